@@ -0,0 +1,771 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pbenchmacros.h
+ * @brief Macros for performance benchmarks
+ * @author Alexander Saprykin
+ *
+ * Every benchmark executable accepts the same options:
+ *
+ *   --warmup N     runs of a P_BENCH_RUN() block before measuring, 1 by default
+ *   --repeat N     measured runs of a P_BENCH_RUN() block, 5 by default
+ *   --cpu N        pins the main thread to the CPU N, the threads created
+ *                  later inherit the pinning on most systems
+ *   --filter TEXT  runs only the cases with TEXT in the name
+ *   --json FILE    also writes all the results into FILE as JSON
+ *   --perf         also reads the hardware performance counters around the
+ *                  P_BENCH_RUN() blocks, where the system allows it
+ *   --baseline DIR compares the results with the baseline recorded in DIR
+ *                  for this machine class and fails on regressions, the
+ *                  baseline is recorded if there is none yet
+ *   --tolerance N  allowed slowdown against the baseline in percent, 50 by
+ *                  default
+ *   --record       records the baseline anew instead of comparing with it
+ *
+ * P_BENCH_RUN() reports the median, minimum and the relative standard
+ * deviation of the repeated runs, the single-shot p_bench_report*() calls
+ * report one measurement. The JSON file starts with the platform backends
+ * the library was built with, so results of different commits and backends
+ * can be compared by a script.
+ *
+ * The baseline keeps the cost of every result in nanoseconds per operation
+ * (or per byte), lower is better: the fastest run of P_BENCH_RUN(), the
+ * elapsed time of p_bench_report() and p_bench_report_bytes(), and the median
+ * of p_bench_report_latency(). Baselines are stored per machine class (the
+ * target OS, the CPU architecture and the number of CPUs) in
+ * DIR/CLASS/SUITE.baseline text files, since the numbers of different
+ * machines can't be compared. Results measured for less than a millisecond
+ * are not compared, and the cases are run up to three times before a
+ * regression is reported. The CTest perf tests ('ctest -L perf') and
+ * scripts/run_tests.sh run the benchmarks this way.
+ */
+
+#ifndef PLIBSYS_HEADER_PBENCHMACROS_H
+#define PLIBSYS_HEADER_PBENCHMACROS_H
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "plibsys.h"
+
+#ifndef PLIBSYS_BENCH_TARGET_OS
+#  define PLIBSYS_BENCH_TARGET_OS	"unknown"
+#  define PLIBSYS_BENCH_THREAD_MODEL	"unknown"
+#  define PLIBSYS_BENCH_RWLOCK_MODEL	"unknown"
+#  define PLIBSYS_BENCH_ATOMIC_MODEL	"unknown"
+#endif
+
+#define P_BENCH_MAX_REPEAT	100
+#define P_BENCH_MAX_RESULTS	512
+#define P_BENCH_MAX_KEY		192
+#define P_BENCH_GATE_MIN_NSECS	1000000
+#define P_BENCH_GATE_ATTEMPTS	3
+
+typedef struct PBenchResult_ {
+	pchar		key[P_BENCH_MAX_KEY];
+	double		cost;
+	pboolean	stable;
+} PBenchResult;
+
+typedef struct PBenchOptions_ {
+	pint		warmup;
+	pint		repeat;
+	pint		cpu;
+	const pchar	*filter;
+	const pchar	*suite;
+	const pchar	*current_case;
+	FILE		*json;
+	pint		json_results;
+	pboolean	use_perf;
+	PPerfCounters	*perf;
+	const pchar	*baseline;
+	double		tolerance;
+	pboolean	record;
+} PBenchOptions;
+
+static PBenchOptions p_bench_options = { 1, 5, -1, NULL, "", "", NULL, 0, FALSE, NULL, NULL, 50.0, FALSE };
+
+static PBenchResult	p_bench_results[P_BENCH_MAX_RESULTS];
+static pint		p_bench_n_results = 0;
+static pint		p_bench_gate_attempt = 0;
+static pint		p_bench_gate_cursor = 0;
+
+#define P_BENCH_CASE_BEGIN(bench_case_name)						\
+	void p_bench_case_##bench_case_name (void)					\
+	{
+
+#define P_BENCH_CASE_END()								\
+	}
+
+/* The cases are run again if they regressed against the baseline, to tell
+ * a real regression from noise */
+#define P_BENCH_SUITE_BEGIN()								\
+	int main (int argc, char **argv)						\
+	{										\
+		pboolean p_bench_passed;						\
+											\
+		if (p_bench_parse_args (argc, argv) == FALSE)				\
+			return 1;							\
+											\
+		p_libsys_init ();							\
+		p_bench_start ();							\
+											\
+		do {
+
+#define P_BENCH_SUITE_END()								\
+		} while (p_bench_gate_retry () == TRUE);				\
+											\
+		p_bench_passed = p_bench_finish ();					\
+		p_libsys_shutdown ();							\
+		return p_bench_passed == TRUE ? 0 : 1;					\
+	}
+
+#define P_BENCH_SUITE_RUN_CASE(a)							\
+	do {										\
+		if (p_bench_options.filter == NULL ||					\
+		    strstr (#a, p_bench_options.filter) != NULL) {			\
+			printf ("Running benchmark case: %s\n", #a);			\
+			p_bench_options.current_case = #a;				\
+			(p_bench_case_##a) ();						\
+		}									\
+	} while (0)
+
+/* Measures the time spent in the given block of code */
+#define P_BENCH_MEASURE(usecs, code)							\
+	do {										\
+		PTimeProfiler *p_bench_profiler = p_time_profiler_new ();		\
+											\
+		code;									\
+											\
+		(usecs) = p_time_profiler_elapsed_usecs (p_bench_profiler);		\
+		p_time_profiler_free (p_bench_profiler);				\
+	} while (0)
+
+/* Runs the given block of code doing ops operations with the warmup and the
+ * repetitions set by the options and reports the statistics */
+#define P_BENCH_RUN(name, ops, code)							\
+	do {										\
+		puint64			p_bench_samples[P_BENCH_MAX_REPEAT];		\
+		PPerfCountersDelta	p_bench_perf_total;				\
+		PTimeProfiler		p_bench_clock;					\
+		pint			p_bench_i;					\
+											\
+		for (p_bench_i = 0; p_bench_i < p_bench_options.warmup; ++p_bench_i) {	\
+			code;								\
+		}									\
+											\
+		memset (&p_bench_perf_total, 0, sizeof (p_bench_perf_total));		\
+											\
+		for (p_bench_i = 0; p_bench_i < p_bench_options.repeat; ++p_bench_i) {	\
+			p_perf_counters_begin (p_bench_options.perf);			\
+			p_time_profiler_reset (&p_bench_clock);				\
+			code;								\
+			p_bench_samples[p_bench_i] =					\
+				p_time_profiler_elapsed_nsecs (&p_bench_clock);		\
+			p_bench_perf_add (&p_bench_perf_total);				\
+		}									\
+											\
+		p_bench_report_runs ((name), (ops), p_bench_samples,			\
+				     p_bench_options.repeat);				\
+		p_bench_report_perf ((name),						\
+				     (psize) (ops) * (psize) p_bench_options.repeat,	\
+				     &p_bench_perf_total);				\
+	} while (0)
+
+inline pboolean p_bench_parse_args (int argc, char **argv)
+{
+	const pchar *slash;
+
+	p_bench_options.suite = argv[0];
+
+	if ((slash = strrchr (argv[0], '/')) != NULL || (slash = strrchr (argv[0], '\\')) != NULL)
+		p_bench_options.suite = slash + 1;
+
+	for (int i = 1; i < argc; ++i) {
+		const pchar *value = i + 1 < argc ? argv[i + 1] : NULL;
+
+		if (strcmp (argv[i], "--perf") == 0) {
+			p_bench_options.use_perf = TRUE;
+			continue;
+		}
+
+		if (strcmp (argv[i], "--record") == 0) {
+			p_bench_options.record = TRUE;
+			continue;
+		}
+
+		if (strcmp (argv[i], "--warmup") == 0 && value != NULL)
+			p_bench_options.warmup = atoi (value);
+		else if (strcmp (argv[i], "--repeat") == 0 && value != NULL)
+			p_bench_options.repeat = atoi (value);
+		else if (strcmp (argv[i], "--cpu") == 0 && value != NULL)
+			p_bench_options.cpu = atoi (value);
+		else if (strcmp (argv[i], "--filter") == 0 && value != NULL)
+			p_bench_options.filter = value;
+		else if (strcmp (argv[i], "--baseline") == 0 && value != NULL)
+			p_bench_options.baseline = value;
+		else if (strcmp (argv[i], "--tolerance") == 0 && value != NULL)
+			p_bench_options.tolerance = atof (value);
+		else if (strcmp (argv[i], "--json") == 0 && value != NULL) {
+			if ((p_bench_options.json = fopen (value, "w")) == NULL) {
+				fprintf (stderr, "Failed to open %s for writing\n", value);
+				return FALSE;
+			}
+		} else {
+			fprintf (stderr,
+				 "Usage: %s [--warmup N] [--repeat N] [--cpu N] [--filter TEXT] [--json FILE] [--perf]"
+				 " [--baseline DIR] [--tolerance N] [--record]\n",
+				 p_bench_options.suite);
+			return FALSE;
+		}
+
+		++i;
+	}
+
+	if (p_bench_options.warmup < 0)
+		p_bench_options.warmup = 0;
+
+	if (p_bench_options.repeat < 1)
+		p_bench_options.repeat = 1;
+
+	if (p_bench_options.repeat > P_BENCH_MAX_REPEAT)
+		p_bench_options.repeat = P_BENCH_MAX_REPEAT;
+
+	if (p_bench_options.tolerance < 0.0)
+		p_bench_options.tolerance = 0.0;
+
+	return TRUE;
+}
+
+inline void p_bench_start (void)
+{
+	if (p_bench_options.cpu >= 0) {
+		PUThreadCpuSet cpu_set;
+
+		p_uthread_cpu_set_clear (&cpu_set);
+
+		if (p_uthread_cpu_set_add (&cpu_set, p_bench_options.cpu) == FALSE ||
+		    p_uthread_set_affinity (p_uthread_current (), &cpu_set) == FALSE) {
+			fprintf (stderr, "Failed to pin to CPU %d, running unpinned\n", p_bench_options.cpu);
+			p_bench_options.cpu = -1;
+		}
+	}
+
+	/* Opened after pinning, the counters follow the thread anyway */
+	if (p_bench_options.use_perf == TRUE &&
+	    (p_bench_options.perf = p_perf_counters_new (NULL)) == NULL)
+		fprintf (stderr, "Performance counters are not available\n");
+
+	if (p_bench_options.json == NULL)
+		return;
+
+	fprintf (p_bench_options.json,
+		 "{\n"
+		 "  \"suite\": \"%s\",\n"
+		 "  \"platform\": {\n"
+		 "    \"os\": \"%s\",\n"
+		 "    \"thread_model\": \"%s\",\n"
+		 "    \"rwlock_model\": \"%s\",\n"
+		 "    \"atomic_model\": \"%s\",\n"
+		 "    \"cpus\": %d\n"
+		 "  },\n"
+		 "  \"warmup\": %d,\n"
+		 "  \"repeat\": %d,\n"
+		 "  \"cpu\": %d,\n"
+		 "  \"results\": [",
+		 p_bench_options.suite,
+		 PLIBSYS_BENCH_TARGET_OS,
+		 PLIBSYS_BENCH_THREAD_MODEL,
+		 PLIBSYS_BENCH_RWLOCK_MODEL,
+		 PLIBSYS_BENCH_ATOMIC_MODEL,
+		 p_uthread_ideal_count (),
+		 p_bench_options.warmup,
+		 p_bench_options.repeat,
+		 p_bench_options.cpu);
+}
+
+inline pboolean p_bench_gate_check (void);
+
+/* Returns FALSE if the results regressed against the baseline */
+inline pboolean p_bench_finish (void)
+{
+	p_perf_counters_free (p_bench_options.perf);
+	p_bench_options.perf = NULL;
+
+	if (p_bench_options.json != NULL) {
+		fprintf (p_bench_options.json, "\n  ]\n}\n");
+		fclose (p_bench_options.json);
+
+		p_bench_options.json = NULL;
+	}
+
+	return p_bench_gate_check ();
+}
+
+/* Remembers the cost of a result for the baseline comparison, the results
+ * measured for less than P_BENCH_GATE_MIN_NSECS are recorded but are too noisy
+ * to be compared. The same name can be reported several times (i.e. for
+ * different sizes), such results are told apart by the order. The repeated
+ * attempts report the results in the same order, the best cost is kept */
+inline void p_bench_gate_add (const pchar *name, const pchar *kind, double cost, double nsecs)
+{
+	PBenchResult	*result;
+	pchar		key[P_BENCH_MAX_KEY];
+	pint		seen = 0;
+
+	if (p_bench_options.baseline == NULL)
+		return;
+
+	if (p_bench_gate_attempt > 0) {
+		if (p_bench_gate_cursor >= p_bench_n_results)
+			return;
+
+		result = &p_bench_results[p_bench_gate_cursor++];
+
+		if (cost < result->cost)
+			result->cost = cost;
+
+		if (nsecs >= P_BENCH_GATE_MIN_NSECS)
+			result->stable = TRUE;
+
+		return;
+	}
+
+	if (p_bench_n_results >= P_BENCH_MAX_RESULTS)
+		return;
+
+	snprintf (key, sizeof (key), "%s/%s [%s]", p_bench_options.current_case, name, kind);
+
+	for (pint i = 0; i < p_bench_n_results; ++i) {
+		if (strncmp (p_bench_results[i].key, key, strlen (key)) == 0)
+			++seen;
+	}
+
+	result = &p_bench_results[p_bench_n_results++];
+
+	if (seen > 0)
+		snprintf (result->key, sizeof (result->key), "%s #%d", key, seen + 1);
+	else
+		snprintf (result->key, sizeof (result->key), "%s", key);
+
+	result->cost   = cost;
+	result->stable = nsecs >= P_BENCH_GATE_MIN_NSECS ? TRUE : FALSE;
+}
+
+inline void p_bench_machine_class (pchar *buf, psize size)
+{
+#if defined (P_CPU_X86_64)
+	const pchar *arch = "x86_64";
+#elif defined (P_CPU_X86_32)
+	const pchar *arch = "x86";
+#elif defined (P_CPU_ARM_64)
+	const pchar *arch = "arm64";
+#elif defined (P_CPU_ARM_32)
+	const pchar *arch = "arm";
+#elif defined (P_CPU_POWER_64)
+	const pchar *arch = "power64";
+#elif defined (P_CPU_MIPS_64)
+	const pchar *arch = "mips64";
+#else
+	const pchar *arch = "other";
+#endif
+
+	snprintf (buf, size, "%s-%s-%dcpu", PLIBSYS_BENCH_TARGET_OS, arch, p_uthread_ideal_count ());
+}
+
+inline void p_bench_gate_paths (pchar *dir, psize dir_size, pchar *path, psize path_size)
+{
+	pchar machine[64];
+
+	p_bench_machine_class (machine, sizeof (machine));
+
+	snprintf (dir, dir_size, "%s/%s", p_bench_options.baseline, machine);
+	snprintf (path, path_size, "%s/%s.baseline", dir, p_bench_options.suite);
+}
+
+inline pboolean p_bench_gate_record (const pchar *path)
+{
+	FILE *file;
+
+	if ((file = fopen (path, "w")) == NULL) {
+		fprintf (stderr, "Failed to open %s for writing\n", path);
+		return FALSE;
+	}
+
+	for (pint i = 0; i < p_bench_n_results; ++i)
+		fprintf (file, "%.3f %s\n", p_bench_results[i].cost, p_bench_results[i].key);
+
+	fclose (file);
+
+	printf ("Recorded %d baseline results into %s\n", p_bench_n_results, path);
+
+	return TRUE;
+}
+
+/* Returns the number of the regressed results, -1 if there is no baseline */
+inline pint p_bench_gate_compare (const pchar *path, pboolean verbose)
+{
+	pchar	line[P_BENCH_MAX_KEY + 64];
+	FILE	*file;
+	double	limit;
+	pint	compared    = 0;
+	pint	regressions = 0;
+
+	if ((file = fopen (path, "r")) == NULL)
+		return -1;
+
+	limit = 1.0 + p_bench_options.tolerance / 100.0;
+
+	while (fgets (line, sizeof (line), file) != NULL) {
+		double	base;
+		pchar	*key;
+		pchar	*end;
+
+		base = strtod (line, &key);
+
+		if (key == line || *key != ' ' || base <= 0.0)
+			continue;
+
+		++key;
+
+		if ((end = strpbrk (key, "\r\n")) != NULL)
+			*end = '\0';
+
+		for (pint i = 0; i < p_bench_n_results; ++i) {
+			const PBenchResult *result = &p_bench_results[i];
+
+			if (strcmp (result->key, key) != 0)
+				continue;
+
+			if (result->stable == FALSE)
+				break;
+
+			++compared;
+
+			if (result->cost > base * limit) {
+				if (verbose == TRUE)
+					printf ("  REGRESSION %-48s %10.2f ns -> %10.2f ns (+%.0f%%)\n",
+						key,
+						base,
+						result->cost,
+						(result->cost / base - 1.0) * 100.0);
+				++regressions;
+			}
+
+			break;
+		}
+	}
+
+	fclose (file);
+
+	if (verbose == TRUE)
+		printf ("Compared %d of %d results with %s, tolerance %.0f%%: %d regressed\n",
+			compared,
+			p_bench_n_results,
+			path,
+			p_bench_options.tolerance,
+			regressions);
+
+	return regressions;
+}
+
+/* Tells whether the cases should be run again to confirm the regressions */
+inline pboolean p_bench_gate_retry (void)
+{
+	pchar dir[512];
+	pchar path[768];
+
+	if (p_bench_options.baseline == NULL || p_bench_options.record == TRUE)
+		return FALSE;
+
+	if (p_bench_gate_attempt + 1 >= P_BENCH_GATE_ATTEMPTS)
+		return FALSE;
+
+	p_bench_gate_paths (dir, sizeof (dir), path, sizeof (path));
+
+	if (p_bench_gate_compare (path, FALSE) <= 0)
+		return FALSE;
+
+	printf ("Running again to confirm the regressions\n");
+
+	++p_bench_gate_attempt;
+	p_bench_gate_cursor = 0;
+
+	return TRUE;
+}
+
+/* Compares the results with the baseline of the machine class, records the
+ * baseline if there is none */
+inline pboolean p_bench_gate_check (void)
+{
+	pchar	dir[512];
+	pchar	path[768];
+	pint	regressions;
+
+	if (p_bench_options.baseline == NULL)
+		return TRUE;
+
+	p_bench_gate_paths (dir, sizeof (dir), path, sizeof (path));
+
+	if (p_bench_options.record == FALSE && (regressions = p_bench_gate_compare (path, TRUE)) >= 0)
+		return regressions == 0 ? TRUE : FALSE;
+
+	if (p_dir_create (p_bench_options.baseline, 0755, NULL) == FALSE ||
+	    p_dir_create (dir, 0755, NULL) == FALSE) {
+		fprintf (stderr, "Failed to create baseline directory %s\n", dir);
+		return FALSE;
+	}
+
+	return p_bench_gate_record (path);
+}
+
+/* Starts a JSON result object, the caller adds the measured fields */
+inline FILE * p_bench_json_begin (const pchar *name, const pchar *kind)
+{
+	FILE *json = p_bench_options.json;
+
+	if (json == NULL || p_bench_gate_attempt > 0)
+		return NULL;
+
+	fprintf (json, "%s\n    { \"case\": \"%s\", \"name\": \"",
+		 p_bench_options.json_results++ > 0 ? "," : "",
+		 p_bench_options.current_case);
+
+	for (const pchar *c = name; *c != '\0'; ++c) {
+		if (*c == '"' || *c == '\\')
+			fputc ('\\', json);
+
+		fputc (*c, json);
+	}
+
+	fprintf (json, "\", \"kind\": \"%s\"", kind);
+
+	return json;
+}
+
+inline void p_bench_report (const pchar *name, psize ops, puint64 usecs)
+{
+	double	rate = usecs == 0 ? 0.0 : (double) ops * 1000000.0 / (double) usecs;
+	FILE	*json;
+
+	printf ("  %-48s %10lu ops %12lu us %16.0f ops/s\n",
+		name,
+		(unsigned long) ops,
+		(unsigned long) usecs,
+		rate);
+
+	if (ops > 0)
+		p_bench_gate_add (name, "ops", (double) usecs * 1000.0 / (double) ops, (double) usecs * 1000.0);
+
+	if ((json = p_bench_json_begin (name, "ops")) != NULL)
+		fprintf (json, ", \"ops\": %lu, \"usecs\": %lu, \"ops_per_sec\": %.0f }",
+			 (unsigned long) ops,
+			 (unsigned long) usecs,
+			 rate);
+}
+
+inline void p_bench_report_bytes (const pchar *name, puint64 bytes, puint64 usecs)
+{
+	double	rate = usecs == 0 ? 0.0 : (double) bytes * 1000000.0 / (double) usecs / (1024.0 * 1024.0);
+	FILE	*json;
+
+	printf ("  %-48s %10lu KB  %12lu us %16.1f MB/s\n",
+		name,
+		(unsigned long) (bytes / 1024),
+		(unsigned long) usecs,
+		rate);
+
+	if (bytes > 0)
+		p_bench_gate_add (name, "bytes", (double) usecs * 1000.0 / (double) bytes, (double) usecs * 1000.0);
+
+	if ((json = p_bench_json_begin (name, "bytes")) != NULL)
+		fprintf (json, ", \"bytes\": %lu, \"usecs\": %lu, \"mb_per_sec\": %.1f }",
+			 (unsigned long) bytes,
+			 (unsigned long) usecs,
+			 rate);
+}
+
+inline int p_bench_compare_samples (const void *a, const void *b)
+{
+	puint64 sa = *((const puint64 *) a);
+	puint64 sb = *((const puint64 *) b);
+
+	return sa < sb ? -1 : (sa > sb ? 1 : 0);
+}
+
+/* Sorts the nanosecond durations of the repeated runs and prints the
+ * statistics per operation */
+inline void p_bench_report_runs (const pchar *name, psize ops, puint64 *samples, pint count)
+{
+	double	mean;
+	double	variance;
+	double	median;
+	double	scale;
+	FILE	*json;
+
+	if (count <= 0)
+		return;
+
+	qsort (samples, (size_t) count, sizeof (puint64), p_bench_compare_samples);
+
+	scale = ops > 0 ? 1.0 / (double) ops : 1.0;
+	mean  = 0.0;
+
+	for (pint i = 0; i < count; ++i)
+		mean += (double) samples[i];
+
+	mean /= (double) count;
+
+	variance = 0.0;
+
+	for (pint i = 0; i < count; ++i)
+		variance += ((double) samples[i] - mean) * ((double) samples[i] - mean);
+
+	variance /= (double) count;
+
+	median = count % 2 == 1 ? (double) samples[count / 2] :
+				  ((double) samples[count / 2 - 1] + (double) samples[count / 2]) / 2.0;
+
+	printf ("  %-48s %10lu ops %10.1f ns/op  min %10.1f  rsd %5.1f%% %14.0f ops/s\n",
+		name,
+		(unsigned long) ops,
+		median * scale,
+		(double) samples[0] * scale,
+		mean > 0.0 ? sqrt (variance) * 100.0 / mean : 0.0,
+		median > 0.0 ? (double) ops * 1e9 / median : 0.0);
+
+	/* The fastest run is the least disturbed by the rest of the system */
+	p_bench_gate_add (name, "runs", (double) samples[0] * scale, (double) samples[0]);
+
+	if ((json = p_bench_json_begin (name, "runs")) != NULL)
+		fprintf (json,
+			 ", \"ops\": %lu, \"runs\": %d, \"ns_per_op\": { \"min\": %.2f, \"median\": %.2f,"
+			 " \"mean\": %.2f, \"stddev\": %.2f, \"max\": %.2f } }",
+			 (unsigned long) ops,
+			 count,
+			 (double) samples[0] * scale,
+			 median * scale,
+			 mean * scale,
+			 sqrt (variance) * scale,
+			 (double) samples[count - 1] * scale);
+}
+
+/* Adds the counter changes since the last p_perf_counters_begin() */
+inline void p_bench_perf_add (PPerfCountersDelta *total)
+{
+	PPerfCountersDelta delta;
+
+	if (p_bench_options.perf == NULL || p_perf_counters_end (p_bench_options.perf, &delta) == FALSE)
+		return;
+
+	for (pint i = 0; i < P_PERF_COUNTER_TYPE_COUNT; ++i)
+		total->values[i] += delta.values[i];
+
+	if (delta.scaled == TRUE)
+		total->scaled = TRUE;
+}
+
+/* Prints the supported performance counters per operation */
+inline void p_bench_report_perf (const pchar *name, psize ops, const PPerfCountersDelta *total)
+{
+	const puint64	*values = total->values;
+	double		scale   = ops > 0 ? 1.0 / (double) ops : 1.0;
+	FILE		*json;
+	pboolean	first   = TRUE;
+
+	if (p_bench_options.perf == NULL)
+		return;
+
+	printf ("  %-48s", "");
+
+	if (values[P_PERF_COUNTER_TYPE_CYCLES] > 0 && values[P_PERF_COUNTER_TYPE_INSTRUCTIONS] > 0)
+		printf (" IPC %.2f", (double) values[P_PERF_COUNTER_TYPE_INSTRUCTIONS] /
+				     (double) values[P_PERF_COUNTER_TYPE_CYCLES]);
+
+	json = p_bench_json_begin (name, "perf");
+
+	if (json != NULL)
+		fprintf (json, ", \"scaled\": %s, \"per_op\": {", total->scaled == TRUE ? "true" : "false");
+
+	for (pint i = 0; i < P_PERF_COUNTER_TYPE_COUNT; ++i) {
+		const pchar *counter = p_perf_counters_get_name ((PPerfCounterType) i);
+
+		if (p_perf_counters_is_supported (p_bench_options.perf, (PPerfCounterType) i) == FALSE)
+			continue;
+
+		printf ("  %s/op %.3f", counter, (double) values[i] * scale);
+
+		if (json != NULL)
+			fprintf (json, "%s \"%s\": %.4f", first == TRUE ? "" : ",", counter, (double) values[i] * scale);
+
+		first = FALSE;
+	}
+
+	printf ("%s\n", total->scaled == TRUE ? "  (scaled)" : "");
+
+	if (json != NULL)
+		fprintf (json, " } }");
+}
+
+/* Sorts the latency samples and prints the percentiles */
+inline void p_bench_report_latency (const pchar *name, puint64 *samples, psize count)
+{
+	double	total;
+	FILE	*json;
+
+	if (count == 0)
+		return;
+
+	qsort (samples, count, sizeof (puint64), p_bench_compare_samples);
+
+	printf ("  %-48s %10lu smp  p50 %6lu us  p99 %6lu us  p99.9 %6lu us  max %6lu us\n",
+		name,
+		(unsigned long) count,
+		(unsigned long) samples[count / 2],
+		(unsigned long) samples[count * 99 / 100],
+		(unsigned long) samples[count * 999 / 1000],
+		(unsigned long) samples[count - 1]);
+
+	total = 0.0;
+
+	for (psize i = 0; i < count; ++i)
+		total += (double) samples[i];
+
+	p_bench_gate_add (name, "latency", (double) samples[count / 2] * 1000.0, total * 1000.0);
+
+	if ((json = p_bench_json_begin (name, "latency")) != NULL)
+		fprintf (json,
+			 ", \"samples\": %lu, \"usecs\": { \"p50\": %lu, \"p99\": %lu, \"p999\": %lu, \"max\": %lu } }",
+			 (unsigned long) count,
+			 (unsigned long) samples[count / 2],
+			 (unsigned long) samples[count * 99 / 100],
+			 (unsigned long) samples[count * 999 / 1000],
+			 (unsigned long) samples[count - 1]);
+}
+
+#endif /* PLIBSYS_HEADER_PBENCHMACROS_H */
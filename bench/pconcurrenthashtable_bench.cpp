@@ -0,0 +1,206 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "pbenchmacros.h"
+
+#define PCONCURRENTHASHTABLE_BENCH_KEYS		65536
+#define PCONCURRENTHASHTABLE_BENCH_OPS		1000000
+#define PCONCURRENTHASHTABLE_BENCH_MAX_THREADS	256
+
+typedef struct BenchContext_ {
+	PConcurrentHashTable	*ctable;
+	PHashTable		*table;
+	PMutex			*mutex;
+	pint			thread_idx;
+} BenchContext;
+
+/* 90% lookups and 10% inserts over a shared key set */
+static void * bench_concurrent_thread (void *data)
+{
+	BenchContext	*ctx  = (BenchContext *) data;
+	puint		seed = (puint) ctx->thread_idx * 7919 + 1;
+
+	for (pint i = 0; i < PCONCURRENTHASHTABLE_BENCH_OPS; ++i) {
+		seed = seed * 1103515245 + 12345;
+
+		ppointer key = PUINT_TO_POINTER (((seed >> 8) % PCONCURRENTHASHTABLE_BENCH_KEYS + 1) * 16);
+
+		if (seed % 10 == 0)
+			p_concurrent_hash_table_insert (ctx->ctable, key, key);
+		else
+			p_concurrent_hash_table_lookup (ctx->ctable, key);
+	}
+
+	return NULL;
+}
+
+static void * bench_mutex_thread (void *data)
+{
+	BenchContext	*ctx  = (BenchContext *) data;
+	puint		seed = (puint) ctx->thread_idx * 7919 + 1;
+
+	for (pint i = 0; i < PCONCURRENTHASHTABLE_BENCH_OPS; ++i) {
+		seed = seed * 1103515245 + 12345;
+
+		ppointer key = PUINT_TO_POINTER (((seed >> 8) % PCONCURRENTHASHTABLE_BENCH_KEYS + 1) * 16);
+
+		p_mutex_lock (ctx->mutex);
+
+		if (seed % 10 == 0)
+			p_hash_table_insert (ctx->table, key, key);
+		else
+			p_hash_table_lookup (ctx->table, key);
+
+		p_mutex_unlock (ctx->mutex);
+	}
+
+	return NULL;
+}
+
+/* Lookups only, the read-mostly case */
+static void * bench_lookup_thread (void *data)
+{
+	BenchContext	*ctx  = (BenchContext *) data;
+	puint		seed = (puint) ctx->thread_idx * 7919 + 1;
+
+	for (pint i = 0; i < PCONCURRENTHASHTABLE_BENCH_OPS; ++i) {
+		seed = seed * 1103515245 + 12345;
+
+		ppointer key = PUINT_TO_POINTER (((seed >> 8) % PCONCURRENTHASHTABLE_BENCH_KEYS + 1) * 16);
+
+		p_concurrent_hash_table_lookup (ctx->ctable, key);
+	}
+
+	return NULL;
+}
+
+static puint64 bench_run_threads (PUThreadFunc func, BenchContext *base, pint threads)
+{
+	PUThread	*thr[PCONCURRENTHASHTABLE_BENCH_MAX_THREADS];
+	BenchContext	ctx[PCONCURRENTHASHTABLE_BENCH_MAX_THREADS];
+	puint64		usecs;
+
+	P_BENCH_MEASURE (usecs, {
+		for (pint i = 0; i < threads; ++i) {
+			ctx[i]            = *base;
+			ctx[i].thread_idx = i;
+			thr[i]            = p_uthread_create (func, &ctx[i], TRUE, NULL);
+		}
+
+		for (pint i = 0; i < threads; ++i) {
+			p_uthread_join (thr[i]);
+			p_uthread_unref (thr[i]);
+		}
+	});
+
+	return usecs;
+}
+
+P_BENCH_CASE_BEGIN (pconcurrenthashtable_scaling_bench)
+{
+	BenchContext	base;
+	pint		max_threads = p_uthread_ideal_count ();
+	pchar		name[64];
+
+	if (max_threads > PCONCURRENTHASHTABLE_BENCH_MAX_THREADS)
+		max_threads = PCONCURRENTHASHTABLE_BENCH_MAX_THREADS;
+
+	base.ctable = p_concurrent_hash_table_new ();
+	base.table  = p_hash_table_new ();
+	base.mutex  = p_mutex_new ();
+
+	for (pint i = 1; i <= PCONCURRENTHASHTABLE_BENCH_KEYS; ++i) {
+		p_concurrent_hash_table_insert (base.ctable, PINT_TO_POINTER (i * 16), PINT_TO_POINTER (i));
+		p_hash_table_insert (base.table, PINT_TO_POINTER (i * 16), PINT_TO_POINTER (i));
+	}
+
+	for (pint threads = 1; ; threads *= 2) {
+		if (threads > max_threads)
+			threads = max_threads;
+
+		psize ops = (psize) threads * PCONCURRENTHASHTABLE_BENCH_OPS;
+
+		snprintf (name, sizeof (name), "global mutex, %d threads", threads);
+		p_bench_report (name, ops, bench_run_threads ((PUThreadFunc) bench_mutex_thread, &base, threads));
+
+		snprintf (name, sizeof (name), "lock striping, %d threads", threads);
+		p_bench_report (name, ops, bench_run_threads ((PUThreadFunc) bench_concurrent_thread, &base, threads));
+
+		if (threads == max_threads)
+			break;
+	}
+
+	p_concurrent_hash_table_free (base.ctable);
+	p_hash_table_free (base.table);
+	p_mutex_free (base.mutex);
+}
+P_BENCH_CASE_END ()
+
+P_BENCH_CASE_BEGIN (pconcurrenthashtable_read_scaling_bench)
+{
+	BenchContext	striped;
+	BenchContext	read_mostly;
+	pint		max_threads = p_uthread_ideal_count ();
+	pchar		name[64];
+
+	if (max_threads > PCONCURRENTHASHTABLE_BENCH_MAX_THREADS)
+		max_threads = PCONCURRENTHASHTABLE_BENCH_MAX_THREADS;
+
+	striped.ctable     = p_concurrent_hash_table_new ();
+	read_mostly.ctable = p_concurrent_hash_table_new_read_mostly (NULL, NULL, NULL, NULL);
+
+	for (pint i = 1; i <= PCONCURRENTHASHTABLE_BENCH_KEYS; ++i) {
+		p_concurrent_hash_table_insert (striped.ctable, PINT_TO_POINTER (i * 16), PINT_TO_POINTER (i));
+		p_concurrent_hash_table_insert (read_mostly.ctable, PINT_TO_POINTER (i * 16), PINT_TO_POINTER (i));
+	}
+
+	for (pint threads = 1; ; threads *= 2) {
+		if (threads > max_threads)
+			threads = max_threads;
+
+		psize ops = (psize) threads * PCONCURRENTHASHTABLE_BENCH_OPS;
+
+		snprintf (name, sizeof (name), "striped lookup, %d threads", threads);
+		p_bench_report (name, ops, bench_run_threads ((PUThreadFunc) bench_lookup_thread, &striped, threads));
+
+		snprintf (name, sizeof (name), "read-mostly lookup, %d threads", threads);
+		p_bench_report (name, ops, bench_run_threads ((PUThreadFunc) bench_lookup_thread, &read_mostly, threads));
+
+		if (threads == max_threads)
+			break;
+	}
+
+	p_concurrent_hash_table_free (striped.ctable);
+	p_concurrent_hash_table_free (read_mostly.ctable);
+}
+P_BENCH_CASE_END ()
+
+P_BENCH_SUITE_BEGIN ()
+{
+	P_BENCH_SUITE_RUN_CASE (pconcurrenthashtable_scaling_bench);
+	P_BENCH_SUITE_RUN_CASE (pconcurrenthashtable_read_scaling_bench);
+}
+P_BENCH_SUITE_END ()
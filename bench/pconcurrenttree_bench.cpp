@@ -0,0 +1,150 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "pbenchmacros.h"
+
+#define PCONCURRENTTREE_BENCH_KEYS		65536
+#define PCONCURRENTTREE_BENCH_OPS		1000000
+#define PCONCURRENTTREE_BENCH_MAX_THREADS	256
+
+typedef struct BenchContext_ {
+	PConcurrentTree	*ctree;
+	PTree		*tree;
+	PRWLock		*lock;
+	pint		thread_idx;
+} BenchContext;
+
+static pint bench_compare_keys (pconstpointer a, pconstpointer b, ppointer data)
+{
+	psize p1 = (psize) a;
+	psize p2 = (psize) b;
+
+	P_UNUSED (data);
+
+	return p1 < p2 ? -1 : (p1 > p2 ? 1 : 0);
+}
+
+static void * bench_rwlock_thread (void *data)
+{
+	BenchContext	*ctx  = (BenchContext *) data;
+	puint		seed = (puint) ctx->thread_idx * 7919 + 1;
+
+	for (pint i = 0; i < PCONCURRENTTREE_BENCH_OPS; ++i) {
+		seed = seed * 1103515245 + 12345;
+
+		ppointer key = PUINT_TO_POINTER (((seed >> 8) % PCONCURRENTTREE_BENCH_KEYS + 1) * 16);
+
+		p_rwlock_reader_lock (ctx->lock);
+		p_tree_lookup (ctx->tree, key);
+		p_rwlock_reader_unlock (ctx->lock);
+	}
+
+	return NULL;
+}
+
+static void * bench_seqlock_thread (void *data)
+{
+	BenchContext	*ctx  = (BenchContext *) data;
+	puint		seed = (puint) ctx->thread_idx * 7919 + 1;
+
+	for (pint i = 0; i < PCONCURRENTTREE_BENCH_OPS; ++i) {
+		seed = seed * 1103515245 + 12345;
+
+		ppointer key = PUINT_TO_POINTER (((seed >> 8) % PCONCURRENTTREE_BENCH_KEYS + 1) * 16);
+
+		p_concurrent_tree_lookup (ctx->ctree, key);
+	}
+
+	return NULL;
+}
+
+static puint64 bench_run_threads (PUThreadFunc func, BenchContext *base, pint threads)
+{
+	PUThread	*thr[PCONCURRENTTREE_BENCH_MAX_THREADS];
+	BenchContext	ctx[PCONCURRENTTREE_BENCH_MAX_THREADS];
+	puint64		usecs;
+
+	P_BENCH_MEASURE (usecs, {
+		for (pint i = 0; i < threads; ++i) {
+			ctx[i]            = *base;
+			ctx[i].thread_idx = i;
+			thr[i]            = p_uthread_create (func, &ctx[i], TRUE, NULL);
+		}
+
+		for (pint i = 0; i < threads; ++i) {
+			p_uthread_join (thr[i]);
+			p_uthread_unref (thr[i]);
+		}
+	});
+
+	return usecs;
+}
+
+P_BENCH_CASE_BEGIN (pconcurrenttree_read_scaling_bench)
+{
+	BenchContext	base;
+	pint		max_threads = p_uthread_ideal_count ();
+	pchar		name[64];
+
+	if (max_threads > PCONCURRENTTREE_BENCH_MAX_THREADS)
+		max_threads = PCONCURRENTTREE_BENCH_MAX_THREADS;
+
+	base.ctree = p_concurrent_tree_new (P_TREE_TYPE_RB, bench_compare_keys, NULL);
+	base.tree  = p_tree_new_with_data (P_TREE_TYPE_RB, bench_compare_keys, NULL);
+	base.lock  = p_rwlock_new ();
+
+	for (pint i = 1; i <= PCONCURRENTTREE_BENCH_KEYS; ++i) {
+		p_concurrent_tree_insert (base.ctree, PINT_TO_POINTER (i * 16), PINT_TO_POINTER (i));
+		p_tree_insert (base.tree, PINT_TO_POINTER (i * 16), PINT_TO_POINTER (i));
+	}
+
+	for (pint threads = 1; ; threads *= 2) {
+		if (threads > max_threads)
+			threads = max_threads;
+
+		psize ops = (psize) threads * PCONCURRENTTREE_BENCH_OPS;
+
+		snprintf (name, sizeof (name), "rwlock lookup, %d threads", threads);
+		p_bench_report (name, ops, bench_run_threads ((PUThreadFunc) bench_rwlock_thread, &base, threads));
+
+		snprintf (name, sizeof (name), "seqlock lookup, %d threads", threads);
+		p_bench_report (name, ops, bench_run_threads ((PUThreadFunc) bench_seqlock_thread, &base, threads));
+
+		if (threads == max_threads)
+			break;
+	}
+
+	p_concurrent_tree_free (base.ctree);
+	p_tree_free (base.tree);
+	p_rwlock_free (base.lock);
+}
+P_BENCH_CASE_END ()
+
+P_BENCH_SUITE_BEGIN ()
+{
+	P_BENCH_SUITE_RUN_CASE (pconcurrenttree_read_scaling_bench);
+}
+P_BENCH_SUITE_END ()
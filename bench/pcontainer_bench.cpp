@@ -0,0 +1,539 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Container benchmark suite: compares the tree types, the hash table, the
+ * typed hash map and the list on the same workloads. The results are printed as CSV, one row per
+ * container, key distribution, size and operation:
+ *
+ *   container,distribution,size,operation,ops,usecs,ops_per_sec,bytes_per_entry
+ *
+ * where bytes_per_entry is the memory allocated by the container divided by
+ * the number of stored keys. Run as `pcontainer_bench [max_size]`, the default
+ * maximal size is PBENCH_DEFAULT_MAX_SIZE. */
+
+#include "plibsys.h"
+#include "pbenchmacros.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define PBENCH_DEFAULT_MAX_SIZE	1000000
+#define PBENCH_SLOW_MAX_SIZE	10000
+
+/* Memory accounting: every block is prefixed with its size */
+
+#define PBENCH_MEM_HEADER	16
+
+static psize bench_mem_used = 0;
+
+static ppointer bench_mem_alloc (psize nbytes)
+{
+	pchar *block = (pchar *) malloc (nbytes + PBENCH_MEM_HEADER);
+
+	if (block == NULL)
+		return NULL;
+
+	*((psize *) block) = nbytes;
+	bench_mem_used    += nbytes;
+
+	return block + PBENCH_MEM_HEADER;
+}
+
+static ppointer bench_mem_realloc (ppointer mem, psize nbytes)
+{
+	pchar *block;
+
+	if (mem == NULL)
+		return bench_mem_alloc (nbytes);
+
+	block = (pchar *) mem - PBENCH_MEM_HEADER;
+
+	bench_mem_used -= *((psize *) block);
+
+	if ((block = (pchar *) realloc (block, nbytes + PBENCH_MEM_HEADER)) == NULL)
+		return NULL;
+
+	*((psize *) block) = nbytes;
+	bench_mem_used    += nbytes;
+
+	return block + PBENCH_MEM_HEADER;
+}
+
+static void bench_mem_free (ppointer mem)
+{
+	pchar *block;
+
+	if (mem == NULL)
+		return;
+
+	block = (pchar *) mem - PBENCH_MEM_HEADER;
+
+	bench_mem_used -= *((psize *) block);
+	free (block);
+}
+
+/* Containers under test, all of them store integer keys as pointers */
+
+typedef struct BenchContainer_ {
+	const pchar	*name;
+	psize		max_size;
+	psize		max_sequential_size;
+	ppointer	(*create)	(void);
+	void		(*insert)	(ppointer container, ppointer key);
+	pboolean	(*lookup)	(ppointer container, ppointer key);
+	void		(*remove)	(ppointer container, ppointer key);
+	psize		(*iterate)	(ppointer container);
+	void		(*destroy)	(ppointer container);
+} BenchContainer;
+
+static pint bench_compare_keys (pconstpointer a, pconstpointer b)
+{
+	psize p1 = (psize) a;
+	psize p2 = (psize) b;
+
+	return p1 < p2 ? -1 : (p1 > p2 ? 1 : 0);
+}
+
+static pboolean bench_tree_count (ppointer key, ppointer value, ppointer data)
+{
+	P_UNUSED (key);
+	P_UNUSED (value);
+
+	++*((psize *) data);
+
+	return FALSE;
+}
+
+static ppointer bench_binary_create (void)
+{
+	return p_tree_new (P_TREE_TYPE_BINARY, bench_compare_keys);
+}
+
+static ppointer bench_rb_create (void)
+{
+	return p_tree_new (P_TREE_TYPE_RB, bench_compare_keys);
+}
+
+static ppointer bench_avl_create (void)
+{
+	return p_tree_new (P_TREE_TYPE_AVL, bench_compare_keys);
+}
+
+static ppointer bench_btree_create (void)
+{
+	return p_tree_new (P_TREE_TYPE_BTREE, bench_compare_keys);
+}
+
+static void bench_tree_insert (ppointer container, ppointer key)
+{
+	p_tree_insert ((PTree *) container, key, key);
+}
+
+static pboolean bench_tree_lookup (ppointer container, ppointer key)
+{
+	return p_tree_lookup ((PTree *) container, key) == key ? TRUE : FALSE;
+}
+
+static void bench_tree_remove (ppointer container, ppointer key)
+{
+	p_tree_remove ((PTree *) container, key);
+}
+
+static psize bench_tree_iterate (ppointer container)
+{
+	psize count = 0;
+
+	p_tree_foreach ((PTree *) container, bench_tree_count, &count);
+
+	return count;
+}
+
+static void bench_tree_destroy (ppointer container)
+{
+	p_tree_free ((PTree *) container);
+}
+
+static ppointer bench_hash_create (void)
+{
+	return p_hash_table_new ();
+}
+
+static void bench_hash_insert (ppointer container, ppointer key)
+{
+	p_hash_table_insert ((PHashTable *) container, key, key);
+}
+
+static pboolean bench_hash_lookup (ppointer container, ppointer key)
+{
+	return p_hash_table_lookup ((PHashTable *) container, key) == key ? TRUE : FALSE;
+}
+
+static void bench_hash_remove (ppointer container, ppointer key)
+{
+	p_hash_table_remove ((PHashTable *) container, key);
+}
+
+static psize bench_hash_iterate (ppointer container)
+{
+	PHashTableIter	iter;
+	psize		count = 0;
+
+	p_hash_table_iter_init (&iter, (PHashTable *) container);
+
+	while (p_hash_table_iter_next (&iter, NULL, NULL) == TRUE)
+		++count;
+
+	return count;
+}
+
+static void bench_hash_destroy (ppointer container)
+{
+	p_hash_table_free ((PHashTable *) container);
+}
+
+/* The typed hash map stores the keys by value and inlines the hashing */
+
+P_DEFINE_HASH_MAP (BenchTypedMap, puint64, puint64, p_typed_hash_uint64, P_TYPED_EQUAL)
+
+static ppointer bench_typed_create (void)
+{
+	return BenchTypedMap_new ();
+}
+
+static void bench_typed_insert (ppointer container, ppointer key)
+{
+	BenchTypedMap_insert ((BenchTypedMap *) container, (puint64) (psize) key, (puint64) (psize) key);
+}
+
+static pboolean bench_typed_lookup (ppointer container, ppointer key)
+{
+	puint64 *value = BenchTypedMap_lookup ((BenchTypedMap *) container, (puint64) (psize) key);
+
+	return value != NULL && *value == (puint64) (psize) key ? TRUE : FALSE;
+}
+
+static void bench_typed_remove (ppointer container, ppointer key)
+{
+	BenchTypedMap_remove ((BenchTypedMap *) container, (puint64) (psize) key);
+}
+
+static psize bench_typed_iterate (ppointer container)
+{
+	psize pos   = 0;
+	psize count = 0;
+
+	while (BenchTypedMap_next ((BenchTypedMap *) container, &pos) != NULL)
+		++count;
+
+	return count;
+}
+
+static void bench_typed_destroy (ppointer container)
+{
+	BenchTypedMap_free ((BenchTypedMap *) container);
+}
+
+/* The list is kept in a head, so it can be updated through a pointer */
+
+static ppointer bench_list_create (void)
+{
+	return p_malloc0 (sizeof (PList *));
+}
+
+static void bench_list_insert (ppointer container, ppointer key)
+{
+	*((PList **) container) = p_list_prepend (*((PList **) container), key);
+}
+
+static pboolean bench_list_lookup (ppointer container, ppointer key)
+{
+	PList *node;
+
+	for (node = *((PList **) container); node != NULL; node = node->next)
+		if (node->data == key)
+			return TRUE;
+
+	return FALSE;
+}
+
+static void bench_list_remove (ppointer container, ppointer key)
+{
+	*((PList **) container) = p_list_remove (*((PList **) container), key);
+}
+
+static psize bench_list_iterate (ppointer container)
+{
+	PList	*node;
+	psize	count = 0;
+
+	for (node = *((PList **) container); node != NULL; node = node->next)
+		++count;
+
+	return count;
+}
+
+static void bench_list_destroy (ppointer container)
+{
+	p_list_free (*((PList **) container));
+	p_free (container);
+}
+
+/* The unbalanced tree degenerates into a list on the sorted keys */
+static const BenchContainer bench_containers[] = {
+	{"binary",    0, PBENCH_SLOW_MAX_SIZE,
+	 bench_binary_create, bench_tree_insert, bench_tree_lookup,
+	 bench_tree_remove, bench_tree_iterate, bench_tree_destroy},
+	{"rb",        0, 0,
+	 bench_rb_create, bench_tree_insert, bench_tree_lookup,
+	 bench_tree_remove, bench_tree_iterate, bench_tree_destroy},
+	{"avl",       0, 0,
+	 bench_avl_create, bench_tree_insert, bench_tree_lookup,
+	 bench_tree_remove, bench_tree_iterate, bench_tree_destroy},
+	{"btree",     0, 0,
+	 bench_btree_create, bench_tree_insert, bench_tree_lookup,
+	 bench_tree_remove, bench_tree_iterate, bench_tree_destroy},
+	{"hashtable", 0, 0,
+	 bench_hash_create, bench_hash_insert, bench_hash_lookup,
+	 bench_hash_remove, bench_hash_iterate, bench_hash_destroy},
+	{"typedmap",  0, 0,
+	 bench_typed_create, bench_typed_insert, bench_typed_lookup,
+	 bench_typed_remove, bench_typed_iterate, bench_typed_destroy},
+	{"list",      PBENCH_SLOW_MAX_SIZE, PBENCH_SLOW_MAX_SIZE,
+	 bench_list_create, bench_list_insert, bench_list_lookup,
+	 bench_list_remove, bench_list_iterate, bench_list_destroy}
+};
+
+/* Key distributions: the keys are always unique, the distribution defines
+ * the order of the operations */
+
+typedef enum BenchDistribution_ {
+	PBENCH_DISTRIBUTION_SEQUENTIAL	= 0,
+	PBENCH_DISTRIBUTION_RANDOM	= 1,
+	PBENCH_DISTRIBUTION_SKEWED	= 2
+} BenchDistribution;
+
+static const pchar *bench_distribution_names[] = {"sequential", "random", "skewed"};
+
+static puint64 bench_random_state = 88172645463325252ULL;
+
+static puint64 bench_random (void)
+{
+	bench_random_state ^= bench_random_state << 13;
+	bench_random_state ^= bench_random_state >> 7;
+	bench_random_state ^= bench_random_state << 17;
+
+	return bench_random_state;
+}
+
+static void bench_shuffle (ppointer *keys, psize count)
+{
+	for (psize i = count; i > 1; --i) {
+		psize		j   = (psize) (bench_random () % i);
+		ppointer	tmp = keys[i - 1];
+
+		keys[i - 1] = keys[j];
+		keys[j]     = tmp;
+	}
+}
+
+/* Fills the keys to insert, to look up and to remove. Skewed lookups hit a
+ * small set of hot keys most of the time: the key index is N * u^4 for an
+ * uniform u, so a half of the lookups goes to the first 6% of the keys */
+static void bench_fill_keys (BenchDistribution	distribution,
+			     psize		count,
+			     ppointer		*insert_keys,
+			     ppointer		*lookup_keys,
+			     ppointer		*remove_keys)
+{
+	for (psize i = 0; i < count; ++i) {
+		if (distribution == PBENCH_DISTRIBUTION_SEQUENTIAL)
+			insert_keys[i] = (ppointer) (i + 1);
+		else
+			insert_keys[i] = (ppointer) ((psize) ((puint32) (i + 1) * 2654435761U));
+	}
+
+	memcpy (lookup_keys, insert_keys, count * sizeof (ppointer));
+	memcpy (remove_keys, insert_keys, count * sizeof (ppointer));
+
+	if (distribution == PBENCH_DISTRIBUTION_SEQUENTIAL)
+		return;
+
+	bench_shuffle (insert_keys, count);
+	bench_shuffle (remove_keys, count);
+
+	if (distribution == PBENCH_DISTRIBUTION_RANDOM) {
+		bench_shuffle (lookup_keys, count);
+		return;
+	}
+
+	for (psize i = 0; i < count; ++i) {
+		double u = (double) (bench_random () >> 11) / 9007199254740992.0;
+
+		lookup_keys[i] = insert_keys[(psize) ((double) count * u * u * u * u)];
+	}
+}
+
+static void bench_report_csv (const BenchContainer	*container,
+			      BenchDistribution		distribution,
+			      psize			size,
+			      const pchar		*operation,
+			      psize			ops,
+			      puint64			usecs,
+			      double			bytes_per_entry)
+{
+	double rate = usecs == 0 ? 0.0 : (double) ops * 1000000.0 / (double) usecs;
+
+	printf ("%s,%s,%lu,%s,%lu,%lu,%.0f,%.1f\n",
+		container->name,
+		bench_distribution_names[distribution],
+		(unsigned long) size,
+		operation,
+		(unsigned long) ops,
+		(unsigned long) usecs,
+		rate,
+		bytes_per_entry);
+}
+
+/* Memory is measured in a separate untimed run, so the accounting doesn't
+ * affect the timings */
+static double bench_measure_memory (const BenchContainer *container, ppointer *keys, psize count)
+{
+	PMemVTable	vtable;
+	ppointer	instance;
+	psize		used;
+
+	vtable.malloc  = bench_mem_alloc;
+	vtable.realloc = bench_mem_realloc;
+	vtable.free    = bench_mem_free;
+
+	bench_mem_used = 0;
+	p_mem_set_vtable (&vtable);
+
+	instance = container->create ();
+
+	for (psize i = 0; i < count; ++i)
+		container->insert (instance, keys[i]);
+
+	used = bench_mem_used;
+
+	container->destroy (instance);
+	p_mem_restore_vtable ();
+
+	return (double) used / (double) count;
+}
+
+static void bench_run (const BenchContainer	*container,
+		       BenchDistribution	distribution,
+		       psize			count)
+{
+	ppointer	*insert_keys = (ppointer *) p_malloc (count * sizeof (ppointer));
+	ppointer	*lookup_keys = (ppointer *) p_malloc (count * sizeof (ppointer));
+	ppointer	*remove_keys = (ppointer *) p_malloc (count * sizeof (ppointer));
+	ppointer	instance;
+	puint64		usecs;
+	psize		found;
+	double		bytes_per_entry;
+
+	bench_fill_keys (distribution, count, insert_keys, lookup_keys, remove_keys);
+
+	bytes_per_entry = bench_measure_memory (container, insert_keys, count);
+	instance        = container->create ();
+
+	P_BENCH_MEASURE (usecs, {
+		for (psize i = 0; i < count; ++i)
+			container->insert (instance, insert_keys[i]);
+	});
+
+	bench_report_csv (container, distribution, count, "insert", count, usecs, bytes_per_entry);
+
+	found = 0;
+
+	P_BENCH_MEASURE (usecs, {
+		for (psize i = 0; i < count; ++i)
+			found += container->lookup (instance, lookup_keys[i]) == TRUE ? 1 : 0;
+	});
+
+	bench_report_csv (container, distribution, count, "lookup", count, usecs, bytes_per_entry);
+
+	if (found != count)
+		fprintf (stderr, "%s: %lu of %lu lookups failed\n",
+			 container->name,
+			 (unsigned long) (count - found),
+			 (unsigned long) count);
+
+	P_BENCH_MEASURE (usecs, {
+		found = container->iterate (instance);
+	});
+
+	bench_report_csv (container, distribution, count, "iterate", count, usecs, bytes_per_entry);
+
+	P_BENCH_MEASURE (usecs, {
+		for (psize i = 0; i < count; ++i)
+			container->remove (instance, remove_keys[i]);
+	});
+
+	bench_report_csv (container, distribution, count, "remove", count, usecs, bytes_per_entry);
+
+	container->destroy (instance);
+
+	p_free (remove_keys);
+	p_free (lookup_keys);
+	p_free (insert_keys);
+}
+
+int main (int argc, char **argv)
+{
+	psize max_size = PBENCH_DEFAULT_MAX_SIZE;
+
+	if (argc > 1 && atol (argv[1]) > 0)
+		max_size = (psize) atol (argv[1]);
+
+	p_libsys_init ();
+
+	printf ("container,distribution,size,operation,ops,usecs,ops_per_sec,bytes_per_entry\n");
+
+	for (psize c = 0; c < sizeof (bench_containers) / sizeof (bench_containers[0]); ++c) {
+		const BenchContainer *container = &bench_containers[c];
+
+		for (pint d = PBENCH_DISTRIBUTION_SEQUENTIAL; d <= PBENCH_DISTRIBUTION_SKEWED; ++d) {
+			psize limit = max_size;
+
+			if (container->max_size > 0 && container->max_size < limit)
+				limit = container->max_size;
+
+			if (d == PBENCH_DISTRIBUTION_SEQUENTIAL &&
+			    container->max_sequential_size > 0 &&
+			    container->max_sequential_size < limit)
+				limit = container->max_sequential_size;
+
+			for (psize size = 1000; size <= limit; size *= 10)
+				bench_run (container, (BenchDistribution) d, size);
+		}
+	}
+
+	p_libsys_shutdown ();
+
+	return 0;
+}
@@ -0,0 +1,112 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "plibsys.h"
+#include "pbenchmacros.h"
+
+#define PCOUNTER_BENCH_ROUNDS		1000000
+#define PCOUNTER_BENCH_MAX_THREADS	256
+
+typedef void (*BenchAddFunc) (ppointer counter);
+
+typedef struct BenchContext_ {
+	ppointer	counter;
+	BenchAddFunc	add_func;
+} BenchContext;
+
+static void bench_atomic_inc (ppointer counter)
+{
+	p_atomic_int64_inc ((volatile pint64 *) counter);
+}
+
+static void * bench_add_thread (void *data)
+{
+	BenchContext *ctx = (BenchContext *) data;
+
+	for (pint round = 0; round < PCOUNTER_BENCH_ROUNDS; ++round)
+		ctx->add_func (ctx->counter);
+
+	return NULL;
+}
+
+static puint64 bench_run_threads (BenchContext *ctx, pint threads)
+{
+	PUThread	*thr[PCOUNTER_BENCH_MAX_THREADS];
+	puint64		usecs;
+
+	P_BENCH_MEASURE (usecs, {
+		for (pint i = 0; i < threads; ++i)
+			thr[i] = p_uthread_create ((PUThreadFunc) bench_add_thread, ctx, TRUE, NULL);
+
+		for (pint i = 0; i < threads; ++i) {
+			p_uthread_join (thr[i]);
+			p_uthread_unref (thr[i]);
+		}
+	});
+
+	return usecs;
+}
+
+P_BENCH_CASE_BEGIN (pcounter_contention_bench)
+{
+	BenchContext		atomic_ctx;
+	BenchContext		counter_ctx;
+	volatile pint64		atomic_value = 0;
+	pint			max_threads  = p_uthread_ideal_count ();
+	pchar			name[64];
+
+	if (max_threads > PCOUNTER_BENCH_MAX_THREADS)
+		max_threads = PCOUNTER_BENCH_MAX_THREADS;
+
+	atomic_ctx.counter   = (ppointer) &atomic_value;
+	atomic_ctx.add_func  = bench_atomic_inc;
+
+	counter_ctx.counter  = p_counter_new (0);
+	counter_ctx.add_func = (BenchAddFunc) p_counter_inc;
+
+	for (pint threads = 1; ; threads *= 2) {
+		if (threads > max_threads)
+			threads = max_threads;
+
+		psize ops = (psize) threads * PCOUNTER_BENCH_ROUNDS;
+
+		snprintf (name, sizeof (name), "Atomic int64 increment, %d threads", threads);
+		p_bench_report (name, ops, bench_run_threads (&atomic_ctx, threads));
+
+		snprintf (name, sizeof (name), "PCounter increment, %d threads", threads);
+		p_bench_report (name, ops, bench_run_threads (&counter_ctx, threads));
+
+		if (threads == max_threads)
+			break;
+	}
+
+	p_counter_free ((PCounter *) counter_ctx.counter);
+}
+P_BENCH_CASE_END ()
+
+P_BENCH_SUITE_BEGIN ()
+{
+	P_BENCH_SUITE_RUN_CASE (pcounter_contention_bench);
+}
+P_BENCH_SUITE_END ()
@@ -0,0 +1,493 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "pbenchmacros.h"
+
+#include <string.h>
+
+#if defined (__GNUC__) && (defined (__x86_64__) || defined (__i386__))
+#  include <x86intrin.h>
+#  define PCRYPTOHASH_BENCH_HAS_TSC
+#elif defined (_MSC_VER) && (defined (_M_X64) || defined (_M_IX86))
+#  include <intrin.h>
+#  define PCRYPTOHASH_BENCH_HAS_TSC
+#endif
+
+#define PCRYPTOHASH_BENCH_TOTAL		(64 * 1024 * 1024)
+#define PCRYPTOHASH_BENCH_CHUNK		(64 * 1024)
+#define PCRYPTOHASH_BENCH_MESSAGES	100000
+#define PCRYPTOHASH_BENCH_SWEEP_BYTES	(16 * 1024 * 1024)
+#define PCRYPTOHASH_BENCH_THREAD_BYTES	(16 * 1024 * 1024)
+
+static const struct {
+	PCryptoHashType	type;
+	const pchar	*title;
+} bench_hashes[] = {
+	{ P_CRYPTO_HASH_TYPE_MD5,	"MD5"		},
+	{ P_CRYPTO_HASH_TYPE_SHA1,	"SHA-1"		},
+	{ P_CRYPTO_HASH_TYPE_SHA2_224,	"SHA2-224"	},
+	{ P_CRYPTO_HASH_TYPE_SHA2_256,	"SHA2-256"	},
+	{ P_CRYPTO_HASH_TYPE_SHA2_384,	"SHA2-384"	},
+	{ P_CRYPTO_HASH_TYPE_SHA2_512,	"SHA2-512"	},
+	{ P_CRYPTO_HASH_TYPE_SHA3_224,	"SHA3-224"	},
+	{ P_CRYPTO_HASH_TYPE_SHA3_256,	"SHA3-256"	},
+	{ P_CRYPTO_HASH_TYPE_SHA3_384,	"SHA3-384"	},
+	{ P_CRYPTO_HASH_TYPE_SHA3_512,	"SHA3-512"	},
+	{ P_CRYPTO_HASH_TYPE_GOST,	"GOST R 34.11-94"	},
+	{ P_CRYPTO_HASH_TYPE_BLAKE2B,	"BLAKE2b"	},
+	{ P_CRYPTO_HASH_TYPE_BLAKE2S,	"BLAKE2s"	},
+	{ P_CRYPTO_HASH_TYPE_BLAKE3,	"BLAKE3"	}
+};
+
+static const psize bench_sweep_sizes[] = {
+	16,
+	64,
+	256,
+	1024,
+	4 * 1024,
+	16 * 1024,
+	64 * 1024,
+	1024 * 1024,
+	16 * 1024 * 1024,
+	64 * 1024 * 1024
+};
+
+typedef struct _PCryptoHashBenchThread {
+	PCryptoHashType	type;
+	psize		size;
+	puchar		*data;
+} PCryptoHashBenchThread;
+
+/* Time stamp counter ticks at the nominal frequency on modern x86 CPUs, so
+ * cycles per byte are only exact with frequency scaling and turbo disabled */
+static puint64
+pcryptohash_bench_cycles (void)
+{
+#ifdef PCRYPTOHASH_BENCH_HAS_TSC
+	return (puint64) __rdtsc ();
+#else
+	return 0;
+#endif
+}
+
+static void
+pcryptohash_bench_report_sweep (const pchar	*name,
+				psize		size,
+				psize		messages,
+				puint64		usecs,
+				puint64		cycles)
+{
+	double bytes = (double) size * (double) messages;
+	double rate  = usecs == 0 ? 0.0 : bytes * 1000000.0 / (double) usecs / (1024.0 * 1024.0);
+	double nsecs = (double) usecs * 1000.0 / (double) messages;
+
+	if (cycles != 0)
+		printf ("  %-32s %10lu B %12.1f MB/s %14.1f ns/msg %10.2f cycles/B\n",
+			name,
+			(unsigned long) size,
+			rate,
+			nsecs,
+			(double) cycles / bytes);
+	else
+		printf ("  %-32s %10lu B %12.1f MB/s %14.1f ns/msg %10s cycles/B\n",
+			name,
+			(unsigned long) size,
+			rate,
+			nsecs,
+			"n/a");
+}
+
+static ppointer
+pcryptohash_bench_thread_func (ppointer arg)
+{
+	PCryptoHashBenchThread	*thread = (PCryptoHashBenchThread *) arg;
+	puchar			digest[P_CRYPTO_HASH_MAX_DIGEST_SIZE];
+
+	for (psize done = 0; done < PCRYPTOHASH_BENCH_THREAD_BYTES; done += thread->size)
+		p_crypto_hash_compute (thread->type, thread->data, thread->size, digest);
+
+	return NULL;
+}
+
+P_BENCH_CASE_BEGIN (pcryptohash_throughput_bench)
+{
+	PCryptoHash	*hash;
+	puchar		*data;
+	puint64		usecs;
+	pchar		name[64];
+
+	if ((data = (puchar *) p_malloc (PCRYPTOHASH_BENCH_CHUNK)) == NULL)
+		return;
+
+	memset (data, 0x5A, PCRYPTOHASH_BENCH_CHUNK);
+
+	for (psize i = 0; i < sizeof (bench_hashes) / sizeof (bench_hashes[0]); ++i) {
+		if ((hash = p_crypto_hash_new (bench_hashes[i].type)) == NULL)
+			continue;
+
+		P_BENCH_MEASURE (usecs, {
+			for (psize done = 0; done < PCRYPTOHASH_BENCH_TOTAL; done += PCRYPTOHASH_BENCH_CHUNK)
+				p_crypto_hash_update (hash, data, PCRYPTOHASH_BENCH_CHUNK);
+
+			p_free (p_crypto_hash_get_string (hash));
+		});
+
+		snprintf (name, sizeof (name), "%s update", bench_hashes[i].title);
+		p_bench_report_bytes (name, PCRYPTOHASH_BENCH_TOTAL, usecs);
+
+		p_crypto_hash_free (hash);
+	}
+
+	p_free (data);
+}
+P_BENCH_CASE_END ()
+
+P_BENCH_CASE_BEGIN (pcryptohash_many_bench)
+{
+	const puchar	**inputs;
+	psize		*lens;
+	puchar		*data;
+	puchar		*digests;
+	PCryptoHash	*hash;
+	puint64		usecs;
+	psize		dig_len;
+	pchar		name[64];
+
+	data    = (puchar *) p_malloc0 (PCRYPTOHASH_BENCH_MESSAGES * 256);
+	inputs  = (const puchar **) p_malloc0 (PCRYPTOHASH_BENCH_MESSAGES * sizeof (puchar *));
+	lens    = (psize *) p_malloc0 (PCRYPTOHASH_BENCH_MESSAGES * sizeof (psize));
+	digests = (puchar *) p_malloc0 (PCRYPTOHASH_BENCH_MESSAGES * 64);
+
+	if (data == NULL || inputs == NULL || lens == NULL || digests == NULL) {
+		p_free (data);
+		p_free (inputs);
+		p_free (lens);
+		p_free (digests);
+		return;
+	}
+
+	memset (data, 0x5A, PCRYPTOHASH_BENCH_MESSAGES * 256);
+
+	for (psize size = 16; size <= 256; size *= 4) {
+		for (psize i = 0; i < PCRYPTOHASH_BENCH_MESSAGES; ++i) {
+			inputs[i] = data + i * 256;
+			lens[i]   = size;
+		}
+
+		for (psize i = 0; i < 4; ++i) {
+			/* Context per message, the way it had to be done before */
+			P_BENCH_MEASURE (usecs, {
+				for (psize j = 0; j < PCRYPTOHASH_BENCH_MESSAGES; ++j) {
+					hash    = p_crypto_hash_new (bench_hashes[i].type);
+					dig_len = 64;
+
+					p_crypto_hash_update (hash, inputs[j], lens[j]);
+					p_crypto_hash_get_digest (hash, digests + j * 64, &dig_len);
+					p_crypto_hash_free (hash);
+				}
+			});
+
+			snprintf (name, sizeof (name), "%s context %lu bytes", bench_hashes[i].title, (unsigned long) size);
+			p_bench_report (name, PCRYPTOHASH_BENCH_MESSAGES, usecs);
+
+			P_BENCH_MEASURE (usecs, {
+				for (psize j = 0; j < PCRYPTOHASH_BENCH_MESSAGES; ++j)
+					p_crypto_hash_compute (bench_hashes[i].type, inputs[j], lens[j], digests + j * 64);
+			});
+
+			snprintf (name, sizeof (name), "%s compute %lu bytes", bench_hashes[i].title, (unsigned long) size);
+			p_bench_report (name, PCRYPTOHASH_BENCH_MESSAGES, usecs);
+
+			P_BENCH_MEASURE (usecs, {
+				p_crypto_hash_compute_many (bench_hashes[i].type,
+							    inputs,
+							    lens,
+							    PCRYPTOHASH_BENCH_MESSAGES,
+							    digests);
+			});
+
+			snprintf (name, sizeof (name), "%s many %lu bytes", bench_hashes[i].title, (unsigned long) size);
+			p_bench_report (name, PCRYPTOHASH_BENCH_MESSAGES, usecs);
+		}
+	}
+
+	p_free (data);
+	p_free (inputs);
+	p_free (lens);
+	p_free (digests);
+}
+P_BENCH_CASE_END ()
+
+P_BENCH_CASE_BEGIN (pcryptohash_blake3_pool_bench)
+{
+	PCryptoHash	*hash;
+	PThreadPool	*pool;
+	puchar		*data;
+	puint64		usecs;
+	pchar		name[64];
+
+	if ((data = (puchar *) p_malloc (PCRYPTOHASH_BENCH_TOTAL)) == NULL)
+		return;
+
+	memset (data, 0x5A, PCRYPTOHASH_BENCH_TOTAL);
+
+	if ((hash = p_crypto_hash_new (P_CRYPTO_HASH_TYPE_BLAKE3)) == NULL) {
+		p_free (data);
+		return;
+	}
+
+	/* Single update of the whole buffer: one thread, then with a pool */
+	for (pint workers = 0; workers <= p_uthread_ideal_count (); workers = workers == 0 ? 1 : workers * 2) {
+		pool = workers == 0 ? NULL : p_thread_pool_new (workers);
+
+		p_crypto_hash_set_thread_pool (hash, pool);
+		p_crypto_hash_reset (hash);
+
+		P_BENCH_MEASURE (usecs, {
+			p_crypto_hash_update (hash, data, PCRYPTOHASH_BENCH_TOTAL);
+			p_free (p_crypto_hash_get_string (hash));
+		});
+
+		snprintf (name, sizeof (name), "BLAKE3 %d pool workers", (int) workers);
+		p_bench_report_bytes (name, PCRYPTOHASH_BENCH_TOTAL, usecs);
+
+		p_crypto_hash_set_thread_pool (hash, NULL);
+
+		if (pool != NULL)
+			p_thread_pool_free (pool);
+	}
+
+	p_crypto_hash_free (hash);
+	p_free (data);
+}
+P_BENCH_CASE_END ()
+
+P_BENCH_CASE_BEGIN (pcryptohash_file_bench)
+{
+	puchar		*data;
+	puchar		digest[P_CRYPTO_HASH_MAX_DIGEST_SIZE];
+	puint64		usecs;
+	FILE		*file;
+	const pchar	*path = "." P_DIR_SEPARATOR "pcryptohash_bench_file.bin";
+
+	if ((data = (puchar *) p_malloc (PCRYPTOHASH_BENCH_TOTAL)) == NULL)
+		return;
+
+	memset (data, 0x5A, PCRYPTOHASH_BENCH_TOTAL);
+
+	if ((file = fopen (path, "wb")) == NULL) {
+		p_free (data);
+		return;
+	}
+
+	fwrite (data, 1, PCRYPTOHASH_BENCH_TOTAL, file);
+	fclose (file);
+
+	P_BENCH_MEASURE (usecs, {
+		p_crypto_hash_compute (P_CRYPTO_HASH_TYPE_BLAKE3, data, PCRYPTOHASH_BENCH_TOTAL, digest);
+	});
+
+	p_bench_report_bytes ("BLAKE3 memory", PCRYPTOHASH_BENCH_TOTAL, usecs);
+
+	/* The file is in the page cache after writing, so it's the overhead only */
+	P_BENCH_MEASURE (usecs, {
+		p_crypto_hash_file (P_CRYPTO_HASH_TYPE_BLAKE3, path, digest, NULL);
+	});
+
+	p_bench_report_bytes ("BLAKE3 file", PCRYPTOHASH_BENCH_TOTAL, usecs);
+
+	p_file_remove (path, NULL);
+	p_free (data);
+}
+P_BENCH_CASE_END ()
+
+P_BENCH_CASE_BEGIN (pcryptohash_string_bench)
+{
+	PCryptoHash	*hash;
+	pchar		hex[P_CRYPTO_HASH_MAX_DIGEST_SIZE * 2 + 1];
+	puint64		usecs;
+
+	if ((hash = p_crypto_hash_new (P_CRYPTO_HASH_TYPE_SHA2_256)) == NULL)
+		return;
+
+	p_crypto_hash_update (hash, (const puchar *) "abc", 3);
+
+	/* The hash is closed after the first call, only the encoding is measured */
+	P_BENCH_MEASURE (usecs, {
+		for (psize i = 0; i < PCRYPTOHASH_BENCH_MESSAGES * 10; ++i)
+			p_free (p_crypto_hash_get_string (hash));
+	});
+
+	p_bench_report ("SHA2-256 get_string", PCRYPTOHASH_BENCH_MESSAGES * 10, usecs);
+
+	P_BENCH_MEASURE (usecs, {
+		for (psize i = 0; i < PCRYPTOHASH_BENCH_MESSAGES * 10; ++i)
+			p_crypto_hash_get_string_into (hash, hex, sizeof (hex));
+	});
+
+	p_bench_report ("SHA2-256 get_string_into", PCRYPTOHASH_BENCH_MESSAGES * 10, usecs);
+
+	p_crypto_hash_free (hash);
+}
+P_BENCH_CASE_END ()
+
+P_BENCH_CASE_BEGIN (pcryptohash_sweep_bench)
+{
+	puchar		*data;
+	puchar		digest[P_CRYPTO_HASH_MAX_DIGEST_SIZE];
+	puint64		usecs;
+	puint64		cycles;
+	psize		messages;
+
+	if ((data = (puchar *) p_malloc (PCRYPTOHASH_BENCH_TOTAL)) == NULL)
+		return;
+
+	memset (data, 0x5A, PCRYPTOHASH_BENCH_TOTAL);
+
+	printf ("  Implementations:\n");
+
+	for (psize i = 0; i < sizeof (bench_hashes) / sizeof (bench_hashes[0]); ++i)
+		printf ("    %-30s %s\n",
+			bench_hashes[i].title,
+			p_crypto_hash_get_implementation (bench_hashes[i].type));
+
+	for (psize i = 0; i < sizeof (bench_hashes) / sizeof (bench_hashes[0]); ++i) {
+		for (psize j = 0; j < sizeof (bench_sweep_sizes) / sizeof (bench_sweep_sizes[0]); ++j) {
+			messages = PCRYPTOHASH_BENCH_SWEEP_BYTES / bench_sweep_sizes[j];
+
+			if (messages == 0)
+				messages = 1;
+
+			/* Warm up the caches and the lazy CPU feature detection */
+			p_crypto_hash_compute (bench_hashes[i].type, data, bench_sweep_sizes[j], digest);
+
+			cycles = pcryptohash_bench_cycles ();
+
+			P_BENCH_MEASURE (usecs, {
+				for (psize k = 0; k < messages; ++k)
+					p_crypto_hash_compute (bench_hashes[i].type, data, bench_sweep_sizes[j], digest);
+			});
+
+			cycles = pcryptohash_bench_cycles () - cycles;
+
+			pcryptohash_bench_report_sweep (bench_hashes[i].title,
+							bench_sweep_sizes[j],
+							messages,
+							usecs,
+							cycles);
+		}
+	}
+
+	p_free (data);
+}
+P_BENCH_CASE_END ()
+
+P_BENCH_CASE_BEGIN (pcryptohash_threads_bench)
+{
+	PCryptoHashBenchThread	*threads;
+	PUThread		**handles;
+	puint64			usecs;
+	pint			count;
+	pint			started;
+	pchar			name[64];
+
+	if ((count = p_uthread_ideal_count ()) < 1)
+		count = 1;
+
+	threads = (PCryptoHashBenchThread *) p_malloc0 (count * sizeof (PCryptoHashBenchThread));
+	handles = (PUThread **) p_malloc0 (count * sizeof (PUThread *));
+
+	if (threads == NULL || handles == NULL) {
+		p_free (threads);
+		p_free (handles);
+		return;
+	}
+
+	/* Every thread hashes its own buffer, there is no sharing between them */
+	for (pint i = 0; i < count; ++i) {
+		if ((threads[i].data = (puchar *) p_malloc (1024 * 1024)) == NULL)
+			goto cleanup;
+
+		memset (threads[i].data, 0x5A, 1024 * 1024);
+	}
+
+	for (psize i = 0; i < sizeof (bench_hashes) / sizeof (bench_hashes[0]); ++i) {
+		for (psize size = 64; size <= 1024 * 1024; size *= 128) {
+			for (pint j = 0; j < count; ++j) {
+				threads[j].type = bench_hashes[i].type;
+				threads[j].size = size;
+			}
+
+			started = 0;
+
+			P_BENCH_MEASURE (usecs, {
+				for (; started < count; ++started) {
+					handles[started] = p_uthread_create (pcryptohash_bench_thread_func,
+									     &threads[started],
+									     TRUE,
+									     NULL);
+
+					if (handles[started] == NULL)
+						break;
+				}
+
+				for (pint j = 0; j < started; ++j) {
+					p_uthread_join (handles[j]);
+					p_uthread_unref (handles[j]);
+				}
+			});
+
+			snprintf (name,
+				  sizeof (name),
+				  "%s %lu B x %d threads",
+				  bench_hashes[i].title,
+				  (unsigned long) size,
+				  (int) started);
+
+			p_bench_report_bytes (name, (puint64) PCRYPTOHASH_BENCH_THREAD_BYTES * started, usecs);
+		}
+	}
+
+cleanup:
+	for (pint i = 0; i < count; ++i)
+		p_free (threads[i].data);
+
+	p_free (threads);
+	p_free (handles);
+}
+P_BENCH_CASE_END ()
+
+P_BENCH_SUITE_BEGIN ()
+{
+	P_BENCH_SUITE_RUN_CASE (pcryptohash_throughput_bench);
+	P_BENCH_SUITE_RUN_CASE (pcryptohash_many_bench);
+	P_BENCH_SUITE_RUN_CASE (pcryptohash_blake3_pool_bench);
+	P_BENCH_SUITE_RUN_CASE (pcryptohash_file_bench);
+	P_BENCH_SUITE_RUN_CASE (pcryptohash_string_bench);
+	P_BENCH_SUITE_RUN_CASE (pcryptohash_sweep_bench);
+	P_BENCH_SUITE_RUN_CASE (pcryptohash_threads_bench);
+}
+P_BENCH_SUITE_END ()
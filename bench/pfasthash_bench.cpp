@@ -0,0 +1,136 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "pbenchmacros.h"
+
+#include <string.h>
+
+#define PFASTHASH_BENCH_TOTAL		(256 * 1024 * 1024)
+#define PFASTHASH_BENCH_CHUNK		(64 * 1024)
+#define PFASTHASH_BENCH_KEYS		1000000
+
+static const struct {
+	PFastHashType	type;
+	const pchar	*title;
+} bench_hashes[] = {
+	{ P_FAST_HASH_TYPE_XXH3_64,	"xxHash3-64"	},
+	{ P_FAST_HASH_TYPE_XXH3_128,	"xxHash3-128"	},
+	{ P_FAST_HASH_TYPE_CRC32C,	"CRC32C"	}
+};
+
+P_BENCH_CASE_BEGIN (pfasthash_throughput_bench)
+{
+	PFastHash	*hash;
+	PCryptoHash	*crypto_hash;
+	puchar		*data;
+	puint64		usecs;
+	puint64		sink = 0;
+	pchar		name[64];
+
+	if ((data = (puchar *) p_malloc (PFASTHASH_BENCH_CHUNK)) == NULL)
+		return;
+
+	memset (data, 0x5A, PFASTHASH_BENCH_CHUNK);
+
+	for (psize i = 0; i < sizeof (bench_hashes) / sizeof (bench_hashes[0]); ++i) {
+		if ((hash = p_fast_hash_new (bench_hashes[i].type, 0)) == NULL)
+			continue;
+
+		P_BENCH_MEASURE (usecs, {
+			for (psize done = 0; done < PFASTHASH_BENCH_TOTAL; done += PFASTHASH_BENCH_CHUNK)
+				p_fast_hash_update (hash, data, PFASTHASH_BENCH_CHUNK);
+
+			sink += p_fast_hash_get_value (hash);
+		});
+
+		snprintf (name, sizeof (name), "%s update", bench_hashes[i].title);
+		p_bench_report_bytes (name, PFASTHASH_BENCH_TOTAL, usecs);
+
+		p_fast_hash_free (hash);
+	}
+
+	/* The fastest cryptographic hash for the reference */
+	if ((crypto_hash = p_crypto_hash_new (P_CRYPTO_HASH_TYPE_BLAKE3)) != NULL) {
+		P_BENCH_MEASURE (usecs, {
+			for (psize done = 0; done < PFASTHASH_BENCH_TOTAL; done += PFASTHASH_BENCH_CHUNK)
+				p_crypto_hash_update (crypto_hash, data, PFASTHASH_BENCH_CHUNK);
+
+			p_free (p_crypto_hash_get_string (crypto_hash));
+		});
+
+		p_bench_report_bytes ("BLAKE3 update", PFASTHASH_BENCH_TOTAL, usecs);
+
+		p_crypto_hash_free (crypto_hash);
+	}
+
+	P_UNUSED (sink);
+
+	p_free (data);
+}
+P_BENCH_CASE_END ()
+
+P_BENCH_CASE_BEGIN (pfasthash_keys_bench)
+{
+	pchar		key[64];
+	puint64		usecs;
+	puint64		sink = 0;
+	pchar		name[64];
+
+	for (psize size = 8; size <= 64; size *= 2) {
+		memset (key, 'k', sizeof (key));
+		key[size - 1] = '\0';
+
+		P_BENCH_MEASURE (usecs, {
+			for (psize i = 0; i < PFASTHASH_BENCH_KEYS; ++i) {
+				key[0] = (pchar) ('a' + (i & 0x0F));
+				sink += p_str_hash (key);
+			}
+		});
+
+		snprintf (name, sizeof (name), "p_str_hash %lu bytes", (unsigned long) size);
+		p_bench_report (name, PFASTHASH_BENCH_KEYS, usecs);
+
+		P_BENCH_MEASURE (usecs, {
+			for (psize i = 0; i < PFASTHASH_BENCH_KEYS; ++i) {
+				key[0] = (pchar) ('a' + (i & 0x0F));
+				sink += p_fast_hash_crc32c (0, key, size);
+			}
+		});
+
+		snprintf (name, sizeof (name), "CRC32C %lu bytes", (unsigned long) size);
+		p_bench_report (name, PFASTHASH_BENCH_KEYS, usecs);
+	}
+
+	P_UNUSED (sink);
+}
+P_BENCH_CASE_END ()
+
+P_BENCH_SUITE_BEGIN ()
+{
+	P_BENCH_SUITE_RUN_CASE (pfasthash_throughput_bench);
+	P_BENCH_SUITE_RUN_CASE (pfasthash_keys_bench);
+}
+P_BENCH_SUITE_END ()
@@ -0,0 +1,132 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "pbenchmacros.h"
+
+#define PFASTMUTEX_BENCH_ROUNDS		200000
+#define PFASTMUTEX_BENCH_WORK		16
+#define PFASTMUTEX_BENCH_MAX_THREADS	256
+
+typedef pboolean (*BenchLockFunc) (ppointer lock);
+
+typedef struct BenchContext_ {
+	ppointer		lock;
+	BenchLockFunc		lock_func;
+	BenchLockFunc		unlock_func;
+	volatile puint64	counter;
+} BenchContext;
+
+static void * bench_lock_thread (void *data)
+{
+	BenchContext *ctx = (BenchContext *) data;
+
+	for (pint round = 0; round < PFASTMUTEX_BENCH_ROUNDS; ++round) {
+		ctx->lock_func (ctx->lock);
+
+		/* Very short critical section */
+		for (pint i = 0; i < PFASTMUTEX_BENCH_WORK; ++i)
+			++ctx->counter;
+
+		ctx->unlock_func (ctx->lock);
+	}
+
+	return NULL;
+}
+
+static puint64 bench_run_threads (BenchContext *ctx, pint threads)
+{
+	PUThread	*thr[PFASTMUTEX_BENCH_MAX_THREADS];
+	puint64		usecs;
+
+	ctx->counter = 0;
+
+	P_BENCH_MEASURE (usecs, {
+		for (pint i = 0; i < threads; ++i)
+			thr[i] = p_uthread_create ((PUThreadFunc) bench_lock_thread, ctx, TRUE, NULL);
+
+		for (pint i = 0; i < threads; ++i) {
+			p_uthread_join (thr[i]);
+			p_uthread_unref (thr[i]);
+		}
+	});
+
+	return usecs;
+}
+
+P_BENCH_CASE_BEGIN (pfastmutex_contention_bench)
+{
+	BenchContext	mutex_ctx;
+	BenchContext	spin_ctx;
+	BenchContext	fast_ctx;
+	pint		max_threads = p_uthread_ideal_count () * 2;
+	pchar		name[64];
+
+	if (max_threads > PFASTMUTEX_BENCH_MAX_THREADS)
+		max_threads = PFASTMUTEX_BENCH_MAX_THREADS;
+
+	mutex_ctx.lock        = p_mutex_new ();
+	mutex_ctx.lock_func   = (BenchLockFunc) p_mutex_lock;
+	mutex_ctx.unlock_func = (BenchLockFunc) p_mutex_unlock;
+
+	spin_ctx.lock         = p_spinlock_new ();
+	spin_ctx.lock_func    = (BenchLockFunc) p_spinlock_lock;
+	spin_ctx.unlock_func  = (BenchLockFunc) p_spinlock_unlock;
+
+	fast_ctx.lock         = p_fast_mutex_new (0);
+	fast_ctx.lock_func    = (BenchLockFunc) p_fast_mutex_lock;
+	fast_ctx.unlock_func  = (BenchLockFunc) p_fast_mutex_unlock;
+
+	/* Twice as many threads as CPUs show the oversubscribed case */
+	for (pint threads = 1; ; threads *= 2) {
+		if (threads > max_threads)
+			threads = max_threads;
+
+		psize ops = (psize) threads * PFASTMUTEX_BENCH_ROUNDS;
+
+		snprintf (name, sizeof (name), "PMutex lock + unlock, %d threads", threads);
+		p_bench_report (name, ops, bench_run_threads (&mutex_ctx, threads));
+
+		snprintf (name, sizeof (name), "PSpinLock lock + unlock, %d threads", threads);
+		p_bench_report (name, ops, bench_run_threads (&spin_ctx, threads));
+
+		snprintf (name, sizeof (name), "PFastMutex lock + unlock, %d threads", threads);
+		p_bench_report (name, ops, bench_run_threads (&fast_ctx, threads));
+
+		if (threads == max_threads)
+			break;
+	}
+
+	p_mutex_free ((PMutex *) mutex_ctx.lock);
+	p_spinlock_free ((PSpinLock *) spin_ctx.lock);
+	p_fast_mutex_free ((PFastMutex *) fast_ctx.lock);
+}
+P_BENCH_CASE_END ()
+
+P_BENCH_SUITE_BEGIN ()
+{
+	P_BENCH_SUITE_RUN_CASE (pfastmutex_contention_bench);
+}
+P_BENCH_SUITE_END ()
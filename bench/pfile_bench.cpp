@@ -0,0 +1,226 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "pbenchmacros.h"
+
+#include <string.h>
+
+#define PFILE_BENCH_RECORDS	200000
+#define PFILE_BENCH_RECORD_SIZE	64
+#define PFILE_BENCH_COPY_SIZE	(64 * 1024 * 1024)
+#define PFILE_BENCH_COPY_CHUNK	(1024 * 1024)
+#define PFILE_BENCH_APPEND_SIZE	(64 * 1024 * 1024)
+#define PFILE_BENCH_APPEND_CHUNK	4096
+
+P_BENCH_CASE_BEGIN (pfile_write_bench)
+{
+	PFile		*file;
+	PFileWriter	*writer;
+	PFileVector	vectors[4];
+	puint64		usecs;
+	puint64		offset;
+	pchar		record[PFILE_BENCH_RECORD_SIZE];
+	const pchar	*path = "." P_DIR_SEPARATOR "pfile_bench_file.bin";
+
+	file = p_file_new (path,
+			   P_FILE_OPEN_FLAG_READ | P_FILE_OPEN_FLAG_WRITE |
+			   P_FILE_OPEN_FLAG_CREATE | P_FILE_OPEN_FLAG_TRUNCATE,
+			   NULL);
+
+	if (file == NULL)
+		return;
+
+	memset (record, 'r', sizeof (record));
+
+	/* Log-like workload: a lot of small sequential records */
+	P_BENCH_MEASURE (usecs, {
+		for (pint i = 0; i < PFILE_BENCH_RECORDS; ++i)
+			p_file_write_at (file, record, sizeof (record), (puint64) i * sizeof (record), NULL);
+	});
+
+	p_bench_report_bytes ("Write at, 64 bytes", (puint64) PFILE_BENCH_RECORDS * sizeof (record), usecs);
+
+	P_BENCH_MEASURE (usecs, {
+		for (pint i = 0; i < PFILE_BENCH_RECORDS; i += 4) {
+			for (pint j = 0; j < 4; ++j) {
+				vectors[j].buffer = record;
+				vectors[j].buflen = sizeof (record);
+			}
+
+			p_file_write_vector_at (file, vectors, 4, (puint64) i * sizeof (record), NULL);
+		}
+	});
+
+	p_bench_report_bytes ("Write vector at, 4 x 64 bytes", (puint64) PFILE_BENCH_RECORDS * sizeof (record), usecs);
+
+	writer = p_file_writer_new (file, 0, 0);
+
+	P_BENCH_MEASURE (usecs, {
+		for (pint i = 0; i < PFILE_BENCH_RECORDS; ++i)
+			p_file_writer_write (writer, record, sizeof (record), NULL);
+
+		p_file_writer_flush (writer, NULL);
+	});
+
+	p_bench_report_bytes ("Buffered writer, 64 bytes", (puint64) PFILE_BENCH_RECORDS * sizeof (record), usecs);
+
+	p_file_writer_free (writer);
+
+	P_BENCH_MEASURE (usecs, {
+		offset = 0;
+
+		for (pint i = 0; i < PFILE_BENCH_RECORDS; ++i) {
+			p_file_read_at (file, record, sizeof (record), offset, NULL);
+			offset += sizeof (record);
+		}
+	});
+
+	p_bench_report_bytes ("Read at, 64 bytes", (puint64) PFILE_BENCH_RECORDS * sizeof (record), usecs);
+
+	p_file_free (file);
+	p_file_remove (path, NULL);
+}
+P_BENCH_CASE_END ()
+
+P_BENCH_CASE_BEGIN (pfile_copy_bench)
+{
+	PFile		*src;
+	PFile		*dst;
+	pchar		*chunk;
+	puint64		usecs;
+	PFileCopyMethod	method = P_FILE_COPY_METHOD_NONE;
+	const pchar	*src_path = "." P_DIR_SEPARATOR "pfile_bench_src.bin";
+	const pchar	*dst_path = "." P_DIR_SEPARATOR "pfile_bench_dst.bin";
+
+	if ((chunk = (pchar *) p_malloc (PFILE_BENCH_COPY_CHUNK)) == NULL)
+		return;
+
+	memset (chunk, 'c', PFILE_BENCH_COPY_CHUNK);
+
+	src = p_file_new (src_path,
+			  P_FILE_OPEN_FLAG_READ | P_FILE_OPEN_FLAG_WRITE |
+			  P_FILE_OPEN_FLAG_CREATE | P_FILE_OPEN_FLAG_TRUNCATE,
+			  NULL);
+
+	if (src == NULL) {
+		p_free (chunk);
+		return;
+	}
+
+	for (puint64 offset = 0; offset < PFILE_BENCH_COPY_SIZE; offset += PFILE_BENCH_COPY_CHUNK)
+		p_file_write_at (src, chunk, PFILE_BENCH_COPY_CHUNK, offset, NULL);
+
+	/* Plain user space copy for the reference */
+	P_BENCH_MEASURE (usecs, {
+		dst = p_file_new (dst_path,
+				  P_FILE_OPEN_FLAG_WRITE | P_FILE_OPEN_FLAG_CREATE | P_FILE_OPEN_FLAG_TRUNCATE,
+				  NULL);
+
+		for (puint64 offset = 0; offset < PFILE_BENCH_COPY_SIZE; offset += PFILE_BENCH_COPY_CHUNK) {
+			p_file_read_at (src, chunk, PFILE_BENCH_COPY_CHUNK, offset, NULL);
+			p_file_write_at (dst, chunk, PFILE_BENCH_COPY_CHUNK, offset, NULL);
+		}
+
+		p_file_free (dst);
+	});
+
+	p_bench_report_bytes ("Read and write loop, 1 MiB", PFILE_BENCH_COPY_SIZE, usecs);
+
+	P_BENCH_MEASURE (usecs, {
+		method = p_file_copy (src_path,
+				      dst_path,
+				      P_FILE_COPY_FLAG_OVERWRITE | P_FILE_COPY_FLAG_NO_CLONE,
+				      NULL);
+	});
+
+	p_bench_report_bytes (method == P_FILE_COPY_METHOD_KERNEL ? "File copy, kernel" :
+			      method == P_FILE_COPY_METHOD_SYSTEM ? "File copy, system" :
+							            "File copy, buffer",
+			      PFILE_BENCH_COPY_SIZE,
+			      usecs);
+
+	P_BENCH_MEASURE (usecs, {
+		method = p_file_copy (src_path, dst_path, P_FILE_COPY_FLAG_OVERWRITE, NULL);
+	});
+
+	if (method == P_FILE_COPY_METHOD_CLONE)
+		p_bench_report_bytes ("File copy, clone", PFILE_BENCH_COPY_SIZE, usecs);
+
+	p_file_free (src);
+	p_file_remove (src_path, NULL);
+	p_file_remove (dst_path, NULL);
+	p_free (chunk);
+}
+P_BENCH_CASE_END ()
+
+P_BENCH_CASE_BEGIN (pfile_preallocate_bench)
+{
+	PFile		*file;
+	pchar		chunk[PFILE_BENCH_APPEND_CHUNK];
+	puint64		usecs;
+	const pchar	*path = "." P_DIR_SEPARATOR "pfile_bench_append.bin";
+
+	memset (chunk, 'a', sizeof (chunk));
+
+	for (pint pass = 0; pass < 2; ++pass) {
+		file = p_file_new (path,
+				   P_FILE_OPEN_FLAG_WRITE | P_FILE_OPEN_FLAG_CREATE | P_FILE_OPEN_FLAG_TRUNCATE,
+				   NULL);
+
+		if (file == NULL)
+			return;
+
+		/* Reserve the space ahead without changing the file size */
+		if (pass == 1 && p_file_preallocate (file, 0, PFILE_BENCH_APPEND_SIZE, TRUE, NULL) == FALSE) {
+			p_file_free (file);
+			break;
+		}
+
+		P_BENCH_MEASURE (usecs, {
+			for (puint64 offset = 0; offset < PFILE_BENCH_APPEND_SIZE; offset += sizeof (chunk))
+				p_file_write_at (file, chunk, sizeof (chunk), offset, NULL);
+
+			p_file_sync_data (file, NULL);
+		});
+
+		p_bench_report_bytes (pass == 0 ? "Append 4 KiB, sync" : "Append 4 KiB, preallocated, sync",
+				      PFILE_BENCH_APPEND_SIZE,
+				      usecs);
+
+		p_file_free (file);
+	}
+
+	p_file_remove (path, NULL);
+}
+P_BENCH_CASE_END ()
+
+P_BENCH_SUITE_BEGIN ()
+{
+	P_BENCH_SUITE_RUN_CASE (pfile_write_bench);
+	P_BENCH_SUITE_RUN_CASE (pfile_copy_bench);
+	P_BENCH_SUITE_RUN_CASE (pfile_preallocate_bench);
+}
+P_BENCH_SUITE_END ()
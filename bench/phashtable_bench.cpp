@@ -0,0 +1,303 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "pbenchmacros.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define PHASHTABLE_BENCH_CHAINED_SIZE	101
+
+/* Reference chained hash table with a fixed number of buckets, the same
+ * layout PHashTable had before switching to open addressing */
+
+typedef struct BenchChainedNode_ {
+	struct BenchChainedNode_	*next;
+	ppointer			key;
+	ppointer			value;
+} BenchChainedNode;
+
+typedef struct BenchChainedTable_ {
+	BenchChainedNode		*table[PHASHTABLE_BENCH_CHAINED_SIZE];
+} BenchChainedTable;
+
+static puint bench_chained_hash (pconstpointer key)
+{
+	return (puint) (((psize) (P_POINTER_TO_INT (key) + 37)) % PHASHTABLE_BENCH_CHAINED_SIZE);
+}
+
+static void bench_chained_insert (BenchChainedTable *table, ppointer key, ppointer value)
+{
+	puint			hash = bench_chained_hash (key);
+	BenchChainedNode	*node;
+
+	for (node = table->table[hash]; node != NULL; node = node->next)
+		if (node->key == key) {
+			node->value = value;
+			return;
+		}
+
+	node = (BenchChainedNode *) p_malloc0 (sizeof (BenchChainedNode));
+
+	node->key   = key;
+	node->value = value;
+	node->next  = table->table[hash];
+
+	table->table[hash] = node;
+}
+
+static ppointer bench_chained_lookup (BenchChainedTable *table, pconstpointer key)
+{
+	BenchChainedNode *node;
+
+	for (node = table->table[bench_chained_hash (key)]; node != NULL; node = node->next)
+		if (node->key == key)
+			return node->value;
+
+	return (ppointer) -1;
+}
+
+static void bench_chained_free (BenchChainedTable *table)
+{
+	BenchChainedNode	*node;
+	BenchChainedNode	*next;
+
+	for (int i = 0; i < PHASHTABLE_BENCH_CHAINED_SIZE; ++i)
+		for (node = table->table[i]; node != NULL; node = next) {
+			next = node->next;
+			p_free (node);
+		}
+
+	p_free (table);
+}
+
+/* Keys look like aligned heap pointers, the common case for session tables */
+static ppointer * bench_make_keys (psize count)
+{
+	ppointer	*keys = (ppointer *) p_malloc0 (count * sizeof (ppointer));
+	psize		base  = 0x10000;
+
+	for (psize i = 0; i < count; ++i)
+		keys[i] = (ppointer) (base + i * 16);
+
+	/* Shuffle to avoid sequential access pattern */
+	for (psize i = count - 1; i > 0; --i) {
+		psize		j   = (psize) rand () % (i + 1);
+		ppointer	tmp = keys[i];
+
+		keys[i] = keys[j];
+		keys[j] = tmp;
+	}
+
+	return keys;
+}
+
+static void bench_hash_table_run (psize count)
+{
+	ppointer		*keys = bench_make_keys (count);
+	PHashTable		*table;
+	BenchChainedTable	*chained;
+	puint64			usecs;
+	psize			found;
+
+	printf ("Entries: %lu\n", (unsigned long) count);
+
+	chained = (BenchChainedTable *) p_malloc0 (sizeof (BenchChainedTable));
+
+	P_BENCH_MEASURE (usecs, {
+		for (psize i = 0; i < count; ++i)
+			bench_chained_insert (chained, keys[i], keys[i]);
+	});
+
+	p_bench_report ("chained insert", count, usecs);
+
+	found = 0;
+
+	P_BENCH_MEASURE (usecs, {
+		for (psize i = 0; i < count; ++i)
+			found += bench_chained_lookup (chained, keys[i]) == keys[i] ? 1 : 0;
+	});
+
+	p_bench_report ("chained lookup", count, usecs);
+
+	bench_chained_free (chained);
+
+	table = p_hash_table_new ();
+
+	P_BENCH_MEASURE (usecs, {
+		for (psize i = 0; i < count; ++i)
+			p_hash_table_insert (table, keys[i], keys[i]);
+	});
+
+	p_bench_report ("open addressing insert", count, usecs);
+
+	P_BENCH_MEASURE (usecs, {
+		for (psize i = 0; i < count; ++i)
+			found += p_hash_table_lookup (table, keys[i]) == keys[i] ? 1 : 0;
+	});
+
+	p_bench_report ("open addressing lookup", count, usecs);
+
+	P_BENCH_MEASURE (usecs, {
+		for (psize i = 0; i < count; ++i)
+			p_hash_table_remove (table, keys[i]);
+	});
+
+	p_bench_report ("open addressing remove", count, usecs);
+
+	if (found != count * 2)
+		printf ("  lookup mismatch: %lu found\n", (unsigned long) found);
+
+	p_hash_table_free (table);
+	p_free (keys);
+}
+
+P_BENCH_CASE_BEGIN (phashtable_chained_vs_open_bench)
+{
+	srand (1);
+
+	bench_hash_table_run (1000);
+	bench_hash_table_run (10000);
+	bench_hash_table_run (100000);
+}
+P_BENCH_CASE_END ()
+
+P_BENCH_CASE_BEGIN (phashtable_bulk_load_bench)
+{
+	psize		count = 500000;
+	ppointer	*keys;
+	PHashTable	*table;
+	puint64		usecs;
+
+	srand (1);
+	keys = bench_make_keys (count);
+
+	printf ("Entries: %lu\n", (unsigned long) count);
+
+	table = p_hash_table_new ();
+
+	P_BENCH_MEASURE (usecs, {
+		for (psize i = 0; i < count; ++i)
+			p_hash_table_insert (table, keys[i], keys[i]);
+	});
+
+	p_bench_report ("growing insert", count, usecs);
+	p_hash_table_free (table);
+
+	table = p_hash_table_new_sized (count);
+
+	P_BENCH_MEASURE (usecs, {
+		for (psize i = 0; i < count; ++i)
+			p_hash_table_insert (table, keys[i], keys[i]);
+	});
+
+	p_bench_report ("pre-sized insert", count, usecs);
+	p_hash_table_free (table);
+
+	table = p_hash_table_new ();
+
+	P_BENCH_MEASURE (usecs, {
+		p_hash_table_insert_bulk (table, keys, keys, count);
+	});
+
+	p_bench_report ("bulk insert", count, usecs);
+	p_hash_table_free (table);
+
+	p_free (keys);
+}
+P_BENCH_CASE_END ()
+
+/* Header lines are looked up by the name slice, PHashTable needs a
+ * zero-terminated copy of it */
+P_BENCH_CASE_BEGIN (phashtable_string_keys_bench)
+{
+	const psize	names = 64;
+	const psize	count = 1000000;
+	pchar		(*lines)[48];
+	psize		*name_lens;
+	pchar		name[48];
+	PHashTable	*table;
+	PStrHashTable	*str_table;
+	puint64		usecs;
+	psize		found = 0;
+
+	lines     = (pchar (*)[48]) p_malloc0 (names * sizeof (*lines));
+	name_lens = (psize *) p_malloc0 (names * sizeof (psize));
+	table     = p_hash_table_new_full (p_str_hash, p_str_equal, p_free, NULL);
+	str_table = p_str_hash_table_new (NULL);
+
+	for (psize i = 0; i < names; ++i) {
+		snprintf (name, sizeof (name), "X-Header-Name-%lu", (unsigned long) i);
+		snprintf (lines[i], sizeof (lines[i]), "%s: value", name);
+
+		name_lens[i] = strlen (name);
+
+		p_hash_table_insert (table, p_strdup (name), PINT_TO_POINTER (i + 1));
+		p_str_hash_table_insert (str_table, name, PINT_TO_POINTER (i + 1));
+	}
+
+	printf ("Names: %lu\n", (unsigned long) names);
+
+	P_BENCH_MEASURE (usecs, {
+		for (psize i = 0; i < count; ++i) {
+			psize idx = i % names;
+
+			memcpy (name, lines[idx], name_lens[idx]);
+			name[name_lens[idx]] = '\0';
+
+			found += p_hash_table_lookup (table, name) != (ppointer) -1;
+		}
+	});
+
+	p_bench_report ("PHashTable, p_str_hash() lookup", count, usecs);
+
+	P_BENCH_MEASURE (usecs, {
+		for (psize i = 0; i < count; ++i) {
+			psize idx = i % names;
+
+			found += p_str_hash_table_lookup_len (str_table, lines[idx], name_lens[idx]) != (ppointer) -1;
+		}
+	});
+
+	p_bench_report ("PStrHashTable slice lookup", count, usecs);
+
+	if (found != count * 2)
+		printf ("  Unexpected result\n");
+
+	p_hash_table_free (table);
+	p_str_hash_table_free (str_table);
+	p_free (name_lens);
+	p_free (lines);
+}
+P_BENCH_CASE_END ()
+
+P_BENCH_SUITE_BEGIN ()
+{
+	P_BENCH_SUITE_RUN_CASE (phashtable_chained_vs_open_bench);
+	P_BENCH_SUITE_RUN_CASE (phashtable_bulk_load_bench);
+	P_BENCH_SUITE_RUN_CASE (phashtable_string_keys_bench);
+}
+P_BENCH_SUITE_END ()
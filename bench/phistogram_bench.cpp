@@ -0,0 +1,128 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "plibsys.h"
+#include "pbenchmacros.h"
+
+#include <stdlib.h>
+
+#define PHISTOGRAM_BENCH_ROUNDS		1000000
+#define PHISTOGRAM_BENCH_THREADS	4
+
+static PHistogram *	bench_histogram = NULL;
+
+static int bench_compare_values (const void *a, const void *b)
+{
+	puint64 va = *((const puint64 *) a);
+	puint64 vb = *((const puint64 *) b);
+
+	return va < vb ? -1 : (va > vb ? 1 : 0);
+}
+
+/* Latency-like values: mostly around a microsecond with a long tail */
+static puint64 bench_value (pint round)
+{
+	puint64 x = (puint64) round * 0x9E3779B97F4A7C15ULL;
+
+	x ^= x >> 29;
+
+	return 500 + (x & 0x3FF) + ((x & 0xF000) == 0 ? (x >> 40) : 0);
+}
+
+static void * bench_record_thread (void *)
+{
+	for (pint round = 0; round < PHISTOGRAM_BENCH_ROUNDS; ++round)
+		p_histogram_record (bench_histogram, bench_value (round));
+
+	return NULL;
+}
+
+P_BENCH_CASE_BEGIN (phistogram_record_bench)
+{
+	PHistogram		*histogram;
+	PUThread		*thr[PHISTOGRAM_BENCH_THREADS];
+	puint64			*samples;
+	volatile puint64	sink = 0;
+	puint64			usecs;
+
+	histogram = p_histogram_new (3600000000000ULL, 3, FALSE);
+	samples   = (puint64 *) p_malloc (sizeof (puint64) * PHISTOGRAM_BENCH_ROUNDS);
+
+	/* Reference: keeping the raw samples and sorting them for a percentile */
+	P_BENCH_MEASURE (usecs, {
+		for (pint round = 0; round < PHISTOGRAM_BENCH_ROUNDS; ++round)
+			samples[round] = bench_value (round);
+	});
+
+	p_bench_report ("Raw samples, record", PHISTOGRAM_BENCH_ROUNDS, usecs);
+
+	P_BENCH_MEASURE (usecs, {
+		qsort (samples, PHISTOGRAM_BENCH_ROUNDS, sizeof (puint64), bench_compare_values);
+		sink += samples[PHISTOGRAM_BENCH_ROUNDS / 100 * 99];
+	});
+
+	p_bench_report ("Raw samples, sort for percentile", 1, usecs);
+
+	P_BENCH_MEASURE (usecs, {
+		for (pint round = 0; round < PHISTOGRAM_BENCH_ROUNDS; ++round)
+			p_histogram_record (histogram, bench_value (round));
+	});
+
+	p_bench_report ("PHistogram record", PHISTOGRAM_BENCH_ROUNDS, usecs);
+
+	P_BENCH_MEASURE (usecs, {
+		sink += p_histogram_get_percentile (histogram, 99.0);
+	});
+
+	p_bench_report ("PHistogram percentile", 1, usecs);
+
+	p_histogram_free (histogram);
+	p_free (samples);
+
+	/* Concurrent recording from several threads */
+	bench_histogram = p_histogram_new (3600000000000ULL, 3, TRUE);
+
+	P_BENCH_MEASURE (usecs, {
+		for (pint i = 0; i < PHISTOGRAM_BENCH_THREADS; ++i)
+			thr[i] = p_uthread_create ((PUThreadFunc) bench_record_thread, NULL, TRUE, NULL);
+
+		for (pint i = 0; i < PHISTOGRAM_BENCH_THREADS; ++i) {
+			p_uthread_join (thr[i]);
+			p_uthread_unref (thr[i]);
+		}
+	});
+
+	p_bench_report ("PHistogram concurrent record, 4 threads",
+			PHISTOGRAM_BENCH_ROUNDS * PHISTOGRAM_BENCH_THREADS, usecs);
+
+	p_histogram_free (bench_histogram);
+	bench_histogram = NULL;
+}
+P_BENCH_CASE_END ()
+
+P_BENCH_SUITE_BEGIN ()
+{
+	P_BENCH_SUITE_RUN_CASE (phistogram_record_bench);
+}
+P_BENCH_SUITE_END ()
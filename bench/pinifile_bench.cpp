@@ -0,0 +1,178 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "pbenchmacros.h"
+
+#include <stdio.h>
+
+#define PINIFILE_BENCH_SECTIONS	2000
+#define PINIFILE_BENCH_KEYS	200
+#define PINIFILE_BENCH_LOOKUPS	100000
+#define PINIFILE_BENCH_RELOADS	1000
+
+P_BENCH_CASE_BEGIN (pinifile_parse_bench)
+{
+	PIniFile	*ini;
+	FILE		*file;
+	puint64		usecs;
+	psize		bytes;
+	pint		sum;
+	pchar		section[32];
+	pchar		key[32];
+	const pchar	*path = "." P_DIR_SEPARATOR "pinifile_bench_file.ini";
+
+	if ((file = fopen (path, "w")) == NULL)
+		return;
+
+	/* Generated config: many sections, every one with a lot of short values */
+	for (pint i = 0; i < PINIFILE_BENCH_SECTIONS; ++i) {
+		fprintf (file, "[route_%d]\n", i);
+
+		for (pint j = 0; j < PINIFILE_BENCH_KEYS; ++j)
+			fprintf (file, "next_hop_%d = \"10.%d.%d.1\" ; weight %d\n", j, i % 256, j, i + j);
+	}
+
+	bytes = (psize) ftell (file);
+	fclose (file);
+
+	if ((ini = p_ini_file_new (path)) == NULL) {
+		p_file_remove (path, NULL);
+		return;
+	}
+
+	P_BENCH_MEASURE (usecs, {
+		p_ini_file_parse (ini, NULL);
+	});
+
+	p_bench_report_bytes ("Parse", bytes, usecs);
+
+	sum = 0;
+
+	P_BENCH_MEASURE (usecs, {
+		for (pint i = 0; i < PINIFILE_BENCH_LOOKUPS; ++i) {
+			snprintf (section, sizeof (section), "route_%d", i % PINIFILE_BENCH_SECTIONS);
+			snprintf (key, sizeof (key), "next_hop_%d", i % PINIFILE_BENCH_KEYS);
+
+			sum += p_ini_file_is_key_exists (ini, section, key) ? 1 : 0;
+		}
+	});
+
+	p_bench_report ("Lookup", PINIFILE_BENCH_LOOKUPS, usecs);
+
+	if (sum != PINIFILE_BENCH_LOOKUPS)
+		printf ("  Lookup failed: %d keys found\n", sum);
+
+	/* Hot reconfiguration loop: the same parameters are read again and again */
+	sum = 0;
+
+	P_BENCH_MEASURE (usecs, {
+		for (pint i = 0; i < PINIFILE_BENCH_LOOKUPS; ++i)
+			sum += p_ini_file_parameter_int (ini, "route_7", "next_hop_42", 0);
+	});
+
+	p_bench_report ("Read integer", PINIFILE_BENCH_LOOKUPS, usecs);
+
+	P_BENCH_MEASURE (usecs, {
+		for (pint i = 0; i < PINIFILE_BENCH_LOOKUPS; ++i)
+			sum += p_ini_file_parameter_double (ini, "route_7", "next_hop_42", 0.0) > 0.0 ? 1 : 0;
+	});
+
+	p_bench_report ("Read double", PINIFILE_BENCH_LOOKUPS, usecs);
+
+	P_BENCH_MEASURE (usecs, {
+		for (pint i = 0; i < PINIFILE_BENCH_LOOKUPS; ++i)
+			p_free (p_ini_file_parameter_string (ini, "route_7", "next_hop_42", NULL));
+	});
+
+	p_bench_report ("Read string copy", PINIFILE_BENCH_LOOKUPS, usecs);
+
+	P_BENCH_MEASURE (usecs, {
+		for (pint i = 0; i < PINIFILE_BENCH_LOOKUPS; ++i)
+			sum += p_ini_file_parameter_string_view (ini, "route_7", "next_hop_42", NULL) != NULL ? 1 : 0;
+	});
+
+	p_bench_report ("Read string view", PINIFILE_BENCH_LOOKUPS, usecs);
+
+	/* Whole group of settings read at once */
+	P_BENCH_MEASURE (usecs, {
+		for (pint i = 0; i < PINIFILE_BENCH_LOOKUPS; ++i) {
+			sum += p_ini_file_parameter_int (ini, "route_7", "next_hop_1", 0);
+			sum += p_ini_file_parameter_int (ini, "route_7", "next_hop_2", 0);
+			sum += p_ini_file_parameter_int (ini, "route_7", "next_hop_3", 0);
+			sum += p_ini_file_parameter_int (ini, "route_7", "next_hop_4", 0);
+		}
+	});
+
+	p_bench_report ("Read 4 integers one by one", PINIFILE_BENCH_LOOKUPS, usecs);
+
+	pint		values[4];
+	PIniFileQuery	queries[] = {
+		{"next_hop_1", P_INI_FILE_VALUE_INT, &values[0], FALSE},
+		{"next_hop_2", P_INI_FILE_VALUE_INT, &values[1], FALSE},
+		{"next_hop_3", P_INI_FILE_VALUE_INT, &values[2], FALSE},
+		{"next_hop_4", P_INI_FILE_VALUE_INT, &values[3], FALSE}
+	};
+
+	P_BENCH_MEASURE (usecs, {
+		for (pint i = 0; i < PINIFILE_BENCH_LOOKUPS; ++i) {
+			p_ini_file_get_many (ini, "route_7", queries, 4);
+			sum += values[0] + values[1] + values[2] + values[3];
+		}
+	});
+
+	p_bench_report ("Read 4 integers at once", PINIFILE_BENCH_LOOKUPS, usecs);
+
+	/* Periodic reload of an untouched file: the file was written within the
+	 * same second as it was loaded, so mtime can't be trusted and the content
+	 * hash is compared instead */
+	P_BENCH_MEASURE (usecs, {
+		for (pint i = 0; i < PINIFILE_BENCH_RELOADS; ++i)
+			p_ini_file_reload (ini, NULL, NULL);
+	});
+
+	p_bench_report ("Reload unchanged (hash)", PINIFILE_BENCH_RELOADS, usecs);
+
+	/* Once the file is old enough, a stat call is all it takes */
+	p_uthread_sleep (1100);
+	p_ini_file_reload (ini, NULL, NULL);
+
+	P_BENCH_MEASURE (usecs, {
+		for (pint i = 0; i < PINIFILE_BENCH_RELOADS; ++i)
+			p_ini_file_reload (ini, NULL, NULL);
+	});
+
+	p_bench_report ("Reload unchanged (stat)", PINIFILE_BENCH_RELOADS, usecs);
+
+	p_ini_file_free (ini);
+	p_file_remove (path, NULL);
+}
+P_BENCH_CASE_END ()
+
+P_BENCH_SUITE_BEGIN ()
+{
+	P_BENCH_SUITE_RUN_CASE (pinifile_parse_bench);
+}
+P_BENCH_SUITE_END ()
@@ -0,0 +1,315 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Cross-module benchmark suite: a few hot operations of every subsystem, each
+ * measured with P_BENCH_RUN() so the results of different commits and
+ * platform backends can be compared from the JSON output, see pbenchmacros.h
+ * for the options. */
+
+#include "plibsys.h"
+#include "pbenchmacros.h"
+
+#include <string.h>
+
+#define PBENCH_OPS		100000
+#define PBENCH_HASH_DATA_SIZE	(64 * 1024)
+#define PBENCH_HASH_ROUNDS	64
+#define PBENCH_MESSAGE_SIZE	64
+#define PBENCH_SOCKET_OPS	10000
+#define PBENCH_THREAD_OPS	100
+
+static volatile puint64 bench_sink = 0;
+
+static pint bench_compare_keys (pconstpointer a, pconstpointer b)
+{
+	psize ka = PPOINTER_TO_PSIZE (a);
+	psize kb = PPOINTER_TO_PSIZE (b);
+
+	return ka < kb ? -1 : (ka > kb ? 1 : 0);
+}
+
+static ppointer bench_thread_func (ppointer data)
+{
+	return data;
+}
+
+P_BENCH_CASE_BEGIN (memory_bench)
+{
+	PMemPool *pool = p_mem_pool_new (64);
+
+	P_BENCH_RUN ("p_malloc + p_free 64 bytes", PBENCH_OPS, {
+		for (psize i = 0; i < PBENCH_OPS; ++i) {
+			ppointer block = p_malloc (64);
+			bench_sink += PPOINTER_TO_PSIZE (block);
+			p_free (block);
+		}
+	});
+
+	if (pool != NULL) {
+		P_BENCH_RUN ("PMemPool alloc + release 64 bytes", PBENCH_OPS, {
+			for (psize i = 0; i < PBENCH_OPS; ++i) {
+				ppointer block = p_mem_pool_alloc (pool);
+				bench_sink += PPOINTER_TO_PSIZE (block);
+				p_mem_pool_release (pool, block);
+			}
+		});
+
+		p_mem_pool_free (pool);
+	}
+}
+P_BENCH_CASE_END ()
+
+P_BENCH_CASE_BEGIN (container_bench)
+{
+	PHashTable	*table = p_hash_table_new ();
+	PTree		*tree  = p_tree_new (P_TREE_TYPE_RB, bench_compare_keys);
+
+	if (table == NULL || tree == NULL) {
+		p_hash_table_free (table);
+		p_tree_free (tree);
+		return;
+	}
+
+	/* Values are overwritten after the first run, so the size stays fixed */
+	P_BENCH_RUN ("PHashTable insert", PBENCH_OPS, {
+		for (psize i = 1; i <= PBENCH_OPS; ++i)
+			p_hash_table_insert (table, PSIZE_TO_POINTER (i), PSIZE_TO_POINTER (i));
+	});
+
+	P_BENCH_RUN ("PHashTable lookup", PBENCH_OPS, {
+		for (psize i = 1; i <= PBENCH_OPS; ++i)
+			bench_sink += PPOINTER_TO_PSIZE (p_hash_table_lookup (table, PSIZE_TO_POINTER (i)));
+	});
+
+	P_BENCH_RUN ("PTree (red-black) insert", PBENCH_OPS, {
+		for (psize i = 1; i <= PBENCH_OPS; ++i)
+			p_tree_insert (tree, PSIZE_TO_POINTER (i), PSIZE_TO_POINTER (i));
+	});
+
+	P_BENCH_RUN ("PTree (red-black) lookup", PBENCH_OPS, {
+		for (psize i = 1; i <= PBENCH_OPS; ++i)
+			bench_sink += PPOINTER_TO_PSIZE (p_tree_lookup (tree, PSIZE_TO_POINTER (i)));
+	});
+
+	p_tree_free (tree);
+	p_hash_table_free (table);
+}
+P_BENCH_CASE_END ()
+
+P_BENCH_CASE_BEGIN (string_bench)
+{
+	P_BENCH_RUN ("p_strdup 32 bytes", PBENCH_OPS, {
+		for (psize i = 0; i < PBENCH_OPS; ++i) {
+			pchar *copy = p_strdup ("The quick brown fox jumps over");
+			bench_sink += (puint64) copy[i % 8];
+			p_free (copy);
+		}
+	});
+
+	P_BENCH_RUN ("p_strtod", PBENCH_OPS, {
+		for (psize i = 0; i < PBENCH_OPS; ++i)
+			bench_sink += (puint64) p_strtod ("3.14159265358979");
+	});
+}
+P_BENCH_CASE_END ()
+
+P_BENCH_CASE_BEGIN (hash_bench)
+{
+	puchar	*data = (puchar *) p_malloc (PBENCH_HASH_DATA_SIZE);
+	puchar	digest[P_CRYPTO_HASH_MAX_DIGEST_SIZE];
+	pchar	name[64];
+
+	if (data == NULL)
+		return;
+
+	memset (data, 0xA5, PBENCH_HASH_DATA_SIZE);
+
+	snprintf (name, sizeof (name), "SHA2-256 64 KB (%s)", p_crypto_hash_get_implementation (P_CRYPTO_HASH_TYPE_SHA2_256));
+
+	P_BENCH_RUN (name, PBENCH_HASH_ROUNDS, {
+		for (psize i = 0; i < PBENCH_HASH_ROUNDS; ++i)
+			p_crypto_hash_compute (P_CRYPTO_HASH_TYPE_SHA2_256, data, PBENCH_HASH_DATA_SIZE, digest);
+	});
+
+	P_BENCH_RUN ("MD5 64 KB", PBENCH_HASH_ROUNDS, {
+		for (psize i = 0; i < PBENCH_HASH_ROUNDS; ++i)
+			p_crypto_hash_compute (P_CRYPTO_HASH_TYPE_MD5, data, PBENCH_HASH_DATA_SIZE, digest);
+	});
+
+	P_BENCH_RUN ("XXH3-64 64 KB", PBENCH_HASH_ROUNDS, {
+		for (psize i = 0; i < PBENCH_HASH_ROUNDS; ++i)
+			bench_sink += p_fast_hash_xxh3_64 (data, PBENCH_HASH_DATA_SIZE, i);
+	});
+
+	p_free (data);
+}
+P_BENCH_CASE_END ()
+
+P_BENCH_CASE_BEGIN (sync_bench)
+{
+	volatile pint	value = 0;
+	PMutex		*mutex    = p_mutex_new ();
+	PSpinLock	*spinlock = p_spinlock_new ();
+	PRWLock		*rwlock   = p_rwlock_new ();
+
+	P_BENCH_RUN ("p_atomic_int_inc", PBENCH_OPS, {
+		for (psize i = 0; i < PBENCH_OPS; ++i)
+			p_atomic_int_inc (&value);
+	});
+
+	P_BENCH_RUN ("p_atomic_int_compare_and_exchange", PBENCH_OPS, {
+		for (psize i = 0; i < PBENCH_OPS; ++i)
+			p_atomic_int_compare_and_exchange (&value, value, value + 1);
+	});
+
+	if (mutex != NULL) {
+		P_BENCH_RUN ("PMutex lock + unlock", PBENCH_OPS, {
+			for (psize i = 0; i < PBENCH_OPS; ++i) {
+				p_mutex_lock (mutex);
+				p_mutex_unlock (mutex);
+			}
+		});
+	}
+
+	if (spinlock != NULL) {
+		P_BENCH_RUN ("PSpinLock lock + unlock", PBENCH_OPS, {
+			for (psize i = 0; i < PBENCH_OPS; ++i) {
+				p_spinlock_lock (spinlock);
+				p_spinlock_unlock (spinlock);
+			}
+		});
+	}
+
+	if (rwlock != NULL) {
+		P_BENCH_RUN ("PRWLock reader lock + unlock", PBENCH_OPS, {
+			for (psize i = 0; i < PBENCH_OPS; ++i) {
+				p_rwlock_reader_lock (rwlock);
+				p_rwlock_reader_unlock (rwlock);
+			}
+		});
+	}
+
+	p_rwlock_free (rwlock);
+	p_spinlock_free (spinlock);
+	p_mutex_free (mutex);
+}
+P_BENCH_CASE_END ()
+
+P_BENCH_CASE_BEGIN (socket_bench)
+{
+	PSocket		*sock;
+	PSocketAddress	*any_addr;
+	PSocketAddress	*addr;
+	pchar		message[PBENCH_MESSAGE_SIZE];
+
+	sock     = p_socket_new (P_SOCKET_FAMILY_INET, P_SOCKET_TYPE_DATAGRAM, P_SOCKET_PROTOCOL_UDP, NULL);
+	any_addr = p_socket_address_new ("127.0.0.1", 0);
+
+	if (sock == NULL || any_addr == NULL || p_socket_bind (sock, any_addr, FALSE, NULL) == FALSE) {
+		p_socket_address_free (any_addr);
+		p_socket_free (sock);
+		return;
+	}
+
+	p_socket_address_free (any_addr);
+
+	if ((addr = p_socket_get_local_address (sock, NULL)) == NULL) {
+		p_socket_free (sock);
+		return;
+	}
+
+	memset (message, 0x5A, sizeof (message));
+
+	/* Every datagram is received before the next one is sent, so the socket
+	 * buffer never overflows */
+	P_BENCH_RUN ("UDP loopback send + receive 64 bytes", PBENCH_SOCKET_OPS, {
+		for (psize i = 0; i < PBENCH_SOCKET_OPS; ++i) {
+			p_socket_send_to (sock, addr, message, sizeof (message), NULL);
+			p_socket_receive (sock, message, sizeof (message), NULL);
+		}
+	});
+
+	p_socket_address_free (addr);
+	p_socket_free (sock);
+}
+P_BENCH_CASE_END ()
+
+P_BENCH_CASE_BEGIN (shmbuffer_bench)
+{
+	PShmBuffer	*buffer;
+	pchar		message[PBENCH_MESSAGE_SIZE];
+
+	/* Buffer may be left from a previous run on UNIX systems */
+	if ((buffer = p_shm_buffer_new ("plibsys_bench", 1024 * 1024, NULL)) == NULL)
+		return;
+
+	p_shm_buffer_take_ownership (buffer);
+	p_shm_buffer_free (buffer);
+
+	if ((buffer = p_shm_buffer_new ("plibsys_bench", 1024 * 1024, NULL)) == NULL)
+		return;
+
+	p_shm_buffer_take_ownership (buffer);
+	memset (message, 0x5A, sizeof (message));
+
+	P_BENCH_RUN ("PShmBuffer write + read 64 bytes", PBENCH_OPS, {
+		for (psize i = 0; i < PBENCH_OPS; ++i) {
+			p_shm_buffer_write (buffer, message, sizeof (message), NULL);
+			p_shm_buffer_read (buffer, message, sizeof (message), NULL);
+		}
+	});
+
+	p_shm_buffer_free (buffer);
+}
+P_BENCH_CASE_END ()
+
+P_BENCH_CASE_BEGIN (thread_bench)
+{
+	P_BENCH_RUN ("PUThread create + join", PBENCH_THREAD_OPS, {
+		for (psize i = 0; i < PBENCH_THREAD_OPS; ++i) {
+			PUThread *thread = p_uthread_create (bench_thread_func, NULL, TRUE, NULL);
+
+			if (thread == NULL)
+				break;
+
+			p_uthread_join (thread);
+			p_uthread_unref (thread);
+		}
+	});
+}
+P_BENCH_CASE_END ()
+
+P_BENCH_SUITE_BEGIN ()
+{
+	P_BENCH_SUITE_RUN_CASE (memory_bench);
+	P_BENCH_SUITE_RUN_CASE (container_bench);
+	P_BENCH_SUITE_RUN_CASE (string_bench);
+	P_BENCH_SUITE_RUN_CASE (hash_bench);
+	P_BENCH_SUITE_RUN_CASE (sync_bench);
+	P_BENCH_SUITE_RUN_CASE (socket_bench);
+	P_BENCH_SUITE_RUN_CASE (shmbuffer_bench);
+	P_BENCH_SUITE_RUN_CASE (thread_bench);
+}
+P_BENCH_SUITE_END ()
@@ -0,0 +1,124 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "pbenchmacros.h"
+
+#define PMEMPOOL_BENCH_BATCH		256
+#define PMEMPOOL_BENCH_ROUNDS		4000
+#define PMEMPOOL_BENCH_OBJECT_SIZE	24
+#define PMEMPOOL_BENCH_MAX_THREADS	256
+
+typedef struct BenchContext_ {
+	PMemPool	*pool;
+} BenchContext;
+
+static void * bench_malloc_thread (void *data)
+{
+	ppointer objects[PMEMPOOL_BENCH_BATCH];
+
+	P_UNUSED (data);
+
+	for (pint round = 0; round < PMEMPOOL_BENCH_ROUNDS; ++round) {
+		for (pint i = 0; i < PMEMPOOL_BENCH_BATCH; ++i)
+			objects[i] = p_malloc0 (PMEMPOOL_BENCH_OBJECT_SIZE);
+
+		for (pint i = 0; i < PMEMPOOL_BENCH_BATCH; ++i)
+			p_free (objects[i]);
+	}
+
+	return NULL;
+}
+
+static void * bench_pool_thread (void *data)
+{
+	BenchContext	*ctx = (BenchContext *) data;
+	ppointer	objects[PMEMPOOL_BENCH_BATCH];
+
+	for (pint round = 0; round < PMEMPOOL_BENCH_ROUNDS; ++round) {
+		for (pint i = 0; i < PMEMPOOL_BENCH_BATCH; ++i)
+			objects[i] = p_mem_pool_alloc0 (ctx->pool);
+
+		for (pint i = 0; i < PMEMPOOL_BENCH_BATCH; ++i)
+			p_mem_pool_release (ctx->pool, objects[i]);
+	}
+
+	return NULL;
+}
+
+static puint64 bench_run_threads (PUThreadFunc func, BenchContext *ctx, pint threads)
+{
+	PUThread	*thr[PMEMPOOL_BENCH_MAX_THREADS];
+	puint64		usecs;
+
+	P_BENCH_MEASURE (usecs, {
+		for (pint i = 0; i < threads; ++i)
+			thr[i] = p_uthread_create (func, ctx, TRUE, NULL);
+
+		for (pint i = 0; i < threads; ++i) {
+			p_uthread_join (thr[i]);
+			p_uthread_unref (thr[i]);
+		}
+	});
+
+	return usecs;
+}
+
+P_BENCH_CASE_BEGIN (pmempool_alloc_release_bench)
+{
+	BenchContext	ctx;
+	pint		max_threads = p_uthread_ideal_count ();
+	pchar		name[64];
+
+	if (max_threads > PMEMPOOL_BENCH_MAX_THREADS)
+		max_threads = PMEMPOOL_BENCH_MAX_THREADS;
+
+	ctx.pool = p_mem_pool_new (PMEMPOOL_BENCH_OBJECT_SIZE);
+
+	for (pint threads = 1; ; threads *= 2) {
+		if (threads > max_threads)
+			threads = max_threads;
+
+		psize ops = (psize) threads * PMEMPOOL_BENCH_ROUNDS * PMEMPOOL_BENCH_BATCH;
+
+		snprintf (name, sizeof (name), "p_malloc0 + p_free, %d threads", threads);
+		p_bench_report (name, ops, bench_run_threads ((PUThreadFunc) bench_malloc_thread, &ctx, threads));
+
+		snprintf (name, sizeof (name), "pool alloc0 + release, %d threads", threads);
+		p_bench_report (name, ops, bench_run_threads ((PUThreadFunc) bench_pool_thread, &ctx, threads));
+
+		if (threads == max_threads)
+			break;
+	}
+
+	p_mem_pool_free (ctx.pool);
+}
+P_BENCH_CASE_END ()
+
+P_BENCH_SUITE_BEGIN ()
+{
+	P_BENCH_SUITE_RUN_CASE (pmempool_alloc_release_bench);
+}
+P_BENCH_SUITE_END ()
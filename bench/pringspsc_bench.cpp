@@ -0,0 +1,195 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "pbenchmacros.h"
+
+#define PRINGSPSC_BENCH_ROUNDS		4000000
+#define PRINGSPSC_BENCH_CAPACITY	1024
+#define PRINGSPSC_BENCH_BATCH		64
+
+typedef void (*BenchSideFunc) (ppointer queue);
+
+typedef struct BenchContext_ {
+	ppointer	queue;
+	BenchSideFunc	producer_func;
+	BenchSideFunc	consumer_func;
+} BenchContext;
+
+static void bench_mpmc_producer (ppointer queue)
+{
+	for (psize i = 1; i <= PRINGSPSC_BENCH_ROUNDS; ++i)
+		while (!p_queue_mpmc_try_push ((PQueueMPMC *) queue, PSIZE_TO_POINTER (i)))
+			p_uthread_yield ();
+}
+
+static void bench_mpmc_consumer (ppointer queue)
+{
+	ppointer	value;
+	psize		received = 0;
+
+	while (received < PRINGSPSC_BENCH_ROUNDS) {
+		if (p_queue_mpmc_try_pop ((PQueueMPMC *) queue, &value))
+			++received;
+		else
+			p_uthread_yield ();
+	}
+}
+
+static void bench_ring_producer (ppointer queue)
+{
+	for (psize i = 1; i <= PRINGSPSC_BENCH_ROUNDS; ++i)
+		while (!p_ring_spsc_try_write ((PRingSPSC *) queue, &i))
+			p_uthread_yield ();
+}
+
+static void bench_ring_consumer (ppointer queue)
+{
+	psize value;
+	psize received = 0;
+
+	while (received < PRINGSPSC_BENCH_ROUNDS) {
+		if (p_ring_spsc_try_read ((PRingSPSC *) queue, &value))
+			++received;
+		else
+			p_uthread_yield ();
+	}
+}
+
+static void bench_ring_batch_producer (ppointer queue)
+{
+	psize	*space;
+	psize	reserved;
+	psize	i = 1;
+
+	while (i <= PRINGSPSC_BENCH_ROUNDS) {
+		space = (psize *) p_ring_spsc_reserve ((PRingSPSC *) queue, PRINGSPSC_BENCH_BATCH, &reserved);
+
+		if (space == NULL) {
+			p_uthread_yield ();
+			continue;
+		}
+
+		psize filled = 0;
+
+		while (filled < reserved && i <= PRINGSPSC_BENCH_ROUNDS)
+			space[filled++] = i++;
+
+		p_ring_spsc_commit ((PRingSPSC *) queue, filled);
+	}
+}
+
+static void bench_ring_batch_consumer (ppointer queue)
+{
+	psize	values[PRINGSPSC_BENCH_BATCH];
+	psize	received = 0;
+	psize	count;
+
+	while (received < PRINGSPSC_BENCH_ROUNDS) {
+		count = p_ring_spsc_try_read_batch ((PRingSPSC *) queue, values, PRINGSPSC_BENCH_BATCH);
+
+		if (count == 0)
+			p_uthread_yield ();
+
+		received += count;
+	}
+}
+
+static void * bench_producer_thread (void *data)
+{
+	BenchContext *ctx = (BenchContext *) data;
+
+	ctx->producer_func (ctx->queue);
+
+	return NULL;
+}
+
+static void * bench_consumer_thread (void *data)
+{
+	BenchContext *ctx = (BenchContext *) data;
+
+	ctx->consumer_func (ctx->queue);
+
+	return NULL;
+}
+
+static puint64 bench_run_threads (BenchContext *ctx)
+{
+	PUThread	*producer;
+	PUThread	*consumer;
+	puint64		usecs;
+
+	P_BENCH_MEASURE (usecs, {
+		producer = p_uthread_create ((PUThreadFunc) bench_producer_thread, ctx, TRUE, NULL);
+		consumer = p_uthread_create ((PUThreadFunc) bench_consumer_thread, ctx, TRUE, NULL);
+
+		p_uthread_join (producer);
+		p_uthread_join (consumer);
+	});
+
+	p_uthread_unref (producer);
+	p_uthread_unref (consumer);
+
+	return usecs;
+}
+
+P_BENCH_CASE_BEGIN (pringspsc_transfer_bench)
+{
+	BenchContext mpmc_ctx;
+	BenchContext ring_ctx;
+	BenchContext batch_ctx;
+
+	mpmc_ctx.queue          = p_queue_mpmc_new (PRINGSPSC_BENCH_CAPACITY, FALSE);
+	mpmc_ctx.producer_func  = bench_mpmc_producer;
+	mpmc_ctx.consumer_func  = bench_mpmc_consumer;
+
+	ring_ctx.queue          = p_ring_spsc_new (sizeof (psize), PRINGSPSC_BENCH_CAPACITY);
+	ring_ctx.producer_func  = bench_ring_producer;
+	ring_ctx.consumer_func  = bench_ring_consumer;
+
+	batch_ctx.queue         = ring_ctx.queue;
+	batch_ctx.producer_func = bench_ring_batch_producer;
+	batch_ctx.consumer_func = bench_ring_batch_consumer;
+
+	p_bench_report ("PQueueMPMC push + pop, 1 + 1 threads",
+			PRINGSPSC_BENCH_ROUNDS,
+			bench_run_threads (&mpmc_ctx));
+	p_bench_report ("PRingSPSC write + read, 1 + 1 threads",
+			PRINGSPSC_BENCH_ROUNDS,
+			bench_run_threads (&ring_ctx));
+	p_bench_report ("PRingSPSC reserve + read batch, 1 + 1 threads",
+			PRINGSPSC_BENCH_ROUNDS,
+			bench_run_threads (&batch_ctx));
+
+	p_queue_mpmc_free ((PQueueMPMC *) mpmc_ctx.queue);
+	p_ring_spsc_free ((PRingSPSC *) ring_ctx.queue);
+}
+P_BENCH_CASE_END ()
+
+P_BENCH_SUITE_BEGIN ()
+{
+	P_BENCH_SUITE_RUN_CASE (pringspsc_transfer_bench);
+}
+P_BENCH_SUITE_END ()
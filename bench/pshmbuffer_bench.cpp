@@ -0,0 +1,104 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "pbenchmacros.h"
+
+#include <string.h>
+
+#define PSHMBUFFER_BENCH_SIZE		(4 * 1024 * 1024)
+#define PSHMBUFFER_BENCH_TOTAL		(256 * 1024 * 1024)
+#define PSHMBUFFER_BENCH_MIN_ROUNDS	1000
+#define PSHMBUFFER_BENCH_MIN_MESSAGE	16
+#define PSHMBUFFER_BENCH_MAX_MESSAGE	(1024 * 1024)
+
+typedef PShmBuffer * (*BenchNewFunc) (const pchar *name, psize size, PError **error);
+
+static void bench_run_sizes (const pchar *title, BenchNewFunc new_func)
+{
+	PShmBuffer	*buffer;
+	pchar		*message;
+	pchar		*storage;
+	puint64		usecs;
+	pchar		name[64];
+
+	/* Buffer may be left from a previous run on UNIX systems */
+	if ((buffer = new_func ("pshmbuffer_bench", PSHMBUFFER_BENCH_SIZE, NULL)) == NULL)
+		return;
+
+	p_shm_buffer_take_ownership (buffer);
+	p_shm_buffer_free (buffer);
+
+	buffer  = new_func ("pshmbuffer_bench", PSHMBUFFER_BENCH_SIZE, NULL);
+	message = (pchar *) p_malloc (PSHMBUFFER_BENCH_MAX_MESSAGE);
+	storage = (pchar *) p_malloc (PSHMBUFFER_BENCH_MAX_MESSAGE);
+
+	if (buffer == NULL || message == NULL || storage == NULL) {
+		p_shm_buffer_free (buffer);
+		p_free (message);
+		p_free (storage);
+		return;
+	}
+
+	p_shm_buffer_take_ownership (buffer);
+	memset (message, 0x5A, PSHMBUFFER_BENCH_MAX_MESSAGE);
+
+	/* The positions move on, so the messages wrap around the end of the
+	 * buffer from time to time, like in the real use */
+	for (psize size = PSHMBUFFER_BENCH_MIN_MESSAGE; size <= PSHMBUFFER_BENCH_MAX_MESSAGE; size *= 4) {
+		psize rounds = PSHMBUFFER_BENCH_TOTAL / size;
+
+		if (rounds < PSHMBUFFER_BENCH_MIN_ROUNDS)
+			rounds = PSHMBUFFER_BENCH_MIN_ROUNDS;
+
+		P_BENCH_MEASURE (usecs, {
+			for (psize i = 0; i < rounds; ++i) {
+				p_shm_buffer_write (buffer, message, size, NULL);
+				p_shm_buffer_read (buffer, storage, size, NULL);
+			}
+		});
+
+		snprintf (name, sizeof (name), "%s write + read %lu bytes", title, (unsigned long) size);
+		p_bench_report (name, rounds, usecs);
+		p_bench_report_bytes (name, (puint64) rounds * size, usecs);
+	}
+
+	p_shm_buffer_free (buffer);
+	p_free (message);
+	p_free (storage);
+}
+
+P_BENCH_CASE_BEGIN (pshmbuffer_throughput_bench)
+{
+	bench_run_sizes ("Locked", p_shm_buffer_new);
+	bench_run_sizes ("SPSC", p_shm_buffer_new_spsc);
+}
+P_BENCH_CASE_END ()
+
+P_BENCH_SUITE_BEGIN ()
+{
+	P_BENCH_SUITE_RUN_CASE (pshmbuffer_throughput_bench);
+}
+P_BENCH_SUITE_END ()
@@ -0,0 +1,398 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "pbenchmacros.h"
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PSTRING_BENCH_ITERATIONS	1000000
+#define PSTRING_BENCH_LINE_LEN		256
+#define PSTRING_BENCH_NUMBERS		1024
+#define PSTRING_BENCH_MESSAGES		100000
+#define PSTRING_BENCH_PIECES		1000
+
+/* Typical config line: indented key, value and a trailing comment */
+static const pchar bench_line[] = "    connection_timeout_ms = 1500    ; default is 3000   \n";
+
+/* Keeps the compiler from hoisting pure libc calls out of the loops */
+static volatile psize bench_offset = 0;
+
+P_BENCH_CASE_BEGIN (pstring_chomp_bench)
+{
+	puint64		usecs;
+	psize		sink = 0;
+	psize		len;
+	pchar		buf[sizeof (bench_line)];
+
+	P_BENCH_MEASURE (usecs, {
+		for (pint i = 0; i < PSTRING_BENCH_ITERATIONS; ++i) {
+			pchar *str = p_strchomp (bench_line);
+
+			sink += (psize) str[0];
+			p_free (str);
+		}
+	});
+
+	p_bench_report ("Chomp with copy", PSTRING_BENCH_ITERATIONS, usecs);
+
+	P_BENCH_MEASURE (usecs, {
+		for (pint i = 0; i < PSTRING_BENCH_ITERATIONS; ++i)
+			sink += (psize) p_strchomp_view (bench_line, &len)[0] + len;
+	});
+
+	p_bench_report ("Chomp view", PSTRING_BENCH_ITERATIONS, usecs);
+
+	P_BENCH_MEASURE (usecs, {
+		for (pint i = 0; i < PSTRING_BENCH_ITERATIONS; ++i) {
+			memcpy (buf, bench_line, sizeof (bench_line));
+			sink += (psize) p_strtrim_inplace (buf)[0];
+		}
+	});
+
+	p_bench_report ("Trim in place (with restore)", PSTRING_BENCH_ITERATIONS, usecs);
+
+	if (sink == 0)
+		printf ("  Unexpected result\n");
+}
+P_BENCH_CASE_END ()
+
+P_BENCH_CASE_BEGIN (pstring_scan_bench)
+{
+	puint64		usecs;
+	psize		sink = 0;
+	pchar		line[PSTRING_BENCH_LINE_LEN + 1];
+	pchar		spaces[PSTRING_BENCH_LINE_LEN + 1];
+
+	/* Long value with a comment at the very end, long indentation */
+	memset (line, 'v', PSTRING_BENCH_LINE_LEN);
+	line[PSTRING_BENCH_LINE_LEN - 1] = ';';
+	line[PSTRING_BENCH_LINE_LEN]     = '\0';
+
+	memset (spaces, ' ', PSTRING_BENCH_LINE_LEN);
+	spaces[PSTRING_BENCH_LINE_LEN - 1] = 'x';
+	spaces[PSTRING_BENCH_LINE_LEN]     = '\0';
+
+	P_BENCH_MEASURE (usecs, {
+		for (pint i = 0; i < PSTRING_BENCH_ITERATIONS; ++i) {
+			const pchar *ptr = spaces;
+
+			while (isspace (* ((const puchar *) ptr)))
+				++ptr;
+
+			sink += (psize) (ptr - spaces);
+		}
+	});
+
+	p_bench_report_bytes ("Skip spaces, isspace() loop",
+			      (puint64) PSTRING_BENCH_ITERATIONS * PSTRING_BENCH_LINE_LEN,
+			      usecs);
+
+	P_BENCH_MEASURE (usecs, {
+		for (pint i = 0; i < PSTRING_BENCH_ITERATIONS; ++i)
+			sink += p_str_skip_spaces (spaces, PSTRING_BENCH_LINE_LEN);
+	});
+
+	p_bench_report_bytes ("Skip spaces, p_str_skip_spaces()",
+			      (puint64) PSTRING_BENCH_ITERATIONS * PSTRING_BENCH_LINE_LEN,
+			      usecs);
+
+	P_BENCH_MEASURE (usecs, {
+		for (pint i = 0; i < PSTRING_BENCH_ITERATIONS; ++i) {
+			const pchar *ptr = line;
+
+			while (*ptr != '\0' && *ptr != '#' && *ptr != ';')
+				++ptr;
+
+			sink += (psize) (ptr - line);
+		}
+	});
+
+	p_bench_report_bytes ("Find delimiter, scalar loop",
+			      (puint64) PSTRING_BENCH_ITERATIONS * PSTRING_BENCH_LINE_LEN,
+			      usecs);
+
+	P_BENCH_MEASURE (usecs, {
+		for (pint i = 0; i < PSTRING_BENCH_ITERATIONS; ++i)
+			sink += strcspn (line + bench_offset, "#;");
+	});
+
+	p_bench_report_bytes ("Find delimiter, strcspn()",
+			      (puint64) PSTRING_BENCH_ITERATIONS * PSTRING_BENCH_LINE_LEN,
+			      usecs);
+
+	P_BENCH_MEASURE (usecs, {
+		for (pint i = 0; i < PSTRING_BENCH_ITERATIONS; ++i)
+			sink += p_str_find_any (line, PSTRING_BENCH_LINE_LEN, "#;");
+	});
+
+	p_bench_report_bytes ("Find delimiter, p_str_find_any()",
+			      (puint64) PSTRING_BENCH_ITERATIONS * PSTRING_BENCH_LINE_LEN,
+			      usecs);
+
+	if (sink == 0)
+		printf ("  Unexpected result\n");
+}
+P_BENCH_CASE_END ()
+
+P_BENCH_CASE_BEGIN (pstring_number_bench)
+{
+	puint64		usecs;
+	pchar		(*fields)[32];
+	psize		lens[PSTRING_BENCH_NUMBERS];
+	double		dsink = 0.0;
+	puint64		isink = 0;
+	double		dval;
+	pint64		ival;
+
+	if ((fields = (pchar (*)[32]) p_malloc (PSTRING_BENCH_NUMBERS * 32)) == NULL)
+		return;
+
+	/* Telemetry-like fields: prices, coordinates and plain counters */
+	for (pint i = 0; i < PSTRING_BENCH_NUMBERS; ++i) {
+		switch (i % 3) {
+		case 0:
+			snprintf (fields[i], 32, "%d.%02d", i * 37 % 10000, i % 100);
+			break;
+		case 1:
+			snprintf (fields[i], 32, "%.17g", (i + 1) * 0.0123456789);
+			break;
+		default:
+			snprintf (fields[i], 32, "%.6e", (i + 1) * 1234.5678);
+			break;
+		}
+
+		lens[i] = strlen (fields[i]);
+	}
+
+	P_BENCH_MEASURE (usecs, {
+		for (pint i = 0; i < PSTRING_BENCH_ITERATIONS; ++i)
+			dsink += strtod (fields[i % PSTRING_BENCH_NUMBERS], NULL);
+	});
+
+	p_bench_report ("Parse double, strtod()", PSTRING_BENCH_ITERATIONS, usecs);
+
+	P_BENCH_MEASURE (usecs, {
+		for (pint i = 0; i < PSTRING_BENCH_ITERATIONS; ++i)
+			dsink += p_strtod (fields[i % PSTRING_BENCH_NUMBERS]);
+	});
+
+	p_bench_report ("Parse double, p_strtod()", PSTRING_BENCH_ITERATIONS, usecs);
+
+	P_BENCH_MEASURE (usecs, {
+		for (pint i = 0; i < PSTRING_BENCH_ITERATIONS; ++i) {
+			p_strtod_n (fields[i % PSTRING_BENCH_NUMBERS], lens[i % PSTRING_BENCH_NUMBERS], &dval);
+			dsink += dval;
+		}
+	});
+
+	p_bench_report ("Parse double, p_strtod_n()", PSTRING_BENCH_ITERATIONS, usecs);
+
+	for (pint i = 0; i < PSTRING_BENCH_NUMBERS; ++i) {
+		snprintf (fields[i], 32, "%lld", (long long) (i * 7919LL * (i % 5 == 0 ? 1000000007LL : 1)));
+		lens[i] = strlen (fields[i]);
+	}
+
+	P_BENCH_MEASURE (usecs, {
+		for (pint i = 0; i < PSTRING_BENCH_ITERATIONS; ++i)
+			isink += (puint64) strtoll (fields[i % PSTRING_BENCH_NUMBERS], NULL, 10);
+	});
+
+	p_bench_report ("Parse integer, strtoll()", PSTRING_BENCH_ITERATIONS, usecs);
+
+	P_BENCH_MEASURE (usecs, {
+		for (pint i = 0; i < PSTRING_BENCH_ITERATIONS; ++i) {
+			p_strtoll_n (fields[i % PSTRING_BENCH_NUMBERS], lens[i % PSTRING_BENCH_NUMBERS], &ival);
+			isink += (puint64) ival;
+		}
+	});
+
+	p_bench_report ("Parse integer, p_strtoll_n()", PSTRING_BENCH_ITERATIONS, usecs);
+
+	if (dsink == 0.0 || isink == 0)
+		printf ("  Unexpected result\n");
+
+	p_free (fields);
+}
+P_BENCH_CASE_END ()
+
+P_BENCH_CASE_BEGIN (pstring_builder_bench)
+{
+	PStringBuilder	sb;
+	puint64		usecs;
+	psize		sink = 0;
+	pchar		num[32];
+
+	/* Short log line: fits into the inline storage */
+	P_BENCH_MEASURE (usecs, {
+		for (pint i = 0; i < PSTRING_BENCH_MESSAGES; ++i) {
+			pchar	*msg = (pchar *) p_malloc (64);
+
+			strcpy (msg, "request ");
+			snprintf (num, sizeof (num), "%d", i);
+			strcat (msg, num);
+			strcat (msg, " took ");
+			snprintf (num, sizeof (num), "%d", i % 1000);
+			strcat (msg, num);
+			strcat (msg, " us");
+
+			sink += strlen (msg);
+			p_free (msg);
+		}
+	});
+
+	p_bench_report ("Short message, snprintf() + strcat()", PSTRING_BENCH_MESSAGES, usecs);
+
+	P_BENCH_MEASURE (usecs, {
+		for (pint i = 0; i < PSTRING_BENCH_MESSAGES; ++i) {
+			p_string_builder_init (&sb);
+			p_string_builder_append (&sb, "request ");
+			p_string_builder_append_int (&sb, i);
+			p_string_builder_append (&sb, " took ");
+			p_string_builder_append_int (&sb, i % 1000);
+			p_string_builder_append (&sb, " us");
+
+			sink += p_string_builder_length (&sb);
+			p_string_builder_clear (&sb);
+		}
+	});
+
+	p_bench_report ("Short message, PStringBuilder", PSTRING_BENCH_MESSAGES, usecs);
+
+	/* Long message grown piece by piece */
+	P_BENCH_MEASURE (usecs, {
+		for (pint k = 0; k < 10; ++k) {
+			pchar *msg = p_strdup ("");
+
+			for (pint i = 0; i < PSTRING_BENCH_PIECES; ++i) {
+				snprintf (num, sizeof (num), "%d,", i);
+				msg = (pchar *) p_realloc (msg, strlen (msg) + strlen (num) + 1);
+				strcat (msg, num);
+			}
+
+			sink += strlen (msg);
+			p_free (msg);
+		}
+	});
+
+	p_bench_report ("Long message, p_realloc() + strcat()", 10 * PSTRING_BENCH_PIECES, usecs);
+
+	P_BENCH_MEASURE (usecs, {
+		for (pint k = 0; k < 10; ++k) {
+			p_string_builder_init (&sb);
+
+			for (pint i = 0; i < PSTRING_BENCH_PIECES; ++i) {
+				p_string_builder_append_int (&sb, i);
+				p_string_builder_append_char (&sb, ',');
+			}
+
+			sink += p_string_builder_length (&sb);
+			p_string_builder_clear (&sb);
+		}
+	});
+
+	p_bench_report ("Long message, PStringBuilder", 10 * PSTRING_BENCH_PIECES, usecs);
+
+	if (sink == 0)
+		printf ("  Unexpected result\n");
+}
+P_BENCH_CASE_END ()
+
+P_BENCH_CASE_BEGIN (pstring_pool_bench)
+{
+	static const pchar * const names[] = {
+		"Host", "User-Agent", "Accept", "Accept-Encoding", "Accept-Language",
+		"Connection", "Content-Length", "Content-Type", "Cookie", "Referer"
+	};
+
+	const psize	names_count = sizeof (names) / sizeof (names[0]);
+	PStringPool	*pool;
+	const pchar	*interned[sizeof (names) / sizeof (names[0])];
+	const pchar	*probe;
+	puint64		usecs;
+	psize		sink = 0;
+
+	if ((pool = p_string_pool_new ()) == NULL)
+		return;
+
+	for (psize i = 0; i < names_count; ++i)
+		interned[i] = p_string_pool_intern (pool, names[i]);
+
+	P_BENCH_MEASURE (usecs, {
+		for (pint i = 0; i < PSTRING_BENCH_MESSAGES; ++i)
+			sink += (psize) p_string_pool_intern (pool, names[(i + bench_offset) % names_count]) & 1;
+	});
+
+	p_bench_report ("Intern existing name", PSTRING_BENCH_MESSAGES, usecs);
+
+	/* Find the last name among the known ones */
+	P_BENCH_MEASURE (usecs, {
+		for (pint i = 0; i < PSTRING_BENCH_MESSAGES; ++i) {
+			probe = names[names_count - 1 - bench_offset];
+
+			for (psize k = 0; k < names_count; ++k) {
+				if (strcmp (probe, names[k]) == 0) {
+					sink += k;
+					break;
+				}
+			}
+		}
+	});
+
+	p_bench_report ("Match name, strcmp()", PSTRING_BENCH_MESSAGES, usecs);
+
+	P_BENCH_MEASURE (usecs, {
+		for (pint i = 0; i < PSTRING_BENCH_MESSAGES; ++i) {
+			probe = interned[names_count - 1 - bench_offset];
+
+			for (psize k = 0; k < names_count; ++k) {
+				if (probe == interned[k]) {
+					sink += k;
+					break;
+				}
+			}
+		}
+	});
+
+	p_bench_report ("Match name, interned pointers", PSTRING_BENCH_MESSAGES, usecs);
+
+	p_string_pool_free (pool);
+
+	if (sink == 0)
+		printf ("  Unexpected result\n");
+}
+P_BENCH_CASE_END ()
+
+P_BENCH_SUITE_BEGIN ()
+{
+	P_BENCH_SUITE_RUN_CASE (pstring_chomp_bench);
+	P_BENCH_SUITE_RUN_CASE (pstring_scan_bench);
+	P_BENCH_SUITE_RUN_CASE (pstring_number_bench);
+	P_BENCH_SUITE_RUN_CASE (pstring_builder_bench);
+	P_BENCH_SUITE_RUN_CASE (pstring_pool_bench);
+}
+P_BENCH_SUITE_END ()
@@ -0,0 +1,436 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+/* Contention benchmark suite for the synchronization primitives: PMutex,
+ * PSpinLock, PRWLock with different read ratios, PCondVariable ping-pong and
+ * the atomic operations, from 1 thread to twice the number of CPUs. Every
+ * lock benchmark reports the throughput and the latency of the acquisition,
+ * sampled every PSYNC_BENCH_SAMPLE_EVERY operation. The suite starts with the
+ * models the library was built with, so the results from different platforms
+ * can be told apart. */
+
+#include "plibsys.h"
+#include "pbenchmacros.h"
+
+#define PSYNC_BENCH_ROUNDS		100000
+#define PSYNC_BENCH_PING_PONG_ROUNDS	20000
+#define PSYNC_BENCH_SAMPLE_EVERY	8
+#define PSYNC_BENCH_WORK		16
+#define PSYNC_BENCH_MAX_THREADS		256
+
+#ifndef PLIBSYS_BENCH_TARGET_OS
+#  define PLIBSYS_BENCH_TARGET_OS	"unknown"
+#endif
+
+#ifndef PLIBSYS_BENCH_THREAD_MODEL
+#  define PLIBSYS_BENCH_THREAD_MODEL	"unknown"
+#endif
+
+#ifndef PLIBSYS_BENCH_RWLOCK_MODEL
+#  define PLIBSYS_BENCH_RWLOCK_MODEL	"unknown"
+#endif
+
+#ifndef PLIBSYS_BENCH_ATOMIC_MODEL
+#  define PLIBSYS_BENCH_ATOMIC_MODEL	"unknown"
+#endif
+
+typedef pboolean (*BenchLockFunc) (ppointer lock);
+
+typedef struct BenchContext_ {
+	ppointer		lock;
+	BenchLockFunc		write_lock;
+	BenchLockFunc		write_unlock;
+	BenchLockFunc		read_lock;
+	BenchLockFunc		read_unlock;
+	pint			read_percent;
+	volatile puint64	counter;
+} BenchContext;
+
+typedef struct BenchThread_ {
+	BenchContext	*ctx;
+	puint64		*samples;
+	psize		n_samples;
+	puint32		seed;
+} BenchThread;
+
+typedef void (*BenchAtomicFunc) (void);
+
+static volatile pint	bench_atomic_int   = 0;
+static volatile pint64	bench_atomic_int64 = 0;
+
+static void * bench_lock_thread (void *data)
+{
+	BenchThread	*thread = (BenchThread *) data;
+	BenchContext	*ctx    = thread->ctx;
+	PTimeProfiler	*profiler;
+	puint64		start;
+	pboolean	is_read;
+
+	profiler = p_time_profiler_new ();
+
+	for (pint round = 0; round < PSYNC_BENCH_ROUNDS; ++round) {
+		pboolean sample = (round % PSYNC_BENCH_SAMPLE_EVERY) == 0;
+
+		/* Linear congruential generator, good enough to mix the reads */
+		thread->seed = thread->seed * 1103515245U + 12345U;
+		is_read      = (pint) ((thread->seed >> 16) % 100) < ctx->read_percent;
+
+		start = sample ? p_time_profiler_elapsed_usecs (profiler) : 0;
+
+		if (is_read)
+			ctx->read_lock (ctx->lock);
+		else
+			ctx->write_lock (ctx->lock);
+
+		if (sample)
+			thread->samples[thread->n_samples++] = p_time_profiler_elapsed_usecs (profiler) - start;
+
+		/* Very short critical section */
+		if (is_read) {
+			volatile puint64 value;
+
+			for (pint i = 0; i < PSYNC_BENCH_WORK; ++i)
+				value = ctx->counter;
+
+			P_UNUSED (value);
+			ctx->read_unlock (ctx->lock);
+		} else {
+			for (pint i = 0; i < PSYNC_BENCH_WORK; ++i)
+				++ctx->counter;
+
+			ctx->write_unlock (ctx->lock);
+		}
+	}
+
+	p_time_profiler_free (profiler);
+
+	return NULL;
+}
+
+static void bench_run_lock (const pchar *title, BenchContext *ctx, pint threads)
+{
+	PUThread	*thr[PSYNC_BENCH_MAX_THREADS];
+	BenchThread	info[PSYNC_BENCH_MAX_THREADS];
+	puint64		*samples;
+	puint64		usecs;
+	psize		per_thread;
+	psize		count;
+	pchar		name[64];
+
+	per_thread = PSYNC_BENCH_ROUNDS / PSYNC_BENCH_SAMPLE_EVERY + 1;
+	samples    = (puint64 *) p_malloc (sizeof (puint64) * per_thread * (psize) threads);
+
+	if (samples == NULL)
+		return;
+
+	ctx->counter = 0;
+
+	for (pint i = 0; i < threads; ++i) {
+		info[i].ctx       = ctx;
+		info[i].samples   = samples + per_thread * (psize) i;
+		info[i].n_samples = 0;
+		info[i].seed      = (puint32) i * 7919U + 1U;
+	}
+
+	P_BENCH_MEASURE (usecs, {
+		for (pint i = 0; i < threads; ++i)
+			thr[i] = p_uthread_create ((PUThreadFunc) bench_lock_thread, &info[i], TRUE, NULL);
+
+		for (pint i = 0; i < threads; ++i) {
+			p_uthread_join (thr[i]);
+			p_uthread_unref (thr[i]);
+		}
+	});
+
+	/* Pack the samples of all the threads together */
+	count = 0;
+
+	for (pint i = 0; i < threads; ++i) {
+		for (psize j = 0; j < info[i].n_samples; ++j)
+			samples[count++] = info[i].samples[j];
+	}
+
+	snprintf (name, sizeof (name), "%s, %d threads", title, threads);
+	p_bench_report (name, (psize) threads * PSYNC_BENCH_ROUNDS, usecs);
+
+	snprintf (name, sizeof (name), "%s latency", title);
+	p_bench_report_latency (name, samples, count);
+
+	p_free (samples);
+}
+
+static pint bench_max_threads (void)
+{
+	pint max_threads = p_uthread_ideal_count () * 2;
+
+	return max_threads > PSYNC_BENCH_MAX_THREADS ? PSYNC_BENCH_MAX_THREADS : max_threads;
+}
+
+P_BENCH_CASE_BEGIN (psync_backend_info)
+{
+	printf ("  Platform:                 %s\n", PLIBSYS_BENCH_TARGET_OS);
+	printf ("  Thread model:             %s\n", PLIBSYS_BENCH_THREAD_MODEL);
+	printf ("  RW lock model:            %s\n", PLIBSYS_BENCH_RWLOCK_MODEL);
+	printf ("  Atomic model:             %s\n", PLIBSYS_BENCH_ATOMIC_MODEL);
+	printf ("  Lock-free atomics:        %s\n", p_atomic_is_lock_free () ? "yes" : "no");
+	printf ("  Lock-free int64 atomics:  %s\n", p_atomic_int64_is_lock_free () ? "yes" : "no");
+	printf ("  CPUs:                     %d\n", p_uthread_ideal_count ());
+}
+P_BENCH_CASE_END ()
+
+P_BENCH_CASE_BEGIN (psync_mutex_bench)
+{
+	BenchContext	mutex_ctx;
+	BenchContext	spin_ctx;
+	pint		max_threads = bench_max_threads ();
+
+	mutex_ctx.lock         = p_mutex_new ();
+	mutex_ctx.write_lock   = (BenchLockFunc) p_mutex_lock;
+	mutex_ctx.write_unlock = (BenchLockFunc) p_mutex_unlock;
+	mutex_ctx.read_lock    = mutex_ctx.write_lock;
+	mutex_ctx.read_unlock  = mutex_ctx.write_unlock;
+	mutex_ctx.read_percent = 0;
+
+	spin_ctx.lock          = p_spinlock_new ();
+	spin_ctx.write_lock    = (BenchLockFunc) p_spinlock_lock;
+	spin_ctx.write_unlock  = (BenchLockFunc) p_spinlock_unlock;
+	spin_ctx.read_lock     = spin_ctx.write_lock;
+	spin_ctx.read_unlock   = spin_ctx.write_unlock;
+	spin_ctx.read_percent  = 0;
+
+	/* Twice as many threads as CPUs show the oversubscribed case */
+	for (pint threads = 1; ; threads *= 2) {
+		if (threads > max_threads)
+			threads = max_threads;
+
+		bench_run_lock ("PMutex lock + unlock", &mutex_ctx, threads);
+		bench_run_lock ("PSpinLock lock + unlock", &spin_ctx, threads);
+
+		if (threads == max_threads)
+			break;
+	}
+
+	p_mutex_free ((PMutex *) mutex_ctx.lock);
+	p_spinlock_free ((PSpinLock *) spin_ctx.lock);
+}
+P_BENCH_CASE_END ()
+
+P_BENCH_CASE_BEGIN (psync_rwlock_bench)
+{
+	BenchContext	ctx;
+	pint		max_threads = bench_max_threads ();
+	pint		ratios[]    = {100, 95, 50, 0};
+	pchar		title[64];
+
+	ctx.lock         = p_rwlock_new ();
+	ctx.write_lock   = (BenchLockFunc) p_rwlock_writer_lock;
+	ctx.write_unlock = (BenchLockFunc) p_rwlock_writer_unlock;
+	ctx.read_lock    = (BenchLockFunc) p_rwlock_reader_lock;
+	ctx.read_unlock  = (BenchLockFunc) p_rwlock_reader_unlock;
+
+	for (psize r = 0; r < sizeof (ratios) / sizeof (ratios[0]); ++r) {
+		ctx.read_percent = ratios[r];
+
+		snprintf (title, sizeof (title), "PRWLock %d%% reads", ratios[r]);
+
+		for (pint threads = 1; ; threads *= 2) {
+			if (threads > max_threads)
+				threads = max_threads;
+
+			bench_run_lock (title, &ctx, threads);
+
+			if (threads == max_threads)
+				break;
+		}
+	}
+
+	p_rwlock_free ((PRWLock *) ctx.lock);
+}
+P_BENCH_CASE_END ()
+
+/* Two threads pass the turn back and forth through a condition variable */
+
+typedef struct BenchPingPong_ {
+	PMutex		*mutex;
+	PCondVariable	*cond;
+	pint		turn;
+} BenchPingPong;
+
+static void * bench_pong_thread (void *data)
+{
+	BenchPingPong *pp = (BenchPingPong *) data;
+
+	p_mutex_lock (pp->mutex);
+
+	for (pint round = 0; round < PSYNC_BENCH_PING_PONG_ROUNDS; ++round) {
+		while (pp->turn != 1)
+			p_cond_variable_wait (pp->cond, pp->mutex);
+
+		pp->turn = 0;
+		p_cond_variable_signal (pp->cond);
+	}
+
+	p_mutex_unlock (pp->mutex);
+
+	return NULL;
+}
+
+P_BENCH_CASE_BEGIN (psync_condvar_bench)
+{
+	BenchPingPong	pp;
+	PUThread	*pong;
+	PTimeProfiler	*profiler;
+	puint64		*samples;
+	puint64		usecs;
+	puint64		start;
+
+	pp.mutex = p_mutex_new ();
+	pp.cond  = p_cond_variable_new ();
+	pp.turn  = 0;
+
+	samples  = (puint64 *) p_malloc (sizeof (puint64) * PSYNC_BENCH_PING_PONG_ROUNDS);
+	profiler = p_time_profiler_new ();
+
+	P_BENCH_MEASURE (usecs, {
+		pong = p_uthread_create ((PUThreadFunc) bench_pong_thread, &pp, TRUE, NULL);
+
+		p_mutex_lock (pp.mutex);
+
+		for (pint round = 0; round < PSYNC_BENCH_PING_PONG_ROUNDS; ++round) {
+			start   = p_time_profiler_elapsed_usecs (profiler);
+			pp.turn = 1;
+			p_cond_variable_signal (pp.cond);
+
+			while (pp.turn != 0)
+				p_cond_variable_wait (pp.cond, pp.mutex);
+
+			samples[round] = p_time_profiler_elapsed_usecs (profiler) - start;
+		}
+
+		p_mutex_unlock (pp.mutex);
+
+		p_uthread_join (pong);
+	});
+
+	p_bench_report ("PCondVariable ping-pong round trips", PSYNC_BENCH_PING_PONG_ROUNDS, usecs);
+	p_bench_report_latency ("PCondVariable round trip latency", samples, PSYNC_BENCH_PING_PONG_ROUNDS);
+
+	p_uthread_unref (pong);
+	p_time_profiler_free (profiler);
+	p_free (samples);
+	p_cond_variable_free (pp.cond);
+	p_mutex_free (pp.mutex);
+}
+P_BENCH_CASE_END ()
+
+static void bench_atomic_inc (void)
+{
+	p_atomic_int_inc (&bench_atomic_int);
+}
+
+static void bench_atomic_cas (void)
+{
+	pint value;
+
+	do {
+		value = p_atomic_int_get_explicit (&bench_atomic_int, P_ATOMIC_MEMORY_ORDER_RELAXED);
+	} while (!p_atomic_int_compare_and_exchange (&bench_atomic_int, value, value + 1));
+}
+
+static void bench_atomic_add_relaxed (void)
+{
+	p_atomic_int_add_explicit (&bench_atomic_int, 1, P_ATOMIC_MEMORY_ORDER_RELAXED);
+}
+
+static void bench_atomic_int64_add (void)
+{
+	p_atomic_int64_add (&bench_atomic_int64, 1);
+}
+
+static void * bench_atomic_thread (void *data)
+{
+	BenchAtomicFunc func = (BenchAtomicFunc) data;
+
+	for (pint round = 0; round < PSYNC_BENCH_ROUNDS; ++round)
+		func ();
+
+	return NULL;
+}
+
+static puint64 bench_run_atomic (BenchAtomicFunc func, pint threads)
+{
+	PUThread	*thr[PSYNC_BENCH_MAX_THREADS];
+	puint64		usecs;
+
+	P_BENCH_MEASURE (usecs, {
+		for (pint i = 0; i < threads; ++i)
+			thr[i] = p_uthread_create ((PUThreadFunc) bench_atomic_thread, (ppointer) func, TRUE, NULL);
+
+		for (pint i = 0; i < threads; ++i) {
+			p_uthread_join (thr[i]);
+			p_uthread_unref (thr[i]);
+		}
+	});
+
+	return usecs;
+}
+
+P_BENCH_CASE_BEGIN (psync_atomic_bench)
+{
+	pint	max_threads = bench_max_threads ();
+	pchar	name[64];
+
+	for (pint threads = 1; ; threads *= 2) {
+		if (threads > max_threads)
+			threads = max_threads;
+
+		psize ops = (psize) threads * PSYNC_BENCH_ROUNDS;
+
+		snprintf (name, sizeof (name), "Atomic int increment, %d threads", threads);
+		p_bench_report (name, ops, bench_run_atomic (bench_atomic_inc, threads));
+
+		snprintf (name, sizeof (name), "Atomic int CAS loop, %d threads", threads);
+		p_bench_report (name, ops, bench_run_atomic (bench_atomic_cas, threads));
+
+		snprintf (name, sizeof (name), "Atomic int relaxed add, %d threads", threads);
+		p_bench_report (name, ops, bench_run_atomic (bench_atomic_add_relaxed, threads));
+
+		snprintf (name, sizeof (name), "Atomic int64 add, %d threads", threads);
+		p_bench_report (name, ops, bench_run_atomic (bench_atomic_int64_add, threads));
+
+		if (threads == max_threads)
+			break;
+	}
+}
+P_BENCH_CASE_END ()
+
+P_BENCH_SUITE_BEGIN ()
+{
+	P_BENCH_SUITE_RUN_CASE (psync_backend_info);
+	P_BENCH_SUITE_RUN_CASE (psync_mutex_bench);
+	P_BENCH_SUITE_RUN_CASE (psync_rwlock_bench);
+	P_BENCH_SUITE_RUN_CASE (psync_condvar_bench);
+	P_BENCH_SUITE_RUN_CASE (psync_atomic_bench);
+}
+P_BENCH_SUITE_END ()
@@ -0,0 +1,95 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "plibsys.h"
+#include "pbenchmacros.h"
+
+#include <time.h>
+
+#define PTIMEPROFILER_BENCH_ROUNDS	10000000
+
+P_BENCH_CASE_BEGIN (ptimeprofiler_read_bench)
+{
+	PTimeProfiler		*profiler = p_time_profiler_new ();
+	volatile puint64	sink      = 0;
+	puint64			usecs;
+
+	P_BENCH_MEASURE (usecs, {
+		for (pint round = 0; round < PTIMEPROFILER_BENCH_ROUNDS; ++round)
+			sink += p_time_profiler_elapsed_usecs (profiler);
+	});
+
+	p_bench_report ("Elapsed time", PTIMEPROFILER_BENCH_ROUNDS, usecs);
+
+	P_BENCH_MEASURE (usecs, {
+		for (pint round = 0; round < PTIMEPROFILER_BENCH_ROUNDS; ++round)
+			p_time_profiler_reset (profiler);
+	});
+
+	p_bench_report ("Reset", PTIMEPROFILER_BENCH_ROUNDS, usecs);
+
+	P_BENCH_MEASURE (usecs, {
+		for (pint round = 0; round < PTIMEPROFILER_BENCH_ROUNDS; ++round)
+			sink += p_time_profiler_elapsed_nsecs (profiler);
+	});
+
+	p_bench_report ("Elapsed time, nanoseconds", PTIMEPROFILER_BENCH_ROUNDS, usecs);
+
+	P_BENCH_MEASURE (usecs, {
+		for (pint round = 0; round < PTIMEPROFILER_BENCH_ROUNDS; ++round)
+			sink += p_time_profiler_ticks ();
+	});
+
+	p_bench_report ("Raw ticks", PTIMEPROFILER_BENCH_ROUNDS, usecs);
+
+	P_BENCH_MEASURE (usecs, {
+		for (pint round = 0; round < PTIMEPROFILER_BENCH_ROUNDS; ++round)
+			sink += p_time_coarse_now_msecs ();
+	});
+
+	p_bench_report ("Coarse clock, milliseconds", PTIMEPROFILER_BENCH_ROUNDS, usecs);
+
+#if defined (CLOCK_MONOTONIC)
+	struct timespec ts;
+
+	/* Reference: the clock PTimeProfiler falls back to */
+	P_BENCH_MEASURE (usecs, {
+		for (pint round = 0; round < PTIMEPROFILER_BENCH_ROUNDS; ++round) {
+			clock_gettime (CLOCK_MONOTONIC, &ts);
+			sink += (puint64) ts.tv_nsec;
+		}
+	});
+
+	p_bench_report ("clock_gettime (CLOCK_MONOTONIC)", PTIMEPROFILER_BENCH_ROUNDS, usecs);
+#endif
+
+	p_time_profiler_free (profiler);
+}
+P_BENCH_CASE_END ()
+
+P_BENCH_SUITE_BEGIN ()
+{
+	P_BENCH_SUITE_RUN_CASE (ptimeprofiler_read_bench);
+}
+P_BENCH_SUITE_END ()
@@ -0,0 +1,81 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "plibsys.h"
+#include "pbenchmacros.h"
+
+#include <stdio.h>
+
+#define PTRACE_BENCH_ROUNDS	1000000
+
+static void
+ptrace_bench_collect (const PTraceRecord *records, psize count, ppointer user_data)
+{
+	P_UNUSED (records);
+
+	*((psize *) user_data) += count;
+}
+
+P_BENCH_CASE_BEGIN (ptrace_span_bench)
+{
+	psize	collected = 0;
+	puint64	usecs;
+	pchar	name[64];
+
+	P_BENCH_MEASURE (usecs, {
+		for (pint round = 0; round < PTRACE_BENCH_ROUNDS; ++round) {
+			P_TRACE_BEGIN ("bench span");
+			P_TRACE_END;
+		}
+	});
+
+	p_bench_report ("Span, not recording", PTRACE_BENCH_ROUNDS, usecs);
+
+	if (p_trace_start (ptrace_bench_collect, &collected, 1) == FALSE) {
+		printf ("Tracing is not supported\n");
+		return;
+	}
+
+	P_BENCH_MEASURE (usecs, {
+		for (pint round = 0; round < PTRACE_BENCH_ROUNDS; ++round) {
+			P_TRACE_BEGIN_ARGS ("bench span", round, 0);
+			P_TRACE_END;
+		}
+	});
+
+	p_trace_stop ();
+
+	/* A full buffer drops the records, that costs less than recording */
+	snprintf (name, sizeof (name), "Span, recording, %.1f%% dropped",
+		  100.0 * (double) p_trace_get_dropped () / (PTRACE_BENCH_ROUNDS * 2));
+
+	p_bench_report (name, PTRACE_BENCH_ROUNDS, usecs);
+}
+P_BENCH_CASE_END ()
+
+P_BENCH_SUITE_BEGIN ()
+{
+	P_BENCH_SUITE_RUN_CASE (ptrace_span_bench);
+}
+P_BENCH_SUITE_END ()
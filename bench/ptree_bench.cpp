@@ -0,0 +1,349 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "pbenchmacros.h"
+
+#include <stdlib.h>
+
+#define PTREE_BENCH_KEYS	1000000
+#define PTREE_BENCH_REBUILD_KEYS	256
+#define PTREE_BENCH_REBUILDS	20000
+#define PTREE_BENCH_SNAPSHOTS	10000
+
+static pint bench_compare_keys (pconstpointer a, pconstpointer b)
+{
+	psize p1 = (psize) a;
+	psize p2 = (psize) b;
+
+	return p1 < p2 ? -1 : (p1 > p2 ? 1 : 0);
+}
+
+static void bench_tree_run (PTreeType type, const pchar *name, ppointer *keys, psize count)
+{
+	PTree	*tree;
+	puint64	usecs;
+	psize	found;
+	pchar	label[64];
+
+	tree = p_tree_new (type, bench_compare_keys);
+
+	P_BENCH_MEASURE (usecs, {
+		for (psize i = 0; i < count; ++i)
+			p_tree_insert (tree, keys[i], keys[i]);
+	});
+
+	snprintf (label, sizeof (label), "%s insert", name);
+	p_bench_report (label, count, usecs);
+
+	found = 0;
+
+	P_BENCH_MEASURE (usecs, {
+		for (psize i = count; i > 0; --i)
+			found += p_tree_lookup (tree, keys[i - 1]) == keys[i - 1] ? 1 : 0;
+	});
+
+	snprintf (label, sizeof (label), "%s lookup", name);
+	p_bench_report (label, count, usecs);
+
+	P_BENCH_MEASURE (usecs, {
+		for (psize i = 0; i < count; ++i)
+			p_tree_remove (tree, keys[i]);
+	});
+
+	snprintf (label, sizeof (label), "%s remove", name);
+	p_bench_report (label, count, usecs);
+
+	if (found != count)
+		printf ("  lookup mismatch: %lu found\n", (unsigned long) found);
+
+	p_tree_free (tree);
+}
+
+static void bench_tree_rebuild (PTree *tree, const pchar *name)
+{
+	puint64	usecs;
+	pchar	label[64];
+
+	P_BENCH_MEASURE (usecs, {
+		for (pint i = 0; i < PTREE_BENCH_REBUILDS; ++i) {
+			for (psize j = 0; j < PTREE_BENCH_REBUILD_KEYS; ++j)
+				p_tree_insert (tree, (ppointer) ((j * 7919) % PTREE_BENCH_REBUILD_KEYS + 1), NULL);
+
+			p_tree_clear (tree);
+		}
+	});
+
+	snprintf (label, sizeof (label), "%s rebuild", name);
+	p_bench_report (label, (psize) PTREE_BENCH_REBUILDS * PTREE_BENCH_REBUILD_KEYS, usecs);
+
+	p_tree_free (tree);
+}
+
+P_BENCH_CASE_BEGIN (ptree_types_bench)
+{
+	ppointer *keys = (ppointer *) p_malloc0 (PTREE_BENCH_KEYS * sizeof (ppointer));
+
+	srand (1);
+
+	for (psize i = 0; i < PTREE_BENCH_KEYS; ++i)
+		keys[i] = (ppointer) ((i + 1) * 16);
+
+	/* Random order defeats hardware prefetching */
+	for (psize i = PTREE_BENCH_KEYS - 1; i > 0; --i) {
+		psize		j   = ((psize) rand () * RAND_MAX + (psize) rand ()) % (i + 1);
+		ppointer	tmp = keys[i];
+
+		keys[i] = keys[j];
+		keys[j] = tmp;
+	}
+
+	printf ("Keys: %d\n", PTREE_BENCH_KEYS);
+
+	bench_tree_run (P_TREE_TYPE_RB, "red-black", keys, PTREE_BENCH_KEYS);
+	bench_tree_run (P_TREE_TYPE_AVL, "AVL", keys, PTREE_BENCH_KEYS);
+	bench_tree_run (P_TREE_TYPE_BTREE, "B-tree", keys, PTREE_BENCH_KEYS);
+
+	p_free (keys);
+}
+P_BENCH_CASE_END ()
+
+static void bench_tree_load (PTreeType type, const pchar *name, ppointer *keys, psize count)
+{
+	PTree	*tree;
+	puint64	usecs;
+	pchar	label[64];
+
+	tree = p_tree_new (type, bench_compare_keys);
+
+	P_BENCH_MEASURE (usecs, {
+		for (psize i = 0; i < count; ++i)
+			p_tree_insert (tree, keys[i], keys[i]);
+	});
+
+	snprintf (label, sizeof (label), "%s insert sorted", name);
+	p_bench_report (label, count, usecs);
+
+	p_tree_free (tree);
+
+	P_BENCH_MEASURE (usecs, {
+		tree = p_tree_new_from_sorted (type,
+					       (PCompareDataFunc) bench_compare_keys,
+					       NULL,
+					       NULL,
+					       NULL,
+					       keys,
+					       keys,
+					       count);
+	});
+
+	snprintf (label, sizeof (label), "%s from sorted", name);
+	p_bench_report (label, count, usecs);
+
+	p_tree_free (tree);
+}
+
+P_BENCH_CASE_BEGIN (ptree_sorted_bench)
+{
+	ppointer *keys = (ppointer *) p_malloc0 (PTREE_BENCH_KEYS * sizeof (ppointer));
+
+	for (psize i = 0; i < PTREE_BENCH_KEYS; ++i)
+		keys[i] = (ppointer) ((i + 1) * 16);
+
+	printf ("Keys: %d\n", PTREE_BENCH_KEYS);
+
+	bench_tree_load (P_TREE_TYPE_RB, "red-black", keys, PTREE_BENCH_KEYS);
+	bench_tree_load (P_TREE_TYPE_AVL, "AVL", keys, PTREE_BENCH_KEYS);
+	bench_tree_load (P_TREE_TYPE_BTREE, "B-tree", keys, PTREE_BENCH_KEYS);
+
+	p_free (keys);
+}
+P_BENCH_CASE_END ()
+
+P_BENCH_CASE_BEGIN (ptree_pooled_bench)
+{
+	printf ("Rebuilds: %d x %d keys\n", PTREE_BENCH_REBUILDS, PTREE_BENCH_REBUILD_KEYS);
+
+	bench_tree_rebuild (p_tree_new (P_TREE_TYPE_RB, bench_compare_keys), "red-black");
+	bench_tree_rebuild (p_tree_new_pooled (P_TREE_TYPE_RB,
+					       (PCompareDataFunc) bench_compare_keys,
+					       NULL,
+					       NULL,
+					       NULL),
+			    "red-black pooled");
+	bench_tree_rebuild (p_tree_new (P_TREE_TYPE_AVL, bench_compare_keys), "AVL");
+	bench_tree_rebuild (p_tree_new_pooled (P_TREE_TYPE_AVL,
+					       (PCompareDataFunc) bench_compare_keys,
+					       NULL,
+					       NULL,
+					       NULL),
+			    "AVL pooled");
+}
+P_BENCH_CASE_END ()
+
+P_BENCH_CASE_BEGIN (ptree_snapshot_bench)
+{
+	ppointer	*keys = (ppointer *) p_malloc0 (PTREE_BENCH_KEYS * sizeof (ppointer));
+	ppointer	*copy_keys = (ppointer *) p_malloc0 (PTREE_BENCH_KEYS * sizeof (ppointer));
+	PTree		*tree;
+	PTree		*copy;
+	PTreeIter	iter;
+	puint64		usecs;
+	psize		count;
+
+	for (psize i = 0; i < PTREE_BENCH_KEYS; ++i)
+		keys[i] = (ppointer) ((psize) rand () * 16 + 16);
+
+	printf ("Keys: %d, snapshots: %d\n", PTREE_BENCH_KEYS, PTREE_BENCH_SNAPSHOTS);
+
+	tree = p_tree_new_persistent ((PCompareDataFunc) bench_compare_keys, NULL);
+
+	P_BENCH_MEASURE (usecs, {
+		for (psize i = 0; i < PTREE_BENCH_KEYS; ++i)
+			p_tree_insert (tree, keys[i], keys[i]);
+	});
+
+	p_bench_report ("persistent insert", PTREE_BENCH_KEYS, usecs);
+
+	/* A consistent copy without snapshots takes a full walk and rebuild */
+	P_BENCH_MEASURE (usecs, {
+		count = 0;
+		p_tree_iter_init (&iter, tree);
+
+		while (p_tree_iter_next (&iter, &copy_keys[count], NULL) == TRUE)
+			++count;
+
+		copy = p_tree_new_from_sorted (P_TREE_TYPE_AVL,
+					       (PCompareDataFunc) bench_compare_keys,
+					       NULL,
+					       NULL,
+					       NULL,
+					       copy_keys,
+					       copy_keys,
+					       count);
+	});
+
+	p_bench_report ("deep copy", 1, usecs);
+	p_tree_free (copy);
+
+	/* Every write after a snapshot copies the path to the changed key */
+	P_BENCH_MEASURE (usecs, {
+		for (psize i = 0; i < PTREE_BENCH_SNAPSHOTS; ++i) {
+			copy = p_tree_snapshot (tree);
+			p_tree_insert (tree, (ppointer) ((psize) keys[i] + 1), NULL);
+			p_tree_free (copy);
+		}
+	});
+
+	p_bench_report ("snapshot and write", PTREE_BENCH_SNAPSHOTS, usecs);
+
+	p_tree_free (tree);
+	p_free (copy_keys);
+	p_free (keys);
+}
+P_BENCH_CASE_END ()
+
+typedef struct _BenchLinkItem {
+	psize		id;
+	psize		payload;
+	PTreeLink	link;
+} BenchLinkItem;
+
+P_BENCH_CASE_BEGIN (ptree_link_bench)
+{
+	BenchLinkItem	**objects = (BenchLinkItem **) p_malloc0 (PTREE_BENCH_KEYS * sizeof (BenchLinkItem *));
+	PTreeLinkHead	head;
+	PTree		*tree;
+	puint64		usecs;
+	psize		sum;
+
+	/* Unique keys in a random order */
+	for (psize i = 0; i < PTREE_BENCH_KEYS; ++i) {
+		objects[i]          = (BenchLinkItem *) p_malloc0 (sizeof (BenchLinkItem));
+		objects[i]->id      = (psize) ((puint32) i * 2654435761U) + 1;
+		objects[i]->payload = i;
+	}
+
+	printf ("Objects: %d\n", PTREE_BENCH_KEYS);
+
+	/* The tree nodes point to the objects */
+	tree = p_tree_new (P_TREE_TYPE_RB, bench_compare_keys);
+
+	P_BENCH_MEASURE (usecs, {
+		for (psize i = 0; i < PTREE_BENCH_KEYS; ++i)
+			p_tree_insert (tree, (ppointer) objects[i]->id, objects[i]);
+	});
+
+	p_bench_report ("red-black insert", PTREE_BENCH_KEYS, usecs);
+
+	sum = 0;
+
+	P_BENCH_MEASURE (usecs, {
+		for (psize i = 0; i < PTREE_BENCH_KEYS; ++i)
+			sum += ((BenchLinkItem *) p_tree_lookup (tree, (ppointer) objects[i]->id))->payload;
+	});
+
+	p_bench_report ("red-black lookup", PTREE_BENCH_KEYS, usecs);
+
+	p_tree_free (tree);
+
+	/* The same objects hold the links themselves */
+	p_tree_link_head_init (&head, (PCompareDataFunc) bench_compare_keys, NULL);
+
+	P_BENCH_MEASURE (usecs, {
+		for (psize i = 0; i < PTREE_BENCH_KEYS; ++i)
+			p_tree_link_insert (&head, &objects[i]->link, (ppointer) objects[i]->id);
+	});
+
+	p_bench_report ("intrusive insert", PTREE_BENCH_KEYS, usecs);
+
+	P_BENCH_MEASURE (usecs, {
+		for (psize i = 0; i < PTREE_BENCH_KEYS; ++i)
+			sum -= P_CONTAINER_OF (p_tree_link_lookup (&head, (ppointer) objects[i]->id),
+					       BenchLinkItem,
+					       link)->payload;
+	});
+
+	p_bench_report ("intrusive lookup", PTREE_BENCH_KEYS, usecs);
+
+	if (sum != 0)
+		printf ("Lookup results mismatch\n");
+
+	for (psize i = 0; i < PTREE_BENCH_KEYS; ++i)
+		p_free (objects[i]);
+
+	p_free (objects);
+}
+P_BENCH_CASE_END ()
+
+P_BENCH_SUITE_BEGIN ()
+{
+	P_BENCH_SUITE_RUN_CASE (ptree_types_bench);
+	P_BENCH_SUITE_RUN_CASE (ptree_pooled_bench);
+	P_BENCH_SUITE_RUN_CASE (ptree_sorted_bench);
+	P_BENCH_SUITE_RUN_CASE (ptree_snapshot_bench);
+	P_BENCH_SUITE_RUN_CASE (ptree_link_bench);
+}
+P_BENCH_SUITE_END ()
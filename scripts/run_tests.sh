@@ -26,10 +26,14 @@
 #
 #===========================================================================
 
-if [[ $# -ne 2 ]]; then
-    echo "Usage: run_tests.sh <testing_dir> <shared_library>"
+if [[ $# -ne 2 && $# -ne 3 ]]; then
+    echo "Usage: run_tests.sh <testing_dir> <shared_library> [<perf_baseline_dir>]"
     echo "Where: <testing_dir> is a directory containing tests to run"
     echo "       <shared_library> is a path to the shared library to be tested"
+    echo "       <perf_baseline_dir> is a directory with performance baselines,"
+    echo "       if given the benchmarks from <testing_dir> are also run and"
+    echo "       fail on regressions beyond PLIBSYS_PERF_TOLERANCE percent"
+    echo "       (50 by default), missing baselines are recorded"
     exit 1
 fi
 
@@ -67,4 +71,26 @@ do
     fi
 done
 
+if [[ $# -eq 3 ]]; then
+    echo "Running performance tests..."
+
+    for file in $files
+    do
+        if [[ $file == *"_bench"* && $file != *".baseline" ]]; then
+            bench_name=${file%.*}
+            total_counter=$((total_counter + 1))
+            echo "[RUN ] $bench_name"
+
+            $($1/${file} --baseline $3 --tolerance ${PLIBSYS_PERF_TOLERANCE:-50} > /dev/null 2>&1)
+
+            if [[ $? -ne 0 ]]; then
+                echo "[FAIL] *** Performance test failed: $bench_name"
+            else
+                echo "[PASS] Performance test passed: $bench_name"
+                pass_counter=$((pass_counter + 1))
+            fi
+        fi
+    done
+fi
+
 echo "Tests passed: $pass_counter/$total_counter"
@@ -0,0 +1,334 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "pmem.h"
+#include "parray.h"
+
+#include <string.h>
+
+#define P_ARRAY_MIN_CAPACITY	8
+#define P_ARRAY_SORT_INSERTION	16
+#define P_ARRAY_SORT_STACK	64
+
+struct PArray_ {
+	ppointer	*data;
+	psize		length;
+	psize		capacity;
+};
+
+static pboolean pp_array_grow (PArray *array, psize capacity);
+static pint pp_array_compare (PCompareFunc func, PCompareDataFunc data_func, ppointer data, pconstpointer a, pconstpointer b);
+static void pp_array_sort (PArray *array, PCompareFunc func, PCompareDataFunc data_func, ppointer data);
+
+static pboolean
+pp_array_grow (PArray *array, psize capacity)
+{
+	ppointer	*new_data;
+	psize		new_capacity;
+
+	new_capacity = array->capacity < P_ARRAY_MIN_CAPACITY ? P_ARRAY_MIN_CAPACITY : array->capacity;
+
+	while (new_capacity < capacity) {
+		if (P_UNLIKELY (new_capacity > ((psize) -1) / sizeof (ppointer) / 2)) {
+			new_capacity = capacity;
+			break;
+		}
+
+		new_capacity <<= 1;
+	}
+
+	if (P_UNLIKELY (new_capacity > ((psize) -1) / sizeof (ppointer)))
+		return FALSE;
+
+	if (P_UNLIKELY ((new_data = p_realloc (array->data, new_capacity * sizeof (ppointer))) == NULL))
+		return FALSE;
+
+	array->data     = new_data;
+	array->capacity = new_capacity;
+
+	return TRUE;
+}
+
+static pint
+pp_array_compare (PCompareFunc		func,
+		  PCompareDataFunc	data_func,
+		  ppointer		data,
+		  pconstpointer		a,
+		  pconstpointer		b)
+{
+	return func != NULL ? func (a, b) : data_func (a, b, data);
+}
+
+/* Iterative quicksort with a median of three pivot, the smaller partition is
+ * always sorted first to keep the stack within log2(N) entries */
+static void
+pp_array_sort (PArray *array, PCompareFunc func, PCompareDataFunc data_func, ppointer data)
+{
+	psize		stack[P_ARRAY_SORT_STACK * 2];
+	psize		depth;
+	psize		lo, hi;
+	psize		i, j, mid;
+	ppointer	*elems;
+	ppointer	pivot;
+	ppointer	tmp;
+
+	elems = array->data;
+	depth = 0;
+	lo    = 0;
+	hi    = array->length;
+
+	for (;;) {
+		while (hi - lo > P_ARRAY_SORT_INSERTION) {
+			mid = lo + (hi - lo) / 2;
+
+			/* Order elems[lo] <= elems[mid] <= elems[hi - 1] */
+			if (pp_array_compare (func, data_func, data, elems[mid], elems[lo]) < 0) {
+				tmp = elems[mid]; elems[mid] = elems[lo]; elems[lo] = tmp;
+			}
+
+			if (pp_array_compare (func, data_func, data, elems[hi - 1], elems[mid]) < 0) {
+				tmp = elems[hi - 1]; elems[hi - 1] = elems[mid]; elems[mid] = tmp;
+
+				if (pp_array_compare (func, data_func, data, elems[mid], elems[lo]) < 0) {
+					tmp = elems[mid]; elems[mid] = elems[lo]; elems[lo] = tmp;
+				}
+			}
+
+			pivot = elems[mid];
+			i     = lo;
+			j     = hi - 1;
+
+			for (;;) {
+				while (pp_array_compare (func, data_func, data, elems[i], pivot) < 0)
+					++i;
+
+				while (pp_array_compare (func, data_func, data, pivot, elems[j]) < 0)
+					--j;
+
+				if (i >= j)
+					break;
+
+				tmp = elems[i]; elems[i] = elems[j]; elems[j] = tmp;
+
+				++i;
+				--j;
+			}
+
+			/* Partitions are [lo, j + 1) and [j + 1, hi) */
+			if (j + 1 - lo < hi - j - 1) {
+				stack[depth * 2]     = j + 1;
+				stack[depth * 2 + 1] = hi;
+				hi = j + 1;
+			} else {
+				stack[depth * 2]     = lo;
+				stack[depth * 2 + 1] = j + 1;
+				lo = j + 1;
+			}
+
+			++depth;
+		}
+
+		for (i = lo + 1; i < hi; ++i) {
+			tmp = elems[i];
+
+			for (j = i; j > lo && pp_array_compare (func, data_func, data, tmp, elems[j - 1]) < 0; --j)
+				elems[j] = elems[j - 1];
+
+			elems[j] = tmp;
+		}
+
+		if (depth == 0)
+			break;
+
+		--depth;
+		lo = stack[depth * 2];
+		hi = stack[depth * 2 + 1];
+	}
+}
+
+P_LIB_API PArray *
+p_array_new (void)
+{
+	PArray *ret;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PArray))) == NULL)) {
+		P_ERROR ("PArray::p_array_new: failed to allocate memory");
+		return NULL;
+	}
+
+	return ret;
+}
+
+P_LIB_API PArray *
+p_array_new_sized (psize capacity)
+{
+	PArray *ret;
+
+	if (P_UNLIKELY ((ret = p_array_new ()) == NULL))
+		return NULL;
+
+	if (P_UNLIKELY (p_array_reserve (ret, capacity) == FALSE)) {
+		P_ERROR ("PArray::p_array_new_sized: failed to allocate memory");
+		p_array_free (ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+P_LIB_API pboolean
+p_array_push (PArray *array, ppointer data)
+{
+	if (P_UNLIKELY (array == NULL))
+		return FALSE;
+
+	if (array->length == array->capacity) {
+		if (P_UNLIKELY (pp_array_grow (array, array->length + 1) == FALSE)) {
+			P_ERROR ("PArray::p_array_push: failed to allocate memory");
+			return FALSE;
+		}
+	}
+
+	array->data[array->length++] = data;
+
+	return TRUE;
+}
+
+P_LIB_API ppointer
+p_array_pop (PArray *array)
+{
+	if (P_UNLIKELY (array == NULL || array->length == 0))
+		return NULL;
+
+	return array->data[--array->length];
+}
+
+P_LIB_API pboolean
+p_array_reserve (PArray *array, psize capacity)
+{
+	if (P_UNLIKELY (array == NULL))
+		return FALSE;
+
+	if (capacity <= array->capacity)
+		return TRUE;
+
+	return pp_array_grow (array, capacity);
+}
+
+P_LIB_API ppointer
+p_array_index (const PArray *array, psize index)
+{
+	if (P_UNLIKELY (array == NULL || index >= array->length))
+		return NULL;
+
+	return array->data[index];
+}
+
+P_LIB_API void
+p_array_remove_index (PArray *array, psize index)
+{
+	if (P_UNLIKELY (array == NULL || index >= array->length))
+		return;
+
+	--array->length;
+
+	memmove (array->data + index,
+		 array->data + index + 1,
+		 (array->length - index) * sizeof (ppointer));
+}
+
+P_LIB_API psize
+p_array_length (const PArray *array)
+{
+	if (P_UNLIKELY (array == NULL))
+		return 0;
+
+	return array->length;
+}
+
+P_LIB_API ppointer *
+p_array_data (const PArray *array)
+{
+	if (P_UNLIKELY (array == NULL || array->length == 0))
+		return NULL;
+
+	return array->data;
+}
+
+P_LIB_API void
+p_array_foreach (const PArray *array, PFunc func, ppointer user_data)
+{
+	psize i;
+
+	if (P_UNLIKELY (array == NULL || func == NULL))
+		return;
+
+	for (i = 0; i < array->length; ++i)
+		func (array->data[i], user_data);
+}
+
+P_LIB_API void
+p_array_reverse (PArray *array)
+{
+	ppointer	tmp;
+	psize		i;
+
+	if (P_UNLIKELY (array == NULL))
+		return;
+
+	for (i = 0; i < array->length / 2; ++i) {
+		tmp                                = array->data[i];
+		array->data[i]                     = array->data[array->length - i - 1];
+		array->data[array->length - i - 1] = tmp;
+	}
+}
+
+P_LIB_API void
+p_array_sort (PArray *array, PCompareFunc func)
+{
+	if (P_UNLIKELY (array == NULL || func == NULL))
+		return;
+
+	pp_array_sort (array, func, NULL, NULL);
+}
+
+P_LIB_API void
+p_array_sort_with_data (PArray *array, PCompareDataFunc func, ppointer data)
+{
+	if (P_UNLIKELY (array == NULL || func == NULL))
+		return;
+
+	pp_array_sort (array, NULL, func, data);
+}
+
+P_LIB_API void
+p_array_free (PArray *array)
+{
+	if (P_UNLIKELY (array == NULL))
+		return;
+
+	p_free (array->data);
+	p_free (array);
+}
@@ -0,0 +1,234 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file parray.h
+ * @brief Dynamic array of pointers
+ * @author Alexander Saprykin
+ *
+ * #PArray is a growable array which stores pointers in a single contiguous
+ * block of memory. Unlike #PList it doesn't require an allocation per element,
+ * provides O(1) indexed access and a cache friendly traversal.
+ *
+ * Use p_array_new() or p_array_new_sized() to create an array. Appending with
+ * p_array_push() takes amortized O(1) time: the storage grows geometrically,
+ * and you can use p_array_reserve() to make room for a known number of
+ * elements at once.
+ *
+ * Elements are accessed with p_array_index(), or directly through the pointer
+ * returned by p_array_data():
+ * @code
+ * PArray      *array;
+ * ppointer    *data;
+ * psize       i;
+ *
+ * array = p_array_new ();
+ *
+ * p_array_push (array, P_INT_TO_POINTER (12));
+ * p_array_push (array, P_INT_TO_POINTER (14));
+ *
+ * data = p_array_data (array);
+ *
+ * for (i = 0; i < p_array_length (array); ++i)
+ *     my_func (data[i]);
+ *
+ * p_array_free (array);
+ * @endcode
+ * #PArray stores only the pointers to the data, so you must free used memory
+ * manually, p_array_free() only frees array's internal memory. The best
+ * approach to free used memory is the p_array_foreach() routine.
+ *
+ * The array can be sorted in place with p_array_sort() and
+ * p_array_sort_with_data(). Sorting is not stable and doesn't allocate memory.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PARRAY_H
+#define PLIBSYS_HEADER_PARRAY_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+
+P_BEGIN_DECLS
+
+/** Array opaque data structure. */
+typedef struct PArray_ PArray;
+
+/**
+ * @brief Initializes a new array.
+ * @return Pointer to a newly initialized #PArray structure in case of success,
+ * NULL otherwise.
+ * @since 0.0.5
+ * @note Free with p_array_free() after usage.
+ */
+P_LIB_API PArray *	p_array_new		(void);
+
+/**
+ * @brief Initializes a new array with a capacity hint.
+ * @param capacity Number of elements the array should hold without growing.
+ * @return Pointer to a newly initialized #PArray structure in case of success,
+ * NULL otherwise.
+ * @since 0.0.5
+ * @note Free with p_array_free() after usage.
+ */
+P_LIB_API PArray *	p_array_new_sized	(psize			capacity);
+
+/**
+ * @brief Appends data to an array.
+ * @param array Initialized array.
+ * @param data Data to append.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * This call takes amortized O(1) time. The array is left untouched if it fails
+ * to grow.
+ */
+P_LIB_API pboolean	p_array_push		(PArray			*array,
+						 ppointer		data);
+
+/**
+ * @brief Removes the last element from an array.
+ * @param array Initialized array.
+ * @return Data of the removed element, NULL if the array is empty.
+ * @since 0.0.5
+ */
+P_LIB_API ppointer	p_array_pop		(PArray			*array);
+
+/**
+ * @brief Makes room for a number of elements in an array.
+ * @param array Initialized array.
+ * @param capacity Total number of elements the array should hold without
+ * growing.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The array never shrinks, so a capacity below the current one is a no-op.
+ */
+P_LIB_API pboolean	p_array_reserve		(PArray			*array,
+						 psize			capacity);
+
+/**
+ * @brief Gets an array element by its index.
+ * @param array Initialized array.
+ * @param index Index of the element.
+ * @return Data of the element, NULL if @a index is out of range.
+ * @since 0.0.5
+ */
+P_LIB_API ppointer	p_array_index		(const PArray		*array,
+						 psize			index);
+
+/**
+ * @brief Removes an array element by its index.
+ * @param array Initialized array.
+ * @param index Index of the element.
+ * @since 0.0.5
+ *
+ * Elements after @a index are shifted to keep the order.
+ */
+P_LIB_API void		p_array_remove_index	(PArray			*array,
+						 psize			index);
+
+/**
+ * @brief Gets the number of array elements.
+ * @param array Initialized array.
+ * @return Number of elements in the @a array.
+ * @since 0.0.5
+ */
+P_LIB_API psize		p_array_length		(const PArray		*array);
+
+/**
+ * @brief Gets the array storage.
+ * @param array Initialized array.
+ * @return Pointer to the first element, NULL if the @a array is empty.
+ * @since 0.0.5
+ *
+ * The pointer is valid until the array is modified.
+ */
+P_LIB_API ppointer *	p_array_data		(const PArray		*array);
+
+/**
+ * @brief Calls a specified function for each array element.
+ * @param array Array to go through.
+ * @param func Pointer for the callback function.
+ * @param user_data User defined data, may be NULL.
+ * @since 0.0.5
+ *
+ * The @a func will receive the element data and @a user_data in the array
+ * order.
+ */
+P_LIB_API void		p_array_foreach		(const PArray		*array,
+						 PFunc			func,
+						 ppointer		user_data);
+
+/**
+ * @brief Reverses the array order in place.
+ * @param array Array to reverse.
+ * @since 0.0.5
+ */
+P_LIB_API void		p_array_reverse		(PArray			*array);
+
+/**
+ * @brief Sorts an array in place.
+ * @param array Array to sort.
+ * @param func Function to compare two elements.
+ * @since 0.0.5
+ *
+ * The @a func receives the element data, it should return a negative value if
+ * the first element is less than the second one, a positive value if it is
+ * greater, and zero if they are equal. Sorting takes O(NlogN) average time and
+ * is not stable.
+ */
+P_LIB_API void		p_array_sort		(PArray			*array,
+						 PCompareFunc		func);
+
+/**
+ * @brief Sorts an array in place using additional data for comparison.
+ * @param array Array to sort.
+ * @param func Function to compare two elements.
+ * @param data Data to pass into @a func, may be NULL.
+ * @since 0.0.5
+ *
+ * Same as p_array_sort(), but @a data is passed into every @a func call.
+ */
+P_LIB_API void		p_array_sort_with_data	(PArray			*array,
+						 PCompareDataFunc	func,
+						 ppointer		data);
+
+/**
+ * @brief Frees array memory.
+ * @param array Array to free.
+ * @since 0.0.5
+ *
+ * This function frees only the array's internal memory, not the data stored in
+ * the elements.
+ */
+P_LIB_API void		p_array_free		(PArray			*array);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PARRAY_H */
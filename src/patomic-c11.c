@@ -27,12 +27,30 @@
 
 #ifdef P_CC_SUN
 #  define PATOMIC_INT_CAST(x) (pint *) (x)
+#  define PATOMIC_INT64_CAST(x) (pint64 *) (x)
 #  define PATOMIC_SIZE_CAST(x) (psize *) (x)
 #else
 #  define PATOMIC_INT_CAST(x) x
+#  define PATOMIC_INT64_CAST(x) x
 #  define PATOMIC_SIZE_CAST(x) x
 #endif
 
+#if (PLIBSYS_SIZEOF_VOID_P == 8)
+#  define PATOMIC_POINTER_LOAD(x, order) __atomic_load_8 (PATOMIC_SIZE_CAST ((const volatile psize *) (x)), order)
+#  define PATOMIC_POINTER_STORE(x, val, order) __atomic_store_8 (PATOMIC_SIZE_CAST ((volatile psize *) (x)), val, order)
+#else
+#  define PATOMIC_POINTER_LOAD(x, order) __atomic_load_4 (PATOMIC_SIZE_CAST ((const volatile psize *) (x)), order)
+#  define PATOMIC_POINTER_STORE(x, val, order) __atomic_store_4 (PATOMIC_SIZE_CAST ((volatile psize *) (x)), val, order)
+#endif
+
+/* The memory order must be a constant for the builtins, otherwise it is
+ * treated as sequentially consistent: switch over all the orders */
+
+/* 32-bit targets may have no 64-bit compare and exchange */
+#if (PLIBSYS_SIZEOF_VOID_P == 8) || defined (__GCC_HAVE_SYNC_COMPARE_AND_SWAP_8)
+#  define PATOMIC_INT64_LOCK_FREE
+#endif
+
 P_LIB_API pint
 p_atomic_int_get (const volatile pint *atomic)
 {
@@ -101,6 +119,88 @@ p_atomic_int_xor (volatile puint	*atomic,
 	return (puint) __atomic_fetch_xor (atomic, val, __ATOMIC_SEQ_CST);
 }
 
+P_LIB_API pint
+p_atomic_int_get_explicit (const volatile pint	*atomic,
+			   PAtomicMemoryOrder	order)
+{
+	switch (order) {
+	case P_ATOMIC_MEMORY_ORDER_RELAXED:
+		return (pint) __atomic_load_4 (PATOMIC_INT_CAST (atomic), __ATOMIC_RELAXED);
+	case P_ATOMIC_MEMORY_ORDER_ACQUIRE:
+	case P_ATOMIC_MEMORY_ORDER_RELEASE:
+	case P_ATOMIC_MEMORY_ORDER_ACQ_REL:
+		return (pint) __atomic_load_4 (PATOMIC_INT_CAST (atomic), __ATOMIC_ACQUIRE);
+	default:
+		return (pint) __atomic_load_4 (PATOMIC_INT_CAST (atomic), __ATOMIC_SEQ_CST);
+	}
+}
+
+P_LIB_API void
+p_atomic_int_set_explicit (volatile pint	*atomic,
+			   pint			val,
+			   PAtomicMemoryOrder	order)
+{
+	switch (order) {
+	case P_ATOMIC_MEMORY_ORDER_RELAXED:
+		__atomic_store_4 (PATOMIC_INT_CAST (atomic), val, __ATOMIC_RELAXED);
+		break;
+	case P_ATOMIC_MEMORY_ORDER_ACQUIRE:
+	case P_ATOMIC_MEMORY_ORDER_RELEASE:
+	case P_ATOMIC_MEMORY_ORDER_ACQ_REL:
+		__atomic_store_4 (PATOMIC_INT_CAST (atomic), val, __ATOMIC_RELEASE);
+		break;
+	default:
+		__atomic_store_4 (PATOMIC_INT_CAST (atomic), val, __ATOMIC_SEQ_CST);
+		break;
+	}
+}
+
+P_LIB_API pint
+p_atomic_int_add_explicit (volatile pint	*atomic,
+			   pint			val,
+			   PAtomicMemoryOrder	order)
+{
+	switch (order) {
+	case P_ATOMIC_MEMORY_ORDER_RELAXED:
+		return (pint) __atomic_fetch_add (atomic, val, __ATOMIC_RELAXED);
+	case P_ATOMIC_MEMORY_ORDER_ACQUIRE:
+		return (pint) __atomic_fetch_add (atomic, val, __ATOMIC_ACQUIRE);
+	case P_ATOMIC_MEMORY_ORDER_RELEASE:
+		return (pint) __atomic_fetch_add (atomic, val, __ATOMIC_RELEASE);
+	case P_ATOMIC_MEMORY_ORDER_ACQ_REL:
+		return (pint) __atomic_fetch_add (atomic, val, __ATOMIC_ACQ_REL);
+	default:
+		return (pint) __atomic_fetch_add (atomic, val, __ATOMIC_SEQ_CST);
+	}
+}
+
+P_LIB_API pboolean
+p_atomic_int_compare_and_exchange_explicit (volatile pint	*atomic,
+					    pint		oldval,
+					    pint		newval,
+					    PAtomicMemoryOrder	order)
+{
+	pint tmp_int = oldval;
+
+	switch (order) {
+	case P_ATOMIC_MEMORY_ORDER_RELAXED:
+		return (pboolean) __atomic_compare_exchange_n (PATOMIC_INT_CAST (atomic), &tmp_int, newval, 0,
+							       __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+	case P_ATOMIC_MEMORY_ORDER_ACQUIRE:
+		return (pboolean) __atomic_compare_exchange_n (PATOMIC_INT_CAST (atomic), &tmp_int, newval, 0,
+							       __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE);
+	case P_ATOMIC_MEMORY_ORDER_RELEASE:
+		return (pboolean) __atomic_compare_exchange_n (PATOMIC_INT_CAST (atomic), &tmp_int, newval, 0,
+							       __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+	case P_ATOMIC_MEMORY_ORDER_ACQ_REL:
+		return (pboolean) __atomic_compare_exchange_n (PATOMIC_INT_CAST (atomic), &tmp_int, newval, 0,
+							       __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+	default:
+		return (pboolean) __atomic_compare_exchange_n (PATOMIC_INT_CAST (atomic), &tmp_int, newval, 0,
+							       __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+	}
+}
+
 P_LIB_API ppointer
 p_atomic_pointer_get (const volatile void *atomic)
 {
@@ -165,12 +265,491 @@ p_atomic_pointer_xor (volatile void	*atomic,
 	return (psize) __atomic_fetch_xor ((volatile pssize *) atomic, val, __ATOMIC_SEQ_CST);
 }
 
+P_LIB_API ppointer
+p_atomic_pointer_get_explicit (const volatile void	*atomic,
+			       PAtomicMemoryOrder	order)
+{
+	switch (order) {
+	case P_ATOMIC_MEMORY_ORDER_RELAXED:
+		return (ppointer) PATOMIC_POINTER_LOAD (atomic, __ATOMIC_RELAXED);
+	case P_ATOMIC_MEMORY_ORDER_ACQUIRE:
+	case P_ATOMIC_MEMORY_ORDER_RELEASE:
+	case P_ATOMIC_MEMORY_ORDER_ACQ_REL:
+		return (ppointer) PATOMIC_POINTER_LOAD (atomic, __ATOMIC_ACQUIRE);
+	default:
+		return (ppointer) PATOMIC_POINTER_LOAD (atomic, __ATOMIC_SEQ_CST);
+	}
+}
+
+P_LIB_API void
+p_atomic_pointer_set_explicit (volatile void		*atomic,
+			       ppointer			val,
+			       PAtomicMemoryOrder	order)
+{
+	switch (order) {
+	case P_ATOMIC_MEMORY_ORDER_RELAXED:
+		PATOMIC_POINTER_STORE (atomic, (psize) val, __ATOMIC_RELAXED);
+		break;
+	case P_ATOMIC_MEMORY_ORDER_ACQUIRE:
+	case P_ATOMIC_MEMORY_ORDER_RELEASE:
+	case P_ATOMIC_MEMORY_ORDER_ACQ_REL:
+		PATOMIC_POINTER_STORE (atomic, (psize) val, __ATOMIC_RELEASE);
+		break;
+	default:
+		PATOMIC_POINTER_STORE (atomic, (psize) val, __ATOMIC_SEQ_CST);
+		break;
+	}
+}
+
+P_LIB_API pssize
+p_atomic_pointer_add_explicit (volatile void		*atomic,
+			       pssize			val,
+			       PAtomicMemoryOrder	order)
+{
+	switch (order) {
+	case P_ATOMIC_MEMORY_ORDER_RELAXED:
+		return (pssize) __atomic_fetch_add ((volatile pssize *) atomic, val, __ATOMIC_RELAXED);
+	case P_ATOMIC_MEMORY_ORDER_ACQUIRE:
+		return (pssize) __atomic_fetch_add ((volatile pssize *) atomic, val, __ATOMIC_ACQUIRE);
+	case P_ATOMIC_MEMORY_ORDER_RELEASE:
+		return (pssize) __atomic_fetch_add ((volatile pssize *) atomic, val, __ATOMIC_RELEASE);
+	case P_ATOMIC_MEMORY_ORDER_ACQ_REL:
+		return (pssize) __atomic_fetch_add ((volatile pssize *) atomic, val, __ATOMIC_ACQ_REL);
+	default:
+		return (pssize) __atomic_fetch_add ((volatile pssize *) atomic, val, __ATOMIC_SEQ_CST);
+	}
+}
+
+P_LIB_API pboolean
+p_atomic_pointer_compare_and_exchange_explicit (volatile void		*atomic,
+						ppointer		oldval,
+						ppointer		newval,
+						PAtomicMemoryOrder	order)
+{
+	ppointer tmp_pointer = oldval;
+
+	switch (order) {
+	case P_ATOMIC_MEMORY_ORDER_RELAXED:
+		return (pboolean) __atomic_compare_exchange_n (PATOMIC_SIZE_CAST ((volatile psize *) atomic),
+							       (psize *) &tmp_pointer,
+							       PPOINTER_TO_PSIZE (newval), 0,
+							       __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+	case P_ATOMIC_MEMORY_ORDER_ACQUIRE:
+		return (pboolean) __atomic_compare_exchange_n (PATOMIC_SIZE_CAST ((volatile psize *) atomic),
+							       (psize *) &tmp_pointer,
+							       PPOINTER_TO_PSIZE (newval), 0,
+							       __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE);
+	case P_ATOMIC_MEMORY_ORDER_RELEASE:
+		return (pboolean) __atomic_compare_exchange_n (PATOMIC_SIZE_CAST ((volatile psize *) atomic),
+							       (psize *) &tmp_pointer,
+							       PPOINTER_TO_PSIZE (newval), 0,
+							       __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+	case P_ATOMIC_MEMORY_ORDER_ACQ_REL:
+		return (pboolean) __atomic_compare_exchange_n (PATOMIC_SIZE_CAST ((volatile psize *) atomic),
+							       (psize *) &tmp_pointer,
+							       PPOINTER_TO_PSIZE (newval), 0,
+							       __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+	default:
+		return (pboolean) __atomic_compare_exchange_n (PATOMIC_SIZE_CAST ((volatile psize *) atomic),
+							       (psize *) &tmp_pointer,
+							       PPOINTER_TO_PSIZE (newval), 0,
+							       __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+	}
+}
+
+#ifdef PATOMIC_INT64_LOCK_FREE
+
+P_LIB_API pint64
+p_atomic_int64_get (const volatile pint64 *atomic)
+{
+	return (pint64) __atomic_load_8 (PATOMIC_INT64_CAST (atomic), __ATOMIC_SEQ_CST);
+}
+
+P_LIB_API void
+p_atomic_int64_set (volatile pint64	*atomic,
+		    pint64		val)
+{
+	__atomic_store_8 (PATOMIC_INT64_CAST (atomic), val, __ATOMIC_SEQ_CST);
+}
+
+P_LIB_API void
+p_atomic_int64_inc (volatile pint64 *atomic)
+{
+	(void) __atomic_fetch_add (atomic, 1, __ATOMIC_SEQ_CST);
+}
+
+P_LIB_API pboolean
+p_atomic_int64_dec_and_test (volatile pint64 *atomic)
+{
+	return (__atomic_fetch_sub (atomic, 1, __ATOMIC_SEQ_CST) == 1) ? TRUE : FALSE;
+}
+
+P_LIB_API pboolean
+p_atomic_int64_compare_and_exchange (volatile pint64	*atomic,
+				     pint64		oldval,
+				     pint64		newval)
+{
+	pint64 tmp_int = oldval;
+
+	return (pboolean) __atomic_compare_exchange_n (PATOMIC_INT64_CAST (atomic),
+						       &tmp_int,
+						       newval,
+						       0,
+						       __ATOMIC_SEQ_CST,
+						       __ATOMIC_SEQ_CST);
+}
+
+P_LIB_API pint64
+p_atomic_int64_add (volatile pint64	*atomic,
+		    pint64		val)
+{
+	return (pint64) __atomic_fetch_add (atomic, val, __ATOMIC_SEQ_CST);
+}
+
+P_LIB_API puint64
+p_atomic_int64_and (volatile puint64	*atomic,
+		    puint64		val)
+{
+	return (puint64) __atomic_fetch_and (atomic, val, __ATOMIC_SEQ_CST);
+}
+
+P_LIB_API puint64
+p_atomic_int64_or (volatile puint64	*atomic,
+		   puint64		val)
+{
+	return (puint64) __atomic_fetch_or (atomic, val, __ATOMIC_SEQ_CST);
+}
+
+P_LIB_API puint64
+p_atomic_int64_xor (volatile puint64	*atomic,
+		    puint64		val)
+{
+	return (puint64) __atomic_fetch_xor (atomic, val, __ATOMIC_SEQ_CST);
+}
+
+P_LIB_API pint64
+p_atomic_int64_get_explicit (const volatile pint64	*atomic,
+			     PAtomicMemoryOrder		order)
+{
+	switch (order) {
+	case P_ATOMIC_MEMORY_ORDER_RELAXED:
+		return (pint64) __atomic_load_8 (PATOMIC_INT64_CAST (atomic), __ATOMIC_RELAXED);
+	case P_ATOMIC_MEMORY_ORDER_ACQUIRE:
+	case P_ATOMIC_MEMORY_ORDER_RELEASE:
+	case P_ATOMIC_MEMORY_ORDER_ACQ_REL:
+		return (pint64) __atomic_load_8 (PATOMIC_INT64_CAST (atomic), __ATOMIC_ACQUIRE);
+	default:
+		return (pint64) __atomic_load_8 (PATOMIC_INT64_CAST (atomic), __ATOMIC_SEQ_CST);
+	}
+}
+
+P_LIB_API void
+p_atomic_int64_set_explicit (volatile pint64	*atomic,
+			     pint64		val,
+			     PAtomicMemoryOrder	order)
+{
+	switch (order) {
+	case P_ATOMIC_MEMORY_ORDER_RELAXED:
+		__atomic_store_8 (PATOMIC_INT64_CAST (atomic), val, __ATOMIC_RELAXED);
+		break;
+	case P_ATOMIC_MEMORY_ORDER_ACQUIRE:
+	case P_ATOMIC_MEMORY_ORDER_RELEASE:
+	case P_ATOMIC_MEMORY_ORDER_ACQ_REL:
+		__atomic_store_8 (PATOMIC_INT64_CAST (atomic), val, __ATOMIC_RELEASE);
+		break;
+	default:
+		__atomic_store_8 (PATOMIC_INT64_CAST (atomic), val, __ATOMIC_SEQ_CST);
+		break;
+	}
+}
+
+P_LIB_API pint64
+p_atomic_int64_add_explicit (volatile pint64	*atomic,
+			     pint64		val,
+			     PAtomicMemoryOrder	order)
+{
+	switch (order) {
+	case P_ATOMIC_MEMORY_ORDER_RELAXED:
+		return (pint64) __atomic_fetch_add (atomic, val, __ATOMIC_RELAXED);
+	case P_ATOMIC_MEMORY_ORDER_ACQUIRE:
+		return (pint64) __atomic_fetch_add (atomic, val, __ATOMIC_ACQUIRE);
+	case P_ATOMIC_MEMORY_ORDER_RELEASE:
+		return (pint64) __atomic_fetch_add (atomic, val, __ATOMIC_RELEASE);
+	case P_ATOMIC_MEMORY_ORDER_ACQ_REL:
+		return (pint64) __atomic_fetch_add (atomic, val, __ATOMIC_ACQ_REL);
+	default:
+		return (pint64) __atomic_fetch_add (atomic, val, __ATOMIC_SEQ_CST);
+	}
+}
+
+P_LIB_API pboolean
+p_atomic_int64_compare_and_exchange_explicit (volatile pint64		*atomic,
+					      pint64			oldval,
+					      pint64			newval,
+					      PAtomicMemoryOrder	order)
+{
+	pint64 tmp_int = oldval;
+
+	switch (order) {
+	case P_ATOMIC_MEMORY_ORDER_RELAXED:
+		return (pboolean) __atomic_compare_exchange_n (PATOMIC_INT64_CAST (atomic), &tmp_int, newval, 0,
+							       __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+	case P_ATOMIC_MEMORY_ORDER_ACQUIRE:
+		return (pboolean) __atomic_compare_exchange_n (PATOMIC_INT64_CAST (atomic), &tmp_int, newval, 0,
+							       __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE);
+	case P_ATOMIC_MEMORY_ORDER_RELEASE:
+		return (pboolean) __atomic_compare_exchange_n (PATOMIC_INT64_CAST (atomic), &tmp_int, newval, 0,
+							       __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+	case P_ATOMIC_MEMORY_ORDER_ACQ_REL:
+		return (pboolean) __atomic_compare_exchange_n (PATOMIC_INT64_CAST (atomic), &tmp_int, newval, 0,
+							       __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+	default:
+		return (pboolean) __atomic_compare_exchange_n (PATOMIC_INT64_CAST (atomic), &tmp_int, newval, 0,
+							       __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+	}
+}
+
+#else /* !PATOMIC_INT64_LOCK_FREE */
+
+/* No 64-bit compare and exchange, guard the 64-bit values with a spin lock */
+static volatile pint pp_atomic_int64_lock = 0;
+
+static void pp_atomic_int64_lock_acquire (void);
+static void pp_atomic_int64_lock_release (void);
+
+static void
+pp_atomic_int64_lock_acquire (void)
+{
+	while (p_atomic_int_compare_and_exchange (&pp_atomic_int64_lock, 0, 1) == FALSE)
+		;
+}
+
+static void
+pp_atomic_int64_lock_release (void)
+{
+	p_atomic_int_set (&pp_atomic_int64_lock, 0);
+}
+
+P_LIB_API pint64
+p_atomic_int64_get (const volatile pint64 *atomic)
+{
+	pint64 value;
+
+	pp_atomic_int64_lock_acquire ();
+	value = *atomic;
+	pp_atomic_int64_lock_release ();
+
+	return value;
+}
+
+P_LIB_API void
+p_atomic_int64_set (volatile pint64	*atomic,
+		    pint64		val)
+{
+	pp_atomic_int64_lock_acquire ();
+	*atomic = val;
+	pp_atomic_int64_lock_release ();
+}
+
+P_LIB_API void
+p_atomic_int64_inc (volatile pint64 *atomic)
+{
+	pp_atomic_int64_lock_acquire ();
+	(*atomic)++;
+	pp_atomic_int64_lock_release ();
+}
+
+P_LIB_API pboolean
+p_atomic_int64_dec_and_test (volatile pint64 *atomic)
+{
+	pboolean is_zero;
+
+	pp_atomic_int64_lock_acquire ();
+	is_zero = --(*atomic) == 0;
+	pp_atomic_int64_lock_release ();
+
+	return is_zero;
+}
+
+P_LIB_API pboolean
+p_atomic_int64_compare_and_exchange (volatile pint64	*atomic,
+				     pint64		oldval,
+				     pint64		newval)
+{
+	pboolean success;
+
+	pp_atomic_int64_lock_acquire ();
+
+	if ((success = (*atomic == oldval)))
+		*atomic = newval;
+
+	pp_atomic_int64_lock_release ();
+
+	return success;
+}
+
+P_LIB_API pint64
+p_atomic_int64_add (volatile pint64	*atomic,
+		    pint64		val)
+{
+	pint64 oldval;
+
+	pp_atomic_int64_lock_acquire ();
+	oldval = *atomic;
+	*atomic = oldval + val;
+	pp_atomic_int64_lock_release ();
+
+	return oldval;
+}
+
+P_LIB_API puint64
+p_atomic_int64_and (volatile puint64	*atomic,
+		    puint64		val)
+{
+	puint64 oldval;
+
+	pp_atomic_int64_lock_acquire ();
+	oldval = *atomic;
+	*atomic = oldval & val;
+	pp_atomic_int64_lock_release ();
+
+	return oldval;
+}
+
+P_LIB_API puint64
+p_atomic_int64_or (volatile puint64	*atomic,
+		   puint64		val)
+{
+	puint64 oldval;
+
+	pp_atomic_int64_lock_acquire ();
+	oldval = *atomic;
+	*atomic = oldval | val;
+	pp_atomic_int64_lock_release ();
+
+	return oldval;
+}
+
+P_LIB_API puint64
+p_atomic_int64_xor (volatile puint64	*atomic,
+		    puint64		val)
+{
+	puint64 oldval;
+
+	pp_atomic_int64_lock_acquire ();
+	oldval = *atomic;
+	*atomic = oldval ^ val;
+	pp_atomic_int64_lock_release ();
+
+	return oldval;
+}
+
+P_LIB_API pint64
+p_atomic_int64_get_explicit (const volatile pint64	*atomic,
+			     PAtomicMemoryOrder		order)
+{
+	P_UNUSED (order);
+
+	return p_atomic_int64_get (atomic);
+}
+
+P_LIB_API void
+p_atomic_int64_set_explicit (volatile pint64	*atomic,
+			     pint64		val,
+			     PAtomicMemoryOrder	order)
+{
+	P_UNUSED (order);
+
+	p_atomic_int64_set (atomic, val);
+}
+
+P_LIB_API pint64
+p_atomic_int64_add_explicit (volatile pint64	*atomic,
+			     pint64		val,
+			     PAtomicMemoryOrder	order)
+{
+	P_UNUSED (order);
+
+	return p_atomic_int64_add (atomic, val);
+}
+
+P_LIB_API pboolean
+p_atomic_int64_compare_and_exchange_explicit (volatile pint64		*atomic,
+					      pint64			oldval,
+					      pint64			newval,
+					      PAtomicMemoryOrder	order)
+{
+	P_UNUSED (order);
+
+	return p_atomic_int64_compare_and_exchange (atomic, oldval, newval);
+}
+
+#endif /* PATOMIC_INT64_LOCK_FREE */
+
+P_LIB_API void
+p_atomic_memory_barrier (void)
+{
+	__atomic_thread_fence (__ATOMIC_SEQ_CST);
+}
+
+P_LIB_API void
+p_atomic_thread_fence (PAtomicMemoryOrder order)
+{
+	switch (order) {
+	case P_ATOMIC_MEMORY_ORDER_RELAXED:
+		break;
+	case P_ATOMIC_MEMORY_ORDER_ACQUIRE:
+		__atomic_thread_fence (__ATOMIC_ACQUIRE);
+		break;
+	case P_ATOMIC_MEMORY_ORDER_RELEASE:
+		__atomic_thread_fence (__ATOMIC_RELEASE);
+		break;
+	case P_ATOMIC_MEMORY_ORDER_ACQ_REL:
+		__atomic_thread_fence (__ATOMIC_ACQ_REL);
+		break;
+	default:
+		__atomic_thread_fence (__ATOMIC_SEQ_CST);
+		break;
+	}
+}
+
+P_LIB_API void
+p_atomic_signal_fence (PAtomicMemoryOrder order)
+{
+	switch (order) {
+	case P_ATOMIC_MEMORY_ORDER_RELAXED:
+		break;
+	case P_ATOMIC_MEMORY_ORDER_ACQUIRE:
+		__atomic_signal_fence (__ATOMIC_ACQUIRE);
+		break;
+	case P_ATOMIC_MEMORY_ORDER_RELEASE:
+		__atomic_signal_fence (__ATOMIC_RELEASE);
+		break;
+	case P_ATOMIC_MEMORY_ORDER_ACQ_REL:
+		__atomic_signal_fence (__ATOMIC_ACQ_REL);
+		break;
+	default:
+		__atomic_signal_fence (__ATOMIC_SEQ_CST);
+		break;
+	}
+}
+
 P_LIB_API pboolean
 p_atomic_is_lock_free (void)
 {
 	return TRUE;
 }
 
+P_LIB_API pboolean
+p_atomic_int64_is_lock_free (void)
+{
+#ifdef PATOMIC_INT64_LOCK_FREE
+	return TRUE;
+#else
+	return FALSE;
+#endif
+}
+
 void
 p_atomic_thread_init (void)
 {
@@ -157,6 +157,50 @@ p_atomic_int_xor (volatile puint	*atomic,
 	return i;
 }
 
+P_LIB_API pint
+p_atomic_int_get_explicit (const volatile pint	*atomic,
+			   PAtomicMemoryOrder	order)
+{
+	if (order == P_ATOMIC_MEMORY_ORDER_RELAXED)
+		return *atomic;
+
+	return p_atomic_int_get (atomic);
+}
+
+P_LIB_API void
+p_atomic_int_set_explicit (volatile pint	*atomic,
+			   pint			val,
+			   PAtomicMemoryOrder	order)
+{
+	if (order == P_ATOMIC_MEMORY_ORDER_RELAXED) {
+		*atomic = val;
+		return;
+	}
+
+	p_atomic_int_set (atomic, val);
+}
+
+P_LIB_API pint
+p_atomic_int_add_explicit (volatile pint	*atomic,
+			   pint			val,
+			   PAtomicMemoryOrder	order)
+{
+	P_UNUSED (order);
+
+	return p_atomic_int_add (atomic, val);
+}
+
+P_LIB_API pboolean
+p_atomic_int_compare_and_exchange_explicit (volatile pint	*atomic,
+					    pint		oldval,
+					    pint		newval,
+					    PAtomicMemoryOrder	order)
+{
+	P_UNUSED (order);
+
+	return p_atomic_int_compare_and_exchange (atomic, oldval, newval);
+}
+
 P_LIB_API ppointer
 p_atomic_pointer_get (const volatile void *atomic)
 {
@@ -269,12 +313,229 @@ p_atomic_pointer_xor (volatile void	*atomic,
 	return (psize) i;
 }
 
+P_LIB_API ppointer
+p_atomic_pointer_get_explicit (const volatile void	*atomic,
+			       PAtomicMemoryOrder	order)
+{
+	if (order == P_ATOMIC_MEMORY_ORDER_RELAXED)
+		return (ppointer) *((const volatile psize *) atomic);
+
+	return p_atomic_pointer_get (atomic);
+}
+
+P_LIB_API void
+p_atomic_pointer_set_explicit (volatile void		*atomic,
+			       ppointer			val,
+			       PAtomicMemoryOrder	order)
+{
+	if (order == P_ATOMIC_MEMORY_ORDER_RELAXED) {
+		*((volatile psize *) atomic) = (psize) val;
+		return;
+	}
+
+	p_atomic_pointer_set (atomic, val);
+}
+
+P_LIB_API pssize
+p_atomic_pointer_add_explicit (volatile void		*atomic,
+			       pssize			val,
+			       PAtomicMemoryOrder	order)
+{
+	P_UNUSED (order);
+
+	return p_atomic_pointer_add (atomic, val);
+}
+
+P_LIB_API pboolean
+p_atomic_pointer_compare_and_exchange_explicit (volatile void		*atomic,
+						ppointer		oldval,
+						ppointer		newval,
+						PAtomicMemoryOrder	order)
+{
+	P_UNUSED (order);
+
+	return p_atomic_pointer_compare_and_exchange (atomic, oldval, newval);
+}
+
+P_LIB_API pint64
+p_atomic_int64_get (const volatile pint64 *atomic)
+{
+	__MB ();
+	return *atomic;
+}
+
+P_LIB_API void
+p_atomic_int64_set (volatile pint64	*atomic,
+		    pint64		val)
+{
+	(void) __ATOMIC_EXCH_QUAD ((volatile void *) atomic, val);
+	__MB ();
+}
+
+P_LIB_API void
+p_atomic_int64_inc (volatile pint64 *atomic)
+{
+	__MB ();
+	(void) __ATOMIC_INCREMENT_QUAD ((volatile void *) atomic);
+	__MB ();
+}
+
+P_LIB_API pboolean
+p_atomic_int64_dec_and_test (volatile pint64 *atomic)
+{
+	pboolean result;
+
+	__MB ();
+	result = __ATOMIC_DECREMENT_QUAD ((volatile void *) atomic) == 1 ? TRUE : FALSE;
+	__MB ();
+
+	return result;
+}
+
+P_LIB_API pboolean
+p_atomic_int64_compare_and_exchange (volatile pint64	*atomic,
+				     pint64		oldval,
+				     pint64		newval)
+{
+	pboolean result;
+
+	__MB ();
+	result = PATOMIC_DECC_CAS_QUAD (atomic, oldval, newval, atomic) == 1 ? TRUE : FALSE;
+	__MB ();
+
+	return result;
+}
+
+P_LIB_API pint64
+p_atomic_int64_add (volatile pint64	*atomic,
+		    pint64		val)
+{
+	pint64 result;
+
+	__MB ();
+	result = __ATOMIC_ADD_QUAD ((volatile void *) atomic, val);
+	__MB ();
+
+	return result;
+}
+
+P_LIB_API puint64
+p_atomic_int64_and (volatile puint64	*atomic,
+		    puint64		val)
+{
+	puint64 result;
+
+	__MB ();
+	result = (puint64) __ATOMIC_AND_QUAD ((volatile void *) atomic, (pint64) val);
+	__MB ();
+
+	return result;
+}
+
+P_LIB_API puint64
+p_atomic_int64_or (volatile puint64	*atomic,
+		   puint64		val)
+{
+	puint64 result;
+
+	__MB ();
+	result = (puint64) __ATOMIC_OR_QUAD ((volatile void *) atomic, (pint64) val);
+	__MB ();
+
+	return result;
+}
+
+P_LIB_API puint64
+p_atomic_int64_xor (volatile puint64	*atomic,
+		    puint64		val)
+{
+	pint64 i;
+
+	do {
+		__MB ();
+		i = (pint64) (*atomic);
+	} while (PATOMIC_DECC_CAS_QUAD (atomic, i, i ^ ((pint64) val), atomic) != 1);
+
+	__MB ();
+
+	return (puint64) i;
+}
+
+P_LIB_API pint64
+p_atomic_int64_get_explicit (const volatile pint64	*atomic,
+			     PAtomicMemoryOrder		order)
+{
+	if (order == P_ATOMIC_MEMORY_ORDER_RELAXED)
+		return *atomic;
+
+	return p_atomic_int64_get (atomic);
+}
+
+P_LIB_API void
+p_atomic_int64_set_explicit (volatile pint64	*atomic,
+			     pint64		val,
+			     PAtomicMemoryOrder	order)
+{
+	if (order == P_ATOMIC_MEMORY_ORDER_RELAXED) {
+		*atomic = val;
+		return;
+	}
+
+	p_atomic_int64_set (atomic, val);
+}
+
+P_LIB_API pint64
+p_atomic_int64_add_explicit (volatile pint64	*atomic,
+			     pint64		val,
+			     PAtomicMemoryOrder	order)
+{
+	P_UNUSED (order);
+
+	return p_atomic_int64_add (atomic, val);
+}
+
+P_LIB_API pboolean
+p_atomic_int64_compare_and_exchange_explicit (volatile pint64		*atomic,
+					      pint64			oldval,
+					      pint64			newval,
+					      PAtomicMemoryOrder	order)
+{
+	P_UNUSED (order);
+
+	return p_atomic_int64_compare_and_exchange (atomic, oldval, newval);
+}
+
+P_LIB_API void
+p_atomic_memory_barrier (void)
+{
+	__MB ();
+}
+
+P_LIB_API void
+p_atomic_thread_fence (PAtomicMemoryOrder order)
+{
+	if (order != P_ATOMIC_MEMORY_ORDER_RELAXED)
+		p_atomic_memory_barrier ();
+}
+
+P_LIB_API void
+p_atomic_signal_fence (PAtomicMemoryOrder order)
+{
+	p_atomic_thread_fence (order);
+}
+
 P_LIB_API pboolean
 p_atomic_is_lock_free (void)
 {
 	return TRUE;
 }
 
+P_LIB_API pboolean
+p_atomic_int64_is_lock_free (void)
+{
+	return TRUE;
+}
+
 void
 p_atomic_thread_init (void)
 {
@@ -0,0 +1,524 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file patomic-inline.h
+ * @brief Inline atomic operations
+ * @author Alexander Saprykin
+ *
+ * The atomic operations from patomic.h are exported library functions, so
+ * every p_atomic_int_inc() costs a call, which is larger than the atomic
+ * instruction itself on hot counters. Define P_ATOMIC_INLINE before including
+ * plibsys.h (or pass it to the compiler) to replace the most used operations
+ * with inline functions, so they compile to single instructions at the call
+ * site:
+ * - p_atomic_int_get(), p_atomic_int_set(), p_atomic_int_inc(),
+ * p_atomic_int_dec_and_test(), p_atomic_int_compare_and_exchange(),
+ * p_atomic_int_add(), p_atomic_int_and(), p_atomic_int_or(),
+ * p_atomic_int_xor();
+ * - p_atomic_pointer_get(), p_atomic_pointer_set(),
+ * p_atomic_pointer_compare_and_exchange(), p_atomic_pointer_add();
+ * - with the c11 atomic model also p_atomic_int_get_explicit(),
+ * p_atomic_int_set_explicit(), p_atomic_int_add_explicit(),
+ * p_atomic_pointer_get_explicit() and p_atomic_pointer_set_explicit().
+ *
+ * The replacement is made with function-like macros, so taking an address of
+ * an operation still gives the exported function, and the library ABI doesn't
+ * change. Inline and exported operations can be freely mixed on the same
+ * variables. The other operations (including the #pint64 ones) are always
+ * called out-of-line.
+ *
+ * Inlining is used only when the compiler supports the same kind of lock-free
+ * intrinsics which the library was built with (GCC-compatible __atomic or
+ * __sync builtins, MSVC Interlocked functions). With the simulated atomic
+ * model P_ATOMIC_INLINE has no effect, because the operations must take the
+ * library lock. Check #P_ATOMIC_INLINE_ENABLED to know whether the inline
+ * operations are in use.
+ *
+ * The header is included by patomic.h automatically, don't include it
+ * directly.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PATOMIC_INLINE_H
+#define PLIBSYS_HEADER_PATOMIC_INLINE_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+
+#if defined (PLIBSYS_ATOMIC_C11) && defined (__ATOMIC_SEQ_CST)
+#  define P_ATOMIC_INLINE_C11
+#elif (defined (PLIBSYS_ATOMIC_C11) || defined (PLIBSYS_ATOMIC_SYNC)) && \
+      defined (P_CC_GNU) && !defined (P_CC_CRAY)
+#  define P_ATOMIC_INLINE_SYNC
+#elif defined (PLIBSYS_ATOMIC_WIN) && defined (P_CC_MSVC)
+#  define P_ATOMIC_INLINE_WIN
+#endif
+
+#if defined (P_ATOMIC_INLINE_C11) || defined (P_ATOMIC_INLINE_SYNC) || defined (P_ATOMIC_INLINE_WIN)
+/** Defined when the inline atomic operations are in use. */
+#  define P_ATOMIC_INLINE_ENABLED
+#endif
+
+#ifdef P_ATOMIC_INLINE_ENABLED
+
+#if defined (__cplusplus)
+#  define P_ATOMIC_INLINE_FUNC static inline
+#elif defined (P_CC_MSVC)
+#  define P_ATOMIC_INLINE_FUNC static __inline
+#else
+#  define P_ATOMIC_INLINE_FUNC static __inline__
+#endif
+
+#ifdef P_ATOMIC_INLINE_C11
+
+P_ATOMIC_INLINE_FUNC pint
+p_atomic_inline_int_get (const volatile pint *atomic)
+{
+	return __atomic_load_n (atomic, __ATOMIC_SEQ_CST);
+}
+
+P_ATOMIC_INLINE_FUNC void
+p_atomic_inline_int_set (volatile pint	*atomic,
+			 pint		val)
+{
+	__atomic_store_n (atomic, val, __ATOMIC_SEQ_CST);
+}
+
+P_ATOMIC_INLINE_FUNC void
+p_atomic_inline_int_inc (volatile pint *atomic)
+{
+	(void) __atomic_fetch_add (atomic, 1, __ATOMIC_SEQ_CST);
+}
+
+P_ATOMIC_INLINE_FUNC pboolean
+p_atomic_inline_int_dec_and_test (volatile pint *atomic)
+{
+	return (__atomic_fetch_sub (atomic, 1, __ATOMIC_SEQ_CST) == 1) ? TRUE : FALSE;
+}
+
+P_ATOMIC_INLINE_FUNC pboolean
+p_atomic_inline_int_compare_and_exchange (volatile pint	*atomic,
+					  pint		oldval,
+					  pint		newval)
+{
+	return (pboolean) __atomic_compare_exchange_n (atomic,
+						       &oldval,
+						       newval,
+						       0,
+						       __ATOMIC_SEQ_CST,
+						       __ATOMIC_SEQ_CST);
+}
+
+P_ATOMIC_INLINE_FUNC pint
+p_atomic_inline_int_add (volatile pint	*atomic,
+			 pint		val)
+{
+	return __atomic_fetch_add (atomic, val, __ATOMIC_SEQ_CST);
+}
+
+P_ATOMIC_INLINE_FUNC puint
+p_atomic_inline_int_and (volatile puint	*atomic,
+			 puint			val)
+{
+	return __atomic_fetch_and (atomic, val, __ATOMIC_SEQ_CST);
+}
+
+P_ATOMIC_INLINE_FUNC puint
+p_atomic_inline_int_or (volatile puint	*atomic,
+			puint		val)
+{
+	return __atomic_fetch_or (atomic, val, __ATOMIC_SEQ_CST);
+}
+
+P_ATOMIC_INLINE_FUNC puint
+p_atomic_inline_int_xor (volatile puint	*atomic,
+			 puint			val)
+{
+	return __atomic_fetch_xor (atomic, val, __ATOMIC_SEQ_CST);
+}
+
+P_ATOMIC_INLINE_FUNC ppointer
+p_atomic_inline_pointer_get (const volatile void *atomic)
+{
+	return (ppointer) __atomic_load_n ((const volatile psize *) atomic, __ATOMIC_SEQ_CST);
+}
+
+P_ATOMIC_INLINE_FUNC void
+p_atomic_inline_pointer_set (volatile void	*atomic,
+			     ppointer		val)
+{
+	__atomic_store_n ((volatile psize *) atomic, (psize) val, __ATOMIC_SEQ_CST);
+}
+
+P_ATOMIC_INLINE_FUNC pboolean
+p_atomic_inline_pointer_compare_and_exchange (volatile void	*atomic,
+					      ppointer		oldval,
+					      ppointer		newval)
+{
+	psize tmp_val = (psize) oldval;
+
+	return (pboolean) __atomic_compare_exchange_n ((volatile psize *) atomic,
+						       &tmp_val,
+						       (psize) newval,
+						       0,
+						       __ATOMIC_SEQ_CST,
+						       __ATOMIC_SEQ_CST);
+}
+
+P_ATOMIC_INLINE_FUNC pssize
+p_atomic_inline_pointer_add (volatile void	*atomic,
+			     pssize		val)
+{
+	return __atomic_fetch_add ((volatile pssize *) atomic, val, __ATOMIC_SEQ_CST);
+}
+
+/* With a constant order the switch folds into a single instruction */
+
+P_ATOMIC_INLINE_FUNC pint
+p_atomic_inline_int_get_explicit (const volatile pint	*atomic,
+				  PAtomicMemoryOrder	order)
+{
+	switch (order) {
+	case P_ATOMIC_MEMORY_ORDER_RELAXED:
+		return __atomic_load_n (atomic, __ATOMIC_RELAXED);
+	case P_ATOMIC_MEMORY_ORDER_ACQUIRE:
+	case P_ATOMIC_MEMORY_ORDER_RELEASE:
+	case P_ATOMIC_MEMORY_ORDER_ACQ_REL:
+		return __atomic_load_n (atomic, __ATOMIC_ACQUIRE);
+	default:
+		return __atomic_load_n (atomic, __ATOMIC_SEQ_CST);
+	}
+}
+
+P_ATOMIC_INLINE_FUNC void
+p_atomic_inline_int_set_explicit (volatile pint		*atomic,
+				  pint			val,
+				  PAtomicMemoryOrder	order)
+{
+	switch (order) {
+	case P_ATOMIC_MEMORY_ORDER_RELAXED:
+		__atomic_store_n (atomic, val, __ATOMIC_RELAXED);
+		break;
+	case P_ATOMIC_MEMORY_ORDER_ACQUIRE:
+	case P_ATOMIC_MEMORY_ORDER_RELEASE:
+	case P_ATOMIC_MEMORY_ORDER_ACQ_REL:
+		__atomic_store_n (atomic, val, __ATOMIC_RELEASE);
+		break;
+	default:
+		__atomic_store_n (atomic, val, __ATOMIC_SEQ_CST);
+		break;
+	}
+}
+
+P_ATOMIC_INLINE_FUNC pint
+p_atomic_inline_int_add_explicit (volatile pint		*atomic,
+				  pint			val,
+				  PAtomicMemoryOrder	order)
+{
+	switch (order) {
+	case P_ATOMIC_MEMORY_ORDER_RELAXED:
+		return __atomic_fetch_add (atomic, val, __ATOMIC_RELAXED);
+	case P_ATOMIC_MEMORY_ORDER_ACQUIRE:
+		return __atomic_fetch_add (atomic, val, __ATOMIC_ACQUIRE);
+	case P_ATOMIC_MEMORY_ORDER_RELEASE:
+		return __atomic_fetch_add (atomic, val, __ATOMIC_RELEASE);
+	case P_ATOMIC_MEMORY_ORDER_ACQ_REL:
+		return __atomic_fetch_add (atomic, val, __ATOMIC_ACQ_REL);
+	default:
+		return __atomic_fetch_add (atomic, val, __ATOMIC_SEQ_CST);
+	}
+}
+
+P_ATOMIC_INLINE_FUNC ppointer
+p_atomic_inline_pointer_get_explicit (const volatile void	*atomic,
+				      PAtomicMemoryOrder	order)
+{
+	const volatile psize *ptr = (const volatile psize *) atomic;
+
+	switch (order) {
+	case P_ATOMIC_MEMORY_ORDER_RELAXED:
+		return (ppointer) __atomic_load_n (ptr, __ATOMIC_RELAXED);
+	case P_ATOMIC_MEMORY_ORDER_ACQUIRE:
+	case P_ATOMIC_MEMORY_ORDER_RELEASE:
+	case P_ATOMIC_MEMORY_ORDER_ACQ_REL:
+		return (ppointer) __atomic_load_n (ptr, __ATOMIC_ACQUIRE);
+	default:
+		return (ppointer) __atomic_load_n (ptr, __ATOMIC_SEQ_CST);
+	}
+}
+
+P_ATOMIC_INLINE_FUNC void
+p_atomic_inline_pointer_set_explicit (volatile void		*atomic,
+				      ppointer			val,
+				      PAtomicMemoryOrder	order)
+{
+	volatile psize *ptr = (volatile psize *) atomic;
+
+	switch (order) {
+	case P_ATOMIC_MEMORY_ORDER_RELAXED:
+		__atomic_store_n (ptr, (psize) val, __ATOMIC_RELAXED);
+		break;
+	case P_ATOMIC_MEMORY_ORDER_ACQUIRE:
+	case P_ATOMIC_MEMORY_ORDER_RELEASE:
+	case P_ATOMIC_MEMORY_ORDER_ACQ_REL:
+		__atomic_store_n (ptr, (psize) val, __ATOMIC_RELEASE);
+		break;
+	default:
+		__atomic_store_n (ptr, (psize) val, __ATOMIC_SEQ_CST);
+		break;
+	}
+}
+
+#  define p_atomic_int_get_explicit(atomic, order)		p_atomic_inline_int_get_explicit (atomic, order)
+#  define p_atomic_int_set_explicit(atomic, val, order)		p_atomic_inline_int_set_explicit (atomic, val, order)
+#  define p_atomic_int_add_explicit(atomic, val, order)		p_atomic_inline_int_add_explicit (atomic, val, order)
+#  define p_atomic_pointer_get_explicit(atomic, order)		p_atomic_inline_pointer_get_explicit (atomic, order)
+#  define p_atomic_pointer_set_explicit(atomic, val, order)	p_atomic_inline_pointer_set_explicit (atomic, val, order)
+
+#elif defined (P_ATOMIC_INLINE_SYNC)
+
+P_ATOMIC_INLINE_FUNC pint
+p_atomic_inline_int_get (const volatile pint *atomic)
+{
+	__sync_synchronize ();
+	return *atomic;
+}
+
+P_ATOMIC_INLINE_FUNC void
+p_atomic_inline_int_set (volatile pint	*atomic,
+			 pint		val)
+{
+	*atomic = val;
+	__sync_synchronize ();
+}
+
+P_ATOMIC_INLINE_FUNC void
+p_atomic_inline_int_inc (volatile pint *atomic)
+{
+	(void) __sync_fetch_and_add (atomic, 1);
+}
+
+P_ATOMIC_INLINE_FUNC pboolean
+p_atomic_inline_int_dec_and_test (volatile pint *atomic)
+{
+	return __sync_fetch_and_sub (atomic, 1) == 1 ? TRUE : FALSE;
+}
+
+P_ATOMIC_INLINE_FUNC pboolean
+p_atomic_inline_int_compare_and_exchange (volatile pint	*atomic,
+					  pint		oldval,
+					  pint		newval)
+{
+	return (pboolean) __sync_bool_compare_and_swap (atomic, oldval, newval);
+}
+
+P_ATOMIC_INLINE_FUNC pint
+p_atomic_inline_int_add (volatile pint	*atomic,
+			 pint		val)
+{
+	return __sync_fetch_and_add (atomic, val);
+}
+
+P_ATOMIC_INLINE_FUNC puint
+p_atomic_inline_int_and (volatile puint	*atomic,
+			 puint			val)
+{
+	return __sync_fetch_and_and (atomic, val);
+}
+
+P_ATOMIC_INLINE_FUNC puint
+p_atomic_inline_int_or (volatile puint	*atomic,
+			puint		val)
+{
+	return __sync_fetch_and_or (atomic, val);
+}
+
+P_ATOMIC_INLINE_FUNC puint
+p_atomic_inline_int_xor (volatile puint	*atomic,
+			 puint			val)
+{
+	return __sync_fetch_and_xor (atomic, val);
+}
+
+P_ATOMIC_INLINE_FUNC ppointer
+p_atomic_inline_pointer_get (const volatile void *atomic)
+{
+	__sync_synchronize ();
+	return (ppointer) *((const volatile psize *) atomic);
+}
+
+P_ATOMIC_INLINE_FUNC void
+p_atomic_inline_pointer_set (volatile void	*atomic,
+			     ppointer		val)
+{
+	*((volatile psize *) atomic) = (psize) val;
+	__sync_synchronize ();
+}
+
+P_ATOMIC_INLINE_FUNC pboolean
+p_atomic_inline_pointer_compare_and_exchange (volatile void	*atomic,
+					      ppointer		oldval,
+					      ppointer		newval)
+{
+	return (pboolean) __sync_bool_compare_and_swap ((volatile psize *) atomic,
+							(psize) oldval,
+							(psize) newval);
+}
+
+P_ATOMIC_INLINE_FUNC pssize
+p_atomic_inline_pointer_add (volatile void	*atomic,
+			     pssize		val)
+{
+	return __sync_fetch_and_add ((volatile pssize *) atomic, val);
+}
+
+#elif defined (P_ATOMIC_INLINE_WIN)
+
+#include <intrin.h>
+
+P_ATOMIC_INLINE_FUNC pint
+p_atomic_inline_int_get (const volatile pint *atomic)
+{
+	MemoryBarrier ();
+	return *atomic;
+}
+
+P_ATOMIC_INLINE_FUNC void
+p_atomic_inline_int_set (volatile pint	*atomic,
+			 pint		val)
+{
+	*atomic = val;
+	MemoryBarrier ();
+}
+
+P_ATOMIC_INLINE_FUNC void
+p_atomic_inline_int_inc (volatile pint *atomic)
+{
+	InterlockedIncrement ((LONG volatile *) atomic);
+}
+
+P_ATOMIC_INLINE_FUNC pboolean
+p_atomic_inline_int_dec_and_test (volatile pint *atomic)
+{
+	return InterlockedDecrement ((LONG volatile *) atomic) == 0 ? TRUE : FALSE;
+}
+
+P_ATOMIC_INLINE_FUNC pboolean
+p_atomic_inline_int_compare_and_exchange (volatile pint	*atomic,
+					  pint		oldval,
+					  pint		newval)
+{
+	return InterlockedCompareExchange ((LONG volatile *) atomic,
+					   (LONG) newval,
+					   (LONG) oldval) == oldval ? TRUE : FALSE;
+}
+
+P_ATOMIC_INLINE_FUNC pint
+p_atomic_inline_int_add (volatile pint	*atomic,
+			 pint		val)
+{
+	return (pint) InterlockedExchangeAdd ((LONG volatile *) atomic, (LONG) val);
+}
+
+P_ATOMIC_INLINE_FUNC puint
+p_atomic_inline_int_and (volatile puint	*atomic,
+			 puint			val)
+{
+	return (puint) _InterlockedAnd ((LONG volatile *) atomic, (LONG) val);
+}
+
+P_ATOMIC_INLINE_FUNC puint
+p_atomic_inline_int_or (volatile puint	*atomic,
+			puint		val)
+{
+	return (puint) _InterlockedOr ((LONG volatile *) atomic, (LONG) val);
+}
+
+P_ATOMIC_INLINE_FUNC puint
+p_atomic_inline_int_xor (volatile puint	*atomic,
+			 puint			val)
+{
+	return (puint) _InterlockedXor ((LONG volatile *) atomic, (LONG) val);
+}
+
+P_ATOMIC_INLINE_FUNC ppointer
+p_atomic_inline_pointer_get (const volatile void *atomic)
+{
+	MemoryBarrier ();
+	return *((const volatile ppointer *) atomic);
+}
+
+P_ATOMIC_INLINE_FUNC void
+p_atomic_inline_pointer_set (volatile void	*atomic,
+			     ppointer		val)
+{
+	*((volatile ppointer *) atomic) = val;
+	MemoryBarrier ();
+}
+
+P_ATOMIC_INLINE_FUNC pboolean
+p_atomic_inline_pointer_compare_and_exchange (volatile void	*atomic,
+					      ppointer		oldval,
+					      ppointer		newval)
+{
+	return InterlockedCompareExchangePointer ((volatile PVOID *) atomic,
+						  (PVOID) newval,
+						  (PVOID) oldval) == oldval ? TRUE : FALSE;
+}
+
+P_ATOMIC_INLINE_FUNC pssize
+p_atomic_inline_pointer_add (volatile void	*atomic,
+			     pssize		val)
+{
+#  if (PLIBSYS_SIZEOF_VOID_P == 8)
+	return (pssize) InterlockedExchangeAdd64 ((LONGLONG volatile *) atomic, (LONGLONG) val);
+#  else
+	return (pssize) InterlockedExchangeAdd ((LONG volatile *) atomic, (LONG) val);
+#  endif
+}
+
+#endif /* P_ATOMIC_INLINE_WIN */
+
+#define p_atomic_int_get(atomic)					p_atomic_inline_int_get (atomic)
+#define p_atomic_int_set(atomic, val)					p_atomic_inline_int_set (atomic, val)
+#define p_atomic_int_inc(atomic)					p_atomic_inline_int_inc (atomic)
+#define p_atomic_int_dec_and_test(atomic)				p_atomic_inline_int_dec_and_test (atomic)
+#define p_atomic_int_compare_and_exchange(atomic, oldval, newval)	p_atomic_inline_int_compare_and_exchange (atomic, oldval, newval)
+#define p_atomic_int_add(atomic, val)					p_atomic_inline_int_add (atomic, val)
+#define p_atomic_int_and(atomic, val)					p_atomic_inline_int_and (atomic, val)
+#define p_atomic_int_or(atomic, val)					p_atomic_inline_int_or (atomic, val)
+#define p_atomic_int_xor(atomic, val)					p_atomic_inline_int_xor (atomic, val)
+#define p_atomic_pointer_get(atomic)					p_atomic_inline_pointer_get (atomic)
+#define p_atomic_pointer_set(atomic, val)				p_atomic_inline_pointer_set (atomic, val)
+#define p_atomic_pointer_compare_and_exchange(atomic, oldval, newval)	p_atomic_inline_pointer_compare_and_exchange (atomic, oldval, newval)
+#define p_atomic_pointer_add(atomic, val)				p_atomic_inline_pointer_add (atomic, val)
+
+#endif /* P_ATOMIC_INLINE_ENABLED */
+
+#endif /* PLIBSYS_HEADER_PATOMIC_INLINE_H */
@@ -143,6 +143,46 @@ p_atomic_int_xor (volatile puint	*atomic,
 	return oldval;
 }
 
+P_LIB_API pint
+p_atomic_int_get_explicit (const volatile pint	*atomic,
+			   PAtomicMemoryOrder	order)
+{
+	P_UNUSED (order);
+
+	return p_atomic_int_get (atomic);
+}
+
+P_LIB_API void
+p_atomic_int_set_explicit (volatile pint	*atomic,
+			   pint			val,
+			   PAtomicMemoryOrder	order)
+{
+	P_UNUSED (order);
+
+	p_atomic_int_set (atomic, val);
+}
+
+P_LIB_API pint
+p_atomic_int_add_explicit (volatile pint	*atomic,
+			   pint			val,
+			   PAtomicMemoryOrder	order)
+{
+	P_UNUSED (order);
+
+	return p_atomic_int_add (atomic, val);
+}
+
+P_LIB_API pboolean
+p_atomic_int_compare_and_exchange_explicit (volatile pint	*atomic,
+					    pint		oldval,
+					    pint		newval,
+					    PAtomicMemoryOrder	order)
+{
+	P_UNUSED (order);
+
+	return p_atomic_int_compare_and_exchange (atomic, oldval, newval);
+}
+
 P_LIB_API ppointer
 p_atomic_pointer_get (const volatile void *atomic)
 {
@@ -245,12 +285,232 @@ p_atomic_pointer_xor (volatile void	*atomic,
 	return oldval;
 }
 
+P_LIB_API ppointer
+p_atomic_pointer_get_explicit (const volatile void	*atomic,
+			       PAtomicMemoryOrder	order)
+{
+	P_UNUSED (order);
+
+	return p_atomic_pointer_get (atomic);
+}
+
+P_LIB_API void
+p_atomic_pointer_set_explicit (volatile void		*atomic,
+			       ppointer			val,
+			       PAtomicMemoryOrder	order)
+{
+	P_UNUSED (order);
+
+	p_atomic_pointer_set (atomic, val);
+}
+
+P_LIB_API pssize
+p_atomic_pointer_add_explicit (volatile void		*atomic,
+			       pssize			val,
+			       PAtomicMemoryOrder	order)
+{
+	P_UNUSED (order);
+
+	return p_atomic_pointer_add (atomic, val);
+}
+
+P_LIB_API pboolean
+p_atomic_pointer_compare_and_exchange_explicit (volatile void		*atomic,
+						ppointer		oldval,
+						ppointer		newval,
+						PAtomicMemoryOrder	order)
+{
+	P_UNUSED (order);
+
+	return p_atomic_pointer_compare_and_exchange (atomic, oldval, newval);
+}
+
+P_LIB_API pint64
+p_atomic_int64_get (const volatile pint64 *atomic)
+{
+	pint64 value;
+
+	p_mutex_lock (pp_atomic_mutex);
+	value = *atomic;
+	p_mutex_unlock (pp_atomic_mutex);
+
+	return value;
+}
+
+P_LIB_API void
+p_atomic_int64_set (volatile pint64	*atomic,
+		    pint64		val)
+{
+	p_mutex_lock (pp_atomic_mutex);
+	*atomic = val;
+	p_mutex_unlock (pp_atomic_mutex);
+}
+
+P_LIB_API void
+p_atomic_int64_inc (volatile pint64 *atomic)
+{
+	p_mutex_lock (pp_atomic_mutex);
+	(*atomic)++;
+	p_mutex_unlock (pp_atomic_mutex);
+}
+
+P_LIB_API pboolean
+p_atomic_int64_dec_and_test (volatile pint64 *atomic)
+{
+	pboolean is_zero;
+
+	p_mutex_lock (pp_atomic_mutex);
+	is_zero = --(*atomic) == 0;
+	p_mutex_unlock (pp_atomic_mutex);
+
+	return is_zero;
+}
+
+P_LIB_API pboolean
+p_atomic_int64_compare_and_exchange (volatile pint64	*atomic,
+				     pint64		oldval,
+				     pint64		newval)
+{
+	pboolean success;
+
+	p_mutex_lock (pp_atomic_mutex);
+
+	if ((success = (*atomic == oldval)))
+		*atomic = newval;
+
+	p_mutex_unlock (pp_atomic_mutex);
+
+	return success;
+}
+
+P_LIB_API pint64
+p_atomic_int64_add (volatile pint64	*atomic,
+		    pint64		val)
+{
+	pint64 oldval;
+
+	p_mutex_lock (pp_atomic_mutex);
+	oldval = *atomic;
+	*atomic = oldval + val;
+	p_mutex_unlock (pp_atomic_mutex);
+
+	return oldval;
+}
+
+P_LIB_API puint64
+p_atomic_int64_and (volatile puint64	*atomic,
+		    puint64		val)
+{
+	puint64 oldval;
+
+	p_mutex_lock (pp_atomic_mutex);
+	oldval = *atomic;
+	*atomic = oldval & val;
+	p_mutex_unlock (pp_atomic_mutex);
+
+	return oldval;
+}
+
+P_LIB_API puint64
+p_atomic_int64_or (volatile puint64	*atomic,
+		   puint64		val)
+{
+	puint64 oldval;
+
+	p_mutex_lock (pp_atomic_mutex);
+	oldval = *atomic;
+	*atomic = oldval | val;
+	p_mutex_unlock (pp_atomic_mutex);
+
+	return oldval;
+}
+
+P_LIB_API puint64
+p_atomic_int64_xor (volatile puint64	*atomic,
+		    puint64		val)
+{
+	puint64 oldval;
+
+	p_mutex_lock (pp_atomic_mutex);
+	oldval = *atomic;
+	*atomic = oldval ^ val;
+	p_mutex_unlock (pp_atomic_mutex);
+
+	return oldval;
+}
+
+P_LIB_API pint64
+p_atomic_int64_get_explicit (const volatile pint64	*atomic,
+			     PAtomicMemoryOrder		order)
+{
+	P_UNUSED (order);
+
+	return p_atomic_int64_get (atomic);
+}
+
+P_LIB_API void
+p_atomic_int64_set_explicit (volatile pint64	*atomic,
+			     pint64		val,
+			     PAtomicMemoryOrder	order)
+{
+	P_UNUSED (order);
+
+	p_atomic_int64_set (atomic, val);
+}
+
+P_LIB_API pint64
+p_atomic_int64_add_explicit (volatile pint64	*atomic,
+			     pint64		val,
+			     PAtomicMemoryOrder	order)
+{
+	P_UNUSED (order);
+
+	return p_atomic_int64_add (atomic, val);
+}
+
+P_LIB_API pboolean
+p_atomic_int64_compare_and_exchange_explicit (volatile pint64		*atomic,
+					      pint64			oldval,
+					      pint64			newval,
+					      PAtomicMemoryOrder	order)
+{
+	P_UNUSED (order);
+
+	return p_atomic_int64_compare_and_exchange (atomic, oldval, newval);
+}
+
+P_LIB_API void
+p_atomic_memory_barrier (void)
+{
+	p_mutex_lock (pp_atomic_mutex);
+	p_mutex_unlock (pp_atomic_mutex);
+}
+
+P_LIB_API void
+p_atomic_thread_fence (PAtomicMemoryOrder order)
+{
+	if (order != P_ATOMIC_MEMORY_ORDER_RELAXED)
+		p_atomic_memory_barrier ();
+}
+
+P_LIB_API void
+p_atomic_signal_fence (PAtomicMemoryOrder order)
+{
+	p_atomic_thread_fence (order);
+}
+
 P_LIB_API pboolean
 p_atomic_is_lock_free (void)
 {
 	return FALSE;
 }
 
+P_LIB_API pboolean
+p_atomic_int64_is_lock_free (void)
+{
+	return FALSE;
+}
+
 void
 p_atomic_thread_init (void)
 {
@@ -29,6 +29,11 @@
 #  include <intrinsics.h>
 #endif
 
+/* 32-bit targets may have no 64-bit compare and exchange */
+#if (PLIBSYS_SIZEOF_VOID_P == 8) || defined (__GCC_HAVE_SYNC_COMPARE_AND_SWAP_8)
+#  define PATOMIC_INT64_LOCK_FREE
+#endif
+
 P_LIB_API pint
 p_atomic_int_get (const volatile pint *atomic)
 {
@@ -104,6 +109,50 @@ p_atomic_int_xor (volatile puint	*atomic,
 	return (puint) __sync_fetch_and_xor (atomic, val);
 }
 
+P_LIB_API pint
+p_atomic_int_get_explicit (const volatile pint	*atomic,
+			   PAtomicMemoryOrder	order)
+{
+	if (order == P_ATOMIC_MEMORY_ORDER_RELAXED)
+		return *atomic;
+
+	return p_atomic_int_get (atomic);
+}
+
+P_LIB_API void
+p_atomic_int_set_explicit (volatile pint	*atomic,
+			   pint			val,
+			   PAtomicMemoryOrder	order)
+{
+	if (order == P_ATOMIC_MEMORY_ORDER_RELAXED) {
+		*atomic = val;
+		return;
+	}
+
+	p_atomic_int_set (atomic, val);
+}
+
+P_LIB_API pint
+p_atomic_int_add_explicit (volatile pint	*atomic,
+			   pint			val,
+			   PAtomicMemoryOrder	order)
+{
+	P_UNUSED (order);
+
+	return p_atomic_int_add (atomic, val);
+}
+
+P_LIB_API pboolean
+p_atomic_int_compare_and_exchange_explicit (volatile pint	*atomic,
+					    pint		oldval,
+					    pint		newval,
+					    PAtomicMemoryOrder	order)
+{
+	P_UNUSED (order);
+
+	return p_atomic_int_compare_and_exchange (atomic, oldval, newval);
+}
+
 P_LIB_API ppointer
 p_atomic_pointer_get (const volatile void *atomic)
 {
@@ -173,12 +222,356 @@ p_atomic_pointer_xor (volatile void	*atomic,
 	return (psize) __sync_fetch_and_xor ((volatile psize *) atomic, val);
 }
 
+P_LIB_API ppointer
+p_atomic_pointer_get_explicit (const volatile void	*atomic,
+			       PAtomicMemoryOrder	order)
+{
+	if (order == P_ATOMIC_MEMORY_ORDER_RELAXED)
+		return (ppointer) *((const volatile psize *) atomic);
+
+	return p_atomic_pointer_get (atomic);
+}
+
+P_LIB_API void
+p_atomic_pointer_set_explicit (volatile void		*atomic,
+			       ppointer			val,
+			       PAtomicMemoryOrder	order)
+{
+	if (order == P_ATOMIC_MEMORY_ORDER_RELAXED) {
+		*((volatile psize *) atomic) = (psize) val;
+		return;
+	}
+
+	p_atomic_pointer_set (atomic, val);
+}
+
+P_LIB_API pssize
+p_atomic_pointer_add_explicit (volatile void		*atomic,
+			       pssize			val,
+			       PAtomicMemoryOrder	order)
+{
+	P_UNUSED (order);
+
+	return p_atomic_pointer_add (atomic, val);
+}
+
+P_LIB_API pboolean
+p_atomic_pointer_compare_and_exchange_explicit (volatile void		*atomic,
+						ppointer		oldval,
+						ppointer		newval,
+						PAtomicMemoryOrder	order)
+{
+	P_UNUSED (order);
+
+	return p_atomic_pointer_compare_and_exchange (atomic, oldval, newval);
+}
+
+#ifdef PATOMIC_INT64_LOCK_FREE
+
+P_LIB_API pint64
+p_atomic_int64_get (const volatile pint64 *atomic)
+{
+#if (PLIBSYS_SIZEOF_VOID_P == 8)
+#  ifdef P_CC_CRAY
+	__builtin_ia32_mfence ();
+#  else
+	__sync_synchronize ();
+#  endif
+	return *atomic;
+#else
+	/* Plain 64-bit load is not atomic on a 32-bit target */
+	return __sync_val_compare_and_swap ((volatile pint64 *) atomic, 0, 0);
+#endif
+}
+
+P_LIB_API void
+p_atomic_int64_set (volatile pint64	*atomic,
+		    pint64		val)
+{
+#if (PLIBSYS_SIZEOF_VOID_P == 8)
+	*atomic = val;
+#  ifdef P_CC_CRAY
+	__builtin_ia32_mfence ();
+#  else
+	__sync_synchronize ();
+#  endif
+#else
+	pint64 oldval;
+
+	do {
+		oldval = *atomic;
+	} while (__sync_val_compare_and_swap (atomic, oldval, val) != oldval);
+#endif
+}
+
+P_LIB_API void
+p_atomic_int64_inc (volatile pint64 *atomic)
+{
+	(void) __sync_fetch_and_add (atomic, 1);
+}
+
+P_LIB_API pboolean
+p_atomic_int64_dec_and_test (volatile pint64 *atomic)
+{
+	return __sync_fetch_and_sub (atomic, 1) == 1 ? TRUE : FALSE;
+}
+
+P_LIB_API pboolean
+p_atomic_int64_compare_and_exchange (volatile pint64	*atomic,
+				     pint64		oldval,
+				     pint64		newval)
+{
+#ifdef P_CC_CRAY
+	return __sync_val_compare_and_swap (atomic, oldval, newval) == oldval ? TRUE : FALSE;
+#else
+	return (pboolean) __sync_bool_compare_and_swap (atomic, oldval, newval);
+#endif
+}
+
+P_LIB_API pint64
+p_atomic_int64_add (volatile pint64	*atomic,
+		    pint64		val)
+{
+	return (pint64) __sync_fetch_and_add (atomic, val);
+}
+
+P_LIB_API puint64
+p_atomic_int64_and (volatile puint64	*atomic,
+		    puint64		val)
+{
+	return (puint64) __sync_fetch_and_and (atomic, val);
+}
+
+P_LIB_API puint64
+p_atomic_int64_or (volatile puint64	*atomic,
+		   puint64		val)
+{
+	return (puint64) __sync_fetch_and_or (atomic, val);
+}
+
+P_LIB_API puint64
+p_atomic_int64_xor (volatile puint64	*atomic,
+		    puint64		val)
+{
+	return (puint64) __sync_fetch_and_xor (atomic, val);
+}
+
+#else /* !PATOMIC_INT64_LOCK_FREE */
+
+/* No 64-bit compare and exchange, guard the 64-bit values with a spin lock */
+static volatile pint pp_atomic_int64_lock = 0;
+
+static void pp_atomic_int64_lock_acquire (void);
+static void pp_atomic_int64_lock_release (void);
+
+static void
+pp_atomic_int64_lock_acquire (void)
+{
+	while (p_atomic_int_compare_and_exchange (&pp_atomic_int64_lock, 0, 1) == FALSE)
+		;
+}
+
+static void
+pp_atomic_int64_lock_release (void)
+{
+	p_atomic_int_set (&pp_atomic_int64_lock, 0);
+}
+
+P_LIB_API pint64
+p_atomic_int64_get (const volatile pint64 *atomic)
+{
+	pint64 value;
+
+	pp_atomic_int64_lock_acquire ();
+	value = *atomic;
+	pp_atomic_int64_lock_release ();
+
+	return value;
+}
+
+P_LIB_API void
+p_atomic_int64_set (volatile pint64	*atomic,
+		    pint64		val)
+{
+	pp_atomic_int64_lock_acquire ();
+	*atomic = val;
+	pp_atomic_int64_lock_release ();
+}
+
+P_LIB_API void
+p_atomic_int64_inc (volatile pint64 *atomic)
+{
+	pp_atomic_int64_lock_acquire ();
+	(*atomic)++;
+	pp_atomic_int64_lock_release ();
+}
+
+P_LIB_API pboolean
+p_atomic_int64_dec_and_test (volatile pint64 *atomic)
+{
+	pboolean is_zero;
+
+	pp_atomic_int64_lock_acquire ();
+	is_zero = --(*atomic) == 0;
+	pp_atomic_int64_lock_release ();
+
+	return is_zero;
+}
+
+P_LIB_API pboolean
+p_atomic_int64_compare_and_exchange (volatile pint64	*atomic,
+				     pint64		oldval,
+				     pint64		newval)
+{
+	pboolean success;
+
+	pp_atomic_int64_lock_acquire ();
+
+	if ((success = (*atomic == oldval)))
+		*atomic = newval;
+
+	pp_atomic_int64_lock_release ();
+
+	return success;
+}
+
+P_LIB_API pint64
+p_atomic_int64_add (volatile pint64	*atomic,
+		    pint64		val)
+{
+	pint64 oldval;
+
+	pp_atomic_int64_lock_acquire ();
+	oldval = *atomic;
+	*atomic = oldval + val;
+	pp_atomic_int64_lock_release ();
+
+	return oldval;
+}
+
+P_LIB_API puint64
+p_atomic_int64_and (volatile puint64	*atomic,
+		    puint64		val)
+{
+	puint64 oldval;
+
+	pp_atomic_int64_lock_acquire ();
+	oldval = *atomic;
+	*atomic = oldval & val;
+	pp_atomic_int64_lock_release ();
+
+	return oldval;
+}
+
+P_LIB_API puint64
+p_atomic_int64_or (volatile puint64	*atomic,
+		   puint64		val)
+{
+	puint64 oldval;
+
+	pp_atomic_int64_lock_acquire ();
+	oldval = *atomic;
+	*atomic = oldval | val;
+	pp_atomic_int64_lock_release ();
+
+	return oldval;
+}
+
+P_LIB_API puint64
+p_atomic_int64_xor (volatile puint64	*atomic,
+		    puint64		val)
+{
+	puint64 oldval;
+
+	pp_atomic_int64_lock_acquire ();
+	oldval = *atomic;
+	*atomic = oldval ^ val;
+	pp_atomic_int64_lock_release ();
+
+	return oldval;
+}
+
+#endif /* PATOMIC_INT64_LOCK_FREE */
+
+P_LIB_API pint64
+p_atomic_int64_get_explicit (const volatile pint64	*atomic,
+			     PAtomicMemoryOrder		order)
+{
+	P_UNUSED (order);
+
+	return p_atomic_int64_get (atomic);
+}
+
+P_LIB_API void
+p_atomic_int64_set_explicit (volatile pint64	*atomic,
+			     pint64		val,
+			     PAtomicMemoryOrder	order)
+{
+	P_UNUSED (order);
+
+	p_atomic_int64_set (atomic, val);
+}
+
+P_LIB_API pint64
+p_atomic_int64_add_explicit (volatile pint64	*atomic,
+			     pint64		val,
+			     PAtomicMemoryOrder	order)
+{
+	P_UNUSED (order);
+
+	return p_atomic_int64_add (atomic, val);
+}
+
+P_LIB_API pboolean
+p_atomic_int64_compare_and_exchange_explicit (volatile pint64		*atomic,
+					      pint64			oldval,
+					      pint64			newval,
+					      PAtomicMemoryOrder	order)
+{
+	P_UNUSED (order);
+
+	return p_atomic_int64_compare_and_exchange (atomic, oldval, newval);
+}
+
+P_LIB_API void
+p_atomic_memory_barrier (void)
+{
+#ifdef P_CC_CRAY
+	__builtin_ia32_mfence ();
+#else
+	__sync_synchronize ();
+#endif
+}
+
+P_LIB_API void
+p_atomic_thread_fence (PAtomicMemoryOrder order)
+{
+	if (order != P_ATOMIC_MEMORY_ORDER_RELAXED)
+		p_atomic_memory_barrier ();
+}
+
+P_LIB_API void
+p_atomic_signal_fence (PAtomicMemoryOrder order)
+{
+	p_atomic_thread_fence (order);
+}
+
 P_LIB_API pboolean
 p_atomic_is_lock_free (void)
 {
 	return TRUE;
 }
 
+P_LIB_API pboolean
+p_atomic_int64_is_lock_free (void)
+{
+#ifdef PATOMIC_INT64_LOCK_FREE
+	return TRUE;
+#else
+	return FALSE;
+#endif
+}
+
 void
 p_atomic_thread_init (void)
 {
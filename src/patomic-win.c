@@ -115,6 +115,79 @@ ppInterlockedXor (LONG volatile	*atomic,
 #  define InterlockedXor(a,b) ppInterlockedXor(a,b)
 #endif
 
+#if PLIBSYS_SIZEOF_VOID_P == 8
+#  define PATOMIC_WIN_INT64_ADD(a,b) InterlockedExchangeAdd64(a,b)
+#  define PATOMIC_WIN_INT64_AND(a,b) InterlockedAnd64(a,b)
+#  define PATOMIC_WIN_INT64_OR(a,b) InterlockedOr64(a,b)
+#  define PATOMIC_WIN_INT64_XOR(a,b) InterlockedXor64(a,b)
+#else
+/* Only the 64-bit compare and exchange is available on all 32-bit targets */
+static LONGLONG
+ppInterlockedExchangeAdd64 (LONGLONG volatile	*atomic,
+			    LONGLONG		val)
+{
+	LONGLONG i, j;
+
+	j = *atomic;
+	do {
+		i = j;
+		j = InterlockedCompareExchange64 (atomic, i + val, i);
+	} while (i != j);
+
+	return j;
+}
+
+static LONGLONG
+ppInterlockedAnd64 (LONGLONG volatile	*atomic,
+		    LONGLONG		val)
+{
+	LONGLONG i, j;
+
+	j = *atomic;
+	do {
+		i = j;
+		j = InterlockedCompareExchange64 (atomic, i & val, i);
+	} while (i != j);
+
+	return j;
+}
+
+static LONGLONG
+ppInterlockedOr64 (LONGLONG volatile	*atomic,
+		   LONGLONG		val)
+{
+	LONGLONG i, j;
+
+	j = *atomic;
+	do {
+		i = j;
+		j = InterlockedCompareExchange64 (atomic, i | val, i);
+	} while (i != j);
+
+	return j;
+}
+
+static LONGLONG
+ppInterlockedXor64 (LONGLONG volatile	*atomic,
+		    LONGLONG		val)
+{
+	LONGLONG i, j;
+
+	j = *atomic;
+	do {
+		i = j;
+		j = InterlockedCompareExchange64 (atomic, i ^ val, i);
+	} while (i != j);
+
+	return j;
+}
+
+#  define PATOMIC_WIN_INT64_ADD(a,b) ppInterlockedExchangeAdd64(a,b)
+#  define PATOMIC_WIN_INT64_AND(a,b) ppInterlockedAnd64(a,b)
+#  define PATOMIC_WIN_INT64_OR(a,b) ppInterlockedOr64(a,b)
+#  define PATOMIC_WIN_INT64_XOR(a,b) ppInterlockedXor64(a,b)
+#endif
+
 /* http://msdn.microsoft.com/en-us/library/ms684122(v=vs.85).aspx */
 
 P_LIB_API pint
@@ -182,6 +255,50 @@ p_atomic_int_xor (volatile puint	*atomic,
 	return (puint) InterlockedXor ((LONG volatile *) atomic, (LONG) val);
 }
 
+P_LIB_API pint
+p_atomic_int_get_explicit (const volatile pint	*atomic,
+			   PAtomicMemoryOrder	order)
+{
+	if (order == P_ATOMIC_MEMORY_ORDER_RELAXED)
+		return *atomic;
+
+	return p_atomic_int_get (atomic);
+}
+
+P_LIB_API void
+p_atomic_int_set_explicit (volatile pint	*atomic,
+			   pint			val,
+			   PAtomicMemoryOrder	order)
+{
+	if (order == P_ATOMIC_MEMORY_ORDER_RELAXED) {
+		*atomic = val;
+		return;
+	}
+
+	p_atomic_int_set (atomic, val);
+}
+
+P_LIB_API pint
+p_atomic_int_add_explicit (volatile pint	*atomic,
+			   pint			val,
+			   PAtomicMemoryOrder	order)
+{
+	P_UNUSED (order);
+
+	return p_atomic_int_add (atomic, val);
+}
+
+P_LIB_API pboolean
+p_atomic_int_compare_and_exchange_explicit (volatile pint	*atomic,
+					    pint		oldval,
+					    pint		newval,
+					    PAtomicMemoryOrder	order)
+{
+	P_UNUSED (order);
+
+	return p_atomic_int_compare_and_exchange (atomic, oldval, newval);
+}
+
 P_LIB_API ppointer
 p_atomic_pointer_get (const volatile void *atomic)
 {
@@ -255,12 +372,201 @@ p_atomic_pointer_xor (volatile void	*atomic,
 #endif
 }
 
+P_LIB_API ppointer
+p_atomic_pointer_get_explicit (const volatile void	*atomic,
+			       PAtomicMemoryOrder	order)
+{
+	if (order == P_ATOMIC_MEMORY_ORDER_RELAXED)
+		return (ppointer) *((const volatile psize *) atomic);
+
+	return p_atomic_pointer_get (atomic);
+}
+
+P_LIB_API void
+p_atomic_pointer_set_explicit (volatile void		*atomic,
+			       ppointer			val,
+			       PAtomicMemoryOrder	order)
+{
+	if (order == P_ATOMIC_MEMORY_ORDER_RELAXED) {
+		*((volatile psize *) atomic) = (psize) val;
+		return;
+	}
+
+	p_atomic_pointer_set (atomic, val);
+}
+
+P_LIB_API pssize
+p_atomic_pointer_add_explicit (volatile void		*atomic,
+			       pssize			val,
+			       PAtomicMemoryOrder	order)
+{
+	P_UNUSED (order);
+
+	return p_atomic_pointer_add (atomic, val);
+}
+
+P_LIB_API pboolean
+p_atomic_pointer_compare_and_exchange_explicit (volatile void		*atomic,
+						ppointer		oldval,
+						ppointer		newval,
+						PAtomicMemoryOrder	order)
+{
+	P_UNUSED (order);
+
+	return p_atomic_pointer_compare_and_exchange (atomic, oldval, newval);
+}
+
+P_LIB_API pint64
+p_atomic_int64_get (const volatile pint64 *atomic)
+{
+#if PLIBSYS_SIZEOF_VOID_P == 8
+	MemoryBarrier ();
+	return *atomic;
+#else
+	/* Plain 64-bit load is not atomic on a 32-bit target */
+	return (pint64) InterlockedCompareExchange64 ((LONGLONG volatile *) atomic, 0, 0);
+#endif
+}
+
+P_LIB_API void
+p_atomic_int64_set (volatile pint64	*atomic,
+		    pint64		val)
+{
+#if PLIBSYS_SIZEOF_VOID_P == 8
+	*atomic = val;
+	MemoryBarrier ();
+#else
+	LONGLONG i, j;
+
+	j = (LONGLONG) *atomic;
+	do {
+		i = j;
+		j = InterlockedCompareExchange64 ((LONGLONG volatile *) atomic, (LONGLONG) val, i);
+	} while (i != j);
+#endif
+}
+
+P_LIB_API void
+p_atomic_int64_inc (volatile pint64 *atomic)
+{
+	(void) PATOMIC_WIN_INT64_ADD ((LONGLONG volatile *) atomic, 1);
+}
+
+P_LIB_API pboolean
+p_atomic_int64_dec_and_test (volatile pint64 *atomic)
+{
+	return PATOMIC_WIN_INT64_ADD ((LONGLONG volatile *) atomic, -1) == 1 ? TRUE : FALSE;
+}
+
+P_LIB_API pboolean
+p_atomic_int64_compare_and_exchange (volatile pint64	*atomic,
+				     pint64		oldval,
+				     pint64		newval)
+{
+	return InterlockedCompareExchange64 ((LONGLONG volatile *) atomic,
+					     (LONGLONG) newval,
+					     (LONGLONG) oldval) == oldval ? TRUE : FALSE;
+}
+
+P_LIB_API pint64
+p_atomic_int64_add (volatile pint64	*atomic,
+		    pint64		val)
+{
+	return (pint64) PATOMIC_WIN_INT64_ADD ((LONGLONG volatile *) atomic, (LONGLONG) val);
+}
+
+P_LIB_API puint64
+p_atomic_int64_and (volatile puint64	*atomic,
+		    puint64		val)
+{
+	return (puint64) PATOMIC_WIN_INT64_AND ((LONGLONG volatile *) atomic, (LONGLONG) val);
+}
+
+P_LIB_API puint64
+p_atomic_int64_or (volatile puint64	*atomic,
+		   puint64		val)
+{
+	return (puint64) PATOMIC_WIN_INT64_OR ((LONGLONG volatile *) atomic, (LONGLONG) val);
+}
+
+P_LIB_API puint64
+p_atomic_int64_xor (volatile puint64	*atomic,
+		    puint64		val)
+{
+	return (puint64) PATOMIC_WIN_INT64_XOR ((LONGLONG volatile *) atomic, (LONGLONG) val);
+}
+
+P_LIB_API pint64
+p_atomic_int64_get_explicit (const volatile pint64	*atomic,
+			     PAtomicMemoryOrder		order)
+{
+	P_UNUSED (order);
+
+	return p_atomic_int64_get (atomic);
+}
+
+P_LIB_API void
+p_atomic_int64_set_explicit (volatile pint64	*atomic,
+			     pint64		val,
+			     PAtomicMemoryOrder	order)
+{
+	P_UNUSED (order);
+
+	p_atomic_int64_set (atomic, val);
+}
+
+P_LIB_API pint64
+p_atomic_int64_add_explicit (volatile pint64	*atomic,
+			     pint64		val,
+			     PAtomicMemoryOrder	order)
+{
+	P_UNUSED (order);
+
+	return p_atomic_int64_add (atomic, val);
+}
+
+P_LIB_API pboolean
+p_atomic_int64_compare_and_exchange_explicit (volatile pint64		*atomic,
+					      pint64			oldval,
+					      pint64			newval,
+					      PAtomicMemoryOrder	order)
+{
+	P_UNUSED (order);
+
+	return p_atomic_int64_compare_and_exchange (atomic, oldval, newval);
+}
+
+P_LIB_API void
+p_atomic_memory_barrier (void)
+{
+	MemoryBarrier ();
+}
+
+P_LIB_API void
+p_atomic_thread_fence (PAtomicMemoryOrder order)
+{
+	if (order != P_ATOMIC_MEMORY_ORDER_RELAXED)
+		p_atomic_memory_barrier ();
+}
+
+P_LIB_API void
+p_atomic_signal_fence (PAtomicMemoryOrder order)
+{
+	p_atomic_thread_fence (order);
+}
+
 P_LIB_API pboolean
 p_atomic_is_lock_free (void)
 {
 	return TRUE;
 }
 
+P_LIB_API pboolean
+p_atomic_int64_is_lock_free (void)
+{
+	return TRUE;
+}
+
 void
 p_atomic_thread_init (void)
 {
@@ -46,6 +46,40 @@
  *
  * The Windows platform provides all the required lock-free operations in most
  * cases, so it always has lock-free support.
+ *
+ * The #pint64 operations work with 64-bit values on any target, including the
+ * 32-bit ones where a pointer-sized value is not wide enough for byte counters
+ * or sequence numbers. A 32-bit target may lack a 64-bit compare and exchange
+ * instruction, in that case the #pint64 operations are simulated with a lock
+ * even if the other operations are lock-free: check the
+ * p_atomic_int64_is_lock_free() call for them. A #pint64 atomic variable should
+ * be aligned to 8 bytes, which is not guaranteed for structure members on some
+ * 32-bit targets.
+ *
+ * All the operations above are sequentially consistent and act as full
+ * barriers, which costs extra fences on weakly ordered CPUs like ARM and POWER.
+ * The `_explicit` variants take a #PAtomicMemoryOrder instead: a statistics
+ * counter needs only #P_ATOMIC_MEMORY_ORDER_RELAXED, a flag publishing data
+ * needs a #P_ATOMIC_MEMORY_ORDER_RELEASE set paired with a
+ * #P_ATOMIC_MEMORY_ORDER_ACQUIRE get. An order which makes no sense for an
+ * operation is strengthened: a get treats release as acquire, a set treats
+ * acquire as release. The c11 atomic model maps the orders directly, the other
+ * models use plain accesses for relaxed gets and sets of naturally atomic
+ * values and full barriers for everything else. Standalone fences are issued
+ * with p_atomic_thread_fence() and p_atomic_signal_fence().
+ *
+ * All the operations are exported library functions. Hot code can define
+ * P_ATOMIC_INLINE before including plibsys.h to get the most used of them
+ * inlined, see patomic-inline.h for the details.
+ *
+ * A thread which has nothing to do until an atomic integer changes can sleep
+ * in p_atomic_int_wait() instead of spinning, and the thread changing the
+ * value wakes it up with p_atomic_int_notify_one() or
+ * p_atomic_int_notify_all(). The waiting uses futexes on Linux, __ulock_wait()
+ * on macOS and WaitOnAddress() on Windows 8 and newer, so a notify call without
+ * waiters doesn't enter the kernel. Elsewhere the threads sleep on condition
+ * variables from a small table hashed by the address, and a notify call
+ * without waiters costs a memory barrier.
  */
 
 #if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
@@ -60,6 +94,15 @@
 
 P_BEGIN_DECLS
 
+/** Memory order for the explicit atomic operations. */
+typedef enum PAtomicMemoryOrder_ {
+	P_ATOMIC_MEMORY_ORDER_RELAXED	= 0,	/**< Atomicity only, no ordering.				*/
+	P_ATOMIC_MEMORY_ORDER_ACQUIRE	= 1,	/**< Later accesses are not moved before the operation.	*/
+	P_ATOMIC_MEMORY_ORDER_RELEASE	= 2,	/**< Earlier accesses are not moved after the operation.	*/
+	P_ATOMIC_MEMORY_ORDER_ACQ_REL	= 3,	/**< Both acquire and release.					*/
+	P_ATOMIC_MEMORY_ORDER_SEQ_CST	= 4	/**< Acquire, release and a single total order.		*/
+} PAtomicMemoryOrder;
+
 /**
  * @brief Gets #pint value from @a atomic.
  * @param atomic Pointer to #pint to get the value from.
@@ -295,6 +338,375 @@ P_LIB_API psize		p_atomic_pointer_or			(volatile void		*atomic,
 P_LIB_API psize		p_atomic_pointer_xor			(volatile void		*atomic,
 								 psize			val);
 
+/**
+ * @brief Gets #pint64 value from @a atomic.
+ * @param atomic Pointer to #pint64 to get the value from.
+ * @return Integer value.
+ * @since 0.0.5
+ *
+ * This call acts as a full compiler and hardware memory barrier (before the
+ * get).
+ */
+P_LIB_API pint64	p_atomic_int64_get			(const volatile pint64	*atomic);
+
+/**
+ * @brief Sets #pint64 value to @a atomic.
+ * @param[out] atomic Pointer to #pint64 to set the value for.
+ * @param val New #pint64 value.
+ * @since 0.0.5
+ *
+ * This call acts as a full compiler and hardware memory barrier (after the
+ * set).
+ */
+P_LIB_API void		p_atomic_int64_set			(volatile pint64	*atomic,
+								 pint64			val);
+
+/**
+ * @brief Increments #pint64 value from @a atomic by 1.
+ * @param[in,out] atomic Pointer to #pint64 to increment the value.
+ * @since 0.0.5
+ *
+ * Think of this operation as an atomic version of `{ *atomic += 1; }`.
+ *
+ * This call acts as a full compiler and hardware memory barrier.
+ */
+P_LIB_API void		p_atomic_int64_inc			(volatile pint64	*atomic);
+
+/**
+ * @brief Decrements #pint64 value from @a atomic by 1 and tests the result
+ * for zero.
+ * @param[in,out] atomic Pointer to #pint64 to decrement the value.
+ * @return TRUE if the new value is equal to zero, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * Think of this operation as an atomic version of
+ * `{ *atomic -= 1; return (*atomic == 0); }`.
+ *
+ * This call acts as a full compiler and hardware memory barrier.
+ */
+P_LIB_API pboolean	p_atomic_int64_dec_and_test		(volatile pint64	*atomic);
+
+/**
+ * @brief Compares @a oldval with the value pointed to by @a atomic and if
+ * they are equal, atomically exchanges the value of @a atomic with @a newval.
+ * @param[in,out] atomic Pointer to #pint64.
+ * @param oldval Old #pint64 value.
+ * @param newval New #pint64 value.
+ * @return TRUE if @a atomic value was equal @a oldval, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * This compare and exchange is done atomically.
+ *
+ * Think of this operation as an atomic version of
+ * `{ if (*atomic == oldval) { *atomic = newval; return TRUE; } else return FALSE; }`.
+ *
+ * This call acts as a full compiler and hardware memory barrier.
+ */
+P_LIB_API pboolean	p_atomic_int64_compare_and_exchange	(volatile pint64	*atomic,
+								 pint64			oldval,
+								 pint64			newval);
+
+/**
+ * @brief Atomically adds #pint64 value to @a atomic value.
+ * @param[in,out] atomic Pointer to #pint64.
+ * @param val Integer to add to @a atomic value.
+ * @return Old value before the addition.
+ * @since 0.0.5
+ *
+ * Think of this operation as an atomic version of
+ * `{ tmp = *atomic; *atomic += val; return tmp; }`.
+ *
+ * This call acts as a full compiler and hardware memory barrier.
+ */
+P_LIB_API pint64	p_atomic_int64_add			(volatile pint64	*atomic,
+								 pint64			val);
+
+/**
+ * @brief Atomically performs the bitwise 'and' operation of @a atomic value
+ * and @a val storing the result back in @a atomic.
+ * @param[in,out] atomic Pointer to #puint64.
+ * @param val #puint64 to perform bitwise 'and' with @a atomic value.
+ * @return Old @a atomic value before the operation.
+ * @since 0.0.5
+ *
+ * Think of this operation as an atomic version of
+ * `{ tmp = *atomic; *atomic &= val; return tmp; }`.
+ *
+ * This call acts as a full compiler and hardware memory barrier.
+ */
+P_LIB_API puint64	p_atomic_int64_and			(volatile puint64	*atomic,
+								 puint64		val);
+
+/**
+ * @brief Atomically performs the bitwise 'or' operation of @a atomic value
+ * and @a val storing the result back in @a atomic.
+ * @param[in,out] atomic Pointer to #puint64.
+ * @param val #puint64 to perform bitwise 'or' with @a atomic value.
+ * @return Old @a atomic value before the operation.
+ * @since 0.0.5
+ *
+ * Think of this operation as an atomic version of
+ * `{ tmp = *atomic; *atomic |= val; return tmp; }`.
+ *
+ * This call acts as a full compiler and hardware memory barrier.
+ */
+P_LIB_API puint64	p_atomic_int64_or			(volatile puint64	*atomic,
+								 puint64		val);
+
+/**
+ * @brief Atomically performs the bitwise 'xor' operation of @a atomic value
+ * and @a val storing the result back in @a atomic.
+ * @param[in,out] atomic Pointer to #puint64.
+ * @param val #puint64 to perform bitwise 'xor' with @a atomic value.
+ * @return Old @a atomic value before the operation.
+ * @since 0.0.5
+ *
+ * Think of this operation as an atomic version of
+ * `{ tmp = *atomic; *atomic ^= val; return tmp; }`.
+ *
+ * This call acts as a full compiler and hardware memory barrier.
+ */
+P_LIB_API puint64	p_atomic_int64_xor			(volatile puint64	*atomic,
+								 puint64		val);
+
+/**
+ * @brief Gets #pint value from @a atomic with the given memory order.
+ * @param atomic Pointer to #pint to get the value from.
+ * @param order Memory order of the operation.
+ * @return Integer value.
+ * @since 0.0.5
+ */
+P_LIB_API pint		p_atomic_int_get_explicit		(const volatile pint	*atomic,
+								 PAtomicMemoryOrder	order);
+
+/**
+ * @brief Sets #pint value to @a atomic with the given memory order.
+ * @param[out] atomic Pointer to #pint to set the value for.
+ * @param val New #pint value.
+ * @param order Memory order of the operation.
+ * @since 0.0.5
+ */
+P_LIB_API void		p_atomic_int_set_explicit		(volatile pint		*atomic,
+								 pint			val,
+								 PAtomicMemoryOrder	order);
+
+/**
+ * @brief Atomically adds #pint value to @a atomic value with the given memory
+ * order.
+ * @param[in,out] atomic Pointer to #pint.
+ * @param val Integer to add to @a atomic value.
+ * @param order Memory order of the operation.
+ * @return Old value before the addition.
+ * @since 0.0.5
+ *
+ * A relaxed addition is enough for a statistics counter.
+ */
+P_LIB_API pint		p_atomic_int_add_explicit		(volatile pint		*atomic,
+								 pint			val,
+								 PAtomicMemoryOrder	order);
+
+/**
+ * @brief Compares @a oldval with the value pointed to by @a atomic and if
+ * they are equal, atomically exchanges the value of @a atomic with @a newval,
+ * with the given memory order.
+ * @param[in,out] atomic Pointer to #pint.
+ * @param oldval Old #pint value.
+ * @param newval New #pint value.
+ * @param order Memory order of the operation.
+ * @return TRUE if @a atomic value was equal @a oldval, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * A failed exchange uses @a order without its release part.
+ */
+P_LIB_API pboolean	p_atomic_int_compare_and_exchange_explicit	(volatile pint		*atomic,
+									 pint			oldval,
+									 pint			newval,
+									 PAtomicMemoryOrder	order);
+
+/**
+ * @brief Gets #pint64 value from @a atomic with the given memory order.
+ * @param atomic Pointer to #pint64 to get the value from.
+ * @param order Memory order of the operation.
+ * @return Integer value.
+ * @since 0.0.5
+ */
+P_LIB_API pint64	p_atomic_int64_get_explicit		(const volatile pint64	*atomic,
+								 PAtomicMemoryOrder	order);
+
+/**
+ * @brief Sets #pint64 value to @a atomic with the given memory order.
+ * @param[out] atomic Pointer to #pint64 to set the value for.
+ * @param val New #pint64 value.
+ * @param order Memory order of the operation.
+ * @since 0.0.5
+ */
+P_LIB_API void		p_atomic_int64_set_explicit		(volatile pint64	*atomic,
+								 pint64			val,
+								 PAtomicMemoryOrder	order);
+
+/**
+ * @brief Atomically adds #pint64 value to @a atomic value with the given memory
+ * order.
+ * @param[in,out] atomic Pointer to #pint64.
+ * @param val Integer to add to @a atomic value.
+ * @param order Memory order of the operation.
+ * @return Old value before the addition.
+ * @since 0.0.5
+ */
+P_LIB_API pint64	p_atomic_int64_add_explicit		(volatile pint64	*atomic,
+								 pint64			val,
+								 PAtomicMemoryOrder	order);
+
+/**
+ * @brief Compares @a oldval with the value pointed to by @a atomic and if
+ * they are equal, atomically exchanges the value of @a atomic with @a newval,
+ * with the given memory order.
+ * @param[in,out] atomic Pointer to #pint64.
+ * @param oldval Old #pint64 value.
+ * @param newval New #pint64 value.
+ * @param order Memory order of the operation.
+ * @return TRUE if @a atomic value was equal @a oldval, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * A failed exchange uses @a order without its release part.
+ */
+P_LIB_API pboolean	p_atomic_int64_compare_and_exchange_explicit	(volatile pint64	*atomic,
+									 pint64			oldval,
+									 pint64			newval,
+									 PAtomicMemoryOrder	order);
+
+/**
+ * @brief Gets #ppointer-sized value from @a atomic with the given memory
+ * order.
+ * @param atomic Pointer to get the value from.
+ * @param order Memory order of the operation.
+ * @return Value from the pointer.
+ * @since 0.0.5
+ */
+P_LIB_API ppointer	p_atomic_pointer_get_explicit		(const volatile void	*atomic,
+								 PAtomicMemoryOrder	order);
+
+/**
+ * @brief Sets @a val to #ppointer-sized @a atomic with the given memory order.
+ * @param[out] atomic Pointer to set the value for.
+ * @param val New value for @a atomic.
+ * @param order Memory order of the operation.
+ * @since 0.0.5
+ *
+ * A release set publishes the data written before it to an acquire get of
+ * the same pointer.
+ */
+P_LIB_API void		p_atomic_pointer_set_explicit		(volatile void		*atomic,
+								 ppointer		val,
+								 PAtomicMemoryOrder	order);
+
+/**
+ * @brief Atomically adds #ppointer-sized value to @a atomic value with the
+ * given memory order.
+ * @param[in,out] atomic Pointer to #ppointer-sized value.
+ * @param val Value to add to @a atomic value.
+ * @param order Memory order of the operation.
+ * @return Old value before the addition.
+ * @since 0.0.5
+ */
+P_LIB_API pssize	p_atomic_pointer_add_explicit		(volatile void		*atomic,
+								 pssize			val,
+								 PAtomicMemoryOrder	order);
+
+/**
+ * @brief Compares @a oldval with the value pointed to by @a atomic and if
+ * they are equal, atomically exchanges the value of @a atomic with @a newval,
+ * with the given memory order.
+ * @param[in,out] atomic Pointer to #ppointer-sized value.
+ * @param oldval Old #ppointer-sized value.
+ * @param newval New #ppointer-sized value.
+ * @param order Memory order of the operation.
+ * @return TRUE if @a atomic value was equal @a oldval, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * A failed exchange uses @a order without its release part.
+ */
+P_LIB_API pboolean	p_atomic_pointer_compare_and_exchange_explicit	(volatile void		*atomic,
+									 ppointer		oldval,
+									 ppointer		newval,
+									 PAtomicMemoryOrder	order);
+
+/**
+ * @brief Issues a memory fence between threads.
+ * @param order Memory order of the fence.
+ * @since 0.0.5
+ *
+ * An acquire fence orders the preceding relaxed gets against the following
+ * accesses, a release fence orders the preceding accesses against the following
+ * relaxed sets. A #P_ATOMIC_MEMORY_ORDER_SEQ_CST fence is the same as
+ * p_atomic_memory_barrier(), a #P_ATOMIC_MEMORY_ORDER_RELAXED fence does
+ * nothing.
+ */
+P_LIB_API void		p_atomic_thread_fence			(PAtomicMemoryOrder	order);
+
+/**
+ * @brief Issues a memory fence between a thread and a signal handler
+ * executed in it.
+ * @param order Memory order of the fence.
+ * @since 0.0.5
+ *
+ * Only the compiler reordering is prevented, no hardware fence is needed
+ * within the same thread. Atomic models without a compiler-only fence issue
+ * the thread fence instead.
+ */
+P_LIB_API void		p_atomic_signal_fence			(PAtomicMemoryOrder	order);
+
+/**
+ * @brief Issues a full compiler and hardware memory barrier.
+ * @since 0.0.5
+ *
+ * No memory access before the barrier can be reordered with any memory access
+ * after it. This is useful to order plain memory accesses against atomic ones,
+ * i.e. to validate the data read optimistically under a sequence counter.
+ */
+P_LIB_API void		p_atomic_memory_barrier			(void);
+
+/**
+ * @brief Waits until an atomic integer changes its value.
+ * @param atomic Pointer to #pint to wait on.
+ * @param expected Value to wait while @a atomic holds it.
+ * @param timeout Timeout in milliseconds, -1 to wait infinitely, 0 to return
+ * immediately.
+ * @return TRUE if @a atomic doesn't hold @a expected or the thread was woken
+ * up, FALSE on timeout or in case of error.
+ * @since 0.0.5
+ *
+ * The value is compared and the thread goes to sleep atomically with respect
+ * to p_atomic_int_notify_one() and p_atomic_int_notify_all(): a notify call
+ * made after changing the value can't be missed. The call may return TRUE
+ * without a notify call (a spurious wakeup), so check the value in a loop.
+ *
+ * The waiters and the notifiers must be in the same process.
+ */
+P_LIB_API pboolean	p_atomic_int_wait			(const volatile pint	*atomic,
+								 pint			expected,
+								 pint			timeout);
+
+/**
+ * @brief Wakes up a thread waiting on an atomic integer.
+ * @param atomic Pointer to #pint the thread waits on.
+ * @since 0.0.5
+ *
+ * Change the value before the call, see p_atomic_int_wait(). Without the
+ * native support all the threads waiting on addresses in the same hash slot
+ * are woken up, the others return as after a spurious wakeup.
+ */
+P_LIB_API void		p_atomic_int_notify_one			(volatile pint		*atomic);
+
+/**
+ * @brief Wakes up all the threads waiting on an atomic integer.
+ * @param atomic Pointer to #pint the threads wait on.
+ * @since 0.0.5
+ *
+ * Change the value before the call, see p_atomic_int_wait().
+ */
+P_LIB_API void		p_atomic_int_notify_all			(volatile pint		*atomic);
+
 /**
  * @brief Checks whether atomic operations are lock-free.
  * @return TRUE in case of success, FALSE otherwise.
@@ -302,9 +714,27 @@ P_LIB_API psize		p_atomic_pointer_xor			(volatile void		*atomic,
  *
  * Some underlying atomic model implementations may not support lock-free
  * operations depending on hardware or software.
+ *
+ * This call reports the #pint and pointer-sized operations, use
+ * p_atomic_int64_is_lock_free() for the #pint64 ones.
  */
 P_LIB_API pboolean	p_atomic_is_lock_free			(void);
 
+/**
+ * @brief Checks whether #pint64 atomic operations are lock-free.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * A 32-bit target without a 64-bit compare and exchange instruction simulates
+ * the #pint64 operations with a lock, even if p_atomic_is_lock_free() returns
+ * TRUE.
+ */
+P_LIB_API pboolean	p_atomic_int64_is_lock_free		(void);
+
 P_END_DECLS
 
+#if defined (P_ATOMIC_INLINE) && !defined (PLIBSYS_COMPILATION)
+#  include "patomic-inline.h"
+#endif
+
 #endif /* PLIBSYS_HEADER_PATOMIC_H */
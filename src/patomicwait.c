@@ -0,0 +1,333 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* The native calls compare the value and go to sleep atomically in the
+ * kernel. Without them a waiter registers in the bucket waiters counter and
+ * checks the value under the bucket mutex, while a notifier changes the value
+ * and then reads the counter: a full barrier on both sides makes at least one
+ * of them see the other, and the notifier takes the mutex to broadcast, so
+ * the wakeup can't fall between the check and the sleep. A bucket is shared
+ * by many addresses, hence a broadcast even for a single thread. */
+
+#include "patomic.h"
+#include "pcondvariable.h"
+#include "pmem.h"
+#include "pmutex.h"
+#include "ponce.h"
+
+#if defined (PLIBSYS_HAS_FUTEX)
+#  include <errno.h>
+#  include <time.h>
+#  include <unistd.h>
+#  include <sys/syscall.h>
+#  include <linux/futex.h>
+#elif defined (PLIBSYS_HAS_ULOCK)
+#  include <errno.h>
+#  define P_ATOMIC_ULOCK_COMPARE_AND_WAIT	0x00000001
+#  define P_ATOMIC_ULOCK_WAKE_ALL		0x00000100
+#  define P_ATOMIC_ULOCK_NO_ERRNO		0x01000000
+extern int __ulock_wait (puint32 operation, void *addr, puint64 value, puint32 timeout);
+extern int __ulock_wake (puint32 operation, void *addr, puint64 wake_value);
+#else
+#  define P_ATOMIC_WAIT_USE_BUCKETS
+#  define P_ATOMIC_WAIT_BUCKETS		64
+#endif
+
+#ifdef P_ATOMIC_WAIT_USE_BUCKETS
+#  ifdef P_OS_WIN
+typedef BOOL (WINAPI * PWin32WaitOnAddress) (volatile VOID *addr, PVOID cmp_addr, SIZE_T size, DWORD ms);
+typedef VOID (WINAPI * PWin32WakeByAddress) (PVOID addr);
+
+static PWin32WaitOnAddress	pp_atomic_wait_func     = NULL;
+static PWin32WakeByAddress	pp_atomic_wake_one_func = NULL;
+static PWin32WakeByAddress	pp_atomic_wake_all_func = NULL;
+#  endif
+
+typedef struct PAtomicWaitBucket_ {
+	PMutex		*mutex;
+	PCondVariable	*cond;
+	volatile pint	waiters;
+	pchar		pad[P_MEM_CACHE_LINE_SIZE - 2 * sizeof (ppointer) - sizeof (pint)];
+} PAtomicWaitBucket;
+
+static P_CACHE_ALIGNED PAtomicWaitBucket	pp_atomic_wait_buckets[P_ATOMIC_WAIT_BUCKETS];
+static POnce			pp_atomic_wait_once = P_ONCE_INIT;
+
+static PAtomicWaitBucket * pp_atomic_wait_get_bucket (const volatile pint *atomic);
+static void pp_atomic_wait_init (ppointer data);
+#endif
+
+static void pp_atomic_int_notify (volatile pint *atomic, pboolean all);
+
+void p_atomic_wait_shutdown (void);
+
+#ifdef P_ATOMIC_WAIT_USE_BUCKETS
+static PAtomicWaitBucket *
+pp_atomic_wait_get_bucket (const volatile pint *atomic)
+{
+	psize addr;
+
+	addr = PPOINTER_TO_PSIZE (atomic);
+
+	return &pp_atomic_wait_buckets[((addr >> 4) ^ (addr >> 10)) & (P_ATOMIC_WAIT_BUCKETS - 1)];
+}
+#endif
+
+static void
+pp_atomic_int_notify (volatile pint	*atomic,
+		      pboolean		all)
+{
+#if defined (PLIBSYS_HAS_FUTEX)
+	syscall (SYS_futex, atomic, FUTEX_WAKE_PRIVATE, all == TRUE ? P_MAXINT32 : 1, NULL, NULL, 0);
+#elif defined (PLIBSYS_HAS_ULOCK)
+	__ulock_wake (P_ATOMIC_ULOCK_COMPARE_AND_WAIT |
+		      P_ATOMIC_ULOCK_NO_ERRNO         |
+		      (all == TRUE ? P_ATOMIC_ULOCK_WAKE_ALL : 0),
+		      (void *) atomic,
+		      0);
+#else
+	PAtomicWaitBucket *bucket;
+
+	p_once (&pp_atomic_wait_once, pp_atomic_wait_init, NULL);
+
+#  ifdef P_OS_WIN
+	if (pp_atomic_wait_func != NULL) {
+		if (all == TRUE)
+			pp_atomic_wake_all_func ((PVOID) atomic);
+		else
+			pp_atomic_wake_one_func ((PVOID) atomic);
+
+		return;
+	}
+#  endif
+
+	bucket = pp_atomic_wait_get_bucket (atomic);
+
+	if (P_UNLIKELY (bucket->mutex == NULL))
+		return;
+
+	p_atomic_thread_fence (P_ATOMIC_MEMORY_ORDER_SEQ_CST);
+
+	if (p_atomic_int_get_explicit (&bucket->waiters, P_ATOMIC_MEMORY_ORDER_RELAXED) == 0)
+		return;
+
+	p_mutex_lock (bucket->mutex);
+	p_cond_variable_broadcast (bucket->cond);
+	p_mutex_unlock (bucket->mutex);
+#endif
+}
+
+P_LIB_API pboolean
+p_atomic_int_wait (const volatile pint	*atomic,
+		   pint			expected,
+		   pint			timeout)
+{
+#if defined (PLIBSYS_HAS_FUTEX)
+	struct timespec	ts;
+	struct timespec	*pts;
+#elif defined (PLIBSYS_HAS_ULOCK)
+	puint32		usecs;
+	int		result;
+#else
+	PAtomicWaitBucket	*bucket;
+	pint			result;
+#endif
+
+	if (P_UNLIKELY (atomic == NULL))
+		return FALSE;
+
+	if (p_atomic_int_get (atomic) != expected)
+		return TRUE;
+
+	if (timeout == 0)
+		return FALSE;
+
+#if defined (PLIBSYS_HAS_FUTEX)
+	pts = NULL;
+
+	if (timeout > 0) {
+		ts.tv_sec  = timeout / 1000;
+		ts.tv_nsec = (timeout % 1000) * 1000000L;
+		pts        = &ts;
+	}
+
+	/* Fails with EAGAIN at once if the value is not expected anymore */
+	if (syscall (SYS_futex, atomic, FUTEX_WAIT_PRIVATE, expected, pts, NULL, 0) == 0)
+		return TRUE;
+
+	return errno == ETIMEDOUT ? FALSE : TRUE;
+#elif defined (PLIBSYS_HAS_ULOCK)
+	/* Zero means no timeout, a longer wait returns as a spurious wakeup */
+	if (timeout < 0)
+		usecs = 0;
+	else if ((puint32) timeout > P_MAXUINT32 / 1000)
+		usecs = (P_MAXUINT32 / 1000) * 1000;
+	else
+		usecs = (puint32) timeout * 1000;
+
+	result = __ulock_wait (P_ATOMIC_ULOCK_COMPARE_AND_WAIT | P_ATOMIC_ULOCK_NO_ERRNO,
+			       (void *) atomic,
+			       (puint64) (puint32) expected,
+			       usecs);
+
+	return result == -ETIMEDOUT ? FALSE : TRUE;
+#else
+	/* Buckets are needed only for the first wait or notify */
+	p_once (&pp_atomic_wait_once, pp_atomic_wait_init, NULL);
+
+#  ifdef P_OS_WIN
+	if (pp_atomic_wait_func != NULL) {
+		if (pp_atomic_wait_func ((volatile VOID *) atomic,
+					 (PVOID) &expected,
+					 sizeof (pint),
+					 timeout < 0 ? INFINITE : (DWORD) timeout))
+			return TRUE;
+
+		return GetLastError () == ERROR_TIMEOUT ? FALSE : TRUE;
+	}
+#  endif
+
+	bucket = pp_atomic_wait_get_bucket (atomic);
+
+	if (P_UNLIKELY (bucket->mutex == NULL))
+		return FALSE;
+
+	p_mutex_lock (bucket->mutex);
+
+	p_atomic_int_inc (&bucket->waiters);
+
+	if (p_atomic_int_get (atomic) != expected)
+		result = 1;
+	else if (timeout < 0)
+		result = p_cond_variable_wait (bucket->cond, bucket->mutex) == TRUE ? 1 : -1;
+	else
+		result = p_cond_variable_wait_timed (bucket->cond, bucket->mutex, timeout);
+
+	p_atomic_int_add (&bucket->waiters, -1);
+
+	p_mutex_unlock (bucket->mutex);
+
+	return result > 0 ? TRUE : FALSE;
+#endif
+}
+
+P_LIB_API void
+p_atomic_int_notify_one (volatile pint *atomic)
+{
+	if (P_UNLIKELY (atomic == NULL))
+		return;
+
+	pp_atomic_int_notify (atomic, FALSE);
+}
+
+P_LIB_API void
+p_atomic_int_notify_all (volatile pint *atomic)
+{
+	if (P_UNLIKELY (atomic == NULL))
+		return;
+
+	pp_atomic_int_notify (atomic, TRUE);
+}
+
+#ifdef P_ATOMIC_WAIT_USE_BUCKETS
+static void
+pp_atomic_wait_init (ppointer data)
+{
+	pint i;
+
+#  ifdef P_OS_WIN
+	HMODULE hmodule;
+#  endif
+
+	P_UNUSED (data);
+
+#  ifdef P_OS_WIN
+
+	/* Available since Windows 8 */
+	if ((hmodule = GetModuleHandleA ("kernelbase.dll")) != NULL) {
+		pp_atomic_wait_func     = (PWin32WaitOnAddress) GetProcAddress (hmodule, "WaitOnAddress");
+		pp_atomic_wake_one_func = (PWin32WakeByAddress) GetProcAddress (hmodule, "WakeByAddressSingle");
+		pp_atomic_wake_all_func = (PWin32WakeByAddress) GetProcAddress (hmodule, "WakeByAddressAll");
+	}
+
+	if (pp_atomic_wait_func != NULL && pp_atomic_wake_one_func != NULL && pp_atomic_wake_all_func != NULL)
+		return;
+
+	pp_atomic_wait_func     = NULL;
+	pp_atomic_wake_one_func = NULL;
+	pp_atomic_wake_all_func = NULL;
+#  endif
+
+	for (i = 0; i < P_ATOMIC_WAIT_BUCKETS; ++i) {
+		PAtomicWaitBucket *bucket = &pp_atomic_wait_buckets[i];
+
+		bucket->mutex = p_mutex_new ();
+		bucket->cond  = p_cond_variable_new ();
+
+		if (P_UNLIKELY (bucket->mutex == NULL || bucket->cond == NULL)) {
+			P_ERROR ("PAtomic::pp_atomic_wait_init: failed to create wait bucket");
+
+			if (bucket->mutex != NULL)
+				p_mutex_free (bucket->mutex);
+
+			if (bucket->cond != NULL)
+				p_cond_variable_free (bucket->cond);
+
+			bucket->mutex = NULL;
+			bucket->cond  = NULL;
+		}
+	}
+}
+#endif
+
+void
+p_atomic_wait_shutdown (void)
+{
+#ifdef P_ATOMIC_WAIT_USE_BUCKETS
+	pint i;
+
+	/* Let the next library initialization start over */
+	pp_atomic_wait_once = P_ONCE_INIT;
+
+	for (i = 0; i < P_ATOMIC_WAIT_BUCKETS; ++i) {
+		PAtomicWaitBucket *bucket = &pp_atomic_wait_buckets[i];
+
+		if (bucket->mutex != NULL)
+			p_mutex_free (bucket->mutex);
+
+		if (bucket->cond != NULL)
+			p_cond_variable_free (bucket->cond);
+
+		bucket->mutex = NULL;
+		bucket->cond  = NULL;
+	}
+
+#  ifdef P_OS_WIN
+	pp_atomic_wait_func     = NULL;
+	pp_atomic_wake_one_func = NULL;
+	pp_atomic_wake_all_func = NULL;
+#  endif
+#endif
+}
@@ -0,0 +1,251 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* The generic barrier counts the arrived threads in an atomic counter, the
+ * last thread resets it and bumps the phase number which the other threads
+ * poll. The last thread publishes the new phase and wakes up the sleepers
+ * under the mutex. A thread which sees the new phase while spinning still
+ * takes the mutex once before returning, so the barrier is never freed while
+ * the last thread is using it. */
+
+#include "patomic.h"
+#include "pbarrier.h"
+#include "pcondvariable.h"
+#include "pmem.h"
+#include "pmutex.h"
+
+#if defined (PLIBSYS_HAS_POSIX_BARRIER)
+#  include <pthread.h>
+#endif
+
+#ifdef P_OS_WIN
+/* Layout of SYNCHRONIZATION_BARRIER, older SDKs lack the definition */
+typedef struct PWin32SyncBarrier_ {
+	DWORD		reserved1;
+	DWORD		reserved2;
+	ULONG_PTR	reserved3[2];
+	DWORD		reserved4;
+	DWORD		reserved5;
+} PWin32SyncBarrier;
+
+typedef BOOL (WINAPI * PWin32InitSyncBarrier) (PWin32SyncBarrier *barrier, LONG total_threads, LONG spin_count);
+typedef BOOL (WINAPI * PWin32EnterSyncBarrier) (PWin32SyncBarrier *barrier, DWORD flags);
+typedef BOOL (WINAPI * PWin32DeleteSyncBarrier) (PWin32SyncBarrier *barrier);
+#endif
+
+struct PBarrier_ {
+	volatile pint		n_arrived;
+	volatile pint		phase;
+	volatile pint		n_sleepers;
+	pint			count;
+	pint			spin_count;
+	PMutex			*mutex;
+	PCondVariable		*cond;
+#if defined (PLIBSYS_HAS_POSIX_BARRIER)
+	pboolean		is_native;
+	pthread_barrier_t	native;
+#elif defined (P_OS_WIN)
+	pboolean		is_native;
+	PWin32SyncBarrier	native;
+	PWin32EnterSyncBarrier	enter_func;
+	PWin32DeleteSyncBarrier	delete_func;
+#endif
+};
+
+static pboolean pp_barrier_init_native (PBarrier *barrier);
+static pboolean pp_barrier_wait_generic (PBarrier *barrier);
+
+static pboolean
+pp_barrier_init_native (PBarrier *barrier)
+{
+#if defined (PLIBSYS_HAS_POSIX_BARRIER)
+	/* Native barrier never spins in user space */
+	if (barrier->spin_count > 0)
+		return FALSE;
+
+	if (P_UNLIKELY (pthread_barrier_init (&barrier->native, NULL, (unsigned) barrier->count) != 0))
+		return FALSE;
+
+	barrier->is_native = TRUE;
+
+	return TRUE;
+#elif defined (P_OS_WIN)
+	HMODULE			hmodule;
+	PWin32InitSyncBarrier	init_func;
+
+	if (P_UNLIKELY ((hmodule = GetModuleHandleA ("kernel32.dll")) == NULL))
+		return FALSE;
+
+	init_func            = (PWin32InitSyncBarrier) GetProcAddress (hmodule, "InitializeSynchronizationBarrier");
+	barrier->enter_func  = (PWin32EnterSyncBarrier) GetProcAddress (hmodule, "EnterSynchronizationBarrier");
+	barrier->delete_func = (PWin32DeleteSyncBarrier) GetProcAddress (hmodule, "DeleteSynchronizationBarrier");
+
+	if (init_func == NULL || barrier->enter_func == NULL || barrier->delete_func == NULL)
+		return FALSE;
+
+	/* Synchronization barrier spins by itself before blocking */
+	if (P_UNLIKELY (init_func (&barrier->native,
+				   (LONG) barrier->count,
+				   (LONG) barrier->spin_count) == FALSE))
+		return FALSE;
+
+	barrier->is_native = TRUE;
+
+	return TRUE;
+#else
+	P_UNUSED (barrier);
+
+	return FALSE;
+#endif
+}
+
+static pboolean
+pp_barrier_wait_generic (PBarrier *barrier)
+{
+	pint	phase;
+	pint	i;
+
+	phase = p_atomic_int_get (&barrier->phase);
+
+	if (p_atomic_int_add (&barrier->n_arrived, 1) == barrier->count - 1) {
+		p_mutex_lock (barrier->mutex);
+
+		/* Nobody can arrive for the next phase before it is published */
+		p_atomic_int_set (&barrier->n_arrived, 0);
+		p_atomic_int_inc (&barrier->phase);
+
+		if (p_atomic_int_get (&barrier->n_sleepers) > 0)
+			p_cond_variable_broadcast (barrier->cond);
+
+		p_mutex_unlock (barrier->mutex);
+
+		return TRUE;
+	}
+
+	for (i = 0; i < barrier->spin_count; ++i) {
+		if (p_atomic_int_get (&barrier->phase) != phase)
+			break;
+	}
+
+	p_mutex_lock (barrier->mutex);
+
+	if (p_atomic_int_get (&barrier->phase) == phase) {
+		p_atomic_int_inc (&barrier->n_sleepers);
+
+		while (p_atomic_int_get (&barrier->phase) == phase)
+			p_cond_variable_wait (barrier->cond, barrier->mutex);
+
+		p_atomic_int_add (&barrier->n_sleepers, -1);
+	}
+
+	p_mutex_unlock (barrier->mutex);
+
+	return FALSE;
+}
+
+P_LIB_API PBarrier *
+p_barrier_new (pint	count,
+	       pint	spin_count)
+{
+	PBarrier *ret;
+
+	if (P_UNLIKELY (count <= 0 || spin_count < 0))
+		return NULL;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PBarrier))) == NULL)) {
+		P_ERROR ("PBarrier::p_barrier_new: failed to allocate memory");
+		return NULL;
+	}
+
+	ret->count      = count;
+	ret->spin_count = spin_count;
+
+	if (pp_barrier_init_native (ret) == TRUE)
+		return ret;
+
+	if (P_UNLIKELY ((ret->mutex = p_mutex_new ()) == NULL)) {
+		P_ERROR ("PBarrier::p_barrier_new: failed to create mutex");
+		p_free (ret);
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret->cond = p_cond_variable_new ()) == NULL)) {
+		P_ERROR ("PBarrier::p_barrier_new: failed to create condition variable");
+		p_mutex_free (ret->mutex);
+		p_free (ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+P_LIB_API pboolean
+p_barrier_wait (PBarrier *barrier)
+{
+	if (P_UNLIKELY (barrier == NULL))
+		return FALSE;
+
+#if defined (PLIBSYS_HAS_POSIX_BARRIER)
+	if (barrier->is_native == TRUE)
+		return pthread_barrier_wait (&barrier->native) == PTHREAD_BARRIER_SERIAL_THREAD ? TRUE : FALSE;
+#elif defined (P_OS_WIN)
+	if (barrier->is_native == TRUE)
+		return barrier->enter_func (&barrier->native, 0) ? TRUE : FALSE;
+#endif
+
+	return pp_barrier_wait_generic (barrier);
+}
+
+P_LIB_API pint
+p_barrier_get_count (const PBarrier *barrier)
+{
+	if (P_UNLIKELY (barrier == NULL))
+		return 0;
+
+	return barrier->count;
+}
+
+P_LIB_API void
+p_barrier_free (PBarrier *barrier)
+{
+	if (P_UNLIKELY (barrier == NULL))
+		return;
+
+#if defined (PLIBSYS_HAS_POSIX_BARRIER)
+	if (barrier->is_native == TRUE)
+		pthread_barrier_destroy (&barrier->native);
+#elif defined (P_OS_WIN)
+	if (barrier->is_native == TRUE)
+		barrier->delete_func (&barrier->native);
+#endif
+
+	if (barrier->cond != NULL)
+		p_cond_variable_free (barrier->cond);
+
+	if (barrier->mutex != NULL)
+		p_mutex_free (barrier->mutex);
+
+	p_free (barrier);
+}
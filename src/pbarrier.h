@@ -0,0 +1,108 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pbarrier.h
+ * @brief Thread barrier
+ * @author Alexander Saprykin
+ *
+ * A barrier stops a group of threads at a point until all of them have
+ * reached it, which splits a parallel algorithm into phases: no thread starts
+ * the next phase before others have finished the current one. A barrier is
+ * created for a fixed number of threads with p_barrier_new(), every thread
+ * calls p_barrier_wait() at the end of a phase. When the last thread arrives
+ * all the threads are released and the barrier is ready for the next phase
+ * right away, so it can be reused in a loop.
+ *
+ * Exactly one of the released threads gets TRUE from p_barrier_wait(), it can
+ * do the serial part of the work between the phases (i.e. swap the buffers).
+ *
+ * The native barrier of the system is used where available: a
+ * synchronization barrier on Windows 8 and newer, and pthread_barrier_t on
+ * POSIX systems if the spin count is zero. With a positive spin count the
+ * waiting threads first poll the barrier state for that many rounds and only
+ * then go to sleep. For short phases, when all the
+ * threads arrive almost at once, none of them goes to sleep. Spinning
+ * only pays off if every thread has its own CPU, otherwise the spinning
+ * threads take the CPU time from the ones which are still running.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PBARRIER_H
+#define PLIBSYS_HEADER_PBARRIER_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+
+P_BEGIN_DECLS
+
+/** Barrier opaque data type. */
+typedef struct PBarrier_ PBarrier;
+
+/**
+ * @brief Creates a new barrier.
+ * @param count Number of threads to wait for, must be positive.
+ * @param spin_count Number of polling rounds before blocking, 0 to block at
+ * once.
+ * @return Pointer to #PBarrier in case of success, NULL otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API PBarrier *	p_barrier_new		(pint		count,
+						 pint		spin_count);
+
+/**
+ * @brief Waits on a barrier until all the threads have reached it.
+ * @param barrier #PBarrier to wait on.
+ * @return TRUE for exactly one of the released threads, FALSE for all the
+ * other ones and in case of error.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_barrier_wait		(PBarrier	*barrier);
+
+/**
+ * @brief Gets the number of threads a barrier waits for.
+ * @param barrier #PBarrier to get the number for.
+ * @return Number of threads given to p_barrier_new(), 0 in case of error.
+ * @since 0.0.5
+ */
+P_LIB_API pint		p_barrier_get_count	(const PBarrier	*barrier);
+
+/**
+ * @brief Frees a barrier.
+ * @param barrier #PBarrier to free.
+ * @since 0.0.5
+ *
+ * No threads should wait on the barrier at that moment. It is safe to free
+ * the barrier right after p_barrier_wait() has returned in any of the
+ * threads, the last arrived thread doesn't touch it after that.
+ */
+P_LIB_API void		p_barrier_free		(PBarrier	*barrier);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PBARRIER_H */
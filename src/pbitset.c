@@ -0,0 +1,621 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "pmem.h"
+#include "patomic.h"
+#include "pbitset.h"
+
+#include <string.h>
+
+#if defined (P_CPU_X86_64) || defined (__SSE2__) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define P_BITSET_SSE2
+#elif defined (P_CPU_ARM_64)
+#  include <arm_neon.h>
+#  define P_BITSET_NEON
+#endif
+
+#ifdef P_CC_MSVC
+#  include <intrin.h>
+#endif
+
+#define P_BITSET_WORD_BITS		64
+#define P_BITSET_WORD_SHIFT		6
+#define P_BITSET_WORD_MASK		63
+
+/* Atomic bit sets are limited to the word size of the atomic bitwise operations */
+#define P_ATOMIC_BITSET_WORD_BITS	32
+#define P_ATOMIC_BITSET_WORD_SHIFT	5
+#define P_ATOMIC_BITSET_WORD_MASK	31
+
+typedef enum PBitsetOp_ {
+	P_BITSET_OP_AND	= 0,
+	P_BITSET_OP_OR	= 1,
+	P_BITSET_OP_XOR	= 2
+} PBitsetOp;
+
+/* The bits beyond the size in the last word are always clear */
+struct PBitset_ {
+	puint64		*words;
+	psize		num_words;
+	psize		size;
+};
+
+/* The bits beyond the size in the last word are always set, so they are never
+ * found as the clear ones */
+struct PAtomicBitset_ {
+	volatile puint	*words;
+	psize		num_words;
+	psize		size;
+};
+
+static puint pp_bitset_ctz64 (puint64 word);
+static puint pp_bitset_ctz32 (puint32 word);
+static puint pp_bitset_popcount64 (puint64 word);
+static void pp_bitset_fill_range (PBitset *bitset, psize start, psize count, pboolean value);
+static pboolean pp_bitset_combine (PBitset *bitset, const PBitset *other, PBitsetOp op);
+
+static puint
+pp_bitset_ctz64 (puint64 word)
+{
+#if defined (P_CC_GNU) || defined (P_CC_CLANG)
+	return (puint) __builtin_ctzll (word);
+#elif defined (P_CC_MSVC) && (defined (P_CPU_X86_64) || defined (P_CPU_ARM_64))
+	unsigned long idx;
+
+	_BitScanForward64 (&idx, word);
+
+	return (puint) idx;
+#else
+	puint idx;
+
+	for (idx = 0; (word & 1) == 0; word >>= 1)
+		++idx;
+
+	return idx;
+#endif
+}
+
+static puint
+pp_bitset_ctz32 (puint32 word)
+{
+#if defined (P_CC_GNU) || defined (P_CC_CLANG)
+	return (puint) __builtin_ctz (word);
+#elif defined (P_CC_MSVC)
+	unsigned long idx;
+
+	_BitScanForward (&idx, word);
+
+	return (puint) idx;
+#else
+	puint idx;
+
+	for (idx = 0; (word & 1) == 0; word >>= 1)
+		++idx;
+
+	return idx;
+#endif
+}
+
+static puint
+pp_bitset_popcount64 (puint64 word)
+{
+#if defined (P_CC_GNU) || defined (P_CC_CLANG)
+	return (puint) __builtin_popcountll (word);
+#else
+	word = word - ((word >> 1) & 0x5555555555555555ULL);
+	word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+	word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+
+	return (puint) ((word * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+static void
+pp_bitset_fill_range (PBitset	*bitset,
+		      psize	start,
+		      psize	count,
+		      pboolean	value)
+{
+	puint64	mask;
+	psize	end;
+	psize	bit;
+	psize	len;
+
+	if (start >= bitset->size)
+		return;
+
+	end = count > bitset->size - start ? bitset->size : start + count;
+
+	while (start < end) {
+		bit  = start & P_BITSET_WORD_MASK;
+		len  = P_BITSET_WORD_BITS - bit;
+
+		if (len > end - start)
+			len = end - start;
+
+		mask = (len == P_BITSET_WORD_BITS ? ~((puint64) 0) : ((((puint64) 1) << len) - 1)) << bit;
+
+		if (value)
+			bitset->words[start >> P_BITSET_WORD_SHIFT] |= mask;
+		else
+			bitset->words[start >> P_BITSET_WORD_SHIFT] &= ~mask;
+
+		start += len;
+	}
+}
+
+static pboolean
+pp_bitset_combine (PBitset		*bitset,
+		   const PBitset	*other,
+		   PBitsetOp		op)
+{
+	puint64	*dst;
+	const puint64	*src;
+	psize	i;
+
+	if (P_UNLIKELY (bitset == NULL || other == NULL || bitset->size != other->size))
+		return FALSE;
+
+	dst = bitset->words;
+	src = other->words;
+	i   = 0;
+
+#if defined (P_BITSET_SSE2)
+	for (; i + 2 <= bitset->num_words; i += 2) {
+		__m128i a = _mm_loadu_si128 ((const __m128i *) (dst + i));
+		__m128i b = _mm_loadu_si128 ((const __m128i *) (src + i));
+
+		switch (op) {
+		case P_BITSET_OP_AND:
+			a = _mm_and_si128 (a, b);
+			break;
+		case P_BITSET_OP_OR:
+			a = _mm_or_si128 (a, b);
+			break;
+		default:
+			a = _mm_xor_si128 (a, b);
+			break;
+		}
+
+		_mm_storeu_si128 ((__m128i *) (dst + i), a);
+	}
+#elif defined (P_BITSET_NEON)
+	for (; i + 2 <= bitset->num_words; i += 2) {
+		uint64x2_t a = vld1q_u64 ((const uint64_t *) (dst + i));
+		uint64x2_t b = vld1q_u64 ((const uint64_t *) (src + i));
+
+		switch (op) {
+		case P_BITSET_OP_AND:
+			a = vandq_u64 (a, b);
+			break;
+		case P_BITSET_OP_OR:
+			a = vorrq_u64 (a, b);
+			break;
+		default:
+			a = veorq_u64 (a, b);
+			break;
+		}
+
+		vst1q_u64 ((uint64_t *) (dst + i), a);
+	}
+#endif
+
+	for (; i < bitset->num_words; ++i) {
+		switch (op) {
+		case P_BITSET_OP_AND:
+			dst[i] &= src[i];
+			break;
+		case P_BITSET_OP_OR:
+			dst[i] |= src[i];
+			break;
+		default:
+			dst[i] ^= src[i];
+			break;
+		}
+	}
+
+	return TRUE;
+}
+
+P_LIB_API PBitset *
+p_bitset_new (psize size)
+{
+	PBitset *ret;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PBitset))) == NULL)) {
+		P_ERROR ("PBitset::p_bitset_new: failed(1) to allocate memory");
+		return NULL;
+	}
+
+	if (P_UNLIKELY (p_bitset_resize (ret, size) == FALSE)) {
+		P_ERROR ("PBitset::p_bitset_new: failed(2) to allocate memory");
+		p_free (ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+P_LIB_API pboolean
+p_bitset_resize (PBitset	*bitset,
+		 psize		size)
+{
+	puint64	*new_words;
+	psize	num_words;
+
+	if (P_UNLIKELY (bitset == NULL))
+		return FALSE;
+
+	if (P_UNLIKELY (size > ((psize) -1) - P_BITSET_WORD_MASK))
+		return FALSE;
+
+	num_words = (size + P_BITSET_WORD_MASK) >> P_BITSET_WORD_SHIFT;
+
+	if (num_words == 0) {
+		p_free (bitset->words);
+		new_words = NULL;
+	} else if (num_words != bitset->num_words) {
+		if (P_UNLIKELY (num_words > ((psize) -1) / sizeof (puint64)))
+			return FALSE;
+
+		if (P_UNLIKELY ((new_words = p_realloc (bitset->words, num_words * sizeof (puint64))) == NULL))
+			return FALSE;
+
+		if (num_words > bitset->num_words)
+			memset (new_words + bitset->num_words, 0, (num_words - bitset->num_words) * sizeof (puint64));
+	} else
+		new_words = bitset->words;
+
+	/* Drop the bits beyond the new size in the last word */
+	if (size < bitset->size && (size & P_BITSET_WORD_MASK) != 0)
+		new_words[num_words - 1] &= (((puint64) 1) << (size & P_BITSET_WORD_MASK)) - 1;
+
+	bitset->words     = new_words;
+	bitset->num_words = num_words;
+	bitset->size      = size;
+
+	return TRUE;
+}
+
+P_LIB_API psize
+p_bitset_get_size (const PBitset *bitset)
+{
+	if (P_UNLIKELY (bitset == NULL))
+		return 0;
+
+	return bitset->size;
+}
+
+P_LIB_API void
+p_bitset_set (PBitset	*bitset,
+	      psize	index)
+{
+	if (P_UNLIKELY (bitset == NULL || index >= bitset->size))
+		return;
+
+	bitset->words[index >> P_BITSET_WORD_SHIFT] |= ((puint64) 1) << (index & P_BITSET_WORD_MASK);
+}
+
+P_LIB_API void
+p_bitset_clear (PBitset	*bitset,
+		psize	index)
+{
+	if (P_UNLIKELY (bitset == NULL || index >= bitset->size))
+		return;
+
+	bitset->words[index >> P_BITSET_WORD_SHIFT] &= ~(((puint64) 1) << (index & P_BITSET_WORD_MASK));
+}
+
+P_LIB_API pboolean
+p_bitset_test (const PBitset	*bitset,
+	       psize		index)
+{
+	if (P_UNLIKELY (bitset == NULL || index >= bitset->size))
+		return FALSE;
+
+	return (bitset->words[index >> P_BITSET_WORD_SHIFT] >> (index & P_BITSET_WORD_MASK)) & 1;
+}
+
+P_LIB_API void
+p_bitset_set_range (PBitset	*bitset,
+		    psize	start,
+		    psize	count)
+{
+	if (P_UNLIKELY (bitset == NULL))
+		return;
+
+	pp_bitset_fill_range (bitset, start, count, TRUE);
+}
+
+P_LIB_API void
+p_bitset_clear_range (PBitset	*bitset,
+		      psize	start,
+		      psize	count)
+{
+	if (P_UNLIKELY (bitset == NULL))
+		return;
+
+	pp_bitset_fill_range (bitset, start, count, FALSE);
+}
+
+P_LIB_API psize
+p_bitset_find_first_set (const PBitset	*bitset,
+			 psize		from)
+{
+	puint64	word;
+	psize	i;
+
+	if (P_UNLIKELY (bitset == NULL || from >= bitset->size))
+		return P_BITSET_NOT_FOUND;
+
+	i    = from >> P_BITSET_WORD_SHIFT;
+	word = bitset->words[i] & (~((puint64) 0) << (from & P_BITSET_WORD_MASK));
+
+	for (;;) {
+		if (word != 0)
+			return (i << P_BITSET_WORD_SHIFT) + pp_bitset_ctz64 (word);
+
+		if (++i == bitset->num_words)
+			return P_BITSET_NOT_FOUND;
+
+		word = bitset->words[i];
+	}
+}
+
+P_LIB_API psize
+p_bitset_find_first_clear (const PBitset	*bitset,
+			   psize		from)
+{
+	puint64	word;
+	psize	ret;
+	psize	i;
+
+	if (P_UNLIKELY (bitset == NULL || from >= bitset->size))
+		return P_BITSET_NOT_FOUND;
+
+	i    = from >> P_BITSET_WORD_SHIFT;
+	word = ~bitset->words[i] & (~((puint64) 0) << (from & P_BITSET_WORD_MASK));
+
+	for (;;) {
+		if (word != 0) {
+			/* The tail of the last word looks clear */
+			ret = (i << P_BITSET_WORD_SHIFT) + pp_bitset_ctz64 (word);
+
+			return ret < bitset->size ? ret : P_BITSET_NOT_FOUND;
+		}
+
+		if (++i == bitset->num_words)
+			return P_BITSET_NOT_FOUND;
+
+		word = ~bitset->words[i];
+	}
+}
+
+P_LIB_API psize
+p_bitset_count (const PBitset *bitset)
+{
+	psize	ret;
+	psize	i;
+
+	if (P_UNLIKELY (bitset == NULL))
+		return 0;
+
+	ret = 0;
+	i   = 0;
+
+#if defined (P_BITSET_NEON)
+	for (; i + 2 <= bitset->num_words; i += 2)
+		ret += vaddvq_u8 (vcntq_u8 (vld1q_u8 ((const uint8_t *) (bitset->words + i))));
+#endif
+
+	for (; i < bitset->num_words; ++i)
+		ret += pp_bitset_popcount64 (bitset->words[i]);
+
+	return ret;
+}
+
+P_LIB_API pboolean
+p_bitset_and (PBitset		*bitset,
+	      const PBitset	*other)
+{
+	return pp_bitset_combine (bitset, other, P_BITSET_OP_AND);
+}
+
+P_LIB_API pboolean
+p_bitset_or (PBitset		*bitset,
+	     const PBitset	*other)
+{
+	return pp_bitset_combine (bitset, other, P_BITSET_OP_OR);
+}
+
+P_LIB_API pboolean
+p_bitset_xor (PBitset		*bitset,
+	      const PBitset	*other)
+{
+	return pp_bitset_combine (bitset, other, P_BITSET_OP_XOR);
+}
+
+P_LIB_API void
+p_bitset_free (PBitset *bitset)
+{
+	if (P_UNLIKELY (bitset == NULL))
+		return;
+
+	p_free (bitset->words);
+	p_free (bitset);
+}
+
+P_LIB_API PAtomicBitset *
+p_atomic_bitset_new (psize size)
+{
+	PAtomicBitset	*ret;
+	psize		num_words;
+
+	if (P_UNLIKELY (size > ((psize) -1) - P_ATOMIC_BITSET_WORD_MASK))
+		return NULL;
+
+	num_words = (size + P_ATOMIC_BITSET_WORD_MASK) >> P_ATOMIC_BITSET_WORD_SHIFT;
+
+	if (P_UNLIKELY (num_words > ((psize) -1) / sizeof (puint)))
+		return NULL;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PAtomicBitset))) == NULL)) {
+		P_ERROR ("PAtomicBitset::p_atomic_bitset_new: failed(1) to allocate memory");
+		return NULL;
+	}
+
+	if (num_words > 0 && P_UNLIKELY ((ret->words = p_malloc0 (num_words * sizeof (puint))) == NULL)) {
+		P_ERROR ("PAtomicBitset::p_atomic_bitset_new: failed(2) to allocate memory");
+		p_free (ret);
+		return NULL;
+	}
+
+	if ((size & P_ATOMIC_BITSET_WORD_MASK) != 0)
+		ret->words[num_words - 1] = ~((1U << (size & P_ATOMIC_BITSET_WORD_MASK)) - 1);
+
+	ret->num_words = num_words;
+	ret->size      = size;
+
+	return ret;
+}
+
+P_LIB_API psize
+p_atomic_bitset_get_size (const PAtomicBitset *bitset)
+{
+	if (P_UNLIKELY (bitset == NULL))
+		return 0;
+
+	return bitset->size;
+}
+
+P_LIB_API pboolean
+p_atomic_bitset_set (PAtomicBitset	*bitset,
+		     psize		index)
+{
+	puint bit;
+
+	if (P_UNLIKELY (bitset == NULL || index >= bitset->size))
+		return FALSE;
+
+	bit = 1U << (index & P_ATOMIC_BITSET_WORD_MASK);
+
+	return (p_atomic_int_or (&bitset->words[index >> P_ATOMIC_BITSET_WORD_SHIFT], bit) & bit) != 0;
+}
+
+P_LIB_API pboolean
+p_atomic_bitset_clear (PAtomicBitset	*bitset,
+		       psize		index)
+{
+	puint bit;
+
+	if (P_UNLIKELY (bitset == NULL || index >= bitset->size))
+		return FALSE;
+
+	bit = 1U << (index & P_ATOMIC_BITSET_WORD_MASK);
+
+	return (p_atomic_int_and (&bitset->words[index >> P_ATOMIC_BITSET_WORD_SHIFT], ~bit) & bit) != 0;
+}
+
+P_LIB_API pboolean
+p_atomic_bitset_test (const PAtomicBitset	*bitset,
+		      psize			index)
+{
+	puint word;
+
+	if (P_UNLIKELY (bitset == NULL || index >= bitset->size))
+		return FALSE;
+
+	word = (puint) p_atomic_int_get ((const volatile pint *) &bitset->words[index >> P_ATOMIC_BITSET_WORD_SHIFT]);
+
+	return (word >> (index & P_ATOMIC_BITSET_WORD_MASK)) & 1;
+}
+
+P_LIB_API psize
+p_atomic_bitset_find_and_set (PAtomicBitset	*bitset,
+			      psize		from)
+{
+	puint	mask;
+	puint	bit;
+	puint	free_bits;
+	psize	w;
+	psize	i;
+
+	if (P_UNLIKELY (bitset == NULL || bitset->size == 0))
+		return P_BITSET_NOT_FOUND;
+
+	if (from >= bitset->size)
+		from = 0;
+
+	w    = from >> P_ATOMIC_BITSET_WORD_SHIFT;
+	mask = ~0U << (from & P_ATOMIC_BITSET_WORD_MASK);
+
+	/* The first word is visited twice to cover the bits before the start */
+	for (i = 0; i <= bitset->num_words; ++i) {
+		for (;;) {
+			free_bits = ~((puint) p_atomic_int_get ((const volatile pint *) &bitset->words[w])) & mask;
+
+			if (free_bits == 0)
+				break;
+
+			bit = 1U << pp_bitset_ctz32 (free_bits);
+
+			/* Another thread may take the bit first, then try the next one */
+			if ((p_atomic_int_or (&bitset->words[w], bit) & bit) == 0)
+				return (w << P_ATOMIC_BITSET_WORD_SHIFT) + pp_bitset_ctz32 (bit);
+		}
+
+		mask = ~0U;
+		w    = w + 1 == bitset->num_words ? 0 : w + 1;
+	}
+
+	return P_BITSET_NOT_FOUND;
+}
+
+P_LIB_API psize
+p_atomic_bitset_count (const PAtomicBitset *bitset)
+{
+	psize	ret;
+	psize	i;
+
+	if (P_UNLIKELY (bitset == NULL))
+		return 0;
+
+	for (i = 0, ret = 0; i < bitset->num_words; ++i)
+		ret += pp_bitset_popcount64 ((puint) p_atomic_int_get ((const volatile pint *) &bitset->words[i]));
+
+	/* Exclude the always set tail */
+	return ret - (bitset->num_words * P_ATOMIC_BITSET_WORD_BITS - bitset->size);
+}
+
+P_LIB_API void
+p_atomic_bitset_free (PAtomicBitset *bitset)
+{
+	if (P_UNLIKELY (bitset == NULL))
+		return;
+
+	p_free ((ppointer) bitset->words);
+	p_free (bitset);
+}
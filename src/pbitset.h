@@ -0,0 +1,313 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pbitset.h
+ * @brief Bit sets
+ * @author Alexander Saprykin
+ *
+ * #PBitset stores a set of bits packed into 64-bit words, which takes 8 times
+ * less memory than an array of #pboolean and allows to process 64 bits with a
+ * single instruction: p_bitset_find_first_set() and
+ * p_bitset_find_first_clear() skip the full (or the empty) words and locate a
+ * bit with a count trailing zeros instruction, p_bitset_count() uses the
+ * population count, and the whole-set operations (p_bitset_and(),
+ * p_bitset_or(), p_bitset_xor()) are vectorized with SSE2 or NEON where
+ * available.
+ *
+ * The size of a set is given on creation, all the bits are clear initially.
+ * Use p_bitset_resize() to grow (or shrink) a set later. The bit operations
+ * with an index out of the set size are ignored.
+ *
+ * #PBitset is not thread-safe. For a set shared between threads, i.e. a map
+ * of the free slots in a pool, use #PAtomicBitset: it has a fixed size, and
+ * all the bit operations on it are atomic. p_atomic_bitset_find_and_set()
+ * finds a clear bit and sets it in one atomic step, so several threads can
+ * allocate the slots concurrently:
+ * @code
+ * psize slot;
+ *
+ * slot = p_atomic_bitset_find_and_set (slots, 0);
+ *
+ * if (slot != P_BITSET_NOT_FOUND) {
+ *     my_use_slot (slot);
+ *     p_atomic_bitset_clear (slots, slot);
+ * }
+ * @endcode
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PBITSET_H
+#define PLIBSYS_HEADER_PBITSET_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+
+P_BEGIN_DECLS
+
+/** Bit set opaque data structure. */
+typedef struct PBitset_ PBitset;
+
+/** Atomic bit set opaque data structure. */
+typedef struct PAtomicBitset_ PAtomicBitset;
+
+/** Index returned when no bit was found. */
+#define P_BITSET_NOT_FOUND ((psize) -1)
+
+/**
+ * @brief Creates a new bit set.
+ * @param size Number of bits in the set, can be 0.
+ * @return Pointer to a newly created #PBitset in case of success, NULL
+ * otherwise.
+ * @since 0.0.5
+ *
+ * All the bits are clear.
+ */
+P_LIB_API PBitset *	p_bitset_new			(psize			size);
+
+/**
+ * @brief Changes the number of bits in a bit set.
+ * @param bitset Bit set to resize.
+ * @param size New number of bits.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The new bits are clear, the bits beyond the new size are dropped. The set is
+ * left untouched in case of a failure.
+ */
+P_LIB_API pboolean	p_bitset_resize			(PBitset		*bitset,
+							 psize			size);
+
+/**
+ * @brief Gets the number of bits in a bit set.
+ * @param bitset Bit set to check.
+ * @return Number of the bits.
+ * @since 0.0.5
+ */
+P_LIB_API psize		p_bitset_get_size		(const PBitset		*bitset);
+
+/**
+ * @brief Sets a bit.
+ * @param bitset Bit set to modify.
+ * @param index Index of the bit.
+ * @since 0.0.5
+ */
+P_LIB_API void		p_bitset_set			(PBitset		*bitset,
+							 psize			index);
+
+/**
+ * @brief Clears a bit.
+ * @param bitset Bit set to modify.
+ * @param index Index of the bit.
+ * @since 0.0.5
+ */
+P_LIB_API void		p_bitset_clear			(PBitset		*bitset,
+							 psize			index);
+
+/**
+ * @brief Checks a bit.
+ * @param bitset Bit set to check.
+ * @param index Index of the bit.
+ * @return TRUE if the bit is set, FALSE if it is clear or out of the set.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_bitset_test			(const PBitset		*bitset,
+							 psize			index);
+
+/**
+ * @brief Sets a range of bits.
+ * @param bitset Bit set to modify.
+ * @param start Index of the first bit.
+ * @param count Number of the bits, the range is cut at the set size.
+ * @since 0.0.5
+ */
+P_LIB_API void		p_bitset_set_range		(PBitset		*bitset,
+							 psize			start,
+							 psize			count);
+
+/**
+ * @brief Clears a range of bits.
+ * @param bitset Bit set to modify.
+ * @param start Index of the first bit.
+ * @param count Number of the bits, the range is cut at the set size.
+ * @since 0.0.5
+ */
+P_LIB_API void		p_bitset_clear_range		(PBitset		*bitset,
+							 psize			start,
+							 psize			count);
+
+/**
+ * @brief Finds the first set bit starting from a given index.
+ * @param bitset Bit set to search in.
+ * @param from Index to start the search from.
+ * @return Index of the found bit, #P_BITSET_NOT_FOUND if there is none.
+ * @since 0.0.5
+ */
+P_LIB_API psize		p_bitset_find_first_set		(const PBitset		*bitset,
+							 psize			from);
+
+/**
+ * @brief Finds the first clear bit starting from a given index.
+ * @param bitset Bit set to search in.
+ * @param from Index to start the search from.
+ * @return Index of the found bit, #P_BITSET_NOT_FOUND if there is none.
+ * @since 0.0.5
+ */
+P_LIB_API psize		p_bitset_find_first_clear	(const PBitset		*bitset,
+							 psize			from);
+
+/**
+ * @brief Counts the set bits.
+ * @param bitset Bit set to check.
+ * @return Number of the set bits.
+ * @since 0.0.5
+ */
+P_LIB_API psize		p_bitset_count			(const PBitset		*bitset);
+
+/**
+ * @brief Intersects a bit set with another one.
+ * @param bitset Bit set to store the result in.
+ * @param other Bit set of the same size.
+ * @return TRUE in case of success, FALSE if the sizes differ.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_bitset_and			(PBitset		*bitset,
+							 const PBitset		*other);
+
+/**
+ * @brief Unites a bit set with another one.
+ * @param bitset Bit set to store the result in.
+ * @param other Bit set of the same size.
+ * @return TRUE in case of success, FALSE if the sizes differ.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_bitset_or			(PBitset		*bitset,
+							 const PBitset		*other);
+
+/**
+ * @brief Computes the symmetric difference of a bit set with another one.
+ * @param bitset Bit set to store the result in.
+ * @param other Bit set of the same size.
+ * @return TRUE in case of success, FALSE if the sizes differ.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_bitset_xor			(PBitset		*bitset,
+							 const PBitset		*other);
+
+/**
+ * @brief Frees a bit set.
+ * @param bitset Bit set to free.
+ * @since 0.0.5
+ */
+P_LIB_API void		p_bitset_free			(PBitset		*bitset);
+
+/**
+ * @brief Creates a new atomic bit set.
+ * @param size Number of bits in the set, can't be changed later.
+ * @return Pointer to a newly created #PAtomicBitset in case of success, NULL
+ * otherwise.
+ * @since 0.0.5
+ *
+ * All the bits are clear.
+ */
+P_LIB_API PAtomicBitset * p_atomic_bitset_new		(psize			size);
+
+/**
+ * @brief Gets the number of bits in an atomic bit set.
+ * @param bitset Bit set to check.
+ * @return Number of the bits.
+ * @since 0.0.5
+ */
+P_LIB_API psize		p_atomic_bitset_get_size	(const PAtomicBitset	*bitset);
+
+/**
+ * @brief Atomically sets a bit.
+ * @param bitset Bit set to modify.
+ * @param index Index of the bit.
+ * @return Previous state of the bit, FALSE if @a index is out of the set.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_atomic_bitset_set		(PAtomicBitset		*bitset,
+							 psize			index);
+
+/**
+ * @brief Atomically clears a bit.
+ * @param bitset Bit set to modify.
+ * @param index Index of the bit.
+ * @return Previous state of the bit, FALSE if @a index is out of the set.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_atomic_bitset_clear		(PAtomicBitset		*bitset,
+							 psize			index);
+
+/**
+ * @brief Atomically checks a bit.
+ * @param bitset Bit set to check.
+ * @param index Index of the bit.
+ * @return TRUE if the bit is set, FALSE if it is clear or out of the set.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_atomic_bitset_test		(const PAtomicBitset	*bitset,
+							 psize			index);
+
+/**
+ * @brief Finds a clear bit and sets it atomically.
+ * @param bitset Bit set to modify.
+ * @param from Index to start the search from, the search wraps around the end
+ * of the set.
+ * @return Index of the bit which was set by this call, #P_BITSET_NOT_FOUND if
+ * all the bits are set.
+ * @since 0.0.5
+ *
+ * Concurrent calls never return the same bit until it is cleared. Start the
+ * search from different indices in different threads (i.e. from the last
+ * found one) to spread the contention.
+ */
+P_LIB_API psize		p_atomic_bitset_find_and_set	(PAtomicBitset		*bitset,
+							 psize			from);
+
+/**
+ * @brief Counts the set bits.
+ * @param bitset Bit set to check.
+ * @return Number of the set bits.
+ * @since 0.0.5
+ *
+ * The bits changed concurrently may or may not be counted.
+ */
+P_LIB_API psize		p_atomic_bitset_count		(const PAtomicBitset	*bitset);
+
+/**
+ * @brief Frees an atomic bit set.
+ * @param bitset Bit set to free.
+ * @since 0.0.5
+ */
+P_LIB_API void		p_atomic_bitset_free		(PAtomicBitset		*bitset);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PBITSET_H */
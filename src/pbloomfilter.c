@@ -0,0 +1,369 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "pmem.h"
+#include "pfasthash.h"
+#include "pbloomfilter.h"
+
+#include <string.h>
+
+#if defined (P_CPU_X86_64) || defined (__SSE2__) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define P_BLOOM_FILTER_SSE2
+#elif defined (P_CPU_ARM_64)
+#  include <arm_neon.h>
+#  define P_BLOOM_FILTER_NEON
+#endif
+
+#define P_BLOOM_FILTER_BLOCK_WORDS	8
+#define P_BLOOM_FILTER_BLOCK_SIZE	(P_BLOOM_FILTER_BLOCK_WORDS * sizeof (puint32))
+#define P_BLOOM_FILTER_MAX_BLOCKS	((psize) P_MAXUINT32)
+
+struct PBloomFilter_ {
+	puint32	*blocks;
+	psize	num_blocks;
+};
+
+/* Odd multipliers selecting a bit in every word of a block, the same as in the
+ * split block Bloom filter of Apache Parquet */
+static const puint32 pp_bloom_filter_salt[P_BLOOM_FILTER_BLOCK_WORDS] = {
+	0x47B6137BU, 0x44974D91U, 0x8824AD5BU, 0xA2B7289DU,
+	0x705495C7U, 0x2DF1424BU, 0x9EFC4947U, 0x5C6BFB31U
+};
+
+static pdouble pp_bloom_filter_sqrt (pdouble x);
+static pdouble pp_bloom_filter_ln (pdouble x);
+static psize pp_bloom_filter_calc_blocks (psize expected_items, pdouble false_positive_rate);
+static puint64 pp_bloom_filter_mix (puint64 hash);
+static puint32 * pp_bloom_filter_get_block (const PBloomFilter *filter, puint64 hash);
+
+/* The library doesn't link with libm, and the sizing needs only a rough
+ * precision, so these are plain Newton's iterations and a series */
+static pdouble
+pp_bloom_filter_sqrt (pdouble x)
+{
+	pdouble	y;
+	pint	i;
+
+	y = x < 1.0 ? 1.0 : x;
+
+	for (i = 0; i < 64; ++i)
+		y = (y + x / y) * 0.5;
+
+	return y;
+}
+
+static pdouble
+pp_bloom_filter_ln (pdouble x)
+{
+	pdouble	z, z2, term, sum;
+	pint	exp2;
+	pint	i;
+
+	/* Reduce to [1, 2): ln (x) = ln (m) + e * ln (2) */
+	for (exp2 = 0; x >= 2.0; ++exp2)
+		x *= 0.5;
+
+	for (; x < 1.0; --exp2)
+		x *= 2.0;
+
+	/* ln (m) = 2 * atanh ((m - 1) / (m + 1)), |z| <= 1/3 */
+	z    = (x - 1.0) / (x + 1.0);
+	z2   = z * z;
+	term = z;
+	sum  = 0.0;
+
+	for (i = 1; i < 40; i += 2) {
+		sum  += term / i;
+		term *= z2;
+	}
+
+	return 2.0 * sum + exp2 * 0.69314718055994530942;
+}
+
+static psize
+pp_bloom_filter_calc_blocks (psize	expected_items,
+			     pdouble	false_positive_rate)
+{
+	pdouble	root;
+	pdouble	bits;
+	pdouble	blocks;
+
+	if (expected_items == 0)
+		expected_items = 1;
+
+	/* With one bit set in each of 8 words the rate is about (1 - e^(-8n/m))^8,
+	 * so m = -8n / ln (1 - p^(1/8)) */
+	root = pp_bloom_filter_sqrt (pp_bloom_filter_sqrt (pp_bloom_filter_sqrt (false_positive_rate)));
+	bits = -8.0 * (pdouble) expected_items / pp_bloom_filter_ln (1.0 - root);
+
+	/* The blocks are not loaded evenly, which makes the rate a bit worse
+	 * than the formula above gives */
+	blocks = bits * 1.1 / (P_BLOOM_FILTER_BLOCK_SIZE * 8) + 1.0;
+
+	if (blocks >= (pdouble) P_BLOOM_FILTER_MAX_BLOCKS ||
+	    blocks >= (pdouble) (((psize) -1) / P_BLOOM_FILTER_BLOCK_SIZE))
+		return 0;
+
+	return (psize) blocks;
+}
+
+/* Finalizer of MurmurHash3, spreads weak hash values over all the bits */
+static puint64
+pp_bloom_filter_mix (puint64 hash)
+{
+	hash ^= hash >> 33;
+	hash *= 0xFF51AFD7ED558CCDULL;
+	hash ^= hash >> 33;
+	hash *= 0xC4CEB9FE1A85EC53ULL;
+	hash ^= hash >> 33;
+
+	return hash;
+}
+
+static puint32 *
+pp_bloom_filter_get_block (const PBloomFilter	*filter,
+			   puint64		hash)
+{
+	/* Multiply and shift maps the upper half onto [0, num_blocks) without
+	 * a division */
+	return filter->blocks + ((hash >> 32) * (puint64) filter->num_blocks >> 32) * P_BLOOM_FILTER_BLOCK_WORDS;
+}
+
+#if defined (P_BLOOM_FILTER_SSE2)
+static __m128i pp_bloom_filter_mullo_sse2 (__m128i a, __m128i b);
+static void pp_bloom_filter_make_mask_sse2 (puint32 key, __m128i *lo, __m128i *hi);
+
+/* SSE2 has no 32-bit lane multiplication, combine two 64-bit ones */
+static __m128i
+pp_bloom_filter_mullo_sse2 (__m128i	a,
+			    __m128i	b)
+{
+	__m128i	even;
+	__m128i	odd;
+
+	even = _mm_mul_epu32 (a, b);
+	odd  = _mm_mul_epu32 (_mm_srli_epi64 (a, 32), _mm_srli_epi64 (b, 32));
+
+	return _mm_unpacklo_epi32 (_mm_shuffle_epi32 (even, _MM_SHUFFLE (0, 0, 2, 0)),
+				   _mm_shuffle_epi32 (odd, _MM_SHUFFLE (0, 0, 2, 0)));
+}
+
+static void
+pp_bloom_filter_make_mask_sse2 (puint32	key,
+				__m128i	*lo,
+				__m128i	*hi)
+{
+	__m128i	vkey;
+	__m128i	one;
+	__m128i	bits;
+
+	vkey = _mm_set1_epi32 ((pint) key);
+	one  = _mm_set1_epi32 (0x3F800000);
+
+	/* There is no variable lane shift either: 1 << n is built as the float
+	 * 2^n and converted back. For n = 31 the conversion overflows into
+	 * 0x80000000, which is exactly the required bit */
+	bits = _mm_srli_epi32 (pp_bloom_filter_mullo_sse2 (vkey, _mm_loadu_si128 ((const __m128i *) pp_bloom_filter_salt)), 27);
+	*lo  = _mm_cvttps_epi32 (_mm_castsi128_ps (_mm_add_epi32 (_mm_slli_epi32 (bits, 23), one)));
+
+	bits = _mm_srli_epi32 (pp_bloom_filter_mullo_sse2 (vkey, _mm_loadu_si128 ((const __m128i *) pp_bloom_filter_salt + 1)), 27);
+	*hi  = _mm_cvttps_epi32 (_mm_castsi128_ps (_mm_add_epi32 (_mm_slli_epi32 (bits, 23), one)));
+}
+#endif
+
+P_LIB_API PBloomFilter *
+p_bloom_filter_new (psize	expected_items,
+		    pdouble	false_positive_rate)
+{
+	PBloomFilter	*ret;
+	psize		num_blocks;
+
+	if (P_UNLIKELY (!(false_positive_rate > 0.0 && false_positive_rate < 1.0)))
+		return NULL;
+
+	if (P_UNLIKELY ((num_blocks = pp_bloom_filter_calc_blocks (expected_items, false_positive_rate)) == 0))
+		return NULL;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PBloomFilter))) == NULL)) {
+		P_ERROR ("PBloomFilter::p_bloom_filter_new: failed(1) to allocate memory");
+		return NULL;
+	}
+
+	/* A block is aligned to its size so it never crosses a cache line */
+	if (P_UNLIKELY ((ret->blocks = p_malloc0_aligned (num_blocks * P_BLOOM_FILTER_BLOCK_SIZE,
+							  P_MEM_CACHE_LINE_SIZE)) == NULL)) {
+		P_ERROR ("PBloomFilter::p_bloom_filter_new: failed(2) to allocate memory");
+		p_free (ret);
+		return NULL;
+	}
+
+	ret->num_blocks = num_blocks;
+
+	return ret;
+}
+
+P_LIB_API void
+p_bloom_filter_add (PBloomFilter	*filter,
+		    pconstpointer	data,
+		    psize		len)
+{
+	if (P_UNLIKELY (filter == NULL || (data == NULL && len > 0)))
+		return;
+
+	p_bloom_filter_add_hash (filter, p_fast_hash_xxh3_64 (data, len, 0));
+}
+
+P_LIB_API void
+p_bloom_filter_add_hash (PBloomFilter	*filter,
+			 puint64	hash)
+{
+	puint32	*block;
+	puint32	key;
+#if defined (P_BLOOM_FILTER_SSE2)
+	__m128i	lo;
+	__m128i	hi;
+#elif defined (P_BLOOM_FILTER_NEON)
+	uint32x4_t	vkey;
+#else
+	pint	i;
+#endif
+
+	if (P_UNLIKELY (filter == NULL))
+		return;
+
+	hash  = pp_bloom_filter_mix (hash);
+	block = pp_bloom_filter_get_block (filter, hash);
+	key   = (puint32) hash;
+
+#if defined (P_BLOOM_FILTER_SSE2)
+	pp_bloom_filter_make_mask_sse2 (key, &lo, &hi);
+
+	_mm_store_si128 ((__m128i *) block, _mm_or_si128 (_mm_load_si128 ((const __m128i *) block), lo));
+	_mm_store_si128 ((__m128i *) block + 1, _mm_or_si128 (_mm_load_si128 ((const __m128i *) block + 1), hi));
+#elif defined (P_BLOOM_FILTER_NEON)
+	vkey = vdupq_n_u32 (key);
+
+	vst1q_u32 (block, vorrq_u32 (vld1q_u32 (block),
+				     vshlq_u32 (vdupq_n_u32 (1),
+						vreinterpretq_s32_u32 (vshrq_n_u32 (vmulq_u32 (vkey, vld1q_u32 (pp_bloom_filter_salt)), 27)))));
+	vst1q_u32 (block + 4, vorrq_u32 (vld1q_u32 (block + 4),
+					 vshlq_u32 (vdupq_n_u32 (1),
+						    vreinterpretq_s32_u32 (vshrq_n_u32 (vmulq_u32 (vkey, vld1q_u32 (pp_bloom_filter_salt + 4)), 27)))));
+#else
+	for (i = 0; i < P_BLOOM_FILTER_BLOCK_WORDS; ++i)
+		block[i] |= (puint32) 1 << ((key * pp_bloom_filter_salt[i]) >> 27);
+#endif
+}
+
+P_LIB_API pboolean
+p_bloom_filter_contains (const PBloomFilter	*filter,
+			 pconstpointer		data,
+			 psize			len)
+{
+	if (P_UNLIKELY (filter == NULL || (data == NULL && len > 0)))
+		return FALSE;
+
+	return p_bloom_filter_contains_hash (filter, p_fast_hash_xxh3_64 (data, len, 0));
+}
+
+P_LIB_API pboolean
+p_bloom_filter_contains_hash (const PBloomFilter	*filter,
+			      puint64			hash)
+{
+	const puint32	*block;
+	puint32		key;
+#if defined (P_BLOOM_FILTER_SSE2)
+	__m128i		lo;
+	__m128i		hi;
+	__m128i		missed;
+#elif defined (P_BLOOM_FILTER_NEON)
+	uint32x4_t	vkey;
+	uint32x4_t	missed;
+#else
+	pint		i;
+#endif
+
+	if (P_UNLIKELY (filter == NULL))
+		return FALSE;
+
+	hash  = pp_bloom_filter_mix (hash);
+	block = pp_bloom_filter_get_block (filter, hash);
+	key   = (puint32) hash;
+
+#if defined (P_BLOOM_FILTER_SSE2)
+	pp_bloom_filter_make_mask_sse2 (key, &lo, &hi);
+
+	missed = _mm_or_si128 (_mm_andnot_si128 (_mm_load_si128 ((const __m128i *) block), lo),
+			       _mm_andnot_si128 (_mm_load_si128 ((const __m128i *) block + 1), hi));
+
+	return _mm_movemask_epi8 (_mm_cmpeq_epi32 (missed, _mm_setzero_si128 ())) == 0xFFFF;
+#elif defined (P_BLOOM_FILTER_NEON)
+	vkey   = vdupq_n_u32 (key);
+	missed = vorrq_u32 (vbicq_u32 (vshlq_u32 (vdupq_n_u32 (1),
+						  vreinterpretq_s32_u32 (vshrq_n_u32 (vmulq_u32 (vkey, vld1q_u32 (pp_bloom_filter_salt)), 27))),
+				       vld1q_u32 (block)),
+			    vbicq_u32 (vshlq_u32 (vdupq_n_u32 (1),
+						  vreinterpretq_s32_u32 (vshrq_n_u32 (vmulq_u32 (vkey, vld1q_u32 (pp_bloom_filter_salt + 4)), 27))),
+				       vld1q_u32 (block + 4)));
+
+	return vmaxvq_u32 (missed) == 0;
+#else
+	for (i = 0; i < P_BLOOM_FILTER_BLOCK_WORDS; ++i) {
+		if ((block[i] & ((puint32) 1 << ((key * pp_bloom_filter_salt[i]) >> 27))) == 0)
+			return FALSE;
+	}
+
+	return TRUE;
+#endif
+}
+
+P_LIB_API void
+p_bloom_filter_clear (PBloomFilter *filter)
+{
+	if (P_UNLIKELY (filter == NULL))
+		return;
+
+	memset (filter->blocks, 0, filter->num_blocks * P_BLOOM_FILTER_BLOCK_SIZE);
+}
+
+P_LIB_API psize
+p_bloom_filter_get_size (const PBloomFilter *filter)
+{
+	if (P_UNLIKELY (filter == NULL))
+		return 0;
+
+	return filter->num_blocks * P_BLOOM_FILTER_BLOCK_SIZE;
+}
+
+P_LIB_API void
+p_bloom_filter_free (PBloomFilter *filter)
+{
+	if (P_UNLIKELY (filter == NULL))
+		return;
+
+	p_free_aligned (filter->blocks);
+	p_free (filter);
+}
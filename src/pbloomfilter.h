@@ -0,0 +1,155 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pbloomfilter.h
+ * @brief Blocked Bloom filter
+ * @author Alexander Saprykin
+ *
+ * A Bloom filter answers whether an item may be in a set using a few bits per
+ * item. It never gives false negatives: for every added item the answer is
+ * positive. An item which was not added is reported as present with a small
+ * probability (false positive rate) chosen on creation. Put a filter in front
+ * of a large hash table, an on-disk index or a remote call to skip the
+ * expensive lookups of the missing keys.
+ *
+ * #PBloomFilter is a split block Bloom filter: the bit array is divided into
+ * blocks of 256 bits (eight 32-bit words), the hash value of an item selects a
+ * single block and one bit is set in each of its words. Thus every lookup
+ * touches exactly one cache line, and the eight bit positions are computed and
+ * checked in parallel with SSE2 on x86 and with NEON on ARMv8 targets. The
+ * results are the same on any platform.
+ *
+ * Use p_bloom_filter_new() with the expected number of items and the target
+ * false positive rate to create a filter of a suitable size. The real rate
+ * grows if more items are added. Items are hashed with p_fast_hash_xxh3_64(),
+ * or a hash value computed elsewhere (i.e. for a hash table lookup) can be
+ * passed into p_bloom_filter_add_hash() and p_bloom_filter_contains_hash()
+ * instead to avoid hashing the key twice.
+ *
+ * Items can't be removed from a Bloom filter, use #PCuckooFilter if deletions
+ * are required. A filter is not thread-safe for concurrent additions, while
+ * concurrent lookups are safe.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PBLOOMFILTER_H
+#define PLIBSYS_HEADER_PBLOOMFILTER_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+
+P_BEGIN_DECLS
+
+/** Bloom filter opaque data structure. */
+typedef struct PBloomFilter_ PBloomFilter;
+
+/**
+ * @brief Creates a new Bloom filter.
+ * @param expected_items Number of items expected to be added.
+ * @param false_positive_rate Target false positive rate, must be greater than
+ * 0 and less than 1 (i.e. 0.01 for 1%).
+ * @return Pointer to a newly created #PBloomFilter in case of success, NULL
+ * otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API PBloomFilter *	p_bloom_filter_new		(psize			expected_items,
+								 pdouble		false_positive_rate);
+
+/**
+ * @brief Adds an item to a Bloom filter.
+ * @param filter Bloom filter to add the item to.
+ * @param data Item data.
+ * @param len Length of @a data in bytes.
+ * @since 0.0.5
+ */
+P_LIB_API void			p_bloom_filter_add		(PBloomFilter		*filter,
+								 pconstpointer		data,
+								 psize			len);
+
+/**
+ * @brief Adds an item to a Bloom filter by its hash value.
+ * @param filter Bloom filter to add the item to.
+ * @param hash 64-bit hash value of the item.
+ * @since 0.0.5
+ *
+ * The hash value is mixed once more, so a weaker hash function may be used as
+ * well. Use the same function for the lookups.
+ */
+P_LIB_API void			p_bloom_filter_add_hash		(PBloomFilter		*filter,
+								 puint64		hash);
+
+/**
+ * @brief Checks whether an item may be in a Bloom filter.
+ * @param filter Bloom filter to check.
+ * @param data Item data.
+ * @param len Length of @a data in bytes.
+ * @return FALSE if the item was definitely not added, TRUE if it was added or
+ * in case of a false positive.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean		p_bloom_filter_contains		(const PBloomFilter	*filter,
+								 pconstpointer		data,
+								 psize			len);
+
+/**
+ * @brief Checks whether an item may be in a Bloom filter by its hash value.
+ * @param filter Bloom filter to check.
+ * @param hash 64-bit hash value of the item.
+ * @return FALSE if the item was definitely not added, TRUE if it was added or
+ * in case of a false positive.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean		p_bloom_filter_contains_hash	(const PBloomFilter	*filter,
+								 puint64		hash);
+
+/**
+ * @brief Removes all the items from a Bloom filter.
+ * @param filter Bloom filter to clear.
+ * @since 0.0.5
+ */
+P_LIB_API void			p_bloom_filter_clear		(PBloomFilter		*filter);
+
+/**
+ * @brief Gets the size of a Bloom filter bit array.
+ * @param filter Bloom filter to check.
+ * @return Size of the bit array in bytes.
+ * @since 0.0.5
+ */
+P_LIB_API psize			p_bloom_filter_get_size		(const PBloomFilter	*filter);
+
+/**
+ * @brief Frees a Bloom filter.
+ * @param filter Bloom filter to free.
+ * @since 0.0.5
+ */
+P_LIB_API void			p_bloom_filter_free		(PBloomFilter		*filter);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PBLOOMFILTER_H */
@@ -0,0 +1,592 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Every shard keeps its pairs in two intrusive structures at once: a chained
+ * hash index and a doubly linked recency list with the newest pair at the
+ * head. Both are updated in O(1) time, and a pair costs a single allocation.
+ *
+ * SIEVE keeps the list in the insertion order and moves the hand from the
+ * tail towards the head, see "SIEVE is Simpler than LRU" (Zhang et al.,
+ * NSDI 2024). */
+
+#include "pmem.h"
+#include "pmutex.h"
+#include "phashtable.h"
+#include "pcache.h"
+
+#define P_CACHE_MIN_BUCKETS	16
+#define P_CACHE_MAX_SHARDS	4096
+
+typedef struct PCacheEntry_ PCacheEntry;
+
+struct PCacheEntry_ {
+	PCacheEntry	*hash_next;
+	PCacheEntry	*prev;
+	PCacheEntry	*next;
+	ppointer	key;
+	ppointer	value;
+	psize		cost;
+	puint		hash;
+	pboolean	visited;
+};
+
+/* Shards are written on every access, keep them on separate cache lines */
+typedef struct PCacheShard_ {
+	P_CACHE_ALIGNED PMutex	*lock;
+	PCacheEntry	**buckets;
+	psize		num_buckets;
+	PCacheEntry	*head;
+	PCacheEntry	*tail;
+	PCacheEntry	*hand;
+	psize		count;
+	psize		cost;
+} PCacheShard;
+
+struct PCache_ {
+	PCacheShard	*shards;
+	psize		shards_count;
+	puint		shards_shift;
+	PCachePolicy	policy;
+	psize		max_count;
+	psize		max_cost;
+	PHashFunc	hash_func;
+	PEqualFunc	equal_func;
+	PDestroyFunc	key_destroy;
+	PDestroyFunc	value_destroy;
+	PCacheEvictFunc	evict_func;
+	ppointer	evict_data;
+};
+
+static puint pp_cache_hash (const PCache *cache, pconstpointer key);
+static PCacheShard * pp_cache_get_shard (const PCache *cache, puint hash);
+static void pp_cache_lock (PCacheShard *shard);
+static void pp_cache_unlock (PCacheShard *shard);
+static PCacheEntry * pp_cache_find (const PCache *cache, const PCacheShard *shard, pconstpointer key, puint hash);
+static pboolean pp_cache_grow_buckets (PCacheShard *shard);
+static void pp_cache_list_unlink (PCacheShard *shard, PCacheEntry *entry);
+static void pp_cache_list_push_head (PCacheShard *shard, PCacheEntry *entry);
+static void pp_cache_touch (const PCache *cache, PCacheShard *shard, PCacheEntry *entry);
+static void pp_cache_remove_entry (const PCache *cache, PCacheShard *shard, PCacheEntry *entry);
+static PCacheEntry * pp_cache_select_victim (const PCache *cache, PCacheShard *shard, const PCacheEntry *keep);
+static void pp_cache_evict (const PCache *cache, PCacheShard *shard, const PCacheEntry *keep);
+static void pp_cache_clear_shard (const PCache *cache, PCacheShard *shard);
+
+static puint
+pp_cache_hash (const PCache *cache, pconstpointer key)
+{
+	return cache->hash_func == NULL ? p_direct_hash (key) : cache->hash_func (key);
+}
+
+static PCacheShard *
+pp_cache_get_shard (const PCache *cache, puint hash)
+{
+	if (cache->shards_count == 1)
+		return cache->shards;
+
+	/* Use high bits of a multiplicative mix: buckets inside the shard are
+	 * selected with low bits of the hash */
+	return cache->shards + ((hash * 0x9E3779B1U) >> cache->shards_shift);
+}
+
+static void
+pp_cache_lock (PCacheShard *shard)
+{
+	if (shard->lock != NULL)
+		p_mutex_lock (shard->lock);
+}
+
+static void
+pp_cache_unlock (PCacheShard *shard)
+{
+	if (shard->lock != NULL)
+		p_mutex_unlock (shard->lock);
+}
+
+static PCacheEntry *
+pp_cache_find (const PCache		*cache,
+	       const PCacheShard	*shard,
+	       pconstpointer		key,
+	       puint			hash)
+{
+	PCacheEntry *entry;
+
+	if (shard->num_buckets == 0)
+		return NULL;
+
+	for (entry = shard->buckets[hash & (shard->num_buckets - 1)]; entry != NULL; entry = entry->hash_next) {
+		if (entry->hash != hash)
+			continue;
+
+		if (cache->equal_func == NULL ? entry->key == key : cache->equal_func (entry->key, key))
+			return entry;
+	}
+
+	return NULL;
+}
+
+static pboolean
+pp_cache_grow_buckets (PCacheShard *shard)
+{
+	PCacheEntry	**new_buckets;
+	PCacheEntry	*entry;
+	PCacheEntry	*next;
+	psize		new_num;
+	psize		i;
+
+	new_num = shard->num_buckets == 0 ? P_CACHE_MIN_BUCKETS : shard->num_buckets * 2;
+
+	if (P_UNLIKELY (new_num > ((psize) -1) / sizeof (PCacheEntry *)))
+		return FALSE;
+
+	if (P_UNLIKELY ((new_buckets = p_malloc0 (new_num * sizeof (PCacheEntry *))) == NULL))
+		return FALSE;
+
+	for (i = 0; i < shard->num_buckets; ++i) {
+		for (entry = shard->buckets[i]; entry != NULL; entry = next) {
+			next = entry->hash_next;
+
+			entry->hash_next = new_buckets[entry->hash & (new_num - 1)];
+			new_buckets[entry->hash & (new_num - 1)] = entry;
+		}
+	}
+
+	p_free (shard->buckets);
+
+	shard->buckets     = new_buckets;
+	shard->num_buckets = new_num;
+
+	return TRUE;
+}
+
+static void
+pp_cache_list_unlink (PCacheShard	*shard,
+		      PCacheEntry	*entry)
+{
+	if (entry->prev != NULL)
+		entry->prev->next = entry->next;
+	else
+		shard->head = entry->next;
+
+	if (entry->next != NULL)
+		entry->next->prev = entry->prev;
+	else
+		shard->tail = entry->prev;
+
+	entry->prev = NULL;
+	entry->next = NULL;
+}
+
+static void
+pp_cache_list_push_head (PCacheShard	*shard,
+			 PCacheEntry	*entry)
+{
+	entry->prev = NULL;
+	entry->next = shard->head;
+
+	if (shard->head != NULL)
+		shard->head->prev = entry;
+	else
+		shard->tail = entry;
+
+	shard->head = entry;
+}
+
+static void
+pp_cache_touch (const PCache	*cache,
+		PCacheShard	*shard,
+		PCacheEntry	*entry)
+{
+	if (cache->policy == P_CACHE_POLICY_SIEVE) {
+		entry->visited = TRUE;
+		return;
+	}
+
+	if (shard->head == entry)
+		return;
+
+	pp_cache_list_unlink (shard, entry);
+	pp_cache_list_push_head (shard, entry);
+}
+
+static void
+pp_cache_remove_entry (const PCache	*cache,
+		       PCacheShard	*shard,
+		       PCacheEntry	*entry)
+{
+	PCacheEntry **link;
+
+	for (link = &shard->buckets[entry->hash & (shard->num_buckets - 1)]; *link != entry; link = &(*link)->hash_next)
+		;
+
+	*link = entry->hash_next;
+
+	if (shard->hand == entry)
+		shard->hand = entry->prev;
+
+	pp_cache_list_unlink (shard, entry);
+
+	--shard->count;
+	shard->cost -= entry->cost;
+
+	if (cache->key_destroy != NULL)
+		cache->key_destroy (entry->key);
+
+	if (cache->value_destroy != NULL)
+		cache->value_destroy (entry->value);
+
+	p_free (entry);
+}
+
+static PCacheEntry *
+pp_cache_select_victim (const PCache		*cache,
+			PCacheShard		*shard,
+			const PCacheEntry	*keep)
+{
+	PCacheEntry *entry;
+
+	if (cache->policy == P_CACHE_POLICY_LRU)
+		return shard->tail != keep ? shard->tail : shard->tail->prev;
+
+	/* Every pair is passed at most twice: the first pass clears the visited
+	 * marks, so the hand stops on the second one at the latest */
+	if (shard->head == shard->tail && shard->head == keep)
+		return NULL;
+
+	entry = shard->hand != NULL ? shard->hand : shard->tail;
+
+	while (entry == keep || entry->visited) {
+		entry->visited = FALSE;
+		entry = entry->prev != NULL ? entry->prev : shard->tail;
+	}
+
+	/* Removal moves the hand one step further */
+	shard->hand = entry;
+
+	return entry;
+}
+
+static void
+pp_cache_evict (const PCache		*cache,
+		PCacheShard		*shard,
+		const PCacheEntry	*keep)
+{
+	PCacheEntry *victim;
+
+	while ((cache->max_count > 0 && shard->count > cache->max_count) ||
+	       (cache->max_cost > 0 && shard->cost > cache->max_cost)) {
+		if (P_UNLIKELY ((victim = pp_cache_select_victim (cache, shard, keep)) == NULL))
+			break;
+
+		if (cache->evict_func != NULL)
+			cache->evict_func (victim->key, victim->value, cache->evict_data);
+
+		pp_cache_remove_entry (cache, shard, victim);
+	}
+}
+
+static void
+pp_cache_clear_shard (const PCache	*cache,
+		      PCacheShard	*shard)
+{
+	while (shard->head != NULL)
+		pp_cache_remove_entry (cache, shard, shard->head);
+
+	shard->hand = NULL;
+}
+
+P_LIB_API PCache *
+p_cache_new (psize max_count)
+{
+	return p_cache_new_full (P_CACHE_POLICY_LRU, max_count, 0, 0, NULL, NULL, NULL, NULL);
+}
+
+P_LIB_API PCache *
+p_cache_new_full (PCachePolicy	policy,
+		  psize		max_count,
+		  psize		max_cost,
+		  psize		shards,
+		  PHashFunc	hash_func,
+		  PEqualFunc	equal_func,
+		  PDestroyFunc	key_destroy,
+		  PDestroyFunc	value_destroy)
+{
+	PCache	*ret;
+	psize	count;
+	puint	bits;
+	psize	i;
+
+	if (P_UNLIKELY (max_count == 0 && max_cost == 0))
+		return NULL;
+
+	if (P_UNLIKELY (policy != P_CACHE_POLICY_LRU && policy != P_CACHE_POLICY_SIEVE))
+		return NULL;
+
+	if (shards > P_CACHE_MAX_SHARDS)
+		shards = P_CACHE_MAX_SHARDS;
+
+	for (count = 1, bits = 0; count < shards; count <<= 1, ++bits)
+		;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PCache))) == NULL)) {
+		P_ERROR ("PCache::p_cache_new_full: failed(1) to allocate memory");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret->shards = p_malloc0_aligned (count * sizeof (PCacheShard), P_CACHE_LINE_SIZE)) == NULL)) {
+		P_ERROR ("PCache::p_cache_new_full: failed(2) to allocate memory");
+		p_free (ret);
+		return NULL;
+	}
+
+	ret->shards_count  = count;
+	ret->shards_shift  = 32 - bits;
+	ret->policy        = policy;
+	ret->max_count     = max_count / count + (max_count % count != 0 ? 1 : 0);
+	ret->max_cost      = max_cost / count + (max_cost % count != 0 ? 1 : 0);
+	ret->hash_func     = hash_func;
+	ret->equal_func    = equal_func;
+	ret->key_destroy   = key_destroy;
+	ret->value_destroy = value_destroy;
+
+	if (shards == 0)
+		return ret;
+
+	for (i = 0; i < count; ++i) {
+		if (P_UNLIKELY ((ret->shards[i].lock = p_mutex_new ()) == NULL)) {
+			P_ERROR ("PCache::p_cache_new_full: failed to initialize shard");
+			p_cache_free (ret);
+			return NULL;
+		}
+	}
+
+	return ret;
+}
+
+P_LIB_API void
+p_cache_set_evict_func (PCache		*cache,
+			PCacheEvictFunc	func,
+			ppointer	user_data)
+{
+	if (P_UNLIKELY (cache == NULL))
+		return;
+
+	cache->evict_func = func;
+	cache->evict_data = user_data;
+}
+
+P_LIB_API pboolean
+p_cache_insert (PCache		*cache,
+		ppointer	key,
+		ppointer	value,
+		psize		cost)
+{
+	PCacheShard	*shard;
+	PCacheEntry	*entry;
+	puint		hash;
+
+	if (P_UNLIKELY (cache == NULL))
+		return FALSE;
+
+	if (P_UNLIKELY (cache->max_cost > 0 && cost > cache->max_cost))
+		return FALSE;
+
+	hash  = pp_cache_hash (cache, key);
+	shard = pp_cache_get_shard (cache, hash);
+
+	pp_cache_lock (shard);
+
+	if ((entry = pp_cache_find (cache, shard, key, hash)) != NULL) {
+		if (cache->key_destroy != NULL && entry->key != key)
+			cache->key_destroy (entry->key);
+
+		if (cache->value_destroy != NULL && entry->value != value)
+			cache->value_destroy (entry->value);
+
+		shard->cost  = shard->cost - entry->cost + cost;
+		entry->key   = key;
+		entry->value = value;
+		entry->cost  = cost;
+
+		pp_cache_touch (cache, shard, entry);
+	} else {
+		/* Keep the load factor within one, a failed growth only makes the
+		 * chains longer */
+		if (shard->count >= shard->num_buckets &&
+		    P_UNLIKELY (pp_cache_grow_buckets (shard) == FALSE && shard->num_buckets == 0)) {
+			pp_cache_unlock (shard);
+			P_ERROR ("PCache::p_cache_insert: failed(1) to allocate memory");
+			return FALSE;
+		}
+
+		if (P_UNLIKELY ((entry = p_malloc0 (sizeof (PCacheEntry))) == NULL)) {
+			pp_cache_unlock (shard);
+			P_ERROR ("PCache::p_cache_insert: failed(2) to allocate memory");
+			return FALSE;
+		}
+
+		entry->key   = key;
+		entry->value = value;
+		entry->cost  = cost;
+		entry->hash  = hash;
+
+		entry->hash_next = shard->buckets[hash & (shard->num_buckets - 1)];
+		shard->buckets[hash & (shard->num_buckets - 1)] = entry;
+
+		pp_cache_list_push_head (shard, entry);
+
+		++shard->count;
+		shard->cost += cost;
+	}
+
+	pp_cache_evict (cache, shard, entry);
+
+	pp_cache_unlock (shard);
+
+	return TRUE;
+}
+
+P_LIB_API ppointer
+p_cache_lookup (PCache		*cache,
+		pconstpointer	key)
+{
+	PCacheShard	*shard;
+	PCacheEntry	*entry;
+	ppointer	ret;
+	puint		hash;
+
+	if (P_UNLIKELY (cache == NULL))
+		return (ppointer) (-1);
+
+	hash  = pp_cache_hash (cache, key);
+	shard = pp_cache_get_shard (cache, hash);
+
+	pp_cache_lock (shard);
+
+	if ((entry = pp_cache_find (cache, shard, key, hash)) != NULL) {
+		pp_cache_touch (cache, shard, entry);
+		ret = entry->value;
+	} else
+		ret = (ppointer) (-1);
+
+	pp_cache_unlock (shard);
+
+	return ret;
+}
+
+P_LIB_API pboolean
+p_cache_remove (PCache		*cache,
+		pconstpointer	key)
+{
+	PCacheShard	*shard;
+	PCacheEntry	*entry;
+	puint		hash;
+
+	if (P_UNLIKELY (cache == NULL))
+		return FALSE;
+
+	hash  = pp_cache_hash (cache, key);
+	shard = pp_cache_get_shard (cache, hash);
+
+	pp_cache_lock (shard);
+
+	if ((entry = pp_cache_find (cache, shard, key, hash)) != NULL)
+		pp_cache_remove_entry (cache, shard, entry);
+
+	pp_cache_unlock (shard);
+
+	return entry != NULL;
+}
+
+P_LIB_API psize
+p_cache_get_count (PCache *cache)
+{
+	psize	ret;
+	psize	i;
+
+	if (P_UNLIKELY (cache == NULL))
+		return 0;
+
+	for (i = 0, ret = 0; i < cache->shards_count; ++i) {
+		pp_cache_lock (&cache->shards[i]);
+		ret += cache->shards[i].count;
+		pp_cache_unlock (&cache->shards[i]);
+	}
+
+	return ret;
+}
+
+P_LIB_API psize
+p_cache_get_cost (PCache *cache)
+{
+	psize	ret;
+	psize	i;
+
+	if (P_UNLIKELY (cache == NULL))
+		return 0;
+
+	for (i = 0, ret = 0; i < cache->shards_count; ++i) {
+		pp_cache_lock (&cache->shards[i]);
+		ret += cache->shards[i].cost;
+		pp_cache_unlock (&cache->shards[i]);
+	}
+
+	return ret;
+}
+
+P_LIB_API void
+p_cache_clear (PCache *cache)
+{
+	psize i;
+
+	if (P_UNLIKELY (cache == NULL))
+		return;
+
+	for (i = 0; i < cache->shards_count; ++i) {
+		pp_cache_lock (&cache->shards[i]);
+		pp_cache_clear_shard (cache, &cache->shards[i]);
+		pp_cache_unlock (&cache->shards[i]);
+	}
+}
+
+P_LIB_API void
+p_cache_free (PCache *cache)
+{
+	psize i;
+
+	if (P_UNLIKELY (cache == NULL))
+		return;
+
+	for (i = 0; i < cache->shards_count; ++i) {
+		pp_cache_clear_shard (cache, &cache->shards[i]);
+
+		p_free (cache->shards[i].buckets);
+
+		if (cache->shards[i].lock != NULL)
+			p_mutex_free (cache->shards[i].lock);
+	}
+
+	p_free_aligned (cache->shards);
+	p_free (cache);
+}
@@ -0,0 +1,237 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pcache.h
+ * @brief Bounded cache
+ * @author Alexander Saprykin
+ *
+ * A cache maps keys to values like #PHashTable, but holds a limited amount of
+ * data: when a new pair exceeds the limit, the pairs which are least likely to
+ * be needed again are evicted. The limit is set as a maximum number of pairs,
+ * a maximum total cost (i.e. the memory size of the values given on
+ * insertion), or both. Lookups, insertions, removals and evictions take O(1)
+ * time.
+ *
+ * Two eviction policies are supported:
+ * - #P_CACHE_POLICY_LRU evicts the least recently used pair. Every hit moves
+ * the pair to the front of the recency list.
+ * - #P_CACHE_POLICY_SIEVE only marks a pair as visited on a hit, and the
+ * eviction hand sweeps from the oldest pairs to the newer ones, evicting the
+ * first pair which was not visited since the previous sweep. Hits never
+ * reorder the list, which makes them cheaper, and SIEVE usually gives a better
+ * hit ratio than LRU for the web-like workloads where many keys are requested
+ * only once.
+ *
+ * An eviction callback can be set with p_cache_set_evict_func() to write the
+ * evicted data back or to count the evictions. It is called only when a pair
+ * is evicted to satisfy the limits, not on a removal or a replacement.
+ *
+ * A cache created with p_cache_new() is not thread-safe. Pass a non-zero
+ * number of shards to p_cache_new_full() to get a thread-safe cache: the keys
+ * are split over the shards, each one with its own lock, recency list and an
+ * even part of the limits, so the threads working with the keys from different
+ * shards do not contend. The eviction is per shard, so the policy is applied
+ * approximately in this mode. As with #PConcurrentHashTable, the values
+ * returned by the lookup can be evicted by another thread at any moment, so
+ * take care about the values lifetime (i.e. use reference counted values with
+ * a value destroy function dropping a reference).
+ *
+ * Keys and values are stored only as pointers, provide the destroy functions
+ * to p_cache_new_full() to free them on the removal.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PCACHE_H
+#define PLIBSYS_HEADER_PCACHE_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+
+P_BEGIN_DECLS
+
+/** Cache opaque data structure. */
+typedef struct PCache_ PCache;
+
+/** Cache eviction policies. */
+typedef enum PCachePolicy_ {
+	P_CACHE_POLICY_LRU	= 0,	/**< Least recently used pair is evicted.		*/
+	P_CACHE_POLICY_SIEVE	= 1	/**< Not visited pair is found with a sweeping hand.	*/
+} PCachePolicy;
+
+/**
+ * @brief Cache eviction callback.
+ * @param key Key of the evicted pair.
+ * @param value Value of the evicted pair.
+ * @param user_data Data passed to p_cache_set_evict_func().
+ *
+ * The callback is called before the destroy functions of the key and the
+ * value. In a thread-safe cache it is called with the shard lock held, so it
+ * must not call the cache functions.
+ */
+typedef void (*PCacheEvictFunc) (ppointer key, ppointer value, ppointer user_data);
+
+/**
+ * @brief Creates a new LRU cache with pointer keys.
+ * @param max_count Maximum number of pairs, must be greater than zero.
+ * @return Pointer to a newly created #PCache in case of success, NULL
+ * otherwise.
+ * @since 0.0.5
+ *
+ * Keys are hashed and compared as pointers, the cache is not thread-safe.
+ */
+P_LIB_API PCache *	p_cache_new		(psize			max_count);
+
+/**
+ * @brief Creates a new cache with custom parameters.
+ * @param policy Eviction policy.
+ * @param max_count Maximum number of pairs, 0 for no limit.
+ * @param max_cost Maximum total cost of the pairs, 0 for no limit.
+ * @param shards Number of the independently locked shards for a thread-safe
+ * cache, 0 for a cache without locking. It is rounded up to the nearest power
+ * of two.
+ * @param hash_func Function to calculate a hash value of a key, if NULL then
+ * keys are hashed as pointers.
+ * @param equal_func Function to check two keys for equality, if NULL then keys
+ * are compared as pointers.
+ * @param key_destroy Function to call on every key before its removal from the
+ * cache, maybe NULL.
+ * @param value_destroy Function to call on every value before its removal from
+ * the cache, maybe NULL.
+ * @return Pointer to a newly created #PCache in case of success, NULL
+ * otherwise.
+ * @since 0.0.5
+ *
+ * At least one of @a max_count and @a max_cost must be set. With several
+ * shards every shard gets an equal part of the limits (rounded up).
+ */
+P_LIB_API PCache *	p_cache_new_full	(PCachePolicy		policy,
+						 psize			max_count,
+						 psize			max_cost,
+						 psize			shards,
+						 PHashFunc		hash_func,
+						 PEqualFunc		equal_func,
+						 PDestroyFunc		key_destroy,
+						 PDestroyFunc		value_destroy);
+
+/**
+ * @brief Sets a cache eviction callback.
+ * @param cache Cache to set the callback for.
+ * @param func Eviction callback, NULL to remove it.
+ * @param user_data Data to pass into @a func.
+ * @since 0.0.5
+ * @note Set the callback before the cache is shared between threads.
+ */
+P_LIB_API void		p_cache_set_evict_func	(PCache			*cache,
+						 PCacheEvictFunc	func,
+						 ppointer		user_data);
+
+/**
+ * @brief Inserts a new key-value pair into a cache.
+ * @param cache Cache to insert the pair into.
+ * @param key Key to insert.
+ * @param value Value to insert.
+ * @param cost Cost of the pair, counted against the maximum cost.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * If the key already exists, its key and value are replaced (the destroy
+ * functions are called on the old ones) and the pair counts as used. Other
+ * pairs are evicted if the limits are exceeded, but never the inserted one.
+ * The insertion fails if the @a cost alone is greater than the maximum cost
+ * (of a shard), the cache takes no ownership of the @a key and the @a value
+ * in case of a failure.
+ */
+P_LIB_API pboolean	p_cache_insert		(PCache			*cache,
+						 ppointer		key,
+						 ppointer		value,
+						 psize			cost);
+
+/**
+ * @brief Searches for a key in a cache.
+ * @param cache Cache to lookup in.
+ * @param key Key to lookup for.
+ * @return Value related to the key (can be NULL), (#ppointer) -1 if the key
+ * was not found.
+ * @since 0.0.5
+ *
+ * A found pair counts as used.
+ */
+P_LIB_API ppointer	p_cache_lookup		(PCache			*cache,
+						 pconstpointer		key);
+
+/**
+ * @brief Removes a key from a cache.
+ * @param cache Cache to remove the key from.
+ * @param key Key to remove.
+ * @return TRUE if the key was removed, FALSE if it was not found.
+ * @since 0.0.5
+ *
+ * The eviction callback is not called.
+ */
+P_LIB_API pboolean	p_cache_remove		(PCache			*cache,
+						 pconstpointer		key);
+
+/**
+ * @brief Gets the number of pairs in a cache.
+ * @param cache Cache to check.
+ * @return Number of the pairs.
+ * @since 0.0.5
+ */
+P_LIB_API psize		p_cache_get_count	(PCache			*cache);
+
+/**
+ * @brief Gets the total cost of the pairs in a cache.
+ * @param cache Cache to check.
+ * @return Total cost of the pairs.
+ * @since 0.0.5
+ */
+P_LIB_API psize		p_cache_get_cost	(PCache			*cache);
+
+/**
+ * @brief Removes all the pairs from a cache.
+ * @param cache Cache to clear.
+ * @since 0.0.5
+ *
+ * The eviction callback is not called.
+ */
+P_LIB_API void		p_cache_clear		(PCache			*cache);
+
+/**
+ * @brief Frees a cache.
+ * @param cache Cache to free.
+ * @since 0.0.5
+ *
+ * The destroy functions are called for all the pairs, the eviction callback
+ * is not.
+ */
+P_LIB_API void		p_cache_free		(PCache			*cache);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PCACHE_H */
@@ -0,0 +1,581 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Read-mostly hash table: readers never take a lock, writers are serialized
+ * with a mutex.
+ *
+ * The table is an array of buckets with singly linked chains of nodes. Bucket
+ * heads and node links are published with atomic pointer stores, and a node
+ * is never modified after it becomes visible to readers (except its link):
+ * replacing a value means publishing a new node instead of the old one. The
+ * whole bucket array is replaced with a fresh copy on resize.
+ *
+ * Unlinked nodes and arrays are put into a retire list and freed after a grace
+ * period: every reader announces itself in one of two reader counter sets
+ * (selected by the current phase), a writer flips the phase and waits until
+ * all the readers of the previous phase leave. Counters are sharded over
+ * several cache lines by the thread ID, so readers on different cores do not
+ * bounce the same cache line.
+ *
+ * Nodes are carved from slabs, reclaimed nodes go to a free list and are
+ * reused by the next insertions, so under churn the global allocator is mostly
+ * avoided. Slabs are released all at once when the table is freed. All the
+ * slab operations are performed by writers with the mutex being held. */
+
+#include "pmem.h"
+#include "patomic.h"
+#include "phashtable.h"
+#include "pmutex.h"
+#include "puthread.h"
+#include "pconcurrenthashtable-readmostly.h"
+
+typedef struct PReadMostlyNode_ {
+	struct PReadMostlyNode_	*next;
+	struct PReadMostlyNode_	*retired_next;
+	ppointer		key;
+	ppointer		value;
+	puint			hash;
+	pboolean		owns_data;
+} PReadMostlyNode;
+
+typedef struct PReadMostlyBuckets_ {
+	struct PReadMostlyBuckets_	*retired_next;
+	psize				size;
+	PReadMostlyNode			*heads[1];
+} PReadMostlyBuckets;
+
+/* Number of reader counter shards per phase, power of two */
+#define P_READ_MOSTLY_READER_SHARDS	32
+
+/* Number of retired nodes to reclaim at once */
+#define P_READ_MOSTLY_RETIRE_BATCH	64
+
+/* Initial number of buckets, power of two */
+#define P_READ_MOSTLY_MIN_SIZE		16
+
+/* Number of nodes in a single slab */
+#define P_READ_MOSTLY_SLAB_SIZE		128
+
+typedef struct PReadMostlySlab_ {
+	struct PReadMostlySlab_	*next;
+	psize			used;
+	PReadMostlyNode		nodes[P_READ_MOSTLY_SLAB_SIZE];
+} PReadMostlySlab;
+
+typedef struct PReadMostlyCounter_ {
+	volatile pint	count;
+	pchar		pad[P_CACHE_LINE_SIZE - sizeof (pint)];
+} PReadMostlyCounter;
+
+struct PConcurrentHashTableReadMostly_ {
+	PReadMostlyCounter	readers[2][P_READ_MOSTLY_READER_SHARDS];
+	volatile pint		phase;
+	PReadMostlyBuckets	*buckets;
+	PMutex			*mutex;
+	psize			count;
+	PReadMostlyNode		*retired_nodes;
+	PReadMostlyBuckets	*retired_buckets;
+	psize			retired_count;
+	PReadMostlySlab		*slabs;
+	PReadMostlyNode		*free_nodes;
+	PHashFunc		hash_func;
+	PEqualFunc		equal_func;
+	PDestroyFunc		key_destroy_func;
+	PDestroyFunc		value_destroy_func;
+};
+
+static puint pp_read_mostly_calc_hash (const PConcurrentHashTableReadMostly *table, pconstpointer key);
+static pboolean pp_read_mostly_equal (const PConcurrentHashTableReadMostly *table, pconstpointer a, pconstpointer b);
+static PReadMostlyBuckets * pp_read_mostly_buckets_new (psize size);
+static PReadMostlyNode * pp_read_mostly_node_new (PConcurrentHashTableReadMostly *table, ppointer key, ppointer value, puint hash, PReadMostlyNode *next);
+static void pp_read_mostly_node_free (PConcurrentHashTableReadMostly *table, PReadMostlyNode *node);
+static void pp_read_mostly_node_release (PConcurrentHashTableReadMostly *table, PReadMostlyNode *node);
+static volatile pint * pp_read_mostly_reader_enter (PConcurrentHashTableReadMostly *table);
+static void pp_read_mostly_reader_leave (volatile pint *counter);
+static void pp_read_mostly_synchronize (PConcurrentHashTableReadMostly *table);
+static void pp_read_mostly_reclaim (PConcurrentHashTableReadMostly *table);
+static void pp_read_mostly_retire_node (PConcurrentHashTableReadMostly *table, PReadMostlyNode *node);
+static void pp_read_mostly_grow (PConcurrentHashTableReadMostly *table);
+static ppointer pp_read_mostly_find (PConcurrentHashTableReadMostly *table, pconstpointer key, puint hash);
+
+static puint
+pp_read_mostly_calc_hash (const PConcurrentHashTableReadMostly *table, pconstpointer key)
+{
+	puint hash;
+
+	if (table->hash_func == NULL)
+		return p_direct_hash (key);
+
+	hash  = table->hash_func (key);
+	hash ^= hash >> 16;
+	hash *= 0x45D9F3BU;
+	hash ^= hash >> 16;
+
+	return hash;
+}
+
+static pboolean
+pp_read_mostly_equal (const PConcurrentHashTableReadMostly *table, pconstpointer a, pconstpointer b)
+{
+	return table->equal_func == NULL ? (a == b) : table->equal_func (a, b);
+}
+
+static PReadMostlyBuckets *
+pp_read_mostly_buckets_new (psize size)
+{
+	PReadMostlyBuckets *ret;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PReadMostlyBuckets) +
+					  (size - 1) * sizeof (PReadMostlyNode *))) == NULL))
+		return NULL;
+
+	ret->size = size;
+
+	return ret;
+}
+
+static PReadMostlyNode *
+pp_read_mostly_node_new (PConcurrentHashTableReadMostly	*table,
+			 ppointer			key,
+			 ppointer			value,
+			 puint				hash,
+			 PReadMostlyNode		*next)
+{
+	PReadMostlyNode	*ret;
+	PReadMostlySlab	*slab;
+
+	if (table->free_nodes != NULL) {
+		ret = table->free_nodes;
+		table->free_nodes = ret->retired_next;
+	} else {
+		slab = table->slabs;
+
+		if (slab == NULL || slab->used == P_READ_MOSTLY_SLAB_SIZE) {
+			if (P_UNLIKELY ((slab = p_malloc (sizeof (PReadMostlySlab))) == NULL))
+				return NULL;
+
+			slab->next   = table->slabs;
+			slab->used   = 0;
+			table->slabs = slab;
+		}
+
+		ret = &slab->nodes[slab->used++];
+	}
+
+	ret->next         = next;
+	ret->retired_next = NULL;
+	ret->key          = key;
+	ret->value        = value;
+	ret->hash         = hash;
+	ret->owns_data    = TRUE;
+
+	return ret;
+}
+
+static void
+pp_read_mostly_node_release (PConcurrentHashTableReadMostly *table, PReadMostlyNode *node)
+{
+	node->retired_next = table->free_nodes;
+	table->free_nodes  = node;
+}
+
+static void
+pp_read_mostly_node_free (PConcurrentHashTableReadMostly *table, PReadMostlyNode *node)
+{
+	if (node->owns_data == TRUE) {
+		if (table->key_destroy_func != NULL)
+			table->key_destroy_func (node->key);
+
+		if (table->value_destroy_func != NULL)
+			table->value_destroy_func (node->value);
+	}
+
+	pp_read_mostly_node_release (table, node);
+}
+
+static volatile pint *
+pp_read_mostly_reader_enter (PConcurrentHashTableReadMostly *table)
+{
+	volatile pint	*counter;
+	puint		shard;
+	pint		phase;
+
+	shard = p_direct_hash (p_uthread_current_id ()) & (P_READ_MOSTLY_READER_SHARDS - 1);
+
+	/* Re-check the phase after the announcement: otherwise a writer could
+	 * have flipped it and already checked our counter set to be empty */
+	for (;;) {
+		phase   = p_atomic_int_get (&table->phase) & 1;
+		counter = &table->readers[phase][shard].count;
+
+		p_atomic_int_inc (counter);
+
+		if (P_LIKELY ((p_atomic_int_get (&table->phase) & 1) == phase))
+			return counter;
+
+		p_atomic_int_add (counter, -1);
+	}
+}
+
+static void
+pp_read_mostly_reader_leave (volatile pint *counter)
+{
+	p_atomic_int_add (counter, -1);
+}
+
+static void
+pp_read_mostly_synchronize (PConcurrentHashTableReadMostly *table)
+{
+	pint	phase;
+	pint	i;
+
+	phase = p_atomic_int_get (&table->phase) & 1;
+
+	p_atomic_int_inc (&table->phase);
+
+	for (i = 0; i < P_READ_MOSTLY_READER_SHARDS; ++i) {
+		while (p_atomic_int_get (&table->readers[phase][i].count) != 0)
+			p_uthread_yield ();
+	}
+}
+
+static void
+pp_read_mostly_reclaim (PConcurrentHashTableReadMostly *table)
+{
+	PReadMostlyNode		*node;
+	PReadMostlyBuckets	*buckets;
+
+	if (table->retired_nodes == NULL && table->retired_buckets == NULL)
+		return;
+
+	pp_read_mostly_synchronize (table);
+
+	while (table->retired_nodes != NULL) {
+		node = table->retired_nodes;
+		table->retired_nodes = node->retired_next;
+		pp_read_mostly_node_free (table, node);
+	}
+
+	while (table->retired_buckets != NULL) {
+		buckets = table->retired_buckets;
+		table->retired_buckets = buckets->retired_next;
+		p_free (buckets);
+	}
+
+	table->retired_count = 0;
+}
+
+static void
+pp_read_mostly_retire_node (PConcurrentHashTableReadMostly *table, PReadMostlyNode *node)
+{
+	node->retired_next   = table->retired_nodes;
+	table->retired_nodes = node;
+
+	if (++table->retired_count >= P_READ_MOSTLY_RETIRE_BATCH)
+		pp_read_mostly_reclaim (table);
+}
+
+static void
+pp_read_mostly_grow (PConcurrentHashTableReadMostly *table)
+{
+	PReadMostlyBuckets	*old_buckets;
+	PReadMostlyBuckets	*new_buckets;
+	PReadMostlyNode		*node;
+	PReadMostlyNode		*next_node;
+	PReadMostlyNode		*new_node;
+	psize			mask;
+	psize			i;
+
+	old_buckets = table->buckets;
+
+	if (P_UNLIKELY ((new_buckets = pp_read_mostly_buckets_new (old_buckets->size * 2)) == NULL))
+		return;
+
+	mask = new_buckets->size - 1;
+
+	/* Readers may still walk the old chains, so copy the nodes instead of
+	 * relinking them */
+	for (i = 0; i < old_buckets->size; ++i) {
+		for (node = old_buckets->heads[i]; node != NULL; node = node->next) {
+			new_node = pp_read_mostly_node_new (table,
+							    node->key,
+							    node->value,
+							    node->hash,
+							    new_buckets->heads[node->hash & mask]);
+
+			if (P_UNLIKELY (new_node == NULL))
+				break;
+
+			new_buckets->heads[node->hash & mask] = new_node;
+		}
+
+		if (P_UNLIKELY (node != NULL))
+			break;
+	}
+
+	if (P_UNLIKELY (i < old_buckets->size)) {
+		for (i = 0; i < new_buckets->size; ++i) {
+			for (node = new_buckets->heads[i]; node != NULL; node = next_node) {
+				next_node = node->next;
+				pp_read_mostly_node_release (table, node);
+			}
+		}
+
+		p_free (new_buckets);
+		return;
+	}
+
+	p_atomic_pointer_set (&table->buckets, new_buckets);
+
+	/* The data now belongs to the copies */
+	for (i = 0; i < old_buckets->size; ++i) {
+		for (node = old_buckets->heads[i]; node != NULL; node = node->next) {
+			node->owns_data      = FALSE;
+			node->retired_next   = table->retired_nodes;
+			table->retired_nodes = node;
+		}
+	}
+
+	old_buckets->retired_next = table->retired_buckets;
+	table->retired_buckets    = old_buckets;
+
+	pp_read_mostly_reclaim (table);
+}
+
+static ppointer
+pp_read_mostly_find (PConcurrentHashTableReadMostly *table, pconstpointer key, puint hash)
+{
+	PReadMostlyBuckets	*buckets;
+	PReadMostlyNode		*node;
+	volatile pint		*counter;
+	ppointer		ret = (ppointer) -1;
+
+	counter = pp_read_mostly_reader_enter (table);
+
+	buckets = p_atomic_pointer_get (&table->buckets);
+	node    = p_atomic_pointer_get (&buckets->heads[hash & (buckets->size - 1)]);
+
+	for (; node != NULL; node = p_atomic_pointer_get (&node->next)) {
+		if (node->hash == hash && pp_read_mostly_equal (table, node->key, key)) {
+			ret = node->value;
+			break;
+		}
+	}
+
+	pp_read_mostly_reader_leave (counter);
+
+	return ret;
+}
+
+PConcurrentHashTableReadMostly *
+p_concurrent_hash_table_read_mostly_new (PHashFunc	hash_func,
+					 PEqualFunc	equal_func,
+					 PDestroyFunc	key_destroy,
+					 PDestroyFunc	value_destroy)
+{
+	PConcurrentHashTableReadMostly *ret;
+
+	/* Aligned so every reader counter takes a single cache line */
+	if (P_UNLIKELY ((ret = p_malloc0_aligned (sizeof (PConcurrentHashTableReadMostly),
+						  P_CACHE_LINE_SIZE)) == NULL))
+		return NULL;
+
+	if (P_UNLIKELY ((ret->buckets = pp_read_mostly_buckets_new (P_READ_MOSTLY_MIN_SIZE)) == NULL)) {
+		p_free_aligned (ret);
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret->mutex = p_mutex_new ()) == NULL)) {
+		p_free (ret->buckets);
+		p_free_aligned (ret);
+		return NULL;
+	}
+
+	ret->hash_func          = hash_func == p_direct_hash ? NULL : hash_func;
+	ret->equal_func         = equal_func == p_direct_equal ? NULL : equal_func;
+	ret->key_destroy_func   = key_destroy;
+	ret->value_destroy_func = value_destroy;
+
+	return ret;
+}
+
+void
+p_concurrent_hash_table_read_mostly_insert (PConcurrentHashTableReadMostly	*table,
+					    ppointer				key,
+					    ppointer				value)
+{
+	PReadMostlyNode	**link;
+	PReadMostlyNode	*node;
+	PReadMostlyNode	*new_node;
+	psize		idx;
+	puint		hash;
+
+	hash = pp_read_mostly_calc_hash (table, key);
+
+	p_mutex_lock (table->mutex);
+
+	idx  = hash & (table->buckets->size - 1);
+	link = &table->buckets->heads[idx];
+
+	for (node = *link; node != NULL; link = &node->next, node = node->next) {
+		if (node->hash == hash && pp_read_mostly_equal (table, node->key, key))
+			break;
+	}
+
+	/* Either replace the node as a whole (readers may still use the old one),
+	 * or insert a new one in front of the chain */
+	new_node = pp_read_mostly_node_new (table,
+					    key,
+					    value,
+					    hash,
+					    node != NULL ? node->next : table->buckets->heads[idx]);
+
+	if (P_UNLIKELY (new_node == NULL)) {
+		p_mutex_unlock (table->mutex);
+		P_ERROR ("PConcurrentHashTable::p_concurrent_hash_table_insert: failed to allocate memory");
+		return;
+	}
+
+	if (node != NULL) {
+		p_atomic_pointer_set (link, new_node);
+		pp_read_mostly_retire_node (table, node);
+	} else {
+		p_atomic_pointer_set (&table->buckets->heads[idx], new_node);
+
+		if (++table->count > table->buckets->size)
+			pp_read_mostly_grow (table);
+	}
+
+	p_mutex_unlock (table->mutex);
+}
+
+ppointer
+p_concurrent_hash_table_read_mostly_lookup (PConcurrentHashTableReadMostly	*table,
+					    pconstpointer			key)
+{
+	return pp_read_mostly_find (table, key, pp_read_mostly_calc_hash (table, key));
+}
+
+ppointer
+p_concurrent_hash_table_read_mostly_lookup_or_insert (PConcurrentHashTableReadMostly	*table,
+						      ppointer				key,
+						      ppointer				value)
+{
+	PReadMostlyNode	*node;
+	ppointer	ret;
+	puint		hash;
+	psize		idx;
+
+	hash = pp_read_mostly_calc_hash (table, key);
+
+	if ((ret = pp_read_mostly_find (table, key, hash)) != (ppointer) -1)
+		return ret;
+
+	p_mutex_lock (table->mutex);
+
+	idx = hash & (table->buckets->size - 1);
+
+	for (node = table->buckets->heads[idx]; node != NULL; node = node->next) {
+		if (node->hash == hash && pp_read_mostly_equal (table, node->key, key)) {
+			p_mutex_unlock (table->mutex);
+			return node->value;
+		}
+	}
+
+	if (P_UNLIKELY ((node = pp_read_mostly_node_new (table, key, value, hash, table->buckets->heads[idx])) == NULL)) {
+		p_mutex_unlock (table->mutex);
+		P_ERROR ("PConcurrentHashTable::p_concurrent_hash_table_lookup_or_insert: failed to allocate memory");
+		return (ppointer) -1;
+	}
+
+	p_atomic_pointer_set (&table->buckets->heads[idx], node);
+
+	if (++table->count > table->buckets->size)
+		pp_read_mostly_grow (table);
+
+	p_mutex_unlock (table->mutex);
+
+	return (ppointer) -1;
+}
+
+void
+p_concurrent_hash_table_read_mostly_remove (PConcurrentHashTableReadMostly	*table,
+					    pconstpointer			key)
+{
+	PReadMostlyNode	**link;
+	PReadMostlyNode	*node;
+	puint		hash;
+
+	hash = pp_read_mostly_calc_hash (table, key);
+
+	p_mutex_lock (table->mutex);
+
+	link = &table->buckets->heads[hash & (table->buckets->size - 1)];
+
+	for (node = *link; node != NULL; link = &node->next, node = node->next) {
+		if (node->hash == hash && pp_read_mostly_equal (table, node->key, key)) {
+			/* The removed node keeps its link for the current readers */
+			p_atomic_pointer_set (link, node->next);
+			--table->count;
+			pp_read_mostly_retire_node (table, node);
+			break;
+		}
+	}
+
+	p_mutex_unlock (table->mutex);
+}
+
+void
+p_concurrent_hash_table_read_mostly_free (PConcurrentHashTableReadMostly *table)
+{
+	PReadMostlyNode	*node;
+	PReadMostlyNode	*next_node;
+	PReadMostlySlab	*slab;
+	psize		i;
+
+	if (table->buckets != NULL) {
+		for (i = 0; i < table->buckets->size; ++i) {
+			for (node = table->buckets->heads[i]; node != NULL; node = next_node) {
+				next_node = node->next;
+				pp_read_mostly_node_free (table, node);
+			}
+		}
+
+		p_free (table->buckets);
+	}
+
+	pp_read_mostly_reclaim (table);
+
+	while (table->slabs != NULL) {
+		slab = table->slabs;
+		table->slabs = slab->next;
+		p_free (slab);
+	}
+
+	if (table->mutex != NULL)
+		p_mutex_free (table->mutex);
+
+	p_free_aligned (table);
+}
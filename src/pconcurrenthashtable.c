@@ -0,0 +1,284 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Concurrent hash table is organized as a fixed array of segments, each one
+ * is a regular PHashTable protected by its own read-write lock. A segment is
+ * selected by the high bits of the key hash, while the segment table itself
+ * uses low bits to find the slot.
+ *
+ * In the read-mostly mode all the work is delegated to the table with
+ * lock-free readers, see pconcurrenthashtable-readmostly.c. */
+
+#include "pmem.h"
+#include "phashtable.h"
+#include "pconcurrenthashtable.h"
+#include "pconcurrenthashtable-readmostly.h"
+#include "prwlock.h"
+#include "puthread.h"
+
+typedef struct PConcurrentHashTableSegment_ {
+	PRWLock		*lock;
+	PHashTable	*table;
+} PConcurrentHashTableSegment;
+
+struct PConcurrentHashTable_ {
+	PConcurrentHashTableReadMostly	*read_mostly;
+	PConcurrentHashTableSegment	*segments;
+	psize				segments_count;
+	puint				segments_shift;
+	PHashFunc			hash_func;
+};
+
+/* Number of segments per CPU core when selected automatically */
+#define P_CONCURRENT_HASH_TABLE_SEGMENTS_PER_CPU	4
+
+/* Upper limit for the number of segments */
+#define P_CONCURRENT_HASH_TABLE_MAX_SEGMENTS		4096
+
+static PConcurrentHashTableSegment * pp_concurrent_hash_table_get_segment (const PConcurrentHashTable *table,
+									   pconstpointer		key);
+
+static PConcurrentHashTableSegment *
+pp_concurrent_hash_table_get_segment (const PConcurrentHashTable *table, pconstpointer key)
+{
+	puint hash;
+
+	if (table->segments_count == 1)
+		return table->segments;
+
+	hash = table->hash_func == NULL ? p_direct_hash (key) : table->hash_func (key);
+
+	/* Use high bits of a multiplicative mix: slots inside the segment are
+	 * selected with low bits of the hash */
+	hash *= 0x9E3779B1U;
+
+	return table->segments + (hash >> table->segments_shift);
+}
+
+P_LIB_API PConcurrentHashTable *
+p_concurrent_hash_table_new (void)
+{
+	return p_concurrent_hash_table_new_full (0, NULL, NULL, NULL, NULL);
+}
+
+P_LIB_API PConcurrentHashTable *
+p_concurrent_hash_table_new_full (psize		segments,
+				  PHashFunc	hash_func,
+				  PEqualFunc	equal_func,
+				  PDestroyFunc	key_destroy,
+				  PDestroyFunc	value_destroy)
+{
+	PConcurrentHashTable	*ret;
+	psize			count;
+	puint			bits;
+	psize			i;
+
+	if (segments == 0)
+		segments = (psize) p_uthread_ideal_count () * P_CONCURRENT_HASH_TABLE_SEGMENTS_PER_CPU;
+
+	if (segments > P_CONCURRENT_HASH_TABLE_MAX_SEGMENTS)
+		segments = P_CONCURRENT_HASH_TABLE_MAX_SEGMENTS;
+
+	for (count = 1, bits = 0; count < segments; count <<= 1, ++bits)
+		;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PConcurrentHashTable))) == NULL)) {
+		P_ERROR ("PConcurrentHashTable::p_concurrent_hash_table_new_full: failed(1) to allocate memory");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret->segments = p_malloc0 (count * sizeof (PConcurrentHashTableSegment))) == NULL)) {
+		P_ERROR ("PConcurrentHashTable::p_concurrent_hash_table_new_full: failed(2) to allocate memory");
+		p_free (ret);
+		return NULL;
+	}
+
+	ret->segments_count = count;
+	ret->segments_shift = 32 - bits;
+	ret->hash_func      = hash_func;
+
+	for (i = 0; i < count; ++i) {
+		ret->segments[i].lock  = p_rwlock_new ();
+		ret->segments[i].table = p_hash_table_new_full (hash_func, equal_func, key_destroy, value_destroy);
+
+		if (P_UNLIKELY (ret->segments[i].lock == NULL || ret->segments[i].table == NULL)) {
+			P_ERROR ("PConcurrentHashTable::p_concurrent_hash_table_new_full: failed to initialize segment");
+			p_concurrent_hash_table_free (ret);
+			return NULL;
+		}
+	}
+
+	return ret;
+}
+
+P_LIB_API PConcurrentHashTable *
+p_concurrent_hash_table_new_read_mostly (PHashFunc	hash_func,
+					 PEqualFunc	equal_func,
+					 PDestroyFunc	key_destroy,
+					 PDestroyFunc	value_destroy)
+{
+	PConcurrentHashTable *ret;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PConcurrentHashTable))) == NULL)) {
+		P_ERROR ("PConcurrentHashTable::p_concurrent_hash_table_new_read_mostly: failed(1) to allocate memory");
+		return NULL;
+	}
+
+	ret->read_mostly = p_concurrent_hash_table_read_mostly_new (hash_func,
+								    equal_func,
+								    key_destroy,
+								    value_destroy);
+
+	if (P_UNLIKELY (ret->read_mostly == NULL)) {
+		P_ERROR ("PConcurrentHashTable::p_concurrent_hash_table_new_read_mostly: failed(2) to allocate memory");
+		p_free (ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+P_LIB_API void
+p_concurrent_hash_table_insert (PConcurrentHashTable	*table,
+				ppointer		key,
+				ppointer		value)
+{
+	PConcurrentHashTableSegment *segment;
+
+	if (P_UNLIKELY (table == NULL))
+		return;
+
+	if (table->read_mostly != NULL) {
+		p_concurrent_hash_table_read_mostly_insert (table->read_mostly, key, value);
+		return;
+	}
+
+	segment = pp_concurrent_hash_table_get_segment (table, key);
+
+	p_rwlock_writer_lock (segment->lock);
+	p_hash_table_insert (segment->table, key, value);
+	p_rwlock_writer_unlock (segment->lock);
+}
+
+P_LIB_API ppointer
+p_concurrent_hash_table_lookup (PConcurrentHashTable	*table,
+				pconstpointer		key)
+{
+	PConcurrentHashTableSegment	*segment;
+	ppointer			ret;
+
+	if (P_UNLIKELY (table == NULL))
+		return NULL;
+
+	if (table->read_mostly != NULL)
+		return p_concurrent_hash_table_read_mostly_lookup (table->read_mostly, key);
+
+	segment = pp_concurrent_hash_table_get_segment (table, key);
+
+	p_rwlock_reader_lock (segment->lock);
+	ret = p_hash_table_lookup (segment->table, key);
+	p_rwlock_reader_unlock (segment->lock);
+
+	return ret;
+}
+
+P_LIB_API ppointer
+p_concurrent_hash_table_lookup_or_insert (PConcurrentHashTable	*table,
+					  ppointer		key,
+					  ppointer		value)
+{
+	PConcurrentHashTableSegment	*segment;
+	ppointer			ret;
+
+	if (P_UNLIKELY (table == NULL))
+		return NULL;
+
+	if (table->read_mostly != NULL)
+		return p_concurrent_hash_table_read_mostly_lookup_or_insert (table->read_mostly, key, value);
+
+	segment = pp_concurrent_hash_table_get_segment (table, key);
+
+	/* Most of the calls usually find an existing key, try it with
+	 * a shared lock first */
+	p_rwlock_reader_lock (segment->lock);
+	ret = p_hash_table_lookup (segment->table, key);
+	p_rwlock_reader_unlock (segment->lock);
+
+	if (ret != (ppointer) -1)
+		return ret;
+
+	p_rwlock_writer_lock (segment->lock);
+
+	if ((ret = p_hash_table_lookup (segment->table, key)) == (ppointer) -1)
+		p_hash_table_insert (segment->table, key, value);
+
+	p_rwlock_writer_unlock (segment->lock);
+
+	return ret;
+}
+
+P_LIB_API void
+p_concurrent_hash_table_remove (PConcurrentHashTable	*table,
+				pconstpointer		key)
+{
+	PConcurrentHashTableSegment *segment;
+
+	if (P_UNLIKELY (table == NULL))
+		return;
+
+	if (table->read_mostly != NULL) {
+		p_concurrent_hash_table_read_mostly_remove (table->read_mostly, key);
+		return;
+	}
+
+	segment = pp_concurrent_hash_table_get_segment (table, key);
+
+	p_rwlock_writer_lock (segment->lock);
+	p_hash_table_remove (segment->table, key);
+	p_rwlock_writer_unlock (segment->lock);
+}
+
+P_LIB_API void
+p_concurrent_hash_table_free (PConcurrentHashTable *table)
+{
+	psize i;
+
+	if (P_UNLIKELY (table == NULL))
+		return;
+
+	if (table->read_mostly != NULL)
+		p_concurrent_hash_table_read_mostly_free (table->read_mostly);
+
+	for (i = 0; i < table->segments_count; ++i) {
+		if (table->segments[i].table != NULL)
+			p_hash_table_free (table->segments[i].table);
+
+		if (table->segments[i].lock != NULL)
+			p_rwlock_free (table->segments[i].lock);
+	}
+
+	p_free (table->segments);
+	p_free (table);
+}
@@ -0,0 +1,206 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pconcurrenthashtable.h
+ * @brief Concurrent hash table
+ * @author Alexander Saprykin
+ *
+ * A concurrent hash table is a thread-safe variant of #PHashTable which can be
+ * accessed from several threads at once without any external locking.
+ *
+ * Protecting a #PHashTable with a single global lock serializes all the
+ * threads, and the lock itself becomes a bottleneck on machines with many
+ * cores. #PConcurrentHashTable splits the keys into several independent
+ * segments (lock striping): every segment is an ordinary #PHashTable guarded
+ * by its own read-write lock. Operations on keys which fall into different
+ * segments do not contend at all, and lookups within the same segment share
+ * the lock.
+ *
+ * A number of segments is fixed at the creation time, by default it is
+ * calculated from the number of available CPU cores (see
+ * p_uthread_ideal_count()), but it can be explicitly provided with
+ * p_concurrent_hash_table_new_full().
+ *
+ * For the read-mostly workloads, when lookups outnumber updates by orders of
+ * magnitude, create the table with p_concurrent_hash_table_new_read_mostly().
+ * In this mode readers take no lock at all and never write to the shared
+ * table memory except their own (sharded) reader counter, so the lookup
+ * throughput scales with the number of reader threads. Writers are serialized
+ * with a single mutex, removed pairs are freed (and destroyed) only after all
+ * the readers which could see them leave the table, so updates are much more
+ * expensive than in the default mode.
+ *
+ * Use p_concurrent_hash_table_lookup_or_insert() to atomically check for an
+ * existing key and insert a new pair otherwise, which is impossible to do
+ * with a separate lookup and insert calls without races.
+ *
+ * Note that the values returned by the lookup can be removed by another thread
+ * at any moment, so take care about the values lifetime if some of the threads
+ * remove pairs from the table concurrently.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PCONCURRENTHASHTABLE_H
+#define PLIBSYS_HEADER_PCONCURRENTHASHTABLE_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+
+P_BEGIN_DECLS
+
+/** Opaque data structure for a concurrent hash table. */
+typedef struct PConcurrentHashTable_ PConcurrentHashTable;
+
+/**
+ * @brief Initializes a new concurrent hash table.
+ * @return Pointer to a newly initialized #PConcurrentHashTable structure in
+ * case of success, NULL otherwise.
+ * @since 0.0.5
+ * @note Free with p_concurrent_hash_table_free() after usage.
+ *
+ * Keys are hashed and compared as pointers, the number of segments is selected
+ * automatically.
+ */
+P_LIB_API PConcurrentHashTable *	p_concurrent_hash_table_new		(void);
+
+/**
+ * @brief Initializes a new concurrent hash table with custom parameters.
+ * @param segments Number of independently locked segments, 0 to select it
+ * automatically. It is rounded up to the nearest power of two.
+ * @param hash_func Function to calculate a hash value of a key, if NULL then
+ * keys are hashed as pointers.
+ * @param equal_func Function to check two keys for equality, if NULL then keys
+ * are compared as pointers.
+ * @param key_destroy Function to call on every key before its removal from the
+ * table, maybe NULL.
+ * @param value_destroy Function to call on every value before its removal from
+ * the table, maybe NULL.
+ * @return Pointer to a newly initialized #PConcurrentHashTable structure in
+ * case of success, NULL otherwise.
+ * @since 0.0.5
+ * @note Free with p_concurrent_hash_table_free() after usage.
+ *
+ * Destroy functions are called with the segment lock being held, so they
+ * should not try to access the same table.
+ */
+P_LIB_API PConcurrentHashTable *	p_concurrent_hash_table_new_full	(psize			segments,
+										 PHashFunc		hash_func,
+										 PEqualFunc		equal_func,
+										 PDestroyFunc		key_destroy,
+										 PDestroyFunc		value_destroy);
+
+/**
+ * @brief Initializes a new concurrent hash table with lock-free readers.
+ * @param hash_func Function to calculate a hash value of a key, if NULL then
+ * keys are hashed as pointers.
+ * @param equal_func Function to check two keys for equality, if NULL then keys
+ * are compared as pointers.
+ * @param key_destroy Function to call on every key after its removal from the
+ * table, maybe NULL.
+ * @param value_destroy Function to call on every value after its removal from
+ * the table, maybe NULL.
+ * @return Pointer to a newly initialized #PConcurrentHashTable structure in
+ * case of success, NULL otherwise.
+ * @since 0.0.5
+ * @note Free with p_concurrent_hash_table_free() after usage.
+ *
+ * Lookups in this mode are lock-free, while all the modifications are
+ * serialized. Removed and replaced pairs are destroyed with a delay, after a
+ * grace period, when no reader can access them anymore.
+ */
+P_LIB_API PConcurrentHashTable *	p_concurrent_hash_table_new_read_mostly	(PHashFunc		hash_func,
+										 PEqualFunc		equal_func,
+										 PDestroyFunc		key_destroy,
+										 PDestroyFunc		value_destroy);
+
+/**
+ * @brief Inserts a new key-value pair into a concurrent hash table.
+ * @param table Initialized concurrent hash table.
+ * @param key Key to insert.
+ * @param value Value to insert.
+ * @since 0.0.5
+ *
+ * If the @a key already exists, its key and value are replaced (and destroyed
+ * if the destroy functions were provided).
+ */
+P_LIB_API void				p_concurrent_hash_table_insert		(PConcurrentHashTable	*table,
+										 ppointer		key,
+										 ppointer		value);
+
+/**
+ * @brief Searches for a specifed key in the concurrent hash table.
+ * @param table Concurrent hash table to lookup in.
+ * @param key Key to lookup for.
+ * @return Value related to its key pair (can be NULL), (#ppointer) -1 if no
+ * value was found.
+ * @since 0.0.5
+ */
+P_LIB_API ppointer			p_concurrent_hash_table_lookup		(PConcurrentHashTable	*table,
+										 pconstpointer		key);
+
+/**
+ * @brief Atomically searches for a key and inserts a new pair if it is not
+ * found.
+ * @param table Concurrent hash table to lookup in.
+ * @param key Key to lookup for, and to insert if it is not found.
+ * @param value Value to insert if the @a key is not found.
+ * @return Value already associated with the @a key (can be NULL), (#ppointer)
+ * -1 if the @a key was not found and the new pair was inserted.
+ * @since 0.0.5
+ *
+ * The lookup and insertion are performed as a single operation, so only one
+ * of the concurrent callers with the same key would succeed in insertion. If
+ * the @a key already exists, the table is not modified and the caller keeps
+ * ownership of the passed @a key and @a value.
+ */
+P_LIB_API ppointer			p_concurrent_hash_table_lookup_or_insert	(PConcurrentHashTable	*table,
+										 ppointer		key,
+										 ppointer		value);
+
+/**
+ * @brief Removes @a key from a concurrent hash table.
+ * @param table Concurrent hash table to remove the key from.
+ * @param key Key to remove (if exists).
+ * @since 0.0.5
+ */
+P_LIB_API void				p_concurrent_hash_table_remove		(PConcurrentHashTable	*table,
+										 pconstpointer		key);
+
+/**
+ * @brief Frees a previously initialized #PConcurrentHashTable.
+ * @param table Concurrent hash table to free.
+ * @since 0.0.5
+ *
+ * The table must not be accessed by other threads at the moment of the call.
+ */
+P_LIB_API void				p_concurrent_hash_table_free		(PConcurrentHashTable	*table);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PCONCURRENTHASHTABLE_H */
@@ -0,0 +1,201 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Concurrent tree is a pooled PTree with a sequence counter: a writer makes the
+ * counter odd for the time of a change, readers walk the tree without a lock
+ * and retry if the counter was odd or changed during the walk.
+ *
+ * The pool keeps all the removed nodes inside its slabs until the tree is
+ * freed, so whatever pointer a reader loads from a node points either to a
+ * node of the same tree or to NULL. A walk through an inconsistent tree may
+ * still loop, so it's bounded by the lookup itself.
+ *
+ * A reader may also call the compare function on the key of a node which has
+ * just been removed, before it finds out about the change. The tree never
+ * destroys the keys, and they must outlive any lookup which may see them. */
+
+#include "pmem.h"
+#include "patomic.h"
+#include "pconcurrenttree.h"
+#include "pmutex.h"
+#include "ptree-private.h"
+#include "puthread.h"
+
+/* Number of optimistic attempts before a reader takes the writer lock */
+#define P_CONCURRENT_TREE_MAX_RETRIES	16
+
+struct PConcurrentTree_ {
+	volatile pint	sequence;
+	PMutex		*mutex;
+	PTree		*tree;
+};
+
+static void pp_concurrent_tree_write_begin (PConcurrentTree *tree);
+static void pp_concurrent_tree_write_end (PConcurrentTree *tree);
+
+static void
+pp_concurrent_tree_write_begin (PConcurrentTree *tree)
+{
+	p_mutex_lock (tree->mutex);
+	p_atomic_int_inc (&tree->sequence);
+}
+
+static void
+pp_concurrent_tree_write_end (PConcurrentTree *tree)
+{
+	p_atomic_int_inc (&tree->sequence);
+	p_mutex_unlock (tree->mutex);
+}
+
+P_LIB_API PConcurrentTree *
+p_concurrent_tree_new (PTreeType		type,
+		       PCompareDataFunc	func,
+		       ppointer		data)
+{
+	PConcurrentTree *ret;
+
+	if (P_UNLIKELY (!(type >= P_TREE_TYPE_BINARY && type <= P_TREE_TYPE_AVL)))
+		return NULL;
+
+	if (P_UNLIKELY (func == NULL))
+		return NULL;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PConcurrentTree))) == NULL)) {
+		P_ERROR ("PConcurrentTree::p_concurrent_tree_new: failed to allocate memory");
+		return NULL;
+	}
+
+	/* No destroy functions: a reader may still compare the key of a node
+	 * which has been removed or replaced */
+	ret->mutex = p_mutex_new ();
+	ret->tree  = p_tree_new_pooled (type, func, data, NULL, NULL);
+
+	if (P_UNLIKELY (ret->mutex == NULL || ret->tree == NULL)) {
+		P_ERROR ("PConcurrentTree::p_concurrent_tree_new: failed to initialize tree");
+		p_concurrent_tree_free (ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+P_LIB_API void
+p_concurrent_tree_insert (PConcurrentTree	*tree,
+			  ppointer		key,
+			  ppointer		value)
+{
+	if (P_UNLIKELY (tree == NULL))
+		return;
+
+	pp_concurrent_tree_write_begin (tree);
+	p_tree_insert (tree->tree, key, value);
+	pp_concurrent_tree_write_end (tree);
+}
+
+P_LIB_API pboolean
+p_concurrent_tree_remove (PConcurrentTree	*tree,
+			  pconstpointer		key)
+{
+	pboolean result;
+
+	if (P_UNLIKELY (tree == NULL))
+		return FALSE;
+
+	pp_concurrent_tree_write_begin (tree);
+	result = p_tree_remove (tree->tree, key);
+	pp_concurrent_tree_write_end (tree);
+
+	return result;
+}
+
+P_LIB_API ppointer
+p_concurrent_tree_lookup (PConcurrentTree	*tree,
+			  pconstpointer		key)
+{
+	ppointer	value;
+	pboolean	found;
+	pboolean	completed;
+	pint		sequence;
+	pint		i;
+
+	if (P_UNLIKELY (tree == NULL))
+		return NULL;
+
+	for (i = 0; i < P_CONCURRENT_TREE_MAX_RETRIES; ++i) {
+		if (((sequence = p_atomic_int_get (&tree->sequence)) & 1) != 0) {
+			p_uthread_yield ();
+			continue;
+		}
+
+		value     = NULL;
+		completed = p_tree_lookup_optimistic (tree->tree, key, &value, &found);
+
+		/* All the node reads must complete before the counter check */
+		p_atomic_memory_barrier ();
+
+		if (completed == TRUE && p_atomic_int_get (&tree->sequence) == sequence)
+			return found == TRUE ? value : (ppointer) -1;
+	}
+
+	/* The tree is consistent under the lock, so the walk always completes */
+	p_mutex_lock (tree->mutex);
+
+	if (p_tree_lookup_optimistic (tree->tree, key, &value, &found) == FALSE || found == FALSE)
+		value = (ppointer) -1;
+
+	p_mutex_unlock (tree->mutex);
+
+	return value;
+}
+
+P_LIB_API pint
+p_concurrent_tree_get_nnodes (PConcurrentTree *tree)
+{
+	pint ret;
+
+	if (P_UNLIKELY (tree == NULL))
+		return 0;
+
+	p_mutex_lock (tree->mutex);
+	ret = p_tree_get_nnodes (tree->tree);
+	p_mutex_unlock (tree->mutex);
+
+	return ret;
+}
+
+P_LIB_API void
+p_concurrent_tree_free (PConcurrentTree *tree)
+{
+	if (P_UNLIKELY (tree == NULL))
+		return;
+
+	if (tree->tree != NULL)
+		p_tree_free (tree->tree);
+
+	if (tree->mutex != NULL)
+		p_mutex_free (tree->mutex);
+
+	p_free (tree);
+}
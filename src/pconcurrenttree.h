@@ -0,0 +1,152 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pconcurrenttree.h
+ * @brief Concurrent binary search tree
+ * @author Alexander Saprykin
+ *
+ * A concurrent tree is a thread-safe ordered map for the read-mostly workloads:
+ * many threads looking up the keys while a few threads update the tree.
+ *
+ * Protecting a #PTree with a #PRWLock still makes every reader write to the
+ * shared lock word, so the readers on different cores keep bouncing the same
+ * cache line. Readers of #PConcurrentTree take no lock and write nothing: they
+ * walk the tree optimistically and validate the result with a sequence counter
+ * which writers increment before and after every change. A lookup which raced
+ * with a writer is simply retried, and after several unsuccessful attempts the
+ * reader falls back to the writer lock, so it can't starve. Writers are
+ * serialized with a mutex.
+ *
+ * As readers may walk through the nodes being changed or removed at the same
+ * moment, the tree nodes are never returned to the system while the tree
+ * exists, they are reused by the next insertions instead. For the same reason
+ * the compare function can be called concurrently with stale keys: keys which
+ * were already removed from a tree (or NULL while a node is being reused). Keys
+ * like integers stored in pointers are fine as is, keys pointing to memory
+ * must stay valid as long as the tree exists. The tree doesn't take ownership
+ * of the keys and the values.
+ *
+ * Only binary trees are supported: #P_TREE_TYPE_BINARY, #P_TREE_TYPE_RB and
+ * #P_TREE_TYPE_AVL. Updates are more expensive than with a plain #PTree,
+ * consider a concurrent tree only when lookups clearly dominate.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PCONCURRENTTREE_H
+#define PLIBSYS_HEADER_PCONCURRENTTREE_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+#include "ptree.h"
+
+P_BEGIN_DECLS
+
+/** Opaque data structure for a concurrent tree. */
+typedef struct PConcurrentTree_ PConcurrentTree;
+
+/**
+ * @brief Initializes a new concurrent tree.
+ * @param type Tree algorithm type to use, #P_TREE_TYPE_BTREE is not supported.
+ * @param func Key compare function.
+ * @param data Data to be passed to @a func along with the keys.
+ * @return Pointer to a newly initialized #PConcurrentTree structure in case of
+ * success, NULL otherwise.
+ * @since 0.0.5
+ * @note Free with p_concurrent_tree_free() after usage.
+ *
+ * See the requirements for @a func in the description of #PConcurrentTree.
+ */
+P_LIB_API PConcurrentTree *	p_concurrent_tree_new		(PTreeType		type,
+								 PCompareDataFunc	func,
+								 ppointer		data);
+
+/**
+ * @brief Inserts a new key-value pair into a concurrent tree.
+ * @param tree Initialized concurrent tree.
+ * @param key Key to insert.
+ * @param value Value to insert.
+ * @since 0.0.5
+ *
+ * If the @a key already exists in the tree then its value is replaced.
+ *
+ * The tree doesn't free anything on replacement. Keys and values taken out of
+ * the tree must stay valid while concurrent lookups may still see them, i.e.
+ * until no lookups are running or the tree is freed.
+ */
+P_LIB_API void			p_concurrent_tree_insert	(PConcurrentTree	*tree,
+								 ppointer		key,
+								 ppointer		value);
+
+/**
+ * @brief Removes a key from a concurrent tree.
+ * @param tree Concurrent tree to remove the key from.
+ * @param key Key to remove.
+ * @return TRUE if the key was removed, FALSE if it was not found.
+ * @since 0.0.5
+ *
+ * The stored key is not freed. Lookups running at the same time may still call
+ * the compare function on it, so don't free it until no lookups are running
+ * or the tree is freed.
+ */
+P_LIB_API pboolean		p_concurrent_tree_remove	(PConcurrentTree	*tree,
+								 pconstpointer		key);
+
+/**
+ * @brief Searches for a specifed key in a concurrent tree.
+ * @param tree Concurrent tree to lookup in.
+ * @param key Key to lookup for.
+ * @return Value related to the @a key (can be NULL), (#ppointer) -1 if no
+ * value was found.
+ * @since 0.0.5
+ *
+ * The lookup takes no lock unless it keeps racing with the writers.
+ */
+P_LIB_API ppointer		p_concurrent_tree_lookup	(PConcurrentTree	*tree,
+								 pconstpointer		key);
+
+/**
+ * @brief Gets the number of key-value pairs in a concurrent tree.
+ * @param tree Concurrent tree to get the node count for.
+ * @return Node count, 0 if the tree is empty or an invalid pointer is given.
+ * @since 0.0.5
+ */
+P_LIB_API pint			p_concurrent_tree_get_nnodes	(PConcurrentTree	*tree);
+
+/**
+ * @brief Frees a previously initialized #PConcurrentTree.
+ * @param tree Concurrent tree to free.
+ * @since 0.0.5
+ *
+ * The tree must not be accessed by other threads at the moment of the call.
+ */
+P_LIB_API void			p_concurrent_tree_free		(PConcurrentTree	*tree);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PCONCURRENTTREE_H */
@@ -138,6 +138,23 @@ p_cond_variable_wait (PCondVariable	*cond,
 	return TRUE;
 }
 
+P_LIB_API pint
+p_cond_variable_wait_timed (PCondVariable	*cond,
+			    PMutex		*mutex,
+			    pint		timeout)
+{
+	if (P_UNLIKELY (cond == NULL || mutex == NULL))
+		return -1;
+
+	/* Suspended threads cannot be woken up by a timer */
+	if (P_UNLIKELY (timeout >= 0)) {
+		P_WARNING ("PCondVariable::p_cond_variable_wait_timed: finite timeout is not supported");
+		return -1;
+	}
+
+	return p_cond_variable_wait (cond, mutex) == TRUE ? 1 : -1;
+}
+
 P_LIB_API pboolean
 p_cond_variable_signal (PCondVariable *cond)
 {
@@ -53,6 +53,18 @@ p_cond_variable_wait (PCondVariable	*cond,
 	return FALSE;
 }
 
+P_LIB_API pint
+p_cond_variable_wait_timed (PCondVariable	*cond,
+			    PMutex		*mutex,
+			    pint		timeout)
+{
+	P_UNUSED (cond);
+	P_UNUSED (mutex);
+	P_UNUSED (timeout);
+
+	return -1;
+}
+
 P_LIB_API pboolean
 p_cond_variable_signal (PCondVariable *cond)
 {
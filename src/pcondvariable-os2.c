@@ -31,6 +31,7 @@
 
 #define INCL_DOSSEMAPHORES
 #define INCL_DOSERRORS
+#define INCL_DOSMISC
 #include <os2.h>
 
 struct PCondVariable_ {
@@ -39,6 +40,63 @@ struct PCondVariable_ {
 	pint	signaled;
 };
 
+static pint pp_cond_variable_wait_os2 (PCondVariable *cond, PMutex *mutex, ULONG timeout);
+
+static pint
+pp_cond_variable_wait_os2 (PCondVariable	*cond,
+			   PMutex		*mutex,
+			   ULONG		timeout)
+{
+	APIRET	ulrc;
+	APIRET	reset_ulrc;
+	ULONG	wait_ms  = timeout;
+	ULONG	start_ms = 0;
+	ULONG	now_ms;
+
+	if (timeout != SEM_INDEFINITE_WAIT)
+		DosQuerySysInfo (QSV_MS_COUNT, QSV_MS_COUNT, &start_ms, sizeof (start_ms));
+
+	do {
+		p_atomic_int_inc (&cond->waiters_count);
+		p_mutex_unlock (mutex);
+
+		do {
+			ULONG post_count;
+
+			ulrc = DosWaitEventSem (cond->waiters_sema, wait_ms);
+
+			if (ulrc == NO_ERROR) {
+				reset_ulrc = DosResetEventSem (cond->waiters_sema, &post_count);
+
+				if (P_UNLIKELY (reset_ulrc != NO_ERROR &&
+						reset_ulrc != ERROR_ALREADY_RESET))
+					P_WARNING ("PCondVariable::pp_cond_variable_wait_os2: DosResetEventSem() failed");
+
+				if (p_atomic_int_compare_and_exchange (&cond->signaled, 1, 0) == TRUE)
+					break;
+			}
+
+			/* Someone else took the signal, wait for the rest of the time */
+			if (timeout != SEM_INDEFINITE_WAIT && (ulrc == NO_ERROR || ulrc == ERROR_INTERRUPT)) {
+				DosQuerySysInfo (QSV_MS_COUNT, QSV_MS_COUNT, &now_ms, sizeof (now_ms));
+
+				if (now_ms - start_ms >= timeout)
+					ulrc = ERROR_TIMEOUT;
+				else
+					wait_ms = timeout - (now_ms - start_ms);
+			}
+		} while (ulrc == NO_ERROR);
+
+		p_atomic_int_add (&cond->waiters_count, -1);
+		p_mutex_lock (mutex);
+	} while (ulrc == ERROR_INTERRUPT);
+
+	if (ulrc == ERROR_TIMEOUT)
+		return 0;
+
+	return (ulrc == NO_ERROR) ? 1 : -1;
+}
+
 P_LIB_API PCondVariable *
 p_cond_variable_new (void)
 {
@@ -77,36 +135,23 @@ P_LIB_API pboolean
 p_cond_variable_wait (PCondVariable	*cond,
 		      PMutex		*mutex)
 {
-	APIRET ulrc;
-	APIRET reset_ulrc;
-
 	if (P_UNLIKELY (cond == NULL || mutex == NULL))
 		return FALSE;
 
-	do {
-		p_atomic_int_inc (&cond->waiters_count);
-		p_mutex_unlock (mutex);
-
-		do {
-			ULONG post_count;
-
-			ulrc = DosWaitEventSem (cond->waiters_sema, SEM_INDEFINITE_WAIT);
-
-			if (ulrc == NO_ERROR) {
-				reset_ulrc = DosResetEventSem (cond->waiters_sema, &post_count);
-				
-				if (P_UNLIKELY (reset_ulrc != NO_ERROR &&
-						reset_ulrc != ERROR_ALREADY_RESET))
-					P_WARNING ("PCondVariable::p_cond_variable_wait: DosResetEventSem() failed");
-			}
-		} while (ulrc == NO_ERROR &&
-			 p_atomic_int_compare_and_exchange (&cond->signaled, 1, 0) == FALSE);
+	return pp_cond_variable_wait_os2 (cond, mutex, SEM_INDEFINITE_WAIT) == 1 ? TRUE : FALSE;
+}
 
-		p_atomic_int_add (&cond->waiters_count, -1);
-		p_mutex_lock (mutex);
-	} while (ulrc == ERROR_INTERRUPT);
+P_LIB_API pint
+p_cond_variable_wait_timed (PCondVariable	*cond,
+			    PMutex		*mutex,
+			    pint		timeout)
+{
+	if (P_UNLIKELY (cond == NULL || mutex == NULL))
+		return -1;
 
-	return (ulrc == NO_ERROR) ? TRUE : FALSE;
+	return pp_cond_variable_wait_os2 (cond,
+					  mutex,
+					  timeout < 0 ? SEM_INDEFINITE_WAIT : (ULONG) timeout);
 }
 
 P_LIB_API pboolean
@@ -29,23 +29,52 @@
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <errno.h>
 #include "pthread.h"
 
+#if !defined (PLIBSYS_HAS_POSIX_CONDATTR_SETCLOCK) && !defined (PLIBSYS_HAS_POSIX_COND_RELATIVE_NP)
+#  include <sys/time.h>
+#endif
+
 struct PCondVariable_ {
-	pthread_cond_t hdl;
+	pthread_cond_t	hdl;
+	pboolean	is_monotonic;
 };
 
 P_LIB_API PCondVariable *
 p_cond_variable_new (void)
 {
-	PCondVariable *ret;
+	PCondVariable		*ret;
+#ifdef PLIBSYS_HAS_POSIX_CONDATTR_SETCLOCK
+	pthread_condattr_t	attr;
+#endif
+	pint			res;
 
 	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PCondVariable))) == NULL)) {
 		P_ERROR ("PCondVariable::p_cond_variable_new: failed to allocate memory");
 		return NULL;
 	}
 
-	if (P_UNLIKELY (pthread_cond_init (&ret->hdl, NULL) != 0)) {
+#ifdef PLIBSYS_HAS_POSIX_CONDATTR_SETCLOCK
+	if (P_UNLIKELY (pthread_condattr_init (&attr) != 0)) {
+		P_ERROR ("PCondVariable::p_cond_variable_new: failed to initialize attributes");
+		p_free (ret);
+		return NULL;
+	}
+
+	/* Timed waits should not depend on the system time changes */
+	if (P_UNLIKELY (pthread_condattr_setclock (&attr, CLOCK_MONOTONIC) != 0))
+		P_WARNING ("PCondVariable::p_cond_variable_new: failed to set monotonic clock");
+	else
+		ret->is_monotonic = TRUE;
+
+	res = pthread_cond_init (&ret->hdl, &attr);
+	pthread_condattr_destroy (&attr);
+#else
+	res = pthread_cond_init (&ret->hdl, NULL);
+#endif
+
+	if (P_UNLIKELY (res != 0)) {
 		P_ERROR ("PCondVariable::p_cond_variable_new: failed to initialize");
 		p_free (ret);
 		return NULL;
@@ -82,6 +111,64 @@ p_cond_variable_wait (PCondVariable	*cond,
 	return TRUE;
 }
 
+P_LIB_API pint
+p_cond_variable_wait_timed (PCondVariable	*cond,
+			    PMutex		*mutex,
+			    pint		timeout)
+{
+	struct timespec	ts;
+	pint		res;
+#if !defined (PLIBSYS_HAS_POSIX_COND_RELATIVE_NP) && !defined (PLIBSYS_HAS_POSIX_CONDATTR_SETCLOCK)
+	struct timeval	tv;
+#endif
+
+	if (P_UNLIKELY (cond == NULL || mutex == NULL))
+		return -1;
+
+	if (timeout < 0)
+		return p_cond_variable_wait (cond, mutex) == TRUE ? 1 : -1;
+
+#if defined (PLIBSYS_HAS_POSIX_COND_RELATIVE_NP)
+	ts.tv_sec  = timeout / 1000;
+	ts.tv_nsec = (timeout % 1000) * 1000000L;
+
+	res = pthread_cond_timedwait_relative_np (&cond->hdl, (pthread_mutex_t *) mutex, &ts);
+#else
+#  ifdef PLIBSYS_HAS_POSIX_CONDATTR_SETCLOCK
+	if (P_UNLIKELY (clock_gettime (cond->is_monotonic == TRUE ? CLOCK_MONOTONIC : CLOCK_REALTIME, &ts) != 0)) {
+		P_ERROR ("PCondVariable::p_cond_variable_wait_timed: clock_gettime() failed");
+		return -1;
+	}
+#  else
+	gettimeofday (&tv, NULL);
+
+	ts.tv_sec  = tv.tv_sec;
+	ts.tv_nsec = tv.tv_usec * 1000L;
+#  endif
+
+	/* Absolute deadline for the clock of the condition variable */
+	ts.tv_sec  += timeout / 1000;
+	ts.tv_nsec += (timeout % 1000) * 1000000L;
+
+	if (ts.tv_nsec >= 1000000000L) {
+		ts.tv_sec  += 1;
+		ts.tv_nsec -= 1000000000L;
+	}
+
+	res = pthread_cond_timedwait (&cond->hdl, (pthread_mutex_t *) mutex, &ts);
+#endif
+
+	if (res == ETIMEDOUT)
+		return 0;
+
+	if (P_UNLIKELY (res != 0)) {
+		P_ERROR ("PCondVariable::p_cond_variable_wait_timed: pthread_cond_timedwait() failed");
+		return -1;
+	}
+
+	return 1;
+}
+
 P_LIB_API pboolean
 p_cond_variable_signal (PCondVariable *cond)
 {
@@ -29,6 +29,7 @@
 #include <stdlib.h>
 #include <time.h>
 #include <string.h>
+#include <errno.h>
 #include <thread.h>
 #include <synch.h>
 
@@ -83,6 +84,37 @@ p_cond_variable_wait (PCondVariable	*cond,
 	return TRUE;
 }
 
+P_LIB_API pint
+p_cond_variable_wait_timed (PCondVariable	*cond,
+			    PMutex		*mutex,
+			    pint		timeout)
+{
+	timestruc_t	reltime;
+	pint		res;
+
+	if (P_UNLIKELY (cond == NULL || mutex == NULL))
+		return -1;
+
+	if (timeout < 0)
+		return p_cond_variable_wait (cond, mutex) == TRUE ? 1 : -1;
+
+	reltime.tv_sec  = timeout / 1000;
+	reltime.tv_nsec = (timeout % 1000) * 1000000L;
+
+	/* Relative timeout is measured with a monotonic clock */
+	res = cond_reltimedwait (&cond->hdl, (mutex_t *) mutex, &reltime);
+
+	if (res == ETIME || res == ETIMEDOUT)
+		return 0;
+
+	if (P_UNLIKELY (res != 0)) {
+		P_ERROR ("PCondVariable::p_cond_variable_wait_timed: cond_reltimedwait() failed");
+		return -1;
+	}
+
+	return 1;
+}
+
 P_LIB_API pboolean
 p_cond_variable_signal (PCondVariable *cond)
 {
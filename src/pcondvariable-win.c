@@ -42,7 +42,7 @@ typedef VOID (WINAPI * WakeAllConditionVariableFunc)    (ppointer cv);
 
 typedef pboolean (* PWin32CondInit)    (PCondVariable *cond);
 typedef void     (* PWin32CondClose)   (PCondVariable *cond);
-typedef pboolean (* PWin32CondWait)    (PCondVariable *cond, PMutex *mutex);
+typedef pint     (* PWin32CondWait)    (PCondVariable *cond, PMutex *mutex, DWORD ms);
 typedef pboolean (* PWin32CondSignal)  (PCondVariable *cond);
 typedef pboolean (* PWin32CondBrdcast) (PCondVariable *cond);
 
@@ -73,14 +73,14 @@ static PCondVariableVistaTable pp_cond_variable_vista_table = {NULL, NULL, NULL,
 /* CONDITION_VARIABLE routines */
 static pboolean pp_cond_variable_init_vista (PCondVariable *cond);
 static void pp_cond_variable_close_vista (PCondVariable *cond);
-static pboolean pp_cond_variable_wait_vista (PCondVariable *cond, PMutex *mutex);
+static pint pp_cond_variable_wait_vista (PCondVariable *cond, PMutex *mutex, DWORD ms);
 static pboolean pp_cond_variable_signal_vista (PCondVariable *cond);
 static pboolean pp_cond_variable_broadcast_vista (PCondVariable *cond);
 
 /* Windows XP emulation routines */
 static pboolean pp_cond_variable_init_xp (PCondVariable *cond);
 static void pp_cond_variable_close_xp (PCondVariable *cond);
-static pboolean pp_cond_variable_wait_xp (PCondVariable *cond, PMutex *mutex);
+static pint pp_cond_variable_wait_xp (PCondVariable *cond, PMutex *mutex, DWORD ms);
 static pboolean pp_cond_variable_signal_xp (PCondVariable *cond);
 static pboolean pp_cond_variable_broadcast_xp (PCondVariable *cond);
 
@@ -100,12 +100,13 @@ pp_cond_variable_close_vista (PCondVariable *cond)
 	P_UNUSED (cond);
 }
 
-static pboolean
-pp_cond_variable_wait_vista (PCondVariable *cond, PMutex *mutex)
+static pint
+pp_cond_variable_wait_vista (PCondVariable *cond, PMutex *mutex, DWORD ms)
 {
-	return pp_cond_variable_vista_table.cv_wait (cond,
-						     (PCRITICAL_SECTION) mutex,
-						     INFINITE) != 0 ? TRUE : FALSE;
+	if (pp_cond_variable_vista_table.cv_wait (cond, (PCRITICAL_SECTION) mutex, ms) != 0)
+		return 1;
+
+	return GetLastError () == ERROR_TIMEOUT ? 0 : -1;
 }
 
 static pboolean
@@ -158,8 +159,8 @@ pp_cond_variable_close_xp (PCondVariable *cond)
 	p_free (cond->cv);
 }
 
-static pboolean
-pp_cond_variable_wait_xp (PCondVariable *cond, PMutex *mutex)
+static pint
+pp_cond_variable_wait_xp (PCondVariable *cond, PMutex *mutex, DWORD ms)
 {
 	PCondVariableXP	*cv_xp = ((PCondVariableXP *) cond->cv);
 	DWORD		wait;
@@ -167,13 +168,16 @@ pp_cond_variable_wait_xp (PCondVariable *cond, PMutex *mutex)
 	p_atomic_int_inc (&cv_xp->waiters_count);
 
 	p_mutex_unlock (mutex);
-	wait = WaitForSingleObjectEx (cv_xp->waiters_sema, INFINITE, FALSE);
+	wait = WaitForSingleObjectEx (cv_xp->waiters_sema, ms, FALSE);
 	p_mutex_lock (mutex);
 
 	if (wait != WAIT_OBJECT_0)
 		p_atomic_int_add (&cv_xp->waiters_count, -1);
 
-	return wait == WAIT_OBJECT_0 ? TRUE : FALSE;
+	if (wait == WAIT_TIMEOUT)
+		return 0;
+
+	return wait == WAIT_OBJECT_0 ? 1 : -1;
 }
 
 static pboolean
@@ -241,7 +245,18 @@ p_cond_variable_wait (PCondVariable	*cond,
 	if (P_UNLIKELY (cond == NULL || mutex == NULL))
 		return FALSE;
 
-	return pp_cond_variable_wait_func (cond, mutex);
+	return pp_cond_variable_wait_func (cond, mutex, INFINITE) == 1 ? TRUE : FALSE;
+}
+
+P_LIB_API pint
+p_cond_variable_wait_timed (PCondVariable	*cond,
+			    PMutex		*mutex,
+			    pint		timeout)
+{
+	if (P_UNLIKELY (cond == NULL || mutex == NULL))
+		return -1;
+
+	return pp_cond_variable_wait_func (cond, mutex, timeout < 0 ? INFINITE : (DWORD) timeout);
 }
 
 P_LIB_API pboolean
@@ -75,6 +75,7 @@
 #include "pmacros.h"
 #include "ptypes.h"
 #include "pmutex.h"
+#include "pdeadline.h"
 
 P_BEGIN_DECLS
 
@@ -108,6 +109,56 @@ P_LIB_API void			p_cond_variable_free		(PCondVariable	*cond);
 P_LIB_API pboolean		p_cond_variable_wait		(PCondVariable	*cond,
 								 PMutex		*mutex);
 
+/**
+ * @brief Waits for a signal on a given condition variable with a timeout.
+ * @param cond Condition variable to wait on.
+ * @param mutex Locked mutex which will remain locked after waiting.
+ * @param timeout Timeout in milliseconds, -1 to wait infinitely, 0 to return
+ * immediately.
+ * @return 1 if the thread was woken up, 0 on timeout, -1 in case of error.
+ * @since 0.0.5
+ *
+ * The calling thread will sleep until the signal on @a cond arrived or the
+ * timeout expired. The mutex is locked again in both cases, so the condition
+ * should be checked after a timeout as well. Like p_cond_variable_wait() the
+ * call may return 1 without a signal (a spurious wakeup), wait in a loop
+ * with a recomputed timeout to meet a deadline.
+ *
+ * On POSIX systems the timeout is measured with a monotonic clock where
+ * available, so changing the system time doesn't affect it. Finite timeouts
+ * are not supported on AmigaOS, BeOS and AtheOS, the call returns -1 there.
+ */
+P_LIB_API pint			p_cond_variable_wait_timed	(PCondVariable	*cond,
+								 PMutex		*mutex,
+								 pint		timeout);
+
+/**
+ * @brief Waits for a signal on a given condition variable until a deadline.
+ * @param cond Condition variable to wait on.
+ * @param mutex Locked mutex which will remain locked after waiting.
+ * @param deadline Deadline to wait until, NULL to wait infinitely.
+ * @return 1 if the thread was woken up, 0 if the deadline has expired, -1 in
+ * case of error.
+ * @since 0.0.5
+ *
+ * Works like p_cond_variable_wait_timed(), but the waiting time is bounded
+ * by the absolute @a deadline, so the condition can be checked in a loop
+ * without recomputing the timeout:
+ * @code
+ * p_mutex_lock (mutex);
+ *
+ * while (queue_is_empty (queue) && p_cond_variable_wait_until (cond, mutex, &deadline) == 1)
+ *	;
+ *
+ * p_mutex_unlock (mutex);
+ * @endcode
+ *
+ * Returns 0 immediately if @a deadline has already expired.
+ */
+P_LIB_API pint			p_cond_variable_wait_until	(PCondVariable	*cond,
+								 PMutex		*mutex,
+								 const PDeadline	*deadline);
+
 /**
  * @brief Emitts a signal on a given condition variable for one waiting thread.
  * @param cond Condition variable to emit the signal on.
@@ -0,0 +1,168 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* The count is decremented without the lock, except the last decrement which
+ * is done under the mutex along with the wake up of the sleepers. A thread
+ * which sees the zero count without sleeping still takes the mutex once
+ * before returning, so the latch is never freed while the last decrementing
+ * thread is using it. */
+
+#include "patomic.h"
+#include "pcondvariable.h"
+#include "pcountdownlatch.h"
+#include "pmem.h"
+#include "pmutex.h"
+
+struct PCountDownLatch_ {
+	volatile pint	count;
+	volatile pint	n_sleepers;
+	pint		spin_count;
+	PMutex		*mutex;
+	PCondVariable	*cond;
+};
+
+P_LIB_API PCountDownLatch *
+p_count_down_latch_new (pint	count,
+			pint	spin_count)
+{
+	PCountDownLatch *ret;
+
+	if (P_UNLIKELY (count < 0 || spin_count < 0))
+		return NULL;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PCountDownLatch))) == NULL)) {
+		P_ERROR ("PCountDownLatch::p_count_down_latch_new: failed to allocate memory");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret->mutex = p_mutex_new ()) == NULL)) {
+		P_ERROR ("PCountDownLatch::p_count_down_latch_new: failed to create mutex");
+		p_free (ret);
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret->cond = p_cond_variable_new ()) == NULL)) {
+		P_ERROR ("PCountDownLatch::p_count_down_latch_new: failed to create condition variable");
+		p_mutex_free (ret->mutex);
+		p_free (ret);
+		return NULL;
+	}
+
+	ret->spin_count = spin_count;
+
+	p_atomic_int_set (&ret->count, count);
+
+	return ret;
+}
+
+P_LIB_API void
+p_count_down_latch_count_down (PCountDownLatch *latch)
+{
+	pint count;
+
+	if (P_UNLIKELY (latch == NULL))
+		return;
+
+	do {
+		if ((count = p_atomic_int_get (&latch->count)) <= 1)
+			break;
+	} while (p_atomic_int_compare_and_exchange (&latch->count, count, count - 1) == FALSE);
+
+	if (count > 1)
+		return;
+
+	p_mutex_lock (latch->mutex);
+
+	if (p_atomic_int_compare_and_exchange (&latch->count, 1, 0) == TRUE &&
+	    p_atomic_int_get (&latch->n_sleepers) > 0)
+		p_cond_variable_broadcast (latch->cond);
+
+	p_mutex_unlock (latch->mutex);
+}
+
+P_LIB_API pboolean
+p_count_down_latch_wait (PCountDownLatch *latch)
+{
+	pint i;
+
+	if (P_UNLIKELY (latch == NULL))
+		return FALSE;
+
+	for (i = 0; i <= latch->spin_count; ++i) {
+		if (p_atomic_int_get (&latch->count) == 0)
+			break;
+	}
+
+	p_mutex_lock (latch->mutex);
+
+	if (p_atomic_int_get (&latch->count) > 0) {
+		p_atomic_int_inc (&latch->n_sleepers);
+
+		while (p_atomic_int_get (&latch->count) > 0)
+			p_cond_variable_wait (latch->cond, latch->mutex);
+
+		p_atomic_int_add (&latch->n_sleepers, -1);
+	}
+
+	p_mutex_unlock (latch->mutex);
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_count_down_latch_try_wait (const PCountDownLatch *latch)
+{
+	if (P_UNLIKELY (latch == NULL))
+		return FALSE;
+
+	if (p_atomic_int_get (&latch->count) > 0)
+		return FALSE;
+
+	/* Waits for the last decrementing thread to leave the latch */
+	p_mutex_lock (latch->mutex);
+	p_mutex_unlock (latch->mutex);
+
+	return TRUE;
+}
+
+P_LIB_API pint
+p_count_down_latch_get_count (const PCountDownLatch *latch)
+{
+	if (P_UNLIKELY (latch == NULL))
+		return 0;
+
+	return p_atomic_int_get (&latch->count);
+}
+
+P_LIB_API void
+p_count_down_latch_free (PCountDownLatch *latch)
+{
+	if (P_UNLIKELY (latch == NULL))
+		return;
+
+	p_cond_variable_free (latch->cond);
+	p_mutex_free (latch->mutex);
+	p_free (latch);
+}
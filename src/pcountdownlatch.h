@@ -0,0 +1,128 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pcountdownlatch.h
+ * @brief Count down latch
+ * @author Alexander Saprykin
+ *
+ * A count down latch lets threads wait until a number of events has happened,
+ * i.e. until a set of tasks has finished or a group of workers has started.
+ * The latch is created with the number of events by p_count_down_latch_new(),
+ * every event is reported with p_count_down_latch_count_down(), and
+ * p_count_down_latch_wait() blocks until the count drops to zero. Unlike a
+ * barrier the threads which count down never wait, and any number of threads
+ * can wait on the latch.
+ *
+ * A latch is not reusable: once the count has reached zero it stays there and
+ * all the following waits return at once.
+ *
+ * Counting down is a single atomic operation, only the last one takes the
+ * latch mutex to wake up the sleeping waiters. With a positive spin count the
+ * waiting threads first poll the count for that many rounds and only then go
+ * to sleep, so a wait for events which are about to happen doesn't block.
+ * Such a waiter still takes the mutex once before returning, which makes it
+ * safe to free the latch right after the wait, even if the last counting
+ * down thread has not returned yet.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PCOUNTDOWNLATCH_H
+#define PLIBSYS_HEADER_PCOUNTDOWNLATCH_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+
+P_BEGIN_DECLS
+
+/** Count down latch opaque data type. */
+typedef struct PCountDownLatch_ PCountDownLatch;
+
+/**
+ * @brief Creates a new count down latch.
+ * @param count Number of events to wait for, 0 or more.
+ * @param spin_count Number of polling rounds before blocking, 0 to block at
+ * once.
+ * @return Pointer to #PCountDownLatch in case of success, NULL otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API PCountDownLatch *	p_count_down_latch_new		(pint			count,
+								 pint			spin_count);
+
+/**
+ * @brief Decrements the count of a latch.
+ * @param latch #PCountDownLatch to count down.
+ * @since 0.0.5
+ *
+ * The waiting threads are released when the count reaches zero. Counting down
+ * a latch with a zero count does nothing.
+ */
+P_LIB_API void			p_count_down_latch_count_down	(PCountDownLatch	*latch);
+
+/**
+ * @brief Waits until the count of a latch reaches zero.
+ * @param latch #PCountDownLatch to wait on.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean		p_count_down_latch_wait		(PCountDownLatch	*latch);
+
+/**
+ * @brief Checks whether the count of a latch has reached zero without
+ * waiting.
+ * @param latch #PCountDownLatch to check.
+ * @return TRUE if the count is zero, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean		p_count_down_latch_try_wait	(const PCountDownLatch	*latch);
+
+/**
+ * @brief Gets the current count of a latch.
+ * @param latch #PCountDownLatch to get the count for.
+ * @return Current count, 0 in case of error.
+ * @since 0.0.5
+ *
+ * The count may be changed by other threads by the time it is returned.
+ */
+P_LIB_API pint			p_count_down_latch_get_count	(const PCountDownLatch	*latch);
+
+/**
+ * @brief Frees a count down latch.
+ * @param latch #PCountDownLatch to free.
+ * @since 0.0.5
+ *
+ * No threads should wait on the latch at that moment. It is safe to free
+ * the latch once p_count_down_latch_wait() or p_count_down_latch_try_wait()
+ * has reported the zero count, the counting down threads don't touch it
+ * after that.
+ */
+P_LIB_API void			p_count_down_latch_free		(PCountDownLatch	*latch);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PCOUNTDOWNLATCH_H */
@@ -0,0 +1,165 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* A thread may move to another CPU between picking a slot and updating it,
+ * so the slots are still updated atomically, but with the relaxed order: the
+ * counter doesn't order any other memory. */
+
+#include "patomic.h"
+#include "pmem.h"
+#include "puthread.h"
+#include "pcounter.h"
+
+#define P_COUNTER_MAX_SLOTS	256
+
+typedef struct PCounterSlot_ {
+	volatile pint64	value;
+	pchar		pad[P_MEM_CACHE_LINE_SIZE - sizeof (pint64)];
+} PCounterSlot;
+
+struct PCounter_ {
+	PCounterSlot	*slots;
+	pint		slot_mask;
+};
+
+static pint pp_counter_pick_slot (const PCounter *counter);
+
+static pint
+pp_counter_pick_slot (const PCounter *counter)
+{
+	pint	cpu;
+	psize	id;
+
+	if (P_LIKELY ((cpu = p_uthread_current_cpu ()) >= 0))
+		return cpu & counter->slot_mask;
+
+	/* Without the CPU number at least spread different threads */
+	id = (psize) p_uthread_current_id ();
+
+	return (pint) ((id >> 4) ^ (id >> 12)) & counter->slot_mask;
+}
+
+P_LIB_API PCounter *
+p_counter_new (pint n_slots)
+{
+	PCounter	*ret;
+	pint		size;
+
+	if (n_slots <= 0)
+		n_slots = p_uthread_ideal_count ();
+
+	if (n_slots > P_COUNTER_MAX_SLOTS)
+		n_slots = P_COUNTER_MAX_SLOTS;
+
+	for (size = 1; size < n_slots; size <<= 1)
+		;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PCounter))) == NULL)) {
+		P_ERROR ("PCounter::p_counter_new: failed to allocate memory");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret->slots = p_malloc0_aligned (sizeof (PCounterSlot) * (psize) size,
+							 P_MEM_CACHE_LINE_SIZE)) == NULL)) {
+		P_ERROR ("PCounter::p_counter_new: failed to allocate memory for slots");
+		p_free (ret);
+		return NULL;
+	}
+
+	ret->slot_mask = size - 1;
+
+	return ret;
+}
+
+P_LIB_API void
+p_counter_add (PCounter	*counter,
+	       pint64	value)
+{
+	if (P_UNLIKELY (counter == NULL))
+		return;
+
+	p_atomic_int64_add_explicit (&counter->slots[pp_counter_pick_slot (counter)].value,
+				     value,
+				     P_ATOMIC_MEMORY_ORDER_RELAXED);
+}
+
+P_LIB_API void
+p_counter_inc (PCounter *counter)
+{
+	p_counter_add (counter, 1);
+}
+
+P_LIB_API pint64
+p_counter_get (const PCounter *counter)
+{
+	pint64	ret;
+	pint	i;
+
+	if (P_UNLIKELY (counter == NULL))
+		return 0;
+
+	ret = 0;
+
+	for (i = 0; i <= counter->slot_mask; ++i)
+		ret += p_atomic_int64_get_explicit (&counter->slots[i].value, P_ATOMIC_MEMORY_ORDER_RELAXED);
+
+	return ret;
+}
+
+P_LIB_API pint64
+p_counter_reset (PCounter *counter)
+{
+	pint64	ret;
+	pint64	value;
+	pint	i;
+
+	if (P_UNLIKELY (counter == NULL))
+		return 0;
+
+	ret = 0;
+
+	/* Subtracting instead of storing zero keeps the concurrent updates */
+	for (i = 0; i <= counter->slot_mask; ++i) {
+		value = p_atomic_int64_get_explicit (&counter->slots[i].value, P_ATOMIC_MEMORY_ORDER_RELAXED);
+
+		if (value == 0)
+			continue;
+
+		p_atomic_int64_add_explicit (&counter->slots[i].value, -value, P_ATOMIC_MEMORY_ORDER_RELAXED);
+		ret += value;
+	}
+
+	return ret;
+}
+
+P_LIB_API void
+p_counter_free (PCounter *counter)
+{
+	if (P_UNLIKELY (counter == NULL))
+		return;
+
+	p_free_aligned (counter->slots);
+	p_free (counter);
+}
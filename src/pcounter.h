@@ -0,0 +1,114 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pcounter.h
+ * @brief Sharded counter
+ * @author Alexander Saprykin
+ *
+ * A sharded counter is a 64-bit counter for values updated by many threads
+ * at once, like request counters or statistics. A single atomic counter
+ * keeps its value in one cache line, which bounces between the CPUs on every
+ * update. Here the value is split over several slots, each on its own cache
+ * line, and an update goes to the slot of the CPU the thread runs on (or
+ * picked by the thread ID if the CPU number is unknown). Updates from
+ * different CPUs don't touch the same memory.
+ *
+ * The price is paid by the readers: p_counter_get() sums all the slots, so
+ * it is slower than an update and, while the updates go on, returns a value
+ * the counter had at some moment during the call. Use a single atomic
+ * integer if the counter is read as often as it is updated.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PCOUNTER_H
+#define PLIBSYS_HEADER_PCOUNTER_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+
+P_BEGIN_DECLS
+
+/** Sharded counter opaque data type. */
+typedef struct PCounter_ PCounter;
+
+/**
+ * @brief Creates a new sharded counter with a zero value.
+ * @param n_slots Number of slots, 0 to use the number of CPUs. It is rounded
+ * up to a power of two and limited by 256.
+ * @return Pointer to #PCounter in case of success, NULL otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API PCounter *	p_counter_new		(pint		n_slots);
+
+/**
+ * @brief Adds a value to a sharded counter.
+ * @param counter #PCounter to add the value to.
+ * @param value Value to add, can be negative.
+ * @since 0.0.5
+ */
+P_LIB_API void		p_counter_add		(PCounter	*counter,
+						 pint64		value);
+
+/**
+ * @brief Increments a sharded counter by 1.
+ * @param counter #PCounter to increment.
+ * @since 0.0.5
+ */
+P_LIB_API void		p_counter_inc		(PCounter	*counter);
+
+/**
+ * @brief Gets the value of a sharded counter.
+ * @param counter #PCounter to get the value for.
+ * @return Sum of all the slots.
+ * @since 0.0.5
+ */
+P_LIB_API pint64	p_counter_get		(const PCounter	*counter);
+
+/**
+ * @brief Resets a sharded counter to zero.
+ * @param counter #PCounter to reset.
+ * @return Value taken from the counter.
+ * @since 0.0.5
+ *
+ * Every slot is reset separately, so the updates going on during the call
+ * are either included into the returned value or stay in the counter, none of
+ * them is lost. Use it to collect the statistics periodically.
+ */
+P_LIB_API pint64	p_counter_reset		(PCounter	*counter);
+
+/**
+ * @brief Frees a sharded counter.
+ * @param counter #PCounter to free.
+ * @since 0.0.5
+ */
+P_LIB_API void		p_counter_free		(PCounter	*counter);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PCOUNTER_H */
@@ -0,0 +1,190 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PCPUFEATURES_PRIVATE_H
+#define PLIBSYS_HEADER_PCPUFEATURES_PRIVATE_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+#include "pcpufeatures.h"
+
+P_BEGIN_DECLS
+
+/**
+ * @def P_CPU_X86_SHA
+ * @brief Defined if the x86 SHA extensions code can be compiled.
+ *
+ * Such code must be placed into the functions marked with
+ * #P_CPU_X86_SHA_TARGET and called only if p_cpu_has_feature_internal()
+ * reports the extensions.
+ */
+
+/**
+ * @def P_CPU_ARM_SHA
+ * @brief Defined if the ARMv8 Cryptographic Extension is targeted.
+ *
+ * The compiler assumes that the instructions are always there, so they don't
+ * need a runtime check.
+ */
+
+#if defined (PLIBSYS_HAS_X86_SHA_INTRINSICS)
+#  define P_CPU_X86_SHA
+#  define P_CPU_X86_SHA_TARGET __attribute__ ((target ("sha,ssse3,sse4.1")))
+#elif defined (P_CC_MSVC) && (_MSC_VER >= 1900) && (defined (P_CPU_X86_32) || defined (P_CPU_X86_64))
+#  define P_CPU_X86_SHA
+#  define P_CPU_X86_SHA_TARGET
+#elif defined (P_CPU_ARM_64) && (defined (__ARM_FEATURE_CRYPTO) || defined (__ARM_FEATURE_SHA2))
+#  define P_CPU_ARM_SHA
+#endif
+
+/**
+ * @def P_CPU_X86_CRC32
+ * @brief Defined if the SSE4.2 CRC32 code can be compiled.
+ *
+ * Such code must be placed into the functions marked with
+ * #P_CPU_X86_CRC32_TARGET and called only if p_cpu_has_feature_internal()
+ * reports #P_CPU_FEATURE_CRC32C.
+ */
+
+/**
+ * @def P_CPU_ARM_CRC32
+ * @brief Defined if the ARMv8 CRC32 instructions are targeted, no runtime
+ * check is needed.
+ */
+
+#if defined (PLIBSYS_HAS_X86_CRC32_INTRINSICS)
+#  define P_CPU_X86_CRC32
+#  define P_CPU_X86_CRC32_TARGET __attribute__ ((target ("sse4.2")))
+#elif defined (P_CC_MSVC) && (_MSC_VER >= 1500) && (defined (P_CPU_X86_32) || defined (P_CPU_X86_64))
+#  define P_CPU_X86_CRC32
+#  define P_CPU_X86_CRC32_TARGET
+#elif defined (P_CPU_ARM_64) && defined (__ARM_FEATURE_CRC32)
+#  define P_CPU_ARM_CRC32
+#endif
+
+/**
+ * @def P_CPU_X86_BMI
+ * @brief Defined if plain C code can be compiled for x86-64 with the BMI1
+ * and BMI2 instructions (andn, rorx and others).
+ *
+ * Such code must be placed into the functions marked with
+ * #P_CPU_X86_BMI_TARGET and called only if p_cpu_has_feature_internal()
+ * reports #P_CPU_FEATURE_BMI.
+ */
+
+/**
+ * @def P_CPU_ARM_SHA3
+ * @brief Defined if the ARMv8.2 SHA3 instructions (EOR3, RAX1, XAR, BCAX)
+ * are targeted, no runtime check is needed.
+ */
+
+#if defined (PLIBSYS_HAS_X86_BMI_TARGET) && defined (P_CPU_X86_64)
+#  define P_CPU_X86_BMI
+#  define P_CPU_X86_BMI_TARGET __attribute__ ((target ("bmi,bmi2")))
+#elif defined (P_CPU_ARM_64) && defined (__ARM_FEATURE_SHA3)
+#  define P_CPU_ARM_SHA3
+#endif
+
+/**
+ * @brief Checks whether the given extension can be used by the library.
+ * @param feature Extension to check.
+ * @return TRUE if the extension can be used, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * Unlike p_cpu_has_feature() only the extensions the library has the code
+ * compiled for are reported. The CPU is queried only once, the result is
+ * cached.
+ */
+pboolean	p_cpu_has_feature_internal	(PCpuFeature	feature);
+
+/** Generic implementation pointer, cast it back to the real type. */
+typedef void (*PCpuImplFunc) (void);
+
+/** Implementation of a routine with the extensions it requires. */
+typedef struct PCpuImpl_ {
+	puint32		features;	/**< Required #PCpuFeature mask, 0 for the portable one.	*/
+	PCpuImplFunc	func;		/**< Implementation.						*/
+} PCpuImpl;
+
+/**
+ * @brief Selects the best implementation the running CPU can execute.
+ * @param impls Implementations, the preferred ones first, the last one must
+ * require no extensions.
+ * @param cache Resolved index storage, must be initialized with -1.
+ * @return Selected implementation.
+ * @since 0.0.5
+ *
+ * The first implementation whose extensions are reported by
+ * p_cpu_has_feature_internal() is selected and its index is stored in
+ * @a cache, so the next calls only read it. The table is usually a static
+ * array next to the implementations:
+ * @code
+ * static const PCpuImpl pp_impls[] = {
+ * #ifdef P_CPU_X86_CRC32
+ *	{ P_CPU_FEATURE_CRC32C, (PCpuImplFunc) pp_crc_x86 },
+ * #endif
+ *	{ 0, (PCpuImplFunc) pp_crc_soft }
+ * };
+ * static volatile pint pp_impl = -1;
+ *
+ * func = (PCrcFunc) p_cpu_resolve_internal (pp_impls,
+ *					      sizeof (pp_impls) / sizeof (pp_impls[0]),
+ *					      &pp_impl);
+ * @endcode
+ */
+PCpuImplFunc	p_cpu_resolve_internal		(const PCpuImpl	*impls,
+						 pint		count,
+						 volatile pint	*cache);
+
+/**
+ * @def P_CPU_X86_TSC
+ * @brief Defined if the x86 time stamp counter reading code can be compiled.
+ *
+ * The counter can serve as a clock only if p_cpu_has_feature_internal()
+ * reports #P_CPU_FEATURE_INVARIANT_TSC, and rdtscp can be used only if
+ * #P_CPU_FEATURE_RDTSCP is reported.
+ */
+
+/**
+ * @def P_CPU_ARM_CNTVCT
+ * @brief Defined if the ARMv8 virtual counter (CNTVCT_EL0) reading code can
+ * be compiled, no runtime check is needed.
+ */
+
+#if defined (PLIBSYS_HAS_X86_TSC_INTRINSICS)
+#  define P_CPU_X86_TSC
+#elif defined (P_CC_MSVC) && (defined (P_CPU_X86_32) || defined (P_CPU_X86_64))
+#  define P_CPU_X86_TSC
+#elif defined (P_CPU_ARM_64) && defined (P_CC_GNU)
+#  define P_CPU_ARM_CNTVCT
+#endif
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PCPUFEATURES_PRIVATE_H */
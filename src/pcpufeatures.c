@@ -0,0 +1,445 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "patomic.h"
+#include "pcpufeatures.h"
+#include "pcpufeatures-private.h"
+
+#include <string.h>
+
+#if defined (P_CPU_X86_32) || defined (P_CPU_X86_64)
+#  if defined (PLIBSYS_HAS_X86_CPUID)
+#    define P_CPU_X86_CPUID
+#    include <cpuid.h>
+#  elif defined (P_CC_MSVC)
+#    define P_CPU_X86_CPUID
+#    include <intrin.h>
+#  endif
+#endif
+
+#if defined (P_CPU_ARM_32) || defined (P_CPU_ARM_64)
+#  if defined (P_OS_LINUX) && defined (PLIBSYS_HAS_GETAUXVAL)
+#    define P_CPU_ARM_AUXV
+#    include <sys/auxv.h>
+#  endif
+#endif
+
+#ifdef P_OS_MAC
+#  include <sys/types.h>
+#  include <sys/sysctl.h>
+#endif
+
+#define P_CPU_FEATURES_UNKNOWN	-1
+
+/* Bits of AT_HWCAP and AT_HWCAP2, the system headers may lack them */
+#define P_CPU_HWCAP64_ASIMD	(1UL << 1)
+#define P_CPU_HWCAP64_AES	(1UL << 3)
+#define P_CPU_HWCAP64_PMULL	(1UL << 4)
+#define P_CPU_HWCAP64_SHA1	(1UL << 5)
+#define P_CPU_HWCAP64_SHA2	(1UL << 6)
+#define P_CPU_HWCAP64_CRC32	(1UL << 7)
+#define P_CPU_HWCAP64_ATOMICS	(1UL << 8)
+#define P_CPU_HWCAP64_SHA3	(1UL << 17)
+#define P_CPU_HWCAP32_NEON	(1UL << 12)
+#define P_CPU_HWCAP2_32_AES	(1UL << 0)
+#define P_CPU_HWCAP2_32_PMULL	(1UL << 1)
+#define P_CPU_HWCAP2_32_SHA1	(1UL << 2)
+#define P_CPU_HWCAP2_32_SHA2	(1UL << 3)
+#define P_CPU_HWCAP2_32_CRC32	(1UL << 4)
+
+/* Windows on ARM, older SDKs lack these */
+#define P_CPU_PF_ARM_V8_CRYPTO	30
+#define P_CPU_PF_ARM_V8_CRC32	31
+#define P_CPU_PF_ARM_V81_ATOMIC	34
+
+/* Accelerated code the library has for the extensions, they are reported
+ * internally only if the code was compiled in */
+#define P_CPU_FEATURES_GATED	(P_CPU_FEATURE_SHA1 | P_CPU_FEATURE_SHA2_256 | \
+				 P_CPU_FEATURE_CRC32C | P_CPU_FEATURE_BMI | \
+				 P_CPU_FEATURE_INVARIANT_TSC | P_CPU_FEATURE_RDTSCP)
+
+#if defined (P_CPU_X86_SHA) || defined (P_CPU_ARM_SHA)
+#  define P_CPU_FEATURES_HAS_SHA	(P_CPU_FEATURE_SHA1 | P_CPU_FEATURE_SHA2_256)
+#else
+#  define P_CPU_FEATURES_HAS_SHA	0
+#endif
+
+#if defined (P_CPU_X86_CRC32) || defined (P_CPU_ARM_CRC32)
+#  define P_CPU_FEATURES_HAS_CRC32	P_CPU_FEATURE_CRC32C
+#else
+#  define P_CPU_FEATURES_HAS_CRC32	0
+#endif
+
+#if defined (P_CPU_X86_BMI)
+#  define P_CPU_FEATURES_HAS_BMI	P_CPU_FEATURE_BMI
+#else
+#  define P_CPU_FEATURES_HAS_BMI	0
+#endif
+
+#if defined (P_CPU_X86_TSC)
+#  define P_CPU_FEATURES_HAS_TSC	(P_CPU_FEATURE_INVARIANT_TSC | P_CPU_FEATURE_RDTSCP)
+#else
+#  define P_CPU_FEATURES_HAS_TSC	0
+#endif
+
+#define P_CPU_FEATURES_COMPILED	(P_CPU_FEATURES_HAS_SHA | P_CPU_FEATURES_HAS_CRC32 | \
+				 P_CPU_FEATURES_HAS_BMI | P_CPU_FEATURES_HAS_TSC)
+
+static volatile pint pp_cpu_features = P_CPU_FEATURES_UNKNOWN;
+
+#ifdef P_CPU_X86_CPUID
+static pboolean pp_cpu_cpuid (puint32 leaf, puint32 regs[4]);
+static puint64 pp_cpu_xgetbv (void);
+static pint pp_cpu_detect_x86 (void);
+#endif
+#ifdef P_CPU_ARM_AUXV
+static pint pp_cpu_detect_arm_auxv (void);
+#endif
+#ifdef P_OS_MAC
+static pboolean pp_cpu_sysctl_flag (const pchar *name);
+#endif
+static pint pp_cpu_detect_features (void);
+static pint pp_cpu_get_features (void);
+
+#ifdef P_CPU_X86_CPUID
+static pboolean
+pp_cpu_cpuid (puint32	leaf,
+	      puint32	regs[4])
+{
+#  if defined (P_CC_MSVC)
+	pint	info[4];
+	pint	i;
+
+	/* Extended leaves have their own maximum */
+	__cpuid (info, (pint) (leaf & 0x80000000U));
+
+	if ((puint32) info[0] < leaf)
+		return FALSE;
+
+	__cpuidex (info, (pint) leaf, 0);
+
+	for (i = 0; i < 4; ++i)
+		regs[i] = (puint32) info[i];
+
+	return TRUE;
+#  else
+	return __get_cpuid_count (leaf, 0, &regs[0], &regs[1], &regs[2], &regs[3]) != 0 ? TRUE : FALSE;
+#  endif
+}
+
+/* Must be called only if OSXSAVE is reported */
+static puint64
+pp_cpu_xgetbv (void)
+{
+#  if defined (P_CC_MSVC)
+#    if (_MSC_FULL_VER >= 160040219)
+	return (puint64) _xgetbv (0);
+#    else
+	return 0;
+#    endif
+#  else
+	puint32 lo;
+	puint32 hi;
+
+	/* Encoded by hand for the assemblers not knowing xgetbv */
+	__asm__ __volatile__ (".byte 0x0f, 0x01, 0xd0" : "=a" (lo), "=d" (hi) : "c" (0));
+
+	return ((puint64) hi << 32) | lo;
+#  endif
+}
+
+static pint
+pp_cpu_detect_x86 (void)
+{
+	pint	features = 0;
+	puint32	leaf1[4];
+	puint32	leaf7[4];
+	puint32	ext_leaf[4];
+	puint64	xcr0 = 0;
+
+	if (pp_cpu_cpuid (1, leaf1) == FALSE)
+		return 0;
+
+	if (pp_cpu_cpuid (7, leaf7) == FALSE)
+		memset (leaf7, 0, sizeof (leaf7));
+
+	if ((leaf1[3] & (1U << 26)) != 0)
+		features |= P_CPU_FEATURE_SSE2;
+
+	if ((leaf1[2] & (1U << 9)) != 0)
+		features |= P_CPU_FEATURE_SSSE3;
+
+	if ((leaf1[2] & (1U << 19)) != 0)
+		features |= P_CPU_FEATURE_SSE4_1;
+
+	/* The CRC32 instruction comes with SSE4.2 */
+	if ((leaf1[2] & (1U << 20)) != 0)
+		features |= P_CPU_FEATURE_SSE4_2 | P_CPU_FEATURE_CRC32C;
+
+	if ((leaf1[2] & (1U << 23)) != 0)
+		features |= P_CPU_FEATURE_POPCNT;
+
+	if ((leaf1[2] & (1U << 25)) != 0)
+		features |= P_CPU_FEATURE_AES;
+
+	if ((leaf1[2] & (1U << 1)) != 0)
+		features |= P_CPU_FEATURE_CLMUL;
+
+	/* SHA needs SSSE3 and SSE4.1 for the byte shuffles and blends */
+	if ((leaf1[2] & (1U << 9)) != 0 && (leaf1[2] & (1U << 19)) != 0 && (leaf7[1] & (1U << 29)) != 0)
+		features |= P_CPU_FEATURE_SHA1 | P_CPU_FEATURE_SHA2_256;
+
+	if ((leaf7[1] & (1U << 3)) != 0 && (leaf7[1] & (1U << 8)) != 0)
+		features |= P_CPU_FEATURE_BMI;
+
+	/* The wide registers are usable only if the system saves them on the
+	 * context switches: XMM and YMM state for AVX, plus the opmask and the
+	 * upper ZMM state for AVX-512 */
+	if ((leaf1[2] & (1U << 27)) != 0)
+		xcr0 = pp_cpu_xgetbv ();
+
+	if ((leaf1[2] & (1U << 28)) != 0 && (xcr0 & 0x06) == 0x06) {
+		features |= P_CPU_FEATURE_AVX;
+
+		if ((leaf7[1] & (1U << 5)) != 0)
+			features |= P_CPU_FEATURE_AVX2;
+
+		if ((leaf7[1] & (1U << 16)) != 0) {
+#  ifdef P_OS_MAC
+			/* macOS enables the AVX-512 state on the first use only */
+			if ((xcr0 & 0xE0) == 0xE0 || pp_cpu_sysctl_flag ("hw.optional.avx512f") == TRUE)
+#  else
+			if ((xcr0 & 0xE0) == 0xE0)
+#  endif
+				features |= P_CPU_FEATURE_AVX512F;
+		}
+	}
+
+	if (pp_cpu_cpuid (0x80000001U, ext_leaf) == TRUE && (ext_leaf[3] & (1U << 27)) != 0)
+		features |= P_CPU_FEATURE_RDTSCP;
+
+	if (pp_cpu_cpuid (0x80000007U, ext_leaf) == TRUE && (ext_leaf[3] & (1U << 8)) != 0)
+		features |= P_CPU_FEATURE_INVARIANT_TSC;
+
+	return features;
+}
+#endif
+
+#ifdef P_CPU_ARM_AUXV
+static pint
+pp_cpu_detect_arm_auxv (void)
+{
+	pint		features = 0;
+	unsigned long	hwcap    = getauxval (AT_HWCAP);
+#  ifdef P_CPU_ARM_64
+	if ((hwcap & P_CPU_HWCAP64_ASIMD) != 0)
+		features |= P_CPU_FEATURE_NEON;
+
+	if ((hwcap & P_CPU_HWCAP64_AES) != 0)
+		features |= P_CPU_FEATURE_AES;
+
+	if ((hwcap & P_CPU_HWCAP64_PMULL) != 0)
+		features |= P_CPU_FEATURE_CLMUL;
+
+	if ((hwcap & P_CPU_HWCAP64_SHA1) != 0)
+		features |= P_CPU_FEATURE_SHA1;
+
+	if ((hwcap & P_CPU_HWCAP64_SHA2) != 0)
+		features |= P_CPU_FEATURE_SHA2_256;
+
+	if ((hwcap & P_CPU_HWCAP64_CRC32) != 0)
+		features |= P_CPU_FEATURE_CRC32C;
+
+	if ((hwcap & P_CPU_HWCAP64_ATOMICS) != 0)
+		features |= P_CPU_FEATURE_ATOMICS;
+
+	if ((hwcap & P_CPU_HWCAP64_SHA3) != 0)
+		features |= P_CPU_FEATURE_SHA3;
+#  else
+	/* 32-bit kernels report the ARMv8 extensions separately */
+	unsigned long	hwcap2   = getauxval (AT_HWCAP2);
+
+	if ((hwcap & P_CPU_HWCAP32_NEON) != 0)
+		features |= P_CPU_FEATURE_NEON;
+
+	if ((hwcap2 & P_CPU_HWCAP2_32_AES) != 0)
+		features |= P_CPU_FEATURE_AES;
+
+	if ((hwcap2 & P_CPU_HWCAP2_32_PMULL) != 0)
+		features |= P_CPU_FEATURE_CLMUL;
+
+	if ((hwcap2 & P_CPU_HWCAP2_32_SHA1) != 0)
+		features |= P_CPU_FEATURE_SHA1;
+
+	if ((hwcap2 & P_CPU_HWCAP2_32_SHA2) != 0)
+		features |= P_CPU_FEATURE_SHA2_256;
+
+	if ((hwcap2 & P_CPU_HWCAP2_32_CRC32) != 0)
+		features |= P_CPU_FEATURE_CRC32C;
+#  endif
+
+	return features;
+}
+#endif
+
+#ifdef P_OS_MAC
+static pboolean
+pp_cpu_sysctl_flag (const pchar *name)
+{
+	pint	value = 0;
+	size_t	len   = sizeof (value);
+
+	if (sysctlbyname (name, &value, &len, NULL, 0) != 0)
+		return FALSE;
+
+	return value != 0 ? TRUE : FALSE;
+}
+#endif
+
+static pint
+pp_cpu_detect_features (void)
+{
+	pint features = 0;
+
+#if defined (P_CPU_X86_CPUID)
+	features |= pp_cpu_detect_x86 ();
+#elif defined (P_CPU_X86_64)
+	features |= P_CPU_FEATURE_SSE2;
+#endif
+
+#if defined (P_CPU_ARM_AUXV)
+	features |= pp_cpu_detect_arm_auxv ();
+#elif defined (P_CPU_ARM_64) && defined (P_OS_MAC)
+	/* Every Apple ARM64 CPU has the ARMv8 Cryptographic Extension */
+	features |= P_CPU_FEATURE_NEON | P_CPU_FEATURE_AES | P_CPU_FEATURE_CLMUL |
+		    P_CPU_FEATURE_SHA1 | P_CPU_FEATURE_SHA2_256;
+
+	if (pp_cpu_sysctl_flag ("hw.optional.armv8_crc32") == TRUE)
+		features |= P_CPU_FEATURE_CRC32C;
+
+	if (pp_cpu_sysctl_flag ("hw.optional.armv8_1_atomics") == TRUE)
+		features |= P_CPU_FEATURE_ATOMICS;
+
+	if (pp_cpu_sysctl_flag ("hw.optional.armv8_2_sha3") == TRUE)
+		features |= P_CPU_FEATURE_SHA3;
+#elif defined (P_CPU_ARM_64) && defined (P_OS_WIN)
+	features |= P_CPU_FEATURE_NEON;
+
+	if (IsProcessorFeaturePresent (P_CPU_PF_ARM_V8_CRYPTO))
+		features |= P_CPU_FEATURE_AES | P_CPU_FEATURE_CLMUL |
+			    P_CPU_FEATURE_SHA1 | P_CPU_FEATURE_SHA2_256;
+
+	if (IsProcessorFeaturePresent (P_CPU_PF_ARM_V8_CRC32))
+		features |= P_CPU_FEATURE_CRC32C;
+
+	if (IsProcessorFeaturePresent (P_CPU_PF_ARM_V81_ATOMIC))
+		features |= P_CPU_FEATURE_ATOMICS;
+#endif
+
+	/* Whatever the compiler was allowed to use is there for sure */
+#if defined (__ARM_NEON) || defined (__ARM_NEON__)
+	features |= P_CPU_FEATURE_NEON;
+#endif
+
+#if defined (P_CPU_ARM_SHA)
+	features |= P_CPU_FEATURE_SHA1 | P_CPU_FEATURE_SHA2_256;
+#endif
+
+#if defined (P_CPU_ARM_CRC32)
+	features |= P_CPU_FEATURE_CRC32C;
+#endif
+
+#if defined (P_CPU_ARM_SHA3)
+	features |= P_CPU_FEATURE_SHA3;
+#endif
+
+#if defined (P_CPU_ARM) && defined (__ARM_FEATURE_ATOMICS)
+	features |= P_CPU_FEATURE_ATOMICS;
+#endif
+
+	return features;
+}
+
+static pint
+pp_cpu_get_features (void)
+{
+	pint features = p_atomic_int_get (&pp_cpu_features);
+
+	/* Racing threads get the same answer anyway */
+	if (P_UNLIKELY (features == P_CPU_FEATURES_UNKNOWN)) {
+		features = pp_cpu_detect_features ();
+		p_atomic_int_set (&pp_cpu_features, features);
+	}
+
+	return features;
+}
+
+P_LIB_API pboolean
+p_cpu_has_feature (PCpuFeature feature)
+{
+	return (pp_cpu_get_features () & (pint) feature) != 0 ? TRUE : FALSE;
+}
+
+P_LIB_API puint32
+p_cpu_get_features (void)
+{
+	return (puint32) pp_cpu_get_features ();
+}
+
+pboolean
+p_cpu_has_feature_internal (PCpuFeature feature)
+{
+	pint features = pp_cpu_get_features ();
+
+	features &= ~P_CPU_FEATURES_GATED | P_CPU_FEATURES_COMPILED;
+
+	return (features & (pint) feature) != 0 ? TRUE : FALSE;
+}
+
+PCpuImplFunc
+p_cpu_resolve_internal (const PCpuImpl	*impls,
+			pint		count,
+			volatile pint	*cache)
+{
+	pint	index = p_atomic_int_get (cache);
+	pint	features;
+
+	if (P_LIKELY (index >= 0))
+		return impls[index].func;
+
+	features = pp_cpu_get_features ();
+	features &= ~P_CPU_FEATURES_GATED | P_CPU_FEATURES_COMPILED;
+
+	/* The last one is the portable fallback */
+	for (index = 0; index < count - 1; ++index) {
+		if ((features & (pint) impls[index].features) == (pint) impls[index].features)
+			break;
+	}
+
+	/* Racing threads select the same one anyway */
+	p_atomic_int_set (cache, index);
+
+	return impls[index].func;
+}
@@ -0,0 +1,113 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pcpufeatures.h
+ * @brief CPU features
+ * @author Alexander Saprykin
+ *
+ * The CPU detection macros from pmacroscpu.h tell which architecture the code
+ * is compiled for, but not which optional instruction set extensions the
+ * running CPU supports. A binary built for a generic x86-64 target can run
+ * on a CPU with AVX2 and SHA extensions as well as on a CPU without them, so
+ * the faster code paths must be selected at runtime.
+ *
+ * p_cpu_has_feature() checks a single #PCpuFeature and p_cpu_get_features()
+ * returns all of the supported ones as a bit mask. The CPU is queried only
+ * once, on the first call, and the result is cached, so both calls are cheap
+ * enough to be used before every operation, though it is better to resolve
+ * the implementation once and keep a pointer to it.
+ *
+ * On x86 the features are read with the cpuid instruction, and the state of
+ * the AVX and AVX-512 registers is additionally checked with xgetbv, because
+ * the operating system may not enable them. On ARM the features are taken
+ * from the auxiliary vector (getauxval()) on Linux, from the hw.optional.*
+ * sysctl values on macOS and from IsProcessorFeaturePresent() on Windows.
+ * Elsewhere only the extensions the library was compiled for (the compiler
+ * assumes them to be always there) are reported.
+ *
+ * The library itself uses this information to select the accelerated
+ * implementations of the hash functions and other hot routines, only the
+ * ones which were compiled in are used, though.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PCPUFEATURES_H
+#define PLIBSYS_HEADER_PCPUFEATURES_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+
+P_BEGIN_DECLS
+
+/** Optional CPU instruction set extensions. */
+typedef enum PCpuFeature_ {
+	P_CPU_FEATURE_SHA1		= 1 << 0,	/**< SHA-1 instructions (x86, ARM).		*/
+	P_CPU_FEATURE_SHA2_256		= 1 << 1,	/**< SHA-256 instructions (x86, ARM).		*/
+	P_CPU_FEATURE_CRC32C		= 1 << 2,	/**< CRC32C instructions (x86 SSE4.2, ARM).	*/
+	P_CPU_FEATURE_BMI		= 1 << 3,	/**< BMI1 and BMI2 instructions (x86).		*/
+	P_CPU_FEATURE_INVARIANT_TSC	= 1 << 4,	/**< Constant rate time stamp counter (x86).	*/
+	P_CPU_FEATURE_RDTSCP		= 1 << 5,	/**< rdtscp instruction (x86).			*/
+	P_CPU_FEATURE_SSE2		= 1 << 6,	/**< SSE2 instructions (x86).			*/
+	P_CPU_FEATURE_SSSE3		= 1 << 7,	/**< SSSE3 instructions (x86).			*/
+	P_CPU_FEATURE_SSE4_1		= 1 << 8,	/**< SSE4.1 instructions (x86).			*/
+	P_CPU_FEATURE_SSE4_2		= 1 << 9,	/**< SSE4.2 instructions (x86).			*/
+	P_CPU_FEATURE_POPCNT		= 1 << 10,	/**< popcnt instruction (x86).			*/
+	P_CPU_FEATURE_AVX		= 1 << 11,	/**< AVX instructions (x86).			*/
+	P_CPU_FEATURE_AVX2		= 1 << 12,	/**< AVX2 instructions (x86).			*/
+	P_CPU_FEATURE_AVX512F		= 1 << 13,	/**< AVX-512 Foundation instructions (x86).	*/
+	P_CPU_FEATURE_AES		= 1 << 14,	/**< AES instructions (x86, ARM).		*/
+	P_CPU_FEATURE_CLMUL		= 1 << 15,	/**< Carry-less multiplication (x86, ARM).	*/
+	P_CPU_FEATURE_NEON		= 1 << 16,	/**< NEON (Advanced SIMD) instructions (ARM).	*/
+	P_CPU_FEATURE_SHA3		= 1 << 17,	/**< ARMv8.2 SHA3 instructions (ARM).		*/
+	P_CPU_FEATURE_ATOMICS		= 1 << 18	/**< ARMv8.1 LSE atomic instructions (ARM).	*/
+} PCpuFeature;
+
+/**
+ * @brief Checks whether the running CPU supports the given extension.
+ * @param feature Extension to check.
+ * @return TRUE if the CPU (and the operating system, if it matters) supports
+ * the extension, FALSE otherwise or if the extension can't be detected.
+ * @since 0.0.5
+ *
+ * The CPU is queried only once, the result is cached.
+ */
+P_LIB_API pboolean	p_cpu_has_feature	(PCpuFeature	feature);
+
+/**
+ * @brief Gets all of the extensions supported by the running CPU.
+ * @return Bit mask of the supported #PCpuFeature values.
+ * @since 0.0.5
+ *
+ * The CPU is queried only once, the result is cached.
+ */
+P_LIB_API puint32	p_cpu_get_features	(void);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PCPUFEATURES_H */
@@ -0,0 +1,84 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PCPURELAX_PRIVATE_H
+#define PLIBSYS_HEADER_PCPURELAX_PRIVATE_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+#include "puthread.h"
+
+/**
+ * @def P_CPU_RELAX
+ * @brief Hints the CPU that the caller is spinning on a busy-wait loop.
+ *
+ * On x86 it is the PAUSE instruction, which saves power and avoids the
+ * pipeline flush on leaving the loop, on ARM and POWER it yields to the other
+ * hardware thread of the core. Elsewhere it does nothing.
+ */
+
+#if defined (P_CC_MSVC)
+#  define P_CPU_RELAX() YieldProcessor ()
+#elif defined (P_CC_GNU) && (defined (P_CPU_X86_32) || defined (P_CPU_X86_64))
+#  define P_CPU_RELAX() __asm__ __volatile__ ("pause" ::: "memory")
+#elif defined (P_CC_GNU) && (defined (P_CPU_ARM_64) || defined (P_CPU_ARM_V7) || defined (P_CPU_ARM_V8))
+#  define P_CPU_RELAX() __asm__ __volatile__ ("yield" ::: "memory")
+#elif defined (P_CC_GNU) && defined (P_CPU_POWER)
+#  define P_CPU_RELAX() __asm__ __volatile__ ("or 27,27,27" ::: "memory")
+#else
+#  define P_CPU_RELAX() do {} while (0)
+#endif
+
+/** Max number of P_CPU_RELAX() calls in a row for P_CPU_BACKOFF(). */
+#define P_CPU_MAX_BACKOFF 64
+
+/**
+ * @def P_CPU_BACKOFF
+ * @brief Waits a bit before the next attempt to take a busy lock.
+ * @param backoff #pint variable with the current number of relax rounds,
+ * start it from 1.
+ *
+ * The number of rounds doubles on every call up to #P_CPU_MAX_BACKOFF, after
+ * that the CPU is given away to other threads, which helps when there are
+ * more spinning threads than CPUs.
+ */
+#define P_CPU_BACKOFF(backoff)							\
+	do {									\
+		pint p_cpu_backoff_i;						\
+										\
+		for (p_cpu_backoff_i = 0; p_cpu_backoff_i < (backoff); ++p_cpu_backoff_i) \
+			P_CPU_RELAX ();						\
+										\
+		if ((backoff) < P_CPU_MAX_BACKOFF)				\
+			(backoff) <<= 1;					\
+		else								\
+			p_uthread_yield ();					\
+	} while (0)
+
+#endif /* PLIBSYS_HEADER_PCPURELAX_PRIVATE_H */
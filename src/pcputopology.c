@@ -0,0 +1,824 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "patomic.h"
+#include "pcputopology.h"
+#include "pmem.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef P_OS_LINUX
+#  include <unistd.h>
+#endif
+
+#ifdef P_OS_MAC
+#  include <sys/types.h>
+#  include <sys/sysctl.h>
+#endif
+
+#define P_CPU_TOPOLOGY_MAX_CPUS		P_UTHREAD_CPU_SET_SIZE
+#define P_CPU_TOPOLOGY_LINE_SIZE	256
+#define P_CPU_TOPOLOGY_PATH_SIZE	128
+#define P_CPU_TOPOLOGY_SYSFS_CPU	"/sys/devices/system/cpu"
+#define P_CPU_TOPOLOGY_SYSFS_NODE	"/sys/devices/system/node"
+
+#ifdef P_OS_WIN
+typedef BOOL (WINAPI * PCpuTopologyGetInfoFunc) (PSYSTEM_LOGICAL_PROCESSOR_INFORMATION, PDWORD);
+#endif
+
+/* Package and core are kept as reported by the system until the snapshot is
+ * complete, then they are renumbered densely */
+typedef struct PCpuTopologyCpu_ {
+	pint	package;
+	pint	core;
+	pint	node;
+	pint	cache[P_CPU_TOPOLOGY_MAX_CACHE_LEVEL];	/* Lowest CPU sharing the cache, -1 if unknown */
+} PCpuTopologyCpu;
+
+static volatile psize pp_cpu_topology_line_size = 0;
+
+struct PCpuTopology_ {
+	PCpuTopologyCpu	cpus[P_CPU_TOPOLOGY_MAX_CPUS];	/* Offline CPUs have package set to -1 */
+	pint		n_cpus;
+	pint		n_cores;
+	pint		n_packages;
+	pint		n_nodes;
+	psize		cache_size[P_CPU_TOPOLOGY_MAX_CACHE_LEVEL];
+	psize		line_size;
+};
+
+static void pp_cpu_topology_set_cpu (PCpuTopology *topology, pint cpu, pint package, pint core, pint node);
+static void pp_cpu_topology_fill_flat (PCpuTopology *topology);
+static void pp_cpu_topology_finish (PCpuTopology *topology);
+static pboolean pp_cpu_topology_fill (PCpuTopology *topology);
+#ifdef P_OS_LINUX
+static pboolean pp_cpu_topology_read_line (const pchar *path, pchar *line);
+static pboolean pp_cpu_topology_read_int (const pchar *path, pint *value);
+static pboolean pp_cpu_topology_parse_list (const pchar *line, PUThreadCpuSet *cpu_set);
+static psize pp_cpu_topology_parse_size (const pchar *line);
+static void pp_cpu_topology_fill_caches (PCpuTopology *topology, pint cpu, pboolean set_sizes);
+static void pp_cpu_topology_fill_nodes (PCpuTopology *topology);
+#endif
+#ifdef P_OS_MAC
+static void pp_cpu_topology_set_cache (PCpuTopology *topology, pint level, pint first_cpu, pint n_cpus);
+#endif
+
+static void
+pp_cpu_topology_set_cpu (PCpuTopology	*topology,
+			 pint		cpu,
+			 pint		package,
+			 pint		core,
+			 pint		node)
+{
+	if (cpu < 0 || cpu >= P_CPU_TOPOLOGY_MAX_CPUS)
+		return;
+
+	topology->cpus[cpu].package = package;
+	topology->cpus[cpu].core    = core;
+	topology->cpus[cpu].node    = node;
+}
+
+static void
+pp_cpu_topology_fill_flat (PCpuTopology *topology)
+{
+	pint n_cpus;
+	pint i;
+
+	n_cpus = p_uthread_ideal_count ();
+
+	if (n_cpus < 1)
+		n_cpus = 1;
+	else if (n_cpus > P_CPU_TOPOLOGY_MAX_CPUS)
+		n_cpus = P_CPU_TOPOLOGY_MAX_CPUS;
+
+	for (i = 0; i < n_cpus; ++i)
+		pp_cpu_topology_set_cpu (topology, i, 0, i, 0);
+}
+
+static void
+pp_cpu_topology_finish (PCpuTopology *topology)
+{
+	PCpuTopologyCpu	*cpus = topology->cpus;
+	pint		package[P_CPU_TOPOLOGY_MAX_CPUS];
+	pint		core[P_CPU_TOPOLOGY_MAX_CPUS];
+	pint		i;
+	pint		j;
+
+	topology->n_cpus     = 0;
+	topology->n_cores    = 0;
+	topology->n_packages = 0;
+	topology->n_nodes    = 0;
+
+	/* The system IDs are sparse and core IDs repeat across packages, so each
+	 * distinct pair gets the index of its first appearance */
+	for (i = 0; i < P_CPU_TOPOLOGY_MAX_CPUS; ++i) {
+		if (cpus[i].package < 0)
+			continue;
+
+		++topology->n_cpus;
+
+		for (j = 0; j < i; ++j)
+			if (cpus[j].package == cpus[i].package)
+				break;
+
+		package[i] = j < i ? package[j] : topology->n_packages++;
+
+		for (j = 0; j < i; ++j)
+			if (cpus[j].package == cpus[i].package && cpus[j].core == cpus[i].core)
+				break;
+
+		core[i] = j < i ? core[j] : topology->n_cores++;
+
+		if (cpus[i].node < 0)
+			cpus[i].node = 0;
+
+		for (j = 0; j < i; ++j)
+			if (cpus[j].package >= 0 && cpus[j].node == cpus[i].node)
+				break;
+
+		if (j == i)
+			++topology->n_nodes;
+	}
+
+	for (i = 0; i < P_CPU_TOPOLOGY_MAX_CPUS; ++i) {
+		if (cpus[i].package < 0)
+			continue;
+
+		cpus[i].package = package[i];
+		cpus[i].core    = core[i];
+	}
+}
+
+#ifdef P_OS_LINUX
+static pboolean
+pp_cpu_topology_read_line (const pchar	*path,
+			   pchar	*line)
+{
+	FILE		*file;
+	pboolean	result;
+
+	if ((file = fopen (path, "r")) == NULL)
+		return FALSE;
+
+	result = fgets (line, P_CPU_TOPOLOGY_LINE_SIZE, file) != NULL ? TRUE : FALSE;
+
+	fclose (file);
+
+	return result;
+}
+
+static pboolean
+pp_cpu_topology_read_int (const pchar	*path,
+			  pint		*value)
+{
+	pchar	line[P_CPU_TOPOLOGY_LINE_SIZE];
+	pchar	*end;
+	long	val;
+
+	if (pp_cpu_topology_read_line (path, line) == FALSE)
+		return FALSE;
+
+	val = strtol (line, &end, 10);
+
+	if (end == line)
+		return FALSE;
+
+	*value = (pint) val;
+
+	return TRUE;
+}
+
+static pboolean
+pp_cpu_topology_parse_list (const pchar		*line,
+			    PUThreadCpuSet	*cpu_set)
+{
+	const pchar	*cur = line;
+	pchar		*end;
+	long		first;
+	long		last;
+	long		i;
+	pboolean	found = FALSE;
+
+	p_uthread_cpu_set_clear (cpu_set);
+
+	/* The list looks like "0-3,8,10-11" */
+	while (*cur != '\0') {
+		first = strtol (cur, &end, 10);
+
+		if (end == cur)
+			break;
+
+		last = first;
+		cur  = end;
+
+		if (*cur == '-') {
+			last = strtol (cur + 1, &end, 10);
+
+			if (end == cur + 1)
+				break;
+
+			cur = end;
+		}
+
+		for (i = first; i <= last && i < P_CPU_TOPOLOGY_MAX_CPUS; ++i)
+			found |= p_uthread_cpu_set_add (cpu_set, (pint) i);
+
+		if (*cur != ',')
+			break;
+
+		++cur;
+	}
+
+	return found;
+}
+
+static psize
+pp_cpu_topology_parse_size (const pchar *line)
+{
+	pchar	*end;
+	long	val;
+
+	/* Sizes look like "48K" or "32M" */
+	val = strtol (line, &end, 10);
+
+	if (end == line || val <= 0)
+		return 0;
+
+	if (*end == 'K')
+		return (psize) val * 1024;
+	else if (*end == 'M')
+		return (psize) val * 1024 * 1024;
+	else
+		return (psize) val;
+}
+
+static void
+pp_cpu_topology_fill_caches (PCpuTopology	*topology,
+			     pint		cpu,
+			     pboolean		set_sizes)
+{
+	PUThreadCpuSet	shared;
+	pchar		path[P_CPU_TOPOLOGY_PATH_SIZE];
+	pchar		line[P_CPU_TOPOLOGY_LINE_SIZE];
+	pint		index;
+	pint		level;
+	pint		line_size;
+	pint		i;
+
+	for (index = 0; ; ++index) {
+		sprintf (path, P_CPU_TOPOLOGY_SYSFS_CPU "/cpu%d/cache/index%d/level", cpu, index);
+
+		if (pp_cpu_topology_read_int (path, &level) == FALSE)
+			break;
+
+		if (level < 1 || level > P_CPU_TOPOLOGY_MAX_CACHE_LEVEL)
+			continue;
+
+		sprintf (path, P_CPU_TOPOLOGY_SYSFS_CPU "/cpu%d/cache/index%d/type", cpu, index);
+
+		if (pp_cpu_topology_read_line (path, line) == FALSE || strncmp (line, "Instruction", 11) == 0)
+			continue;
+
+		sprintf (path, P_CPU_TOPOLOGY_SYSFS_CPU "/cpu%d/cache/index%d/shared_cpu_list", cpu, index);
+
+		if (pp_cpu_topology_read_line (path, line) == TRUE &&
+		    pp_cpu_topology_parse_list (line, &shared) == TRUE) {
+			for (i = 0; i < P_CPU_TOPOLOGY_MAX_CPUS; ++i)
+				if (p_uthread_cpu_set_contains (&shared, i) == TRUE)
+					break;
+
+			topology->cpus[cpu].cache[level - 1] = i;
+		}
+
+		if (set_sizes == FALSE)
+			continue;
+
+		sprintf (path, P_CPU_TOPOLOGY_SYSFS_CPU "/cpu%d/cache/index%d/size", cpu, index);
+
+		if (pp_cpu_topology_read_line (path, line) == TRUE)
+			topology->cache_size[level - 1] = pp_cpu_topology_parse_size (line);
+
+		sprintf (path, P_CPU_TOPOLOGY_SYSFS_CPU "/cpu%d/cache/index%d/coherency_line_size", cpu, index);
+
+		if (level == 1 && pp_cpu_topology_read_int (path, &line_size) == TRUE && line_size > 0)
+			topology->line_size = (psize) line_size;
+	}
+}
+
+static void
+pp_cpu_topology_fill_nodes (PCpuTopology *topology)
+{
+	PUThreadCpuSet	nodes;
+	PUThreadCpuSet	cpus;
+	pchar		path[P_CPU_TOPOLOGY_PATH_SIZE];
+	pchar		line[P_CPU_TOPOLOGY_LINE_SIZE];
+	pint		node;
+	pint		i;
+
+	if (pp_cpu_topology_read_line (P_CPU_TOPOLOGY_SYSFS_NODE "/online", line) == FALSE ||
+	    pp_cpu_topology_parse_list (line, &nodes) == FALSE)
+		return;
+
+	for (node = 0; node < P_UTHREAD_CPU_SET_SIZE; ++node) {
+		if (p_uthread_cpu_set_contains (&nodes, node) == FALSE)
+			continue;
+
+		sprintf (path, P_CPU_TOPOLOGY_SYSFS_NODE "/node%d/cpulist", node);
+
+		if (pp_cpu_topology_read_line (path, line) == FALSE ||
+		    pp_cpu_topology_parse_list (line, &cpus) == FALSE)
+			continue;
+
+		for (i = 0; i < P_CPU_TOPOLOGY_MAX_CPUS; ++i)
+			if (p_uthread_cpu_set_contains (&cpus, i) == TRUE)
+				topology->cpus[i].node = node;
+	}
+}
+#endif
+
+#ifdef P_OS_MAC
+static void
+pp_cpu_topology_set_cache (PCpuTopology	*topology,
+			   pint		level,
+			   pint		first_cpu,
+			   pint		n_cpus)
+{
+	pint i;
+
+	for (i = first_cpu; i < first_cpu + n_cpus && i < P_CPU_TOPOLOGY_MAX_CPUS; ++i)
+		topology->cpus[i].cache[level - 1] = first_cpu;
+}
+#endif
+
+static pboolean
+pp_cpu_topology_fill (PCpuTopology *topology)
+{
+#if defined (P_OS_LINUX)
+	PUThreadCpuSet	online;
+	pchar		path[P_CPU_TOPOLOGY_PATH_SIZE];
+	pchar		line[P_CPU_TOPOLOGY_LINE_SIZE];
+	pint		package;
+	pint		core;
+	pint		i;
+	pboolean	found = FALSE;
+
+	if (pp_cpu_topology_read_line (P_CPU_TOPOLOGY_SYSFS_CPU "/online", line) == FALSE ||
+	    pp_cpu_topology_parse_list (line, &online) == FALSE)
+		return FALSE;
+
+	for (i = 0; i < P_CPU_TOPOLOGY_MAX_CPUS; ++i) {
+		if (p_uthread_cpu_set_contains (&online, i) == FALSE)
+			continue;
+
+		/* Containers and some architectures don't expose the IDs */
+		sprintf (path, P_CPU_TOPOLOGY_SYSFS_CPU "/cpu%d/topology/physical_package_id", i);
+
+		if (pp_cpu_topology_read_int (path, &package) == FALSE || package < 0)
+			package = 0;
+
+		sprintf (path, P_CPU_TOPOLOGY_SYSFS_CPU "/cpu%d/topology/core_id", i);
+
+		if (pp_cpu_topology_read_int (path, &core) == FALSE || core < 0)
+			core = i;
+
+		pp_cpu_topology_set_cpu (topology, i, package, core, -1);
+		pp_cpu_topology_fill_caches (topology, i, !found);
+
+		found = TRUE;
+	}
+
+	pp_cpu_topology_fill_nodes (topology);
+
+#  ifdef _SC_LEVEL1_DCACHE_LINESIZE
+	if (topology->line_size == 0 && sysconf (_SC_LEVEL1_DCACHE_LINESIZE) > 0)
+		topology->line_size = (psize) sysconf (_SC_LEVEL1_DCACHE_LINESIZE);
+
+	if (topology->cache_size[0] == 0 && sysconf (_SC_LEVEL1_DCACHE_SIZE) > 0)
+		topology->cache_size[0] = (psize) sysconf (_SC_LEVEL1_DCACHE_SIZE);
+
+	if (topology->cache_size[1] == 0 && sysconf (_SC_LEVEL2_CACHE_SIZE) > 0)
+		topology->cache_size[1] = (psize) sysconf (_SC_LEVEL2_CACHE_SIZE);
+
+	if (topology->cache_size[2] == 0 && sysconf (_SC_LEVEL3_CACHE_SIZE) > 0)
+		topology->cache_size[2] = (psize) sysconf (_SC_LEVEL3_CACHE_SIZE);
+#  endif
+
+	return found;
+#elif defined (P_OS_WIN)
+	PCpuTopologyGetInfoFunc			get_info_func;
+	PSYSTEM_LOGICAL_PROCESSOR_INFORMATION	info;
+	DWORD					len = 0;
+	DWORD					count;
+	DWORD					i;
+	pint					cpu;
+	pint					first;
+	pint					level;
+
+	get_info_func = (PCpuTopologyGetInfoFunc) GetProcAddress (GetModuleHandleA ("kernel32.dll"),
+								  "GetLogicalProcessorInformation");
+
+	if (P_UNLIKELY (get_info_func == NULL))
+		return FALSE;
+
+	if (get_info_func (NULL, &len) == TRUE || GetLastError () != ERROR_INSUFFICIENT_BUFFER)
+		return FALSE;
+
+	if (P_UNLIKELY ((info = p_malloc0 (len)) == NULL))
+		return FALSE;
+
+	if (P_UNLIKELY (get_info_func (info, &len) == FALSE)) {
+		p_free (info);
+		return FALSE;
+	}
+
+	count = len / sizeof (SYSTEM_LOGICAL_PROCESSOR_INFORMATION);
+
+	/* Cores and packages are identified by the record index */
+	for (i = 0; i < count; ++i) {
+		for (cpu = 0; cpu < (pint) (sizeof (ULONG_PTR) * 8); ++cpu) {
+			if ((info[i].ProcessorMask & ((ULONG_PTR) 1 << cpu)) == 0)
+				continue;
+
+			if (info[i].Relationship == RelationProcessorCore) {
+				if (topology->cpus[cpu].package < 0)
+					topology->cpus[cpu].package = 0;
+
+				topology->cpus[cpu].core = (pint) i;
+			} else if (info[i].Relationship == RelationProcessorPackage)
+				topology->cpus[cpu].package = (pint) i;
+			else if (info[i].Relationship == RelationNumaNode)
+				topology->cpus[cpu].node = (pint) info[i].NumaNode.NodeNumber;
+		}
+
+		if (info[i].Relationship != RelationCache || info[i].Cache.Type == CacheInstruction)
+			continue;
+
+		level = (pint) info[i].Cache.Level;
+
+		if (level < 1 || level > P_CPU_TOPOLOGY_MAX_CACHE_LEVEL)
+			continue;
+
+		topology->cache_size[level - 1] = (psize) info[i].Cache.Size;
+
+		if (level == 1)
+			topology->line_size = (psize) info[i].Cache.LineSize;
+
+		first = -1;
+
+		for (cpu = 0; cpu < (pint) (sizeof (ULONG_PTR) * 8); ++cpu) {
+			if ((info[i].ProcessorMask & ((ULONG_PTR) 1 << cpu)) == 0)
+				continue;
+
+			if (first < 0)
+				first = cpu;
+
+			topology->cpus[cpu].cache[level - 1] = first;
+		}
+	}
+
+	p_free (info);
+
+	/* A CPU without a core record can't be described */
+	for (cpu = 0; cpu < P_CPU_TOPOLOGY_MAX_CPUS; ++cpu)
+		if (topology->cpus[cpu].core < 0)
+			topology->cpus[cpu].package = -1;
+
+	for (cpu = 0; cpu < P_CPU_TOPOLOGY_MAX_CPUS; ++cpu)
+		if (topology->cpus[cpu].package >= 0)
+			return TRUE;
+
+	return FALSE;
+#elif defined (P_OS_MAC)
+	puint64	cache_config[P_CPU_TOPOLOGY_MAX_CACHE_LEVEL + 1];
+	puint64	value;
+	pint	n_logical  = 0;
+	pint	n_physical = 0;
+	pint	n_packages = 0;
+	pint	level;
+	pint	cpu;
+	pint	shared;
+	size_t	len;
+
+	len = sizeof (n_logical);
+
+	if (sysctlbyname ("hw.logicalcpu", &n_logical, &len, NULL, 0) != 0 || n_logical < 1)
+		return FALSE;
+
+	len = sizeof (n_physical);
+
+	if (sysctlbyname ("hw.physicalcpu", &n_physical, &len, NULL, 0) != 0 || n_physical < 1)
+		n_physical = n_logical;
+
+	len = sizeof (n_packages);
+
+	if (sysctlbyname ("hw.packages", &n_packages, &len, NULL, 0) != 0 || n_packages < 1)
+		n_packages = 1;
+
+	if (n_logical > P_CPU_TOPOLOGY_MAX_CPUS)
+		n_logical = P_CPU_TOPOLOGY_MAX_CPUS;
+
+	if (n_physical > n_logical)
+		n_physical = n_logical;
+
+	if (n_packages > n_physical)
+		n_packages = n_physical;
+
+	/* macOS numbers the CPUs core by core and package by package */
+	for (cpu = 0; cpu < n_logical; ++cpu)
+		pp_cpu_topology_set_cpu (topology,
+					 cpu,
+					 cpu / (n_logical / n_packages),
+					 cpu / (n_logical / n_physical),
+					 0);
+
+	len = sizeof (value);
+
+	if (sysctlbyname ("hw.cachelinesize", &value, &len, NULL, 0) == 0)
+		topology->line_size = (psize) value;
+
+	len = sizeof (value);
+
+	if (sysctlbyname ("hw.l1dcachesize", &value, &len, NULL, 0) == 0)
+		topology->cache_size[0] = (psize) value;
+
+	len = sizeof (value);
+
+	if (sysctlbyname ("hw.l2cachesize", &value, &len, NULL, 0) == 0)
+		topology->cache_size[1] = (psize) value;
+
+	len = sizeof (value);
+
+	if (sysctlbyname ("hw.l3cachesize", &value, &len, NULL, 0) == 0)
+		topology->cache_size[2] = (psize) value;
+
+	/* The first entry of hw.cacheconfig is for memory, then the number of
+	 * CPUs sharing each cache level follows */
+	len = sizeof (cache_config);
+
+	if (sysctlbyname ("hw.cacheconfig", cache_config, &len, NULL, 0) == 0) {
+		for (level = 1; level <= P_CPU_TOPOLOGY_MAX_CACHE_LEVEL; ++level) {
+			if ((psize) level >= len / sizeof (puint64) || topology->cache_size[level - 1] == 0)
+				break;
+
+			shared = (pint) cache_config[level];
+
+			if (shared < 1)
+				continue;
+
+			for (cpu = 0; cpu < n_logical; cpu += shared)
+				pp_cpu_topology_set_cache (topology, level, cpu, shared);
+		}
+	}
+
+	return TRUE;
+#else
+	P_UNUSED (topology);
+	return FALSE;
+#endif
+}
+
+P_LIB_API PCpuTopology *
+p_cpu_topology_new (void)
+{
+	PCpuTopology	*ret;
+	pint		i;
+	pint		j;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PCpuTopology))) == NULL)) {
+		P_ERROR ("PCpuTopology::p_cpu_topology_new: failed to allocate memory");
+		return NULL;
+	}
+
+	for (i = 0; i < P_CPU_TOPOLOGY_MAX_CPUS; ++i) {
+		ret->cpus[i].package = -1;
+		ret->cpus[i].core    = -1;
+		ret->cpus[i].node    = -1;
+
+		for (j = 0; j < P_CPU_TOPOLOGY_MAX_CACHE_LEVEL; ++j)
+			ret->cpus[i].cache[j] = -1;
+	}
+
+	if (pp_cpu_topology_fill (ret) == FALSE)
+		pp_cpu_topology_fill_flat (ret);
+
+	pp_cpu_topology_finish (ret);
+
+	return ret;
+}
+
+P_LIB_API pint
+p_cpu_topology_get_cpu_count (const PCpuTopology *topology)
+{
+	if (P_UNLIKELY (topology == NULL))
+		return -1;
+
+	return topology->n_cpus;
+}
+
+P_LIB_API pint
+p_cpu_topology_get_core_count (const PCpuTopology *topology)
+{
+	if (P_UNLIKELY (topology == NULL))
+		return -1;
+
+	return topology->n_cores;
+}
+
+P_LIB_API pint
+p_cpu_topology_get_package_count (const PCpuTopology *topology)
+{
+	if (P_UNLIKELY (topology == NULL))
+		return -1;
+
+	return topology->n_packages;
+}
+
+P_LIB_API pint
+p_cpu_topology_get_numa_node_count (const PCpuTopology *topology)
+{
+	if (P_UNLIKELY (topology == NULL))
+		return -1;
+
+	return topology->n_nodes;
+}
+
+P_LIB_API psize
+p_cpu_topology_get_cache_size (const PCpuTopology	*topology,
+			       pint			level)
+{
+	if (P_UNLIKELY (topology == NULL || level < 1 || level > P_CPU_TOPOLOGY_MAX_CACHE_LEVEL))
+		return 0;
+
+	return topology->cache_size[level - 1];
+}
+
+P_LIB_API psize
+p_cpu_topology_get_cache_line_size (const PCpuTopology *topology)
+{
+	if (P_UNLIKELY (topology == NULL))
+		return 0;
+
+	return topology->line_size;
+}
+
+P_LIB_API psize
+p_cpu_topology_detect_cache_line_size (void)
+{
+	PCpuTopology	*topology;
+	psize		line_size;
+
+	if ((line_size = (psize) p_atomic_pointer_get (&pp_cpu_topology_line_size)) != 0)
+		return line_size;
+
+	if (P_UNLIKELY ((topology = p_cpu_topology_new ()) == NULL))
+		return P_CACHE_LINE_SIZE;
+
+	/* Racing callers detect the same value */
+	if ((line_size = topology->line_size) == 0)
+		line_size = P_CACHE_LINE_SIZE;
+
+	p_cpu_topology_free (topology);
+
+	p_atomic_pointer_set (&pp_cpu_topology_line_size, (ppointer) line_size);
+
+	return line_size;
+}
+
+P_LIB_API pint
+p_cpu_topology_get_cpu_core (const PCpuTopology	*topology,
+			     pint		cpu)
+{
+	if (P_UNLIKELY (topology == NULL || cpu < 0 || cpu >= P_CPU_TOPOLOGY_MAX_CPUS))
+		return -1;
+
+	return topology->cpus[cpu].package < 0 ? -1 : topology->cpus[cpu].core;
+}
+
+P_LIB_API pint
+p_cpu_topology_get_cpu_package (const PCpuTopology	*topology,
+				pint			cpu)
+{
+	if (P_UNLIKELY (topology == NULL || cpu < 0 || cpu >= P_CPU_TOPOLOGY_MAX_CPUS))
+		return -1;
+
+	return topology->cpus[cpu].package;
+}
+
+P_LIB_API pint
+p_cpu_topology_get_cpu_numa_node (const PCpuTopology	*topology,
+				  pint			cpu)
+{
+	if (P_UNLIKELY (topology == NULL || cpu < 0 || cpu >= P_CPU_TOPOLOGY_MAX_CPUS))
+		return -1;
+
+	return topology->cpus[cpu].package < 0 ? -1 : topology->cpus[cpu].node;
+}
+
+P_LIB_API pboolean
+p_cpu_topology_get_core_cpus (const PCpuTopology	*topology,
+			      pint			core,
+			      PUThreadCpuSet		*cpu_set)
+{
+	pboolean	found = FALSE;
+	pint		i;
+
+	if (P_UNLIKELY (topology == NULL || cpu_set == NULL))
+		return FALSE;
+
+	p_uthread_cpu_set_clear (cpu_set);
+
+	for (i = 0; i < P_CPU_TOPOLOGY_MAX_CPUS; ++i) {
+		if (topology->cpus[i].package < 0 || topology->cpus[i].core != core)
+			continue;
+
+		p_uthread_cpu_set_add (cpu_set, i);
+		found = TRUE;
+	}
+
+	return found;
+}
+
+P_LIB_API pboolean
+p_cpu_topology_get_numa_node_cpus (const PCpuTopology	*topology,
+				   pint			node,
+				   PUThreadCpuSet	*cpu_set)
+{
+	pboolean	found = FALSE;
+	pint		i;
+
+	if (P_UNLIKELY (topology == NULL || cpu_set == NULL))
+		return FALSE;
+
+	p_uthread_cpu_set_clear (cpu_set);
+
+	for (i = 0; i < P_CPU_TOPOLOGY_MAX_CPUS; ++i) {
+		if (topology->cpus[i].package < 0 || topology->cpus[i].node != node)
+			continue;
+
+		p_uthread_cpu_set_add (cpu_set, i);
+		found = TRUE;
+	}
+
+	return found;
+}
+
+P_LIB_API pboolean
+p_cpu_topology_get_cache_cpus (const PCpuTopology	*topology,
+			       pint			cpu,
+			       pint			level,
+			       PUThreadCpuSet		*cpu_set)
+{
+	pint first;
+	pint i;
+
+	if (P_UNLIKELY (topology == NULL || cpu_set == NULL))
+		return FALSE;
+
+	p_uthread_cpu_set_clear (cpu_set);
+
+	if (P_UNLIKELY (cpu < 0 || cpu >= P_CPU_TOPOLOGY_MAX_CPUS ||
+			level < 1 || level > P_CPU_TOPOLOGY_MAX_CACHE_LEVEL))
+		return FALSE;
+
+	if (topology->cpus[cpu].package < 0 || (first = topology->cpus[cpu].cache[level - 1]) < 0)
+		return FALSE;
+
+	for (i = 0; i < P_CPU_TOPOLOGY_MAX_CPUS; ++i)
+		if (topology->cpus[i].package >= 0 && topology->cpus[i].cache[level - 1] == first)
+			p_uthread_cpu_set_add (cpu_set, i);
+
+	return TRUE;
+}
+
+P_LIB_API void
+p_cpu_topology_free (PCpuTopology *topology)
+{
+	if (P_UNLIKELY (topology == NULL))
+		return;
+
+	p_free (topology);
+}
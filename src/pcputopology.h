@@ -0,0 +1,238 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pcputopology.h
+ * @brief CPU topology
+ * @author Alexander Saprykin
+ *
+ * p_uthread_ideal_count() tells how many logical CPUs are available, but not
+ * how they are laid out: which of them are SMT siblings of the same physical
+ * core, which ones share a cache, and which NUMA node each of them belongs to.
+ * #PCpuTopology describes that layout so thread pools and allocators can size
+ * and place themselves, i.e. run one worker per physical core or keep a pool
+ * of buffers per NUMA node.
+ *
+ * Use p_cpu_topology_new() to take a snapshot of the system topology. It holds
+ * the number of packages (sockets), physical cores, logical CPUs (hardware
+ * threads) and NUMA nodes, the L1, L2 and L3 data cache sizes and the cache
+ * line size, p_cpu_topology_detect_cache_line_size() returns the latter without
+ * keeping a snapshot. Every logical CPU is mapped to its core, package and NUMA node,
+ * and the CPUs sharing a core, a cache or a node can be collected into a
+ * #PUThreadCpuSet and passed to p_uthread_set_affinity() directly.
+ *
+ * On Linux the topology is read from sysfs, with sysconf() as a fallback. On
+ * Windows GetLogicalProcessorInformation() is used, it describes the CPUs of
+ * the current processor group only, the same ones the thread affinity calls
+ * work with. On macOS the hw.* sysctl values are used, and the CPUs are
+ * assumed to be numbered core by core. Elsewhere every logical CPU is reported
+ * as a separate core of a single package and a single NUMA node, and the
+ * cache sizes are unknown.
+ *
+ * CPUs are numbered the same way as for p_uthread_set_affinity() and
+ * p_uthread_current_cpu(), the numbering can have gaps if some CPUs are
+ * offline. Cores and packages are numbered densely from zero, NUMA nodes use
+ * the system numbering. The snapshot isn't updated when CPUs go online or
+ * offline, take a new one if that matters.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PCPUTOPOLOGY_H
+#define PLIBSYS_HEADER_PCPUTOPOLOGY_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+#include "puthread.h"
+
+P_BEGIN_DECLS
+
+/** CPU topology opaque data type. */
+typedef struct PCpuTopology_ PCpuTopology;
+
+/** Max cache level described by #PCpuTopology. */
+#define P_CPU_TOPOLOGY_MAX_CACHE_LEVEL	3
+
+/**
+ * @brief Takes a snapshot of the CPU topology.
+ * @return Pointer to a newly created #PCpuTopology object in case of success,
+ * NULL otherwise.
+ * @since 0.0.5
+ *
+ * The snapshot always describes at least one CPU, if the topology can't be
+ * obtained it falls back to p_uthread_ideal_count() flat CPUs.
+ */
+P_LIB_API PCpuTopology *	p_cpu_topology_new			(void);
+
+/**
+ * @brief Gets the number of logical CPUs (hardware threads).
+ * @param topology #PCpuTopology object.
+ * @return Number of logical CPUs, -1 in case of error.
+ * @since 0.0.5
+ */
+P_LIB_API pint		p_cpu_topology_get_cpu_count		(const PCpuTopology	*topology);
+
+/**
+ * @brief Gets the number of physical cores.
+ * @param topology #PCpuTopology object.
+ * @return Number of physical cores, -1 in case of error.
+ * @since 0.0.5
+ */
+P_LIB_API pint		p_cpu_topology_get_core_count		(const PCpuTopology	*topology);
+
+/**
+ * @brief Gets the number of physical packages (sockets).
+ * @param topology #PCpuTopology object.
+ * @return Number of packages, -1 in case of error.
+ * @since 0.0.5
+ */
+P_LIB_API pint		p_cpu_topology_get_package_count	(const PCpuTopology	*topology);
+
+/**
+ * @brief Gets the number of NUMA nodes with CPUs.
+ * @param topology #PCpuTopology object.
+ * @return Number of NUMA nodes, -1 in case of error.
+ * @since 0.0.5
+ *
+ * A system without NUMA support is reported as a single node.
+ */
+P_LIB_API pint		p_cpu_topology_get_numa_node_count	(const PCpuTopology	*topology);
+
+/**
+ * @brief Gets the size of a data cache level.
+ * @param topology #PCpuTopology object.
+ * @param level Cache level, from 1 to #P_CPU_TOPOLOGY_MAX_CACHE_LEVEL.
+ * @return Size of a single cache of the given level in bytes, 0 if the level is
+ * missing or unknown.
+ * @since 0.0.5
+ *
+ * The size is of one cache instance, i.e. the L2 cache of a single core, not a
+ * sum over all of them. Instruction caches are not taken into account.
+ */
+P_LIB_API psize		p_cpu_topology_get_cache_size		(const PCpuTopology	*topology,
+								 pint			level);
+
+/**
+ * @brief Gets the cache line size.
+ * @param topology #PCpuTopology object.
+ * @return Size of the L1 data cache line in bytes, 0 if unknown.
+ * @since 0.0.5
+ */
+P_LIB_API psize		p_cpu_topology_get_cache_line_size	(const PCpuTopology	*topology);
+
+/**
+ * @brief Detects the cache line size of the running CPU.
+ * @return Size of the L1 data cache line in bytes, #P_CACHE_LINE_SIZE if it
+ * can't be detected.
+ * @since 0.0.5
+ *
+ * Takes a topology snapshot on the first call only, the result is cached.
+ * Useful to check whether the compile-time #P_CACHE_LINE_SIZE matches the
+ * hardware.
+ */
+P_LIB_API psize		p_cpu_topology_detect_cache_line_size	(void);
+
+/**
+ * @brief Gets the physical core a logical CPU belongs to.
+ * @param topology #PCpuTopology object.
+ * @param cpu Logical CPU number.
+ * @return Core index starting from zero, -1 if the CPU is unknown.
+ * @since 0.0.5
+ */
+P_LIB_API pint		p_cpu_topology_get_cpu_core		(const PCpuTopology	*topology,
+								 pint			cpu);
+
+/**
+ * @brief Gets the package a logical CPU belongs to.
+ * @param topology #PCpuTopology object.
+ * @param cpu Logical CPU number.
+ * @return Package index starting from zero, -1 if the CPU is unknown.
+ * @since 0.0.5
+ */
+P_LIB_API pint		p_cpu_topology_get_cpu_package		(const PCpuTopology	*topology,
+								 pint			cpu);
+
+/**
+ * @brief Gets the NUMA node a logical CPU belongs to.
+ * @param topology #PCpuTopology object.
+ * @param cpu Logical CPU number.
+ * @return NUMA node number, -1 if the CPU is unknown.
+ * @since 0.0.5
+ */
+P_LIB_API pint		p_cpu_topology_get_cpu_numa_node	(const PCpuTopology	*topology,
+								 pint			cpu);
+
+/**
+ * @brief Gets the logical CPUs of a physical core.
+ * @param topology #PCpuTopology object.
+ * @param core Core index.
+ * @param[out] cpu_set Set to fill with the CPUs, cleared first.
+ * @return TRUE if at least one CPU was found, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_cpu_topology_get_core_cpus		(const PCpuTopology	*topology,
+								 pint			core,
+								 PUThreadCpuSet		*cpu_set);
+
+/**
+ * @brief Gets the logical CPUs of a NUMA node.
+ * @param topology #PCpuTopology object.
+ * @param node NUMA node number.
+ * @param[out] cpu_set Set to fill with the CPUs, cleared first.
+ * @return TRUE if at least one CPU was found, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_cpu_topology_get_numa_node_cpus	(const PCpuTopology	*topology,
+								 pint			node,
+								 PUThreadCpuSet		*cpu_set);
+
+/**
+ * @brief Gets the logical CPUs sharing a data cache with a given CPU.
+ * @param topology #PCpuTopology object.
+ * @param cpu Logical CPU number.
+ * @param level Cache level, from 1 to #P_CPU_TOPOLOGY_MAX_CACHE_LEVEL.
+ * @param[out] cpu_set Set to fill with the CPUs, cleared first.
+ * @return TRUE if the cache sharing is known, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The set includes @a cpu itself.
+ */
+P_LIB_API pboolean	p_cpu_topology_get_cache_cpus		(const PCpuTopology	*topology,
+								 pint			cpu,
+								 pint			level,
+								 PUThreadCpuSet		*cpu_set);
+
+/**
+ * @brief Frees a #PCpuTopology object.
+ * @param topology #PCpuTopology object to free.
+ * @since 0.0.5
+ */
+P_LIB_API void		p_cpu_topology_free			(PCpuTopology		*topology);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PCPUTOPOLOGY_H */
@@ -0,0 +1,416 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <string.h>
+#include <stdlib.h>
+
+#include "pmem.h"
+#include "pcryptohash-blake2.h"
+
+/* Unkeyed sequential mode with the full digest length only. The last block
+ * must be compressed with the final flag, so it is always kept in the buffer
+ * until the finish call. */
+
+#define P_BLAKE2B_BLOCK_SIZE	128
+#define P_BLAKE2S_BLOCK_SIZE	64
+
+struct PHashBLAKE2b_ {
+	puint64		h[8];
+	puint64		t[2];
+	puchar		buf[P_BLAKE2B_BLOCK_SIZE];
+	puint		buf_len;
+};
+
+struct PHashBLAKE2s_ {
+	puint32		h[8];
+	puint32		t[2];
+	puchar		buf[P_BLAKE2S_BLOCK_SIZE];
+	puint		buf_len;
+};
+
+static const puchar pp_crypto_hash_blake2_sigma[12][16] = {
+	{  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 },
+	{ 14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3 },
+	{ 11,  8, 12,  0,  5,  2, 15, 13, 10, 14,  3,  6,  7,  1,  9,  4 },
+	{  7,  9,  3,  1, 13, 12, 11, 14,  2,  6,  5, 10,  4,  0, 15,  8 },
+	{  9,  0,  5,  7,  2,  4, 10, 15, 14,  1, 11, 12,  6,  8,  3, 13 },
+	{  2, 12,  6, 10,  0, 11,  8,  3,  4, 13,  7,  5, 15, 14,  1,  9 },
+	{ 12,  5,  1, 15, 14, 13,  4, 10,  0,  7,  6,  3,  9,  2,  8, 11 },
+	{ 13, 11,  7, 14, 12,  1,  3,  9,  5,  0, 15,  4,  8,  6,  2, 10 },
+	{  6, 15, 14,  9, 11,  3,  0,  8, 12,  2, 13,  7,  1,  4, 10,  5 },
+	{ 10,  2,  8,  4,  7,  6,  1,  5, 15, 11,  9, 14,  3, 12, 13,  0 },
+	{  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 },
+	{ 14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3 }
+};
+
+static const puint64 pp_crypto_hash_blake2b_iv[8] = {
+	0x6A09E667F3BCC908ULL, 0xBB67AE8584CAA73BULL,
+	0x3C6EF372FE94F82BULL, 0xA54FF53A5F1D36F1ULL,
+	0x510E527FADE682D1ULL, 0x9B05688C2B3E6C1FULL,
+	0x1F83D9ABFB41BD6BULL, 0x5BE0CD19137E2179ULL
+};
+
+static const puint32 pp_crypto_hash_blake2s_iv[8] = {
+	0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A,
+	0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19
+};
+
+static void pp_crypto_hash_blake2b_process (PHashBLAKE2b *ctx, const puchar *block, pboolean last);
+static void pp_crypto_hash_blake2s_process (PHashBLAKE2s *ctx, const puchar *block, pboolean last);
+
+#define P_BLAKE2B_ROTR(val, shift) (((val) >> (shift)) | ((val) << (64 - (shift))))
+#define P_BLAKE2S_ROTR(val, shift) (((val) >> (shift)) | ((val) << (32 - (shift))))
+
+#define P_BLAKE2B_G(r, i, a, b, c, d)						\
+{										\
+	a = a + b + m[pp_crypto_hash_blake2_sigma[r][2 * (i) + 0]];		\
+	d = P_BLAKE2B_ROTR (d ^ a, 32);						\
+	c = c + d;								\
+	b = P_BLAKE2B_ROTR (b ^ c, 24);						\
+	a = a + b + m[pp_crypto_hash_blake2_sigma[r][2 * (i) + 1]];		\
+	d = P_BLAKE2B_ROTR (d ^ a, 16);						\
+	c = c + d;								\
+	b = P_BLAKE2B_ROTR (b ^ c, 63);						\
+}
+
+#define P_BLAKE2S_G(r, i, a, b, c, d)						\
+{										\
+	a = a + b + m[pp_crypto_hash_blake2_sigma[r][2 * (i) + 0]];		\
+	d = P_BLAKE2S_ROTR (d ^ a, 16);						\
+	c = c + d;								\
+	b = P_BLAKE2S_ROTR (b ^ c, 12);						\
+	a = a + b + m[pp_crypto_hash_blake2_sigma[r][2 * (i) + 1]];		\
+	d = P_BLAKE2S_ROTR (d ^ a, 8);						\
+	c = c + d;								\
+	b = P_BLAKE2S_ROTR (b ^ c, 7);						\
+}
+
+#define P_BLAKE2_ROUND(G, r)							\
+{										\
+	G (r, 0, v[0], v[4], v[ 8], v[12]);					\
+	G (r, 1, v[1], v[5], v[ 9], v[13]);					\
+	G (r, 2, v[2], v[6], v[10], v[14]);					\
+	G (r, 3, v[3], v[7], v[11], v[15]);					\
+	G (r, 4, v[0], v[5], v[10], v[15]);					\
+	G (r, 5, v[1], v[6], v[11], v[12]);					\
+	G (r, 6, v[2], v[7], v[ 8], v[13]);					\
+	G (r, 7, v[3], v[4], v[ 9], v[14]);					\
+}
+
+static void
+pp_crypto_hash_blake2b_process (PHashBLAKE2b	*ctx,
+				const puchar	*block,
+				pboolean	last)
+{
+	puint64	m[16];
+	puint64	v[16];
+	puint	i;
+
+	memcpy (m, block, P_BLAKE2B_BLOCK_SIZE);
+
+	for (i = 0; i < 16; ++i)
+		m[i] = PUINT64_FROM_LE (m[i]);
+
+	for (i = 0; i < 8; ++i) {
+		v[i]     = ctx->h[i];
+		v[i + 8] = pp_crypto_hash_blake2b_iv[i];
+	}
+
+	v[12] ^= ctx->t[0];
+	v[13] ^= ctx->t[1];
+
+	if (last == TRUE)
+		v[14] = ~v[14];
+
+	for (i = 0; i < 12; ++i)
+		P_BLAKE2_ROUND (P_BLAKE2B_G, i);
+
+	for (i = 0; i < 8; ++i)
+		ctx->h[i] ^= v[i] ^ v[i + 8];
+}
+
+static void
+pp_crypto_hash_blake2s_process (PHashBLAKE2s	*ctx,
+				const puchar	*block,
+				pboolean	last)
+{
+	puint32	m[16];
+	puint32	v[16];
+	puint	i;
+
+	memcpy (m, block, P_BLAKE2S_BLOCK_SIZE);
+
+	for (i = 0; i < 16; ++i)
+		m[i] = PUINT32_FROM_LE (m[i]);
+
+	for (i = 0; i < 8; ++i) {
+		v[i]     = ctx->h[i];
+		v[i + 8] = pp_crypto_hash_blake2s_iv[i];
+	}
+
+	v[12] ^= ctx->t[0];
+	v[13] ^= ctx->t[1];
+
+	if (last == TRUE)
+		v[14] = ~v[14];
+
+	for (i = 0; i < 10; ++i)
+		P_BLAKE2_ROUND (P_BLAKE2S_G, i);
+
+	for (i = 0; i < 8; ++i)
+		ctx->h[i] ^= v[i] ^ v[i + 8];
+}
+
+PHashBLAKE2b *
+p_crypto_hash_blake2b_init (ppointer	mem,
+			    psize	size)
+{
+	PHashBLAKE2b *ret;
+
+	if (P_UNLIKELY (mem == NULL || size < sizeof (PHashBLAKE2b)))
+		return NULL;
+
+	ret = (PHashBLAKE2b *) mem;
+	memset (ret, 0, sizeof (PHashBLAKE2b));
+
+	p_crypto_hash_blake2b_reset (ret);
+
+	return ret;
+}
+
+PHashBLAKE2b *
+p_crypto_hash_blake2b_new (void)
+{
+	PHashBLAKE2b *ret;
+
+	if (P_UNLIKELY ((ret = p_malloc (sizeof (PHashBLAKE2b))) == NULL))
+		return NULL;
+
+	return p_crypto_hash_blake2b_init (ret, sizeof (PHashBLAKE2b));
+}
+
+void
+p_crypto_hash_blake2b_reset (PHashBLAKE2b *ctx)
+{
+	memcpy (ctx->h, pp_crypto_hash_blake2b_iv, sizeof (ctx->h));
+
+	/* Parameter block: 64 bytes digest, no key, sequential mode */
+	ctx->h[0] ^= 0x01010000ULL ^ 64;
+
+	memset (ctx->buf, 0, P_BLAKE2B_BLOCK_SIZE);
+
+	ctx->t[0]    = 0;
+	ctx->t[1]    = 0;
+	ctx->buf_len = 0;
+}
+
+void
+p_crypto_hash_blake2b_update (PHashBLAKE2b	*ctx,
+			      const puchar	*data,
+			      psize		len)
+{
+	psize to_fill;
+
+	to_fill = P_BLAKE2B_BLOCK_SIZE - ctx->buf_len;
+
+	if (len > to_fill) {
+		memcpy (ctx->buf + ctx->buf_len, data, to_fill);
+
+		if ((ctx->t[0] += P_BLAKE2B_BLOCK_SIZE) < P_BLAKE2B_BLOCK_SIZE)
+			++ctx->t[1];
+
+		pp_crypto_hash_blake2b_process (ctx, ctx->buf, FALSE);
+
+		data += to_fill;
+		len -= to_fill;
+		ctx->buf_len = 0;
+
+		while (len > P_BLAKE2B_BLOCK_SIZE) {
+			if ((ctx->t[0] += P_BLAKE2B_BLOCK_SIZE) < P_BLAKE2B_BLOCK_SIZE)
+				++ctx->t[1];
+
+			pp_crypto_hash_blake2b_process (ctx, data, FALSE);
+
+			data += P_BLAKE2B_BLOCK_SIZE;
+			len -= P_BLAKE2B_BLOCK_SIZE;
+		}
+	}
+
+	if (len > 0) {
+		memcpy (ctx->buf + ctx->buf_len, data, len);
+		ctx->buf_len += (puint) len;
+	}
+}
+
+void
+p_crypto_hash_blake2b_finish (PHashBLAKE2b *ctx)
+{
+	puint i;
+
+	if ((ctx->t[0] += ctx->buf_len) < ctx->buf_len)
+		++ctx->t[1];
+
+	memset (ctx->buf + ctx->buf_len, 0, P_BLAKE2B_BLOCK_SIZE - ctx->buf_len);
+
+	pp_crypto_hash_blake2b_process (ctx, ctx->buf, TRUE);
+
+	for (i = 0; i < 8; ++i)
+		ctx->h[i] = PUINT64_TO_LE (ctx->h[i]);
+}
+
+const puchar *
+p_crypto_hash_blake2b_digest (PHashBLAKE2b *ctx)
+{
+	return (const puchar *) ctx->h;
+}
+
+void
+p_crypto_hash_blake2b_copy (PHashBLAKE2b	*dst,
+			    const PHashBLAKE2b	*src)
+{
+	memcpy (dst, src, sizeof (PHashBLAKE2b));
+}
+
+void
+p_crypto_hash_blake2b_free (PHashBLAKE2b *ctx)
+{
+	p_free (ctx);
+}
+
+PHashBLAKE2s *
+p_crypto_hash_blake2s_init (ppointer	mem,
+			    psize	size)
+{
+	PHashBLAKE2s *ret;
+
+	if (P_UNLIKELY (mem == NULL || size < sizeof (PHashBLAKE2s)))
+		return NULL;
+
+	ret = (PHashBLAKE2s *) mem;
+	memset (ret, 0, sizeof (PHashBLAKE2s));
+
+	p_crypto_hash_blake2s_reset (ret);
+
+	return ret;
+}
+
+PHashBLAKE2s *
+p_crypto_hash_blake2s_new (void)
+{
+	PHashBLAKE2s *ret;
+
+	if (P_UNLIKELY ((ret = p_malloc (sizeof (PHashBLAKE2s))) == NULL))
+		return NULL;
+
+	return p_crypto_hash_blake2s_init (ret, sizeof (PHashBLAKE2s));
+}
+
+void
+p_crypto_hash_blake2s_reset (PHashBLAKE2s *ctx)
+{
+	memcpy (ctx->h, pp_crypto_hash_blake2s_iv, sizeof (ctx->h));
+
+	/* Parameter block: 32 bytes digest, no key, sequential mode */
+	ctx->h[0] ^= 0x01010000 ^ 32;
+
+	memset (ctx->buf, 0, P_BLAKE2S_BLOCK_SIZE);
+
+	ctx->t[0]    = 0;
+	ctx->t[1]    = 0;
+	ctx->buf_len = 0;
+}
+
+void
+p_crypto_hash_blake2s_update (PHashBLAKE2s	*ctx,
+			      const puchar	*data,
+			      psize		len)
+{
+	psize to_fill;
+
+	to_fill = P_BLAKE2S_BLOCK_SIZE - ctx->buf_len;
+
+	if (len > to_fill) {
+		memcpy (ctx->buf + ctx->buf_len, data, to_fill);
+
+		if ((ctx->t[0] += P_BLAKE2S_BLOCK_SIZE) < P_BLAKE2S_BLOCK_SIZE)
+			++ctx->t[1];
+
+		pp_crypto_hash_blake2s_process (ctx, ctx->buf, FALSE);
+
+		data += to_fill;
+		len -= to_fill;
+		ctx->buf_len = 0;
+
+		while (len > P_BLAKE2S_BLOCK_SIZE) {
+			if ((ctx->t[0] += P_BLAKE2S_BLOCK_SIZE) < P_BLAKE2S_BLOCK_SIZE)
+				++ctx->t[1];
+
+			pp_crypto_hash_blake2s_process (ctx, data, FALSE);
+
+			data += P_BLAKE2S_BLOCK_SIZE;
+			len -= P_BLAKE2S_BLOCK_SIZE;
+		}
+	}
+
+	if (len > 0) {
+		memcpy (ctx->buf + ctx->buf_len, data, len);
+		ctx->buf_len += (puint) len;
+	}
+}
+
+void
+p_crypto_hash_blake2s_finish (PHashBLAKE2s *ctx)
+{
+	puint i;
+
+	if ((ctx->t[0] += ctx->buf_len) < ctx->buf_len)
+		++ctx->t[1];
+
+	memset (ctx->buf + ctx->buf_len, 0, P_BLAKE2S_BLOCK_SIZE - ctx->buf_len);
+
+	pp_crypto_hash_blake2s_process (ctx, ctx->buf, TRUE);
+
+	for (i = 0; i < 8; ++i)
+		ctx->h[i] = PUINT32_TO_LE (ctx->h[i]);
+}
+
+const puchar *
+p_crypto_hash_blake2s_digest (PHashBLAKE2s *ctx)
+{
+	return (const puchar *) ctx->h;
+}
+
+void
+p_crypto_hash_blake2s_copy (PHashBLAKE2s	*dst,
+			    const PHashBLAKE2s	*src)
+{
+	memcpy (dst, src, sizeof (PHashBLAKE2s));
+}
+
+void
+p_crypto_hash_blake2s_free (PHashBLAKE2s *ctx)
+{
+	p_free (ctx);
+}
@@ -0,0 +1,63 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* BLAKE2b and BLAKE2s interface implementation for #PCryptoHash */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PCRYPTOHASHBLAKE2_H
+#define PLIBSYS_HEADER_PCRYPTOHASHBLAKE2_H
+
+#include "ptypes.h"
+#include "pmacros.h"
+
+P_BEGIN_DECLS
+
+typedef struct PHashBLAKE2b_ PHashBLAKE2b;
+typedef struct PHashBLAKE2s_ PHashBLAKE2s;
+
+PHashBLAKE2b *	p_crypto_hash_blake2b_new	(void);
+PHashBLAKE2b *	p_crypto_hash_blake2b_init	(ppointer mem, psize size);
+void		p_crypto_hash_blake2b_update	(PHashBLAKE2b *ctx, const puchar *data, psize len);
+void		p_crypto_hash_blake2b_finish	(PHashBLAKE2b *ctx);
+const puchar *	p_crypto_hash_blake2b_digest	(PHashBLAKE2b *ctx);
+void		p_crypto_hash_blake2b_reset	(PHashBLAKE2b *ctx);
+void		p_crypto_hash_blake2b_free	(PHashBLAKE2b *ctx);
+void		p_crypto_hash_blake2b_copy	(PHashBLAKE2b *dst, const PHashBLAKE2b *src);
+
+PHashBLAKE2s *	p_crypto_hash_blake2s_new	(void);
+PHashBLAKE2s *	p_crypto_hash_blake2s_init	(ppointer mem, psize size);
+void		p_crypto_hash_blake2s_update	(PHashBLAKE2s *ctx, const puchar *data, psize len);
+void		p_crypto_hash_blake2s_finish	(PHashBLAKE2s *ctx);
+const puchar *	p_crypto_hash_blake2s_digest	(PHashBLAKE2s *ctx);
+void		p_crypto_hash_blake2s_reset	(PHashBLAKE2s *ctx);
+void		p_crypto_hash_blake2s_free	(PHashBLAKE2s *ctx);
+void		p_crypto_hash_blake2s_copy	(PHashBLAKE2s *dst, const PHashBLAKE2s *src);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PCRYPTOHASHBLAKE2_H */
@@ -0,0 +1,671 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* The input is split into 1 KiB chunks which are the leaves of a binary
+ * tree, the root node is finalized with a special flag. Chunks are
+ * independent, so once a whole aligned subtree of the input is available it
+ * is hashed at once: four chunks at a time in SIMD lanes and, with a thread
+ * pool set, several big parts of the subtree on the pool workers. Only the
+ * chaining values of the complete subtrees are kept between the updates. */
+
+#include <string.h>
+#include <stdlib.h>
+
+#include "pmem.h"
+#include "pcountdownlatch.h"
+#include "pcryptohash-blake3.h"
+#include "pcryptohash-multi.h"
+
+#define P_BLAKE3_BLOCK_LEN		64
+#define P_BLAKE3_CHUNK_LEN		1024
+#define P_BLAKE3_CHUNK_BLOCKS		(P_BLAKE3_CHUNK_LEN / P_BLAKE3_BLOCK_LEN)
+#define P_BLAKE3_MAX_DEPTH		54
+
+/* Smallest part of a subtree worth a thread pool task, in chunks */
+#define P_BLAKE3_TASK_MIN_CHUNKS	64
+#define P_BLAKE3_MAX_TASKS		64
+
+#define P_BLAKE3_CHUNK_START		(1 << 0)
+#define P_BLAKE3_CHUNK_END		(1 << 1)
+#define P_BLAKE3_PARENT			(1 << 2)
+#define P_BLAKE3_ROOT			(1 << 3)
+
+struct PHashBLAKE3_ {
+	puint32		cv_stack[P_BLAKE3_MAX_DEPTH][8];
+	puint		cv_stack_len;
+
+	/* Current chunk */
+	puint32		cv[8];
+	puint64		chunk_counter;
+	puchar		buf[P_BLAKE3_BLOCK_LEN];
+	puint		buf_len;
+	puint		blocks_compressed;
+
+	puint32		hash[8];
+	PThreadPool	*pool;
+};
+
+typedef struct PHashBLAKE3Task_ {
+	const puchar	*data;
+	psize		chunks;
+	puint64		counter;
+	puint32		cv[8];
+	PCountDownLatch	*latch;
+} PHashBLAKE3Task;
+
+static const puint32 pp_crypto_hash_blake3_iv[8] = {
+	0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A,
+	0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19
+};
+
+static const puchar pp_crypto_hash_blake3_schedule[7][16] = {
+	{  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 },
+	{  2,  6,  3, 10,  7,  0,  4, 13,  1, 11, 12,  5,  9, 14, 15,  8 },
+	{  3,  4, 10, 12, 13,  2,  7, 14,  6,  5,  9,  0, 11, 15,  8,  1 },
+	{ 10,  7, 12,  9, 14,  3, 13, 15,  4,  0, 11,  2,  5,  8,  1,  6 },
+	{ 12, 13,  9, 11, 15, 10, 14,  8,  7,  2,  5,  3,  0,  1,  6,  4 },
+	{  9, 14, 11,  5,  8, 12, 15,  1, 13,  3,  0, 10,  2,  6,  4,  7 },
+	{ 11, 15,  5,  0,  1,  9,  8,  6, 14, 10,  2, 12,  3,  4,  7, 13 }
+};
+
+static void pp_crypto_hash_blake3_load_block (const puchar *block, puint32 m[16]);
+static void pp_crypto_hash_blake3_compress (const puint32 cv[8], const puint32 m[16], puint64 counter,
+					    puint32 block_len, puint32 flags, puint32 out[16]);
+static void pp_crypto_hash_blake3_parent_cv (const puint32 left[8], const puint32 right[8], puint32 out[8]);
+static void pp_crypto_hash_blake3_chunk_cv (const puchar *chunk, puint64 counter, puint32 out[8]);
+#ifdef P_HASH_VEC
+static void pp_crypto_hash_blake3_chunks_x4 (const puchar *chunks, puint64 counter, puint32 out[][8]);
+#endif
+static void pp_crypto_hash_blake3_subtree_serial (const puchar *data, psize chunks, puint64 counter, puint32 out[8]);
+static void pp_crypto_hash_blake3_task (ppointer data);
+static void pp_crypto_hash_blake3_subtree (PHashBLAKE3 *ctx, const puchar *data, psize chunks, puint32 out[8]);
+static void pp_crypto_hash_blake3_add_cv (PHashBLAKE3 *ctx, puint32 cv[8], puint64 total);
+static void pp_crypto_hash_blake3_chunk_update (PHashBLAKE3 *ctx, const puchar *data, psize len);
+static void pp_crypto_hash_blake3_chunk_reset (PHashBLAKE3 *ctx);
+
+#define P_BLAKE3_ROTR(val, shift) (((val) >> (shift)) | ((val) << (32 - (shift))))
+
+#define P_BLAKE3_G(a, b, c, d, x, y)						\
+{										\
+	a = a + b + (x);							\
+	d = P_BLAKE3_ROTR (d ^ a, 16);						\
+	c = c + d;								\
+	b = P_BLAKE3_ROTR (b ^ c, 12);						\
+	a = a + b + (y);							\
+	d = P_BLAKE3_ROTR (d ^ a, 8);						\
+	c = c + d;								\
+	b = P_BLAKE3_ROTR (b ^ c, 7);						\
+}
+
+#ifdef P_HASH_VEC
+/* Right rotations by 16, 12, 8 and 7 bits */
+#  define P_BLAKE3_VEC_G(a, b, c, d, x, y)					\
+{										\
+	a = P_HASH_VEC_ADD (P_HASH_VEC_ADD (a, b), x);				\
+	d = P_HASH_VEC_ROTL (P_HASH_VEC_XOR (d, a), 16);			\
+	c = P_HASH_VEC_ADD (c, d);						\
+	b = P_HASH_VEC_ROTL (P_HASH_VEC_XOR (b, c), 20);			\
+	a = P_HASH_VEC_ADD (P_HASH_VEC_ADD (a, b), y);				\
+	d = P_HASH_VEC_ROTL (P_HASH_VEC_XOR (d, a), 24);			\
+	c = P_HASH_VEC_ADD (c, d);						\
+	b = P_HASH_VEC_ROTL (P_HASH_VEC_XOR (b, c), 25);			\
+}
+#endif
+
+static void
+pp_crypto_hash_blake3_load_block (const puchar	*block,
+				  puint32	m[16])
+{
+	puint i;
+
+	memcpy (m, block, P_BLAKE3_BLOCK_LEN);
+
+	for (i = 0; i < 16; ++i)
+		m[i] = PUINT32_FROM_LE (m[i]);
+}
+
+static void
+pp_crypto_hash_blake3_compress (const puint32	cv[8],
+				const puint32	m[16],
+				puint64		counter,
+				puint32		block_len,
+				puint32		flags,
+				puint32		out[16])
+{
+	const puchar	*s;
+	puint32		v[16];
+	puint		i;
+
+	for (i = 0; i < 8; ++i)
+		v[i] = cv[i];
+
+	for (i = 0; i < 4; ++i)
+		v[i + 8] = pp_crypto_hash_blake3_iv[i];
+
+	v[12] = (puint32) counter;
+	v[13] = (puint32) (counter >> 32);
+	v[14] = block_len;
+	v[15] = flags;
+
+	for (i = 0; i < 7; ++i) {
+		s = pp_crypto_hash_blake3_schedule[i];
+
+		P_BLAKE3_G (v[0], v[4], v[ 8], v[12], m[s[ 0]], m[s[ 1]]);
+		P_BLAKE3_G (v[1], v[5], v[ 9], v[13], m[s[ 2]], m[s[ 3]]);
+		P_BLAKE3_G (v[2], v[6], v[10], v[14], m[s[ 4]], m[s[ 5]]);
+		P_BLAKE3_G (v[3], v[7], v[11], v[15], m[s[ 6]], m[s[ 7]]);
+		P_BLAKE3_G (v[0], v[5], v[10], v[15], m[s[ 8]], m[s[ 9]]);
+		P_BLAKE3_G (v[1], v[6], v[11], v[12], m[s[10]], m[s[11]]);
+		P_BLAKE3_G (v[2], v[7], v[ 8], v[13], m[s[12]], m[s[13]]);
+		P_BLAKE3_G (v[3], v[4], v[ 9], v[14], m[s[14]], m[s[15]]);
+	}
+
+	for (i = 0; i < 8; ++i) {
+		out[i]     = v[i] ^ v[i + 8];
+		out[i + 8] = v[i + 8] ^ cv[i];
+	}
+}
+
+static void
+pp_crypto_hash_blake3_parent_cv (const puint32	left[8],
+				 const puint32	right[8],
+				 puint32	out[8])
+{
+	puint32	m[16];
+	puint32	res[16];
+
+	memcpy (m, left, 32);
+	memcpy (m + 8, right, 32);
+
+	pp_crypto_hash_blake3_compress (pp_crypto_hash_blake3_iv, m, 0, P_BLAKE3_BLOCK_LEN, P_BLAKE3_PARENT, res);
+
+	memcpy (out, res, 32);
+}
+
+static void
+pp_crypto_hash_blake3_chunk_cv (const puchar	*chunk,
+				puint64		counter,
+				puint32		out[8])
+{
+	puint32	m[16];
+	puint32	res[16];
+	puint32	flags;
+	puint	i;
+
+	memcpy (out, pp_crypto_hash_blake3_iv, 32);
+
+	for (i = 0; i < P_BLAKE3_CHUNK_BLOCKS; ++i) {
+		flags = 0;
+
+		if (i == 0)
+			flags |= P_BLAKE3_CHUNK_START;
+
+		if (i == P_BLAKE3_CHUNK_BLOCKS - 1)
+			flags |= P_BLAKE3_CHUNK_END;
+
+		pp_crypto_hash_blake3_load_block (chunk + i * P_BLAKE3_BLOCK_LEN, m);
+		pp_crypto_hash_blake3_compress (out, m, counter, P_BLAKE3_BLOCK_LEN, flags, res);
+
+		memcpy (out, res, 32);
+	}
+}
+
+#ifdef P_HASH_VEC
+/* Every lane hashes its own chunk of four consecutive ones */
+static void
+pp_crypto_hash_blake3_chunks_x4 (const puchar	*chunks,
+				 puint64	counter,
+				 puint32	out[][8])
+{
+	puint32		lane_words[P_HASH_VEC_LANES][16];
+	puint32		words[16][P_HASH_VEC_LANES];
+	puint32		state[8][P_HASH_VEC_LANES];
+	const puchar	*s;
+	PHashVec	h[8];
+	PHashVec	v[16];
+	PHashVec	m[16];
+	PHashVec	counter_low;
+	PHashVec	counter_high;
+	puint32		flags;
+	puint		block, lane, i;
+
+	for (i = 0; i < 8; ++i)
+		h[i] = P_HASH_VEC_SET1 (pp_crypto_hash_blake3_iv[i]);
+
+	for (lane = 0; lane < P_HASH_VEC_LANES; ++lane) {
+		state[0][lane] = (puint32) (counter + lane);
+		state[1][lane] = (puint32) ((counter + lane) >> 32);
+	}
+
+	counter_low  = P_HASH_VEC_LOAD (state[0]);
+	counter_high = P_HASH_VEC_LOAD (state[1]);
+
+	for (block = 0; block < P_BLAKE3_CHUNK_BLOCKS; ++block) {
+		for (lane = 0; lane < P_HASH_VEC_LANES; ++lane)
+			pp_crypto_hash_blake3_load_block (chunks + lane * P_BLAKE3_CHUNK_LEN + block * P_BLAKE3_BLOCK_LEN,
+							  lane_words[lane]);
+
+		for (i = 0; i < 16; ++i) {
+			for (lane = 0; lane < P_HASH_VEC_LANES; ++lane)
+				words[i][lane] = lane_words[lane][i];
+
+			m[i] = P_HASH_VEC_LOAD (words[i]);
+		}
+
+		flags = 0;
+
+		if (block == 0)
+			flags |= P_BLAKE3_CHUNK_START;
+
+		if (block == P_BLAKE3_CHUNK_BLOCKS - 1)
+			flags |= P_BLAKE3_CHUNK_END;
+
+		for (i = 0; i < 8; ++i)
+			v[i] = h[i];
+
+		for (i = 0; i < 4; ++i)
+			v[i + 8] = P_HASH_VEC_SET1 (pp_crypto_hash_blake3_iv[i]);
+
+		v[12] = counter_low;
+		v[13] = counter_high;
+		v[14] = P_HASH_VEC_SET1 (P_BLAKE3_BLOCK_LEN);
+		v[15] = P_HASH_VEC_SET1 (flags);
+
+		for (i = 0; i < 7; ++i) {
+			s = pp_crypto_hash_blake3_schedule[i];
+
+			P_BLAKE3_VEC_G (v[0], v[4], v[ 8], v[12], m[s[ 0]], m[s[ 1]]);
+			P_BLAKE3_VEC_G (v[1], v[5], v[ 9], v[13], m[s[ 2]], m[s[ 3]]);
+			P_BLAKE3_VEC_G (v[2], v[6], v[10], v[14], m[s[ 4]], m[s[ 5]]);
+			P_BLAKE3_VEC_G (v[3], v[7], v[11], v[15], m[s[ 6]], m[s[ 7]]);
+			P_BLAKE3_VEC_G (v[0], v[5], v[10], v[15], m[s[ 8]], m[s[ 9]]);
+			P_BLAKE3_VEC_G (v[1], v[6], v[11], v[12], m[s[10]], m[s[11]]);
+			P_BLAKE3_VEC_G (v[2], v[7], v[ 8], v[13], m[s[12]], m[s[13]]);
+			P_BLAKE3_VEC_G (v[3], v[4], v[ 9], v[14], m[s[14]], m[s[15]]);
+		}
+
+		for (i = 0; i < 8; ++i)
+			h[i] = P_HASH_VEC_XOR (v[i], v[i + 8]);
+	}
+
+	for (i = 0; i < 8; ++i) {
+		P_HASH_VEC_STORE (state[i], h[i]);
+
+		for (lane = 0; lane < P_HASH_VEC_LANES; ++lane)
+			out[lane][i] = state[i][lane];
+	}
+}
+#endif
+
+/* The subtree of a power of two chunks is never the root */
+static void
+pp_crypto_hash_blake3_subtree_serial (const puchar	*data,
+				      psize		chunks,
+				      puint64		counter,
+				      puint32		out[8])
+{
+	puint32	stack[P_BLAKE3_MAX_DEPTH][8];
+	puint32	cvs[P_HASH_VEC_LANES][8];
+	puint	stack_len;
+	puint	count, j;
+	psize	i, total;
+
+	stack_len = 0;
+
+	for (i = 0; i < chunks; i += count) {
+#ifdef P_HASH_VEC
+		if (chunks - i >= P_HASH_VEC_LANES) {
+			pp_crypto_hash_blake3_chunks_x4 (data + i * P_BLAKE3_CHUNK_LEN, counter + i, cvs);
+			count = P_HASH_VEC_LANES;
+		} else
+#endif
+		{
+			pp_crypto_hash_blake3_chunk_cv (data + i * P_BLAKE3_CHUNK_LEN, counter + i, cvs[0]);
+			count = 1;
+		}
+
+		for (j = 0; j < count; ++j) {
+			/* Merge the completed subtrees, one per trailing zero bit */
+			for (total = i + j + 1; (total & 1) == 0; total >>= 1)
+				pp_crypto_hash_blake3_parent_cv (stack[--stack_len], cvs[j], cvs[j]);
+
+			memcpy (stack[stack_len++], cvs[j], 32);
+		}
+	}
+
+	memcpy (out, stack[0], 32);
+}
+
+static void
+pp_crypto_hash_blake3_task (ppointer data)
+{
+	PHashBLAKE3Task *task = (PHashBLAKE3Task *) data;
+
+	pp_crypto_hash_blake3_subtree_serial (task->data, task->chunks, task->counter, task->cv);
+
+	p_count_down_latch_count_down (task->latch);
+}
+
+static void
+pp_crypto_hash_blake3_subtree (PHashBLAKE3	*ctx,
+			       const puchar	*data,
+			       psize		chunks,
+			       puint32		out[8])
+{
+	PHashBLAKE3Task	tasks[P_BLAKE3_MAX_TASKS];
+	PCountDownLatch	*latch;
+	psize		n_tasks;
+	psize		max_tasks;
+	psize		i;
+
+	max_tasks = 1;
+
+	if (ctx->pool != NULL) {
+		while (max_tasks < (psize) p_thread_pool_get_worker_count (ctx->pool) + 1 &&
+		       max_tasks < P_BLAKE3_MAX_TASKS)
+			max_tasks <<= 1;
+	}
+
+	/* Power of two parts, so every part is a subtree itself */
+	for (n_tasks = 1; n_tasks < max_tasks && chunks / (n_tasks << 1) >= P_BLAKE3_TASK_MIN_CHUNKS; n_tasks <<= 1)
+		;
+
+	if (n_tasks == 1 || (latch = p_count_down_latch_new ((pint) n_tasks - 1, 0)) == NULL) {
+		pp_crypto_hash_blake3_subtree_serial (data, chunks, ctx->chunk_counter, out);
+		return;
+	}
+
+	for (i = 0; i < n_tasks; ++i) {
+		tasks[i].chunks  = chunks / n_tasks;
+		tasks[i].data    = data + i * tasks[i].chunks * P_BLAKE3_CHUNK_LEN;
+		tasks[i].counter = ctx->chunk_counter + i * tasks[i].chunks;
+		tasks[i].latch   = latch;
+	}
+
+	for (i = 1; i < n_tasks; ++i) {
+		if (P_UNLIKELY (p_thread_pool_push (ctx->pool, pp_crypto_hash_blake3_task, &tasks[i]) == FALSE))
+			pp_crypto_hash_blake3_task (&tasks[i]);
+	}
+
+	/* The calling thread takes the first part */
+	pp_crypto_hash_blake3_subtree_serial (tasks[0].data, tasks[0].chunks, tasks[0].counter, tasks[0].cv);
+
+	/* The wait returns only after the last task has left the latch, and the
+	 * tasks don't touch it or their descriptors after counting down */
+	p_count_down_latch_wait (latch);
+	p_count_down_latch_free (latch);
+
+	for (; n_tasks > 1; n_tasks >>= 1) {
+		for (i = 0; i < n_tasks / 2; ++i)
+			pp_crypto_hash_blake3_parent_cv (tasks[2 * i].cv, tasks[2 * i + 1].cv, tasks[i].cv);
+	}
+
+	memcpy (out, tasks[0].cv, 32);
+}
+
+/* total is the number of subtrees of the same size as the new one hashed so
+ * far, including it */
+static void
+pp_crypto_hash_blake3_add_cv (PHashBLAKE3	*ctx,
+			      puint32		cv[8],
+			      puint64		total)
+{
+	for (; (total & 1) == 0; total >>= 1)
+		pp_crypto_hash_blake3_parent_cv (ctx->cv_stack[--ctx->cv_stack_len], cv, cv);
+
+	memcpy (ctx->cv_stack[ctx->cv_stack_len++], cv, 32);
+}
+
+/* The last block of a chunk can be the root, so it stays in the buffer */
+static void
+pp_crypto_hash_blake3_chunk_update (PHashBLAKE3		*ctx,
+				    const puchar	*data,
+				    psize		len)
+{
+	puint32	m[16];
+	puint32	res[16];
+	psize	to_fill;
+
+	while (len > 0) {
+		if (ctx->buf_len == P_BLAKE3_BLOCK_LEN) {
+			pp_crypto_hash_blake3_load_block (ctx->buf, m);
+			pp_crypto_hash_blake3_compress (ctx->cv,
+							m,
+							ctx->chunk_counter,
+							P_BLAKE3_BLOCK_LEN,
+							ctx->blocks_compressed == 0 ? P_BLAKE3_CHUNK_START : 0,
+							res);
+			memcpy (ctx->cv, res, 32);
+
+			++ctx->blocks_compressed;
+			ctx->buf_len = 0;
+		}
+
+		if (ctx->buf_len == 0) {
+			while (len > P_BLAKE3_BLOCK_LEN) {
+				pp_crypto_hash_blake3_load_block (data, m);
+				pp_crypto_hash_blake3_compress (ctx->cv,
+								m,
+								ctx->chunk_counter,
+								P_BLAKE3_BLOCK_LEN,
+								ctx->blocks_compressed == 0 ? P_BLAKE3_CHUNK_START : 0,
+								res);
+				memcpy (ctx->cv, res, 32);
+
+				++ctx->blocks_compressed;
+				data += P_BLAKE3_BLOCK_LEN;
+				len -= P_BLAKE3_BLOCK_LEN;
+			}
+		}
+
+		to_fill = P_BLAKE3_BLOCK_LEN - ctx->buf_len;
+
+		if (to_fill > len)
+			to_fill = len;
+
+		memcpy (ctx->buf + ctx->buf_len, data, to_fill);
+
+		ctx->buf_len += (puint) to_fill;
+		data += to_fill;
+		len -= to_fill;
+	}
+}
+
+static void
+pp_crypto_hash_blake3_chunk_reset (PHashBLAKE3 *ctx)
+{
+	memcpy (ctx->cv, pp_crypto_hash_blake3_iv, 32);
+
+	ctx->buf_len           = 0;
+	ctx->blocks_compressed = 0;
+}
+
+PHashBLAKE3 *
+p_crypto_hash_blake3_init (ppointer	mem,
+			   psize	size)
+{
+	PHashBLAKE3 *ret;
+
+	if (P_UNLIKELY (mem == NULL || size < sizeof (PHashBLAKE3)))
+		return NULL;
+
+	ret = (PHashBLAKE3 *) mem;
+	memset (ret, 0, sizeof (PHashBLAKE3));
+
+	p_crypto_hash_blake3_reset (ret);
+
+	return ret;
+}
+
+PHashBLAKE3 *
+p_crypto_hash_blake3_new (void)
+{
+	PHashBLAKE3 *ret;
+
+	if (P_UNLIKELY ((ret = p_malloc (sizeof (PHashBLAKE3))) == NULL))
+		return NULL;
+
+	return p_crypto_hash_blake3_init (ret, sizeof (PHashBLAKE3));
+}
+
+void
+p_crypto_hash_blake3_reset (PHashBLAKE3 *ctx)
+{
+	pp_crypto_hash_blake3_chunk_reset (ctx);
+
+	ctx->chunk_counter = 0;
+	ctx->cv_stack_len  = 0;
+}
+
+void
+p_crypto_hash_blake3_update (PHashBLAKE3	*ctx,
+			     const puchar	*data,
+			     psize		len)
+{
+	puint32	m[16];
+	puint32	res[16];
+	psize	chunk_len;
+	psize	subtree_chunks;
+
+	while (len > 0) {
+		chunk_len = ctx->blocks_compressed * P_BLAKE3_BLOCK_LEN + ctx->buf_len;
+
+		/* More data follows, so the full chunk is not the root */
+		if (chunk_len == P_BLAKE3_CHUNK_LEN) {
+			pp_crypto_hash_blake3_load_block (ctx->buf, m);
+			pp_crypto_hash_blake3_compress (ctx->cv,
+							m,
+							ctx->chunk_counter,
+							P_BLAKE3_BLOCK_LEN,
+							P_BLAKE3_CHUNK_END,
+							res);
+
+			pp_crypto_hash_blake3_add_cv (ctx, res, ++ctx->chunk_counter);
+			pp_crypto_hash_blake3_chunk_reset (ctx);
+
+			chunk_len = 0;
+		}
+
+		/* Take the biggest aligned subtree leaving at least one byte
+		 * for the following chunk */
+		if (chunk_len == 0 && len > P_BLAKE3_CHUNK_LEN) {
+			for (subtree_chunks = 1;
+			     (subtree_chunks << 1) <= (len - 1) / P_BLAKE3_CHUNK_LEN;
+			     subtree_chunks <<= 1)
+				;
+
+			while ((ctx->chunk_counter & (subtree_chunks - 1)) != 0)
+				subtree_chunks >>= 1;
+
+			pp_crypto_hash_blake3_subtree (ctx, data, subtree_chunks, res);
+
+			ctx->chunk_counter += subtree_chunks;
+			pp_crypto_hash_blake3_add_cv (ctx, res, ctx->chunk_counter / subtree_chunks);
+
+			data += subtree_chunks * P_BLAKE3_CHUNK_LEN;
+			len -= subtree_chunks * P_BLAKE3_CHUNK_LEN;
+
+			continue;
+		}
+
+		if (chunk_len + len > P_BLAKE3_CHUNK_LEN)
+			chunk_len = P_BLAKE3_CHUNK_LEN - chunk_len;
+		else
+			chunk_len = len;
+
+		pp_crypto_hash_blake3_chunk_update (ctx, data, chunk_len);
+
+		data += chunk_len;
+		len -= chunk_len;
+	}
+}
+
+void
+p_crypto_hash_blake3_finish (PHashBLAKE3 *ctx)
+{
+	puint32	cv[8];
+	puint32	m[16];
+	puint32	res[16];
+	puint64	counter;
+	puint32	block_len;
+	puint32	flags;
+	puint	i;
+
+	memset (ctx->buf + ctx->buf_len, 0, P_BLAKE3_BLOCK_LEN - ctx->buf_len);
+
+	memcpy (cv, ctx->cv, 32);
+	pp_crypto_hash_blake3_load_block (ctx->buf, m);
+
+	counter   = ctx->chunk_counter;
+	block_len = ctx->buf_len;
+	flags     = P_BLAKE3_CHUNK_END;
+
+	if (ctx->blocks_compressed == 0)
+		flags |= P_BLAKE3_CHUNK_START;
+
+	/* Walk up the right edge of the tree */
+	for (i = ctx->cv_stack_len; i > 0; --i) {
+		pp_crypto_hash_blake3_compress (cv, m, counter, block_len, flags, res);
+
+		memcpy (m, ctx->cv_stack[i - 1], 32);
+		memcpy (m + 8, res, 32);
+		memcpy (cv, pp_crypto_hash_blake3_iv, 32);
+
+		counter   = 0;
+		block_len = P_BLAKE3_BLOCK_LEN;
+		flags     = P_BLAKE3_PARENT;
+	}
+
+	pp_crypto_hash_blake3_compress (cv, m, counter, block_len, flags | P_BLAKE3_ROOT, res);
+
+	for (i = 0; i < 8; ++i)
+		ctx->hash[i] = PUINT32_TO_LE (res[i]);
+}
+
+const puchar *
+p_crypto_hash_blake3_digest (PHashBLAKE3 *ctx)
+{
+	return (const puchar *) ctx->hash;
+}
+
+void
+p_crypto_hash_blake3_copy (PHashBLAKE3		*dst,
+			   const PHashBLAKE3	*src)
+{
+	memcpy (dst, src, sizeof (PHashBLAKE3));
+}
+
+void
+p_crypto_hash_blake3_set_thread_pool (PHashBLAKE3	*ctx,
+				      PThreadPool	*pool)
+{
+	ctx->pool = pool;
+}
+
+void
+p_crypto_hash_blake3_free (PHashBLAKE3 *ctx)
+{
+	p_free (ctx);
+}
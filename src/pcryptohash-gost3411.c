@@ -388,18 +388,33 @@ static void pp_crypto_hash_gost3411_process (PHashGOST3411	*ctx,
 }
 
 PHashGOST3411 *
-p_crypto_hash_gost3411_new (void)
+p_crypto_hash_gost3411_init (ppointer	mem,
+			     psize	size)
 {
 	PHashGOST3411 *ret;
 
-	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PHashGOST3411))) == NULL))
+	if (P_UNLIKELY (mem == NULL || size < sizeof (PHashGOST3411)))
 		return NULL;
 
+	ret = (PHashGOST3411 *) mem;
+	memset (ret, 0, sizeof (PHashGOST3411));
+
 	p_crypto_hash_gost3411_reset (ret);
 
 	return ret;
 }
 
+PHashGOST3411 *
+p_crypto_hash_gost3411_new (void)
+{
+	PHashGOST3411 *ret;
+
+	if (P_UNLIKELY ((ret = p_malloc (sizeof (PHashGOST3411))) == NULL))
+		return NULL;
+
+	return p_crypto_hash_gost3411_init (ret, sizeof (PHashGOST3411));
+}
+
 void
 p_crypto_hash_gost3411_update (PHashGOST3411	*ctx,
 			       const puchar	*data,
@@ -477,6 +492,13 @@ p_crypto_hash_gost3411_reset (PHashGOST3411 *ctx)
 	memset (ctx->sum, 0, 32);
 }
 
+void
+p_crypto_hash_gost3411_copy (PHashGOST3411		*dst,
+			     const PHashGOST3411	*src)
+{
+	memcpy (dst, src, sizeof (PHashGOST3411));
+}
+
 void
 p_crypto_hash_gost3411_free (PHashGOST3411 *ctx)
 {
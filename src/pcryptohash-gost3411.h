@@ -40,6 +40,8 @@ P_BEGIN_DECLS
 typedef struct PHashGOST3411_ PHashGOST3411;
 
 PHashGOST3411 *	p_crypto_hash_gost3411_new	(void);
+PHashGOST3411 *	p_crypto_hash_gost3411_init	(ppointer		mem,
+						 psize			size);
 void		p_crypto_hash_gost3411_update	(PHashGOST3411		*ctx,
 						 const puchar		*data,
 						 psize			len);
@@ -47,6 +49,8 @@ void		p_crypto_hash_gost3411_finish	(PHashGOST3411		*ctx);
 const puchar *	p_crypto_hash_gost3411_digest	(PHashGOST3411		*ctx);
 void		p_crypto_hash_gost3411_reset	(PHashGOST3411		*ctx);
 void		p_crypto_hash_gost3411_free	(PHashGOST3411		*ctx);
+void		p_crypto_hash_gost3411_copy	(PHashGOST3411		*dst,
+						 const PHashGOST3411	*src);
 
 P_END_DECLS
 
@@ -25,6 +25,7 @@
 
 #include "pmem.h"
 #include "pcryptohash-md5.h"
+#include "pcryptohash-multi.h"
 
 #include <string.h>
 #include <stdlib.h>
@@ -70,6 +71,23 @@ static void pp_crypto_hash_md5_process (PHashMD5 *ctx, const puint32 data[16]);
 #define P_MD5_ROUND_3(a, b, c, d, k, i, s)				\
 	a += P_MD5_I (b, c, d) + data[k] + i, a = P_MD5_ROTL (a, s) + b
 
+#ifdef P_HASH_VEC
+#  define P_MD5_VEC_F(x, y, z) P_HASH_VEC_XOR (z, P_HASH_VEC_AND (x, P_HASH_VEC_XOR (y, z)))
+#  define P_MD5_VEC_G(x, y, z) P_MD5_VEC_F (z, x, y)
+#  define P_MD5_VEC_H(x, y, z) P_HASH_VEC_XOR (P_HASH_VEC_XOR (x, y), z)
+#  define P_MD5_VEC_I(x, y, z) P_HASH_VEC_XOR (y, P_HASH_VEC_OR (x, P_HASH_VEC_NOT (z)))
+
+#  define P_MD5_VEC_ROUND(f, a, b, c, d, k, i, s)					\
+	a = P_HASH_VEC_ADD (a, P_HASH_VEC_ADD (f (b, c, d),				\
+		P_HASH_VEC_ADD (P_HASH_VEC_LOAD (data[k]), P_HASH_VEC_SET1 (i)))),	\
+	a = P_HASH_VEC_ADD (P_HASH_VEC_ROTL (a, s), b)
+
+#  define P_MD5_VEC_ROUND_0(a, b, c, d, k, i, s) P_MD5_VEC_ROUND (P_MD5_VEC_F, a, b, c, d, k, i, s)
+#  define P_MD5_VEC_ROUND_1(a, b, c, d, k, i, s) P_MD5_VEC_ROUND (P_MD5_VEC_G, a, b, c, d, k, i, s)
+#  define P_MD5_VEC_ROUND_2(a, b, c, d, k, i, s) P_MD5_VEC_ROUND (P_MD5_VEC_H, a, b, c, d, k, i, s)
+#  define P_MD5_VEC_ROUND_3(a, b, c, d, k, i, s) P_MD5_VEC_ROUND (P_MD5_VEC_I, a, b, c, d, k, i, s)
+#endif
+
 static void
 pp_crypto_hash_md5_swap_bytes (puint32	*data,
 			       puint	words)
@@ -170,6 +188,93 @@ pp_crypto_hash_md5_process (PHashMD5		*ctx,
 	ctx->hash[3] += D;
 }
 
+#ifdef P_HASH_VEC
+void
+p_crypto_hash_md5_process_x4 (puint32		state[][P_HASH_VEC_LANES],
+			      const puint32	data[16][P_HASH_VEC_LANES])
+{
+	PHashVec A, B, C, D;
+
+	A = P_HASH_VEC_LOAD (state[0]);
+	B = P_HASH_VEC_LOAD (state[1]);
+	C = P_HASH_VEC_LOAD (state[2]);
+	D = P_HASH_VEC_LOAD (state[3]);
+
+	P_MD5_VEC_ROUND_0 (A, B, C, D, 0,  0xD76AA478,  7);
+	P_MD5_VEC_ROUND_0 (D, A, B, C, 1,  0xE8C7B756, 12);
+	P_MD5_VEC_ROUND_0 (C, D, A, B, 2,  0x242070DB, 17);
+	P_MD5_VEC_ROUND_0 (B, C, D, A, 3,  0xC1BDCEEE, 22);
+	P_MD5_VEC_ROUND_0 (A, B, C, D, 4,  0xF57C0FAF,  7);
+	P_MD5_VEC_ROUND_0 (D, A, B, C, 5,  0x4787C62A, 12);
+	P_MD5_VEC_ROUND_0 (C, D, A, B, 6,  0xA8304613, 17);
+	P_MD5_VEC_ROUND_0 (B, C, D, A, 7,  0xFD469501, 22);
+	P_MD5_VEC_ROUND_0 (A, B, C, D, 8,  0x698098D8,  7);
+	P_MD5_VEC_ROUND_0 (D, A, B, C, 9,  0x8B44F7AF, 12);
+	P_MD5_VEC_ROUND_0 (C, D, A, B, 10, 0xFFFF5BB1, 17);
+	P_MD5_VEC_ROUND_0 (B, C, D, A, 11, 0x895CD7BE, 22);
+	P_MD5_VEC_ROUND_0 (A, B, C, D, 12, 0x6B901122,  7);
+	P_MD5_VEC_ROUND_0 (D, A, B, C, 13, 0xFD987193, 12);
+	P_MD5_VEC_ROUND_0 (C, D, A, B, 14, 0xA679438E, 17);
+	P_MD5_VEC_ROUND_0 (B, C, D, A, 15, 0x49B40821, 22);
+
+	P_MD5_VEC_ROUND_1 (A, B, C, D, 1,  0xF61E2562,  5);
+	P_MD5_VEC_ROUND_1 (D, A, B, C, 6,  0xC040B340,  9);
+	P_MD5_VEC_ROUND_1 (C, D, A, B, 11, 0x265E5A51, 14);
+	P_MD5_VEC_ROUND_1 (B, C, D, A, 0,  0xE9B6C7AA, 20);
+	P_MD5_VEC_ROUND_1 (A, B, C, D, 5,  0xD62F105D,  5);
+	P_MD5_VEC_ROUND_1 (D, A, B, C, 10, 0x02441453,  9);
+	P_MD5_VEC_ROUND_1 (C, D, A, B, 15, 0xD8A1E681, 14);
+	P_MD5_VEC_ROUND_1 (B, C, D, A, 4,  0xE7D3FBC8, 20);
+	P_MD5_VEC_ROUND_1 (A, B, C, D, 9,  0x21E1CDE6,  5);
+	P_MD5_VEC_ROUND_1 (D, A, B, C, 14, 0xC33707D6,  9);
+	P_MD5_VEC_ROUND_1 (C, D, A, B, 3,  0xF4D50D87, 14);
+	P_MD5_VEC_ROUND_1 (B, C, D, A, 8,  0x455A14ED, 20);
+	P_MD5_VEC_ROUND_1 (A, B, C, D, 13, 0xA9E3E905,  5);
+	P_MD5_VEC_ROUND_1 (D, A, B, C, 2,  0xFCEFA3F8,  9);
+	P_MD5_VEC_ROUND_1 (C, D, A, B, 7,  0x676F02D9, 14);
+	P_MD5_VEC_ROUND_1 (B, C, D, A, 12, 0x8D2A4C8A, 20);
+
+	P_MD5_VEC_ROUND_2 (A, B, C, D, 5,  0xFFFA3942,  4);
+	P_MD5_VEC_ROUND_2 (D, A, B, C, 8,  0x8771F681, 11);
+	P_MD5_VEC_ROUND_2 (C, D, A, B, 11, 0x6D9D6122, 16);
+	P_MD5_VEC_ROUND_2 (B, C, D, A, 14, 0xFDE5380C, 23);
+	P_MD5_VEC_ROUND_2 (A, B, C, D, 1,  0xA4BEEA44,  4);
+	P_MD5_VEC_ROUND_2 (D, A, B, C, 4,  0x4BDECFA9, 11);
+	P_MD5_VEC_ROUND_2 (C, D, A, B, 7,  0xF6BB4B60, 16);
+	P_MD5_VEC_ROUND_2 (B, C, D, A, 10, 0xBEBFBC70, 23);
+	P_MD5_VEC_ROUND_2 (A, B, C, D, 13, 0x289B7EC6,  4);
+	P_MD5_VEC_ROUND_2 (D, A, B, C, 0,  0xEAA127FA, 11);
+	P_MD5_VEC_ROUND_2 (C, D, A, B, 3,  0xD4EF3085, 16);
+	P_MD5_VEC_ROUND_2 (B, C, D, A, 6,  0x04881D05, 23);
+	P_MD5_VEC_ROUND_2 (A, B, C, D, 9,  0xD9D4D039,  4);
+	P_MD5_VEC_ROUND_2 (D, A, B, C, 12, 0xE6DB99E5, 11);
+	P_MD5_VEC_ROUND_2 (C, D, A, B, 15, 0x1FA27CF8, 16);
+	P_MD5_VEC_ROUND_2 (B, C, D, A, 2,  0xC4AC5665, 23);
+
+	P_MD5_VEC_ROUND_3 (A, B, C, D, 0,  0xF4292244,  6);
+	P_MD5_VEC_ROUND_3 (D, A, B, C, 7,  0x432AFF97, 10);
+	P_MD5_VEC_ROUND_3 (C, D, A, B, 14, 0xAB9423A7, 15);
+	P_MD5_VEC_ROUND_3 (B, C, D, A, 5,  0xFC93A039, 21);
+	P_MD5_VEC_ROUND_3 (A, B, C, D, 12, 0x655B59C3,  6);
+	P_MD5_VEC_ROUND_3 (D, A, B, C, 3,  0x8F0CCC92, 10);
+	P_MD5_VEC_ROUND_3 (C, D, A, B, 10, 0xFFEFF47D, 15);
+	P_MD5_VEC_ROUND_3 (B, C, D, A, 1,  0x85845DD1, 21);
+	P_MD5_VEC_ROUND_3 (A, B, C, D, 8,  0x6FA87E4F,  6);
+	P_MD5_VEC_ROUND_3 (D, A, B, C, 15, 0xFE2CE6E0, 10);
+	P_MD5_VEC_ROUND_3 (C, D, A, B, 6,  0xA3014314, 15);
+	P_MD5_VEC_ROUND_3 (B, C, D, A, 13, 0x4E0811A1, 21);
+	P_MD5_VEC_ROUND_3 (A, B, C, D, 4,  0xF7537E82,  6);
+	P_MD5_VEC_ROUND_3 (D, A, B, C, 11, 0xBD3AF235, 10);
+	P_MD5_VEC_ROUND_3 (C, D, A, B, 2,  0x2AD7D2BB, 15);
+	P_MD5_VEC_ROUND_3 (B, C, D, A, 9,  0xEB86D391, 21);
+
+	P_HASH_VEC_STORE (state[0], P_HASH_VEC_ADD (A, P_HASH_VEC_LOAD (state[0])));
+	P_HASH_VEC_STORE (state[1], P_HASH_VEC_ADD (B, P_HASH_VEC_LOAD (state[1])));
+	P_HASH_VEC_STORE (state[2], P_HASH_VEC_ADD (C, P_HASH_VEC_LOAD (state[2])));
+	P_HASH_VEC_STORE (state[3], P_HASH_VEC_ADD (D, P_HASH_VEC_LOAD (state[3])));
+}
+#endif
+
 void
 p_crypto_hash_md5_reset (PHashMD5 *ctx)
 {
@@ -185,18 +290,33 @@ p_crypto_hash_md5_reset (PHashMD5 *ctx)
 }
 
 PHashMD5 *
-p_crypto_hash_md5_new (void)
+p_crypto_hash_md5_init (ppointer	mem,
+			psize		size)
 {
 	PHashMD5 *ret;
 
-	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PHashMD5))) == NULL))
+	if (P_UNLIKELY (mem == NULL || size < sizeof (PHashMD5)))
 		return NULL;
 
+	ret = (PHashMD5 *) mem;
+	memset (ret, 0, sizeof (PHashMD5));
+
 	p_crypto_hash_md5_reset (ret);
 
 	return ret;
 }
 
+PHashMD5 *
+p_crypto_hash_md5_new (void)
+{
+	PHashMD5 *ret;
+
+	if (P_UNLIKELY ((ret = p_malloc (sizeof (PHashMD5))) == NULL))
+		return NULL;
+
+	return p_crypto_hash_md5_init (ret, sizeof (PHashMD5));
+}
+
 void
 p_crypto_hash_md5_update (PHashMD5	*ctx,
 			  const puchar	*data,
@@ -266,6 +386,13 @@ p_crypto_hash_md5_digest (PHashMD5 *ctx)
 	return (const puchar *) ctx->hash;
 }
 
+void
+p_crypto_hash_md5_copy (PHashMD5	*dst,
+			const PHashMD5	*src)
+{
+	memcpy (dst, src, sizeof (PHashMD5));
+}
+
 void
 p_crypto_hash_md5_free (PHashMD5 *ctx)
 {
@@ -40,11 +40,13 @@ P_BEGIN_DECLS
 typedef struct PHashMD5_ PHashMD5;
 
 PHashMD5 *	p_crypto_hash_md5_new		(void);
+PHashMD5 *	p_crypto_hash_md5_init		(ppointer mem, psize size);
 void		p_crypto_hash_md5_update	(PHashMD5 *ctx, const puchar *data, psize len);
 void		p_crypto_hash_md5_finish	(PHashMD5 *ctx);
 const puchar *	p_crypto_hash_md5_digest	(PHashMD5 *ctx);
 void		p_crypto_hash_md5_reset		(PHashMD5 *ctx);
 void		p_crypto_hash_md5_free		(PHashMD5 *ctx);
+void		p_crypto_hash_md5_copy		(PHashMD5 *dst, const PHashMD5 *src);
 
 P_END_DECLS
 
@@ -0,0 +1,251 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Short independent messages spend most of their time in the per-message
+ * setup and in the dependency chain of a single compression, so several
+ * messages are hashed at once, one per SIMD lane. A lane picks up the next
+ * message as soon as its current one is finished, thus messages of different
+ * lengths don't stall each other for longer than one block. The padding is
+ * built on the fly from the caller's buffers without copying the whole
+ * message. */
+
+#include "pcpufeatures-private.h"
+#include "pcryptohash-multi.h"
+
+#include <string.h>
+
+#ifdef P_HASH_VEC
+typedef struct PHashMultiAlgo_ {
+	puint		state_words;
+	puint		digest_words;
+	pboolean	big_endian;
+	const puint32	*iv;
+	void		(*process) (puint32 state[][P_HASH_VEC_LANES],
+				    const puint32 data[16][P_HASH_VEC_LANES]);
+} PHashMultiAlgo;
+
+typedef struct PHashMultiLane_ {
+	const puchar	*data;
+	psize		len;
+	psize		block;
+	psize		blocks;
+	puchar		*digest;
+} PHashMultiLane;
+
+static const puint32 pp_crypto_hash_multi_md5_iv[] = {
+	0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476
+};
+
+static const puint32 pp_crypto_hash_multi_sha1_iv[] = {
+	0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0
+};
+
+static const puint32 pp_crypto_hash_multi_sha2_224_iv[] = {
+	0xC1059ED8, 0x367CD507, 0x3070DD17, 0xF70E5939,
+	0xFFC00B31, 0x68581511, 0x64F98FA7, 0xBEFA4FA4
+};
+
+static const puint32 pp_crypto_hash_multi_sha2_256_iv[] = {
+	0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A,
+	0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19
+};
+
+static void pp_crypto_hash_multi_load_block (const PHashMultiAlgo *algo,
+					     const PHashMultiLane *lane,
+					     puint32 data[16][P_HASH_VEC_LANES],
+					     puint index);
+static void pp_crypto_hash_multi_store_digest (const PHashMultiAlgo *algo,
+					       const PHashMultiLane *lane,
+					       puint32 state[][P_HASH_VEC_LANES],
+					       puint index);
+
+static void
+pp_crypto_hash_multi_load_block (const PHashMultiAlgo	*algo,
+				 const PHashMultiLane	*lane,
+				 puint32		data[16][P_HASH_VEC_LANES],
+				 puint			index)
+{
+	puchar		tail[64];
+	const puchar	*block;
+	psize		offset;
+	puint64		bits;
+	puint32		word;
+	puint		i;
+
+	offset = lane->block * 64;
+
+	if (offset + 64 <= lane->len)
+		block = lane->data + offset;
+	else {
+		memset (tail, 0, 64);
+
+		if (offset < lane->len)
+			memcpy (tail, lane->data + offset, lane->len - offset);
+
+		if (offset <= lane->len)
+			tail[lane->len - offset] = 0x80;
+
+		if (lane->block + 1 == lane->blocks) {
+			bits = ((puint64) lane->len) << 3;
+
+			for (i = 0; i < 8; ++i)
+				tail[algo->big_endian ? 63 - i : 56 + i] = (puchar) (bits >> (i * 8));
+		}
+
+		block = tail;
+	}
+
+	for (i = 0; i < 16; ++i) {
+		memcpy (&word, block + i * 4, 4);
+		data[i][index] = algo->big_endian ? PUINT32_FROM_BE (word) : PUINT32_FROM_LE (word);
+	}
+}
+
+static void
+pp_crypto_hash_multi_store_digest (const PHashMultiAlgo	*algo,
+				   const PHashMultiLane	*lane,
+				   puint32		state[][P_HASH_VEC_LANES],
+				   puint		index)
+{
+	puint32	word;
+	puint	i;
+
+	for (i = 0; i < algo->digest_words; ++i) {
+		word = algo->big_endian ? PUINT32_TO_BE (state[i][index]) : PUINT32_TO_LE (state[i][index]);
+		memcpy (lane->digest + i * 4, &word, 4);
+	}
+}
+#endif
+
+pboolean
+p_crypto_hash_multi_compute (PCryptoHashType		type,
+			     const puchar * const	*inputs,
+			     const psize		*lens,
+			     psize			n,
+			     puchar			*digests)
+{
+#ifdef P_HASH_VEC
+	PHashMultiAlgo	algo;
+	PHashMultiLane	lanes[P_HASH_VEC_LANES];
+	puint32		state[8][P_HASH_VEC_LANES];
+	puint32		data[16][P_HASH_VEC_LANES];
+	psize		next;
+	puint		active;
+	puint		i, w;
+
+	switch (type) {
+	case P_CRYPTO_HASH_TYPE_MD5:
+		algo.state_words  = 4;
+		algo.digest_words = 4;
+		algo.big_endian   = FALSE;
+		algo.iv           = pp_crypto_hash_multi_md5_iv;
+		algo.process      = p_crypto_hash_md5_process_x4;
+		break;
+	case P_CRYPTO_HASH_TYPE_SHA1:
+		algo.state_words  = 5;
+		algo.digest_words = 5;
+		algo.big_endian   = TRUE;
+		algo.iv           = pp_crypto_hash_multi_sha1_iv;
+		algo.process      = p_crypto_hash_sha1_process_x4;
+		break;
+	case P_CRYPTO_HASH_TYPE_SHA2_224:
+	case P_CRYPTO_HASH_TYPE_SHA2_256:
+		/* A single stream with the SHA instructions is faster, while for
+		 * SHA-1 the lanes still win as its rounds are cheap */
+		if (p_cpu_has_feature_internal (P_CPU_FEATURE_SHA2_256))
+			return FALSE;
+
+		algo.state_words  = 8;
+		algo.digest_words = type == P_CRYPTO_HASH_TYPE_SHA2_224 ? 7 : 8;
+		algo.big_endian   = TRUE;
+		algo.iv           = type == P_CRYPTO_HASH_TYPE_SHA2_224 ? pp_crypto_hash_multi_sha2_224_iv
+									: pp_crypto_hash_multi_sha2_256_iv;
+		algo.process      = p_crypto_hash_sha2_256_process_x4;
+		break;
+	default:
+		return FALSE;
+	}
+
+	memset (state, 0, sizeof (state));
+	memset (data, 0, sizeof (data));
+
+	next   = 0;
+	active = 0;
+
+	for (i = 0; i < P_HASH_VEC_LANES; ++i)
+		lanes[i].data = NULL;
+
+	for (;;) {
+		/* Feed the idle lanes with the next messages */
+		for (i = 0; i < P_HASH_VEC_LANES && next < n; ++i) {
+			if (lanes[i].data != NULL)
+				continue;
+
+			lanes[i].data   = inputs[next] != NULL ? inputs[next] : (const puchar *) "";
+			lanes[i].len    = lens[next];
+			lanes[i].block  = 0;
+			lanes[i].blocks = (lens[next] + 8) / 64 + 1;
+			lanes[i].digest = digests + next * algo.digest_words * 4;
+
+			for (w = 0; w < algo.state_words; ++w)
+				state[w][i] = algo.iv[w];
+
+			++active;
+			++next;
+		}
+
+		if (active == 0)
+			break;
+
+		/* Idle lanes hash whatever was left in their slots */
+		for (i = 0; i < P_HASH_VEC_LANES; ++i) {
+			if (lanes[i].data != NULL)
+				pp_crypto_hash_multi_load_block (&algo, &lanes[i], data, i);
+		}
+
+		algo.process (state, (const puint32 (*)[P_HASH_VEC_LANES]) data);
+
+		for (i = 0; i < P_HASH_VEC_LANES; ++i) {
+			if (lanes[i].data == NULL || ++lanes[i].block < lanes[i].blocks)
+				continue;
+
+			pp_crypto_hash_multi_store_digest (&algo, &lanes[i], state, i);
+
+			lanes[i].data = NULL;
+			--active;
+		}
+	}
+
+	return TRUE;
+#else
+	P_UNUSED (type);
+	P_UNUSED (inputs);
+	P_UNUSED (lens);
+	P_UNUSED (n);
+	P_UNUSED (digests);
+
+	return FALSE;
+#endif
+}
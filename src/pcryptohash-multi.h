@@ -0,0 +1,97 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Multi-buffer (several messages per SIMD register) hashing for #PCryptoHash */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PCRYPTOHASHMULTI_H
+#define PLIBSYS_HEADER_PCRYPTOHASHMULTI_H
+
+#include "ptypes.h"
+#include "pmacros.h"
+#include "pcryptohash.h"
+
+/* Every lane holds the same word of a different message, the state and
+ * the message block are stored as [word][lane] arrays */
+#define P_HASH_VEC_LANES	4
+
+#if defined (P_CPU_X86_64) || defined (__SSE2__) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define P_HASH_VEC
+typedef __m128i PHashVec;
+#  define P_HASH_VEC_LOAD(p)		_mm_loadu_si128 ((const __m128i *) (p))
+#  define P_HASH_VEC_STORE(p, v)	_mm_storeu_si128 ((__m128i *) (p), v)
+#  define P_HASH_VEC_SET1(x)		_mm_set1_epi32 ((pint) (x))
+#  define P_HASH_VEC_ADD(a, b)		_mm_add_epi32 (a, b)
+#  define P_HASH_VEC_XOR(a, b)		_mm_xor_si128 (a, b)
+#  define P_HASH_VEC_AND(a, b)		_mm_and_si128 (a, b)
+#  define P_HASH_VEC_OR(a, b)		_mm_or_si128 (a, b)
+#  define P_HASH_VEC_SHL(a, s)		_mm_slli_epi32 (a, s)
+#  define P_HASH_VEC_SHR(a, s)		_mm_srli_epi32 (a, s)
+#elif defined (P_CPU_ARM_64) || defined (__ARM_NEON)
+#  include <arm_neon.h>
+#  define P_HASH_VEC
+typedef uint32x4_t PHashVec;
+#  define P_HASH_VEC_LOAD(p)		vld1q_u32 (p)
+#  define P_HASH_VEC_STORE(p, v)	vst1q_u32 (p, v)
+#  define P_HASH_VEC_SET1(x)		vdupq_n_u32 ((puint32) (x))
+#  define P_HASH_VEC_ADD(a, b)		vaddq_u32 (a, b)
+#  define P_HASH_VEC_XOR(a, b)		veorq_u32 (a, b)
+#  define P_HASH_VEC_AND(a, b)		vandq_u32 (a, b)
+#  define P_HASH_VEC_OR(a, b)		vorrq_u32 (a, b)
+#  define P_HASH_VEC_SHL(a, s)		vshlq_u32 (a, vdupq_n_s32 ((pint) (s)))
+#  define P_HASH_VEC_SHR(a, s)		vshlq_u32 (a, vdupq_n_s32 (-(pint) (s)))
+#endif
+
+#ifdef P_HASH_VEC
+#  define P_HASH_VEC_NOT(a)		P_HASH_VEC_XOR (a, P_HASH_VEC_SET1 (0xFFFFFFFF))
+#  define P_HASH_VEC_ROTL(a, s)		P_HASH_VEC_OR (P_HASH_VEC_SHL (a, s), P_HASH_VEC_SHR (a, 32 - (s)))
+#endif
+
+P_BEGIN_DECLS
+
+#ifdef P_HASH_VEC
+void		p_crypto_hash_md5_process_x4		(puint32 state[][P_HASH_VEC_LANES],
+							 const puint32 data[16][P_HASH_VEC_LANES]);
+void		p_crypto_hash_sha1_process_x4		(puint32 state[][P_HASH_VEC_LANES],
+							 const puint32 data[16][P_HASH_VEC_LANES]);
+void		p_crypto_hash_sha2_256_process_x4	(puint32 state[][P_HASH_VEC_LANES],
+							 const puint32 data[16][P_HASH_VEC_LANES]);
+#endif
+
+/* Returns FALSE if the type has no multi-buffer implementation or a single
+ * stream is faster on this CPU, nothing is computed in that case */
+pboolean	p_crypto_hash_multi_compute		(PCryptoHashType	type,
+							 const puchar * const	*inputs,
+							 const psize		*lens,
+							 psize			n,
+							 puchar			*digests);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PCRYPTOHASHMULTI_H */
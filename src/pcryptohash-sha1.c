@@ -27,7 +27,15 @@
 #include <stdlib.h>
 
 #include "pmem.h"
+#include "pcpufeatures-private.h"
 #include "pcryptohash-sha1.h"
+#include "pcryptohash-multi.h"
+
+#if defined (P_CPU_X86_SHA)
+#  include <immintrin.h>
+#elif defined (P_CPU_ARM_SHA)
+#  include <arm_neon.h>
+#endif
 
 struct PHashSHA1_ {
 	union buf_ {
@@ -38,6 +46,8 @@ struct PHashSHA1_ {
 
 	puint32		len_high;
 	puint32		len_low;
+
+	pboolean	accel;
 };
 
 static const puchar pp_crypto_hash_sha1_pad[64] = {
@@ -49,6 +59,12 @@ static const puchar pp_crypto_hash_sha1_pad[64] = {
 
 static void pp_crypto_hash_sha1_swap_bytes (puint32 *data, puint words);
 static void pp_crypto_hash_sha1_process (PHashSHA1 *ctx, const puint32 data[16]);
+static void pp_crypto_hash_sha1_process_blocks (PHashSHA1 *ctx, const puchar *data, psize blocks);
+#if defined (P_CPU_X86_SHA)
+static void pp_crypto_hash_sha1_process_x86 (puint32 *hash, const puchar *data, psize blocks);
+#elif defined (P_CPU_ARM_SHA)
+static void pp_crypto_hash_sha1_process_arm (puint32 *hash, const puchar *data, psize blocks);
+#endif
 
 #define P_SHA1_ROTL(val, shift) ((val) << (shift) |  (val) >> (32 - (shift)))
 
@@ -94,6 +110,35 @@ static void pp_crypto_hash_sha1_process (PHashSHA1 *ctx, const puint32 data[16])
 	b = P_SHA1_ROTL (b, 30);			\
 }
 
+#ifdef P_HASH_VEC
+#  define P_SHA1_VEC_F1(x, y, z) P_HASH_VEC_XOR (z, P_HASH_VEC_AND (x, P_HASH_VEC_XOR (y, z)))
+#  define P_SHA1_VEC_F2(x, y, z) P_HASH_VEC_XOR (P_HASH_VEC_XOR (x, y), z)
+#  define P_SHA1_VEC_F3(x, y, z) P_HASH_VEC_OR (P_HASH_VEC_AND (x, y), P_HASH_VEC_AND (z, P_HASH_VEC_OR (x, y)))
+
+#  define P_SHA1_VEC_W(W, i)							\
+(										\
+	(W)[(i) & 0x0F] = P_HASH_VEC_ROTL (					\
+		P_HASH_VEC_XOR (P_HASH_VEC_XOR ((W)[((i) - 3)  & 0x0F],		\
+						(W)[((i) - 8)  & 0x0F]),		\
+				P_HASH_VEC_XOR ((W)[((i) - 14) & 0x0F],		\
+						(W)[((i) - 16) & 0x0F])),		\
+		1)								\
+)
+
+#  define P_SHA1_VEC_ROUND(f, k, a, b, c, d, e, w)				\
+{										\
+	e = P_HASH_VEC_ADD (P_HASH_VEC_ADD (e, P_HASH_VEC_ROTL (a, 5)),		\
+			    P_HASH_VEC_ADD (f (b, c, d),				\
+					    P_HASH_VEC_ADD (P_HASH_VEC_SET1 (k), w)));	\
+	b = P_HASH_VEC_ROTL (b, 30);						\
+}
+
+#  define P_SHA1_VEC_ROUND_0(a, b, c, d, e, w) P_SHA1_VEC_ROUND (P_SHA1_VEC_F1, 0x5A827999, a, b, c, d, e, w)
+#  define P_SHA1_VEC_ROUND_1(a, b, c, d, e, w) P_SHA1_VEC_ROUND (P_SHA1_VEC_F2, 0x6ED9EBA1, a, b, c, d, e, w)
+#  define P_SHA1_VEC_ROUND_2(a, b, c, d, e, w) P_SHA1_VEC_ROUND (P_SHA1_VEC_F3, 0x8F1BBCDC, a, b, c, d, e, w)
+#  define P_SHA1_VEC_ROUND_3(a, b, c, d, e, w) P_SHA1_VEC_ROUND (P_SHA1_VEC_F2, 0xCA62C1D6, a, b, c, d, e, w)
+#endif
+
 static void
 pp_crypto_hash_sha1_swap_bytes (puint32	*data,
 				puint	words)
@@ -217,6 +262,257 @@ pp_crypto_hash_sha1_process (PHashSHA1		*ctx,
 	ctx->hash[4] += E;
 }
 
+#ifdef P_HASH_VEC
+void
+p_crypto_hash_sha1_process_x4 (puint32		state[][P_HASH_VEC_LANES],
+			       const puint32	data[16][P_HASH_VEC_LANES])
+{
+	PHashVec	W[16], A, B, C, D, E;
+	puint		i;
+
+	for (i = 0; i < 16; ++i)
+		W[i] = P_HASH_VEC_LOAD (data[i]);
+
+	A = P_HASH_VEC_LOAD (state[0]);
+	B = P_HASH_VEC_LOAD (state[1]);
+	C = P_HASH_VEC_LOAD (state[2]);
+	D = P_HASH_VEC_LOAD (state[3]);
+	E = P_HASH_VEC_LOAD (state[4]);
+
+	P_SHA1_VEC_ROUND_0 (A, B, C, D, E, W[0]);
+	P_SHA1_VEC_ROUND_0 (E, A, B, C, D, W[1]);
+	P_SHA1_VEC_ROUND_0 (D, E, A, B, C, W[2]);
+	P_SHA1_VEC_ROUND_0 (C, D, E, A, B, W[3]);
+	P_SHA1_VEC_ROUND_0 (B, C, D, E, A, W[4]);
+	P_SHA1_VEC_ROUND_0 (A, B, C, D, E, W[5]);
+	P_SHA1_VEC_ROUND_0 (E, A, B, C, D, W[6]);
+	P_SHA1_VEC_ROUND_0 (D, E, A, B, C, W[7]);
+	P_SHA1_VEC_ROUND_0 (C, D, E, A, B, W[8]);
+	P_SHA1_VEC_ROUND_0 (B, C, D, E, A, W[9]);
+	P_SHA1_VEC_ROUND_0 (A, B, C, D, E, W[10]);
+	P_SHA1_VEC_ROUND_0 (E, A, B, C, D, W[11]);
+	P_SHA1_VEC_ROUND_0 (D, E, A, B, C, W[12]);
+	P_SHA1_VEC_ROUND_0 (C, D, E, A, B, W[13]);
+	P_SHA1_VEC_ROUND_0 (B, C, D, E, A, W[14]);
+	P_SHA1_VEC_ROUND_0 (A, B, C, D, E, W[15]);
+	P_SHA1_VEC_ROUND_0 (E, A, B, C, D, P_SHA1_VEC_W (W, 16));
+	P_SHA1_VEC_ROUND_0 (D, E, A, B, C, P_SHA1_VEC_W (W, 17));
+	P_SHA1_VEC_ROUND_0 (C, D, E, A, B, P_SHA1_VEC_W (W, 18));
+	P_SHA1_VEC_ROUND_0 (B, C, D, E, A, P_SHA1_VEC_W (W, 19));
+
+	P_SHA1_VEC_ROUND_1 (A, B, C, D, E, P_SHA1_VEC_W (W, 20));
+	P_SHA1_VEC_ROUND_1 (E, A, B, C, D, P_SHA1_VEC_W (W, 21));
+	P_SHA1_VEC_ROUND_1 (D, E, A, B, C, P_SHA1_VEC_W (W, 22));
+	P_SHA1_VEC_ROUND_1 (C, D, E, A, B, P_SHA1_VEC_W (W, 23));
+	P_SHA1_VEC_ROUND_1 (B, C, D, E, A, P_SHA1_VEC_W (W, 24));
+	P_SHA1_VEC_ROUND_1 (A, B, C, D, E, P_SHA1_VEC_W (W, 25));
+	P_SHA1_VEC_ROUND_1 (E, A, B, C, D, P_SHA1_VEC_W (W, 26));
+	P_SHA1_VEC_ROUND_1 (D, E, A, B, C, P_SHA1_VEC_W (W, 27));
+	P_SHA1_VEC_ROUND_1 (C, D, E, A, B, P_SHA1_VEC_W (W, 28));
+	P_SHA1_VEC_ROUND_1 (B, C, D, E, A, P_SHA1_VEC_W (W, 29));
+	P_SHA1_VEC_ROUND_1 (A, B, C, D, E, P_SHA1_VEC_W (W, 30));
+	P_SHA1_VEC_ROUND_1 (E, A, B, C, D, P_SHA1_VEC_W (W, 31));
+	P_SHA1_VEC_ROUND_1 (D, E, A, B, C, P_SHA1_VEC_W (W, 32));
+	P_SHA1_VEC_ROUND_1 (C, D, E, A, B, P_SHA1_VEC_W (W, 33));
+	P_SHA1_VEC_ROUND_1 (B, C, D, E, A, P_SHA1_VEC_W (W, 34));
+	P_SHA1_VEC_ROUND_1 (A, B, C, D, E, P_SHA1_VEC_W (W, 35));
+	P_SHA1_VEC_ROUND_1 (E, A, B, C, D, P_SHA1_VEC_W (W, 36));
+	P_SHA1_VEC_ROUND_1 (D, E, A, B, C, P_SHA1_VEC_W (W, 37));
+	P_SHA1_VEC_ROUND_1 (C, D, E, A, B, P_SHA1_VEC_W (W, 38));
+	P_SHA1_VEC_ROUND_1 (B, C, D, E, A, P_SHA1_VEC_W (W, 39));
+
+	P_SHA1_VEC_ROUND_2 (A, B, C, D, E, P_SHA1_VEC_W (W, 40));
+	P_SHA1_VEC_ROUND_2 (E, A, B, C, D, P_SHA1_VEC_W (W, 41));
+	P_SHA1_VEC_ROUND_2 (D, E, A, B, C, P_SHA1_VEC_W (W, 42));
+	P_SHA1_VEC_ROUND_2 (C, D, E, A, B, P_SHA1_VEC_W (W, 43));
+	P_SHA1_VEC_ROUND_2 (B, C, D, E, A, P_SHA1_VEC_W (W, 44));
+	P_SHA1_VEC_ROUND_2 (A, B, C, D, E, P_SHA1_VEC_W (W, 45));
+	P_SHA1_VEC_ROUND_2 (E, A, B, C, D, P_SHA1_VEC_W (W, 46));
+	P_SHA1_VEC_ROUND_2 (D, E, A, B, C, P_SHA1_VEC_W (W, 47));
+	P_SHA1_VEC_ROUND_2 (C, D, E, A, B, P_SHA1_VEC_W (W, 48));
+	P_SHA1_VEC_ROUND_2 (B, C, D, E, A, P_SHA1_VEC_W (W, 49));
+	P_SHA1_VEC_ROUND_2 (A, B, C, D, E, P_SHA1_VEC_W (W, 50));
+	P_SHA1_VEC_ROUND_2 (E, A, B, C, D, P_SHA1_VEC_W (W, 51));
+	P_SHA1_VEC_ROUND_2 (D, E, A, B, C, P_SHA1_VEC_W (W, 52));
+	P_SHA1_VEC_ROUND_2 (C, D, E, A, B, P_SHA1_VEC_W (W, 53));
+	P_SHA1_VEC_ROUND_2 (B, C, D, E, A, P_SHA1_VEC_W (W, 54));
+	P_SHA1_VEC_ROUND_2 (A, B, C, D, E, P_SHA1_VEC_W (W, 55));
+	P_SHA1_VEC_ROUND_2 (E, A, B, C, D, P_SHA1_VEC_W (W, 56));
+	P_SHA1_VEC_ROUND_2 (D, E, A, B, C, P_SHA1_VEC_W (W, 57));
+	P_SHA1_VEC_ROUND_2 (C, D, E, A, B, P_SHA1_VEC_W (W, 58));
+	P_SHA1_VEC_ROUND_2 (B, C, D, E, A, P_SHA1_VEC_W (W, 59));
+
+	P_SHA1_VEC_ROUND_3 (A, B, C, D, E, P_SHA1_VEC_W (W, 60));
+	P_SHA1_VEC_ROUND_3 (E, A, B, C, D, P_SHA1_VEC_W (W, 61));
+	P_SHA1_VEC_ROUND_3 (D, E, A, B, C, P_SHA1_VEC_W (W, 62));
+	P_SHA1_VEC_ROUND_3 (C, D, E, A, B, P_SHA1_VEC_W (W, 63));
+	P_SHA1_VEC_ROUND_3 (B, C, D, E, A, P_SHA1_VEC_W (W, 64));
+	P_SHA1_VEC_ROUND_3 (A, B, C, D, E, P_SHA1_VEC_W (W, 65));
+	P_SHA1_VEC_ROUND_3 (E, A, B, C, D, P_SHA1_VEC_W (W, 66));
+	P_SHA1_VEC_ROUND_3 (D, E, A, B, C, P_SHA1_VEC_W (W, 67));
+	P_SHA1_VEC_ROUND_3 (C, D, E, A, B, P_SHA1_VEC_W (W, 68));
+	P_SHA1_VEC_ROUND_3 (B, C, D, E, A, P_SHA1_VEC_W (W, 69));
+	P_SHA1_VEC_ROUND_3 (A, B, C, D, E, P_SHA1_VEC_W (W, 70));
+	P_SHA1_VEC_ROUND_3 (E, A, B, C, D, P_SHA1_VEC_W (W, 71));
+	P_SHA1_VEC_ROUND_3 (D, E, A, B, C, P_SHA1_VEC_W (W, 72));
+	P_SHA1_VEC_ROUND_3 (C, D, E, A, B, P_SHA1_VEC_W (W, 73));
+	P_SHA1_VEC_ROUND_3 (B, C, D, E, A, P_SHA1_VEC_W (W, 74));
+	P_SHA1_VEC_ROUND_3 (A, B, C, D, E, P_SHA1_VEC_W (W, 75));
+	P_SHA1_VEC_ROUND_3 (E, A, B, C, D, P_SHA1_VEC_W (W, 76));
+	P_SHA1_VEC_ROUND_3 (D, E, A, B, C, P_SHA1_VEC_W (W, 77));
+	P_SHA1_VEC_ROUND_3 (C, D, E, A, B, P_SHA1_VEC_W (W, 78));
+	P_SHA1_VEC_ROUND_3 (B, C, D, E, A, P_SHA1_VEC_W (W, 79));
+
+	P_HASH_VEC_STORE (state[0], P_HASH_VEC_ADD (A, P_HASH_VEC_LOAD (state[0])));
+	P_HASH_VEC_STORE (state[1], P_HASH_VEC_ADD (B, P_HASH_VEC_LOAD (state[1])));
+	P_HASH_VEC_STORE (state[2], P_HASH_VEC_ADD (C, P_HASH_VEC_LOAD (state[2])));
+	P_HASH_VEC_STORE (state[3], P_HASH_VEC_ADD (D, P_HASH_VEC_LOAD (state[3])));
+	P_HASH_VEC_STORE (state[4], P_HASH_VEC_ADD (E, P_HASH_VEC_LOAD (state[4])));
+}
+#endif
+
+#if defined (P_CPU_X86_SHA)
+P_CPU_X86_SHA_TARGET static void
+pp_crypto_hash_sha1_process_x86 (puint32	*hash,
+				 const puchar	*data,
+				 psize		blocks)
+{
+	__m128i	abcd, abcd_prev, abcd_save, e0, e0_save;
+	__m128i	msg[4], e, mask;
+	pint	g;
+
+	mask = _mm_set_epi32 (0x00010203, 0x04050607, 0x08090A0B, 0x0C0D0E0F);
+
+	abcd = _mm_shuffle_epi32 (_mm_loadu_si128 ((const __m128i *) hash), 0x1B);
+	e0   = _mm_set_epi32 ((pint) hash[4], 0, 0, 0);
+
+	while (blocks-- > 0) {
+		abcd_save = abcd;
+		e0_save   = e0;
+		abcd_prev = abcd;
+
+		for (g = 0; g < 20; ++g) {
+			if (g < 4)
+				msg[g] = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i *) (data + g * 16)), mask);
+			else
+				msg[g & 3] = _mm_sha1msg2_epu32 (
+						_mm_xor_si128 (_mm_sha1msg1_epu32 (msg[g & 3], msg[(g + 1) & 3]),
+							       msg[(g + 2) & 3]),
+						msg[(g + 3) & 3]);
+
+			/* E for the next four rounds is derived from A four rounds ago */
+			e = (g == 0) ? _mm_add_epi32 (e0, msg[0])
+				     : _mm_sha1nexte_epu32 (abcd_prev, msg[g & 3]);
+
+			abcd_prev = abcd;
+
+			/* Round function selector must be an immediate */
+			switch (g / 5) {
+			case 0:
+				abcd = _mm_sha1rnds4_epu32 (abcd, e, 0);
+				break;
+			case 1:
+				abcd = _mm_sha1rnds4_epu32 (abcd, e, 1);
+				break;
+			case 2:
+				abcd = _mm_sha1rnds4_epu32 (abcd, e, 2);
+				break;
+			default:
+				abcd = _mm_sha1rnds4_epu32 (abcd, e, 3);
+				break;
+			}
+		}
+
+		e0   = _mm_sha1nexte_epu32 (abcd_prev, e0_save);
+		abcd = _mm_add_epi32 (abcd, abcd_save);
+
+		data += 64;
+	}
+
+	_mm_storeu_si128 ((__m128i *) hash, _mm_shuffle_epi32 (abcd, 0x1B));
+	hash[4] = (puint32) _mm_extract_epi32 (e0, 3);
+}
+#elif defined (P_CPU_ARM_SHA)
+static void
+pp_crypto_hash_sha1_process_arm (puint32	*hash,
+				 const puchar	*data,
+				 psize		blocks)
+{
+	static const puint32 K[4] = { 0x5A827999, 0x6ED9EBA1, 0x8F1BBCDC, 0xCA62C1D6 };
+
+	uint32x4_t	abcd, abcd_save;
+	uint32x4_t	msg[4], tmp;
+	puint32		e0, e0_save, e_next;
+	pint		g;
+
+	abcd = vld1q_u32 (hash);
+	e0   = hash[4];
+
+	while (blocks-- > 0) {
+		abcd_save = abcd;
+		e0_save   = e0;
+
+		for (g = 0; g < 20; ++g) {
+			if (g < 4)
+				msg[g] = vreinterpretq_u32_u8 (vrev32q_u8 (vld1q_u8 (data + g * 16)));
+			else
+				msg[g & 3] = vsha1su1q_u32 (vsha1su0q_u32 (msg[g & 3],
+									   msg[(g + 1) & 3],
+									   msg[(g + 2) & 3]),
+							    msg[(g + 3) & 3]);
+
+			tmp    = vaddq_u32 (msg[g & 3], vdupq_n_u32 (K[g / 5]));
+			e_next = vsha1h_u32 (vgetq_lane_u32 (abcd, 0));
+
+			if (g < 5)
+				abcd = vsha1cq_u32 (abcd, e0, tmp);
+			else if (g < 10 || g >= 15)
+				abcd = vsha1pq_u32 (abcd, e0, tmp);
+			else
+				abcd = vsha1mq_u32 (abcd, e0, tmp);
+
+			e0 = e_next;
+		}
+
+		abcd = vaddq_u32 (abcd, abcd_save);
+		e0  += e0_save;
+
+		data += 64;
+	}
+
+	vst1q_u32 (hash, abcd);
+	hash[4] = e0;
+}
+#endif
+
+static void
+pp_crypto_hash_sha1_process_blocks (PHashSHA1		*ctx,
+				    const puchar	*data,
+				    psize		blocks)
+{
+	puint32 W[16];
+
+#if defined (P_CPU_X86_SHA)
+	if (ctx->accel == TRUE) {
+		pp_crypto_hash_sha1_process_x86 (ctx->hash, data, blocks);
+		return;
+	}
+#elif defined (P_CPU_ARM_SHA)
+	if (ctx->accel == TRUE) {
+		pp_crypto_hash_sha1_process_arm (ctx->hash, data, blocks);
+		return;
+	}
+#endif
+
+	while (blocks-- > 0) {
+		memcpy (W, data, 64);
+		pp_crypto_hash_sha1_swap_bytes (W, 16);
+		pp_crypto_hash_sha1_process (ctx, W);
+
+		data += 64;
+	}
+}
+
 void
 p_crypto_hash_sha1_reset (PHashSHA1 *ctx)
 {
@@ -233,18 +529,35 @@ p_crypto_hash_sha1_reset (PHashSHA1 *ctx)
 }
 
 PHashSHA1 *
-p_crypto_hash_sha1_new (void)
+p_crypto_hash_sha1_init (ppointer	mem,
+			 psize		size)
 {
 	PHashSHA1 *ret;
 
-	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PHashSHA1))) == NULL))
+	if (P_UNLIKELY (mem == NULL || size < sizeof (PHashSHA1)))
 		return NULL;
 
+	ret = (PHashSHA1 *) mem;
+	memset (ret, 0, sizeof (PHashSHA1));
+
+	ret->accel = p_cpu_has_feature_internal (P_CPU_FEATURE_SHA1);
+
 	p_crypto_hash_sha1_reset (ret);
 
 	return ret;
 }
 
+PHashSHA1 *
+p_crypto_hash_sha1_new (void)
+{
+	PHashSHA1 *ret;
+
+	if (P_UNLIKELY ((ret = p_malloc (sizeof (PHashSHA1))) == NULL))
+		return NULL;
+
+	return p_crypto_hash_sha1_init (ret, sizeof (PHashSHA1));
+}
+
 void
 p_crypto_hash_sha1_update (PHashSHA1	*ctx,
 			   const puchar	*data,
@@ -262,21 +575,18 @@ p_crypto_hash_sha1_update (PHashSHA1	*ctx,
 
 	if (left && (puint32) len >= to_fill) {
 		memcpy (ctx->buf.buf + left, data, to_fill);
-		pp_crypto_hash_sha1_swap_bytes (ctx->buf.buf_w, 16);
-		pp_crypto_hash_sha1_process (ctx, ctx->buf.buf_w);
+		pp_crypto_hash_sha1_process_blocks (ctx, ctx->buf.buf, 1);
 
 		data += to_fill;
 		len -= to_fill;
 		left = 0;
 	}
 
-	while (len >= 64) {
-		memcpy (ctx->buf.buf, data, 64);
-		pp_crypto_hash_sha1_swap_bytes (ctx->buf.buf_w, 16);
-		pp_crypto_hash_sha1_process (ctx, ctx->buf.buf_w);
+	if (len >= 64) {
+		pp_crypto_hash_sha1_process_blocks (ctx, data, len / 64);
 
-		data += 64;
-		len -= 64;
+		data += len & ~((psize) 0x3F);
+		len &= 0x3F;
 	}
 
 	if (len > 0)
@@ -299,11 +609,12 @@ p_crypto_hash_sha1_finish (PHashSHA1 *ctx)
 	if (last > 0)
 		p_crypto_hash_sha1_update (ctx, pp_crypto_hash_sha1_pad, (psize) last);
 
-	ctx->buf.buf_w[14] = high;
-	ctx->buf.buf_w[15] = low;
+	/* Keep the buffer in the byte order, so the last block can take the
+	 * accelerated path as well */
+	ctx->buf.buf_w[14] = PUINT32_TO_BE (high);
+	ctx->buf.buf_w[15] = PUINT32_TO_BE (low);
 
-	pp_crypto_hash_sha1_swap_bytes (ctx->buf.buf_w, 14);
-	pp_crypto_hash_sha1_process (ctx, ctx->buf.buf_w);
+	pp_crypto_hash_sha1_process_blocks (ctx, ctx->buf.buf, 1);
 
 	pp_crypto_hash_sha1_swap_bytes (ctx->hash, 5);
 }
@@ -314,6 +625,13 @@ p_crypto_hash_sha1_digest (PHashSHA1 *ctx)
 	return (const puchar *) ctx->hash;
 }
 
+void
+p_crypto_hash_sha1_copy (PHashSHA1		*dst,
+			 const PHashSHA1	*src)
+{
+	memcpy (dst, src, sizeof (PHashSHA1));
+}
+
 void
 p_crypto_hash_sha1_free (PHashSHA1 *ctx)
 {
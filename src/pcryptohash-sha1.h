@@ -40,11 +40,13 @@ P_BEGIN_DECLS
 typedef struct PHashSHA1_ PHashSHA1;
 
 PHashSHA1 *	p_crypto_hash_sha1_new		(void);
+PHashSHA1 *	p_crypto_hash_sha1_init		(ppointer mem, psize size);
 void		p_crypto_hash_sha1_update	(PHashSHA1 *ctx, const puchar *data, psize len);
 void		p_crypto_hash_sha1_finish	(PHashSHA1 *ctx);
 const puchar *	p_crypto_hash_sha1_digest	(PHashSHA1 *ctx);
 void		p_crypto_hash_sha1_reset	(PHashSHA1 *ctx);
 void		p_crypto_hash_sha1_free		(PHashSHA1 *ctx);
+void		p_crypto_hash_sha1_copy		(PHashSHA1 *dst, const PHashSHA1 *src);
 
 P_END_DECLS
 
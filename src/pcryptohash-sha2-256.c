@@ -27,7 +27,15 @@
 #include <stdlib.h>
 
 #include "pmem.h"
+#include "pcpufeatures-private.h"
 #include "pcryptohash-sha2-256.h"
+#include "pcryptohash-multi.h"
+
+#if defined (P_CPU_X86_SHA)
+#  include <immintrin.h>
+#elif defined (P_CPU_ARM_SHA)
+#  include <arm_neon.h>
+#endif
 
 struct PHashSHA2_256_ {
 	union buf_ {
@@ -40,6 +48,7 @@ struct PHashSHA2_256_ {
 	puint32		len_low;
 
 	pboolean	is224;
+	pboolean	accel;
 };
 
 static const puchar pp_crypto_hash_sha2_256_pad[64] = {
@@ -70,7 +79,13 @@ static const puint32 pp_crypto_hash_sha2_256_K[] = {
 
 static void pp_crypto_hash_sha2_256_swap_bytes (puint32 *data, puint words);
 static void pp_crypto_hash_sha2_256_process (PHashSHA2_256 *ctx, const puint32 data[16]);
-static PHashSHA2_256 * pp_crypto_hash_sha2_256_new_internal (pboolean is224);
+static void pp_crypto_hash_sha2_256_process_blocks (PHashSHA2_256 *ctx, const puchar *data, psize blocks);
+#if defined (P_CPU_X86_SHA)
+static void pp_crypto_hash_sha2_256_process_x86 (puint32 *hash, const puchar *data, psize blocks);
+#elif defined (P_CPU_ARM_SHA)
+static void pp_crypto_hash_sha2_256_process_arm (puint32 *hash, const puchar *data, psize blocks);
+#endif
+static PHashSHA2_256 * pp_crypto_hash_sha2_256_init_internal (ppointer mem, psize size, pboolean is224);
 
 #define P_SHA2_256_SHR(val, shift) (((val) & 0xFFFFFFFF) >> (shift))
 #define P_SHA2_256_ROTR(val, shift) (P_SHA2_256_SHR(val, shift) | ((val) << (32 - (shift))))
@@ -97,6 +112,39 @@ static PHashSHA2_256 * pp_crypto_hash_sha2_256_new_internal (pboolean is224);
 	h = tmp_sum1 + tmp_sum2;						\
 }
 
+#ifdef P_HASH_VEC
+#  define P_SHA2_256_VEC_ROTR(val, shift) P_HASH_VEC_ROTL (val, 32 - (shift))
+
+#  define P_SHA2_256_VEC_XOR3(x, y, z) P_HASH_VEC_XOR (P_HASH_VEC_XOR (x, y), z)
+
+#  define P_SHA2_256_VEC_S0(x) P_SHA2_256_VEC_XOR3 (P_SHA2_256_VEC_ROTR (x, 7),  P_SHA2_256_VEC_ROTR (x, 18), P_HASH_VEC_SHR (x, 3))
+#  define P_SHA2_256_VEC_S1(x) P_SHA2_256_VEC_XOR3 (P_SHA2_256_VEC_ROTR (x, 17), P_SHA2_256_VEC_ROTR (x, 19), P_HASH_VEC_SHR (x, 10))
+#  define P_SHA2_256_VEC_S2(x) P_SHA2_256_VEC_XOR3 (P_SHA2_256_VEC_ROTR (x, 2),  P_SHA2_256_VEC_ROTR (x, 13), P_SHA2_256_VEC_ROTR (x, 22))
+#  define P_SHA2_256_VEC_S3(x) P_SHA2_256_VEC_XOR3 (P_SHA2_256_VEC_ROTR (x, 6),  P_SHA2_256_VEC_ROTR (x, 11), P_SHA2_256_VEC_ROTR (x, 25))
+
+#  define P_SHA2_256_VEC_F0(x, y, z) P_HASH_VEC_OR (P_HASH_VEC_AND (x, y), P_HASH_VEC_AND (z, P_HASH_VEC_OR (x, y)))
+#  define P_SHA2_256_VEC_F1(x, y, z) P_HASH_VEC_XOR (z, P_HASH_VEC_AND (x, P_HASH_VEC_XOR (y, z)))
+
+#  define P_SHA2_256_VEC_R(t)							\
+(										\
+	W[(t) & 0x0F] = P_HASH_VEC_ADD (						\
+		P_HASH_VEC_ADD (P_SHA2_256_VEC_S1 (W[((t) -  2) & 0x0F]),		\
+				W[((t) -  7) & 0x0F]),				\
+		P_HASH_VEC_ADD (P_SHA2_256_VEC_S0 (W[((t) - 15) & 0x0F]),		\
+				W[(t) & 0x0F]))					\
+)
+
+#  define P_SHA2_256_VEC_P(a, b, c, d, e, f, g, h, x, K)			\
+{										\
+	tmp_sum1 = P_HASH_VEC_ADD (P_HASH_VEC_ADD (h, P_SHA2_256_VEC_S3 (e)),	\
+				   P_HASH_VEC_ADD (P_SHA2_256_VEC_F1 (e, f, g),	\
+						   P_HASH_VEC_ADD (P_HASH_VEC_SET1 (K), x)));	\
+	tmp_sum2 = P_HASH_VEC_ADD (P_SHA2_256_VEC_S2 (a), P_SHA2_256_VEC_F0 (a, b, c));	\
+	d = P_HASH_VEC_ADD (d, tmp_sum1);					\
+	h = P_HASH_VEC_ADD (tmp_sum1, tmp_sum2);				\
+}
+#endif
+
 static void
 pp_crypto_hash_sha2_256_swap_bytes (puint32	*data,
 				    puint	words)
@@ -152,15 +200,186 @@ pp_crypto_hash_sha2_256_process (PHashSHA2_256	*ctx,
 		ctx->hash[i] += A[i];
 }
 
+#ifdef P_HASH_VEC
+void
+p_crypto_hash_sha2_256_process_x4 (puint32		state[][P_HASH_VEC_LANES],
+				   const puint32	data[16][P_HASH_VEC_LANES])
+{
+	PHashVec	tmp_sum1, tmp_sum2;
+	PHashVec	W[16];
+	PHashVec	A[8];
+	puint		i;
+
+	for (i = 0; i < 8; i++)
+		A[i] = P_HASH_VEC_LOAD (state[i]);
+
+	for (i = 0; i < 16; i++)
+		W[i] = P_HASH_VEC_LOAD (data[i]);
+
+	for (i = 0; i < 16; i += 8) {
+		P_SHA2_256_VEC_P (A[0], A[1], A[2], A[3], A[4], A[5], A[6], A[7], W[i + 0], pp_crypto_hash_sha2_256_K[i + 0]);
+		P_SHA2_256_VEC_P (A[7], A[0], A[1], A[2], A[3], A[4], A[5], A[6], W[i + 1], pp_crypto_hash_sha2_256_K[i + 1]);
+		P_SHA2_256_VEC_P (A[6], A[7], A[0], A[1], A[2], A[3], A[4], A[5], W[i + 2], pp_crypto_hash_sha2_256_K[i + 2]);
+		P_SHA2_256_VEC_P (A[5], A[6], A[7], A[0], A[1], A[2], A[3], A[4], W[i + 3], pp_crypto_hash_sha2_256_K[i + 3]);
+		P_SHA2_256_VEC_P (A[4], A[5], A[6], A[7], A[0], A[1], A[2], A[3], W[i + 4], pp_crypto_hash_sha2_256_K[i + 4]);
+		P_SHA2_256_VEC_P (A[3], A[4], A[5], A[6], A[7], A[0], A[1], A[2], W[i + 5], pp_crypto_hash_sha2_256_K[i + 5]);
+		P_SHA2_256_VEC_P (A[2], A[3], A[4], A[5], A[6], A[7], A[0], A[1], W[i + 6], pp_crypto_hash_sha2_256_K[i + 6]);
+		P_SHA2_256_VEC_P (A[1], A[2], A[3], A[4], A[5], A[6], A[7], A[0], W[i + 7], pp_crypto_hash_sha2_256_K[i + 7]);
+	}
+
+	for (i = 16; i < 64; i += 8) {
+		P_SHA2_256_VEC_P (A[0], A[1], A[2], A[3], A[4], A[5], A[6], A[7], P_SHA2_256_VEC_R (i + 0), pp_crypto_hash_sha2_256_K[i + 0]);
+		P_SHA2_256_VEC_P (A[7], A[0], A[1], A[2], A[3], A[4], A[5], A[6], P_SHA2_256_VEC_R (i + 1), pp_crypto_hash_sha2_256_K[i + 1]);
+		P_SHA2_256_VEC_P (A[6], A[7], A[0], A[1], A[2], A[3], A[4], A[5], P_SHA2_256_VEC_R (i + 2), pp_crypto_hash_sha2_256_K[i + 2]);
+		P_SHA2_256_VEC_P (A[5], A[6], A[7], A[0], A[1], A[2], A[3], A[4], P_SHA2_256_VEC_R (i + 3), pp_crypto_hash_sha2_256_K[i + 3]);
+		P_SHA2_256_VEC_P (A[4], A[5], A[6], A[7], A[0], A[1], A[2], A[3], P_SHA2_256_VEC_R (i + 4), pp_crypto_hash_sha2_256_K[i + 4]);
+		P_SHA2_256_VEC_P (A[3], A[4], A[5], A[6], A[7], A[0], A[1], A[2], P_SHA2_256_VEC_R (i + 5), pp_crypto_hash_sha2_256_K[i + 5]);
+		P_SHA2_256_VEC_P (A[2], A[3], A[4], A[5], A[6], A[7], A[0], A[1], P_SHA2_256_VEC_R (i + 6), pp_crypto_hash_sha2_256_K[i + 6]);
+		P_SHA2_256_VEC_P (A[1], A[2], A[3], A[4], A[5], A[6], A[7], A[0], P_SHA2_256_VEC_R (i + 7), pp_crypto_hash_sha2_256_K[i + 7]);
+	}
+
+	for (i = 0; i < 8; i++)
+		P_HASH_VEC_STORE (state[i], P_HASH_VEC_ADD (A[i], P_HASH_VEC_LOAD (state[i])));
+}
+#endif
+
+#if defined (P_CPU_X86_SHA)
+P_CPU_X86_SHA_TARGET static void
+pp_crypto_hash_sha2_256_process_x86 (puint32		*hash,
+				     const puchar	*data,
+				     psize		blocks)
+{
+	__m128i	state0, state1, save0, save1;
+	__m128i	msg[4], tmp, mask;
+	pint	g;
+
+	mask = _mm_set_epi32 (0x0C0D0E0F, 0x08090A0B, 0x04050607, 0x00010203);
+
+	/* Rearrange the state into ABEF and CDGH halves */
+	tmp    = _mm_shuffle_epi32 (_mm_loadu_si128 ((const __m128i *) &hash[0]), 0xB1);
+	state1 = _mm_shuffle_epi32 (_mm_loadu_si128 ((const __m128i *) &hash[4]), 0x1B);
+	state0 = _mm_alignr_epi8 (tmp, state1, 8);
+	state1 = _mm_blend_epi16 (state1, tmp, 0xF0);
+
+	while (blocks-- > 0) {
+		save0 = state0;
+		save1 = state1;
+
+		for (g = 0; g < 16; ++g) {
+			if (g < 4)
+				msg[g] = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i *) (data + g * 16)), mask);
+			else
+				msg[g & 3] = _mm_sha256msg2_epu32 (
+						_mm_add_epi32 (_mm_sha256msg1_epu32 (msg[g & 3], msg[(g + 1) & 3]),
+							       _mm_alignr_epi8 (msg[(g + 3) & 3], msg[(g + 2) & 3], 4)),
+						msg[(g + 3) & 3]);
+
+			tmp    = _mm_add_epi32 (msg[g & 3],
+						_mm_loadu_si128 ((const __m128i *) &pp_crypto_hash_sha2_256_K[g * 4]));
+			state1 = _mm_sha256rnds2_epu32 (state1, state0, tmp);
+			tmp    = _mm_shuffle_epi32 (tmp, 0x0E);
+			state0 = _mm_sha256rnds2_epu32 (state0, state1, tmp);
+		}
+
+		state0 = _mm_add_epi32 (state0, save0);
+		state1 = _mm_add_epi32 (state1, save1);
+
+		data += 64;
+	}
+
+	tmp    = _mm_shuffle_epi32 (state0, 0x1B);
+	state1 = _mm_shuffle_epi32 (state1, 0xB1);
+	state0 = _mm_blend_epi16 (tmp, state1, 0xF0);
+	state1 = _mm_alignr_epi8 (state1, tmp, 8);
+
+	_mm_storeu_si128 ((__m128i *) &hash[0], state0);
+	_mm_storeu_si128 ((__m128i *) &hash[4], state1);
+}
+#elif defined (P_CPU_ARM_SHA)
+static void
+pp_crypto_hash_sha2_256_process_arm (puint32		*hash,
+				     const puchar	*data,
+				     psize		blocks)
+{
+	uint32x4_t	state0, state1, save0, save1;
+	uint32x4_t	msg[4], tmp0, tmp1;
+	pint		g;
+
+	state0 = vld1q_u32 (&hash[0]);
+	state1 = vld1q_u32 (&hash[4]);
+
+	while (blocks-- > 0) {
+		save0 = state0;
+		save1 = state1;
+
+		for (g = 0; g < 16; ++g) {
+			if (g < 4)
+				msg[g] = vreinterpretq_u32_u8 (vrev32q_u8 (vld1q_u8 (data + g * 16)));
+			else
+				msg[g & 3] = vsha256su1q_u32 (vsha256su0q_u32 (msg[g & 3], msg[(g + 1) & 3]),
+							      msg[(g + 2) & 3],
+							      msg[(g + 3) & 3]);
+
+			tmp0   = vaddq_u32 (msg[g & 3], vld1q_u32 (&pp_crypto_hash_sha2_256_K[g * 4]));
+			tmp1   = state0;
+			state0 = vsha256hq_u32 (state0, state1, tmp0);
+			state1 = vsha256h2q_u32 (state1, tmp1, tmp0);
+		}
+
+		state0 = vaddq_u32 (state0, save0);
+		state1 = vaddq_u32 (state1, save1);
+
+		data += 64;
+	}
+
+	vst1q_u32 (&hash[0], state0);
+	vst1q_u32 (&hash[4], state1);
+}
+#endif
+
+static void
+pp_crypto_hash_sha2_256_process_blocks (PHashSHA2_256	*ctx,
+					const puchar	*data,
+					psize		blocks)
+{
+	puint32 W[16];
+
+#if defined (P_CPU_X86_SHA)
+	if (ctx->accel == TRUE) {
+		pp_crypto_hash_sha2_256_process_x86 (ctx->hash, data, blocks);
+		return;
+	}
+#elif defined (P_CPU_ARM_SHA)
+	if (ctx->accel == TRUE) {
+		pp_crypto_hash_sha2_256_process_arm (ctx->hash, data, blocks);
+		return;
+	}
+#endif
+
+	while (blocks-- > 0) {
+		memcpy (W, data, 64);
+		pp_crypto_hash_sha2_256_swap_bytes (W, 16);
+		pp_crypto_hash_sha2_256_process (ctx, W);
+
+		data += 64;
+	}
+}
+
 static PHashSHA2_256 *
-pp_crypto_hash_sha2_256_new_internal (pboolean is224)
+pp_crypto_hash_sha2_256_init_internal (ppointer	mem,
+				       psize	size,
+				       pboolean	is224)
 {
 	PHashSHA2_256 *ret;
 
-	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PHashSHA2_256))) == NULL))
+	if (P_UNLIKELY (mem == NULL || size < sizeof (PHashSHA2_256)))
 		return NULL;
 
+	ret = (PHashSHA2_256 *) mem;
+	memset (ret, 0, sizeof (PHashSHA2_256));
+
 	ret->is224 = is224;
+	ret->accel = p_cpu_has_feature_internal (P_CPU_FEATURE_SHA2_256);
 
 	p_crypto_hash_sha2_256_reset (ret);
 
@@ -198,16 +417,40 @@ p_crypto_hash_sha2_256_reset (PHashSHA2_256 *ctx)
 	}
 }
 
+PHashSHA2_256 *
+p_crypto_hash_sha2_256_init (ppointer	mem,
+			     psize	size)
+{
+	return pp_crypto_hash_sha2_256_init_internal (mem, size, FALSE);
+}
+
+PHashSHA2_256 *
+p_crypto_hash_sha2_224_init (ppointer	mem,
+			     psize	size)
+{
+	return pp_crypto_hash_sha2_256_init_internal (mem, size, TRUE);
+}
+
 PHashSHA2_256 *
 p_crypto_hash_sha2_256_new (void)
 {
-	return pp_crypto_hash_sha2_256_new_internal (FALSE);
+	PHashSHA2_256 *ret;
+
+	if (P_UNLIKELY ((ret = p_malloc (sizeof (PHashSHA2_256))) == NULL))
+		return NULL;
+
+	return p_crypto_hash_sha2_256_init (ret, sizeof (PHashSHA2_256));
 }
 
 PHashSHA2_256 *
 p_crypto_hash_sha2_224_new (void)
 {
-	return pp_crypto_hash_sha2_256_new_internal (TRUE);
+	PHashSHA2_256 *ret;
+
+	if (P_UNLIKELY ((ret = p_malloc (sizeof (PHashSHA2_256))) == NULL))
+		return NULL;
+
+	return p_crypto_hash_sha2_224_init (ret, sizeof (PHashSHA2_256));
 }
 
 void
@@ -227,21 +470,18 @@ p_crypto_hash_sha2_256_update (PHashSHA2_256	*ctx,
 
 	if (left && (puint32) len >= to_fill) {
 		memcpy (ctx->buf.buf + left, data, to_fill);
-		pp_crypto_hash_sha2_256_swap_bytes (ctx->buf.buf_w, 16);
-		pp_crypto_hash_sha2_256_process (ctx, ctx->buf.buf_w);
+		pp_crypto_hash_sha2_256_process_blocks (ctx, ctx->buf.buf, 1);
 
 		data += to_fill;
 		len -= to_fill;
 		left = 0;
 	}
 
-	while (len >= 64) {
-		memcpy (ctx->buf.buf, data, 64);
-		pp_crypto_hash_sha2_256_swap_bytes (ctx->buf.buf_w, 16);
-		pp_crypto_hash_sha2_256_process (ctx, ctx->buf.buf_w);
+	if (len >= 64) {
+		pp_crypto_hash_sha2_256_process_blocks (ctx, data, len / 64);
 
-		data += 64;
-		len -= 64;
+		data += len & ~((psize) 0x3F);
+		len &= 0x3F;
 	}
 
 	if (len > 0)
@@ -264,11 +504,12 @@ p_crypto_hash_sha2_256_finish (PHashSHA2_256 *ctx)
 	if (last > 0)
 		p_crypto_hash_sha2_256_update (ctx, pp_crypto_hash_sha2_256_pad, (psize) last);
 
-	ctx->buf.buf_w[14] = high;
-	ctx->buf.buf_w[15] = low;
+	/* Keep the buffer in the byte order, so the last block can take the
+	 * accelerated path as well */
+	ctx->buf.buf_w[14] = PUINT32_TO_BE (high);
+	ctx->buf.buf_w[15] = PUINT32_TO_BE (low);
 
-	pp_crypto_hash_sha2_256_swap_bytes (ctx->buf.buf_w, 14);
-	pp_crypto_hash_sha2_256_process (ctx, ctx->buf.buf_w);
+	pp_crypto_hash_sha2_256_process_blocks (ctx, ctx->buf.buf, 1);
 
 	pp_crypto_hash_sha2_256_swap_bytes (ctx->hash, ctx->is224 == FALSE ? 8 : 7);
 }
@@ -279,6 +520,13 @@ p_crypto_hash_sha2_256_digest (PHashSHA2_256 *ctx)
 	return (const puchar *) ctx->hash;
 }
 
+void
+p_crypto_hash_sha2_256_copy (PHashSHA2_256		*dst,
+			     const PHashSHA2_256	*src)
+{
+	memcpy (dst, src, sizeof (PHashSHA2_256));
+}
+
 void
 p_crypto_hash_sha2_256_free (PHashSHA2_256 *ctx)
 {
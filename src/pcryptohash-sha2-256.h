@@ -40,19 +40,23 @@ P_BEGIN_DECLS
 typedef struct PHashSHA2_256_ PHashSHA2_256;
 
 PHashSHA2_256 *	p_crypto_hash_sha2_256_new	(void);
+PHashSHA2_256 *	p_crypto_hash_sha2_256_init	(ppointer mem, psize size);
 void		p_crypto_hash_sha2_256_update	(PHashSHA2_256 *ctx, const puchar *data, psize len);
 void		p_crypto_hash_sha2_256_finish	(PHashSHA2_256 *ctx);
 const puchar *	p_crypto_hash_sha2_256_digest	(PHashSHA2_256 *ctx);
 void		p_crypto_hash_sha2_256_reset	(PHashSHA2_256 *ctx);
 void		p_crypto_hash_sha2_256_free	(PHashSHA2_256 *ctx);
+void		p_crypto_hash_sha2_256_copy	(PHashSHA2_256 *dst, const PHashSHA2_256 *src);
 
 PHashSHA2_256 *	p_crypto_hash_sha2_224_new	(void);
+PHashSHA2_256 *	p_crypto_hash_sha2_224_init	(ppointer mem, psize size);
 
 #define p_crypto_hash_sha2_224_update p_crypto_hash_sha2_256_update
 #define p_crypto_hash_sha2_224_finish p_crypto_hash_sha2_256_finish
 #define p_crypto_hash_sha2_224_digest p_crypto_hash_sha2_256_digest
 #define p_crypto_hash_sha2_224_reset  p_crypto_hash_sha2_256_reset
 #define p_crypto_hash_sha2_224_free   p_crypto_hash_sha2_256_free
+#define p_crypto_hash_sha2_224_copy   p_crypto_hash_sha2_256_copy
 
 P_END_DECLS
 
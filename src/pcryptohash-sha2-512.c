@@ -98,7 +98,7 @@ static const puint64 pp_crypto_hash_sha2_512_K[] = {
 
 static void pp_crypto_hash_sha2_512_swap_bytes (puint64 *data, puint words);
 static void pp_crypto_hash_sha2_512_process (PHashSHA2_512 *ctx, const puint64 data[16]);
-static PHashSHA2_512 * pp_crypto_hash_sha2_512_new_internal (pboolean is384);
+static PHashSHA2_512 * pp_crypto_hash_sha2_512_init_internal (ppointer mem, psize size, pboolean is384);
 
 #define P_SHA2_512_SHR(val, shift) ((val) >> (shift))
 #define P_SHA2_512_ROTR(val, shift) (P_SHA2_512_SHR(val, shift) | ((val) << (64 - (shift))))
@@ -167,13 +167,18 @@ pp_crypto_hash_sha2_512_process (PHashSHA2_512	*ctx,
 }
 
 static PHashSHA2_512 *
-pp_crypto_hash_sha2_512_new_internal (pboolean is384)
+pp_crypto_hash_sha2_512_init_internal (ppointer	mem,
+				       psize	size,
+				       pboolean	is384)
 {
 	PHashSHA2_512 *ret;
 
-	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PHashSHA2_512))) == NULL))
+	if (P_UNLIKELY (mem == NULL || size < sizeof (PHashSHA2_512)))
 		return NULL;
 
+	ret = (PHashSHA2_512 *) mem;
+	memset (ret, 0, sizeof (PHashSHA2_512));
+
 	ret->is384 = is384;
 
 	p_crypto_hash_sha2_512_reset (ret);
@@ -212,16 +217,40 @@ p_crypto_hash_sha2_512_reset (PHashSHA2_512 *ctx)
 	}
 }
 
+PHashSHA2_512 *
+p_crypto_hash_sha2_512_init (ppointer	mem,
+			     psize	size)
+{
+	return pp_crypto_hash_sha2_512_init_internal (mem, size, FALSE);
+}
+
+PHashSHA2_512 *
+p_crypto_hash_sha2_384_init (ppointer	mem,
+			     psize	size)
+{
+	return pp_crypto_hash_sha2_512_init_internal (mem, size, TRUE);
+}
+
 PHashSHA2_512 *
 p_crypto_hash_sha2_512_new (void)
 {
-	return pp_crypto_hash_sha2_512_new_internal (FALSE);
+	PHashSHA2_512 *ret;
+
+	if (P_UNLIKELY ((ret = p_malloc (sizeof (PHashSHA2_512))) == NULL))
+		return NULL;
+
+	return p_crypto_hash_sha2_512_init (ret, sizeof (PHashSHA2_512));
 }
 
 PHashSHA2_512 *
 p_crypto_hash_sha2_384_new (void)
 {
-	return pp_crypto_hash_sha2_512_new_internal (TRUE);
+	PHashSHA2_512 *ret;
+
+	if (P_UNLIKELY ((ret = p_malloc (sizeof (PHashSHA2_512))) == NULL))
+		return NULL;
+
+	return p_crypto_hash_sha2_384_init (ret, sizeof (PHashSHA2_512));
 }
 
 void
@@ -293,6 +322,13 @@ p_crypto_hash_sha2_512_digest (PHashSHA2_512 *ctx)
 	return (const puchar *) ctx->hash;
 }
 
+void
+p_crypto_hash_sha2_512_copy (PHashSHA2_512		*dst,
+			     const PHashSHA2_512	*src)
+{
+	memcpy (dst, src, sizeof (PHashSHA2_512));
+}
+
 void
 p_crypto_hash_sha2_512_free (PHashSHA2_512 *ctx)
 {
@@ -40,19 +40,23 @@ P_BEGIN_DECLS
 typedef struct PHashSHA2_512_ PHashSHA2_512;
 
 PHashSHA2_512 *	p_crypto_hash_sha2_512_new	(void);
+PHashSHA2_512 *	p_crypto_hash_sha2_512_init	(ppointer mem, psize size);
 void		p_crypto_hash_sha2_512_update	(PHashSHA2_512 *ctx, const puchar *data, psize len);
 void		p_crypto_hash_sha2_512_finish	(PHashSHA2_512 *ctx);
 const puchar *	p_crypto_hash_sha2_512_digest	(PHashSHA2_512 *ctx);
 void		p_crypto_hash_sha2_512_reset	(PHashSHA2_512 *ctx);
 void		p_crypto_hash_sha2_512_free	(PHashSHA2_512 *ctx);
+void		p_crypto_hash_sha2_512_copy	(PHashSHA2_512 *dst, const PHashSHA2_512 *src);
 
 PHashSHA2_512 *	p_crypto_hash_sha2_384_new	(void);
+PHashSHA2_512 *	p_crypto_hash_sha2_384_init	(ppointer mem, psize size);
 
 #define p_crypto_hash_sha2_384_update p_crypto_hash_sha2_512_update
 #define p_crypto_hash_sha2_384_finish p_crypto_hash_sha2_512_finish
 #define p_crypto_hash_sha2_384_digest p_crypto_hash_sha2_512_digest
 #define p_crypto_hash_sha2_384_reset  p_crypto_hash_sha2_512_reset
 #define p_crypto_hash_sha2_384_free   p_crypto_hash_sha2_512_free
+#define p_crypto_hash_sha2_384_copy   p_crypto_hash_sha2_512_copy
 
 P_END_DECLS
 
@@ -27,8 +27,13 @@
 #include <stdlib.h>
 
 #include "pmem.h"
+#include "pcpufeatures-private.h"
 #include "pcryptohash-sha3.h"
 
+#if defined (P_CPU_ARM_SHA3)
+#  include <arm_neon.h>
+#endif
+
 struct PHashSHA3_ {
 	union buf_ {
 		puchar	buf[200];
@@ -38,6 +43,8 @@ struct PHashSHA3_ {
 
 	puint32		len;
 	puint32		block_size;
+
+	pboolean	accel;
 };
 
 static const puint64 pp_crypto_hash_sha3_K[] = {
@@ -56,16 +63,167 @@ static const puint64 pp_crypto_hash_sha3_K[] = {
 };
 
 static void pp_crypto_hash_sha3_swap_bytes (puint64 *data, puint words);
-static void pp_crypto_hash_sha3_keccak_theta (PHashSHA3 *ctx);
-static void pp_crypto_hash_sha3_keccak_rho_pi (PHashSHA3 *ctx);
-static void pp_crypto_hash_sha3_keccak_chi (PHashSHA3 *ctx);
-static void pp_crypto_hash_sha3_keccak_permutate (PHashSHA3 *ctx);
+static void pp_crypto_hash_sha3_keccak_permutate (puint64 *state);
+#if defined (P_CPU_X86_BMI)
+static void pp_crypto_hash_sha3_keccak_permutate_bmi (puint64 *state);
+#elif defined (P_CPU_ARM_SHA3)
+static void pp_crypto_hash_sha3_keccak_permutate_arm (puint64 *state);
+#endif
 static void pp_crypto_hash_sha3_process (PHashSHA3 *ctx, const puint64 *data);
-static PHashSHA3 * pp_crypto_hash_sha3_new_internal (puint bits);
+static PHashSHA3 * pp_crypto_hash_sha3_init_internal (ppointer mem, psize size, puint bits);
 
 #define P_SHA3_SHL(val, shift) ((val) << (shift))
 #define P_SHA3_ROTL(val, shift) (P_SHA3_SHL(val, shift) | ((val) >> (64 - (shift))))
 
+/* The permutation keeps the state in 25 named lanes: the row is one of b, g,
+ * k, m, s (y = 0..4) and the column is one of a, e, i, o, u (x = 0..4). Each
+ * round goes from the A lanes to the E lanes or back, so all the steps are
+ * fused and the state stays in registers (see [Keccak implementation
+ * overview]). */
+
+#define P_SHA3_DECLARE_LANES(A)								\
+	puint64	A##ba, A##be, A##bi, A##bo, A##bu;					\
+	puint64	A##ga, A##ge, A##gi, A##go, A##gu;					\
+	puint64	A##ka, A##ke, A##ki, A##ko, A##ku;					\
+	puint64	A##ma, A##me, A##mi, A##mo, A##mu;					\
+	puint64	A##sa, A##se, A##si, A##so, A##su;
+
+#define P_SHA3_LOAD_LANES(A, state)							\
+	A##ba = state[0];  A##be = state[1];  A##bi = state[2];				\
+	A##bo = state[3];  A##bu = state[4];  A##ga = state[5];				\
+	A##ge = state[6];  A##gi = state[7];  A##go = state[8];				\
+	A##gu = state[9];  A##ka = state[10]; A##ke = state[11];			\
+	A##ki = state[12]; A##ko = state[13]; A##ku = state[14];			\
+	A##ma = state[15]; A##me = state[16]; A##mi = state[17];			\
+	A##mo = state[18]; A##mu = state[19]; A##sa = state[20];			\
+	A##se = state[21]; A##si = state[22]; A##so = state[23];			\
+	A##su = state[24];
+
+#define P_SHA3_STORE_LANES(A, state)							\
+	state[0]  = A##ba; state[1]  = A##be; state[2]  = A##bi;			\
+	state[3]  = A##bo; state[4]  = A##bu; state[5]  = A##ga;			\
+	state[6]  = A##ge; state[7]  = A##gi; state[8]  = A##go;			\
+	state[9]  = A##gu; state[10] = A##ka; state[11] = A##ke;			\
+	state[12] = A##ki; state[13] = A##ko; state[14] = A##ku;			\
+	state[15] = A##ma; state[16] = A##me; state[17] = A##mi;			\
+	state[18] = A##mo; state[19] = A##mu; state[20] = A##sa;			\
+	state[21] = A##se; state[22] = A##si; state[23] = A##so;			\
+	state[24] = A##su;
+
+/* Theta step (see [Keccak Reference, Section 2.3.2]) */
+#define P_SHA3_THETA(A)									\
+	Ca = A##ba ^ A##ga ^ A##ka ^ A##ma ^ A##sa;					\
+	Ce = A##be ^ A##ge ^ A##ke ^ A##me ^ A##se;					\
+	Ci = A##bi ^ A##gi ^ A##ki ^ A##mi ^ A##si;					\
+	Co = A##bo ^ A##go ^ A##ko ^ A##mo ^ A##so;					\
+	Cu = A##bu ^ A##gu ^ A##ku ^ A##mu ^ A##su;					\
+											\
+	Da = Cu ^ P_SHA3_ROTL (Ce, 1);							\
+	De = Ca ^ P_SHA3_ROTL (Ci, 1);							\
+	Di = Ce ^ P_SHA3_ROTL (Co, 1);							\
+	Do = Ci ^ P_SHA3_ROTL (Cu, 1);							\
+	Du = Co ^ P_SHA3_ROTL (Ca, 1);
+
+/* Rho and pi steps (see [Keccak Reference, Sections 2.3.3 and 2.3.4]) for
+ * the lanes which become the given row after pi */
+#define P_SHA3_RHO_PI_B(A)								\
+	Ba = A##ba ^ Da;								\
+	Be = P_SHA3_ROTL (A##ge ^ De, 44);						\
+	Bi = P_SHA3_ROTL (A##ki ^ Di, 43);						\
+	Bo = P_SHA3_ROTL (A##mo ^ Do, 21);						\
+	Bu = P_SHA3_ROTL (A##su ^ Du, 14);
+
+#define P_SHA3_RHO_PI_G(A)								\
+	Ba = P_SHA3_ROTL (A##bo ^ Do, 28);						\
+	Be = P_SHA3_ROTL (A##gu ^ Du, 20);						\
+	Bi = P_SHA3_ROTL (A##ka ^ Da, 3);						\
+	Bo = P_SHA3_ROTL (A##me ^ De, 45);						\
+	Bu = P_SHA3_ROTL (A##si ^ Di, 61);
+
+#define P_SHA3_RHO_PI_K(A)								\
+	Ba = P_SHA3_ROTL (A##be ^ De, 1);						\
+	Be = P_SHA3_ROTL (A##gi ^ Di, 6);						\
+	Bi = P_SHA3_ROTL (A##ko ^ Do, 25);						\
+	Bo = P_SHA3_ROTL (A##mu ^ Du, 8);						\
+	Bu = P_SHA3_ROTL (A##sa ^ Da, 18);
+
+#define P_SHA3_RHO_PI_M(A)								\
+	Ba = P_SHA3_ROTL (A##bu ^ Du, 27);						\
+	Be = P_SHA3_ROTL (A##ga ^ Da, 36);						\
+	Bi = P_SHA3_ROTL (A##ke ^ De, 10);						\
+	Bo = P_SHA3_ROTL (A##mi ^ Di, 15);						\
+	Bu = P_SHA3_ROTL (A##so ^ Do, 56);
+
+#define P_SHA3_RHO_PI_S(A)								\
+	Ba = P_SHA3_ROTL (A##bi ^ Di, 62);						\
+	Be = P_SHA3_ROTL (A##go ^ Do, 55);						\
+	Bi = P_SHA3_ROTL (A##ku ^ Du, 39);						\
+	Bo = P_SHA3_ROTL (A##ma ^ Da, 41);						\
+	Bu = P_SHA3_ROTL (A##se ^ De, 2);
+
+/* Chi step (see [Keccak Reference, Section 2.3.1]) for a single row */
+#define P_SHA3_CHI(E, row)								\
+	E##row##a = Ba ^ (~Be & Bi);							\
+	E##row##e = Be ^ (~Bi & Bo);							\
+	E##row##i = Bi ^ (~Bo & Bu);							\
+	E##row##o = Bo ^ (~Bu & Ba);							\
+	E##row##u = Bu ^ (~Ba & Be);
+
+/* Full round with the iota step (see [Keccak Reference, Section 2.3.5]) */
+#define P_SHA3_ROUND(A, E, rc)								\
+	P_SHA3_THETA (A)								\
+	P_SHA3_RHO_PI_B (A) P_SHA3_CHI (E, b) E##ba ^= (rc);				\
+	P_SHA3_RHO_PI_G (A) P_SHA3_CHI (E, g)						\
+	P_SHA3_RHO_PI_K (A) P_SHA3_CHI (E, k)						\
+	P_SHA3_RHO_PI_M (A) P_SHA3_CHI (E, m)						\
+	P_SHA3_RHO_PI_S (A) P_SHA3_CHI (E, s)
+
+/* Lane complementing transform (see [Keccak implementation overview]): the be,
+ * bi, go, ki, mi and sa lanes are kept inverted during the permutation, so chi
+ * needs a single NOT per row at most. Useful unless the CPU has an AND-NOT
+ * instruction. */
+#define P_SHA3_COMPLEMENT_LANES(A)							\
+	A##be = ~A##be; A##bi = ~A##bi; A##go = ~A##go;					\
+	A##ki = ~A##ki; A##mi = ~A##mi; A##sa = ~A##sa;
+
+#define P_SHA3_ROUND_COMPLEMENTED(A, E, rc)						\
+	P_SHA3_THETA (A)								\
+											\
+	P_SHA3_RHO_PI_B (A)								\
+	E##ba = Ba ^ (Be | Bi) ^ (rc);							\
+	E##be = Be ^ (~Bi | Bo);							\
+	E##bi = Bi ^ (Bo & Bu);								\
+	E##bo = Bo ^ (Bu | Ba);								\
+	E##bu = Bu ^ (Ba & Be);								\
+											\
+	P_SHA3_RHO_PI_G (A)								\
+	E##ga = Ba ^ (Be | Bi);								\
+	E##ge = Be ^ (Bi & Bo);								\
+	E##gi = Bi ^ (Bo | ~Bu);							\
+	E##go = Bo ^ (Bu | Ba);								\
+	E##gu = Bu ^ (Ba & Be);								\
+											\
+	P_SHA3_RHO_PI_K (A)								\
+	E##ka = Ba ^ (Be | Bi);								\
+	E##ke = Be ^ (Bi & Bo);								\
+	E##ki = Bi ^ (~Bo & Bu);							\
+	E##ko = ~Bo ^ (Bu | Ba);							\
+	E##ku = Bu ^ (Ba & Be);								\
+											\
+	P_SHA3_RHO_PI_M (A)								\
+	E##ma = Ba ^ (Be & Bi);								\
+	E##me = Be ^ (Bi | Bo);								\
+	E##mi = Bi ^ (~Bo | Bu);							\
+	E##mo = ~Bo ^ (Bu & Ba);							\
+	E##mu = Bu ^ (Ba | Be);								\
+											\
+	P_SHA3_RHO_PI_S (A)								\
+	E##sa = Ba ^ (~Be & Bi);							\
+	E##se = ~Be ^ (Bi | Bo);							\
+	E##si = Bi ^ (Bo & Bu);								\
+	E##so = Bo ^ (Bu | Ba);								\
+	E##su = Bu ^ (Ba & Be);
+
 static void
 pp_crypto_hash_sha3_swap_bytes (puint64	*data,
 				puint	words)
@@ -81,101 +239,123 @@ pp_crypto_hash_sha3_swap_bytes (puint64	*data,
 #endif
 }
 
-/* Theta step (see [Keccak Reference, Section 2.3.2]) */
 static void
-pp_crypto_hash_sha3_keccak_theta (PHashSHA3 *ctx)
+pp_crypto_hash_sha3_keccak_permutate (puint64 *state)
 {
+	P_SHA3_DECLARE_LANES (A)
+	P_SHA3_DECLARE_LANES (E)
+	puint64	Ba, Be, Bi, Bo, Bu;
+	puint64	Ca, Ce, Ci, Co, Cu;
+	puint64	Da, De, Di, Do, Du;
 	puint	i;
-	puint64	C[5], D[5];
-
-	/* Compute the parity of the columns */
-	for (i = 0; i < 5; ++i)
-		C[i] = ctx->hash[i] ^ ctx->hash[i + 5] ^ ctx->hash[i + 10] ^ ctx->hash[i + 15] ^ ctx->hash[i + 20];
-
-	/* Compute the theta effect for a given column */
-	D[0] = P_SHA3_ROTL (C[1], 1) ^ C[4];
-	D[1] = P_SHA3_ROTL (C[2], 1) ^ C[0];
-	D[2] = P_SHA3_ROTL (C[3], 1) ^ C[1];
-	D[3] = P_SHA3_ROTL (C[4], 1) ^ C[2];
-	D[4] = P_SHA3_ROTL (C[0], 1) ^ C[3];
-
-	/* Add the theta effect to the whole column */
-	for (i = 0; i < 5; ++i) {
-		ctx->hash[i]      ^= D[i];
-		ctx->hash[i + 5]  ^= D[i];
-		ctx->hash[i + 10] ^= D[i];
-		ctx->hash[i + 15] ^= D[i];
-		ctx->hash[i + 20] ^= D[i];
+
+	P_SHA3_LOAD_LANES (A, state)
+	P_SHA3_COMPLEMENT_LANES (A)
+
+	for (i = 0; i < 24; i += 2) {
+		P_SHA3_ROUND_COMPLEMENTED (A, E, pp_crypto_hash_sha3_K[i])
+		P_SHA3_ROUND_COMPLEMENTED (E, A, pp_crypto_hash_sha3_K[i + 1])
 	}
-}
 
-/* Rho and pi steps (see [Keccak Reference, Sections 2.3.3 and 2.3.4]) */
-static void
-pp_crypto_hash_sha3_keccak_rho_pi (PHashSHA3 *ctx)
-{
-	puint64 tmp_A;
-
-	/* Unroll the loop over ((0 1)(2 3))^t * (1 0) for 0 ≤ t ≤ 23 */
-	tmp_A = ctx->hash[1];
-	ctx->hash[1]  = P_SHA3_ROTL (ctx->hash[6],  44);
-	ctx->hash[6]  = P_SHA3_ROTL (ctx->hash[9],  20);
-	ctx->hash[9]  = P_SHA3_ROTL (ctx->hash[22], 61);
-	ctx->hash[22] = P_SHA3_ROTL (ctx->hash[14], 39);
-	ctx->hash[14] = P_SHA3_ROTL (ctx->hash[20], 18);
-	ctx->hash[20] = P_SHA3_ROTL (ctx->hash[2],  62);
-	ctx->hash[2]  = P_SHA3_ROTL (ctx->hash[12], 43);
-	ctx->hash[12] = P_SHA3_ROTL (ctx->hash[13], 25);
-	ctx->hash[13] = P_SHA3_ROTL (ctx->hash[19],  8);
-	ctx->hash[19] = P_SHA3_ROTL (ctx->hash[23], 56);
-	ctx->hash[23] = P_SHA3_ROTL (ctx->hash[15], 41);
-	ctx->hash[15] = P_SHA3_ROTL (ctx->hash[4],  27);
-	ctx->hash[4]  = P_SHA3_ROTL (ctx->hash[24], 14);
-	ctx->hash[24] = P_SHA3_ROTL (ctx->hash[21],  2);
-	ctx->hash[21] = P_SHA3_ROTL (ctx->hash[8],  55);
-	ctx->hash[8]  = P_SHA3_ROTL (ctx->hash[16], 45);
-	ctx->hash[16] = P_SHA3_ROTL (ctx->hash[5],  36);
-	ctx->hash[5]  = P_SHA3_ROTL (ctx->hash[3],  28);
-	ctx->hash[3]  = P_SHA3_ROTL (ctx->hash[18], 21);
-	ctx->hash[18] = P_SHA3_ROTL (ctx->hash[17], 15);
-	ctx->hash[17] = P_SHA3_ROTL (ctx->hash[11], 10);
-	ctx->hash[11] = P_SHA3_ROTL (ctx->hash[7],   6);
-	ctx->hash[7]  = P_SHA3_ROTL (ctx->hash[10],  3);
-	ctx->hash[10] = P_SHA3_ROTL (tmp_A, 1);
+	P_SHA3_COMPLEMENT_LANES (A)
+	P_SHA3_STORE_LANES (A, state)
 }
 
-/* Chi step (see [Keccak Reference, Section 2.3.1]) */
-static void
-pp_crypto_hash_sha3_keccak_chi (PHashSHA3 *ctx)
+#if defined (P_CPU_X86_BMI)
+/* With andn the plain chi is a single instruction per lane, rorx saves
+ * the moves around the rotations */
+P_CPU_X86_BMI_TARGET static void
+pp_crypto_hash_sha3_keccak_permutate_bmi (puint64 *state)
 {
-	puint i;
-	puint64	tmp_A1, tmp_A2;
+	P_SHA3_DECLARE_LANES (A)
+	P_SHA3_DECLARE_LANES (E)
+	puint64	Ba, Be, Bi, Bo, Bu;
+	puint64	Ca, Ce, Ci, Co, Cu;
+	puint64	Da, De, Di, Do, Du;
+	puint	i;
 
-	for (i = 0; i < 25; i += 5) {
-		tmp_A1 = ctx->hash[i + 0];
-		tmp_A2 = ctx->hash[i + 1];
+	P_SHA3_LOAD_LANES (A, state)
 
-		ctx->hash[i + 0] ^= ~tmp_A2 & ctx->hash[i + 2];
-		ctx->hash[i + 1] ^= ~ctx->hash[i + 2] & ctx->hash[i + 3];
-		ctx->hash[i + 2] ^= ~ctx->hash[i + 3] & ctx->hash[i + 4];
-		ctx->hash[i + 3] ^= ~ctx->hash[i + 4] & tmp_A1;
-		ctx->hash[i + 4] ^= ~tmp_A1 & tmp_A2;
+	for (i = 0; i < 24; i += 2) {
+		P_SHA3_ROUND (A, E, pp_crypto_hash_sha3_K[i])
+		P_SHA3_ROUND (E, A, pp_crypto_hash_sha3_K[i + 1])
 	}
+
+	P_SHA3_STORE_LANES (A, state)
 }
+#elif defined (P_CPU_ARM_SHA3)
+/* Every lane lives in the lower half of a vector register: EOR3 computes the
+ * column parity, RAX1 the theta effect, XAR is theta plus rho and BCAX is
+ * the whole chi step for a lane */
+#  define P_SHA3_ARM_XAR(i, rot) vxarq_u64 (A[i], D[(i) % 5], 64 - (rot))
+#  define P_SHA3_ARM_CHI(row)								\
+	A[row * 5 + 0] = vbcaxq_u64 (B[row * 5 + 0], B[row * 5 + 2], B[row * 5 + 1]);	\
+	A[row * 5 + 1] = vbcaxq_u64 (B[row * 5 + 1], B[row * 5 + 3], B[row * 5 + 2]);	\
+	A[row * 5 + 2] = vbcaxq_u64 (B[row * 5 + 2], B[row * 5 + 4], B[row * 5 + 3]);	\
+	A[row * 5 + 3] = vbcaxq_u64 (B[row * 5 + 3], B[row * 5 + 0], B[row * 5 + 4]);	\
+	A[row * 5 + 4] = vbcaxq_u64 (B[row * 5 + 4], B[row * 5 + 1], B[row * 5 + 0]);
 
 static void
-pp_crypto_hash_sha3_keccak_permutate (PHashSHA3 *ctx)
+pp_crypto_hash_sha3_keccak_permutate_arm (puint64 *state)
 {
-	puint i;
+	uint64x2_t	A[25], B[25], C[5], D[5];
+	puint		i;
 
-	for (i = 0; i < 24; ++i) {
-		pp_crypto_hash_sha3_keccak_theta (ctx);
-		pp_crypto_hash_sha3_keccak_rho_pi (ctx);
-		pp_crypto_hash_sha3_keccak_chi (ctx);
+	for (i = 0; i < 25; ++i)
+		A[i] = vld1q_dup_u64 ((const uint64_t *) state + i);
 
-		/* Iota step (see [Keccak Reference, Section 2.3.5]) */
-		ctx->hash[0] ^= pp_crypto_hash_sha3_K[i];
+	for (i = 0; i < 24; ++i) {
+		C[0] = veor3q_u64 (veor3q_u64 (A[0], A[5], A[10]), A[15], A[20]);
+		C[1] = veor3q_u64 (veor3q_u64 (A[1], A[6], A[11]), A[16], A[21]);
+		C[2] = veor3q_u64 (veor3q_u64 (A[2], A[7], A[12]), A[17], A[22]);
+		C[3] = veor3q_u64 (veor3q_u64 (A[3], A[8], A[13]), A[18], A[23]);
+		C[4] = veor3q_u64 (veor3q_u64 (A[4], A[9], A[14]), A[19], A[24]);
+
+		D[0] = vrax1q_u64 (C[4], C[1]);
+		D[1] = vrax1q_u64 (C[0], C[2]);
+		D[2] = vrax1q_u64 (C[1], C[3]);
+		D[3] = vrax1q_u64 (C[2], C[4]);
+		D[4] = vrax1q_u64 (C[3], C[0]);
+
+		B[0]  = veorq_u64 (A[0], D[0]);
+		B[1]  = P_SHA3_ARM_XAR (6,  44);
+		B[2]  = P_SHA3_ARM_XAR (12, 43);
+		B[3]  = P_SHA3_ARM_XAR (18, 21);
+		B[4]  = P_SHA3_ARM_XAR (24, 14);
+		B[5]  = P_SHA3_ARM_XAR (3,  28);
+		B[6]  = P_SHA3_ARM_XAR (9,  20);
+		B[7]  = P_SHA3_ARM_XAR (10,  3);
+		B[8]  = P_SHA3_ARM_XAR (16, 45);
+		B[9]  = P_SHA3_ARM_XAR (22, 61);
+		B[10] = P_SHA3_ARM_XAR (1,   1);
+		B[11] = P_SHA3_ARM_XAR (7,   6);
+		B[12] = P_SHA3_ARM_XAR (13, 25);
+		B[13] = P_SHA3_ARM_XAR (19,  8);
+		B[14] = P_SHA3_ARM_XAR (20, 18);
+		B[15] = P_SHA3_ARM_XAR (4,  27);
+		B[16] = P_SHA3_ARM_XAR (5,  36);
+		B[17] = P_SHA3_ARM_XAR (11, 10);
+		B[18] = P_SHA3_ARM_XAR (17, 15);
+		B[19] = P_SHA3_ARM_XAR (23, 56);
+		B[20] = P_SHA3_ARM_XAR (2,  62);
+		B[21] = P_SHA3_ARM_XAR (8,  55);
+		B[22] = P_SHA3_ARM_XAR (14, 39);
+		B[23] = P_SHA3_ARM_XAR (15, 41);
+		B[24] = P_SHA3_ARM_XAR (21,  2);
+
+		P_SHA3_ARM_CHI (0)
+		P_SHA3_ARM_CHI (1)
+		P_SHA3_ARM_CHI (2)
+		P_SHA3_ARM_CHI (3)
+		P_SHA3_ARM_CHI (4)
+
+		A[0] = veorq_u64 (A[0], vdupq_n_u64 (pp_crypto_hash_sha3_K[i]));
 	}
+
+	for (i = 0; i < 25; ++i)
+		vst1q_lane_u64 ((uint64_t *) state + i, A[i], 0);
 }
+#endif
 
 static void
 pp_crypto_hash_sha3_process (PHashSHA3		*ctx,
@@ -188,18 +368,34 @@ pp_crypto_hash_sha3_process (PHashSHA3		*ctx,
 		ctx->hash[i] ^= data[i];
 
 	/* Make the Keccak permutation */
-	pp_crypto_hash_sha3_keccak_permutate (ctx);
+#if defined (P_CPU_X86_BMI)
+	if (ctx->accel == TRUE) {
+		pp_crypto_hash_sha3_keccak_permutate_bmi (ctx->hash);
+		return;
+	}
+#elif defined (P_CPU_ARM_SHA3)
+	pp_crypto_hash_sha3_keccak_permutate_arm (ctx->hash);
+	return;
+#endif
+
+	pp_crypto_hash_sha3_keccak_permutate (ctx->hash);
 }
 
 static PHashSHA3 *
-pp_crypto_hash_sha3_new_internal (puint bits)
+pp_crypto_hash_sha3_init_internal (ppointer	mem,
+				   psize	size,
+				   puint	bits)
 {
 	PHashSHA3 *ret;
 
-	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PHashSHA3))) == NULL))
+	if (P_UNLIKELY (mem == NULL || size < sizeof (PHashSHA3)))
 		return NULL;
 
+	ret = (PHashSHA3 *) mem;
+	memset (ret, 0, sizeof (PHashSHA3));
+
 	ret->block_size = (1600 - bits * 2) / 8;
+	ret->accel      = p_cpu_has_feature_internal (P_CPU_FEATURE_BMI);
 
 	return ret;
 }
@@ -213,28 +409,76 @@ p_crypto_hash_sha3_reset (PHashSHA3 *ctx)
 	ctx->len = 0;
 }
 
+PHashSHA3 *
+p_crypto_hash_sha3_224_init (ppointer	mem,
+			     psize	size)
+{
+	return pp_crypto_hash_sha3_init_internal (mem, size, 224);
+}
+
+PHashSHA3 *
+p_crypto_hash_sha3_256_init (ppointer	mem,
+			     psize	size)
+{
+	return pp_crypto_hash_sha3_init_internal (mem, size, 256);
+}
+
+PHashSHA3 *
+p_crypto_hash_sha3_384_init (ppointer	mem,
+			     psize	size)
+{
+	return pp_crypto_hash_sha3_init_internal (mem, size, 384);
+}
+
+PHashSHA3 *
+p_crypto_hash_sha3_512_init (ppointer	mem,
+			     psize	size)
+{
+	return pp_crypto_hash_sha3_init_internal (mem, size, 512);
+}
+
 PHashSHA3 *
 p_crypto_hash_sha3_224_new (void)
 {
-	return pp_crypto_hash_sha3_new_internal (224);
+	PHashSHA3 *ret;
+
+	if (P_UNLIKELY ((ret = p_malloc (sizeof (PHashSHA3))) == NULL))
+		return NULL;
+
+	return p_crypto_hash_sha3_224_init (ret, sizeof (PHashSHA3));
 }
 
 PHashSHA3 *
 p_crypto_hash_sha3_256_new (void)
 {
-	return pp_crypto_hash_sha3_new_internal (256);
+	PHashSHA3 *ret;
+
+	if (P_UNLIKELY ((ret = p_malloc (sizeof (PHashSHA3))) == NULL))
+		return NULL;
+
+	return p_crypto_hash_sha3_256_init (ret, sizeof (PHashSHA3));
 }
 
 PHashSHA3 *
 p_crypto_hash_sha3_384_new (void)
 {
-	return pp_crypto_hash_sha3_new_internal (384);
+	PHashSHA3 *ret;
+
+	if (P_UNLIKELY ((ret = p_malloc (sizeof (PHashSHA3))) == NULL))
+		return NULL;
+
+	return p_crypto_hash_sha3_384_init (ret, sizeof (PHashSHA3));
 }
 
 PHashSHA3 *
 p_crypto_hash_sha3_512_new (void)
 {
-	return pp_crypto_hash_sha3_new_internal (512);
+	PHashSHA3 *ret;
+
+	if (P_UNLIKELY ((ret = p_malloc (sizeof (PHashSHA3))) == NULL))
+		return NULL;
+
+	return p_crypto_hash_sha3_512_init (ret, sizeof (PHashSHA3));
 }
 
 void
@@ -290,6 +534,13 @@ p_crypto_hash_sha3_digest (PHashSHA3 *ctx)
 	return (const puchar *) ctx->hash;
 }
 
+void
+p_crypto_hash_sha3_copy (PHashSHA3		*dst,
+			 const PHashSHA3	*src)
+{
+	memcpy (dst, src, sizeof (PHashSHA3));
+}
+
 void
 p_crypto_hash_sha3_free (PHashSHA3 *ctx)
 {
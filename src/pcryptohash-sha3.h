@@ -44,35 +44,45 @@ void		p_crypto_hash_sha3_finish	(PHashSHA3 *ctx);
 const puchar *	p_crypto_hash_sha3_digest	(PHashSHA3 *ctx);
 void		p_crypto_hash_sha3_reset	(PHashSHA3 *ctx);
 void		p_crypto_hash_sha3_free		(PHashSHA3 *ctx);
+void		p_crypto_hash_sha3_copy		(PHashSHA3 *dst, const PHashSHA3 *src);
 
 PHashSHA3 *	p_crypto_hash_sha3_224_new	(void);
 PHashSHA3 *	p_crypto_hash_sha3_256_new	(void);
 PHashSHA3 *	p_crypto_hash_sha3_384_new	(void);
 PHashSHA3 *	p_crypto_hash_sha3_512_new	(void);
 
+PHashSHA3 *	p_crypto_hash_sha3_224_init	(ppointer mem, psize size);
+PHashSHA3 *	p_crypto_hash_sha3_256_init	(ppointer mem, psize size);
+PHashSHA3 *	p_crypto_hash_sha3_384_init	(ppointer mem, psize size);
+PHashSHA3 *	p_crypto_hash_sha3_512_init	(ppointer mem, psize size);
+
 #define p_crypto_hash_sha3_224_update p_crypto_hash_sha3_update
 #define p_crypto_hash_sha3_224_finish p_crypto_hash_sha3_finish
 #define p_crypto_hash_sha3_224_digest p_crypto_hash_sha3_digest
 #define p_crypto_hash_sha3_224_reset  p_crypto_hash_sha3_reset
 #define p_crypto_hash_sha3_224_free   p_crypto_hash_sha3_free
+#define p_crypto_hash_sha3_224_copy   p_crypto_hash_sha3_copy
 
 #define p_crypto_hash_sha3_256_update p_crypto_hash_sha3_update
 #define p_crypto_hash_sha3_256_finish p_crypto_hash_sha3_finish
 #define p_crypto_hash_sha3_256_digest p_crypto_hash_sha3_digest
 #define p_crypto_hash_sha3_256_reset  p_crypto_hash_sha3_reset
 #define p_crypto_hash_sha3_256_free   p_crypto_hash_sha3_free
+#define p_crypto_hash_sha3_256_copy   p_crypto_hash_sha3_copy
 
 #define p_crypto_hash_sha3_384_update p_crypto_hash_sha3_update
 #define p_crypto_hash_sha3_384_finish p_crypto_hash_sha3_finish
 #define p_crypto_hash_sha3_384_digest p_crypto_hash_sha3_digest
 #define p_crypto_hash_sha3_384_reset  p_crypto_hash_sha3_reset
 #define p_crypto_hash_sha3_384_free   p_crypto_hash_sha3_free
+#define p_crypto_hash_sha3_384_copy   p_crypto_hash_sha3_copy
 
 #define p_crypto_hash_sha3_512_update p_crypto_hash_sha3_update
 #define p_crypto_hash_sha3_512_finish p_crypto_hash_sha3_finish
 #define p_crypto_hash_sha3_512_digest p_crypto_hash_sha3_digest
 #define p_crypto_hash_sha3_512_reset  p_crypto_hash_sha3_reset
 #define p_crypto_hash_sha3_512_free   p_crypto_hash_sha3_free
+#define p_crypto_hash_sha3_512_copy   p_crypto_hash_sha3_copy
 
 P_END_DECLS
 
@@ -24,124 +24,288 @@
  */
 
 #include "pmem.h"
+#include "pcondvariable.h"
+#include "pcpufeatures-private.h"
 #include "pcryptohash.h"
+#include "pcryptohash-blake2.h"
+#include "pcryptohash-blake3.h"
 #include "pcryptohash-gost3411.h"
 #include "pcryptohash-md5.h"
+#include "pcryptohash-multi.h"
 #include "pcryptohash-sha1.h"
 #include "pcryptohash-sha2-256.h"
 #include "pcryptohash-sha2-512.h"
 #include "pcryptohash-sha3.h"
+#include "perror-private.h"
+#include "pmappedfile.h"
+#include "pmutex.h"
+#include "pstring.h"
+#include "puthread.h"
 
+#include <stdio.h>
 #include <string.h>
 
+#ifdef P_OS_UNIX
+#  include <sys/types.h>
+#  include <sys/stat.h>
+#endif
+
 #define P_HASH_FUNCS(ctx, type) \
 	ctx->create = (void * (*) (void)) p_crypto_hash_##type##_new;				\
+	ctx->init = (void * (*) (ppointer, psize)) p_crypto_hash_##type##_init;			\
 	ctx->update = (void (*) (void *, const puchar *, psize)) p_crypto_hash_##type##_update;	\
 	ctx->finish = (void (*) (void *)) p_crypto_hash_##type##_finish;			\
 	ctx->digest = (const puchar * (*) (void *)) p_crypto_hash_##type##_digest;		\
 	ctx->reset = (void (*) (void *)) p_crypto_hash_##type##_reset;				\
-	ctx->free = (void (*) (void *)) p_crypto_hash_##type##_free;
+	ctx->free = (void (*) (void *)) p_crypto_hash_##type##_free;				\
+	ctx->copy = (void (*) (void *, const void *)) p_crypto_hash_##type##_copy;
 
 struct PCryptoHash_ {
 	PCryptoHashType	type;
 	ppointer	context;
 	puint		hash_len;
 	pboolean	closed;
+	pboolean	in_place;
 	ppointer	(*create)	(void);
+	ppointer	(*init)		(ppointer mem, psize size);
 	void		(*update)	(void *hash, const puchar *data, psize len);
 	void		(*finish)	(void *hash);
 	const puchar *	(*digest)	(void *hash);
 	void		(*reset)	(void *hash);
 	void		(*free)		(void *hash);
+	void		(*copy)		(void *dst, const void *src);
+	void		(*set_pool)	(void *hash, PThreadPool *pool);
 };
 
-static pchar pp_crypto_hash_hex_str[]= "0123456789abcdef";
+#define P_CRYPTO_HASH_TYPE_IS_VALID(type) \
+	((type) >= P_CRYPTO_HASH_TYPE_MD5 && (type) <= P_CRYPTO_HASH_TYPE_BLAKE3)
+
+/* In-place storage layout: the hash structure, then the algorithm context */
+#define P_CRYPTO_HASH_ALIGN		16
+#define P_CRYPTO_HASH_ALIGN_UP(x)	(((x) + P_CRYPTO_HASH_ALIGN - 1) & ~((psize) P_CRYPTO_HASH_ALIGN - 1))
+
+/* Mapped files are hashed by windows, the next one is prefetched meanwhile */
+#define P_CRYPTO_HASH_FILE_WINDOW	(4 * 1024 * 1024)
+/* Size of each of the two read buffers when the file can't be mapped */
+#define P_CRYPTO_HASH_FILE_BUFFER	(1024 * 1024)
+
+/* The reader thread fills one buffer while the other one is hashed. A buffer
+ * shorter than P_CRYPTO_HASH_FILE_BUFFER is the last one. */
+typedef struct PCryptoHashFileReader_ {
+	FILE		*file;
+	puchar		*bufs[2];
+	psize		lens[2];
+	pboolean	ready[2];
+	pboolean	stop;
+	pboolean	failed;
+	pint		io_error;
+	pint		native_error;
+	PMutex		*mutex;
+	PCondVariable	*cond;
+} PCryptoHashFileReader;
 
 static void
-pp_crypto_hash_digest_to_hex (const puchar *digest, puint len, pchar *out);
+pp_crypto_hash_setup (PCryptoHash *hash, PCryptoHashType type);
+static pboolean
+pp_crypto_hash_file_mapped (PCryptoHash *hash, const pchar *path);
+static ppointer
+pp_crypto_hash_file_reader (ppointer data);
+static pboolean
+pp_crypto_hash_file_read_async (PCryptoHash *hash, FILE *file, puchar *bufs[2], PError **error);
+static pboolean
+pp_crypto_hash_file_read (PCryptoHash *hash, FILE *file, puchar *buf, PError **error);
 
 static void
-pp_crypto_hash_digest_to_hex (const puchar *digest, puint len, pchar *out)
+pp_crypto_hash_setup (PCryptoHash *hash, PCryptoHashType type)
 {
-	puint i;
-
-	for (i = 0; i < len; ++i) {
-		*(out + (i << 1)    ) = pp_crypto_hash_hex_str[(digest[i] >> 4) & 0x0F];
-		*(out + (i << 1) + 1) = pp_crypto_hash_hex_str[(digest[i]     ) & 0x0F];
-	}
-}
-
-P_LIB_API PCryptoHash *
-p_crypto_hash_new (PCryptoHashType type)
-{
-	PCryptoHash *ret;
-
-	if (P_UNLIKELY (!(type >= P_CRYPTO_HASH_TYPE_MD5 && type <= P_CRYPTO_HASH_TYPE_GOST)))
-		return NULL;
-
-	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PCryptoHash))) == NULL)) {
-		P_ERROR ("PCryptoHash::p_crypto_hash_new: failed to allocate memory");
-		return NULL;
-	}
+	hash->set_pool = NULL;
 
 	switch (type) {
 	case P_CRYPTO_HASH_TYPE_MD5:
-		P_HASH_FUNCS (ret, md5);
-		ret->hash_len = 16;
+		P_HASH_FUNCS (hash, md5);
+		hash->hash_len = 16;
 		break;
 	case P_CRYPTO_HASH_TYPE_SHA1:
-		P_HASH_FUNCS (ret, sha1);
-		ret->hash_len = 20;
+		P_HASH_FUNCS (hash, sha1);
+		hash->hash_len = 20;
 		break;
 	case P_CRYPTO_HASH_TYPE_SHA2_224:
-		P_HASH_FUNCS (ret, sha2_224);
-		ret->hash_len = 28;
+		P_HASH_FUNCS (hash, sha2_224);
+		hash->hash_len = 28;
 		break;
 	case P_CRYPTO_HASH_TYPE_SHA2_256:
-		P_HASH_FUNCS (ret, sha2_256);
-		ret->hash_len = 32;
+		P_HASH_FUNCS (hash, sha2_256);
+		hash->hash_len = 32;
 		break;
 	case P_CRYPTO_HASH_TYPE_SHA2_384:
-		P_HASH_FUNCS (ret, sha2_384);
-		ret->hash_len = 48;
+		P_HASH_FUNCS (hash, sha2_384);
+		hash->hash_len = 48;
 		break;
 	case P_CRYPTO_HASH_TYPE_SHA2_512:
-		P_HASH_FUNCS (ret, sha2_512);
-		ret->hash_len = 64;
+		P_HASH_FUNCS (hash, sha2_512);
+		hash->hash_len = 64;
 		break;
 	case P_CRYPTO_HASH_TYPE_SHA3_224:
-		P_HASH_FUNCS (ret, sha3_224);
-		ret->hash_len = 28;
+		P_HASH_FUNCS (hash, sha3_224);
+		hash->hash_len = 28;
 		break;
 	case P_CRYPTO_HASH_TYPE_SHA3_256:
-		P_HASH_FUNCS (ret, sha3_256);
-		ret->hash_len = 32;
+		P_HASH_FUNCS (hash, sha3_256);
+		hash->hash_len = 32;
 		break;
 	case P_CRYPTO_HASH_TYPE_SHA3_384:
-		P_HASH_FUNCS (ret, sha3_384);
-		ret->hash_len = 48;
+		P_HASH_FUNCS (hash, sha3_384);
+		hash->hash_len = 48;
 		break;
 	case P_CRYPTO_HASH_TYPE_SHA3_512:
-		P_HASH_FUNCS (ret, sha3_512);
-		ret->hash_len = 64;
+		P_HASH_FUNCS (hash, sha3_512);
+		hash->hash_len = 64;
 		break;
 	case P_CRYPTO_HASH_TYPE_GOST:
-		P_HASH_FUNCS (ret, gost3411);
-		ret->hash_len = 32;
+		P_HASH_FUNCS (hash, gost3411);
+		hash->hash_len = 32;
+		break;
+	case P_CRYPTO_HASH_TYPE_BLAKE2B:
+		P_HASH_FUNCS (hash, blake2b);
+		hash->hash_len = 64;
+		break;
+	case P_CRYPTO_HASH_TYPE_BLAKE2S:
+		P_HASH_FUNCS (hash, blake2s);
+		hash->hash_len = 32;
+		break;
+	case P_CRYPTO_HASH_TYPE_BLAKE3:
+		P_HASH_FUNCS (hash, blake3);
+		hash->set_pool = (void (*) (void *, PThreadPool *)) p_crypto_hash_blake3_set_thread_pool;
+		hash->hash_len = 32;
 		break;
 	}
 
-	ret->type   = type;
-	ret->closed = FALSE;
+	hash->type     = type;
+	hash->closed   = FALSE;
+	hash->in_place = FALSE;
+}
+
+P_LIB_API PCryptoHash *
+p_crypto_hash_new (PCryptoHashType type)
+{
+	PCryptoHash *ret;
+
+	if (P_UNLIKELY (!P_CRYPTO_HASH_TYPE_IS_VALID (type)))
+		return NULL;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PCryptoHash))) == NULL)) {
+		P_ERROR ("PCryptoHash::p_crypto_hash_new: failed to allocate memory");
+		return NULL;
+	}
+
+	pp_crypto_hash_setup (ret, type);
+
+	if (P_UNLIKELY ((ret->context = ret->create ()) == NULL)) {
+		p_free (ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+P_LIB_API PCryptoHash *
+p_crypto_hash_init_in_place (PCryptoHashType	type,
+			     ppointer		storage,
+			     psize		size)
+{
+	PCryptoHash	*ret;
+	psize		skip;
+
+	if (P_UNLIKELY (!P_CRYPTO_HASH_TYPE_IS_VALID (type)))
+		return NULL;
+
+	if (P_UNLIKELY (storage == NULL))
+		return NULL;
+
+	skip = P_CRYPTO_HASH_ALIGN_UP (PPOINTER_TO_PSIZE (storage)) - PPOINTER_TO_PSIZE (storage);
+
+	if (P_UNLIKELY (size < skip + P_CRYPTO_HASH_ALIGN_UP (sizeof (PCryptoHash))))
+		return NULL;
+
+	ret  = (PCryptoHash *) ((puchar *) storage + skip);
+	size = size - skip - P_CRYPTO_HASH_ALIGN_UP (sizeof (PCryptoHash));
+
+	memset (ret, 0, sizeof (PCryptoHash));
+
+	pp_crypto_hash_setup (ret, type);
+
+	ret->in_place = TRUE;
+
+	if (P_UNLIKELY ((ret->context = ret->init ((puchar *) ret + P_CRYPTO_HASH_ALIGN_UP (sizeof (PCryptoHash)),
+						   size)) == NULL))
+		return NULL;
+
+	return ret;
+}
+
+P_LIB_API pboolean
+p_crypto_hash_compute (PCryptoHashType	type,
+		       const puchar	*data,
+		       psize		len,
+		       puchar		*digest)
+{
+	puint64		storage[P_CRYPTO_HASH_MAX_CONTEXT_SIZE / sizeof (puint64)];
+	PCryptoHash	*hash;
+
+	if (P_UNLIKELY (digest == NULL || (data == NULL && len > 0)))
+		return FALSE;
+
+	if (P_UNLIKELY ((hash = p_crypto_hash_init_in_place (type, storage, sizeof (storage))) == NULL))
+		return FALSE;
+
+	if (len > 0)
+		hash->update (hash->context, data, len);
+
+	hash->finish (hash->context);
+	memcpy (digest, hash->digest (hash->context), hash->hash_len);
+
+	return TRUE;
+}
+
+P_LIB_API PCryptoHash *
+p_crypto_hash_copy (const PCryptoHash *hash)
+{
+	PCryptoHash *ret;
+
+	if (P_UNLIKELY (hash == NULL))
+		return NULL;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PCryptoHash))) == NULL)) {
+		P_ERROR ("PCryptoHash::p_crypto_hash_copy: failed to allocate memory");
+		return NULL;
+	}
+
+	memcpy (ret, hash, sizeof (PCryptoHash));
+
+	ret->in_place = FALSE;
 
 	if (P_UNLIKELY ((ret->context = ret->create ()) == NULL)) {
 		p_free (ret);
 		return NULL;
 	}
 
+	ret->copy (ret->context, hash->context);
+
 	return ret;
 }
 
+P_LIB_API pboolean
+p_crypto_hash_set_thread_pool (PCryptoHash	*hash,
+			       PThreadPool	*pool)
+{
+	if (P_UNLIKELY (hash == NULL || hash->set_pool == NULL))
+		return FALSE;
+
+	hash->set_pool (hash->context, pool);
+
+	return TRUE;
+}
+
 P_LIB_API void
 p_crypto_hash_update (PCryptoHash *hash, const puchar *data, psize len)
 {
@@ -184,11 +348,32 @@ p_crypto_hash_get_string (PCryptoHash *hash)
 	if (P_UNLIKELY ((ret = p_malloc0 (hash->hash_len * 2 + 1)) == NULL))
 		return NULL;
 
-	pp_crypto_hash_digest_to_hex (digest, hash->hash_len, ret);
+	p_hex_encode (digest, hash->hash_len, ret, hash->hash_len * 2 + 1);
 
 	return ret;
 }
 
+P_LIB_API pboolean
+p_crypto_hash_get_string_into (PCryptoHash	*hash,
+			       pchar		*buf,
+			       psize		buflen)
+{
+	const puchar *digest;
+
+	if (P_UNLIKELY (hash == NULL || buf == NULL || buflen < hash->hash_len * 2 + 1))
+		return FALSE;
+
+	if (!hash->closed) {
+		hash->finish (hash->context);
+		hash->closed = TRUE;
+	}
+
+	if (P_UNLIKELY ((digest = hash->digest (hash->context)) == NULL))
+		return FALSE;
+
+	return p_hex_encode (digest, hash->hash_len, buf, buflen);
+}
+
 P_LIB_API void
 p_crypto_hash_get_digest (PCryptoHash *hash, puchar *buf, psize *len)
 {
@@ -245,6 +430,382 @@ p_crypto_hash_free (PCryptoHash *hash)
 	if (P_UNLIKELY (hash == NULL))
 		return;
 
+	/* Caller owns the storage */
+	if (hash->in_place == TRUE)
+		return;
+
 	hash->free (hash->context);
 	p_free (hash);
 }
+
+P_LIB_API pboolean
+p_crypto_hash_compute_many (PCryptoHashType		type,
+			    const puchar * const	*inputs,
+			    const psize			*lens,
+			    psize			n,
+			    puchar			*digests)
+{
+	puint64		storage[P_CRYPTO_HASH_MAX_CONTEXT_SIZE / sizeof (puint64)];
+	PCryptoHash	*hash;
+	psize		i;
+
+	if (P_UNLIKELY (!P_CRYPTO_HASH_TYPE_IS_VALID (type)))
+		return FALSE;
+
+	if (P_UNLIKELY (n > 0 && (inputs == NULL || lens == NULL || digests == NULL)))
+		return FALSE;
+
+	for (i = 0; i < n; ++i) {
+		if (P_UNLIKELY (inputs[i] == NULL && lens[i] > 0))
+			return FALSE;
+	}
+
+	if (n == 0)
+		return TRUE;
+
+	if (p_crypto_hash_multi_compute (type, inputs, lens, n, digests) == TRUE)
+		return TRUE;
+
+	/* One context is enough for all the messages */
+	if (P_UNLIKELY ((hash = p_crypto_hash_init_in_place (type, storage, sizeof (storage))) == NULL))
+		return FALSE;
+
+	for (i = 0; i < n; ++i) {
+		if (i > 0)
+			hash->reset (hash->context);
+
+		if (lens[i] > 0)
+			hash->update (hash->context, inputs[i], lens[i]);
+
+		hash->finish (hash->context);
+		memcpy (digests + i * hash->hash_len, hash->digest (hash->context), hash->hash_len);
+	}
+
+	return TRUE;
+}
+
+/* Returns FALSE only if the file can't be mapped or reports no size (empty or
+ * special files), the caller reads it then */
+static pboolean
+pp_crypto_hash_file_mapped (PCryptoHash		*hash,
+			    const pchar		*path)
+{
+	PMappedFile	*file;
+	const puchar	*addr;
+	psize		size;
+	psize		offset;
+	psize		len;
+#ifdef P_OS_UNIX
+	struct stat	sb;
+
+	/* Opening a FIFO only to find out it can't be mapped would lose its data */
+	if (stat (path, &sb) != 0 || !S_ISREG (sb.st_mode))
+		return FALSE;
+#endif
+
+	if ((file = p_mapped_file_new (path, P_MAPPED_FILE_ACCESS_READONLY, NULL)) == NULL)
+		return FALSE;
+
+	addr = (const puchar *) p_mapped_file_get_address (file);
+	size = p_mapped_file_get_size (file);
+
+	if (addr == NULL || size == 0) {
+		p_mapped_file_free (file);
+		return FALSE;
+	}
+
+	p_mapped_file_advise (file, 0, 0, P_MAPPED_FILE_ADVICE_SEQUENTIAL, NULL);
+
+	for (offset = 0; offset < size; offset += len) {
+		len = size - offset;
+
+		if (len > P_CRYPTO_HASH_FILE_WINDOW) {
+			len = P_CRYPTO_HASH_FILE_WINDOW;
+
+			/* The system reads the next window while this one is hashed */
+			p_mapped_file_advise (file,
+					      offset + len,
+					      P_CRYPTO_HASH_FILE_WINDOW,
+					      P_MAPPED_FILE_ADVICE_WILLNEED,
+					      NULL);
+		}
+
+		hash->update (hash->context, addr + offset, len);
+	}
+
+	p_mapped_file_free (file);
+
+	return TRUE;
+}
+
+static ppointer
+pp_crypto_hash_file_reader (ppointer data)
+{
+	PCryptoHashFileReader	*reader = (PCryptoHashFileReader *) data;
+	psize			len;
+	pint			idx = 0;
+
+	while (TRUE) {
+		p_mutex_lock (reader->mutex);
+
+		while (reader->ready[idx] == TRUE && reader->stop == FALSE)
+			p_cond_variable_wait (reader->cond, reader->mutex);
+
+		if (reader->stop == TRUE) {
+			p_mutex_unlock (reader->mutex);
+			break;
+		}
+
+		p_mutex_unlock (reader->mutex);
+
+		len = fread (reader->bufs[idx], 1, P_CRYPTO_HASH_FILE_BUFFER, reader->file);
+
+		p_mutex_lock (reader->mutex);
+
+		if (P_UNLIKELY (len < P_CRYPTO_HASH_FILE_BUFFER && ferror (reader->file))) {
+			reader->failed       = TRUE;
+			reader->io_error     = (pint) p_error_get_last_io ();
+			reader->native_error = p_error_get_last_system ();
+		}
+
+		reader->lens[idx]  = len;
+		reader->ready[idx] = TRUE;
+
+		p_cond_variable_broadcast (reader->cond);
+		p_mutex_unlock (reader->mutex);
+
+		if (len < P_CRYPTO_HASH_FILE_BUFFER)
+			break;
+
+		idx ^= 1;
+	}
+
+	return NULL;
+}
+
+/* Returns FALSE without touching the hash if the reader thread can't be
+ * started, the caller reads the file by itself then */
+static pboolean
+pp_crypto_hash_file_read_async (PCryptoHash	*hash,
+				FILE		*file,
+				puchar		*bufs[2],
+				PError		**error)
+{
+	PCryptoHashFileReader	reader;
+	PUThread		*thread;
+	psize			len;
+	pboolean		failed;
+	pint			idx = 0;
+
+	memset (&reader, 0, sizeof (reader));
+
+	reader.file    = file;
+	reader.bufs[0] = bufs[0];
+	reader.bufs[1] = bufs[1];
+	reader.mutex   = p_mutex_new ();
+	reader.cond    = p_cond_variable_new ();
+
+	if (P_UNLIKELY (reader.mutex == NULL || reader.cond == NULL)) {
+		p_mutex_free (reader.mutex);
+		p_cond_variable_free (reader.cond);
+		return FALSE;
+	}
+
+	if (P_UNLIKELY ((thread = p_uthread_create (pp_crypto_hash_file_reader,
+						    &reader,
+						    TRUE,
+						    "PCryptoHashReader")) == NULL)) {
+		p_mutex_free (reader.mutex);
+		p_cond_variable_free (reader.cond);
+		return FALSE;
+	}
+
+	do {
+		p_mutex_lock (reader.mutex);
+
+		while (reader.ready[idx] == FALSE)
+			p_cond_variable_wait (reader.cond, reader.mutex);
+
+		len    = reader.lens[idx];
+		failed = reader.failed;
+
+		p_mutex_unlock (reader.mutex);
+
+		if (len > 0 && failed == FALSE)
+			hash->update (hash->context, bufs[idx], len);
+
+		p_mutex_lock (reader.mutex);
+
+		reader.ready[idx] = FALSE;
+
+		p_cond_variable_broadcast (reader.cond);
+		p_mutex_unlock (reader.mutex);
+
+		idx ^= 1;
+	} while (len == P_CRYPTO_HASH_FILE_BUFFER);
+
+	p_uthread_join (thread);
+	p_uthread_unref (thread);
+
+	p_mutex_free (reader.mutex);
+	p_cond_variable_free (reader.cond);
+
+	if (P_UNLIKELY (reader.failed == TRUE)) {
+		p_error_set_error_p (error,
+				     reader.io_error,
+				     reader.native_error,
+				     "Failed to call fread() to read file");
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static pboolean
+pp_crypto_hash_file_read (PCryptoHash	*hash,
+			  FILE		*file,
+			  puchar	*buf,
+			  PError	**error)
+{
+	psize len;
+
+	do {
+		len = fread (buf, 1, P_CRYPTO_HASH_FILE_BUFFER, file);
+
+		if (len > 0)
+			hash->update (hash->context, buf, len);
+	} while (len == P_CRYPTO_HASH_FILE_BUFFER);
+
+	if (P_UNLIKELY (ferror (file))) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call fread() to read file");
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_crypto_hash_file (PCryptoHashType	type,
+		    const pchar		*path,
+		    puchar		*digest,
+		    PError		**error)
+{
+	puint64		storage[P_CRYPTO_HASH_MAX_CONTEXT_SIZE / sizeof (puint64)];
+	PCryptoHash	*hash;
+	FILE		*file;
+	puchar		*bufs[2];
+	pboolean	result;
+
+	if (P_UNLIKELY (path == NULL || digest == NULL ||
+			(hash = p_crypto_hash_init_in_place (type, storage, sizeof (storage))) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	if (pp_crypto_hash_file_mapped (hash, path) == FALSE) {
+		if (P_UNLIKELY ((file = fopen (path, "rb")) == NULL)) {
+			p_error_set_error_p (error,
+					     (pint) p_error_get_last_io (),
+					     p_error_get_last_system (),
+					     "Failed to call fopen() to open file");
+			return FALSE;
+		}
+
+		/* Reads are large enough, stdio buffering would only copy the data */
+		setvbuf (file, NULL, _IONBF, 0);
+
+		bufs[0] = (puchar *) p_malloc (P_CRYPTO_HASH_FILE_BUFFER);
+		bufs[1] = (puchar *) p_malloc (P_CRYPTO_HASH_FILE_BUFFER);
+
+		if (P_UNLIKELY (bufs[0] == NULL)) {
+			p_free (bufs[1]);
+			fclose (file);
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IO_NO_RESOURCES,
+					     0,
+					     "Failed to allocate memory for read buffer");
+			return FALSE;
+		}
+
+		result = FALSE;
+
+		if (bufs[1] == NULL ||
+		    (result = pp_crypto_hash_file_read_async (hash, file, bufs, error)) == FALSE) {
+			/* Read errors are reported by the thread as well */
+			if (ferror (file))
+				result = FALSE;
+			else
+				result = pp_crypto_hash_file_read (hash, file, bufs[0], error);
+		}
+
+		p_free (bufs[0]);
+		p_free (bufs[1]);
+		fclose (file);
+
+		if (P_UNLIKELY (result == FALSE))
+			return FALSE;
+	}
+
+	hash->finish (hash->context);
+	memcpy (digest, hash->digest (hash->context), hash->hash_len);
+
+	return TRUE;
+}
+
+P_LIB_API const pchar *
+p_crypto_hash_get_implementation (PCryptoHashType type)
+{
+	switch (type) {
+	case P_CRYPTO_HASH_TYPE_MD5:
+	case P_CRYPTO_HASH_TYPE_SHA2_384:
+	case P_CRYPTO_HASH_TYPE_SHA2_512:
+	case P_CRYPTO_HASH_TYPE_GOST:
+	case P_CRYPTO_HASH_TYPE_BLAKE2B:
+	case P_CRYPTO_HASH_TYPE_BLAKE2S:
+		return "generic";
+	case P_CRYPTO_HASH_TYPE_SHA1:
+#if defined (P_CPU_X86_SHA)
+		if (p_cpu_has_feature_internal (P_CPU_FEATURE_SHA1))
+			return "x86 SHA extensions";
+#elif defined (P_CPU_ARM_SHA)
+		if (p_cpu_has_feature_internal (P_CPU_FEATURE_SHA1))
+			return "ARMv8 Cryptographic Extension";
+#endif
+		return "generic";
+	case P_CRYPTO_HASH_TYPE_SHA2_224:
+	case P_CRYPTO_HASH_TYPE_SHA2_256:
+#if defined (P_CPU_X86_SHA)
+		if (p_cpu_has_feature_internal (P_CPU_FEATURE_SHA2_256))
+			return "x86 SHA extensions";
+#elif defined (P_CPU_ARM_SHA)
+		if (p_cpu_has_feature_internal (P_CPU_FEATURE_SHA2_256))
+			return "ARMv8 Cryptographic Extension";
+#endif
+		return "generic";
+	case P_CRYPTO_HASH_TYPE_SHA3_224:
+	case P_CRYPTO_HASH_TYPE_SHA3_256:
+	case P_CRYPTO_HASH_TYPE_SHA3_384:
+	case P_CRYPTO_HASH_TYPE_SHA3_512:
+#if defined (P_CPU_X86_BMI)
+		if (p_cpu_has_feature_internal (P_CPU_FEATURE_BMI))
+			return "x86-64 BMI1/BMI2";
+#elif defined (P_CPU_ARM_SHA3)
+		return "ARMv8.2 SHA3";
+#endif
+		return "generic (lane complementing)";
+	case P_CRYPTO_HASH_TYPE_BLAKE3:
+#ifdef P_HASH_VEC
+		return "4-way SIMD";
+#else
+		return "generic";
+#endif
+	default:
+		return NULL;
+	}
+}
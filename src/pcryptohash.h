@@ -55,7 +55,10 @@
  * - SHA-3/256;
  * - SHA-3/384;
  * - SHA-3/512;
- * - GOST (R 34.11-94).
+ * - GOST (R 34.11-94);
+ * - BLAKE2b;
+ * - BLAKE2s;
+ * - BLAKE3.
  *
  * Use p_crypto_hash_new() to initialize a new hash context with one of the
  * mentioned above types. Data for hashing can be added in several chunks using
@@ -67,6 +70,28 @@
  * a hexidemical string or in a raw representation.
  *
  * A hashing algorithm couldn't be changed after the context initialization.
+ *
+ * To hash a single buffer without any heap allocation use
+ * p_crypto_hash_compute(). A context can also be placed into caller provided
+ * storage of #P_CRYPTO_HASH_MAX_CONTEXT_SIZE bytes with
+ * p_crypto_hash_init_in_place() and then used as usual.
+ *
+ * A partially updated context can be forked with p_crypto_hash_copy() to reuse
+ * a hashed common prefix for several messages.
+ *
+ * A whole file can be hashed with p_crypto_hash_file(), which maps the file
+ * into memory and lets the system read ahead, so hashing keeps up with the
+ * storage.
+ *
+ * Many small independent messages can be hashed with a single call to
+ * p_crypto_hash_compute_many() without creating a context for each of them.
+ * MD5, SHA-1 and SHA-2/224/256 hash several messages at once using SIMD lanes
+ * when possible, other types are processed one by one.
+ *
+ * BLAKE3 hashes the input as a tree of 1 KiB chunks, so a long input (a few
+ * KiB and more) passed in a single update is hashed four chunks at a time in
+ * SIMD lanes. With a thread pool set by p_crypto_hash_set_thread_pool() the
+ * large parts of such an input are hashed on the pool workers as well.
  */
 
 #if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
@@ -78,9 +103,17 @@
 
 #include "pmacros.h"
 #include "ptypes.h"
+#include "perror.h"
+#include "pthreadpool.h"
 
 P_BEGIN_DECLS
 
+/** Storage size enough for any in-place hash context, in bytes. */
+#define P_CRYPTO_HASH_MAX_CONTEXT_SIZE	2048
+
+/** Maximum digest length among all the hash types, in bytes. */
+#define P_CRYPTO_HASH_MAX_DIGEST_SIZE	64
+
 /** Opaque data structure for handling a cryptographic hash context. */
 typedef struct PCryptoHash_ PCryptoHash;
 
@@ -96,7 +129,10 @@ typedef enum PCryptoHashType_ {
 	P_CRYPTO_HASH_TYPE_SHA3_256	= 7, /**< SHA-2/256 hash function.		@since 0.0.2	*/
 	P_CRYPTO_HASH_TYPE_SHA3_384	= 8, /**< SHA-2/384 hash function.		@since 0.0.2	*/
 	P_CRYPTO_HASH_TYPE_SHA3_512	= 9, /**< SHA-3/512 hash function.		@since 0.0.2	*/
-	P_CRYPTO_HASH_TYPE_GOST		= 10 /**< GOST (R 34.11-94) hash function.	@since 0.0.1	*/
+	P_CRYPTO_HASH_TYPE_GOST		= 10, /**< GOST (R 34.11-94) hash function.	@since 0.0.1	*/
+	P_CRYPTO_HASH_TYPE_BLAKE2B	= 11, /**< BLAKE2b-512 hash function.		@since 0.0.5	*/
+	P_CRYPTO_HASH_TYPE_BLAKE2S	= 12, /**< BLAKE2s-256 hash function.		@since 0.0.5	*/
+	P_CRYPTO_HASH_TYPE_BLAKE3	= 13  /**< BLAKE3-256 hash function.		@since 0.0.5	*/
 } PCryptoHashType;
 
 /**
@@ -108,6 +144,74 @@ typedef enum PCryptoHashType_ {
  */
 P_LIB_API PCryptoHash *		p_crypto_hash_new		(PCryptoHashType	type);
 
+/**
+ * @brief Initializes a new #PCryptoHash context in caller provided storage.
+ * @param type Hash function type to use, can't be changed later.
+ * @param storage Memory to place the context into, any alignment.
+ * @param size Size of @a storage, in bytes. #P_CRYPTO_HASH_MAX_CONTEXT_SIZE is
+ * enough for any hash type.
+ * @return #PCryptoHash context placed into @a storage in case of success, NULL
+ * otherwise.
+ * @since 0.0.5
+ *
+ * The context is used the same way as the one from p_crypto_hash_new(), but
+ * no memory is allocated. It stays valid while @a storage does, calling
+ * p_crypto_hash_free() on it is allowed and does nothing.
+ */
+P_LIB_API PCryptoHash *		p_crypto_hash_init_in_place	(PCryptoHashType	type,
+								 ppointer		storage,
+								 psize			size);
+
+/**
+ * @brief Computes a raw digest of a single buffer.
+ * @param type Hash function type to use.
+ * @param data Data to hash, may be NULL only if @a len is zero.
+ * @param len Data length, in bytes.
+ * @param[out] digest Buffer to store the digest, must hold the digest length
+ * of the @a type (#P_CRYPTO_HASH_MAX_DIGEST_SIZE is always enough).
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * This is a shortcut for the new/update/get digest/free sequence which keeps
+ * the context on the stack and never touches the heap.
+ */
+P_LIB_API pboolean		p_crypto_hash_compute		(PCryptoHashType	type,
+								 const puchar		*data,
+								 psize			len,
+								 puchar			*digest);
+
+/**
+ * @brief Duplicates a hash context with its current state.
+ * @param hash #PCryptoHash context to copy.
+ * @return Independent copy of @a hash in case of success, NULL otherwise.
+ * @since 0.0.5
+ *
+ * The copy has the same type, hashed data and open/closed state as the
+ * source. Both contexts can be updated separately afterwards, so a state after
+ * a long common prefix can be saved once and forked for every message instead
+ * of rehashing the prefix. The copy is always allocated on the heap, even if
+ * @a hash was initialized in place, and should be freed with
+ * p_crypto_hash_free(). A thread pool set for @a hash is shared by the copy.
+ */
+P_LIB_API PCryptoHash *		p_crypto_hash_copy		(const PCryptoHash	*hash);
+
+/**
+ * @brief Sets a thread pool to hash large inputs in parallel.
+ * @param hash #PCryptoHash context to set the pool for.
+ * @param pool #PThreadPool to use, NULL to hash in the calling thread only.
+ * @return TRUE in case of success, FALSE if the hash type doesn't support
+ * parallel hashing (only #P_CRYPTO_HASH_TYPE_BLAKE3 does).
+ * @since 0.0.5
+ *
+ * Each p_crypto_hash_update() with more than 128 KiB of data splits it into
+ * parts for the pool workers and the calling thread, and returns after all of
+ * them are hashed. The result doesn't depend on the pool. The pool must
+ * outlive the context and its copies, and the context must not be updated
+ * from a worker of the same pool.
+ */
+P_LIB_API pboolean		p_crypto_hash_set_thread_pool	(PCryptoHash		*hash,
+								 PThreadPool		*pool);
+
 /**
  * @brief Adds a new chunk of data for hashing.
  * @param hash #PCryptoHash context to add @a data to.
@@ -144,6 +248,23 @@ P_LIB_API void			p_crypto_hash_reset		(PCryptoHash		*hash);
  */
 P_LIB_API pchar *		p_crypto_hash_get_string	(PCryptoHash		*hash);
 
+/**
+ * @brief Gets a hash in a hexidemical representation into a given buffer.
+ * @param hash #PCryptoHash context to get a string from.
+ * @param[out] buf Buffer to store the NULL-terminated string.
+ * @param buflen Size of @a buf, must be at least twice the digest length plus
+ * one byte (#P_CRYPTO_HASH_MAX_DIGEST_SIZE * 2 + 1 is always enough).
+ * @return TRUE in case of success, FALSE otherwise.
+ * @note Before writing the string the hash context will be closed for further
+ * updates.
+ * @since 0.0.5
+ *
+ * Same as p_crypto_hash_get_string(), but nothing is allocated.
+ */
+P_LIB_API pboolean		p_crypto_hash_get_string_into	(PCryptoHash		*hash,
+								 pchar			*buf,
+								 psize			buflen);
+
 /**
  * @brief Gets a hash in a raw representation.
  * @param hash #PCryptoHash context to get a digest from.
@@ -183,6 +304,69 @@ P_LIB_API PCryptoHashType	p_crypto_hash_get_type		(const PCryptoHash	*hash);
  */
 P_LIB_API void			p_crypto_hash_free		(PCryptoHash		*hash);
 
+/**
+ * @brief Computes raw digests of several independent messages.
+ * @param type Hash function type to use.
+ * @param inputs Array of @a n messages, an item may be NULL only if its length
+ * is zero.
+ * @param lens Array of @a n message lengths, in bytes.
+ * @param n Number of messages.
+ * @param[out] digests Buffer to store the digests one after another, must be
+ * at least @a n multiplied by the digest length of the @a type in bytes.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The result is the same as hashing every message in its own context, but
+ * the per-message setup is avoided. Up to 4 messages are processed in
+ * parallel SIMD lanes for MD5, SHA-1 and SHA-2/224/256 on x86 (SSE2) and ARM
+ * (NEON) targets. SHA-2 prefers a single stream if the CPU has the dedicated
+ * SHA instructions.
+ */
+P_LIB_API pboolean		p_crypto_hash_compute_many	(PCryptoHashType	type,
+								 const puchar * const	*inputs,
+								 const psize		*lens,
+								 psize			n,
+								 puchar			*digests);
+
+/**
+ * @brief Computes a raw digest of a file.
+ * @param type Hash function type to use.
+ * @param path Path to the file.
+ * @param[out] digest Buffer to store the digest, must hold the digest length
+ * of the @a type (#P_CRYPTO_HASH_MAX_DIGEST_SIZE is always enough).
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The file is mapped read-only with the sequential access advice and hashed
+ * by 4 MiB windows, the system is asked to read the next window ahead while
+ * the current one is hashed. Files which can't be mapped (pipes, special
+ * files or systems without memory mapping) are read by 1 MiB blocks on a
+ * helper thread, so reading and hashing overlap. If the thread can't be
+ * started the file is read in the calling thread.
+ *
+ * The file must not be truncated while it's being hashed: on some systems
+ * accessing the truncated part of a mapping terminates the process.
+ */
+P_LIB_API pboolean		p_crypto_hash_file		(PCryptoHashType	type,
+								 const pchar		*path,
+								 puchar			*digest,
+								 PError			**error);
+
+/**
+ * @brief Gets a name of the implementation used for a hash function type.
+ * @param type Hash function type.
+ * @return Static string with a short human-readable name of the code path
+ * (i.e. "x86 SHA extensions" or "generic"), NULL for an unknown @a type.
+ * @since 0.0.5
+ *
+ * Some hash functions have several implementations, the best one is selected
+ * at runtime depending on the features of the CPU. This call reports which
+ * one is taken on the current machine, it's mostly useful for diagnostics and
+ * benchmarks. The returned string must not be freed.
+ */
+P_LIB_API const pchar *		p_crypto_hash_get_implementation (PCryptoHashType	type);
+
 P_END_DECLS
 
 #endif /* PLIBSYS_HEADER_PCRYPTOHASH_H */
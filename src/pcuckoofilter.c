@@ -0,0 +1,413 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "pmem.h"
+#include "pfasthash.h"
+#include "pcuckoofilter.h"
+
+#include <string.h>
+
+#define P_CUCKOO_FILTER_SLOTS		4
+#define P_CUCKOO_FILTER_MAX_KICKS	500
+#define P_CUCKOO_FILTER_MAX_LOAD	0.9
+
+/* Fingerprints are stored in the buckets of four slots, zero marks an empty
+ * slot, so a bucket is a 32-bit word for the 8-bit fingerprints and a 64-bit
+ * one for the 16-bit fingerprints. The victim keeps a fingerprint which could
+ * not be placed after the last kick, the filter is full while it is set */
+struct PCuckooFilter_ {
+	puint8		*table;
+	psize		num_buckets;
+	psize		count;
+	puint64		rand_state;
+	puint		fp_bits;
+	puint32		fp_mask;
+	pboolean	has_victim;
+	puint32		victim_fp;
+	psize		victim_index;
+};
+
+static puint64 pp_cuckoo_filter_mix (puint64 hash);
+static void pp_cuckoo_filter_hash (const PCuckooFilter *filter, puint64 hash, puint32 *fp, psize *index);
+static psize pp_cuckoo_filter_alt_index (const PCuckooFilter *filter, psize index, puint32 fp);
+static puint32 pp_cuckoo_filter_get_slot (const PCuckooFilter *filter, psize index, puint slot);
+static void pp_cuckoo_filter_set_slot (PCuckooFilter *filter, psize index, puint slot, puint32 fp);
+static pboolean pp_cuckoo_filter_bucket_has (const PCuckooFilter *filter, psize index, puint32 fp);
+static pboolean pp_cuckoo_filter_bucket_insert (PCuckooFilter *filter, psize index, puint32 fp);
+static pboolean pp_cuckoo_filter_bucket_delete (PCuckooFilter *filter, psize index, puint32 fp);
+static void pp_cuckoo_filter_insert (PCuckooFilter *filter, psize index, puint32 fp);
+
+/* Finalizer of MurmurHash3, spreads weak hash values over all the bits */
+static puint64
+pp_cuckoo_filter_mix (puint64 hash)
+{
+	hash ^= hash >> 33;
+	hash *= 0xFF51AFD7ED558CCDULL;
+	hash ^= hash >> 33;
+	hash *= 0xC4CEB9FE1A85EC53ULL;
+	hash ^= hash >> 33;
+
+	return hash;
+}
+
+static void
+pp_cuckoo_filter_hash (const PCuckooFilter	*filter,
+		       puint64			hash,
+		       puint32			*fp,
+		       psize			*index)
+{
+	hash   = pp_cuckoo_filter_mix (hash);
+	*fp    = (puint32) (hash >> 32) & filter->fp_mask;
+	*index = (psize) hash & (filter->num_buckets - 1);
+
+	if (*fp == 0)
+		*fp = 1;
+}
+
+/* Partial-key cuckoo hashing: the other bucket is found from the current one
+ * and the fingerprint only, the operation is its own inverse */
+static psize
+pp_cuckoo_filter_alt_index (const PCuckooFilter	*filter,
+			    psize		index,
+			    puint32		fp)
+{
+	return (index ^ (psize) (fp * 0x5BD1E995U)) & (filter->num_buckets - 1);
+}
+
+static puint32
+pp_cuckoo_filter_get_slot (const PCuckooFilter	*filter,
+			   psize		index,
+			   puint		slot)
+{
+	if (filter->fp_bits == 8)
+		return filter->table[index * P_CUCKOO_FILTER_SLOTS + slot];
+	else
+		return ((const puint16 *) filter->table)[index * P_CUCKOO_FILTER_SLOTS + slot];
+}
+
+static void
+pp_cuckoo_filter_set_slot (PCuckooFilter	*filter,
+			   psize		index,
+			   puint		slot,
+			   puint32		fp)
+{
+	if (filter->fp_bits == 8)
+		filter->table[index * P_CUCKOO_FILTER_SLOTS + slot] = (puint8) fp;
+	else
+		((puint16 *) filter->table)[index * P_CUCKOO_FILTER_SLOTS + slot] = (puint16) fp;
+}
+
+/* Checks all the slots at once with the "has a zero byte" bit trick applied
+ * to the bucket XORed with the fingerprint */
+static pboolean
+pp_cuckoo_filter_bucket_has (const PCuckooFilter	*filter,
+			     psize			index,
+			     puint32			fp)
+{
+	puint32	word32;
+	puint64	word64;
+
+	if (filter->fp_bits == 8) {
+		memcpy (&word32, filter->table + index * sizeof (puint32), sizeof (puint32));
+
+		word32 ^= fp * 0x01010101U;
+
+		return ((word32 - 0x01010101U) & ~word32 & 0x80808080U) != 0;
+	} else {
+		memcpy (&word64, filter->table + index * sizeof (puint64), sizeof (puint64));
+
+		word64 ^= fp * 0x0001000100010001ULL;
+
+		return ((word64 - 0x0001000100010001ULL) & ~word64 & 0x8000800080008000ULL) != 0;
+	}
+}
+
+static pboolean
+pp_cuckoo_filter_bucket_insert (PCuckooFilter	*filter,
+				psize		index,
+				puint32		fp)
+{
+	puint slot;
+
+	for (slot = 0; slot < P_CUCKOO_FILTER_SLOTS; ++slot) {
+		if (pp_cuckoo_filter_get_slot (filter, index, slot) == 0) {
+			pp_cuckoo_filter_set_slot (filter, index, slot, fp);
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+static pboolean
+pp_cuckoo_filter_bucket_delete (PCuckooFilter	*filter,
+				psize		index,
+				puint32		fp)
+{
+	puint slot;
+
+	if (!pp_cuckoo_filter_bucket_has (filter, index, fp))
+		return FALSE;
+
+	for (slot = 0; slot < P_CUCKOO_FILTER_SLOTS; ++slot) {
+		if (pp_cuckoo_filter_get_slot (filter, index, slot) == fp) {
+			pp_cuckoo_filter_set_slot (filter, index, slot, 0);
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+static void
+pp_cuckoo_filter_insert (PCuckooFilter	*filter,
+			 psize		index,
+			 puint32	fp)
+{
+	puint32	old_fp;
+	puint	slot;
+	pint	kick;
+
+	if (pp_cuckoo_filter_bucket_insert (filter, index, fp) ||
+	    pp_cuckoo_filter_bucket_insert (filter, pp_cuckoo_filter_alt_index (filter, index, fp), fp))
+		return;
+
+	/* Both buckets are full: evict a random fingerprint to its other bucket
+	 * and repeat for the evicted one */
+	for (kick = 0; kick < P_CUCKOO_FILTER_MAX_KICKS; ++kick) {
+		filter->rand_state ^= filter->rand_state << 13;
+		filter->rand_state ^= filter->rand_state >> 7;
+		filter->rand_state ^= filter->rand_state << 17;
+
+		slot   = (puint) (filter->rand_state & (P_CUCKOO_FILTER_SLOTS - 1));
+		old_fp = pp_cuckoo_filter_get_slot (filter, index, slot);
+
+		pp_cuckoo_filter_set_slot (filter, index, slot, fp);
+
+		fp    = old_fp;
+		index = pp_cuckoo_filter_alt_index (filter, index, fp);
+
+		if (pp_cuckoo_filter_bucket_insert (filter, index, fp))
+			return;
+	}
+
+	filter->has_victim   = TRUE;
+	filter->victim_fp    = fp;
+	filter->victim_index = index;
+}
+
+P_LIB_API PCuckooFilter *
+p_cuckoo_filter_new (psize	expected_items,
+		     pdouble	false_positive_rate)
+{
+	PCuckooFilter	*ret;
+	psize		num_buckets;
+	pdouble		min_buckets;
+	puint		fp_bits;
+
+	if (P_UNLIKELY (!(false_positive_rate > 0.0 && false_positive_rate < 1.0)))
+		return NULL;
+
+	/* A lookup compares 2 * 4 slots, each matches with 1 / 2^f chance */
+	fp_bits = (2.0 * P_CUCKOO_FILTER_SLOTS) / 256.0 <= false_positive_rate ? 8 : 16;
+
+	min_buckets = (pdouble) expected_items / (P_CUCKOO_FILTER_SLOTS * P_CUCKOO_FILTER_MAX_LOAD);
+
+	/* Alternate buckets are found with XOR, so the number must be a power of
+	 * two. At least two buckets are needed to have alternates at all */
+	for (num_buckets = 2; (pdouble) num_buckets < min_buckets; num_buckets <<= 1) {
+		if (P_UNLIKELY (num_buckets > ((psize) -1) / sizeof (puint64) / 2))
+			return NULL;
+	}
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PCuckooFilter))) == NULL)) {
+		P_ERROR ("PCuckooFilter::p_cuckoo_filter_new: failed(1) to allocate memory");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret->table = p_malloc0_aligned (num_buckets * P_CUCKOO_FILTER_SLOTS * (fp_bits / 8),
+							 P_MEM_CACHE_LINE_SIZE)) == NULL)) {
+		P_ERROR ("PCuckooFilter::p_cuckoo_filter_new: failed(2) to allocate memory");
+		p_free (ret);
+		return NULL;
+	}
+
+	ret->num_buckets = num_buckets;
+	ret->fp_bits     = fp_bits;
+	ret->fp_mask     = fp_bits == 8 ? 0xFFU : 0xFFFFU;
+	ret->rand_state  = 0x9E3779B97F4A7C15ULL;
+
+	return ret;
+}
+
+P_LIB_API pboolean
+p_cuckoo_filter_add (PCuckooFilter	*filter,
+		     pconstpointer	data,
+		     psize		len)
+{
+	if (P_UNLIKELY (filter == NULL || (data == NULL && len > 0)))
+		return FALSE;
+
+	return p_cuckoo_filter_add_hash (filter, p_fast_hash_xxh3_64 (data, len, 0));
+}
+
+P_LIB_API pboolean
+p_cuckoo_filter_add_hash (PCuckooFilter	*filter,
+			  puint64	hash)
+{
+	puint32	fp;
+	psize	index;
+
+	if (P_UNLIKELY (filter == NULL || filter->has_victim))
+		return FALSE;
+
+	pp_cuckoo_filter_hash (filter, hash, &fp, &index);
+	pp_cuckoo_filter_insert (filter, index, fp);
+
+	/* Even if a victim is left, the new fingerprint is in the table */
+	++filter->count;
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_cuckoo_filter_contains (const PCuckooFilter	*filter,
+			  pconstpointer		data,
+			  psize			len)
+{
+	if (P_UNLIKELY (filter == NULL || (data == NULL && len > 0)))
+		return FALSE;
+
+	return p_cuckoo_filter_contains_hash (filter, p_fast_hash_xxh3_64 (data, len, 0));
+}
+
+P_LIB_API pboolean
+p_cuckoo_filter_contains_hash (const PCuckooFilter	*filter,
+			       puint64			hash)
+{
+	puint32	fp;
+	psize	index;
+	psize	alt_index;
+
+	if (P_UNLIKELY (filter == NULL))
+		return FALSE;
+
+	pp_cuckoo_filter_hash (filter, hash, &fp, &index);
+	alt_index = pp_cuckoo_filter_alt_index (filter, index, fp);
+
+	if (filter->has_victim && filter->victim_fp == fp &&
+	    (filter->victim_index == index || filter->victim_index == alt_index))
+		return TRUE;
+
+	return pp_cuckoo_filter_bucket_has (filter, index, fp) ||
+	       pp_cuckoo_filter_bucket_has (filter, alt_index, fp);
+}
+
+P_LIB_API pboolean
+p_cuckoo_filter_remove (PCuckooFilter	*filter,
+			pconstpointer	data,
+			psize		len)
+{
+	if (P_UNLIKELY (filter == NULL || (data == NULL && len > 0)))
+		return FALSE;
+
+	return p_cuckoo_filter_remove_hash (filter, p_fast_hash_xxh3_64 (data, len, 0));
+}
+
+P_LIB_API pboolean
+p_cuckoo_filter_remove_hash (PCuckooFilter	*filter,
+			     puint64		hash)
+{
+	puint32	fp;
+	psize	index;
+	psize	alt_index;
+
+	if (P_UNLIKELY (filter == NULL))
+		return FALSE;
+
+	pp_cuckoo_filter_hash (filter, hash, &fp, &index);
+	alt_index = pp_cuckoo_filter_alt_index (filter, index, fp);
+
+	if (filter->has_victim && filter->victim_fp == fp &&
+	    (filter->victim_index == index || filter->victim_index == alt_index)) {
+		filter->has_victim = FALSE;
+		--filter->count;
+		return TRUE;
+	}
+
+	if (!pp_cuckoo_filter_bucket_delete (filter, index, fp) &&
+	    !pp_cuckoo_filter_bucket_delete (filter, alt_index, fp))
+		return FALSE;
+
+	--filter->count;
+
+	/* A slot is free now, try to place the victim again */
+	if (filter->has_victim) {
+		filter->has_victim = FALSE;
+		pp_cuckoo_filter_insert (filter, filter->victim_index, filter->victim_fp);
+	}
+
+	return TRUE;
+}
+
+P_LIB_API psize
+p_cuckoo_filter_get_count (const PCuckooFilter *filter)
+{
+	if (P_UNLIKELY (filter == NULL))
+		return 0;
+
+	return filter->count;
+}
+
+P_LIB_API psize
+p_cuckoo_filter_get_size (const PCuckooFilter *filter)
+{
+	if (P_UNLIKELY (filter == NULL))
+		return 0;
+
+	return filter->num_buckets * P_CUCKOO_FILTER_SLOTS * (filter->fp_bits / 8);
+}
+
+P_LIB_API void
+p_cuckoo_filter_clear (PCuckooFilter *filter)
+{
+	if (P_UNLIKELY (filter == NULL))
+		return;
+
+	memset (filter->table, 0, p_cuckoo_filter_get_size (filter));
+
+	filter->count      = 0;
+	filter->has_victim = FALSE;
+}
+
+P_LIB_API void
+p_cuckoo_filter_free (PCuckooFilter *filter)
+{
+	if (P_UNLIKELY (filter == NULL))
+		return;
+
+	p_free_aligned (filter->table);
+	p_free (filter);
+}
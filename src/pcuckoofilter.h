@@ -0,0 +1,184 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pcuckoofilter.h
+ * @brief Cuckoo filter
+ * @author Alexander Saprykin
+ *
+ * A cuckoo filter, like #PBloomFilter, answers whether an item may be in a set
+ * with no false negatives and a small false positive rate, but it also
+ * supports removing the items. It stores a short fingerprint of every item in
+ * one of the two candidate buckets of four slots each, and moves the
+ * fingerprints between their buckets (like the cuckoo birds do) to make room
+ * for a new one. A lookup checks only two buckets, both are compared against
+ * the fingerprint with a few word-sized operations instead of a slot by slot
+ * loop.
+ *
+ * Use p_cuckoo_filter_new() with the expected number of items and the target
+ * false positive rate to create a filter of a suitable size. Fingerprints are
+ * 8 or 16 bits long, so the rate can't be lower than about 0.012%. The table
+ * is sized to keep the expected number of items at no more than 90% load, an
+ * insertion fails only when no room can be found for a fingerprint. Items are hashed with p_fast_hash_xxh3_64(), or a hash value
+ * computed elsewhere can be used with the *_hash() variants of the calls.
+ *
+ * Remove only the items which were added before: removing an item which was
+ * not added may remove a matching fingerprint of another item and introduce a
+ * false negative. An item may be added several times (up to eight), each copy
+ * needs its own removal. A filter is not thread-safe for concurrent
+ * modifications, while concurrent lookups are safe.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PCUCKOOFILTER_H
+#define PLIBSYS_HEADER_PCUCKOOFILTER_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+
+P_BEGIN_DECLS
+
+/** Cuckoo filter opaque data structure. */
+typedef struct PCuckooFilter_ PCuckooFilter;
+
+/**
+ * @brief Creates a new cuckoo filter.
+ * @param expected_items Number of items expected to be added.
+ * @param false_positive_rate Target false positive rate, must be greater than
+ * 0 and less than 1 (i.e. 0.01 for 1%).
+ * @return Pointer to a newly created #PCuckooFilter in case of success, NULL
+ * otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API PCuckooFilter *	p_cuckoo_filter_new		(psize			expected_items,
+								 pdouble		false_positive_rate);
+
+/**
+ * @brief Adds an item to a cuckoo filter.
+ * @param filter Cuckoo filter to add the item to.
+ * @param data Item data.
+ * @param len Length of @a data in bytes.
+ * @return TRUE in case of success, FALSE if the filter is full.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean		p_cuckoo_filter_add		(PCuckooFilter		*filter,
+								 pconstpointer		data,
+								 psize			len);
+
+/**
+ * @brief Adds an item to a cuckoo filter by its hash value.
+ * @param filter Cuckoo filter to add the item to.
+ * @param hash 64-bit hash value of the item.
+ * @return TRUE in case of success, FALSE if the filter is full.
+ * @since 0.0.5
+ *
+ * The hash value is mixed once more, so a weaker hash function may be used as
+ * well. Use the same function for the lookups and the removals.
+ */
+P_LIB_API pboolean		p_cuckoo_filter_add_hash	(PCuckooFilter		*filter,
+								 puint64		hash);
+
+/**
+ * @brief Checks whether an item may be in a cuckoo filter.
+ * @param filter Cuckoo filter to check.
+ * @param data Item data.
+ * @param len Length of @a data in bytes.
+ * @return FALSE if the item is definitely not in the filter, TRUE if it is or
+ * in case of a false positive.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean		p_cuckoo_filter_contains	(const PCuckooFilter	*filter,
+								 pconstpointer		data,
+								 psize			len);
+
+/**
+ * @brief Checks whether an item may be in a cuckoo filter by its hash value.
+ * @param filter Cuckoo filter to check.
+ * @param hash 64-bit hash value of the item.
+ * @return FALSE if the item is definitely not in the filter, TRUE if it is or
+ * in case of a false positive.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean		p_cuckoo_filter_contains_hash	(const PCuckooFilter	*filter,
+								 puint64		hash);
+
+/**
+ * @brief Removes an item from a cuckoo filter.
+ * @param filter Cuckoo filter to remove the item from.
+ * @param data Item data.
+ * @param len Length of @a data in bytes.
+ * @return TRUE if the item was removed, FALSE if it was not found.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean		p_cuckoo_filter_remove		(PCuckooFilter		*filter,
+								 pconstpointer		data,
+								 psize			len);
+
+/**
+ * @brief Removes an item from a cuckoo filter by its hash value.
+ * @param filter Cuckoo filter to remove the item from.
+ * @param hash 64-bit hash value of the item.
+ * @return TRUE if the item was removed, FALSE if it was not found.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean		p_cuckoo_filter_remove_hash	(PCuckooFilter		*filter,
+								 puint64		hash);
+
+/**
+ * @brief Gets the number of items in a cuckoo filter.
+ * @param filter Cuckoo filter to check.
+ * @return Number of items in the filter.
+ * @since 0.0.5
+ */
+P_LIB_API psize			p_cuckoo_filter_get_count	(const PCuckooFilter	*filter);
+
+/**
+ * @brief Gets the size of a cuckoo filter table.
+ * @param filter Cuckoo filter to check.
+ * @return Size of the table in bytes.
+ * @since 0.0.5
+ */
+P_LIB_API psize			p_cuckoo_filter_get_size	(const PCuckooFilter	*filter);
+
+/**
+ * @brief Removes all the items from a cuckoo filter.
+ * @param filter Cuckoo filter to clear.
+ * @since 0.0.5
+ */
+P_LIB_API void			p_cuckoo_filter_clear		(PCuckooFilter		*filter);
+
+/**
+ * @brief Frees a cuckoo filter.
+ * @param filter Cuckoo filter to free.
+ * @since 0.0.5
+ */
+P_LIB_API void			p_cuckoo_filter_free		(PCuckooFilter		*filter);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PCUCKOOFILTER_H */
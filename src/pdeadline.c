@@ -0,0 +1,119 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "pdeadline.h"
+#include "ptimeprofiler-private.h"
+
+#define P_DEADLINE_INFINITE_BUDGET	P_MAXUINT64
+
+P_LIB_API void
+p_deadline_init_msecs (PDeadline	*deadline,
+		       pint		timeout)
+{
+	if (timeout < 0)
+		p_deadline_init_infinite (deadline);
+	else
+		p_deadline_init_nsecs (deadline, (puint64) timeout * 1000000);
+}
+
+P_LIB_API void
+p_deadline_init_nsecs (PDeadline	*deadline,
+		       puint64		nsecs)
+{
+	if (P_UNLIKELY (deadline == NULL))
+		return;
+
+	deadline->start  = p_time_profiler_get_ticks_internal ();
+	deadline->budget = nsecs;
+}
+
+P_LIB_API void
+p_deadline_init_infinite (PDeadline *deadline)
+{
+	if (P_UNLIKELY (deadline == NULL))
+		return;
+
+	deadline->start  = 0;
+	deadline->budget = P_DEADLINE_INFINITE_BUDGET;
+}
+
+P_LIB_API pboolean
+p_deadline_is_infinite (const PDeadline *deadline)
+{
+	return deadline == NULL || deadline->budget == P_DEADLINE_INFINITE_BUDGET;
+}
+
+P_LIB_API pboolean
+p_deadline_has_expired (const PDeadline *deadline)
+{
+	return p_deadline_get_remaining_nsecs (deadline) == 0;
+}
+
+P_LIB_API puint64
+p_deadline_get_remaining_nsecs (const PDeadline *deadline)
+{
+	puint64	ticks;
+	puint64	elapsed;
+
+	if (p_deadline_is_infinite (deadline) == TRUE)
+		return P_DEADLINE_INFINITE_BUDGET;
+
+	if (deadline->budget == 0)
+		return 0;
+
+	ticks = p_time_profiler_get_ticks_internal ();
+
+	/* Cycle counters of different cores may be slightly out of sync */
+	elapsed = ticks > deadline->start ? p_time_profiler_ticks_to_nsecs_internal (ticks - deadline->start) : 0;
+
+	return elapsed >= deadline->budget ? 0 : deadline->budget - elapsed;
+}
+
+P_LIB_API pint
+p_deadline_get_remaining_msecs (const PDeadline *deadline)
+{
+	puint64 remaining;
+
+	if (p_deadline_is_infinite (deadline) == TRUE)
+		return -1;
+
+	remaining = p_deadline_get_remaining_nsecs (deadline);
+
+	/* Round up, so a timed wait doesn't return before the deadline */
+	remaining = remaining / 1000000 + (remaining % 1000000 != 0 ? 1 : 0);
+
+	return remaining > (puint64) P_MAXINT32 ? P_MAXINT32 : (pint) remaining;
+}
+
+P_LIB_API void
+p_deadline_limit (PDeadline		*deadline,
+		  const PDeadline	*limit)
+{
+	if (P_UNLIKELY (deadline == NULL) || p_deadline_is_infinite (limit) == TRUE)
+		return;
+
+	if (p_deadline_get_remaining_nsecs (limit) < p_deadline_get_remaining_nsecs (deadline))
+		*deadline = *limit;
+}
@@ -0,0 +1,166 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pdeadline.h
+ * @brief Deadlines for blocking calls
+ * @author Alexander Saprykin
+ *
+ * #PDeadline marks a point in time on the monotonic clock of #PTimeProfiler,
+ * so changing the system time doesn't move it. Unlike a relative timeout it
+ * can be passed through a chain of blocking calls without recomputing: each
+ * call waits only for the time left, and the time spent between the calls
+ * is accounted as well, so a multi-step request never runs out of its
+ * budget:
+ * @code
+ * PDeadline deadline;
+ *
+ * p_deadline_init_msecs (&deadline, 500);
+ *
+ * p_socket_set_deadline (socket, &deadline);
+ * read_request (socket);
+ *
+ * if (p_semaphore_acquire_until (sem, &deadline, NULL) == 1) {
+ *	write_response (socket);
+ *	p_semaphore_release (sem, NULL);
+ * }
+ * @endcode
+ *
+ * The deadline aware calls are p_cond_variable_wait_until(),
+ * p_semaphore_acquire_until(), p_shm_buffer_read_until(),
+ * p_shm_buffer_write_until() and the blocking #PSocket calls after
+ * p_socket_set_deadline(). A NULL deadline means waiting infinitely in all of
+ * them.
+ *
+ * A deadline is just a pair of values, it can be placed on the stack or
+ * inside another structure and doesn't need to be freed. Copy it to pass the
+ * same deadline along, use p_deadline_limit() to take the earlier one of
+ * two deadlines, i.e. for a step which has its own limit within the whole
+ * request budget.
+ *
+ * The underlying calls take the remaining time in milliseconds on most
+ * platforms, so the time is rounded up: a call never returns before the
+ * deadline because of a timeout, but may return up to a millisecond later.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PDEADLINE_H
+#define PLIBSYS_HEADER_PDEADLINE_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+
+P_BEGIN_DECLS
+
+/** Deadline, all the fields are private. */
+typedef struct PDeadline_ {
+	puint64	start;	/**< Ticks counter when the deadline was set.		*/
+	puint64	budget;	/**< Nanoseconds since @a start, P_MAXUINT64 if infinite.	*/
+} PDeadline;
+
+/**
+ * @brief Sets a deadline in a given number of milliseconds from now.
+ * @param deadline Deadline to set.
+ * @param timeout Timeout in milliseconds, -1 (or any negative value) for an
+ * infinite deadline, 0 for an already expired one.
+ * @since 0.0.5
+ *
+ * The @a timeout follows the convention of the relative timeouts of the
+ * library, i.e. p_cond_variable_wait_timed().
+ */
+P_LIB_API void		p_deadline_init_msecs		(PDeadline		*deadline,
+							 pint			timeout);
+
+/**
+ * @brief Sets a deadline in a given number of nanoseconds from now.
+ * @param deadline Deadline to set.
+ * @param nsecs Nanoseconds from now, P_MAXUINT64 for an infinite deadline.
+ * @since 0.0.5
+ */
+P_LIB_API void		p_deadline_init_nsecs		(PDeadline		*deadline,
+							 puint64		nsecs);
+
+/**
+ * @brief Sets an infinite deadline which never expires.
+ * @param deadline Deadline to set.
+ * @since 0.0.5
+ */
+P_LIB_API void		p_deadline_init_infinite	(PDeadline		*deadline);
+
+/**
+ * @brief Checks whether a deadline is infinite.
+ * @param deadline Deadline to check, NULL is infinite.
+ * @return TRUE if @a deadline never expires, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_deadline_is_infinite		(const PDeadline	*deadline);
+
+/**
+ * @brief Checks whether a deadline has expired.
+ * @param deadline Deadline to check, NULL is infinite.
+ * @return TRUE if @a deadline has expired, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_deadline_has_expired		(const PDeadline	*deadline);
+
+/**
+ * @brief Gets the time left until a deadline.
+ * @param deadline Deadline to get the time for, NULL is infinite.
+ * @return Nanoseconds left, 0 if @a deadline has expired, P_MAXUINT64 if it
+ * is infinite.
+ * @since 0.0.5
+ */
+P_LIB_API puint64	p_deadline_get_remaining_nsecs	(const PDeadline	*deadline);
+
+/**
+ * @brief Gets the time left until a deadline as a relative timeout.
+ * @param deadline Deadline to get the timeout for, NULL is infinite.
+ * @return Milliseconds left rounded up, 0 if @a deadline has expired, -1 if
+ * it is infinite.
+ * @since 0.0.5
+ *
+ * The result can be passed to the calls which take a relative timeout in
+ * milliseconds. Recompute it before each call, the remaining time shrinks.
+ * Deadlines further than #P_MAXINT32 milliseconds are clamped.
+ */
+P_LIB_API pint		p_deadline_get_remaining_msecs	(const PDeadline	*deadline);
+
+/**
+ * @brief Moves a deadline to another one if the latter is earlier.
+ * @param deadline Deadline to limit.
+ * @param limit Deadline to limit with, NULL is infinite.
+ * @since 0.0.5
+ *
+ * After the call @a deadline expires no later than @a limit.
+ */
+P_LIB_API void		p_deadline_limit		(PDeadline		*deadline,
+							 const PDeadline	*limit);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PDEADLINE_H */
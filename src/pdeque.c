@@ -0,0 +1,317 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "pmem.h"
+#include "pdeque.h"
+
+#include <string.h>
+
+#define P_DEQUE_MIN_CAPACITY	8
+
+/* Capacity is a power of two, so positions wrap with a mask */
+struct PDeque_ {
+	ppointer	*data;
+	psize		head;
+	psize		length;
+	psize		capacity;
+};
+
+static pboolean pp_deque_grow (PDeque *deque, psize capacity);
+
+static pboolean
+pp_deque_grow (PDeque *deque, psize capacity)
+{
+	ppointer	*new_data;
+	psize		new_capacity;
+	psize		wrapped;
+
+	new_capacity = deque->capacity < P_DEQUE_MIN_CAPACITY ? P_DEQUE_MIN_CAPACITY : deque->capacity;
+
+	while (new_capacity < capacity) {
+		if (P_UNLIKELY (new_capacity > ((psize) -1) / sizeof (ppointer) / 2))
+			return FALSE;
+
+		new_capacity <<= 1;
+	}
+
+	if (P_UNLIKELY (new_capacity > ((psize) -1) / sizeof (ppointer)))
+		return FALSE;
+
+	if (P_UNLIKELY ((new_data = p_realloc (deque->data, new_capacity * sizeof (ppointer))) == NULL))
+		return FALSE;
+
+	/* Move the wrapped part right after the old end, the new capacity is at
+	 * least twice larger so it always fits */
+	if (deque->head + deque->length > deque->capacity) {
+		wrapped = deque->head + deque->length - deque->capacity;
+
+		memcpy (new_data + deque->capacity, new_data, wrapped * sizeof (ppointer));
+	}
+
+	deque->data     = new_data;
+	deque->capacity = new_capacity;
+
+	return TRUE;
+}
+
+P_LIB_API PDeque *
+p_deque_new (void)
+{
+	PDeque *ret;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PDeque))) == NULL)) {
+		P_ERROR ("PDeque::p_deque_new: failed to allocate memory");
+		return NULL;
+	}
+
+	return ret;
+}
+
+P_LIB_API PDeque *
+p_deque_new_sized (psize capacity)
+{
+	PDeque *ret;
+
+	if (P_UNLIKELY ((ret = p_deque_new ()) == NULL))
+		return NULL;
+
+	if (P_UNLIKELY (p_deque_reserve (ret, capacity) == FALSE)) {
+		P_ERROR ("PDeque::p_deque_new_sized: failed to allocate memory");
+		p_deque_free (ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+P_LIB_API pboolean
+p_deque_push_back (PDeque *deque, ppointer data)
+{
+	if (P_UNLIKELY (deque == NULL))
+		return FALSE;
+
+	if (deque->length == deque->capacity) {
+		if (P_UNLIKELY (pp_deque_grow (deque, deque->length + 1) == FALSE)) {
+			P_ERROR ("PDeque::p_deque_push_back: failed to allocate memory");
+			return FALSE;
+		}
+	}
+
+	deque->data[(deque->head + deque->length) & (deque->capacity - 1)] = data;
+	++deque->length;
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_deque_push_front (PDeque *deque, ppointer data)
+{
+	if (P_UNLIKELY (deque == NULL))
+		return FALSE;
+
+	if (deque->length == deque->capacity) {
+		if (P_UNLIKELY (pp_deque_grow (deque, deque->length + 1) == FALSE)) {
+			P_ERROR ("PDeque::p_deque_push_front: failed to allocate memory");
+			return FALSE;
+		}
+	}
+
+	deque->head = (deque->head - 1) & (deque->capacity - 1);
+	deque->data[deque->head] = data;
+	++deque->length;
+
+	return TRUE;
+}
+
+P_LIB_API ppointer
+p_deque_pop_back (PDeque *deque)
+{
+	if (P_UNLIKELY (deque == NULL || deque->length == 0))
+		return NULL;
+
+	--deque->length;
+
+	return deque->data[(deque->head + deque->length) & (deque->capacity - 1)];
+}
+
+P_LIB_API ppointer
+p_deque_pop_front (PDeque *deque)
+{
+	ppointer ret;
+
+	if (P_UNLIKELY (deque == NULL || deque->length == 0))
+		return NULL;
+
+	ret = deque->data[deque->head];
+
+	deque->head = (deque->head + 1) & (deque->capacity - 1);
+	--deque->length;
+
+	return ret;
+}
+
+P_LIB_API ppointer
+p_deque_peek_back (const PDeque *deque)
+{
+	if (P_UNLIKELY (deque == NULL || deque->length == 0))
+		return NULL;
+
+	return deque->data[(deque->head + deque->length - 1) & (deque->capacity - 1)];
+}
+
+P_LIB_API ppointer
+p_deque_peek_front (const PDeque *deque)
+{
+	if (P_UNLIKELY (deque == NULL || deque->length == 0))
+		return NULL;
+
+	return deque->data[deque->head];
+}
+
+P_LIB_API psize
+p_deque_discard_front (PDeque *deque, psize count)
+{
+	if (P_UNLIKELY (deque == NULL))
+		return 0;
+
+	if (count > deque->length)
+		count = deque->length;
+
+	if (count > 0)
+		deque->head = (deque->head + count) & (deque->capacity - 1);
+
+	deque->length -= count;
+
+	return count;
+}
+
+P_LIB_API pboolean
+p_deque_reserve (PDeque *deque, psize capacity)
+{
+	if (P_UNLIKELY (deque == NULL))
+		return FALSE;
+
+	if (capacity <= deque->capacity)
+		return TRUE;
+
+	return pp_deque_grow (deque, capacity);
+}
+
+P_LIB_API ppointer
+p_deque_index (const PDeque *deque, psize index)
+{
+	if (P_UNLIKELY (deque == NULL || index >= deque->length))
+		return NULL;
+
+	return deque->data[(deque->head + index) & (deque->capacity - 1)];
+}
+
+P_LIB_API pboolean
+p_deque_set_index (PDeque *deque, psize index, ppointer data)
+{
+	if (P_UNLIKELY (deque == NULL || index >= deque->length))
+		return FALSE;
+
+	deque->data[(deque->head + index) & (deque->capacity - 1)] = data;
+
+	return TRUE;
+}
+
+P_LIB_API psize
+p_deque_length (const PDeque *deque)
+{
+	if (P_UNLIKELY (deque == NULL))
+		return 0;
+
+	return deque->length;
+}
+
+P_LIB_API psize
+p_deque_get_spans (const PDeque	*deque,
+		   ppointer	**first,
+		   psize	*first_len,
+		   ppointer	**second,
+		   psize	*second_len)
+{
+	psize len1;
+	psize len2;
+
+	if (P_UNLIKELY (deque == NULL || deque->length == 0)) {
+		len1 = 0;
+		len2 = 0;
+	} else if (deque->head + deque->length > deque->capacity) {
+		len1 = deque->capacity - deque->head;
+		len2 = deque->length - len1;
+	} else {
+		len1 = deque->length;
+		len2 = 0;
+	}
+
+	if (first != NULL)
+		*first = len1 > 0 ? deque->data + deque->head : NULL;
+
+	if (first_len != NULL)
+		*first_len = len1;
+
+	if (second != NULL)
+		*second = len2 > 0 ? deque->data : NULL;
+
+	if (second_len != NULL)
+		*second_len = len2;
+
+	return len1 + len2;
+}
+
+P_LIB_API void
+p_deque_foreach (const PDeque *deque, PFunc func, ppointer user_data)
+{
+	psize i;
+
+	if (P_UNLIKELY (deque == NULL || func == NULL))
+		return;
+
+	for (i = 0; i < deque->length; ++i)
+		func (deque->data[(deque->head + i) & (deque->capacity - 1)], user_data);
+}
+
+P_LIB_API void
+p_deque_clear (PDeque *deque)
+{
+	if (P_UNLIKELY (deque == NULL))
+		return;
+
+	deque->head   = 0;
+	deque->length = 0;
+}
+
+P_LIB_API void
+p_deque_free (PDeque *deque)
+{
+	if (P_UNLIKELY (deque == NULL))
+		return;
+
+	p_free (deque->data);
+	p_free (deque);
+}
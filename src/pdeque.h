@@ -0,0 +1,267 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pdeque.h
+ * @brief Double-ended queue
+ * @author Alexander Saprykin
+ *
+ * #PDeque is a growable ring buffer of pointers. Elements are added and
+ * removed at both ends in O(1) time without an allocation per element (unlike
+ * #PList, where appending to the tail takes O(n) time), so it suits well for
+ * FIFO work queues, LIFO stacks and sliding windows. Any element is accessed
+ * by its index in O(1) time, too.
+ *
+ * The capacity is always a power of two and grows geometrically, use
+ * p_deque_reserve() to make room for a known number of elements at once. The
+ * deque never shrinks on removals.
+ *
+ * As the elements wrap around the end of the storage, they occupy at most two
+ * contiguous blocks of memory. Use p_deque_get_spans() to get both blocks for
+ * a batch processing, and p_deque_discard_front() to drop the processed
+ * elements at once:
+ * @code
+ * ppointer    *first, *second;
+ * psize       first_len, second_len;
+ *
+ * p_deque_get_spans (deque, &first, &first_len, &second, &second_len);
+ *
+ * my_process_batch (first, first_len);
+ * my_process_batch (second, second_len);
+ *
+ * p_deque_discard_front (deque, first_len + second_len);
+ * @endcode
+ * #PDeque stores only the pointers to the data, so you must free used memory
+ * manually, p_deque_free() only frees deque's internal memory.
+ *
+ * The deque is not thread-safe, see #PQueueMPMC or #PRingSPSC for the
+ * concurrent queues.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PDEQUE_H
+#define PLIBSYS_HEADER_PDEQUE_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+
+P_BEGIN_DECLS
+
+/** Deque opaque data structure. */
+typedef struct PDeque_ PDeque;
+
+/**
+ * @brief Initializes a new deque.
+ * @return Pointer to a newly initialized #PDeque structure in case of success,
+ * NULL otherwise.
+ * @since 0.0.5
+ * @note Free with p_deque_free() after usage.
+ */
+P_LIB_API PDeque *	p_deque_new		(void);
+
+/**
+ * @brief Initializes a new deque with a capacity hint.
+ * @param capacity Number of elements the deque should hold without growing.
+ * @return Pointer to a newly initialized #PDeque structure in case of success,
+ * NULL otherwise.
+ * @since 0.0.5
+ * @note Free with p_deque_free() after usage.
+ */
+P_LIB_API PDeque *	p_deque_new_sized	(psize			capacity);
+
+/**
+ * @brief Adds data to the back of a deque.
+ * @param deque Initialized deque.
+ * @param data Data to add.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * This call takes amortized O(1) time. The deque is left untouched if it fails
+ * to grow.
+ */
+P_LIB_API pboolean	p_deque_push_back	(PDeque			*deque,
+						 ppointer		data);
+
+/**
+ * @brief Adds data to the front of a deque.
+ * @param deque Initialized deque.
+ * @param data Data to add.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * This call takes amortized O(1) time. The deque is left untouched if it fails
+ * to grow.
+ */
+P_LIB_API pboolean	p_deque_push_front	(PDeque			*deque,
+						 ppointer		data);
+
+/**
+ * @brief Removes the last element from a deque.
+ * @param deque Initialized deque.
+ * @return Data of the removed element, NULL if the deque is empty.
+ * @since 0.0.5
+ */
+P_LIB_API ppointer	p_deque_pop_back	(PDeque			*deque);
+
+/**
+ * @brief Removes the first element from a deque.
+ * @param deque Initialized deque.
+ * @return Data of the removed element, NULL if the deque is empty.
+ * @since 0.0.5
+ */
+P_LIB_API ppointer	p_deque_pop_front	(PDeque			*deque);
+
+/**
+ * @brief Gets the last element of a deque without removing it.
+ * @param deque Initialized deque.
+ * @return Data of the last element, NULL if the deque is empty.
+ * @since 0.0.5
+ */
+P_LIB_API ppointer	p_deque_peek_back	(const PDeque		*deque);
+
+/**
+ * @brief Gets the first element of a deque without removing it.
+ * @param deque Initialized deque.
+ * @return Data of the first element, NULL if the deque is empty.
+ * @since 0.0.5
+ */
+P_LIB_API ppointer	p_deque_peek_front	(const PDeque		*deque);
+
+/**
+ * @brief Removes a number of elements from the front of a deque.
+ * @param deque Initialized deque.
+ * @param count Number of the elements to remove.
+ * @return Number of the removed elements, it is less than @a count if the
+ * deque had fewer elements.
+ * @since 0.0.5
+ *
+ * This call takes O(1) time regardless of the @a count.
+ */
+P_LIB_API psize		p_deque_discard_front	(PDeque			*deque,
+						 psize			count);
+
+/**
+ * @brief Makes room for a number of elements in a deque.
+ * @param deque Initialized deque.
+ * @param capacity Total number of elements the deque should hold without
+ * growing.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The capacity is rounded up to a power of two. The deque never shrinks, so a
+ * capacity below the current one is a no-op.
+ */
+P_LIB_API pboolean	p_deque_reserve		(PDeque			*deque,
+						 psize			capacity);
+
+/**
+ * @brief Gets a deque element by its index.
+ * @param deque Initialized deque.
+ * @param index Index of the element counting from the front.
+ * @return Data of the element, NULL if @a index is out of range.
+ * @since 0.0.5
+ */
+P_LIB_API ppointer	p_deque_index		(const PDeque		*deque,
+						 psize			index);
+
+/**
+ * @brief Sets a deque element by its index.
+ * @param deque Initialized deque.
+ * @param index Index of the element counting from the front.
+ * @param data Data to set.
+ * @return TRUE in case of success, FALSE if @a index is out of range.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_deque_set_index	(PDeque			*deque,
+						 psize			index,
+						 ppointer		data);
+
+/**
+ * @brief Gets the number of deque elements.
+ * @param deque Initialized deque.
+ * @return Number of elements in the @a deque.
+ * @since 0.0.5
+ */
+P_LIB_API psize		p_deque_length		(const PDeque		*deque);
+
+/**
+ * @brief Gets the deque storage as two contiguous spans.
+ * @param deque Initialized deque.
+ * @param[out] first Pointer to the first span, NULL if it is empty.
+ * @param[out] first_len Length of the first span.
+ * @param[out] second Pointer to the second span, NULL if it is empty.
+ * @param[out] second_len Length of the second span.
+ * @return Total number of elements in both spans.
+ * @since 0.0.5
+ *
+ * The first span starts with the front element, the second one continues it
+ * from the beginning of the storage when the elements wrap around. The
+ * pointers are valid until the deque is modified.
+ */
+P_LIB_API psize		p_deque_get_spans	(const PDeque		*deque,
+						 ppointer		**first,
+						 psize			*first_len,
+						 ppointer		**second,
+						 psize			*second_len);
+
+/**
+ * @brief Calls a specified function for each deque element.
+ * @param deque Deque to go through.
+ * @param func Pointer for the callback function.
+ * @param user_data User defined data, may be NULL.
+ * @since 0.0.5
+ *
+ * The @a func will receive the element data and @a user_data in the order
+ * from the front to the back.
+ */
+P_LIB_API void		p_deque_foreach		(const PDeque		*deque,
+						 PFunc			func,
+						 ppointer		user_data);
+
+/**
+ * @brief Removes all the elements from a deque.
+ * @param deque Deque to clear.
+ * @since 0.0.5
+ *
+ * The storage is kept for the reuse.
+ */
+P_LIB_API void		p_deque_clear		(PDeque			*deque);
+
+/**
+ * @brief Frees deque memory.
+ * @param deque Deque to free.
+ * @since 0.0.5
+ *
+ * This function frees only the deque's internal memory, not the data stored in
+ * the elements.
+ */
+P_LIB_API void		p_deque_free		(PDeque			*deque);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PDEQUE_H */
@@ -24,6 +24,7 @@
  */
 
 #include "pdir.h"
+#include "pdir-private.h"
 
 #include <stdlib.h>
 
@@ -45,6 +46,63 @@ p_dir_new (const pchar	*path,
 	return NULL;
 }
 
+PDir *
+p_dir_open_subdir (PDir		*parent,
+		   const pchar	*name,
+		   const pchar	*path,
+		   pboolean	*is_link,
+		   PError	**error)
+{
+	P_UNUSED (parent);
+	P_UNUSED (name);
+	P_UNUSED (path);
+
+	*is_link = FALSE;
+
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IO_NOT_IMPLEMENTED,
+			     0,
+			     "No directory implementation");
+
+	return NULL;
+}
+
+pboolean
+p_dir_get_entry_stat (PDir		*dir,
+		      const pchar	*name,
+		      const pchar	*path,
+		      puint64		*size,
+		      pint64		*mtime)
+{
+	P_UNUSED (dir);
+	P_UNUSED (name);
+	P_UNUSED (path);
+	P_UNUSED (size);
+	P_UNUSED (mtime);
+
+	return FALSE;
+}
+
+pboolean
+p_dir_remove_entry (PDir	*dir,
+		    const pchar	*name,
+		    const pchar	*path,
+		    pboolean	is_dir,
+		    PError	**error)
+{
+	P_UNUSED (dir);
+	P_UNUSED (name);
+	P_UNUSED (path);
+	P_UNUSED (is_dir);
+
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IO_NOT_IMPLEMENTED,
+			     0,
+			     "No directory implementation");
+
+	return FALSE;
+}
+
 P_LIB_API pboolean
 p_dir_create (const pchar	*path,
 	      pint		mode,
@@ -103,6 +161,24 @@ p_dir_get_next_entry (PDir	*dir,
 	return NULL;
 }
 
+P_LIB_API pssize
+p_dir_get_next_entries (PDir		*dir,
+			PDirEntry	*entries,
+			psize		max,
+			PError		**error)
+{
+	P_UNUSED (dir);
+	P_UNUSED (entries);
+	P_UNUSED (max);
+
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IO_NOT_IMPLEMENTED,
+			     0,
+			     "No directory implementation");
+
+	return -1;
+}
+
 P_LIB_API pboolean
 p_dir_rewind (PDir	*dir,
 	      PError	**error)
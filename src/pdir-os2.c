@@ -24,6 +24,7 @@
  */
 
 #include "pdir.h"
+#include "pdir-private.h"
 #include "perror.h"
 #include "pmem.h"
 #include "pstring.h"
@@ -35,6 +36,7 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
 
 struct PDir_ {
 	FILEFINDBUF3	find_data;
@@ -42,6 +44,7 @@ struct PDir_ {
 	pboolean	cached;
 	pchar		path[CCHMAXPATH];
 	pchar		*orig_path;
+	PDirNames	names;
 };
 
 P_LIB_API PDir *
@@ -158,6 +161,71 @@ p_dir_new (const pchar	*path,
 	return ret;
 }
 
+PDir *
+p_dir_open_subdir (PDir		*parent,
+		   const pchar	*name,
+		   const pchar	*path,
+		   pboolean	*is_link,
+		   PError	**error)
+{
+	P_UNUSED (parent);
+	P_UNUSED (name);
+
+	*is_link = FALSE;
+
+	return p_dir_new (path, error);
+}
+
+pboolean
+p_dir_get_entry_stat (PDir		*dir,
+		      const pchar	*name,
+		      const pchar	*path,
+		      puint64		*size,
+		      pint64		*mtime)
+{
+	struct stat sb;
+
+	P_UNUSED (dir);
+	P_UNUSED (name);
+
+	if (P_UNLIKELY (stat (path, &sb) != 0))
+		return FALSE;
+
+	*size  = (puint64) sb.st_size;
+	*mtime = (pint64) sb.st_mtime;
+
+	return TRUE;
+}
+
+pboolean
+p_dir_remove_entry (PDir	*dir,
+		    const pchar	*name,
+		    const pchar	*path,
+		    pboolean	is_dir,
+		    PError	**error)
+{
+	APIRET ulrc;
+
+	P_UNUSED (dir);
+	P_UNUSED (name);
+
+	if (is_dir == TRUE)
+		ulrc = DosDeleteDir ((PSZ) path);
+	else
+		ulrc = DosDelete ((PSZ) path);
+
+	if (P_UNLIKELY (ulrc != NO_ERROR)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_io_from_system ((pint) ulrc),
+				     (pint) ulrc,
+				     is_dir == TRUE ? "Failed to call DosDeleteDir() to remove directory"
+						    : "Failed to call DosDelete() to remove file");
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
 P_LIB_API pboolean
 p_dir_create (const pchar	*path,
 	      pint		mode,
@@ -247,7 +315,6 @@ P_LIB_API PDirEntry *
 p_dir_get_next_entry (PDir	*dir,
 		      PError	**error)
 {
-	PDirEntry	*ret;
 	APIRET		ulrc;
 	ULONG		find_count;
 
@@ -297,22 +364,77 @@ p_dir_get_next_entry (PDir	*dir,
 		}
 	}
 
-	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PDirEntry))) == NULL)) {
+	return p_dir_entry_new (dir->find_data.achName,
+				(dir->find_data.attrFile & FILE_DIRECTORY) != 0 ? P_DIR_ENTRY_TYPE_DIR
+										: P_DIR_ENTRY_TYPE_FILE,
+				error);
+}
+
+P_LIB_API pssize
+p_dir_get_next_entries (PDir		*dir,
+			PDirEntry	*entries,
+			psize		max,
+			PError		**error)
+{
+	APIRET	ulrc;
+	ULONG	find_count;
+	psize	count;
+
+	if (P_UNLIKELY (dir == NULL || (entries == NULL && max > 0))) {
 		p_error_set_error_p (error,
-				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
 				     0,
-				     "Failed to allocate memory for directory entry");
-		return NULL;
+				     "Invalid input argument");
+		return -1;
 	}
 
-	ret->name = p_strdup (dir->find_data.achName);
+	for (count = 0; count < max; ++count) {
+		/* Stream is empty or already exhausted */
+		if (dir->search_handle == HDIR_CREATE)
+			break;
+
+		if (dir->cached == TRUE)
+			dir->cached = FALSE;
+		else {
+			find_count = 1;
+
+			ulrc = DosFindNext (dir->search_handle,
+					    (PVOID) &dir->find_data,
+					    sizeof (dir->find_data),
+					    &find_count);
+
+			if (ulrc != NO_ERROR) {
+				DosFindClose (dir->search_handle);
+				dir->search_handle = HDIR_CREATE;
+
+				if (ulrc == ERROR_NO_MORE_FILES)
+					break;
+
+				p_error_set_error_p (error,
+						     (pint) p_error_get_io_from_system ((pint) ulrc),
+						     (pint) ulrc,
+						     "Failed to call DosFindNext() to read directory stream");
+				return -1;
+			}
+		}
 
-	if ((dir->find_data.attrFile & FILE_DIRECTORY) != 0)
-		ret->type = P_DIR_ENTRY_TYPE_DIR;
-	else
-		ret->type = P_DIR_ENTRY_TYPE_FILE;
+		if (P_UNLIKELY (p_dir_names_add (&dir->names, &entries[count], dir->find_data.achName) == FALSE)) {
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IO_NO_RESOURCES,
+					     0,
+					     "Failed to allocate memory for directory entry names");
+			return -1;
+		}
 
-	return ret;
+		if ((dir->find_data.attrFile & FILE_DIRECTORY) != 0)
+			entries[count].type = P_DIR_ENTRY_TYPE_DIR;
+		else
+			entries[count].type = P_DIR_ENTRY_TYPE_FILE;
+	}
+
+	p_dir_names_finish (&dir->names, entries, count);
+
+	return (pssize) count;
 }
 
 P_LIB_API pboolean
@@ -376,6 +498,8 @@ p_dir_free (PDir *dir)
 			P_ERROR ("PDir::p_dir_free: DosFindClose() failed");
 	}
 
+	p_dir_names_clear (&dir->names);
+
 	p_free (dir->orig_path);
 	p_free (dir);
 }
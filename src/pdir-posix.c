@@ -24,22 +24,36 @@
  */
 
 #include "pdir.h"
+#include "pdir-private.h"
 #include "perror.h"
 #include "pfile.h"
 #include "pmem.h"
 #include "pstring.h"
 #include "perror-private.h"
+#include "psysclose-private.h"
 
 #include <stdlib.h>
 #include <string.h>
 #include <dirent.h>
 #include <unistd.h>
 #include <limits.h>
+#include <fcntl.h>
+#include <errno.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 
-#if defined (__GLIBC__) && (__GLIBC__ >= 2) && (__GLIBC_MINOR__ >= 24)
+#ifdef P_OS_LINUX
+#  include <sys/syscall.h>
+#endif
+
+/* readdir() is thread-safe for different streams on these systems, while
+ * readdir_r() is deprecated, openat(), fstatat() and fdopendir() are
+ * available as well */
+#if defined (__GLIBC__) || defined (P_OS_LINUX)   || defined (P_OS_DARWIN)  || \
+    defined (P_OS_FREEBSD) || defined (P_OS_NETBSD) || defined (P_OS_OPENBSD) || \
+    defined (P_OS_DRAGONFLY)
 #  define P_DIR_NON_REENTRANT 1
+#  define P_DIR_HAVE_FSTATAT 1
 # elif defined (P_OS_SOLARIS) || defined (P_OS_QNX6) || defined (P_OS_UNIXWARE) || \
        defined (P_OS_SCO)     || defined (P_OS_IRIX) || defined (P_OS_HAIKU)
 #  define P_DIR_NEED_BUF_ALLOC 1
@@ -55,20 +69,257 @@
 #  endif
 #endif
 
+/* Entry type is known without a stat() call on most file systems */
+#if defined (DT_UNKNOWN) && defined (DT_DIR) && defined (DT_REG) && defined (DT_LNK)
+#  define P_DIR_HAVE_D_TYPE 1
+#  define P_DIR_DIRENT_TYPE(entry) ((pint) (entry)->d_type)
+#else
+#  define P_DIR_DIRENT_TYPE(entry) 0
+#endif
+
+/* Raw directory records can be read in large batches */
+#if defined (P_OS_LINUX) && defined (SYS_getdents64) && defined (P_DIR_HAVE_D_TYPE)
+#  define P_DIR_HAVE_RAW_READ 1
+#  define P_DIR_RAW_READ_NAME "getdents64()"
+
+typedef struct PDirRawEntry_ {
+	puint64		d_ino;
+	pint64		d_off;
+	pushort		d_reclen;
+	puchar		d_type;
+	pchar		d_name[1];
+} PDirRawEntry;
+#elif defined (P_OS_FREEBSD) && defined (P_DIR_HAVE_D_TYPE)
+#  define P_DIR_HAVE_RAW_READ 1
+#  define P_DIR_RAW_READ_NAME "getdirentries()"
+
+typedef struct dirent PDirRawEntry;
+#endif
+
+/* Size of the buffer for raw directory records */
+#define P_DIR_RAW_BUF_SIZE	(128 * 1024)
+
 struct PDir_ {
 	DIR *		dir;
 	struct dirent	*dir_result;
+#ifndef P_DIR_NON_REENTRANT
+	struct dirent	*dirent_buf;
+#endif
+#ifdef P_DIR_HAVE_RAW_READ
+	pchar		*raw_buf;
+	psize		raw_len;
+	psize		raw_pos;
+#else
+	PDirNames	names;
+#endif
 	pchar		*path;
 	pchar		*orig_path;
 };
 
+static PDir * pp_dir_new_from_stream (DIR *stream, const pchar *path, PError **error);
+static PDirEntryType pp_dir_get_entry_type (const PDir *dir, const pchar *name, pint d_type);
+static pboolean pp_dir_read_entry (PDir *dir, PError **error);
+#ifdef P_DIR_HAVE_RAW_READ
+static pssize pp_dir_read_raw (PDir *dir);
+#endif
+
+static PDirEntryType
+pp_dir_get_entry_type (const PDir	*dir,
+		       const pchar	*name,
+		       pint		d_type)
+{
+	struct stat	sb;
+#ifndef P_DIR_HAVE_FSTATAT
+	pchar		*entry_path;
+	psize		path_len;
+#endif
+
+#ifdef P_DIR_HAVE_D_TYPE
+	switch (d_type) {
+	case DT_DIR:
+		return P_DIR_ENTRY_TYPE_DIR;
+	case DT_REG:
+		return P_DIR_ENTRY_TYPE_FILE;
+	case DT_UNKNOWN:
+	case DT_LNK:
+		/* Symbolic links are resolved with stat() */
+		break;
+	default:
+		return P_DIR_ENTRY_TYPE_OTHER;
+	}
+#else
+	P_UNUSED (d_type);
+#endif
+
+#ifdef P_DIR_HAVE_FSTATAT
+	if (P_UNLIKELY (fstatat (dirfd (dir->dir), name, &sb, 0) != 0)) {
+		P_WARNING ("PDir::pp_dir_get_entry_type: fstatat() failed");
+		return P_DIR_ENTRY_TYPE_OTHER;
+	}
+#else
+	path_len = strlen (dir->path);
+
+	if (P_UNLIKELY ((entry_path = p_malloc0 (path_len + strlen (name) + 2)) == NULL)) {
+		P_WARNING ("PDir::pp_dir_get_entry_type: failed to allocate memory for stat()");
+		return P_DIR_ENTRY_TYPE_OTHER;
+	}
+
+	strcat (entry_path, dir->path);
+	*(entry_path + path_len) = '/';
+	strcat (entry_path + path_len + 1, name);
+
+	if (P_UNLIKELY (stat (entry_path, &sb) != 0)) {
+		P_WARNING ("PDir::pp_dir_get_entry_type: stat() failed");
+		p_free (entry_path);
+		return P_DIR_ENTRY_TYPE_OTHER;
+	}
+
+	p_free (entry_path);
+#endif
+
+	if (S_ISDIR (sb.st_mode))
+		return P_DIR_ENTRY_TYPE_DIR;
+	else if (S_ISREG (sb.st_mode))
+		return P_DIR_ENTRY_TYPE_FILE;
+	else
+		return P_DIR_ENTRY_TYPE_OTHER;
+}
+
+/* Reads the next entry into dir->dir_result, which is NULL at the end */
+static pboolean
+pp_dir_read_entry (PDir		*dir,
+		   PError	**error)
+{
+#ifdef P_DIR_NON_REENTRANT
+	p_error_set_last_system (0);
+
+	if ((dir->dir_result = readdir (dir->dir)) == NULL) {
+		if (P_UNLIKELY (p_error_get_last_system () != 0)) {
+			p_error_set_error_p (error,
+					     (pint) p_error_get_last_io (),
+					     p_error_get_last_system (),
+					     "Failed to call readdir() to read directory stream");
+			return FALSE;
+		}
+	}
+#elif defined (P_DIR_NEED_SIMPLE_R)
+	p_error_set_last_system (0);
+
+	if ((dir->dir_result = readdir_r (dir->dir, dir->dirent_buf)) == NULL) {
+		if (P_UNLIKELY (p_error_get_last_system () != 0)) {
+			p_error_set_error_p (error,
+					     (pint) p_error_get_last_io (),
+					     p_error_get_last_system (),
+					     "Failed to call readdir_r() to read directory stream");
+			return FALSE;
+		}
+	}
+#else
+	if (P_UNLIKELY (readdir_r (dir->dir, dir->dirent_buf, &dir->dir_result) != 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call readdir_r() to read directory stream");
+		return FALSE;
+	}
+#endif
+
+	return TRUE;
+}
+
+#ifdef P_DIR_HAVE_RAW_READ
+static pssize
+pp_dir_read_raw (PDir *dir)
+{
+#  ifdef P_OS_LINUX
+	return (pssize) syscall (SYS_getdents64, dirfd (dir->dir), dir->raw_buf, (psize) P_DIR_RAW_BUF_SIZE);
+#  else
+	off_t base;
+
+	return (pssize) getdirentries (dirfd (dir->dir), dir->raw_buf, P_DIR_RAW_BUF_SIZE, &base);
+#  endif
+}
+#endif
+
+/* Takes ownership of the stream */
+static PDir *
+pp_dir_new_from_stream (DIR		*stream,
+			const pchar	*path,
+			PError		**error)
+{
+	PDir	*ret;
+	pchar	*pathp;
+#ifdef P_DIR_NEED_BUF_ALLOC
+	pint	name_max;
+#endif
+
+#ifdef P_DIR_NEED_BUF_ALLOC
+#  if defined (P_OS_SOLARIS)
+	name_max = (pint) (FILENAME_MAX);
+#  elif defined (P_OS_SCO) || defined (P_OS_IRIX)
+	name_max = (pint) pathconf (path, _PC_NAME_MAX);
+
+	if (name_max == -1) {
+		if (p_error_get_last_system () == 0)
+			name_max = _POSIX_PATH_MAX;
+		else {
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IO_FAILED,
+					     0,
+					     "Failed to get NAME_MAX using pathconf()");
+			closedir (stream);
+			return NULL;
+		}
+	}
+#  elif defined (P_OS_QNX6) || defined (P_OS_UNIXWARE) || defined (P_OS_HAIKU)
+	name_max = (pint) (NAME_MAX);
+#  endif
+#endif
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PDir))) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for directory structure");
+		closedir (stream);
+		return NULL;
+	}
+
+	ret->dir = stream;
+
+#ifndef P_DIR_NON_REENTRANT
+#  ifdef P_DIR_NEED_BUF_ALLOC
+	ret->dirent_buf = p_malloc0 (sizeof (struct dirent) + name_max + 1);
+#  else
+	ret->dirent_buf = p_malloc0 (sizeof (struct dirent));
+#  endif
+
+	if (P_UNLIKELY (ret->dirent_buf == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for internal directory entry");
+		p_dir_free (ret);
+		return NULL;
+	}
+#endif
+
+	ret->path      = p_strdup (path);
+	ret->orig_path = p_strdup (path);
+
+	pathp = ret->path + strlen (ret->path) - 1;
+
+	if (*pathp == '/' || *pathp == '\\')
+		*pathp = '\0';
+
+	return ret;
+}
+
 P_LIB_API PDir *
 p_dir_new (const pchar	*path,
 	   PError	**error)
 {
-	PDir	*ret;
-	DIR	*dir;
-	pchar	*pathp;
+	DIR *stream;
 
 	if (P_UNLIKELY (path == NULL)) {
 		p_error_set_error_p (error,
@@ -78,7 +329,7 @@ p_dir_new (const pchar	*path,
 		return NULL;
 	}
 
-	if (P_UNLIKELY ((dir = opendir (path)) == NULL)) {
+	if (P_UNLIKELY ((stream = opendir (path)) == NULL)) {
 		p_error_set_error_p (error,
 				     (pint) p_error_get_last_io (),
 				     p_error_get_last_system (),
@@ -86,25 +337,150 @@ p_dir_new (const pchar	*path,
 		return NULL;
 	}
 
-	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PDir))) == NULL)) {
+	return pp_dir_new_from_stream (stream, path, error);
+}
+
+PDir *
+p_dir_open_subdir (PDir		*parent,
+		   const pchar	*name,
+		   const pchar	*path,
+		   pboolean	*is_link,
+		   PError	**error)
+{
+#ifdef P_DIR_HAVE_FSTATAT
+	struct stat	sb;
+	DIR		*stream;
+	pint		flags;
+	pint		fd;
+
+	*is_link = FALSE;
+
+	flags = O_RDONLY;
+#  ifdef O_DIRECTORY
+	flags |= O_DIRECTORY;
+#  endif
+#  ifdef O_NOFOLLOW
+	flags |= O_NOFOLLOW;
+#  endif
+#  ifdef O_CLOEXEC
+	flags |= O_CLOEXEC;
+#  endif
+
+	if (parent != NULL)
+		fd = openat (dirfd (parent->dir), name, flags);
+	else
+		fd = open (path, flags);
+
+	if (P_UNLIKELY (fd < 0)) {
+		/* FreeBSD reports a symbolic link with EMLINK, Linux with ENOTDIR
+		 * when combined with O_DIRECTORY */
+		if (errno == ELOOP || errno == EMLINK) {
+			*is_link = TRUE;
+			return NULL;
+		}
+
+		if (errno == ENOTDIR) {
+			if (parent != NULL)
+				*is_link = fstatat (dirfd (parent->dir), name, &sb, AT_SYMLINK_NOFOLLOW) == 0 &&
+					   S_ISLNK (sb.st_mode);
+			else
+				*is_link = lstat (path, &sb) == 0 && S_ISLNK (sb.st_mode);
+
+			if (*is_link == TRUE)
+				return NULL;
+
+			errno = ENOTDIR;
+		}
+
 		p_error_set_error_p (error,
-				     (pint) P_ERROR_IO_NO_RESOURCES,
-				     0,
-				     "Failed to allocate memory for directory structure");
-		closedir (dir);
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call openat() to open directory");
 		return NULL;
 	}
 
-	ret->dir       = dir;
-	ret->path      = p_strdup (path);
-	ret->orig_path = p_strdup (path);
+	if (P_UNLIKELY ((stream = fdopendir (fd)) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call fdopendir() to open directory stream");
+		p_sys_close (fd);
+		return NULL;
+	}
 
-	pathp = ret->path + strlen (ret->path) - 1;
+	return pp_dir_new_from_stream (stream, path, error);
+#else
+	struct stat sb;
 
-	if (*pathp == '/' || *pathp == '\\')
-		*pathp = '\0';
+	P_UNUSED (parent);
+	P_UNUSED (name);
 
-	return ret;
+	*is_link = (lstat (path, &sb) == 0 && S_ISLNK (sb.st_mode)) ? TRUE : FALSE;
+
+	if (*is_link == TRUE)
+		return NULL;
+
+	return p_dir_new (path, error);
+#endif
+}
+
+pboolean
+p_dir_get_entry_stat (PDir		*dir,
+		      const pchar	*name,
+		      const pchar	*path,
+		      puint64		*size,
+		      pint64		*mtime)
+{
+	struct stat sb;
+
+#ifdef P_DIR_HAVE_FSTATAT
+	P_UNUSED (path);
+
+	if (P_UNLIKELY (fstatat (dirfd (dir->dir), name, &sb, 0) != 0))
+		return FALSE;
+#else
+	P_UNUSED (dir);
+	P_UNUSED (name);
+
+	if (P_UNLIKELY (stat (path, &sb) != 0))
+		return FALSE;
+#endif
+
+	*size  = (puint64) sb.st_size;
+	*mtime = (pint64) sb.st_mtime;
+
+	return TRUE;
+}
+
+pboolean
+p_dir_remove_entry (PDir	*dir,
+		    const pchar	*name,
+		    const pchar	*path,
+		    pboolean	is_dir,
+		    PError	**error)
+{
+	pint result;
+
+#ifdef P_DIR_HAVE_FSTATAT
+	if (dir != NULL)
+		result = unlinkat (dirfd (dir->dir), name, is_dir == TRUE ? AT_REMOVEDIR : 0);
+	else
+#else
+	P_UNUSED (dir);
+	P_UNUSED (name);
+#endif
+		result = is_dir == TRUE ? rmdir (path) : unlink (path);
+
+	if (P_UNLIKELY (result != 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     is_dir == TRUE ? "Failed to remove directory"
+						    : "Failed to remove file");
+		return FALSE;
+	}
+
+	return TRUE;
 }
 
 P_LIB_API pboolean
@@ -187,19 +563,6 @@ P_LIB_API PDirEntry *
 p_dir_get_next_entry (PDir	*dir,
 		      PError	**error)
 {
-	PDirEntry	*ret;
-#ifdef P_DIR_NEED_BUF_ALLOC
-	struct dirent	*dirent_st;
-#elif !defined (P_DIR_NON_REENTRANT)
-	struct dirent	dirent_st;
-#endif
-	struct stat	sb;
-	pchar		*entry_path;
-	psize		path_len;
-#ifdef P_DIR_NEED_BUF_ALLOC
-	pint		name_max;
-#endif
-
 	if (P_UNLIKELY (dir == NULL || dir->dir == NULL)) {
 		p_error_set_error_p (error,
 				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
@@ -208,140 +571,112 @@ p_dir_get_next_entry (PDir	*dir,
 		return NULL;
 	}
 
-#ifdef P_DIR_NEED_BUF_ALLOC
-#  if defined (P_OS_SOLARIS)
-	name_max = (pint) (FILENAME_MAX);
-#  elif defined (P_OS_SCO) || defined (P_OS_IRIX)
-	name_max = (pint) pathconf (dir->orig_path, _PC_NAME_MAX);
-
-	if (name_max == -1) {
-		if (p_error_get_last_system () == 0)
-			name_max = _POSIX_PATH_MAX;
-		else {
-			p_error_set_error_p (error,
-					     (pint) P_ERROR_IO_FAILED,
-					     0,
-					     "Failed to get NAME_MAX using pathconf()");
-			return NULL;
-		}
-	}
-#  elif defined (P_OS_QNX6) || defined (P_OS_UNIXWARE) || defined (P_OS_HAIKU)
-	name_max = (pint) (NAME_MAX);
-#  endif
+	if (P_UNLIKELY (pp_dir_read_entry (dir, error) == FALSE))
+		return NULL;
 
-	if (P_UNLIKELY ((dirent_st = p_malloc0 (sizeof (struct dirent) + name_max + 1)) == NULL)) {
-		p_error_set_error_p (error,
-				     (pint) P_ERROR_IO_NO_RESOURCES,
-				     0,
-				     "Failed to allocate memory for internal directory entry");
+	if (dir->dir_result == NULL)
 		return NULL;
-	}
 
-#  ifdef P_DIR_NEED_SIMPLE_R
-	p_error_set_last_system (0);
+	return p_dir_entry_new (dir->dir_result->d_name,
+				pp_dir_get_entry_type (dir,
+						       dir->dir_result->d_name,
+						       P_DIR_DIRENT_TYPE (dir->dir_result)),
+				error);
+}
 
-	if ((dir->dir_result = readdir_r (dir->dir, dirent_st)) == NULL) {
-		if (P_UNLIKELY (p_error_get_last_system () != 0)) {
-			p_error_set_error_p (error,
-					     (pint) p_error_get_last_io (),
-					     p_error_get_last_system (),
-					     "Failed to call readdir_r() to read directory stream");
-			p_free (dirent_st);
-			return NULL;
-		}
-	}
-#  else
-	if (P_UNLIKELY (readdir_r (dir->dir, dirent_st, &dir->dir_result) != 0)) {
-		p_error_set_error_p (error,
-				     (pint) p_error_get_last_io (),
-				     p_error_get_last_system (),
-				     "Failed to call readdir_r() to read directory stream");
-		p_free (dirent_st);
-		return NULL;
-	}
-#  endif
-#else
-#  ifdef P_DIR_NON_REENTRANT
-	p_error_set_last_system (0);
+P_LIB_API pssize
+p_dir_get_next_entries (PDir		*dir,
+			PDirEntry	*entries,
+			psize		max,
+			PError		**error)
+{
+#ifdef P_DIR_HAVE_RAW_READ
+	PDirRawEntry	*raw;
+	pssize		raw_len;
+#endif
+	psize		count;
 
-	if ((dir->dir_result = readdir (dir->dir)) == NULL) {
-		if (P_UNLIKELY (p_error_get_last_system () != 0)) {
-			p_error_set_error_p (error,
-					     (pint) p_error_get_last_io (),
-					     p_error_get_last_system (),
-					     "Failed to call readdir() to read directory stream");
-			return NULL;
-		}
-	}
-#  else
-	if (P_UNLIKELY (readdir_r (dir->dir, &dirent_st, &dir->dir_result) != 0)) {
+	if (P_UNLIKELY (dir == NULL || dir->dir == NULL || (entries == NULL && max > 0))) {
 		p_error_set_error_p (error,
-				     (pint) p_error_get_last_io (),
-				     p_error_get_last_system (),
-				     "Failed to call readdir_r() to read directory stream");
-		return NULL;
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
 	}
-#  endif
-#endif
 
-	if (dir->dir_result == NULL) {
-#ifdef P_DIR_NEED_BUF_ALLOC
-		p_free (dirent_st);
-#endif
-		return NULL;
-	}
+	if (P_UNLIKELY (max == 0))
+		return 0;
 
-	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PDirEntry))) == NULL)) {
+#ifdef P_DIR_HAVE_RAW_READ
+	if (P_UNLIKELY (dir->raw_buf == NULL && (dir->raw_buf = p_malloc (P_DIR_RAW_BUF_SIZE)) == NULL)) {
 		p_error_set_error_p (error,
 				     (pint) P_ERROR_IO_NO_RESOURCES,
 				     0,
-				     "Failed to allocate memory for directory entry");
-#ifdef P_DIR_NEED_BUF_ALLOC
-		p_free (dirent_st);
-#endif
-		return NULL;
+				     "Failed to allocate memory for directory records");
+		return -1;
 	}
 
-#ifdef P_DIR_NEED_BUF_ALLOC
-	ret->name = p_strdup (dirent_st->d_name);
-	p_free (dirent_st);
-#else
-#  ifdef P_DIR_NON_REENTRANT
-	ret->name = p_strdup (dir->dir_result->d_name);
-#  else
-	ret->name = p_strdup (dirent_st.d_name);
-#  endif
-#endif
+	count = 0;
+
+	/* Names point into the buffer, so it is refilled only when all the
+	 * records are consumed by the previous calls */
+	while (count == 0) {
+		if (dir->raw_pos >= dir->raw_len) {
+			if (P_UNLIKELY ((raw_len = pp_dir_read_raw (dir)) < 0)) {
+				p_error_set_error_p (error,
+						     (pint) p_error_get_last_io (),
+						     p_error_get_last_system (),
+						     "Failed to call " P_DIR_RAW_READ_NAME " to read directory stream");
+				return -1;
+			}
+
+			dir->raw_len = (psize) raw_len;
+			dir->raw_pos = 0;
+
+			if (raw_len == 0)
+				return 0;
+		}
 
-	path_len = strlen (dir->path);
+		while (count < max && dir->raw_pos < dir->raw_len) {
+			raw = (PDirRawEntry *) (dir->raw_buf + dir->raw_pos);
 
-	if (P_UNLIKELY ((entry_path = p_malloc0 (path_len + strlen (ret->name) + 2)) == NULL)) {
-		P_WARNING ("PDir::p_dir_get_next_entry: failed to allocate memory for stat()");
-		ret->type = P_DIR_ENTRY_TYPE_OTHER;
-		return ret;
-	}
+			dir->raw_pos += raw->d_reclen;
 
-	strcat (entry_path, dir->path);
-	*(entry_path + path_len) = '/';
-	strcat (entry_path + path_len + 1, ret->name);
+			/* Deleted or whiteout entries */
+			if (raw->d_ino == 0)
+				continue;
 
-	if (P_UNLIKELY (stat (entry_path, &sb) != 0)) {
-		P_WARNING ("PDir::p_dir_get_next_entry: stat() failed");
-		ret->type = P_DIR_ENTRY_TYPE_OTHER;
-		p_free (entry_path);
-		return ret;
+			entries[count].name = raw->d_name;
+			entries[count].type = pp_dir_get_entry_type (dir, raw->d_name, (pint) raw->d_type);
+
+			++count;
+		}
 	}
+#else
+	for (count = 0; count < max; ++count) {
+		if (P_UNLIKELY (pp_dir_read_entry (dir, error) == FALSE))
+			return -1;
 
-	p_free (entry_path);
+		if (dir->dir_result == NULL)
+			break;
 
-	if (S_ISDIR (sb.st_mode))
-		ret->type = P_DIR_ENTRY_TYPE_DIR;
-	else if (S_ISREG (sb.st_mode))
-		ret->type = P_DIR_ENTRY_TYPE_FILE;
-	else
-		ret->type = P_DIR_ENTRY_TYPE_OTHER;
+		if (P_UNLIKELY (p_dir_names_add (&dir->names, &entries[count], dir->dir_result->d_name) == FALSE)) {
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IO_NO_RESOURCES,
+					     0,
+					     "Failed to allocate memory for directory entry names");
+			return -1;
+		}
 
-	return ret;
+		entries[count].type = pp_dir_get_entry_type (dir,
+							     dir->dir_result->d_name,
+							     P_DIR_DIRENT_TYPE (dir->dir_result));
+	}
+
+	p_dir_names_finish (&dir->names, entries, count);
+#endif
+
+	return (pssize) count;
 }
 
 P_LIB_API pboolean
@@ -358,6 +693,11 @@ p_dir_rewind (PDir	*dir,
 
 	rewinddir (dir->dir);
 
+#ifdef P_DIR_HAVE_RAW_READ
+	dir->raw_len = 0;
+	dir->raw_pos = 0;
+#endif
+
 	return TRUE;
 }
 
@@ -372,6 +712,16 @@ p_dir_free (PDir *dir)
 			P_ERROR ("PDir::p_dir_free: closedir() failed");
 	}
 
+#ifndef P_DIR_NON_REENTRANT
+	p_free (dir->dirent_buf);
+#endif
+
+#ifdef P_DIR_HAVE_RAW_READ
+	p_free (dir->raw_buf);
+#else
+	p_dir_names_clear (&dir->names);
+#endif
+
 	p_free (dir->path);
 	p_free (dir->orig_path);
 	p_free (dir);
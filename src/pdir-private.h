@@ -0,0 +1,139 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2016 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PDIR_PRIVATE_H
+#define PLIBSYS_HEADER_PDIR_PRIVATE_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+#include "pdir.h"
+
+P_BEGIN_DECLS
+
+/** Storage for the entry names of a single p_dir_get_next_entries() call. */
+typedef struct PDirNames_ {
+	pchar	*data;	/**< Names separated by zero bytes.	*/
+	psize	size;	/**< Allocated size of the data.	*/
+	psize	used;	/**< Used size of the data.		*/
+} PDirNames;
+
+/**
+ * @brief Allocates a directory entry.
+ * @param name Entry name.
+ * @param type Entry type.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Newly allocated entry in case of success, NULL otherwise.
+ *
+ * The name is stored in the same memory block right after the entry, so
+ * there is a single allocation per entry.
+ */
+PDirEntry *	p_dir_entry_new		(const pchar	*name,
+					 PDirEntryType	type,
+					 PError		**error);
+
+/**
+ * @brief Adds an entry name to the storage.
+ * @param names Names storage.
+ * @param entry Entry to set the name for.
+ * @param name Name to add.
+ * @return TRUE in case of success, FALSE otherwise.
+ *
+ * The storage may be reallocated while adding the names, so @a entry keeps
+ * only the name offset until p_dir_names_finish() is called.
+ */
+pboolean	p_dir_names_add		(PDirNames	*names,
+					 PDirEntry	*entry,
+					 const pchar	*name);
+
+/**
+ * @brief Sets the final name pointers for the entries.
+ * @param names Names storage.
+ * @param entries Entries filled with p_dir_names_add().
+ * @param count Number of entries.
+ */
+void		p_dir_names_finish	(PDirNames	*names,
+					 PDirEntry	*entries,
+					 psize		count);
+
+/**
+ * @brief Frees the names storage.
+ * @param names Names storage.
+ */
+void		p_dir_names_clear	(PDirNames	*names);
+
+/**
+ * @brief Opens a subdirectory during a tree walk.
+ * @param parent Opened parent directory, NULL to open by @a path.
+ * @param name Name of the subdirectory in @a parent.
+ * @param path Full path of the subdirectory.
+ * @param[out] is_link Set to TRUE if the subdirectory is a symbolic link which
+ * must not be followed.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Opened directory in case of success, NULL otherwise.
+ */
+PDir *		p_dir_open_subdir	(PDir		*parent,
+					 const pchar	*name,
+					 const pchar	*path,
+					 pboolean	*is_link,
+					 PError		**error);
+
+/**
+ * @brief Gets the size and the modification time of a directory entry.
+ * @param dir Opened directory containing the entry.
+ * @param name Name of the entry in @a dir.
+ * @param path Full path of the entry.
+ * @param[out] size Size of the entry, in bytes.
+ * @param[out] mtime Modification time, seconds since the Epoch.
+ * @return TRUE in case of success, FALSE otherwise.
+ */
+pboolean	p_dir_get_entry_stat	(PDir		*dir,
+					 const pchar	*name,
+					 const pchar	*path,
+					 puint64	*size,
+					 pint64		*mtime);
+
+/**
+ * @brief Removes a directory entry during a recursive removal.
+ * @param dir Opened directory containing the entry, NULL to remove by @a path.
+ * @param name Name of the entry in @a dir.
+ * @param path Full path of the entry.
+ * @param is_dir Whether the entry is a directory, symbolic links are removed
+ * as files.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ */
+pboolean	p_dir_remove_entry	(PDir		*dir,
+					 const pchar	*name,
+					 const pchar	*path,
+					 pboolean	is_dir,
+					 PError		**error);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PDIR_PRIVATE_H */
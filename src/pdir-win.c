@@ -24,6 +24,7 @@
  */
 
 #include "pdir.h"
+#include "pdir-private.h"
 #include "perror.h"
 #include "pmem.h"
 #include "pstring.h"
@@ -32,14 +33,55 @@
 #include <stdlib.h>
 #include <string.h>
 
+/* Available since Windows 7, older systems reject the flag */
+#ifndef FIND_FIRST_EX_LARGE_FETCH
+#  define FIND_FIRST_EX_LARGE_FETCH	0x00000002
+#endif
+
+/* FindExInfoBasic value, skips filling the short 8.3 names */
+#define P_DIR_FIND_EX_INFO_BASIC	((FINDEX_INFO_LEVELS) 1)
+
 struct PDir_ {
 	WIN32_FIND_DATAA	find_data;
 	HANDLE			search_handle;
 	pboolean		cached;
 	pchar			path[MAX_PATH + 3];
 	pchar			*orig_path;
+	PDirNames		names;
 };
 
+static HANDLE pp_dir_find_first (PDir *dir);
+static PDirEntryType pp_dir_get_entry_type (DWORD attrs);
+
+static HANDLE
+pp_dir_find_first (PDir *dir)
+{
+	HANDLE handle;
+
+	handle = FindFirstFileExA (dir->path,
+				   P_DIR_FIND_EX_INFO_BASIC,
+				   &dir->find_data,
+				   FindExSearchNameMatch,
+				   NULL,
+				   FIND_FIRST_EX_LARGE_FETCH);
+
+	if (handle == INVALID_HANDLE_VALUE && GetLastError () == ERROR_INVALID_PARAMETER)
+		handle = FindFirstFileA (dir->path, &dir->find_data);
+
+	return handle;
+}
+
+static PDirEntryType
+pp_dir_get_entry_type (DWORD attrs)
+{
+	if (attrs & FILE_ATTRIBUTE_DIRECTORY)
+		return P_DIR_ENTRY_TYPE_DIR;
+	else if (attrs & FILE_ATTRIBUTE_DEVICE)
+		return P_DIR_ENTRY_TYPE_OTHER;
+	else
+		return P_DIR_ENTRY_TYPE_FILE;
+}
+
 P_LIB_API PDir *
 p_dir_new (const pchar	*path,
 	   PError	**error)
@@ -82,13 +124,13 @@ p_dir_new (const pchar	*path,
 	*pathp = '\0';
 
 	/* Open directory stream and retrieve the first entry */
-	ret->search_handle = FindFirstFileA (ret->path, &ret->find_data);
+	ret->search_handle = pp_dir_find_first (ret);
 
 	if (P_UNLIKELY (ret->search_handle == INVALID_HANDLE_VALUE)) {
 		p_error_set_error_p (error,
 				     (pint) p_error_get_last_io (),
 				     p_error_get_last_system (),
-				     "Failed to call FindFirstFileA() to open directory stream");
+				     "Failed to call FindFirstFileExA() to open directory stream");
 		p_free (ret);
 		return NULL;
 	}
@@ -99,6 +141,89 @@ p_dir_new (const pchar	*path,
 	return ret;
 }
 
+PDir *
+p_dir_open_subdir (PDir		*parent,
+		   const pchar	*name,
+		   const pchar	*path,
+		   pboolean	*is_link,
+		   PError	**error)
+{
+	DWORD attrs;
+
+	P_UNUSED (parent);
+	P_UNUSED (name);
+
+	/* Don't follow junctions and symbolic links */
+	attrs    = GetFileAttributesA (path);
+	*is_link = (attrs != INVALID_FILE_ATTRIBUTES && (attrs & FILE_ATTRIBUTE_REPARSE_POINT)) ? TRUE : FALSE;
+
+	if (*is_link == TRUE)
+		return NULL;
+
+	return p_dir_new (path, error);
+}
+
+pboolean
+p_dir_get_entry_stat (PDir		*dir,
+		      const pchar	*name,
+		      const pchar	*path,
+		      puint64		*size,
+		      pint64		*mtime)
+{
+	WIN32_FILE_ATTRIBUTE_DATA	data;
+	puint64				ftime;
+
+	P_UNUSED (dir);
+	P_UNUSED (name);
+
+	if (P_UNLIKELY (GetFileAttributesExA (path, GetFileExInfoStandard, &data) == 0))
+		return FALSE;
+
+	*size = ((puint64) data.nFileSizeHigh << 32) | (puint64) data.nFileSizeLow;
+
+	/* FILETIME counts 100 ns intervals since January 1, 1601 */
+	ftime  = ((puint64) data.ftLastWriteTime.dwHighDateTime << 32) | (puint64) data.ftLastWriteTime.dwLowDateTime;
+	*mtime = ((pint64) ftime - (pint64) 116444736000000000LL) / 10000000;
+
+	return TRUE;
+}
+
+pboolean
+p_dir_remove_entry (PDir	*dir,
+		    const pchar	*name,
+		    const pchar	*path,
+		    pboolean	is_dir,
+		    PError	**error)
+{
+	DWORD	attrs;
+	BOOL	result;
+
+	P_UNUSED (dir);
+	P_UNUSED (name);
+
+	/* Directory junctions and symbolic links are removed as directories */
+	if (is_dir == FALSE) {
+		attrs  = GetFileAttributesA (path);
+		is_dir = (attrs != INVALID_FILE_ATTRIBUTES && (attrs & FILE_ATTRIBUTE_DIRECTORY)) ? TRUE : FALSE;
+	}
+
+	if (is_dir == TRUE)
+		result = RemoveDirectoryA (path);
+	else
+		result = DeleteFileA (path);
+
+	if (P_UNLIKELY (result == 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     is_dir == TRUE ? "Failed to call RemoveDirectoryA() to remove directory"
+						    : "Failed to call DeleteFileA() to remove file");
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
 P_LIB_API pboolean
 p_dir_create (const pchar	*path,
 	      pint		mode,
@@ -183,8 +308,6 @@ P_LIB_API PDirEntry *
 p_dir_get_next_entry (PDir	*dir,
 		      PError	**error)
 {
-	PDirEntry	*ret;
-	DWORD		dwAttrs;
 
 	if (P_UNLIKELY (dir == NULL)) {
 		p_error_set_error_p (error,
@@ -216,26 +339,66 @@ p_dir_get_next_entry (PDir	*dir,
 		}
 	}
 
-	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PDirEntry))) == NULL)) {
+	return p_dir_entry_new (dir->find_data.cFileName,
+				pp_dir_get_entry_type (dir->find_data.dwFileAttributes),
+				error);
+}
+
+P_LIB_API pssize
+p_dir_get_next_entries (PDir		*dir,
+			PDirEntry	*entries,
+			psize		max,
+			PError		**error)
+{
+	psize count;
+
+	if (P_UNLIKELY (dir == NULL || (entries == NULL && max > 0))) {
 		p_error_set_error_p (error,
-				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
 				     0,
-				     "Failed to allocate memory for directory entry");
-		return NULL;
+				     "Invalid input argument");
+		return -1;
 	}
 
-	ret->name = p_strdup (dir->find_data.cFileName);
+	for (count = 0; count < max; ++count) {
+		if (dir->cached == TRUE)
+			dir->cached = FALSE;
+		else {
+			/* Stream is already exhausted */
+			if (dir->search_handle == INVALID_HANDLE_VALUE)
+				break;
+
+			if (!FindNextFileA (dir->search_handle, &dir->find_data)) {
+				if (P_UNLIKELY (GetLastError () != ERROR_NO_MORE_FILES)) {
+					p_error_set_error_p (error,
+							     (pint) p_error_get_last_io (),
+							     p_error_get_last_system (),
+							     "Failed to call FindNextFileA() to read directory stream");
+					FindClose (dir->search_handle);
+					dir->search_handle = INVALID_HANDLE_VALUE;
+					return -1;
+				}
+
+				FindClose (dir->search_handle);
+				dir->search_handle = INVALID_HANDLE_VALUE;
+				break;
+			}
+		}
 
-	dwAttrs = dir->find_data.dwFileAttributes;
+		if (P_UNLIKELY (p_dir_names_add (&dir->names, &entries[count], dir->find_data.cFileName) == FALSE)) {
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IO_NO_RESOURCES,
+					     0,
+					     "Failed to allocate memory for directory entry names");
+			return -1;
+		}
 
-	if (dwAttrs & FILE_ATTRIBUTE_DIRECTORY)
-		ret->type = P_DIR_ENTRY_TYPE_DIR;
-	else if (dwAttrs & FILE_ATTRIBUTE_DEVICE)
-		ret->type = P_DIR_ENTRY_TYPE_OTHER;
-	else
-		ret->type = P_DIR_ENTRY_TYPE_FILE;
+		entries[count].type = pp_dir_get_entry_type (dir->find_data.dwFileAttributes);
+	}
 
-	return ret;
+	p_dir_names_finish (&dir->names, entries, count);
+
+	return (pssize) count;
 }
 
 P_LIB_API pboolean
@@ -260,13 +423,13 @@ p_dir_rewind (PDir	*dir,
 		}
 	}
 
-	dir->search_handle = FindFirstFileA (dir->path, &dir->find_data);
+	dir->search_handle = pp_dir_find_first (dir);
 
 	if (P_UNLIKELY (dir->search_handle == INVALID_HANDLE_VALUE)) {
 		p_error_set_error_p (error,
 				     (pint) p_error_get_last_io (),
 				     p_error_get_last_system (),
-				     "Failed to call FindFirstFileA() to open directory stream");
+				     "Failed to call FindFirstFileExA() to open directory stream");
 		dir->cached = FALSE;
 		return FALSE;
 	} else {
@@ -286,6 +449,8 @@ p_dir_free (PDir *dir)
 			P_ERROR ("PDir::p_dir_free: FindClose() failed");
 	}
 
+	p_dir_names_clear (&dir->names);
+
 	p_free (dir->orig_path);
 	p_free (dir);
 }
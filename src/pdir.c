@@ -24,7 +24,80 @@
  */
 
 #include "pmem.h"
+#include "patomic.h"
+#include "pcondvariable.h"
 #include "pdir.h"
+#include "pdir-private.h"
+#include "perror.h"
+#include "pfile.h"
+#include "pmutex.h"
+#include "pstring.h"
+#include "pthreadpool.h"
+
+#include <string.h>
+
+/* Number of entries read from a directory per call during a tree traversal */
+#define P_DIR_TREE_BATCH_SIZE		64
+
+/* Maximum number of subdirectory tasks per pool worker, when there are
+ * already enough of them a subdirectory is handled in place */
+#define P_DIR_TREE_TASKS_PER_WORKER	4
+
+/* State shared by the tree traversals which may run on a thread pool */
+typedef struct PDirTree_ {
+	PThreadPool	*pool;
+	pint		max_tasks;
+	volatile pint	tasks;
+	PMutex		*mutex;
+	PCondVariable	*cond;
+	pboolean	failed;
+	PError		*error;
+} PDirTree;
+
+typedef struct PDirWalk_ {
+	PDirTree	tree;
+	puint		flags;
+	PDirWalkFunc	func;
+	ppointer	user_data;
+	volatile pint	stopped;
+} PDirWalk;
+
+typedef struct PDirWalkTask_ {
+	PDirWalk	*walk;
+	pchar		*path;
+	pint		depth;
+} PDirWalkTask;
+
+/* Directory is removed when its contents and all its subdirectories are */
+typedef struct PDirRemoveNode_ {
+	PDirTree		*tree;
+	struct PDirRemoveNode_	*parent;
+	pchar			*path;
+	volatile pint		refs;
+} PDirRemoveNode;
+
+typedef struct PDirCopy_ {
+	PDirTree	*tree;
+	const pchar	*src;
+	psize		src_len;
+	const pchar	*dst;
+} PDirCopy;
+
+static pchar * pp_dir_join_path (const pchar *path, const pchar *name);
+static pboolean pp_dir_tree_init (PDirTree *tree, PThreadPool *pool, PError **error);
+static void pp_dir_tree_fail (PDirTree *tree, PError *error);
+static void pp_dir_tree_task_done (PDirTree *tree);
+static pboolean pp_dir_tree_finish (PDirTree *tree, PError **error);
+static void pp_dir_walk_subdir (PDirWalk *walk, PDir *parent, const pchar *name, const pchar *path, pint depth);
+static pboolean pp_dir_walk_push (PDirWalk *walk, const pchar *path, pint depth);
+static void pp_dir_walk_task (ppointer data);
+static void pp_dir_walk_dir (PDirWalk *walk, PDir *dir, const pchar *path, pint depth);
+static PDirRemoveNode * pp_dir_remove_node_new (PDirTree *tree, PDirRemoveNode *parent, const pchar *path);
+static void pp_dir_remove_node_release (PDirRemoveNode *node);
+static void pp_dir_remove_link (PDirRemoveNode *node, PDir *parent, const pchar *name);
+static void pp_dir_remove_task (ppointer data);
+static void pp_dir_remove_dir (PDirRemoveNode *node, PDir *dir);
+static PDirWalkResult pp_dir_copy_entry (const PDirWalkEntry *entry, ppointer user_data);
 
 P_LIB_API void
 p_dir_entry_free (PDirEntry *entry)
@@ -32,6 +105,698 @@ p_dir_entry_free (PDirEntry *entry)
 	if (P_UNLIKELY (entry == NULL))
 		return;
 
-	p_free (entry->name);
+	/* Names allocated along with the entry are freed with it */
+	if (entry->name != (pchar *) (entry + 1))
+		p_free (entry->name);
+
 	p_free (entry);
 }
+
+PDirEntry *
+p_dir_entry_new (const pchar	*name,
+		 PDirEntryType	type,
+		 PError		**error)
+{
+	PDirEntry	*ret;
+	psize		name_len;
+
+	name_len = strlen (name);
+
+	if (P_UNLIKELY ((ret = p_malloc (sizeof (PDirEntry) + name_len + 1)) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for directory entry");
+		return NULL;
+	}
+
+	ret->name = (pchar *) (ret + 1);
+	ret->type = type;
+
+	memcpy (ret->name, name, name_len + 1);
+
+	return ret;
+}
+
+pboolean
+p_dir_names_add (PDirNames	*names,
+		 PDirEntry	*entry,
+		 const pchar	*name)
+{
+	pchar	*data;
+	psize	len;
+	psize	size;
+
+	len = strlen (name) + 1;
+
+	if (names->size - names->used < len) {
+		for (size = names->size > 0 ? names->size * 2 : 4096; size - names->used < len; size *= 2)
+			;
+
+		if (P_UNLIKELY ((data = p_realloc (names->data, size)) == NULL))
+			return FALSE;
+
+		names->data = data;
+		names->size = size;
+	}
+
+	memcpy (names->data + names->used, name, len);
+
+	entry->name = (pchar *) names->used;
+	names->used += len;
+
+	return TRUE;
+}
+
+void
+p_dir_names_finish (PDirNames	*names,
+		    PDirEntry	*entries,
+		    psize	count)
+{
+	psize i;
+
+	for (i = 0; i < count; ++i)
+		entries[i].name = names->data + (psize) entries[i].name;
+
+	/* The next call starts over */
+	names->used = 0;
+}
+
+void
+p_dir_names_clear (PDirNames *names)
+{
+	p_free (names->data);
+
+	names->data = NULL;
+	names->size = 0;
+	names->used = 0;
+}
+
+static pchar *
+pp_dir_join_path (const pchar	*path,
+		  const pchar	*name)
+{
+	pchar	*ret;
+	psize	path_len;
+	psize	name_len;
+
+	path_len = strlen (path);
+	name_len = strlen (name);
+
+	if (P_UNLIKELY ((ret = p_malloc (path_len + name_len + 2)) == NULL))
+		return NULL;
+
+	memcpy (ret, path, path_len);
+
+	if (path_len > 0 && path[path_len - 1] != '/' && path[path_len - 1] != '\\')
+		ret[path_len++] = P_DIR_SEPARATOR[0];
+
+	memcpy (ret + path_len, name, name_len + 1);
+
+	return ret;
+}
+
+static pboolean
+pp_dir_tree_init (PDirTree	*tree,
+		  PThreadPool	*pool,
+		  PError	**error)
+{
+	memset (tree, 0, sizeof (PDirTree));
+
+	if (pool == NULL)
+		return TRUE;
+
+	tree->mutex = p_mutex_new ();
+	tree->cond  = p_cond_variable_new ();
+
+	if (P_UNLIKELY (tree->mutex == NULL || tree->cond == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for tree synchronization");
+
+		if (tree->mutex != NULL)
+			p_mutex_free (tree->mutex);
+
+		if (tree->cond != NULL)
+			p_cond_variable_free (tree->cond);
+
+		return FALSE;
+	}
+
+	tree->pool      = pool;
+	tree->max_tasks = p_thread_pool_get_worker_count (pool) * P_DIR_TREE_TASKS_PER_WORKER;
+
+	return TRUE;
+}
+
+/* Keeps the first error only, takes ownership of the error */
+static void
+pp_dir_tree_fail (PDirTree	*tree,
+		  PError	*error)
+{
+	if (tree->mutex != NULL)
+		p_mutex_lock (tree->mutex);
+
+	tree->failed = TRUE;
+
+	if (tree->error == NULL) {
+		tree->error = error;
+		error       = NULL;
+	}
+
+	if (tree->mutex != NULL)
+		p_mutex_unlock (tree->mutex);
+
+	if (error != NULL)
+		p_error_free (error);
+}
+
+static void
+pp_dir_tree_task_done (PDirTree *tree)
+{
+	/* The waiter holds the mutex until it sleeps, so the wakeup can't be
+	 * missed */
+	if (p_atomic_int_dec_and_test (&tree->tasks) == TRUE) {
+		p_mutex_lock (tree->mutex);
+		p_cond_variable_broadcast (tree->cond);
+		p_mutex_unlock (tree->mutex);
+	}
+}
+
+/* Waits for the pool tasks and reports the first error */
+static pboolean
+pp_dir_tree_finish (PDirTree	*tree,
+		    PError	**error)
+{
+	if (tree->pool != NULL) {
+		p_mutex_lock (tree->mutex);
+
+		while (p_atomic_int_get (&tree->tasks) > 0)
+			p_cond_variable_wait (tree->cond, tree->mutex);
+
+		p_mutex_unlock (tree->mutex);
+
+		p_cond_variable_free (tree->cond);
+		p_mutex_free (tree->mutex);
+	}
+
+	if (tree->error != NULL) {
+		if (error != NULL && *error == NULL)
+			*error = tree->error;
+		else
+			p_error_free (tree->error);
+	}
+
+	return tree->failed == TRUE ? FALSE : TRUE;
+}
+
+static void
+pp_dir_walk_subdir (PDirWalk	*walk,
+		    PDir	*parent,
+		    const pchar	*name,
+		    const pchar	*path,
+		    pint	depth)
+{
+	PDir		*dir;
+	PError		*error   = NULL;
+	pboolean	is_link;
+
+	if ((dir = p_dir_open_subdir (parent, name, path, &is_link, &error)) == NULL) {
+		if (is_link == FALSE)
+			pp_dir_tree_fail (&walk->tree, error);
+
+		return;
+	}
+
+	pp_dir_walk_dir (walk, dir, path, depth);
+
+	p_dir_free (dir);
+}
+
+static pboolean
+pp_dir_walk_push (PDirWalk	*walk,
+		  const pchar	*path,
+		  pint		depth)
+{
+	PDirWalkTask *task;
+
+	if (walk->tree.pool == NULL || p_atomic_int_get (&walk->tree.tasks) >= walk->tree.max_tasks)
+		return FALSE;
+
+	if (P_UNLIKELY ((task = p_malloc0 (sizeof (PDirWalkTask))) == NULL))
+		return FALSE;
+
+	if (P_UNLIKELY ((task->path = p_strdup (path)) == NULL)) {
+		p_free (task);
+		return FALSE;
+	}
+
+	task->walk  = walk;
+	task->depth = depth;
+
+	p_atomic_int_inc (&walk->tree.tasks);
+
+	if (P_UNLIKELY (p_thread_pool_push (walk->tree.pool, pp_dir_walk_task, task) == FALSE)) {
+		p_atomic_int_add (&walk->tree.tasks, -1);
+		p_free (task->path);
+		p_free (task);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static void
+pp_dir_walk_task (ppointer data)
+{
+	PDirWalkTask	*task = data;
+	PDirWalk	*walk = task->walk;
+
+	if (p_atomic_int_get (&walk->stopped) == 0)
+		pp_dir_walk_subdir (walk, NULL, NULL, task->path, task->depth);
+
+	p_free (task->path);
+	p_free (task);
+
+	pp_dir_tree_task_done (&walk->tree);
+}
+
+static void
+pp_dir_walk_dir (PDirWalk	*walk,
+		 PDir		*dir,
+		 const pchar	*path,
+		 pint		depth)
+{
+	PDirEntry	entries[P_DIR_TREE_BATCH_SIZE];
+	PDirWalkEntry	entry;
+	PDirWalkResult	result;
+	PError		*error = NULL;
+	pchar		*entry_path;
+	pssize		count;
+	pssize		i;
+
+	while ((count = p_dir_get_next_entries (dir, entries, P_DIR_TREE_BATCH_SIZE, &error)) > 0) {
+		for (i = 0; i < count; ++i) {
+			if (p_atomic_int_get (&walk->stopped) != 0)
+				return;
+
+			if (strcmp (entries[i].name, ".") == 0 || strcmp (entries[i].name, "..") == 0)
+				continue;
+
+			if (P_UNLIKELY ((entry_path = pp_dir_join_path (path, entries[i].name)) == NULL)) {
+				pp_dir_tree_fail (&walk->tree,
+						  p_error_new_literal ((pint) P_ERROR_IO_NO_RESOURCES,
+								       0,
+								       "Failed to allocate memory for entry path"));
+				continue;
+			}
+
+			memset (&entry, 0, sizeof (entry));
+
+			entry.path  = entry_path;
+			entry.name  = entries[i].name;
+			entry.type  = entries[i].type;
+			entry.depth = depth;
+
+			if (walk->flags & P_DIR_WALK_FLAG_STAT)
+				entry.has_stat = p_dir_get_entry_stat (dir,
+								       entries[i].name,
+								       entry_path,
+								       &entry.size,
+								       &entry.mtime);
+
+			result = walk->func (&entry, walk->user_data);
+
+			if (result == P_DIR_WALK_STOP) {
+				p_atomic_int_set (&walk->stopped, 1);
+				p_free (entry_path);
+				return;
+			}
+
+			/* Subdirectory is walked in place when the pool has enough
+			 * work already, the parent handle is at hand then */
+			if (entries[i].type == P_DIR_ENTRY_TYPE_DIR &&
+			    result != P_DIR_WALK_SKIP &&
+			    pp_dir_walk_push (walk, entry_path, depth + 1) == FALSE)
+				pp_dir_walk_subdir (walk, dir, entries[i].name, entry_path, depth + 1);
+
+			p_free (entry_path);
+		}
+	}
+
+	if (P_UNLIKELY (count < 0))
+		pp_dir_tree_fail (&walk->tree, error);
+}
+
+static PDirRemoveNode *
+pp_dir_remove_node_new (PDirTree	*tree,
+			PDirRemoveNode	*parent,
+			const pchar	*path)
+{
+	PDirRemoveNode *node;
+
+	if (P_UNLIKELY ((node = p_malloc0 (sizeof (PDirRemoveNode))) == NULL))
+		return NULL;
+
+	if (P_UNLIKELY ((node->path = p_strdup (path)) == NULL)) {
+		p_free (node);
+		return NULL;
+	}
+
+	node->tree   = tree;
+	node->parent = parent;
+	node->refs   = 1;
+
+	if (parent != NULL)
+		p_atomic_int_inc (&parent->refs);
+
+	return node;
+}
+
+/* The last reference removes the directory itself and releases the parent */
+static void
+pp_dir_remove_node_release (PDirRemoveNode *node)
+{
+	PDirRemoveNode	*parent;
+	PError		*error;
+
+	while (node != NULL && p_atomic_int_dec_and_test (&node->refs) == TRUE) {
+		error = NULL;
+
+		if (P_UNLIKELY (p_dir_remove_entry (NULL, NULL, node->path, TRUE, &error) == FALSE))
+			pp_dir_tree_fail (node->tree, error);
+
+		parent = node->parent;
+
+		p_free (node->path);
+		p_free (node);
+
+		node = parent;
+	}
+}
+
+/* Symbolic link to a directory is removed as a file instead of the node */
+static void
+pp_dir_remove_link (PDirRemoveNode	*node,
+		    PDir		*parent,
+		    const pchar		*name)
+{
+	PError *error = NULL;
+
+	if (P_UNLIKELY (p_dir_remove_entry (parent, name, node->path, FALSE, &error) == FALSE))
+		pp_dir_tree_fail (node->tree, error);
+
+	pp_dir_remove_node_release (node->parent);
+
+	p_free (node->path);
+	p_free (node);
+}
+
+static void
+pp_dir_remove_task (ppointer data)
+{
+	PDirRemoveNode	*node  = data;
+	PDirTree	*tree  = node->tree;
+	PDir		*dir;
+	PError		*error = NULL;
+	pboolean	is_link;
+
+	if ((dir = p_dir_open_subdir (NULL, NULL, node->path, &is_link, &error)) != NULL) {
+		pp_dir_remove_dir (node, dir);
+		p_dir_free (dir);
+		pp_dir_remove_node_release (node);
+	} else if (is_link == TRUE)
+		pp_dir_remove_link (node, NULL, NULL);
+	else {
+		pp_dir_tree_fail (tree, error);
+		pp_dir_remove_node_release (node);
+	}
+
+	pp_dir_tree_task_done (tree);
+}
+
+static void
+pp_dir_remove_dir (PDirRemoveNode	*node,
+		   PDir			*dir)
+{
+	PDirEntry	entries[P_DIR_TREE_BATCH_SIZE];
+	PDirRemoveNode	*child;
+	PDirTree	*tree  = node->tree;
+	PDir		*subdir;
+	PError		*error = NULL;
+	pchar		*entry_path;
+	pboolean	is_link;
+	pssize		count;
+	pssize		i;
+
+	while ((count = p_dir_get_next_entries (dir, entries, P_DIR_TREE_BATCH_SIZE, &error)) > 0) {
+		for (i = 0; i < count; ++i) {
+			if (strcmp (entries[i].name, ".") == 0 || strcmp (entries[i].name, "..") == 0)
+				continue;
+
+			if (P_UNLIKELY ((entry_path = pp_dir_join_path (node->path, entries[i].name)) == NULL)) {
+				pp_dir_tree_fail (tree,
+						  p_error_new_literal ((pint) P_ERROR_IO_NO_RESOURCES,
+								       0,
+								       "Failed to allocate memory for entry path"));
+				continue;
+			}
+
+			if (entries[i].type != P_DIR_ENTRY_TYPE_DIR) {
+				if (P_UNLIKELY (p_dir_remove_entry (dir,
+								    entries[i].name,
+								    entry_path,
+								    FALSE,
+								    &error) == FALSE)) {
+					pp_dir_tree_fail (tree, error);
+					error = NULL;
+				}
+
+				p_free (entry_path);
+				continue;
+			}
+
+			if (P_UNLIKELY ((child = pp_dir_remove_node_new (tree, node, entry_path)) == NULL)) {
+				pp_dir_tree_fail (tree,
+						  p_error_new_literal ((pint) P_ERROR_IO_NO_RESOURCES,
+								       0,
+								       "Failed to allocate memory for directory node"));
+				p_free (entry_path);
+				continue;
+			}
+
+			if (tree->pool != NULL && p_atomic_int_get (&tree->tasks) < tree->max_tasks) {
+				p_atomic_int_inc (&tree->tasks);
+
+				if (P_LIKELY (p_thread_pool_push (tree->pool, pp_dir_remove_task, child) == TRUE)) {
+					p_free (entry_path);
+					continue;
+				}
+
+				p_atomic_int_add (&tree->tasks, -1);
+			}
+
+			if ((subdir = p_dir_open_subdir (dir, entries[i].name, entry_path, &is_link, &error)) != NULL) {
+				pp_dir_remove_dir (child, subdir);
+				p_dir_free (subdir);
+				pp_dir_remove_node_release (child);
+			} else if (is_link == TRUE)
+				pp_dir_remove_link (child, dir, entries[i].name);
+			else {
+				pp_dir_tree_fail (tree, error);
+				error = NULL;
+				pp_dir_remove_node_release (child);
+			}
+
+			p_free (entry_path);
+		}
+	}
+
+	if (P_UNLIKELY (count < 0))
+		pp_dir_tree_fail (tree, error);
+}
+
+/* Directories are reported before their contents, so the target directory
+ * exists before any of its entries is copied */
+static PDirWalkResult
+pp_dir_copy_entry (const PDirWalkEntry	*entry,
+		   ppointer		user_data)
+{
+	PDirCopy	*copy  = user_data;
+	PError		*error = NULL;
+	pchar		*dst_path;
+	pboolean	result;
+
+	if (entry->type != P_DIR_ENTRY_TYPE_DIR && entry->type != P_DIR_ENTRY_TYPE_FILE)
+		return P_DIR_WALK_CONTINUE;
+
+	if (P_UNLIKELY ((dst_path = pp_dir_join_path (copy->dst, entry->path + copy->src_len)) == NULL)) {
+		pp_dir_tree_fail (copy->tree,
+				  p_error_new_literal ((pint) P_ERROR_IO_NO_RESOURCES,
+						       0,
+						       "Failed to allocate memory for entry path"));
+		return P_DIR_WALK_SKIP;
+	}
+
+	if (entry->type == P_DIR_ENTRY_TYPE_DIR)
+		result = p_dir_create (dst_path, 0777, &error);
+	else
+		result = p_file_copy (entry->path,
+				      dst_path,
+				      P_FILE_COPY_FLAG_OVERWRITE,
+				      &error) != P_FILE_COPY_METHOD_NONE;
+
+	p_free (dst_path);
+
+	if (P_UNLIKELY (result == FALSE)) {
+		pp_dir_tree_fail (copy->tree, error);
+		return P_DIR_WALK_SKIP;
+	}
+
+	return P_DIR_WALK_CONTINUE;
+}
+
+P_LIB_API pboolean
+p_dir_walk (const pchar		*path,
+	    puint		flags,
+	    PThreadPool		*pool,
+	    PDirWalkFunc	func,
+	    ppointer		user_data,
+	    PError		**error)
+{
+	PDirWalk	walk;
+	PDir		*dir;
+
+	if (P_UNLIKELY (path == NULL || func == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY ((dir = p_dir_new (path, error)) == NULL))
+		return FALSE;
+
+	memset (&walk, 0, sizeof (walk));
+
+	if (P_UNLIKELY (pp_dir_tree_init (&walk.tree, pool, error) == FALSE)) {
+		p_dir_free (dir);
+		return FALSE;
+	}
+
+	walk.flags     = flags;
+	walk.func      = func;
+	walk.user_data = user_data;
+
+	pp_dir_walk_dir (&walk, dir, path, 0);
+
+	p_dir_free (dir);
+
+	return pp_dir_tree_finish (&walk.tree, error);
+}
+
+P_LIB_API pboolean
+p_dir_remove_recursive (const pchar	*path,
+			PThreadPool	*pool,
+			PError		**error)
+{
+	PDirRemoveNode	*root;
+	PDirTree	tree;
+	PDir		*dir;
+
+	if (P_UNLIKELY (path == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY ((dir = p_dir_new (path, error)) == NULL))
+		return FALSE;
+
+	if (P_UNLIKELY (pp_dir_tree_init (&tree, pool, error) == FALSE)) {
+		p_dir_free (dir);
+		return FALSE;
+	}
+
+	if (P_UNLIKELY ((root = pp_dir_remove_node_new (&tree, NULL, path)) == NULL)) {
+		pp_dir_tree_fail (&tree,
+				  p_error_new_literal ((pint) P_ERROR_IO_NO_RESOURCES,
+						       0,
+						       "Failed to allocate memory for directory node"));
+		p_dir_free (dir);
+		return pp_dir_tree_finish (&tree, error);
+	}
+
+	pp_dir_remove_dir (root, dir);
+
+	/* Handle must be closed before removing the directory on Windows */
+	p_dir_free (dir);
+
+	pp_dir_remove_node_release (root);
+
+	return pp_dir_tree_finish (&tree, error);
+}
+
+P_LIB_API pboolean
+p_dir_copy_recursive (const pchar	*src,
+		      const pchar	*dst,
+		      PThreadPool	*pool,
+		      PError		**error)
+{
+	PDirCopy	copy;
+	PDirTree	tree;
+	pboolean	result;
+
+	if (P_UNLIKELY (src == NULL || dst == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (p_dir_is_exists (src) == FALSE)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NOT_EXISTS,
+				     0,
+				     "Specified directory doesn't exist");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (p_dir_create (dst, 0777, error) == FALSE))
+		return FALSE;
+
+	/* Copy errors are collected here, the walk reports its own */
+	memset (&tree, 0, sizeof (tree));
+
+	copy.tree    = &tree;
+	copy.src     = src;
+	copy.src_len = strlen (src);
+	copy.dst     = dst;
+
+	if (pool != NULL && P_UNLIKELY ((tree.mutex = p_mutex_new ()) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for tree synchronization");
+		return FALSE;
+	}
+
+	result = p_dir_walk (src, P_DIR_WALK_FLAG_NONE, pool, pp_dir_copy_entry, &copy, error);
+
+	if (tree.mutex != NULL)
+		p_mutex_free (tree.mutex);
+
+	if (tree.error != NULL) {
+		if (error != NULL && *error == NULL)
+			*error = tree.error;
+		else
+			p_error_free (tree.error);
+	}
+
+	return result == TRUE && tree.failed == FALSE;
+}
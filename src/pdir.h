@@ -40,6 +40,21 @@
  * read with the p_dir_get_next_entry() call until it returns NULL (though it's
  * better to check an error code to be sure no error occurred).
  *
+ * Huge directories are read faster with p_dir_get_next_entries(), which fills
+ * a caller provided array with a number of entries per call and doesn't
+ * allocate memory for every entry. On Linux and FreeBSD it reads the raw
+ * directory records with getdents64() and getdirentries() into a large
+ * buffer, on Windows it asks the system to fetch the entries in large
+ * batches.
+ *
+ * A whole directory tree can be traversed with p_dir_walk(), which calls a
+ * function for every entry and lets it skip subdirectories. Given a
+ * #PThreadPool, the walk spreads the subdirectories across its workers, which
+ * keeps many metadata requests in flight on network file systems and SSDs.
+ *
+ * A whole tree is removed with p_dir_remove_recursive() and copied with
+ * p_dir_copy_recursive(), both of which can use a #PThreadPool as well.
+ *
  * Also some directory manipulation routines are provided to create, remove and
  * check existance.
  */
@@ -54,6 +69,7 @@
 #include "pmacros.h"
 #include "ptypes.h"
 #include "perror.h"
+#include "pthreadpool.h"
 
 P_BEGIN_DECLS
 
@@ -73,6 +89,38 @@ typedef struct PDirEntry_ {
 	PDirEntryType	type;	/**< Type.	*/
 } PDirEntry;
 
+/** Flags for p_dir_walk(). */
+typedef enum PDirWalkFlags_ {
+	P_DIR_WALK_FLAG_NONE	= 0,		/**< No flags.					*/
+	P_DIR_WALK_FLAG_STAT	= 1 << 0	/**< Fill the size and the modification time.	*/
+} PDirWalkFlags;
+
+/** Return values of a #PDirWalkFunc function. */
+typedef enum PDirWalkResult_ {
+	P_DIR_WALK_CONTINUE	= 0,	/**< Continue the walk.				*/
+	P_DIR_WALK_SKIP		= 1,	/**< Don't descend into the current directory.	*/
+	P_DIR_WALK_STOP		= 2	/**< Stop the whole walk.			*/
+} PDirWalkResult;
+
+/** Entry of a directory tree passed to a #PDirWalkFunc function. */
+typedef struct PDirWalkEntry_ {
+	const pchar	*path;		/**< Path of the entry, starts with the walk path.	*/
+	const pchar	*name;		/**< Name of the entry.					*/
+	PDirEntryType	type;		/**< Type of the entry.					*/
+	pint		depth;		/**< Depth, 0 for the entries of the walk path.		*/
+	pboolean	has_stat;	/**< Whether @a size and @a mtime are filled.		*/
+	puint64		size;		/**< Size in bytes.					*/
+	pint64		mtime;		/**< Modification time, seconds since the Epoch.	*/
+} PDirWalkEntry;
+
+/**
+ * @brief Function called by p_dir_walk() for every entry.
+ * @param entry Entry info, valid only during the call.
+ * @param user_data Data passed to p_dir_walk().
+ * @return Whether to continue the walk.
+ */
+typedef PDirWalkResult (*PDirWalkFunc) (const PDirWalkEntry *entry, ppointer user_data);
+
 /**
  * @brief Creates a new #PDir object.
  * @param path Directory path.
@@ -140,7 +188,12 @@ P_LIB_API pchar *	p_dir_get_path		(const PDir	*dir);
  * @since 0.0.1
  *
  * Caller takes ownership of the returned object. Use p_dir_entry_free() to free
- * memory of the directory entry after usage.
+ * memory of the directory entry after usage. The entry and its name are
+ * allocated with a single memory block.
+ *
+ * Every call allocates memory, use p_dir_get_next_entries() for large scans:
+ * it reuses the caller provided array and a per-directory name buffer, so
+ * there is no allocation per entry.
  *
  * An error is set only if it is occurred. You should check the @a error object
  * for #P_ERROR_IO_NO_MORE code.
@@ -148,6 +201,118 @@ P_LIB_API pchar *	p_dir_get_path		(const PDir	*dir);
 P_LIB_API PDirEntry *	p_dir_get_next_entry	(PDir		*dir,
 						 PError		**error);
 
+/**
+ * @brief Gets a number of the next directory entries at once.
+ * @param dir Directory to get the next entries from.
+ * @param[out] entries Array to store the entries in.
+ * @param max Number of elements in the @a entries array.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Number of stored entries in case of success, 0 if there are no more
+ * entries, -1 otherwise.
+ * @since 0.0.5
+ *
+ * Entry names are owned by the @a dir and remain valid until the next call of
+ * this function, p_dir_rewind() or p_dir_free(), so the entries must not be
+ * freed with p_dir_entry_free(). Copy the names you need to keep.
+ *
+ * Less than @a max entries may be returned even if the directory has more,
+ * i.e. when the internal buffer ends. Keep calling the function until it
+ * returns 0.
+ *
+ * Don't mix this function with p_dir_get_next_entry() on the same @a dir
+ * without p_dir_rewind() in between, as they may buffer the entries
+ * differently.
+ */
+P_LIB_API pssize	p_dir_get_next_entries	(PDir		*dir,
+						 PDirEntry	*entries,
+						 psize		max,
+						 PError		**error);
+
+/**
+ * @brief Walks through a directory tree.
+ * @param path Directory path to walk through.
+ * @param flags Walk flags, a combination of #PDirWalkFlags.
+ * @param pool #PThreadPool to walk the subdirectories in parallel, NULL to
+ * walk in the calling thread.
+ * @param func Function to call for every entry.
+ * @param user_data Data to pass to @a func.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The @a func is called for a directory before its entries, returning
+ * #P_DIR_WALK_SKIP for it prunes the subtree. Symbolic links to directories
+ * are reported but not descended into where the system can tell them apart.
+ *
+ * Subdirectories are opened relative to their parent handle where supported
+ * (openat()), so the full paths are not resolved again for every level.
+ *
+ * With a @a pool the @a func is called concurrently from the pool workers and
+ * the caller, so it must be thread-safe, and the order of the entries is not
+ * defined. The call returns when the whole tree has been walked. The pool must
+ * not be shut down during the walk, and the function must not be called from
+ * a worker of the same @a pool.
+ *
+ * A subdirectory which can't be read doesn't stop the walk: the rest of the
+ * tree is walked, and FALSE is returned with the first such error. Stopping
+ * the walk with #P_DIR_WALK_STOP is not an error.
+ */
+P_LIB_API pboolean	p_dir_walk		(const pchar	*path,
+						 puint		flags,
+						 PThreadPool	*pool,
+						 PDirWalkFunc	func,
+						 ppointer	user_data,
+						 PError		**error);
+
+/**
+ * @brief Removes a directory with all its contents.
+ * @param path Directory path to remove.
+ * @param pool #PThreadPool to remove the subdirectories in parallel, NULL to
+ * remove in the calling thread.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The entries are removed relative to their parent directory handle where
+ * supported (unlinkat()), and the entry types reported by the directory
+ * listing are used, so no additional stat() call is made for most of the
+ * entries. Symbolic links are removed themselves, their targets are left
+ * intact.
+ *
+ * A directory is removed once all its subdirectories are, possibly by
+ * different pool workers. The pool must not be shut down during the call,
+ * and the function must not be called from a worker of the same @a pool.
+ *
+ * An entry which can't be removed doesn't stop the call: the rest of the
+ * tree is removed, and FALSE is returned with the first such error.
+ */
+P_LIB_API pboolean	p_dir_remove_recursive	(const pchar	*path,
+						 PThreadPool	*pool,
+						 PError		**error);
+
+/**
+ * @brief Copies a directory with all its contents.
+ * @param src Directory path to copy.
+ * @param dst Target directory path, created if it doesn't exist.
+ * @param pool #PThreadPool to copy the subdirectories in parallel, NULL to
+ * copy in the calling thread.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The tree is traversed with p_dir_walk(), so the same pool restrictions
+ * apply. Regular files are copied with p_file_copy(), so they are cloned
+ * where the file system allows, existing target files are overwritten. Entries of other types are skipped, and symbolic links to
+ * directories are copied as empty directories.
+ *
+ * A file which can't be copied doesn't stop the call: the rest of the tree is
+ * copied, and FALSE is returned with the first such error.
+ */
+P_LIB_API pboolean	p_dir_copy_recursive	(const pchar	*src,
+						 const pchar	*dst,
+						 PThreadPool	*pool,
+						 PError		**error);
+
 /**
  * @brief Resets a directory entry pointer.
  * @param dir Directory to reset the entry pointer.
@@ -0,0 +1,1049 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* The events are collected by a thread and put into a list under the mutex.
+ * The thread sends a datagram to the wake socket when the list becomes
+ * signaled, and the reader drains the socket only when it empties the list,
+ * under the same mutex, so a pending event always has a datagram after it. */
+
+#include "patomic.h"
+#include "pdir.h"
+#include "pdirwatcher.h"
+#include "pfile.h"
+#include "pmem.h"
+#include "pmutex.h"
+#include "psocketaddress.h"
+#include "pstring.h"
+#include "puthread.h"
+#include "perror-private.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined (P_OS_WIN)
+#  define P_DIR_WATCHER_USE_WIN
+#elif defined (PLIBSYS_HAS_INOTIFY)
+#  define P_DIR_WATCHER_USE_INOTIFY
+#  include <sys/inotify.h>
+#elif defined (PLIBSYS_HAS_KQUEUE)
+#  define P_DIR_WATCHER_USE_KQUEUE
+#  include <sys/types.h>
+#  include <sys/event.h>
+#  include <sys/time.h>
+#else
+#  define P_DIR_WATCHER_USE_SCAN
+#endif
+
+#if defined (P_DIR_WATCHER_USE_KQUEUE) || defined (P_DIR_WATCHER_USE_SCAN)
+#  define P_DIR_WATCHER_USE_SNAPSHOT
+#  include "pdir-private.h"
+#endif
+
+#ifndef P_OS_WIN
+#  include "psysclose-private.h"
+
+#  include <errno.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif
+
+/* Pending events above this number are dropped */
+#define P_DIR_WATCHER_MAX_EVENTS	4096
+
+/* Size of the buffer for the system event records */
+#define P_DIR_WATCHER_BUF_SIZE		(64 * 1024)
+
+/* Interval to list the directory again, in milliseconds */
+#define P_DIR_WATCHER_SCAN_INTERVAL	1000
+
+/* Step to check for the stop request while waiting, in milliseconds */
+#define P_DIR_WATCHER_SCAN_STEP		50
+
+/* Number of entries read from the directory per call while listing */
+#define P_DIR_WATCHER_BATCH_SIZE	64
+
+typedef struct PDirWatcherNode_ {
+	struct PDirWatcherNode_	*next;
+	PDirWatcherEventType	type;
+	puint32			cookie;
+	pchar			*name;
+} PDirWatcherNode;
+
+#ifdef P_DIR_WATCHER_USE_SNAPSHOT
+typedef struct PDirWatcherItem_ {
+	pchar	*name;
+	puint64	size;
+	pint64	mtime;
+} PDirWatcherItem;
+
+typedef struct PDirWatcherSnapshot_ {
+	PDirWatcherItem	*items;
+	psize		count;
+} PDirWatcherSnapshot;
+#endif
+
+struct PDirWatcher_ {
+	pchar			*path;
+	PUThread		*thread;
+	PMutex			*mutex;
+	PDirWatcherNode		*head;
+	PDirWatcherNode		*tail;
+	PDirWatcherNode		*delivered;
+	pint			queued;
+	pboolean		overflowed;
+	pboolean		signaled;
+	PSocket			*wake_socket;
+	PSocketAddress		*wake_address;
+	pchar			*buffer;
+#if defined (P_DIR_WATCHER_USE_WIN)
+	HANDLE			dir;
+	HANDLE			stop_event;
+	OVERLAPPED		overlapped;
+	puint32			cookie;
+#elif defined (P_DIR_WATCHER_USE_INOTIFY)
+	pint			fd;
+	pint			wd;
+#elif defined (P_DIR_WATCHER_USE_KQUEUE)
+	pint			kqueue_fd;
+	pint			dir_fd;
+	pint			stop_pipe[2];
+#endif
+#ifdef P_DIR_WATCHER_USE_SNAPSHOT
+	PDirWatcherSnapshot	snapshot;
+#endif
+#ifdef P_DIR_WATCHER_USE_SCAN
+	volatile pint		stopped;
+#endif
+};
+
+static pboolean pp_dir_watcher_wake_init (PDirWatcher *watcher, PError **error);
+static void pp_dir_watcher_push (PDirWatcher *watcher, PDirWatcherEventType type, const pchar *name, puint32 cookie);
+static void pp_dir_watcher_free_nodes (PDirWatcherNode *node);
+#ifdef P_DIR_WATCHER_USE_SNAPSHOT
+static pint pp_dir_watcher_item_compare (const void *a, const void *b);
+static void pp_dir_watcher_snapshot_clear (PDirWatcherSnapshot *snapshot);
+static pboolean pp_dir_watcher_snapshot_take (const pchar *path, PDirWatcherSnapshot *snapshot, PError **error);
+static pboolean pp_dir_watcher_rescan (PDirWatcher *watcher);
+#endif
+static pboolean pp_dir_watcher_sys_init (PDirWatcher *watcher, PError **error);
+static void pp_dir_watcher_sys_stop (PDirWatcher *watcher);
+static void pp_dir_watcher_sys_close (PDirWatcher *watcher);
+static ppointer pp_dir_watcher_thread (ppointer data);
+
+static pboolean
+pp_dir_watcher_wake_init (PDirWatcher	*watcher,
+			  PError	**error)
+{
+	PSocketAddress *address = NULL;
+
+	/* Loopback datagram socket wakes up the poller from the thread */
+	watcher->wake_socket = p_socket_new (P_SOCKET_FAMILY_INET,
+					     P_SOCKET_TYPE_DATAGRAM,
+					     P_SOCKET_PROTOCOL_UDP,
+					     error);
+
+	if (P_LIKELY (watcher->wake_socket != NULL)) {
+		if (P_UNLIKELY ((address = p_socket_address_new ("127.0.0.1", 0)) == NULL))
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IO_NO_RESOURCES,
+					     0,
+					     "Failed to allocate memory for socket address");
+	}
+
+	if (P_UNLIKELY (address == NULL ||
+			p_socket_bind (watcher->wake_socket, address, FALSE, error) == FALSE ||
+			(watcher->wake_address = p_socket_get_local_address (watcher->wake_socket, error)) == NULL)) {
+		if (address != NULL)
+			p_socket_address_free (address);
+
+		return FALSE;
+	}
+
+	p_socket_address_free (address);
+	p_socket_set_blocking (watcher->wake_socket, FALSE);
+
+	return TRUE;
+}
+
+/* Runs in the watcher thread */
+static void
+pp_dir_watcher_push (PDirWatcher		*watcher,
+		     PDirWatcherEventType	type,
+		     const pchar		*name,
+		     puint32			cookie)
+{
+	PDirWatcherNode	*node;
+	psize		name_len;
+	pboolean	wake = FALSE;
+	pchar		byte = 0;
+
+	p_mutex_lock (watcher->mutex);
+
+	if (type == P_DIR_WATCHER_EVENT_MODIFIED &&
+	    name != NULL &&
+	    watcher->tail != NULL &&
+	    watcher->tail->type == P_DIR_WATCHER_EVENT_MODIFIED &&
+	    watcher->tail->name != NULL &&
+	    strcmp (watcher->tail->name, name) == 0) {
+		p_mutex_unlock (watcher->mutex);
+		return;
+	}
+
+	if (watcher->queued >= P_DIR_WATCHER_MAX_EVENTS) {
+		if (watcher->overflowed == TRUE) {
+			p_mutex_unlock (watcher->mutex);
+			return;
+		}
+
+		type                = P_DIR_WATCHER_EVENT_OVERFLOW;
+		name                = NULL;
+		cookie              = 0;
+		watcher->overflowed = TRUE;
+	}
+
+	name_len = name != NULL ? strlen (name) + 1 : 0;
+
+	if (P_UNLIKELY ((node = p_malloc0 (sizeof (PDirWatcherNode) + name_len)) == NULL)) {
+		p_mutex_unlock (watcher->mutex);
+		P_WARNING ("PDirWatcher::pp_dir_watcher_push: failed to allocate memory");
+		return;
+	}
+
+	node->type   = type;
+	node->cookie = cookie;
+
+	if (name != NULL) {
+		node->name = (pchar *) (node + 1);
+		memcpy (node->name, name, name_len);
+	}
+
+	if (watcher->tail != NULL)
+		watcher->tail->next = node;
+	else
+		watcher->head = node;
+
+	watcher->tail = node;
+	++watcher->queued;
+
+	if (watcher->signaled == FALSE) {
+		watcher->signaled = TRUE;
+		wake              = TRUE;
+	}
+
+	p_mutex_unlock (watcher->mutex);
+
+	if (wake)
+		p_socket_send_to (watcher->wake_socket, watcher->wake_address, &byte, 1, NULL);
+}
+
+static void
+pp_dir_watcher_free_nodes (PDirWatcherNode *node)
+{
+	PDirWatcherNode *next;
+
+	while (node != NULL) {
+		next = node->next;
+		p_free (node);
+		node = next;
+	}
+}
+
+#ifdef P_DIR_WATCHER_USE_SNAPSHOT
+static pint
+pp_dir_watcher_item_compare (const void	*a,
+			     const void	*b)
+{
+	return strcmp (((const PDirWatcherItem *) a)->name, ((const PDirWatcherItem *) b)->name);
+}
+
+static void
+pp_dir_watcher_snapshot_clear (PDirWatcherSnapshot *snapshot)
+{
+	psize i;
+
+	for (i = 0; i < snapshot->count; ++i)
+		p_free (snapshot->items[i].name);
+
+	if (snapshot->items != NULL)
+		p_free (snapshot->items);
+
+	snapshot->items = NULL;
+	snapshot->count = 0;
+}
+
+/* Lists the directory into a snapshot sorted by name */
+static pboolean
+pp_dir_watcher_snapshot_take (const pchar		*path,
+			      PDirWatcherSnapshot	*snapshot,
+			      PError			**error)
+{
+	PDirEntry	entries[P_DIR_WATCHER_BATCH_SIZE];
+	PDirWatcherItem	*items;
+	PDirWatcherItem	*item;
+	PDir		*dir;
+	pchar		*entry_path;
+	psize		size     = 0;
+	psize		path_len = strlen (path);
+	pssize		count;
+	pssize		i;
+
+	memset (snapshot, 0, sizeof (PDirWatcherSnapshot));
+
+	if (P_UNLIKELY ((dir = p_dir_new (path, error)) == NULL))
+		return FALSE;
+
+	while ((count = p_dir_get_next_entries (dir, entries, P_DIR_WATCHER_BATCH_SIZE, error)) > 0) {
+		for (i = 0; i < count; ++i) {
+			if (strcmp (entries[i].name, ".") == 0 || strcmp (entries[i].name, "..") == 0)
+				continue;
+
+			if (snapshot->count == size) {
+				size  = size == 0 ? P_DIR_WATCHER_BATCH_SIZE : size * 2;
+				items = p_realloc (snapshot->items, size * sizeof (PDirWatcherItem));
+
+				if (P_UNLIKELY (items == NULL))
+					break;
+
+				snapshot->items = items;
+			}
+
+			item = &snapshot->items[snapshot->count];
+
+			if (P_UNLIKELY ((item->name = p_strdup (entries[i].name)) == NULL))
+				break;
+
+			entry_path = p_malloc (path_len + strlen (entries[i].name) + 2);
+
+			if (P_UNLIKELY (entry_path == NULL)) {
+				p_free (item->name);
+				break;
+			}
+
+			memcpy (entry_path, path, path_len);
+			entry_path[path_len] = P_DIR_SEPARATOR[0];
+			strcpy (entry_path + path_len + 1, entries[i].name);
+
+			if (p_dir_get_entry_stat (dir, entries[i].name, entry_path, &item->size, &item->mtime) == FALSE) {
+				item->size  = 0;
+				item->mtime = 0;
+			}
+
+			p_free (entry_path);
+			++snapshot->count;
+		}
+
+		if (P_UNLIKELY (i < count)) {
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IO_NO_RESOURCES,
+					     0,
+					     "Failed to allocate memory for directory listing");
+			count = -1;
+			break;
+		}
+	}
+
+	p_dir_free (dir);
+
+	if (P_UNLIKELY (count < 0)) {
+		pp_dir_watcher_snapshot_clear (snapshot);
+		return FALSE;
+	}
+
+	if (snapshot->count > 1)
+		qsort (snapshot->items, snapshot->count, sizeof (PDirWatcherItem), pp_dir_watcher_item_compare);
+
+	return TRUE;
+}
+
+/* Lists the directory again and reports the difference with the previous
+ * listing, returns FALSE when the directory is gone */
+static pboolean
+pp_dir_watcher_rescan (PDirWatcher *watcher)
+{
+	PDirWatcherSnapshot	snapshot;
+	PDirWatcherSnapshot	*old = &watcher->snapshot;
+	psize			i    = 0;
+	psize			j    = 0;
+	pint			cmp;
+
+	if (P_UNLIKELY (pp_dir_watcher_snapshot_take (watcher->path, &snapshot, NULL) == FALSE)) {
+		if (p_dir_is_exists (watcher->path) == FALSE) {
+			pp_dir_watcher_push (watcher, P_DIR_WATCHER_EVENT_DELETED, NULL, 0);
+			return FALSE;
+		}
+
+		pp_dir_watcher_push (watcher, P_DIR_WATCHER_EVENT_OVERFLOW, NULL, 0);
+		return TRUE;
+	}
+
+	while (i < old->count || j < snapshot.count) {
+		if (i == old->count)
+			cmp = 1;
+		else if (j == snapshot.count)
+			cmp = -1;
+		else
+			cmp = strcmp (old->items[i].name, snapshot.items[j].name);
+
+		if (cmp < 0)
+			pp_dir_watcher_push (watcher, P_DIR_WATCHER_EVENT_DELETED, old->items[i++].name, 0);
+		else if (cmp > 0)
+			pp_dir_watcher_push (watcher, P_DIR_WATCHER_EVENT_CREATED, snapshot.items[j++].name, 0);
+		else {
+			if (old->items[i].size != snapshot.items[j].size ||
+			    old->items[i].mtime != snapshot.items[j].mtime)
+				pp_dir_watcher_push (watcher, P_DIR_WATCHER_EVENT_MODIFIED, snapshot.items[j].name, 0);
+
+			++i;
+			++j;
+		}
+	}
+
+	pp_dir_watcher_snapshot_clear (old);
+	*old = snapshot;
+
+	return TRUE;
+}
+#endif /* P_DIR_WATCHER_USE_SNAPSHOT */
+
+#if defined (P_DIR_WATCHER_USE_WIN)
+static pboolean
+pp_dir_watcher_sys_init (PDirWatcher	*watcher,
+			 PError		**error)
+{
+	watcher->dir        = INVALID_HANDLE_VALUE;
+	watcher->stop_event = NULL;
+
+	if (P_UNLIKELY ((watcher->buffer = p_malloc (P_DIR_WATCHER_BUF_SIZE)) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for event buffer");
+		return FALSE;
+	}
+
+	watcher->dir = CreateFileA (watcher->path,
+				    FILE_LIST_DIRECTORY,
+				    FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+				    NULL,
+				    OPEN_EXISTING,
+				    FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,
+				    NULL);
+
+	if (P_UNLIKELY (watcher->dir == INVALID_HANDLE_VALUE)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call CreateFileA() to open directory");
+		return FALSE;
+	}
+
+	watcher->overlapped.hEvent = CreateEventA (NULL, TRUE, FALSE, NULL);
+	watcher->stop_event        = CreateEventA (NULL, TRUE, FALSE, NULL);
+
+	if (P_UNLIKELY (watcher->overlapped.hEvent == NULL || watcher->stop_event == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call CreateEventA() to create event");
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static void
+pp_dir_watcher_sys_stop (PDirWatcher *watcher)
+{
+	SetEvent (watcher->stop_event);
+}
+
+static void
+pp_dir_watcher_sys_close (PDirWatcher *watcher)
+{
+	if (watcher->dir != INVALID_HANDLE_VALUE)
+		CloseHandle (watcher->dir);
+
+	if (watcher->overlapped.hEvent != NULL)
+		CloseHandle (watcher->overlapped.hEvent);
+
+	if (watcher->stop_event != NULL)
+		CloseHandle (watcher->stop_event);
+}
+
+static ppointer
+pp_dir_watcher_thread (ppointer data)
+{
+	PDirWatcher		*watcher = data;
+	FILE_NOTIFY_INFORMATION	*info;
+	HANDLE			handles[2];
+	DWORD			bytes;
+	DWORD			offset;
+	pchar			name[MAX_PATH * 3 + 1];
+	pint			name_len;
+	puint32			cookie   = 0;
+
+	handles[0] = watcher->stop_event;
+	handles[1] = watcher->overlapped.hEvent;
+
+	for (;;) {
+		ResetEvent (watcher->overlapped.hEvent);
+
+		if (P_UNLIKELY (ReadDirectoryChangesW (watcher->dir,
+						       watcher->buffer,
+						       P_DIR_WATCHER_BUF_SIZE,
+						       FALSE,
+						       FILE_NOTIFY_CHANGE_FILE_NAME  |
+						       FILE_NOTIFY_CHANGE_DIR_NAME   |
+						       FILE_NOTIFY_CHANGE_ATTRIBUTES |
+						       FILE_NOTIFY_CHANGE_SIZE       |
+						       FILE_NOTIFY_CHANGE_LAST_WRITE,
+						       NULL,
+						       &watcher->overlapped,
+						       NULL) == 0)) {
+			pp_dir_watcher_push (watcher, P_DIR_WATCHER_EVENT_DELETED, NULL, 0);
+			break;
+		}
+
+		if (WaitForMultipleObjects (2, handles, FALSE, INFINITE) != WAIT_OBJECT_0 + 1) {
+			CancelIo (watcher->dir);
+			GetOverlappedResult (watcher->dir, &watcher->overlapped, &bytes, TRUE);
+			break;
+		}
+
+		if (P_UNLIKELY (GetOverlappedResult (watcher->dir, &watcher->overlapped, &bytes, FALSE) == 0)) {
+			/* The directory is being deleted */
+			pp_dir_watcher_push (watcher, P_DIR_WATCHER_EVENT_DELETED, NULL, 0);
+			break;
+		}
+
+		/* The system buffer has overflowed */
+		if (bytes == 0) {
+			pp_dir_watcher_push (watcher, P_DIR_WATCHER_EVENT_OVERFLOW, NULL, 0);
+			continue;
+		}
+
+		offset = 0;
+
+		do {
+			info     = (FILE_NOTIFY_INFORMATION *) (watcher->buffer + offset);
+			name_len = WideCharToMultiByte (CP_ACP,
+							0,
+							info->FileName,
+							(int) (info->FileNameLength / sizeof (WCHAR)),
+							name,
+							(int) sizeof (name) - 1,
+							NULL,
+							NULL);
+
+			name[name_len > 0 ? name_len : 0] = '\0';
+
+			switch (info->Action) {
+			case FILE_ACTION_ADDED:
+				pp_dir_watcher_push (watcher, P_DIR_WATCHER_EVENT_CREATED, name, 0);
+				break;
+			case FILE_ACTION_REMOVED:
+				pp_dir_watcher_push (watcher, P_DIR_WATCHER_EVENT_DELETED, name, 0);
+				break;
+			case FILE_ACTION_MODIFIED:
+				pp_dir_watcher_push (watcher, P_DIR_WATCHER_EVENT_MODIFIED, name, 0);
+				break;
+			case FILE_ACTION_RENAMED_OLD_NAME:
+				/* The new name always follows the old one */
+				cookie = ++watcher->cookie;
+				pp_dir_watcher_push (watcher, P_DIR_WATCHER_EVENT_RENAMED_FROM, name, cookie);
+				break;
+			case FILE_ACTION_RENAMED_NEW_NAME:
+				pp_dir_watcher_push (watcher, P_DIR_WATCHER_EVENT_RENAMED_TO, name, cookie);
+				break;
+			default:
+				break;
+			}
+
+			offset += info->NextEntryOffset;
+		} while (info->NextEntryOffset != 0);
+	}
+
+	return NULL;
+}
+#elif defined (P_DIR_WATCHER_USE_INOTIFY)
+static pboolean
+pp_dir_watcher_sys_init (PDirWatcher	*watcher,
+			 PError		**error)
+{
+	puint32 mask;
+
+	watcher->fd = -1;
+	watcher->wd = -1;
+
+	if (P_UNLIKELY ((watcher->buffer = p_malloc (P_DIR_WATCHER_BUF_SIZE)) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for event buffer");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY ((watcher->fd = inotify_init1 (IN_CLOEXEC)) < 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call inotify_init1() to create inotify instance");
+		return FALSE;
+	}
+
+	mask = IN_CREATE | IN_DELETE | IN_MODIFY | IN_ATTRIB | IN_MOVED_FROM | IN_MOVED_TO |
+	       IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+#  ifdef IN_EXCL_UNLINK
+	mask |= IN_EXCL_UNLINK;
+#  endif
+
+	if (P_UNLIKELY ((watcher->wd = inotify_add_watch (watcher->fd, watcher->path, mask)) < 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call inotify_add_watch() to watch directory");
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/* Removing the watch queues IN_IGNORED, which ends the thread */
+static void
+pp_dir_watcher_sys_stop (PDirWatcher *watcher)
+{
+	inotify_rm_watch (watcher->fd, watcher->wd);
+}
+
+static void
+pp_dir_watcher_sys_close (PDirWatcher *watcher)
+{
+	if (watcher->fd >= 0)
+		p_sys_close (watcher->fd);
+}
+
+static ppointer
+pp_dir_watcher_thread (ppointer data)
+{
+	PDirWatcher		*watcher = data;
+	struct inotify_event	*event;
+	const pchar		*name;
+	pssize			count;
+	pssize			offset;
+
+	for (;;) {
+		if ((count = read (watcher->fd, watcher->buffer, P_DIR_WATCHER_BUF_SIZE)) <= 0) {
+			if (count < 0 && errno == EINTR)
+				continue;
+
+			break;
+		}
+
+		for (offset = 0; offset < count; offset += (pssize) (sizeof (struct inotify_event) + event->len)) {
+			event = (struct inotify_event *) (watcher->buffer + offset);
+			name  = event->len > 0 ? event->name : NULL;
+
+			if (event->mask & IN_Q_OVERFLOW)
+				pp_dir_watcher_push (watcher, P_DIR_WATCHER_EVENT_OVERFLOW, NULL, 0);
+
+			if (event->mask & IN_IGNORED)
+				return NULL;
+
+			if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF)) {
+				pp_dir_watcher_push (watcher, P_DIR_WATCHER_EVENT_DELETED, NULL, 0);
+				continue;
+			}
+
+			if (name == NULL)
+				continue;
+
+			if (event->mask & IN_CREATE)
+				pp_dir_watcher_push (watcher, P_DIR_WATCHER_EVENT_CREATED, name, 0);
+			else if (event->mask & IN_DELETE)
+				pp_dir_watcher_push (watcher, P_DIR_WATCHER_EVENT_DELETED, name, 0);
+			else if (event->mask & (IN_MODIFY | IN_ATTRIB))
+				pp_dir_watcher_push (watcher, P_DIR_WATCHER_EVENT_MODIFIED, name, 0);
+			else if (event->mask & IN_MOVED_FROM)
+				pp_dir_watcher_push (watcher, P_DIR_WATCHER_EVENT_RENAMED_FROM, name, event->cookie);
+			else if (event->mask & IN_MOVED_TO)
+				pp_dir_watcher_push (watcher, P_DIR_WATCHER_EVENT_RENAMED_TO, name, event->cookie);
+		}
+	}
+
+	return NULL;
+}
+#elif defined (P_DIR_WATCHER_USE_KQUEUE)
+static pboolean
+pp_dir_watcher_sys_init (PDirWatcher	*watcher,
+			 PError		**error)
+{
+	struct kevent	changes[2];
+	pint		flags;
+	pint		i;
+
+	watcher->kqueue_fd    = -1;
+	watcher->dir_fd       = -1;
+	watcher->stop_pipe[0] = -1;
+	watcher->stop_pipe[1] = -1;
+
+	if (P_UNLIKELY (pp_dir_watcher_snapshot_take (watcher->path, &watcher->snapshot, error) == FALSE))
+		return FALSE;
+
+	flags = O_RDONLY;
+#  ifdef O_EVTONLY
+	flags = O_EVTONLY;
+#  endif
+#  ifdef O_DIRECTORY
+	flags |= O_DIRECTORY;
+#  endif
+#  ifdef O_CLOEXEC
+	flags |= O_CLOEXEC;
+#  endif
+
+	if (P_UNLIKELY ((watcher->dir_fd = open (watcher->path, flags)) < 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call open() to open directory");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (pipe (watcher->stop_pipe) != 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call pipe() to create stop pipe");
+		watcher->stop_pipe[0] = -1;
+		watcher->stop_pipe[1] = -1;
+		return FALSE;
+	}
+
+	for (i = 0; i < 2; ++i) {
+		flags = fcntl (watcher->stop_pipe[i], F_GETFD);
+
+		if (P_UNLIKELY (flags == -1 || fcntl (watcher->stop_pipe[i], F_SETFD, flags | FD_CLOEXEC) == -1))
+			P_WARNING ("PDirWatcher::pp_dir_watcher_sys_init: fcntl() with FD_CLOEXEC failed");
+	}
+
+	if (P_UNLIKELY ((watcher->kqueue_fd = kqueue ()) < 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call kqueue() to create kernel queue");
+		return FALSE;
+	}
+
+	EV_SET (&changes[0],
+		watcher->dir_fd,
+		EVFILT_VNODE,
+		EV_ADD | EV_CLEAR,
+		NOTE_WRITE | NOTE_EXTEND | NOTE_ATTRIB | NOTE_DELETE | NOTE_RENAME,
+		0,
+		0);
+
+	EV_SET (&changes[1], watcher->stop_pipe[0], EVFILT_READ, EV_ADD, 0, 0, 0);
+
+	if (P_UNLIKELY (kevent (watcher->kqueue_fd, changes, 2, NULL, 0, NULL) != 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call kevent() to watch directory");
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static void
+pp_dir_watcher_sys_stop (PDirWatcher *watcher)
+{
+	pchar byte = 0;
+
+	while (write (watcher->stop_pipe[1], &byte, 1) < 0 && errno == EINTR)
+		;
+}
+
+static void
+pp_dir_watcher_sys_close (PDirWatcher *watcher)
+{
+	if (watcher->kqueue_fd >= 0)
+		p_sys_close (watcher->kqueue_fd);
+
+	if (watcher->dir_fd >= 0)
+		p_sys_close (watcher->dir_fd);
+
+	if (watcher->stop_pipe[0] >= 0)
+		p_sys_close (watcher->stop_pipe[0]);
+
+	if (watcher->stop_pipe[1] >= 0)
+		p_sys_close (watcher->stop_pipe[1]);
+
+	pp_dir_watcher_snapshot_clear (&watcher->snapshot);
+}
+
+static ppointer
+pp_dir_watcher_thread (ppointer data)
+{
+	PDirWatcher	*watcher = data;
+	struct kevent	events[2];
+	struct timespec	timeout;
+	pint		count;
+	pint		i;
+
+	timeout.tv_sec  = P_DIR_WATCHER_SCAN_INTERVAL / 1000;
+	timeout.tv_nsec = (P_DIR_WATCHER_SCAN_INTERVAL % 1000) * 1000000L;
+
+	/* Files modified in place don't change the directory, so the listing is
+	 * also compared when the wait times out */
+	for (;;) {
+		if ((count = kevent (watcher->kqueue_fd, NULL, 0, events, 2, &timeout)) < 0) {
+			if (errno == EINTR)
+				continue;
+
+			break;
+		}
+
+		for (i = 0; i < count; ++i) {
+			if (events[i].filter == EVFILT_READ)
+				return NULL;
+
+			if (events[i].fflags & (NOTE_DELETE | NOTE_RENAME)) {
+				pp_dir_watcher_push (watcher, P_DIR_WATCHER_EVENT_DELETED, NULL, 0);
+				return NULL;
+			}
+		}
+
+		if (pp_dir_watcher_rescan (watcher) == FALSE)
+			break;
+	}
+
+	return NULL;
+}
+#else /* P_DIR_WATCHER_USE_SCAN */
+static pboolean
+pp_dir_watcher_sys_init (PDirWatcher	*watcher,
+			 PError		**error)
+{
+	return pp_dir_watcher_snapshot_take (watcher->path, &watcher->snapshot, error);
+}
+
+static void
+pp_dir_watcher_sys_stop (PDirWatcher *watcher)
+{
+	p_atomic_int_set (&watcher->stopped, 1);
+}
+
+static void
+pp_dir_watcher_sys_close (PDirWatcher *watcher)
+{
+	pp_dir_watcher_snapshot_clear (&watcher->snapshot);
+}
+
+static ppointer
+pp_dir_watcher_thread (ppointer data)
+{
+	PDirWatcher	*watcher = data;
+	pint		elapsed;
+
+	for (;;) {
+		for (elapsed = 0; elapsed < P_DIR_WATCHER_SCAN_INTERVAL; elapsed += P_DIR_WATCHER_SCAN_STEP) {
+			if (p_atomic_int_get (&watcher->stopped) != 0)
+				return NULL;
+
+			p_uthread_sleep (P_DIR_WATCHER_SCAN_STEP);
+		}
+
+		if (pp_dir_watcher_rescan (watcher) == FALSE)
+			break;
+	}
+
+	return NULL;
+}
+#endif
+
+P_LIB_API PDirWatcher *
+p_dir_watcher_new (const pchar	*path,
+		   PError	**error)
+{
+	PDirWatcher *ret;
+
+	if (P_UNLIKELY (path == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PDirWatcher))) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for directory watcher");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret->path = p_strdup (path)) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for directory path");
+		p_free (ret);
+		return NULL;
+	}
+
+	/* The directory must be watched by the time the call returns, system
+	 * handles are set up first to be closed safely */
+	if (P_UNLIKELY (pp_dir_watcher_sys_init (ret, error) == FALSE ||
+			pp_dir_watcher_wake_init (ret, error) == FALSE)) {
+		p_dir_watcher_free (ret);
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret->mutex = p_mutex_new ()) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for mutex");
+		p_dir_watcher_free (ret);
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret->thread = p_uthread_create (pp_dir_watcher_thread,
+							 ret,
+							 TRUE,
+							 "p_dir_watcher")) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_FAILED,
+				     0,
+				     "Failed to create directory watcher thread");
+		p_dir_watcher_free (ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+P_LIB_API PSocket *
+p_dir_watcher_get_socket (const PDirWatcher *watcher)
+{
+	if (P_UNLIKELY (watcher == NULL))
+		return NULL;
+
+	return watcher->wake_socket;
+}
+
+P_LIB_API pint
+p_dir_watcher_read_events (PDirWatcher		*watcher,
+			   PDirWatcherEvent	*events,
+			   pint			max_events,
+			   PError		**error)
+{
+	PDirWatcherNode	*node;
+	PDirWatcherNode	*last  = NULL;
+	pchar		buf[16];
+	pint		count = 0;
+
+	if (P_UNLIKELY (watcher == NULL || events == NULL || max_events <= 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	p_mutex_lock (watcher->mutex);
+
+	pp_dir_watcher_free_nodes (watcher->delivered);
+
+	watcher->delivered = watcher->head;
+
+	for (node = watcher->head; node != NULL && count < max_events; node = node->next) {
+		events[count].type   = node->type;
+		events[count].name   = node->name;
+		events[count].cookie = node->cookie;
+
+		last = node;
+		++count;
+	}
+
+	if (last != NULL) {
+		watcher->head = last->next;
+		last->next    = NULL;
+	}
+
+	watcher->queued -= count;
+
+	if (watcher->head == NULL) {
+		watcher->tail       = NULL;
+		watcher->overflowed = FALSE;
+
+		if (watcher->signaled == TRUE) {
+			while (p_socket_receive (watcher->wake_socket, buf, sizeof (buf), NULL) > 0)
+				;
+
+			watcher->signaled = FALSE;
+		}
+	}
+
+	p_mutex_unlock (watcher->mutex);
+
+	return count;
+}
+
+P_LIB_API void
+p_dir_watcher_free (PDirWatcher *watcher)
+{
+	if (P_UNLIKELY (watcher == NULL))
+		return;
+
+	if (watcher->thread != NULL) {
+		pp_dir_watcher_sys_stop (watcher);
+		p_uthread_join (watcher->thread);
+		p_uthread_unref (watcher->thread);
+	}
+
+	pp_dir_watcher_sys_close (watcher);
+
+	pp_dir_watcher_free_nodes (watcher->head);
+	pp_dir_watcher_free_nodes (watcher->delivered);
+
+	if (watcher->wake_address != NULL)
+		p_socket_address_free (watcher->wake_address);
+
+	if (watcher->wake_socket != NULL)
+		p_socket_free (watcher->wake_socket);
+
+	if (watcher->mutex != NULL)
+		p_mutex_free (watcher->mutex);
+
+	if (watcher->buffer != NULL)
+		p_free (watcher->buffer);
+
+	if (watcher->path != NULL)
+		p_free (watcher->path);
+
+	p_free (watcher);
+}
@@ -0,0 +1,152 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pdirwatcher.h
+ * @brief Directory change notifications
+ * @author Alexander Saprykin
+ *
+ * A directory watcher reports the changes of the entries of a directory as
+ * they happen, instead of listing the directory again and again to spot them.
+ * Create a watcher for a directory with p_dir_watcher_new(), then fetch the
+ * pending events with p_dir_watcher_read_events().
+ *
+ * Each #PDirWatcherEvent carries the type of the change and the name of the
+ * entry relative to the watched directory. A renamed entry is reported with
+ * a #P_DIR_WATCHER_EVENT_RENAMED_FROM and #P_DIR_WATCHER_EVENT_RENAMED_TO pair
+ * sharing the same cookie where the system reports renames, and as a deleted
+ * and a created entry otherwise. An entry moved into or out of the directory
+ * gets only one event of the pair. Back-to-back modifications of the same
+ * entry are merged into one event while it's not read yet.
+ *
+ * A watcher is pollable along with the sockets: p_dir_watcher_get_socket()
+ * returns a socket which becomes readable when events are pending, register
+ * it in a #PSocketPoller with #P_SOCKET_POLLER_CONDITION_IN. Don't read from
+ * or close the socket, it belongs to the watcher.
+ *
+ * The best mechanism of the system is used: inotify on Linux, kqueue on BSD
+ * systems and macOS, and ReadDirectoryChangesW() on Windows. The events are
+ * collected by a thread owned by the watcher. On the other systems the
+ * directory is listed periodically and compared with the previous listing.
+ * kqueue reports only that a directory has changed, so the listing is
+ * compared there as well, and it is also repeated periodically to catch
+ * files modified in place.
+ *
+ * Only the entries of the directory itself are watched, not of its
+ * subdirectories. If the events come faster than they are read, the extra
+ * events are dropped and #P_DIR_WATCHER_EVENT_OVERFLOW is reported, list the
+ * directory again to catch up then.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PDIRWATCHER_H
+#define PLIBSYS_HEADER_PDIRWATCHER_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+#include "perror.h"
+#include "psocket.h"
+
+P_BEGIN_DECLS
+
+/** Directory watcher event types. */
+typedef enum PDirWatcherEventType_ {
+	P_DIR_WATCHER_EVENT_CREATED		= 0,	/**< Entry has been created.			*/
+	P_DIR_WATCHER_EVENT_MODIFIED		= 1,	/**< Entry contents or attributes changed.	*/
+	P_DIR_WATCHER_EVENT_DELETED		= 2,	/**< Entry has been deleted.			*/
+	P_DIR_WATCHER_EVENT_RENAMED_FROM	= 3,	/**< Entry has been renamed, old name.		*/
+	P_DIR_WATCHER_EVENT_RENAMED_TO		= 4,	/**< Entry has been renamed, new name.		*/
+	P_DIR_WATCHER_EVENT_OVERFLOW		= 5	/**< Some events have been dropped.		*/
+} PDirWatcherEventType;
+
+/** Change returned by p_dir_watcher_read_events(). */
+typedef struct PDirWatcherEvent_ {
+	PDirWatcherEventType	type;	/**< Event type.						*/
+	const pchar		*name;	/**< Entry name, NULL for the watched directory itself.	*/
+	puint32			cookie;	/**< Same for both events of a rename, 0 otherwise.	*/
+} PDirWatcherEvent;
+
+/** Directory watcher opaque data type. */
+typedef struct PDirWatcher_ PDirWatcher;
+
+/**
+ * @brief Starts watching a directory.
+ * @param path Directory path to watch.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Pointer to #PDirWatcher in case of success, NULL otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API PDirWatcher *	p_dir_watcher_new		(const pchar		*path,
+							 PError			**error);
+
+/**
+ * @brief Gets a socket to poll a directory watcher with.
+ * @param watcher #PDirWatcher to get the socket for.
+ * @return Socket which is readable while events are pending, NULL in case of
+ * error.
+ * @since 0.0.5
+ *
+ * The socket may be reported as readable once more after all the events have
+ * been read, p_dir_watcher_read_events() returns 0 then.
+ */
+P_LIB_API PSocket *	p_dir_watcher_get_socket	(const PDirWatcher	*watcher);
+
+/**
+ * @brief Reads the pending events of a directory watcher.
+ * @param watcher #PDirWatcher to read the events from.
+ * @param[out] events Array to store the events in.
+ * @param max_events Size of @a events.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Number of events stored in @a events, 0 if there are no pending
+ * events, -1 in case of error.
+ * @since 0.0.5
+ *
+ * The call never blocks. The names of the events stay valid until the next
+ * call or until the watcher is freed.
+ *
+ * An event with #P_DIR_WATCHER_EVENT_DELETED and no name means the watched
+ * directory itself has been deleted or moved, no more events are reported
+ * after it.
+ */
+P_LIB_API pint		p_dir_watcher_read_events	(PDirWatcher		*watcher,
+							 PDirWatcherEvent	*events,
+							 pint			max_events,
+							 PError			**error);
+
+/**
+ * @brief Stops watching a directory and frees a directory watcher.
+ * @param watcher #PDirWatcher to free.
+ * @since 0.0.5
+ *
+ * Remove the socket of the watcher from a poller before freeing it.
+ */
+P_LIB_API void		p_dir_watcher_free		(PDirWatcher		*watcher);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PDIRWATCHER_H */
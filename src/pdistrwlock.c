@@ -0,0 +1,272 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Every reader slot takes a whole cache line. A reader increments its slot
+ * and then checks the writer flag, a writer raises the flag and then checks
+ * the slots: with the sequentially consistent atomics at least one of them
+ * sees the other. The writers mutex both serializes the writers and puts the
+ * readers to sleep while a writer holds the lock. */
+
+#include "patomic.h"
+#include "pcpurelax-private.h"
+#include "pmem.h"
+#include "pmutex.h"
+#include "puthread.h"
+#include "pdistrwlock.h"
+
+#define P_DIST_RWLOCK_MAX_SLOTS		256
+
+typedef struct PDistRWLockSlot_ {
+	volatile pint	readers;
+	pchar		pad[P_MEM_CACHE_LINE_SIZE - sizeof (pint)];
+} PDistRWLockSlot;
+
+struct PDistRWLock_ {
+	PDistRWLockSlot	*slots;
+	pint		slot_mask;
+	volatile pint	writer;
+	PMutex		*write_mutex;
+};
+
+static pint pp_dist_rwlock_pick_slot (const PDistRWLock *lock);
+static void pp_dist_rwlock_wait_readers (PDistRWLock *lock);
+
+static pint
+pp_dist_rwlock_pick_slot (const PDistRWLock *lock)
+{
+	pint	cpu;
+	psize	id;
+
+	if (P_LIKELY ((cpu = p_uthread_current_cpu ()) >= 0))
+		return cpu & lock->slot_mask;
+
+	/* Without the CPU number at least spread different threads */
+	id = (psize) p_uthread_current_id ();
+
+	return (pint) ((id >> 4) ^ (id >> 12)) & lock->slot_mask;
+}
+
+static void
+pp_dist_rwlock_wait_readers (PDistRWLock *lock)
+{
+	pint	i;
+	pint	backoff;
+
+	for (i = 0; i <= lock->slot_mask; ++i) {
+		backoff = 1;
+
+		while (p_atomic_int_get (&lock->slots[i].readers) != 0)
+			P_CPU_BACKOFF (backoff);
+	}
+}
+
+P_LIB_API PDistRWLock *
+p_dist_rwlock_new (pint n_slots)
+{
+	PDistRWLock	*ret;
+	pint		size;
+
+	if (n_slots <= 0)
+		n_slots = p_uthread_ideal_count ();
+
+	if (n_slots > P_DIST_RWLOCK_MAX_SLOTS)
+		n_slots = P_DIST_RWLOCK_MAX_SLOTS;
+
+	for (size = 1; size < n_slots; size <<= 1)
+		;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PDistRWLock))) == NULL)) {
+		P_ERROR ("PDistRWLock::p_dist_rwlock_new: failed to allocate memory");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret->slots = p_malloc0_aligned (sizeof (PDistRWLockSlot) * (psize) size,
+							 P_MEM_CACHE_LINE_SIZE)) == NULL)) {
+		P_ERROR ("PDistRWLock::p_dist_rwlock_new: failed to allocate memory for slots");
+		p_free (ret);
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret->write_mutex = p_mutex_new ()) == NULL)) {
+		P_ERROR ("PDistRWLock::p_dist_rwlock_new: failed to allocate mutex");
+		p_free_aligned (ret->slots);
+		p_free (ret);
+		return NULL;
+	}
+
+	ret->slot_mask = size - 1;
+
+	return ret;
+}
+
+P_LIB_API pint
+p_dist_rwlock_reader_lock (PDistRWLock *lock)
+{
+	pint slot;
+
+	if (P_UNLIKELY (lock == NULL))
+		return -1;
+
+	for (;;) {
+		slot = pp_dist_rwlock_pick_slot (lock);
+
+		p_atomic_int_inc (&lock->slots[slot].readers);
+
+		if (P_LIKELY (p_atomic_int_get (&lock->writer) == 0))
+			return slot;
+
+		p_atomic_int_add (&lock->slots[slot].readers, -1);
+
+		/* Sleep until the writer is done */
+		if (P_UNLIKELY (p_mutex_lock (lock->write_mutex) == FALSE)) {
+			P_ERROR ("PDistRWLock::p_dist_rwlock_reader_lock: p_mutex_lock() failed");
+			return -1;
+		}
+
+		if (P_UNLIKELY (p_mutex_unlock (lock->write_mutex) == FALSE)) {
+			P_ERROR ("PDistRWLock::p_dist_rwlock_reader_lock: p_mutex_unlock() failed");
+			return -1;
+		}
+	}
+}
+
+P_LIB_API pint
+p_dist_rwlock_reader_trylock (PDistRWLock *lock)
+{
+	pint slot;
+
+	if (P_UNLIKELY (lock == NULL))
+		return -1;
+
+	if (p_atomic_int_get (&lock->writer) != 0)
+		return -1;
+
+	slot = pp_dist_rwlock_pick_slot (lock);
+
+	p_atomic_int_inc (&lock->slots[slot].readers);
+
+	if (P_LIKELY (p_atomic_int_get (&lock->writer) == 0))
+		return slot;
+
+	p_atomic_int_add (&lock->slots[slot].readers, -1);
+
+	return -1;
+}
+
+P_LIB_API pboolean
+p_dist_rwlock_reader_unlock (PDistRWLock	*lock,
+			     pint		slot)
+{
+	if (P_UNLIKELY (lock == NULL || slot < 0 || slot > lock->slot_mask))
+		return FALSE;
+
+	p_atomic_int_add (&lock->slots[slot].readers, -1);
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_dist_rwlock_writer_lock (PDistRWLock *lock)
+{
+	if (P_UNLIKELY (lock == NULL))
+		return FALSE;
+
+	if (P_UNLIKELY (p_mutex_lock (lock->write_mutex) == FALSE)) {
+		P_ERROR ("PDistRWLock::p_dist_rwlock_writer_lock: p_mutex_lock() failed");
+		return FALSE;
+	}
+
+	p_atomic_int_set (&lock->writer, 1);
+
+	pp_dist_rwlock_wait_readers (lock);
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_dist_rwlock_writer_trylock (PDistRWLock *lock)
+{
+	pint i;
+
+	if (P_UNLIKELY (lock == NULL))
+		return FALSE;
+
+	if (p_mutex_trylock (lock->write_mutex) == FALSE)
+		return FALSE;
+
+	p_atomic_int_set (&lock->writer, 1);
+
+	for (i = 0; i <= lock->slot_mask; ++i) {
+		if (p_atomic_int_get (&lock->slots[i].readers) != 0) {
+			p_atomic_int_set (&lock->writer, 0);
+
+			if (P_UNLIKELY (p_mutex_unlock (lock->write_mutex) == FALSE))
+				P_ERROR ("PDistRWLock::p_dist_rwlock_writer_trylock: p_mutex_unlock() failed");
+
+			return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_dist_rwlock_writer_unlock (PDistRWLock *lock)
+{
+	if (P_UNLIKELY (lock == NULL))
+		return FALSE;
+
+	p_atomic_int_set (&lock->writer, 0);
+
+	if (P_UNLIKELY (p_mutex_unlock (lock->write_mutex) == FALSE)) {
+		P_ERROR ("PDistRWLock::p_dist_rwlock_writer_unlock: p_mutex_unlock() failed");
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+P_LIB_API void
+p_dist_rwlock_free (PDistRWLock *lock)
+{
+	pint i;
+
+	if (P_UNLIKELY (lock == NULL))
+		return;
+
+	if (P_UNLIKELY (p_atomic_int_get (&lock->writer) != 0))
+		P_WARNING ("PDistRWLock::p_dist_rwlock_free: destroying while a writer is present");
+
+	for (i = 0; i <= lock->slot_mask; ++i) {
+		if (P_UNLIKELY (p_atomic_int_get (&lock->slots[i].readers) != 0)) {
+			P_WARNING ("PDistRWLock::p_dist_rwlock_free: destroying while readers are present");
+			break;
+		}
+	}
+
+	p_mutex_free (lock->write_mutex);
+	p_free_aligned (lock->slots);
+	p_free (lock);
+}
@@ -0,0 +1,145 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pdistrwlock.h
+ * @brief Distributed read-write lock
+ * @author Alexander Saprykin
+ *
+ * A distributed read-write lock is a #PRWLock variant for data read very
+ * often and changed rarely. A usual read-write lock counts the readers in a
+ * single word which every reader modifies, so the cache line with the counter
+ * bounces between the CPUs even when there are no writers at all. Here the
+ * readers are counted in several slots, each on its own cache line, and a
+ * reader picks the slot of the CPU it runs on. Readers on different CPUs
+ * don't share any memory they write to, and a reader lock costs a pair of
+ * atomic operations on a mostly local cache line.
+ *
+ * The price is paid by the writers: a writer has to check every slot and wait
+ * for the readers in all of them, so use #PRWLock if the writes are frequent.
+ * Writers are in favor over readers: the new readers wait while a writer is
+ * waiting for the current readers to leave or holds the lock. Hence do not
+ * lock a distributed lock for reading recursively, a writer in between leads
+ * to a deadlock.
+ *
+ * p_dist_rwlock_reader_lock() returns the slot the reader was counted in, pass
+ * it to p_dist_rwlock_reader_unlock(): a thread may move to another CPU while
+ * it holds the lock.
+ *
+ * The readers sleep while a writer holds the lock, the writers sleep while
+ * another writer holds the lock, and spin for a while before yielding the CPU
+ * while the last readers finish.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PDISTRWLOCK_H
+#define PLIBSYS_HEADER_PDISTRWLOCK_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+
+P_BEGIN_DECLS
+
+/** Distributed read-write lock opaque data type. */
+typedef struct PDistRWLock_ PDistRWLock;
+
+/**
+ * @brief Creates a new distributed read-write lock.
+ * @param n_slots Number of reader slots, 0 to use the number of CPUs. It is
+ * rounded up to a power of two and limited by 256.
+ * @return Pointer to #PDistRWLock in case of success, NULL otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API PDistRWLock *	p_dist_rwlock_new		(pint		n_slots);
+
+/**
+ * @brief Locks a distributed read-write lock for reading.
+ * @param lock #PDistRWLock to lock.
+ * @return Reader slot to pass to p_dist_rwlock_reader_unlock() in case of
+ * success, -1 otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pint		p_dist_rwlock_reader_lock	(PDistRWLock	*lock);
+
+/**
+ * @brief Tries to lock a distributed read-write lock for reading without
+ * waiting.
+ * @param lock #PDistRWLock to lock.
+ * @return Reader slot to pass to p_dist_rwlock_reader_unlock() if the lock
+ * was acquired, -1 otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pint		p_dist_rwlock_reader_trylock	(PDistRWLock	*lock);
+
+/**
+ * @brief Releases a distributed read-write lock locked for reading.
+ * @param lock #PDistRWLock to release.
+ * @param slot Reader slot returned by the lock call.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_dist_rwlock_reader_unlock	(PDistRWLock	*lock,
+							 pint		slot);
+
+/**
+ * @brief Locks a distributed read-write lock for writing.
+ * @param lock #PDistRWLock to lock.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_dist_rwlock_writer_lock	(PDistRWLock	*lock);
+
+/**
+ * @brief Tries to lock a distributed read-write lock for writing without
+ * waiting.
+ * @param lock #PDistRWLock to lock.
+ * @return TRUE if the lock was acquired, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_dist_rwlock_writer_trylock	(PDistRWLock	*lock);
+
+/**
+ * @brief Releases a distributed read-write lock locked for writing.
+ * @param lock #PDistRWLock to release.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_dist_rwlock_writer_unlock	(PDistRWLock	*lock);
+
+/**
+ * @brief Frees a distributed read-write lock.
+ * @param lock #PDistRWLock to free.
+ * @since 0.0.5
+ *
+ * The lock should be unlocked at that moment.
+ */
+P_LIB_API void		p_dist_rwlock_free		(PDistRWLock	*lock);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PDISTRWLOCK_H */
@@ -25,6 +25,7 @@
 
 #include "perror.h"
 #include "pmem.h"
+#include "ponce.h"
 #include "pstring.h"
 #include "perror-private.h"
 
@@ -38,13 +39,37 @@
 #endif
 
 struct PError_ {
-	pint	code;
-	pint	native_code;
-	pchar	*message;
+	pint		code;
+	pint		native_code;
+	pchar		*message;
+	pboolean	static_message;
 };
 
-PErrorIO
-p_error_get_io_from_system (pint err_code)
+/* Most of the system error codes are small, so they are classified with a
+ * direct lookup, the table keeps an offset from the error domain value */
+#define P_ERROR_LOOKUP_TABLE_SIZE	256
+
+static POnce	pp_error_lookup_once = P_ONCE_INIT;
+static puint8	pp_error_io_table[P_ERROR_LOOKUP_TABLE_SIZE];
+static puint8	pp_error_ipc_table[P_ERROR_LOOKUP_TABLE_SIZE];
+
+static void pp_error_free_message (PError *error);
+static PErrorIO pp_error_get_io_from_system_switch (pint err_code);
+static PErrorIPC pp_error_get_ipc_from_system_switch (pint err_code);
+static void pp_error_lookup_init (ppointer data);
+
+static void
+pp_error_free_message (PError *error)
+{
+	if (error->message != NULL && error->static_message == FALSE)
+		p_free (error->message);
+
+	error->message        = NULL;
+	error->static_message = FALSE;
+}
+
+static PErrorIO
+pp_error_get_io_from_system_switch (pint err_code)
 {
 	switch (err_code) {
 	case 0:
@@ -414,14 +439,8 @@ p_error_get_io_from_system (pint err_code)
 	}
 }
 
-PErrorIO
-p_error_get_last_io (void)
-{
-	return p_error_get_io_from_system (p_error_get_last_system ());
-}
-
-PErrorIPC
-p_error_get_ipc_from_system (pint err_code)
+static PErrorIPC
+pp_error_get_ipc_from_system_switch (pint err_code)
 {
 	switch (err_code) {
 	case 0:
@@ -645,6 +664,57 @@ p_error_get_ipc_from_system (pint err_code)
 	}
 }
 
+static void
+pp_error_lookup_init (ppointer data)
+{
+	pint i;
+
+	P_UNUSED (data);
+
+	for (i = 0; i < P_ERROR_LOOKUP_TABLE_SIZE; ++i) {
+		pp_error_io_table[i]  = (puint8) (pp_error_get_io_from_system_switch (i) - P_ERROR_DOMAIN_IO);
+		pp_error_ipc_table[i] = (puint8) (pp_error_get_ipc_from_system_switch (i) - P_ERROR_DOMAIN_IPC);
+	}
+}
+
+PErrorIO
+p_error_get_io_from_system (pint err_code)
+{
+	/* Retry loops on non-blocking sockets hit this one most of the time */
+#if defined (P_OS_WIN) && defined (WSAEWOULDBLOCK)
+	if (P_LIKELY (err_code == WSAEWOULDBLOCK))
+		return P_ERROR_IO_WOULD_BLOCK;
+#elif !defined (P_OS_WIN) && !defined (P_OS_OS2) && defined (EAGAIN)
+	if (P_LIKELY (err_code == EAGAIN))
+		return P_ERROR_IO_WOULD_BLOCK;
+#endif
+
+	if (P_LIKELY (err_code >= 0 && err_code < P_ERROR_LOOKUP_TABLE_SIZE)) {
+		p_once (&pp_error_lookup_once, pp_error_lookup_init, NULL);
+		return (PErrorIO) (P_ERROR_DOMAIN_IO + pp_error_io_table[err_code]);
+	}
+
+	return pp_error_get_io_from_system_switch (err_code);
+}
+
+PErrorIO
+p_error_get_last_io (void)
+{
+	return p_error_get_io_from_system (p_error_get_last_system ());
+}
+
+
+PErrorIPC
+p_error_get_ipc_from_system (pint err_code)
+{
+	if (P_LIKELY (err_code >= 0 && err_code < P_ERROR_LOOKUP_TABLE_SIZE)) {
+		p_once (&pp_error_lookup_once, pp_error_lookup_init, NULL);
+		return (PErrorIPC) (P_ERROR_DOMAIN_IPC + pp_error_ipc_table[err_code]);
+	}
+
+	return pp_error_get_ipc_from_system_switch (err_code);
+}
+
 PErrorIPC
 p_error_get_last_ipc (void)
 {
@@ -745,8 +815,7 @@ p_error_set_error (PError	*error,
 	if (P_UNLIKELY (error == NULL))
 		return;
 
-	if (error->message != NULL)
-		p_free (error->message);
+	pp_error_free_message (error);
 
 	error->code        = code;
 	error->native_code = native_code;
@@ -765,6 +834,24 @@ p_error_set_error_p (PError		**error,
 	*error = p_error_new_literal (code, native_code, message);
 }
 
+P_LIB_API void
+p_error_set_error_static_p (PError		**error,
+			    pint		code,
+			    pint		native_code,
+			    const pchar		*message)
+{
+	if (error == NULL || *error != NULL)
+		return;
+
+	if (P_UNLIKELY ((*error = p_error_new ()) == NULL))
+		return;
+
+	(*error)->code           = code;
+	(*error)->native_code    = native_code;
+	(*error)->message        = (pchar *) message;
+	(*error)->static_message = TRUE;
+}
+
 P_LIB_API void
 p_error_set_code (PError	*error,
 		  pint		code)
@@ -792,8 +879,7 @@ p_error_set_message (PError		*error,
 	if (P_UNLIKELY (error == NULL))
 		return;
 
-	if (error->message != NULL)
-		p_free (error->message);
+	pp_error_free_message (error);
 
 	error->message = p_strdup (message);
 }
@@ -804,10 +890,8 @@ p_error_clear (PError *error)
 	if (P_UNLIKELY (error == NULL))
 		return;
 
-	if (error->message != NULL)
-		p_free (error->message);
+	pp_error_free_message (error);
 
-	error->message     = NULL;
 	error->code        = 0;
 	error->native_code = 0;
 }
@@ -818,8 +902,7 @@ p_error_free (PError	*error)
 	if (P_UNLIKELY (error == NULL))
 		return;
 
-	if (error->message != NULL)
-		p_free (error->message);
+	pp_error_free_message (error);
 
 	p_free (error);
 }
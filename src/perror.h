@@ -43,6 +43,11 @@
  * pointer into an API call. Simply initialize it with zero and check the result
  * after. Therefore you need to free memory if an error occurred.
  *
+ * Reporting an error costs a memory allocation, which matters on the paths
+ * failing frequently. p_error_set_error_static_p() avoids copying a message
+ * for string literals, and #PSocket can report the #P_ERROR_IO_WOULD_BLOCK
+ * case with a return code alone, see p_socket_set_silent_would_block().
+ *
  * Most operating systems store the last error code of the most system calls in
  * a thread-specific variable. Moreover, Windows stores the error code of the
  * last socket related call in a separate variable. Use
@@ -161,6 +166,23 @@ P_LIB_API void		p_error_set_error_p	(PError		**error,
 						 pint		native_code,
 						 const pchar	*message);
 
+/**
+ * @brief Sets error data through a double pointer without copying a message.
+ * @param error #PError object to set the data for.
+ * @param code Error code.
+ * @param native_code Native error code, leave 0 to ignore.
+ * @param message Static error message, it must outlive the error object.
+ * @since 0.0.5
+ *
+ * Works the same way as p_error_set_error_p() but keeps a reference to
+ * @a message instead of duplicating it, so only the #PError object itself is
+ * allocated. Use it with string literals on frequently failing paths.
+ */
+P_LIB_API void		p_error_set_error_static_p	(PError		**error,
+							 pint		code,
+							 pint		native_code,
+							 const pchar	*message);
+
 /**
  * @brief Sets an error code.
  * @param error #PError object to set the code for.
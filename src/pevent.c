@@ -0,0 +1,356 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "patomic.h"
+#include "pevent.h"
+#include "pmem.h"
+#include "perror-private.h"
+
+#if defined (P_OS_WIN)  || defined (P_OS_BEOS) || defined (P_OS_MAC) || \
+    defined (P_OS_MAC9) || defined (P_OS_OS2)  || defined (P_OS_AMIGA)
+#  define P_EVENT_USE_SOCKET
+#  include "psocket.h"
+#  include "psocketaddress.h"
+#elif defined (PLIBSYS_HAS_EVENTFD)
+#  define P_EVENT_USE_EVENTFD
+#  include <sys/eventfd.h>
+#else
+#  define P_EVENT_USE_PIPE
+#endif
+
+#ifndef P_EVENT_USE_SOCKET
+#  include "psysclose-private.h"
+
+#  include <errno.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif
+
+struct PEvent_ {
+	volatile pint	signaled;
+#if defined (P_EVENT_USE_SOCKET)
+	PSocket		*socket;
+	PSocketAddress	*address;
+#elif defined (P_EVENT_USE_EVENTFD)
+	pint		fd;
+#else
+	pint		fds[2];
+#endif
+};
+
+static pboolean pp_event_sys_init (PEvent *event, PError **error);
+static void pp_event_sys_close (PEvent *event);
+static pboolean pp_event_sys_signal (PEvent *event);
+static void pp_event_sys_drain (PEvent *event);
+static pint pp_event_sys_get_fd (const PEvent *event);
+
+#if defined (P_EVENT_USE_SOCKET)
+/* Datagram sent to itself, the only option where only sockets are pollable */
+static pboolean
+pp_event_sys_init (PEvent	*event,
+		   PError	**error)
+{
+	PSocketAddress *address;
+
+	if (P_UNLIKELY ((event->socket = p_socket_new (P_SOCKET_FAMILY_INET,
+						       P_SOCKET_TYPE_DATAGRAM,
+						       P_SOCKET_PROTOCOL_UDP,
+						       error)) == NULL))
+		return FALSE;
+
+	if (P_UNLIKELY ((address = p_socket_address_new ("127.0.0.1", 0)) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for socket address");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (p_socket_bind (event->socket, address, FALSE, error) == FALSE)) {
+		p_socket_address_free (address);
+		return FALSE;
+	}
+
+	p_socket_address_free (address);
+
+	if (P_UNLIKELY ((event->address = p_socket_get_local_address (event->socket, error)) == NULL))
+		return FALSE;
+
+	p_socket_set_blocking (event->socket, FALSE);
+
+	return TRUE;
+}
+
+static void
+pp_event_sys_close (PEvent *event)
+{
+	if (event->socket != NULL)
+		p_socket_free (event->socket);
+
+	if (event->address != NULL)
+		p_socket_address_free (event->address);
+}
+
+static pboolean
+pp_event_sys_signal (PEvent *event)
+{
+	pchar byte = 0;
+
+	return p_socket_send_to (event->socket, event->address, &byte, 1, NULL) == 1;
+}
+
+static void
+pp_event_sys_drain (PEvent *event)
+{
+	pchar buf[16];
+
+	while (p_socket_receive (event->socket, buf, sizeof (buf), NULL) > 0)
+		;
+}
+
+static pint
+pp_event_sys_get_fd (const PEvent *event)
+{
+	return p_socket_get_fd (event->socket);
+}
+#elif defined (P_EVENT_USE_EVENTFD)
+static pboolean
+pp_event_sys_init (PEvent	*event,
+		   PError	**error)
+{
+	if (P_UNLIKELY ((event->fd = eventfd (0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call eventfd() to create event");
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static void
+pp_event_sys_close (PEvent *event)
+{
+	if (event->fd >= 0 && P_UNLIKELY (p_sys_close (event->fd) != 0))
+		P_WARNING ("PEvent::pp_event_sys_close: p_sys_close() failed");
+}
+
+static pboolean
+pp_event_sys_signal (PEvent *event)
+{
+	puint64 value = 1;
+	pssize	res;
+
+	while ((res = write (event->fd, &value, sizeof (value))) < 0 && errno == EINTR)
+		;
+
+	/* Only a counter overflow blocks, the event is readable then anyway */
+	return res == (pssize) sizeof (value) || errno == EAGAIN;
+}
+
+static void
+pp_event_sys_drain (PEvent *event)
+{
+	puint64 value;
+
+	/* A single read resets the counter */
+	while (read (event->fd, &value, sizeof (value)) < 0 && errno == EINTR)
+		;
+}
+
+static pint
+pp_event_sys_get_fd (const PEvent *event)
+{
+	return event->fd;
+}
+#else /* P_EVENT_USE_PIPE */
+static pboolean
+pp_event_sys_init (PEvent	*event,
+		   PError	**error)
+{
+	pint flags;
+	pint i;
+
+	if (P_UNLIKELY (pipe (event->fds) != 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call pipe() to create event");
+		event->fds[0] = -1;
+		event->fds[1] = -1;
+		return FALSE;
+	}
+
+	for (i = 0; i < 2; ++i) {
+		flags = fcntl (event->fds[i], F_GETFL);
+
+		if (P_UNLIKELY (flags == -1 || fcntl (event->fds[i], F_SETFL, flags | O_NONBLOCK) == -1)) {
+			p_error_set_error_p (error,
+					     (pint) p_error_get_last_io (),
+					     p_error_get_last_system (),
+					     "Failed to call fcntl() to make event non-blocking");
+			return FALSE;
+		}
+
+		flags = fcntl (event->fds[i], F_GETFD);
+
+		if (P_UNLIKELY (flags == -1 || fcntl (event->fds[i], F_SETFD, flags | FD_CLOEXEC) == -1))
+			P_WARNING ("PEvent::pp_event_sys_init: fcntl() with FD_CLOEXEC failed");
+	}
+
+	return TRUE;
+}
+
+static void
+pp_event_sys_close (PEvent *event)
+{
+	pint i;
+
+	for (i = 0; i < 2; ++i) {
+		if (event->fds[i] >= 0 && P_UNLIKELY (p_sys_close (event->fds[i]) != 0))
+			P_WARNING ("PEvent::pp_event_sys_close: p_sys_close() failed");
+	}
+}
+
+static pboolean
+pp_event_sys_signal (PEvent *event)
+{
+	pchar	byte = 0;
+	pssize	res;
+
+	while ((res = write (event->fds[1], &byte, 1)) < 0 && errno == EINTR)
+		;
+
+	/* A full pipe is readable anyway */
+	return res == 1 || errno == EAGAIN || errno == EWOULDBLOCK;
+}
+
+static void
+pp_event_sys_drain (PEvent *event)
+{
+	pchar	buf[64];
+	pssize	res;
+
+	while ((res = read (event->fds[0], buf, sizeof (buf))) > 0 || (res < 0 && errno == EINTR))
+		;
+}
+
+static pint
+pp_event_sys_get_fd (const PEvent *event)
+{
+	return event->fds[0];
+}
+#endif
+
+P_LIB_API PEvent *
+p_event_new (PError **error)
+{
+	PEvent *ret;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PEvent))) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for event");
+		return NULL;
+	}
+
+#if defined (P_EVENT_USE_EVENTFD)
+	ret->fd = -1;
+#elif defined (P_EVENT_USE_PIPE)
+	ret->fds[0] = -1;
+	ret->fds[1] = -1;
+#endif
+
+	if (P_UNLIKELY (pp_event_sys_init (ret, error) == FALSE)) {
+		p_event_free (ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+P_LIB_API pboolean
+p_event_signal (PEvent *event)
+{
+	if (P_UNLIKELY (event == NULL))
+		return FALSE;
+
+	/* Coalesced into the pending signal */
+	if (p_atomic_int_compare_and_exchange (&event->signaled, 0, 1) == FALSE)
+		return TRUE;
+
+	if (P_UNLIKELY (pp_event_sys_signal (event) == FALSE)) {
+		p_atomic_int_set (&event->signaled, 0);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_event_clear (PEvent *event)
+{
+	if (P_UNLIKELY (event == NULL))
+		return FALSE;
+
+	/* The flag is reset only after draining: the other way round a signal
+	 * coming in between would be drained while the flag stays set, and all
+	 * the following signals would be swallowed. This way the worst case is a
+	 * spurious wakeup. */
+	pp_event_sys_drain (event);
+
+	return p_atomic_int_compare_and_exchange (&event->signaled, 1, 0);
+}
+
+P_LIB_API pboolean
+p_event_is_signaled (const PEvent *event)
+{
+	if (P_UNLIKELY (event == NULL))
+		return FALSE;
+
+	return p_atomic_int_get (&event->signaled) != 0;
+}
+
+P_LIB_API pint
+p_event_get_fd (const PEvent *event)
+{
+	if (P_UNLIKELY (event == NULL))
+		return -1;
+
+	return pp_event_sys_get_fd (event);
+}
+
+P_LIB_API void
+p_event_free (PEvent *event)
+{
+	if (P_UNLIKELY (event == NULL))
+		return;
+
+	pp_event_sys_close (event);
+
+	p_free (event);
+}
@@ -0,0 +1,127 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pevent.h
+ * @brief Cross-thread wakeup event
+ * @author Alexander Saprykin
+ *
+ * An event wakes up a thread blocked in a #PSocketPoller from any other
+ * thread. It is backed by a descriptor which becomes readable when the event
+ * is signaled, so it joins the same poll set as the sockets with
+ * p_socket_poller_add_event(), and the waiting thread is woken up either by
+ * network activity or by the event, whichever comes first.
+ *
+ * The descriptor is an eventfd on Linux, a pipe on the other POSIX systems and
+ * a loopback datagram socket on Windows and the systems which can select()
+ * only sockets.
+ *
+ * Signals coalesce: p_event_signal() touches the descriptor only if the event
+ * is not signaled yet, so a burst of notifications costs a single system call
+ * and a single wakeup. The waiting thread calls p_event_clear() when the
+ * event is reported ready and then picks up all the work published before the
+ * signals, the next signal wakes it up again.
+ *
+ * p_event_signal() is thread-safe and can be called from any number of
+ * threads, p_event_clear() must be called from the single waiting thread.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PEVENT_H
+#define PLIBSYS_HEADER_PEVENT_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+#include "perror.h"
+
+P_BEGIN_DECLS
+
+/** Cross-thread wakeup event opaque data type. */
+typedef struct PEvent_ PEvent;
+
+/**
+ * @brief Creates a new event in the non-signaled state.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Pointer to #PEvent in case of success, NULL otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API PEvent *	p_event_new		(PError		**error);
+
+/**
+ * @brief Signals an event.
+ * @param event #PEvent to signal.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * Does nothing if @a event is already signaled. Thread-safe.
+ */
+P_LIB_API pboolean	p_event_signal		(PEvent		*event);
+
+/**
+ * @brief Resets an event to the non-signaled state.
+ * @param event #PEvent to reset.
+ * @return TRUE if @a event was signaled, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * Call it before handling the work the signal was about, so a signal sent
+ * during the handling is not lost.
+ */
+P_LIB_API pboolean	p_event_clear		(PEvent		*event);
+
+/**
+ * @brief Checks whether an event is signaled.
+ * @param event #PEvent to check.
+ * @return TRUE if @a event is signaled, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_event_is_signaled	(const PEvent	*event);
+
+/**
+ * @brief Gets the descriptor of an event.
+ * @param event #PEvent to get the descriptor for.
+ * @return Descriptor which is readable while @a event is signaled, -1 in case
+ * of error.
+ * @since 0.0.5
+ *
+ * On Windows it is a socket handle. Don't read from or close the descriptor,
+ * use p_event_clear() and p_event_free() instead.
+ */
+P_LIB_API pint		p_event_get_fd		(const PEvent	*event);
+
+/**
+ * @brief Frees an event.
+ * @param event #PEvent to free.
+ * @since 0.0.5
+ *
+ * Remove the event from the pollers before freeing it.
+ */
+P_LIB_API void		p_event_free		(PEvent		*event);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PEVENT_H */
@@ -0,0 +1,679 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "patomic.h"
+#include "peventloop.h"
+#include "phashtable.h"
+#include "plist.h"
+#include "pmem.h"
+#include "pmutex.h"
+#include "ptimerwheel.h"
+#include "puthread.h"
+#include "perror-private.h"
+
+#define P_EVENT_LOOP_MAX_EVENTS		64
+#define P_EVENT_LOOP_MIN_TASKS		16
+#define P_EVENT_LOOP_TIMER_RESOLUTION	1
+
+typedef struct PEventLoopTask_ {
+	PEventLoopFunc		func;
+	ppointer		user_data;
+} PEventLoopTask;
+
+typedef struct PEventLoopSource_ {
+	PSocket			*socket;
+	PEventLoopSocketFunc	func;
+	ppointer		user_data;
+} PEventLoopSource;
+
+struct PEventLoopTimer_ {
+	PListLink		link;
+	PEventLoop		*loop;
+	PTimerWheelTimer	*timer;
+	PEventLoopTimerFunc	func;
+	ppointer		user_data;
+	puint64			interval;
+	pboolean		firing;
+	pboolean		cancelled;
+};
+
+struct PEventLoop_ {
+	PSocketPoller		*poller;
+	PTimerWheel		*wheel;
+	PHashTable		*sources;
+	PListLink		timers;
+	PSocketPollerEvent	events[P_EVENT_LOOP_MAX_EVENTS];
+	pint			n_events;
+	pint			dispatch_index;
+	PEvent			*wake_event;
+	PMutex			*task_mutex;
+	PEventLoopTask		*tasks;
+	psize			task_count;
+	psize			task_capacity;
+	PEventLoopTask		*running;
+	psize			running_capacity;
+	volatile pint		has_tasks;
+	volatile pint		stopped;
+	volatile P_HANDLE	thread_id;
+};
+
+struct PEventLoopGroup_ {
+	PEventLoop		**loops;
+	PUThread		**threads;
+	pint			count;
+	volatile pint		next;
+};
+
+static pboolean pp_event_loop_wake_open (PEventLoop *loop, PError **error);
+static pboolean pp_event_loop_is_loop_thread (PEventLoop *loop);
+static void pp_event_loop_timer_release (PEventLoopTimer *timer);
+static void pp_event_loop_timer_func (PTimerWheel *wheel, PTimerWheelTimer *wheel_timer, ppointer user_data);
+static psize pp_event_loop_run_tasks (PEventLoop *loop);
+static ppointer pp_event_loop_group_thread (ppointer data);
+
+static pboolean
+pp_event_loop_wake_open (PEventLoop	*loop,
+			 PError		**error)
+{
+	if (P_UNLIKELY ((loop->wake_event = p_event_new (error)) == NULL))
+		return FALSE;
+
+	return p_socket_poller_add_event (loop->poller, loop->wake_event, NULL, error);
+}
+
+static pboolean
+pp_event_loop_is_loop_thread (PEventLoop *loop)
+{
+	return p_atomic_pointer_get (&loop->thread_id) == p_uthread_current_id ();
+}
+
+static void
+pp_event_loop_timer_release (PEventLoopTimer *timer)
+{
+	p_list_link_remove (&timer->link);
+	p_free (timer);
+}
+
+static void
+pp_event_loop_timer_func (PTimerWheel		*wheel,
+			  PTimerWheelTimer	*wheel_timer,
+			  ppointer		user_data)
+{
+	PEventLoopTimer *timer = user_data;
+
+	timer->firing = TRUE;
+	timer->func (timer->loop, timer, timer->user_data);
+	timer->firing = FALSE;
+
+	/* The delay is counted from the expired tick, so the timer doesn't drift */
+	if (timer->cancelled == FALSE &&
+	    timer->interval > 0 &&
+	    p_timer_wheel_reschedule (wheel, wheel_timer, timer->interval) == TRUE)
+		return;
+
+	/* Otherwise the wheel releases its timer after the callback */
+	pp_event_loop_timer_release (timer);
+}
+
+/* Takes the whole queue at once, the tasks posted meanwhile go to the next
+ * batch */
+static psize
+pp_event_loop_run_tasks (PEventLoop *loop)
+{
+	PEventLoopTask	*batch;
+	psize		capacity;
+	psize		count;
+	psize		i;
+
+	if (p_atomic_int_get (&loop->has_tasks) == 0)
+		return 0;
+
+	p_mutex_lock (loop->task_mutex);
+
+	batch    = loop->tasks;
+	capacity = loop->task_capacity;
+	count    = loop->task_count;
+
+	loop->tasks            = loop->running;
+	loop->task_capacity    = loop->running_capacity;
+	loop->task_count       = 0;
+	loop->running          = batch;
+	loop->running_capacity = capacity;
+
+	p_atomic_int_set (&loop->has_tasks, 0);
+
+	p_mutex_unlock (loop->task_mutex);
+
+	for (i = 0; i < count; ++i)
+		batch[i].func (loop, batch[i].user_data);
+
+	return count;
+}
+
+static ppointer
+pp_event_loop_group_thread (ppointer data)
+{
+	p_event_loop_run ((PEventLoop *) data, NULL);
+
+	return NULL;
+}
+
+P_LIB_API PEventLoop *
+p_event_loop_new (PError **error)
+{
+	PEventLoop *ret;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PEventLoop))) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for event loop");
+		return NULL;
+	}
+
+	p_list_link_init (&ret->timers);
+
+	if (P_UNLIKELY ((ret->poller = p_socket_poller_new (error)) == NULL)) {
+		p_event_loop_free (ret);
+		return NULL;
+	}
+
+	ret->wheel      = p_timer_wheel_new (P_EVENT_LOOP_TIMER_RESOLUTION);
+	ret->sources    = p_hash_table_new ();
+	ret->task_mutex = p_mutex_new ();
+
+	if (P_UNLIKELY (ret->wheel == NULL || ret->sources == NULL || ret->task_mutex == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for event loop");
+		p_event_loop_free (ret);
+		return NULL;
+	}
+
+	if (P_UNLIKELY (pp_event_loop_wake_open (ret, error) == FALSE)) {
+		p_event_loop_free (ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+P_LIB_API pboolean
+p_event_loop_add_socket (PEventLoop		*loop,
+			 PSocket		*socket,
+			 pint			conditions,
+			 pint			flags,
+			 PEventLoopSocketFunc	func,
+			 ppointer		user_data,
+			 PError			**error)
+{
+	PEventLoopSource *source;
+
+	if (P_UNLIKELY (loop == NULL || socket == NULL || func == NULL ||
+			p_hash_table_lookup (loop->sources, socket) != (ppointer) -1)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY ((source = p_malloc0 (sizeof (PEventLoopSource))) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for socket source");
+		return FALSE;
+	}
+
+	source->socket    = socket;
+	source->func      = func;
+	source->user_data = user_data;
+
+	p_hash_table_insert (loop->sources, socket, source);
+
+	if (P_UNLIKELY (p_hash_table_lookup (loop->sources, socket) != source)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for socket source");
+		p_free (source);
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (p_socket_poller_add (loop->poller, socket, conditions, flags, source, error) == FALSE)) {
+		p_hash_table_remove (loop->sources, socket);
+		p_free (source);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_event_loop_modify_socket (PEventLoop	*loop,
+			    PSocket	*socket,
+			    pint	conditions,
+			    pint	flags,
+			    PError	**error)
+{
+	PEventLoopSource *source;
+
+	if (P_UNLIKELY (loop == NULL || socket == NULL ||
+			(source = p_hash_table_lookup (loop->sources, socket)) == (ppointer) -1)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	return p_socket_poller_modify (loop->poller, socket, conditions, flags, source, error);
+}
+
+P_LIB_API pboolean
+p_event_loop_remove_socket (PEventLoop	*loop,
+			    PSocket	*socket,
+			    PError	**error)
+{
+	PEventLoopSource	*source;
+	pint			i;
+
+	if (P_UNLIKELY (loop == NULL || socket == NULL ||
+			(source = p_hash_table_lookup (loop->sources, socket)) == (ppointer) -1)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (p_socket_poller_remove (loop->poller, socket, error) == FALSE))
+		return FALSE;
+
+	/* The socket may be reported later in the batch being dispatched */
+	for (i = loop->dispatch_index + 1; i < loop->n_events; ++i)
+		if (loop->events[i].user_data == source)
+			loop->events[i].user_data = NULL;
+
+	p_hash_table_remove (loop->sources, socket);
+	p_free (source);
+
+	return TRUE;
+}
+
+P_LIB_API PEventLoopTimer *
+p_event_loop_add_timer (PEventLoop		*loop,
+			puint64			delay,
+			puint64			interval,
+			PEventLoopTimerFunc	func,
+			ppointer		user_data)
+{
+	PEventLoopTimer *ret;
+
+	if (P_UNLIKELY (loop == NULL || func == NULL))
+		return NULL;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PEventLoopTimer))) == NULL)) {
+		P_ERROR ("PEventLoop::p_event_loop_add_timer: failed to allocate memory");
+		return NULL;
+	}
+
+	ret->loop      = loop;
+	ret->func      = func;
+	ret->user_data = user_data;
+	ret->interval  = interval;
+
+	ret->timer = p_timer_wheel_schedule (loop->wheel, delay, pp_event_loop_timer_func, ret);
+
+	if (P_UNLIKELY (ret->timer == NULL)) {
+		P_ERROR ("PEventLoop::p_event_loop_add_timer: failed to schedule timer");
+		p_free (ret);
+		return NULL;
+	}
+
+	p_list_link_append (&loop->timers, &ret->link);
+
+	return ret;
+}
+
+P_LIB_API pboolean
+p_event_loop_cancel_timer (PEventLoop		*loop,
+			   PEventLoopTimer	*timer)
+{
+	if (P_UNLIKELY (loop == NULL || timer == NULL || timer->loop != loop || timer->cancelled == TRUE))
+		return FALSE;
+
+	p_timer_wheel_cancel (loop->wheel, timer->timer);
+
+	/* Released after its own callback returns */
+	if (timer->firing == TRUE)
+		timer->cancelled = TRUE;
+	else
+		pp_event_loop_timer_release (timer);
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_event_loop_post (PEventLoop		*loop,
+		   PEventLoopFunc	func,
+		   ppointer		user_data)
+{
+	PEventLoopTask	*new_tasks;
+	psize		new_capacity;
+	pboolean	wake;
+
+	if (P_UNLIKELY (loop == NULL || func == NULL))
+		return FALSE;
+
+	p_mutex_lock (loop->task_mutex);
+
+	if (loop->task_count == loop->task_capacity) {
+		new_capacity = loop->task_capacity < P_EVENT_LOOP_MIN_TASKS ? P_EVENT_LOOP_MIN_TASKS
+									    : loop->task_capacity * 2;
+		new_tasks    = p_realloc (loop->tasks, new_capacity * sizeof (PEventLoopTask));
+
+		if (P_UNLIKELY (new_tasks == NULL)) {
+			p_mutex_unlock (loop->task_mutex);
+			P_ERROR ("PEventLoop::p_event_loop_post: failed to allocate memory");
+			return FALSE;
+		}
+
+		loop->tasks         = new_tasks;
+		loop->task_capacity = new_capacity;
+	}
+
+	loop->tasks[loop->task_count].func      = func;
+	loop->tasks[loop->task_count].user_data = user_data;
+
+	/* Only the first task of a batch wakes the loop up */
+	wake = (++loop->task_count == 1);
+
+	if (wake)
+		p_atomic_int_set (&loop->has_tasks, 1);
+
+	p_mutex_unlock (loop->task_mutex);
+
+	/* The loop thread checks the queue before waiting anyway */
+	if (wake && pp_event_loop_is_loop_thread (loop) == FALSE)
+		p_event_signal (loop->wake_event);
+
+	return TRUE;
+}
+
+P_LIB_API pint
+p_event_loop_run_once (PEventLoop	*loop,
+		       pint		timeout,
+		       PError		**error)
+{
+	PEventLoopSource	*source;
+	pint			wheel_timeout;
+	pint			dispatched;
+	pint			n_events;
+	pint			i;
+
+	if (P_UNLIKELY (loop == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	p_atomic_pointer_set (&loop->thread_id, p_uthread_current_id ());
+
+	if (p_atomic_int_get (&loop->has_tasks) != 0)
+		timeout = 0;
+	else {
+		wheel_timeout = p_timer_wheel_get_timeout (loop->wheel);
+
+		if (wheel_timeout >= 0 && (timeout < 0 || wheel_timeout < timeout))
+			timeout = wheel_timeout;
+	}
+
+	n_events = p_socket_poller_wait (loop->poller, loop->events, P_EVENT_LOOP_MAX_EVENTS, timeout, error);
+
+	if (P_UNLIKELY (n_events < 0))
+		return -1;
+
+	dispatched     = 0;
+	loop->n_events = n_events;
+
+	for (i = 0; i < n_events; ++i) {
+		loop->dispatch_index = i;
+
+		if (loop->events[i].socket == NULL) {
+			p_event_clear (loop->wake_event);
+			continue;
+		}
+
+		/* Removed by one of the previous callbacks */
+		if ((source = loop->events[i].user_data) == NULL)
+			continue;
+
+		source->func (loop, source->socket, loop->events[i].conditions, source->user_data);
+		++dispatched;
+	}
+
+	loop->n_events       = 0;
+	loop->dispatch_index = 0;
+
+	dispatched += (pint) p_timer_wheel_process (loop->wheel);
+	dispatched += (pint) pp_event_loop_run_tasks (loop);
+
+	return dispatched;
+}
+
+P_LIB_API pboolean
+p_event_loop_run (PEventLoop	*loop,
+		  PError	**error)
+{
+	if (P_UNLIKELY (loop == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	while (p_atomic_int_get (&loop->stopped) == 0) {
+		if (P_UNLIKELY (p_event_loop_run_once (loop, -1, error) < 0))
+			return FALSE;
+	}
+
+	/* The loop can be run again */
+	p_atomic_int_set (&loop->stopped, 0);
+
+	return TRUE;
+}
+
+P_LIB_API void
+p_event_loop_stop (PEventLoop *loop)
+{
+	if (P_UNLIKELY (loop == NULL))
+		return;
+
+	p_atomic_int_set (&loop->stopped, 1);
+
+	if (pp_event_loop_is_loop_thread (loop) == FALSE)
+		p_event_signal (loop->wake_event);
+}
+
+P_LIB_API void
+p_event_loop_free (PEventLoop *loop)
+{
+	PList		*sources;
+	PList		*cur;
+
+	if (P_UNLIKELY (loop == NULL))
+		return;
+
+	if (loop->sources != NULL) {
+		sources = p_hash_table_values (loop->sources);
+
+		for (cur = sources; cur != NULL; cur = cur->next)
+			p_free (cur->data);
+
+		p_list_free (sources);
+		p_hash_table_free (loop->sources);
+	}
+
+	/* Wheel timers are released along with the wheel */
+	while (p_list_link_is_empty (&loop->timers) == FALSE)
+		pp_event_loop_timer_release (P_CONTAINER_OF (loop->timers.next, PEventLoopTimer, link));
+
+	if (loop->wheel != NULL)
+		p_timer_wheel_free (loop->wheel);
+
+	if (loop->wake_event != NULL) {
+		if (loop->poller != NULL)
+			p_socket_poller_remove_event (loop->poller, loop->wake_event, NULL);
+
+		p_event_free (loop->wake_event);
+	}
+
+	if (loop->poller != NULL)
+		p_socket_poller_free (loop->poller);
+
+	if (loop->task_mutex != NULL)
+		p_mutex_free (loop->task_mutex);
+
+	p_free (loop->tasks);
+	p_free (loop->running);
+	p_free (loop);
+}
+
+P_LIB_API PEventLoopGroup *
+p_event_loop_group_new (pint	n_loops,
+			PError	**error)
+{
+	PEventLoopGroup	*ret;
+	pint		i;
+
+	if (n_loops <= 0)
+		n_loops = p_uthread_ideal_count ();
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PEventLoopGroup))) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for event loop group");
+		return NULL;
+	}
+
+	ret->loops   = p_malloc0 ((psize) n_loops * sizeof (PEventLoop *));
+	ret->threads = p_malloc0 ((psize) n_loops * sizeof (PUThread *));
+
+	if (P_UNLIKELY (ret->loops == NULL || ret->threads == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for event loop group");
+		p_event_loop_group_free (ret);
+		return NULL;
+	}
+
+	for (i = 0; i < n_loops; ++i) {
+		if (P_UNLIKELY ((ret->loops[i] = p_event_loop_new (error)) == NULL)) {
+			p_event_loop_group_free (ret);
+			return NULL;
+		}
+
+		ret->count = i + 1;
+
+		ret->threads[i] = p_uthread_create ((PUThreadFunc) pp_event_loop_group_thread,
+						    ret->loops[i],
+						    TRUE,
+						    "event-loop");
+
+		if (P_UNLIKELY (ret->threads[i] == NULL)) {
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IO_NO_RESOURCES,
+					     0,
+					     "Failed to start event loop thread");
+			p_event_loop_group_free (ret);
+			return NULL;
+		}
+	}
+
+	return ret;
+}
+
+P_LIB_API pint
+p_event_loop_group_get_count (const PEventLoopGroup *group)
+{
+	if (P_UNLIKELY (group == NULL))
+		return 0;
+
+	return group->count;
+}
+
+P_LIB_API PEventLoop *
+p_event_loop_group_get_loop (PEventLoopGroup	*group,
+			     pint		index)
+{
+	if (P_UNLIKELY (group == NULL || index < 0 || index >= group->count))
+		return NULL;
+
+	return group->loops[index];
+}
+
+P_LIB_API PEventLoop *
+p_event_loop_group_next (PEventLoopGroup *group)
+{
+	puint index;
+
+	if (P_UNLIKELY (group == NULL || group->count == 0))
+		return NULL;
+
+	index = (puint) p_atomic_int_add (&group->next, 1);
+
+	return group->loops[index % (puint) group->count];
+}
+
+P_LIB_API void
+p_event_loop_group_free (PEventLoopGroup *group)
+{
+	pint i;
+
+	if (P_UNLIKELY (group == NULL))
+		return;
+
+	for (i = 0; i < group->count; ++i) {
+		if (group->threads[i] != NULL) {
+			p_event_loop_stop (group->loops[i]);
+			p_uthread_join (group->threads[i]);
+			p_uthread_unref (group->threads[i]);
+		}
+
+		p_event_loop_free (group->loops[i]);
+	}
+
+	p_free (group->threads);
+	p_free (group->loops);
+	p_free (group);
+}
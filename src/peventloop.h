@@ -0,0 +1,329 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file peventloop.h
+ * @brief Event loop for sockets, timers and posted tasks
+ * @author Alexander Saprykin
+ *
+ * An event loop ties together a #PSocketPoller, a #PTimerWheel and a wakeup
+ * channel, so a service thread waits for its sockets, its timers and the work
+ * handed over from the other threads in a single place.
+ *
+ * Register a socket with p_event_loop_add_socket() along with a callback which
+ * is called with the ready conditions, see #PSocketPoller for their meaning.
+ * Timers are added with p_event_loop_add_timer(): a timer with a non-zero
+ * interval is periodic and fires until it is cancelled, a one-shot timer is
+ * released after its callback returns. The timers have a millisecond
+ * resolution and are driven by the coarse monotonic clock.
+ *
+ * Any thread can hand a function over to the loop thread with
+ * p_event_loop_post(). The posted tasks are queued under a short lock and run
+ * in the order of posting, in batches: the loop takes all the queued tasks at
+ * once on each iteration, and the loop thread is woken up only by the first
+ * task of a batch, so a burst of posts costs a single wakeup. The wakeup is a
+ * #PEvent registered in the poller.
+ *
+ * Run the loop with p_event_loop_run() until p_event_loop_stop() is called,
+ * or drive it step by step with p_event_loop_run_once(). Only
+ * p_event_loop_post() and p_event_loop_stop() are thread-safe, the other
+ * calls must be made from the loop thread (or before the loop is started),
+ * usually from the callbacks or the posted tasks.
+ *
+ * #PEventLoopGroup runs one loop per thread, by default as many as
+ * p_uthread_ideal_count() reports. A server usually accepts the connections in
+ * one thread and spreads them over the loops of a group with
+ * p_event_loop_group_next(), posting the registration into the chosen loop.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PEVENTLOOP_H
+#define PLIBSYS_HEADER_PEVENTLOOP_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+#include "psocket.h"
+#include "psocketpoller.h"
+#include "perror.h"
+
+P_BEGIN_DECLS
+
+/** Event loop opaque data type. */
+typedef struct PEventLoop_ PEventLoop;
+
+/** Event loop timer opaque data type. */
+typedef struct PEventLoopTimer_ PEventLoopTimer;
+
+/** Group of event loops running in their own threads, opaque data type. */
+typedef struct PEventLoopGroup_ PEventLoopGroup;
+
+/**
+ * @brief Posted task callback.
+ * @param loop Event loop running the task.
+ * @param user_data Data passed on posting.
+ */
+typedef void (*PEventLoopFunc) (PEventLoop	*loop,
+				ppointer	user_data);
+
+/**
+ * @brief Socket callback.
+ * @param loop Event loop the socket is registered in.
+ * @param socket Ready socket.
+ * @param conditions Combination of #PSocketPollerCondition.
+ * @param user_data Data passed on registration.
+ */
+typedef void (*PEventLoopSocketFunc) (PEventLoop	*loop,
+				      PSocket		*socket,
+				      pint		conditions,
+				      ppointer		user_data);
+
+/**
+ * @brief Timer callback.
+ * @param loop Event loop the timer belongs to.
+ * @param timer Fired timer.
+ * @param user_data Data passed on adding the timer.
+ */
+typedef void (*PEventLoopTimerFunc) (PEventLoop		*loop,
+				     PEventLoopTimer	*timer,
+				     ppointer		user_data);
+
+/**
+ * @brief Creates a new event loop.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Pointer to #PEventLoop in case of success, NULL otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API PEventLoop *		p_event_loop_new		(PError			**error);
+
+/**
+ * @brief Registers a socket in an event loop.
+ * @param loop #PEventLoop to register the socket in.
+ * @param socket Non-blocking #PSocket to register.
+ * @param conditions Combination of #P_SOCKET_POLLER_CONDITION_IN and
+ * #P_SOCKET_POLLER_CONDITION_OUT to wait for.
+ * @param flags Combination of #PSocketPollerFlags.
+ * @param func Function to call when the socket is ready.
+ * @param user_data Data to pass into @a func.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * A socket can be registered only once in the same loop. Remove it with
+ * p_event_loop_remove_socket() before closing or freeing it.
+ */
+P_LIB_API pboolean		p_event_loop_add_socket		(PEventLoop		*loop,
+								 PSocket		*socket,
+								 pint			conditions,
+								 pint			flags,
+								 PEventLoopSocketFunc	func,
+								 ppointer		user_data,
+								 PError			**error);
+
+/**
+ * @brief Changes the conditions a socket is waited for.
+ * @param loop #PEventLoop the socket is registered in.
+ * @param socket #PSocket to change the registration for.
+ * @param conditions Combination of #P_SOCKET_POLLER_CONDITION_IN and
+ * #P_SOCKET_POLLER_CONDITION_OUT to wait for.
+ * @param flags Combination of #PSocketPollerFlags.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean		p_event_loop_modify_socket	(PEventLoop		*loop,
+								 PSocket		*socket,
+								 pint			conditions,
+								 pint			flags,
+								 PError			**error);
+
+/**
+ * @brief Unregisters a socket from an event loop.
+ * @param loop #PEventLoop the socket is registered in.
+ * @param socket #PSocket to unregister.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * Can be called from any callback, the socket callback is not called anymore
+ * even if the socket was already reported as ready in the current iteration.
+ */
+P_LIB_API pboolean		p_event_loop_remove_socket	(PEventLoop		*loop,
+								 PSocket		*socket,
+								 PError			**error);
+
+/**
+ * @brief Adds a timer to an event loop.
+ * @param loop #PEventLoop to add the timer to.
+ * @param delay Delay before the first firing, in milliseconds.
+ * @param interval Interval between the next firings in milliseconds, 0 for a
+ * one-shot timer.
+ * @param func Function to call when the timer fires.
+ * @param user_data Data to pass into @a func.
+ * @return Pointer to the new timer in case of success, NULL otherwise.
+ * @since 0.0.5
+ *
+ * A periodic timer doesn't drift: each firing is counted from the previous
+ * deadline, not from the moment its callback was called. A one-shot timer is
+ * released after its callback returns, and its pointer must not be used
+ * anymore.
+ */
+P_LIB_API PEventLoopTimer *	p_event_loop_add_timer		(PEventLoop		*loop,
+								 puint64		delay,
+								 puint64		interval,
+								 PEventLoopTimerFunc	func,
+								 ppointer		user_data);
+
+/**
+ * @brief Cancels a timer.
+ * @param loop #PEventLoop the timer belongs to.
+ * @param timer Timer to cancel.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The timer is released and its pointer must not be used anymore. It can be
+ * called from the timer callback itself.
+ */
+P_LIB_API pboolean		p_event_loop_cancel_timer	(PEventLoop		*loop,
+								 PEventLoopTimer	*timer);
+
+/**
+ * @brief Posts a task to be run in the loop thread.
+ * @param loop #PEventLoop to run the task in.
+ * @param func Function to call.
+ * @param user_data Data to pass into @a func.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * This call is thread-safe. The tasks run in the order of posting, the ones
+ * posted from the loop thread itself run in the same iteration. The tasks
+ * still queued when the loop is freed are dropped.
+ */
+P_LIB_API pboolean		p_event_loop_post		(PEventLoop		*loop,
+								 PEventLoopFunc		func,
+								 ppointer		user_data);
+
+/**
+ * @brief Runs a single iteration of an event loop.
+ * @param loop #PEventLoop to run.
+ * @param timeout Maximum time to wait for the events in milliseconds, -1 to
+ * wait until any event happens, 0 to return immediately.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Number of called callbacks and tasks, -1 in case of error.
+ * @since 0.0.5
+ *
+ * The wait ends earlier if a timer is due or a task is posted. Ready sockets
+ * are dispatched first, then the expired timers, then the posted tasks.
+ */
+P_LIB_API pint			p_event_loop_run_once		(PEventLoop		*loop,
+								 pint			timeout,
+								 PError			**error);
+
+/**
+ * @brief Runs an event loop until it is stopped.
+ * @param loop #PEventLoop to run.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE if the loop was stopped, FALSE in case of error.
+ * @since 0.0.5
+ *
+ * The calling thread becomes the loop thread until the call returns.
+ */
+P_LIB_API pboolean		p_event_loop_run		(PEventLoop		*loop,
+								 PError			**error);
+
+/**
+ * @brief Stops an event loop.
+ * @param loop #PEventLoop to stop.
+ * @since 0.0.5
+ *
+ * This call is thread-safe. p_event_loop_run() returns after the current
+ * iteration. A loop which is not running yet returns from the next
+ * p_event_loop_run() call right away.
+ */
+P_LIB_API void			p_event_loop_stop		(PEventLoop		*loop);
+
+/**
+ * @brief Frees an event loop.
+ * @param loop #PEventLoop to free.
+ * @since 0.0.5
+ *
+ * The loop must not be running. The registered sockets are not closed or
+ * freed, the pending timers and tasks are dropped without calling them.
+ */
+P_LIB_API void			p_event_loop_free		(PEventLoop		*loop);
+
+/**
+ * @brief Creates event loops and starts a thread for each one.
+ * @param n_loops Number of loops, 0 or less to use p_uthread_ideal_count().
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Pointer to #PEventLoopGroup in case of success, NULL otherwise.
+ * @since 0.0.5
+ *
+ * Every loop runs p_event_loop_run() in its own thread, interact with the
+ * loops of the group with p_event_loop_post().
+ */
+P_LIB_API PEventLoopGroup *	p_event_loop_group_new		(pint			n_loops,
+								 PError			**error);
+
+/**
+ * @brief Gets the number of loops in a group.
+ * @param group #PEventLoopGroup to get the number for.
+ * @return Number of loops.
+ * @since 0.0.5
+ */
+P_LIB_API pint			p_event_loop_group_get_count	(const PEventLoopGroup	*group);
+
+/**
+ * @brief Gets a loop of a group by its index.
+ * @param group #PEventLoopGroup to get the loop from.
+ * @param index Index of the loop, from 0 to the number of loops minus 1.
+ * @return Pointer to #PEventLoop in case of success, NULL otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API PEventLoop *		p_event_loop_group_get_loop	(PEventLoopGroup	*group,
+								 pint			index);
+
+/**
+ * @brief Picks the next loop of a group in the round-robin order.
+ * @param group #PEventLoopGroup to pick the loop from.
+ * @return Pointer to #PEventLoop in case of success, NULL otherwise.
+ * @since 0.0.5
+ *
+ * This call is thread-safe.
+ */
+P_LIB_API PEventLoop *		p_event_loop_group_next		(PEventLoopGroup	*group);
+
+/**
+ * @brief Stops all the loops of a group, joins their threads and frees them.
+ * @param group #PEventLoopGroup to free.
+ * @since 0.0.5
+ */
+P_LIB_API void			p_event_loop_group_free		(PEventLoopGroup	*group);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PEVENTLOOP_H */
@@ -0,0 +1,826 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* XXH3 from xxHash 0.8 by Yann Collet. Inputs up to 240 bytes are mixed
+ * directly with a few multiplications, longer ones are consumed in 64 bytes
+ * stripes by eight independent accumulators, which are scrambled after each
+ * block of 16 stripes and merged at the end. The stream keeps the last stripe
+ * of the consumed data, as the final stripe always ends at the last byte and
+ * may overlap the consumed ones. */
+
+#include <string.h>
+
+#include "pfasthash-xxh3.h"
+
+#if defined (P_CPU_X86_64) || defined (__SSE2__) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define P_XXH3_SSE2
+#endif
+
+#if defined (P_CC_MSVC) && defined (P_CPU_X86_64)
+#  include <intrin.h>
+#endif
+
+#define P_XXH3_PRIME32_1		0x9E3779B1U
+#define P_XXH3_PRIME32_2		0x85EBCA77U
+#define P_XXH3_PRIME32_3		0xC2B2AE3DU
+#define P_XXH3_PRIME64_1		0x9E3779B185EBCA87ULL
+#define P_XXH3_PRIME64_2		0xC2B2AE3D27D4EB4FULL
+#define P_XXH3_PRIME64_3		0x165667B19E3779F9ULL
+#define P_XXH3_PRIME64_4		0x85EBCA77C2B2AE63ULL
+#define P_XXH3_PRIME64_5		0x27D4EB2F165667C5ULL
+#define P_XXH3_PRIME_MX1		0x165667919E3779F9ULL
+#define P_XXH3_PRIME_MX2		0x9FB21C651E98DF25ULL
+
+#define P_XXH3_MIDSIZE_MAX		240
+#define P_XXH3_MIDSIZE_START_OFFSET	3
+#define P_XXH3_MIDSIZE_LAST_OFFSET	17
+#define P_XXH3_SECRET_SIZE_MIN		136
+#define P_XXH3_SECRET_CONSUME_RATE	8
+#define P_XXH3_SECRET_LAST_ACC_START	7
+#define P_XXH3_SECRET_MERGE_ACCS_START	11
+#define P_XXH3_SECRET_LIMIT		(P_XXH3_SECRET_SIZE - P_XXH3_STRIPE_LEN)
+#define P_XXH3_STRIPES_PER_BLOCK	(P_XXH3_SECRET_LIMIT / P_XXH3_SECRET_CONSUME_RATE)
+#define P_XXH3_BLOCK_LEN		(P_XXH3_STRIPE_LEN * P_XXH3_STRIPES_PER_BLOCK)
+#define P_XXH3_BUFFER_STRIPES		(P_XXH3_BUFFER_SIZE / P_XXH3_STRIPE_LEN)
+
+#define P_XXH3_ROTL32(val, shift) (((val) << (shift)) | ((val) >> (32 - (shift))))
+#define P_XXH3_ROTL64(val, shift) (((val) << (shift)) | ((val) >> (64 - (shift))))
+
+static const puchar pp_fast_hash_xxh3_secret[P_XXH3_SECRET_SIZE] = {
+	0xB8, 0xFE, 0x6C, 0x39, 0x23, 0xA4, 0x4B, 0xBE, 0x7C, 0x01, 0x81, 0x2C,
+	0xF7, 0x21, 0xAD, 0x1C, 0xDE, 0xD4, 0x6D, 0xE9, 0x83, 0x90, 0x97, 0xDB,
+	0x72, 0x40, 0xA4, 0xA4, 0xB7, 0xB3, 0x67, 0x1F, 0xCB, 0x79, 0xE6, 0x4E,
+	0xCC, 0xC0, 0xE5, 0x78, 0x82, 0x5A, 0xD0, 0x7D, 0xCC, 0xFF, 0x72, 0x21,
+	0xB8, 0x08, 0x46, 0x74, 0xF7, 0x43, 0x24, 0x8E, 0xE0, 0x35, 0x90, 0xE6,
+	0x81, 0x3A, 0x26, 0x4C, 0x3C, 0x28, 0x52, 0xBB, 0x91, 0xC3, 0x00, 0xCB,
+	0x88, 0xD0, 0x65, 0x8B, 0x1B, 0x53, 0x2E, 0xA3, 0x71, 0x64, 0x48, 0x97,
+	0xA2, 0x0D, 0xF9, 0x4E, 0x38, 0x19, 0xEF, 0x46, 0xA9, 0xDE, 0xAC, 0xD8,
+	0xA8, 0xFA, 0x76, 0x3F, 0xE3, 0x9C, 0x34, 0x3F, 0xF9, 0xDC, 0xBB, 0xC7,
+	0xC7, 0x0B, 0x4F, 0x1D, 0x8A, 0x51, 0xE0, 0x4B, 0xCD, 0xB4, 0x59, 0x31,
+	0xC8, 0x9F, 0x7E, 0xC9, 0xD9, 0x78, 0x73, 0x64, 0xEA, 0xC5, 0xAC, 0x83,
+	0x34, 0xD3, 0xEB, 0xC3, 0xC5, 0x81, 0xA0, 0xFF, 0xFA, 0x13, 0x63, 0xEB,
+	0x17, 0x0D, 0xDD, 0x51, 0xB7, 0xF0, 0xDA, 0x49, 0xD3, 0x16, 0x55, 0x26,
+	0x29, 0xD4, 0x68, 0x9E, 0x2B, 0x16, 0xBE, 0x58, 0x7D, 0x47, 0xA1, 0xFC,
+	0x8F, 0xF8, 0xB8, 0xD1, 0x7A, 0xD0, 0x31, 0xCE, 0x45, 0xCB, 0x3A, 0x8F,
+	0x95, 0x16, 0x04, 0x28, 0xAF, 0xD7, 0xFB, 0xCA, 0xBB, 0x4B, 0x40, 0x7E
+};
+
+static const puint64 pp_fast_hash_xxh3_acc_init[8] = {
+	P_XXH3_PRIME32_3, P_XXH3_PRIME64_1, P_XXH3_PRIME64_2, P_XXH3_PRIME64_3,
+	P_XXH3_PRIME64_4, P_XXH3_PRIME32_2, P_XXH3_PRIME64_5, P_XXH3_PRIME32_1
+};
+
+static puint32 pp_fast_hash_xxh3_read32 (const puchar *data);
+static puint64 pp_fast_hash_xxh3_read64 (const puchar *data);
+static puint64 pp_fast_hash_xxh3_mul128 (puint64 a, puint64 b, puint64 *high);
+static puint64 pp_fast_hash_xxh3_mul128_fold64 (puint64 a, puint64 b);
+static puint64 pp_fast_hash_xxh3_xxh64_avalanche (puint64 h);
+static puint64 pp_fast_hash_xxh3_avalanche (puint64 h);
+static puint64 pp_fast_hash_xxh3_rrmxmx (puint64 h, puint64 len);
+static puint64 pp_fast_hash_xxh3_mix16 (const puchar *data, const puchar *secret, puint64 seed);
+static void pp_fast_hash_xxh3_mix32 (puint64 acc[2], const puchar *data1, const puchar *data2,
+				     const puchar *secret, puint64 seed);
+static puint64 pp_fast_hash_xxh3_short_64 (const puchar *data, psize len, puint64 seed);
+static void pp_fast_hash_xxh3_short_128 (const puchar *data, psize len, puint64 seed,
+					 puint64 *low, puint64 *high);
+static void pp_fast_hash_xxh3_init_secret (puchar *secret, puint64 seed);
+static void pp_fast_hash_xxh3_accumulate_512 (puint64 acc[8], const puchar *data, const puchar *secret);
+static void pp_fast_hash_xxh3_scramble (puint64 acc[8], const puchar *secret);
+static void pp_fast_hash_xxh3_accumulate (puint64 acc[8], const puchar *data, const puchar *secret, psize stripes);
+static void pp_fast_hash_xxh3_consume_stripes (puint64 acc[8], puint *stripes_so_far, const puchar *data,
+					       psize stripes, const puchar *secret);
+static void pp_fast_hash_xxh3_hash_long (puint64 acc[8], const puchar *data, psize len, const puchar *secret);
+static void pp_fast_hash_xxh3_digest_long (const PHashXXH3 *ctx, puint64 acc[8]);
+static puint64 pp_fast_hash_xxh3_merge_accs (const puint64 acc[8], const puchar *secret, puint64 start);
+
+static puint32
+pp_fast_hash_xxh3_read32 (const puchar *data)
+{
+	puint32 val;
+
+	memcpy (&val, data, sizeof (val));
+
+	return PUINT32_FROM_LE (val);
+}
+
+static puint64
+pp_fast_hash_xxh3_read64 (const puchar *data)
+{
+	puint64 val;
+
+	memcpy (&val, data, sizeof (val));
+
+	return PUINT64_FROM_LE (val);
+}
+
+static puint64
+pp_fast_hash_xxh3_mul128 (puint64	a,
+			  puint64	b,
+			  puint64	*high)
+{
+#if defined (__SIZEOF_INT128__)
+	__uint128_t product = (__uint128_t) a * b;
+
+	*high = (puint64) (product >> 64);
+
+	return (puint64) product;
+#elif defined (P_CC_MSVC) && defined (P_CPU_X86_64)
+	return _umul128 (a, b, high);
+#else
+	puint64	lo_lo, hi_lo, lo_hi, hi_hi;
+	puint64	cross;
+
+	lo_lo = (a & 0xFFFFFFFF) * (b & 0xFFFFFFFF);
+	hi_lo = (a >> 32)        * (b & 0xFFFFFFFF);
+	lo_hi = (a & 0xFFFFFFFF) * (b >> 32);
+	hi_hi = (a >> 32)        * (b >> 32);
+
+	cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+	*high = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+
+	return (cross << 32) | (lo_lo & 0xFFFFFFFF);
+#endif
+}
+
+static puint64
+pp_fast_hash_xxh3_mul128_fold64 (puint64	a,
+				 puint64	b)
+{
+	puint64 high;
+	puint64 low;
+
+	low = pp_fast_hash_xxh3_mul128 (a, b, &high);
+
+	return low ^ high;
+}
+
+static puint64
+pp_fast_hash_xxh3_xxh64_avalanche (puint64 h)
+{
+	h ^= h >> 33;
+	h *= P_XXH3_PRIME64_2;
+	h ^= h >> 29;
+	h *= P_XXH3_PRIME64_3;
+	h ^= h >> 32;
+
+	return h;
+}
+
+static puint64
+pp_fast_hash_xxh3_avalanche (puint64 h)
+{
+	h ^= h >> 37;
+	h *= P_XXH3_PRIME_MX1;
+	h ^= h >> 32;
+
+	return h;
+}
+
+static puint64
+pp_fast_hash_xxh3_rrmxmx (puint64	h,
+			  puint64	len)
+{
+	h ^= P_XXH3_ROTL64 (h, 49) ^ P_XXH3_ROTL64 (h, 24);
+	h *= P_XXH3_PRIME_MX2;
+	h ^= (h >> 35) + len;
+	h *= P_XXH3_PRIME_MX2;
+	h ^= h >> 28;
+
+	return h;
+}
+
+static puint64
+pp_fast_hash_xxh3_mix16 (const puchar	*data,
+			 const puchar	*secret,
+			 puint64	seed)
+{
+	return pp_fast_hash_xxh3_mul128_fold64 (pp_fast_hash_xxh3_read64 (data) ^
+						(pp_fast_hash_xxh3_read64 (secret) + seed),
+						pp_fast_hash_xxh3_read64 (data + 8) ^
+						(pp_fast_hash_xxh3_read64 (secret + 8) - seed));
+}
+
+static void
+pp_fast_hash_xxh3_mix32 (puint64	acc[2],
+			 const puchar	*data1,
+			 const puchar	*data2,
+			 const puchar	*secret,
+			 puint64	seed)
+{
+	acc[0] += pp_fast_hash_xxh3_mix16 (data1, secret, seed);
+	acc[0] ^= pp_fast_hash_xxh3_read64 (data2) + pp_fast_hash_xxh3_read64 (data2 + 8);
+	acc[1] += pp_fast_hash_xxh3_mix16 (data2, secret + 16, seed);
+	acc[1] ^= pp_fast_hash_xxh3_read64 (data1) + pp_fast_hash_xxh3_read64 (data1 + 8);
+}
+
+static puint64
+pp_fast_hash_xxh3_short_64 (const puchar	*data,
+			    psize		len,
+			    puint64		seed)
+{
+	const puchar	*secret = pp_fast_hash_xxh3_secret;
+	puint64		acc;
+	puint64		bitflip1, bitflip2;
+	puint64		input1, input2;
+	puint32		combined;
+	psize		i;
+
+	if (len == 0)
+		return pp_fast_hash_xxh3_xxh64_avalanche (seed ^ (pp_fast_hash_xxh3_read64 (secret + 56) ^
+								  pp_fast_hash_xxh3_read64 (secret + 64)));
+
+	if (len <= 3) {
+		combined = ((puint32) data[0] << 16) | ((puint32) data[len >> 1] << 24) |
+			   ((puint32) data[len - 1]) | ((puint32) len << 8);
+		bitflip1 = (pp_fast_hash_xxh3_read32 (secret) ^ pp_fast_hash_xxh3_read32 (secret + 4)) + seed;
+
+		return pp_fast_hash_xxh3_xxh64_avalanche ((puint64) combined ^ bitflip1);
+	}
+
+	if (len <= 8) {
+		seed    ^= (puint64) PUINT32_SWAP_BYTES ((puint32) seed) << 32;
+		input1   = pp_fast_hash_xxh3_read32 (data);
+		input2   = pp_fast_hash_xxh3_read32 (data + len - 4);
+		bitflip1 = (pp_fast_hash_xxh3_read64 (secret + 8) ^ pp_fast_hash_xxh3_read64 (secret + 16)) - seed;
+
+		return pp_fast_hash_xxh3_rrmxmx ((input2 + (input1 << 32)) ^ bitflip1, len);
+	}
+
+	if (len <= 16) {
+		bitflip1 = (pp_fast_hash_xxh3_read64 (secret + 24) ^ pp_fast_hash_xxh3_read64 (secret + 32)) + seed;
+		bitflip2 = (pp_fast_hash_xxh3_read64 (secret + 40) ^ pp_fast_hash_xxh3_read64 (secret + 48)) - seed;
+		input1   = pp_fast_hash_xxh3_read64 (data) ^ bitflip1;
+		input2   = pp_fast_hash_xxh3_read64 (data + len - 8) ^ bitflip2;
+
+		acc = len + PUINT64_SWAP_BYTES (input1) + input2 + pp_fast_hash_xxh3_mul128_fold64 (input1, input2);
+
+		return pp_fast_hash_xxh3_avalanche (acc);
+	}
+
+	acc = len * P_XXH3_PRIME64_1;
+
+	if (len <= 128) {
+		if (len > 32) {
+			if (len > 64) {
+				if (len > 96) {
+					acc += pp_fast_hash_xxh3_mix16 (data + 48, secret + 96, seed);
+					acc += pp_fast_hash_xxh3_mix16 (data + len - 64, secret + 112, seed);
+				}
+
+				acc += pp_fast_hash_xxh3_mix16 (data + 32, secret + 64, seed);
+				acc += pp_fast_hash_xxh3_mix16 (data + len - 48, secret + 80, seed);
+			}
+
+			acc += pp_fast_hash_xxh3_mix16 (data + 16, secret + 32, seed);
+			acc += pp_fast_hash_xxh3_mix16 (data + len - 32, secret + 48, seed);
+		}
+
+		acc += pp_fast_hash_xxh3_mix16 (data, secret, seed);
+		acc += pp_fast_hash_xxh3_mix16 (data + len - 16, secret + 16, seed);
+
+		return pp_fast_hash_xxh3_avalanche (acc);
+	}
+
+	for (i = 0; i < 8; ++i)
+		acc += pp_fast_hash_xxh3_mix16 (data + 16 * i, secret + 16 * i, seed);
+
+	acc = pp_fast_hash_xxh3_avalanche (acc);
+
+	for (i = 8; i < len / 16; ++i)
+		acc += pp_fast_hash_xxh3_mix16 (data + 16 * i,
+						secret + 16 * (i - 8) + P_XXH3_MIDSIZE_START_OFFSET,
+						seed);
+
+	acc += pp_fast_hash_xxh3_mix16 (data + len - 16,
+					secret + P_XXH3_SECRET_SIZE_MIN - P_XXH3_MIDSIZE_LAST_OFFSET,
+					seed);
+
+	return pp_fast_hash_xxh3_avalanche (acc);
+}
+
+static void
+pp_fast_hash_xxh3_short_128 (const puchar	*data,
+			     psize		len,
+			     puint64		seed,
+			     puint64		*low,
+			     puint64		*high)
+{
+	const puchar	*secret = pp_fast_hash_xxh3_secret;
+	puint64		acc[2];
+	puint64		bitflip1, bitflip2;
+	puint64		input1, input2;
+	puint64		m_low, m_high;
+	puint32		combined_low, combined_high;
+	psize		i;
+
+	if (len == 0) {
+		*low  = pp_fast_hash_xxh3_xxh64_avalanche (seed ^ pp_fast_hash_xxh3_read64 (secret + 64) ^
+							   pp_fast_hash_xxh3_read64 (secret + 72));
+		*high = pp_fast_hash_xxh3_xxh64_avalanche (seed ^ pp_fast_hash_xxh3_read64 (secret + 80) ^
+							   pp_fast_hash_xxh3_read64 (secret + 88));
+		return;
+	}
+
+	if (len <= 3) {
+		combined_low  = ((puint32) data[0] << 16) | ((puint32) data[len >> 1] << 24) |
+				((puint32) data[len - 1]) | ((puint32) len << 8);
+		combined_high = PUINT32_SWAP_BYTES (combined_low);
+		combined_high = P_XXH3_ROTL32 (combined_high, 13);
+
+		bitflip1 = (pp_fast_hash_xxh3_read32 (secret) ^ pp_fast_hash_xxh3_read32 (secret + 4)) + seed;
+		bitflip2 = (pp_fast_hash_xxh3_read32 (secret + 8) ^ pp_fast_hash_xxh3_read32 (secret + 12)) - seed;
+
+		*low  = pp_fast_hash_xxh3_xxh64_avalanche ((puint64) combined_low ^ bitflip1);
+		*high = pp_fast_hash_xxh3_xxh64_avalanche ((puint64) combined_high ^ bitflip2);
+		return;
+	}
+
+	if (len <= 8) {
+		seed    ^= (puint64) PUINT32_SWAP_BYTES ((puint32) seed) << 32;
+		input1   = pp_fast_hash_xxh3_read32 (data);
+		input2   = pp_fast_hash_xxh3_read32 (data + len - 4);
+		bitflip1 = (pp_fast_hash_xxh3_read64 (secret + 16) ^ pp_fast_hash_xxh3_read64 (secret + 24)) + seed;
+
+		m_low = pp_fast_hash_xxh3_mul128 ((input1 + (input2 << 32)) ^ bitflip1,
+						  P_XXH3_PRIME64_1 + ((puint64) len << 2),
+						  &m_high);
+
+		m_high += m_low << 1;
+		m_low  ^= m_high >> 3;
+		m_low  ^= m_low >> 35;
+		m_low  *= P_XXH3_PRIME_MX2;
+		m_low  ^= m_low >> 28;
+
+		*low  = m_low;
+		*high = pp_fast_hash_xxh3_avalanche (m_high);
+		return;
+	}
+
+	if (len <= 16) {
+		bitflip1 = (pp_fast_hash_xxh3_read64 (secret + 32) ^ pp_fast_hash_xxh3_read64 (secret + 40)) - seed;
+		bitflip2 = (pp_fast_hash_xxh3_read64 (secret + 48) ^ pp_fast_hash_xxh3_read64 (secret + 56)) + seed;
+		input1   = pp_fast_hash_xxh3_read64 (data);
+		input2   = pp_fast_hash_xxh3_read64 (data + len - 8);
+
+		m_low = pp_fast_hash_xxh3_mul128 (input1 ^ input2 ^ bitflip1, P_XXH3_PRIME64_1, &m_high);
+
+		m_low  += (puint64) (len - 1) << 54;
+		input2 ^= bitflip2;
+		m_high += input2 + (puint64) (puint32) input2 * (P_XXH3_PRIME32_2 - 1);
+		m_low  ^= PUINT64_SWAP_BYTES (m_high);
+
+		*low  = pp_fast_hash_xxh3_mul128 (m_low, P_XXH3_PRIME64_2, high);
+		*high += m_high * P_XXH3_PRIME64_2;
+
+		*low  = pp_fast_hash_xxh3_avalanche (*low);
+		*high = pp_fast_hash_xxh3_avalanche (*high);
+		return;
+	}
+
+	acc[0] = len * P_XXH3_PRIME64_1;
+	acc[1] = 0;
+
+	if (len <= 128) {
+		if (len > 32) {
+			if (len > 64) {
+				if (len > 96)
+					pp_fast_hash_xxh3_mix32 (acc, data + 48, data + len - 64, secret + 96, seed);
+
+				pp_fast_hash_xxh3_mix32 (acc, data + 32, data + len - 48, secret + 64, seed);
+			}
+
+			pp_fast_hash_xxh3_mix32 (acc, data + 16, data + len - 32, secret + 32, seed);
+		}
+
+		pp_fast_hash_xxh3_mix32 (acc, data, data + len - 16, secret, seed);
+	} else {
+		for (i = 0; i < 4; ++i)
+			pp_fast_hash_xxh3_mix32 (acc, data + 32 * i, data + 32 * i + 16, secret + 32 * i, seed);
+
+		acc[0] = pp_fast_hash_xxh3_avalanche (acc[0]);
+		acc[1] = pp_fast_hash_xxh3_avalanche (acc[1]);
+
+		for (i = 4; i < len / 32; ++i)
+			pp_fast_hash_xxh3_mix32 (acc,
+						 data + 32 * i,
+						 data + 32 * i + 16,
+						 secret + P_XXH3_MIDSIZE_START_OFFSET + 32 * (i - 4),
+						 seed);
+
+		pp_fast_hash_xxh3_mix32 (acc,
+					 data + len - 16,
+					 data + len - 32,
+					 secret + P_XXH3_SECRET_SIZE_MIN - P_XXH3_MIDSIZE_LAST_OFFSET - 16,
+					 0 - seed);
+	}
+
+	*low  = pp_fast_hash_xxh3_avalanche (acc[0] + acc[1]);
+	*high = 0 - pp_fast_hash_xxh3_avalanche (acc[0] * P_XXH3_PRIME64_1 +
+						 acc[1] * P_XXH3_PRIME64_4 +
+						 (len - seed) * P_XXH3_PRIME64_2);
+}
+
+static void
+pp_fast_hash_xxh3_init_secret (puchar	*secret,
+			       puint64	seed)
+{
+	puint64	lo, hi;
+	puint	i;
+
+	for (i = 0; i < P_XXH3_SECRET_SIZE; i += 16) {
+		lo = PUINT64_TO_LE (pp_fast_hash_xxh3_read64 (pp_fast_hash_xxh3_secret + i) + seed);
+		hi = PUINT64_TO_LE (pp_fast_hash_xxh3_read64 (pp_fast_hash_xxh3_secret + i + 8) - seed);
+
+		memcpy (secret + i, &lo, 8);
+		memcpy (secret + i + 8, &hi, 8);
+	}
+}
+
+static void
+pp_fast_hash_xxh3_accumulate_512 (puint64	acc[8],
+				  const puchar	*data,
+				  const puchar	*secret)
+{
+#ifdef P_XXH3_SSE2
+	__m128i	acc_vec, data_vec, key_vec;
+	__m128i	data_key, data_key_hi, product, data_swap;
+	puint	i;
+
+	for (i = 0; i < 4; ++i) {
+		acc_vec  = _mm_loadu_si128 ((const __m128i *) (acc + 2 * i));
+		data_vec = _mm_loadu_si128 ((const __m128i *) (data + 16 * i));
+		key_vec  = _mm_loadu_si128 ((const __m128i *) (secret + 16 * i));
+
+		/* Low halves of data ^ key multiplied by the high ones */
+		data_key    = _mm_xor_si128 (data_vec, key_vec);
+		data_key_hi = _mm_shuffle_epi32 (data_key, _MM_SHUFFLE (0, 3, 0, 1));
+		product     = _mm_mul_epu32 (data_key, data_key_hi);
+
+		/* Lanes are swapped so the input reaches the neighbour */
+		data_swap = _mm_shuffle_epi32 (data_vec, _MM_SHUFFLE (1, 0, 3, 2));
+		acc_vec   = _mm_add_epi64 (acc_vec, data_swap);
+		acc_vec   = _mm_add_epi64 (acc_vec, product);
+
+		_mm_storeu_si128 ((__m128i *) (acc + 2 * i), acc_vec);
+	}
+#else
+	puint64	data_val, data_key;
+	puint	i;
+
+	for (i = 0; i < 8; ++i) {
+		data_val = pp_fast_hash_xxh3_read64 (data + 8 * i);
+		data_key = data_val ^ pp_fast_hash_xxh3_read64 (secret + 8 * i);
+
+		acc[i ^ 1] += data_val;
+		acc[i]     += (data_key & 0xFFFFFFFF) * (data_key >> 32);
+	}
+#endif
+}
+
+static void
+pp_fast_hash_xxh3_scramble (puint64		acc[8],
+			    const puchar	*secret)
+{
+#ifdef P_XXH3_SSE2
+	__m128i	acc_vec, key_vec, prime;
+	__m128i	product_lo, product_hi;
+	puint	i;
+
+	prime = _mm_set1_epi32 ((pint) P_XXH3_PRIME32_1);
+
+	for (i = 0; i < 4; ++i) {
+		acc_vec = _mm_loadu_si128 ((const __m128i *) (acc + 2 * i));
+		key_vec = _mm_loadu_si128 ((const __m128i *) (secret + 16 * i));
+
+		acc_vec = _mm_xor_si128 (acc_vec, _mm_srli_epi64 (acc_vec, 47));
+		acc_vec = _mm_xor_si128 (acc_vec, key_vec);
+
+		/* 64-bit lanes multiplied by a 32-bit constant */
+		product_lo = _mm_mul_epu32 (acc_vec, prime);
+		product_hi = _mm_mul_epu32 (_mm_shuffle_epi32 (acc_vec, _MM_SHUFFLE (0, 3, 0, 1)), prime);
+		acc_vec    = _mm_add_epi64 (product_lo, _mm_slli_epi64 (product_hi, 32));
+
+		_mm_storeu_si128 ((__m128i *) (acc + 2 * i), acc_vec);
+	}
+#else
+	puint64	val;
+	puint	i;
+
+	for (i = 0; i < 8; ++i) {
+		val  = acc[i];
+		val ^= val >> 47;
+		val ^= pp_fast_hash_xxh3_read64 (secret + 8 * i);
+		val *= P_XXH3_PRIME32_1;
+
+		acc[i] = val;
+	}
+#endif
+}
+
+static void
+pp_fast_hash_xxh3_accumulate (puint64		acc[8],
+			      const puchar	*data,
+			      const puchar	*secret,
+			      psize		stripes)
+{
+	psize i;
+
+	for (i = 0; i < stripes; ++i)
+		pp_fast_hash_xxh3_accumulate_512 (acc,
+						  data + i * P_XXH3_STRIPE_LEN,
+						  secret + i * P_XXH3_SECRET_CONSUME_RATE);
+}
+
+/* Stripes must not span more than one block boundary */
+static void
+pp_fast_hash_xxh3_consume_stripes (puint64		acc[8],
+				   puint		*stripes_so_far,
+				   const puchar		*data,
+				   psize		stripes,
+				   const puchar		*secret)
+{
+	psize to_end;
+
+	to_end = P_XXH3_STRIPES_PER_BLOCK - *stripes_so_far;
+
+	if (stripes >= to_end) {
+		pp_fast_hash_xxh3_accumulate (acc,
+					      data,
+					      secret + *stripes_so_far * P_XXH3_SECRET_CONSUME_RATE,
+					      to_end);
+		pp_fast_hash_xxh3_scramble (acc, secret + P_XXH3_SECRET_LIMIT);
+		pp_fast_hash_xxh3_accumulate (acc, data + to_end * P_XXH3_STRIPE_LEN, secret, stripes - to_end);
+
+		*stripes_so_far = (puint) (stripes - to_end);
+	} else {
+		pp_fast_hash_xxh3_accumulate (acc,
+					      data,
+					      secret + *stripes_so_far * P_XXH3_SECRET_CONSUME_RATE,
+					      stripes);
+
+		*stripes_so_far += (puint) stripes;
+	}
+}
+
+static void
+pp_fast_hash_xxh3_hash_long (puint64		acc[8],
+			     const puchar	*data,
+			     psize		len,
+			     const puchar	*secret)
+{
+	psize	blocks;
+	psize	stripes;
+	psize	i;
+
+	memcpy (acc, pp_fast_hash_xxh3_acc_init, sizeof (pp_fast_hash_xxh3_acc_init));
+
+	blocks = (len - 1) / P_XXH3_BLOCK_LEN;
+
+	for (i = 0; i < blocks; ++i) {
+		pp_fast_hash_xxh3_accumulate (acc, data + i * P_XXH3_BLOCK_LEN, secret, P_XXH3_STRIPES_PER_BLOCK);
+		pp_fast_hash_xxh3_scramble (acc, secret + P_XXH3_SECRET_LIMIT);
+	}
+
+	stripes = ((len - 1) - blocks * P_XXH3_BLOCK_LEN) / P_XXH3_STRIPE_LEN;
+
+	pp_fast_hash_xxh3_accumulate (acc, data + blocks * P_XXH3_BLOCK_LEN, secret, stripes);
+
+	/* The last stripe always ends at the last byte */
+	pp_fast_hash_xxh3_accumulate_512 (acc,
+					  data + len - P_XXH3_STRIPE_LEN,
+					  secret + P_XXH3_SECRET_LIMIT - P_XXH3_SECRET_LAST_ACC_START);
+}
+
+static puint64
+pp_fast_hash_xxh3_merge_accs (const puint64	acc[8],
+			      const puchar	*secret,
+			      puint64		start)
+{
+	puint64	result = start;
+	puint	i;
+
+	for (i = 0; i < 4; ++i)
+		result += pp_fast_hash_xxh3_mul128_fold64 (acc[2 * i] ^ pp_fast_hash_xxh3_read64 (secret + 16 * i),
+							   acc[2 * i + 1] ^ pp_fast_hash_xxh3_read64 (secret + 16 * i + 8));
+
+	return pp_fast_hash_xxh3_avalanche (result);
+}
+
+static void
+pp_fast_hash_xxh3_digest_long (const PHashXXH3	*ctx,
+			       puint64		acc[8])
+{
+	puchar	last_stripe[P_XXH3_STRIPE_LEN];
+	puint	stripes_so_far;
+	psize	catchup;
+
+	memcpy (acc, ctx->acc, sizeof (ctx->acc));
+
+	stripes_so_far = ctx->stripes;
+
+	if (ctx->buf_len >= P_XXH3_STRIPE_LEN) {
+		pp_fast_hash_xxh3_consume_stripes (acc,
+						   &stripes_so_far,
+						   ctx->buf,
+						   (ctx->buf_len - 1) / P_XXH3_STRIPE_LEN,
+						   ctx->secret);
+
+		memcpy (last_stripe, ctx->buf + ctx->buf_len - P_XXH3_STRIPE_LEN, P_XXH3_STRIPE_LEN);
+	} else {
+		/* The tail of the previous buffer is still in place */
+		catchup = P_XXH3_STRIPE_LEN - ctx->buf_len;
+
+		memcpy (last_stripe, ctx->buf + P_XXH3_BUFFER_SIZE - catchup, catchup);
+		memcpy (last_stripe + catchup, ctx->buf, ctx->buf_len);
+	}
+
+	pp_fast_hash_xxh3_accumulate_512 (acc,
+					  last_stripe,
+					  ctx->secret + P_XXH3_SECRET_LIMIT - P_XXH3_SECRET_LAST_ACC_START);
+}
+
+puint64
+p_fast_hash_xxh3_64_compute (const puchar	*data,
+			     psize		len,
+			     puint64		seed)
+{
+	puchar	secret[P_XXH3_SECRET_SIZE];
+	puint64	acc[8];
+
+	if (len <= P_XXH3_MIDSIZE_MAX)
+		return pp_fast_hash_xxh3_short_64 (data, len, seed);
+
+	if (seed != 0)
+		pp_fast_hash_xxh3_init_secret (secret, seed);
+
+	pp_fast_hash_xxh3_hash_long (acc, data, len, seed != 0 ? secret : pp_fast_hash_xxh3_secret);
+
+	return pp_fast_hash_xxh3_merge_accs (acc,
+					     (seed != 0 ? secret : pp_fast_hash_xxh3_secret) +
+					     P_XXH3_SECRET_MERGE_ACCS_START,
+					     (puint64) len * P_XXH3_PRIME64_1);
+}
+
+void
+p_fast_hash_xxh3_128_compute (const puchar	*data,
+			      psize		len,
+			      puint64		seed,
+			      puint64		*low,
+			      puint64		*high)
+{
+	puchar		secret_buf[P_XXH3_SECRET_SIZE];
+	const puchar	*secret;
+	puint64		acc[8];
+
+	if (len <= P_XXH3_MIDSIZE_MAX) {
+		pp_fast_hash_xxh3_short_128 (data, len, seed, low, high);
+		return;
+	}
+
+	secret = pp_fast_hash_xxh3_secret;
+
+	if (seed != 0) {
+		pp_fast_hash_xxh3_init_secret (secret_buf, seed);
+		secret = secret_buf;
+	}
+
+	pp_fast_hash_xxh3_hash_long (acc, data, len, secret);
+
+	*low  = pp_fast_hash_xxh3_merge_accs (acc,
+					      secret + P_XXH3_SECRET_MERGE_ACCS_START,
+					      (puint64) len * P_XXH3_PRIME64_1);
+	*high = pp_fast_hash_xxh3_merge_accs (acc,
+					      secret + P_XXH3_SECRET_SIZE - P_XXH3_STRIPE_LEN -
+					      P_XXH3_SECRET_MERGE_ACCS_START,
+					      ~((puint64) len * P_XXH3_PRIME64_2));
+}
+
+void
+p_fast_hash_xxh3_reset (PHashXXH3	*ctx,
+			puint64		seed)
+{
+	memcpy (ctx->acc, pp_fast_hash_xxh3_acc_init, sizeof (pp_fast_hash_xxh3_acc_init));
+
+	if (seed != 0)
+		pp_fast_hash_xxh3_init_secret (ctx->secret, seed);
+	else
+		memcpy (ctx->secret, pp_fast_hash_xxh3_secret, P_XXH3_SECRET_SIZE);
+
+	ctx->total_len = 0;
+	ctx->seed      = seed;
+	ctx->buf_len   = 0;
+	ctx->stripes   = 0;
+}
+
+void
+p_fast_hash_xxh3_update (PHashXXH3	*ctx,
+			 const puchar	*data,
+			 psize		len)
+{
+	psize to_fill;
+
+	ctx->total_len += len;
+
+	if (len <= P_XXH3_BUFFER_SIZE - ctx->buf_len) {
+		memcpy (ctx->buf + ctx->buf_len, data, len);
+		ctx->buf_len += (puint) len;
+		return;
+	}
+
+	/* More data follows, so the whole buffer can be consumed */
+	if (ctx->buf_len > 0) {
+		to_fill = P_XXH3_BUFFER_SIZE - ctx->buf_len;
+
+		memcpy (ctx->buf + ctx->buf_len, data, to_fill);
+
+		pp_fast_hash_xxh3_consume_stripes (ctx->acc,
+						   &ctx->stripes,
+						   ctx->buf,
+						   P_XXH3_BUFFER_STRIPES,
+						   ctx->secret);
+
+		data += to_fill;
+		len -= to_fill;
+		ctx->buf_len = 0;
+	}
+
+	if (len > P_XXH3_BUFFER_SIZE) {
+		do {
+			pp_fast_hash_xxh3_consume_stripes (ctx->acc,
+							   &ctx->stripes,
+							   data,
+							   P_XXH3_BUFFER_STRIPES,
+							   ctx->secret);
+
+			data += P_XXH3_BUFFER_SIZE;
+			len -= P_XXH3_BUFFER_SIZE;
+		} while (len > P_XXH3_BUFFER_SIZE);
+
+		/* Keep the last consumed stripe for a short tail */
+		memcpy (ctx->buf + P_XXH3_BUFFER_SIZE - P_XXH3_STRIPE_LEN, data - P_XXH3_STRIPE_LEN, P_XXH3_STRIPE_LEN);
+	}
+
+	memcpy (ctx->buf, data, len);
+	ctx->buf_len = (puint) len;
+}
+
+puint64
+p_fast_hash_xxh3_64_digest (const PHashXXH3 *ctx)
+{
+	puint64 acc[8];
+
+	if (ctx->total_len <= P_XXH3_MIDSIZE_MAX)
+		return pp_fast_hash_xxh3_short_64 (ctx->buf, (psize) ctx->total_len, ctx->seed);
+
+	pp_fast_hash_xxh3_digest_long (ctx, acc);
+
+	return pp_fast_hash_xxh3_merge_accs (acc,
+					     ctx->secret + P_XXH3_SECRET_MERGE_ACCS_START,
+					     ctx->total_len * P_XXH3_PRIME64_1);
+}
+
+void
+p_fast_hash_xxh3_128_digest (const PHashXXH3	*ctx,
+			     puint64		*low,
+			     puint64		*high)
+{
+	puint64 acc[8];
+
+	if (ctx->total_len <= P_XXH3_MIDSIZE_MAX) {
+		pp_fast_hash_xxh3_short_128 (ctx->buf, (psize) ctx->total_len, ctx->seed, low, high);
+		return;
+	}
+
+	pp_fast_hash_xxh3_digest_long (ctx, acc);
+
+	*low  = pp_fast_hash_xxh3_merge_accs (acc,
+					      ctx->secret + P_XXH3_SECRET_MERGE_ACCS_START,
+					      ctx->total_len * P_XXH3_PRIME64_1);
+	*high = pp_fast_hash_xxh3_merge_accs (acc,
+					      ctx->secret + P_XXH3_SECRET_SIZE - P_XXH3_STRIPE_LEN -
+					      P_XXH3_SECRET_MERGE_ACCS_START,
+					      ~(ctx->total_len * P_XXH3_PRIME64_2));
+}
@@ -0,0 +1,65 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* xxHash3 (64 and 128 bits) implementation for #PFastHash */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PFASTHASHXXH3_H
+#define PLIBSYS_HEADER_PFASTHASHXXH3_H
+
+#include "ptypes.h"
+#include "pmacros.h"
+
+P_BEGIN_DECLS
+
+#define P_XXH3_STRIPE_LEN	64
+#define P_XXH3_SECRET_SIZE	192
+#define P_XXH3_BUFFER_SIZE	256
+
+typedef struct PHashXXH3_ {
+	puint64		acc[8];
+	puchar		secret[P_XXH3_SECRET_SIZE];
+	puchar		buf[P_XXH3_BUFFER_SIZE];
+	puint64		total_len;
+	puint64		seed;
+	puint		buf_len;
+	puint		stripes;
+} PHashXXH3;
+
+puint64		p_fast_hash_xxh3_64_compute	(const puchar *data, psize len, puint64 seed);
+void		p_fast_hash_xxh3_128_compute	(const puchar *data, psize len, puint64 seed,
+						 puint64 *low, puint64 *high);
+
+void		p_fast_hash_xxh3_reset		(PHashXXH3 *ctx, puint64 seed);
+void		p_fast_hash_xxh3_update		(PHashXXH3 *ctx, const puchar *data, psize len);
+puint64		p_fast_hash_xxh3_64_digest	(const PHashXXH3 *ctx);
+void		p_fast_hash_xxh3_128_digest	(const PHashXXH3 *ctx, puint64 *low, puint64 *high);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PFASTHASHXXH3_H */
@@ -0,0 +1,235 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "pmem.h"
+#include "pfasthash.h"
+#include "pfasthash-crc32c.h"
+#include "pfasthash-xxh3.h"
+
+#include <string.h>
+
+struct PFastHash_ {
+	PFastHashType	type;
+	puint64		seed;
+	union state_ {
+		PHashXXH3	xxh3;
+		puint32		crc;
+	} state;
+};
+
+static void pp_fast_hash_put_be64 (puchar *buf, puint64 val);
+
+static void
+pp_fast_hash_put_be64 (puchar	*buf,
+		       puint64	val)
+{
+	val = PUINT64_TO_BE (val);
+	memcpy (buf, &val, sizeof (val));
+}
+
+P_LIB_API PFastHash *
+p_fast_hash_new (PFastHashType	type,
+		 puint64	seed)
+{
+	PFastHash *ret;
+
+	if (P_UNLIKELY (type < P_FAST_HASH_TYPE_XXH3_64 || type > P_FAST_HASH_TYPE_CRC32C))
+		return NULL;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PFastHash))) == NULL))
+		return NULL;
+
+	ret->type = type;
+	ret->seed = seed;
+
+	p_fast_hash_reset (ret);
+
+	return ret;
+}
+
+P_LIB_API void
+p_fast_hash_update (PFastHash		*hash,
+		    pconstpointer	data,
+		    psize		len)
+{
+	if (P_UNLIKELY (hash == NULL || (data == NULL && len > 0)))
+		return;
+
+	if (len == 0)
+		return;
+
+	if (hash->type == P_FAST_HASH_TYPE_CRC32C)
+		hash->state.crc = p_fast_hash_crc32c_compute (hash->state.crc, (const puchar *) data, len);
+	else
+		p_fast_hash_xxh3_update (&hash->state.xxh3, (const puchar *) data, len);
+}
+
+P_LIB_API void
+p_fast_hash_reset (PFastHash *hash)
+{
+	if (P_UNLIKELY (hash == NULL))
+		return;
+
+	if (hash->type == P_FAST_HASH_TYPE_CRC32C)
+		hash->state.crc = (puint32) hash->seed;
+	else
+		p_fast_hash_xxh3_reset (&hash->state.xxh3, hash->seed);
+}
+
+P_LIB_API puint64
+p_fast_hash_get_value (const PFastHash *hash)
+{
+	puint64 low, high;
+
+	if (P_UNLIKELY (hash == NULL))
+		return 0;
+
+	switch (hash->type) {
+	case P_FAST_HASH_TYPE_XXH3_64:
+		return p_fast_hash_xxh3_64_digest (&hash->state.xxh3);
+	case P_FAST_HASH_TYPE_XXH3_128:
+		p_fast_hash_xxh3_128_digest (&hash->state.xxh3, &low, &high);
+		return low;
+	case P_FAST_HASH_TYPE_CRC32C:
+		return hash->state.crc;
+	default:
+		return 0;
+	}
+}
+
+P_LIB_API void
+p_fast_hash_get_digest (const PFastHash	*hash,
+			puchar		*buf,
+			psize		*len)
+{
+	puint64	low, high;
+	puint32	crc;
+	pssize	hash_len;
+
+	if (P_UNLIKELY (len == NULL))
+		return;
+
+	if (P_UNLIKELY (hash == NULL || buf == NULL)) {
+		*len = 0;
+		return;
+	}
+
+	hash_len = p_fast_hash_get_length (hash);
+
+	if (P_UNLIKELY ((psize) hash_len > *len)) {
+		*len = 0;
+		return;
+	}
+
+	switch (hash->type) {
+	case P_FAST_HASH_TYPE_XXH3_64:
+		pp_fast_hash_put_be64 (buf, p_fast_hash_xxh3_64_digest (&hash->state.xxh3));
+		break;
+	case P_FAST_HASH_TYPE_XXH3_128:
+		p_fast_hash_xxh3_128_digest (&hash->state.xxh3, &low, &high);
+		pp_fast_hash_put_be64 (buf, high);
+		pp_fast_hash_put_be64 (buf + 8, low);
+		break;
+	case P_FAST_HASH_TYPE_CRC32C:
+		crc = PUINT32_TO_BE (hash->state.crc);
+		memcpy (buf, &crc, sizeof (crc));
+		break;
+	}
+
+	*len = (psize) hash_len;
+}
+
+P_LIB_API pssize
+p_fast_hash_get_length (const PFastHash *hash)
+{
+	if (P_UNLIKELY (hash == NULL))
+		return -1;
+
+	switch (hash->type) {
+	case P_FAST_HASH_TYPE_XXH3_64:
+		return 8;
+	case P_FAST_HASH_TYPE_XXH3_128:
+		return 16;
+	case P_FAST_HASH_TYPE_CRC32C:
+		return 4;
+	default:
+		return -1;
+	}
+}
+
+P_LIB_API PFastHashType
+p_fast_hash_get_type (const PFastHash *hash)
+{
+	if (P_UNLIKELY (hash == NULL))
+		return (PFastHashType) -1;
+
+	return hash->type;
+}
+
+P_LIB_API void
+p_fast_hash_free (PFastHash *hash)
+{
+	if (P_UNLIKELY (hash == NULL))
+		return;
+
+	p_free (hash);
+}
+
+P_LIB_API puint64
+p_fast_hash_xxh3_64 (pconstpointer	data,
+		     psize		len,
+		     puint64		seed)
+{
+	if (P_UNLIKELY (data == NULL && len > 0))
+		return 0;
+
+	return p_fast_hash_xxh3_64_compute ((const puchar *) data, len, seed);
+}
+
+P_LIB_API pboolean
+p_fast_hash_xxh3_128 (pconstpointer	data,
+		      psize		len,
+		      puint64		seed,
+		      puint64		*low,
+		      puint64		*high)
+{
+	if (P_UNLIKELY ((data == NULL && len > 0) || low == NULL || high == NULL))
+		return FALSE;
+
+	p_fast_hash_xxh3_128_compute ((const puchar *) data, len, seed, low, high);
+
+	return TRUE;
+}
+
+P_LIB_API puint32
+p_fast_hash_crc32c (puint32		crc,
+		    pconstpointer	data,
+		    psize		len)
+{
+	if (P_UNLIKELY (data == NULL && len > 0))
+		return crc;
+
+	return p_fast_hash_crc32c_compute (crc, (const puchar *) data, len);
+}
@@ -0,0 +1,212 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pfasthash.h
+ * @brief Fast non-cryptographic hash functions
+ * @author Alexander Saprykin
+ *
+ * A non-cryptographic hash function maps the data to a short hash value with
+ * a good distribution and as fast as possible. Unlike the #PCryptoHash
+ * functions it gives no protection against intentionally crafted collisions,
+ * so use it for hash tables, checksums of the stored or transferred data,
+ * deduplication and similar tasks only.
+ *
+ * The fast hash module supports the following hash functions:
+ * - xxHash3 with 64-bit value;
+ * - xxHash3 with 128-bit value;
+ * - CRC32C (Castagnoli).
+ *
+ * xxHash3 processes long inputs with SSE2 on x86 targets, CRC32C uses the
+ * SSE4.2 instructions on x86 (when supported by the running CPU) and the CRC32
+ * instructions on ARMv8 targets. The results are the same as of the reference
+ * implementations on any platform.
+ *
+ * Use p_fast_hash_new() to initialize a new hash context with one of the
+ * mentioned above types and a seed. Data can be added in several chunks using
+ * the p_fast_hash_update() routine. Unlike #PCryptoHash, the hash value can be
+ * taken at any moment with p_fast_hash_get_value() or p_fast_hash_get_digest()
+ * and the context stays open for further updates.
+ *
+ * To hash a single buffer use one of p_fast_hash_xxh3_64(),
+ * p_fast_hash_xxh3_128() or p_fast_hash_crc32c(), they don't allocate any
+ * memory.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PFASTHASH_H
+#define PLIBSYS_HEADER_PFASTHASH_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+
+P_BEGIN_DECLS
+
+/** Opaque data structure for handling a fast hash context. */
+typedef struct PFastHash_ PFastHash;
+
+/** Fast hash function types for #PFastHash. */
+typedef enum PFastHashType_ {
+	P_FAST_HASH_TYPE_XXH3_64	= 0, /**< xxHash3 with 64-bit value.	@since 0.0.5	*/
+	P_FAST_HASH_TYPE_XXH3_128	= 1, /**< xxHash3 with 128-bit value.	@since 0.0.5	*/
+	P_FAST_HASH_TYPE_CRC32C		= 2  /**< CRC32C (Castagnoli).		@since 0.0.5	*/
+} PFastHashType;
+
+/**
+ * @brief Initializes a new #PFastHash context.
+ * @param type Hash function type to use, can't be changed later.
+ * @param seed Seed for xxHash3, or a CRC value of the preceding data to
+ * continue from for CRC32C (only the lower 32 bits are used). Use zero for the
+ * default.
+ * @return Newly initialized #PFastHash context in case of success, NULL
+ * otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API PFastHash *		p_fast_hash_new			(PFastHashType		type,
+								 puint64		seed);
+
+/**
+ * @brief Adds a new chunk of data for hashing.
+ * @param hash #PFastHash context to add @a data to.
+ * @param data Data to add for hashing, may be NULL only if @a len is zero.
+ * @param len Data length, in bytes.
+ * @since 0.0.5
+ */
+P_LIB_API void			p_fast_hash_update		(PFastHash		*hash,
+								 pconstpointer		data,
+								 psize			len);
+
+/**
+ * @brief Resets a hash state.
+ * @param hash #PFastHash context to reset.
+ * @since 0.0.5
+ *
+ * All previously added data is lost, the seed given to p_fast_hash_new() is
+ * kept.
+ */
+P_LIB_API void			p_fast_hash_reset		(PFastHash		*hash);
+
+/**
+ * @brief Gets a hash value of the data added so far.
+ * @param hash #PFastHash context to get the value from.
+ * @return Hash value in case of success, 0 otherwise. For
+ * #P_FAST_HASH_TYPE_XXH3_128 only the lower 64 bits are returned.
+ * @since 0.0.5
+ *
+ * The context remains open, more data can be added later.
+ */
+P_LIB_API puint64		p_fast_hash_get_value		(const PFastHash	*hash);
+
+/**
+ * @brief Gets a hash value of the data added so far in a raw representation.
+ * @param hash #PFastHash context to get the digest from.
+ * @param buf Buffer to store the digest.
+ * @param[in,out] len Size of @a buf when calling, count of written bytes
+ * after.
+ * @since 0.0.5
+ *
+ * The value is written in big-endian byte order (the canonical form of the
+ * reference implementations), the higher half goes first for
+ * #P_FAST_HASH_TYPE_XXH3_128. The context remains open, more data can be added
+ * later.
+ */
+P_LIB_API void			p_fast_hash_get_digest		(const PFastHash	*hash,
+								 puchar			*buf,
+								 psize			*len);
+
+/**
+ * @brief Gets a hash digest length depending on its type.
+ * @param hash #PFastHash context to get the length for.
+ * @return Length (in bytes) of the given hash depending on its type in case of
+ * success, -1 otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pssize		p_fast_hash_get_length		(const PFastHash	*hash);
+
+/**
+ * @brief Gets a hash function type.
+ * @param hash #PFastHash context to get the type for.
+ * @return Hash function type used in the given context.
+ * @since 0.0.5
+ */
+P_LIB_API PFastHashType		p_fast_hash_get_type		(const PFastHash	*hash);
+
+/**
+ * @brief Frees a previously initialized hash context.
+ * @param hash #PFastHash context to free.
+ * @since 0.0.5
+ */
+P_LIB_API void			p_fast_hash_free		(PFastHash		*hash);
+
+/**
+ * @brief Computes a 64-bit xxHash3 value of a single buffer.
+ * @param data Data to hash, may be NULL only if @a len is zero.
+ * @param len Data length, in bytes.
+ * @param seed Seed, zero for the default.
+ * @return Hash value.
+ * @since 0.0.5
+ */
+P_LIB_API puint64		p_fast_hash_xxh3_64		(pconstpointer		data,
+								 psize			len,
+								 puint64		seed);
+
+/**
+ * @brief Computes a 128-bit xxHash3 value of a single buffer.
+ * @param data Data to hash, may be NULL only if @a len is zero.
+ * @param len Data length, in bytes.
+ * @param seed Seed, zero for the default.
+ * @param[out] low Lower 64 bits of the hash value.
+ * @param[out] high Higher 64 bits of the hash value.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean		p_fast_hash_xxh3_128		(pconstpointer		data,
+								 psize			len,
+								 puint64		seed,
+								 puint64		*low,
+								 puint64		*high);
+
+/**
+ * @brief Computes a CRC32C value of a single buffer.
+ * @param crc CRC value of the preceding data to continue from, zero for a new
+ * computation.
+ * @param data Data to hash, may be NULL only if @a len is zero.
+ * @param len Data length, in bytes.
+ * @return CRC value of the preceding and the given data.
+ * @since 0.0.5
+ *
+ * The CRC of a message split into several parts can be computed by passing
+ * the result for the previous part as @a crc.
+ */
+P_LIB_API puint32		p_fast_hash_crc32c		(puint32		crc,
+								 pconstpointer		data,
+								 psize			len);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PFASTHASH_H */
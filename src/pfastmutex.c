@@ -0,0 +1,241 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* The lock word follows "Futexes Are Tricky" by Ulrich Drepper: 0 is
+ * unlocked, 1 is locked, 2 is locked with possibly parked threads. A thread
+ * parks only after setting the word to 2, and the owner wakes somebody up
+ * only if the word was 2, so the uncontended paths never leave user space.
+ *
+ * Without futexes and WaitOnAddress() the threads park on a condition
+ * variable. A parking thread checks the word under the park mutex, while the
+ * owner resets the word and only then takes the park mutex to signal, so the
+ * wakeup cannot be lost. */
+
+#include "patomic.h"
+#include "pcondvariable.h"
+#include "pcpurelax-private.h"
+#include "pfastmutex.h"
+#include "pmem.h"
+#include "pmutex.h"
+
+#ifdef PLIBSYS_HAS_FUTEX
+#  include <unistd.h>
+#  include <sys/syscall.h>
+#  include <linux/futex.h>
+#endif
+
+#define P_FAST_MUTEX_DEFAULT_SPIN	100
+
+#ifdef P_OS_WIN
+typedef BOOL (WINAPI * PWin32WaitOnAddress) (volatile VOID *addr, PVOID cmp_addr, SIZE_T size, DWORD ms);
+typedef VOID (WINAPI * PWin32WakeByAddressSingle) (PVOID addr);
+#endif
+
+struct PFastMutex_ {
+	volatile pint			state;
+	pint				spin_count;
+#ifndef PLIBSYS_HAS_FUTEX
+	PMutex				*park_mutex;
+	PCondVariable			*park_cond;
+#endif
+#ifdef P_OS_WIN
+	PWin32WaitOnAddress		wait_func;
+	PWin32WakeByAddressSingle	wake_func;
+#endif
+};
+
+static pint pp_fast_mutex_exchange (volatile pint *atomic, pint val);
+static void pp_fast_mutex_park (PFastMutex *mutex);
+static void pp_fast_mutex_unpark (PFastMutex *mutex);
+
+static pint
+pp_fast_mutex_exchange (volatile pint *atomic, pint val)
+{
+	pint old_val;
+
+	do {
+		old_val = p_atomic_int_get (atomic);
+	} while (p_atomic_int_compare_and_exchange (atomic, old_val, val) == FALSE);
+
+	return old_val;
+}
+
+static void
+pp_fast_mutex_park (PFastMutex *mutex)
+{
+#if defined (PLIBSYS_HAS_FUTEX)
+	/* Returns at once if the word is not 2 anymore */
+	syscall (SYS_futex, &mutex->state, FUTEX_WAIT_PRIVATE, 2, NULL, NULL, 0);
+#else
+#  ifdef P_OS_WIN
+	pint cmp_val = 2;
+
+	if (mutex->wait_func != NULL) {
+		mutex->wait_func (&mutex->state, &cmp_val, sizeof (pint), INFINITE);
+		return;
+	}
+#  endif
+	p_mutex_lock (mutex->park_mutex);
+
+	if (p_atomic_int_get (&mutex->state) == 2)
+		p_cond_variable_wait (mutex->park_cond, mutex->park_mutex);
+
+	p_mutex_unlock (mutex->park_mutex);
+#endif
+}
+
+static void
+pp_fast_mutex_unpark (PFastMutex *mutex)
+{
+#if defined (PLIBSYS_HAS_FUTEX)
+	syscall (SYS_futex, &mutex->state, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+#else
+#  ifdef P_OS_WIN
+	if (mutex->wake_func != NULL) {
+		mutex->wake_func ((PVOID) &mutex->state);
+		return;
+	}
+#  endif
+	p_mutex_lock (mutex->park_mutex);
+	p_cond_variable_signal (mutex->park_cond);
+	p_mutex_unlock (mutex->park_mutex);
+#endif
+}
+
+P_LIB_API PFastMutex *
+p_fast_mutex_new (pint spin_count)
+{
+	PFastMutex	*ret;
+#ifdef P_OS_WIN
+	HMODULE		hmodule;
+#endif
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PFastMutex))) == NULL)) {
+		P_ERROR ("PFastMutex::p_fast_mutex_new: failed to allocate memory");
+		return NULL;
+	}
+
+	ret->spin_count = spin_count > 0 ? spin_count : P_FAST_MUTEX_DEFAULT_SPIN;
+
+#ifdef P_OS_WIN
+	/* Available since Windows 8 */
+	if ((hmodule = GetModuleHandleA ("kernelbase.dll")) != NULL) {
+		ret->wait_func = (PWin32WaitOnAddress) GetProcAddress (hmodule, "WaitOnAddress");
+		ret->wake_func = (PWin32WakeByAddressSingle) GetProcAddress (hmodule, "WakeByAddressSingle");
+	}
+
+	if (ret->wait_func != NULL && ret->wake_func != NULL)
+		return ret;
+
+	ret->wait_func = NULL;
+	ret->wake_func = NULL;
+#endif
+
+#ifndef PLIBSYS_HAS_FUTEX
+	if (P_UNLIKELY ((ret->park_mutex = p_mutex_new ()) == NULL)) {
+		P_ERROR ("PFastMutex::p_fast_mutex_new: failed to create mutex");
+		p_free (ret);
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret->park_cond = p_cond_variable_new ()) == NULL)) {
+		P_ERROR ("PFastMutex::p_fast_mutex_new: failed to create condition variable");
+		p_mutex_free (ret->park_mutex);
+		p_free (ret);
+		return NULL;
+	}
+#endif
+
+	return ret;
+}
+
+P_LIB_API pboolean
+p_fast_mutex_lock (PFastMutex *mutex)
+{
+	pint i;
+
+	if (P_UNLIKELY (mutex == NULL))
+		return FALSE;
+
+	if (P_LIKELY (p_atomic_int_compare_and_exchange (&mutex->state, 0, 1) == TRUE))
+		return TRUE;
+
+	/* Read before trying, a failed exchange takes the cache line for nothing */
+	for (i = 0; i < mutex->spin_count; ++i) {
+		P_CPU_RELAX ();
+
+		if (p_atomic_int_get (&mutex->state) == 0 &&
+		    p_atomic_int_compare_and_exchange (&mutex->state, 0, 1) == TRUE)
+			return TRUE;
+	}
+
+	while (pp_fast_mutex_exchange (&mutex->state, 2) != 0)
+		pp_fast_mutex_park (mutex);
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_fast_mutex_trylock (PFastMutex *mutex)
+{
+	if (P_UNLIKELY (mutex == NULL))
+		return FALSE;
+
+	return p_atomic_int_compare_and_exchange (&mutex->state, 0, 1);
+}
+
+P_LIB_API pboolean
+p_fast_mutex_unlock (PFastMutex *mutex)
+{
+	if (P_UNLIKELY (mutex == NULL))
+		return FALSE;
+
+	if (p_atomic_int_add (&mutex->state, -1) != 1) {
+		p_atomic_int_set (&mutex->state, 0);
+		pp_fast_mutex_unpark (mutex);
+	}
+
+	return TRUE;
+}
+
+P_LIB_API void
+p_fast_mutex_free (PFastMutex *mutex)
+{
+	if (P_UNLIKELY (mutex == NULL))
+		return;
+
+	if (P_UNLIKELY (p_atomic_int_get (&mutex->state) != 0))
+		P_WARNING ("PFastMutex::p_fast_mutex_free: destroying locked mutex");
+
+#ifndef PLIBSYS_HAS_FUTEX
+	if (mutex->park_cond != NULL)
+		p_cond_variable_free (mutex->park_cond);
+
+	if (mutex->park_mutex != NULL)
+		p_mutex_free (mutex->park_mutex);
+#endif
+
+	p_free (mutex);
+}
@@ -0,0 +1,111 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pfastmutex.h
+ * @brief Adaptive spin-then-park mutex
+ * @author Alexander Saprykin
+ *
+ * A fast mutex is a mutual exclusion lock for very short critical sections.
+ * Taking a free lock is a single atomic operation and doesn't enter the
+ * kernel. A thread which finds the lock busy spins for a while, expecting the
+ * owner to leave the critical section soon, and only then parks until the
+ * lock is released. So under a light contention the lock behaves like a
+ * #PSpinLock, and under a heavy one it doesn't burn the CPU time like a
+ * #PMutex.
+ *
+ * Unlocking makes a system call only if there are parked threads. The
+ * threads park on a futex on Linux and on WaitOnAddress() on Windows 8 and
+ * newer, other systems use a mutex with a condition variable internally.
+ *
+ * A fast mutex is not recursive: locking it twice from the same thread is a
+ * deadlock. It is not fair either, a spinning thread may take the lock before
+ * a parked one.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PFASTMUTEX_H
+#define PLIBSYS_HEADER_PFASTMUTEX_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+
+P_BEGIN_DECLS
+
+/** Fast mutex opaque data type. */
+typedef struct PFastMutex_ PFastMutex;
+
+/**
+ * @brief Creates a new fast mutex.
+ * @param spin_count Number of spinning rounds before parking, 0 or less to use
+ * the default one.
+ * @return Pointer to #PFastMutex in case of success, NULL otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API PFastMutex *	p_fast_mutex_new	(pint		spin_count);
+
+/**
+ * @brief Locks a fast mutex.
+ * @param mutex #PFastMutex to lock.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The calling thread spins and then parks until the lock is acquired.
+ */
+P_LIB_API pboolean	p_fast_mutex_lock	(PFastMutex	*mutex);
+
+/**
+ * @brief Tries to lock a fast mutex without waiting.
+ * @param mutex #PFastMutex to lock.
+ * @return TRUE if the lock was acquired, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_fast_mutex_trylock	(PFastMutex	*mutex);
+
+/**
+ * @brief Releases a locked fast mutex.
+ * @param mutex #PFastMutex to unlock.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * Only the thread which locked the mutex should unlock it.
+ */
+P_LIB_API pboolean	p_fast_mutex_unlock	(PFastMutex	*mutex);
+
+/**
+ * @brief Frees a fast mutex.
+ * @param mutex #PFastMutex to free.
+ * @since 0.0.5
+ *
+ * The mutex should be unlocked at that moment.
+ */
+P_LIB_API void		p_fast_mutex_free	(PFastMutex	*mutex);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PFASTMUTEX_H */
@@ -0,0 +1,58 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "pfiber-private.h"
+
+PFiberContext *
+p_fiber_context_new_thread (void)
+{
+	return NULL;
+}
+
+PFiberContext *
+p_fiber_context_new (psize		stack_size,
+		     PFiberContextFunc	func,
+		     ppointer		data)
+{
+	P_UNUSED (stack_size);
+	P_UNUSED (func);
+	P_UNUSED (data);
+
+	return NULL;
+}
+
+void
+p_fiber_context_switch (PFiberContext	*from,
+			PFiberContext	*to)
+{
+	P_UNUSED (from);
+	P_UNUSED (to);
+}
+
+void
+p_fiber_context_free (PFiberContext *context)
+{
+	P_UNUSED (context);
+}
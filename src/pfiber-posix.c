@@ -0,0 +1,350 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "pmem.h"
+#include "pfiber-private.h"
+
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+
+#if defined (PLIBSYS_MMAP_HAS_MAP_ANONYMOUS) || defined (PLIBSYS_MMAP_HAS_MAP_ANON)
+#  include <sys/mman.h>
+#  define P_FIBER_GUARD_PAGE
+#endif
+
+/* Hand-written switch for the System V x86-64 and AAPCS64 ABIs */
+#if (defined (P_CC_GNU) || defined (P_CC_CLANG)) && \
+    !defined (P_OS_WIN) && !defined (P_OS_CYGWIN) && !defined (P_OS_MSYS)
+#  if defined (P_CPU_X86_64) || defined (P_CPU_ARM_64)
+#    define P_FIBER_ASM
+#  endif
+#endif
+
+#if !defined (P_FIBER_ASM) && defined (PLIBSYS_HAS_UCONTEXT)
+#  include <ucontext.h>
+#  define P_FIBER_UCONTEXT
+#endif
+
+#ifdef P_OS_DARWIN
+#  define P_FIBER_ASM_SYMBOL(name)	"_" #name
+#  define P_FIBER_ASM_HIDDEN(name)	".private_extern _" #name "\n"
+#else
+#  define P_FIBER_ASM_SYMBOL(name)	#name
+#  define P_FIBER_ASM_HIDDEN(name)	".hidden " #name "\n"
+#endif
+
+#if defined (P_FIBER_ASM) || defined (P_FIBER_UCONTEXT)
+#  define P_FIBER_HAS_STACK
+#endif
+
+struct PFiberContext_ {
+	ppointer		stack;
+	psize			stack_size;
+	PFiberContextFunc	func;
+	ppointer		data;
+#if defined (P_FIBER_ASM)
+	ppointer		sp;
+#elif defined (P_FIBER_UCONTEXT)
+	ucontext_t		uc;
+#endif
+};
+
+#ifdef P_FIBER_HAS_STACK
+static psize pp_fiber_page_size (void);
+static ppointer pp_fiber_stack_new (psize size);
+static void pp_fiber_stack_free (ppointer stack, psize size);
+#endif
+
+#if defined (P_FIBER_ASM)
+/* Saves the callee-saved registers on the current stack, stores the stack
+ * pointer into *from_sp, and restores the registers from to_sp */
+extern void pp_fiber_asm_switch (ppointer *from_sp, ppointer to_sp);
+extern void pp_fiber_asm_start (void);
+
+#  if defined (P_CPU_X86_64)
+/* Frame: x87 control word, MXCSR, r15, r14, r13, r12, rbx, rbp, return address */
+#    define P_FIBER_FRAME_SIZE	9
+
+__asm__ (
+	".text\n"
+	".globl " P_FIBER_ASM_SYMBOL (pp_fiber_asm_switch) "\n"
+	P_FIBER_ASM_HIDDEN (pp_fiber_asm_switch)
+	".p2align 4\n"
+	P_FIBER_ASM_SYMBOL (pp_fiber_asm_switch) ":\n"
+	"	pushq	%rbp\n"
+	"	pushq	%rbx\n"
+	"	pushq	%r12\n"
+	"	pushq	%r13\n"
+	"	pushq	%r14\n"
+	"	pushq	%r15\n"
+	"	subq	$16, %rsp\n"
+	"	stmxcsr	8(%rsp)\n"
+	"	fnstcw	(%rsp)\n"
+	"	movq	%rsp, (%rdi)\n"
+	"	movq	%rsi, %rsp\n"
+	"	ldmxcsr	8(%rsp)\n"
+	"	fldcw	(%rsp)\n"
+	"	addq	$16, %rsp\n"
+	"	popq	%r15\n"
+	"	popq	%r14\n"
+	"	popq	%r13\n"
+	"	popq	%r12\n"
+	"	popq	%rbx\n"
+	"	popq	%rbp\n"
+	"	ret\n"
+	".globl " P_FIBER_ASM_SYMBOL (pp_fiber_asm_start) "\n"
+	P_FIBER_ASM_HIDDEN (pp_fiber_asm_start)
+	".p2align 4\n"
+	P_FIBER_ASM_SYMBOL (pp_fiber_asm_start) ":\n"
+	"	movq	%r12, %rdi\n"
+	"	callq	*%r13\n"
+	"	ud2\n"
+);
+#  elif defined (P_CPU_ARM_64)
+/* Frame: x19-x28, x29, x30, d8-d15 */
+#    define P_FIBER_FRAME_SIZE	20
+
+__asm__ (
+	".text\n"
+	".globl " P_FIBER_ASM_SYMBOL (pp_fiber_asm_switch) "\n"
+	P_FIBER_ASM_HIDDEN (pp_fiber_asm_switch)
+	".p2align 4\n"
+	P_FIBER_ASM_SYMBOL (pp_fiber_asm_switch) ":\n"
+	"	sub	sp, sp, #160\n"
+	"	stp	x19, x20, [sp, #0]\n"
+	"	stp	x21, x22, [sp, #16]\n"
+	"	stp	x23, x24, [sp, #32]\n"
+	"	stp	x25, x26, [sp, #48]\n"
+	"	stp	x27, x28, [sp, #64]\n"
+	"	stp	x29, x30, [sp, #80]\n"
+	"	stp	d8, d9, [sp, #96]\n"
+	"	stp	d10, d11, [sp, #112]\n"
+	"	stp	d12, d13, [sp, #128]\n"
+	"	stp	d14, d15, [sp, #144]\n"
+	"	mov	x2, sp\n"
+	"	str	x2, [x0]\n"
+	"	mov	sp, x1\n"
+	"	ldp	x19, x20, [sp, #0]\n"
+	"	ldp	x21, x22, [sp, #16]\n"
+	"	ldp	x23, x24, [sp, #32]\n"
+	"	ldp	x25, x26, [sp, #48]\n"
+	"	ldp	x27, x28, [sp, #64]\n"
+	"	ldp	x29, x30, [sp, #80]\n"
+	"	ldp	d8, d9, [sp, #96]\n"
+	"	ldp	d10, d11, [sp, #112]\n"
+	"	ldp	d12, d13, [sp, #128]\n"
+	"	ldp	d14, d15, [sp, #144]\n"
+	"	add	sp, sp, #160\n"
+	"	ret\n"
+	".globl " P_FIBER_ASM_SYMBOL (pp_fiber_asm_start) "\n"
+	P_FIBER_ASM_HIDDEN (pp_fiber_asm_start)
+	".p2align 4\n"
+	P_FIBER_ASM_SYMBOL (pp_fiber_asm_start) ":\n"
+	"	mov	x0, x19\n"
+	"	blr	x20\n"
+	"	brk	#0\n"
+);
+#  endif
+#elif defined (P_FIBER_UCONTEXT)
+static void pp_fiber_ucontext_entry (puint hi, puint lo);
+
+/* makecontext() passes int arguments only, so the pointer is split */
+static void
+pp_fiber_ucontext_entry (puint	hi,
+			 puint	lo)
+{
+	PFiberContext *context = (PFiberContext *) (((puintptr) hi << 16 << 16) | (puintptr) lo);
+
+	context->func (context->data);
+}
+#endif
+
+#ifdef P_FIBER_HAS_STACK
+static psize
+pp_fiber_page_size (void)
+{
+#ifdef _SC_PAGESIZE
+	long page_size = sysconf (_SC_PAGESIZE);
+
+	if (page_size > 0)
+		return (psize) page_size;
+#endif
+
+	return 4096;
+}
+
+static ppointer
+pp_fiber_stack_new (psize size)
+{
+#ifdef P_FIBER_GUARD_PAGE
+	ppointer	stack;
+	pint		map_flags = MAP_PRIVATE;
+
+#  ifdef PLIBSYS_MMAP_HAS_MAP_ANONYMOUS
+	map_flags |= MAP_ANONYMOUS;
+#  else
+	map_flags |= MAP_ANON;
+#  endif
+
+	/* The lowest page catches the overflow of the downward growing stack */
+	if (P_UNLIKELY ((stack = mmap (NULL, size, PROT_READ | PROT_WRITE, map_flags, -1, 0)) == (void *) -1))
+		return NULL;
+
+	if (P_UNLIKELY (mprotect (stack, pp_fiber_page_size (), PROT_NONE) != 0)) {
+		munmap (stack, size);
+		return NULL;
+	}
+
+	return stack;
+#else
+	return p_malloc (size);
+#endif
+}
+
+static void
+pp_fiber_stack_free (ppointer	stack,
+		     psize	size)
+{
+#ifdef P_FIBER_GUARD_PAGE
+	munmap (stack, size);
+#else
+	P_UNUSED (size);
+	p_free (stack);
+#endif
+}
+#endif
+
+PFiberContext *
+p_fiber_context_new_thread (void)
+{
+#ifdef P_FIBER_HAS_STACK
+	return p_malloc0 (sizeof (PFiberContext));
+#else
+	return NULL;
+#endif
+}
+
+PFiberContext *
+p_fiber_context_new (psize		stack_size,
+		     PFiberContextFunc	func,
+		     ppointer		data)
+{
+#ifdef P_FIBER_HAS_STACK
+	PFiberContext	*ret;
+	psize		page_size;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PFiberContext))) == NULL))
+		return NULL;
+
+	page_size = pp_fiber_page_size ();
+
+#  ifdef P_FIBER_GUARD_PAGE
+	stack_size += page_size;
+#  endif
+
+	ret->stack_size = (stack_size + page_size - 1) & ~(page_size - 1);
+	ret->func       = func;
+	ret->data       = data;
+
+	if (P_UNLIKELY ((ret->stack = pp_fiber_stack_new (ret->stack_size)) == NULL)) {
+		p_free (ret);
+		return NULL;
+	}
+
+#  if defined (P_FIBER_ASM)
+	{
+		ppointer *frame = (ppointer *) ((pchar *) ret->stack + ret->stack_size) - P_FIBER_FRAME_SIZE;
+
+		memset (frame, 0, P_FIBER_FRAME_SIZE * sizeof (ppointer));
+
+#    if defined (P_CPU_X86_64)
+		/* Default x87 control word and MXCSR */
+		((puint16 *) frame)[0] = 0x037F;
+		((puint32 *) frame)[2] = 0x1F80;
+
+		frame[5] = data;
+		frame[4] = (ppointer) func;
+		frame[8] = (ppointer) pp_fiber_asm_start;
+#    elif defined (P_CPU_ARM_64)
+		frame[0]  = data;
+		frame[1]  = (ppointer) func;
+		frame[11] = (ppointer) pp_fiber_asm_start;
+#    endif
+
+		ret->sp = frame;
+	}
+#  else
+	if (P_UNLIKELY (getcontext (&ret->uc) != 0)) {
+		pp_fiber_stack_free (ret->stack, ret->stack_size);
+		p_free (ret);
+		return NULL;
+	}
+
+	ret->uc.uc_stack.ss_sp   = ret->stack;
+	ret->uc.uc_stack.ss_size = ret->stack_size;
+	ret->uc.uc_link          = NULL;
+
+	makecontext (&ret->uc,
+		     (void (*) (void)) pp_fiber_ucontext_entry,
+		     2,
+		     (puint) ((puintptr) ret >> 16 >> 16),
+		     (puint) ((puintptr) ret & 0xFFFFFFFFU));
+#  endif
+
+	return ret;
+#else
+	P_UNUSED (stack_size);
+	P_UNUSED (func);
+	P_UNUSED (data);
+
+	return NULL;
+#endif
+}
+
+void
+p_fiber_context_switch (PFiberContext	*from,
+			PFiberContext	*to)
+{
+#if defined (P_FIBER_ASM)
+	pp_fiber_asm_switch (&from->sp, to->sp);
+#elif defined (P_FIBER_UCONTEXT)
+	swapcontext (&from->uc, &to->uc);
+#else
+	P_UNUSED (from);
+	P_UNUSED (to);
+#endif
+}
+
+void
+p_fiber_context_free (PFiberContext *context)
+{
+#ifdef P_FIBER_HAS_STACK
+	if (context->stack != NULL)
+		pp_fiber_stack_free (context->stack, context->stack_size);
+#endif
+
+	p_free (context);
+}
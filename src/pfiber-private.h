@@ -0,0 +1,81 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PFIBER_PRIVATE_H
+#define PLIBSYS_HEADER_PFIBER_PRIVATE_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+
+P_BEGIN_DECLS
+
+/** Execution context of a fiber or of a thread running fibers. */
+typedef struct PFiberContext_ PFiberContext;
+
+/** Context entry point, must never return. */
+typedef void (*PFiberContextFunc) (ppointer data);
+
+/**
+ * @brief Creates a context for the calling thread.
+ * @return Pointer to #PFiberContext in case of success, NULL otherwise.
+ *
+ * Switching to this context resumes the thread on its own stack.
+ */
+PFiberContext *	p_fiber_context_new_thread	(void);
+
+/**
+ * @brief Creates a context running on a new stack.
+ * @param stack_size Stack size in bytes, rounded up to the page size.
+ * @param func Entry point to start with on the first switch.
+ * @param data Data to pass to @a func.
+ * @return Pointer to #PFiberContext in case of success, NULL otherwise.
+ *
+ * The stack is protected with a guard page where the platform allows it.
+ */
+PFiberContext *	p_fiber_context_new		(psize			stack_size,
+						 PFiberContextFunc	func,
+						 ppointer		data);
+
+/**
+ * @brief Saves the current context and switches to another one.
+ * @param from Context to save the current state into.
+ * @param to Context to switch to.
+ */
+void		p_fiber_context_switch		(PFiberContext		*from,
+						 PFiberContext		*to);
+
+/**
+ * @brief Frees a context which is not running.
+ * @param context Context to free.
+ */
+void		p_fiber_context_free		(PFiberContext		*context);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PFIBER_PRIVATE_H */
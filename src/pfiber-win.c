@@ -0,0 +1,114 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "pmem.h"
+#include "pfiber-private.h"
+
+struct PFiberContext_ {
+	LPVOID			fiber;
+	pboolean		converted;
+	PFiberContextFunc	func;
+	ppointer		data;
+};
+
+static VOID CALLBACK pp_fiber_win_entry (LPVOID param);
+
+static VOID CALLBACK
+pp_fiber_win_entry (LPVOID param)
+{
+	PFiberContext *context = (PFiberContext *) param;
+
+	context->func (context->data);
+}
+
+PFiberContext *
+p_fiber_context_new_thread (void)
+{
+	PFiberContext *ret;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PFiberContext))) == NULL))
+		return NULL;
+
+	/* The thread may be converted already by someone else */
+	if ((ret->fiber = ConvertThreadToFiber (NULL)) != NULL)
+		ret->converted = TRUE;
+	else if (GetLastError () == ERROR_ALREADY_FIBER)
+		ret->fiber = GetCurrentFiber ();
+
+	if (P_UNLIKELY (ret->fiber == NULL)) {
+		p_free (ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+PFiberContext *
+p_fiber_context_new (psize		stack_size,
+		     PFiberContextFunc	func,
+		     ppointer		data)
+{
+	PFiberContext *ret;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PFiberContext))) == NULL))
+		return NULL;
+
+	ret->func = func;
+	ret->data = data;
+
+	/* The system reserves the stack along with its guard page */
+	ret->fiber = CreateFiberEx (stack_size,
+				    stack_size,
+				    FIBER_FLAG_FLOAT_SWITCH,
+				    pp_fiber_win_entry,
+				    ret);
+
+	if (P_UNLIKELY (ret->fiber == NULL)) {
+		p_free (ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+void
+p_fiber_context_switch (PFiberContext	*from,
+			PFiberContext	*to)
+{
+	P_UNUSED (from);
+
+	SwitchToFiber (to->fiber);
+}
+
+void
+p_fiber_context_free (PFiberContext *context)
+{
+	if (context->func != NULL)
+		DeleteFiber (context->fiber);
+	else if (context->converted == TRUE)
+		ConvertFiberToThread ();
+
+	p_free (context);
+}
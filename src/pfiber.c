@@ -0,0 +1,689 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "pfiber.h"
+#include "plist.h"
+#include "pmem.h"
+#include "pfiber-private.h"
+
+#if !defined (P_CC_MSVC) && !defined (PLIBSYS_HAS_THREAD_KEYWORD)
+#  include "ponce.h"
+#  include "puthread.h"
+#endif
+
+#define P_FIBER_DEFAULT_STACK_SIZE	(64 * 1024)
+#define P_FIBER_MIN_STACK_SIZE		(16 * 1024)
+#define P_FIBER_MAX_IDLE		64
+
+#if defined (P_CC_MSVC)
+#  define P_FIBER_THREAD_LOCAL	__declspec(thread)
+#elif defined (PLIBSYS_HAS_THREAD_KEYWORD)
+#  define P_FIBER_THREAD_LOCAL	__thread
+#endif
+
+typedef enum PFiberState_ {
+	P_FIBER_STATE_IDLE	= 0,
+	P_FIBER_STATE_READY	= 1,
+	P_FIBER_STATE_RUNNING	= 2,
+	P_FIBER_STATE_SUSPENDED	= 3,
+	P_FIBER_STATE_WAITING	= 4
+} PFiberState;
+
+struct PFiber_ {
+	PListLink		link;
+	PListLink		all_link;
+	PFiberScheduler		*scheduler;
+	PFiberContext		*context;
+	PFiberFunc		func;
+	ppointer		user_data;
+	PFiberState		state;
+	PSocket			*wait_socket;
+	PEventLoopTimer		*wait_timer;
+	pint			wait_result;
+};
+
+/* Outlives the scheduler while its dispatch is still queued in the loop */
+typedef struct PFiberDispatch_ {
+	PFiberScheduler		*scheduler;
+} PFiberDispatch;
+
+struct PFiberScheduler_ {
+	PEventLoop		*loop;
+	PFiberContext		*context;
+	psize			stack_size;
+	PListLink		ready;
+	psize			ready_count;
+	PListLink		idle;
+	psize			idle_count;
+	PListLink		all;
+	psize			count;
+	PFiber			*current;
+	PFiber			*dead;
+	PFiberDispatch		*dispatch;
+	pboolean		dispatch_posted;
+	pboolean		running;
+};
+
+#ifdef P_FIBER_THREAD_LOCAL
+static P_FIBER_THREAD_LOCAL PFiberScheduler *pp_fiber_scheduler = NULL;
+
+#  define P_FIBER_GET_SCHEDULER()		(pp_fiber_scheduler)
+#  define P_FIBER_SET_SCHEDULER(scheduler)	(pp_fiber_scheduler = (scheduler))
+#else
+static POnce		pp_fiber_once = P_ONCE_INIT;
+static PUThreadKey	*pp_fiber_key = NULL;
+
+static void pp_fiber_key_init (ppointer data);
+
+static void
+pp_fiber_key_init (ppointer data)
+{
+	P_UNUSED (data);
+
+	pp_fiber_key = p_uthread_local_new (NULL);
+}
+
+#  define P_FIBER_GET_SCHEDULER()		((PFiberScheduler *) p_uthread_get_local (pp_fiber_key))
+#  define P_FIBER_SET_SCHEDULER(scheduler)	p_uthread_set_local (pp_fiber_key, (scheduler))
+#endif
+
+static void pp_fiber_entry (ppointer data);
+static void pp_fiber_free (PFiber *fiber);
+static void pp_fiber_make_ready (PFiber *fiber);
+static void pp_fiber_park (PFiber *fiber, PFiberState state);
+static PFiber * pp_fiber_get_waitable (PError **error);
+static void pp_fiber_scheduler_wake (PFiberScheduler *scheduler);
+static void pp_fiber_dispatch_func (PEventLoop *loop, ppointer user_data);
+static void pp_fiber_sleep_func (PEventLoop *loop, PEventLoopTimer *timer, ppointer user_data);
+static void pp_fiber_socket_func (PEventLoop *loop, PSocket *socket, pint conditions, ppointer user_data);
+static void pp_fiber_timeout_func (PEventLoop *loop, PEventLoopTimer *timer, ppointer user_data);
+
+/* Fibers are never unwound: a finished one returns to the scheduler and waits
+ * to be reused for the next spawn */
+static void
+pp_fiber_entry (ppointer data)
+{
+	PFiber		*fiber = data;
+	PFiberScheduler	*scheduler = fiber->scheduler;
+
+	for (;;) {
+		fiber->func (fiber->user_data);
+
+		fiber->func      = NULL;
+		fiber->user_data = NULL;
+		fiber->state     = P_FIBER_STATE_IDLE;
+
+		--scheduler->count;
+
+		/* Own stack can't be released while running on it */
+		if (scheduler->idle_count < P_FIBER_MAX_IDLE) {
+			p_list_link_append (&scheduler->idle, &fiber->link);
+			++scheduler->idle_count;
+		} else
+			scheduler->dead = fiber;
+
+		p_fiber_context_switch (fiber->context, scheduler->context);
+	}
+}
+
+static void
+pp_fiber_free (PFiber *fiber)
+{
+	p_list_link_remove (&fiber->all_link);
+	p_fiber_context_free (fiber->context);
+	p_free (fiber);
+}
+
+static void
+pp_fiber_make_ready (PFiber *fiber)
+{
+	PFiberScheduler *scheduler = fiber->scheduler;
+
+	fiber->state = P_FIBER_STATE_READY;
+
+	p_list_link_append (&scheduler->ready, &fiber->link);
+	++scheduler->ready_count;
+
+	pp_fiber_scheduler_wake (scheduler);
+}
+
+static void
+pp_fiber_park (PFiber		*fiber,
+	       PFiberState	state)
+{
+	fiber->state = state;
+
+	p_fiber_context_switch (fiber->context, fiber->scheduler->context);
+}
+
+static PFiber *
+pp_fiber_get_waitable (PError **error)
+{
+	PFiberScheduler *scheduler = P_FIBER_GET_SCHEDULER ();
+
+	if (P_UNLIKELY (scheduler == NULL || scheduler->current == NULL || scheduler->loop == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Must be called from a fiber of a scheduler with a loop");
+		return NULL;
+	}
+
+	return scheduler->current;
+}
+
+/* Posted from the loop thread, the task runs within the same iteration
+ * without a wakeup */
+static void
+pp_fiber_scheduler_wake (PFiberScheduler *scheduler)
+{
+	if (scheduler->loop == NULL || scheduler->running == TRUE || scheduler->dispatch_posted == TRUE)
+		return;
+
+	if (P_UNLIKELY (p_event_loop_post (scheduler->loop, pp_fiber_dispatch_func, scheduler->dispatch) == FALSE)) {
+		P_ERROR ("PFiber::pp_fiber_scheduler_wake: failed to schedule fibers");
+		return;
+	}
+
+	scheduler->dispatch_posted = TRUE;
+}
+
+static void
+pp_fiber_dispatch_func (PEventLoop	*loop,
+			ppointer	user_data)
+{
+	PFiberDispatch *dispatch = user_data;
+
+	P_UNUSED (loop);
+
+	/* The scheduler is gone */
+	if (dispatch->scheduler == NULL) {
+		p_free (dispatch);
+		return;
+	}
+
+	dispatch->scheduler->dispatch_posted = FALSE;
+
+	p_fiber_scheduler_run_ready (dispatch->scheduler);
+}
+
+static void
+pp_fiber_sleep_func (PEventLoop		*loop,
+		     PEventLoopTimer	*timer,
+		     ppointer		user_data)
+{
+	PFiber *fiber = user_data;
+
+	P_UNUSED (loop);
+	P_UNUSED (timer);
+
+	fiber->wait_timer = NULL;
+
+	pp_fiber_make_ready (fiber);
+}
+
+static void
+pp_fiber_socket_func (PEventLoop	*loop,
+		      PSocket		*socket,
+		      pint		conditions,
+		      ppointer		user_data)
+{
+	PFiber *fiber = user_data;
+
+	p_event_loop_remove_socket (loop, socket, NULL);
+
+	if (fiber->wait_timer != NULL) {
+		p_event_loop_cancel_timer (loop, fiber->wait_timer);
+		fiber->wait_timer = NULL;
+	}
+
+	fiber->wait_socket = NULL;
+	fiber->wait_result = conditions;
+
+	pp_fiber_make_ready (fiber);
+}
+
+static void
+pp_fiber_timeout_func (PEventLoop	*loop,
+		       PEventLoopTimer	*timer,
+		       ppointer		user_data)
+{
+	PFiber *fiber = user_data;
+
+	P_UNUSED (timer);
+
+	p_event_loop_remove_socket (loop, fiber->wait_socket, NULL);
+
+	fiber->wait_timer  = NULL;
+	fiber->wait_socket = NULL;
+	fiber->wait_result = 0;
+
+	pp_fiber_make_ready (fiber);
+}
+
+P_LIB_API PFiberScheduler *
+p_fiber_scheduler_new (PEventLoop	*loop,
+		       psize		stack_size,
+		       PError		**error)
+{
+	PFiberScheduler *ret;
+
+#ifndef P_FIBER_THREAD_LOCAL
+	p_once (&pp_fiber_once, pp_fiber_key_init, NULL);
+#endif
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PFiberScheduler))) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for fiber scheduler");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret->dispatch = p_malloc0 (sizeof (PFiberDispatch))) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for fiber scheduler");
+		p_free (ret);
+		return NULL;
+	}
+
+	ret->dispatch->scheduler = ret;
+
+	/* Fibers are run on behalf of this thread's context */
+	if (P_UNLIKELY ((ret->context = p_fiber_context_new_thread ()) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to create thread context for fibers");
+		p_free (ret->dispatch);
+		p_free (ret);
+		return NULL;
+	}
+
+	if (stack_size == 0)
+		stack_size = P_FIBER_DEFAULT_STACK_SIZE;
+	else if (stack_size < P_FIBER_MIN_STACK_SIZE)
+		stack_size = P_FIBER_MIN_STACK_SIZE;
+
+	ret->loop       = loop;
+	ret->stack_size = stack_size;
+
+	p_list_link_init (&ret->ready);
+	p_list_link_init (&ret->idle);
+	p_list_link_init (&ret->all);
+
+	return ret;
+}
+
+P_LIB_API pboolean
+p_fiber_scheduler_spawn (PFiberScheduler	*scheduler,
+			 PFiberFunc		func,
+			 ppointer		user_data,
+			 PError			**error)
+{
+	PFiber *fiber;
+
+	if (P_UNLIKELY (scheduler == NULL || func == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	if (scheduler->idle_count > 0) {
+		fiber = P_CONTAINER_OF (scheduler->idle.next, PFiber, link);
+
+		p_list_link_remove (&fiber->link);
+		--scheduler->idle_count;
+	} else {
+		if (P_UNLIKELY ((fiber = p_malloc0 (sizeof (PFiber))) == NULL)) {
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IO_NO_RESOURCES,
+					     0,
+					     "Failed to allocate memory for fiber");
+			return FALSE;
+		}
+
+		fiber->scheduler = scheduler;
+		fiber->context   = p_fiber_context_new (scheduler->stack_size, pp_fiber_entry, fiber);
+
+		if (P_UNLIKELY (fiber->context == NULL)) {
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IO_NO_RESOURCES,
+					     0,
+					     "Failed to allocate fiber stack");
+			p_free (fiber);
+			return FALSE;
+		}
+
+		p_list_link_append (&scheduler->all, &fiber->all_link);
+	}
+
+	fiber->func      = func;
+	fiber->user_data = user_data;
+
+	++scheduler->count;
+
+	pp_fiber_make_ready (fiber);
+
+	return TRUE;
+}
+
+P_LIB_API pint
+p_fiber_scheduler_run_ready (PFiberScheduler *scheduler)
+{
+	PFiberScheduler	*prev_scheduler;
+	PFiber		*fiber;
+	psize		count;
+	psize		i;
+
+	if (P_UNLIKELY (scheduler == NULL || scheduler->running == TRUE))
+		return -1;
+
+	prev_scheduler = P_FIBER_GET_SCHEDULER ();
+
+	/* Schedulers of the same thread can't be nested from a fiber */
+	if (P_UNLIKELY (prev_scheduler != NULL && prev_scheduler->current != NULL))
+		return -1;
+
+	P_FIBER_SET_SCHEDULER (scheduler);
+
+	scheduler->running = TRUE;
+
+	/* The fibers getting ready meanwhile wait for the next run */
+	count = scheduler->ready_count;
+
+	for (i = 0; i < count; ++i) {
+		fiber = P_CONTAINER_OF (scheduler->ready.next, PFiber, link);
+
+		p_list_link_remove (&fiber->link);
+		--scheduler->ready_count;
+
+		fiber->state       = P_FIBER_STATE_RUNNING;
+		scheduler->current = fiber;
+
+		p_fiber_context_switch (scheduler->context, fiber->context);
+
+		scheduler->current = NULL;
+
+		if (scheduler->dead != NULL) {
+			pp_fiber_free (scheduler->dead);
+			scheduler->dead = NULL;
+		}
+	}
+
+	scheduler->running = FALSE;
+
+	P_FIBER_SET_SCHEDULER (prev_scheduler);
+
+	if (scheduler->ready_count > 0)
+		pp_fiber_scheduler_wake (scheduler);
+
+	return (pint) count;
+}
+
+P_LIB_API psize
+p_fiber_scheduler_get_count (const PFiberScheduler *scheduler)
+{
+	if (P_UNLIKELY (scheduler == NULL))
+		return 0;
+
+	return scheduler->count;
+}
+
+P_LIB_API void
+p_fiber_scheduler_free (PFiberScheduler *scheduler)
+{
+	PFiber *fiber;
+
+	if (P_UNLIKELY (scheduler == NULL))
+		return;
+
+	if (P_UNLIKELY (scheduler->running == TRUE)) {
+		P_ERROR ("PFiber::p_fiber_scheduler_free: called from a fiber");
+		return;
+	}
+
+	/* The queued dispatch releases itself */
+	if (scheduler->dispatch_posted == TRUE)
+		scheduler->dispatch->scheduler = NULL;
+	else
+		p_free (scheduler->dispatch);
+
+	while (p_list_link_is_empty (&scheduler->all) == FALSE) {
+		fiber = P_CONTAINER_OF (scheduler->all.next, PFiber, all_link);
+
+		if (fiber->wait_socket != NULL)
+			p_event_loop_remove_socket (scheduler->loop, fiber->wait_socket, NULL);
+
+		if (fiber->wait_timer != NULL)
+			p_event_loop_cancel_timer (scheduler->loop, fiber->wait_timer);
+
+		pp_fiber_free (fiber);
+	}
+
+	p_fiber_context_free (scheduler->context);
+	p_free (scheduler);
+}
+
+P_LIB_API PFiber *
+p_fiber_current (void)
+{
+	PFiberScheduler *scheduler;
+
+#ifndef P_FIBER_THREAD_LOCAL
+	if (P_UNLIKELY (pp_fiber_key == NULL))
+		return NULL;
+#endif
+
+	scheduler = P_FIBER_GET_SCHEDULER ();
+
+	return scheduler != NULL ? scheduler->current : NULL;
+}
+
+P_LIB_API pboolean
+p_fiber_yield (void)
+{
+	PFiber *fiber;
+
+	if (P_UNLIKELY ((fiber = p_fiber_current ()) == NULL))
+		return FALSE;
+
+	p_list_link_append (&fiber->scheduler->ready, &fiber->link);
+	++fiber->scheduler->ready_count;
+
+	pp_fiber_park (fiber, P_FIBER_STATE_READY);
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_fiber_suspend (void)
+{
+	PFiber *fiber;
+
+	if (P_UNLIKELY ((fiber = p_fiber_current ()) == NULL))
+		return FALSE;
+
+	pp_fiber_park (fiber, P_FIBER_STATE_SUSPENDED);
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_fiber_resume (PFiber *fiber)
+{
+	if (P_UNLIKELY (fiber == NULL || fiber->state != P_FIBER_STATE_SUSPENDED))
+		return FALSE;
+
+	pp_fiber_make_ready (fiber);
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_fiber_sleep (puint32 msec)
+{
+	PFiber *fiber;
+
+	if (P_UNLIKELY ((fiber = pp_fiber_get_waitable (NULL)) == NULL))
+		return FALSE;
+
+	fiber->wait_timer = p_event_loop_add_timer (fiber->scheduler->loop,
+						    msec,
+						    0,
+						    pp_fiber_sleep_func,
+						    fiber);
+
+	if (P_UNLIKELY (fiber->wait_timer == NULL))
+		return FALSE;
+
+	pp_fiber_park (fiber, P_FIBER_STATE_WAITING);
+
+	return TRUE;
+}
+
+P_LIB_API pint
+p_fiber_wait_socket (PSocket	*socket,
+		     pint	conditions,
+		     pint	timeout,
+		     PError	**error)
+{
+	PFiber		*fiber;
+	PEventLoop	*loop;
+
+	if (P_UNLIKELY (socket == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	if (P_UNLIKELY ((fiber = pp_fiber_get_waitable (error)) == NULL))
+		return -1;
+
+	loop = fiber->scheduler->loop;
+
+	if (P_UNLIKELY (p_event_loop_add_socket (loop,
+						 socket,
+						 conditions,
+						 P_SOCKET_POLLER_FLAG_NONE,
+						 pp_fiber_socket_func,
+						 fiber,
+						 error) == FALSE))
+		return -1;
+
+	if (timeout >= 0) {
+		fiber->wait_timer = p_event_loop_add_timer (loop,
+							    (puint64) timeout,
+							    0,
+							    pp_fiber_timeout_func,
+							    fiber);
+
+		if (P_UNLIKELY (fiber->wait_timer == NULL)) {
+			p_event_loop_remove_socket (loop, socket, NULL);
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IO_NO_RESOURCES,
+					     0,
+					     "Failed to allocate memory for timeout");
+			return -1;
+		}
+	}
+
+	fiber->wait_socket = socket;
+	fiber->wait_result = 0;
+
+	pp_fiber_park (fiber, P_FIBER_STATE_WAITING);
+
+	return fiber->wait_result;
+}
+
+P_LIB_API pssize
+p_fiber_socket_receive (PSocket	*socket,
+			pchar	*buffer,
+			psize	buflen,
+			PError	**error)
+{
+	PError	*tmp_error;
+	pssize	ret;
+
+	for (;;) {
+		tmp_error = NULL;
+
+		if ((ret = p_socket_receive (socket, buffer, buflen, &tmp_error)) >= 0)
+			return ret;
+
+		if (tmp_error == NULL || p_error_get_code (tmp_error) != (pint) P_ERROR_IO_WOULD_BLOCK)
+			break;
+
+		p_error_free (tmp_error);
+
+		if (P_UNLIKELY (p_fiber_wait_socket (socket, P_SOCKET_POLLER_CONDITION_IN, -1, error) < 0))
+			return -1;
+	}
+
+	if (error != NULL)
+		*error = tmp_error;
+	else if (tmp_error != NULL)
+		p_error_free (tmp_error);
+
+	return -1;
+}
+
+P_LIB_API pssize
+p_fiber_socket_send (PSocket		*socket,
+		     const pchar	*buffer,
+		     psize		buflen,
+		     PError		**error)
+{
+	PError	*tmp_error;
+	pssize	ret;
+
+	for (;;) {
+		tmp_error = NULL;
+
+		if ((ret = p_socket_send (socket, buffer, buflen, &tmp_error)) >= 0)
+			return ret;
+
+		if (tmp_error == NULL || p_error_get_code (tmp_error) != (pint) P_ERROR_IO_WOULD_BLOCK)
+			break;
+
+		p_error_free (tmp_error);
+
+		if (P_UNLIKELY (p_fiber_wait_socket (socket, P_SOCKET_POLLER_CONDITION_OUT, -1, error) < 0))
+			return -1;
+	}
+
+	if (error != NULL)
+		*error = tmp_error;
+	else if (tmp_error != NULL)
+		p_error_free (tmp_error);
+
+	return -1;
+}
@@ -0,0 +1,249 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pfiber.h
+ * @brief Lightweight fibers
+ * @author Alexander Saprykin
+ *
+ * A fiber is a function running on its own small stack, cooperatively: it
+ * keeps the thread until it yields, sleeps or waits for a socket, and then
+ * another fiber of the same thread takes over. The switch costs a few dozen
+ * instructions, so thousands of connections can be served in a plain
+ * sequential style by a single thread instead of one #PUThread each.
+ *
+ * Fibers belong to a #PFiberScheduler, which is bound to a #PEventLoop and
+ * runs the ready fibers from the loop thread. A fiber waiting with
+ * p_fiber_sleep(), p_fiber_wait_socket() or the p_fiber_socket_receive() and
+ * p_fiber_socket_send() helpers is parked, and the loop resumes it once the
+ * timer fires or the socket becomes ready. A scheduler created without a loop
+ * is driven manually with p_fiber_scheduler_run_ready(), its fibers can only
+ * yield or suspend themselves.
+ *
+ * The context switch is hand-written for x86-64 and AArch64 on the System V
+ * and the Apple ABIs, ucontext is used on the other POSIX systems and the
+ * native fibers on Windows. The stacks are allocated with a guard page, so
+ * a stack overflow crashes instead of silently corrupting the memory. The
+ * default stack size is 64 KB, keep the large buffers off the fiber stacks.
+ * Finished fibers are kept in the scheduler and reused along with their
+ * stacks for the next spawns.
+ *
+ * All the calls must be made from the thread running the scheduler's loop. To
+ * wake a fiber from another thread, post a task to the loop with
+ * p_event_loop_post() which calls p_fiber_resume(). A fiber is never moved to
+ * another thread. Fibers are not supported on all the platforms, in that case
+ * p_fiber_scheduler_new() fails.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PFIBER_H
+#define PLIBSYS_HEADER_PFIBER_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+#include "peventloop.h"
+#include "psocket.h"
+#include "perror.h"
+
+P_BEGIN_DECLS
+
+/** Fiber opaque data type. */
+typedef struct PFiber_ PFiber;
+
+/** Fiber scheduler opaque data type. */
+typedef struct PFiberScheduler_ PFiberScheduler;
+
+/**
+ * @brief Fiber body.
+ * @param user_data Data passed on spawning.
+ */
+typedef void (*PFiberFunc) (ppointer user_data);
+
+/**
+ * @brief Creates a new fiber scheduler.
+ * @param loop Event loop to run the fibers from, NULL to run them manually.
+ * @param stack_size Stack size of the fibers in bytes, 0 for the default one.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Pointer to #PFiberScheduler in case of success, NULL otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API PFiberScheduler *	p_fiber_scheduler_new		(PEventLoop		*loop,
+								 psize			stack_size,
+								 PError			**error);
+
+/**
+ * @brief Starts a new fiber.
+ * @param scheduler #PFiberScheduler to run the fiber.
+ * @param func Fiber body.
+ * @param user_data Data to pass to @a func.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The fiber is queued as ready and starts on the next scheduler run, it can be
+ * spawned from another fiber too. A finished fiber's stack is reused.
+ */
+P_LIB_API pboolean		p_fiber_scheduler_spawn		(PFiberScheduler	*scheduler,
+								 PFiberFunc		func,
+								 ppointer		user_data,
+								 PError			**error);
+
+/**
+ * @brief Runs the fibers which are ready.
+ * @param scheduler #PFiberScheduler to run.
+ * @return Number of the fibers run, -1 in case of error.
+ * @since 0.0.5
+ *
+ * Each fiber which was ready on the call runs until it yields, parks or
+ * finishes. The fibers which became ready meanwhile run on the next call.
+ * The scheduler with a loop does it itself from the loop, so the call is
+ * needed only for the manual scheduling. It must not be called from a fiber.
+ */
+P_LIB_API pint			p_fiber_scheduler_run_ready	(PFiberScheduler	*scheduler);
+
+/**
+ * @brief Gets the number of the fibers which are not finished yet.
+ * @param scheduler #PFiberScheduler to get the number for.
+ * @return Number of the live fibers.
+ * @since 0.0.5
+ */
+P_LIB_API psize			p_fiber_scheduler_get_count	(const PFiberScheduler	*scheduler);
+
+/**
+ * @brief Frees a fiber scheduler.
+ * @param scheduler #PFiberScheduler to free.
+ * @since 0.0.5
+ *
+ * The unfinished fibers are dropped along with their stacks without being
+ * unwound, so whatever they hold leaks. It must not be called from a fiber.
+ */
+P_LIB_API void			p_fiber_scheduler_free		(PFiberScheduler	*scheduler);
+
+/**
+ * @brief Gets the calling fiber.
+ * @return Calling fiber, NULL if not called from a fiber.
+ * @since 0.0.5
+ */
+P_LIB_API PFiber *		p_fiber_current			(void);
+
+/**
+ * @brief Lets the other ready fibers run.
+ * @return TRUE in case of success, FALSE if not called from a fiber.
+ * @since 0.0.5
+ *
+ * The fiber is queued as ready and continues on the next scheduler run.
+ */
+P_LIB_API pboolean		p_fiber_yield			(void);
+
+/**
+ * @brief Parks the calling fiber until p_fiber_resume() is called for it.
+ * @return TRUE in case of success, FALSE if not called from a fiber.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean		p_fiber_suspend			(void);
+
+/**
+ * @brief Makes a suspended fiber ready.
+ * @param fiber Fiber to resume.
+ * @return TRUE in case of success, FALSE if the fiber is not suspended.
+ * @since 0.0.5
+ *
+ * Only the fibers parked with p_fiber_suspend() can be resumed, the ones
+ * waiting in p_fiber_sleep() or p_fiber_wait_socket() are resumed by the loop.
+ */
+P_LIB_API pboolean		p_fiber_resume			(PFiber			*fiber);
+
+/**
+ * @brief Parks the calling fiber for a given time.
+ * @param msec Time to sleep, in milliseconds.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * Requires the scheduler to have a loop.
+ */
+P_LIB_API pboolean		p_fiber_sleep			(puint32		msec);
+
+/**
+ * @brief Parks the calling fiber until a socket becomes ready.
+ * @param socket Non-blocking socket to wait for.
+ * @param conditions Combination of #P_SOCKET_POLLER_CONDITION_IN and
+ * #P_SOCKET_POLLER_CONDITION_OUT to wait for.
+ * @param timeout Timeout in milliseconds, -1 to wait infinitely.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Combination of #PSocketPollerCondition reported, 0 on timeout, -1 in
+ * case of error.
+ * @since 0.0.5
+ *
+ * The socket is registered in the scheduler's loop only for the time of the
+ * wait, so it must not be registered there by other means. Requires the
+ * scheduler to have a loop.
+ */
+P_LIB_API pint			p_fiber_wait_socket		(PSocket		*socket,
+								 pint			conditions,
+								 pint			timeout,
+								 PError			**error);
+
+/**
+ * @brief Receives data from a socket, parking the calling fiber while no data
+ * is available.
+ * @param socket Non-blocking socket to receive the data from.
+ * @param buffer Buffer to write the data to.
+ * @param buflen Length of @a buffer.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Size in bytes of the received data in case of success, -1 otherwise.
+ * @since 0.0.5
+ *
+ * Works like p_socket_receive() on a blocking socket, but other fibers keep
+ * running while this one waits.
+ */
+P_LIB_API pssize		p_fiber_socket_receive		(PSocket		*socket,
+								 pchar			*buffer,
+								 psize			buflen,
+								 PError			**error);
+
+/**
+ * @brief Sends data through a socket, parking the calling fiber while the
+ * socket is not writable.
+ * @param socket Non-blocking connected socket to send the data through.
+ * @param buffer Buffer with the data to send.
+ * @param buflen Length of @a buffer.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Size in bytes of the sent data in case of success, -1 otherwise.
+ * @since 0.0.5
+ *
+ * Works like p_socket_send() on a blocking socket, but other fibers keep
+ * running while this one waits.
+ */
+P_LIB_API pssize		p_fiber_socket_send		(PSocket		*socket,
+								 const pchar		*buffer,
+								 psize			buflen,
+								 PError			**error);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PFIBER_H */
@@ -25,11 +25,101 @@
 
 #include "perror.h"
 #include "pfile.h"
+#include "pmem.h"
 #include "perror-private.h"
+#include "pfile-private.h"
+#include "psysclose-private.h"
+
+#include <string.h>
 
 #ifndef P_OS_WIN
 #  include <unistd.h>
+#  include <fcntl.h>
+#  include <errno.h>
+#  include <sys/types.h>
+#  include <sys/stat.h>
+#endif
+
+#if defined (__GLIBC__) || defined (P_OS_LINUX) || defined (P_OS_FREEBSD) || \
+    defined (P_OS_NETBSD) || defined (P_OS_OPENBSD) || defined (P_OS_DRAGONFLY)
+#  define P_FILE_HAVE_VECTOR
+#  include <sys/uio.h>
+#  include <limits.h>
+#endif
+
+#if defined (__GLIBC__) || defined (P_OS_LINUX) || defined (P_OS_FREEBSD) || \
+    defined (P_OS_NETBSD) || defined (P_OS_OPENBSD) || defined (P_OS_SOLARIS)
+#  define P_FILE_HAVE_FDATASYNC
+#endif
+
+#ifdef P_OS_LINUX
+#  define P_FILE_HAVE_SENDFILE
+#  include <sys/ioctl.h>
+#  include <sys/sendfile.h>
+#  include <linux/fs.h>
+#endif
+
+#ifdef PLIBSYS_HAS_CLONEFILE
+#  include <sys/attr.h>
+#  include <sys/clonefile.h>
+#endif
+
+#if defined (PLIBSYS_HAS_COPY_FILE_RANGE) || defined (P_FILE_HAVE_SENDFILE)
+#  define P_FILE_HAVE_KERNEL_COPY
+#endif
+
+/* Maximum number of buffer descriptors for a single preadv() or pwritev() */
+#if defined (P_FILE_HAVE_VECTOR) && defined (IOV_MAX) && IOV_MAX < 64
+#  define P_FILE_VECTOR_MAX		IOV_MAX
+#else
+#  define P_FILE_VECTOR_MAX		64
+#endif
+
+/* Maximum size of a single read or write system call */
+#define P_FILE_CHUNK_MAX		((psize) 1 << 30)
+
+#define P_FILE_WRITER_DEFAULT_SIZE	(1024 * 1024)
+
+/* Buffer size to copy file data through the user space */
+#define P_FILE_COPY_BUFFER_SIZE		(1024 * 1024)
+
+#ifdef P_OS_WIN
+/* FILE_INFO_BY_HANDLE_CLASS values, declared only since Windows Vista */
+#  define P_FILE_WIN_ALLOCATION_INFO	5
+#  define P_FILE_WIN_END_OF_FILE_INFO	6
+
+typedef BOOL (WINAPI * PWin32SetFileInformationByHandle) (HANDLE handle, pint info_class, LPVOID info, DWORD size);
+#endif
+
+struct PFile_ {
+#ifdef P_OS_WIN
+	HANDLE		handle;
+#else
+	pint		fd;
+#endif
+	puint		flags;
+};
+
+struct PFileWriter_ {
+	PFile		*file;
+	puint64		offset;
+	pchar		*buffer;
+	ppointer	buffer_mem;
+	psize		size;
+	psize		used;
+};
+
+static pboolean pp_file_check_range (psize size, puint64 offset, PError **error);
+#ifndef P_OS_WIN
+#  ifdef P_FILE_HAVE_KERNEL_COPY
+static pint pp_file_copy_kernel (pint src_fd, pint dst_fd, puint64 size, pboolean use_sendfile, PError **error);
+#  endif
+static pboolean pp_file_copy_buffer (pint src_fd, pint dst_fd, PError **error);
+static PFileCopyMethod pp_file_copy_fd (pint src_fd, pint dst_fd, puint64 size, puint flags, PError **error);
 #endif
+static pint pp_file_preallocate (PFile *file, puint64 offset, puint64 size, pboolean keep_size);
+static pssize pp_file_transfer (PFile *file, pchar *buffer, psize size, puint64 offset, pboolean write, PError **error);
+static pssize pp_file_transfer_vector (PFile *file, const PFileVector *vectors, psize n_vectors, puint64 offset, pboolean write, PError **error);
 
 P_LIB_API pboolean
 p_file_is_exists (const pchar *file)
@@ -78,3 +168,1216 @@ p_file_remove (const pchar	*file,
 
 	return result;
 }
+
+#ifndef P_OS_WIN
+#  ifdef P_FILE_HAVE_KERNEL_COPY
+/* Returns 1 when copied, 0 when the call doesn't work for these files and
+ * nothing has been copied, -1 in case of error */
+static pint
+pp_file_copy_kernel (pint	src_fd,
+		     pint	dst_fd,
+		     puint64	size,
+		     pboolean	use_sendfile,
+		     PError	**error)
+{
+	puint64	copied = 0;
+	psize	chunk;
+	pssize	count;
+
+#    if !defined (P_FILE_HAVE_SENDFILE) || !defined (PLIBSYS_HAS_COPY_FILE_RANGE)
+	P_UNUSED (use_sendfile);
+#    endif
+
+	/* Both files are at the start, so the file positions are used */
+	while (copied < size) {
+		chunk = size - copied > P_FILE_CHUNK_MAX ? P_FILE_CHUNK_MAX : (psize) (size - copied);
+
+#    if defined (P_FILE_HAVE_SENDFILE) && defined (PLIBSYS_HAS_COPY_FILE_RANGE)
+		if (use_sendfile == TRUE)
+			count = sendfile (dst_fd, src_fd, NULL, chunk);
+		else
+			count = copy_file_range (src_fd, NULL, dst_fd, NULL, chunk, 0);
+#    elif defined (P_FILE_HAVE_SENDFILE)
+		count = sendfile (dst_fd, src_fd, NULL, chunk);
+#    else
+		count = copy_file_range (src_fd, NULL, dst_fd, NULL, chunk, 0);
+#    endif
+
+		if (count < 0) {
+			if (errno == EINTR)
+				continue;
+
+			if (copied == 0 && (errno == ENOSYS || errno == EXDEV || errno == EINVAL ||
+#    ifdef EOPNOTSUPP
+					    errno == EOPNOTSUPP ||
+#    endif
+					    errno == EBADF))
+				return 0;
+
+			p_error_set_error_p (error,
+					     (pint) p_error_get_last_io (),
+					     p_error_get_last_system (),
+					     "Failed to copy file data in kernel");
+			return -1;
+		}
+
+		/* Some pseudo file systems report no data this way */
+		if (count == 0)
+			return copied == 0 ? 0 : 1;
+
+		copied += (puint64) count;
+	}
+
+	return 1;
+}
+#  endif
+
+static pboolean
+pp_file_copy_buffer (pint	src_fd,
+		     pint	dst_fd,
+		     PError	**error)
+{
+	pchar	*buffer;
+	off_t	offset = 0;
+	pssize	count;
+	pssize	written;
+	pssize	done;
+
+	if (P_UNLIKELY ((buffer = p_malloc (P_FILE_COPY_BUFFER_SIZE)) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for copy buffer");
+		return FALSE;
+	}
+
+	for (;;) {
+		if ((count = pread (src_fd, buffer, P_FILE_COPY_BUFFER_SIZE, offset)) < 0) {
+			if (errno == EINTR)
+				continue;
+
+			p_error_set_error_p (error,
+					     (pint) p_error_get_last_io (),
+					     p_error_get_last_system (),
+					     "Failed to call pread() to read file");
+			p_free (buffer);
+			return FALSE;
+		}
+
+		if (count == 0)
+			break;
+
+		for (done = 0; done < count; done += written) {
+			written = pwrite (dst_fd, buffer + done, (psize) (count - done), offset + done);
+
+			if (written < 0 && errno == EINTR) {
+				written = 0;
+				continue;
+			}
+
+			if (P_UNLIKELY (written <= 0)) {
+				p_error_set_error_p (error,
+						     (pint) p_error_get_last_io (),
+						     p_error_get_last_system (),
+						     "Failed to call pwrite() to write file");
+				p_free (buffer);
+				return FALSE;
+			}
+		}
+
+		offset += count;
+	}
+
+	p_free (buffer);
+
+	return TRUE;
+}
+
+static PFileCopyMethod
+pp_file_copy_fd (pint		src_fd,
+		 pint		dst_fd,
+		 puint64	size,
+		 puint		flags,
+		 PError		**error)
+{
+#  ifdef P_FILE_HAVE_KERNEL_COPY
+	pint result;
+#  endif
+
+#  if defined (P_OS_LINUX) && defined (FICLONE)
+	if ((flags & P_FILE_COPY_FLAG_NO_CLONE) == 0 && ioctl (dst_fd, FICLONE, src_fd) == 0)
+		return P_FILE_COPY_METHOD_CLONE;
+#  else
+	P_UNUSED (flags);
+#  endif
+
+#  ifdef PLIBSYS_HAS_COPY_FILE_RANGE
+	if ((result = pp_file_copy_kernel (src_fd, dst_fd, size, FALSE, error)) != 0)
+		return result > 0 ? P_FILE_COPY_METHOD_KERNEL : P_FILE_COPY_METHOD_NONE;
+#  endif
+
+#  ifdef P_FILE_HAVE_SENDFILE
+	if ((result = pp_file_copy_kernel (src_fd, dst_fd, size, TRUE, error)) != 0)
+		return result > 0 ? P_FILE_COPY_METHOD_KERNEL : P_FILE_COPY_METHOD_NONE;
+#  endif
+
+#  ifndef P_FILE_HAVE_KERNEL_COPY
+	P_UNUSED (size);
+#  endif
+
+	return pp_file_copy_buffer (src_fd, dst_fd, error) == TRUE ? P_FILE_COPY_METHOD_BUFFER
+								   : P_FILE_COPY_METHOD_NONE;
+}
+#endif /* !P_OS_WIN */
+
+P_LIB_API PFileCopyMethod
+p_file_copy (const pchar	*src,
+	     const pchar	*dst,
+	     puint		flags,
+	     PError		**error)
+{
+#ifndef P_OS_WIN
+	struct stat	src_sb;
+	struct stat	dst_sb;
+	PFileCopyMethod	method;
+	pboolean	created;
+	pint		open_flags;
+	pint		src_fd;
+	pint		dst_fd;
+#endif
+
+	if (P_UNLIKELY (src == NULL || dst == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return P_FILE_COPY_METHOD_NONE;
+	}
+
+#ifdef P_OS_WIN
+	if (P_UNLIKELY (CopyFileExA ((LPCSTR) src,
+				     (LPCSTR) dst,
+				     NULL,
+				     NULL,
+				     NULL,
+				     (flags & P_FILE_COPY_FLAG_OVERWRITE) ? 0 : COPY_FILE_FAIL_IF_EXISTS) == 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call CopyFileExA() to copy file");
+		return P_FILE_COPY_METHOD_NONE;
+	}
+
+	return P_FILE_COPY_METHOD_SYSTEM;
+#else
+	open_flags = O_RDONLY;
+#  ifdef O_CLOEXEC
+	open_flags |= O_CLOEXEC;
+#  endif
+
+	if (P_UNLIKELY ((src_fd = open (src, open_flags)) < 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call open() to open source file");
+		return P_FILE_COPY_METHOD_NONE;
+	}
+
+	if (P_UNLIKELY (fstat (src_fd, &src_sb) != 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call fstat() to get source file size");
+		p_sys_close (src_fd);
+		return P_FILE_COPY_METHOD_NONE;
+	}
+
+	if (P_UNLIKELY (!S_ISREG (src_sb.st_mode))) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Source is not a regular file");
+		p_sys_close (src_fd);
+		return P_FILE_COPY_METHOD_NONE;
+	}
+
+	created = TRUE;
+
+	/* Truncating the source itself would lose its data */
+	if (stat (dst, &dst_sb) == 0) {
+		if (P_UNLIKELY ((flags & P_FILE_COPY_FLAG_OVERWRITE) == 0)) {
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IO_EXISTS,
+					     0,
+					     "Target file already exists");
+			p_sys_close (src_fd);
+			return P_FILE_COPY_METHOD_NONE;
+		}
+
+		if (P_UNLIKELY (dst_sb.st_dev == src_sb.st_dev && dst_sb.st_ino == src_sb.st_ino)) {
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+					     0,
+					     "Source and target are the same file");
+			p_sys_close (src_fd);
+			return P_FILE_COPY_METHOD_NONE;
+		}
+
+		created = FALSE;
+	}
+
+#  ifdef PLIBSYS_HAS_CLONEFILE
+	/* Works only for a new target, copies the metadata as well */
+	if (created == TRUE && (flags & P_FILE_COPY_FLAG_NO_CLONE) == 0 && clonefile (src, dst, 0) == 0) {
+		p_sys_close (src_fd);
+		return P_FILE_COPY_METHOD_CLONE;
+	}
+#  endif
+
+	open_flags = O_WRONLY | O_CREAT | O_TRUNC;
+
+	if ((flags & P_FILE_COPY_FLAG_OVERWRITE) == 0)
+		open_flags |= O_EXCL;
+#  ifdef O_CLOEXEC
+	open_flags |= O_CLOEXEC;
+#  endif
+
+	if (P_UNLIKELY ((dst_fd = open (dst, open_flags, (mode_t) (src_sb.st_mode & 0777))) < 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call open() to open target file");
+		p_sys_close (src_fd);
+		return P_FILE_COPY_METHOD_NONE;
+	}
+
+	method = pp_file_copy_fd (src_fd, dst_fd, (puint64) src_sb.st_size, flags, error);
+
+	if (P_UNLIKELY (p_sys_close (dst_fd) != 0 && method != P_FILE_COPY_METHOD_NONE)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call close() to close target file");
+		method = P_FILE_COPY_METHOD_NONE;
+	}
+
+	p_sys_close (src_fd);
+
+	if (P_UNLIKELY (method == P_FILE_COPY_METHOD_NONE && created == TRUE))
+		unlink (dst);
+
+	return method;
+#endif
+}
+
+static pboolean
+pp_file_check_range (psize	size,
+		     puint64	offset,
+		     PError	**error)
+{
+	/* Both the offset and the end of the range should fit the signed type */
+	if (P_UNLIKELY (offset > (puint64) P_MAXINT64 || (puint64) size > (puint64) P_MAXINT64 - offset
+#ifndef P_OS_WIN
+			|| (sizeof (off_t) < sizeof (puint64) && offset + size > (puint64) P_MAXINT32)
+#endif
+			)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "File offset is out of range");
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/* Transfers the whole buffer, less data is returned only at the end of file */
+static pssize
+pp_file_transfer (PFile		*file,
+		  pchar		*buffer,
+		  psize		size,
+		  puint64	offset,
+		  pboolean	write,
+		  PError	**error)
+{
+	psize		total = 0;
+	psize		chunk;
+#ifdef P_OS_WIN
+	OVERLAPPED	ov;
+	DWORD		done;
+	BOOL		result;
+#else
+	ssize_t		done;
+#endif
+
+	while (total < size) {
+		chunk = size - total;
+
+		if (chunk > P_FILE_CHUNK_MAX)
+			chunk = P_FILE_CHUNK_MAX;
+
+#ifdef P_OS_WIN
+		memset (&ov, 0, sizeof (ov));
+
+		ov.Offset     = (DWORD) ((offset + total) & 0xFFFFFFFF);
+		ov.OffsetHigh = (DWORD) ((offset + total) >> 32);
+
+		if (write == TRUE)
+			result = WriteFile (file->handle, buffer + total, (DWORD) chunk, &done, &ov);
+		else
+			result = ReadFile (file->handle, buffer + total, (DWORD) chunk, &done, &ov);
+
+		if (P_UNLIKELY (result == FALSE)) {
+			if (write == FALSE && GetLastError () == ERROR_HANDLE_EOF)
+				break;
+#else
+		if (write == TRUE)
+			done = pwrite (file->fd, buffer + total, chunk, (off_t) (offset + total));
+		else
+			done = pread (file->fd, buffer + total, chunk, (off_t) (offset + total));
+
+		if (P_UNLIKELY (done < 0)) {
+			if (errno == EINTR)
+				continue;
+#endif
+			p_error_set_error_p (error,
+					     (pint) p_error_get_last_io (),
+					     p_error_get_last_system (),
+					     write == TRUE ? "Failed to write data to file"
+							   : "Failed to read data from file");
+			return -1;
+		}
+
+		if (done == 0)
+			break;
+
+		total += (psize) done;
+	}
+
+	return (pssize) total;
+}
+
+static pssize
+pp_file_transfer_vector (PFile			*file,
+			 const PFileVector	*vectors,
+			 psize			n_vectors,
+			 puint64		offset,
+			 pboolean		write,
+			 PError			**error)
+{
+#ifdef P_FILE_HAVE_VECTOR
+	struct iovec	iov[P_FILE_VECTOR_MAX];
+	psize		n_iov;
+	psize		expected;
+	ssize_t		done;
+	psize		skip;
+#endif
+	psize		total = 0;
+	psize		i     = 0;
+	pssize		result;
+
+	if (P_UNLIKELY (file == NULL || (vectors == NULL && n_vectors > 0))) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	for (i = 0; i < n_vectors; ++i) {
+		if (P_UNLIKELY (vectors[i].buflen > P_MAXSIZE - total)) {
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+					     0,
+					     "Total length of buffers is too large");
+			return -1;
+		}
+
+		total += vectors[i].buflen;
+	}
+
+	if (P_UNLIKELY (total > (psize) P_MAXSSIZE)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Total length of buffers is too large");
+		return -1;
+	}
+
+	if (P_UNLIKELY (pp_file_check_range (total, offset, error) == FALSE))
+		return -1;
+
+	total = 0;
+	i     = 0;
+
+	while (i < n_vectors) {
+#ifdef P_FILE_HAVE_VECTOR
+		for (n_iov = 0, expected = 0; n_iov < P_FILE_VECTOR_MAX && i + n_iov < n_vectors; ++n_iov) {
+			iov[n_iov].iov_base = vectors[i + n_iov].buffer;
+			iov[n_iov].iov_len  = vectors[i + n_iov].buflen;
+			expected           += vectors[i + n_iov].buflen;
+		}
+
+		if (write == TRUE)
+			done = pwritev (file->fd, iov, (int) n_iov, (off_t) (offset + total));
+		else
+			done = preadv (file->fd, iov, (int) n_iov, (off_t) (offset + total));
+
+		if (P_UNLIKELY (done < 0)) {
+			if (errno == EINTR)
+				continue;
+
+			p_error_set_error_p (error,
+					     (pint) p_error_get_last_io (),
+					     p_error_get_last_system (),
+					     write == TRUE ? "Failed to write data to file"
+							   : "Failed to read data from file");
+			return -1;
+		}
+
+		total += (psize) done;
+
+		if ((psize) done == expected) {
+			i += n_iov;
+			continue;
+		}
+
+		if (done == 0 && write == FALSE)
+			break;
+
+		/* Short transfer, finish the interrupted buffer with a plain call */
+		for (skip = (psize) done; skip >= vectors[i].buflen; ++i)
+			skip -= vectors[i].buflen;
+
+		result = pp_file_transfer (file,
+					   vectors[i].buffer + skip,
+					   vectors[i].buflen - skip,
+					   offset + total,
+					   write,
+					   error);
+#else
+		result = pp_file_transfer (file,
+					   vectors[i].buffer,
+					   vectors[i].buflen,
+					   offset + total,
+					   write,
+					   error);
+#endif
+		if (P_UNLIKELY (result < 0))
+			return -1;
+
+		total += (psize) result;
+
+#ifdef P_FILE_HAVE_VECTOR
+		if ((psize) result < vectors[i].buflen - skip)
+#else
+		if ((psize) result < vectors[i].buflen)
+#endif
+			break;
+
+		++i;
+	}
+
+	return (pssize) total;
+}
+
+P_LIB_API PFile *
+p_file_new (const pchar	*path,
+	    puint	flags,
+	    PError	**error)
+{
+	PFile	*ret;
+#ifdef P_OS_WIN
+	DWORD	access      = 0;
+	DWORD	disposition;
+	DWORD	attrs       = FILE_ATTRIBUTE_NORMAL;
+#else
+	pint	oflags;
+#endif
+
+	if (P_UNLIKELY (path == NULL || (flags & (P_FILE_OPEN_FLAG_READ | P_FILE_OPEN_FLAG_WRITE)) == 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PFile))) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for file structure");
+		return NULL;
+	}
+
+	ret->flags = flags;
+
+#ifdef P_OS_WIN
+	if (flags & P_FILE_OPEN_FLAG_READ)
+		access |= GENERIC_READ;
+
+	if (flags & P_FILE_OPEN_FLAG_WRITE)
+		access |= GENERIC_WRITE;
+
+	if (flags & P_FILE_OPEN_FLAG_CREATE) {
+		if (flags & P_FILE_OPEN_FLAG_EXCLUSIVE)
+			disposition = CREATE_NEW;
+		else if (flags & P_FILE_OPEN_FLAG_TRUNCATE)
+			disposition = CREATE_ALWAYS;
+		else
+			disposition = OPEN_ALWAYS;
+	} else if (flags & P_FILE_OPEN_FLAG_TRUNCATE)
+		disposition = TRUNCATE_EXISTING;
+	else
+		disposition = OPEN_EXISTING;
+
+	if (flags & P_FILE_OPEN_FLAG_DIRECT)
+		attrs |= FILE_FLAG_NO_BUFFERING | FILE_FLAG_WRITE_THROUGH;
+
+	ret->handle = CreateFileA ((LPCSTR) path,
+				   access,
+				   FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+				   NULL,
+				   disposition,
+				   attrs,
+				   NULL);
+
+	if (P_UNLIKELY (ret->handle == INVALID_HANDLE_VALUE)) {
+#else
+#  if !defined (O_DIRECT) && !defined (F_NOCACHE)
+	if (flags & P_FILE_OPEN_FLAG_DIRECT) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NOT_SUPPORTED,
+				     0,
+				     "Direct I/O is not supported on this platform");
+		p_free (ret);
+		return NULL;
+	}
+#  endif
+
+	if ((flags & P_FILE_OPEN_FLAG_READ) && (flags & P_FILE_OPEN_FLAG_WRITE))
+		oflags = O_RDWR;
+	else if (flags & P_FILE_OPEN_FLAG_WRITE)
+		oflags = O_WRONLY;
+	else
+		oflags = O_RDONLY;
+
+	if (flags & P_FILE_OPEN_FLAG_CREATE)
+		oflags |= O_CREAT;
+
+	if (flags & P_FILE_OPEN_FLAG_EXCLUSIVE)
+		oflags |= O_EXCL;
+
+	if (flags & P_FILE_OPEN_FLAG_TRUNCATE)
+		oflags |= O_TRUNC;
+
+#  ifdef O_CLOEXEC
+	oflags |= O_CLOEXEC;
+#  endif
+
+#  ifdef O_DIRECT
+	if (flags & P_FILE_OPEN_FLAG_DIRECT)
+		oflags |= O_DIRECT;
+#  endif
+
+	while ((ret->fd = open (path, oflags, 0666)) == -1 && errno == EINTR)
+		;
+
+#  if !defined (O_DIRECT) && defined (F_NOCACHE)
+	if (ret->fd != -1 && (flags & P_FILE_OPEN_FLAG_DIRECT) && fcntl (ret->fd, F_NOCACHE, 1) == -1) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to disable caching for file");
+		p_sys_close (ret->fd);
+		p_free (ret);
+		return NULL;
+	}
+#  endif
+
+	if (P_UNLIKELY (ret->fd == -1)) {
+#endif
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to open file");
+		p_free (ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+P_LIB_API pssize
+p_file_read_at (PFile	*file,
+		pchar	*buffer,
+		psize	buflen,
+		puint64	offset,
+		PError	**error)
+{
+	if (P_UNLIKELY (file == NULL || (buffer == NULL && buflen > 0) || buflen > (psize) P_MAXSSIZE)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	if (P_UNLIKELY (pp_file_check_range (buflen, offset, error) == FALSE))
+		return -1;
+
+	return pp_file_transfer (file, buffer, buflen, offset, FALSE, error);
+}
+
+P_LIB_API pssize
+p_file_write_at (PFile		*file,
+		 const pchar	*buffer,
+		 psize		buflen,
+		 puint64	offset,
+		 PError		**error)
+{
+	if (P_UNLIKELY (file == NULL || (buffer == NULL && buflen > 0) || buflen > (psize) P_MAXSSIZE)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	if (P_UNLIKELY (pp_file_check_range (buflen, offset, error) == FALSE))
+		return -1;
+
+	return pp_file_transfer (file, (pchar *) buffer, buflen, offset, TRUE, error);
+}
+
+P_LIB_API pssize
+p_file_read_vector_at (PFile			*file,
+		       const PFileVector	*vectors,
+		       psize			n_vectors,
+		       puint64			offset,
+		       PError			**error)
+{
+	return pp_file_transfer_vector (file, vectors, n_vectors, offset, FALSE, error);
+}
+
+P_LIB_API pssize
+p_file_write_vector_at (PFile			*file,
+			const PFileVector	*vectors,
+			psize			n_vectors,
+			puint64			offset,
+			PError			**error)
+{
+	return pp_file_transfer_vector (file, vectors, n_vectors, offset, TRUE, error);
+}
+
+P_LIB_API pboolean
+p_file_sync (PFile	*file,
+	     PError	**error)
+{
+	pboolean result;
+
+	if (P_UNLIKELY (file == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+#ifdef P_OS_WIN
+	result = (FlushFileBuffers (file->handle) != 0);
+#else
+	while ((result = (fsync (file->fd) == 0)) == FALSE && errno == EINTR)
+		;
+#endif
+
+	if (P_UNLIKELY (!result))
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to synchronize file");
+
+	return result;
+}
+
+P_LIB_API pboolean
+p_file_sync_data (PFile		*file,
+		  PError	**error)
+{
+#ifdef P_FILE_HAVE_FDATASYNC
+	pboolean result;
+
+	if (P_UNLIKELY (file == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	while ((result = (fdatasync (file->fd) == 0)) == FALSE && errno == EINTR)
+		;
+
+	if (P_UNLIKELY (!result))
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to synchronize file data");
+
+	return result;
+#else
+	return p_file_sync (file, error);
+#endif
+}
+
+P_LIB_API pint64
+p_file_get_size (PFile	*file,
+		 PError	**error)
+{
+#ifdef P_OS_WIN
+	LARGE_INTEGER	size;
+#else
+	struct stat	sb;
+#endif
+
+	if (P_UNLIKELY (file == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+#ifdef P_OS_WIN
+	if (P_UNLIKELY (GetFileSizeEx (file->handle, &size) == 0)) {
+#else
+	if (P_UNLIKELY (fstat (file->fd, &sb) != 0)) {
+#endif
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to get file size");
+		return -1;
+	}
+
+#ifdef P_OS_WIN
+	return (pint64) size.QuadPart;
+#else
+	return (pint64) sb.st_size;
+#endif
+}
+
+/* Returns 1 on success, 0 if the preallocation isn't supported and -1 on
+ * error with the system error code set */
+static pint
+pp_file_preallocate (PFile	*file,
+		     puint64	offset,
+		     puint64	size,
+		     pboolean	keep_size)
+{
+#if defined (P_OS_WIN)
+	PWin32SetFileInformationByHandle	set_info_func = NULL;
+	HMODULE					hmodule;
+	LARGE_INTEGER				file_size;
+	LARGE_INTEGER				end;
+
+	if (P_UNLIKELY (GetFileSizeEx (file->handle, &file_size) == 0))
+		return -1;
+
+	end.QuadPart = (LONGLONG) (offset + size);
+
+	/* Non-sparse files have all the space up to the end allocated */
+	if (end.QuadPart <= file_size.QuadPart)
+		return 1;
+
+	/* Available since Windows Vista */
+	if ((hmodule = GetModuleHandleA ("kernel32.dll")) != NULL)
+		set_info_func = (PWin32SetFileInformationByHandle) GetProcAddress (hmodule,
+										   "SetFileInformationByHandle");
+
+	if (set_info_func != NULL) {
+		if (P_UNLIKELY (set_info_func (file->handle,
+					       P_FILE_WIN_ALLOCATION_INFO,
+					       &end,
+					       sizeof (end)) == 0))
+			return -1;
+
+		if (keep_size)
+			return 1;
+
+		return set_info_func (file->handle, P_FILE_WIN_END_OF_FILE_INFO, &end, sizeof (end)) != 0 ? 1 : -1;
+	}
+
+	if (keep_size)
+		return 0;
+
+	/* Extending the file allocates the space for it as well */
+	if (P_UNLIKELY (SetFilePointerEx (file->handle, end, NULL, FILE_BEGIN) == 0))
+		return -1;
+
+	return SetEndOfFile (file->handle) != 0 ? 1 : -1;
+#elif defined (PLIBSYS_HAS_FALLOCATE) || defined (PLIBSYS_HAS_POSIX_FALLOCATE)
+	pint result;
+
+#  ifdef PLIBSYS_HAS_FALLOCATE
+	while ((result = fallocate (file->fd,
+				    keep_size ? FALLOC_FL_KEEP_SIZE : 0,
+				    (off_t) offset,
+				    (off_t) size)) != 0 && errno == EINTR)
+		;
+
+	if (result == 0)
+		return 1;
+
+	if (errno != EOPNOTSUPP && errno != ENOSYS)
+		return -1;
+#  endif
+
+	if (keep_size)
+		return 0;
+
+#  ifdef PLIBSYS_HAS_POSIX_FALLOCATE
+	/* Unlike fallocate(), it emulates the call by writing zeros if needed */
+	while ((result = posix_fallocate (file->fd, (off_t) offset, (off_t) size)) == EINTR)
+		;
+
+	if (result == 0)
+		return 1;
+
+	if (result == EOPNOTSUPP || result == ENOSYS)
+		return 0;
+
+	errno = result;
+	return -1;
+#  else
+	return 0;
+#  endif
+#elif defined (F_PREALLOCATE)
+	struct stat	sb;
+	fstore_t	store;
+
+	if (P_UNLIKELY (fstat (file->fd, &sb) != 0))
+		return -1;
+
+	if ((puint64) sb.st_size >= offset + size)
+		return 1;
+
+	/* F_PEOFPOSMODE allocates the space starting from the physical end */
+	store.fst_flags      = F_ALLOCATECONTIG | F_ALLOCATEALL;
+	store.fst_posmode    = F_PEOFPOSMODE;
+	store.fst_offset     = 0;
+	store.fst_length     = (off_t) (offset + size - (puint64) sb.st_size);
+	store.fst_bytesalloc = 0;
+
+	if (fcntl (file->fd, F_PREALLOCATE, &store) == -1) {
+		/* Contiguous space is not a requirement */
+		store.fst_flags = F_ALLOCATEALL;
+
+		if (P_UNLIKELY (fcntl (file->fd, F_PREALLOCATE, &store) == -1))
+			return errno == ENOTSUP ? 0 : -1;
+	}
+
+	if (keep_size)
+		return 1;
+
+	return ftruncate (file->fd, (off_t) (offset + size)) == 0 ? 1 : -1;
+#else
+	P_UNUSED (file);
+	P_UNUSED (offset);
+	P_UNUSED (size);
+	P_UNUSED (keep_size);
+
+	return 0;
+#endif
+}
+
+P_LIB_API pboolean
+p_file_preallocate (PFile	*file,
+		    puint64	offset,
+		    puint64	size,
+		    pboolean	keep_size,
+		    PError	**error)
+{
+	pint result;
+
+	if (P_UNLIKELY (file == NULL || size == 0 || offset > (puint64) P_MAXINT64 - size)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	result = pp_file_preallocate (file, offset, size, keep_size);
+
+	if (P_UNLIKELY (result == 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NOT_SUPPORTED,
+				     0,
+				     "File space preallocation is not supported");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (result < 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to preallocate file space");
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_file_advise (PFile		*file,
+	       puint64		offset,
+	       puint64		size,
+	       PFileAdvice	advice,
+	       PError		**error)
+{
+#if defined (PLIBSYS_HAS_POSIX_FADVISE)
+	pint			native_advice;
+	pint			result;
+#elif defined (F_RDAHEAD) && defined (F_RDADVISE)
+	struct radvisory	ra;
+	struct stat		sb;
+	pboolean		result = TRUE;
+#endif
+
+	if (P_UNLIKELY (file == NULL				||
+			offset > (puint64) P_MAXINT64		||
+			size > (puint64) P_MAXINT64 - offset	||
+			(pint) advice < (pint) P_FILE_ADVICE_NORMAL	||
+			(pint) advice > (pint) P_FILE_ADVICE_DONT_NEED)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+#if defined (PLIBSYS_HAS_POSIX_FADVISE)
+	switch (advice) {
+	case P_FILE_ADVICE_SEQUENTIAL:
+		native_advice = POSIX_FADV_SEQUENTIAL;
+		break;
+	case P_FILE_ADVICE_RANDOM:
+		native_advice = POSIX_FADV_RANDOM;
+		break;
+	case P_FILE_ADVICE_WILL_NEED:
+		native_advice = POSIX_FADV_WILLNEED;
+		break;
+	case P_FILE_ADVICE_DONT_NEED:
+		native_advice = POSIX_FADV_DONTNEED;
+		break;
+	default:
+		native_advice = POSIX_FADV_NORMAL;
+		break;
+	}
+
+	/* posix_fadvise() returns the error code instead of setting errno */
+	if (P_UNLIKELY ((result = posix_fadvise (file->fd, (off_t) offset, (off_t) size, native_advice)) != 0)) {
+		errno = result;
+
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to set file access advice");
+		return FALSE;
+	}
+
+	return TRUE;
+#elif defined (F_RDAHEAD) && defined (F_RDADVISE)
+	switch (advice) {
+	case P_FILE_ADVICE_NORMAL:
+	case P_FILE_ADVICE_SEQUENTIAL:
+		result = (fcntl (file->fd, F_RDAHEAD, 1) != -1);
+		break;
+	case P_FILE_ADVICE_RANDOM:
+		result = (fcntl (file->fd, F_RDAHEAD, 0) != -1);
+		break;
+	case P_FILE_ADVICE_WILL_NEED:
+		if (size == 0) {
+			if ((result = (fstat (file->fd, &sb) == 0)) == FALSE)
+				break;
+
+			size = (puint64) sb.st_size > offset ? (puint64) sb.st_size - offset : 0;
+		}
+
+		ra.ra_offset = (off_t) offset;
+		ra.ra_count  = (pint) (size > (puint64) P_MAXINT32 ? (puint64) P_MAXINT32 : size);
+
+		result = (ra.ra_count == 0 || fcntl (file->fd, F_RDADVISE, &ra) != -1);
+		break;
+	default:
+		/* There is no way to drop a file range from the cache */
+		break;
+	}
+
+	if (P_UNLIKELY (!result)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to set file access advice");
+		return FALSE;
+	}
+
+	return TRUE;
+#else
+	P_UNUSED (offset);
+	P_UNUSED (size);
+	P_UNUSED (advice);
+
+	return TRUE;
+#endif
+}
+
+#ifndef P_OS_WIN
+pint
+p_file_get_fd (const PFile *file)
+{
+	return file->fd;
+}
+#endif
+
+P_LIB_API void
+p_file_free (PFile *file)
+{
+	if (P_UNLIKELY (file == NULL))
+		return;
+
+#ifdef P_OS_WIN
+	CloseHandle (file->handle);
+#else
+	p_sys_close (file->fd);
+#endif
+
+	p_free (file);
+}
+
+P_LIB_API PFileWriter *
+p_file_writer_new (PFile	*file,
+		   puint64	offset,
+		   psize	buffer_size)
+{
+	PFileWriter *ret;
+
+	if (P_UNLIKELY (file == NULL || (file->flags & P_FILE_OPEN_FLAG_WRITE) == 0))
+		return NULL;
+
+	if (buffer_size == 0)
+		buffer_size = P_FILE_WRITER_DEFAULT_SIZE;
+
+	if (P_UNLIKELY (buffer_size > P_MAXSIZE - P_FILE_DIRECT_ALIGNMENT))
+		return NULL;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PFileWriter))) == NULL)) {
+		P_ERROR ("PFile::p_file_writer_new: failed(1) to allocate memory");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret->buffer_mem = p_malloc (buffer_size + P_FILE_DIRECT_ALIGNMENT)) == NULL)) {
+		P_ERROR ("PFile::p_file_writer_new: failed(2) to allocate memory");
+		p_free (ret);
+		return NULL;
+	}
+
+	ret->buffer = (pchar *) (((psize) ret->buffer_mem + P_FILE_DIRECT_ALIGNMENT - 1) &
+				 ~((psize) P_FILE_DIRECT_ALIGNMENT - 1));
+	ret->file   = file;
+	ret->offset = offset;
+	ret->size   = buffer_size;
+
+	return ret;
+}
+
+P_LIB_API pboolean
+p_file_writer_write (PFileWriter	*writer,
+		     const pchar	*buffer,
+		     psize		buflen,
+		     PError		**error)
+{
+	if (P_UNLIKELY (writer == NULL || (buffer == NULL && buflen > 0))) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	if (P_LIKELY (buflen <= writer->size - writer->used)) {
+		memcpy (writer->buffer + writer->used, buffer, buflen);
+		writer->used += buflen;
+
+		return TRUE;
+	}
+
+	if (P_UNLIKELY (p_file_writer_flush (writer, error) == FALSE))
+		return FALSE;
+
+	if (buflen < writer->size) {
+		memcpy (writer->buffer, buffer, buflen);
+		writer->used = buflen;
+
+		return TRUE;
+	}
+
+	/* No point in copying large blocks */
+	if (P_UNLIKELY (p_file_write_at (writer->file, buffer, buflen, writer->offset, error) < 0))
+		return FALSE;
+
+	writer->offset += buflen;
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_file_writer_flush (PFileWriter	*writer,
+		     PError		**error)
+{
+	if (P_UNLIKELY (writer == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	if (writer->used == 0)
+		return TRUE;
+
+	if (P_UNLIKELY (p_file_write_at (writer->file,
+					 writer->buffer,
+					 writer->used,
+					 writer->offset,
+					 error) < 0))
+		return FALSE;
+
+	writer->offset += writer->used;
+	writer->used    = 0;
+
+	return TRUE;
+}
+
+P_LIB_API puint64
+p_file_writer_get_offset (const PFileWriter *writer)
+{
+	if (P_UNLIKELY (writer == NULL))
+		return 0;
+
+	return writer->offset + writer->used;
+}
+
+P_LIB_API void
+p_file_writer_free (PFileWriter *writer)
+{
+	if (P_UNLIKELY (writer == NULL))
+		return;
+
+	p_file_writer_flush (writer, NULL);
+
+	p_free (writer->buffer_mem);
+	p_free (writer);
+}
@@ -31,6 +31,39 @@
  * To check file existance use p_file_is_exists(). To remove an exisiting file
  * use p_file_remove().
  *
+ * p_file_copy() copies a file without passing its data through a user space
+ * buffer whenever the system allows: it clones the file on the file systems
+ * with shared extents (FICLONE, clonefile()), then asks the kernel to copy the
+ * data (copy_file_range(), sendfile(), CopyFileExA()), and falls back to a
+ * read and write loop only when none of these work. The used method is
+ * returned as #PFileCopyMethod.
+ *
+ * #PFile is a handle for the positional file I/O. Open a file with
+ * p_file_new() using a combination of #PFileOpenFlags, then read or write data
+ * at the given offsets with p_file_read_at() and p_file_write_at(). Several
+ * buffers can be transferred with a single call using p_file_read_vector_at()
+ * and p_file_write_vector_at(). The positional calls don't use the file
+ * position, so a single #PFile can be shared between threads.
+ *
+ * Use p_file_sync() to flush both data and metadata to a storage device, and
+ * p_file_sync_data() to flush data only (and the metadata required to read it
+ * back).
+ *
+ * A file which grows by appends gets fragmented and updates its metadata on
+ * every extension. Reserve the space ahead with p_file_preallocate() to lay it
+ * out contiguously. p_file_advise() tells the system how the file is going to
+ * be accessed: i.e. read ahead more aggressively for the sequential scans, or
+ * drop the already streamed data from the page cache.
+ *
+ * #P_FILE_OPEN_FLAG_DIRECT bypasses the operating system cache. The buffers,
+ * the offsets and the sizes of the transfers must be aligned then, usually to
+ * the logical block size of the device (#P_FILE_DIRECT_ALIGNMENT is enough on
+ * most systems).
+ *
+ * #PFileWriter coalesces a lot of small sequential writes into the large ones
+ * using a user space buffer. Don't forget to call p_file_writer_flush() before
+ * synchronizing the file or reading the written data back.
+ *
  * #P_DIR_SEPARATOR provides a platform independent directory separator symbol
  * which you can use to form file or directory path.
  */
@@ -56,6 +89,59 @@
 #  define P_DIR_SEPARATOR "/"
 #endif
 
+/** Alignment of the buffers used by #PFileWriter for the direct I/O. */
+#define P_FILE_DIRECT_ALIGNMENT	4096
+
+/** Flags to open a file with. */
+typedef enum PFileOpenFlags_ {
+	P_FILE_OPEN_FLAG_READ		= 1 << 0,	/**< Open for reading.				*/
+	P_FILE_OPEN_FLAG_WRITE		= 1 << 1,	/**< Open for writing.				*/
+	P_FILE_OPEN_FLAG_CREATE		= 1 << 2,	/**< Create the file if it doesn't exist.	*/
+	P_FILE_OPEN_FLAG_EXCLUSIVE	= 1 << 3,	/**< Fail if the file exists, used with
+							     #P_FILE_OPEN_FLAG_CREATE.			*/
+	P_FILE_OPEN_FLAG_TRUNCATE	= 1 << 4,	/**< Truncate the file to zero size.		*/
+	P_FILE_OPEN_FLAG_DIRECT		= 1 << 5	/**< Bypass the operating system cache (O_DIRECT,
+							     FILE_FLAG_NO_BUFFERING).			*/
+} PFileOpenFlags;
+
+/** Flags to copy a file with. */
+typedef enum PFileCopyFlags_ {
+	P_FILE_COPY_FLAG_NONE		= 0,		/**< No flags.					*/
+	P_FILE_COPY_FLAG_OVERWRITE	= 1 << 0,	/**< Replace the existing target file.		*/
+	P_FILE_COPY_FLAG_NO_CLONE	= 1 << 1	/**< Don't share the data blocks with the
+							     source, make a physical copy.		*/
+} PFileCopyFlags;
+
+/** Method used by p_file_copy(). */
+typedef enum PFileCopyMethod_ {
+	P_FILE_COPY_METHOD_NONE		= 0,	/**< Copy failed.						*/
+	P_FILE_COPY_METHOD_CLONE	= 1,	/**< File cloned, the data blocks are shared.			*/
+	P_FILE_COPY_METHOD_KERNEL	= 2,	/**< Data copied by the kernel (copy_file_range(), sendfile()).	*/
+	P_FILE_COPY_METHOD_SYSTEM	= 3,	/**< File copied by the system call (CopyFileExA()).		*/
+	P_FILE_COPY_METHOD_BUFFER	= 4	/**< Data copied through a user space buffer.			*/
+} PFileCopyMethod;
+
+/** Access pattern hints for p_file_advise(). */
+typedef enum PFileAdvice_ {
+	P_FILE_ADVICE_NORMAL		= 0,	/**< No particular access pattern, the default.		*/
+	P_FILE_ADVICE_SEQUENTIAL	= 1,	/**< Data is accessed sequentially, read ahead more.	*/
+	P_FILE_ADVICE_RANDOM		= 2,	/**< Data is accessed randomly, don't read ahead.	*/
+	P_FILE_ADVICE_WILL_NEED		= 3,	/**< Data will be accessed soon, start reading it.	*/
+	P_FILE_ADVICE_DONT_NEED		= 4	/**< Data won't be accessed soon, drop it from cache.	*/
+} PFileAdvice;
+
+/** Buffer descriptor for scatter/gather file operations. */
+typedef struct PFileVector_ {
+	pchar	*buffer;	/**< Buffer to read data in or write data from.	*/
+	psize	buflen;		/**< Length of the buffer.			*/
+} PFileVector;
+
+/** Opened file handle. */
+typedef struct PFile_ PFile;
+
+/** Buffered sequential file writer. */
+typedef struct PFileWriter_ PFileWriter;
+
 P_BEGIN_DECLS
 
 /**
@@ -82,6 +168,297 @@ P_LIB_API pboolean p_file_is_exists	(const pchar	*file);
 P_LIB_API pboolean p_file_remove	(const pchar	*file,
 					 PError		**error);
 
+/**
+ * @brief Copies a file.
+ * @param src Source file path.
+ * @param dst Target file path.
+ * @param flags Copy flags, a combination of #PFileCopyFlags.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Used copy method in case of success, #P_FILE_COPY_METHOD_NONE
+ * otherwise.
+ * @since 0.0.5
+ *
+ * The target file gets the permissions of the source file (minus umask) when
+ * it's created. The call fails if the target file exists, unless
+ * #P_FILE_COPY_FLAG_OVERWRITE is given. A target file created by the call is
+ * removed if the copy fails.
+ *
+ * A clone shares the data blocks with the source until either of the files is
+ * modified, which makes the copy instant and doesn't take space. Use
+ * #P_FILE_COPY_FLAG_NO_CLONE when the copy must survive damage to the blocks
+ * of the source, i.e. for backups on the same device.
+ */
+P_LIB_API PFileCopyMethod p_file_copy	(const pchar	*src,
+					 const pchar	*dst,
+					 puint		flags,
+					 PError		**error);
+
+/**
+ * @brief Opens a file.
+ * @param path Path to the file.
+ * @param flags Open flags, a combination of #PFileOpenFlags.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Pointer to #PFile in case of success, NULL otherwise.
+ * @since 0.0.5
+ *
+ * At least one of #P_FILE_OPEN_FLAG_READ and #P_FILE_OPEN_FLAG_WRITE should be
+ * set. A newly created file gets the default access permissions (0666 modified
+ * by the process umask on UNIX systems).
+ *
+ * The direct I/O is supported on Windows, Linux, FreeBSD and other systems
+ * with O_DIRECT, and on macOS (using F_NOCACHE). On other systems the call
+ * fails with #P_ERROR_IO_NOT_SUPPORTED if #P_FILE_OPEN_FLAG_DIRECT is set.
+ */
+P_LIB_API PFile *	p_file_new		(const pchar		*path,
+						 puint			flags,
+						 PError			**error);
+
+/**
+ * @brief Reads data from a file at a given offset.
+ * @param file #PFile to read data from.
+ * @param buffer Buffer to read data in.
+ * @param buflen Length of @a buffer.
+ * @param offset Offset in the file to read data from.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Size in bytes of read data in case of success, -1 otherwise.
+ * @since 0.0.5
+ *
+ * The call reads until @a buflen bytes are read or the end of the file is
+ * reached, so less than @a buflen bytes are returned only at the end of the
+ * file. The file position isn't used and isn't changed on UNIX systems.
+ */
+P_LIB_API pssize	p_file_read_at		(PFile			*file,
+						 pchar			*buffer,
+						 psize			buflen,
+						 puint64		offset,
+						 PError			**error);
+
+/**
+ * @brief Writes data to a file at a given offset.
+ * @param file #PFile to write data to.
+ * @param buffer Buffer with data to write.
+ * @param buflen Length of @a buffer.
+ * @param offset Offset in the file to write data at.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Size in bytes of written data in case of success, -1 otherwise.
+ * @since 0.0.5
+ *
+ * The call writes all the data unless an error occurs. The file position
+ * isn't used and isn't changed on UNIX systems.
+ */
+P_LIB_API pssize	p_file_write_at		(PFile			*file,
+						 const pchar		*buffer,
+						 psize			buflen,
+						 puint64		offset,
+						 PError			**error);
+
+/**
+ * @brief Reads data from a file at a given offset into several buffers.
+ * @param file #PFile to read data from.
+ * @param vectors Array of buffer descriptors to read data in.
+ * @param n_vectors Number of descriptors in @a vectors.
+ * @param offset Offset in the file to read data from.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Size in bytes of read data in case of success, -1 otherwise.
+ * @since 0.0.5
+ *
+ * The buffers are filled in the order they are given in @a vectors, each
+ * buffer is filled completely before moving to the next one. As with
+ * p_file_read_at(), less data is returned only at the end of the file.
+ *
+ * This call is implemented using preadv() where it's available, otherwise
+ * every buffer is read with a separate call.
+ */
+P_LIB_API pssize	p_file_read_vector_at	(PFile			*file,
+						 const PFileVector	*vectors,
+						 psize			n_vectors,
+						 puint64		offset,
+						 PError			**error);
+
+/**
+ * @brief Writes data from several buffers to a file at a given offset.
+ * @param file #PFile to write data to.
+ * @param vectors Array of buffer descriptors with data to write.
+ * @param n_vectors Number of descriptors in @a vectors.
+ * @param offset Offset in the file to write data at.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Size in bytes of written data in case of success, -1 otherwise.
+ * @since 0.0.5
+ *
+ * The buffers are written one after another in the order they are given in
+ * @a vectors. This call is implemented using pwritev() where it's available,
+ * otherwise every buffer is written with a separate call.
+ */
+P_LIB_API pssize	p_file_write_vector_at	(PFile			*file,
+						 const PFileVector	*vectors,
+						 psize			n_vectors,
+						 puint64		offset,
+						 PError			**error);
+
+/**
+ * @brief Flushes file data and metadata to a storage device.
+ * @param file #PFile to synchronize.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_file_sync		(PFile			*file,
+						 PError			**error);
+
+/**
+ * @brief Flushes file data to a storage device.
+ * @param file #PFile to synchronize.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * Unlike p_file_sync(), the metadata which isn't required to read the data
+ * back (i.e. modification time) may be not flushed, which saves a disk write.
+ * This call is implemented using fdatasync() where it's available, otherwise
+ * it's the same as p_file_sync().
+ */
+P_LIB_API pboolean	p_file_sync_data	(PFile			*file,
+						 PError			**error);
+
+/**
+ * @brief Gets a file size.
+ * @param file #PFile to get the size for.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Size of the file in bytes in case of success, -1 otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pint64	p_file_get_size		(PFile			*file,
+						 PError			**error);
+
+/**
+ * @brief Reserves disk space for a file region.
+ * @param file #PFile to reserve the space for, must be opened for writing.
+ * @param offset Offset of the region in bytes.
+ * @param size Size of the region in bytes, must be greater than zero.
+ * @param keep_size Whether to leave the file size unchanged.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * After a successful call writes into the region don't fail because of the
+ * lack of disk space, and the file system has a chance to allocate the region
+ * contiguously. If @a keep_size is FALSE the file is extended up to
+ * @a offset + @a size if it's smaller, the new bytes are read as zeros. If
+ * @a keep_size is TRUE only the disk space beyond the end of the file is
+ * reserved, which suits the files filled by appends.
+ *
+ * This call is implemented using fallocate() or posix_fallocate() on Linux,
+ * F_PREALLOCATE on macOS and SetFileInformationByHandle() on Windows. Where
+ * the space can't be reserved #P_ERROR_IO_NOT_SUPPORTED is reported.
+ */
+P_LIB_API pboolean	p_file_preallocate	(PFile			*file,
+						 puint64		offset,
+						 puint64		size,
+						 pboolean		keep_size,
+						 PError			**error);
+
+/**
+ * @brief Declares an access pattern for a file region.
+ * @param file #PFile to give the hint for.
+ * @param offset Offset of the region in bytes.
+ * @param size Size of the region in bytes, 0 means up to the end of the file.
+ * @param advice Expected access pattern.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The hint doesn't change the semantics of the file operations, only the
+ * caching strategy. Use #P_FILE_ADVICE_DONT_NEED after streaming a large file
+ * to keep it from evicting more useful data from the page cache.
+ *
+ * This call is implemented using posix_fadvise(), or F_RDAHEAD and F_RDADVISE
+ * on macOS. Windows accepts the access hints only when opening a file, so the
+ * call does nothing and succeeds there, as well as on the other systems
+ * without the hints support.
+ */
+P_LIB_API pboolean	p_file_advise		(PFile			*file,
+						 puint64		offset,
+						 puint64		size,
+						 PFileAdvice		advice,
+						 PError			**error);
+
+/**
+ * @brief Closes a file and frees its resources.
+ * @param file #PFile to free.
+ * @since 0.0.5
+ */
+P_LIB_API void		p_file_free		(PFile			*file);
+
+/**
+ * @brief Creates a new buffered writer.
+ * @param file #PFile to write data to, must be opened for writing.
+ * @param offset Offset in the file to start writing at.
+ * @param buffer_size Size of the buffer in bytes, 0 to use the default one
+ * (1 MiB).
+ * @return Pointer to #PFileWriter in case of success, NULL otherwise.
+ * @since 0.0.5
+ *
+ * Data is written sequentially starting from @a offset. The writer doesn't own
+ * the @a file, it must stay opened until the writer is freed.
+ *
+ * The buffer is aligned to #P_FILE_DIRECT_ALIGNMENT, so it can be used with
+ * the direct I/O if @a buffer_size and @a offset are aligned too. Note that
+ * flushing of a partially filled buffer may fail for such files then.
+ */
+P_LIB_API PFileWriter *	p_file_writer_new	(PFile			*file,
+						 puint64		offset,
+						 psize			buffer_size);
+
+/**
+ * @brief Writes data using a buffered writer.
+ * @param writer #PFileWriter to write data with.
+ * @param buffer Buffer with data to write.
+ * @param buflen Length of @a buffer.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * Data is copied into the buffer which is written to the file when it's full.
+ * Data larger than the buffer is written directly after the buffered data.
+ */
+P_LIB_API pboolean	p_file_writer_write	(PFileWriter		*writer,
+						 const pchar		*buffer,
+						 psize			buflen,
+						 PError			**error);
+
+/**
+ * @brief Writes buffered data to the file.
+ * @param writer #PFileWriter to flush.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * This call doesn't synchronize the file with a storage device, use
+ * p_file_sync() after flushing for that.
+ */
+P_LIB_API pboolean	p_file_writer_flush	(PFileWriter		*writer,
+						 PError			**error);
+
+/**
+ * @brief Gets the current writing offset of a buffered writer.
+ * @param writer #PFileWriter to get the offset for.
+ * @return Offset in the file the next data will be written at.
+ * @since 0.0.5
+ *
+ * The offset includes the data which hasn't been flushed yet.
+ */
+P_LIB_API puint64	p_file_writer_get_offset (const PFileWriter	*writer);
+
+/**
+ * @brief Flushes buffered data and frees a buffered writer.
+ * @param writer #PFileWriter to free.
+ * @since 0.0.5
+ *
+ * Flushing errors are ignored, call p_file_writer_flush() before to check
+ * them.
+ */
+P_LIB_API void		p_file_writer_free	(PFileWriter		*writer);
+
 P_END_DECLS
 
 #endif /* PLIBSYS_HEADER_PFILE_H */
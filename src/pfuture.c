@@ -0,0 +1,755 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "patomic.h"
+#include "pfuture.h"
+#include "pmem.h"
+#include "pmempool.h"
+#include "ponce.h"
+#include "ptimeprofiler.h"
+
+#define P_FUTURE_STATUS_PENDING		0
+#define P_FUTURE_STATUS_COMPLETING	1
+#define P_FUTURE_STATUS_DONE		2
+
+typedef enum PFutureNodeType_ {
+	P_FUTURE_NODE_TYPE_INLINE	= 0,
+	P_FUTURE_NODE_TYPE_POOL		= 1,
+	P_FUTURE_NODE_TYPE_LOOP		= 2,
+	P_FUTURE_NODE_TYPE_ALL		= 3,
+	P_FUTURE_NODE_TYPE_ANY		= 4
+} PFutureNodeType;
+
+struct PFuture_ {
+	volatile pint		ref_count;
+	volatile pint		status;
+	volatile pint		waiters;
+	pboolean		failed;
+	ppointer		value;
+	PError			*error;
+	ppointer volatile	continuations;
+};
+
+/* Promise is the same state seen from the producer side */
+struct PPromise_ {
+	PFuture			future;
+};
+
+typedef struct PFutureCombinator_ {
+	volatile pint		ref_count;
+	volatile pint		remaining;
+	PFuture			**futures;
+	psize			count;
+	PFuture			*result;
+} PFutureCombinator;
+
+typedef struct PFutureNode_ {
+	struct PFutureNode_	*next;
+	PFutureNodeType		type;
+	PFuture			*source;
+	PFuture			*result;
+	PFutureFunc		async_func;
+	PFutureThenFunc		func;
+	ppointer		user_data;
+	PThreadPool		*pool;
+	PEventLoop		*loop;
+	PFutureCombinator	*combinator;
+	psize			index;
+} PFutureNode;
+
+static POnce	pp_future_once = P_ONCE_INIT;
+static PMemPool	*pp_future_pool = NULL;
+
+/* Marks a closed list of continuations */
+static pint	pp_future_closed;
+
+#define P_FUTURE_CLOSED		((ppointer) &pp_future_closed)
+
+static void pp_future_init (ppointer data);
+static ppointer pp_future_alloc (void);
+static PFuture * pp_future_new (pint ref_count);
+static pboolean pp_future_complete (PFuture *future, ppointer value, pboolean failed, PError *error);
+static pboolean pp_future_wait (PFuture *future, pint timeout);
+static PFutureNode * pp_future_node_new (PFutureNodeType type, PFuture *source);
+static void pp_future_node_free (PFutureNode *node);
+static void pp_future_node_add (PFuture *future, PFutureNode *node);
+static void pp_future_node_dispatch (PFutureNode *node);
+static void pp_future_node_run (ppointer data);
+static void pp_future_node_loop_run (PEventLoop *loop, ppointer data);
+static void pp_future_node_async_run (ppointer data);
+static void pp_future_node_fail (PFutureNode *node);
+static void pp_future_combinator_notify (PFutureNode *node);
+static PFuture * pp_future_then (PFuture *future, PFutureNodeType type, PThreadPool *pool, PEventLoop *loop,
+				 PFutureThenFunc func, ppointer user_data);
+static PFuture * pp_future_combine (PFuture **futures, psize count, PFutureNodeType type);
+
+static void
+pp_future_init (ppointer data)
+{
+	psize size = sizeof (PFuture);
+
+	P_UNUSED (data);
+
+	/* All the objects share a single pool */
+	if (size < sizeof (PFutureNode))
+		size = sizeof (PFutureNode);
+
+	if (size < sizeof (PFutureCombinator))
+		size = sizeof (PFutureCombinator);
+
+	pp_future_pool = p_mem_pool_new (size);
+}
+
+static ppointer
+pp_future_alloc (void)
+{
+	p_once (&pp_future_once, pp_future_init, NULL);
+
+	if (P_UNLIKELY (pp_future_pool == NULL))
+		return NULL;
+
+	return p_mem_pool_alloc0 (pp_future_pool);
+}
+
+static PFuture *
+pp_future_new (pint ref_count)
+{
+	PFuture *ret;
+
+	if (P_UNLIKELY ((ret = pp_future_alloc ()) == NULL))
+		return NULL;
+
+	ret->ref_count     = ref_count;
+	ret->status        = P_FUTURE_STATUS_PENDING;
+	ret->continuations = NULL;
+
+	return ret;
+}
+
+static pboolean
+pp_future_complete (PFuture	*future,
+		    ppointer	value,
+		    pboolean	failed,
+		    PError	*error)
+{
+	PFutureNode	*nodes;
+	PFutureNode	*reversed;
+	PFutureNode	*next;
+
+	if (p_atomic_int_compare_and_exchange (&future->status,
+					       P_FUTURE_STATUS_PENDING,
+					       P_FUTURE_STATUS_COMPLETING) == FALSE) {
+		if (error != NULL)
+			p_error_free (error);
+
+		return FALSE;
+	}
+
+	future->value  = value;
+	future->failed = failed;
+	future->error  = error;
+
+	p_atomic_int_set (&future->status, P_FUTURE_STATUS_DONE);
+
+	/* Pairs with the waiter counting itself before checking the status */
+	if (p_atomic_int_get (&future->waiters) > 0)
+		p_atomic_int_notify_all (&future->status);
+
+	do
+		nodes = p_atomic_pointer_get (&future->continuations);
+	while (p_atomic_pointer_compare_and_exchange (&future->continuations,
+						      nodes,
+						      P_FUTURE_CLOSED) == FALSE);
+
+	/* Run in the order the continuations were added */
+	for (reversed = NULL; nodes != NULL; nodes = next) {
+		next           = nodes->next;
+		nodes->next    = reversed;
+		reversed       = nodes;
+	}
+
+	for (; reversed != NULL; reversed = next) {
+		next = reversed->next;
+		pp_future_node_dispatch (reversed);
+	}
+
+	return TRUE;
+}
+
+static pboolean
+pp_future_wait (PFuture	*future,
+		pint	timeout)
+{
+	puint64	deadline;
+	puint64	now;
+	pint	status;
+	pint	remaining;
+
+	if (p_atomic_int_get (&future->status) == P_FUTURE_STATUS_DONE)
+		return TRUE;
+
+	if (timeout == 0)
+		return FALSE;
+
+	deadline  = timeout > 0 ? p_time_coarse_now_msecs () + (puint64) timeout : 0;
+	remaining = -1;
+
+	p_atomic_int_inc (&future->waiters);
+
+	while ((status = p_atomic_int_get (&future->status)) != P_FUTURE_STATUS_DONE) {
+		if (timeout > 0) {
+			if ((now = p_time_coarse_now_msecs ()) >= deadline)
+				break;
+
+			remaining = (pint) (deadline - now);
+		}
+
+		p_atomic_int_wait (&future->status, status, remaining);
+	}
+
+	p_atomic_int_add (&future->waiters, -1);
+
+	return status == P_FUTURE_STATUS_DONE;
+}
+
+static PFutureNode *
+pp_future_node_new (PFutureNodeType	type,
+		    PFuture		*source)
+{
+	PFutureNode *ret;
+
+	if (P_UNLIKELY ((ret = pp_future_alloc ()) == NULL))
+		return NULL;
+
+	ret->type   = type;
+	ret->source = source != NULL ? p_future_ref (source) : NULL;
+
+	return ret;
+}
+
+static void
+pp_future_node_free (PFutureNode *node)
+{
+	if (node->source != NULL)
+		p_future_unref (node->source);
+
+	if (node->result != NULL)
+		p_future_unref (node->result);
+
+	p_mem_pool_release (pp_future_pool, node);
+}
+
+/* Continuations are pushed onto a lock-free stack until it is closed */
+static void
+pp_future_node_add (PFuture	*future,
+		    PFutureNode	*node)
+{
+	PFutureNode *head;
+
+	for (;;) {
+		head = p_atomic_pointer_get (&future->continuations);
+
+		if (head == P_FUTURE_CLOSED) {
+			pp_future_node_dispatch (node);
+			return;
+		}
+
+		node->next = head;
+
+		if (p_atomic_pointer_compare_and_exchange (&future->continuations, head, node) == TRUE)
+			return;
+	}
+}
+
+static void
+pp_future_node_dispatch (PFutureNode *node)
+{
+	switch (node->type) {
+	case P_FUTURE_NODE_TYPE_INLINE:
+		pp_future_node_run (node);
+		break;
+	case P_FUTURE_NODE_TYPE_POOL:
+		if (P_UNLIKELY (p_thread_pool_push (node->pool, pp_future_node_run, node) == FALSE))
+			pp_future_node_fail (node);
+		break;
+	case P_FUTURE_NODE_TYPE_LOOP:
+		if (P_UNLIKELY (p_event_loop_post (node->loop, pp_future_node_loop_run, node) == FALSE))
+			pp_future_node_fail (node);
+		break;
+	case P_FUTURE_NODE_TYPE_ALL:
+	case P_FUTURE_NODE_TYPE_ANY:
+		pp_future_combinator_notify (node);
+		break;
+	}
+}
+
+static void
+pp_future_node_run (ppointer data)
+{
+	PFutureNode	*node  = data;
+	PError		*error = NULL;
+	ppointer	value;
+
+	value = node->func (node->source, node->user_data, &error);
+
+	if (error != NULL)
+		pp_future_complete (node->result, NULL, TRUE, error);
+	else
+		pp_future_complete (node->result, value, FALSE, NULL);
+
+	pp_future_node_free (node);
+}
+
+static void
+pp_future_node_loop_run (PEventLoop	*loop,
+			 ppointer	data)
+{
+	P_UNUSED (loop);
+
+	pp_future_node_run (data);
+}
+
+static void
+pp_future_node_async_run (ppointer data)
+{
+	PFutureNode	*node  = data;
+	PError		*error = NULL;
+	ppointer	value;
+
+	value = node->async_func (node->user_data, &error);
+
+	if (error != NULL)
+		pp_future_complete (node->result, NULL, TRUE, error);
+	else
+		pp_future_complete (node->result, value, FALSE, NULL);
+
+	pp_future_node_free (node);
+}
+
+static void
+pp_future_node_fail (PFutureNode *node)
+{
+	PError *error = NULL;
+
+	p_error_set_error_static_p (&error,
+				    (pint) P_ERROR_IO_NO_RESOURCES,
+				    0,
+				    "Failed to schedule continuation");
+
+	pp_future_complete (node->result, NULL, TRUE, error);
+	pp_future_node_free (node);
+}
+
+static void
+pp_future_combinator_notify (PFutureNode *node)
+{
+	PFutureCombinator	*combinator = node->combinator;
+	PFuture			*failed     = NULL;
+	psize			i;
+
+	if (node->type == P_FUTURE_NODE_TYPE_ANY) {
+		if (p_atomic_int_compare_and_exchange (&combinator->remaining, 1, 0) == TRUE)
+			pp_future_complete (combinator->result, P_INT_TO_POINTER ((pint) node->index), FALSE, NULL);
+	} else if (p_atomic_int_dec_and_test (&combinator->remaining) == TRUE) {
+		for (i = 0; i < combinator->count && failed == NULL; ++i)
+			if (combinator->futures[i]->failed == TRUE)
+				failed = combinator->futures[i];
+
+		if (failed != NULL)
+			pp_future_complete (combinator->result,
+					    NULL,
+					    TRUE,
+					    failed->error != NULL ? p_error_copy (failed->error) : NULL);
+		else
+			pp_future_complete (combinator->result, NULL, FALSE, NULL);
+	}
+
+	pp_future_node_free (node);
+
+	if (p_atomic_int_dec_and_test (&combinator->ref_count) == FALSE)
+		return;
+
+	for (i = 0; i < combinator->count; ++i)
+		p_future_unref (combinator->futures[i]);
+
+	p_free (combinator->futures);
+	p_future_unref (combinator->result);
+	p_mem_pool_release (pp_future_pool, combinator);
+}
+
+static PFuture *
+pp_future_then (PFuture			*future,
+		PFutureNodeType		type,
+		PThreadPool		*pool,
+		PEventLoop		*loop,
+		PFutureThenFunc		func,
+		ppointer		user_data)
+{
+	PFutureNode	*node;
+	PFuture		*ret;
+
+	if (P_UNLIKELY (future == NULL || func == NULL))
+		return NULL;
+
+	/* One reference for the caller, one for the node completing it */
+	if (P_UNLIKELY ((ret = pp_future_new (2)) == NULL)) {
+		P_ERROR ("PFuture::pp_future_then: failed to allocate memory(1)");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((node = pp_future_node_new (type, future)) == NULL)) {
+		P_ERROR ("PFuture::pp_future_then: failed to allocate memory(2)");
+		p_mem_pool_release (pp_future_pool, ret);
+		return NULL;
+	}
+
+	node->result    = ret;
+	node->func      = func;
+	node->user_data = user_data;
+	node->pool      = pool;
+	node->loop      = loop;
+
+	pp_future_node_add (future, node);
+
+	return ret;
+}
+
+static PFuture *
+pp_future_combine (PFuture		**futures,
+		   psize		count,
+		   PFutureNodeType	type)
+{
+	PFutureCombinator	*combinator;
+	PFutureNode		*nodes = NULL;
+	PFutureNode		*node;
+	PFutureNode		*next;
+	PFuture			*ret;
+	psize			i;
+
+	if (P_UNLIKELY (futures == NULL || count == 0 || count > (psize) P_MAXINT32))
+		return NULL;
+
+	for (i = 0; i < count; ++i)
+		if (P_UNLIKELY (futures[i] == NULL))
+			return NULL;
+
+	if (P_UNLIKELY ((ret = pp_future_new (2)) == NULL)) {
+		P_ERROR ("PFuture::pp_future_combine: failed to allocate memory(1)");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((combinator = pp_future_alloc ()) == NULL ||
+			(combinator->futures = p_malloc (count * sizeof (PFuture *))) == NULL)) {
+		P_ERROR ("PFuture::pp_future_combine: failed to allocate memory(2)");
+
+		if (combinator != NULL)
+			p_mem_pool_release (pp_future_pool, combinator);
+
+		p_mem_pool_release (pp_future_pool, ret);
+		return NULL;
+	}
+
+	/* All the nodes are allocated up front, so nothing is attached on failure */
+	for (i = count; i > 0; --i) {
+		if (P_UNLIKELY ((node = pp_future_node_new (type, futures[i - 1])) == NULL)) {
+			P_ERROR ("PFuture::pp_future_combine: failed to allocate memory(3)");
+
+			for (; nodes != NULL; nodes = next) {
+				next = nodes->next;
+				pp_future_node_free (nodes);
+			}
+
+			p_free (combinator->futures);
+			p_mem_pool_release (pp_future_pool, combinator);
+			p_mem_pool_release (pp_future_pool, ret);
+			return NULL;
+		}
+
+		node->combinator = combinator;
+		node->index      = i - 1;
+		node->next       = nodes;
+		nodes            = node;
+	}
+
+	for (i = 0; i < count; ++i)
+		combinator->futures[i] = p_future_ref (futures[i]);
+
+	combinator->count     = count;
+	combinator->result    = ret;
+	combinator->ref_count = (pint) count;
+	combinator->remaining = type == P_FUTURE_NODE_TYPE_ALL ? (pint) count : 1;
+
+	for (i = 0; nodes != NULL; ++i, nodes = next) {
+		next = nodes->next;
+		pp_future_node_add (futures[i], nodes);
+	}
+
+	return ret;
+}
+
+void
+p_future_shutdown (void)
+{
+	/* Let the next library initialization start over */
+	pp_future_once = P_ONCE_INIT;
+
+	if (pp_future_pool != NULL) {
+		p_mem_pool_free (pp_future_pool);
+		pp_future_pool = NULL;
+	}
+}
+
+P_LIB_API PPromise *
+p_promise_new (void)
+{
+	PFuture *ret;
+
+	if (P_UNLIKELY ((ret = pp_future_new (1)) == NULL)) {
+		P_ERROR ("PFuture::p_promise_new: failed to allocate memory");
+		return NULL;
+	}
+
+	return (PPromise *) ret;
+}
+
+P_LIB_API PFuture *
+p_promise_get_future (PPromise *promise)
+{
+	if (P_UNLIKELY (promise == NULL))
+		return NULL;
+
+	return p_future_ref (&promise->future);
+}
+
+P_LIB_API pboolean
+p_promise_set_value (PPromise	*promise,
+		     ppointer	value)
+{
+	if (P_UNLIKELY (promise == NULL))
+		return FALSE;
+
+	return pp_future_complete (&promise->future, value, FALSE, NULL);
+}
+
+P_LIB_API pboolean
+p_promise_set_error (PPromise	*promise,
+		     PError	*error)
+{
+	if (P_UNLIKELY (promise == NULL)) {
+		if (error != NULL)
+			p_error_free (error);
+
+		return FALSE;
+	}
+
+	return pp_future_complete (&promise->future, NULL, TRUE, error);
+}
+
+P_LIB_API void
+p_promise_free (PPromise *promise)
+{
+	if (P_UNLIKELY (promise == NULL))
+		return;
+
+	/* Broken promise, its error is reported as a generic failure */
+	pp_future_complete (&promise->future, NULL, TRUE, NULL);
+
+	p_future_unref (&promise->future);
+}
+
+P_LIB_API PFuture *
+p_future_async (PThreadPool	*pool,
+		PFutureFunc	func,
+		ppointer	user_data)
+{
+	PFutureNode	*node;
+	PFuture		*ret;
+
+	if (P_UNLIKELY (pool == NULL || func == NULL))
+		return NULL;
+
+	if (P_UNLIKELY ((ret = pp_future_new (2)) == NULL)) {
+		P_ERROR ("PFuture::p_future_async: failed to allocate memory(1)");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((node = pp_future_node_new (P_FUTURE_NODE_TYPE_POOL, NULL)) == NULL)) {
+		P_ERROR ("PFuture::p_future_async: failed to allocate memory(2)");
+		p_mem_pool_release (pp_future_pool, ret);
+		return NULL;
+	}
+
+	node->result     = ret;
+	node->async_func = func;
+	node->user_data  = user_data;
+
+	if (P_UNLIKELY (p_thread_pool_push (pool, pp_future_node_async_run, node) == FALSE)) {
+		node->result = NULL;
+		pp_future_node_free (node);
+		p_mem_pool_release (pp_future_pool, ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+P_LIB_API PFuture *
+p_future_ref (PFuture *future)
+{
+	if (P_UNLIKELY (future == NULL))
+		return NULL;
+
+	p_atomic_int_inc (&future->ref_count);
+
+	return future;
+}
+
+P_LIB_API void
+p_future_unref (PFuture *future)
+{
+	if (P_UNLIKELY (future == NULL))
+		return;
+
+	if (p_atomic_int_dec_and_test (&future->ref_count) == FALSE)
+		return;
+
+	if (future->error != NULL)
+		p_error_free (future->error);
+
+	p_mem_pool_release (pp_future_pool, future);
+}
+
+P_LIB_API pboolean
+p_future_is_ready (const PFuture *future)
+{
+	if (P_UNLIKELY (future == NULL))
+		return FALSE;
+
+	return p_atomic_int_get (&future->status) == P_FUTURE_STATUS_DONE;
+}
+
+P_LIB_API pboolean
+p_future_is_failed (const PFuture *future)
+{
+	if (P_UNLIKELY (future == NULL))
+		return FALSE;
+
+	return p_atomic_int_get (&future->status) == P_FUTURE_STATUS_DONE && future->failed == TRUE;
+}
+
+P_LIB_API pboolean
+p_future_wait (PFuture *future)
+{
+	if (P_UNLIKELY (future == NULL))
+		return FALSE;
+
+	return pp_future_wait (future, -1);
+}
+
+P_LIB_API pboolean
+p_future_wait_timed (PFuture	*future,
+		     pint	timeout)
+{
+	if (P_UNLIKELY (future == NULL || timeout < 0))
+		return FALSE;
+
+	return pp_future_wait (future, timeout);
+}
+
+P_LIB_API ppointer
+p_future_get_value (PFuture	*future,
+		    PError	**error)
+{
+	if (P_UNLIKELY (future == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return NULL;
+	}
+
+	pp_future_wait (future, -1);
+
+	if (future->failed == FALSE)
+		return future->value;
+
+	if (error != NULL) {
+		if (future->error != NULL)
+			*error = p_error_copy (future->error);
+		else
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IO_FAILED,
+					     0,
+					     "Future failed without an error, the promise may be broken");
+	}
+
+	return NULL;
+}
+
+P_LIB_API PFuture *
+p_future_then (PFuture		*future,
+	       PFutureThenFunc	func,
+	       ppointer		user_data)
+{
+	return pp_future_then (future, P_FUTURE_NODE_TYPE_INLINE, NULL, NULL, func, user_data);
+}
+
+P_LIB_API PFuture *
+p_future_then_pool (PFuture		*future,
+		    PThreadPool		*pool,
+		    PFutureThenFunc	func,
+		    ppointer		user_data)
+{
+	if (P_UNLIKELY (pool == NULL))
+		return NULL;
+
+	return pp_future_then (future, P_FUTURE_NODE_TYPE_POOL, pool, NULL, func, user_data);
+}
+
+P_LIB_API PFuture *
+p_future_then_loop (PFuture		*future,
+		    PEventLoop		*loop,
+		    PFutureThenFunc	func,
+		    ppointer		user_data)
+{
+	if (P_UNLIKELY (loop == NULL))
+		return NULL;
+
+	return pp_future_then (future, P_FUTURE_NODE_TYPE_LOOP, NULL, loop, func, user_data);
+}
+
+P_LIB_API PFuture *
+p_future_when_all (PFuture	**futures,
+		   psize	count)
+{
+	return pp_future_combine (futures, count, P_FUTURE_NODE_TYPE_ALL);
+}
+
+P_LIB_API PFuture *
+p_future_when_any (PFuture	**futures,
+		   psize	count)
+{
+	return pp_future_combine (futures, count, P_FUTURE_NODE_TYPE_ANY);
+}
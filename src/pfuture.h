@@ -0,0 +1,306 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pfuture.h
+ * @brief Futures and promises
+ * @author Alexander Saprykin
+ *
+ * A promise is the producer side of a single result, a future is the consumer
+ * side. The producer completes the promise once with a value or an error, the
+ * consumers wait for the future with p_future_wait() or
+ * p_future_wait_timed(), or chain a continuation to it with p_future_then(),
+ * which produces a future of its own.
+ *
+ * The completion state is a single atomic status: completing is a compare and
+ * exchange, checking for readiness is a load. The continuations are pushed
+ * onto a lock-free stack, which the producer closes on completion and then
+ * runs the continuations from. A continuation added to a ready future runs
+ * immediately. The waiting threads sleep with p_atomic_int_wait(), and the
+ * producer makes the wakeup call only if someone is actually waiting.
+ *
+ * A continuation runs inline, in the thread completing the future, with
+ * p_future_then(), or is pushed into a #PThreadPool with
+ * p_future_then_pool() or posted into a #PEventLoop with
+ * p_future_then_loop(). p_future_async() runs a function in a thread pool and
+ * gives its result as a future. p_future_when_all() and p_future_when_any()
+ * combine several futures into one.
+ *
+ * Futures are reference counted, each call returning a future gives a new
+ * reference which must be released with p_future_unref(). The values are not
+ * owned by the futures. The promises, the futures and the continuations are
+ * allocated from a shared #PMemPool, so they don't touch the system allocator
+ * in a steady state. All of them must be released before p_libsys_shutdown().
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PFUTURE_H
+#define PLIBSYS_HEADER_PFUTURE_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+#include "peventloop.h"
+#include "perror.h"
+#include "pthreadpool.h"
+
+P_BEGIN_DECLS
+
+/** Future opaque data type. */
+typedef struct PFuture_ PFuture;
+
+/** Promise opaque data type. */
+typedef struct PPromise_ PPromise;
+
+/**
+ * @brief Function producing a future's value.
+ * @param user_data Data passed to p_future_async().
+ * @param[out] error Error to fail the future with, leave it untouched to
+ * succeed.
+ * @return Value of the future.
+ */
+typedef ppointer (*PFutureFunc) (ppointer	user_data,
+				 PError		**error);
+
+/**
+ * @brief Continuation of a future.
+ * @param future Ready future the continuation was added to.
+ * @param user_data Data passed on adding the continuation.
+ * @param[out] error Error to fail the continuation's future with, leave it
+ * untouched to succeed.
+ * @return Value of the continuation's future.
+ */
+typedef ppointer (*PFutureThenFunc) (PFuture	*future,
+				     ppointer	user_data,
+				     PError	**error);
+
+/**
+ * @brief Creates a new promise.
+ * @return Pointer to #PPromise in case of success, NULL otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API PPromise *	p_promise_new			(void);
+
+/**
+ * @brief Gets the future of a promise.
+ * @param promise #PPromise to get the future for.
+ * @return New reference to the future, NULL in case of error.
+ * @since 0.0.5
+ */
+P_LIB_API PFuture *	p_promise_get_future		(PPromise		*promise);
+
+/**
+ * @brief Completes a promise with a value.
+ * @param promise #PPromise to complete.
+ * @param value Value to complete with.
+ * @return TRUE in case of success, FALSE if the promise is already completed.
+ * @since 0.0.5
+ *
+ * Wakes up the waiters and runs or schedules the continuations.
+ */
+P_LIB_API pboolean	p_promise_set_value		(PPromise		*promise,
+							 ppointer		value);
+
+/**
+ * @brief Completes a promise with an error.
+ * @param promise #PPromise to complete.
+ * @param error Error to complete with, the promise takes the ownership of
+ * it. NULL to fail with a generic error.
+ * @return TRUE in case of success, FALSE if the promise is already completed
+ * (then @a error is freed).
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_promise_set_error		(PPromise		*promise,
+							 PError			*error);
+
+/**
+ * @brief Frees a promise.
+ * @param promise #PPromise to free.
+ * @since 0.0.5
+ *
+ * A promise which hasn't been completed yet fails its future with
+ * #P_ERROR_IO_FAILED, so the consumers are never left waiting.
+ */
+P_LIB_API void		p_promise_free			(PPromise		*promise);
+
+/**
+ * @brief Runs a function in a thread pool.
+ * @param pool #PThreadPool to run @a func in.
+ * @param func Function producing the value.
+ * @param user_data Data to pass to @a func.
+ * @return Future of the result in case of success, NULL otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API PFuture *	p_future_async			(PThreadPool		*pool,
+							 PFutureFunc		func,
+							 ppointer		user_data);
+
+/**
+ * @brief Adds a reference to a future.
+ * @param future #PFuture to add the reference to.
+ * @return @a future.
+ * @since 0.0.5
+ */
+P_LIB_API PFuture *	p_future_ref			(PFuture		*future);
+
+/**
+ * @brief Releases a reference to a future.
+ * @param future #PFuture to release the reference to.
+ * @since 0.0.5
+ *
+ * The pending continuations keep their own references, so a future can be
+ * released right after chaining.
+ */
+P_LIB_API void		p_future_unref			(PFuture		*future);
+
+/**
+ * @brief Checks whether a future is completed.
+ * @param future #PFuture to check.
+ * @return TRUE if @a future is completed, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_future_is_ready		(const PFuture		*future);
+
+/**
+ * @brief Checks whether a future is completed with an error.
+ * @param future #PFuture to check.
+ * @return TRUE if @a future is completed with an error, FALSE if it succeeded
+ * or is not completed yet.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_future_is_failed		(const PFuture		*future);
+
+/**
+ * @brief Waits until a future is completed.
+ * @param future #PFuture to wait for.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_future_wait			(PFuture		*future);
+
+/**
+ * @brief Waits until a future is completed or a timeout passes.
+ * @param future #PFuture to wait for.
+ * @param timeout Timeout in milliseconds, 0 to check without waiting.
+ * @return TRUE if @a future is completed, FALSE on timeout or in case of error.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_future_wait_timed		(PFuture		*future,
+							 pint			timeout);
+
+/**
+ * @brief Waits for a future and gets its value.
+ * @param future #PFuture to get the value of.
+ * @param[out] error Copy of the future's error, NULL to ignore.
+ * @return Value of @a future, NULL if it failed.
+ * @since 0.0.5
+ */
+P_LIB_API ppointer	p_future_get_value		(PFuture		*future,
+							 PError			**error);
+
+/**
+ * @brief Chains a continuation running inline.
+ * @param future #PFuture to chain to.
+ * @param func Continuation to run once @a future is completed.
+ * @param user_data Data to pass to @a func.
+ * @return Future of the continuation's result in case of success, NULL
+ * otherwise.
+ * @since 0.0.5
+ *
+ * The continuation runs in the thread completing @a future, or right away in
+ * the calling thread if @a future is already completed. Keep it short.
+ */
+P_LIB_API PFuture *	p_future_then			(PFuture		*future,
+							 PFutureThenFunc	func,
+							 ppointer		user_data);
+
+/**
+ * @brief Chains a continuation running in a thread pool.
+ * @param future #PFuture to chain to.
+ * @param pool #PThreadPool to run the continuation in.
+ * @param func Continuation to run once @a future is completed.
+ * @param user_data Data to pass to @a func.
+ * @return Future of the continuation's result in case of success, NULL
+ * otherwise.
+ * @since 0.0.5
+ *
+ * If the pool refuses the task, the continuation's future fails with
+ * #P_ERROR_IO_NO_RESOURCES.
+ */
+P_LIB_API PFuture *	p_future_then_pool		(PFuture		*future,
+							 PThreadPool		*pool,
+							 PFutureThenFunc	func,
+							 ppointer		user_data);
+
+/**
+ * @brief Chains a continuation running in an event loop.
+ * @param future #PFuture to chain to.
+ * @param loop #PEventLoop to run the continuation in.
+ * @param func Continuation to run once @a future is completed.
+ * @param user_data Data to pass to @a func.
+ * @return Future of the continuation's result in case of success, NULL
+ * otherwise.
+ * @since 0.0.5
+ *
+ * The continuation is posted with p_event_loop_post(). If the loop is freed
+ * before running it, the continuation's future is never completed.
+ */
+P_LIB_API PFuture *	p_future_then_loop		(PFuture		*future,
+							 PEventLoop		*loop,
+							 PFutureThenFunc	func,
+							 ppointer		user_data);
+
+/**
+ * @brief Combines futures into one completed when all of them are.
+ * @param futures Array of the futures to combine.
+ * @param count Number of the futures in @a futures.
+ * @return Combined future in case of success, NULL otherwise.
+ * @since 0.0.5
+ *
+ * The combined future succeeds with NULL value if all the futures succeed,
+ * otherwise it fails with the error of the first failed one in the array
+ * order. The combined future takes its own references to @a futures.
+ */
+P_LIB_API PFuture *	p_future_when_all		(PFuture		**futures,
+							 psize			count);
+
+/**
+ * @brief Combines futures into one completed when any of them is.
+ * @param futures Array of the futures to combine.
+ * @param count Number of the futures in @a futures.
+ * @return Combined future in case of success, NULL otherwise.
+ * @since 0.0.5
+ *
+ * The combined future succeeds with the index of the first completed future,
+ * use P_POINTER_TO_INT() to get it, regardless of whether that one succeeded.
+ */
+P_LIB_API PFuture *	p_future_when_any		(PFuture		**futures,
+							 psize			count);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PFUTURE_H */
@@ -23,69 +23,383 @@
  * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
-/* Hash table organized like this: table[hash key]->[list with values]
- * Note: this implementation is not intended to use on huge loads */
+/* Hash table organized as an open-addressing table with linear probing:
+ * keys and values are stored inline in a single array of slots, a parallel
+ * array keeps the cached hash value (or empty/deleted marker) of each slot,
+ * so most probes touch only one cache line. The table grows automatically
+ * when the load factor (including deleted slots) exceeds the threshold. */
 
 #include "pmem.h"
 #include "phashtable.h"
+#include "pfasthash-xxh3.h"
 
 #include <stdlib.h>
+#include <string.h>
 
-typedef struct PHashTableNode_ PHashTableNode;
+typedef struct PHashTableEntry_ PHashTableEntry;
 
-struct PHashTableNode_ {
-	PHashTableNode	*next;
+struct PHashTableEntry_ {
 	ppointer	key;
 	ppointer	value;
 };
 
 struct PHashTable_ {
-	PHashTableNode	**table;
+	puint		*hashes;
+	PHashTableEntry	*entries;
 	psize		size;
+	psize		used;
+	psize		deleted;
+	PHashFunc	hash_func;
+	PEqualFunc	equal_func;
+	PDestroyFunc	key_destroy_func;
+	PDestroyFunc	value_destroy_func;
+	PHashTable	*value_index;
 };
 
-/* Size of unique hash keys in hash table */
-#define P_HASH_TABLE_SIZE 101
+/* Initial number of slots in hash table, must be a power of two */
+#define P_HASH_TABLE_MIN_SIZE		8
+
+/* Slot markers in the hash array, real hashes are always above them */
+#define P_HASH_TABLE_EMPTY_SLOT		0
+#define P_HASH_TABLE_DELETED_SLOT	1
+#define P_HASH_TABLE_MIN_HASH		2
+
+/* Maximum load factor (used + deleted slots) before the table is rebuilt */
+#define P_HASH_TABLE_LOAD_NUM		3
+#define P_HASH_TABLE_LOAD_DEN		4
+
+static puint pp_hash_table_direct_hash (pconstpointer key);
+static puint pp_hash_table_calc_hash (const PHashTable *table, pconstpointer key);
+static psize pp_hash_table_find_slot (const PHashTable *table, pconstpointer key, puint hash);
+static void pp_hash_table_destroy_entry (PHashTable *table, PHashTableEntry *entry);
+static pboolean pp_hash_table_alloc_slots (PHashTable *table, psize size);
+static pboolean pp_hash_table_resize (PHashTable *table, psize size);
+static psize pp_hash_table_capacity_size (psize capacity);
+static pboolean pp_hash_table_reserve_slot (PHashTable *table);
+static void pp_hash_table_remove_slot (PHashTable *table, psize slot);
+static pboolean pp_hash_table_index_add (PHashTable *table, ppointer key, ppointer value);
+static void pp_hash_table_index_remove (PHashTable *table, pconstpointer key, pconstpointer value);
 
-static puint pp_hash_table_calc_hash (pconstpointer pointer, psize modulo);
-static PHashTableNode * pp_hash_table_find_node (const PHashTable *table, pconstpointer key, puint hash);
+static puint
+pp_hash_table_direct_hash (pconstpointer key)
+{
+	puint64 val;
+
+	/* Fibonacci hashing: take the high bits of the multiplicative mix, so
+	 * aligned pointers with zero low bits are spread over the table */
+	val  = (puint64) ((psize) key);
+	val *= 0x9E3779B97F4A7C15ULL;
+
+	return (puint) (val >> 32);
+}
 
 static puint
-pp_hash_table_calc_hash (pconstpointer pointer, psize modulo)
+pp_hash_table_calc_hash (const PHashTable *table, pconstpointer key)
+{
+	puint hash;
+
+	if (table->hash_func == NULL)
+		hash = pp_hash_table_direct_hash (key);
+	else {
+		/* User functions may have weak low bits, while the slot index
+		 * is taken from them, so mix the bits once more */
+		hash  = table->hash_func (key);
+		hash ^= hash >> 16;
+		hash *= 0x45D9F3BU;
+		hash ^= hash >> 16;
+	}
+
+	return hash < P_HASH_TABLE_MIN_HASH ? hash + P_HASH_TABLE_MIN_HASH : hash;
+}
+
+static psize
+pp_hash_table_find_slot (const PHashTable *table, pconstpointer key, puint hash)
+{
+	psize	mask;
+	psize	i;
+
+	mask = table->size - 1;
+
+	if (table->equal_func == NULL) {
+		for (i = hash & mask; table->hashes[i] != P_HASH_TABLE_EMPTY_SLOT; i = (i + 1) & mask) {
+			if (table->hashes[i] == hash && table->entries[i].key == key)
+				return i;
+		}
+	} else {
+		for (i = hash & mask; table->hashes[i] != P_HASH_TABLE_EMPTY_SLOT; i = (i + 1) & mask) {
+			if (table->hashes[i] == hash && table->equal_func (table->entries[i].key, key) == TRUE)
+				return i;
+		}
+	}
+
+	return table->size;
+}
+
+static void
+pp_hash_table_destroy_entry (PHashTable *table, PHashTableEntry *entry)
+{
+	if (table->key_destroy_func != NULL)
+		table->key_destroy_func (entry->key);
+
+	if (table->value_destroy_func != NULL)
+		table->value_destroy_func (entry->value);
+}
+
+static pboolean
+pp_hash_table_alloc_slots (PHashTable *table, psize size)
+{
+	if (P_UNLIKELY ((table->hashes = p_malloc0 (size * sizeof (puint))) == NULL))
+		return FALSE;
+
+	if (P_UNLIKELY ((table->entries = p_malloc (size * sizeof (PHashTableEntry))) == NULL)) {
+		p_free (table->hashes);
+		table->hashes = NULL;
+		return FALSE;
+	}
+
+	table->size    = size;
+	table->used    = 0;
+	table->deleted = 0;
+
+	return TRUE;
+}
+
+static pboolean
+pp_hash_table_resize (PHashTable *table, psize size)
+{
+	puint		*old_hashes;
+	PHashTableEntry	*old_entries;
+	psize		old_size;
+	psize		mask;
+	psize		i;
+	psize		j;
+
+	old_hashes  = table->hashes;
+	old_entries = table->entries;
+	old_size    = table->size;
+
+	if (P_UNLIKELY (pp_hash_table_alloc_slots (table, size) == FALSE)) {
+		table->hashes  = old_hashes;
+		table->entries = old_entries;
+		return FALSE;
+	}
+
+	mask = size - 1;
+
+	for (i = 0; i < old_size; ++i) {
+		if (old_hashes[i] < P_HASH_TABLE_MIN_HASH)
+			continue;
+
+		for (j = old_hashes[i] & mask; table->hashes[j] != P_HASH_TABLE_EMPTY_SLOT; j = (j + 1) & mask)
+			;
+
+		table->hashes[j]  = old_hashes[i];
+		table->entries[j] = old_entries[i];
+		++table->used;
+	}
+
+	p_free (old_hashes);
+	p_free (old_entries);
+
+	return TRUE;
+}
+
+/* Gives the smallest table size to hold a given number of pairs within the
+ * load factor, or zero on overflow */
+static psize
+pp_hash_table_capacity_size (psize capacity)
+{
+	psize size;
+
+	if (P_UNLIKELY (capacity > ((psize) -1) / P_HASH_TABLE_LOAD_DEN / 2))
+		return 0;
+
+	for (size = P_HASH_TABLE_MIN_SIZE; size * P_HASH_TABLE_LOAD_NUM < capacity * P_HASH_TABLE_LOAD_DEN; size <<= 1)
+		;
+
+	return size;
+}
+
+static pboolean
+pp_hash_table_reserve_slot (PHashTable *table)
+{
+	psize new_size;
+
+	if ((table->used + table->deleted + 1) * P_HASH_TABLE_LOAD_DEN <= table->size * P_HASH_TABLE_LOAD_NUM)
+		return TRUE;
+
+	/* Grow only if live pairs occupy more than a half of the table,
+	 * otherwise just rebuild it in place to purge deleted slots */
+	new_size = table->size;
+
+	if ((table->used + 1) * 2 > table->size)
+		new_size <<= 1;
+
+	if (P_LIKELY (pp_hash_table_resize (table, new_size) == TRUE))
+		return TRUE;
+
+	/* Fallback to the current table while there is at least one free slot */
+	return (table->used + table->deleted + 1 < table->size) ? TRUE : FALSE;
+}
+
+/* Value index maps every value to a set of its keys, which is a hash table
+ * itself with keys mapped to themselves */
+static pboolean
+pp_hash_table_index_add (PHashTable *table, ppointer key, ppointer value)
+{
+	PHashTable	*keys;
+	psize		used;
+
+	if ((keys = p_hash_table_lookup (table->value_index, value)) == (ppointer) -1) {
+		if (P_UNLIKELY ((keys = p_hash_table_new_full (table->hash_func,
+								table->equal_func,
+								NULL,
+								NULL)) == NULL))
+			return FALSE;
+
+		used = table->value_index->used;
+		p_hash_table_insert (table->value_index, value, keys);
+
+		if (P_UNLIKELY (table->value_index->used == used)) {
+			p_hash_table_free (keys);
+			return FALSE;
+		}
+	}
+
+	used = keys->used;
+	p_hash_table_insert (keys, key, key);
+
+	if (P_UNLIKELY (keys->used == used && p_hash_table_lookup (keys, key) != key)) {
+		if (keys->used == 0)
+			p_hash_table_remove (table->value_index, value);
+
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static void
+pp_hash_table_index_remove (PHashTable *table, pconstpointer key, pconstpointer value)
 {
-	/* As simple as we can :) */
-	return (puint) (((psize) (P_POINTER_TO_INT (pointer) + 37)) % modulo);
+	PHashTable *keys;
+
+	if ((keys = p_hash_table_lookup (table->value_index, value)) == (ppointer) -1)
+		return;
+
+	p_hash_table_remove (keys, key);
+
+	if (keys->used == 0)
+		p_hash_table_remove (table->value_index, value);
 }
 
-static PHashTableNode *
-pp_hash_table_find_node (const PHashTable *table, pconstpointer key, puint hash)
+static void
+pp_hash_table_remove_slot (PHashTable *table, psize slot)
 {
-	PHashTableNode *ret;
+	psize mask;
+
+	if (table->value_index != NULL)
+		pp_hash_table_index_remove (table, table->entries[slot].key, table->entries[slot].value);
+
+	pp_hash_table_destroy_entry (table, &table->entries[slot]);
+
+	mask = table->size - 1;
 
-	for (ret = table->table[hash]; ret != NULL; ret = ret->next)
-		if (ret->key == key)
-			return ret;
+	--table->used;
 
-	return NULL;
+	if (table->hashes[(slot + 1) & mask] != P_HASH_TABLE_EMPTY_SLOT) {
+		table->hashes[slot] = P_HASH_TABLE_DELETED_SLOT;
+		++table->deleted;
+		return;
+	}
+
+	/* The probe chain ends here, so trailing deleted slots can be freed,
+	 * pairs are never moved which keeps iterators valid */
+	table->hashes[slot] = P_HASH_TABLE_EMPTY_SLOT;
+
+	for (slot = (slot - 1) & mask; table->hashes[slot] == P_HASH_TABLE_DELETED_SLOT; slot = (slot - 1) & mask) {
+		table->hashes[slot] = P_HASH_TABLE_EMPTY_SLOT;
+		--table->deleted;
+	}
 }
 
 P_LIB_API PHashTable *
 p_hash_table_new (void)
+{
+	return p_hash_table_new_full (NULL, NULL, NULL, NULL);
+}
+
+P_LIB_API PHashTable *
+p_hash_table_new_full (PHashFunc	hash_func,
+		       PEqualFunc	equal_func,
+		       PDestroyFunc	key_destroy,
+		       PDestroyFunc	value_destroy)
 {
 	PHashTable *ret;
 
 	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PHashTable))) == NULL)) {
-		P_ERROR ("PHashTable::p_hash_table_new: failed(1) to allocate memory");
+		P_ERROR ("PHashTable::p_hash_table_new_full: failed(1) to allocate memory");
 		return NULL;
 	}
 
-	if (P_UNLIKELY ((ret->table = p_malloc0 (P_HASH_TABLE_SIZE * sizeof (PHashTableNode *))) == NULL)) {
-		P_ERROR ("PHashTable::p_hash_table_new: failed(2) to allocate memory");
+	if (P_UNLIKELY (pp_hash_table_alloc_slots (ret, P_HASH_TABLE_MIN_SIZE) == FALSE)) {
+		P_ERROR ("PHashTable::p_hash_table_new_full: failed(2) to allocate memory");
 		p_free (ret);
 		return NULL;
 	}
 
-	ret->size = P_HASH_TABLE_SIZE;
+	/* Direct hashing is the default, so don't pay for an indirect call */
+	ret->hash_func          = hash_func == p_direct_hash ? NULL : hash_func;
+	ret->equal_func         = equal_func == p_direct_equal ? NULL : equal_func;
+	ret->key_destroy_func   = key_destroy;
+	ret->value_destroy_func = value_destroy;
+
+	return ret;
+}
+
+P_LIB_API PHashTable *
+p_hash_table_new_sized (psize capacity)
+{
+	PHashTable *ret;
+
+	if (P_UNLIKELY ((ret = p_hash_table_new ()) == NULL))
+		return NULL;
+
+	if (P_UNLIKELY (p_hash_table_reserve (ret, capacity) == FALSE)) {
+		P_ERROR ("PHashTable::p_hash_table_new_sized: failed to allocate memory");
+		p_hash_table_free (ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+P_LIB_API PHashTable *
+p_hash_table_new_indexed (PHashFunc	hash_func,
+			  PEqualFunc	equal_func,
+			  PDestroyFunc	key_destroy,
+			  PDestroyFunc	value_destroy,
+			  PHashFunc	value_hash_func,
+			  PEqualFunc	value_equal_func)
+{
+	PHashTable *ret;
+
+	if (P_UNLIKELY ((ret = p_hash_table_new_full (hash_func,
+						      equal_func,
+						      key_destroy,
+						      value_destroy)) == NULL))
+		return NULL;
+
+	ret->value_index = p_hash_table_new_full (value_hash_func,
+						  value_equal_func,
+						  NULL,
+						  (PDestroyFunc) p_hash_table_free);
+
+	if (P_UNLIKELY (ret->value_index == NULL)) {
+		P_ERROR ("PHashTable::p_hash_table_new_indexed: failed to allocate memory");
+		p_hash_table_free (ret);
+		return NULL;
+	}
 
 	return ret;
 }
@@ -93,57 +407,133 @@ p_hash_table_new (void)
 P_LIB_API void
 p_hash_table_insert (PHashTable *table, ppointer key, ppointer value)
 {
-	PHashTableNode	*node;
-	puint		hash;
+	psize	mask;
+	psize	slot;
+	psize	i;
+	puint	hash;
 
 	if (P_UNLIKELY (table == NULL))
 		return;
 
-	hash = pp_hash_table_calc_hash (key, table->size);
+	hash = pp_hash_table_calc_hash (table, key);
+
+	if ((slot = pp_hash_table_find_slot (table, key, hash)) != table->size) {
+		if (table->value_index != NULL) {
+			/* Add a new value first, so the table stays untouched on
+			 * failure, the same value only needs its key replaced */
+			if (table->value_index->equal_func == NULL ?
+			    table->entries[slot].value == value :
+			    table->value_index->equal_func (table->entries[slot].value, value) == TRUE) {
+				pp_hash_table_index_add (table, key, value);
+			} else {
+				if (P_UNLIKELY (pp_hash_table_index_add (table, key, value) == FALSE)) {
+					P_ERROR ("PHashTable::p_hash_table_insert: failed(1) to allocate memory");
+					return;
+				}
 
-	if ((node = pp_hash_table_find_node (table, key, hash)) == NULL) {
-		if (P_UNLIKELY ((node = p_malloc0 (sizeof (PHashTableNode))) == NULL)) {
-			P_ERROR ("PHashTable::p_hash_table_insert: failed to allocate memory");
-			return;
+				pp_hash_table_index_remove (table, table->entries[slot].key, table->entries[slot].value);
+			}
 		}
 
-		/* Insert a new node in front of others */
-		node->key   = key;
-		node->value = value;
-		node->next  = table->table[hash];
+		pp_hash_table_destroy_entry (table, &table->entries[slot]);
+
+		table->entries[slot].key   = key;
+		table->entries[slot].value = value;
+		return;
+	}
+
+	if (P_UNLIKELY (pp_hash_table_reserve_slot (table) == FALSE)) {
+		P_ERROR ("PHashTable::p_hash_table_insert: failed(2) to allocate memory");
+		return;
+	}
+
+	if (table->value_index != NULL && P_UNLIKELY (pp_hash_table_index_add (table, key, value) == FALSE)) {
+		P_ERROR ("PHashTable::p_hash_table_insert: failed(3) to allocate memory");
+		return;
+	}
+
+	mask = table->size - 1;
+
+	/* Reuse the first deleted slot in the probe sequence */
+	for (i = hash & mask; table->hashes[i] >= P_HASH_TABLE_MIN_HASH; i = (i + 1) & mask)
+		;
+
+	if (table->hashes[i] == P_HASH_TABLE_DELETED_SLOT)
+		--table->deleted;
+
+	table->hashes[i]        = hash;
+	table->entries[i].key   = key;
+	table->entries[i].value = value;
 
-		table->table[hash] = node;
-	} else
-		node->value = value;
+	++table->used;
+}
+
+P_LIB_API pboolean
+p_hash_table_insert_bulk (PHashTable	*table,
+			  ppointer	*keys,
+			  ppointer	*values,
+			  psize		count)
+{
+	psize i;
+
+	if (P_UNLIKELY (table == NULL || (count > 0 && (keys == NULL || values == NULL))))
+		return FALSE;
+
+	if (P_UNLIKELY (count > ((psize) -1) - table->used ||
+			p_hash_table_reserve (table, table->used + count) == FALSE)) {
+		P_ERROR ("PHashTable::p_hash_table_insert_bulk: failed to allocate memory");
+		return FALSE;
+	}
+
+	for (i = 0; i < count; ++i)
+		p_hash_table_insert (table, keys[i], values[i]);
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_hash_table_reserve (PHashTable *table, psize capacity)
+{
+	psize size;
+
+	if (P_UNLIKELY (table == NULL))
+		return FALSE;
+
+	if (P_UNLIKELY ((size = pp_hash_table_capacity_size (capacity)) == 0))
+		return FALSE;
+
+	/* Deleted slots are purged on rebuild, so only live pairs count */
+	if (size <= table->size && (capacity + table->deleted) * P_HASH_TABLE_LOAD_DEN <= table->size * P_HASH_TABLE_LOAD_NUM)
+		return TRUE;
+
+	return pp_hash_table_resize (table, size > table->size ? size : table->size);
 }
 
 P_LIB_API ppointer
 p_hash_table_lookup (const PHashTable *table, pconstpointer key)
 {
-	PHashTableNode	*node;
-	puint		hash;
+	psize slot;
 
 	if (P_UNLIKELY (table == NULL))
 		return NULL;
 
-	hash = pp_hash_table_calc_hash (key, table->size);
+	slot = pp_hash_table_find_slot (table, key, pp_hash_table_calc_hash (table, key));
 
-	return ((node = pp_hash_table_find_node (table, key, hash)) == NULL) ? (ppointer) (-1) : node->value;
+	return slot == table->size ? (ppointer) (-1) : table->entries[slot].value;
 }
 
 P_LIB_API PList *
 p_hash_table_keys (const PHashTable *table)
 {
-	PList		*ret = NULL;
-	PHashTableNode	*node;
-	puint		i;
+	PList	*ret = NULL;
+	psize	i;
 
 	if (P_UNLIKELY (table == NULL))
 		return NULL;
 
 	for (i = 0; i < table->size; ++i)
-		for (node = table->table[i]; node != NULL; node = node->next)
-			ret = p_list_append (ret, node->key);
+		if (table->hashes[i] >= P_HASH_TABLE_MIN_HASH)
+			ret = p_list_prepend (ret, table->entries[i].key);
 
 	return ret;
 }
@@ -151,16 +541,53 @@ p_hash_table_keys (const PHashTable *table)
 P_LIB_API PList *
 p_hash_table_values (const PHashTable *table)
 {
-	PList		*ret = NULL;
-	PHashTableNode	*node;
-	puint		i;
+	PList	*ret = NULL;
+	psize	i;
 
 	if (P_UNLIKELY (table == NULL))
 		return NULL;
 
 	for (i = 0; i < table->size; ++i)
-		for (node = table->table[i]; node != NULL; node = node->next)
-			ret = p_list_append (ret, node->value);
+		if (table->hashes[i] >= P_HASH_TABLE_MIN_HASH)
+			ret = p_list_prepend (ret, table->entries[i].value);
+
+	return ret;
+}
+
+P_LIB_API PArray *
+p_hash_table_keys_array (const PHashTable *table)
+{
+	PArray	*ret;
+	psize	i;
+
+	if (P_UNLIKELY (table == NULL))
+		return NULL;
+
+	if (P_UNLIKELY ((ret = p_array_new_sized (table->used)) == NULL))
+		return NULL;
+
+	for (i = table->size; i > 0; --i)
+		if (table->hashes[i - 1] >= P_HASH_TABLE_MIN_HASH)
+			p_array_push (ret, table->entries[i - 1].key);
+
+	return ret;
+}
+
+P_LIB_API PArray *
+p_hash_table_values_array (const PHashTable *table)
+{
+	PArray	*ret;
+	psize	i;
+
+	if (P_UNLIKELY (table == NULL))
+		return NULL;
+
+	if (P_UNLIKELY ((ret = p_array_new_sized (table->used)) == NULL))
+		return NULL;
+
+	for (i = table->size; i > 0; --i)
+		if (table->hashes[i - 1] >= P_HASH_TABLE_MIN_HASH)
+			p_array_push (ret, table->entries[i - 1].value);
 
 	return ret;
 }
@@ -168,76 +595,164 @@ p_hash_table_values (const PHashTable *table)
 P_LIB_API void
 p_hash_table_free (PHashTable *table)
 {
-	PHashTableNode	*node, *next_node;
-	puint		i;
+	psize i;
 
 	if (P_UNLIKELY (table == NULL))
 		return;
 
-	for (i = 0; i < table->size; ++i)
-		for (node = table->table[i]; node != NULL; ) {
-			next_node = node->next;
-			p_free (node);
-			node = next_node;
-		}
+	if (table->key_destroy_func != NULL || table->value_destroy_func != NULL) {
+		for (i = 0; i < table->size; ++i)
+			if (table->hashes[i] >= P_HASH_TABLE_MIN_HASH)
+				pp_hash_table_destroy_entry (table, &table->entries[i]);
+	}
+
+	if (table->value_index != NULL)
+		p_hash_table_free (table->value_index);
 
-	p_free (table->table);
+	p_free (table->hashes);
+	p_free (table->entries);
 	p_free (table);
 }
 
 P_LIB_API void
 p_hash_table_remove (PHashTable *table, pconstpointer key)
 {
-	PHashTableNode	*node, *prev_node;
-	puint		hash;
+	psize slot;
 
 	if (P_UNLIKELY (table == NULL))
 		return;
 
-	hash = pp_hash_table_calc_hash (key, table->size);
-
-	if (pp_hash_table_find_node (table, key, hash) != NULL) {
-		node = table->table[hash];
-		prev_node = NULL;
-
-		while (node != NULL) {
-			if (node->key == key) {
-				if (prev_node == NULL)
-					table->table[hash] = node->next;
-				else
-					prev_node->next = node->next;
+	if ((slot = pp_hash_table_find_slot (table, key, pp_hash_table_calc_hash (table, key))) == table->size)
+		return;
 
-				p_free (node);
-				break;
-			} else {
-				prev_node = node;
-				node = node->next;
-			}
-		}
-	}
+	pp_hash_table_remove_slot (table, slot);
 }
 
 P_LIB_API PList *
 p_hash_table_lookup_by_value (const PHashTable *table, pconstpointer val, PCompareFunc func)
 {
 	PList		*ret = NULL;
-	PHashTableNode	*node;
-	puint		i;
+	PHashTable	*keys;
+	psize		i;
 	pboolean	res;
 
 	if (P_UNLIKELY (table == NULL))
 		return NULL;
 
-	for (i = 0; i < table->size; ++i)
-		for (node = table->table[i]; node != NULL; node = node->next) {
-			if (func == NULL)
-				res = (node->value == val);
-			else
-				res = (func (node->value, val) == 0);
-
-			if (res)
-				ret = p_list_append (ret, node->key);
-		}
+	if (func == NULL && table->value_index != NULL) {
+		keys = p_hash_table_lookup (table->value_index, val);
+
+		return keys == (ppointer) -1 ? NULL : p_hash_table_keys (keys);
+	}
+
+	for (i = 0; i < table->size; ++i) {
+		if (table->hashes[i] < P_HASH_TABLE_MIN_HASH)
+			continue;
+
+		if (func == NULL)
+			res = (table->entries[i].value == val);
+		else
+			res = (func (table->entries[i].value, val) == 0);
+
+		if (res)
+			ret = p_list_prepend (ret, table->entries[i].key);
+	}
 
 	return ret;
 }
+
+P_LIB_API void
+p_hash_table_iter_init (PHashTableIter *iter, PHashTable *table)
+{
+	if (P_UNLIKELY (iter == NULL))
+		return;
+
+	iter->table    = table;
+	iter->position = (psize) -1;
+	iter->removed  = FALSE;
+}
+
+P_LIB_API pboolean
+p_hash_table_iter_next (PHashTableIter *iter, ppointer *key, ppointer *value)
+{
+	PHashTable	*table;
+	psize		i;
+
+	if (P_UNLIKELY (iter == NULL || iter->table == NULL))
+		return FALSE;
+
+	table = iter->table;
+
+	for (i = iter->position + 1; i < table->size; ++i) {
+		if (table->hashes[i] >= P_HASH_TABLE_MIN_HASH)
+			break;
+	}
+
+	iter->position = i;
+	iter->removed  = FALSE;
+
+	if (i >= table->size)
+		return FALSE;
+
+	if (key != NULL)
+		*key = table->entries[i].key;
+
+	if (value != NULL)
+		*value = table->entries[i].value;
+
+	return TRUE;
+}
+
+P_LIB_API void
+p_hash_table_iter_remove (PHashTableIter *iter)
+{
+	if (P_UNLIKELY (iter == NULL || iter->table == NULL))
+		return;
+
+	if (P_UNLIKELY (iter->removed == TRUE || iter->position >= iter->table->size))
+		return;
+
+	pp_hash_table_remove_slot (iter->table, iter->position);
+
+	iter->removed = TRUE;
+}
+
+P_LIB_API puint
+p_direct_hash (pconstpointer key)
+{
+	return pp_hash_table_direct_hash (key);
+}
+
+P_LIB_API pboolean
+p_direct_equal (pconstpointer a, pconstpointer b)
+{
+	return a == b ? TRUE : FALSE;
+}
+
+P_LIB_API puint
+p_int_hash (pconstpointer key)
+{
+	return (puint) (*((const pint *) key));
+}
+
+P_LIB_API pboolean
+p_int_equal (pconstpointer a, pconstpointer b)
+{
+	return *((const pint *) a) == *((const pint *) b) ? TRUE : FALSE;
+}
+
+P_LIB_API puint
+p_str_hash (pconstpointer key)
+{
+	puint64 hash;
+
+	hash = p_fast_hash_xxh3_64_compute ((const puchar *) key, strlen ((const pchar *) key), 0);
+
+	return (puint) (hash ^ (hash >> 32));
+}
+
+P_LIB_API pboolean
+p_str_equal (pconstpointer a, pconstpointer b)
+{
+	return strcmp ((const pchar *) a, (const pchar *) b) == 0 ? TRUE : FALSE;
+}
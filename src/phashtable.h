@@ -29,26 +29,35 @@
  * @author Alexander Saprykin
  *
  * A hash table is a data structure used to map keys to values. The hash table
- * consists of several internal slots which hold a list of values. A hash
+ * consists of an array of internal slots which hold key-value pairs. A hash
  * function is used to compute an index in the array of the slots from a given
  * key. The hash function itself is fast and it takes a constant time to compute
  * the internal slot index.
  *
- * When the number of pairs in the hash table is small the lookup and insert
- * (remove) operations are very fast and have average complexity O(1), because
- * every slot holds almost the only one pair. As the number of internal slots is
- * fixed, the increasing number of pairs will lead to degraded performance and
- * the average complexity of the operations can drop to O(N) in the worst case.
- * This is because the more pairs are inserted the more longer the list of
- * values is placed in every slot.
+ * This implementation uses open addressing with linear probing: keys and
+ * values are stored inline in the slots array, so a lookup usually touches
+ * only one or two cache lines instead of walking a linked list. If the slot
+ * for a given key is already occupied, the next free slot is used. As the
+ * number of pairs grows the table is automatically resized to keep the load
+ * factor low, so the lookup and insert (remove) operations have average
+ * complexity O(1) even on large data sets.
  *
- * This is a simple hash table implementation which is not intended for heavy
- * usage (several thousands), see #PTree if you need the best performance on
- * large data sets. This implementation doesn't support multi-inserts when
- * several values belong to the same key.
+ * This implementation doesn't support multi-inserts when several values
+ * belong to the same key.
  *
  * Note that #PHashTable stores keys and values only as pointers, so you need
- * to free used memory manually, p_hash_table_free() will not do it in any way.
+ * to free used memory manually, p_hash_table_free() will not do it in any way
+ * unless destroy notification functions were provided with
+ * p_hash_table_new_full().
+ *
+ * By default keys are hashed and compared as pointers. Use
+ * p_hash_table_new_full() to provide custom hash and equality functions, i.e.
+ * p_str_hash() and p_str_equal() for NUL-terminated string keys, or
+ * p_int_hash() and p_int_equal() for keys pointing to integers.
+ *
+ * Use #PHashTableIter to walk through all the pairs in place, without
+ * allocating any memory, see p_hash_table_iter_init(). The current pair can
+ * be safely removed during the iteration with p_hash_table_iter_remove().
  *
  * Integers (up to 32 bits) can be stored in pointers using #P_POINTER_TO_INT
  * and #P_INT_TO_POINTER macros.
@@ -64,12 +73,27 @@
 #include "pmacros.h"
 #include "ptypes.h"
 #include "plist.h"
+#include "parray.h"
 
 P_BEGIN_DECLS
 
 /** Opaque data structure for a hash table. */
 typedef struct PHashTable_ PHashTable;
 
+/**
+ * @brief Hash table iterator.
+ * @since 0.0.5
+ *
+ * The iterator is intended to be allocated on the stack and initialized with
+ * p_hash_table_iter_init(), its fields are private and should not be accessed
+ * directly.
+ */
+typedef struct PHashTableIter_ {
+	PHashTable	*table;		/**< Table being iterated.		*/
+	psize		position;	/**< Current slot position.		*/
+	pboolean	removed;	/**< Whether current pair was removed.	*/
+} PHashTableIter;
+
 /**
  * @brief Initializes a new hash table.
  * @return Pointer to a	 newly initialized #PHashTable structure in case of
@@ -79,6 +103,77 @@ typedef struct PHashTable_ PHashTable;
  */
 P_LIB_API PHashTable *	p_hash_table_new		(void);
 
+/**
+ * @brief Initializes a new hash table with a capacity hint.
+ * @param capacity Number of key-value pairs the table should hold without
+ * growing.
+ * @return Pointer to a newly initialized #PHashTable structure in case of
+ * success, NULL otherwise.
+ * @since 0.0.5
+ * @note Free with p_hash_table_free() after usage.
+ *
+ * Keys are hashed and compared as pointers, just like for p_hash_table_new().
+ * Use p_hash_table_reserve() to pre-size a table with custom functions.
+ */
+P_LIB_API PHashTable *	p_hash_table_new_sized		(psize			capacity);
+
+/**
+ * @brief Initializes a new hash table with custom hashing and memory
+ * management.
+ * @param hash_func Function to calculate a hash value of a key, if NULL then
+ * keys are hashed as pointers.
+ * @param equal_func Function to check two keys for equality, if NULL then keys
+ * are compared as pointers.
+ * @param key_destroy Function to call on every key before its removal from the
+ * table, maybe NULL.
+ * @param value_destroy Function to call on every value before its removal from
+ * the table, maybe NULL.
+ * @return Pointer to a newly initialized #PHashTable structure in case of
+ * success, NULL otherwise.
+ * @since 0.0.5
+ * @note Free with p_hash_table_free() after usage.
+ *
+ * If the key already exists on insertion, it will be replaced with the new one.
+ * Destroy functions are called on the old key and the old value in that case.
+ * Destroy functions are also called on removal and in p_hash_table_free().
+ */
+P_LIB_API PHashTable *	p_hash_table_new_full		(PHashFunc		hash_func,
+							 PEqualFunc		equal_func,
+							 PDestroyFunc		key_destroy,
+							 PDestroyFunc		value_destroy);
+
+/**
+ * @brief Initializes a new hash table with an index of values.
+ * @param hash_func Function to calculate a hash value of a key, if NULL then
+ * keys are hashed as pointers.
+ * @param equal_func Function to check two keys for equality, if NULL then keys
+ * are compared as pointers.
+ * @param key_destroy Function to call on every key before its removal from the
+ * table, maybe NULL.
+ * @param value_destroy Function to call on every value before its removal from
+ * the table, maybe NULL.
+ * @param value_hash_func Function to calculate a hash value of a value, if NULL
+ * then values are hashed as pointers.
+ * @param value_equal_func Function to check two values for equality, if NULL
+ * then values are compared as pointers.
+ * @return Pointer to a newly initialized #PHashTable structure in case of
+ * success, NULL otherwise.
+ * @since 0.0.5
+ * @note Free with p_hash_table_free() after usage.
+ *
+ * The table maintains a secondary index which maps every stored value to the
+ * set of its keys. It is kept in sync on every insertion and removal, so
+ * p_hash_table_lookup_by_value() (with a NULL compare function) takes near
+ * constant time instead of scanning the whole table. The price is additional
+ * memory per every distinct value and slower modifications.
+ */
+P_LIB_API PHashTable *	p_hash_table_new_indexed	(PHashFunc		hash_func,
+							 PEqualFunc		equal_func,
+							 PDestroyFunc		key_destroy,
+							 PDestroyFunc		value_destroy,
+							 PHashFunc		value_hash_func,
+							 PEqualFunc		value_equal_func);
+
 /**
  * @brief Inserts a new key-value pair into a hash table.
  * @param table Initialized hash table.
@@ -93,6 +188,40 @@ P_LIB_API void		p_hash_table_insert		(PHashTable		*table,
 							 ppointer		key,
 							 ppointer		value);
 
+/**
+ * @brief Inserts a number of key-value pairs into a hash table.
+ * @param table Initialized hash table.
+ * @param keys Array of keys to insert.
+ * @param values Array of values to insert, with the same size as @a keys.
+ * @param count Number of pairs in the arrays.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The table is grown once to hold all the pairs before filling, so no
+ * intermediate rehashing takes place. If that fails, nothing is inserted.
+ * Room is reserved for all the given pairs, including ones with keys already
+ * present in the table.
+ * Pairs are inserted in the arrays order, so a duplicated key ends up with
+ * the last of its values.
+ */
+P_LIB_API pboolean	p_hash_table_insert_bulk	(PHashTable		*table,
+							 ppointer		*keys,
+							 ppointer		*values,
+							 psize			count);
+
+/**
+ * @brief Makes room for a number of key-value pairs in a hash table.
+ * @param table Initialized hash table.
+ * @param capacity Total number of key-value pairs the table should hold
+ * without growing.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The table never shrinks, so a capacity below the current one is a no-op.
+ */
+P_LIB_API pboolean	p_hash_table_reserve		(PHashTable		*table,
+							 psize			capacity);
+
 /**
  * @brief Searches for a specifed key in the hash table.
  * @param table Hash table to lookup in.
@@ -126,6 +255,32 @@ P_LIB_API PList *	p_hash_table_keys		(const PHashTable	*table);
  */
 P_LIB_API PList *	p_hash_table_values		(const PHashTable	*table);
 
+/**
+ * @brief Gives an array of all the stored keys in the hash table.
+ * @param table Hash table to collect keys from.
+ * @return Array of all the stored keys, NULL in case of error.
+ * @since 0.0.5
+ * @note You should manually free the returned array with p_array_free() after
+ * using it.
+ *
+ * Keys are given in the same order as p_hash_table_keys() does, but stored in
+ * a single block of memory rather than a node per key.
+ */
+P_LIB_API PArray *	p_hash_table_keys_array		(const PHashTable	*table);
+
+/**
+ * @brief Gives an array of all the stored values in the hash table.
+ * @param table Hash table to collect values from.
+ * @return Array of all the stored values, NULL in case of error.
+ * @since 0.0.5
+ * @note You should manually free the returned array with p_array_free() after
+ * using it.
+ *
+ * Values are given in the same order as p_hash_table_values() does, but stored
+ * in a single block of memory rather than a node per value.
+ */
+P_LIB_API PArray *	p_hash_table_values_array	(const PHashTable	*table);
+
 /**
  * @brief Frees a previously initialized #PHashTable.
  * @param table Hash table to free.
@@ -157,11 +312,132 @@ P_LIB_API void		p_hash_table_remove		(PHashTable		*table,
  * The compare function should return 0 if a value from the hash table (the
  * first parameter) is accepted related to the given lookup value (the second
  * parameter), and -1 or 1 otherwise.
+ *
+ * This call scans the whole table unless it was created with
+ * p_hash_table_new_indexed() and @a func is NULL: in that case the value index
+ * is used, and values are compared with the value equality function of the
+ * index.
  */
 P_LIB_API PList *	p_hash_table_lookup_by_value	(const PHashTable	*table,
 							 pconstpointer		val,
 							 PCompareFunc		func);
 
+/**
+ * @brief Initializes an iterator over a hash table.
+ * @param iter Iterator to initialize.
+ * @param table Hash table to iterate over.
+ * @since 0.0.5
+ *
+ * The iterator doesn't allocate any memory and doesn't require any cleanup.
+ * The table must not be modified during the iteration other than with
+ * p_hash_table_iter_remove(), otherwise the iterator becomes invalid.
+ *
+ * Typical usage:
+ * @code
+ * PHashTableIter	iter;
+ * ppointer		key, value;
+ *
+ * p_hash_table_iter_init (&iter, table);
+ *
+ * while (p_hash_table_iter_next (&iter, &key, &value) == TRUE) {
+ *	if (is_expired (value) == TRUE)
+ *		p_hash_table_iter_remove (&iter);
+ * }
+ * @endcode
+ */
+P_LIB_API void		p_hash_table_iter_init		(PHashTableIter		*iter,
+							 PHashTable		*table);
+
+/**
+ * @brief Advances an iterator to the next key-value pair.
+ * @param iter Initialized iterator.
+ * @param[out] key Pointer to store the key of the pair, maybe NULL.
+ * @param[out] value Pointer to store the value of the pair, maybe NULL.
+ * @return TRUE if the iterator was advanced to the next pair, FALSE if the end
+ * of the table was reached.
+ * @since 0.0.5
+ *
+ * Pairs are returned in arbitrary order.
+ */
+P_LIB_API pboolean	p_hash_table_iter_next		(PHashTableIter		*iter,
+							 ppointer		*key,
+							 ppointer		*value);
+
+/**
+ * @brief Removes the current key-value pair from the table.
+ * @param iter Iterator pointing to a pair to remove.
+ * @since 0.0.5
+ *
+ * Removes the pair returned by the last p_hash_table_iter_next() call, the
+ * destroy functions are called if they were provided with
+ * p_hash_table_new_full(). The iteration can be continued after the removal.
+ */
+P_LIB_API void		p_hash_table_iter_remove	(PHashTableIter		*iter);
+
+/**
+ * @brief Calculates a hash value of a pointer.
+ * @param key Pointer to calculate the hash value for.
+ * @return Hash value of the pointer.
+ * @since 0.0.5
+ *
+ * It uses a multiplicative (Fibonacci) mix, so aligned pointers with zeroed
+ * low bits are spread uniformly. Use along with p_direct_equal(), or pass NULL
+ * to p_hash_table_new_full() which gives the same effect.
+ */
+P_LIB_API puint		p_direct_hash			(pconstpointer		key);
+
+/**
+ * @brief Compares two pointers for equality.
+ * @param a First pointer to compare.
+ * @param b Second pointer to compare.
+ * @return TRUE if the pointers are equal, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_direct_equal			(pconstpointer		a,
+							 pconstpointer		b);
+
+/**
+ * @brief Calculates a hash value of an integer.
+ * @param key Pointer to a #pint value to calculate the hash value for.
+ * @return Hash value of the integer.
+ * @since 0.0.5
+ *
+ * Use this function if keys are pointers to integers. If integers are stored
+ * directly in pointers with #PINT_TO_POINTER, use p_direct_hash() instead.
+ */
+P_LIB_API puint		p_int_hash			(pconstpointer		key);
+
+/**
+ * @brief Compares two integers for equality.
+ * @param a Pointer to the first #pint value to compare.
+ * @param b Pointer to the second #pint value to compare.
+ * @return TRUE if the integers are equal, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_int_equal			(pconstpointer		a,
+							 pconstpointer		b);
+
+/**
+ * @brief Calculates a hash value of a NUL-terminated string.
+ * @param key String to calculate the hash value for.
+ * @return Hash value of the string.
+ * @since 0.0.5
+ *
+ * 64-bit xxHash3 of the string bytes folded to #puint is used, see
+ * #PFastHash.
+ */
+P_LIB_API puint		p_str_hash			(pconstpointer		key);
+
+/**
+ * @brief Compares two NUL-terminated strings for equality.
+ * @param a First string to compare.
+ * @param b Second string to compare.
+ * @return TRUE if the strings are equal, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_str_equal			(pconstpointer		a,
+							 pconstpointer		b);
+
 P_END_DECLS
 
 #endif /* PLIBSYS_HEADER_PHASHTABLE_H */
@@ -0,0 +1,467 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "pmem.h"
+#include "pheap.h"
+
+#define P_HEAP_MIN_CAPACITY	8
+#define P_HEAP_DEFAULT_ARITY	2
+
+/* Elements are kept in the implicit d-ary heap layout: children of the element
+ * at position i are located at positions [d * i + 1, d * i + d]. Positions and
+ * handles are tied with two index arrays, ids[] maps a position to a handle
+ * and pos[] maps a handle back to its position. Unused handles are chained
+ * into a free list through pos[]. The number of handles never exceeds the
+ * number of elements ever stored at once, so all three arrays share the same
+ * capacity. */
+struct PHeap_ {
+	ppointer		*data;
+	PHeapHandle		*ids;
+	psize			*pos;
+	psize			length;
+	psize			capacity;
+	psize			slots;
+	PHeapHandle		free_head;
+	psize			arity;
+	PCompareFunc		func;
+	PCompareDataFunc	data_func;
+	ppointer		cmp_data;
+};
+
+static pboolean pp_heap_grow (PHeap *heap, psize capacity);
+static pint pp_heap_compare (const PHeap *heap, pconstpointer a, pconstpointer b);
+static pboolean pp_heap_handle_is_valid (const PHeap *heap, PHeapHandle handle);
+static PHeapHandle pp_heap_handle_alloc (PHeap *heap, psize pos);
+static psize pp_heap_sift_up (PHeap *heap, psize pos);
+static void pp_heap_sift_down (PHeap *heap, psize pos);
+static ppointer pp_heap_remove_at (PHeap *heap, psize pos);
+static PHeap * pp_heap_new (PCompareFunc func, PCompareDataFunc data_func, ppointer data, psize arity);
+
+static pboolean
+pp_heap_grow (PHeap *heap, psize capacity)
+{
+	ppointer	*new_data;
+	PHeapHandle	*new_ids;
+	psize		*new_pos;
+	psize		new_capacity;
+
+	new_capacity = heap->capacity < P_HEAP_MIN_CAPACITY ? P_HEAP_MIN_CAPACITY : heap->capacity;
+
+	while (new_capacity < capacity) {
+		if (P_UNLIKELY (new_capacity > ((psize) -1) / sizeof (ppointer) / 2)) {
+			new_capacity = capacity;
+			break;
+		}
+
+		new_capacity <<= 1;
+	}
+
+	if (P_UNLIKELY (new_capacity > ((psize) -1) / sizeof (ppointer) ||
+			new_capacity > ((psize) -1) / sizeof (psize)))
+		return FALSE;
+
+	/* Capacity is updated only when all the arrays are grown, the ones grown
+	 * before a failure are just larger than needed */
+	if (P_UNLIKELY ((new_data = p_realloc (heap->data, new_capacity * sizeof (ppointer))) == NULL))
+		return FALSE;
+
+	heap->data = new_data;
+
+	if (P_UNLIKELY ((new_ids = p_realloc (heap->ids, new_capacity * sizeof (PHeapHandle))) == NULL))
+		return FALSE;
+
+	heap->ids = new_ids;
+
+	if (P_UNLIKELY ((new_pos = p_realloc (heap->pos, new_capacity * sizeof (psize))) == NULL))
+		return FALSE;
+
+	heap->pos      = new_pos;
+	heap->capacity = new_capacity;
+
+	return TRUE;
+}
+
+static pint
+pp_heap_compare (const PHeap *heap, pconstpointer a, pconstpointer b)
+{
+	return heap->func != NULL ? heap->func (a, b) : heap->data_func (a, b, heap->cmp_data);
+}
+
+static pboolean
+pp_heap_handle_is_valid (const PHeap *heap, PHeapHandle handle)
+{
+	/* A free handle stores the next free one in pos[], but no element refers
+	 * back to it through ids[] */
+	return handle < heap->slots &&
+	       heap->pos[handle] < heap->length &&
+	       heap->ids[heap->pos[handle]] == handle;
+}
+
+static PHeapHandle
+pp_heap_handle_alloc (PHeap *heap, psize pos)
+{
+	PHeapHandle handle;
+
+	if (heap->free_head != P_HEAP_INVALID_HANDLE) {
+		handle          = heap->free_head;
+		heap->free_head = heap->pos[handle];
+	} else
+		handle = heap->slots++;
+
+	heap->pos[handle] = pos;
+	heap->ids[pos]    = handle;
+
+	return handle;
+}
+
+static psize
+pp_heap_sift_up (PHeap *heap, psize pos)
+{
+	ppointer	elem;
+	PHeapHandle	handle;
+	psize		parent;
+
+	elem   = heap->data[pos];
+	handle = heap->ids[pos];
+
+	while (pos > 0) {
+		parent = (pos - 1) / heap->arity;
+
+		if (pp_heap_compare (heap, elem, heap->data[parent]) >= 0)
+			break;
+
+		heap->data[pos]           = heap->data[parent];
+		heap->ids[pos]            = heap->ids[parent];
+		heap->pos[heap->ids[pos]] = pos;
+
+		pos = parent;
+	}
+
+	heap->data[pos]   = elem;
+	heap->ids[pos]    = handle;
+	heap->pos[handle] = pos;
+
+	return pos;
+}
+
+static void
+pp_heap_sift_down (PHeap *heap, psize pos)
+{
+	ppointer	elem;
+	PHeapHandle	handle;
+	psize		child;
+	psize		best;
+	psize		count;
+	psize		i;
+
+	elem   = heap->data[pos];
+	handle = heap->ids[pos];
+
+	/* The first child d * pos + 1 exists only if pos <= (length - 2) / d,
+	 * checking it this way also avoids an overflow for huge arities */
+	while (heap->length > 1 && pos <= (heap->length - 2) / heap->arity) {
+		child = heap->arity * pos + 1;
+		count = heap->length - child;
+
+		if (count > heap->arity)
+			count = heap->arity;
+
+		best = child;
+
+		for (i = 1; i < count; ++i) {
+			if (pp_heap_compare (heap, heap->data[child + i], heap->data[best]) < 0)
+				best = child + i;
+		}
+
+		if (pp_heap_compare (heap, heap->data[best], elem) >= 0)
+			break;
+
+		heap->data[pos]           = heap->data[best];
+		heap->ids[pos]            = heap->ids[best];
+		heap->pos[heap->ids[pos]] = pos;
+
+		pos = best;
+	}
+
+	heap->data[pos]   = elem;
+	heap->ids[pos]    = handle;
+	heap->pos[handle] = pos;
+}
+
+static ppointer
+pp_heap_remove_at (PHeap *heap, psize pos)
+{
+	ppointer	ret;
+	PHeapHandle	handle;
+
+	ret    = heap->data[pos];
+	handle = heap->ids[pos];
+
+	heap->pos[handle] = heap->free_head;
+	heap->free_head   = handle;
+
+	if (pos != --heap->length) {
+		heap->data[pos]           = heap->data[heap->length];
+		heap->ids[pos]            = heap->ids[heap->length];
+		heap->pos[heap->ids[pos]] = pos;
+
+		if (pp_heap_sift_up (heap, pos) == pos)
+			pp_heap_sift_down (heap, pos);
+	}
+
+	return ret;
+}
+
+static PHeap *
+pp_heap_new (PCompareFunc	func,
+	     PCompareDataFunc	data_func,
+	     ppointer		data,
+	     psize		arity)
+{
+	PHeap *ret;
+
+	if (P_UNLIKELY (func == NULL && data_func == NULL))
+		return NULL;
+
+	if (arity == 0)
+		arity = P_HEAP_DEFAULT_ARITY;
+
+	if (P_UNLIKELY (arity < 2))
+		return NULL;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PHeap))) == NULL)) {
+		P_ERROR ("PHeap::pp_heap_new: failed to allocate memory");
+		return NULL;
+	}
+
+	ret->free_head = P_HEAP_INVALID_HANDLE;
+	ret->arity     = arity;
+	ret->func      = func;
+	ret->data_func = data_func;
+	ret->cmp_data  = data;
+
+	return ret;
+}
+
+P_LIB_API PHeap *
+p_heap_new (PCompareFunc func)
+{
+	return pp_heap_new (func, NULL, NULL, 0);
+}
+
+P_LIB_API PHeap *
+p_heap_new_full (PCompareDataFunc	func,
+		 ppointer		data,
+		 psize			arity)
+{
+	return pp_heap_new (NULL, func, data, arity);
+}
+
+P_LIB_API pboolean
+p_heap_reserve (PHeap	*heap,
+		psize	capacity)
+{
+	if (P_UNLIKELY (heap == NULL))
+		return FALSE;
+
+	if (capacity <= heap->capacity)
+		return TRUE;
+
+	if (P_UNLIKELY (pp_heap_grow (heap, capacity) == FALSE)) {
+		P_ERROR ("PHeap::p_heap_reserve: failed to allocate memory");
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_heap_push (PHeap		*heap,
+	     ppointer		data,
+	     PHeapHandle	*handle)
+{
+	PHeapHandle new_handle;
+
+	if (P_UNLIKELY (heap == NULL))
+		return FALSE;
+
+	if (heap->length == heap->capacity) {
+		if (P_UNLIKELY (pp_heap_grow (heap, heap->length + 1) == FALSE)) {
+			P_ERROR ("PHeap::p_heap_push: failed to allocate memory");
+			return FALSE;
+		}
+	}
+
+	heap->data[heap->length] = data;
+	new_handle = pp_heap_handle_alloc (heap, heap->length);
+
+	pp_heap_sift_up (heap, heap->length++);
+
+	if (handle != NULL)
+		*handle = new_handle;
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_heap_push_bulk (PHeap		*heap,
+		  ppointer	*data,
+		  psize		count,
+		  PHeapHandle	*handles)
+{
+	psize	old_length;
+	psize	i;
+
+	if (P_UNLIKELY (heap == NULL || (data == NULL && count > 0)))
+		return FALSE;
+
+	if (count == 0)
+		return TRUE;
+
+	if (P_UNLIKELY (count > ((psize) -1) - heap->length))
+		return FALSE;
+
+	if (heap->length + count > heap->capacity) {
+		if (P_UNLIKELY (pp_heap_grow (heap, heap->length + count) == FALSE)) {
+			P_ERROR ("PHeap::p_heap_push_bulk: failed to allocate memory");
+			return FALSE;
+		}
+	}
+
+	old_length = heap->length;
+
+	for (i = 0; i < count; ++i) {
+		heap->data[old_length + i] = data[i];
+
+		if (handles != NULL)
+			handles[i] = pp_heap_handle_alloc (heap, old_length + i);
+		else
+			pp_heap_handle_alloc (heap, old_length + i);
+	}
+
+	heap->length += count;
+
+	if (count > old_length) {
+		/* Floyd's bottom-up construction, O(N) for the whole heap */
+		if (heap->length > 1) {
+			i = (heap->length - 2) / heap->arity + 1;
+
+			while (i-- > 0)
+				pp_heap_sift_down (heap, i);
+		}
+	} else {
+		for (i = old_length; i < heap->length; ++i)
+			pp_heap_sift_up (heap, i);
+	}
+
+	return TRUE;
+}
+
+P_LIB_API ppointer
+p_heap_peek (const PHeap *heap)
+{
+	if (P_UNLIKELY (heap == NULL || heap->length == 0))
+		return NULL;
+
+	return heap->data[0];
+}
+
+P_LIB_API ppointer
+p_heap_pop (PHeap *heap)
+{
+	if (P_UNLIKELY (heap == NULL || heap->length == 0))
+		return NULL;
+
+	return pp_heap_remove_at (heap, 0);
+}
+
+P_LIB_API pboolean
+p_heap_update (PHeap		*heap,
+	       PHeapHandle	handle)
+{
+	psize pos;
+
+	if (P_UNLIKELY (heap == NULL || !pp_heap_handle_is_valid (heap, handle)))
+		return FALSE;
+
+	pos = heap->pos[handle];
+
+	if (pp_heap_sift_up (heap, pos) == pos)
+		pp_heap_sift_down (heap, pos);
+
+	return TRUE;
+}
+
+P_LIB_API ppointer
+p_heap_remove (PHeap		*heap,
+	       PHeapHandle	handle)
+{
+	if (P_UNLIKELY (heap == NULL || !pp_heap_handle_is_valid (heap, handle)))
+		return NULL;
+
+	return pp_heap_remove_at (heap, heap->pos[handle]);
+}
+
+P_LIB_API ppointer
+p_heap_get (const PHeap	*heap,
+	    PHeapHandle	handle)
+{
+	if (P_UNLIKELY (heap == NULL || !pp_heap_handle_is_valid (heap, handle)))
+		return NULL;
+
+	return heap->data[heap->pos[handle]];
+}
+
+P_LIB_API psize
+p_heap_length (const PHeap *heap)
+{
+	if (P_UNLIKELY (heap == NULL))
+		return 0;
+
+	return heap->length;
+}
+
+P_LIB_API void
+p_heap_clear (PHeap *heap)
+{
+	if (P_UNLIKELY (heap == NULL))
+		return;
+
+	heap->length    = 0;
+	heap->slots     = 0;
+	heap->free_head = P_HEAP_INVALID_HANDLE;
+}
+
+P_LIB_API void
+p_heap_free (PHeap *heap)
+{
+	if (P_UNLIKELY (heap == NULL))
+		return;
+
+	p_free (heap->data);
+	p_free (heap->ids);
+	p_free (heap->pos);
+	p_free (heap);
+}
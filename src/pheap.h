@@ -0,0 +1,234 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pheap.h
+ * @brief Priority queue
+ * @author Alexander Saprykin
+ *
+ * #PHeap is a priority queue implemented as an implicit d-ary heap: the
+ * elements are stored in a single contiguous array without per-element nodes.
+ * The smallest element (according to the compare function) is always on the
+ * top and is available with p_heap_peek() in O(1) time, p_heap_push() and
+ * p_heap_pop() take O(logN) time.
+ *
+ * Use p_heap_new() to create a binary heap, or p_heap_new_full() to select
+ * the arity and pass additional data into the compare function. Heaps with
+ * four or eight children per node are shallower and touch less cache lines on
+ * pop, which often makes them faster for large queues.
+ *
+ * Every pushed element gets a #PHeapHandle which remains valid until the
+ * element leaves the heap. If the key of an element changes (i.e. a timer is
+ * rescheduled), call p_heap_update() with its handle to restore the heap order
+ * in O(logN) time, or take the element out of the middle of the queue with
+ * p_heap_remove(). Handles of the removed elements are reused for the new
+ * ones.
+ *
+ * Many elements can be added at once with p_heap_push_bulk(), which rebuilds
+ * the heap in O(N) time when it is faster than pushing them one by one.
+ *
+ * #PHeap stores only the pointers to the data, so you must free used memory
+ * manually, p_heap_free() only frees heap's internal memory. The heap is not
+ * thread-safe.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PHEAP_H
+#define PLIBSYS_HEADER_PHEAP_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+
+P_BEGIN_DECLS
+
+/** Heap opaque data structure. */
+typedef struct PHeap_ PHeap;
+
+/** Handle of an element in a heap. */
+typedef psize PHeapHandle;
+
+/** Invalid heap element handle. */
+#define P_HEAP_INVALID_HANDLE ((PHeapHandle) -1)
+
+/**
+ * @brief Initializes a new binary heap.
+ * @param func Function to compare two elements.
+ * @return Pointer to a newly initialized #PHeap structure in case of success,
+ * NULL otherwise.
+ * @since 0.0.5
+ * @note Free with p_heap_free() after usage.
+ *
+ * The @a func receives the element data, it should return a negative value if
+ * the first element is less than the second one, a positive value if it is
+ * greater, and zero if they are equal. The least element is on the top.
+ */
+P_LIB_API PHeap *	p_heap_new		(PCompareFunc		func);
+
+/**
+ * @brief Initializes a new d-ary heap.
+ * @param func Function to compare two elements.
+ * @param data Data to pass into @a func, may be NULL.
+ * @param arity Number of children per node, 0 for a binary heap.
+ * @return Pointer to a newly initialized #PHeap structure in case of success,
+ * NULL otherwise.
+ * @since 0.0.5
+ * @note Free with p_heap_free() after usage.
+ *
+ * Same as p_heap_new(), but @a data is passed into every @a func call.
+ */
+P_LIB_API PHeap *	p_heap_new_full		(PCompareDataFunc	func,
+						 ppointer		data,
+						 psize			arity);
+
+/**
+ * @brief Makes room for a number of elements in a heap.
+ * @param heap Initialized heap.
+ * @param capacity Total number of elements the heap should hold without
+ * growing.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_heap_reserve		(PHeap			*heap,
+						 psize			capacity);
+
+/**
+ * @brief Inserts an element into a heap.
+ * @param heap Initialized heap.
+ * @param data Element data.
+ * @param[out] handle Pointer to store the element handle into, may be NULL.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * This call takes O(logN) time. The heap is left untouched if it fails to
+ * grow.
+ */
+P_LIB_API pboolean	p_heap_push		(PHeap			*heap,
+						 ppointer		data,
+						 PHeapHandle		*handle);
+
+/**
+ * @brief Inserts several elements into a heap at once.
+ * @param heap Initialized heap.
+ * @param data Array of the element data.
+ * @param count Number of the elements in @a data.
+ * @param[out] handles Array to store the element handles into, must have at
+ * least @a count elements, may be NULL.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * If the number of the new elements is comparable with the heap size, the
+ * whole heap is rebuilt in O(N) time instead of pushing every element. Either
+ * all the elements are inserted or none of them.
+ */
+P_LIB_API pboolean	p_heap_push_bulk	(PHeap			*heap,
+						 ppointer		*data,
+						 psize			count,
+						 PHeapHandle		*handles);
+
+/**
+ * @brief Gets the least heap element without removing it.
+ * @param heap Initialized heap.
+ * @return Data of the least element, NULL if the heap is empty.
+ * @since 0.0.5
+ */
+P_LIB_API ppointer	p_heap_peek		(const PHeap		*heap);
+
+/**
+ * @brief Removes the least heap element.
+ * @param heap Initialized heap.
+ * @return Data of the removed element, NULL if the heap is empty.
+ * @since 0.0.5
+ *
+ * This call takes O(logN) time.
+ */
+P_LIB_API ppointer	p_heap_pop		(PHeap			*heap);
+
+/**
+ * @brief Restores the heap order after the key of an element has changed.
+ * @param heap Initialized heap.
+ * @param handle Handle of the changed element.
+ * @return TRUE in case of success, FALSE if @a handle is not valid.
+ * @since 0.0.5
+ *
+ * The key may be either decreased or increased. This call takes O(logN) time.
+ */
+P_LIB_API pboolean	p_heap_update		(PHeap			*heap,
+						 PHeapHandle		handle);
+
+/**
+ * @brief Removes an arbitrary element from a heap.
+ * @param heap Initialized heap.
+ * @param handle Handle of the element to remove.
+ * @return Data of the removed element, NULL if @a handle is not valid.
+ * @since 0.0.5
+ *
+ * This call takes O(logN) time. The @a handle becomes invalid after the call.
+ */
+P_LIB_API ppointer	p_heap_remove		(PHeap			*heap,
+						 PHeapHandle		handle);
+
+/**
+ * @brief Gets heap element data by its handle.
+ * @param heap Initialized heap.
+ * @param handle Handle of the element.
+ * @return Data of the element, NULL if @a handle is not valid.
+ * @since 0.0.5
+ */
+P_LIB_API ppointer	p_heap_get		(const PHeap		*heap,
+						 PHeapHandle		handle);
+
+/**
+ * @brief Gets the number of heap elements.
+ * @param heap Initialized heap.
+ * @return Number of elements in the @a heap.
+ * @since 0.0.5
+ */
+P_LIB_API psize		p_heap_length		(const PHeap		*heap);
+
+/**
+ * @brief Removes all the elements from a heap.
+ * @param heap Heap to clear.
+ * @since 0.0.5
+ *
+ * All the handles become invalid, the memory is kept for reuse.
+ */
+P_LIB_API void		p_heap_clear		(PHeap			*heap);
+
+/**
+ * @brief Frees heap memory.
+ * @param heap Heap to free.
+ * @since 0.0.5
+ *
+ * This function frees only the heap's internal memory, not the data stored in
+ * the elements.
+ */
+P_LIB_API void		p_heap_free		(PHeap			*heap);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PHEAP_H */
@@ -0,0 +1,463 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* The layout follows HdrHistogram with the unit of 1. The sub-bucket count
+ * is the smallest power of two giving the requested precision, bucket 0
+ * covers the values [0, sub_bucket_count) with a step of 1, every next bucket
+ * covers twice the range with twice the step. Only the upper halves of the
+ * buckets after the first one are stored, their lower halves are the same
+ * values as the upper half of the previous bucket. */
+
+#include "patomic.h"
+#include "pmem.h"
+#include "phistogram.h"
+
+#define P_HISTOGRAM_MAX_VALUE	((puint64) (P_MAXINT64 / 2))
+
+struct PHistogram_ {
+	volatile pint64	*counts;
+	pint		counts_len;
+	pint		sub_bucket_count;
+	pint		sub_bucket_half_count;
+	pint		sub_bucket_half_count_magnitude;
+	puint64		sub_bucket_mask;
+	puint64		max_value;
+	pboolean	concurrent;
+	volatile pint64	min;
+	volatile pint64	max;
+};
+
+static puint pp_histogram_clz (puint64 val);
+static pint pp_histogram_get_index (const PHistogram *histogram, puint64 value);
+static pint pp_histogram_get_bucket_index (const PHistogram *histogram, pint index, pint *sub_bucket_index);
+static puint64 pp_histogram_lowest_value (const PHistogram *histogram, pint index);
+static puint64 pp_histogram_range_size (const PHistogram *histogram, pint index);
+static puint64 pp_histogram_get_count_at (const PHistogram *histogram, pint index);
+static void pp_histogram_add (PHistogram *histogram, puint64 value, puint64 count);
+static void pp_histogram_update_min (PHistogram *histogram, puint64 value);
+static void pp_histogram_update_max (PHistogram *histogram, puint64 value);
+
+static puint
+pp_histogram_clz (puint64 val)
+{
+#if defined (P_CC_GNU) || defined (P_CC_CLANG)
+	return (puint) __builtin_clzll (val);
+#elif defined (P_CC_MSVC) && defined (P_CPU_X86_64)
+	unsigned long idx;
+
+	_BitScanReverse64 (&idx, val);
+
+	return (puint) (63 - idx);
+#else
+	puint ret;
+
+	for (ret = 0; (val & ((puint64) 0x8000000000000000ULL)) == 0; val <<= 1)
+		++ret;
+
+	return ret;
+#endif
+}
+
+static pint
+pp_histogram_get_index (const PHistogram	*histogram,
+			puint64			value)
+{
+	pint bucket_index;
+	pint sub_bucket_index;
+
+	/* The mask keeps the small values in bucket 0 and clz defined */
+	bucket_index     = 64 - (pint) pp_histogram_clz (value | histogram->sub_bucket_mask) -
+			   (histogram->sub_bucket_half_count_magnitude + 1);
+	sub_bucket_index = (pint) (value >> bucket_index);
+
+	return ((bucket_index + 1) << histogram->sub_bucket_half_count_magnitude) +
+	       (sub_bucket_index - histogram->sub_bucket_half_count);
+}
+
+static pint
+pp_histogram_get_bucket_index (const PHistogram	*histogram,
+			       pint			index,
+			       pint			*sub_bucket_index)
+{
+	pint bucket_index;
+
+	bucket_index      = (index >> histogram->sub_bucket_half_count_magnitude) - 1;
+	*sub_bucket_index = (index & (histogram->sub_bucket_half_count - 1)) + histogram->sub_bucket_half_count;
+
+	if (bucket_index < 0) {
+		*sub_bucket_index -= histogram->sub_bucket_half_count;
+		bucket_index       = 0;
+	}
+
+	return bucket_index;
+}
+
+static puint64
+pp_histogram_lowest_value (const PHistogram	*histogram,
+			   pint			index)
+{
+	pint bucket_index;
+	pint sub_bucket_index;
+
+	bucket_index = pp_histogram_get_bucket_index (histogram, index, &sub_bucket_index);
+
+	return ((puint64) sub_bucket_index) << bucket_index;
+}
+
+static puint64
+pp_histogram_range_size (const PHistogram	*histogram,
+			 pint			index)
+{
+	pint sub_bucket_index;
+
+	return ((puint64) 1) << pp_histogram_get_bucket_index (histogram, index, &sub_bucket_index);
+}
+
+static puint64
+pp_histogram_get_count_at (const PHistogram	*histogram,
+			   pint			index)
+{
+	return (puint64) p_atomic_int64_get_explicit (&histogram->counts[index], P_ATOMIC_MEMORY_ORDER_RELAXED);
+}
+
+static void
+pp_histogram_add (PHistogram	*histogram,
+		  puint64	value,
+		  puint64	count)
+{
+	pint index;
+
+	if (P_UNLIKELY (value > histogram->max_value))
+		value = histogram->max_value;
+
+	index = pp_histogram_get_index (histogram, value);
+
+	if (histogram->concurrent == TRUE)
+		p_atomic_int64_add_explicit (&histogram->counts[index], (pint64) count, P_ATOMIC_MEMORY_ORDER_RELAXED);
+	else
+		histogram->counts[index] += (pint64) count;
+}
+
+static void
+pp_histogram_update_min (PHistogram	*histogram,
+			 puint64	value)
+{
+	pint64 current;
+
+	do {
+		current = p_atomic_int64_get_explicit (&histogram->min, P_ATOMIC_MEMORY_ORDER_RELAXED);
+
+		if ((pint64) value >= current)
+			return;
+
+		if (histogram->concurrent == FALSE) {
+			histogram->min = (pint64) value;
+			return;
+		}
+	} while (p_atomic_int64_compare_and_exchange (&histogram->min, current, (pint64) value) == FALSE);
+}
+
+static void
+pp_histogram_update_max (PHistogram	*histogram,
+			 puint64	value)
+{
+	pint64 current;
+
+	do {
+		current = p_atomic_int64_get_explicit (&histogram->max, P_ATOMIC_MEMORY_ORDER_RELAXED);
+
+		if ((pint64) value <= current)
+			return;
+
+		if (histogram->concurrent == FALSE) {
+			histogram->max = (pint64) value;
+			return;
+		}
+	} while (p_atomic_int64_compare_and_exchange (&histogram->max, current, (pint64) value) == FALSE);
+}
+
+P_LIB_API PHistogram *
+p_histogram_new (puint64	max_value,
+		 pint		significant_digits,
+		 pboolean	concurrent)
+{
+	PHistogram	*ret;
+	puint64		largest;
+	puint64		range;
+	pint		sub_bucket_count;
+	pint		magnitude;
+	pint		bucket_count;
+	pint		i;
+
+	if (P_UNLIKELY (max_value < 2 || significant_digits < 1 || significant_digits > 5))
+		return NULL;
+
+	if (max_value > P_HISTOGRAM_MAX_VALUE)
+		max_value = P_HISTOGRAM_MAX_VALUE;
+
+	/* Two values per unit of the last digit give the precision */
+	for (largest = 2, i = 0; i < significant_digits; ++i)
+		largest *= 10;
+
+	for (magnitude = 0, sub_bucket_count = 1; (puint64) sub_bucket_count < largest; ++magnitude)
+		sub_bucket_count <<= 1;
+
+	/* Each bucket doubles the covered range */
+	for (bucket_count = 1, range = (puint64) sub_bucket_count; range <= max_value; ++bucket_count)
+		range <<= 1;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PHistogram))) == NULL)) {
+		P_ERROR ("PHistogram::p_histogram_new: failed to allocate memory");
+		return NULL;
+	}
+
+	ret->sub_bucket_count                = sub_bucket_count;
+	ret->sub_bucket_half_count           = sub_bucket_count / 2;
+	ret->sub_bucket_half_count_magnitude = magnitude - 1;
+	ret->sub_bucket_mask                 = (puint64) sub_bucket_count - 1;
+	ret->counts_len                      = (bucket_count + 1) * ret->sub_bucket_half_count;
+	ret->max_value                       = max_value;
+	ret->concurrent                      = concurrent;
+	ret->min                             = P_MAXINT64;
+	ret->max                             = 0;
+
+	if (P_UNLIKELY ((ret->counts = p_malloc0 (sizeof (pint64) * (psize) ret->counts_len)) == NULL)) {
+		P_ERROR ("PHistogram::p_histogram_new: failed to allocate memory for buckets");
+		p_free (ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+P_LIB_API void
+p_histogram_record (PHistogram	*histogram,
+		    puint64	value)
+{
+	p_histogram_record_count (histogram, value, 1);
+}
+
+P_LIB_API void
+p_histogram_record_count (PHistogram	*histogram,
+			  puint64	value,
+			  puint64	count)
+{
+	if (P_UNLIKELY (histogram == NULL || count == 0))
+		return;
+
+	if (P_UNLIKELY (value > histogram->max_value))
+		value = histogram->max_value;
+
+	pp_histogram_add (histogram, value, count);
+	pp_histogram_update_min (histogram, value);
+	pp_histogram_update_max (histogram, value);
+}
+
+P_LIB_API pboolean
+p_histogram_merge (PHistogram		*dst,
+		   const PHistogram	*src)
+{
+	puint64	count;
+	puint64	value;
+	pint64	src_min;
+	pint64	src_max;
+	pint	i;
+
+	if (P_UNLIKELY (dst == NULL || src == NULL || dst == src))
+		return FALSE;
+
+	src_min = p_atomic_int64_get_explicit (&src->min, P_ATOMIC_MEMORY_ORDER_RELAXED);
+	src_max = p_atomic_int64_get_explicit (&src->max, P_ATOMIC_MEMORY_ORDER_RELAXED);
+
+	for (i = 0; i < src->counts_len; ++i) {
+		if ((count = pp_histogram_get_count_at (src, i)) == 0)
+			continue;
+
+		/* The same layout lets the counts be added bucket by bucket */
+		if (src->sub_bucket_count == dst->sub_bucket_count && i < dst->counts_len) {
+			if (dst->concurrent == TRUE)
+				p_atomic_int64_add_explicit (&dst->counts[i], (pint64) count, P_ATOMIC_MEMORY_ORDER_RELAXED);
+			else
+				dst->counts[i] += (pint64) count;
+
+			continue;
+		}
+
+		value = pp_histogram_lowest_value (src, i) + (pp_histogram_range_size (src, i) >> 1);
+
+		/* Keep the median inside the really recorded range */
+		if (value > (puint64) src_max)
+			value = (puint64) src_max;
+
+		if (value < (puint64) src_min)
+			value = (puint64) src_min;
+
+		pp_histogram_add (dst, value, count);
+	}
+
+	if (src_min <= src_max) {
+		pp_histogram_update_min (dst, (puint64) src_min > dst->max_value ? dst->max_value : (puint64) src_min);
+		pp_histogram_update_max (dst, (puint64) src_max > dst->max_value ? dst->max_value : (puint64) src_max);
+	}
+
+	return TRUE;
+}
+
+P_LIB_API puint64
+p_histogram_get_percentile (const PHistogram	*histogram,
+			    double		percentile)
+{
+	puint64	total;
+	puint64	target;
+	puint64	cumulative;
+	puint64	value;
+	pint64	min;
+	pint64	max;
+	double	exact;
+	pint	i;
+
+	if (P_UNLIKELY (histogram == NULL))
+		return 0;
+
+	if ((total = p_histogram_get_count (histogram)) == 0)
+		return 0;
+
+	min = p_atomic_int64_get_explicit (&histogram->min, P_ATOMIC_MEMORY_ORDER_RELAXED);
+	max = p_atomic_int64_get_explicit (&histogram->max, P_ATOMIC_MEMORY_ORDER_RELAXED);
+
+	if (percentile <= 0.0)
+		return min <= max ? (puint64) min : 0;
+
+	if (percentile > 100.0)
+		percentile = 100.0;
+
+	exact  = percentile / 100.0 * (double) total;
+	target = (puint64) exact;
+
+	if ((double) target < exact || target == 0)
+		++target;
+
+	if (target > total)
+		target = total;
+
+	for (cumulative = 0, i = 0; i < histogram->counts_len; ++i) {
+		cumulative += pp_histogram_get_count_at (histogram, i);
+
+		if (cumulative >= target)
+			break;
+	}
+
+	if (P_UNLIKELY (i == histogram->counts_len))
+		return (puint64) max;
+
+	value = pp_histogram_lowest_value (histogram, i) + pp_histogram_range_size (histogram, i) - 1;
+
+	return value > (puint64) max ? (puint64) max : value;
+}
+
+P_LIB_API puint64
+p_histogram_get_count (const PHistogram *histogram)
+{
+	puint64	ret;
+	pint	i;
+
+	if (P_UNLIKELY (histogram == NULL))
+		return 0;
+
+	for (ret = 0, i = 0; i < histogram->counts_len; ++i)
+		ret += pp_histogram_get_count_at (histogram, i);
+
+	return ret;
+}
+
+P_LIB_API puint64
+p_histogram_get_min (const PHistogram *histogram)
+{
+	pint64 min;
+
+	if (P_UNLIKELY (histogram == NULL))
+		return 0;
+
+	min = p_atomic_int64_get_explicit (&histogram->min, P_ATOMIC_MEMORY_ORDER_RELAXED);
+
+	return min == P_MAXINT64 ? 0 : (puint64) min;
+}
+
+P_LIB_API puint64
+p_histogram_get_max (const PHistogram *histogram)
+{
+	if (P_UNLIKELY (histogram == NULL))
+		return 0;
+
+	return (puint64) p_atomic_int64_get_explicit (&histogram->max, P_ATOMIC_MEMORY_ORDER_RELAXED);
+}
+
+P_LIB_API double
+p_histogram_get_mean (const PHistogram *histogram)
+{
+	double	total;
+	double	sum;
+	puint64	count;
+	pint	i;
+
+	if (P_UNLIKELY (histogram == NULL))
+		return 0.0;
+
+	for (total = 0.0, sum = 0.0, i = 0; i < histogram->counts_len; ++i) {
+		if ((count = pp_histogram_get_count_at (histogram, i)) == 0)
+			continue;
+
+		total += (double) count;
+		sum   += (double) count * (double) (pp_histogram_lowest_value (histogram, i) +
+						    (pp_histogram_range_size (histogram, i) >> 1));
+	}
+
+	return total > 0.0 ? sum / total : 0.0;
+}
+
+P_LIB_API void
+p_histogram_reset (PHistogram *histogram)
+{
+	pint i;
+
+	if (P_UNLIKELY (histogram == NULL))
+		return;
+
+	for (i = 0; i < histogram->counts_len; ++i)
+		p_atomic_int64_set_explicit (&histogram->counts[i], 0, P_ATOMIC_MEMORY_ORDER_RELAXED);
+
+	p_atomic_int64_set (&histogram->min, P_MAXINT64);
+	p_atomic_int64_set (&histogram->max, 0);
+}
+
+P_LIB_API void
+p_histogram_free (PHistogram *histogram)
+{
+	if (P_UNLIKELY (histogram == NULL))
+		return;
+
+	p_free ((ppointer) histogram->counts);
+	p_free (histogram);
+}
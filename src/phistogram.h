@@ -0,0 +1,200 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file phistogram.h
+ * @brief Latency histogram
+ * @author Alexander Saprykin
+ *
+ * A histogram counts the recorded values in buckets instead of keeping the
+ * values themselves, so it takes a fixed amount of memory and a fixed time to
+ * record a value however many values are recorded. It is designed for the
+ * latencies measured with #PTimeProfiler in nanoseconds, but fits any
+ * non-negative integer values.
+ *
+ * The buckets are log-linear like in HdrHistogram: every power of two range
+ * of the values is split into the same number of linear sub-buckets. This
+ * keeps the relative error of any value within the given number of
+ * significant decimal digits, i.e. with 3 digits both 1000 and 1000000
+ * nanoseconds are recorded with an error of at most 0.1%. The values from 0
+ * up to the given maximum can be recorded, larger values are counted as the
+ * maximum.
+ *
+ * A histogram created as concurrent can be updated by many threads at once,
+ * every recording is then a single relaxed atomic increment (plus a rare
+ * update of the minimum or the maximum). A histogram updated by a single
+ * thread can skip the atomic operations, i.e. every thread records into its
+ * own histogram and the histograms are combined with p_histogram_merge() for
+ * the report:
+ * @code
+ * PTimeProfiler profiler;
+ *
+ * p_time_profiler_reset (&profiler);
+ * process_request (request);
+ * p_histogram_record (histogram, p_time_profiler_elapsed_nsecs (&profiler));
+ * ...
+ * p99 = p_histogram_get_percentile (histogram, 99.0);
+ * @endcode
+ *
+ * The queries can be run while the values are recorded by the other threads,
+ * they see a snapshot which may miss some of the concurrent updates.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PHISTOGRAM_H
+#define PLIBSYS_HEADER_PHISTOGRAM_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+
+P_BEGIN_DECLS
+
+/** Histogram opaque data type. */
+typedef struct PHistogram_ PHistogram;
+
+/**
+ * @brief Creates a new empty histogram.
+ * @param max_value Maximum value to record, at least 2. Larger values are
+ * counted as @a max_value.
+ * @param significant_digits Number of significant decimal digits to keep, from
+ * 1 to 5.
+ * @param concurrent Whether the histogram can be updated by several threads
+ * at once.
+ * @return Pointer to #PHistogram in case of success, NULL otherwise.
+ * @since 0.0.5
+ *
+ * The memory taken grows with the number of digits and logarithmically with
+ * @a max_value: a histogram tracking up to an hour in nanoseconds with 3
+ * digits takes about 300 kilobytes.
+ */
+P_LIB_API PHistogram *	p_histogram_new			(puint64		max_value,
+							 pint			significant_digits,
+							 pboolean		concurrent);
+
+/**
+ * @brief Records a value in a histogram.
+ * @param histogram #PHistogram to record the value in.
+ * @param value Value to record.
+ * @since 0.0.5
+ */
+P_LIB_API void		p_histogram_record		(PHistogram		*histogram,
+							 puint64		value);
+
+/**
+ * @brief Records a value several times in a histogram.
+ * @param histogram #PHistogram to record the value in.
+ * @param value Value to record.
+ * @param count Number of times to record @a value.
+ * @since 0.0.5
+ */
+P_LIB_API void		p_histogram_record_count	(PHistogram		*histogram,
+							 puint64		value,
+							 puint64		count);
+
+/**
+ * @brief Adds all the values of one histogram to another.
+ * @param dst #PHistogram to add the values to.
+ * @param src #PHistogram to take the values from, it is not changed.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The histograms may have different maximums and precisions, then the values
+ * of @a src are added with the precision of @a src at most. @a src must not be
+ * updated during the call unless it is concurrent.
+ */
+P_LIB_API pboolean	p_histogram_merge		(PHistogram		*dst,
+							 const PHistogram	*src);
+
+/**
+ * @brief Gets the value at a given percentile of a histogram.
+ * @param histogram #PHistogram to get the value for.
+ * @param percentile Percentile, from 0.0 to 100.0.
+ * @return Value not less than @a percentile percent of the recorded values, 0
+ * if the histogram is empty.
+ * @since 0.0.5
+ *
+ * The value is the largest one counted in the same bucket, limited by the
+ * maximum recorded value, so it is rounded up within the precision. 0.0 gives
+ * the minimum and 100.0 gives the maximum recorded values.
+ */
+P_LIB_API puint64	p_histogram_get_percentile	(const PHistogram	*histogram,
+							 double			percentile);
+
+/**
+ * @brief Gets the number of values recorded in a histogram.
+ * @param histogram #PHistogram to get the number for.
+ * @return Number of the recorded values.
+ * @since 0.0.5
+ */
+P_LIB_API puint64	p_histogram_get_count		(const PHistogram	*histogram);
+
+/**
+ * @brief Gets the minimum value recorded in a histogram.
+ * @param histogram #PHistogram to get the value for.
+ * @return Minimum recorded value, 0 if the histogram is empty.
+ * @since 0.0.5
+ */
+P_LIB_API puint64	p_histogram_get_min		(const PHistogram	*histogram);
+
+/**
+ * @brief Gets the maximum value recorded in a histogram.
+ * @param histogram #PHistogram to get the value for.
+ * @return Maximum recorded value, 0 if the histogram is empty.
+ * @since 0.0.5
+ */
+P_LIB_API puint64	p_histogram_get_max		(const PHistogram	*histogram);
+
+/**
+ * @brief Gets the mean of the values recorded in a histogram.
+ * @param histogram #PHistogram to get the mean for.
+ * @return Mean of the recorded values within the precision, 0.0 if the
+ * histogram is empty.
+ * @since 0.0.5
+ */
+P_LIB_API double	p_histogram_get_mean		(const PHistogram	*histogram);
+
+/**
+ * @brief Removes all the values from a histogram.
+ * @param histogram #PHistogram to reset.
+ * @since 0.0.5
+ *
+ * The values recorded concurrently with the call may stay in the histogram
+ * partially, i.e. be counted in a bucket but not in the maximum.
+ */
+P_LIB_API void		p_histogram_reset		(PHistogram		*histogram);
+
+/**
+ * @brief Frees a histogram.
+ * @param histogram #PHistogram to free.
+ * @since 0.0.5
+ */
+P_LIB_API void		p_histogram_free		(PHistogram		*histogram);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PHISTOGRAM_H */
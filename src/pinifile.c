@@ -26,6 +26,10 @@
 #include "perror.h"
 #include "pinifile.h"
 #include "plist.h"
+#include "parray.h"
+#include "patomic.h"
+#include "pfasthash.h"
+#include "phashtable.h"
 #include "pmem.h"
 #include "pstring.h"
 #include "perror-private.h"
@@ -34,107 +38,749 @@
 #include <stdio.h>
 #include <string.h>
 #include <ctype.h>
+#include <time.h>
 
-#define	P_INI_FILE_MAX_LINE	1024
+#if defined (P_OS_UNIX) || defined (P_OS_WIN)
+#  include <sys/types.h>
+#  include <sys/stat.h>
+#  define P_INI_FILE_HAS_STAT
+#endif
 
+#define	P_INI_FILE_READ_CHUNK	65536
+#define	P_INI_FILE_MIN_ITEMS	16
+
+/* Shifts of the typed value cache bits: the lower bit is taken by a thread
+ * which converts the value first, the upper one is set after it's stored */
+#define	P_INI_FILE_CACHE_INT		0
+#define	P_INI_FILE_CACHE_DOUBLE		2
+#define	P_INI_FILE_CACHE_BOOLEAN	4
+
+/* Names and values are views into the file buffer, they are terminated with
+ * a zero character in place during parsing */
 typedef struct PIniParameter_ {
-	pchar		*name;
-	pchar		*value;
+	psize		name;
+	psize		name_len;
+	psize		value;
+	psize		value_len;
+	volatile puint	cached;
+	pint		int_val;
+	pboolean	bool_val;
+	double		double_val;
 } PIniParameter;
 
 typedef struct PIniSection_ {
-	pchar		*name;
-	PList		*keys;
+	psize		name;
+	psize		name_len;
+	psize		first_param;
+	psize		params_count;
+	PHashTable	*keys;
 } PIniSection;
 
 struct PIniFile_ {
 	pchar		*path;
-	PList		*sections;
+	pchar		*data;
+	psize		data_len;
+	puint64		data_hash;
+	pint64		mtime;
+	pint64		size;
+	pint64		load_time;
+	pboolean	has_stat;
+	PHashTable	*index;
+	PIniSection	*sections;
+	psize		sections_count;
+	psize		sections_size;
+	PIniParameter	*params;
+	psize		params_count;
+	psize		params_size;
+	pboolean	case_sensitive;
 	pboolean	is_parsed;
 };
 
-static PIniParameter * pp_ini_file_parameter_new (const pchar *name, const pchar *val);
-static void pp_ini_file_parameter_free (PIniParameter *param);
-static PIniSection * pp_ini_file_section_new (const pchar *name);
-static void pp_ini_file_section_free (PIniSection *section);
-static pchar * pp_ini_file_find_parameter (const PIniFile *file, const pchar *section, const pchar *key);
+static pboolean pp_ini_file_stat (const pchar *path, pint64 *mtime, pint64 *size);
+static pchar * pp_ini_file_read (const pchar *path, psize *len, PError **error);
+static pboolean pp_ini_file_read_content (PIniFile *file, PError **error);
+static pboolean pp_ini_file_process (PIniFile *file, PError **error);
+static ppointer pp_ini_file_grow (ppointer items, psize *size, psize count, psize item_size);
+static pboolean pp_ini_file_tokenize (PIniFile *file, psize len);
+static puint pp_ini_file_nocase_hash (pconstpointer key);
+static pboolean pp_ini_file_nocase_equal (pconstpointer a, pconstpointer b);
+static PHashTable * pp_ini_file_index_new (const PIniFile *file, psize count);
+static pboolean pp_ini_file_build_index (PIniFile *file);
+static void pp_ini_file_clear (PIniFile *file);
+static ppointer pp_ini_file_lookup (const PHashTable *table, const pchar *name);
+static pboolean pp_ini_file_change_add (PListHead *head, PIniFileChangeType type, const pchar *section, const pchar *key);
+static pboolean pp_ini_file_diff (const PIniFile *old_file, const PIniFile *new_file, PListHead *head);
+static pchar * pp_ini_file_strndup (const pchar *str, psize len);
+static const PIniSection * pp_ini_file_find_section (const PIniFile *file, const pchar *section);
+static PIniParameter * pp_ini_file_find_parameter (const PIniFile *file, const pchar *section, const pchar *key);
+static pboolean pp_ini_file_cache_is_ready (const PIniParameter *param, puint type);
+static pboolean pp_ini_file_cache_claim (PIniParameter *param, puint type);
+static void pp_ini_file_cache_publish (PIniParameter *param, puint type);
+static pboolean pp_ini_file_to_boolean (const pchar *val);
+static pint pp_ini_file_value_int (const PIniFile *file, PIniParameter *param);
+static double pp_ini_file_value_double (const PIniFile *file, PIniParameter *param);
+static pboolean pp_ini_file_value_boolean (const PIniFile *file, PIniParameter *param);
+
+static pboolean
+pp_ini_file_stat (const pchar	*path,
+		  pint64	*mtime,
+		  pint64	*size)
+{
+#ifdef P_INI_FILE_HAS_STAT
+	struct stat sb;
 
-static PIniParameter *
-pp_ini_file_parameter_new (const pchar	*name,
-			   const pchar	*val)
+	if (stat (path, &sb) != 0)
+		return FALSE;
+
+	*mtime = (pint64) sb.st_mtime;
+	*size  = (pint64) sb.st_size;
+
+	return TRUE;
+#else
+	P_UNUSED (path);
+	P_UNUSED (mtime);
+	P_UNUSED (size);
+
+	return FALSE;
+#endif
+}
+
+static pchar *
+pp_ini_file_read (const pchar	*path,
+		  psize		*len,
+		  PError	**error)
 {
-	PIniParameter *ret;
+	FILE	*in_file;
+	pchar	*ret, *tmp;
+	psize	size, read_len;
+	long	file_size;
 
-	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PIniParameter))) == NULL))
+	if (P_UNLIKELY ((in_file = fopen (path, "rb")) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to open file for reading");
 		return NULL;
+	}
 
-	if (P_UNLIKELY ((ret->name = p_strdup (name)) == NULL)) {
-		p_free (ret);
+	/* The size is only a hint: it's not known for pipes and may change. Two
+	 * spare bytes let us see the end of file without growing the buffer. */
+	size = P_INI_FILE_READ_CHUNK;
+
+	if (fseek (in_file, 0, SEEK_END) == 0) {
+		if ((file_size = ftell (in_file)) > 0)
+			size = (psize) file_size + 2;
+
+		rewind (in_file);
+	}
+
+	if (P_UNLIKELY ((ret = p_malloc (size)) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for file contents");
+		fclose (in_file);
 		return NULL;
 	}
 
-	if (P_UNLIKELY ((ret->value = p_strdup (val)) == NULL)) {
-		p_free (ret->name);
+	*len = 0;
+
+	/* Always keep a spare byte for the trailing zero */
+	while ((read_len = fread (ret + *len, 1, size - *len - 1, in_file)) > 0) {
+		*len += read_len;
+
+		if (size - *len > 1)
+			continue;
+
+		if (P_UNLIKELY ((tmp = p_realloc (ret, size * 2)) == NULL)) {
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IO_NO_RESOURCES,
+					     0,
+					     "Failed to allocate memory for file contents");
+			p_free (ret);
+			fclose (in_file);
+			return NULL;
+		}
+
+		ret   = tmp;
+		size *= 2;
+	}
+
+	if (P_UNLIKELY (ferror (in_file))) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to read file");
 		p_free (ret);
+		fclose (in_file);
 		return NULL;
 	}
 
+	if (P_UNLIKELY (fclose (in_file) != 0))
+		P_WARNING ("PIniFile::pp_ini_file_read: fclose() failed");
+
+	ret[*len] = '\0';
+
 	return ret;
 }
 
-static void
-pp_ini_file_parameter_free (PIniParameter *param)
+static pboolean
+pp_ini_file_read_content (PIniFile	*file,
+			  PError	**error)
+{
+	/* Metadata is taken before reading, so a later change is noticed */
+	file->has_stat  = pp_ini_file_stat (file->path, &file->mtime, &file->size);
+	file->load_time = (pint64) time (NULL);
+
+	if (P_UNLIKELY ((file->data = pp_ini_file_read (file->path, &file->data_len, error)) == NULL))
+		return FALSE;
+
+	file->data_hash = p_fast_hash_xxh3_64 (file->data, file->data_len, 0);
+
+	return TRUE;
+}
+
+static pboolean
+pp_ini_file_process (PIniFile	*file,
+		     PError	**error)
 {
-	p_free (param->name);
-	p_free (param->value);
-	p_free (param);
+	if (P_UNLIKELY (pp_ini_file_tokenize (file, file->data_len) == FALSE ||
+			pp_ini_file_build_index (file) == FALSE)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for parsed data");
+
+		pp_ini_file_clear (file);
+
+		return FALSE;
+	}
+
+	return TRUE;
 }
 
-static PIniSection *
-pp_ini_file_section_new (const pchar *name)
+static ppointer
+pp_ini_file_grow (ppointer	items,
+		  psize		*size,
+		  psize		count,
+		  psize		item_size)
 {
-	PIniSection *ret;
+	ppointer	ret;
+	psize		new_size;
 
-	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PIniSection))) == NULL))
+	if (count < *size)
+		return items;
+
+	new_size = *size == 0 ? P_INI_FILE_MIN_ITEMS : *size * 2;
+
+	if (P_UNLIKELY ((ret = p_realloc (items, new_size * item_size)) == NULL))
 		return NULL;
 
-	if (P_UNLIKELY ((ret->name = p_strdup (name)) == NULL)) {
-		p_free (ret);
+	*size = new_size;
+
+	return ret;
+}
+
+static pboolean
+pp_ini_file_tokenize (PIniFile	*file,
+		      psize	len)
+{
+	PIniSection	*section;
+	PIniParameter	*param;
+	pchar		*data, *line, *line_end, *next, *ptr, *key_end, *val, *val_end;
+	ppointer	tmp;
+	psize		bom_shift;
+
+	data    = file->data;
+	section = NULL;
+
+	/* UTF-8, UTF-32 and UTF-16 BOM detection */
+	if (len >= 3 && (puchar) data[0] == 0xEF && (puchar) data[1] == 0xBB && (puchar) data[2] == 0xBF)
+		bom_shift = 3;
+	else if (len >= 4 && (puchar) data[0] == 0x00 && (puchar) data[1] == 0x00 &&
+		 (puchar) data[2] == 0xFE && (puchar) data[3] == 0xFF)
+		bom_shift = 4;
+	else if (len >= 4 && (puchar) data[0] == 0xFF && (puchar) data[1] == 0xFE &&
+		 (puchar) data[2] == 0x00 && (puchar) data[3] == 0x00)
+		bom_shift = 4;
+	else if (len >= 2 && (((puchar) data[0] == 0xFE && (puchar) data[1] == 0xFF) ||
+			      ((puchar) data[0] == 0xFF && (puchar) data[1] == 0xFE)))
+		bom_shift = 2;
+	else
+		bom_shift = 0;
+
+	for (line = data + bom_shift; line < data + len; line = next) {
+		if ((line_end = memchr (line, '\n', (psize) (data + len - line))) == NULL)
+			line_end = data + len;
+
+		next  = line_end + 1;
+		line += p_str_skip_spaces (line, (psize) (line_end - line));
+
+		while (line_end > line && isspace (* ((const puchar *) (line_end - 1))))
+			--line_end;
+
+		if (line == line_end || *line == '#' || *line == ';')
+			continue;
+
+		if (*line == '[' && *(line_end - 1) == ']') {
+			/* New section found */
+			ptr = memchr (line + 1, ']', (psize) (line_end - line - 1));
+
+			if (ptr == line + 1)
+				continue;
+
+			++line;
+
+			while (line < ptr && isspace (* ((const puchar *) line)))
+				++line;
+
+			while (ptr > line && isspace (* ((const puchar *) (ptr - 1))))
+				--ptr;
+
+			*ptr = '\0';
+
+			/* Previous section without parameters is dropped */
+			if (section == NULL || section->params_count > 0) {
+				if (P_UNLIKELY ((tmp = pp_ini_file_grow (file->sections,
+									 &file->sections_size,
+									 file->sections_count,
+									 sizeof (PIniSection))) == NULL))
+					return FALSE;
+
+				file->sections = (PIniSection *) tmp;
+				section        = file->sections + file->sections_count++;
+			}
+
+			section->name         = (psize) (line - data);
+			section->name_len     = (psize) (ptr - line);
+			section->first_param  = file->params_count;
+			section->params_count = 0;
+			section->keys         = NULL;
+
+			continue;
+		}
+
+		if (section == NULL)
+			continue;
+
+		/* New parameter found, a value is taken by the first '=' */
+		if ((key_end = memchr (line, '=', (psize) (line_end - line))) == NULL || key_end == line)
+			continue;
+
+		val = key_end + 1;
+
+		while (key_end > line && isspace (* ((const puchar *) (key_end - 1))))
+			--key_end;
+
+		while (val < line_end && isspace (* ((const puchar *) val)))
+			++val;
+
+		if (val == line_end)
+			continue;
+
+		if ((*val == '"' || *val == '\'') && val + 1 < line_end && *(val + 1) != *val) {
+			/* Quoted value, comment symbols are allowed inside */
+			if ((val_end = memchr (val + 1, *val, (psize) (line_end - val - 1))) == NULL)
+				val_end = line_end;
+
+			++val;
+		} else {
+			val_end = val + p_str_find_any (val, (psize) (line_end - val), "#;");
+
+			if (val_end == val)
+				continue;
+		}
+
+		while (val < val_end && isspace (* ((const puchar *) val)))
+			++val;
+
+		while (val_end > val && isspace (* ((const puchar *) (val_end - 1))))
+			--val_end;
+
+		if (val_end - val == 2 && (strncmp (val, "\"\"", 2) == 0 || strncmp (val, "''", 2) == 0))
+			val_end = val;
+
+		if (P_UNLIKELY ((tmp = pp_ini_file_grow (file->params,
+							 &file->params_size,
+							 file->params_count,
+							 sizeof (PIniParameter))) == NULL))
+			return FALSE;
+
+		file->params = (PIniParameter *) tmp;
+
+		*key_end = '\0';
+		*val_end = '\0';
+
+		param = file->params + file->params_count++;
+
+		param->name      = (psize) (line - data);
+		param->name_len  = (psize) (key_end - line);
+		param->value     = (psize) (val - data);
+		param->value_len = (psize) (val_end - val);
+		param->cached    = 0;
+
+		++section->params_count;
+	}
+
+	if (section != NULL && section->params_count == 0)
+		--file->sections_count;
+
+	return TRUE;
+}
+
+static puint
+pp_ini_file_nocase_hash (pconstpointer key)
+{
+	const puchar	*str;
+	puint		hash;
+
+	/* FNV-1a over the lowercase letters */
+	hash = 2166136261U;
+
+	for (str = (const puchar *) key; *str != '\0'; ++str) {
+		hash ^= (puint) tolower (*str);
+		hash *= 16777619U;
+	}
+
+	return hash;
+}
+
+static pboolean
+pp_ini_file_nocase_equal (pconstpointer a, pconstpointer b)
+{
+	const puchar	*str1 = (const puchar *) a;
+	const puchar	*str2 = (const puchar *) b;
+
+	for (; *str1 != '\0' && tolower (*str1) == tolower (*str2); ++str1, ++str2)
+		;
+
+	return tolower (*str1) == tolower (*str2);
+}
+
+static PHashTable *
+pp_ini_file_index_new (const PIniFile	*file,
+		       psize		count)
+{
+	PHashTable *ret;
+
+	if (file->case_sensitive)
+		ret = p_hash_table_new_full (p_str_hash, p_str_equal, NULL, NULL);
+	else
+		ret = p_hash_table_new_full (pp_ini_file_nocase_hash, pp_ini_file_nocase_equal, NULL, NULL);
+
+	if (P_UNLIKELY (ret == NULL))
+		return NULL;
+
+	/* Room for all the names, so insertion can't fail silently */
+	if (P_UNLIKELY (p_hash_table_reserve (ret, count) == FALSE)) {
+		p_hash_table_free (ret);
 		return NULL;
 	}
 
 	return ret;
 }
 
+static pboolean
+pp_ini_file_build_index (PIniFile *file)
+{
+	PIniSection	*section;
+	PIniParameter	*param;
+	psize		i, j;
+
+	if (P_UNLIKELY ((file->index = pp_ini_file_index_new (file, file->sections_count)) == NULL))
+		return FALSE;
+
+	/* Names are inserted in the file order, so repeated ones end up with
+	 * the last section or value */
+	for (i = 0; i < file->sections_count; ++i) {
+		section = file->sections + i;
+
+		if (P_UNLIKELY ((section->keys = pp_ini_file_index_new (file, section->params_count)) == NULL))
+			return FALSE;
+
+		p_hash_table_insert (file->index, file->data + section->name, section);
+
+		for (j = 0; j < section->params_count; ++j) {
+			param = file->params + section->first_param + j;
+			p_hash_table_insert (section->keys, file->data + param->name, param);
+		}
+	}
+
+	return TRUE;
+}
+
 static void
-pp_ini_file_section_free (PIniSection *section)
+pp_ini_file_clear (PIniFile *file)
 {
-	p_list_foreach (section->keys, (PFunc) pp_ini_file_parameter_free, NULL);
-	p_list_free (section->keys);
-	p_free (section->name);
-	p_free (section);
+	psize i;
+
+	for (i = 0; i < file->sections_count; ++i) {
+		if (file->sections[i].keys != NULL)
+			p_hash_table_free (file->sections[i].keys);
+	}
+
+	if (file->index != NULL)
+		p_hash_table_free (file->index);
+
+	p_free (file->params);
+	p_free (file->sections);
+	p_free (file->data);
+
+	file->index          = NULL;
+	file->params         = NULL;
+	file->params_count   = 0;
+	file->params_size    = 0;
+	file->sections       = NULL;
+	file->sections_count = 0;
+	file->sections_size  = 0;
+	file->data           = NULL;
+}
+
+static ppointer
+pp_ini_file_lookup (const PHashTable	*table,
+		    const pchar		*name)
+{
+	ppointer ret;
+
+	if (table == NULL || (ret = p_hash_table_lookup (table, name)) == (ppointer) -1)
+		return NULL;
+
+	return ret;
+}
+
+static pboolean
+pp_ini_file_change_add (PListHead		*head,
+			PIniFileChangeType	type,
+			const pchar		*section,
+			const pchar		*key)
+{
+	PIniFileChange *change;
+
+	if (P_UNLIKELY ((change = p_malloc0 (sizeof (PIniFileChange))) == NULL))
+		return FALSE;
+
+	change->type    = type;
+	change->section = p_strdup (section);
+	change->key     = key == NULL ? NULL : p_strdup (key);
+
+	if (P_UNLIKELY (change->section == NULL || (key != NULL && change->key == NULL) ||
+			p_list_head_append (head, change) == FALSE)) {
+		p_ini_file_change_free (change);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/* Only the sections and keys returned by the lookups are compared, repeated
+ * ones are overridden anyway */
+static pboolean
+pp_ini_file_diff (const PIniFile	*old_file,
+		  const PIniFile	*new_file,
+		  PListHead		*head)
+{
+	const PIniSection	*sec, *old_sec;
+	const PIniParameter	*param, *old_param;
+	const pchar		*name;
+	psize			i, j;
+
+	for (i = 0; i < new_file->sections_count; ++i) {
+		sec  = new_file->sections + i;
+		name = new_file->data + sec->name;
+
+		if (pp_ini_file_lookup (new_file->index, name) != sec)
+			continue;
+
+		if ((old_sec = pp_ini_file_lookup (old_file->index, name)) == NULL) {
+			if (P_UNLIKELY (!pp_ini_file_change_add (head, P_INI_FILE_CHANGE_ADDED, name, NULL)))
+				return FALSE;
+
+			continue;
+		}
+
+		for (j = 0; j < sec->params_count; ++j) {
+			param = new_file->params + sec->first_param + j;
+
+			if (pp_ini_file_lookup (sec->keys, new_file->data + param->name) != param)
+				continue;
+
+			old_param = pp_ini_file_lookup (old_sec->keys, new_file->data + param->name);
+
+			if (old_param == NULL) {
+				if (P_UNLIKELY (!pp_ini_file_change_add (head,
+									 P_INI_FILE_CHANGE_ADDED,
+									 name,
+									 new_file->data + param->name)))
+					return FALSE;
+			} else if (old_param->value_len != param->value_len ||
+				   memcmp (old_file->data + old_param->value,
+					   new_file->data + param->value,
+					   param->value_len) != 0) {
+				if (P_UNLIKELY (!pp_ini_file_change_add (head,
+									 P_INI_FILE_CHANGE_MODIFIED,
+									 name,
+									 new_file->data + param->name)))
+					return FALSE;
+			}
+		}
+
+		for (j = 0; j < old_sec->params_count; ++j) {
+			old_param = old_file->params + old_sec->first_param + j;
+
+			if (pp_ini_file_lookup (old_sec->keys, old_file->data + old_param->name) != old_param ||
+			    pp_ini_file_lookup (sec->keys, old_file->data + old_param->name) != NULL)
+				continue;
+
+			if (P_UNLIKELY (!pp_ini_file_change_add (head,
+								 P_INI_FILE_CHANGE_REMOVED,
+								 name,
+								 old_file->data + old_param->name)))
+				return FALSE;
+		}
+	}
+
+	for (i = 0; i < old_file->sections_count; ++i) {
+		old_sec = old_file->sections + i;
+		name    = old_file->data + old_sec->name;
+
+		if (pp_ini_file_lookup (old_file->index, name) != old_sec ||
+		    pp_ini_file_lookup (new_file->index, name) != NULL)
+			continue;
+
+		if (P_UNLIKELY (!pp_ini_file_change_add (head, P_INI_FILE_CHANGE_REMOVED, name, NULL)))
+			return FALSE;
+	}
+
+	return TRUE;
 }
 
 static pchar *
-pp_ini_file_find_parameter (const PIniFile *file, const pchar *section, const pchar *key)
+pp_ini_file_strndup (const pchar	*str,
+		     psize		len)
 {
-	PList	*item;
+	pchar *ret;
 
-	if (P_UNLIKELY (file == NULL || file->is_parsed == FALSE || section == NULL || key == NULL))
+	if (P_UNLIKELY ((ret = p_malloc (len + 1)) == NULL))
 		return NULL;
 
-	for (item = file->sections; item != NULL; item = item->next)
-		if (strcmp (((PIniSection *) item->data)->name, section) == 0)
-			break;
+	memcpy (ret, str, len);
+	ret[len] = '\0';
+
+	return ret;
+}
 
-	if (item == NULL)
+static const PIniSection *
+pp_ini_file_find_section (const PIniFile	*file,
+			  const pchar		*section)
+{
+	if (P_UNLIKELY (file == NULL || file->is_parsed == FALSE || section == NULL))
 		return NULL;
 
-	for (item = ((PIniSection *) item->data)->keys; item != NULL; item = item->next)
-		if (strcmp (((PIniParameter *) item->data)->name, key) == 0)
-			return p_strdup (((PIniParameter *) item->data)->value);
+	return (const PIniSection *) pp_ini_file_lookup (file->index, section);
+}
+
+static PIniParameter *
+pp_ini_file_find_parameter (const PIniFile *file, const pchar *section, const pchar *key)
+{
+	const PIniSection *sect;
+
+	if (P_UNLIKELY (key == NULL))
+		return NULL;
+
+	if ((sect = pp_ini_file_find_section (file, section)) == NULL)
+		return NULL;
+
+	return (PIniParameter *) pp_ini_file_lookup (sect->keys, key);
+}
+
+static pboolean
+pp_ini_file_cache_is_ready (const PIniParameter *param, puint type)
+{
+	return (((puint) p_atomic_int_get ((const volatile pint *) &param->cached)) & (2U << type)) != 0;
+}
+
+static pboolean
+pp_ini_file_cache_claim (PIniParameter *param, puint type)
+{
+	return (p_atomic_int_or (&param->cached, 1U << type) & (1U << type)) == 0;
+}
+
+static void
+pp_ini_file_cache_publish (PIniParameter *param, puint type)
+{
+	p_atomic_int_or (&param->cached, 2U << type);
+}
+
+static pboolean
+pp_ini_file_to_boolean (const pchar *val)
+{
+	if (strcmp (val, "true") == 0 || strcmp (val, "TRUE") == 0)
+		return TRUE;
+	else if (strcmp (val, "false") == 0 || strcmp (val, "FALSE") == 0)
+		return FALSE;
+	else if (atoi (val) > 0)
+		return TRUE;
+	else
+		return FALSE;
+}
+
+/* Concurrent readers may convert the same value, but only the one which has
+ * claimed the cache stores it, others just return their own result */
+static pint
+pp_ini_file_value_int (const PIniFile	*file,
+		       PIniParameter	*param)
+{
+	pint ret;
+
+	if (pp_ini_file_cache_is_ready (param, P_INI_FILE_CACHE_INT))
+		return param->int_val;
+
+	ret = atoi (file->data + param->value);
 
-	return NULL;
+	if (pp_ini_file_cache_claim (param, P_INI_FILE_CACHE_INT)) {
+		param->int_val = ret;
+		pp_ini_file_cache_publish (param, P_INI_FILE_CACHE_INT);
+	}
+
+	return ret;
+}
+
+static double
+pp_ini_file_value_double (const PIniFile	*file,
+			  PIniParameter		*param)
+{
+	double ret;
+
+	if (pp_ini_file_cache_is_ready (param, P_INI_FILE_CACHE_DOUBLE))
+		return param->double_val;
+
+	ret = p_strtod (file->data + param->value);
+
+	if (pp_ini_file_cache_claim (param, P_INI_FILE_CACHE_DOUBLE)) {
+		param->double_val = ret;
+		pp_ini_file_cache_publish (param, P_INI_FILE_CACHE_DOUBLE);
+	}
+
+	return ret;
+}
+
+static pboolean
+pp_ini_file_value_boolean (const PIniFile	*file,
+			   PIniParameter	*param)
+{
+	pboolean ret;
+
+	if (pp_ini_file_cache_is_ready (param, P_INI_FILE_CACHE_BOOLEAN))
+		return param->bool_val;
+
+	ret = pp_ini_file_to_boolean (file->data + param->value);
+
+	if (pp_ini_file_cache_claim (param, P_INI_FILE_CACHE_BOOLEAN)) {
+		param->bool_val = ret;
+		pp_ini_file_cache_publish (param, P_INI_FILE_CACHE_BOOLEAN);
+	}
+
+	return ret;
 }
 
 P_LIB_API PIniFile *
@@ -153,7 +799,8 @@ p_ini_file_new (const pchar *path)
 		return NULL;
 	}
 
-	ret->is_parsed = FALSE;
+	ret->case_sensitive = TRUE;
+	ret->is_parsed      = FALSE;
 
 	return ret;
 }
@@ -164,25 +811,27 @@ p_ini_file_free (PIniFile *file)
 	if (P_UNLIKELY (file == NULL))
 		return;
 
-	p_list_foreach (file->sections, (PFunc) pp_ini_file_section_free, NULL);
-	p_list_free (file->sections);
+	pp_ini_file_clear (file);
 	p_free (file->path);
 	p_free (file);
 }
 
+P_LIB_API pboolean
+p_ini_file_set_case_sensitive (PIniFile	*file,
+			       pboolean	case_sensitive)
+{
+	if (P_UNLIKELY (file == NULL || file->is_parsed == TRUE))
+		return FALSE;
+
+	file->case_sensitive = case_sensitive;
+
+	return TRUE;
+}
+
 P_LIB_API pboolean
 p_ini_file_parse (PIniFile	*file,
 		  PError	**error)
 {
-	PIniSection	*section;
-	PIniParameter	*param;
-	FILE		*in_file;
-	pchar		*dst_line, *tmp_str;
-	pchar		src_line[P_INI_FILE_MAX_LINE + 1],
-			key[P_INI_FILE_MAX_LINE + 1],
-			value[P_INI_FILE_MAX_LINE + 1];
-	pint		bom_shift;
-
 	if (P_UNLIKELY (file == NULL)) {
 		p_error_set_error_p (error,
 				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
@@ -194,113 +843,105 @@ p_ini_file_parse (PIniFile	*file,
 	if (file->is_parsed)
 		return TRUE;
 
-	if (P_UNLIKELY ((in_file = fopen (file->path, "r")) == NULL)) {
+	if (P_UNLIKELY (pp_ini_file_read_content (file, error) == FALSE ||
+			pp_ini_file_process (file, error) == FALSE))
+		return FALSE;
+
+	file->is_parsed = TRUE;
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_ini_file_reload (PIniFile	*file,
+		   PList	**changes,
+		   PError	**error)
+{
+	PIniFile	new_file;
+	PListHead	head;
+	PList		*list;
+	pint64		mtime, size;
+
+	if (P_UNLIKELY (file == NULL)) {
 		p_error_set_error_p (error,
-				     (pint) p_error_get_last_io (),
-				     p_error_get_last_system (),
-				     "Failed to open file for reading");
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
 		return FALSE;
 	}
 
-	dst_line = NULL;
-	section  = NULL;
-	param    = NULL;
-
-	memset (src_line, 0, sizeof (src_line));
-
-	while (fgets (src_line, sizeof (src_line), in_file) != NULL) {
-		/* UTF-8, UTF-16 and UTF-32 BOM detection */
-		if ((puchar) src_line[0] == 0xEF && (puchar) src_line[1] == 0xBB && (puchar) src_line[2] == 0xBF)
-			bom_shift = 3;
-		else if (((puchar) src_line[0] == 0xFE && (puchar) src_line[1] == 0xFF) ||
-			 ((puchar) src_line[0] == 0xFF && (puchar) src_line[1] == 0xFE))
-			bom_shift = 2;
-		else if ((puchar) src_line[0] == 0x00 && (puchar) src_line[1] == 0x00 &&
-			 (puchar) src_line[2] == 0xFE && (puchar) src_line[3] == 0xFF)
-			bom_shift = 4;
-		else if ((puchar) src_line[0] == 0xFF && (puchar) src_line[1] == 0xFE &&
-			 (puchar) src_line[2] == 0x00 && (puchar) src_line[3] == 0x00)
-			bom_shift = 4;
-		else
-			bom_shift = 0;
-
-		dst_line = p_strchomp (src_line + bom_shift);
-
-		if (dst_line == NULL)
-			continue;
+	if (changes != NULL)
+		*changes = NULL;
 
-		/* This should not happen */
-		if (P_UNLIKELY (strlen (dst_line) > P_INI_FILE_MAX_LINE))
-			dst_line[P_INI_FILE_MAX_LINE] = '\0';
+	/* Modification time has a coarse resolution: if the file was changed
+	 * in the same second it was read, the content must be checked */
+	if (file->is_parsed && file->has_stat && file->mtime < file->load_time &&
+	    pp_ini_file_stat (file->path, &mtime, &size) &&
+	    mtime == file->mtime && size == file->size)
+		return TRUE;
 
-		if (dst_line[0] == '[' && dst_line[strlen (dst_line) - 1] == ']' &&
-		    sscanf (dst_line, "[%[^]]", key) == 1) {
-			/* New section found */
-			if ((tmp_str = p_strchomp (key)) != NULL) {
-				/* This should not happen */
-				if (P_UNLIKELY (strlen (tmp_str) > P_INI_FILE_MAX_LINE))
-					tmp_str[P_INI_FILE_MAX_LINE] = '\0';
-
-				strcpy (key, tmp_str);
-				p_free (tmp_str);
-
-				if (section != NULL) {
-					if (section->keys == NULL)
-						pp_ini_file_section_free (section);
-					else
-						file->sections = p_list_prepend (file->sections, section);
-				}
-
-				section = pp_ini_file_section_new (key);
-			}
-		} else if (sscanf (dst_line, "%[^=] = \"%[^\"]\"", key, value) == 2 ||
-			   sscanf (dst_line, "%[^=] = '%[^\']'", key, value) == 2 ||
-			   sscanf (dst_line, "%[^=] = %[^;#]", key, value) == 2) {
-			/* New parameter found */
-			if ((tmp_str = p_strchomp (key)) != NULL) {
-				/* This should not happen */
-				if (P_UNLIKELY (strlen (tmp_str) > P_INI_FILE_MAX_LINE))
-					tmp_str[P_INI_FILE_MAX_LINE] = '\0';
-
-				strcpy (key, tmp_str);
-				p_free (tmp_str);
-
-				if ((tmp_str = p_strchomp (value)) != NULL) {
-					/* This should not happen */
-					if (P_UNLIKELY (strlen (tmp_str) > P_INI_FILE_MAX_LINE))
-						tmp_str[P_INI_FILE_MAX_LINE] = '\0';
-
-					strcpy (value, tmp_str);
-					p_free (tmp_str);
-
-					if (strcmp (value, "\"\"") == 0 || (strcmp (value, "''") == 0))
-						value[0] = '\0';
-
-					if (section != NULL && (param = pp_ini_file_parameter_new (key, value)) != NULL)
-						section->keys = p_list_prepend (section->keys, param);
-				}
-			}
-		}
+	memset (&new_file, 0, sizeof (PIniFile));
 
-		p_free (dst_line);
-		memset (src_line, 0, sizeof (src_line));
+	new_file.path           = file->path;
+	new_file.case_sensitive = file->case_sensitive;
+
+	if (P_UNLIKELY (pp_ini_file_read_content (&new_file, error) == FALSE))
+		return FALSE;
+
+	if (file->is_parsed && new_file.data_len == file->data_len &&
+	    new_file.data_hash == file->data_hash) {
+		file->has_stat  = new_file.has_stat;
+		file->mtime     = new_file.mtime;
+		file->size      = new_file.size;
+		file->load_time = new_file.load_time;
+
+		p_free (new_file.data);
+
+		return TRUE;
 	}
 
-	if (section != NULL) {
-		if (section->keys == NULL)
-			pp_ini_file_section_free (section);
-		else
-			file->sections = p_list_append (file->sections, section);
+	if (P_UNLIKELY (pp_ini_file_process (&new_file, error) == FALSE))
+		return FALSE;
+
+	if (changes != NULL) {
+		p_list_head_init (&head);
+
+		if (P_UNLIKELY (pp_ini_file_diff (file, &new_file, &head) == FALSE)) {
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IO_NO_RESOURCES,
+					     0,
+					     "Failed to allocate memory for changes");
+
+			list = p_list_head_steal (&head);
+			p_list_foreach (list, (PFunc) p_ini_file_change_free, NULL);
+			p_list_free (list);
+			pp_ini_file_clear (&new_file);
+
+			return FALSE;
+		}
+
+		*changes = p_list_head_steal (&head);
 	}
 
-	if (P_UNLIKELY (fclose (in_file) != 0))
-		P_WARNING ("PIniFile::p_ini_file_parse: fclose() failed");
+	pp_ini_file_clear (file);
 
-	file->is_parsed = TRUE;
+	new_file.is_parsed = TRUE;
+	*file              = new_file;
 
 	return TRUE;
 }
 
+P_LIB_API void
+p_ini_file_change_free (PIniFileChange *change)
+{
+	if (P_UNLIKELY (change == NULL))
+		return;
+
+	p_free (change->section);
+	p_free (change->key);
+	p_free (change);
+}
+
 P_LIB_API pboolean
 p_ini_file_is_parsed (const PIniFile *file)
 {
@@ -313,16 +954,18 @@ p_ini_file_is_parsed (const PIniFile *file)
 P_LIB_API PList *
 p_ini_file_sections (const PIniFile *file)
 {
-	PList	*ret;
-	PList	*sec;
+	PList			*ret;
+	const PIniSection	*sec;
 
 	if (P_UNLIKELY (file == NULL || file->is_parsed == FALSE))
 		return NULL;
 
 	ret = NULL;
 
-	for (sec = file->sections; sec != NULL; sec = sec->next)
-		ret = p_list_prepend (ret, p_strdup (((PIniSection *) sec->data)->name));
+	for (sec = file->sections + file->sections_count; sec != file->sections; ) {
+		--sec;
+		ret = p_list_prepend (ret, pp_ini_file_strndup (file->data + sec->name, sec->name_len));
+	}
 
 	return ret;
 }
@@ -331,49 +974,72 @@ P_LIB_API PList *
 p_ini_file_keys (const PIniFile	*file,
 		 const pchar	*section)
 {
-	PList	*ret;
-	PList	*item;
+	PList			*ret;
+	const PIniSection	*sec;
+	const PIniParameter	*item;
 
-	if (P_UNLIKELY (file == NULL || file->is_parsed == FALSE || section == NULL))
+	if ((sec = pp_ini_file_find_section (file, section)) == NULL)
 		return NULL;
 
 	ret = NULL;
 
-	for (item = file->sections; item != NULL; item = item->next)
-		if (strcmp (((PIniSection *) item->data)->name, section) == 0)
-			break;
+	for (item = file->params + sec->first_param + sec->params_count;
+	     item != file->params + sec->first_param; ) {
+		--item;
+		ret = p_list_prepend (ret, pp_ini_file_strndup (file->data + item->name, item->name_len));
+	}
+
+	return ret;
+}
+
+P_LIB_API PArray *
+p_ini_file_sections_array (const PIniFile *file)
+{
+	PArray	*ret;
+	psize	i;
+
+	if (P_UNLIKELY (file == NULL || file->is_parsed == FALSE))
+		return NULL;
 
-	if (item == NULL)
+	if (P_UNLIKELY ((ret = p_array_new ()) == NULL))
 		return NULL;
 
-	for (item = ((PIniSection *) item->data)->keys; item != NULL; item = item->next)
-		ret = p_list_prepend (ret, p_strdup (((PIniParameter *) item->data)->name));
+	for (i = 0; i < file->sections_count; ++i)
+		p_array_push (ret, pp_ini_file_strndup (file->data + file->sections[i].name,
+							file->sections[i].name_len));
 
 	return ret;
 }
 
-P_LIB_API pboolean
-p_ini_file_is_key_exists (const PIniFile	*file,
-			  const pchar		*section,
-			  const pchar		*key)
+P_LIB_API PArray *
+p_ini_file_keys_array (const PIniFile	*file,
+		       const pchar	*section)
 {
-	PList	*item;
+	PArray			*ret;
+	const PIniSection	*sec;
+	const PIniParameter	*item;
+	psize			i;
 
-	if (P_UNLIKELY (file == NULL || file->is_parsed == FALSE || section == NULL || key == NULL))
-		return FALSE;
+	if ((sec = pp_ini_file_find_section (file, section)) == NULL)
+		return NULL;
 
-	for (item = file->sections; item != NULL; item = item->next)
-		if (strcmp (((PIniSection *) item->data)->name, section) == 0)
-			break;
+	if (P_UNLIKELY ((ret = p_array_new ()) == NULL))
+		return NULL;
 
-	if (item == NULL)
-		return FALSE;
+	for (i = 0; i < sec->params_count; ++i) {
+		item = file->params + sec->first_param + i;
+		p_array_push (ret, pp_ini_file_strndup (file->data + item->name, item->name_len));
+	}
 
-	for (item = ((PIniSection *) item->data)->keys; item != NULL; item = item->next)
-		if (strcmp (((PIniParameter *) item->data)->name, key) == 0)
-			return TRUE;
+	return ret;
+}
 
-	return FALSE;
+P_LIB_API pboolean
+p_ini_file_is_key_exists (const PIniFile	*file,
+			  const pchar		*section,
+			  const pchar		*key)
+{
+	return pp_ini_file_find_parameter (file, section, key) != NULL;
 }
 
 P_LIB_API pchar *
@@ -382,12 +1048,26 @@ p_ini_file_parameter_string (const PIniFile	*file,
 			     const pchar	*key,
 			     const pchar	*default_val)
 {
-	pchar *val;
+	const PIniParameter *param;
 
-	if ((val = pp_ini_file_find_parameter (file, section, key)) == NULL)
+	if ((param = pp_ini_file_find_parameter (file, section, key)) == NULL)
 		return p_strdup (default_val);
 
-	return val;
+	return pp_ini_file_strndup (file->data + param->value, param->value_len);
+}
+
+P_LIB_API const pchar *
+p_ini_file_parameter_string_view (const PIniFile	*file,
+				  const pchar		*section,
+				  const pchar		*key,
+				  const pchar		*default_val)
+{
+	const PIniParameter *param;
+
+	if ((param = pp_ini_file_find_parameter (file, section, key)) == NULL)
+		return default_val;
+
+	return file->data + param->value;
 }
 
 P_LIB_API pint
@@ -396,16 +1076,12 @@ p_ini_file_parameter_int (const PIniFile	*file,
 			  const pchar		*key,
 			  pint			default_val)
 {
-	pchar	*val;
-	pint	ret;
+	PIniParameter *param;
 
-	if ((val = pp_ini_file_find_parameter (file, section, key)) == NULL)
+	if ((param = pp_ini_file_find_parameter (file, section, key)) == NULL)
 		return default_val;
 
-	ret = atoi (val);
-	p_free (val);
-
-	return ret;
+	return pp_ini_file_value_int (file, param);
 }
 
 P_LIB_API double
@@ -414,16 +1090,12 @@ p_ini_file_parameter_double (const PIniFile	*file,
 			     const pchar	*key,
 			     double		default_val)
 {
-	pchar	*val;
-	pdouble	ret;
+	PIniParameter *param;
 
-	if ((val = pp_ini_file_find_parameter (file, section, key)) == NULL)
+	if ((param = pp_ini_file_find_parameter (file, section, key)) == NULL)
 		return default_val;
 
-	ret = p_strtod (val);
-	p_free (val);
-
-	return ret;
+	return pp_ini_file_value_double (file, param);
 }
 
 P_LIB_API pboolean
@@ -432,24 +1104,12 @@ p_ini_file_parameter_boolean (const PIniFile	*file,
 			      const pchar	*key,
 			      pboolean		default_val)
 {
-	pchar		*val;
-	pboolean	ret;
+	PIniParameter *param;
 
-	if ((val = pp_ini_file_find_parameter (file, section, key)) == NULL)
+	if ((param = pp_ini_file_find_parameter (file, section, key)) == NULL)
 		return default_val;
 
-	if (strcmp (val, "true") == 0 || strcmp (val, "TRUE") == 0)
-		ret = TRUE;
-	else if (strcmp (val, "false") == 0 || strcmp (val, "FALSE") == 0)
-		ret = FALSE;
-	else if (atoi (val) > 0)
-		ret = TRUE;
-	else
-		ret = FALSE;
-
-	p_free (val);
-
-	return ret;
+	return pp_ini_file_value_boolean (file, param);
 }
 
 P_LIB_API PList *
@@ -457,47 +1117,114 @@ p_ini_file_parameter_list (const PIniFile	*file,
 			   const pchar		*section,
 			   const pchar		*key)
 {
-	PList	*ret = NULL;
-	pchar	*val, *str;
-	pchar	buf[P_INI_FILE_MAX_LINE + 1];
-	psize	len, buf_cnt;
+	PListHead		ret;
+	const PIniParameter	*param;
+	const pchar		*val, *str, *token;
+	psize			len;
 
-	if ((val = pp_ini_file_find_parameter (file, section, key)) == NULL)
+	if ((param = pp_ini_file_find_parameter (file, section, key)) == NULL)
 		return NULL;
 
-	len = strlen (val);
+	val = file->data + param->value;
+	len = param->value_len;
 
-	if (len < 3 || val[0] != '{' || val[len - 1] != '}') {
-		p_free (val);
+	if (len < 3 || val[0] != '{' || val[len - 1] != '}')
 		return NULL;
-	}
+
+	p_list_head_init (&ret);
 
 	/* Skip first brace '{' symbol */
 	str = val + 1;
-	buf[0] = '\0';
-	buf_cnt = 0;
 
 	while (*str && *str != '}') {
-		if (!isspace (* ((const puchar *) str)))
-			buf[buf_cnt++] = *str;
-		else {
-			buf[buf_cnt] = '\0';
-
-			if (buf_cnt > 0)
-				ret = p_list_append (ret, p_strdup (buf));
-
-			buf_cnt = 0;
+		if (isspace (* ((const puchar *) str))) {
+			++str;
+			continue;
 		}
 
-		++str;
+		for (token = str; *str && *str != '}' && !isspace (* ((const puchar *) str)); ++str)
+			;
+
+		p_list_head_append (&ret, pp_ini_file_strndup (token, (psize) (str - token)));
 	}
 
-	if (buf_cnt > 0) {
-		buf[buf_cnt] = '\0';
-		ret = p_list_append (ret, p_strdup (buf));
+	return p_list_head_steal (&ret);
+}
+
+P_LIB_API pboolean
+p_ini_file_section_foreach (const PIniFile		*file,
+			    const pchar			*section,
+			    PIniFileForeachFunc		func,
+			    ppointer			user_data)
+{
+	const PIniSection	*sec;
+	const PIniParameter	*item;
+	psize			i;
+
+	if (P_UNLIKELY (func == NULL))
+		return FALSE;
+
+	if ((sec = pp_ini_file_find_section (file, section)) == NULL)
+		return FALSE;
+
+	for (i = 0; i < sec->params_count; ++i) {
+		item = file->params + sec->first_param + i;
+
+		if (func (file->data + item->name, file->data + item->value, user_data))
+			break;
 	}
 
-	p_free (val);
+	return TRUE;
+}
+
+P_LIB_API psize
+p_ini_file_get_many (const PIniFile	*file,
+		     const pchar	*section,
+		     PIniFileQuery	*queries,
+		     psize		count)
+{
+	const PIniSection	*sec;
+	PIniParameter		*param;
+	PIniFileQuery		*query;
+	psize			ret;
+	psize			i;
+
+	if (P_UNLIKELY (queries == NULL))
+		return 0;
+
+	sec = pp_ini_file_find_section (file, section);
+	ret = 0;
+
+	for (i = 0; i < count; ++i) {
+		query = queries + i;
+		param = (sec == NULL || query->key == NULL) ? NULL
+							    : (PIniParameter *) pp_ini_file_lookup (sec->keys, query->key);
+
+		if ((query->found = (param != NULL)) == FALSE)
+			continue;
+
+		++ret;
+
+		if (query->value == NULL)
+			continue;
+
+		switch (query->type) {
+		case P_INI_FILE_VALUE_STRING:
+			*((const pchar **) query->value) = file->data + param->value;
+			break;
+		case P_INI_FILE_VALUE_INT:
+			*((pint *) query->value) = pp_ini_file_value_int (file, param);
+			break;
+		case P_INI_FILE_VALUE_DOUBLE:
+			*((double *) query->value) = pp_ini_file_value_double (file, param);
+			break;
+		case P_INI_FILE_VALUE_BOOLEAN:
+			*((pboolean *) query->value) = pp_ini_file_value_boolean (file, param);
+			break;
+		default:
+			break;
+		}
+	}
 
 	return ret;
 }
@@ -55,7 +55,9 @@
  * simply '0/1'.
  *
  * Any value can be interpreted as a string at any moment. Actually all the
- * values are stored internally as strings.
+ * values are stored internally as strings. Integer, floating point and boolean
+ * conversions are cached on the first access, so reading the same parameter
+ * again is cheap.
  *
  * A list of values can be stored between the '{}' symbols separated with
  * spaces. The list only supports string values, so you should convert them to
@@ -101,6 +103,7 @@
 #include "pmacros.h"
 #include "ptypes.h"
 #include "plist.h"
+#include "parray.h"
 #include "perror.h"
 
 P_BEGIN_DECLS
@@ -108,6 +111,48 @@ P_BEGIN_DECLS
 /** INI file opaque data structure. */
 typedef struct PIniFile_ PIniFile;
 
+/** Kind of a change found by p_ini_file_reload(). */
+typedef enum PIniFileChangeType_ {
+	P_INI_FILE_CHANGE_ADDED		= 0,	/**< Section or key was added.		*/
+	P_INI_FILE_CHANGE_REMOVED	= 1,	/**< Section or key was removed.	*/
+	P_INI_FILE_CHANGE_MODIFIED	= 2	/**< Value of a key was changed.	*/
+} PIniFileChangeType;
+
+/** Single change found by p_ini_file_reload(). */
+typedef struct PIniFileChange_ {
+	PIniFileChangeType	type;		/**< Kind of the change.			*/
+	pchar			*section;	/**< Section name.				*/
+	pchar			*key;		/**< Key, NULL if the whole section changed.	*/
+} PIniFileChange;
+
+/** Type of a value requested with p_ini_file_get_many(). */
+typedef enum PIniFileValueType_ {
+	P_INI_FILE_VALUE_STRING		= 0,	/**< String view, stored to `const pchar *`.	*/
+	P_INI_FILE_VALUE_INT		= 1,	/**< Integer, stored to #pint.			*/
+	P_INI_FILE_VALUE_DOUBLE		= 2,	/**< Floating point, stored to `double`.	*/
+	P_INI_FILE_VALUE_BOOLEAN	= 3	/**< Boolean, stored to #pboolean.		*/
+} PIniFileValueType;
+
+/** Single entry of a p_ini_file_get_many() query table. */
+typedef struct PIniFileQuery_ {
+	const pchar		*key;	/**< Key to read.					*/
+	PIniFileValueType	type;	/**< Type to convert the value to.			*/
+	ppointer		value;	/**< Storage for the value, may be NULL.		*/
+	pboolean		found;	/**< Set to TRUE if the key exists, FALSE otherwise.	*/
+} PIniFileQuery;
+
+/**
+ * @brief Function to visit section parameters with p_ini_file_section_foreach().
+ * @param key Parameter name, owned by the #PIniFile.
+ * @param value Parameter value, owned by the #PIniFile.
+ * @param user_data Data provided by the caller.
+ * @return FALSE to continue visiting, TRUE to stop it.
+ * @since 0.0.5
+ */
+typedef pboolean (*PIniFileForeachFunc) (const pchar	*key,
+					 const pchar	*value,
+					 ppointer	user_data);
+
 /**
  * @brief Creates a new #PIniFile for parsing.
  * @param path Path to a file to parse.
@@ -123,16 +168,75 @@ P_LIB_API PIniFile *	p_ini_file_new			(const pchar	*path);
  */
 P_LIB_API void		p_ini_file_free			(PIniFile	*file);
 
+/**
+ * @brief Sets whether section names and keys are case sensitive.
+ * @param file #PIniFile to set the option for, it must not be parsed yet.
+ * @param case_sensitive TRUE to match names exactly, FALSE to ignore the case
+ * of ASCII letters.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * Names are case sensitive by default. The option affects all the lookups by
+ * a section name or a key, names are returned in the original case anyway.
+ * Sections or keys which differ only in case are treated as repeated ones, so
+ * the last of them is used.
+ */
+P_LIB_API pboolean	p_ini_file_set_case_sensitive	(PIniFile	*file,
+							 pboolean	case_sensitive);
+
 /**
  * @brief Parses given #PIniFile.
  * @param file #PIniFile file to parse.
  * @param[out] error Error report object, NULL to ignore.
  * @return TRUE in case of success, FALSE otherwise.
  * @since 0.0.1
+ *
+ * The whole file is read into a single buffer at once and tokenized in place,
+ * so there is no limit on the line length. Section names, keys and values are
+ * stored as views into that buffer, it's kept until the @a file is freed.
+ *
+ * Sections and keys are indexed with hash tables during parsing, so lookups
+ * take near constant time regardless of the file size.
  */
 P_LIB_API pboolean	p_ini_file_parse		(PIniFile	*file,
 							 PError		**error);
 
+/**
+ * @brief Parses given #PIniFile again if the file was changed.
+ * @param file #PIniFile file to reload.
+ * @param[out] changes List of #PIniFileChange items to store the differences
+ * with the previous parse, NULL to ignore.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ * @note It's a caller responsibility to free each returned change with
+ * p_ini_file_change_free() and the returned list with p_list_free().
+ *
+ * If the modification time and the size of the file are the same as before,
+ * nothing is read at all. Otherwise the file is read and its content hash is
+ * compared with the previous one, the file is only parsed again if the content
+ * differs. The @a changes list is empty (NULL) if nothing was changed.
+ *
+ * A whole added or removed section is reported once with a NULL key, changes
+ * in the sections which exist in both versions are reported per key. Only
+ * the last of repeated sections or keys is taken into account.
+ *
+ * If the @a file wasn't parsed before, it's parsed and every section is
+ * reported as added. In case of a failure the previous content is kept.
+ * Strings returned by p_ini_file_parameter_string_view() become invalid after
+ * the file is parsed again.
+ */
+P_LIB_API pboolean	p_ini_file_reload		(PIniFile	*file,
+							 PList		**changes,
+							 PError		**error);
+
+/**
+ * @brief Frees a change returned by p_ini_file_reload().
+ * @param change Change to free.
+ * @since 0.0.5
+ */
+P_LIB_API void		p_ini_file_change_free		(PIniFileChange	*change);
+
 /**
  * @brief Checks whether #PIniFile was already parsed or not.
  * @param file #PIniFile to check.
@@ -152,6 +256,19 @@ P_LIB_API pboolean	p_ini_file_is_parsed		(const PIniFile	*file);
  */
 P_LIB_API PList	*	p_ini_file_sections		(const PIniFile	*file);
 
+/**
+ * @brief Gets all the sections from a given file as an array.
+ * @param file #PIniFile to get the sections from. The @a file should be parsed
+ * before.
+ * @return #PArray of section names.
+ * @since 0.0.5
+ * @note It's a caller responsibility to p_free() each returned string and to
+ * free the returned array with p_array_free().
+ *
+ * Names are given in the same order as p_ini_file_sections() does.
+ */
+P_LIB_API PArray *	p_ini_file_sections_array	(const PIniFile	*file);
+
 /**
  * @brief Gets all the keys from a given section.
  * @param file #PIniFile to get the keys from. The @a file should be parsed
@@ -165,6 +282,21 @@ P_LIB_API PList	*	p_ini_file_sections		(const PIniFile	*file);
 P_LIB_API PList *	p_ini_file_keys			(const PIniFile	*file,
 							 const pchar	*section);
 
+/**
+ * @brief Gets all the keys from a given section as an array.
+ * @param file #PIniFile to get the keys from. The @a file should be parsed
+ * before.
+ * @param section Section name to get the keys from.
+ * @return #PArray of key names.
+ * @since 0.0.5
+ * @note It's a caller responsibility to p_free() each returned string and to
+ * free the returned array with p_array_free().
+ *
+ * Names are given in the same order as p_ini_file_keys() does.
+ */
+P_LIB_API PArray *	p_ini_file_keys_array		(const PIniFile	*file,
+							 const pchar	*section);
+
 /**
  * @brief Checks whether a key exists.
  * @param file #PIniFile to check in. The @a file should be parsed before.
@@ -194,6 +326,23 @@ P_LIB_API pchar *	p_ini_file_parameter_string	(const PIniFile	*file,
 							 const pchar	*key,
 							 const pchar	*default_val);
 
+/**
+ * @brief Gets specified parameter's value as a string without copying it.
+ * @param file #PIniFile to get the value from. The @a file should be parsed
+ * before.
+ * @param section Section to get the value from.
+ * @param key Key to get the value from.
+ * @param default_val Default value to return if no specified key exists.
+ * @return Key's value in case of success, @a default_value otherwise.
+ * @since 0.0.5
+ * @note The returned string is owned by the @a file and is valid until the
+ * @a file is freed, it must not be modified or freed.
+ */
+P_LIB_API const pchar *	p_ini_file_parameter_string_view (const PIniFile	*file,
+							  const pchar		*section,
+							  const pchar		*key,
+							  const pchar		*default_val);
+
 /**
  * @brief Gets specified parameter's value as an integer.
  * @param file #PIniFile to get the value from. The @a file should be parsed
@@ -256,6 +405,47 @@ P_LIB_API PList *	p_ini_file_parameter_list	(const PIniFile	*file,
 							 const pchar	*section,
 							 const pchar	*key);
 
+/**
+ * @brief Visits all parameters of a section in the file order.
+ * @param file #PIniFile to visit the parameters of. The @a file should be
+ * parsed before.
+ * @param section Section to visit.
+ * @param func Function to call for every parameter.
+ * @param user_data Data to pass to the @a func.
+ * @return TRUE if the section exists, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The keys and values passed to the @a func are owned by the @a file and are
+ * valid until the @a file is freed or reloaded. Duplicated keys are visited
+ * as many times as they appear in the file, the last one is the one returned
+ * by the other getters.
+ */
+P_LIB_API pboolean	p_ini_file_section_foreach	(const PIniFile		*file,
+							 const pchar		*section,
+							 PIniFileForeachFunc	func,
+							 ppointer		user_data);
+
+/**
+ * @brief Reads several parameters of a section at once.
+ * @param file #PIniFile to get the values from. The @a file should be parsed
+ * before.
+ * @param section Section to get the values from.
+ * @param[in,out] queries Table of keys to read.
+ * @param count Number of entries in the @a queries table.
+ * @return Number of found keys.
+ * @since 0.0.5
+ *
+ * The section is looked up only once, every found value is converted the same
+ * way as with the p_ini_file_parameter_*() getters and stored into the
+ * #PIniFileQuery.value storage. The storage of a missing key is not touched,
+ * so it can be pre-filled with a default value. String values are not copied,
+ * see p_ini_file_parameter_string_view().
+ */
+P_LIB_API psize		p_ini_file_get_many		(const PIniFile	*file,
+							 const pchar	*section,
+							 PIniFileQuery	*queries,
+							 psize		count);
+
 P_END_DECLS
 
 #endif /* PLIBSYS_HEADER_PINIFILE_H */
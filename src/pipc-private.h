@@ -71,6 +71,16 @@ pint		p_ipc_unix_get_ftok_key		(const pchar	*file_name);
 pchar *		p_ipc_get_platform_key		(const pchar	*name,
 						 pboolean	posix);
 
+/**
+ * @brief Touches every page of a memory region to fault it in.
+ * @param addr Region start.
+ * @param size Region size in bytes.
+ * @param page_size Page size in bytes.
+ */
+void		p_ipc_prefault_memory		(pconstpointer	addr,
+						 psize		size,
+						 psize		page_size);
+
 P_END_DECLS
 
 #endif /* PLIBSYS_HEADER_PIPC_PRIVATE_H */
@@ -176,3 +176,19 @@ p_ipc_get_platform_key (const pchar *name, pboolean posix)
 	return path_name;
 #endif
 }
+
+/* A read is enough: it maps the page of a shared segment in */
+void
+p_ipc_prefault_memory (pconstpointer	addr,
+		       psize		size,
+		       psize		page_size)
+{
+	const volatile pchar	*ptr = (const volatile pchar *) addr;
+	psize			i;
+
+	if (P_UNLIKELY (addr == NULL || page_size == 0))
+		return;
+
+	for (i = 0; i < size; i += page_size)
+		(void) ptr[i];
+}
@@ -55,6 +55,7 @@
 #include "perror.h"
 #include "pfile.h"
 #include "plibraryloader.h"
+#include "plibraryloader-private.h"
 #include "pmem.h"
 #include "pstring.h"
 
@@ -72,8 +73,9 @@
 typedef APTR plibrary_handle;
 
 struct PLibraryLoader_ {
-	plibrary_handle	handle;
-	Elf32_Error	last_error;
+	plibrary_handle		handle;
+	PConcurrentHashTable	*symbols;
+	Elf32_Error		last_error;
 };
 
 static Elf32_Handle pp_library_loader_elf_root = NULL;
@@ -417,7 +419,8 @@ pp_library_loader_clean_handle (plibrary_handle handle)
 }
 
 P_LIB_API PLibraryLoader *
-p_library_loader_new (const pchar *path)
+p_library_loader_new_with_flags (const pchar	*path,
+				 pint		flags)
 {
 	PLibraryLoader	*loader = NULL;
 	plibrary_handle	handle  = NULL;
@@ -427,32 +430,41 @@ p_library_loader_new (const pchar *path)
 		return NULL;
 
 	if (pp_library_loader_elf_root == NULL) {
-		P_ERROR ("PLibraryLoader::p_library_loader_new: shared library subsystem is not initialized");
+		P_ERROR ("PLibraryLoader::p_library_loader_new_with_flags: shared library subsystem is not initialized");
 		return NULL;
 	}
 
 	if (strlen (path) >= MAXPATHLEN) {
-		P_ERROR ("PLibraryLoader::p_library_loader_new: too long file path or name");
+		P_ERROR ("PLibraryLoader::p_library_loader_new_with_flags: too long file path or name");
 		return NULL;
 	}
 
 	if (pp_library_loader_translate_path (path, path_buffer, MAXPATHLEN) != 0) {
-		P_ERROR ("PLibraryLoader::p_library_loader_new: failed to convert to UNIX path");
+		P_ERROR ("PLibraryLoader::p_library_loader_new_with_flags: failed to convert to UNIX path");
 		return NULL;
 	}
 
 	path = path_buffer;
 
-	handle = IElf->DLOpen (pp_library_loader_elf_root, (CONST_STRPTR) path, ELF32_RTLD_LOCAL);
+	handle = IElf->DLOpen (pp_library_loader_elf_root,
+			       (CONST_STRPTR) path,
+			       (flags & P_LIBRARY_LOADER_FLAG_GLOBAL) ? ELF32_RTLD_GLOBAL : ELF32_RTLD_LOCAL);
 
 	if (P_UNLIKELY (handle == NULL)) {
-		P_ERROR ("PLibraryLoader::p_library_loader_new: DLOpen() failed");
+		P_ERROR ("PLibraryLoader::p_library_loader_new_with_flags: DLOpen() failed");
 		return NULL;
 	}
 
 	if (P_UNLIKELY ((loader = p_malloc0 (sizeof (PLibraryLoader))) == NULL)) {
-		P_ERROR ("PLibraryLoader::p_library_loader_new: failed to allocate memory");
+		P_ERROR ("PLibraryLoader::p_library_loader_new_with_flags: failed(1) to allocate memory");
+		pp_library_loader_clean_handle (handle);
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((loader->symbols = p_library_loader_cache_new ()) == NULL)) {
+		P_ERROR ("PLibraryLoader::p_library_loader_new_with_flags: failed(2) to allocate memory");
 		pp_library_loader_clean_handle (handle);
+		p_free (loader);
 		return NULL;
 	}
 
@@ -465,11 +477,17 @@ p_library_loader_new (const pchar *path)
 P_LIB_API PFuncAddr
 p_library_loader_get_symbol (PLibraryLoader *loader, const pchar *sym)
 {
-	APTR func_addr = NULL;
+	APTR		func_addr = NULL;
+	PFuncAddr	addr;
 
 	if (P_UNLIKELY (loader == NULL || sym == NULL || loader->handle == NULL))
 		return NULL;
 
+	if (p_library_loader_cache_lookup (loader->symbols, sym, &addr) == TRUE) {
+		loader->last_error = ELF32_NO_ERROR;
+		return addr;
+	}
+
 	if (pp_library_loader_elf_root == NULL) {
 		P_ERROR ("PLibraryLoader::p_library_loader_new: shared library subsystem is not initialized");
 		return NULL;
@@ -480,6 +498,9 @@ p_library_loader_get_symbol (PLibraryLoader *loader, const pchar *sym)
 					  (CONST_STRPTR) sym,
 					  &func_addr);
 
+	if (loader->last_error == ELF32_NO_ERROR && func_addr != NULL)
+		p_library_loader_cache_insert (loader->symbols, sym, (PFuncAddr) func_addr);
+
 	return (PFuncAddr) func_addr;
 }
 
@@ -491,6 +512,7 @@ p_library_loader_free (PLibraryLoader *loader)
 
 	pp_library_loader_clean_handle (loader->handle);
 
+	p_concurrent_hash_table_free (loader->symbols);
 	p_free (loader);
 }
 
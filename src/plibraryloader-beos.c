@@ -26,6 +26,7 @@
 #include "perror.h"
 #include "pfile.h"
 #include "plibraryloader.h"
+#include "plibraryloader-private.h"
 #include "pmem.h"
 #include "pstring.h"
 
@@ -34,8 +35,9 @@
 typedef image_id plibrary_handle;
 
 struct PLibraryLoader_ {
-	plibrary_handle	handle;
-	status_t	last_status;
+	plibrary_handle		handle;
+	PConcurrentHashTable	*symbols;
+	status_t		last_status;
 };
 
 static void pp_library_loader_clean_handle (plibrary_handle handle);
@@ -48,25 +50,36 @@ pp_library_loader_clean_handle (plibrary_handle handle)
 }
 
 P_LIB_API PLibraryLoader *
-p_library_loader_new (const pchar *path)
+p_library_loader_new_with_flags (const pchar	*path,
+				 pint		flags)
 {
 	PLibraryLoader	*loader = NULL;
 	plibrary_handle	handle;
 
+	/* Add-ons are always bound at the loading time and never global */
+	P_UNUSED (flags);
+
 	if (!p_file_is_exists (path))
 		return NULL;
 
 	if (P_UNLIKELY ((handle = load_add_on (path)) == B_ERROR)) {
-		P_ERROR ("PLibraryLoader::p_library_loader_new: load_add_on() failed");
+		P_ERROR ("PLibraryLoader::p_library_loader_new_with_flags: load_add_on() failed");
 		return NULL;
 	}
 
 	if (P_UNLIKELY ((loader = p_malloc0 (sizeof (PLibraryLoader))) == NULL)) {
-		P_ERROR ("PLibraryLoader::p_library_loader_new: failed to allocate memory");
+		P_ERROR ("PLibraryLoader::p_library_loader_new_with_flags: failed(1) to allocate memory");
 		pp_library_loader_clean_handle (handle);
 		return NULL;
 	}
 
+	if (P_UNLIKELY ((loader->symbols = p_library_loader_cache_new ()) == NULL)) {
+		P_ERROR ("PLibraryLoader::p_library_loader_new_with_flags: failed(2) to allocate memory");
+		pp_library_loader_clean_handle (handle);
+		p_free (loader);
+		return NULL;
+	}
+
 	loader->handle      = handle;
 	loader->last_status = B_OK;
 
@@ -77,11 +90,17 @@ P_LIB_API PFuncAddr
 p_library_loader_get_symbol (PLibraryLoader *loader, const pchar *sym)
 {
 	ppointer	location = NULL;
+	PFuncAddr	addr;
 	status_t	status;
 
 	if (P_UNLIKELY (loader == NULL || sym == NULL))
 		return NULL;
 
+	if (p_library_loader_cache_lookup (loader->symbols, sym, &addr) == TRUE) {
+		loader->last_status = B_OK;
+		return addr;
+	}
+
 	if (P_UNLIKELY ((status = get_image_symbol (loader->handle,
 						    (pchar *) sym,
 						    B_SYMBOL_TYPE_ANY,
@@ -93,6 +112,9 @@ p_library_loader_get_symbol (PLibraryLoader *loader, const pchar *sym)
 
 	loader->last_status = B_OK;
 
+	if (location != NULL)
+		p_library_loader_cache_insert (loader->symbols, sym, (PFuncAddr) location);
+
 	return (PFuncAddr) location;
 }
 
@@ -104,6 +126,7 @@ p_library_loader_free (PLibraryLoader *loader)
 
 	pp_library_loader_clean_handle (loader->handle);
 
+	p_concurrent_hash_table_free (loader->symbols);
 	p_free (loader);
 }
 
@@ -26,9 +26,13 @@
 #include "plibraryloader.h"
 
 P_LIB_API PLibraryLoader *
-p_library_loader_new (const pchar *path)
+p_library_loader_new_with_flags (const pchar	*path,
+				 pint		flags)
 {
-	P_ERROR ("PLibraryLoader::p_library_loader_new: not implemented");
+	P_UNUSED (path);
+	P_UNUSED (flags);
+
+	P_ERROR ("PLibraryLoader::p_library_loader_new_with_flags: not implemented");
 	return NULL;
 }
 
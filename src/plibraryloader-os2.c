@@ -26,6 +26,7 @@
 #include "perror.h"
 #include "pfile.h"
 #include "plibraryloader.h"
+#include "plibraryloader-private.h"
 #include "pmem.h"
 #include "pstring.h"
 
@@ -36,8 +37,9 @@
 typedef HMODULE plibrary_handle;
 
 struct PLibraryLoader_ {
-	plibrary_handle	handle;
-	APIRET		last_error;
+	plibrary_handle		handle;
+	PConcurrentHashTable	*symbols;
+	APIRET			last_error;
 };
 
 static void pp_library_loader_clean_handle (plibrary_handle handle);
@@ -55,13 +57,16 @@ pp_library_loader_clean_handle (plibrary_handle handle)
 }
 
 P_LIB_API PLibraryLoader *
-p_library_loader_new (const pchar *path)
+p_library_loader_new_with_flags (const pchar	*path,
+				 pint		flags)
 {
 	PLibraryLoader	*loader = NULL;
 	plibrary_handle	handle  = NULLHANDLE;
 	UCHAR		load_err[256];
 	APIRET		ulrc;
 
+	/* Modules are always bound at the loading time */
+	P_UNUSED (flags);
 
 	if (!p_file_is_exists (path))
 		return NULL;
@@ -73,16 +78,23 @@ p_library_loader_new (const pchar *path)
 		;
 
 	if (P_UNLIKELY (ulrc != NO_ERROR)) {
-		P_ERROR ("PLibraryLoader::p_library_loader_new: DosLoadModule() failed");
+		P_ERROR ("PLibraryLoader::p_library_loader_new_with_flags: DosLoadModule() failed");
 		return NULL;
 	}
 
 	if (P_UNLIKELY ((loader = p_malloc0 (sizeof (PLibraryLoader))) == NULL)) {
-		P_ERROR ("PLibraryLoader::p_library_loader_new: failed to allocate memory");
+		P_ERROR ("PLibraryLoader::p_library_loader_new_with_flags: failed(1) to allocate memory");
 		pp_library_loader_clean_handle (handle);
 		return NULL;
 	}
 
+	if (P_UNLIKELY ((loader->symbols = p_library_loader_cache_new ()) == NULL)) {
+		P_ERROR ("PLibraryLoader::p_library_loader_new_with_flags: failed(2) to allocate memory");
+		pp_library_loader_clean_handle (handle);
+		p_free (loader);
+		return NULL;
+	}
+
 	loader->handle     = handle;
 	loader->last_error = NO_ERROR;
 
@@ -92,12 +104,18 @@ p_library_loader_new (const pchar *path)
 P_LIB_API PFuncAddr
 p_library_loader_get_symbol (PLibraryLoader *loader, const pchar *sym)
 {
-	PFN	func_addr = NULL;
-	APIRET	ulrc;
+	PFN		func_addr = NULL;
+	PFuncAddr	addr;
+	APIRET		ulrc;
 
 	if (P_UNLIKELY (loader == NULL || sym == NULL || loader->handle == NULL))
 		return NULL;
 
+	if (p_library_loader_cache_lookup (loader->symbols, sym, &addr) == TRUE) {
+		loader->last_error = NO_ERROR;
+		return addr;
+	}
+
 	if (P_UNLIKELY ((ulrc = DosQueryProcAddr (loader->handle, 0, (PSZ) sym, &func_addr)) != NO_ERROR)) {
 		P_ERROR ("PLibraryLoader::p_library_loader_get_symbol: DosQueryProcAddr() failed");
 		loader->last_error = ulrc;
@@ -106,6 +124,9 @@ p_library_loader_get_symbol (PLibraryLoader *loader, const pchar *sym)
 
 	loader->last_error = NO_ERROR;
 
+	if (func_addr != NULL)
+		p_library_loader_cache_insert (loader->symbols, sym, (PFuncAddr) func_addr);
+
 	return (PFuncAddr) func_addr;
 }
 
@@ -117,6 +138,7 @@ p_library_loader_free (PLibraryLoader *loader)
 
 	pp_library_loader_clean_handle (loader->handle);
 
+	p_concurrent_hash_table_free (loader->symbols);
 	p_free (loader);
 }
 
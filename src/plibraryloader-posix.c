@@ -26,6 +26,7 @@
 #include "perror.h"
 #include "pfile.h"
 #include "plibraryloader.h"
+#include "plibraryloader-private.h"
 #include "pmem.h"
 #include "pstring.h"
 
@@ -43,7 +44,8 @@
 typedef ppointer plibrary_handle;
 
 struct PLibraryLoader_ {
-	plibrary_handle	handle;
+	plibrary_handle		handle;
+	PConcurrentHashTable	*symbols;
 };
 
 static void pp_library_loader_clean_handle (plibrary_handle handle);
@@ -56,10 +58,12 @@ pp_library_loader_clean_handle (plibrary_handle handle)
 }
 
 P_LIB_API PLibraryLoader *
-p_library_loader_new (const pchar *path)
+p_library_loader_new_with_flags (const pchar	*path,
+				 pint		flags)
 {
 	PLibraryLoader	*loader = NULL;
 	plibrary_handle	handle;
+	pint		dl_flags;
 #if defined (P_OS_FREEBSD) || defined (P_OS_DRAGONFLY)
 	struct stat	stat_buf;
 #endif
@@ -69,27 +73,43 @@ p_library_loader_new (const pchar *path)
 
 #if defined (P_OS_FREEBSD) || defined (P_OS_DRAGONFLY)
 	if (P_UNLIKELY (stat (path, &stat_buf) != 0)) {
-		P_ERROR ("PLibraryLoader::p_library_loader_new: stat() failed");
+		P_ERROR ("PLibraryLoader::p_library_loader_new_with_flags: stat() failed");
 		return NULL;
 	}
 
 	if (P_UNLIKELY (stat_buf.st_size == 0)) {
-		P_ERROR ("PLibraryLoader::p_library_loader_new: unable to handle zero-size file");
+		P_ERROR ("PLibraryLoader::p_library_loader_new_with_flags: unable to handle zero-size file");
 		return NULL;
 	}
 #endif
 
-	if (P_UNLIKELY ((handle = dlopen (path, RTLD_NOW)) == NULL)) {
-		P_ERROR ("PLibraryLoader::p_library_loader_new: dlopen() failed");
+	dl_flags = (flags & P_LIBRARY_LOADER_FLAG_LAZY) ? RTLD_LAZY : RTLD_NOW;
+
+	if (flags & P_LIBRARY_LOADER_FLAG_GLOBAL)
+		dl_flags |= RTLD_GLOBAL;
+#ifdef RTLD_LOCAL
+	else
+		dl_flags |= RTLD_LOCAL;
+#endif
+
+	if (P_UNLIKELY ((handle = dlopen (path, dl_flags)) == NULL)) {
+		P_ERROR ("PLibraryLoader::p_library_loader_new_with_flags: dlopen() failed");
 		return NULL;
 	}
 
 	if (P_UNLIKELY ((loader = p_malloc0 (sizeof (PLibraryLoader))) == NULL)) {
-		P_ERROR ("PLibraryLoader::p_library_loader_new: failed to allocate memory");
+		P_ERROR ("PLibraryLoader::p_library_loader_new_with_flags: failed(1) to allocate memory");
 		pp_library_loader_clean_handle (handle);
 		return NULL;
 	}
 
+	if (P_UNLIKELY ((loader->symbols = p_library_loader_cache_new ()) == NULL)) {
+		P_ERROR ("PLibraryLoader::p_library_loader_new_with_flags: failed(2) to allocate memory");
+		pp_library_loader_clean_handle (handle);
+		p_free (loader);
+		return NULL;
+	}
+
 	loader->handle = handle;
 
 	return loader;
@@ -98,10 +118,18 @@ p_library_loader_new (const pchar *path)
 P_LIB_API PFuncAddr
 p_library_loader_get_symbol (PLibraryLoader *loader, const pchar *sym)
 {
+	PFuncAddr addr;
+
 	if (P_UNLIKELY (loader == NULL || sym == NULL || loader->handle == NULL))
 		return NULL;
 
-	return (PFuncAddr) dlsym (loader->handle, sym);
+	if (p_library_loader_cache_lookup (loader->symbols, sym, &addr) == TRUE)
+		return addr;
+
+	if ((addr = (PFuncAddr) dlsym (loader->handle, sym)) != NULL)
+		p_library_loader_cache_insert (loader->symbols, sym, addr);
+
+	return addr;
 }
 
 P_LIB_API void
@@ -112,6 +140,7 @@ p_library_loader_free (PLibraryLoader *loader)
 
 	pp_library_loader_clean_handle (loader->handle);
 
+	p_concurrent_hash_table_free (loader->symbols);
 	p_free (loader);
 }
 
@@ -0,0 +1,75 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PLIBRARYLOADER_PRIVATE_H
+#define PLIBSYS_HEADER_PLIBRARYLOADER_PRIVATE_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+#include "pconcurrenthashtable.h"
+#include "plibraryloader.h"
+
+P_BEGIN_DECLS
+
+/**
+ * @brief Creates a cache for the resolved symbols of a shared library.
+ * @return Newly created cache in case of success, NULL otherwise.
+ * @note Free with p_concurrent_hash_table_free() after usage.
+ *
+ * Lookups in the cache are lock-free, so it can be shared by all the threads
+ * using the same loader.
+ */
+PConcurrentHashTable * p_library_loader_cache_new (void);
+
+/**
+ * @brief Looks for a previously resolved symbol in the cache.
+ * @param cache Symbol cache.
+ * @param sym Name of the symbol.
+ * @param[out] addr Pointer to store the symbol address into.
+ * @return TRUE if the symbol was found in the cache, FALSE otherwise.
+ */
+pboolean p_library_loader_cache_lookup (PConcurrentHashTable	*cache,
+					const pchar		*sym,
+					PFuncAddr		*addr);
+
+/**
+ * @brief Puts a resolved symbol into the cache.
+ * @param cache Symbol cache.
+ * @param sym Name of the symbol, it is copied.
+ * @param addr Address of the symbol.
+ *
+ * Failures are silently ignored, the symbol would be resolved again next time.
+ */
+void p_library_loader_cache_insert (PConcurrentHashTable	*cache,
+				    const pchar			*sym,
+				    PFuncAddr			addr);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PLIBRARYLOADER_PRIVATE_H */
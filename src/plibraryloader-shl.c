@@ -26,6 +26,7 @@
 #include "perror.h"
 #include "pfile.h"
 #include "plibraryloader.h"
+#include "plibraryloader-private.h"
 #include "pmem.h"
 #include "pstring.h"
 
@@ -36,8 +37,9 @@
 typedef shl_t plibrary_handle;
 
 struct PLibraryLoader_ {
-	plibrary_handle	handle;
-	int		last_error;
+	plibrary_handle		handle;
+	PConcurrentHashTable	*symbols;
+	int			last_error;
 };
 
 static void pp_library_loader_clean_handle (plibrary_handle handle);
@@ -50,22 +52,38 @@ pp_library_loader_clean_handle (plibrary_handle handle)
 }
 
 P_LIB_API PLibraryLoader *
-p_library_loader_new (const pchar *path)
+p_library_loader_new_with_flags (const pchar	*path,
+				 pint		flags)
 {
 	PLibraryLoader	*loader = NULL;
 	plibrary_handle	handle;
+	int		bind_flags;
 
 	if (!p_file_is_exists (path))
 		return NULL;
 
-	if (P_UNLIKELY ((handle = shl_load (path, BIND_IMMEDIATE | BIND_NONFATAL | DYNAMIC_PATH, 0)) == NULL)) {
-		P_ERROR ("PLibraryLoader::p_library_loader_new: shl_load() failed");
+	bind_flags  = (flags & P_LIBRARY_LOADER_FLAG_LAZY) ? BIND_DEFERRED : BIND_IMMEDIATE;
+	bind_flags |= BIND_NONFATAL | DYNAMIC_PATH;
+
+	/* Symbols of the explicitly loaded libraries are not visible to others */
+	if (flags & P_LIBRARY_LOADER_FLAG_GLOBAL)
+		P_WARNING ("PLibraryLoader::p_library_loader_new_with_flags: global binding is not supported");
+
+	if (P_UNLIKELY ((handle = shl_load (path, bind_flags, 0)) == NULL)) {
+		P_ERROR ("PLibraryLoader::p_library_loader_new_with_flags: shl_load() failed");
 		return NULL;
 	}
 
 	if (P_UNLIKELY ((loader = p_malloc0 (sizeof (PLibraryLoader))) == NULL)) {
-		P_ERROR ("PLibraryLoader::p_library_loader_new: failed to allocate memory");
+		P_ERROR ("PLibraryLoader::p_library_loader_new_with_flags: failed(1) to allocate memory");
+		pp_library_loader_clean_handle (handle);
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((loader->symbols = p_library_loader_cache_new ()) == NULL)) {
+		P_ERROR ("PLibraryLoader::p_library_loader_new_with_flags: failed(2) to allocate memory");
 		pp_library_loader_clean_handle (handle);
+		p_free (loader);
 		return NULL;
 	}
 
@@ -83,6 +101,11 @@ p_library_loader_get_symbol (PLibraryLoader *loader, const pchar *sym)
 	if (P_UNLIKELY (loader == NULL || sym == NULL || loader->handle == NULL))
 		return NULL;
 
+	if (p_library_loader_cache_lookup (loader->symbols, sym, &func_addr) == TRUE) {
+		loader->last_error = 0;
+		return func_addr;
+	}
+
 	if (P_UNLIKELY (shl_findsym (&loader->handle, sym, TYPE_UNDEFINED, (ppointer) &func_addr) != 0)) {
 		P_ERROR ("PLibraryLoader::p_library_loader_get_symbol: shl_findsym() failed");
 		loader->last_error = (errno == 0 ? -1 : errno);
@@ -91,6 +114,9 @@ p_library_loader_get_symbol (PLibraryLoader *loader, const pchar *sym)
 
 	loader->last_error = 0;
 
+	if (func_addr != NULL)
+		p_library_loader_cache_insert (loader->symbols, sym, func_addr);
+
 	return func_addr;
 }
 
@@ -102,6 +128,7 @@ p_library_loader_free (PLibraryLoader *loader)
 
 	pp_library_loader_clean_handle (loader->handle);
 
+	p_concurrent_hash_table_free (loader->symbols);
 	p_free (loader);
 }
 
@@ -26,13 +26,15 @@
 #include "perror.h"
 #include "pfile.h"
 #include "plibraryloader.h"
+#include "plibraryloader-private.h"
 #include "pmem.h"
 #include "pstring.h"
 
 typedef HINSTANCE	plibrary_handle;
 
 struct PLibraryLoader_ {
-	plibrary_handle	handle;
+	plibrary_handle		handle;
+	PConcurrentHashTable	*symbols;
 };
 
 static void pp_library_loader_clean_handle (plibrary_handle handle);
@@ -45,25 +47,37 @@ pp_library_loader_clean_handle (plibrary_handle handle)
 }
 
 P_LIB_API PLibraryLoader *
-p_library_loader_new (const pchar *path)
+p_library_loader_new_with_flags (const pchar	*path,
+				 pint		flags)
 {
 	PLibraryLoader	*loader = NULL;
 	plibrary_handle	handle;
 
+	/* Imports are always bound at the loading time, and exports are looked up
+	 * per module, so there is nothing to tune */
+	P_UNUSED (flags);
+
 	if (!p_file_is_exists (path))
 		return NULL;
 
 	if (P_UNLIKELY ((handle = LoadLibraryA (path)) == NULL)) {
-		P_ERROR ("PLibraryLoader::p_library_loader_new: LoadLibraryA() failed");
+		P_ERROR ("PLibraryLoader::p_library_loader_new_with_flags: LoadLibraryA() failed");
 		return NULL;
 	}
 
 	if (P_UNLIKELY ((loader = p_malloc0 (sizeof (PLibraryLoader))) == NULL)) {
-		P_ERROR ("PLibraryLoader::p_library_loader_new: failed to allocate memory");
+		P_ERROR ("PLibraryLoader::p_library_loader_new_with_flags: failed(1) to allocate memory");
 		pp_library_loader_clean_handle (handle);
 		return NULL;
 	}
 
+	if (P_UNLIKELY ((loader->symbols = p_library_loader_cache_new ()) == NULL)) {
+		P_ERROR ("PLibraryLoader::p_library_loader_new_with_flags: failed(2) to allocate memory");
+		pp_library_loader_clean_handle (handle);
+		p_free (loader);
+		return NULL;
+	}
+
 	loader->handle = handle;
 
 	return loader;
@@ -77,7 +91,11 @@ p_library_loader_get_symbol (PLibraryLoader *loader, const pchar *sym)
 	if (P_UNLIKELY (loader == NULL || sym == NULL || loader->handle == NULL))
 		return NULL;
 
-	ret_sym = (PFuncAddr) GetProcAddress (loader->handle, sym);
+	if (p_library_loader_cache_lookup (loader->symbols, sym, &ret_sym) == TRUE)
+		return ret_sym;
+
+	if ((ret_sym = (PFuncAddr) GetProcAddress (loader->handle, sym)) != NULL)
+		p_library_loader_cache_insert (loader->symbols, sym, ret_sym);
 
 	return ret_sym;
 }
@@ -90,6 +108,7 @@ p_library_loader_free (PLibraryLoader *loader)
 
 	pp_library_loader_clean_handle (loader->handle);
 
+	p_concurrent_hash_table_free (loader->symbols);
 	p_free (loader);
 }
 
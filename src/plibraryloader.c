@@ -0,0 +1,95 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "phashtable.h"
+#include "plibraryloader.h"
+#include "plibraryloader-private.h"
+#include "pmem.h"
+#include "pstring.h"
+
+P_LIB_API PLibraryLoader *
+p_library_loader_new (const pchar *path)
+{
+	return p_library_loader_new_with_flags (path, P_LIBRARY_LOADER_FLAG_DEFAULT);
+}
+
+P_LIB_API pssize
+p_library_loader_get_symbols (PLibraryLoader	*loader,
+			      const pchar	**syms,
+			      PFuncAddr		*addrs,
+			      psize		count)
+{
+	pssize	resolved = 0;
+	psize	i;
+
+	if (P_UNLIKELY (loader == NULL || syms == NULL || addrs == NULL))
+		return -1;
+
+	for (i = 0; i < count; ++i) {
+		if ((addrs[i] = p_library_loader_get_symbol (loader, syms[i])) != NULL)
+			++resolved;
+	}
+
+	return resolved;
+}
+
+PConcurrentHashTable *
+p_library_loader_cache_new (void)
+{
+	return p_concurrent_hash_table_new_read_mostly (p_str_hash,
+							p_str_equal,
+							(PDestroyFunc) p_free,
+							NULL);
+}
+
+pboolean
+p_library_loader_cache_lookup (PConcurrentHashTable	*cache,
+			       const pchar		*sym,
+			       PFuncAddr		*addr)
+{
+	ppointer value;
+
+	if ((value = p_concurrent_hash_table_lookup (cache, sym)) == (ppointer) -1)
+		return FALSE;
+
+	*addr = (PFuncAddr) value;
+
+	return TRUE;
+}
+
+void
+p_library_loader_cache_insert (PConcurrentHashTable	*cache,
+			       const pchar		*sym,
+			       PFuncAddr		addr)
+{
+	pchar *key;
+
+	if (P_UNLIKELY ((key = p_strdup (sym)) == NULL))
+		return;
+
+	/* Another thread may have resolved the same symbol meanwhile */
+	if (p_concurrent_hash_table_lookup_or_insert (cache, key, (ppointer) addr) != (ppointer) -1)
+		p_free (key);
+}
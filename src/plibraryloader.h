@@ -48,6 +48,20 @@
  * p_library_loader_get_symbol() to retrieve a pointer to a symbol within it.
  * Close the library after usage with p_library_loader_free().
  *
+ * p_library_loader_new_with_flags() allows to choose when the symbols of the
+ * library are bound: all of them at the loading time (default), or each one on
+ * its first call, which makes loading of large libraries faster but moves the
+ * cost (and possible unresolved symbol failures) to the first calls. It also
+ * allows to make the library symbols available for resolution of the libraries
+ * loaded later. These flags are hints and are ignored where the platform has
+ * no such a notion (i.e. Windows always binds imports at the loading time).
+ *
+ * Every loader caches the successfully resolved symbols, so repeated lookups
+ * of the same name don't go to the system loader again. Plugin hosts which
+ * resolve a whole table of entry points at once can use
+ * p_library_loader_get_symbols() instead of calling
+ * p_library_loader_get_symbol() for each of them.
+ *
  * Please note the following platform specific differences:
  *
  * - HP-UX doesn't support loading libraries containing TLS and built with
@@ -82,6 +96,13 @@ typedef struct PLibraryLoader_ PLibraryLoader;
 /** Pointer to a function address. */
 typedef void (*PFuncAddr) (void);
 
+/** Flags controlling shared library loading. */
+typedef enum PLibraryLoaderFlags_ {
+	P_LIBRARY_LOADER_FLAG_DEFAULT	= 0,		/**< Bind all the symbols at once, keep them local.	*/
+	P_LIBRARY_LOADER_FLAG_LAZY	= 1 << 0,	/**< Bind function symbols on their first call.		*/
+	P_LIBRARY_LOADER_FLAG_GLOBAL	= 1 << 1	/**< Make the symbols available for other libraries.	*/
+} PLibraryLoaderFlags;
+
 /**
  * @brief Loads a shared library.
  * @param path Path to the shared library file.
@@ -95,6 +116,23 @@ typedef void (*PFuncAddr) (void);
  */
 P_LIB_API PLibraryLoader *	p_library_loader_new		(const pchar	*path);
 
+/**
+ * @brief Loads a shared library with the given binding flags.
+ * @param path Path to the shared library file.
+ * @param flags Loading flags, a bitwise combination of #PLibraryLoaderFlags.
+ * @return Pointer to #PLibraryLoader in case of success, NULL otherwise.
+ * @since 0.0.5
+ *
+ * With #P_LIBRARY_LOADER_FLAG_LAZY the loading is faster, but an unresolved
+ * function is reported only on its first call (usually by terminating the
+ * program) instead of failing the loading.
+ *
+ * Note that the library which is already loaded keeps its binding mode, only
+ * #P_LIBRARY_LOADER_FLAG_GLOBAL may be added to it on some platforms.
+ */
+P_LIB_API PLibraryLoader *	p_library_loader_new_with_flags	(const pchar	*path,
+								 pint		flags);
+
 /**
  * @brief Gets a pointer to a symbol in the loaded shared library.
  * @param loader Pointer to the loaded shared library handle.
@@ -109,6 +147,26 @@ P_LIB_API PLibraryLoader *	p_library_loader_new		(const pchar	*path);
 P_LIB_API PFuncAddr		p_library_loader_get_symbol	(PLibraryLoader	*loader,
 								 const pchar	*sym);
 
+/**
+ * @brief Gets pointers to several symbols in the loaded shared library.
+ * @param loader Pointer to the loaded shared library handle.
+ * @param syms Array of the symbol names.
+ * @param addrs Array to store the symbol pointers into, must have at least
+ * @a count elements.
+ * @param count Number of the symbols to resolve.
+ * @return Number of the resolved symbols, -1 in case of invalid input.
+ * @since 0.0.5
+ *
+ * Unresolved symbols are set to NULL in @a addrs, all the other symbols are
+ * still resolved. Compare the returned value with @a count to check whether
+ * all of them were found. Unlike p_library_loader_get_symbol(), the symbols
+ * with a NULL value are counted as unresolved.
+ */
+P_LIB_API pssize		p_library_loader_get_symbols	(PLibraryLoader	*loader,
+								 const pchar	**syms,
+								 PFuncAddr	*addrs,
+								 psize		count);
+
 /**
  * @brief Frees memory and allocated resources of #PLibraryLoader.
  * @param loader #PLibraryLoader object to free.
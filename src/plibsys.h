@@ -29,35 +29,96 @@
 #define PLIBSYS_H_INSIDE
 
 #include "plibsysconfig.h"
+#include "parray.h"
+#include "pbarrier.h"
+#include "pbitset.h"
+#include "pbloomfilter.h"
+#include "pcache.h"
 #include "patomic.h"
+#include "pconcurrenthashtable.h"
+#include "pconcurrenttree.h"
 #include "pcondvariable.h"
+#include "pcountdownlatch.h"
+#include "pcounter.h"
+#include "pcpufeatures.h"
+#include "pcputopology.h"
 #include "pcryptohash.h"
+#include "pcuckoofilter.h"
+#include "pdeadline.h"
+#include "pdeque.h"
 #include "pdir.h"
+#include "pdirwatcher.h"
+#include "pdistrwlock.h"
 #include "perror.h"
+#include "pevent.h"
+#include "peventloop.h"
+#include "pfasthash.h"
+#include "pfastmutex.h"
+#include "pfiber.h"
+#include "pfuture.h"
 #include "pfile.h"
 #include "phashtable.h"
+#include "pheap.h"
+#include "phistogram.h"
 #include "pinifile.h"
 #include "plibraryloader.h"
 #include "plist.h"
+#include "plocalsemaphore.h"
+#include "plockfreestack.h"
+#include "plockstats.h"
+#include "plog.h"
 #include "pmacros.h"
 #include "pmacroscompiler.h"
 #include "pmacroscpu.h"
 #include "pmacrosos.h"
 #include "pmain.h"
+#include "pmappedfile.h"
+#include "pmappedtable.h"
+#include "pmcslock.h"
 #include "pmem.h"
+#include "pmempool.h"
+#include "pmetrics.h"
 #include "pmutex.h"
+#include "ponce.h"
+#include "pparallel.h"
+#include "pperfcounters.h"
 #include "pprocess.h"
+#include "pqueuempmc.h"
+#include "pradixtree.h"
+#include "preclaim.h"
+#include "presolver.h"
+#include "pringspsc.h"
 #include "prwlock.h"
 #include "psemaphore.h"
+#include "pseqlock.h"
 #include "pshm.h"
+#include "pshmarena.h"
+#include "pshmbroadcast.h"
 #include "pshmbuffer.h"
+#include "pshmqueue.h"
+#include "pskiplist.h"
 #include "psocket.h"
 #include "psocketaddress.h"
+#include "psocketpoller.h"
+#include "psocketpool.h"
+#include "psocketasync.h"
+#include "psocketstream.h"
+#include "psort.h"
 #include "pspinlock.h"
 #include "pstdarg.h"
+#include "pstrhashtable.h"
 #include "pstring.h"
+#include "pstringbuilder.h"
+#include "pstringpool.h"
+#include "ptaskscheduler.h"
+#include "pthreadpool.h"
+#include "pticketlock.h"
 #include "ptimeprofiler.h"
+#include "ptimerwheel.h"
+#include "ptrace.h"
+#include "ptraceexporter.h"
 #include "ptree.h"
+#include "ptypedcontainers.h"
 #include "ptypes.h"
 #include "puthread.h"
 
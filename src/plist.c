@@ -27,6 +27,49 @@
 #include "plist.h"
 
 #include <stdlib.h>
+#include <string.h>
+
+/* Elements of a chunk are kept in data[start .. start + count) */
+struct PListChunk_ {
+	PListChunk	*next;
+	puint		start;
+	puint		count;
+	ppointer	data[P_LIST_UNROLLED_CHUNK_SIZE];
+};
+
+static PListChunk * pp_list_chunk_new (void);
+static void pp_list_unrolled_unlink (PListUnrolled *list, PListChunk *prev, PListChunk *chunk);
+
+static PListChunk *
+pp_list_chunk_new (void)
+{
+	PListChunk *chunk;
+
+	if (P_UNLIKELY ((chunk = p_malloc (sizeof (PListChunk))) == NULL))
+		return NULL;
+
+	chunk->next  = NULL;
+	chunk->start = 0;
+	chunk->count = 0;
+
+	return chunk;
+}
+
+static void
+pp_list_unrolled_unlink (PListUnrolled	*list,
+			 PListChunk	*prev,
+			 PListChunk	*chunk)
+{
+	if (prev == NULL)
+		list->first = chunk->next;
+	else
+		prev->next = chunk->next;
+
+	if (list->last == chunk)
+		list->last = prev;
+
+	p_free (chunk);
+}
 
 P_LIB_API PList *
 p_list_append (PList *list, ppointer data)
@@ -172,3 +215,401 @@ p_list_reverse	(PList *list)
 
 	return prev;
 }
+
+P_LIB_API void
+p_list_head_init (PListHead *head)
+{
+	if (P_UNLIKELY (head == NULL))
+		return;
+
+	head->first  = NULL;
+	head->last   = NULL;
+	head->length = 0;
+}
+
+P_LIB_API pboolean
+p_list_head_append (PListHead *head, ppointer data)
+{
+	PList *item;
+
+	if (P_UNLIKELY (head == NULL))
+		return FALSE;
+
+	if (P_UNLIKELY ((item = p_malloc0 (sizeof (PList))) == NULL)) {
+		P_ERROR ("PList::p_list_head_append: failed to allocate memory");
+		return FALSE;
+	}
+
+	item->data = data;
+
+	if (head->last == NULL)
+		head->first = item;
+	else
+		head->last->next = item;
+
+	head->last = item;
+	++head->length;
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_list_head_prepend (PListHead *head, ppointer data)
+{
+	PList *item;
+
+	if (P_UNLIKELY (head == NULL))
+		return FALSE;
+
+	if (P_UNLIKELY ((item = p_malloc0 (sizeof (PList))) == NULL)) {
+		P_ERROR ("PList::p_list_head_prepend: failed to allocate memory");
+		return FALSE;
+	}
+
+	item->data = data;
+	item->next = head->first;
+
+	if (head->last == NULL)
+		head->last = item;
+
+	head->first = item;
+	++head->length;
+
+	return TRUE;
+}
+
+P_LIB_API ppointer
+p_list_head_pop (PListHead *head)
+{
+	PList		*item;
+	ppointer	ret;
+
+	if (P_UNLIKELY (head == NULL || head->first == NULL))
+		return NULL;
+
+	item        = head->first;
+	ret         = item->data;
+	head->first = item->next;
+
+	if (head->first == NULL)
+		head->last = NULL;
+
+	--head->length;
+
+	p_free (item);
+
+	return ret;
+}
+
+P_LIB_API psize
+p_list_head_length (const PListHead *head)
+{
+	if (P_UNLIKELY (head == NULL))
+		return 0;
+
+	return head->length;
+}
+
+P_LIB_API PList *
+p_list_head_steal (PListHead *head)
+{
+	PList *ret;
+
+	if (P_UNLIKELY (head == NULL))
+		return NULL;
+
+	ret = head->first;
+
+	p_list_head_init (head);
+
+	return ret;
+}
+
+P_LIB_API void
+p_list_head_clear (PListHead *head)
+{
+	if (P_UNLIKELY (head == NULL))
+		return;
+
+	p_list_free (head->first);
+	p_list_head_init (head);
+}
+
+P_LIB_API void
+p_list_link_init (PListLink *link)
+{
+	if (P_UNLIKELY (link == NULL))
+		return;
+
+	link->next = link;
+	link->prev = link;
+}
+
+P_LIB_API void
+p_list_link_append (PListLink *head, PListLink *link)
+{
+	if (P_UNLIKELY (head == NULL || link == NULL))
+		return;
+
+	link->next       = head;
+	link->prev       = head->prev;
+	head->prev->next = link;
+	head->prev       = link;
+}
+
+P_LIB_API void
+p_list_link_prepend (PListLink *head, PListLink *link)
+{
+	if (P_UNLIKELY (head == NULL || link == NULL))
+		return;
+
+	link->next       = head->next;
+	link->prev       = head;
+	head->next->prev = link;
+	head->next       = link;
+}
+
+P_LIB_API void
+p_list_link_remove (PListLink *link)
+{
+	if (P_UNLIKELY (link == NULL))
+		return;
+
+	link->prev->next = link->next;
+	link->next->prev = link->prev;
+
+	p_list_link_init (link);
+}
+
+P_LIB_API pboolean
+p_list_link_is_empty (const PListLink *head)
+{
+	if (P_UNLIKELY (head == NULL))
+		return TRUE;
+
+	return head->next == head ? TRUE : FALSE;
+}
+
+P_LIB_API psize
+p_list_link_length (const PListLink *head)
+{
+	const PListLink	*cur_link;
+	psize		ret;
+
+	if (P_UNLIKELY (head == NULL))
+		return 0;
+
+	for (ret = 0, cur_link = head->next; cur_link != head; cur_link = cur_link->next)
+		++ret;
+
+	return ret;
+}
+
+P_LIB_API void
+p_list_unrolled_init (PListUnrolled *list)
+{
+	if (P_UNLIKELY (list == NULL))
+		return;
+
+	list->first  = NULL;
+	list->last   = NULL;
+	list->length = 0;
+}
+
+P_LIB_API pboolean
+p_list_unrolled_append (PListUnrolled *list, ppointer data)
+{
+	PListChunk *chunk;
+
+	if (P_UNLIKELY (list == NULL))
+		return FALSE;
+
+	chunk = list->last;
+
+	if (chunk != NULL && chunk->start + chunk->count == P_LIST_UNROLLED_CHUNK_SIZE &&
+	    chunk->start > 0) {
+		/* There is room before the first element, move the elements there */
+		memmove (chunk->data, chunk->data + chunk->start, chunk->count * sizeof (ppointer));
+		chunk->start = 0;
+	}
+
+	if (chunk == NULL || chunk->start + chunk->count == P_LIST_UNROLLED_CHUNK_SIZE) {
+		if (P_UNLIKELY ((chunk = pp_list_chunk_new ()) == NULL)) {
+			P_ERROR ("PList::p_list_unrolled_append: failed to allocate memory");
+			return FALSE;
+		}
+
+		if (list->last == NULL)
+			list->first = chunk;
+		else
+			list->last->next = chunk;
+
+		list->last = chunk;
+	}
+
+	chunk->data[chunk->start + chunk->count] = data;
+
+	++chunk->count;
+	++list->length;
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_list_unrolled_prepend (PListUnrolled *list, ppointer data)
+{
+	PListChunk *chunk;
+
+	if (P_UNLIKELY (list == NULL))
+		return FALSE;
+
+	chunk = list->first;
+
+	if (chunk != NULL && chunk->start == 0 && chunk->count < P_LIST_UNROLLED_CHUNK_SIZE) {
+		/* There is room after the last element, move the elements there */
+		chunk->start = P_LIST_UNROLLED_CHUNK_SIZE - chunk->count;
+		memmove (chunk->data + chunk->start, chunk->data, chunk->count * sizeof (ppointer));
+	}
+
+	if (chunk == NULL || chunk->start == 0) {
+		if (P_UNLIKELY ((chunk = pp_list_chunk_new ()) == NULL)) {
+			P_ERROR ("PList::p_list_unrolled_prepend: failed to allocate memory");
+			return FALSE;
+		}
+
+		/* Filled from the end, so the next prepends fit in the same chunk */
+		chunk->start = P_LIST_UNROLLED_CHUNK_SIZE;
+		chunk->next  = list->first;
+
+		if (list->last == NULL)
+			list->last = chunk;
+
+		list->first = chunk;
+	}
+
+	--chunk->start;
+	chunk->data[chunk->start] = data;
+
+	++chunk->count;
+	++list->length;
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_list_unrolled_remove (PListUnrolled *list, ppointer data)
+{
+	PListChunk	*chunk;
+	PListChunk	*prev;
+	PListChunk	*next;
+	puint		end;
+	puint		i;
+
+	if (P_UNLIKELY (list == NULL))
+		return FALSE;
+
+	for (prev = NULL, chunk = list->first; chunk != NULL; prev = chunk, chunk = chunk->next) {
+		end = chunk->start + chunk->count;
+
+		for (i = chunk->start; i < end && chunk->data[i] != data; ++i)
+			;
+
+		if (i == end)
+			continue;
+
+		/* Close the gap moving the shorter side */
+		if (i - chunk->start < end - i - 1) {
+			memmove (chunk->data + chunk->start + 1,
+				 chunk->data + chunk->start,
+				 (i - chunk->start) * sizeof (ppointer));
+			++chunk->start;
+		} else
+			memmove (chunk->data + i, chunk->data + i + 1, (end - i - 1) * sizeof (ppointer));
+
+		--chunk->count;
+		--list->length;
+
+		next = chunk->next;
+
+		if (chunk->count == 0)
+			pp_list_unrolled_unlink (list, prev, chunk);
+		else if (chunk->count < P_LIST_UNROLLED_CHUNK_SIZE / 4 &&
+			 next != NULL && chunk->count + next->count <= P_LIST_UNROLLED_CHUNK_SIZE) {
+			/* Merge the next chunk to keep the chunks dense */
+			memmove (chunk->data, chunk->data + chunk->start, chunk->count * sizeof (ppointer));
+			memcpy (chunk->data + chunk->count, next->data + next->start, next->count * sizeof (ppointer));
+
+			chunk->start  = 0;
+			chunk->count += next->count;
+
+			pp_list_unrolled_unlink (list, chunk, next);
+		}
+
+		return TRUE;
+	}
+
+	return FALSE;
+}
+
+P_LIB_API ppointer
+p_list_unrolled_pop (PListUnrolled *list)
+{
+	PListChunk	*chunk;
+	ppointer	ret;
+
+	if (P_UNLIKELY (list == NULL || list->first == NULL))
+		return NULL;
+
+	chunk = list->first;
+	ret   = chunk->data[chunk->start];
+
+	++chunk->start;
+	--chunk->count;
+	--list->length;
+
+	if (chunk->count == 0)
+		pp_list_unrolled_unlink (list, NULL, chunk);
+
+	return ret;
+}
+
+P_LIB_API void
+p_list_unrolled_foreach (const PListUnrolled *list, PFunc func, ppointer user_data)
+{
+	const PListChunk	*chunk;
+	puint			end;
+	puint			i;
+
+	if (P_UNLIKELY (list == NULL || func == NULL))
+		return;
+
+	for (chunk = list->first; chunk != NULL; chunk = chunk->next)
+		for (i = chunk->start, end = chunk->start + chunk->count; i < end; ++i)
+			func (chunk->data[i], user_data);
+}
+
+P_LIB_API psize
+p_list_unrolled_length (const PListUnrolled *list)
+{
+	if (P_UNLIKELY (list == NULL))
+		return 0;
+
+	return list->length;
+}
+
+P_LIB_API void
+p_list_unrolled_clear (PListUnrolled *list)
+{
+	PListChunk *chunk;
+	PListChunk *next;
+
+	if (P_UNLIKELY (list == NULL))
+		return;
+
+	for (chunk = list->first; chunk != NULL; chunk = next) {
+		next = chunk->next;
+		p_free (chunk);
+	}
+
+	p_list_unrolled_init (list);
+}
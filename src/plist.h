@@ -74,7 +74,44 @@
  * p_list_remove() will remove only the first matching node.
  *
  * If you need to add large amount of nodes at once it is better to prepend them
- * and then reverse the list.
+ * and then reverse the list, or use a #PListHead.
+ *
+ * #PListHead tracks the first and the last nodes of a list along with its
+ * length, so appending, prepending, popping and getting the length take O(1)
+ * constant time. It doesn't require any allocations by itself and can be
+ * placed on the stack:
+ * @code
+ * PListHead   head;
+ * PList       *list;
+ *
+ * p_list_head_init (&head);
+ *
+ * p_list_head_append (&head, P_INT_TO_POINTER (1));
+ * p_list_head_append (&head, P_INT_TO_POINTER (2));
+ *
+ * list = p_list_head_steal (&head);
+ * @endcode
+ * The nodes are regular #PList nodes, so the list can be traversed from the
+ * @a first field or taken with p_list_head_steal() and used with all the
+ * p_list_* routines.
+ *
+ * #PListUnrolled is an unrolled list: each node (a chunk) holds up to
+ * #P_LIST_UNROLLED_CHUNK_SIZE data pointers next to each other. It has the
+ * same append, prepend, remove and foreach semantics as #PListHead, but takes
+ * only a couple of bytes of overhead per element instead of a whole node, and
+ * p_list_unrolled_foreach() reads the memory mostly sequentially, one cache
+ * miss per chunk instead of one per element. Like #PListHead, it can be placed
+ * on the stack:
+ * @code
+ * PListUnrolled   list;
+ *
+ * p_list_unrolled_init (&list);
+ *
+ * p_list_unrolled_append (&list, P_INT_TO_POINTER (1));
+ * p_list_unrolled_foreach (&list, (PFunc) my_func, my_data);
+ *
+ * p_list_unrolled_clear (&list);
+ * @endcode
  */
 
 #if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
@@ -98,6 +135,43 @@ struct PList_ {
 	PList		*next;	/**< Next list node.		*/
 };
 
+/** Head of a singly linked list with a tail pointer and length. */
+typedef struct PListHead_ {
+	PList	*first;		/**< First list node, NULL if empty.	*/
+	PList	*last;		/**< Last list node, NULL if empty.	*/
+	psize	length;		/**< Number of nodes in the list.	*/
+} PListHead;
+
+/** Number of the data pointers in a #PListUnrolled chunk. */
+#define P_LIST_UNROLLED_CHUNK_SIZE	14
+
+/** Chunk of an unrolled list, opaque data type. */
+typedef struct PListChunk_ PListChunk;
+
+/** Unrolled list, the fields are private. */
+typedef struct PListUnrolled_ {
+	PListChunk	*first;		/**< First chunk, NULL if empty.	*/
+	PListChunk	*last;		/**< Last chunk, NULL if empty.		*/
+	psize		length;		/**< Number of elements in the list.	*/
+} PListUnrolled;
+
+/**
+ * @brief Link of an intrusive circular doubly linked list.
+ * @since 0.0.5
+ *
+ * The link is intended to be embedded into a user structure, use
+ * #P_CONTAINER_OF to get the structure back from the link. The list itself
+ * is represented by a standalone link, the head, so an empty list is a head
+ * linked to itself. Walk the list with:
+ * @code
+ * for (link = head.next; link != &head; link = link->next)
+ * @endcode
+ */
+typedef struct PListLink_ {
+	struct PListLink_	*next;	/**< Next link, the head after the last one.		*/
+	struct PListLink_	*prev;	/**< Previous link, the head before the first one.	*/
+} PListLink;
+
 /**
  * @brief Appends data to a list.
  * @param list #PList for appending the data.
@@ -194,6 +268,227 @@ P_LIB_API PList *	p_list_prepend	(PList		*list,
  */
 P_LIB_API PList *	p_list_reverse	(PList		*list) P_GNUC_WARN_UNUSED_RESULT;
 
+/**
+ * @brief Initializes a list head.
+ * @param head List head to initialize.
+ * @since 0.0.5
+ *
+ * The head is initialized with an empty list.
+ */
+P_LIB_API void		p_list_head_init	(PListHead	*head);
+
+/**
+ * @brief Appends data to a list head.
+ * @param head Initialized list head.
+ * @param data Data to append.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * This call takes O(1) constant time.
+ */
+P_LIB_API pboolean	p_list_head_append	(PListHead	*head,
+						 ppointer	data);
+
+/**
+ * @brief Prepends data to a list head.
+ * @param head Initialized list head.
+ * @param data Data to prepend.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_list_head_prepend	(PListHead	*head,
+						 ppointer	data);
+
+/**
+ * @brief Removes the first node from a list head.
+ * @param head Initialized list head.
+ * @return Data of the removed node, NULL if the list is empty.
+ * @since 0.0.5
+ *
+ * Use p_list_head_length() to distinguish an empty list from the NULL data.
+ */
+P_LIB_API ppointer	p_list_head_pop		(PListHead	*head);
+
+/**
+ * @brief Gets the number of nodes in a list head.
+ * @param head Initialized list head.
+ * @return Number of nodes in the list.
+ * @since 0.0.5
+ *
+ * Unlike p_list_length(), this call takes O(1) constant time.
+ */
+P_LIB_API psize		p_list_head_length	(const PListHead	*head);
+
+/**
+ * @brief Takes the list from a list head.
+ * @param head Initialized list head.
+ * @return The list stored in the head, NULL if it is empty.
+ * @since 0.0.5
+ *
+ * The head is left empty, the caller owns the returned list and should free
+ * it with p_list_free() after usage.
+ */
+P_LIB_API PList *	p_list_head_steal	(PListHead	*head) P_GNUC_WARN_UNUSED_RESULT;
+
+/**
+ * @brief Frees all the nodes of a list head.
+ * @param head Initialized list head.
+ * @since 0.0.5
+ *
+ * Only the list's internal memory is freed, not the data stored in the nodes.
+ * The head is left empty and can be used again.
+ */
+P_LIB_API void		p_list_head_clear	(PListHead	*head);
+
+/**
+ * @brief Initializes an intrusive list head or a standalone link.
+ * @param link Link to initialize.
+ * @since 0.0.5
+ *
+ * The link is linked to itself, so it's an empty list head.
+ */
+P_LIB_API void		p_list_link_init	(PListLink	*link);
+
+/**
+ * @brief Appends a link to an intrusive list.
+ * @param head Initialized list head.
+ * @param link Link to append, must not be in any list.
+ * @since 0.0.5
+ *
+ * No memory is allocated, this call takes O(1) constant time.
+ */
+P_LIB_API void		p_list_link_append	(PListLink	*head,
+						 PListLink	*link);
+
+/**
+ * @brief Prepends a link to an intrusive list.
+ * @param head Initialized list head.
+ * @param link Link to prepend, must not be in any list.
+ * @since 0.0.5
+ */
+P_LIB_API void		p_list_link_prepend	(PListLink	*head,
+						 PListLink	*link);
+
+/**
+ * @brief Removes a link from the intrusive list it's in.
+ * @param link Link to remove.
+ * @since 0.0.5
+ *
+ * The list head is not needed, this call takes O(1) constant time. The link
+ * is left linked to itself, so removing it again does nothing.
+ */
+P_LIB_API void		p_list_link_remove	(PListLink	*link);
+
+/**
+ * @brief Checks whether an intrusive list is empty.
+ * @param head Initialized list head.
+ * @return TRUE if the list has no links, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_list_link_is_empty	(const PListLink	*head);
+
+/**
+ * @brief Counts the links of an intrusive list.
+ * @param head Initialized list head.
+ * @return Number of the links in the list.
+ * @since 0.0.5
+ * @note This call takes O(N) time.
+ */
+P_LIB_API psize		p_list_link_length	(const PListLink	*head);
+
+/**
+ * @brief Initializes an unrolled list.
+ * @param list Unrolled list to initialize.
+ * @since 0.0.5
+ *
+ * The list is initialized empty, no memory is allocated.
+ */
+P_LIB_API void		p_list_unrolled_init	(PListUnrolled	*list);
+
+/**
+ * @brief Appends data to an unrolled list.
+ * @param list Initialized unrolled list.
+ * @param data Data to append.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * This call takes O(1) constant time, a new chunk is allocated only when the
+ * last one is full.
+ */
+P_LIB_API pboolean	p_list_unrolled_append	(PListUnrolled	*list,
+						 ppointer	data);
+
+/**
+ * @brief Prepends data to an unrolled list.
+ * @param list Initialized unrolled list.
+ * @param data Data to prepend.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * This call takes O(1) constant time, a new chunk is allocated only when the
+ * first one has no room before its first element.
+ */
+P_LIB_API pboolean	p_list_unrolled_prepend	(PListUnrolled	*list,
+						 ppointer	data);
+
+/**
+ * @brief Removes data from an unrolled list.
+ * @param list Initialized unrolled list.
+ * @param data Data to remove.
+ * @return TRUE if the data was found and removed, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * Only the first matching element is removed. A chunk which becomes less than
+ * a quarter full is merged with the next one when it fits.
+ */
+P_LIB_API pboolean	p_list_unrolled_remove	(PListUnrolled	*list,
+						 ppointer	data);
+
+/**
+ * @brief Removes the first element from an unrolled list.
+ * @param list Initialized unrolled list.
+ * @return Data of the removed element, NULL if the list is empty.
+ * @since 0.0.5
+ *
+ * Use p_list_unrolled_length() to distinguish an empty list from the NULL
+ * data.
+ */
+P_LIB_API ppointer	p_list_unrolled_pop	(PListUnrolled	*list);
+
+/**
+ * @brief Calls a specified function for each element of an unrolled list.
+ * @param list Initialized unrolled list.
+ * @param func Pointer for the callback function.
+ * @param user_data User defined data, may be NULL.
+ * @since 0.0.5
+ *
+ * The elements are passed in the list order. The list must not be modified
+ * from @a func.
+ */
+P_LIB_API void		p_list_unrolled_foreach	(const PListUnrolled	*list,
+						 PFunc			func,
+						 ppointer		user_data);
+
+/**
+ * @brief Gets the number of elements in an unrolled list.
+ * @param list Initialized unrolled list.
+ * @return Number of elements in the list.
+ * @since 0.0.5
+ *
+ * This call takes O(1) constant time.
+ */
+P_LIB_API psize		p_list_unrolled_length	(const PListUnrolled	*list);
+
+/**
+ * @brief Frees all the chunks of an unrolled list.
+ * @param list Initialized unrolled list.
+ * @since 0.0.5
+ *
+ * Only the list's internal memory is freed, not the data stored in it. The
+ * list is left empty and can be used again.
+ */
+P_LIB_API void		p_list_unrolled_clear	(PListUnrolled	*list);
+
 P_END_DECLS
 
 #endif /* PLIBSYS_HEADER_PLIST_H */
@@ -0,0 +1,175 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* The counter holds the available units, a thread which finds none registers
+ * in n_waiters and only then checks the counter again before sleeping on it,
+ * while a releasing thread increases the counter and only then checks
+ * n_waiters. So either the sleeper sees the new units or it is woken up, and
+ * p_atomic_int_wait() doesn't sleep if the counter is not zero anymore. */
+
+#include "patomic.h"
+#include "plocalsemaphore.h"
+#include "pmem.h"
+#include "ptimeprofiler.h"
+
+struct PLocalSemaphore_ {
+	volatile pint	count;
+	volatile pint	n_waiters;
+};
+
+static pboolean pp_local_semaphore_try_take (PLocalSemaphore *sem);
+
+static pboolean
+pp_local_semaphore_try_take (PLocalSemaphore *sem)
+{
+	pint count;
+
+	while ((count = p_atomic_int_get (&sem->count)) > 0) {
+		if (p_atomic_int_compare_and_exchange (&sem->count, count, count - 1) == TRUE)
+			return TRUE;
+	}
+
+	return FALSE;
+}
+
+P_LIB_API PLocalSemaphore *
+p_local_semaphore_new (pint init_val)
+{
+	PLocalSemaphore *ret;
+
+	if (P_UNLIKELY (init_val < 0))
+		return NULL;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PLocalSemaphore))) == NULL)) {
+		P_ERROR ("PLocalSemaphore::p_local_semaphore_new: failed to allocate memory");
+		return NULL;
+	}
+
+	p_atomic_int_set (&ret->count, init_val);
+
+	return ret;
+}
+
+P_LIB_API pboolean
+p_local_semaphore_acquire (PLocalSemaphore *sem)
+{
+	return p_local_semaphore_acquire_timed (sem, -1);
+}
+
+P_LIB_API pboolean
+p_local_semaphore_try_acquire (PLocalSemaphore *sem)
+{
+	if (P_UNLIKELY (sem == NULL))
+		return FALSE;
+
+	return pp_local_semaphore_try_take (sem);
+}
+
+P_LIB_API pboolean
+p_local_semaphore_acquire_timed (PLocalSemaphore	*sem,
+				 pint			timeout)
+{
+	puint64		deadline = 0;
+	puint64		now;
+	pint		wait_time;
+	pboolean	ret      = FALSE;
+
+	if (P_UNLIKELY (sem == NULL || timeout < -1))
+		return FALSE;
+
+	if (P_LIKELY (pp_local_semaphore_try_take (sem) == TRUE))
+		return TRUE;
+
+	if (timeout == 0)
+		return FALSE;
+
+	if (timeout > 0)
+		deadline = p_time_coarse_now_msecs () + (puint64) timeout;
+
+	p_atomic_int_inc (&sem->n_waiters);
+
+	for (;;) {
+		if (pp_local_semaphore_try_take (sem) == TRUE) {
+			ret = TRUE;
+			break;
+		}
+
+		wait_time = -1;
+
+		if (timeout > 0) {
+			if ((now = p_time_coarse_now_msecs ()) >= deadline)
+				break;
+
+			wait_time = (pint) (deadline - now);
+		}
+
+		/* Returns at once if a unit has been released meanwhile */
+		p_atomic_int_wait (&sem->count, 0, wait_time);
+	}
+
+	p_atomic_int_add (&sem->n_waiters, -1);
+
+	return ret;
+}
+
+P_LIB_API pboolean
+p_local_semaphore_release (PLocalSemaphore	*sem,
+			   pint			count)
+{
+	pint value;
+
+	if (P_UNLIKELY (sem == NULL || count <= 0))
+		return FALSE;
+
+	do {
+		if (P_UNLIKELY ((value = p_atomic_int_get (&sem->count)) > P_MAXINT32 - count))
+			return FALSE;
+	} while (p_atomic_int_compare_and_exchange (&sem->count, value, value + count) == FALSE);
+
+	if (p_atomic_int_get (&sem->n_waiters) == 0)
+		return TRUE;
+
+	if (count == 1)
+		p_atomic_int_notify_one (&sem->count);
+	else
+		p_atomic_int_notify_all (&sem->count);
+
+	return TRUE;
+}
+
+P_LIB_API pint
+p_local_semaphore_get_value (const PLocalSemaphore *sem)
+{
+	if (P_UNLIKELY (sem == NULL))
+		return 0;
+
+	return p_atomic_int_get (&sem->count);
+}
+
+P_LIB_API void
+p_local_semaphore_free (PLocalSemaphore *sem)
+{
+	p_free (sem);
+}
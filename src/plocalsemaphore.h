@@ -0,0 +1,125 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file plocalsemaphore.h
+ * @brief Unnamed in-process semaphore
+ * @author Alexander Saprykin
+ *
+ * A local semaphore is a counting semaphore (see psemaphore.h for the idea)
+ * shared by the threads of a single process only. It has no name and needs
+ * no system-wide object, so there is nothing to clean up after a crash, and
+ * it suits the in-process producer-consumer queues and bounded buffers best.
+ *
+ * The counter lives in user space: acquiring an available unit and releasing
+ * a unit nobody waits for are single atomic operations. A thread which finds
+ * no units sleeps with p_atomic_int_wait(), on a futex on Linux and on
+ * WaitOnAddress() on Windows 8 and newer, and a release makes a system call
+ * only if there are sleeping threads.
+ *
+ * The semaphore is not fair: a thread which has just arrived may take a unit
+ * before a sleeping one.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PLOCALSEMAPHORE_H
+#define PLIBSYS_HEADER_PLOCALSEMAPHORE_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+
+P_BEGIN_DECLS
+
+/** Local semaphore opaque data type. */
+typedef struct PLocalSemaphore_ PLocalSemaphore;
+
+/**
+ * @brief Creates a new local semaphore.
+ * @param init_val Initial number of available units.
+ * @return Pointer to #PLocalSemaphore in case of success, NULL otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API PLocalSemaphore *	p_local_semaphore_new		(pint			init_val);
+
+/**
+ * @brief Takes a unit, waits until one is available.
+ * @param sem #PLocalSemaphore to take the unit from.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean		p_local_semaphore_acquire	(PLocalSemaphore	*sem);
+
+/**
+ * @brief Takes a unit if one is available.
+ * @param sem #PLocalSemaphore to take the unit from.
+ * @return TRUE if the unit was taken, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean		p_local_semaphore_try_acquire	(PLocalSemaphore	*sem);
+
+/**
+ * @brief Takes a unit, waits for a limited time until one is available.
+ * @param sem #PLocalSemaphore to take the unit from.
+ * @param timeout Timeout in milliseconds, -1 to wait infinitely.
+ * @return TRUE if the unit was taken, FALSE on timeout or in case of error.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean		p_local_semaphore_acquire_timed	(PLocalSemaphore	*sem,
+								 pint			timeout);
+
+/**
+ * @brief Gives units back.
+ * @param sem #PLocalSemaphore to give the units to.
+ * @param count Number of units to give.
+ * @return TRUE in case of success, FALSE if @a count is not positive or the
+ * counter would overflow.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean		p_local_semaphore_release	(PLocalSemaphore	*sem,
+								 pint			count);
+
+/**
+ * @brief Gets the number of available units.
+ * @param sem #PLocalSemaphore to get the number for.
+ * @return Number of available units, it may change right after the call.
+ * @since 0.0.5
+ */
+P_LIB_API pint			p_local_semaphore_get_value	(const PLocalSemaphore	*sem);
+
+/**
+ * @brief Frees a local semaphore.
+ * @param sem #PLocalSemaphore to free.
+ * @since 0.0.5
+ *
+ * No thread may wait on the semaphore anymore.
+ */
+P_LIB_API void			p_local_semaphore_free		(PLocalSemaphore	*sem);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PLOCALSEMAPHORE_H */
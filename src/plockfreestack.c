@@ -0,0 +1,346 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* The top of the stack is a pair of the top node and a tag changed by every
+ * pop, swapped together by pp_lock_free_stack_cas(). A failed swap reloads
+ * the pair, so the callers just retry with the new values. Reading the pair
+ * in two halves may give a torn value, but then the swap fails and the loop
+ * gets a consistent one. Pushes don't change the tag: a stale push can't
+ * succeed anyway, the next links it sets are written again on retry. */
+
+#include "patomic.h"
+#include "pmem.h"
+#include "plockfreestack.h"
+
+#if defined (P_CC_GNU) && (defined (P_CPU_X86_64) || defined (P_CPU_ARM_64))
+#  define P_LOCK_FREE_STACK_DWCAS
+#elif defined (P_CC_MSVC) && (defined (P_CPU_X86_64) || defined (P_CPU_ARM_64))
+#  define P_LOCK_FREE_STACK_DWCAS
+#  include <intrin.h>
+#elif PLIBSYS_SIZEOF_VOID_P == 4
+#  define P_LOCK_FREE_STACK_PACKED
+#else
+#  define P_LOCK_FREE_STACK_LOCKED
+#  include "pspinlock.h"
+#endif
+
+typedef struct PLockFreeStackHead_ {
+	PLockFreeStackNode	*top;
+	psize			tag;
+} PLockFreeStackHead;
+
+struct PLockFreeStack_ {
+#if defined (P_LOCK_FREE_STACK_PACKED)
+	/* Top in the low half, tag in the high one */
+	volatile puint64	head;
+#else
+	/* Double-width swaps need a 16 byte alignment given by the allocation */
+	volatile ppointer	top;
+	volatile psize		tag;
+#endif
+#ifdef P_LOCK_FREE_STACK_LOCKED
+	PSpinLock		*lock;
+#endif
+};
+
+static void pp_lock_free_stack_load (const PLockFreeStack *stack, PLockFreeStackHead *head);
+static pboolean pp_lock_free_stack_cas (PLockFreeStack *stack, PLockFreeStackHead *expected, const PLockFreeStackHead *desired);
+
+#if defined (P_LOCK_FREE_STACK_PACKED)
+
+static void
+pp_lock_free_stack_load (const PLockFreeStack	*stack,
+			 PLockFreeStackHead	*head)
+{
+	puint64 value;
+
+	value = (puint64) p_atomic_int64_get ((const volatile pint64 *) &stack->head);
+
+	head->top = (PLockFreeStackNode *) PSIZE_TO_POINTER ((psize) (value & 0xFFFFFFFFU));
+	head->tag = (psize) (value >> 32);
+}
+
+static pboolean
+pp_lock_free_stack_cas (PLockFreeStack			*stack,
+			PLockFreeStackHead		*expected,
+			const PLockFreeStackHead	*desired)
+{
+	puint64 old_value;
+	puint64 new_value;
+
+	old_value = ((puint64) expected->tag << 32) | (puint64) PPOINTER_TO_PSIZE (expected->top);
+	new_value = ((puint64) desired->tag << 32) | (puint64) PPOINTER_TO_PSIZE (desired->top);
+
+	if (p_atomic_int64_compare_and_exchange ((volatile pint64 *) &stack->head,
+						 (pint64) old_value,
+						 (pint64) new_value) == TRUE)
+		return TRUE;
+
+	pp_lock_free_stack_load (stack, expected);
+
+	return FALSE;
+}
+
+#else /* !P_LOCK_FREE_STACK_PACKED */
+
+static void
+pp_lock_free_stack_load (const PLockFreeStack	*stack,
+			 PLockFreeStackHead	*head)
+{
+	head->tag = PPOINTER_TO_PSIZE (p_atomic_pointer_get_explicit (&stack->tag, P_ATOMIC_MEMORY_ORDER_ACQUIRE));
+	head->top = (PLockFreeStackNode *) p_atomic_pointer_get_explicit (&stack->top, P_ATOMIC_MEMORY_ORDER_ACQUIRE);
+}
+
+#  if defined (P_LOCK_FREE_STACK_DWCAS) && defined (P_CC_MSVC)
+
+static pboolean
+pp_lock_free_stack_cas (PLockFreeStack			*stack,
+			PLockFreeStackHead		*expected,
+			const PLockFreeStackHead	*desired)
+{
+	/* Updates the expected pair on failure */
+	return _InterlockedCompareExchange128 ((volatile __int64 *) &stack->top,
+					       (__int64) desired->tag,
+					       (__int64) desired->top,
+					       (__int64 *) expected) != 0 ? TRUE : FALSE;
+}
+
+#  elif defined (P_LOCK_FREE_STACK_DWCAS) && defined (P_CPU_X86_64)
+
+static pboolean
+pp_lock_free_stack_cas (PLockFreeStack			*stack,
+			PLockFreeStackHead		*expected,
+			const PLockFreeStackHead	*desired)
+{
+	puchar result;
+
+	/* Loads the current pair into rdx:rax on failure */
+	__asm__ __volatile__ ("lock; cmpxchg16b %1\n\t"
+			      "sete %0"
+			      : "=q" (result), "+m" (*stack), "+a" (expected->top), "+d" (expected->tag)
+			      : "b" (desired->top), "c" (desired->tag)
+			      : "cc", "memory");
+
+	return result != 0 ? TRUE : FALSE;
+}
+
+#  elif defined (P_LOCK_FREE_STACK_DWCAS) && defined (P_CPU_ARM_64)
+
+static pboolean
+pp_lock_free_stack_cas (PLockFreeStack			*stack,
+			PLockFreeStackHead		*expected,
+			const PLockFreeStackHead	*desired)
+{
+	PLockFreeStackNode	*old_top;
+	psize			old_tag;
+	puint32			failed;
+
+	/* The exclusive pair has to stay in a single block: a memory access
+	 * between the load and the store may clear the exclusive monitor */
+	__asm__ __volatile__ ("1:\n\t"
+			      "ldaxp %0, %1, %3\n\t"
+			      "cmp %0, %4\n\t"
+			      "ccmp %1, %5, #0, eq\n\t"
+			      "b.ne 2f\n\t"
+			      "stlxp %w2, %6, %7, %3\n\t"
+			      "cbnz %w2, 1b\n"
+			      "2:"
+			      : "=&r" (old_top), "=&r" (old_tag), "=&r" (failed), "+Q" (*stack)
+			      : "r" (expected->top), "r" (expected->tag), "r" (desired->top), "r" (desired->tag)
+			      : "cc", "memory");
+
+	if (old_top == expected->top && old_tag == expected->tag)
+		return TRUE;
+
+	expected->top = old_top;
+	expected->tag = old_tag;
+
+	return FALSE;
+}
+
+#  else /* P_LOCK_FREE_STACK_LOCKED */
+
+static pboolean
+pp_lock_free_stack_cas (PLockFreeStack			*stack,
+			PLockFreeStackHead		*expected,
+			const PLockFreeStackHead	*desired)
+{
+	pboolean result;
+
+	p_spinlock_lock (stack->lock);
+
+	result = (stack->top == expected->top && stack->tag == expected->tag) ? TRUE : FALSE;
+
+	if (result == TRUE) {
+		stack->top = desired->top;
+		stack->tag = desired->tag;
+	} else {
+		expected->top = (PLockFreeStackNode *) stack->top;
+		expected->tag = stack->tag;
+	}
+
+	p_spinlock_unlock (stack->lock);
+
+	return result;
+}
+
+#  endif
+#endif /* P_LOCK_FREE_STACK_PACKED */
+
+P_LIB_API PLockFreeStack *
+p_lock_free_stack_new (void)
+{
+	PLockFreeStack *ret;
+
+	if (P_UNLIKELY ((ret = p_malloc0_aligned (sizeof (PLockFreeStack), P_MEM_CACHE_LINE_SIZE)) == NULL)) {
+		P_ERROR ("PLockFreeStack::p_lock_free_stack_new: failed to allocate memory");
+		return NULL;
+	}
+
+#ifdef P_LOCK_FREE_STACK_LOCKED
+	if (P_UNLIKELY ((ret->lock = p_spinlock_new ()) == NULL)) {
+		P_ERROR ("PLockFreeStack::p_lock_free_stack_new: failed to allocate spinlock");
+		p_free_aligned (ret);
+		return NULL;
+	}
+#endif
+
+	return ret;
+}
+
+P_LIB_API void
+p_lock_free_stack_push (PLockFreeStack		*stack,
+			PLockFreeStackNode	*node)
+{
+	p_lock_free_stack_push_all (stack, node, node);
+}
+
+P_LIB_API PLockFreeStackNode *
+p_lock_free_stack_pop (PLockFreeStack *stack)
+{
+	PLockFreeStackHead	expected;
+	PLockFreeStackHead	desired;
+
+	if (P_UNLIKELY (stack == NULL))
+		return NULL;
+
+	pp_lock_free_stack_load (stack, &expected);
+
+	do {
+		if (expected.top == NULL)
+			return NULL;
+
+		/* The node may be popped and pushed again meanwhile, then the tag
+		 * doesn't match and the link read here is thrown away */
+		desired.top = (PLockFreeStackNode *) p_atomic_pointer_get_explicit (&expected.top->next,
+										    P_ATOMIC_MEMORY_ORDER_RELAXED);
+		desired.tag = expected.tag + 1;
+	} while (pp_lock_free_stack_cas (stack, &expected, &desired) == FALSE);
+
+	return expected.top;
+}
+
+P_LIB_API void
+p_lock_free_stack_push_all (PLockFreeStack	*stack,
+			    PLockFreeStackNode	*first,
+			    PLockFreeStackNode	*last)
+{
+	PLockFreeStackHead	expected;
+	PLockFreeStackHead	desired;
+
+	if (P_UNLIKELY (stack == NULL || first == NULL || last == NULL))
+		return;
+
+	pp_lock_free_stack_load (stack, &expected);
+
+	desired.top = first;
+
+	do {
+		/* Concurrent pops read the link atomically */
+		p_atomic_pointer_set_explicit (&last->next, expected.top, P_ATOMIC_MEMORY_ORDER_RELAXED);
+		desired.tag = expected.tag;
+	} while (pp_lock_free_stack_cas (stack, &expected, &desired) == FALSE);
+}
+
+P_LIB_API PLockFreeStackNode *
+p_lock_free_stack_pop_all (PLockFreeStack *stack)
+{
+	PLockFreeStackHead	expected;
+	PLockFreeStackHead	desired;
+
+	if (P_UNLIKELY (stack == NULL))
+		return NULL;
+
+	pp_lock_free_stack_load (stack, &expected);
+
+	desired.top = NULL;
+
+	do {
+		if (expected.top == NULL)
+			return NULL;
+
+		desired.tag = expected.tag + 1;
+	} while (pp_lock_free_stack_cas (stack, &expected, &desired) == FALSE);
+
+	return expected.top;
+}
+
+P_LIB_API pboolean
+p_lock_free_stack_is_empty (const PLockFreeStack *stack)
+{
+	PLockFreeStackHead head;
+
+	if (P_UNLIKELY (stack == NULL))
+		return TRUE;
+
+	pp_lock_free_stack_load (stack, &head);
+
+	return head.top == NULL ? TRUE : FALSE;
+}
+
+P_LIB_API pboolean
+p_lock_free_stack_is_lock_free (void)
+{
+#if defined (P_LOCK_FREE_STACK_DWCAS)
+	return TRUE;
+#elif defined (P_LOCK_FREE_STACK_PACKED)
+	return p_atomic_int64_is_lock_free ();
+#else
+	return FALSE;
+#endif
+}
+
+P_LIB_API void
+p_lock_free_stack_free (PLockFreeStack *stack)
+{
+	if (P_UNLIKELY (stack == NULL))
+		return;
+
+#ifdef P_LOCK_FREE_STACK_LOCKED
+	p_spinlock_free (stack->lock);
+#endif
+
+	p_free_aligned (stack);
+}
@@ -0,0 +1,154 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file plockfreestack.h
+ * @brief ABA-safe lock-free stack
+ * @author Alexander Saprykin
+ *
+ * A lock-free stack is a LIFO list of nodes which any number of threads push
+ * and pop without a lock, it suits free lists and object pools best. The
+ * stack is intrusive: the caller embeds a #PLockFreeStackNode into its own
+ * objects, the stack never allocates memory for them.
+ *
+ * A naive stack on a single pointer compare and exchange suffers from the
+ * ABA problem: a thread reads the top node A and its next node B, another
+ * thread pops A and B and pushes A back, and the first thread then swaps the
+ * top from A to the already taken B. Here the top pointer comes with a tag
+ * which every pop changes, and both are swapped at once: with a double-width
+ * compare and exchange on the 64-bit x86 and ARM CPUs, or with the pointer
+ * and the tag packed into a 64-bit atomic integer on the 32-bit platforms.
+ * Elsewhere the stack falls back to a spinlock, see
+ * p_lock_free_stack_is_lock_free().
+ *
+ * A popping thread may still read the next link of a node which another
+ * thread has just popped, so the memory of a popped node must stay readable
+ * while the stack is in use: keep the nodes in a pool, or retire them through
+ * #PEpochDomain or #PHazardDomain before freeing.
+ *
+ * p_lock_free_stack_push_all() and p_lock_free_stack_pop_all() move a whole
+ * chain of nodes with a single atomic operation, e.g. to return a batch of
+ * objects to a pool or to take over all of them at once.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PLOCKFREESTACK_H
+#define PLIBSYS_HEADER_PLOCKFREESTACK_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+
+P_BEGIN_DECLS
+
+/** Lock-free stack opaque data type. */
+typedef struct PLockFreeStack_ PLockFreeStack;
+
+/** Lock-free stack node to embed into the stacked objects. */
+typedef struct PLockFreeStackNode_ {
+	struct PLockFreeStackNode_	*next;	/**< Next node in the stack or in a chain. */
+} PLockFreeStackNode;
+
+/**
+ * @brief Creates a new empty lock-free stack.
+ * @return Pointer to #PLockFreeStack in case of success, NULL otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API PLockFreeStack *	p_lock_free_stack_new		(void);
+
+/**
+ * @brief Pushes a node onto a lock-free stack.
+ * @param stack #PLockFreeStack to push the node onto.
+ * @param node Node to push, its next link is overwritten.
+ * @since 0.0.5
+ */
+P_LIB_API void			p_lock_free_stack_push		(PLockFreeStack		*stack,
+								 PLockFreeStackNode	*node);
+
+/**
+ * @brief Pops a node from a lock-free stack.
+ * @param stack #PLockFreeStack to pop the node from.
+ * @return Node from the top of the stack, NULL if the stack is empty.
+ * @since 0.0.5
+ */
+P_LIB_API PLockFreeStackNode *	p_lock_free_stack_pop		(PLockFreeStack		*stack);
+
+/**
+ * @brief Pushes a chain of nodes onto a lock-free stack.
+ * @param stack #PLockFreeStack to push the nodes onto.
+ * @param first First node of the chain, it becomes the top of the stack.
+ * @param last Last node of the chain, reachable from @a first by the next
+ * links. Its next link is overwritten.
+ * @since 0.0.5
+ *
+ * The whole chain appears on the stack at once. Concurrent pops may still
+ * read the next links of the nodes they have lost, so link the chain with
+ * p_atomic_pointer_set_explicit() rather than plain stores.
+ */
+P_LIB_API void			p_lock_free_stack_push_all	(PLockFreeStack		*stack,
+								 PLockFreeStackNode	*first,
+								 PLockFreeStackNode	*last);
+
+/**
+ * @brief Pops all the nodes from a lock-free stack.
+ * @param stack #PLockFreeStack to pop the nodes from.
+ * @return Chain of the nodes from the top to the bottom of the stack, linked
+ * by the next links and terminated by NULL, or NULL if the stack is empty.
+ * @since 0.0.5
+ */
+P_LIB_API PLockFreeStackNode *	p_lock_free_stack_pop_all	(PLockFreeStack		*stack);
+
+/**
+ * @brief Checks whether a lock-free stack is empty.
+ * @param stack #PLockFreeStack to check.
+ * @return TRUE if the stack is empty or NULL, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The result is only a snapshot when other threads use the stack.
+ */
+P_LIB_API pboolean		p_lock_free_stack_is_empty	(const PLockFreeStack	*stack);
+
+/**
+ * @brief Checks whether the lock-free stack is really lock-free on the
+ * platform.
+ * @return TRUE if the stack doesn't use a lock, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean		p_lock_free_stack_is_lock_free	(void);
+
+/**
+ * @brief Frees a lock-free stack.
+ * @param stack #PLockFreeStack to free.
+ * @since 0.0.5
+ *
+ * The nodes still in the stack are not touched.
+ */
+P_LIB_API void			p_lock_free_stack_free		(PLockFreeStack		*stack);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PLOCKFREESTACK_H */
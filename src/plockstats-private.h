@@ -0,0 +1,111 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PLOCKSTATS_PRIVATE_H
+#define PLIBSYS_HEADER_PLOCKSTATS_PRIVATE_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+#include "pmutex.h"
+#include "prwlock.h"
+#include "plockstats.h"
+
+P_BEGIN_DECLS
+
+#ifdef PLIBSYS_LOCK_STATS
+/* Every lock backend carries a record, the profiling wrappers in plockstats.c
+ * reach it through a getter defined by the backend. The backend calls are
+ * renamed, so the wrappers take over the public names. The record goes after
+ * the system handle: the condition variables cast a mutex to its handle. */
+typedef struct PLockStatsRecord_ {
+	struct PLockStatsRecord_	*prev;
+	struct PLockStatsRecord_	*next;
+	pconstpointer			lock;
+	PLockStatsType			type;
+	pchar				name[P_LOCK_STATS_NAME_SIZE];
+	volatile pint64			acquisitions;
+	volatile pint64			contended;
+	volatile pint64			wait_total;
+	volatile pint64			wait_max;
+	volatile pint64			hold_total;
+	volatile pint64			hold_max;
+	puint64				locked_at;
+} PLockStatsRecord;
+
+#  define P_LOCK_STATS_FIELD					\
+	PLockStatsRecord	lock_stats;
+
+#  define P_LOCK_STATS_DEFINE_GETTER(type, func)		\
+	PLockStatsRecord *					\
+	func (type *lock)					\
+	{							\
+		return &lock->lock_stats;			\
+	}
+
+PLockStatsRecord *	p_mutex_get_lock_stats	(PMutex *mutex);
+PLockStatsRecord *	p_rwlock_get_lock_stats	(PRWLock *lock);
+
+PMutex *	p_mutex_new_unprofiled			(void);
+pboolean	p_mutex_lock_unprofiled			(PMutex *mutex);
+pboolean	p_mutex_trylock_unprofiled		(PMutex *mutex);
+pboolean	p_mutex_unlock_unprofiled		(PMutex *mutex);
+void		p_mutex_free_unprofiled			(PMutex *mutex);
+
+PRWLock *	p_rwlock_new_unprofiled			(void);
+pboolean	p_rwlock_reader_lock_unprofiled		(PRWLock *lock);
+pboolean	p_rwlock_reader_trylock_unprofiled	(PRWLock *lock);
+pboolean	p_rwlock_reader_unlock_unprofiled	(PRWLock *lock);
+pboolean	p_rwlock_writer_lock_unprofiled		(PRWLock *lock);
+pboolean	p_rwlock_writer_trylock_unprofiled	(PRWLock *lock);
+pboolean	p_rwlock_writer_unlock_unprofiled	(PRWLock *lock);
+void		p_rwlock_free_unprofiled		(PRWLock *lock);
+
+#  ifndef PLIBSYS_LOCK_STATS_WRAPPERS
+#    define p_mutex_new			p_mutex_new_unprofiled
+#    define p_mutex_lock		p_mutex_lock_unprofiled
+#    define p_mutex_trylock		p_mutex_trylock_unprofiled
+#    define p_mutex_unlock		p_mutex_unlock_unprofiled
+#    define p_mutex_free		p_mutex_free_unprofiled
+#    define p_rwlock_new		p_rwlock_new_unprofiled
+#    define p_rwlock_reader_lock	p_rwlock_reader_lock_unprofiled
+#    define p_rwlock_reader_trylock	p_rwlock_reader_trylock_unprofiled
+#    define p_rwlock_reader_unlock	p_rwlock_reader_unlock_unprofiled
+#    define p_rwlock_writer_lock	p_rwlock_writer_lock_unprofiled
+#    define p_rwlock_writer_trylock	p_rwlock_writer_trylock_unprofiled
+#    define p_rwlock_writer_unlock	p_rwlock_writer_unlock_unprofiled
+#    define p_rwlock_free		p_rwlock_free_unprofiled
+#  endif
+#else
+#  define P_LOCK_STATS_FIELD
+#  define P_LOCK_STATS_DEFINE_GETTER(type, func)
+#endif
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PLOCKSTATS_PRIVATE_H */
@@ -0,0 +1,592 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* The locks are kept in a list guarded by a tiny spin lock: a #PMutex can't
+ * guard it, because creating a mutex registers it in the list. A lock is tried
+ * first, only when that fails the waiting time is measured, so an uncontended
+ * acquisition takes a single clock reading for the hold time. The clock is
+ * not available until p_libsys_init() sets up the time profiler, before that
+ * only the acquisitions are counted. */
+
+#define PLIBSYS_LOCK_STATS_WRAPPERS
+
+#include "plockstats.h"
+#include "plockstats-private.h"
+
+#ifdef PLIBSYS_LOCK_STATS
+#  include "patomic.h"
+#  include "pmem.h"
+#  include "ptimeprofiler.h"
+#  include "ptimeprofiler-private.h"
+#  include "puthread.h"
+
+#  include <stdio.h>
+#  include <string.h>
+
+static volatile pint	pp_lock_stats_list_lock = 0;
+static PLockStatsRecord	*pp_lock_stats_list     = NULL;
+static PTimeProfiler	pp_lock_stats_clock;
+static volatile pint	pp_lock_stats_has_clock = 0;
+
+static void pp_lock_stats_list_lock_acquire (void);
+static void pp_lock_stats_list_lock_release (void);
+static puint64 pp_lock_stats_now (void);
+static void pp_lock_stats_update_max (volatile pint64 *max, pint64 value);
+static void pp_lock_stats_register (PLockStatsRecord *record, pconstpointer lock, PLockStatsType type);
+static void pp_lock_stats_unregister (PLockStatsRecord *record);
+static PLockStatsRecord * pp_lock_stats_find (pconstpointer lock);
+static void pp_lock_stats_fill (const PLockStatsRecord *record, PLockStats *stats);
+static pboolean pp_lock_stats_is_more_contended (const PLockStats *a, const PLockStats *b);
+static void pp_lock_stats_acquired (PLockStatsRecord *record, pboolean contended, puint64 start, pboolean exclusive);
+static void pp_lock_stats_released (PLockStatsRecord *record);
+
+static void
+pp_lock_stats_list_lock_acquire (void)
+{
+	while (p_atomic_int_compare_and_exchange (&pp_lock_stats_list_lock, 0, 1) == FALSE)
+		p_uthread_yield ();
+}
+
+static void
+pp_lock_stats_list_lock_release (void)
+{
+	p_atomic_int_set (&pp_lock_stats_list_lock, 0);
+}
+
+static puint64
+pp_lock_stats_now (void)
+{
+	if (p_atomic_int_get_explicit (&pp_lock_stats_has_clock, P_ATOMIC_MEMORY_ORDER_ACQUIRE) == 0)
+		return 0;
+
+	return p_time_profiler_elapsed_usecs_internal (&pp_lock_stats_clock);
+}
+
+static void
+pp_lock_stats_update_max (volatile pint64	*max,
+			  pint64		value)
+{
+	pint64 current;
+
+	do {
+		current = p_atomic_int64_get (max);
+
+		if (current >= value)
+			return;
+	} while (p_atomic_int64_compare_and_exchange (max, current, value) == FALSE);
+}
+
+static void
+pp_lock_stats_register (PLockStatsRecord	*record,
+			pconstpointer		lock,
+			PLockStatsType		type)
+{
+	memset (record, 0, sizeof (PLockStatsRecord));
+
+	record->lock = lock;
+	record->type = type;
+
+	pp_lock_stats_list_lock_acquire ();
+
+	record->next = pp_lock_stats_list;
+
+	if (pp_lock_stats_list != NULL)
+		pp_lock_stats_list->prev = record;
+
+	pp_lock_stats_list = record;
+
+	pp_lock_stats_list_lock_release ();
+}
+
+static void
+pp_lock_stats_unregister (PLockStatsRecord *record)
+{
+	pp_lock_stats_list_lock_acquire ();
+
+	if (record->prev != NULL)
+		record->prev->next = record->next;
+	else
+		pp_lock_stats_list = record->next;
+
+	if (record->next != NULL)
+		record->next->prev = record->prev;
+
+	pp_lock_stats_list_lock_release ();
+}
+
+/* Must be called with the list lock held */
+static PLockStatsRecord *
+pp_lock_stats_find (pconstpointer lock)
+{
+	PLockStatsRecord *record;
+
+	for (record = pp_lock_stats_list; record != NULL; record = record->next) {
+		if (record->lock == lock)
+			return record;
+	}
+
+	return NULL;
+}
+
+static void
+pp_lock_stats_fill (const PLockStatsRecord	*record,
+		    PLockStats			*stats)
+{
+	stats->lock             = record->lock;
+	stats->type             = record->type;
+	stats->acquisitions     = (puint64) p_atomic_int64_get (&record->acquisitions);
+	stats->contended        = (puint64) p_atomic_int64_get (&record->contended);
+	stats->wait_total_usecs = (puint64) p_atomic_int64_get (&record->wait_total);
+	stats->wait_max_usecs   = (puint64) p_atomic_int64_get (&record->wait_max);
+	stats->hold_total_usecs = (puint64) p_atomic_int64_get (&record->hold_total);
+	stats->hold_max_usecs   = (puint64) p_atomic_int64_get (&record->hold_max);
+
+	memcpy (stats->name, record->name, P_LOCK_STATS_NAME_SIZE);
+}
+
+static pboolean
+pp_lock_stats_is_more_contended (const PLockStats	*a,
+				 const PLockStats	*b)
+{
+	if (a->contended != b->contended)
+		return a->contended > b->contended;
+
+	return a->wait_total_usecs > b->wait_total_usecs;
+}
+
+static void
+pp_lock_stats_acquired (PLockStatsRecord	*record,
+			pboolean		contended,
+			puint64			start,
+			pboolean		exclusive)
+{
+	puint64 now = 0;
+
+	p_atomic_int64_add (&record->acquisitions, 1);
+
+	if (contended == TRUE || exclusive == TRUE)
+		now = pp_lock_stats_now ();
+
+	if (contended == TRUE) {
+		p_atomic_int64_add (&record->contended, 1);
+
+		if (start != 0 && now >= start) {
+			p_atomic_int64_add (&record->wait_total, (pint64) (now - start));
+			pp_lock_stats_update_max (&record->wait_max, (pint64) (now - start));
+		}
+	}
+
+	/* Only the owner of an exclusive lock touches it */
+	if (exclusive == TRUE)
+		record->locked_at = now;
+}
+
+static void
+pp_lock_stats_released (PLockStatsRecord *record)
+{
+	puint64 now;
+	puint64 hold;
+
+	if (record->locked_at == 0 || (now = pp_lock_stats_now ()) < record->locked_at)
+		return;
+
+	hold = now - record->locked_at;
+
+	p_atomic_int64_add (&record->hold_total, (pint64) hold);
+	pp_lock_stats_update_max (&record->hold_max, (pint64) hold);
+}
+
+void
+p_lock_stats_init (void)
+{
+	pp_lock_stats_clock.counter = p_time_profiler_get_ticks_internal ();
+
+	/* The clock starts from 1, 0 stands for no time */
+	if (pp_lock_stats_clock.counter > 0)
+		--pp_lock_stats_clock.counter;
+
+	p_atomic_int_set_explicit (&pp_lock_stats_has_clock, 1, P_ATOMIC_MEMORY_ORDER_RELEASE);
+}
+
+void
+p_lock_stats_shutdown (void)
+{
+	p_atomic_int_set_explicit (&pp_lock_stats_has_clock, 0, P_ATOMIC_MEMORY_ORDER_RELEASE);
+}
+
+P_LIB_API PMutex *
+p_mutex_new (void)
+{
+	PMutex *ret;
+
+	if (P_LIKELY ((ret = p_mutex_new_unprofiled ()) != NULL))
+		pp_lock_stats_register (p_mutex_get_lock_stats (ret), ret, P_LOCK_STATS_TYPE_MUTEX);
+
+	return ret;
+}
+
+P_LIB_API pboolean
+p_mutex_lock (PMutex *mutex)
+{
+	puint64 start;
+
+	if (P_UNLIKELY (mutex == NULL))
+		return FALSE;
+
+	if (p_mutex_trylock_unprofiled (mutex) == TRUE) {
+		pp_lock_stats_acquired (p_mutex_get_lock_stats (mutex), FALSE, 0, TRUE);
+		return TRUE;
+	}
+
+	start = pp_lock_stats_now ();
+
+	if (P_UNLIKELY (p_mutex_lock_unprofiled (mutex) == FALSE))
+		return FALSE;
+
+	pp_lock_stats_acquired (p_mutex_get_lock_stats (mutex), TRUE, start, TRUE);
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_mutex_trylock (PMutex *mutex)
+{
+	if (P_UNLIKELY (mutex == NULL))
+		return FALSE;
+
+	if (p_mutex_trylock_unprofiled (mutex) == FALSE)
+		return FALSE;
+
+	pp_lock_stats_acquired (p_mutex_get_lock_stats (mutex), FALSE, 0, TRUE);
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_mutex_unlock (PMutex *mutex)
+{
+	if (P_UNLIKELY (mutex == NULL))
+		return FALSE;
+
+	pp_lock_stats_released (p_mutex_get_lock_stats (mutex));
+
+	return p_mutex_unlock_unprofiled (mutex);
+}
+
+P_LIB_API void
+p_mutex_free (PMutex *mutex)
+{
+	if (P_UNLIKELY (mutex == NULL))
+		return;
+
+	pp_lock_stats_unregister (p_mutex_get_lock_stats (mutex));
+	p_mutex_free_unprofiled (mutex);
+}
+
+P_LIB_API PRWLock *
+p_rwlock_new (void)
+{
+	PRWLock *ret;
+
+	if (P_LIKELY ((ret = p_rwlock_new_unprofiled ()) != NULL))
+		pp_lock_stats_register (p_rwlock_get_lock_stats (ret), ret, P_LOCK_STATS_TYPE_RWLOCK);
+
+	return ret;
+}
+
+P_LIB_API pboolean
+p_rwlock_reader_lock (PRWLock *lock)
+{
+	puint64 start;
+
+	if (P_UNLIKELY (lock == NULL))
+		return FALSE;
+
+	if (p_rwlock_reader_trylock_unprofiled (lock) == TRUE) {
+		pp_lock_stats_acquired (p_rwlock_get_lock_stats (lock), FALSE, 0, FALSE);
+		return TRUE;
+	}
+
+	start = pp_lock_stats_now ();
+
+	if (P_UNLIKELY (p_rwlock_reader_lock_unprofiled (lock) == FALSE))
+		return FALSE;
+
+	pp_lock_stats_acquired (p_rwlock_get_lock_stats (lock), TRUE, start, FALSE);
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_rwlock_reader_trylock (PRWLock *lock)
+{
+	if (P_UNLIKELY (lock == NULL))
+		return FALSE;
+
+	if (p_rwlock_reader_trylock_unprofiled (lock) == FALSE)
+		return FALSE;
+
+	pp_lock_stats_acquired (p_rwlock_get_lock_stats (lock), FALSE, 0, FALSE);
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_rwlock_reader_unlock (PRWLock *lock)
+{
+	return p_rwlock_reader_unlock_unprofiled (lock);
+}
+
+P_LIB_API pboolean
+p_rwlock_writer_lock (PRWLock *lock)
+{
+	puint64 start;
+
+	if (P_UNLIKELY (lock == NULL))
+		return FALSE;
+
+	if (p_rwlock_writer_trylock_unprofiled (lock) == TRUE) {
+		pp_lock_stats_acquired (p_rwlock_get_lock_stats (lock), FALSE, 0, TRUE);
+		return TRUE;
+	}
+
+	start = pp_lock_stats_now ();
+
+	if (P_UNLIKELY (p_rwlock_writer_lock_unprofiled (lock) == FALSE))
+		return FALSE;
+
+	pp_lock_stats_acquired (p_rwlock_get_lock_stats (lock), TRUE, start, TRUE);
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_rwlock_writer_trylock (PRWLock *lock)
+{
+	if (P_UNLIKELY (lock == NULL))
+		return FALSE;
+
+	if (p_rwlock_writer_trylock_unprofiled (lock) == FALSE)
+		return FALSE;
+
+	pp_lock_stats_acquired (p_rwlock_get_lock_stats (lock), FALSE, 0, TRUE);
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_rwlock_writer_unlock (PRWLock *lock)
+{
+	if (P_UNLIKELY (lock == NULL))
+		return FALSE;
+
+	pp_lock_stats_released (p_rwlock_get_lock_stats (lock));
+
+	return p_rwlock_writer_unlock_unprofiled (lock);
+}
+
+P_LIB_API void
+p_rwlock_free (PRWLock *lock)
+{
+	if (P_UNLIKELY (lock == NULL))
+		return;
+
+	pp_lock_stats_unregister (p_rwlock_get_lock_stats (lock));
+	p_rwlock_free_unprofiled (lock);
+}
+#else
+void
+p_lock_stats_init (void)
+{
+}
+
+void
+p_lock_stats_shutdown (void)
+{
+}
+#endif
+
+P_LIB_API pboolean
+p_lock_stats_set_name (pconstpointer	lock,
+		       const pchar	*name)
+{
+#ifdef PLIBSYS_LOCK_STATS
+	PLockStatsRecord *record;
+
+	if (P_UNLIKELY (lock == NULL))
+		return FALSE;
+
+	pp_lock_stats_list_lock_acquire ();
+
+	if ((record = pp_lock_stats_find (lock)) != NULL) {
+		memset (record->name, 0, P_LOCK_STATS_NAME_SIZE);
+
+		if (name != NULL)
+			strncpy (record->name, name, P_LOCK_STATS_NAME_SIZE - 1);
+	}
+
+	pp_lock_stats_list_lock_release ();
+
+	return record != NULL;
+#else
+	P_UNUSED (lock);
+	P_UNUSED (name);
+
+	return FALSE;
+#endif
+}
+
+P_LIB_API pboolean
+p_lock_stats_get (pconstpointer	lock,
+		  PLockStats	*stats)
+{
+#ifdef PLIBSYS_LOCK_STATS
+	PLockStatsRecord *record;
+
+	if (P_UNLIKELY (lock == NULL || stats == NULL))
+		return FALSE;
+
+	pp_lock_stats_list_lock_acquire ();
+
+	if ((record = pp_lock_stats_find (lock)) != NULL)
+		pp_lock_stats_fill (record, stats);
+
+	pp_lock_stats_list_lock_release ();
+
+	return record != NULL;
+#else
+	P_UNUSED (lock);
+	P_UNUSED (stats);
+
+	return FALSE;
+#endif
+}
+
+P_LIB_API pint
+p_lock_stats_get_top (PLockStats	*stats,
+		      pint		max_count)
+{
+#ifdef PLIBSYS_LOCK_STATS
+	PLockStatsRecord	*record;
+	PLockStats		current;
+	pint			count = 0;
+	pint			i;
+
+	if (P_UNLIKELY (stats == NULL || max_count <= 0))
+		return 0;
+
+	pp_lock_stats_list_lock_acquire ();
+
+	/* Insertion into the sorted array, max_count is expected to be small */
+	for (record = pp_lock_stats_list; record != NULL; record = record->next) {
+		pp_lock_stats_fill (record, &current);
+
+		if (count == max_count && !pp_lock_stats_is_more_contended (&current, &stats[count - 1]))
+			continue;
+
+		if (count < max_count)
+			++count;
+
+		for (i = count - 1; i > 0 && pp_lock_stats_is_more_contended (&current, &stats[i - 1]); --i)
+			stats[i] = stats[i - 1];
+
+		stats[i] = current;
+	}
+
+	pp_lock_stats_list_lock_release ();
+
+	return count;
+#else
+	P_UNUSED (stats);
+	P_UNUSED (max_count);
+
+	return 0;
+#endif
+}
+
+P_LIB_API void
+p_lock_stats_dump (pint max_count)
+{
+#ifdef PLIBSYS_LOCK_STATS
+	PLockStats	*stats;
+	pint		count;
+	pint		i;
+
+	if (P_UNLIKELY (max_count <= 0))
+		return;
+
+	if (P_UNLIKELY ((stats = p_malloc (sizeof (PLockStats) * (psize) max_count)) == NULL)) {
+		P_ERROR ("PLockStats::p_lock_stats_dump: failed to allocate memory");
+		return;
+	}
+
+	count = p_lock_stats_get_top (stats, max_count);
+
+	printf ("%-32s %-7s %12s %12s %12s %10s %12s %10s\n",
+		"Lock", "Type", "Acquired", "Contended",
+		"Wait us", "Max wait", "Hold us", "Max hold");
+
+	for (i = 0; i < count; ++i) {
+		if (stats[i].name[0] != '\0')
+			printf ("%-32s ", stats[i].name);
+		else
+			printf ("%-32p ", stats[i].lock);
+
+		printf ("%-7s %12llu %12llu %12llu %10llu %12llu %10llu\n",
+			stats[i].type == P_LOCK_STATS_TYPE_MUTEX ? "mutex" : "rwlock",
+			(unsigned long long) stats[i].acquisitions,
+			(unsigned long long) stats[i].contended,
+			(unsigned long long) stats[i].wait_total_usecs,
+			(unsigned long long) stats[i].wait_max_usecs,
+			(unsigned long long) stats[i].hold_total_usecs,
+			(unsigned long long) stats[i].hold_max_usecs);
+	}
+
+	p_free (stats);
+#else
+	P_UNUSED (max_count);
+#endif
+}
+
+P_LIB_API void
+p_lock_stats_reset (void)
+{
+#ifdef PLIBSYS_LOCK_STATS
+	PLockStatsRecord *record;
+
+	pp_lock_stats_list_lock_acquire ();
+
+	for (record = pp_lock_stats_list; record != NULL; record = record->next) {
+		p_atomic_int64_set (&record->acquisitions, 0);
+		p_atomic_int64_set (&record->contended, 0);
+		p_atomic_int64_set (&record->wait_total, 0);
+		p_atomic_int64_set (&record->wait_max, 0);
+		p_atomic_int64_set (&record->hold_total, 0);
+		p_atomic_int64_set (&record->hold_max, 0);
+	}
+
+	pp_lock_stats_list_lock_release ();
+#endif
+}
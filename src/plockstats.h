@@ -0,0 +1,152 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file plockstats.h
+ * @brief Lock contention statistics
+ * @author Alexander Saprykin
+ *
+ * A library built with the PLIBSYS_LOCK_STATS option profiles every #PMutex
+ * and #PRWLock: it counts the acquisitions of each lock, the contended ones
+ * (which had to wait because the lock was taken), and measures the total and
+ * the maximum time spent waiting for the lock and holding it. This helps to
+ * find the lock behind a latency spike.
+ *
+ * A lock can be given a name with p_lock_stats_set_name() to tell it apart in
+ * the output. The statistics of a single lock are taken with p_lock_stats_get(),
+ * the most contended locks with p_lock_stats_get_top() or printed to the
+ * standard output with p_lock_stats_dump(). Only the locks which are not freed
+ * yet are reported.
+ *
+ * A lock is first tried without waiting, only if it is taken the lock is
+ * counted as contended and the waiting time is measured. The hold time is
+ * measured from the acquisition to the release, it includes the time a
+ * #PCondVariable waits with the mutex released. For the read locks of a
+ * #PRWLock, which can be held by several threads at once, only the
+ * acquisitions and the waiting are accounted.
+ *
+ * Without the option the locks are not profiled at all and take no time, the
+ * calls of this module report that the statistics are unavailable.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PLOCKSTATS_H
+#define PLIBSYS_HEADER_PLOCKSTATS_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+
+P_BEGIN_DECLS
+
+/** Maximum length of a lock name including the terminating zero. */
+#define P_LOCK_STATS_NAME_SIZE	32
+
+/** Lock type. */
+typedef enum PLockStatsType_ {
+	P_LOCK_STATS_TYPE_MUTEX		= 0,	/**< #PMutex.	*/
+	P_LOCK_STATS_TYPE_RWLOCK	= 1	/**< #PRWLock.	*/
+} PLockStatsType;
+
+/** Contention statistics of a lock. */
+typedef struct PLockStats_ {
+	pconstpointer	lock;				/**< Lock address.			*/
+	PLockStatsType	type;				/**< Lock type.				*/
+	pchar		name[P_LOCK_STATS_NAME_SIZE];	/**< Lock name, empty if not set.	*/
+	puint64		acquisitions;			/**< Number of acquisitions.		*/
+	puint64		contended;			/**< Number of acquisitions which
+							     had to wait.			*/
+	puint64		wait_total_usecs;		/**< Total waiting time.		*/
+	puint64		wait_max_usecs;			/**< Maximum waiting time.		*/
+	puint64		hold_total_usecs;		/**< Total holding time, exclusive
+							     acquisitions only.			*/
+	puint64		hold_max_usecs;			/**< Maximum holding time, exclusive
+							     acquisitions only.			*/
+} PLockStats;
+
+/**
+ * @brief Sets the name of a lock for the contention statistics.
+ * @param lock #PMutex or #PRWLock to set the name for.
+ * @param name Name of the lock, truncated to #P_LOCK_STATS_NAME_SIZE - 1
+ * characters, NULL to clear it.
+ * @return TRUE in case of success, FALSE if @a lock is not known or the
+ * library was built without the PLIBSYS_LOCK_STATS option.
+ * @since 0.0.5
+ *
+ * The name is copied, it is a good idea to set it right after creating the
+ * lock.
+ */
+P_LIB_API pboolean	p_lock_stats_set_name	(pconstpointer		lock,
+						 const pchar		*name);
+
+/**
+ * @brief Gets the contention statistics of a lock.
+ * @param lock #PMutex or #PRWLock to get the statistics for.
+ * @param[out] stats Statistics to fill in.
+ * @return TRUE in case of success, FALSE if @a lock is not known or the
+ * library was built without the PLIBSYS_LOCK_STATS option.
+ * @since 0.0.5
+ *
+ * Counters are updated atomically but read one by one, so they may be slightly
+ * inconsistent while other threads use the lock.
+ */
+P_LIB_API pboolean	p_lock_stats_get	(pconstpointer		lock,
+						 PLockStats		*stats);
+
+/**
+ * @brief Gets the most contended locks.
+ * @param[out] stats Array to fill in, sorted by the number of contended
+ * acquisitions and then by the total waiting time, the most contended first.
+ * @param max_count Size of @a stats.
+ * @return Number of entries filled in, 0 if the library was built without the
+ * PLIBSYS_LOCK_STATS option.
+ * @since 0.0.5
+ */
+P_LIB_API pint		p_lock_stats_get_top	(PLockStats		*stats,
+						 pint			max_count);
+
+/**
+ * @brief Prints the most contended locks to the standard output.
+ * @param max_count Maximum number of locks to print.
+ * @since 0.0.5
+ *
+ * Prints a line per lock, in the order of p_lock_stats_get_top(). Nothing is
+ * printed if the library was built without the PLIBSYS_LOCK_STATS option.
+ */
+P_LIB_API void		p_lock_stats_dump	(pint			max_count);
+
+/**
+ * @brief Resets the contention statistics of all the locks.
+ * @since 0.0.5
+ *
+ * The names of the locks are kept.
+ */
+P_LIB_API void		p_lock_stats_reset	(void);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PLOCKSTATS_H */
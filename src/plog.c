@@ -0,0 +1,656 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* In the asynchronous mode every thread copies its messages into its own SPSC
+ * ring, the writer thread is the only consumer of all the rings. The rings
+ * belong to a reference counted registry in the same way as the trace buffers
+ * (see ptrace.c), so the buffers of the threads which outlive the library
+ * shutdown are freed on the thread exit. The writer sleeps on a sequence
+ * number bumped after every message and is notified only when it actually
+ * sleeps, so a burst of messages costs a few atomic operations per message.
+ *
+ * The rate limiting window is a second of the calendar time: time() needs no
+ * library state and can't fail into another error message. */
+
+#include "plog.h"
+#include "patomic.h"
+#include "pmem.h"
+#include "pmutex.h"
+#include "ponce.h"
+#include "pringspsc.h"
+#include "puthread.h"
+
+#include <string.h>
+#include <time.h>
+
+typedef struct PLogRawRecord_ {
+	pint	level;
+	pchar	message[P_LOG_MESSAGE_SIZE];
+} PLogRawRecord;
+
+typedef struct PLogRegistry_ PLogRegistry;
+
+typedef struct PLogBuffer_ {
+	PLogRegistry		*registry;
+	struct PLogBuffer_	*next;
+	PRingSPSC		*ring;
+	pboolean		orphaned;
+} PLogBuffer;
+
+struct PLogRegistry_ {
+	PMutex		*mutex;
+	PLogBuffer	*buffers;
+	pint		ref_count;
+	pboolean	is_freed;
+	PUThread	*writer;
+	pboolean	running;
+	volatile pint	stopping;
+};
+
+static POnce			pp_log_once       = P_ONCE_INIT;
+static PLogRegistry		*pp_log_registry  = NULL;
+static PUThreadStaticKey	*pp_log_key       = NULL;
+static volatile pint		pp_log_enabled    = 0;
+static volatile pint64		pp_log_dropped    = 0;
+static volatile pint		pp_log_sequence   = 0;
+static volatile pint		pp_log_sleeping   = 0;
+static volatile pint		pp_log_rate_limit = P_LOG_DEFAULT_RATE_LIMIT;
+static PLogFunc			pp_log_func       = NULL;
+static ppointer			pp_log_user_data  = NULL;
+
+/* Marks the threads which write synchronously in the asynchronous mode: the
+ * writer itself and a thread allocating its buffer */
+static PLogBuffer		pp_log_no_buffer;
+
+static void pp_log_init (ppointer data);
+static void pp_log_registry_unref (PLogRegistry *registry);
+static PLogBuffer * pp_log_buffer_new (void);
+static void pp_log_buffer_unlink (PLogRegistry *registry, PLogBuffer *buffer);
+static void pp_log_buffer_free (PLogBuffer *buffer);
+static void pp_log_buffer_thread_exit (ppointer data);
+static void pp_log_deliver (PLogLevel level, const pchar *message);
+static void pp_log_format (pchar *buf, psize size, const pchar *message, pint suppressed);
+static pboolean pp_log_site_allow (PLogSite *site, pint *suppressed);
+static pboolean pp_log_write_async (PLogLevel level, const pchar *message, pint suppressed);
+static void pp_log_write (PLogLevel level, const pchar *message, pint suppressed);
+static void pp_log_drain_buffer (PLogBuffer *buffer);
+static void pp_log_drain (PLogRegistry *registry);
+static ppointer pp_log_writer_func (ppointer data);
+
+static void
+pp_log_registry_unref (PLogRegistry *registry)
+{
+	if (p_atomic_int_dec_and_test (&registry->ref_count) == FALSE)
+		return;
+
+	p_mutex_free (registry->mutex);
+	p_free (registry);
+}
+
+static PLogBuffer *
+pp_log_buffer_new (void)
+{
+	PLogRegistry	*registry = pp_log_registry;
+	PLogBuffer	*buffer;
+
+	if (P_UNLIKELY (registry == NULL))
+		return NULL;
+
+	/* Errors of the allocations below are written synchronously */
+	p_uthread_set_static_local (pp_log_key, &pp_log_no_buffer);
+
+	if (P_UNLIKELY ((buffer = p_malloc0 (sizeof (PLogBuffer))) == NULL)) {
+		p_uthread_set_static_local (pp_log_key, NULL);
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((buffer->ring = p_ring_spsc_new (sizeof (PLogRawRecord),
+							 P_LOG_BUFFER_SIZE)) == NULL)) {
+		p_free (buffer);
+		p_uthread_set_static_local (pp_log_key, NULL);
+		return NULL;
+	}
+
+	buffer->registry = registry;
+	p_atomic_int_inc (&registry->ref_count);
+
+	p_mutex_lock (registry->mutex);
+
+	buffer->next      = registry->buffers;
+	registry->buffers = buffer;
+
+	p_mutex_unlock (registry->mutex);
+
+	p_uthread_set_static_local (pp_log_key, buffer);
+
+	return buffer;
+}
+
+/* Must be called with the registry locked */
+static void
+pp_log_buffer_unlink (PLogRegistry	*registry,
+		      PLogBuffer	*buffer)
+{
+	PLogBuffer **link;
+
+	for (link = &registry->buffers; *link != NULL; link = &(*link)->next) {
+		if (*link == buffer) {
+			*link = buffer->next;
+			break;
+		}
+	}
+}
+
+static void
+pp_log_buffer_free (PLogBuffer *buffer)
+{
+	PLogRegistry *registry = buffer->registry;
+
+	if (buffer->ring != NULL)
+		p_ring_spsc_free (buffer->ring);
+
+	p_free (buffer);
+
+	pp_log_registry_unref (registry);
+}
+
+static void
+pp_log_buffer_thread_exit (ppointer data)
+{
+	PLogBuffer	*buffer = (PLogBuffer *) data;
+	PLogRegistry	*registry;
+
+	if (buffer == &pp_log_no_buffer)
+		return;
+
+	registry = buffer->registry;
+
+	p_mutex_lock (registry->mutex);
+
+	/* The writer delivers the rest of the messages before freeing */
+	if (registry->running == TRUE && registry->is_freed == FALSE) {
+		buffer->orphaned = TRUE;
+		p_mutex_unlock (registry->mutex);
+		return;
+	}
+
+	pp_log_buffer_unlink (registry, buffer);
+
+	p_mutex_unlock (registry->mutex);
+
+	pp_log_buffer_free (buffer);
+}
+
+static void
+pp_log_deliver (PLogLevel	level,
+		const pchar	*message)
+{
+	static const pchar *level_names[] = {"Debug", "Warning", "Error"};
+
+	if (pp_log_func != NULL) {
+		pp_log_func (level, message, pp_log_user_data);
+		return;
+	}
+
+	printf ("** %s: %s **\n", level_names[level], message);
+}
+
+static void
+pp_log_format (pchar		*buf,
+	       psize		size,
+	       const pchar	*message,
+	       pint		suppressed)
+{
+	pchar	suffix[48];
+	pchar	digits[16];
+	psize	suffix_len = 0;
+	psize	message_len;
+	pint	n_digits = 0;
+
+	if (suppressed > 0) {
+		while (suppressed > 0) {
+			digits[n_digits++] = (pchar) ('0' + suppressed % 10);
+			suppressed /= 10;
+		}
+
+		suffix[suffix_len++] = ' ';
+		suffix[suffix_len++] = '(';
+
+		while (n_digits > 0)
+			suffix[suffix_len++] = digits[--n_digits];
+
+		memcpy (suffix + suffix_len, " suppressed)", 12);
+		suffix_len += 12;
+	}
+
+	/* The suffix is kept in a truncated message */
+	message_len = strlen (message);
+
+	if (message_len > size - 1 - suffix_len)
+		message_len = size - 1 - suffix_len;
+
+	memcpy (buf, message, message_len);
+	memcpy (buf + message_len, suffix, suffix_len);
+
+	buf[message_len + suffix_len] = '\0';
+}
+
+static pboolean
+pp_log_site_allow (PLogSite	*site,
+		   pint		*suppressed)
+{
+	pint	limit;
+	pint	window;
+	pint	now;
+
+	*suppressed = 0;
+
+	if ((limit = p_atomic_int_get (&pp_log_rate_limit)) == 0)
+		return TRUE;
+
+	now    = (pint) time (NULL);
+	window = p_atomic_int_get (&site->window);
+
+	/* Only one thread starts a new window and takes the counter */
+	if (window != now && p_atomic_int_compare_and_exchange (&site->window, window, now) == TRUE) {
+		p_atomic_int_set (&site->count, 0);
+
+		do {
+			*suppressed = p_atomic_int_get (&site->suppressed);
+		} while (p_atomic_int_compare_and_exchange (&site->suppressed, *suppressed, 0) == FALSE);
+	}
+
+	/* Checked first to keep the counter from growing during a storm */
+	if (p_atomic_int_get (&site->count) >= limit || p_atomic_int_add (&site->count, 1) >= limit) {
+		p_atomic_int_inc (&site->suppressed);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static pboolean
+pp_log_write_async (PLogLevel	level,
+		    const pchar	*message,
+		    pint	suppressed)
+{
+	PLogBuffer	*buffer;
+	PLogRawRecord	*record;
+	psize		reserved;
+
+	buffer = (PLogBuffer *) p_uthread_get_static_local (pp_log_key);
+
+	if (P_UNLIKELY (buffer == &pp_log_no_buffer))
+		return FALSE;
+
+	if (P_UNLIKELY (buffer == NULL)) {
+		if ((buffer = pp_log_buffer_new ()) == NULL)
+			return FALSE;
+	}
+
+	record = (PLogRawRecord *) p_ring_spsc_reserve (buffer->ring, 1, &reserved);
+
+	if (P_UNLIKELY (record == NULL)) {
+		p_atomic_int64_add_explicit (&pp_log_dropped, 1, P_ATOMIC_MEMORY_ORDER_RELAXED);
+		return TRUE;
+	}
+
+	record->level = (pint) level;
+	pp_log_format (record->message, sizeof (record->message), message, suppressed);
+
+	p_ring_spsc_commit (buffer->ring, 1);
+
+	p_atomic_int_inc (&pp_log_sequence);
+
+	if (p_atomic_int_get (&pp_log_sleeping) != 0)
+		p_atomic_int_notify_one (&pp_log_sequence);
+
+	return TRUE;
+}
+
+static void
+pp_log_write (PLogLevel		level,
+	      const pchar	*message,
+	      pint		suppressed)
+{
+	pchar buf[P_LOG_MESSAGE_SIZE];
+
+	if (p_atomic_int_get (&pp_log_enabled) != 0 &&
+	    pp_log_write_async (level, message, suppressed) == TRUE)
+		return;
+
+	if (suppressed == 0) {
+		pp_log_deliver (level, message);
+		return;
+	}
+
+	pp_log_format (buf, sizeof (buf), message, suppressed);
+	pp_log_deliver (level, buf);
+}
+
+/* Must be called with the registry locked */
+static void
+pp_log_drain_buffer (PLogBuffer *buffer)
+{
+	const PLogRawRecord	*raw;
+	psize			available;
+	psize			i;
+
+	while ((raw = (const PLogRawRecord *) p_ring_spsc_peek (buffer->ring, &available)) != NULL) {
+		for (i = 0; i < available; ++i)
+			pp_log_deliver ((PLogLevel) raw[i].level, raw[i].message);
+
+		p_ring_spsc_release (buffer->ring, available);
+	}
+}
+
+/* Must be called with the registry locked */
+static void
+pp_log_drain (PLogRegistry *registry)
+{
+	PLogBuffer *buffer;
+	PLogBuffer *next;
+
+	for (buffer = registry->buffers; buffer != NULL; buffer = next) {
+		next = buffer->next;
+
+		pp_log_drain_buffer (buffer);
+
+		/* The owner has exited, nothing is written after the flag */
+		if (buffer->orphaned == TRUE) {
+			pp_log_buffer_unlink (registry, buffer);
+
+			/* The registry is referenced by the caller as well */
+			pp_log_buffer_free (buffer);
+		}
+	}
+}
+
+static ppointer
+pp_log_writer_func (ppointer data)
+{
+	PLogRegistry	*registry = (PLogRegistry *) data;
+	pint		sequence;
+
+	/* The handler may write messages as well */
+	p_uthread_set_static_local (pp_log_key, &pp_log_no_buffer);
+
+	while (p_atomic_int_get (&registry->stopping) == 0) {
+		sequence = p_atomic_int_get (&pp_log_sequence);
+
+		p_mutex_lock (registry->mutex);
+		pp_log_drain (registry);
+		p_mutex_unlock (registry->mutex);
+
+		p_atomic_int_set (&pp_log_sleeping, 1);
+
+		/* A message written after the flag is set notifies the writer */
+		if (p_atomic_int_get (&pp_log_sequence) == sequence &&
+		    p_atomic_int_get (&registry->stopping) == 0 &&
+		    p_atomic_int_wait (&pp_log_sequence, sequence, -1) == FALSE)
+			p_uthread_sleep (10);
+
+		p_atomic_int_set (&pp_log_sleeping, 0);
+	}
+
+	return NULL;
+}
+
+static void
+pp_log_init (ppointer data)
+{
+	PLogRegistry *registry;
+
+	P_UNUSED (data);
+
+	if (P_UNLIKELY ((registry = p_malloc0 (sizeof (PLogRegistry))) == NULL)) {
+		P_ERROR ("PLog::pp_log_init: failed to allocate memory");
+		return;
+	}
+
+	registry->ref_count = 1;
+
+	if (P_UNLIKELY ((registry->mutex = p_mutex_new ()) == NULL)) {
+		P_ERROR ("PLog::pp_log_init: failed to create mutex");
+		p_free (registry);
+		return;
+	}
+
+	if (P_UNLIKELY ((pp_log_key = p_uthread_static_local_new (pp_log_buffer_thread_exit)) == NULL)) {
+		P_ERROR ("PLog::pp_log_init: failed to allocate TLS key");
+		pp_log_registry_unref (registry);
+		return;
+	}
+
+	pp_log_registry = registry;
+}
+
+void
+p_log_shutdown (void)
+{
+	PLogRegistry	*registry = pp_log_registry;
+	PLogBuffer	*buffer;
+	PLogBuffer	*next;
+	PLogBuffer	*own_buffer;
+
+	/* Let the next library initialization start over */
+	pp_log_once = P_ONCE_INIT;
+
+	if (registry != NULL) {
+		p_log_stop_async ();
+
+		own_buffer = (PLogBuffer *) p_uthread_get_static_local (pp_log_key);
+
+		if (own_buffer != NULL)
+			p_uthread_set_static_local (pp_log_key, NULL);
+
+		p_uthread_static_local_free (pp_log_key);
+
+		pp_log_key      = NULL;
+		pp_log_registry = NULL;
+
+		p_mutex_lock (registry->mutex);
+
+		registry->is_freed = TRUE;
+
+		/* Buffers of the other threads stay until they exit */
+		for (buffer = registry->buffers; buffer != NULL; buffer = next) {
+			next = buffer->next;
+
+			if (buffer == own_buffer || buffer->orphaned == TRUE) {
+				pp_log_buffer_unlink (registry, buffer);
+				pp_log_buffer_free (buffer);
+				continue;
+			}
+
+			p_ring_spsc_free (buffer->ring);
+			buffer->ring = NULL;
+		}
+
+		p_mutex_unlock (registry->mutex);
+
+		pp_log_registry_unref (registry);
+	}
+
+	pp_log_func      = NULL;
+	pp_log_user_data = NULL;
+
+	p_atomic_int_set (&pp_log_rate_limit, P_LOG_DEFAULT_RATE_LIMIT);
+}
+
+P_LIB_API void
+p_log_set_handler (PLogFunc	func,
+		   ppointer	user_data)
+{
+	PLogRegistry *registry = pp_log_registry;
+
+	if (registry == NULL) {
+		pp_log_func      = func;
+		pp_log_user_data = user_data;
+		return;
+	}
+
+	p_mutex_lock (registry->mutex);
+
+	pp_log_drain (registry);
+
+	pp_log_func      = func;
+	pp_log_user_data = user_data;
+
+	p_mutex_unlock (registry->mutex);
+}
+
+P_LIB_API void
+p_log_set_rate_limit (puint messages_per_second)
+{
+	if (messages_per_second > (puint) P_MAXINT32)
+		messages_per_second = (puint) P_MAXINT32;
+
+	p_atomic_int_set (&pp_log_rate_limit, (pint) messages_per_second);
+}
+
+P_LIB_API pboolean
+p_log_start_async (void)
+{
+	PLogRegistry *registry;
+
+	/* The asynchronous mode is the only reason to set up the registry */
+	p_once (&pp_log_once, pp_log_init, NULL);
+
+	if (P_UNLIKELY ((registry = pp_log_registry) == NULL))
+		return FALSE;
+
+	p_mutex_lock (registry->mutex);
+
+	if (registry->running == TRUE) {
+		p_mutex_unlock (registry->mutex);
+		return TRUE;
+	}
+
+	p_atomic_int_set (&registry->stopping, 0);
+	p_atomic_int64_set (&pp_log_dropped, 0);
+
+	/* The writer waits for the lock until the state is complete */
+	registry->writer = p_uthread_create (pp_log_writer_func, registry, TRUE, "plog");
+
+	if (P_UNLIKELY (registry->writer == NULL)) {
+		p_mutex_unlock (registry->mutex);
+		return FALSE;
+	}
+
+	registry->running = TRUE;
+	p_atomic_int_set (&pp_log_enabled, 1);
+
+	p_mutex_unlock (registry->mutex);
+
+	return TRUE;
+}
+
+P_LIB_API void
+p_log_stop_async (void)
+{
+	PLogRegistry *registry = pp_log_registry;
+
+	if (P_UNLIKELY (registry == NULL))
+		return;
+
+	p_mutex_lock (registry->mutex);
+
+	if (registry->running == FALSE || p_atomic_int_get (&registry->stopping) != 0) {
+		p_mutex_unlock (registry->mutex);
+		return;
+	}
+
+	p_atomic_int_set (&pp_log_enabled, 0);
+	p_atomic_int_set (&registry->stopping, 1);
+
+	p_mutex_unlock (registry->mutex);
+
+	p_atomic_int_inc (&pp_log_sequence);
+	p_atomic_int_notify_one (&pp_log_sequence);
+
+	p_uthread_join (registry->writer);
+	p_uthread_unref (registry->writer);
+
+	p_mutex_lock (registry->mutex);
+
+	pp_log_drain (registry);
+
+	registry->writer  = NULL;
+	registry->running = FALSE;
+
+	p_mutex_unlock (registry->mutex);
+}
+
+P_LIB_API pboolean
+p_log_is_async (void)
+{
+	return p_atomic_int_get (&pp_log_enabled) != 0;
+}
+
+P_LIB_API void
+p_log_flush (void)
+{
+	PLogRegistry *registry = pp_log_registry;
+
+	if (P_UNLIKELY (registry == NULL) || p_atomic_int_get (&pp_log_enabled) == 0)
+		return;
+
+	p_mutex_lock (registry->mutex);
+	pp_log_drain (registry);
+	p_mutex_unlock (registry->mutex);
+}
+
+P_LIB_API puint64
+p_log_get_dropped (void)
+{
+	return (puint64) p_atomic_int64_get (&pp_log_dropped);
+}
+
+P_LIB_API void
+p_log_write (PLogLevel		level,
+	     const pchar	*message)
+{
+	if (P_UNLIKELY (message == NULL || level < P_LOG_LEVEL_DEBUG || level > P_LOG_LEVEL_ERROR))
+		return;
+
+	pp_log_write (level, message, 0);
+}
+
+P_LIB_API void
+p_log_write_site (int		level,
+		  PLogSite	*site,
+		  const char	*msg)
+{
+	pint suppressed = 0;
+
+	if (P_UNLIKELY (msg == NULL || level < P_LOG_LEVEL_DEBUG || level > P_LOG_LEVEL_ERROR))
+		return;
+
+	if (site != NULL && pp_log_site_allow (site, &suppressed) == FALSE)
+		return;
+
+	pp_log_write ((PLogLevel) level, msg, suppressed);
+}
@@ -0,0 +1,178 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file plog.h
+ * @brief Logging
+ * @author Alexander Saprykin
+ *
+ * The library reports unexpected conditions with the #P_ERROR, #P_WARNING and
+ * #P_DEBUG macros, the application can use them as well. By default a message
+ * is printed to stdout in the calling thread, p_log_set_handler() allows to
+ * pass the messages somewhere else.
+ *
+ * Writing to a terminal or a file from many threads at once serializes them
+ * on the stream, so a storm of errors (i.e. failed allocations or socket
+ * errors in a tight loop) may slow down the whole program. Two mechanisms
+ * keep it bounded:
+ * - every call site of the macros is rate limited: after
+ *   p_log_set_rate_limit() messages within a second the rest of the messages
+ *   from the same site are suppressed, the first message in the next second
+ *   reports how many were suppressed;
+ * - p_log_start_async() starts a writer thread: every thread copies its
+ *   messages into its own lock-free ring buffer and the writer thread passes
+ *   them to the handler. A message is truncated to #P_LOG_MESSAGE_SIZE bytes,
+ *   when a buffer is full new messages of the thread are dropped and counted,
+ *   see p_log_get_dropped().
+ *
+ * The debug messages can be removed at compile time with #P_LOG_MIN_LEVEL.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PLOG_H
+#define PLIBSYS_HEADER_PLOG_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+
+P_BEGIN_DECLS
+
+/** Number of messages the buffer of each thread can hold in the asynchronous
+ * mode. */
+#define P_LOG_BUFFER_SIZE		256
+
+/** Maximum length of a message in the asynchronous mode, including the
+ * terminating zero. */
+#define P_LOG_MESSAGE_SIZE		252
+
+/** Default number of messages per second allowed from a single call site. */
+#define P_LOG_DEFAULT_RATE_LIMIT	20
+
+/** Log message level. */
+typedef enum PLogLevel_ {
+	P_LOG_LEVEL_DEBUG	= 0,	/**< Debug message, see #P_DEBUG.	*/
+	P_LOG_LEVEL_WARNING	= 1,	/**< Warning, see #P_WARNING.		*/
+	P_LOG_LEVEL_ERROR	= 2	/**< Error, see #P_ERROR.		*/
+} PLogLevel;
+
+/**
+ * @brief Log handler receiving the messages.
+ * @param level Message level.
+ * @param message Message text, valid during the call only.
+ * @param user_data Data passed to p_log_set_handler().
+ * @since 0.0.5
+ *
+ * In the synchronous mode the handler is called from the thread writing the
+ * message, in the asynchronous one from the writer thread and from
+ * p_log_flush(), never concurrently. It must not call p_log_flush() or stop
+ * the asynchronous mode.
+ */
+typedef void (*PLogFunc) (PLogLevel level, const pchar *message, ppointer user_data);
+
+/**
+ * @brief Sets the log handler.
+ * @param func Handler to pass the messages to, NULL to restore the default
+ * one printing to stdout.
+ * @param user_data Data to pass to @a func.
+ * @since 0.0.5
+ *
+ * The messages buffered in the asynchronous mode are passed to the previous
+ * handler first. In the synchronous mode the handler should be set while no
+ * other thread writes messages. The library shutdown restores the default
+ * handler.
+ */
+P_LIB_API void		p_log_set_handler	(PLogFunc		func,
+						 ppointer		user_data);
+
+/**
+ * @brief Sets the number of messages per second allowed from a single call
+ * site of the logging macros.
+ * @param messages_per_second Number of messages, 0 to disable the rate
+ * limiting.
+ * @since 0.0.5
+ *
+ * The default is #P_LOG_DEFAULT_RATE_LIMIT, it is restored on the library
+ * shutdown. p_log_write() is not rate limited.
+ */
+P_LIB_API void		p_log_set_rate_limit	(puint			messages_per_second);
+
+/**
+ * @brief Starts passing the messages to the handler from a writer thread.
+ * @return TRUE in case of success or if the asynchronous mode is already
+ * started, FALSE if the writer thread failed to start.
+ * @since 0.0.5
+ *
+ * The library shutdown stops the asynchronous mode.
+ */
+P_LIB_API pboolean	p_log_start_async	(void);
+
+/**
+ * @brief Stops the asynchronous mode.
+ * @since 0.0.5
+ *
+ * Waits for the writer thread to finish and passes all the buffered messages
+ * to the handler before returning.
+ */
+P_LIB_API void		p_log_stop_async	(void);
+
+/**
+ * @brief Checks whether the asynchronous mode is started.
+ * @return TRUE if the asynchronous mode is started, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_log_is_async		(void);
+
+/**
+ * @brief Passes the messages buffered in the asynchronous mode to the handler.
+ * @since 0.0.5
+ *
+ * Only the messages written before the call are guaranteed to be passed.
+ * Does nothing in the synchronous mode.
+ */
+P_LIB_API void		p_log_flush		(void);
+
+/**
+ * @brief Gets the number of messages dropped because of full buffers since
+ * the last p_log_start_async().
+ * @return Number of dropped messages.
+ * @since 0.0.5
+ */
+P_LIB_API puint64	p_log_get_dropped	(void);
+
+/**
+ * @brief Writes a message into the log without rate limiting.
+ * @param level Message level.
+ * @param message Message to write.
+ * @since 0.0.5
+ */
+P_LIB_API void		p_log_write		(PLogLevel		level,
+						 const pchar		*message);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PLOG_H */
@@ -48,6 +48,7 @@
 #include "pmacrosos.h"
 
 #include <stdio.h>
+#include <stddef.h>
 
 /* For Clang */
 #ifndef __has_attribute
@@ -159,6 +160,42 @@
 #  define P_NO_RETURN
 #endif
 
+/**
+ * @def P_ALIGNED
+ * @brief Aligns a variable, a structure member or a type to a given boundary.
+ * @param n Alignment in bytes, must be an integer literal power of two.
+ * @since 0.0.5
+ *
+ * Place it before the declaration, i.e. `static P_ALIGNED (16) pint32 v[4];`.
+ * An aligned member makes the size of the structure a multiple of @a n. Heap
+ * objects of such types must be allocated with p_malloc_aligned(). Expands to
+ * nothing for compilers without alignment attributes, so don't rely on it for
+ * correctness.
+ */
+
+/**
+ * @def P_CACHE_ALIGNED
+ * @brief Aligns a variable, a structure member or a type to the cache line.
+ * @since 0.0.5
+ *
+ * Same as #P_ALIGNED with #P_CACHE_LINE_SIZE, keeps data written by different
+ * threads on different cache lines.
+ */
+
+#if defined(P_CC_MSVC)
+#  define P_ALIGNED(n) __declspec(align(n))
+#elif __has_attribute(aligned) || \
+      defined(P_CC_GNU) || \
+      defined(P_CC_INTEL) || \
+     (defined(P_CC_SUN) && __SUNPRO_C >= 0x590) || \
+     (defined(P_CC_SUN) && __SUNPRO_CC >= 0x590)
+#  define P_ALIGNED(n) __attribute__((aligned(n)))
+#else
+#  define P_ALIGNED(n)
+#endif
+
+#define P_CACHE_ALIGNED P_ALIGNED(P_CACHE_LINE_SIZE)
+
 /**
  * @def P_LIKELY
  * @brief Hints a compiler that a condition is likely to be true so it can
@@ -191,29 +228,80 @@
  */
 #define P_UNUSED(a) ((void) a)
 
+/**
+ * @def P_CONTAINER_OF
+ * @brief Gets a pointer to a structure from a pointer to its member.
+ * @param ptr Pointer to the member.
+ * @param type Type of the structure.
+ * @param member Name of the member in the structure.
+ * @since 0.0.5
+ *
+ * Used with the intrusive containers to get from an embedded link (i.e.
+ * #PTreeLink or #PListLink) to the structure holding it.
+ */
+#define P_CONTAINER_OF(ptr, type, member) ((type *) ((pchar *) (ptr) - offsetof (type, member)))
+
+/**
+ * @def P_LOG_MIN_LEVEL
+ * @brief Lowest level of the messages compiled in by #P_DEBUG, #P_WARNING and
+ * #P_ERROR.
+ * @since 0.0.5
+ *
+ * 0 keeps all the messages, 1 removes the debug ones and 2 keeps the errors
+ * only. Define it before including plibsys.h to override the default, which
+ * removes the debug messages if NDEBUG is defined. The removed calls are not
+ * evaluated at all.
+ */
+#ifndef P_LOG_MIN_LEVEL
+#  ifdef NDEBUG
+#    define P_LOG_MIN_LEVEL 1
+#  else
+#    define P_LOG_MIN_LEVEL 0
+#  endif
+#endif
+
+/* Each call site keeps its own rate limiting state, see plog.h */
+#define P_LOG_SITE_WRITE(level, msg)						\
+	do {									\
+		if ((level) >= P_LOG_MIN_LEVEL) {				\
+			static PLogSite p_log_site_ = {0, 0, 0};		\
+			p_log_write_site ((level), &p_log_site_, (msg));	\
+		}								\
+	} while (0)
+
 /**
  * @def P_WARNING
- * @brief Prints a warning message.
- * @param msg Message to print.
+ * @brief Writes a warning message into the log.
+ * @param msg Message to write.
  * @since 0.0.1
+ *
+ * Prints the message to stdout unless another handler is set with
+ * p_log_set_handler(), see plog.h.
  */
-#define P_WARNING(msg) printf ("** Warning: %s **\n", msg)
+#define P_WARNING(msg) P_LOG_SITE_WRITE (1, msg)
 
 /**
  * @def P_ERROR
- * @brief Prints an error message.
- * @param msg Message to print.
+ * @brief Writes an error message into the log.
+ * @param msg Message to write.
  * @since 0.0.1
+ *
+ * Prints the message to stdout unless another handler is set with
+ * p_log_set_handler(), see plog.h.
  */
-#define P_ERROR(msg) printf ("** Error: %s **\n", msg)
+#define P_ERROR(msg) P_LOG_SITE_WRITE (2, msg)
 
 /**
  * @def P_DEBUG
- * @brief Prints a debug message.
- * @param msg Message to print.
+ * @brief Writes a debug message into the log.
+ * @param msg Message to write.
  * @since 0.0.1
+ *
+ * Prints the message to stdout unless another handler is set with
+ * p_log_set_handler(), see plog.h. Removed at compile time depending on
+ * #P_LOG_MIN_LEVEL.
  */
-#define P_DEBUG(msg) printf ("** Debug: %s **\n", msg)
+#define P_DEBUG(msg) P_LOG_SITE_WRITE (0, msg)
 
 #ifdef DOXYGEN
 #  define PLIBSYS_VERSION_MAJOR
@@ -299,4 +387,19 @@
 #  define P_END_DECLS
 #endif
 
+/* Rate limiting state of a logging call site, the fields are private */
+typedef struct PLogSite_ {
+	volatile int	window;
+	volatile int	count;
+	volatile int	suppressed;
+} PLogSite;
+
+P_BEGIN_DECLS
+
+/* Used by the logging macros, plain C types only as ptypes.h includes this
+ * header */
+P_LIB_API void p_log_write_site (int level, PLogSite *site, const char *msg);
+
+P_END_DECLS
+
 #endif /* PLIBSYS_HEADER_PMACROS_H */
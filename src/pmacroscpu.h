@@ -528,6 +528,24 @@
 
 /* We need this to generate full Doxygen documentation */
 
+/**
+ * @def P_CACHE_LINE_SIZE
+ * @brief Assumed size of the CPU cache line in bytes.
+ * @since 0.0.5
+ *
+ * The value is a compile-time guess for the target architecture: 128 bytes
+ * for PowerPC and Apple ARM64 CPUs, 64 bytes for the others. Data contended by
+ * several threads is aligned and padded to it to avoid false sharing, see
+ * #P_CACHE_ALIGNED. The actual size of the running CPU can be obtained with
+ * p_cpu_topology_detect_cache_line_size().
+ */
+
+#if defined (P_CPU_POWER) || (defined (P_CPU_ARM_64) && defined (__APPLE__))
+#  define P_CACHE_LINE_SIZE 128
+#else
+#  define P_CACHE_LINE_SIZE 64
+#endif
+
 #ifdef DOXYGEN
 #  ifndef P_CPU_ALPHA
 #    define P_CPU_ALPHA
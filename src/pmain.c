@@ -30,8 +30,11 @@ extern void p_mem_init			(void);
 extern void p_mem_shutdown		(void);
 extern void p_atomic_thread_init	(void);
 extern void p_atomic_thread_shutdown	(void);
+extern void p_atomic_wait_shutdown	(void);
 extern void p_socket_init_once		(void);
 extern void p_socket_close_once		(void);
+extern void p_socket_cache_shutdown	(void);
+extern void p_socket_address_shutdown	(void);
 extern void p_uthread_init		(void);
 extern void p_uthread_shutdown		(void);
 extern void p_cond_variable_init	(void);
@@ -40,8 +43,16 @@ extern void p_rwlock_init		(void);
 extern void p_rwlock_shutdown		(void);
 extern void p_time_profiler_init	(void);
 extern void p_time_profiler_shutdown	(void);
+extern void p_lock_stats_init		(void);
+extern void p_lock_stats_shutdown	(void);
+extern void p_trace_shutdown		(void);
+extern void p_metrics_shutdown		(void);
+extern void p_future_shutdown		(void);
+extern void p_parallel_shutdown		(void);
 extern void p_library_loader_init	(void);
 extern void p_library_loader_shutdown	(void);
+extern void p_process_shutdown		(void);
+extern void p_log_shutdown		(void);
 
 static pboolean pp_plibsys_inited = FALSE;
 static pchar pp_plibsys_version[] = PLIBSYS_VERSION_STR;
@@ -61,6 +72,7 @@ p_libsys_init (void)
 	p_cond_variable_init ();
 	p_rwlock_init ();
 	p_time_profiler_init ();
+	p_lock_stats_init ();
 	p_library_loader_init ();
 }
 
@@ -81,9 +93,20 @@ p_libsys_shutdown (void)
 
 	pp_plibsys_inited = FALSE;
 
-	p_library_loader_init ();
+	/* The other subsystems may still write messages synchronously */
+	p_log_shutdown ();
+	p_process_shutdown ();
+	p_library_loader_shutdown ();
+	p_metrics_shutdown ();
+	p_future_shutdown ();
+	p_socket_cache_shutdown ();
+	p_socket_address_shutdown ();
+	p_parallel_shutdown ();
+	p_trace_shutdown ();
+	p_lock_stats_shutdown ();
 	p_time_profiler_shutdown ();
 	p_rwlock_shutdown ();
+	p_atomic_wait_shutdown ();
 	p_cond_variable_shutdown ();
 	p_uthread_shutdown ();
 	p_socket_close_once ();
@@ -39,12 +39,25 @@
  * internal library call. This way you can ensure to use provided memory
  * management everywhere (even for library initialization).
  *
+ * Only the core subsystems (memory, threads, sockets) are set up by
+ * p_libsys_init(), the optional ones (tracing, metrics, time profiler clock
+ * calibration, atomic wait buckets, process statistics, the future, socket
+ * and socket address object pools, the parallel loop scheduler and the
+ * asynchronous log writer) are
+ * initialized lazily on their first use with #POnce, so that short-lived
+ * programs don't pay for what they don't use.
+ *
  * When you do not need the library anymore release used resourses with the
  * p_libsys_shutdown() routine. You should only call it once, too. This call is
  * not MT-safe (because it also deinitializes the threading subsystem itself),
  * so it is best to place it in the program's main thread, when the program
  * finishes.
  *
+ * Free the objects created by the library, i.e. sockets and socket addresses,
+ * before the shutdown. Objects recycled through the internal pools keep their
+ * memory after p_libsys_shutdown() if still alive, so they are safe to use and
+ * free, but that memory is not reclaimed until the program exits.
+ *
  * It is not recommended to call the initialization and deinitialization
  * routines on Windows in the DllMain() call because it may require libraries
  * other than kernel32.dll.
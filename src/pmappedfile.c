@@ -0,0 +1,506 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "perror.h"
+#include "pmappedfile.h"
+#include "pmem.h"
+#include "perror-private.h"
+
+#if defined (P_OS_BEOS) || defined (P_OS_OS2) || defined (P_OS_AMIGA)
+#  define P_MAPPED_FILE_NONE
+#elif !defined (P_OS_WIN)
+#  include "psysclose-private.h"
+
+#  include <unistd.h>
+#  include <sys/types.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <fcntl.h>
+#endif
+
+#ifdef P_OS_WIN
+/* Older SDKs lack the declarations for PrefetchVirtualMemory() */
+typedef struct PMappedFileMemoryRange_ {
+	PVOID	addr;
+	SIZE_T	n_bytes;
+} PMappedFileMemoryRange;
+
+typedef BOOL (WINAPI * PMappedFilePrefetchFunc) (HANDLE			process,
+						 ULONG_PTR		n_entries,
+						 PMappedFileMemoryRange	*entries,
+						 ULONG			flags);
+#endif
+
+struct PMappedFile_ {
+	ppointer		addr;
+	psize			size;
+	PMappedFileAccess	access;
+#ifdef P_OS_WIN
+	HANDLE			file_hdl;
+#endif
+};
+
+#ifndef P_MAPPED_FILE_NONE
+static psize pp_mapped_file_get_page_size (void);
+static pboolean pp_mapped_file_map (PMappedFile *file, const pchar *path, PError **error);
+static void pp_mapped_file_unmap (PMappedFile *file);
+
+static psize
+pp_mapped_file_get_page_size (void)
+{
+#  ifdef P_OS_WIN
+	SYSTEM_INFO	sys_info;
+
+	GetSystemInfo (&sys_info);
+
+	return (psize) sys_info.dwPageSize;
+#  else
+	long		page_size;
+
+#    if defined (_SC_PAGESIZE)
+	page_size = sysconf (_SC_PAGESIZE);
+#    elif defined (_SC_PAGE_SIZE)
+	page_size = sysconf (_SC_PAGE_SIZE);
+#    else
+	page_size = getpagesize ();
+#    endif
+
+	return page_size > 0 ? (psize) page_size : 4096;
+#  endif
+}
+
+#  ifdef P_OS_WIN
+static pboolean
+pp_mapped_file_map (PMappedFile		*file,
+		    const pchar		*path,
+		    PError		**error)
+{
+	HANDLE		map_hdl;
+	LARGE_INTEGER	file_size;
+	DWORD		file_access;
+	DWORD		protect;
+	DWORD		map_access;
+
+	if (file->access == P_MAPPED_FILE_ACCESS_READONLY) {
+		file_access = GENERIC_READ;
+		protect     = PAGE_READONLY;
+		map_access  = FILE_MAP_READ;
+	} else {
+		file_access = GENERIC_READ | GENERIC_WRITE;
+		protect     = PAGE_READWRITE;
+		map_access  = FILE_MAP_READ | FILE_MAP_WRITE;
+	}
+
+	file->file_hdl = CreateFileA ((LPCSTR) path,
+				      file_access,
+				      FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+				      NULL,
+				      OPEN_EXISTING,
+				      FILE_ATTRIBUTE_NORMAL,
+				      NULL);
+
+	if (P_UNLIKELY (file->file_hdl == INVALID_HANDLE_VALUE)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call CreateFileA() to open file");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (GetFileSizeEx (file->file_hdl, &file_size) == 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call GetFileSizeEx() to get file size");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY ((puint64) file_size.QuadPart > (puint64) ((psize) -1))) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "File is too large to be mapped");
+		return FALSE;
+	}
+
+	file->size = (psize) file_size.QuadPart;
+
+	/* Empty files can't be mapped */
+	if (file->size == 0)
+		return TRUE;
+
+	if (P_UNLIKELY ((map_hdl = CreateFileMappingA (file->file_hdl,
+						      NULL,
+						      protect,
+						      0,
+						      0,
+						      NULL)) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call CreateFileMappingA() to create file mapping");
+		return FALSE;
+	}
+
+	file->addr = MapViewOfFile (map_hdl, map_access, 0, 0, 0);
+
+	if (P_UNLIKELY (file->addr == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call MapViewOfFile() to map file view");
+		CloseHandle (map_hdl);
+		return FALSE;
+	}
+
+	/* The view keeps the mapping object alive */
+	if (P_UNLIKELY (CloseHandle (map_hdl) == 0))
+		P_WARNING ("PMappedFile::pp_mapped_file_map: CloseHandle() failed");
+
+	return TRUE;
+}
+
+static void
+pp_mapped_file_unmap (PMappedFile *file)
+{
+	if (file->addr != NULL && P_UNLIKELY (UnmapViewOfFile (file->addr) == 0))
+		P_WARNING ("PMappedFile::pp_mapped_file_unmap: UnmapViewOfFile() failed");
+
+	if (file->file_hdl != INVALID_HANDLE_VALUE && P_UNLIKELY (CloseHandle (file->file_hdl) == 0))
+		P_WARNING ("PMappedFile::pp_mapped_file_unmap: CloseHandle() failed");
+
+	file->addr     = NULL;
+	file->file_hdl = INVALID_HANDLE_VALUE;
+}
+#  else
+static pboolean
+pp_mapped_file_map (PMappedFile		*file,
+		    const pchar		*path,
+		    PError		**error)
+{
+	struct stat	stat_buf;
+	pint		fd;
+	pint		prot;
+
+	if (file->access == P_MAPPED_FILE_ACCESS_READONLY)
+		fd = open (path, O_RDONLY);
+	else
+		fd = open (path, O_RDWR);
+
+	if (P_UNLIKELY (fd == -1)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call open() to open file");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (fstat (fd, &stat_buf) == -1)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call fstat() to get file size");
+
+		if (P_UNLIKELY (p_sys_close (fd) != 0))
+			P_WARNING ("PMappedFile::pp_mapped_file_map: p_sys_close() failed(1)");
+
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (stat_buf.st_size < 0 || (puint64) stat_buf.st_size > (puint64) ((psize) -1))) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "File is too large to be mapped");
+
+		if (P_UNLIKELY (p_sys_close (fd) != 0))
+			P_WARNING ("PMappedFile::pp_mapped_file_map: p_sys_close() failed(2)");
+
+		return FALSE;
+	}
+
+	file->size = (psize) stat_buf.st_size;
+
+	/* Empty files can't be mapped */
+	if (file->size > 0) {
+		prot = (file->access == P_MAPPED_FILE_ACCESS_READONLY) ? PROT_READ : PROT_READ | PROT_WRITE;
+
+		if (P_UNLIKELY ((file->addr = mmap (NULL,
+						    file->size,
+						    prot,
+						    MAP_SHARED,
+						    fd,
+						    0)) == (void *) -1)) {
+			p_error_set_error_p (error,
+					     (pint) p_error_get_last_io (),
+					     p_error_get_last_system (),
+					     "Failed to call mmap() to map file");
+			file->addr = NULL;
+
+			if (P_UNLIKELY (p_sys_close (fd) != 0))
+				P_WARNING ("PMappedFile::pp_mapped_file_map: p_sys_close() failed(3)");
+
+			return FALSE;
+		}
+	}
+
+	/* The mapping keeps the file alive */
+	if (P_UNLIKELY (p_sys_close (fd) != 0))
+		P_WARNING ("PMappedFile::pp_mapped_file_map: p_sys_close() failed(4)");
+
+	return TRUE;
+}
+
+static void
+pp_mapped_file_unmap (PMappedFile *file)
+{
+	if (file->addr != NULL && P_UNLIKELY (munmap (file->addr, file->size) != 0))
+		P_WARNING ("PMappedFile::pp_mapped_file_unmap: munmap() failed");
+
+	file->addr = NULL;
+}
+#  endif
+#endif /* !P_MAPPED_FILE_NONE */
+
+P_LIB_API PMappedFile *
+p_mapped_file_new (const pchar		*path,
+		   PMappedFileAccess	access,
+		   PError		**error)
+{
+	PMappedFile *ret;
+
+	if (P_UNLIKELY (path == NULL ||
+			(access != P_MAPPED_FILE_ACCESS_READONLY &&
+			 access != P_MAPPED_FILE_ACCESS_READWRITE))) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return NULL;
+	}
+
+#ifdef P_MAPPED_FILE_NONE
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IO_NOT_IMPLEMENTED,
+			     0,
+			     "No memory mapped files implementation");
+
+	P_UNUSED (ret);
+
+	return NULL;
+#else
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PMappedFile))) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for mapped file");
+		return NULL;
+	}
+
+	ret->access = access;
+#  ifdef P_OS_WIN
+	ret->file_hdl = INVALID_HANDLE_VALUE;
+#  endif
+
+	if (P_UNLIKELY (pp_mapped_file_map (ret, path, error) == FALSE)) {
+		p_mapped_file_free (ret);
+		return NULL;
+	}
+
+	return ret;
+#endif
+}
+
+P_LIB_API ppointer
+p_mapped_file_get_address (const PMappedFile *file)
+{
+	if (P_UNLIKELY (file == NULL))
+		return NULL;
+
+	return file->addr;
+}
+
+P_LIB_API psize
+p_mapped_file_get_size (const PMappedFile *file)
+{
+	if (P_UNLIKELY (file == NULL))
+		return 0;
+
+	return file->size;
+}
+
+P_LIB_API pboolean
+p_mapped_file_advise (PMappedFile		*file,
+		      psize			offset,
+		      psize			length,
+		      PMappedFileAdvice		advice,
+		      PError			**error)
+{
+#if defined (P_OS_WIN)
+	HMODULE			hmodule;
+	PMappedFilePrefetchFunc	prefetch_func;
+	PMappedFileMemoryRange	range;
+#elif !defined (P_MAPPED_FILE_NONE)
+	pint			sys_advice;
+#endif
+#ifndef P_MAPPED_FILE_NONE
+	psize			page_offset;
+#endif
+
+	if (P_UNLIKELY (file == NULL || offset > file->size ||
+			advice < P_MAPPED_FILE_ADVICE_NORMAL ||
+			advice > P_MAPPED_FILE_ADVICE_DONTNEED)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	if (length == 0 || length > file->size - offset)
+		length = file->size - offset;
+
+	if (length == 0)
+		return TRUE;
+
+#ifndef P_MAPPED_FILE_NONE
+	/* Hints work on whole pages only */
+	page_offset = offset % pp_mapped_file_get_page_size ();
+	offset     -= page_offset;
+	length     += page_offset;
+#endif
+
+#if defined (P_OS_WIN)
+	if (advice != P_MAPPED_FILE_ADVICE_WILLNEED)
+		return TRUE;
+
+	if (P_UNLIKELY ((hmodule = GetModuleHandleA ("kernel32.dll")) == NULL))
+		return TRUE;
+
+	prefetch_func = (PMappedFilePrefetchFunc) GetProcAddress (hmodule, "PrefetchVirtualMemory");
+
+	if (prefetch_func == NULL)
+		return TRUE;
+
+	range.addr    = (PVOID) ((pchar *) file->addr + offset);
+	range.n_bytes = (SIZE_T) length;
+
+	if (P_UNLIKELY (prefetch_func (GetCurrentProcess (), 1, &range, 0) == 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call PrefetchVirtualMemory() to read pages");
+		return FALSE;
+	}
+#elif !defined (P_MAPPED_FILE_NONE) && defined (MADV_NORMAL)
+	switch (advice) {
+	case P_MAPPED_FILE_ADVICE_SEQUENTIAL:
+		sys_advice = MADV_SEQUENTIAL;
+		break;
+	case P_MAPPED_FILE_ADVICE_RANDOM:
+		sys_advice = MADV_RANDOM;
+		break;
+	case P_MAPPED_FILE_ADVICE_WILLNEED:
+		sys_advice = MADV_WILLNEED;
+		break;
+	case P_MAPPED_FILE_ADVICE_DONTNEED:
+		sys_advice = MADV_DONTNEED;
+		break;
+	default:
+		sys_advice = MADV_NORMAL;
+		break;
+	}
+
+	if (P_UNLIKELY (madvise ((pchar *) file->addr + offset, length, sys_advice) != 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call madvise() to set access pattern");
+		return FALSE;
+	}
+#elif !defined (P_MAPPED_FILE_NONE)
+	P_UNUSED (sys_advice);
+#endif
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_mapped_file_sync (PMappedFile	*file,
+		    PError	**error)
+{
+	if (P_UNLIKELY (file == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	if (file->access == P_MAPPED_FILE_ACCESS_READONLY || file->addr == NULL)
+		return TRUE;
+
+#if defined (P_OS_WIN)
+	if (P_UNLIKELY (FlushViewOfFile (file->addr, 0) == 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call FlushViewOfFile() to write pages");
+		return FALSE;
+	}
+
+	/* FlushViewOfFile() doesn't wait for the disk */
+	if (P_UNLIKELY (FlushFileBuffers (file->file_hdl) == 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call FlushFileBuffers() to write file");
+		return FALSE;
+	}
+#elif !defined (P_MAPPED_FILE_NONE)
+	if (P_UNLIKELY (msync (file->addr, file->size, MS_SYNC) != 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call msync() to write pages");
+		return FALSE;
+	}
+#endif
+
+	return TRUE;
+}
+
+P_LIB_API void
+p_mapped_file_free (PMappedFile *file)
+{
+	if (P_UNLIKELY (file == NULL))
+		return;
+
+#ifndef P_MAPPED_FILE_NONE
+	pp_mapped_file_unmap (file);
+#endif
+
+	p_free (file);
+}
@@ -0,0 +1,170 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pmappedfile.h
+ * @brief Memory mapped files
+ * @author Alexander Saprykin
+ *
+ * A memory mapped file exposes the contents of a file on the disk as a plain
+ * memory block: the pages are read by the system on demand when they are
+ * touched, without copying the data through the stdio buffers. This is the
+ * fastest way to read large data files.
+ *
+ * Use p_mapped_file_new() to map a whole file for reading only or for reading
+ * and writing. The address and the size of the mapping are available through
+ * p_mapped_file_get_address() and p_mapped_file_get_size(). The size of the
+ * file is taken at the mapping time and can't be changed through the mapping.
+ *
+ * Changes made to a read-write mapping are written back to the file by the
+ * system at some point, call p_mapped_file_sync() to write them immediately.
+ *
+ * p_mapped_file_advise() gives the system a hint about the expected access
+ * pattern, so it can read ahead more aggressively or stop doing it. Hints are
+ * advisory and ignored where the system doesn't support them.
+ *
+ * An empty file has no mapping: the address is NULL and the size is zero.
+ *
+ * Memory mapped files are supported on Windows and UNIX systems, on the other
+ * systems p_mapped_file_new() fails with #P_ERROR_IO_NOT_IMPLEMENTED.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PMAPPEDFILE_H
+#define PLIBSYS_HEADER_PMAPPEDFILE_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+#include "perror.h"
+
+P_BEGIN_DECLS
+
+/** Memory mapped file opaque data structure. */
+typedef struct PMappedFile_ PMappedFile;
+
+/** Memory mapped file access permissions. */
+typedef enum PMappedFileAccess_ {
+	P_MAPPED_FILE_ACCESS_READONLY	= 0,	/**< Read-only access.	*/
+	P_MAPPED_FILE_ACCESS_READWRITE	= 1	/**< Read/write access.	*/
+} PMappedFileAccess;
+
+/** Expected access pattern of a memory mapped file. */
+typedef enum PMappedFileAdvice_ {
+	P_MAPPED_FILE_ADVICE_NORMAL	= 0,	/**< No special treatment.			*/
+	P_MAPPED_FILE_ADVICE_SEQUENTIAL	= 1,	/**< Pages are accessed in order, read ahead
+						     aggressively.				*/
+	P_MAPPED_FILE_ADVICE_RANDOM	= 2,	/**< Pages are accessed randomly, don't read
+						     ahead.					*/
+	P_MAPPED_FILE_ADVICE_WILLNEED	= 3,	/**< Pages will be accessed soon, start reading
+						     them now.					*/
+	P_MAPPED_FILE_ADVICE_DONTNEED	= 4	/**< Pages won't be accessed soon, they may be
+						     dropped from memory.			*/
+} PMappedFileAdvice;
+
+/**
+ * @brief Maps a whole file into memory.
+ * @param path Path to the file.
+ * @param access Access permissions for the mapping.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Pointer to the newly created #PMappedFile in case of success, NULL
+ * otherwise.
+ * @since 0.0.5
+ *
+ * The file should exist and be opened with the same permissions. A file can
+ * be closed or removed while it's still mapped, the mapping stays valid.
+ */
+P_LIB_API PMappedFile *	p_mapped_file_new		(const pchar		*path,
+							 PMappedFileAccess	access,
+							 PError			**error);
+
+/**
+ * @brief Gets the starting address of a memory mapped file.
+ * @param file #PMappedFile to get the address for.
+ * @return Pointer to the mapped contents of the file, NULL for an empty file
+ * or in case of error.
+ * @since 0.0.5
+ */
+P_LIB_API ppointer	p_mapped_file_get_address	(const PMappedFile	*file);
+
+/**
+ * @brief Gets the size of a memory mapped file.
+ * @param file #PMappedFile to get the size for.
+ * @return Size of the mapping in bytes in case of success, 0 otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API psize		p_mapped_file_get_size		(const PMappedFile	*file);
+
+/**
+ * @brief Gives the system a hint about the expected access pattern.
+ * @param file #PMappedFile to give the hint for.
+ * @param offset Starting offset of the range in bytes.
+ * @param length Length of the range in bytes, 0 means up to the end of the
+ * file.
+ * @param advice Expected access pattern.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The range is extended to the page boundaries. The hint is only a hint: it
+ * doesn't change the contents of the mapping and does nothing where the system
+ * doesn't support it, in which case TRUE is returned. Windows supports only
+ * #P_MAPPED_FILE_ADVICE_WILLNEED (since Windows 8).
+ */
+P_LIB_API pboolean	p_mapped_file_advise		(PMappedFile		*file,
+							 psize			offset,
+							 psize			length,
+							 PMappedFileAdvice	advice,
+							 PError			**error);
+
+/**
+ * @brief Writes the changes made to a memory mapped file back to the disk.
+ * @param file #PMappedFile to write the changes for.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * Returns immediately with TRUE for read-only mappings. The call blocks until
+ * the data is written.
+ */
+P_LIB_API pboolean	p_mapped_file_sync		(PMappedFile		*file,
+							 PError			**error);
+
+/**
+ * @brief Unmaps a file and frees a #PMappedFile object.
+ * @param file #PMappedFile to free.
+ * @since 0.0.5
+ *
+ * The pointer obtained with p_mapped_file_get_address() becomes invalid.
+ * Pending changes are written to the file by the system later, use
+ * p_mapped_file_sync() before to make sure they are written.
+ */
+P_LIB_API void		p_mapped_file_free		(PMappedFile		*file);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PMAPPEDFILE_H */
@@ -0,0 +1,978 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "pfasthash.h"
+#include "pfile.h"
+#include "pmappedfile.h"
+#include "pmappedtable.h"
+#include "pmem.h"
+#include "psort.h"
+
+#include <string.h>
+
+#define P_MAPPED_TABLE_MAGIC		"PLIBMTBL"
+#define P_MAPPED_TABLE_MAGIC_SIZE	8
+#define P_MAPPED_TABLE_VERSION		1
+#define P_MAPPED_TABLE_BYTE_ORDER	0x01020304U
+
+/* Alignment of all the records and data in the file */
+#define P_MAPPED_TABLE_ALIGNMENT	8
+
+/* Keys per B-tree index node, their prefixes fill two cache lines */
+#define P_MAPPED_TABLE_NODE_SIZE	16
+
+/* Enough index levels for 2^64 entries */
+#define P_MAPPED_TABLE_MAX_LEVELS	16
+
+/* Minimal number of the hash slots */
+#define P_MAPPED_TABLE_MIN_SLOTS	16
+
+/* Maximum number of the hash layout entries, the slots keep the entry
+ * index plus one in the lower 32 bits and 0 means an empty slot */
+#define P_MAPPED_TABLE_MAX_HASH_ENTRIES	(P_MAXUINT32 - 1)
+
+/* Upper half of the key hash kept in a slot to skip the foreign entries */
+#define P_MAPPED_TABLE_SLOT_HASH_MASK	((puint64) 0xFFFFFFFF00000000ULL)
+
+#define P_MAPPED_TABLE_MIN(a, b)	((a) < (b) ? (a) : (b))
+#define P_MAPPED_TABLE_MAX(a, b)	((a) > (b) ? (a) : (b))
+
+/* Initial capacity of the writer arrays */
+#define P_MAPPED_TABLE_INITIAL_SIZE	64
+
+/* File header, the offsets are from the beginning of the file */
+typedef struct PMappedTableHeader_ {
+	pchar	magic[P_MAPPED_TABLE_MAGIC_SIZE];
+	puint32	version;
+	puint32	byte_order;
+	puint32	layout;
+	puint32	n_levels;
+	puint64	n_entries;
+	puint64	file_size;
+	puint64	entries_offset;
+	puint64	slots_offset;
+	puint64	n_slots;
+	puint64	level_offsets[P_MAPPED_TABLE_MAX_LEVELS];
+	puint64	level_sizes[P_MAPPED_TABLE_MAX_LEVELS];
+} PMappedTableHeader;
+
+/* Entry record, the value follows the key and both are padded with zeros */
+typedef struct PMappedTableEntry_ {
+	puint64	key_offset;
+	puint64	tag;		/* Key hash for the hash layout, big-endian key prefix otherwise */
+	puint32	key_len;
+	puint32	value_len;
+} PMappedTableEntry;
+
+struct PMappedTable_ {
+	PMappedFile		*file;
+	const puchar		*base;
+	psize			size;
+	PMappedTableLayout	layout;
+	psize			n_entries;
+	const PMappedTableEntry	*entries;
+	const puint64		*slots;
+	psize			slot_mask;
+	puint32			n_levels;
+	const puint64		*levels[P_MAPPED_TABLE_MAX_LEVELS];
+	psize			level_sizes[P_MAPPED_TABLE_MAX_LEVELS];
+};
+
+typedef struct PMappedTableItem_ {
+	PMappedTableEntry	entry;
+	psize			key_copy;	/* Offset of the key copy used for sorting */
+} PMappedTableItem;
+
+typedef struct PMappedTableWriter_ {
+	PFile			*file;
+	PFileWriter		*writer;
+	PMappedTableLayout	layout;
+	PMappedTableEncodeFunc	key_func;
+	PMappedTableEncodeFunc	value_func;
+	ppointer		user_data;
+	PMappedTableItem	*items;
+	psize			n_items;
+	psize			items_capacity;
+	pchar			*keys;
+	psize			keys_size;
+	psize			keys_capacity;
+	puint64			offset;
+	PError			**error;
+} PMappedTableWriter;
+
+static const pchar pp_mapped_table_zeros[P_MAPPED_TABLE_ALIGNMENT] = { 0 };
+
+static puint64 pp_mapped_table_key_prefix (const puchar *key, psize key_len);
+static pint pp_mapped_table_key_compare (const puchar *a, psize a_len, const puchar *b, psize b_len);
+static pboolean pp_mapped_table_is_region_valid (psize size, puint64 offset, puint64 count, psize elem_size);
+static pboolean pp_mapped_table_get_entry_data (const PMappedTable *table, const PMappedTableEntry *entry,
+						const puchar **key, const puchar **value);
+static pint pp_mapped_table_entry_compare (const PMappedTable *table, psize index, puint64 entry_prefix,
+					   const puchar *key, psize key_len, puint64 prefix);
+static psize pp_mapped_table_tree_lower_bound (const PMappedTable *table, const puchar *key, psize key_len);
+static pboolean pp_mapped_table_writer_write (PMappedTableWriter *writer, pconstpointer data, psize length);
+static pboolean pp_mapped_table_writer_add (PMappedTableWriter *writer, pconstpointer key, pconstpointer value);
+static pint pp_mapped_table_item_compare (pconstpointer a, pconstpointer b, ppointer data);
+static pboolean pp_mapped_table_writer_write_slots (PMappedTableWriter *writer, PMappedTableHeader *header);
+static pboolean pp_mapped_table_writer_write_levels (PMappedTableWriter *writer, PMappedTableHeader *header);
+static pboolean pp_mapped_table_writer_finish (PMappedTableWriter *writer);
+static pboolean pp_mapped_table_writer_run (PMappedTableWriter *writer, PHashTable *table, PTree *tree,
+					    const pchar *path);
+static pboolean pp_mapped_table_tree_traverse (ppointer key, ppointer value, ppointer user_data);
+
+/* Takes the first 8 bytes padded with zeros, so the prefixes compare the same
+ * way as the keys do unless they are equal */
+static puint64
+pp_mapped_table_key_prefix (const puchar	*key,
+			    psize		key_len)
+{
+	puint64	prefix = 0;
+	psize	i;
+
+	for (i = 0; i < 8; ++i)
+		prefix = (prefix << 8) | (i < key_len ? key[i] : 0);
+
+	return prefix;
+}
+
+static pint
+pp_mapped_table_key_compare (const puchar	*a,
+			     psize		a_len,
+			     const puchar	*b,
+			     psize		b_len)
+{
+	psize	len = P_MAPPED_TABLE_MIN (a_len, b_len);
+	pint	res;
+
+	if (len > 0 && (res = memcmp (a, b, len)) != 0)
+		return res;
+
+	return a_len < b_len ? -1 : (a_len > b_len ? 1 : 0);
+}
+
+static pboolean
+pp_mapped_table_is_region_valid (psize		size,
+				 puint64	offset,
+				 puint64	count,
+				 psize		elem_size)
+{
+	if (offset > (puint64) size || offset % P_MAPPED_TABLE_ALIGNMENT != 0)
+		return FALSE;
+
+	return count <= ((puint64) size - offset) / elem_size;
+}
+
+/* Checks the entry bounds, a damaged file can't make us read beyond it */
+static pboolean
+pp_mapped_table_get_entry_data (const PMappedTable		*table,
+				const PMappedTableEntry		*entry,
+				const puchar			**key,
+				const puchar			**value)
+{
+	puint64	size = (puint64) table->size;
+	puint64	value_offset;
+
+	if (P_UNLIKELY (entry->key_offset > size || entry->key_len >= size - entry->key_offset))
+		return FALSE;
+
+	value_offset = entry->key_offset + entry->key_len;
+	value_offset = (value_offset / P_MAPPED_TABLE_ALIGNMENT + 1) * P_MAPPED_TABLE_ALIGNMENT;
+
+	if (P_UNLIKELY (value_offset > size || entry->value_len >= size - value_offset))
+		return FALSE;
+
+	*key   = table->base + entry->key_offset;
+	*value = table->base + value_offset;
+
+	return TRUE;
+}
+
+/* Compares the key of an entry with a given one, the prefixes are compared
+ * first to avoid touching the entry */
+static pint
+pp_mapped_table_entry_compare (const PMappedTable	*table,
+			       psize			index,
+			       puint64			entry_prefix,
+			       const puchar		*key,
+			       psize			key_len,
+			       puint64			prefix)
+{
+	const PMappedTableEntry	*entry;
+	const puchar		*entry_key;
+	const puchar		*entry_value;
+
+	if (entry_prefix != prefix)
+		return entry_prefix < prefix ? -1 : 1;
+
+	entry = table->entries + index;
+
+	if (P_UNLIKELY (pp_mapped_table_get_entry_data (table, entry, &entry_key, &entry_value) == FALSE))
+		return 1;
+
+	return pp_mapped_table_key_compare (entry_key, entry->key_len, key, key_len);
+}
+
+static psize
+pp_mapped_table_tree_lower_bound (const PMappedTable	*table,
+				  const puchar		*key,
+				  psize			key_len)
+{
+	puint64	prefix = pp_mapped_table_key_prefix (key, key_len);
+	psize	stride = 1;
+	psize	first  = 0;
+	psize	last   = table->n_entries;
+	psize	i;
+	puint32	level;
+
+	for (level = 0; level < table->n_levels; ++level)
+		stride *= P_MAPPED_TABLE_NODE_SIZE;
+
+	if (table->n_levels > 0)
+		last = table->level_sizes[table->n_levels - 1];
+
+	/* Every level narrows the range down to the block which starts with
+	 * the last key less than the given one */
+	for (level = table->n_levels; level > 0; --level) {
+		const puint64 *records = table->levels[level - 1];
+
+		for (i = first; i < last; ++i) {
+			if (pp_mapped_table_entry_compare (table,
+							   i * stride,
+							   records[i],
+							   key,
+							   key_len,
+							   prefix) >= 0)
+				break;
+		}
+
+		first   = (i > first ? i - 1 : first) * P_MAPPED_TABLE_NODE_SIZE;
+		stride /= P_MAPPED_TABLE_NODE_SIZE;
+		last    = P_MAPPED_TABLE_MIN (first + P_MAPPED_TABLE_NODE_SIZE,
+				 level > 1 ? table->level_sizes[level - 2] : table->n_entries);
+	}
+
+	for (i = first; i < last; ++i) {
+		if (pp_mapped_table_entry_compare (table,
+						   i,
+						   table->entries[i].tag,
+						   key,
+						   key_len,
+						   prefix) >= 0)
+			break;
+	}
+
+	return i;
+}
+
+static pboolean
+pp_mapped_table_writer_write (PMappedTableWriter	*writer,
+			      pconstpointer		data,
+			      psize			length)
+{
+	if (length == 0)
+		return TRUE;
+
+	if (P_UNLIKELY (p_file_writer_write (writer->writer,
+					     (const pchar *) data,
+					     length,
+					     writer->error) == FALSE))
+		return FALSE;
+
+	writer->offset += length;
+
+	return TRUE;
+}
+
+static pboolean
+pp_mapped_table_writer_add (PMappedTableWriter	*writer,
+			    pconstpointer	key,
+			    pconstpointer	value)
+{
+	PMappedTableItem	*item;
+	pconstpointer		data;
+	ppointer		new_mem;
+	psize			new_capacity;
+	psize			length;
+
+	if (writer->n_items == writer->items_capacity) {
+		new_capacity = writer->items_capacity == 0 ? P_MAPPED_TABLE_INITIAL_SIZE
+							   : writer->items_capacity * 2;
+
+		if (P_UNLIKELY ((new_mem = p_realloc (writer->items, new_capacity * sizeof (PMappedTableItem))) == NULL)) {
+			p_error_set_error_p (writer->error,
+					     (pint) P_ERROR_IO_NO_RESOURCES,
+					     0,
+					     "Failed to allocate memory for mapped table entries");
+			return FALSE;
+		}
+
+		writer->items          = (PMappedTableItem *) new_mem;
+		writer->items_capacity = new_capacity;
+	}
+
+	item = writer->items + writer->n_items;
+
+	/* Key */
+	length = 0;
+	data   = writer->key_func (key, &length, writer->user_data);
+
+	if (P_UNLIKELY ((data == NULL && length > 0) || length > (psize) P_MAXUINT32 - 1)) {
+		p_error_set_error_p (writer->error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid encoded key of mapped table");
+		return FALSE;
+	}
+
+	item->entry.key_offset = writer->offset;
+	item->entry.key_len    = (puint32) length;
+
+	if (writer->layout == P_MAPPED_TABLE_LAYOUT_HASH) {
+		item->entry.tag = p_fast_hash_xxh3_64 (data, length, 0);
+		item->key_copy  = 0;
+	} else {
+		item->entry.tag = pp_mapped_table_key_prefix ((const puchar *) data, length);
+		item->key_copy  = writer->keys_size;
+
+		if (writer->keys_capacity - writer->keys_size < length) {
+			new_capacity = P_MAPPED_TABLE_MAX (writer->keys_capacity * 2, writer->keys_size + length);
+			new_capacity = P_MAPPED_TABLE_MAX (new_capacity, P_MAPPED_TABLE_INITIAL_SIZE);
+
+			if (P_UNLIKELY ((new_mem = p_realloc (writer->keys, new_capacity)) == NULL)) {
+				p_error_set_error_p (writer->error,
+						     (pint) P_ERROR_IO_NO_RESOURCES,
+						     0,
+						     "Failed to allocate memory for mapped table keys");
+				return FALSE;
+			}
+
+			writer->keys          = (pchar *) new_mem;
+			writer->keys_capacity = new_capacity;
+		}
+
+		if (length > 0)
+			memcpy (writer->keys + writer->keys_size, data, length);
+
+		writer->keys_size += length;
+	}
+
+	/* At least one zero byte follows, so the strings can be used directly */
+	if (P_UNLIKELY (pp_mapped_table_writer_write (writer, data, length) == FALSE ||
+			pp_mapped_table_writer_write (writer,
+						      pp_mapped_table_zeros,
+						      P_MAPPED_TABLE_ALIGNMENT - length % P_MAPPED_TABLE_ALIGNMENT) == FALSE))
+		return FALSE;
+
+	/* Value */
+	length = 0;
+	data   = writer->value_func != NULL ? writer->value_func (value, &length, writer->user_data) : NULL;
+
+	if (P_UNLIKELY ((data == NULL && length > 0) || length > (psize) P_MAXUINT32 - 1)) {
+		p_error_set_error_p (writer->error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid encoded value of mapped table");
+		return FALSE;
+	}
+
+	item->entry.value_len = (puint32) length;
+
+	if (P_UNLIKELY (pp_mapped_table_writer_write (writer, data, length) == FALSE ||
+			pp_mapped_table_writer_write (writer,
+						      pp_mapped_table_zeros,
+						      P_MAPPED_TABLE_ALIGNMENT - length % P_MAPPED_TABLE_ALIGNMENT) == FALSE))
+		return FALSE;
+
+	++writer->n_items;
+
+	return TRUE;
+}
+
+static pint
+pp_mapped_table_item_compare (pconstpointer	a,
+			      pconstpointer	b,
+			      ppointer		data)
+{
+	const PMappedTableItem	*item_a = (const PMappedTableItem *) a;
+	const PMappedTableItem	*item_b = (const PMappedTableItem *) b;
+	const puchar		*keys   = (const puchar *) data;
+
+	if (item_a->entry.tag != item_b->entry.tag)
+		return item_a->entry.tag < item_b->entry.tag ? -1 : 1;
+
+	return pp_mapped_table_key_compare (keys + item_a->key_copy,
+					    item_a->entry.key_len,
+					    keys + item_b->key_copy,
+					    item_b->entry.key_len);
+}
+
+static pboolean
+pp_mapped_table_writer_write_slots (PMappedTableWriter	*writer,
+				    PMappedTableHeader	*header)
+{
+	puint64	*slots;
+	psize	n_slots = P_MAPPED_TABLE_MIN_SLOTS;
+	psize	mask;
+	psize	index;
+	psize	i;
+	pboolean	ret;
+
+	/* Load factor is kept below 3/4 for the short probe sequences */
+	while (n_slots - n_slots / 4 <= writer->n_items)
+		n_slots *= 2;
+
+	if (P_UNLIKELY ((slots = (puint64 *) p_malloc0 (n_slots * sizeof (puint64))) == NULL)) {
+		p_error_set_error_p (writer->error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for mapped table slots");
+		return FALSE;
+	}
+
+	mask = n_slots - 1;
+
+	for (i = 0; i < writer->n_items; ++i) {
+		puint64 tag = writer->items[i].entry.tag;
+
+		for (index = (psize) tag & mask; slots[index] != 0; index = (index + 1) & mask)
+			;
+
+		slots[index] = (tag & P_MAPPED_TABLE_SLOT_HASH_MASK) | (puint64) (i + 1);
+	}
+
+	header->slots_offset = writer->offset;
+	header->n_slots      = n_slots;
+
+	ret = pp_mapped_table_writer_write (writer, slots, n_slots * sizeof (puint64));
+
+	p_free (slots);
+
+	return ret;
+}
+
+static pboolean
+pp_mapped_table_writer_write_levels (PMappedTableWriter	*writer,
+				     PMappedTableHeader	*header)
+{
+	puint64	record;
+	psize	count  = writer->n_items;
+	psize	stride = 1;
+	psize	i;
+	puint32	level;
+
+	for (level = 0; count > P_MAPPED_TABLE_NODE_SIZE; ++level) {
+		count   = (count + P_MAPPED_TABLE_NODE_SIZE - 1) / P_MAPPED_TABLE_NODE_SIZE;
+		stride *= P_MAPPED_TABLE_NODE_SIZE;
+
+		header->level_offsets[level] = writer->offset;
+		header->level_sizes[level]   = count;
+
+		/* The record of a block is the prefix of its first entry */
+		for (i = 0; i < count; ++i) {
+			record = writer->items[i * stride].entry.tag;
+
+			if (P_UNLIKELY (pp_mapped_table_writer_write (writer, &record, sizeof (record)) == FALSE))
+				return FALSE;
+		}
+	}
+
+	header->n_levels = level;
+
+	return TRUE;
+}
+
+static pboolean
+pp_mapped_table_writer_finish (PMappedTableWriter *writer)
+{
+	PMappedTableHeader	header;
+	psize			i;
+
+	memset (&header, 0, sizeof (header));
+
+	if (writer->layout == P_MAPPED_TABLE_LAYOUT_HASH &&
+	    P_UNLIKELY (writer->n_items > P_MAPPED_TABLE_MAX_HASH_ENTRIES)) {
+		p_error_set_error_p (writer->error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Too many entries for mapped table");
+		return FALSE;
+	}
+
+	if (writer->layout == P_MAPPED_TABLE_LAYOUT_TREE)
+		p_sort (writer->items,
+			writer->n_items,
+			sizeof (PMappedTableItem),
+			pp_mapped_table_item_compare,
+			writer->keys);
+
+	header.entries_offset = writer->offset;
+
+	for (i = 0; i < writer->n_items; ++i) {
+		if (P_UNLIKELY (pp_mapped_table_writer_write (writer,
+							      &writer->items[i].entry,
+							      sizeof (PMappedTableEntry)) == FALSE))
+			return FALSE;
+	}
+
+	if (writer->layout == P_MAPPED_TABLE_LAYOUT_HASH) {
+		if (P_UNLIKELY (pp_mapped_table_writer_write_slots (writer, &header) == FALSE))
+			return FALSE;
+	} else {
+		if (P_UNLIKELY (pp_mapped_table_writer_write_levels (writer, &header) == FALSE))
+			return FALSE;
+	}
+
+	if (P_UNLIKELY (p_file_writer_flush (writer->writer, writer->error) == FALSE))
+		return FALSE;
+
+	/* The header goes last, a partially written file is never valid */
+	memcpy (header.magic, P_MAPPED_TABLE_MAGIC, P_MAPPED_TABLE_MAGIC_SIZE);
+
+	header.version    = P_MAPPED_TABLE_VERSION;
+	header.byte_order = P_MAPPED_TABLE_BYTE_ORDER;
+	header.layout     = (puint32) writer->layout;
+	header.n_entries  = writer->n_items;
+	header.file_size  = writer->offset;
+
+	if (P_UNLIKELY (p_file_write_at (writer->file,
+					 (const pchar *) &header,
+					 sizeof (header),
+					 0,
+					 writer->error) != (pssize) sizeof (header)))
+		return FALSE;
+
+	return p_file_sync (writer->file, writer->error);
+}
+
+static pboolean
+pp_mapped_table_tree_traverse (ppointer	key,
+			       ppointer	value,
+			       ppointer	user_data)
+{
+	/* Stops the traversing on failure */
+	return !pp_mapped_table_writer_add ((PMappedTableWriter *) user_data, key, value);
+}
+
+static pboolean
+pp_mapped_table_writer_run (PMappedTableWriter	*writer,
+			    PHashTable		*table,
+			    PTree		*tree,
+			    const pchar		*path)
+{
+	PHashTableIter	iter;
+	ppointer	key;
+	ppointer	value;
+	psize		n_items;
+
+	if (P_UNLIKELY ((writer->file = p_file_new (path,
+						    P_FILE_OPEN_FLAG_WRITE |
+						    P_FILE_OPEN_FLAG_CREATE |
+						    P_FILE_OPEN_FLAG_TRUNCATE,
+						    writer->error)) == NULL))
+		return FALSE;
+
+	/* The data goes right after the header which is written at the end */
+	writer->offset = sizeof (PMappedTableHeader);
+
+	if (P_UNLIKELY ((writer->writer = p_file_writer_new (writer->file, writer->offset, 0)) == NULL)) {
+		p_error_set_error_p (writer->error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for file writer");
+		return FALSE;
+	}
+
+	if (table != NULL) {
+		p_hash_table_iter_init (&iter, table);
+
+		while (p_hash_table_iter_next (&iter, &key, &value) == TRUE) {
+			if (P_UNLIKELY (pp_mapped_table_writer_add (writer, key, value) == FALSE))
+				return FALSE;
+		}
+	} else {
+		n_items = (psize) p_tree_get_nnodes (tree);
+
+		p_tree_foreach (tree, pp_mapped_table_tree_traverse, writer);
+
+		if (P_UNLIKELY (writer->n_items != n_items))
+			return FALSE;
+	}
+
+	return pp_mapped_table_writer_finish (writer);
+}
+
+P_LIB_API pboolean
+p_mapped_table_write_hash_table (PHashTable		*table,
+				 const pchar		*path,
+				 PMappedTableEncodeFunc	key_func,
+				 PMappedTableEncodeFunc	value_func,
+				 ppointer		user_data,
+				 PError			**error)
+{
+	PMappedTableWriter	writer;
+	pboolean		ret;
+
+	if (P_UNLIKELY (table == NULL || path == NULL || key_func == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	memset (&writer, 0, sizeof (writer));
+
+	writer.layout     = P_MAPPED_TABLE_LAYOUT_HASH;
+	writer.key_func   = key_func;
+	writer.value_func = value_func;
+	writer.user_data  = user_data;
+	writer.error      = error;
+
+	ret = pp_mapped_table_writer_run (&writer, table, NULL, path);
+
+	if (writer.writer != NULL)
+		p_file_writer_free (writer.writer);
+
+	if (writer.file != NULL)
+		p_file_free (writer.file);
+
+	p_free (writer.items);
+
+	return ret;
+}
+
+P_LIB_API pboolean
+p_mapped_table_write_tree (PTree			*tree,
+			   const pchar			*path,
+			   PMappedTableEncodeFunc	key_func,
+			   PMappedTableEncodeFunc	value_func,
+			   ppointer			user_data,
+			   PError			**error)
+{
+	PMappedTableWriter	writer;
+	pboolean		ret;
+
+	if (P_UNLIKELY (tree == NULL || path == NULL || key_func == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	memset (&writer, 0, sizeof (writer));
+
+	writer.layout     = P_MAPPED_TABLE_LAYOUT_TREE;
+	writer.key_func   = key_func;
+	writer.value_func = value_func;
+	writer.user_data  = user_data;
+	writer.error      = error;
+
+	ret = pp_mapped_table_writer_run (&writer, NULL, tree, path);
+
+	if (writer.writer != NULL)
+		p_file_writer_free (writer.writer);
+
+	if (writer.file != NULL)
+		p_file_free (writer.file);
+
+	p_free (writer.items);
+	p_free (writer.keys);
+
+	return ret;
+}
+
+P_LIB_API pconstpointer
+p_mapped_table_encode_str (pconstpointer	data,
+			   psize		*length,
+			   ppointer		user_data)
+{
+	P_UNUSED (user_data);
+
+	*length = data != NULL ? strlen ((const pchar *) data) : 0;
+
+	return data;
+}
+
+P_LIB_API PMappedTable *
+p_mapped_table_new (const pchar	*path,
+		    PError	**error)
+{
+	PMappedTable			*ret;
+	const PMappedTableHeader	*header;
+	puint64				expected;
+	puint32				level;
+
+	if (P_UNLIKELY (path == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PMappedTable))) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for mapped table");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret->file = p_mapped_file_new (path, P_MAPPED_FILE_ACCESS_READONLY, error)) == NULL)) {
+		p_free (ret);
+		return NULL;
+	}
+
+	ret->base = (const puchar *) p_mapped_file_get_address (ret->file);
+	ret->size = p_mapped_file_get_size (ret->file);
+	header    = (const PMappedTableHeader *) ret->base;
+
+	if (P_UNLIKELY (ret->size < sizeof (PMappedTableHeader) ||
+			memcmp (header->magic, P_MAPPED_TABLE_MAGIC, P_MAPPED_TABLE_MAGIC_SIZE) != 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "File is not a mapped table");
+		p_mapped_table_free (ret);
+		return NULL;
+	}
+
+	if (P_UNLIKELY (header->version != P_MAPPED_TABLE_VERSION ||
+			header->byte_order != P_MAPPED_TABLE_BYTE_ORDER)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NOT_SUPPORTED,
+				     0,
+				     "Mapped table version or byte order is not supported");
+		p_mapped_table_free (ret);
+		return NULL;
+	}
+
+	ret->layout    = (PMappedTableLayout) header->layout;
+	ret->n_entries = (psize) header->n_entries;
+	ret->n_levels  = header->n_levels;
+	ret->entries   = (const PMappedTableEntry *) (ret->base + header->entries_offset);
+
+	if (P_UNLIKELY (header->file_size != (puint64) ret->size ||
+			(header->layout != P_MAPPED_TABLE_LAYOUT_HASH &&
+			 header->layout != P_MAPPED_TABLE_LAYOUT_TREE) ||
+			pp_mapped_table_is_region_valid (ret->size,
+							 header->entries_offset,
+							 header->n_entries,
+							 sizeof (PMappedTableEntry)) == FALSE))
+		goto invalid;
+
+	if (ret->layout == P_MAPPED_TABLE_LAYOUT_HASH) {
+		/* Probing ends on an empty slot, so there must be one */
+		if (P_UNLIKELY (header->n_slots <= header->n_entries ||
+				(header->n_slots & (header->n_slots - 1)) != 0 ||
+				pp_mapped_table_is_region_valid (ret->size,
+								 header->slots_offset,
+								 header->n_slots,
+								 sizeof (puint64)) == FALSE))
+			goto invalid;
+
+		ret->slots     = (const puint64 *) (ret->base + header->slots_offset);
+		ret->slot_mask = (psize) header->n_slots - 1;
+	} else {
+		if (P_UNLIKELY (header->n_levels > P_MAPPED_TABLE_MAX_LEVELS))
+			goto invalid;
+
+		/* The level sizes must match the number of entries, the lookups
+		 * rely on them */
+		expected = header->n_entries;
+
+		for (level = 0; level < header->n_levels; ++level) {
+			expected = (expected + P_MAPPED_TABLE_NODE_SIZE - 1) / P_MAPPED_TABLE_NODE_SIZE;
+
+			if (P_UNLIKELY (header->level_sizes[level] != expected ||
+					pp_mapped_table_is_region_valid (ret->size,
+									 header->level_offsets[level],
+									 expected,
+									 sizeof (puint64)) == FALSE))
+				goto invalid;
+
+			ret->levels[level]      = (const puint64 *) (ret->base + header->level_offsets[level]);
+			ret->level_sizes[level] = (psize) expected;
+		}
+
+		if (P_UNLIKELY (expected > P_MAPPED_TABLE_NODE_SIZE))
+			goto invalid;
+	}
+
+	return ret;
+
+invalid:
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+			     0,
+			     "Mapped table file is damaged");
+	p_mapped_table_free (ret);
+
+	return NULL;
+}
+
+P_LIB_API PMappedTableLayout
+p_mapped_table_get_layout (const PMappedTable *table)
+{
+	if (P_UNLIKELY (table == NULL))
+		return P_MAPPED_TABLE_LAYOUT_HASH;
+
+	return table->layout;
+}
+
+P_LIB_API psize
+p_mapped_table_get_size (const PMappedTable *table)
+{
+	if (P_UNLIKELY (table == NULL))
+		return 0;
+
+	return table->n_entries;
+}
+
+P_LIB_API pconstpointer
+p_mapped_table_lookup (const PMappedTable	*table,
+		       pconstpointer		key,
+		       psize			key_len,
+		       psize			*value_len)
+{
+	const PMappedTableEntry	*entry;
+	const puchar		*entry_key;
+	const puchar		*entry_value;
+	puint64			hash;
+	puint64			slot;
+	psize			index;
+	psize			probes;
+
+	if (P_UNLIKELY (table == NULL || (key == NULL && key_len > 0)))
+		return NULL;
+
+	if (table->layout == P_MAPPED_TABLE_LAYOUT_TREE) {
+		index = pp_mapped_table_tree_lower_bound (table, (const puchar *) key, key_len);
+
+		if (index == table->n_entries)
+			return NULL;
+
+		entry = table->entries + index;
+	} else {
+		hash  = p_fast_hash_xxh3_64 (key, key_len, 0);
+		entry = NULL;
+
+		for (index = (psize) hash & table->slot_mask, probes = 0;
+		     probes <= table->slot_mask;
+		     index = (index + 1) & table->slot_mask, ++probes) {
+			if ((slot = table->slots[index]) == 0)
+				return NULL;
+
+			if ((slot & P_MAPPED_TABLE_SLOT_HASH_MASK) != (hash & P_MAPPED_TABLE_SLOT_HASH_MASK) ||
+			    P_UNLIKELY ((slot & P_MAXUINT32) > table->n_entries))
+				continue;
+
+			entry = table->entries + (psize) (slot & P_MAXUINT32) - 1;
+
+			if (entry->tag == hash && entry->key_len == key_len &&
+			    pp_mapped_table_get_entry_data (table, entry, &entry_key, &entry_value) == TRUE &&
+			    (key_len == 0 || memcmp (entry_key, key, key_len) == 0))
+				break;
+
+			entry = NULL;
+		}
+
+		if (entry == NULL)
+			return NULL;
+	}
+
+	if (P_UNLIKELY (pp_mapped_table_get_entry_data (table, entry, &entry_key, &entry_value) == FALSE))
+		return NULL;
+
+	if (pp_mapped_table_key_compare (entry_key, entry->key_len, (const puchar *) key, key_len) != 0)
+		return NULL;
+
+	if (value_len != NULL)
+		*value_len = entry->value_len;
+
+	return entry_value;
+}
+
+P_LIB_API psize
+p_mapped_table_lower_bound (const PMappedTable	*table,
+			    pconstpointer	key,
+			    psize		key_len)
+{
+	if (P_UNLIKELY (table == NULL))
+		return 0;
+
+	if (P_UNLIKELY (table->layout != P_MAPPED_TABLE_LAYOUT_TREE || (key == NULL && key_len > 0)))
+		return table->n_entries;
+
+	return pp_mapped_table_tree_lower_bound (table, (const puchar *) key, key_len);
+}
+
+P_LIB_API pboolean
+p_mapped_table_get_entry (const PMappedTable	*table,
+			  psize			index,
+			  pconstpointer		*key,
+			  psize			*key_len,
+			  pconstpointer		*value,
+			  psize			*value_len)
+{
+	const PMappedTableEntry	*entry;
+	const puchar		*entry_key;
+	const puchar		*entry_value;
+
+	if (P_UNLIKELY (table == NULL || index >= table->n_entries))
+		return FALSE;
+
+	entry = table->entries + index;
+
+	if (P_UNLIKELY (pp_mapped_table_get_entry_data (table, entry, &entry_key, &entry_value) == FALSE))
+		return FALSE;
+
+	if (key != NULL)
+		*key = entry_key;
+
+	if (key_len != NULL)
+		*key_len = entry->key_len;
+
+	if (value != NULL)
+		*value = entry_value;
+
+	if (value_len != NULL)
+		*value_len = entry->value_len;
+
+	return TRUE;
+}
+
+P_LIB_API void
+p_mapped_table_free (PMappedTable *table)
+{
+	if (P_UNLIKELY (table == NULL))
+		return;
+
+	if (table->file != NULL)
+		p_mapped_file_free (table->file);
+
+	p_free (table);
+}
@@ -0,0 +1,277 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pmappedtable.h
+ * @brief Memory mapped table snapshots
+ * @author Alexander Saprykin
+ *
+ * A mapped table is a read-only snapshot of a #PHashTable or a #PTree stored
+ * in a file in a form which is used right from a memory mapping: the file
+ * contains only offsets instead of the pointers, so opening it doesn't parse
+ * or rebuild anything. Opening a table of any size takes a single mapping
+ * call, and its pages are read by the system on demand when the lookups touch
+ * them, which makes the cold start of a service with large tables nearly
+ * instant.
+ *
+ * A snapshot is written once with p_mapped_table_write_hash_table() or
+ * p_mapped_table_write_tree(). Keys and values of the containers are opaque
+ * pointers, so the caller provides #PMappedTableEncodeFunc functions which
+ * turn them into byte strings, p_mapped_table_encode_str() does that for the
+ * C strings. Then the snapshot is opened with p_mapped_table_new() and
+ * queried with the encoded keys.
+ *
+ * Two layouts are supported:
+ * - #P_MAPPED_TABLE_LAYOUT_HASH is written from a hash table: an open
+ * addressing slot array indexes the entries by a 64-bit xxHash3 value of the
+ * key, so a lookup usually touches a single slot, entry and key.
+ * - #P_MAPPED_TABLE_LAYOUT_TREE is written from a tree: the entries are
+ * sorted by the key bytes (shorter keys go first on a common prefix) and
+ * indexed by a static B-tree with 16 keys per node, each node keeps the
+ * 8-byte key prefixes in two cache lines, so the full keys are compared only
+ * on a prefix tie. Besides the lookups it supports the ordered access with
+ * p_mapped_table_lower_bound() and p_mapped_table_get_entry().
+ *
+ * Every key and value in the mapping is followed by at least one zero byte,
+ * so the strings encoded without the terminating zero can be used as the C
+ * strings directly.
+ *
+ * The snapshot uses the byte order and the type sizes of the machine it was
+ * written on, opening it on a machine with the different byte order fails
+ * with #P_ERROR_IO_NOT_SUPPORTED error code. The file is written in place,
+ * write it under a temporary name and rename it to replace a snapshot which
+ * may be in use.
+ *
+ * A mapped table is immutable, so it can be used from several threads at once
+ * without any locking.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PMAPPEDTABLE_H
+#define PLIBSYS_HEADER_PMAPPEDTABLE_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+#include "perror.h"
+#include "phashtable.h"
+#include "ptree.h"
+
+P_BEGIN_DECLS
+
+/** Memory mapped table opaque data structure. */
+typedef struct PMappedTable_ PMappedTable;
+
+/** Layout of a memory mapped table. */
+typedef enum PMappedTableLayout_ {
+	P_MAPPED_TABLE_LAYOUT_HASH	= 0,	/**< Open addressing hash table, unordered.	*/
+	P_MAPPED_TABLE_LAYOUT_TREE	= 1	/**< Sorted entries with a B-tree index.	*/
+} PMappedTableLayout;
+
+/**
+ * @brief Function to encode a container key or value into bytes.
+ * @param data Key or value to encode.
+ * @param[out] length Length of the encoded data in bytes.
+ * @param user_data Data provided by a user, maybe NULL.
+ * @return Pointer to the encoded data, may be NULL if @a length is 0.
+ * @since 0.0.5
+ *
+ * The returned data must stay valid until the next call of the function.
+ */
+typedef pconstpointer (*PMappedTableEncodeFunc) (pconstpointer	data,
+						 psize		*length,
+						 ppointer	user_data);
+
+/**
+ * @brief Writes a hash table snapshot into a file.
+ * @param table Hash table to write.
+ * @param path Path to the file to write, it's replaced if exists.
+ * @param key_func Function to encode the keys.
+ * @param value_func Function to encode the values, NULL to write the keys
+ * only.
+ * @param user_data Data to pass into @a key_func and @a value_func, may be
+ * NULL.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ * @sa p_mapped_table_new()
+ *
+ * The snapshot gets #P_MAPPED_TABLE_LAYOUT_HASH layout. The keys should be
+ * encoded uniquely, otherwise only one of the entries with the same encoded
+ * key is found. Up to 2^32 - 2 entries are supported, and the encoded keys
+ * and values should be shorter than 4 GiB.
+ *
+ * The table must not be modified during the call. The file is synchronized
+ * with the storage device before the call returns.
+ */
+P_LIB_API pboolean		p_mapped_table_write_hash_table	(PHashTable			*table,
+								 const pchar			*path,
+								 PMappedTableEncodeFunc		key_func,
+								 PMappedTableEncodeFunc		value_func,
+								 ppointer			user_data,
+								 PError				**error);
+
+/**
+ * @brief Writes a tree snapshot into a file.
+ * @param tree Tree to write.
+ * @param path Path to the file to write, it's replaced if exists.
+ * @param key_func Function to encode the keys.
+ * @param value_func Function to encode the values, NULL to write the keys
+ * only.
+ * @param user_data Data to pass into @a key_func and @a value_func, may be
+ * NULL.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ * @sa p_mapped_table_new()
+ *
+ * The snapshot gets #P_MAPPED_TABLE_LAYOUT_TREE layout. The entries are
+ * ordered by the encoded keys rather than by the tree comparison function,
+ * use an order preserving encoding (i.e. the big-endian integers) to keep
+ * the order. The encoded keys and values should be shorter than 4 GiB.
+ *
+ * The tree must not be modified during the call. The file is synchronized
+ * with the storage device before the call returns.
+ */
+P_LIB_API pboolean		p_mapped_table_write_tree	(PTree				*tree,
+								 const pchar			*path,
+								 PMappedTableEncodeFunc		key_func,
+								 PMappedTableEncodeFunc		value_func,
+								 ppointer			user_data,
+								 PError				**error);
+
+/**
+ * @brief Encodes a C string key or value, see #PMappedTableEncodeFunc.
+ * @param data Zero terminated string to encode.
+ * @param[out] length Length of the string without the terminating zero.
+ * @param user_data Not used.
+ * @return @a data itself.
+ * @since 0.0.5
+ */
+P_LIB_API pconstpointer		p_mapped_table_encode_str	(pconstpointer			data,
+								 psize				*length,
+								 ppointer			user_data);
+
+/**
+ * @brief Opens a mapped table snapshot.
+ * @param path Path to the snapshot file.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Pointer to #PMappedTable in case of success, NULL otherwise.
+ * @since 0.0.5
+ * @sa p_mapped_table_free()
+ *
+ * The file is mapped read-only and only its header and index bounds are
+ * checked, so the call takes the same time for a table of any size. The
+ * entries are checked when accessed, so a damaged file can't make a lookup
+ * read outside of the mapping.
+ */
+P_LIB_API PMappedTable *	p_mapped_table_new		(const pchar			*path,
+								 PError				**error);
+
+/**
+ * @brief Gets the layout of a mapped table.
+ * @param table #PMappedTable to get the layout for.
+ * @return Layout of @a table.
+ * @since 0.0.5
+ */
+P_LIB_API PMappedTableLayout	p_mapped_table_get_layout	(const PMappedTable		*table);
+
+/**
+ * @brief Gets the number of entries of a mapped table.
+ * @param table #PMappedTable to get the number of entries for.
+ * @return Number of entries in @a table.
+ * @since 0.0.5
+ */
+P_LIB_API psize			p_mapped_table_get_size		(const PMappedTable		*table);
+
+/**
+ * @brief Looks up a value by an encoded key.
+ * @param table #PMappedTable to look up in.
+ * @param key Encoded key, may be NULL if @a key_len is 0.
+ * @param key_len Length of @a key in bytes.
+ * @param[out] value_len Length of the found value in bytes, may be NULL.
+ * @return Pointer to the value inside the mapping if the key is found, NULL
+ * otherwise.
+ * @since 0.0.5
+ *
+ * The returned pointer stays valid until the table is freed. An empty value
+ * is returned as a pointer to a zero byte.
+ */
+P_LIB_API pconstpointer		p_mapped_table_lookup		(const PMappedTable		*table,
+								 pconstpointer			key,
+								 psize				key_len,
+								 psize				*value_len);
+
+/**
+ * @brief Finds the first entry which key is not less than a given one.
+ * @param table #PMappedTable to search in.
+ * @param key Encoded key, may be NULL if @a key_len is 0.
+ * @param key_len Length of @a key in bytes.
+ * @return Index of the found entry, or the number of entries if all the keys
+ * are less than @a key.
+ * @since 0.0.5
+ * @sa p_mapped_table_get_entry()
+ *
+ * Works only for #P_MAPPED_TABLE_LAYOUT_TREE layout, the number of entries
+ * is returned for the other ones.
+ */
+P_LIB_API psize			p_mapped_table_lower_bound	(const PMappedTable		*table,
+								 pconstpointer			key,
+								 psize				key_len);
+
+/**
+ * @brief Gets an entry of a mapped table by its index.
+ * @param table #PMappedTable to get the entry from.
+ * @param index Index of the entry, less than p_mapped_table_get_size().
+ * @param[out] key Pointer to store the key of the entry, may be NULL.
+ * @param[out] key_len Pointer to store the key length, may be NULL.
+ * @param[out] value Pointer to store the value of the entry, may be NULL.
+ * @param[out] value_len Pointer to store the value length, may be NULL.
+ * @return TRUE in case of success, FALSE if the index is out of range or the
+ * entry is damaged.
+ * @since 0.0.5
+ *
+ * For #P_MAPPED_TABLE_LAYOUT_TREE layout the entries go in the key order,
+ * for the other layouts the order is arbitrary.
+ */
+P_LIB_API pboolean		p_mapped_table_get_entry	(const PMappedTable		*table,
+								 psize				index,
+								 pconstpointer			*key,
+								 psize				*key_len,
+								 pconstpointer			*value,
+								 psize				*value_len);
+
+/**
+ * @brief Unmaps a table and frees a #PMappedTable object.
+ * @param table #PMappedTable to free.
+ * @since 0.0.5
+ */
+P_LIB_API void			p_mapped_table_free		(PMappedTable			*table);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PMAPPEDTABLE_H */
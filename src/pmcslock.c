@@ -0,0 +1,142 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* The lock is a pointer to the last node of the queue, NULL if the lock is
+ * free. A thread appends its node with an atomic exchange and, if there was a
+ * predecessor, links itself to it and spins on its own flag. The owner hands
+ * the lock over by clearing the flag of the next node. If there is no next
+ * node yet, the owner either swings the tail back to NULL or, if somebody has
+ * just appended a node, waits until the link appears. */
+
+#include "patomic.h"
+#include "pcpurelax-private.h"
+#include "pmcslock.h"
+#include "pmem.h"
+
+#define P_MCS_LOCK_YIELD_ROUNDS	256
+
+struct PMCSLock_ {
+	PMCSLockNode * volatile	tail;
+};
+
+static PMCSLockNode * pp_mcs_lock_exchange_tail (PMCSLock *lock, PMCSLockNode *node);
+
+static PMCSLockNode *
+pp_mcs_lock_exchange_tail (PMCSLock *lock, PMCSLockNode *node)
+{
+	PMCSLockNode *tail;
+
+	do {
+		tail = (PMCSLockNode *) p_atomic_pointer_get (&lock->tail);
+	} while (p_atomic_pointer_compare_and_exchange (&lock->tail, tail, node) == FALSE);
+
+	return tail;
+}
+
+P_LIB_API PMCSLock *
+p_mcs_lock_new (void)
+{
+	PMCSLock *ret;
+
+	if (P_UNLIKELY ((ret = p_malloc0_aligned (sizeof (PMCSLock), P_MEM_CACHE_LINE_SIZE)) == NULL)) {
+		P_ERROR ("PMCSLock::p_mcs_lock_new: failed to allocate memory");
+		return NULL;
+	}
+
+	return ret;
+}
+
+P_LIB_API pboolean
+p_mcs_lock_lock (PMCSLock	*lock,
+		 PMCSLockNode	*node)
+{
+	PMCSLockNode	*pred;
+	pint		rounds = 0;
+
+	if (P_UNLIKELY (lock == NULL || node == NULL))
+		return FALSE;
+
+	p_atomic_pointer_set (&node->next, NULL);
+	p_atomic_int_set (&node->locked, 1);
+
+	if ((pred = pp_mcs_lock_exchange_tail (lock, node)) == NULL)
+		return TRUE;
+
+	p_atomic_pointer_set (&pred->next, node);
+
+	while (p_atomic_int_get (&node->locked) != 0) {
+		P_CPU_RELAX ();
+
+		if (++rounds >= P_MCS_LOCK_YIELD_ROUNDS) {
+			p_uthread_yield ();
+			rounds = 0;
+		}
+	}
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_mcs_lock_trylock (PMCSLock		*lock,
+		    PMCSLockNode	*node)
+{
+	if (P_UNLIKELY (lock == NULL || node == NULL))
+		return FALSE;
+
+	p_atomic_pointer_set (&node->next, NULL);
+	p_atomic_int_set (&node->locked, 0);
+
+	return p_atomic_pointer_compare_and_exchange (&lock->tail, NULL, node);
+}
+
+P_LIB_API pboolean
+p_mcs_lock_unlock (PMCSLock	*lock,
+		   PMCSLockNode	*node)
+{
+	PMCSLockNode	*next;
+	pint		backoff = 1;
+
+	if (P_UNLIKELY (lock == NULL || node == NULL))
+		return FALSE;
+
+	if ((next = (PMCSLockNode *) p_atomic_pointer_get (&node->next)) == NULL) {
+		if (p_atomic_pointer_compare_and_exchange (&lock->tail, node, NULL) == TRUE)
+			return TRUE;
+
+		/* A successor has swapped the tail but not linked itself yet */
+		while ((next = (PMCSLockNode *) p_atomic_pointer_get (&node->next)) == NULL)
+			P_CPU_BACKOFF (backoff);
+	}
+
+	p_atomic_int_set (&next->locked, 0);
+
+	return TRUE;
+}
+
+P_LIB_API void
+p_mcs_lock_free (PMCSLock *lock)
+{
+	p_free_aligned (lock);
+}
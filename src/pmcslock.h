@@ -0,0 +1,128 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pmcslock.h
+ * @brief Fair queue (MCS) spinlock
+ * @author Alexander Saprykin
+ *
+ * An MCS lock (after Mellor-Crummey and Scott) is a fair spinlock where the
+ * waiting threads form a queue of nodes and each of them spins on a flag in
+ * its own node. The lock holder passes the lock to the next node directly, so
+ * an unlock touches only the cache line of a single waiter. This keeps the
+ * lock scalable on machines with many cores, where a #PSpinLock or a
+ * #PTicketLock makes all the waiters fetch the same cache line on every
+ * release.
+ *
+ * Every lock call takes a #PMCSLockNode which must stay valid until the
+ * matching unlock call, it usually lives on the stack of the locking thread.
+ * The same node must be passed to the unlock call. A node can be reused once
+ * the lock is released, but it can't be in two queues at once. Put the nodes
+ * on separate cache lines (which is natural for the stacks of different
+ * threads) to get the scalability benefit.
+ *
+ * The lock grants the lock in the order of arrival, so it degrades when there
+ * are more spinning threads than CPUs, like any fair spinlock. Waiters yield
+ * the CPU after a while to soften that.
+ *
+ * The lock is based on the atomic operations, see p_atomic_is_lock_free().
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PMCSLOCK_H
+#define PLIBSYS_HEADER_PMCSLOCK_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+
+P_BEGIN_DECLS
+
+/** MCS lock queue node, the fields are internal. */
+typedef struct PMCSLockNode_ {
+	struct PMCSLockNode_ * volatile	next;	/**< Next waiting node.		*/
+	volatile pint			locked;	/**< Spinning flag of the owner.	*/
+} PMCSLockNode;
+
+/** MCS lock opaque data type. */
+typedef struct PMCSLock_ PMCSLock;
+
+/**
+ * @brief Creates a new MCS lock.
+ * @return Pointer to #PMCSLock in case of success, NULL otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API PMCSLock *	p_mcs_lock_new		(void);
+
+/**
+ * @brief Locks an MCS lock.
+ * @param lock #PMCSLock to lock.
+ * @param node Queue node of the caller, valid until the unlock.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The threads get the lock in the order they have called this routine. Do
+ * not lock an MCS lock recursively, it leads to a deadlock.
+ */
+P_LIB_API pboolean	p_mcs_lock_lock		(PMCSLock	*lock,
+						 PMCSLockNode	*node);
+
+/**
+ * @brief Tries to lock an MCS lock without waiting.
+ * @param lock #PMCSLock to lock.
+ * @param node Queue node of the caller, valid until the unlock.
+ * @return TRUE if the lock was acquired, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_mcs_lock_trylock	(PMCSLock	*lock,
+						 PMCSLockNode	*node);
+
+/**
+ * @brief Releases a locked MCS lock.
+ * @param lock #PMCSLock to release.
+ * @param node Queue node passed to the lock call.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * Only the thread which holds the lock may release it, with the node it was
+ * locked with.
+ */
+P_LIB_API pboolean	p_mcs_lock_unlock	(PMCSLock	*lock,
+						 PMCSLockNode	*node);
+
+/**
+ * @brief Frees an MCS lock.
+ * @param lock #PMCSLock to free.
+ * @since 0.0.5
+ *
+ * The lock should be unlocked at that moment.
+ */
+P_LIB_API void		p_mcs_lock_free		(PMCSLock	*lock);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PMCSLOCK_H */
@@ -23,6 +23,7 @@
  * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 
@@ -31,6 +32,15 @@
 #include "perror-private.h"
 #include "psysclose-private.h"
 
+#ifdef PLIBSYS_MEM_STATS
+#  include "patomic.h"
+
+/* The public calls are not redirected inside this module */
+#  undef p_malloc
+#  undef p_malloc0
+#  undef p_realloc
+#endif
+
 #ifndef P_OS_WIN
 #  if defined (P_OS_BEOS)
 #    include <be/kernel/OS.h>
@@ -47,8 +57,161 @@
 #  endif
 #endif
 
-static pboolean		p_mem_table_inited = FALSE;
-static PMemVTable	p_mem_table;
+#ifdef P_OS_LINUX
+#  include <errno.h>
+#  include <sys/syscall.h>
+#endif
+
+#ifdef P_OS_WIN
+typedef LPVOID (WINAPI * PMemMapViewOfFileExNumaFunc) (HANDLE	file_mapping,
+						       DWORD	desired_access,
+						       DWORD	offset_high,
+						       DWORD	offset_low,
+						       SIZE_T	n_bytes,
+						       LPVOID	base_addr,
+						       DWORD	preferred_node);
+typedef DWORD (WINAPI * PMemGetCurrentProcessorNumberFunc) (void);
+
+typedef struct PMemRangeEntry_ {
+	PVOID	addr;
+	SIZE_T	n_bytes;
+} PMemRangeEntry;
+
+typedef BOOL (WINAPI * PMemPrefetchVirtualMemoryFunc) (HANDLE		process,
+						       ULONG_PTR	n_entries,
+						       PMemRangeEntry	*entries,
+						       ULONG		flags);
+
+/* Older SDKs lack the large pages flags for file mappings */
+#  ifndef SEC_LARGE_PAGES
+#    define SEC_LARGE_PAGES		0x80000000
+#  endif
+#  ifndef FILE_MAP_LARGE_PAGES
+#    define FILE_MAP_LARGE_PAGES	0x20000000
+#  endif
+#endif
+
+/* Arena blocks are aligned for any type */
+#define P_MEM_ARENA_ALIGN		16
+#define P_MEM_ARENA_ALIGN_UP(size)	(((size) + P_MEM_ARENA_ALIGN - 1) & ~((psize) P_MEM_ARENA_ALIGN - 1))
+#define P_MEM_ARENA_DEFAULT_CHUNK	(64 * 1024)
+#define P_MEM_ARENA_MIN_CHUNK		1024
+
+/* Blocks allocated through the memory table keep their size in front, so they
+ * can be reallocated */
+#define P_MEM_ARENA_BLOCK_HEADER	P_MEM_ARENA_ALIGN
+
+typedef struct PMemArenaChunk_ {
+	struct PMemArenaChunk_	*next;
+	psize			size;
+} PMemArenaChunk;
+
+#define P_MEM_ARENA_CHUNK_HEADER	P_MEM_ARENA_ALIGN_UP (sizeof (PMemArenaChunk))
+
+struct PMemArena_ {
+	PMemArenaChunk	*chunks;
+	PMemArenaChunk	*cur_chunk;
+	PMemArenaChunk	*large_chunks;
+	psize		offset;
+	psize		chunk_size;
+	pboolean	use_mmap;
+	pboolean	is_installed;
+	PMemVTable	chunk_table;
+	PMemVTable	prev_table;
+	ppointer	(*prev_calloc) (psize n_blocks, psize block_size);
+	PMemArena	*prev_arena;
+};
+
+#ifdef PLIBSYS_MEM_STATS
+/* Every block starts with a header keeping its size and module, the module
+ * slots are taken by the first allocation from a source file */
+#  define P_MEM_STATS_HEADER		16
+#  define P_MEM_STATS_MAX_MODULES	128
+
+typedef struct PMemStatsHeader_ {
+	psize	size;
+	pint	module;
+} PMemStatsHeader;
+
+typedef struct PMemStatsCounters_ {
+	volatile psize	alloc_calls;
+	volatile psize	realloc_calls;
+	volatile psize	free_calls;
+	volatile psize	failed_calls;
+	volatile psize	bytes_live;
+	volatile psize	bytes_peak;
+	volatile psize	size_classes[P_MEM_STATS_SIZE_CLASSES];
+} PMemStatsCounters;
+
+typedef struct PMemStatsModule_ {
+	const pchar * volatile	file;
+	PMemStatsCounters	counters;
+} PMemStatsModule;
+
+static PMemStatsCounters	p_mem_stats_total;
+static PMemStatsModule		p_mem_stats_modules[P_MEM_STATS_MAX_MODULES];
+static PMemTraceFunc		p_mem_stats_trace_func = NULL;
+static ppointer			p_mem_stats_trace_data = NULL;
+#endif
+
+static ppointer pp_mem_malloc_aligned (psize n_bytes, psize alignment);
+static void pp_mem_free_aligned (ppointer mem);
+
+static pboolean			p_mem_table_inited = FALSE;
+static PMemVTable		p_mem_table;
+static PMemAlignedVTable	p_mem_aligned_table = {pp_mem_malloc_aligned, pp_mem_free_aligned};
+
+/* Optional zeroed allocation matching the current memory table */
+static ppointer			(*p_mem_calloc) (psize n_blocks, psize block_size) = NULL;
+
+#if defined (P_CC_MSVC)
+#  define P_MEM_THREAD_LOCAL	__declspec(thread)
+#elif defined (PLIBSYS_HAS_THREAD_KEYWORD)
+#  define P_MEM_THREAD_LOCAL	__thread
+#endif
+
+#define P_MEM_THREAD_VTABLE_MAX_DEPTH	8
+
+/* Thread tables take precedence over the process-wide one */
+#ifdef P_MEM_THREAD_LOCAL
+static P_MEM_THREAD_LOCAL PMemVTable	p_mem_thread_tables[P_MEM_THREAD_VTABLE_MAX_DEPTH];
+static P_MEM_THREAD_LOCAL PMemVTable	*p_mem_thread_table = NULL;
+static P_MEM_THREAD_LOCAL pint		p_mem_thread_depth = 0;
+
+#  define P_MEM_TABLE			(P_LIKELY (p_mem_thread_table == NULL) ? &p_mem_table : p_mem_thread_table)
+#  define P_MEM_CALLOC			(P_LIKELY (p_mem_thread_table == NULL) ? p_mem_calloc : NULL)
+#else
+#  define P_MEM_TABLE			(&p_mem_table)
+#  define P_MEM_CALLOC			p_mem_calloc
+#endif
+static PMemArena	*p_mem_active_arena = NULL;
+
+#ifdef PLIBSYS_MEM_STATS
+static pint pp_mem_stats_module_index (const pchar *file);
+static const pchar * pp_mem_stats_module_name (pint index);
+static pint pp_mem_stats_size_class (psize n_bytes);
+static void pp_mem_stats_update (PMemStatsCounters *counters, PMemTraceEvent event, pssize delta, psize n_bytes);
+static void pp_mem_stats_account (pint module, PMemTraceEvent event, pssize delta, psize n_bytes);
+static void pp_mem_stats_fail (pint module);
+static void pp_mem_stats_trace (PMemTraceEvent event, pconstpointer old_mem, pconstpointer mem, psize n_bytes, pint module);
+static void pp_mem_stats_free (ppointer mem);
+static void pp_mem_stats_read (const PMemStatsCounters *counters, PMemStats *stats);
+static void pp_mem_stats_clear (PMemStatsCounters *counters);
+#endif
+
+static psize pp_mem_get_page_size (void);
+static psize pp_mem_get_huge_page_size (void);
+static ppointer pp_mem_mmap_pages (psize n_bytes, pboolean use_huge_pages, pint numa_node, PError **error);
+static pboolean pp_mem_numa_check_policy (PMemNumaPolicy policy, pint node, PError **error);
+static pboolean pp_mem_check_region (ppointer *mem, psize *n_bytes, PError **error);
+static PMemArenaChunk * pp_mem_arena_chunk_new (PMemArena *arena, psize size);
+static void pp_mem_arena_chunk_free (PMemArena *arena, PMemArenaChunk *chunk);
+static ppointer pp_mem_arena_alloc (PMemArena *arena, psize n_bytes);
+static pboolean pp_mem_arena_owns (const PMemArena *arena, pconstpointer mem);
+static pboolean pp_mem_arena_is_last (const PMemArena *arena, const pchar *block, psize size);
+static ppointer pp_mem_arena_table_malloc (psize n_bytes);
+static ppointer pp_mem_arena_table_realloc (ppointer mem, psize n_bytes);
+static void pp_mem_arena_table_free (ppointer mem);
 
 void
 p_mem_init (void)
@@ -68,51 +231,467 @@ p_mem_shutdown (void)
 	p_mem_table.malloc  = NULL;
 	p_mem_table.realloc = NULL;
 	p_mem_table.free    = NULL;
+	p_mem_calloc        = NULL;
 
 	p_mem_table_inited = FALSE;
 }
 
+#ifdef PLIBSYS_MEM_STATS
+/* Slots are filled in order and never released. A source file normally passes
+ * the same name pointer every time, the names are compared only before taking
+ * a new slot */
+static pint
+pp_mem_stats_module_index (const pchar *file)
+{
+	const pchar	*name;
+	pint		i;
+	pint		j;
+
+	if (file == NULL)
+		return 0;
+
+	for (i = 1; i < P_MEM_STATS_MAX_MODULES; ++i) {
+		name = (const pchar *) p_atomic_pointer_get (&p_mem_stats_modules[i].file);
+
+		if (P_LIKELY (name == file))
+			return i;
+
+		if (name != NULL)
+			continue;
+
+		for (j = 1; j < i; ++j) {
+			if (strcmp (p_mem_stats_modules[j].file, file) == 0)
+				return j;
+		}
+
+		if (p_atomic_pointer_compare_and_exchange (&p_mem_stats_modules[i].file,
+							   NULL,
+							   (ppointer) file) == TRUE)
+			return i;
+
+		/* Somebody else took the slot, check it once again */
+		--i;
+	}
+
+	return 0;
+}
+
+static const pchar *
+pp_mem_stats_module_name (pint index)
+{
+	const pchar	*file;
+	const pchar	*ret;
+
+	if (index == 0)
+		return "application";
+
+	file = (const pchar *) p_atomic_pointer_get (&p_mem_stats_modules[index].file);
+
+	for (ret = file; *file != '\0'; ++file) {
+		if (*file == '/' || *file == '\\')
+			ret = file + 1;
+	}
+
+	return ret;
+}
+
+static pint
+pp_mem_stats_size_class (psize n_bytes)
+{
+	psize	limit;
+	pint	ret;
+
+	for (ret = 0, limit = 16; n_bytes > limit && ret < P_MEM_STATS_SIZE_CLASSES - 1; ++ret)
+		limit <<= 1;
+
+	return ret;
+}
+
+/* Counters only need atomicity, no ordering with other memory */
+static pssize
+pp_mem_stats_add (volatile psize	*counter,
+		  pssize		delta)
+{
+	return p_atomic_pointer_add_explicit (counter, delta, P_ATOMIC_MEMORY_ORDER_RELAXED);
+}
+
+static void
+pp_mem_stats_update (PMemStatsCounters	*counters,
+		     PMemTraceEvent	event,
+		     pssize		delta,
+		     psize		n_bytes)
+{
+	psize live;
+	psize peak;
+
+	switch (event) {
+	case P_MEM_TRACE_EVENT_ALLOC:
+		pp_mem_stats_add (&counters->alloc_calls, 1);
+		pp_mem_stats_add (&counters->size_classes[pp_mem_stats_size_class (n_bytes)], 1);
+		break;
+	case P_MEM_TRACE_EVENT_REALLOC:
+		pp_mem_stats_add (&counters->realloc_calls, 1);
+		pp_mem_stats_add (&counters->size_classes[pp_mem_stats_size_class (n_bytes)], 1);
+		break;
+	case P_MEM_TRACE_EVENT_FREE:
+		pp_mem_stats_add (&counters->free_calls, 1);
+		break;
+	}
+
+	live = (psize) (pp_mem_stats_add (&counters->bytes_live, delta) + delta);
+
+	if (delta <= 0)
+		return;
+
+	do {
+		peak = (psize) p_atomic_pointer_get_explicit (&counters->bytes_peak,
+							       P_ATOMIC_MEMORY_ORDER_RELAXED);
+
+		if (peak >= live)
+			break;
+	} while (p_atomic_pointer_compare_and_exchange_explicit (&counters->bytes_peak,
+								 (ppointer) peak,
+								 (ppointer) live,
+								 P_ATOMIC_MEMORY_ORDER_RELAXED) == FALSE);
+}
+
+static void
+pp_mem_stats_account (pint		module,
+		      PMemTraceEvent	event,
+		      pssize		delta,
+		      psize		n_bytes)
+{
+	pp_mem_stats_update (&p_mem_stats_total, event, delta, n_bytes);
+	pp_mem_stats_update (&p_mem_stats_modules[module].counters, event, delta, n_bytes);
+}
+
+static void
+pp_mem_stats_fail (pint module)
+{
+	pp_mem_stats_add (&p_mem_stats_total.failed_calls, 1);
+	pp_mem_stats_add (&p_mem_stats_modules[module].counters.failed_calls, 1);
+}
+
+static void
+pp_mem_stats_trace (PMemTraceEvent	event,
+		    pconstpointer	old_mem,
+		    pconstpointer	mem,
+		    psize		n_bytes,
+		    pint		module)
+{
+	if (p_mem_stats_trace_func == NULL)
+		return;
+
+	p_mem_stats_trace_func (event,
+				old_mem,
+				mem,
+				n_bytes,
+				pp_mem_stats_module_name (module),
+				p_mem_stats_trace_data);
+}
+
+static void
+pp_mem_stats_free (ppointer mem)
+{
+	PMemStatsHeader	*header;
+	psize		size;
+	pint		module;
+
+	header = (PMemStatsHeader *) ((pchar *) mem - P_MEM_STATS_HEADER);
+	size   = header->size;
+	module = header->module;
+
+	P_MEM_TABLE->free (header);
+
+	pp_mem_stats_account (module, P_MEM_TRACE_EVENT_FREE, -((pssize) size), 0);
+	pp_mem_stats_trace (P_MEM_TRACE_EVENT_FREE, NULL, mem, 0, module);
+}
+
+static void
+pp_mem_stats_read (const PMemStatsCounters *counters, PMemStats *stats)
+{
+	pint i;
+
+	stats->alloc_calls   = (psize) p_atomic_pointer_get (&counters->alloc_calls);
+	stats->realloc_calls = (psize) p_atomic_pointer_get (&counters->realloc_calls);
+	stats->free_calls    = (psize) p_atomic_pointer_get (&counters->free_calls);
+	stats->failed_calls  = (psize) p_atomic_pointer_get (&counters->failed_calls);
+	stats->bytes_live    = (psize) p_atomic_pointer_get (&counters->bytes_live);
+	stats->bytes_peak    = (psize) p_atomic_pointer_get (&counters->bytes_peak);
+
+	for (i = 0; i < P_MEM_STATS_SIZE_CLASSES; ++i)
+		stats->size_classes[i] = (psize) p_atomic_pointer_get (&counters->size_classes[i]);
+}
+
+static void
+pp_mem_stats_clear (PMemStatsCounters *counters)
+{
+	pint i;
+
+	p_atomic_pointer_set (&counters->alloc_calls, NULL);
+	p_atomic_pointer_set (&counters->realloc_calls, NULL);
+	p_atomic_pointer_set (&counters->free_calls, NULL);
+	p_atomic_pointer_set (&counters->failed_calls, NULL);
+	p_atomic_pointer_set (&counters->bytes_peak, p_atomic_pointer_get (&counters->bytes_live));
+
+	for (i = 0; i < P_MEM_STATS_SIZE_CLASSES; ++i)
+		p_atomic_pointer_set (&counters->size_classes[i], NULL);
+}
+
+ppointer
+p_mem_stats_malloc (psize n_bytes, const pchar *module)
+{
+	PMemStatsHeader	*header;
+	ppointer	ret;
+	pint		index;
+
+	if (P_UNLIKELY (n_bytes == 0))
+		return NULL;
+
+	index = pp_mem_stats_module_index (module);
+
+	if (P_UNLIKELY (n_bytes > P_MAXSIZE - P_MEM_STATS_HEADER ||
+			(header = P_MEM_TABLE->malloc (n_bytes + P_MEM_STATS_HEADER)) == NULL)) {
+		pp_mem_stats_fail (index);
+		pp_mem_stats_trace (P_MEM_TRACE_EVENT_ALLOC, NULL, NULL, n_bytes, index);
+		return NULL;
+	}
+
+	header->size   = n_bytes;
+	header->module = index;
+
+	ret = (pchar *) header + P_MEM_STATS_HEADER;
+
+	pp_mem_stats_account (index, P_MEM_TRACE_EVENT_ALLOC, (pssize) n_bytes, n_bytes);
+	pp_mem_stats_trace (P_MEM_TRACE_EVENT_ALLOC, NULL, ret, n_bytes, index);
+
+	return ret;
+}
+
+ppointer
+p_mem_stats_malloc0 (psize n_bytes, const pchar *module)
+{
+	PMemStatsHeader	*header;
+	ppointer	ret;
+	pint		index;
+	ppointer	(*calloc_func) (psize n_blocks, psize block_size);
+
+	if ((calloc_func = P_MEM_CALLOC) == NULL) {
+		if (P_UNLIKELY ((ret = p_mem_stats_malloc (n_bytes, module)) == NULL))
+			return NULL;
+
+		memset (ret, 0, n_bytes);
+
+		return ret;
+	}
+
+	if (P_UNLIKELY (n_bytes == 0))
+		return NULL;
+
+	index = pp_mem_stats_module_index (module);
+
+	if (P_UNLIKELY (n_bytes > P_MAXSIZE - P_MEM_STATS_HEADER ||
+			(header = calloc_func (1, n_bytes + P_MEM_STATS_HEADER)) == NULL)) {
+		pp_mem_stats_fail (index);
+		pp_mem_stats_trace (P_MEM_TRACE_EVENT_ALLOC, NULL, NULL, n_bytes, index);
+		return NULL;
+	}
+
+	header->size   = n_bytes;
+	header->module = index;
+
+	ret = (pchar *) header + P_MEM_STATS_HEADER;
+
+	pp_mem_stats_account (index, P_MEM_TRACE_EVENT_ALLOC, (pssize) n_bytes, n_bytes);
+	pp_mem_stats_trace (P_MEM_TRACE_EVENT_ALLOC, NULL, ret, n_bytes, index);
+
+	return ret;
+}
+
+ppointer
+p_mem_stats_realloc (ppointer mem, psize n_bytes, const pchar *module)
+{
+	PMemStatsHeader	*header;
+	ppointer	ret;
+	psize		old_size;
+	pint		index;
+
+	if (P_UNLIKELY (n_bytes == 0))
+		return NULL;
+
+	if (P_UNLIKELY (mem == NULL))
+		return p_mem_stats_malloc (n_bytes, module);
+
+	header   = (PMemStatsHeader *) ((pchar *) mem - P_MEM_STATS_HEADER);
+	old_size = header->size;
+	index    = header->module;
+
+	if (P_UNLIKELY (n_bytes > P_MAXSIZE - P_MEM_STATS_HEADER ||
+			(header = P_MEM_TABLE->realloc (header, n_bytes + P_MEM_STATS_HEADER)) == NULL)) {
+		pp_mem_stats_fail (index);
+		pp_mem_stats_trace (P_MEM_TRACE_EVENT_REALLOC, mem, NULL, n_bytes, index);
+		return NULL;
+	}
+
+	header->size = n_bytes;
+
+	ret = (pchar *) header + P_MEM_STATS_HEADER;
+
+	pp_mem_stats_account (index, P_MEM_TRACE_EVENT_REALLOC, (pssize) n_bytes - (pssize) old_size, n_bytes);
+	pp_mem_stats_trace (P_MEM_TRACE_EVENT_REALLOC, mem, ret, n_bytes, index);
+
+	return ret;
+}
+#endif
+
 P_LIB_API ppointer
 p_malloc (psize n_bytes)
 {
+#ifdef PLIBSYS_MEM_STATS
+	return p_mem_stats_malloc (n_bytes, NULL);
+#else
 	if (P_LIKELY (n_bytes > 0))
-		return p_mem_table.malloc (n_bytes);
+		return P_MEM_TABLE->malloc (n_bytes);
 	else
 		return NULL;
+#endif
 }
 
 P_LIB_API ppointer
 p_malloc0 (psize n_bytes)
 {
+#ifdef PLIBSYS_MEM_STATS
+	return p_mem_stats_malloc0 (n_bytes, NULL);
+#else
 	ppointer ret;
+	ppointer (*calloc_func) (psize n_blocks, psize block_size);
 
 	if (P_LIKELY (n_bytes > 0)) {
-		if (P_UNLIKELY ((ret = p_mem_table.malloc (n_bytes)) == NULL))
+		/* Fresh pages from the system are already zeroed */
+		if ((calloc_func = P_MEM_CALLOC) != NULL)
+			return calloc_func (1, n_bytes);
+
+		if (P_UNLIKELY ((ret = P_MEM_TABLE->malloc (n_bytes)) == NULL))
 			return NULL;
 
 		memset (ret, 0, n_bytes);
 		return ret;
 	} else
 		return NULL;
+#endif
 }
 
 P_LIB_API ppointer
 p_realloc (ppointer mem, psize n_bytes)
 {
+#ifdef PLIBSYS_MEM_STATS
+	return p_mem_stats_realloc (mem, n_bytes, NULL);
+#else
 	if (P_UNLIKELY (n_bytes == 0))
 		return NULL;
 
 	if (P_UNLIKELY (mem == NULL))
-		return p_mem_table.malloc (n_bytes);
+		return P_MEM_TABLE->malloc (n_bytes);
 	else
-		return p_mem_table.realloc (mem, n_bytes);
+		return P_MEM_TABLE->realloc (mem, n_bytes);
+#endif
 }
 
 P_LIB_API void
 p_free (ppointer mem)
+{
+	if (P_UNLIKELY (mem == NULL))
+		return;
+
+#ifdef PLIBSYS_MEM_STATS
+	pp_mem_stats_free (mem);
+#else
+	P_MEM_TABLE->free (mem);
+#endif
+}
+
+/* The original block address is kept right before the aligned one */
+static ppointer
+pp_mem_malloc_aligned (psize n_bytes, psize alignment)
+{
+	pchar	*block;
+	psize	addr;
+
+	if (P_UNLIKELY (n_bytes > P_MAXSIZE - alignment - sizeof (ppointer)))
+		return NULL;
+
+	if (P_UNLIKELY ((block = p_malloc (n_bytes + alignment - 1 + sizeof (ppointer))) == NULL))
+		return NULL;
+
+	addr = ((psize) (block + sizeof (ppointer)) + alignment - 1) & ~(alignment - 1);
+
+	((ppointer *) addr)[-1] = block;
+
+	return (ppointer) addr;
+}
+
+static void
+pp_mem_free_aligned (ppointer mem)
+{
+	p_free (((ppointer *) mem)[-1]);
+}
+
+P_LIB_API ppointer
+p_malloc_aligned (psize	n_bytes,
+		  psize	alignment)
+{
+	if (P_UNLIKELY (n_bytes == 0 || alignment == 0 || (alignment & (alignment - 1)) != 0))
+		return NULL;
+
+	if (alignment < sizeof (ppointer))
+		alignment = sizeof (ppointer);
+
+	if (P_UNLIKELY (n_bytes > P_MAXSIZE - alignment))
+		return NULL;
+
+	n_bytes = (n_bytes + alignment - 1) & ~(alignment - 1);
+
+	return p_mem_aligned_table.malloc_aligned (n_bytes, alignment);
+}
+
+P_LIB_API ppointer
+p_malloc0_aligned (psize	n_bytes,
+		   psize	alignment)
+{
+	ppointer ret;
+
+	if (P_UNLIKELY ((ret = p_malloc_aligned (n_bytes, alignment)) == NULL))
+		return NULL;
+
+	memset (ret, 0, n_bytes);
+
+	return ret;
+}
+
+P_LIB_API void
+p_free_aligned (ppointer mem)
 {
 	if (P_LIKELY (mem != NULL))
-		p_mem_table.free (mem);
+		p_mem_aligned_table.free_aligned (mem);
+}
+
+P_LIB_API pboolean
+p_mem_set_aligned_vtable (const PMemAlignedVTable *table)
+{
+	if (table == NULL) {
+		p_mem_aligned_table.malloc_aligned = pp_mem_malloc_aligned;
+		p_mem_aligned_table.free_aligned   = pp_mem_free_aligned;
+
+		return TRUE;
+	}
+
+	if (P_UNLIKELY (table->malloc_aligned == NULL || table->free_aligned == NULL))
+		return FALSE;
+
+	p_mem_aligned_table.malloc_aligned = table->malloc_aligned;
+	p_mem_aligned_table.free_aligned   = table->free_aligned;
+
+	return TRUE;
 }
 
 P_LIB_API pboolean
@@ -127,52 +706,168 @@ p_mem_set_vtable (const PMemVTable *table)
 	p_mem_table.malloc  = table->malloc;
 	p_mem_table.realloc = table->realloc;
 	p_mem_table.free    = table->free;
+	p_mem_calloc        = NULL;
 
 	p_mem_table_inited = TRUE;
 
 	return TRUE;
 }
 
+P_LIB_API pboolean
+p_mem_push_thread_vtable (const PMemVTable *table)
+{
+	if (P_UNLIKELY (table == NULL))
+		return FALSE;
+
+	if (P_UNLIKELY (table->free == NULL || table->malloc == NULL || table->realloc == NULL))
+		return FALSE;
+
+#ifdef P_MEM_THREAD_LOCAL
+	if (P_UNLIKELY (p_mem_thread_depth == P_MEM_THREAD_VTABLE_MAX_DEPTH)) {
+		P_WARNING ("PMem::p_mem_push_thread_vtable: too many nested tables");
+		return FALSE;
+	}
+
+	p_mem_thread_table = &p_mem_thread_tables[p_mem_thread_depth++];
+
+	p_mem_thread_table->malloc  = table->malloc;
+	p_mem_thread_table->realloc = table->realloc;
+	p_mem_thread_table->free    = table->free;
+
+	return TRUE;
+#else
+	P_WARNING ("PMem::p_mem_push_thread_vtable: no thread-local storage support");
+	return FALSE;
+#endif
+}
+
+P_LIB_API pboolean
+p_mem_pop_thread_vtable (void)
+{
+#ifdef P_MEM_THREAD_LOCAL
+	if (P_UNLIKELY (p_mem_thread_depth == 0))
+		return FALSE;
+
+	--p_mem_thread_depth;
+
+	p_mem_thread_table = p_mem_thread_depth > 0 ? &p_mem_thread_tables[p_mem_thread_depth - 1] : NULL;
+
+	return TRUE;
+#else
+	return FALSE;
+#endif
+}
+
+P_LIB_API void
+p_mem_set_calloc (ppointer (*calloc_func) (psize n_blocks, psize block_size))
+{
+	p_mem_calloc = calloc_func;
+}
+
 P_LIB_API void
 p_mem_restore_vtable (void)
 {
 	p_mem_table.malloc  = (ppointer (*)(psize)) malloc;
 	p_mem_table.realloc = (ppointer (*)(ppointer, psize)) realloc;
 	p_mem_table.free    = (void (*)(ppointer)) free;
+	p_mem_calloc        = (ppointer (*)(psize, psize)) calloc;
+
+	p_mem_aligned_table.malloc_aligned = pp_mem_malloc_aligned;
+	p_mem_aligned_table.free_aligned   = pp_mem_free_aligned;
 
 	p_mem_table_inited = TRUE;
 }
 
-P_LIB_API ppointer
-p_mem_mmap (psize	n_bytes,
-	    PError	**error)
+static psize
+pp_mem_get_page_size (void)
 {
-	ppointer	addr;
 #if defined (P_OS_WIN)
-	HANDLE		hdl;
+	SYSTEM_INFO	sys_info;
+
+	GetSystemInfo (&sys_info);
+
+	return (psize) sys_info.dwPageSize;
 #elif defined (P_OS_BEOS)
-	area_id		area;
-#elif defined (P_OS_OS2)
-	APIRET		ulrc;
+	return B_PAGE_SIZE;
+#elif defined (P_OS_OS2) || defined (P_OS_AMIGA)
+	return 4096;
+#else
+	long page_size;
+
+	if (P_UNLIKELY ((page_size = sysconf (_SC_PAGESIZE)) <= 0))
+		return 4096;
+
+	return (psize) page_size;
+#endif
+}
+
+/* Returns 0 if explicit huge pages are not supported */
+static psize
+pp_mem_get_huge_page_size (void)
+{
+#if defined (P_OS_WIN)
+	return (psize) GetLargePageMinimum ();
+#elif defined (P_OS_LINUX) && defined (MAP_HUGETLB)
+	static psize	huge_page_size = 0;
+	FILE		*meminfo;
+	pchar		line[128];
+	unsigned long	size_kb;
+
+	if (huge_page_size != 0)
+		return huge_page_size;
+
+	if (P_UNLIKELY ((meminfo = fopen ("/proc/meminfo", "r")) == NULL))
+		return 0;
+
+	while (fgets (line, sizeof (line), meminfo) != NULL) {
+		if (sscanf (line, "Hugepagesize: %lu kB", &size_kb) == 1) {
+			huge_page_size = (psize) size_kb * 1024;
+			break;
+		}
+	}
+
+	fclose (meminfo);
+
+	return huge_page_size;
+#else
+	return 0;
+#endif
+}
+
+/* NUMA node is only used on Windows, Linux sets the policy after mapping */
+static ppointer
+pp_mem_mmap_pages (psize	n_bytes,
+		   pboolean	use_huge_pages,
+		   pint		numa_node,
+		   PError	**error)
+{
+	ppointer			addr;
+#if defined (P_OS_WIN)
+	HANDLE				hdl;
+	HMODULE				hmodule;
+	PMemMapViewOfFileExNumaFunc	map_view_numa = NULL;
+	DWORD				protect = PAGE_READWRITE;
+	DWORD				access  = FILE_MAP_READ | FILE_MAP_WRITE;
+#elif defined (P_OS_BEOS)
+	area_id		area;
+#elif defined (P_OS_OS2)
+	APIRET		ulrc;
 #elif !defined (P_OS_AMIGA)
 	int		fd;
 	int		map_flags = MAP_PRIVATE;
 #endif
 
-	if (P_UNLIKELY (n_bytes == 0)) {
-		p_error_set_error_p (error,
-				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
-				     0,
-				     "Invalid input argument");
-		return NULL;
+#if defined (P_OS_WIN)
+	if (use_huge_pages == TRUE) {
+		protect |= SEC_COMMIT | SEC_LARGE_PAGES;
+		access  |= FILE_MAP_LARGE_PAGES;
 	}
 
-#if defined (P_OS_WIN)
 	if (P_UNLIKELY ((hdl = CreateFileMappingA (INVALID_HANDLE_VALUE,
 						   NULL,
-						   PAGE_READWRITE,
-						   0,
-						   (DWORD) n_bytes,
+						   protect,
+						   (DWORD) ((puint64) n_bytes >> 32),
+						   (DWORD) (n_bytes & 0xFFFFFFFF),
 						   NULL)) == NULL)) {
 		p_error_set_error_p (error,
 				     (pint) p_error_get_last_io (),
@@ -181,11 +876,15 @@ p_mem_mmap (psize	n_bytes,
 		return NULL;
 	}
 
-	if (P_UNLIKELY ((addr = MapViewOfFile (hdl,
-					       FILE_MAP_READ | FILE_MAP_WRITE,
-					       0,
-					       0,
-					       n_bytes)) == NULL)) {
+	if (numa_node >= 0 && (hmodule = GetModuleHandleA ("kernel32.dll")) != NULL)
+		map_view_numa = (PMemMapViewOfFileExNumaFunc) GetProcAddress (hmodule, "MapViewOfFileExNuma");
+
+	if (map_view_numa != NULL)
+		addr = map_view_numa (hdl, access, 0, 0, n_bytes, NULL, (DWORD) numa_node);
+	else
+		addr = MapViewOfFile (hdl, access, 0, 0, n_bytes);
+
+	if (P_UNLIKELY (addr == NULL)) {
 		p_error_set_error_p (error,
 				     (pint) p_error_get_last_io (),
 				     p_error_get_last_system (),
@@ -203,6 +902,9 @@ p_mem_mmap (psize	n_bytes,
 		return NULL;
 	}
 #elif defined (P_OS_BEOS)
+	P_UNUSED (use_huge_pages);
+	P_UNUSED (numa_node);
+
 	if (P_LIKELY ((n_bytes % B_PAGE_SIZE)) != 0)
 		n_bytes = (n_bytes / B_PAGE_SIZE + 1) * B_PAGE_SIZE;
 
@@ -216,6 +918,9 @@ p_mem_mmap (psize	n_bytes,
 		return NULL;
 	}
 #elif defined (P_OS_OS2)
+	P_UNUSED (use_huge_pages);
+	P_UNUSED (numa_node);
+
 	if (P_UNLIKELY ((ulrc = DosAllocMem ((PPVOID) &addr,
 					     (ULONG) n_bytes,
 					     PAG_READ | PAG_WRITE | PAG_COMMIT |
@@ -232,6 +937,9 @@ p_mem_mmap (psize	n_bytes,
 		}
 	}
 #elif defined (P_OS_AMIGA)
+	P_UNUSED (use_huge_pages);
+	P_UNUSED (numa_node);
+
 	addr = malloc (n_bytes);
 
 	if (P_UNLIKELY (addr == NULL)) {
@@ -260,6 +968,15 @@ p_mem_mmap (psize	n_bytes,
 	map_flags |= MAP_ANON;
 #  endif
 
+	P_UNUSED (numa_node);
+
+#  ifdef MAP_HUGETLB
+	if (use_huge_pages == TRUE)
+		map_flags |= MAP_HUGETLB;
+#  else
+	P_UNUSED (use_huge_pages);
+#  endif
+
 	if (P_UNLIKELY ((addr = mmap (NULL,
 				      n_bytes,
 				      PROT_READ | PROT_WRITE,
@@ -292,6 +1009,73 @@ p_mem_mmap (psize	n_bytes,
 	return addr;
 }
 
+P_LIB_API ppointer
+p_mem_mmap (psize	n_bytes,
+	    PError	**error)
+{
+	return p_mem_mmap_full (n_bytes, P_MEM_MAP_FLAG_NONE, NULL, error);
+}
+
+P_LIB_API ppointer
+p_mem_mmap_full (psize	n_bytes,
+		 pint	flags,
+		 psize	*page_size,
+		 PError	**error)
+{
+	ppointer	addr;
+	psize		huge_page_size;
+	pboolean	use_fallback;
+
+	if (P_UNLIKELY (n_bytes == 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return NULL;
+	}
+
+	use_fallback = (flags & P_MEM_MAP_FLAG_FALLBACK) != 0 ? TRUE : FALSE;
+
+	if ((flags & P_MEM_MAP_FLAG_HUGE_PAGES) != 0) {
+		huge_page_size = pp_mem_get_huge_page_size ();
+
+		if (huge_page_size != 0 && n_bytes <= P_MAXSIZE - huge_page_size) {
+			addr = pp_mem_mmap_pages ((n_bytes + huge_page_size - 1) / huge_page_size * huge_page_size,
+						  TRUE,
+						  -1,
+						  use_fallback == TRUE ? NULL : error);
+
+			if (addr != NULL) {
+				if (page_size != NULL)
+					*page_size = huge_page_size;
+
+				return addr;
+			}
+		} else if (use_fallback == FALSE)
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IO_NOT_SUPPORTED,
+					     0,
+					     "Huge pages are not supported");
+
+		if (use_fallback == FALSE)
+			return NULL;
+	}
+
+	if (P_UNLIKELY ((addr = pp_mem_mmap_pages (n_bytes, FALSE, -1, error)) == NULL))
+		return NULL;
+
+#if defined (P_OS_LINUX) && defined (MADV_HUGEPAGE)
+	/* Only a hint, the kernel may have transparent huge pages disabled */
+	if ((flags & P_MEM_MAP_FLAG_TRANSPARENT_HUGE_PAGES) != 0)
+		madvise (addr, n_bytes, MADV_HUGEPAGE);
+#endif
+
+	if (page_size != NULL)
+		*page_size = pp_mem_get_page_size ();
+
+	return addr;
+}
+
 P_LIB_API pboolean
 p_mem_munmap (ppointer	mem,
 	      psize	n_bytes,
@@ -355,3 +1139,834 @@ p_mem_munmap (ppointer	mem,
 	} else
 		return TRUE;
 }
+
+static PMemArenaChunk *
+pp_mem_arena_chunk_new (PMemArena *arena, psize size)
+{
+	PMemArenaChunk *ret;
+
+	if (arena->use_mmap == TRUE)
+		ret = p_mem_mmap (size, NULL);
+	else
+		ret = arena->chunk_table.malloc (size);
+
+	if (P_UNLIKELY (ret == NULL))
+		return NULL;
+
+	ret->next = NULL;
+	ret->size = size;
+
+	return ret;
+}
+
+static void
+pp_mem_arena_chunk_free (PMemArena *arena, PMemArenaChunk *chunk)
+{
+	if (arena->use_mmap == TRUE) {
+		if (P_UNLIKELY (p_mem_munmap (chunk, chunk->size, NULL) == FALSE))
+			P_WARNING ("PMem::pp_mem_arena_chunk_free: failed to unmap memory");
+	} else
+		arena->chunk_table.free (chunk);
+}
+
+static ppointer
+pp_mem_arena_alloc (PMemArena *arena, psize n_bytes)
+{
+	PMemArenaChunk	*chunk;
+	psize		size;
+	ppointer	ret;
+
+	size = P_MEM_ARENA_ALIGN_UP (n_bytes);
+
+	if (P_UNLIKELY (size < n_bytes))
+		return NULL;
+
+	/* Large blocks would waste the rest of the regular chunks */
+	if (size > arena->chunk_size / 4) {
+		if (P_UNLIKELY (size > (psize) -1 - P_MEM_ARENA_CHUNK_HEADER))
+			return NULL;
+
+		if (P_UNLIKELY ((chunk = pp_mem_arena_chunk_new (arena, size + P_MEM_ARENA_CHUNK_HEADER)) == NULL))
+			return NULL;
+
+		chunk->next         = arena->large_chunks;
+		arena->large_chunks = chunk;
+
+		return (pchar *) chunk + P_MEM_ARENA_CHUNK_HEADER;
+	}
+
+	if (arena->cur_chunk == NULL || arena->offset + size > arena->cur_chunk->size) {
+		/* The chunks kept after the reset go first */
+		chunk = arena->cur_chunk == NULL ? arena->chunks : arena->cur_chunk->next;
+
+		if (chunk == NULL) {
+			if (P_UNLIKELY ((chunk = pp_mem_arena_chunk_new (arena, arena->chunk_size)) == NULL))
+				return NULL;
+
+			if (arena->cur_chunk == NULL)
+				arena->chunks = chunk;
+			else
+				arena->cur_chunk->next = chunk;
+		}
+
+		arena->cur_chunk = chunk;
+		arena->offset    = P_MEM_ARENA_CHUNK_HEADER;
+	}
+
+	ret            = (pchar *) arena->cur_chunk + arena->offset;
+	arena->offset += size;
+
+	return ret;
+}
+
+/* Chunks after the current one hold no blocks since the last reset */
+static pboolean
+pp_mem_arena_owns (const PMemArena *arena, pconstpointer mem)
+{
+	const PMemArenaChunk	*chunk;
+	const PMemArenaChunk	*last_chunk;
+
+	last_chunk = arena->cur_chunk == NULL ? NULL : arena->cur_chunk->next;
+
+	for (chunk = arena->chunks; chunk != last_chunk; chunk = chunk->next) {
+		if ((const pchar *) mem >= (const pchar *) chunk + P_MEM_ARENA_CHUNK_HEADER &&
+		    (const pchar *) mem < (const pchar *) chunk + chunk->size)
+			return TRUE;
+	}
+
+	for (chunk = arena->large_chunks; chunk != NULL; chunk = chunk->next) {
+		if ((const pchar *) mem >= (const pchar *) chunk + P_MEM_ARENA_CHUNK_HEADER &&
+		    (const pchar *) mem < (const pchar *) chunk + chunk->size)
+			return TRUE;
+	}
+
+	return FALSE;
+}
+
+static pboolean
+pp_mem_arena_is_last (const PMemArena *arena, const pchar *block, psize size)
+{
+	const pchar *chunk_start;
+
+	if (arena->cur_chunk == NULL)
+		return FALSE;
+
+	chunk_start = (const pchar *) arena->cur_chunk;
+
+	return block >= chunk_start + P_MEM_ARENA_CHUNK_HEADER &&
+	       block + size == chunk_start + arena->offset ? TRUE : FALSE;
+}
+
+static ppointer
+pp_mem_arena_table_malloc (psize n_bytes)
+{
+	pchar *block;
+
+	if (P_UNLIKELY (n_bytes > (psize) -1 - P_MEM_ARENA_ALIGN - P_MEM_ARENA_BLOCK_HEADER))
+		return NULL;
+
+	if (P_UNLIKELY ((block = pp_mem_arena_alloc (p_mem_active_arena, n_bytes + P_MEM_ARENA_BLOCK_HEADER)) == NULL))
+		return NULL;
+
+	*((psize *) block) = n_bytes;
+
+	return block + P_MEM_ARENA_BLOCK_HEADER;
+}
+
+static ppointer
+pp_mem_arena_table_realloc (ppointer mem, psize n_bytes)
+{
+	PMemArena	*arena;
+	PMemArena	*base_arena;
+	pchar		*block;
+	psize		old_bytes;
+	psize		old_size;
+	psize		new_size;
+	ppointer	ret;
+
+	base_arena = p_mem_active_arena;
+
+	for (arena = p_mem_active_arena; arena != NULL; arena = arena->prev_arena) {
+		if (pp_mem_arena_owns (arena, mem) == FALSE) {
+			base_arena = arena;
+			continue;
+		}
+
+		if (P_UNLIKELY (n_bytes > (psize) -1 - P_MEM_ARENA_ALIGN - P_MEM_ARENA_BLOCK_HEADER))
+			return NULL;
+
+		block     = (pchar *) mem - P_MEM_ARENA_BLOCK_HEADER;
+		old_bytes = *((psize *) block);
+		old_size  = P_MEM_ARENA_ALIGN_UP (old_bytes + P_MEM_ARENA_BLOCK_HEADER);
+		new_size  = P_MEM_ARENA_ALIGN_UP (n_bytes + P_MEM_ARENA_BLOCK_HEADER);
+
+		/* The last block can grow or shrink in place */
+		if (pp_mem_arena_is_last (arena, block, old_size) == TRUE &&
+		    arena->offset - old_size + new_size <= arena->cur_chunk->size) {
+			arena->offset      = arena->offset - old_size + new_size;
+			*((psize *) block) = n_bytes;
+
+			return mem;
+		}
+
+		if (P_UNLIKELY ((ret = pp_mem_arena_table_malloc (n_bytes)) == NULL))
+			return NULL;
+
+		memcpy (ret, mem, old_bytes < n_bytes ? old_bytes : n_bytes);
+
+		return ret;
+	}
+
+	/* The block was allocated before the outermost arena was installed */
+	return base_arena->prev_table.realloc (mem, n_bytes);
+}
+
+static void
+pp_mem_arena_table_free (ppointer mem)
+{
+	PMemArena	*arena;
+	PMemArena	*base_arena;
+	pchar		*block;
+	psize		size;
+
+	base_arena = p_mem_active_arena;
+
+	for (arena = p_mem_active_arena; arena != NULL; arena = arena->prev_arena) {
+		if (pp_mem_arena_owns (arena, mem) == FALSE) {
+			base_arena = arena;
+			continue;
+		}
+
+		block = (pchar *) mem - P_MEM_ARENA_BLOCK_HEADER;
+		size  = P_MEM_ARENA_ALIGN_UP (*((psize *) block) + P_MEM_ARENA_BLOCK_HEADER);
+
+		if (pp_mem_arena_is_last (arena, block, size) == TRUE)
+			arena->offset -= size;
+
+		return;
+	}
+
+	base_arena->prev_table.free (mem);
+}
+
+P_LIB_API PMemArena *
+p_mem_arena_new (psize		chunk_size,
+		 pboolean	use_mmap)
+{
+	PMemArena	*ret;
+	PMemArena	*base_arena;
+	PMemVTable	chunk_table;
+
+	if (chunk_size == 0)
+		chunk_size = P_MEM_ARENA_DEFAULT_CHUNK;
+	else if (chunk_size < P_MEM_ARENA_MIN_CHUNK)
+		chunk_size = P_MEM_ARENA_MIN_CHUNK;
+
+	/* The table may change later, the chunks are released with this one. An
+	 * installed arena would serve the chunks from the arena being created, so
+	 * take the table which was there before it */
+	chunk_table = p_mem_table;
+
+	for (base_arena = p_mem_active_arena; base_arena != NULL; base_arena = base_arena->prev_arena)
+		chunk_table = base_arena->prev_table;
+
+	if (P_UNLIKELY ((ret = chunk_table.malloc (sizeof (PMemArena))) == NULL)) {
+		P_ERROR ("PMem::p_mem_arena_new: failed to allocate memory");
+		return NULL;
+	}
+
+	memset (ret, 0, sizeof (PMemArena));
+
+	ret->chunk_size  = chunk_size;
+	ret->use_mmap    = use_mmap;
+	ret->chunk_table = chunk_table;
+
+	return ret;
+}
+
+P_LIB_API ppointer
+p_mem_arena_alloc (PMemArena	*arena,
+		   psize	n_bytes)
+{
+	if (P_UNLIKELY (arena == NULL || n_bytes == 0))
+		return NULL;
+
+	return pp_mem_arena_alloc (arena, n_bytes);
+}
+
+P_LIB_API void
+p_mem_arena_reset (PMemArena *arena)
+{
+	PMemArenaChunk *chunk;
+
+	if (P_UNLIKELY (arena == NULL))
+		return;
+
+	while (arena->large_chunks != NULL) {
+		chunk               = arena->large_chunks;
+		arena->large_chunks = chunk->next;
+
+		pp_mem_arena_chunk_free (arena, chunk);
+	}
+
+	arena->cur_chunk = NULL;
+	arena->offset    = 0;
+}
+
+P_LIB_API void
+p_mem_arena_free (PMemArena *arena)
+{
+	PMemArenaChunk *chunk;
+
+	if (P_UNLIKELY (arena == NULL))
+		return;
+
+	if (P_UNLIKELY (arena->is_installed == TRUE)) {
+		P_WARNING ("PMem::p_mem_arena_free: arena is still installed");
+		return;
+	}
+
+	p_mem_arena_reset (arena);
+
+	while (arena->chunks != NULL) {
+		chunk         = arena->chunks;
+		arena->chunks = chunk->next;
+
+		pp_mem_arena_chunk_free (arena, chunk);
+	}
+
+	arena->chunk_table.free (arena);
+}
+
+P_LIB_API pboolean
+p_mem_arena_install (PMemArena *arena)
+{
+	if (P_UNLIKELY (arena == NULL || arena->is_installed == TRUE))
+		return FALSE;
+
+	arena->prev_table   = p_mem_table;
+	arena->prev_calloc  = p_mem_calloc;
+	arena->prev_arena   = p_mem_active_arena;
+	arena->is_installed = TRUE;
+
+	p_mem_active_arena = arena;
+
+	p_mem_table.malloc  = pp_mem_arena_table_malloc;
+	p_mem_table.realloc = pp_mem_arena_table_realloc;
+	p_mem_table.free    = pp_mem_arena_table_free;
+
+	/* Arena blocks are reused after a reset, they must be cleared */
+	p_mem_calloc = NULL;
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_mem_arena_uninstall (PMemArena *arena)
+{
+	if (P_UNLIKELY (arena == NULL || arena != p_mem_active_arena))
+		return FALSE;
+
+	p_mem_table        = arena->prev_table;
+	p_mem_calloc       = arena->prev_calloc;
+	p_mem_active_arena = arena->prev_arena;
+
+	arena->prev_arena   = NULL;
+	arena->is_installed = FALSE;
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_mem_stats_get (PMemStats *stats)
+{
+#ifdef PLIBSYS_MEM_STATS
+	if (P_UNLIKELY (stats == NULL))
+		return FALSE;
+
+	pp_mem_stats_read (&p_mem_stats_total, stats);
+
+	return TRUE;
+#else
+	P_UNUSED (stats);
+	return FALSE;
+#endif
+}
+
+P_LIB_API pint
+p_mem_stats_get_modules (void)
+{
+#ifdef PLIBSYS_MEM_STATS
+	pint ret;
+
+	for (ret = 1; ret < P_MEM_STATS_MAX_MODULES; ++ret) {
+		if (p_atomic_pointer_get (&p_mem_stats_modules[ret].file) == NULL)
+			break;
+	}
+
+	return ret;
+#else
+	return 0;
+#endif
+}
+
+P_LIB_API const pchar *
+p_mem_stats_get_module (pint		index,
+			PMemStats	*stats)
+{
+#ifdef PLIBSYS_MEM_STATS
+	if (P_UNLIKELY (index < 0 || index >= p_mem_stats_get_modules ()))
+		return NULL;
+
+	if (stats != NULL)
+		pp_mem_stats_read (&p_mem_stats_modules[index].counters, stats);
+
+	return pp_mem_stats_module_name (index);
+#else
+	P_UNUSED (index);
+	P_UNUSED (stats);
+	return NULL;
+#endif
+}
+
+P_LIB_API void
+p_mem_stats_reset (void)
+{
+#ifdef PLIBSYS_MEM_STATS
+	pint i;
+
+	pp_mem_stats_clear (&p_mem_stats_total);
+
+	for (i = 0; i < P_MEM_STATS_MAX_MODULES; ++i)
+		pp_mem_stats_clear (&p_mem_stats_modules[i].counters);
+#endif
+}
+
+P_LIB_API pboolean
+p_mem_stats_set_trace_func (PMemTraceFunc	func,
+			    ppointer		user_data)
+{
+#ifdef PLIBSYS_MEM_STATS
+	p_mem_stats_trace_func = func;
+	p_mem_stats_trace_data = user_data;
+
+	return TRUE;
+#else
+	P_UNUSED (func);
+	P_UNUSED (user_data);
+	return FALSE;
+#endif
+}
+
+/* Extends the region to the page boundaries */
+static pboolean
+pp_mem_check_region (ppointer	*mem,
+		     psize	*n_bytes,
+		     PError	**error)
+{
+	psize page_offset;
+
+	if (P_UNLIKELY (*mem == NULL || *n_bytes == 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	page_offset = (psize) ((puintptr) *mem % pp_mem_get_page_size ());
+
+	*mem      = (ppointer) ((pchar *) *mem - page_offset);
+	*n_bytes += page_offset;
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_mem_advise (ppointer		mem,
+	      psize		n_bytes,
+	      PMemAdvice	advice,
+	      PError		**error)
+{
+#if defined (P_OS_WIN)
+	HMODULE				hmodule;
+	PMemPrefetchVirtualMemoryFunc	prefetch_func;
+	PMemRangeEntry			range;
+#elif !defined (P_OS_BEOS) && !defined (P_OS_OS2) && !defined (P_OS_AMIGA) && defined (MADV_NORMAL)
+	pint				sys_advice;
+#endif
+
+	if (P_UNLIKELY (advice < P_MEM_ADVICE_NORMAL || advice > P_MEM_ADVICE_DONTNEED)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid memory advice");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (pp_mem_check_region (&mem, &n_bytes, error) == FALSE))
+		return FALSE;
+
+#if defined (P_OS_WIN)
+	if (advice == P_MEM_ADVICE_DONTNEED) {
+		/* Unlocking pages which are not locked drops them from the working set */
+		VirtualUnlock (mem, n_bytes);
+		return TRUE;
+	}
+
+	if (advice != P_MEM_ADVICE_WILLNEED)
+		return TRUE;
+
+	if (P_UNLIKELY ((hmodule = GetModuleHandleA ("kernel32.dll")) == NULL))
+		return TRUE;
+
+	prefetch_func = (PMemPrefetchVirtualMemoryFunc) GetProcAddress (hmodule, "PrefetchVirtualMemory");
+
+	if (prefetch_func == NULL)
+		return TRUE;
+
+	range.addr    = mem;
+	range.n_bytes = (SIZE_T) n_bytes;
+
+	if (P_UNLIKELY (prefetch_func (GetCurrentProcess (), 1, &range, 0) == 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call PrefetchVirtualMemory() to read pages");
+		return FALSE;
+	}
+#elif !defined (P_OS_BEOS) && !defined (P_OS_OS2) && !defined (P_OS_AMIGA) && defined (MADV_NORMAL)
+	switch (advice) {
+	case P_MEM_ADVICE_SEQUENTIAL:
+		sys_advice = MADV_SEQUENTIAL;
+		break;
+	case P_MEM_ADVICE_RANDOM:
+		sys_advice = MADV_RANDOM;
+		break;
+	case P_MEM_ADVICE_WILLNEED:
+		sys_advice = MADV_WILLNEED;
+		break;
+	case P_MEM_ADVICE_DONTNEED:
+		sys_advice = MADV_DONTNEED;
+		break;
+	default:
+		sys_advice = MADV_NORMAL;
+		break;
+	}
+
+	if (P_UNLIKELY (madvise (mem, n_bytes, sys_advice) != 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call madvise() to set memory advice");
+		return FALSE;
+	}
+#endif
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_mem_prefault (ppointer	mem,
+		psize		n_bytes,
+		PError		**error)
+{
+	volatile pchar	*page;
+	pchar		*start;
+	pchar		*end;
+	pchar		*page_start;
+	psize		page_size;
+
+	start = (pchar *) mem;
+
+	if (P_UNLIKELY (pp_mem_check_region (&mem, &n_bytes, error) == FALSE))
+		return FALSE;
+
+	end = (pchar *) mem + n_bytes;
+
+#if defined (P_OS_LINUX) && defined (MADV_POPULATE_WRITE)
+	/* Older kernels reject the advice, fall back to touching the pages */
+	if (madvise (mem, n_bytes, MADV_POPULATE_WRITE) == 0)
+		return TRUE;
+#endif
+
+	page_size  = pp_mem_get_page_size ();
+	page_start = (pchar *) mem;
+
+	/* Touch only the bytes inside the region, other data may share the pages */
+	for (page = start; page < end; page = page_start) {
+		*page       = *page;
+		page_start += page_size;
+	}
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_mem_lock (ppointer	mem,
+	    psize	n_bytes,
+	    PError	**error)
+{
+	if (P_UNLIKELY (pp_mem_check_region (&mem, &n_bytes, error) == FALSE))
+		return FALSE;
+
+#if defined (P_OS_WIN)
+	if (P_UNLIKELY (VirtualLock (mem, n_bytes) == 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call VirtualLock() to lock memory");
+		return FALSE;
+	}
+#elif defined (P_OS_BEOS) || defined (P_OS_OS2) || defined (P_OS_AMIGA)
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IO_NOT_IMPLEMENTED,
+			     0,
+			     "No memory locking implementation");
+	return FALSE;
+#else
+	if (P_UNLIKELY (mlock (mem, n_bytes) != 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call mlock() to lock memory");
+		return FALSE;
+	}
+#endif
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_mem_unlock (ppointer	mem,
+	      psize	n_bytes,
+	      PError	**error)
+{
+	if (P_UNLIKELY (pp_mem_check_region (&mem, &n_bytes, error) == FALSE))
+		return FALSE;
+
+#if defined (P_OS_WIN)
+	if (P_UNLIKELY (VirtualUnlock (mem, n_bytes) == 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call VirtualUnlock() to unlock memory");
+		return FALSE;
+	}
+#elif defined (P_OS_BEOS) || defined (P_OS_OS2) || defined (P_OS_AMIGA)
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IO_NOT_IMPLEMENTED,
+			     0,
+			     "No memory locking implementation");
+	return FALSE;
+#else
+	if (P_UNLIKELY (munlock (mem, n_bytes) != 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call munlock() to unlock memory");
+		return FALSE;
+	}
+#endif
+
+	return TRUE;
+}
+
+static pboolean
+pp_mem_numa_check_policy (PMemNumaPolicy	policy,
+			  pint			node,
+			  PError		**error)
+{
+	if (P_LIKELY (policy == P_MEM_NUMA_POLICY_DEFAULT || policy == P_MEM_NUMA_POLICY_INTERLEAVE))
+		return TRUE;
+
+	if (P_LIKELY (policy == P_MEM_NUMA_POLICY_NODE && node >= 0 && node < p_mem_numa_get_node_count ()))
+		return TRUE;
+
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+			     0,
+			     "Invalid memory policy");
+
+	return FALSE;
+}
+
+P_LIB_API pint
+p_mem_numa_get_node_count (void)
+{
+#if defined (P_OS_WIN)
+	ULONG highest_node;
+
+	if (P_UNLIKELY (GetNumaHighestNodeNumber (&highest_node) == 0))
+		return 1;
+
+	return highest_node >= P_MEM_NUMA_MAX_NODES ? P_MEM_NUMA_MAX_NODES : (pint) highest_node + 1;
+#elif defined (P_OS_LINUX)
+	FILE	*nodes_file;
+	pchar	line[256];
+	pchar	*cur;
+	pchar	*end;
+	long	node;
+	long	highest_node = 0;
+
+	/* The list looks like "0-3,6" */
+	if (P_UNLIKELY ((nodes_file = fopen ("/sys/devices/system/node/online", "r")) == NULL))
+		return 1;
+
+	if (fgets (line, sizeof (line), nodes_file) != NULL) {
+		for (cur = line; *cur != '\0'; cur = end) {
+			node = strtol (cur, &end, 10);
+
+			if (end == cur) {
+				++end;
+				continue;
+			}
+
+			if (node > highest_node)
+				highest_node = node;
+		}
+	}
+
+	fclose (nodes_file);
+
+	return highest_node >= P_MEM_NUMA_MAX_NODES ? P_MEM_NUMA_MAX_NODES : (pint) highest_node + 1;
+#else
+	return 1;
+#endif
+}
+
+P_LIB_API pint
+p_mem_numa_get_current_node (void)
+{
+#if defined (P_OS_WIN)
+	HMODULE					hmodule;
+	PMemGetCurrentProcessorNumberFunc	get_processor;
+	UCHAR					node;
+
+	if (P_UNLIKELY ((hmodule = GetModuleHandleA ("kernel32.dll")) == NULL))
+		return 0;
+
+	get_processor = (PMemGetCurrentProcessorNumberFunc) GetProcAddress (hmodule,
+									     "GetCurrentProcessorNumber");
+
+	if (get_processor == NULL || GetNumaProcessorNode ((UCHAR) get_processor (), &node) == 0)
+		return 0;
+
+	return node == 0xFF ? 0 : (pint) node;
+#elif defined (P_OS_LINUX) && defined (SYS_getcpu)
+	unsigned int cpu;
+	unsigned int node;
+
+	if (P_UNLIKELY (syscall (SYS_getcpu, &cpu, &node, NULL) != 0))
+		return 0;
+
+	return (pint) node;
+#else
+	return 0;
+#endif
+}
+
+P_LIB_API pboolean
+p_mem_numa_set_policy (ppointer		mem,
+		       psize		n_bytes,
+		       PMemNumaPolicy	policy,
+		       pint		node,
+		       PError		**error)
+{
+#if defined (P_OS_LINUX) && defined (SYS_mbind)
+	unsigned long	node_mask[P_MEM_NUMA_MAX_NODES / (8 * sizeof (unsigned long))];
+	unsigned long	*mask_ptr;
+	unsigned long	max_node;
+	pint		mode;
+	pint		node_count;
+	pint		i;
+#endif
+
+	if (P_UNLIKELY (mem == NULL || n_bytes == 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (pp_mem_numa_check_policy (policy, node, error) == FALSE))
+		return FALSE;
+
+#if defined (P_OS_LINUX) && defined (SYS_mbind)
+	memset (node_mask, 0, sizeof (node_mask));
+
+	/* Constants of the kernel memory policy API */
+	switch (policy) {
+	case P_MEM_NUMA_POLICY_NODE:
+		mode = 1;
+		node_mask[node / (8 * sizeof (unsigned long))] |= 1UL << (node % (8 * sizeof (unsigned long)));
+		break;
+	case P_MEM_NUMA_POLICY_INTERLEAVE:
+		mode       = 3;
+		node_count = p_mem_numa_get_node_count ();
+
+		for (i = 0; i < node_count; ++i)
+			node_mask[i / (8 * sizeof (unsigned long))] |= 1UL << (i % (8 * sizeof (unsigned long)));
+		break;
+	default:
+		mode = 0;
+		break;
+	}
+
+	mask_ptr = mode == 0 ? NULL : node_mask;
+	max_node = mode == 0 ? 0 : P_MEM_NUMA_MAX_NODES + 1;
+
+	if (P_UNLIKELY (syscall (SYS_mbind, mem, n_bytes, mode, mask_ptr, max_node, 0) != 0)) {
+		/* The kernel has no NUMA support or the policy is not allowed */
+		if (errno == ENOSYS || errno == EPERM)
+			return TRUE;
+
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call mbind() to set memory policy");
+		return FALSE;
+	}
+#else
+	P_UNUSED (node);
+#endif
+
+	return TRUE;
+}
+
+P_LIB_API ppointer
+p_mem_mmap_numa (psize		n_bytes,
+		 PMemNumaPolicy	policy,
+		 pint		node,
+		 PError		**error)
+{
+	ppointer addr;
+
+	if (P_UNLIKELY (n_bytes == 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return NULL;
+	}
+
+	if (P_UNLIKELY (pp_mem_numa_check_policy (policy, node, error) == FALSE))
+		return NULL;
+
+	addr = pp_mem_mmap_pages (n_bytes,
+				  FALSE,
+				  policy == P_MEM_NUMA_POLICY_NODE ? node : -1,
+				  error);
+
+	if (P_UNLIKELY (addr == NULL))
+		return NULL;
+
+	/* The pages are not touched yet, so they honor the policy */
+	if (P_UNLIKELY (p_mem_numa_set_policy (addr, n_bytes, policy, node, error) == FALSE)) {
+		p_mem_munmap (addr, n_bytes, NULL);
+		return NULL;
+	}
+
+	return addr;
+}
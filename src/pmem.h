@@ -47,6 +47,17 @@
  * p_libsys_init() then you must to restore the original allocator before
  * calling p_libsys_shutdown().
  *
+ * The table set with p_mem_set_vtable() is shared by the whole process. A
+ * thread can override it for itself with p_mem_push_thread_vtable(): all the
+ * p_malloc() family calls made by that thread, including the ones inside the
+ * library, go to the pushed table until p_mem_pop_thread_vtable() is called.
+ * The other threads are not affected.
+ *
+ * Use p_malloc_aligned() to get a block aligned to a cache line or to a SIMD
+ * register size, and p_free_aligned() to release it. By default aligned blocks
+ * are cut from the larger ones allocated through #PMemVTable, a dedicated
+ * aligned allocator can be provided with p_mem_set_aligned_vtable().
+ *
  * Use p_mem_mmap() to allocate system memory using memory mapping and
  * p_mem_munmap() to release the mapped memory. This type of allocated memory
  * is not backed physically (does not consume any physical storage) by operating
@@ -57,6 +68,38 @@
  * i.e. custom memory allocator can request a large block first, and then it
  * allocates chunks of memory within the block upon request.
  *
+ * Large mappings can use huge pages to reduce TLB pressure, see
+ * p_mem_mmap_full(). Explicit huge pages must be reserved by the system
+ * administrator, transparent huge pages are only a hint to the kernel.
+ *
+ * Mapped memory can be tuned at the page level: p_mem_advise() tells the system
+ * the expected access pattern or returns unused pages to it, p_mem_prefault()
+ * touches all the pages of a region in advance so the first access doesn't
+ * take page faults, and p_mem_lock() pins the pages into physical memory so
+ * they are never swapped out. These calls work on any memory, not only on the
+ * blocks from p_mem_mmap(), the regions are extended to the page boundaries.
+ *
+ * On NUMA systems the memory is placed on the node which touches it first. Use
+ * p_mem_mmap_numa() or p_mem_numa_set_policy() to place it on a given node or
+ * to interleave it across all the nodes, and p_mem_numa_get_current_node() to
+ * find the node of the calling thread. The policy is a hint: systems without
+ * NUMA support, or where the policy can't be changed, ignore it.
+ *
+ * A #PMemArena serves a lot of small allocations which are released all at
+ * once: it cuts them from large chunks with a bump pointer, and releases the
+ * chunks only in p_mem_arena_reset() or p_mem_arena_free(). An arena can also
+ * be installed as the memory management table with p_mem_arena_install() for a
+ * scope, so the library-internal allocations go there too.
+ *
+ * A library built with the PLIBSYS_MEM_STATS option counts the calls, the live
+ * and the peak bytes and the sizes of all the allocations made through
+ * p_malloc() and friends, see p_mem_stats_get(). The allocations made inside
+ * the library are attributed to the source modules of the library, the ones
+ * made by the application are counted separately, see p_mem_stats_get_module().
+ * A trace function set with p_mem_stats_set_trace_func() is called on every
+ * allocation. Without the option the statistics are not collected at all and
+ * take no time.
+ *
  * @note OS/2 supports non-backed memory pages allocation, but in a specific
  * way: an exception handler to control access to uncommitted pages must be
  * allocated on the stack of each thread before using the mapped memory. To
@@ -85,6 +128,100 @@ typedef struct PMemVTable_ {
 	void		(*free)		(ppointer	mem);		/**< free() implementation.	*/
 } PMemVTable;
 
+/** Aligned memory management table. */
+typedef struct PMemAlignedVTable_ {
+	ppointer	(*malloc_aligned)	(psize		n_bytes,
+						 psize		alignment);	/**< Aligned allocation.	*/
+	void		(*free_aligned)		(ppointer	mem);		/**< Aligned block release.	*/
+} PMemAlignedVTable;
+
+/**
+ * @brief Assumed size of the CPU cache line in bytes.
+ * @since 0.0.5
+ *
+ * Objects contended by several threads are aligned and padded to it to avoid
+ * false sharing. Same as #P_CACHE_LINE_SIZE.
+ */
+#define P_MEM_CACHE_LINE_SIZE	P_CACHE_LINE_SIZE
+
+/** Memory mapping flags for p_mem_mmap_full(). */
+typedef enum PMemMapFlags_ {
+	P_MEM_MAP_FLAG_NONE			= 0,		/**< Default pages.				*/
+	P_MEM_MAP_FLAG_HUGE_PAGES		= 1 << 0,	/**< Explicit huge pages: MAP_HUGETLB on Linux, large
+								     pages on Windows.				*/
+	P_MEM_MAP_FLAG_TRANSPARENT_HUGE_PAGES	= 1 << 1,	/**< Advise the kernel to back the default pages with
+								     transparent huge pages where supported.	*/
+	P_MEM_MAP_FLAG_FALLBACK			= 1 << 2	/**< Use the default pages if explicit huge pages
+								     can't be obtained.				*/
+} PMemMapFlags;
+
+/** Expected access pattern of a memory region. */
+typedef enum PMemAdvice_ {
+	P_MEM_ADVICE_NORMAL	= 0,	/**< No special treatment.				*/
+	P_MEM_ADVICE_SEQUENTIAL	= 1,	/**< Pages are accessed in order.			*/
+	P_MEM_ADVICE_RANDOM	= 2,	/**< Pages are accessed randomly.			*/
+	P_MEM_ADVICE_WILLNEED	= 3,	/**< Pages will be accessed soon.			*/
+	P_MEM_ADVICE_DONTNEED	= 4	/**< Pages won't be accessed soon, return them to
+					     the system.					*/
+} PMemAdvice;
+
+/** Maximum number of NUMA nodes supported. */
+#define P_MEM_NUMA_MAX_NODES	1024
+
+/** NUMA memory placement policy. */
+typedef enum PMemNumaPolicy_ {
+	P_MEM_NUMA_POLICY_DEFAULT	= 0,	/**< Node of the thread touching a page first.	*/
+	P_MEM_NUMA_POLICY_NODE		= 1,	/**< Preferred node, other nodes are used only
+						     if it runs out of memory.			*/
+	P_MEM_NUMA_POLICY_INTERLEAVE	= 2	/**< Pages interleaved across all the nodes.	*/
+} PMemNumaPolicy;
+
+/** Number of allocation size classes in #PMemStats. */
+#define P_MEM_STATS_SIZE_CLASSES	16
+
+/** Memory allocation statistics. */
+typedef struct PMemStats_ {
+	psize	alloc_calls;					/**< Number of allocations.		*/
+	psize	realloc_calls;					/**< Number of reallocations.		*/
+	psize	free_calls;					/**< Number of releases.		*/
+	psize	failed_calls;					/**< Number of failed allocations.	*/
+	psize	bytes_live;					/**< Currently allocated bytes.		*/
+	psize	bytes_peak;					/**< Maximum of allocated bytes.	*/
+	psize	size_classes[P_MEM_STATS_SIZE_CLASSES];	/**< Number of allocations by size:
+								     class @a i counts sizes up to
+								     16 << @a i bytes, the last one
+								     counts all the larger sizes.	*/
+} PMemStats;
+
+/** Memory trace event type. */
+typedef enum PMemTraceEvent_ {
+	P_MEM_TRACE_EVENT_ALLOC		= 0,	/**< Memory block was allocated.	*/
+	P_MEM_TRACE_EVENT_REALLOC	= 1,	/**< Memory block was reallocated.	*/
+	P_MEM_TRACE_EVENT_FREE		= 2	/**< Memory block was freed.		*/
+} PMemTraceEvent;
+
+/**
+ * @brief Memory trace function.
+ * @param event Event type.
+ * @param old_mem Previous address of a reallocated block, NULL otherwise.
+ * @param mem Address of the block, NULL if an allocation failed.
+ * @param n_bytes Size of the block, 0 for the freed one.
+ * @param module Name of the module which allocated the block.
+ * @param user_data Data passed to p_mem_stats_set_trace_func().
+ *
+ * Called inside the allocator, so it must not allocate memory with p_malloc()
+ * and friends itself.
+ */
+typedef void (*PMemTraceFunc) (PMemTraceEvent	event,
+			       pconstpointer	old_mem,
+			       pconstpointer	mem,
+			       psize		n_bytes,
+			       const pchar	*module,
+			       ppointer		user_data);
+
+/** Arena allocator opaque data structure. */
+typedef struct PMemArena_ PMemArena;
+
 /**
  * @brief Allocates a memory block for the specified number of bytes.
  * @param n_bytes Size of the memory block in bytes.
@@ -101,6 +238,9 @@ P_LIB_API ppointer	p_malloc		(psize			n_bytes);
  * @return Pointer to a newly allocated memory block filled with zeros in case
  * of success, NULL otherwise.
  * @since 0.0.1
+ *
+ * The system calloc() is used if available (see p_mem_set_calloc()), so large
+ * blocks are not cleared page by page.
  */
 P_LIB_API ppointer	p_malloc0		(psize			n_bytes);
 
@@ -128,6 +268,47 @@ P_LIB_API ppointer	p_realloc		(ppointer		mem,
  */
 P_LIB_API void		p_free			(ppointer		mem);
 
+/**
+ * @brief Allocates an aligned memory block.
+ * @param n_bytes Size of the memory block in bytes, rounded up to a multiple
+ * of @a alignment.
+ * @param alignment Alignment of the block in bytes, must be a power of two.
+ * @return Pointer to the aligned memory block in case of success, NULL
+ * otherwise.
+ * @since 0.0.5
+ *
+ * As the size is rounded up, no other block shares the first or the last
+ * @a alignment bytes with the returned one: use #P_MEM_CACHE_LINE_SIZE to give
+ * an object its own cache lines. Alignments less than the pointer size are
+ * raised to it.
+ *
+ * The block must be freed with p_free_aligned().
+ */
+P_LIB_API ppointer	p_malloc_aligned	(psize			n_bytes,
+						 psize			alignment);
+
+/**
+ * @brief Allocates an aligned memory block and fills it with zeros.
+ * @param n_bytes Size of the memory block in bytes, rounded up to a multiple
+ * of @a alignment.
+ * @param alignment Alignment of the block in bytes, must be a power of two.
+ * @return Pointer to the aligned memory block in case of success, NULL
+ * otherwise.
+ * @since 0.0.5
+ *
+ * The block must be freed with p_free_aligned().
+ */
+P_LIB_API ppointer	p_malloc0_aligned	(psize			n_bytes,
+						 psize			alignment);
+
+/**
+ * @brief Frees an aligned memory block.
+ * @param mem Pointer to the memory block obtained with p_malloc_aligned() or
+ * p_malloc0_aligned(), can be NULL.
+ * @since 0.0.5
+ */
+P_LIB_API void		p_free_aligned		(ppointer		mem);
+
 /**
  * @brief Sets custom memory management routines.
  * @param table Table of the memory routines to use.
@@ -144,15 +325,81 @@ P_LIB_API void		p_free			(ppointer		mem);
  */
 P_LIB_API pboolean	p_mem_set_vtable	(const PMemVTable	*table);
 
+/**
+ * @brief Sets the zeroed allocation routine matching the memory management
+ * table.
+ * @param calloc_func calloc() implementation to serve p_malloc0() with, NULL
+ * to fill the blocks from #PMemVTable with zeros instead.
+ * @note This call is not thread-safe.
+ * @since 0.0.5
+ *
+ * Large zeroed blocks straight from the system don't need clearing, so calloc()
+ * avoids touching every page of them. The blocks returned by @a calloc_func
+ * are released with the free() implementation of the current table, so both
+ * must belong to the same allocator. p_mem_set_vtable() resets the routine to
+ * NULL, call this function after it.
+ */
+P_LIB_API void		p_mem_set_calloc	(ppointer		(*calloc_func) (psize	n_blocks,
+											 psize	block_size));
+
 /**
  * @brief Restores system memory management routines.
  * @note This call is not thread-safe.
  * @since 0.0.1
  *
- * The following system routines are restored: malloc(), free(), realloc().
+ * The following system routines are restored: malloc(), free(), realloc() and
+ * calloc().
  */
 P_LIB_API void		p_mem_restore_vtable	(void);
 
+/**
+ * @brief Overrides the memory management routines for the calling thread.
+ * @param table Table of the memory routines to use, all members must be
+ * non-NULL.
+ * @return TRUE if the table was accepted, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The table is copied and takes precedence over the process-wide one (and over
+ * an installed #PMemArena) for the p_malloc() family calls of the calling
+ * thread only. Tables can be nested up to 8 levels deep, the last pushed one
+ * is used. p_malloc0() fills the blocks from @a table with zeros.
+ *
+ * Blocks must be released by the same table they were allocated with: don't
+ * pass the blocks allocated under the pushed table to other threads for
+ * releasing, and release them before the table is popped.
+ *
+ * Every pushed table must be popped with p_mem_pop_thread_vtable() before the
+ * thread exits. If the compiler has no thread-local storage support the call
+ * always fails.
+ */
+P_LIB_API pboolean	p_mem_push_thread_vtable	(const PMemVTable	*table);
+
+/**
+ * @brief Removes the last memory management table pushed for the calling
+ * thread.
+ * @return TRUE in case of success, FALSE if no table was pushed.
+ * @since 0.0.5
+ *
+ * The previously pushed table or, if there is none, the process-wide table is
+ * used by the thread again.
+ */
+P_LIB_API pboolean	p_mem_pop_thread_vtable		(void);
+
+/**
+ * @brief Sets the aligned memory management routines.
+ * @param table Table of the aligned memory routines to use, NULL to restore
+ * the default ones.
+ * @return TRUE if the table was successfully set, FALSE otherwise.
+ * @note This call is not thread-safe.
+ * @since 0.0.5
+ *
+ * The default routines over-allocate blocks through #PMemVTable, so they follow
+ * p_mem_set_vtable() automatically. All the aligned blocks must be freed with
+ * the same table they were allocated with. p_mem_restore_vtable() restores the
+ * default aligned routines as well.
+ */
+P_LIB_API pboolean	p_mem_set_aligned_vtable	(const PMemAlignedVTable	*table);
+
 /**
  * @brief Gets a memory mapped block from the system.
  * @param n_bytes Size of the memory block in bytes.
@@ -173,6 +420,34 @@ P_LIB_API void		p_mem_restore_vtable	(void);
 P_LIB_API ppointer	p_mem_mmap		(psize			n_bytes,
 						 PError			**error);
 
+/**
+ * @brief Gets a memory mapped block from the system with the given page size.
+ * @param n_bytes Size of the memory block in bytes.
+ * @param flags Mapping flags, a combination of #PMemMapFlags.
+ * @param[out] page_size Size of the pages the block was mapped with, NULL to
+ * ignore.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Pointer to the allocated memory block in case of success, NULL
+ * otherwise.
+ * @since 0.0.5
+ *
+ * With #P_MEM_MAP_FLAG_HUGE_PAGES the size is rounded up to a multiple of the
+ * huge page size, pass the rounded size to p_mem_munmap(). The call fails if
+ * the system doesn't support huge pages or has no free huge pages reserved,
+ * unless #P_MEM_MAP_FLAG_FALLBACK is given: then the block is mapped with the
+ * default pages, and @a page_size tells which ones were obtained.
+ *
+ * #P_MEM_MAP_FLAG_TRANSPARENT_HUGE_PAGES only advises the kernel for the
+ * default pages (madvise() with MADV_HUGEPAGE on Linux), it doesn't change
+ * the reported page size and never fails the call.
+ *
+ * With #P_MEM_MAP_FLAG_NONE the call is the same as p_mem_mmap().
+ */
+P_LIB_API ppointer	p_mem_mmap_full		(psize			n_bytes,
+						 pint			flags,
+						 psize			*page_size,
+						 PError			**error);
+
 /**
  * @brief Unmaps memory back to the system.
  * @param mem Pointer to a memory block previously allocated using the
@@ -186,6 +461,288 @@ P_LIB_API pboolean	p_mem_munmap		(ppointer		mem,
 						 psize			n_bytes,
 						 PError			**error);
 
+/**
+ * @brief Gives the system a hint about the expected use of a memory region.
+ * @param mem Starting address of the region.
+ * @param n_bytes Size of the region in bytes.
+ * @param advice Expected access pattern.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * Uses madvise() on UNIX systems. On Windows only #P_MEM_ADVICE_WILLNEED
+ * (through PrefetchVirtualMemory() since Windows 8) and #P_MEM_ADVICE_DONTNEED
+ * (by trimming the pages from the working set) are supported. The other hints
+ * and the other systems ignore the call and return TRUE.
+ *
+ * @warning On Linux the contents of private anonymous pages, like the ones
+ * from p_mem_mmap(), are dropped with #P_MEM_ADVICE_DONTNEED and read back as
+ * zeros, use it only for the regions which are not needed anymore.
+ */
+P_LIB_API pboolean	p_mem_advise		(ppointer		mem,
+						 psize			n_bytes,
+						 PMemAdvice		advice,
+						 PError			**error);
+
+/**
+ * @brief Commits all the pages of a memory region to physical memory.
+ * @param mem Starting address of the region, the memory must be writable.
+ * @param n_bytes Size of the region in bytes.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * Keeps the contents of the region. Uses MADV_POPULATE_WRITE on Linux when
+ * the kernel supports it, otherwise writes to each page of the region. Should
+ * not be called while other threads write to the same region.
+ */
+P_LIB_API pboolean	p_mem_prefault		(ppointer		mem,
+						 psize			n_bytes,
+						 PError			**error);
+
+/**
+ * @brief Locks the pages of a memory region in physical memory.
+ * @param mem Starting address of the region.
+ * @param n_bytes Size of the region in bytes.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * Locked pages are committed and never swapped out until they are unlocked
+ * with p_mem_unlock() or unmapped. Uses mlock() on UNIX systems and
+ * VirtualLock() on Windows, other systems fail with
+ * #P_ERROR_IO_NOT_IMPLEMENTED.
+ *
+ * The amount of locked memory is limited by the system: RLIMIT_MEMLOCK on UNIX
+ * systems and the minimum working set size on Windows.
+ */
+P_LIB_API pboolean	p_mem_lock		(ppointer		mem,
+						 psize			n_bytes,
+						 PError			**error);
+
+/**
+ * @brief Unlocks the pages of a memory region locked with p_mem_lock().
+ * @param mem Starting address of the region.
+ * @param n_bytes Size of the region in bytes.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_mem_unlock		(ppointer		mem,
+						 psize			n_bytes,
+						 PError			**error);
+
+/**
+ * @brief Gets a memory mapped block from the system placed on NUMA nodes.
+ * @param n_bytes Size of the memory block in bytes.
+ * @param policy Placement policy for the pages.
+ * @param node Node to place the pages on for #P_MEM_NUMA_POLICY_NODE, ignored
+ * otherwise.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Pointer to the allocated memory block in case of success, NULL
+ * otherwise.
+ * @since 0.0.5
+ *
+ * Release the block with p_mem_munmap(). Uses mbind() on Linux and
+ * MapViewOfFileExNuma() on Windows, Windows doesn't support
+ * #P_MEM_NUMA_POLICY_INTERLEAVE and uses the default placement for it.
+ */
+P_LIB_API ppointer	p_mem_mmap_numa		(psize			n_bytes,
+						 PMemNumaPolicy		policy,
+						 pint			node,
+						 PError			**error);
+
+/**
+ * @brief Sets the NUMA placement policy for the pages of a memory mapped block.
+ * @param mem Start of the block, must be aligned to the page size.
+ * @param n_bytes Size of the block in bytes.
+ * @param policy Placement policy for the pages.
+ * @param node Node to place the pages on for #P_MEM_NUMA_POLICY_NODE, ignored
+ * otherwise.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * Only the pages which are not touched yet are affected. Works for the blocks
+ * from p_mem_mmap() and p_mem_mmap_full() on Linux only, it does nothing on
+ * the other systems.
+ */
+P_LIB_API pboolean	p_mem_numa_set_policy	(ppointer		mem,
+						 psize			n_bytes,
+						 PMemNumaPolicy		policy,
+						 pint			node,
+						 PError			**error);
+
+/**
+ * @brief Gets the number of NUMA nodes.
+ * @return Number of NUMA nodes, 1 if the system has no NUMA support.
+ * @since 0.0.5
+ *
+ * Nodes are numbered from 0, the number includes the gaps between the online
+ * nodes if there are any.
+ */
+P_LIB_API pint		p_mem_numa_get_node_count	(void);
+
+/**
+ * @brief Gets the NUMA node of the CPU running the calling thread.
+ * @return NUMA node index, 0 if it can't be found out.
+ * @since 0.0.5
+ *
+ * The thread may be migrated to another node right after the call unless it's
+ * bound to the CPUs of a single node.
+ */
+P_LIB_API pint		p_mem_numa_get_current_node	(void);
+
+/**
+ * @brief Creates a new arena allocator.
+ * @param chunk_size Size of the memory chunks to allocate from, 0 to use the
+ * default one (64 KiB).
+ * @param use_mmap Whether to get the chunks with p_mem_mmap() instead of the
+ * current memory management table.
+ * @return Pointer to the newly created arena in case of success, NULL
+ * otherwise.
+ * @since 0.0.5
+ *
+ * No chunks are allocated until the first allocation. The arena is not
+ * thread-safe.
+ */
+P_LIB_API PMemArena *	p_mem_arena_new		(psize			chunk_size,
+						 pboolean		use_mmap);
+
+/**
+ * @brief Allocates a memory block from an arena.
+ * @param arena Arena to allocate from.
+ * @param n_bytes Size of the memory block in bytes.
+ * @return Pointer to the memory block in case of success, NULL otherwise.
+ * @since 0.0.5
+ *
+ * Blocks are aligned for any type and can't be freed one by one, all of them
+ * stay valid until p_mem_arena_reset() or p_mem_arena_free(). Blocks larger
+ * than a quarter of the chunk size get dedicated chunks.
+ */
+P_LIB_API ppointer	p_mem_arena_alloc	(PMemArena		*arena,
+						 psize			n_bytes);
+
+/**
+ * @brief Releases all the blocks of an arena at once.
+ * @param arena Arena to reset.
+ * @since 0.0.5
+ *
+ * Regular chunks are kept to be reused by the next allocations, the dedicated
+ * chunks of the large blocks are freed.
+ */
+P_LIB_API void		p_mem_arena_reset	(PMemArena		*arena);
+
+/**
+ * @brief Frees an arena along with all its blocks.
+ * @param arena Arena to free.
+ * @since 0.0.5
+ *
+ * An installed arena can't be freed, uninstall it first.
+ */
+P_LIB_API void		p_mem_arena_free	(PMemArena		*arena);
+
+/**
+ * @brief Makes an arena serve p_malloc() and friends.
+ * @param arena Arena to install.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @note This call is not thread-safe.
+ * @warning The blocks allocated while the arena is installed must not be used
+ * after it's reset or freed, and must not be freed with p_free() after it has
+ * been uninstalled.
+ * @since 0.0.5
+ *
+ * Replaces the memory management table until p_mem_arena_uninstall(), so all
+ * the allocations including the ones made inside the library (list nodes,
+ * error messages and so on) are cut from @a arena. That affects all the
+ * threads, so no other thread should allocate memory meanwhile.
+ *
+ * p_free() releases the space only if it was the last allocated block,
+ * p_free() and p_realloc() on the blocks allocated before the installation
+ * are passed to the previous table. Installations can be nested.
+ */
+P_LIB_API pboolean	p_mem_arena_install	(PMemArena		*arena);
+
+/**
+ * @brief Restores the memory management table replaced by an arena.
+ * @param arena Installed arena, the most recently installed one if several
+ * arenas are installed.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @note This call is not thread-safe.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_mem_arena_uninstall	(PMemArena		*arena);
+
+/**
+ * @brief Gets the memory allocation statistics of the whole process.
+ * @param[out] stats Statistics to fill in.
+ * @return TRUE in case of success, FALSE if the library was built without the
+ * PLIBSYS_MEM_STATS option.
+ * @since 0.0.5
+ *
+ * Counters are updated atomically but read one by one, so they may be slightly
+ * inconsistent while other threads allocate memory.
+ */
+P_LIB_API pboolean	p_mem_stats_get		(PMemStats		*stats);
+
+/**
+ * @brief Gets the number of modules in the memory allocation statistics.
+ * @return Number of modules, 0 if the library was built without the
+ * PLIBSYS_MEM_STATS option.
+ * @since 0.0.5
+ *
+ * Module 0 is the application itself, the library modules are added as they
+ * allocate memory for the first time.
+ */
+P_LIB_API pint		p_mem_stats_get_modules	(void);
+
+/**
+ * @brief Gets the memory allocation statistics of a single module.
+ * @param index Index of the module, less than p_mem_stats_get_modules().
+ * @param[out] stats Statistics to fill in.
+ * @return Module name (a source file name of the library, or "application"
+ * for the application itself) in case of success, NULL otherwise.
+ * @since 0.0.5
+ *
+ * A block is accounted to the module which allocated it, no matter which one
+ * reallocates or frees it.
+ */
+P_LIB_API const pchar *	p_mem_stats_get_module	(pint			index,
+						 PMemStats		*stats);
+
+/**
+ * @brief Resets the memory allocation statistics.
+ * @since 0.0.5
+ *
+ * Zeroes the call counters and the size classes, the peak bytes start from the
+ * currently allocated bytes. The allocated bytes are kept.
+ */
+P_LIB_API void		p_mem_stats_reset	(void);
+
+/**
+ * @brief Sets the memory trace function.
+ * @param func Trace function, NULL to disable tracing.
+ * @param user_data Data to pass to @a func.
+ * @return TRUE in case of success, FALSE if the library was built without the
+ * PLIBSYS_MEM_STATS option.
+ * @note This call is not thread-safe, set the function before other threads
+ * start to allocate memory.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_mem_stats_set_trace_func	(PMemTraceFunc	func,
+							 ppointer	user_data);
+
+#if defined (PLIBSYS_COMPILATION) && defined (PLIBSYS_MEM_STATS)
+/* Allocations inside the library are attributed to the source files */
+ppointer	p_mem_stats_malloc	(psize n_bytes, const pchar *module);
+ppointer	p_mem_stats_malloc0	(psize n_bytes, const pchar *module);
+ppointer	p_mem_stats_realloc	(ppointer mem, psize n_bytes, const pchar *module);
+
+#  define p_malloc(n_bytes)		p_mem_stats_malloc (n_bytes, __FILE__)
+#  define p_malloc0(n_bytes)		p_mem_stats_malloc0 (n_bytes, __FILE__)
+#  define p_realloc(mem, n_bytes)	p_mem_stats_realloc (mem, n_bytes, __FILE__)
+#endif
+
 P_END_DECLS
 
 #endif /* PLIBSYS_HEADER_PMEM_H */
@@ -0,0 +1,507 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Magazine allocator: a thread pops and pushes the objects of its loaded
+ * magazine, swaps it with the previous one when it runs empty or full, and
+ * exchanges a magazine with the depot only when both are exhausted. The depot
+ * keeps full and empty magazines, released objects which didn't fit into any
+ * magazine and the slabs.
+ *
+ * Every thread cache holds a reference to the pool, so the destructor of an
+ * exiting thread can still lock the pool after p_mem_pool_free(). The freed
+ * pool has no magazines anymore, the destructor only drops the reference. */
+
+#include "pmem.h"
+#include "pmempool.h"
+#include "pmutex.h"
+#include "puthread.h"
+
+#include <string.h>
+
+#define P_MEM_POOL_MAGAZINE_SIZE	32
+#define P_MEM_POOL_SLAB_SIZE		(32 * 1024)
+#define P_MEM_POOL_MIN_SLAB_OBJECTS	(P_MEM_POOL_MAGAZINE_SIZE * 2)
+
+/* Slabs start with a link to the previous one, padded to keep the objects
+ * aligned the same way as the slab itself */
+#define P_MEM_POOL_SLAB_HEADER		(2 * sizeof (ppointer))
+
+typedef struct PMemPoolMagazine_ {
+	struct PMemPoolMagazine_	*next;
+	pint				count;
+	ppointer			objects[P_MEM_POOL_MAGAZINE_SIZE];
+} PMemPoolMagazine;
+
+typedef struct PMemPoolCache_ {
+	struct PMemPoolCache_	*next;
+	struct PMemPoolCache_	*prev;
+	PMemPool		*pool;
+	PMemPoolMagazine	*loaded;
+	PMemPoolMagazine	*previous;
+} PMemPoolCache;
+
+struct PMemPool_ {
+	PMutex			*mutex;
+	PUThreadStaticKey	*cache_key;
+	PMemPoolCache		*caches;
+	PMemPoolMagazine	*full_magazines;
+	PMemPoolMagazine	*empty_magazines;
+	ppointer		free_objects;
+	ppointer		slabs;
+	pchar			*slab_cursor;
+	pchar			*slab_end;
+	psize			object_size;
+	psize			slab_objects;
+	pint			ref_count;
+	pboolean		is_freed;
+};
+
+static void pp_mem_pool_destroy (PMemPool *pool);
+static void pp_mem_pool_unref (PMemPool *pool);
+static void pp_mem_pool_cache_free (ppointer data);
+static PMemPoolCache * pp_mem_pool_get_cache (PMemPool *pool);
+static void pp_mem_pool_put_magazine (PMemPool *pool, PMemPoolMagazine *magazine);
+static ppointer pp_mem_pool_take_object (PMemPool *pool);
+static void pp_mem_pool_put_object (PMemPool *pool, ppointer mem);
+
+static void
+pp_mem_pool_destroy (PMemPool *pool)
+{
+	p_mutex_free (pool->mutex);
+	p_free (pool);
+}
+
+/* Called with the pool locked, the last reference unlocks and destroys it */
+static void
+pp_mem_pool_unref (PMemPool *pool)
+{
+	if (--pool->ref_count == 0) {
+		p_mutex_unlock (pool->mutex);
+		pp_mem_pool_destroy (pool);
+	} else
+		p_mutex_unlock (pool->mutex);
+}
+
+static void
+pp_mem_pool_cache_free (ppointer data)
+{
+	PMemPoolCache	*cache;
+	PMemPool	*pool;
+
+	cache = (PMemPoolCache *) data;
+	pool  = cache->pool;
+
+	p_mutex_lock (pool->mutex);
+
+	if (pool->is_freed == FALSE) {
+		pp_mem_pool_put_magazine (pool, cache->loaded);
+		pp_mem_pool_put_magazine (pool, cache->previous);
+
+		if (cache->prev != NULL)
+			cache->prev->next = cache->next;
+		else
+			pool->caches = cache->next;
+
+		if (cache->next != NULL)
+			cache->next->prev = cache->prev;
+	}
+
+	p_free (cache);
+
+	pp_mem_pool_unref (pool);
+}
+
+static PMemPoolCache *
+pp_mem_pool_get_cache (PMemPool *pool)
+{
+	PMemPoolCache *cache;
+
+	cache = (PMemPoolCache *) p_uthread_get_static_local (pool->cache_key);
+
+	if (P_LIKELY (cache != NULL))
+		return cache;
+
+	if (P_UNLIKELY ((cache = p_malloc0 (sizeof (PMemPoolCache))) == NULL))
+		return NULL;
+
+	cache->loaded   = p_malloc0 (sizeof (PMemPoolMagazine));
+	cache->previous = p_malloc0 (sizeof (PMemPoolMagazine));
+
+	if (P_UNLIKELY (cache->loaded == NULL || cache->previous == NULL)) {
+		p_free (cache->loaded);
+		p_free (cache->previous);
+		p_free (cache);
+		return NULL;
+	}
+
+	cache->pool = pool;
+
+	p_mutex_lock (pool->mutex);
+
+	cache->next = pool->caches;
+
+	if (pool->caches != NULL)
+		pool->caches->prev = cache;
+
+	pool->caches = cache;
+	++pool->ref_count;
+
+	p_mutex_unlock (pool->mutex);
+
+	p_uthread_set_static_local (pool->cache_key, cache);
+
+	return cache;
+}
+
+/* Called with the pool locked */
+static void
+pp_mem_pool_put_magazine (PMemPool *pool, PMemPoolMagazine *magazine)
+{
+	if (magazine->count > 0) {
+		magazine->next       = pool->full_magazines;
+		pool->full_magazines = magazine;
+	} else {
+		magazine->next        = pool->empty_magazines;
+		pool->empty_magazines = magazine;
+	}
+}
+
+/* Called with the pool locked */
+static ppointer
+pp_mem_pool_take_object (PMemPool *pool)
+{
+	ppointer	ret;
+	pchar		*slab;
+
+	if (pool->free_objects != NULL) {
+		ret                = pool->free_objects;
+		pool->free_objects = *((ppointer *) ret);
+
+		return ret;
+	}
+
+	if (pool->slab_cursor == pool->slab_end) {
+		if (P_UNLIKELY ((slab = p_malloc (P_MEM_POOL_SLAB_HEADER +
+						  pool->slab_objects * pool->object_size)) == NULL))
+			return NULL;
+
+		*((ppointer *) slab) = pool->slabs;
+
+		pool->slabs       = slab;
+		pool->slab_cursor = slab + P_MEM_POOL_SLAB_HEADER;
+		pool->slab_end    = pool->slab_cursor + pool->slab_objects * pool->object_size;
+	}
+
+	ret                = pool->slab_cursor;
+	pool->slab_cursor += pool->object_size;
+
+	return ret;
+}
+
+/* Called with the pool locked */
+static void
+pp_mem_pool_put_object (PMemPool *pool, ppointer mem)
+{
+	*((ppointer *) mem) = pool->free_objects;
+	pool->free_objects  = mem;
+}
+
+P_LIB_API PMemPool *
+p_mem_pool_new (psize object_size)
+{
+	PMemPool *ret;
+
+	if (P_UNLIKELY (object_size == 0 || object_size > P_MAXSIZE / P_MEM_POOL_MIN_SLAB_OBJECTS))
+		return NULL;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PMemPool))) == NULL)) {
+		P_ERROR ("PMemPool::p_mem_pool_new: failed to allocate memory");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret->mutex = p_mutex_new ()) == NULL)) {
+		P_ERROR ("PMemPool::p_mem_pool_new: failed to allocate mutex");
+		p_free (ret);
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret->cache_key = p_uthread_static_local_new (pp_mem_pool_cache_free)) == NULL)) {
+		P_ERROR ("PMemPool::p_mem_pool_new: failed to allocate TLS key");
+		p_mutex_free (ret->mutex);
+		p_free (ret);
+		return NULL;
+	}
+
+	/* Free objects are linked through their first pointer */
+	ret->object_size  = (object_size + sizeof (ppointer) - 1) & ~(sizeof (ppointer) - 1);
+	ret->slab_objects = P_MEM_POOL_SLAB_SIZE / ret->object_size;
+	ret->ref_count    = 1;
+
+	if (ret->slab_objects < P_MEM_POOL_MIN_SLAB_OBJECTS)
+		ret->slab_objects = P_MEM_POOL_MIN_SLAB_OBJECTS;
+
+	return ret;
+}
+
+P_LIB_API ppointer
+p_mem_pool_alloc (PMemPool *pool)
+{
+	PMemPoolCache		*cache;
+	PMemPoolMagazine	*magazine;
+	ppointer		ret;
+
+	if (P_UNLIKELY (pool == NULL))
+		return NULL;
+
+	if (P_UNLIKELY ((cache = pp_mem_pool_get_cache (pool)) == NULL)) {
+		p_mutex_lock (pool->mutex);
+		ret = pp_mem_pool_take_object (pool);
+		p_mutex_unlock (pool->mutex);
+
+		return ret;
+	}
+
+	if (P_LIKELY (cache->loaded->count > 0))
+		return cache->loaded->objects[--cache->loaded->count];
+
+	if (cache->previous->count > 0) {
+		magazine        = cache->loaded;
+		cache->loaded   = cache->previous;
+		cache->previous = magazine;
+
+		return cache->loaded->objects[--cache->loaded->count];
+	}
+
+	/* Both magazines are empty: trade one for a full magazine from the depot
+	 * or fill the loaded one right away */
+	p_mutex_lock (pool->mutex);
+
+	if (pool->full_magazines != NULL) {
+		magazine             = pool->full_magazines;
+		pool->full_magazines = magazine->next;
+
+		pp_mem_pool_put_magazine (pool, cache->previous);
+
+		cache->previous = cache->loaded;
+		cache->loaded   = magazine;
+	} else {
+		magazine = cache->loaded;
+
+		while (magazine->count < P_MEM_POOL_MAGAZINE_SIZE) {
+			if (P_UNLIKELY ((ret = pp_mem_pool_take_object (pool)) == NULL))
+				break;
+
+			magazine->objects[magazine->count++] = ret;
+		}
+	}
+
+	p_mutex_unlock (pool->mutex);
+
+	if (P_UNLIKELY (cache->loaded->count == 0))
+		return NULL;
+
+	return cache->loaded->objects[--cache->loaded->count];
+}
+
+P_LIB_API ppointer
+p_mem_pool_alloc0 (PMemPool *pool)
+{
+	ppointer ret;
+
+	if (P_UNLIKELY ((ret = p_mem_pool_alloc (pool)) == NULL))
+		return NULL;
+
+	memset (ret, 0, pool->object_size);
+
+	return ret;
+}
+
+P_LIB_API void
+p_mem_pool_release (PMemPool	*pool,
+		    ppointer	mem)
+{
+	PMemPoolCache		*cache;
+	PMemPoolMagazine	*magazine;
+
+	if (P_UNLIKELY (pool == NULL || mem == NULL))
+		return;
+
+	if (P_UNLIKELY ((cache = pp_mem_pool_get_cache (pool)) == NULL)) {
+		p_mutex_lock (pool->mutex);
+		pp_mem_pool_put_object (pool, mem);
+		p_mutex_unlock (pool->mutex);
+
+		return;
+	}
+
+	if (P_LIKELY (cache->loaded->count < P_MEM_POOL_MAGAZINE_SIZE)) {
+		cache->loaded->objects[cache->loaded->count++] = mem;
+		return;
+	}
+
+	if (cache->previous->count == 0) {
+		magazine        = cache->loaded;
+		cache->loaded   = cache->previous;
+		cache->previous = magazine;
+
+		cache->loaded->objects[cache->loaded->count++] = mem;
+		return;
+	}
+
+	/* Both magazines are full: hand one over to the depot and continue with
+	 * an empty one */
+	p_mutex_lock (pool->mutex);
+
+	if ((magazine = pool->empty_magazines) != NULL)
+		pool->empty_magazines = magazine->next;
+	else {
+		p_mutex_unlock (pool->mutex);
+
+		magazine = p_malloc0 (sizeof (PMemPoolMagazine));
+
+		p_mutex_lock (pool->mutex);
+
+		if (P_UNLIKELY (magazine == NULL)) {
+			pp_mem_pool_put_object (pool, mem);
+			p_mutex_unlock (pool->mutex);
+
+			return;
+		}
+	}
+
+	pp_mem_pool_put_magazine (pool, cache->previous);
+
+	p_mutex_unlock (pool->mutex);
+
+	magazine->count = 0;
+
+	cache->previous = cache->loaded;
+	cache->loaded   = magazine;
+
+	cache->loaded->objects[cache->loaded->count++] = mem;
+}
+
+P_LIB_API psize
+p_mem_pool_get_used_count (PMemPool *pool)
+{
+	PMemPoolCache		*cache;
+	PMemPoolMagazine	*magazine;
+	ppointer		slab;
+	ppointer		object;
+	psize			ret;
+
+	if (P_UNLIKELY (pool == NULL))
+		return 0;
+
+	p_mutex_lock (pool->mutex);
+
+	/* Objects cut from the slabs, the newest one may be cut only in part */
+	ret = 0;
+
+	for (slab = pool->slabs; slab != NULL; slab = *((ppointer *) slab))
+		ret += pool->slab_objects;
+
+	if (pool->slabs != NULL)
+		ret -= (psize) (pool->slab_end - pool->slab_cursor) / pool->object_size;
+
+	/* Minus the ones waiting for reuse */
+	for (object = pool->free_objects; object != NULL; object = *((ppointer *) object))
+		--ret;
+
+	for (magazine = pool->full_magazines; magazine != NULL; magazine = magazine->next)
+		ret -= (psize) magazine->count;
+
+	for (cache = pool->caches; cache != NULL; cache = cache->next)
+		ret -= (psize) (cache->loaded->count + cache->previous->count);
+
+	p_mutex_unlock (pool->mutex);
+
+	return ret;
+}
+
+P_LIB_API void
+p_mem_pool_free (PMemPool *pool)
+{
+	PMemPoolCache		*cache;
+	PMemPoolCache		*own_cache;
+	PMemPoolMagazine	*magazine;
+	ppointer		slab;
+
+	if (P_UNLIKELY (pool == NULL))
+		return;
+
+	own_cache = (PMemPoolCache *) p_uthread_get_static_local (pool->cache_key);
+
+	if (own_cache != NULL)
+		p_uthread_set_static_local (pool->cache_key, NULL);
+
+	p_uthread_static_local_free (pool->cache_key);
+
+	p_mutex_lock (pool->mutex);
+
+	pool->is_freed = TRUE;
+
+	/* Caches of the other threads stay until they exit */
+	for (cache = pool->caches; cache != NULL; cache = cache->next) {
+		p_free (cache->loaded);
+		p_free (cache->previous);
+
+		cache->loaded   = NULL;
+		cache->previous = NULL;
+	}
+
+	if (own_cache != NULL) {
+		p_free (own_cache);
+		--pool->ref_count;
+	}
+
+	while (pool->full_magazines != NULL) {
+		magazine             = pool->full_magazines;
+		pool->full_magazines = magazine->next;
+
+		p_free (magazine);
+	}
+
+	while (pool->empty_magazines != NULL) {
+		magazine              = pool->empty_magazines;
+		pool->empty_magazines = magazine->next;
+
+		p_free (magazine);
+	}
+
+	while (pool->slabs != NULL) {
+		slab        = pool->slabs;
+		pool->slabs = *((ppointer *) slab);
+
+		p_free (slab);
+	}
+
+	pool->caches       = NULL;
+	pool->free_objects = NULL;
+	pool->slab_cursor  = NULL;
+	pool->slab_end     = NULL;
+
+	pp_mem_pool_unref (pool);
+}
@@ -0,0 +1,134 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pmempool.h
+ * @brief Fixed-size object pool
+ * @author Alexander Saprykin
+ *
+ * A memory pool serves the objects of a single size fixed at creation, like
+ * list items, tree nodes or socket addresses. Objects are cut from large slabs
+ * and never returned to the system until the pool is freed, released objects
+ * are reused by the next allocations instead.
+ *
+ * A pool is thread-safe and most of the time takes no lock: every thread keeps
+ * a small cache of two magazines (arrays of free objects) in its TLS slot, and
+ * allocations and releases only pop and push the objects there. A shared depot
+ * guarded by a mutex is visited only when both magazines of a thread run empty
+ * (to take a full magazine) or full (to hand one over), i.e. once per dozens of
+ * operations. An object can be released by any thread, not only by the one
+ * which allocated it.
+ *
+ * The cache of an exiting thread is returned to the depot automatically. Each
+ * pool takes a TLS key which is never returned to the system, so pools are
+ * meant to be long-living objects: create a few pools per object type rather
+ * than a pool per container.
+ *
+ * Use p_mem_pool_alloc() or p_mem_pool_alloc0() instead of p_malloc() and
+ * p_malloc0(), and p_mem_pool_release() instead of p_free(). The slabs are
+ * allocated with p_malloc(), so a pool can be combined with a custom memory
+ * management table.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PMEMPOOL_H
+#define PLIBSYS_HEADER_PMEMPOOL_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+
+P_BEGIN_DECLS
+
+/** Memory pool opaque data structure. */
+typedef struct PMemPool_ PMemPool;
+
+/**
+ * @brief Creates a new memory pool.
+ * @param object_size Size of the objects in bytes, rounded up to a multiple of
+ * the pointer size.
+ * @return Pointer to the newly created pool in case of success, NULL otherwise.
+ * @since 0.0.5
+ *
+ * No slabs are allocated until the first allocation.
+ */
+P_LIB_API PMemPool *	p_mem_pool_new		(psize		object_size);
+
+/**
+ * @brief Allocates an object from a pool.
+ * @param pool Pool to allocate from.
+ * @return Pointer to the object in case of success, NULL otherwise.
+ * @since 0.0.5
+ *
+ * Contents of the object are undefined, objects are aligned at least to the
+ * pointer size.
+ */
+P_LIB_API ppointer	p_mem_pool_alloc	(PMemPool	*pool);
+
+/**
+ * @brief Allocates an object from a pool and fills it with zeros.
+ * @param pool Pool to allocate from.
+ * @return Pointer to the object in case of success, NULL otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API ppointer	p_mem_pool_alloc0	(PMemPool	*pool);
+
+/**
+ * @brief Returns an object to a pool.
+ * @param pool Pool the object was allocated from.
+ * @param mem Object to release, can be NULL.
+ * @since 0.0.5
+ */
+P_LIB_API void		p_mem_pool_release	(PMemPool	*pool,
+						 ppointer	mem);
+
+/**
+ * @brief Gets the number of objects allocated from a pool and not released.
+ * @param pool Pool to get the number for.
+ * @return Number of the objects in use, 0 in case of error.
+ * @since 0.0.5
+ *
+ * The call locks the depot and walks the caches of all the threads, it is
+ * meant for the diagnostics and the shutdown rather than for the hot path.
+ * The result is exact only if no other thread uses the pool at the same time.
+ */
+P_LIB_API psize		p_mem_pool_get_used_count (PMemPool	*pool);
+
+/**
+ * @brief Frees a pool along with all its objects.
+ * @param pool Pool to free.
+ * @since 0.0.5
+ *
+ * All the objects become invalid, no other thread may use the pool at the
+ * same time. Caches of the threads which are still running are released when
+ * they exit.
+ */
+P_LIB_API void		p_mem_pool_free		(PMemPool	*pool);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PMEMPOOL_H */
@@ -0,0 +1,488 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* The registry is a list guarded by a mutex, it is touched only to register,
+ * unregister and iterate the metrics. The values live in the metrics
+ * themselves and are updated without the registry. */
+
+#include "patomic.h"
+#include "pcounter.h"
+#include "pmem.h"
+#include "pmetrics.h"
+#include "pmutex.h"
+#include "ponce.h"
+#include "pstring.h"
+#include "ptrace.h"
+
+#include <string.h>
+
+struct PMetric_ {
+	struct PMetric_	*next;
+	pchar		*name;
+	pchar		*labels;
+	pchar		*help;
+	PMetricType	type;
+	pint		ref_count;
+	PCounter	*counter;
+	volatile pint64	gauge;
+	PHistogram	*histogram;
+	PMetricReadFunc	read_func;
+	ppointer	read_data;
+};
+
+static POnce	pp_metrics_once  = P_ONCE_INIT;
+static PMutex	*pp_metrics_mutex = NULL;
+static PMetric	*pp_metrics_head  = NULL;
+static PMetric	*pp_metrics_tail  = NULL;
+
+static PMetric * pp_metrics_find (const pchar *name, const pchar *labels);
+static PMetric * pp_metrics_new (const pchar *name, const pchar *labels, const pchar *help, PMetricType type);
+static void pp_metrics_free (PMetric *metric);
+static PMetric * pp_metrics_register (const pchar *name, const pchar *labels, const pchar *help,
+				      PMetricType type, puint64 max_value, pint significant_digits,
+				      PMetricReadFunc func, ppointer user_data);
+static pint64 pp_metrics_read (const PMetric *metric);
+static void pp_metrics_register_builtin (void);
+static void pp_metrics_init (ppointer data);
+
+/* Must be called with the registry locked */
+static PMetric *
+pp_metrics_find (const pchar	*name,
+		 const pchar	*labels)
+{
+	PMetric *metric;
+
+	for (metric = pp_metrics_head; metric != NULL; metric = metric->next) {
+		if (strcmp (metric->name, name) == 0 && strcmp (metric->labels, labels) == 0)
+			return metric;
+	}
+
+	return NULL;
+}
+
+static PMetric *
+pp_metrics_new (const pchar	*name,
+		const pchar	*labels,
+		const pchar	*help,
+		PMetricType	type)
+{
+	PMetric *ret;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PMetric))) == NULL))
+		return NULL;
+
+	ret->name      = p_strdup (name);
+	ret->labels    = p_strdup (labels);
+	ret->help      = p_strdup (help);
+	ret->type      = type;
+	ret->ref_count = 1;
+
+	if (P_UNLIKELY (ret->name == NULL || ret->labels == NULL || ret->help == NULL)) {
+		pp_metrics_free (ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+static void
+pp_metrics_free (PMetric *metric)
+{
+	if (metric->counter != NULL)
+		p_counter_free (metric->counter);
+
+	if (metric->histogram != NULL)
+		p_histogram_free (metric->histogram);
+
+	p_free (metric->name);
+	p_free (metric->labels);
+	p_free (metric->help);
+	p_free (metric);
+}
+
+static PMetric *
+pp_metrics_register (const pchar	*name,
+		     const pchar	*labels,
+		     const pchar	*help,
+		     PMetricType	type,
+		     puint64		max_value,
+		     pint		significant_digits,
+		     PMetricReadFunc	func,
+		     ppointer		user_data)
+{
+	PMetric *ret;
+
+	if (P_UNLIKELY (name == NULL || *name == '\0' || pp_metrics_mutex == NULL))
+		return NULL;
+
+	if (labels == NULL)
+		labels = "";
+
+	if (help == NULL)
+		help = "";
+
+	p_mutex_lock (pp_metrics_mutex);
+
+	if ((ret = pp_metrics_find (name, labels)) != NULL) {
+		/* Callbacks can't be shared, nobody would know which one is called */
+		if (ret->type != type || ret->read_func != NULL || func != NULL)
+			ret = NULL;
+		else
+			++ret->ref_count;
+
+		p_mutex_unlock (pp_metrics_mutex);
+
+		return ret;
+	}
+
+	if (P_UNLIKELY ((ret = pp_metrics_new (name, labels, help, type)) == NULL)) {
+		p_mutex_unlock (pp_metrics_mutex);
+		P_ERROR ("PMetrics::pp_metrics_register: failed to allocate memory");
+		return NULL;
+	}
+
+	if (func != NULL) {
+		ret->read_func = func;
+		ret->read_data = user_data;
+	} else if (type == P_METRIC_TYPE_COUNTER)
+		ret->counter = p_counter_new (0);
+	else if (type == P_METRIC_TYPE_HISTOGRAM)
+		ret->histogram = p_histogram_new (max_value, significant_digits, TRUE);
+
+	if (P_UNLIKELY ((type == P_METRIC_TYPE_COUNTER && func == NULL && ret->counter == NULL) ||
+			(type == P_METRIC_TYPE_HISTOGRAM && ret->histogram == NULL))) {
+		p_mutex_unlock (pp_metrics_mutex);
+		pp_metrics_free (ret);
+		return NULL;
+	}
+
+	if (pp_metrics_tail != NULL)
+		pp_metrics_tail->next = ret;
+	else
+		pp_metrics_head = ret;
+
+	pp_metrics_tail = ret;
+
+	p_mutex_unlock (pp_metrics_mutex);
+
+	return ret;
+}
+
+static pint64
+pp_metrics_read (const PMetric *metric)
+{
+	if (metric->read_func != NULL)
+		return metric->read_func (metric->read_data);
+
+	switch (metric->type) {
+	case P_METRIC_TYPE_COUNTER:
+		return p_counter_get (metric->counter);
+	case P_METRIC_TYPE_GAUGE:
+		return p_atomic_int64_get_explicit (&metric->gauge, P_ATOMIC_MEMORY_ORDER_RELAXED);
+	case P_METRIC_TYPE_HISTOGRAM:
+		return (pint64) p_histogram_get_count (metric->histogram);
+	default:
+		return 0;
+	}
+}
+
+#ifdef PLIBSYS_MEM_STATS
+static pint64 pp_metrics_read_mem_stat (ppointer user_data);
+
+static pint64
+pp_metrics_read_mem_stat (ppointer user_data)
+{
+	PMemStats stats;
+
+	if (P_UNLIKELY (p_mem_stats_get (&stats) == FALSE))
+		return 0;
+
+	/* The offset of the field is passed as the user data */
+	return (pint64) *((const psize *) ((const pchar *) &stats + PPOINTER_TO_PSIZE (user_data)));
+}
+#endif
+
+#ifdef PLIBSYS_TRACE
+static pint64 pp_metrics_read_trace_dropped (ppointer user_data);
+
+static pint64
+pp_metrics_read_trace_dropped (ppointer user_data)
+{
+	P_UNUSED (user_data);
+
+	return (pint64) p_trace_get_dropped ();
+}
+#endif
+
+static void
+pp_metrics_register_builtin (void)
+{
+#ifdef PLIBSYS_MEM_STATS
+	pp_metrics_register ("plibsys_mem_alloc_calls", NULL, "Number of memory allocations",
+			     P_METRIC_TYPE_COUNTER, 0, 0, pp_metrics_read_mem_stat,
+			     PSIZE_TO_POINTER (offsetof (PMemStats, alloc_calls)));
+	pp_metrics_register ("plibsys_mem_realloc_calls", NULL, "Number of memory reallocations",
+			     P_METRIC_TYPE_COUNTER, 0, 0, pp_metrics_read_mem_stat,
+			     PSIZE_TO_POINTER (offsetof (PMemStats, realloc_calls)));
+	pp_metrics_register ("plibsys_mem_free_calls", NULL, "Number of memory releases",
+			     P_METRIC_TYPE_COUNTER, 0, 0, pp_metrics_read_mem_stat,
+			     PSIZE_TO_POINTER (offsetof (PMemStats, free_calls)));
+	pp_metrics_register ("plibsys_mem_failed_calls", NULL, "Number of failed memory allocations",
+			     P_METRIC_TYPE_COUNTER, 0, 0, pp_metrics_read_mem_stat,
+			     PSIZE_TO_POINTER (offsetof (PMemStats, failed_calls)));
+	pp_metrics_register ("plibsys_mem_bytes_live", NULL, "Currently allocated bytes",
+			     P_METRIC_TYPE_GAUGE, 0, 0, pp_metrics_read_mem_stat,
+			     PSIZE_TO_POINTER (offsetof (PMemStats, bytes_live)));
+	pp_metrics_register ("plibsys_mem_bytes_peak", NULL, "Maximum of allocated bytes",
+			     P_METRIC_TYPE_GAUGE, 0, 0, pp_metrics_read_mem_stat,
+			     PSIZE_TO_POINTER (offsetof (PMemStats, bytes_peak)));
+#endif
+
+#ifdef PLIBSYS_TRACE
+	pp_metrics_register ("plibsys_trace_dropped_records", NULL, "Number of dropped trace records",
+			     P_METRIC_TYPE_COUNTER, 0, 0, pp_metrics_read_trace_dropped, NULL);
+#endif
+}
+
+static void
+pp_metrics_init (ppointer data)
+{
+	P_UNUSED (data);
+
+	if (P_UNLIKELY ((pp_metrics_mutex = p_mutex_new ()) == NULL)) {
+		P_ERROR ("PMetrics::pp_metrics_init: failed to create mutex");
+		return;
+	}
+
+	pp_metrics_register_builtin ();
+}
+
+void
+p_metrics_shutdown (void)
+{
+	PMetric *metric;
+	PMetric *next;
+
+	/* Let the next library initialization start over */
+	pp_metrics_once = P_ONCE_INIT;
+
+	if (P_UNLIKELY (pp_metrics_mutex == NULL))
+		return;
+
+	for (metric = pp_metrics_head; metric != NULL; metric = next) {
+		next = metric->next;
+		pp_metrics_free (metric);
+	}
+
+	pp_metrics_head = NULL;
+	pp_metrics_tail = NULL;
+
+	p_mutex_free (pp_metrics_mutex);
+	pp_metrics_mutex = NULL;
+}
+
+P_LIB_API PMetric *
+p_metrics_register_counter (const pchar	*name,
+			    const pchar	*labels,
+			    const pchar	*help)
+{
+	p_once (&pp_metrics_once, pp_metrics_init, NULL);
+
+	return pp_metrics_register (name, labels, help, P_METRIC_TYPE_COUNTER, 0, 0, NULL, NULL);
+}
+
+P_LIB_API PMetric *
+p_metrics_register_gauge (const pchar	*name,
+			  const pchar	*labels,
+			  const pchar	*help)
+{
+	p_once (&pp_metrics_once, pp_metrics_init, NULL);
+
+	return pp_metrics_register (name, labels, help, P_METRIC_TYPE_GAUGE, 0, 0, NULL, NULL);
+}
+
+P_LIB_API PMetric *
+p_metrics_register_histogram (const pchar	*name,
+			      const pchar	*labels,
+			      const pchar	*help,
+			      puint64		max_value,
+			      pint		significant_digits)
+{
+	p_once (&pp_metrics_once, pp_metrics_init, NULL);
+
+	return pp_metrics_register (name,
+				    labels,
+				    help,
+				    P_METRIC_TYPE_HISTOGRAM,
+				    max_value,
+				    significant_digits,
+				    NULL,
+				    NULL);
+}
+
+P_LIB_API PMetric *
+p_metrics_register_func (const pchar		*name,
+			 const pchar		*labels,
+			 const pchar		*help,
+			 PMetricType		type,
+			 PMetricReadFunc	func,
+			 ppointer		user_data)
+{
+	if (P_UNLIKELY (func == NULL || (type != P_METRIC_TYPE_COUNTER && type != P_METRIC_TYPE_GAUGE)))
+		return NULL;
+
+	p_once (&pp_metrics_once, pp_metrics_init, NULL);
+
+	return pp_metrics_register (name, labels, help, type, 0, 0, func, user_data);
+}
+
+P_LIB_API void
+p_metrics_unregister (PMetric *metric)
+{
+	PMetric **link;
+	PMetric *prev;
+
+	if (P_UNLIKELY (metric == NULL || pp_metrics_mutex == NULL))
+		return;
+
+	p_mutex_lock (pp_metrics_mutex);
+
+	if (--metric->ref_count > 0) {
+		p_mutex_unlock (pp_metrics_mutex);
+		return;
+	}
+
+	for (prev = NULL, link = &pp_metrics_head; *link != NULL; prev = *link, link = &(*link)->next) {
+		if (*link == metric) {
+			*link = metric->next;
+
+			if (pp_metrics_tail == metric)
+				pp_metrics_tail = prev;
+
+			break;
+		}
+	}
+
+	p_mutex_unlock (pp_metrics_mutex);
+
+	pp_metrics_free (metric);
+}
+
+P_LIB_API void
+p_metrics_add (PMetric	*metric,
+	       pint64	value)
+{
+	if (P_UNLIKELY (metric == NULL || metric->read_func != NULL))
+		return;
+
+	if (metric->type == P_METRIC_TYPE_COUNTER)
+		p_counter_add (metric->counter, value);
+	else if (metric->type == P_METRIC_TYPE_GAUGE)
+		p_atomic_int64_add_explicit (&metric->gauge, value, P_ATOMIC_MEMORY_ORDER_RELAXED);
+}
+
+P_LIB_API void
+p_metrics_inc (PMetric *metric)
+{
+	p_metrics_add (metric, 1);
+}
+
+P_LIB_API void
+p_metrics_set (PMetric	*metric,
+	       pint64	value)
+{
+	if (P_UNLIKELY (metric == NULL || metric->type != P_METRIC_TYPE_GAUGE || metric->read_func != NULL))
+		return;
+
+	p_atomic_int64_set_explicit (&metric->gauge, value, P_ATOMIC_MEMORY_ORDER_RELAXED);
+}
+
+P_LIB_API void
+p_metrics_record (PMetric	*metric,
+		  puint64	value)
+{
+	if (P_UNLIKELY (metric == NULL || metric->type != P_METRIC_TYPE_HISTOGRAM))
+		return;
+
+	p_histogram_record (metric->histogram, value);
+}
+
+P_LIB_API pint64
+p_metrics_get_value (const PMetric *metric)
+{
+	if (P_UNLIKELY (metric == NULL))
+		return 0;
+
+	return pp_metrics_read (metric);
+}
+
+P_LIB_API PHistogram *
+p_metrics_get_histogram (const PMetric *metric)
+{
+	if (P_UNLIKELY (metric == NULL))
+		return NULL;
+
+	return metric->histogram;
+}
+
+P_LIB_API pint
+p_metrics_foreach (PMetricsFunc	func,
+		   ppointer	user_data)
+{
+	PMetricSample	sample;
+	PMetric		*metric;
+	pint		ret;
+
+	if (P_UNLIKELY (func == NULL))
+		return 0;
+
+	/* Built-in metrics are reported even if nothing has been registered */
+	p_once (&pp_metrics_once, pp_metrics_init, NULL);
+
+	if (P_UNLIKELY (pp_metrics_mutex == NULL))
+		return 0;
+
+	ret = 0;
+
+	p_mutex_lock (pp_metrics_mutex);
+
+	for (metric = pp_metrics_head; metric != NULL; metric = metric->next) {
+		sample.name      = metric->name;
+		sample.labels    = metric->labels;
+		sample.help      = metric->help;
+		sample.type      = metric->type;
+		sample.value     = pp_metrics_read (metric);
+		sample.histogram = metric->histogram;
+
+		++ret;
+
+		if (func (&sample, user_data) == FALSE)
+			break;
+	}
+
+	p_mutex_unlock (pp_metrics_mutex);
+
+	return ret;
+}
@@ -0,0 +1,269 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pmetrics.h
+ * @brief Metrics registry
+ * @author Alexander Saprykin
+ *
+ * The metrics registry collects the named counters, gauges and histograms of
+ * an application and of the library itself in one place, so an exporter can
+ * read all of them with p_metrics_foreach() without knowing where they come
+ * from.
+ *
+ * A metric is identified by its name and an optional label string, i.e.
+ * "method=get,code=200": metrics with the same name and different labels are
+ * different series of the same quantity. Registering an existing name and
+ * labels pair again returns the same metric, so independent parts of the code
+ * can share it. Each registration must be balanced with
+ * p_metrics_unregister(). The remaining metrics are freed by
+ * p_libsys_shutdown().
+ *
+ * The metric types are:
+ * - #P_METRIC_TYPE_COUNTER: a value which only grows, i.e. the number of
+ * handled requests. It is a #PCounter inside, so it scales with many threads
+ * updating it.
+ * - #P_METRIC_TYPE_GAUGE: a value which goes up and down, i.e. the number of
+ * open connections.
+ * - #P_METRIC_TYPE_HISTOGRAM: a distribution of values, i.e. latencies in
+ * nanoseconds, recorded into a concurrent #PHistogram.
+ *
+ * Counters and gauges can also be read through a callback when the value is
+ * already kept elsewhere: such metrics cost nothing until they are read. The
+ * library registers its own statistics this way under the "plibsys_" prefix,
+ * i.e. the memory statistics when built with the PLIBSYS_MEM_STATS option.
+ *
+ * Updating a metric doesn't touch the registry: it is a single atomic
+ * operation on the metric itself.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PMETRICS_H
+#define PLIBSYS_HEADER_PMETRICS_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+#include "phistogram.h"
+
+P_BEGIN_DECLS
+
+/** Metric opaque data type. */
+typedef struct PMetric_ PMetric;
+
+/** Metric type. */
+typedef enum PMetricType_ {
+	P_METRIC_TYPE_COUNTER	= 0,	/**< Growing value.		*/
+	P_METRIC_TYPE_GAUGE	= 1,	/**< Arbitrary value.		*/
+	P_METRIC_TYPE_HISTOGRAM	= 2	/**< Distribution of values.	*/
+} PMetricType;
+
+/** Metric value as passed to p_metrics_foreach(). */
+typedef struct PMetricSample_ {
+	const pchar		*name;		/**< Metric name.				*/
+	const pchar		*labels;	/**< Labels, empty string if not set.		*/
+	const pchar		*help;		/**< Description, empty string if not set.	*/
+	PMetricType		type;		/**< Metric type.				*/
+	pint64			value;		/**< Counter or gauge value, number of the
+						     recorded values for a histogram.		*/
+	const PHistogram	*histogram;	/**< Histogram to query, NULL for the other
+						     types.					*/
+} PMetricSample;
+
+/**
+ * @brief Callback reading the value of a metric.
+ * @param user_data Data passed to p_metrics_register_func().
+ * @return Current value of the metric.
+ * @since 0.0.5
+ *
+ * It is called with the registry locked and must not call the registry.
+ */
+typedef pint64 (*PMetricReadFunc) (ppointer user_data);
+
+/**
+ * @brief Callback receiving the metrics from p_metrics_foreach().
+ * @param sample Metric value, valid only during the call.
+ * @param user_data Data passed to p_metrics_foreach().
+ * @return TRUE to continue the iteration, FALSE to stop it.
+ * @since 0.0.5
+ *
+ * It is called with the registry locked and must not call the registry.
+ */
+typedef pboolean (*PMetricsFunc) (const PMetricSample *sample, ppointer user_data);
+
+/**
+ * @brief Registers a counter.
+ * @param name Metric name.
+ * @param labels Metric labels, NULL if not needed.
+ * @param help Metric description, NULL if not needed.
+ * @return Pointer to #PMetric in case of success, NULL if a metric of another
+ * type is registered with the same @a name and @a labels or in case of error.
+ * @since 0.0.5
+ *
+ * The strings are copied. The counter starts from zero.
+ */
+P_LIB_API PMetric *	p_metrics_register_counter	(const pchar		*name,
+							 const pchar		*labels,
+							 const pchar		*help);
+
+/**
+ * @brief Registers a gauge.
+ * @param name Metric name.
+ * @param labels Metric labels, NULL if not needed.
+ * @param help Metric description, NULL if not needed.
+ * @return Pointer to #PMetric in case of success, NULL if a metric of another
+ * type is registered with the same @a name and @a labels or in case of error.
+ * @since 0.0.5
+ *
+ * The strings are copied. The gauge starts from zero.
+ */
+P_LIB_API PMetric *	p_metrics_register_gauge	(const pchar		*name,
+							 const pchar		*labels,
+							 const pchar		*help);
+
+/**
+ * @brief Registers a histogram.
+ * @param name Metric name.
+ * @param labels Metric labels, NULL if not needed.
+ * @param help Metric description, NULL if not needed.
+ * @param max_value Maximum value to record, see p_histogram_new().
+ * @param significant_digits Precision, see p_histogram_new().
+ * @return Pointer to #PMetric in case of success, NULL if a metric of another
+ * type is registered with the same @a name and @a labels or in case of error.
+ * @since 0.0.5
+ *
+ * The strings are copied. If the histogram is already registered, the
+ * existing one is returned with its original maximum and precision.
+ */
+P_LIB_API PMetric *	p_metrics_register_histogram	(const pchar		*name,
+							 const pchar		*labels,
+							 const pchar		*help,
+							 puint64		max_value,
+							 pint			significant_digits);
+
+/**
+ * @brief Registers a counter or a gauge read through a callback.
+ * @param name Metric name.
+ * @param labels Metric labels, NULL if not needed.
+ * @param help Metric description, NULL if not needed.
+ * @param type #P_METRIC_TYPE_COUNTER or #P_METRIC_TYPE_GAUGE.
+ * @param func Callback to read the value with.
+ * @param user_data Data to pass to @a func.
+ * @return Pointer to #PMetric in case of success, NULL if the name and labels
+ * pair is already registered or in case of error.
+ * @since 0.0.5
+ *
+ * The strings are copied. The metric can't be updated with p_metrics_add()
+ * and p_metrics_set(), @a func is called each time the value is read.
+ */
+P_LIB_API PMetric *	p_metrics_register_func		(const pchar		*name,
+							 const pchar		*labels,
+							 const pchar		*help,
+							 PMetricType		type,
+							 PMetricReadFunc	func,
+							 ppointer		user_data);
+
+/**
+ * @brief Drops a registration of a metric.
+ * @param metric #PMetric to unregister.
+ * @since 0.0.5
+ *
+ * The metric is removed and freed when all its registrations are dropped.
+ */
+P_LIB_API void		p_metrics_unregister		(PMetric		*metric);
+
+/**
+ * @brief Adds a value to a counter or a gauge.
+ * @param metric #PMetric to add the value to.
+ * @param value Value to add, must not be negative for a counter.
+ * @since 0.0.5
+ */
+P_LIB_API void		p_metrics_add			(PMetric		*metric,
+							 pint64			value);
+
+/**
+ * @brief Increments a counter or a gauge by 1.
+ * @param metric #PMetric to increment.
+ * @since 0.0.5
+ */
+P_LIB_API void		p_metrics_inc			(PMetric		*metric);
+
+/**
+ * @brief Sets the value of a gauge.
+ * @param metric #PMetric to set the value for.
+ * @param value Value to set.
+ * @since 0.0.5
+ */
+P_LIB_API void		p_metrics_set			(PMetric		*metric,
+							 pint64			value);
+
+/**
+ * @brief Records a value in a histogram.
+ * @param metric #PMetric to record the value in.
+ * @param value Value to record.
+ * @since 0.0.5
+ */
+P_LIB_API void		p_metrics_record		(PMetric		*metric,
+							 puint64		value);
+
+/**
+ * @brief Gets the value of a metric.
+ * @param metric #PMetric to get the value for.
+ * @return Counter or gauge value, number of the recorded values for a
+ * histogram.
+ * @since 0.0.5
+ */
+P_LIB_API pint64	p_metrics_get_value		(const PMetric		*metric);
+
+/**
+ * @brief Gets the histogram of a metric.
+ * @param metric #PMetric to get the histogram for.
+ * @return Histogram of the metric, NULL if it is not a histogram.
+ * @since 0.0.5
+ *
+ * The histogram belongs to the metric, it can be queried and reset but not
+ * freed.
+ */
+P_LIB_API PHistogram *	p_metrics_get_histogram		(const PMetric		*metric);
+
+/**
+ * @brief Calls a function for every registered metric.
+ * @param func Function to call.
+ * @param user_data Data to pass to @a func.
+ * @return Number of metrics passed to @a func.
+ * @since 0.0.5
+ *
+ * The metrics are passed in the order of registration. The registry is locked
+ * during the call, so no metric is registered or removed meanwhile, while the
+ * values keep being updated.
+ */
+P_LIB_API pint		p_metrics_foreach		(PMetricsFunc		func,
+							 ppointer		user_data);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PMETRICS_H */
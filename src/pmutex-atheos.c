@@ -25,6 +25,7 @@
 
 #include "pmem.h"
 #include "pmutex.h"
+#include "plockstats-private.h"
 
 #include <stdlib.h>
 #include <errno.h>
@@ -35,8 +36,11 @@ typedef sem_id mutex_hdl;
 
 struct PMutex_ {
 	mutex_hdl	hdl;
+	P_LOCK_STATS_FIELD
 };
 
+P_LOCK_STATS_DEFINE_GETTER (PMutex, p_mutex_get_lock_stats)
+
 P_LIB_API PMutex *
 p_mutex_new (void)
 {
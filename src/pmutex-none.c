@@ -24,13 +24,17 @@
  */
 
 #include "pmutex.h"
+#include "plockstats-private.h"
 
 #include <stdlib.h>
 
 struct PMutex_ {
 	pint	hdl;
+	P_LOCK_STATS_FIELD
 };
 
+P_LOCK_STATS_DEFINE_GETTER (PMutex, p_mutex_get_lock_stats)
+
 P_LIB_API PMutex *
 p_mutex_new (void)
 {
@@ -25,6 +25,7 @@
 
 #include "pmem.h"
 #include "pmutex.h"
+#include "plockstats-private.h"
 
 #include <stdlib.h>
 #include "pthread.h"
@@ -33,8 +34,11 @@ typedef pthread_mutex_t mutex_hdl;
 
 struct PMutex_ {
 	mutex_hdl	hdl;
+	P_LOCK_STATS_FIELD
 };
 
+P_LOCK_STATS_DEFINE_GETTER (PMutex, p_mutex_get_lock_stats)
+
 P_LIB_API PMutex *
 p_mutex_new (void)
 {
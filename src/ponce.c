@@ -0,0 +1,89 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "patomic.h"
+#include "ponce.h"
+#include "puthread.h"
+
+#define P_ONCE_STATE_NONE	0
+#define P_ONCE_STATE_RUNNING	1
+#define P_ONCE_STATE_DONE	2
+
+P_LIB_API pboolean
+p_once_init_enter (POnce *once)
+{
+	if (P_UNLIKELY (once == NULL))
+		return FALSE;
+
+	if (P_LIKELY (p_atomic_int_get_explicit (once, P_ATOMIC_MEMORY_ORDER_ACQUIRE) == P_ONCE_STATE_DONE))
+		return FALSE;
+
+	if (p_atomic_int_compare_and_exchange_explicit (once,
+							P_ONCE_STATE_NONE,
+							P_ONCE_STATE_RUNNING,
+							P_ATOMIC_MEMORY_ORDER_ACQUIRE) == TRUE)
+		return TRUE;
+
+	/* Initialization routines are short, yielding is enough here and
+	 * doesn't depend on other subsystems being initialized */
+	while (p_atomic_int_get_explicit (once, P_ATOMIC_MEMORY_ORDER_ACQUIRE) != P_ONCE_STATE_DONE)
+		p_uthread_yield ();
+
+	return FALSE;
+}
+
+P_LIB_API void
+p_once_init_leave (POnce *once)
+{
+	if (P_UNLIKELY (once == NULL))
+		return;
+
+	p_atomic_int_set_explicit (once, P_ONCE_STATE_DONE, P_ATOMIC_MEMORY_ORDER_RELEASE);
+}
+
+P_LIB_API void
+p_once (POnce		*once,
+	POnceFunc	func,
+	ppointer	user_data)
+{
+	if (P_UNLIKELY (once == NULL || func == NULL))
+		return;
+
+	if (p_once_init_enter (once) == FALSE)
+		return;
+
+	func (user_data);
+
+	p_once_init_leave (once);
+}
+
+P_LIB_API pboolean
+p_once_is_done (const POnce *once)
+{
+	if (P_UNLIKELY (once == NULL))
+		return FALSE;
+
+	return p_atomic_int_get_explicit (once, P_ATOMIC_MEMORY_ORDER_ACQUIRE) == P_ONCE_STATE_DONE;
+}
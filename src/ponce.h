@@ -0,0 +1,127 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file ponce.h
+ * @brief One-time initialization
+ * @author Alexander Saprykin
+ *
+ * A once flag guarantees that an initialization routine runs exactly one time
+ * even if several threads reach it at once: the first thread runs the routine
+ * while all the others wait until it completes. Later calls return almost
+ * immediately, the check is a single atomic load.
+ *
+ * A #POnce flag must be statically initialized with #P_ONCE_INIT, no explicit
+ * creation or freeing is required, and it can be used before p_libsys_init()
+ * is called. Use p_once() to run a routine, or a pair of p_once_init_enter()
+ * and p_once_init_leave() calls to wrap an initialization code inline:
+ * @code
+ * static POnce init_once = P_ONCE_INIT;
+ *
+ * if (p_once_init_enter (&init_once)) {
+ *         ... initialization code ...
+ *         p_once_init_leave (&init_once);
+ * }
+ * @endcode
+ *
+ * The library itself initializes its optional subsystems this way on first
+ * use rather than in p_libsys_init().
+ *
+ * Waiting threads yield the CPU in a loop, so an initialization routine should
+ * be short. It must not use the same once flag, that would be a deadlock.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PONCE_H
+#define PLIBSYS_HEADER_PONCE_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+
+P_BEGIN_DECLS
+
+/** Once flag, must be initialized with #P_ONCE_INIT. */
+typedef pint POnce;
+
+/** Static initializer for #POnce. */
+#define P_ONCE_INIT	0
+
+/**
+ * @brief Initialization routine for p_once().
+ * @param user_data Data passed to p_once().
+ * @since 0.0.5
+ */
+typedef void (*POnceFunc) (ppointer user_data);
+
+/**
+ * @brief Starts a one-time initialization section.
+ * @param once Once flag.
+ * @return TRUE if the caller must run the initialization and then call
+ * p_once_init_leave(), FALSE if the initialization has already completed.
+ * @since 0.0.5
+ *
+ * If another thread is running the initialization at the moment, the call
+ * waits for it to complete and returns FALSE.
+ */
+P_LIB_API pboolean	p_once_init_enter	(POnce		*once);
+
+/**
+ * @brief Completes a one-time initialization section.
+ * @param once Once flag for which p_once_init_enter() returned TRUE.
+ * @since 0.0.5
+ *
+ * All the memory writes made by the initialization are visible to the threads
+ * which pass p_once_init_enter() afterwards.
+ */
+P_LIB_API void		p_once_init_leave	(POnce		*once);
+
+/**
+ * @brief Runs a routine exactly one time for a given once flag.
+ * @param once Once flag.
+ * @param func Routine to run.
+ * @param user_data Data to pass to @a func.
+ * @since 0.0.5
+ *
+ * The call returns only after @a func has completed, whichever thread has run
+ * it.
+ */
+P_LIB_API void		p_once			(POnce		*once,
+						 POnceFunc	func,
+						 ppointer	user_data);
+
+/**
+ * @brief Checks whether a one-time initialization has completed.
+ * @param once Once flag.
+ * @return TRUE if the initialization has completed, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_once_is_done		(const POnce	*once);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PONCE_H */
@@ -0,0 +1,284 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "pmem.h"
+#include "ponce.h"
+#include "pparallel.h"
+#include "ptaskscheduler.h"
+#include "puthread.h"
+
+#include <string.h>
+
+#define P_PARALLEL_CHUNKS_PER_THREAD	8
+#define P_PARALLEL_STACK_RESULT		64
+
+typedef struct PParallelContext_ {
+	PTaskScheduler		*scheduler;
+	psize			grain;
+	PParallelForFunc	for_func;
+	PParallelReduceFunc	reduce_func;
+	PParallelJoinFunc	join_func;
+	pconstpointer		identity;
+	psize			result_size;
+	ppointer		data;
+} PParallelContext;
+
+typedef struct PParallelRange_ {
+	PParallelContext	*ctx;
+	psize			begin;
+	psize			end;
+	ppointer		result;
+} PParallelRange;
+
+typedef union PParallelResult_ {
+	pchar			bytes[P_PARALLEL_STACK_RESULT];
+	puint64			u64;
+	pdouble			d;
+	ppointer		p;
+} PParallelResult;
+
+static POnce		pp_parallel_once      = P_ONCE_INIT;
+static PTaskScheduler	*pp_parallel_scheduler = NULL;
+
+static void pp_parallel_init (ppointer data);
+static PTaskScheduler * pp_parallel_get_scheduler (void);
+static psize pp_parallel_get_grain (PTaskScheduler *scheduler, psize count, psize grain);
+static void pp_parallel_for_range (PParallelContext *ctx, psize begin, psize end);
+static void pp_parallel_for_task (ppointer data);
+static void pp_parallel_reduce_range (PParallelContext *ctx, psize begin, psize end, ppointer result);
+static void pp_parallel_reduce_task (ppointer data);
+
+static void
+pp_parallel_init (ppointer data)
+{
+	pint n_threads = p_uthread_ideal_count ();
+
+	P_UNUSED (data);
+
+	/* The calling thread works while syncing, so one worker less is enough */
+	if (n_threads > 1)
+		pp_parallel_scheduler = p_task_scheduler_new (n_threads - 1);
+}
+
+static PTaskScheduler *
+pp_parallel_get_scheduler (void)
+{
+	p_once (&pp_parallel_once, pp_parallel_init, NULL);
+
+	return pp_parallel_scheduler;
+}
+
+static psize
+pp_parallel_get_grain (PTaskScheduler	*scheduler,
+		       psize		count,
+		       psize		grain)
+{
+	psize n_threads;
+
+	if (grain > 0)
+		return grain;
+
+	n_threads = (psize) p_task_scheduler_get_worker_count (scheduler) + 1;
+	grain     = count / (n_threads * P_PARALLEL_CHUNKS_PER_THREAD);
+
+	return grain > 0 ? grain : 1;
+}
+
+/* The right half is spawned and the left one is run in place, so the stack
+ * depth is logarithmic */
+static void
+pp_parallel_for_range (PParallelContext	*ctx,
+		       psize		begin,
+		       psize		end)
+{
+	PParallelRange	right;
+	PTaskGroup	group;
+
+	if (end - begin <= ctx->grain) {
+		ctx->for_func (begin, end, ctx->data);
+		return;
+	}
+
+	right.ctx    = ctx;
+	right.begin  = begin + (end - begin) / 2;
+	right.end    = end;
+	right.result = NULL;
+
+	p_task_group_init (&group, ctx->scheduler);
+	p_task_group_spawn (&group, pp_parallel_for_task, &right);
+
+	pp_parallel_for_range (ctx, begin, right.begin);
+
+	p_task_group_sync (&group);
+}
+
+static void
+pp_parallel_for_task (ppointer data)
+{
+	PParallelRange *range = (PParallelRange *) data;
+
+	pp_parallel_for_range (range->ctx, range->begin, range->end);
+}
+
+static void
+pp_parallel_reduce_range (PParallelContext	*ctx,
+			  psize			begin,
+			  psize			end,
+			  ppointer		result)
+{
+	PParallelRange	right;
+	PParallelResult	stack_result;
+	PTaskGroup	group;
+
+	if (end - begin <= ctx->grain) {
+		ctx->reduce_func (begin, end, result, ctx->data);
+		return;
+	}
+
+	if (ctx->result_size <= sizeof (stack_result))
+		right.result = &stack_result;
+	else if (P_UNLIKELY ((right.result = p_malloc (ctx->result_size)) == NULL)) {
+		ctx->reduce_func (begin, end, result, ctx->data);
+		return;
+	}
+
+	memcpy (right.result, ctx->identity, ctx->result_size);
+
+	right.ctx   = ctx;
+	right.begin = begin + (end - begin) / 2;
+	right.end   = end;
+
+	p_task_group_init (&group, ctx->scheduler);
+	p_task_group_spawn (&group, pp_parallel_reduce_task, &right);
+
+	pp_parallel_reduce_range (ctx, begin, right.begin, result);
+
+	p_task_group_sync (&group);
+
+	ctx->join_func (result, right.result, ctx->data);
+
+	if (right.result != (ppointer) &stack_result)
+		p_free (right.result);
+}
+
+static void
+pp_parallel_reduce_task (ppointer data)
+{
+	PParallelRange *range = (PParallelRange *) data;
+
+	pp_parallel_reduce_range (range->ctx, range->begin, range->end, range->result);
+}
+
+void
+p_parallel_shutdown (void)
+{
+	/* Let the next library initialization start over */
+	pp_parallel_once = P_ONCE_INIT;
+
+	if (pp_parallel_scheduler != NULL) {
+		p_task_scheduler_free (pp_parallel_scheduler);
+		pp_parallel_scheduler = NULL;
+	}
+}
+
+P_LIB_API pboolean
+p_parallel_for (psize			begin,
+		psize			end,
+		psize			grain,
+		PParallelForFunc	func,
+		ppointer		data)
+{
+	PParallelContext	ctx;
+	PTaskScheduler		*scheduler;
+
+	if (P_UNLIKELY (func == NULL || begin > end))
+		return FALSE;
+
+	if (begin == end)
+		return TRUE;
+
+	scheduler = pp_parallel_get_scheduler ();
+
+	if (scheduler == NULL || end - begin <= grain) {
+		func (begin, end, data);
+		return TRUE;
+	}
+
+	memset (&ctx, 0, sizeof (ctx));
+
+	ctx.scheduler = scheduler;
+	ctx.grain     = pp_parallel_get_grain (scheduler, end - begin, grain);
+	ctx.for_func  = func;
+	ctx.data      = data;
+
+	pp_parallel_for_range (&ctx, begin, end);
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_parallel_reduce (psize		begin,
+		   psize		end,
+		   psize		grain,
+		   PParallelReduceFunc	func,
+		   PParallelJoinFunc	join,
+		   pconstpointer	identity,
+		   psize		result_size,
+		   ppointer		result,
+		   ppointer		data)
+{
+	PParallelContext	ctx;
+	PTaskScheduler		*scheduler;
+
+	if (P_UNLIKELY (func == NULL || join == NULL || identity == NULL ||
+			result_size == 0 || result == NULL || begin > end))
+		return FALSE;
+
+	memcpy (result, identity, result_size);
+
+	if (begin == end)
+		return TRUE;
+
+	scheduler = pp_parallel_get_scheduler ();
+
+	if (scheduler == NULL || end - begin <= grain) {
+		func (begin, end, result, data);
+		return TRUE;
+	}
+
+	memset (&ctx, 0, sizeof (ctx));
+
+	ctx.scheduler   = scheduler;
+	ctx.grain       = pp_parallel_get_grain (scheduler, end - begin, grain);
+	ctx.reduce_func = func;
+	ctx.join_func   = join;
+	ctx.identity    = identity;
+	ctx.result_size = result_size;
+	ctx.data        = data;
+
+	pp_parallel_reduce_range (&ctx, begin, end, result);
+
+	return TRUE;
+}
@@ -0,0 +1,149 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pparallel.h
+ * @brief Parallel loops
+ * @author Alexander Saprykin
+ *
+ * Parallel loops split an index range into chunks and run them on the
+ * workers of a shared #PTaskScheduler, which saves hand-splitting data
+ * parallel work (hashing chunks, scanning arrays) across threads.
+ *
+ * p_parallel_for() calls a function on the disjoint subranges covering
+ * [begin, end). p_parallel_reduce() additionally folds each subrange into its
+ * own copy of the result, initialized from an identity value, and joins the
+ * results pairwise. The joins keep the order of the subranges, so the join
+ * function has to be associative but not necessarily commutative.
+ *
+ * The range is split in halves recursively until a part is not larger than
+ * the grain, and the halves are spawned into the scheduler, so idle workers
+ * steal the large parts first. A zero grain is chosen automatically to make
+ * several chunks per thread. The calling thread takes part in the work and
+ * returns when the whole range is done. The loops can be nested.
+ *
+ * The shared scheduler is started on the first use with one worker less than
+ * p_uthread_ideal_count() and stopped by p_libsys_shutdown(). On a single-core
+ * system no scheduler is started and the function is called once with the
+ * whole range, the same happens if the range doesn't exceed the grain.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PPARALLEL_H
+#define PLIBSYS_HEADER_PPARALLEL_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+
+P_BEGIN_DECLS
+
+/**
+ * @brief Body of a parallel loop.
+ * @param begin First index of the subrange.
+ * @param end Index past the last one of the subrange.
+ * @param data Data passed to p_parallel_for().
+ */
+typedef void (*PParallelForFunc) (psize		begin,
+				  psize		end,
+				  ppointer	data);
+
+/**
+ * @brief Body of a parallel reduction.
+ * @param begin First index of the subrange.
+ * @param end Index past the last one of the subrange.
+ * @param result Result to fold the subrange into.
+ * @param data Data passed to p_parallel_reduce().
+ */
+typedef void (*PParallelReduceFunc) (psize	begin,
+				     psize	end,
+				     ppointer	result,
+				     ppointer	data);
+
+/**
+ * @brief Joins the results of two adjacent subranges.
+ * @param result Result of the left subrange to join into.
+ * @param other Result of the right subrange.
+ * @param data Data passed to p_parallel_reduce().
+ */
+typedef void (*PParallelJoinFunc) (ppointer		result,
+				   pconstpointer	other,
+				   ppointer		data);
+
+/**
+ * @brief Runs a loop over an index range in parallel.
+ * @param begin First index of the range.
+ * @param end Index past the last one of the range.
+ * @param grain Largest subrange to run without splitting, 0 to choose it
+ * automatically.
+ * @param func Function to call on the subranges.
+ * @param data Pointer to pass into @a func, may be NULL.
+ * @return TRUE in case of success, FALSE in case of invalid input.
+ * @since 0.0.5
+ *
+ * @a func is called concurrently on disjoint subranges covering the whole
+ * range, in no particular order.
+ */
+P_LIB_API pboolean	p_parallel_for		(psize			begin,
+						 psize			end,
+						 psize			grain,
+						 PParallelForFunc	func,
+						 ppointer		data);
+
+/**
+ * @brief Runs a reduction over an index range in parallel.
+ * @param begin First index of the range.
+ * @param end Index past the last one of the range.
+ * @param grain Largest subrange to run without splitting, 0 to choose it
+ * automatically.
+ * @param func Function to fold the subranges with.
+ * @param join Function to join the results of the adjacent subranges.
+ * @param identity Initial value of every partial result.
+ * @param result_size Size of the result in bytes.
+ * @param[out] result Buffer of @a result_size bytes to store the result in.
+ * @param data Pointer to pass into @a func and @a join, may be NULL.
+ * @return TRUE in case of success, FALSE in case of invalid input.
+ * @since 0.0.5
+ *
+ * The partial results are plain memory copies of @a identity, so the result
+ * must not own any resources. Results up to 64 bytes are kept on the stack,
+ * larger ones are allocated, and a subrange which fails to allocate one is
+ * folded without splitting.
+ */
+P_LIB_API pboolean	p_parallel_reduce	(psize			begin,
+						 psize			end,
+						 psize			grain,
+						 PParallelReduceFunc	func,
+						 PParallelJoinFunc	join,
+						 pconstpointer		identity,
+						 psize			result_size,
+						 ppointer		result,
+						 ppointer		data);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PPARALLEL_H */
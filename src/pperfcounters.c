@@ -0,0 +1,330 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* All the counters are opened as a single group with the first opened one as
+ * the leader, so a single read() returns all the values together with the
+ * time the group was enabled and actually running. The two times differ when
+ * the kernel multiplexes more groups than the PMU can count at once, then
+ * the values are extrapolated like perf-stat does. The counters keep running
+ * all the time, a region is measured as a difference of two reads. */
+
+#include "pmem.h"
+#include "perror-private.h"
+#include "pperfcounters.h"
+
+#include <string.h>
+
+#ifdef PLIBSYS_HAS_PERF_EVENT
+#  include <errno.h>
+#  include <unistd.h>
+#  include <sys/ioctl.h>
+#  include <sys/syscall.h>
+#  include <linux/perf_event.h>
+
+#  ifdef PERF_FLAG_FD_CLOEXEC
+#    define P_PERF_COUNTERS_OPEN_FLAGS	PERF_FLAG_FD_CLOEXEC
+#  else
+#    define P_PERF_COUNTERS_OPEN_FLAGS	0
+#  endif
+
+typedef struct PPerfCountersReading_ {
+	puint64	nr;
+	puint64	time_enabled;
+	puint64	time_running;
+	puint64	values[P_PERF_COUNTER_TYPE_COUNT];
+} PPerfCountersReading;
+
+struct PPerfCounters_ {
+	pint			fds[P_PERF_COUNTER_TYPE_COUNT];
+	pint			slots[P_PERF_COUNTER_TYPE_COUNT];
+	pint			leader_fd;
+	psize			read_size;
+	PPerfCountersReading	start;
+};
+
+static const struct {
+	puint32	type;
+	puint64	config;
+} pp_perf_counters_events[P_PERF_COUNTER_TYPE_COUNT] = {
+	{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+	{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+	{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+	{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+	{ PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK },
+	{ PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS },
+	{ PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES }
+};
+
+static pint pp_perf_counters_open (PPerfCounterType type, pint group_fd);
+static pboolean pp_perf_counters_read (PPerfCounters *counters, PPerfCountersReading *reading);
+#endif
+
+static const pchar *pp_perf_counters_names[P_PERF_COUNTER_TYPE_COUNT] = {
+	"cycles",
+	"instructions",
+	"cache-misses",
+	"branch-misses",
+	"task-clock",
+	"page-faults",
+	"context-switches"
+};
+
+#ifdef PLIBSYS_HAS_PERF_EVENT
+static pint
+pp_perf_counters_open (PPerfCounterType	type,
+		       pint		group_fd)
+{
+	struct perf_event_attr	attr;
+	pint			fd;
+
+	memset (&attr, 0, sizeof (attr));
+
+	attr.size           = sizeof (attr);
+	attr.type           = pp_perf_counters_events[type].type;
+	attr.config         = pp_perf_counters_events[type].config;
+	attr.read_format    = PERF_FORMAT_GROUP |
+			      PERF_FORMAT_TOTAL_TIME_ENABLED |
+			      PERF_FORMAT_TOTAL_TIME_RUNNING;
+	attr.disabled       = group_fd < 0 ? 1 : 0;
+	attr.exclude_hv     = 1;
+
+	/* Context switches happen in the kernel and would be excluded too */
+	if (attr.type == PERF_TYPE_HARDWARE)
+		attr.exclude_kernel = 1;
+
+	/* The calling thread on any CPU */
+	fd = (pint) syscall (__NR_perf_event_open, &attr, 0, -1, group_fd, P_PERF_COUNTERS_OPEN_FLAGS);
+
+	/* Strict policy allows to count the user mode only */
+	if (fd < 0 && errno == EACCES && attr.exclude_kernel == 0) {
+		attr.exclude_kernel = 1;
+		fd = (pint) syscall (__NR_perf_event_open, &attr, 0, -1, group_fd, P_PERF_COUNTERS_OPEN_FLAGS);
+	}
+
+	return fd;
+}
+
+static pboolean
+pp_perf_counters_read (PPerfCounters		*counters,
+		       PPerfCountersReading	*reading)
+{
+	if (P_UNLIKELY (read (counters->leader_fd, reading, counters->read_size) != (ssize_t) counters->read_size)) {
+		p_error_set_last_system (errno);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+P_LIB_API PPerfCounters *
+p_perf_counters_new (PError **error)
+{
+	PPerfCounters	*ret;
+	pint		last_error = 0;
+	pint		count      = 0;
+	pint		i;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PPerfCounters))) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for performance counters");
+		return NULL;
+	}
+
+	ret->leader_fd = -1;
+
+	/* Hardware counters may be missing, i.e. in a virtual machine */
+	for (i = 0; i < P_PERF_COUNTER_TYPE_COUNT; ++i) {
+		ret->fds[i]   = pp_perf_counters_open ((PPerfCounterType) i, ret->leader_fd);
+		ret->slots[i] = -1;
+
+		if (ret->fds[i] < 0) {
+			last_error = errno;
+			continue;
+		}
+
+		if (ret->leader_fd < 0)
+			ret->leader_fd = ret->fds[i];
+
+		ret->slots[i] = count++;
+	}
+
+	if (P_UNLIKELY (count == 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NOT_SUPPORTED,
+				     last_error,
+				     "No performance counters available");
+		p_free (ret);
+		return NULL;
+	}
+
+	ret->read_size = (3 + (psize) count) * sizeof (puint64);
+
+	if (P_UNLIKELY (ioctl (ret->leader_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP) != 0 ||
+			pp_perf_counters_read (ret, &ret->start) == FALSE)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to enable performance counters");
+		p_perf_counters_free (ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+P_LIB_API pboolean
+p_perf_counters_is_supported (const PPerfCounters	*counters,
+			      PPerfCounterType		type)
+{
+	if (P_UNLIKELY (counters == NULL || (pint) type < 0 || (pint) type >= P_PERF_COUNTER_TYPE_COUNT))
+		return FALSE;
+
+	return counters->slots[type] >= 0;
+}
+
+P_LIB_API pboolean
+p_perf_counters_begin (PPerfCounters *counters)
+{
+	if (P_UNLIKELY (counters == NULL))
+		return FALSE;
+
+	return pp_perf_counters_read (counters, &counters->start);
+}
+
+P_LIB_API pboolean
+p_perf_counters_end (PPerfCounters		*counters,
+		     PPerfCountersDelta	*delta)
+{
+	PPerfCountersReading	reading;
+	puint64			enabled;
+	puint64			running;
+	puint64			value;
+	pint			i;
+
+	if (P_UNLIKELY (counters == NULL || delta == NULL))
+		return FALSE;
+
+	memset (delta, 0, sizeof (PPerfCountersDelta));
+
+	if (P_UNLIKELY (pp_perf_counters_read (counters, &reading) == FALSE))
+		return FALSE;
+
+	enabled = reading.time_enabled - counters->start.time_enabled;
+	running = reading.time_running - counters->start.time_running;
+
+	delta->scaled = running < enabled ? TRUE : FALSE;
+
+	for (i = 0; i < P_PERF_COUNTER_TYPE_COUNT; ++i) {
+		if (counters->slots[i] < 0)
+			continue;
+
+		value = reading.values[counters->slots[i]] - counters->start.values[counters->slots[i]];
+
+		/* The group didn't run at all, i.e. the PMU is busy */
+		if (P_UNLIKELY (running == 0))
+			value = 0;
+		else if (running < enabled)
+			value = (puint64) ((double) value * (double) enabled / (double) running);
+
+		delta->values[i] = value;
+	}
+
+	return TRUE;
+}
+
+P_LIB_API void
+p_perf_counters_free (PPerfCounters *counters)
+{
+	pint i;
+
+	if (P_UNLIKELY (counters == NULL))
+		return;
+
+	for (i = 0; i < P_PERF_COUNTER_TYPE_COUNT; ++i) {
+		if (counters->fds[i] >= 0)
+			close (counters->fds[i]);
+	}
+
+	p_free (counters);
+}
+#else
+P_LIB_API PPerfCounters *
+p_perf_counters_new (PError **error)
+{
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IO_NOT_IMPLEMENTED,
+			     0,
+			     "No performance counters implementation");
+
+	return NULL;
+}
+
+P_LIB_API pboolean
+p_perf_counters_is_supported (const PPerfCounters	*counters,
+			      PPerfCounterType		type)
+{
+	P_UNUSED (counters);
+	P_UNUSED (type);
+
+	return FALSE;
+}
+
+P_LIB_API pboolean
+p_perf_counters_begin (PPerfCounters *counters)
+{
+	P_UNUSED (counters);
+
+	return FALSE;
+}
+
+P_LIB_API pboolean
+p_perf_counters_end (PPerfCounters		*counters,
+		     PPerfCountersDelta	*delta)
+{
+	P_UNUSED (counters);
+
+	if (delta != NULL)
+		memset (delta, 0, sizeof (PPerfCountersDelta));
+
+	return FALSE;
+}
+
+P_LIB_API void
+p_perf_counters_free (PPerfCounters *counters)
+{
+	P_UNUSED (counters);
+}
+#endif
+
+P_LIB_API const pchar *
+p_perf_counters_get_name (PPerfCounterType type)
+{
+	if (P_UNLIKELY ((pint) type < 0 || (pint) type >= P_PERF_COUNTER_TYPE_COUNT))
+		return NULL;
+
+	return pp_perf_counters_names[type];
+}
@@ -0,0 +1,165 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pperfcounters.h
+ * @brief Hardware performance counters
+ * @author Alexander Saprykin
+ *
+ * Wall-clock time tells how long a piece of code runs, but not why: the
+ * hardware performance counters tell whether it is bound by the cache misses,
+ * the branch mispredictions or simply executes a lot of instructions.
+ *
+ * #PPerfCounters opens a group of counters for the calling thread, the
+ * counters of a group are always scheduled together, so their values
+ * describe the same time span. Wrap a region with p_perf_counters_begin() and
+ * p_perf_counters_end() to get the counter deltas:
+ * @code
+ * PPerfCounters      *counters = p_perf_counters_new (NULL);
+ * PPerfCountersDelta delta;
+ *
+ * p_perf_counters_begin (counters);
+ * process_batch (batch);
+ * p_perf_counters_end (counters, &delta);
+ *
+ * printf ("IPC: %.2f\n", (double) delta.values[P_PERF_COUNTER_TYPE_INSTRUCTIONS] /
+ *                        (double) delta.values[P_PERF_COUNTER_TYPE_CYCLES]);
+ * @endcode
+ *
+ * Only the work of the calling thread is counted, the hardware counters
+ * count the user mode only. Reading the counters takes a system call, so the
+ * regions should be long enough, at least a few microseconds.
+ *
+ * The counters are not always available: virtual machines often have no
+ * performance monitoring unit, and the system policy may forbid the access
+ * (on Linux see /proc/sys/kernel/perf_event_paranoid). A counter which can't
+ * be opened is reported as unsupported by p_perf_counters_is_supported() and
+ * reads as zero, while the others still work. The software counters (task
+ * clock, page faults and context switches) are available in most cases. If no
+ * counter can be opened p_perf_counters_new() fails.
+ *
+ * The counters are supported on Linux through the perf_event_open() system
+ * call, on the other systems p_perf_counters_new() fails with
+ * #P_ERROR_IO_NOT_IMPLEMENTED.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PPERFCOUNTERS_H
+#define PLIBSYS_HEADER_PPERFCOUNTERS_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+#include "perror.h"
+
+P_BEGIN_DECLS
+
+/** Performance counter type. */
+typedef enum PPerfCounterType_ {
+	P_PERF_COUNTER_TYPE_CYCLES		= 0,	/**< CPU cycles.				*/
+	P_PERF_COUNTER_TYPE_INSTRUCTIONS	= 1,	/**< Retired instructions.			*/
+	P_PERF_COUNTER_TYPE_CACHE_MISSES	= 2,	/**< Last level cache misses.			*/
+	P_PERF_COUNTER_TYPE_BRANCH_MISSES	= 3,	/**< Mispredicted branches.			*/
+	P_PERF_COUNTER_TYPE_TASK_CLOCK		= 4,	/**< Time on the CPU, in nanoseconds.		*/
+	P_PERF_COUNTER_TYPE_PAGE_FAULTS		= 5,	/**< Page faults.				*/
+	P_PERF_COUNTER_TYPE_CONTEXT_SWITCHES	= 6	/**< Context switches.				*/
+} PPerfCounterType;
+
+/** Number of the counter types. */
+#define P_PERF_COUNTER_TYPE_COUNT	7
+
+/** Performance counters opaque data type. */
+typedef struct PPerfCounters_ PPerfCounters;
+
+/** Counter changes over a region. */
+typedef struct PPerfCountersDelta_ {
+	puint64	values[P_PERF_COUNTER_TYPE_COUNT];	/**< Changes indexed by #PPerfCounterType,
+							     zero for the unsupported ones.	*/
+	pboolean scaled;				/**< Whether the counters were
+							     multiplexed with the other groups
+							     and the values are estimated.	*/
+} PPerfCountersDelta;
+
+/**
+ * @brief Opens the performance counters for the calling thread.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Pointer to a newly created #PPerfCounters object in case of
+ * success, NULL if no counter can be opened.
+ * @since 0.0.5
+ *
+ * The counters must be used from the calling thread only.
+ */
+P_LIB_API PPerfCounters *	p_perf_counters_new		(PError			**error);
+
+/**
+ * @brief Checks whether a counter is available.
+ * @param counters #PPerfCounters to check.
+ * @param type Counter type.
+ * @return TRUE if the counter of the @a type is opened, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean		p_perf_counters_is_supported	(const PPerfCounters	*counters,
+								 PPerfCounterType	type);
+
+/**
+ * @brief Gets a short name of a counter type.
+ * @param type Counter type.
+ * @return Name of the @a type, i.e. "cycles", NULL for an unknown type.
+ * @since 0.0.5
+ */
+P_LIB_API const pchar *		p_perf_counters_get_name	(PPerfCounterType	type);
+
+/**
+ * @brief Marks the start of a measured region.
+ * @param counters #PPerfCounters to read.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean		p_perf_counters_begin		(PPerfCounters		*counters);
+
+/**
+ * @brief Marks the end of a measured region and gets the counter changes.
+ * @param counters #PPerfCounters to read.
+ * @param[out] delta Counter changes since the last p_perf_counters_begin().
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The same begin mark can be used for several p_perf_counters_end() calls.
+ */
+P_LIB_API pboolean		p_perf_counters_end		(PPerfCounters		*counters,
+								 PPerfCountersDelta	*delta);
+
+/**
+ * @brief Closes the performance counters.
+ * @param counters #PPerfCounters to free.
+ * @since 0.0.5
+ */
+P_LIB_API void			p_perf_counters_free		(PPerfCounters		*counters);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PPERFCOUNTERS_H */
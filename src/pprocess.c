@@ -23,12 +23,728 @@
  * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include "pmem.h"
+#include "ponce.h"
 #include "pprocess.h"
+#include "pstring.h"
+#include "ptimeprofiler.h"
+#include "puthread.h"
+#include "perror-private.h"
 
-#ifndef P_OS_WIN
+#include <string.h>
+
+#ifdef P_OS_WIN
+#  include <psapi.h>
+#else
 #  include <sys/types.h>
+#  include <sys/socket.h>
+#  include <sys/wait.h>
+#  include <errno.h>
+#  include <fcntl.h>
 #  include <signal.h>
 #  include <unistd.h>
+#  include <time.h>
+#  include <sys/time.h>
+#  include <sys/resource.h>
+#  ifdef PLIBSYS_HAS_POSIX_SPAWN
+#    include <spawn.h>
+#  endif
+#  ifdef P_OS_LINUX
+#    include <sys/stat.h>
+#    include <sys/syscall.h>
+#  endif
+#  ifdef P_OS_MAC
+#    include <libproc.h>
+#    include <sys/proc_info.h>
+#    include <mach/mach_time.h>
+#    include <crt_externs.h>
+#    define environ (*_NSGetEnviron ())
+#  else
+extern char **environ;
+#  endif
+#endif
+
+#define P_PROCESS_STDIO_COUNT		3
+#define P_PROCESS_WAIT_MAX_SLEEP	50
+#define P_PROCESS_PROC_PATH_SIZE	64
+#define P_PROCESS_PROC_BUF_SIZE		4096
+#define P_PROCESS_MAC_FDS_MAX		256
+
+struct PProcess_ {
+#ifdef P_OS_WIN
+	HANDLE		proc;
+	HANDLE		pipes[P_PROCESS_STDIO_COUNT];
+	DWORD		pid;
+#else
+	pid_t		pid;
+	pint		fds[P_PROCESS_STDIO_COUNT];
+	PSocket		*sockets[P_PROCESS_STDIO_COUNT];
+	pint		exit_code;
+	pboolean	reaped;
+#endif
+};
+
+static POnce pp_process_once = P_ONCE_INIT;
+
+#ifdef P_OS_WIN
+typedef BOOL (WINAPI * PWin32GetProcessMemoryInfo) (HANDLE			process,
+						    PPROCESS_MEMORY_COUNTERS	counters,
+						    DWORD			cb);
+
+static PWin32GetProcessMemoryInfo pp_process_get_memory_info_func = NULL;
+#endif
+
+#ifdef P_OS_LINUX
+/* Layout of the getdents64() records, it is fixed by the kernel ABI */
+typedef struct PProcessDirent64_ {
+	puint64		d_ino;
+	pint64		d_off;
+	pushort		d_reclen;
+	puchar		d_type;
+	pchar		d_name[1];
+} PProcessDirent64;
+
+static pint64 pp_process_page_size   = -1;
+static pint64 pp_process_clock_ticks = -1;
+#endif
+
+#ifdef P_OS_MAC
+static mach_timebase_info_data_t pp_process_timebase = {0, 0};
+#endif
+
+static void pp_process_init (ppointer data);
+static pboolean pp_process_check_flags (puint flags, PError **error);
+static void pp_process_close_all (PProcess *process);
+
+#ifdef P_OS_LINUX
+static void pp_process_build_proc_path (pchar *path, puint32 pid, pboolean self, const pchar *name);
+static pssize pp_process_read_proc (puint32 pid, pboolean self, const pchar *name, pchar *buf, psize buflen);
+static pboolean pp_process_parse_stat (const pchar *buf, psize len, pboolean with_times, PProcessStats *stats);
+static pint64 pp_process_parse_status_value (const pchar *buf, psize len, const pchar *key);
+static pint64 pp_process_count_fds (puint32 pid, pboolean self);
+#endif
+
+#ifdef P_OS_WIN
+static pboolean pp_process_create_pipe (PProcessStdio stdio, HANDLE *parent, HANDLE *child, PError **error);
+static pchar * pp_process_build_cmdline (const pchar *path, const pchar * const *argv);
+static pchar * pp_process_build_envblock (const pchar * const *envp);
+#else
+static pboolean pp_process_create_pair (puint flags, pint fds[2], PError **error);
+static void pp_process_decode_status (PProcess *process, pint status);
+#  ifdef PLIBSYS_HAS_POSIX_SPAWN
+static pint pp_process_spawn_posix (pid_t *pid, const pchar *path, pchar * const *argv, pchar * const *envp,
+				    const pchar *working_dir, puint flags, const pint child_fds[P_PROCESS_STDIO_COUNT]);
+#  endif
+#  if !defined (PLIBSYS_HAS_POSIX_SPAWN) || !defined (PLIBSYS_HAS_POSIX_SPAWN_CHDIR)
+static pint pp_process_spawn_fork (pid_t *pid, const pchar *path, pchar * const *argv, pchar * const *envp,
+				   const pchar *working_dir, puint flags, const pint child_fds[P_PROCESS_STDIO_COUNT]);
+#  endif
+#endif
+
+#ifdef P_OS_LINUX
+static void
+pp_process_build_proc_path (pchar		*path,
+			    puint32		pid,
+			    pboolean		self,
+			    const pchar		*name)
+{
+	pchar	digits[16];
+	pint	n_digits = 0;
+
+	memcpy (path, "/proc/", 6);
+	path += 6;
+
+	if (self == TRUE) {
+		memcpy (path, "self", 4);
+		path += 4;
+	} else {
+		do {
+			digits[n_digits++] = (pchar) ('0' + pid % 10);
+			pid /= 10;
+		} while (pid > 0);
+
+		while (n_digits > 0)
+			*path++ = digits[--n_digits];
+	}
+
+	*path++ = '/';
+
+	strcpy (path, name);
+}
+
+static pssize
+pp_process_read_proc (puint32		pid,
+		      pboolean		self,
+		      const pchar	*name,
+		      pchar		*buf,
+		      psize		buflen)
+{
+	pchar	path[P_PROCESS_PROC_PATH_SIZE];
+	psize	total = 0;
+	pssize	res   = 0;
+	pint	fd;
+
+	pp_process_build_proc_path (path, pid, self, name);
+
+	if ((fd = open (path, O_RDONLY)) < 0)
+		return -1;
+
+	/* Procfs files are generated on read, the buffer is kept zero-terminated */
+	while (total < buflen - 1) {
+		res = read (fd, buf + total, buflen - 1 - total);
+
+		if (res < 0 && errno == EINTR)
+			continue;
+
+		if (res <= 0)
+			break;
+
+		total += (psize) res;
+	}
+
+	close (fd);
+
+	buf[total] = '\0';
+
+	return res < 0 ? -1 : (pssize) total;
+}
+
+static pboolean
+pp_process_parse_stat (const pchar	*buf,
+		       psize		len,
+		       pboolean		with_times,
+		       PProcessStats	*stats)
+{
+	const pchar	*ptr;
+	const pchar	*end;
+	const pchar	*token_end;
+	pint64		value;
+	pint		field;
+
+	/* The command name may contain spaces and brackets, so the fields are
+	 * counted from the last closing bracket which ends the 2nd field */
+	if (P_UNLIKELY ((ptr = strrchr (buf, ')')) == NULL))
+		return FALSE;
+
+	end = buf + len;
+
+	for (++ptr, field = 3; field <= 24; ++field) {
+		ptr += p_str_skip_spaces (ptr, (psize) (end - ptr));
+
+		for (token_end = ptr; token_end < end && *token_end != ' '; ++token_end)
+			;
+
+		if (P_UNLIKELY (token_end == ptr))
+			return FALSE;
+
+		if (field == 14 || field == 15 || field == 20 || field == 23 || field == 24) {
+			if (P_UNLIKELY (p_strtoll_n (ptr, (psize) (token_end - ptr), &value) != (psize) (token_end - ptr)))
+				return FALSE;
+
+			switch (field) {
+			case 14:
+				if (with_times == TRUE && pp_process_clock_ticks > 0)
+					stats->user_time = value * 1000000000 / pp_process_clock_ticks;
+				break;
+			case 15:
+				if (with_times == TRUE && pp_process_clock_ticks > 0)
+					stats->system_time = value * 1000000000 / pp_process_clock_ticks;
+				break;
+			case 20:
+				stats->threads = value;
+				break;
+			case 23:
+				stats->virtual_size = value;
+				break;
+			case 24:
+				if (pp_process_page_size > 0)
+					stats->rss = value * pp_process_page_size;
+				break;
+			}
+		}
+
+		ptr = token_end;
+	}
+
+	return TRUE;
+}
+
+static pint64
+pp_process_parse_status_value (const pchar	*buf,
+			       psize		len,
+			       const pchar	*key)
+{
+	const pchar	*line;
+	const pchar	*end;
+	psize		key_len;
+	psize		skip;
+	pint64		value;
+
+	key_len = strlen (key);
+	end     = buf + len;
+
+	for (line = buf; line < end; ++line) {
+		if ((psize) (end - line) > key_len && memcmp (line, key, key_len) == 0) {
+			line += key_len;
+			skip  = p_str_skip_spaces (line, (psize) (end - line));
+
+			if (p_strtoll_n (line + skip, (psize) (end - line) - skip, &value) == 0)
+				return -1;
+
+			return value;
+		}
+
+		if ((line = memchr (line, '\n', (psize) (end - line))) == NULL)
+			break;
+	}
+
+	return -1;
+}
+
+static pint64
+pp_process_count_fds (puint32	pid,
+		      pboolean	self)
+{
+	pchar		path[P_PROCESS_PROC_PATH_SIZE];
+	struct stat	st;
+#  ifdef SYS_getdents64
+	puint64		dents[P_PROCESS_PROC_BUF_SIZE / sizeof (puint64)];
+	PProcessDirent64 *dent;
+	pint64		count = 0;
+	plong		res;
+	plong		offset;
+	pint		fd;
+#  endif
+
+	pp_process_build_proc_path (path, pid, self, "fd");
+
+	/* Since Linux 6.2 the size of the directory is the number of descriptors */
+	if (stat (path, &st) == 0 && st.st_size > 0)
+		return (pint64) st.st_size;
+
+#  ifdef SYS_getdents64
+	/* readdir() allocates, read the entries into a stack buffer instead */
+	if ((fd = open (path, O_RDONLY | O_DIRECTORY)) < 0)
+		return -1;
+
+	while ((res = syscall (SYS_getdents64, fd, dents, sizeof (dents))) > 0) {
+		for (offset = 0; offset < res; offset += dent->d_reclen) {
+			dent = (PProcessDirent64 *) ((pchar *) dents + offset);
+
+			if (dent->d_name[0] != '.')
+				++count;
+		}
+	}
+
+	close (fd);
+
+	if (P_UNLIKELY (res < 0))
+		return -1;
+
+	/* Don't count the descriptor of the directory itself */
+	return self == TRUE ? count - 1 : count;
+#  else
+	return -1;
+#  endif
+}
+#endif
+
+static void
+pp_process_init (ppointer data)
+{
+#if defined (P_OS_WIN)
+	HMODULE hmodule;
+#endif
+
+	P_UNUSED (data);
+
+#if defined (P_OS_WIN)
+	/* Exported from kernel32 since Windows 7, psapi is required otherwise */
+	if ((hmodule = GetModuleHandleA ("kernel32.dll")) != NULL)
+		pp_process_get_memory_info_func = (PWin32GetProcessMemoryInfo) GetProcAddress (hmodule,
+											       "K32GetProcessMemoryInfo");
+#elif defined (P_OS_LINUX)
+	pp_process_page_size   = (pint64) sysconf (_SC_PAGESIZE);
+	pp_process_clock_ticks = (pint64) sysconf (_SC_CLK_TCK);
+#elif defined (P_OS_MAC)
+	if (mach_timebase_info (&pp_process_timebase) != KERN_SUCCESS) {
+		pp_process_timebase.numer = 0;
+		pp_process_timebase.denom = 0;
+	}
+#endif
+}
+
+static pboolean
+pp_process_check_flags (puint	flags,
+			PError	**error)
+{
+	if (P_UNLIKELY ((flags & P_PROCESS_SPAWN_PIPE_STDIN  && flags & P_PROCESS_SPAWN_NULL_STDIN)  ||
+			(flags & P_PROCESS_SPAWN_PIPE_STDOUT && flags & P_PROCESS_SPAWN_NULL_STDOUT) ||
+			(flags & P_PROCESS_SPAWN_PIPE_STDERR && flags & P_PROCESS_SPAWN_NULL_STDERR))) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Both pipe and null redirection requested for the same stream");
+		return FALSE;
+	}
+
+#ifdef P_OS_WIN
+	if (P_UNLIKELY (flags & P_PROCESS_SPAWN_SOCKET_PIPES)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NOT_SUPPORTED,
+				     0,
+				     "Socket pipes are not supported on this platform");
+		return FALSE;
+	}
+#endif
+
+	return TRUE;
+}
+
+static void
+pp_process_close_all (PProcess *process)
+{
+	pint i;
+
+	for (i = 0; i < P_PROCESS_STDIO_COUNT; ++i)
+		p_process_close_stdio (process, (PProcessStdio) i);
+}
+
+#ifdef P_OS_WIN
+static pboolean
+pp_process_create_pipe (PProcessStdio	stdio,
+			HANDLE		*parent,
+			HANDLE		*child,
+			PError		**error)
+{
+	SECURITY_ATTRIBUTES	sa;
+	HANDLE			read_end;
+	HANDLE			write_end;
+
+	memset (&sa, 0, sizeof (sa));
+
+	sa.nLength        = sizeof (sa);
+	sa.bInheritHandle = TRUE;
+
+	if (P_UNLIKELY (CreatePipe (&read_end, &write_end, &sa, 0) == 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call CreatePipe() to create pipe");
+		return FALSE;
+	}
+
+	if (stdio == P_PROCESS_STDIO_IN) {
+		*parent = write_end;
+		*child  = read_end;
+	} else {
+		*parent = read_end;
+		*child  = write_end;
+	}
+
+	/* Only the child end should be inherited */
+	if (P_UNLIKELY (SetHandleInformation (*parent, HANDLE_FLAG_INHERIT, 0) == 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call SetHandleInformation() on pipe");
+		CloseHandle (read_end);
+		CloseHandle (write_end);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static pchar *
+pp_process_build_cmdline (const pchar		*path,
+			  const pchar * const	*argv)
+{
+	const pchar * const	*args;
+	const pchar		*single[2];
+	const pchar		*ptr;
+	pchar			*ret;
+	pchar			*out;
+	psize			len;
+	psize			slashes;
+
+	if (argv == NULL) {
+		single[0] = path;
+		single[1] = NULL;
+		argv      = single;
+	}
+
+	/* Each character may be escaped, plus quotes and a separator */
+	for (args = argv, len = 1; *args != NULL; ++args)
+		len += strlen (*args) * 2 + 3;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (len)) == NULL))
+		return NULL;
+
+	/* Quote according to the CommandLineToArgvW() rules */
+	for (args = argv, out = ret; *args != NULL; ++args) {
+		if (args != argv)
+			*out++ = ' ';
+
+		*out++ = '"';
+
+		for (ptr = *args, slashes = 0; *ptr != '\0'; ++ptr) {
+			if (*ptr == '\\') {
+				++slashes;
+			} else if (*ptr == '"') {
+				for (++slashes; slashes > 0; --slashes)
+					*out++ = '\\';
+			} else
+				slashes = 0;
+
+			*out++ = *ptr;
+		}
+
+		/* Backslashes before the closing quote must be doubled */
+		for (; slashes > 0; --slashes)
+			*out++ = '\\';
+
+		*out++ = '"';
+	}
+
+	return ret;
+}
+
+static pchar *
+pp_process_build_envblock (const pchar * const *envp)
+{
+	const pchar * const	*vars;
+	pchar			*ret;
+	pchar			*out;
+	psize			len;
+	psize			var_len;
+
+	for (vars = envp, len = 2; *vars != NULL; ++vars)
+		len += strlen (*vars) + 1;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (len)) == NULL))
+		return NULL;
+
+	/* Block is terminated with an additional zero, already there */
+	for (vars = envp, out = ret; *vars != NULL; ++vars) {
+		var_len = strlen (*vars) + 1;
+		memcpy (out, *vars, var_len);
+		out += var_len;
+	}
+
+	return ret;
+}
+#else
+static pboolean
+pp_process_create_pair (puint	flags,
+			pint	fds[2],
+			PError	**error)
+{
+	pint res;
+
+	if (flags & P_PROCESS_SPAWN_SOCKET_PIPES)
+		res = socketpair (AF_UNIX, SOCK_STREAM, 0, fds);
+	else
+		res = pipe (fds);
+
+	if (P_UNLIKELY (res != 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to create pipe for child process");
+		return FALSE;
+	}
+
+	/* Neither end should leak into other spawned processes, the child end
+	 * is duplicated into a standard stream which clears the flag */
+	if (P_UNLIKELY (fcntl (fds[0], F_SETFD, FD_CLOEXEC) != 0 ||
+			fcntl (fds[1], F_SETFD, FD_CLOEXEC) != 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call fcntl() to set FD_CLOEXEC on pipe");
+		close (fds[0]);
+		close (fds[1]);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static void
+pp_process_decode_status (PProcess	*process,
+			  pint		status)
+{
+	if (WIFEXITED (status))
+		process->exit_code = WEXITSTATUS (status);
+	else if (WIFSIGNALED (status))
+		process->exit_code = -WTERMSIG (status);
+	else
+		process->exit_code = -1;
+
+	process->reaped = TRUE;
+}
+
+#  ifdef PLIBSYS_HAS_POSIX_SPAWN
+static pint
+pp_process_spawn_posix (pid_t		*pid,
+			const pchar	*path,
+			pchar * const	*argv,
+			pchar * const	*envp,
+			const pchar	*working_dir,
+			puint		flags,
+			const pint	child_fds[P_PROCESS_STDIO_COUNT])
+{
+	posix_spawn_file_actions_t	actions;
+	posix_spawnattr_t		attr;
+	sigset_t			sigdef;
+	pshort				attr_flags;
+	pint				res;
+	pint				i;
+
+	if (P_UNLIKELY ((res = posix_spawn_file_actions_init (&actions)) != 0))
+		return res;
+
+	if (P_UNLIKELY ((res = posix_spawnattr_init (&attr)) != 0)) {
+		posix_spawn_file_actions_destroy (&actions);
+		return res;
+	}
+
+	for (i = 0; i < P_PROCESS_STDIO_COUNT && res == 0; ++i) {
+		if (child_fds[i] >= 0)
+			res = posix_spawn_file_actions_adddup2 (&actions, child_fds[i], i);
+		else if (flags & (P_PROCESS_SPAWN_NULL_STDIN << i))
+			res = posix_spawn_file_actions_addopen (&actions,
+								i,
+								"/dev/null",
+								i == P_PROCESS_STDIO_IN ? O_RDONLY : O_WRONLY,
+								0);
+	}
+
+#    ifdef PLIBSYS_HAS_POSIX_SPAWN_CHDIR
+	if (res == 0 && working_dir != NULL)
+		res = posix_spawn_file_actions_addchdir_np (&actions, working_dir);
+#    else
+	P_UNUSED (working_dir);
+#    endif
+
+	/* SIGPIPE is ignored by the library, don't pass it to the child */
+	attr_flags = POSIX_SPAWN_SETSIGDEF;
+#    ifdef POSIX_SPAWN_USEVFORK
+	attr_flags |= POSIX_SPAWN_USEVFORK;
+#    endif
+
+	sigemptyset (&sigdef);
+	sigaddset (&sigdef, SIGPIPE);
+
+	if (res == 0)
+		res = posix_spawnattr_setsigdefault (&attr, &sigdef);
+
+	if (res == 0)
+		res = posix_spawnattr_setflags (&attr, attr_flags);
+
+	if (res == 0) {
+		if (flags & P_PROCESS_SPAWN_SEARCH_PATH)
+			res = posix_spawnp (pid, path, &actions, &attr, argv, envp);
+		else
+			res = posix_spawn (pid, path, &actions, &attr, argv, envp);
+	}
+
+	posix_spawnattr_destroy (&attr);
+	posix_spawn_file_actions_destroy (&actions);
+
+	return res;
+}
+#  endif
+
+#  if !defined (PLIBSYS_HAS_POSIX_SPAWN) || !defined (PLIBSYS_HAS_POSIX_SPAWN_CHDIR)
+static pint
+pp_process_spawn_fork (pid_t		*pid,
+		       const pchar	*path,
+		       pchar * const	*argv,
+		       pchar * const	*envp,
+		       const pchar	*working_dir,
+		       puint		flags,
+		       const pint	child_fds[P_PROCESS_STDIO_COUNT])
+{
+	pint	status_fds[2];
+	pint	child_err;
+	pint	null_fd;
+	pint	i;
+	pssize	res;
+
+	/* The child reports an exec() failure through the pipe which is closed
+	 * on a successful exec() */
+	if (P_UNLIKELY (pipe (status_fds) != 0))
+		return errno;
+
+	if (P_UNLIKELY (fcntl (status_fds[1], F_SETFD, FD_CLOEXEC) != 0)) {
+		child_err = errno;
+		close (status_fds[0]);
+		close (status_fds[1]);
+		return child_err;
+	}
+
+	if ((*pid = fork ()) == 0) {
+		close (status_fds[0]);
+
+		for (i = 0; i < P_PROCESS_STDIO_COUNT; ++i) {
+			if (child_fds[i] >= 0) {
+				if (dup2 (child_fds[i], i) < 0)
+					break;
+			} else if (flags & (P_PROCESS_SPAWN_NULL_STDIN << i)) {
+				null_fd = open ("/dev/null", i == P_PROCESS_STDIO_IN ? O_RDONLY : O_WRONLY);
+
+				if (null_fd < 0 || (null_fd != i && dup2 (null_fd, i) < 0))
+					break;
+
+				if (null_fd != i)
+					close (null_fd);
+			}
+		}
+
+		if (i == P_PROCESS_STDIO_COUNT && (working_dir == NULL || chdir (working_dir) == 0)) {
+			signal (SIGPIPE, SIG_DFL);
+
+			environ = (pchar **) envp;
+
+			if (flags & P_PROCESS_SPAWN_SEARCH_PATH)
+				execvp (path, argv);
+			else
+				execv (path, argv);
+		}
+
+		child_err = errno;
+
+		while (write (status_fds[1], &child_err, sizeof (child_err)) < 0 && errno == EINTR)
+			;
+
+		_exit (127);
+	}
+
+	if (P_UNLIKELY (*pid < 0)) {
+		child_err = errno;
+		close (status_fds[0]);
+		close (status_fds[1]);
+		return child_err;
+	}
+
+	close (status_fds[1]);
+
+	while ((res = read (status_fds[0], &child_err, sizeof (child_err))) < 0 && errno == EINTR)
+		;
+
+	close (status_fds[0]);
+
+	if (res != (pssize) sizeof (child_err))
+		return 0;
+
+	while (waitpid (*pid, NULL, 0) < 0 && errno == EINTR)
+		;
+
+	return child_err;
+}
+#  endif
 #endif
 
 P_LIB_API puint32
@@ -59,3 +775,833 @@ p_process_is_running (puint32 pid)
 	return kill ((pid_t) pid, 0) == 0;
 #endif
 }
+
+P_LIB_API pint64
+p_process_get_cpu_time (void)
+{
+#ifdef P_OS_WIN
+	FILETIME	creation_time;
+	FILETIME	exit_time;
+	FILETIME	kernel_time;
+	FILETIME	user_time;
+	puint64		ticks;
+
+	if (P_UNLIKELY (GetProcessTimes (GetCurrentProcess (),
+					 &creation_time,
+					 &exit_time,
+					 &kernel_time,
+					 &user_time) == 0))
+		return -1;
+
+	/* Both times are in 100-nanosecond intervals */
+	ticks = (((puint64) kernel_time.dwHighDateTime << 32) | kernel_time.dwLowDateTime) +
+		(((puint64) user_time.dwHighDateTime << 32) | user_time.dwLowDateTime);
+
+	return (pint64) (ticks * 100);
+#else
+	struct rusage	usage;
+#  ifdef CLOCK_PROCESS_CPUTIME_ID
+	struct timespec	ts;
+
+	if (P_LIKELY (clock_gettime (CLOCK_PROCESS_CPUTIME_ID, &ts) == 0))
+		return (pint64) ts.tv_sec * 1000000000 + (pint64) ts.tv_nsec;
+#  endif
+
+	/* Fallback with a microsecond resolution */
+	if (P_UNLIKELY (getrusage (RUSAGE_SELF, &usage) != 0))
+		return -1;
+
+	return ((pint64) usage.ru_utime.tv_sec + (pint64) usage.ru_stime.tv_sec) * 1000000000 +
+	       ((pint64) usage.ru_utime.tv_usec + (pint64) usage.ru_stime.tv_usec) * 1000;
+#endif
+}
+
+P_LIB_API pboolean
+p_process_get_stats (puint32		pid,
+		     PProcessStats	*stats,
+		     PError		**error)
+{
+	pboolean		self;
+#if defined (P_OS_WIN)
+	PROCESS_MEMORY_COUNTERS_EX	counters;
+	HANDLE				proc;
+	FILETIME			creation_time;
+	FILETIME			exit_time;
+	FILETIME			kernel_time;
+	FILETIME			user_time;
+	DWORD				handles;
+#elif defined (P_OS_LINUX)
+	struct rusage		usage;
+	pchar			buf[P_PROCESS_PROC_BUF_SIZE];
+	pssize			len;
+#elif defined (P_OS_MAC)
+	struct rusage		usage;
+	struct proc_taskinfo	task_info;
+	struct proc_fdinfo	fds[P_PROCESS_MAC_FDS_MAX];
+	pint			fds_size;
+#else
+	struct rusage		usage;
+#endif
+
+	if (P_UNLIKELY (stats == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	stats->rss                  = -1;
+	stats->virtual_size         = -1;
+	stats->user_time            = -1;
+	stats->system_time          = -1;
+	stats->open_fds             = -1;
+	stats->threads              = -1;
+	stats->voluntary_switches   = -1;
+	stats->involuntary_switches = -1;
+
+	p_once (&pp_process_once, pp_process_init, NULL);
+
+	self = pid == p_process_get_current_pid ();
+
+#if defined (P_OS_WIN)
+	if (self == TRUE)
+		proc = GetCurrentProcess ();
+	else if (P_UNLIKELY ((proc = OpenProcess (PROCESS_QUERY_INFORMATION | PROCESS_VM_READ,
+						  FALSE,
+						  (DWORD) pid)) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call OpenProcess() to query process");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (GetProcessTimes (proc, &creation_time, &exit_time, &kernel_time, &user_time) == 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call GetProcessTimes() to query process");
+
+		if (self == FALSE)
+			CloseHandle (proc);
+
+		return FALSE;
+	}
+
+	/* Both times are in 100-nanosecond intervals */
+	stats->user_time   = (pint64) ((((puint64) user_time.dwHighDateTime << 32) |
+					user_time.dwLowDateTime) * 100);
+	stats->system_time = (pint64) ((((puint64) kernel_time.dwHighDateTime << 32) |
+					kernel_time.dwLowDateTime) * 100);
+
+	memset (&counters, 0, sizeof (counters));
+	counters.cb = sizeof (counters);
+
+	if (pp_process_get_memory_info_func != NULL &&
+	    pp_process_get_memory_info_func (proc,
+					     (PPROCESS_MEMORY_COUNTERS) &counters,
+					     sizeof (counters)) != 0) {
+		stats->rss          = (pint64) counters.WorkingSetSize;
+		stats->virtual_size = (pint64) counters.PrivateUsage;
+	}
+
+	if (GetProcessHandleCount (proc, &handles) != 0)
+		stats->open_fds = (pint64) handles;
+
+	if (self == FALSE)
+		CloseHandle (proc);
+#elif defined (P_OS_LINUX)
+	if (P_UNLIKELY ((len = pp_process_read_proc (pid, self, "stat", buf, sizeof (buf))) <= 0 ||
+			pp_process_parse_stat (buf, (psize) len, !self, stats) == FALSE)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to read process statistics from procfs");
+		return FALSE;
+	}
+
+	if (self == TRUE) {
+		/* Better resolution than the clock ticks in procfs */
+		if (P_LIKELY (getrusage (RUSAGE_SELF, &usage) == 0)) {
+			stats->user_time            = (pint64) usage.ru_utime.tv_sec * 1000000000 +
+						      (pint64) usage.ru_utime.tv_usec * 1000;
+			stats->system_time          = (pint64) usage.ru_stime.tv_sec * 1000000000 +
+						      (pint64) usage.ru_stime.tv_usec * 1000;
+			stats->voluntary_switches   = (pint64) usage.ru_nvcsw;
+			stats->involuntary_switches = (pint64) usage.ru_nivcsw;
+		}
+	} else if ((len = pp_process_read_proc (pid, FALSE, "status", buf, sizeof (buf))) > 0) {
+		stats->voluntary_switches   = pp_process_parse_status_value (buf,
+									     (psize) len,
+									     "voluntary_ctxt_switches:");
+		stats->involuntary_switches = pp_process_parse_status_value (buf,
+									     (psize) len,
+									     "nonvoluntary_ctxt_switches:");
+	}
+
+	stats->open_fds = pp_process_count_fds (pid, self);
+#elif defined (P_OS_MAC)
+	if (P_UNLIKELY (proc_pidinfo ((pid_t) pid,
+				      PROC_PIDTASKINFO,
+				      0,
+				      &task_info,
+				      sizeof (task_info)) != (pint) sizeof (task_info))) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call proc_pidinfo() to query process");
+		return FALSE;
+	}
+
+	stats->rss          = (pint64) task_info.pti_resident_size;
+	stats->virtual_size = (pint64) task_info.pti_virtual_size;
+	stats->threads      = (pint64) task_info.pti_threadnum;
+
+	/* Times are in the Mach absolute time units */
+	if (pp_process_timebase.denom != 0) {
+		stats->user_time   = (pint64) (task_info.pti_total_user * pp_process_timebase.numer /
+					       pp_process_timebase.denom);
+		stats->system_time = (pint64) (task_info.pti_total_system * pp_process_timebase.numer /
+					       pp_process_timebase.denom);
+	}
+
+	/* The buffer size is only an estimate if all of the slots are filled */
+	fds_size = proc_pidinfo ((pid_t) pid, PROC_PIDLISTFDS, 0, fds, sizeof (fds));
+
+	if (fds_size == (pint) sizeof (fds))
+		fds_size = proc_pidinfo ((pid_t) pid, PROC_PIDLISTFDS, 0, NULL, 0);
+
+	if (fds_size >= 0)
+		stats->open_fds = (pint64) (fds_size / PROC_PIDLISTFD_SIZE);
+
+	if (self == TRUE && getrusage (RUSAGE_SELF, &usage) == 0) {
+		stats->voluntary_switches   = (pint64) usage.ru_nvcsw;
+		stats->involuntary_switches = (pint64) usage.ru_nivcsw;
+	}
+#else
+	if (P_UNLIKELY (self == FALSE)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NOT_SUPPORTED,
+				     0,
+				     "Querying other processes is not supported on this platform");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (getrusage (RUSAGE_SELF, &usage) != 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call getrusage() to query process");
+		return FALSE;
+	}
+
+	stats->user_time            = (pint64) usage.ru_utime.tv_sec * 1000000000 +
+				      (pint64) usage.ru_utime.tv_usec * 1000;
+	stats->system_time          = (pint64) usage.ru_stime.tv_sec * 1000000000 +
+				      (pint64) usage.ru_stime.tv_usec * 1000;
+	stats->voluntary_switches   = (pint64) usage.ru_nvcsw;
+	stats->involuntary_switches = (pint64) usage.ru_nivcsw;
+#endif
+
+	return TRUE;
+}
+
+P_LIB_API PProcess *
+p_process_spawn (const pchar		*path,
+		 const pchar * const	*argv,
+		 const pchar * const	*envp,
+		 const pchar		*working_dir,
+		 puint			flags,
+		 PError			**error)
+{
+	PProcess		*ret;
+	pint			i;
+#ifdef P_OS_WIN
+	HANDLE			child_handles[P_PROCESS_STDIO_COUNT];
+	STARTUPINFOA		si;
+	PROCESS_INFORMATION	pi;
+	pchar			*cmdline;
+	pchar			*envblock;
+	BOOL			created;
+#else
+	const pchar		*single[2];
+	pint			child_fds[P_PROCESS_STDIO_COUNT];
+	pint			pair[2];
+	pint			res;
+#endif
+
+	if (P_UNLIKELY (path == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return NULL;
+	}
+
+	if (P_UNLIKELY (pp_process_check_flags (flags, error) == FALSE))
+		return NULL;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PProcess))) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for process");
+		return NULL;
+	}
+
+#ifdef P_OS_WIN
+	for (i = 0; i < P_PROCESS_STDIO_COUNT; ++i) {
+		ret->pipes[i]     = NULL;
+		child_handles[i]  = NULL;
+	}
+
+	memset (&si, 0, sizeof (si));
+	memset (&pi, 0, sizeof (pi));
+
+	si.cb      = sizeof (si);
+	si.dwFlags = STARTF_USESTDHANDLES;
+
+	for (i = 0; i < P_PROCESS_STDIO_COUNT; ++i) {
+		if (flags & (P_PROCESS_SPAWN_PIPE_STDIN << i)) {
+			if (P_UNLIKELY (pp_process_create_pipe ((PProcessStdio) i,
+								&ret->pipes[i],
+								&child_handles[i],
+								error) == FALSE))
+				break;
+		} else if (flags & (P_PROCESS_SPAWN_NULL_STDIN << i)) {
+			SECURITY_ATTRIBUTES sa;
+
+			memset (&sa, 0, sizeof (sa));
+
+			sa.nLength        = sizeof (sa);
+			sa.bInheritHandle = TRUE;
+
+			child_handles[i] = CreateFileA ("NUL",
+							i == P_PROCESS_STDIO_IN ? GENERIC_READ : GENERIC_WRITE,
+							FILE_SHARE_READ | FILE_SHARE_WRITE,
+							&sa,
+							OPEN_EXISTING,
+							FILE_ATTRIBUTE_NORMAL,
+							NULL);
+
+			if (P_UNLIKELY (child_handles[i] == INVALID_HANDLE_VALUE)) {
+				child_handles[i] = NULL;
+				p_error_set_error_p (error,
+						     (pint) p_error_get_last_io (),
+						     p_error_get_last_system (),
+						     "Failed to call CreateFileA() to open null device");
+				break;
+			}
+		}
+	}
+
+	if (P_UNLIKELY (i != P_PROCESS_STDIO_COUNT)) {
+		for (i = 0; i < P_PROCESS_STDIO_COUNT; ++i) {
+			if (child_handles[i] != NULL)
+				CloseHandle (child_handles[i]);
+		}
+
+		pp_process_close_all (ret);
+		p_free (ret);
+		return NULL;
+	}
+
+	si.hStdInput  = child_handles[0] != NULL ? child_handles[0] : GetStdHandle (STD_INPUT_HANDLE);
+	si.hStdOutput = child_handles[1] != NULL ? child_handles[1] : GetStdHandle (STD_OUTPUT_HANDLE);
+	si.hStdError  = child_handles[2] != NULL ? child_handles[2] : GetStdHandle (STD_ERROR_HANDLE);
+
+	cmdline  = pp_process_build_cmdline (path, argv);
+	envblock = envp != NULL ? pp_process_build_envblock (envp) : NULL;
+
+	if (P_UNLIKELY (cmdline == NULL || (envp != NULL && envblock == NULL))) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for process command line");
+		created = FALSE;
+	} else {
+		/* Application name disables the search, the command line is used
+		 * to find the executable otherwise */
+		created = CreateProcessA ((flags & P_PROCESS_SPAWN_SEARCH_PATH) ? NULL : path,
+					  cmdline,
+					  NULL,
+					  NULL,
+					  TRUE,
+					  0,
+					  envblock,
+					  working_dir,
+					  &si,
+					  &pi);
+
+		if (P_UNLIKELY (created == FALSE))
+			p_error_set_error_p (error,
+					     (pint) p_error_get_last_io (),
+					     p_error_get_last_system (),
+					     "Failed to call CreateProcessA() to spawn process");
+	}
+
+	p_free (cmdline);
+	p_free (envblock);
+
+	for (i = 0; i < P_PROCESS_STDIO_COUNT; ++i) {
+		if (child_handles[i] != NULL)
+			CloseHandle (child_handles[i]);
+	}
+
+	if (P_UNLIKELY (created == FALSE)) {
+		pp_process_close_all (ret);
+		p_free (ret);
+		return NULL;
+	}
+
+	CloseHandle (pi.hThread);
+
+	ret->proc = pi.hProcess;
+	ret->pid  = pi.dwProcessId;
+#else
+	if (argv == NULL) {
+		single[0] = path;
+		single[1] = NULL;
+		argv      = single;
+	}
+
+	for (i = 0; i < P_PROCESS_STDIO_COUNT; ++i) {
+		ret->fds[i]  = -1;
+		child_fds[i] = -1;
+	}
+
+	for (i = 0; i < P_PROCESS_STDIO_COUNT; ++i) {
+		if (!(flags & (P_PROCESS_SPAWN_PIPE_STDIN << i)))
+			continue;
+
+		if (P_UNLIKELY (pp_process_create_pair (flags, pair, error) == FALSE))
+			break;
+
+		/* The child reads from stdin and writes to other streams */
+		ret->fds[i]  = i == P_PROCESS_STDIO_IN ? pair[1] : pair[0];
+		child_fds[i] = i == P_PROCESS_STDIO_IN ? pair[0] : pair[1];
+	}
+
+	if (P_LIKELY (i == P_PROCESS_STDIO_COUNT)) {
+		if (envp == NULL)
+			envp = (const pchar * const *) environ;
+
+#  ifdef PLIBSYS_HAS_POSIX_SPAWN
+#    ifndef PLIBSYS_HAS_POSIX_SPAWN_CHDIR
+		if (working_dir != NULL)
+			res = pp_process_spawn_fork (&ret->pid,
+						     path,
+						     (pchar * const *) argv,
+						     (pchar * const *) envp,
+						     working_dir,
+						     flags,
+						     child_fds);
+		else
+#    endif
+			res = pp_process_spawn_posix (&ret->pid,
+						      path,
+						      (pchar * const *) argv,
+						      (pchar * const *) envp,
+						      working_dir,
+						      flags,
+						      child_fds);
+#  else
+		res = pp_process_spawn_fork (&ret->pid,
+					     path,
+					     (pchar * const *) argv,
+					     (pchar * const *) envp,
+					     working_dir,
+					     flags,
+					     child_fds);
+#  endif
+
+		if (P_UNLIKELY (res != 0))
+			p_error_set_error_p (error,
+					     (pint) p_error_get_io_from_system (res),
+					     res,
+					     "Failed to spawn process");
+	} else
+		res = -1;
+
+	for (i = 0; i < P_PROCESS_STDIO_COUNT; ++i) {
+		if (child_fds[i] >= 0)
+			close (child_fds[i]);
+	}
+
+	if (P_LIKELY (res == 0) && (flags & P_PROCESS_SPAWN_SOCKET_PIPES)) {
+		for (i = 0; i < P_PROCESS_STDIO_COUNT; ++i) {
+			if (ret->fds[i] < 0)
+				continue;
+
+			if (P_UNLIKELY ((ret->sockets[i] = p_socket_new_from_fd (ret->fds[i], error)) == NULL))
+				break;
+
+			/* The socket owns the descriptor now */
+			ret->fds[i] = -1;
+		}
+
+		/* The child has been spawned already, reap it */
+		if (P_UNLIKELY (i != P_PROCESS_STDIO_COUNT)) {
+			kill (ret->pid, SIGKILL);
+
+			while (waitpid (ret->pid, NULL, 0) < 0 && errno == EINTR)
+				;
+
+			res = -1;
+		}
+	}
+
+	if (P_UNLIKELY (res != 0)) {
+		pp_process_close_all (ret);
+		p_free (ret);
+		return NULL;
+	}
+#endif
+
+	return ret;
+}
+
+P_LIB_API puint32
+p_process_get_pid (const PProcess *process)
+{
+	if (P_UNLIKELY (process == NULL))
+		return 0;
+
+	return (puint32) process->pid;
+}
+
+P_LIB_API PSocket *
+p_process_get_stdio_socket (const PProcess	*process,
+			    PProcessStdio	stdio)
+{
+	if (P_UNLIKELY (process == NULL || (pint) stdio < 0 || (pint) stdio >= P_PROCESS_STDIO_COUNT))
+		return NULL;
+
+#ifdef P_OS_WIN
+	return NULL;
+#else
+	return process->sockets[stdio];
+#endif
+}
+
+P_LIB_API pssize
+p_process_read (const PProcess	*process,
+		PProcessStdio	stdio,
+		pchar		*buffer,
+		psize		buflen,
+		PError		**error)
+{
+#ifdef P_OS_WIN
+	DWORD	read_bytes;
+#else
+	pssize	ret;
+#endif
+
+	if (P_UNLIKELY (process == NULL || buffer == NULL ||
+			(stdio != P_PROCESS_STDIO_OUT && stdio != P_PROCESS_STDIO_ERR))) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+#ifdef P_OS_WIN
+	if (P_UNLIKELY (process->pipes[stdio] == NULL)) {
+#else
+	if (process->sockets[stdio] != NULL)
+		return p_socket_receive (process->sockets[stdio], buffer, buflen, error);
+
+	if (P_UNLIKELY (process->fds[stdio] < 0)) {
+#endif
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NOT_AVAILABLE,
+				     0,
+				     "Process stream is not redirected to pipe");
+		return -1;
+	}
+
+#ifdef P_OS_WIN
+	if (P_UNLIKELY (ReadFile (process->pipes[stdio],
+				  buffer,
+				  (DWORD) (buflen > P_MAXUINT32 ? P_MAXUINT32 : buflen),
+				  &read_bytes,
+				  NULL) == 0)) {
+		/* The child has closed its end */
+		if (GetLastError () == ERROR_BROKEN_PIPE)
+			return 0;
+
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call ReadFile() to read from pipe");
+		return -1;
+	}
+
+	return (pssize) read_bytes;
+#else
+	while ((ret = read (process->fds[stdio], buffer, buflen)) < 0 && errno == EINTR)
+		;
+
+	if (P_UNLIKELY (ret < 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call read() to read from pipe");
+		return -1;
+	}
+
+	return ret;
+#endif
+}
+
+P_LIB_API pssize
+p_process_write (const PProcess	*process,
+		 const pchar	*buffer,
+		 psize		buflen,
+		 PError		**error)
+{
+#ifdef P_OS_WIN
+	DWORD	written_bytes;
+#else
+	pssize	ret;
+#endif
+
+	if (P_UNLIKELY (process == NULL || buffer == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+#ifdef P_OS_WIN
+	if (P_UNLIKELY (process->pipes[P_PROCESS_STDIO_IN] == NULL)) {
+#else
+	if (process->sockets[P_PROCESS_STDIO_IN] != NULL)
+		return p_socket_send (process->sockets[P_PROCESS_STDIO_IN], buffer, buflen, error);
+
+	if (P_UNLIKELY (process->fds[P_PROCESS_STDIO_IN] < 0)) {
+#endif
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NOT_AVAILABLE,
+				     0,
+				     "Process stream is not redirected to pipe");
+		return -1;
+	}
+
+#ifdef P_OS_WIN
+	if (P_UNLIKELY (WriteFile (process->pipes[P_PROCESS_STDIO_IN],
+				   buffer,
+				   (DWORD) (buflen > P_MAXUINT32 ? P_MAXUINT32 : buflen),
+				   &written_bytes,
+				   NULL) == 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call WriteFile() to write to pipe");
+		return -1;
+	}
+
+	return (pssize) written_bytes;
+#else
+	while ((ret = write (process->fds[P_PROCESS_STDIO_IN], buffer, buflen)) < 0 && errno == EINTR)
+		;
+
+	if (P_UNLIKELY (ret < 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call write() to write to pipe");
+		return -1;
+	}
+
+	return ret;
+#endif
+}
+
+P_LIB_API pboolean
+p_process_close_stdio (PProcess		*process,
+		       PProcessStdio	stdio)
+{
+	if (P_UNLIKELY (process == NULL || (pint) stdio < 0 || (pint) stdio >= P_PROCESS_STDIO_COUNT))
+		return FALSE;
+
+#ifdef P_OS_WIN
+	if (process->pipes[stdio] == NULL)
+		return FALSE;
+
+	CloseHandle (process->pipes[stdio]);
+	process->pipes[stdio] = NULL;
+#else
+	if (process->sockets[stdio] != NULL) {
+		p_socket_free (process->sockets[stdio]);
+		process->sockets[stdio] = NULL;
+	} else if (process->fds[stdio] >= 0) {
+		close (process->fds[stdio]);
+		process->fds[stdio] = -1;
+	} else
+		return FALSE;
+#endif
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_process_wait (PProcess	*process,
+		pint		timeout,
+		pint		*exit_code,
+		PError		**error)
+{
+#ifdef P_OS_WIN
+	DWORD		res;
+	DWORD		code;
+#else
+	puint64		deadline;
+	puint32		sleep_time;
+	pid_t		res;
+	pint		status;
+#endif
+
+	if (P_UNLIKELY (process == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+#ifdef P_OS_WIN
+	res = WaitForSingleObject (process->proc, timeout < 0 ? INFINITE : (DWORD) timeout);
+
+	if (res == WAIT_TIMEOUT) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_TIMED_OUT,
+				     0,
+				     "Process is still running");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (res != WAIT_OBJECT_0 || GetExitCodeProcess (process->proc, &code) == 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to wait for process");
+		return FALSE;
+	}
+
+	if (exit_code != NULL)
+		*exit_code = (pint) code;
+#else
+	deadline   = timeout > 0 ? p_time_coarse_now_msecs () + (puint64) timeout : 0;
+	sleep_time = 1;
+
+	while (process->reaped == FALSE) {
+		res = waitpid (process->pid, &status, timeout < 0 ? 0 : WNOHANG);
+
+		if (res == process->pid) {
+			pp_process_decode_status (process, status);
+			break;
+		}
+
+		if (P_UNLIKELY (res < 0 && errno != EINTR)) {
+			p_error_set_error_p (error,
+					     (pint) p_error_get_last_io (),
+					     p_error_get_last_system (),
+					     "Failed to call waitpid() to wait for process");
+			return FALSE;
+		}
+
+		if (res == 0) {
+			if (timeout == 0 || p_time_coarse_now_msecs () >= deadline) {
+				p_error_set_error_p (error,
+						     (pint) P_ERROR_IO_TIMED_OUT,
+						     0,
+						     "Process is still running");
+				return FALSE;
+			}
+
+			/* There is no portable way to wait for a child with a
+			 * timeout, poll with a growing interval */
+			p_uthread_sleep (sleep_time);
+			if (sleep_time < P_PROCESS_WAIT_MAX_SLEEP)
+				sleep_time *= 2;
+		}
+	}
+
+	if (exit_code != NULL)
+		*exit_code = process->exit_code;
+#endif
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_process_terminate (PProcess	*process,
+		     PError	**error)
+{
+	if (P_UNLIKELY (process == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+#ifdef P_OS_WIN
+	if (P_UNLIKELY (TerminateProcess (process->proc, 1) == 0)) {
+		/* Already exited processes can't be terminated */
+		if (WaitForSingleObject (process->proc, 0) == WAIT_OBJECT_0)
+			return TRUE;
+
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call TerminateProcess() to kill process");
+		return FALSE;
+	}
+#else
+	if (process->reaped == TRUE)
+		return TRUE;
+
+	if (P_UNLIKELY (kill (process->pid, SIGKILL) != 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call kill() to kill process");
+		return FALSE;
+	}
+#endif
+
+	return TRUE;
+}
+
+P_LIB_API void
+p_process_free (PProcess *process)
+{
+	if (P_UNLIKELY (process == NULL))
+		return;
+
+	pp_process_close_all (process);
+
+#ifdef P_OS_WIN
+	CloseHandle (process->proc);
+#endif
+
+	p_free (process);
+}
+
+void
+p_process_shutdown (void)
+{
+	/* Let the next library initialization start over */
+	pp_process_once = P_ONCE_INIT;
+
+#if defined (P_OS_WIN)
+	pp_process_get_memory_info_func = NULL;
+#elif defined (P_OS_LINUX)
+	pp_process_page_size   = -1;
+	pp_process_clock_ticks = -1;
+#endif
+}
@@ -33,6 +33,42 @@
  * To get a PID of the currently running process call
  * p_process_get_current_pid(). To check whether a process with a given PID is
  * running up use p_process_is_running().
+ *
+ * CPU time consumed by all the threads of the calling process can be obtained
+ * with p_process_get_cpu_time(), see p_uthread_get_cpu_time() for a per-thread
+ * equivalent.
+ *
+ * A snapshot of process resource usage (resident memory, CPU time, open
+ * descriptors, context switches) is returned by p_process_get_stats(). It
+ * doesn't allocate memory and is cheap enough to be sampled periodically. On
+ * Linux it reads a couple of small files from procfs, on macOS it uses
+ * proc_pidinfo(), and on Windows GetProcessMemoryInfo() and friends. Counters
+ * which are not available on a given platform are set to -1. Other processes
+ * can be queried on Linux, macOS and Windows only, other systems report the
+ * calling process.
+ *
+ * A child process can be started with p_process_spawn(). On POSIX systems it
+ * uses posix_spawn() when available, which doesn't copy page tables of the
+ * calling process like fork() does, so spawning stays cheap even from a process
+ * with a large address space. The fork() and exec() pair is used as a fallback
+ * only when posix_spawn() is missing or can't change a working directory. On
+ * Windows CreateProcess() is used.
+ *
+ * Standard streams of the child process are inherited by default. Each of them
+ * can be redirected to a pipe using #P_PROCESS_SPAWN_PIPE_STDIN,
+ * #P_PROCESS_SPAWN_PIPE_STDOUT and #P_PROCESS_SPAWN_PIPE_STDERR flags, or
+ * discarded with #P_PROCESS_SPAWN_NULL_STDIN, #P_PROCESS_SPAWN_NULL_STDOUT and
+ * #P_PROCESS_SPAWN_NULL_STDERR flags. Use p_process_write() and
+ * p_process_read() to exchange data over the pipes, and p_process_close_stdio()
+ * to signal the end of input.
+ *
+ * With #P_PROCESS_SPAWN_SOCKET_PIPES flag the pipes are created as connected
+ * local stream sockets instead. The parent ends can be obtained with
+ * p_process_get_stdio_socket() and added to a #PSocketPoller to multiplex them
+ * with other I/O. This flag is supported on POSIX systems only.
+ *
+ * Use p_process_wait() to wait for the child process termination and to get its
+ * exit code, p_process_terminate() forcibly kills the child process.
  */
 
 #if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
@@ -44,9 +80,46 @@
 
 #include "pmacros.h"
 #include "ptypes.h"
+#include "perror.h"
+#include "psocket.h"
 
 P_BEGIN_DECLS
 
+/** Standard stream of a child process. */
+typedef enum PProcessStdio_ {
+	P_PROCESS_STDIO_IN	= 0,	/**< Standard input.	*/
+	P_PROCESS_STDIO_OUT	= 1,	/**< Standard output.	*/
+	P_PROCESS_STDIO_ERR	= 2	/**< Standard error.	*/
+} PProcessStdio;
+
+/** Flags controlling child process creation. */
+typedef enum PProcessSpawnFlags_ {
+	P_PROCESS_SPAWN_DEFAULT		= 0,		/**< Inherit all the standard streams.		*/
+	P_PROCESS_SPAWN_PIPE_STDIN	= 1 << 0,	/**< Redirect standard input to a pipe.		*/
+	P_PROCESS_SPAWN_PIPE_STDOUT	= 1 << 1,	/**< Redirect standard output to a pipe.	*/
+	P_PROCESS_SPAWN_PIPE_STDERR	= 1 << 2,	/**< Redirect standard error to a pipe.		*/
+	P_PROCESS_SPAWN_NULL_STDIN	= 1 << 3,	/**< Read standard input from a null device.	*/
+	P_PROCESS_SPAWN_NULL_STDOUT	= 1 << 4,	/**< Discard standard output.			*/
+	P_PROCESS_SPAWN_NULL_STDERR	= 1 << 5,	/**< Discard standard error.			*/
+	P_PROCESS_SPAWN_SEARCH_PATH	= 1 << 6,	/**< Search for the executable in PATH.		*/
+	P_PROCESS_SPAWN_SOCKET_PIPES	= 1 << 7	/**< Use local sockets instead of pipes.	*/
+} PProcessSpawnFlags;
+
+/** Process resource usage snapshot, unavailable values are set to -1. */
+typedef struct PProcessStats_ {
+	pint64	rss;			/**< Resident set size, in bytes.			*/
+	pint64	virtual_size;		/**< Virtual memory size, in bytes.			*/
+	pint64	user_time;		/**< CPU time spent in user mode, in nanoseconds.	*/
+	pint64	system_time;		/**< CPU time spent in kernel mode, in nanoseconds.	*/
+	pint64	open_fds;		/**< Number of open file descriptors or handles.	*/
+	pint64	threads;		/**< Number of threads.					*/
+	pint64	voluntary_switches;	/**< Number of voluntary context switches.		*/
+	pint64	involuntary_switches;	/**< Number of involuntary context switches.		*/
+} PProcessStats;
+
+/** Child process opaque data type. */
+typedef struct PProcess_ PProcess;
+
 /**
  * @brief Gets a PID of the calling process.
  * @return PID of the calling process.
@@ -63,6 +136,169 @@ P_LIB_API puint32	p_process_get_current_pid	(void);
  */
 P_LIB_API pboolean	p_process_is_running		(puint32 pid);
 
+/**
+ * @brief Gets CPU time consumed by the calling process.
+ * @return CPU time (user and system) of all the process threads in
+ * nanoseconds, -1 in case of error.
+ * @since 0.0.5
+ */
+P_LIB_API pint64	p_process_get_cpu_time		(void);
+
+/**
+ * @brief Gets resource usage statistics of a process.
+ * @param pid PID of the process, use p_process_get_current_pid() for the
+ * calling process.
+ * @param[out] stats Statistics to fill in.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * No memory is allocated during the call. The calling process is always
+ * supported, #P_ERROR_IO_NOT_SUPPORTED is reported for other processes on
+ * platforms without a way to query them.
+ */
+P_LIB_API pboolean	p_process_get_stats		(puint32		pid,
+							 PProcessStats		*stats,
+							 PError			**error);
+
+/**
+ * @brief Spawns a new child process.
+ * @param path Path to the executable, or its file name if
+ * #P_PROCESS_SPAWN_SEARCH_PATH flag is set.
+ * @param argv NULL-terminated argument list including the program name, may be
+ * NULL to pass @a path as the only argument.
+ * @param envp NULL-terminated list of the "NAME=value" environment variables,
+ * may be NULL to inherit the environment of the calling process.
+ * @param working_dir Working directory of the child process, may be NULL to
+ * inherit the current one.
+ * @param flags Bitwise OR of #PProcessSpawnFlags values.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Pointer to a newly spawned child process in case of success, NULL
+ * otherwise.
+ * @since 0.0.5
+ *
+ * Both pipe and null redirection flags must not be set for the same stream.
+ * The parent ends of the pipes are not inherited by any other spawned process.
+ */
+P_LIB_API PProcess *	p_process_spawn			(const pchar		*path,
+							 const pchar * const	*argv,
+							 const pchar * const	*envp,
+							 const pchar		*working_dir,
+							 puint			flags,
+							 PError			**error);
+
+/**
+ * @brief Gets a PID of a child process.
+ * @param process Child process.
+ * @return PID of the child process, 0 in case of error.
+ * @since 0.0.5
+ */
+P_LIB_API puint32	p_process_get_pid		(const PProcess		*process);
+
+/**
+ * @brief Gets a socket connected to a standard stream of a child process.
+ * @param process Child process.
+ * @param stdio Standard stream to get the socket for.
+ * @return Socket in case of success, NULL if the stream is not redirected,
+ * already closed or the process was spawned without
+ * #P_PROCESS_SPAWN_SOCKET_PIPES flag.
+ * @since 0.0.5
+ *
+ * The socket is owned by the process object and must not be freed, use
+ * p_process_close_stdio() instead. It can be added to a #PSocketPoller, it is
+ * also used internally by p_process_read() and p_process_write(), so its
+ * blocking mode affects them.
+ */
+P_LIB_API PSocket *	p_process_get_stdio_socket	(const PProcess		*process,
+							 PProcessStdio		stdio);
+
+/**
+ * @brief Reads data from a standard output or error of a child process.
+ * @param process Child process.
+ * @param stdio Either #P_PROCESS_STDIO_OUT or #P_PROCESS_STDIO_ERR.
+ * @param[out] buffer Buffer to read data in.
+ * @param buflen Size of @a buffer, in bytes.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Number of bytes read in case of success, 0 if the child process has
+ * closed the stream, -1 otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pssize	p_process_read			(const PProcess		*process,
+							 PProcessStdio		stdio,
+							 pchar			*buffer,
+							 psize			buflen,
+							 PError			**error);
+
+/**
+ * @brief Writes data to a standard input of a child process.
+ * @param process Child process.
+ * @param buffer Buffer with data to write.
+ * @param buflen Size of @a buffer, in bytes.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Number of bytes written in case of success, -1 otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pssize	p_process_write			(const PProcess		*process,
+							 const pchar		*buffer,
+							 psize			buflen,
+							 PError			**error);
+
+/**
+ * @brief Closes the parent end of a redirected standard stream.
+ * @param process Child process.
+ * @param stdio Standard stream to close.
+ * @return TRUE in case of success, FALSE if the stream is not redirected or
+ * already closed.
+ * @since 0.0.5
+ *
+ * Closing #P_PROCESS_STDIO_IN delivers the end of file to the child process.
+ */
+P_LIB_API pboolean	p_process_close_stdio		(PProcess		*process,
+							 PProcessStdio		stdio);
+
+/**
+ * @brief Waits for a child process to terminate.
+ * @param process Child process.
+ * @param timeout Timeout in milliseconds, 0 to check without waiting, a
+ * negative value to wait infinitely.
+ * @param[out] exit_code Exit code of the child process, may be NULL. A negative
+ * signal number is stored if the child process was killed by a signal.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE if the child process has terminated, FALSE otherwise.
+ * #P_ERROR_IO_TIMED_OUT is reported if the child process is still running.
+ * @since 0.0.5
+ *
+ * The function can be called repeatedly, the exit code is stored after the
+ * child process has terminated.
+ */
+P_LIB_API pboolean	p_process_wait			(PProcess		*process,
+							 pint			timeout,
+							 pint			*exit_code,
+							 PError			**error);
+
+/**
+ * @brief Forcibly terminates a child process.
+ * @param process Child process.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * Use p_process_wait() afterwards to release the system resources.
+ */
+P_LIB_API pboolean	p_process_terminate		(PProcess		*process,
+							 PError			**error);
+
+/**
+ * @brief Frees a child process object.
+ * @param process Child process to free.
+ * @since 0.0.5
+ *
+ * All the redirected streams are closed. The child process itself is neither
+ * waited for nor terminated, on POSIX systems it remains a zombie after the
+ * exit unless it was waited for with p_process_wait() before.
+ */
+P_LIB_API void		p_process_free			(PProcess		*process);
+
 P_END_DECLS
 
 #endif /* PLIBSYS_HEADER_PPROCESS_H */
@@ -0,0 +1,435 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* The algorithm is by Dmitry Vyukov. A slot of position pos is free for the
+ * producer when its sequence equals pos, and holds a pointer for the consumer
+ * when its sequence equals pos + 1. The consumer makes it free for the next
+ * round by setting the sequence to pos + capacity. Positions only grow, so a
+ * producer seeing a sequence behind its position knows the queue is full, and
+ * a consumer seeing one behind knows it is empty.
+ *
+ * Sleeping threads register in a waiters counter under the mutex and check the
+ * queue again before sleeping, while the waking side changes the queue and
+ * then reads the counter: a full barrier on both sides makes at least one of
+ * them see the other. */
+
+#include "patomic.h"
+#include "pcondvariable.h"
+#include "pmem.h"
+#include "pmutex.h"
+#include "ptimeprofiler.h"
+#include "pqueuempmc.h"
+
+#define P_QUEUE_MPMC_MIN_CAPACITY	2
+
+typedef struct PQueueMPMCSlot_ {
+	volatile psize	sequence;
+	ppointer	data;
+} PQueueMPMCSlot;
+
+struct PQueueMPMC_ {
+	volatile psize	tail;
+	pchar		pad_tail[P_MEM_CACHE_LINE_SIZE - sizeof (psize)];
+	volatile psize	head;
+	pchar		pad_head[P_MEM_CACHE_LINE_SIZE - sizeof (psize)];
+	PQueueMPMCSlot	*slots;
+	psize		mask;
+	PMutex		*mutex;
+	PCondVariable	*not_empty;
+	PCondVariable	*not_full;
+	volatile pint	push_waiters;
+	volatile pint	pop_waiters;
+};
+
+static psize pp_queue_mpmc_get_position (const volatile psize *position, PAtomicMemoryOrder order);
+static pboolean pp_queue_mpmc_push (PQueueMPMC *queue, ppointer data);
+static pboolean pp_queue_mpmc_pop (PQueueMPMC *queue, ppointer *data);
+static void pp_queue_mpmc_wake (PQueueMPMC *queue, volatile pint *waiters, PCondVariable *cond, pboolean all);
+static pint pp_queue_mpmc_get_remaining (const PTimeProfiler *profiler, pint timeout);
+static pboolean pp_queue_mpmc_wait (PQueueMPMC *queue, pboolean is_push, ppointer *data, pint timeout);
+
+static psize
+pp_queue_mpmc_get_position (const volatile psize	*position,
+			    PAtomicMemoryOrder		order)
+{
+	return PPOINTER_TO_PSIZE (p_atomic_pointer_get_explicit (position, order));
+}
+
+static pboolean
+pp_queue_mpmc_push (PQueueMPMC	*queue,
+		    ppointer	data)
+{
+	PQueueMPMCSlot	*slot;
+	psize		pos;
+	pssize		diff;
+
+	pos = pp_queue_mpmc_get_position (&queue->tail, P_ATOMIC_MEMORY_ORDER_RELAXED);
+
+	for (;;) {
+		slot = &queue->slots[pos & queue->mask];
+		diff = (pssize) (pp_queue_mpmc_get_position (&slot->sequence, P_ATOMIC_MEMORY_ORDER_ACQUIRE) - pos);
+
+		if (diff == 0) {
+			if (p_atomic_pointer_compare_and_exchange_explicit (&queue->tail,
+									    PSIZE_TO_POINTER (pos),
+									    PSIZE_TO_POINTER (pos + 1),
+									    P_ATOMIC_MEMORY_ORDER_RELAXED) == TRUE)
+				break;
+		} else if (diff < 0)
+			return FALSE;
+
+		pos = pp_queue_mpmc_get_position (&queue->tail, P_ATOMIC_MEMORY_ORDER_RELAXED);
+	}
+
+	slot->data = data;
+	p_atomic_pointer_set_explicit (&slot->sequence, PSIZE_TO_POINTER (pos + 1), P_ATOMIC_MEMORY_ORDER_RELEASE);
+
+	return TRUE;
+}
+
+static pboolean
+pp_queue_mpmc_pop (PQueueMPMC	*queue,
+		   ppointer	*data)
+{
+	PQueueMPMCSlot	*slot;
+	psize		pos;
+	pssize		diff;
+
+	pos = pp_queue_mpmc_get_position (&queue->head, P_ATOMIC_MEMORY_ORDER_RELAXED);
+
+	for (;;) {
+		slot = &queue->slots[pos & queue->mask];
+		diff = (pssize) (pp_queue_mpmc_get_position (&slot->sequence, P_ATOMIC_MEMORY_ORDER_ACQUIRE) - (pos + 1));
+
+		if (diff == 0) {
+			if (p_atomic_pointer_compare_and_exchange_explicit (&queue->head,
+									    PSIZE_TO_POINTER (pos),
+									    PSIZE_TO_POINTER (pos + 1),
+									    P_ATOMIC_MEMORY_ORDER_RELAXED) == TRUE)
+				break;
+		} else if (diff < 0)
+			return FALSE;
+
+		pos = pp_queue_mpmc_get_position (&queue->head, P_ATOMIC_MEMORY_ORDER_RELAXED);
+	}
+
+	*data = slot->data;
+	p_atomic_pointer_set_explicit (&slot->sequence,
+				       PSIZE_TO_POINTER (pos + queue->mask + 1),
+				       P_ATOMIC_MEMORY_ORDER_RELEASE);
+
+	return TRUE;
+}
+
+static void
+pp_queue_mpmc_wake (PQueueMPMC		*queue,
+		    volatile pint	*waiters,
+		    PCondVariable	*cond,
+		    pboolean		all)
+{
+	if (queue->mutex == NULL)
+		return;
+
+	p_atomic_thread_fence (P_ATOMIC_MEMORY_ORDER_SEQ_CST);
+
+	if (p_atomic_int_get_explicit (waiters, P_ATOMIC_MEMORY_ORDER_RELAXED) == 0)
+		return;
+
+	p_mutex_lock (queue->mutex);
+
+	if (all == TRUE)
+		p_cond_variable_broadcast (cond);
+	else
+		p_cond_variable_signal (cond);
+
+	p_mutex_unlock (queue->mutex);
+}
+
+static pint
+pp_queue_mpmc_get_remaining (const PTimeProfiler	*profiler,
+			     pint			timeout)
+{
+	puint64 elapsed;
+
+	if (timeout <= 0)
+		return timeout;
+
+	elapsed = p_time_profiler_elapsed_usecs (profiler) / 1000;
+
+	return elapsed >= (puint64) timeout ? 0 : timeout - (pint) elapsed;
+}
+
+static pboolean
+pp_queue_mpmc_wait (PQueueMPMC	*queue,
+		    pboolean	is_push,
+		    ppointer	*data,
+		    pint	timeout)
+{
+	PTimeProfiler	*profiler;
+	PCondVariable	*cond;
+	volatile pint	*waiters;
+	pboolean	result;
+	pint		remaining;
+
+	if (timeout == 0)
+		return FALSE;
+
+	profiler = NULL;
+
+	if (timeout > 0 && P_UNLIKELY ((profiler = p_time_profiler_new ()) == NULL)) {
+		P_ERROR ("PQueueMPMC::pp_queue_mpmc_wait: failed to allocate time profiler");
+		return FALSE;
+	}
+
+	cond    = is_push ? queue->not_full : queue->not_empty;
+	waiters = is_push ? &queue->push_waiters : &queue->pop_waiters;
+	result  = FALSE;
+
+	p_mutex_lock (queue->mutex);
+	p_atomic_int_inc (waiters);
+
+	for (;;) {
+		p_atomic_thread_fence (P_ATOMIC_MEMORY_ORDER_SEQ_CST);
+
+		if (is_push)
+			result = pp_queue_mpmc_push (queue, *data);
+		else
+			result = pp_queue_mpmc_pop (queue, data);
+
+		if (result == TRUE)
+			break;
+
+		if ((remaining = pp_queue_mpmc_get_remaining (profiler, timeout)) == 0)
+			break;
+
+		if (P_UNLIKELY (p_cond_variable_wait_timed (cond, queue->mutex, remaining) < 0)) {
+			P_ERROR ("PQueueMPMC::pp_queue_mpmc_wait: p_cond_variable_wait_timed() failed");
+			break;
+		}
+	}
+
+	p_atomic_int_add (waiters, -1);
+	p_mutex_unlock (queue->mutex);
+
+	if (profiler != NULL)
+		p_time_profiler_free (profiler);
+
+	return result;
+}
+
+P_LIB_API PQueueMPMC *
+p_queue_mpmc_new (psize		capacity,
+		  pboolean	blocking)
+{
+	PQueueMPMC	*ret;
+	psize		size;
+	psize		i;
+
+	if (P_UNLIKELY (capacity > (P_MAXSIZE / sizeof (PQueueMPMCSlot)) / 2))
+		return NULL;
+
+	for (size = P_QUEUE_MPMC_MIN_CAPACITY; size < capacity; size <<= 1)
+		;
+
+	if (P_UNLIKELY ((ret = p_malloc0_aligned (sizeof (PQueueMPMC), P_MEM_CACHE_LINE_SIZE)) == NULL)) {
+		P_ERROR ("PQueueMPMC::p_queue_mpmc_new: failed to allocate memory");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret->slots = p_malloc0_aligned (sizeof (PQueueMPMCSlot) * size,
+							 P_MEM_CACHE_LINE_SIZE)) == NULL)) {
+		P_ERROR ("PQueueMPMC::p_queue_mpmc_new: failed to allocate memory for slots");
+		p_free_aligned (ret);
+		return NULL;
+	}
+
+	if (blocking == TRUE) {
+		ret->mutex     = p_mutex_new ();
+		ret->not_empty = p_cond_variable_new ();
+		ret->not_full  = p_cond_variable_new ();
+
+		if (P_UNLIKELY (ret->mutex == NULL || ret->not_empty == NULL || ret->not_full == NULL)) {
+			P_ERROR ("PQueueMPMC::p_queue_mpmc_new: failed to allocate blocking primitives");
+			p_queue_mpmc_free (ret);
+			return NULL;
+		}
+	}
+
+	for (i = 0; i < size; ++i)
+		ret->slots[i].sequence = i;
+
+	ret->mask = size - 1;
+
+	return ret;
+}
+
+P_LIB_API pboolean
+p_queue_mpmc_try_push (PQueueMPMC	*queue,
+		       ppointer		data)
+{
+	if (P_UNLIKELY (queue == NULL))
+		return FALSE;
+
+	if (pp_queue_mpmc_push (queue, data) == FALSE)
+		return FALSE;
+
+	pp_queue_mpmc_wake (queue, &queue->pop_waiters, queue->not_empty, FALSE);
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_queue_mpmc_try_pop (PQueueMPMC	*queue,
+		      ppointer		*data)
+{
+	if (P_UNLIKELY (queue == NULL || data == NULL))
+		return FALSE;
+
+	if (pp_queue_mpmc_pop (queue, data) == FALSE)
+		return FALSE;
+
+	pp_queue_mpmc_wake (queue, &queue->push_waiters, queue->not_full, FALSE);
+
+	return TRUE;
+}
+
+P_LIB_API psize
+p_queue_mpmc_try_push_batch (PQueueMPMC	*queue,
+			     ppointer	*data,
+			     psize	count)
+{
+	psize i;
+
+	if (P_UNLIKELY (queue == NULL || data == NULL))
+		return 0;
+
+	for (i = 0; i < count && pp_queue_mpmc_push (queue, data[i]) == TRUE; ++i)
+		;
+
+	if (i > 0)
+		pp_queue_mpmc_wake (queue, &queue->pop_waiters, queue->not_empty, i > 1);
+
+	return i;
+}
+
+P_LIB_API psize
+p_queue_mpmc_try_pop_batch (PQueueMPMC	*queue,
+			    ppointer	*data,
+			    psize	max_count)
+{
+	psize i;
+
+	if (P_UNLIKELY (queue == NULL || data == NULL))
+		return 0;
+
+	for (i = 0; i < max_count && pp_queue_mpmc_pop (queue, &data[i]) == TRUE; ++i)
+		;
+
+	if (i > 0)
+		pp_queue_mpmc_wake (queue, &queue->push_waiters, queue->not_full, i > 1);
+
+	return i;
+}
+
+P_LIB_API pboolean
+p_queue_mpmc_push_wait (PQueueMPMC	*queue,
+			ppointer	data,
+			pint		timeout)
+{
+	if (P_UNLIKELY (queue == NULL || queue->mutex == NULL))
+		return FALSE;
+
+	if (pp_queue_mpmc_push (queue, data) == FALSE &&
+	    pp_queue_mpmc_wait (queue, TRUE, &data, timeout) == FALSE)
+		return FALSE;
+
+	pp_queue_mpmc_wake (queue, &queue->pop_waiters, queue->not_empty, FALSE);
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_queue_mpmc_pop_wait (PQueueMPMC	*queue,
+		       ppointer		*data,
+		       pint		timeout)
+{
+	if (P_UNLIKELY (queue == NULL || data == NULL || queue->mutex == NULL))
+		return FALSE;
+
+	if (pp_queue_mpmc_pop (queue, data) == FALSE &&
+	    pp_queue_mpmc_wait (queue, FALSE, data, timeout) == FALSE)
+		return FALSE;
+
+	pp_queue_mpmc_wake (queue, &queue->push_waiters, queue->not_full, FALSE);
+
+	return TRUE;
+}
+
+P_LIB_API psize
+p_queue_mpmc_get_capacity (const PQueueMPMC *queue)
+{
+	if (P_UNLIKELY (queue == NULL))
+		return 0;
+
+	return queue->mask + 1;
+}
+
+P_LIB_API psize
+p_queue_mpmc_get_size (const PQueueMPMC *queue)
+{
+	psize head;
+	psize tail;
+
+	if (P_UNLIKELY (queue == NULL))
+		return 0;
+
+	head = pp_queue_mpmc_get_position (&queue->head, P_ATOMIC_MEMORY_ORDER_ACQUIRE);
+	tail = pp_queue_mpmc_get_position (&queue->tail, P_ATOMIC_MEMORY_ORDER_ACQUIRE);
+
+	/* Both positions move while reading them */
+	if (tail <= head)
+		return 0;
+
+	return tail - head > queue->mask + 1 ? queue->mask + 1 : tail - head;
+}
+
+P_LIB_API void
+p_queue_mpmc_free (PQueueMPMC *queue)
+{
+	if (P_UNLIKELY (queue == NULL))
+		return;
+
+	if (queue->mutex != NULL)
+		p_mutex_free (queue->mutex);
+
+	if (queue->not_empty != NULL)
+		p_cond_variable_free (queue->not_empty);
+
+	if (queue->not_full != NULL)
+		p_cond_variable_free (queue->not_full);
+
+	p_free_aligned (queue->slots);
+	p_free_aligned (queue);
+}
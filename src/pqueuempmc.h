@@ -0,0 +1,190 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pqueuempmc.h
+ * @brief Bounded lock-free multi-producer multi-consumer queue
+ * @author Alexander Saprykin
+ *
+ * A multi-producer multi-consumer queue passes pointers between any number of
+ * threads without a lock. It is a ring of a fixed capacity where every slot
+ * carries a sequence number: a producer claims the next free slot with a
+ * single compare and exchange on the tail position, stores the pointer and
+ * publishes it by advancing the slot sequence, a consumer does the same on the
+ * head position. Producers and consumers meet only in the slots, and the two
+ * positions live on separate cache lines.
+ *
+ * p_queue_mpmc_try_push() fails if the queue is full, p_queue_mpmc_try_pop()
+ * fails if it is empty, neither of them ever waits. The batch calls move
+ * several pointers at once and return how many they moved. Pointers pushed by
+ * a single producer are popped in the order they were pushed.
+ *
+ * A queue created with the blocking support also has p_queue_mpmc_push_wait()
+ * and p_queue_mpmc_pop_wait() which sleep until there is a free slot or a
+ * pointer to pop, with a timeout. The sleeping threads are woken by any push
+ * or pop call on the queue, so the non-blocking calls pay for a memory barrier
+ * to check for them. Without the blocking support the waiting calls fail.
+ *
+ * NULL pointers can be queued as well.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PQUEUEMPMC_H
+#define PLIBSYS_HEADER_PQUEUEMPMC_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+
+P_BEGIN_DECLS
+
+/** Multi-producer multi-consumer queue opaque data type. */
+typedef struct PQueueMPMC_ PQueueMPMC;
+
+/**
+ * @brief Creates a new multi-producer multi-consumer queue.
+ * @param capacity Maximum number of queued pointers, rounded up to a power
+ * of two, at least 2.
+ * @param blocking Whether to support p_queue_mpmc_push_wait() and
+ * p_queue_mpmc_pop_wait().
+ * @return Pointer to #PQueueMPMC in case of success, NULL otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API PQueueMPMC *	p_queue_mpmc_new		(psize		capacity,
+							 pboolean	blocking);
+
+/**
+ * @brief Pushes a pointer into a queue without waiting.
+ * @param queue #PQueueMPMC to push into.
+ * @param data Pointer to push.
+ * @return TRUE in case of success, FALSE if the queue is full.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_queue_mpmc_try_push		(PQueueMPMC	*queue,
+							 ppointer	data);
+
+/**
+ * @brief Pops a pointer from a queue without waiting.
+ * @param queue #PQueueMPMC to pop from.
+ * @param[out] data Popped pointer.
+ * @return TRUE in case of success, FALSE if the queue is empty.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_queue_mpmc_try_pop		(PQueueMPMC	*queue,
+							 ppointer	*data);
+
+/**
+ * @brief Pushes several pointers into a queue without waiting.
+ * @param queue #PQueueMPMC to push into.
+ * @param data Array of pointers to push.
+ * @param count Number of pointers in @a data.
+ * @return Number of pointers pushed from the start of @a data, less than
+ * @a count if the queue became full.
+ * @since 0.0.5
+ *
+ * The batch is not pushed atomically: pointers from other producers may come
+ * in between.
+ */
+P_LIB_API psize		p_queue_mpmc_try_push_batch	(PQueueMPMC	*queue,
+							 ppointer	*data,
+							 psize		count);
+
+/**
+ * @brief Pops several pointers from a queue without waiting.
+ * @param queue #PQueueMPMC to pop from.
+ * @param[out] data Array to store the popped pointers in.
+ * @param max_count Size of @a data.
+ * @return Number of pointers stored in @a data, less than @a max_count if the
+ * queue became empty.
+ * @since 0.0.5
+ */
+P_LIB_API psize		p_queue_mpmc_try_pop_batch	(PQueueMPMC	*queue,
+							 ppointer	*data,
+							 psize		max_count);
+
+/**
+ * @brief Pushes a pointer into a queue, waiting for a free slot.
+ * @param queue #PQueueMPMC to push into.
+ * @param data Pointer to push.
+ * @param timeout Timeout in milliseconds, -1 to wait infinitely, 0 to return
+ * immediately.
+ * @return TRUE in case of success, FALSE on timeout or error.
+ * @since 0.0.5
+ *
+ * The queue must be created with the blocking support.
+ */
+P_LIB_API pboolean	p_queue_mpmc_push_wait		(PQueueMPMC	*queue,
+							 ppointer	data,
+							 pint		timeout);
+
+/**
+ * @brief Pops a pointer from a queue, waiting for a pointer to pop.
+ * @param queue #PQueueMPMC to pop from.
+ * @param[out] data Popped pointer.
+ * @param timeout Timeout in milliseconds, -1 to wait infinitely, 0 to return
+ * immediately.
+ * @return TRUE in case of success, FALSE on timeout or error.
+ * @since 0.0.5
+ *
+ * The queue must be created with the blocking support.
+ */
+P_LIB_API pboolean	p_queue_mpmc_pop_wait		(PQueueMPMC	*queue,
+							 ppointer	*data,
+							 pint		timeout);
+
+/**
+ * @brief Gets the capacity of a queue.
+ * @param queue #PQueueMPMC to get the capacity for.
+ * @return Maximum number of queued pointers.
+ * @since 0.0.5
+ */
+P_LIB_API psize		p_queue_mpmc_get_capacity	(const PQueueMPMC	*queue);
+
+/**
+ * @brief Gets the number of pointers in a queue.
+ * @param queue #PQueueMPMC to get the number for.
+ * @return Number of queued pointers.
+ * @since 0.0.5
+ *
+ * The number is only a snapshot: other threads may change the queue at the
+ * same time.
+ */
+P_LIB_API psize		p_queue_mpmc_get_size		(const PQueueMPMC	*queue);
+
+/**
+ * @brief Frees a queue.
+ * @param queue #PQueueMPMC to free.
+ * @since 0.0.5
+ *
+ * The queued pointers are not freed. No thread should use the queue at that
+ * moment.
+ */
+P_LIB_API void		p_queue_mpmc_free		(PQueueMPMC	*queue);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PQUEUEMPMC_H */
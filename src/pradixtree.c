@@ -0,0 +1,1184 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* The adaptive radix tree follows "The Adaptive Radix Tree: ARTful Indexing
+ * for Main-Memory Databases" (Leis et al., ICDE 2013). Child pointers are
+ * tagged: a set lowest bit marks a leaf, which holds a copy of the whole key,
+ * so a path may end with a leaf as soon as it becomes unique.
+ *
+ * Inner nodes keep the compressed path in the hybrid way: the full length of
+ * the shared prefix is stored, but only its first P_RADIX_TREE_MAX_PREFIX bytes.
+ * Lookups skip the rest optimistically and verify the leaf key at the end,
+ * while modifications load the missing bytes from any leaf below the node.
+ *
+ * A key which ends exactly at an inner node (i.e. it is a prefix of the other
+ * keys) is kept in the node's own leaf slot. */
+
+#include "pmem.h"
+#include "pradixtree.h"
+
+#include <string.h>
+
+#if defined (P_CPU_X86_64) || defined (__SSE2__) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define P_RADIX_TREE_SSE2
+#elif defined (P_CPU_ARM_64)
+#  include <arm_neon.h>
+#  define P_RADIX_TREE_NEON
+#endif
+
+#ifdef P_CC_MSVC
+#  include <intrin.h>
+#endif
+
+#define P_RADIX_TREE_MAX_PREFIX		((psize) 8)
+
+#define P_RADIX_TREE_MIN(a, b)		((a) < (b) ? (a) : (b))
+
+#define P_RADIX_TREE_IS_LEAF(p)		((PPOINTER_TO_PSIZE (p) & 1) != 0)
+#define P_RADIX_TREE_TO_LEAF(p)		((PRadixTreeLeaf *) PSIZE_TO_POINTER (PPOINTER_TO_PSIZE (p) & ~((psize) 1)))
+#define P_RADIX_TREE_FROM_LEAF(l)	PSIZE_TO_POINTER (PPOINTER_TO_PSIZE (l) | 1)
+#define P_RADIX_TREE_LEAF_KEY(l)	((puint8 *) ((l) + 1))
+
+typedef enum PRadixTreeNodeType_ {
+	P_RADIX_TREE_NODE4	= 0,
+	P_RADIX_TREE_NODE16	= 1,
+	P_RADIX_TREE_NODE48	= 2,
+	P_RADIX_TREE_NODE256	= 3
+} PRadixTreeNodeType;
+
+typedef enum PRadixTreeInsertResult_ {
+	P_RADIX_TREE_INSERT_FAILED	= 0,
+	P_RADIX_TREE_INSERT_NEW		= 1,
+	P_RADIX_TREE_INSERT_REPLACED	= 2
+} PRadixTreeInsertResult;
+
+/* The key bytes follow the structure */
+typedef struct PRadixTreeLeaf_ {
+	ppointer	value;
+	psize		key_len;
+} PRadixTreeLeaf;
+
+typedef struct PRadixTreeNode_ {
+	puint8		type;
+	puint16		count;
+	psize		prefix_len;
+	puint8		prefix[P_RADIX_TREE_MAX_PREFIX];
+	PRadixTreeLeaf	*leaf;
+} PRadixTreeNode;
+
+typedef struct PRadixTreeNode4_ {
+	PRadixTreeNode	node;
+	puint8		keys[4];
+	ppointer	children[4];
+} PRadixTreeNode4;
+
+typedef struct PRadixTreeNode16_ {
+	PRadixTreeNode	node;
+	puint8		keys[16];
+	ppointer	children[16];
+} PRadixTreeNode16;
+
+/* Index holds a child position plus one, zero for an empty slot */
+typedef struct PRadixTreeNode48_ {
+	PRadixTreeNode	node;
+	puint8		index[256];
+	ppointer	children[48];
+} PRadixTreeNode48;
+
+typedef struct PRadixTreeNode256_ {
+	PRadixTreeNode	node;
+	ppointer	children[256];
+} PRadixTreeNode256;
+
+struct PRadixTree_ {
+	ppointer	root;
+	psize		count;
+	PDestroyFunc	value_destroy;
+};
+
+static puint pp_radix_tree_ctz (puint32 mask);
+static PRadixTreeNode * pp_radix_tree_node_new (PRadixTreeNodeType type);
+static void pp_radix_tree_copy_header (PRadixTreeNode *dst, const PRadixTreeNode *src);
+static pboolean pp_radix_tree_leaf_matches (const PRadixTreeLeaf *leaf, const puint8 *key, psize key_len);
+static pboolean pp_radix_tree_leaf_is_prefix (const PRadixTreeLeaf *leaf, const puint8 *key, psize key_len);
+static ppointer * pp_radix_tree_find_child (PRadixTreeNode *node, puint8 c);
+static PRadixTreeLeaf * pp_radix_tree_minimum (ppointer p);
+static psize pp_radix_tree_check_prefix (const PRadixTreeNode *node, const puint8 *key, psize key_len, psize depth);
+static psize pp_radix_tree_prefix_mismatch (const PRadixTreeNode *node, const puint8 *key, psize key_len, psize depth);
+static pboolean pp_radix_tree_add_child (ppointer *ref, PRadixTreeNode *node, puint8 c, ppointer child);
+static void pp_radix_tree_attach_leaf (PRadixTreeNode *node, PRadixTreeLeaf *leaf, psize depth);
+static void pp_radix_tree_remove_child (ppointer *ref, PRadixTreeNode *node, puint8 c, ppointer *slot);
+static void pp_radix_tree_compact (ppointer *ref, PRadixTreeNode *node);
+static PRadixTreeInsertResult pp_radix_tree_insert_leaf (PRadixTree *tree, PRadixTreeLeaf *new_leaf);
+static void pp_radix_tree_free_leaf (PRadixTree *tree, PRadixTreeLeaf *leaf);
+static void pp_radix_tree_free_node (PRadixTree *tree, ppointer p);
+static pboolean pp_radix_tree_traverse (ppointer p, PRadixTreeTraverseFunc func, ppointer user_data);
+
+static puint
+pp_radix_tree_ctz (puint32 mask)
+{
+#if defined (P_CC_GNU) || defined (P_CC_CLANG)
+	return (puint) __builtin_ctz (mask);
+#elif defined (P_CC_MSVC)
+	unsigned long idx;
+
+	_BitScanForward (&idx, mask);
+
+	return (puint) idx;
+#else
+	puint idx;
+
+	for (idx = 0; (mask & 1) == 0; mask >>= 1)
+		++idx;
+
+	return idx;
+#endif
+}
+
+static PRadixTreeNode *
+pp_radix_tree_node_new (PRadixTreeNodeType type)
+{
+	PRadixTreeNode	*ret;
+	psize		size;
+
+	switch (type) {
+	case P_RADIX_TREE_NODE4:
+		size = sizeof (PRadixTreeNode4);
+		break;
+	case P_RADIX_TREE_NODE16:
+		size = sizeof (PRadixTreeNode16);
+		break;
+	case P_RADIX_TREE_NODE48:
+		size = sizeof (PRadixTreeNode48);
+		break;
+	default:
+		size = sizeof (PRadixTreeNode256);
+		break;
+	}
+
+	if (P_UNLIKELY ((ret = p_malloc0 (size)) == NULL))
+		return NULL;
+
+	ret->type = (puint8) type;
+
+	return ret;
+}
+
+static void
+pp_radix_tree_copy_header (PRadixTreeNode	*dst,
+			   const PRadixTreeNode	*src)
+{
+	dst->count      = src->count;
+	dst->prefix_len = src->prefix_len;
+	dst->leaf       = src->leaf;
+
+	memcpy (dst->prefix, src->prefix, P_RADIX_TREE_MAX_PREFIX);
+}
+
+static pboolean
+pp_radix_tree_leaf_matches (const PRadixTreeLeaf	*leaf,
+			    const puint8		*key,
+			    psize			key_len)
+{
+	return leaf->key_len == key_len &&
+	       (key_len == 0 || memcmp (P_RADIX_TREE_LEAF_KEY (leaf), key, key_len) == 0);
+}
+
+static pboolean
+pp_radix_tree_leaf_is_prefix (const PRadixTreeLeaf	*leaf,
+			      const puint8		*key,
+			      psize			key_len)
+{
+	return leaf->key_len <= key_len &&
+	       (leaf->key_len == 0 || memcmp (P_RADIX_TREE_LEAF_KEY (leaf), key, leaf->key_len) == 0);
+}
+
+static ppointer *
+pp_radix_tree_find_child (PRadixTreeNode	*node,
+			  puint8		c)
+{
+	puint i;
+
+	switch (node->type) {
+	case P_RADIX_TREE_NODE4:
+	{
+		PRadixTreeNode4 *n4 = (PRadixTreeNode4 *) node;
+
+		for (i = 0; i < node->count; ++i) {
+			if (n4->keys[i] == c)
+				return &n4->children[i];
+		}
+
+		return NULL;
+	}
+	case P_RADIX_TREE_NODE16:
+	{
+		PRadixTreeNode16 *n16 = (PRadixTreeNode16 *) node;
+#if defined (P_RADIX_TREE_SSE2)
+		__m128i	cmp;
+		puint32	mask;
+
+		cmp  = _mm_cmpeq_epi8 (_mm_set1_epi8 ((char) c), _mm_loadu_si128 ((const __m128i *) n16->keys));
+		mask = ((puint32) _mm_movemask_epi8 (cmp)) & ((1U << node->count) - 1);
+
+		return mask != 0 ? &n16->children[pp_radix_tree_ctz (mask)] : NULL;
+#elif defined (P_RADIX_TREE_NEON)
+		static const puint8 lanes[16] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
+
+		uint8x16_t cmp;
+
+		/* Non-matching lanes become 0xFF, so the minimum is the first match */
+		cmp = vceqq_u8 (vdupq_n_u8 (c), vld1q_u8 (n16->keys));
+		i   = vminvq_u8 (vbslq_u8 (cmp, vld1q_u8 (lanes), vdupq_n_u8 (0xFF)));
+
+		return i < node->count ? &n16->children[i] : NULL;
+#else
+		for (i = 0; i < node->count; ++i) {
+			if (n16->keys[i] == c)
+				return &n16->children[i];
+		}
+
+		return NULL;
+#endif
+	}
+	case P_RADIX_TREE_NODE48:
+	{
+		PRadixTreeNode48 *n48 = (PRadixTreeNode48 *) node;
+
+		return n48->index[c] != 0 ? &n48->children[n48->index[c] - 1] : NULL;
+	}
+	default:
+	{
+		PRadixTreeNode256 *n256 = (PRadixTreeNode256 *) node;
+
+		return n256->children[c] != NULL ? &n256->children[c] : NULL;
+	}
+	}
+}
+
+static PRadixTreeLeaf *
+pp_radix_tree_minimum (ppointer p)
+{
+	PRadixTreeNode	*node;
+	puint		i;
+
+	while (!P_RADIX_TREE_IS_LEAF (p)) {
+		node = (PRadixTreeNode *) p;
+
+		if (node->leaf != NULL)
+			return node->leaf;
+
+		switch (node->type) {
+		case P_RADIX_TREE_NODE4:
+			p = ((PRadixTreeNode4 *) node)->children[0];
+			break;
+		case P_RADIX_TREE_NODE16:
+			p = ((PRadixTreeNode16 *) node)->children[0];
+			break;
+		case P_RADIX_TREE_NODE48:
+			for (i = 0; ((PRadixTreeNode48 *) node)->index[i] == 0; ++i)
+				;
+
+			p = ((PRadixTreeNode48 *) node)->children[((PRadixTreeNode48 *) node)->index[i] - 1];
+			break;
+		default:
+			for (i = 0; ((PRadixTreeNode256 *) node)->children[i] == NULL; ++i)
+				;
+
+			p = ((PRadixTreeNode256 *) node)->children[i];
+			break;
+		}
+	}
+
+	return P_RADIX_TREE_TO_LEAF (p);
+}
+
+/* Compares only the stored part of the prefix */
+static psize
+pp_radix_tree_check_prefix (const PRadixTreeNode	*node,
+			    const puint8		*key,
+			    psize			key_len,
+			    psize			depth)
+{
+	psize max_cmp;
+	psize i;
+
+	max_cmp = P_RADIX_TREE_MIN (P_RADIX_TREE_MIN (node->prefix_len, P_RADIX_TREE_MAX_PREFIX), key_len - depth);
+
+	for (i = 0; i < max_cmp; ++i) {
+		if (node->prefix[i] != key[depth + i])
+			return i;
+	}
+
+	return i;
+}
+
+/* Compares the whole prefix, loading the bytes which are not stored from a leaf */
+static psize
+pp_radix_tree_prefix_mismatch (const PRadixTreeNode	*node,
+			       const puint8		*key,
+			       psize			key_len,
+			       psize			depth)
+{
+	const PRadixTreeLeaf	*leaf;
+	psize			max_cmp;
+	psize			i;
+
+	i = pp_radix_tree_check_prefix (node, key, key_len, depth);
+
+	if (i < P_RADIX_TREE_MAX_PREFIX || node->prefix_len <= P_RADIX_TREE_MAX_PREFIX)
+		return i;
+
+	leaf    = pp_radix_tree_minimum ((ppointer) node);
+	max_cmp = P_RADIX_TREE_MIN (node->prefix_len, key_len - depth);
+
+	for (; i < max_cmp; ++i) {
+		if (P_RADIX_TREE_LEAF_KEY (leaf)[depth + i] != key[depth + i])
+			return i;
+	}
+
+	return i;
+}
+
+static pboolean
+pp_radix_tree_add_child (ppointer		*ref,
+			 PRadixTreeNode		*node,
+			 puint8			c,
+			 ppointer		child)
+{
+	PRadixTreeNode	*grown;
+	puint		i;
+
+	switch (node->type) {
+	case P_RADIX_TREE_NODE4:
+	{
+		PRadixTreeNode4 *n4 = (PRadixTreeNode4 *) node;
+
+		if (node->count < 4) {
+			for (i = 0; i < node->count && n4->keys[i] < c; ++i)
+				;
+
+			memmove (n4->keys + i + 1, n4->keys + i, node->count - i);
+			memmove (n4->children + i + 1, n4->children + i, (node->count - i) * sizeof (ppointer));
+
+			n4->keys[i]     = c;
+			n4->children[i] = child;
+			++node->count;
+
+			return TRUE;
+		}
+
+		if (P_UNLIKELY ((grown = pp_radix_tree_node_new (P_RADIX_TREE_NODE16)) == NULL))
+			return FALSE;
+
+		pp_radix_tree_copy_header (grown, node);
+
+		memcpy (((PRadixTreeNode16 *) grown)->keys, n4->keys, 4);
+		memcpy (((PRadixTreeNode16 *) grown)->children, n4->children, 4 * sizeof (ppointer));
+		break;
+	}
+	case P_RADIX_TREE_NODE16:
+	{
+		PRadixTreeNode16 *n16 = (PRadixTreeNode16 *) node;
+
+		if (node->count < 16) {
+			for (i = 0; i < node->count && n16->keys[i] < c; ++i)
+				;
+
+			memmove (n16->keys + i + 1, n16->keys + i, node->count - i);
+			memmove (n16->children + i + 1, n16->children + i, (node->count - i) * sizeof (ppointer));
+
+			n16->keys[i]     = c;
+			n16->children[i] = child;
+			++node->count;
+
+			return TRUE;
+		}
+
+		if (P_UNLIKELY ((grown = pp_radix_tree_node_new (P_RADIX_TREE_NODE48)) == NULL))
+			return FALSE;
+
+		pp_radix_tree_copy_header (grown, node);
+
+		for (i = 0; i < 16; ++i)
+			((PRadixTreeNode48 *) grown)->index[n16->keys[i]] = (puint8) (i + 1);
+
+		memcpy (((PRadixTreeNode48 *) grown)->children, n16->children, 16 * sizeof (ppointer));
+		break;
+	}
+	case P_RADIX_TREE_NODE48:
+	{
+		PRadixTreeNode48 *n48 = (PRadixTreeNode48 *) node;
+
+		if (node->count < 48) {
+			for (i = 0; n48->children[i] != NULL; ++i)
+				;
+
+			n48->children[i] = child;
+			n48->index[c]    = (puint8) (i + 1);
+			++node->count;
+
+			return TRUE;
+		}
+
+		if (P_UNLIKELY ((grown = pp_radix_tree_node_new (P_RADIX_TREE_NODE256)) == NULL))
+			return FALSE;
+
+		pp_radix_tree_copy_header (grown, node);
+
+		for (i = 0; i < 256; ++i) {
+			if (n48->index[i] != 0)
+				((PRadixTreeNode256 *) grown)->children[i] = n48->children[n48->index[i] - 1];
+		}
+		break;
+	}
+	default:
+		((PRadixTreeNode256 *) node)->children[c] = child;
+		++node->count;
+
+		return TRUE;
+	}
+
+	*ref = grown;
+	p_free (node);
+
+	return pp_radix_tree_add_child (ref, grown, c, child);
+}
+
+/* Node must have a room for the leaf */
+static void
+pp_radix_tree_attach_leaf (PRadixTreeNode	*node,
+			   PRadixTreeLeaf	*leaf,
+			   psize		depth)
+{
+	ppointer ref = node;
+
+	if (leaf->key_len == depth)
+		node->leaf = leaf;
+	else
+		pp_radix_tree_add_child (&ref,
+					 node,
+					 P_RADIX_TREE_LEAF_KEY (leaf)[depth],
+					 P_RADIX_TREE_FROM_LEAF (leaf));
+}
+
+static void
+pp_radix_tree_remove_child (ppointer		*ref,
+			    PRadixTreeNode	*node,
+			    puint8		c,
+			    ppointer		*slot)
+{
+	PRadixTreeNode	*shrunk;
+	puint		pos;
+	puint		i;
+
+	switch (node->type) {
+	case P_RADIX_TREE_NODE4:
+	{
+		PRadixTreeNode4 *n4 = (PRadixTreeNode4 *) node;
+
+		pos = (puint) (slot - n4->children);
+
+		memmove (n4->keys + pos, n4->keys + pos + 1, node->count - pos - 1);
+		memmove (n4->children + pos, n4->children + pos + 1, (node->count - pos - 1) * sizeof (ppointer));
+		--node->count;
+
+		pp_radix_tree_compact (ref, node);
+		return;
+	}
+	case P_RADIX_TREE_NODE16:
+	{
+		PRadixTreeNode16 *n16 = (PRadixTreeNode16 *) node;
+
+		pos = (puint) (slot - n16->children);
+
+		memmove (n16->keys + pos, n16->keys + pos + 1, node->count - pos - 1);
+		memmove (n16->children + pos, n16->children + pos + 1, (node->count - pos - 1) * sizeof (ppointer));
+		--node->count;
+
+		/* A failed shrinking only leaves the larger node in place */
+		if (node->count > 3 || (shrunk = pp_radix_tree_node_new (P_RADIX_TREE_NODE4)) == NULL)
+			return;
+
+		pp_radix_tree_copy_header (shrunk, node);
+
+		memcpy (((PRadixTreeNode4 *) shrunk)->keys, n16->keys, 3);
+		memcpy (((PRadixTreeNode4 *) shrunk)->children, n16->children, 3 * sizeof (ppointer));
+		break;
+	}
+	case P_RADIX_TREE_NODE48:
+	{
+		PRadixTreeNode48 *n48 = (PRadixTreeNode48 *) node;
+
+		n48->children[n48->index[c] - 1] = NULL;
+		n48->index[c] = 0;
+		--node->count;
+
+		if (node->count > 12 || (shrunk = pp_radix_tree_node_new (P_RADIX_TREE_NODE16)) == NULL)
+			return;
+
+		pp_radix_tree_copy_header (shrunk, node);
+
+		for (i = 0, pos = 0; i < 256; ++i) {
+			if (n48->index[i] == 0)
+				continue;
+
+			((PRadixTreeNode16 *) shrunk)->keys[pos]     = (puint8) i;
+			((PRadixTreeNode16 *) shrunk)->children[pos] = n48->children[n48->index[i] - 1];
+			++pos;
+		}
+		break;
+	}
+	default:
+	{
+		PRadixTreeNode256 *n256 = (PRadixTreeNode256 *) node;
+
+		n256->children[c] = NULL;
+		--node->count;
+
+		if (node->count > 37 || (shrunk = pp_radix_tree_node_new (P_RADIX_TREE_NODE48)) == NULL)
+			return;
+
+		pp_radix_tree_copy_header (shrunk, node);
+
+		for (i = 0, pos = 0; i < 256; ++i) {
+			if (n256->children[i] == NULL)
+				continue;
+
+			((PRadixTreeNode48 *) shrunk)->index[i]      = (puint8) (pos + 1);
+			((PRadixTreeNode48 *) shrunk)->children[pos] = n256->children[i];
+			++pos;
+		}
+		break;
+	}
+	}
+
+	*ref = shrunk;
+	p_free (node);
+}
+
+/* Replaces a node with a single entry by the entry itself */
+static void
+pp_radix_tree_compact (ppointer		*ref,
+		       PRadixTreeNode	*node)
+{
+	PRadixTreeNode4	*n4 = (PRadixTreeNode4 *) node;
+	PRadixTreeNode	*child;
+	puint8		prefix[P_RADIX_TREE_MAX_PREFIX];
+	psize		stored;
+	psize		len;
+
+	if (node->type != P_RADIX_TREE_NODE4 || node->count + (node->leaf != NULL ? 1 : 0) != 1)
+		return;
+
+	if (node->leaf != NULL) {
+		*ref = P_RADIX_TREE_FROM_LEAF (node->leaf);
+		p_free (node);
+		return;
+	}
+
+	if (P_RADIX_TREE_IS_LEAF (n4->children[0])) {
+		*ref = n4->children[0];
+		p_free (node);
+		return;
+	}
+
+	/* The child path becomes: node prefix, the key byte, child prefix */
+	child  = (PRadixTreeNode *) n4->children[0];
+	stored = P_RADIX_TREE_MIN (node->prefix_len, P_RADIX_TREE_MAX_PREFIX);
+
+	memcpy (prefix, node->prefix, stored);
+
+	if (stored < P_RADIX_TREE_MAX_PREFIX) {
+		prefix[stored++] = n4->keys[0];
+
+		len = P_RADIX_TREE_MIN (child->prefix_len, P_RADIX_TREE_MAX_PREFIX - stored);
+		memcpy (prefix + stored, child->prefix, len);
+		stored += len;
+	}
+
+	memcpy (child->prefix, prefix, stored);
+	child->prefix_len += node->prefix_len + 1;
+
+	*ref = child;
+	p_free (node);
+}
+
+static PRadixTreeInsertResult
+pp_radix_tree_insert_leaf (PRadixTree		*tree,
+			   PRadixTreeLeaf	*new_leaf)
+{
+	const puint8	*key     = P_RADIX_TREE_LEAF_KEY (new_leaf);
+	psize		key_len  = new_leaf->key_len;
+	ppointer	*ref     = &tree->root;
+	psize		depth    = 0;
+	PRadixTreeNode	*node;
+	PRadixTreeNode	*split;
+	PRadixTreeLeaf	*leaf;
+	ppointer	*child;
+	psize		limit;
+	psize		diff;
+	puint8		c;
+
+	for (;;) {
+		if (*ref == NULL) {
+			*ref = P_RADIX_TREE_FROM_LEAF (new_leaf);
+			return P_RADIX_TREE_INSERT_NEW;
+		}
+
+		if (P_RADIX_TREE_IS_LEAF (*ref)) {
+			leaf = P_RADIX_TREE_TO_LEAF (*ref);
+
+			if (pp_radix_tree_leaf_matches (leaf, key, key_len)) {
+				if (tree->value_destroy != NULL && leaf->value != new_leaf->value)
+					tree->value_destroy (leaf->value);
+
+				leaf->value = new_leaf->value;
+
+				return P_RADIX_TREE_INSERT_REPLACED;
+			}
+
+			/* Two keys share a path now: split it at their common prefix */
+			if (P_UNLIKELY ((split = pp_radix_tree_node_new (P_RADIX_TREE_NODE4)) == NULL))
+				return P_RADIX_TREE_INSERT_FAILED;
+
+			limit = P_RADIX_TREE_MIN (leaf->key_len, key_len);
+
+			for (diff = depth; diff < limit && P_RADIX_TREE_LEAF_KEY (leaf)[diff] == key[diff]; ++diff)
+				;
+
+			split->prefix_len = diff - depth;
+			memcpy (split->prefix, key + depth, P_RADIX_TREE_MIN (split->prefix_len, P_RADIX_TREE_MAX_PREFIX));
+
+			pp_radix_tree_attach_leaf (split, leaf, diff);
+			pp_radix_tree_attach_leaf (split, new_leaf, diff);
+
+			*ref = split;
+
+			return P_RADIX_TREE_INSERT_NEW;
+		}
+
+		node = (PRadixTreeNode *) *ref;
+
+		if (node->prefix_len > 0) {
+			diff = pp_radix_tree_prefix_mismatch (node, key, key_len, depth);
+
+			if (diff < node->prefix_len) {
+				if (P_UNLIKELY ((split = pp_radix_tree_node_new (P_RADIX_TREE_NODE4)) == NULL))
+					return P_RADIX_TREE_INSERT_FAILED;
+
+				split->prefix_len = diff;
+				memcpy (split->prefix, node->prefix, P_RADIX_TREE_MIN (diff, P_RADIX_TREE_MAX_PREFIX));
+
+				if (node->prefix_len <= P_RADIX_TREE_MAX_PREFIX) {
+					c = node->prefix[diff];
+
+					node->prefix_len -= diff + 1;
+					memmove (node->prefix, node->prefix + diff + 1, node->prefix_len);
+				} else {
+					leaf = pp_radix_tree_minimum (node);
+					c    = P_RADIX_TREE_LEAF_KEY (leaf)[depth + diff];
+
+					node->prefix_len -= diff + 1;
+					memcpy (node->prefix,
+						P_RADIX_TREE_LEAF_KEY (leaf) + depth + diff + 1,
+						P_RADIX_TREE_MIN (node->prefix_len, P_RADIX_TREE_MAX_PREFIX));
+				}
+
+				*ref = split;
+
+				pp_radix_tree_add_child (ref, split, c, node);
+				pp_radix_tree_attach_leaf (split, new_leaf, depth + diff);
+
+				return P_RADIX_TREE_INSERT_NEW;
+			}
+
+			depth += node->prefix_len;
+		}
+
+		if (depth == key_len) {
+			if (node->leaf != NULL) {
+				if (tree->value_destroy != NULL && node->leaf->value != new_leaf->value)
+					tree->value_destroy (node->leaf->value);
+
+				node->leaf->value = new_leaf->value;
+
+				return P_RADIX_TREE_INSERT_REPLACED;
+			}
+
+			node->leaf = new_leaf;
+
+			return P_RADIX_TREE_INSERT_NEW;
+		}
+
+		if ((child = pp_radix_tree_find_child (node, key[depth])) == NULL) {
+			if (P_UNLIKELY (pp_radix_tree_add_child (ref,
+								 node,
+								 key[depth],
+								 P_RADIX_TREE_FROM_LEAF (new_leaf)) == FALSE))
+				return P_RADIX_TREE_INSERT_FAILED;
+
+			return P_RADIX_TREE_INSERT_NEW;
+		}
+
+		ref = child;
+		++depth;
+	}
+}
+
+static void
+pp_radix_tree_free_leaf (PRadixTree		*tree,
+			 PRadixTreeLeaf		*leaf)
+{
+	if (tree->value_destroy != NULL)
+		tree->value_destroy (leaf->value);
+
+	p_free (leaf);
+}
+
+static void
+pp_radix_tree_free_node (PRadixTree	*tree,
+			 ppointer	p)
+{
+	PRadixTreeNode	*node;
+	puint		i;
+
+	if (P_RADIX_TREE_IS_LEAF (p)) {
+		pp_radix_tree_free_leaf (tree, P_RADIX_TREE_TO_LEAF (p));
+		return;
+	}
+
+	node = (PRadixTreeNode *) p;
+
+	if (node->leaf != NULL)
+		pp_radix_tree_free_leaf (tree, node->leaf);
+
+	switch (node->type) {
+	case P_RADIX_TREE_NODE4:
+		for (i = 0; i < node->count; ++i)
+			pp_radix_tree_free_node (tree, ((PRadixTreeNode4 *) node)->children[i]);
+		break;
+	case P_RADIX_TREE_NODE16:
+		for (i = 0; i < node->count; ++i)
+			pp_radix_tree_free_node (tree, ((PRadixTreeNode16 *) node)->children[i]);
+		break;
+	case P_RADIX_TREE_NODE48:
+		for (i = 0; i < 48; ++i) {
+			if (((PRadixTreeNode48 *) node)->children[i] != NULL)
+				pp_radix_tree_free_node (tree, ((PRadixTreeNode48 *) node)->children[i]);
+		}
+		break;
+	default:
+		for (i = 0; i < 256; ++i) {
+			if (((PRadixTreeNode256 *) node)->children[i] != NULL)
+				pp_radix_tree_free_node (tree, ((PRadixTreeNode256 *) node)->children[i]);
+		}
+		break;
+	}
+
+	p_free (node);
+}
+
+static pboolean
+pp_radix_tree_traverse (ppointer		p,
+			PRadixTreeTraverseFunc	func,
+			ppointer		user_data)
+{
+	PRadixTreeNode	*node;
+	PRadixTreeLeaf	*leaf;
+	puint		i;
+
+	if (P_RADIX_TREE_IS_LEAF (p)) {
+		leaf = P_RADIX_TREE_TO_LEAF (p);
+		return func (P_RADIX_TREE_LEAF_KEY (leaf), leaf->key_len, leaf->value, user_data);
+	}
+
+	node = (PRadixTreeNode *) p;
+
+	/* The key ending at the node is a prefix of all the others below */
+	if (node->leaf != NULL &&
+	    func (P_RADIX_TREE_LEAF_KEY (node->leaf), node->leaf->key_len, node->leaf->value, user_data) == TRUE)
+		return TRUE;
+
+	switch (node->type) {
+	case P_RADIX_TREE_NODE4:
+		for (i = 0; i < node->count; ++i) {
+			if (pp_radix_tree_traverse (((PRadixTreeNode4 *) node)->children[i], func, user_data) == TRUE)
+				return TRUE;
+		}
+		break;
+	case P_RADIX_TREE_NODE16:
+		for (i = 0; i < node->count; ++i) {
+			if (pp_radix_tree_traverse (((PRadixTreeNode16 *) node)->children[i], func, user_data) == TRUE)
+				return TRUE;
+		}
+		break;
+	case P_RADIX_TREE_NODE48:
+	{
+		PRadixTreeNode48 *n48 = (PRadixTreeNode48 *) node;
+
+		for (i = 0; i < 256; ++i) {
+			if (n48->index[i] != 0 &&
+			    pp_radix_tree_traverse (n48->children[n48->index[i] - 1], func, user_data) == TRUE)
+				return TRUE;
+		}
+		break;
+	}
+	default:
+		for (i = 0; i < 256; ++i) {
+			if (((PRadixTreeNode256 *) node)->children[i] != NULL &&
+			    pp_radix_tree_traverse (((PRadixTreeNode256 *) node)->children[i], func, user_data) == TRUE)
+				return TRUE;
+		}
+		break;
+	}
+
+	return FALSE;
+}
+
+P_LIB_API PRadixTree *
+p_radix_tree_new (void)
+{
+	return p_radix_tree_new_full (NULL);
+}
+
+P_LIB_API PRadixTree *
+p_radix_tree_new_full (PDestroyFunc value_destroy)
+{
+	PRadixTree *ret;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PRadixTree))) == NULL)) {
+		P_ERROR ("PRadixTree::p_radix_tree_new_full: failed(1) to allocate memory");
+		return NULL;
+	}
+
+	ret->value_destroy = value_destroy;
+
+	return ret;
+}
+
+P_LIB_API pboolean
+p_radix_tree_insert (PRadixTree		*tree,
+		     const puint8	*key,
+		     psize		key_len,
+		     ppointer		value)
+{
+	PRadixTreeLeaf		*leaf;
+	PRadixTreeInsertResult	result;
+
+	if (P_UNLIKELY (tree == NULL || (key == NULL && key_len > 0)))
+		return FALSE;
+
+	if (P_UNLIKELY (key_len > ((psize) -1) - sizeof (PRadixTreeLeaf)))
+		return FALSE;
+
+	if (P_UNLIKELY ((leaf = p_malloc (sizeof (PRadixTreeLeaf) + key_len)) == NULL)) {
+		P_ERROR ("PRadixTree::p_radix_tree_insert: failed(1) to allocate memory");
+		return FALSE;
+	}
+
+	leaf->value   = value;
+	leaf->key_len = key_len;
+
+	if (key_len > 0)
+		memcpy (P_RADIX_TREE_LEAF_KEY (leaf), key, key_len);
+
+	result = pp_radix_tree_insert_leaf (tree, leaf);
+
+	if (result != P_RADIX_TREE_INSERT_NEW)
+		p_free (leaf);
+
+	if (P_UNLIKELY (result == P_RADIX_TREE_INSERT_FAILED)) {
+		P_ERROR ("PRadixTree::p_radix_tree_insert: failed(2) to allocate memory");
+		return FALSE;
+	}
+
+	if (result == P_RADIX_TREE_INSERT_NEW)
+		++tree->count;
+
+	return TRUE;
+}
+
+P_LIB_API ppointer
+p_radix_tree_lookup (PRadixTree		*tree,
+		     const puint8	*key,
+		     psize		key_len)
+{
+	PRadixTreeNode	*node;
+	ppointer	*child;
+	ppointer	p;
+	psize		depth;
+
+	if (P_UNLIKELY (tree == NULL || (key == NULL && key_len > 0)))
+		return (ppointer) (-1);
+
+	for (p = tree->root, depth = 0; p != NULL; ++depth) {
+		if (P_RADIX_TREE_IS_LEAF (p)) {
+			if (pp_radix_tree_leaf_matches (P_RADIX_TREE_TO_LEAF (p), key, key_len))
+				return P_RADIX_TREE_TO_LEAF (p)->value;
+
+			break;
+		}
+
+		node = (PRadixTreeNode *) p;
+
+		if (node->prefix_len > 0) {
+			if (pp_radix_tree_check_prefix (node, key, key_len, depth) !=
+			    P_RADIX_TREE_MIN (node->prefix_len, P_RADIX_TREE_MAX_PREFIX))
+				break;
+
+			depth += node->prefix_len;
+		}
+
+		if (depth > key_len)
+			break;
+
+		if (depth == key_len) {
+			if (node->leaf != NULL && pp_radix_tree_leaf_matches (node->leaf, key, key_len))
+				return node->leaf->value;
+
+			break;
+		}
+
+		child = pp_radix_tree_find_child (node, key[depth]);
+		p     = child != NULL ? *child : NULL;
+	}
+
+	return (ppointer) (-1);
+}
+
+P_LIB_API pboolean
+p_radix_tree_lookup_longest (PRadixTree		*tree,
+			     const puint8	*key,
+			     psize		key_len,
+			     psize		*prefix_len,
+			     ppointer		*value)
+{
+	PRadixTreeNode	*node;
+	PRadixTreeLeaf	*best;
+	ppointer	*child;
+	ppointer	p;
+	psize		depth;
+
+	if (P_UNLIKELY (tree == NULL || (key == NULL && key_len > 0)))
+		return FALSE;
+
+	/* Every stored prefix of the key lies on the path of the key, candidates
+	 * are verified in full as the prefixes are skipped optimistically */
+	for (p = tree->root, depth = 0, best = NULL; p != NULL; ++depth) {
+		if (P_RADIX_TREE_IS_LEAF (p)) {
+			if (pp_radix_tree_leaf_is_prefix (P_RADIX_TREE_TO_LEAF (p), key, key_len))
+				best = P_RADIX_TREE_TO_LEAF (p);
+
+			break;
+		}
+
+		node = (PRadixTreeNode *) p;
+
+		if (node->prefix_len > 0) {
+			if (pp_radix_tree_check_prefix (node, key, key_len, depth) !=
+			    P_RADIX_TREE_MIN (node->prefix_len, P_RADIX_TREE_MAX_PREFIX))
+				break;
+
+			depth += node->prefix_len;
+		}
+
+		if (depth > key_len)
+			break;
+
+		if (node->leaf != NULL && pp_radix_tree_leaf_is_prefix (node->leaf, key, key_len))
+			best = node->leaf;
+
+		if (depth == key_len)
+			break;
+
+		child = pp_radix_tree_find_child (node, key[depth]);
+		p     = child != NULL ? *child : NULL;
+	}
+
+	if (best == NULL)
+		return FALSE;
+
+	if (prefix_len != NULL)
+		*prefix_len = best->key_len;
+
+	if (value != NULL)
+		*value = best->value;
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_radix_tree_remove (PRadixTree		*tree,
+		     const puint8	*key,
+		     psize		key_len)
+{
+	PRadixTreeNode	*node;
+	PRadixTreeLeaf	*leaf;
+	ppointer	*ref;
+	ppointer	*child;
+	psize		depth;
+
+	if (P_UNLIKELY (tree == NULL || (key == NULL && key_len > 0)))
+		return FALSE;
+
+	leaf = NULL;
+
+	for (ref = &tree->root, depth = 0; *ref != NULL; ref = child, ++depth) {
+		if (P_RADIX_TREE_IS_LEAF (*ref)) {
+			leaf = P_RADIX_TREE_TO_LEAF (*ref);
+
+			if (!pp_radix_tree_leaf_matches (leaf, key, key_len))
+				return FALSE;
+
+			*ref = NULL;
+			break;
+		}
+
+		node = (PRadixTreeNode *) *ref;
+
+		if (node->prefix_len > 0) {
+			if (pp_radix_tree_check_prefix (node, key, key_len, depth) !=
+			    P_RADIX_TREE_MIN (node->prefix_len, P_RADIX_TREE_MAX_PREFIX))
+				return FALSE;
+
+			depth += node->prefix_len;
+		}
+
+		if (depth > key_len)
+			return FALSE;
+
+		if (depth == key_len) {
+			if (node->leaf == NULL || !pp_radix_tree_leaf_matches (node->leaf, key, key_len))
+				return FALSE;
+
+			leaf       = node->leaf;
+			node->leaf = NULL;
+
+			pp_radix_tree_compact (ref, node);
+			break;
+		}
+
+		if ((child = pp_radix_tree_find_child (node, key[depth])) == NULL)
+			return FALSE;
+
+		if (P_RADIX_TREE_IS_LEAF (*child)) {
+			leaf = P_RADIX_TREE_TO_LEAF (*child);
+
+			if (!pp_radix_tree_leaf_matches (leaf, key, key_len))
+				return FALSE;
+
+			pp_radix_tree_remove_child (ref, node, key[depth], child);
+			break;
+		}
+	}
+
+	if (leaf == NULL)
+		return FALSE;
+
+	pp_radix_tree_free_leaf (tree, leaf);
+	--tree->count;
+
+	return TRUE;
+}
+
+P_LIB_API void
+p_radix_tree_foreach_prefix (PRadixTree			*tree,
+			     const puint8		*prefix,
+			     psize			prefix_len,
+			     PRadixTreeTraverseFunc	traverse_func,
+			     ppointer			user_data)
+{
+	PRadixTreeNode	*node;
+	PRadixTreeLeaf	*leaf;
+	ppointer	*child;
+	ppointer	p;
+	psize		depth;
+	psize		diff;
+
+	if (P_UNLIKELY (tree == NULL || traverse_func == NULL || (prefix == NULL && prefix_len > 0)))
+		return;
+
+	for (p = tree->root, depth = 0; p != NULL; ++depth) {
+		if (P_RADIX_TREE_IS_LEAF (p)) {
+			leaf = P_RADIX_TREE_TO_LEAF (p);
+
+			if (leaf->key_len >= prefix_len &&
+			    (prefix_len == 0 || memcmp (P_RADIX_TREE_LEAF_KEY (leaf), prefix, prefix_len) == 0))
+				traverse_func (P_RADIX_TREE_LEAF_KEY (leaf), leaf->key_len, leaf->value, user_data);
+
+			return;
+		}
+
+		node = (PRadixTreeNode *) p;
+		diff = pp_radix_tree_prefix_mismatch (node, prefix, prefix_len, depth);
+
+		/* The prefix ends within the node path, all the keys below match */
+		if (depth + diff >= prefix_len) {
+			pp_radix_tree_traverse (p, traverse_func, user_data);
+			return;
+		}
+
+		if (diff < node->prefix_len)
+			return;
+
+		depth += node->prefix_len;
+		child  = pp_radix_tree_find_child (node, prefix[depth]);
+		p      = child != NULL ? *child : NULL;
+	}
+}
+
+P_LIB_API psize
+p_radix_tree_get_count (const PRadixTree *tree)
+{
+	if (P_UNLIKELY (tree == NULL))
+		return 0;
+
+	return tree->count;
+}
+
+P_LIB_API void
+p_radix_tree_clear (PRadixTree *tree)
+{
+	if (P_UNLIKELY (tree == NULL))
+		return;
+
+	if (tree->root != NULL)
+		pp_radix_tree_free_node (tree, tree->root);
+
+	tree->root  = NULL;
+	tree->count = 0;
+}
+
+P_LIB_API void
+p_radix_tree_free (PRadixTree *tree)
+{
+	if (P_UNLIKELY (tree == NULL))
+		return;
+
+	p_radix_tree_clear (tree);
+	p_free (tree);
+}
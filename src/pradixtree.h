@@ -0,0 +1,210 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pradixtree.h
+ * @brief Adaptive radix tree
+ * @author Alexander Saprykin
+ *
+ * A radix tree maps byte string keys to values. Unlike #PTree it does not
+ * compare whole keys on every level: each inner node consumes one byte of the
+ * key (plus a compressed run of the bytes shared by all the keys below it), so
+ * a lookup takes O(k) time for a key of length k regardless of the number of
+ * stored keys.
+ *
+ * The tree is adaptive: an inner node grows through the layouts for 4, 16, 48
+ * and 256 children as its fan-out increases and shrinks back on removals. The
+ * small layouts keep the nodes within a couple of cache lines, and the 16-slot
+ * layout is searched with SSE2 or NEON instructions where available.
+ *
+ * Besides the exact lookup, the tree finds the longest stored key which is a
+ * prefix of the given one with p_radix_tree_lookup_longest() (i.e. routing by
+ * path prefixes or longest-prefix match of network addresses on byte
+ * boundaries), and iterates over all the keys starting with the given prefix
+ * in the lexicographic order with p_radix_tree_foreach_prefix().
+ *
+ * Keys are arbitrary byte sequences and may be prefixes of each other. The
+ * tree copies the key on insertion, while values are stored only as pointers:
+ * provide a value destroy function to p_radix_tree_new_full() to free them on
+ * the removal. To store integer keys, encode them in big-endian byte order:
+ * this way the lexicographic order of the keys matches the numerical one.
+ *
+ * The tree is not thread-safe.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PRADIXTREE_H
+#define PLIBSYS_HEADER_PRADIXTREE_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+
+P_BEGIN_DECLS
+
+/** Radix tree opaque data structure. */
+typedef struct PRadixTree_ PRadixTree;
+
+/**
+ * @brief Radix tree traverse function.
+ * @param key Key of the pair, not zero-terminated.
+ * @param key_len Length of the @a key, in bytes.
+ * @param value Value of the pair.
+ * @param user_data Data passed to the traverse routine.
+ * @return FALSE to continue traversing, TRUE to stop it.
+ * @since 0.0.5
+ */
+typedef pboolean (*PRadixTreeTraverseFunc) (const puint8	*key,
+					    psize		key_len,
+					    ppointer		value,
+					    ppointer		user_data);
+
+/**
+ * @brief Creates a new radix tree.
+ * @return Pointer to a newly created #PRadixTree in case of success, NULL
+ * otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API PRadixTree *	p_radix_tree_new		(void);
+
+/**
+ * @brief Creates a new radix tree with a value destroy function.
+ * @param value_destroy Function to call on every removed value, can be NULL.
+ * @return Pointer to a newly created #PRadixTree in case of success, NULL
+ * otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API PRadixTree *	p_radix_tree_new_full		(PDestroyFunc		value_destroy);
+
+/**
+ * @brief Inserts a new key-value pair into a radix tree.
+ * @param tree Radix tree to insert the pair into.
+ * @param key Key to insert, can be NULL if @a key_len is 0.
+ * @param key_len Length of the @a key, in bytes.
+ * @param value Value to insert.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * If the key already exists, its value is replaced (the value destroy function
+ * is called on the old one). The tree stores a copy of the @a key.
+ */
+P_LIB_API pboolean	p_radix_tree_insert		(PRadixTree		*tree,
+							 const puint8		*key,
+							 psize			key_len,
+							 ppointer		value);
+
+/**
+ * @brief Searches for a key in a radix tree.
+ * @param tree Radix tree to lookup in.
+ * @param key Key to lookup for.
+ * @param key_len Length of the @a key, in bytes.
+ * @return Value related to the key (can be NULL), (#ppointer) -1 if the key
+ * was not found.
+ * @since 0.0.5
+ */
+P_LIB_API ppointer	p_radix_tree_lookup		(PRadixTree		*tree,
+							 const puint8		*key,
+							 psize			key_len);
+
+/**
+ * @brief Searches for the longest stored key which is a prefix of the given
+ * key.
+ * @param tree Radix tree to lookup in.
+ * @param key Key to lookup for.
+ * @param key_len Length of the @a key, in bytes.
+ * @param[out] prefix_len Length of the found prefix, can be NULL.
+ * @param[out] value Value related to the found prefix, can be NULL.
+ * @return TRUE if a prefix was found, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The @a key itself counts as its own prefix, as well as the empty key.
+ */
+P_LIB_API pboolean	p_radix_tree_lookup_longest	(PRadixTree		*tree,
+							 const puint8		*key,
+							 psize			key_len,
+							 psize			*prefix_len,
+							 ppointer		*value);
+
+/**
+ * @brief Removes a key from a radix tree.
+ * @param tree Radix tree to remove the key from.
+ * @param key Key to remove.
+ * @param key_len Length of the @a key, in bytes.
+ * @return TRUE if the key was removed, FALSE if it was not found.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_radix_tree_remove		(PRadixTree		*tree,
+							 const puint8		*key,
+							 psize			key_len);
+
+/**
+ * @brief Iterates over the keys starting with the given prefix.
+ * @param tree Radix tree to traverse.
+ * @param prefix Prefix of the keys, can be NULL if @a prefix_len is 0.
+ * @param prefix_len Length of the @a prefix, in bytes, 0 to traverse all the
+ * keys.
+ * @param traverse_func Function to call on every matching pair.
+ * @param user_data Data to pass to the @a traverse_func.
+ * @since 0.0.5
+ *
+ * The keys are traversed in the lexicographic order of their bytes, a key goes
+ * before all the longer keys it is a prefix of. Do not modify the tree during
+ * the traversal.
+ */
+P_LIB_API void		p_radix_tree_foreach_prefix	(PRadixTree		*tree,
+							 const puint8		*prefix,
+							 psize			prefix_len,
+							 PRadixTreeTraverseFunc	traverse_func,
+							 ppointer		user_data);
+
+/**
+ * @brief Gets the number of keys in a radix tree.
+ * @param tree Radix tree to check.
+ * @return Number of the keys.
+ * @since 0.0.5
+ */
+P_LIB_API psize		p_radix_tree_get_count		(const PRadixTree	*tree);
+
+/**
+ * @brief Removes all the keys from a radix tree.
+ * @param tree Radix tree to clear.
+ * @since 0.0.5
+ */
+P_LIB_API void		p_radix_tree_clear		(PRadixTree		*tree);
+
+/**
+ * @brief Frees a previously initialized radix tree.
+ * @param tree Radix tree to free.
+ * @since 0.0.5
+ *
+ * The value destroy function is called on all the remaining values.
+ */
+P_LIB_API void		p_radix_tree_free		(PRadixTree		*tree);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PRADIXTREE_H */
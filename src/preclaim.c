@@ -0,0 +1,734 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Both kinds of domains share the per-thread records: a record is created on
+ * the first use by a thread and linked into the domain list, which only grows
+ * until the domain is freed, so the scanning threads walk it without a lock.
+ * When a thread exits, its record is marked unused under the domain mutex and
+ * given to the next registering thread together with the retired nodes left
+ * in it. As in #PMemPool, every used record holds a reference to the domain,
+ * so the TLS destructor of an exiting thread can still lock the domain after
+ * it was freed.
+ *
+ * An epoch record holds (epoch << 1) | 1 inside a critical section and 0
+ * outside of it. The global epoch advances from E to E + 1 only if every
+ * record inside a critical section holds E, so once the global epoch reaches
+ * E + 2 no thread can still be in a critical section started in epoch E, and
+ * the nodes retired in it are safe to free.
+ *
+ * A hazard slot is published with a full barrier before the protected pointer
+ * is loaded again, and the scanner puts a full barrier between unlinking the
+ * node and reading the slots: either the reader sees the node unlinked and
+ * retries, or the scanner sees the slot and keeps the node. */
+
+#include "patomic.h"
+#include "pmem.h"
+#include "pmutex.h"
+#include "psort.h"
+#include "puthread.h"
+#include "preclaim.h"
+
+#include <string.h>
+
+#define P_RECLAIM_BATCH_SIZE		64
+#define P_RECLAIM_STACK_HAZARDS		128
+
+typedef struct PReclaimDomain_ PReclaimDomain;
+
+typedef struct PReclaimRetired_ {
+	ppointer	data;
+	PDestroyFunc	free_func;
+	psize		epoch;
+} PReclaimRetired;
+
+typedef struct PReclaimRecord_ {
+	volatile psize		epoch;
+	volatile ppointer	*hazards;
+	pint			nesting;
+	pboolean		in_use;
+	struct PReclaimRecord_	*next;
+	PReclaimDomain		*domain;
+	PReclaimRetired		*retired;
+	psize			retired_count;
+	psize			retired_size;
+} PReclaimRecord;
+
+struct PReclaimDomain_ {
+	/* Epoch domain only */
+	volatile psize		epoch;
+	pchar			pad_epoch[P_MEM_CACHE_LINE_SIZE - sizeof (psize)];
+	PReclaimRecord * volatile records;
+	volatile pint		n_records;
+	pint			n_hazards;
+	PMutex			*mutex;
+	PUThreadStaticKey	*record_key;
+	pint			ref_count;
+	pboolean		is_freed;
+};
+
+struct PEpochDomain_ {
+	PReclaimDomain	base;
+};
+
+struct PHazardDomain_ {
+	PReclaimDomain	base;
+};
+
+static pboolean pp_reclaim_domain_init (PReclaimDomain *domain, pint n_hazards);
+static void pp_reclaim_domain_unref (PReclaimDomain *domain);
+static void pp_reclaim_domain_free (PReclaimDomain *domain);
+static void pp_reclaim_record_free (ppointer data);
+static PReclaimRecord * pp_reclaim_get_record (PReclaimDomain *domain);
+static pboolean pp_reclaim_record_push (PReclaimRecord *record, ppointer data, PDestroyFunc free_func, psize epoch);
+static void pp_reclaim_record_flush (PReclaimRecord *record);
+static void pp_epoch_domain_try_advance (PReclaimDomain *domain);
+static void pp_epoch_domain_collect_record (PReclaimDomain *domain, PReclaimRecord *record);
+static pint pp_hazard_domain_compare (pconstpointer a, pconstpointer b, ppointer data);
+static void pp_hazard_domain_scan (PReclaimDomain *domain, PReclaimRecord *record);
+
+static pboolean
+pp_reclaim_domain_init (PReclaimDomain	*domain,
+			pint		n_hazards)
+{
+	if (P_UNLIKELY ((domain->mutex = p_mutex_new ()) == NULL))
+		return FALSE;
+
+	if (P_UNLIKELY ((domain->record_key = p_uthread_static_local_new (pp_reclaim_record_free)) == NULL)) {
+		p_mutex_free (domain->mutex);
+		return FALSE;
+	}
+
+	domain->n_hazards = n_hazards;
+	domain->ref_count = 1;
+
+	return TRUE;
+}
+
+/* Called with the domain locked, the last reference unlocks and destroys it */
+static void
+pp_reclaim_domain_unref (PReclaimDomain *domain)
+{
+	if (--domain->ref_count == 0) {
+		p_mutex_unlock (domain->mutex);
+		p_mutex_free (domain->mutex);
+		p_free_aligned (domain);
+	} else
+		p_mutex_unlock (domain->mutex);
+}
+
+static void
+pp_reclaim_domain_free (PReclaimDomain *domain)
+{
+	PReclaimRecord	*record;
+	PReclaimRecord	*next;
+	PReclaimRecord	*own_record;
+
+	own_record = (PReclaimRecord *) p_uthread_get_static_local (domain->record_key);
+
+	if (own_record != NULL)
+		p_uthread_set_static_local (domain->record_key, NULL);
+
+	p_uthread_static_local_free (domain->record_key);
+
+	p_mutex_lock (domain->mutex);
+
+	domain->is_freed = TRUE;
+
+	/* Records of the other running threads stay until they exit */
+	for (record = domain->records; record != NULL; record = next) {
+		next = record->next;
+
+		pp_reclaim_record_flush (record);
+
+		if (record == own_record) {
+			p_free_aligned (record);
+			--domain->ref_count;
+		} else if (record->in_use == FALSE)
+			p_free_aligned (record);
+	}
+
+	pp_reclaim_domain_unref (domain);
+}
+
+static void
+pp_reclaim_record_free (ppointer data)
+{
+	PReclaimRecord	*record;
+	PReclaimDomain	*domain;
+	pint		i;
+
+	record = (PReclaimRecord *) data;
+	domain = record->domain;
+
+	p_mutex_lock (domain->mutex);
+
+	if (domain->is_freed == TRUE)
+		p_free_aligned (record);
+	else {
+		/* The thread can't hold any node after the exit */
+		for (i = 0; i < domain->n_hazards; ++i)
+			p_atomic_pointer_set_explicit (&record->hazards[i], NULL, P_ATOMIC_MEMORY_ORDER_RELEASE);
+
+		p_atomic_pointer_set_explicit (&record->epoch, NULL, P_ATOMIC_MEMORY_ORDER_RELEASE);
+
+		record->nesting = 0;
+		record->in_use  = FALSE;
+	}
+
+	pp_reclaim_domain_unref (domain);
+}
+
+static PReclaimRecord *
+pp_reclaim_get_record (PReclaimDomain *domain)
+{
+	PReclaimRecord	*record;
+	psize		size;
+
+	record = (PReclaimRecord *) p_uthread_get_static_local (domain->record_key);
+
+	if (P_LIKELY (record != NULL))
+		return record;
+
+	p_mutex_lock (domain->mutex);
+
+	for (record = domain->records; record != NULL; record = record->next) {
+		if (record->in_use == FALSE)
+			break;
+	}
+
+	if (record == NULL) {
+		/* Records of different threads never share a cache line */
+		size = sizeof (PReclaimRecord) + (psize) domain->n_hazards * sizeof (ppointer);
+		size = (size + P_MEM_CACHE_LINE_SIZE - 1) & ~((psize) P_MEM_CACHE_LINE_SIZE - 1);
+
+		if (P_UNLIKELY ((record = p_malloc0_aligned (size, P_MEM_CACHE_LINE_SIZE)) == NULL)) {
+			p_mutex_unlock (domain->mutex);
+			return NULL;
+		}
+
+		record->hazards = (volatile ppointer *) (record + 1);
+		record->domain  = domain;
+		record->next    = domain->records;
+
+		p_atomic_pointer_set (&domain->records, record);
+		p_atomic_int_inc (&domain->n_records);
+	}
+
+	record->in_use = TRUE;
+	++domain->ref_count;
+
+	p_mutex_unlock (domain->mutex);
+
+	p_uthread_set_static_local (domain->record_key, record);
+
+	return record;
+}
+
+static pboolean
+pp_reclaim_record_push (PReclaimRecord	*record,
+			ppointer	data,
+			PDestroyFunc	free_func,
+			psize		epoch)
+{
+	PReclaimRetired	*retired;
+	psize		size;
+
+	if (record->retired_count == record->retired_size) {
+		size = record->retired_size == 0 ? P_RECLAIM_BATCH_SIZE : record->retired_size * 2;
+
+		if (P_UNLIKELY ((retired = p_realloc (record->retired, size * sizeof (PReclaimRetired))) == NULL))
+			return FALSE;
+
+		record->retired      = retired;
+		record->retired_size = size;
+	}
+
+	retired = &record->retired[record->retired_count++];
+
+	retired->data      = data;
+	retired->free_func = free_func;
+	retired->epoch     = epoch;
+
+	return TRUE;
+}
+
+static void
+pp_reclaim_record_flush (PReclaimRecord *record)
+{
+	psize i;
+
+	for (i = 0; i < record->retired_count; ++i)
+		record->retired[i].free_func (record->retired[i].data);
+
+	p_free (record->retired);
+
+	record->retired       = NULL;
+	record->retired_count = 0;
+	record->retired_size  = 0;
+}
+
+static void
+pp_epoch_domain_try_advance (PReclaimDomain *domain)
+{
+	PReclaimRecord	*record;
+	psize		epoch;
+	psize		state;
+
+	/* Orders the loads below after the caller's unlinks and retires */
+	p_atomic_thread_fence (P_ATOMIC_MEMORY_ORDER_SEQ_CST);
+
+	epoch = PPOINTER_TO_PSIZE (p_atomic_pointer_get_explicit (&domain->epoch, P_ATOMIC_MEMORY_ORDER_RELAXED));
+
+	for (record = (PReclaimRecord *) p_atomic_pointer_get (&domain->records);
+	     record != NULL;
+	     record = record->next) {
+		state = PPOINTER_TO_PSIZE (p_atomic_pointer_get_explicit (&record->epoch,
+									  P_ATOMIC_MEMORY_ORDER_RELAXED));
+
+		if ((state & 1) != 0 && (state >> 1) != epoch)
+			return;
+	}
+
+	/* Pairs with the release in p_epoch_domain_leave() */
+	p_atomic_thread_fence (P_ATOMIC_MEMORY_ORDER_ACQUIRE);
+
+	p_atomic_pointer_compare_and_exchange (&domain->epoch, PSIZE_TO_POINTER (epoch), PSIZE_TO_POINTER (epoch + 1));
+}
+
+/* Retired nodes are appended in the epoch order, so the ones to free make up
+ * a prefix of the list */
+static void
+pp_epoch_domain_collect_record (PReclaimDomain	*domain,
+				PReclaimRecord	*record)
+{
+	psize epoch;
+	psize count;
+
+	epoch = PPOINTER_TO_PSIZE (p_atomic_pointer_get_explicit (&domain->epoch, P_ATOMIC_MEMORY_ORDER_ACQUIRE));
+
+	for (count = 0; count < record->retired_count; ++count) {
+		if (record->retired[count].epoch + 2 > epoch)
+			break;
+
+		record->retired[count].free_func (record->retired[count].data);
+	}
+
+	if (count == 0)
+		return;
+
+	record->retired_count -= count;
+
+	memmove (record->retired, record->retired + count, record->retired_count * sizeof (PReclaimRetired));
+}
+
+static int
+pp_hazard_domain_compare (pconstpointer	a,
+			  pconstpointer	b,
+			  ppointer	data)
+{
+	psize pa;
+	psize pb;
+
+	P_UNUSED (data);
+
+	pa = PPOINTER_TO_PSIZE (*((const ppointer *) a));
+	pb = PPOINTER_TO_PSIZE (*((const ppointer *) b));
+
+	return pa < pb ? -1 : (pa > pb ? 1 : 0);
+}
+
+static void
+pp_hazard_domain_scan (PReclaimDomain	*domain,
+		       PReclaimRecord	*record)
+{
+	ppointer	stack_hazards[P_RECLAIM_STACK_HAZARDS];
+	ppointer	*hazards;
+	ppointer	data;
+	PReclaimRecord	*head;
+	PReclaimRecord	*current;
+	psize		total;
+	psize		found;
+	psize		kept;
+	psize		pos;
+	psize		i;
+
+	if (record->retired_count == 0)
+		return;
+
+	/* Pairs with the barrier in p_hazard_domain_protect() */
+	p_atomic_thread_fence (P_ATOMIC_MEMORY_ORDER_SEQ_CST);
+
+	/* Records are only prepended, the list from this head never changes */
+	head = (PReclaimRecord *) p_atomic_pointer_get (&domain->records);
+
+	for (total = 0, current = head; current != NULL; current = current->next)
+		total += (psize) domain->n_hazards;
+
+	if (total <= P_RECLAIM_STACK_HAZARDS)
+		hazards = stack_hazards;
+	else if (P_UNLIKELY ((hazards = p_malloc (total * sizeof (ppointer))) == NULL))
+		return;
+
+	for (found = 0, current = head; current != NULL; current = current->next) {
+		for (i = 0; i < (psize) domain->n_hazards; ++i) {
+			data = p_atomic_pointer_get_explicit (&current->hazards[i], P_ATOMIC_MEMORY_ORDER_RELAXED);
+
+			if (data != NULL)
+				hazards[found++] = data;
+		}
+	}
+
+	/* Pairs with the release in p_hazard_domain_clear() */
+	p_atomic_thread_fence (P_ATOMIC_MEMORY_ORDER_ACQUIRE);
+
+	p_sort (hazards, found, sizeof (ppointer), pp_hazard_domain_compare, NULL);
+
+	for (i = 0, kept = 0; i < record->retired_count; ++i) {
+		pos = p_lower_bound (hazards,
+				     found,
+				     sizeof (ppointer),
+				     &record->retired[i].data,
+				     pp_hazard_domain_compare,
+				     NULL);
+
+		if (pos < found && hazards[pos] == record->retired[i].data)
+			record->retired[kept++] = record->retired[i];
+		else
+			record->retired[i].free_func (record->retired[i].data);
+	}
+
+	record->retired_count = kept;
+
+	if (hazards != stack_hazards)
+		p_free (hazards);
+}
+
+P_LIB_API PEpochDomain *
+p_epoch_domain_new (void)
+{
+	PEpochDomain *ret;
+
+	if (P_UNLIKELY ((ret = p_malloc0_aligned (sizeof (PEpochDomain), P_MEM_CACHE_LINE_SIZE)) == NULL)) {
+		P_ERROR ("PEpochDomain::p_epoch_domain_new: failed to allocate memory");
+		return NULL;
+	}
+
+	if (P_UNLIKELY (pp_reclaim_domain_init (&ret->base, 0) == FALSE)) {
+		P_ERROR ("PEpochDomain::p_epoch_domain_new: failed to initialize domain");
+		p_free_aligned (ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+P_LIB_API pboolean
+p_epoch_domain_enter (PEpochDomain *domain)
+{
+	PReclaimRecord	*record;
+	psize		epoch;
+
+	if (P_UNLIKELY (domain == NULL))
+		return FALSE;
+
+	if (P_UNLIKELY ((record = pp_reclaim_get_record (&domain->base)) == NULL))
+		return FALSE;
+
+	if (record->nesting++ > 0)
+		return TRUE;
+
+	epoch = PPOINTER_TO_PSIZE (p_atomic_pointer_get_explicit (&domain->base.epoch,
+								  P_ATOMIC_MEMORY_ORDER_RELAXED));
+
+	p_atomic_pointer_set_explicit (&record->epoch,
+				       PSIZE_TO_POINTER ((epoch << 1) | 1),
+				       P_ATOMIC_MEMORY_ORDER_RELAXED);
+
+	/* Loads of the shared nodes must not pass the announcement */
+	p_atomic_thread_fence (P_ATOMIC_MEMORY_ORDER_SEQ_CST);
+
+	return TRUE;
+}
+
+P_LIB_API void
+p_epoch_domain_leave (PEpochDomain *domain)
+{
+	PReclaimRecord *record;
+
+	if (P_UNLIKELY (domain == NULL))
+		return;
+
+	record = (PReclaimRecord *) p_uthread_get_static_local (domain->base.record_key);
+
+	if (P_UNLIKELY (record == NULL || record->nesting == 0))
+		return;
+
+	if (--record->nesting == 0)
+		p_atomic_pointer_set_explicit (&record->epoch, NULL, P_ATOMIC_MEMORY_ORDER_RELEASE);
+}
+
+P_LIB_API pboolean
+p_epoch_domain_retire (PEpochDomain	*domain,
+		       ppointer		data,
+		       PDestroyFunc	free_func)
+{
+	PReclaimRecord	*record;
+	psize		epoch;
+
+	if (P_UNLIKELY (domain == NULL || data == NULL || free_func == NULL))
+		return FALSE;
+
+	if (P_UNLIKELY ((record = pp_reclaim_get_record (&domain->base)) == NULL))
+		return FALSE;
+
+	/* The node must be unlinked before the epoch is read */
+	p_atomic_thread_fence (P_ATOMIC_MEMORY_ORDER_SEQ_CST);
+
+	epoch = PPOINTER_TO_PSIZE (p_atomic_pointer_get_explicit (&domain->base.epoch,
+								  P_ATOMIC_MEMORY_ORDER_RELAXED));
+
+	if (P_UNLIKELY (pp_reclaim_record_push (record, data, free_func, epoch) == FALSE))
+		return FALSE;
+
+	if (record->retired_count % P_RECLAIM_BATCH_SIZE == 0) {
+		pp_epoch_domain_try_advance (&domain->base);
+		pp_epoch_domain_collect_record (&domain->base, record);
+	}
+
+	return TRUE;
+}
+
+P_LIB_API void
+p_epoch_domain_collect (PEpochDomain *domain)
+{
+	PReclaimRecord *record;
+
+	if (P_UNLIKELY (domain == NULL))
+		return;
+
+	pp_epoch_domain_try_advance (&domain->base);
+
+	record = (PReclaimRecord *) p_uthread_get_static_local (domain->base.record_key);
+
+	if (record != NULL)
+		pp_epoch_domain_collect_record (&domain->base, record);
+
+	p_mutex_lock (domain->base.mutex);
+
+	for (record = domain->base.records; record != NULL; record = record->next) {
+		if (record->in_use == FALSE)
+			pp_epoch_domain_collect_record (&domain->base, record);
+	}
+
+	p_mutex_unlock (domain->base.mutex);
+}
+
+P_LIB_API void
+p_epoch_domain_barrier (PEpochDomain *domain)
+{
+	psize target;
+	psize epoch;
+
+	if (P_UNLIKELY (domain == NULL))
+		return;
+
+	p_atomic_thread_fence (P_ATOMIC_MEMORY_ORDER_SEQ_CST);
+
+	/* Everything retired so far has an epoch not greater than the current */
+	target = PPOINTER_TO_PSIZE (p_atomic_pointer_get (&domain->base.epoch)) + 2;
+
+	for (;;) {
+		epoch = PPOINTER_TO_PSIZE (p_atomic_pointer_get (&domain->base.epoch));
+
+		if ((pssize) (epoch - target) >= 0)
+			break;
+
+		pp_epoch_domain_try_advance (&domain->base);
+
+		if (PPOINTER_TO_PSIZE (p_atomic_pointer_get (&domain->base.epoch)) == epoch)
+			p_uthread_yield ();
+	}
+
+	p_epoch_domain_collect (domain);
+}
+
+P_LIB_API void
+p_epoch_domain_free (PEpochDomain *domain)
+{
+	if (P_UNLIKELY (domain == NULL))
+		return;
+
+	pp_reclaim_domain_free (&domain->base);
+}
+
+P_LIB_API PHazardDomain *
+p_hazard_domain_new (pint n_hazards)
+{
+	PHazardDomain *ret;
+
+	if (P_UNLIKELY (n_hazards <= 0))
+		return NULL;
+
+	if (P_UNLIKELY ((ret = p_malloc0_aligned (sizeof (PHazardDomain), P_MEM_CACHE_LINE_SIZE)) == NULL)) {
+		P_ERROR ("PHazardDomain::p_hazard_domain_new: failed to allocate memory");
+		return NULL;
+	}
+
+	if (P_UNLIKELY (pp_reclaim_domain_init (&ret->base, n_hazards) == FALSE)) {
+		P_ERROR ("PHazardDomain::p_hazard_domain_new: failed to initialize domain");
+		p_free_aligned (ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+P_LIB_API ppointer
+p_hazard_domain_protect (PHazardDomain		*domain,
+			 pint			index,
+			 const volatile void	*source)
+{
+	PReclaimRecord	*record;
+	ppointer	value;
+	ppointer	check;
+
+	if (P_UNLIKELY (domain == NULL || source == NULL || index < 0 || index >= domain->base.n_hazards))
+		return NULL;
+
+	if (P_UNLIKELY ((record = pp_reclaim_get_record (&domain->base)) == NULL))
+		return NULL;
+
+	value = p_atomic_pointer_get_explicit (source, P_ATOMIC_MEMORY_ORDER_RELAXED);
+
+	for (;;) {
+		p_atomic_pointer_set_explicit (&record->hazards[index], value, P_ATOMIC_MEMORY_ORDER_RELAXED);
+
+		/* The slot must be visible before the pointer is checked again */
+		p_atomic_thread_fence (P_ATOMIC_MEMORY_ORDER_SEQ_CST);
+
+		check = p_atomic_pointer_get_explicit (source, P_ATOMIC_MEMORY_ORDER_ACQUIRE);
+
+		if (P_LIKELY (check == value))
+			return value;
+
+		value = check;
+	}
+}
+
+P_LIB_API pboolean
+p_hazard_domain_set (PHazardDomain	*domain,
+		     pint		index,
+		     ppointer		data)
+{
+	PReclaimRecord *record;
+
+	if (P_UNLIKELY (domain == NULL || index < 0 || index >= domain->base.n_hazards))
+		return FALSE;
+
+	if (P_UNLIKELY ((record = pp_reclaim_get_record (&domain->base)) == NULL))
+		return FALSE;
+
+	p_atomic_pointer_set_explicit (&record->hazards[index], data, P_ATOMIC_MEMORY_ORDER_RELAXED);
+	p_atomic_thread_fence (P_ATOMIC_MEMORY_ORDER_SEQ_CST);
+
+	return TRUE;
+}
+
+P_LIB_API void
+p_hazard_domain_clear (PHazardDomain	*domain,
+		       pint		index)
+{
+	PReclaimRecord *record;
+
+	if (P_UNLIKELY (domain == NULL || index < 0 || index >= domain->base.n_hazards))
+		return;
+
+	record = (PReclaimRecord *) p_uthread_get_static_local (domain->base.record_key);
+
+	if (P_UNLIKELY (record == NULL))
+		return;
+
+	p_atomic_pointer_set_explicit (&record->hazards[index], NULL, P_ATOMIC_MEMORY_ORDER_RELEASE);
+}
+
+P_LIB_API pboolean
+p_hazard_domain_retire (PHazardDomain	*domain,
+			ppointer	data,
+			PDestroyFunc	free_func)
+{
+	PReclaimRecord	*record;
+	psize		threshold;
+
+	if (P_UNLIKELY (domain == NULL || data == NULL || free_func == NULL))
+		return FALSE;
+
+	if (P_UNLIKELY ((record = pp_reclaim_get_record (&domain->base)) == NULL))
+		return FALSE;
+
+	if (P_UNLIKELY (pp_reclaim_record_push (record, data, free_func, 0) == FALSE))
+		return FALSE;
+
+	/* A scan keeps at most one node per slot, so it frees at least the
+	 * batch size nodes and the cost per node stays constant */
+	threshold = P_RECLAIM_BATCH_SIZE +
+		    (psize) domain->base.n_hazards * (psize) p_atomic_int_get (&domain->base.n_records);
+
+	if (record->retired_count >= threshold)
+		pp_hazard_domain_scan (&domain->base, record);
+
+	return TRUE;
+}
+
+P_LIB_API void
+p_hazard_domain_collect (PHazardDomain *domain)
+{
+	PReclaimRecord *record;
+
+	if (P_UNLIKELY (domain == NULL))
+		return;
+
+	record = (PReclaimRecord *) p_uthread_get_static_local (domain->base.record_key);
+
+	if (record != NULL)
+		pp_hazard_domain_scan (&domain->base, record);
+
+	p_mutex_lock (domain->base.mutex);
+
+	for (record = domain->base.records; record != NULL; record = record->next) {
+		if (record->in_use == FALSE)
+			pp_hazard_domain_scan (&domain->base, record);
+	}
+
+	p_mutex_unlock (domain->base.mutex);
+}
+
+P_LIB_API void
+p_hazard_domain_free (PHazardDomain *domain)
+{
+	if (P_UNLIKELY (domain == NULL))
+		return;
+
+	pp_reclaim_domain_free (&domain->base);
+}
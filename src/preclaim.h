@@ -0,0 +1,242 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file preclaim.h
+ * @brief Safe memory reclamation for lock-free structures
+ * @author Alexander Saprykin
+ *
+ * A lock-free structure unlinks a node with a single compare and exchange,
+ * but another thread may still be reading the node it has just loaded, so the
+ * node can't be freed right away. Instead it is retired to a reclamation
+ * domain which frees it once no thread can hold a reference anymore. Two kinds
+ * of domains are available.
+ *
+ * An epoch domain (#PEpochDomain) counts global epochs. Readers enclose every
+ * access to the shared nodes into p_epoch_domain_enter() and
+ * p_epoch_domain_leave(), which only publish the current epoch in a per-thread
+ * record. The epoch advances once all the threads inside a critical section
+ * have seen it, and a node retired in some epoch is freed two epochs later.
+ * Entering and leaving cost a couple of stores, but a thread stuck inside a
+ * critical section holds back every retired node.
+ *
+ * A hazard pointer domain (#PHazardDomain) gives each thread a few hazard
+ * slots. A reader publishes a pointer in a slot with
+ * p_hazard_domain_protect() before dereferencing it, and a retired node is
+ * freed only when no slot holds it. Each protection costs a full memory
+ * barrier, but the number of unreclaimed nodes stays bounded whatever the
+ * readers do.
+ *
+ * Retired nodes are kept in per-thread lists and freed in batches: a list is
+ * scanned once it grows past a threshold, or on an explicit collect call.
+ * The lists of the exited threads are passed to the next threads registering
+ * in the domain and are also handled by the collect calls. A destroy function
+ * called for a retired node must not retire nodes into the same domain.
+ *
+ * The per-thread records are kept in static TLS keys, see
+ * p_uthread_static_local_new().
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PRECLAIM_H
+#define PLIBSYS_HEADER_PRECLAIM_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+
+P_BEGIN_DECLS
+
+/** Epoch-based reclamation domain opaque data type. */
+typedef struct PEpochDomain_ PEpochDomain;
+
+/** Hazard pointer reclamation domain opaque data type. */
+typedef struct PHazardDomain_ PHazardDomain;
+
+/**
+ * @brief Creates a new epoch-based reclamation domain.
+ * @return Pointer to #PEpochDomain in case of success, NULL otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API PEpochDomain *	p_epoch_domain_new		(void);
+
+/**
+ * @brief Enters a critical section of an epoch domain.
+ * @param domain #PEpochDomain to enter.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * Nodes retired to @a domain are not freed while the calling thread stays in
+ * the critical section. The calls can be nested, each successful call must be
+ * paired with p_epoch_domain_leave().
+ */
+P_LIB_API pboolean		p_epoch_domain_enter		(PEpochDomain	*domain);
+
+/**
+ * @brief Leaves a critical section of an epoch domain.
+ * @param domain #PEpochDomain to leave.
+ * @since 0.0.5
+ */
+P_LIB_API void			p_epoch_domain_leave		(PEpochDomain	*domain);
+
+/**
+ * @brief Retires a node to an epoch domain.
+ * @param domain #PEpochDomain to retire the node to.
+ * @param data Node already unlinked from the shared structure.
+ * @param free_func Function to free @a data with.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * @a free_func is called once every thread has left the critical sections it
+ * was in at the time of the call. The call may free a batch of the nodes
+ * retired earlier. In case of failure @a data stays with the caller.
+ */
+P_LIB_API pboolean		p_epoch_domain_retire		(PEpochDomain	*domain,
+								 ppointer	data,
+								 PDestroyFunc	free_func);
+
+/**
+ * @brief Frees the retired nodes which are safe to free.
+ * @param domain #PEpochDomain to collect the nodes in.
+ * @since 0.0.5
+ *
+ * Tries to advance the epoch and frees the nodes retired by the calling
+ * thread and by the exited threads.
+ */
+P_LIB_API void			p_epoch_domain_collect		(PEpochDomain	*domain);
+
+/**
+ * @brief Waits until all the nodes retired so far can be freed.
+ * @param domain #PEpochDomain to wait for.
+ * @since 0.0.5
+ *
+ * Frees the nodes retired by the calling thread and by the exited threads
+ * before the call. It waits for every other thread to leave its current
+ * critical section, so it must not be called inside a critical section.
+ */
+P_LIB_API void			p_epoch_domain_barrier		(PEpochDomain	*domain);
+
+/**
+ * @brief Frees an epoch domain.
+ * @param domain #PEpochDomain to free.
+ * @since 0.0.5
+ *
+ * All the retired nodes are freed right away, no thread may access them
+ * anymore.
+ */
+P_LIB_API void			p_epoch_domain_free		(PEpochDomain	*domain);
+
+/**
+ * @brief Creates a new hazard pointer reclamation domain.
+ * @param n_hazards Number of hazard slots per thread, at least 1.
+ * @return Pointer to #PHazardDomain in case of success, NULL otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API PHazardDomain *	p_hazard_domain_new		(pint		n_hazards);
+
+/**
+ * @brief Loads a pointer and protects it with a hazard slot.
+ * @param domain #PHazardDomain to protect the pointer in.
+ * @param index Hazard slot of the calling thread, from 0 to the number of
+ * slots minus 1.
+ * @param source Location to load the pointer from.
+ * @return Protected pointer loaded from @a source in case of success, NULL in
+ * case of error or if @a source holds NULL.
+ * @since 0.0.5
+ *
+ * The pointer is loaded again after it is published, until it doesn't change
+ * anymore: the returned node can't be freed until the slot is cleared or
+ * reused, even if it is unlinked later.
+ */
+P_LIB_API ppointer		p_hazard_domain_protect		(PHazardDomain		*domain,
+								 pint			index,
+								 const volatile void	*source);
+
+/**
+ * @brief Publishes a pointer in a hazard slot.
+ * @param domain #PHazardDomain to publish the pointer in.
+ * @param index Hazard slot of the calling thread.
+ * @param data Pointer to publish.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * Unlike p_hazard_domain_protect() it doesn't validate the pointer, use it for
+ * a node which is known to be protected by another slot, e.g. to move the
+ * protection between the slots.
+ */
+P_LIB_API pboolean		p_hazard_domain_set		(PHazardDomain	*domain,
+								 pint		index,
+								 ppointer	data);
+
+/**
+ * @brief Clears a hazard slot.
+ * @param domain #PHazardDomain to clear the slot in.
+ * @param index Hazard slot of the calling thread.
+ * @since 0.0.5
+ */
+P_LIB_API void			p_hazard_domain_clear		(PHazardDomain	*domain,
+								 pint		index);
+
+/**
+ * @brief Retires a node to a hazard pointer domain.
+ * @param domain #PHazardDomain to retire the node to.
+ * @param data Node already unlinked from the shared structure.
+ * @param free_func Function to free @a data with.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * @a free_func is called once no hazard slot holds @a data. The call may free
+ * a batch of the nodes retired earlier. In case of failure @a data stays with
+ * the caller.
+ */
+P_LIB_API pboolean		p_hazard_domain_retire		(PHazardDomain	*domain,
+								 ppointer	data,
+								 PDestroyFunc	free_func);
+
+/**
+ * @brief Frees the retired nodes which are safe to free.
+ * @param domain #PHazardDomain to collect the nodes in.
+ * @since 0.0.5
+ *
+ * Frees the nodes retired by the calling thread and by the exited threads
+ * which no hazard slot holds.
+ */
+P_LIB_API void			p_hazard_domain_collect		(PHazardDomain	*domain);
+
+/**
+ * @brief Frees a hazard pointer domain.
+ * @param domain #PHazardDomain to free.
+ * @since 0.0.5
+ *
+ * All the retired nodes are freed right away, no thread may access them
+ * anymore.
+ */
+P_LIB_API void			p_hazard_domain_free		(PHazardDomain	*domain);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PRECLAIM_H */
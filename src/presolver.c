@@ -0,0 +1,716 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Cache entries are keyed by hostname and hold the native addresses without a
+ * port, which is patched in when a result is delivered. An entry is pending
+ * while a worker runs getaddrinfo() for it: the lookups arriving meanwhile
+ * are queued as waiters of the entry and served with the same result. Pending
+ * entries are never evicted, so the worker can use its entry without holding
+ * the lock. The results are built under the lock and delivered after it is
+ * released, so callbacks may start new lookups. */
+
+#include "pmem.h"
+#include "pstring.h"
+#include "pmutex.h"
+#include "pcondvariable.h"
+#include "pstrhashtable.h"
+#include "pthreadpool.h"
+#include "ptimeprofiler.h"
+#include "presolver.h"
+#include "plibsys-private.h"
+
+#include <string.h>
+
+#if defined (P_OS_WIN) || defined (PLIBSYS_HAS_GETADDRINFO)
+#  define P_RESOLVER_HAS_GETADDRINFO
+#endif
+
+#if defined (P_RESOLVER_HAS_GETADDRINFO) && !defined (P_OS_WIN)
+#  include <netdb.h>
+#endif
+
+#ifdef P_OS_VMS
+#  if PLIBSYS_SIZEOF_VOID_P == 8
+#    define addrinfo __addrinfo64
+#  endif
+#endif
+
+#define P_RESOLVER_DEFAULT_WORKERS	4
+
+typedef struct PResolverNative_ {
+	struct sockaddr_storage	sa;
+	psize			len;
+} PResolverNative;
+
+typedef struct PResolverWaiter_ PResolverWaiter;
+
+struct PResolverWaiter_ {
+	PResolverWaiter	*next;
+	PResolverFunc	func;
+	ppointer	user_data;
+	puint16		port;
+};
+
+typedef struct PResolverDelivery_ {
+	PResolverFunc	func;
+	ppointer	user_data;
+	PSocketAddress	**addresses;
+	psize		n_addresses;
+	PError		*error;
+} PResolverDelivery;
+
+typedef struct PResolverEntry_ {
+	PResolver	*resolver;
+	pchar		*hostname;
+	PResolverNative	*natives;
+	psize		n_natives;
+	PErrorIO	error_code;
+	pint		native_code;
+	const pchar	*message;
+	puint64		expire_time;
+	pboolean	is_pending;
+	PResolverWaiter	*waiters;
+} PResolverEntry;
+
+typedef struct PResolverSync_ {
+	PResolver	*resolver;
+	PSocketAddress	**addresses;
+	psize		n_addresses;
+	PError		*error;
+	pboolean	is_done;
+} PResolverSync;
+
+struct PResolver_ {
+	PMutex		*mutex;
+	PCondVariable	*cond;
+	PThreadPool	*pool;
+	PStrHashTable	*cache;
+	pint		ttl;
+	pint		negative_ttl;
+};
+
+static void pp_resolver_entry_free (ppointer data);
+static PResolverEntry * pp_resolver_get_cached (PResolver *resolver, const pchar *hostname);
+static void pp_resolver_make_delivery (const PResolverEntry *entry, puint16 port, PResolverDelivery *delivery);
+static void pp_resolver_deliver (PResolverDelivery *delivery);
+static void pp_resolver_query (PResolverEntry *entry);
+static void pp_resolver_worker (ppointer data);
+static void pp_resolver_sync_func (PSocketAddress **addresses, psize n_addresses, PError *error, ppointer user_data);
+static pboolean pp_resolver_start (PResolver *resolver, const pchar *hostname, puint16 port,
+				   PResolverFunc func, ppointer user_data, PError **error);
+
+static void
+pp_resolver_entry_free (ppointer data)
+{
+	PResolverEntry *entry = (PResolverEntry *) data;
+
+	p_free (entry->hostname);
+	p_free (entry->natives);
+	p_free (entry);
+}
+
+/* Called with the resolver locked, drops an expired entry */
+static PResolverEntry *
+pp_resolver_get_cached (PResolver	*resolver,
+			const pchar	*hostname)
+{
+	PResolverEntry *entry;
+
+	entry = (PResolverEntry *) p_str_hash_table_lookup (resolver->cache, hostname);
+
+	if (entry == (PResolverEntry *) -1)
+		return NULL;
+
+	if (entry->is_pending == FALSE && p_time_coarse_now_msecs () >= entry->expire_time) {
+		p_str_hash_table_remove (resolver->cache, hostname);
+		return NULL;
+	}
+
+	return entry;
+}
+
+/* Called with the resolver locked, builds a private copy of the result */
+static void
+pp_resolver_make_delivery (const PResolverEntry	*entry,
+			   puint16		port,
+			   PResolverDelivery	*delivery)
+{
+	PResolverNative	native;
+	psize		i;
+
+	delivery->addresses   = NULL;
+	delivery->n_addresses = 0;
+	delivery->error       = NULL;
+
+	if (entry->error_code != P_ERROR_IO_NONE) {
+		p_error_set_error_static_p (&delivery->error,
+					    (pint) entry->error_code,
+					    entry->native_code,
+					    entry->message);
+		return;
+	}
+
+	delivery->addresses = p_malloc0 (entry->n_natives * sizeof (PSocketAddress *));
+
+	if (P_UNLIKELY (delivery->addresses == NULL)) {
+		p_error_set_error_static_p (&delivery->error,
+					    (pint) P_ERROR_IO_NO_RESOURCES,
+					    0,
+					    "Failed to allocate memory for resolved addresses");
+		return;
+	}
+
+	for (i = 0; i < entry->n_natives; ++i) {
+		native = entry->natives[i];
+
+		if (native.sa.ss_family == AF_INET)
+			((struct sockaddr_in *) &native.sa)->sin_port = p_htons (port);
+#ifdef AF_INET6
+		else if (native.sa.ss_family == AF_INET6)
+			((struct sockaddr_in6 *) &native.sa)->sin6_port = p_htons (port);
+#endif
+
+		delivery->addresses[delivery->n_addresses] = p_socket_address_new_from_native (&native.sa,
+											       native.len);
+
+		if (P_LIKELY (delivery->addresses[delivery->n_addresses] != NULL))
+			++delivery->n_addresses;
+	}
+
+	if (P_UNLIKELY (delivery->n_addresses < entry->n_natives)) {
+		p_resolver_free_addresses (delivery->addresses, delivery->n_addresses);
+
+		delivery->addresses   = NULL;
+		delivery->n_addresses = 0;
+
+		p_error_set_error_static_p (&delivery->error,
+					    (pint) P_ERROR_IO_NO_RESOURCES,
+					    0,
+					    "Failed to allocate memory for resolved addresses");
+	}
+}
+
+static void
+pp_resolver_deliver (PResolverDelivery *delivery)
+{
+	delivery->func (delivery->addresses,
+			delivery->n_addresses,
+			delivery->error,
+			delivery->user_data);
+}
+
+/* Runs the system resolver without holding the lock */
+static void
+pp_resolver_query (PResolverEntry *entry)
+{
+#ifdef P_RESOLVER_HAS_GETADDRINFO
+	struct addrinfo	hints;
+	struct addrinfo	*res;
+	struct addrinfo	*cur;
+	psize		count;
+	pint		ret;
+
+	memset (&hints, 0, sizeof (hints));
+
+	hints.ai_family   = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+
+	if ((ret = getaddrinfo (entry->hostname, NULL, &hints, &res)) != 0) {
+		switch (ret) {
+#  ifdef EAI_NONAME
+		case EAI_NONAME:
+			entry->error_code = P_ERROR_IO_NOT_EXISTS;
+			entry->message    = "Hostname is not known";
+			break;
+#  endif
+#  ifdef EAI_AGAIN
+		case EAI_AGAIN:
+			entry->error_code = P_ERROR_IO_NOT_AVAILABLE;
+			entry->message    = "Name server is temporarily not available";
+			break;
+#  endif
+#  ifdef EAI_MEMORY
+		case EAI_MEMORY:
+			entry->error_code = P_ERROR_IO_NO_RESOURCES;
+			entry->message    = "Not enough memory to resolve hostname";
+			break;
+#  endif
+		default:
+			entry->error_code = P_ERROR_IO_FAILED;
+			entry->message    = "Failed to call getaddrinfo() to resolve hostname";
+			break;
+		}
+
+		entry->native_code = ret;
+		return;
+	}
+
+	for (cur = res, count = 0; cur != NULL; cur = cur->ai_next)
+		++count;
+
+	if (P_UNLIKELY ((entry->natives = p_malloc0 (count * sizeof (PResolverNative))) == NULL)) {
+		freeaddrinfo (res);
+
+		entry->error_code = P_ERROR_IO_NO_RESOURCES;
+		entry->message    = "Failed to allocate memory for resolved addresses";
+		return;
+	}
+
+	for (cur = res; cur != NULL; cur = cur->ai_next) {
+		if (cur->ai_family != AF_INET
+#  ifdef AF_INET6
+		    && cur->ai_family != AF_INET6
+#  endif
+		   )
+			continue;
+
+		if (P_UNLIKELY ((psize) cur->ai_addrlen > sizeof (struct sockaddr_storage)))
+			continue;
+
+		memcpy (&entry->natives[entry->n_natives].sa, cur->ai_addr, (psize) cur->ai_addrlen);
+		entry->natives[entry->n_natives].len = (psize) cur->ai_addrlen;
+		++entry->n_natives;
+	}
+
+	freeaddrinfo (res);
+
+	if (P_UNLIKELY (entry->n_natives == 0)) {
+		entry->error_code = P_ERROR_IO_NOT_EXISTS;
+		entry->message    = "Hostname has no supported addresses";
+	}
+#else
+	entry->error_code = P_ERROR_IO_NOT_IMPLEMENTED;
+	entry->message    = "Hostname resolving is not supported on this platform";
+#endif
+}
+
+static void
+pp_resolver_worker (ppointer data)
+{
+	PResolverEntry		*entry    = (PResolverEntry *) data;
+	PResolver		*resolver = entry->resolver;
+	PResolverDelivery	*deliveries;
+	PResolverWaiter		*waiters;
+	PResolverWaiter		*waiter;
+	psize			n_deliveries;
+	psize			i;
+	pint			ttl;
+
+	pp_resolver_query (entry);
+
+	p_mutex_lock (resolver->mutex);
+
+	waiters = entry->waiters;
+
+	for (waiter = waiters, n_deliveries = 0; waiter != NULL; waiter = waiter->next)
+		++n_deliveries;
+
+	deliveries = p_malloc0 (n_deliveries * sizeof (PResolverDelivery));
+
+	if (P_LIKELY (deliveries != NULL)) {
+		for (waiter = waiters, i = 0; waiter != NULL; waiter = waiter->next, ++i) {
+			deliveries[i].func      = waiter->func;
+			deliveries[i].user_data = waiter->user_data;
+
+			pp_resolver_make_delivery (entry, waiter->port, &deliveries[i]);
+		}
+	}
+
+	entry->waiters    = NULL;
+	entry->is_pending = FALSE;
+
+	ttl = entry->error_code == P_ERROR_IO_NONE ? resolver->ttl : resolver->negative_ttl;
+
+	if (ttl > 0)
+		entry->expire_time = p_time_coarse_now_msecs () + (puint64) ttl;
+	else
+		p_str_hash_table_remove (resolver->cache, entry->hostname);
+
+	p_mutex_unlock (resolver->mutex);
+
+	for (i = 0; waiters != NULL; ++i) {
+		waiter  = waiters;
+		waiters = waiters->next;
+
+		/* Without memory for the results only the failure can be reported */
+		if (P_LIKELY (deliveries != NULL))
+			pp_resolver_deliver (&deliveries[i]);
+		else
+			waiter->func (NULL, 0, NULL, waiter->user_data);
+
+		p_free (waiter);
+	}
+
+	p_free (deliveries);
+}
+
+static void
+pp_resolver_sync_func (PSocketAddress	**addresses,
+		       psize		n_addresses,
+		       PError		*error,
+		       ppointer		user_data)
+{
+	PResolverSync *sync = (PResolverSync *) user_data;
+
+	p_mutex_lock (sync->resolver->mutex);
+
+	sync->addresses   = addresses;
+	sync->n_addresses = n_addresses;
+	sync->error       = error;
+	sync->is_done     = TRUE;
+
+	p_cond_variable_broadcast (sync->resolver->cond);
+	p_mutex_unlock (sync->resolver->mutex);
+}
+
+static pboolean
+pp_resolver_start (PResolver		*resolver,
+		   const pchar		*hostname,
+		   puint16		port,
+		   PResolverFunc	func,
+		   ppointer		user_data,
+		   PError		**error)
+{
+	PResolverEntry		*entry;
+	PResolverWaiter		*waiter;
+	PResolverDelivery	delivery;
+	pboolean		is_new = FALSE;
+
+	if (P_UNLIKELY ((waiter = p_malloc0 (sizeof (PResolverWaiter))) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for resolver lookup");
+		return FALSE;
+	}
+
+	waiter->func      = func;
+	waiter->user_data = user_data;
+	waiter->port      = port;
+
+	p_mutex_lock (resolver->mutex);
+
+	entry = pp_resolver_get_cached (resolver, hostname);
+
+	if (entry != NULL && entry->is_pending == FALSE) {
+		/* Cache hit, deliver right away */
+		delivery.func      = func;
+		delivery.user_data = user_data;
+
+		pp_resolver_make_delivery (entry, port, &delivery);
+
+		p_mutex_unlock (resolver->mutex);
+		p_free (waiter);
+
+		pp_resolver_deliver (&delivery);
+
+		return TRUE;
+	}
+
+	if (entry == NULL) {
+		if (P_UNLIKELY ((entry = p_malloc0 (sizeof (PResolverEntry))) == NULL ||
+				(entry->hostname = p_strdup (hostname)) == NULL)) {
+			p_mutex_unlock (resolver->mutex);
+
+			if (entry != NULL)
+				p_free (entry);
+
+			p_free (waiter);
+
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IO_NO_RESOURCES,
+					     0,
+					     "Failed to allocate memory for resolver entry");
+			return FALSE;
+		}
+
+		entry->resolver   = resolver;
+		entry->error_code = P_ERROR_IO_NONE;
+		entry->is_pending = TRUE;
+
+		if (P_UNLIKELY (p_str_hash_table_insert (resolver->cache, hostname, entry) == FALSE)) {
+			p_mutex_unlock (resolver->mutex);
+
+			pp_resolver_entry_free (entry);
+			p_free (waiter);
+
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IO_NO_RESOURCES,
+					     0,
+					     "Failed to allocate memory for resolver entry");
+			return FALSE;
+		}
+
+		is_new = TRUE;
+	}
+
+	/* Coalesce with the lookup in progress */
+	waiter->next   = entry->waiters;
+	entry->waiters = waiter;
+
+	if (is_new == TRUE &&
+	    P_UNLIKELY (p_thread_pool_push (resolver->pool, pp_resolver_worker, entry) == FALSE)) {
+		p_str_hash_table_remove (resolver->cache, hostname);
+		p_mutex_unlock (resolver->mutex);
+
+		p_free (waiter);
+
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to queue resolver lookup");
+		return FALSE;
+	}
+
+	p_mutex_unlock (resolver->mutex);
+
+	return TRUE;
+}
+
+P_LIB_API PResolver *
+p_resolver_new (pint	n_workers,
+		pint	ttl,
+		pint	negative_ttl,
+		PError	**error)
+{
+	PResolver *ret;
+
+	if (P_UNLIKELY (ttl < 0 || negative_ttl < 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return NULL;
+	}
+
+	if (n_workers <= 0)
+		n_workers = P_RESOLVER_DEFAULT_WORKERS;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PResolver))) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for resolver");
+		return NULL;
+	}
+
+	ret->ttl          = ttl;
+	ret->negative_ttl = negative_ttl;
+	ret->mutex        = p_mutex_new ();
+	ret->cond         = p_cond_variable_new ();
+	ret->cache        = p_str_hash_table_new (pp_resolver_entry_free);
+	ret->pool         = p_thread_pool_new (n_workers);
+
+	if (P_UNLIKELY (ret->mutex == NULL ||
+			ret->cond == NULL  ||
+			ret->cache == NULL ||
+			ret->pool == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate resolver resources");
+		p_resolver_free (ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+P_LIB_API pboolean
+p_resolver_lookup_async (PResolver	*resolver,
+			 const pchar	*hostname,
+			 puint16	port,
+			 PResolverFunc	func,
+			 ppointer	user_data,
+			 PError		**error)
+{
+	if (P_UNLIKELY (resolver == NULL || hostname == NULL || *hostname == '\0' || func == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	return pp_resolver_start (resolver, hostname, port, func, user_data, error);
+}
+
+P_LIB_API pboolean
+p_resolver_lookup (PResolver		*resolver,
+		   const pchar		*hostname,
+		   puint16		port,
+		   PSocketAddress	***addresses,
+		   psize		*n_addresses,
+		   PError		**error)
+{
+	PResolverSync sync;
+
+	if (P_UNLIKELY (resolver == NULL || hostname == NULL || *hostname == '\0' ||
+			addresses == NULL || n_addresses == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	memset (&sync, 0, sizeof (sync));
+	sync.resolver = resolver;
+
+	if (P_UNLIKELY (pp_resolver_start (resolver,
+					   hostname,
+					   port,
+					   pp_resolver_sync_func,
+					   &sync,
+					   error) == FALSE))
+		return FALSE;
+
+	p_mutex_lock (resolver->mutex);
+
+	while (sync.is_done == FALSE)
+		p_cond_variable_wait (resolver->cond, resolver->mutex);
+
+	p_mutex_unlock (resolver->mutex);
+
+	if (sync.addresses == NULL && sync.error == NULL)
+		p_error_set_error_p (&sync.error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for resolver lookup");
+
+	if (sync.error != NULL) {
+		if (error != NULL && *error == NULL)
+			*error = sync.error;
+		else
+			p_error_free (sync.error);
+
+		return FALSE;
+	}
+
+	*addresses   = sync.addresses;
+	*n_addresses = sync.n_addresses;
+
+	return TRUE;
+}
+
+P_LIB_API PSocket *
+p_resolver_connect (PResolver	*resolver,
+		    const pchar	*hostname,
+		    puint16	port,
+		    pint	delay,
+		    pint	timeout,
+		    PError	**error)
+{
+	PSocketAddress	**addresses;
+	PSocket		*ret;
+	psize		n_addresses;
+
+	if (P_UNLIKELY (p_resolver_lookup (resolver,
+					   hostname,
+					   port,
+					   &addresses,
+					   &n_addresses,
+					   error) == FALSE))
+		return NULL;
+
+	ret = p_socket_connect_any (addresses, n_addresses, delay, timeout, NULL, error);
+
+	p_resolver_free_addresses (addresses, n_addresses);
+
+	return ret;
+}
+
+P_LIB_API void
+p_resolver_clear_cache (PResolver *resolver)
+{
+	PStrHashTableIter	iter;
+	PResolverEntry		*entry;
+
+	if (P_UNLIKELY (resolver == NULL))
+		return;
+
+	p_mutex_lock (resolver->mutex);
+
+	p_str_hash_table_iter_init (&iter, resolver->cache);
+
+	while (p_str_hash_table_iter_next (&iter, NULL, NULL, (ppointer *) &entry) == TRUE) {
+		if (entry->is_pending == FALSE)
+			p_str_hash_table_iter_remove (&iter);
+	}
+
+	p_mutex_unlock (resolver->mutex);
+}
+
+P_LIB_API psize
+p_resolver_get_cache_size (PResolver *resolver)
+{
+	psize ret;
+
+	if (P_UNLIKELY (resolver == NULL))
+		return 0;
+
+	p_mutex_lock (resolver->mutex);
+	ret = p_str_hash_table_size (resolver->cache);
+	p_mutex_unlock (resolver->mutex);
+
+	return ret;
+}
+
+P_LIB_API void
+p_resolver_free_addresses (PSocketAddress	**addresses,
+			   psize		n_addresses)
+{
+	psize i;
+
+	if (P_UNLIKELY (addresses == NULL))
+		return;
+
+	for (i = 0; i < n_addresses; ++i)
+		p_socket_address_free (addresses[i]);
+
+	p_free (addresses);
+}
+
+P_LIB_API void
+p_resolver_free (PResolver *resolver)
+{
+	if (P_UNLIKELY (resolver == NULL))
+		return;
+
+	/* Lets the lookups in progress finish and deliver their results */
+	if (resolver->pool != NULL)
+		p_thread_pool_free (resolver->pool);
+
+	if (resolver->cache != NULL)
+		p_str_hash_table_free (resolver->cache);
+
+	if (resolver->cond != NULL)
+		p_cond_variable_free (resolver->cond);
+
+	if (resolver->mutex != NULL)
+		p_mutex_free (resolver->mutex);
+
+	p_free (resolver);
+}
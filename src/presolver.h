@@ -0,0 +1,203 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file presolver.h
+ * @brief Asynchronous hostname resolver
+ * @author Alexander Saprykin
+ *
+ * p_socket_address_new() accepts only numeric addresses. #PResolver resolves
+ * hostnames into lists of #PSocketAddress with the system resolver
+ * (getaddrinfo()) on a pool of worker threads, so a lookup never blocks the
+ * caller unless it asks for that with p_resolver_lookup().
+ *
+ * Results are cached by hostname: successful lookups for @a ttl milliseconds
+ * and failed ones for @a negative_ttl milliseconds, both set with
+ * p_resolver_new(). The system resolver doesn't report the TTLs of DNS
+ * records, so the same lifetime is applied to every name. Concurrent lookups
+ * of the same name are coalesced: only the first one queries the system
+ * resolver, the others wait for its result.
+ *
+ * Each lookup delivers its own copy of the addresses with the requested port,
+ * free them with p_resolver_free_addresses(). To connect to a host by name
+ * use p_resolver_connect(), it races the resolved addresses with
+ * p_socket_connect_any().
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PRESOLVER_H
+#define PLIBSYS_HEADER_PRESOLVER_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+#include "perror.h"
+#include "psocket.h"
+#include "psocketaddress.h"
+
+P_BEGIN_DECLS
+
+/** Hostname resolver opaque data type. */
+typedef struct PResolver_ PResolver;
+
+/**
+ * @brief Typedef for a lookup completion callback.
+ * @param addresses Resolved addresses, NULL in case of failure.
+ * @param n_addresses Number of addresses in @a addresses.
+ * @param error Error report object in case of failure, NULL otherwise.
+ * @param user_data Pointer passed to p_resolver_lookup_async().
+ *
+ * The callback takes ownership of @a addresses and @a error: free them with
+ * p_resolver_free_addresses() and p_error_free().
+ */
+typedef void (*PResolverFunc) (PSocketAddress	**addresses,
+			       psize		n_addresses,
+			       PError		*error,
+			       ppointer		user_data);
+
+/**
+ * @brief Creates a new hostname resolver.
+ * @param n_workers Number of worker threads, 0 or less to use a default value.
+ * @param ttl Lifetime of a successful result in the cache in milliseconds, 0
+ * to disable caching.
+ * @param negative_ttl Lifetime of a failed result in the cache in
+ * milliseconds, 0 to disable caching.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Pointer to #PResolver in case of success, NULL otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API PResolver *	p_resolver_new			(pint			n_workers,
+							 pint			ttl,
+							 pint			negative_ttl,
+							 PError			**error);
+
+/**
+ * @brief Starts resolving a hostname without blocking.
+ * @param resolver #PResolver to use.
+ * @param hostname Hostname or numeric address to resolve.
+ * @param port Port number to set in the resolved addresses.
+ * @param func Function to call with the result.
+ * @param user_data Pointer to pass into @a func, may be NULL.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE if the lookup was started, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * If the result is already cached, @a func is called from the calling thread
+ * before this call returns. Otherwise it is called from a worker thread once
+ * the lookup is finished.
+ */
+P_LIB_API pboolean	p_resolver_lookup_async		(PResolver		*resolver,
+							 const pchar		*hostname,
+							 puint16		port,
+							 PResolverFunc		func,
+							 ppointer		user_data,
+							 PError			**error);
+
+/**
+ * @brief Resolves a hostname, blocking until the result is ready.
+ * @param resolver #PResolver to use.
+ * @param hostname Hostname or numeric address to resolve.
+ * @param port Port number to set in the resolved addresses.
+ * @param[out] addresses Pointer to store the array of resolved addresses.
+ * @param[out] n_addresses Pointer to store the number of resolved addresses.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * Free the addresses with p_resolver_free_addresses() after usage. Must not be
+ * called from a lookup callback.
+ */
+P_LIB_API pboolean	p_resolver_lookup		(PResolver		*resolver,
+							 const pchar		*hostname,
+							 puint16		port,
+							 PSocketAddress		***addresses,
+							 psize			*n_addresses,
+							 PError			**error);
+
+/**
+ * @brief Resolves a hostname and connects to one of its addresses.
+ * @param resolver #PResolver to use.
+ * @param hostname Hostname or numeric address to connect to.
+ * @param port Port number to connect to.
+ * @param delay Delay between the connection attempts in milliseconds, 0 to use
+ * the default value.
+ * @param timeout Timeout for the connection in milliseconds, 0 to wait until
+ * all the attempts fail.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return New connected TCP #PSocket in blocking mode in case of success, NULL
+ * otherwise.
+ * @since 0.0.5
+ * @sa p_socket_connect_any()
+ *
+ * The resolved addresses are raced in the order returned by the system
+ * resolver. The @a timeout doesn't include the time spent on resolving.
+ */
+P_LIB_API PSocket *	p_resolver_connect		(PResolver		*resolver,
+							 const pchar		*hostname,
+							 puint16		port,
+							 pint			delay,
+							 pint			timeout,
+							 PError			**error);
+
+/**
+ * @brief Drops all the finished results from the cache of a resolver.
+ * @param resolver #PResolver to clear the cache for.
+ * @since 0.0.5
+ *
+ * Lookups in progress are not affected.
+ */
+P_LIB_API void		p_resolver_clear_cache		(PResolver		*resolver);
+
+/**
+ * @brief Gets the number of hostnames in the cache of a resolver.
+ * @param resolver #PResolver to get the number for.
+ * @return Number of cached and in progress hostnames.
+ * @since 0.0.5
+ */
+P_LIB_API psize		p_resolver_get_cache_size	(PResolver		*resolver);
+
+/**
+ * @brief Frees an array of addresses returned by a resolver.
+ * @param addresses Array of addresses to free, may be NULL.
+ * @param n_addresses Number of addresses in @a addresses.
+ * @since 0.0.5
+ */
+P_LIB_API void		p_resolver_free_addresses	(PSocketAddress		**addresses,
+							 psize			n_addresses);
+
+/**
+ * @brief Frees a resolver.
+ * @param resolver #PResolver to free.
+ * @since 0.0.5
+ *
+ * Waits for the lookups in progress to finish and calls their callbacks.
+ */
+P_LIB_API void		p_resolver_free			(PResolver		*resolver);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PRESOLVER_H */
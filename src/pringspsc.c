@@ -0,0 +1,369 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Both indices only grow and are masked only to address the buffer, so the
+ * number of elements is always tail - head, even after the indices wrap.
+ * The producer owns the tail and the consumer owns the head: each side reads
+ * its own index without synchronization and publishes it with a release
+ * store, which makes the copied elements visible before the index. The
+ * opposite index is loaded with acquire semantics, but only when the cached
+ * copy shows too little space or data. */
+
+#include "patomic.h"
+#include "pmem.h"
+#include "pringspsc.h"
+
+#include <string.h>
+
+#define P_RING_SPSC_MIN_CAPACITY	2
+
+struct PRingSPSC_ {
+	/* Producer side */
+	volatile psize	tail;
+	psize		head_cache;
+	psize		reserved;
+	pchar		pad_tail[P_MEM_CACHE_LINE_SIZE - 3 * sizeof (psize)];
+	/* Consumer side */
+	volatile psize	head;
+	psize		tail_cache;
+	psize		peeked;
+	pchar		pad_head[P_MEM_CACHE_LINE_SIZE - 3 * sizeof (psize)];
+	/* Read-only after creation */
+	pchar		*buffer;
+	psize		mask;
+	psize		element_size;
+};
+
+static psize pp_ring_spsc_get_index (const volatile psize *index, PAtomicMemoryOrder order);
+static void pp_ring_spsc_set_index (volatile psize *index, psize value);
+static psize pp_ring_spsc_get_free (PRingSPSC *ring, psize count);
+static psize pp_ring_spsc_get_available (PRingSPSC *ring, psize count);
+static void pp_ring_spsc_copy (ppointer dst, pconstpointer src, psize size);
+
+static psize
+pp_ring_spsc_get_index (const volatile psize	*index,
+			PAtomicMemoryOrder	order)
+{
+	return PPOINTER_TO_PSIZE (p_atomic_pointer_get_explicit (index, order));
+}
+
+static void
+pp_ring_spsc_set_index (volatile psize	*index,
+			psize		value)
+{
+	p_atomic_pointer_set_explicit (index, PSIZE_TO_POINTER (value), P_ATOMIC_MEMORY_ORDER_RELEASE);
+}
+
+/* Returns the free space for the producer, looks at the consumer's index only
+ * if the cached one gives less than count elements. */
+static psize
+pp_ring_spsc_get_free (PRingSPSC	*ring,
+		       psize		count)
+{
+	psize tail;
+	psize free_space;
+
+	tail       = pp_ring_spsc_get_index (&ring->tail, P_ATOMIC_MEMORY_ORDER_RELAXED);
+	free_space = ring->mask + 1 - (tail - ring->head_cache);
+
+	if (free_space < count) {
+		ring->head_cache = pp_ring_spsc_get_index (&ring->head, P_ATOMIC_MEMORY_ORDER_ACQUIRE);
+		free_space       = ring->mask + 1 - (tail - ring->head_cache);
+	}
+
+	return free_space;
+}
+
+/* Returns the elements available for the consumer, looks at the producer's
+ * index only if the cached one gives less than count elements. */
+static psize
+pp_ring_spsc_get_available (PRingSPSC	*ring,
+			    psize	count)
+{
+	psize head;
+	psize available;
+
+	head      = pp_ring_spsc_get_index (&ring->head, P_ATOMIC_MEMORY_ORDER_RELAXED);
+	available = ring->tail_cache - head;
+
+	if (available < count) {
+		ring->tail_cache = pp_ring_spsc_get_index (&ring->tail, P_ATOMIC_MEMORY_ORDER_ACQUIRE);
+		available        = ring->tail_cache - head;
+	}
+
+	return available;
+}
+
+static void
+pp_ring_spsc_copy (ppointer		dst,
+		   pconstpointer	src,
+		   psize		size)
+{
+	/* The constant size lets the compiler inline the common case */
+	if (size == sizeof (ppointer))
+		memcpy (dst, src, sizeof (ppointer));
+	else
+		memcpy (dst, src, size);
+}
+
+P_LIB_API PRingSPSC *
+p_ring_spsc_new (psize	element_size,
+		 psize	capacity)
+{
+	PRingSPSC	*ret;
+	psize		size;
+
+	if (P_UNLIKELY (element_size == 0 || capacity > P_MAXSIZE / 2))
+		return NULL;
+
+	for (size = P_RING_SPSC_MIN_CAPACITY; size < capacity; size <<= 1)
+		;
+
+	if (P_UNLIKELY (size > P_MAXSIZE / element_size))
+		return NULL;
+
+	if (P_UNLIKELY ((ret = p_malloc0_aligned (sizeof (PRingSPSC), P_MEM_CACHE_LINE_SIZE)) == NULL)) {
+		P_ERROR ("PRingSPSC::p_ring_spsc_new: failed to allocate memory");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret->buffer = p_malloc0_aligned (element_size * size, P_MEM_CACHE_LINE_SIZE)) == NULL)) {
+		P_ERROR ("PRingSPSC::p_ring_spsc_new: failed to allocate memory for buffer");
+		p_free_aligned (ret);
+		return NULL;
+	}
+
+	ret->mask         = size - 1;
+	ret->element_size = element_size;
+
+	return ret;
+}
+
+P_LIB_API pboolean
+p_ring_spsc_try_write (PRingSPSC	*ring,
+		       pconstpointer	element)
+{
+	psize tail;
+
+	if (P_UNLIKELY (ring == NULL || element == NULL))
+		return FALSE;
+
+	if (pp_ring_spsc_get_free (ring, 1) == 0)
+		return FALSE;
+
+	tail = pp_ring_spsc_get_index (&ring->tail, P_ATOMIC_MEMORY_ORDER_RELAXED);
+
+	pp_ring_spsc_copy (ring->buffer + (tail & ring->mask) * ring->element_size,
+			   element,
+			   ring->element_size);
+
+	ring->reserved = 0;
+	pp_ring_spsc_set_index (&ring->tail, tail + 1);
+
+	return TRUE;
+}
+
+P_LIB_API ppointer
+p_ring_spsc_reserve (PRingSPSC	*ring,
+		     psize	count,
+		     psize	*reserved)
+{
+	psize tail;
+	psize offset;
+	psize contiguous;
+
+	if (P_UNLIKELY (ring == NULL || count == 0 || reserved == NULL))
+		return NULL;
+
+	*reserved      = 0;
+	ring->reserved = 0;
+
+	tail       = pp_ring_spsc_get_index (&ring->tail, P_ATOMIC_MEMORY_ORDER_RELAXED);
+	offset     = tail & ring->mask;
+	contiguous = ring->mask + 1 - offset;
+
+	if (count > contiguous)
+		count = contiguous;
+
+	if ((contiguous = pp_ring_spsc_get_free (ring, count)) == 0)
+		return NULL;
+
+	if (count > contiguous)
+		count = contiguous;
+
+	*reserved      = count;
+	ring->reserved = count;
+
+	return ring->buffer + offset * ring->element_size;
+}
+
+P_LIB_API pboolean
+p_ring_spsc_commit (PRingSPSC	*ring,
+		    psize	count)
+{
+	psize tail;
+
+	if (P_UNLIKELY (ring == NULL || count > ring->reserved))
+		return FALSE;
+
+	ring->reserved = 0;
+
+	if (count == 0)
+		return TRUE;
+
+	tail = pp_ring_spsc_get_index (&ring->tail, P_ATOMIC_MEMORY_ORDER_RELAXED);
+	pp_ring_spsc_set_index (&ring->tail, tail + count);
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_ring_spsc_try_read (PRingSPSC	*ring,
+		      ppointer	element)
+{
+	return p_ring_spsc_try_read_batch (ring, element, 1) == 1;
+}
+
+P_LIB_API psize
+p_ring_spsc_try_read_batch (PRingSPSC	*ring,
+			    ppointer	elements,
+			    psize	max_count)
+{
+	psize head;
+	psize offset;
+	psize count;
+	psize first;
+
+	if (P_UNLIKELY (ring == NULL || elements == NULL || max_count == 0))
+		return 0;
+
+	if ((count = pp_ring_spsc_get_available (ring, max_count)) == 0)
+		return 0;
+
+	if (count > max_count)
+		count = max_count;
+
+	head   = pp_ring_spsc_get_index (&ring->head, P_ATOMIC_MEMORY_ORDER_RELAXED);
+	offset = head & ring->mask;
+	first  = ring->mask + 1 - offset;
+
+	if (count == 1)
+		pp_ring_spsc_copy (elements, ring->buffer + offset * ring->element_size, ring->element_size);
+	else if (count <= first)
+		memcpy (elements, ring->buffer + offset * ring->element_size, count * ring->element_size);
+	else {
+		memcpy (elements, ring->buffer + offset * ring->element_size, first * ring->element_size);
+		memcpy ((pchar *) elements + first * ring->element_size,
+			ring->buffer,
+			(count - first) * ring->element_size);
+	}
+
+	ring->peeked = 0;
+	pp_ring_spsc_set_index (&ring->head, head + count);
+
+	return count;
+}
+
+P_LIB_API pconstpointer
+p_ring_spsc_peek (PRingSPSC	*ring,
+		  psize		*available)
+{
+	psize head;
+	psize offset;
+	psize count;
+
+	if (P_UNLIKELY (ring == NULL || available == NULL))
+		return NULL;
+
+	*available   = 0;
+	ring->peeked = 0;
+
+	head   = pp_ring_spsc_get_index (&ring->head, P_ATOMIC_MEMORY_ORDER_RELAXED);
+	offset = head & ring->mask;
+
+	if ((count = pp_ring_spsc_get_available (ring, ring->mask + 1 - offset)) == 0)
+		return NULL;
+
+	if (count > ring->mask + 1 - offset)
+		count = ring->mask + 1 - offset;
+
+	*available   = count;
+	ring->peeked = count;
+
+	return ring->buffer + offset * ring->element_size;
+}
+
+P_LIB_API pboolean
+p_ring_spsc_release (PRingSPSC	*ring,
+		     psize	count)
+{
+	psize head;
+
+	if (P_UNLIKELY (ring == NULL || count > ring->peeked))
+		return FALSE;
+
+	ring->peeked = 0;
+
+	if (count == 0)
+		return TRUE;
+
+	head = pp_ring_spsc_get_index (&ring->head, P_ATOMIC_MEMORY_ORDER_RELAXED);
+	pp_ring_spsc_set_index (&ring->head, head + count);
+
+	return TRUE;
+}
+
+P_LIB_API psize
+p_ring_spsc_get_capacity (const PRingSPSC *ring)
+{
+	if (P_UNLIKELY (ring == NULL))
+		return 0;
+
+	return ring->mask + 1;
+}
+
+P_LIB_API psize
+p_ring_spsc_get_size (const PRingSPSC *ring)
+{
+	psize head;
+
+	if (P_UNLIKELY (ring == NULL))
+		return 0;
+
+	/* The head first: the tail never falls behind it afterwards */
+	head = pp_ring_spsc_get_index (&ring->head, P_ATOMIC_MEMORY_ORDER_ACQUIRE);
+
+	return pp_ring_spsc_get_index (&ring->tail, P_ATOMIC_MEMORY_ORDER_ACQUIRE) - head;
+}
+
+P_LIB_API void
+p_ring_spsc_free (PRingSPSC *ring)
+{
+	if (P_UNLIKELY (ring == NULL))
+		return;
+
+	p_free_aligned (ring->buffer);
+	p_free_aligned (ring);
+}
@@ -0,0 +1,203 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pringspsc.h
+ * @brief Single-producer single-consumer ring buffer
+ * @author Alexander Saprykin
+ *
+ * A single-producer single-consumer ring passes fixed-size elements from
+ * exactly one writing thread to exactly one reading thread. With a single
+ * thread on each side no compare and exchange is needed at all: the producer
+ * alone moves the tail, the consumer alone moves the head, and each side
+ * publishes its index with a single release store. The indices live on
+ * separate cache lines, and each side keeps a cached copy of the opposite
+ * index, so it reads the other side's cache line only when the cached value
+ * says the ring is full (or empty).
+ *
+ * The elements are copied in and out by p_ring_spsc_try_write() and
+ * p_ring_spsc_try_read_batch(). To avoid the copy, the producer can take the
+ * space for elements with p_ring_spsc_reserve(), fill them in place and
+ * publish them with p_ring_spsc_commit(). In the same way the consumer can
+ * look at the elements with p_ring_spsc_peek() and let the producer reuse
+ * the space with p_ring_spsc_release(). A reserved or peeked range is
+ * contiguous, so it may be shorter than the free space or the available
+ * elements when it meets the end of the ring.
+ *
+ * The calls of each side must come from one thread at a time, the ring does
+ * not check that. Use #PQueueMPMC for several producers or consumers.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PRINGSPSC_H
+#define PLIBSYS_HEADER_PRINGSPSC_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+
+P_BEGIN_DECLS
+
+/** Single-producer single-consumer ring opaque data type. */
+typedef struct PRingSPSC_ PRingSPSC;
+
+/**
+ * @brief Creates a new single-producer single-consumer ring.
+ * @param element_size Size of an element in bytes.
+ * @param capacity Maximum number of elements in the ring, rounded up to a
+ * power of two.
+ * @return Pointer to #PRingSPSC in case of success, NULL otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API PRingSPSC *	p_ring_spsc_new			(psize		element_size,
+							 psize		capacity);
+
+/**
+ * @brief Writes an element into a ring without waiting.
+ * @param ring #PRingSPSC to write into.
+ * @param element Element to copy into the ring.
+ * @return TRUE in case of success, FALSE if the ring is full.
+ * @since 0.0.5
+ *
+ * Called by the producer only.
+ */
+P_LIB_API pboolean	p_ring_spsc_try_write		(PRingSPSC	*ring,
+							 pconstpointer	element);
+
+/**
+ * @brief Reserves space for elements in a ring.
+ * @param ring #PRingSPSC to reserve the space in.
+ * @param count Number of elements wanted.
+ * @param[out] reserved Number of elements reserved, up to @a count.
+ * @return Pointer to the contiguous space for @a reserved elements in case of
+ * success, NULL if the ring is full.
+ * @since 0.0.5
+ *
+ * Called by the producer only. The elements are invisible for the consumer
+ * until p_ring_spsc_commit() is called. A new reservation replaces the
+ * previous uncommitted one.
+ */
+P_LIB_API ppointer	p_ring_spsc_reserve		(PRingSPSC	*ring,
+							 psize		count,
+							 psize		*reserved);
+
+/**
+ * @brief Publishes the reserved elements to the consumer.
+ * @param ring #PRingSPSC to commit the elements in.
+ * @param count Number of elements filled, from the start of the reservation.
+ * @return TRUE in case of success, FALSE if @a count is larger than the
+ * reservation.
+ * @since 0.0.5
+ *
+ * Called by the producer only. The rest of the reservation is dropped.
+ */
+P_LIB_API pboolean	p_ring_spsc_commit		(PRingSPSC	*ring,
+							 psize		count);
+
+/**
+ * @brief Reads an element from a ring without waiting.
+ * @param ring #PRingSPSC to read from.
+ * @param[out] element Buffer to copy the element into.
+ * @return TRUE in case of success, FALSE if the ring is empty.
+ * @since 0.0.5
+ *
+ * Called by the consumer only.
+ */
+P_LIB_API pboolean	p_ring_spsc_try_read		(PRingSPSC	*ring,
+							 ppointer	element);
+
+/**
+ * @brief Reads several elements from a ring without waiting.
+ * @param ring #PRingSPSC to read from.
+ * @param[out] elements Buffer to copy the elements into.
+ * @param max_count Number of elements @a elements can hold.
+ * @return Number of elements copied, 0 if the ring is empty.
+ * @since 0.0.5
+ *
+ * Called by the consumer only. The head index is published once for the
+ * whole batch.
+ */
+P_LIB_API psize		p_ring_spsc_try_read_batch	(PRingSPSC	*ring,
+							 ppointer	elements,
+							 psize		max_count);
+
+/**
+ * @brief Gets the elements available for reading in place.
+ * @param ring #PRingSPSC to peek into.
+ * @param[out] available Number of contiguous elements available.
+ * @return Pointer to the first available element in case of success, NULL if
+ * the ring is empty.
+ * @since 0.0.5
+ *
+ * Called by the consumer only. The elements stay in the ring until
+ * p_ring_spsc_release() is called.
+ */
+P_LIB_API pconstpointer	p_ring_spsc_peek		(PRingSPSC	*ring,
+							 psize		*available);
+
+/**
+ * @brief Releases the elements read in place.
+ * @param ring #PRingSPSC to release the elements in.
+ * @param count Number of elements to release, from the start of the last
+ * peeked range.
+ * @return TRUE in case of success, FALSE if @a count is larger than the
+ * peeked range.
+ * @since 0.0.5
+ *
+ * Called by the consumer only.
+ */
+P_LIB_API pboolean	p_ring_spsc_release		(PRingSPSC	*ring,
+							 psize		count);
+
+/**
+ * @brief Gets the capacity of a ring.
+ * @param ring #PRingSPSC to get the capacity for.
+ * @return Maximum number of elements in the ring.
+ * @since 0.0.5
+ */
+P_LIB_API psize		p_ring_spsc_get_capacity	(const PRingSPSC	*ring);
+
+/**
+ * @brief Gets the number of elements in a ring.
+ * @param ring #PRingSPSC to get the number for.
+ * @return Number of committed and not released elements.
+ * @since 0.0.5
+ *
+ * The number is only a snapshot when called while the other side works.
+ */
+P_LIB_API psize		p_ring_spsc_get_size		(const PRingSPSC	*ring);
+
+/**
+ * @brief Frees a ring.
+ * @param ring #PRingSPSC to free.
+ * @since 0.0.5
+ */
+P_LIB_API void		p_ring_spsc_free		(PRingSPSC	*ring);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PRINGSPSC_H */
@@ -26,49 +26,148 @@
 #include "pmem.h"
 #include "pmutex.h"
 #include "pcondvariable.h"
+#include "patomic.h"
 #include "prwlock.h"
+#include "plockstats-private.h"
 
 #include <stdlib.h>
 
-#define P_RWLOCK_SET_READERS(lock, readers) (((lock) & (~0x00007FFF)) | (readers))
-#define P_RWLOCK_READER_COUNT(lock) ((lock) & 0x00007FFF)
-#define P_RWLOCK_SET_WRITERS(lock, writers) (((lock) & (~0x3FFF8000)) | ((writers) << 15))
-#define P_RWLOCK_WRITER_COUNT(lock) (((lock) & 0x3FFF8000) >> 15)
+/* Lock state word: active readers, an active writer and a waiters flag */
+#define P_RWLOCK_READER_MASK		0x1FFFFFFF
+#define P_RWLOCK_WAITERS		0x20000000
+#define P_RWLOCK_WRITER			0x40000000
 
+/* Uncontended operations touch only the state word, the mutex and the
+ * condition variables are used only when someone has to sleep */
 struct PRWLock_ {
+	volatile pint	state;
 	PMutex		*mutex;
 	PCondVariable	*read_cv;
 	PCondVariable	*write_cv;
-	puint32		active_threads;
-	puint32		waiting_threads;
+	puint32		waiting_readers;
+	puint32		waiting_writers;
+	P_LOCK_STATS_FIELD
 };
 
+P_LOCK_STATS_DEFINE_GETTER (PRWLock, p_rwlock_get_lock_stats)
+
+static pboolean pp_rwlock_try_read (PRWLock *lock);
+static pboolean pp_rwlock_try_write (PRWLock *lock);
+static void pp_rwlock_set_waiters (PRWLock *lock);
+static void pp_rwlock_clear_waiters (PRWLock *lock);
+static pboolean pp_rwlock_wake (PRWLock *lock, const pchar *func);
+
+static pboolean
+pp_rwlock_try_read (PRWLock *lock)
+{
+	pint state;
+
+	for (;;) {
+		state = p_atomic_int_get (&lock->state);
+
+		if (state & P_RWLOCK_WRITER)
+			return FALSE;
+
+		if (P_UNLIKELY ((state & P_RWLOCK_READER_MASK) == P_RWLOCK_READER_MASK))
+			return FALSE;
+
+		if (p_atomic_int_compare_and_exchange (&lock->state, state, state + 1))
+			return TRUE;
+	}
+}
+
+static pboolean
+pp_rwlock_try_write (PRWLock *lock)
+{
+	pint state;
+
+	for (;;) {
+		state = p_atomic_int_get (&lock->state);
+
+		if (state & ~P_RWLOCK_WAITERS)
+			return FALSE;
+
+		if (p_atomic_int_compare_and_exchange (&lock->state, state, state | P_RWLOCK_WRITER))
+			return TRUE;
+	}
+}
+
+/* Both are called with the mutex held: the waiters flag follows the number
+ * of the sleeping threads, so the unlock fast paths know when to wake */
+static void
+pp_rwlock_set_waiters (PRWLock *lock)
+{
+	p_atomic_int_or ((volatile puint *) &lock->state, (puint) P_RWLOCK_WAITERS);
+}
+
+static void
+pp_rwlock_clear_waiters (PRWLock *lock)
+{
+	if (lock->waiting_readers == 0 && lock->waiting_writers == 0)
+		p_atomic_int_and ((volatile puint *) &lock->state, (puint) ~P_RWLOCK_WAITERS);
+}
+
+static pboolean
+pp_rwlock_wake (PRWLock		*lock,
+		const pchar	*func)
+{
+	pboolean signal_ok = TRUE;
+
+	if (P_UNLIKELY (p_mutex_lock (lock->mutex) == FALSE)) {
+		P_ERROR ("PRWLock::pp_rwlock_wake: p_mutex_lock() failed");
+		return FALSE;
+	}
+
+	/* Writers are in favor, as in the mutex based implementation */
+	if (lock->waiting_writers > 0) {
+		if (P_UNLIKELY (p_cond_variable_signal (lock->write_cv) == FALSE)) {
+			P_ERROR (func);
+			signal_ok = FALSE;
+		}
+	} else if (lock->waiting_readers > 0) {
+		if (P_UNLIKELY (p_cond_variable_broadcast (lock->read_cv) == FALSE)) {
+			P_ERROR (func);
+			signal_ok = FALSE;
+		}
+	}
+
+	if (P_UNLIKELY (p_mutex_unlock (lock->mutex) == FALSE)) {
+		P_ERROR ("PRWLock::pp_rwlock_wake: p_mutex_unlock() failed");
+		return FALSE;
+	}
+
+	return signal_ok;
+}
+
 P_LIB_API PRWLock *
 p_rwlock_new (void)
 {
 	PRWLock *ret;
 
-	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PRWLock))) == NULL)) {
+	if (P_UNLIKELY ((ret = p_malloc0_aligned (sizeof (PRWLock), P_MEM_CACHE_LINE_SIZE)) == NULL)) {
 		P_ERROR ("PRWLock::p_rwlock_new: failed to allocate memory");
 		return NULL;
 	}
 
 	if (P_UNLIKELY ((ret->mutex = p_mutex_new ()) == NULL)) {
 		P_ERROR ("PRWLock::p_rwlock_new: failed to allocate mutex");
-		p_free (ret);
+		p_free_aligned (ret);
+		return NULL;
 	}
 
 	if (P_UNLIKELY ((ret->read_cv = p_cond_variable_new ()) == NULL)) {
 		P_ERROR ("PRWLock::p_rwlock_new: failed to allocate condition variable for read");
 		p_mutex_free (ret->mutex);
-		p_free (ret);
+		p_free_aligned (ret);
+		return NULL;
 	}
 
 	if (P_UNLIKELY ((ret->write_cv = p_cond_variable_new ()) == NULL)) {
 		P_ERROR ("PRWLock::p_rwlock_new: failed to allocate condition variable for write");
 		p_cond_variable_free (ret->read_cv);
 		p_mutex_free (ret->mutex);
-		p_free (ret);
+		p_free_aligned (ret);
+		return NULL;
 	}
 
 	return ret;
@@ -77,11 +176,18 @@ p_rwlock_new (void)
 P_LIB_API pboolean
 p_rwlock_reader_lock (PRWLock *lock)
 {
-	pboolean wait_ok;
+	pint		state;
+	pboolean	wait_ok;
 
 	if (P_UNLIKELY (lock == NULL))
 		return FALSE;
 
+	state = p_atomic_int_get (&lock->state);
+
+	if (P_LIKELY ((state & (P_RWLOCK_WRITER | P_RWLOCK_WAITERS)) == 0 &&
+		      p_atomic_int_compare_and_exchange (&lock->state, state, state + 1)))
+		return TRUE;
+
 	if (P_UNLIKELY (p_mutex_lock (lock->mutex) == FALSE)) {
 		P_ERROR ("PRWLock::p_rwlock_reader_lock: p_mutex_lock() failed");
 		return FALSE;
@@ -89,11 +195,11 @@ p_rwlock_reader_lock (PRWLock *lock)
 
 	wait_ok = TRUE;
 
-	if (P_RWLOCK_WRITER_COUNT (lock->active_threads)) {
-		lock->waiting_threads = P_RWLOCK_SET_READERS (lock->waiting_threads,
-							      P_RWLOCK_READER_COUNT (lock->waiting_threads) + 1);
+	if (!pp_rwlock_try_read (lock)) {
+		++lock->waiting_readers;
+		pp_rwlock_set_waiters (lock);
 
-		while (P_RWLOCK_WRITER_COUNT (lock->active_threads)) {
+		while (!pp_rwlock_try_read (lock)) {
 			wait_ok = p_cond_variable_wait (lock->read_cv, lock->mutex);
 
 			if (P_UNLIKELY (wait_ok == FALSE)) {
@@ -102,14 +208,10 @@ p_rwlock_reader_lock (PRWLock *lock)
 			}
 		}
 
-		lock->waiting_threads = P_RWLOCK_SET_READERS (lock->waiting_threads,
-							      P_RWLOCK_READER_COUNT (lock->waiting_threads) - 1);
+		--lock->waiting_readers;
+		pp_rwlock_clear_waiters (lock);
 	}
 
-	if (P_LIKELY (wait_ok == TRUE))
-		lock->active_threads = P_RWLOCK_SET_READERS (lock->active_threads,
-							     P_RWLOCK_READER_COUNT (lock->active_threads) + 1);
-
 	if (P_UNLIKELY (p_mutex_unlock (lock->mutex) == FALSE)) {
 		P_ERROR ("PRWLock::p_rwlock_reader_lock: p_mutex_unlock() failed");
 		return FALSE;
@@ -124,68 +226,32 @@ p_rwlock_reader_trylock (PRWLock *lock)
 	if (P_UNLIKELY (lock == NULL))
 		return FALSE;
 
-	if (P_UNLIKELY (p_mutex_lock (lock->mutex) == FALSE)) {
-		P_ERROR ("PRWLock::p_rwlock_reader_trylock: p_mutex_lock() failed");
-		return FALSE;
-	}
-
-	if (P_RWLOCK_WRITER_COUNT (lock->active_threads)) {
-		if (P_UNLIKELY (p_mutex_unlock (lock->mutex) == FALSE))
-			P_ERROR ("PRWLock::p_rwlock_reader_trylock: p_mutex_unlock() failed(1)");
-
-		return FALSE;
-	}
-
-	lock->active_threads = P_RWLOCK_SET_READERS (lock->active_threads,
-						     P_RWLOCK_READER_COUNT (lock->active_threads) + 1);
-
-	if (P_UNLIKELY (p_mutex_unlock (lock->mutex) == FALSE)) {
-		P_ERROR ("PRWLock::p_rwlock_reader_trylock: p_mutex_unlock() failed(2)");
-		return FALSE;
-	}
-
-	return TRUE;
+	return pp_rwlock_try_read (lock);
 }
 
 P_LIB_API pboolean
 p_rwlock_reader_unlock (PRWLock *lock)
 {
-	puint32		reader_count;
-	pboolean	signal_ok;
+	pint state;
 
 	if (P_UNLIKELY (lock == NULL))
 		return FALSE;
 
-	if (P_UNLIKELY (p_mutex_lock (lock->mutex) == FALSE)) {
-		P_ERROR ("PRWLock::p_rwlock_reader_unlock: p_mutex_lock() failed");
-		return FALSE;
-	}
-
-	reader_count = P_RWLOCK_READER_COUNT (lock->active_threads);
+	for (;;) {
+		state = p_atomic_int_get (&lock->state);
 
-	if (P_UNLIKELY (reader_count == 0)) {
-		if (P_UNLIKELY (p_mutex_unlock (lock->mutex) == FALSE))
-			P_ERROR ("PRWLock::p_rwlock_reader_unlock: p_mutex_unlock() failed(1)");
+		if (P_UNLIKELY ((state & P_RWLOCK_READER_MASK) == 0))
+			return TRUE;
 
-		return TRUE;
+		if (p_atomic_int_compare_and_exchange (&lock->state, state, state - 1))
+			break;
 	}
 
-	lock->active_threads = P_RWLOCK_SET_READERS (lock->active_threads, reader_count - 1);
-
-	signal_ok = TRUE;
-
-	if (reader_count == 1 && P_RWLOCK_WRITER_COUNT (lock->waiting_threads))
-		signal_ok = p_cond_variable_signal (lock->write_cv);
-
-	if (P_UNLIKELY (signal_ok == FALSE))
-		P_ERROR ("PRWLock::p_rwlock_reader_unlock: p_cond_variable_signal() failed");
-
-	if (P_UNLIKELY (p_mutex_unlock (lock->mutex) == FALSE)) {
-		P_ERROR ("PRWLock::p_rwlock_reader_unlock: p_mutex_unlock() failed(2)");
-		return FALSE;
-	}
+	/* The last reader hands the lock over to a sleeping thread */
+	if (P_LIKELY ((state & P_RWLOCK_WAITERS) == 0 || (state & P_RWLOCK_READER_MASK) != 1))
+		return TRUE;
 
-	return signal_ok;
+	return pp_rwlock_wake (lock, "PRWLock::p_rwlock_reader_unlock: p_cond_variable_signal() failed");
 }
 
 P_LIB_API pboolean
@@ -196,6 +262,9 @@ p_rwlock_writer_lock (PRWLock *lock)
 	if (P_UNLIKELY (lock == NULL))
 		return FALSE;
 
+	if (P_LIKELY (p_atomic_int_compare_and_exchange (&lock->state, 0, P_RWLOCK_WRITER)))
+		return TRUE;
+
 	if (P_UNLIKELY (p_mutex_lock (lock->mutex) == FALSE)) {
 		P_ERROR ("PRWLock::p_rwlock_writer_lock: p_mutex_lock() failed");
 		return FALSE;
@@ -203,11 +272,11 @@ p_rwlock_writer_lock (PRWLock *lock)
 
 	wait_ok = TRUE;
 
-	if (lock->active_threads) {
-		lock->waiting_threads = P_RWLOCK_SET_WRITERS (lock->waiting_threads,
-							      P_RWLOCK_WRITER_COUNT (lock->waiting_threads) + 1);
+	if (!pp_rwlock_try_write (lock)) {
+		++lock->waiting_writers;
+		pp_rwlock_set_waiters (lock);
 
-		while (lock->active_threads) {
+		while (!pp_rwlock_try_write (lock)) {
 			wait_ok = p_cond_variable_wait (lock->write_cv, lock->mutex);
 
 			if (P_UNLIKELY (wait_ok == FALSE)) {
@@ -216,13 +285,10 @@ p_rwlock_writer_lock (PRWLock *lock)
 			}
 		}
 
-		lock->waiting_threads = P_RWLOCK_SET_WRITERS (lock->waiting_threads,
-							      P_RWLOCK_WRITER_COUNT (lock->waiting_threads) - 1);
+		--lock->waiting_writers;
+		pp_rwlock_clear_waiters (lock);
 	}
 
-	if (P_LIKELY (wait_ok == TRUE))
-		lock->active_threads = P_RWLOCK_SET_WRITERS (lock->active_threads, 1);
-
 	if (P_UNLIKELY (p_mutex_unlock (lock->mutex) == FALSE)) {
 		P_ERROR ("PRWLock::p_rwlock_writer_lock: p_mutex_unlock() failed");
 		return FALSE;
@@ -237,63 +303,31 @@ p_rwlock_writer_trylock (PRWLock *lock)
 	if (P_UNLIKELY (lock == NULL))
 		return FALSE;
 
-	if (P_UNLIKELY (p_mutex_lock (lock->mutex) == FALSE)) {
-		P_ERROR ("PRWLock::p_rwlock_writer_trylock: p_mutex_lock() failed");
-		return FALSE;
-	}
-
-	if (lock->active_threads) {
-		if (P_UNLIKELY (p_mutex_unlock (lock->mutex) == FALSE))
-			P_ERROR ("PRWLock::p_rwlock_writer_trylock: p_mutex_unlock() failed(1)");
-
-		return FALSE;
-	}
-
-	lock->active_threads = P_RWLOCK_SET_WRITERS (lock->active_threads, 1);
-
-	if (P_UNLIKELY (p_mutex_unlock (lock->mutex) == FALSE)) {
-		P_ERROR ("PRWLock::p_rwlock_writer_trylock: p_mutex_unlock() failed(2)");
-		return FALSE;
-	}
-
-	return TRUE;
+	return pp_rwlock_try_write (lock);
 }
 
 P_LIB_API pboolean
 p_rwlock_writer_unlock (PRWLock *lock)
 {
-	pboolean signal_ok;
+	pint state;
 
 	if (P_UNLIKELY (lock == NULL))
 		return FALSE;
 
-	if (P_UNLIKELY (p_mutex_lock (lock->mutex) == FALSE)) {
-		P_ERROR ("PRWLock::p_rwlock_writer_unlock: p_mutex_lock() failed");
-		return FALSE;
-	}
-
-	lock->active_threads = P_RWLOCK_SET_WRITERS (lock->active_threads, 0);
+	for (;;) {
+		state = p_atomic_int_get (&lock->state);
 
-	signal_ok = TRUE;
+		if (P_UNLIKELY ((state & P_RWLOCK_WRITER) == 0))
+			return TRUE;
 
-	if (P_RWLOCK_WRITER_COUNT (lock->waiting_threads)) {
-		if (P_UNLIKELY (p_cond_variable_signal (lock->write_cv) == FALSE)) {
-			P_ERROR ("PRWLock::p_rwlock_writer_unlock: p_cond_variable_signal() failed");
-			signal_ok = FALSE;
-		}
-	} else if (P_RWLOCK_READER_COUNT (lock->waiting_threads)) {
-		if (P_UNLIKELY (p_cond_variable_broadcast (lock->read_cv) == FALSE)) {
-			P_ERROR ("PRWLock::p_rwlock_writer_unlock: p_cond_variable_broadcast() failed");
-			signal_ok = FALSE;
-		}
+		if (p_atomic_int_compare_and_exchange (&lock->state, state, state & ~P_RWLOCK_WRITER))
+			break;
 	}
 
-	if (P_UNLIKELY (p_mutex_unlock (lock->mutex) == FALSE)) {
-		P_ERROR ("PRWLock::p_rwlock_writer_unlock: p_mutex_unlock() failed");
-		return FALSE;
-	}
+	if (P_LIKELY ((state & P_RWLOCK_WAITERS) == 0))
+		return TRUE;
 
-	return signal_ok;
+	return pp_rwlock_wake (lock, "PRWLock::p_rwlock_writer_unlock: p_cond_variable_signal() failed");
 }
 
 P_LIB_API void
@@ -302,17 +336,17 @@ p_rwlock_free (PRWLock *lock)
 	if (P_UNLIKELY (lock == NULL))
 		return;
 
-	if (P_UNLIKELY (lock->active_threads))
+	if (P_UNLIKELY (p_atomic_int_get (&lock->state) & ~P_RWLOCK_WAITERS))
 		P_WARNING ("PRWLock::p_rwlock_free: destroying while active threads are present");
 
-	if (P_UNLIKELY (lock->waiting_threads))
+	if (P_UNLIKELY (lock->waiting_readers || lock->waiting_writers))
 		P_WARNING ("PRWLock::p_rwlock_free: destroying while waiting threads are present");
 
 	p_mutex_free (lock->mutex);
 	p_cond_variable_free (lock->read_cv);
 	p_cond_variable_free (lock->write_cv);
 
-	p_free (lock);
+	p_free_aligned (lock);
 }
 
 void
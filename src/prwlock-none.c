@@ -24,13 +24,17 @@
  */
 
 #include "prwlock.h"
+#include "plockstats-private.h"
 
 #include <stdlib.h>
 
 struct PRWLock_ {
 	pint hdl;
+	P_LOCK_STATS_FIELD
 };
 
+P_LOCK_STATS_DEFINE_GETTER (PRWLock, p_rwlock_get_lock_stats)
+
 P_LIB_API PRWLock *
 p_rwlock_new (void)
 {
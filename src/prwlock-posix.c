@@ -25,6 +25,7 @@
 
 #include "pmem.h"
 #include "prwlock.h"
+#include "plockstats-private.h"
 
 #include <stdlib.h>
 #include "pthread.h"
@@ -33,8 +34,11 @@ typedef pthread_rwlock_t rwlock_hdl;
 
 struct PRWLock_ {
 	rwlock_hdl hdl;
+	P_LOCK_STATS_FIELD
 };
 
+P_LOCK_STATS_DEFINE_GETTER (PRWLock, p_rwlock_get_lock_stats)
+
 static pboolean pp_rwlock_unlock_any (PRWLock *lock);
 
 static pboolean
@@ -56,14 +60,14 @@ p_rwlock_new (void)
 {
 	PRWLock *ret;
 
-	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PRWLock))) == NULL)) {
+	if (P_UNLIKELY ((ret = p_malloc0_aligned (sizeof (PRWLock), P_MEM_CACHE_LINE_SIZE)) == NULL)) {
 		P_ERROR ("PRWLock::p_rwlock_new: failed to allocate memory");
 		return NULL;
 	}
 
 	if (P_UNLIKELY (pthread_rwlock_init (&ret->hdl, NULL) != 0)) {
 		P_ERROR ("PRWLock::p_rwlock_new: pthread_rwlock_init() failed");
-		p_free (ret);
+		p_free_aligned (ret);
 		return NULL;
 	}
 
@@ -137,7 +141,7 @@ p_rwlock_free (PRWLock *lock)
 	if (P_UNLIKELY (pthread_rwlock_destroy (&lock->hdl) != 0))
 		P_ERROR ("PRWLock::p_rwlock_free: pthread_rwlock_destroy() failed");
 
-	p_free (lock);
+	p_free_aligned (lock);
 }
 
 void
@@ -29,6 +29,7 @@
 #include "patomic.h"
 #include "puthread.h"
 #include "prwlock.h"
+#include "plockstats-private.h"
 
 #include <stdlib.h>
 
@@ -85,8 +86,11 @@ typedef struct PRWLockXP_ {
 
 struct PRWLock_ {
 	ppointer lock;
+	P_LOCK_STATS_FIELD
 };
 
+P_LOCK_STATS_DEFINE_GETTER (PRWLock, p_rwlock_get_lock_stats)
+
 static PRWLockVistaTable pp_rwlock_vista_table = {NULL, NULL, NULL, NULL,
 						  NULL, NULL, NULL};
 
@@ -177,7 +181,7 @@ pp_rwlock_init_xp (PRWLock *lock)
 {
 	PRWLockXP *rwl_xp;
 
-	if ((lock->lock = p_malloc0 (sizeof (PRWLockXP))) == NULL) {
+	if ((lock->lock = p_malloc0_aligned (sizeof (PRWLockXP), P_MEM_CACHE_LINE_SIZE)) == NULL) {
 		P_ERROR ("PRWLock::pp_rwlock_init_xp: failed to allocate memory");
 		return FALSE;
 	}
@@ -189,7 +193,7 @@ pp_rwlock_init_xp (PRWLock *lock)
 
 	if (P_UNLIKELY (rwl_xp->event == NULL)) {
 		P_ERROR ("PRWLock::pp_rwlock_init_xp: CreateEventA() failed");
-		p_free (lock->lock);
+		p_free_aligned (lock->lock);
 		lock->lock = NULL;
 		return FALSE;
 	}
@@ -201,7 +205,7 @@ static void
 pp_rwlock_close_xp (PRWLock *lock)
 {
 	CloseHandle (((PRWLockXP *) lock->lock)->event);
-	p_free (lock->lock);
+	p_free_aligned (lock->lock);
 }
 
 static pboolean
@@ -406,14 +410,14 @@ p_rwlock_new (void)
 {
 	PRWLock *ret;
 
-	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PRWLock))) == NULL)) {
+	if (P_UNLIKELY ((ret = p_malloc0_aligned (sizeof (PRWLock), P_MEM_CACHE_LINE_SIZE)) == NULL)) {
 		P_ERROR ("PRWLock::p_rwlock_new: failed to allocate memory");
 		return NULL;
 	}
 
 	if (P_UNLIKELY (pp_rwlock_init_func (ret) != TRUE)) {
 		P_ERROR ("PRWLock::p_rwlock_new: failed to initialize");
-		p_free (ret);
+		p_free_aligned (ret);
 		return NULL;
 	}
 
@@ -481,7 +485,7 @@ p_rwlock_free (PRWLock *lock)
 		return;
 
 	pp_rwlock_close_func (lock);
-	p_free (lock);
+	p_free_aligned (lock);
 }
 
 void
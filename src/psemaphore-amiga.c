@@ -27,6 +27,7 @@
 #include "pmem.h"
 #include "psemaphore.h"
 #include "pipc-private.h"
+#include "puthread.h"
 
 #include <stdlib.h>
 #include <string.h>
@@ -203,6 +204,33 @@ p_semaphore_acquire (PSemaphore	*sem,
 	return TRUE;
 }
 
+P_LIB_API pint
+p_semaphore_acquire_until (PSemaphore		*sem,
+			   const PDeadline	*deadline,
+			   PError		**error)
+{
+	if (P_UNLIKELY (sem == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	if (p_deadline_is_infinite (deadline) == TRUE)
+		return p_semaphore_acquire (sem, error) == TRUE ? 1 : -1;
+
+	/* No timed wait, poll the semaphore */
+	while (IExec->AttemptSemaphore (sem->sem_shared) == FALSE) {
+		if (p_deadline_has_expired (deadline) == TRUE)
+			return 0;
+
+		p_uthread_sleep (1);
+	}
+
+	return 1;
+}
+
 P_LIB_API pboolean
 p_semaphore_release (PSemaphore	*sem,
 		     PError	**error)
@@ -69,6 +69,22 @@ p_semaphore_acquire (PSemaphore	*sem,
 	return FALSE;
 }
 
+P_LIB_API pint
+p_semaphore_acquire_until (PSemaphore		*sem,
+			   const PDeadline	*deadline,
+			   PError		**error)
+{
+	P_UNUSED (sem);
+	P_UNUSED (deadline);
+
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IPC_NOT_IMPLEMENTED,
+			     0,
+			     "No semaphore implementation");
+
+	return -1;
+}
+
 P_LIB_API pboolean
 p_semaphore_release (PSemaphore	*sem,
 		     PError	**error)
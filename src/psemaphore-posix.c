@@ -37,6 +37,12 @@
 #include <semaphore.h>
 #include <errno.h>
 
+#if defined (PLIBSYS_HAS_SEM_CLOCKWAIT) || defined (PLIBSYS_HAS_SEM_TIMEDWAIT)
+#  include <time.h>
+#else
+#  include "puthread.h"
+#endif
+
 #define P_SEM_SUFFIX		"_p_sem_object"
 
 typedef sem_t psem_hdl;
@@ -232,6 +238,83 @@ p_semaphore_acquire (PSemaphore	*sem,
 	return ret;
 }
 
+P_LIB_API pint
+p_semaphore_acquire_until (PSemaphore		*sem,
+			   const PDeadline	*deadline,
+			   PError		**error)
+{
+	puint64		remaining;
+	pint		res;
+#if defined (PLIBSYS_HAS_SEM_CLOCKWAIT) || defined (PLIBSYS_HAS_SEM_TIMEDWAIT)
+	struct timespec	ts;
+#endif
+
+	if (P_UNLIKELY (sem == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	if (p_deadline_is_infinite (deadline) == TRUE)
+		return p_semaphore_acquire (sem, error) == TRUE ? 1 : -1;
+
+	while (TRUE) {
+		if ((res = sem_trywait (sem->sem_hdl)) == 0)
+			return 1;
+
+		if (P_UNLIKELY (p_error_get_last_system () != EAGAIN && p_error_get_last_system () != EINTR))
+			break;
+
+		if ((remaining = p_deadline_get_remaining_nsecs (deadline)) == 0)
+			return 0;
+
+#if defined (PLIBSYS_HAS_SEM_CLOCKWAIT) || defined (PLIBSYS_HAS_SEM_TIMEDWAIT)
+		/* sem_timedwait() takes the system time, so the deadline is
+		 * checked again on a timeout in case the time has been changed */
+#  ifdef PLIBSYS_HAS_SEM_CLOCKWAIT
+		res = clock_gettime (CLOCK_MONOTONIC, &ts);
+#  else
+		res = clock_gettime (CLOCK_REALTIME, &ts);
+#  endif
+
+		if (P_UNLIKELY (res != 0))
+			break;
+
+		ts.tv_sec  += (time_t) (remaining / 1000000000);
+		ts.tv_nsec += (long) (remaining % 1000000000);
+
+		if (ts.tv_nsec >= 1000000000L) {
+			ts.tv_sec  += 1;
+			ts.tv_nsec -= 1000000000L;
+		}
+
+#  ifdef PLIBSYS_HAS_SEM_CLOCKWAIT
+		res = sem_clockwait (sem->sem_hdl, CLOCK_MONOTONIC, &ts);
+#  else
+		res = sem_timedwait (sem->sem_hdl, &ts);
+#  endif
+
+		if (res == 0)
+			return 1;
+
+		if (P_UNLIKELY (p_error_get_last_system () != ETIMEDOUT && p_error_get_last_system () != EINTR))
+			break;
+#else
+		/* No timed wait, poll the semaphore */
+		p_uthread_sleep (1);
+#endif
+	}
+
+	p_error_set_error_p (error,
+			     (pint) p_error_get_last_ipc (),
+			     p_error_get_last_system (),
+			     "Failed to wait on semaphore");
+
+	return -1;
+}
+
 P_LIB_API pboolean
 p_semaphore_release (PSemaphore	*sem,
 		     PError	**error)
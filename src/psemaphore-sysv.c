@@ -40,6 +40,12 @@
 #include <sys/types.h>
 #include <sys/ipc.h>
 
+#ifdef PLIBSYS_HAS_SEMTIMEDOP
+#  include <time.h>
+#else
+#  include "puthread.h"
+#endif
+
 #define P_SEM_SUFFIX		"_p_sem_object"
 #define P_SEM_INVALID_HDL	-1
 
@@ -262,6 +268,77 @@ p_semaphore_acquire (PSemaphore	*sem,
 	return ret;
 }
 
+P_LIB_API pint
+p_semaphore_acquire_until (PSemaphore		*sem,
+			   const PDeadline	*deadline,
+			   PError		**error)
+{
+	struct sembuf	sem_trylock = {0, -1, SEM_UNDO | IPC_NOWAIT};
+	puint64		remaining;
+	pboolean	recreated = FALSE;
+	pint		res;
+#ifdef PLIBSYS_HAS_SEMTIMEDOP
+	struct timespec	ts;
+#endif
+
+	if (P_UNLIKELY (sem == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	if (p_deadline_is_infinite (deadline) == TRUE)
+		return p_semaphore_acquire (sem, error) == TRUE ? 1 : -1;
+
+	while (TRUE) {
+		if ((res = semop (sem->sem_hdl, &sem_trylock, 1)) == 0)
+			return 1;
+
+		if (P_UNLIKELY ((p_error_get_last_system () == EIDRM ||
+				 p_error_get_last_system () == EINVAL) && recreated == FALSE)) {
+			P_WARNING ("PSemaphore::p_semaphore_acquire_until: trying to recreate");
+			pp_semaphore_clean_handle (sem);
+
+			if (P_UNLIKELY (pp_semaphore_create_handle (sem, error) == FALSE))
+				return -1;
+
+			recreated = TRUE;
+			continue;
+		}
+
+		if (P_UNLIKELY (p_error_get_last_system () != EAGAIN && p_error_get_last_system () != EINTR))
+			break;
+
+		if ((remaining = p_deadline_get_remaining_nsecs (deadline)) == 0)
+			return 0;
+
+#ifdef PLIBSYS_HAS_SEMTIMEDOP
+		/* The timeout is relative, so it is measured with a monotonic clock */
+		ts.tv_sec  = (time_t) (remaining / 1000000000);
+		ts.tv_nsec = (long) (remaining % 1000000000);
+
+		if ((res = semtimedop (sem->sem_hdl, &sem_lock, 1, &ts)) == 0)
+			return 1;
+
+		if (P_UNLIKELY (p_error_get_last_system () != EAGAIN && p_error_get_last_system () != EINTR &&
+				p_error_get_last_system () != EIDRM && p_error_get_last_system () != EINVAL))
+			break;
+#else
+		/* No timed wait, poll the semaphore */
+		p_uthread_sleep (1);
+#endif
+	}
+
+	p_error_set_error_p (error,
+			     (pint) p_error_get_last_ipc (),
+			     p_error_get_last_system (),
+			     "Failed to call semop() on semaphore");
+
+	return -1;
+}
+
 P_LIB_API pboolean
 p_semaphore_release (PSemaphore	*sem,
 		     PError	**error)
@@ -164,6 +164,46 @@ p_semaphore_acquire (PSemaphore	*sem,
 	return ret;
 }
 
+P_LIB_API pint
+p_semaphore_acquire_until (PSemaphore		*sem,
+			   const PDeadline	*deadline,
+			   PError		**error)
+{
+	DWORD	res;
+	pint	timeout;
+
+	if (P_UNLIKELY (sem == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	/* The wait is measured with the tick count, rounded milliseconds may
+	 * finish a bit early, so check the deadline again */
+	while (TRUE) {
+		timeout = p_deadline_get_remaining_msecs (deadline);
+		res     = WaitForSingleObject (sem->sem_hdl, timeout < 0 ? INFINITE : (DWORD) timeout);
+
+		if (res == WAIT_OBJECT_0)
+			return 1;
+
+		if (res != WAIT_TIMEOUT)
+			break;
+
+		if (p_deadline_has_expired (deadline) == TRUE)
+			return 0;
+	}
+
+	p_error_set_error_p (error,
+			     (pint) p_error_get_last_ipc (),
+			     p_error_get_last_system (),
+			     "Failed to call WaitForSingleObject() on semaphore");
+
+	return -1;
+}
+
 P_LIB_API pboolean
 p_semaphore_release (PSemaphore	*sem,
 		     PError	**error)
@@ -101,6 +101,7 @@
 #include "pmacros.h"
 #include "ptypes.h"
 #include "perror.h"
+#include "pdeadline.h"
 
 P_BEGIN_DECLS
 
@@ -166,6 +167,29 @@ P_LIB_API void		p_semaphore_take_ownership	(PSemaphore		*sem);
 P_LIB_API pboolean	p_semaphore_acquire		(PSemaphore		*sem,
 							 PError			**error);
 
+/**
+ * @brief Acquires (P operation) a semaphore, waiting no longer than until a
+ * deadline.
+ * @param sem #PSemaphore to acquire.
+ * @param deadline Deadline to wait until, NULL to wait infinitely.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return 1 if the semaphore has been acquired, 0 if the deadline has
+ * expired, -1 in case of error.
+ * @since 0.0.5
+ *
+ * If the semaphore can be acquired immediately it is acquired even after the
+ * deadline has expired.
+ *
+ * The wait follows the monotonic clock where the system allows
+ * (sem_clockwait(), semtimedop() or WaitForSingleObject()). Otherwise the
+ * absolute system time is used and the deadline is checked again after a
+ * timeout, or the semaphore is polled every millisecond if no timed wait is
+ * available at all (i.e. on macOS and AmigaOS). Not supported on OS/2.
+ */
+P_LIB_API pint		p_semaphore_acquire_until	(PSemaphore		*sem,
+							 const PDeadline	*deadline,
+							 PError			**error);
+
 /**
  * @brief Releases (V operation) a semaphore.
  * @param sem #PSemaphore to release.
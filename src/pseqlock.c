@@ -0,0 +1,148 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* The sequence number is odd while a writer is inside, so taking the write
+ * lock is a compare-and-swap from an even value to the next odd one. The
+ * barriers keep the data accesses between the sequence number reads and
+ * writes on the weakly ordered CPUs. */
+
+#include "patomic.h"
+#include "pcpurelax-private.h"
+#include "pmem.h"
+#include "pseqlock.h"
+
+struct PSeqLock_ {
+	volatile pint	sequence;
+};
+
+P_LIB_API PSeqLock *
+p_seq_lock_new (void)
+{
+	PSeqLock *ret;
+
+	if (P_UNLIKELY ((ret = p_malloc0_aligned (sizeof (PSeqLock), P_MEM_CACHE_LINE_SIZE)) == NULL)) {
+		P_ERROR ("PSeqLock::p_seq_lock_new: failed to allocate memory");
+		return NULL;
+	}
+
+	return ret;
+}
+
+P_LIB_API puint
+p_seq_lock_read_begin (const PSeqLock *lock)
+{
+	puint	seq;
+	pint	backoff = 1;
+
+	if (P_UNLIKELY (lock == NULL))
+		return 0;
+
+	while (((seq = (puint) p_atomic_int_get (&lock->sequence)) & 1) != 0)
+		P_CPU_BACKOFF (backoff);
+
+	return seq;
+}
+
+P_LIB_API pboolean
+p_seq_lock_read_retry (const PSeqLock	*lock,
+		       puint		seq)
+{
+	if (P_UNLIKELY (lock == NULL))
+		return FALSE;
+
+	p_atomic_memory_barrier ();
+
+	return (puint) p_atomic_int_get (&lock->sequence) != seq;
+}
+
+P_LIB_API pboolean
+p_seq_lock_write_lock (PSeqLock *lock)
+{
+	pint	seq;
+	pint	backoff = 1;
+
+	if (P_UNLIKELY (lock == NULL))
+		return FALSE;
+
+	for (;;) {
+		seq = p_atomic_int_get (&lock->sequence);
+
+		if ((seq & 1) == 0 &&
+		    p_atomic_int_compare_and_exchange (&lock->sequence, seq, (pint) ((puint) seq + 1)))
+			break;
+
+		P_CPU_BACKOFF (backoff);
+	}
+
+	p_atomic_memory_barrier ();
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_seq_lock_write_trylock (PSeqLock *lock)
+{
+	pint seq;
+
+	if (P_UNLIKELY (lock == NULL))
+		return FALSE;
+
+	seq = p_atomic_int_get (&lock->sequence);
+
+	if ((seq & 1) != 0 ||
+	    !p_atomic_int_compare_and_exchange (&lock->sequence, seq, (pint) ((puint) seq + 1)))
+		return FALSE;
+
+	p_atomic_memory_barrier ();
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_seq_lock_write_unlock (PSeqLock *lock)
+{
+	if (P_UNLIKELY (lock == NULL))
+		return FALSE;
+
+	if (P_UNLIKELY ((p_atomic_int_get (&lock->sequence) & 1) == 0))
+		return FALSE;
+
+	p_atomic_memory_barrier ();
+	p_atomic_int_inc (&lock->sequence);
+
+	return TRUE;
+}
+
+P_LIB_API void
+p_seq_lock_free (PSeqLock *lock)
+{
+	if (P_UNLIKELY (lock == NULL))
+		return;
+
+	if (P_UNLIKELY ((p_atomic_int_get (&lock->sequence) & 1) != 0))
+		P_WARNING ("PSeqLock::p_seq_lock_free: destroying while a writer is present");
+
+	p_free_aligned (lock);
+}
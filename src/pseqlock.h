@@ -0,0 +1,135 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pseqlock.h
+ * @brief Sequence lock
+ * @author Alexander Saprykin
+ *
+ * A sequence lock protects small data which is read often and changed rarely,
+ * like a timestamp, a pair of coordinates or a statistics snapshot. Readers
+ * don't lock anything and never block a writer: instead a reader checks after
+ * reading that no writer has changed the data meanwhile, and reads it again
+ * otherwise. Readers don't write to any shared memory, so they scale with the
+ * number of CPUs perfectly.
+ *
+ * The lock keeps a sequence number which a writer makes odd while it changes
+ * the data and even again when it is done. A reader loop looks like:
+ * @code
+ * do {
+ *	seq = p_seq_lock_read_begin (lock);
+ *	copy = shared_data;
+ * } while (p_seq_lock_read_retry (lock, seq));
+ * @endcode
+ *
+ * The data read inside the loop may be inconsistent, so the reader must only
+ * copy it: do not follow pointers read from it or act on the values before
+ * p_seq_lock_read_retry() has confirmed the copy. Frequent writes can keep
+ * the readers retrying, use #PRWLock for such data instead.
+ *
+ * Writers are serialized with each other, and spin for a while before
+ * yielding the CPU while another writer holds the lock.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PSEQLOCK_H
+#define PLIBSYS_HEADER_PSEQLOCK_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+
+P_BEGIN_DECLS
+
+/** Sequence lock opaque data type. */
+typedef struct PSeqLock_ PSeqLock;
+
+/**
+ * @brief Creates a new sequence lock.
+ * @return Pointer to #PSeqLock in case of success, NULL otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API PSeqLock *	p_seq_lock_new		(void);
+
+/**
+ * @brief Starts reading the data protected by a sequence lock.
+ * @param lock #PSeqLock to read under.
+ * @return Sequence number to pass to p_seq_lock_read_retry().
+ * @since 0.0.5
+ *
+ * Waits while a writer holds the lock.
+ */
+P_LIB_API puint		p_seq_lock_read_begin	(const PSeqLock	*lock);
+
+/**
+ * @brief Checks whether the data read under a sequence lock should be read
+ * again.
+ * @param lock #PSeqLock the data was read under.
+ * @param seq Sequence number returned by p_seq_lock_read_begin().
+ * @return TRUE if a writer has changed the data meanwhile and it should be
+ * read again, FALSE if the data read is consistent.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_seq_lock_read_retry	(const PSeqLock	*lock,
+						 puint		seq);
+
+/**
+ * @brief Locks a sequence lock for writing.
+ * @param lock #PSeqLock to lock.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_seq_lock_write_lock	(PSeqLock	*lock);
+
+/**
+ * @brief Tries to lock a sequence lock for writing without waiting.
+ * @param lock #PSeqLock to lock.
+ * @return TRUE if the lock was acquired, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_seq_lock_write_trylock	(PSeqLock	*lock);
+
+/**
+ * @brief Releases a sequence lock locked for writing.
+ * @param lock #PSeqLock to release.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_seq_lock_write_unlock	(PSeqLock	*lock);
+
+/**
+ * @brief Frees a sequence lock.
+ * @param lock #PSeqLock to free.
+ * @since 0.0.5
+ *
+ * The lock should be unlocked at that moment.
+ */
+P_LIB_API void		p_seq_lock_free		(PSeqLock	*lock);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PSEQLOCK_H */
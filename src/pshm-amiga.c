@@ -37,6 +37,7 @@
 #define P_SHM_NAMESPACE	"pshm"
 #define P_SHM_SUFFIX	"_p_shm_object"
 #define P_SHM_PRIV_SIZE	(2 * sizeof (psize))
+#define P_SHM_PAGE_SIZE	4096
 
 struct PShm_ {
 	pboolean	is_owner;
@@ -45,6 +46,8 @@ struct PShm_ {
 	psize		size;
 	PSemaphore	*sem;
 	PShmAccessPerms	perms;
+	PShmFlags	flags;
+	psize		page_size;
 };
 
 static PErrorIPC pp_shm_get_ipc_error (puint32 err_code);
@@ -115,7 +118,11 @@ pp_shm_create_handle (PShm	*shm,
 		is_exists = TRUE;
 	}
 
-	shm->addr = ((pchar *) mem_area) + P_SHM_PRIV_SIZE;
+	shm->addr      = ((pchar *) mem_area) + P_SHM_PRIV_SIZE;
+	shm->page_size = P_SHM_PAGE_SIZE;
+
+	if ((shm->flags & P_SHM_FLAG_PREFAULT) != 0)
+		p_ipc_prefault_memory (shm->addr, shm->size, shm->page_size);
 
 	if (P_UNLIKELY ((shm->sem = p_semaphore_new (shm->platform_key, 1,
 						     is_exists ? P_SEM_ACCESS_OPEN : P_SEM_ACCESS_CREATE,
@@ -135,6 +142,16 @@ p_shm_new (const pchar		*name,
 	   psize		size,
 	   PShmAccessPerms	perms,
 	   PError		**error)
+{
+	return p_shm_new_with_flags (name, size, perms, P_SHM_FLAG_NONE, error);
+}
+
+P_LIB_API PShm *
+p_shm_new_with_flags (const pchar	*name,
+		      psize		size,
+		      PShmAccessPerms	perms,
+		      PShmFlags		flags,
+		      PError		**error)
 {
 	PShm	*ret;
 	pchar	*new_name;
@@ -147,6 +164,14 @@ p_shm_new (const pchar		*name,
 		return NULL;
 	}
 
+	if (P_UNLIKELY ((flags & P_SHM_FLAG_LOCK) != 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_NOT_IMPLEMENTED,
+				     0,
+				     "Locking memory segment is not supported");
+		return NULL;
+	}
+
 	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PShm))) == NULL)) {
 		p_error_set_error_p (error,
 				     (pint) P_ERROR_IPC_NO_RESOURCES,
@@ -169,6 +194,7 @@ p_shm_new (const pchar		*name,
 
 	ret->platform_key = p_ipc_get_platform_key (new_name, FALSE);
 	ret->perms        = perms;
+	ret->flags        = flags;
 	ret->size         = size;
 
 	p_free (new_name);
@@ -184,6 +210,36 @@ p_shm_new (const pchar		*name,
 	return ret;
 }
 
+P_LIB_API PShm *
+p_shm_new_anonymous (psize		size,
+		     PShmAccessPerms	perms,
+		     PError		**error)
+{
+	P_UNUSED (size);
+	P_UNUSED (perms);
+
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IPC_NOT_IMPLEMENTED,
+			     0,
+			     "No anonymous shared memory backend");
+	return NULL;
+}
+
+P_LIB_API PShm *
+p_shm_new_from_handle (pint		handle,
+		       PShmAccessPerms	perms,
+		       PError		**error)
+{
+	P_UNUSED (handle);
+	P_UNUSED (perms);
+
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IPC_NOT_IMPLEMENTED,
+			     0,
+			     "No anonymous shared memory backend");
+	return NULL;
+}
+
 P_LIB_API void
 p_shm_take_ownership (PShm *shm)
 {
@@ -272,3 +328,20 @@ p_shm_get_size (const PShm *shm)
 
 	return shm->size;
 }
+
+P_LIB_API psize
+p_shm_get_page_size (const PShm *shm)
+{
+	if (P_UNLIKELY (shm == NULL))
+		return 0;
+
+	return shm->page_size;
+}
+
+P_LIB_API pint
+p_shm_get_handle (const PShm *shm)
+{
+	P_UNUSED (shm);
+
+	return -1;
+}
@@ -45,6 +45,46 @@ p_shm_new (const pchar		*name,
 	return NULL;
 }
 
+P_LIB_API PShm *
+p_shm_new_with_flags (const pchar	*name,
+		      psize		size,
+		      PShmAccessPerms	perms,
+		      PShmFlags		flags,
+		      PError		**error)
+{
+	P_UNUSED (name);
+	P_UNUSED (size);
+	P_UNUSED (perms);
+	P_UNUSED (flags);
+	P_UNUSED (error);
+
+	return NULL;
+}
+
+P_LIB_API PShm *
+p_shm_new_anonymous (psize		size,
+		     PShmAccessPerms	perms,
+		     PError		**error)
+{
+	P_UNUSED (size);
+	P_UNUSED (perms);
+	P_UNUSED (error);
+
+	return NULL;
+}
+
+P_LIB_API PShm *
+p_shm_new_from_handle (pint		handle,
+		       PShmAccessPerms	perms,
+		       PError		**error)
+{
+	P_UNUSED (handle);
+	P_UNUSED (perms);
+	P_UNUSED (error);
+
+	return NULL;
+}
+
 P_LIB_API void
 p_shm_take_ownership (PShm *shm)
 {
@@ -92,3 +132,19 @@ p_shm_get_size (const PShm *shm)
 
 	return 0;
 }
+
+P_LIB_API psize
+p_shm_get_page_size (const PShm *shm)
+{
+	P_UNUSED (shm);
+
+	return 0;
+}
+
+P_LIB_API pint
+p_shm_get_handle (const PShm *shm)
+{
+	P_UNUSED (shm);
+
+	return -1;
+}
@@ -40,6 +40,7 @@
 #define P_SHM_MEM_PREFIX	"\\SHAREMEM\\"
 #define P_SHM_SEM_PREFIX	"\\SEM32\\"
 #define P_SHM_SUFFIX		"_p_shm_object"
+#define P_SHM_PAGE_SIZE		4096
 
 struct PShm_ {
 	pchar		*platform_key;
@@ -47,6 +48,8 @@ struct PShm_ {
 	psize		size;
 	HMTX		sem;
 	PShmAccessPerms	perms;
+	PShmFlags	flags;
+	psize		page_size;
 };
 
 static pboolean pp_shm_create_handle (PShm *shm, PError **error);
@@ -144,6 +147,20 @@ pp_shm_create_handle (PShm	*shm,
 	} else
 		p_free (mem_name);
 
+	shm->page_size = P_SHM_PAGE_SIZE;
+
+	if ((shm->flags & P_SHM_FLAG_LOCK) != 0) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_NOT_IMPLEMENTED,
+				     0,
+				     "Locking memory segment is not supported");
+		pp_shm_clean_handle (shm);
+		return FALSE;
+	}
+
+	if ((shm->flags & P_SHM_FLAG_PREFAULT) != 0)
+		p_ipc_prefault_memory (shm->addr, shm->size, shm->page_size);
+
 	if (P_UNLIKELY ((sem_name = p_malloc0 (strlen (shm->platform_key) +
 					       strlen (P_SHM_SEM_PREFIX) + 1)) == NULL)) {
 		p_error_set_error_p (error,
@@ -206,6 +223,16 @@ p_shm_new (const pchar		*name,
 	   psize		size,
 	   PShmAccessPerms	perms,
 	   PError		**error)
+{
+	return p_shm_new_with_flags (name, size, perms, P_SHM_FLAG_NONE, error);
+}
+
+P_LIB_API PShm *
+p_shm_new_with_flags (const pchar	*name,
+		      psize		size,
+		      PShmAccessPerms	perms,
+		      PShmFlags		flags,
+		      PError		**error)
 {
 	PShm	*ret;
 	pchar	*new_name;
@@ -240,6 +267,7 @@ p_shm_new (const pchar		*name,
 
 	ret->platform_key = p_ipc_get_platform_key (new_name, FALSE);
 	ret->perms        = perms;
+	ret->flags        = flags;
 	ret->size         = size;
 
 	p_free (new_name);
@@ -255,6 +283,36 @@ p_shm_new (const pchar		*name,
 	return ret;
 }
 
+P_LIB_API PShm *
+p_shm_new_anonymous (psize		size,
+		     PShmAccessPerms	perms,
+		     PError		**error)
+{
+	P_UNUSED (size);
+	P_UNUSED (perms);
+
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IPC_NOT_IMPLEMENTED,
+			     0,
+			     "No anonymous shared memory backend");
+	return NULL;
+}
+
+P_LIB_API PShm *
+p_shm_new_from_handle (pint		handle,
+		       PShmAccessPerms	perms,
+		       PError		**error)
+{
+	P_UNUSED (handle);
+	P_UNUSED (perms);
+
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IPC_NOT_IMPLEMENTED,
+			     0,
+			     "No anonymous shared memory backend");
+	return NULL;
+}
+
 P_LIB_API void
 p_shm_take_ownership (PShm *shm)
 {
@@ -348,3 +406,20 @@ p_shm_get_size (const PShm *shm)
 
 	return shm->size;
 }
+
+P_LIB_API psize
+p_shm_get_page_size (const PShm *shm)
+{
+	if (P_UNLIKELY (shm == NULL))
+		return 0;
+
+	return shm->page_size;
+}
+
+P_LIB_API pint
+p_shm_get_handle (const PShm *shm)
+{
+	P_UNUSED (shm);
+
+	return -1;
+}
@@ -23,6 +23,7 @@
  * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include "patomic.h"
 #include "perror.h"
 #include "pmem.h"
 #include "psemaphore.h"
@@ -39,67 +40,280 @@
 #include <sys/mman.h>
 #include <errno.h>
 
+#ifdef P_OS_LINUX
+#  include <sys/vfs.h>
+#endif
+
+#ifdef PLIBSYS_HAS_POSIX_ROBUST_MUTEX
+#  include "pdeadline.h"
+#  include "puthread.h"
+#  include <pthread.h>
+#  include <signal.h>
+#endif
+
 #define P_SHM_SUFFIX		"_p_shm_object"
 #define P_SHM_INVALID_HDL	-1
 
+#ifdef P_OS_LINUX
+#  define P_SHM_HUGETLBFS_DIR	"/dev/hugepages"
+#  define P_SHM_HUGETLBFS_MAGIC	0x958458f6
+#endif
+
+#ifdef PLIBSYS_HAS_POSIX_ROBUST_MUTEX
+#  define P_SHM_LOCK_READY		-1
+/* Interval of checking that the initializing process is still alive, and the
+ * limit of waiting for a live one */
+#  define P_SHM_LOCK_CHECK_INTERVAL	100
+#  define P_SHM_LOCK_INIT_TIMEOUT	5000
+
+typedef struct PShmLockArea_ {
+	/* 0 before the initialization, PID of the initializing process while
+	 * it is in progress, P_SHM_LOCK_READY after it */
+	volatile pint	state;
+	pthread_mutex_t	mutex;
+} PShmLockArea;
+
+/* Keeps the user data aligned to the cache line */
+#  define P_SHM_LOCK_AREA_SIZE	((sizeof (PShmLockArea) + P_MEM_CACHE_LINE_SIZE - 1) & \
+				 ~((psize) P_MEM_CACHE_LINE_SIZE - 1))
+#endif
+
 struct PShm_ {
 	pboolean	shm_created;
+	pint		fd;
 	pchar		*platform_key;
+	pchar		*huge_path;
 	ppointer	addr;
 	psize		size;
+	psize		map_size;
+	psize		area_size;
+	psize		page_size;
 	PSemaphore	*sem;
 	PShmAccessPerms	perms;
+	PShmFlags	flags;
 };
 
+#ifdef P_OS_LINUX
+static pint pp_shm_open_huge (PShm *shm, pboolean *is_exists);
+#endif
+#ifdef PLIBSYS_HAS_POSIX_ROBUST_MUTEX
+static PShmLockArea * pp_shm_get_lock_area (const PShm *shm);
+static pboolean pp_shm_init_lock_area (PShm *shm, PError **error);
+#endif
+static pint pp_shm_open_anonymous (void);
+static pboolean pp_shm_map_handle (PShm *shm, pint fd, pboolean is_exists, PError **error);
 static pboolean pp_shm_create_handle (PShm *shm, PError **error);
+static PShm * pp_shm_new_from_fd (pint fd, PShmAccessPerms perms, psize size, PError **error);
 static void pp_shm_clean_handle (PShm *shm);
 
-static pboolean
-pp_shm_create_handle (PShm	*shm,
-		      PError	**error)
+#ifdef P_OS_LINUX
+/* Returns the descriptor of the segment file on hugetlbfs, or -1 if the
+ * segment should go to the regular shared memory */
+static pint
+pp_shm_open_huge (PShm		*shm,
+		  pboolean	*is_exists)
 {
-	pboolean	is_exists;
-	pint		fd, flags;
-	struct stat	stat_buf;
+	struct statfs	fs_buf;
+	pint		fd;
 
-	if (P_UNLIKELY (shm == NULL || shm->platform_key == NULL)) {
-		p_error_set_error_p (error,
-				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
-				     0,
-				     "Invalid input argument");
-		return FALSE;
-	}
+	if (statfs (P_SHM_HUGETLBFS_DIR, &fs_buf) != 0 || fs_buf.f_type != P_SHM_HUGETLBFS_MAGIC)
+		return P_SHM_INVALID_HDL;
 
-	is_exists = FALSE;
+	if (P_UNLIKELY ((shm->huge_path = p_malloc0 (strlen (P_SHM_HUGETLBFS_DIR) +
+						     strlen (shm->platform_key) + 1)) == NULL))
+		return P_SHM_INVALID_HDL;
 
-	while ((fd = shm_open (shm->platform_key,
-			       O_CREAT | O_EXCL | O_RDWR,
-			       0660)) == P_SHM_INVALID_HDL &&
+	/* The platform key starts with a slash */
+	strcpy (shm->huge_path, P_SHM_HUGETLBFS_DIR);
+	strcat (shm->huge_path, shm->platform_key);
+
+	while ((fd = open (shm->huge_path, O_RDWR, 0660)) == P_SHM_INVALID_HDL &&
 	       p_error_get_last_system () == EINTR)
 	;
 
-	if (fd == P_SHM_INVALID_HDL) {
-		if (p_error_get_last_system () == EEXIST) {
-			is_exists = TRUE;
+	if (fd != P_SHM_INVALID_HDL)
+		*is_exists = TRUE;
+	else {
+		/* Someone has already created it with the regular pages */
+		if ((fd = shm_open (shm->platform_key, O_RDWR, 0660)) != P_SHM_INVALID_HDL) {
+			if (P_UNLIKELY (p_sys_close (fd) != 0))
+				P_WARNING ("PShm::pp_shm_open_huge: p_sys_close() failed");
 
-			while ((fd = shm_open (shm->platform_key,
-					       O_RDWR,
-					       0660)) == P_SHM_INVALID_HDL &&
+			fd = P_SHM_INVALID_HDL;
+		} else {
+			while ((fd = open (shm->huge_path,
+					   O_CREAT | O_EXCL | O_RDWR,
+					   0660)) == P_SHM_INVALID_HDL &&
 			       p_error_get_last_system () == EINTR)
 			;
+
+			if (fd != P_SHM_INVALID_HDL)
+				shm->shm_created = TRUE;
 		}
-	} else
-		shm->shm_created = TRUE;
+	}
 
-	if (P_UNLIKELY (fd == P_SHM_INVALID_HDL)) {
-		p_error_set_error_p (error,
-				     (pint) p_error_get_last_ipc (),
-				     p_error_get_last_system (),
-				     "Failed to call shm_open() to create memory segment");
-		pp_shm_clean_handle (shm);
-		return FALSE;
+	if (fd == P_SHM_INVALID_HDL) {
+		p_free (shm->huge_path);
+		shm->huge_path = NULL;
+		return P_SHM_INVALID_HDL;
+	}
+
+	shm->page_size = (psize) fs_buf.f_bsize;
+
+	return fd;
+}
+#endif
+
+#ifdef PLIBSYS_HAS_POSIX_ROBUST_MUTEX
+static PShmLockArea *
+pp_shm_get_lock_area (const PShm *shm)
+{
+	return (PShmLockArea *) ((pchar *) shm->addr - shm->area_size);
+}
+
+/* Any user may come first, the segment starts zeroed */
+static pboolean
+pp_shm_init_lock_area (PShm	*shm,
+		       PError	**error)
+{
+	PShmLockArea		*area;
+	pthread_mutexattr_t	attr;
+	PDeadline		check;
+	PDeadline		limit;
+	pint			self;
+	pint			state;
+	pint			res;
+
+	area = pp_shm_get_lock_area (shm);
+	self = (pint) getpid ();
+
+	p_deadline_init_msecs (&check, P_SHM_LOCK_CHECK_INTERVAL);
+	p_deadline_init_msecs (&limit, P_SHM_LOCK_INIT_TIMEOUT);
+
+	while ((state = p_atomic_int_get (&area->state)) != P_SHM_LOCK_READY) {
+		if (state == 0 && p_atomic_int_compare_and_exchange (&area->state, 0, self)) {
+			if (P_LIKELY ((res = pthread_mutexattr_init (&attr)) == 0)) {
+				if ((res = pthread_mutexattr_setpshared (&attr, PTHREAD_PROCESS_SHARED)) == 0 &&
+				    (res = pthread_mutexattr_setrobust (&attr, PTHREAD_MUTEX_ROBUST)) == 0)
+					res = pthread_mutex_init (&area->mutex, &attr);
+
+				pthread_mutexattr_destroy (&attr);
+			}
+
+			if (P_UNLIKELY (res != 0)) {
+				p_atomic_int_set (&area->state, 0);
+				p_error_set_error_p (error,
+						     (pint) p_error_get_ipc_from_system (res),
+						     res,
+						     "Failed to initialize process-shared mutex");
+				return FALSE;
+			}
+
+			p_atomic_int_set (&area->state, P_SHM_LOCK_READY);
+			break;
+		}
+
+		if (state != 0 && p_deadline_has_expired (&check) == TRUE) {
+			/* The initializing process has died in the middle, take over */
+			if (kill ((pid_t) state, 0) != 0 && errno == ESRCH) {
+				p_atomic_int_compare_and_exchange (&area->state, state, 0);
+				continue;
+			}
+
+			if (P_UNLIKELY (p_deadline_has_expired (&limit) == TRUE)) {
+				p_error_set_error_p (error,
+						     (pint) P_ERROR_IPC_FAILED,
+						     0,
+						     "Timed out while waiting for process-shared mutex initialization");
+				return FALSE;
+			}
+
+			p_deadline_init_msecs (&check, P_SHM_LOCK_CHECK_INTERVAL);
+		}
+
+		p_uthread_yield ();
+	}
+
+	return TRUE;
+}
+#endif
+
+/* The descriptor is closed on exec, but survives fork() */
+static pint
+pp_shm_open_anonymous (void)
+{
+#ifdef PLIBSYS_HAS_MEMFD_CREATE
+	pint fd;
+
+	while ((fd = memfd_create ("p_shm_anonymous", MFD_CLOEXEC)) == P_SHM_INVALID_HDL &&
+	       p_error_get_last_system () == EINTR)
+	;
+
+	return fd;
+#else
+	static volatile pint	counter = 0;
+	pchar			name[64];
+	pchar			*platform_key;
+	puint32			values[2];
+	pint			fd, flags, pos, i, j;
+
+	/* An object with a unique name, unlinked right after creation */
+	strcpy (name, "p_shm_anonymous");
+
+	values[0] = (puint32) getpid ();
+	values[1] = (puint32) p_atomic_int_add (&counter, 1);
+	pos       = (pint) strlen (name);
+
+	for (i = 0; i < 2; ++i) {
+		name[pos++] = '_';
+
+		for (j = 28; j >= 0; j -= 4)
+			name[pos++] = "0123456789abcdef"[(values[i] >> j) & 0xF];
 	}
 
+	name[pos] = '\0';
+
+#  if defined (P_OS_IRIX) || defined (P_OS_TRU64)
+	platform_key = p_ipc_get_platform_key (name, FALSE);
+#  else
+	platform_key = p_ipc_get_platform_key (name, TRUE);
+#  endif
+
+	if (P_UNLIKELY (platform_key == NULL))
+		return P_SHM_INVALID_HDL;
+
+	while ((fd = shm_open (platform_key,
+			       O_CREAT | O_EXCL | O_RDWR,
+			       0600)) == P_SHM_INVALID_HDL &&
+	       p_error_get_last_system () == EINTR)
+	;
+
+	if (fd != P_SHM_INVALID_HDL) {
+		if (P_UNLIKELY (shm_unlink (platform_key) == -1))
+			P_ERROR ("PShm::pp_shm_open_anonymous: shm_unlink() failed");
+
+		flags = fcntl (fd, F_GETFD, 0);
+
+		if (P_UNLIKELY (flags == -1 || fcntl (fd, F_SETFD, flags | FD_CLOEXEC) == -1))
+			P_WARNING ("PShm::pp_shm_open_anonymous: fcntl() with FD_CLOEXEC failed");
+	}
+
+	p_free (platform_key);
+
+	return fd;
+#endif
+}
+
+/* Maps the segment, the descriptor is left open */
+static pboolean
+pp_shm_map_handle (PShm		*shm,
+		   pint		fd,
+		   pboolean	is_exists,
+		   PError	**error)
+{
+	pint		prot, flags;
+	struct stat	stat_buf;
+
 	/* Try to get size of the existing file descriptor */
 	if (is_exists) {
 		if (P_UNLIKELY (fstat (fd, &stat_buf) == -1)) {
@@ -107,48 +321,179 @@ pp_shm_create_handle (PShm	*shm,
 					     (pint) p_error_get_last_ipc (),
 					     p_error_get_last_system (),
 					     "Failed to call fstat() to get memory segment size");
+			return FALSE;
+		}
 
-			if (P_UNLIKELY (p_sys_close (fd) != 0))
-				P_WARNING ("PShm::pp_shm_create_handle: p_sys_close() failed(1)");
-
-			pp_shm_clean_handle (shm);
+		if (P_UNLIKELY ((psize) stat_buf.st_size <= shm->area_size)) {
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+					     0,
+					     "Memory segment is too small to hold the lock");
 			return FALSE;
 		}
 
-		shm->size = (psize) stat_buf.st_size;
+		shm->map_size = (psize) stat_buf.st_size;
 	} else {
-		if (P_UNLIKELY ((ftruncate (fd, (off_t) shm->size)) == -1)) {
+		shm->map_size = shm->size + shm->area_size;
+
+		/* Huge pages can only be mapped as a whole */
+		if (shm->huge_path != NULL)
+			shm->map_size = (shm->map_size + shm->page_size - 1) / shm->page_size * shm->page_size;
+
+		if (P_UNLIKELY ((ftruncate (fd, (off_t) shm->map_size)) == -1)) {
 			p_error_set_error_p (error,
 					     (pint) p_error_get_last_ipc (),
 					     p_error_get_last_system (),
 					     "Failed to call ftruncate() to set memory segment size");
-
-			if (P_UNLIKELY (p_sys_close (fd) != 0))
-				P_WARNING ("PShm::pp_shm_create_handle: p_sys_close() failed(2)");
-
-			pp_shm_clean_handle (shm);
 			return FALSE;
 		}
 	}
 
-	flags = (shm->perms == P_SHM_ACCESS_READONLY) ? PROT_READ : PROT_READ | PROT_WRITE;
+	shm->size = shm->map_size - shm->area_size;
+	flags     = MAP_SHARED;
+
+	/* The lock is written even by the readers */
+	if (shm->perms == P_SHM_ACCESS_READONLY && shm->area_size == 0)
+		prot = PROT_READ;
+	else
+		prot = PROT_READ | PROT_WRITE;
+
+#ifdef MAP_POPULATE
+	if ((shm->flags & P_SHM_FLAG_PREFAULT) != 0)
+		flags |= MAP_POPULATE;
+#endif
 
-	if (P_UNLIKELY ((shm->addr = mmap (NULL, shm->size, flags, MAP_SHARED, fd, 0)) == (void *) -1)) {
+	if (P_UNLIKELY ((shm->addr = mmap (NULL, shm->map_size, prot, flags, fd, 0)) == (void *) -1)) {
 		p_error_set_error_p (error,
 				     (pint) p_error_get_last_ipc (),
 				     p_error_get_last_system (),
 				     "Failed to call mmap() to map memory segment");
 		shm->addr = NULL;
+		return FALSE;
+	}
+
+	/* The lock area goes before the user data */
+	shm->addr = (pchar *) shm->addr + shm->area_size;
+
+	/* Only a whole page lock area is allowed for the read-only access */
+	if (shm->perms == P_SHM_ACCESS_READONLY && shm->area_size != 0 &&
+	    P_UNLIKELY (mprotect (shm->addr, shm->size, PROT_READ) != 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_ipc (),
+				     p_error_get_last_system (),
+				     "Failed to call mprotect() to protect memory segment");
+		return FALSE;
+	}
+
+#ifdef MADV_HUGEPAGE
+	/* No hugetlbfs, transparent huge pages may still back the segment */
+	if ((shm->flags & P_SHM_FLAG_HUGE_PAGES) != 0 && shm->huge_path == NULL)
+		madvise ((pchar *) shm->addr - shm->area_size, shm->map_size, MADV_HUGEPAGE);
+#endif
+
+#ifndef MAP_POPULATE
+	if ((shm->flags & P_SHM_FLAG_PREFAULT) != 0)
+		p_ipc_prefault_memory ((pchar *) shm->addr - shm->area_size, shm->map_size, shm->page_size);
+#endif
+
+	if ((shm->flags & P_SHM_FLAG_LOCK) != 0 && P_UNLIKELY (mlock ((pchar *) shm->addr - shm->area_size, shm->map_size) != 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_ipc (),
+				     p_error_get_last_system (),
+				     "Failed to call mlock() to lock memory segment");
+		return FALSE;
+	}
+
+#ifdef PLIBSYS_HAS_POSIX_ROBUST_MUTEX
+	if (shm->area_size != 0)
+		return pp_shm_init_lock_area (shm, error);
+#endif
+
+	return TRUE;
+}
+
+static pboolean
+pp_shm_create_handle (PShm	*shm,
+		      PError	**error)
+{
+	pboolean	is_exists;
+	pboolean	is_mapped;
+	pint		fd;
+
+	if (P_UNLIKELY (shm == NULL || shm->platform_key == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
 
-		if (P_UNLIKELY (p_sys_close (fd) != 0))
-			P_WARNING ("PShm::pp_shm_create_handle: p_sys_close() failed(3)");
+	is_exists      = FALSE;
+	fd             = P_SHM_INVALID_HDL;
+	shm->page_size = (psize) sysconf (_SC_PAGESIZE);
+	shm->area_size = 0;
 
+#ifdef PLIBSYS_HAS_POSIX_ROBUST_MUTEX
+	if ((shm->flags & P_SHM_FLAG_SHARED_LOCK) != 0) {
+		if (P_UNLIKELY (shm->perms == P_SHM_ACCESS_READONLY)) {
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+					     0,
+					     "Shared lock requires read/write access");
+			return FALSE;
+		}
+
+		shm->area_size = P_SHM_LOCK_AREA_SIZE;
+	}
+#endif
+
+#ifdef P_OS_LINUX
+	if ((shm->flags & P_SHM_FLAG_HUGE_PAGES) != 0)
+		fd = pp_shm_open_huge (shm, &is_exists);
+#endif
+
+	if (fd == P_SHM_INVALID_HDL) {
+		while ((fd = shm_open (shm->platform_key,
+				       O_CREAT | O_EXCL | O_RDWR,
+				       0660)) == P_SHM_INVALID_HDL &&
+		       p_error_get_last_system () == EINTR)
+		;
+
+		if (fd == P_SHM_INVALID_HDL) {
+			if (p_error_get_last_system () == EEXIST) {
+				is_exists = TRUE;
+
+				while ((fd = shm_open (shm->platform_key,
+						       O_RDWR,
+						       0660)) == P_SHM_INVALID_HDL &&
+				       p_error_get_last_system () == EINTR)
+				;
+			}
+		} else
+			shm->shm_created = TRUE;
+	}
+
+	if (P_UNLIKELY (fd == P_SHM_INVALID_HDL)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_ipc (),
+				     p_error_get_last_system (),
+				     "Failed to call shm_open() to create memory segment");
 		pp_shm_clean_handle (shm);
 		return FALSE;
 	}
 
+	is_mapped = pp_shm_map_handle (shm, fd, is_exists, error);
+
 	if (P_UNLIKELY (p_sys_close (fd) != 0))
-		P_WARNING ("PShm::pp_shm_create_handle: p_sys_close() failed(4)");
+		P_WARNING ("PShm::pp_shm_create_handle: p_sys_close() failed");
+
+	if (P_UNLIKELY (is_mapped == FALSE)) {
+		pp_shm_clean_handle (shm);
+		return FALSE;
+	}
+
+	if (shm->area_size != 0)
+		return TRUE;
 
 	if (P_UNLIKELY ((shm->sem = p_semaphore_new (shm->platform_key, 1,
 						     is_exists ? P_SEM_ACCESS_OPEN : P_SEM_ACCESS_CREATE,
@@ -160,15 +505,91 @@ pp_shm_create_handle (PShm	*shm,
 	return TRUE;
 }
 
+/* Creates the segment of the given size, or opens the existing one if the
+ * size is zero. The descriptor is duplicated. */
+static PShm *
+pp_shm_new_from_fd (pint		fd,
+		    PShmAccessPerms	perms,
+		    psize		size,
+		    PError		**error)
+{
+	PShm	*ret;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PShm))) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for shared segment");
+		return NULL;
+	}
+
+	ret->perms     = perms;
+	ret->size      = size;
+	ret->page_size = (psize) sysconf (_SC_PAGESIZE);
+
+#ifdef PLIBSYS_HAS_POSIX_ROBUST_MUTEX
+	/* There is no named semaphore, the lock takes a whole page to let the
+	 * user data be protected from writing */
+	ret->flags     = P_SHM_FLAG_SHARED_LOCK;
+	ret->area_size = ret->page_size;
+#endif
+
+#ifdef F_DUPFD_CLOEXEC
+	ret->fd = fcntl (fd, F_DUPFD_CLOEXEC, 0);
+#else
+	if ((ret->fd = dup (fd)) != P_SHM_INVALID_HDL) {
+		pint flags = fcntl (ret->fd, F_GETFD, 0);
+
+		if (P_UNLIKELY (flags == -1 || fcntl (ret->fd, F_SETFD, flags | FD_CLOEXEC) == -1))
+			P_WARNING ("PShm::pp_shm_new_from_fd: fcntl() with FD_CLOEXEC failed");
+	}
+#endif
+
+	if (P_UNLIKELY (ret->fd == P_SHM_INVALID_HDL)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_ipc (),
+				     p_error_get_last_system (),
+				     "Failed to duplicate memory segment descriptor");
+		p_free (ret);
+		return NULL;
+	}
+
+	if (P_UNLIKELY (pp_shm_map_handle (ret, ret->fd, size == 0, error) == FALSE)) {
+		p_shm_free (ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
 static void
 pp_shm_clean_handle (PShm *shm)
 {
-	if (P_UNLIKELY (shm->addr != NULL && munmap (shm->addr, shm->size) == -1))
+	if (P_UNLIKELY (shm->addr != NULL && munmap ((pchar *) shm->addr - shm->area_size, shm->map_size) == -1))
 		P_ERROR ("PShm::pp_shm_clean_handle: munmap () failed");
 
-	if (shm->shm_created == TRUE && shm_unlink (shm->platform_key) == -1)
+	if (shm->fd != P_SHM_INVALID_HDL) {
+		if (P_UNLIKELY (p_sys_close (shm->fd) != 0))
+			P_WARNING ("PShm::pp_shm_clean_handle: p_sys_close() failed");
+
+		shm->fd = P_SHM_INVALID_HDL;
+	}
+
+	/* Anonymous segments have no name to unlink */
+	if (shm->platform_key == NULL)
+		shm->shm_created = FALSE;
+
+	if (shm->shm_created == TRUE && shm->huge_path != NULL) {
+		if (P_UNLIKELY (unlink (shm->huge_path) == -1))
+			P_ERROR ("PShm::pp_shm_clean_handle: unlink() failed");
+	} else if (shm->shm_created == TRUE && shm_unlink (shm->platform_key) == -1)
 		P_ERROR ("PShm::pp_shm_clean_handle: shm_unlink() failed");
 
+	if (shm->huge_path != NULL) {
+		p_free (shm->huge_path);
+		shm->huge_path = NULL;
+	}
+
 	if (P_LIKELY (shm->sem != NULL)) {
 		p_semaphore_free (shm->sem);
 		shm->sem         = NULL;
@@ -177,6 +598,7 @@ pp_shm_clean_handle (PShm *shm)
 	shm->shm_created = FALSE;
 	shm->addr        = NULL;
 	shm->size        = 0;
+	shm->map_size    = 0;
 }
 
 P_LIB_API PShm *
@@ -184,6 +606,16 @@ p_shm_new (const pchar		*name,
 	   psize		size,
 	   PShmAccessPerms	perms,
 	   PError		**error)
+{
+	return p_shm_new_with_flags (name, size, perms, P_SHM_FLAG_NONE, error);
+}
+
+P_LIB_API PShm *
+p_shm_new_with_flags (const pchar	*name,
+		      psize		size,
+		      PShmAccessPerms	perms,
+		      PShmFlags		flags,
+		      PError		**error)
 {
 	PShm	*ret;
 	pchar	*new_name;
@@ -222,8 +654,10 @@ p_shm_new (const pchar		*name,
 #else
 	ret->platform_key = p_ipc_get_platform_key (new_name, TRUE);
 #endif
+	ret->fd    = P_SHM_INVALID_HDL;
 	ret->perms = perms;
 	ret->size  = size;
+	ret->flags = flags;
 
 	p_free (new_name);
 
@@ -238,6 +672,54 @@ p_shm_new (const pchar		*name,
 	return ret;
 }
 
+P_LIB_API PShm *
+p_shm_new_anonymous (psize		size,
+		     PShmAccessPerms	perms,
+		     PError		**error)
+{
+	PShm *ret;
+	pint fd;
+
+	if (P_UNLIKELY (size == 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((fd = pp_shm_open_anonymous ()) == P_SHM_INVALID_HDL)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_ipc (),
+				     p_error_get_last_system (),
+				     "Failed to create anonymous memory segment");
+		return NULL;
+	}
+
+	ret = pp_shm_new_from_fd (fd, perms, size, error);
+
+	if (P_UNLIKELY (p_sys_close (fd) != 0))
+		P_WARNING ("PShm::p_shm_new_anonymous: p_sys_close() failed");
+
+	return ret;
+}
+
+P_LIB_API PShm *
+p_shm_new_from_handle (pint		handle,
+		       PShmAccessPerms	perms,
+		       PError		**error)
+{
+	if (P_UNLIKELY (handle < 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return NULL;
+	}
+
+	return pp_shm_new_from_fd (handle, perms, 0, error);
+}
+
 P_LIB_API void
 p_shm_take_ownership (PShm *shm)
 {
@@ -274,6 +756,34 @@ p_shm_lock (PShm	*shm,
 		return FALSE;
 	}
 
+#ifdef PLIBSYS_HAS_POSIX_ROBUST_MUTEX
+	if (shm->area_size != 0) {
+		pint res = pthread_mutex_lock (&pp_shm_get_lock_area (shm)->mutex);
+
+		/* The owner has died, the lock is ours now */
+		if (P_UNLIKELY (res == EOWNERDEAD))
+			res = pthread_mutex_consistent (&pp_shm_get_lock_area (shm)->mutex);
+
+		if (P_UNLIKELY (res != 0)) {
+			p_error_set_error_p (error,
+					     (pint) p_error_get_ipc_from_system (res),
+					     res,
+					     "Failed to call pthread_mutex_lock() to lock memory segment");
+			return FALSE;
+		}
+
+		return TRUE;
+	}
+#endif
+
+	if (P_UNLIKELY (shm->sem == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_NOT_IMPLEMENTED,
+				     0,
+				     "Anonymous memory segment has no lock");
+		return FALSE;
+	}
+
 	return p_semaphore_acquire (shm->sem, error);
 }
 
@@ -289,6 +799,30 @@ p_shm_unlock (PShm	*shm,
 		return FALSE;
 	}
 
+#ifdef PLIBSYS_HAS_POSIX_ROBUST_MUTEX
+	if (shm->area_size != 0) {
+		pint res = pthread_mutex_unlock (&pp_shm_get_lock_area (shm)->mutex);
+
+		if (P_UNLIKELY (res != 0)) {
+			p_error_set_error_p (error,
+					     (pint) p_error_get_ipc_from_system (res),
+					     res,
+					     "Failed to call pthread_mutex_unlock() to unlock memory segment");
+			return FALSE;
+		}
+
+		return TRUE;
+	}
+#endif
+
+	if (P_UNLIKELY (shm->sem == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_NOT_IMPLEMENTED,
+				     0,
+				     "Anonymous memory segment has no lock");
+		return FALSE;
+	}
+
 	return p_semaphore_release (shm->sem, error);
 }
 
@@ -309,3 +843,21 @@ p_shm_get_size (const PShm *shm)
 
 	return shm->size;
 }
+
+P_LIB_API psize
+p_shm_get_page_size (const PShm *shm)
+{
+	if (P_UNLIKELY (shm == NULL))
+		return 0;
+
+	return shm->page_size;
+}
+
+P_LIB_API pint
+p_shm_get_handle (const PShm *shm)
+{
+	if (P_UNLIKELY (shm == NULL))
+		return -1;
+
+	return shm->fd;
+}
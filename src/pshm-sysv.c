@@ -37,6 +37,7 @@
 #include <sys/shm.h>
 #include <sys/types.h>
 #include <sys/ipc.h>
+#include <sys/mman.h>
 #include <errno.h>
 
 #define P_SHM_SUFFIX		"_p_shm_object"
@@ -53,6 +54,8 @@ struct PShm_ {
 	psize		size;
 	PSemaphore	*sem;
 	PShmAccessPerms	perms;
+	PShmFlags	flags;
+	psize		page_size;
 };
 
 static pboolean pp_shm_create_handle (PShm *shm, PError **error);
@@ -139,6 +142,21 @@ pp_shm_create_handle (PShm	*shm,
 		return FALSE;
 	}
 
+	/* Huge pages are not supported for System V segments */
+	shm->page_size = (psize) sysconf (_SC_PAGESIZE);
+
+	if ((shm->flags & P_SHM_FLAG_PREFAULT) != 0)
+		p_ipc_prefault_memory (shm->addr, shm->size, shm->page_size);
+
+	if ((shm->flags & P_SHM_FLAG_LOCK) != 0 && P_UNLIKELY (mlock (shm->addr, shm->size) != 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_ipc (),
+				     p_error_get_last_system (),
+				     "Failed to call mlock() to lock memory segment");
+		pp_shm_clean_handle (shm);
+		return FALSE;
+	}
+
 	if (P_UNLIKELY ((shm->sem = p_semaphore_new (shm->platform_key, 1,
 						     is_exists ? P_SEM_ACCESS_OPEN : P_SEM_ACCESS_CREATE,
 						     error)) == NULL)) {
@@ -185,6 +203,16 @@ p_shm_new (const pchar		*name,
 	   psize		size,
 	   PShmAccessPerms	perms,
 	   PError		**error)
+{
+	return p_shm_new_with_flags (name, size, perms, P_SHM_FLAG_NONE, error);
+}
+
+P_LIB_API PShm *
+p_shm_new_with_flags (const pchar	*name,
+		      psize		size,
+		      PShmAccessPerms	perms,
+		      PShmFlags		flags,
+		      PError		**error)
 {
 	PShm	*ret;
 	pchar	*new_name;
@@ -219,6 +247,7 @@ p_shm_new (const pchar		*name,
 
 	ret->platform_key = p_ipc_get_platform_key (new_name, FALSE);
 	ret->perms        = perms;
+	ret->flags        = flags;
 	ret->size         = size;
 
 	p_free (new_name);
@@ -234,6 +263,36 @@ p_shm_new (const pchar		*name,
 	return ret;
 }
 
+P_LIB_API PShm *
+p_shm_new_anonymous (psize		size,
+		     PShmAccessPerms	perms,
+		     PError		**error)
+{
+	P_UNUSED (size);
+	P_UNUSED (perms);
+
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IPC_NOT_IMPLEMENTED,
+			     0,
+			     "No anonymous shared memory backend");
+	return NULL;
+}
+
+P_LIB_API PShm *
+p_shm_new_from_handle (pint		handle,
+		       PShmAccessPerms	perms,
+		       PError		**error)
+{
+	P_UNUSED (handle);
+	P_UNUSED (perms);
+
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IPC_NOT_IMPLEMENTED,
+			     0,
+			     "No anonymous shared memory backend");
+	return NULL;
+}
+
 P_LIB_API void
 p_shm_take_ownership (PShm *shm)
 {
@@ -305,3 +364,20 @@ p_shm_get_size (const PShm *shm)
 
 	return shm->size;
 }
+
+P_LIB_API psize
+p_shm_get_page_size (const PShm *shm)
+{
+	if (P_UNLIKELY (shm == NULL))
+		return 0;
+
+	return shm->page_size;
+}
+
+P_LIB_API pint
+p_shm_get_handle (const PShm *shm)
+{
+	P_UNUSED (shm);
+
+	return -1;
+}
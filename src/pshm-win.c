@@ -38,6 +38,8 @@
 
 typedef HANDLE pshm_hdl;
 
+typedef SIZE_T (WINAPI * PWin32GetLargePageMinimum) (void);
+
 struct PShm_ {
 	pchar		*platform_key;
 	pshm_hdl	shm_hdl;
@@ -45,10 +47,30 @@ struct PShm_ {
 	psize		size;
 	PSemaphore	*sem;
 	PShmAccessPerms	perms;
+	PShmFlags	flags;
+	psize		page_size;
 };
 
+static psize pp_shm_get_large_page_size (void);
 static pboolean pp_shm_create_handle (PShm *shm, PError **error);
 static void pp_shm_clean_handle (PShm *shm);
+static PShm * pp_shm_new_from_mapping (pshm_hdl hdl, PShmAccessPerms perms, psize size, PError **error);
+
+/* Available since Windows Vista, 0 if there are no large pages */
+static psize
+pp_shm_get_large_page_size (void)
+{
+	PWin32GetLargePageMinimum	get_minimum;
+	HMODULE				hmodule;
+
+	if ((hmodule = GetModuleHandleA ("kernel32.dll")) == NULL)
+		return 0;
+
+	if ((get_minimum = (PWin32GetLargePageMinimum) GetProcAddress (hmodule, "GetLargePageMinimum")) == NULL)
+		return 0;
+
+	return (psize) get_minimum ();
+}
 
 static pboolean
 pp_shm_create_handle (PShm	*shm,
@@ -56,7 +78,9 @@ pp_shm_create_handle (PShm	*shm,
 {
 	pboolean			is_exists;
 	MEMORY_BASIC_INFORMATION	mem_stat;
+	SYSTEM_INFO			sys_info;
 	DWORD				protect;
+	psize				large_size;
 
 	if (P_UNLIKELY (shm == NULL || shm->platform_key == NULL)) {
 		p_error_set_error_p (error,
@@ -70,8 +94,30 @@ pp_shm_create_handle (PShm	*shm,
 
 	protect = (shm->perms == P_SHM_ACCESS_READONLY) ? PAGE_READONLY : PAGE_READWRITE;
 
+	GetSystemInfo (&sys_info);
+	shm->page_size = (psize) sys_info.dwPageSize;
+
+#ifdef SEC_LARGE_PAGES
+	/* Needs the SeLockMemoryPrivilege, the regular pages are used otherwise.
+	 * An existing mapping is opened as is, and the page size isn't known. */
+	if ((shm->flags & P_SHM_FLAG_HUGE_PAGES) != 0 && (large_size = pp_shm_get_large_page_size ()) > 0) {
+		shm->shm_hdl = CreateFileMappingA (INVALID_HANDLE_VALUE,
+						   NULL,
+						   protect | SEC_COMMIT | SEC_LARGE_PAGES,
+						   0,
+						   (DWORD) ((shm->size + large_size - 1) / large_size * large_size),
+						   shm->platform_key);
+
+		if (shm->shm_hdl != NULL && GetLastError () != ERROR_ALREADY_EXISTS)
+			shm->page_size = large_size;
+	}
+#else
+	P_UNUSED (large_size);
+#endif
+
 	/* Multibyte character set must be enabled */
-	if (P_UNLIKELY ((shm->shm_hdl = CreateFileMappingA (INVALID_HANDLE_VALUE,
+	if (shm->shm_hdl == NULL &&
+	    P_UNLIKELY ((shm->shm_hdl = CreateFileMappingA (INVALID_HANDLE_VALUE,
 							    NULL,
 							    protect,
 							    0,
@@ -110,6 +156,18 @@ pp_shm_create_handle (PShm	*shm,
 
 	shm->size = mem_stat.RegionSize;
 
+	if ((shm->flags & P_SHM_FLAG_PREFAULT) != 0)
+		p_ipc_prefault_memory (shm->addr, shm->size, shm->page_size);
+
+	if ((shm->flags & P_SHM_FLAG_LOCK) != 0 && P_UNLIKELY (VirtualLock (shm->addr, shm->size) == 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_ipc (),
+				     p_error_get_last_system (),
+				     "Failed to call VirtualLock() to lock memory segment");
+		pp_shm_clean_handle (shm);
+		return FALSE;
+	}
+
 	if (P_UNLIKELY ((shm->sem = p_semaphore_new (shm->platform_key, 1,
 						     is_exists ? P_SEM_ACCESS_OPEN : P_SEM_ACCESS_CREATE,
 						     error)) == NULL)) {
@@ -139,11 +197,80 @@ pp_shm_clean_handle (PShm *shm)
 	shm->size    = 0;
 }
 
+/* Takes ownership of the mapping handle */
+static PShm *
+pp_shm_new_from_mapping (pshm_hdl		hdl,
+			 PShmAccessPerms	perms,
+			 psize			size,
+			 PError			**error)
+{
+	PShm				*ret;
+	MEMORY_BASIC_INFORMATION	mem_stat;
+	SYSTEM_INFO			sys_info;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PShm))) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for shared segment");
+
+		if (P_UNLIKELY (CloseHandle (hdl) == 0))
+			P_ERROR ("PShm::pp_shm_new_from_mapping: CloseHandle() failed");
+
+		return NULL;
+	}
+
+	GetSystemInfo (&sys_info);
+
+	ret->shm_hdl   = hdl;
+	ret->perms     = perms;
+	ret->page_size = (psize) sys_info.dwPageSize;
+
+	if (P_UNLIKELY ((ret->addr = MapViewOfFile (hdl,
+						    perms == P_SHM_ACCESS_READONLY ? FILE_MAP_READ : FILE_MAP_ALL_ACCESS,
+						    0,
+						    0,
+						    0)) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_ipc (),
+				     p_error_get_last_system (),
+				     "Failed to call MapViewOfFile() to map file to memory");
+		p_shm_free (ret);
+		return NULL;
+	}
+
+	if (P_UNLIKELY (VirtualQuery (ret->addr, &mem_stat, sizeof (mem_stat)) == 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_ipc (),
+				     p_error_get_last_system (),
+				     "Failed to call VirtualQuery() to get memory map info");
+		p_shm_free (ret);
+		return NULL;
+	}
+
+	ret->size = mem_stat.RegionSize;
+
+	if (size != 0 && ret->size > size)
+		ret->size = size;
+
+	return ret;
+}
+
 P_LIB_API PShm *
 p_shm_new (const pchar		*name,
 	   psize		size,
 	   PShmAccessPerms	perms,
 	   PError		**error)
+{
+	return p_shm_new_with_flags (name, size, perms, P_SHM_FLAG_NONE, error);
+}
+
+P_LIB_API PShm *
+p_shm_new_with_flags (const pchar	*name,
+		      psize		size,
+		      PShmAccessPerms	perms,
+		      PShmFlags		flags,
+		      PError		**error)
 {
 	PShm	*ret;
 	pchar	*new_name;
@@ -178,6 +305,7 @@ p_shm_new (const pchar		*name,
 
 	ret->platform_key = p_ipc_get_platform_key (new_name, FALSE);
 	ret->perms        = perms;
+	ret->flags        = flags;
 	ret->size         = size;
 
 	p_free (new_name);
@@ -193,6 +321,70 @@ p_shm_new (const pchar		*name,
 	return ret;
 }
 
+P_LIB_API PShm *
+p_shm_new_anonymous (psize		size,
+		     PShmAccessPerms	perms,
+		     PError		**error)
+{
+	pshm_hdl hdl;
+
+	if (P_UNLIKELY (size == 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return NULL;
+	}
+
+	/* The users which open it by the handle may want to write */
+	if (P_UNLIKELY ((hdl = CreateFileMappingA (INVALID_HANDLE_VALUE,
+						   NULL,
+						   PAGE_READWRITE,
+						   0,
+						   (DWORD) size,
+						   NULL)) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_ipc (),
+				     p_error_get_last_system (),
+				     "Failed to call CreateFileMapping() to create file mapping");
+		return NULL;
+	}
+
+	return pp_shm_new_from_mapping (hdl, perms, size, error);
+}
+
+P_LIB_API PShm *
+p_shm_new_from_handle (pint		handle,
+		       PShmAccessPerms	perms,
+		       PError		**error)
+{
+	pshm_hdl hdl;
+
+	if (P_UNLIKELY (handle == -1)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return NULL;
+	}
+
+	if (P_UNLIKELY (DuplicateHandle (GetCurrentProcess (),
+					 LongToHandle ((LONG) handle),
+					 GetCurrentProcess (),
+					 &hdl,
+					 0,
+					 FALSE,
+					 DUPLICATE_SAME_ACCESS) == 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_ipc (),
+				     p_error_get_last_system (),
+				     "Failed to call DuplicateHandle() to open file mapping");
+		return NULL;
+	}
+
+	return pp_shm_new_from_mapping (hdl, perms, 0, error);
+}
+
 P_LIB_API void
 p_shm_take_ownership (PShm *shm)
 {
@@ -225,6 +417,14 @@ p_shm_lock (PShm	*shm,
 		return FALSE;
 	}
 
+	if (P_UNLIKELY (shm->sem == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_NOT_IMPLEMENTED,
+				     0,
+				     "Anonymous memory segment has no lock");
+		return FALSE;
+	}
+
 	return p_semaphore_acquire (shm->sem, error);
 }
 
@@ -240,6 +440,14 @@ p_shm_unlock (PShm	*shm,
 		return FALSE;
 	}
 
+	if (P_UNLIKELY (shm->sem == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_NOT_IMPLEMENTED,
+				     0,
+				     "Anonymous memory segment has no lock");
+		return FALSE;
+	}
+
 	return p_semaphore_release (shm->sem, error);
 }
 
@@ -260,3 +468,22 @@ p_shm_get_size (const PShm *shm)
 
 	return shm->size;
 }
+
+P_LIB_API psize
+p_shm_get_page_size (const PShm *shm)
+{
+	if (P_UNLIKELY (shm == NULL))
+		return 0;
+
+	return shm->page_size;
+}
+
+P_LIB_API pint
+p_shm_get_handle (const PShm *shm)
+{
+	/* Only the anonymous segments are opened by the handle */
+	if (P_UNLIKELY (shm == NULL || shm->platform_key != NULL || shm->shm_hdl == P_SHM_INVALID_HDL))
+		return -1;
+
+	return (pint) HandleToLong (shm->shm_hdl);
+}
@@ -79,6 +79,36 @@
  * - BeOS lacks support for process-wide named semaphores which leads to the
  * absence of shared memory.
  *
+ * Large segments can be created with p_shm_new_with_flags() to be backed by
+ * huge pages, to be populated with physical pages right at the mapping and to
+ * be locked in RAM, so the hot loops over the segment take no page faults and
+ * fewer TLB misses. Huge pages come from a hugetlbfs mount (/dev/hugepages) on
+ * Linux and from large pages on Windows: if they are not available, the
+ * segment is created with the regular pages, check p_shm_get_page_size() for
+ * the page size actually obtained.
+ *
+ * By default p_shm_lock() and p_shm_unlock() go through a named #PSemaphore,
+ * which costs a system call even without contention. With the
+ * #P_SHM_FLAG_SHARED_LOCK flag the segment keeps a process-shared robust mutex
+ * in front of the user data instead, so the uncontended lock is a single
+ * atomic operation. If a process dies while holding that lock, the next
+ * p_shm_lock() call recovers it and succeeds, and the data under the lock may
+ * be inconsistent then. The flag is supported on the POSIX systems with
+ * robust mutexes, the semaphore is used elsewhere.
+ *
+ * The first process mapping such a segment initializes the mutex, the others
+ * wait for it. If the initializing process dies in the middle, a waiting one
+ * takes the initialization over once it finds that process gone. A live but
+ * stalled initializer, or a PID reused by another process right after the
+ * crash, fails the waiting calls with #P_ERROR_IPC_FAILED after 5 seconds.
+ *
+ * Use p_shm_new_anonymous() to create a segment without a name. It skips the
+ * name lookup and can't leak: the system removes it after the last user
+ * closes it, even after a crash. Other processes get such a segment through
+ * its handle (see p_shm_get_handle()): a child process inherits it across
+ * fork(), or it can be passed over a UNIX domain socket (or duplicated into
+ * another process on Windows), and opened with p_shm_new_from_handle().
+ *
  * You can take ownership of the shared memory segment with
  * p_shm_take_ownership() to explicitly remove it from the system after closing.
  */
@@ -102,6 +132,15 @@ typedef enum PShmAccessPerms_ {
 	P_SHM_ACCESS_READWRITE	= 1	/**< Read/write access.	*/
 } PShmAccessPerms;
 
+/** Flags for shared memory segment creation. */
+typedef enum PShmFlags_ {
+	P_SHM_FLAG_NONE		= 0,		/**< Regular pages.				*/
+	P_SHM_FLAG_HUGE_PAGES	= 1 << 0,	/**< Huge pages if available.			*/
+	P_SHM_FLAG_PREFAULT	= 1 << 1,	/**< Populate all the pages at the mapping.	*/
+	P_SHM_FLAG_LOCK		= 1 << 2,	/**< Lock the pages in RAM.			*/
+	P_SHM_FLAG_SHARED_LOCK	= 1 << 3	/**< Keep the lock inside the segment.		*/
+} PShmFlags;
+
 /** Shared memory opaque data structure. */
 typedef struct PShm_ PShm;
 
@@ -120,6 +159,72 @@ P_LIB_API PShm *	p_shm_new		(const pchar		*name,
 						 PShmAccessPerms	perms,
 						 PError			**error);
 
+/**
+ * @brief Creates a new #PShm object with the given creation flags.
+ * @param name Shared memory name.
+ * @param size Size of the memory segment in bytes, can't be changed later.
+ * @param perms Memory segment permissions, see #PShmAccessPerms.
+ * @param flags Creation flags, a combination of #PShmFlags.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Pointer to a newly created #PShm object in case of success, NULL
+ * otherwise.
+ * @since 0.0.5
+ *
+ * #P_SHM_FLAG_HUGE_PAGES falls back to the regular pages silently, while the
+ * call fails if #P_SHM_FLAG_LOCK can't lock the pages (usually because of the
+ * locked memory limit). A huge pages segment lives apart from the regular
+ * ones on Linux, so all the users of a segment must pass the same
+ * #P_SHM_FLAG_HUGE_PAGES flag. On Windows large pages need the "Lock pages in
+ * memory" privilege, and a segment with them is always locked in RAM.
+ *
+ * The same goes for #P_SHM_FLAG_SHARED_LOCK, which changes the layout of the
+ * segment. The lock is written to even by the readers, so it can't be used
+ * with #P_SHM_ACCESS_READONLY.
+ */
+P_LIB_API PShm *	p_shm_new_with_flags	(const pchar		*name,
+						 psize			size,
+						 PShmAccessPerms	perms,
+						 PShmFlags		flags,
+						 PError			**error);
+
+/**
+ * @brief Creates a new anonymous #PShm object.
+ * @param size Size of the memory segment in bytes, can't be changed later.
+ * @param perms Memory segment permissions, see #PShmAccessPerms.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Pointer to a newly created #PShm object in case of success, NULL
+ * otherwise.
+ * @since 0.0.5
+ *
+ * The segment is backed by memfd_create() on Linux (by an unlinked POSIX
+ * shared memory object on the other UNIX systems) and by an unnamed file
+ * mapping on Windows. The descriptor is closed on exec() on UNIX systems.
+ * Anonymous segments are not supported with System V IPC, OS/2 and AmigaOS.
+ *
+ * p_shm_lock() and p_shm_unlock() work on an anonymous segment only on the
+ * POSIX systems with robust mutexes, they report #P_ERROR_IPC_NOT_IMPLEMENTED
+ * otherwise.
+ */
+P_LIB_API PShm *	p_shm_new_anonymous	(psize			size,
+						 PShmAccessPerms	perms,
+						 PError			**error);
+
+/**
+ * @brief Opens an anonymous #PShm object by its handle.
+ * @param handle Handle of the segment, see p_shm_get_handle().
+ * @param perms Memory segment permissions, see #PShmAccessPerms.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Pointer to a newly created #PShm object in case of success, NULL
+ * otherwise.
+ * @since 0.0.5
+ *
+ * The handle is duplicated, so the caller still has to close its own copy.
+ * The size of the segment may be rounded up to the page size on Windows.
+ */
+P_LIB_API PShm *	p_shm_new_from_handle	(pint			handle,
+						 PShmAccessPerms	perms,
+						 PError			**error);
+
 /**
  * @brief Takes ownership of a shared memory segment.
  * @param shm Shared memory segment.
@@ -190,6 +295,28 @@ P_LIB_API ppointer	p_shm_get_address	(const PShm		*shm);
  */
 P_LIB_API psize		p_shm_get_size		(const PShm		*shm);
 
+/**
+ * @brief Gets the size of the pages backing a #PShm memory segment.
+ * @param shm #PShm to get the page size for.
+ * @return Page size in bytes in case of success, 0 otherwise.
+ * @since 0.0.5
+ *
+ * The size of a huge page means that the segment is backed by huge pages.
+ */
+P_LIB_API psize		p_shm_get_page_size	(const PShm		*shm);
+
+/**
+ * @brief Gets the handle of an anonymous shared memory segment.
+ * @param shm Shared memory segment.
+ * @return File descriptor (a file mapping handle on Windows) of the segment,
+ * or -1 for the named segments and in case of error.
+ * @since 0.0.5
+ *
+ * The handle remains owned by @a shm, pass it to another process and open
+ * the segment there with p_shm_new_from_handle().
+ */
+P_LIB_API pint		p_shm_get_handle	(const PShm		*shm);
+
 P_END_DECLS
 
 #endif /* PLIBSYS_HEADER_PSHM_H */
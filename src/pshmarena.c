@@ -0,0 +1,420 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* The arena is a list of physically adjacent blocks, each starting with a
+ * header which holds the block size (with the lowest bit set for an allocated
+ * block) and the size of the previous block, so both neighbours of a released
+ * block can be found and merged with it. The free blocks are also linked into
+ * a doubly linked list through their payload, and the allocation takes the
+ * first free block which fits. Only the offsets are stored inside the segment
+ * as it is mapped at different addresses in different processes. A zeroed
+ * segment has no magic value and is initialized by the first locked call. */
+
+#include "pmem.h"
+#include "pshm.h"
+#include "pshmarena.h"
+
+#define P_SHM_ARENA_MAGIC		((psize) 0x50534841)
+#define P_SHM_ARENA_ALIGN		16
+#define P_SHM_ARENA_HEADER_SIZE		P_SHM_ARENA_ALIGN
+#define P_SHM_ARENA_MIN_BLOCK		(P_SHM_ARENA_ALIGN * 2)
+#define P_SHM_ARENA_USED_BIT		((psize) 1)
+
+/* Arena header words */
+#define P_SHM_ARENA_MAGIC_WORD		0
+#define P_SHM_ARENA_END_WORD		1
+#define P_SHM_ARENA_HEAD_WORD		2
+#define P_SHM_ARENA_FREE_WORD		3
+#define P_SHM_ARENA_HEAP_OFFSET		((sizeof (psize) * 4 + P_SHM_ARENA_ALIGN - 1) & \
+					 ~((psize) P_SHM_ARENA_ALIGN - 1))
+
+/* Block words, the links live in the payload of the free blocks */
+#define P_SHM_ARENA_SIZE_WORD		0
+#define P_SHM_ARENA_PREV_SIZE_WORD	1
+#define P_SHM_ARENA_NEXT_FREE_WORD	2
+#define P_SHM_ARENA_PREV_FREE_WORD	3
+
+struct PShmArena_ {
+	PShm	*shm;
+	pchar	*base;
+	psize	size;
+};
+
+static psize * pp_shm_arena_word (const PShmArena *arena, psize offset, psize word);
+static psize pp_shm_arena_get_block_size (const PShmArena *arena, psize block);
+static void pp_shm_arena_init (PShmArena *arena);
+static void pp_shm_arena_link (PShmArena *arena, psize block);
+static void pp_shm_arena_unlink (PShmArena *arena, psize block);
+static void pp_shm_arena_set_block (PShmArena *arena, psize block, psize size, pboolean used);
+static pboolean pp_shm_arena_lock (PShmArena *arena, PError **error);
+
+static psize *
+pp_shm_arena_word (const PShmArena	*arena,
+		   psize		offset,
+		   psize		word)
+{
+	return (psize *) (arena->base + offset) + word;
+}
+
+static psize
+pp_shm_arena_get_block_size (const PShmArena	*arena,
+			     psize		block)
+{
+	return *pp_shm_arena_word (arena, block, P_SHM_ARENA_SIZE_WORD) & ~P_SHM_ARENA_USED_BIT;
+}
+
+static void
+pp_shm_arena_init (PShmArena *arena)
+{
+	psize end;
+
+	end = arena->size & ~((psize) P_SHM_ARENA_ALIGN - 1);
+
+	*pp_shm_arena_word (arena, 0, P_SHM_ARENA_END_WORD)  = end;
+	*pp_shm_arena_word (arena, 0, P_SHM_ARENA_HEAD_WORD) = 0;
+	*pp_shm_arena_word (arena, 0, P_SHM_ARENA_FREE_WORD) = 0;
+
+	if (end - P_SHM_ARENA_HEAP_OFFSET >= P_SHM_ARENA_MIN_BLOCK) {
+		*pp_shm_arena_word (arena, P_SHM_ARENA_HEAP_OFFSET, P_SHM_ARENA_PREV_SIZE_WORD) = 0;
+		pp_shm_arena_set_block (arena, P_SHM_ARENA_HEAP_OFFSET, end - P_SHM_ARENA_HEAP_OFFSET, FALSE);
+		pp_shm_arena_link (arena, P_SHM_ARENA_HEAP_OFFSET);
+	}
+
+	*pp_shm_arena_word (arena, 0, P_SHM_ARENA_MAGIC_WORD) = P_SHM_ARENA_MAGIC;
+}
+
+static void
+pp_shm_arena_link (PShmArena	*arena,
+		   psize	block)
+{
+	psize *head = pp_shm_arena_word (arena, 0, P_SHM_ARENA_HEAD_WORD);
+
+	*pp_shm_arena_word (arena, block, P_SHM_ARENA_NEXT_FREE_WORD) = *head;
+	*pp_shm_arena_word (arena, block, P_SHM_ARENA_PREV_FREE_WORD) = 0;
+
+	if (*head != 0)
+		*pp_shm_arena_word (arena, *head, P_SHM_ARENA_PREV_FREE_WORD) = block;
+
+	*head = block;
+
+	*pp_shm_arena_word (arena, 0, P_SHM_ARENA_FREE_WORD) += pp_shm_arena_get_block_size (arena, block);
+}
+
+static void
+pp_shm_arena_unlink (PShmArena	*arena,
+		     psize	block)
+{
+	psize next = *pp_shm_arena_word (arena, block, P_SHM_ARENA_NEXT_FREE_WORD);
+	psize prev = *pp_shm_arena_word (arena, block, P_SHM_ARENA_PREV_FREE_WORD);
+
+	if (prev != 0)
+		*pp_shm_arena_word (arena, prev, P_SHM_ARENA_NEXT_FREE_WORD) = next;
+	else
+		*pp_shm_arena_word (arena, 0, P_SHM_ARENA_HEAD_WORD) = next;
+
+	if (next != 0)
+		*pp_shm_arena_word (arena, next, P_SHM_ARENA_PREV_FREE_WORD) = prev;
+
+	*pp_shm_arena_word (arena, 0, P_SHM_ARENA_FREE_WORD) -= pp_shm_arena_get_block_size (arena, block);
+}
+
+/* Also updates the back reference of the following block */
+static void
+pp_shm_arena_set_block (PShmArena	*arena,
+			psize		block,
+			psize		size,
+			pboolean	used)
+{
+	*pp_shm_arena_word (arena, block, P_SHM_ARENA_SIZE_WORD) = used ? (size | P_SHM_ARENA_USED_BIT) : size;
+
+	if (block + size < *pp_shm_arena_word (arena, 0, P_SHM_ARENA_END_WORD))
+		*pp_shm_arena_word (arena, block + size, P_SHM_ARENA_PREV_SIZE_WORD) = size;
+}
+
+static pboolean
+pp_shm_arena_lock (PShmArena	*arena,
+		   PError	**error)
+{
+	if (P_UNLIKELY (p_shm_lock (arena->shm, error) == FALSE))
+		return FALSE;
+
+	if (P_UNLIKELY (*pp_shm_arena_word (arena, 0, P_SHM_ARENA_MAGIC_WORD) != P_SHM_ARENA_MAGIC))
+		pp_shm_arena_init (arena);
+
+	return TRUE;
+}
+
+P_LIB_API PShmArena *
+p_shm_arena_new (const pchar	*name,
+		 psize		size,
+		 PError		**error)
+{
+	PShmArena	*ret;
+	PShm		*shm;
+	psize		end;
+
+	if (P_UNLIKELY (name == NULL || size < P_SHM_ARENA_HEAP_OFFSET + P_SHM_ARENA_MIN_BLOCK)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((shm = p_shm_new (name, size, P_SHM_ACCESS_READWRITE, error)) == NULL))
+		return NULL;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PShmArena))) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for shared arena");
+		p_shm_free (shm);
+		return NULL;
+	}
+
+	ret->shm  = shm;
+	ret->base = (pchar *) p_shm_get_address (shm);
+	ret->size = p_shm_get_size (shm);
+
+	if (P_UNLIKELY (ret->base == NULL || ret->size < P_SHM_ARENA_HEAP_OFFSET + P_SHM_ARENA_MIN_BLOCK)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Too small memory segment to hold required data");
+		p_shm_arena_free (ret);
+		return NULL;
+	}
+
+	if (P_UNLIKELY (pp_shm_arena_lock (ret, error) == FALSE)) {
+		p_shm_arena_free (ret);
+		return NULL;
+	}
+
+	end = *pp_shm_arena_word (ret, 0, P_SHM_ARENA_END_WORD);
+
+	if (P_UNLIKELY (p_shm_unlock (shm, error) == FALSE)) {
+		p_shm_arena_free (ret);
+		return NULL;
+	}
+
+	/* Created by another process with a larger segment */
+	if (P_UNLIKELY (end > ret->size)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Arena doesn't fit into the memory segment");
+		p_shm_arena_free (ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+P_LIB_API void
+p_shm_arena_free (PShmArena *arena)
+{
+	if (P_UNLIKELY (arena == NULL))
+		return;
+
+	p_shm_free (arena->shm);
+	p_free (arena);
+}
+
+P_LIB_API void
+p_shm_arena_take_ownership (PShmArena *arena)
+{
+	if (P_UNLIKELY (arena == NULL))
+		return;
+
+	p_shm_take_ownership (arena->shm);
+}
+
+P_LIB_API psize
+p_shm_arena_alloc (PShmArena	*arena,
+		   psize	size,
+		   PError	**error)
+{
+	psize	need;
+	psize	block;
+	psize	block_size;
+
+	if (P_UNLIKELY (arena == NULL || size == 0 || size > arena->size)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return 0;
+	}
+
+	need = (size + P_SHM_ARENA_HEADER_SIZE + P_SHM_ARENA_ALIGN - 1) & ~((psize) P_SHM_ARENA_ALIGN - 1);
+
+	if (need < P_SHM_ARENA_MIN_BLOCK)
+		need = P_SHM_ARENA_MIN_BLOCK;
+
+	if (P_UNLIKELY (pp_shm_arena_lock (arena, error) == FALSE))
+		return 0;
+
+	block = *pp_shm_arena_word (arena, 0, P_SHM_ARENA_HEAD_WORD);
+
+	while (block != 0 && pp_shm_arena_get_block_size (arena, block) < need)
+		block = *pp_shm_arena_word (arena, block, P_SHM_ARENA_NEXT_FREE_WORD);
+
+	if (P_UNLIKELY (block == 0)) {
+		p_shm_unlock (arena->shm, NULL);
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_NO_RESOURCES,
+				     0,
+				     "No free block large enough in shared arena");
+		return 0;
+	}
+
+	block_size = pp_shm_arena_get_block_size (arena, block);
+
+	pp_shm_arena_unlink (arena, block);
+
+	/* Split off the tail if it can hold a block on its own */
+	if (block_size - need >= P_SHM_ARENA_MIN_BLOCK) {
+		pp_shm_arena_set_block (arena, block, need, TRUE);
+		pp_shm_arena_set_block (arena, block + need, block_size - need, FALSE);
+		pp_shm_arena_link (arena, block + need);
+	} else
+		pp_shm_arena_set_block (arena, block, block_size, TRUE);
+
+	if (P_UNLIKELY (p_shm_unlock (arena->shm, error) == FALSE))
+		return 0;
+
+	return block + P_SHM_ARENA_HEADER_SIZE;
+}
+
+P_LIB_API pboolean
+p_shm_arena_release (PShmArena	*arena,
+		     psize	offset,
+		     PError	**error)
+{
+	psize	block, block_size;
+	psize	neighbour, end;
+
+	if (P_UNLIKELY (arena == NULL ||
+			offset < P_SHM_ARENA_HEAP_OFFSET + P_SHM_ARENA_HEADER_SIZE ||
+			offset >= arena->size ||
+			(offset & (P_SHM_ARENA_ALIGN - 1)) != 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (pp_shm_arena_lock (arena, error) == FALSE))
+		return FALSE;
+
+	block      = offset - P_SHM_ARENA_HEADER_SIZE;
+	block_size = pp_shm_arena_get_block_size (arena, block);
+	end        = *pp_shm_arena_word (arena, 0, P_SHM_ARENA_END_WORD);
+
+	/* Catches double release and most of the wild offsets */
+	if (P_UNLIKELY (block >= end ||
+			(*pp_shm_arena_word (arena, block, P_SHM_ARENA_SIZE_WORD) & P_SHM_ARENA_USED_BIT) == 0 ||
+			block_size < P_SHM_ARENA_MIN_BLOCK ||
+			block_size > end - block)) {
+		p_shm_unlock (arena->shm, NULL);
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Offset doesn't point to an allocated block");
+		return FALSE;
+	}
+
+	neighbour = block + block_size;
+
+	if (neighbour < end && (*pp_shm_arena_word (arena, neighbour, P_SHM_ARENA_SIZE_WORD) & P_SHM_ARENA_USED_BIT) == 0) {
+		pp_shm_arena_unlink (arena, neighbour);
+		block_size += pp_shm_arena_get_block_size (arena, neighbour);
+	}
+
+	if (block > P_SHM_ARENA_HEAP_OFFSET) {
+		neighbour = block - *pp_shm_arena_word (arena, block, P_SHM_ARENA_PREV_SIZE_WORD);
+
+		if ((*pp_shm_arena_word (arena, neighbour, P_SHM_ARENA_SIZE_WORD) & P_SHM_ARENA_USED_BIT) == 0) {
+			pp_shm_arena_unlink (arena, neighbour);
+			block_size += pp_shm_arena_get_block_size (arena, neighbour);
+			block       = neighbour;
+		}
+	}
+
+	pp_shm_arena_set_block (arena, block, block_size, FALSE);
+	pp_shm_arena_link (arena, block);
+
+	return p_shm_unlock (arena->shm, error);
+}
+
+P_LIB_API ppointer
+p_shm_arena_get_pointer (const PShmArena	*arena,
+			 psize			offset)
+{
+	if (P_UNLIKELY (arena == NULL || offset < P_SHM_ARENA_HEAP_OFFSET || offset >= arena->size))
+		return NULL;
+
+	return arena->base + offset;
+}
+
+P_LIB_API psize
+p_shm_arena_get_offset (const PShmArena	*arena,
+			pconstpointer		ptr)
+{
+	const pchar *addr = (const pchar *) ptr;
+
+	if (P_UNLIKELY (arena == NULL || addr < arena->base + P_SHM_ARENA_HEAP_OFFSET ||
+			addr >= arena->base + arena->size))
+		return 0;
+
+	return (psize) (addr - arena->base);
+}
+
+P_LIB_API pssize
+p_shm_arena_get_free_size (PShmArena	*arena,
+			   PError	**error)
+{
+	psize free_size;
+
+	if (P_UNLIKELY (arena == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	if (P_UNLIKELY (pp_shm_arena_lock (arena, error) == FALSE))
+		return -1;
+
+	free_size = *pp_shm_arena_word (arena, 0, P_SHM_ARENA_FREE_WORD);
+
+	if (P_UNLIKELY (p_shm_unlock (arena->shm, error) == FALSE))
+		return -1;
+
+	return (pssize) free_size;
+}
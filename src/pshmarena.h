@@ -0,0 +1,174 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pshmarena.h
+ * @brief Shared memory allocator
+ * @author Alexander Saprykin
+ *
+ * A shared memory arena manages blocks of variable size inside a single #PShm
+ * segment, so several processes can allocate and release objects right in
+ * the shared memory instead of copying them through a #PShmBuffer.
+ *
+ * The segment is usually mapped at different addresses in different
+ * processes, that's why the blocks are identified by their offsets from the
+ * beginning of the arena. An offset can be passed to another process which
+ * opened the same arena, and turned into a pointer there with
+ * p_shm_arena_get_pointer(). Offset 0 never belongs to a block and is used to
+ * report a failure.
+ *
+ * The arena is identified by its name across the system, like #PShm. Use
+ * p_shm_arena_new() to open it and p_shm_arena_free() to close it. Then use
+ * p_shm_arena_alloc() to get a new block and p_shm_arena_release() to give it
+ * back. The blocks are aligned to 16 bytes. The allocator serializes all the
+ * allocations with the lock of the underlying #PShm segment, so the arena may
+ * be used by any number of threads and processes at the same time. Released
+ * neighbour blocks are merged together to fight fragmentation.
+ *
+ * You can take ownership of the arena with p_shm_arena_take_ownership() to
+ * remove it from the system after closing, see #PShm for the details.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PSHMARENA_H
+#define PLIBSYS_HEADER_PSHMARENA_H
+
+#include "ptypes.h"
+#include "pmacros.h"
+#include "perror.h"
+
+P_BEGIN_DECLS
+
+/** Shared memory arena opaque data structure. */
+typedef struct PShmArena_ PShmArena;
+
+/**
+ * @brief Opens a shared memory arena.
+ * @param name Unique arena name.
+ * @param size Arena size in bytes, including the internal bookkeeping.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Pointer to the #PShmArena structure in case of success, NULL
+ * otherwise.
+ * @since 0.0.5
+ *
+ * If an arena with the same name already exists then it is opened with its
+ * own size, @a size is ignored in that case.
+ */
+P_LIB_API PShmArena *	p_shm_arena_new			(const pchar	*name,
+							 psize		size,
+							 PError		**error);
+
+/**
+ * @brief Closes a shared memory arena.
+ * @param arena #PShmArena to close.
+ * @since 0.0.5
+ *
+ * The blocks allocated through the arena are not released. Note that an arena
+ * will be completely removed from the system only after the last instance of
+ * the arena with the same name is closed.
+ */
+P_LIB_API void		p_shm_arena_free		(PShmArena	*arena);
+
+/**
+ * @brief Takes ownership of a shared memory arena.
+ * @param arena Shared memory arena.
+ * @since 0.0.5
+ *
+ * Works like p_shm_buffer_take_ownership().
+ */
+P_LIB_API void		p_shm_arena_take_ownership	(PShmArena	*arena);
+
+/**
+ * @brief Allocates a block inside a shared memory arena.
+ * @param arena #PShmArena to allocate the block in.
+ * @param size Block size in bytes.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Offset of the block in case of success, 0 otherwise.
+ * @since 0.0.5
+ *
+ * The block content is not initialized. The call fails with the
+ * #P_ERROR_IPC_NO_RESOURCES error if the arena has no free block large
+ * enough.
+ */
+P_LIB_API psize		p_shm_arena_alloc		(PShmArena	*arena,
+							 psize		size,
+							 PError		**error);
+
+/**
+ * @brief Releases a block of a shared memory arena.
+ * @param arena #PShmArena the block was allocated in.
+ * @param offset Offset of the block returned by p_shm_arena_alloc().
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The block may be released by any process which opened the arena, not only
+ * by the one which has allocated it. An offset which doesn't point to an
+ * allocated block is rejected.
+ */
+P_LIB_API pboolean	p_shm_arena_release		(PShmArena	*arena,
+							 psize		offset,
+							 PError		**error);
+
+/**
+ * @brief Gets the address of a block in the current process.
+ * @param arena #PShmArena the block was allocated in.
+ * @param offset Offset of the block.
+ * @return Block address in case of success, NULL otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API ppointer	p_shm_arena_get_pointer		(const PShmArena	*arena,
+							 psize			offset);
+
+/**
+ * @brief Gets the offset of a block by its address.
+ * @param arena #PShmArena the block was allocated in.
+ * @param ptr Block address in the current process.
+ * @return Block offset in case of success, 0 otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API psize		p_shm_arena_get_offset		(const PShmArena	*arena,
+							 pconstpointer		ptr);
+
+/**
+ * @brief Gets the amount of free space in a shared memory arena.
+ * @param arena #PShmArena to check.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Free space in bytes, including the headers of the free blocks, or
+ * -1 if error occured.
+ * @since 0.0.5
+ *
+ * The free space may be fragmented, so a block of this size can't be always
+ * allocated.
+ */
+P_LIB_API pssize	p_shm_arena_get_free_size	(PShmArena	*arena,
+							 PError		**error);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PSHMARENA_H */
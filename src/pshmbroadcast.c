@@ -0,0 +1,266 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Every slot works as a sequence lock: the writer stores 2 * n + 1 into the
+ * slot sequence before it writes message n and 2 * n + 2 after that. A reader
+ * waiting for message n takes it only if the sequence is 2 * n + 2 both before
+ * and after the copy. A lower sequence means that the message isn't ready
+ * yet, a higher one that the writer has already lapped the reader. The readers
+ * never write into the segment, so the writer touches only the slot and the
+ * published counter whatever the number of readers is. */
+
+#include "patomic.h"
+#include "pmem.h"
+#include "pshm.h"
+#include "pshmbroadcast.h"
+
+#include <string.h>
+
+#define P_SHM_BROADCAST_COUNT_OFFSET	0
+#define P_SHM_BROADCAST_SLOTS_OFFSET	P_MEM_CACHE_LINE_SIZE
+#define P_SHM_BROADCAST_SLOT_HEADER	sizeof (psize) * 2
+
+struct PShmBroadcast_ {
+	PShm		*shm;
+	volatile psize	*count;
+	pchar		*slots;
+	psize		slot_size;
+	psize		msg_size;
+	psize		mask;
+	psize		cursor;
+};
+
+static psize pp_shm_broadcast_get_seq (const volatile psize *seq, PAtomicMemoryOrder order);
+static void pp_shm_broadcast_set_seq (volatile psize *seq, psize value, PAtomicMemoryOrder order);
+
+static psize
+pp_shm_broadcast_get_seq (const volatile psize	*seq,
+			  PAtomicMemoryOrder	order)
+{
+	return PPOINTER_TO_PSIZE (p_atomic_pointer_get_explicit (seq, order));
+}
+
+static void
+pp_shm_broadcast_set_seq (volatile psize	*seq,
+			  psize			value,
+			  PAtomicMemoryOrder	order)
+{
+	p_atomic_pointer_set_explicit (seq, PSIZE_TO_POINTER (value), order);
+}
+
+P_LIB_API PShmBroadcast *
+p_shm_broadcast_new (const pchar	*name,
+		     psize		msg_size,
+		     psize		capacity,
+		     PError		**error)
+{
+	PShmBroadcast	*ret;
+	PShm		*shm;
+	psize		slot_size;
+	psize		slots;
+	psize		shm_size;
+
+	if (P_UNLIKELY (name == NULL || msg_size == 0 || capacity == 0 || capacity > P_MAXSIZE / 4)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return NULL;
+	}
+
+	/* Emulated atomics use a lock which is local for the process */
+	if (P_UNLIKELY (p_atomic_is_lock_free () == FALSE)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_NOT_IMPLEMENTED,
+				     0,
+				     "Lock-free atomic operations are not available");
+		return NULL;
+	}
+
+	for (slots = 1; slots < capacity; slots <<= 1)
+		;
+
+	/* Neighbour slots don't share cache lines */
+	slot_size = (P_SHM_BROADCAST_SLOT_HEADER + msg_size + P_MEM_CACHE_LINE_SIZE - 1) &
+		    ~((psize) P_MEM_CACHE_LINE_SIZE - 1);
+
+	if (P_UNLIKELY (slot_size < msg_size || slot_size > (P_MAXSIZE - P_SHM_BROADCAST_SLOTS_OFFSET) / slots)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Too large shared memory segment requested");
+		return NULL;
+	}
+
+	shm_size = P_SHM_BROADCAST_SLOTS_OFFSET + slot_size * slots;
+
+	if (P_UNLIKELY ((shm = p_shm_new (name, shm_size, P_SHM_ACCESS_READWRITE, error)) == NULL))
+		return NULL;
+
+	if (P_UNLIKELY (p_shm_get_size (shm) < shm_size || p_shm_get_address (shm) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Too small memory segment to hold required data");
+		p_shm_free (shm);
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PShmBroadcast))) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for shared broadcast ring");
+		p_shm_free (shm);
+		return NULL;
+	}
+
+	ret->shm       = shm;
+	ret->count     = (volatile psize *) ((pchar *) p_shm_get_address (shm) + P_SHM_BROADCAST_COUNT_OFFSET);
+	ret->slots     = (pchar *) p_shm_get_address (shm) + P_SHM_BROADCAST_SLOTS_OFFSET;
+	ret->slot_size = slot_size;
+	ret->msg_size  = msg_size;
+	ret->mask      = slots - 1;
+	ret->cursor    = pp_shm_broadcast_get_seq (ret->count, P_ATOMIC_MEMORY_ORDER_ACQUIRE);
+
+	return ret;
+}
+
+P_LIB_API void
+p_shm_broadcast_free (PShmBroadcast *bc)
+{
+	if (P_UNLIKELY (bc == NULL))
+		return;
+
+	p_shm_free (bc->shm);
+	p_free (bc);
+}
+
+P_LIB_API void
+p_shm_broadcast_take_ownership (PShmBroadcast *bc)
+{
+	if (P_UNLIKELY (bc == NULL))
+		return;
+
+	p_shm_take_ownership (bc->shm);
+}
+
+P_LIB_API pssize
+p_shm_broadcast_write (PShmBroadcast	*bc,
+		       pconstpointer	data,
+		       psize		len,
+		       PError		**error)
+{
+	psize	count;
+	pchar	*slot;
+
+	if (P_UNLIKELY (bc == NULL || data == NULL || len == 0 || len > bc->msg_size)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	count = pp_shm_broadcast_get_seq (bc->count, P_ATOMIC_MEMORY_ORDER_RELAXED);
+	slot  = bc->slots + (count & bc->mask) * bc->slot_size;
+
+	/* The odd sequence must be visible before any byte of the message */
+	pp_shm_broadcast_set_seq ((volatile psize *) slot, count * 2 + 1, P_ATOMIC_MEMORY_ORDER_RELAXED);
+	p_atomic_thread_fence (P_ATOMIC_MEMORY_ORDER_SEQ_CST);
+
+	memcpy (slot + sizeof (psize), &len, sizeof (psize));
+	memcpy (slot + P_SHM_BROADCAST_SLOT_HEADER, data, len);
+
+	pp_shm_broadcast_set_seq ((volatile psize *) slot, count * 2 + 2, P_ATOMIC_MEMORY_ORDER_RELEASE);
+	pp_shm_broadcast_set_seq (bc->count, count + 1, P_ATOMIC_MEMORY_ORDER_RELEASE);
+
+	return (pssize) len;
+}
+
+P_LIB_API pssize
+p_shm_broadcast_read (PShmBroadcast	*bc,
+		      ppointer		storage,
+		      psize		len,
+		      PError		**error)
+{
+	psize	seq, expected;
+	psize	msg_len, count;
+	pchar	*slot;
+
+	if (P_UNLIKELY (bc == NULL || storage == NULL || len == 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	slot     = bc->slots + (bc->cursor & bc->mask) * bc->slot_size;
+	expected = bc->cursor * 2 + 2;
+	seq      = pp_shm_broadcast_get_seq ((const volatile psize *) slot, P_ATOMIC_MEMORY_ORDER_ACQUIRE);
+
+	/* Not written yet, or being written right now */
+	if ((pssize) (seq - expected) < 0)
+		return 0;
+
+	if (seq == expected) {
+		memcpy (&msg_len, slot + sizeof (psize), sizeof (psize));
+
+		/* The length may be torn, it is checked with the sequence */
+		if (msg_len <= len && msg_len <= bc->msg_size)
+			memcpy (storage, slot + P_SHM_BROADCAST_SLOT_HEADER, msg_len);
+
+		p_atomic_thread_fence (P_ATOMIC_MEMORY_ORDER_ACQUIRE);
+
+		if (pp_shm_broadcast_get_seq ((const volatile psize *) slot, P_ATOMIC_MEMORY_ORDER_RELAXED) == seq) {
+			if (P_UNLIKELY (msg_len > len)) {
+				p_error_set_error_p (error,
+						     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+						     0,
+						     "Too small storage to hold the message");
+				return -1;
+			}
+
+			++bc->cursor;
+
+			return (pssize) msg_len;
+		}
+	}
+
+	/* Lapped by the writer, skip to the oldest message which is still there */
+	count = pp_shm_broadcast_get_seq (bc->count, P_ATOMIC_MEMORY_ORDER_ACQUIRE);
+
+	if ((pssize) (count - bc->mask - bc->cursor) > 0)
+		bc->cursor = count - bc->mask;
+	else
+		++bc->cursor;
+
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IPC_OVERFLOW,
+			     0,
+			     "Messages were overwritten before being read");
+	return -1;
+}
@@ -0,0 +1,151 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pshmbroadcast.h
+ * @brief Shared memory broadcast ring
+ * @author Alexander Saprykin
+ *
+ * A shared memory broadcast ring delivers every message of a single writer to
+ * any number of readers, which may all live in different processes. The
+ * message is written into the shared memory only once, and every reader
+ * copies it out on its own.
+ *
+ * The ring is identified by its name across the system, like #PShm. Use
+ * p_shm_broadcast_new() to open it and p_shm_broadcast_free() to close it.
+ * All the users of a ring must open it with the same message size and
+ * capacity.
+ *
+ * The ring has a fixed number of slots, one message each, and every message
+ * gets the next sequence number. The writer never waits for the readers: it
+ * overwrites the oldest slot, so the cost of p_shm_broadcast_write() doesn't
+ * depend on the number of readers. Each #PShmBroadcast object keeps its own
+ * read cursor, starting from the first message written after it was opened.
+ * A reader which falls behind by more than the capacity loses the overwritten
+ * messages: p_shm_broadcast_read() reports the overrun with the
+ * #P_ERROR_IPC_OVERFLOW error and moves the cursor to the oldest message still
+ * in the ring.
+ *
+ * Only one thread (in any process) may write into a ring at the same time,
+ * while each #PShmBroadcast object may be read by one thread at a time. The
+ * ring needs lock-free atomic operations, see p_atomic_is_lock_free().
+ *
+ * You can take ownership of the ring with p_shm_broadcast_take_ownership() to
+ * remove it from the system after closing, see #PShm for the details.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PSHMBROADCAST_H
+#define PLIBSYS_HEADER_PSHMBROADCAST_H
+
+#include "ptypes.h"
+#include "pmacros.h"
+#include "perror.h"
+
+P_BEGIN_DECLS
+
+/** Shared memory broadcast ring opaque data structure. */
+typedef struct PShmBroadcast_ PShmBroadcast;
+
+/**
+ * @brief Opens a shared memory broadcast ring.
+ * @param name Unique ring name.
+ * @param msg_size Maximum message size in bytes.
+ * @param capacity Number of messages kept in the ring, rounded up to a power
+ * of two.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Pointer to the #PShmBroadcast structure in case of success, NULL
+ * otherwise.
+ * @since 0.0.5
+ *
+ * If a ring with the same name already exists then it is opened, it must be
+ * large enough for @a msg_size and @a capacity.
+ */
+P_LIB_API PShmBroadcast *	p_shm_broadcast_new		(const pchar	*name,
+								 psize		msg_size,
+								 psize		capacity,
+								 PError		**error);
+
+/**
+ * @brief Closes a shared memory broadcast ring.
+ * @param bc #PShmBroadcast to close.
+ * @since 0.0.5
+ *
+ * Note that a ring will be completely removed from the system only after the
+ * last instance of the ring with the same name is closed.
+ */
+P_LIB_API void			p_shm_broadcast_free		(PShmBroadcast	*bc);
+
+/**
+ * @brief Takes ownership of a shared memory broadcast ring.
+ * @param bc Shared memory broadcast ring.
+ * @since 0.0.5
+ *
+ * Works like p_shm_buffer_take_ownership().
+ */
+P_LIB_API void			p_shm_broadcast_take_ownership	(PShmBroadcast	*bc);
+
+/**
+ * @brief Publishes a message to all the readers.
+ * @param bc #PShmBroadcast to write the message into.
+ * @param data Message data.
+ * @param len Message size in bytes, up to the message size of the ring.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return @a len in case of success, -1 otherwise.
+ * @since 0.0.5
+ *
+ * The oldest message is overwritten, the call never waits.
+ */
+P_LIB_API pssize		p_shm_broadcast_write		(PShmBroadcast	*bc,
+								 pconstpointer	data,
+								 psize		len,
+								 PError		**error);
+
+/**
+ * @brief Reads the next message from a shared memory broadcast ring.
+ * @param bc #PShmBroadcast to read the message from.
+ * @param[out] storage Output buffer to put the message in.
+ * @param len Storage size in bytes.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Message size in bytes, 0 if there is no new message, or -1 if error
+ * occured.
+ * @since 0.0.5
+ *
+ * If the writer has overwritten the next message, the call fails with the
+ * #P_ERROR_IPC_OVERFLOW error and the next call continues from the oldest
+ * message still available. A message which doesn't fit into @a storage is
+ * left unread.
+ */
+P_LIB_API pssize		p_shm_broadcast_read		(PShmBroadcast	*bc,
+								 ppointer	storage,
+								 psize		len,
+								 PError		**error);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PSHMBROADCAST_H */
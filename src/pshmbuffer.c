@@ -23,71 +23,109 @@
  * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+/* A blocked reader registers in the readers counter and sleeps on the data
+ * sequence word, a writer bumps the word and wakes the sleepers only if the
+ * counter is not zero. The reader checks for the data once more after it is
+ * registered, and the writer reads the counter after it has published the
+ * data: a full barrier on both sides makes at least one of them see the
+ * other. A writer waits for space in the same way. The words live in the
+ * segment, so the sleepers are woken across the processes with a shared
+ * futex (or a shared ulock on Darwin); elsewhere the sleepers poll the word.
+ *
+ * The counter and the word a side wakes with sit on the cache line of that
+ * side's position, so a write only reads the writer's own line when nobody
+ * sleeps. */
+
+#include "patomic.h"
 #include "pmem.h"
 #include "pshm.h"
 #include "pshmbuffer.h"
+#include "puthread.h"
 
 #include <stdlib.h>
 #include <string.h>
 
+#if defined (PLIBSYS_HAS_FUTEX)
+#  include <errno.h>
+#  include <time.h>
+#  include <unistd.h>
+#  include <sys/syscall.h>
+#  include <linux/futex.h>
+#elif defined (PLIBSYS_HAS_ULOCK)
+#  include <errno.h>
+#  define P_SHM_BUFFER_ULOCK_COMPARE_AND_WAIT_SHARED	0x00000003
+#  define P_SHM_BUFFER_ULOCK_WAKE_ALL			0x00000100
+#  define P_SHM_BUFFER_ULOCK_NO_ERRNO			0x01000000
+extern int __ulock_wait (puint32 operation, void *addr, puint64 value, puint32 timeout);
+extern int __ulock_wake (puint32 operation, void *addr, puint64 wake_value);
+#else
+#  define P_SHM_BUFFER_WAIT_SPINS			64
+#endif
+
 #define P_SHM_BUFFER_READ_OFFSET	0
 #define P_SHM_BUFFER_WRITE_OFFSET	sizeof (psize)
-#define P_SHM_BUFFER_DATA_OFFSET	sizeof (psize) * 2
+#define P_SHM_BUFFER_SPACE_SEQ_OFFSET	sizeof (psize) * 2
+#define P_SHM_BUFFER_WRITERS_OFFSET	sizeof (psize) * 2 + sizeof (pint)
+#define P_SHM_BUFFER_DATA_SEQ_OFFSET	sizeof (psize) * 2 + sizeof (pint) * 2
+#define P_SHM_BUFFER_READERS_OFFSET	sizeof (psize) * 2 + sizeof (pint) * 3
+#define P_SHM_BUFFER_DATA_OFFSET	sizeof (psize) * 2 + sizeof (pint) * 4
+
+/* In the SPSC mode each position takes its own cache line */
+#define P_SHM_BUFFER_SPSC_READ_OFFSET	0
+#define P_SHM_BUFFER_SPSC_WRITE_OFFSET	P_MEM_CACHE_LINE_SIZE
+#define P_SHM_BUFFER_SPSC_DATA_OFFSET	P_MEM_CACHE_LINE_SIZE * 2
+
+/* Offsets of the wake words from the position of the same cache line */
+#define P_SHM_BUFFER_SEQ_DELTA		sizeof (psize)
+#define P_SHM_BUFFER_WAITERS_DELTA	sizeof (psize) + sizeof (pint)
 
 struct PShmBuffer_ {
-	PShm *shm;
-	psize size;
+	PShm		*shm;
+	psize		size;
+	pboolean	is_spsc;
+	psize		read_offset;
+	psize		write_offset;
+	psize		data_offset;
+	/* Positions of the other side seen last time, SPSC mode only */
+	psize		read_cache;
+	psize		write_cache;
+	/* Wake words: the reader's ones wake writers and vice versa */
+	volatile pint	*space_seq;
+	volatile pint	*writers_waiting;
+	volatile pint	*data_seq;
+	volatile pint	*readers_waiting;
+	/* Pending reserve_write() and peek() ranges */
+	psize		reserved;
+	psize		peeked;
+	pint		lock_users;
 };
 
+static PShmBuffer * pp_shm_buffer_new (const pchar *name, psize size, pboolean is_spsc, PError **error);
+static psize pp_shm_buffer_get_pos (PShmBuffer *buf, ppointer addr, psize offset, PAtomicMemoryOrder order);
+static void pp_shm_buffer_set_pos (PShmBuffer *buf, ppointer addr, psize offset, psize pos);
+static psize pp_shm_buffer_calc_free_space (PShmBuffer *buf, psize read_pos, psize write_pos);
+static psize pp_shm_buffer_calc_used_space (PShmBuffer *buf, psize read_pos, psize write_pos);
 static psize pp_shm_buffer_get_free_space (PShmBuffer *buf);
 static psize pp_shm_buffer_get_used_space (PShmBuffer *buf);
-
-/* Warning: this function is not thread-safe, only for internal usage */
-static psize
-pp_shm_buffer_get_free_space (PShmBuffer *buf)
-{
-	psize		read_pos, write_pos;
-	ppointer	addr;
-
-	addr = p_shm_get_address (buf->shm);
-
-	memcpy (&read_pos, (pchar *) addr + P_SHM_BUFFER_READ_OFFSET, sizeof (read_pos));
-	memcpy (&write_pos, (pchar *) addr + P_SHM_BUFFER_WRITE_OFFSET, sizeof (write_pos));
-
-	if (write_pos < read_pos)
-		return read_pos - write_pos - 1;
-	else if (write_pos > read_pos)
-		return buf->size - (write_pos - read_pos) - 1;
-	else
-		return buf->size - 1;
-}
-
-static psize
-pp_shm_buffer_get_used_space (PShmBuffer *buf)
-{
-	psize		read_pos, write_pos;
-	ppointer	addr;
-
-	addr = p_shm_get_address (buf->shm);
-
-	memcpy (&read_pos, (pchar *) addr + P_SHM_BUFFER_READ_OFFSET, sizeof (read_pos));
-	memcpy (&write_pos, (pchar *) addr + P_SHM_BUFFER_WRITE_OFFSET, sizeof (write_pos));
-
-	if (write_pos > read_pos)
-		return write_pos - read_pos;
-	else if (write_pos < read_pos)
-		return (buf->size - (read_pos - write_pos));
-	else
-		return 0;
-}
-
-P_LIB_API PShmBuffer *
-p_shm_buffer_new (const pchar	*name,
-		  psize		size,
-		  PError	**error)
+static void pp_shm_buffer_read_data (PShmBuffer *buf, ppointer addr, psize pos, ppointer storage, psize len);
+static void pp_shm_buffer_write_data (PShmBuffer *buf, ppointer addr, psize pos, pconstpointer data, psize len);
+static pboolean pp_shm_buffer_lock (PShmBuffer *buf, PError **error);
+static pboolean pp_shm_buffer_unlock (PShmBuffer *buf, PError **error);
+static void pp_shm_buffer_fill_view (PShmBuffer *buf, ppointer addr, psize pos, psize len, PShmBufferView *view);
+static pboolean pp_shm_buffer_wait (volatile pint *word, pint expected, pint timeout);
+static void pp_shm_buffer_wake (volatile pint *word, volatile pint *waiters);
+static pint pp_shm_buffer_read_spsc (PShmBuffer *buf, ppointer addr, ppointer storage, psize len);
+static pssize pp_shm_buffer_write_spsc (PShmBuffer *buf, ppointer addr, pconstpointer data, psize len);
+
+static PShmBuffer *
+pp_shm_buffer_new (const pchar	*name,
+		   psize	size,
+		   pboolean	is_spsc,
+		   PError	**error)
 {
 	PShmBuffer	*ret;
 	PShm		*shm;
+	psize		data_offset;
 
 	if (P_UNLIKELY (name == NULL)) {
 		p_error_set_error_p (error,
@@ -97,13 +135,24 @@ p_shm_buffer_new (const pchar	*name,
 		return NULL;
 	}
 
+	/* Emulated atomics use a lock which is local for the process */
+	if (P_UNLIKELY (is_spsc == TRUE && p_atomic_is_lock_free () == FALSE)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_NOT_IMPLEMENTED,
+				     0,
+				     "Lock-free atomic operations are not available");
+		return NULL;
+	}
+
+	data_offset = is_spsc ? P_SHM_BUFFER_SPSC_DATA_OFFSET : P_SHM_BUFFER_DATA_OFFSET;
+
 	if (P_UNLIKELY ((shm = p_shm_new (name,
-					  (size != 0) ? size + P_SHM_BUFFER_DATA_OFFSET + 1 : 0,
+					  (size != 0) ? size + data_offset + 1 : 0,
 					  P_SHM_ACCESS_READWRITE,
 					  error)) == NULL))
 		return NULL;
 
-	if (P_UNLIKELY (p_shm_get_size (shm) <= P_SHM_BUFFER_DATA_OFFSET + 1)) {
+	if (P_UNLIKELY (p_shm_get_size (shm) <= data_offset + 1)) {
 		p_error_set_error_p (error,
 				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
 				     0,
@@ -121,18 +170,392 @@ p_shm_buffer_new (const pchar	*name,
 		return NULL;
 	}
 
-	ret->shm  = shm;
-	ret->size = p_shm_get_size (shm) - P_SHM_BUFFER_DATA_OFFSET;
+	ret->shm          = shm;
+	ret->size         = p_shm_get_size (shm) - data_offset;
+	ret->is_spsc      = is_spsc;
+	ret->read_offset  = is_spsc ? P_SHM_BUFFER_SPSC_READ_OFFSET : P_SHM_BUFFER_READ_OFFSET;
+	ret->write_offset = is_spsc ? P_SHM_BUFFER_SPSC_WRITE_OFFSET : P_SHM_BUFFER_WRITE_OFFSET;
+	ret->data_offset  = data_offset;
+
+	if (is_spsc == TRUE) {
+		ret->space_seq       = (volatile pint *) ((pchar *) p_shm_get_address (shm) +
+							  ret->read_offset + P_SHM_BUFFER_SEQ_DELTA);
+		ret->writers_waiting = (volatile pint *) ((pchar *) p_shm_get_address (shm) +
+							  ret->read_offset + P_SHM_BUFFER_WAITERS_DELTA);
+		ret->data_seq        = (volatile pint *) ((pchar *) p_shm_get_address (shm) +
+							  ret->write_offset + P_SHM_BUFFER_SEQ_DELTA);
+		ret->readers_waiting = (volatile pint *) ((pchar *) p_shm_get_address (shm) +
+							  ret->write_offset + P_SHM_BUFFER_WAITERS_DELTA);
+	} else {
+		ret->space_seq       = (volatile pint *) ((pchar *) p_shm_get_address (shm) +
+							  P_SHM_BUFFER_SPACE_SEQ_OFFSET);
+		ret->writers_waiting = (volatile pint *) ((pchar *) p_shm_get_address (shm) +
+							  P_SHM_BUFFER_WRITERS_OFFSET);
+		ret->data_seq        = (volatile pint *) ((pchar *) p_shm_get_address (shm) +
+							  P_SHM_BUFFER_DATA_SEQ_OFFSET);
+		ret->readers_waiting = (volatile pint *) ((pchar *) p_shm_get_address (shm) +
+							  P_SHM_BUFFER_READERS_OFFSET);
+	}
+
+	/* The other side may already be running, the caches must not run ahead */
+	if (is_spsc == TRUE && p_shm_get_address (shm) != NULL) {
+		ret->read_cache  = pp_shm_buffer_get_pos (ret,
+							  p_shm_get_address (shm),
+							  ret->read_offset,
+							  P_ATOMIC_MEMORY_ORDER_ACQUIRE);
+		ret->write_cache = pp_shm_buffer_get_pos (ret,
+							  p_shm_get_address (shm),
+							  ret->write_offset,
+							  P_ATOMIC_MEMORY_ORDER_ACQUIRE);
+	}
 
 	return ret;
 }
 
+static psize
+pp_shm_buffer_get_pos (PShmBuffer		*buf,
+		       ppointer			addr,
+		       psize			offset,
+		       PAtomicMemoryOrder	order)
+{
+	psize pos;
+
+	if (buf->is_spsc == TRUE)
+		return PPOINTER_TO_PSIZE (p_atomic_pointer_get_explicit ((pchar *) addr + offset, order));
+
+	memcpy (&pos, (pchar *) addr + offset, sizeof (pos));
+
+	return pos;
+}
+
+/* The SPSC mode publishes a position with the release semantics, so the data
+ * copied before is visible to the other side when it sees the position */
+static void
+pp_shm_buffer_set_pos (PShmBuffer	*buf,
+		       ppointer		addr,
+		       psize		offset,
+		       psize		pos)
+{
+	if (buf->is_spsc == TRUE)
+		p_atomic_pointer_set_explicit ((pchar *) addr + offset,
+					       PSIZE_TO_POINTER (pos),
+					       P_ATOMIC_MEMORY_ORDER_RELEASE);
+	else
+		memcpy ((pchar *) addr + offset, &pos, sizeof (pos));
+}
+
+static psize
+pp_shm_buffer_calc_free_space (PShmBuffer	*buf,
+			       psize		read_pos,
+			       psize		write_pos)
+{
+	if (write_pos < read_pos)
+		return read_pos - write_pos - 1;
+	else if (write_pos > read_pos)
+		return buf->size - (write_pos - read_pos) - 1;
+	else
+		return buf->size - 1;
+}
+
+static psize
+pp_shm_buffer_calc_used_space (PShmBuffer	*buf,
+			       psize		read_pos,
+			       psize		write_pos)
+{
+	if (write_pos > read_pos)
+		return write_pos - read_pos;
+	else if (write_pos < read_pos)
+		return (buf->size - (read_pos - write_pos));
+	else
+		return 0;
+}
+
+/* Warning: this function is not thread-safe, only for internal usage */
+static psize
+pp_shm_buffer_get_free_space (PShmBuffer *buf)
+{
+	psize		read_pos, write_pos;
+	ppointer	addr;
+
+	addr = p_shm_get_address (buf->shm);
+
+	read_pos  = pp_shm_buffer_get_pos (buf, addr, buf->read_offset, P_ATOMIC_MEMORY_ORDER_ACQUIRE);
+	write_pos = pp_shm_buffer_get_pos (buf, addr, buf->write_offset, P_ATOMIC_MEMORY_ORDER_ACQUIRE);
+
+	return pp_shm_buffer_calc_free_space (buf, read_pos, write_pos);
+}
+
+static psize
+pp_shm_buffer_get_used_space (PShmBuffer *buf)
+{
+	psize		read_pos, write_pos;
+	ppointer	addr;
+
+	addr = p_shm_get_address (buf->shm);
+
+	read_pos  = pp_shm_buffer_get_pos (buf, addr, buf->read_offset, P_ATOMIC_MEMORY_ORDER_ACQUIRE);
+	write_pos = pp_shm_buffer_get_pos (buf, addr, buf->write_offset, P_ATOMIC_MEMORY_ORDER_ACQUIRE);
+
+	return pp_shm_buffer_calc_used_space (buf, read_pos, write_pos);
+}
+
+/* Copies from the ring in at most two chunks, split at the end of the ring */
+static void
+pp_shm_buffer_read_data (PShmBuffer	*buf,
+			 ppointer	addr,
+			 psize		pos,
+			 ppointer	storage,
+			 psize		len)
+{
+	pchar	*data = (pchar *) addr + buf->data_offset;
+	psize	first = buf->size - pos;
+
+	if (len <= first)
+		memcpy (storage, data + pos, len);
+	else {
+		memcpy (storage, data + pos, first);
+		memcpy ((pchar *) storage + first, data, len - first);
+	}
+}
+
+/* Copies to the ring in at most two chunks, split at the end of the ring */
+static void
+pp_shm_buffer_write_data (PShmBuffer	*buf,
+			  ppointer	addr,
+			  psize		pos,
+			  pconstpointer	data,
+			  psize		len)
+{
+	pchar	*ring = (pchar *) addr + buf->data_offset;
+	psize	first = buf->size - pos;
+
+	if (len <= first)
+		memcpy (ring + pos, data, len);
+	else {
+		memcpy (ring + pos, data, first);
+		memcpy (ring, (const pchar *) data + first, len - first);
+	}
+}
+
+/* Only the consumer moves the read position and only the producer moves the
+ * write one, so each side loads its own position without ordering. The other
+ * side's position is taken from the cache and loaded with the acquire
+ * semantics only when the cached one gives too little data or space. */
+static pint
+pp_shm_buffer_read_spsc (PShmBuffer	*buf,
+			 ppointer	addr,
+			 ppointer	storage,
+			 psize		len)
+{
+	psize read_pos;
+	psize data_aval;
+	psize to_copy;
+
+	read_pos  = pp_shm_buffer_get_pos (buf, addr, buf->read_offset, P_ATOMIC_MEMORY_ORDER_RELAXED);
+	data_aval = pp_shm_buffer_calc_used_space (buf, read_pos, buf->write_cache);
+
+	if (data_aval < len) {
+		buf->write_cache = pp_shm_buffer_get_pos (buf,
+							  addr,
+							  buf->write_offset,
+							  P_ATOMIC_MEMORY_ORDER_ACQUIRE);
+		data_aval        = pp_shm_buffer_calc_used_space (buf, read_pos, buf->write_cache);
+	}
+
+	if (data_aval == 0)
+		return 0;
+
+	to_copy = (data_aval <= len) ? data_aval : len;
+
+	pp_shm_buffer_read_data (buf, addr, read_pos, storage, to_copy);
+	pp_shm_buffer_set_pos (buf, addr, buf->read_offset, (read_pos + to_copy) % buf->size);
+
+	return (pint) to_copy;
+}
+
+static pssize
+pp_shm_buffer_write_spsc (PShmBuffer	*buf,
+			  ppointer	addr,
+			  pconstpointer	data,
+			  psize		len)
+{
+	psize write_pos;
+
+	write_pos = pp_shm_buffer_get_pos (buf, addr, buf->write_offset, P_ATOMIC_MEMORY_ORDER_RELAXED);
+
+	if (pp_shm_buffer_calc_free_space (buf, buf->read_cache, write_pos) < len) {
+		buf->read_cache = pp_shm_buffer_get_pos (buf,
+							 addr,
+							 buf->read_offset,
+							 P_ATOMIC_MEMORY_ORDER_ACQUIRE);
+
+		if (pp_shm_buffer_calc_free_space (buf, buf->read_cache, write_pos) < len)
+			return 0;
+	}
+
+	pp_shm_buffer_write_data (buf, addr, write_pos, data, len);
+	pp_shm_buffer_set_pos (buf, addr, buf->write_offset, (write_pos + len) % buf->size);
+
+	return (pssize) len;
+}
+
+/* A reserved or peeked range keeps a locked buffer locked until it is
+ * committed or consumed, both sides of the same object share the lock */
+static pboolean
+pp_shm_buffer_lock (PShmBuffer	*buf,
+		    PError	**error)
+{
+	if (buf->is_spsc == TRUE || buf->lock_users++ > 0)
+		return TRUE;
+
+	if (P_UNLIKELY (p_shm_lock (buf->shm, error) == FALSE)) {
+		buf->lock_users = 0;
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static pboolean
+pp_shm_buffer_unlock (PShmBuffer	*buf,
+		      PError		**error)
+{
+	if (buf->is_spsc == TRUE || --buf->lock_users > 0)
+		return TRUE;
+
+	return p_shm_unlock (buf->shm, error);
+}
+
+static void
+pp_shm_buffer_fill_view (PShmBuffer	*buf,
+			 ppointer	addr,
+			 psize		pos,
+			 psize		len,
+			 PShmBufferView	*view)
+{
+	pchar	*data = (pchar *) addr + buf->data_offset;
+	psize	first = buf->size - pos;
+
+	if (len <= first) {
+		view->data[0] = data + pos;
+		view->size[0] = len;
+		view->data[1] = NULL;
+		view->size[1] = 0;
+	} else {
+		view->data[0] = data + pos;
+		view->size[0] = first;
+		view->data[1] = data;
+		view->size[1] = len - first;
+	}
+}
+
+/* Returns FALSE on timeout, TRUE if the word has changed or on a wakeup */
+static pboolean
+pp_shm_buffer_wait (volatile pint	*word,
+		    pint		expected,
+		    pint		timeout)
+{
+#if defined (PLIBSYS_HAS_FUTEX)
+	struct timespec	ts;
+	struct timespec	*pts = NULL;
+
+	if (timeout > 0) {
+		ts.tv_sec  = timeout / 1000;
+		ts.tv_nsec = (timeout % 1000) * 1000000L;
+		pts        = &ts;
+	}
+
+	/* Not the private futex: the sleepers may be in other processes */
+	if (syscall (SYS_futex, word, FUTEX_WAIT, expected, pts, NULL, 0) == 0)
+		return TRUE;
+
+	return errno == ETIMEDOUT ? FALSE : TRUE;
+#elif defined (PLIBSYS_HAS_ULOCK)
+	puint32 usecs;
+
+	if (timeout < 0)
+		usecs = 0;
+	else if ((puint32) timeout > P_MAXUINT32 / 1000)
+		usecs = (P_MAXUINT32 / 1000) * 1000;
+	else
+		usecs = (puint32) timeout * 1000;
+
+	return __ulock_wait (P_SHM_BUFFER_ULOCK_COMPARE_AND_WAIT_SHARED | P_SHM_BUFFER_ULOCK_NO_ERRNO,
+			     (void *) word,
+			     (puint64) (puint32) expected,
+			     usecs) == -ETIMEDOUT ? FALSE : TRUE;
+#else
+	PDeadline	deadline;
+	pint		spins = 0;
+
+	/* No process-shared wait here, poll the word */
+	p_deadline_init_msecs (&deadline, timeout);
+
+	while (p_atomic_int_get (word) == expected) {
+		if (p_deadline_has_expired (&deadline) == TRUE)
+			return FALSE;
+
+		if (spins++ < P_SHM_BUFFER_WAIT_SPINS)
+			p_uthread_yield ();
+		else
+			p_uthread_sleep (1);
+	}
+
+	return TRUE;
+#endif
+}
+
+/* Called after the position is published */
+static void
+pp_shm_buffer_wake (volatile pint	*word,
+		    volatile pint	*waiters)
+{
+	p_atomic_thread_fence (P_ATOMIC_MEMORY_ORDER_SEQ_CST);
+
+	if (p_atomic_int_get_explicit (waiters, P_ATOMIC_MEMORY_ORDER_RELAXED) == 0)
+		return;
+
+	p_atomic_int_inc (word);
+
+#if defined (PLIBSYS_HAS_FUTEX)
+	syscall (SYS_futex, word, FUTEX_WAKE, P_MAXINT32, NULL, NULL, 0);
+#elif defined (PLIBSYS_HAS_ULOCK)
+	__ulock_wake (P_SHM_BUFFER_ULOCK_COMPARE_AND_WAIT_SHARED |
+		      P_SHM_BUFFER_ULOCK_NO_ERRNO                |
+		      P_SHM_BUFFER_ULOCK_WAKE_ALL,
+		      (void *) word,
+		      0);
+#endif
+}
+
+P_LIB_API PShmBuffer *
+p_shm_buffer_new (const pchar	*name,
+		  psize		size,
+		  PError	**error)
+{
+	return pp_shm_buffer_new (name, size, FALSE, error);
+}
+
+P_LIB_API PShmBuffer *
+p_shm_buffer_new_spsc (const pchar	*name,
+		       psize		size,
+		       PError		**error)
+{
+	return pp_shm_buffer_new (name, size, TRUE, error);
+}
+
 P_LIB_API void
 p_shm_buffer_free (PShmBuffer *buf)
 {
 	if (P_UNLIKELY (buf == NULL))
 		return;
 
+	/* Don't leave the other users locked out */
+	if (buf->lock_users > 0) {
+		buf->lock_users = 1;
+		pp_shm_buffer_unlock (buf, NULL);
+	}
+
 	p_shm_free (buf->shm);
 	p_free (buf);
 }
@@ -154,7 +577,7 @@ p_shm_buffer_read (PShmBuffer	*buf,
 {
 	psize		read_pos, write_pos;
 	psize		data_aval, to_copy;
-	puint		i;
+	pint		result;
 	ppointer	addr;
 
 	if (P_UNLIKELY (buf == NULL || storage == NULL || len == 0)) {
@@ -173,6 +596,13 @@ p_shm_buffer_read (PShmBuffer	*buf,
 		return -1;
 	}
 
+	if (buf->is_spsc == TRUE) {
+		if ((result = pp_shm_buffer_read_spsc (buf, addr, storage, len)) > 0)
+			pp_shm_buffer_wake (buf->space_seq, buf->writers_waiting);
+
+		return result;
+	}
+
 	if (P_UNLIKELY (p_shm_lock (buf->shm, error) == FALSE))
 		return -1;
 
@@ -189,10 +619,7 @@ p_shm_buffer_read (PShmBuffer	*buf,
 	data_aval = pp_shm_buffer_get_used_space (buf);
 	to_copy   = (data_aval <= len) ? data_aval : len;
 
-	for (i = 0; i < to_copy; ++i)
-		memcpy ((pchar *) storage + i,
-			(pchar *) addr + P_SHM_BUFFER_DATA_OFFSET + ((read_pos + i) % buf->size),
-			1);
+	pp_shm_buffer_read_data (buf, addr, read_pos, storage, to_copy);
 
 	read_pos = (read_pos + to_copy) % buf->size;
 	memcpy ((pchar *) addr + P_SHM_BUFFER_READ_OFFSET, &read_pos, sizeof (read_pos));
@@ -200,6 +627,8 @@ p_shm_buffer_read (PShmBuffer	*buf,
 	if (P_UNLIKELY (p_shm_unlock (buf->shm, error) == FALSE))
 		return -1;
 
+	pp_shm_buffer_wake (buf->space_seq, buf->writers_waiting);
+
 	return (pint) to_copy;
 }
 
@@ -210,7 +639,7 @@ p_shm_buffer_write (PShmBuffer	*buf,
 		    PError	**error)
 {
 	psize		read_pos, write_pos;
-	puint		i;
+	pssize		result;
 	ppointer	addr;
 
 	if (P_UNLIKELY (buf == NULL || data == NULL || len == 0)) {
@@ -229,6 +658,13 @@ p_shm_buffer_write (PShmBuffer	*buf,
 		return -1;
 	}
 
+	if (buf->is_spsc == TRUE) {
+		if ((result = pp_shm_buffer_write_spsc (buf, addr, data, len)) > 0)
+			pp_shm_buffer_wake (buf->data_seq, buf->readers_waiting);
+
+		return result;
+	}
+
 	if (P_UNLIKELY (p_shm_lock (buf->shm, error) == FALSE))
 		return -1;
 
@@ -242,10 +678,7 @@ p_shm_buffer_write (PShmBuffer	*buf,
 		return 0;
 	}
 
-	for (i = 0; i < len; ++i)
-		memcpy ((pchar *) addr + P_SHM_BUFFER_DATA_OFFSET + ((write_pos + i) % buf->size),
-			(pchar *) data + i,
-			1);
+	pp_shm_buffer_write_data (buf, addr, write_pos, data, len);
 
 	write_pos = (write_pos + len) % buf->size;
 	memcpy ((pchar *) addr + P_SHM_BUFFER_WRITE_OFFSET, &write_pos, sizeof (write_pos));
@@ -253,6 +686,291 @@ p_shm_buffer_write (PShmBuffer	*buf,
 	if (P_UNLIKELY (p_shm_unlock (buf->shm, error) == FALSE))
 		return -1;
 
+	pp_shm_buffer_wake (buf->data_seq, buf->readers_waiting);
+
+	return (pssize) len;
+}
+
+P_LIB_API pint
+p_shm_buffer_read_wait (PShmBuffer	*buf,
+			ppointer	storage,
+			psize		len,
+			pint		timeout,
+			PError		**error)
+{
+	PDeadline deadline;
+
+	p_deadline_init_msecs (&deadline, timeout);
+
+	return p_shm_buffer_read_until (buf, storage, len, &deadline, error);
+}
+
+P_LIB_API pint
+p_shm_buffer_read_until (PShmBuffer		*buf,
+			 ppointer		storage,
+			 psize			len,
+			 const PDeadline	*deadline,
+			 PError			**error)
+{
+	pint	result;
+	pint	remaining;
+	pint	seq;
+
+	if (P_UNLIKELY (buf == NULL || storage == NULL || len == 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	while (TRUE) {
+		if ((result = p_shm_buffer_read (buf, storage, len, error)) != 0)
+			return result;
+
+		if ((remaining = p_deadline_get_remaining_msecs (deadline)) == 0)
+			return 0;
+
+		seq = p_atomic_int_get (buf->data_seq);
+
+		p_atomic_int_inc (buf->readers_waiting);
+		p_atomic_thread_fence (P_ATOMIC_MEMORY_ORDER_SEQ_CST);
+
+		if ((result = p_shm_buffer_read (buf, storage, len, error)) == 0)
+			pp_shm_buffer_wait (buf->data_seq, seq, remaining);
+
+		p_atomic_int_add (buf->readers_waiting, -1);
+
+		if (result != 0)
+			return result;
+	}
+}
+
+P_LIB_API pssize
+p_shm_buffer_write_wait (PShmBuffer	*buf,
+			 ppointer	data,
+			 psize		len,
+			 pint		timeout,
+			 PError		**error)
+{
+	PDeadline deadline;
+
+	p_deadline_init_msecs (&deadline, timeout);
+
+	return p_shm_buffer_write_until (buf, data, len, &deadline, error);
+}
+
+P_LIB_API pssize
+p_shm_buffer_write_until (PShmBuffer		*buf,
+			  ppointer		data,
+			  psize			len,
+			  const PDeadline	*deadline,
+			  PError		**error)
+{
+	pssize	result;
+	pint	remaining;
+	pint	seq;
+
+	/* Such data would never fit, no point to wait */
+	if (P_UNLIKELY (buf == NULL || data == NULL || len == 0 || len >= buf->size)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	while (TRUE) {
+		if ((result = p_shm_buffer_write (buf, data, len, error)) != 0)
+			return result;
+
+		if ((remaining = p_deadline_get_remaining_msecs (deadline)) == 0)
+			return 0;
+
+		seq = p_atomic_int_get (buf->space_seq);
+
+		p_atomic_int_inc (buf->writers_waiting);
+		p_atomic_thread_fence (P_ATOMIC_MEMORY_ORDER_SEQ_CST);
+
+		if ((result = p_shm_buffer_write (buf, data, len, error)) == 0)
+			pp_shm_buffer_wait (buf->space_seq, seq, remaining);
+
+		p_atomic_int_add (buf->writers_waiting, -1);
+
+		if (result != 0)
+			return result;
+	}
+}
+
+P_LIB_API pssize
+p_shm_buffer_reserve_write (PShmBuffer		*buf,
+			    psize		len,
+			    PShmBufferView	*view,
+			    PError		**error)
+{
+	psize		read_pos, write_pos;
+	ppointer	addr;
+
+	if (P_UNLIKELY (buf == NULL || len == 0 || view == NULL || buf->reserved != 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	if (P_UNLIKELY ((addr = p_shm_get_address (buf->shm)) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Unable to get shared memory address");
+		return -1;
+	}
+
+	if (P_UNLIKELY (pp_shm_buffer_lock (buf, error) == FALSE))
+		return -1;
+
+	write_pos = pp_shm_buffer_get_pos (buf, addr, buf->write_offset, P_ATOMIC_MEMORY_ORDER_RELAXED);
+
+	if (buf->is_spsc == TRUE) {
+		read_pos = buf->read_cache;
+
+		if (pp_shm_buffer_calc_free_space (buf, read_pos, write_pos) < len) {
+			read_pos        = pp_shm_buffer_get_pos (buf,
+								 addr,
+								 buf->read_offset,
+								 P_ATOMIC_MEMORY_ORDER_ACQUIRE);
+			buf->read_cache = read_pos;
+		}
+	} else
+		read_pos = pp_shm_buffer_get_pos (buf, addr, buf->read_offset, P_ATOMIC_MEMORY_ORDER_RELAXED);
+
+	if (pp_shm_buffer_calc_free_space (buf, read_pos, write_pos) < len) {
+		if (P_UNLIKELY (pp_shm_buffer_unlock (buf, error) == FALSE))
+			return -1;
+
+		return 0;
+	}
+
+	pp_shm_buffer_fill_view (buf, addr, write_pos, len, view);
+	buf->reserved = len;
+
+	return (pssize) len;
+}
+
+P_LIB_API pssize
+p_shm_buffer_commit_write (PShmBuffer	*buf,
+			   psize	len,
+			   PError	**error)
+{
+	psize		write_pos;
+	ppointer	addr;
+
+	if (P_UNLIKELY (buf == NULL || buf->reserved == 0 || len > buf->reserved)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	addr          = p_shm_get_address (buf->shm);
+	buf->reserved = 0;
+
+	if (len > 0) {
+		write_pos = pp_shm_buffer_get_pos (buf, addr, buf->write_offset, P_ATOMIC_MEMORY_ORDER_RELAXED);
+		pp_shm_buffer_set_pos (buf, addr, buf->write_offset, (write_pos + len) % buf->size);
+	}
+
+	if (P_UNLIKELY (pp_shm_buffer_unlock (buf, error) == FALSE))
+		return -1;
+
+	if (len > 0)
+		pp_shm_buffer_wake (buf->data_seq, buf->readers_waiting);
+
+	return (pssize) len;
+}
+
+P_LIB_API pssize
+p_shm_buffer_peek (PShmBuffer		*buf,
+		   PShmBufferView	*view,
+		   PError		**error)
+{
+	psize		read_pos, write_pos;
+	psize		data_aval;
+	ppointer	addr;
+
+	if (P_UNLIKELY (buf == NULL || view == NULL || buf->peeked != 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	if (P_UNLIKELY ((addr = p_shm_get_address (buf->shm)) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Unable to get shared memory address");
+		return -1;
+	}
+
+	if (P_UNLIKELY (pp_shm_buffer_lock (buf, error) == FALSE))
+		return -1;
+
+	/* Peek shows everything, so the producer's position is always loaded */
+	read_pos  = pp_shm_buffer_get_pos (buf, addr, buf->read_offset, P_ATOMIC_MEMORY_ORDER_RELAXED);
+	write_pos = pp_shm_buffer_get_pos (buf, addr, buf->write_offset, P_ATOMIC_MEMORY_ORDER_ACQUIRE);
+	data_aval = pp_shm_buffer_calc_used_space (buf, read_pos, write_pos);
+
+	buf->write_cache = write_pos;
+
+	if (data_aval == 0) {
+		memset (view, 0, sizeof (PShmBufferView));
+
+		if (P_UNLIKELY (pp_shm_buffer_unlock (buf, error) == FALSE))
+			return -1;
+
+		return 0;
+	}
+
+	pp_shm_buffer_fill_view (buf, addr, read_pos, data_aval, view);
+	buf->peeked = data_aval;
+
+	return (pssize) data_aval;
+}
+
+P_LIB_API pssize
+p_shm_buffer_consume (PShmBuffer	*buf,
+		      psize		len,
+		      PError		**error)
+{
+	psize		read_pos;
+	ppointer	addr;
+
+	if (P_UNLIKELY (buf == NULL || buf->peeked == 0 || len > buf->peeked)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	addr        = p_shm_get_address (buf->shm);
+	buf->peeked = 0;
+
+	if (len > 0) {
+		read_pos = pp_shm_buffer_get_pos (buf, addr, buf->read_offset, P_ATOMIC_MEMORY_ORDER_RELAXED);
+		pp_shm_buffer_set_pos (buf, addr, buf->read_offset, (read_pos + len) % buf->size);
+	}
+
+	if (P_UNLIKELY (pp_shm_buffer_unlock (buf, error) == FALSE))
+		return -1;
+
+	if (len > 0)
+		pp_shm_buffer_wake (buf->space_seq, buf->writers_waiting);
+
 	return (pssize) len;
 }
 
@@ -270,6 +988,9 @@ p_shm_buffer_get_free_space (PShmBuffer	*buf,
 		return -1;
 	}
 
+	if (buf->is_spsc == TRUE)
+		return (pssize) pp_shm_buffer_get_free_space (buf);
+
 	if (P_UNLIKELY (p_shm_lock (buf->shm, error) == FALSE))
 		return -1;
 
@@ -295,6 +1016,9 @@ p_shm_buffer_get_used_space (PShmBuffer	*buf,
 		return -1;
 	}
 
+	if (buf->is_spsc == TRUE)
+		return (pssize) pp_shm_buffer_get_used_space (buf);
+
 	if (P_UNLIKELY (p_shm_lock (buf->shm, error) == FALSE))
 		return -1;
 
@@ -310,7 +1034,6 @@ P_LIB_API void
 p_shm_buffer_clear (PShmBuffer *buf)
 {
 	ppointer	addr;
-	psize		size;
 
 	if (P_UNLIKELY (buf == NULL))
 		return;
@@ -320,15 +1043,21 @@ p_shm_buffer_clear (PShmBuffer *buf)
 		return;
 	}
 
-	size = p_shm_get_size (buf->shm);
-
 	if (P_UNLIKELY (p_shm_lock (buf->shm, NULL) == FALSE)) {
 		P_ERROR ("PShmBuffer::p_shm_buffer_clear: p_shm_lock() failed");
 		return;
 	}
 
-	memset (addr, 0, size);
+	/* The wake words are kept: someone may be sleeping on them */
+	memset ((pchar *) addr + buf->read_offset, 0, sizeof (psize));
+	memset ((pchar *) addr + buf->write_offset, 0, sizeof (psize));
+	memset ((pchar *) addr + buf->data_offset, 0, buf->size);
+
+	buf->read_cache  = 0;
+	buf->write_cache = 0;
 
 	if (P_UNLIKELY (p_shm_unlock (buf->shm, NULL) == FALSE))
 		P_ERROR ("PShmBuffer::p_shm_buffer_clear: p_shm_unlock() failed");
+
+	pp_shm_buffer_wake (buf->space_seq, buf->writers_waiting);
 }
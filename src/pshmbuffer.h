@@ -61,6 +61,32 @@
  * Data can be read and written into the buffer only sequentially. There is no
  * way to access an arbitrary address inside the buffer.
  *
+ * A buffer with exactly one writer and one reader, which may live in different
+ * processes, can be opened with p_shm_buffer_new_spsc() instead. In this mode
+ * the read and the write positions are atomic variables on separate cache
+ * lines: each side moves only its own position and publishes it after copying
+ * the data, so reading and writing take no locks and no system calls at all.
+ * All the users of a buffer must open it in the same mode, and each side must
+ * be used by a single thread at a time. The mode needs lock-free atomic
+ * operations, see p_atomic_is_lock_free().
+ *
+ * To avoid copying the data in and out, a writer can reserve space in the
+ * buffer with p_shm_buffer_reserve_write(), build the data right there and
+ * publish it with p_shm_buffer_commit_write(). A reader can look at the
+ * available data with p_shm_buffer_peek() and release it with
+ * p_shm_buffer_consume(). The range may wrap around the end of the buffer, so
+ * it is given as a #PShmBufferView of up to two parts. A buffer opened with
+ * p_shm_buffer_new() stays locked from the reservation (or peek) until the
+ * commit (or consume), so keep that short and don't call p_shm_buffer_read()
+ * or p_shm_buffer_write() on the same object in between.
+ *
+ * To wait for the data or for the free space use p_shm_buffer_read_wait() and
+ * p_shm_buffer_write_wait(). A sleeping side is woken by the other one through
+ * a futex word inside the segment on Linux (or a shared ulock on macOS), so it
+ * works across the processes and costs the writer or the reader nothing when
+ * nobody sleeps. On other systems the waiting side polls the buffer. The
+ * sleepers are woken by every read, write, commit, consume and clear call.
+ *
  * You can take ownership of the shared memory buffer with
  * p_shm_buffer_take_ownership() to explicitly remove it from the system after
  * closing. Please refer to the #PShm description to understand the intention of
@@ -77,12 +103,20 @@
 #include "ptypes.h"
 #include "pmacros.h"
 #include "perror.h"
+#include "pdeadline.h"
 
 P_BEGIN_DECLS
 
 /** Shared memory buffer opaque data structure. */
 typedef struct PShmBuffer_ PShmBuffer;
 
+/** Range of a shared memory buffer, split in two parts if it wraps around the
+ * end of the buffer. */
+typedef struct PShmBufferView_ {
+	ppointer	data[2];	/**< Start of each part, NULL for an empty part.	*/
+	psize		size[2];	/**< Size of each part in bytes.			*/
+} PShmBufferView;
+
 /**
  * @brief Creates a new #PShmBuffer structure.
  * @param name Unique buffer name.
@@ -99,6 +133,29 @@ P_LIB_API PShmBuffer *	p_shm_buffer_new		(const pchar	*name,
 							 psize		size,
 							 PError		**error);
 
+/**
+ * @brief Creates a new #PShmBuffer structure for a single producer and a
+ * single consumer.
+ * @param name Unique buffer name.
+ * @param size Buffer size in bytes, can't be changed later.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Pointer to the #PShmBuffer structure in case of success, NULL
+ * otherwise.
+ * @since 0.0.5
+ *
+ * The buffer is read and written without locking: only one thread (in any
+ * process) may write into the buffer and only one may read from it at the
+ * same time. If a buffer with the same name already exists then the @a size
+ * will be ignored and the existing buffer will be returned, it must have been
+ * created with this call too.
+ *
+ * p_shm_buffer_clear() resets the positions, it must not be called while the
+ * other side uses the buffer.
+ */
+P_LIB_API PShmBuffer *	p_shm_buffer_new_spsc		(const pchar	*name,
+							 psize		size,
+							 PError		**error);
+
 /**
  * @brief Frees #PShmBuffer structure.
  * @param buf #PShmBuffer to free.
@@ -159,6 +216,144 @@ P_LIB_API pssize	p_shm_buffer_write		(PShmBuffer	*buf,
 							 psize		len,
 							 PError		**error);
 
+/**
+ * @brief Reads data from a shared memory buffer, waiting for it if needed.
+ * @param buf #PShmBuffer to read data from.
+ * @param[out] storage Output buffer to put data in.
+ * @param len Storage size in bytes.
+ * @param timeout Timeout in milliseconds, -1 to wait infinitely, 0 to not
+ * wait at all.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Number of read bytes (0 if no data has arrived in @a timeout), or -1
+ * if error occured.
+ * @since 0.0.5
+ */
+P_LIB_API pint		p_shm_buffer_read_wait		(PShmBuffer	*buf,
+							 ppointer	storage,
+							 psize		len,
+							 pint		timeout,
+							 PError		**error);
+
+/**
+ * @brief Reads data from a shared memory buffer, waiting for it no longer
+ * than until a deadline.
+ * @param buf #PShmBuffer to read data from.
+ * @param[out] storage Output buffer to put data in.
+ * @param len Storage size in bytes.
+ * @param deadline Deadline to wait until, NULL to wait infinitely.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Number of read bytes (0 if no data has arrived until @a deadline),
+ * or -1 if error occured.
+ * @since 0.0.5
+ * @sa p_shm_buffer_read_wait()
+ */
+P_LIB_API pint		p_shm_buffer_read_until		(PShmBuffer	*buf,
+							 ppointer	storage,
+							 psize		len,
+							 const PDeadline	*deadline,
+							 PError		**error);
+
+/**
+ * @brief Writes data into a shared memory buffer, waiting for the space if
+ * needed.
+ * @param buf #PShmBuffer to write data into.
+ * @param data Data to write.
+ * @param len Data size in bytes, must be less than the buffer size.
+ * @param timeout Timeout in milliseconds, -1 to wait infinitely, 0 to not
+ * wait at all.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Number of written bytes (0 if the space hasn't been freed in
+ * @a timeout), or -1 if error occured.
+ * @since 0.0.5
+ */
+P_LIB_API pssize	p_shm_buffer_write_wait		(PShmBuffer	*buf,
+							 ppointer	data,
+							 psize		len,
+							 pint		timeout,
+							 PError		**error);
+
+/**
+ * @brief Writes data into a shared memory buffer, waiting for the space no
+ * longer than until a deadline.
+ * @param buf #PShmBuffer to write data into.
+ * @param data Data to write.
+ * @param len Data size in bytes, must be less than the buffer size.
+ * @param deadline Deadline to wait until, NULL to wait infinitely.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Number of written bytes (0 if the space hasn't been freed until
+ * @a deadline), or -1 if error occured.
+ * @since 0.0.5
+ * @sa p_shm_buffer_write_wait()
+ */
+P_LIB_API pssize	p_shm_buffer_write_until	(PShmBuffer	*buf,
+							 ppointer	data,
+							 psize		len,
+							 const PDeadline	*deadline,
+							 PError		**error);
+
+/**
+ * @brief Reserves space for writing in place into a shared memory buffer.
+ * @param buf #PShmBuffer to reserve space in.
+ * @param len Size of the space in bytes.
+ * @param[out] view Reserved space, its parts together are @a len bytes long.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return @a len in case of success, 0 if the buffer hasn't enough free space,
+ * or -1 if error occured.
+ * @since 0.0.5
+ *
+ * The data written into @a view becomes visible for the reader only after
+ * p_shm_buffer_commit_write(). Only one range can be reserved at a time.
+ */
+P_LIB_API pssize	p_shm_buffer_reserve_write	(PShmBuffer	*buf,
+							 psize		len,
+							 PShmBufferView	*view,
+							 PError		**error);
+
+/**
+ * @brief Publishes the data written into the reserved space.
+ * @param buf #PShmBuffer to commit the data into.
+ * @param len Number of bytes to publish from the start of the reserved space,
+ * not more than reserved, 0 to cancel the reservation.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return @a len in case of success, -1 otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pssize	p_shm_buffer_commit_write	(PShmBuffer	*buf,
+							 psize		len,
+							 PError		**error);
+
+/**
+ * @brief Gets all the data available for reading without copying it.
+ * @param buf #PShmBuffer to look at.
+ * @param[out] view Available data, its parts together are as long as the
+ * returned value.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Number of available bytes (can be 0 if buffer is empty), or -1 if
+ * error occured.
+ * @since 0.0.5
+ *
+ * The data stays in the buffer until it is released with
+ * p_shm_buffer_consume(). Only one range can be peeked at a time.
+ */
+P_LIB_API pssize	p_shm_buffer_peek		(PShmBuffer	*buf,
+							 PShmBufferView	*view,
+							 PError		**error);
+
+/**
+ * @brief Releases the data got with p_shm_buffer_peek().
+ * @param buf #PShmBuffer to release the data in.
+ * @param len Number of bytes to release from the start of the peeked data,
+ * not more than peeked, 0 to release nothing.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return @a len in case of success, -1 otherwise.
+ * @since 0.0.5
+ *
+ * The released space can be overwritten by the writer.
+ */
+P_LIB_API pssize	p_shm_buffer_consume		(PShmBuffer	*buf,
+							 psize		len,
+							 PError		**error);
+
 /**
  * @brief Gets free space in the shared memory buffer.
  * @param buf #PShmBuffer to check space in.
@@ -0,0 +1,343 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Both positions only grow and are masked only to address the data, so the
+ * used space is always reserve - read, even after the positions wrap. The
+ * consumer publishes its position with a release store after it has zeroed
+ * the released records, and a producer loads it with acquire semantics before
+ * claiming the space. A record header is zero until its producer stores the
+ * message length (or the padding mark) with a release store, so the consumer
+ * sees the whole message once it sees the header. A zero header means that
+ * the record is still being written, or that the queue is empty. */
+
+#include "patomic.h"
+#include "pmem.h"
+#include "pshm.h"
+#include "pshmqueue.h"
+
+#include <string.h>
+
+#define P_SHM_QUEUE_RESERVE_OFFSET	0
+#define P_SHM_QUEUE_READ_OFFSET		P_MEM_CACHE_LINE_SIZE
+#define P_SHM_QUEUE_DATA_OFFSET		P_MEM_CACHE_LINE_SIZE * 2
+
+#define P_SHM_QUEUE_RECORD_ALIGN	8
+#define P_SHM_QUEUE_HEADER_SIZE		8
+#define P_SHM_QUEUE_MIN_SIZE		64
+#define P_SHM_QUEUE_PAD_MARK		-1
+
+struct PShmQueue_ {
+	PShm		*shm;
+	volatile psize	*reserve_pos;
+	volatile psize	*read_pos;
+	pchar		*data;
+	psize		mask;
+};
+
+static psize pp_shm_queue_get_pos (const volatile psize *pos, PAtomicMemoryOrder order);
+static void pp_shm_queue_set_pos (volatile psize *pos, psize value);
+static psize pp_shm_queue_get_record_size (psize len);
+static psize pp_shm_queue_next (PShmQueue *queue, psize *read_pos);
+static void pp_shm_queue_release (PShmQueue *queue, psize *read_pos, psize len);
+
+static psize
+pp_shm_queue_get_pos (const volatile psize	*pos,
+		      PAtomicMemoryOrder	order)
+{
+	return PPOINTER_TO_PSIZE (p_atomic_pointer_get_explicit (pos, order));
+}
+
+static void
+pp_shm_queue_set_pos (volatile psize	*pos,
+		      psize		value)
+{
+	p_atomic_pointer_set_explicit (pos, PSIZE_TO_POINTER (value), P_ATOMIC_MEMORY_ORDER_RELEASE);
+}
+
+static psize
+pp_shm_queue_get_record_size (psize len)
+{
+	return P_SHM_QUEUE_HEADER_SIZE + ((len + P_SHM_QUEUE_RECORD_ALIGN - 1) & ~((psize) P_SHM_QUEUE_RECORD_ALIGN - 1));
+}
+
+/* Returns the length of the complete message at the read position or 0,
+ * skips (and zeroes) the padding on the way. */
+static psize
+pp_shm_queue_next (PShmQueue	*queue,
+		   psize	*read_pos)
+{
+	pchar	*record;
+	pint	header;
+
+	while (TRUE) {
+		record = queue->data + (*read_pos & queue->mask);
+		header = p_atomic_int_get_explicit ((volatile pint *) record, P_ATOMIC_MEMORY_ORDER_ACQUIRE);
+
+		if (header != P_SHM_QUEUE_PAD_MARK)
+			return (psize) header;
+
+		memset (record, 0, P_SHM_QUEUE_HEADER_SIZE);
+		*read_pos += queue->mask + 1 - (*read_pos & queue->mask);
+	}
+}
+
+/* Zeroes the record: its space may hold any header of the next round */
+static void
+pp_shm_queue_release (PShmQueue	*queue,
+		      psize	*read_pos,
+		      psize	len)
+{
+	psize record_size = pp_shm_queue_get_record_size (len);
+
+	memset (queue->data + (*read_pos & queue->mask), 0, record_size);
+	*read_pos += record_size;
+}
+
+P_LIB_API PShmQueue *
+p_shm_queue_new (const pchar	*name,
+		 psize		size,
+		 PError		**error)
+{
+	PShmQueue	*ret;
+	PShm		*shm;
+	psize		capacity;
+
+	if (P_UNLIKELY (name == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return NULL;
+	}
+
+	/* Emulated atomics use a lock which is local for the process */
+	if (P_UNLIKELY (p_atomic_is_lock_free () == FALSE)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_NOT_IMPLEMENTED,
+				     0,
+				     "Lock-free atomic operations are not available");
+		return NULL;
+	}
+
+	/* Power of two capacity keeps the masked positions valid after a wrap */
+	for (capacity = P_SHM_QUEUE_MIN_SIZE; capacity < size && capacity <= P_MAXSIZE / 4; capacity <<= 1)
+		;
+
+	if (P_UNLIKELY ((shm = p_shm_new (name,
+					  (size != 0) ? capacity + P_SHM_QUEUE_DATA_OFFSET : 0,
+					  P_SHM_ACCESS_READWRITE,
+					  error)) == NULL))
+		return NULL;
+
+	/* The segment may be opened with a zero size, take what it has */
+	if (p_shm_get_size (shm) >= P_SHM_QUEUE_DATA_OFFSET) {
+		for (capacity = P_SHM_QUEUE_MIN_SIZE;
+		     capacity <= (p_shm_get_size (shm) - P_SHM_QUEUE_DATA_OFFSET) / 2;
+		     capacity <<= 1)
+			;
+	}
+
+	if (P_UNLIKELY (p_shm_get_size (shm) < P_SHM_QUEUE_DATA_OFFSET + P_SHM_QUEUE_MIN_SIZE ||
+			p_shm_get_address (shm) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Too small memory segment to hold required data");
+		p_shm_free (shm);
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PShmQueue))) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for shared queue");
+		p_shm_free (shm);
+		return NULL;
+	}
+
+	ret->shm         = shm;
+	ret->reserve_pos = (volatile psize *) ((pchar *) p_shm_get_address (shm) + P_SHM_QUEUE_RESERVE_OFFSET);
+	ret->read_pos    = (volatile psize *) ((pchar *) p_shm_get_address (shm) + P_SHM_QUEUE_READ_OFFSET);
+	ret->data        = (pchar *) p_shm_get_address (shm) + P_SHM_QUEUE_DATA_OFFSET;
+	ret->mask        = capacity - 1;
+
+	return ret;
+}
+
+P_LIB_API void
+p_shm_queue_free (PShmQueue *queue)
+{
+	if (P_UNLIKELY (queue == NULL))
+		return;
+
+	p_shm_free (queue->shm);
+	p_free (queue);
+}
+
+P_LIB_API void
+p_shm_queue_take_ownership (PShmQueue *queue)
+{
+	if (P_UNLIKELY (queue == NULL))
+		return;
+
+	p_shm_take_ownership (queue->shm);
+}
+
+P_LIB_API pssize
+p_shm_queue_push (PShmQueue	*queue,
+		  pconstpointer	data,
+		  psize		len,
+		  PError	**error)
+{
+	psize	reserve_pos, read_pos;
+	psize	record_size, tail, need;
+	pchar	*record;
+
+	if (P_UNLIKELY (queue == NULL || data == NULL || len == 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	/* With the skipped tail a larger record may not fit even in an empty queue */
+	if (P_UNLIKELY (len > (psize) P_MAXINT32 || len > (queue->mask + 1) / 2 ||
+			(record_size = pp_shm_queue_get_record_size (len)) > (queue->mask + 1) / 2)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Too large message for the queue");
+		return -1;
+	}
+
+	do {
+		reserve_pos = pp_shm_queue_get_pos (queue->reserve_pos, P_ATOMIC_MEMORY_ORDER_RELAXED);
+		read_pos    = pp_shm_queue_get_pos (queue->read_pos, P_ATOMIC_MEMORY_ORDER_ACQUIRE);
+
+		/* The record doesn't wrap, the tail is skipped instead */
+		tail = queue->mask + 1 - (reserve_pos & queue->mask);
+		need = tail < record_size ? tail + record_size : record_size;
+
+		if (queue->mask + 1 - (reserve_pos - read_pos) < need)
+			return 0;
+	} while (p_atomic_pointer_compare_and_exchange_explicit (queue->reserve_pos,
+								 PSIZE_TO_POINTER (reserve_pos),
+								 PSIZE_TO_POINTER (reserve_pos + need),
+								 P_ATOMIC_MEMORY_ORDER_ACQUIRE) == FALSE);
+
+	if (need != record_size) {
+		p_atomic_int_set_explicit ((volatile pint *) (queue->data + (reserve_pos & queue->mask)),
+					   P_SHM_QUEUE_PAD_MARK,
+					   P_ATOMIC_MEMORY_ORDER_RELEASE);
+		reserve_pos += tail;
+	}
+
+	record = queue->data + (reserve_pos & queue->mask);
+
+	memcpy (record + P_SHM_QUEUE_HEADER_SIZE, data, len);
+	p_atomic_int_set_explicit ((volatile pint *) record, (pint) len, P_ATOMIC_MEMORY_ORDER_RELEASE);
+
+	return (pssize) len;
+}
+
+P_LIB_API pssize
+p_shm_queue_pop (PShmQueue	*queue,
+		 ppointer	storage,
+		 psize		len,
+		 PError		**error)
+{
+	psize	read_pos, start_pos;
+	psize	msg_len;
+
+	if (P_UNLIKELY (queue == NULL || storage == NULL || len == 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	start_pos = pp_shm_queue_get_pos (queue->read_pos, P_ATOMIC_MEMORY_ORDER_RELAXED);
+	read_pos  = start_pos;
+
+	if ((msg_len = pp_shm_queue_next (queue, &read_pos)) > len) {
+		if (read_pos != start_pos)
+			pp_shm_queue_set_pos (queue->read_pos, read_pos);
+
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Too small storage to hold the message");
+		return -1;
+	}
+
+	if (msg_len > 0) {
+		memcpy (storage, queue->data + (read_pos & queue->mask) + P_SHM_QUEUE_HEADER_SIZE, msg_len);
+		pp_shm_queue_release (queue, &read_pos, msg_len);
+	}
+
+	if (read_pos != start_pos)
+		pp_shm_queue_set_pos (queue->read_pos, read_pos);
+
+	return (pssize) msg_len;
+}
+
+P_LIB_API pssize
+p_shm_queue_pop_batch (PShmQueue	*queue,
+		       PShmQueueFunc	func,
+		       ppointer		user_data,
+		       psize		max_count,
+		       PError		**error)
+{
+	psize	read_pos, start_pos;
+	psize	msg_len;
+	psize	count;
+
+	if (P_UNLIKELY (queue == NULL || func == NULL || max_count == 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	start_pos = pp_shm_queue_get_pos (queue->read_pos, P_ATOMIC_MEMORY_ORDER_RELAXED);
+	read_pos  = start_pos;
+
+	for (count = 0; count < max_count; ++count) {
+		if ((msg_len = pp_shm_queue_next (queue, &read_pos)) == 0)
+			break;
+
+		func (queue->data + (read_pos & queue->mask) + P_SHM_QUEUE_HEADER_SIZE, msg_len, user_data);
+		pp_shm_queue_release (queue, &read_pos, msg_len);
+	}
+
+	if (read_pos != start_pos)
+		pp_shm_queue_set_pos (queue->read_pos, read_pos);
+
+	return (pssize) count;
+}
@@ -0,0 +1,179 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pshmqueue.h
+ * @brief Multi-producer shared memory message queue
+ * @author Alexander Saprykin
+ *
+ * A shared memory queue passes messages from any number of producers to a
+ * single consumer, which may all live in different processes. Unlike
+ * #PShmBuffer, which is a stream of bytes, the queue keeps the message
+ * boundaries: every message is stored as a record with its length, and the
+ * consumer always gets whole messages in the order they were reserved.
+ *
+ * The queue is identified by its name across the system, like #PShm. Use
+ * p_shm_queue_new() to open it and p_shm_queue_free() to close it. All the
+ * users of a queue must open it with the same call.
+ *
+ * A producer claims space for its record with a single compare and exchange
+ * on the reserve position in the segment header, copies the message there and
+ * then marks the record as complete. Producers don't wait for each other, but
+ * the consumer stops at the first record which is not complete yet. A record
+ * never wraps around the end of the queue: if it doesn't fit, the tail is
+ * skipped. Don't let a producer die between the reservation and the end of
+ * p_shm_queue_push(), the consumer would never get past its record.
+ *
+ * p_shm_queue_pop() copies a single message out. p_shm_queue_pop_batch()
+ * passes several messages to a callback right in the shared memory and frees
+ * their space at once, so the producers see it with a single update. Only one
+ * thread (in any process) may consume the messages at the same time.
+ *
+ * The queue needs lock-free atomic operations, see p_atomic_is_lock_free().
+ *
+ * You can take ownership of the queue with p_shm_queue_take_ownership() to
+ * remove it from the system after closing, see #PShm for the details.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PSHMQUEUE_H
+#define PLIBSYS_HEADER_PSHMQUEUE_H
+
+#include "ptypes.h"
+#include "pmacros.h"
+#include "perror.h"
+
+P_BEGIN_DECLS
+
+/** Shared memory queue opaque data structure. */
+typedef struct PShmQueue_ PShmQueue;
+
+/**
+ * @brief Function to receive a message from p_shm_queue_pop_batch().
+ * @param data Message data, valid only during the call.
+ * @param len Message size in bytes.
+ * @param user_data Data provided by the caller.
+ * @since 0.0.5
+ */
+typedef void (*PShmQueueFunc) (pconstpointer data, psize len, ppointer user_data);
+
+/**
+ * @brief Creates a new #PShmQueue structure.
+ * @param name Unique queue name.
+ * @param size Queue size in bytes, can't be changed later. Each message takes
+ * its size rounded up to 8 bytes plus 8 bytes for the header.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Pointer to the #PShmQueue structure in case of success, NULL
+ * otherwise.
+ * @since 0.0.5
+ *
+ * If a queue with the same name already exists then the @a size will be
+ * ignored and the existing queue will be returned.
+ */
+P_LIB_API PShmQueue *	p_shm_queue_new			(const pchar	*name,
+							 psize		size,
+							 PError		**error);
+
+/**
+ * @brief Frees #PShmQueue structure.
+ * @param queue #PShmQueue to free.
+ * @since 0.0.5
+ *
+ * Note that a queue will be completely removed from the system only after the
+ * last instance of the queue with the same name is closed.
+ */
+P_LIB_API void		p_shm_queue_free		(PShmQueue	*queue);
+
+/**
+ * @brief Takes ownership of a shared memory queue.
+ * @param queue Shared memory queue.
+ * @since 0.0.5
+ *
+ * Works like p_shm_buffer_take_ownership().
+ */
+P_LIB_API void		p_shm_queue_take_ownership	(PShmQueue	*queue);
+
+/**
+ * @brief Tries to put a message into a shared memory queue.
+ * @param queue #PShmQueue to put the message into.
+ * @param data Message data.
+ * @param len Message size in bytes, can't be 0. The message with its header
+ * can take up to a half of the queue size.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return @a len in case of success, 0 if the queue hasn't enough free space,
+ * or -1 if error occured (including a message which would never fit).
+ * @since 0.0.5
+ *
+ * Can be called by any number of producers at the same time.
+ */
+P_LIB_API pssize	p_shm_queue_push		(PShmQueue	*queue,
+							 pconstpointer	data,
+							 psize		len,
+							 PError		**error);
+
+/**
+ * @brief Tries to take a message from a shared memory queue.
+ * @param queue #PShmQueue to take the message from.
+ * @param[out] storage Output buffer to put the message in.
+ * @param len Storage size in bytes.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Message size in bytes, 0 if there is no complete message, or -1 if
+ * error occured.
+ * @since 0.0.5
+ *
+ * The message is left in the queue if it doesn't fit into @a storage, the
+ * call fails in that case.
+ */
+P_LIB_API pssize	p_shm_queue_pop			(PShmQueue	*queue,
+							 ppointer	storage,
+							 psize		len,
+							 PError		**error);
+
+/**
+ * @brief Takes several messages from a shared memory queue without copying.
+ * @param queue #PShmQueue to take the messages from.
+ * @param func Function to call for each message.
+ * @param user_data Data to pass to @a func.
+ * @param max_count Maximum number of messages to take.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Number of messages taken (0 if there is no complete message), or -1
+ * if error occured.
+ * @since 0.0.5
+ *
+ * The space of all the taken messages is released after the last call of
+ * @a func.
+ */
+P_LIB_API pssize	p_shm_queue_pop_batch		(PShmQueue	*queue,
+							 PShmQueueFunc	func,
+							 ppointer	user_data,
+							 psize		max_count,
+							 PError		**error);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PSHMQUEUE_H */
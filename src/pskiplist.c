@@ -0,0 +1,526 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "patomic.h"
+#include "pmem.h"
+#include "preclaim.h"
+#include "pskiplist.h"
+
+#define P_SKIP_LIST_MAX_LEVEL	32
+
+#define P_SKIP_LIST_IS_MARKED(ptr)	((PPOINTER_TO_PSIZE (ptr) & 1) != 0)
+#define P_SKIP_LIST_MARK(ptr)		((PSkipListNode *) PSIZE_TO_POINTER (PPOINTER_TO_PSIZE (ptr) | 1))
+#define P_SKIP_LIST_UNMARK(ptr)		((PSkipListNode *) PSIZE_TO_POINTER (PPOINTER_TO_PSIZE (ptr) & ~((psize) 1)))
+
+typedef struct PSkipListNode_ PSkipListNode;
+
+/* The lowest bit of a next pointer marks the node as removed at that level.
+ * A node is referenced by its inserter until all its levels are linked and by
+ * its remover, the last one retires the node, so a node being removed while
+ * its upper levels are still linked is never freed while reachable. */
+struct PSkipListNode_ {
+	PSkipList		*list;
+	ppointer		key;
+	ppointer		value;
+	volatile pint		ref_count;
+	pint			height;
+	PSkipListNode * volatile next[1];
+};
+
+struct PSkipList_ {
+	PSkipListNode		*head;
+	PEpochDomain		*domain;
+	PCompareDataFunc	func;
+	ppointer		data;
+	PDestroyFunc		key_destroy;
+	PDestroyFunc		value_destroy;
+	volatile pint		count;
+};
+
+static PSkipListNode * pp_skip_list_node_new (PSkipList *list, pint height);
+static void pp_skip_list_node_free (PSkipListNode *node);
+static void pp_skip_list_node_unref (PSkipListNode *node);
+static pint pp_skip_list_random_height (puint64 seed);
+static pboolean pp_skip_list_find (PSkipList *list, pconstpointer key, PSkipListNode **preds, PSkipListNode **succs);
+static PSkipListNode * pp_skip_list_lower_bound (PSkipList *list, pconstpointer key);
+
+static PSkipListNode *
+pp_skip_list_node_new (PSkipList	*list,
+		       pint		height)
+{
+	PSkipListNode	*node;
+	pint		i;
+
+	node = p_malloc (sizeof (PSkipListNode) + (psize) (height - 1) * sizeof (PSkipListNode *));
+
+	if (P_UNLIKELY (node == NULL))
+		return NULL;
+
+	node->list      = list;
+	node->key       = NULL;
+	node->value     = NULL;
+	node->ref_count = 2;
+	node->height    = height;
+
+	for (i = 0; i < height; ++i)
+		node->next[i] = NULL;
+
+	return node;
+}
+
+static void
+pp_skip_list_node_free (PSkipListNode *node)
+{
+	PSkipList *list = node->list;
+
+	if (list->key_destroy != NULL)
+		list->key_destroy (node->key);
+
+	if (list->value_destroy != NULL)
+		list->value_destroy (node->value);
+
+	p_free (node);
+}
+
+static void
+pp_skip_list_node_unref (PSkipListNode *node)
+{
+	if (p_atomic_int_dec_and_test (&node->ref_count) == FALSE)
+		return;
+
+	if (P_UNLIKELY (p_epoch_domain_retire (node->list->domain,
+					       node,
+					       (PDestroyFunc) pp_skip_list_node_free) == FALSE)) {
+		/* Called outside of the critical sections, so waiting is fine */
+		p_epoch_domain_barrier (node->list->domain);
+		pp_skip_list_node_free (node);
+	}
+}
+
+/* Geometric distribution with p = 1/2 from the mixed bits of the seed, so the
+ * writers don't have to share a random state */
+static pint
+pp_skip_list_random_height (puint64 seed)
+{
+	puint64	hash;
+	pint	height;
+
+	hash  = seed;
+	hash ^= hash >> 33;
+	hash *= 0xFF51AFD7ED558CCDULL;
+	hash ^= hash >> 33;
+	hash *= 0xC4CEB9FE1A85EC53ULL;
+	hash ^= hash >> 33;
+
+	for (height = 1; height < P_SKIP_LIST_MAX_LEVEL && (hash & 1) != 0; ++height)
+		hash >>= 1;
+
+	return height;
+}
+
+/* Fills the predecessors and the successors of a key at every level, and
+ * unlinks the marked nodes on the way. Returns TRUE if succs[0] holds the key. */
+static pboolean
+pp_skip_list_find (PSkipList		*list,
+		   pconstpointer	key,
+		   PSkipListNode	**preds,
+		   PSkipListNode	**succs)
+{
+	PSkipListNode	*pred;
+	PSkipListNode	*curr;
+	PSkipListNode	*succ;
+	pint		level;
+
+retry:
+	pred = list->head;
+
+	for (level = P_SKIP_LIST_MAX_LEVEL - 1; level >= 0; --level) {
+		curr = P_SKIP_LIST_UNMARK (p_atomic_pointer_get (&pred->next[level]));
+
+		while (curr != NULL) {
+			succ = (PSkipListNode *) p_atomic_pointer_get (&curr->next[level]);
+
+			if (P_SKIP_LIST_IS_MARKED (succ)) {
+				/* Fails if the predecessor has changed or was removed */
+				if (p_atomic_pointer_compare_and_exchange (&pred->next[level],
+									   curr,
+									   P_SKIP_LIST_UNMARK (succ)) == FALSE)
+					goto retry;
+
+				curr = P_SKIP_LIST_UNMARK (succ);
+				continue;
+			}
+
+			if (list->func (curr->key, key, list->data) >= 0)
+				break;
+
+			pred = curr;
+			curr = succ;
+		}
+
+		preds[level] = pred;
+		succs[level] = curr;
+	}
+
+	return succs[0] != NULL && list->func (succs[0]->key, key, list->data) == 0;
+}
+
+/* Finds the first live node not less than a key without changing the list */
+static PSkipListNode *
+pp_skip_list_lower_bound (PSkipList		*list,
+			  pconstpointer		key)
+{
+	PSkipListNode	*pred;
+	PSkipListNode	*curr;
+	PSkipListNode	*succ;
+	pint		level;
+
+	pred = list->head;
+	curr = NULL;
+
+	for (level = P_SKIP_LIST_MAX_LEVEL - 1; level >= 0; --level) {
+		curr = P_SKIP_LIST_UNMARK (p_atomic_pointer_get (&pred->next[level]));
+
+		while (curr != NULL) {
+			succ = (PSkipListNode *) p_atomic_pointer_get (&curr->next[level]);
+
+			if (P_SKIP_LIST_IS_MARKED (succ)) {
+				curr = P_SKIP_LIST_UNMARK (succ);
+				continue;
+			}
+
+			if (list->func (curr->key, key, list->data) >= 0)
+				break;
+
+			pred = curr;
+			curr = succ;
+		}
+	}
+
+	return curr;
+}
+
+P_LIB_API PSkipList *
+p_skip_list_new (PCompareDataFunc	func,
+		 ppointer		data)
+{
+	return p_skip_list_new_full (func, data, NULL, NULL);
+}
+
+P_LIB_API PSkipList *
+p_skip_list_new_full (PCompareDataFunc	func,
+		      ppointer		data,
+		      PDestroyFunc	key_destroy,
+		      PDestroyFunc	value_destroy)
+{
+	PSkipList *ret;
+
+	if (P_UNLIKELY (func == NULL))
+		return NULL;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PSkipList))) == NULL)) {
+		P_ERROR ("PSkipList::p_skip_list_new_full: failed(1) to allocate memory");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret->head = pp_skip_list_node_new (ret, P_SKIP_LIST_MAX_LEVEL)) == NULL)) {
+		P_ERROR ("PSkipList::p_skip_list_new_full: failed(2) to allocate memory");
+		p_free (ret);
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret->domain = p_epoch_domain_new ()) == NULL)) {
+		P_ERROR ("PSkipList::p_skip_list_new_full: failed to create reclamation domain");
+		p_free (ret->head);
+		p_free (ret);
+		return NULL;
+	}
+
+	ret->func          = func;
+	ret->data          = data;
+	ret->key_destroy   = key_destroy;
+	ret->value_destroy = value_destroy;
+
+	return ret;
+}
+
+P_LIB_API pboolean
+p_skip_list_insert (PSkipList	*list,
+		    ppointer	key,
+		    ppointer	value)
+{
+	PSkipListNode	*preds[P_SKIP_LIST_MAX_LEVEL];
+	PSkipListNode	*succs[P_SKIP_LIST_MAX_LEVEL];
+	PSkipListNode	*node;
+	PSkipListNode	*next;
+	pint		height;
+	pint		level;
+
+	if (P_UNLIKELY (list == NULL))
+		return FALSE;
+
+	/* The key and the current size are different enough between the calls */
+	height = pp_skip_list_random_height ((puint64) PPOINTER_TO_PSIZE (key) ^
+					     ((puint64) p_atomic_int_get (&list->count) << 32));
+
+	if (P_UNLIKELY ((node = pp_skip_list_node_new (list, height)) == NULL)) {
+		P_ERROR ("PSkipList::p_skip_list_insert: failed to allocate memory");
+		return FALSE;
+	}
+
+	node->key   = key;
+	node->value = value;
+
+	if (P_UNLIKELY (p_epoch_domain_enter (list->domain) == FALSE)) {
+		p_free (node);
+		return FALSE;
+	}
+
+	for (;;) {
+		if (pp_skip_list_find (list, key, preds, succs) == TRUE) {
+			p_epoch_domain_leave (list->domain);
+			p_free (node);
+			return FALSE;
+		}
+
+		for (level = 0; level < height; ++level)
+			node->next[level] = succs[level];
+
+		/* Linking the bottom level inserts the key */
+		if (p_atomic_pointer_compare_and_exchange (&preds[0]->next[0], succs[0], node) == TRUE)
+			break;
+	}
+
+	p_atomic_int_inc (&list->count);
+
+	for (level = 1; level < height; ++level) {
+		for (;;) {
+			next = (PSkipListNode *) p_atomic_pointer_get (&node->next[level]);
+
+			/* The node is being removed, stop linking it */
+			if (P_SKIP_LIST_IS_MARKED (next))
+				goto out;
+
+			if (next != succs[level] &&
+			    p_atomic_pointer_compare_and_exchange (&node->next[level], next, succs[level]) == FALSE)
+				continue;
+
+			if (p_atomic_pointer_compare_and_exchange (&preds[level]->next[level], succs[level], node) == TRUE)
+				break;
+
+			/* The neighbours have changed, find them again */
+			if (pp_skip_list_find (list, key, preds, succs) == FALSE || succs[0] != node)
+				goto out;
+		}
+	}
+
+out:
+	/* A remover might have unlinked the node before some of its levels were
+	 * linked, unlink them too */
+	if (P_SKIP_LIST_IS_MARKED (p_atomic_pointer_get (&node->next[0])))
+		pp_skip_list_find (list, key, preds, succs);
+
+	p_epoch_domain_leave (list->domain);
+
+	pp_skip_list_node_unref (node);
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_skip_list_remove (PSkipList		*list,
+		    pconstpointer	key)
+{
+	PSkipListNode	*preds[P_SKIP_LIST_MAX_LEVEL];
+	PSkipListNode	*succs[P_SKIP_LIST_MAX_LEVEL];
+	PSkipListNode	*node;
+	PSkipListNode	*next;
+	pint		level;
+
+	if (P_UNLIKELY (list == NULL))
+		return FALSE;
+
+	if (P_UNLIKELY (p_epoch_domain_enter (list->domain) == FALSE))
+		return FALSE;
+
+	if (pp_skip_list_find (list, key, preds, succs) == FALSE) {
+		p_epoch_domain_leave (list->domain);
+		return FALSE;
+	}
+
+	node = succs[0];
+
+	/* Mark the upper levels top down, then the bottom one */
+	for (level = node->height - 1; level > 0; --level) {
+		next = (PSkipListNode *) p_atomic_pointer_get (&node->next[level]);
+
+		while (!P_SKIP_LIST_IS_MARKED (next)) {
+			p_atomic_pointer_compare_and_exchange (&node->next[level], next, P_SKIP_LIST_MARK (next));
+			next = (PSkipListNode *) p_atomic_pointer_get (&node->next[level]);
+		}
+	}
+
+	for (;;) {
+		next = (PSkipListNode *) p_atomic_pointer_get (&node->next[0]);
+
+		/* Another thread has removed the node first */
+		if (P_SKIP_LIST_IS_MARKED (next)) {
+			p_epoch_domain_leave (list->domain);
+			return FALSE;
+		}
+
+		if (p_atomic_pointer_compare_and_exchange (&node->next[0], next, P_SKIP_LIST_MARK (next)) == TRUE)
+			break;
+	}
+
+	p_atomic_int_add (&list->count, -1);
+
+	/* Unlink the node from all the levels */
+	pp_skip_list_find (list, key, preds, succs);
+
+	p_epoch_domain_leave (list->domain);
+
+	pp_skip_list_node_unref (node);
+
+	return TRUE;
+}
+
+P_LIB_API ppointer
+p_skip_list_lookup (PSkipList		*list,
+		    pconstpointer	key)
+{
+	PSkipListNode	*node;
+	ppointer	ret;
+
+	if (P_UNLIKELY (list == NULL))
+		return (ppointer) -1;
+
+	if (P_UNLIKELY (p_epoch_domain_enter (list->domain) == FALSE))
+		return (ppointer) -1;
+
+	node = pp_skip_list_lower_bound (list, key);
+
+	if (node != NULL && list->func (node->key, key, list->data) == 0)
+		ret = node->value;
+	else
+		ret = (ppointer) -1;
+
+	p_epoch_domain_leave (list->domain);
+
+	return ret;
+}
+
+P_LIB_API void
+p_skip_list_foreach (PSkipList		*list,
+		     PTraverseFunc	traverse_func,
+		     ppointer		user_data)
+{
+	PSkipListNode	*node;
+	PSkipListNode	*next;
+
+	if (P_UNLIKELY (list == NULL || traverse_func == NULL))
+		return;
+
+	if (P_UNLIKELY (p_epoch_domain_enter (list->domain) == FALSE))
+		return;
+
+	for (node = (PSkipListNode *) p_atomic_pointer_get (&list->head->next[0]); node != NULL; node = P_SKIP_LIST_UNMARK (next)) {
+		next = (PSkipListNode *) p_atomic_pointer_get (&node->next[0]);
+
+		if (P_SKIP_LIST_IS_MARKED (next))
+			continue;
+
+		if (traverse_func (node->key, node->value, user_data) == TRUE)
+			break;
+	}
+
+	p_epoch_domain_leave (list->domain);
+}
+
+P_LIB_API void
+p_skip_list_foreach_range (PSkipList		*list,
+			   pconstpointer	from,
+			   pconstpointer	to,
+			   PTraverseFunc	traverse_func,
+			   ppointer		user_data)
+{
+	PSkipListNode	*node;
+	PSkipListNode	*next;
+
+	if (P_UNLIKELY (list == NULL || traverse_func == NULL))
+		return;
+
+	if (P_UNLIKELY (p_epoch_domain_enter (list->domain) == FALSE))
+		return;
+
+	for (node = pp_skip_list_lower_bound (list, from); node != NULL; node = P_SKIP_LIST_UNMARK (next)) {
+		next = (PSkipListNode *) p_atomic_pointer_get (&node->next[0]);
+
+		if (P_SKIP_LIST_IS_MARKED (next))
+			continue;
+
+		if (list->func (node->key, to, list->data) >= 0)
+			break;
+
+		if (traverse_func (node->key, node->value, user_data) == TRUE)
+			break;
+	}
+
+	p_epoch_domain_leave (list->domain);
+}
+
+P_LIB_API psize
+p_skip_list_get_count (PSkipList *list)
+{
+	pint count;
+
+	if (P_UNLIKELY (list == NULL))
+		return 0;
+
+	count = p_atomic_int_get (&list->count);
+
+	return count > 0 ? (psize) count : 0;
+}
+
+P_LIB_API void
+p_skip_list_free (PSkipList *list)
+{
+	PSkipListNode	*node;
+	PSkipListNode	*next;
+
+	if (P_UNLIKELY (list == NULL))
+		return;
+
+	/* Frees the removed nodes, they are not reachable from the head anymore */
+	p_epoch_domain_free (list->domain);
+
+	for (node = list->head->next[0]; node != NULL; node = next) {
+		next = P_SKIP_LIST_UNMARK (node->next[0]);
+		pp_skip_list_node_free (node);
+	}
+
+	p_free (list->head);
+	p_free (list);
+}
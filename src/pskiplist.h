@@ -0,0 +1,201 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pskiplist.h
+ * @brief Lock-free concurrent skip list
+ * @author Alexander Saprykin
+ *
+ * A skip list is an ordered map built of several levels of sorted linked
+ * lists: every node is in the bottom list, and each next level holds about a
+ * half of the nodes of the level below, so a search skips most of the nodes
+ * going down from the top level. Lookup, insertion and removal take O(logN)
+ * expected time.
+ *
+ * #PSkipList is lock-free: any number of threads may look up, insert, remove
+ * and iterate at the same time, and none of them waits for another one.
+ * Unlike #PConcurrentTree, the writers are not serialized, they only contend
+ * when they change the neighbouring nodes. A node is removed by marking its
+ * links first (the lowest bit of the next pointers), which makes it logically
+ * deleted, and the marked node is then unlinked by any thread passing through
+ * it.
+ *
+ * A removed node may still be read by the threads which have just loaded it,
+ * so it is freed through a #PEpochDomain owned by the list: every operation
+ * runs in a critical section of the domain, and the node (along with its key
+ * and value, if the destroy functions are given) is freed after all the
+ * threads have left the sections they were in. The list takes a static TLS
+ * key for the domain, so it is meant to be a long-living object.
+ *
+ * A key can be inserted only once, the value of an existing key is never
+ * replaced: remove the key and insert it again instead. Iteration walks the
+ * bottom level in the key order and sees a consistent node at every step, but
+ * not a snapshot of the whole list: the keys inserted or removed concurrently
+ * may be seen or not.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PSKIPLIST_H
+#define PLIBSYS_HEADER_PSKIPLIST_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+
+P_BEGIN_DECLS
+
+/** Lock-free skip list opaque data type. */
+typedef struct PSkipList_ PSkipList;
+
+/**
+ * @brief Creates a new skip list.
+ * @param func Key compare function.
+ * @param data Data to be passed to @a func along with the keys.
+ * @return Pointer to #PSkipList in case of success, NULL otherwise.
+ * @since 0.0.5
+ *
+ * @a func may be called concurrently from several threads.
+ */
+P_LIB_API PSkipList *	p_skip_list_new			(PCompareDataFunc	func,
+							 ppointer		data);
+
+/**
+ * @brief Creates a new skip list with the destroy functions.
+ * @param func Key compare function.
+ * @param data Data to be passed to @a func along with the keys.
+ * @param key_destroy Function to call for a key when its node is freed, may
+ * be NULL.
+ * @param value_destroy Function to call for a value when its node is freed,
+ * may be NULL.
+ * @return Pointer to #PSkipList in case of success, NULL otherwise.
+ * @since 0.0.5
+ *
+ * The destroy functions are called once no thread can access the removed
+ * node anymore, or from p_skip_list_free().
+ */
+P_LIB_API PSkipList *	p_skip_list_new_full		(PCompareDataFunc	func,
+							 ppointer		data,
+							 PDestroyFunc		key_destroy,
+							 PDestroyFunc		value_destroy);
+
+/**
+ * @brief Inserts a key-value pair into a skip list.
+ * @param list Initialized skip list.
+ * @param key Key to insert.
+ * @param value Value to insert.
+ * @return TRUE if the pair was inserted, FALSE if the key already exists or
+ * in case of error.
+ * @since 0.0.5
+ *
+ * The key and the value are not destroyed if the call fails.
+ */
+P_LIB_API pboolean	p_skip_list_insert		(PSkipList		*list,
+							 ppointer		key,
+							 ppointer		value);
+
+/**
+ * @brief Removes a key from a skip list.
+ * @param list Initialized skip list.
+ * @param key Key to remove.
+ * @return TRUE if the key was removed, FALSE if it was not found.
+ * @since 0.0.5
+ *
+ * If several threads remove the same key, only one of them succeeds.
+ */
+P_LIB_API pboolean	p_skip_list_remove		(PSkipList		*list,
+							 pconstpointer		key);
+
+/**
+ * @brief Searches for a key in a skip list.
+ * @param list Initialized skip list.
+ * @param key Key to lookup for.
+ * @return Value related to the @a key (can be NULL), (#ppointer) -1 if no
+ * value was found.
+ * @since 0.0.5
+ *
+ * The lookup never writes to the list nodes.
+ */
+P_LIB_API ppointer	p_skip_list_lookup		(PSkipList		*list,
+							 pconstpointer		key);
+
+/**
+ * @brief Iterates through all the key-value pairs of a skip list in the key
+ * order.
+ * @param list Initialized skip list.
+ * @param traverse_func Function to call for each pair.
+ * @param user_data Data to pass into @a traverse_func, may be NULL.
+ * @since 0.0.5
+ *
+ * @a traverse_func returns TRUE to stop the iteration. It may insert and
+ * remove the keys, but must not free the list.
+ */
+P_LIB_API void		p_skip_list_foreach		(PSkipList		*list,
+							 PTraverseFunc		traverse_func,
+							 ppointer		user_data);
+
+/**
+ * @brief Iterates through the key-value pairs of a skip list in a key range.
+ * @param list Initialized skip list.
+ * @param from Lower bound of the range, inclusive.
+ * @param to Upper bound of the range, exclusive.
+ * @param traverse_func Function to call for each pair.
+ * @param user_data Data to pass into @a traverse_func, may be NULL.
+ * @since 0.0.5
+ *
+ * The pairs are passed in the key order, @a traverse_func returns TRUE to stop
+ * the iteration.
+ */
+P_LIB_API void		p_skip_list_foreach_range	(PSkipList		*list,
+							 pconstpointer		from,
+							 pconstpointer		to,
+							 PTraverseFunc		traverse_func,
+							 ppointer		user_data);
+
+/**
+ * @brief Gets the number of key-value pairs in a skip list.
+ * @param list Initialized skip list.
+ * @return Number of pairs.
+ * @since 0.0.5
+ *
+ * The number is exact only when no other thread changes the list.
+ */
+P_LIB_API psize		p_skip_list_get_count		(PSkipList		*list);
+
+/**
+ * @brief Frees a skip list.
+ * @param list Skip list to free.
+ * @since 0.0.5
+ *
+ * The list must not be accessed by other threads at the moment of the call.
+ * The destroy functions are called for all the remaining and the removed
+ * pairs.
+ */
+P_LIB_API void		p_skip_list_free		(PSkipList		*list);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PSKIPLIST_H */
@@ -24,11 +24,12 @@
  * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include "patomic.h"
 #include "pmem.h"
+#include "pmempool.h"
 #include "psocket.h"
-#ifdef P_OS_SCO
-#  include "ptimeprofiler.h"
-#endif
+#include "psocketpoller.h"
+#include "ptimeprofiler.h"
 #include "perror-private.h"
 #include "plibsys-private.h"
 #include "psysclose-private.h"
@@ -41,11 +42,45 @@
 #  include <errno.h>
 #  include <unistd.h>
 #  include <signal.h>
+#  include <netinet/tcp.h>
 #  ifdef P_OS_VMS
 #    include <stropts.h>
 #  endif
 #endif
 
+#ifdef P_OS_WIN
+#  include <mswsock.h>
+#else
+#  include <sys/stat.h>
+#endif
+
+#if defined (P_OS_LINUX)
+#  define P_SOCKET_SENDFILE_LINUX
+#  include <sys/sendfile.h>
+#elif defined (P_OS_FREEBSD) || defined (P_OS_DRAGONFLY)
+#  define P_SOCKET_SENDFILE_BSD
+#  include <sys/uio.h>
+#elif defined (P_OS_MAC)
+#  define P_SOCKET_SENDFILE_DARWIN
+#  include <sys/uio.h>
+#elif defined (P_OS_WIN)
+#  define P_SOCKET_SENDFILE_WIN
+#else
+#  define P_SOCKET_SENDFILE_NONE
+#endif
+
+#ifdef P_OS_WIN
+typedef HANDLE PSocketFileHandle;
+#else
+typedef pint PSocketFileHandle;
+#endif
+
+/* Maximum number of bytes passed to a single native file sending call */
+#define P_SOCKET_SEND_FILE_CHUNK_SIZE	0x40000000
+
+/* Size of the buffer used to send a file without native support */
+#define P_SOCKET_SEND_FILE_BUFFER_SIZE	(64 * 1024)
+
 #ifndef P_OS_WIN
 #  if defined (P_OS_BEOS) || defined (P_OS_MAC) || defined (P_OS_MAC9) || \
       defined (P_OS_OS2)  || defined (P_OS_AMIGA)
@@ -58,6 +93,77 @@
 #  endif
 #endif
 
+#if defined (P_OS_WIN)
+#  define P_SOCKET_VECTOR_WSA
+typedef WSABUF PSocketNativeVector;
+#elif defined (PLIBSYS_HAS_SENDMSG)
+#  define P_SOCKET_VECTOR_MSG
+#  include <sys/uio.h>
+#  include <limits.h>
+typedef struct iovec PSocketNativeVector;
+#else
+#  define P_SOCKET_VECTOR_COPY
+#endif
+
+/* Maximum number of buffer descriptors for a single scatter/gather call */
+#if defined (P_SOCKET_VECTOR_MSG) && defined (IOV_MAX)
+#  define P_SOCKET_VECTOR_MAX		IOV_MAX
+#else
+#  define P_SOCKET_VECTOR_MAX		1024
+#endif
+
+/* Number of native buffer descriptors which are kept on the stack */
+#define P_SOCKET_VECTOR_STACK_SIZE	16
+
+#ifdef PLIBSYS_HAS_MMSG
+#  include <sys/uio.h>
+/* Number of datagrams passed to a single recvmmsg() or sendmmsg() call */
+#  define P_SOCKET_MMSG_BATCH_SIZE	32
+#endif
+
+#ifdef PLIBSYS_HAS_UDP_GSO
+#  include <sys/uio.h>
+#  include <netinet/udp.h>
+/* Kernel limit of datagrams in a single UDP_SEGMENT send */
+#  define P_SOCKET_GSO_MAX_SEGMENTS	64
+#endif
+
+#ifdef PLIBSYS_HAS_SCM_RIGHTS
+#  include <sys/uio.h>
+/* Control data buffer for the passed descriptors, aligned for the headers */
+typedef union PSocketFdsControl_ {
+	struct cmsghdr	header;
+	pchar		buf[CMSG_SPACE (sizeof (pint) * P_SOCKET_MAX_FDS)];
+} PSocketFdsControl;
+#endif
+
+#if defined (PLIBSYS_HAS_SO_TIMESTAMPING)
+#  define P_SOCKET_TIMESTAMP_MSG
+#  include <sys/uio.h>
+#  include <time.h>
+#  include <linux/net_tstamp.h>
+#  include <linux/errqueue.h>
+#elif defined (PLIBSYS_HAS_SO_TIMESTAMP)
+#  define P_SOCKET_TIMESTAMP_MSG
+#  include <sys/uio.h>
+#  include <sys/time.h>
+#endif
+
+#ifdef P_SOCKET_TIMESTAMP_MSG
+/* Control data buffer for the timestamps and the other headers which may
+ * be enabled along with them, aligned for the headers */
+typedef union PSocketTimestampControl_ {
+	struct cmsghdr	header;
+	pchar		buf[512];
+} PSocketTimestampControl;
+#endif
+
+/* Delay between the connection attempts recommended by RFC 8305 */
+#define P_SOCKET_CONNECT_ANY_DELAY	250
+
+/* Number of the finished connection attempts to handle at once */
+#define P_SOCKET_CONNECT_ANY_EVENTS	8
+
 /* On old Solaris systems SOMAXCONN is set to 5 */
 #define P_SOCKET_DEFAULT_BACKLOG	5
 
@@ -68,11 +174,17 @@ struct PSocket_ {
 	pint		fd;
 	pint		listen_backlog;
 	pint		timeout;
+	PDeadline	deadline;
+	puint		has_deadline	: 1;
 	puint		blocking	: 1;
 	puint		keepalive	: 1;
 	puint		closed		: 1;
 	puint		connected	: 1;
 	puint		listening	: 1;
+	puint		silent_block	: 1;
+	PSocketStats	*stats;
+	PTimeProfiler	*stats_timer;
+	pint		pool_gen;
 #ifdef P_OS_WIN
 	WSAEVENT	events;
 #endif
@@ -81,6 +193,13 @@ struct PSocket_ {
 #endif
 };
 
+/* Servers create and free a socket for every accepted connection, so the
+ * objects are recycled through a pool instead of the general allocator */
+static PMemPool * volatile pp_socket_pool = NULL;
+
+/* Generation of the current pool, bumped when the pool is retired */
+static volatile pint pp_socket_pool_gen = 0;
+
 #ifndef SHUT_RD
 #  define SHUT_RD			0
 #endif
@@ -99,9 +218,51 @@ struct PSocket_ {
 #  define P_SOCKET_DEFAULT_SEND_FLAGS	0
 #endif
 
+static PSocket * pp_socket_alloc (void);
+static void pp_socket_release (PSocket *socket);
 static pboolean pp_socket_set_fd_blocking (pint fd, pboolean blocking, PError **error);
 static pboolean pp_socket_check (const PSocket *socket, PError **error);
 static pboolean pp_socket_set_details_from_fd (PSocket *socket, PError **error);
+static void pp_socket_stats_update (const PSocket *socket, pboolean is_send, pssize bytes, psize packets, pint err_code);
+static void pp_socket_set_error (const PSocket *socket, PError **error, PErrorIO sock_err, pint err_code, const pchar *message);
+static pboolean pp_socket_check_vectors (const PSocketVector *vectors, psize n_vectors, psize *total, PError **error);
+#ifndef P_SOCKET_VECTOR_COPY
+static PSocketNativeVector * pp_socket_vectors_to_native (const PSocketVector *vectors, psize n_vectors,
+							   PSocketNativeVector *stack_vec, psize *n_native, PError **error);
+#endif
+static pssize pp_socket_send_vector (const PSocket *socket, struct sockaddr_storage *sa, socklen_t optlen,
+				     const PSocketVector *vectors, psize n_vectors, PError **error);
+static pssize pp_socket_receive_vector (const PSocket *socket, PSocketAddress **address,
+					const PSocketVector *vectors, psize n_vectors, PError **error);
+static pboolean pp_socket_check_messages (PSocketMessage *messages, psize n_messages, pboolean is_send, PError **error);
+static pssize pp_socket_receive_many_once (const PSocket *socket, PSocketMessage *messages, psize n_messages, pint *err_code);
+static pssize pp_socket_send_many_once (const PSocket *socket, PSocketMessage *messages, psize n_messages, pint *err_code);
+#ifndef P_SOCKET_SENDFILE_NONE
+static pssize pp_socket_send_file_native (const PSocket *socket, PSocketFileHandle file,
+					  puint64 offset, psize length, pint *err_code);
+static pboolean pp_socket_send_file_is_unsupported (pint err_code);
+#endif
+static pssize pp_socket_send_file_copy (const PSocket *socket, PSocketFileHandle file,
+					puint64 offset, psize length, PError **error);
+static pssize pp_socket_send_file (const PSocket *socket, PSocketFileHandle file,
+				   puint64 offset, psize length, PError **error);
+static pboolean pp_socket_option_to_native (const PSocket *socket, PSocketOption option, pint *level, pint *optname);
+static pint pp_socket_accept_fd (const PSocket *socket, pboolean *nonblocking, pint *err_code);
+static PSocket * pp_socket_new_accepted (const PSocket *socket, pint fd, pboolean nonblocking, PError **error);
+static void pp_socket_connect_any_order (PSocketAddress **addresses, psize n_addresses, psize *order);
+static PSocket * pp_socket_connect_any_start (PSocketAddress *address, pboolean *pending, PError **error);
+static pint pp_socket_get_wait_timeout (const PSocket *socket);
+static pboolean pp_socket_io_condition_wait (const PSocket *socket, PSocketIOCondition condition, PError **error);
+static pssize pp_socket_receive_from_native (const PSocket *socket, struct sockaddr_storage *sa, socklen_t *optlen, pchar *buffer, psize buflen, PError **error);
+static void pp_socket_timestamps_finish (PSocketTimestamps *timestamps);
+#ifdef P_SOCKET_TIMESTAMP_MSG
+static void pp_socket_timestamps_from_control (struct msghdr *msg, PSocketTimestamps *timestamps);
+#endif
+#ifdef PLIBSYS_HAS_UDP_GSO
+static pssize pp_socket_send_gso_once (const PSocket *socket, struct sockaddr_storage *sa, socklen_t optlen,
+				       const pchar *buffer, psize buflen, psize segment_size, pint *err_code);
+static pboolean pp_socket_gso_is_unsupported (pint err_code);
+#endif
 
 static pboolean
 pp_socket_set_fd_blocking (pint		fd,
@@ -246,6 +407,9 @@ pp_socket_set_details_from_fd (PSocket	*socket,
 					     "Failed to call getsockopt() to get socket SO_DOMAIN option");
 			return FALSE;
 		}
+
+		/* Unnamed local sockets may have an empty address */
+		address.ss_family = family;
 	}
 #endif
 
@@ -257,6 +421,11 @@ pp_socket_set_details_from_fd (PSocket	*socket,
 	case P_SOCKET_FAMILY_INET6:
 		socket->family = P_SOCKET_FAMILY_INET6;
 		break;
+#endif
+#ifdef AF_UNIX
+	case P_SOCKET_FAMILY_UNIX:
+		socket->family = P_SOCKET_FAMILY_UNIX;
+		break;
 #endif
 	default:
 		socket->family = P_SOCKET_FAMILY_UNKNOWN;
@@ -340,754 +509,3355 @@ p_socket_close_once (void)
 #endif
 }
 
-P_LIB_API PSocket *
-p_socket_new_from_fd (pint	fd,
-		      PError	**error)
+/* Called before the threading shutdown, the pool needs a TLS key */
+void
+p_socket_cache_shutdown (void)
 {
-	PSocket	*ret;
-#if !defined (P_OS_WIN) && defined (SO_NOSIGPIPE)
-	pint	flags;
-#endif
+	if (pp_socket_pool == NULL)
+		return;
 
-	if (P_UNLIKELY (fd < 0)) {
-		p_error_set_error_p (error,
-				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
-				     0,
-				     "Unable to create socket from bad fd");
-		return NULL;
-	}
+	/* Sockets still alive keep using the pool memory, so it is retired
+	 * instead: they can be closed and freed, but the memory is not reclaimed */
+	if (p_mem_pool_get_used_count (pp_socket_pool) == 0)
+		p_mem_pool_free (pp_socket_pool);
 
-	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PSocket))) == NULL)) {
-		p_error_set_error_p (error,
-				     (pint) P_ERROR_IO_NO_RESOURCES,
-				     0,
-				     "Failed to allocate memory for socket");
-		return NULL;
-	}
+	pp_socket_pool = NULL;
+	p_atomic_int_inc (&pp_socket_pool_gen);
+}
 
-	ret->fd = fd;
+static PSocket *
+pp_socket_alloc (void)
+{
+	PMemPool	*pool = p_atomic_pointer_get (&pp_socket_pool);
+	PSocket		*socket;
 
-	if (P_UNLIKELY (pp_socket_set_details_from_fd (ret, error) == FALSE)) {
-		p_free (ret);
-		return NULL;
+	/* Created on the first use, a failed creation is retried next time */
+	if (P_UNLIKELY (pool == NULL)) {
+		if (P_UNLIKELY ((pool = p_mem_pool_new (sizeof (PSocket))) == NULL))
+			return NULL;
+
+		if (p_atomic_pointer_compare_and_exchange (&pp_socket_pool, NULL, pool) == FALSE) {
+			p_mem_pool_free (pool);
+			pool = p_atomic_pointer_get (&pp_socket_pool);
+		}
 	}
 
-	if (P_UNLIKELY (pp_socket_set_fd_blocking (ret->fd, FALSE, error) == FALSE)) {
-		p_free (ret);
+	if (P_UNLIKELY ((socket = p_mem_pool_alloc0 (pool)) == NULL))
 		return NULL;
-	}
 
-#if !defined (P_OS_WIN) && defined (SO_NOSIGPIPE)
-	flags = 1;
+	socket->pool_gen = p_atomic_int_get (&pp_socket_pool_gen);
 
-	if (setsockopt (ret->fd, SOL_SOCKET, SO_NOSIGPIPE, &flags, sizeof (flags)) < 0)
-		P_WARNING ("PSocket::p_socket_new_from_fd: setsockopt() with SO_NOSIGPIPE failed");
-#endif
+	return socket;
+}
 
-	p_socket_set_listen_backlog (ret, P_SOCKET_DEFAULT_BACKLOG);
+static void
+pp_socket_release (PSocket *socket)
+{
+	/* Sockets of a retired pool stay valid until the process exits */
+	if (P_UNLIKELY (socket->pool_gen != p_atomic_int_get (&pp_socket_pool_gen)))
+		return;
 
-	ret->timeout  = 0;
-	ret->blocking = TRUE;
+	p_mem_pool_release (pp_socket_pool, socket);
+}
 
-#ifdef P_OS_SCO
-	if (P_UNLIKELY ((ret->timer = p_time_profiler_new ()) == NULL)) {
-		p_error_set_error_p (error,
-				     (pint) P_ERROR_IO_NO_RESOURCES,
-				     0,
-				     "Failed to allocate memory for internal timer");
-		p_free (ret);
-		return NULL;
-	}
-#endif
+/* Reports a failed call, the would-block case is skipped in the silent mode */
+static void
+pp_socket_set_error (const PSocket	*socket,
+		     PError		**error,
+		     PErrorIO		sock_err,
+		     pint		err_code,
+		     const pchar	*message)
+{
+	if (sock_err == P_ERROR_IO_WOULD_BLOCK && socket->silent_block)
+		return;
 
-#ifdef P_OS_WIN
-	if (P_UNLIKELY ((ret->events = WSACreateEvent ()) == WSA_INVALID_EVENT)) {
-		p_error_set_error_p (error,
-				     (pint) P_ERROR_IO_FAILED,
-				     (pint) p_error_get_last_net (),
-				     "Failed to call WSACreateEvent() on socket");
-		p_free (ret);
-		return NULL;
+	p_error_set_error_static_p (error, (pint) sock_err, err_code, message);
+}
+
+/* Accounts a data transfer call, negative bytes mean a failed one */
+static void
+pp_socket_stats_update (const PSocket	*socket,
+			pboolean	is_send,
+			pssize		bytes,
+			psize		packets,
+			pint		err_code)
+{
+	PSocketStats *stats = socket->stats;
+
+	++stats->syscalls;
+
+	if (bytes < 0) {
+		if (p_error_get_io_from_system (err_code) == P_ERROR_IO_WOULD_BLOCK)
+			++stats->would_block;
+
+		return;
 	}
-#endif
 
-	return ret;
+	/* Nothing has been transferred, i.e. the peer has closed the connection */
+	if (bytes == 0)
+		return;
+
+	if (is_send) {
+		stats->bytes_sent   += (puint64) bytes;
+		stats->packets_sent += (puint64) packets;
+	} else {
+		stats->bytes_received   += (puint64) bytes;
+		stats->packets_received += (puint64) packets;
+	}
 }
 
-P_LIB_API PSocket *
-p_socket_new (PSocketFamily	family,
-	      PSocketType	type,
-	      PSocketProtocol	protocol,
-	      PError		**error)
+static pboolean
+pp_socket_check_vectors (const PSocketVector	*vectors,
+			 psize			n_vectors,
+			 psize			*total,
+			 PError			**error)
 {
-	PSocket	*ret;
-	pint	native_type, fd;
-#ifndef P_OS_WIN
-	pint	flags;
-#endif
+	psize i;
 
-	if (P_UNLIKELY (family   == P_SOCKET_FAMILY_UNKNOWN ||
-			type     == P_SOCKET_TYPE_UNKNOWN   ||
-			protocol == P_SOCKET_PROTOCOL_UNKNOWN)) {
+	*total = 0;
+
+	if (P_UNLIKELY (vectors == NULL || n_vectors == 0 || n_vectors > P_SOCKET_VECTOR_MAX)) {
 		p_error_set_error_p (error,
 				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
 				     0,
-				     "Invalid input socket family, type or protocol");
-		return NULL;
+				     "Invalid input argument");
+		return FALSE;
 	}
 
-	switch (type) {
-	case P_SOCKET_TYPE_STREAM:
-		native_type = SOCK_STREAM;
-		break;
-
-	case P_SOCKET_TYPE_DATAGRAM:
-		native_type = SOCK_DGRAM;
-		break;
-
-#ifdef SOCK_SEQPACKET
-	case P_SOCKET_TYPE_SEQPACKET:
-		native_type = SOCK_SEQPACKET;
-		break;
+	for (i = 0; i < n_vectors; ++i) {
+		if (P_UNLIKELY ((vectors[i].buffer == NULL && vectors[i].buflen > 0) ||
+				vectors[i].buflen > (psize) P_MAXSSIZE - *total
+#ifdef P_SOCKET_VECTOR_WSA
+				|| vectors[i].buflen > (psize) P_MAXUINT32
 #endif
+				)) {
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+					     0,
+					     "Invalid buffer descriptor");
+			return FALSE;
+		}
 
-	default:
+		*total += vectors[i].buflen;
+	}
+
+	if (P_UNLIKELY (*total == 0)) {
 		p_error_set_error_p (error,
 				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
 				     0,
-				     "Unable to create socket with unknown family");
-		return NULL;
+				     "Invalid input argument");
+		return FALSE;
 	}
 
-	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PSocket))) == NULL)) {
+	return TRUE;
+}
+
+#ifndef P_SOCKET_VECTOR_COPY
+static PSocketNativeVector *
+pp_socket_vectors_to_native (const PSocketVector	*vectors,
+			     psize			n_vectors,
+			     PSocketNativeVector	*stack_vec,
+			     psize			*n_native,
+			     PError			**error)
+{
+	PSocketNativeVector	*native_vec;
+	psize			i;
+
+	if (n_vectors <= P_SOCKET_VECTOR_STACK_SIZE)
+		native_vec = stack_vec;
+	else if (P_UNLIKELY ((native_vec = p_malloc (n_vectors * sizeof (PSocketNativeVector))) == NULL)) {
 		p_error_set_error_p (error,
 				     (pint) P_ERROR_IO_NO_RESOURCES,
 				     0,
-				     "Failed to allocate memory for socket");
+				     "Failed to allocate memory for buffer descriptors");
 		return NULL;
 	}
 
-#ifdef P_OS_SCO
-	if (P_UNLIKELY ((ret->timer = p_time_profiler_new ()) == NULL)) {
-		p_error_set_error_p (error,
-				     (pint) P_ERROR_IO_NO_RESOURCES,
-				     0,
-				     "Failed to allocate memory for internal timer");
-		p_free (ret);
-		return NULL;
+	*n_native = 0;
+
+	/* Empty descriptors are skipped */
+	for (i = 0; i < n_vectors; ++i) {
+		if (vectors[i].buflen == 0)
+			continue;
+
+#  ifdef P_SOCKET_VECTOR_WSA
+		native_vec[*n_native].buf = (CHAR *) vectors[i].buffer;
+		native_vec[*n_native].len = (ULONG) vectors[i].buflen;
+#  else
+		native_vec[*n_native].iov_base = (void *) vectors[i].buffer;
+		native_vec[*n_native].iov_len  = (size_t) vectors[i].buflen;
+#  endif
+		++(*n_native);
 	}
+
+	return native_vec;
+}
 #endif
 
-#ifdef SOCK_CLOEXEC
-	native_type |= SOCK_CLOEXEC;
+static pssize
+pp_socket_send_vector (const PSocket		*socket,
+		       struct sockaddr_storage	*sa,
+		       socklen_t		optlen,
+		       const PSocketVector	*vectors,
+		       psize			n_vectors,
+		       PError			**error)
+{
+	PErrorIO		sock_err;
+	psize			total;
+	pssize			ret;
+	pint			err_code;
+#ifdef P_SOCKET_VECTOR_COPY
+	pchar			*data;
+	psize			i;
+	psize			offset;
+#else
+	PSocketNativeVector	stack_vec[P_SOCKET_VECTOR_STACK_SIZE];
+	PSocketNativeVector	*native_vec;
+	psize			n_native;
 #endif
-	if (P_UNLIKELY ((fd = (pint) socket (family, native_type, protocol)) < 0)) {
-		p_error_set_error_p (error,
-				     (pint) p_error_get_io_from_system (p_error_get_last_net ()),
-				     (pint) p_error_get_last_net (),
-				     "Failed to call socket() to create socket");
-#ifdef P_OS_SCO
-		p_time_profiler_free (ret->timer);
+#ifdef P_SOCKET_VECTOR_WSA
+	DWORD			sent;
+#endif
+#ifdef P_SOCKET_VECTOR_MSG
+	struct msghdr		msg;
 #endif
-		p_free (ret);
-		return NULL;
-	}
 
-#ifndef P_OS_WIN
-	flags = fcntl (fd, F_GETFD, 0);
+	if (P_UNLIKELY (pp_socket_check_vectors (vectors, n_vectors, &total, error) == FALSE))
+		return -1;
 
-	if (P_LIKELY (flags != -1 && (flags & FD_CLOEXEC) == 0)) {
-		flags |= FD_CLOEXEC;
+	if (P_UNLIKELY (pp_socket_check (socket, error) == FALSE))
+		return -1;
 
-		if (P_UNLIKELY (fcntl (fd, F_SETFD, flags) < 0))
-			P_WARNING ("PSocket::p_socket_new: fcntl() with FD_CLOEXEC failed");
+#ifdef P_SOCKET_VECTOR_COPY
+	if (P_UNLIKELY ((data = p_malloc (total)) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for data buffer");
+		return -1;
 	}
-#endif
 
-	ret->fd = fd;
-
-#ifdef P_OS_WIN
-	ret->events = WSA_INVALID_EVENT;
-#endif
+	for (i = 0, offset = 0; i < n_vectors; ++i) {
+		if (vectors[i].buflen == 0)
+			continue;
 
-	if (P_UNLIKELY (pp_socket_set_fd_blocking (ret->fd, FALSE, error) == FALSE)) {
-		p_socket_free (ret);
-		return NULL;
+		memcpy (data + offset, vectors[i].buffer, vectors[i].buflen);
+		offset += vectors[i].buflen;
 	}
+#else
+	if (P_UNLIKELY ((native_vec = pp_socket_vectors_to_native (vectors,
+								   n_vectors,
+								   stack_vec,
+								   &n_native,
+								   error)) == NULL))
+		return -1;
+#endif
 
-#if !defined (P_OS_WIN) && defined (SO_NOSIGPIPE)
-	flags = 1;
+#ifdef P_SOCKET_VECTOR_MSG
+	memset (&msg, 0, sizeof (msg));
 
-	if (setsockopt (ret->fd, SOL_SOCKET, SO_NOSIGPIPE, &flags, sizeof (flags)) < 0)
-		P_WARNING ("PSocket::p_socket_new: setsockopt() with SO_NOSIGPIPE failed");
+	msg.msg_name    = (void *) sa;
+	msg.msg_namelen = sa != NULL ? optlen : 0;
+	msg.msg_iov     = native_vec;
+	msg.msg_iovlen  = (int) n_native;
 #endif
 
-	ret->timeout  = 0;
-	ret->blocking = TRUE;
-	ret->family   = family;
-	ret->protocol = protocol;
-	ret->type     = type;
-
-	p_socket_set_listen_backlog (ret, P_SOCKET_DEFAULT_BACKLOG);
+	for (;;) {
+		if (socket->blocking &&
+		    p_socket_io_condition_wait (socket,
+						P_SOCKET_IO_CONDITION_POLLOUT,
+						error) == FALSE) {
+			ret = -1;
+			break;
+		}
 
-#ifdef P_OS_WIN
-	if (P_UNLIKELY ((ret->events = WSACreateEvent ()) == WSA_INVALID_EVENT)) {
-		p_error_set_error_p (error,
-				     (pint) P_ERROR_IO_FAILED,
-				     (pint) p_error_get_last_net (),
-				     "Failed to call WSACreateEvent() on socket");
-		p_socket_free (ret);
-		return NULL;
-	}
+#if defined (P_SOCKET_VECTOR_WSA)
+		if (sa != NULL)
+			ret = WSASendTo (socket->fd,
+					 native_vec,
+					 (DWORD) n_native,
+					 &sent,
+					 0,
+					 (const struct sockaddr *) sa,
+					 optlen,
+					 NULL,
+					 NULL) == SOCKET_ERROR ? -1 : (pssize) sent;
+		else
+			ret = WSASend (socket->fd,
+				       native_vec,
+				       (DWORD) n_native,
+				       &sent,
+				       0,
+				       NULL,
+				       NULL) == SOCKET_ERROR ? -1 : (pssize) sent;
+#elif defined (P_SOCKET_VECTOR_MSG)
+		ret = sendmsg (socket->fd, &msg, P_SOCKET_DEFAULT_SEND_FLAGS);
+#else
+		if (sa != NULL)
+			ret = sendto (socket->fd,
+				      data,
+				      (socklen_t) total,
+				      0,
+				      (struct sockaddr *) sa,
+				      optlen);
+		else
+			ret = send (socket->fd,
+				    data,
+				    (socklen_t) total,
+				    P_SOCKET_DEFAULT_SEND_FLAGS);
 #endif
 
-	return ret;
-}
+		if (P_UNLIKELY (socket->stats != NULL))
+			pp_socket_stats_update (socket, TRUE, ret, 1, ret < 0 ? p_error_get_last_net () : 0);
 
-P_LIB_API pint
+		if (ret < 0) {
+			err_code = p_error_get_last_net ();
+
+#if !defined (P_OS_WIN) && defined (EINTR)
+			if (err_code == EINTR)
+				continue;
+#endif
+			sock_err = p_error_get_io_from_system (err_code);
+
+			if (socket->blocking && sock_err == P_ERROR_IO_WOULD_BLOCK)
+				continue;
+
+			pp_socket_set_error (socket,
+					     error,
+					     sock_err,
+					     err_code,
+#if defined (P_SOCKET_VECTOR_WSA)
+					     "Failed to call WSASend() on socket");
+#elif defined (P_SOCKET_VECTOR_MSG)
+					     "Failed to call sendmsg() on socket");
+#else
+					     "Failed to call send() on socket");
+#endif
+		}
+
+		break;
+	}
+
+#ifdef P_SOCKET_VECTOR_COPY
+	p_free (data);
+#else
+	if (native_vec != stack_vec)
+		p_free (native_vec);
+#endif
+
+	return ret;
+}
+
+static pssize
+pp_socket_receive_vector (const PSocket		*socket,
+			  PSocketAddress	**address,
+			  const PSocketVector	*vectors,
+			  psize			n_vectors,
+			  PError		**error)
+{
+	PErrorIO		sock_err;
+	struct sockaddr_storage	sa;
+	socklen_t		optlen;
+	psize			total;
+	pssize			ret;
+	pint			err_code;
+#ifdef P_SOCKET_VECTOR_COPY
+	pchar			*data;
+	psize			i;
+	psize			offset;
+	psize			chunk;
+#else
+	PSocketNativeVector	stack_vec[P_SOCKET_VECTOR_STACK_SIZE];
+	PSocketNativeVector	*native_vec;
+	psize			n_native;
+#endif
+#ifdef P_SOCKET_VECTOR_WSA
+	DWORD			recvd;
+	DWORD			flags;
+#endif
+#ifdef P_SOCKET_VECTOR_MSG
+	struct msghdr		msg;
+#endif
+
+	if (P_UNLIKELY (pp_socket_check_vectors (vectors, n_vectors, &total, error) == FALSE))
+		return -1;
+
+	if (P_UNLIKELY (pp_socket_check (socket, error) == FALSE))
+		return -1;
+
+#ifdef P_SOCKET_VECTOR_COPY
+	if (P_UNLIKELY ((data = p_malloc (total)) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for data buffer");
+		return -1;
+	}
+#else
+	if (P_UNLIKELY ((native_vec = pp_socket_vectors_to_native (vectors,
+								   n_vectors,
+								   stack_vec,
+								   &n_native,
+								   error)) == NULL))
+		return -1;
+#endif
+
+	for (;;) {
+		if (socket->blocking &&
+		    p_socket_io_condition_wait (socket,
+						P_SOCKET_IO_CONDITION_POLLIN,
+						error) == FALSE) {
+			ret = -1;
+			break;
+		}
+
+		optlen = sizeof (sa);
+
+#if defined (P_SOCKET_VECTOR_WSA)
+		flags = 0;
+
+		if (address != NULL)
+			ret = WSARecvFrom (socket->fd,
+					   native_vec,
+					   (DWORD) n_native,
+					   &recvd,
+					   &flags,
+					   (struct sockaddr *) &sa,
+					   &optlen,
+					   NULL,
+					   NULL) == SOCKET_ERROR ? -1 : (pssize) recvd;
+		else
+			ret = WSARecv (socket->fd,
+				       native_vec,
+				       (DWORD) n_native,
+				       &recvd,
+				       &flags,
+				       NULL,
+				       NULL) == SOCKET_ERROR ? -1 : (pssize) recvd;
+#elif defined (P_SOCKET_VECTOR_MSG)
+		memset (&msg, 0, sizeof (msg));
+
+		msg.msg_name    = address != NULL ? (void *) &sa : NULL;
+		msg.msg_namelen = address != NULL ? optlen : 0;
+		msg.msg_iov     = native_vec;
+		msg.msg_iovlen  = (int) n_native;
+
+		if ((ret = recvmsg (socket->fd, &msg, 0)) >= 0)
+			optlen = msg.msg_namelen;
+#else
+		if (address != NULL)
+			ret = recvfrom (socket->fd,
+					data,
+					(socklen_t) total,
+					0,
+					(struct sockaddr *) &sa,
+					&optlen);
+		else
+			ret = recv (socket->fd, data, (socklen_t) total, 0);
+#endif
+
+		if (P_UNLIKELY (socket->stats != NULL))
+			pp_socket_stats_update (socket, FALSE, ret, 1, ret < 0 ? p_error_get_last_net () : 0);
+
+		if (ret < 0) {
+			err_code = p_error_get_last_net ();
+
+#if !defined (P_OS_WIN) && defined (EINTR)
+			if (err_code == EINTR)
+				continue;
+#endif
+			sock_err = p_error_get_io_from_system (err_code);
+
+			if (socket->blocking && sock_err == P_ERROR_IO_WOULD_BLOCK)
+				continue;
+
+			pp_socket_set_error (socket,
+					     error,
+					     sock_err,
+					     err_code,
+#if defined (P_SOCKET_VECTOR_WSA)
+					     "Failed to call WSARecv() on socket");
+#elif defined (P_SOCKET_VECTOR_MSG)
+					     "Failed to call recvmsg() on socket");
+#else
+					     "Failed to call recv() on socket");
+#endif
+		} else if (address != NULL)
+			*address = p_socket_address_new_from_native (&sa, (psize) optlen);
+
+		break;
+	}
+
+#ifdef P_SOCKET_VECTOR_COPY
+	for (i = 0, offset = 0; ret > 0 && i < n_vectors && offset < (psize) ret; ++i) {
+		chunk = (psize) ret - offset;
+
+		if (chunk > vectors[i].buflen)
+			chunk = vectors[i].buflen;
+
+		if (chunk == 0)
+			continue;
+
+		memcpy (vectors[i].buffer, data + offset, chunk);
+		offset += chunk;
+	}
+
+	p_free (data);
+#else
+	if (native_vec != stack_vec)
+		p_free (native_vec);
+#endif
+
+	return ret;
+}
+
+static pboolean
+pp_socket_check_messages (PSocketMessage	*messages,
+			  psize			n_messages,
+			  pboolean		is_send,
+			  PError		**error)
+{
+	struct sockaddr_storage	sa;
+	psize			i;
+
+	if (P_UNLIKELY (messages == NULL || n_messages == 0 || n_messages > (psize) P_MAXSSIZE)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	for (i = 0; i < n_messages; ++i) {
+		if (P_UNLIKELY (messages[i].buffer == NULL || messages[i].buflen == 0)) {
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+					     0,
+					     "Invalid datagram descriptor");
+			return FALSE;
+		}
+
+		if (is_send && messages[i].address != NULL &&
+		    P_UNLIKELY (p_socket_address_to_native (messages[i].address, &sa, sizeof (sa)) == FALSE)) {
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IO_FAILED,
+					     0,
+					     "Failed to convert socket address to native structure");
+			return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+/* Receives as many pending datagrams as possible without blocking */
+static pssize
+pp_socket_receive_many_once (const PSocket	*socket,
+			     PSocketMessage	*messages,
+			     psize		n_messages,
+			     pint		*err_code)
+{
+#ifdef PLIBSYS_HAS_MMSG
+	struct sockaddr_storage	sa[P_SOCKET_MMSG_BATCH_SIZE];
+	struct mmsghdr		msgs[P_SOCKET_MMSG_BATCH_SIZE];
+	struct iovec		iov[P_SOCKET_MMSG_BATCH_SIZE];
+	psize			batch;
+	psize			i;
+	pssize			bytes;
+	pint			ret = 0;
+#else
+	struct sockaddr_storage	sa;
+	socklen_t		optlen;
+	pssize			ret = 0;
+#endif
+	psize			count = 0;
+
+#ifdef PLIBSYS_HAS_MMSG
+	while (count < n_messages) {
+		batch = n_messages - count;
+
+		if (batch > P_SOCKET_MMSG_BATCH_SIZE)
+			batch = P_SOCKET_MMSG_BATCH_SIZE;
+
+		memset (msgs, 0, sizeof (struct mmsghdr) * batch);
+
+		for (i = 0; i < batch; ++i) {
+			iov[i].iov_base = messages[count + i].buffer;
+			iov[i].iov_len  = messages[count + i].buflen;
+
+			msgs[i].msg_hdr.msg_name    = &sa[i];
+			msgs[i].msg_hdr.msg_namelen = sizeof (sa[i]);
+			msgs[i].msg_hdr.msg_iov     = &iov[i];
+			msgs[i].msg_hdr.msg_iovlen  = 1;
+		}
+
+		if ((ret = recvmmsg (socket->fd, msgs, (unsigned int) batch, 0, NULL)) < 0) {
+			*err_code = p_error_get_last_net ();
+
+			if (P_UNLIKELY (socket->stats != NULL))
+				pp_socket_stats_update (socket, FALSE, -1, 0, *err_code);
+
+			break;
+		}
+
+		for (i = 0, bytes = 0; i < (psize) ret; ++i) {
+			messages[count + i].length  = (psize) msgs[i].msg_len;
+			messages[count + i].address = p_socket_address_new_from_native (&sa[i],
+											(psize) msgs[i].msg_hdr.msg_namelen);
+			bytes += (pssize) msgs[i].msg_len;
+		}
+
+		if (P_UNLIKELY (socket->stats != NULL))
+			pp_socket_stats_update (socket, FALSE, bytes, (psize) ret, 0);
+
+		count += (psize) ret;
+
+		/* No more pending datagrams */
+		if ((psize) ret < batch)
+			break;
+	}
+#else
+	for (; count < n_messages; ++count) {
+		optlen = sizeof (sa);
+
+		if ((ret = recvfrom (socket->fd,
+				     messages[count].buffer,
+				     (socklen_t) messages[count].buflen,
+				     0,
+				     (struct sockaddr *) &sa,
+				     &optlen)) < 0) {
+			*err_code = p_error_get_last_net ();
+
+			if (P_UNLIKELY (socket->stats != NULL))
+				pp_socket_stats_update (socket, FALSE, -1, 0, *err_code);
+
+			break;
+		}
+
+		if (P_UNLIKELY (socket->stats != NULL))
+			pp_socket_stats_update (socket, FALSE, ret, 1, 0);
+
+		messages[count].length  = (psize) ret;
+		messages[count].address = p_socket_address_new_from_native (&sa, (psize) optlen);
+	}
+#endif
+
+	/* Errors after the first datagram only stop the batch */
+	return (ret < 0 && count == 0) ? -1 : (pssize) count;
+}
+
+/* Sends as many datagrams as possible without blocking */
+static pssize
+pp_socket_send_many_once (const PSocket		*socket,
+			  PSocketMessage	*messages,
+			  psize			n_messages,
+			  pint			*err_code)
+{
+#ifdef PLIBSYS_HAS_MMSG
+	struct sockaddr_storage	sa[P_SOCKET_MMSG_BATCH_SIZE];
+	struct mmsghdr		msgs[P_SOCKET_MMSG_BATCH_SIZE];
+	struct iovec		iov[P_SOCKET_MMSG_BATCH_SIZE];
+	psize			batch;
+	psize			i;
+	pssize			bytes;
+	pint			ret = 0;
+#else
+	struct sockaddr_storage	sa;
+	pssize			ret = 0;
+#endif
+	psize			count = 0;
+
+#ifdef PLIBSYS_HAS_MMSG
+	while (count < n_messages) {
+		batch = n_messages - count;
+
+		if (batch > P_SOCKET_MMSG_BATCH_SIZE)
+			batch = P_SOCKET_MMSG_BATCH_SIZE;
+
+		memset (msgs, 0, sizeof (struct mmsghdr) * batch);
+
+		for (i = 0; i < batch; ++i) {
+			iov[i].iov_base = messages[count + i].buffer;
+			iov[i].iov_len  = messages[count + i].buflen;
+
+			if (messages[count + i].address != NULL) {
+				p_socket_address_to_native (messages[count + i].address, &sa[i], sizeof (sa[i]));
+
+				msgs[i].msg_hdr.msg_name    = &sa[i];
+				msgs[i].msg_hdr.msg_namelen =
+					(socklen_t) p_socket_address_get_native_size (messages[count + i].address);
+			}
+
+			msgs[i].msg_hdr.msg_iov    = &iov[i];
+			msgs[i].msg_hdr.msg_iovlen = 1;
+		}
+
+		if ((ret = sendmmsg (socket->fd, msgs, (unsigned int) batch, P_SOCKET_DEFAULT_SEND_FLAGS)) < 0) {
+			*err_code = p_error_get_last_net ();
+
+			if (P_UNLIKELY (socket->stats != NULL))
+				pp_socket_stats_update (socket, TRUE, -1, 0, *err_code);
+
+			break;
+		}
+
+		for (i = 0, bytes = 0; i < (psize) ret; ++i) {
+			messages[count + i].length = (psize) msgs[i].msg_len;
+			bytes += (pssize) msgs[i].msg_len;
+		}
+
+		if (P_UNLIKELY (socket->stats != NULL))
+			pp_socket_stats_update (socket, TRUE, bytes, (psize) ret, 0);
+
+		count += (psize) ret;
+
+		/* Socket send buffer is full */
+		if ((psize) ret < batch)
+			break;
+	}
+#else
+	for (; count < n_messages; ++count) {
+		if (messages[count].address != NULL) {
+			p_socket_address_to_native (messages[count].address, &sa, sizeof (sa));
+
+			ret = sendto (socket->fd,
+				      messages[count].buffer,
+				      (socklen_t) messages[count].buflen,
+				      0,
+				      (struct sockaddr *) &sa,
+				      (socklen_t) p_socket_address_get_native_size (messages[count].address));
+		} else
+			ret = send (socket->fd,
+				    messages[count].buffer,
+				    (socklen_t) messages[count].buflen,
+				    P_SOCKET_DEFAULT_SEND_FLAGS);
+
+		if (ret < 0) {
+			*err_code = p_error_get_last_net ();
+
+			if (P_UNLIKELY (socket->stats != NULL))
+				pp_socket_stats_update (socket, TRUE, -1, 0, *err_code);
+
+			break;
+		}
+
+		if (P_UNLIKELY (socket->stats != NULL))
+			pp_socket_stats_update (socket, TRUE, ret, 1, 0);
+
+		messages[count].length = (psize) ret;
+	}
+#endif
+
+	/* Errors after the first datagram only stop the batch */
+	return (ret < 0 && count == 0) ? -1 : (pssize) count;
+}
+
+#ifndef P_SOCKET_SENDFILE_NONE
+/* Sends a part of the file without blocking using a kernel side copying */
+static pssize
+pp_socket_send_file_native (const PSocket	*socket,
+			    PSocketFileHandle	file,
+			    puint64		offset,
+			    psize		length,
+			    pint		*err_code)
+{
+#  if defined (P_SOCKET_SENDFILE_LINUX)
+	off_t			file_offset;
+	pssize			ret;
+
+	file_offset = (off_t) offset;
+
+	if ((ret = sendfile (socket->fd, file, &file_offset, length)) < 0)
+		*err_code = p_error_get_last_net ();
+
+	return ret;
+#  elif defined (P_SOCKET_SENDFILE_BSD)
+	off_t			sent = 0;
+
+	if (sendfile (file, socket->fd, (off_t) offset, length, NULL, &sent, 0) < 0) {
+		*err_code = p_error_get_last_net ();
+
+		/* Interrupted call still can send a part of the data */
+		if (sent > 0)
+			return (pssize) sent;
+
+		return -1;
+	}
+
+	return (pssize) sent;
+#  elif defined (P_SOCKET_SENDFILE_DARWIN)
+	off_t			sent = (off_t) length;
+
+	if (sendfile (file, socket->fd, (off_t) offset, &sent, NULL, 0) < 0) {
+		*err_code = p_error_get_last_net ();
+
+		/* Interrupted call still can send a part of the data */
+		if (sent > 0)
+			return (pssize) sent;
+
+		return -1;
+	}
+
+	return (pssize) sent;
+#  else
+	LPFN_TRANSMITFILE	transmit_func = NULL;
+	GUID			transmit_guid = WSAID_TRANSMITFILE;
+	OVERLAPPED		ov;
+	DWORD			bytes;
+	DWORD			flags;
+
+	if (P_UNLIKELY (WSAIoctl (socket->fd,
+				  SIO_GET_EXTENSION_FUNCTION_POINTER,
+				  &transmit_guid,
+				  sizeof (transmit_guid),
+				  &transmit_func,
+				  sizeof (transmit_func),
+				  &bytes,
+				  NULL,
+				  NULL) == SOCKET_ERROR || transmit_func == NULL)) {
+		*err_code = WSAEOPNOTSUPP;
+		return -1;
+	}
+
+	memset (&ov, 0, sizeof (ov));
+
+	ov.Offset     = (DWORD) (offset & 0xFFFFFFFF);
+	ov.OffsetHigh = (DWORD) (offset >> 32);
+
+	if (P_UNLIKELY ((ov.hEvent = WSACreateEvent ()) == WSA_INVALID_EVENT)) {
+		*err_code = p_error_get_last_net ();
+		return -1;
+	}
+
+	if (transmit_func (socket->fd, file, (DWORD) length, 0, &ov, NULL, 0) == FALSE &&
+	    (*err_code = p_error_get_last_net ()) != WSA_IO_PENDING) {
+		WSACloseEvent (ov.hEvent);
+		return -1;
+	}
+
+	if (WSAGetOverlappedResult (socket->fd, &ov, &bytes, TRUE, &flags) == FALSE) {
+		*err_code = p_error_get_last_net ();
+		WSACloseEvent (ov.hEvent);
+		return -1;
+	}
+
+	WSACloseEvent (ov.hEvent);
+
+	return (pssize) bytes;
+#  endif
+}
+
+/* Checks whether the native call can't be used for the given file or socket */
+static pboolean
+pp_socket_send_file_is_unsupported (pint err_code)
+{
+#  ifdef P_OS_WIN
+	return err_code == WSAEOPNOTSUPP || err_code == WSAENOTSOCK;
+#  else
+	return err_code == EINVAL
+#    ifdef ENOSYS
+	    || err_code == ENOSYS
+#    endif
+#    ifdef EOPNOTSUPP
+	    || err_code == EOPNOTSUPP
+#    endif
+#    if defined (ENOTSUP) && (!defined (EOPNOTSUPP) || ENOTSUP != EOPNOTSUPP)
+	    || err_code == ENOTSUP
+#    endif
+#    ifdef ENOTSOCK
+	    || err_code == ENOTSOCK
+#    endif
+	    ;
+#  endif
+}
+#endif
+
+/* Sends a part of the file reading it into the user space */
+static pssize
+pp_socket_send_file_copy (const PSocket		*socket,
+			  PSocketFileHandle	file,
+			  puint64		offset,
+			  psize			length,
+			  PError		**error)
+{
+	PError		*send_error = NULL;
+	pchar		*buffer;
+	pboolean	failed = FALSE;
+	psize		total = 0;
+	psize		chunk;
+	psize		pos;
+	pssize		ret;
+#ifdef P_OS_WIN
+	LARGE_INTEGER	file_pos;
+	DWORD		read_bytes;
+#endif
+
+	if (P_UNLIKELY ((buffer = p_malloc (P_SOCKET_SEND_FILE_BUFFER_SIZE)) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for file buffer");
+		return -1;
+	}
+
+#ifdef P_OS_WIN
+	file_pos.QuadPart = (LONGLONG) offset;
+
+	if (P_UNLIKELY (SetFilePointerEx (file, file_pos, NULL, FILE_BEGIN) == 0)) {
+#else
+	if (P_UNLIKELY (lseek (file, (off_t) offset, SEEK_SET) == (off_t) -1)) {
+#endif
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to set file position");
+		p_free (buffer);
+		return -1;
+	}
+
+	while (total < length) {
+		chunk = length - total;
+
+		if (chunk > P_SOCKET_SEND_FILE_BUFFER_SIZE)
+			chunk = P_SOCKET_SEND_FILE_BUFFER_SIZE;
+
+#ifdef P_OS_WIN
+		ret = ReadFile (file, buffer, (DWORD) chunk, &read_bytes, NULL) == 0 ? -1 : (pssize) read_bytes;
+#else
+		while ((ret = read (file, buffer, chunk)) < 0 && p_error_get_last_system () == EINTR)
+			;
+#endif
+
+		if (ret < 0) {
+			if (total == 0) {
+				p_error_set_error_p (error,
+						     (pint) p_error_get_last_io (),
+						     p_error_get_last_system (),
+						     "Failed to read file");
+				failed = TRUE;
+			}
+
+			break;
+		}
+
+		/* File has been truncated */
+		if (ret == 0)
+			break;
+
+		for (pos = 0; pos < (psize) ret; ) {
+			pssize sent;
+
+			if ((sent = p_socket_send (socket, buffer + pos, (psize) ret - pos, &send_error)) < 0)
+				break;
+
+			pos += (psize) sent;
+		}
+
+		total += pos;
+
+		if (send_error != NULL) {
+			/* Report only if nothing has been sent at all */
+			if (total == 0 && error != NULL)
+				*error = send_error;
+			else
+				p_error_free (send_error);
+
+			failed = (total == 0);
+			break;
+		}
+	}
+
+	p_free (buffer);
+
+	return failed ? -1 : (pssize) total;
+}
+
+static pssize
+pp_socket_send_file (const PSocket	*socket,
+		     PSocketFileHandle	file,
+		     puint64		offset,
+		     psize		length,
+		     PError		**error)
+{
+	puint64			file_size;
+#ifdef P_OS_WIN
+	LARGE_INTEGER		win_size;
+#else
+	struct stat		stat_buf;
+#endif
+#ifndef P_SOCKET_SENDFILE_NONE
+	PErrorIO		sock_err;
+	pboolean		failed = FALSE;
+	psize			total;
+	psize			chunk;
+	pssize			ret;
+	pint			err_code;
+#endif
+
+#ifdef P_OS_WIN
+	if (P_UNLIKELY (GetFileSizeEx (file, &win_size) == 0)) {
+#else
+	if (P_UNLIKELY (fstat (file, &stat_buf) != 0)) {
+#endif
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to get file size");
+		return -1;
+	}
+
+#ifdef P_OS_WIN
+	file_size = (puint64) win_size.QuadPart;
+#else
+	file_size = (puint64) stat_buf.st_size;
+#endif
+
+	if (P_UNLIKELY (offset > file_size)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Offset is beyond the end of file");
+		return -1;
+	}
+
+	if (length == 0 || (puint64) length > file_size - offset)
+		length = (psize) (file_size - offset);
+
+	if (length == 0)
+		return 0;
+
+#ifdef P_SOCKET_SENDFILE_NONE
+	return pp_socket_send_file_copy (socket, file, offset, length, error);
+#else
+#  ifdef P_SOCKET_SENDFILE_WIN
+	/* TransmitFile() always waits for completion */
+	if (!socket->blocking)
+		return pp_socket_send_file_copy (socket, file, offset, length, error);
+#  endif
+
+	for (total = 0; total < length; ) {
+		if (socket->blocking &&
+		    p_socket_io_condition_wait (socket,
+						P_SOCKET_IO_CONDITION_POLLOUT,
+						total == 0 ? error : NULL) == FALSE) {
+			failed = (total == 0);
+			break;
+		}
+
+		chunk = length - total;
+
+		if (chunk > P_SOCKET_SEND_FILE_CHUNK_SIZE)
+			chunk = P_SOCKET_SEND_FILE_CHUNK_SIZE;
+
+		ret = pp_socket_send_file_native (socket, file, offset + total, chunk, &err_code);
+
+		if (P_UNLIKELY (socket->stats != NULL))
+			pp_socket_stats_update (socket, TRUE, ret, 1, ret < 0 ? err_code : 0);
+
+		if (ret < 0) {
+#  if !defined (P_OS_WIN) && defined (EINTR)
+			if (err_code == EINTR)
+				continue;
+#  endif
+			/* Not supported for this file, send it the old way */
+			if (total == 0 && pp_socket_send_file_is_unsupported (err_code))
+				return pp_socket_send_file_copy (socket, file, offset, length, error);
+
+			sock_err = p_error_get_io_from_system (err_code);
+
+			if (socket->blocking && sock_err == P_ERROR_IO_WOULD_BLOCK)
+				continue;
+
+			if (total == 0) {
+				pp_socket_set_error (socket,
+						     error,
+						     sock_err,
+						     err_code,
+#  ifdef P_SOCKET_SENDFILE_WIN
+						     "Failed to call TransmitFile() on socket");
+#  else
+						     "Failed to call sendfile() on socket");
+#  endif
+				failed = TRUE;
+			}
+
+			break;
+		}
+
+		/* File has been truncated */
+		if (ret == 0)
+			break;
+
+		total += (psize) ret;
+	}
+
+	return failed ? -1 : (pssize) total;
+#endif
+}
+
+static pboolean
+pp_socket_option_to_native (const PSocket	*socket,
+			    PSocketOption	option,
+			    pint		*level,
+			    pint		*optname)
+{
+	*level = IPPROTO_TCP;
+
+	switch (option) {
+	case P_SOCKET_OPTION_TCP_NODELAY:
+		*optname = TCP_NODELAY;
+		return TRUE;
+#ifdef TCP_QUICKACK
+	case P_SOCKET_OPTION_TCP_QUICKACK:
+		*optname = TCP_QUICKACK;
+		return TRUE;
+#endif
+#if defined (TCP_CORK)
+	case P_SOCKET_OPTION_TCP_CORK:
+		*optname = TCP_CORK;
+		return TRUE;
+#elif defined (TCP_NOPUSH)
+	case P_SOCKET_OPTION_TCP_CORK:
+		*optname = TCP_NOPUSH;
+		return TRUE;
+#endif
+#ifdef SO_REUSEPORT
+	case P_SOCKET_OPTION_REUSE_PORT:
+		*level   = SOL_SOCKET;
+		*optname = SO_REUSEPORT;
+		return TRUE;
+#endif
+#ifdef TCP_FASTOPEN
+	case P_SOCKET_OPTION_TCP_FASTOPEN:
+		*optname = TCP_FASTOPEN;
+		return TRUE;
+#endif
+#ifdef SO_BUSY_POLL
+	case P_SOCKET_OPTION_BUSY_POLL:
+		*level   = SOL_SOCKET;
+		*optname = SO_BUSY_POLL;
+		return TRUE;
+#endif
+#ifdef SO_INCOMING_CPU
+	case P_SOCKET_OPTION_INCOMING_CPU:
+		*level   = SOL_SOCKET;
+		*optname = SO_INCOMING_CPU;
+		return TRUE;
+#endif
+	case P_SOCKET_OPTION_TOS:
+#if defined (AF_INET6) && defined (IPV6_TCLASS)
+		if (socket->family == P_SOCKET_FAMILY_INET6) {
+			*level   = IPPROTO_IPV6;
+			*optname = IPV6_TCLASS;
+			return TRUE;
+		}
+#endif
+		*level   = IPPROTO_IP;
+		*optname = IP_TOS;
+		return TRUE;
+#ifdef TCP_NOTSENT_LOWAT
+	case P_SOCKET_OPTION_TCP_NOTSENT_LOWAT:
+		*optname = TCP_NOTSENT_LOWAT;
+		return TRUE;
+#endif
+#ifdef PLIBSYS_HAS_UDP_GSO
+	case P_SOCKET_OPTION_UDP_GRO:
+		*level   = SOL_UDP;
+		*optname = UDP_GRO;
+		return TRUE;
+#endif
+	default:
+		return FALSE;
+	}
+}
+
+#ifdef PLIBSYS_HAS_UDP_GSO
+/* Sends a train of datagrams with a single call, the kernel splits it */
+static pssize
+pp_socket_send_gso_once (const PSocket			*socket,
+			 struct sockaddr_storage	*sa,
+			 socklen_t			optlen,
+			 const pchar			*buffer,
+			 psize				buflen,
+			 psize				segment_size,
+			 pint				*err_code)
+{
+	union {
+		struct cmsghdr	header;
+		pchar		buf[CMSG_SPACE (sizeof (puint16))];
+	}			control;
+	struct msghdr		msg;
+	struct iovec		iov;
+	struct cmsghdr		*cmsg;
+	puint16			gso_size;
+	pssize			ret;
+
+	memset (&msg, 0, sizeof (msg));
+	memset (&control, 0, sizeof (control));
+
+	iov.iov_base = (ppointer) buffer;
+	iov.iov_len  = buflen;
+
+	msg.msg_name       = (void *) sa;
+	msg.msg_namelen    = sa != NULL ? optlen : 0;
+	msg.msg_iov        = &iov;
+	msg.msg_iovlen     = 1;
+	msg.msg_control    = control.buf;
+	msg.msg_controllen = sizeof (control.buf);
+
+	gso_size = (puint16) segment_size;
+	cmsg     = CMSG_FIRSTHDR (&msg);
+
+	cmsg->cmsg_level = SOL_UDP;
+	cmsg->cmsg_type  = UDP_SEGMENT;
+	cmsg->cmsg_len   = CMSG_LEN (sizeof (puint16));
+
+	memcpy (CMSG_DATA (cmsg), &gso_size, sizeof (puint16));
+
+	if ((ret = sendmsg (socket->fd, &msg, P_SOCKET_DEFAULT_SEND_FLAGS)) < 0)
+		*err_code = p_error_get_last_net ();
+
+	return ret;
+}
+
+/* Old kernels don't know the option, and the network interface must support
+ * checksum offloading, the data is sent one datagram at a time then */
+static pboolean
+pp_socket_gso_is_unsupported (pint err_code)
+{
+	return err_code == EIO || err_code == EINVAL || err_code == ENOPROTOOPT || err_code == EOPNOTSUPP;
+}
+#endif
+
+/* Stamps the return of a call, the age is measured against the wall clock
+ * the kernel uses for the software timestamps */
+static void
+pp_socket_timestamps_finish (PSocketTimestamps *timestamps)
+{
+	puint64		now = 0;
+#if defined (PLIBSYS_HAS_SO_TIMESTAMPING)
+	struct timespec	ts;
+
+	if (P_LIKELY (clock_gettime (CLOCK_REALTIME, &ts) == 0))
+		now = (puint64) ts.tv_sec * 1000000000 + (puint64) ts.tv_nsec;
+#elif defined (PLIBSYS_HAS_SO_TIMESTAMP)
+	struct timeval	tv;
+
+	if (P_LIKELY (gettimeofday (&tv, NULL) == 0))
+		now = (puint64) tv.tv_sec * 1000000000 + (puint64) tv.tv_usec * 1000;
+#endif
+
+	timestamps->ticks = p_time_profiler_ticks ();
+	timestamps->age   = 0;
+
+	/* The wall clock may be stepped back in between */
+	if (timestamps->software != 0 && now > timestamps->software)
+		timestamps->age = now - timestamps->software;
+}
+
+#ifdef P_SOCKET_TIMESTAMP_MSG
+static void
+pp_socket_timestamps_from_control (struct msghdr	*msg,
+				   PSocketTimestamps	*timestamps)
+{
+	struct cmsghdr	*cmsg;
+#ifdef PLIBSYS_HAS_SO_TIMESTAMPING
+	struct timespec	ts[3];
+#endif
+#ifdef SCM_TIMESTAMP
+	struct timeval	tv;
+#endif
+
+	for (cmsg = CMSG_FIRSTHDR (msg); cmsg != NULL; cmsg = CMSG_NXTHDR (msg, cmsg)) {
+		if (cmsg->cmsg_level != SOL_SOCKET)
+			continue;
+
+#ifdef PLIBSYS_HAS_SO_TIMESTAMPING
+		/* Software, deprecated and raw hardware timestamps */
+		if (cmsg->cmsg_type == SCM_TIMESTAMPING && cmsg->cmsg_len >= CMSG_LEN (sizeof (ts))) {
+			memcpy (ts, CMSG_DATA (cmsg), sizeof (ts));
+
+			timestamps->software = (puint64) ts[0].tv_sec * 1000000000 + (puint64) ts[0].tv_nsec;
+			timestamps->hardware = (puint64) ts[2].tv_sec * 1000000000 + (puint64) ts[2].tv_nsec;
+		}
+#endif
+#ifdef SCM_TIMESTAMP
+		if (cmsg->cmsg_type == SCM_TIMESTAMP && cmsg->cmsg_len >= CMSG_LEN (sizeof (tv))) {
+			memcpy (&tv, CMSG_DATA (cmsg), sizeof (tv));
+
+			timestamps->software = (puint64) tv.tv_sec * 1000000000 + (puint64) tv.tv_usec * 1000;
+		}
+#endif
+	}
+}
+#endif
+
+/* Makes a single accept attempt without waiting */
+static pint
+pp_socket_accept_fd (const PSocket	*socket,
+		     pboolean		*nonblocking,
+		     pint		*err_code)
+{
+	pint	res;
+#ifndef P_OS_WIN
+	pint	flags;
+#endif
+
+#ifdef PLIBSYS_HAS_ACCEPT4
+	if ((res = accept4 (socket->fd, NULL, 0, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+		*nonblocking = TRUE;
+		return res;
+	}
+
+	/* Kernel can be older than the C library */
+	if (p_error_get_last_net () != ENOSYS) {
+		*err_code = p_error_get_last_net ();
+		return -1;
+	}
+#endif
+
+	*nonblocking = FALSE;
+
+	if ((res = (pint) accept (socket->fd, NULL, 0)) < 0) {
+		*err_code = p_error_get_last_net ();
+		return -1;
+	}
+
+#ifdef P_OS_WIN
+	/* The socket inherits the accepting sockets event mask and even object,
+	 * we need to remove that */
+	WSAEventSelect (res, NULL, 0);
+#else
+	flags = fcntl (res, F_GETFD, 0);
+
+	if (P_LIKELY (flags != -1 && (flags & FD_CLOEXEC) == 0)) {
+		flags |= FD_CLOEXEC;
+
+		if (P_UNLIKELY (fcntl (res, F_SETFD, flags) < 0))
+			P_WARNING ("PSocket::pp_socket_accept_fd: fcntl() with FD_CLOEXEC failed");
+	}
+#endif
+
+	return res;
+}
+
+/* Takes the ownership of the accepted fd, even on failure */
+static PSocket *
+pp_socket_new_accepted (const PSocket	*socket,
+			pint		fd,
+			pboolean	nonblocking,
+			PError		**error)
+{
+	PSocket	*ret;
+#if !defined (P_OS_WIN) && defined (SO_NOSIGPIPE)
+	pint	flags;
+#endif
+
+	if (P_UNLIKELY ((ret = pp_socket_alloc ()) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for socket");
+
+		if (P_UNLIKELY (p_sys_close (fd) != 0))
+			P_WARNING ("PSocket::pp_socket_new_accepted: p_sys_close() failed");
+
+		return NULL;
+	}
+
+	ret->fd = fd;
+
+#ifdef P_OS_WIN
+	ret->events = WSA_INVALID_EVENT;
+#endif
+
+	/* The accepted socket has the same details as the listening one, there is
+	 * no need to query them from the system */
+	ret->family    = socket->family;
+	ret->type      = socket->type;
+	ret->protocol  = socket->protocol;
+	ret->keepalive = socket->keepalive;
+	ret->connected = TRUE;
+	ret->timeout   = 0;
+	ret->blocking  = TRUE;
+
+	ret->has_deadline = FALSE;
+
+	p_socket_set_listen_backlog (ret, P_SOCKET_DEFAULT_BACKLOG);
+
+	if (!nonblocking && P_UNLIKELY (pp_socket_set_fd_blocking (ret->fd, FALSE, error) == FALSE)) {
+		p_socket_free (ret);
+		return NULL;
+	}
+
+#if !defined (P_OS_WIN) && defined (SO_NOSIGPIPE)
+	flags = 1;
+
+	if (setsockopt (ret->fd, SOL_SOCKET, SO_NOSIGPIPE, &flags, sizeof (flags)) < 0)
+		P_WARNING ("PSocket::pp_socket_new_accepted: setsockopt() with SO_NOSIGPIPE failed");
+#endif
+
+#ifdef P_OS_SCO
+	if (P_UNLIKELY ((ret->timer = p_time_profiler_new ()) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for internal timer");
+		p_socket_free (ret);
+		return NULL;
+	}
+#endif
+
+#ifdef P_OS_WIN
+	if (P_UNLIKELY ((ret->events = WSACreateEvent ()) == WSA_INVALID_EVENT)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_FAILED,
+				     (pint) p_error_get_last_net (),
+				     "Failed to call WSACreateEvent() on socket");
+		p_socket_free (ret);
+		return NULL;
+	}
+#endif
+
+	return ret;
+}
+
+/* Interleaves address families starting with the first one (RFC 8305) */
+static void
+pp_socket_connect_any_order (PSocketAddress	**addresses,
+			     psize		n_addresses,
+			     psize		*order)
+{
+	PSocketFamily	family;
+	psize		first_next = 0;
+	psize		other_next = 0;
+	psize		count;
+
+	family = p_socket_address_get_family (addresses[0]);
+
+	for (count = 0; count < n_addresses; ++count) {
+		while (first_next < n_addresses && p_socket_address_get_family (addresses[first_next]) != family)
+			++first_next;
+
+		while (other_next < n_addresses && p_socket_address_get_family (addresses[other_next]) == family)
+			++other_next;
+
+		/* Take the other family on odd positions while it lasts */
+		if ((count % 2 == 1 && other_next < n_addresses) || first_next >= n_addresses)
+			order[count] = other_next++;
+		else
+			order[count] = first_next++;
+	}
+}
+
+/* Starts a non-blocking connection attempt */
+static PSocket *
+pp_socket_connect_any_start (PSocketAddress	*address,
+			     pboolean		*pending,
+			     PError		**error)
+{
+	PSocket	*ret;
+	PError	*conn_error = NULL;
+	pint	code;
+
+	if (P_UNLIKELY ((ret = p_socket_new (p_socket_address_get_family (address),
+					     P_SOCKET_TYPE_STREAM,
+					     P_SOCKET_PROTOCOL_TCP,
+					     error)) == NULL))
+		return NULL;
+
+	p_socket_set_blocking (ret, FALSE);
+
+	*pending = FALSE;
+
+	if (p_socket_connect (ret, address, &conn_error) == TRUE)
+		return ret;
+
+	code = p_error_get_code (conn_error);
+
+	if (code == (pint) P_ERROR_IO_IN_PROGRESS || code == (pint) P_ERROR_IO_WOULD_BLOCK) {
+		p_error_free (conn_error);
+		*pending = TRUE;
+		return ret;
+	}
+
+	p_error_set_error_p (error,
+			     code,
+			     p_error_get_native_code (conn_error),
+			     p_error_get_message (conn_error));
+	p_error_free (conn_error);
+	p_socket_free (ret);
+
+	return NULL;
+}
+
+P_LIB_API PSocket *
+p_socket_new_from_fd (pint	fd,
+		      PError	**error)
+{
+	PSocket	*ret;
+#if !defined (P_OS_WIN) && defined (SO_NOSIGPIPE)
+	pint	flags;
+#endif
+
+	if (P_UNLIKELY (fd < 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Unable to create socket from bad fd");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret = pp_socket_alloc ()) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for socket");
+		return NULL;
+	}
+
+	ret->fd = fd;
+
+	if (P_UNLIKELY (pp_socket_set_details_from_fd (ret, error) == FALSE)) {
+		pp_socket_release (ret);
+		return NULL;
+	}
+
+	if (P_UNLIKELY (pp_socket_set_fd_blocking (ret->fd, FALSE, error) == FALSE)) {
+		pp_socket_release (ret);
+		return NULL;
+	}
+
+#if !defined (P_OS_WIN) && defined (SO_NOSIGPIPE)
+	flags = 1;
+
+	if (setsockopt (ret->fd, SOL_SOCKET, SO_NOSIGPIPE, &flags, sizeof (flags)) < 0)
+		P_WARNING ("PSocket::p_socket_new_from_fd: setsockopt() with SO_NOSIGPIPE failed");
+#endif
+
+	p_socket_set_listen_backlog (ret, P_SOCKET_DEFAULT_BACKLOG);
+
+	ret->timeout  = 0;
+	ret->blocking = TRUE;
+
+	ret->has_deadline = FALSE;
+
+#ifdef P_OS_SCO
+	if (P_UNLIKELY ((ret->timer = p_time_profiler_new ()) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for internal timer");
+		pp_socket_release (ret);
+		return NULL;
+	}
+#endif
+
+#ifdef P_OS_WIN
+	if (P_UNLIKELY ((ret->events = WSACreateEvent ()) == WSA_INVALID_EVENT)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_FAILED,
+				     (pint) p_error_get_last_net (),
+				     "Failed to call WSACreateEvent() on socket");
+		pp_socket_release (ret);
+		return NULL;
+	}
+#endif
+
+	return ret;
+}
+
+P_LIB_API PSocket *
+p_socket_new (PSocketFamily	family,
+	      PSocketType	type,
+	      PSocketProtocol	protocol,
+	      PError		**error)
+{
+	PSocket	*ret;
+	pint	native_type, fd;
+#ifndef P_OS_WIN
+	pint	flags;
+#endif
+
+	if (P_UNLIKELY (family   == P_SOCKET_FAMILY_UNKNOWN ||
+			type     == P_SOCKET_TYPE_UNKNOWN   ||
+			protocol == P_SOCKET_PROTOCOL_UNKNOWN)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input socket family, type or protocol");
+		return NULL;
+	}
+
+	switch (type) {
+	case P_SOCKET_TYPE_STREAM:
+		native_type = SOCK_STREAM;
+		break;
+
+	case P_SOCKET_TYPE_DATAGRAM:
+		native_type = SOCK_DGRAM;
+		break;
+
+#ifdef SOCK_SEQPACKET
+	case P_SOCKET_TYPE_SEQPACKET:
+		native_type = SOCK_SEQPACKET;
+		break;
+#endif
+
+	default:
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Unable to create socket with unknown family");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret = pp_socket_alloc ()) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for socket");
+		return NULL;
+	}
+
+#ifdef P_OS_SCO
+	if (P_UNLIKELY ((ret->timer = p_time_profiler_new ()) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for internal timer");
+		pp_socket_release (ret);
+		return NULL;
+	}
+#endif
+
+#ifdef SOCK_CLOEXEC
+	native_type |= SOCK_CLOEXEC;
+#endif
+	if (P_UNLIKELY ((fd = (pint) socket (family, native_type, protocol)) < 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_io_from_system (p_error_get_last_net ()),
+				     (pint) p_error_get_last_net (),
+				     "Failed to call socket() to create socket");
+#ifdef P_OS_SCO
+		p_time_profiler_free (ret->timer);
+#endif
+		pp_socket_release (ret);
+		return NULL;
+	}
+
+#ifndef P_OS_WIN
+	flags = fcntl (fd, F_GETFD, 0);
+
+	if (P_LIKELY (flags != -1 && (flags & FD_CLOEXEC) == 0)) {
+		flags |= FD_CLOEXEC;
+
+		if (P_UNLIKELY (fcntl (fd, F_SETFD, flags) < 0))
+			P_WARNING ("PSocket::p_socket_new: fcntl() with FD_CLOEXEC failed");
+	}
+#endif
+
+	ret->fd = fd;
+
+#ifdef P_OS_WIN
+	ret->events = WSA_INVALID_EVENT;
+#endif
+
+	if (P_UNLIKELY (pp_socket_set_fd_blocking (ret->fd, FALSE, error) == FALSE)) {
+		p_socket_free (ret);
+		return NULL;
+	}
+
+#if !defined (P_OS_WIN) && defined (SO_NOSIGPIPE)
+	flags = 1;
+
+	if (setsockopt (ret->fd, SOL_SOCKET, SO_NOSIGPIPE, &flags, sizeof (flags)) < 0)
+		P_WARNING ("PSocket::p_socket_new: setsockopt() with SO_NOSIGPIPE failed");
+#endif
+
+	ret->timeout  = 0;
+	ret->blocking = TRUE;
+	ret->family   = family;
+	ret->protocol = protocol;
+	ret->type     = type;
+
+	ret->has_deadline = FALSE;
+
+	p_socket_set_listen_backlog (ret, P_SOCKET_DEFAULT_BACKLOG);
+
+#ifdef P_OS_WIN
+	if (P_UNLIKELY ((ret->events = WSACreateEvent ()) == WSA_INVALID_EVENT)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_FAILED,
+				     (pint) p_error_get_last_net (),
+				     "Failed to call WSACreateEvent() on socket");
+		p_socket_free (ret);
+		return NULL;
+	}
+#endif
+
+	return ret;
+}
+
+P_LIB_API pint
 p_socket_get_fd (const PSocket *socket)
 {
-	if (P_UNLIKELY (socket == NULL))
+	if (P_UNLIKELY (socket == NULL))
+		return -1;
+
+	return socket->fd;
+}
+
+P_LIB_API PSocketFamily
+p_socket_get_family (const PSocket *socket)
+{
+	if (P_UNLIKELY (socket == NULL))
+		return P_SOCKET_FAMILY_UNKNOWN;
+
+	return socket->family;
+}
+
+P_LIB_API PSocketType
+p_socket_get_type (const PSocket *socket)
+{
+	if (P_UNLIKELY (socket == NULL))
+		return P_SOCKET_TYPE_UNKNOWN;
+
+	return socket->type;
+}
+
+P_LIB_API PSocketProtocol
+p_socket_get_protocol (const PSocket *socket)
+{
+	if (P_UNLIKELY (socket == NULL))
+		return P_SOCKET_PROTOCOL_UNKNOWN;
+
+	return socket->protocol;
+}
+
+P_LIB_API pboolean
+p_socket_get_keepalive (const PSocket *socket)
+{
+	if (P_UNLIKELY (socket == NULL))
+		return FALSE;
+
+	return socket->keepalive;
+}
+
+P_LIB_API pboolean
+p_socket_get_blocking (PSocket *socket)
+{
+	if (P_UNLIKELY (socket == NULL))
+		return FALSE;
+
+	return socket->blocking;
+}
+
+P_LIB_API pboolean
+p_socket_get_silent_would_block (const PSocket *socket)
+{
+	if (P_UNLIKELY (socket == NULL))
+		return FALSE;
+
+	return socket->silent_block;
+}
+
+P_LIB_API int
+p_socket_get_listen_backlog (const PSocket *socket)
+{
+	if (P_UNLIKELY (socket == NULL))
+		return -1;
+
+	return socket->listen_backlog;
+}
+
+P_LIB_API pint
+p_socket_get_timeout (const PSocket *socket)
+{
+	if (P_UNLIKELY (socket == NULL))
+		return -1;
+
+	return socket->timeout;
+}
+
+P_LIB_API PSocketAddress *
+p_socket_get_local_address (const PSocket	*socket,
+			    PError		**error)
+{
+	struct sockaddr_storage	buffer;
+	socklen_t		len;
+	PSocketAddress		*ret;
+
+	if (P_UNLIKELY (socket == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return NULL;
+	}
+
+	len = sizeof (buffer);
+
+	if (P_UNLIKELY (getsockname (socket->fd, (struct sockaddr *) &buffer, &len) < 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_io_from_system (p_error_get_last_net ()),
+				     (pint) p_error_get_last_net (),
+				     "Failed to call getsockname() to get local socket address");
+		return NULL;
+	}
+
+	ret = p_socket_address_new_from_native (&buffer, (psize) len);
+
+	if (P_UNLIKELY (ret == NULL))
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_FAILED,
+				     0,
+				     "Failed to create socket address from native structure");
+
+	return ret;
+}
+
+P_LIB_API PSocketAddress *
+p_socket_get_remote_address (const PSocket	*socket,
+			     PError		**error)
+{
+	struct sockaddr_storage	buffer;
+	socklen_t 		len;
+	PSocketAddress		*ret;
+
+	if (P_UNLIKELY (socket == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return NULL;
+	}
+
+	len = sizeof (buffer);
+
+	if (P_UNLIKELY (getpeername (socket->fd, (struct sockaddr *) &buffer, &len) < 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_io_from_system (p_error_get_last_net ()),
+				     (pint) p_error_get_last_net (),
+				     "Failed to call getpeername() to get remote socket address");
+		return NULL;
+	}
+
+#ifdef P_OS_SYLLABLE
+	/* Syllable has a bug with a wrong byte order for a TCP port,
+	 * as it only supports IPv4 we can easily fix it here. */
+	((struct sockaddr_in *) &buffer)->sin_port =
+			p_htons (((struct sockaddr_in *) &buffer)->sin_port);
+#endif
+
+	ret = p_socket_address_new_from_native (&buffer, (psize) len);
+
+	if (P_UNLIKELY (ret == NULL))
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_FAILED,
+				     0,
+				     "Failed to create socket address from native structure");
+
+	return ret;
+}
+
+P_LIB_API pboolean
+p_socket_is_connected (const PSocket *socket)
+{
+	if (P_UNLIKELY (socket == NULL))
+		return FALSE;
+
+	return socket->connected;
+}
+
+P_LIB_API pboolean
+p_socket_is_closed (const PSocket *socket)
+{
+	if (P_UNLIKELY (socket == NULL))
+		return TRUE;
+
+	return socket->closed;
+}
+
+P_LIB_API pboolean
+p_socket_check_connect_result (PSocket  *socket,
+			       PError	**error)
+{
+	socklen_t	optlen;
+	pint		val;
+
+	if (P_UNLIKELY (socket == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	optlen = sizeof (val);
+
+	if (P_UNLIKELY (getsockopt (socket->fd, SOL_SOCKET, SO_ERROR, (ppointer) &val, &optlen) < 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_io_from_system (p_error_get_last_net ()),
+				     (pint) p_error_get_last_net (),
+				     "Failed to call getsockopt() to get connection status");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (val != 0))
+		p_error_set_error_p (error,
+				     (pint) p_error_get_io_from_system (val),
+				     val,
+				     "Error in socket layer");
+
+	socket->connected = (val == 0);
+
+	return (val == 0);
+}
+
+P_LIB_API void
+p_socket_set_keepalive (PSocket		*socket,
+			pboolean	keepalive)
+{
+#ifdef P_OS_WIN
+	pchar value;
+#else
+	pint value;
+#endif
+
+	if (P_UNLIKELY (socket == NULL))
+		return;
+
+	if (socket->keepalive == (puint) !!keepalive)
+		return;
+
+#ifdef P_OS_WIN
+	value = !! (pchar) keepalive;
+#else
+	value = !! (pint) keepalive;
+#endif
+	if (setsockopt (socket->fd, SOL_SOCKET, SO_KEEPALIVE, &value, sizeof (value)) < 0) {
+		P_WARNING ("PSocket::p_socket_set_keepalive: setsockopt() with SO_KEEPALIVE failed");
+		return;
+	}
+
+	socket->keepalive = !! (pint) keepalive;
+}
+
+P_LIB_API void
+p_socket_set_blocking (PSocket	*socket,
+		       pboolean	blocking)
+{
+	if (P_UNLIKELY (socket == NULL))
+		return;
+
+	socket->blocking = !! blocking;
+}
+
+P_LIB_API void
+p_socket_set_silent_would_block (PSocket	*socket,
+				 pboolean	silent)
+{
+	if (P_UNLIKELY (socket == NULL))
+		return;
+
+	socket->silent_block = !! silent;
+}
+
+P_LIB_API void
+p_socket_set_listen_backlog (PSocket	*socket,
+			     pint	backlog)
+{
+	if (P_UNLIKELY (socket == NULL || socket->listening))
+		return;
+
+	socket->listen_backlog = backlog;
+}
+
+P_LIB_API void
+p_socket_set_timeout (PSocket	*socket,
+		      pint	timeout)
+{
+	if (P_UNLIKELY (socket == NULL))
+		return;
+
+	if (timeout < 0)
+		timeout = 0;
+
+	socket->timeout = timeout;
+}
+
+P_LIB_API void
+p_socket_set_deadline (PSocket		*socket,
+		       const PDeadline	*deadline)
+{
+	if (P_UNLIKELY (socket == NULL))
+		return;
+
+	if (deadline == NULL) {
+		socket->has_deadline = FALSE;
+		return;
+	}
+
+	socket->deadline     = *deadline;
+	socket->has_deadline = TRUE;
+}
+
+P_LIB_API pboolean
+p_socket_bind (const PSocket	*socket,
+	       PSocketAddress	*address,
+	       pboolean		allow_reuse,
+	       PError		**error)
+{
+	struct sockaddr_storage	addr;
+
+#ifdef SO_REUSEPORT
+	pboolean		reuse_port;
+#endif
+
+#ifdef P_OS_WIN
+	pchar			value;
+#else
+	pint			value;
+#endif
+
+	if (P_UNLIKELY (socket == NULL || address == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (pp_socket_check (socket, error) == FALSE))
+		return FALSE;
+
+	/* Windows allows to reuse the same address even for an active TCP
+	 * connection, that's why on Windows we should use SO_REUSEADDR only
+	 * for UDP sockets, UNIX doesn't have such behavior
+	 *
+	 * Ignore errors here, the only likely error is "not supported", and
+	 * this is a "best effort" thing mainly */
+
+#ifdef P_OS_WIN
+	value = !! (pchar) (allow_reuse && (socket->type == P_SOCKET_TYPE_DATAGRAM));
+#else
+	value = !! (pint) allow_reuse;
+#endif
+
+	if (setsockopt (socket->fd, SOL_SOCKET, SO_REUSEADDR, &value, sizeof (value)) < 0)
+		P_WARNING ("PSocket::p_socket_bind: setsockopt() with SO_REUSEADDR failed");
+
+#ifdef SO_REUSEPORT
+	reuse_port = allow_reuse && (socket->type == P_SOCKET_TYPE_DATAGRAM);
+
+#  ifdef P_OS_WIN
+	value = !! (pchar) reuse_port;
+#  else
+	value = !! (pint) reuse_port;
+#  endif
+
+	if (setsockopt (socket->fd, SOL_SOCKET, SO_REUSEPORT, &value, sizeof (value)) < 0)
+		P_WARNING ("PSocket::p_socket_bind: setsockopt() with SO_REUSEPORT failed");
+#endif
+
+	if (P_UNLIKELY (p_socket_address_to_native (address, &addr, sizeof (addr)) == FALSE)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_FAILED,
+				     0,
+				     "Failed to convert socket address to native structure");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (bind (socket->fd,
+			      (struct sockaddr *) &addr,
+			      (socklen_t) p_socket_address_get_native_size (address)) < 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_io_from_system (p_error_get_last_net ()),
+				     (pint) p_error_get_last_net (),
+				     "Failed to call bind() on socket");
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_socket_connect (PSocket		*socket,
+		  PSocketAddress	*address,
+		  PError		**error)
+{
+	struct sockaddr_storage	buffer;
+	pint			err_code;
+	pint			conn_result;
+	PErrorIO		sock_err;
+
+	if (P_UNLIKELY (socket == NULL || address == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (pp_socket_check (socket, error) == FALSE))
+		return FALSE;
+
+	if (P_UNLIKELY (p_socket_address_to_native (address, &buffer, sizeof (buffer)) == FALSE)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_FAILED,
+				     0,
+				     "Failed to convert socket address to native structure");
+		return FALSE;
+	}
+
+#if !defined (P_OS_WIN) && defined (EINTR)
+	for (;;) {
+		conn_result = connect (socket->fd, (struct sockaddr *) &buffer,
+				       (socklen_t) p_socket_address_get_native_size (address));
+
+		if (P_LIKELY (conn_result == 0))
+			break;
+
+		err_code = p_error_get_last_net ();
+
+		if (err_code == EINTR)
+			continue;
+		else
+			break;
+	}
+#else
+	conn_result = connect (socket->fd, (struct sockaddr *) &buffer,
+			       (pint) p_socket_address_get_native_size (address));
+
+	if (conn_result != 0)
+		err_code = p_error_get_last_net ();
+#endif
+
+	if (conn_result == 0) {
+		socket->connected = TRUE;
+		return TRUE;
+	}
+
+	sock_err = p_error_get_io_from_system (err_code);
+
+	if (P_LIKELY (sock_err == P_ERROR_IO_WOULD_BLOCK || sock_err == P_ERROR_IO_IN_PROGRESS)) {
+		if (socket->blocking) {
+			if (p_socket_io_condition_wait (socket,
+							P_SOCKET_IO_CONDITION_POLLOUT,
+							error) == TRUE &&
+			    p_socket_check_connect_result (socket, error) == TRUE) {
+				socket->connected = TRUE;
+				return TRUE;
+			}
+		} else
+			pp_socket_set_error (socket,
+					     error,
+					     sock_err,
+					     err_code,
+					     "Couldn't block non-blocking socket");
+	} else
+		pp_socket_set_error (socket,
+				     error,
+				     sock_err,
+				     err_code,
+				     "Failed to call connect() on socket");
+
+	return FALSE;
+}
+
+P_LIB_API PSocket *
+p_socket_connect_any (PSocketAddress	**addresses,
+		      psize		n_addresses,
+		      pint		delay,
+		      pint		timeout,
+		      psize		*index,
+		      PError		**error)
+{
+	PSocketPollerEvent	events[P_SOCKET_CONNECT_ANY_EVENTS];
+	PSocketPoller		*poller    = NULL;
+	PTimeProfiler		*profiler  = NULL;
+	PSocket			**sockets  = NULL;
+	psize			*order     = NULL;
+	PSocket			*ret       = NULL;
+	PError			*att_error = NULL;
+	pboolean		pending;
+	psize			next       = 0;
+	psize			active     = 0;
+	psize			winner     = 0;
+	psize			i;
+	puint64			elapsed;
+	puint64			next_start = 0;
+	pint			wait_time;
+	pint			n_events;
+	pint			k;
+
+	if (P_UNLIKELY (addresses == NULL || n_addresses == 0 || delay < 0 || timeout < 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return NULL;
+	}
+
+	for (i = 0; i < n_addresses; ++i) {
+		if (P_UNLIKELY (addresses[i] == NULL)) {
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+					     0,
+					     "Invalid input argument");
+			return NULL;
+		}
+	}
+
+	if (delay == 0)
+		delay = P_SOCKET_CONNECT_ANY_DELAY;
+
+	sockets  = p_malloc0 (n_addresses * sizeof (PSocket *));
+	order    = p_malloc0 (n_addresses * sizeof (psize));
+	profiler = p_time_profiler_new ();
+
+	if (P_UNLIKELY (sockets == NULL || order == NULL || profiler == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for connection attempts");
+		n_addresses = 0;
+	} else if (P_UNLIKELY ((poller = p_socket_poller_new (error)) == NULL))
+		n_addresses = 0;
+	else
+		pp_socket_connect_any_order (addresses, n_addresses, order);
+
+	while (ret == NULL && n_addresses > 0) {
+		elapsed = p_time_profiler_elapsed_usecs (profiler) / 1000;
+
+		if (timeout > 0 && elapsed >= (puint64) timeout) {
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IO_TIMED_OUT,
+					     0,
+					     "Timed out while connecting to the addresses");
+			break;
+		}
+
+		/* Start the next attempt after the delay, or if all have failed */
+		if (next < n_addresses && (active == 0 || elapsed >= next_start)) {
+			i          = order[next++];
+			next_start = elapsed + (puint64) delay;
+
+			if (att_error != NULL) {
+				p_error_free (att_error);
+				att_error = NULL;
+			}
+
+			if ((sockets[i] = pp_socket_connect_any_start (addresses[i], &pending, &att_error)) == NULL)
+				continue;
+
+			if (!pending) {
+				ret    = sockets[i];
+				winner = i;
+				break;
+			}
+
+			if (P_UNLIKELY (p_socket_poller_add (poller,
+							     sockets[i],
+							     P_SOCKET_POLLER_CONDITION_OUT,
+							     P_SOCKET_POLLER_FLAG_NONE,
+							     &sockets[i],
+							     &att_error) == FALSE)) {
+				p_socket_free (sockets[i]);
+				sockets[i] = NULL;
+				continue;
+			}
+
+			++active;
+			continue;
+		}
+
+		if (active == 0) {
+			if (att_error != NULL)
+				p_error_set_error_p (error,
+						     p_error_get_code (att_error),
+						     p_error_get_native_code (att_error),
+						     p_error_get_message (att_error));
+			break;
+		}
+
+		wait_time = -1;
+
+		if (next < n_addresses)
+			wait_time = (pint) (next_start - elapsed);
+
+		if (timeout > 0 && (wait_time < 0 || (puint64) timeout - elapsed < (puint64) wait_time))
+			wait_time = (pint) ((puint64) timeout - elapsed);
+
+		if (P_UNLIKELY ((n_events = p_socket_poller_wait (poller,
+								  events,
+								  P_SOCKET_CONNECT_ANY_EVENTS,
+								  wait_time,
+								  error)) < 0))
+			break;
+
+		for (k = 0; k < n_events; ++k) {
+			i = (psize) ((PSocket **) events[k].user_data - sockets);
+
+			if (att_error != NULL) {
+				p_error_free (att_error);
+				att_error = NULL;
+			}
+
+			if (p_socket_check_connect_result (sockets[i], &att_error) == TRUE) {
+				ret    = sockets[i];
+				winner = i;
+				break;
+			}
+
+			/* Failed attempt lets the next one start at once */
+			p_socket_poller_remove (poller, sockets[i], NULL);
+			p_socket_free (sockets[i]);
+
+			sockets[i] = NULL;
+			next_start = elapsed;
+			--active;
+		}
+	}
+
+	for (i = 0; i < n_addresses; ++i) {
+		if (sockets[i] == NULL)
+			continue;
+
+		p_socket_poller_remove (poller, sockets[i], NULL);
+
+		if (sockets[i] != ret)
+			p_socket_free (sockets[i]);
+	}
+
+	if (ret != NULL) {
+		p_socket_set_blocking (ret, TRUE);
+
+		if (index != NULL)
+			*index = winner;
+	}
+
+	if (att_error != NULL)
+		p_error_free (att_error);
+
+	if (poller != NULL)
+		p_socket_poller_free (poller);
+
+	if (profiler != NULL)
+		p_time_profiler_free (profiler);
+
+	p_free (order);
+	p_free (sockets);
+
+	return ret;
+}
+
+P_LIB_API pboolean
+p_socket_listen (PSocket	*socket,
+		 PError		**error)
+{
+	if (P_UNLIKELY (socket == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (pp_socket_check (socket, error) == FALSE))
+		return FALSE;
+
+	if (P_UNLIKELY (listen (socket->fd, socket->listen_backlog) < 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_io_from_system (p_error_get_last_net ()),
+				     (pint) p_error_get_last_net (),
+				     "Failed to call listen() on socket");
+		return FALSE;
+	}
+
+	socket->listening = TRUE;
+	return TRUE;
+}
+
+P_LIB_API PSocket *
+p_socket_accept (const PSocket	*socket,
+		 PError		**error)
+{
+	PErrorIO	sock_err;
+	pboolean	nonblocking;
+	pint		res;
+	pint		err_code;
+
+	if (P_UNLIKELY (socket == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return NULL;
+	}
+
+	if (P_UNLIKELY (pp_socket_check (socket, error) == FALSE))
+		return NULL;
+
+	for (;;) {
+		if (socket->blocking &&
+		    p_socket_io_condition_wait (socket,
+						P_SOCKET_IO_CONDITION_POLLIN,
+						error) == FALSE)
+			return NULL;
+
+		if ((res = pp_socket_accept_fd (socket, &nonblocking, &err_code)) < 0) {
+#if !defined (P_OS_WIN) && defined (EINTR)
+			if (err_code == EINTR)
+				continue;
+#endif
+			sock_err = p_error_get_io_from_system (err_code);
+
+			if (socket->blocking && sock_err == P_ERROR_IO_WOULD_BLOCK)
+				continue;
+
+			pp_socket_set_error (socket,
+					     error,
+					     sock_err,
+					     err_code,
+					     "Failed to call accept() on socket");
+
+			return NULL;
+		}
+
+		break;
+	}
+
+	return pp_socket_new_accepted (socket, res, nonblocking, error);
+}
+
+P_LIB_API pssize
+p_socket_accept_many (const PSocket	*socket,
+		      PSocket		**sockets,
+		      psize		max_sockets,
+		      PError		**error)
+{
+	PErrorIO	sock_err;
+	pboolean	nonblocking;
+	psize		count;
+	pint		res;
+	pint		err_code;
+
+	if (P_UNLIKELY (socket == NULL || sockets == NULL || max_sockets == 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	if (P_UNLIKELY (pp_socket_check (socket, error) == FALSE))
+		return -1;
+
+	if (max_sockets > (psize) P_MAXSSIZE)
+		max_sockets = (psize) P_MAXSSIZE;
+
+	count = 0;
+
+	while (count < max_sockets) {
+		/* Wait only for the first connection */
+		if (count == 0 && socket->blocking &&
+		    p_socket_io_condition_wait (socket,
+						P_SOCKET_IO_CONDITION_POLLIN,
+						error) == FALSE)
+			return -1;
+
+		if ((res = pp_socket_accept_fd (socket, &nonblocking, &err_code)) < 0) {
+#if !defined (P_OS_WIN) && defined (EINTR)
+			if (err_code == EINTR)
+				continue;
+#endif
+			if (count > 0)
+				break;
+
+			sock_err = p_error_get_io_from_system (err_code);
+
+			if (socket->blocking && sock_err == P_ERROR_IO_WOULD_BLOCK)
+				continue;
+
+			pp_socket_set_error (socket,
+					     error,
+					     sock_err,
+					     err_code,
+					     "Failed to call accept() on socket");
+
+			return -1;
+		}
+
+		if (P_UNLIKELY ((sockets[count] = pp_socket_new_accepted (socket,
+									  res,
+									  nonblocking,
+									  count == 0 ? error : NULL)) == NULL)) {
+			if (count == 0)
+				return -1;
+
+			break;
+		}
+
+		++count;
+	}
+
+	return (pssize) count;
+}
+
+P_LIB_API pssize
+p_socket_receive (const PSocket	*socket,
+		  pchar		*buffer,
+		  psize		buflen,
+		  PError	**error)
+{
+	PErrorIO	sock_err;
+	pssize		ret;
+	pint		err_code;
+
+	if (P_UNLIKELY (socket == NULL || buffer == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	if (P_UNLIKELY (pp_socket_check (socket, error) == FALSE))
+		return -1;
+
+	for (;;) {
+		if (socket->blocking &&
+		    p_socket_io_condition_wait (socket,
+						P_SOCKET_IO_CONDITION_POLLIN,
+						error) == FALSE)
+			return -1;
+
+		if ((ret = recv (socket->fd, buffer, (socklen_t) buflen, 0)) < 0) {
+			err_code = p_error_get_last_net ();
+
+			if (P_UNLIKELY (socket->stats != NULL))
+				pp_socket_stats_update (socket, FALSE, -1, 0, err_code);
+
+#if !defined (P_OS_WIN) && defined (EINTR)
+			if (err_code == EINTR)
+				continue;
+#endif
+			sock_err = p_error_get_io_from_system (err_code);
+
+			if (socket->blocking && sock_err == P_ERROR_IO_WOULD_BLOCK)
+				continue;
+
+			pp_socket_set_error (socket,
+					     error,
+					     sock_err,
+					     err_code,
+					     "Failed to call recv() on socket");
+
+			return -1;
+		}
+
+		break;
+	}
+
+	if (P_UNLIKELY (socket->stats != NULL))
+		pp_socket_stats_update (socket, FALSE, ret, 1, 0);
+
+	return ret;
+}
+
+/* Receives a datagram along with its native source address */
+static pssize
+pp_socket_receive_from_native (const PSocket		*socket,
+			       struct sockaddr_storage	*sa,
+			       socklen_t		*optlen,
+			       pchar			*buffer,
+			       psize			buflen,
+			       PError			**error)
+{
+	PErrorIO	sock_err;
+	pssize		ret;
+	pint		err_code;
+
+	if (P_UNLIKELY (socket == NULL || buffer == NULL || buflen == 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
 		return -1;
+	}
 
-	return socket->fd;
-}
+	if (P_UNLIKELY (pp_socket_check (socket, error) == FALSE))
+		return -1;
 
-P_LIB_API PSocketFamily
-p_socket_get_family (const PSocket *socket)
-{
-	if (P_UNLIKELY (socket == NULL))
-		return P_SOCKET_FAMILY_UNKNOWN;
+	*optlen = sizeof (struct sockaddr_storage);
 
-	return socket->family;
-}
+	for (;;) {
+		if (socket->blocking &&
+		    p_socket_io_condition_wait (socket,
+						P_SOCKET_IO_CONDITION_POLLIN,
+						error) == FALSE)
+			return -1;
 
-P_LIB_API PSocketType
-p_socket_get_type (const PSocket *socket)
-{
-	if (P_UNLIKELY (socket == NULL))
-		return P_SOCKET_TYPE_UNKNOWN;
+		if ((ret = recvfrom (socket->fd,
+				     buffer,
+				     (socklen_t) buflen,
+				     0,
+				     (struct sockaddr *) sa,
+				     optlen)) < 0) {
+			err_code = p_error_get_last_net ();
 
-	return socket->type;
-}
+			if (P_UNLIKELY (socket->stats != NULL))
+				pp_socket_stats_update (socket, FALSE, -1, 0, err_code);
 
-P_LIB_API PSocketProtocol
-p_socket_get_protocol (const PSocket *socket)
-{
-	if (P_UNLIKELY (socket == NULL))
-		return P_SOCKET_PROTOCOL_UNKNOWN;
+#if !defined (P_OS_WIN) && defined (EINTR)
+			if (err_code == EINTR)
+				continue;
+#endif
+			sock_err = p_error_get_io_from_system (err_code);
 
-	return socket->protocol;
-}
+			if (socket->blocking && sock_err == P_ERROR_IO_WOULD_BLOCK)
+				continue;
 
-P_LIB_API pboolean
-p_socket_get_keepalive (const PSocket *socket)
-{
-	if (P_UNLIKELY (socket == NULL))
-		return FALSE;
+			pp_socket_set_error (socket,
+					     error,
+					     sock_err,
+					     err_code,
+					     "Failed to call recvfrom() on socket");
 
-	return socket->keepalive;
-}
+			return -1;
+		}
 
-P_LIB_API pboolean
-p_socket_get_blocking (PSocket *socket)
-{
-	if (P_UNLIKELY (socket == NULL))
-		return FALSE;
+		break;
+	}
 
-	return socket->blocking;
+	if (P_UNLIKELY (socket->stats != NULL))
+		pp_socket_stats_update (socket, FALSE, ret, 1, 0);
+
+	return ret;
 }
 
-P_LIB_API int
-p_socket_get_listen_backlog (const PSocket *socket)
+P_LIB_API pssize
+p_socket_receive_from (const PSocket	*socket,
+		       PSocketAddress	**address,
+		       pchar		*buffer,
+		       psize		buflen,
+		       PError		**error)
 {
-	if (P_UNLIKELY (socket == NULL))
-		return -1;
+	struct sockaddr_storage sa;
+	socklen_t		optlen;
+	pssize			ret;
 
-	return socket->listen_backlog;
+	ret = pp_socket_receive_from_native (socket, &sa, &optlen, buffer, buflen, error);
+
+	if (ret >= 0 && address != NULL)
+		*address = p_socket_address_new_from_native (&sa, optlen);
+
+	return ret;
 }
 
-P_LIB_API pint
-p_socket_get_timeout (const PSocket *socket)
+P_LIB_API pssize
+p_socket_receive_from_into (const PSocket	*socket,
+			    PSocketAddress	*address,
+			    pchar		*buffer,
+			    psize		buflen,
+			    PError		**error)
 {
-	if (P_UNLIKELY (socket == NULL))
-		return -1;
+	struct sockaddr_storage sa;
+	socklen_t		optlen;
+	pssize			ret;
 
-	return socket->timeout;
+	ret = pp_socket_receive_from_native (socket, &sa, &optlen, buffer, buflen, error);
+
+	if (ret >= 0 && address != NULL)
+		p_socket_address_set_from_native (address, &sa, optlen);
+
+	return ret;
 }
 
-P_LIB_API PSocketAddress *
-p_socket_get_local_address (const PSocket	*socket,
-			    PError		**error)
+P_LIB_API pssize
+p_socket_send (const PSocket	*socket,
+	       const pchar	*buffer,
+	       psize		buflen,
+	       PError		**error)
 {
-	struct sockaddr_storage	buffer;
-	socklen_t		len;
-	PSocketAddress		*ret;
+	PErrorIO	sock_err;
+	pssize		ret;
+	pint		err_code;
 
-	if (P_UNLIKELY (socket == NULL)) {
+	if (P_UNLIKELY (socket == NULL || buffer == NULL || buflen == 0)) {
 		p_error_set_error_p (error,
 				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
 				     0,
 				     "Invalid input argument");
-		return NULL;
+		return -1;
 	}
 
-	len = sizeof (buffer);
+	if (P_UNLIKELY (pp_socket_check (socket, error) == FALSE))
+		return -1;
 
-	if (P_UNLIKELY (getsockname (socket->fd, (struct sockaddr *) &buffer, &len) < 0)) {
-		p_error_set_error_p (error,
-				     (pint) p_error_get_io_from_system (p_error_get_last_net ()),
-				     (pint) p_error_get_last_net (),
-				     "Failed to call getsockname() to get local socket address");
-		return NULL;
-	}
+	for (;;) {
+		if (socket->blocking &&
+		    p_socket_io_condition_wait (socket,
+						P_SOCKET_IO_CONDITION_POLLOUT,
+						error) == FALSE)
+			return -1;
 
-	ret = p_socket_address_new_from_native (&buffer, (psize) len);
+		if ((ret = send (socket->fd,
+				 buffer,
+				 (socklen_t) buflen,
+				 P_SOCKET_DEFAULT_SEND_FLAGS)) < 0) {
+			err_code = p_error_get_last_net ();
 
-	if (P_UNLIKELY (ret == NULL))
-		p_error_set_error_p (error,
-				     (pint) P_ERROR_IO_FAILED,
-				     0,
-				     "Failed to create socket address from native structure");
+			if (P_UNLIKELY (socket->stats != NULL))
+				pp_socket_stats_update (socket, TRUE, -1, 0, err_code);
+
+#if !defined (P_OS_WIN) && defined (EINTR)
+			if (err_code == EINTR)
+				continue;
+#endif
+			sock_err = p_error_get_io_from_system (err_code);
+
+			if (socket->blocking && sock_err == P_ERROR_IO_WOULD_BLOCK)
+				continue;
+
+			pp_socket_set_error (socket,
+					     error,
+					     sock_err,
+					     err_code,
+					     "Failed to call send() on socket");
+
+			return -1;
+		}
+
+		break;
+	}
+
+	if (P_UNLIKELY (socket->stats != NULL))
+		pp_socket_stats_update (socket, TRUE, ret, 1, 0);
 
 	return ret;
 }
 
-P_LIB_API PSocketAddress *
-p_socket_get_remote_address (const PSocket	*socket,
-			     PError		**error)
+P_LIB_API pssize
+p_socket_send_to (const PSocket		*socket,
+		  PSocketAddress	*address,
+		  const pchar		*buffer,
+		  psize			buflen,
+		  PError		**error)
 {
-	struct sockaddr_storage	buffer;
-	socklen_t 		len;
-	PSocketAddress		*ret;
+	PErrorIO		sock_err;
+	struct sockaddr_storage sa;
+	socklen_t		optlen;
+	pssize			ret;
+	pint			err_code;
 
-	if (P_UNLIKELY (socket == NULL)) {
+	if (!socket || !address || !buffer) {
 		p_error_set_error_p (error,
 				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
 				     0,
 				     "Invalid input argument");
-		return NULL;
+		return -1;
 	}
 
-	len = sizeof (buffer);
+	if (!pp_socket_check (socket, error))
+		return -1;
 
-	if (P_UNLIKELY (getpeername (socket->fd, (struct sockaddr *) &buffer, &len) < 0)) {
+	if (!p_socket_address_to_native (address, &sa, sizeof (sa))) {
 		p_error_set_error_p (error,
-				     (pint) p_error_get_io_from_system (p_error_get_last_net ()),
-				     (pint) p_error_get_last_net (),
-				     "Failed to call getpeername() to get remote socket address");
-		return NULL;
+				     (pint) P_ERROR_IO_FAILED,
+				     0,
+				     "Failed to convert socket address to native structure");
+		return -1;
 	}
 
-#ifdef P_OS_SYLLABLE
-	/* Syllable has a bug with a wrong byte order for a TCP port,
-	 * as it only supports IPv4 we can easily fix it here. */
-	((struct sockaddr_in *) &buffer)->sin_port =
-			p_htons (((struct sockaddr_in *) &buffer)->sin_port);
+	optlen = (socklen_t) p_socket_address_get_native_size (address);
+
+	for (;;) {
+		if (socket->blocking &&
+		    p_socket_io_condition_wait (socket, P_SOCKET_IO_CONDITION_POLLOUT, error) == FALSE)
+			return -1;
+
+		if ((ret = sendto (socket->fd,
+				   buffer,
+				   (socklen_t) buflen,
+				   0,
+				   (struct sockaddr *) &sa,
+				   optlen)) < 0) {
+			err_code = p_error_get_last_net ();
+
+			if (P_UNLIKELY (socket->stats != NULL))
+				pp_socket_stats_update (socket, TRUE, -1, 0, err_code);
+
+#if !defined (P_OS_WIN) && defined (EINTR)
+			if (err_code == EINTR)
+				continue;
 #endif
+			sock_err = p_error_get_io_from_system (err_code);
 
-	ret = p_socket_address_new_from_native (&buffer, (psize) len);
+			if (socket->blocking && sock_err == P_ERROR_IO_WOULD_BLOCK)
+				continue;
 
-	if (P_UNLIKELY (ret == NULL))
-		p_error_set_error_p (error,
-				     (pint) P_ERROR_IO_FAILED,
-				     0,
-				     "Failed to create socket address from native structure");
+			pp_socket_set_error (socket,
+					     error,
+					     sock_err,
+					     err_code,
+					     "Failed to call sendto() on socket");
+
+			return -1;
+		}
+
+		break;
+	}
+
+	if (P_UNLIKELY (socket->stats != NULL))
+		pp_socket_stats_update (socket, TRUE, ret, 1, 0);
 
 	return ret;
 }
 
-P_LIB_API pboolean
-p_socket_is_connected (const PSocket *socket)
+P_LIB_API pssize
+p_socket_receive_vector (const PSocket		*socket,
+			 const PSocketVector	*vectors,
+			 psize			n_vectors,
+			 PError			**error)
 {
-	if (P_UNLIKELY (socket == NULL))
-		return FALSE;
+	if (P_UNLIKELY (socket == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
 
-	return socket->connected;
+	return pp_socket_receive_vector (socket, NULL, vectors, n_vectors, error);
 }
 
-P_LIB_API pboolean
-p_socket_is_closed (const PSocket *socket)
+P_LIB_API pssize
+p_socket_receive_vector_from (const PSocket		*socket,
+			      PSocketAddress		**address,
+			      const PSocketVector	*vectors,
+			      psize			n_vectors,
+			      PError			**error)
 {
-	if (P_UNLIKELY (socket == NULL))
-		return TRUE;
+	if (P_UNLIKELY (socket == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
 
-	return socket->closed;
+	return pp_socket_receive_vector (socket, address, vectors, n_vectors, error);
 }
 
-P_LIB_API pboolean
-p_socket_check_connect_result (PSocket  *socket,
-			       PError	**error)
+P_LIB_API pssize
+p_socket_send_vector (const PSocket		*socket,
+		      const PSocketVector	*vectors,
+		      psize			n_vectors,
+		      PError			**error)
 {
-	socklen_t	optlen;
-	pint		val;
-
 	if (P_UNLIKELY (socket == NULL)) {
 		p_error_set_error_p (error,
 				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
 				     0,
 				     "Invalid input argument");
-		return FALSE;
+		return -1;
 	}
 
-	optlen = sizeof (val);
+	return pp_socket_send_vector (socket, NULL, 0, vectors, n_vectors, error);
+}
 
-	if (P_UNLIKELY (getsockopt (socket->fd, SOL_SOCKET, SO_ERROR, (ppointer) &val, &optlen) < 0)) {
+P_LIB_API pssize
+p_socket_send_vector_to (const PSocket		*socket,
+			 PSocketAddress		*address,
+			 const PSocketVector	*vectors,
+			 psize			n_vectors,
+			 PError			**error)
+{
+	struct sockaddr_storage sa;
+
+	if (P_UNLIKELY (socket == NULL || address == NULL)) {
 		p_error_set_error_p (error,
-				     (pint) p_error_get_io_from_system (p_error_get_last_net ()),
-				     (pint) p_error_get_last_net (),
-				     "Failed to call getsockopt() to get connection status");
-		return FALSE;
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
 	}
 
-	if (P_UNLIKELY (val != 0))
+	if (P_UNLIKELY (p_socket_address_to_native (address, &sa, sizeof (sa)) == FALSE)) {
 		p_error_set_error_p (error,
-				     (pint) p_error_get_io_from_system (val),
-				     val,
-				     "Error in socket layer");
-
-	socket->connected = (val == 0);
+				     (pint) P_ERROR_IO_FAILED,
+				     0,
+				     "Failed to convert socket address to native structure");
+		return -1;
+	}
 
-	return (val == 0);
+	return pp_socket_send_vector (socket,
+				      &sa,
+				      (socklen_t) p_socket_address_get_native_size (address),
+				      vectors,
+				      n_vectors,
+				      error);
 }
 
-P_LIB_API void
-p_socket_set_keepalive (PSocket		*socket,
-			pboolean	keepalive)
+P_LIB_API pssize
+p_socket_receive_many (const PSocket	*socket,
+		       PSocketMessage	*messages,
+		       psize		n_messages,
+		       PError		**error)
 {
-#ifdef P_OS_WIN
-	pchar value;
-#else
-	pint value;
-#endif
-
-	if (P_UNLIKELY (socket == NULL))
-		return;
-
-	if (socket->keepalive == (puint) !!keepalive)
-		return;
+	PErrorIO	sock_err;
+	pssize		ret;
+	pint		err_code;
 
-#ifdef P_OS_WIN
-	value = !! (pchar) keepalive;
-#else
-	value = !! (pint) keepalive;
-#endif
-	if (setsockopt (socket->fd, SOL_SOCKET, SO_KEEPALIVE, &value, sizeof (value)) < 0) {
-		P_WARNING ("PSocket::p_socket_set_keepalive: setsockopt() with SO_KEEPALIVE failed");
-		return;
+	if (P_UNLIKELY (socket == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
 	}
 
-	socket->keepalive = !! (pint) keepalive;
-}
+	if (P_UNLIKELY (pp_socket_check_messages (messages, n_messages, FALSE, error) == FALSE))
+		return -1;
 
-P_LIB_API void
-p_socket_set_blocking (PSocket	*socket,
-		       pboolean	blocking)
-{
-	if (P_UNLIKELY (socket == NULL))
-		return;
+	if (P_UNLIKELY (pp_socket_check (socket, error) == FALSE))
+		return -1;
 
-	socket->blocking = !! blocking;
-}
+	for (;;) {
+		if (socket->blocking &&
+		    p_socket_io_condition_wait (socket,
+						P_SOCKET_IO_CONDITION_POLLIN,
+						error) == FALSE)
+			return -1;
 
-P_LIB_API void
-p_socket_set_listen_backlog (PSocket	*socket,
-			     pint	backlog)
-{
-	if (P_UNLIKELY (socket == NULL || socket->listening))
-		return;
+		if ((ret = pp_socket_receive_many_once (socket, messages, n_messages, &err_code)) < 0) {
+#if !defined (P_OS_WIN) && defined (EINTR)
+			if (err_code == EINTR)
+				continue;
+#endif
+			sock_err = p_error_get_io_from_system (err_code);
 
-	socket->listen_backlog = backlog;
-}
+			if (socket->blocking && sock_err == P_ERROR_IO_WOULD_BLOCK)
+				continue;
 
-P_LIB_API void
-p_socket_set_timeout (PSocket	*socket,
-		      pint	timeout)
-{
-	if (P_UNLIKELY (socket == NULL))
-		return;
+			pp_socket_set_error (socket,
+					     error,
+					     sock_err,
+					     err_code,
+#ifdef PLIBSYS_HAS_MMSG
+					     "Failed to call recvmmsg() on socket");
+#else
+					     "Failed to call recvfrom() on socket");
+#endif
 
-	if (timeout < 0)
-		timeout = 0;
+			return -1;
+		}
 
-	socket->timeout = timeout;
+		break;
+	}
+
+	return ret;
 }
 
-P_LIB_API pboolean
-p_socket_bind (const PSocket	*socket,
-	       PSocketAddress	*address,
-	       pboolean		allow_reuse,
-	       PError		**error)
+P_LIB_API pssize
+p_socket_send_many (const PSocket	*socket,
+		    PSocketMessage	*messages,
+		    psize		n_messages,
+		    PError		**error)
 {
-	struct sockaddr_storage	addr;
-
-#ifdef SO_REUSEPORT
-	pboolean		reuse_port;
-#endif
-
-#ifdef P_OS_WIN
-	pchar			value;
-#else
-	pint			value;
-#endif
+	PErrorIO	sock_err;
+	pssize		ret;
+	pint		err_code;
 
-	if (P_UNLIKELY (socket == NULL || address == NULL)) {
+	if (P_UNLIKELY (socket == NULL)) {
 		p_error_set_error_p (error,
 				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
 				     0,
 				     "Invalid input argument");
-		return FALSE;
+		return -1;
 	}
 
+	if (P_UNLIKELY (pp_socket_check_messages (messages, n_messages, TRUE, error) == FALSE))
+		return -1;
+
 	if (P_UNLIKELY (pp_socket_check (socket, error) == FALSE))
-		return FALSE;
+		return -1;
 
-	/* Windows allows to reuse the same address even for an active TCP
-	 * connection, that's why on Windows we should use SO_REUSEADDR only
-	 * for UDP sockets, UNIX doesn't have such behavior
-	 *
-	 * Ignore errors here, the only likely error is "not supported", and
-	 * this is a "best effort" thing mainly */
+	for (;;) {
+		if (socket->blocking &&
+		    p_socket_io_condition_wait (socket,
+						P_SOCKET_IO_CONDITION_POLLOUT,
+						error) == FALSE)
+			return -1;
 
-#ifdef P_OS_WIN
-	value = !! (pchar) (allow_reuse && (socket->type == P_SOCKET_TYPE_DATAGRAM));
-#else
-	value = !! (pint) allow_reuse;
+		if ((ret = pp_socket_send_many_once (socket, messages, n_messages, &err_code)) < 0) {
+#if !defined (P_OS_WIN) && defined (EINTR)
+			if (err_code == EINTR)
+				continue;
 #endif
+			sock_err = p_error_get_io_from_system (err_code);
 
-	if (setsockopt (socket->fd, SOL_SOCKET, SO_REUSEADDR, &value, sizeof (value)) < 0)
-		P_WARNING ("PSocket::p_socket_bind: setsockopt() with SO_REUSEADDR failed");
-
-#ifdef SO_REUSEPORT
-	reuse_port = allow_reuse && (socket->type == P_SOCKET_TYPE_DATAGRAM);
-
-#  ifdef P_OS_WIN
-	value = !! (pchar) reuse_port;
-#  else
-	value = !! (pint) reuse_port;
-#  endif
+			if (socket->blocking && sock_err == P_ERROR_IO_WOULD_BLOCK)
+				continue;
 
-	if (setsockopt (socket->fd, SOL_SOCKET, SO_REUSEPORT, &value, sizeof (value)) < 0)
-		P_WARNING ("PSocket::p_socket_bind: setsockopt() with SO_REUSEPORT failed");
+			pp_socket_set_error (socket,
+					     error,
+					     sock_err,
+					     err_code,
+#ifdef PLIBSYS_HAS_MMSG
+					     "Failed to call sendmmsg() on socket");
+#else
+					     "Failed to call sendto() on socket");
 #endif
 
-	if (P_UNLIKELY (p_socket_address_to_native (address, &addr, sizeof (addr)) == FALSE)) {
-		p_error_set_error_p (error,
-				     (pint) P_ERROR_IO_FAILED,
-				     0,
-				     "Failed to convert socket address to native structure");
-		return FALSE;
-	}
+			return -1;
+		}
 
-	if (P_UNLIKELY (bind (socket->fd,
-			      (struct sockaddr *) &addr,
-			      (socklen_t) p_socket_address_get_native_size (address)) < 0)) {
-		p_error_set_error_p (error,
-				     (pint) p_error_get_io_from_system (p_error_get_last_net ()),
-				     (pint) p_error_get_last_net (),
-				     "Failed to call bind() on socket");
-		return FALSE;
+		break;
 	}
 
-	return TRUE;
+	return ret;
 }
 
-P_LIB_API pboolean
-p_socket_connect (PSocket		*socket,
-		  PSocketAddress	*address,
-		  PError		**error)
+P_LIB_API pssize
+p_socket_send_segmented (const PSocket	*socket,
+			 PSocketAddress	*address,
+			 const pchar	*buffer,
+			 psize		buflen,
+			 psize		segment_size,
+			 PError		**error)
 {
-	struct sockaddr_storage	buffer;
-	pint			err_code;
-	pint			conn_result;
+	struct sockaddr_storage	sa;
+	socklen_t		optlen = 0;
+	psize			sent   = 0;
+	psize			chunk;
+	pssize			ret;
+#ifdef PLIBSYS_HAS_UDP_GSO
 	PErrorIO		sock_err;
+	psize			max_chunk;
+	pint			err_code;
+#endif
 
-	if (P_UNLIKELY (socket == NULL || address == NULL)) {
+	if (P_UNLIKELY (socket == NULL || buffer == NULL || buflen == 0 ||
+			segment_size == 0 || segment_size > P_SOCKET_MAX_SEGMENT_SIZE)) {
 		p_error_set_error_p (error,
 				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
 				     0,
 				     "Invalid input argument");
-		return FALSE;
+		return -1;
 	}
 
 	if (P_UNLIKELY (pp_socket_check (socket, error) == FALSE))
-		return FALSE;
+		return -1;
 
-	if (P_UNLIKELY (p_socket_address_to_native (address, &buffer, sizeof (buffer)) == FALSE)) {
-		p_error_set_error_p (error,
-				     (pint) P_ERROR_IO_FAILED,
-				     0,
-				     "Failed to convert socket address to native structure");
-		return FALSE;
+	if (address != NULL) {
+		if (P_UNLIKELY (p_socket_address_to_native (address, &sa, sizeof (sa)) == FALSE)) {
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IO_FAILED,
+					     0,
+					     "Failed to convert socket address to native structure");
+			return -1;
+		}
+
+		optlen = (socklen_t) p_socket_address_get_native_size (address);
 	}
 
-#if !defined (P_OS_WIN) && defined (EINTR)
-	for (;;) {
-		conn_result = connect (socket->fd, (struct sockaddr *) &buffer,
-				       (socklen_t) p_socket_address_get_native_size (address));
+#ifdef PLIBSYS_HAS_UDP_GSO
+	max_chunk = P_SOCKET_MAX_SEGMENT_SIZE / segment_size;
+
+	if (max_chunk > P_SOCKET_GSO_MAX_SEGMENTS)
+		max_chunk = P_SOCKET_GSO_MAX_SEGMENTS;
 
-		if (P_LIKELY (conn_result == 0))
-			break;
+	max_chunk *= segment_size;
 
-		err_code = p_error_get_last_net ();
+	/* A single datagram goes the usual way */
+	while (buflen - sent > segment_size) {
+		chunk = buflen - sent < max_chunk ? buflen - sent : max_chunk;
 
-		if (err_code == EINTR)
-			continue;
-		else
-			break;
-	}
-#else
-	conn_result = connect (socket->fd, (struct sockaddr *) &buffer,
-			       (pint) p_socket_address_get_native_size (address));
+		if (socket->blocking &&
+		    p_socket_io_condition_wait (socket,
+						P_SOCKET_IO_CONDITION_POLLOUT,
+						sent == 0 ? error : NULL) == FALSE)
+			return sent == 0 ? -1 : (pssize) sent;
+
+		if ((ret = pp_socket_send_gso_once (socket,
+						    address != NULL ? &sa : NULL,
+						    optlen,
+						    buffer + sent,
+						    chunk,
+						    segment_size,
+						    &err_code)) < 0) {
+			if (P_UNLIKELY (socket->stats != NULL))
+				pp_socket_stats_update (socket, TRUE, -1, 0, err_code);
 
-	if (conn_result != 0)
-		err_code = p_error_get_last_net ();
-#endif
+			if (err_code == EINTR)
+				continue;
 
-	if (conn_result == 0) {
-		socket->connected = TRUE;
-		return TRUE;
-	}
+			if (pp_socket_gso_is_unsupported (err_code))
+				break;
 
-	sock_err = p_error_get_io_from_system (err_code);
+			sock_err = p_error_get_io_from_system (err_code);
 
-	if (P_LIKELY (sock_err == P_ERROR_IO_WOULD_BLOCK || sock_err == P_ERROR_IO_IN_PROGRESS)) {
-		if (socket->blocking) {
-			if (p_socket_io_condition_wait (socket,
-							P_SOCKET_IO_CONDITION_POLLOUT,
-							error) == TRUE &&
-			    p_socket_check_connect_result (socket, error) == TRUE) {
-				socket->connected = TRUE;
-				return TRUE;
-			}
-		} else
-			p_error_set_error_p (error,
-					     (pint) sock_err,
+			if (socket->blocking && sock_err == P_ERROR_IO_WOULD_BLOCK)
+				continue;
+
+			if (sent > 0)
+				return (pssize) sent;
+
+			pp_socket_set_error (socket,
+					     error,
+					     sock_err,
 					     err_code,
-					     "Couldn't block non-blocking socket");
-	} else
-		p_error_set_error_p (error,
-				     (pint) sock_err,
-				     err_code,
-				     "Failed to call connect() on socket");
+					     "Failed to call sendmsg() on socket");
 
-	return FALSE;
-}
+			return -1;
+		}
 
-P_LIB_API pboolean
-p_socket_listen (PSocket	*socket,
-		 PError		**error)
-{
-	if (P_UNLIKELY (socket == NULL)) {
-		p_error_set_error_p (error,
-				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
-				     0,
-				     "Invalid input argument");
-		return FALSE;
+		if (P_UNLIKELY (socket->stats != NULL))
+			pp_socket_stats_update (socket, TRUE, ret, (chunk + segment_size - 1) / segment_size, 0);
+
+		sent += (psize) ret;
 	}
+#endif
 
-	if (P_UNLIKELY (pp_socket_check (socket, error) == FALSE))
-		return FALSE;
+	while (sent < buflen) {
+		chunk = buflen - sent < segment_size ? buflen - sent : segment_size;
 
-	if (P_UNLIKELY (listen (socket->fd, socket->listen_backlog) < 0)) {
-		p_error_set_error_p (error,
-				     (pint) p_error_get_io_from_system (p_error_get_last_net ()),
-				     (pint) p_error_get_last_net (),
-				     "Failed to call listen() on socket");
-		return FALSE;
+		if (address != NULL)
+			ret = p_socket_send_to (socket, address, buffer + sent, chunk, sent == 0 ? error : NULL);
+		else
+			ret = p_socket_send (socket, buffer + sent, chunk, sent == 0 ? error : NULL);
+
+		if (ret < 0)
+			return sent == 0 ? -1 : (pssize) sent;
+
+		sent += (psize) ret;
 	}
 
-	socket->listening = TRUE;
-	return TRUE;
+	return (pssize) sent;
 }
 
-P_LIB_API PSocket *
-p_socket_accept (const PSocket	*socket,
-		 PError		**error)
+P_LIB_API pssize
+p_socket_receive_segmented (const PSocket	*socket,
+			    PSocketAddress	**address,
+			    pchar		*buffer,
+			    psize		buflen,
+			    psize		*segment_size,
+			    PError		**error)
 {
-	PSocket		*ret;
-	PErrorIO	sock_err;
-	pint		res;
-	pint		err_code;
-#ifndef P_OS_WIN
-	pint		flags;
+	struct sockaddr_storage	sa;
+	socklen_t		optlen;
+	pssize			ret;
+#ifdef PLIBSYS_HAS_UDP_GSO
+	union {
+		struct cmsghdr	header;
+		pchar		buf[CMSG_SPACE (sizeof (pint))];
+	}			control;
+	struct msghdr		msg;
+	struct iovec		iov;
+	struct cmsghdr		*cmsg;
+	PErrorIO		sock_err;
+	pint			err_code;
+	pint			gro_size;
 #endif
 
-	if (P_UNLIKELY (socket == NULL)) {
+	if (P_UNLIKELY (socket == NULL || buffer == NULL || buflen == 0 || segment_size == NULL)) {
 		p_error_set_error_p (error,
 				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
 				     0,
 				     "Invalid input argument");
-		return NULL;
+		return -1;
 	}
 
+#ifndef PLIBSYS_HAS_UDP_GSO
+	if ((ret = pp_socket_receive_from_native (socket, &sa, &optlen, buffer, buflen, error)) < 0)
+		return -1;
+
+	*segment_size = (psize) ret;
+#else
 	if (P_UNLIKELY (pp_socket_check (socket, error) == FALSE))
-		return NULL;
+		return -1;
 
 	for (;;) {
+		memset (&msg, 0, sizeof (msg));
+
+		iov.iov_base = buffer;
+		iov.iov_len  = buflen;
+
+		msg.msg_name       = &sa;
+		msg.msg_namelen    = sizeof (sa);
+		msg.msg_iov        = &iov;
+		msg.msg_iovlen     = 1;
+		msg.msg_control    = control.buf;
+		msg.msg_controllen = sizeof (control.buf);
+
 		if (socket->blocking &&
 		    p_socket_io_condition_wait (socket,
 						P_SOCKET_IO_CONDITION_POLLIN,
 						error) == FALSE)
-			return NULL;
+			return -1;
 
-		if ((res = (pint) accept (socket->fd, NULL, 0)) < 0) {
+		if ((ret = recvmsg (socket->fd, &msg, 0)) < 0) {
 			err_code = p_error_get_last_net ();
-#if !defined (P_OS_WIN) && defined (EINTR)
-			if (p_error_get_last_net () == EINTR)
+
+			if (P_UNLIKELY (socket->stats != NULL))
+				pp_socket_stats_update (socket, FALSE, -1, 0, err_code);
+
+			if (err_code == EINTR)
 				continue;
-#endif
+
 			sock_err = p_error_get_io_from_system (err_code);
 
 			if (socket->blocking && sock_err == P_ERROR_IO_WOULD_BLOCK)
 				continue;
 
-			p_error_set_error_p (error,
-					     (pint) sock_err,
+			pp_socket_set_error (socket,
+					     error,
+					     sock_err,
 					     err_code,
-					     "Failed to call accept() on socket");
+					     "Failed to call recvmsg() on socket");
 
-			return NULL;
+			return -1;
 		}
 
 		break;
 	}
 
-#ifdef P_OS_WIN
-	/* The socket inherits the accepting sockets event mask and even object,
-	 * we need to remove that */
-	WSAEventSelect (res, NULL, 0);
-#else
-	flags = fcntl (res, F_GETFD, 0);
+	optlen        = msg.msg_namelen;
+	*segment_size = (psize) ret;
 
-	if (P_LIKELY (flags != -1 && (flags & FD_CLOEXEC) == 0)) {
-		flags |= FD_CLOEXEC;
+	for (cmsg = CMSG_FIRSTHDR (&msg); cmsg != NULL; cmsg = CMSG_NXTHDR (&msg, cmsg)) {
+		if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO) {
+			memcpy (&gro_size, CMSG_DATA (cmsg), sizeof (pint));
 
-		if (P_UNLIKELY (fcntl (res, F_SETFD, flags) < 0))
-			P_WARNING ("PSocket::p_socket_accept: fcntl() with FD_CLOEXEC failed");
+			if (gro_size > 0 && (psize) gro_size < (psize) ret)
+				*segment_size = (psize) gro_size;
+		}
 	}
+
+	if (P_UNLIKELY (socket->stats != NULL))
+		pp_socket_stats_update (socket, FALSE, ret, ret == 0 ? 1 : ((psize) ret + *segment_size - 1) / *segment_size, 0);
 #endif
 
-	if (P_UNLIKELY ((ret = p_socket_new_from_fd (res, error)) == NULL)) {
-		if (P_UNLIKELY (p_sys_close (res) != 0))
-			P_WARNING ("PSocket::p_socket_accept: p_sys_close() failed");
-	} else
-		ret->protocol = socket->protocol;
+	if (address != NULL)
+		*address = p_socket_address_new_from_native (&sa, optlen);
 
 	return ret;
 }
 
+P_LIB_API pboolean
+p_socket_set_timestamping (const PSocket	*socket,
+			   pint			flags,
+			   PError		**error)
+{
+#ifdef P_SOCKET_TIMESTAMP_MSG
+	pint	optname;
+	pint	value;
+#endif
+
+	if (P_UNLIKELY (socket == NULL || (flags & ~(P_SOCKET_TIMESTAMP_RX_SOFTWARE |
+						     P_SOCKET_TIMESTAMP_RX_HARDWARE |
+						     P_SOCKET_TIMESTAMP_TX_SOFTWARE |
+						     P_SOCKET_TIMESTAMP_TX_HARDWARE)) != 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (pp_socket_check (socket, error) == FALSE))
+		return FALSE;
+
+#if defined (PLIBSYS_HAS_SO_TIMESTAMPING)
+	optname = SO_TIMESTAMPING;
+	value   = 0;
+
+	if (flags & P_SOCKET_TIMESTAMP_RX_SOFTWARE)
+		value |= SOF_TIMESTAMPING_RX_SOFTWARE;
+
+	if (flags & P_SOCKET_TIMESTAMP_RX_HARDWARE)
+		value |= SOF_TIMESTAMPING_RX_HARDWARE;
+
+	if (flags & P_SOCKET_TIMESTAMP_TX_SOFTWARE)
+		value |= SOF_TIMESTAMPING_TX_SOFTWARE;
+
+	if (flags & P_SOCKET_TIMESTAMP_TX_HARDWARE)
+		value |= SOF_TIMESTAMPING_TX_HARDWARE;
+
+	/* Generation flags above, reporting ones below */
+	if (flags & (P_SOCKET_TIMESTAMP_RX_SOFTWARE | P_SOCKET_TIMESTAMP_TX_SOFTWARE))
+		value |= SOF_TIMESTAMPING_SOFTWARE;
+
+	if (flags & (P_SOCKET_TIMESTAMP_RX_HARDWARE | P_SOCKET_TIMESTAMP_TX_HARDWARE))
+		value |= SOF_TIMESTAMPING_RAW_HARDWARE;
+
+	/* Numbers the sent packets and doesn't loop their data back along with
+	 * the timestamps */
+	if (flags & (P_SOCKET_TIMESTAMP_TX_SOFTWARE | P_SOCKET_TIMESTAMP_TX_HARDWARE))
+		value |= SOF_TIMESTAMPING_OPT_ID | SOF_TIMESTAMPING_OPT_TSONLY;
+#elif defined (PLIBSYS_HAS_SO_TIMESTAMP)
+	if (P_UNLIKELY ((flags & ~P_SOCKET_TIMESTAMP_RX_SOFTWARE) != 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NOT_SUPPORTED,
+				     0,
+				     "Only software receive timestamps are supported on this platform");
+		return FALSE;
+	}
+
+	optname = SO_TIMESTAMP;
+	value   = flags != 0 ? 1 : 0;
+#else
+	if (flags == 0)
+		return TRUE;
+
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IO_NOT_SUPPORTED,
+			     0,
+			     "Packet timestamps are not supported");
+	return FALSE;
+#endif
+
+#ifdef P_SOCKET_TIMESTAMP_MSG
+	if (P_UNLIKELY (setsockopt (socket->fd,
+				    SOL_SOCKET,
+				    optname,
+				    (pconstpointer) &value,
+				    sizeof (value)) != 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_io_from_system (p_error_get_last_net ()),
+				     (pint) p_error_get_last_net (),
+				     "Failed to call setsockopt() on socket to set timestamping");
+		return FALSE;
+	}
+
+	return TRUE;
+#endif
+}
+
 P_LIB_API pssize
-p_socket_receive (const PSocket	*socket,
-		  pchar		*buffer,
-		  psize		buflen,
-		  PError	**error)
+p_socket_receive_from_timestamped (const PSocket	*socket,
+				   PSocketAddress	**address,
+				   pchar		*buffer,
+				   psize		buflen,
+				   PSocketTimestamps	*timestamps,
+				   PError		**error)
 {
-	PErrorIO	sock_err;
-	pssize		ret;
-	pint		err_code;
+	struct sockaddr_storage	sa;
+	socklen_t		optlen;
+	pssize			ret;
+#ifdef P_SOCKET_TIMESTAMP_MSG
+	PSocketTimestampControl	control;
+	struct msghdr		msg;
+	struct iovec		iov;
+	PErrorIO		sock_err;
+	pint			err_code;
+#endif
 
-	if (P_UNLIKELY (socket == NULL || buffer == NULL)) {
+	if (P_UNLIKELY (socket == NULL || buffer == NULL || buflen == 0 || timestamps == NULL)) {
 		p_error_set_error_p (error,
 				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
 				     0,
@@ -1095,32 +3865,53 @@ p_socket_receive (const PSocket	*socket,
 		return -1;
 	}
 
+	memset (timestamps, 0, sizeof (PSocketTimestamps));
+
+#ifndef P_SOCKET_TIMESTAMP_MSG
+	if ((ret = pp_socket_receive_from_native (socket, &sa, &optlen, buffer, buflen, error)) < 0)
+		return -1;
+#else
 	if (P_UNLIKELY (pp_socket_check (socket, error) == FALSE))
 		return -1;
 
 	for (;;) {
+		memset (&msg, 0, sizeof (msg));
+
+		iov.iov_base = buffer;
+		iov.iov_len  = buflen;
+
+		msg.msg_name       = &sa;
+		msg.msg_namelen    = sizeof (sa);
+		msg.msg_iov        = &iov;
+		msg.msg_iovlen     = 1;
+		msg.msg_control    = control.buf;
+		msg.msg_controllen = sizeof (control.buf);
+
 		if (socket->blocking &&
 		    p_socket_io_condition_wait (socket,
 						P_SOCKET_IO_CONDITION_POLLIN,
 						error) == FALSE)
 			return -1;
 
-		if ((ret = recv (socket->fd, buffer, (socklen_t) buflen, 0)) < 0) {
+		if ((ret = recvmsg (socket->fd, &msg, 0)) < 0) {
 			err_code = p_error_get_last_net ();
 
-#if !defined (P_OS_WIN) && defined (EINTR)
+			if (P_UNLIKELY (socket->stats != NULL))
+				pp_socket_stats_update (socket, FALSE, -1, 0, err_code);
+
 			if (err_code == EINTR)
 				continue;
-#endif
+
 			sock_err = p_error_get_io_from_system (err_code);
 
 			if (socket->blocking && sock_err == P_ERROR_IO_WOULD_BLOCK)
 				continue;
 
-			p_error_set_error_p (error,
-					     (pint) sock_err,
+			pp_socket_set_error (socket,
+					     error,
+					     sock_err,
 					     err_code,
-					     "Failed to call recv() on socket");
+					     "Failed to call recvmsg() on socket");
 
 			return -1;
 		}
@@ -1128,87 +3919,172 @@ p_socket_receive (const PSocket	*socket,
 		break;
 	}
 
+	optlen = msg.msg_namelen;
+
+	pp_socket_timestamps_from_control (&msg, timestamps);
+
+	if (P_UNLIKELY (socket->stats != NULL))
+		pp_socket_stats_update (socket, FALSE, ret, 1, 0);
+#endif
+
+	pp_socket_timestamps_finish (timestamps);
+
+	if (address != NULL)
+		*address = p_socket_address_new_from_native (&sa, optlen);
+
 	return ret;
 }
 
-P_LIB_API pssize
-p_socket_receive_from (const PSocket	*socket,
-		       PSocketAddress	**address,
-		       pchar		*buffer,
-		       psize		buflen,
-		       PError		**error)
+P_LIB_API pboolean
+p_socket_get_tx_timestamp (const PSocket	*socket,
+			   PSocketTimestamps	*timestamps,
+			   PError		**error)
 {
-	PErrorIO		sock_err;
-	struct sockaddr_storage sa;
-	socklen_t		optlen;
-	pssize			ret;
-	pint			err_code;
+#ifdef PLIBSYS_HAS_SO_TIMESTAMPING
+	PSocketTimestampControl		control;
+	struct sock_extended_err	serr;
+	struct msghdr			msg;
+	struct cmsghdr			*cmsg;
+	pboolean			found;
+	pint				err_code;
+#endif
 
-	if (P_UNLIKELY (socket == NULL || buffer == NULL || buflen == 0)) {
+	if (P_UNLIKELY (socket == NULL || timestamps == NULL)) {
 		p_error_set_error_p (error,
 				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
 				     0,
 				     "Invalid input argument");
-		return -1;
+		return FALSE;
 	}
 
 	if (P_UNLIKELY (pp_socket_check (socket, error) == FALSE))
-		return -1;
+		return FALSE;
 
-	optlen = sizeof (sa);
+#ifndef PLIBSYS_HAS_SO_TIMESTAMPING
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IO_NOT_SUPPORTED,
+			     0,
+			     "Transmit timestamps are not supported");
+	return FALSE;
+#else
+	for (found = FALSE; found == FALSE; ) {
+		memset (&msg, 0, sizeof (msg));
+		memset (timestamps, 0, sizeof (PSocketTimestamps));
 
-	for (;;) {
-		if (socket->blocking &&
-		    p_socket_io_condition_wait (socket,
-						P_SOCKET_IO_CONDITION_POLLIN,
-						error) == FALSE)
-			return -1;
+		/* The looped back data (if any) is not needed, only the headers */
+		msg.msg_control    = control.buf;
+		msg.msg_controllen = sizeof (control.buf);
 
-		if ((ret = recvfrom (socket->fd,
-				     buffer,
-				     (socklen_t) buflen,
-				     0,
-				     (struct sockaddr *) &sa,
-				     &optlen)) < 0) {
+		if (recvmsg (socket->fd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
 			err_code = p_error_get_last_net ();
 
-#if !defined (P_OS_WIN) && defined (EINTR)
 			if (err_code == EINTR)
 				continue;
-#endif
-			sock_err = p_error_get_io_from_system (err_code);
 
-			if (socket->blocking && sock_err == P_ERROR_IO_WOULD_BLOCK)
+			pp_socket_set_error (socket,
+					     error,
+					     p_error_get_io_from_system (err_code),
+					     err_code,
+					     "Failed to call recvmsg() on socket to get timestamp");
+			return FALSE;
+		}
+
+		pp_socket_timestamps_from_control (&msg, timestamps);
+
+		/* Other queued errors (i.e. ICMP ones) are skipped */
+		for (cmsg = CMSG_FIRSTHDR (&msg); cmsg != NULL; cmsg = CMSG_NXTHDR (&msg, cmsg)) {
+			if (!((cmsg->cmsg_level == IPPROTO_IP && cmsg->cmsg_type == IP_RECVERR) ||
+			      (cmsg->cmsg_level == IPPROTO_IPV6 && cmsg->cmsg_type == IPV6_RECVERR)) ||
+			    cmsg->cmsg_len < CMSG_LEN (sizeof (serr)))
 				continue;
 
-			p_error_set_error_p (error,
-					     (pint) sock_err,
-					     err_code,
-					     "Failed to call recvfrom() on socket");
+			memcpy (&serr, CMSG_DATA (cmsg), sizeof (serr));
+
+			if (serr.ee_errno == ENOMSG && serr.ee_origin == SO_EE_ORIGIN_TIMESTAMPING) {
+				timestamps->id = serr.ee_data;
+				found          = TRUE;
+			}
+		}
+	}
+
+	pp_socket_timestamps_finish (timestamps);
+
+	return TRUE;
+#endif
+}
+
+P_LIB_API pssize
+p_socket_send_file (const PSocket	*socket,
+		    const pchar		*path,
+		    puint64		offset,
+		    psize		length,
+		    PError		**error)
+{
+	PSocketFileHandle	file;
+	pssize			ret;
+
+	if (P_UNLIKELY (socket == NULL || path == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
 
-			return -1;
-		}
+	if (P_UNLIKELY (pp_socket_check (socket, error) == FALSE))
+		return -1;
 
-		break;
+#ifdef P_OS_WIN
+	file = CreateFileA (path,
+			    GENERIC_READ,
+			    FILE_SHARE_READ,
+			    NULL,
+			    OPEN_EXISTING,
+			    FILE_FLAG_SEQUENTIAL_SCAN,
+			    NULL);
+
+	if (P_UNLIKELY (file == INVALID_HANDLE_VALUE)) {
+#else
+	if (P_UNLIKELY ((file = open (path, O_RDONLY)) < 0)) {
+#endif
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to open file");
+		return -1;
 	}
 
-	if (address != NULL)
-		*address = p_socket_address_new_from_native (&sa, optlen);
+	ret = pp_socket_send_file (socket, file, offset, length, error);
+
+#ifdef P_OS_WIN
+	CloseHandle (file);
+#else
+	p_sys_close (file);
+#endif
 
 	return ret;
 }
 
 P_LIB_API pssize
-p_socket_send (const PSocket	*socket,
-	       const pchar	*buffer,
-	       psize		buflen,
-	       PError		**error)
+p_socket_send_fds (const PSocket	*socket,
+		   const pchar		*buffer,
+		   psize		buflen,
+		   const pint		*fds,
+		   psize		n_fds,
+		   PError		**error)
 {
-	PErrorIO	sock_err;
-	pssize		ret;
-	pint		err_code;
+#ifdef PLIBSYS_HAS_SCM_RIGHTS
+	PSocketFdsControl	control;
+	struct msghdr		msg;
+	struct iovec		iov;
+	struct cmsghdr		*cmsg;
+	PErrorIO		sock_err;
+	pssize			ret;
+	pint			err_code;
+#endif
 
-	if (P_UNLIKELY (socket == NULL || buffer == NULL || buflen == 0)) {
+	if (P_UNLIKELY (socket == NULL || buffer == NULL || buflen == 0 ||
+			fds == NULL || n_fds == 0 || n_fds > P_SOCKET_MAX_FDS)) {
 		p_error_set_error_p (error,
 				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
 				     0,
@@ -1219,6 +4095,40 @@ p_socket_send (const PSocket	*socket,
 	if (P_UNLIKELY (pp_socket_check (socket, error) == FALSE))
 		return -1;
 
+#ifndef PLIBSYS_HAS_SCM_RIGHTS
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IO_NOT_SUPPORTED,
+			     0,
+			     "Passing descriptors is not supported");
+	return -1;
+#else
+	if (P_UNLIKELY (socket->family != P_SOCKET_FAMILY_UNIX)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NOT_SUPPORTED,
+				     0,
+				     "Descriptors can be passed only through local sockets");
+		return -1;
+	}
+
+	memset (&msg, 0, sizeof (msg));
+	memset (&control, 0, sizeof (control));
+
+	iov.iov_base = (ppointer) buffer;
+	iov.iov_len  = buflen;
+
+	msg.msg_iov        = &iov;
+	msg.msg_iovlen     = 1;
+	msg.msg_control    = control.buf;
+	msg.msg_controllen = CMSG_SPACE (sizeof (pint) * n_fds);
+
+	cmsg = CMSG_FIRSTHDR (&msg);
+
+	cmsg->cmsg_level = SOL_SOCKET;
+	cmsg->cmsg_type  = SCM_RIGHTS;
+	cmsg->cmsg_len   = CMSG_LEN (sizeof (pint) * n_fds);
+
+	memcpy (CMSG_DATA (cmsg), fds, sizeof (pint) * n_fds);
+
 	for (;;) {
 		if (socket->blocking &&
 		    p_socket_io_condition_wait (socket,
@@ -1226,25 +4136,25 @@ p_socket_send (const PSocket	*socket,
 						error) == FALSE)
 			return -1;
 
-		if ((ret = send (socket->fd,
-				 buffer,
-				 (socklen_t) buflen,
-				 P_SOCKET_DEFAULT_SEND_FLAGS)) < 0) {
+		if ((ret = sendmsg (socket->fd, &msg, P_SOCKET_DEFAULT_SEND_FLAGS)) < 0) {
 			err_code = p_error_get_last_net ();
 
-#if !defined (P_OS_WIN) && defined (EINTR)
+			if (P_UNLIKELY (socket->stats != NULL))
+				pp_socket_stats_update (socket, TRUE, -1, 0, err_code);
+
 			if (err_code == EINTR)
 				continue;
-#endif
+
 			sock_err = p_error_get_io_from_system (err_code);
 
 			if (socket->blocking && sock_err == P_ERROR_IO_WOULD_BLOCK)
 				continue;
 
-			p_error_set_error_p (error,
-					     (pint) sock_err,
+			pp_socket_set_error (socket,
+					     error,
+					     sock_err,
 					     err_code,
-					     "Failed to call send() on socket");
+					     "Failed to call sendmsg() on socket");
 
 			return -1;
 		}
@@ -1252,23 +4162,40 @@ p_socket_send (const PSocket	*socket,
 		break;
 	}
 
+	if (P_UNLIKELY (socket->stats != NULL))
+		pp_socket_stats_update (socket, TRUE, ret, 1, 0);
+
 	return ret;
+#endif
 }
 
 P_LIB_API pssize
-p_socket_send_to (const PSocket		*socket,
-		  PSocketAddress	*address,
-		  const pchar		*buffer,
-		  psize			buflen,
-		  PError		**error)
+p_socket_receive_fds (const PSocket	*socket,
+		      pchar		*buffer,
+		      psize		buflen,
+		      pint		*fds,
+		      psize		*n_fds,
+		      PError		**error)
 {
+#ifdef PLIBSYS_HAS_SCM_RIGHTS
+	PSocketFdsControl	control;
+	struct msghdr		msg;
+	struct iovec		iov;
+	struct cmsghdr		*cmsg;
 	PErrorIO		sock_err;
-	struct sockaddr_storage sa;
-	socklen_t		optlen;
 	pssize			ret;
+	psize			count;
+	psize			received;
+	psize			i;
 	pint			err_code;
+	pint			fd;
+#  ifndef MSG_CMSG_CLOEXEC
+	pint			flags;
+#  endif
+#endif
 
-	if (!socket || !address || !buffer) {
+	if (P_UNLIKELY (socket == NULL || buffer == NULL || buflen == 0 ||
+			fds == NULL || n_fds == NULL)) {
 		p_error_set_error_p (error,
 				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
 				     0,
@@ -1276,45 +4203,66 @@ p_socket_send_to (const PSocket		*socket,
 		return -1;
 	}
 
-	if (!pp_socket_check (socket, error))
+	if (P_UNLIKELY (pp_socket_check (socket, error) == FALSE))
 		return -1;
 
-	if (!p_socket_address_to_native (address, &sa, sizeof (sa))) {
+#ifndef PLIBSYS_HAS_SCM_RIGHTS
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IO_NOT_SUPPORTED,
+			     0,
+			     "Passing descriptors is not supported");
+	return -1;
+#else
+	if (P_UNLIKELY (socket->family != P_SOCKET_FAMILY_UNIX)) {
 		p_error_set_error_p (error,
-				     (pint) P_ERROR_IO_FAILED,
+				     (pint) P_ERROR_IO_NOT_SUPPORTED,
 				     0,
-				     "Failed to convert socket address to native structure");
+				     "Descriptors can be passed only through local sockets");
 		return -1;
 	}
 
-	optlen = (socklen_t) p_socket_address_get_native_size (address);
-
 	for (;;) {
+		memset (&msg, 0, sizeof (msg));
+
+		iov.iov_base = buffer;
+		iov.iov_len  = buflen;
+
+		msg.msg_iov        = &iov;
+		msg.msg_iovlen     = 1;
+		msg.msg_control    = control.buf;
+		msg.msg_controllen = sizeof (control.buf);
+
 		if (socket->blocking &&
-		    p_socket_io_condition_wait (socket, P_SOCKET_IO_CONDITION_POLLOUT, error) == FALSE)
+		    p_socket_io_condition_wait (socket,
+						P_SOCKET_IO_CONDITION_POLLIN,
+						error) == FALSE)
 			return -1;
 
-		if ((ret = sendto (socket->fd,
-				   buffer,
-				   (socklen_t) buflen,
-				   0,
-				   (struct sockaddr *) &sa,
-				   optlen)) < 0) {
+#  ifdef MSG_CMSG_CLOEXEC
+		ret = recvmsg (socket->fd, &msg, MSG_CMSG_CLOEXEC);
+#  else
+		ret = recvmsg (socket->fd, &msg, 0);
+#  endif
+
+		if (ret < 0) {
 			err_code = p_error_get_last_net ();
 
-#if !defined (P_OS_WIN) && defined (EINTR)
+			if (P_UNLIKELY (socket->stats != NULL))
+				pp_socket_stats_update (socket, FALSE, -1, 0, err_code);
+
 			if (err_code == EINTR)
 				continue;
-#endif
+
 			sock_err = p_error_get_io_from_system (err_code);
 
 			if (socket->blocking && sock_err == P_ERROR_IO_WOULD_BLOCK)
 				continue;
 
-			p_error_set_error_p (error,
-					     (pint) sock_err,
+			pp_socket_set_error (socket,
+					     error,
+					     sock_err,
 					     err_code,
-					     "Failed to call sendto() on socket");
+					     "Failed to call recvmsg() on socket");
 
 			return -1;
 		}
@@ -1322,7 +4270,42 @@ p_socket_send_to (const PSocket		*socket,
 		break;
 	}
 
+	received = 0;
+
+	for (cmsg = CMSG_FIRSTHDR (&msg); cmsg != NULL; cmsg = CMSG_NXTHDR (&msg, cmsg)) {
+		if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS)
+			continue;
+
+		count = (cmsg->cmsg_len - CMSG_LEN (0)) / sizeof (pint);
+
+		for (i = 0; i < count; ++i) {
+			memcpy (&fd, CMSG_DATA (cmsg) + i * sizeof (pint), sizeof (pint));
+
+			if (received == *n_fds) {
+				p_sys_close (fd);
+				continue;
+			}
+
+#  ifndef MSG_CMSG_CLOEXEC
+			flags = fcntl (fd, F_GETFD, 0);
+
+			if (P_LIKELY (flags != -1 && (flags & FD_CLOEXEC) == 0)) {
+				if (P_UNLIKELY (fcntl (fd, F_SETFD, flags | FD_CLOEXEC) < 0))
+					P_WARNING ("PSocket::p_socket_receive_fds: fcntl() with FD_CLOEXEC failed");
+			}
+#  endif
+
+			fds[received++] = fd;
+		}
+	}
+
+	*n_fds = received;
+
+	if (P_UNLIKELY (socket->stats != NULL))
+		pp_socket_stats_update (socket, FALSE, ret, 1, 0);
+
 	return ret;
+#endif
 }
 
 P_LIB_API pboolean
@@ -1431,7 +4414,9 @@ p_socket_free (PSocket *socket)
 		p_time_profiler_free (socket->timer);
 #endif
 
-	p_free (socket);
+	p_socket_set_stats_enabled (socket, FALSE, NULL);
+
+	pp_socket_release (socket);
 }
 
 P_LIB_API pboolean
@@ -1472,10 +4457,221 @@ p_socket_set_buffer_size (const PSocket		*socket,
 	return TRUE;
 }
 
+P_LIB_API pboolean
+p_socket_set_option (const PSocket	*socket,
+		     PSocketOption	option,
+		     pint		value,
+		     PError		**error)
+{
+	pint	level;
+	pint	optname;
+
+	if (P_UNLIKELY (socket == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (pp_socket_check (socket, error) == FALSE))
+		return FALSE;
+
+	if (P_UNLIKELY (pp_socket_option_to_native (socket, option, &level, &optname) == FALSE)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NOT_SUPPORTED,
+				     0,
+				     "Socket option is not supported on this platform");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (setsockopt (socket->fd,
+				    level,
+				    optname,
+				    (pconstpointer) &value,
+				    sizeof (value)) != 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_io_from_system (p_error_get_last_net ()),
+				     (pint) p_error_get_last_net (),
+				     "Failed to call setsockopt() on socket to set option");
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_socket_get_option (const PSocket	*socket,
+		     PSocketOption	option,
+		     pint		*value,
+		     PError		**error)
+{
+	socklen_t	optlen;
+	pint		level;
+	pint		optname;
+	pint		optval;
+
+	if (P_UNLIKELY (socket == NULL || value == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (pp_socket_check (socket, error) == FALSE))
+		return FALSE;
+
+	if (P_UNLIKELY (pp_socket_option_to_native (socket, option, &level, &optname) == FALSE)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NOT_SUPPORTED,
+				     0,
+				     "Socket option is not supported on this platform");
+		return FALSE;
+	}
+
+	/* Some systems return a single byte for the boolean options */
+	optval = 0;
+	optlen = sizeof (optval);
+
+	if (P_UNLIKELY (getsockopt (socket->fd, level, optname, (ppointer) &optval, &optlen) != 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_io_from_system (p_error_get_last_net ()),
+				     (pint) p_error_get_last_net (),
+				     "Failed to call getsockopt() on socket to get option");
+		return FALSE;
+	}
+
+	if (optlen == sizeof (pchar))
+		optval = (pint) *((puchar *) &optval);
+
+	switch (option) {
+	case P_SOCKET_OPTION_TCP_NODELAY:
+	case P_SOCKET_OPTION_TCP_QUICKACK:
+	case P_SOCKET_OPTION_TCP_CORK:
+	case P_SOCKET_OPTION_REUSE_PORT:
+		optval = (optval != 0);
+		break;
+	default:
+		break;
+	}
+
+	*value = optval;
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_socket_set_stats_enabled (PSocket	*socket,
+			    pboolean	enabled,
+			    PError	**error)
+{
+	if (P_UNLIKELY (socket == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	if (enabled == FALSE) {
+		if (socket->stats_timer != NULL)
+			p_time_profiler_free (socket->stats_timer);
+
+		p_free (socket->stats);
+
+		socket->stats       = NULL;
+		socket->stats_timer = NULL;
+
+		return TRUE;
+	}
+
+	if (socket->stats != NULL)
+		return TRUE;
+
+	if (P_UNLIKELY ((socket->stats = p_malloc0 (sizeof (PSocketStats))) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for socket statistics");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY ((socket->stats_timer = p_time_profiler_new ()) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for socket statistics timer");
+		p_free (socket->stats);
+		socket->stats = NULL;
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_socket_get_stats (const PSocket	*socket,
+		    PSocketStats	*stats)
+{
+	if (P_UNLIKELY (socket == NULL || stats == NULL || socket->stats == NULL))
+		return FALSE;
+
+	memcpy (stats, socket->stats, sizeof (PSocketStats));
+
+	return TRUE;
+}
+
+P_LIB_API void
+p_socket_reset_stats (PSocket *socket)
+{
+	if (P_UNLIKELY (socket == NULL || socket->stats == NULL))
+		return;
+
+	memset (socket->stats, 0, sizeof (PSocketStats));
+}
+
 P_LIB_API pboolean
 p_socket_io_condition_wait (const PSocket	*socket,
 			    PSocketIOCondition	condition,
 			    PError		**error)
+{
+	pboolean ret;
+
+	if (P_LIKELY (socket == NULL || socket->stats == NULL))
+		return pp_socket_io_condition_wait (socket, condition, error);
+
+	p_time_profiler_reset (socket->stats_timer);
+
+	ret = pp_socket_io_condition_wait (socket, condition, error);
+
+	++socket->stats->waits;
+	socket->stats->wait_time += p_time_profiler_elapsed_usecs (socket->stats_timer);
+
+	return ret;
+}
+
+/* Returns the time to wait in milliseconds, -1 to wait infinitely */
+static pint
+pp_socket_get_wait_timeout (const PSocket *socket)
+{
+	pint timeout = socket->timeout > 0 ? socket->timeout : -1;
+	pint remaining;
+
+	if (socket->has_deadline) {
+		remaining = p_deadline_get_remaining_msecs (&socket->deadline);
+
+		if (remaining >= 0 && (timeout < 0 || remaining < timeout))
+			timeout = remaining;
+	}
+
+	return timeout;
+}
+
+static pboolean
+pp_socket_io_condition_wait (const PSocket	*socket,
+			     PSocketIOCondition	condition,
+			     PError		**error)
 {
 #if defined (P_OS_WIN)
 	long	network_events;
@@ -1493,7 +4689,8 @@ p_socket_io_condition_wait (const PSocket	*socket,
 	if (P_UNLIKELY (pp_socket_check (socket, error) == FALSE))
 		return FALSE;
 
-	timeout = socket->timeout > 0 ? socket->timeout : WSA_INFINITE;
+	if ((timeout = pp_socket_get_wait_timeout (socket)) < 0)
+		timeout = WSA_INFINITE;
 
 	if (condition == P_SOCKET_IO_CONDITION_POLLIN)
 		network_events = FD_READ | FD_ACCEPT;
@@ -1536,7 +4733,7 @@ p_socket_io_condition_wait (const PSocket	*socket,
 	if (P_UNLIKELY (pp_socket_check (socket, error) == FALSE))
 		return FALSE;
 
-	timeout = socket->timeout > 0 ? socket->timeout : -1;
+	timeout = pp_socket_get_wait_timeout (socket);
 
 	pfd.fd = socket->fd;
 	pfd.revents = 0;
@@ -1588,6 +4785,7 @@ p_socket_io_condition_wait (const PSocket	*socket,
 	struct timeval		tv;
 	struct timeval *	ptv;
 	pint			evret;
+	pint			timeout;
 
 	if (P_UNLIKELY (socket == NULL)) {
 		p_error_set_error_p (error,
@@ -1600,7 +4798,9 @@ p_socket_io_condition_wait (const PSocket	*socket,
 	if (P_UNLIKELY (pp_socket_check (socket, error) == FALSE))
 		return FALSE;
 
-	if (socket->timeout > 0)
+	timeout = pp_socket_get_wait_timeout (socket);
+
+	if (timeout >= 0)
 		ptv = &tv;
 	else
 		ptv = NULL;
@@ -1609,9 +4809,9 @@ p_socket_io_condition_wait (const PSocket	*socket,
 		FD_ZERO (&fds);
 		FD_SET (socket->fd, &fds);
 
-		if (socket->timeout > 0) {
-			tv.tv_sec  = socket->timeout / 1000;
-			tv.tv_usec = (socket->timeout % 1000) * 1000;
+		if (timeout >= 0) {
+			tv.tv_sec  = timeout / 1000;
+			tv.tv_usec = (timeout % 1000) * 1000;
 		}
 
 		if (condition == P_SOCKET_IO_CONDITION_POLLIN)
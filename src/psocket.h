@@ -49,6 +49,13 @@
  * correspondingly. INET6 family is not supported on all platforms, refer to
  * documentation for a particular target platform.
  *
+ * The UNIX family provides local (UNIX domain) sockets for the communication
+ * between processes on the same host, it bypasses the network stack entirely.
+ * Use #P_SOCKET_PROTOCOL_DEFAULT with it and create the addresses with
+ * p_socket_address_new_unix(). Connected local sockets can also pass open
+ * file descriptors to each other with p_socket_send_fds() and
+ * p_socket_receive_fds().
+ *
  * #PSocket supports different underlying data transfer protocols: TCP, UDP and
  * others. Note that not all protocols can be used with any socket type, i.e.
  * you can use the TCP protocol with a stream socket, but you can't use the UDP
@@ -143,6 +150,15 @@
  * @endcode
  * Here a UDP socket was created, bound to the localhost address and the port
  * @a 5432. Do not forget to close the socket and free memory after its usage.
+ *
+ * Socket objects, like the accepted ones, are recycled through a per-thread
+ * cached pool (see #PMemPool) rather than allocated from the heap every time,
+ * so a high connection churn stays off the general allocator.
+ *
+ * Free all the sockets before calling p_libsys_shutdown(), the pool is
+ * released there. Sockets still alive at that point remain usable and can be
+ * closed and freed later, but their memory is not reclaimed until the program
+ * exits.
  */
 
 #if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
@@ -155,9 +171,16 @@
 #include "pmacros.h"
 #include "psocketaddress.h"
 #include "perror.h"
+#include "pdeadline.h"
 
 P_BEGIN_DECLS
 
+/** Maximum number of descriptors passed with p_socket_send_fds() at once. */
+#define P_SOCKET_MAX_FDS		16
+
+/** Maximum segment size for p_socket_send_segmented(), the largest UDP payload. */
+#define P_SOCKET_MAX_SEGMENT_SIZE	65507
+
 /** Socket protocols specified by the IANA.  */
 typedef enum PSocketProtocol_ {
 	P_SOCKET_PROTOCOL_UNKNOWN	= -1,	/**< Unknown protocol.	*/
@@ -181,12 +204,79 @@ typedef enum PSocketDirection_ {
 	P_SOCKET_DIRECTION_RCV		= 1	/**< Receive direction.	*/
 } PSocketDirection;
 
+/** Socket options for low-latency tuning, see p_socket_set_option(). */
+typedef enum PSocketOption_ {
+	P_SOCKET_OPTION_TCP_NODELAY		= 0,	/**< Disables the Nagle algorithm (TCP_NODELAY), boolean.		*/
+	P_SOCKET_OPTION_TCP_QUICKACK		= 1,	/**< Sends ACKs immediately (TCP_QUICKACK), boolean, Linux only.	*/
+	P_SOCKET_OPTION_TCP_CORK		= 2,	/**< Holds partial frames (TCP_CORK or TCP_NOPUSH), boolean.		*/
+	P_SOCKET_OPTION_REUSE_PORT		= 3,	/**< Allows several sockets on the same port (SO_REUSEPORT), boolean.	*/
+	P_SOCKET_OPTION_TCP_FASTOPEN		= 4,	/**< TCP Fast Open queue length for a listening socket (TCP_FASTOPEN).	*/
+	P_SOCKET_OPTION_BUSY_POLL		= 5,	/**< Busy polling time in microseconds (SO_BUSY_POLL), Linux only.	*/
+	P_SOCKET_OPTION_INCOMING_CPU		= 6,	/**< CPU which handles the socket (SO_INCOMING_CPU), Linux only.	*/
+	P_SOCKET_OPTION_TOS			= 7,	/**< Type of service byte (IP_TOS or IPV6_TCLASS).			*/
+	P_SOCKET_OPTION_TCP_NOTSENT_LOWAT	= 8,	/**< Limit of unsent bytes in bytes (TCP_NOTSENT_LOWAT).		*/
+	P_SOCKET_OPTION_UDP_GRO			= 9	/**< Coalesces received datagrams (UDP_GRO), boolean, Linux only.	*/
+} PSocketOption;
+
 /** Socket IO waiting (polling) conditions. */
 typedef enum PSocketIOCondition_ {
 	P_SOCKET_IO_CONDITION_POLLIN	= 1,	/**< Ready to read.	*/
 	P_SOCKET_IO_CONDITION_POLLOUT	= 2	/**< Ready to write.	*/
 } PSocketIOCondition;
 
+/** Buffer descriptor for scatter/gather data operations. */
+typedef struct PSocketVector_ {
+	pchar	*buffer;	/**< Buffer to read data from or write data in.	*/
+	psize	buflen;		/**< Length of the buffer.			*/
+} PSocketVector;
+
+/** Datagram descriptor for batched data operations. */
+typedef struct PSocketMessage_ {
+	PSocketAddress	*address;	/**< Remote address to send the datagram to or
+					     the received datagram source address.	*/
+	pchar		*buffer;	/**< Buffer with datagram data.			*/
+	psize		buflen;		/**< Length of the buffer.			*/
+	psize		length;		/**< Size in bytes of sent or received data.	*/
+} PSocketMessage;
+
+/** Socket I/O statistics counters. */
+typedef struct PSocketStats_ {
+	puint64	bytes_sent;		/**< Number of bytes sent.				*/
+	puint64	bytes_received;		/**< Number of bytes received.				*/
+	puint64	packets_sent;		/**< Number of send calls or datagrams which
+					     transferred data.					*/
+	puint64	packets_received;	/**< Number of receive calls or datagrams which
+					     transferred data.					*/
+	puint64	syscalls;		/**< Number of data transfer system calls.		*/
+	puint64	would_block;		/**< Number of calls failed because they would
+					     block.						*/
+	puint64	waits;			/**< Number of p_socket_io_condition_wait() calls.	*/
+	puint64	wait_time;		/**< Time spent in p_socket_io_condition_wait(), in
+					     microseconds.					*/
+} PSocketStats;
+
+/** Packet timestamps to enable, see p_socket_set_timestamping(). */
+typedef enum PSocketTimestampFlags_ {
+	P_SOCKET_TIMESTAMP_RX_SOFTWARE	= 1 << 0,	/**< Kernel timestamps of received packets.	*/
+	P_SOCKET_TIMESTAMP_RX_HARDWARE	= 1 << 1,	/**< NIC timestamps of received packets.	*/
+	P_SOCKET_TIMESTAMP_TX_SOFTWARE	= 1 << 2,	/**< Kernel timestamps of sent packets.		*/
+	P_SOCKET_TIMESTAMP_TX_HARDWARE	= 1 << 3	/**< NIC timestamps of sent packets.		*/
+} PSocketTimestampFlags;
+
+/** Packet timestamps. */
+typedef struct PSocketTimestamps_ {
+	puint64	software;	/**< Kernel timestamp in nanoseconds since the Unix
+				     epoch, 0 if not available.				*/
+	puint64	hardware;	/**< NIC timestamp in nanoseconds of the NIC clock,
+				     0 if not available.				*/
+	puint64	age;		/**< Nanoseconds passed from the kernel timestamp
+				     till the call returned, 0 if not available.	*/
+	puint64	ticks;		/**< p_time_profiler_ticks() value taken when the
+				     call returned.					*/
+	puint32	id;		/**< Sequence number of the sent packet for the
+				     transmit timestamps, 0 otherwise.			*/
+} PSocketTimestamps;
+
 /** Socket opaque structure. */
 typedef struct PSocket_ PSocket;
 
@@ -308,6 +398,16 @@ P_LIB_API pboolean		p_socket_get_keepalive		(const PSocket		*socket);
  */
 P_LIB_API pboolean		p_socket_get_blocking		(PSocket 		*socket);
 
+/**
+ * @brief Checks whether @a socket reports the would-block case silently.
+ * @param socket #PSocket to check the mode for.
+ * @return TRUE if the would-block case is reported with a return code alone,
+ * FALSE otherwise.
+ * @since 0.0.5
+ * @sa p_socket_set_silent_would_block()
+ */
+P_LIB_API pboolean		p_socket_get_silent_would_block	(const PSocket		*socket);
+
 /**
  * @brief Gets a @a socket listen backlog parameter.
  * @param socket #PSocket to get the listen backlog parameter for.
@@ -459,6 +559,23 @@ P_LIB_API void			p_socket_set_keepalive		(PSocket 		*socket,
 P_LIB_API void			p_socket_set_blocking		(PSocket 		*socket,
 								 pboolean		blocking);
 
+/**
+ * @brief Sets whether @a socket reports the would-block case silently.
+ * @param socket #PSocket to set the mode for.
+ * @param silent Whether to skip the #PError for the would-block case.
+ * @since 0.0.5
+ * @sa p_socket_get_silent_would_block()
+ *
+ * A non-blocking socket fails with #P_ERROR_IO_WOULD_BLOCK each time an
+ * operation can't be completed immediately, and every such failure allocates
+ * a #PError. In the silent mode the failing call returns its usual error
+ * value (-1, FALSE or NULL) but leaves the @a error untouched, so the
+ * would-block case is told apart by a NULL error. Other errors are reported
+ * as usual. Disabled by default.
+ */
+P_LIB_API void			p_socket_set_silent_would_block	(PSocket		*socket,
+								 pboolean		silent);
+
 /**
  * @brief Sets a @a socket listen backlog parameter.
  * @param socket #PSocket to set the listen backlog parameter for.
@@ -487,6 +604,28 @@ P_LIB_API void			p_socket_set_listen_backlog	(PSocket		*socket,
 P_LIB_API void			p_socket_set_timeout		(PSocket		*socket,
 								 pint			timeout);
 
+/**
+ * @brief Sets a @a socket deadline for blocking I/O operations.
+ * @param socket #PSocket to set the @a deadline for.
+ * @param deadline Deadline to set, copied into the socket, NULL to unset.
+ * @since 0.0.5
+ * @sa p_socket_set_timeout(), p_socket_io_condition_wait()
+ *
+ * Unlike the timeout which limits each blocking call separately, all the
+ * blocking calls after setting the deadline share the time until it: a call
+ * fails with #P_ERROR_IO_TIMED_OUT as soon as the deadline expires. It makes
+ * possible to bound a whole request (connect, send the request, receive the
+ * response) without recomputing the timeout before each call. If a timeout
+ * is also set, the call waits for whichever expires first.
+ *
+ * For a non-blocking socket the deadline affects only the
+ * p_socket_io_condition_wait() maximum waiting time. An expired deadline
+ * still lets a call through if the socket is ready without waiting. The
+ * deadline stays until unset, it is not inherited by the accepted sockets.
+ */
+P_LIB_API void			p_socket_set_deadline		(PSocket		*socket,
+								 const PDeadline	*deadline);
+
 /**
  * @brief Binds a @a socket to a given local address.
  * @param socket #PSocket to bind.
@@ -567,6 +706,40 @@ P_LIB_API pboolean		p_socket_connect		(PSocket		*socket,
 								 PSocketAddress		*address,
 								 PError			**error);
 
+/**
+ * @brief Connects to the first reachable address among several candidates.
+ * @param addresses Array of #PSocketAddress candidates in the order of
+ * preference.
+ * @param n_addresses Number of addresses in @a addresses.
+ * @param delay Delay between the connection attempts in milliseconds, 0 to use
+ * the default value (250 ms).
+ * @param timeout Timeout for the whole operation in milliseconds, 0 to wait
+ * until all the attempts fail.
+ * @param[out] index Index of the connected address in @a addresses, NULL to
+ * ignore.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return New connected TCP #PSocket in blocking mode in case of success, NULL
+ * otherwise.
+ * @since 0.0.5
+ * @sa p_socket_connect(), p_socket_check_connect_result()
+ *
+ * Implements the connection racing of RFC 8305 ("Happy Eyeballs"): instead of
+ * waiting for a dead address to time out, a new non-blocking connection
+ * attempt is started every @a delay milliseconds (or right after a failed
+ * one) while the previous attempts are still in progress. The first attempt to
+ * succeed wins, and the others are cancelled. The addresses of different
+ * families are interleaved, starting with the family of the first address, so
+ * a broken IPv6 path doesn't delay an IPv4 fallback.
+ *
+ * If all the attempts fail, the error of the last failed attempt is reported.
+ */
+P_LIB_API PSocket *		p_socket_connect_any		(PSocketAddress		**addresses,
+								 psize			n_addresses,
+								 pint			delay,
+								 pint			timeout,
+								 psize			*index,
+								 PError			**error);
+
 /**
  * @brief Puts a @a socket into a listening state.
  * @param socket #PSocket to start listening.
@@ -599,10 +772,39 @@ P_LIB_API pboolean		p_socket_listen			(PSocket 		*socket,
  * This call has meaning only for connection oriented sockets. The socket can
  * accept new incoming connections only after calling p_socket_bind() and
  * p_socket_listen().
+ *
+ * Where available, accept4() is used to get a non-blocking close-on-exec
+ * descriptor with a single system call. The accepted socket inherits its
+ * family, type, protocol and keepalive option from the listening @a socket.
  */
 P_LIB_API PSocket *		p_socket_accept			(const PSocket		*socket,
 								 PError			**error);
 
+/**
+ * @brief Accepts several @a socket incoming connections at once.
+ * @param socket #PSocket to accept the incoming connections from.
+ * @param[out] sockets Array to store new #PSocket objects with the accepted
+ * connections.
+ * @param max_sockets Maximum number of connections to accept, the size of
+ * @a sockets.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Number of accepted connections in case of success, -1 otherwise.
+ * @note If the @a socket is in a blocking mode, then the caller will be blocked
+ * until at least one connection accepted.
+ * @since 0.0.5
+ * @sa p_socket_accept()
+ *
+ * Accepts the pending connections until @a max_sockets is reached or there are
+ * no more connections waiting in the queue, which helps to drain the queue
+ * quickly under a high connection rate. An error is reported only if no
+ * connections were accepted, otherwise the call returns the number of
+ * accepted ones and the error will show up on the next call.
+ */
+P_LIB_API pssize		p_socket_accept_many		(const PSocket		*socket,
+								 PSocket		**sockets,
+								 psize			max_sockets,
+								 PError			**error);
+
 /**
  * @brief Receives data from a given @a socket.
  * @param socket #PSocket to receive data from.
@@ -653,6 +855,31 @@ P_LIB_API pssize		p_socket_receive_from		(const PSocket 		*socket,
 								 psize			buflen,
 								 PError			**error);
 
+/**
+ * @brief Receives data from a given @a socket into a reusable remote address.
+ * @param socket #PSocket to receive data from.
+ * @param[out] address Caller-owned address to update with the remote one in
+ * case of success, may be NULL.
+ * @param buffer Buffer to write received data in.
+ * @param buflen Length of @a buffer.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Size in bytes of written data in case of success, -1 otherwise.
+ * @note If the @a socket is in a blocking mode, then the caller will be blocked
+ * until data arrives.
+ * @since 0.0.5
+ * @sa p_socket_receive_from(), p_socket_address_set_from_native()
+ *
+ * Works the same way as p_socket_receive_from() but updates @a address in place
+ * instead of allocating a new one for every datagram, so a single address
+ * object can be reused in a receive loop. If the remote address can't be
+ * represented with #PSocketAddress, @a address is left untouched.
+ */
+P_LIB_API pssize		p_socket_receive_from_into	(const PSocket		*socket,
+								 PSocketAddress		*address,
+								 pchar			*buffer,
+								 psize			buflen,
+								 PError			**error);
+
 /**
  * @brief Sends data through a given @a socket.
  * @param socket #PSocket to send data through.
@@ -698,6 +925,404 @@ P_LIB_API pssize		p_socket_send_to		(const PSocket		*socket,
 								 psize			buflen,
 								 PError			**error);
 
+/**
+ * @brief Receives data from a given @a socket into several buffers.
+ * @param socket #PSocket to receive data from.
+ * @param vectors Array of buffer descriptors to write received data in.
+ * @param n_vectors Number of descriptors in @a vectors.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Size in bytes of written data in case of success, -1 otherwise.
+ * @note If the @a socket is in a blocking mode, then the caller will be blocked
+ * until data arrives.
+ * @since 0.0.5
+ * @sa p_socket_receive(), p_socket_receive_vector_from()
+ *
+ * Received data fills the buffers in the order they are given in @a vectors,
+ * each buffer is filled completely before moving to the next one. Descriptors
+ * with zero length are skipped. The total length of all the buffers is treated
+ * as the @a buflen parameter of p_socket_receive().
+ *
+ * This call is implemented using recvmsg() on POSIX systems and WSARecv() on
+ * Windows. On systems without a native scatter/gather support data is received
+ * into a temporary buffer and then copied.
+ */
+P_LIB_API pssize		p_socket_receive_vector		(const PSocket		*socket,
+								 const PSocketVector	*vectors,
+								 psize			n_vectors,
+								 PError			**error);
+
+/**
+ * @brief Receives data from a given @a socket into several buffers and saves
+ * a remote address.
+ * @param socket #PSocket to receive data from.
+ * @param[out] address Pointer to store the remote address in case of success,
+ * may be NULL. The caller is responsible to free it after usage.
+ * @param vectors Array of buffer descriptors to write received data in.
+ * @param n_vectors Number of descriptors in @a vectors.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Size in bytes of written data in case of success, -1 otherwise.
+ * @note If the @a socket is in a blocking mode, then the caller will be blocked
+ * until data arrives.
+ * @since 0.0.5
+ * @sa p_socket_receive_from(), p_socket_receive_vector()
+ *
+ * See p_socket_receive_vector() for the details about how the data is written
+ * in the buffers. A single datagram is always received at once, so its parts
+ * can be placed into the separate buffers (i.e. a header and a payload).
+ *
+ * This call is normally used only with a connection-less socket.
+ */
+P_LIB_API pssize		p_socket_receive_vector_from	(const PSocket		*socket,
+								 PSocketAddress		**address,
+								 const PSocketVector	*vectors,
+								 psize			n_vectors,
+								 PError			**error);
+
+/**
+ * @brief Sends data from several buffers through a given @a socket.
+ * @param socket #PSocket to send data through.
+ * @param vectors Array of buffer descriptors with data to send.
+ * @param n_vectors Number of descriptors in @a vectors.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Size in bytes of sent data in case of success, -1 otherwise.
+ * @note If the @a socket is in a blocking mode, then the caller will be blocked
+ * until data sent.
+ * @since 0.0.5
+ * @sa p_socket_send(), p_socket_send_vector_to()
+ *
+ * Data from the buffers is sent in the order they are given in @a vectors as a
+ * single piece of data, without the need to copy it into one buffer first.
+ * Descriptors with zero length are skipped. For stream sockets less data than
+ * requested can be sent, check the returned value.
+ *
+ * This call is implemented using sendmsg() on POSIX systems and WSASend() on
+ * Windows. On systems without a native scatter/gather support data is copied
+ * into a temporary buffer and then sent.
+ */
+P_LIB_API pssize		p_socket_send_vector		(const PSocket		*socket,
+								 const PSocketVector	*vectors,
+								 psize			n_vectors,
+								 PError			**error);
+
+/**
+ * @brief Sends data from several buffers through a given @a socket to a given
+ * address.
+ * @param socket #PSocket to send data through.
+ * @param address #PSocketAddress to send data to.
+ * @param vectors Array of buffer descriptors with data to send.
+ * @param n_vectors Number of descriptors in @a vectors.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Size in bytes of sent data in case of success, -1 otherwise.
+ * @note If the @a socket is in a blocking mode, then the caller will be blocked
+ * until data sent.
+ * @since 0.0.5
+ * @sa p_socket_send_to(), p_socket_send_vector()
+ *
+ * All the buffers are sent as a single datagram. This call is used when dealing
+ * with connection-less sockets, see p_socket_send_to() for more information.
+ */
+P_LIB_API pssize		p_socket_send_vector_to		(const PSocket		*socket,
+								 PSocketAddress		*address,
+								 const PSocketVector	*vectors,
+								 psize			n_vectors,
+								 PError			**error);
+
+/**
+ * @brief Receives several datagrams from a given @a socket at once.
+ * @param socket #PSocket to receive datagrams from.
+ * @param messages Array of datagram descriptors to receive data in.
+ * @param n_messages Number of descriptors in @a messages.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Number of received datagrams in case of success, -1 otherwise.
+ * @note If the @a socket is in a blocking mode, then the caller will be blocked
+ * until at least one datagram arrives.
+ * @since 0.0.5
+ * @sa p_socket_receive_from(), p_socket_send_many()
+ *
+ * Each received datagram is written in the @a buffer of the next descriptor
+ * from @a messages, its size is stored in the @a length field. The @a address
+ * field is always overwritten with the datagram source address (or NULL in case
+ * of failure), the caller is responsible to free it after usage. Descriptors
+ * after the returned number are left untouched.
+ *
+ * The call returns as soon as there are no more pending datagrams, it never
+ * blocks after the first one is received. If the @a buflen is less than the
+ * received datagram size, excess bytes are discarded.
+ *
+ * This call uses recvmmsg() to receive a batch of datagrams with a single
+ * system call where available, and falls back to a recvfrom() loop otherwise.
+ */
+P_LIB_API pssize		p_socket_receive_many		(const PSocket		*socket,
+								 PSocketMessage		*messages,
+								 psize			n_messages,
+								 PError			**error);
+
+/**
+ * @brief Sends several datagrams through a given @a socket at once.
+ * @param socket #PSocket to send datagrams through.
+ * @param messages Array of datagram descriptors with data to send.
+ * @param n_messages Number of descriptors in @a messages.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Number of sent datagrams in case of success, -1 otherwise.
+ * @note If the @a socket is in a blocking mode, then the caller will be blocked
+ * until at least one datagram sent.
+ * @since 0.0.5
+ * @sa p_socket_send_to(), p_socket_receive_many()
+ *
+ * Each datagram is sent to the @a address from its descriptor, or to the
+ * address the @a socket is connected to if the @a address is NULL. The number
+ * of sent bytes is stored in the @a length field.
+ *
+ * Less datagrams than requested can be sent if an error occurs after the first
+ * one or the socket send buffer is full, check the returned value and resend
+ * the rest.
+ *
+ * This call uses sendmmsg() to send a batch of datagrams with a single system
+ * call where available, and falls back to a sendto() loop otherwise.
+ */
+P_LIB_API pssize		p_socket_send_many		(const PSocket		*socket,
+								 PSocketMessage		*messages,
+								 psize			n_messages,
+								 PError			**error);
+
+/**
+ * @brief Sends a buffer as a train of equally sized datagrams.
+ * @param socket Datagram #PSocket to send data through.
+ * @param address Address to send the datagrams to, NULL for a connected
+ * @a socket.
+ * @param buffer Buffer with data to send.
+ * @param buflen Length of @a buffer.
+ * @param segment_size Size of each datagram except the last one which may be
+ * shorter, up to #P_SOCKET_MAX_SEGMENT_SIZE.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Size in bytes of sent data in case of success, -1 otherwise.
+ * @since 0.0.5
+ * @sa p_socket_receive_segmented(), p_socket_send_many()
+ *
+ * On Linux up to 64 datagrams are passed to the kernel at once with the
+ * UDP_SEGMENT (GSO) control message, so the per-packet processing is done by
+ * the network card or once per train in the kernel. On the other systems, and
+ * if the kernel or the network interface doesn't support it, the datagrams are
+ * sent one by one.
+ *
+ * Less data than requested can be sent if an error occurs after the first
+ * datagram or the socket send buffer is full, the sent size is always a
+ * multiple of @a segment_size then. Check the returned value and resend the
+ * rest.
+ */
+P_LIB_API pssize		p_socket_send_segmented		(const PSocket		*socket,
+								 PSocketAddress		*address,
+								 const pchar		*buffer,
+								 psize			buflen,
+								 psize			segment_size,
+								 PError			**error);
+
+/**
+ * @brief Receives coalesced datagrams from a @a socket.
+ * @param socket Datagram #PSocket to receive data from.
+ * @param[out] address Source address of the datagrams, NULL to ignore. The
+ * caller takes ownership of the returned object.
+ * @param buffer Buffer to write received data in.
+ * @param buflen Length of @a buffer.
+ * @param[out] segment_size Size of each received datagram except the last one
+ * which may be shorter.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Size in bytes of received data in case of success, -1 otherwise.
+ * @since 0.0.5
+ * @sa p_socket_send_segmented(), #P_SOCKET_OPTION_UDP_GRO
+ *
+ * With #P_SOCKET_OPTION_UDP_GRO enabled the Linux kernel merges consecutive
+ * datagrams of the same size from the same source, so a single call can
+ * return many of them: split the data by @a segment_size. The buffer should
+ * be large enough for #P_SOCKET_MAX_SEGMENT_SIZE bytes, otherwise the merged
+ * data is truncated.
+ *
+ * Without the offload the call receives a single datagram and @a segment_size
+ * equals the returned size.
+ */
+P_LIB_API pssize		p_socket_receive_segmented	(const PSocket		*socket,
+								 PSocketAddress		**address,
+								 pchar			*buffer,
+								 psize			buflen,
+								 psize			*segment_size,
+								 PError			**error);
+
+/**
+ * @brief Enables kernel or NIC timestamps of the packets of a @a socket.
+ * @param socket #PSocket to enable the timestamps for.
+ * @param flags Timestamps to enable, a combination of #PSocketTimestampFlags,
+ * 0 to disable them all.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ * @sa p_socket_receive_from_timestamped(), p_socket_get_tx_timestamp()
+ *
+ * The timestamps separate the network latency from the application one: the
+ * kernel stamps a packet when it arrives from (or leaves to) the network
+ * device, and the NIC stamps it on the wire.
+ *
+ * SO_TIMESTAMPING is used on Linux, where all the flags are supported. The
+ * hardware timestamps are delivered only if the NIC supports them and is
+ * configured to produce them (SIOCSHWTSTAMP, i.e. with hwstamp_ctl), which
+ * is out of the scope of this call. The other systems with SO_TIMESTAMP
+ * support only #P_SOCKET_TIMESTAMP_RX_SOFTWARE, the rest of the flags and
+ * the systems without timestamps (including Windows) fail with
+ * #P_ERROR_IO_NOT_SUPPORTED error code.
+ */
+P_LIB_API pboolean		p_socket_set_timestamping	(const PSocket		*socket,
+								 pint			flags,
+								 PError			**error);
+
+/**
+ * @brief Receives data from a given @a socket along with its timestamps.
+ * @param socket #PSocket to receive data from.
+ * @param[out] address Pointer to store the remote address in case of success,
+ * may be NULL. The caller is responsible to free it after usage.
+ * @param buffer Buffer to write received data in.
+ * @param buflen Length of @a buffer.
+ * @param[out] timestamps Timestamps of the received data.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Size in bytes of written data in case of success, -1 otherwise.
+ * @note If the @a socket is in a blocking mode, then the caller will be blocked
+ * until data arrives.
+ * @since 0.0.5
+ * @sa p_socket_set_timestamping(), p_socket_receive_from()
+ *
+ * Works the same way as p_socket_receive_from() but also fills in the
+ * timestamps enabled with p_socket_set_timestamping(), the others are set to
+ * 0. PSocketTimestamps::age and PSocketTimestamps::ticks are in the
+ * #PTimeProfiler units, so the time from the packet arrival to any later
+ * point of the processing is:
+ * @code
+ * timestamps.age + p_time_profiler_ticks_to_nsecs (p_time_profiler_ticks () - timestamps.ticks)
+ * @endcode
+ *
+ * For a stream socket the timestamps are the ones of the last packet which
+ * contributed to the received data.
+ */
+P_LIB_API pssize		p_socket_receive_from_timestamped (const PSocket	*socket,
+								 PSocketAddress		**address,
+								 pchar			*buffer,
+								 psize			buflen,
+								 PSocketTimestamps	*timestamps,
+								 PError			**error);
+
+/**
+ * @brief Gets the next transmit timestamp of a @a socket.
+ * @param socket #PSocket to get the timestamp for.
+ * @param[out] timestamps Timestamps of the sent packet.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ * @sa p_socket_set_timestamping()
+ *
+ * Transmit timestamps are enabled with #P_SOCKET_TIMESTAMP_TX_SOFTWARE and
+ * #P_SOCKET_TIMESTAMP_TX_HARDWARE flags and are queued by the kernel after
+ * the packet was handed to the device, so they are available some time after
+ * the send call. The call never blocks and fails with
+ * #P_ERROR_IO_WOULD_BLOCK error code if there are no queued timestamps.
+ *
+ * PSocketTimestamps::id tells which packet the timestamp belongs to: it
+ * counts the datagrams sent since the timestamps were enabled starting from
+ * 0, or the bytes for a stream socket. Subtract PSocketTimestamps::age from
+ * the time passed since the send call (measured with #PTimeProfiler) to get
+ * the time it took the packet to reach the device.
+ *
+ * Supported only on Linux, the other systems fail with
+ * #P_ERROR_IO_NOT_SUPPORTED error code.
+ */
+P_LIB_API pboolean		p_socket_get_tx_timestamp	(const PSocket		*socket,
+								 PSocketTimestamps	*timestamps,
+								 PError			**error);
+
+/**
+ * @brief Sends a file contents through a given @a socket.
+ * @param socket #PSocket to send data through.
+ * @param path Path to the file to send.
+ * @param offset Offset in the file to start sending from, in bytes.
+ * @param length Number of bytes to send, 0 to send until the end of the file.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Size in bytes of sent data in case of success, -1 otherwise.
+ * @note If the @a socket is in a blocking mode, then the caller will be blocked
+ * until all the data sent.
+ * @since 0.0.5
+ * @sa p_socket_send()
+ *
+ * The file data is passed to the socket by the kernel without copying it into
+ * the user space: sendfile() is used on Linux, BSD and macOS, and TransmitFile()
+ * on Windows. On other systems (or if the native call is not supported for the
+ * given file or socket) the file is read and sent in chunks.
+ *
+ * If the range exceeds the end of the file, only the data up to the end is
+ * sent. The @a offset beyond the end of the file is treated as an error.
+ *
+ * For a non-blocking @a socket less data than requested can be sent, check the
+ * returned value and call this function again with the updated offset.
+ */
+P_LIB_API pssize		p_socket_send_file		(const PSocket		*socket,
+								 const pchar		*path,
+								 puint64		offset,
+								 psize			length,
+								 PError			**error);
+
+/**
+ * @brief Sends data along with open file descriptors through a local socket.
+ * @param socket Connected local #PSocket to send data through.
+ * @param buffer Buffer with data to send, at least one byte.
+ * @param buflen Length of @a buffer.
+ * @param fds Descriptors to pass.
+ * @param n_fds Number of descriptors in @a fds, up to #P_SOCKET_MAX_FDS.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Size in bytes of sent data in case of success, -1 otherwise.
+ * @since 0.0.5
+ * @sa p_socket_receive_fds()
+ *
+ * The receiving process gets its own duplicates of the descriptors, i.e. to
+ * hand off an accepted connection (see p_socket_get_fd()) or an anonymous
+ * shared memory segment (see p_shm_get_handle()). The caller still owns and
+ * has to close @a fds.
+ *
+ * The descriptors travel with the first byte of the data, so for a stream
+ * socket the rest of the data can be sent with p_socket_send() if less was
+ * sent than requested.
+ *
+ * Descriptors are passed with SCM_RIGHTS, #P_ERROR_IO_NOT_SUPPORTED is
+ * reported on Windows and the other systems without it.
+ */
+P_LIB_API pssize		p_socket_send_fds		(const PSocket		*socket,
+								 const pchar		*buffer,
+								 psize			buflen,
+								 const pint		*fds,
+								 psize			n_fds,
+								 PError			**error);
+
+/**
+ * @brief Receives data along with open file descriptors from a local socket.
+ * @param socket Connected local #PSocket to receive data from.
+ * @param buffer Buffer to write received data in.
+ * @param buflen Length of @a buffer.
+ * @param[out] fds Array for the received descriptors.
+ * @param[in,out] n_fds Capacity of @a fds on input, number of the received
+ * descriptors on output.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Size in bytes of received data in case of success, -1 otherwise.
+ * @since 0.0.5
+ * @sa p_socket_send_fds()
+ *
+ * The caller owns the received descriptors and must close them. They have the
+ * close-on-exec flag set. Descriptors which don't fit into @a fds (or above
+ * #P_SOCKET_MAX_FDS) are closed right away.
+ *
+ * Receiving the data with p_socket_receive() closes the descriptors which were
+ * sent along with it.
+ */
+P_LIB_API pssize		p_socket_receive_fds		(const PSocket		*socket,
+								 pchar			*buffer,
+								 psize			buflen,
+								 pint			*fds,
+								 psize			*n_fds,
+								 PError			**error);
+
 /**
  * @brief Closes a @a socket.
  * @param socket #PSocket to close.
@@ -756,6 +1381,94 @@ P_LIB_API pboolean		p_socket_set_buffer_size	(const PSocket		*socket,
 								 psize			size,
 								 PError			**error);
 
+/**
+ * @brief Sets a low-latency tuning option on a @a socket.
+ * @param socket #PSocket to set the option for.
+ * @param option Option to set.
+ * @param value Value to set: 0 or 1 for boolean options, a number otherwise.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ * @sa p_socket_get_option()
+ *
+ * Each #PSocketOption maps to a single native option, see its description.
+ * The options which are not available on the current platform fail with
+ * #P_ERROR_IO_NOT_SUPPORTED error code. The TCP options are valid only for
+ * TCP sockets.
+ *
+ * #P_SOCKET_OPTION_REUSE_PORT should be set before binding the socket,
+ * #P_SOCKET_OPTION_TCP_FASTOPEN before switching it into the listening state.
+ * On Linux #P_SOCKET_OPTION_TCP_QUICKACK is reset by the kernel after some
+ * time, so it should be set again after every receive operation when needed.
+ * #P_SOCKET_OPTION_TOS is mapped to IPV6_TCLASS for IPv6 sockets.
+ * Enable #P_SOCKET_OPTION_UDP_GRO only if the data is received with
+ * p_socket_receive_segmented(), the other calls can't tell the datagrams
+ * apart.
+ */
+P_LIB_API pboolean		p_socket_set_option		(const PSocket		*socket,
+								 PSocketOption		option,
+								 pint			value,
+								 PError			**error);
+
+/**
+ * @brief Gets a low-latency tuning option of a @a socket.
+ * @param socket #PSocket to get the option for.
+ * @param option Option to get.
+ * @param[out] value Option value: 0 or 1 for boolean options.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ * @sa p_socket_set_option()
+ */
+P_LIB_API pboolean		p_socket_get_option		(const PSocket		*socket,
+								 PSocketOption		option,
+								 pint			*value,
+								 PError			**error);
+
+/**
+ * @brief Enables or disables I/O statistics counters of a @a socket.
+ * @param socket #PSocket to enable the counters for.
+ * @param enabled Whether to enable the counters.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ * @sa p_socket_get_stats(), p_socket_reset_stats()
+ *
+ * The counters are disabled by default and cost a single check per call then.
+ * Enabling them again keeps the collected values, disabling drops them.
+ *
+ * The counters account the data transfer calls of #PSocket (including the ones
+ * made by p_socket_send_file() and the helpers built on top of #PSocket) and
+ * the time spent in p_socket_io_condition_wait(), which is where a blocking
+ * socket waits. They are updated without any locking, so do not use the same
+ * socket from several threads while the counters are enabled.
+ */
+P_LIB_API pboolean		p_socket_set_stats_enabled	(PSocket		*socket,
+								 pboolean		enabled,
+								 PError			**error);
+
+/**
+ * @brief Gets I/O statistics counters of a @a socket.
+ * @param socket #PSocket to get the counters for.
+ * @param[out] stats Counters to fill in.
+ * @return TRUE in case of success, FALSE if the counters are disabled.
+ * @since 0.0.5
+ * @sa p_socket_set_stats_enabled()
+ *
+ * A would-block result of a blocking socket is retried internally, so high
+ * PSocketStats::would_block and PSocketStats::syscalls values compared to
+ * PSocketStats::packets_received point to wasted wakeups.
+ */
+P_LIB_API pboolean		p_socket_get_stats		(const PSocket		*socket,
+								 PSocketStats		*stats);
+
+/**
+ * @brief Resets I/O statistics counters of a @a socket to zero.
+ * @param socket #PSocket to reset the counters for.
+ * @since 0.0.5
+ */
+P_LIB_API void			p_socket_reset_stats		(PSocket		*socket);
+
 /**
  * @brief Waits for a specified I/O @a condition on @a socket.
  * @param socket #PSocket to wait for @a condition on.
@@ -768,7 +1481,8 @@ P_LIB_API pboolean		p_socket_set_buffer_size	(const PSocket		*socket,
  * Waits until @a condition will be met on @a socket or an error occurred. If
  * timeout was set using p_socket_set_timeout() and a network I/O operation
  * doesn't finish until timeout expired, call will fail with
- * #P_ERROR_IO_TIMED_OUT error code.
+ * #P_ERROR_IO_TIMED_OUT error code. The same happens when the deadline set
+ * with p_socket_set_deadline() expires.
  */
 P_LIB_API pboolean		p_socket_io_condition_wait	(const PSocket		*socket,
 								 PSocketIOCondition	condition,
@@ -23,9 +23,12 @@
  * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include "patomic.h"
 #include "pmem.h"
+#include "pmempool.h"
 #include "pstring.h"
 #include "psocketaddress.h"
+#include "pfasthash-xxh3.h"
 #include "plibsys-private.h"
 
 #include <stdlib.h>
@@ -76,73 +79,313 @@
 #  endif
 #endif
 
+/* Windows 10 SDK provides struct sockaddr_un in a separate header */
+#ifdef P_OS_WIN
+#  ifdef PLIBSYS_HAS_AFUNIX
+#    include <afunix.h>
+#    define P_SOCKET_ADDRESS_HAS_UNIX
+#  endif
+#elif defined (AF_UNIX)
+#  include <sys/un.h>
+#  include <stddef.h>
+#  define P_SOCKET_ADDRESS_HAS_UNIX
+#endif
+
+#ifdef P_SOCKET_ADDRESS_HAS_UNIX
+#  define P_SOCKET_ADDRESS_UNIX_PATH_SIZE	sizeof (((struct sockaddr_un *) NULL)->sun_path)
+#  define P_SOCKET_ADDRESS_UNIX_PATH_OFFSET	offsetof (struct sockaddr_un, sun_path)
+#endif
+
 struct PSocketAddress_ {
 	PSocketFamily	family;
 	union addr_ {
 		struct in_addr sin_addr;
 #ifdef AF_INET6
 		struct in6_addr sin6_addr;
+#endif
+#ifdef P_SOCKET_ADDRESS_HAS_UNIX
+		/* Used bytes of sun_path without the trailing zero, abstract
+		 * names start with a zero byte, unbound sockets have no path */
+		struct {
+			pchar	path[P_SOCKET_ADDRESS_UNIX_PATH_SIZE];
+			psize	path_len;
+		} un;
 #endif
 	} 		addr;
 	puint16 	port;
 	puint32		flowinfo;
 	puint32		scope_id;
+	pint		pool_gen;
 };
 
+/* Family, port, address and scope ID */
+#define P_SOCKET_ADDRESS_KEY_SIZE	(3 + sizeof (union addr_) + sizeof (puint32))
+
+/* Addresses are created and freed for every accepted connection, so they are
+ * recycled through a pool instead of the general allocator */
+static PMemPool * volatile pp_socket_address_pool = NULL;
+
+/* Generation of the current pool, bumped when the pool is retired */
+static volatile pint pp_socket_address_pool_gen = 0;
+
+static PSocketAddress * pp_socket_address_alloc (void);
+static void pp_socket_address_release (PSocketAddress *addr);
+static psize pp_socket_address_get_key (const PSocketAddress *addr, puchar *key);
+#ifdef P_SOCKET_ADDRESS_HAS_UNIX
+static PSocketAddress * pp_socket_address_new_unix (const pchar *name, pboolean abstract);
+static pchar * pp_socket_address_get_unix_name (const PSocketAddress *addr);
+#endif
+
+static PSocketAddress *
+pp_socket_address_alloc (void)
+{
+	PMemPool	*pool = p_atomic_pointer_get (&pp_socket_address_pool);
+	PSocketAddress	*addr;
+
+	/* Created on the first use, a failed creation is retried next time */
+	if (P_UNLIKELY (pool == NULL)) {
+		if (P_UNLIKELY ((pool = p_mem_pool_new (sizeof (PSocketAddress))) == NULL))
+			return NULL;
+
+		if (p_atomic_pointer_compare_and_exchange (&pp_socket_address_pool, NULL, pool) == FALSE) {
+			p_mem_pool_free (pool);
+			pool = p_atomic_pointer_get (&pp_socket_address_pool);
+		}
+	}
+
+	if (P_UNLIKELY ((addr = p_mem_pool_alloc0 (pool)) == NULL))
+		return NULL;
+
+	addr->pool_gen = p_atomic_int_get (&pp_socket_address_pool_gen);
+
+	return addr;
+}
+
+static void
+pp_socket_address_release (PSocketAddress *addr)
+{
+	/* Addresses of a retired pool stay valid until the process exits */
+	if (P_UNLIKELY (addr->pool_gen != p_atomic_int_get (&pp_socket_address_pool_gen)))
+		return;
+
+	p_mem_pool_release (pp_socket_address_pool, addr);
+}
+
+void
+p_socket_address_shutdown (void)
+{
+	if (pp_socket_address_pool == NULL)
+		return;
+
+	/* Addresses still alive keep using the pool memory, so it is retired
+	 * instead: they can be used and freed, but the memory is not reclaimed */
+	if (p_mem_pool_get_used_count (pp_socket_address_pool) == 0)
+		p_mem_pool_free (pp_socket_address_pool);
+
+	pp_socket_address_pool = NULL;
+	p_atomic_int_inc (&pp_socket_address_pool_gen);
+}
+
+/* Serializes the identity fields of an address into P_SOCKET_ADDRESS_KEY_SIZE
+ * bytes at most */
+static psize
+pp_socket_address_get_key (const PSocketAddress	*addr,
+			   puchar		*key)
+{
+	psize len = 0;
+
+	key[len++] = (puchar) addr->family;
+	key[len++] = (puchar) (addr->port >> 8);
+	key[len++] = (puchar) (addr->port & 0xFF);
+
+	if (addr->family == P_SOCKET_FAMILY_INET) {
+		memcpy (key + len, &addr->addr.sin_addr, sizeof (struct in_addr));
+		len += sizeof (struct in_addr);
+	}
+#ifdef AF_INET6
+	else if (addr->family == P_SOCKET_FAMILY_INET6) {
+		memcpy (key + len, &addr->addr.sin6_addr, sizeof (struct in6_addr));
+		len += sizeof (struct in6_addr);
+
+		memcpy (key + len, &addr->scope_id, sizeof (puint32));
+		len += sizeof (puint32);
+	}
+#endif
+#ifdef P_SOCKET_ADDRESS_HAS_UNIX
+	else if (addr->family == P_SOCKET_FAMILY_UNIX) {
+		memcpy (key + len, addr->addr.un.path, addr->addr.un.path_len);
+		len += addr->addr.un.path_len;
+	}
+#endif
+
+	return len;
+}
+
+#ifdef P_SOCKET_ADDRESS_HAS_UNIX
+static PSocketAddress *
+pp_socket_address_new_unix (const pchar	*name,
+			    pboolean	abstract)
+{
+	PSocketAddress	*ret;
+	psize		len;
+
+	if (P_UNLIKELY (name == NULL))
+		return NULL;
+
+	len = strlen (name) + (abstract ? 1 : 0);
+
+	/* Keep a room for the trailing zero, some systems require it */
+	if (P_UNLIKELY (len == 0 || (abstract && len == 1) || len >= P_SOCKET_ADDRESS_UNIX_PATH_SIZE))
+		return NULL;
+
+	if (P_UNLIKELY ((ret = pp_socket_address_alloc ()) == NULL)) {
+		P_ERROR ("PSocketAddress::pp_socket_address_new_unix: failed to allocate memory");
+		return NULL;
+	}
+
+	ret->family = P_SOCKET_FAMILY_UNIX;
+
+	memcpy (ret->addr.un.path + (abstract ? 1 : 0), name, strlen (name));
+	ret->addr.un.path_len = len;
+
+	return ret;
+}
+
+static pchar *
+pp_socket_address_get_unix_name (const PSocketAddress *addr)
+{
+	const pchar	*name = addr->addr.un.path;
+	psize		len   = addr->addr.un.path_len;
+	pchar		*ret;
+
+	if (len > 0 && name[0] == '\0') {
+		++name;
+		--len;
+	}
+
+	if (P_UNLIKELY ((ret = p_malloc0 (len + 1)) == NULL)) {
+		P_ERROR ("PSocketAddress::pp_socket_address_get_unix_name: failed to allocate memory");
+		return NULL;
+	}
+
+	memcpy (ret, name, len);
+
+	return ret;
+}
+#endif
+
 P_LIB_API PSocketAddress *
 p_socket_address_new_from_native (pconstpointer	native,
 				  psize		len)
 {
-	PSocketAddress	*ret;
-	puint16		family;
+	PSocketAddress *ret;
 
 	if (P_UNLIKELY (native == NULL || len == 0))
 		return NULL;
 
-	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PSocketAddress))) == NULL))
+	if (P_UNLIKELY ((ret = pp_socket_address_alloc ()) == NULL))
 		return NULL;
 
+	if (P_UNLIKELY (p_socket_address_set_from_native (ret, native, len) == FALSE)) {
+		pp_socket_address_release (ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+P_LIB_API pboolean
+p_socket_address_set_from_native (PSocketAddress	*addr,
+				  pconstpointer		native,
+				  psize			len)
+{
+	puint16 family;
+
+	if (P_UNLIKELY (addr == NULL || native == NULL || len == 0))
+		return FALSE;
+
 	family = ((struct sockaddr *) native)->sa_family;
 
 	if (family == AF_INET) {
 		if (len < sizeof (struct sockaddr_in)) {
-			P_WARNING ("PSocketAddress::p_socket_address_new_from_native: invalid IPv4 native size");
-			p_free (ret);
-			return NULL;
+			P_WARNING ("PSocketAddress::p_socket_address_set_from_native: invalid IPv4 native size");
+			return FALSE;
 		}
 
-		memcpy (&ret->addr.sin_addr, &((struct sockaddr_in *) native)->sin_addr, sizeof (struct in_addr));
-		ret->family = P_SOCKET_FAMILY_INET;
-		ret->port   = p_ntohs (((struct sockaddr_in *) native)->sin_port);
-		return ret;
+		memcpy (&addr->addr.sin_addr, &((struct sockaddr_in *) native)->sin_addr, sizeof (struct in_addr));
+		addr->family   = P_SOCKET_FAMILY_INET;
+		addr->port     = p_ntohs (((struct sockaddr_in *) native)->sin_port);
+		addr->flowinfo = 0;
+		addr->scope_id = 0;
+		return TRUE;
 	}
 #ifdef AF_INET6
 	else if (family == AF_INET6) {
 		if (len < sizeof (struct sockaddr_in6)) {
-			P_WARNING ("PSocketAddress::p_socket_address_new_from_native: invalid IPv6 native size");
-			p_free (ret);
-			return NULL;
+			P_WARNING ("PSocketAddress::p_socket_address_set_from_native: invalid IPv6 native size");
+			return FALSE;
 		}
 
-		memcpy (&ret->addr.sin6_addr,
+		memcpy (&addr->addr.sin6_addr,
 			&((struct sockaddr_in6 *) native)->sin6_addr,
 			sizeof (struct in6_addr));
 
-		ret->family   = P_SOCKET_FAMILY_INET6;
-		ret->port     = p_ntohs (((struct sockaddr_in *) native)->sin_port);
+		addr->family   = P_SOCKET_FAMILY_INET6;
+		addr->port     = p_ntohs (((struct sockaddr_in *) native)->sin_port);
+		addr->flowinfo = 0;
+		addr->scope_id = 0;
 #ifdef PLIBSYS_SOCKADDR_IN6_HAS_FLOWINFO
-		ret->flowinfo = ((struct sockaddr_in6 *) native)->sin6_flowinfo;
+		addr->flowinfo = ((struct sockaddr_in6 *) native)->sin6_flowinfo;
 #endif
 #ifdef PLIBSYS_SOCKADDR_IN6_HAS_SCOPEID
-		ret->scope_id = ((struct sockaddr_in6 *) native)->sin6_scope_id;
+		addr->scope_id = ((struct sockaddr_in6 *) native)->sin6_scope_id;
 #endif
-		return ret;
+		return TRUE;
 	}
 #endif
-	else {
-		p_free (ret);
-		return NULL;
+#ifdef P_SOCKET_ADDRESS_HAS_UNIX
+	else if (family == AF_UNIX) {
+		const pchar	*path;
+		psize		path_len;
+		psize		i;
+
+		if (len < P_SOCKET_ADDRESS_UNIX_PATH_OFFSET) {
+			P_WARNING ("PSocketAddress::p_socket_address_set_from_native: invalid local native size");
+			return FALSE;
+		}
+
+		path     = ((const struct sockaddr_un *) native)->sun_path;
+		path_len = len - P_SOCKET_ADDRESS_UNIX_PATH_OFFSET;
+
+		if (path_len > P_SOCKET_ADDRESS_UNIX_PATH_SIZE)
+			path_len = P_SOCKET_ADDRESS_UNIX_PATH_SIZE;
+
+#  ifdef P_OS_LINUX
+		/* Linux counts all the bytes of an abstract name, other systems
+		 * may report a zero-filled path for unbound sockets */
+		if (path_len == 0 || path[0] != '\0') {
+#  endif
+			for (i = 0; i < path_len && path[i] != '\0'; ++i)
+				;
+
+			path_len = i;
+#  ifdef P_OS_LINUX
+		}
+#  endif
+
+		memset (&addr->addr, 0, sizeof (addr->addr));
+		memcpy (addr->addr.un.path, path, path_len);
+
+		addr->addr.un.path_len = path_len;
+		addr->family           = P_SOCKET_FAMILY_UNIX;
+		addr->port             = 0;
+		addr->flowinfo         = 0;
+		addr->scope_id         = 0;
+		return TRUE;
 	}
+#endif
+	else
+		return FALSE;
 }
 
 P_LIB_API PSocketAddress *
@@ -194,7 +437,7 @@ p_socket_address_new (const pchar	*address,
 	}
 #endif
 
-	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PSocketAddress))) == NULL)) {
+	if (P_UNLIKELY ((ret = pp_socket_address_alloc ()) == NULL)) {
 		P_ERROR ("PSocketAddress::p_socket_address_new: failed to allocate memory");
 		return NULL;
 	}
@@ -235,7 +478,7 @@ p_socket_address_new (const pchar	*address,
 #  endif /* AF_INET6 */
 #endif /* P_OS_WIN */
 
-	p_free (ret);
+	pp_socket_address_release (ret);
 	return NULL;
 }
 
@@ -249,7 +492,7 @@ p_socket_address_new_any (PSocketFamily	family,
 	struct in6_addr	any6_addr = IN6ADDR_ANY_INIT;
 #endif
 
-	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PSocketAddress))) == NULL)) {
+	if (P_UNLIKELY ((ret = pp_socket_address_alloc ()) == NULL)) {
 		P_ERROR ("PSocketAddress::p_socket_address_new_any: failed to allocate memory");
 		return NULL;
 	}
@@ -261,7 +504,7 @@ p_socket_address_new_any (PSocketFamily	family,
 		memcpy (&ret->addr.sin6_addr, &any6_addr.s6_addr, sizeof (any6_addr.s6_addr));
 #endif
 	else {
-		p_free (ret);
+		pp_socket_address_release (ret);
 		return NULL;
 	}
 
@@ -281,7 +524,7 @@ p_socket_address_new_loopback (PSocketFamily	family,
 	struct in6_addr	loop6_addr = IN6ADDR_LOOPBACK_INIT;
 #endif
 
-	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PSocketAddress))) == NULL)) {
+	if (P_UNLIKELY ((ret = pp_socket_address_alloc ()) == NULL)) {
 		P_ERROR ("PSocketAddress::p_socket_address_new_loopback: failed to allocate memory");
 		return NULL;
 	}
@@ -293,7 +536,7 @@ p_socket_address_new_loopback (PSocketFamily	family,
 		memcpy (&ret->addr.sin6_addr, &loop6_addr.s6_addr, sizeof (loop6_addr.s6_addr));
 #endif
 	else {
-		p_free (ret);
+		pp_socket_address_release (ret);
 		return NULL;
 	}
 
@@ -303,6 +546,28 @@ p_socket_address_new_loopback (PSocketFamily	family,
 	return ret;
 }
 
+P_LIB_API PSocketAddress *
+p_socket_address_new_unix (const pchar *path)
+{
+#ifdef P_SOCKET_ADDRESS_HAS_UNIX
+	return pp_socket_address_new_unix (path, FALSE);
+#else
+	P_UNUSED (path);
+	return NULL;
+#endif
+}
+
+P_LIB_API PSocketAddress *
+p_socket_address_new_unix_abstract (const pchar *name)
+{
+#if defined (P_SOCKET_ADDRESS_HAS_UNIX) && defined (P_OS_LINUX)
+	return pp_socket_address_new_unix (name, TRUE);
+#else
+	P_UNUSED (name);
+	return NULL;
+#endif
+}
+
 P_LIB_API pboolean
 p_socket_address_to_native (const PSocketAddress	*addr,
 			    ppointer			dest,
@@ -351,6 +616,20 @@ p_socket_address_to_native (const PSocketAddress	*addr,
 #endif
 		return TRUE;
 	}
+#endif
+#ifdef P_SOCKET_ADDRESS_HAS_UNIX
+	else if (addr->family == P_SOCKET_FAMILY_UNIX) {
+		/* Only the used part of the structure may fit into the buffer */
+		if (P_UNLIKELY (destlen < p_socket_address_get_native_size (addr))) {
+			P_WARNING ("PSocketAddress::p_socket_address_to_native: invalid buffer size for local address");
+			return FALSE;
+		}
+
+		memset (dest, 0, p_socket_address_get_native_size (addr));
+		memcpy (((struct sockaddr_un *) dest)->sun_path, addr->addr.un.path, addr->addr.un.path_len);
+		((struct sockaddr_un *) dest)->sun_family = AF_UNIX;
+		return TRUE;
+	}
 #endif
 	else {
 		P_WARNING ("PSocketAddress::p_socket_address_to_native: unsupported socket address");
@@ -369,6 +648,17 @@ p_socket_address_get_native_size (const PSocketAddress *addr)
 #ifdef AF_INET6
 	else if (addr->family == P_SOCKET_FAMILY_INET6)
 		return sizeof (struct sockaddr_in6);
+#endif
+#ifdef P_SOCKET_ADDRESS_HAS_UNIX
+	else if (addr->family == P_SOCKET_FAMILY_UNIX) {
+		/* Abstract names are passed with the exact length */
+		if (addr->addr.un.path_len > 0 && addr->addr.un.path[0] == '\0')
+			return P_SOCKET_ADDRESS_UNIX_PATH_OFFSET + addr->addr.un.path_len;
+		else if (addr->addr.un.path_len > 0)
+			return P_SOCKET_ADDRESS_UNIX_PATH_OFFSET + addr->addr.un.path_len + 1;
+		else
+			return P_SOCKET_ADDRESS_UNIX_PATH_OFFSET;
+	}
 #endif
 	else {
 		P_WARNING ("PSocketAddress::p_socket_address_get_native_size: unsupported socket family");
@@ -406,6 +696,12 @@ p_socket_address_get_address (const PSocketAddress *addr)
 
 	if (P_UNLIKELY (addr == NULL || addr->family == P_SOCKET_FAMILY_UNKNOWN))
 		return NULL;
+
+#ifdef P_SOCKET_ADDRESS_HAS_UNIX
+	if (addr->family == P_SOCKET_FAMILY_UNIX)
+		return pp_socket_address_get_unix_name (addr);
+#endif
+
 #ifdef P_OS_WIN
 	sin = (struct sockaddr_in *) &sa;
 #  ifdef AF_INET6
@@ -564,6 +860,26 @@ p_socket_address_is_ipv6_supported (void)
 #endif
 }
 
+P_LIB_API pboolean
+p_socket_address_is_unix_supported (void)
+{
+#if defined (P_OS_WIN) && defined (P_SOCKET_ADDRESS_HAS_UNIX)
+	SOCKET sock;
+
+	/* The SDK may be newer than the system, ask the network stack */
+	if ((sock = socket (AF_UNIX, SOCK_STREAM, 0)) == INVALID_SOCKET)
+		return FALSE;
+
+	closesocket (sock);
+
+	return TRUE;
+#elif defined (P_SOCKET_ADDRESS_HAS_UNIX)
+	return TRUE;
+#else
+	return FALSE;
+#endif
+}
+
 P_LIB_API pboolean
 p_socket_address_is_any (const PSocketAddress *addr)
 {
@@ -578,12 +894,11 @@ p_socket_address_is_any (const PSocketAddress *addr)
 		return (addr4 == INADDR_ANY);
 	}
 #ifdef AF_INET6
-	else
+	else if (addr->family == P_SOCKET_FAMILY_INET6)
 		return IN6_IS_ADDR_UNSPECIFIED (&addr->addr.sin6_addr);
-#else
+#endif
 	else
 		return FALSE;
-#endif
 }
 
 P_LIB_API pboolean
@@ -601,12 +916,98 @@ p_socket_address_is_loopback (const PSocketAddress *addr)
 		return ((addr4 & 0xff000000) == 0x7f000000);
 	}
 #ifdef AF_INET6
-	else
+	else if (addr->family == P_SOCKET_FAMILY_INET6)
 		return IN6_IS_ADDR_LOOPBACK (&addr->addr.sin6_addr);
-#else
+#endif
 	else
 		return FALSE;
+}
+
+P_LIB_API pboolean
+p_socket_address_is_unix_abstract (const PSocketAddress *addr)
+{
+#ifdef P_SOCKET_ADDRESS_HAS_UNIX
+	if (P_UNLIKELY (addr == NULL || addr->family != P_SOCKET_FAMILY_UNIX))
+		return FALSE;
+
+	return addr->addr.un.path_len > 0 && addr->addr.un.path[0] == '\0';
+#else
+	P_UNUSED (addr);
+	return FALSE;
+#endif
+}
+
+P_LIB_API puint
+p_socket_address_hash (pconstpointer addr)
+{
+	const PSocketAddress	*sa = (const PSocketAddress *) addr;
+	puchar			key[P_SOCKET_ADDRESS_KEY_SIZE];
+	psize			len;
+	puint64			hash;
+
+	if (P_UNLIKELY (sa == NULL))
+		return 0;
+
+	/* Same fields as p_socket_address_equal() */
+	len = pp_socket_address_get_key (sa, key);
+
+	hash = p_fast_hash_xxh3_64_compute (key, len, 0);
+
+	return (puint) (hash ^ (hash >> 32));
+}
+
+P_LIB_API pboolean
+p_socket_address_equal (pconstpointer	a,
+			pconstpointer	b)
+{
+	return p_socket_address_compare (a, b) == 0;
+}
+
+P_LIB_API pint
+p_socket_address_compare (pconstpointer	a,
+			  pconstpointer	b)
+{
+	const PSocketAddress	*sa = (const PSocketAddress *) a;
+	const PSocketAddress	*sb = (const PSocketAddress *) b;
+	pint			ret;
+
+	if (sa == sb)
+		return 0;
+
+	if (sa == NULL)
+		return -1;
+
+	if (sb == NULL)
+		return 1;
+
+	if (sa->family != sb->family)
+		return sa->family < sb->family ? -1 : 1;
+
+	if (sa->family == P_SOCKET_FAMILY_INET)
+		ret = memcmp (&sa->addr.sin_addr, &sb->addr.sin_addr, sizeof (struct in_addr));
+#ifdef AF_INET6
+	else if (sa->family == P_SOCKET_FAMILY_INET6)
+		ret = memcmp (&sa->addr.sin6_addr, &sb->addr.sin6_addr, sizeof (struct in6_addr));
+#endif
+#ifdef P_SOCKET_ADDRESS_HAS_UNIX
+	else if (sa->family == P_SOCKET_FAMILY_UNIX && sa->addr.un.path_len != sb->addr.un.path_len)
+		ret = sa->addr.un.path_len < sb->addr.un.path_len ? -1 : 1;
+	else if (sa->family == P_SOCKET_FAMILY_UNIX)
+		ret = memcmp (sa->addr.un.path, sb->addr.un.path, sa->addr.un.path_len);
 #endif
+	else
+		ret = 0;
+
+	if (ret != 0)
+		return ret < 0 ? -1 : 1;
+
+	if (sa->port != sb->port)
+		return sa->port < sb->port ? -1 : 1;
+
+	if (sa->family == P_SOCKET_FAMILY_INET6 && sa->scope_id != sb->scope_id)
+		return sa->scope_id < sb->scope_id ? -1 : 1;
+
+	return 0;
 }
 
 P_LIB_API void
@@ -615,5 +1016,5 @@ p_socket_address_free (PSocketAddress *addr)
 	if (P_UNLIKELY (addr == NULL))
 		return;
 
-	p_free (addr);
+	pp_socket_address_release (addr);
 }
@@ -43,13 +43,30 @@
  * for all the platforms. Sometimes you may also need to enable IPv6 support in
  * the system to make it working.
  *
+ * Local (UNIX domain) addresses are created with p_socket_address_new_unix()
+ * from a file system path, and on Linux also in the abstract namespace with
+ * p_socket_address_new_unix_abstract(). They have no port, and
+ * p_socket_address_get_address() returns the path (or the abstract name) for
+ * them. Windows supports them starting from Windows 10 and only with stream
+ * sockets, check p_socket_address_is_unix_supported() at run-time.
+ *
  * Convenient methods to create special addresses are provided: for the loopback
  * interface use p_socket_address_new_loopback(), for the any-address interface
  * use p_socket_address_new_any().
  *
  * If you want to get the underlying native address structure for further usage
  * in system calls use p_socket_address_to_native(), and
- * p_socket_address_new_from_native() for a vice versa conversion.
+ * p_socket_address_new_from_native() for a vice versa conversion. An existing
+ * object can be updated in place with p_socket_address_set_from_native(), i.e.
+ * to reuse a single address for every received datagram.
+ *
+ * Address objects are recycled through a per-thread cached pool (see
+ * #PMemPool) rather than allocated from the heap every time, so servers
+ * creating an address per connection don't stress the general allocator.
+ *
+ * Free all the addresses before calling p_libsys_shutdown(), the pool is
+ * released there. Addresses still alive at that point remain usable, but
+ * their memory is not reclaimed until the program exits.
  */
 
 #if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
@@ -75,9 +92,14 @@ typedef enum PSocketFamily_ {
 	P_SOCKET_FAMILY_UNKNOWN = 0,		/**< Unknown family.	*/
 	P_SOCKET_FAMILY_INET	= AF_INET,	/**< IPv4 family.	*/
 #ifdef AF_INET6
-	P_SOCKET_FAMILY_INET6	= AF_INET6	/**< IPv6 family.	*/
+	P_SOCKET_FAMILY_INET6	= AF_INET6,	/**< IPv6 family.	*/
 #else
-	P_SOCKET_FAMILY_INET6	= -1		/**< No IPv6 family.	*/
+	P_SOCKET_FAMILY_INET6	= -1,		/**< No IPv6 family.	*/
+#endif
+#ifdef AF_UNIX
+	P_SOCKET_FAMILY_UNIX	= AF_UNIX	/**< Local family.	*/
+#else
+	P_SOCKET_FAMILY_UNIX	= -2		/**< No local family.	*/
 #endif
 } PSocketFamily;
 
@@ -94,6 +116,21 @@ typedef struct PSocketAddress_ PSocketAddress;
 P_LIB_API PSocketAddress *	p_socket_address_new_from_native	(pconstpointer		native,
 									 psize			len);
 
+/**
+ * @brief Updates #PSocketAddress from the native socket address raw data.
+ * @param addr #PSocketAddress to update.
+ * @param native Pointer to the native socket address raw data.
+ * @param len Raw data length, in bytes.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * Does the same conversion as p_socket_address_new_from_native() but without
+ * allocating a new object. In case of failure @a addr is left untouched.
+ */
+P_LIB_API pboolean		p_socket_address_set_from_native	(PSocketAddress		*addr,
+									 pconstpointer		native,
+									 psize			len);
+
 /**
  * @brief Creates new #PSocketAddress.
  * @param address String representation of an address (i.e. "172.146.45.5").
@@ -138,6 +175,33 @@ P_LIB_API PSocketAddress *	p_socket_address_new_any		(PSocketFamily		family,
 P_LIB_API PSocketAddress *	p_socket_address_new_loopback		(PSocketFamily		family,
 									 puint16		port);
 
+/**
+ * @brief Creates new local (UNIX domain) #PSocketAddress.
+ * @param path File system path of the socket.
+ * @return Pointer to #PSocketAddress in case of success, NULL otherwise.
+ * @since 0.0.5
+ *
+ * The path must be shorter than the native limit, which is about 100 bytes
+ * (108 bytes on Linux and Windows, 104 bytes on BSD and macOS).
+ *
+ * Binding a socket creates a file at the @a path, it is not removed when the
+ * socket is closed. Remove the file yourself, binding fails if it exists.
+ */
+P_LIB_API PSocketAddress *	p_socket_address_new_unix		(const pchar		*path);
+
+/**
+ * @brief Creates new local (UNIX domain) #PSocketAddress in the abstract
+ * namespace.
+ * @param name Name of the socket, not empty.
+ * @return Pointer to #PSocketAddress in case of success, NULL otherwise.
+ * @since 0.0.5
+ *
+ * Abstract sockets exist only on Linux. They don't appear in the file system
+ * and vanish along with the last socket bound to them, so there is nothing to
+ * clean up after a crash. Returns NULL on the other systems.
+ */
+P_LIB_API PSocketAddress *	p_socket_address_new_unix_abstract	(const pchar		*name);
+
 /**
  * @brief Converts #PSocketAddress to the native socket address raw data.
  * @param addr #PSocketAddress to convert.
@@ -173,6 +237,10 @@ P_LIB_API PSocketFamily		p_socket_address_get_family		(const PSocketAddress	*add
  * @return Pointer to the string representation of the socket address in case of
  * success, NULL otherwise. The caller takes ownership of the returned pointer.
  * @since 0.0.1
+ *
+ * For a local address this is the path or the abstract name of the socket, or
+ * an empty string if the socket is not bound (i.e. the peer of a connected
+ * client socket).
  */
 P_LIB_API pchar *		p_socket_address_get_address		(const PSocketAddress	*addr);
 
@@ -251,6 +319,16 @@ P_LIB_API pboolean		p_socket_address_is_scope_id_supported	(void);
  */
 P_LIB_API pboolean		p_socket_address_is_ipv6_supported	(void);
 
+/**
+ * @brief Checks whether local (UNIX domain) sockets are supported.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * On Windows the check is done at run-time, local sockets are available
+ * starting from Windows 10 (build 17063).
+ */
+P_LIB_API pboolean		p_socket_address_is_unix_supported	(void);
+
 /**
  * @brief Checks whether a given socket address is an any-address
  * representation. Such an address is a 0.0.0.0.
@@ -272,6 +350,67 @@ P_LIB_API pboolean		p_socket_address_is_any			(const PSocketAddress	*addr);
  */
 P_LIB_API pboolean		p_socket_address_is_loopback		(const PSocketAddress	*addr);
 
+/**
+ * @brief Checks whether a given socket address is a local (UNIX domain)
+ * address in the abstract namespace.
+ * @param addr #PSocketAddress to check.
+ * @return TRUE if the @a addr is in the abstract namespace, FALSE otherwise.
+ * @since 0.0.5
+ * @sa p_socket_address_new_unix_abstract()
+ */
+P_LIB_API pboolean		p_socket_address_is_unix_abstract	(const PSocketAddress	*addr);
+
+/**
+ * @brief Calculates a hash value of a socket address.
+ * @param addr #PSocketAddress to calculate the hash value for.
+ * @return Hash value of the address, 0 for NULL.
+ * @since 0.0.5
+ * @sa p_socket_address_equal(), p_socket_address_compare()
+ *
+ * The hash covers the family, the binary IP address, the port and the IPv6
+ * scope ID, the same fields p_socket_address_equal() compares. Together they
+ * allow to use addresses as #PHashTable keys directly:
+ * @code
+ * table = p_hash_table_new_full (p_socket_address_hash,
+ *                                p_socket_address_equal,
+ *                                NULL,
+ *                                NULL);
+ * @endcode
+ */
+P_LIB_API puint			p_socket_address_hash			(pconstpointer		addr);
+
+/**
+ * @brief Checks whether two socket addresses are equal.
+ * @param a First #PSocketAddress to compare.
+ * @param b Second #PSocketAddress to compare.
+ * @return TRUE if the addresses are equal, FALSE otherwise.
+ * @since 0.0.5
+ * @sa p_socket_address_hash(), p_socket_address_compare()
+ *
+ * Two addresses are equal if they have the same family, binary IP address,
+ * port and IPv6 scope ID. The IPv6 flow information is not a part of the
+ * peer identity and is ignored.
+ */
+P_LIB_API pboolean		p_socket_address_equal			(pconstpointer		a,
+									 pconstpointer		b);
+
+/**
+ * @brief Compares two socket addresses.
+ * @param a First #PSocketAddress to compare.
+ * @param b Second #PSocketAddress to compare.
+ * @return Less than 0 if @a a is less than @a b, 0 if they are equal, greater
+ * than 0 otherwise.
+ * @since 0.0.5
+ * @sa p_socket_address_equal()
+ *
+ * Addresses are ordered by the family, then by the binary IP address in the
+ * network byte order, then by the port and the IPv6 scope ID, so an ordered
+ * #PTree keeps addresses of the same host together. NULL is less than any
+ * address. The signature matches #PCompareFunc.
+ */
+P_LIB_API pint			p_socket_address_compare		(pconstpointer		a,
+									 pconstpointer		b);
+
 /**
  * @brief Frees a socket address structure and its resources.
  * @param addr #PSocketAddress to free.
@@ -0,0 +1,1848 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "phashtable.h"
+#include "pmem.h"
+#include "pmutex.h"
+#include "psocketasync.h"
+#include "psocketpoller.h"
+#include "pthreadpool.h"
+#include "ptimeprofiler.h"
+#include "perror-private.h"
+#include "pfile-private.h"
+
+#include <string.h>
+
+#ifdef PLIBSYS_HAS_IO_URING
+#  define P_SOCKET_ASYNC_USE_IO_URING
+#  include "psysclose-private.h"
+
+#  include <linux/io_uring.h>
+#  include <sys/mman.h>
+#  include <sys/socket.h>
+#  include <sys/syscall.h>
+#  include <sys/uio.h>
+#  include <errno.h>
+#  include <poll.h>
+#  include <unistd.h>
+
+/* Zero-copy send appeared in Linux 6.0 */
+#  ifdef IORING_RECVSEND_FIXED_BUF
+#    define P_SOCKET_ASYNC_HAS_SEND_ZC
+#  endif
+#endif
+
+#define P_SOCKET_ASYNC_DEFAULT_QUEUE_SIZE	256
+#define P_SOCKET_ASYNC_MAX_QUEUE_SIZE		32768
+#define P_SOCKET_ASYNC_MAX_TRANSFER		0x7FFFF000
+#define P_SOCKET_ASYNC_POLLER_EVENTS		64
+/* Number of threads running the emulated file operations */
+#define P_SOCKET_ASYNC_FILE_WORKERS		4
+/* Marks a socket which is reported by the poller */
+#define P_SOCKET_ASYNC_READY_MARK		0x100
+
+#ifdef P_SOCKET_ASYNC_USE_IO_URING
+/* Kernel limit for the registered buffers */
+#  define P_SOCKET_ASYNC_MAX_BUFFERS		16384
+#else
+#  define P_SOCKET_ASYNC_MAX_BUFFERS		P_MAXINT32
+#endif
+
+typedef struct PSocketAsyncOp_ {
+	PSocketAsyncOperation	operation;
+	PSocket			*socket;
+	PFile			*file;
+	PSocketAsync		*async;
+	ppointer		user_data;
+	pchar			*buffer;
+	psize			buflen;
+	pint			buffer_index;
+	struct sockaddr_storage	address;
+	socklen_t		address_len;
+	pssize			zc_result;
+	puint64			offset;
+	/* Result of the emulated file operation */
+	pssize			file_result;
+	PErrorIO		file_error;
+	pint			file_native_error;
+	puint			data_only	: 1;
+	puint			ready		: 1;
+	puint			connecting	: 1;
+	puint			polling		: 1;
+	puint			cancelled	: 1;
+	struct PSocketAsyncOp_	*next_free;
+} PSocketAsyncOp;
+
+struct PSocketAsync_ {
+	PSocketAsyncOp		*ops;
+	PSocketAsyncOp		*free_ops;
+	pint			queue_size;
+	pint			pending;
+	PSocketVector		*buffers;
+	psize			n_buffers;
+	/* Poller emulation */
+	PSocketAsyncOp		**waiting;
+	pint			waiting_count;
+	PSocketPoller		*poller;
+	PHashTable		*conditions;
+	PSocket			**polled;
+	pint			polled_count;
+	PSocketPollerEvent	*events;
+	/* Thread pool emulation of the file operations */
+	PThreadPool		*file_pool;
+	PMutex			*file_mutex;
+	PSocketAsyncOp		**file_done;
+	pint			file_done_count;
+	pint			file_running;
+	PSocket			*wake_socket;
+	PSocketAddress		*wake_address;
+#ifdef P_SOCKET_ASYNC_USE_IO_URING
+	pint			ring_fd;
+	ppointer		ring;
+	psize			ring_size;
+	struct io_uring_sqe	*sqes;
+	psize			sqes_size;
+	puint			*sq_head;
+	puint			*sq_tail;
+	puint			*sq_array;
+	puint			sq_mask;
+	puint			sq_entries;
+	puint			*cq_head;
+	puint			*cq_tail;
+	puint			cq_mask;
+	struct io_uring_cqe	*cqes;
+	puint			to_submit;
+	pboolean		has_send_zc;
+#endif
+};
+
+static PSocketAsyncOp * pp_socket_async_op_new (PSocketAsync *async, PSocket *socket, PFile *file,
+						PSocketAsyncOperation operation, ppointer user_data,
+						PError **error);
+static void pp_socket_async_op_release (PSocketAsync *async, PSocketAsyncOp *op);
+static void pp_socket_async_op_submit (PSocketAsync *async, PSocketAsyncOp *op);
+static void pp_socket_async_set_completion (PSocketAsyncOp *op, PSocketAsyncCompletion *completion,
+					    pssize result, PErrorIO error_code, pint native_error);
+static pboolean pp_socket_async_submit_transfer (PSocketAsync *async, PSocket *socket,
+						 PSocketAsyncOperation operation, pchar *buffer,
+						 psize buflen, pint buffer_index, ppointer user_data,
+						 PError **error);
+static pboolean pp_socket_async_submit_file (PSocketAsync *async, PFile *file,
+					     PSocketAsyncOperation operation, pchar *buffer,
+					     psize buflen, puint64 offset, pboolean data_only,
+					     ppointer user_data, PError **error);
+static pboolean pp_socket_async_check_fixed (PSocketAsync *async, psize buffer_index, psize offset,
+					     psize length, PError **error);
+static pint pp_socket_async_get_remaining (const PTimeProfiler *profiler, pint timeout);
+static pboolean pp_socket_async_emu_init (PSocketAsync *async, PError **error);
+static pboolean pp_socket_async_emu_try (PSocketAsyncOp *op, PSocketAsyncCompletion *completion);
+static pint pp_socket_async_emu_run (PSocketAsync *async, PSocketAsyncCompletion *completions, pint max_completions);
+static pboolean pp_socket_async_emu_watch (PSocketAsync *async, PError **error);
+static void pp_socket_async_emu_unwatch (PSocketAsync *async);
+static void pp_socket_async_emu_mark_ready (PSocketAsync *async, pint n_events);
+static pint pp_socket_async_emu_wait (PSocketAsync *async, PSocketAsyncCompletion *completions,
+				      pint max_completions, pint timeout, PError **error);
+static pboolean pp_socket_async_file_init (PSocketAsync *async, PError **error);
+static void pp_socket_async_file_close (PSocketAsync *async);
+static void pp_socket_async_file_task (ppointer data);
+static void pp_socket_async_file_wake (PSocketAsync *async);
+static void pp_socket_async_file_drain_wake (PSocketAsync *async);
+static pint pp_socket_async_file_reap (PSocketAsync *async, PSocketAsyncCompletion *completions,
+				       pint max_completions);
+#ifdef P_SOCKET_ASYNC_USE_IO_URING
+static pboolean pp_socket_async_ring_init (PSocketAsync *async);
+static void pp_socket_async_ring_close (PSocketAsync *async);
+static struct io_uring_sqe * pp_socket_async_ring_get_sqe (PSocketAsync *async);
+static void pp_socket_async_ring_commit (PSocketAsync *async);
+static void pp_socket_async_ring_push_op (PSocketAsync *async, PSocketAsyncOp *op);
+static pint pp_socket_async_ring_enter (PSocketAsync *async, puint min_complete, pint timeout);
+static pboolean pp_socket_async_ring_process (PSocketAsync *async, PSocketAsyncOp *op, pint res,
+					      puint flags, PSocketAsyncCompletion *completion);
+static pint pp_socket_async_ring_reap (PSocketAsync *async, PSocketAsyncCompletion *completions, pint max_completions);
+static pint pp_socket_async_ring_wait (PSocketAsync *async, PSocketAsyncCompletion *completions,
+				       pint max_completions, pint timeout, PError **error);
+static void pp_socket_async_ring_cancel_all (PSocketAsync *async);
+static pboolean pp_socket_async_ring_set_buffers (PSocketAsync *async, const PSocketVector *buffers,
+						  psize n_buffers, PError **error);
+#endif
+
+static PSocketAsyncOp *
+pp_socket_async_op_new (PSocketAsync		*async,
+			PSocket			*socket,
+			PFile			*file,
+			PSocketAsyncOperation	operation,
+			ppointer		user_data,
+			PError			**error)
+{
+	PSocketAsyncOp *op;
+
+	if (P_UNLIKELY (async == NULL || (socket == NULL) == (file == NULL))) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return NULL;
+	}
+
+	if (P_UNLIKELY (async->free_ops == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Asynchronous socket operations queue is full");
+		return NULL;
+	}
+
+	op = async->free_ops;
+	async->free_ops = op->next_free;
+
+	memset (op, 0, sizeof (PSocketAsyncOp));
+
+	op->operation    = operation;
+	op->socket       = socket;
+	op->file         = file;
+	op->async        = async;
+	op->user_data    = user_data;
+	op->buffer_index = -1;
+	op->ready        = TRUE;
+
+	return op;
+}
+
+static void
+pp_socket_async_op_release (PSocketAsync	*async,
+			    PSocketAsyncOp	*op)
+{
+	op->socket      = NULL;
+	op->file        = NULL;
+	op->next_free   = async->free_ops;
+	async->free_ops = op;
+
+	--async->pending;
+}
+
+static void
+pp_socket_async_op_submit (PSocketAsync		*async,
+			   PSocketAsyncOp	*op)
+{
+	++async->pending;
+
+#ifdef P_SOCKET_ASYNC_USE_IO_URING
+	if (async->ring_fd >= 0) {
+		pp_socket_async_ring_push_op (async, op);
+		return;
+	}
+#endif
+
+	if (op->file != NULL) {
+		++async->file_running;
+
+		/* Run in place if the pool can't take it, the result is the same */
+		if (P_UNLIKELY (p_thread_pool_push (async->file_pool, pp_socket_async_file_task, op) == FALSE))
+			pp_socket_async_file_task (op);
+
+		return;
+	}
+
+	async->waiting[async->waiting_count++] = op;
+}
+
+static void
+pp_socket_async_set_completion (PSocketAsyncOp		*op,
+				PSocketAsyncCompletion	*completion,
+				pssize			result,
+				PErrorIO		error_code,
+				pint			native_error)
+{
+	completion->operation    = op->operation;
+	completion->socket       = op->socket;
+	completion->user_data    = op->user_data;
+	completion->result       = result;
+	completion->error_code   = error_code;
+	completion->native_error = native_error;
+	completion->accepted     = NULL;
+	completion->file         = op->file;
+}
+
+static pboolean
+pp_socket_async_submit_transfer (PSocketAsync		*async,
+				 PSocket		*socket,
+				 PSocketAsyncOperation	operation,
+				 pchar			*buffer,
+				 psize			buflen,
+				 pint			buffer_index,
+				 ppointer		user_data,
+				 PError			**error)
+{
+	PSocketAsyncOp *op;
+
+	if (P_UNLIKELY (buffer == NULL || buflen == 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY ((op = pp_socket_async_op_new (async, socket, NULL, operation, user_data, error)) == NULL))
+		return FALSE;
+
+	op->buffer       = buffer;
+	op->buflen       = buflen > P_SOCKET_ASYNC_MAX_TRANSFER ? P_SOCKET_ASYNC_MAX_TRANSFER : buflen;
+	op->buffer_index = buffer_index;
+
+	pp_socket_async_op_submit (async, op);
+
+	return TRUE;
+}
+
+static pboolean
+pp_socket_async_submit_file (PSocketAsync		*async,
+			     PFile			*file,
+			     PSocketAsyncOperation	operation,
+			     pchar			*buffer,
+			     psize			buflen,
+			     puint64			offset,
+			     pboolean			data_only,
+			     ppointer			user_data,
+			     PError			**error)
+{
+	PSocketAsyncOp *op;
+
+	if (P_UNLIKELY (operation != P_SOCKET_ASYNC_OPERATION_FILE_SYNC &&
+			(buffer == NULL || buflen == 0 || offset > (puint64) P_MAXINT64))) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (async != NULL && file != NULL && async->free_ops != NULL &&
+#ifdef P_SOCKET_ASYNC_USE_IO_URING
+			async->ring_fd < 0 &&
+#endif
+			async->file_pool == NULL && pp_socket_async_file_init (async, error) == FALSE))
+		return FALSE;
+
+	if (P_UNLIKELY ((op = pp_socket_async_op_new (async, NULL, file, operation, user_data, error)) == NULL))
+		return FALSE;
+
+	op->buffer    = buffer;
+	op->buflen    = buflen > P_SOCKET_ASYNC_MAX_TRANSFER ? P_SOCKET_ASYNC_MAX_TRANSFER : buflen;
+	op->offset    = offset;
+	op->data_only = data_only ? 1 : 0;
+
+	pp_socket_async_op_submit (async, op);
+
+	return TRUE;
+}
+
+static pboolean
+pp_socket_async_check_fixed (PSocketAsync	*async,
+			     psize		buffer_index,
+			     psize		offset,
+			     psize		length,
+			     PError		**error)
+{
+	if (P_UNLIKELY (async == NULL || buffer_index >= async->n_buffers || length == 0 ||
+			offset > async->buffers[buffer_index].buflen ||
+			length > async->buffers[buffer_index].buflen - offset)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid registered buffer range");
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static pint
+pp_socket_async_get_remaining (const PTimeProfiler	*profiler,
+			       pint			timeout)
+{
+	puint64 elapsed;
+
+	if (timeout <= 0)
+		return timeout;
+
+	elapsed = p_time_profiler_elapsed_usecs (profiler) / 1000;
+
+	return elapsed >= (puint64) timeout ? 0 : timeout - (pint) elapsed;
+}
+
+static pboolean
+pp_socket_async_emu_init (PSocketAsync	*async,
+			  PError	**error)
+{
+	if (P_UNLIKELY ((async->poller = p_socket_poller_new (error)) == NULL))
+		return FALSE;
+
+	async->waiting    = p_malloc0 ((psize) async->queue_size * sizeof (PSocketAsyncOp *));
+	async->polled     = p_malloc0 ((psize) async->queue_size * sizeof (PSocket *));
+	async->events     = p_malloc0 (P_SOCKET_ASYNC_POLLER_EVENTS * sizeof (PSocketPollerEvent));
+	async->conditions = p_hash_table_new ();
+
+	if (P_UNLIKELY (async->waiting == NULL    ||
+			async->polled == NULL     ||
+			async->events == NULL     ||
+			async->conditions == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for asynchronous socket operations");
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/* Tries to finish an operation without blocking */
+static pboolean
+pp_socket_async_emu_try (PSocketAsyncOp		*op,
+			 PSocketAsyncCompletion	*completion)
+{
+	PSocketAddress	*address;
+	PSocket		*accepted   = NULL;
+	PError		*error      = NULL;
+	pboolean	blocking;
+	pboolean	silent;
+	pboolean	would_block = FALSE;
+	pssize		result      = 0;
+
+	/* Would-block is the common outcome here, don't allocate errors for it */
+	blocking = p_socket_get_blocking (op->socket);
+	silent   = p_socket_get_silent_would_block (op->socket);
+	p_socket_set_blocking (op->socket, FALSE);
+	p_socket_set_silent_would_block (op->socket, TRUE);
+
+	switch (op->operation) {
+	case P_SOCKET_ASYNC_OPERATION_ACCEPT:
+		accepted    = p_socket_accept (op->socket, &error);
+		would_block = (accepted == NULL && error == NULL);
+		break;
+	case P_SOCKET_ASYNC_OPERATION_CONNECT:
+		if (op->connecting) {
+			p_socket_check_connect_result (op->socket, &error);
+			break;
+		}
+
+		address = p_socket_address_new_from_native (&op->address, (psize) op->address_len);
+
+		if (P_UNLIKELY (address == NULL)) {
+			p_error_set_error_p (&error,
+					     (pint) P_ERROR_IO_NO_RESOURCES,
+					     0,
+					     "Failed to allocate memory for socket address");
+			break;
+		}
+
+		/* Silent would-block leaves the error unset */
+		if (p_socket_connect (op->socket, address, &error) == FALSE &&
+		    (error == NULL || p_error_get_code (error) == (pint) P_ERROR_IO_IN_PROGRESS)) {
+			/* Connection result is checked once the socket is writable */
+			p_error_free (error);
+			error          = NULL;
+			would_block    = TRUE;
+			op->connecting = TRUE;
+		}
+
+		p_socket_address_free (address);
+		break;
+	case P_SOCKET_ASYNC_OPERATION_RECEIVE:
+		result      = p_socket_receive (op->socket, op->buffer, op->buflen, &error);
+		would_block = (result < 0 && error == NULL);
+		break;
+	case P_SOCKET_ASYNC_OPERATION_SEND:
+		result      = p_socket_send (op->socket, op->buffer, op->buflen, &error);
+		would_block = (result < 0 && error == NULL);
+		break;
+	default:
+		/* File operations are run by the workers */
+		break;
+	}
+
+	p_socket_set_blocking (op->socket, blocking);
+	p_socket_set_silent_would_block (op->socket, silent);
+
+	if (would_block == TRUE ||
+	    (error != NULL && p_error_get_code (error) == (pint) P_ERROR_IO_WOULD_BLOCK)) {
+		p_error_free (error);
+		op->ready = FALSE;
+		return FALSE;
+	}
+
+	if (error != NULL) {
+		pp_socket_async_set_completion (op,
+						completion,
+						-1,
+						(PErrorIO) p_error_get_code (error),
+						p_error_get_native_code (error));
+		p_error_free (error);
+	} else {
+		pp_socket_async_set_completion (op, completion, result, P_ERROR_IO_NONE, 0);
+		completion->accepted = accepted;
+	}
+
+	return TRUE;
+}
+
+static pint
+pp_socket_async_emu_run (PSocketAsync		*async,
+			 PSocketAsyncCompletion	*completions,
+			 pint			max_completions)
+{
+	PSocketAsyncOp	*op;
+	pint		count;
+	pint		kept  = 0;
+	pint		i;
+
+	count = pp_socket_async_file_reap (async, completions, max_completions);
+
+	/* Keep the submission order for the operations left */
+	for (i = 0; i < async->waiting_count; ++i) {
+		op = async->waiting[i];
+
+		if (count < max_completions && op->ready &&
+		    pp_socket_async_emu_try (op, &completions[count]) == TRUE) {
+			pp_socket_async_op_release (async, op);
+			++count;
+			continue;
+		}
+
+		async->waiting[kept++] = op;
+	}
+
+	async->waiting_count = kept;
+
+	return count;
+}
+
+static pboolean
+pp_socket_async_emu_watch (PSocketAsync	*async,
+			   PError	**error)
+{
+	PSocketAsyncOp	*op;
+	ppointer	value;
+	pint		conditions;
+	pint		i;
+
+	/* Combine the conditions of all the operations for the same socket */
+	for (i = 0; i < async->waiting_count; ++i) {
+		op = async->waiting[i];
+
+		if (op->operation == P_SOCKET_ASYNC_OPERATION_ACCEPT ||
+		    op->operation == P_SOCKET_ASYNC_OPERATION_RECEIVE)
+			conditions = P_SOCKET_POLLER_CONDITION_IN;
+		else
+			conditions = P_SOCKET_POLLER_CONDITION_OUT;
+
+		value = p_hash_table_lookup (async->conditions, op->socket);
+
+		if (value == (ppointer) -1)
+			async->polled[async->polled_count++] = op->socket;
+		else
+			conditions |= P_POINTER_TO_INT (value);
+
+		p_hash_table_insert (async->conditions, op->socket, P_INT_TO_POINTER (conditions));
+	}
+
+	/* Finished file operations are signalled with a datagram */
+	if (async->file_running > 0 &&
+	    P_UNLIKELY (p_socket_poller_add (async->poller,
+					     async->wake_socket,
+					     P_SOCKET_POLLER_CONDITION_IN,
+					     P_SOCKET_POLLER_FLAG_NONE,
+					     NULL,
+					     error) == FALSE))
+		return FALSE;
+
+	for (i = 0; i < async->polled_count; ++i) {
+		conditions = P_POINTER_TO_INT (p_hash_table_lookup (async->conditions, async->polled[i]));
+
+		if (P_UNLIKELY (p_socket_poller_add (async->poller,
+						     async->polled[i],
+						     conditions,
+						     P_SOCKET_POLLER_FLAG_NONE,
+						     NULL,
+						     error) == FALSE))
+			return FALSE;
+	}
+
+	return TRUE;
+}
+
+/* Sockets are not kept in the poller as they can be closed between the waits */
+static void
+pp_socket_async_emu_unwatch (PSocketAsync *async)
+{
+	pint i;
+
+	if (async->file_running > 0)
+		p_socket_poller_remove (async->poller, async->wake_socket, NULL);
+
+	for (i = 0; i < async->polled_count; ++i) {
+		p_socket_poller_remove (async->poller, async->polled[i], NULL);
+		p_hash_table_remove (async->conditions, async->polled[i]);
+	}
+
+	async->polled_count = 0;
+}
+
+static void
+pp_socket_async_emu_mark_ready (PSocketAsync	*async,
+				pint		n_events)
+{
+	PSocketAsyncOp	*op;
+	pint		conditions;
+	pint		wanted;
+	pint		i;
+
+	for (i = 0; i < n_events; ++i) {
+		if (async->events[i].socket == async->wake_socket) {
+			pp_socket_async_file_drain_wake (async);
+			continue;
+		}
+
+		p_hash_table_insert (async->conditions,
+				     async->events[i].socket,
+				     P_INT_TO_POINTER (async->events[i].conditions | P_SOCKET_ASYNC_READY_MARK));
+	}
+
+	for (i = 0; i < async->waiting_count; ++i) {
+		op         = async->waiting[i];
+		conditions = P_POINTER_TO_INT (p_hash_table_lookup (async->conditions, op->socket));
+
+		if ((conditions & P_SOCKET_ASYNC_READY_MARK) == 0)
+			continue;
+
+		if (op->operation == P_SOCKET_ASYNC_OPERATION_ACCEPT ||
+		    op->operation == P_SOCKET_ASYNC_OPERATION_RECEIVE)
+			wanted = P_SOCKET_POLLER_CONDITION_IN;
+		else
+			wanted = P_SOCKET_POLLER_CONDITION_OUT;
+
+		/* Errors are reported by the operation itself */
+		wanted |= P_SOCKET_POLLER_CONDITION_ERROR | P_SOCKET_POLLER_CONDITION_HANGUP;
+
+		if ((conditions & wanted) != 0)
+			op->ready = TRUE;
+	}
+}
+
+static pint
+pp_socket_async_emu_wait (PSocketAsync			*async,
+			  PSocketAsyncCompletion	*completions,
+			  pint				max_completions,
+			  pint				timeout,
+			  PError			**error)
+{
+	PTimeProfiler	*profiler = NULL;
+	pint		remaining;
+	pint		count;
+	pint		n_events;
+
+	if (timeout > 0 && P_UNLIKELY ((profiler = p_time_profiler_new ()) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for time profiler");
+		return -1;
+	}
+
+	for (;;) {
+		count = pp_socket_async_emu_run (async, completions, max_completions);
+
+		if (count > 0 || timeout == 0 || (async->waiting_count == 0 && async->file_running == 0))
+			break;
+
+		remaining = pp_socket_async_get_remaining (profiler, timeout);
+
+		if (timeout > 0 && remaining == 0)
+			break;
+
+		if (P_LIKELY (pp_socket_async_emu_watch (async, error) == TRUE))
+			n_events = p_socket_poller_wait (async->poller,
+							 async->events,
+							 P_SOCKET_ASYNC_POLLER_EVENTS,
+							 remaining,
+							 error);
+		else
+			n_events = -1;
+
+		if (n_events > 0)
+			pp_socket_async_emu_mark_ready (async, n_events);
+
+		pp_socket_async_emu_unwatch (async);
+
+		if (P_UNLIKELY (n_events < 0)) {
+			count = -1;
+			break;
+		}
+	}
+
+	if (profiler != NULL)
+		p_time_profiler_free (profiler);
+
+	return count;
+}
+
+static pboolean
+pp_socket_async_file_init (PSocketAsync	*async,
+			   PError	**error)
+{
+	PSocketAddress *address = NULL;
+
+	async->file_mutex = p_mutex_new ();
+	async->file_done  = p_malloc0 ((psize) async->queue_size * sizeof (PSocketAsyncOp *));
+	async->file_pool  = p_thread_pool_new (P_SOCKET_ASYNC_FILE_WORKERS);
+
+	if (P_UNLIKELY (async->file_mutex == NULL || async->file_done == NULL || async->file_pool == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for asynchronous file operations");
+		pp_socket_async_file_close (async);
+		return FALSE;
+	}
+
+	/* Loopback datagram socket wakes up the poller from the workers */
+	async->wake_socket = p_socket_new (P_SOCKET_FAMILY_INET,
+					   P_SOCKET_TYPE_DATAGRAM,
+					   P_SOCKET_PROTOCOL_UDP,
+					   error);
+
+	if (P_LIKELY (async->wake_socket != NULL)) {
+		if (P_UNLIKELY ((address = p_socket_address_new ("127.0.0.1", 0)) == NULL))
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IO_NO_RESOURCES,
+					     0,
+					     "Failed to allocate memory for socket address");
+	}
+
+	if (P_UNLIKELY (address == NULL ||
+			p_socket_bind (async->wake_socket, address, FALSE, error) == FALSE ||
+			(async->wake_address = p_socket_get_local_address (async->wake_socket, error)) == NULL)) {
+		if (address != NULL)
+			p_socket_address_free (address);
+
+		pp_socket_async_file_close (async);
+		return FALSE;
+	}
+
+	p_socket_address_free (address);
+	p_socket_set_blocking (async->wake_socket, FALSE);
+
+	return TRUE;
+}
+
+static void
+pp_socket_async_file_close (PSocketAsync *async)
+{
+	/* Waits for the running operations */
+	if (async->file_pool != NULL)
+		p_thread_pool_free (async->file_pool);
+
+	if (async->file_mutex != NULL)
+		p_mutex_free (async->file_mutex);
+
+	if (async->file_done != NULL)
+		p_free (async->file_done);
+
+	if (async->wake_address != NULL)
+		p_socket_address_free (async->wake_address);
+
+	if (async->wake_socket != NULL)
+		p_socket_free (async->wake_socket);
+
+	async->file_pool    = NULL;
+	async->file_mutex   = NULL;
+	async->file_done    = NULL;
+	async->wake_address = NULL;
+	async->wake_socket  = NULL;
+}
+
+/* Runs in a worker thread, the operation is owned by the worker until it's
+ * put into the finished list */
+static void
+pp_socket_async_file_task (ppointer data)
+{
+	PSocketAsyncOp	*op    = data;
+	PSocketAsync	*async = op->async;
+	PError		*error = NULL;
+	pboolean	wake;
+
+	switch (op->operation) {
+	case P_SOCKET_ASYNC_OPERATION_FILE_READ:
+		op->file_result = p_file_read_at (op->file, op->buffer, op->buflen, op->offset, &error);
+		break;
+	case P_SOCKET_ASYNC_OPERATION_FILE_WRITE:
+		op->file_result = p_file_write_at (op->file, op->buffer, op->buflen, op->offset, &error);
+		break;
+	default:
+		if (op->data_only)
+			op->file_result = p_file_sync_data (op->file, &error) == TRUE ? 0 : -1;
+		else
+			op->file_result = p_file_sync (op->file, &error) == TRUE ? 0 : -1;
+		break;
+	}
+
+	if (error != NULL) {
+		op->file_result       = -1;
+		op->file_error        = (PErrorIO) p_error_get_code (error);
+		op->file_native_error = p_error_get_native_code (error);
+		p_error_free (error);
+	} else {
+		op->file_error        = P_ERROR_IO_NONE;
+		op->file_native_error = 0;
+	}
+
+	p_mutex_lock (async->file_mutex);
+	async->file_done[async->file_done_count++] = op;
+	wake = (async->file_done_count == 1);
+	p_mutex_unlock (async->file_mutex);
+
+	/* A single datagram is enough until the list is reaped */
+	if (wake)
+		pp_socket_async_file_wake (async);
+}
+
+static void
+pp_socket_async_file_wake (PSocketAsync *async)
+{
+	pchar byte = 0;
+
+	p_socket_send_to (async->wake_socket, async->wake_address, &byte, 1, NULL);
+}
+
+static void
+pp_socket_async_file_drain_wake (PSocketAsync *async)
+{
+	pchar buf[16];
+
+	while (p_socket_receive (async->wake_socket, buf, sizeof (buf), NULL) > 0)
+		;
+}
+
+static pint
+pp_socket_async_file_reap (PSocketAsync			*async,
+			   PSocketAsyncCompletion	*completions,
+			   pint				max_completions)
+{
+	PSocketAsyncOp	*op;
+	pint		count = 0;
+
+	if (async->file_running == 0)
+		return 0;
+
+	p_mutex_lock (async->file_mutex);
+
+	while (count < max_completions && count < async->file_done_count) {
+		op = async->file_done[count];
+
+		pp_socket_async_set_completion (op,
+						&completions[count],
+						op->file_result,
+						op->file_error,
+						op->file_native_error);
+		pp_socket_async_op_release (async, op);
+		++count;
+	}
+
+	/* Workers signal only an empty list becoming non-empty, the rest are
+	 * reaped by the next wait before polling */
+	if (count > 0) {
+		async->file_done_count -= count;
+		memmove (async->file_done,
+			 async->file_done + count,
+			 (psize) async->file_done_count * sizeof (PSocketAsyncOp *));
+	}
+
+	p_mutex_unlock (async->file_mutex);
+
+	async->file_running -= count;
+
+	return count;
+}
+
+#ifdef P_SOCKET_ASYNC_USE_IO_URING
+static pboolean
+pp_socket_async_ring_init (PSocketAsync *async)
+{
+	struct io_uring_params	params;
+#  ifdef P_SOCKET_ASYNC_HAS_SEND_ZC
+	struct io_uring_probe	*probe;
+#  endif
+	psize			sq_size;
+	psize			cq_size;
+	puint			features;
+	pchar			*ring;
+
+	memset (&params, 0, sizeof (params));
+
+	params.flags      = IORING_SETUP_CQSIZE;
+	params.cq_entries = (puint) async->queue_size * 2;
+
+	if ((async->ring_fd = (pint) syscall (__NR_io_uring_setup, (puint) async->queue_size, &params)) < 0)
+		return FALSE;
+
+	/* Timed waits require kernel 5.11 */
+	features = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_EXT_ARG;
+
+	if ((params.features & features) != features) {
+		pp_socket_async_ring_close (async);
+		return FALSE;
+	}
+
+	sq_size = params.sq_off.array + params.sq_entries * sizeof (puint);
+	cq_size = params.cq_off.cqes + params.cq_entries * sizeof (struct io_uring_cqe);
+
+	async->ring_size = sq_size > cq_size ? sq_size : cq_size;
+	async->ring      = mmap (NULL,
+				 async->ring_size,
+				 PROT_READ | PROT_WRITE,
+				 MAP_SHARED | MAP_POPULATE,
+				 async->ring_fd,
+				 IORING_OFF_SQ_RING);
+
+	if (async->ring == MAP_FAILED) {
+		async->ring = NULL;
+		pp_socket_async_ring_close (async);
+		return FALSE;
+	}
+
+	async->sqes_size = params.sq_entries * sizeof (struct io_uring_sqe);
+	async->sqes      = mmap (NULL,
+				 async->sqes_size,
+				 PROT_READ | PROT_WRITE,
+				 MAP_SHARED | MAP_POPULATE,
+				 async->ring_fd,
+				 IORING_OFF_SQES);
+
+	if (async->sqes == MAP_FAILED) {
+		async->sqes = NULL;
+		pp_socket_async_ring_close (async);
+		return FALSE;
+	}
+
+	ring = (pchar *) async->ring;
+
+	async->sq_head    = (puint *) (ring + params.sq_off.head);
+	async->sq_tail    = (puint *) (ring + params.sq_off.tail);
+	async->sq_array   = (puint *) (ring + params.sq_off.array);
+	async->sq_mask    = *((puint *) (ring + params.sq_off.ring_mask));
+	async->sq_entries = params.sq_entries;
+	async->cq_head    = (puint *) (ring + params.cq_off.head);
+	async->cq_tail    = (puint *) (ring + params.cq_off.tail);
+	async->cq_mask    = *((puint *) (ring + params.cq_off.ring_mask));
+	async->cqes       = (struct io_uring_cqe *) (ring + params.cq_off.cqes);
+
+#  ifdef P_SOCKET_ASYNC_HAS_SEND_ZC
+	/* Zero-copy send is used for the registered buffers if supported */
+	probe = p_malloc0 (sizeof (struct io_uring_probe) + 256 * sizeof (struct io_uring_probe_op));
+
+	if (probe != NULL) {
+		if (syscall (__NR_io_uring_register, async->ring_fd, IORING_REGISTER_PROBE, probe, 256) == 0 &&
+		    probe->last_op >= IORING_OP_SEND_ZC)
+			async->has_send_zc = (probe->ops[IORING_OP_SEND_ZC].flags & IO_URING_OP_SUPPORTED) != 0;
+
+		p_free (probe);
+	}
+#  endif
+
+	return TRUE;
+}
+
+static void
+pp_socket_async_ring_close (PSocketAsync *async)
+{
+	if (async->sqes != NULL)
+		munmap (async->sqes, async->sqes_size);
+
+	if (async->ring != NULL)
+		munmap (async->ring, async->ring_size);
+
+	if (async->ring_fd >= 0)
+		p_sys_close (async->ring_fd);
+
+	async->sqes    = NULL;
+	async->ring    = NULL;
+	async->ring_fd = -1;
+}
+
+static struct io_uring_sqe *
+pp_socket_async_ring_get_sqe (PSocketAsync *async)
+{
+	struct io_uring_sqe	*sqe;
+	puint			tail;
+	puint			head;
+
+	tail = *async->sq_tail;
+	head = __atomic_load_n (async->sq_head, __ATOMIC_ACQUIRE);
+
+	if (P_UNLIKELY (tail - head >= async->sq_entries))
+		return NULL;
+
+	sqe = &async->sqes[tail & async->sq_mask];
+	memset (sqe, 0, sizeof (struct io_uring_sqe));
+
+	async->sq_array[tail & async->sq_mask] = tail & async->sq_mask;
+
+	return sqe;
+}
+
+static void
+pp_socket_async_ring_commit (PSocketAsync *async)
+{
+	/* The entry must be visible to the kernel before the new tail */
+	__atomic_store_n (async->sq_tail, *async->sq_tail + 1, __ATOMIC_RELEASE);
+
+	++async->to_submit;
+}
+
+static void
+pp_socket_async_ring_push_op (PSocketAsync	*async,
+			      PSocketAsyncOp	*op)
+{
+	struct io_uring_sqe	*sqe;
+	puint			events;
+
+	/* Every operation takes at most one entry, the ring is big enough */
+	sqe = pp_socket_async_ring_get_sqe (async);
+
+	sqe->fd        = op->file != NULL ? p_file_get_fd (op->file) : p_socket_get_fd (op->socket);
+	sqe->user_data = (__u64) (puintptr) op;
+
+	if (op->polling) {
+		if (op->operation == P_SOCKET_ASYNC_OPERATION_ACCEPT ||
+		    op->operation == P_SOCKET_ASYNC_OPERATION_RECEIVE)
+			events = POLLIN;
+		else
+			events = POLLOUT;
+
+#  if P_BYTE_ORDER == P_BIG_ENDIAN
+		events = (events << 16) | (events >> 16);
+#  endif
+		sqe->opcode        = IORING_OP_POLL_ADD;
+		sqe->poll32_events = events;
+
+		pp_socket_async_ring_commit (async);
+		return;
+	}
+
+	switch (op->operation) {
+	case P_SOCKET_ASYNC_OPERATION_ACCEPT:
+		sqe->opcode = IORING_OP_ACCEPT;
+		break;
+	case P_SOCKET_ASYNC_OPERATION_CONNECT:
+		sqe->opcode = IORING_OP_CONNECT;
+		sqe->addr   = (__u64) (puintptr) &op->address;
+		sqe->off    = (__u64) op->address_len;
+		break;
+	case P_SOCKET_ASYNC_OPERATION_RECEIVE:
+		sqe->addr = (__u64) (puintptr) op->buffer;
+		sqe->len  = (__u32) op->buflen;
+
+		if (op->buffer_index >= 0) {
+			sqe->opcode    = IORING_OP_READ_FIXED;
+			sqe->buf_index = (__u16) op->buffer_index;
+		} else
+			sqe->opcode = IORING_OP_RECV;
+		break;
+	case P_SOCKET_ASYNC_OPERATION_SEND:
+		sqe->addr      = (__u64) (puintptr) op->buffer;
+		sqe->len       = (__u32) op->buflen;
+		sqe->msg_flags = MSG_NOSIGNAL;
+
+		sqe->opcode    = IORING_OP_SEND;
+#  ifdef P_SOCKET_ASYNC_HAS_SEND_ZC
+		if (op->buffer_index >= 0 && async->has_send_zc) {
+			sqe->opcode    = IORING_OP_SEND_ZC;
+			sqe->ioprio    = IORING_RECVSEND_FIXED_BUF;
+			sqe->buf_index = (__u16) op->buffer_index;
+		}
+#  endif
+		break;
+	case P_SOCKET_ASYNC_OPERATION_FILE_READ:
+	case P_SOCKET_ASYNC_OPERATION_FILE_WRITE:
+		sqe->opcode = op->operation == P_SOCKET_ASYNC_OPERATION_FILE_READ ? IORING_OP_READ
+										  : IORING_OP_WRITE;
+		sqe->addr   = (__u64) (puintptr) op->buffer;
+		sqe->len    = (__u32) op->buflen;
+		sqe->off    = (__u64) op->offset;
+		break;
+	case P_SOCKET_ASYNC_OPERATION_FILE_SYNC:
+		sqe->opcode      = IORING_OP_FSYNC;
+		sqe->fsync_flags = op->data_only ? IORING_FSYNC_DATASYNC : 0;
+		break;
+	}
+
+	pp_socket_async_ring_commit (async);
+}
+
+static pint
+pp_socket_async_ring_enter (PSocketAsync	*async,
+			    puint		min_complete,
+			    pint		timeout)
+{
+	struct io_uring_getevents_arg	arg;
+	struct __kernel_timespec	ts;
+	puint				flags = 0;
+	pint				ret;
+
+	memset (&arg, 0, sizeof (arg));
+
+	if (min_complete > 0) {
+		flags |= IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG;
+
+		if (timeout >= 0) {
+			ts.tv_sec  = timeout / 1000;
+			ts.tv_nsec = (timeout % 1000) * 1000000;
+			arg.ts     = (__u64) (puintptr) &ts;
+		}
+	}
+
+	ret = (pint) syscall (__NR_io_uring_enter,
+			      async->ring_fd,
+			      async->to_submit,
+			      min_complete,
+			      flags,
+			      (flags & IORING_ENTER_EXT_ARG) ? &arg : NULL,
+			      (flags & IORING_ENTER_EXT_ARG) ? sizeof (arg) : 0);
+
+	if (ret > 0)
+		async->to_submit -= (puint) ret;
+
+	return ret;
+}
+
+/* Handles a completion entry, returns TRUE if the operation is finished */
+static pboolean
+pp_socket_async_ring_process (PSocketAsync		*async,
+			      PSocketAsyncOp		*op,
+			      pint			res,
+			      puint			flags,
+			      PSocketAsyncCompletion	*completion)
+{
+	PSocket	*accepted;
+	PError	*error = NULL;
+
+	/* Regular files are always ready, just try again */
+	if (op->file != NULL && (res == -EAGAIN || res == -EINTR)) {
+		pp_socket_async_ring_push_op (async, op);
+		return FALSE;
+	}
+
+#  ifdef P_SOCKET_ASYNC_HAS_SEND_ZC
+	/* Buffer of the zero-copy send is in use until the notification */
+	if (flags & IORING_CQE_F_MORE) {
+		op->zc_result = res;
+		return FALSE;
+	}
+
+	if (flags & IORING_CQE_F_NOTIF)
+		res = (pint) op->zc_result;
+	else
+#  endif
+	if (op->polling) {
+		op->polling = FALSE;
+
+		if (res >= 0 && op->operation != P_SOCKET_ASYNC_OPERATION_CONNECT) {
+			pp_socket_async_ring_push_op (async, op);
+			return FALSE;
+		}
+
+		res = res < 0 ? res : 0;
+	} else if (res == -EAGAIN || res == -EINTR ||
+		   (op->operation == P_SOCKET_ASYNC_OPERATION_CONNECT && (res == -EINPROGRESS || res == -EALREADY))) {
+		/* Non-blocking sockets are not waited by the kernel */
+		op->polling = (res != -EINTR);
+		pp_socket_async_ring_push_op (async, op);
+		return FALSE;
+	}
+
+	if (res < 0) {
+		pp_socket_async_set_completion (op,
+						completion,
+						-1,
+						p_error_get_io_from_system (-res),
+						-res);
+		return TRUE;
+	}
+
+	switch (op->operation) {
+	case P_SOCKET_ASYNC_OPERATION_ACCEPT:
+		if (P_UNLIKELY ((accepted = p_socket_new_from_fd (res, NULL)) == NULL)) {
+			p_sys_close (res);
+			pp_socket_async_set_completion (op, completion, -1, P_ERROR_IO_FAILED, 0);
+			return TRUE;
+		}
+
+		pp_socket_async_set_completion (op, completion, 0, P_ERROR_IO_NONE, 0);
+		completion->accepted = accepted;
+		break;
+	case P_SOCKET_ASYNC_OPERATION_CONNECT:
+		/* Updates the socket connection state */
+		if (P_UNLIKELY (p_socket_check_connect_result (op->socket, &error) == FALSE)) {
+			pp_socket_async_set_completion (op,
+							completion,
+							-1,
+							(PErrorIO) p_error_get_code (error),
+							p_error_get_native_code (error));
+			p_error_free (error);
+			return TRUE;
+		}
+
+		pp_socket_async_set_completion (op, completion, 0, P_ERROR_IO_NONE, 0);
+		break;
+	default:
+		pp_socket_async_set_completion (op, completion, (pssize) res, P_ERROR_IO_NONE, 0);
+		break;
+	}
+
+	return TRUE;
+}
+
+static pint
+pp_socket_async_ring_reap (PSocketAsync			*async,
+			   PSocketAsyncCompletion	*completions,
+			   pint				max_completions)
+{
+	struct io_uring_cqe	*cqe;
+	PSocketAsyncOp		*op;
+	puint			head;
+	puint			tail;
+	pint			count = 0;
+
+	head = *async->cq_head;
+	tail = __atomic_load_n (async->cq_tail, __ATOMIC_ACQUIRE);
+
+	while (head != tail && count < max_completions) {
+		cqe = &async->cqes[head & async->cq_mask];
+		op  = (PSocketAsyncOp *) (puintptr) cqe->user_data;
+
+		++head;
+
+		if (op == NULL)
+			continue;
+
+		if (pp_socket_async_ring_process (async, op, cqe->res, cqe->flags, &completions[count]) == TRUE) {
+			pp_socket_async_op_release (async, op);
+			++count;
+		}
+	}
+
+	__atomic_store_n (async->cq_head, head, __ATOMIC_RELEASE);
+
+	return count;
+}
+
+static pint
+pp_socket_async_ring_wait (PSocketAsync			*async,
+			   PSocketAsyncCompletion	*completions,
+			   pint				max_completions,
+			   pint				timeout,
+			   PError			**error)
+{
+	PTimeProfiler	*profiler = NULL;
+	pint		remaining;
+	pint		count;
+	pint		err_code;
+
+	if (timeout > 0 && P_UNLIKELY ((profiler = p_time_profiler_new ()) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for time profiler");
+		return -1;
+	}
+
+	for (;;) {
+		count = pp_socket_async_ring_reap (async, completions, max_completions);
+
+		remaining = pp_socket_async_get_remaining (profiler, timeout);
+
+		if (count > 0 || remaining == 0 || async->pending == 0) {
+			/* Start the operations submitted while reaping */
+			if (async->to_submit > 0)
+				pp_socket_async_ring_enter (async, 0, 0);
+
+			break;
+		}
+
+		if (pp_socket_async_ring_enter (async, 1, remaining) < 0) {
+			err_code = p_error_get_last_system ();
+
+			/* Interrupted or timed out */
+			if (err_code == EINTR || err_code == ETIME)
+				break;
+
+			/* Completion queue is overflown, reap it first */
+			if (err_code == EBUSY || err_code == EAGAIN)
+				continue;
+
+			p_error_set_error_p (error,
+					     (pint) p_error_get_io_from_system (err_code),
+					     err_code,
+					     "Failed to call io_uring_enter() to wait for completions");
+			count = -1;
+			break;
+		}
+	}
+
+	if (profiler != NULL)
+		p_time_profiler_free (profiler);
+
+	return count;
+}
+
+static void
+pp_socket_async_ring_cancel_all (PSocketAsync *async)
+{
+	struct io_uring_sqe	*sqe;
+	struct io_uring_cqe	*cqe;
+	PSocketAsyncOp		*op;
+	puint			head;
+	puint			tail;
+	pint			i;
+
+	while (async->to_submit > 0 && pp_socket_async_ring_enter (async, 0, 0) >= 0)
+		;
+
+	while (async->pending > 0) {
+		for (i = 0; i < async->queue_size; ++i) {
+			op = &async->ops[i];
+
+			if ((op->socket == NULL && op->file == NULL) || op->cancelled)
+				continue;
+
+			if ((sqe = pp_socket_async_ring_get_sqe (async)) == NULL)
+				break;
+
+			/* Cancel requests are not reported */
+			sqe->opcode = IORING_OP_ASYNC_CANCEL;
+			sqe->addr   = (__u64) (puintptr) op;
+
+			op->cancelled = TRUE;
+
+			pp_socket_async_ring_commit (async);
+		}
+
+		if (pp_socket_async_ring_enter (async, 1, -1) < 0 && p_error_get_last_system () != EINTR) {
+			P_WARNING ("PSocketAsync::pp_socket_async_ring_cancel_all: io_uring_enter() failed");
+			break;
+		}
+
+		head = *async->cq_head;
+		tail = __atomic_load_n (async->cq_tail, __ATOMIC_ACQUIRE);
+
+		for (; head != tail; ++head) {
+			cqe = &async->cqes[head & async->cq_mask];
+			op  = (PSocketAsyncOp *) (puintptr) cqe->user_data;
+
+			if (op == NULL)
+				continue;
+
+#  ifdef P_SOCKET_ASYNC_HAS_SEND_ZC
+			/* Wait for the zero-copy notification to release the buffer */
+			if (cqe->flags & IORING_CQE_F_MORE)
+				continue;
+#  endif
+
+			if (op->operation == P_SOCKET_ASYNC_OPERATION_ACCEPT && !op->polling && cqe->res >= 0)
+				p_sys_close (cqe->res);
+
+			pp_socket_async_op_release (async, op);
+		}
+
+		__atomic_store_n (async->cq_head, head, __ATOMIC_RELEASE);
+	}
+}
+
+static pboolean
+pp_socket_async_ring_set_buffers (PSocketAsync		*async,
+				  const PSocketVector	*buffers,
+				  psize			n_buffers,
+				  PError		**error)
+{
+	struct iovec	*iov;
+	psize		i;
+	pint		ret;
+
+	if (async->n_buffers > 0)
+		syscall (__NR_io_uring_register, async->ring_fd, IORING_UNREGISTER_BUFFERS, NULL, 0);
+
+	if (n_buffers == 0)
+		return TRUE;
+
+	if (P_UNLIKELY ((iov = p_malloc0 (n_buffers * sizeof (struct iovec))) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for registered buffers");
+		return FALSE;
+	}
+
+	for (i = 0; i < n_buffers; ++i) {
+		iov[i].iov_base = buffers[i].buffer;
+		iov[i].iov_len  = buffers[i].buflen;
+	}
+
+	ret = (pint) syscall (__NR_io_uring_register,
+			      async->ring_fd,
+			      IORING_REGISTER_BUFFERS,
+			      iov,
+			      (puint) n_buffers);
+
+	p_free (iov);
+
+	if (P_UNLIKELY (ret < 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call io_uring_register() to register buffers");
+		return FALSE;
+	}
+
+	return TRUE;
+}
+#endif
+
+P_LIB_API PSocketAsync *
+p_socket_async_new (pint	queue_size,
+		    PError	**error)
+{
+	PSocketAsync	*ret;
+	pint		i;
+
+	if (queue_size == 0)
+		queue_size = P_SOCKET_ASYNC_DEFAULT_QUEUE_SIZE;
+
+	if (P_UNLIKELY (queue_size < 0 || queue_size > P_SOCKET_ASYNC_MAX_QUEUE_SIZE)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PSocketAsync))) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for asynchronous socket operations");
+		return NULL;
+	}
+
+	ret->queue_size = queue_size;
+
+#ifdef P_SOCKET_ASYNC_USE_IO_URING
+	ret->ring_fd = -1;
+#endif
+
+	if (P_UNLIKELY ((ret->ops = p_malloc0 ((psize) queue_size * sizeof (PSocketAsyncOp))) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for asynchronous socket operations");
+		p_free (ret);
+		return NULL;
+	}
+
+	for (i = queue_size - 1; i >= 0; --i) {
+		ret->ops[i].next_free = ret->free_ops;
+		ret->free_ops         = &ret->ops[i];
+	}
+
+#ifdef P_SOCKET_ASYNC_USE_IO_URING
+	/* Fall back to the emulation if io_uring is disabled or too old */
+	if (pp_socket_async_ring_init (ret) == TRUE)
+		return ret;
+#endif
+
+	if (P_UNLIKELY (pp_socket_async_emu_init (ret, error) == FALSE)) {
+		p_socket_async_free (ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+P_LIB_API pboolean
+p_socket_async_is_native (const PSocketAsync *async)
+{
+	if (P_UNLIKELY (async == NULL))
+		return FALSE;
+
+#ifdef P_SOCKET_ASYNC_USE_IO_URING
+	return async->ring_fd >= 0;
+#else
+	return FALSE;
+#endif
+}
+
+P_LIB_API pboolean
+p_socket_async_register_buffers (PSocketAsync		*async,
+				 const PSocketVector	*buffers,
+				 psize			n_buffers,
+				 PError			**error)
+{
+	PSocketVector	*new_buffers = NULL;
+	psize		i;
+
+	if (P_UNLIKELY (async == NULL || (buffers == NULL) != (n_buffers == 0) ||
+			n_buffers > P_SOCKET_ASYNC_MAX_BUFFERS)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	for (i = 0; i < n_buffers; ++i) {
+		if (P_UNLIKELY (buffers[i].buffer == NULL || buffers[i].buflen == 0 ||
+				buffers[i].buflen > P_SOCKET_ASYNC_MAX_TRANSFER)) {
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+					     0,
+					     "Invalid buffer descriptor");
+			return FALSE;
+		}
+	}
+
+	if (P_UNLIKELY (async->pending > 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_IN_PROGRESS,
+				     0,
+				     "Buffers can't be replaced while operations are in progress");
+		return FALSE;
+	}
+
+	if (n_buffers > 0) {
+		if (P_UNLIKELY ((new_buffers = p_malloc (n_buffers * sizeof (PSocketVector))) == NULL)) {
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IO_NO_RESOURCES,
+					     0,
+					     "Failed to allocate memory for registered buffers");
+			return FALSE;
+		}
+
+		memcpy (new_buffers, buffers, n_buffers * sizeof (PSocketVector));
+	}
+
+#ifdef P_SOCKET_ASYNC_USE_IO_URING
+	if (async->ring_fd >= 0 &&
+	    P_UNLIKELY (pp_socket_async_ring_set_buffers (async, buffers, n_buffers, error) == FALSE)) {
+		if (new_buffers != NULL)
+			p_free (new_buffers);
+
+		/* Old buffers are already unregistered */
+		n_buffers   = 0;
+		new_buffers = NULL;
+	}
+#endif
+
+	if (async->buffers != NULL)
+		p_free (async->buffers);
+
+	async->buffers   = new_buffers;
+	async->n_buffers = n_buffers;
+
+	return new_buffers != NULL || (buffers == NULL && n_buffers == 0);
+}
+
+P_LIB_API pboolean
+p_socket_async_submit_accept (PSocketAsync	*async,
+			      PSocket		*socket,
+			      ppointer		user_data,
+			      PError		**error)
+{
+	PSocketAsyncOp *op;
+
+	if (P_UNLIKELY ((op = pp_socket_async_op_new (async,
+						      socket,
+						      NULL,
+						      P_SOCKET_ASYNC_OPERATION_ACCEPT,
+						      user_data,
+						      error)) == NULL))
+		return FALSE;
+
+	pp_socket_async_op_submit (async, op);
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_socket_async_submit_connect (PSocketAsync	*async,
+			       PSocket		*socket,
+			       PSocketAddress	*address,
+			       ppointer		user_data,
+			       PError		**error)
+{
+	PSocketAsyncOp *op;
+
+	if (P_UNLIKELY (address == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY ((op = pp_socket_async_op_new (async,
+						      socket,
+						      NULL,
+						      P_SOCKET_ASYNC_OPERATION_CONNECT,
+						      user_data,
+						      error)) == NULL))
+		return FALSE;
+
+	if (P_UNLIKELY (p_socket_address_to_native (address, &op->address, sizeof (op->address)) == FALSE)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_FAILED,
+				     0,
+				     "Failed to convert socket address to native structure");
+		op->socket      = NULL;
+		op->next_free   = async->free_ops;
+		async->free_ops = op;
+		return FALSE;
+	}
+
+	op->address_len = (socklen_t) p_socket_address_get_native_size (address);
+
+	pp_socket_async_op_submit (async, op);
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_socket_async_submit_receive (PSocketAsync	*async,
+			       PSocket		*socket,
+			       pchar		*buffer,
+			       psize		buflen,
+			       ppointer		user_data,
+			       PError		**error)
+{
+	return pp_socket_async_submit_transfer (async,
+						socket,
+						P_SOCKET_ASYNC_OPERATION_RECEIVE,
+						buffer,
+						buflen,
+						-1,
+						user_data,
+						error);
+}
+
+P_LIB_API pboolean
+p_socket_async_submit_send (PSocketAsync	*async,
+			    PSocket		*socket,
+			    const pchar		*buffer,
+			    psize		buflen,
+			    ppointer		user_data,
+			    PError		**error)
+{
+	return pp_socket_async_submit_transfer (async,
+						socket,
+						P_SOCKET_ASYNC_OPERATION_SEND,
+						(pchar *) buffer,
+						buflen,
+						-1,
+						user_data,
+						error);
+}
+
+P_LIB_API pboolean
+p_socket_async_submit_receive_fixed (PSocketAsync	*async,
+				     PSocket		*socket,
+				     psize		buffer_index,
+				     psize		offset,
+				     psize		length,
+				     ppointer		user_data,
+				     PError		**error)
+{
+	if (P_UNLIKELY (pp_socket_async_check_fixed (async, buffer_index, offset, length, error) == FALSE))
+		return FALSE;
+
+	return pp_socket_async_submit_transfer (async,
+						socket,
+						P_SOCKET_ASYNC_OPERATION_RECEIVE,
+						async->buffers[buffer_index].buffer + offset,
+						length,
+						(pint) buffer_index,
+						user_data,
+						error);
+}
+
+P_LIB_API pboolean
+p_socket_async_submit_send_fixed (PSocketAsync	*async,
+				  PSocket	*socket,
+				  psize		buffer_index,
+				  psize		offset,
+				  psize		length,
+				  ppointer	user_data,
+				  PError	**error)
+{
+	if (P_UNLIKELY (pp_socket_async_check_fixed (async, buffer_index, offset, length, error) == FALSE))
+		return FALSE;
+
+	return pp_socket_async_submit_transfer (async,
+						socket,
+						P_SOCKET_ASYNC_OPERATION_SEND,
+						async->buffers[buffer_index].buffer + offset,
+						length,
+						(pint) buffer_index,
+						user_data,
+						error);
+}
+
+P_LIB_API pboolean
+p_socket_async_submit_file_read (PSocketAsync	*async,
+				 PFile		*file,
+				 pchar		*buffer,
+				 psize		buflen,
+				 puint64	offset,
+				 ppointer	user_data,
+				 PError		**error)
+{
+	return pp_socket_async_submit_file (async,
+					    file,
+					    P_SOCKET_ASYNC_OPERATION_FILE_READ,
+					    buffer,
+					    buflen,
+					    offset,
+					    FALSE,
+					    user_data,
+					    error);
+}
+
+P_LIB_API pboolean
+p_socket_async_submit_file_write (PSocketAsync	*async,
+				  PFile		*file,
+				  const pchar	*buffer,
+				  psize		buflen,
+				  puint64	offset,
+				  ppointer	user_data,
+				  PError	**error)
+{
+	return pp_socket_async_submit_file (async,
+					    file,
+					    P_SOCKET_ASYNC_OPERATION_FILE_WRITE,
+					    (pchar *) buffer,
+					    buflen,
+					    offset,
+					    FALSE,
+					    user_data,
+					    error);
+}
+
+P_LIB_API pboolean
+p_socket_async_submit_file_sync (PSocketAsync	*async,
+				 PFile		*file,
+				 pboolean	data_only,
+				 ppointer	user_data,
+				 PError		**error)
+{
+	return pp_socket_async_submit_file (async,
+					    file,
+					    P_SOCKET_ASYNC_OPERATION_FILE_SYNC,
+					    NULL,
+					    0,
+					    0,
+					    data_only,
+					    user_data,
+					    error);
+}
+
+P_LIB_API pint
+p_socket_async_get_pending (const PSocketAsync *async)
+{
+	if (P_UNLIKELY (async == NULL))
+		return 0;
+
+	return async->pending;
+}
+
+P_LIB_API pint
+p_socket_async_wait (PSocketAsync		*async,
+		     PSocketAsyncCompletion	*completions,
+		     pint			max_completions,
+		     pint			timeout,
+		     PError			**error)
+{
+	if (P_UNLIKELY (async == NULL || completions == NULL || max_completions <= 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	if (async->pending == 0)
+		return 0;
+
+#ifdef P_SOCKET_ASYNC_USE_IO_URING
+	if (async->ring_fd >= 0)
+		return pp_socket_async_ring_wait (async, completions, max_completions, timeout, error);
+#endif
+
+	return pp_socket_async_emu_wait (async, completions, max_completions, timeout, error);
+}
+
+P_LIB_API void
+p_socket_async_free (PSocketAsync *async)
+{
+	if (P_UNLIKELY (async == NULL))
+		return;
+
+#ifdef P_SOCKET_ASYNC_USE_IO_URING
+	if (async->ring_fd >= 0) {
+		pp_socket_async_ring_cancel_all (async);
+		pp_socket_async_ring_close (async);
+	}
+#endif
+
+	pp_socket_async_file_close (async);
+
+	if (async->poller != NULL)
+		p_socket_poller_free (async->poller);
+
+	if (async->conditions != NULL)
+		p_hash_table_free (async->conditions);
+
+	if (async->waiting != NULL)
+		p_free (async->waiting);
+
+	if (async->polled != NULL)
+		p_free (async->polled);
+
+	if (async->events != NULL)
+		p_free (async->events);
+
+	if (async->buffers != NULL)
+		p_free (async->buffers);
+
+	p_free (async->ops);
+	p_free (async);
+}
@@ -0,0 +1,398 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file psocketasync.h
+ * @brief Completion-based asynchronous socket operations
+ * @author Alexander Saprykin
+ *
+ * A #PSocketPoller tells when a socket is ready, and the caller still has to
+ * make a system call for every read or write. A #PSocketAsync queue works the
+ * other way around: the caller submits operations (accept, connect, receive or
+ * send) along with a user data pointer, and later reaps the finished ones in
+ * batches with p_socket_async_wait(). Each finished operation is reported once
+ * as a #PSocketAsyncCompletion carrying its result.
+ *
+ * On Linux the queue is backed by io_uring (kernel 5.11 or newer): submitted
+ * operations are passed to the kernel and reaped with a single system call per
+ * wait. Buffers registered with p_socket_async_register_buffers() are pinned
+ * in memory once, and operations submitted with
+ * p_socket_async_submit_receive_fixed() or p_socket_async_submit_send_fixed()
+ * use them without mapping the pages on every call.
+ *
+ * On the other systems, or if io_uring is not available at runtime, the queue
+ * is emulated on top of a #PSocketPoller: operations are tried first, and the
+ * ones which would block are retried once their sockets become ready. Check
+ * p_socket_async_is_native() to find out which backend is used. The interface
+ * and the results are the same for both backends.
+ *
+ * The sockets and the buffers of the submitted operations must stay valid
+ * until the operations are completed. The blocking mode of the sockets is not
+ * taken into account, operations never block the caller. Several operations
+ * can be submitted for the same socket, but their order of completion is not
+ * guaranteed. A queue is not thread-safe: submit and wait from the same
+ * thread, or guard the calls with a lock.
+ *
+ * File reads, writes and synchronizations of a #PFile can be submitted to the
+ * same queue with p_socket_async_submit_file_read(),
+ * p_socket_async_submit_file_write() and p_socket_async_submit_file_sync(), so
+ * a single loop drives both the network and the disk I/O. With io_uring they
+ * are passed to the kernel as well. Otherwise the file operations are run on a
+ * small pool of worker threads owned by the queue, which wake up the waiting
+ * caller once they are finished. The #PFile must stay opened until its
+ * operations are completed.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PSOCKETASYNC_H
+#define PLIBSYS_HEADER_PSOCKETASYNC_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+#include "psocket.h"
+#include "psocketaddress.h"
+#include "pfile.h"
+#include "perror.h"
+
+P_BEGIN_DECLS
+
+/** Asynchronous socket operations. */
+typedef enum PSocketAsyncOperation_ {
+	P_SOCKET_ASYNC_OPERATION_ACCEPT		= 0,	/**< Accept an incoming connection.	*/
+	P_SOCKET_ASYNC_OPERATION_CONNECT	= 1,	/**< Connect to a remote address.	*/
+	P_SOCKET_ASYNC_OPERATION_RECEIVE	= 2,	/**< Receive data.			*/
+	P_SOCKET_ASYNC_OPERATION_SEND		= 3,	/**< Send data.				*/
+	P_SOCKET_ASYNC_OPERATION_FILE_READ	= 4,	/**< Read data from a file.		*/
+	P_SOCKET_ASYNC_OPERATION_FILE_WRITE	= 5,	/**< Write data to a file.		*/
+	P_SOCKET_ASYNC_OPERATION_FILE_SYNC	= 6	/**< Flush a file to a storage device.	*/
+} PSocketAsyncOperation;
+
+/** Finished operation returned by p_socket_async_wait(). */
+typedef struct PSocketAsyncCompletion_ {
+	PSocketAsyncOperation	operation;	/**< Finished operation.				*/
+	PSocket			*socket;	/**< Socket the operation was submitted for, NULL
+						     for the file operations.			*/
+	ppointer		user_data;	/**< User data given at the submission.			*/
+	pssize			result;		/**< Size in bytes of received, sent, read or written
+						     data, 0 for accept, connect and sync, -1 in
+						     case of failure.				*/
+	PErrorIO		error_code;	/**< #P_ERROR_IO_NONE or the failure reason.		*/
+	pint			native_error;	/**< Platform error code, 0 if not applicable.		*/
+	PSocket			*accepted;	/**< Accepted socket, the caller is responsible to
+						     free it after usage.				*/
+	PFile			*file;		/**< File the operation was submitted for, NULL for
+						     the socket operations.			*/
+} PSocketAsyncCompletion;
+
+/** Asynchronous socket operations queue opaque data type. */
+typedef struct PSocketAsync_ PSocketAsync;
+
+/**
+ * @brief Creates a new asynchronous socket operations queue.
+ * @param queue_size Maximum number of operations in progress, 0 to use the
+ * default size (256).
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Pointer to #PSocketAsync in case of success, NULL otherwise.
+ * @since 0.0.5
+ * @sa p_socket_async_is_native()
+ *
+ * The size limits the number of submitted operations which are not yet
+ * reaped with p_socket_async_wait(), it can't exceed 32768.
+ */
+P_LIB_API PSocketAsync *	p_socket_async_new			(pint			queue_size,
+									 PError			**error);
+
+/**
+ * @brief Checks whether a queue uses a kernel completion backend.
+ * @param async #PSocketAsync to check.
+ * @return TRUE if the operations are passed to the kernel (io_uring), FALSE if
+ * they are emulated using a socket poller.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean		p_socket_async_is_native		(const PSocketAsync	*async);
+
+/**
+ * @brief Registers the buffers for fixed operations.
+ * @param async #PSocketAsync to register the buffers in.
+ * @param buffers Array of buffer descriptors to register.
+ * @param n_buffers Number of descriptors in @a buffers.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ * @sa p_socket_async_submit_receive_fixed(), p_socket_async_submit_send_fixed()
+ *
+ * The buffers are referred to by their index in @a buffers. With io_uring the
+ * buffer pages are pinned in memory until the buffers are replaced or the queue
+ * is freed, this may be limited by the locked memory quota of the process.
+ *
+ * The registered buffers can be replaced only when there are no operations in
+ * progress, pass NULL and 0 to unregister them.
+ */
+P_LIB_API pboolean		p_socket_async_register_buffers		(PSocketAsync		*async,
+									 const PSocketVector	*buffers,
+									 psize			n_buffers,
+									 PError			**error);
+
+/**
+ * @brief Submits an accept operation.
+ * @param async #PSocketAsync to submit the operation to.
+ * @param socket Listening #PSocket to accept a connection on.
+ * @param user_data Pointer to return along with the completion.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The accepted socket is returned in the @a accepted field of the completion.
+ */
+P_LIB_API pboolean		p_socket_async_submit_accept		(PSocketAsync		*async,
+									 PSocket		*socket,
+									 ppointer		user_data,
+									 PError			**error);
+
+/**
+ * @brief Submits a connect operation.
+ * @param async #PSocketAsync to submit the operation to.
+ * @param socket #PSocket to connect.
+ * @param address Remote address to connect to, it is copied and can be freed
+ * right after the call.
+ * @param user_data Pointer to return along with the completion.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean		p_socket_async_submit_connect		(PSocketAsync		*async,
+									 PSocket		*socket,
+									 PSocketAddress		*address,
+									 ppointer		user_data,
+									 PError			**error);
+
+/**
+ * @brief Submits a receive operation.
+ * @param async #PSocketAsync to submit the operation to.
+ * @param socket #PSocket to receive data from.
+ * @param buffer Buffer to write received data in.
+ * @param buflen Length of @a buffer.
+ * @param user_data Pointer to return along with the completion.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The operation completes as soon as any data is received, the @a result
+ * field of the completion is 0 if the connection was closed by the peer.
+ */
+P_LIB_API pboolean		p_socket_async_submit_receive		(PSocketAsync		*async,
+									 PSocket		*socket,
+									 pchar			*buffer,
+									 psize			buflen,
+									 ppointer		user_data,
+									 PError			**error);
+
+/**
+ * @brief Submits a send operation.
+ * @param async #PSocketAsync to submit the operation to.
+ * @param socket #PSocket to send data through.
+ * @param buffer Buffer with data to send.
+ * @param buflen Length of @a buffer.
+ * @param user_data Pointer to return along with the completion.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * For stream sockets less data than requested can be sent, check the
+ * @a result field of the completion.
+ */
+P_LIB_API pboolean		p_socket_async_submit_send		(PSocketAsync		*async,
+									 PSocket		*socket,
+									 const pchar		*buffer,
+									 psize			buflen,
+									 ppointer		user_data,
+									 PError			**error);
+
+/**
+ * @brief Submits a receive operation into a registered buffer.
+ * @param async #PSocketAsync to submit the operation to.
+ * @param socket #PSocket to receive data from.
+ * @param buffer_index Index of the registered buffer.
+ * @param offset Offset in the registered buffer to write received data at.
+ * @param length Maximum size in bytes of data to receive.
+ * @param user_data Pointer to return along with the completion.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ * @sa p_socket_async_register_buffers()
+ *
+ * The range must lie within the registered buffer.
+ */
+P_LIB_API pboolean		p_socket_async_submit_receive_fixed	(PSocketAsync		*async,
+									 PSocket		*socket,
+									 psize			buffer_index,
+									 psize			offset,
+									 psize			length,
+									 ppointer		user_data,
+									 PError			**error);
+
+/**
+ * @brief Submits a send operation from a registered buffer.
+ * @param async #PSocketAsync to submit the operation to.
+ * @param socket #PSocket to send data through.
+ * @param buffer_index Index of the registered buffer.
+ * @param offset Offset in the registered buffer to send data from.
+ * @param length Size in bytes of data to send.
+ * @param user_data Pointer to return along with the completion.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ * @sa p_socket_async_register_buffers()
+ *
+ * The range must lie within the registered buffer.
+ */
+P_LIB_API pboolean		p_socket_async_submit_send_fixed	(PSocketAsync		*async,
+									 PSocket		*socket,
+									 psize			buffer_index,
+									 psize			offset,
+									 psize			length,
+									 ppointer		user_data,
+									 PError			**error);
+
+/**
+ * @brief Submits a file read operation.
+ * @param async #PSocketAsync to submit the operation to.
+ * @param file #PFile to read data from, opened for reading.
+ * @param buffer Buffer to read data in.
+ * @param buflen Length of @a buffer.
+ * @param offset Offset in the file to read data from.
+ * @param user_data Pointer to return along with the completion.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * As with p_file_read_at(), the file position isn't used. Less data than
+ * requested is read at the end of the file, the @a result field of the
+ * completion is 0 if @a offset is beyond the end.
+ */
+P_LIB_API pboolean		p_socket_async_submit_file_read		(PSocketAsync		*async,
+									 PFile			*file,
+									 pchar			*buffer,
+									 psize			buflen,
+									 puint64		offset,
+									 ppointer		user_data,
+									 PError			**error);
+
+/**
+ * @brief Submits a file write operation.
+ * @param async #PSocketAsync to submit the operation to.
+ * @param file #PFile to write data to, opened for writing.
+ * @param buffer Buffer with data to write.
+ * @param buflen Length of @a buffer.
+ * @param offset Offset in the file to write data at.
+ * @param user_data Pointer to return along with the completion.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * Check the @a result field of the completion: the kernel may write less data
+ * than requested, i.e. when the disk is full.
+ */
+P_LIB_API pboolean		p_socket_async_submit_file_write	(PSocketAsync		*async,
+									 PFile			*file,
+									 const pchar		*buffer,
+									 psize			buflen,
+									 puint64		offset,
+									 ppointer		user_data,
+									 PError			**error);
+
+/**
+ * @brief Submits a file synchronization operation.
+ * @param async #PSocketAsync to submit the operation to.
+ * @param file #PFile to synchronize.
+ * @param data_only Whether to flush only data, as p_file_sync_data() does.
+ * @param user_data Pointer to return along with the completion.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The synchronization is not ordered with the other operations in progress:
+ * submit it after the writes it should cover are completed.
+ */
+P_LIB_API pboolean		p_socket_async_submit_file_sync		(PSocketAsync		*async,
+									 PFile			*file,
+									 pboolean		data_only,
+									 ppointer		user_data,
+									 PError			**error);
+
+/**
+ * @brief Gets the number of operations in progress.
+ * @param async #PSocketAsync to get the number for.
+ * @return Number of submitted operations which are not reaped yet.
+ * @since 0.0.5
+ */
+P_LIB_API pint			p_socket_async_get_pending		(const PSocketAsync	*async);
+
+/**
+ * @brief Waits for the submitted operations to complete.
+ * @param async #PSocketAsync to wait on.
+ * @param[out] completions Array to store the finished operations in.
+ * @param max_completions Size of @a completions.
+ * @param timeout Timeout in milliseconds, -1 to wait infinitely, 0 to return
+ * immediately.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Number of finished operations stored in @a completions, 0 on
+ * timeout, -1 in case of error.
+ * @since 0.0.5
+ *
+ * The operations submitted since the last call are started first. The call
+ * returns as soon as at least one operation is finished, reaping all the
+ * finished ones up to @a max_completions. The rest are reported by the next
+ * calls. The call returns 0 immediately if there are no operations in
+ * progress, and may return 0 before the timeout if it was interrupted by a
+ * signal.
+ *
+ * A failure of an operation is reported in its completion, the call itself
+ * fails only if the queue can't be waited on.
+ */
+P_LIB_API pint			p_socket_async_wait			(PSocketAsync		*async,
+									 PSocketAsyncCompletion	*completions,
+									 pint			max_completions,
+									 pint			timeout,
+									 PError			**error);
+
+/**
+ * @brief Frees an asynchronous socket operations queue.
+ * @param async #PSocketAsync to free.
+ * @since 0.0.5
+ *
+ * The operations in progress are cancelled, and the call waits until the
+ * kernel releases their buffers. File operations can't be cancelled, the call
+ * waits for them to finish. Connections accepted by the cancelled accept
+ * operations are closed. The sockets are not closed or freed.
+ */
+P_LIB_API void			p_socket_async_free			(PSocketAsync		*async);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PSOCKETASYNC_H */
@@ -0,0 +1,1128 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "phashtable.h"
+#include "pmem.h"
+#include "psocketpoller.h"
+#include "perror-private.h"
+
+#include <string.h>
+
+#if defined (P_OS_WIN)
+#  define P_SOCKET_POLLER_USE_WSAPOLL
+#elif defined (PLIBSYS_HAS_EPOLL)
+#  define P_SOCKET_POLLER_USE_EPOLL
+#  include <sys/epoll.h>
+#elif defined (PLIBSYS_HAS_KQUEUE)
+#  define P_SOCKET_POLLER_USE_KQUEUE
+#  include <sys/types.h>
+#  include <sys/event.h>
+#  include <sys/time.h>
+#elif defined (P_OS_BEOS) || defined (P_OS_MAC) || defined (P_OS_MAC9) || \
+      defined (P_OS_OS2)  || defined (P_OS_AMIGA)
+#  define P_SOCKET_POLLER_USE_SELECT
+#  include <sys/select.h>
+#  include <sys/time.h>
+#else
+#  define P_SOCKET_POLLER_USE_POLL
+#  include <sys/poll.h>
+#endif
+
+#ifndef P_OS_WIN
+#  include "psysclose-private.h"
+
+#  include <errno.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif
+
+#if defined (P_SOCKET_POLLER_USE_EPOLL) || defined (P_SOCKET_POLLER_USE_KQUEUE)
+#  define P_SOCKET_POLLER_USE_KERNEL_SET
+#endif
+
+#define P_SOCKET_POLLER_MIN_REGS	16
+#define P_SOCKET_POLLER_CONDITIONS	(P_SOCKET_POLLER_CONDITION_IN | P_SOCKET_POLLER_CONDITION_OUT)
+
+#ifdef P_SOCKET_POLLER_USE_WSAPOLL
+/* Older SDKs lack the WSAPoll() declarations */
+#  define P_SOCKET_POLLER_WIN_POLLERR		0x0001
+#  define P_SOCKET_POLLER_WIN_POLLHUP		0x0002
+#  define P_SOCKET_POLLER_WIN_POLLNVAL		0x0004
+#  define P_SOCKET_POLLER_WIN_POLLWRNORM	0x0010
+#  define P_SOCKET_POLLER_WIN_POLLRDNORM	0x0100
+
+typedef struct PSocketPollerPollFd_ {
+	SOCKET	fd;
+	SHORT	events;
+	SHORT	revents;
+} PSocketPollerPollFd;
+
+typedef int (WSAAPI * PSocketPollerWSAPollFunc) (PSocketPollerPollFd	*fds,
+						 ULONG			n_fds,
+						 INT			timeout);
+#elif defined (P_SOCKET_POLLER_USE_POLL)
+typedef struct pollfd PSocketPollerPollFd;
+#endif
+
+#ifdef P_SOCKET_POLLER_USE_KQUEUE
+/* NetBSD before 10.0 declares the user data as an integer */
+#  ifdef P_OS_NETBSD
+#    define P_SOCKET_POLLER_KEVENT_UDATA(ptr)	((intptr_t) (ptr))
+#  else
+#    define P_SOCKET_POLLER_KEVENT_UDATA(ptr)	((void *) (ptr))
+#  endif
+#endif
+
+typedef struct PSocketPollerReg_ {
+	PSocket		*socket;
+	ppointer	user_data;
+	pint		fd;
+	pint		conditions;
+	pint		flags;
+	pint		index;
+#ifdef P_SOCKET_POLLER_USE_KQUEUE
+	puint		wait_id;
+	pint		event_index;
+#endif
+} PSocketPollerReg;
+
+struct PSocketPoller_ {
+	PHashTable			*sockets;
+	PSocketPollerReg		**regs;
+	pint				regs_count;
+	pint				regs_size;
+	pint				scan_start;
+#ifdef P_SOCKET_POLLER_USE_KERNEL_SET
+	pint				poll_fd;
+	ppointer			sys_events;
+	pint				sys_events_size;
+#endif
+#ifdef P_SOCKET_POLLER_USE_KQUEUE
+	puint				wait_id;
+#endif
+#if defined (P_SOCKET_POLLER_USE_POLL) || defined (P_SOCKET_POLLER_USE_WSAPOLL)
+	PSocketPollerPollFd		*pfds;
+#endif
+#ifdef P_SOCKET_POLLER_USE_WSAPOLL
+	PSocketPollerWSAPollFunc	wsapoll;
+#endif
+};
+
+static pboolean pp_socket_poller_check_args (pint conditions, pint flags, PError **error);
+static pboolean pp_socket_poller_reserve (PSocketPoller *poller, PError **error);
+static pboolean pp_socket_poller_add (PSocketPoller *poller, ppointer key, PSocket *socket, pint fd, pint conditions, pint flags, ppointer user_data, PError **error);
+static pboolean pp_socket_poller_remove (PSocketPoller *poller, ppointer key, PError **error);
+static void pp_socket_poller_set_error (PError **error, const pchar *message);
+static pboolean pp_socket_poller_sys_init (PSocketPoller *poller, PError **error);
+static void pp_socket_poller_sys_close (PSocketPoller *poller);
+static pboolean pp_socket_poller_sys_update (PSocketPoller *poller, PSocketPollerReg *reg, pint old_conditions, pboolean is_new, PError **error);
+static void pp_socket_poller_sys_remove (PSocketPoller *poller, PSocketPollerReg *reg);
+static pint pp_socket_poller_sys_wait (PSocketPoller *poller, PSocketPollerEvent *events, pint max_events, pint timeout, PError **error);
+
+static pboolean
+pp_socket_poller_check_args (pint	conditions,
+			     pint	flags,
+			     PError	**error)
+{
+	if (P_UNLIKELY ((conditions & ~P_SOCKET_POLLER_CONDITIONS) != 0 ||
+			(flags & ~P_SOCKET_POLLER_FLAG_EDGE_TRIGGERED) != 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid socket poller conditions or flags");
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static pboolean
+pp_socket_poller_reserve (PSocketPoller	*poller,
+			  PError	**error)
+{
+	PSocketPollerReg	**regs;
+#if defined (P_SOCKET_POLLER_USE_POLL) || defined (P_SOCKET_POLLER_USE_WSAPOLL)
+	PSocketPollerPollFd	*pfds;
+#endif
+	pint			new_size;
+
+	if (P_LIKELY (poller->regs_count < poller->regs_size))
+		return TRUE;
+
+	new_size = poller->regs_size == 0 ? P_SOCKET_POLLER_MIN_REGS : poller->regs_size * 2;
+
+	if (P_UNLIKELY (new_size < poller->regs_size ||
+			(regs = p_realloc (poller->regs, (psize) new_size * sizeof (PSocketPollerReg *))) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for socket poller");
+		return FALSE;
+	}
+
+	poller->regs = regs;
+
+#if defined (P_SOCKET_POLLER_USE_POLL) || defined (P_SOCKET_POLLER_USE_WSAPOLL)
+	if (P_UNLIKELY ((pfds = p_realloc (poller->pfds, (psize) new_size * sizeof (PSocketPollerPollFd))) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for socket poller");
+		return FALSE;
+	}
+
+	poller->pfds = pfds;
+#endif
+
+	poller->regs_size = new_size;
+
+	return TRUE;
+}
+
+static void
+pp_socket_poller_set_error (PError	**error,
+			    const pchar	*message)
+{
+	p_error_set_error_p (error,
+			     (pint) p_error_get_io_from_system (p_error_get_last_net ()),
+			     (pint) p_error_get_last_net (),
+			     message);
+}
+
+#if defined (P_SOCKET_POLLER_USE_EPOLL)
+static pboolean
+pp_socket_poller_sys_init (PSocketPoller	*poller,
+			   PError		**error)
+{
+#  ifdef EPOLL_CLOEXEC
+	poller->poll_fd = epoll_create1 (EPOLL_CLOEXEC);
+#  else
+	pint flags;
+
+	if (P_LIKELY ((poller->poll_fd = epoll_create (P_SOCKET_POLLER_MIN_REGS)) != -1)) {
+		flags = fcntl (poller->poll_fd, F_GETFD, 0);
+
+		if (P_UNLIKELY (flags == -1 || fcntl (poller->poll_fd, F_SETFD, flags | FD_CLOEXEC) == -1))
+			P_WARNING ("PSocketPoller::pp_socket_poller_sys_init: fcntl() with FD_CLOEXEC failed");
+	}
+#  endif
+
+	if (P_UNLIKELY (poller->poll_fd == -1)) {
+		pp_socket_poller_set_error (error, "Failed to call epoll_create() to create poller");
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static pboolean
+pp_socket_poller_sys_update (PSocketPoller	*poller,
+			     PSocketPollerReg	*reg,
+			     pint		old_conditions,
+			     pboolean		is_new,
+			     PError		**error)
+{
+	struct epoll_event ev;
+
+	P_UNUSED (old_conditions);
+
+	memset (&ev, 0, sizeof (ev));
+
+	ev.data.ptr = reg;
+	ev.events   = 0;
+
+	if (reg->conditions & P_SOCKET_POLLER_CONDITION_IN)
+		ev.events |= EPOLLIN;
+
+	if (reg->conditions & P_SOCKET_POLLER_CONDITION_OUT)
+		ev.events |= EPOLLOUT;
+
+	if (reg->flags & P_SOCKET_POLLER_FLAG_EDGE_TRIGGERED)
+		ev.events |= EPOLLET;
+
+	if (P_UNLIKELY (epoll_ctl (poller->poll_fd,
+				   is_new ? EPOLL_CTL_ADD : EPOLL_CTL_MOD,
+				   reg->fd,
+				   &ev) != 0)) {
+		pp_socket_poller_set_error (error, "Failed to call epoll_ctl() to register socket");
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static void
+pp_socket_poller_sys_remove (PSocketPoller	*poller,
+			     PSocketPollerReg	*reg)
+{
+	struct epoll_event ev;
+
+	/* Old kernels require a non-NULL event, a closed socket is already removed */
+	memset (&ev, 0, sizeof (ev));
+	epoll_ctl (poller->poll_fd, EPOLL_CTL_DEL, reg->fd, &ev);
+}
+
+static pint
+pp_socket_poller_sys_wait (PSocketPoller	*poller,
+			   PSocketPollerEvent	*events,
+			   pint			max_events,
+			   pint			timeout,
+			   PError		**error)
+{
+	struct epoll_event	*sys_events;
+	PSocketPollerReg	*reg;
+	pint			evret;
+	pint			i;
+
+	sys_events = (struct epoll_event *) poller->sys_events;
+	evret      = epoll_wait (poller->poll_fd, sys_events, max_events, timeout);
+
+	if (P_UNLIKELY (evret == -1)) {
+		if (p_error_get_last_net () == EINTR)
+			return 0;
+
+		pp_socket_poller_set_error (error, "Failed to call epoll_wait() on poller");
+		return -1;
+	}
+
+	for (i = 0; i < evret; ++i) {
+		reg = (PSocketPollerReg *) sys_events[i].data.ptr;
+
+		events[i].socket     = reg->socket;
+		events[i].user_data  = reg->user_data;
+		events[i].conditions = 0;
+
+		if (sys_events[i].events & EPOLLIN)
+			events[i].conditions |= P_SOCKET_POLLER_CONDITION_IN;
+
+		if (sys_events[i].events & EPOLLOUT)
+			events[i].conditions |= P_SOCKET_POLLER_CONDITION_OUT;
+
+		if (sys_events[i].events & EPOLLERR)
+			events[i].conditions |= P_SOCKET_POLLER_CONDITION_ERROR;
+
+		if (sys_events[i].events & EPOLLHUP)
+			events[i].conditions |= P_SOCKET_POLLER_CONDITION_HANGUP;
+	}
+
+	return evret;
+}
+#elif defined (P_SOCKET_POLLER_USE_KQUEUE)
+static pboolean
+pp_socket_poller_sys_init (PSocketPoller	*poller,
+			   PError		**error)
+{
+	pint flags;
+
+	if (P_UNLIKELY ((poller->poll_fd = kqueue ()) == -1)) {
+		pp_socket_poller_set_error (error, "Failed to call kqueue() to create poller");
+		return FALSE;
+	}
+
+	flags = fcntl (poller->poll_fd, F_GETFD, 0);
+
+	if (P_UNLIKELY (flags == -1 || fcntl (poller->poll_fd, F_SETFD, flags | FD_CLOEXEC) == -1))
+		P_WARNING ("PSocketPoller::pp_socket_poller_sys_init: fcntl() with FD_CLOEXEC failed");
+
+	poller->wait_id = 0;
+
+	return TRUE;
+}
+
+/* Read and write readiness are separate filters in kqueue */
+static pboolean
+pp_socket_poller_sys_update (PSocketPoller	*poller,
+			     PSocketPollerReg	*reg,
+			     pint		old_conditions,
+			     pboolean		is_new,
+			     PError		**error)
+{
+	struct kevent	changes[2];
+	pint		n_changes = 0;
+	pint		add_flags;
+
+	P_UNUSED (is_new);
+
+	add_flags = EV_ADD | EV_ENABLE;
+
+	if (reg->flags & P_SOCKET_POLLER_FLAG_EDGE_TRIGGERED)
+		add_flags |= EV_CLEAR;
+
+	if (reg->conditions & P_SOCKET_POLLER_CONDITION_IN)
+		EV_SET (&changes[n_changes++], reg->fd, EVFILT_READ, add_flags, 0, 0,
+			P_SOCKET_POLLER_KEVENT_UDATA (reg));
+	else if (old_conditions & P_SOCKET_POLLER_CONDITION_IN)
+		EV_SET (&changes[n_changes++], reg->fd, EVFILT_READ, EV_DELETE, 0, 0,
+			P_SOCKET_POLLER_KEVENT_UDATA (reg));
+
+	if (reg->conditions & P_SOCKET_POLLER_CONDITION_OUT)
+		EV_SET (&changes[n_changes++], reg->fd, EVFILT_WRITE, add_flags, 0, 0,
+			P_SOCKET_POLLER_KEVENT_UDATA (reg));
+	else if (old_conditions & P_SOCKET_POLLER_CONDITION_OUT)
+		EV_SET (&changes[n_changes++], reg->fd, EVFILT_WRITE, EV_DELETE, 0, 0,
+			P_SOCKET_POLLER_KEVENT_UDATA (reg));
+
+	if (n_changes == 0)
+		return TRUE;
+
+	if (P_UNLIKELY (kevent (poller->poll_fd, changes, n_changes, NULL, 0, NULL) == -1)) {
+		pp_socket_poller_set_error (error, "Failed to call kevent() to register socket");
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static void
+pp_socket_poller_sys_remove (PSocketPoller	*poller,
+			     PSocketPollerReg	*reg)
+{
+	struct kevent	change;
+
+	/* Closed sockets are already removed, so the errors are ignored */
+	if (reg->conditions & P_SOCKET_POLLER_CONDITION_IN) {
+		EV_SET (&change, reg->fd, EVFILT_READ, EV_DELETE, 0, 0, P_SOCKET_POLLER_KEVENT_UDATA (reg));
+		kevent (poller->poll_fd, &change, 1, NULL, 0, NULL);
+	}
+
+	if (reg->conditions & P_SOCKET_POLLER_CONDITION_OUT) {
+		EV_SET (&change, reg->fd, EVFILT_WRITE, EV_DELETE, 0, 0, P_SOCKET_POLLER_KEVENT_UDATA (reg));
+		kevent (poller->poll_fd, &change, 1, NULL, 0, NULL);
+	}
+}
+
+static pint
+pp_socket_poller_sys_wait (PSocketPoller	*poller,
+			   PSocketPollerEvent	*events,
+			   pint			max_events,
+			   pint			timeout,
+			   PError		**error)
+{
+	struct kevent		*sys_events;
+	struct timespec		ts;
+	PSocketPollerReg	*reg;
+	PSocketPollerEvent	*event;
+	pint			evret;
+	pint			n_events;
+	pint			i;
+
+	if (timeout >= 0) {
+		ts.tv_sec  = timeout / 1000;
+		ts.tv_nsec = (timeout % 1000) * 1000000L;
+	}
+
+	sys_events = (struct kevent *) poller->sys_events;
+	evret      = kevent (poller->poll_fd, NULL, 0, sys_events, max_events, timeout >= 0 ? &ts : NULL);
+
+	if (P_UNLIKELY (evret == -1)) {
+		if (p_error_get_last_net () == EINTR)
+			return 0;
+
+		pp_socket_poller_set_error (error, "Failed to call kevent() on poller");
+		return -1;
+	}
+
+	/* Both filters of a socket are merged into a single event */
+	if (P_UNLIKELY (++poller->wait_id == 0))
+		++poller->wait_id;
+
+	n_events = 0;
+
+	for (i = 0; i < evret; ++i) {
+		reg = (PSocketPollerReg *) (puintptr) sys_events[i].udata;
+
+		if (reg->wait_id == poller->wait_id)
+			event = &events[reg->event_index];
+		else {
+			reg->wait_id     = poller->wait_id;
+			reg->event_index = n_events;
+
+			event = &events[n_events++];
+
+			event->socket     = reg->socket;
+			event->user_data  = reg->user_data;
+			event->conditions = 0;
+		}
+
+		if (sys_events[i].filter == EVFILT_READ)
+			event->conditions |= P_SOCKET_POLLER_CONDITION_IN;
+		else if (sys_events[i].filter == EVFILT_WRITE)
+			event->conditions |= P_SOCKET_POLLER_CONDITION_OUT;
+
+		if (sys_events[i].flags & EV_ERROR)
+			event->conditions |= P_SOCKET_POLLER_CONDITION_ERROR;
+
+		if (sys_events[i].flags & EV_EOF)
+			event->conditions |= P_SOCKET_POLLER_CONDITION_HANGUP;
+	}
+
+	return n_events;
+}
+#elif defined (P_SOCKET_POLLER_USE_POLL) || defined (P_SOCKET_POLLER_USE_WSAPOLL)
+static pboolean
+pp_socket_poller_sys_init (PSocketPoller	*poller,
+			   PError		**error)
+{
+#  ifdef P_SOCKET_POLLER_USE_WSAPOLL
+	HMODULE hmodule;
+
+	if (P_LIKELY ((hmodule = GetModuleHandleA ("ws2_32.dll")) != NULL))
+		poller->wsapoll = (PSocketPollerWSAPollFunc) GetProcAddress (hmodule, "WSAPoll");
+
+	/* Windows XP and older */
+	if (P_UNLIKELY (poller->wsapoll == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NOT_SUPPORTED,
+				     0,
+				     "WSAPoll() is not available");
+		return FALSE;
+	}
+#  else
+	P_UNUSED (poller);
+	P_UNUSED (error);
+#  endif
+
+	return TRUE;
+}
+
+static pboolean
+pp_socket_poller_sys_update (PSocketPoller	*poller,
+			     PSocketPollerReg	*reg,
+			     pint		old_conditions,
+			     pboolean		is_new,
+			     PError		**error)
+{
+	PSocketPollerPollFd *pfd;
+
+	P_UNUSED (old_conditions);
+	P_UNUSED (is_new);
+	P_UNUSED (error);
+
+	pfd = &poller->pfds[reg->index];
+
+#  ifdef P_SOCKET_POLLER_USE_WSAPOLL
+	pfd->fd = (SOCKET) reg->fd;
+#  else
+	pfd->fd = reg->fd;
+#  endif
+	pfd->events  = 0;
+	pfd->revents = 0;
+
+#  ifdef P_SOCKET_POLLER_USE_WSAPOLL
+	if (reg->conditions & P_SOCKET_POLLER_CONDITION_IN)
+		pfd->events |= P_SOCKET_POLLER_WIN_POLLRDNORM;
+
+	if (reg->conditions & P_SOCKET_POLLER_CONDITION_OUT)
+		pfd->events |= P_SOCKET_POLLER_WIN_POLLWRNORM;
+#  else
+	if (reg->conditions & P_SOCKET_POLLER_CONDITION_IN)
+		pfd->events |= POLLIN;
+
+	if (reg->conditions & P_SOCKET_POLLER_CONDITION_OUT)
+		pfd->events |= POLLOUT;
+#  endif
+
+	return TRUE;
+}
+
+static void
+pp_socket_poller_sys_remove (PSocketPoller	*poller,
+			     PSocketPollerReg	*reg)
+{
+	/* The last registration takes the place of the removed one */
+	poller->pfds[reg->index] = poller->pfds[poller->regs_count - 1];
+}
+
+static pint
+pp_socket_poller_sys_wait (PSocketPoller	*poller,
+			   PSocketPollerEvent	*events,
+			   pint			max_events,
+			   pint			timeout,
+			   PError		**error)
+{
+	PSocketPollerPollFd	*pfd;
+	PSocketPollerReg	*reg;
+	pint			evret;
+	pint			n_events;
+	pint			scan_start;
+	pint			index;
+	pint			i;
+
+#  ifdef P_SOCKET_POLLER_USE_WSAPOLL
+	evret = poller->wsapoll (poller->pfds, (ULONG) poller->regs_count, timeout);
+#  else
+	evret = poll (poller->pfds, (nfds_t) poller->regs_count, timeout);
+#  endif
+
+	if (P_UNLIKELY (evret < 0)) {
+#  ifdef EINTR
+		if (p_error_get_last_net () == EINTR)
+			return 0;
+#  endif
+
+		pp_socket_poller_set_error (error, "Failed to call poll() on poller");
+		return -1;
+	}
+
+	n_events   = 0;
+	scan_start = poller->scan_start;
+
+	/* Scanning starts after the last reported socket to be fair */
+	for (i = 0; i < poller->regs_count && n_events < max_events && evret > 0; ++i) {
+		index = (scan_start + i) % poller->regs_count;
+		pfd   = &poller->pfds[index];
+
+		if (pfd->revents == 0)
+			continue;
+
+		--evret;
+
+		reg = poller->regs[index];
+
+		events[n_events].socket     = reg->socket;
+		events[n_events].user_data  = reg->user_data;
+		events[n_events].conditions = 0;
+
+#  ifdef P_SOCKET_POLLER_USE_WSAPOLL
+		if (pfd->revents & P_SOCKET_POLLER_WIN_POLLRDNORM)
+			events[n_events].conditions |= P_SOCKET_POLLER_CONDITION_IN;
+
+		if (pfd->revents & P_SOCKET_POLLER_WIN_POLLWRNORM)
+			events[n_events].conditions |= P_SOCKET_POLLER_CONDITION_OUT;
+
+		if (pfd->revents & (P_SOCKET_POLLER_WIN_POLLERR | P_SOCKET_POLLER_WIN_POLLNVAL))
+			events[n_events].conditions |= P_SOCKET_POLLER_CONDITION_ERROR;
+
+		if (pfd->revents & P_SOCKET_POLLER_WIN_POLLHUP)
+			events[n_events].conditions |= P_SOCKET_POLLER_CONDITION_HANGUP;
+#  else
+		if (pfd->revents & POLLIN)
+			events[n_events].conditions |= P_SOCKET_POLLER_CONDITION_IN;
+
+		if (pfd->revents & POLLOUT)
+			events[n_events].conditions |= P_SOCKET_POLLER_CONDITION_OUT;
+
+		if (pfd->revents & (POLLERR | POLLNVAL))
+			events[n_events].conditions |= P_SOCKET_POLLER_CONDITION_ERROR;
+
+		if (pfd->revents & POLLHUP)
+			events[n_events].conditions |= P_SOCKET_POLLER_CONDITION_HANGUP;
+#  endif
+
+		pfd->revents = 0;
+
+		poller->scan_start = index + 1;
+		++n_events;
+	}
+
+	return n_events;
+}
+#else /* P_SOCKET_POLLER_USE_SELECT */
+static pboolean
+pp_socket_poller_sys_init (PSocketPoller	*poller,
+			   PError		**error)
+{
+	P_UNUSED (poller);
+	P_UNUSED (error);
+
+	return TRUE;
+}
+
+static pboolean
+pp_socket_poller_sys_update (PSocketPoller	*poller,
+			     PSocketPollerReg	*reg,
+			     pint		old_conditions,
+			     pboolean		is_new,
+			     PError		**error)
+{
+	P_UNUSED (poller);
+	P_UNUSED (old_conditions);
+	P_UNUSED (is_new);
+
+	if (P_UNLIKELY (reg->fd >= FD_SETSIZE)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Socket descriptor is out of select() range");
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static void
+pp_socket_poller_sys_remove (PSocketPoller	*poller,
+			     PSocketPollerReg	*reg)
+{
+	P_UNUSED (poller);
+	P_UNUSED (reg);
+}
+
+static pint
+pp_socket_poller_sys_wait (PSocketPoller	*poller,
+			   PSocketPollerEvent	*events,
+			   pint			max_events,
+			   pint			timeout,
+			   PError		**error)
+{
+	fd_set			read_fds;
+	fd_set			write_fds;
+	fd_set			except_fds;
+	struct timeval		tv;
+	PSocketPollerReg	*reg;
+	pint			max_fd = -1;
+	pint			evret;
+	pint			n_events;
+	pint			scan_start;
+	pint			index;
+	pint			conditions;
+	pint			i;
+
+	FD_ZERO (&read_fds);
+	FD_ZERO (&write_fds);
+	FD_ZERO (&except_fds);
+
+	for (i = 0; i < poller->regs_count; ++i) {
+		reg = poller->regs[i];
+
+		if (reg->conditions & P_SOCKET_POLLER_CONDITION_IN)
+			FD_SET (reg->fd, &read_fds);
+
+		if (reg->conditions & P_SOCKET_POLLER_CONDITION_OUT)
+			FD_SET (reg->fd, &write_fds);
+
+		FD_SET (reg->fd, &except_fds);
+
+		if (reg->fd > max_fd)
+			max_fd = reg->fd;
+	}
+
+	if (timeout >= 0) {
+		tv.tv_sec  = timeout / 1000;
+		tv.tv_usec = (timeout % 1000) * 1000;
+	}
+
+	evret = select (max_fd + 1, &read_fds, &write_fds, &except_fds, timeout >= 0 ? &tv : NULL);
+
+	if (P_UNLIKELY (evret < 0)) {
+#  ifdef EINTR
+		if (p_error_get_last_net () == EINTR)
+			return 0;
+#  endif
+
+		pp_socket_poller_set_error (error, "Failed to call select() on poller");
+		return -1;
+	}
+
+	n_events   = 0;
+	scan_start = poller->scan_start;
+
+	for (i = 0; i < poller->regs_count && n_events < max_events && evret > 0; ++i) {
+		index = (scan_start + i) % poller->regs_count;
+		reg   = poller->regs[index];
+
+		conditions = 0;
+
+		if (FD_ISSET (reg->fd, &read_fds))
+			conditions |= P_SOCKET_POLLER_CONDITION_IN;
+
+		if (FD_ISSET (reg->fd, &write_fds))
+			conditions |= P_SOCKET_POLLER_CONDITION_OUT;
+
+		if (FD_ISSET (reg->fd, &except_fds))
+			conditions |= P_SOCKET_POLLER_CONDITION_ERROR;
+
+		if (conditions == 0)
+			continue;
+
+		--evret;
+
+		events[n_events].socket     = reg->socket;
+		events[n_events].user_data  = reg->user_data;
+		events[n_events].conditions = conditions;
+
+		poller->scan_start = index + 1;
+		++n_events;
+	}
+
+	return n_events;
+}
+#endif
+
+static void
+pp_socket_poller_sys_close (PSocketPoller *poller)
+{
+#ifdef P_SOCKET_POLLER_USE_KERNEL_SET
+	if (poller->poll_fd != -1 && P_UNLIKELY (p_sys_close (poller->poll_fd) != 0))
+		P_WARNING ("PSocketPoller::pp_socket_poller_sys_close: p_sys_close() failed");
+
+	poller->poll_fd = -1;
+
+	p_free (poller->sys_events);
+#endif
+#if defined (P_SOCKET_POLLER_USE_POLL) || defined (P_SOCKET_POLLER_USE_WSAPOLL)
+	p_free (poller->pfds);
+#endif
+#ifdef P_SOCKET_POLLER_USE_SELECT
+	P_UNUSED (poller);
+#endif
+}
+
+static pboolean
+pp_socket_poller_add (PSocketPoller	*poller,
+		      ppointer		key,
+		      PSocket		*socket,
+		      pint		fd,
+		      pint		conditions,
+		      pint		flags,
+		      ppointer		user_data,
+		      PError		**error)
+{
+	PSocketPollerReg *reg;
+
+	if (P_UNLIKELY (p_hash_table_lookup (poller->sockets, key) != (ppointer) -1)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_EXISTS,
+				     0,
+				     "Socket is already registered in poller");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (pp_socket_poller_reserve (poller, error) == FALSE))
+		return FALSE;
+
+	if (P_UNLIKELY ((reg = p_malloc0 (sizeof (PSocketPollerReg))) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for socket registration");
+		return FALSE;
+	}
+
+	reg->socket     = socket;
+	reg->user_data  = user_data;
+	reg->fd         = fd;
+	reg->conditions = conditions;
+	reg->flags      = flags;
+	reg->index      = poller->regs_count;
+
+	p_hash_table_insert (poller->sockets, key, reg);
+
+	/* Lookup fails only if the insertion failed to allocate memory */
+	if (P_UNLIKELY (p_hash_table_lookup (poller->sockets, key) != reg)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for socket registration");
+		p_free (reg);
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (pp_socket_poller_sys_update (poller, reg, 0, TRUE, error) == FALSE)) {
+		p_hash_table_remove (poller->sockets, key);
+		p_free (reg);
+		return FALSE;
+	}
+
+	poller->regs[poller->regs_count++] = reg;
+
+	return TRUE;
+}
+
+static pboolean
+pp_socket_poller_remove (PSocketPoller	*poller,
+			 ppointer	key,
+			 PError		**error)
+{
+	PSocketPollerReg *reg;
+
+	if (P_UNLIKELY ((reg = p_hash_table_lookup (poller->sockets, key)) == (ppointer) -1)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NOT_EXISTS,
+				     0,
+				     "Socket is not registered in poller");
+		return FALSE;
+	}
+
+	pp_socket_poller_sys_remove (poller, reg);
+
+	poller->regs[reg->index]        = poller->regs[poller->regs_count - 1];
+	poller->regs[reg->index]->index = reg->index;
+
+	--poller->regs_count;
+
+	p_hash_table_remove (poller->sockets, key);
+	p_free (reg);
+
+	return TRUE;
+}
+
+P_LIB_API PSocketPoller *
+p_socket_poller_new (PError **error)
+{
+	PSocketPoller *ret;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PSocketPoller))) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for socket poller");
+		return NULL;
+	}
+
+#ifdef P_SOCKET_POLLER_USE_KERNEL_SET
+	ret->poll_fd = -1;
+#endif
+
+	if (P_UNLIKELY ((ret->sockets = p_hash_table_new ()) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for socket poller");
+		p_free (ret);
+		return NULL;
+	}
+
+	if (P_UNLIKELY (pp_socket_poller_sys_init (ret, error) == FALSE)) {
+		p_socket_poller_free (ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+P_LIB_API pboolean
+p_socket_poller_add (PSocketPoller	*poller,
+		     PSocket		*socket,
+		     pint		conditions,
+		     pint		flags,
+		     ppointer		user_data,
+		     PError		**error)
+{
+	if (P_UNLIKELY (poller == NULL || socket == NULL || p_socket_get_fd (socket) < 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (pp_socket_poller_check_args (conditions, flags, error) == FALSE))
+		return FALSE;
+
+	return pp_socket_poller_add (poller,
+				     socket,
+				     socket,
+				     p_socket_get_fd (socket),
+				     conditions,
+				     flags,
+				     user_data,
+				     error);
+}
+
+P_LIB_API pboolean
+p_socket_poller_add_event (PSocketPoller	*poller,
+			   PEvent		*event,
+			   ppointer		user_data,
+			   PError		**error)
+{
+	if (P_UNLIKELY (poller == NULL || event == NULL || p_event_get_fd (event) < 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	/* Level-triggered, so an event which is not cleared is reported again */
+	return pp_socket_poller_add (poller,
+				     event,
+				     NULL,
+				     p_event_get_fd (event),
+				     P_SOCKET_POLLER_CONDITION_IN,
+				     P_SOCKET_POLLER_FLAG_NONE,
+				     user_data,
+				     error);
+}
+
+P_LIB_API pboolean
+p_socket_poller_modify (PSocketPoller	*poller,
+			PSocket		*socket,
+			pint		conditions,
+			pint		flags,
+			ppointer	user_data,
+			PError		**error)
+{
+	PSocketPollerReg	*reg;
+	pint			old_conditions;
+	pint			old_flags;
+
+	if (P_UNLIKELY (poller == NULL || socket == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (pp_socket_poller_check_args (conditions, flags, error) == FALSE))
+		return FALSE;
+
+	if (P_UNLIKELY ((reg = p_hash_table_lookup (poller->sockets, socket)) == (ppointer) -1)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NOT_EXISTS,
+				     0,
+				     "Socket is not registered in poller");
+		return FALSE;
+	}
+
+	old_conditions = reg->conditions;
+	old_flags      = reg->flags;
+
+	reg->conditions = conditions;
+	reg->flags      = flags;
+
+	if (P_UNLIKELY (pp_socket_poller_sys_update (poller, reg, old_conditions, FALSE, error) == FALSE)) {
+		reg->conditions = old_conditions;
+		reg->flags      = old_flags;
+		return FALSE;
+	}
+
+	reg->user_data = user_data;
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_socket_poller_remove (PSocketPoller	*poller,
+			PSocket		*socket,
+			PError		**error)
+{
+	if (P_UNLIKELY (poller == NULL || socket == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	return pp_socket_poller_remove (poller, socket, error);
+}
+
+P_LIB_API pboolean
+p_socket_poller_remove_event (PSocketPoller	*poller,
+			      PEvent		*event,
+			      PError		**error)
+{
+	if (P_UNLIKELY (poller == NULL || event == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	return pp_socket_poller_remove (poller, event, error);
+}
+
+P_LIB_API pint
+p_socket_poller_get_count (const PSocketPoller *poller)
+{
+	if (P_UNLIKELY (poller == NULL))
+		return 0;
+
+	return poller->regs_count;
+}
+
+P_LIB_API pint
+p_socket_poller_wait (PSocketPoller		*poller,
+		      PSocketPollerEvent	*events,
+		      pint			max_events,
+		      pint			timeout,
+		      PError			**error)
+{
+#if defined (P_SOCKET_POLLER_USE_EPOLL)
+	psize		event_size = sizeof (struct epoll_event);
+#elif defined (P_SOCKET_POLLER_USE_KQUEUE)
+	psize		event_size = sizeof (struct kevent);
+#endif
+#ifdef P_SOCKET_POLLER_USE_KERNEL_SET
+	ppointer	sys_events;
+#endif
+
+	if (P_UNLIKELY (poller == NULL || events == NULL || max_events <= 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	if (poller->regs_count == 0)
+		return 0;
+
+	if (timeout < 0)
+		timeout = -1;
+
+#ifdef P_SOCKET_POLLER_USE_KERNEL_SET
+	/* More events than sockets are never returned */
+	if (max_events > poller->regs_count)
+		max_events = poller->regs_count;
+
+	if (poller->sys_events_size < max_events) {
+		if (P_UNLIKELY ((sys_events = p_realloc (poller->sys_events,
+							 (psize) max_events * event_size)) == NULL)) {
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IO_NO_RESOURCES,
+					     0,
+					     "Failed to allocate memory for poller events");
+			return -1;
+		}
+
+		poller->sys_events      = sys_events;
+		poller->sys_events_size = max_events;
+	}
+#endif
+
+	return pp_socket_poller_sys_wait (poller, events, max_events, timeout, error);
+}
+
+P_LIB_API void
+p_socket_poller_free (PSocketPoller *poller)
+{
+	pint i;
+
+	if (P_UNLIKELY (poller == NULL))
+		return;
+
+	for (i = 0; i < poller->regs_count; ++i)
+		p_free (poller->regs[i]);
+
+	pp_socket_poller_sys_close (poller);
+
+	p_hash_table_free (poller->sockets);
+	p_free (poller->regs);
+	p_free (poller);
+}
@@ -0,0 +1,243 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file psocketpoller.h
+ * @brief Socket readiness poller
+ * @author Alexander Saprykin
+ *
+ * A socket poller waits for many sockets at once, which is the base of an
+ * event loop serving thousands of connections from a single thread. Where
+ * p_socket_io_condition_wait() blocks on one socket, a #PSocketPoller keeps a
+ * set of registered sockets and returns the ready ones in batches.
+ *
+ * Register a socket with p_socket_poller_add() for
+ * #P_SOCKET_POLLER_CONDITION_IN (the same as #P_SOCKET_IO_CONDITION_POLLIN:
+ * data to read or a connection to accept) and/or
+ * #P_SOCKET_POLLER_CONDITION_OUT (the same as #P_SOCKET_IO_CONDITION_POLLOUT:
+ * space to write or a finished connect). Every socket carries a user data
+ * pointer which is returned along with it. Conditions can be changed with
+ * p_socket_poller_modify(), and p_socket_poller_remove() unregisters a socket.
+ *
+ * p_socket_poller_wait() fills an array of #PSocketPollerEvent with the ready
+ * sockets. #P_SOCKET_POLLER_CONDITION_ERROR and
+ * #P_SOCKET_POLLER_CONDITION_HANGUP are reported whenever they happen, even if
+ * they were not requested.
+ *
+ * The best mechanism of the system is used: epoll on Linux, kqueue on BSD
+ * systems and macOS, WSAPoll() on Windows, and poll() or select() on the other
+ * systems. With epoll and kqueue the cost of a wait depends only on the number
+ * of ready sockets, not on the number of registered ones.
+ *
+ * Sockets are level-triggered by default: a socket is reported on every wait
+ * while it stays ready. With #P_SOCKET_POLLER_FLAG_EDGE_TRIGGERED a socket is
+ * reported once per readiness change on epoll and kqueue, so it must be read
+ * or written until the operation would block. Other systems ignore the flag,
+ * the draining loop works for them just as well.
+ *
+ * A #PEvent registered with p_socket_poller_add_event() wakes up the waiting
+ * thread from the other threads. It is reported with the
+ * #P_SOCKET_POLLER_CONDITION_IN condition and a NULL socket until it is reset
+ * with p_event_clear().
+ *
+ * Use non-blocking sockets with a poller, see p_socket_set_blocking(). Remove
+ * a socket from the poller before closing or freeing it. A poller is not
+ * thread-safe: register sockets and wait from the same thread, or guard the
+ * calls with a lock.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PSOCKETPOLLER_H
+#define PLIBSYS_HEADER_PSOCKETPOLLER_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+#include "psocket.h"
+#include "pevent.h"
+#include "perror.h"
+
+P_BEGIN_DECLS
+
+/** Socket poller conditions, can be combined. */
+typedef enum PSocketPollerCondition_ {
+	P_SOCKET_POLLER_CONDITION_IN		= P_SOCKET_IO_CONDITION_POLLIN,		/**< Ready to read.		*/
+	P_SOCKET_POLLER_CONDITION_OUT		= P_SOCKET_IO_CONDITION_POLLOUT,	/**< Ready to write.		*/
+	P_SOCKET_POLLER_CONDITION_ERROR		= 4,					/**< Error occurred, result only.	*/
+	P_SOCKET_POLLER_CONDITION_HANGUP	= 8					/**< Peer closed, result only.	*/
+} PSocketPollerCondition;
+
+/** Socket registration flags, can be combined. */
+typedef enum PSocketPollerFlags_ {
+	P_SOCKET_POLLER_FLAG_NONE		= 0,	/**< No flags.					*/
+	P_SOCKET_POLLER_FLAG_EDGE_TRIGGERED	= 1	/**< Report readiness changes only.		*/
+} PSocketPollerFlags;
+
+/** Ready socket returned by p_socket_poller_wait(). */
+typedef struct PSocketPollerEvent_ {
+	PSocket		*socket;	/**< Ready socket, NULL for an event.		*/
+	ppointer	user_data;	/**< User data given at the registration.	*/
+	pint		conditions;	/**< Combination of #PSocketPollerCondition.	*/
+} PSocketPollerEvent;
+
+/** Socket poller opaque data type. */
+typedef struct PSocketPoller_ PSocketPoller;
+
+/**
+ * @brief Creates a new socket poller.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Pointer to #PSocketPoller in case of success, NULL otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API PSocketPoller *	p_socket_poller_new	(PError			**error);
+
+/**
+ * @brief Registers a socket in a poller.
+ * @param poller #PSocketPoller to register the socket in.
+ * @param socket #PSocket to register.
+ * @param conditions Combination of #P_SOCKET_POLLER_CONDITION_IN and
+ * #P_SOCKET_POLLER_CONDITION_OUT to wait for, can be 0 to wait only for errors.
+ * @param flags Combination of #PSocketPollerFlags.
+ * @param user_data Pointer to return along with the socket.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * A socket can be registered only once in the same poller, use
+ * p_socket_poller_modify() to change the registration. With select() the
+ * descriptor of the socket must be less than FD_SETSIZE.
+ */
+P_LIB_API pboolean		p_socket_poller_add	(PSocketPoller		*poller,
+							 PSocket		*socket,
+							 pint			conditions,
+							 pint			flags,
+							 ppointer		user_data,
+							 PError			**error);
+
+/**
+ * @brief Changes the registration of a socket in a poller.
+ * @param poller #PSocketPoller the socket is registered in.
+ * @param socket #PSocket to change the registration for.
+ * @param conditions Combination of #P_SOCKET_POLLER_CONDITION_IN and
+ * #P_SOCKET_POLLER_CONDITION_OUT to wait for.
+ * @param flags Combination of #PSocketPollerFlags.
+ * @param user_data Pointer to return along with the socket.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean		p_socket_poller_modify	(PSocketPoller		*poller,
+							 PSocket		*socket,
+							 pint			conditions,
+							 pint			flags,
+							 ppointer		user_data,
+							 PError			**error);
+
+/**
+ * @brief Unregisters a socket from a poller.
+ * @param poller #PSocketPoller the socket is registered in.
+ * @param socket #PSocket to unregister.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean		p_socket_poller_remove	(PSocketPoller		*poller,
+							 PSocket		*socket,
+							 PError			**error);
+
+/**
+ * @brief Registers an event in a poller.
+ * @param poller #PSocketPoller to register the event in.
+ * @param event #PEvent to register.
+ * @param user_data Pointer to return along with the event.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The event is reported with a NULL socket while it is signaled, so reset it
+ * with p_event_clear() after the wakeup.
+ */
+P_LIB_API pboolean		p_socket_poller_add_event	(PSocketPoller		*poller,
+								 PEvent			*event,
+								 ppointer		user_data,
+								 PError			**error);
+
+/**
+ * @brief Unregisters an event from a poller.
+ * @param poller #PSocketPoller the event is registered in.
+ * @param event #PEvent to unregister.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean		p_socket_poller_remove_event	(PSocketPoller		*poller,
+								 PEvent			*event,
+								 PError			**error);
+
+/**
+ * @brief Gets the number of sockets and events registered in a poller.
+ * @param poller #PSocketPoller to get the number for.
+ * @return Number of registered sockets and events.
+ * @since 0.0.5
+ */
+P_LIB_API pint			p_socket_poller_get_count	(const PSocketPoller	*poller);
+
+/**
+ * @brief Waits for the registered sockets to become ready.
+ * @param poller #PSocketPoller to wait on.
+ * @param[out] events Array to store the ready sockets in.
+ * @param max_events Size of @a events.
+ * @param timeout Timeout in milliseconds, -1 to wait infinitely, 0 to return
+ * immediately.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Number of ready sockets stored in @a events, 0 on timeout, -1 in
+ * case of error.
+ * @since 0.0.5
+ *
+ * Each ready socket is reported once per call. If more than @a max_events
+ * sockets are ready, the rest are reported by the next calls. The call returns
+ * 0 immediately if no sockets are registered, and may return 0 before the
+ * timeout if it was interrupted by a signal.
+ */
+P_LIB_API pint			p_socket_poller_wait	(PSocketPoller		*poller,
+							 PSocketPollerEvent	*events,
+							 pint			max_events,
+							 pint			timeout,
+							 PError			**error);
+
+/**
+ * @brief Frees a socket poller.
+ * @param poller #PSocketPoller to free.
+ * @since 0.0.5
+ *
+ * The registered sockets are not closed or freed.
+ */
+P_LIB_API void			p_socket_poller_free	(PSocketPoller		*poller);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PSOCKETPOLLER_H */
@@ -0,0 +1,722 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "patomic.h"
+#include "pconcurrenthashtable.h"
+#include "plockfreestack.h"
+#include "pmem.h"
+#include "psocketpoller.h"
+#include "psocketpool.h"
+#include "ptimeprofiler.h"
+
+#define P_SOCKET_POOL_EVENTS	16
+
+/* Entries are never freed while the pool is in use: a popping thread may
+ * still read the link of an entry another thread has just popped */
+typedef struct PSocketPoolEntry_ {
+	PLockFreeStackNode	node;
+	PSocket			*socket;
+	puint64			idle_since;
+} PSocketPoolEntry;
+
+typedef struct PSocketPoolHost_ {
+	PSocketAddress		*address;
+	PLockFreeStack		*idle;
+	volatile pint		idle_count;
+	volatile pint		open_count;
+} PSocketPoolHost;
+
+struct PSocketPool_ {
+	PConcurrentHashTable	*hosts;
+	PLockFreeStack		*free_entries;
+	pint			max_idle;
+	pint			max_per_host;
+	volatile pint		idle_timeout;
+	volatile pint		connect_timeout;
+};
+
+static PSocketAddress * pp_socket_pool_copy_address (const PSocketAddress *address);
+static PSocketPoolHost * pp_socket_pool_host_new (const PSocketAddress *address);
+static void pp_socket_pool_host_free (PSocketPoolHost *host);
+static PSocketPoolHost * pp_socket_pool_get_host (PSocketPool *pool, const PSocketAddress *address, pboolean create, PError **error);
+static pboolean pp_socket_pool_reserve (volatile pint *counter, pint max);
+static void pp_socket_pool_close (PSocketPoolHost *host, PSocket *socket);
+static void pp_socket_pool_push_idle (PSocketPool *pool, PSocketPoolHost *host, PSocket *socket);
+static pboolean pp_socket_pool_is_alive (PSocketPool *pool, PSocketPoolEntry *entry, puint64 now);
+static PSocket * pp_socket_pool_connect (PSocketPool *pool, PSocketAddress *address, PError **error);
+static PSocket * pp_socket_pool_connect_start (PSocketAddress *address, pboolean *pending, PError **error);
+
+static PSocketAddress *
+pp_socket_pool_copy_address (const PSocketAddress *address)
+{
+	PSocketAddress	*ret;
+	ppointer	native;
+	psize		native_size;
+
+	native_size = p_socket_address_get_native_size (address);
+
+	if (P_UNLIKELY (native_size == 0 || (native = p_malloc0 (native_size)) == NULL))
+		return NULL;
+
+	ret = NULL;
+
+	if (P_LIKELY (p_socket_address_to_native (address, native, native_size) == TRUE))
+		ret = p_socket_address_new_from_native (native, native_size);
+
+	p_free (native);
+
+	return ret;
+}
+
+static PSocketPoolHost *
+pp_socket_pool_host_new (const PSocketAddress *address)
+{
+	PSocketPoolHost *ret;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PSocketPoolHost))) == NULL))
+		return NULL;
+
+	ret->address = pp_socket_pool_copy_address (address);
+	ret->idle    = p_lock_free_stack_new ();
+
+	if (P_UNLIKELY (ret->address == NULL || ret->idle == NULL)) {
+		pp_socket_pool_host_free (ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+static void
+pp_socket_pool_host_free (PSocketPoolHost *host)
+{
+	PLockFreeStackNode	*node;
+	PLockFreeStackNode	*next;
+	PSocketPoolEntry	*entry;
+
+	if (host->idle != NULL) {
+		for (node = p_lock_free_stack_pop_all (host->idle); node != NULL; node = next) {
+			next  = node->next;
+			entry = P_CONTAINER_OF (node, PSocketPoolEntry, node);
+
+			p_socket_free (entry->socket);
+			p_free (entry);
+		}
+
+		p_lock_free_stack_free (host->idle);
+	}
+
+	if (host->address != NULL)
+		p_socket_address_free (host->address);
+
+	p_free (host);
+}
+
+static PSocketPoolHost *
+pp_socket_pool_get_host (PSocketPool		*pool,
+			 const PSocketAddress	*address,
+			 pboolean		create,
+			 PError			**error)
+{
+	PSocketPoolHost	*host;
+	ppointer	existing;
+
+	/* Peers are never removed, the lookup takes no lock */
+	if (P_LIKELY ((host = p_concurrent_hash_table_lookup (pool->hosts, address)) != (ppointer) -1))
+		return host;
+
+	if (create == FALSE)
+		return NULL;
+
+	if (P_UNLIKELY ((host = pp_socket_pool_host_new (address)) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for socket pool peer");
+		return NULL;
+	}
+
+	existing = p_concurrent_hash_table_lookup_or_insert (pool->hosts, host->address, host);
+
+	if (existing != (ppointer) -1) {
+		pp_socket_pool_host_free (host);
+		return (PSocketPoolHost *) existing;
+	}
+
+	/* The insertion reports a failed allocation the same way */
+	if (P_UNLIKELY (p_concurrent_hash_table_lookup (pool->hosts, address) != host)) {
+		pp_socket_pool_host_free (host);
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for socket pool peer");
+		return NULL;
+	}
+
+	return host;
+}
+
+static pboolean
+pp_socket_pool_reserve (volatile pint	*counter,
+			pint		max)
+{
+	pint value;
+
+	if (max == 0) {
+		p_atomic_int_inc (counter);
+		return TRUE;
+	}
+
+	do {
+		if ((value = p_atomic_int_get (counter)) >= max)
+			return FALSE;
+	} while (p_atomic_int_compare_and_exchange (counter, value, value + 1) == FALSE);
+
+	return TRUE;
+}
+
+static void
+pp_socket_pool_close (PSocketPoolHost	*host,
+		      PSocket		*socket)
+{
+	p_socket_free (socket);
+	p_atomic_int_add (&host->open_count, -1);
+}
+
+/* Must be called with an idle slot reserved */
+static void
+pp_socket_pool_push_idle (PSocketPool		*pool,
+			  PSocketPoolHost	*host,
+			  PSocket		*socket)
+{
+	PLockFreeStackNode	*node;
+	PSocketPoolEntry	*entry;
+
+	if ((node = p_lock_free_stack_pop (pool->free_entries)) != NULL)
+		entry = P_CONTAINER_OF (node, PSocketPoolEntry, node);
+	else if (P_UNLIKELY ((entry = p_malloc0 (sizeof (PSocketPoolEntry))) == NULL)) {
+		p_atomic_int_add (&host->idle_count, -1);
+		pp_socket_pool_close (host, socket);
+		return;
+	}
+
+	entry->socket     = socket;
+	entry->idle_since = p_time_coarse_now_msecs ();
+
+	p_lock_free_stack_push (host->idle, &entry->node);
+}
+
+static pboolean
+pp_socket_pool_is_alive (PSocketPool		*pool,
+			 PSocketPoolEntry	*entry,
+			 puint64		now)
+{
+	PSocket		*socket = entry->socket;
+	PError		*error  = NULL;
+	pchar		byte;
+	pssize		received;
+	pint		timeout;
+	pboolean	silent;
+
+	timeout = p_atomic_int_get (&pool->idle_timeout);
+
+	if (timeout > 0 && now > entry->idle_since && now - entry->idle_since > (puint64) timeout)
+		return FALSE;
+
+	if (P_UNLIKELY (p_socket_is_closed (socket) == TRUE))
+		return FALSE;
+
+	/* An idle peer has nothing to say: data or EOF mean the connection is
+	 * either broken or closed */
+	silent = p_socket_get_silent_would_block (socket);
+
+	p_socket_set_silent_would_block (socket, TRUE);
+	p_socket_set_blocking (socket, FALSE);
+
+	received = p_socket_receive (socket, &byte, 1, &error);
+
+	p_socket_set_blocking (socket, TRUE);
+	p_socket_set_silent_would_block (socket, silent);
+
+	if (error != NULL) {
+		p_error_free (error);
+		return FALSE;
+	}
+
+	return received < 0;
+}
+
+static PSocket *
+pp_socket_pool_connect (PSocketPool	*pool,
+			PSocketAddress	*address,
+			PError		**error)
+{
+	PSocket	*ret;
+	pint	timeout;
+
+	if (P_UNLIKELY ((ret = p_socket_new (p_socket_address_get_family (address),
+					     P_SOCKET_TYPE_STREAM,
+					     P_SOCKET_PROTOCOL_TCP,
+					     error)) == NULL))
+		return NULL;
+
+	if ((timeout = p_atomic_int_get (&pool->connect_timeout)) > 0)
+		p_socket_set_timeout (ret, timeout);
+
+	if (P_UNLIKELY (p_socket_connect (ret, address, error) == FALSE)) {
+		p_socket_free (ret);
+		return NULL;
+	}
+
+	if (timeout > 0)
+		p_socket_set_timeout (ret, 0);
+
+	return ret;
+}
+
+static PSocket *
+pp_socket_pool_connect_start (PSocketAddress	*address,
+			      pboolean		*pending,
+			      PError		**error)
+{
+	PSocket	*ret;
+	PError	*conn_error = NULL;
+	pint	code;
+
+	if (P_UNLIKELY ((ret = p_socket_new (p_socket_address_get_family (address),
+					     P_SOCKET_TYPE_STREAM,
+					     P_SOCKET_PROTOCOL_TCP,
+					     error)) == NULL))
+		return NULL;
+
+	p_socket_set_blocking (ret, FALSE);
+
+	*pending = FALSE;
+
+	if (p_socket_connect (ret, address, &conn_error) == TRUE) {
+		p_socket_set_blocking (ret, TRUE);
+		return ret;
+	}
+
+	code = p_error_get_code (conn_error);
+
+	if (code == (pint) P_ERROR_IO_IN_PROGRESS || code == (pint) P_ERROR_IO_WOULD_BLOCK) {
+		p_error_free (conn_error);
+		*pending = TRUE;
+		return ret;
+	}
+
+	p_error_set_error_p (error,
+			     code,
+			     p_error_get_native_code (conn_error),
+			     p_error_get_message (conn_error));
+	p_error_free (conn_error);
+	p_socket_free (ret);
+
+	return NULL;
+}
+
+P_LIB_API PSocketPool *
+p_socket_pool_new (pint		max_idle,
+		   pint		max_per_host,
+		   PError	**error)
+{
+	PSocketPool *ret;
+
+	if (P_UNLIKELY (max_idle < 0 || max_per_host < 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PSocketPool))) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for socket pool");
+		return NULL;
+	}
+
+	ret->hosts = p_concurrent_hash_table_new_read_mostly (p_socket_address_hash,
+							      p_socket_address_equal,
+							      NULL,
+							      (PDestroyFunc) pp_socket_pool_host_free);
+	ret->free_entries = p_lock_free_stack_new ();
+
+	if (P_UNLIKELY (ret->hosts == NULL || ret->free_entries == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for socket pool");
+		p_socket_pool_free (ret);
+		return NULL;
+	}
+
+	ret->max_idle     = max_idle;
+	ret->max_per_host = max_per_host;
+	ret->idle_timeout = P_SOCKET_POOL_DEFAULT_IDLE_TIMEOUT;
+
+	return ret;
+}
+
+P_LIB_API void
+p_socket_pool_set_idle_timeout (PSocketPool	*pool,
+				pint		timeout)
+{
+	if (P_UNLIKELY (pool == NULL || timeout < 0))
+		return;
+
+	p_atomic_int_set (&pool->idle_timeout, timeout);
+}
+
+P_LIB_API void
+p_socket_pool_set_connect_timeout (PSocketPool	*pool,
+				   pint		timeout)
+{
+	if (P_UNLIKELY (pool == NULL || timeout < 0))
+		return;
+
+	p_atomic_int_set (&pool->connect_timeout, timeout);
+}
+
+P_LIB_API PSocket *
+p_socket_pool_acquire (PSocketPool	*pool,
+		       PSocketAddress	*address,
+		       PError		**error)
+{
+	PSocketPoolHost		*host;
+	PSocketPoolEntry	*entry;
+	PLockFreeStackNode	*node;
+	PSocket			*ret;
+	pboolean		alive;
+	puint64			now;
+
+	if (P_UNLIKELY (pool == NULL || address == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((host = pp_socket_pool_get_host (pool, address, TRUE, error)) == NULL))
+		return NULL;
+
+	now = p_time_coarse_now_msecs ();
+
+	while ((node = p_lock_free_stack_pop (host->idle)) != NULL) {
+		entry = P_CONTAINER_OF (node, PSocketPoolEntry, node);
+		ret   = entry->socket;
+
+		p_atomic_int_add (&host->idle_count, -1);
+
+		alive = pp_socket_pool_is_alive (pool, entry, now);
+
+		p_lock_free_stack_push (pool->free_entries, &entry->node);
+
+		if (P_LIKELY (alive == TRUE))
+			return ret;
+
+		pp_socket_pool_close (host, ret);
+	}
+
+	if (P_UNLIKELY (pp_socket_pool_reserve (&host->open_count, pool->max_per_host) == FALSE)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Connection limit of the peer is reached");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret = pp_socket_pool_connect (pool, address, error)) == NULL))
+		p_atomic_int_add (&host->open_count, -1);
+
+	return ret;
+}
+
+P_LIB_API void
+p_socket_pool_release (PSocketPool	*pool,
+		       PSocketAddress	*address,
+		       PSocket		*socket,
+		       pboolean		reusable)
+{
+	PSocketPoolHost *host;
+
+	if (P_UNLIKELY (pool == NULL || address == NULL || socket == NULL))
+		return;
+
+	/* Not taken from this pool */
+	if (P_UNLIKELY ((host = pp_socket_pool_get_host (pool, address, FALSE, NULL)) == NULL)) {
+		p_socket_free (socket);
+		return;
+	}
+
+	if (reusable == FALSE ||
+	    p_socket_is_connected (socket) == FALSE ||
+	    p_socket_is_closed (socket) == TRUE ||
+	    pool->max_idle == 0 ||
+	    pp_socket_pool_reserve (&host->idle_count, pool->max_idle) == FALSE) {
+		pp_socket_pool_close (host, socket);
+		return;
+	}
+
+	pp_socket_pool_push_idle (pool, host, socket);
+}
+
+P_LIB_API pint
+p_socket_pool_preconnect (PSocketPool		*pool,
+			  PSocketAddress	*address,
+			  pint			count,
+			  PError		**error)
+{
+	PSocketPollerEvent	events[P_SOCKET_POOL_EVENTS];
+	PSocketPoolHost		*host;
+	PSocketPoller		*poller   = NULL;
+	PTimeProfiler		*profiler = NULL;
+	PSocket			**sockets = NULL;
+	PError			*att_error = NULL;
+	pboolean		pending;
+	puint64			elapsed;
+	pint			timeout;
+	pint			wait_time;
+	pint			n_events;
+	pint			opened = 0;
+	pint			active = 0;
+	pint			started;
+	pint			i;
+	pint			k;
+
+	if (P_UNLIKELY (pool == NULL || address == NULL || count < 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	if (P_UNLIKELY ((host = pp_socket_pool_get_host (pool, address, TRUE, error)) == NULL))
+		return -1;
+
+	if (count == 0 || pool->max_idle == 0)
+		return 0;
+
+	sockets  = p_malloc0 ((psize) count * sizeof (PSocket *));
+	profiler = p_time_profiler_new ();
+
+	if (P_UNLIKELY (sockets == NULL || profiler == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for connection attempts");
+		opened = -1;
+	} else if (P_UNLIKELY ((poller = p_socket_poller_new (error)) == NULL))
+		opened = -1;
+
+	/* The connections take the idle slots in advance */
+	for (started = 0; opened >= 0 && started < count; ++started) {
+		if (pp_socket_pool_reserve (&host->idle_count, pool->max_idle) == FALSE)
+			break;
+
+		if (pp_socket_pool_reserve (&host->open_count, pool->max_per_host) == FALSE) {
+			p_atomic_int_add (&host->idle_count, -1);
+			break;
+		}
+
+		if (att_error != NULL) {
+			p_error_free (att_error);
+			att_error = NULL;
+		}
+
+		if ((sockets[started] = pp_socket_pool_connect_start (address, &pending, &att_error)) == NULL ||
+		    (pending == TRUE && p_socket_poller_add (poller,
+							     sockets[started],
+							     P_SOCKET_POLLER_CONDITION_OUT,
+							     P_SOCKET_POLLER_FLAG_NONE,
+							     &sockets[started],
+							     &att_error) == FALSE)) {
+			if (sockets[started] != NULL) {
+				p_socket_free (sockets[started]);
+				sockets[started] = NULL;
+			}
+
+			p_atomic_int_add (&host->idle_count, -1);
+			p_atomic_int_add (&host->open_count, -1);
+
+			/* The rest of the attempts would fail the same way */
+			++started;
+			break;
+		}
+
+		if (pending == FALSE) {
+			pp_socket_pool_push_idle (pool, host, sockets[started]);
+			sockets[started] = NULL;
+			++opened;
+			continue;
+		}
+
+		++active;
+	}
+
+	timeout = p_atomic_int_get (&pool->connect_timeout);
+
+	while (opened >= 0 && active > 0) {
+		elapsed   = p_time_profiler_elapsed_usecs (profiler) / 1000;
+		wait_time = -1;
+
+		if (timeout > 0) {
+			if (elapsed >= (puint64) timeout) {
+				if (att_error != NULL)
+					p_error_free (att_error);
+
+				att_error = p_error_new_literal ((pint) P_ERROR_IO_TIMED_OUT,
+								 0,
+								 "Timed out while connecting to the peer");
+				break;
+			}
+
+			wait_time = (pint) ((puint64) timeout - elapsed);
+		}
+
+		if (P_UNLIKELY ((n_events = p_socket_poller_wait (poller,
+								  events,
+								  P_SOCKET_POOL_EVENTS,
+								  wait_time,
+								  &att_error)) < 0))
+			break;
+
+		for (k = 0; k < n_events; ++k) {
+			i = (pint) ((PSocket **) events[k].user_data - sockets);
+
+			p_socket_poller_remove (poller, sockets[i], NULL);
+
+			if (att_error != NULL) {
+				p_error_free (att_error);
+				att_error = NULL;
+			}
+
+			if (p_socket_check_connect_result (sockets[i], &att_error) == TRUE) {
+				p_socket_set_blocking (sockets[i], TRUE);
+				pp_socket_pool_push_idle (pool, host, sockets[i]);
+				++opened;
+			} else {
+				p_socket_free (sockets[i]);
+				p_atomic_int_add (&host->idle_count, -1);
+				p_atomic_int_add (&host->open_count, -1);
+			}
+
+			sockets[i] = NULL;
+			--active;
+		}
+	}
+
+	/* Attempts left after a timeout or a failure */
+	for (i = 0; sockets != NULL && i < started; ++i) {
+		if (sockets[i] == NULL)
+			continue;
+
+		p_socket_poller_remove (poller, sockets[i], NULL);
+		p_socket_free (sockets[i]);
+
+		p_atomic_int_add (&host->idle_count, -1);
+		p_atomic_int_add (&host->open_count, -1);
+	}
+
+	if (opened == 0 && att_error != NULL) {
+		p_error_set_error_p (error,
+				     p_error_get_code (att_error),
+				     p_error_get_native_code (att_error),
+				     p_error_get_message (att_error));
+		opened = -1;
+	}
+
+	if (att_error != NULL)
+		p_error_free (att_error);
+
+	if (poller != NULL)
+		p_socket_poller_free (poller);
+
+	if (profiler != NULL)
+		p_time_profiler_free (profiler);
+
+	p_free (sockets);
+
+	return opened;
+}
+
+P_LIB_API pint
+p_socket_pool_get_idle_count (PSocketPool		*pool,
+			      const PSocketAddress	*address)
+{
+	PSocketPoolHost *host;
+
+	if (P_UNLIKELY (pool == NULL || address == NULL))
+		return -1;
+
+	if ((host = pp_socket_pool_get_host (pool, address, FALSE, NULL)) == NULL)
+		return 0;
+
+	return p_atomic_int_get (&host->idle_count);
+}
+
+P_LIB_API pint
+p_socket_pool_get_open_count (PSocketPool		*pool,
+			      const PSocketAddress	*address)
+{
+	PSocketPoolHost *host;
+
+	if (P_UNLIKELY (pool == NULL || address == NULL))
+		return -1;
+
+	if ((host = pp_socket_pool_get_host (pool, address, FALSE, NULL)) == NULL)
+		return 0;
+
+	return p_atomic_int_get (&host->open_count);
+}
+
+P_LIB_API void
+p_socket_pool_free (PSocketPool *pool)
+{
+	PLockFreeStackNode *node;
+	PLockFreeStackNode *next;
+
+	if (P_UNLIKELY (pool == NULL))
+		return;
+
+	if (pool->hosts != NULL)
+		p_concurrent_hash_table_free (pool->hosts);
+
+	if (pool->free_entries != NULL) {
+		for (node = p_lock_free_stack_pop_all (pool->free_entries); node != NULL; node = next) {
+			next = node->next;
+			p_free (P_CONTAINER_OF (node, PSocketPoolEntry, node));
+		}
+
+		p_lock_free_stack_free (pool->free_entries);
+	}
+
+	p_free (pool);
+}
@@ -0,0 +1,203 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file psocketpool.h
+ * @brief Pool of outbound TCP connections
+ * @author Alexander Saprykin
+ *
+ * A client talking to the same servers over and over again pays for a TCP
+ * handshake (and often for a name resolution before it) on every new
+ * connection. A socket pool keeps the connections which are not in use open,
+ * so the next request to the same peer can reuse one of them.
+ *
+ * The connections are grouped by the peer #PSocketAddress. Take a connection
+ * with p_socket_pool_acquire(), which returns an idle one or connects a new
+ * one, and give it back with p_socket_pool_release() once the exchange is
+ * over. Release the connection as not reusable if the exchange failed or left
+ * the protocol in an unknown state, the pool closes it then.
+ *
+ * Each peer has its idle connections on a lock-free stack and the peers are
+ * found in a read-mostly table, so acquiring and releasing an idle connection
+ * takes no lock. The number of idle connections kept per peer is limited, the
+ * excess ones are closed on release. The total number of connections per peer,
+ * including the ones in use, can be limited as well.
+ *
+ * An idle connection is checked before it is handed out: if the peer has
+ * closed it, sent unexpected data or it stayed idle longer than the idle
+ * timeout, the connection is closed and the next one is tried. The check costs
+ * a non-blocking receive call, much less than a new connection.
+ *
+ * p_socket_pool_preconnect() opens several connections to a peer in parallel
+ * ahead of time, i.e. on the program start, so the first requests don't wait
+ * for the handshakes.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PSOCKETPOOL_H
+#define PLIBSYS_HEADER_PSOCKETPOOL_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+#include "perror.h"
+#include "psocket.h"
+#include "psocketaddress.h"
+
+P_BEGIN_DECLS
+
+/** Default idle timeout of the pooled connections, in milliseconds. */
+#define P_SOCKET_POOL_DEFAULT_IDLE_TIMEOUT	30000
+
+/** Socket pool opaque data type. */
+typedef struct PSocketPool_ PSocketPool;
+
+/**
+ * @brief Creates a new socket pool.
+ * @param max_idle Maximum number of idle connections kept per peer, 0 to keep
+ * none.
+ * @param max_per_host Maximum number of connections per peer, including the
+ * ones in use, 0 for no limit.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Pointer to #PSocketPool in case of success, NULL otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API PSocketPool *	p_socket_pool_new			(pint			max_idle,
+								 pint			max_per_host,
+								 PError			**error);
+
+/**
+ * @brief Sets the idle timeout of the pooled connections.
+ * @param pool #PSocketPool to set the timeout for.
+ * @param timeout Timeout in milliseconds, 0 for no timeout.
+ * @since 0.0.5
+ *
+ * A connection idle for longer than @a timeout is closed instead of being
+ * handed out. The default is #P_SOCKET_POOL_DEFAULT_IDLE_TIMEOUT, keep it
+ * below the idle timeout of the servers.
+ */
+P_LIB_API void		p_socket_pool_set_idle_timeout		(PSocketPool		*pool,
+								 pint			timeout);
+
+/**
+ * @brief Sets the timeout for establishing new connections.
+ * @param pool #PSocketPool to set the timeout for.
+ * @param timeout Timeout in milliseconds, 0 to wait as long as the system
+ * does.
+ * @since 0.0.5
+ */
+P_LIB_API void		p_socket_pool_set_connect_timeout	(PSocketPool		*pool,
+								 pint			timeout);
+
+/**
+ * @brief Takes a connection to a peer from the pool.
+ * @param pool #PSocketPool to take the connection from.
+ * @param address Peer address.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Connected TCP #PSocket in the blocking mode in case of success, NULL
+ * otherwise.
+ * @since 0.0.5
+ *
+ * Returns a healthy idle connection if there is one, otherwise connects a new
+ * one. Fails with #P_ERROR_IO_NO_RESOURCES if the connection limit of the peer
+ * is reached. The socket must be given back with p_socket_pool_release() with
+ * the same @a address, it must not be freed directly.
+ */
+P_LIB_API PSocket *	p_socket_pool_acquire			(PSocketPool		*pool,
+								 PSocketAddress		*address,
+								 PError			**error);
+
+/**
+ * @brief Gives a connection back to the pool.
+ * @param pool #PSocketPool the connection was taken from.
+ * @param address Peer address the connection was taken for.
+ * @param socket Connection to give back.
+ * @param reusable Whether the connection can be handed out again, pass FALSE
+ * if an exchange failed or was interrupted.
+ * @since 0.0.5
+ *
+ * The connection is closed if it is not reusable or the pool already keeps
+ * enough idle connections to the peer. Restore the blocking mode and the
+ * timeout of the socket if you have changed them.
+ */
+P_LIB_API void		p_socket_pool_release			(PSocketPool		*pool,
+								 PSocketAddress		*address,
+								 PSocket		*socket,
+								 pboolean		reusable);
+
+/**
+ * @brief Opens idle connections to a peer ahead of time.
+ * @param pool #PSocketPool to open the connections in.
+ * @param address Peer address.
+ * @param count Number of connections to open.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Number of opened connections in case of success, -1 otherwise.
+ * @since 0.0.5
+ *
+ * The connections are established in parallel and waited for up to the
+ * connect timeout. Fewer connections are opened if the limits of the pool
+ * don't allow @a count more idle ones. The error is reported only if none of
+ * the attempts has succeeded.
+ */
+P_LIB_API pint		p_socket_pool_preconnect		(PSocketPool		*pool,
+								 PSocketAddress		*address,
+								 pint			count,
+								 PError			**error);
+
+/**
+ * @brief Gets the number of idle connections to a peer.
+ * @param pool #PSocketPool to get the number for.
+ * @param address Peer address.
+ * @return Number of idle connections in case of success, -1 otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pint		p_socket_pool_get_idle_count		(PSocketPool		*pool,
+								 const PSocketAddress	*address);
+
+/**
+ * @brief Gets the number of open connections to a peer, including the ones
+ * in use.
+ * @param pool #PSocketPool to get the number for.
+ * @param address Peer address.
+ * @return Number of open connections in case of success, -1 otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pint		p_socket_pool_get_open_count		(PSocketPool		*pool,
+								 const PSocketAddress	*address);
+
+/**
+ * @brief Frees a socket pool and closes its idle connections.
+ * @param pool #PSocketPool to free.
+ * @since 0.0.5
+ *
+ * All the connections must be released before.
+ */
+P_LIB_API void		p_socket_pool_free			(PSocketPool		*pool);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PSOCKETPOOL_H */
@@ -0,0 +1,378 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "pmem.h"
+#include "psocketstream.h"
+
+#include <string.h>
+
+#define P_SOCKET_STREAM_DEFAULT_BUFFER_SIZE	(16 * 1024)
+
+struct PSocketStream_ {
+	PSocket	*socket;
+	pchar	*buffer;
+	psize	capacity;
+	psize	chunk_size;
+	psize	start;
+	psize	end;
+};
+
+static pboolean pp_socket_stream_reserve (PSocketStream *stream, psize length, PError **error);
+static pssize pp_socket_stream_fill (PSocketStream *stream, psize length, PError **error);
+static pssize pp_socket_stream_find (const pchar *data, psize len, const pchar *delimiter, psize delimiter_len);
+static void pp_socket_stream_consume (PSocketStream *stream, psize length);
+
+/* Makes room to keep at least length bytes contiguous */
+static pboolean
+pp_socket_stream_reserve (PSocketStream	*stream,
+			  psize		length,
+			  PError	**error)
+{
+	pchar	*new_buffer;
+	psize	available;
+	psize	new_capacity;
+
+	available = stream->end - stream->start;
+
+	/* Move the data to the front rather than issue small reads */
+	if (stream->start > 0 &&
+	    (stream->capacity - stream->end < stream->chunk_size / 2 ||
+	     stream->capacity - stream->start < length)) {
+		memmove (stream->buffer, stream->buffer + stream->start, available);
+
+		stream->start = 0;
+		stream->end   = available;
+	}
+
+	if (P_LIKELY (stream->capacity >= length))
+		return TRUE;
+
+	new_capacity = stream->capacity;
+
+	while (new_capacity < length)
+		new_capacity = new_capacity > P_MAXSIZE / 2 ? length : new_capacity * 2;
+
+	if (P_UNLIKELY ((new_buffer = p_realloc (stream->buffer, new_capacity)) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for socket stream buffer");
+		return FALSE;
+	}
+
+	stream->buffer   = new_buffer;
+	stream->capacity = new_capacity;
+
+	return TRUE;
+}
+
+/* Receives data until at least length bytes are buffered */
+static pssize
+pp_socket_stream_fill (PSocketStream	*stream,
+		       psize		length,
+		       PError		**error)
+{
+	pssize ret;
+
+	while (stream->end - stream->start < length) {
+		if (P_UNLIKELY (pp_socket_stream_reserve (stream, length, error) == FALSE))
+			return -1;
+
+		ret = p_socket_receive (stream->socket,
+					stream->buffer + stream->end,
+					stream->capacity - stream->end,
+					error);
+
+		if (ret <= 0)
+			return ret;
+
+		stream->end += (psize) ret;
+	}
+
+	return (pssize) (stream->end - stream->start);
+}
+
+static pssize
+pp_socket_stream_find (const pchar	*data,
+		       psize		len,
+		       const pchar	*delimiter,
+		       psize		delimiter_len)
+{
+	const pchar	*pos;
+	psize		offset = 0;
+
+	while (len - offset >= delimiter_len) {
+		pos = memchr (data + offset, delimiter[0], len - offset - delimiter_len + 1);
+
+		if (pos == NULL)
+			break;
+
+		offset = (psize) (pos - data);
+
+		if (memcmp (pos + 1, delimiter + 1, delimiter_len - 1) == 0)
+			return (pssize) offset;
+
+		++offset;
+	}
+
+	return -1;
+}
+
+static void
+pp_socket_stream_consume (PSocketStream	*stream,
+			  psize		length)
+{
+	stream->start += length;
+
+	if (stream->start == stream->end) {
+		stream->start = 0;
+		stream->end   = 0;
+	}
+}
+
+P_LIB_API PSocketStream *
+p_socket_stream_new (PSocket	*socket,
+		     psize	buffer_size,
+		     PError	**error)
+{
+	PSocketStream *ret;
+
+	if (P_UNLIKELY (socket == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return NULL;
+	}
+
+	if (buffer_size == 0)
+		buffer_size = P_SOCKET_STREAM_DEFAULT_BUFFER_SIZE;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PSocketStream))) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for socket stream");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret->buffer = p_malloc (buffer_size)) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for socket stream buffer");
+		p_free (ret);
+		return NULL;
+	}
+
+	ret->socket     = socket;
+	ret->capacity   = buffer_size;
+	ret->chunk_size = buffer_size;
+
+	return ret;
+}
+
+P_LIB_API PSocket *
+p_socket_stream_get_socket (const PSocketStream *stream)
+{
+	if (P_UNLIKELY (stream == NULL))
+		return NULL;
+
+	return stream->socket;
+}
+
+P_LIB_API psize
+p_socket_stream_get_available (const PSocketStream *stream)
+{
+	if (P_UNLIKELY (stream == NULL))
+		return 0;
+
+	return stream->end - stream->start;
+}
+
+P_LIB_API pssize
+p_socket_stream_read (PSocketStream	*stream,
+		      pchar		*buffer,
+		      psize		buflen,
+		      PError		**error)
+{
+	pssize	ret;
+	psize	length;
+
+	if (P_UNLIKELY (stream == NULL || buffer == NULL || buflen == 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	if (stream->start == stream->end) {
+		/* Large reads don't need the intermediate copy */
+		if (buflen >= stream->chunk_size)
+			return p_socket_receive (stream->socket, buffer, buflen, error);
+
+		if ((ret = pp_socket_stream_fill (stream, 1, error)) <= 0)
+			return ret;
+	}
+
+	length = stream->end - stream->start;
+
+	if (length > buflen)
+		length = buflen;
+
+	memcpy (buffer, stream->buffer + stream->start, length);
+	pp_socket_stream_consume (stream, length);
+
+	return (pssize) length;
+}
+
+P_LIB_API pssize
+p_socket_stream_read_exact (PSocketStream	*stream,
+			    pchar		*buffer,
+			    psize		length,
+			    PError		**error)
+{
+	pssize ret;
+
+	if (P_UNLIKELY (stream == NULL || buffer == NULL || length == 0 || length > (psize) P_MAXSSIZE)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	if ((ret = pp_socket_stream_fill (stream, length, error)) <= 0)
+		return ret;
+
+	memcpy (buffer, stream->buffer + stream->start, length);
+	pp_socket_stream_consume (stream, length);
+
+	return (pssize) length;
+}
+
+P_LIB_API pssize
+p_socket_stream_read_until (PSocketStream	*stream,
+			    const pchar		*delimiter,
+			    psize		delimiter_len,
+			    pchar		*buffer,
+			    psize		buflen,
+			    PError		**error)
+{
+	pssize	ret;
+	pssize	pos;
+	psize	available;
+	psize	limit;
+	psize	searched = 0;
+
+	if (P_UNLIKELY (stream == NULL || delimiter == NULL || delimiter_len == 0 ||
+			buffer == NULL || buflen < delimiter_len || buflen > (psize) P_MAXSSIZE)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	for (;;) {
+		available = stream->end - stream->start;
+		limit     = available > buflen ? buflen : available;
+
+		/* Look only through the newly received data */
+		pos = pp_socket_stream_find (stream->buffer + stream->start + searched,
+					     limit - searched,
+					     delimiter,
+					     delimiter_len);
+
+		if (pos >= 0) {
+			limit = searched + (psize) pos + delimiter_len;
+
+			memcpy (buffer, stream->buffer + stream->start, limit);
+			pp_socket_stream_consume (stream, limit);
+
+			return (pssize) limit;
+		}
+
+		if (available >= buflen) {
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IO_NO_RESOURCES,
+					     0,
+					     "Delimiter is not found within the buffer length");
+			return -1;
+		}
+
+		searched = limit >= delimiter_len ? limit - delimiter_len + 1 : 0;
+
+		if ((ret = pp_socket_stream_fill (stream, available + 1, error)) <= 0)
+			return ret;
+	}
+}
+
+P_LIB_API pssize
+p_socket_stream_peek (PSocketStream	*stream,
+		      psize		length,
+		      const pchar	**data,
+		      PError		**error)
+{
+	pssize ret;
+
+	if (P_UNLIKELY (stream == NULL || data == NULL || length > (psize) P_MAXSSIZE)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	if (length > 0 && (ret = pp_socket_stream_fill (stream, length, error)) <= 0)
+		return ret;
+
+	*data = stream->buffer + stream->start;
+
+	return (pssize) (stream->end - stream->start);
+}
+
+P_LIB_API pboolean
+p_socket_stream_skip (PSocketStream	*stream,
+		      psize		length)
+{
+	if (P_UNLIKELY (stream == NULL || length > stream->end - stream->start))
+		return FALSE;
+
+	pp_socket_stream_consume (stream, length);
+
+	return TRUE;
+}
+
+P_LIB_API void
+p_socket_stream_free (PSocketStream *stream)
+{
+	if (P_UNLIKELY (stream == NULL))
+		return;
+
+	p_free (stream->buffer);
+	p_free (stream);
+}
@@ -0,0 +1,203 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file psocketstream.h
+ * @brief Buffered socket reader
+ * @author Alexander Saprykin
+ *
+ * Parsers of line based or length-prefixed protocols need data in pieces which
+ * rarely match the boundaries of the received chunks. Calling
+ * p_socket_receive() for every small piece costs a system call each time. A
+ * #PSocketStream keeps an internal buffer and reads the socket in large chunks,
+ * so a single system call usually serves many messages.
+ *
+ * p_socket_stream_read_exact() returns exactly the requested number of bytes
+ * (i.e. a fixed header or a length-prefixed body), and
+ * p_socket_stream_read_until() returns the data up to and including a
+ * delimiter (i.e. a line ending). p_socket_stream_peek() gives a direct pointer
+ * to the buffered data without copying it, and p_socket_stream_skip() consumes
+ * it afterwards. p_socket_stream_read() returns whatever is buffered, or
+ * makes a single receive call if the buffer is empty.
+ *
+ * The buffer grows when a single message doesn't fit into it, and the buffered
+ * data remains contiguous, so a peeked message is never split. With a
+ * non-blocking socket the calls fail with #P_ERROR_IO_WOULD_BLOCK until the
+ * whole message has arrived, and no data is consumed in that case: just repeat
+ * the call when the socket becomes readable. A call returns 0 when the peer has
+ * closed the connection before the whole message was received, the incomplete
+ * data stays in the buffer.
+ *
+ * The stream doesn't own the socket, free the stream before freeing the
+ * socket. Don't read the socket directly while the stream is in use, the
+ * buffered data would be lost. A stream is not thread-safe.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PSOCKETSTREAM_H
+#define PLIBSYS_HEADER_PSOCKETSTREAM_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+#include "psocket.h"
+#include "perror.h"
+
+P_BEGIN_DECLS
+
+/** Buffered socket reader opaque data type. */
+typedef struct PSocketStream_ PSocketStream;
+
+/**
+ * @brief Creates a new buffered reader for a socket.
+ * @param socket #PSocket to read data from.
+ * @param buffer_size Initial size of the internal buffer in bytes, it is also
+ * the size of a single receive call, 0 to use the default size (16 KiB).
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Pointer to #PSocketStream in case of success, NULL otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API PSocketStream *	p_socket_stream_new		(PSocket		*socket,
+								 psize			buffer_size,
+								 PError			**error);
+
+/**
+ * @brief Gets a socket of a buffered reader.
+ * @param stream #PSocketStream to get the socket for.
+ * @return #PSocket the @a stream reads from in case of success, NULL
+ * otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API PSocket *		p_socket_stream_get_socket	(const PSocketStream	*stream);
+
+/**
+ * @brief Gets a number of buffered bytes which can be read without I/O.
+ * @param stream #PSocketStream to get the number of bytes for.
+ * @return Number of buffered bytes.
+ * @since 0.0.5
+ */
+P_LIB_API psize			p_socket_stream_get_available	(const PSocketStream	*stream);
+
+/**
+ * @brief Reads available data from a buffered reader.
+ * @param stream #PSocketStream to read data from.
+ * @param buffer Buffer to store the data in.
+ * @param buflen Size of @a buffer.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Size in bytes of the read data, 0 if the connection has been closed,
+ * -1 otherwise.
+ * @since 0.0.5
+ *
+ * Returns the buffered data if there is any, otherwise makes a single receive
+ * call like p_socket_receive() does.
+ */
+P_LIB_API pssize		p_socket_stream_read		(PSocketStream		*stream,
+								 pchar			*buffer,
+								 psize			buflen,
+								 PError			**error);
+
+/**
+ * @brief Reads an exact number of bytes from a buffered reader.
+ * @param stream #PSocketStream to read data from.
+ * @param buffer Buffer to store the data in, at least @a length bytes.
+ * @param length Number of bytes to read.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return @a length in case of success, 0 if the connection has been closed
+ * before the data was received, -1 otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pssize		p_socket_stream_read_exact	(PSocketStream		*stream,
+								 pchar			*buffer,
+								 psize			length,
+								 PError			**error);
+
+/**
+ * @brief Reads data up to a delimiter from a buffered reader.
+ * @param stream #PSocketStream to read data from.
+ * @param delimiter Delimiter to look for.
+ * @param delimiter_len Length of @a delimiter in bytes.
+ * @param buffer Buffer to store the data in.
+ * @param buflen Size of @a buffer, the maximum length of the data.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Size in bytes of the read data including the delimiter in case of
+ * success, 0 if the connection has been closed before the delimiter was
+ * received, -1 otherwise.
+ * @since 0.0.5
+ *
+ * If the delimiter is not found within the first @a buflen bytes, the call
+ * fails with #P_ERROR_IO_NO_RESOURCES error code and no data is consumed.
+ */
+P_LIB_API pssize		p_socket_stream_read_until	(PSocketStream		*stream,
+								 const pchar		*delimiter,
+								 psize			delimiter_len,
+								 pchar			*buffer,
+								 psize			buflen,
+								 PError			**error);
+
+/**
+ * @brief Peeks into buffered data without copying it.
+ * @param stream #PSocketStream to peek data from.
+ * @param length Minimal number of bytes to peek, 0 to get the buffered data
+ * without any I/O.
+ * @param[out] data Pointer to the buffered data.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Number of bytes available at @a data (at least @a length) in case of
+ * success, 0 if the connection has been closed before the data was received,
+ * -1 otherwise.
+ * @since 0.0.5
+ * @sa p_socket_stream_skip()
+ *
+ * The data is not consumed, call p_socket_stream_skip() after processing it.
+ * The pointer remains valid until the next call on the @a stream.
+ */
+P_LIB_API pssize		p_socket_stream_peek		(PSocketStream		*stream,
+								 psize			length,
+								 const pchar		**data,
+								 PError			**error);
+
+/**
+ * @brief Consumes buffered data.
+ * @param stream #PSocketStream to consume data from.
+ * @param length Number of bytes to consume, must not exceed the number of
+ * buffered bytes.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ * @sa p_socket_stream_peek()
+ */
+P_LIB_API pboolean		p_socket_stream_skip		(PSocketStream		*stream,
+								 psize			length);
+
+/**
+ * @brief Frees a buffered reader, the socket is not freed.
+ * @param stream #PSocketStream to free.
+ * @since 0.0.5
+ */
+P_LIB_API void			p_socket_stream_free		(PSocketStream		*stream);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PSOCKETSTREAM_H */
@@ -0,0 +1,668 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "pmem.h"
+#include "psort.h"
+
+#include <string.h>
+
+#define P_SORT_INSERTION_THRESHOLD	16
+#define P_SORT_NINTHER_THRESHOLD	128
+#define P_SORT_PARALLEL_CUTOFF		4096
+
+typedef struct PSortContext_ {
+	psize			size;
+	PCompareDataFunc	func;
+	ppointer		data;
+	pboolean		word_swap;
+} PSortContext;
+
+typedef struct PSortTask_ {
+	const PSortContext	*ctx;
+	PTaskScheduler		*scheduler;
+	puint8			*base;
+	psize			count;
+	pint			depth;
+} PSortTask;
+
+static void pp_sort_context_init (PSortContext *ctx, pconstpointer base, psize size, PCompareDataFunc func, ppointer data);
+static pint pp_sort_depth_limit (psize count);
+static void pp_sort_swap (const PSortContext *ctx, puint8 *a, puint8 *b);
+static void pp_sort_insertion (const PSortContext *ctx, puint8 *base, psize count);
+static void pp_sort_sift_down (const PSortContext *ctx, puint8 *base, psize root, psize count);
+static void pp_sort_heap (const PSortContext *ctx, puint8 *base, psize count);
+static puint8 * pp_sort_median3 (const PSortContext *ctx, puint8 *a, puint8 *b, puint8 *c);
+static psize pp_sort_partition (const PSortContext *ctx, puint8 *base, psize count);
+static void pp_sort_intro (const PSortContext *ctx, puint8 *base, psize count, pint depth);
+static void pp_sort_merge (const PSortContext *ctx, puint8 *base, psize count, puint8 *buf);
+static puint64 pp_sort_radix_key (const puint8 *elem, PSortKeyType key_type);
+static void pp_sort_parallel_task (PSortTask *task);
+
+static void
+pp_sort_context_init (PSortContext		*ctx,
+		      pconstpointer		base,
+		      psize			size,
+		      PCompareDataFunc		func,
+		      ppointer			data)
+{
+	ctx->size      = size;
+	ctx->func      = func;
+	ctx->data      = data;
+	ctx->word_swap = (size % sizeof (psize)) == 0 &&
+			 (PPOINTER_TO_PSIZE (base) % sizeof (psize)) == 0;
+}
+
+static pint
+pp_sort_depth_limit (psize count)
+{
+	pint depth = 0;
+
+	while (count > 1) {
+		count >>= 1;
+		depth += 2;
+	}
+
+	return depth;
+}
+
+static void
+pp_sort_swap (const PSortContext	*ctx,
+	      puint8			*a,
+	      puint8			*b)
+{
+	psize	n;
+	psize	wtmp;
+	puint8	btmp;
+	psize	*wa;
+	psize	*wb;
+
+	if (ctx->word_swap) {
+		wa = (psize *) a;
+		wb = (psize *) b;
+
+		for (n = ctx->size / sizeof (psize); n > 0; --n) {
+			wtmp  = *wa;
+			*wa++ = *wb;
+			*wb++ = wtmp;
+		}
+	} else {
+		for (n = ctx->size; n > 0; --n) {
+			btmp = *a;
+			*a++ = *b;
+			*b++ = btmp;
+		}
+	}
+}
+
+/* Moves the elements by adjacent swaps only, so it is stable */
+static void
+pp_sort_insertion (const PSortContext	*ctx,
+		   puint8		*base,
+		   psize		count)
+{
+	psize	size = ctx->size;
+	puint8	*end = base + count * size;
+	puint8	*cur;
+	puint8	*pos;
+
+	for (cur = base + size; cur < end; cur += size)
+		for (pos = cur; pos > base && ctx->func (pos - size, pos, ctx->data) > 0; pos -= size)
+			pp_sort_swap (ctx, pos - size, pos);
+}
+
+static void
+pp_sort_sift_down (const PSortContext	*ctx,
+		   puint8		*base,
+		   psize		root,
+		   psize		count)
+{
+	psize	size = ctx->size;
+	psize	child;
+
+	for (;;) {
+		child = 2 * root + 1;
+
+		if (child >= count)
+			break;
+
+		if (child + 1 < count &&
+		    ctx->func (base + child * size, base + (child + 1) * size, ctx->data) < 0)
+			++child;
+
+		if (ctx->func (base + root * size, base + child * size, ctx->data) >= 0)
+			break;
+
+		pp_sort_swap (ctx, base + root * size, base + child * size);
+		root = child;
+	}
+}
+
+static void
+pp_sort_heap (const PSortContext	*ctx,
+	      puint8			*base,
+	      psize			count)
+{
+	psize i;
+
+	for (i = count / 2; i > 0; --i)
+		pp_sort_sift_down (ctx, base, i - 1, count);
+
+	for (i = count - 1; i > 0; --i) {
+		pp_sort_swap (ctx, base, base + i * ctx->size);
+		pp_sort_sift_down (ctx, base, 0, i);
+	}
+}
+
+static puint8 *
+pp_sort_median3 (const PSortContext	*ctx,
+		 puint8			*a,
+		 puint8			*b,
+		 puint8			*c)
+{
+	if (ctx->func (a, b, ctx->data) < 0) {
+		if (ctx->func (b, c, ctx->data) < 0)
+			return b;
+
+		return ctx->func (a, c, ctx->data) < 0 ? c : a;
+	} else {
+		if (ctx->func (a, c, ctx->data) < 0)
+			return a;
+
+		return ctx->func (b, c, ctx->data) < 0 ? c : b;
+	}
+}
+
+/* Hoare partition around a median pivot kept at the first position, the
+ * elements equal to the pivot stop both scans, so the runs of the equal
+ * elements are split evenly instead of degrading to quadratic time. Returns
+ * the final position of the pivot. */
+static psize
+pp_sort_partition (const PSortContext	*ctx,
+		   puint8		*base,
+		   psize		count)
+{
+	psize	size = ctx->size;
+	puint8	*mid = base + (count / 2) * size;
+	puint8	*last = base + (count - 1) * size;
+	puint8	*pivot;
+	psize	step;
+	psize	i;
+	psize	j;
+
+	if (count > P_SORT_NINTHER_THRESHOLD) {
+		step  = (count / 8) * size;
+		pivot = pp_sort_median3 (ctx,
+					 pp_sort_median3 (ctx, base, base + step, base + 2 * step),
+					 pp_sort_median3 (ctx, mid - step, mid, mid + step),
+					 pp_sort_median3 (ctx, last - 2 * step, last - step, last));
+	} else
+		pivot = pp_sort_median3 (ctx, base, mid, last);
+
+	if (pivot != base)
+		pp_sort_swap (ctx, base, pivot);
+
+	i = 1;
+	j = count - 1;
+
+	for (;;) {
+		while (i <= j && ctx->func (base + i * size, base, ctx->data) < 0)
+			++i;
+
+		while (i <= j && ctx->func (base + j * size, base, ctx->data) > 0)
+			--j;
+
+		if (i >= j)
+			break;
+
+		pp_sort_swap (ctx, base + i * size, base + j * size);
+		++i;
+		--j;
+	}
+
+	if (j > 0)
+		pp_sort_swap (ctx, base, base + j * size);
+
+	return j;
+}
+
+static void
+pp_sort_intro (const PSortContext	*ctx,
+	       puint8			*base,
+	       psize			count,
+	       pint			depth)
+{
+	psize pivot;
+
+	while (count > P_SORT_INSERTION_THRESHOLD) {
+		if (depth-- == 0) {
+			pp_sort_heap (ctx, base, count);
+			return;
+		}
+
+		pivot = pp_sort_partition (ctx, base, count);
+
+		/* Recurse into the smaller part to bound the stack depth */
+		if (pivot < count - pivot - 1) {
+			pp_sort_intro (ctx, base, pivot, depth);
+			base  += (pivot + 1) * ctx->size;
+			count -= pivot + 1;
+		} else {
+			pp_sort_intro (ctx, base + (pivot + 1) * ctx->size, count - pivot - 1, depth);
+			count = pivot;
+		}
+	}
+
+	pp_sort_insertion (ctx, base, count);
+}
+
+static void
+pp_sort_merge (const PSortContext	*ctx,
+	       puint8			*base,
+	       psize			count,
+	       puint8			*buf)
+{
+	psize	size = ctx->size;
+	psize	mid;
+	puint8	*left;
+	puint8	*left_end;
+	puint8	*right;
+	puint8	*end;
+	puint8	*out;
+
+	if (count <= P_SORT_INSERTION_THRESHOLD) {
+		pp_sort_insertion (ctx, base, count);
+		return;
+	}
+
+	mid = count / 2;
+
+	pp_sort_merge (ctx, base, mid, buf);
+	pp_sort_merge (ctx, base + mid * size, count - mid, buf);
+
+	/* Already ordered halves need no merging */
+	if (ctx->func (base + (mid - 1) * size, base + mid * size, ctx->data) <= 0)
+		return;
+
+	memcpy (buf, base, mid * size);
+
+	left     = buf;
+	left_end = buf + mid * size;
+	right    = base + mid * size;
+	end      = base + count * size;
+	out      = base;
+
+	/* Take from the right half only when strictly less to keep stability */
+	while (left < left_end && right < end) {
+		if (ctx->func (right, left, ctx->data) < 0) {
+			memcpy (out, right, size);
+			right += size;
+		} else {
+			memcpy (out, left, size);
+			left += size;
+		}
+
+		out += size;
+	}
+
+	/* The rest of the right half is in place already */
+	if (left < left_end)
+		memcpy (out, left, (psize) (left_end - left));
+}
+
+/* Maps a key to an unsigned integer with the same order */
+static puint64
+pp_sort_radix_key (const puint8		*elem,
+		   PSortKeyType		key_type)
+{
+	puint32	u32;
+	puint64	u64;
+
+	switch (key_type) {
+	case P_SORT_KEY_UINT32:
+		memcpy (&u32, elem, sizeof (u32));
+		return u32;
+	case P_SORT_KEY_INT32:
+		memcpy (&u32, elem, sizeof (u32));
+		return u32 ^ 0x80000000U;
+	case P_SORT_KEY_UINT64:
+		memcpy (&u64, elem, sizeof (u64));
+		return u64;
+	case P_SORT_KEY_INT64:
+		memcpy (&u64, elem, sizeof (u64));
+		return u64 ^ 0x8000000000000000ULL;
+	case P_SORT_KEY_FLOAT:
+		/* Negative values have all the bits flipped to reverse their order */
+		memcpy (&u32, elem, sizeof (u32));
+		return u32 ^ ((u32 & 0x80000000U) ? 0xFFFFFFFFU : 0x80000000U);
+	case P_SORT_KEY_DOUBLE:
+		memcpy (&u64, elem, sizeof (u64));
+		return u64 ^ ((u64 & 0x8000000000000000ULL) ? 0xFFFFFFFFFFFFFFFFULL : 0x8000000000000000ULL);
+	default:
+		return 0;
+	}
+}
+
+static void
+pp_sort_parallel_task (PSortTask *task)
+{
+	PTaskGroup	group;
+	PSortTask	left;
+	PSortTask	right;
+	psize		pivot;
+
+	if (task->count <= P_SORT_PARALLEL_CUTOFF || task->depth == 0) {
+		pp_sort_intro (task->ctx, task->base, task->count, pp_sort_depth_limit (task->count));
+		return;
+	}
+
+	pivot = pp_sort_partition (task->ctx, task->base, task->count);
+
+	left        = *task;
+	left.count  = pivot;
+	left.depth  = task->depth - 1;
+
+	right       = *task;
+	right.base  = task->base + (pivot + 1) * task->ctx->size;
+	right.count = task->count - pivot - 1;
+	right.depth = task->depth - 1;
+
+	p_task_group_init (&group, task->scheduler);
+	p_task_group_spawn (&group, (PTaskFunc) pp_sort_parallel_task, &left);
+
+	pp_sort_parallel_task (&right);
+
+	p_task_group_sync (&group);
+}
+
+P_LIB_API void
+p_sort (ppointer		base,
+	psize			count,
+	psize			size,
+	PCompareDataFunc	func,
+	ppointer		data)
+{
+	PSortContext ctx;
+
+	if (P_UNLIKELY (base == NULL || size == 0 || func == NULL || count < 2))
+		return;
+
+	pp_sort_context_init (&ctx, base, size, func, data);
+	pp_sort_intro (&ctx, (puint8 *) base, count, pp_sort_depth_limit (count));
+}
+
+P_LIB_API pboolean
+p_sort_stable (ppointer		base,
+	       psize		count,
+	       psize		size,
+	       PCompareDataFunc	func,
+	       ppointer		data)
+{
+	PSortContext	ctx;
+	puint8		*buf;
+
+	if (P_UNLIKELY (size == 0 || func == NULL || (base == NULL && count > 0)))
+		return FALSE;
+
+	if (count < 2)
+		return TRUE;
+
+	pp_sort_context_init (&ctx, base, size, func, data);
+
+	if (count <= P_SORT_INSERTION_THRESHOLD) {
+		pp_sort_insertion (&ctx, (puint8 *) base, count);
+		return TRUE;
+	}
+
+	if (P_UNLIKELY (count / 2 > ((psize) -1) / size))
+		return FALSE;
+
+	if (P_UNLIKELY ((buf = p_malloc ((count / 2) * size)) == NULL)) {
+		P_ERROR ("PSort::p_sort_stable: failed to allocate memory");
+		return FALSE;
+	}
+
+	pp_sort_merge (&ctx, (puint8 *) base, count, buf);
+
+	p_free (buf);
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_sort_radix (ppointer		base,
+	      psize		count,
+	      psize		size,
+	      psize		key_offset,
+	      PSortKeyType	key_type)
+{
+	psize	counts[8][256];
+	psize	digit_count;
+	psize	key_size;
+	psize	offset;
+	psize	pass;
+	psize	i;
+	puint64	key;
+	puint8	*buf;
+	puint8	*src;
+	puint8	*dst;
+	puint8	*tmp;
+
+	switch (key_type) {
+	case P_SORT_KEY_UINT32:
+	case P_SORT_KEY_INT32:
+	case P_SORT_KEY_FLOAT:
+		key_size = 4;
+		break;
+	case P_SORT_KEY_UINT64:
+	case P_SORT_KEY_INT64:
+	case P_SORT_KEY_DOUBLE:
+		key_size = 8;
+		break;
+	default:
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (size < key_size || key_offset > size - key_size || (base == NULL && count > 0)))
+		return FALSE;
+
+	if (count < 2)
+		return TRUE;
+
+	if (P_UNLIKELY (count > ((psize) -1) / size))
+		return FALSE;
+
+	if (P_UNLIKELY ((buf = p_malloc (count * size)) == NULL)) {
+		P_ERROR ("PSort::p_sort_radix: failed to allocate memory");
+		return FALSE;
+	}
+
+	/* Histograms of all the digits are built in a single pass */
+	memset (counts, 0, sizeof (counts));
+
+	src = (puint8 *) base;
+
+	for (i = 0; i < count; ++i) {
+		key = pp_sort_radix_key (src + i * size + key_offset, key_type);
+
+		for (pass = 0; pass < key_size; ++pass)
+			++counts[pass][(key >> (pass * 8)) & 0xFF];
+	}
+
+	dst = buf;
+
+	for (pass = 0; pass < key_size; ++pass) {
+		key = pp_sort_radix_key (src + key_offset, key_type);
+
+		/* All the elements have the same digit, the pass changes nothing */
+		if (counts[pass][(key >> (pass * 8)) & 0xFF] == count)
+			continue;
+
+		for (i = 0, offset = 0; i < 256; ++i) {
+			digit_count      = counts[pass][i];
+			counts[pass][i]  = offset;
+			offset          += digit_count;
+		}
+
+		for (i = 0; i < count; ++i) {
+			key = pp_sort_radix_key (src + i * size + key_offset, key_type);
+			memcpy (dst + counts[pass][(key >> (pass * 8)) & 0xFF]++ * size, src + i * size, size);
+		}
+
+		tmp = src;
+		src = dst;
+		dst = tmp;
+	}
+
+	if (src != (puint8 *) base)
+		memcpy (base, src, count * size);
+
+	p_free (buf);
+
+	return TRUE;
+}
+
+P_LIB_API void
+p_sort_parallel (PTaskScheduler		*scheduler,
+		 ppointer		base,
+		 psize			count,
+		 psize			size,
+		 PCompareDataFunc	func,
+		 ppointer		data)
+{
+	PSortContext	ctx;
+	PSortTask	task;
+
+	if (P_UNLIKELY (base == NULL || size == 0 || func == NULL || count < 2))
+		return;
+
+	pp_sort_context_init (&ctx, base, size, func, data);
+
+	if (scheduler == NULL || count <= P_SORT_PARALLEL_CUTOFF) {
+		pp_sort_intro (&ctx, (puint8 *) base, count, pp_sort_depth_limit (count));
+		return;
+	}
+
+	task.ctx       = &ctx;
+	task.scheduler = scheduler;
+	task.base      = (puint8 *) base;
+	task.count     = count;
+	task.depth     = pp_sort_depth_limit (count);
+
+	pp_sort_parallel_task (&task);
+}
+
+/* The bounds are searched without branching on the comparison result: the
+ * range is halved on every step and only its start moves, so the compiler can
+ * use a conditional move, and the loop runs the same number of iterations for
+ * any key. */
+P_LIB_API psize
+p_lower_bound (pconstpointer		base,
+	       psize			count,
+	       psize			size,
+	       pconstpointer		key,
+	       PCompareDataFunc		func,
+	       ppointer			data)
+{
+	const puint8	*first = (const puint8 *) base;
+	psize		half;
+
+	if (P_UNLIKELY (base == NULL || size == 0 || func == NULL || count == 0))
+		return count;
+
+	while (count > 1) {
+		half    = count / 2;
+		first  += func (first + half * size, key, data) < 0 ? half * size : 0;
+		count  -= half;
+	}
+
+	first += func (first, key, data) < 0 ? size : 0;
+
+	return (psize) (first - (const puint8 *) base) / size;
+}
+
+P_LIB_API psize
+p_upper_bound (pconstpointer		base,
+	       psize			count,
+	       psize			size,
+	       pconstpointer		key,
+	       PCompareDataFunc		func,
+	       ppointer			data)
+{
+	const puint8	*first = (const puint8 *) base;
+	psize		half;
+
+	if (P_UNLIKELY (base == NULL || size == 0 || func == NULL || count == 0))
+		return count;
+
+	while (count > 1) {
+		half    = count / 2;
+		first  += func (first + half * size, key, data) <= 0 ? half * size : 0;
+		count  -= half;
+	}
+
+	first += func (first, key, data) <= 0 ? size : 0;
+
+	return (psize) (first - (const puint8 *) base) / size;
+}
+
+P_LIB_API psize
+p_lower_bound_uint32 (const puint32	*array,
+		      psize		count,
+		      puint32		key)
+{
+	const puint32	*first = array;
+	psize		half;
+
+	if (P_UNLIKELY (array == NULL || count == 0))
+		return count;
+
+	while (count > 1) {
+		half    = count / 2;
+		first   = first[half] < key ? first + half : first;
+		count  -= half;
+	}
+
+	return (psize) (first - array) + (*first < key);
+}
+
+P_LIB_API psize
+p_lower_bound_uint64 (const puint64	*array,
+		      psize		count,
+		      puint64		key)
+{
+	const puint64	*first = array;
+	psize		half;
+
+	if (P_UNLIKELY (array == NULL || count == 0))
+		return count;
+
+	while (count > 1) {
+		half    = count / 2;
+		first   = first[half] < key ? first + half : first;
+		count  -= half;
+	}
+
+	return (psize) (first - array) + (*first < key);
+}
@@ -0,0 +1,234 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file psort.h
+ * @brief Sorting and searching in arrays
+ * @author Alexander Saprykin
+ *
+ * The routines work with contiguous arrays of elements of any size, the same
+ * way as qsort() and bsearch() from the C library do: the comparison function
+ * receives the pointers to two elements (or to the key and an element for the
+ * searching routines) and returns a negative value if the first one is less
+ * than the second one, a positive value if it is greater, and zero if they are
+ * equal.
+ *
+ * Several sorting algorithms are provided:
+ * - p_sort() is an introspective sort: a quicksort with a median of three (or
+ * a pseudo-median of nine for the large arrays) pivot, which switches to a
+ * heapsort if the recursion gets too deep and to an insertion sort for the
+ * small ranges. It takes O(NlogN) time in the worst case, doesn't allocate
+ * memory, and is not stable.
+ * - p_sort_stable() is a merge sort, it keeps the order of the equal elements
+ * and takes advantage of the already sorted runs, but needs a buffer for a
+ * half of the array.
+ * - p_sort_radix() is a least significant digit radix sort for the elements
+ * with an integer or a floating point key inside. It doesn't call a comparison
+ * function at all and takes O(N) time, so it is the fastest choice for the
+ * large arrays of numbers. The sort is stable, and needs a buffer for a copy
+ * of the array.
+ * - p_sort_parallel() runs the introspective sort on a #PTaskScheduler: the
+ * partitions are sorted by different workers.
+ *
+ * p_lower_bound() and p_upper_bound() find the range of the elements equal to
+ * a key in a sorted array using a binary search without the branches on the
+ * comparison result, which avoids the mispredictions on the random lookups.
+ * The typed variants for the integer arrays don't need a comparison function
+ * at all.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PSORT_H
+#define PLIBSYS_HEADER_PSORT_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+#include "ptaskscheduler.h"
+
+P_BEGIN_DECLS
+
+/** Types of the keys for the radix sort. */
+typedef enum PSortKeyType_ {
+	P_SORT_KEY_UINT32	= 0,	/**< #puint32 key.			*/
+	P_SORT_KEY_INT32	= 1,	/**< #pint32 key.			*/
+	P_SORT_KEY_UINT64	= 2,	/**< #puint64 key.			*/
+	P_SORT_KEY_INT64	= 3,	/**< #pint64 key.			*/
+	P_SORT_KEY_FLOAT	= 4,	/**< #pfloat key.			*/
+	P_SORT_KEY_DOUBLE	= 5	/**< #pdouble key.			*/
+} PSortKeyType;
+
+/**
+ * @brief Sorts an array in place.
+ * @param base Pointer to the first element.
+ * @param count Number of the elements.
+ * @param size Size of an element, in bytes.
+ * @param func Function to compare two elements.
+ * @param data Data to pass into @a func, may be NULL.
+ * @since 0.0.5
+ *
+ * The sort is not stable and takes O(NlogN) time in the worst case.
+ */
+P_LIB_API void		p_sort			(ppointer		base,
+						 psize			count,
+						 psize			size,
+						 PCompareDataFunc	func,
+						 ppointer		data);
+
+/**
+ * @brief Sorts an array in place keeping the order of the equal elements.
+ * @param base Pointer to the first element.
+ * @param count Number of the elements.
+ * @param size Size of an element, in bytes.
+ * @param func Function to compare two elements.
+ * @param data Data to pass into @a func, may be NULL.
+ * @return TRUE in case of success, FALSE if there is no memory for the merge
+ * buffer (the array is left untouched then).
+ * @since 0.0.5
+ *
+ * The sort takes O(NlogN) time, and O(N) time for an already sorted array.
+ */
+P_LIB_API pboolean	p_sort_stable		(ppointer		base,
+						 psize			count,
+						 psize			size,
+						 PCompareDataFunc	func,
+						 ppointer		data);
+
+/**
+ * @brief Sorts an array by a numeric key in place using a radix sort.
+ * @param base Pointer to the first element.
+ * @param count Number of the elements.
+ * @param size Size of an element, in bytes.
+ * @param key_offset Offset of the key inside an element, in bytes.
+ * @param key_type Type of the key.
+ * @return TRUE in case of success, FALSE in case of invalid input or if there
+ * is no memory for the buffer (the array is left untouched then).
+ * @since 0.0.5
+ *
+ * The elements are sorted in the ascending order of the keys, the sort is
+ * stable. The key may be unaligned. Negative zero goes before the positive
+ * one, the NaN values go to the ends of the array according to their sign
+ * bits.
+ */
+P_LIB_API pboolean	p_sort_radix		(ppointer		base,
+						 psize			count,
+						 psize			size,
+						 psize			key_offset,
+						 PSortKeyType		key_type);
+
+/**
+ * @brief Sorts an array in place using several threads.
+ * @param scheduler Task scheduler to run the sorting in, NULL to sort in the
+ * calling thread.
+ * @param base Pointer to the first element.
+ * @param count Number of the elements.
+ * @param size Size of an element, in bytes.
+ * @param func Function to compare two elements, must be thread-safe.
+ * @param data Data to pass into @a func, may be NULL.
+ * @since 0.0.5
+ *
+ * Gives the same result as p_sort(). The calling thread takes part in the
+ * sorting and returns when the array is sorted.
+ */
+P_LIB_API void		p_sort_parallel		(PTaskScheduler		*scheduler,
+						 ppointer		base,
+						 psize			count,
+						 psize			size,
+						 PCompareDataFunc	func,
+						 ppointer		data);
+
+/**
+ * @brief Finds the first element which is not less than a key.
+ * @param base Pointer to the first element of a sorted array.
+ * @param count Number of the elements.
+ * @param size Size of an element, in bytes.
+ * @param key Key to search for.
+ * @param func Function to compare an element (first argument) with the key
+ * (second argument).
+ * @param data Data to pass into @a func, may be NULL.
+ * @return Index of the found element, @a count if all the elements are less
+ * than the key.
+ * @since 0.0.5
+ */
+P_LIB_API psize		p_lower_bound		(pconstpointer		base,
+						 psize			count,
+						 psize			size,
+						 pconstpointer		key,
+						 PCompareDataFunc	func,
+						 ppointer		data);
+
+/**
+ * @brief Finds the first element which is greater than a key.
+ * @param base Pointer to the first element of a sorted array.
+ * @param count Number of the elements.
+ * @param size Size of an element, in bytes.
+ * @param key Key to search for.
+ * @param func Function to compare an element (first argument) with the key
+ * (second argument).
+ * @param data Data to pass into @a func, may be NULL.
+ * @return Index of the found element, @a count if no element is greater than
+ * the key.
+ * @since 0.0.5
+ */
+P_LIB_API psize		p_upper_bound		(pconstpointer		base,
+						 psize			count,
+						 psize			size,
+						 pconstpointer		key,
+						 PCompareDataFunc	func,
+						 ppointer		data);
+
+/**
+ * @brief Finds the first element which is not less than a key in a sorted
+ * array of #puint32.
+ * @param array Sorted array.
+ * @param count Number of the elements.
+ * @param key Key to search for.
+ * @return Index of the found element, @a count if all the elements are less
+ * than the key.
+ * @since 0.0.5
+ */
+P_LIB_API psize		p_lower_bound_uint32	(const puint32		*array,
+						 psize			count,
+						 puint32		key);
+
+/**
+ * @brief Finds the first element which is not less than a key in a sorted
+ * array of #puint64.
+ * @param array Sorted array.
+ * @param count Number of the elements.
+ * @param key Key to search for.
+ * @return Index of the found element, @a count if all the elements are less
+ * than the key.
+ * @since 0.0.5
+ */
+P_LIB_API psize		p_lower_bound_uint64	(const puint64		*array,
+						 psize			count,
+						 puint64		key);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PSORT_H */
@@ -23,6 +23,7 @@
  * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include "pcpurelax-private.h"
 #include "pmem.h"
 #include "pspinlock.h"
 
@@ -32,6 +33,7 @@
 #  define PSPINLOCK_INT_CAST(x) x
 #endif
 
+/* The lock word must stay the first member, see pspinlock-inline.h */
 struct PSpinLock_ {
 	volatile pint spin;
 };
@@ -41,7 +43,7 @@ p_spinlock_new (void)
 {
 	PSpinLock *ret;
 
-	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PSpinLock))) == NULL)) {
+	if (P_UNLIKELY ((ret = p_malloc0_aligned (sizeof (PSpinLock), P_MEM_CACHE_LINE_SIZE)) == NULL)) {
 		P_ERROR ("PSpinLock::p_spinlock_new: failed to allocate memory");
 		return NULL;
 	}
@@ -53,18 +55,26 @@ P_LIB_API pboolean
 p_spinlock_lock (PSpinLock *spinlock)
 {
 	pint tmp_int;
+	pint backoff = 1;
 
 	if (P_UNLIKELY (spinlock == NULL))
 		return FALSE;
 
-	do {
+	for (;;) {
 		tmp_int = 0;
-	} while ((pboolean) __atomic_compare_exchange_n (PSPINLOCK_INT_CAST (&(spinlock->spin)),
-							 &tmp_int,
-							 1,
-							 0,
-							 __ATOMIC_ACQUIRE,
-							 __ATOMIC_RELAXED) == FALSE);
+
+		if ((pboolean) __atomic_compare_exchange_n (PSPINLOCK_INT_CAST (&(spinlock->spin)),
+							    &tmp_int,
+							    1,
+							    0,
+							    __ATOMIC_ACQUIRE,
+							    __ATOMIC_RELAXED) == TRUE)
+			break;
+
+		/* Wait on a shared copy of the cache line until the lock looks free */
+		while (__atomic_load_4 (PSPINLOCK_INT_CAST (&(spinlock->spin)), __ATOMIC_RELAXED) != 0)
+			P_CPU_BACKOFF (backoff);
+	}
 
 	return TRUE;
 }
@@ -99,5 +109,5 @@ p_spinlock_unlock (PSpinLock *spinlock)
 P_LIB_API void
 p_spinlock_free (PSpinLock *spinlock)
 {
-	p_free (spinlock);
+	p_free_aligned (spinlock);
 }
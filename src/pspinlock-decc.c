@@ -41,7 +41,7 @@ p_spinlock_new (void)
 {
 	PSpinLock *ret;
 
-	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PSpinLock))) == NULL)) {
+	if (P_UNLIKELY ((ret = p_malloc0_aligned (sizeof (PSpinLock), P_MEM_CACHE_LINE_SIZE)) == NULL)) {
 		P_ERROR ("PSpinLock::p_spinlock_new: failed to allocate memory");
 		return NULL;
 	}
@@ -83,5 +83,5 @@ p_spinlock_unlock (PSpinLock *spinlock)
 P_LIB_API void
 p_spinlock_free (PSpinLock *spinlock)
 {
-	p_free (spinlock);
+	p_free_aligned (spinlock);
 }
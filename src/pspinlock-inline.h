@@ -0,0 +1,110 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pspinlock-inline.h
+ * @brief Inline spinlock fast paths
+ * @author Alexander Saprykin
+ *
+ * When P_ATOMIC_INLINE is defined before including plibsys.h and the inline
+ * atomic operations are in use (see patomic-inline.h), p_spinlock_trylock()
+ * and p_spinlock_unlock() are inlined, and p_spinlock_lock() tries to take a
+ * free lock inline and calls the library only to wait for a busy one.
+ *
+ * The header is included by pspinlock.h automatically, don't include it
+ * directly.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PSPINLOCK_INLINE_H
+#define PLIBSYS_HEADER_PSPINLOCK_INLINE_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+#include "patomic.h"
+#include "patomic-inline.h"
+
+#ifdef P_ATOMIC_INLINE_ENABLED
+
+/* All the lock-free spinlock models keep the lock word as the first member */
+#define P_SPINLOCK_INLINE_WORD(spinlock) ((volatile pint *) (spinlock))
+
+P_ATOMIC_INLINE_FUNC pboolean
+p_spinlock_inline_trylock (PSpinLock *spinlock)
+{
+	if (P_UNLIKELY (spinlock == NULL))
+		return FALSE;
+
+#  ifdef P_ATOMIC_INLINE_C11
+	{
+		pint tmp_int = 0;
+
+		return (pboolean) __atomic_compare_exchange_n (P_SPINLOCK_INLINE_WORD (spinlock),
+							       &tmp_int,
+							       1,
+							       0,
+							       __ATOMIC_ACQUIRE,
+							       __ATOMIC_RELAXED);
+	}
+#  else
+	return p_atomic_inline_int_compare_and_exchange (P_SPINLOCK_INLINE_WORD (spinlock), 0, 1);
+#  endif
+}
+
+P_ATOMIC_INLINE_FUNC pboolean
+p_spinlock_inline_lock (PSpinLock *spinlock)
+{
+	if (P_LIKELY (p_spinlock_inline_trylock (spinlock) == TRUE))
+		return TRUE;
+
+	/* Contended or invalid: let the library spin with a backoff */
+	return (p_spinlock_lock) (spinlock);
+}
+
+P_ATOMIC_INLINE_FUNC pboolean
+p_spinlock_inline_unlock (PSpinLock *spinlock)
+{
+	if (P_UNLIKELY (spinlock == NULL))
+		return FALSE;
+
+#  ifdef P_ATOMIC_INLINE_C11
+	__atomic_store_n (P_SPINLOCK_INLINE_WORD (spinlock), 0, __ATOMIC_RELEASE);
+#  else
+	p_atomic_inline_int_set (P_SPINLOCK_INLINE_WORD (spinlock), 0);
+#  endif
+
+	return TRUE;
+}
+
+#  define p_spinlock_lock(spinlock)	p_spinlock_inline_lock (spinlock)
+#  define p_spinlock_trylock(spinlock)	p_spinlock_inline_trylock (spinlock)
+#  define p_spinlock_unlock(spinlock)	p_spinlock_inline_unlock (spinlock)
+
+#endif /* P_ATOMIC_INLINE_ENABLED */
+
+#endif /* PLIBSYS_HEADER_PSPINLOCK_INLINE_H */
@@ -36,14 +36,14 @@ p_spinlock_new (void)
 {
 	PSpinLock *ret;
 
-	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PSpinLock))) == NULL)) {
+	if (P_UNLIKELY ((ret = p_malloc0_aligned (sizeof (PSpinLock), P_MEM_CACHE_LINE_SIZE)) == NULL)) {
 		P_ERROR ("PSpinLock::p_spinlock_new: failed to allocate memory");
 		return NULL;
 	}
 
 	if (P_UNLIKELY ((ret->mutex = p_mutex_new ()) == NULL)) {
 		P_ERROR ("PSpinLock::p_spinlock_new: p_mutex_new() failed");
-		p_free (ret);
+		p_free_aligned (ret);
 		return NULL;
 	}
 
@@ -84,5 +84,5 @@ p_spinlock_free (PSpinLock *spinlock)
 		return;
 
 	p_mutex_free (spinlock->mutex);
-	p_free (spinlock);
+	p_free_aligned (spinlock);
 }
@@ -23,9 +23,11 @@
  * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include "pcpurelax-private.h"
 #include "pmem.h"
 #include "pspinlock.h"
 
+/* The lock word must stay the first member, see pspinlock-inline.h */
 struct PSpinLock_ {
 	volatile pint spin;
 };
@@ -35,7 +37,7 @@ p_spinlock_new (void)
 {
 	PSpinLock *ret;
 
-	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PSpinLock))) == NULL)) {
+	if (P_UNLIKELY ((ret = p_malloc0_aligned (sizeof (PSpinLock), P_MEM_CACHE_LINE_SIZE)) == NULL)) {
 		P_ERROR ("PSpinLock::p_spinlock_new: failed to allocate memory");
 		return NULL;
 	}
@@ -46,11 +48,16 @@ p_spinlock_new (void)
 P_LIB_API pboolean
 p_spinlock_lock (PSpinLock *spinlock)
 {
+	pint backoff = 1;
+
 	if (P_UNLIKELY (spinlock == NULL))
 		return FALSE;
 
-	while ((pboolean) __sync_bool_compare_and_swap (&(spinlock->spin), 0, 1) == FALSE)
-		;
+	while ((pboolean) __sync_bool_compare_and_swap (&(spinlock->spin), 0, 1) == FALSE) {
+		/* Wait on a shared copy of the cache line until the lock looks free */
+		while (spinlock->spin != 0)
+			P_CPU_BACKOFF (backoff);
+	}
 
 	return TRUE;
 }
@@ -79,5 +86,5 @@ p_spinlock_unlock (PSpinLock *spinlock)
 P_LIB_API void
 p_spinlock_free (PSpinLock *spinlock)
 {
-	p_free (spinlock);
+	p_free_aligned (spinlock);
 }
@@ -23,10 +23,12 @@
  * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include "pcpurelax-private.h"
 #include "pmem.h"
 #include "patomic.h"
 #include "pspinlock.h"
 
+/* The lock word must stay the first member, see pspinlock-inline.h */
 struct PSpinLock_ {
 	volatile pint spin;
 };
@@ -36,7 +38,7 @@ p_spinlock_new (void)
 {
 	PSpinLock *ret;
 
-	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PSpinLock))) == NULL)) {
+	if (P_UNLIKELY ((ret = p_malloc0_aligned (sizeof (PSpinLock), P_MEM_CACHE_LINE_SIZE)) == NULL)) {
 		P_ERROR ("PSpinLock::p_spinlock_new: failed to allocate memory");
 		return NULL;
 	}
@@ -47,11 +49,16 @@ p_spinlock_new (void)
 P_LIB_API pboolean
 p_spinlock_lock (PSpinLock *spinlock)
 {
+	pint backoff = 1;
+
 	if (P_UNLIKELY (spinlock == NULL))
 		return FALSE;
 
-	while (p_atomic_int_compare_and_exchange (&(spinlock->spin), 0, 1) == FALSE)
-		;
+	while (p_atomic_int_compare_and_exchange (&(spinlock->spin), 0, 1) == FALSE) {
+		/* Wait on a shared copy of the cache line until the lock looks free */
+		while (p_atomic_int_get (&(spinlock->spin)) != 0)
+			P_CPU_BACKOFF (backoff);
+	}
 
 	return TRUE;
 }
@@ -79,5 +86,5 @@ p_spinlock_unlock (PSpinLock *spinlock)
 P_LIB_API void
 p_spinlock_free (PSpinLock *spinlock)
 {
-	p_free (spinlock);
+	p_free_aligned (spinlock);
 }
@@ -50,6 +50,9 @@
  * this call, others will wait for the p_spinlock_unlock() call which marks the
  * end of the critical section. This way the critical section code is guarded
  * against concurrent access of multiple threads at once.
+ *
+ * Define P_ATOMIC_INLINE before including plibsys.h to inline the uncontended
+ * paths of the locking calls, see pspinlock-inline.h.
  */
 
 #if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
@@ -81,7 +84,9 @@ P_LIB_API PSpinLock *	p_spinlock_new		(void);
  * @since 0.0.1
  *
  * A thread will not sleep in this call if another thread is holding the lock,
- * instead it will try to lock @a spinlock in an infinite loop.
+ * instead it will try to lock @a spinlock in an infinite loop. Between the
+ * attempts it waits with an exponential backoff using the CPU pause
+ * instruction, and gives the CPU away to other threads if the lock stays busy.
  *
  * If the atomic model is not lock-free this call will have the same effect
  * as p_mutex_lock().
@@ -139,4 +144,8 @@ P_LIB_API void		p_spinlock_free		(PSpinLock *spinlock);
 
 P_END_DECLS
 
+#if defined (P_ATOMIC_INLINE) && !defined (PLIBSYS_COMPILATION)
+#  include "pspinlock-inline.h"
+#endif
+
 #endif /* PLIBSYS_HEADER_PSPINLOCK_H */
@@ -0,0 +1,534 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2010-2019 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* String-keyed hash table uses the same open addressing scheme as PHashTable:
+ * linear probing, deleted slot markers and the same load factor. The slot
+ * keeps the full 64-bit hash and the length of its key, so the key bytes are
+ * compared only on a (nearly certain) match. Keys are copied into memory
+ * chunks owned by the table. Removed keys leave holes in the chunks, which are
+ * reclaimed by copying the live keys into a new chunk when the table is
+ * rebuilt and the holes take more than a half of the stored bytes. */
+
+#include "pmem.h"
+#include "pstrhashtable.h"
+#include "pfasthash.h"
+
+#include <string.h>
+
+typedef struct PStrHashTableEntry_ {
+	puint64		hash;
+	const pchar	*key;
+	psize		len;
+	ppointer	value;
+} PStrHashTableEntry;
+
+typedef struct PStrHashTableChunk_ {
+	struct PStrHashTableChunk_	*next;
+	psize				used;
+	psize				size;
+} PStrHashTableChunk;
+
+struct PStrHashTable_ {
+	PStrHashTableEntry	*entries;
+	psize			size;
+	psize			used;
+	psize			deleted;
+	PStrHashTableChunk	*chunks;
+	psize			keys_bytes;
+	psize			wasted_bytes;
+	PDestroyFunc		value_destroy_func;
+};
+
+/* Initial number of slots in hash table, must be a power of two */
+#define P_STR_HASH_TABLE_MIN_SIZE	8
+
+/* Slot markers in the hash field, real hashes are always above them */
+#define P_STR_HASH_TABLE_EMPTY_SLOT	0
+#define P_STR_HASH_TABLE_DELETED_SLOT	1
+#define P_STR_HASH_TABLE_MIN_HASH	2
+
+/* Maximum load factor (used + deleted slots) before the table is rebuilt */
+#define P_STR_HASH_TABLE_LOAD_NUM	3
+#define P_STR_HASH_TABLE_LOAD_DEN	4
+
+/* Size of a memory chunk for the keys */
+#define P_STR_HASH_TABLE_CHUNK_SIZE	4096
+
+static puint64 pp_str_hash_table_calc_hash (const pchar *key, psize len);
+static psize pp_str_hash_table_find_slot (const PStrHashTable *table, const pchar *key, psize len, puint64 hash);
+static pchar * pp_str_hash_table_store_key (PStrHashTable *table, const pchar *key, psize len);
+static void pp_str_hash_table_compact_keys (PStrHashTable *table);
+static pboolean pp_str_hash_table_resize (PStrHashTable *table, psize size);
+static pboolean pp_str_hash_table_reserve_slot (PStrHashTable *table);
+static void pp_str_hash_table_remove_slot (PStrHashTable *table, psize slot);
+
+static puint64
+pp_str_hash_table_calc_hash (const pchar *key, psize len)
+{
+	puint64 hash;
+
+	hash = p_fast_hash_xxh3_64 (key, len, 0);
+
+	return hash < P_STR_HASH_TABLE_MIN_HASH ? hash + P_STR_HASH_TABLE_MIN_HASH : hash;
+}
+
+static psize
+pp_str_hash_table_find_slot (const PStrHashTable *table, const pchar *key, psize len, puint64 hash)
+{
+	const PStrHashTableEntry	*entry;
+	psize				mask;
+	psize				i;
+
+	mask = table->size - 1;
+
+	for (i = (psize) hash & mask; table->entries[i].hash != P_STR_HASH_TABLE_EMPTY_SLOT; i = (i + 1) & mask) {
+		entry = &table->entries[i];
+
+		if (entry->hash == hash && entry->len == len && memcmp (entry->key, key, len) == 0)
+			return i;
+	}
+
+	return table->size;
+}
+
+/* Long keys get a chunk of their own, so they don't waste the rest of the
+ * current one */
+static pchar *
+pp_str_hash_table_store_key (PStrHashTable *table, const pchar *key, psize len)
+{
+	PStrHashTableChunk	*chunk;
+	pchar			*ret;
+	psize			size;
+
+	chunk = table->chunks;
+
+	if (chunk == NULL || chunk->size - chunk->used < len + 1) {
+		size = len + 1 > P_STR_HASH_TABLE_CHUNK_SIZE / 4 ? len + 1 : P_STR_HASH_TABLE_CHUNK_SIZE;
+
+		if (P_UNLIKELY ((chunk = p_malloc (sizeof (PStrHashTableChunk) + size)) == NULL))
+			return NULL;
+
+		chunk->used = 0;
+		chunk->size = size;
+
+		if (size == P_STR_HASH_TABLE_CHUNK_SIZE || table->chunks == NULL) {
+			chunk->next   = table->chunks;
+			table->chunks = chunk;
+		} else {
+			chunk->next         = table->chunks->next;
+			table->chunks->next = chunk;
+		}
+	}
+
+	ret = (pchar *) (chunk + 1) + chunk->used;
+
+	memcpy (ret, key, len);
+	ret[len] = '\0';
+
+	chunk->used       += len + 1;
+	table->keys_bytes += len + 1;
+
+	return ret;
+}
+
+/* Copies all the live keys into a single new chunk, the old chunks are kept
+ * if there is no memory for it */
+static void
+pp_str_hash_table_compact_keys (PStrHashTable *table)
+{
+	PStrHashTableChunk	*chunk;
+	PStrHashTableChunk	*next;
+	pchar			*dst;
+	psize			live;
+	psize			i;
+
+	live = table->keys_bytes - table->wasted_bytes;
+
+	if (P_UNLIKELY ((chunk = p_malloc (sizeof (PStrHashTableChunk) + (live > 0 ? live : 1))) == NULL))
+		return;
+
+	chunk->next = NULL;
+	chunk->size = live > 0 ? live : 1;
+	chunk->used = 0;
+
+	dst = (pchar *) (chunk + 1);
+
+	for (i = 0; i < table->size; ++i) {
+		if (table->entries[i].hash < P_STR_HASH_TABLE_MIN_HASH)
+			continue;
+
+		memcpy (dst + chunk->used, table->entries[i].key, table->entries[i].len + 1);
+		table->entries[i].key = dst + chunk->used;
+		chunk->used += table->entries[i].len + 1;
+	}
+
+	for (; table->chunks != NULL; table->chunks = next) {
+		next = table->chunks->next;
+		p_free (table->chunks);
+	}
+
+	table->chunks       = chunk;
+	table->keys_bytes   = live;
+	table->wasted_bytes = 0;
+}
+
+static pboolean
+pp_str_hash_table_resize (PStrHashTable *table, psize size)
+{
+	PStrHashTableEntry	*old_entries;
+	psize			old_size;
+	psize			mask;
+	psize			i;
+	psize			j;
+
+	if (P_UNLIKELY (size > ((psize) -1) / sizeof (PStrHashTableEntry)))
+		return FALSE;
+
+	old_entries = table->entries;
+	old_size    = table->size;
+
+	if (P_UNLIKELY ((table->entries = p_malloc0 (size * sizeof (PStrHashTableEntry))) == NULL)) {
+		table->entries = old_entries;
+		return FALSE;
+	}
+
+	table->size    = size;
+	table->used    = 0;
+	table->deleted = 0;
+
+	mask = size - 1;
+
+	for (i = 0; i < old_size; ++i) {
+		if (old_entries[i].hash < P_STR_HASH_TABLE_MIN_HASH)
+			continue;
+
+		for (j = (psize) old_entries[i].hash & mask;
+		     table->entries[j].hash != P_STR_HASH_TABLE_EMPTY_SLOT;
+		     j = (j + 1) & mask)
+			;
+
+		table->entries[j] = old_entries[i];
+		++table->used;
+	}
+
+	p_free (old_entries);
+
+	if (table->wasted_bytes * 2 > table->keys_bytes)
+		pp_str_hash_table_compact_keys (table);
+
+	return TRUE;
+}
+
+static pboolean
+pp_str_hash_table_reserve_slot (PStrHashTable *table)
+{
+	psize new_size;
+
+	if ((table->used + table->deleted + 1) * P_STR_HASH_TABLE_LOAD_DEN <= table->size * P_STR_HASH_TABLE_LOAD_NUM)
+		return TRUE;
+
+	/* Grow only if live pairs occupy more than a half of the table,
+	 * otherwise just rebuild it in place to purge deleted slots */
+	new_size = table->size;
+
+	if ((table->used + 1) * 2 > table->size)
+		new_size <<= 1;
+
+	if (P_LIKELY (pp_str_hash_table_resize (table, new_size) == TRUE))
+		return TRUE;
+
+	/* Fallback to the current table while there is at least one free slot */
+	return (table->used + table->deleted + 1 < table->size) ? TRUE : FALSE;
+}
+
+static void
+pp_str_hash_table_remove_slot (PStrHashTable *table, psize slot)
+{
+	psize mask;
+
+	if (table->value_destroy_func != NULL)
+		table->value_destroy_func (table->entries[slot].value);
+
+	table->wasted_bytes += table->entries[slot].len + 1;
+
+	mask = table->size - 1;
+
+	--table->used;
+
+	if (table->entries[(slot + 1) & mask].hash != P_STR_HASH_TABLE_EMPTY_SLOT) {
+		table->entries[slot].hash = P_STR_HASH_TABLE_DELETED_SLOT;
+		++table->deleted;
+		return;
+	}
+
+	/* The probe chain ends here, so trailing deleted slots can be freed,
+	 * pairs are never moved which keeps iterators valid */
+	table->entries[slot].hash = P_STR_HASH_TABLE_EMPTY_SLOT;
+
+	for (slot = (slot - 1) & mask;
+	     table->entries[slot].hash == P_STR_HASH_TABLE_DELETED_SLOT;
+	     slot = (slot - 1) & mask) {
+		table->entries[slot].hash = P_STR_HASH_TABLE_EMPTY_SLOT;
+		--table->deleted;
+	}
+}
+
+P_LIB_API PStrHashTable *
+p_str_hash_table_new (PDestroyFunc value_destroy)
+{
+	PStrHashTable *ret;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PStrHashTable))) == NULL)) {
+		P_ERROR ("PStrHashTable::p_str_hash_table_new: failed(1) to allocate memory");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret->entries = p_malloc0 (P_STR_HASH_TABLE_MIN_SIZE * sizeof (PStrHashTableEntry))) == NULL)) {
+		P_ERROR ("PStrHashTable::p_str_hash_table_new: failed(2) to allocate memory");
+		p_free (ret);
+		return NULL;
+	}
+
+	ret->size               = P_STR_HASH_TABLE_MIN_SIZE;
+	ret->value_destroy_func = value_destroy;
+
+	return ret;
+}
+
+P_LIB_API pboolean
+p_str_hash_table_insert (PStrHashTable *table, const pchar *key, ppointer value)
+{
+	if (P_UNLIKELY (key == NULL))
+		return FALSE;
+
+	return p_str_hash_table_insert_len (table, key, strlen (key), value);
+}
+
+P_LIB_API pboolean
+p_str_hash_table_insert_len (PStrHashTable *table, const pchar *key, psize len, ppointer value)
+{
+	PStrHashTableEntry	*entry;
+	pchar			*copy;
+	psize			mask;
+	psize			slot;
+	puint64			hash;
+
+	if (P_UNLIKELY (table == NULL || (key == NULL && len > 0)))
+		return FALSE;
+
+	if (key == NULL)
+		key = "";
+
+	hash = pp_str_hash_table_calc_hash (key, len);
+
+	if ((slot = pp_str_hash_table_find_slot (table, key, len, hash)) != table->size) {
+		entry = &table->entries[slot];
+
+		if (table->value_destroy_func != NULL)
+			table->value_destroy_func (entry->value);
+
+		entry->value = value;
+		return TRUE;
+	}
+
+	if (P_UNLIKELY (pp_str_hash_table_reserve_slot (table) == FALSE)) {
+		P_ERROR ("PStrHashTable::p_str_hash_table_insert_len: failed(1) to allocate memory");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY ((copy = pp_str_hash_table_store_key (table, key, len)) == NULL)) {
+		P_ERROR ("PStrHashTable::p_str_hash_table_insert_len: failed(2) to allocate memory");
+		return FALSE;
+	}
+
+	mask = table->size - 1;
+
+	/* Reuse the first deleted slot in the probe sequence */
+	for (slot = (psize) hash & mask;
+	     table->entries[slot].hash >= P_STR_HASH_TABLE_MIN_HASH;
+	     slot = (slot + 1) & mask)
+		;
+
+	entry = &table->entries[slot];
+
+	if (entry->hash == P_STR_HASH_TABLE_DELETED_SLOT)
+		--table->deleted;
+
+	entry->hash  = hash;
+	entry->key   = copy;
+	entry->len   = len;
+	entry->value = value;
+
+	++table->used;
+
+	return TRUE;
+}
+
+P_LIB_API ppointer
+p_str_hash_table_lookup (const PStrHashTable *table, const pchar *key)
+{
+	if (P_UNLIKELY (key == NULL))
+		return (ppointer) (-1);
+
+	return p_str_hash_table_lookup_len (table, key, strlen (key));
+}
+
+P_LIB_API ppointer
+p_str_hash_table_lookup_len (const PStrHashTable *table, const pchar *key, psize len)
+{
+	psize slot;
+
+	if (P_UNLIKELY (table == NULL || (key == NULL && len > 0)))
+		return (ppointer) (-1);
+
+	if (key == NULL)
+		key = "";
+
+	slot = pp_str_hash_table_find_slot (table, key, len, pp_str_hash_table_calc_hash (key, len));
+
+	return slot == table->size ? (ppointer) (-1) : table->entries[slot].value;
+}
+
+P_LIB_API pboolean
+p_str_hash_table_remove (PStrHashTable *table, const pchar *key)
+{
+	if (P_UNLIKELY (key == NULL))
+		return FALSE;
+
+	return p_str_hash_table_remove_len (table, key, strlen (key));
+}
+
+P_LIB_API pboolean
+p_str_hash_table_remove_len (PStrHashTable *table, const pchar *key, psize len)
+{
+	psize slot;
+
+	if (P_UNLIKELY (table == NULL || (key == NULL && len > 0)))
+		return FALSE;
+
+	if (key == NULL)
+		key = "";
+
+	slot = pp_str_hash_table_find_slot (table, key, len, pp_str_hash_table_calc_hash (key, len));
+
+	if (slot == table->size)
+		return FALSE;
+
+	pp_str_hash_table_remove_slot (table, slot);
+
+	return TRUE;
+}
+
+P_LIB_API psize
+p_str_hash_table_size (const PStrHashTable *table)
+{
+	if (P_UNLIKELY (table == NULL))
+		return 0;
+
+	return table->used;
+}
+
+P_LIB_API void
+p_str_hash_table_free (PStrHashTable *table)
+{
+	PStrHashTableChunk	*next;
+	psize			i;
+
+	if (P_UNLIKELY (table == NULL))
+		return;
+
+	if (table->value_destroy_func != NULL) {
+		for (i = 0; i < table->size; ++i)
+			if (table->entries[i].hash >= P_STR_HASH_TABLE_MIN_HASH)
+				table->value_destroy_func (table->entries[i].value);
+	}
+
+	for (; table->chunks != NULL; table->chunks = next) {
+		next = table->chunks->next;
+		p_free (table->chunks);
+	}
+
+	p_free (table->entries);
+	p_free (table);
+}
+
+P_LIB_API void
+p_str_hash_table_iter_init (PStrHashTableIter *iter, PStrHashTable *table)
+{
+	if (P_UNLIKELY (iter == NULL))
+		return;
+
+	iter->table    = table;
+	iter->position = (psize) -1;
+	iter->removed  = FALSE;
+}
+
+P_LIB_API pboolean
+p_str_hash_table_iter_next (PStrHashTableIter *iter, const pchar **key, psize *len, ppointer *value)
+{
+	PStrHashTable	*table;
+	psize		i;
+
+	if (P_UNLIKELY (iter == NULL || iter->table == NULL))
+		return FALSE;
+
+	table = iter->table;
+
+	for (i = iter->position + 1; i < table->size; ++i) {
+		if (table->entries[i].hash >= P_STR_HASH_TABLE_MIN_HASH)
+			break;
+	}
+
+	iter->position = i;
+	iter->removed  = FALSE;
+
+	if (i >= table->size)
+		return FALSE;
+
+	if (key != NULL)
+		*key = table->entries[i].key;
+
+	if (len != NULL)
+		*len = table->entries[i].len;
+
+	if (value != NULL)
+		*value = table->entries[i].value;
+
+	return TRUE;
+}
+
+P_LIB_API void
+p_str_hash_table_iter_remove (PStrHashTableIter *iter)
+{
+	if (P_UNLIKELY (iter == NULL || iter->table == NULL))
+		return;
+
+	if (P_UNLIKELY (iter->removed == TRUE || iter->position >= iter->table->size))
+		return;
+
+	pp_str_hash_table_remove_slot (iter->table, iter->position);
+
+	iter->removed = TRUE;
+}
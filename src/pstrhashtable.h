@@ -0,0 +1,235 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2010-2016 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pstrhashtable.h
+ * @brief Hash table with string keys
+ * @author Alexander Saprykin
+ *
+ * #PStrHashTable is a hash table specialized for string keys, i.e. header or
+ * option names. Unlike #PHashTable with p_str_hash() and p_str_equal(), it
+ * owns the keys: every key is copied on insertion into a memory arena of the
+ * table, so the caller doesn't need to keep it alive or free it later.
+ *
+ * The full 64-bit hash of a key is stored next to it, so the probing
+ * compares the string bytes only when the hashes (and lengths) match, which
+ * is almost always the key being searched for.
+ *
+ * All the operations have variants taking a key as a pointer and a length,
+ * without a trailing zero. This way a parser can look up a token right in the
+ * input buffer:
+ * @code
+ * handler = p_str_hash_table_lookup_len (table, line + name_start, name_len);
+ * @endcode
+ * Such keys may also contain zero bytes.
+ *
+ * Use #PStrHashTableIter to walk through all the pairs in place, see
+ * p_str_hash_table_iter_init().
+ *
+ * The table is not thread-safe, use #PConcurrentHashTable or an external lock
+ * to share it between threads.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PSTRHASHTABLE_H
+#define PLIBSYS_HEADER_PSTRHASHTABLE_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+
+P_BEGIN_DECLS
+
+/** Opaque data structure for a string-keyed hash table. */
+typedef struct PStrHashTable_ PStrHashTable;
+
+/**
+ * @brief String-keyed hash table iterator.
+ * @since 0.0.5
+ *
+ * The iterator is intended to be allocated on the stack and initialized with
+ * p_str_hash_table_iter_init(), its fields are private and should not be
+ * accessed directly.
+ */
+typedef struct PStrHashTableIter_ {
+	PStrHashTable	*table;		/**< Table being iterated.		*/
+	psize		position;	/**< Current slot position.		*/
+	pboolean	removed;	/**< Whether current pair was removed.	*/
+} PStrHashTableIter;
+
+/**
+ * @brief Initializes a new string-keyed hash table.
+ * @param value_destroy Function to call on every value before its removal from
+ * the table, maybe NULL.
+ * @return Pointer to a newly initialized #PStrHashTable structure in case of
+ * success, NULL otherwise.
+ * @since 0.0.5
+ * @note Free with p_str_hash_table_free() after usage.
+ *
+ * The destroy function is called on the old value when it is replaced by the
+ * insertion, on removal and in p_str_hash_table_free().
+ */
+P_LIB_API PStrHashTable *	p_str_hash_table_new		(PDestroyFunc		value_destroy);
+
+/**
+ * @brief Inserts a key-value pair into a string-keyed hash table.
+ * @param table Initialized hash table.
+ * @param key Zero-terminated key to insert, copied by the table.
+ * @param value Value to insert.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * If the key already exists, its value is replaced.
+ */
+P_LIB_API pboolean		p_str_hash_table_insert		(PStrHashTable		*table,
+								 const pchar		*key,
+								 ppointer		value);
+
+/**
+ * @brief Inserts a key-value pair with a key of a given length.
+ * @param table Initialized hash table.
+ * @param key Key to insert, copied by the table.
+ * @param len Length of @a key, in bytes.
+ * @param value Value to insert.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The stored copy of the key is zero-terminated.
+ */
+P_LIB_API pboolean		p_str_hash_table_insert_len	(PStrHashTable		*table,
+								 const pchar		*key,
+								 psize			len,
+								 ppointer		value);
+
+/**
+ * @brief Searches for a zero-terminated key in a string-keyed hash table.
+ * @param table Hash table to lookup in.
+ * @param key Key to lookup for.
+ * @return Value related to the key (can be NULL), (#ppointer) -1 if no value
+ * was found.
+ * @since 0.0.5
+ */
+P_LIB_API ppointer		p_str_hash_table_lookup		(const PStrHashTable	*table,
+								 const pchar		*key);
+
+/**
+ * @brief Searches for a key of a given length in a string-keyed hash table.
+ * @param table Hash table to lookup in.
+ * @param key Key to lookup for, doesn't need a trailing zero.
+ * @param len Length of @a key, in bytes.
+ * @return Value related to the key (can be NULL), (#ppointer) -1 if no value
+ * was found.
+ * @since 0.0.5
+ */
+P_LIB_API ppointer		p_str_hash_table_lookup_len	(const PStrHashTable	*table,
+								 const pchar		*key,
+								 psize			len);
+
+/**
+ * @brief Removes a zero-terminated key from a string-keyed hash table.
+ * @param table Hash table to remove the key from.
+ * @param key Key to remove.
+ * @return TRUE if the key was found and removed, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean		p_str_hash_table_remove		(PStrHashTable		*table,
+								 const pchar		*key);
+
+/**
+ * @brief Removes a key of a given length from a string-keyed hash table.
+ * @param table Hash table to remove the key from.
+ * @param key Key to remove, doesn't need a trailing zero.
+ * @param len Length of @a key, in bytes.
+ * @return TRUE if the key was found and removed, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean		p_str_hash_table_remove_len	(PStrHashTable		*table,
+								 const pchar		*key,
+								 psize			len);
+
+/**
+ * @brief Gets the number of key-value pairs in a string-keyed hash table.
+ * @param table Hash table to get the size of.
+ * @return Number of stored pairs.
+ * @since 0.0.5
+ */
+P_LIB_API psize			p_str_hash_table_size		(const PStrHashTable	*table);
+
+/**
+ * @brief Frees a string-keyed hash table with all the stored keys.
+ * @param table Hash table to free.
+ * @since 0.0.5
+ *
+ * The value destroy function is called on every stored value if it was
+ * provided with p_str_hash_table_new().
+ */
+P_LIB_API void			p_str_hash_table_free		(PStrHashTable		*table);
+
+/**
+ * @brief Initializes an iterator over a string-keyed hash table.
+ * @param iter Iterator to initialize.
+ * @param table Hash table to iterate over.
+ * @since 0.0.5
+ *
+ * The table must not be modified during the iteration other than with
+ * p_str_hash_table_iter_remove(), otherwise the iterator becomes invalid.
+ */
+P_LIB_API void			p_str_hash_table_iter_init	(PStrHashTableIter	*iter,
+								 PStrHashTable		*table);
+
+/**
+ * @brief Advances an iterator to the next key-value pair.
+ * @param iter Initialized iterator.
+ * @param[out] key Pointer to store the zero-terminated key of the pair, maybe
+ * NULL.
+ * @param[out] len Pointer to store the key length, maybe NULL.
+ * @param[out] value Pointer to store the value of the pair, maybe NULL.
+ * @return TRUE if the iterator was advanced to the next pair, FALSE if the end
+ * of the table was reached.
+ * @since 0.0.5
+ *
+ * Pairs are returned in arbitrary order. The key is owned by the table and is
+ * valid until the table is modified.
+ */
+P_LIB_API pboolean		p_str_hash_table_iter_next	(PStrHashTableIter	*iter,
+								 const pchar		**key,
+								 psize			*len,
+								 ppointer		*value);
+
+/**
+ * @brief Removes the current key-value pair from the table.
+ * @param iter Iterator pointing to a pair to remove.
+ * @since 0.0.5
+ *
+ * Removes the pair returned by the last p_str_hash_table_iter_next() call.
+ * The iteration can be continued after the removal.
+ */
+P_LIB_API void			p_str_hash_table_iter_remove	(PStrHashTableIter	*iter);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PSTRHASHTABLE_H */
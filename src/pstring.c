@@ -30,7 +30,52 @@
 #include <string.h>
 #include <ctype.h>
 
-#define P_STR_MAX_EXPON		308
+#if defined (P_CPU_X86_64) || defined (__SSE2__) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define P_STR_SSE2
+#elif defined (P_CPU_ARM_64)
+#  include <arm_neon.h>
+#  define P_STR_NEON
+#endif
+
+#ifdef P_CC_MSVC
+#  include <intrin.h>
+#endif
+
+#define P_STR_MAX_SIMD_DELIMS	8
+
+static const pchar pp_str_hex_digits[] = "0123456789abcdef";
+
+static pboolean pp_str_is_space (pchar c);
+static puint pp_str_ctz (puint32 mask);
+
+static pboolean
+pp_str_is_space (pchar c)
+{
+	/* The same set as isspace() in the "C" locale */
+	return c == ' ' || (puchar) (c - '\t') <= (puchar) ('\r' - '\t');
+}
+
+static puint
+pp_str_ctz (puint32 mask)
+{
+#if defined (P_CC_GNU) || defined (P_CC_CLANG)
+	return (puint) __builtin_ctz (mask);
+#elif defined (P_CC_MSVC)
+	unsigned long idx;
+
+	_BitScanForward (&idx, mask);
+
+	return (puint) idx;
+#else
+	puint idx;
+
+	for (idx = 0; (mask & 1) == 0; mask >>= 1)
+		++idx;
+
+	return idx;
+#endif
+}
 
 P_LIB_API pchar *
 p_strdup (const pchar *str)
@@ -54,41 +99,189 @@ p_strdup (const pchar *str)
 P_LIB_API pchar *
 p_strchomp (const pchar *str)
 {
-	pssize		pos_start, pos_end;
-	psize		str_len;
+	const pchar	*start;
+	psize		len;
 	pchar		*ret;
-	const pchar	*ptr;
 
-	if (P_UNLIKELY (str == NULL))
+	if (P_UNLIKELY ((start = p_strchomp_view (str, &len)) == NULL))
+		return NULL;
+
+	if (P_UNLIKELY ((ret = p_malloc (len + 1)) == NULL))
 		return NULL;
 
-	ptr       = str;
-	pos_start = 0;
-	pos_end   = ((pssize) strlen (str)) - 1;
+	memcpy (ret, start, len);
+	ret[len] = '\0';
 
-	while (pos_start < pos_end && isspace (* ((const puchar *) ptr++)))
-		++pos_start;
+	return ret;
+}
+
+P_LIB_API const pchar *
+p_strchomp_view (const pchar	*str,
+		 psize		*len)
+{
+	psize start, end;
 
-	ptr = str + pos_end;
+	if (P_UNLIKELY (str == NULL || len == NULL))
+		return NULL;
 
-	while (pos_end > 0 && isspace (* ((const puchar *) ptr--)))
-		--pos_end;
+	end   = strlen (str);
+	start = p_str_skip_spaces (str, end);
 
-	if (pos_end < pos_start)
-		return p_strdup ("\0");
+	while (end > start && pp_str_is_space (str[end - 1]))
+		--end;
 
-	if (pos_end == pos_start && isspace (* ((const puchar *) (str + pos_end))))
-		return p_strdup ("\0");
+	*len = end - start;
 
-	str_len = (psize) (pos_end - pos_start + 2);
+	return str + start;
+}
 
-	if (P_UNLIKELY ((ret = p_malloc0 (str_len)) == NULL))
+P_LIB_API pchar *
+p_strtrim_inplace (pchar *str)
+{
+	const pchar	*start;
+	psize		len;
+
+	if (P_UNLIKELY ((start = p_strchomp_view (str, &len)) == NULL))
 		return NULL;
 
-	memcpy (ret, str + pos_start, str_len - 1);
-	*(ret + str_len - 1) = '\0';
+	if (start != str)
+		memmove (str, start, len);
 
-	return ret;
+	str[len] = '\0';
+
+	return str;
+}
+
+P_LIB_API psize
+p_str_skip_spaces (const pchar	*str,
+		   psize	len)
+{
+	psize i = 0;
+
+	if (P_UNLIKELY (str == NULL))
+		return 0;
+
+	/* Short strings are the common case, don't waste time on vectors */
+	while (i < len && i < 16) {
+		if (!pp_str_is_space (str[i]))
+			return i;
+
+		++i;
+	}
+
+#if defined (P_STR_SSE2)
+	{
+		/* Space or 9..13 after subtracting 9 with an unsigned saturation check */
+		const __m128i space = _mm_set1_epi8 (' ');
+		const __m128i tab   = _mm_set1_epi8 ('\t');
+		const __m128i range = _mm_set1_epi8 ('\r' - '\t');
+
+		for (; i + 16 <= len; i += 16) {
+			__m128i v   = _mm_loadu_si128 ((const __m128i *) (str + i));
+			__m128i ctl = _mm_sub_epi8 (v, tab);
+			__m128i ws  = _mm_or_si128 (_mm_cmpeq_epi8 (v, space),
+						    _mm_cmpeq_epi8 (_mm_min_epu8 (ctl, range), ctl));
+			puint32 mask = (puint32) (~_mm_movemask_epi8 (ws)) & 0xFFFFU;
+
+			if (mask != 0)
+				return i + pp_str_ctz (mask);
+		}
+	}
+#elif defined (P_STR_NEON)
+	{
+		const uint8x16_t space = vdupq_n_u8 (' ');
+		const uint8x16_t tab   = vdupq_n_u8 ('\t');
+		const uint8x16_t range = vdupq_n_u8 ('\r' - '\t');
+
+		for (; i + 16 <= len; i += 16) {
+			uint8x16_t v  = vld1q_u8 ((const uint8_t *) (str + i));
+			uint8x16_t ws = vorrq_u8 (vceqq_u8 (v, space), vcleq_u8 (vsubq_u8 (v, tab), range));
+
+			if (vminvq_u8 (ws) == 0) {
+				while (pp_str_is_space (str[i]))
+					++i;
+
+				return i;
+			}
+		}
+	}
+#endif
+
+	for (; i < len; ++i) {
+		if (!pp_str_is_space (str[i]))
+			return i;
+	}
+
+	return len;
+}
+
+P_LIB_API psize
+p_str_find_any (const pchar	*str,
+		psize		len,
+		const pchar	*delims)
+{
+	psize	i = 0;
+	psize	delims_count;
+
+	if (P_UNLIKELY (str == NULL || delims == NULL))
+		return len;
+
+	if ((delims_count = strlen (delims)) == 0)
+		return len;
+
+	if (delims_count == 1) {
+		const pchar *ptr = memchr (str, delims[0], len);
+
+		return ptr == NULL ? len : (psize) (ptr - str);
+	}
+
+#if defined (P_STR_SSE2)
+	if (delims_count <= P_STR_MAX_SIMD_DELIMS) {
+		__m128i	set[P_STR_MAX_SIMD_DELIMS];
+		psize	k;
+
+		for (k = 0; k < delims_count; ++k)
+			set[k] = _mm_set1_epi8 (delims[k]);
+
+		for (; i + 16 <= len; i += 16) {
+			__m128i v  = _mm_loadu_si128 ((const __m128i *) (str + i));
+			__m128i eq = _mm_cmpeq_epi8 (v, set[0]);
+			puint32 mask;
+
+			for (k = 1; k < delims_count; ++k)
+				eq = _mm_or_si128 (eq, _mm_cmpeq_epi8 (v, set[k]));
+
+			if ((mask = (puint32) _mm_movemask_epi8 (eq)) != 0)
+				return i + pp_str_ctz (mask);
+		}
+	}
+#elif defined (P_STR_NEON)
+	if (delims_count <= P_STR_MAX_SIMD_DELIMS) {
+		uint8x16_t	set[P_STR_MAX_SIMD_DELIMS];
+		psize		k;
+
+		for (k = 0; k < delims_count; ++k)
+			set[k] = vdupq_n_u8 ((uint8_t) delims[k]);
+
+		for (; i + 16 <= len; i += 16) {
+			uint8x16_t v  = vld1q_u8 ((const uint8_t *) (str + i));
+			uint8x16_t eq = vceqq_u8 (v, set[0]);
+
+			for (k = 1; k < delims_count; ++k)
+				eq = vorrq_u8 (eq, vceqq_u8 (v, set[k]));
+
+			if (vmaxvq_u8 (eq) != 0)
+				break;
+		}
+	}
+#endif
+
+	for (; i < len; ++i) {
+		if (memchr (delims, str[i], delims_count) != NULL)
+			return i;
+	}
+
+	return len;
 }
 
 P_LIB_API pchar *
@@ -119,88 +312,68 @@ p_strtok (pchar *str, const pchar *delim, pchar **buf)
 #endif
 }
 
-P_LIB_API double
-p_strtod (const pchar *str)
+P_LIB_API pboolean
+p_hex_encode (const puchar	*data,
+	      psize		len,
+	      pchar		*buf,
+	      psize		buflen)
 {
-	double	sign;
-	double	value;
-	double	scale;
-	double	pow10;
-	puint	expon;
-	pint	frac;
-	pchar	*orig_str, *strp;
-
-	orig_str = p_strchomp (str);
-
-	if (P_UNLIKELY (orig_str == NULL))
-		return 0.0;
-
-	strp = orig_str;
-	sign = 1.0;
-
-	if (*strp == '-') {
-		sign = -1.0;
-		strp += 1;
-	} else if (*strp == '+')
-		strp += 1;
-
-	/* Get digits before decimal point or exponent, if any */
-	for (value = 0.0; isdigit ((pint) *strp); strp += 1)
-		value = value * 10.0 + (*strp - '0');
-
-	/* Get digits after decimal point, if any */
-	if (*strp == '.') {
-		pow10 = 10.0;
-		strp += 1;
-
-		while (isdigit ((pint) *strp)) {
-			value += (*strp - '0') / pow10;
-			pow10 *= 10.0;
-			strp += 1;
+	psize i = 0;
+
+	if (P_UNLIKELY ((data == NULL && len > 0) || buf == NULL))
+		return FALSE;
+
+	if (P_UNLIKELY (buflen == 0 || len > (buflen - 1) / 2))
+		return FALSE;
+
+#if defined (P_STR_SSE2)
+	{
+		/* Nibble n becomes '0' + n, plus the gap to 'a' for n > 9 */
+		const __m128i mask  = _mm_set1_epi8 (0x0F);
+		const __m128i nine  = _mm_set1_epi8 (9);
+		const __m128i zero  = _mm_set1_epi8 ('0');
+		const __m128i alpha = _mm_set1_epi8 ('a' - '0' - 10);
+
+		for (; i + 16 <= len; i += 16) {
+			__m128i v  = _mm_loadu_si128 ((const __m128i *) (data + i));
+			__m128i hi = _mm_and_si128 (_mm_srli_epi16 (v, 4), mask);
+			__m128i lo = _mm_and_si128 (v, mask);
+			__m128i c0 = _mm_unpacklo_epi8 (hi, lo);
+			__m128i c1 = _mm_unpackhi_epi8 (hi, lo);
+
+			c0 = _mm_add_epi8 (_mm_add_epi8 (c0, zero),
+					   _mm_and_si128 (_mm_cmpgt_epi8 (c0, nine), alpha));
+			c1 = _mm_add_epi8 (_mm_add_epi8 (c1, zero),
+					   _mm_and_si128 (_mm_cmpgt_epi8 (c1, nine), alpha));
+
+			_mm_storeu_si128 ((__m128i *) (buf + i * 2), c0);
+			_mm_storeu_si128 ((__m128i *) (buf + i * 2 + 16), c1);
 		}
 	}
+#elif defined (P_STR_NEON)
+	{
+		const uint8x16_t table = vld1q_u8 ((const uint8_t *) pp_str_hex_digits);
+		const uint8x16_t mask  = vdupq_n_u8 (0x0F);
 
-	/* Handle exponent, if any */
-	frac  = 0;
-	scale = 1.0;
-
-	if ((*strp == 'e') || (*strp == 'E')) {
-		/* Get sign of exponent, if any */
-		strp += 1;
-
-		if (*strp == '-') {
-			frac = 1;
-			strp += 1;
-
-		} else if (*strp == '+')
-			strp += 1;
-
-		/* Get digits of exponent, if any */
-		for (expon = 0; isdigit ((pint) *strp); strp += 1)
-			expon = expon * 10 + (puint) ((*strp - '0'));
+		for (; i + 16 <= len; i += 16) {
+			uint8x16_t	v = vld1q_u8 (data + i);
+			uint8x16x2_t	c;
 
-		if (P_UNLIKELY (expon > P_STR_MAX_EXPON))
-			expon = P_STR_MAX_EXPON;
+			/* Interleaving store puts the high nibble first */
+			c.val[0] = vqtbl1q_u8 (table, vshrq_n_u8 (v, 4));
+			c.val[1] = vqtbl1q_u8 (table, vandq_u8 (v, mask));
 
-		/* Calculate scaling factor */
-		while (expon >= 50) {
-			scale *= 1e50;
-			expon -= 50;
-		}
-
-		while (expon >= 8) {
-			scale *= 1e8;
-			expon -= 8;
+			vst2q_u8 ((uint8_t *) (buf + i * 2), c);
 		}
+	}
+#endif
 
-		while (expon > 0) {
-			scale *= 10.0;
-			expon -= 1;
-		}
+	for (; i < len; ++i) {
+		buf[i * 2]     = pp_str_hex_digits[(data[i] >> 4) & 0x0F];
+		buf[i * 2 + 1] = pp_str_hex_digits[data[i] & 0x0F];
 	}
 
-	p_free (orig_str);
+	buf[len * 2] = '\0';
 
-	/* Return signed and scaled floating point result */
-	return sign * (frac ? (value / scale) : (value * scale));
+	return TRUE;
 }
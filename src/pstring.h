@@ -64,6 +64,61 @@ P_LIB_API pchar *	p_strdup	(const pchar	*str);
  */
 P_LIB_API pchar *	p_strchomp	(const pchar	*str);
 
+/**
+ * @brief Removes trailing and leading whitespaces without copying.
+ * @param str String with the trailing zero to process.
+ * @param[out] len Length of the trimmed string.
+ * @return Pointer to the first non-whitespace character of the @a str in case
+ * of success, NULL otherwise.
+ * @since 0.0.5
+ * @note The returned string is not zero-terminated at @a len, it is a view into
+ * the @a str and nothing is allocated.
+ */
+P_LIB_API const pchar *	p_strchomp_view	(const pchar	*str,
+					 psize		*len);
+
+/**
+ * @brief Removes trailing and leading whitespaces in place.
+ * @param[in,out] str String with the trailing zero to process.
+ * @return @a str in case of success, NULL otherwise.
+ * @since 0.0.5
+ *
+ * The trimmed string is moved to the beginning of the @a str and terminated
+ * with a zero, nothing is allocated.
+ */
+P_LIB_API pchar *	p_strtrim_inplace	(pchar		*str);
+
+/**
+ * @brief Skips leading whitespaces.
+ * @param str String to scan, doesn't need a trailing zero.
+ * @param len Length of @a str, in bytes.
+ * @return Index of the first non-whitespace character, @a len if there is no
+ * such one.
+ * @since 0.0.5
+ *
+ * Whitespaces are the same as for isspace() in the "C" locale. Long runs are
+ * scanned 16 bytes at once with SSE2 or NEON instructions if they are available
+ * for the target.
+ */
+P_LIB_API psize		p_str_skip_spaces	(const pchar	*str,
+						 psize		len);
+
+/**
+ * @brief Searches for the first occurrence of any of the given delimiters.
+ * @param str String to scan, doesn't need a trailing zero.
+ * @param len Length of @a str, in bytes.
+ * @param delims Zero-terminated set of delimiters.
+ * @return Index of the first delimiter found, @a len if there is no such one.
+ * @since 0.0.5
+ *
+ * Up to 8 delimiters are compared 16 bytes at once with SSE2 or NEON
+ * instructions if they are available for the target, a single delimiter is
+ * searched with memchr().
+ */
+P_LIB_API psize		p_str_find_any		(const pchar	*str,
+						 psize		len,
+						 const pchar	*delims);
+
 /**
  * @brief Tokenizes a string by given delimiters.
  * @param[in,out] str String to tokenize.
@@ -109,9 +164,85 @@ P_LIB_API pchar *	p_strtok	(pchar		*str,
  * Since the atof() system call is locale dependent, you can use this call to
  * convert string variables to @a double values. The decimal point is '.' as in
  * the 'C' locale.
+ *
+ * Leading whitespaces are skipped, the exponent is clamped to 308 by absolute
+ * value. Since 0.0.5 the result is correctly rounded, see p_strtod_n().
  */
 P_LIB_API double	p_strtod	(const pchar	*str);
 
+/**
+ * @brief Converts a string with an explicit length to @a double without a
+ * locale dependency.
+ * @param str String to convert, doesn't need a trailing zero.
+ * @param len Length of @a str, in bytes.
+ * @param[out] value Converted value, untouched in case of failure.
+ * @return Number of consumed characters in case of success, 0 otherwise.
+ * @since 0.0.5
+ *
+ * Accepts an optional sign, decimal digits with an optional '.' point and
+ * an optional exponent, as well as "inf", "infinity" and "nan" in any case.
+ * Leading whitespaces are not skipped, parsing stops at the first character
+ * which can't continue the number.
+ *
+ * The result is correctly rounded to the nearest value (ties to even), an
+ * overflow gives an infinity and an underflow gives a zero. Nothing is
+ * allocated: most of the values are converted with a single 128-bit
+ * multiplication by a tabulated power of five (the Eisel-Lemire algorithm).
+ */
+P_LIB_API psize		p_strtod_n	(const pchar	*str,
+					 psize		len,
+					 double		*value);
+
+/**
+ * @brief Converts a decimal string with an explicit length to a signed 64-bit
+ * integer.
+ * @param str String to convert, doesn't need a trailing zero.
+ * @param len Length of @a str, in bytes.
+ * @param[out] value Converted value, untouched in case of failure.
+ * @return Number of consumed characters in case of success, 0 otherwise.
+ * @since 0.0.5
+ *
+ * Accepts an optional sign followed by decimal digits, leading whitespaces
+ * are not skipped. A value out of the #pint64 range is treated as a failure.
+ */
+P_LIB_API psize		p_strtoll_n	(const pchar	*str,
+					 psize		len,
+					 pint64		*value);
+
+/**
+ * @brief Converts a decimal string with an explicit length to an unsigned
+ * 64-bit integer.
+ * @param str String to convert, doesn't need a trailing zero.
+ * @param len Length of @a str, in bytes.
+ * @param[out] value Converted value, untouched in case of failure.
+ * @return Number of consumed characters in case of success, 0 otherwise.
+ * @since 0.0.5
+ *
+ * Accepts an optional '+' sign followed by decimal digits, leading whitespaces
+ * are not skipped. A value out of the #puint64 range is treated as a failure.
+ */
+P_LIB_API psize		p_strtoull_n	(const pchar	*str,
+					 psize		len,
+					 puint64	*value);
+
+/**
+ * @brief Encodes binary data into a lowercase hexadecimal string.
+ * @param data Data to encode, may be NULL only if @a len is zero.
+ * @param len Length of @a data, in bytes.
+ * @param[out] buf Buffer to store the string with the trailing zero.
+ * @param buflen Size of @a buf, must be at least @a len * 2 + 1 bytes.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * Every input byte produces two characters, the high nibble goes first. Nothing
+ * is allocated, 16 bytes are converted at once with SSE2 or NEON instructions
+ * if they are available for the target.
+ */
+P_LIB_API pboolean	p_hex_encode	(const puchar	*data,
+					 psize		len,
+					 pchar		*buf,
+					 psize		buflen);
+
 P_END_DECLS
 
 #endif /* PLIBSYS_HEADER_PSTRING_H */
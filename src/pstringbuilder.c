@@ -0,0 +1,421 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "pmem.h"
+#include "pstring.h"
+#include "pstringbuilder.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <float.h>
+
+/* Enough for any "%.17g" output: sign, 17 digits, point and "e-308" */
+#define P_STRING_BUILDER_DOUBLE_SIZE	32
+#define P_STRING_BUILDER_UINT64_DIGITS	20
+
+static const pchar pp_string_builder_digit_pairs[] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+static pchar * pp_string_builder_data (PStringBuilder *sb);
+static pboolean pp_string_builder_grow (PStringBuilder *sb, psize extra);
+static puint pp_string_builder_count_digits (puint64 val);
+static void pp_string_builder_write_uint (pchar *buf, puint64 val, puint digits);
+static psize pp_string_builder_format_double (pchar *buf, double val, pint precision);
+
+static pchar *
+pp_string_builder_data (PStringBuilder *sb)
+{
+	return sb->heap != NULL ? sb->heap : sb->inline_buf;
+}
+
+static pboolean
+pp_string_builder_grow (PStringBuilder	*sb,
+			psize		extra)
+{
+	pchar	*buf;
+	psize	needed;
+	psize	new_capacity;
+
+	if (P_UNLIKELY (extra > (psize) -1 - sb->len - 1))
+		return FALSE;
+
+	needed = sb->len + extra + 1;
+
+	if (P_LIKELY (needed <= sb->capacity))
+		return TRUE;
+
+	/* Geometric growth keeps appending linear in total */
+	new_capacity = sb->capacity;
+
+	while (new_capacity < needed) {
+		if (P_UNLIKELY (new_capacity > (psize) -1 / 2)) {
+			new_capacity = needed;
+			break;
+		}
+
+		new_capacity *= 2;
+	}
+
+	if (sb->heap == NULL) {
+		if (P_UNLIKELY ((buf = p_malloc (new_capacity)) == NULL))
+			return FALSE;
+
+		memcpy (buf, sb->inline_buf, sb->len + 1);
+	} else if (P_UNLIKELY ((buf = p_realloc (sb->heap, new_capacity)) == NULL))
+		return FALSE;
+
+	sb->heap     = buf;
+	sb->capacity = new_capacity;
+
+	return TRUE;
+}
+
+static puint
+pp_string_builder_count_digits (puint64 val)
+{
+	puint digits = 1;
+
+	while (val >= 10000) {
+		val    /= 10000;
+		digits += 4;
+	}
+
+	if (val >= 1000)
+		return digits + 3;
+	else if (val >= 100)
+		return digits + 2;
+	else if (val >= 10)
+		return digits + 1;
+
+	return digits;
+}
+
+/* Writes exactly the given number of digits, two at once from the end */
+static void
+pp_string_builder_write_uint (pchar	*buf,
+			      puint64	val,
+			      puint	digits)
+{
+	puint idx;
+
+	buf += digits;
+
+	while (val >= 100) {
+		idx   = (puint) (val % 100) * 2;
+		val  /= 100;
+		buf  -= 2;
+
+		buf[0] = pp_string_builder_digit_pairs[idx];
+		buf[1] = pp_string_builder_digit_pairs[idx + 1];
+	}
+
+	if (val >= 10) {
+		idx    = (puint) val * 2;
+		buf   -= 2;
+		buf[0] = pp_string_builder_digit_pairs[idx];
+		buf[1] = pp_string_builder_digit_pairs[idx + 1];
+	} else
+		*(--buf) = (pchar) ('0' + val);
+}
+
+static psize
+pp_string_builder_format_double (pchar	*buf,
+				 double	val,
+				 pint	precision)
+{
+	psize len;
+	psize i;
+
+	len = (psize) sprintf (buf, "%.*g", precision, val);
+
+	/* The decimal point is the only locale dependent character here */
+	for (i = 0; i < len; ++i) {
+		if ((buf[i] < '0' || buf[i] > '9') && buf[i] != '-' && buf[i] != '+' &&
+		    buf[i] != 'e' && buf[i] != 'E')
+			buf[i] = '.';
+	}
+
+	return len;
+}
+
+P_LIB_API void
+p_string_builder_init (PStringBuilder *sb)
+{
+	if (P_UNLIKELY (sb == NULL))
+		return;
+
+	sb->heap          = NULL;
+	sb->len           = 0;
+	sb->capacity      = P_STRING_BUILDER_INLINE_SIZE;
+	sb->inline_buf[0] = '\0';
+}
+
+P_LIB_API void
+p_string_builder_clear (PStringBuilder *sb)
+{
+	if (P_UNLIKELY (sb == NULL))
+		return;
+
+	p_free (sb->heap);
+	p_string_builder_init (sb);
+}
+
+P_LIB_API pboolean
+p_string_builder_reserve (PStringBuilder	*sb,
+			  psize			extra)
+{
+	if (P_UNLIKELY (sb == NULL))
+		return FALSE;
+
+	return pp_string_builder_grow (sb, extra);
+}
+
+P_LIB_API pboolean
+p_string_builder_append (PStringBuilder	*sb,
+			 const pchar	*str)
+{
+	if (P_UNLIKELY (str == NULL))
+		return FALSE;
+
+	return p_string_builder_append_len (sb, str, strlen (str));
+}
+
+P_LIB_API pboolean
+p_string_builder_append_len (PStringBuilder	*sb,
+			     const pchar	*str,
+			     psize		len)
+{
+	pchar *data;
+
+	if (P_UNLIKELY (sb == NULL || (str == NULL && len > 0)))
+		return FALSE;
+
+	if (P_UNLIKELY (!pp_string_builder_grow (sb, len)))
+		return FALSE;
+
+	data = pp_string_builder_data (sb);
+
+	if (len > 0)
+		memcpy (data + sb->len, str, len);
+
+	sb->len      += len;
+	data[sb->len] = '\0';
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_string_builder_append_char (PStringBuilder	*sb,
+			      pchar		c)
+{
+	pchar *data;
+
+	if (P_UNLIKELY (sb == NULL))
+		return FALSE;
+
+	if (P_UNLIKELY (!pp_string_builder_grow (sb, 1)))
+		return FALSE;
+
+	data = pp_string_builder_data (sb);
+
+	data[sb->len++] = c;
+	data[sb->len]   = '\0';
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_string_builder_append_int (PStringBuilder	*sb,
+			     pint64		val)
+{
+	pchar	*data;
+	puint64	abs_val;
+	puint	digits;
+	psize	sign;
+
+	if (P_UNLIKELY (sb == NULL))
+		return FALSE;
+
+	/* Negation in unsigned arithmetic works for the minimal value too */
+	sign    = val < 0 ? 1 : 0;
+	abs_val = val < 0 ? (puint64) 0 - (puint64) val : (puint64) val;
+	digits  = pp_string_builder_count_digits (abs_val);
+
+	if (P_UNLIKELY (!pp_string_builder_grow (sb, sign + digits)))
+		return FALSE;
+
+	data = pp_string_builder_data (sb) + sb->len;
+
+	if (sign)
+		*data = '-';
+
+	pp_string_builder_write_uint (data + sign, abs_val, digits);
+
+	sb->len += sign + digits;
+	pp_string_builder_data (sb)[sb->len] = '\0';
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_string_builder_append_uint (PStringBuilder	*sb,
+			      puint64		val)
+{
+	pchar	*data;
+	puint	digits;
+
+	if (P_UNLIKELY (sb == NULL))
+		return FALSE;
+
+	digits = pp_string_builder_count_digits (val);
+
+	if (P_UNLIKELY (!pp_string_builder_grow (sb, digits)))
+		return FALSE;
+
+	data = pp_string_builder_data (sb);
+
+	pp_string_builder_write_uint (data + sb->len, val, digits);
+
+	sb->len      += digits;
+	data[sb->len] = '\0';
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_string_builder_append_double (PStringBuilder	*sb,
+				double		val)
+{
+	pchar	*data;
+	double	check;
+	psize	len;
+
+	if (P_UNLIKELY (sb == NULL))
+		return FALSE;
+
+	if (val != val)
+		return p_string_builder_append_len (sb, "nan", 3);
+	else if (val > DBL_MAX)
+		return p_string_builder_append_len (sb, "inf", 3);
+	else if (val < -DBL_MAX)
+		return p_string_builder_append_len (sb, "-inf", 4);
+
+	if (P_UNLIKELY (!pp_string_builder_grow (sb, P_STRING_BUILDER_DOUBLE_SIZE)))
+		return FALSE;
+
+	data = pp_string_builder_data (sb) + sb->len;
+
+	/* Most of the values are exact with 15 digits and look much nicer */
+	len = pp_string_builder_format_double (data, val, 15);
+
+	if (p_strtod_n (data, len, &check) != len || check != val)
+		len = pp_string_builder_format_double (data, val, 17);
+
+	sb->len += len;
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_string_builder_append_hex (PStringBuilder	*sb,
+			     const puchar	*data,
+			     psize		len)
+{
+	if (P_UNLIKELY (sb == NULL || (data == NULL && len > 0)))
+		return FALSE;
+
+	if (P_UNLIKELY (len > ((psize) -1 - 1) / 2))
+		return FALSE;
+
+	if (P_UNLIKELY (!pp_string_builder_grow (sb, len * 2)))
+		return FALSE;
+
+	if (P_UNLIKELY (!p_hex_encode (data, len, pp_string_builder_data (sb) + sb->len, len * 2 + 1)))
+		return FALSE;
+
+	sb->len += len * 2;
+
+	return TRUE;
+}
+
+P_LIB_API void
+p_string_builder_truncate (PStringBuilder	*sb,
+			   psize		len)
+{
+	if (P_UNLIKELY (sb == NULL || len >= sb->len))
+		return;
+
+	sb->len = len;
+	pp_string_builder_data (sb)[len] = '\0';
+}
+
+P_LIB_API const pchar *
+p_string_builder_get (const PStringBuilder *sb)
+{
+	if (P_UNLIKELY (sb == NULL))
+		return NULL;
+
+	return sb->heap != NULL ? sb->heap : sb->inline_buf;
+}
+
+P_LIB_API psize
+p_string_builder_length (const PStringBuilder *sb)
+{
+	if (P_UNLIKELY (sb == NULL))
+		return 0;
+
+	return sb->len;
+}
+
+P_LIB_API pchar *
+p_string_builder_detach (PStringBuilder *sb)
+{
+	pchar *ret;
+
+	if (P_UNLIKELY (sb == NULL))
+		return NULL;
+
+	if (sb->heap != NULL)
+		ret = sb->heap;
+	else {
+		if (P_UNLIKELY ((ret = p_malloc (sb->len + 1)) == NULL))
+			return NULL;
+
+		memcpy (ret, sb->inline_buf, sb->len + 1);
+	}
+
+	p_string_builder_init (sb);
+
+	return ret;
+}
@@ -0,0 +1,236 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pstringbuilder.h
+ * @brief Growable string builder
+ * @author Alexander Saprykin
+ *
+ * #PStringBuilder collects a string piece by piece. Its buffer grows
+ * geometrically, so appending takes amortized O(1) time per byte instead of
+ * copying the whole string again on every p_strdup() or strcat().
+ *
+ * The first #P_STRING_BUILDER_INLINE_SIZE bytes (including the trailing zero)
+ * are stored inside the builder itself. It doesn't require any allocations by
+ * itself and can be placed on the stack, so short messages are built without
+ * touching the heap at all:
+ * @code
+ * PStringBuilder   sb;
+ * pchar            *msg;
+ *
+ * p_string_builder_init (&sb);
+ * p_string_builder_append (&sb, "request ");
+ * p_string_builder_append_uint (&sb, request_id);
+ * p_string_builder_append (&sb, " took ");
+ * p_string_builder_append_double (&sb, seconds);
+ *
+ * msg = p_string_builder_detach (&sb);
+ * @endcode
+ * Numbers and hex dumps are written right into the builder buffer, without
+ * any intermediate formatting buffers, and don't depend on the current locale.
+ *
+ * All the appending calls leave the builder unchanged if they fail to
+ * allocate memory. Every builder must be freed with p_string_builder_clear()
+ * or p_string_builder_detach(). Don't copy an initialized builder, pass a
+ * pointer to it instead.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PSTRINGBUILDER_H
+#define PLIBSYS_HEADER_PSTRINGBUILDER_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+
+P_BEGIN_DECLS
+
+/** Size of the inline storage of #PStringBuilder, in bytes. */
+#define P_STRING_BUILDER_INLINE_SIZE	64
+
+/** String builder, all the fields are private. */
+typedef struct PStringBuilder_ {
+	pchar	*heap;					/**< Heap buffer, NULL while inline.	*/
+	psize	len;					/**< String length.			*/
+	psize	capacity;				/**< Buffer size, in bytes.		*/
+	pchar	inline_buf[P_STRING_BUILDER_INLINE_SIZE];	/**< Inline storage.		*/
+} PStringBuilder;
+
+/**
+ * @brief Initializes a string builder with an empty string.
+ * @param sb String builder to initialize.
+ * @since 0.0.5
+ */
+P_LIB_API void		p_string_builder_init		(PStringBuilder	*sb);
+
+/**
+ * @brief Frees the memory used by a string builder.
+ * @param sb String builder to clear.
+ * @since 0.0.5
+ *
+ * The builder is left initialized with an empty string and can be reused.
+ */
+P_LIB_API void		p_string_builder_clear		(PStringBuilder	*sb);
+
+/**
+ * @brief Makes sure the given number of bytes can be appended without any
+ * allocations.
+ * @param sb String builder to reserve the space in.
+ * @param extra Number of bytes to reserve, not including the trailing zero.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_string_builder_reserve	(PStringBuilder	*sb,
+							 psize		extra);
+
+/**
+ * @brief Appends a zero-terminated string.
+ * @param sb String builder to append to.
+ * @param str String to append.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_string_builder_append		(PStringBuilder	*sb,
+							 const pchar	*str);
+
+/**
+ * @brief Appends a string of a given length.
+ * @param sb String builder to append to.
+ * @param str String to append, doesn't need a trailing zero.
+ * @param len Number of bytes to append.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_string_builder_append_len	(PStringBuilder	*sb,
+							 const pchar	*str,
+							 psize		len);
+
+/**
+ * @brief Appends a single character.
+ * @param sb String builder to append to.
+ * @param c Character to append.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_string_builder_append_char	(PStringBuilder	*sb,
+							 pchar		c);
+
+/**
+ * @brief Appends a signed integer in the decimal form.
+ * @param sb String builder to append to.
+ * @param val Value to append.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_string_builder_append_int	(PStringBuilder	*sb,
+							 pint64		val);
+
+/**
+ * @brief Appends an unsigned integer in the decimal form.
+ * @param sb String builder to append to.
+ * @param val Value to append.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_string_builder_append_uint	(PStringBuilder	*sb,
+							 puint64	val);
+
+/**
+ * @brief Appends a floating point value.
+ * @param sb String builder to append to.
+ * @param val Value to append.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The value is written with up to 17 significant digits, the shortest of 15
+ * and 17 digits which is read back as the same value by p_strtod_n(). The
+ * decimal point is '.' as in the 'C' locale, infinities and NaNs are written
+ * as "inf", "-inf" and "nan".
+ */
+P_LIB_API pboolean	p_string_builder_append_double	(PStringBuilder	*sb,
+							 double		val);
+
+/**
+ * @brief Appends binary data as a lowercase hexadecimal string.
+ * @param sb String builder to append to.
+ * @param data Data to append, may be NULL only if @a len is zero.
+ * @param len Length of @a data, in bytes.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ * @sa p_hex_encode()
+ */
+P_LIB_API pboolean	p_string_builder_append_hex	(PStringBuilder	*sb,
+							 const puchar	*data,
+							 psize		len);
+
+/**
+ * @brief Truncates the built string.
+ * @param sb String builder to truncate.
+ * @param len New length, nothing happens if it is not less than the current
+ * one.
+ * @since 0.0.5
+ *
+ * The memory is not released, so the builder can be reused for the next
+ * string without allocations.
+ */
+P_LIB_API void		p_string_builder_truncate	(PStringBuilder	*sb,
+							 psize		len);
+
+/**
+ * @brief Gets the built string.
+ * @param sb String builder to get the string from.
+ * @return Zero-terminated string owned by the builder, valid until the next
+ * modification of the @a sb.
+ * @since 0.0.5
+ */
+P_LIB_API const pchar *	p_string_builder_get		(const PStringBuilder	*sb);
+
+/**
+ * @brief Gets the length of the built string.
+ * @param sb String builder to get the length of.
+ * @return Length of the string, not including the trailing zero.
+ * @since 0.0.5
+ */
+P_LIB_API psize		p_string_builder_length		(const PStringBuilder	*sb);
+
+/**
+ * @brief Takes the built string out of a string builder.
+ * @param sb String builder to take the string from.
+ * @return Zero-terminated string in case of success, NULL otherwise. The
+ * caller takes ownership of the returned string and should free it with
+ * p_free().
+ * @since 0.0.5
+ *
+ * A heap buffer is handed over as is, a string stored inline is copied into a
+ * newly allocated one of the exact size. In case of success the builder is
+ * left initialized with an empty string, otherwise it is not changed.
+ */
+P_LIB_API pchar *	p_string_builder_detach		(PStringBuilder	*sb);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PSTRINGBUILDER_H */
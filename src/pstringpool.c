@@ -0,0 +1,388 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* String pool is a fixed array of segments selected by the high bits of the
+ * string hash. Every segment has its own open addressing table with linear
+ * probing (low bits select the slot) and its own list of memory chunks the
+ * strings are copied into, so nothing is shared between the segments. */
+
+#include "pmem.h"
+#include "pfasthash.h"
+#include "prwlock.h"
+#include "puthread.h"
+#include "pstringpool.h"
+
+#include <string.h>
+
+/* Number of segments per CPU core */
+#define P_STRING_POOL_SEGMENTS_PER_CPU	4
+
+/* Upper limit for the number of segments */
+#define P_STRING_POOL_MAX_SEGMENTS	256
+
+/* Initial number of slots in a segment table */
+#define P_STRING_POOL_MIN_SLOTS		64
+
+/* Size of a memory chunk for the strings */
+#define P_STRING_POOL_CHUNK_SIZE	4096
+
+typedef struct PStringPoolEntry_ {
+	const pchar	*str;
+	psize		len;
+	puint64		hash;
+} PStringPoolEntry;
+
+typedef struct PStringPoolChunk_ {
+	struct PStringPoolChunk_	*next;
+	psize				used;
+	psize				size;
+} PStringPoolChunk;
+
+/* Segments are written on every insertion, keep them on separate cache lines */
+typedef struct PStringPoolSegment_ {
+	P_CACHE_ALIGNED PRWLock	*lock;
+	PStringPoolEntry	*slots;
+	psize			slots_count;
+	psize			count;
+	PStringPoolChunk	*chunks;
+} PStringPoolSegment;
+
+struct PStringPool_ {
+	PStringPoolSegment	*segments;
+	psize			segments_count;
+	puint			segments_shift;
+};
+
+static PStringPoolSegment * pp_string_pool_get_segment (const PStringPool *pool, puint64 hash);
+static const PStringPoolEntry * pp_string_pool_find (const PStringPoolSegment *segment,
+						     const pchar *str, psize len, puint64 hash);
+static pboolean pp_string_pool_rehash (PStringPoolSegment *segment);
+static pchar * pp_string_pool_store (PStringPoolSegment *segment, const pchar *str, psize len);
+
+static PStringPoolSegment *
+pp_string_pool_get_segment (const PStringPool	*pool,
+			    puint64		hash)
+{
+	if (pool->segments_count == 1)
+		return pool->segments;
+
+	return pool->segments + (psize) (hash >> pool->segments_shift);
+}
+
+static const PStringPoolEntry *
+pp_string_pool_find (const PStringPoolSegment	*segment,
+		     const pchar		*str,
+		     psize			len,
+		     puint64			hash)
+{
+	const PStringPoolEntry	*entry;
+	psize			mask;
+	psize			idx;
+
+	if (segment->slots_count == 0)
+		return NULL;
+
+	mask = segment->slots_count - 1;
+
+	for (idx = (psize) hash & mask; ; idx = (idx + 1) & mask) {
+		entry = segment->slots + idx;
+
+		if (entry->str == NULL)
+			return NULL;
+
+		if (entry->hash == hash && entry->len == len && memcmp (entry->str, str, len) == 0)
+			return entry;
+	}
+}
+
+static pboolean
+pp_string_pool_rehash (PStringPoolSegment *segment)
+{
+	PStringPoolEntry	*slots;
+	psize			slots_count;
+	psize			mask;
+	psize			idx;
+	psize			i;
+
+	slots_count = segment->slots_count == 0 ? P_STRING_POOL_MIN_SLOTS : segment->slots_count * 2;
+
+	if (P_UNLIKELY ((slots = p_malloc0 (slots_count * sizeof (PStringPoolEntry))) == NULL))
+		return FALSE;
+
+	mask = slots_count - 1;
+
+	for (i = 0; i < segment->slots_count; ++i) {
+		if (segment->slots[i].str == NULL)
+			continue;
+
+		for (idx = (psize) segment->slots[i].hash & mask; slots[idx].str != NULL; idx = (idx + 1) & mask)
+			;
+
+		slots[idx] = segment->slots[i];
+	}
+
+	p_free (segment->slots);
+
+	segment->slots       = slots;
+	segment->slots_count = slots_count;
+
+	return TRUE;
+}
+
+/* Long strings get a chunk of their own, so they don't waste the rest of the
+ * current one */
+static pchar *
+pp_string_pool_store (PStringPoolSegment	*segment,
+		      const pchar		*str,
+		      psize			len)
+{
+	PStringPoolChunk	*chunk;
+	pchar			*ret;
+	psize			size;
+
+	chunk = segment->chunks;
+
+	if (chunk == NULL || chunk->size - chunk->used < len + 1) {
+		size = len + 1 > P_STRING_POOL_CHUNK_SIZE / 4 ? len + 1 : P_STRING_POOL_CHUNK_SIZE;
+
+		if (P_UNLIKELY ((chunk = p_malloc (sizeof (PStringPoolChunk) + size)) == NULL))
+			return NULL;
+
+		chunk->used = 0;
+		chunk->size = size;
+
+		if (size == P_STRING_POOL_CHUNK_SIZE || segment->chunks == NULL) {
+			chunk->next     = segment->chunks;
+			segment->chunks = chunk;
+		} else {
+			chunk->next           = segment->chunks->next;
+			segment->chunks->next = chunk;
+		}
+	}
+
+	ret = (pchar *) (chunk + 1) + chunk->used;
+
+	memcpy (ret, str, len);
+	ret[len] = '\0';
+
+	chunk->used += len + 1;
+
+	return ret;
+}
+
+P_LIB_API PStringPool *
+p_string_pool_new (void)
+{
+	PStringPool	*ret;
+	psize		segments;
+	psize		count;
+	puint		bits;
+	psize		i;
+
+	segments = (psize) p_uthread_ideal_count () * P_STRING_POOL_SEGMENTS_PER_CPU;
+
+	if (segments > P_STRING_POOL_MAX_SEGMENTS)
+		segments = P_STRING_POOL_MAX_SEGMENTS;
+
+	for (count = 1, bits = 0; count < segments; count <<= 1, ++bits)
+		;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PStringPool))) == NULL)) {
+		P_ERROR ("PStringPool::p_string_pool_new: failed(1) to allocate memory");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret->segments = p_malloc0_aligned (count * sizeof (PStringPoolSegment),
+							    P_CACHE_LINE_SIZE)) == NULL)) {
+		P_ERROR ("PStringPool::p_string_pool_new: failed(2) to allocate memory");
+		p_free (ret);
+		return NULL;
+	}
+
+	ret->segments_count = count;
+	ret->segments_shift = 64 - bits;
+
+	for (i = 0; i < count; ++i) {
+		if (P_UNLIKELY ((ret->segments[i].lock = p_rwlock_new ()) == NULL)) {
+			P_ERROR ("PStringPool::p_string_pool_new: failed to initialize segment");
+			p_string_pool_free (ret);
+			return NULL;
+		}
+	}
+
+	return ret;
+}
+
+P_LIB_API const pchar *
+p_string_pool_intern (PStringPool	*pool,
+		      const pchar	*str)
+{
+	if (P_UNLIKELY (str == NULL))
+		return NULL;
+
+	return p_string_pool_intern_len (pool, str, strlen (str));
+}
+
+P_LIB_API const pchar *
+p_string_pool_intern_len (PStringPool	*pool,
+			  const pchar	*str,
+			  psize		len)
+{
+	PStringPoolSegment	*segment;
+	const PStringPoolEntry	*entry;
+	PStringPoolEntry	*slot;
+	const pchar		*ret;
+	pchar			*copy;
+	puint64			hash;
+	psize			mask;
+	psize			idx;
+
+	if (P_UNLIKELY (pool == NULL || (str == NULL && len > 0)))
+		return NULL;
+
+	if (str == NULL)
+		str = "";
+
+	hash    = p_fast_hash_xxh3_64 (str, len, 0);
+	segment = pp_string_pool_get_segment (pool, hash);
+
+	/* Most of the strings are already there */
+	p_rwlock_reader_lock (segment->lock);
+	entry = pp_string_pool_find (segment, str, len, hash);
+	ret   = entry != NULL ? entry->str : NULL;
+	p_rwlock_reader_unlock (segment->lock);
+
+	if (ret != NULL)
+		return ret;
+
+	p_rwlock_writer_lock (segment->lock);
+
+	/* Someone could have added it while the lock was released */
+	if ((entry = pp_string_pool_find (segment, str, len, hash)) != NULL) {
+		ret = entry->str;
+		p_rwlock_writer_unlock (segment->lock);
+		return ret;
+	}
+
+	/* Keep the load factor under 1/2 */
+	if ((segment->count + 1) * 2 > segment->slots_count) {
+		if (P_UNLIKELY (!pp_string_pool_rehash (segment))) {
+			p_rwlock_writer_unlock (segment->lock);
+			return NULL;
+		}
+	}
+
+	if (P_UNLIKELY ((copy = pp_string_pool_store (segment, str, len)) == NULL)) {
+		p_rwlock_writer_unlock (segment->lock);
+		return NULL;
+	}
+
+	mask = segment->slots_count - 1;
+
+	for (idx = (psize) hash & mask; segment->slots[idx].str != NULL; idx = (idx + 1) & mask)
+		;
+
+	slot       = segment->slots + idx;
+	slot->str  = copy;
+	slot->len  = len;
+	slot->hash = hash;
+
+	++segment->count;
+
+	p_rwlock_writer_unlock (segment->lock);
+
+	return copy;
+}
+
+P_LIB_API const pchar *
+p_string_pool_lookup (PStringPool	*pool,
+		      const pchar	*str)
+{
+	PStringPoolSegment	*segment;
+	const PStringPoolEntry	*entry;
+	const pchar		*ret;
+	puint64			hash;
+	psize			len;
+
+	if (P_UNLIKELY (pool == NULL || str == NULL))
+		return NULL;
+
+	len     = strlen (str);
+	hash    = p_fast_hash_xxh3_64 (str, len, 0);
+	segment = pp_string_pool_get_segment (pool, hash);
+
+	p_rwlock_reader_lock (segment->lock);
+	entry = pp_string_pool_find (segment, str, len, hash);
+	ret   = entry != NULL ? entry->str : NULL;
+	p_rwlock_reader_unlock (segment->lock);
+
+	return ret;
+}
+
+P_LIB_API psize
+p_string_pool_size (PStringPool *pool)
+{
+	psize	ret = 0;
+	psize	i;
+
+	if (P_UNLIKELY (pool == NULL))
+		return 0;
+
+	for (i = 0; i < pool->segments_count; ++i) {
+		p_rwlock_reader_lock (pool->segments[i].lock);
+		ret += pool->segments[i].count;
+		p_rwlock_reader_unlock (pool->segments[i].lock);
+	}
+
+	return ret;
+}
+
+P_LIB_API void
+p_string_pool_free (PStringPool *pool)
+{
+	PStringPoolSegment	*segment;
+	PStringPoolChunk	*chunk;
+	psize			i;
+
+	if (P_UNLIKELY (pool == NULL))
+		return;
+
+	for (i = 0; i < pool->segments_count; ++i) {
+		segment = pool->segments + i;
+
+		while ((chunk = segment->chunks) != NULL) {
+			segment->chunks = chunk->next;
+			p_free (chunk);
+		}
+
+		p_free (segment->slots);
+
+		if (segment->lock != NULL)
+			p_rwlock_free (segment->lock);
+	}
+
+	p_free_aligned (pool->segments);
+	p_free (pool);
+}
@@ -0,0 +1,137 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pstringpool.h
+ * @brief String interning pool
+ * @author Alexander Saprykin
+ *
+ * A string pool keeps a single copy of every distinct string added to it and
+ * returns the same canonical pointer for all the equal strings. This saves
+ * memory when the same names (config sections, protocol header keys) are held
+ * by many objects, and turns string comparison into pointer comparison:
+ * @code
+ * const pchar *a = p_string_pool_intern (pool, "Content-Length");
+ * const pchar *b = p_string_pool_intern (pool, header_name);
+ *
+ * if (a == b)
+ *     ...
+ * @endcode
+ * Interned pointers can be used directly as keys of a #PHashTable created
+ * with the default (direct pointer) hash and equality functions.
+ *
+ * The strings are copied into large memory chunks owned by the pool and stay
+ * valid until the pool is freed, they are never removed one by one.
+ *
+ * The pool is thread-safe. Like #PConcurrentHashTable, it is split into
+ * several segments selected by the string hash, each one protected by its own
+ * read-write lock, so threads interning different strings rarely contend and
+ * lookups of already interned strings share the lock.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PSTRINGPOOL_H
+#define PLIBSYS_HEADER_PSTRINGPOOL_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+
+P_BEGIN_DECLS
+
+/** String pool opaque data type. */
+typedef struct PStringPool_ PStringPool;
+
+/**
+ * @brief Creates a new empty string pool.
+ * @return Pointer to #PStringPool in case of success, NULL otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API PStringPool *	p_string_pool_new		(void);
+
+/**
+ * @brief Interns a zero-terminated string.
+ * @param pool #PStringPool to intern the string in.
+ * @param str String to intern.
+ * @return Canonical copy of the @a str owned by the @a pool in case of
+ * success, NULL otherwise.
+ * @since 0.0.5
+ *
+ * Equal strings always give the same pointer. The returned string must not be
+ * modified or freed, it is valid until the @a pool is freed.
+ */
+P_LIB_API const pchar *	p_string_pool_intern		(PStringPool	*pool,
+							 const pchar	*str);
+
+/**
+ * @brief Interns a string of a given length.
+ * @param pool #PStringPool to intern the string in.
+ * @param str String to intern, doesn't need a trailing zero.
+ * @param len Length of @a str, in bytes.
+ * @return Canonical zero-terminated copy of the @a str owned by the @a pool in
+ * case of success, NULL otherwise.
+ * @since 0.0.5
+ *
+ * Useful to intern tokens right from a parsed buffer without copying them
+ * first.
+ */
+P_LIB_API const pchar *	p_string_pool_intern_len	(PStringPool	*pool,
+							 const pchar	*str,
+							 psize		len);
+
+/**
+ * @brief Looks up an already interned string.
+ * @param pool #PStringPool to look up the string in.
+ * @param str String to look up.
+ * @return Canonical copy of the @a str if it was interned before, NULL
+ * otherwise.
+ * @since 0.0.5
+ *
+ * Nothing is added to the @a pool, so it is a cheap check whether a string
+ * from an untrusted source is one of the known names.
+ */
+P_LIB_API const pchar *	p_string_pool_lookup		(PStringPool	*pool,
+							 const pchar	*str);
+
+/**
+ * @brief Gets the number of distinct strings in a string pool.
+ * @param pool #PStringPool to get the size of.
+ * @return Number of interned strings.
+ * @since 0.0.5
+ */
+P_LIB_API psize		p_string_pool_size		(PStringPool	*pool);
+
+/**
+ * @brief Frees a string pool with all the interned strings.
+ * @param pool #PStringPool to free.
+ * @since 0.0.5
+ */
+P_LIB_API void		p_string_pool_free		(PStringPool	*pool);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PSTRINGPOOL_H */
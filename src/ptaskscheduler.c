@@ -0,0 +1,632 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Chase-Lev deques after "Correct and Efficient Work-Stealing for Weak Memory
+ * Models" by Le, Pop, Cohen and Zappa Nardelli, with all the accesses to the
+ * shared fields done through sequentially consistent atomic calls. Indices
+ * grow without bounds, only their difference matters. A full deque is copied
+ * into an array twice as large, the old arrays are kept until the scheduler
+ * is freed because a stealer may still read from them.
+ *
+ * A worker which is about to park registers in n_parked and only then checks
+ * all the deques, while a spawner publishes a task and only then checks
+ * n_parked, so either the worker sees the task or the spawner sees the worker.
+ * The wakeup itself is done under the mutex held by the parking worker. */
+
+#include "patomic.h"
+#include "pcondvariable.h"
+#include "pmem.h"
+#include "pmempool.h"
+#include "pmutex.h"
+#include "ptaskscheduler.h"
+#include "puthread.h"
+
+#define P_TASK_SCHEDULER_DEQUE_SIZE	256
+#define P_TASK_SCHEDULER_SPIN_ROUNDS	64
+
+typedef struct PTask_ {
+	struct PTask_	*next;
+	PTaskFunc	func;
+	ppointer	data;
+	PTaskGroup	*group;
+} PTask;
+
+typedef struct PTaskDequeArray_ {
+	struct PTaskDequeArray_	*prev;
+	psize			mask;
+	PTask * volatile	slots[1];
+} PTaskDequeArray;
+
+typedef struct PTaskWorker_ {
+	volatile psize			top;
+	pchar				pad[P_MEM_CACHE_LINE_SIZE - sizeof (psize)];
+	volatile psize			bottom;
+	PTaskDequeArray * volatile	array;
+	PTaskScheduler			*scheduler;
+	PUThread			*thread;
+	puint32				seed;
+} PTaskWorker;
+
+struct PTaskScheduler_ {
+	PTaskWorker		**workers;
+	PMemPool		*task_pool;
+	PUThreadStaticKey	*worker_key;
+	PMutex			*mutex;
+	PCondVariable		*cond;
+	PTask			*injected_first;
+	PTask			*injected_last;
+	pint			n_workers;
+	pint			n_wakeups;
+	volatile pint		n_injected;
+	volatile pint		n_parked;
+	volatile pint		is_stopping;
+};
+
+static PTaskDequeArray * pp_task_deque_array_new (psize size);
+static pboolean pp_task_deque_push (PTaskWorker *worker, PTask *task);
+static PTask * pp_task_deque_pop (PTaskWorker *worker);
+static PTask * pp_task_deque_steal (PTaskWorker *worker);
+static pboolean pp_task_deque_is_empty (PTaskWorker *worker);
+static void pp_task_scheduler_inject (PTaskScheduler *scheduler, PTask *task);
+static PTask * pp_task_scheduler_take_injected (PTaskScheduler *scheduler);
+static PTask * pp_task_scheduler_take_injected_group (PTaskScheduler *scheduler, PTaskGroup *group);
+static void pp_task_scheduler_wake (PTaskScheduler *scheduler);
+static PTask * pp_task_scheduler_find (PTaskScheduler *scheduler, PTaskWorker *self, puint32 *seed);
+static void pp_task_scheduler_run (PTaskScheduler *scheduler, PTask *task);
+static void pp_task_scheduler_park (PTaskScheduler *scheduler);
+static ppointer pp_task_scheduler_worker (ppointer data);
+
+static PTaskDequeArray *
+pp_task_deque_array_new (psize size)
+{
+	PTaskDequeArray *ret;
+
+	if (P_UNLIKELY ((ret = p_malloc (sizeof (PTaskDequeArray) + (size - 1) * sizeof (PTask *))) == NULL))
+		return NULL;
+
+	ret->prev = NULL;
+	ret->mask = size - 1;
+
+	return ret;
+}
+
+/* Called by the owner only */
+static pboolean
+pp_task_deque_push (PTaskWorker	*worker,
+		    PTask	*task)
+{
+	PTaskDequeArray	*array;
+	PTaskDequeArray	*new_array;
+	psize		top;
+	psize		bottom;
+	psize		i;
+
+	bottom = worker->bottom;
+	top    = PPOINTER_TO_PSIZE (p_atomic_pointer_get (&worker->top));
+	array  = worker->array;
+
+	if (P_UNLIKELY (bottom - top > array->mask)) {
+		if (P_UNLIKELY ((new_array = pp_task_deque_array_new ((array->mask + 1) * 2)) == NULL))
+			return FALSE;
+
+		for (i = top; i != bottom; ++i)
+			new_array->slots[i & new_array->mask] = array->slots[i & array->mask];
+
+		new_array->prev = array;
+		array           = new_array;
+
+		p_atomic_pointer_set (&worker->array, array);
+	}
+
+	p_atomic_pointer_set (&array->slots[bottom & array->mask], task);
+	p_atomic_pointer_set (&worker->bottom, PSIZE_TO_POINTER (bottom + 1));
+
+	return TRUE;
+}
+
+/* Called by the owner only */
+static PTask *
+pp_task_deque_pop (PTaskWorker *worker)
+{
+	PTaskDequeArray	*array;
+	PTask		*task;
+	psize		top;
+	psize		bottom;
+
+	bottom = worker->bottom - 1;
+	array  = worker->array;
+
+	p_atomic_pointer_set (&worker->bottom, PSIZE_TO_POINTER (bottom));
+
+	top = PPOINTER_TO_PSIZE (p_atomic_pointer_get (&worker->top));
+
+	if ((pssize) (bottom - top) < 0) {
+		p_atomic_pointer_set (&worker->bottom, PSIZE_TO_POINTER (bottom + 1));
+		return NULL;
+	}
+
+	task = p_atomic_pointer_get (&array->slots[bottom & array->mask]);
+
+	if (bottom != top)
+		return task;
+
+	/* The last task, race with the stealers for it */
+	if (p_atomic_pointer_compare_and_exchange (&worker->top,
+						   PSIZE_TO_POINTER (top),
+						   PSIZE_TO_POINTER (top + 1)) == FALSE)
+		task = NULL;
+
+	p_atomic_pointer_set (&worker->bottom, PSIZE_TO_POINTER (bottom + 1));
+
+	return task;
+}
+
+static PTask *
+pp_task_deque_steal (PTaskWorker *worker)
+{
+	PTaskDequeArray	*array;
+	PTask		*task;
+	psize		top;
+	psize		bottom;
+
+	top    = PPOINTER_TO_PSIZE (p_atomic_pointer_get (&worker->top));
+	bottom = PPOINTER_TO_PSIZE (p_atomic_pointer_get (&worker->bottom));
+
+	if ((pssize) (bottom - top) <= 0)
+		return NULL;
+
+	array = p_atomic_pointer_get (&worker->array);
+	task  = p_atomic_pointer_get (&array->slots[top & array->mask]);
+
+	/* Lost the race with another stealer or with the owner */
+	if (p_atomic_pointer_compare_and_exchange (&worker->top,
+						   PSIZE_TO_POINTER (top),
+						   PSIZE_TO_POINTER (top + 1)) == FALSE)
+		return NULL;
+
+	return task;
+}
+
+static pboolean
+pp_task_deque_is_empty (PTaskWorker *worker)
+{
+	psize top;
+	psize bottom;
+
+	top    = PPOINTER_TO_PSIZE (p_atomic_pointer_get (&worker->top));
+	bottom = PPOINTER_TO_PSIZE (p_atomic_pointer_get (&worker->bottom));
+
+	return (pssize) (bottom - top) <= 0;
+}
+
+static void
+pp_task_scheduler_inject (PTaskScheduler	*scheduler,
+			  PTask			*task)
+{
+	p_mutex_lock (scheduler->mutex);
+
+	if (scheduler->injected_last != NULL)
+		scheduler->injected_last->next = task;
+	else
+		scheduler->injected_first = task;
+
+	scheduler->injected_last = task;
+
+	p_atomic_int_inc (&scheduler->n_injected);
+
+	if (p_atomic_int_get (&scheduler->n_parked) > scheduler->n_wakeups) {
+		++scheduler->n_wakeups;
+		p_cond_variable_signal (scheduler->cond);
+	}
+
+	p_mutex_unlock (scheduler->mutex);
+}
+
+static PTask *
+pp_task_scheduler_take_injected (PTaskScheduler *scheduler)
+{
+	PTask *task;
+
+	if (P_LIKELY (p_atomic_int_get (&scheduler->n_injected) == 0))
+		return NULL;
+
+	p_mutex_lock (scheduler->mutex);
+
+	if ((task = scheduler->injected_first) != NULL) {
+		if ((scheduler->injected_first = task->next) == NULL)
+			scheduler->injected_last = NULL;
+
+		p_atomic_int_add (&scheduler->n_injected, -1);
+	}
+
+	p_mutex_unlock (scheduler->mutex);
+
+	return task;
+}
+
+/* Outside threads take only the tasks of the group they sync: any other task
+ * may sync in turn and pick up the next one, so the stack would grow without
+ * bound */
+static PTask *
+pp_task_scheduler_take_injected_group (PTaskScheduler	*scheduler,
+				       PTaskGroup	*group)
+{
+	PTask *task;
+	PTask *prev = NULL;
+
+	if (P_LIKELY (p_atomic_int_get (&scheduler->n_injected) == 0))
+		return NULL;
+
+	p_mutex_lock (scheduler->mutex);
+
+	for (task = scheduler->injected_first; task != NULL; prev = task, task = task->next) {
+		if (task->group != group)
+			continue;
+
+		if (prev != NULL)
+			prev->next = task->next;
+		else
+			scheduler->injected_first = task->next;
+
+		if (scheduler->injected_last == task)
+			scheduler->injected_last = prev;
+
+		p_atomic_int_add (&scheduler->n_injected, -1);
+		break;
+	}
+
+	p_mutex_unlock (scheduler->mutex);
+
+	return task;
+}
+
+static void
+pp_task_scheduler_wake (PTaskScheduler *scheduler)
+{
+	p_mutex_lock (scheduler->mutex);
+
+	if (p_atomic_int_get (&scheduler->n_parked) > scheduler->n_wakeups) {
+		++scheduler->n_wakeups;
+		p_cond_variable_signal (scheduler->cond);
+	}
+
+	p_mutex_unlock (scheduler->mutex);
+}
+
+/* Looks into the own deque, the shared queue and then steals */
+static PTask *
+pp_task_scheduler_find (PTaskScheduler	*scheduler,
+			PTaskWorker	*self,
+			puint32		*seed)
+{
+	PTaskWorker	*victim;
+	PTask		*task;
+	pint		start;
+	pint		i;
+
+	if (self != NULL && (task = pp_task_deque_pop (self)) != NULL)
+		return task;
+
+	if ((task = pp_task_scheduler_take_injected (scheduler)) != NULL)
+		return task;
+
+	/* Xorshift to pick a random victim to start from */
+	*seed ^= *seed << 13;
+	*seed ^= *seed >> 17;
+	*seed ^= *seed << 5;
+
+	start = (pint) (*seed % (puint32) scheduler->n_workers);
+
+	for (i = 0; i < scheduler->n_workers; ++i) {
+		victim = scheduler->workers[(start + i) % scheduler->n_workers];
+
+		if (victim == self)
+			continue;
+
+		if ((task = pp_task_deque_steal (victim)) != NULL)
+			return task;
+	}
+
+	return NULL;
+}
+
+static void
+pp_task_scheduler_run (PTaskScheduler	*scheduler,
+		       PTask		*task)
+{
+	PTaskGroup *group;
+
+	group = task->group;
+
+	task->func (task->data);
+
+	p_mem_pool_release (scheduler->task_pool, task);
+
+	/* The group may be gone right after this */
+	p_atomic_int_add (&group->pending, -1);
+}
+
+static void
+pp_task_scheduler_park (PTaskScheduler *scheduler)
+{
+	pboolean	has_work;
+	pint		i;
+
+	p_mutex_lock (scheduler->mutex);
+
+	p_atomic_int_inc (&scheduler->n_parked);
+
+	has_work = p_atomic_int_get (&scheduler->n_injected) > 0 ||
+		   p_atomic_int_get (&scheduler->is_stopping) != 0;
+
+	for (i = 0; has_work == FALSE && i < scheduler->n_workers; ++i)
+		has_work = !pp_task_deque_is_empty (scheduler->workers[i]);
+
+	if (has_work == FALSE) {
+		p_cond_variable_wait (scheduler->cond, scheduler->mutex);
+
+		/* Spurious wakeups may take a signaled one, it is harmless */
+		if (scheduler->n_wakeups > 0)
+			--scheduler->n_wakeups;
+	}
+
+	p_atomic_int_add (&scheduler->n_parked, -1);
+
+	p_mutex_unlock (scheduler->mutex);
+}
+
+static ppointer
+pp_task_scheduler_worker (ppointer data)
+{
+	PTaskScheduler	*scheduler;
+	PTaskWorker	*worker;
+	PTask		*task;
+	pint		idle = 0;
+
+	worker    = (PTaskWorker *) data;
+	scheduler = worker->scheduler;
+
+	p_uthread_set_static_local (scheduler->worker_key, worker);
+
+	for (;;) {
+		if ((task = pp_task_scheduler_find (scheduler, worker, &worker->seed)) != NULL) {
+			pp_task_scheduler_run (scheduler, task);
+			idle = 0;
+			continue;
+		}
+
+		if (p_atomic_int_get (&scheduler->is_stopping) != 0)
+			break;
+
+		if (++idle < P_TASK_SCHEDULER_SPIN_ROUNDS) {
+			p_uthread_yield ();
+			continue;
+		}
+
+		pp_task_scheduler_park (scheduler);
+		idle = 0;
+	}
+
+	return NULL;
+}
+
+P_LIB_API PTaskScheduler *
+p_task_scheduler_new (pint n_workers)
+{
+	PTaskScheduler	*ret;
+	PTaskWorker	*worker;
+	pint		i;
+
+	if (n_workers <= 0)
+		n_workers = p_uthread_ideal_count ();
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PTaskScheduler))) == NULL)) {
+		P_ERROR ("PTaskScheduler::p_task_scheduler_new: failed to allocate memory");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret->workers = p_malloc0 ((psize) n_workers * sizeof (PTaskWorker *))) == NULL)) {
+		P_ERROR ("PTaskScheduler::p_task_scheduler_new: failed to allocate memory");
+		p_free (ret);
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret->mutex = p_mutex_new ()) == NULL ||
+			(ret->cond = p_cond_variable_new ()) == NULL)) {
+		P_ERROR ("PTaskScheduler::p_task_scheduler_new: failed to allocate synchronization primitives");
+		p_task_scheduler_free (ret);
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret->task_pool = p_mem_pool_new (sizeof (PTask))) == NULL ||
+			(ret->worker_key = p_uthread_static_local_new (NULL)) == NULL)) {
+		P_ERROR ("PTaskScheduler::p_task_scheduler_new: failed to allocate task pool");
+		p_task_scheduler_free (ret);
+		return NULL;
+	}
+
+	for (i = 0; i < n_workers; ++i) {
+		if (P_UNLIKELY ((worker = p_malloc0_aligned (sizeof (PTaskWorker), P_MEM_CACHE_LINE_SIZE)) == NULL ||
+				(worker->array = pp_task_deque_array_new (P_TASK_SCHEDULER_DEQUE_SIZE)) == NULL)) {
+			P_ERROR ("PTaskScheduler::p_task_scheduler_new: failed to allocate memory");
+			p_free_aligned (worker);
+			p_task_scheduler_free (ret);
+			return NULL;
+		}
+
+		worker->scheduler = ret;
+		worker->seed      = (puint32) i * 2654435761U + 1;
+
+		ret->workers[ret->n_workers++] = worker;
+	}
+
+	for (i = 0; i < n_workers; ++i) {
+		if (P_UNLIKELY ((ret->workers[i]->thread = p_uthread_create (pp_task_scheduler_worker,
+									     ret->workers[i],
+									     TRUE,
+									     "p_task_sched")) == NULL)) {
+			P_ERROR ("PTaskScheduler::p_task_scheduler_new: failed to create worker thread");
+			p_task_scheduler_free (ret);
+			return NULL;
+		}
+	}
+
+	return ret;
+}
+
+P_LIB_API pint
+p_task_scheduler_get_worker_count (const PTaskScheduler *scheduler)
+{
+	if (P_UNLIKELY (scheduler == NULL))
+		return 0;
+
+	return scheduler->n_workers;
+}
+
+P_LIB_API void
+p_task_scheduler_free (PTaskScheduler *scheduler)
+{
+	PTaskDequeArray	*array;
+	PTaskWorker	*worker;
+	pint		i;
+
+	if (P_UNLIKELY (scheduler == NULL))
+		return;
+
+	if (scheduler->mutex != NULL && scheduler->cond != NULL) {
+		p_mutex_lock (scheduler->mutex);
+		p_atomic_int_set (&scheduler->is_stopping, 1);
+		p_cond_variable_broadcast (scheduler->cond);
+		p_mutex_unlock (scheduler->mutex);
+	}
+
+	for (i = 0; i < scheduler->n_workers; ++i) {
+		worker = scheduler->workers[i];
+
+		if (worker->thread != NULL) {
+			p_uthread_join (worker->thread);
+			p_uthread_unref (worker->thread);
+		}
+	}
+
+	for (i = 0; i < scheduler->n_workers; ++i) {
+		worker = scheduler->workers[i];
+
+		while ((array = worker->array) != NULL) {
+			worker->array = array->prev;
+			p_free (array);
+		}
+
+		p_free_aligned (worker);
+	}
+
+	if (scheduler->task_pool != NULL)
+		p_mem_pool_free (scheduler->task_pool);
+
+	if (scheduler->worker_key != NULL)
+		p_uthread_static_local_free (scheduler->worker_key);
+
+	if (scheduler->cond != NULL)
+		p_cond_variable_free (scheduler->cond);
+
+	if (scheduler->mutex != NULL)
+		p_mutex_free (scheduler->mutex);
+
+	p_free (scheduler->workers);
+	p_free (scheduler);
+}
+
+P_LIB_API void
+p_task_group_init (PTaskGroup		*group,
+		   PTaskScheduler	*scheduler)
+{
+	if (P_UNLIKELY (group == NULL))
+		return;
+
+	group->scheduler = scheduler;
+	group->pending   = 0;
+}
+
+P_LIB_API pboolean
+p_task_group_spawn (PTaskGroup	*group,
+		    PTaskFunc	func,
+		    ppointer	data)
+{
+	PTaskScheduler	*scheduler;
+	PTaskWorker	*self;
+	PTask		*task;
+
+	if (P_UNLIKELY (group == NULL || group->scheduler == NULL || func == NULL))
+		return FALSE;
+
+	scheduler = group->scheduler;
+
+	if (P_UNLIKELY ((task = p_mem_pool_alloc (scheduler->task_pool)) == NULL)) {
+		func (data);
+		return TRUE;
+	}
+
+	task->next  = NULL;
+	task->func  = func;
+	task->data  = data;
+	task->group = group;
+
+	p_atomic_int_inc (&group->pending);
+
+	self = p_uthread_get_static_local (scheduler->worker_key);
+
+	if (self == NULL || P_UNLIKELY (pp_task_deque_push (self, task) == FALSE))
+		pp_task_scheduler_inject (scheduler, task);
+	else if (p_atomic_int_get (&scheduler->n_parked) > 0)
+		pp_task_scheduler_wake (scheduler);
+
+	return TRUE;
+}
+
+P_LIB_API void
+p_task_group_sync (PTaskGroup *group)
+{
+	PTaskScheduler	*scheduler;
+	PTaskWorker	*self;
+	PTask		*task;
+
+	if (P_UNLIKELY (group == NULL || group->scheduler == NULL))
+		return;
+
+	scheduler = group->scheduler;
+	self      = p_uthread_get_static_local (scheduler->worker_key);
+
+	while (p_atomic_int_get (&group->pending) > 0) {
+		if (self != NULL)
+			task = pp_task_scheduler_find (scheduler, self, &self->seed);
+		else
+			task = pp_task_scheduler_take_injected_group (scheduler, group);
+
+		if (task != NULL)
+			pp_task_scheduler_run (scheduler, task);
+		else
+			p_uthread_yield ();
+	}
+}
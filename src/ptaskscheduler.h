@@ -0,0 +1,168 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file ptaskscheduler.h
+ * @brief Work-stealing task scheduler
+ * @author Alexander Saprykin
+ *
+ * A task scheduler runs fork/join parallel code: a task spawns subtasks into a
+ * #PTaskGroup with p_task_group_spawn() and waits for them with
+ * p_task_group_sync(), the subtasks may spawn and sync their own groups. This
+ * suits recursive algorithms (sorting, tree and index builds) where a
+ * #PThreadPool would serialize on its single queue.
+ *
+ * Every worker thread owns a Chase-Lev deque. A worker pushes and pops the
+ * tasks it spawns at the bottom of its own deque without any lock, so the most
+ * recently spawned (and usually cache-hot) task runs first. A worker without
+ * tasks steals the oldest task from the top of the deque of a random victim;
+ * old tasks tend to be the large ones near the root of the recursion, so a
+ * steal brings a lot of work. Idle workers spin for a while looking for tasks
+ * and then park until something is spawned.
+ *
+ * A thread waiting in p_task_group_sync() doesn't block: it runs tasks from
+ * its deque or steals them until the group is done. Tasks spawned by threads
+ * which are not workers of the scheduler go to a shared queue. Such a thread
+ * runs only the queued tasks of the group it syncs, so its stack stays as deep
+ * as the recursion.
+ *
+ * A group lives on the stack of the spawning function and needs no
+ * allocation, tasks are allocated from a #PMemPool. Example of a recursive
+ * sum:
+ * @code
+ * static void sum_task (ppointer data)
+ * {
+ *	SumRange	*range = data;
+ *	SumRange	left, right;
+ *	PTaskGroup	group;
+ *
+ *	if (range->end - range->begin < CUTOFF) {
+ *		range->sum = sum_sequential (range);
+ *		return;
+ *	}
+ *
+ *	split_range (range, &left, &right);
+ *
+ *	p_task_group_init (&group, range->scheduler);
+ *	p_task_group_spawn (&group, sum_task, &left);
+ *	sum_task (&right);
+ *	p_task_group_sync (&group);
+ *
+ *	range->sum = left.sum + right.sum;
+ * }
+ * @endcode
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PTASKSCHEDULER_H
+#define PLIBSYS_HEADER_PTASKSCHEDULER_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+
+P_BEGIN_DECLS
+
+/** Typedef for a #PTaskScheduler task function. */
+typedef void (*PTaskFunc) (ppointer data);
+
+/** Task scheduler opaque data type. */
+typedef struct PTaskScheduler_ PTaskScheduler;
+
+/** Group of spawned tasks, the fields are private. */
+typedef struct PTaskGroup_ {
+	PTaskScheduler	*scheduler;	/**< Scheduler to spawn the tasks in.	*/
+	volatile pint	pending;	/**< Number of unfinished tasks.	*/
+} PTaskGroup;
+
+/**
+ * @brief Creates a new task scheduler and starts its workers.
+ * @param n_workers Number of worker threads, 0 or less to use
+ * p_uthread_ideal_count().
+ * @return Pointer to #PTaskScheduler in case of success, NULL otherwise.
+ * @since 0.0.5
+ *
+ * Each scheduler takes two TLS keys (for the workers and the task pool), so
+ * schedulers are meant to be long-living objects.
+ */
+P_LIB_API PTaskScheduler *	p_task_scheduler_new		(pint			n_workers);
+
+/**
+ * @brief Gets the number of worker threads of a task scheduler.
+ * @param scheduler #PTaskScheduler to get the number for.
+ * @return Number of worker threads.
+ * @since 0.0.5
+ */
+P_LIB_API pint			p_task_scheduler_get_worker_count (const PTaskScheduler *scheduler);
+
+/**
+ * @brief Frees a task scheduler and joins its workers.
+ * @param scheduler #PTaskScheduler to free.
+ * @since 0.0.5
+ *
+ * All the groups of the scheduler must be synced before.
+ */
+P_LIB_API void			p_task_scheduler_free		(PTaskScheduler		*scheduler);
+
+/**
+ * @brief Initializes a task group.
+ * @param group #PTaskGroup to initialize.
+ * @param scheduler #PTaskScheduler to run the tasks of the group in.
+ * @since 0.0.5
+ */
+P_LIB_API void			p_task_group_init		(PTaskGroup		*group,
+								 PTaskScheduler		*scheduler);
+
+/**
+ * @brief Spawns a task in a group.
+ * @param group #PTaskGroup to spawn the task in.
+ * @param func Task function.
+ * @param data Pointer to pass into @a func, may be NULL.
+ * @return TRUE in case of success, FALSE in case of invalid input.
+ * @since 0.0.5
+ *
+ * The task may start right away on another worker, or later in
+ * p_task_group_sync(). If there is no memory for the task it is run by the
+ * caller before returning.
+ */
+P_LIB_API pboolean		p_task_group_spawn		(PTaskGroup		*group,
+								 PTaskFunc		func,
+								 ppointer		data);
+
+/**
+ * @brief Waits until all the tasks of a group have finished.
+ * @param group #PTaskGroup to wait for.
+ * @since 0.0.5
+ *
+ * The caller runs other tasks of the scheduler while waiting. The group can be
+ * reused for spawning after this call.
+ */
+P_LIB_API void			p_task_group_sync		(PTaskGroup		*group);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PTASKSCHEDULER_H */
@@ -0,0 +1,798 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Each queue is a ring buffer with the power of two capacity, it grows when
+ * full and never shrinks. Parked workers are counted along with the wakeups
+ * which have been signaled but not consumed yet: a worker is woken only when
+ * there are more parked workers than wakeups in flight. A spurious wakeup may
+ * consume a pending one, which only costs an extra signal later.
+ *
+ * A regular pool has a single queue. A NUMA pool has a queue per node with
+ * its own lock, the workers of a node take tasks from their queue first and
+ * then steal from the other nodes, the nodes of the same package first. A
+ * push which finds no parked worker on its node wakes a parked one on the
+ * nearest other node, so it can steal. Only one lock is held at a time.
+ *
+ * Queued and running tasks are counted together in a single atomic counter.
+ * The worker which brings it down to zero wakes the waiters under the pool
+ * mutex, so the waiters can check it under the same mutex. */
+
+#include "patomic.h"
+#include "pcputopology.h"
+#include "pmem.h"
+#include "pthreadpool.h"
+#include "pmutex.h"
+#include "pcondvariable.h"
+#include "puthread.h"
+
+#define P_THREAD_POOL_INITIAL_CAPACITY	256
+#define P_THREAD_POOL_BATCH_SIZE	32
+#define P_THREAD_POOL_STEAL_SIZE	8
+
+typedef struct PThreadPoolTask_ {
+	PThreadPoolFunc	func;
+	ppointer	data;
+} PThreadPoolTask;
+
+/* Nodes are written by their workers all the time, keep them on separate cache
+ * lines */
+typedef struct PThreadPoolNode_ {
+	P_CACHE_ALIGNED PMutex	*mutex;
+	PCondVariable	*work_cond;
+	PThreadPoolTask	*tasks;
+	psize		capacity;
+	psize		head;
+	psize		count;
+	pint		n_workers;
+	pint		n_parked;
+	pint		n_wakeups;
+	pint		numa_node;
+	pint		*victims;
+	PUThreadCpuSet	cpu_set;
+	pboolean	is_stopping;
+} PThreadPoolNode;
+
+typedef struct PThreadPoolWorker_ {
+	PThreadPool	*pool;
+	PThreadPoolNode	*node;
+	PUThread	*thread;
+	PMemArena	*arena;
+} PThreadPoolWorker;
+
+struct PThreadPool_ {
+	PMutex			*mutex;
+	PCondVariable		*idle_cond;
+	PUThreadStaticKey	*worker_key;
+	PCpuTopology		*topology;
+	PThreadPoolNode		*nodes;
+	PThreadPoolWorker	*workers;
+	volatile psize		n_pending;
+	volatile pint		n_idle;
+	volatile pint		next_node;
+	pint			n_nodes;
+	pint			n_workers;
+	pboolean		is_numa;
+	pboolean		is_stopping;
+};
+
+static void pp_thread_pool_wake (PThreadPoolNode *node);
+static void pp_thread_pool_wake_nearest (PThreadPool *pool, PThreadPoolNode *node);
+static pboolean pp_thread_pool_grow (PThreadPoolNode *node);
+static psize pp_thread_pool_take (PThreadPoolNode *node, psize n_max, PThreadPoolTask *batch);
+static void pp_thread_pool_run (PThreadPool *pool, PThreadPoolTask *batch, psize n_batch);
+static psize pp_thread_pool_steal (PThreadPool *pool, PThreadPoolNode *node, PThreadPoolTask *batch);
+static ppointer pp_thread_pool_worker (ppointer data);
+static PThreadPoolNode * pp_thread_pool_find_node (PThreadPool *pool, pint numa_node);
+static pboolean pp_thread_pool_push_node (PThreadPool *pool, PThreadPoolNode *node, PThreadPoolFunc func, ppointer data);
+static pboolean pp_thread_pool_setup_numa (PThreadPool *pool, pint n_workers);
+static PThreadPool * pp_thread_pool_new (pint n_workers, pboolean numa);
+static void pp_thread_pool_destroy (PThreadPool *pool);
+
+/* Called with the node locked */
+static void
+pp_thread_pool_wake (PThreadPoolNode *node)
+{
+	if (node->n_parked > node->n_wakeups) {
+		++node->n_wakeups;
+		p_cond_variable_signal (node->work_cond);
+	}
+}
+
+/* Called with no node locked */
+static void
+pp_thread_pool_wake_nearest (PThreadPool	*pool,
+			     PThreadPoolNode	*node)
+{
+	PThreadPoolNode	*victim;
+	pboolean	is_woken = FALSE;
+	pint		i;
+
+	for (i = 0; i < pool->n_nodes - 1 && is_woken == FALSE; ++i) {
+		if (p_atomic_int_get (&pool->n_idle) == 0)
+			return;
+
+		victim = &pool->nodes[node->victims[i]];
+
+		p_mutex_lock (victim->mutex);
+
+		if (victim->n_parked > victim->n_wakeups) {
+			pp_thread_pool_wake (victim);
+			is_woken = TRUE;
+		}
+
+		p_mutex_unlock (victim->mutex);
+	}
+}
+
+/* Called with the node locked */
+static pboolean
+pp_thread_pool_grow (PThreadPoolNode *node)
+{
+	PThreadPoolTask	*tasks;
+	psize		capacity;
+	psize		i;
+
+	capacity = node->capacity * 2;
+
+	if (P_UNLIKELY (capacity < node->capacity))
+		return FALSE;
+
+	if (P_UNLIKELY ((tasks = p_malloc (capacity * sizeof (PThreadPoolTask))) == NULL))
+		return FALSE;
+
+	for (i = 0; i < node->count; ++i)
+		tasks[i] = node->tasks[(node->head + i) & (node->capacity - 1)];
+
+	p_free (node->tasks);
+
+	node->tasks    = tasks;
+	node->capacity = capacity;
+	node->head     = 0;
+
+	return TRUE;
+}
+
+/* Called with the node locked */
+static psize
+pp_thread_pool_take (PThreadPoolNode	*node,
+		     psize		n_max,
+		     PThreadPoolTask	*batch)
+{
+	psize n_batch;
+	psize i;
+
+	n_batch = node->count < n_max ? node->count : n_max;
+
+	for (i = 0; i < n_batch; ++i)
+		batch[i] = node->tasks[(node->head + i) & (node->capacity - 1)];
+
+	node->head   = (node->head + n_batch) & (node->capacity - 1);
+	node->count -= n_batch;
+
+	return n_batch;
+}
+
+static void
+pp_thread_pool_run (PThreadPool		*pool,
+		    PThreadPoolTask	*batch,
+		    psize		n_batch)
+{
+	psize i;
+
+	for (i = 0; i < n_batch; ++i)
+		batch[i].func (batch[i].data);
+
+	if ((psize) p_atomic_pointer_add (&pool->n_pending, -((pssize) n_batch)) == n_batch) {
+		p_mutex_lock (pool->mutex);
+		p_cond_variable_broadcast (pool->idle_cond);
+		p_mutex_unlock (pool->mutex);
+	}
+}
+
+/* Called with no node locked */
+static psize
+pp_thread_pool_steal (PThreadPool	*pool,
+		      PThreadPoolNode	*node,
+		      PThreadPoolTask	*batch)
+{
+	PThreadPoolNode	*victim;
+	psize		n_batch;
+	pint		i;
+
+	for (i = 0; i < pool->n_nodes - 1; ++i) {
+		victim = &pool->nodes[node->victims[i]];
+
+		p_mutex_lock (victim->mutex);
+
+		/* Leave most of the work to the owners, their data is local */
+		n_batch = pp_thread_pool_take (victim,
+					       victim->count / 2 + 1 < P_THREAD_POOL_STEAL_SIZE ?
+					       victim->count / 2 + 1 : P_THREAD_POOL_STEAL_SIZE,
+					       batch);
+
+		p_mutex_unlock (victim->mutex);
+
+		if (n_batch > 0)
+			return n_batch;
+	}
+
+	return 0;
+}
+
+static ppointer
+pp_thread_pool_worker (ppointer data)
+{
+	PThreadPool		*pool;
+	PThreadPoolWorker	*worker;
+	PThreadPoolNode		*node;
+	PThreadPoolTask		batch[P_THREAD_POOL_BATCH_SIZE];
+	psize			n_batch;
+
+	worker = (PThreadPoolWorker *) data;
+	pool   = worker->pool;
+	node   = worker->node;
+
+	/* Pages of the local arena are placed by the first touch, so pin first */
+	if (pool->is_numa == TRUE) {
+		p_uthread_set_static_local (pool->worker_key, worker);
+		p_uthread_set_affinity (p_uthread_current (), &node->cpu_set);
+	}
+
+	p_mutex_lock (node->mutex);
+
+	for (;;) {
+		if (node->count > 0) {
+			/* Take a fair share to leave some work for the others */
+			n_batch = pp_thread_pool_take (node,
+						       node->count / (psize) node->n_workers + 1 < P_THREAD_POOL_BATCH_SIZE ?
+						       node->count / (psize) node->n_workers + 1 : P_THREAD_POOL_BATCH_SIZE,
+						       batch);
+
+			/* Pass the rest of the work to a parked worker */
+			if (node->count > 0)
+				pp_thread_pool_wake (node);
+
+			p_mutex_unlock (node->mutex);
+
+			pp_thread_pool_run (pool, batch, n_batch);
+
+			p_mutex_lock (node->mutex);
+			continue;
+		}
+
+		if (node->is_stopping == TRUE)
+			break;
+
+		if (pool->n_nodes > 1) {
+			p_mutex_unlock (node->mutex);
+
+			n_batch = pp_thread_pool_steal (pool, node, batch);
+
+			if (n_batch > 0)
+				pp_thread_pool_run (pool, batch, n_batch);
+
+			p_mutex_lock (node->mutex);
+
+			if (n_batch > 0 || node->count > 0 || node->is_stopping == TRUE)
+				continue;
+		}
+
+		++node->n_parked;
+		p_atomic_int_inc (&pool->n_idle);
+
+		p_cond_variable_wait (node->work_cond, node->mutex);
+
+		p_atomic_int_add (&pool->n_idle, -1);
+		--node->n_parked;
+
+		if (node->n_wakeups > 0)
+			--node->n_wakeups;
+	}
+
+	p_mutex_unlock (node->mutex);
+
+	return NULL;
+}
+
+static PThreadPoolNode *
+pp_thread_pool_find_node (PThreadPool	*pool,
+			  pint		numa_node)
+{
+	pint i;
+
+	for (i = 0; i < pool->n_nodes; ++i)
+		if (pool->nodes[i].numa_node == numa_node)
+			return &pool->nodes[i];
+
+	return NULL;
+}
+
+static pboolean
+pp_thread_pool_push_node (PThreadPool		*pool,
+			  PThreadPoolNode	*node,
+			  PThreadPoolFunc	func,
+			  ppointer		data)
+{
+	PThreadPoolTask	*task;
+	pboolean	is_woken;
+
+	p_mutex_lock (node->mutex);
+
+	if (P_UNLIKELY (node->is_stopping == TRUE ||
+			(node->count == node->capacity && pp_thread_pool_grow (node) == FALSE))) {
+		p_mutex_unlock (node->mutex);
+		return FALSE;
+	}
+
+	task       = &node->tasks[(node->head + node->count) & (node->capacity - 1)];
+	task->func = func;
+	task->data = data;
+
+	++node->count;
+
+	p_atomic_pointer_add (&pool->n_pending, 1);
+
+	is_woken = node->n_parked > node->n_wakeups ? TRUE : FALSE;
+
+	pp_thread_pool_wake (node);
+
+	p_mutex_unlock (node->mutex);
+
+	/* All the workers of the node are busy, let an idle neighbour steal */
+	if (is_woken == FALSE && pool->n_nodes > 1 && p_atomic_int_get (&pool->n_idle) > 0)
+		pp_thread_pool_wake_nearest (pool, node);
+
+	return TRUE;
+}
+
+static pboolean
+pp_thread_pool_setup_numa (PThreadPool	*pool,
+			   pint		n_workers)
+{
+	PUThreadCpuSet	cpu_set;
+	PThreadPoolNode	*node;
+	pint		n_cpus;
+	pint		n_assigned;
+	pint		package;
+	pint		numa_node;
+	pint		cpu;
+	pint		i;
+	pint		j;
+	pint		k;
+
+	if (P_UNLIKELY ((pool->topology = p_cpu_topology_new ()) == NULL))
+		return FALSE;
+
+	n_cpus = p_cpu_topology_get_cpu_count (pool->topology);
+
+	if (n_workers <= 0)
+		n_workers = n_cpus;
+
+	if (P_UNLIKELY ((pool->nodes = p_malloc0_aligned ((psize) p_cpu_topology_get_numa_node_count (pool->topology) *
+							  sizeof (PThreadPoolNode),
+							  P_CACHE_LINE_SIZE)) == NULL))
+		return FALSE;
+
+	/* Workers are shared among the nodes in proportion to their CPUs */
+	n_assigned = 0;
+
+	for (numa_node = 0; numa_node < P_UTHREAD_CPU_SET_SIZE; ++numa_node) {
+		if (p_cpu_topology_get_numa_node_cpus (pool->topology, numa_node, &cpu_set) == FALSE)
+			continue;
+
+		node            = &pool->nodes[pool->n_nodes++];
+		node->numa_node = numa_node;
+		node->cpu_set   = cpu_set;
+		node->n_workers = (pint) ((pint64) n_workers * p_uthread_cpu_set_count (&cpu_set) / n_cpus);
+
+		n_assigned += node->n_workers;
+
+		if (pool->n_nodes == p_cpu_topology_get_numa_node_count (pool->topology))
+			break;
+	}
+
+	for (i = 0; n_assigned < n_workers; i = (i + 1) % pool->n_nodes, ++n_assigned)
+		++pool->nodes[i].n_workers;
+
+	for (i = 0; i < pool->n_nodes; ++i) {
+		node = &pool->nodes[i];
+
+		if (node->n_workers == 0)
+			node->n_workers = 1;
+
+		if (P_UNLIKELY ((node->victims = p_malloc0 ((psize) pool->n_nodes * sizeof (pint))) == NULL))
+			return FALSE;
+
+		for (cpu = 0; p_uthread_cpu_set_contains (&node->cpu_set, cpu) == FALSE; ++cpu)
+			;
+
+		package = p_cpu_topology_get_cpu_package (pool->topology, cpu);
+
+		/* Victims on the same package go first, the farther ones after */
+		for (k = 0, j = 1; j < pool->n_nodes; ++j) {
+			for (cpu = 0; p_uthread_cpu_set_contains (&pool->nodes[(i + j) % pool->n_nodes].cpu_set, cpu) == FALSE; ++cpu)
+				;
+
+			if (p_cpu_topology_get_cpu_package (pool->topology, cpu) == package)
+				node->victims[k++] = (i + j) % pool->n_nodes;
+		}
+
+		for (j = 1; j < pool->n_nodes; ++j) {
+			for (cpu = 0; p_uthread_cpu_set_contains (&pool->nodes[(i + j) % pool->n_nodes].cpu_set, cpu) == FALSE; ++cpu)
+				;
+
+			if (p_cpu_topology_get_cpu_package (pool->topology, cpu) != package)
+				node->victims[k++] = (i + j) % pool->n_nodes;
+		}
+	}
+
+	return TRUE;
+}
+
+static PThreadPool *
+pp_thread_pool_new (pint	n_workers,
+		    pboolean	numa)
+{
+	PThreadPool	*ret;
+	PThreadPoolNode	*node;
+	pint		i;
+	pint		j;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PThreadPool))) == NULL)) {
+		P_ERROR ("PThreadPool::p_thread_pool_new: failed to allocate memory");
+		return NULL;
+	}
+
+	ret->is_numa = numa;
+
+	if (numa == TRUE) {
+		if (P_UNLIKELY (pp_thread_pool_setup_numa (ret, n_workers) == FALSE)) {
+			P_ERROR ("PThreadPool::p_thread_pool_new: failed to allocate memory");
+			pp_thread_pool_destroy (ret);
+			return NULL;
+		}
+	} else {
+		if (n_workers <= 0)
+			n_workers = p_uthread_ideal_count ();
+
+		if (P_UNLIKELY ((ret->nodes = p_malloc0_aligned (sizeof (PThreadPoolNode), P_CACHE_LINE_SIZE)) == NULL)) {
+			P_ERROR ("PThreadPool::p_thread_pool_new: failed to allocate memory");
+			pp_thread_pool_destroy (ret);
+			return NULL;
+		}
+
+		ret->n_nodes            = 1;
+		ret->nodes[0].n_workers = n_workers;
+		ret->nodes[0].numa_node = -1;
+	}
+
+	if (P_UNLIKELY ((ret->mutex = p_mutex_new ()) == NULL)) {
+		P_ERROR ("PThreadPool::p_thread_pool_new: failed to allocate mutex");
+		pp_thread_pool_destroy (ret);
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret->idle_cond = p_cond_variable_new ()) == NULL)) {
+		P_ERROR ("PThreadPool::p_thread_pool_new: failed to allocate condition variable");
+		pp_thread_pool_destroy (ret);
+		return NULL;
+	}
+
+	if (P_UNLIKELY (numa == TRUE && (ret->worker_key = p_uthread_static_local_new (NULL)) == NULL)) {
+		P_ERROR ("PThreadPool::p_thread_pool_new: failed to allocate TLS key");
+		pp_thread_pool_destroy (ret);
+		return NULL;
+	}
+
+	for (i = 0, n_workers = 0; i < ret->n_nodes; ++i) {
+		node           = &ret->nodes[i];
+		node->capacity = P_THREAD_POOL_INITIAL_CAPACITY;
+		n_workers     += node->n_workers;
+
+		if (P_UNLIKELY ((node->mutex = p_mutex_new ()) == NULL)) {
+			P_ERROR ("PThreadPool::p_thread_pool_new: failed to allocate mutex");
+			pp_thread_pool_destroy (ret);
+			return NULL;
+		}
+
+		if (P_UNLIKELY ((node->work_cond = p_cond_variable_new ()) == NULL)) {
+			P_ERROR ("PThreadPool::p_thread_pool_new: failed to allocate condition variable");
+			pp_thread_pool_destroy (ret);
+			return NULL;
+		}
+
+		if (P_UNLIKELY ((node->tasks = p_malloc (node->capacity * sizeof (PThreadPoolTask))) == NULL)) {
+			P_ERROR ("PThreadPool::p_thread_pool_new: failed to allocate memory");
+			pp_thread_pool_destroy (ret);
+			return NULL;
+		}
+	}
+
+	if (P_UNLIKELY ((ret->workers = p_malloc0 ((psize) n_workers * sizeof (PThreadPoolWorker))) == NULL)) {
+		P_ERROR ("PThreadPool::p_thread_pool_new: failed to allocate memory");
+		pp_thread_pool_destroy (ret);
+		return NULL;
+	}
+
+	for (i = 0; i < ret->n_nodes; ++i) {
+		for (j = 0; j < ret->nodes[i].n_workers; ++j) {
+			ret->workers[ret->n_workers].pool = ret;
+			ret->workers[ret->n_workers].node = &ret->nodes[i];
+
+			if (P_UNLIKELY ((ret->workers[ret->n_workers].thread =
+						p_uthread_create (pp_thread_pool_worker,
+								  &ret->workers[ret->n_workers],
+								  TRUE,
+								  "p_thread_pool")) == NULL)) {
+				P_ERROR ("PThreadPool::p_thread_pool_new: failed to create worker thread");
+				p_thread_pool_free (ret);
+				return NULL;
+			}
+
+			++ret->n_workers;
+		}
+	}
+
+	return ret;
+}
+
+static void
+pp_thread_pool_destroy (PThreadPool *pool)
+{
+	PThreadPoolNode	*node;
+	pint		i;
+
+	for (i = 0; i < pool->n_workers; ++i)
+		p_mem_arena_free (pool->workers[i].arena);
+
+	for (i = 0; pool->nodes != NULL && i < pool->n_nodes; ++i) {
+		node = &pool->nodes[i];
+
+		if (node->work_cond != NULL)
+			p_cond_variable_free (node->work_cond);
+
+		if (node->mutex != NULL)
+			p_mutex_free (node->mutex);
+
+		p_free (node->tasks);
+		p_free (node->victims);
+	}
+
+	if (pool->worker_key != NULL)
+		p_uthread_static_local_free (pool->worker_key);
+
+	if (pool->idle_cond != NULL)
+		p_cond_variable_free (pool->idle_cond);
+
+	if (pool->mutex != NULL)
+		p_mutex_free (pool->mutex);
+
+	p_cpu_topology_free (pool->topology);
+
+	p_free (pool->workers);
+	p_free_aligned (pool->nodes);
+	p_free (pool);
+}
+
+P_LIB_API PThreadPool *
+p_thread_pool_new (pint n_workers)
+{
+	return pp_thread_pool_new (n_workers, FALSE);
+}
+
+P_LIB_API PThreadPool *
+p_thread_pool_new_numa (pint n_workers)
+{
+	return pp_thread_pool_new (n_workers, TRUE);
+}
+
+P_LIB_API pboolean
+p_thread_pool_push (PThreadPool		*pool,
+		    PThreadPoolFunc	func,
+		    ppointer		data)
+{
+	PThreadPoolWorker	*worker;
+	PThreadPoolNode		*node = NULL;
+	pint			cpu;
+
+	if (P_UNLIKELY (pool == NULL || func == NULL))
+		return FALSE;
+
+	if (pool->n_nodes == 1)
+		return pp_thread_pool_push_node (pool, &pool->nodes[0], func, data);
+
+	/* Workers keep their tasks local, other threads use the node they run on */
+	if ((worker = p_uthread_get_static_local (pool->worker_key)) != NULL && worker->pool == pool)
+		node = worker->node;
+	else if ((cpu = p_uthread_current_cpu ()) >= 0)
+		node = pp_thread_pool_find_node (pool, p_cpu_topology_get_cpu_numa_node (pool->topology, cpu));
+
+	if (node == NULL)
+		node = &pool->nodes[(puint) p_atomic_int_add (&pool->next_node, 1) % (puint) pool->n_nodes];
+
+	return pp_thread_pool_push_node (pool, node, func, data);
+}
+
+P_LIB_API pboolean
+p_thread_pool_push_to_node (PThreadPool		*pool,
+			    pint		numa_node,
+			    PThreadPoolFunc	func,
+			    ppointer		data)
+{
+	PThreadPoolNode *node;
+
+	if (P_UNLIKELY (pool == NULL || func == NULL))
+		return FALSE;
+
+	if ((node = pp_thread_pool_find_node (pool, numa_node)) == NULL)
+		return p_thread_pool_push (pool, func, data);
+
+	return pp_thread_pool_push_node (pool, node, func, data);
+}
+
+P_LIB_API void
+p_thread_pool_wait (PThreadPool *pool)
+{
+	if (P_UNLIKELY (pool == NULL))
+		return;
+
+	p_mutex_lock (pool->mutex);
+
+	while ((psize) p_atomic_pointer_get (&pool->n_pending) > 0)
+		p_cond_variable_wait (pool->idle_cond, pool->mutex);
+
+	p_mutex_unlock (pool->mutex);
+}
+
+P_LIB_API void
+p_thread_pool_shutdown (PThreadPool	*pool,
+			pboolean	drain)
+{
+	PThreadPoolNode	*node;
+	psize		n_dropped;
+	pint		i;
+
+	if (P_UNLIKELY (pool == NULL))
+		return;
+
+	p_mutex_lock (pool->mutex);
+
+	if (pool->is_stopping == TRUE) {
+		p_mutex_unlock (pool->mutex);
+		return;
+	}
+
+	pool->is_stopping = TRUE;
+
+	p_mutex_unlock (pool->mutex);
+
+	for (i = 0; i < pool->n_nodes; ++i) {
+		node = &pool->nodes[i];
+
+		p_mutex_lock (node->mutex);
+
+		node->is_stopping = TRUE;
+		n_dropped         = drain == FALSE ? node->count : 0;
+
+		if (drain == FALSE)
+			node->count = 0;
+
+		p_cond_variable_broadcast (node->work_cond);
+
+		p_mutex_unlock (node->mutex);
+
+		/* Dropped tasks may leave somebody waiting for the pool */
+		if (n_dropped > 0 &&
+		    (psize) p_atomic_pointer_add (&pool->n_pending, -((pssize) n_dropped)) == n_dropped) {
+			p_mutex_lock (pool->mutex);
+			p_cond_variable_broadcast (pool->idle_cond);
+			p_mutex_unlock (pool->mutex);
+		}
+	}
+
+	for (i = 0; i < pool->n_workers; ++i) {
+		p_uthread_join (pool->workers[i].thread);
+		p_uthread_unref (pool->workers[i].thread);
+		pool->workers[i].thread = NULL;
+	}
+}
+
+P_LIB_API pint
+p_thread_pool_get_worker_count (const PThreadPool *pool)
+{
+	if (P_UNLIKELY (pool == NULL))
+		return 0;
+
+	return pool->n_workers;
+}
+
+P_LIB_API pint
+p_thread_pool_get_node_count (const PThreadPool *pool)
+{
+	if (P_UNLIKELY (pool == NULL))
+		return 0;
+
+	return pool->n_nodes;
+}
+
+P_LIB_API pint
+p_thread_pool_get_current_node (const PThreadPool *pool)
+{
+	PThreadPoolWorker *worker;
+
+	if (P_UNLIKELY (pool == NULL) || pool->is_numa == FALSE)
+		return -1;
+
+	if ((worker = p_uthread_get_static_local (pool->worker_key)) == NULL || worker->pool != pool)
+		return -1;
+
+	return worker->node->numa_node;
+}
+
+P_LIB_API PMemArena *
+p_thread_pool_get_local_arena (PThreadPool *pool)
+{
+	PThreadPoolWorker *worker;
+
+	if (P_UNLIKELY (pool == NULL) || pool->is_numa == FALSE)
+		return NULL;
+
+	if ((worker = p_uthread_get_static_local (pool->worker_key)) == NULL || worker->pool != pool)
+		return NULL;
+
+	/* The chunks are mapped on demand and touched by this worker first */
+	if (worker->arena == NULL)
+		worker->arena = p_mem_arena_new (0, TRUE);
+
+	return worker->arena;
+}
+
+P_LIB_API psize
+p_thread_pool_get_pending_count (PThreadPool *pool)
+{
+	psize	ret = 0;
+	pint	i;
+
+	if (P_UNLIKELY (pool == NULL))
+		return 0;
+
+	for (i = 0; i < pool->n_nodes; ++i) {
+		p_mutex_lock (pool->nodes[i].mutex);
+		ret += pool->nodes[i].count;
+		p_mutex_unlock (pool->nodes[i].mutex);
+	}
+
+	return ret;
+}
+
+P_LIB_API void
+p_thread_pool_free (PThreadPool *pool)
+{
+	if (P_UNLIKELY (pool == NULL))
+		return;
+
+	p_thread_pool_shutdown (pool, TRUE);
+	pp_thread_pool_destroy (pool);
+}
@@ -0,0 +1,220 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pthreadpool.h
+ * @brief Thread pool
+ * @author Alexander Saprykin
+ *
+ * A thread pool runs short tasks on a fixed set of worker threads, so the cost
+ * of creating and joining a thread is paid once per worker instead of once per
+ * task. A task is a function with a data pointer pushed into the pool with
+ * p_thread_pool_push(), the tasks are started in the order they were pushed.
+ *
+ * The workers share a single task queue guarded by a mutex. A worker takes a
+ * batch of tasks per lock acquisition (a fair share of the queue, limited to a
+ * few dozens of tasks), so the lock is not touched for each tiny task. Idle
+ * workers park on a condition variable, and a push wakes a parked worker only
+ * if there is no wakeup in flight already, so pushing into a busy pool never
+ * makes a system call.
+ *
+ * A pool created with p_thread_pool_new_numa() keeps a queue per NUMA node
+ * (see #PCpuTopology) and pins the workers of each node to its CPUs, so the
+ * tasks run close to the memory they were pushed for. A push from a worker
+ * goes to the queue of its node, a push from another thread goes to the node
+ * it runs on, p_thread_pool_push_to_node() picks the node explicitly. A worker
+ * without local tasks steals a few tasks from the other nodes, the ones on the
+ * same package first, before parking. Tasks may allocate node-local scratch
+ * memory from p_thread_pool_get_local_arena().
+ *
+ * p_thread_pool_wait() blocks until all the pushed tasks have finished, the
+ * pool stays usable after that. p_thread_pool_shutdown() stops the pool either
+ * running the queued tasks (drain) or dropping them, and joins the workers.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PTHREADPOOL_H
+#define PLIBSYS_HEADER_PTHREADPOOL_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+#include "pmem.h"
+
+P_BEGIN_DECLS
+
+/** Typedef for a #PThreadPool task function. */
+typedef void (*PThreadPoolFunc) (ppointer data);
+
+/** Thread pool opaque data type. */
+typedef struct PThreadPool_ PThreadPool;
+
+/**
+ * @brief Creates a new thread pool and starts its workers.
+ * @param n_workers Number of worker threads, 0 or less to use
+ * p_uthread_ideal_count().
+ * @return Pointer to #PThreadPool in case of success, NULL otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API PThreadPool *	p_thread_pool_new		(pint		n_workers);
+
+/**
+ * @brief Creates a new NUMA-aware thread pool and starts its workers.
+ * @param n_workers Total number of worker threads, 0 or less to use one per
+ * logical CPU.
+ * @return Pointer to #PThreadPool in case of success, NULL otherwise.
+ * @since 0.0.5
+ *
+ * The workers are shared among the NUMA nodes in proportion to the number of
+ * their CPUs, every node gets at least one worker, so there may be more
+ * workers than requested. Each worker is pinned to the CPUs of its node where
+ * the affinity is supported. On a system with a single node the pool works
+ * like the one from p_thread_pool_new().
+ */
+P_LIB_API PThreadPool *	p_thread_pool_new_numa		(pint		n_workers);
+
+/**
+ * @brief Pushes a task into a thread pool.
+ * @param pool #PThreadPool to push the task into.
+ * @param func Task function.
+ * @param data Pointer to pass into @a func, may be NULL.
+ * @return TRUE in case of success, FALSE if the pool is shutting down or there
+ * is no memory to grow the queue.
+ * @since 0.0.5
+ *
+ * Can be called from any thread, including the workers of the same pool.
+ */
+P_LIB_API pboolean	p_thread_pool_push		(PThreadPool	*pool,
+							 PThreadPoolFunc	func,
+							 ppointer	data);
+
+/**
+ * @brief Pushes a task into the queue of a given NUMA node.
+ * @param pool #PThreadPool to push the task into.
+ * @param numa_node NUMA node to run the task on, i.e. the one its data is
+ * placed on.
+ * @param func Task function.
+ * @param data Pointer to pass into @a func, may be NULL.
+ * @return TRUE in case of success, FALSE if the pool is shutting down or there
+ * is no memory to grow the queue.
+ * @since 0.0.5
+ *
+ * Works like p_thread_pool_push() if the pool has no workers on @a numa_node
+ * or wasn't created with p_thread_pool_new_numa(). The task still may be
+ * stolen by a worker of another node if the local workers are busy.
+ */
+P_LIB_API pboolean	p_thread_pool_push_to_node	(PThreadPool	*pool,
+							 pint		numa_node,
+							 PThreadPoolFunc	func,
+							 ppointer	data);
+
+/**
+ * @brief Waits until all the tasks of a thread pool have finished.
+ * @param pool #PThreadPool to wait for.
+ * @since 0.0.5
+ *
+ * Tasks pushed while waiting are waited for as well. Must not be called from
+ * a worker of the same pool.
+ */
+P_LIB_API void		p_thread_pool_wait		(PThreadPool	*pool);
+
+/**
+ * @brief Stops a thread pool and joins its workers.
+ * @param pool #PThreadPool to stop.
+ * @param drain Whether to run the queued tasks before stopping, otherwise the
+ * tasks which haven't been started yet are dropped.
+ * @since 0.0.5
+ *
+ * No tasks can be pushed after this call. The running tasks are always
+ * finished. Calling it again does nothing. Must not be called from a worker of
+ * the same pool.
+ */
+P_LIB_API void		p_thread_pool_shutdown		(PThreadPool	*pool,
+							 pboolean	drain);
+
+/**
+ * @brief Gets the number of worker threads of a thread pool.
+ * @param pool #PThreadPool to get the number for.
+ * @return Number of worker threads.
+ * @since 0.0.5
+ */
+P_LIB_API pint		p_thread_pool_get_worker_count	(const PThreadPool *pool);
+
+/**
+ * @brief Gets the number of task queues of a thread pool.
+ * @param pool #PThreadPool to get the number for.
+ * @return Number of NUMA nodes with workers for a pool from
+ * p_thread_pool_new_numa(), 1 otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pint		p_thread_pool_get_node_count	(const PThreadPool *pool);
+
+/**
+ * @brief Gets the NUMA node of the calling worker.
+ * @param pool #PThreadPool the calling thread belongs to.
+ * @return NUMA node the calling worker is bound to, -1 if the calling thread
+ * isn't a worker of @a pool or the pool is not NUMA-aware.
+ * @since 0.0.5
+ */
+P_LIB_API pint		p_thread_pool_get_current_node	(const PThreadPool *pool);
+
+/**
+ * @brief Gets the memory arena of the calling worker.
+ * @param pool #PThreadPool the calling thread belongs to.
+ * @return Arena of the calling worker, NULL if the calling thread isn't a
+ * worker of @a pool, the pool is not NUMA-aware or there is no memory.
+ * @since 0.0.5
+ *
+ * Every worker of a pool from p_thread_pool_new_numa() has its own arena with
+ * memory mapped chunks. The chunks are first touched by the pinned worker, so
+ * their pages are placed on its node. The arena must be used only by the tasks
+ * running on that worker, the blocks stay valid until p_mem_arena_reset() is
+ * called by a task or the pool is freed.
+ */
+P_LIB_API PMemArena *	p_thread_pool_get_local_arena	(PThreadPool	*pool);
+
+/**
+ * @brief Gets the number of tasks waiting in the queue of a thread pool.
+ * @param pool #PThreadPool to get the number for.
+ * @return Number of queued tasks which haven't been started yet.
+ * @since 0.0.5
+ */
+P_LIB_API psize		p_thread_pool_get_pending_count	(PThreadPool	*pool);
+
+/**
+ * @brief Frees a thread pool.
+ * @param pool #PThreadPool to free.
+ * @since 0.0.5
+ *
+ * Calls p_thread_pool_shutdown() with draining if the pool hasn't been stopped
+ * yet.
+ */
+P_LIB_API void		p_thread_pool_free		(PThreadPool	*pool);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PTHREADPOOL_H */
@@ -0,0 +1,118 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Tickets grow without bounds and wrap around, only the distance between the
+ * own ticket and the served one matters. Only the owner writes the served
+ * number, so the unlock is a plain increment. */
+
+#include "patomic.h"
+#include "pcpurelax-private.h"
+#include "pmem.h"
+#include "pticketlock.h"
+
+#define P_TICKET_LOCK_YIELD_ROUNDS	64
+
+struct PTicketLock_ {
+	volatile pint	next_ticket;
+	volatile pint	now_serving;
+};
+
+P_LIB_API PTicketLock *
+p_ticket_lock_new (void)
+{
+	PTicketLock *ret;
+
+	if (P_UNLIKELY ((ret = p_malloc0_aligned (sizeof (PTicketLock), P_MEM_CACHE_LINE_SIZE)) == NULL)) {
+		P_ERROR ("PTicketLock::p_ticket_lock_new: failed to allocate memory");
+		return NULL;
+	}
+
+	return ret;
+}
+
+P_LIB_API pboolean
+p_ticket_lock_lock (PTicketLock *lock)
+{
+	pint	ticket;
+	puint	ahead;
+	puint	i;
+	pint	rounds = 0;
+
+	if (P_UNLIKELY (lock == NULL))
+		return FALSE;
+
+	ticket = p_atomic_int_add (&lock->next_ticket, 1);
+
+	for (;;) {
+		ahead = (puint) ticket - (puint) p_atomic_int_get (&lock->now_serving);
+
+		if (ahead == 0)
+			break;
+
+		/* Proportional backoff: each thread ahead holds the lock for a while */
+		for (i = 0; i < ahead * 16; ++i)
+			P_CPU_RELAX ();
+
+		if (++rounds >= P_TICKET_LOCK_YIELD_ROUNDS) {
+			p_uthread_yield ();
+			rounds = 0;
+		}
+	}
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_ticket_lock_trylock (PTicketLock *lock)
+{
+	pint serving;
+
+	if (P_UNLIKELY (lock == NULL))
+		return FALSE;
+
+	serving = p_atomic_int_get (&lock->now_serving);
+
+	/* Takes a ticket only if it would be served right away */
+	return p_atomic_int_compare_and_exchange (&lock->next_ticket,
+						  serving,
+						  (pint) ((puint) serving + 1));
+}
+
+P_LIB_API pboolean
+p_ticket_lock_unlock (PTicketLock *lock)
+{
+	if (P_UNLIKELY (lock == NULL))
+		return FALSE;
+
+	p_atomic_int_inc (&lock->now_serving);
+
+	return TRUE;
+}
+
+P_LIB_API void
+p_ticket_lock_free (PTicketLock *lock)
+{
+	p_free_aligned (lock);
+}
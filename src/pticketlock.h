@@ -0,0 +1,113 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pticketlock.h
+ * @brief Fair ticket spinlock
+ * @author Alexander Saprykin
+ *
+ * A ticket lock is a spinlock which grants the lock in the order of arrival,
+ * like a queue at a bakery counter: a thread takes the next ticket number and
+ * spins until the lock serves that number. Unlike #PSpinLock no thread can be
+ * starved by luckier ones, and a waiting thread only reads the lock word until
+ * its turn comes, so the waiters don't fight for the cache line. The wait
+ * between the reads grows with the number of threads ahead in the queue.
+ *
+ * All the waiters still read the same cache line, which bounces on every
+ * unlock. For many cores under a heavy contention prefer #PMCSLock, where
+ * every waiter spins on its own node.
+ *
+ * Like any fair spinlock, a ticket lock degrades badly when there are more
+ * spinning threads than CPUs: the next thread in the queue may be preempted
+ * and all the others have to wait for it. Waiters yield the CPU after a while
+ * to soften that, but consider #PFastMutex for oversubscribed systems.
+ *
+ * The lock is based on the atomic operations, see p_atomic_is_lock_free().
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PTICKETLOCK_H
+#define PLIBSYS_HEADER_PTICKETLOCK_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+
+P_BEGIN_DECLS
+
+/** Ticket lock opaque data type. */
+typedef struct PTicketLock_ PTicketLock;
+
+/**
+ * @brief Creates a new ticket lock.
+ * @return Pointer to #PTicketLock in case of success, NULL otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API PTicketLock *	p_ticket_lock_new	(void);
+
+/**
+ * @brief Locks a ticket lock.
+ * @param lock #PTicketLock to lock.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The threads get the lock in the order they have called this routine. Do
+ * not lock a ticket lock recursively, it leads to a deadlock.
+ */
+P_LIB_API pboolean	p_ticket_lock_lock	(PTicketLock	*lock);
+
+/**
+ * @brief Tries to lock a ticket lock without waiting.
+ * @param lock #PTicketLock to lock.
+ * @return TRUE if the lock was acquired, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_ticket_lock_trylock	(PTicketLock	*lock);
+
+/**
+ * @brief Releases a locked ticket lock.
+ * @param lock #PTicketLock to release.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * Only the thread which holds the lock may release it, releasing an unlocked
+ * ticket lock breaks it.
+ */
+P_LIB_API pboolean	p_ticket_lock_unlock	(PTicketLock	*lock);
+
+/**
+ * @brief Frees a ticket lock.
+ * @param lock #PTicketLock to free.
+ * @since 0.0.5
+ *
+ * The lock should be unlocked at that moment.
+ */
+P_LIB_API void		p_ticket_lock_free	(PTicketLock	*lock);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PTICKETLOCK_H */
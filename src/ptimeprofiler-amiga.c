@@ -30,6 +30,8 @@
 
 static puint64 pp_time_profiler_freq = 1;
 
+static puint64 pp_time_profiler_elapsed_ticks (const PTimeProfiler *profiler);
+
 puint64
 p_time_profiler_get_ticks_internal ()
 {
@@ -40,8 +42,8 @@ p_time_profiler_get_ticks_internal ()
 	return (((puint64) eclock.ev_hi) * pp_time_profiler_freq + (puint64) eclock.ev_lo);
 }
 
-puint64
-p_time_profiler_elapsed_usecs_internal (const PTimeProfiler *profiler)
+static puint64
+pp_time_profiler_elapsed_ticks (const PTimeProfiler *profiler)
 {
 	puint64 value;
 
@@ -52,7 +54,32 @@ p_time_profiler_elapsed_usecs_internal (const PTimeProfiler *profiler)
 	if (P_UNLIKELY (value < profiler->counter))
 		value += (((puint64) 1) << 32) * pp_time_profiler_freq;
 
-	return (value - profiler->counter) * 1000000ULL / pp_time_profiler_freq;
+	return value - profiler->counter;
+}
+
+puint64
+p_time_profiler_ticks_to_nsecs_internal (puint64 ticks)
+{
+	return (ticks / pp_time_profiler_freq) * 1000000000ULL +
+	       (ticks % pp_time_profiler_freq) * 1000000000ULL / pp_time_profiler_freq;
+}
+
+puint64
+p_time_profiler_elapsed_nsecs_internal (const PTimeProfiler *profiler)
+{
+	return p_time_profiler_ticks_to_nsecs_internal (pp_time_profiler_elapsed_ticks (profiler));
+}
+
+puint64
+p_time_profiler_elapsed_usecs_internal (const PTimeProfiler *profiler)
+{
+	return pp_time_profiler_elapsed_ticks (profiler) * 1000000ULL / pp_time_profiler_freq;
+}
+
+puint64
+p_time_profiler_coarse_msecs_internal (void)
+{
+	return p_time_profiler_ticks_to_nsecs_internal (p_time_profiler_get_ticks_internal ()) / 1000000;
 }
 
 void
@@ -34,12 +34,30 @@ p_time_profiler_get_ticks_internal ()
 	return (puint64) system_time ();
 }
 
+puint64
+p_time_profiler_ticks_to_nsecs_internal (puint64 ticks)
+{
+	return ticks * 1000;
+}
+
+puint64
+p_time_profiler_elapsed_nsecs_internal (const PTimeProfiler *profiler)
+{
+	return (((puint64) system_time ()) - profiler->counter) * 1000;
+}
+
 puint64
 p_time_profiler_elapsed_usecs_internal (const PTimeProfiler *profiler)
 {
 	return ((puint64) system_time ()) - profiler->counter;
 }
 
+puint64
+p_time_profiler_coarse_msecs_internal (void)
+{
+	return p_time_profiler_ticks_to_nsecs_internal (p_time_profiler_get_ticks_internal ()) / 1000000;
+}
+
 void
 p_time_profiler_init (void)
 {
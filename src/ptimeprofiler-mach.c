@@ -34,21 +34,32 @@ static puint64 pp_time_profiler_freq_denom = 0;
 puint64
 p_time_profiler_get_ticks_internal ()
 {
-	puint64 val = mach_absolute_time ();
-
-	/* To prevent overflow */
-	val /= 1000;
+	return (puint64) mach_absolute_time ();
+}
 
-	val *= pp_time_profiler_freq_num;
-	val /= pp_time_profiler_freq_denom;
+puint64
+p_time_profiler_ticks_to_nsecs_internal (puint64 ticks)
+{
+	/* Elapsed ticks are small enough to not overflow */
+	return ticks * pp_time_profiler_freq_num / pp_time_profiler_freq_denom;
+}
 
-	return val;
+puint64
+p_time_profiler_elapsed_nsecs_internal (const PTimeProfiler *profiler)
+{
+	return p_time_profiler_ticks_to_nsecs_internal (p_time_profiler_get_ticks_internal () - profiler->counter);
 }
 
 puint64
 p_time_profiler_elapsed_usecs_internal (const PTimeProfiler *profiler)
 {
-	return p_time_profiler_get_ticks_internal () - profiler->counter;
+	return p_time_profiler_elapsed_nsecs_internal (profiler) / 1000;
+}
+
+puint64
+p_time_profiler_coarse_msecs_internal (void)
+{
+	return p_time_profiler_ticks_to_nsecs_internal (p_time_profiler_get_ticks_internal ()) / 1000000;
 }
 
 void
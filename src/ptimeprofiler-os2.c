@@ -56,24 +56,14 @@ p_time_profiler_get_ticks_internal ()
 }
 
 puint64
-p_time_profiler_elapsed_usecs_internal (const PTimeProfiler *profiler)
+p_time_profiler_ticks_to_nsecs_internal (puint64 ticks)
 {
-	puint64	ticks;
 #if PLIBSYS_HAS_LLDIV
 	lldiv_t	ldres;
 #endif
 	puint64	quot;
 	puint64	rem;
 
-	ticks = p_time_profiler_get_ticks_internal ();
-
-	if (ticks < profiler->counter) {
-		P_WARNING ("PTimeProfiler::p_time_profiler_elapsed_usecs_internal: negative jitter");
-		return 1;
-	}
-
-	ticks -= profiler->counter;
-
 #if PLIBSYS_HAS_LLDIV
 	ldres = lldiv ((long long) ticks, (long long) pp_time_profiler_freq);
 
@@ -84,7 +74,34 @@ p_time_profiler_elapsed_usecs_internal (const PTimeProfiler *profiler)
 	rem  = ticks % pp_time_profiler_freq;
 #endif
 
-	return (puint64) (quot * 1000000LL + (rem * 1000000LL) / pp_time_profiler_freq);
+	return (puint64) (quot * 1000000000LL + (rem * 1000000000LL) / pp_time_profiler_freq);
+}
+
+puint64
+p_time_profiler_elapsed_nsecs_internal (const PTimeProfiler *profiler)
+{
+	puint64	ticks;
+
+	ticks = p_time_profiler_get_ticks_internal ();
+
+	if (ticks < profiler->counter) {
+		P_WARNING ("PTimeProfiler::p_time_profiler_elapsed_nsecs_internal: negative jitter");
+		return 1000;
+	}
+
+	return p_time_profiler_ticks_to_nsecs_internal (ticks - profiler->counter);
+}
+
+puint64
+p_time_profiler_elapsed_usecs_internal (const PTimeProfiler *profiler)
+{
+	return p_time_profiler_elapsed_nsecs_internal (profiler) / 1000;
+}
+
+puint64
+p_time_profiler_coarse_msecs_internal (void)
+{
+	return p_time_profiler_ticks_to_nsecs_internal (p_time_profiler_get_ticks_internal ()) / 1000000;
 }
 
 void
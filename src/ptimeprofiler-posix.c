@@ -23,8 +23,10 @@
  * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include "ponce.h"
 #include "ptimeprofiler.h"
 #include "ptimeprofiler-private.h"
+#include "pcpufeatures-private.h"
 
 #include <unistd.h>
 #include <time.h>
@@ -34,15 +36,67 @@
 #  define _POSIX_MONOTONIC_CLOCK (-1)
 #endif
 
+/* Cycle counters are calibrated against the monotonic clock */
+#if (_POSIX_MONOTONIC_CLOCK >= 0) && !defined (P_OS_IRIX) && \
+    (defined (P_CPU_X86_TSC) || defined (P_CPU_ARM_CNTVCT))
+#  define P_TIME_PROFILER_HAVE_CYCLES
+#  ifdef P_CPU_X86_TSC
+#    include <x86intrin.h>
+#  endif
+#endif
+
+/* Interval to measure the cycle counter frequency over, in nanoseconds */
+#define P_TIME_PROFILER_CALIBRATION_NSECS	2000000
+
+/* Number of clock readings to pick the most precise one from */
+#define P_TIME_PROFILER_CALIBRATION_SAMPLES	8
+
+/* Minimal sane cycle counter frequency, in Hz */
+#define P_TIME_PROFILER_MIN_FREQ		1000000
+
+/* Maximal acceptable resolution of the coarse clock, in nanoseconds */
+#define P_TIME_PROFILER_MAX_COARSE_RES		10000000
+
 typedef puint64 (* PPOSIXTicksFunc) (void);
+typedef puint64 (* PPOSIXConvertFunc) (puint64 ticks);
+
+static puint64 pp_time_profiler_get_ticks_lazy (void);
+static puint64 pp_time_profiler_convert_lazy (puint64 ticks);
+
+/* The clock is selected and calibrated on the first use, until then the
+ * functions point to the stubs which run the initialization */
+static POnce             pp_time_profiler_once         = P_ONCE_INIT;
+static PPOSIXTicksFunc   pp_time_profiler_ticks_func   = pp_time_profiler_get_ticks_lazy;
+static PPOSIXConvertFunc pp_time_profiler_convert_func = pp_time_profiler_convert_lazy;
+static pboolean          pp_time_profiler_has_coarse   = FALSE;
 
-static PPOSIXTicksFunc pp_time_profiler_ticks_func = NULL;
+#ifdef P_TIME_PROFILER_HAVE_CYCLES
+/* Nanoseconds per cycle as a 32.32 fixed point value, calibrated once per
+ * process and survives library re-initialization */
+static puint64 pp_time_profiler_cycles_mult = 0;
+#endif
 
 #if (_POSIX_MONOTONIC_CLOCK >= 0) || defined (P_OS_IRIX)
 static puint64 pp_time_profiler_get_ticks_clock ();
 #endif
 
 static puint64 pp_time_profiler_get_ticks_gtod ();
+static puint64 pp_time_profiler_convert_nsecs (puint64 ticks);
+static void pp_time_profiler_init (ppointer data);
+
+#ifdef P_TIME_PROFILER_HAVE_CYCLES
+#  ifdef P_CPU_X86_TSC
+static puint64 pp_time_profiler_get_ticks_rdtsc (void);
+static puint64 pp_time_profiler_get_ticks_rdtscp (void);
+#  else
+static puint64 pp_time_profiler_get_ticks_cntvct (void);
+#  endif
+static puint64 pp_time_profiler_convert_cycles (puint64 cycles);
+static puint64 pp_time_profiler_get_clock_nsecs (void);
+static pboolean pp_time_profiler_sample_cycles (PPOSIXTicksFunc cycles_func, puint64 *cycles, puint64 *nsecs);
+static puint64 pp_time_profiler_calibrate_cycles (PPOSIXTicksFunc cycles_func);
+static PPOSIXTicksFunc pp_time_profiler_init_cycles (void);
+#endif
 
 #if (_POSIX_MONOTONIC_CLOCK >= 0) || defined (P_OS_IRIX)
 static puint64
@@ -58,7 +112,7 @@ pp_time_profiler_get_ticks_clock ()
 		P_ERROR ("PTimeProfiler::pp_time_profiler_get_ticks_clock: clock_gettime() failed");
 		return pp_time_profiler_get_ticks_gtod ();
 	} else
-		return (puint64) (ts.tv_sec * 1000000 + ts.tv_nsec / 1000);
+		return (puint64) ts.tv_sec * 1000000000 + (puint64) ts.tv_nsec;
 }
 #endif
 
@@ -72,8 +126,184 @@ pp_time_profiler_get_ticks_gtod ()
 		return 0;
 	}
 
-	return (puint64) (tv.tv_sec * 1000000 + tv.tv_usec);
+	return ((puint64) tv.tv_sec * 1000000 + (puint64) tv.tv_usec) * 1000;
+}
+
+static puint64
+pp_time_profiler_convert_nsecs (puint64 ticks)
+{
+	return ticks;
+}
+
+#ifdef P_TIME_PROFILER_HAVE_CYCLES
+#  ifdef P_CPU_X86_TSC
+static puint64
+pp_time_profiler_get_ticks_rdtsc (void)
+{
+	/* Invariant TSC without rdtscp is rare, so don't bother with fencing */
+	return (puint64) __rdtsc ();
+}
+
+static puint64
+pp_time_profiler_get_ticks_rdtscp (void)
+{
+	puint aux;
+
+	/* Waits for all the preceding instructions to complete */
+	return (puint64) __rdtscp (&aux);
 }
+#  else
+static puint64
+pp_time_profiler_get_ticks_cntvct (void)
+{
+	puint64 val;
+
+	__asm__ __volatile__ ("isb\n\t"
+			      "mrs %0, cntvct_el0"
+			      : "=r" (val)
+			      :
+			      : "memory");
+
+	return val;
+}
+#  endif
+
+static puint64
+pp_time_profiler_convert_cycles (puint64 cycles)
+{
+	puint64 cycles_hi = cycles >> 32;
+	puint64 cycles_lo = cycles & 0xFFFFFFFFU;
+	puint64 mult      = pp_time_profiler_cycles_mult;
+	puint64 mult_hi;
+	puint64 mult_lo;
+
+	/* The thread may have seen the function before the multiplier, the
+	 * initialization guard makes it visible */
+	if (P_UNLIKELY (mult == 0)) {
+		p_once (&pp_time_profiler_once, pp_time_profiler_init, NULL);
+		mult = pp_time_profiler_cycles_mult;
+	}
+
+	mult_hi = mult >> 32;
+	mult_lo = mult & 0xFFFFFFFFU;
+
+	/* (cycles * mult) >> 32 by the 32-bit halves, avoids 64-bit division */
+	return ((cycles_hi * mult_hi) << 32) + cycles_hi * mult_lo + cycles_lo * mult_hi +
+	       ((cycles_lo * mult_lo) >> 32);
+}
+
+static puint64
+pp_time_profiler_get_clock_nsecs (void)
+{
+	struct timespec ts;
+
+	if (P_UNLIKELY (clock_gettime (CLOCK_MONOTONIC, &ts) != 0))
+		return 0;
+
+	return (puint64) ts.tv_sec * 1000000000 + (puint64) ts.tv_nsec;
+}
+
+static pboolean
+pp_time_profiler_sample_cycles (PPOSIXTicksFunc	cycles_func,
+				puint64		*cycles,
+				puint64		*nsecs)
+{
+	puint64	best_width = P_MAXUINT64;
+	puint64	before;
+	puint64	after;
+	puint64	clock_nsecs;
+	pint	i;
+
+	/* Bracket the clock reading with the counter ones, the narrowest
+	 * bracket is the one not interrupted by preemption */
+	for (i = 0; i < P_TIME_PROFILER_CALIBRATION_SAMPLES; ++i) {
+		before      = cycles_func ();
+		clock_nsecs = pp_time_profiler_get_clock_nsecs ();
+		after       = cycles_func ();
+
+		if (P_UNLIKELY (clock_nsecs == 0))
+			return FALSE;
+
+		if (after >= before && after - before < best_width) {
+			best_width = after - before;
+			*cycles    = before + best_width / 2;
+			*nsecs     = clock_nsecs;
+		}
+	}
+
+	return best_width != P_MAXUINT64;
+}
+
+static puint64
+pp_time_profiler_calibrate_cycles (PPOSIXTicksFunc cycles_func)
+{
+	puint64	start_nsecs;
+	puint64	end_nsecs;
+	puint64	start_cycles;
+	puint64	end_cycles;
+	puint64	cycles;
+
+	/* The first calls may be slow because of the lazy symbol binding */
+	pp_time_profiler_get_clock_nsecs ();
+	cycles_func ();
+
+	if (P_UNLIKELY (!pp_time_profiler_sample_cycles (cycles_func, &start_cycles, &start_nsecs)))
+		return 0;
+
+	do {
+		if (P_UNLIKELY (!pp_time_profiler_sample_cycles (cycles_func, &end_cycles, &end_nsecs)))
+			return 0;
+	} while (end_nsecs - start_nsecs < P_TIME_PROFILER_CALIBRATION_NSECS);
+
+	if (P_UNLIKELY (end_cycles <= start_cycles))
+		return 0;
+
+	cycles = end_cycles - start_cycles;
+	end_nsecs -= start_nsecs;
+
+	return (cycles / end_nsecs) * 1000000000 + (cycles % end_nsecs) * 1000000000 / end_nsecs;
+}
+
+static PPOSIXTicksFunc
+pp_time_profiler_init_cycles (void)
+{
+	PPOSIXTicksFunc	cycles_func;
+	puint64		freq;
+
+#  ifdef P_CPU_X86_TSC
+	/* TSC of the older CPUs follows the core frequency */
+	if (!p_cpu_has_feature_internal (P_CPU_FEATURE_INVARIANT_TSC))
+		return NULL;
+
+	if (p_cpu_has_feature_internal (P_CPU_FEATURE_RDTSCP))
+		cycles_func = pp_time_profiler_get_ticks_rdtscp;
+	else
+		cycles_func = pp_time_profiler_get_ticks_rdtsc;
+#  else
+	cycles_func = pp_time_profiler_get_ticks_cntvct;
+#  endif
+
+	if (pp_time_profiler_cycles_mult != 0)
+		return cycles_func;
+
+#  ifdef P_CPU_ARM_CNTVCT
+	/* The architecture provides the exact counter frequency */
+	__asm__ __volatile__ ("mrs %0, cntfrq_el0" : "=r" (freq));
+
+	if (freq <= P_TIME_PROFILER_MIN_FREQ)
+		freq = pp_time_profiler_calibrate_cycles (cycles_func);
+#  else
+	freq = pp_time_profiler_calibrate_cycles (cycles_func);
+#  endif
+
+	if (freq <= P_TIME_PROFILER_MIN_FREQ)
+		return NULL;
+
+	pp_time_profiler_cycles_mult = ((puint64) 1000000000 << 32) / freq;
+
+	return cycles_func;
+}
+#endif
 
 puint64
 p_time_profiler_get_ticks_internal ()
@@ -81,29 +311,125 @@ p_time_profiler_get_ticks_internal ()
 	return pp_time_profiler_ticks_func ();
 }
 
+puint64
+p_time_profiler_ticks_to_nsecs_internal (puint64 ticks)
+{
+	return pp_time_profiler_convert_func (ticks);
+}
+
+puint64
+p_time_profiler_elapsed_nsecs_internal (const PTimeProfiler *profiler)
+{
+	puint64 ticks = pp_time_profiler_ticks_func ();
+
+	/* Cycle counters of different cores may be slightly out of sync */
+	if (P_UNLIKELY (ticks < profiler->counter))
+		return 0;
+
+	return pp_time_profiler_convert_func (ticks - profiler->counter);
+}
+
 puint64
 p_time_profiler_elapsed_usecs_internal (const PTimeProfiler *profiler)
 {
-	return pp_time_profiler_ticks_func () - profiler->counter;
+	return p_time_profiler_elapsed_nsecs_internal (profiler) / 1000;
 }
 
-void
-p_time_profiler_init (void)
+puint64
+p_time_profiler_coarse_msecs_internal (void)
+{
+#ifdef CLOCK_MONOTONIC_COARSE
+	struct timespec ts;
+
+	/* The clock choice must not change between the calls */
+	p_once (&pp_time_profiler_once, pp_time_profiler_init, NULL);
+
+	/* Served from the vDSO data page without entering the kernel */
+	if (P_LIKELY (pp_time_profiler_has_coarse == TRUE &&
+		      clock_gettime (CLOCK_MONOTONIC_COARSE, &ts) == 0))
+		return (puint64) ts.tv_sec * 1000 + (puint64) ts.tv_nsec / 1000000;
+#endif
+
+	return pp_time_profiler_convert_func (pp_time_profiler_ticks_func ()) / 1000000;
+}
+
+static puint64
+pp_time_profiler_get_ticks_lazy (void)
+{
+	p_once (&pp_time_profiler_once, pp_time_profiler_init, NULL);
+
+	return pp_time_profiler_ticks_func ();
+}
+
+static puint64
+pp_time_profiler_convert_lazy (puint64 ticks)
+{
+	p_once (&pp_time_profiler_once, pp_time_profiler_init, NULL);
+
+	return pp_time_profiler_convert_func (ticks);
+}
+
+static void
+pp_time_profiler_init (ppointer data)
 {
+	PPOSIXTicksFunc		ticks_func;
+	PPOSIXConvertFunc	convert_func;
+#ifdef P_TIME_PROFILER_HAVE_CYCLES
+	PPOSIXTicksFunc		cycles_func;
+#endif
+#ifdef CLOCK_MONOTONIC_COARSE
+	struct timespec		res;
+#endif
+
+	P_UNUSED (data);
+
+#ifdef CLOCK_MONOTONIC_COARSE
+	/* Some kernels configure the coarse clock with a too low tick rate */
+	pp_time_profiler_has_coarse = (clock_getres (CLOCK_MONOTONIC_COARSE, &res) == 0 &&
+				       res.tv_sec == 0 &&
+				       res.tv_nsec <= P_TIME_PROFILER_MAX_COARSE_RES) ? TRUE : FALSE;
+#endif
+
 #if defined (P_OS_IRIX) || (_POSIX_MONOTONIC_CLOCK > 0)
-	pp_time_profiler_ticks_func = (PPOSIXTicksFunc) pp_time_profiler_get_ticks_clock;
+	ticks_func = (PPOSIXTicksFunc) pp_time_profiler_get_ticks_clock;
 #elif (_POSIX_MONOTONIC_CLOCK == 0) && defined (_SC_MONOTONIC_CLOCK)
 	if (P_LIKELY (sysconf (_SC_MONOTONIC_CLOCK) > 0))
-		pp_time_profiler_ticks_func = (PPOSIXTicksFunc) pp_time_profiler_get_ticks_clock;
+		ticks_func = (PPOSIXTicksFunc) pp_time_profiler_get_ticks_clock;
 	else
-		pp_time_profiler_ticks_func = (PPOSIXTicksFunc) pp_time_profiler_get_ticks_gtod;
+		ticks_func = (PPOSIXTicksFunc) pp_time_profiler_get_ticks_gtod;
 #else
-	pp_time_profiler_ticks_func = (PPOSIXTicksFunc) pp_time_profiler_get_ticks_gtod;
+	ticks_func = (PPOSIXTicksFunc) pp_time_profiler_get_ticks_gtod;
 #endif
+
+	convert_func = (PPOSIXConvertFunc) pp_time_profiler_convert_nsecs;
+
+#ifdef P_TIME_PROFILER_HAVE_CYCLES
+	/* Reading a cycle counter is much cheaper than a clock_gettime() call */
+	if (ticks_func == (PPOSIXTicksFunc) pp_time_profiler_get_ticks_clock &&
+	    (cycles_func = pp_time_profiler_init_cycles ()) != NULL) {
+		ticks_func   = cycles_func;
+		convert_func = (PPOSIXConvertFunc) pp_time_profiler_convert_cycles;
+	}
+#endif
+
+	/* Other threads may already call through the pointers, each of them
+	 * switches from the stub to the final function only once */
+	pp_time_profiler_convert_func = convert_func;
+	pp_time_profiler_ticks_func   = ticks_func;
+}
+
+void
+p_time_profiler_init (void)
+{
+	/* Selecting the clock may take a while to calibrate a cycle counter,
+	 * it is done on the first use instead */
 }
 
 void
 p_time_profiler_shutdown (void)
 {
-	pp_time_profiler_ticks_func = NULL;
+	pp_time_profiler_ticks_func   = pp_time_profiler_get_ticks_lazy;
+	pp_time_profiler_convert_func = pp_time_profiler_convert_lazy;
+	pp_time_profiler_has_coarse   = FALSE;
+	pp_time_profiler_once         = P_ONCE_INIT;
 }
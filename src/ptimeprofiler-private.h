@@ -32,13 +32,47 @@
 
 #include "pmacros.h"
 #include "ptypes.h"
+#include "ptimeprofiler.h"
 
 P_BEGIN_DECLS
 
-/** Time profiler opaque data structure. */
-struct PTimeProfiler_ {
-	puint64 counter; /**< Ticks counter. */
-};
+/**
+ * @brief Gets the current value of the platform tick counter.
+ * @return Current ticks value, the units are platform dependent.
+ * @since 0.0.5
+ */
+puint64	p_time_profiler_get_ticks_internal	(void);
+
+/**
+ * @brief Converts a difference of the tick counter values to nanoseconds.
+ * @param ticks Difference of two p_time_profiler_get_ticks_internal() values.
+ * @return Nanoseconds corresponding to @a ticks.
+ * @since 0.0.5
+ */
+puint64	p_time_profiler_ticks_to_nsecs_internal	(puint64		ticks);
+
+/**
+ * @brief Calculates elapsed time since the profiler's counter value.
+ * @param profiler Time profiler to calculate elapsed time for.
+ * @return Microseconds elapsed since the @a profiler counter value.
+ * @since 0.0.5
+ */
+puint64	p_time_profiler_elapsed_usecs_internal	(const PTimeProfiler	*profiler);
+
+/**
+ * @brief Calculates elapsed time since the profiler's counter value.
+ * @param profiler Time profiler to calculate elapsed time for.
+ * @return Nanoseconds elapsed since the @a profiler counter value.
+ * @since 0.0.5
+ */
+puint64	p_time_profiler_elapsed_nsecs_internal	(const PTimeProfiler	*profiler);
+
+/**
+ * @brief Gets the current value of the coarse monotonic clock.
+ * @return Milliseconds since an unspecified starting point.
+ * @since 0.0.5
+ */
+puint64	p_time_profiler_coarse_msecs_internal	(void);
 
 P_END_DECLS
 
@@ -35,15 +35,16 @@
 #endif
 
 typedef puint64 (WINAPI * PWin32TicksFunc) (void);
+/* Returns elapsed ticks, the tick counters may wrap around */
 typedef puint64 (* PWin32ElapsedFunc) (puint64 last_counter);
 
 static PWin32TicksFunc   pp_time_profiler_ticks_func   = NULL;
 static PWin32ElapsedFunc pp_time_profiler_elapsed_func = NULL;
+static PWin32TicksFunc   pp_time_profiler_coarse_func  = NULL;
 static puint64           pp_time_profiler_freq         = 1;
 
 static puint64 WINAPI pp_time_profiler_get_hr_ticks (void);
-static puint64 pp_time_profiler_elapsed_hr (puint64 last_counter);
-static puint64 pp_time_profiler_elapsed_tick64 (puint64 last_counter);
+static puint64 pp_time_profiler_elapsed_ticks (puint64 last_counter);
 static puint64 pp_time_profiler_elapsed_tick (puint64 last_counter);
 
 static puint64 WINAPI
@@ -60,17 +61,41 @@ pp_time_profiler_get_hr_ticks (void)
 }
 
 static puint64
-pp_time_profiler_elapsed_hr (puint64 last_counter)
+pp_time_profiler_elapsed_ticks (puint64 last_counter)
+{
+	return pp_time_profiler_ticks_func () - last_counter;
+}
+
+static puint64
+pp_time_profiler_elapsed_tick (puint64 last_counter)
+{
+	puint64 val;
+	puint64 high_bit;
+
+	high_bit = 0;
+	val      = pp_time_profiler_ticks_func ();
+
+	if (P_UNLIKELY (val < last_counter))
+		high_bit = 1;
+
+	return (val | (high_bit << 32)) - last_counter;
+}
+
+puint64
+p_time_profiler_get_ticks_internal ()
+{
+	return pp_time_profiler_ticks_func ();
+}
+
+puint64
+p_time_profiler_ticks_to_nsecs_internal (puint64 ticks)
 {
-	puint64	ticks;
 #ifdef PLIBSYS_HAS_LLDIV
 	lldiv_t	ldres;
 #endif
 	puint64	quot;
 	puint64	rem;
 
-	ticks = pp_time_profiler_ticks_func () - last_counter;
-
 #ifdef PLIBSYS_HAS_LLDIV
 	ldres = lldiv ((long long) ticks, (long long) pp_time_profiler_freq);
 
@@ -81,40 +106,29 @@ pp_time_profiler_elapsed_hr (puint64 last_counter)
 	rem  = ticks % pp_time_profiler_freq;
 #endif
 
-	return (puint64) (quot * 1000000 + (rem * 1000000) / pp_time_profiler_freq);
+	return (puint64) (quot * 1000000000 + (rem * 1000000000) / pp_time_profiler_freq);
 }
 
-static puint64
-pp_time_profiler_elapsed_tick64 (puint64 last_counter)
-{
-	return (pp_time_profiler_ticks_func () - last_counter) * 1000;
-}
-
-static puint64
-pp_time_profiler_elapsed_tick (puint64 last_counter)
+puint64
+p_time_profiler_elapsed_nsecs_internal (const PTimeProfiler *profiler)
 {
-	puint64 val;
-	puint64 high_bit;
-
-	high_bit = 0;
-	val      = pp_time_profiler_ticks_func ();
-
-	if (P_UNLIKELY (val < last_counter))
-		high_bit = 1;
-
-	return ((val | (high_bit << 32)) - last_counter) * 1000;
+	return p_time_profiler_ticks_to_nsecs_internal (pp_time_profiler_elapsed_func (profiler->counter));
 }
 
 puint64
-p_time_profiler_get_ticks_internal ()
+p_time_profiler_elapsed_usecs_internal (const PTimeProfiler *profiler)
 {
-	return pp_time_profiler_ticks_func ();
+	return p_time_profiler_elapsed_nsecs_internal (profiler) / 1000;
 }
 
 puint64
-p_time_profiler_elapsed_usecs_internal (const PTimeProfiler *profiler)
+p_time_profiler_coarse_msecs_internal (void)
 {
-	return pp_time_profiler_elapsed_func (profiler->counter);
+	/* GetTickCount64() only reads the shared user data page */
+	if (P_LIKELY (pp_time_profiler_coarse_func != NULL))
+		return pp_time_profiler_coarse_func ();
+
+	return p_time_profiler_ticks_to_nsecs_internal (pp_time_profiler_ticks_func ()) / 1000000;
 }
 
 void
@@ -124,6 +138,12 @@ p_time_profiler_init (void)
 	HMODULE		hmodule;
 	pboolean	has_qpc;
 
+	hmodule = GetModuleHandleA ("kernel32.dll");
+
+	/* Available since Vista */
+	if (P_LIKELY (hmodule != NULL))
+		pp_time_profiler_coarse_func = (PWin32TicksFunc) GetProcAddress (hmodule, "GetTickCount64");
+
 	has_qpc = (QueryPerformanceCounter (&tcounter) != 0 && tcounter.QuadPart != 0) ? TRUE : FALSE;
 
 	if (has_qpc == TRUE) {
@@ -133,20 +153,20 @@ p_time_profiler_init (void)
 		} else {
 			pp_time_profiler_freq         = (puint64) (tcounter.QuadPart);
 			pp_time_profiler_ticks_func   = (PWin32TicksFunc) pp_time_profiler_get_hr_ticks;
-			pp_time_profiler_elapsed_func = (PWin32ElapsedFunc) pp_time_profiler_elapsed_hr;
+			pp_time_profiler_elapsed_func = (PWin32ElapsedFunc) pp_time_profiler_elapsed_ticks;
 		}
 	}
 
 	if (P_UNLIKELY (has_qpc == FALSE)) {
-		hmodule = GetModuleHandleA ("kernel32.dll");
-
 		if (P_UNLIKELY (hmodule == NULL)) {
 			P_ERROR ("PTimeProfiler::p_time_profiler_init: failed to load kernel32.dll module");
 			return;
 		}
 
+		/* Tick counters are in milliseconds */
+		pp_time_profiler_freq         = 1000;
 		pp_time_profiler_ticks_func   = (PWin32TicksFunc) GetProcAddress (hmodule, "GetTickCount64");
-		pp_time_profiler_elapsed_func = (PWin32ElapsedFunc) pp_time_profiler_elapsed_tick64;
+		pp_time_profiler_elapsed_func = (PWin32ElapsedFunc) pp_time_profiler_elapsed_ticks;
 
 		if (P_UNLIKELY (pp_time_profiler_ticks_func == NULL)) {
 			pp_time_profiler_ticks_func   = (PWin32TicksFunc) GetProcAddress (hmodule, "GetTickCount");
@@ -166,4 +186,5 @@ p_time_profiler_shutdown (void)
 	pp_time_profiler_freq         = 1;
 	pp_time_profiler_ticks_func   = NULL;
 	pp_time_profiler_elapsed_func = NULL;
+	pp_time_profiler_coarse_func  = NULL;
 }
@@ -39,6 +39,35 @@
  * and p_time_profiler_elapsed_usecs() to get elapsed time since the creation.
  * If you need to reset a profiler use p_time_profiler_reset(). Remove a
  * profiler with p_time_profiler_free().
+ *
+ * A profiler is just a counter value, so it can be placed on the stack or
+ * inside another structure as well. Start such a profiler with
+ * p_time_profiler_reset(), it doesn't need to be freed:
+ * @code
+ * PTimeProfiler profiler;
+ *
+ * p_time_profiler_reset (&profiler);
+ * process_request (request);
+ * record_latency (p_time_profiler_elapsed_nsecs (&profiler));
+ * @endcode
+ *
+ * p_time_profiler_elapsed_nsecs() reports elapsed time with the full
+ * resolution of the underlying clock. The raw clock ticks can be taken with
+ * p_time_profiler_ticks() and converted later, i.e. when recording the
+ * timestamps in a hot loop, with p_time_profiler_ticks_to_nsecs().
+ *
+ * On the POSIX systems running on x86 with an invariant TSC or on ARM64 the
+ * profiler reads the CPU cycle counter (rdtscp, CNTVCT_EL0) instead of
+ * calling clock_gettime(), so even the short code sections can be measured
+ * cheaply. The counter frequency is calibrated against the monotonic clock
+ * once per process at the library initialization, which takes a couple of
+ * milliseconds on x86. Otherwise the monotonic clock is used.
+ *
+ * p_time_coarse_now_msecs() is meant for the timeout bookkeeping on the hot
+ * paths where a millisecond precision is enough: it reads the coarse system
+ * clock (CLOCK_MONOTONIC_COARSE, GetTickCount64()) which is updated by the
+ * kernel on every scheduler tick and costs about as much as a couple of memory
+ * loads.
  */
 
 #if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
@@ -53,8 +82,10 @@
 
 P_BEGIN_DECLS
 
-/** Time profiler opaque data structure. */
-typedef struct PTimeProfiler_ PTimeProfiler;
+/** Time profiler, all the fields are private. */
+typedef struct PTimeProfiler_ {
+	puint64	counter;	/**< Ticks counter at the last reset.	*/
+} PTimeProfiler;
 
 /**
  * @brief Creates a new #PTimeProfiler object.
@@ -81,10 +112,56 @@ P_LIB_API void			p_time_profiler_reset		(PTimeProfiler *	profiler);
  */
 P_LIB_API puint64		p_time_profiler_elapsed_usecs	(const PTimeProfiler *	profiler);
 
+/**
+ * @brief Calculates elapsed time since the last reset or creation with the
+ * full clock resolution.
+ * @param profiler Time profiler to calculate elapsed time for.
+ * @return Nanoseconds elapsed since the last reset or creation.
+ * @since 0.0.5
+ *
+ * The actual resolution depends on the platform clock, i.e. it's one
+ * microsecond if only gettimeofday() is available.
+ */
+P_LIB_API puint64		p_time_profiler_elapsed_nsecs	(const PTimeProfiler *	profiler);
+
+/**
+ * @brief Gets the current value of the clock used by #PTimeProfiler.
+ * @return Current clock value in the platform dependent units.
+ * @since 0.0.5
+ *
+ * The values are monotonic and only their differences are meaningful: pass
+ * a difference to p_time_profiler_ticks_to_nsecs() to get the time.
+ */
+P_LIB_API puint64		p_time_profiler_ticks		(void);
+
+/**
+ * @brief Converts a difference of two p_time_profiler_ticks() values to
+ * nanoseconds.
+ * @param ticks Difference of the clock values.
+ * @return Nanoseconds corresponding to @a ticks.
+ * @since 0.0.5
+ */
+P_LIB_API puint64		p_time_profiler_ticks_to_nsecs	(puint64		ticks);
+
+/**
+ * @brief Gets the current value of the coarse monotonic clock.
+ * @return Milliseconds since an unspecified starting point.
+ * @since 0.0.5
+ *
+ * The clock is updated once per the system timer tick, so the value may lag
+ * behind the precise clock by up to several milliseconds (typically 1-4 ms on
+ * Linux and 10-16 ms on Windows). Only the differences of the values are
+ * meaningful, they never decrease. If the system has no coarse clock the
+ * precise one used by #PTimeProfiler is read instead.
+ */
+P_LIB_API puint64		p_time_coarse_now_msecs		(void);
+
 /**
  * @brief Frees #PTimeProfiler object.
  * @param profiler #PTimeProfiler to free.
  * @since 0.0.1
+ *
+ * Only the profilers created with p_time_profiler_new() should be freed.
  */
 P_LIB_API void			p_time_profiler_free		(PTimeProfiler *	profiler);
 
@@ -0,0 +1,605 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "pmem.h"
+#include "ptimeprofiler.h"
+#include "ptimerwheel.h"
+
+#ifdef P_CC_MSVC
+#  include <intrin.h>
+#endif
+
+#define P_TIMER_WHEEL_LEVELS		4
+#define P_TIMER_WHEEL_SLOT_BITS		8
+#define P_TIMER_WHEEL_SLOTS		(1 << P_TIMER_WHEEL_SLOT_BITS)
+#define P_TIMER_WHEEL_SLOT_MASK		(P_TIMER_WHEEL_SLOTS - 1)
+#define P_TIMER_WHEEL_MAP_WORDS		(P_TIMER_WHEEL_SLOTS / 32)
+#define P_TIMER_WHEEL_MAX_DELTA		((puint64) P_MAXUINT32)
+
+typedef enum PTimerWheelState_ {
+	P_TIMER_WHEEL_STATE_SCHEDULED	= 0,	/* In a wheel slot			*/
+	P_TIMER_WHEEL_STATE_PENDING	= 1,	/* Expired, waiting for its callback	*/
+	P_TIMER_WHEEL_STATE_RUNNING	= 2,	/* Callback is running			*/
+	P_TIMER_WHEEL_STATE_CANCELLED	= 3	/* Cancelled from its own callback	*/
+} PTimerWheelState;
+
+/* Timers are linked through the address of the previous link, so a timer is
+ * unlinked in O(1) without looking for its list, slot is the level index in
+ * the upper bits and the slot index in the lower ones */
+struct PTimerWheelTimer_ {
+	PTimerWheelTimer	*next;
+	PTimerWheelTimer	**pprev;
+	puint64			expires;
+	PTimerWheelFunc		func;
+	ppointer		user_data;
+	puint			slot;
+	pint			state;
+};
+
+typedef struct PTimerWheelLevel_ {
+	PTimerWheelTimer	*slots[P_TIMER_WHEEL_SLOTS];
+	puint32			map[P_TIMER_WHEEL_MAP_WORDS];
+} PTimerWheelLevel;
+
+/* All ticks up to tick are processed, the time of tick N is start + N * resolution,
+ * elapsed is the wheel time since start: the time of the processed tick while the
+ * callbacks are running, and the last advanced time otherwise */
+struct PTimerWheel_ {
+	PTimerWheelLevel	levels[P_TIMER_WHEEL_LEVELS];
+	PTimerWheelTimer	*pending;
+	PTimerWheelTimer	*free_list;
+	puint64			start;
+	puint64			last;
+	puint64			elapsed;
+	puint64			tick;
+	puint32			resolution;
+	psize			count;
+};
+
+static puint pp_timer_wheel_ctz (puint32 mask);
+static pint pp_timer_wheel_find_slot (const PTimerWheelLevel *level, puint from, puint to);
+static void pp_timer_wheel_link (PTimerWheelTimer **head, PTimerWheelTimer *timer);
+static void pp_timer_wheel_unlink (PTimerWheel *wheel, PTimerWheelTimer *timer);
+static void pp_timer_wheel_insert (PTimerWheel *wheel, PTimerWheelTimer *timer);
+static void pp_timer_wheel_set_expires (PTimerWheel *wheel, PTimerWheelTimer *timer, puint64 delay);
+static void pp_timer_wheel_cascade (PTimerWheel *wheel, puint level_idx, puint slot);
+static puint64 pp_timer_wheel_next_tick (const PTimerWheel *wheel, puint64 target);
+static psize pp_timer_wheel_run_pending (PTimerWheel *wheel);
+static void pp_timer_wheel_release (PTimerWheel *wheel, PTimerWheelTimer *timer);
+static void pp_timer_wheel_free_list (PTimerWheelTimer *timer);
+
+static puint
+pp_timer_wheel_ctz (puint32 mask)
+{
+#if defined (P_CC_GNU) || defined (P_CC_CLANG)
+	return (puint) __builtin_ctz (mask);
+#elif defined (P_CC_MSVC)
+	unsigned long idx;
+
+	_BitScanForward (&idx, mask);
+
+	return (puint) idx;
+#else
+	puint idx;
+
+	for (idx = 0; (mask & 1) == 0; mask >>= 1)
+		++idx;
+
+	return idx;
+#endif
+}
+
+/* Finds the first non-empty slot in [from, to), -1 if there is none */
+static pint
+pp_timer_wheel_find_slot (const PTimerWheelLevel	*level,
+			  puint				from,
+			  puint				to)
+{
+	puint32	mask;
+	puint	word;
+	puint	idx;
+
+	while (from < to) {
+		word = from >> 5;
+		mask = level->map[word] & ((puint32) 0xFFFFFFFF << (from & 31));
+
+		if (mask != 0) {
+			idx = (word << 5) + pp_timer_wheel_ctz (mask);
+			return idx < to ? (pint) idx : -1;
+		}
+
+		from = (word + 1) << 5;
+	}
+
+	return -1;
+}
+
+static void
+pp_timer_wheel_link (PTimerWheelTimer	**head,
+		     PTimerWheelTimer	*timer)
+{
+	if ((timer->next = *head) != NULL)
+		timer->next->pprev = &timer->next;
+
+	timer->pprev = head;
+	*head        = timer;
+}
+
+static void
+pp_timer_wheel_unlink (PTimerWheel	*wheel,
+		       PTimerWheelTimer	*timer)
+{
+	PTimerWheelLevel *level;
+
+	if ((*timer->pprev = timer->next) != NULL)
+		timer->next->pprev = timer->pprev;
+
+	if (timer->state != P_TIMER_WHEEL_STATE_SCHEDULED)
+		return;
+
+	level = &wheel->levels[timer->slot >> P_TIMER_WHEEL_SLOT_BITS];
+
+	if (level->slots[timer->slot & P_TIMER_WHEEL_SLOT_MASK] == NULL)
+		level->map[(timer->slot & P_TIMER_WHEEL_SLOT_MASK) >> 5] &= ~((puint32) 1 << (timer->slot & 31));
+}
+
+static void
+pp_timer_wheel_insert (PTimerWheel	*wheel,
+		       PTimerWheelTimer	*timer)
+{
+	puint64	base;
+	puint64	expires;
+	puint64	delta;
+	puint	level_idx;
+	puint	slot;
+
+	/* Tick right after the current one is the nearest a timer can fire at */
+	base    = wheel->tick + 1;
+	expires = timer->expires < base ? base : timer->expires;
+	delta   = expires - base;
+
+	/* Too far timers wait in the last reachable slot and are placed again
+	 * when it is cascaded */
+	if (delta > P_TIMER_WHEEL_MAX_DELTA) {
+		delta   = P_TIMER_WHEEL_MAX_DELTA;
+		expires = base + P_TIMER_WHEEL_MAX_DELTA;
+	}
+
+	for (level_idx = 0; level_idx < P_TIMER_WHEEL_LEVELS - 1; ++level_idx) {
+		if (delta < ((puint64) 1 << ((level_idx + 1) * P_TIMER_WHEEL_SLOT_BITS)))
+			break;
+	}
+
+	slot = (puint) (expires >> (level_idx * P_TIMER_WHEEL_SLOT_BITS)) & P_TIMER_WHEEL_SLOT_MASK;
+
+	timer->state = P_TIMER_WHEEL_STATE_SCHEDULED;
+	timer->slot  = (level_idx << P_TIMER_WHEEL_SLOT_BITS) | slot;
+
+	pp_timer_wheel_link (&wheel->levels[level_idx].slots[slot], timer);
+	wheel->levels[level_idx].map[slot >> 5] |= (puint32) 1 << (slot & 31);
+}
+
+static void
+pp_timer_wheel_set_expires (PTimerWheel		*wheel,
+			    PTimerWheelTimer	*timer,
+			    puint64		delay)
+{
+	puint64 elapsed;
+
+	elapsed = wheel->elapsed;
+
+	if (P_UNLIKELY (delay > P_MAXUINT64 - elapsed - wheel->resolution))
+		delay = P_MAXUINT64 - elapsed - wheel->resolution;
+
+	/* Round up so a timer never fires before its delay has passed */
+	timer->expires = (elapsed + delay + wheel->resolution - 1) / wheel->resolution;
+}
+
+static void
+pp_timer_wheel_cascade (PTimerWheel	*wheel,
+			puint		level_idx,
+			puint		slot)
+{
+	PTimerWheelLevel	*level;
+	PTimerWheelTimer	*timer;
+	PTimerWheelTimer	*next;
+
+	level = &wheel->levels[level_idx];
+	timer = level->slots[slot];
+
+	if (timer == NULL)
+		return;
+
+	level->slots[slot]    = NULL;
+	level->map[slot >> 5] &= ~((puint32) 1 << (slot & 31));
+
+	for (; timer != NULL; timer = next) {
+		next = timer->next;
+		pp_timer_wheel_insert (wheel, timer);
+	}
+}
+
+/* Finds the next tick which has either timers to fire or an upper level slot
+ * to cascade, returns a value greater than target if there is none */
+static puint64
+pp_timer_wheel_next_tick (const PTimerWheel	*wheel,
+			  puint64		target)
+{
+	const PTimerWheelLevel	*level0;
+	puint64			next;
+	puint			level_idx;
+	puint			shift;
+	pint			idx;
+
+	level0 = &wheel->levels[0];
+	next   = wheel->tick + 1;
+
+	while (next <= target) {
+		if ((next & P_TIMER_WHEEL_SLOT_MASK) != 0) {
+			idx = pp_timer_wheel_find_slot (level0,
+							(puint) (next & P_TIMER_WHEEL_SLOT_MASK),
+							P_TIMER_WHEEL_SLOTS);
+
+			if (idx >= 0)
+				return (next & ~((puint64) P_TIMER_WHEEL_SLOT_MASK)) + (puint64) idx;
+
+			next = (next | P_TIMER_WHEEL_SLOT_MASK) + 1;
+			continue;
+		}
+
+		if (level0->slots[0] != NULL)
+			return next;
+
+		for (level_idx = 1; level_idx < P_TIMER_WHEEL_LEVELS; ++level_idx) {
+			shift = level_idx * P_TIMER_WHEEL_SLOT_BITS;
+
+			if ((next & (((puint64) 1 << shift) - 1)) != 0)
+				break;
+
+			if (wheel->levels[level_idx].slots[(next >> shift) & P_TIMER_WHEEL_SLOT_MASK] != NULL)
+				return next;
+		}
+
+		++next;
+	}
+
+	return next;
+}
+
+static psize
+pp_timer_wheel_run_pending (PTimerWheel *wheel)
+{
+	PTimerWheelTimer	*timer;
+	psize			fired;
+
+	fired = 0;
+
+	while ((timer = wheel->pending) != NULL) {
+		pp_timer_wheel_unlink (wheel, timer);
+		--wheel->count;
+
+		timer->state = P_TIMER_WHEEL_STATE_RUNNING;
+		timer->func (wheel, timer, timer->user_data);
+
+		++fired;
+
+		/* The callback may have rescheduled the timer */
+		if (timer->state == P_TIMER_WHEEL_STATE_RUNNING ||
+		    timer->state == P_TIMER_WHEEL_STATE_CANCELLED)
+			pp_timer_wheel_release (wheel, timer);
+	}
+
+	return fired;
+}
+
+static void
+pp_timer_wheel_release (PTimerWheel		*wheel,
+			PTimerWheelTimer	*timer)
+{
+	/* Released timers are kept for reuse until the wheel is freed */
+	timer->state     = P_TIMER_WHEEL_STATE_CANCELLED;
+	timer->next      = wheel->free_list;
+	wheel->free_list = timer;
+}
+
+static void
+pp_timer_wheel_free_list (PTimerWheelTimer *timer)
+{
+	PTimerWheelTimer *next;
+
+	for (; timer != NULL; timer = next) {
+		next = timer->next;
+		p_free (timer);
+	}
+}
+
+P_LIB_API PTimerWheel *
+p_timer_wheel_new (puint32 resolution)
+{
+	return p_timer_wheel_new_full (resolution, p_time_coarse_now_msecs ());
+}
+
+P_LIB_API PTimerWheel *
+p_timer_wheel_new_full (puint32	resolution,
+			puint64	now)
+{
+	PTimerWheel *ret;
+
+	if (P_UNLIKELY (resolution == 0))
+		return NULL;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PTimerWheel))) == NULL)) {
+		P_ERROR ("PTimerWheel::p_timer_wheel_new_full: failed to allocate memory");
+		return NULL;
+	}
+
+	ret->start      = now;
+	ret->last       = now;
+	ret->resolution = resolution;
+
+	return ret;
+}
+
+P_LIB_API PTimerWheelTimer *
+p_timer_wheel_schedule (PTimerWheel	*wheel,
+			puint64		delay,
+			PTimerWheelFunc	func,
+			ppointer	user_data)
+{
+	PTimerWheelTimer *timer;
+
+	if (P_UNLIKELY (wheel == NULL || func == NULL))
+		return NULL;
+
+	if (wheel->free_list != NULL) {
+		timer            = wheel->free_list;
+		wheel->free_list = timer->next;
+	} else if (P_UNLIKELY ((timer = p_malloc0 (sizeof (PTimerWheelTimer))) == NULL)) {
+		P_ERROR ("PTimerWheel::p_timer_wheel_schedule: failed to allocate memory");
+		return NULL;
+	}
+
+	timer->func      = func;
+	timer->user_data = user_data;
+
+	pp_timer_wheel_set_expires (wheel, timer, delay);
+	pp_timer_wheel_insert (wheel, timer);
+
+	++wheel->count;
+
+	return timer;
+}
+
+P_LIB_API pboolean
+p_timer_wheel_reschedule (PTimerWheel		*wheel,
+			  PTimerWheelTimer	*timer,
+			  puint64		delay)
+{
+	if (P_UNLIKELY (wheel == NULL || timer == NULL))
+		return FALSE;
+
+	if (P_UNLIKELY (timer->state == P_TIMER_WHEEL_STATE_CANCELLED))
+		return FALSE;
+
+	if (timer->state == P_TIMER_WHEEL_STATE_RUNNING)
+		++wheel->count;
+	else
+		pp_timer_wheel_unlink (wheel, timer);
+
+	pp_timer_wheel_set_expires (wheel, timer, delay);
+	pp_timer_wheel_insert (wheel, timer);
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_timer_wheel_cancel (PTimerWheel	*wheel,
+		      PTimerWheelTimer	*timer)
+{
+	if (P_UNLIKELY (wheel == NULL || timer == NULL))
+		return FALSE;
+
+	switch (timer->state) {
+	case P_TIMER_WHEEL_STATE_CANCELLED:
+		return FALSE;
+	case P_TIMER_WHEEL_STATE_RUNNING:
+		/* Released by the caller of the callback */
+		timer->state = P_TIMER_WHEEL_STATE_CANCELLED;
+		return TRUE;
+	default:
+		pp_timer_wheel_unlink (wheel, timer);
+		--wheel->count;
+
+		pp_timer_wheel_release (wheel, timer);
+		return TRUE;
+	}
+}
+
+P_LIB_API psize
+p_timer_wheel_advance (PTimerWheel	*wheel,
+		       puint64		now)
+{
+	PTimerWheelTimer	**slot;
+	PTimerWheelTimer	*timer;
+	puint64			target;
+	puint64			next;
+	puint			level_idx;
+	puint			shift;
+	psize			fired;
+
+	if (P_UNLIKELY (wheel == NULL))
+		return 0;
+
+	if (now > wheel->last)
+		wheel->last = now;
+
+	target = (wheel->last - wheel->start) / wheel->resolution;
+	fired  = 0;
+
+	while (wheel->tick < target) {
+		if (wheel->count == 0) {
+			wheel->tick = target;
+			break;
+		}
+
+		next = pp_timer_wheel_next_tick (wheel, target);
+
+		if (next > target) {
+			wheel->tick = target;
+			break;
+		}
+
+		/* Cascaded timers are placed relative to the tick being processed */
+		wheel->tick = next - 1;
+
+		for (level_idx = 1; level_idx < P_TIMER_WHEEL_LEVELS; ++level_idx) {
+			shift = level_idx * P_TIMER_WHEEL_SLOT_BITS;
+
+			if ((next & (((puint64) 1 << shift) - 1)) != 0)
+				break;
+
+			pp_timer_wheel_cascade (wheel,
+						level_idx,
+						(puint) (next >> shift) & P_TIMER_WHEEL_SLOT_MASK);
+		}
+
+		wheel->tick = next;
+
+		/* Detach the whole slot first: the callbacks may schedule new
+		 * timers into the same slot for the next round */
+		slot = &wheel->levels[0].slots[next & P_TIMER_WHEEL_SLOT_MASK];
+
+		if (*slot == NULL)
+			continue;
+
+		wheel->pending = *slot;
+		wheel->pending->pprev = &wheel->pending;
+		*slot = NULL;
+
+		wheel->levels[0].map[(next & P_TIMER_WHEEL_SLOT_MASK) >> 5] &= ~((puint32) 1 << (next & 31));
+
+		for (timer = wheel->pending; timer != NULL; timer = timer->next)
+			timer->state = P_TIMER_WHEEL_STATE_PENDING;
+
+		/* Periodic timers rescheduled from the callbacks keep their pace */
+		wheel->elapsed = next * wheel->resolution;
+		fired += pp_timer_wheel_run_pending (wheel);
+	}
+
+	wheel->elapsed = wheel->last - wheel->start;
+
+	return fired;
+}
+
+P_LIB_API psize
+p_timer_wheel_process (PTimerWheel *wheel)
+{
+	if (P_UNLIKELY (wheel == NULL))
+		return 0;
+
+	return p_timer_wheel_advance (wheel, p_time_coarse_now_msecs ());
+}
+
+P_LIB_API pint
+p_timer_wheel_get_timeout (const PTimerWheel *wheel)
+{
+	const PTimerWheelLevel	*level;
+	puint64			base;
+	puint64			block;
+	puint64			best;
+	puint64			candidate;
+	puint64			elapsed;
+	puint			level_idx;
+	puint			shift;
+	puint			cur;
+	pint			idx;
+
+	if (P_UNLIKELY (wheel == NULL || wheel->count == 0))
+		return -1;
+
+	if (wheel->pending != NULL)
+		return 0;
+
+	base = wheel->tick + 1;
+	best = P_MAXUINT64;
+
+	/* The earliest timer of an upper level slot can't fire before the slot is
+	 * cascaded, which gives a lower bound without looking at the timers */
+	for (level_idx = 0; level_idx < P_TIMER_WHEEL_LEVELS; ++level_idx) {
+		level = &wheel->levels[level_idx];
+		shift = level_idx * P_TIMER_WHEEL_SLOT_BITS;
+		block = (base + ((puint64) 1 << shift) - 1) >> shift;
+		cur   = (puint) block & P_TIMER_WHEEL_SLOT_MASK;
+
+		if ((idx = pp_timer_wheel_find_slot (level, cur, P_TIMER_WHEEL_SLOTS)) < 0 &&
+		    (idx = pp_timer_wheel_find_slot (level, 0, cur)) < 0)
+			continue;
+
+		candidate = (block + (((puint) idx - cur) & P_TIMER_WHEEL_SLOT_MASK)) << shift;
+
+		if (candidate < best)
+			best = candidate;
+	}
+
+	if (P_UNLIKELY (best > P_MAXUINT64 / wheel->resolution))
+		return P_MAXINT32;
+
+	best    *= wheel->resolution;
+	elapsed  = wheel->elapsed;
+
+	if (best <= elapsed)
+		return 0;
+
+	return best - elapsed > (puint64) P_MAXINT32 ? P_MAXINT32 : (pint) (best - elapsed);
+}
+
+P_LIB_API psize
+p_timer_wheel_get_count (const PTimerWheel *wheel)
+{
+	if (P_UNLIKELY (wheel == NULL))
+		return 0;
+
+	return wheel->count;
+}
+
+P_LIB_API void
+p_timer_wheel_free (PTimerWheel *wheel)
+{
+	puint level_idx;
+	puint slot;
+
+	if (P_UNLIKELY (wheel == NULL))
+		return;
+
+	for (level_idx = 0; level_idx < P_TIMER_WHEEL_LEVELS; ++level_idx) {
+		for (slot = 0; slot < P_TIMER_WHEEL_SLOTS; ++slot)
+			pp_timer_wheel_free_list (wheel->levels[level_idx].slots[slot]);
+	}
+
+	pp_timer_wheel_free_list (wheel->pending);
+	pp_timer_wheel_free_list (wheel->free_list);
+
+	p_free (wheel);
+}
@@ -0,0 +1,229 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file ptimerwheel.h
+ * @brief Hierarchical timer wheel
+ * @author Alexander Saprykin
+ *
+ * A timer wheel manages a large number of timeouts (connection idle timers,
+ * retransmissions, lease expirations) where most of the timers are cancelled
+ * or moved long before they fire. Scheduling, rescheduling and cancelling a
+ * timer take O(1) time regardless of the number of timers, unlike a sorted
+ * list or a tree of deadlines.
+ *
+ * The time is divided into ticks of a fixed resolution passed to
+ * p_timer_wheel_new(), and the timers are spread over four levels of 256 slots:
+ * the first level holds the timers which fire within 256 ticks, each next
+ * level is 256 times coarser. When the wheel crosses a slot boundary of an
+ * upper level, the timers from that slot are moved one level down, so every
+ * timer is moved at most three times during its life. Timers fire with a tick
+ * precision and never earlier than requested. Delays longer than 2^32 ticks
+ * are supported as well, such timers just wait on the top level for a few more
+ * rounds.
+ *
+ * The wheel does not use its own thread. Call p_timer_wheel_process() (or
+ * p_timer_wheel_advance() with an own clock) regularly to fire the expired
+ * timers: all the ticks passed since the previous call are handled in one
+ * batch, empty slots are skipped without looking at them. The callback of a
+ * fired timer may schedule, reschedule or cancel any timers, including the
+ * fired one itself: rescheduling it from the callback makes a periodic timer.
+ * A timer which is neither rescheduled nor cancelled is released after its
+ * callback returns, and its pointer must not be used anymore.
+ *
+ * In an event loop pass the result of p_timer_wheel_get_timeout() to
+ * p_socket_poller_wait() (or any other wait call) to sleep until the next
+ * timer is due, and call p_timer_wheel_process() after the wait returns.
+ *
+ * p_timer_wheel_new() takes the time from the coarse monotonic clock, see
+ * p_time_coarse_now_msecs(), which is cheap enough to be read on every loop
+ * iteration. A wheel is not thread-safe: schedule timers and process them
+ * from the same thread, or guard the calls with a lock.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PTIMERWHEEL_H
+#define PLIBSYS_HEADER_PTIMERWHEEL_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+
+P_BEGIN_DECLS
+
+/** Timer wheel opaque data structure. */
+typedef struct PTimerWheel_ PTimerWheel;
+
+/** Timer opaque data structure. */
+typedef struct PTimerWheelTimer_ PTimerWheelTimer;
+
+/**
+ * @brief Timer callback.
+ * @param wheel Timer wheel the timer belongs to.
+ * @param timer Fired timer.
+ * @param user_data Data passed on scheduling.
+ */
+typedef void (*PTimerWheelFunc) (PTimerWheel		*wheel,
+				 PTimerWheelTimer	*timer,
+				 ppointer		user_data);
+
+/**
+ * @brief Creates a new timer wheel driven by the coarse monotonic clock.
+ * @param resolution Tick length in milliseconds, must be greater than zero.
+ * @return Pointer to a newly created #PTimerWheel in case of success, NULL
+ * otherwise.
+ * @since 0.0.5
+ * @note Use p_timer_wheel_process() to fire the timers of this wheel.
+ */
+P_LIB_API PTimerWheel *		p_timer_wheel_new		(puint32		resolution);
+
+/**
+ * @brief Creates a new timer wheel driven by an own clock.
+ * @param resolution Tick length in the clock units, must be greater than zero.
+ * @param now Current clock value.
+ * @return Pointer to a newly created #PTimerWheel in case of success, NULL
+ * otherwise.
+ * @since 0.0.5
+ * @note Use p_timer_wheel_advance() with the values of the same clock to fire
+ * the timers of this wheel.
+ *
+ * The clock must be monotonic, its units are used for the delays and the
+ * timeouts instead of milliseconds.
+ */
+P_LIB_API PTimerWheel *		p_timer_wheel_new_full		(puint32		resolution,
+								 puint64		now);
+
+/**
+ * @brief Schedules a new timer.
+ * @param wheel Timer wheel to schedule the timer in.
+ * @param delay Delay since the current wheel time, in milliseconds.
+ * @param func Callback to call when the timer fires.
+ * @param user_data Data to pass into @a func.
+ * @return Pointer to the new timer in case of success, NULL otherwise.
+ * @since 0.0.5
+ *
+ * The timer fires on the first tick which is at least @a delay later than the
+ * wheel time, i.e. a zero delay fires on the next tick. The wheel time is the
+ * time of the last p_timer_wheel_advance() call, or the time of the expired
+ * tick within a timer callback.
+ */
+P_LIB_API PTimerWheelTimer *	p_timer_wheel_schedule		(PTimerWheel		*wheel,
+								 puint64		delay,
+								 PTimerWheelFunc	func,
+								 ppointer		user_data);
+
+/**
+ * @brief Moves a timer to a new deadline.
+ * @param wheel Timer wheel the timer belongs to.
+ * @param timer Timer to reschedule.
+ * @param delay New delay since the current wheel time, in milliseconds, see
+ * p_timer_wheel_schedule().
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * This call takes O(1) time. It can be used from the callback of the @a timer
+ * itself to make it fire again: the delay is counted from the tick it expired
+ * at, so a periodic timer does not drift even if the wheel is advanced late.
+ */
+P_LIB_API pboolean		p_timer_wheel_reschedule	(PTimerWheel		*wheel,
+								 PTimerWheelTimer	*timer,
+								 puint64		delay);
+
+/**
+ * @brief Cancels a timer.
+ * @param wheel Timer wheel the timer belongs to.
+ * @param timer Timer to cancel.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The timer is released and its pointer must not be used anymore. If the
+ * timer is cancelled from its own callback, it is released after the callback
+ * returns. This call takes O(1) time.
+ */
+P_LIB_API pboolean		p_timer_wheel_cancel		(PTimerWheel		*wheel,
+								 PTimerWheelTimer	*timer);
+
+/**
+ * @brief Advances a timer wheel and fires the expired timers.
+ * @param wheel Timer wheel to advance.
+ * @param now Current clock value.
+ * @return Number of the fired timers.
+ * @since 0.0.5
+ *
+ * All the ticks passed since the previous call are processed, the timers of
+ * every tick are fired in no particular order. A value of @a now which is
+ * less than the previous one is treated as no progress. Do not call this
+ * function from a timer callback.
+ */
+P_LIB_API psize			p_timer_wheel_advance		(PTimerWheel		*wheel,
+								 puint64		now);
+
+/**
+ * @brief Advances a timer wheel to the coarse monotonic clock time.
+ * @param wheel Timer wheel to advance.
+ * @return Number of the fired timers.
+ * @since 0.0.5
+ *
+ * Same as p_timer_wheel_advance() with the value of p_time_coarse_now_msecs().
+ * Use it only for the wheels created with p_timer_wheel_new().
+ */
+P_LIB_API psize			p_timer_wheel_process		(PTimerWheel		*wheel);
+
+/**
+ * @brief Gets the time until the next timer may fire.
+ * @param wheel Timer wheel to check.
+ * @return Timeout in milliseconds since the last time the wheel was advanced,
+ * -1 if there are no timers.
+ * @since 0.0.5
+ *
+ * The value can be passed as a timeout to p_socket_poller_wait(). For the
+ * timers far in the future it points to the moment they are moved to a lower
+ * level, so a wait may end without any timer fired, but never after a timer is
+ * due. The value is limited with #P_MAXINT32.
+ */
+P_LIB_API pint			p_timer_wheel_get_timeout	(const PTimerWheel	*wheel);
+
+/**
+ * @brief Gets the number of scheduled timers.
+ * @param wheel Timer wheel to check.
+ * @return Number of the timers waiting to fire.
+ * @since 0.0.5
+ */
+P_LIB_API psize			p_timer_wheel_get_count		(const PTimerWheel	*wheel);
+
+/**
+ * @brief Frees a timer wheel.
+ * @param wheel Timer wheel to free.
+ * @since 0.0.5
+ *
+ * All the timers are released without calling their callbacks.
+ */
+P_LIB_API void			p_timer_wheel_free		(PTimerWheel		*wheel);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PTIMERWHEEL_H */
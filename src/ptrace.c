@@ -0,0 +1,709 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Each thread writes its records into its own SPSC ring, the collector is the
+ * only consumer of all the rings. The rings and the collector state belong to
+ * a reference counted registry: a thread holds a reference through its buffer,
+ * so the buffers of the threads which outlive the library shutdown can still
+ * be freed on the thread exit, like the caches of a #PMemPool. A thread keeps
+ * a stack of its open spans to put the name and the arguments into the end
+ * records as well. The span names are registered in a static table which
+ * survives the shutdown, so the IDs cached at the call sites stay valid. */
+
+#include "ptrace.h"
+
+#ifdef PLIBSYS_TRACE
+#  include "patomic.h"
+#  include "pcondvariable.h"
+#  include "pmem.h"
+#  include "pmutex.h"
+#  include "ponce.h"
+#  include "pringspsc.h"
+#  include "pstring.h"
+#  include "ptimeprofiler.h"
+#  include "puthread.h"
+#  include "puthread-private.h"
+
+#  include <string.h>
+
+#  define P_TRACE_DRAIN_BATCH		256
+#  define P_TRACE_DEFAULT_INTERVAL	10
+
+typedef struct PTraceRawRecord_ {
+	puint64		ticks;
+	puint32		name_id;
+	puint32		type;
+	puint64		args[2];
+} PTraceRawRecord;
+
+typedef struct PTraceStackEntry_ {
+	puint32		name_id;
+	pboolean	recorded;
+	puint64		args[2];
+} PTraceStackEntry;
+
+typedef struct PTraceRegistry_ PTraceRegistry;
+
+typedef struct PTraceBuffer_ {
+	PTraceRegistry		*registry;
+	struct PTraceBuffer_	*next;
+	PRingSPSC		*ring;
+	puint32			thread_id;
+	pchar			*thread_name;
+	pboolean		orphaned;
+	pint			depth;
+	PTraceStackEntry	stack[P_TRACE_MAX_DEPTH];
+} PTraceBuffer;
+
+struct PTraceRegistry_ {
+	PMutex			*mutex;
+	PCondVariable		*cond;
+	PTraceBuffer		*buffers;
+	puint32			last_thread_id;
+	pint			ref_count;
+	pboolean		is_freed;
+	PUThread		*collector;
+	pboolean		running;
+	pboolean		stopping;
+	PTraceFunc		func;
+	ppointer		user_data;
+	puint			interval_ms;
+	puint64			start_ticks;
+};
+
+static POnce			pp_trace_once      = P_ONCE_INIT;
+static PTraceRegistry		*pp_trace_registry = NULL;
+static PUThreadStaticKey	*pp_trace_key      = NULL;
+static volatile pint		pp_trace_enabled   = 0;
+static volatile pint64		pp_trace_dropped   = 0;
+
+static volatile pint	pp_trace_names_lock  = 0;
+static volatile pint	pp_trace_names_count = 0;
+static const pchar	*pp_trace_names[P_TRACE_MAX_NAMES];
+
+static void pp_trace_init (ppointer data);
+static void pp_trace_registry_unref (PTraceRegistry *registry);
+static PTraceBuffer * pp_trace_buffer_new (void);
+static void pp_trace_buffer_unlink (PTraceRegistry *registry, PTraceBuffer *buffer);
+static void pp_trace_buffer_free (PTraceBuffer *buffer);
+static void pp_trace_buffer_thread_exit (ppointer data);
+static puint32 pp_trace_register_name (const pchar *name);
+static pboolean pp_trace_write (PTraceBuffer *buffer, const PTraceStackEntry *entry, PTraceEventType type);
+static void pp_trace_drain_buffer (PTraceRegistry *registry, PTraceBuffer *buffer, pboolean deliver);
+static void pp_trace_drain (PTraceRegistry *registry, pboolean deliver);
+static ppointer pp_trace_collector_func (ppointer data);
+
+static void
+pp_trace_registry_unref (PTraceRegistry *registry)
+{
+	if (p_atomic_int_dec_and_test (&registry->ref_count) == FALSE)
+		return;
+
+	p_cond_variable_free (registry->cond);
+	p_mutex_free (registry->mutex);
+	p_free (registry);
+}
+
+static PTraceBuffer *
+pp_trace_buffer_new (void)
+{
+	PTraceRegistry	*registry = pp_trace_registry;
+	PTraceBuffer	*buffer;
+	PUThreadBase	*thread;
+
+	if (P_UNLIKELY (registry == NULL))
+		return NULL;
+
+	if (P_UNLIKELY ((buffer = p_malloc0 (sizeof (PTraceBuffer))) == NULL))
+		return NULL;
+
+	if (P_UNLIKELY ((buffer->ring = p_ring_spsc_new (sizeof (PTraceRawRecord),
+							 P_TRACE_BUFFER_SIZE)) == NULL)) {
+		p_free (buffer);
+		return NULL;
+	}
+
+	/* Copied, the buffer may outlive the thread object */
+	if ((thread = (PUThreadBase *) p_uthread_current ()) != NULL && thread->name != NULL)
+		buffer->thread_name = p_strdup (thread->name);
+
+	buffer->registry = registry;
+	p_atomic_int_inc (&registry->ref_count);
+
+	p_mutex_lock (registry->mutex);
+
+	buffer->thread_id = ++registry->last_thread_id;
+	buffer->next      = registry->buffers;
+	registry->buffers = buffer;
+
+	p_mutex_unlock (registry->mutex);
+
+	p_uthread_set_static_local (pp_trace_key, buffer);
+
+	return buffer;
+}
+
+/* Must be called with the registry locked */
+static void
+pp_trace_buffer_unlink (PTraceRegistry	*registry,
+			PTraceBuffer	*buffer)
+{
+	PTraceBuffer **link;
+
+	for (link = &registry->buffers; *link != NULL; link = &(*link)->next) {
+		if (*link == buffer) {
+			*link = buffer->next;
+			break;
+		}
+	}
+}
+
+static void
+pp_trace_buffer_free (PTraceBuffer *buffer)
+{
+	PTraceRegistry *registry = buffer->registry;
+
+	if (buffer->ring != NULL)
+		p_ring_spsc_free (buffer->ring);
+
+	p_free (buffer->thread_name);
+	p_free (buffer);
+
+	pp_trace_registry_unref (registry);
+}
+
+static void
+pp_trace_buffer_thread_exit (ppointer data)
+{
+	PTraceBuffer	*buffer   = (PTraceBuffer *) data;
+	PTraceRegistry	*registry = buffer->registry;
+
+	p_mutex_lock (registry->mutex);
+
+	/* The collector delivers the rest of the records before freeing */
+	if (registry->running == TRUE && registry->is_freed == FALSE) {
+		buffer->orphaned = TRUE;
+		p_mutex_unlock (registry->mutex);
+		return;
+	}
+
+	pp_trace_buffer_unlink (registry, buffer);
+
+	p_mutex_unlock (registry->mutex);
+
+	pp_trace_buffer_free (buffer);
+}
+
+static puint32
+pp_trace_register_name (const pchar *name)
+{
+	pint count;
+	pint i;
+
+	if (P_UNLIKELY (name == NULL))
+		return 0;
+
+	while (p_atomic_int_compare_and_exchange (&pp_trace_names_lock, 0, 1) == FALSE)
+		p_uthread_yield ();
+
+	count = p_atomic_int_get (&pp_trace_names_count);
+
+	for (i = 0; i < count; ++i) {
+		if (pp_trace_names[i] == name || strcmp (pp_trace_names[i], name) == 0)
+			break;
+	}
+
+	if (i == count && count < P_TRACE_MAX_NAMES) {
+		pp_trace_names[count] = name;
+		p_atomic_int_set (&pp_trace_names_count, count + 1);
+	}
+
+	p_atomic_int_set (&pp_trace_names_lock, 0);
+
+	return i < P_TRACE_MAX_NAMES ? (puint32) (i + 1) : 0;
+}
+
+static pboolean
+pp_trace_write (PTraceBuffer		*buffer,
+		const PTraceStackEntry	*entry,
+		PTraceEventType		type)
+{
+	PTraceRawRecord	*record;
+	psize		reserved;
+
+	record = (PTraceRawRecord *) p_ring_spsc_reserve (buffer->ring, 1, &reserved);
+
+	if (P_UNLIKELY (record == NULL)) {
+		p_atomic_int64_add_explicit (&pp_trace_dropped, 1, P_ATOMIC_MEMORY_ORDER_RELAXED);
+		return FALSE;
+	}
+
+	record->ticks   = p_time_profiler_ticks ();
+	record->name_id = entry->name_id;
+	record->type    = (puint32) type;
+	record->args[0] = entry->args[0];
+	record->args[1] = entry->args[1];
+
+	p_ring_spsc_commit (buffer->ring, 1);
+
+	return TRUE;
+}
+
+/* Must be called with the registry locked */
+static void
+pp_trace_drain_buffer (PTraceRegistry	*registry,
+		       PTraceBuffer	*buffer,
+		       pboolean		deliver)
+{
+	PTraceRecord		records[P_TRACE_DRAIN_BATCH];
+	const PTraceRawRecord	*raw;
+	psize			available;
+	psize			i;
+
+	while ((raw = (const PTraceRawRecord *) p_ring_spsc_peek (buffer->ring, &available)) != NULL) {
+		if (available > P_TRACE_DRAIN_BATCH)
+			available = P_TRACE_DRAIN_BATCH;
+
+		if (deliver == FALSE) {
+			p_ring_spsc_release (buffer->ring, available);
+			continue;
+		}
+
+		for (i = 0; i < available; ++i) {
+			records[i].timestamp   = raw[i].ticks > registry->start_ticks ?
+						 p_time_profiler_ticks_to_nsecs (raw[i].ticks - registry->start_ticks) :
+						 0;
+			records[i].thread_id   = buffer->thread_id;
+			records[i].thread_name = buffer->thread_name;
+			records[i].name_id     = raw[i].name_id;
+			records[i].type        = (PTraceEventType) raw[i].type;
+			records[i].args[0]     = raw[i].args[0];
+			records[i].args[1]     = raw[i].args[1];
+		}
+
+		p_ring_spsc_release (buffer->ring, available);
+
+		registry->func (records, available, registry->user_data);
+	}
+}
+
+/* Must be called with the registry locked */
+static void
+pp_trace_drain (PTraceRegistry	*registry,
+		pboolean	deliver)
+{
+	PTraceBuffer *buffer;
+	PTraceBuffer *next;
+
+	for (buffer = registry->buffers; buffer != NULL; buffer = next) {
+		next = buffer->next;
+
+		/* The owner has exited, nothing is written after the flag */
+		if (buffer->orphaned == TRUE) {
+			pp_trace_drain_buffer (registry, buffer, deliver);
+			pp_trace_buffer_unlink (registry, buffer);
+
+			/* The registry is referenced by the caller as well */
+			pp_trace_buffer_free (buffer);
+			continue;
+		}
+
+		pp_trace_drain_buffer (registry, buffer, deliver);
+	}
+}
+
+static ppointer
+pp_trace_collector_func (ppointer data)
+{
+	PTraceRegistry *registry = (PTraceRegistry *) data;
+
+	p_mutex_lock (registry->mutex);
+
+	while (registry->stopping == FALSE) {
+		pp_trace_drain (registry, TRUE);
+
+		if (registry->stopping == TRUE)
+			break;
+
+		/* Not all the platforms support finite timeouts */
+		if (p_cond_variable_wait_timed (registry->cond, registry->mutex, (pint) registry->interval_ms) < 0) {
+			p_mutex_unlock (registry->mutex);
+			p_uthread_sleep ((puint32) registry->interval_ms);
+			p_mutex_lock (registry->mutex);
+		}
+	}
+
+	p_mutex_unlock (registry->mutex);
+
+	return NULL;
+}
+
+static void
+pp_trace_init (ppointer data)
+{
+	PTraceRegistry *registry;
+
+	P_UNUSED (data);
+
+	if (P_UNLIKELY ((registry = p_malloc0 (sizeof (PTraceRegistry))) == NULL)) {
+		P_ERROR ("PTrace::pp_trace_init: failed to allocate memory");
+		return;
+	}
+
+	registry->mutex     = p_mutex_new ();
+	registry->cond      = p_cond_variable_new ();
+	registry->ref_count = 1;
+
+	if (P_UNLIKELY (registry->mutex == NULL || registry->cond == NULL)) {
+		P_ERROR ("PTrace::pp_trace_init: failed to create synchronization primitives");
+		pp_trace_registry_unref (registry);
+		return;
+	}
+
+	if (P_UNLIKELY ((pp_trace_key = p_uthread_static_local_new (pp_trace_buffer_thread_exit)) == NULL)) {
+		P_ERROR ("PTrace::pp_trace_init: failed to allocate TLS key");
+		pp_trace_registry_unref (registry);
+		return;
+	}
+
+	pp_trace_registry = registry;
+}
+
+void
+p_trace_shutdown (void)
+{
+	PTraceRegistry	*registry = pp_trace_registry;
+	PTraceBuffer	*buffer;
+	PTraceBuffer	*next;
+	PTraceBuffer	*own_buffer;
+
+	/* Let the next library initialization start over */
+	pp_trace_once = P_ONCE_INIT;
+
+	if (P_UNLIKELY (registry == NULL))
+		return;
+
+	p_trace_stop ();
+
+	own_buffer = (PTraceBuffer *) p_uthread_get_static_local (pp_trace_key);
+
+	if (own_buffer != NULL)
+		p_uthread_set_static_local (pp_trace_key, NULL);
+
+	p_uthread_static_local_free (pp_trace_key);
+
+	pp_trace_key      = NULL;
+	pp_trace_registry = NULL;
+
+	p_mutex_lock (registry->mutex);
+
+	registry->is_freed = TRUE;
+
+	/* Buffers of the other threads stay until they exit */
+	for (buffer = registry->buffers; buffer != NULL; buffer = next) {
+		next = buffer->next;
+
+		if (buffer == own_buffer || buffer->orphaned == TRUE) {
+			pp_trace_buffer_unlink (registry, buffer);
+			pp_trace_buffer_free (buffer);
+			continue;
+		}
+
+		p_ring_spsc_free (buffer->ring);
+		buffer->ring = NULL;
+	}
+
+	p_mutex_unlock (registry->mutex);
+
+	pp_trace_registry_unref (registry);
+}
+
+P_LIB_API pboolean
+p_trace_start (PTraceFunc	func,
+	       ppointer		user_data,
+	       puint		interval_ms)
+{
+	PTraceRegistry *registry;
+
+	if (P_UNLIKELY (func == NULL))
+		return FALSE;
+
+	/* Recording is the only reason to set up the registry */
+	p_once (&pp_trace_once, pp_trace_init, NULL);
+
+	if (P_UNLIKELY ((registry = pp_trace_registry) == NULL))
+		return FALSE;
+
+	p_mutex_lock (registry->mutex);
+
+	if (registry->running == TRUE) {
+		p_mutex_unlock (registry->mutex);
+		return FALSE;
+	}
+
+	pp_trace_drain (registry, FALSE);
+
+	registry->func        = func;
+	registry->user_data   = user_data;
+	registry->interval_ms = interval_ms > 0 ? interval_ms : P_TRACE_DEFAULT_INTERVAL;
+	registry->stopping    = FALSE;
+	registry->start_ticks = p_time_profiler_ticks ();
+
+	p_atomic_int64_set (&pp_trace_dropped, 0);
+
+	/* The collector waits for the lock until the state is complete */
+	registry->collector = p_uthread_create (pp_trace_collector_func, registry, TRUE, "ptrace");
+
+	if (P_UNLIKELY (registry->collector == NULL)) {
+		p_mutex_unlock (registry->mutex);
+		return FALSE;
+	}
+
+	registry->running = TRUE;
+	p_atomic_int_set (&pp_trace_enabled, 1);
+
+	p_mutex_unlock (registry->mutex);
+
+	return TRUE;
+}
+
+P_LIB_API void
+p_trace_stop (void)
+{
+	PTraceRegistry *registry = pp_trace_registry;
+
+	if (P_UNLIKELY (registry == NULL))
+		return;
+
+	p_mutex_lock (registry->mutex);
+
+	if (registry->running == FALSE || registry->stopping == TRUE) {
+		p_mutex_unlock (registry->mutex);
+		return;
+	}
+
+	p_atomic_int_set (&pp_trace_enabled, 0);
+
+	registry->stopping = TRUE;
+	p_cond_variable_signal (registry->cond);
+
+	p_mutex_unlock (registry->mutex);
+
+	p_uthread_join (registry->collector);
+	p_uthread_unref (registry->collector);
+
+	p_mutex_lock (registry->mutex);
+
+	pp_trace_drain (registry, TRUE);
+
+	registry->collector = NULL;
+	registry->running   = FALSE;
+
+	p_mutex_unlock (registry->mutex);
+}
+
+P_LIB_API pboolean
+p_trace_is_enabled (void)
+{
+	return p_atomic_int_get (&pp_trace_enabled) != 0;
+}
+
+P_LIB_API puint64
+p_trace_get_dropped (void)
+{
+	return (puint64) p_atomic_int64_get (&pp_trace_dropped);
+}
+
+P_LIB_API puint64
+p_trace_get_timestamp (void)
+{
+	PTraceRegistry	*registry = pp_trace_registry;
+	puint64		ticks;
+
+	if (P_UNLIKELY (registry == NULL) || p_atomic_int_get (&pp_trace_enabled) == 0)
+		return 0;
+
+	ticks = p_time_profiler_ticks ();
+
+	return ticks > registry->start_ticks ? p_time_profiler_ticks_to_nsecs (ticks - registry->start_ticks) : 0;
+}
+
+P_LIB_API const pchar *
+p_trace_get_name (puint32 name_id)
+{
+	if (name_id == 0 || name_id > (puint32) p_atomic_int_get (&pp_trace_names_count))
+		return NULL;
+
+	return pp_trace_names[name_id - 1];
+}
+
+P_LIB_API void
+p_trace_begin (volatile puint32	*name_cache,
+	       const pchar		*name,
+	       puint64			arg0,
+	       puint64			arg1)
+{
+	PTraceBuffer		*buffer;
+	PTraceStackEntry	*entry;
+	pboolean		enabled;
+	puint32			name_id;
+
+	if (P_UNLIKELY (pp_trace_key == NULL))
+		return;
+
+	enabled = p_atomic_int_get_explicit (&pp_trace_enabled, P_ATOMIC_MEMORY_ORDER_RELAXED) != 0;
+	buffer  = (PTraceBuffer *) p_uthread_get_static_local (pp_trace_key);
+
+	/* Spans are tracked from the first one started while recording */
+	if (P_UNLIKELY (buffer == NULL)) {
+		if (enabled == FALSE || (buffer = pp_trace_buffer_new ()) == NULL)
+			return;
+	}
+
+	if (P_UNLIKELY (buffer->depth >= P_TRACE_MAX_DEPTH)) {
+		++buffer->depth;
+
+		if (enabled == TRUE)
+			p_atomic_int64_add_explicit (&pp_trace_dropped, 1, P_ATOMIC_MEMORY_ORDER_RELAXED);
+
+		return;
+	}
+
+	entry = &buffer->stack[buffer->depth++];
+	entry->recorded = FALSE;
+
+	if (enabled == FALSE)
+		return;
+
+	if (P_UNLIKELY ((name_id = *name_cache) == 0)) {
+		name_id     = pp_trace_register_name (name);
+		*name_cache = name_id;
+	}
+
+	entry->name_id  = name_id;
+	entry->args[0]  = arg0;
+	entry->args[1]  = arg1;
+	entry->recorded = pp_trace_write (buffer, entry, P_TRACE_EVENT_TYPE_BEGIN);
+
+	/* The end record is dropped as well */
+	if (P_UNLIKELY (entry->recorded == FALSE))
+		p_atomic_int64_add_explicit (&pp_trace_dropped, 1, P_ATOMIC_MEMORY_ORDER_RELAXED);
+}
+
+P_LIB_API void
+p_trace_end (void)
+{
+	PTraceBuffer		*buffer;
+	PTraceStackEntry	*entry;
+
+	if (P_UNLIKELY (pp_trace_key == NULL))
+		return;
+
+	buffer = (PTraceBuffer *) p_uthread_get_static_local (pp_trace_key);
+
+	if (P_UNLIKELY (buffer == NULL || buffer->depth == 0))
+		return;
+
+	if (P_UNLIKELY (--buffer->depth >= P_TRACE_MAX_DEPTH)) {
+		if (p_atomic_int_get_explicit (&pp_trace_enabled, P_ATOMIC_MEMORY_ORDER_RELAXED) != 0)
+			p_atomic_int64_add_explicit (&pp_trace_dropped, 1, P_ATOMIC_MEMORY_ORDER_RELAXED);
+
+		return;
+	}
+
+	entry = &buffer->stack[buffer->depth];
+
+	if (entry->recorded == FALSE ||
+	    p_atomic_int_get_explicit (&pp_trace_enabled, P_ATOMIC_MEMORY_ORDER_RELAXED) == 0)
+		return;
+
+	pp_trace_write (buffer, entry, P_TRACE_EVENT_TYPE_END);
+}
+#else
+void
+p_trace_shutdown (void)
+{
+}
+
+P_LIB_API pboolean
+p_trace_start (PTraceFunc	func,
+	       ppointer		user_data,
+	       puint		interval_ms)
+{
+	P_UNUSED (func);
+	P_UNUSED (user_data);
+	P_UNUSED (interval_ms);
+
+	return FALSE;
+}
+
+P_LIB_API void
+p_trace_stop (void)
+{
+}
+
+P_LIB_API pboolean
+p_trace_is_enabled (void)
+{
+	return FALSE;
+}
+
+P_LIB_API puint64
+p_trace_get_dropped (void)
+{
+	return 0;
+}
+
+P_LIB_API puint64
+p_trace_get_timestamp (void)
+{
+	return 0;
+}
+
+P_LIB_API const pchar *
+p_trace_get_name (puint32 name_id)
+{
+	P_UNUSED (name_id);
+
+	return NULL;
+}
+
+P_LIB_API void
+p_trace_begin (volatile puint32	*name_cache,
+	       const pchar		*name,
+	       puint64			arg0,
+	       puint64			arg1)
+{
+	P_UNUSED (name_cache);
+	P_UNUSED (name);
+	P_UNUSED (arg0);
+	P_UNUSED (arg1);
+}
+
+P_LIB_API void
+p_trace_end (void)
+{
+}
+#endif
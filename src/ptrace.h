@@ -0,0 +1,230 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file ptrace.h
+ * @brief Trace spans
+ * @author Alexander Saprykin
+ *
+ * Trace spans mark the time ranges spent in the parts of the code, i.e. the
+ * handling of a request or a single pass of a processing loop. A span starts
+ * with #P_TRACE_BEGIN (or #P_TRACE_BEGIN_ARGS to attach two integer arguments)
+ * and ends with #P_TRACE_END in the same thread, the spans can be nested:
+ * @code
+ * P_TRACE_BEGIN_ARGS ("parse", request_id, request_size);
+ * parse_request (request);
+ * P_TRACE_END;
+ * @endcode
+ *
+ * Every thread records its spans into its own lock-free ring buffer, so the
+ * recording threads never wait for each other. A record is a fixed-size
+ * structure with a raw clock reading, the name and the arguments, recording
+ * a span takes only a few tens of nanoseconds. Span names must be string
+ * literals or other strings living until the library shutdown, a name is
+ * registered once per call site and identified by a number afterwards.
+ *
+ * Nothing is recorded until p_trace_start() is called. It starts a collector
+ * thread which periodically drains the buffers and passes the records to the
+ * given callback as #PTraceRecord structures with the time elapsed since the
+ * start in nanoseconds. p_trace_stop() stops the recording and delivers the
+ * remaining records. #PTraceExporter is a ready collector writing the records
+ * into a file in the Chrome trace format. When a buffer is full, new records of the thread are
+ * dropped and counted, see p_trace_get_dropped().
+ *
+ * The macros compile to nothing if the library was built without the
+ * PLIBSYS_TRACE option or #P_TRACE_DISABLE is defined before including
+ * plibsys.h, the latter allows to remove the spans from a single source file
+ * or a whole application.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PTRACE_H
+#define PLIBSYS_HEADER_PTRACE_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+
+P_BEGIN_DECLS
+
+/** Number of records the buffer of each thread can hold. */
+#define P_TRACE_BUFFER_SIZE	8192
+
+/** Maximum nesting depth of the spans in a thread, deeper spans are dropped. */
+#define P_TRACE_MAX_DEPTH	64
+
+/** Maximum number of distinct span names. */
+#define P_TRACE_MAX_NAMES	1024
+
+/** Trace record type. */
+typedef enum PTraceEventType_ {
+	P_TRACE_EVENT_TYPE_BEGIN	= 0,	/**< Span started.	*/
+	P_TRACE_EVENT_TYPE_END		= 1	/**< Span ended.	*/
+} PTraceEventType;
+
+/** Trace record as delivered to the collector callback. */
+typedef struct PTraceRecord_ {
+	puint64		timestamp;	/**< Nanoseconds since p_trace_start().		*/
+	puint32		thread_id;	/**< Sequential number of the recording thread,
+					     starting from 1.				*/
+	const pchar	*thread_name;	/**< Name of the recording #PUThread, NULL if
+					     not set, valid during the callback only.	*/
+	puint32		name_id;	/**< Span name, see p_trace_get_name().		*/
+	PTraceEventType	type;		/**< Record type.				*/
+	puint64		args[2];	/**< Span arguments, the same in the begin and
+					     the end records.				*/
+} PTraceRecord;
+
+/**
+ * @brief Collector callback receiving the trace records.
+ * @param records Records of a single thread in the order of recording.
+ * @param count Number of records.
+ * @param user_data Data passed to p_trace_start().
+ * @since 0.0.5
+ *
+ * The callback is called from the collector thread and from p_trace_stop(),
+ * never concurrently. It must not record trace spans itself.
+ */
+typedef void (*PTraceFunc) (const PTraceRecord *records, psize count, ppointer user_data);
+
+/**
+ * @brief Starts recording and collecting the trace spans.
+ * @param func Callback to pass the records to.
+ * @param user_data Data to pass to @a func.
+ * @param interval_ms Interval between the buffer drains, in milliseconds, 0
+ * to use the default of 10 milliseconds.
+ * @return TRUE in case of success, FALSE if the recording is already started,
+ * the collector thread failed to start or the library was built without the
+ * PLIBSYS_TRACE option.
+ * @since 0.0.5
+ *
+ * The records left in the buffers from the previous session are discarded
+ * and the dropped records counter is reset.
+ */
+P_LIB_API pboolean	p_trace_start		(PTraceFunc		func,
+						 ppointer		user_data,
+						 puint			interval_ms);
+
+/**
+ * @brief Stops recording the trace spans.
+ * @since 0.0.5
+ *
+ * Waits for the collector thread to finish and passes all the remaining
+ * records to the callback before returning. The spans which started before
+ * the call may miss their end records.
+ */
+P_LIB_API void		p_trace_stop		(void);
+
+/**
+ * @brief Checks whether the trace spans are recorded.
+ * @return TRUE if the recording is started, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_trace_is_enabled	(void);
+
+/**
+ * @brief Gets the number of records dropped because of full buffers or too
+ * deep nesting since the last p_trace_start().
+ * @return Number of dropped records.
+ * @since 0.0.5
+ */
+P_LIB_API puint64	p_trace_get_dropped	(void);
+
+/**
+ * @brief Gets the current time on the scale of the delivered records.
+ * @return Nanoseconds since p_trace_start(), 0 if the recording is not
+ * started.
+ * @since 0.0.5
+ *
+ * Allows to put other events, i.e. the samples of the counters, on the same
+ * timeline with the spans.
+ */
+P_LIB_API puint64	p_trace_get_timestamp	(void);
+
+/**
+ * @brief Gets the name of a span.
+ * @param name_id Name ID from a #PTraceRecord.
+ * @return Span name, NULL if @a name_id is not known.
+ * @since 0.0.5
+ */
+P_LIB_API const pchar *	p_trace_get_name	(puint32		name_id);
+
+/**
+ * @brief Records the start of a span, use #P_TRACE_BEGIN instead.
+ * @param name_cache Per call site cache of the name ID, must be zero
+ * initially.
+ * @param name Span name.
+ * @param arg0 First argument.
+ * @param arg1 Second argument.
+ * @since 0.0.5
+ */
+P_LIB_API void		p_trace_begin		(volatile puint32	*name_cache,
+						 const pchar		*name,
+						 puint64		arg0,
+						 puint64		arg1);
+
+/**
+ * @brief Records the end of the innermost span, use #P_TRACE_END instead.
+ * @since 0.0.5
+ */
+P_LIB_API void		p_trace_end		(void);
+
+#if defined (PLIBSYS_TRACE) && !defined (P_TRACE_DISABLE)
+/**
+ * @brief Starts a span with two integer arguments.
+ * @param name Span name, a string literal.
+ * @param arg0 First argument, converted to #puint64.
+ * @param arg1 Second argument, converted to #puint64.
+ * @since 0.0.5
+ */
+#  define P_TRACE_BEGIN_ARGS(name, arg0, arg1)						\
+	do {										\
+		static volatile puint32 pp_trace_name_cache = 0;			\
+		p_trace_begin (&pp_trace_name_cache, (name),				\
+			       (puint64) (arg0), (puint64) (arg1));			\
+	} while (0)
+
+/**
+ * @brief Ends the innermost span of the calling thread.
+ * @since 0.0.5
+ */
+#  define P_TRACE_END		p_trace_end ()
+#else
+#  define P_TRACE_BEGIN_ARGS(name, arg0, arg1)	do {} while (0)
+#  define P_TRACE_END				do {} while (0)
+#endif
+
+/**
+ * @brief Starts a span.
+ * @param name Span name, a string literal.
+ * @since 0.0.5
+ */
+#define P_TRACE_BEGIN(name)	P_TRACE_BEGIN_ARGS (name, 0, 0)
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PTRACE_H */
@@ -0,0 +1,319 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* The events are printed straight into a stdio stream with a fixed-size
+ * buffer. The only state growing with the capture is a bit per recording
+ * thread which remembers whether the thread name was already written. */
+
+#include "pmem.h"
+#include "perror-private.h"
+#include "pmetrics.h"
+#include "pmutex.h"
+#include "pprocess.h"
+#include "ptraceexporter.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define P_TRACE_EXPORTER_FILE_BUFFER	(64 * 1024)
+
+struct PTraceExporter_ {
+	FILE		*file;
+	pchar		*file_buffer;
+	PMutex		*mutex;
+	puint32		pid;
+	pboolean	has_events;
+	puint32		*threads;
+	puint32		threads_words;
+};
+
+typedef struct PTraceExporterCounters_ {
+	PTraceExporter	*exporter;
+	puint64		timestamp;
+	pint		count;
+} PTraceExporterCounters;
+
+static void pp_trace_exporter_write_chars (FILE *file, const pchar *str);
+static void pp_trace_exporter_begin_event (PTraceExporter *exporter);
+static void pp_trace_exporter_write_timestamp (FILE *file, puint64 nsecs);
+static void pp_trace_exporter_write_thread_name (PTraceExporter *exporter, const PTraceRecord *record);
+static pboolean pp_trace_exporter_write_counter (const PMetricSample *sample, ppointer user_data);
+
+/* Writes a string escaped for JSON, without the quotes */
+static void
+pp_trace_exporter_write_chars (FILE		*file,
+			       const pchar	*str)
+{
+	for (; *str != '\0'; ++str) {
+		if (*str == '"' || *str == '\\') {
+			fputc ('\\', file);
+			fputc (*str, file);
+		} else if ((puchar) *str < 0x20)
+			fprintf (file, "\\u%04x", (puint) (puchar) *str);
+		else
+			fputc (*str, file);
+	}
+}
+
+/* Must be called with the exporter locked */
+static void
+pp_trace_exporter_begin_event (PTraceExporter *exporter)
+{
+	fputs (exporter->has_events == TRUE ? ",\n" : "\n", exporter->file);
+	exporter->has_events = TRUE;
+}
+
+static void
+pp_trace_exporter_write_timestamp (FILE		*file,
+				   puint64	nsecs)
+{
+	/* The format expects microseconds */
+	fprintf (file, "\"ts\":%" PUINT64_FORMAT ".%03u", nsecs / 1000, (puint) (nsecs % 1000));
+}
+
+/* Must be called with the exporter locked */
+static void
+pp_trace_exporter_write_thread_name (PTraceExporter	*exporter,
+				     const PTraceRecord	*record)
+{
+	puint32	word = record->thread_id / 32;
+	puint32	bit  = (puint32) 1 << (record->thread_id % 32);
+	puint32	*threads;
+	puint32	new_words;
+
+	if (word >= exporter->threads_words) {
+		new_words = (word + 1) * 2;
+
+		/* Without the memory the name is just written again later */
+		if (P_LIKELY ((threads = p_realloc (exporter->threads, new_words * sizeof (puint32))) != NULL)) {
+			memset (threads + exporter->threads_words, 0,
+				(new_words - exporter->threads_words) * sizeof (puint32));
+
+			exporter->threads       = threads;
+			exporter->threads_words = new_words;
+		}
+	}
+
+	if (word < exporter->threads_words) {
+		if ((exporter->threads[word] & bit) != 0)
+			return;
+
+		exporter->threads[word] |= bit;
+	}
+
+	pp_trace_exporter_begin_event (exporter);
+
+	fprintf (exporter->file,
+		 "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":%u,\"args\":{\"name\":\"",
+		 (puint) exporter->pid,
+		 (puint) record->thread_id);
+
+	if (record->thread_name != NULL)
+		pp_trace_exporter_write_chars (exporter->file, record->thread_name);
+	else
+		fprintf (exporter->file, "Thread %u", (puint) record->thread_id);
+
+	fputs ("\"}}", exporter->file);
+}
+
+/* Must be called with the exporter locked */
+static pboolean
+pp_trace_exporter_write_counter (const PMetricSample	*sample,
+				 ppointer		user_data)
+{
+	PTraceExporterCounters	*counters = (PTraceExporterCounters *) user_data;
+	FILE			*file     = counters->exporter->file;
+
+	if (sample->type != P_METRIC_TYPE_COUNTER && sample->type != P_METRIC_TYPE_GAUGE)
+		return TRUE;
+
+	pp_trace_exporter_begin_event (counters->exporter);
+
+	/* Every labeled series is a separate track */
+	fputs ("{\"name\":\"", file);
+	pp_trace_exporter_write_chars (file, sample->name);
+
+	if (sample->labels[0] != '\0') {
+		fputc ('{', file);
+		pp_trace_exporter_write_chars (file, sample->labels);
+		fputc ('}', file);
+	}
+
+	fprintf (file, "\",\"ph\":\"C\",\"pid\":%u,", (puint) counters->exporter->pid);
+	pp_trace_exporter_write_timestamp (file, counters->timestamp);
+	fprintf (file, ",\"args\":{\"value\":%" PINT64_FORMAT "}}", sample->value);
+
+	++counters->count;
+
+	return TRUE;
+}
+
+P_LIB_API PTraceExporter *
+p_trace_exporter_new (const pchar	*path,
+		      PError		**error)
+{
+	PTraceExporter *ret;
+
+	if (P_UNLIKELY (path == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PTraceExporter))) == NULL ||
+			(ret->file_buffer = p_malloc (P_TRACE_EXPORTER_FILE_BUFFER)) == NULL ||
+			(ret->mutex = p_mutex_new ()) == NULL)) {
+		if (ret != NULL)
+			p_free (ret->file_buffer);
+
+		p_free (ret);
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for trace exporter");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret->file = fopen (path, "wb")) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call fopen() to create file");
+		p_mutex_free (ret->mutex);
+		p_free (ret->file_buffer);
+		p_free (ret);
+		return NULL;
+	}
+
+	setvbuf (ret->file, ret->file_buffer, _IOFBF, P_TRACE_EXPORTER_FILE_BUFFER);
+
+	ret->pid = p_process_get_current_pid ();
+
+	fputs ("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", ret->file);
+
+	return ret;
+}
+
+P_LIB_API void
+p_trace_exporter_write_records (const PTraceRecord	*records,
+				psize			count,
+				ppointer		exporter)
+{
+	PTraceExporter	*trace_exporter = (PTraceExporter *) exporter;
+	const pchar	*name;
+	FILE		*file;
+	psize		i;
+
+	if (P_UNLIKELY (records == NULL || trace_exporter == NULL))
+		return;
+
+	file = trace_exporter->file;
+
+	p_mutex_lock (trace_exporter->mutex);
+
+	for (i = 0; i < count; ++i) {
+		pp_trace_exporter_write_thread_name (trace_exporter, &records[i]);
+		pp_trace_exporter_begin_event (trace_exporter);
+
+		if (records[i].type == P_TRACE_EVENT_TYPE_END) {
+			fprintf (file, "{\"ph\":\"E\",\"pid\":%u,\"tid\":%u,",
+				 (puint) trace_exporter->pid,
+				 (puint) records[i].thread_id);
+			pp_trace_exporter_write_timestamp (file, records[i].timestamp);
+			fputc ('}', file);
+			continue;
+		}
+
+		name = p_trace_get_name (records[i].name_id);
+
+		fputs ("{\"name\":\"", file);
+		pp_trace_exporter_write_chars (file, name != NULL ? name : "unknown");
+		fprintf (file, "\",\"ph\":\"B\",\"pid\":%u,\"tid\":%u,",
+			 (puint) trace_exporter->pid,
+			 (puint) records[i].thread_id);
+		pp_trace_exporter_write_timestamp (file, records[i].timestamp);
+		fprintf (file, ",\"args\":{\"arg0\":%" PUINT64_FORMAT ",\"arg1\":%" PUINT64_FORMAT "}}",
+			 records[i].args[0],
+			 records[i].args[1]);
+	}
+
+	p_mutex_unlock (trace_exporter->mutex);
+}
+
+P_LIB_API pint
+p_trace_exporter_write_counters (PTraceExporter *exporter)
+{
+	PTraceExporterCounters counters;
+
+	if (P_UNLIKELY (exporter == NULL))
+		return 0;
+
+	counters.exporter  = exporter;
+	counters.timestamp = p_trace_get_timestamp ();
+	counters.count     = 0;
+
+	p_mutex_lock (exporter->mutex);
+	p_metrics_foreach (pp_trace_exporter_write_counter, &counters);
+	p_mutex_unlock (exporter->mutex);
+
+	return counters.count;
+}
+
+P_LIB_API pboolean
+p_trace_exporter_close (PTraceExporter	*exporter,
+			PError		**error)
+{
+	pboolean result;
+
+	if (P_UNLIKELY (exporter == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	fputs ("\n]}\n", exporter->file);
+
+	result = ferror (exporter->file) == 0 ? TRUE : FALSE;
+
+	if (P_UNLIKELY (fclose (exporter->file) != 0))
+		result = FALSE;
+
+	if (P_UNLIKELY (result == FALSE))
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to write trace file");
+
+	p_mutex_free (exporter->mutex);
+	p_free (exporter->threads);
+	p_free (exporter->file_buffer);
+	p_free (exporter);
+
+	return result;
+}
@@ -0,0 +1,129 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file ptraceexporter.h
+ * @brief Trace file exporter
+ * @author Alexander Saprykin
+ *
+ * #PTraceExporter writes the trace spans collected by p_trace_start() into a
+ * file in the Chrome Trace Event JSON format, which can be opened directly in
+ * the standard viewers like Perfetto UI (ui.perfetto.dev) or
+ * chrome://tracing.
+ *
+ * The records are written as they are delivered by the collector, through a
+ * fixed-size file buffer, so the memory usage doesn't depend on the length of
+ * the capture:
+ * @code
+ * PTraceExporter *exporter = p_trace_exporter_new ("capture.json", NULL);
+ *
+ * p_trace_start (p_trace_exporter_write_records, exporter, 0);
+ * ...
+ * p_trace_exporter_write_counters (exporter);
+ * ...
+ * p_trace_stop ();
+ * p_trace_exporter_close (exporter, NULL);
+ * @endcode
+ *
+ * Every recording thread is shown as a separate track named after its
+ * #PUThread name or "Thread N" if the name is not set. The span arguments are
+ * shown as "arg0" and "arg1". p_trace_exporter_write_counters() adds the
+ * current values of the counters and gauges from the metrics registry (see
+ * #PMetric) as counter tracks, call it periodically to get a chart of the
+ * values over time.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PTRACEEXPORTER_H
+#define PLIBSYS_HEADER_PTRACEEXPORTER_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+#include "perror.h"
+#include "ptrace.h"
+
+P_BEGIN_DECLS
+
+/** Trace exporter opaque data type. */
+typedef struct PTraceExporter_ PTraceExporter;
+
+/**
+ * @brief Creates a new trace file.
+ * @param path Path to the file, an existing file is overwritten.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Pointer to a newly created #PTraceExporter object in case of
+ * success, NULL otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API PTraceExporter *	p_trace_exporter_new		(const pchar		*path,
+								 PError			**error);
+
+/**
+ * @brief Writes the trace records into the file.
+ * @param records Trace records.
+ * @param count Number of records.
+ * @param exporter #PTraceExporter to write into.
+ * @since 0.0.5
+ *
+ * The signature matches #PTraceFunc, so the function can be passed to
+ * p_trace_start() directly with the exporter as the user data.
+ */
+P_LIB_API void			p_trace_exporter_write_records	(const PTraceRecord	*records,
+								 psize			count,
+								 ppointer		exporter);
+
+/**
+ * @brief Writes the current values of the counter and gauge metrics into the
+ * file.
+ * @param exporter #PTraceExporter to write into.
+ * @return Number of written values.
+ * @since 0.0.5
+ *
+ * The values are placed on the timeline at p_trace_get_timestamp(). The
+ * function can be called from any thread while the collector is writing the
+ * records.
+ */
+P_LIB_API pint			p_trace_exporter_write_counters	(PTraceExporter		*exporter);
+
+/**
+ * @brief Completes the trace file and frees the exporter.
+ * @param exporter #PTraceExporter to close.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE if all the data was written successfully, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * Call p_trace_stop() before closing, so the collector doesn't write into
+ * the freed exporter. The file is completed even if some of the writes
+ * failed, though the failed parts are lost.
+ */
+P_LIB_API pboolean		p_trace_exporter_close		(PTraceExporter		*exporter,
+								 PError			**error);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PTRACEEXPORTER_H */
@@ -30,8 +30,10 @@ typedef struct PTreeAVLNode_ {
 	struct PTreeBaseNode_	base;
 	struct PTreeAVLNode_	*parent;
 	pint			balance_factor;
+	pint			size;
 } PTreeAVLNode;
 
+static void pp_tree_avl_update_size (PTreeAVLNode *node);
 static void pp_tree_avl_rotate_left (PTreeAVLNode *node, PTreeBaseNode **root);
 static void pp_tree_avl_rotate_right (PTreeAVLNode *node, PTreeBaseNode **root);
 static void pp_tree_avl_rotate_left_right (PTreeAVLNode *node, PTreeBaseNode **root);
@@ -39,6 +41,14 @@ static void pp_tree_avl_rotate_right_left (PTreeAVLNode *node, PTreeBaseNode **r
 static void pp_tree_avl_balance_insert (PTreeAVLNode *node, PTreeBaseNode **root);
 static void pp_tree_avl_balance_remove (PTreeAVLNode *node, PTreeBaseNode **root);
 
+/* Rotations keep the size of the whole subtree, only the sizes of the moved
+ * nodes should be recalculated, the lower one first */
+static void
+pp_tree_avl_update_size (PTreeAVLNode *node)
+{
+	node->size = 1 + p_tree_avl_node_size (node->base.left) + p_tree_avl_node_size (node->base.right);
+}
+
 static void
 pp_tree_avl_rotate_left (PTreeAVLNode *node, PTreeBaseNode **root)
 {
@@ -59,6 +69,9 @@ pp_tree_avl_rotate_left (PTreeAVLNode *node, PTreeBaseNode **root)
 	} else
 		*root = (PTreeBaseNode *) node;
 
+	pp_tree_avl_update_size ((PTreeAVLNode *) node->base.left);
+	pp_tree_avl_update_size (node);
+
 	/* Restore balance factor */
 	((PTreeAVLNode *) node)->balance_factor +=1;
 	((PTreeAVLNode *) node->base.left)->balance_factor = -((PTreeAVLNode *) node)->balance_factor;
@@ -84,6 +97,9 @@ pp_tree_avl_rotate_right (PTreeAVLNode *node, PTreeBaseNode **root)
 	} else
 		*root = (PTreeBaseNode *) node;
 
+	pp_tree_avl_update_size ((PTreeAVLNode *) node->base.right);
+	pp_tree_avl_update_size (node);
+
 	/* Restore balance factor */
 	((PTreeAVLNode *) node)->balance_factor -= 1;
 	((PTreeAVLNode *) node->base.right)->balance_factor = -((PTreeAVLNode *) node)->balance_factor;
@@ -121,6 +137,10 @@ pp_tree_avl_rotate_left_right (PTreeAVLNode *node, PTreeBaseNode **root)
 	tmp_node->base.left = (PTreeBaseNode *) node;
 	node->parent = tmp_node;
 
+	pp_tree_avl_update_size ((PTreeAVLNode *) tmp_node->base.left);
+	pp_tree_avl_update_size ((PTreeAVLNode *) tmp_node->base.right);
+	pp_tree_avl_update_size (tmp_node);
+
 	/* Restore balance factor */
 	if (tmp_node->balance_factor == 1) {
 		((PTreeAVLNode *) tmp_node->base.left)->balance_factor  = 0;
@@ -168,6 +188,10 @@ pp_tree_avl_rotate_right_left (PTreeAVLNode *node, PTreeBaseNode **root)
 	tmp_node->base.right = (PTreeBaseNode *) node;
 	node->parent = tmp_node;
 
+	pp_tree_avl_update_size ((PTreeAVLNode *) tmp_node->base.left);
+	pp_tree_avl_update_size ((PTreeAVLNode *) tmp_node->base.right);
+	pp_tree_avl_update_size (tmp_node);
+
 	/* Restore balance factor */
 	if (tmp_node->balance_factor == 1) {
 		((PTreeAVLNode *) tmp_node->base.left)->balance_factor  = 0;
@@ -337,6 +361,7 @@ pp_tree_avl_balance_remove (PTreeAVLNode *node, PTreeBaseNode **root)
 
 pboolean
 p_tree_avl_insert (PTreeBaseNode	**root_node,
+		   PTreeNodePool	*pool,
 		   PCompareDataFunc	compare_func,
 		   ppointer		data,
 		   PDestroyFunc		key_destroy_func,
@@ -346,6 +371,7 @@ p_tree_avl_insert (PTreeBaseNode	**root_node,
 {
 	PTreeBaseNode	**cur_node;
 	PTreeBaseNode	*parent_node;
+	PTreeAVLNode	*size_node;
 	pint		cmp_result;
 
 	cur_node    = root_node;
@@ -379,7 +405,7 @@ p_tree_avl_insert (PTreeBaseNode	**root_node,
 		return FALSE;
 	}
 
-	if (P_UNLIKELY ((*cur_node = p_malloc0 (sizeof (PTreeAVLNode))) == NULL))
+	if (P_UNLIKELY ((*cur_node = p_tree_node_pool_alloc (pool, sizeof (PTreeAVLNode))) == NULL))
 		return FALSE;
 
 	(*cur_node)->key   = key;
@@ -387,6 +413,10 @@ p_tree_avl_insert (PTreeBaseNode	**root_node,
 
 	((PTreeAVLNode *) *cur_node)->balance_factor = 0;
 	((PTreeAVLNode *) *cur_node)->parent         = (PTreeAVLNode *) parent_node;
+	((PTreeAVLNode *) *cur_node)->size           = 1;
+
+	for (size_node = (PTreeAVLNode *) parent_node; size_node != NULL; size_node = size_node->parent)
+		++size_node->size;
 
 	/* Balance the tree */
 	pp_tree_avl_balance_insert (((PTreeAVLNode *) *cur_node), root_node);
@@ -396,6 +426,7 @@ p_tree_avl_insert (PTreeBaseNode	**root_node,
 
 pboolean
 p_tree_avl_remove (PTreeBaseNode	**root_node,
+		   PTreeNodePool	*pool,
 		   PCompareDataFunc	compare_func,
 		   ppointer		data,
 		   PDestroyFunc		key_destroy_func,
@@ -406,6 +437,7 @@ p_tree_avl_remove (PTreeBaseNode	**root_node,
 	PTreeBaseNode	*prev_node;
 	PTreeBaseNode	*child_node;
 	PTreeAVLNode	*child_parent;
+	PTreeAVLNode	*size_node;
 	pint		cmp_result;
 
 	cur_node = *root_node;
@@ -437,6 +469,13 @@ p_tree_avl_remove (PTreeBaseNode	**root_node,
 		cur_node = prev_node;
 	}
 
+	/* The node stays in the tree during rebalancing, but it's already not
+	 * counted in the subtree sizes */
+	((PTreeAVLNode *) cur_node)->size = 0;
+
+	for (size_node = ((PTreeAVLNode *) cur_node)->parent; size_node != NULL; size_node = size_node->parent)
+		--size_node->size;
+
 	child_node = cur_node->left == NULL ? cur_node->right : cur_node->left;
 
 	if (child_node == NULL)
@@ -469,11 +508,38 @@ p_tree_avl_remove (PTreeBaseNode	**root_node,
 	if (value_destroy_func != NULL)
 		value_destroy_func (cur_node->value);
 
-	p_free (cur_node);
+	p_tree_node_pool_release (pool, cur_node);
 
 	return TRUE;
 }
 
+PTreeBaseNode *
+p_tree_avl_build_node (PTreeNodePool	*pool,
+		       PTreeBaseNode	*parent,
+		       pint		size,
+		       pint		balance_factor,
+		       pboolean		is_lowest)
+{
+	PTreeAVLNode *ret;
+
+	P_UNUSED (is_lowest);
+
+	if (P_UNLIKELY ((ret = p_tree_node_pool_alloc (pool, sizeof (PTreeAVLNode))) == NULL))
+		return NULL;
+
+	ret->parent         = (PTreeAVLNode *) parent;
+	ret->balance_factor = balance_factor;
+	ret->size           = size;
+
+	return (PTreeBaseNode *) ret;
+}
+
+pint
+p_tree_avl_node_size (PTreeBaseNode *node)
+{
+	return node == NULL ? 0 : ((PTreeAVLNode *) node)->size;
+}
+
 void
 p_tree_avl_node_free (PTreeBaseNode *node)
 {
@@ -37,6 +37,7 @@
 P_BEGIN_DECLS
 
 pboolean	p_tree_avl_insert	(PTreeBaseNode		**root_node,
+					 PTreeNodePool		*pool,
 					 PCompareDataFunc	compare_func,
 					 ppointer		data,
 					 PDestroyFunc		key_destroy_func,
@@ -45,12 +46,22 @@ pboolean	p_tree_avl_insert	(PTreeBaseNode		**root_node,
 					 ppointer		value);
 
 pboolean	p_tree_avl_remove	(PTreeBaseNode		**root_node,
+					 PTreeNodePool		*pool,
 					 PCompareDataFunc	compare_func,
 					 ppointer		data,
 					 PDestroyFunc		key_destroy_func,
 					 PDestroyFunc		value_destroy_func,
 					 pconstpointer		key);
 
+PTreeBaseNode *	p_tree_avl_build_node	(PTreeNodePool	*pool,
+					 PTreeBaseNode	*parent,
+					 pint		size,
+					 pint		balance_factor,
+					 pboolean	is_lowest);
+
+/* Gives the number of nodes in the subtree of @a node, 0 for NULL */
+pint		p_tree_avl_node_size	(PTreeBaseNode	*node);
+
 void		p_tree_avl_node_free	(PTreeBaseNode	*node);
 
 P_END_DECLS
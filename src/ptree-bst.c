@@ -28,6 +28,7 @@
 
 pboolean
 p_tree_bst_insert (PTreeBaseNode	**root_node,
+		   PTreeNodePool	*pool,
 		   PCompareDataFunc	compare_func,
 		   ppointer		data,
 		   PDestroyFunc		key_destroy_func,
@@ -52,7 +53,7 @@ p_tree_bst_insert (PTreeBaseNode	**root_node,
 	}
 
 	if ((*cur_node) == NULL) {
-		if (P_UNLIKELY ((*cur_node = p_malloc0 (sizeof (PTreeBaseNode))) == NULL))
+		if (P_UNLIKELY ((*cur_node = p_tree_node_pool_alloc (pool, sizeof (PTreeBaseNode))) == NULL))
 			return FALSE;
 
 		(*cur_node)->key   = key;
@@ -75,6 +76,7 @@ p_tree_bst_insert (PTreeBaseNode	**root_node,
 
 pboolean
 p_tree_bst_remove (PTreeBaseNode	**root_node,
+		   PTreeNodePool	*pool,
 		   PCompareDataFunc	compare_func,
 		   ppointer		data,
 		   PDestroyFunc		key_destroy_func,
@@ -128,11 +130,26 @@ p_tree_bst_remove (PTreeBaseNode	**root_node,
 	if (value_destroy_func != NULL)
 		value_destroy_func (cur_node->value);
 
-	p_free (cur_node);
+	p_tree_node_pool_release (pool, cur_node);
 
 	return TRUE;
 }
 
+PTreeBaseNode *
+p_tree_bst_build_node (PTreeNodePool	*pool,
+		       PTreeBaseNode	*parent,
+		       pint		size,
+		       pint		balance_factor,
+		       pboolean		is_lowest)
+{
+	P_UNUSED (parent);
+	P_UNUSED (size);
+	P_UNUSED (balance_factor);
+	P_UNUSED (is_lowest);
+
+	return p_tree_node_pool_alloc (pool, sizeof (PTreeBaseNode));
+}
+
 void
 p_tree_bst_node_free (PTreeBaseNode *node)
 {
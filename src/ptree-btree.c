@@ -0,0 +1,917 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "pmem.h"
+#include "ptree-btree.h"
+
+#include <stddef.h>
+#include <string.h>
+
+/* Minimal degree of the tree: every node except the root holds from
+ * (degree - 1) up to (2 * degree - 1) keys. With 8 the keys and the values
+ * arrays take two cache lines each on 64-bit platforms */
+#define P_TREE_BTREE_MIN_DEGREE	8
+#define P_TREE_BTREE_MIN_KEYS	(P_TREE_BTREE_MIN_DEGREE - 1)
+#define P_TREE_BTREE_MAX_KEYS	(2 * P_TREE_BTREE_MIN_DEGREE - 1)
+
+/* Enough for 2^31 keys even at the minimal fill */
+#define P_TREE_BTREE_MAX_DEPTH	32
+
+typedef struct PTreeBTreeNode_ {
+	pint			nkeys;
+	pboolean		is_leaf;
+	ppointer		keys[P_TREE_BTREE_MAX_KEYS];
+	ppointer		values[P_TREE_BTREE_MAX_KEYS];
+	/* Not allocated for leaves */
+	struct PTreeBTreeNode_	*children[P_TREE_BTREE_MAX_KEYS + 1];
+} PTreeBTreeNode;
+
+static PTreeBTreeNode * pp_tree_btree_node_new (PTreeNodePool *pool, pboolean is_leaf);
+static pint pp_tree_btree_find_index (const PTreeBTreeNode *node, pconstpointer key, PCompareDataFunc compare_func, ppointer data, pboolean *found);
+static pint pp_tree_btree_find_bound (const PTreeBTreeNode *node, pconstpointer key, PCompareDataFunc compare_func, ppointer data, pboolean is_upper);
+static pboolean pp_tree_btree_split_child (PTreeNodePool *pool, PTreeBTreeNode *parent, pint index);
+static void pp_tree_btree_merge_children (PTreeNodePool *pool, PTreeBTreeNode *parent, pint index);
+static void pp_tree_btree_rotate_right (PTreeBTreeNode *parent, pint index);
+static void pp_tree_btree_rotate_left (PTreeBTreeNode *parent, pint index);
+
+/* Internal node of a B-tree being built from a sorted array */
+typedef struct PTreeBTreeBuildFrame_ {
+	PTreeBTreeNode	*node;
+	psize		child_capacity;
+	psize		child_keys;
+	pint		nchildren;
+	pint		nlarger;
+	pint		next_child;
+} PTreeBTreeBuildFrame;
+
+static PTreeBTreeNode *
+pp_tree_btree_node_new (PTreeNodePool *pool, pboolean is_leaf)
+{
+	PTreeBTreeNode *ret;
+
+	/* Pooled nodes are all of the same size */
+	if (is_leaf == TRUE && pool == NULL)
+		ret = p_malloc0 (offsetof (PTreeBTreeNode, children));
+	else
+		ret = p_tree_node_pool_alloc (pool, sizeof (PTreeBTreeNode));
+
+	if (P_UNLIKELY (ret == NULL))
+		return NULL;
+
+	ret->is_leaf = is_leaf;
+
+	return ret;
+}
+
+/* Gives the index of the first key which is not less than @a key */
+static pint
+pp_tree_btree_find_index (const PTreeBTreeNode	*node,
+			  pconstpointer		key,
+			  PCompareDataFunc	compare_func,
+			  ppointer		data,
+			  pboolean		*found)
+{
+	pint low;
+	pint high;
+	pint mid;
+	pint cmp_result;
+
+	low    = 0;
+	high   = node->nkeys;
+	*found = FALSE;
+
+	while (low < high) {
+		mid        = low + (high - low) / 2;
+		cmp_result = compare_func (key, node->keys[mid], data);
+
+		if (cmp_result == 0) {
+			*found = TRUE;
+			return mid;
+		} else if (cmp_result < 0)
+			high = mid;
+		else
+			low = mid + 1;
+	}
+
+	return low;
+}
+
+/* Gives the index of the first key which is not less (or greater, if
+ * @a is_upper is TRUE) than @a key */
+static pint
+pp_tree_btree_find_bound (const PTreeBTreeNode	*node,
+			  pconstpointer		key,
+			  PCompareDataFunc	compare_func,
+			  ppointer		data,
+			  pboolean		is_upper)
+{
+	pint low;
+	pint high;
+	pint mid;
+	pint cmp_result;
+
+	low  = 0;
+	high = node->nkeys;
+
+	while (low < high) {
+		mid        = low + (high - low) / 2;
+		cmp_result = compare_func (node->keys[mid], key, data);
+
+		if (cmp_result > 0 || (cmp_result == 0 && is_upper == FALSE))
+			high = mid;
+		else
+			low = mid + 1;
+	}
+
+	return low;
+}
+
+/* Splits the full child at @a index, its median key moves up into @a parent */
+static pboolean
+pp_tree_btree_split_child (PTreeNodePool *pool, PTreeBTreeNode *parent, pint index)
+{
+	PTreeBTreeNode	*child;
+	PTreeBTreeNode	*sibling;
+
+	child = parent->children[index];
+
+	if (P_UNLIKELY ((sibling = pp_tree_btree_node_new (pool, child->is_leaf)) == NULL))
+		return FALSE;
+
+	sibling->nkeys = P_TREE_BTREE_MIN_KEYS;
+
+	memcpy (sibling->keys,
+		child->keys + P_TREE_BTREE_MIN_DEGREE,
+		P_TREE_BTREE_MIN_KEYS * sizeof (ppointer));
+	memcpy (sibling->values,
+		child->values + P_TREE_BTREE_MIN_DEGREE,
+		P_TREE_BTREE_MIN_KEYS * sizeof (ppointer));
+
+	if (child->is_leaf == FALSE)
+		memcpy (sibling->children,
+			child->children + P_TREE_BTREE_MIN_DEGREE,
+			P_TREE_BTREE_MIN_DEGREE * sizeof (PTreeBTreeNode *));
+
+	child->nkeys = P_TREE_BTREE_MIN_KEYS;
+
+	memmove (parent->children + index + 2,
+		 parent->children + index + 1,
+		 (psize) (parent->nkeys - index) * sizeof (PTreeBTreeNode *));
+	memmove (parent->keys + index + 1,
+		 parent->keys + index,
+		 (psize) (parent->nkeys - index) * sizeof (ppointer));
+	memmove (parent->values + index + 1,
+		 parent->values + index,
+		 (psize) (parent->nkeys - index) * sizeof (ppointer));
+
+	parent->children[index + 1] = sibling;
+	parent->keys[index]         = child->keys[P_TREE_BTREE_MIN_KEYS];
+	parent->values[index]       = child->values[P_TREE_BTREE_MIN_KEYS];
+
+	++parent->nkeys;
+
+	return TRUE;
+}
+
+/* Merges the children at @a index and (@a index + 1) along with the parent key
+ * between them, both of the children must have the minimal number of keys */
+static void
+pp_tree_btree_merge_children (PTreeNodePool *pool, PTreeBTreeNode *parent, pint index)
+{
+	PTreeBTreeNode	*left;
+	PTreeBTreeNode	*right;
+
+	left  = parent->children[index];
+	right = parent->children[index + 1];
+
+	left->keys[left->nkeys]   = parent->keys[index];
+	left->values[left->nkeys] = parent->values[index];
+
+	memcpy (left->keys + left->nkeys + 1, right->keys, (psize) right->nkeys * sizeof (ppointer));
+	memcpy (left->values + left->nkeys + 1, right->values, (psize) right->nkeys * sizeof (ppointer));
+
+	if (left->is_leaf == FALSE)
+		memcpy (left->children + left->nkeys + 1,
+			right->children,
+			(psize) (right->nkeys + 1) * sizeof (PTreeBTreeNode *));
+
+	left->nkeys += right->nkeys + 1;
+
+	memmove (parent->keys + index,
+		 parent->keys + index + 1,
+		 (psize) (parent->nkeys - index - 1) * sizeof (ppointer));
+	memmove (parent->values + index,
+		 parent->values + index + 1,
+		 (psize) (parent->nkeys - index - 1) * sizeof (ppointer));
+	memmove (parent->children + index + 1,
+		 parent->children + index + 2,
+		 (psize) (parent->nkeys - index - 1) * sizeof (PTreeBTreeNode *));
+
+	--parent->nkeys;
+
+	p_tree_node_pool_release (pool, right);
+}
+
+/* Moves a key from the left sibling through the parent into the child at
+ * @a index */
+static void
+pp_tree_btree_rotate_right (PTreeBTreeNode *parent, pint index)
+{
+	PTreeBTreeNode	*child;
+	PTreeBTreeNode	*left;
+
+	child = parent->children[index];
+	left  = parent->children[index - 1];
+
+	memmove (child->keys + 1, child->keys, (psize) child->nkeys * sizeof (ppointer));
+	memmove (child->values + 1, child->values, (psize) child->nkeys * sizeof (ppointer));
+
+	child->keys[0]   = parent->keys[index - 1];
+	child->values[0] = parent->values[index - 1];
+
+	if (child->is_leaf == FALSE) {
+		memmove (child->children + 1,
+			 child->children,
+			 (psize) (child->nkeys + 1) * sizeof (PTreeBTreeNode *));
+
+		child->children[0] = left->children[left->nkeys];
+	}
+
+	parent->keys[index - 1]   = left->keys[left->nkeys - 1];
+	parent->values[index - 1] = left->values[left->nkeys - 1];
+
+	--left->nkeys;
+	++child->nkeys;
+}
+
+/* Moves a key from the right sibling through the parent into the child at
+ * @a index */
+static void
+pp_tree_btree_rotate_left (PTreeBTreeNode *parent, pint index)
+{
+	PTreeBTreeNode	*child;
+	PTreeBTreeNode	*right;
+
+	child = parent->children[index];
+	right = parent->children[index + 1];
+
+	child->keys[child->nkeys]   = parent->keys[index];
+	child->values[child->nkeys] = parent->values[index];
+
+	if (child->is_leaf == FALSE)
+		child->children[child->nkeys + 1] = right->children[0];
+
+	parent->keys[index]   = right->keys[0];
+	parent->values[index] = right->values[0];
+
+	memmove (right->keys, right->keys + 1, (psize) (right->nkeys - 1) * sizeof (ppointer));
+	memmove (right->values, right->values + 1, (psize) (right->nkeys - 1) * sizeof (ppointer));
+
+	if (right->is_leaf == FALSE)
+		memmove (right->children,
+			 right->children + 1,
+			 (psize) right->nkeys * sizeof (PTreeBTreeNode *));
+
+	--right->nkeys;
+	++child->nkeys;
+}
+
+pboolean
+p_tree_btree_insert (PTreeBaseNode	**root_node,
+		     PTreeNodePool	*pool,
+		     PCompareDataFunc	compare_func,
+		     ppointer		data,
+		     PDestroyFunc	key_destroy_func,
+		     PDestroyFunc	value_destroy_func,
+		     ppointer		key,
+		     ppointer		value)
+{
+	PTreeBTreeNode	**root;
+	PTreeBTreeNode	*node;
+	PTreeBTreeNode	*new_root;
+	pboolean	found;
+	pint		index;
+	pint		cmp_result;
+
+	root = (PTreeBTreeNode **) root_node;
+
+	if (*root == NULL) {
+		if (P_UNLIKELY ((*root = pp_tree_btree_node_new (pool, TRUE)) == NULL))
+			return FALSE;
+
+		(*root)->keys[0]   = key;
+		(*root)->values[0] = value;
+		(*root)->nkeys     = 1;
+
+		return TRUE;
+	}
+
+	/* Full nodes are split on the way down, so there is always room in a
+	 * parent for the median key */
+	if ((*root)->nkeys == P_TREE_BTREE_MAX_KEYS) {
+		if (P_UNLIKELY ((new_root = pp_tree_btree_node_new (pool, FALSE)) == NULL))
+			return FALSE;
+
+		new_root->children[0] = *root;
+
+		if (P_UNLIKELY (pp_tree_btree_split_child (pool, new_root, 0) == FALSE)) {
+			p_tree_node_pool_release (pool, new_root);
+			return FALSE;
+		}
+
+		*root = new_root;
+	}
+
+	node = *root;
+
+	while (TRUE) {
+		index = pp_tree_btree_find_index (node, key, compare_func, data, &found);
+
+		if (found == TRUE)
+			break;
+
+		if (node->is_leaf == TRUE) {
+			memmove (node->keys + index + 1,
+				 node->keys + index,
+				 (psize) (node->nkeys - index) * sizeof (ppointer));
+			memmove (node->values + index + 1,
+				 node->values + index,
+				 (psize) (node->nkeys - index) * sizeof (ppointer));
+
+			node->keys[index]   = key;
+			node->values[index] = value;
+
+			++node->nkeys;
+
+			return TRUE;
+		}
+
+		if (node->children[index]->nkeys == P_TREE_BTREE_MAX_KEYS) {
+			if (P_UNLIKELY (pp_tree_btree_split_child (pool, node, index) == FALSE))
+				return FALSE;
+
+			cmp_result = compare_func (key, node->keys[index], data);
+
+			if (cmp_result == 0)
+				break;
+			else if (cmp_result > 0)
+				++index;
+		}
+
+		node = node->children[index];
+	}
+
+	if (key_destroy_func != NULL)
+		key_destroy_func (node->keys[index]);
+
+	if (value_destroy_func != NULL)
+		value_destroy_func (node->values[index]);
+
+	node->keys[index]   = key;
+	node->values[index] = value;
+
+	return FALSE;
+}
+
+pboolean
+p_tree_btree_remove (PTreeBaseNode	**root_node,
+		     PTreeNodePool	*pool,
+		     PCompareDataFunc	compare_func,
+		     ppointer		data,
+		     PDestroyFunc	key_destroy_func,
+		     PDestroyFunc	value_destroy_func,
+		     pconstpointer	key)
+{
+	PTreeBTreeNode	**root;
+	PTreeBTreeNode	*node;
+	PTreeBTreeNode	*child;
+	PTreeBTreeNode	*neighbor;
+	pboolean	found;
+	pboolean	need_destroy;
+	pint		index;
+
+	root         = (PTreeBTreeNode **) root_node;
+	node         = *root;
+	need_destroy = TRUE;
+
+	if (P_UNLIKELY (node == NULL))
+		return FALSE;
+
+	/* Single pass down the tree: every child we step into is refilled up
+	 * to at least the minimal degree, so a key can be taken from it
+	 * without going back */
+	while (TRUE) {
+		index = pp_tree_btree_find_index (node, key, compare_func, data, &found);
+
+		if (found == TRUE && node->is_leaf == TRUE) {
+			if (need_destroy == TRUE) {
+				if (key_destroy_func != NULL)
+					key_destroy_func (node->keys[index]);
+
+				if (value_destroy_func != NULL)
+					value_destroy_func (node->values[index]);
+			}
+
+			memmove (node->keys + index,
+				 node->keys + index + 1,
+				 (psize) (node->nkeys - index - 1) * sizeof (ppointer));
+			memmove (node->values + index,
+				 node->values + index + 1,
+				 (psize) (node->nkeys - index - 1) * sizeof (ppointer));
+
+			--node->nkeys;
+			break;
+		}
+
+		if (found == TRUE) {
+			child    = node->children[index];
+			neighbor = node->children[index + 1];
+
+			if (child->nkeys > P_TREE_BTREE_MIN_KEYS || neighbor->nkeys > P_TREE_BTREE_MIN_KEYS) {
+				if (need_destroy == TRUE) {
+					if (key_destroy_func != NULL)
+						key_destroy_func (node->keys[index]);
+
+					if (value_destroy_func != NULL)
+						value_destroy_func (node->values[index]);
+
+					need_destroy = FALSE;
+				}
+
+				/* Replace with the predecessor or the successor
+				 * and remove it from the leaf */
+				if (child->nkeys > P_TREE_BTREE_MIN_KEYS) {
+					for (neighbor = child; neighbor->is_leaf == FALSE; )
+						neighbor = neighbor->children[neighbor->nkeys];
+
+					node->keys[index]   = neighbor->keys[neighbor->nkeys - 1];
+					node->values[index] = neighbor->values[neighbor->nkeys - 1];
+				} else {
+					for (child = neighbor; neighbor->is_leaf == FALSE; )
+						neighbor = neighbor->children[0];
+
+					node->keys[index]   = neighbor->keys[0];
+					node->values[index] = neighbor->values[0];
+				}
+
+				key  = node->keys[index];
+				node = child;
+				continue;
+			}
+
+			/* The key moves down into the merged child */
+			pp_tree_btree_merge_children (pool, node, index);
+		} else {
+			if (node->is_leaf == TRUE)
+				return FALSE;
+
+			child = node->children[index];
+
+			if (child->nkeys > P_TREE_BTREE_MIN_KEYS) {
+				node = child;
+				continue;
+			}
+
+			if (index > 0 && node->children[index - 1]->nkeys > P_TREE_BTREE_MIN_KEYS) {
+				pp_tree_btree_rotate_right (node, index);
+				node = child;
+				continue;
+			}
+
+			if (index < node->nkeys && node->children[index + 1]->nkeys > P_TREE_BTREE_MIN_KEYS) {
+				pp_tree_btree_rotate_left (node, index);
+				node = child;
+				continue;
+			}
+
+			if (index == node->nkeys)
+				--index;
+
+			pp_tree_btree_merge_children (pool, node, index);
+		}
+
+		child = node->children[index];
+
+		/* Root has given its last key to the merged child */
+		if (node == *root && node->nkeys == 0) {
+			*root = child;
+			p_tree_node_pool_release (pool, node);
+		}
+
+		node = child;
+	}
+
+	if ((*root)->nkeys == 0) {
+		p_tree_node_pool_release (pool, *root);
+		*root = NULL;
+	}
+
+	return TRUE;
+}
+
+ppointer
+p_tree_btree_lookup (PTreeBaseNode	*root_node,
+		     PCompareDataFunc	compare_func,
+		     ppointer		data,
+		     pconstpointer	key)
+{
+	PTreeBTreeNode	*node;
+	pboolean	found;
+	pint		index;
+
+	node = (PTreeBTreeNode *) root_node;
+
+	while (node != NULL) {
+		index = pp_tree_btree_find_index (node, key, compare_func, data, &found);
+
+		if (found == TRUE)
+			return node->values[index];
+
+		node = node->is_leaf == TRUE ? NULL : node->children[index];
+	}
+
+	return NULL;
+}
+
+pboolean
+p_tree_btree_lookup_bound (PTreeBaseNode	*root_node,
+			   PCompareDataFunc	compare_func,
+			   ppointer		data,
+			   pconstpointer	key,
+			   pboolean		is_upper,
+			   ppointer		*found_key,
+			   ppointer		*value)
+{
+	PTreeBTreeNode	*node;
+	PTreeBTreeNode	*bound_node;
+	pint		bound_index;
+	pint		index;
+
+	node        = (PTreeBTreeNode *) root_node;
+	bound_node  = NULL;
+	bound_index = 0;
+
+	/* The bound found in a lower level is always less than the one from an
+	 * upper level */
+	while (node != NULL) {
+		index = pp_tree_btree_find_bound (node, key, compare_func, data, is_upper);
+
+		if (index < node->nkeys) {
+			bound_node  = node;
+			bound_index = index;
+		}
+
+		node = node->is_leaf == TRUE ? NULL : node->children[index];
+	}
+
+	if (bound_node == NULL)
+		return FALSE;
+
+	if (found_key != NULL)
+		*found_key = bound_node->keys[bound_index];
+
+	if (value != NULL)
+		*value = bound_node->values[bound_index];
+
+	return TRUE;
+}
+
+void
+p_tree_btree_foreach_range (PTreeBaseNode	*root_node,
+			    PCompareDataFunc	compare_func,
+			    ppointer		data,
+			    pconstpointer	from,
+			    pconstpointer	to,
+			    PTraverseFunc	traverse_func,
+			    ppointer		user_data)
+{
+	PTreeBTreeNode	*stack[P_TREE_BTREE_MAX_DEPTH];
+	pint		indexes[P_TREE_BTREE_MAX_DEPTH];
+	PTreeBTreeNode	*node;
+	PTreeBTreeNode	*top;
+	pint		depth;
+	pint		index;
+
+	depth = 0;
+
+	/* Remember the path to the lower bound, all the keys on the left of it
+	 * are skipped */
+	for (node = (PTreeBTreeNode *) root_node; node != NULL; ++depth) {
+		index          = pp_tree_btree_find_bound (node, from, compare_func, data, FALSE);
+		stack[depth]   = node;
+		indexes[depth] = index;
+		node           = node->is_leaf == TRUE ? NULL : node->children[index];
+	}
+
+	while (depth > 0) {
+		top   = stack[depth - 1];
+		index = indexes[depth - 1];
+
+		if (index >= top->nkeys) {
+			--depth;
+			continue;
+		}
+
+		if (compare_func (top->keys[index], to, data) >= 0)
+			return;
+
+		if (traverse_func (top->keys[index], top->values[index], user_data) == TRUE)
+			return;
+
+		indexes[depth - 1] = index + 1;
+
+		for (node = top->is_leaf == TRUE ? NULL : top->children[index + 1]; node != NULL; ++depth) {
+			stack[depth]   = node;
+			indexes[depth] = 0;
+			node           = node->is_leaf == TRUE ? NULL : node->children[0];
+		}
+	}
+}
+
+/* Every path node except the last one keeps the index of the child the path
+ * goes through, the last one keeps the index of the current key. The tree is
+ * never deeper than P_TREE_BTREE_MAX_DEPTH, so the path always fits */
+pboolean
+p_tree_btree_iter_step (PTreeBaseNode	*root_node,
+			ppointer	*path,
+			pint		*indices,
+			pint		*depth,
+			pboolean	forward,
+			ppointer	*key,
+			ppointer	*value)
+{
+	PTreeBTreeNode	*node;
+	pint		top;
+
+	if (P_UNLIKELY (root_node == NULL)) {
+		*depth = 0;
+		return FALSE;
+	}
+
+	if (*depth == 0)
+		node = (PTreeBTreeNode *) root_node;
+	else {
+		top  = *depth - 1;
+		node = (PTreeBTreeNode *) path[top];
+
+		if (node->is_leaf == FALSE) {
+			/* Go down to the closest key of the neighbour subtree */
+			if (forward == TRUE)
+				++indices[top];
+
+			node = node->children[indices[top]];
+		} else if (forward == TRUE && indices[top] + 1 < node->nkeys) {
+			++indices[top];
+			node = NULL;
+		} else if (forward == FALSE && indices[top] > 0) {
+			--indices[top];
+			node = NULL;
+		} else {
+			/* Go up until the child has a key next to it */
+			do
+				--(*depth);
+			while (*depth > 0 &&
+			       (forward == TRUE ?
+				indices[*depth - 1] == ((PTreeBTreeNode *) path[*depth - 1])->nkeys :
+				indices[*depth - 1] == 0));
+
+			if (*depth == 0)
+				return FALSE;
+
+			if (forward == FALSE)
+				--indices[*depth - 1];
+
+			node = NULL;
+		}
+	}
+
+	while (node != NULL) {
+		path[*depth]    = node;
+		indices[*depth] = forward == TRUE ? 0 : node->nkeys;
+
+		if (node->is_leaf == TRUE && forward == FALSE)
+			--indices[*depth];
+
+		++(*depth);
+
+		node = node->is_leaf == TRUE ? NULL : node->children[indices[*depth - 1]];
+	}
+
+	top  = *depth - 1;
+	node = (PTreeBTreeNode *) path[top];
+
+	if (key != NULL)
+		*key = node->keys[indices[top]];
+
+	if (value != NULL)
+		*value = node->values[indices[top]];
+
+	return TRUE;
+}
+
+/* Every subtree gets the minimal number of children (but at least two) which can
+ * hold its keys, and the keys are spread evenly among the children. This keeps
+ * all the leaves on the same level and every node filled at least up to the
+ * minimal number of keys. The capacity of a subtree of height h is 16^h - 1, so
+ * @a child_capacity holds 16^(h - 1), which is 1 for the leaves */
+pboolean
+p_tree_btree_build (PTreeBaseNode	**root_node,
+		    PTreeNodePool	*pool,
+		    ppointer		*keys,
+		    ppointer		*values,
+		    psize		count)
+{
+	PTreeBTreeBuildFrame	stack[P_TREE_BTREE_MAX_DEPTH];
+	PTreeBTreeBuildFrame	*top;
+	PTreeBTreeNode		*node;
+	psize			capacity;
+	psize			nkeys;
+	psize			pos;
+	pint			depth;
+	pint			i;
+
+	*root_node = NULL;
+
+	if (count == 0)
+		return TRUE;
+
+	capacity = 1;
+
+	while (count >= capacity * (P_TREE_BTREE_MAX_KEYS + 1))
+		capacity *= P_TREE_BTREE_MAX_KEYS + 1;
+
+	nkeys = count;
+	pos   = 0;
+	depth = 0;
+
+	while (TRUE) {
+		if (P_UNLIKELY ((node = pp_tree_btree_node_new (pool, capacity == 1)) == NULL)) {
+			/* The node without any child yet can be freed as an empty leaf */
+			if (depth > 0 && stack[depth - 1].next_child == 0)
+				stack[depth - 1].node->is_leaf = TRUE;
+
+			return FALSE;
+		}
+
+		if (depth == 0)
+			*root_node = (PTreeBaseNode *) node;
+		else {
+			top = &stack[depth - 1];
+			i   = top->next_child;
+
+			/* The separator goes right before the keys of the new child */
+			if (i > 0) {
+				top->node->keys[i - 1]   = keys[pos];
+				top->node->values[i - 1] = values == NULL ? NULL : values[pos];
+				top->node->nkeys         = i;
+				++pos;
+			}
+
+			top->node->children[i] = node;
+		}
+
+		if (capacity > 1) {
+			top = &stack[depth++];
+
+			top->node           = node;
+			top->child_capacity = capacity / (P_TREE_BTREE_MAX_KEYS + 1);
+			top->nchildren      = (pint) ((nkeys + capacity) / capacity);
+
+			if (top->nchildren < 2)
+				top->nchildren = 2;
+
+			top->child_keys = (nkeys - (psize) top->nchildren + 1) / (psize) top->nchildren;
+			top->nlarger    = (pint) ((nkeys - (psize) top->nchildren + 1) % (psize) top->nchildren);
+			top->next_child = 0;
+		} else {
+			for (i = 0; i < (pint) nkeys; ++i) {
+				node->keys[i]   = keys[pos];
+				node->values[i] = values == NULL ? NULL : values[pos];
+				++pos;
+			}
+
+			node->nkeys = (pint) nkeys;
+
+			/* Go up to the first node which still has children to build */
+			while (depth > 0 && ++stack[depth - 1].next_child == stack[depth - 1].nchildren)
+				--depth;
+
+			if (depth == 0)
+				return TRUE;
+		}
+
+		top      = &stack[depth - 1];
+		capacity = top->child_capacity;
+		nkeys    = top->child_keys + (top->next_child < top->nlarger ? 1 : 0);
+	}
+}
+
+void
+p_tree_btree_foreach (PTreeBaseNode	*root_node,
+		      PTraverseFunc	traverse_func,
+		      ppointer		user_data)
+{
+	PTreeBTreeNode	*stack[P_TREE_BTREE_MAX_DEPTH];
+	pint		indexes[P_TREE_BTREE_MAX_DEPTH];
+	PTreeBTreeNode	*node;
+	PTreeBTreeNode	*top;
+	pint		depth;
+	pint		index;
+
+	node  = (PTreeBTreeNode *) root_node;
+	depth = 0;
+
+	while (TRUE) {
+		/* Go down to the leftmost leaf of the subtree */
+		for (; node != NULL; ++depth) {
+			stack[depth]   = node;
+			indexes[depth] = 0;
+			node           = node->is_leaf == TRUE ? NULL : node->children[0];
+		}
+
+		if (depth == 0)
+			break;
+
+		top   = stack[depth - 1];
+		index = indexes[depth - 1];
+
+		if (index >= top->nkeys) {
+			--depth;
+			continue;
+		}
+
+		if (traverse_func (top->keys[index], top->values[index], user_data) == TRUE)
+			return;
+
+		indexes[depth - 1] = index + 1;
+		node               = top->is_leaf == TRUE ? NULL : top->children[index + 1];
+	}
+}
+
+void
+p_tree_btree_clear (PTreeBaseNode	*root_node,
+		    PTreeNodePool	*pool,
+		    PDestroyFunc	key_destroy_func,
+		    PDestroyFunc	value_destroy_func)
+{
+	PTreeBTreeNode	*stack[P_TREE_BTREE_MAX_DEPTH];
+	pint		indexes[P_TREE_BTREE_MAX_DEPTH];
+	PTreeBTreeNode	*top;
+	pint		depth;
+	pint		i;
+
+	if (P_UNLIKELY (root_node == NULL))
+		return;
+
+	stack[0]   = (PTreeBTreeNode *) root_node;
+	indexes[0] = 0;
+	depth      = 1;
+
+	/* Post-order traversal, so a node is freed after all of its children */
+	while (depth > 0) {
+		top = stack[depth - 1];
+
+		if (top->is_leaf == FALSE && indexes[depth - 1] <= top->nkeys) {
+			stack[depth]   = top->children[indexes[depth - 1]++];
+			indexes[depth] = 0;
+			++depth;
+			continue;
+		}
+
+		for (i = 0; i < top->nkeys; ++i) {
+			if (key_destroy_func != NULL)
+				key_destroy_func (top->keys[i]);
+
+			if (value_destroy_func != NULL)
+				value_destroy_func (top->values[i]);
+		}
+
+		/* Pooled nodes are released all at once by the caller */
+		if (pool == NULL)
+			p_free (top);
+
+		--depth;
+	}
+}
@@ -0,0 +1,111 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PTREEBTREE_H
+#define PLIBSYS_HEADER_PTREEBTREE_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+#include "ptree-private.h"
+
+P_BEGIN_DECLS
+
+/* B-tree nodes don't share the binary tree layout, so @a root_node only holds
+ * the root pointer for them and should never be dereferenced as a
+ * #PTreeBaseNode */
+
+pboolean	p_tree_btree_insert	(PTreeBaseNode		**root_node,
+					 PTreeNodePool		*pool,
+					 PCompareDataFunc	compare_func,
+					 ppointer		data,
+					 PDestroyFunc		key_destroy_func,
+					 PDestroyFunc		value_destroy_func,
+					 ppointer		key,
+					 ppointer		value);
+
+pboolean	p_tree_btree_remove	(PTreeBaseNode		**root_node,
+					 PTreeNodePool		*pool,
+					 PCompareDataFunc	compare_func,
+					 ppointer		data,
+					 PDestroyFunc		key_destroy_func,
+					 PDestroyFunc		value_destroy_func,
+					 pconstpointer		key);
+
+ppointer	p_tree_btree_lookup	(PTreeBaseNode		*root_node,
+					 PCompareDataFunc	compare_func,
+					 ppointer		data,
+					 pconstpointer		key);
+
+pboolean	p_tree_btree_lookup_bound	(PTreeBaseNode		*root_node,
+						 PCompareDataFunc	compare_func,
+						 ppointer		data,
+						 pconstpointer		key,
+						 pboolean		is_upper,
+						 ppointer		*found_key,
+						 ppointer		*value);
+
+void		p_tree_btree_foreach_range	(PTreeBaseNode		*root_node,
+						 PCompareDataFunc	compare_func,
+						 ppointer		data,
+						 pconstpointer		from,
+						 pconstpointer		to,
+						 PTraverseFunc		traverse_func,
+						 ppointer		user_data);
+
+/* Moves the cursor given by @a path and @a indices to the neighbour key, a
+ * zero @a depth means the cursor is outside of the tree. @a path must have
+ * room for #P_TREE_ITER_MAX_DEPTH nodes */
+pboolean	p_tree_btree_iter_step	(PTreeBaseNode		*root_node,
+					 ppointer		*path,
+					 pint			*indices,
+					 pint			*depth,
+					 pboolean		forward,
+					 ppointer		*key,
+					 ppointer		*value);
+
+/* Builds a new tree from @a count keys sorted in strictly ascending order, on
+ * failure @a root_node holds a valid part of the tree which should be cleared */
+pboolean	p_tree_btree_build	(PTreeBaseNode		**root_node,
+					 PTreeNodePool		*pool,
+					 ppointer		*keys,
+					 ppointer		*values,
+					 psize			count);
+
+void		p_tree_btree_foreach	(PTreeBaseNode		*root_node,
+					 PTraverseFunc		traverse_func,
+					 ppointer		user_data);
+
+void		p_tree_btree_clear	(PTreeBaseNode		*root_node,
+					 PTreeNodePool		*pool,
+					 PDestroyFunc		key_destroy_func,
+					 PDestroyFunc		value_destroy_func);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PTREEBTREE_H */
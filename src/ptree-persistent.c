@@ -0,0 +1,392 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "patomic.h"
+#include "pmem.h"
+#include "ptree-persistent.h"
+
+/* An AVL tree with 2^31 nodes is less than 46 levels high */
+#define P_TREE_PERSISTENT_MAX_DEPTH	64
+
+typedef struct PTreePersistentNode_ {
+	struct PTreeBaseNode_	base;
+	volatile pint		ref_count;
+	pint			height;
+	pint			size;
+} PTreePersistentNode;
+
+static pint pp_tree_persistent_height (PTreeBaseNode *node);
+static void pp_tree_persistent_update (PTreeBaseNode *node);
+static PTreeBaseNode * pp_tree_persistent_own (PTreeBaseNode **link);
+static pboolean pp_tree_persistent_rotate_left (PTreeBaseNode **link);
+static pboolean pp_tree_persistent_rotate_right (PTreeBaseNode **link);
+static void pp_tree_persistent_balance (PTreeBaseNode **link);
+static void pp_tree_persistent_retrace (PTreeBaseNode ***path, pint depth);
+
+static pint
+pp_tree_persistent_height (PTreeBaseNode *node)
+{
+	return node != NULL ? ((PTreePersistentNode *) node)->height : 0;
+}
+
+static void
+pp_tree_persistent_update (PTreeBaseNode *node)
+{
+	pint left_height;
+	pint right_height;
+
+	left_height  = pp_tree_persistent_height (node->left);
+	right_height = pp_tree_persistent_height (node->right);
+
+	((PTreePersistentNode *) node)->height = 1 + (left_height > right_height ? left_height : right_height);
+	((PTreePersistentNode *) node)->size   = 1 + p_tree_persistent_node_size (node->left) +
+						     p_tree_persistent_node_size (node->right);
+}
+
+/* Makes the node behind @a link private, so it can be modified in place. The
+ * node holding @a link must be private already: then the reference count
+ * tells whether some other tree can reach the node */
+static PTreeBaseNode *
+pp_tree_persistent_own (PTreeBaseNode **link)
+{
+	PTreePersistentNode *node;
+	PTreePersistentNode *copy;
+
+	node = (PTreePersistentNode *) *link;
+
+	if (p_atomic_int_get (&node->ref_count) == 1)
+		return (PTreeBaseNode *) node;
+
+	if (P_UNLIKELY ((copy = p_malloc (sizeof (PTreePersistentNode))) == NULL))
+		return NULL;
+
+	copy->base      = node->base;
+	copy->ref_count = 1;
+	copy->height    = node->height;
+	copy->size      = node->size;
+
+	p_tree_persistent_node_ref (copy->base.left);
+	p_tree_persistent_node_ref (copy->base.right);
+
+	*link = (PTreeBaseNode *) copy;
+
+	/* Other owners may have dropped the node meanwhile */
+	p_tree_persistent_node_unref ((PTreeBaseNode *) node);
+
+	return (PTreeBaseNode *) copy;
+}
+
+/* Rotations move the references around without changing their number */
+static pboolean
+pp_tree_persistent_rotate_left (PTreeBaseNode **link)
+{
+	PTreeBaseNode *node;
+	PTreeBaseNode *right;
+
+	node = *link;
+
+	if (P_UNLIKELY ((right = pp_tree_persistent_own (&node->right)) == NULL))
+		return FALSE;
+
+	node->right = right->left;
+	right->left = node;
+	*link       = right;
+
+	pp_tree_persistent_update (node);
+	pp_tree_persistent_update (right);
+
+	return TRUE;
+}
+
+static pboolean
+pp_tree_persistent_rotate_right (PTreeBaseNode **link)
+{
+	PTreeBaseNode *node;
+	PTreeBaseNode *left;
+
+	node = *link;
+
+	if (P_UNLIKELY ((left = pp_tree_persistent_own (&node->left)) == NULL))
+		return FALSE;
+
+	node->left  = left->right;
+	left->right = node;
+	*link       = left;
+
+	pp_tree_persistent_update (node);
+	pp_tree_persistent_update (left);
+
+	return TRUE;
+}
+
+/* If a child can't be copied for a rotation the subtree is left unbalanced,
+ * which keeps the tree valid, only a bit higher */
+static void
+pp_tree_persistent_balance (PTreeBaseNode **link)
+{
+	PTreeBaseNode	*node;
+	pint		balance_factor;
+
+	node = *link;
+
+	pp_tree_persistent_update (node);
+
+	balance_factor = pp_tree_persistent_height (node->left) - pp_tree_persistent_height (node->right);
+
+	if (balance_factor > 1) {
+		if (pp_tree_persistent_height (node->left->left) <
+		    pp_tree_persistent_height (node->left->right)) {
+			if (P_UNLIKELY (pp_tree_persistent_own (&node->left) == NULL))
+				return;
+
+			if (P_UNLIKELY (pp_tree_persistent_rotate_left (&node->left) == FALSE))
+				return;
+		}
+
+		pp_tree_persistent_rotate_right (link);
+	} else if (balance_factor < -1) {
+		if (pp_tree_persistent_height (node->right->right) <
+		    pp_tree_persistent_height (node->right->left)) {
+			if (P_UNLIKELY (pp_tree_persistent_own (&node->right) == NULL))
+				return;
+
+			if (P_UNLIKELY (pp_tree_persistent_rotate_right (&node->right) == FALSE))
+				return;
+		}
+
+		pp_tree_persistent_rotate_left (link);
+	}
+}
+
+/* Heights and sizes change along the whole path, so it's always walked up to
+ * the root */
+static void
+pp_tree_persistent_retrace (PTreeBaseNode ***path, pint depth)
+{
+	while (depth > 0)
+		pp_tree_persistent_balance (path[--depth]);
+}
+
+pboolean
+p_tree_persistent_insert (PTreeBaseNode		**root_node,
+			  PTreeNodePool		*pool,
+			  PCompareDataFunc	compare_func,
+			  ppointer		data,
+			  PDestroyFunc		key_destroy_func,
+			  PDestroyFunc		value_destroy_func,
+			  ppointer		key,
+			  ppointer		value)
+{
+	PTreeBaseNode	**path[P_TREE_PERSISTENT_MAX_DEPTH];
+	PTreeBaseNode	**cur_link;
+	PTreeBaseNode	*cur_node;
+	pint		cmp_result;
+	pint		depth;
+
+	P_UNUSED (pool);
+	P_UNUSED (key_destroy_func);
+	P_UNUSED (value_destroy_func);
+
+	cur_link = root_node;
+	depth    = 0;
+
+	/* Copy the nodes on the way down, the copies are still valid nodes if
+	 * any allocation fails */
+	while (*cur_link != NULL) {
+		if (P_UNLIKELY (depth == P_TREE_PERSISTENT_MAX_DEPTH))
+			return FALSE;
+
+		if (P_UNLIKELY ((cur_node = pp_tree_persistent_own (cur_link)) == NULL))
+			return FALSE;
+
+		path[depth++] = cur_link;
+		cmp_result    = compare_func (key, cur_node->key, data);
+
+		if (cmp_result < 0)
+			cur_link = &cur_node->left;
+		else if (cmp_result > 0)
+			cur_link = &cur_node->right;
+		else {
+			cur_node->key   = key;
+			cur_node->value = value;
+
+			return FALSE;
+		}
+	}
+
+	if (P_UNLIKELY ((cur_node = p_malloc0 (sizeof (PTreePersistentNode))) == NULL))
+		return FALSE;
+
+	cur_node->key   = key;
+	cur_node->value = value;
+
+	((PTreePersistentNode *) cur_node)->ref_count = 1;
+	((PTreePersistentNode *) cur_node)->height    = 1;
+	((PTreePersistentNode *) cur_node)->size      = 1;
+
+	*cur_link = cur_node;
+
+	pp_tree_persistent_retrace (path, depth);
+
+	return TRUE;
+}
+
+pboolean
+p_tree_persistent_remove (PTreeBaseNode		**root_node,
+			  PTreeNodePool		*pool,
+			  PCompareDataFunc	compare_func,
+			  ppointer		data,
+			  PDestroyFunc		key_destroy_func,
+			  PDestroyFunc		value_destroy_func,
+			  pconstpointer		key)
+{
+	PTreeBaseNode	**path[P_TREE_PERSISTENT_MAX_DEPTH];
+	PTreeBaseNode	**cur_link;
+	PTreeBaseNode	*cur_node;
+	PTreeBaseNode	*found_node;
+	pint		cmp_result;
+	pint		depth;
+
+	P_UNUSED (pool);
+	P_UNUSED (key_destroy_func);
+	P_UNUSED (value_destroy_func);
+
+	/* Don't copy anything for a missing key */
+	cur_node = *root_node;
+
+	while (cur_node != NULL) {
+		cmp_result = compare_func (key, cur_node->key, data);
+
+		if (cmp_result < 0)
+			cur_node = cur_node->left;
+		else if (cmp_result > 0)
+			cur_node = cur_node->right;
+		else
+			break;
+	}
+
+	if (cur_node == NULL)
+		return FALSE;
+
+	cur_link = root_node;
+	depth    = 0;
+
+	while (TRUE) {
+		if (P_UNLIKELY (depth == P_TREE_PERSISTENT_MAX_DEPTH))
+			return FALSE;
+
+		if (P_UNLIKELY ((cur_node = pp_tree_persistent_own (cur_link)) == NULL))
+			return FALSE;
+
+		path[depth++] = cur_link;
+		cmp_result    = compare_func (key, cur_node->key, data);
+
+		if (cmp_result < 0)
+			cur_link = &cur_node->left;
+		else if (cmp_result > 0)
+			cur_link = &cur_node->right;
+		else
+			break;
+	}
+
+	/* A node with two children takes the pair of its successor, which is
+	 * removed instead. Both are private, so no other tree notices that */
+	if (cur_node->left != NULL && cur_node->right != NULL) {
+		found_node = cur_node;
+		cur_link   = &found_node->right;
+
+		while (TRUE) {
+			if (P_UNLIKELY (depth == P_TREE_PERSISTENT_MAX_DEPTH))
+				return FALSE;
+
+			if (P_UNLIKELY ((cur_node = pp_tree_persistent_own (cur_link)) == NULL))
+				return FALSE;
+
+			path[depth++] = cur_link;
+
+			if (cur_node->left == NULL)
+				break;
+
+			cur_link = &cur_node->left;
+		}
+
+		found_node->key   = cur_node->key;
+		found_node->value = cur_node->value;
+	}
+
+	/* The only child keeps its reference, now from the link */
+	*path[--depth] = cur_node->left != NULL ? cur_node->left : cur_node->right;
+
+	p_free (cur_node);
+
+	pp_tree_persistent_retrace (path, depth);
+
+	return TRUE;
+}
+
+pint
+p_tree_persistent_node_size (PTreeBaseNode *node)
+{
+	return node != NULL ? ((PTreePersistentNode *) node)->size : 0;
+}
+
+void
+p_tree_persistent_node_ref (PTreeBaseNode *node)
+{
+	if (node != NULL)
+		p_atomic_int_inc (&((PTreePersistentNode *) node)->ref_count);
+}
+
+/* Nodes to be freed are chained through the left links, the right subtree is
+ * released after the left one */
+void
+p_tree_persistent_node_unref (PTreeBaseNode *node)
+{
+	PTreeBaseNode	*pending_nodes;
+	PTreeBaseNode	*next_node;
+
+	pending_nodes = NULL;
+
+	while (TRUE) {
+		if (node != NULL && p_atomic_int_dec_and_test (&((PTreePersistentNode *) node)->ref_count) == TRUE) {
+			next_node     = node->left;
+			node->left    = pending_nodes;
+			pending_nodes = node;
+			node          = next_node;
+			continue;
+		}
+
+		if (pending_nodes == NULL)
+			break;
+
+		node          = pending_nodes;
+		pending_nodes = node->left;
+		next_node     = node->right;
+
+		p_free (node);
+
+		node = next_node;
+	}
+}
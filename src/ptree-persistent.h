@@ -0,0 +1,73 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PTREEPERSISTENT_H
+#define PLIBSYS_HEADER_PTREEPERSISTENT_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+#include "ptree-private.h"
+
+P_BEGIN_DECLS
+
+/* Persistent AVL tree: the nodes have no parent links and are reference
+ * counted, so several trees can share them. A shared node is never modified,
+ * every change copies the nodes on the path to it instead. The node pool and
+ * the destroy notifiers are not used */
+
+pboolean	p_tree_persistent_insert	(PTreeBaseNode		**root_node,
+						 PTreeNodePool		*pool,
+						 PCompareDataFunc	compare_func,
+						 ppointer		data,
+						 PDestroyFunc		key_destroy_func,
+						 PDestroyFunc		value_destroy_func,
+						 ppointer		key,
+						 ppointer		value);
+
+pboolean	p_tree_persistent_remove	(PTreeBaseNode		**root_node,
+						 PTreeNodePool		*pool,
+						 PCompareDataFunc	compare_func,
+						 ppointer		data,
+						 PDestroyFunc		key_destroy_func,
+						 PDestroyFunc		value_destroy_func,
+						 pconstpointer		key);
+
+/* Gives the number of nodes in the subtree of @a node, 0 for NULL */
+pint		p_tree_persistent_node_size	(PTreeBaseNode	*node);
+
+/* Adds a reference to the subtree of @a node, @a node maybe NULL */
+void		p_tree_persistent_node_ref	(PTreeBaseNode	*node);
+
+/* Drops a reference to the subtree of @a node, freeing the nodes which are
+ * not shared anymore, @a node maybe NULL */
+void		p_tree_persistent_node_unref	(PTreeBaseNode	*node);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PTREEPERSISTENT_H */
@@ -32,6 +32,7 @@
 
 #include "pmacros.h"
 #include "ptypes.h"
+#include "ptree.h"
 
 P_BEGIN_DECLS
 
@@ -43,6 +44,36 @@ typedef struct PTreeBaseNode_ {
 	ppointer		value;	/**< Node value.	*/
 } PTreeBaseNode;
 
+/** Pool of the tree nodes of the same size. */
+typedef struct PTreeNodePool_ PTreeNodePool;
+
+PTreeNodePool *	p_tree_node_pool_new		(void);
+
+/* Allocates a zeroed node, falls back to p_malloc0() if @a pool is NULL. All
+ * the nodes allocated from the same pool must be of the same size */
+ppointer	p_tree_node_pool_alloc		(PTreeNodePool	*pool,
+						 psize		node_size);
+
+/* Puts a node back into @a pool, falls back to p_free() if @a pool is NULL */
+void		p_tree_node_pool_release	(PTreeNodePool	*pool,
+						 ppointer	node);
+
+/* Releases all the nodes at once, including the ones still in use */
+void		p_tree_node_pool_clear		(PTreeNodePool	*pool);
+
+void		p_tree_node_pool_free		(PTreeNodePool	*pool);
+
+/* Looks up @a key in a binary tree which may be modified at the same time by
+ * a writer, the result has to be validated by the caller. Gives up and returns
+ * FALSE if the walk takes more steps than a consistent tree ever needs. All the
+ * nodes must come from a pool which is not cleared during the lookup. The walk
+ * may compare @a key with the keys of the nodes removed meanwhile, so the tree
+ * must not destroy its keys and values, such trees are rejected with FALSE */
+pboolean	p_tree_lookup_optimistic	(PTree		*tree,
+						 pconstpointer	key,
+						 ppointer	*value,
+						 pboolean	*found);
+
 P_END_DECLS
 
 #endif /* PLIBSYS_HEADER_PTREE_PRIVATE_H */
@@ -36,17 +36,25 @@ typedef struct PTreeRBNode_ {
 	struct PTreeBaseNode_	base;
 	struct PTreeRBNode_	*parent;
 	PTreeRBColor		color;
+	pint			size;
 } PTreeRBNode;
 
+/* Intrusive links are used as the nodes, so they must have the same layout */
+typedef char pp_tree_rb_link_check[(sizeof (PTreeLink) == sizeof (PTreeRBNode) &&
+				    offsetof (PTreeLink, parent) == offsetof (PTreeRBNode, parent) &&
+				    offsetof (PTreeLink, color) == offsetof (PTreeRBNode, color)) ? 1 : -1];
+
 static pboolean pp_tree_rb_is_black (PTreeRBNode *node);
 static pboolean pp_tree_rb_is_red (PTreeRBNode *node);
 static PTreeRBNode * pp_tree_rb_get_gparent (PTreeRBNode *node);
 static PTreeRBNode * pp_tree_rb_get_uncle (PTreeRBNode *node);
 static PTreeRBNode * pp_tree_rb_get_sibling (PTreeRBNode *node);
+static void pp_tree_rb_update_size (PTreeRBNode *node);
 static void pp_tree_rb_rotate_left (PTreeRBNode *node, PTreeBaseNode **root);
 static void pp_tree_rb_rotate_right (PTreeRBNode *node, PTreeBaseNode **root);
 static void pp_tree_rb_balance_insert (PTreeRBNode *node, PTreeBaseNode **root);
 static void pp_tree_rb_balance_remove (PTreeRBNode *node, PTreeBaseNode **root);
+static void pp_tree_rb_swap_nodes (PTreeRBNode *node, PTreeRBNode *prev_node, PTreeBaseNode **root);
 
 static pboolean
 pp_tree_rb_is_black (PTreeRBNode *node)
@@ -89,6 +97,14 @@ pp_tree_rb_get_sibling (PTreeRBNode *node)
 		return (PTreeRBNode *) node->parent->base.left;
 }
 
+/* Rotations keep the size of the whole subtree, only the sizes of the moved
+ * nodes should be recalculated, the lower one first */
+static void
+pp_tree_rb_update_size (PTreeRBNode *node)
+{
+	node->size = 1 + p_tree_rb_node_size (node->base.left) + p_tree_rb_node_size (node->base.right);
+}
+
 static void
 pp_tree_rb_rotate_left (PTreeRBNode *node, PTreeBaseNode **root)
 {
@@ -112,6 +128,9 @@ pp_tree_rb_rotate_left (PTreeRBNode *node, PTreeBaseNode **root)
 	((PTreeRBNode *) tmp_node)->parent = node->parent;
 	node->parent = (PTreeRBNode *) tmp_node;
 
+	pp_tree_rb_update_size (node);
+	pp_tree_rb_update_size ((PTreeRBNode *) tmp_node);
+
 	if (P_UNLIKELY (((PTreeRBNode *) tmp_node)->parent == NULL))
 		*root = tmp_node;
 }
@@ -139,6 +158,9 @@ pp_tree_rb_rotate_right (PTreeRBNode *node, PTreeBaseNode **root)
 	((PTreeRBNode *) tmp_node)->parent = node->parent;
 	node->parent = (PTreeRBNode *) tmp_node;
 
+	pp_tree_rb_update_size (node);
+	pp_tree_rb_update_size ((PTreeRBNode *) tmp_node);
+
 	if (P_UNLIKELY (((PTreeRBNode *) tmp_node)->parent == NULL))
 		*root = tmp_node;
 }
@@ -337,8 +359,60 @@ pp_tree_rb_balance_remove (PTreeRBNode *node, PTreeBaseNode **root)
 	}
 }
 
+/* Puts the predecessor of @a node (which has both children) in its place and
+ * vice versa, including the color and the subtree size */
+static void
+pp_tree_rb_swap_nodes (PTreeRBNode *node, PTreeRBNode *prev_node, PTreeBaseNode **root)
+{
+	PTreeRBNode	*parent;
+	PTreeBaseNode	*prev_left;
+	PTreeRBColor	color;
+	pint		size;
+
+	parent    = node->parent;
+	prev_left = prev_node->base.left;
+
+	if (parent == NULL)
+		*root = (PTreeBaseNode *) prev_node;
+	else if (parent->base.left == (PTreeBaseNode *) node)
+		parent->base.left = (PTreeBaseNode *) prev_node;
+	else
+		parent->base.right = (PTreeBaseNode *) prev_node;
+
+	prev_node->base.right = node->base.right;
+	((PTreeRBNode *) node->base.right)->parent = prev_node;
+
+	if (node->base.left == (PTreeBaseNode *) prev_node) {
+		prev_node->base.left = (PTreeBaseNode *) node;
+		node->parent         = prev_node;
+	} else {
+		prev_node->base.left = node->base.left;
+		((PTreeRBNode *) node->base.left)->parent = prev_node;
+
+		prev_node->parent->base.right = (PTreeBaseNode *) node;
+		node->parent                  = prev_node->parent;
+	}
+
+	prev_node->parent = parent;
+
+	node->base.left  = prev_left;
+	node->base.right = NULL;
+
+	if (prev_left != NULL)
+		((PTreeRBNode *) prev_left)->parent = node;
+
+	color            = node->color;
+	node->color      = prev_node->color;
+	prev_node->color = color;
+
+	size            = node->size;
+	node->size      = prev_node->size;
+	prev_node->size = size;
+}
+
 pboolean
 p_tree_rb_insert (PTreeBaseNode		**root_node,
+		  PTreeNodePool		*pool,
 		  PCompareDataFunc	compare_func,
 		  ppointer		data,
 		  PDestroyFunc		key_destroy_func,
@@ -381,23 +455,20 @@ p_tree_rb_insert (PTreeBaseNode		**root_node,
 		return FALSE;
 	}
 
-	if (P_UNLIKELY ((*cur_node = p_malloc0 (sizeof (PTreeRBNode))) == NULL))
+	if (P_UNLIKELY ((*cur_node = p_tree_node_pool_alloc (pool, sizeof (PTreeRBNode))) == NULL))
 		return FALSE;
 
 	(*cur_node)->key   = key;
 	(*cur_node)->value = value;
 
-	((PTreeRBNode *) *cur_node)->color  = P_TREE_RB_COLOR_RED;
-	((PTreeRBNode *) *cur_node)->parent = (PTreeRBNode *) parent_node;
-
-	/* Balance the tree */
-	pp_tree_rb_balance_insert ((PTreeRBNode *) *cur_node, root_node);
+	p_tree_rb_link_node (root_node, parent_node, cur_node, *cur_node);
 
 	return TRUE;
 }
 
 pboolean
 p_tree_rb_remove (PTreeBaseNode		**root_node,
+		  PTreeNodePool		*pool,
 		  PCompareDataFunc	compare_func,
 		  ppointer		data,
 		  PDestroyFunc		key_destroy_func,
@@ -405,9 +476,6 @@ p_tree_rb_remove (PTreeBaseNode		**root_node,
 		  pconstpointer		key)
 {
 	PTreeBaseNode	*cur_node;
-	PTreeBaseNode	*prev_node;
-	PTreeBaseNode	*child_node;
-	PTreeRBNode	*child_parent;
 	pint		cmp_result;
 
 	cur_node = *root_node;
@@ -426,32 +494,84 @@ p_tree_rb_remove (PTreeBaseNode		**root_node,
 	if (P_UNLIKELY (cur_node == NULL))
 		return FALSE;
 
-	if (cur_node->left != NULL && cur_node->right != NULL) {
-		prev_node = cur_node->left;
+	p_tree_rb_unlink_node (root_node, cur_node);
+
+	/* Free unused node */
+	if (key_destroy_func != NULL)
+		key_destroy_func (cur_node->key);
+
+	if (value_destroy_func != NULL)
+		value_destroy_func (cur_node->value);
+
+	p_tree_node_pool_release (pool, cur_node);
+
+	return TRUE;
+}
+
+void
+p_tree_rb_link_node (PTreeBaseNode	**root_node,
+		     PTreeBaseNode	*parent,
+		     PTreeBaseNode	**link,
+		     PTreeBaseNode	*node)
+{
+	PTreeRBNode *size_node;
+
+	node->left  = NULL;
+	node->right = NULL;
+
+	((PTreeRBNode *) node)->color  = P_TREE_RB_COLOR_RED;
+	((PTreeRBNode *) node)->parent = (PTreeRBNode *) parent;
+	((PTreeRBNode *) node)->size   = 1;
+
+	*link = node;
+
+	for (size_node = (PTreeRBNode *) parent; size_node != NULL; size_node = size_node->parent)
+		++size_node->size;
+
+	/* Balance the tree */
+	pp_tree_rb_balance_insert ((PTreeRBNode *) node, root_node);
+}
+
+void
+p_tree_rb_unlink_node (PTreeBaseNode	**root_node,
+		       PTreeBaseNode	*node)
+{
+	PTreeBaseNode	*prev_node;
+	PTreeBaseNode	*child_node;
+	PTreeRBNode	*child_parent;
+	PTreeRBNode	*size_node;
+
+	/* The node is moved down instead of copying the pair of its predecessor,
+	 * the nodes may be embedded into the user data */
+	if (node->left != NULL && node->right != NULL) {
+		prev_node = node->left;
 
 		while (prev_node->right != NULL)
 			prev_node = prev_node->right;
 
-		cur_node->key   = prev_node->key;
-		cur_node->value = prev_node->value;
-
-		/* Mark node for removal */
-		cur_node = prev_node;
+		pp_tree_rb_swap_nodes ((PTreeRBNode *) node, (PTreeRBNode *) prev_node, root_node);
 	}
 
-	child_node = cur_node->left == NULL ? cur_node->right : cur_node->left;
+	/* The node stays in the tree during rebalancing, but it's already not
+	 * counted in the subtree sizes */
+	((PTreeRBNode *) node)->size = 0;
 
-	if (child_node == NULL && pp_tree_rb_is_black ((PTreeRBNode *) cur_node) == TRUE)
-		pp_tree_rb_balance_remove ((PTreeRBNode *) cur_node, root_node);
+	for (size_node = ((PTreeRBNode *) node)->parent; size_node != NULL; size_node = size_node->parent)
+		--size_node->size;
+
+	child_node = node->left == NULL ? node->right : node->left;
+
+	if (child_node == NULL && pp_tree_rb_is_black ((PTreeRBNode *) node) == TRUE)
+		pp_tree_rb_balance_remove ((PTreeRBNode *) node, root_node);
 
 	/* Replace node with its child */
-	if (cur_node == *root_node) {
+	if (node == *root_node) {
 		*root_node   = child_node;
 		child_parent = NULL;
 	} else {
-		child_parent = ((PTreeRBNode *) cur_node)->parent;
+		child_parent = ((PTreeRBNode *) node)->parent;
 
-		if (child_parent->base.left == cur_node)
+		if (child_parent->base.left == node)
 			child_parent->base.left = child_node;
 		else
 			child_parent->base.right = child_node;
@@ -461,20 +581,91 @@ p_tree_rb_remove (PTreeBaseNode		**root_node,
 		((PTreeRBNode *) child_node)->parent = child_parent;
 
 		/* Check if we need to repaint the node */
-		if (pp_tree_rb_is_black ((PTreeRBNode *) cur_node) == TRUE)
-				((PTreeRBNode *) child_node)->color = P_TREE_RB_COLOR_BLACK;
+		if (pp_tree_rb_is_black ((PTreeRBNode *) node) == TRUE)
+			((PTreeRBNode *) child_node)->color = P_TREE_RB_COLOR_BLACK;
 	}
 
-	/* Free unused node */
-	if (key_destroy_func != NULL)
-		key_destroy_func (cur_node->key);
+	node->left  = NULL;
+	node->right = NULL;
 
-	if (value_destroy_func != NULL)
-		value_destroy_func (cur_node->value);
+	((PTreeRBNode *) node)->parent = NULL;
+}
+
+PTreeBaseNode *
+p_tree_rb_node_next (PTreeBaseNode *node)
+{
+	PTreeRBNode *parent;
 
-	p_free (cur_node);
+	if (node->right != NULL) {
+		node = node->right;
 
-	return TRUE;
+		while (node->left != NULL)
+			node = node->left;
+
+		return node;
+	}
+
+	parent = ((PTreeRBNode *) node)->parent;
+
+	while (parent != NULL && parent->base.right == node) {
+		node   = (PTreeBaseNode *) parent;
+		parent = parent->parent;
+	}
+
+	return (PTreeBaseNode *) parent;
+}
+
+PTreeBaseNode *
+p_tree_rb_node_prev (PTreeBaseNode *node)
+{
+	PTreeRBNode *parent;
+
+	if (node->left != NULL) {
+		node = node->left;
+
+		while (node->right != NULL)
+			node = node->right;
+
+		return node;
+	}
+
+	parent = ((PTreeRBNode *) node)->parent;
+
+	while (parent != NULL && parent->base.left == node) {
+		node   = (PTreeBaseNode *) parent;
+		parent = parent->parent;
+	}
+
+	return (PTreeBaseNode *) parent;
+}
+
+PTreeBaseNode *
+p_tree_rb_build_node (PTreeNodePool	*pool,
+		      PTreeBaseNode	*parent,
+		      pint		size,
+		      pint		balance_factor,
+		      pboolean		is_lowest)
+{
+	PTreeRBNode *ret;
+
+	P_UNUSED (balance_factor);
+
+	if (P_UNLIKELY ((ret = p_tree_node_pool_alloc (pool, sizeof (PTreeRBNode))) == NULL))
+		return NULL;
+
+	/* All the paths through black nodes have the same length, the lowest
+	 * level of a not complete tree is the only one that can be red */
+	ret->parent = (PTreeRBNode *) parent;
+	ret->color  = is_lowest == TRUE ? P_TREE_RB_COLOR_RED : P_TREE_RB_COLOR_BLACK;
+	ret->size   = size;
+
+	return (PTreeBaseNode *) ret;
+}
+
+pint
+p_tree_rb_node_size (PTreeBaseNode *node)
+{
+	return node == NULL ? 0 : ((PTreeRBNode *) node)->size;
 }
 
 void
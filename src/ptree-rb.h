@@ -37,6 +37,7 @@
 P_BEGIN_DECLS
 
 pboolean	p_tree_rb_insert	(PTreeBaseNode		**root_node,
+					 PTreeNodePool		*pool,
 					 PCompareDataFunc	compare_func,
 					 ppointer		data,
 					 PDestroyFunc		key_destroy_func,
@@ -45,12 +46,39 @@ pboolean	p_tree_rb_insert	(PTreeBaseNode		**root_node,
 					 ppointer		value);
 
 pboolean	p_tree_rb_remove	(PTreeBaseNode		**root_node,
+					 PTreeNodePool		*pool,
 					 PCompareDataFunc	compare_func,
 					 ppointer		data,
 					 PDestroyFunc		key_destroy_func,
 					 PDestroyFunc		value_destroy_func,
 					 pconstpointer		key);
 
+/* Links a zeroed @a node under @a parent via @a link (which is NULL yet) and
+ * rebalances the tree, the key of @a node must be set already */
+void		p_tree_rb_link_node	(PTreeBaseNode	**root_node,
+					 PTreeBaseNode	*parent,
+					 PTreeBaseNode	**link,
+					 PTreeBaseNode	*node);
+
+/* Unlinks @a node from the tree and rebalances it, @a node is not freed */
+void		p_tree_rb_unlink_node	(PTreeBaseNode	**root_node,
+					 PTreeBaseNode	*node);
+
+/* Give the in-order neighbours of @a node using the parent links, NULL at
+ * the ends */
+PTreeBaseNode *	p_tree_rb_node_next	(PTreeBaseNode	*node);
+
+PTreeBaseNode *	p_tree_rb_node_prev	(PTreeBaseNode	*node);
+
+PTreeBaseNode *	p_tree_rb_build_node	(PTreeNodePool	*pool,
+					 PTreeBaseNode	*parent,
+					 pint		size,
+					 pint		balance_factor,
+					 pboolean	is_lowest);
+
+/* Gives the number of nodes in the subtree of @a node, 0 for NULL */
+pint		p_tree_rb_node_size	(PTreeBaseNode	*node);
+
 void		p_tree_rb_node_free	(PTreeBaseNode	*node);
 
 P_END_DECLS
@@ -27,9 +27,14 @@
 #include "ptree.h"
 #include "ptree-avl.h"
 #include "ptree-bst.h"
+#include "ptree-btree.h"
+#include "ptree-persistent.h"
 #include "ptree-rb.h"
 
+#include <string.h>
+
 typedef pboolean	(*PTreeInsertNode)	(PTreeBaseNode		**root_node,
+						 PTreeNodePool		*pool,
 						 PCompareDataFunc	compare_func,
 						 ppointer		data,
 						 PDestroyFunc		key_destroy_func,
@@ -38,6 +43,7 @@ typedef pboolean	(*PTreeInsertNode)	(PTreeBaseNode		**root_node,
 						 ppointer		value);
 
 typedef pboolean	(*PTreeRemoveNode)	(PTreeBaseNode		**root_node,
+						 PTreeNodePool		*pool,
 						 PCompareDataFunc	compare_func,
 						 ppointer		data,
 						 PDestroyFunc		key_destroy_func,
@@ -46,19 +52,205 @@ typedef pboolean	(*PTreeRemoveNode)	(PTreeBaseNode		**root_node,
 
 typedef void		(*PTreeFreeNode)	(PTreeBaseNode	*node);
 
+typedef pint		(*PTreeNodeSize)	(PTreeBaseNode	*node);
+
+typedef PTreeBaseNode *	(*PTreeBuildNode)	(PTreeNodePool		*pool,
+						 PTreeBaseNode		*parent,
+						 pint			size,
+						 pint			balance_factor,
+						 pboolean		is_lowest);
+
+/* Subtree of a binary tree still to be built from a sorted array */
+typedef struct PTreeBuildFrame_ {
+	psize		start;
+	psize		end;
+	pint		depth;
+	PTreeBaseNode	*parent;
+	PTreeBaseNode	**link;
+} PTreeBuildFrame;
+
+/* A balanced tree can't be deeper than the number of bits in the node count,
+ * and the build stack keeps at most one pending subtree per level */
+#define P_TREE_BUILD_STACK_SIZE	(sizeof (psize) * 8 + 1)
+
+/* Balanced trees never get that deep, only a degenerated binary one needs a
+ * heap allocated stack for the range traversal */
+#define P_TREE_RANGE_STACK_SIZE	64
+
+/* Slabs of the node pool grow from the minimal to the maximal number of
+ * nodes, doubling every time */
+#define P_TREE_POOL_MIN_SLAB	16
+#define P_TREE_POOL_MAX_SLAB	1024
+
+struct PTreeNodePool_ {
+	ppointer	free_nodes;
+	ppointer	slabs;
+	psize		node_size;
+	psize		slab_nodes;
+	psize		slab_used;
+};
+
 struct PTree_ {
 	PTreeBaseNode		*root;
+	PTreeNodePool		*pool;
 	PTreeInsertNode		insert_node_func;
 	PTreeRemoveNode		remove_node_func;
 	PTreeFreeNode		free_node_func;
+	PTreeNodeSize		node_size_func;
 	PDestroyFunc		key_destroy_func;
 	PDestroyFunc		value_destroy_func;
 	PCompareDataFunc	compare_func;
 	ppointer		data;
 	PTreeType		type;
 	pint			nnodes;
+	pboolean		is_persistent;
 };
 
+static pboolean pp_tree_lookup_bound (PTree *tree, pconstpointer key, pboolean is_upper, ppointer *found_key, ppointer *value);
+static pint pp_tree_build_height (psize count);
+static pboolean pp_tree_build_binary (PTree *tree, PTreeBuildNode build_func, ppointer *keys, ppointer *values, psize count);
+static PTreeBaseNode * pp_tree_iter_find_neighbour (PTree *tree, pconstpointer key, pboolean forward);
+static pboolean pp_tree_iter_step (PTreeIter *iter, pboolean forward, ppointer *key, ppointer *value);
+
+PTreeNodePool *
+p_tree_node_pool_new (void)
+{
+	return p_malloc0 (sizeof (PTreeNodePool));
+}
+
+/* Every slab starts with a link to the previous one, followed by the nodes.
+ * Free nodes are linked through their first pointer */
+ppointer
+p_tree_node_pool_alloc (PTreeNodePool *pool, psize node_size)
+{
+	ppointer	ret;
+	ppointer	slab;
+	psize		slab_nodes;
+
+	if (pool == NULL)
+		return p_malloc0 (node_size);
+
+	if (pool->free_nodes != NULL) {
+		ret              = pool->free_nodes;
+		pool->free_nodes = *((ppointer *) ret);
+
+		memset (ret, 0, pool->node_size);
+
+		return ret;
+	}
+
+	if (pool->slabs == NULL || pool->slab_used == pool->slab_nodes) {
+		if (pool->slab_nodes < P_TREE_POOL_MIN_SLAB)
+			slab_nodes = P_TREE_POOL_MIN_SLAB;
+		else if (pool->slab_nodes < P_TREE_POOL_MAX_SLAB)
+			slab_nodes = pool->slab_nodes * 2;
+		else
+			slab_nodes = P_TREE_POOL_MAX_SLAB;
+
+		if (P_UNLIKELY ((slab = p_malloc0 (sizeof (ppointer) + slab_nodes * node_size)) == NULL))
+			return NULL;
+
+		*((ppointer *) slab) = pool->slabs;
+
+		pool->slabs      = slab;
+		pool->node_size  = node_size;
+		pool->slab_nodes = slab_nodes;
+		pool->slab_used  = 0;
+	}
+
+	ret = (pchar *) pool->slabs + sizeof (ppointer) + pool->slab_used * pool->node_size;
+	++pool->slab_used;
+
+	return ret;
+}
+
+void
+p_tree_node_pool_release (PTreeNodePool *pool, ppointer node)
+{
+	if (pool == NULL) {
+		p_free (node);
+		return;
+	}
+
+	*((ppointer *) node) = pool->free_nodes;
+	pool->free_nodes     = node;
+}
+
+void
+p_tree_node_pool_clear (PTreeNodePool *pool)
+{
+	ppointer slab;
+	ppointer next_slab;
+
+	if (pool == NULL)
+		return;
+
+	for (slab = pool->slabs; slab != NULL; slab = next_slab) {
+		next_slab = *((ppointer *) slab);
+		p_free (slab);
+	}
+
+	pool->free_nodes = NULL;
+	pool->slabs      = NULL;
+	pool->slab_nodes = 0;
+	pool->slab_used  = 0;
+}
+
+void
+p_tree_node_pool_free (PTreeNodePool *pool)
+{
+	p_tree_node_pool_clear (pool);
+	p_free (pool);
+}
+
+static pboolean
+pp_tree_lookup_bound (PTree		*tree,
+		      pconstpointer	key,
+		      pboolean		is_upper,
+		      ppointer		*found_key,
+		      ppointer		*value)
+{
+	PTreeBaseNode	*cur_node;
+	PTreeBaseNode	*bound_node;
+	pint		cmp_result;
+
+	if (P_UNLIKELY (tree == NULL))
+		return FALSE;
+
+	if (tree->type == P_TREE_TYPE_BTREE)
+		return p_tree_btree_lookup_bound (tree->root,
+						  tree->compare_func,
+						  tree->data,
+						  key,
+						  is_upper,
+						  found_key,
+						  value);
+
+	cur_node   = tree->root;
+	bound_node = NULL;
+
+	while (cur_node != NULL) {
+		cmp_result = tree->compare_func (cur_node->key, key, tree->data);
+
+		if (cmp_result > 0 || (cmp_result == 0 && is_upper == FALSE)) {
+			bound_node = cur_node;
+			cur_node   = cur_node->left;
+		} else
+			cur_node = cur_node->right;
+	}
+
+	if (bound_node == NULL)
+		return FALSE;
+
+	if (found_key != NULL)
+		*found_key = bound_node->key;
+
+	if (value != NULL)
+		*value = bound_node->value;
+
+	return TRUE;
+}
+
 P_LIB_API PTree *
 p_tree_new (PTreeType		type,
 	    PCompareFunc	func)
@@ -83,7 +275,7 @@ p_tree_new_full (PTreeType		type,
 {
 	PTree *ret;
 
-	if (P_UNLIKELY (!(type >= P_TREE_TYPE_BINARY && type <= P_TREE_TYPE_AVL)))
+	if (P_UNLIKELY (!(type >= P_TREE_TYPE_BINARY && type <= P_TREE_TYPE_BTREE)))
 		return NULL;
 
 	if (P_UNLIKELY (func == NULL))
@@ -110,14 +302,227 @@ p_tree_new_full (PTreeType		type,
 		ret->insert_node_func = p_tree_rb_insert;
 		ret->remove_node_func = p_tree_rb_remove;
 		ret->free_node_func   = p_tree_rb_node_free;
+		ret->node_size_func   = p_tree_rb_node_size;
 		break;
 	case P_TREE_TYPE_AVL:
 		ret->insert_node_func = p_tree_avl_insert;
 		ret->remove_node_func = p_tree_avl_remove;
 		ret->free_node_func   = p_tree_avl_node_free;
+		ret->node_size_func   = p_tree_avl_node_size;
+		break;
+	case P_TREE_TYPE_BTREE:
+		ret->insert_node_func = p_tree_btree_insert;
+		ret->remove_node_func = p_tree_btree_remove;
+		ret->free_node_func   = NULL;
+		break;
+	}
+
+	return ret;
+}
+
+P_LIB_API PTree *
+p_tree_new_pooled (PTreeType		type,
+		   PCompareDataFunc	func,
+		   ppointer		data,
+		   PDestroyFunc		key_destroy,
+		   PDestroyFunc		value_destroy)
+{
+	PTree *ret;
+
+	if (P_UNLIKELY ((ret = p_tree_new_full (type, func, data, key_destroy, value_destroy)) == NULL))
+		return NULL;
+
+	if (P_UNLIKELY ((ret->pool = p_tree_node_pool_new ()) == NULL)) {
+		P_ERROR ("PTree::p_tree_new_pooled: failed to allocate memory");
+		p_free (ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+static pint
+pp_tree_build_height (psize count)
+{
+	pint ret;
+
+	for (ret = 0; count > 0; count >>= 1)
+		++ret;
+
+	return ret;
+}
+
+/* The middle key of every range becomes the root of its subtree, so the
+ * subtree sizes differ at most by one and only the lowest level is not
+ * complete */
+static pboolean
+pp_tree_build_binary (PTree		*tree,
+		      PTreeBuildNode	build_func,
+		      ppointer		*keys,
+		      ppointer		*values,
+		      psize		count)
+{
+	PTreeBuildFrame	stack[P_TREE_BUILD_STACK_SIZE];
+	PTreeBuildFrame	frame;
+	PTreeBaseNode	*node;
+	psize		middle;
+	psize		depth;
+	pint		lowest_depth;
+
+	if (count == 0)
+		return TRUE;
+
+	lowest_depth = pp_tree_build_height (count) - 1;
+
+	stack[0].start  = 0;
+	stack[0].end    = count;
+	stack[0].depth  = 0;
+	stack[0].parent = NULL;
+	stack[0].link   = &tree->root;
+	depth           = 1;
+
+	while (depth > 0) {
+		frame  = stack[--depth];
+		middle = frame.start + (frame.end - frame.start) / 2;
+
+		node = build_func (tree->pool,
+				   frame.parent,
+				   (pint) (frame.end - frame.start),
+				   pp_tree_build_height (middle - frame.start) -
+				   pp_tree_build_height (frame.end - middle - 1),
+				   frame.depth > 0 && frame.depth == lowest_depth);
+
+		if (P_UNLIKELY (node == NULL))
+			return FALSE;
+
+		node->key   = keys[middle];
+		node->value = values == NULL ? NULL : values[middle];
+
+		*frame.link = node;
+		++tree->nnodes;
+
+		if (middle + 1 < frame.end) {
+			stack[depth].start  = middle + 1;
+			stack[depth].end    = frame.end;
+			stack[depth].depth  = frame.depth + 1;
+			stack[depth].parent = node;
+			stack[depth].link   = &node->right;
+			++depth;
+		}
+
+		if (frame.start < middle) {
+			stack[depth].start  = frame.start;
+			stack[depth].end    = middle;
+			stack[depth].depth  = frame.depth + 1;
+			stack[depth].parent = node;
+			stack[depth].link   = &node->left;
+			++depth;
+		}
+	}
+
+	return TRUE;
+}
+
+P_LIB_API PTree *
+p_tree_new_from_sorted (PTreeType		type,
+			PCompareDataFunc	func,
+			ppointer		data,
+			PDestroyFunc		key_destroy,
+			PDestroyFunc		value_destroy,
+			ppointer		*keys,
+			ppointer		*values,
+			psize			count)
+{
+	PTree		*ret;
+	psize		i;
+	pboolean	result;
+
+	if (P_UNLIKELY (keys == NULL && count > 0))
+		return NULL;
+
+	/* Destroy functions are set only on success, the caller keeps the keys
+	 * and the values otherwise */
+	if (P_UNLIKELY ((ret = p_tree_new_full (type, func, data, NULL, NULL)) == NULL))
+		return NULL;
+
+	for (i = 1; i < count; ++i) {
+		if (P_UNLIKELY (func (keys[i - 1], keys[i], data) >= 0)) {
+			P_WARNING ("PTree::p_tree_new_from_sorted: keys are not in strictly ascending order");
+			p_tree_free (ret);
+			return NULL;
+		}
+	}
+
+	switch (type) {
+	case P_TREE_TYPE_BINARY:
+		result = pp_tree_build_binary (ret, p_tree_bst_build_node, keys, values, count);
+		break;
+	case P_TREE_TYPE_RB:
+		result = pp_tree_build_binary (ret, p_tree_rb_build_node, keys, values, count);
 		break;
+	case P_TREE_TYPE_AVL:
+		result = pp_tree_build_binary (ret, p_tree_avl_build_node, keys, values, count);
+		break;
+	default:
+		result = p_tree_btree_build (&ret->root, ret->pool, keys, values, count);
+
+		if (result == TRUE)
+			ret->nnodes = (pint) count;
+		break;
+	}
+
+	if (P_UNLIKELY (result == FALSE)) {
+		P_ERROR ("PTree::p_tree_new_from_sorted: failed to allocate memory");
+		p_tree_free (ret);
+		return NULL;
+	}
+
+	ret->key_destroy_func   = key_destroy;
+	ret->value_destroy_func = value_destroy;
+
+	return ret;
+}
+
+P_LIB_API PTree *
+p_tree_new_persistent (PCompareDataFunc	func,
+		       ppointer		data)
+{
+	PTree *ret;
+
+	if (P_UNLIKELY ((ret = p_tree_new_full (P_TREE_TYPE_AVL, func, data, NULL, NULL)) == NULL))
+		return NULL;
+
+	ret->insert_node_func = p_tree_persistent_insert;
+	ret->remove_node_func = p_tree_persistent_remove;
+	ret->free_node_func   = NULL;
+	ret->node_size_func   = p_tree_persistent_node_size;
+	ret->is_persistent    = TRUE;
+
+	return ret;
+}
+
+P_LIB_API PTree *
+p_tree_snapshot (PTree *tree)
+{
+	PTree *ret;
+
+	if (P_UNLIKELY (tree == NULL))
+		return NULL;
+
+	if (P_UNLIKELY (tree->is_persistent == FALSE)) {
+		P_WARNING ("PTree::p_tree_snapshot: only persistent trees can share nodes");
+		return NULL;
 	}
 
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PTree))) == NULL)) {
+		P_ERROR ("PTree::p_tree_snapshot: failed to allocate memory");
+		return NULL;
+	}
+
+	*ret = *tree;
+
+	p_tree_persistent_node_ref (ret->root);
+
 	return ret;
 }
 
@@ -132,6 +537,7 @@ p_tree_insert (PTree	*tree,
 		return;
 
 	result = tree->insert_node_func (&tree->root,
+					 tree->pool,
 					 tree->compare_func,
 					 tree->data,
 					 tree->key_destroy_func,
@@ -153,6 +559,7 @@ p_tree_remove (PTree		*tree,
 		return FALSE;
 
 	result = tree->remove_node_func (&tree->root,
+					 tree->pool,
 					 tree->compare_func,
 					 tree->data,
 					 tree->key_destroy_func,
@@ -174,6 +581,9 @@ p_tree_lookup (PTree		*tree,
 	if (P_UNLIKELY (tree == NULL))
 		return NULL;
 
+	if (tree->type == P_TREE_TYPE_BTREE)
+		return p_tree_btree_lookup (tree->root, tree->compare_func, tree->data, key);
+
 	cur_node = tree->root;
 
 	while (cur_node != NULL) {
@@ -190,6 +600,216 @@ p_tree_lookup (PTree		*tree,
 	return NULL;
 }
 
+pboolean
+p_tree_lookup_optimistic (PTree		*tree,
+			  pconstpointer	key,
+			  ppointer	*value,
+			  pboolean	*found)
+{
+	PTreeBaseNode	*cur_node;
+	pint		max_steps;
+	pint		cmp_result;
+
+	*found = FALSE;
+
+	if (P_UNLIKELY (tree->key_destroy_func != NULL || tree->value_destroy_func != NULL))
+		return FALSE;
+
+	/* Balanced trees are never deeper than the iterator path */
+	max_steps = tree->type == P_TREE_TYPE_BINARY ? tree->nnodes + 1 : P_TREE_ITER_MAX_DEPTH;
+	cur_node  = tree->root;
+
+	while (cur_node != NULL) {
+		if (P_UNLIKELY (max_steps-- == 0))
+			return FALSE;
+
+		cmp_result = tree->compare_func (key, cur_node->key, tree->data);
+
+		if (cmp_result < 0)
+			cur_node = cur_node->left;
+		else if (cmp_result > 0)
+			cur_node = cur_node->right;
+		else {
+			*value = cur_node->value;
+			*found = TRUE;
+			break;
+		}
+	}
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_tree_select (PTree	*tree,
+	       pint	index,
+	       ppointer	*key,
+	       ppointer	*value)
+{
+	PTreeBaseNode	*cur_node;
+	pint		left_size;
+
+	if (P_UNLIKELY (tree == NULL || tree->node_size_func == NULL))
+		return FALSE;
+
+	if (P_UNLIKELY (index < 0 || index >= tree->nnodes))
+		return FALSE;
+
+	cur_node = tree->root;
+
+	while (cur_node != NULL) {
+		left_size = tree->node_size_func (cur_node->left);
+
+		if (index < left_size)
+			cur_node = cur_node->left;
+		else if (index > left_size) {
+			index   -= left_size + 1;
+			cur_node = cur_node->right;
+		} else {
+			if (key != NULL)
+				*key = cur_node->key;
+
+			if (value != NULL)
+				*value = cur_node->value;
+
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+P_LIB_API pint
+p_tree_rank (PTree		*tree,
+	     pconstpointer	key)
+{
+	PTreeBaseNode	*cur_node;
+	pint		cmp_result;
+	pint		ret;
+
+	if (P_UNLIKELY (tree == NULL || tree->node_size_func == NULL))
+		return -1;
+
+	cur_node = tree->root;
+	ret      = 0;
+
+	while (cur_node != NULL) {
+		cmp_result = tree->compare_func (key, cur_node->key, tree->data);
+
+		if (cmp_result < 0)
+			cur_node = cur_node->left;
+		else if (cmp_result > 0) {
+			ret     += tree->node_size_func (cur_node->left) + 1;
+			cur_node = cur_node->right;
+		} else
+			return ret + tree->node_size_func (cur_node->left);
+	}
+
+	return ret;
+}
+
+P_LIB_API pboolean
+p_tree_lookup_lower_bound (PTree		*tree,
+			   pconstpointer	key,
+			   ppointer		*found_key,
+			   ppointer		*value)
+{
+	return pp_tree_lookup_bound (tree, key, FALSE, found_key, value);
+}
+
+P_LIB_API pboolean
+p_tree_lookup_upper_bound (PTree		*tree,
+			   pconstpointer	key,
+			   ppointer		*found_key,
+			   ppointer		*value)
+{
+	return pp_tree_lookup_bound (tree, key, TRUE, found_key, value);
+}
+
+P_LIB_API void
+p_tree_foreach_range (PTree		*tree,
+		      pconstpointer	from,
+		      pconstpointer	to,
+		      PTraverseFunc	traverse_func,
+		      ppointer		user_data)
+{
+	PTreeBaseNode	*local_stack[P_TREE_RANGE_STACK_SIZE];
+	PTreeBaseNode	**stack;
+	PTreeBaseNode	**new_stack;
+	PTreeBaseNode	*cur_node;
+	psize		stack_size;
+	psize		depth;
+	pboolean	push_node;
+
+	if (P_UNLIKELY (tree == NULL || traverse_func == NULL))
+		return;
+
+	if (tree->type == P_TREE_TYPE_BTREE) {
+		p_tree_btree_foreach_range (tree->root,
+					    tree->compare_func,
+					    tree->data,
+					    from,
+					    to,
+					    traverse_func,
+					    user_data);
+		return;
+	}
+
+	stack      = local_stack;
+	stack_size = P_TREE_RANGE_STACK_SIZE;
+	depth      = 0;
+	cur_node   = tree->root;
+
+	/* The stack holds the nodes which are not visited yet on the path from
+	 * the root, the top one is always the next in-order node */
+	while (TRUE) {
+		while (cur_node != NULL) {
+			push_node = tree->compare_func (cur_node->key, from, tree->data) >= 0 ? TRUE : FALSE;
+
+			if (push_node == TRUE) {
+				if (P_UNLIKELY (depth == stack_size)) {
+					if (stack == local_stack) {
+						new_stack = p_malloc (stack_size * 2 * sizeof (PTreeBaseNode *));
+
+						if (P_LIKELY (new_stack != NULL))
+							memcpy (new_stack, stack, stack_size * sizeof (PTreeBaseNode *));
+					} else
+						new_stack = p_realloc (stack, stack_size * 2 * sizeof (PTreeBaseNode *));
+
+					if (P_UNLIKELY (new_stack == NULL)) {
+						P_ERROR ("PTree::p_tree_foreach_range: failed to allocate memory");
+						break;
+					}
+
+					stack       = new_stack;
+					stack_size *= 2;
+				}
+
+				stack[depth++] = cur_node;
+				cur_node       = cur_node->left;
+			} else
+				cur_node = cur_node->right;
+		}
+
+		if (cur_node != NULL || depth == 0)
+			break;
+
+		cur_node = stack[--depth];
+
+		if (tree->compare_func (cur_node->key, to, tree->data) >= 0)
+			break;
+
+		if (traverse_func (cur_node->key, cur_node->value, user_data) == TRUE)
+			break;
+
+		/* Everything in the right subtree is above the lower bound */
+		from     = cur_node->key;
+		cur_node = cur_node->right;
+	}
+
+	if (stack != local_stack)
+		p_free (stack);
+}
+
 P_LIB_API void
 p_tree_foreach (PTree		*tree,
 		PTraverseFunc	traverse_func,
@@ -197,6 +817,9 @@ p_tree_foreach (PTree		*tree,
 {
 	PTreeBaseNode	*cur_node;
 	PTreeBaseNode	*prev_node;
+	PTreeIter	iter;
+	ppointer	key;
+	ppointer	value;
 	pint		mod_counter;
 	pboolean	need_stop;
 
@@ -206,6 +829,24 @@ p_tree_foreach (PTree		*tree,
 	if (P_UNLIKELY (tree->root == NULL))
 		return;
 
+	/* Shared nodes can't be modified even for a while, they may be read by
+	 * the other trees from other threads */
+	if (tree->is_persistent == TRUE) {
+		p_tree_iter_init (&iter, tree);
+
+		while (p_tree_iter_next (&iter, &key, &value) == TRUE) {
+			if (traverse_func (key, value, user_data) == TRUE)
+				break;
+		}
+
+		return;
+	}
+
+	if (tree->type == P_TREE_TYPE_BTREE) {
+		p_tree_btree_foreach (tree->root, traverse_func, user_data);
+		return;
+	}
+
 	cur_node    = tree->root;
 	mod_counter = 0;
 	need_stop   = FALSE;
@@ -247,6 +888,146 @@ p_tree_foreach (PTree		*tree,
 	}
 }
 
+/* Used when the path to the current node doesn't fit into the iterator, only
+ * degenerated binary trees can get that deep */
+static PTreeBaseNode *
+pp_tree_iter_find_neighbour (PTree		*tree,
+			     pconstpointer	key,
+			     pboolean		forward)
+{
+	PTreeBaseNode	*cur_node;
+	PTreeBaseNode	*ret_node;
+	pint		cmp_result;
+
+	cur_node = tree->root;
+	ret_node = NULL;
+
+	while (cur_node != NULL) {
+		cmp_result = tree->compare_func (key, cur_node->key, tree->data);
+
+		if (forward == TRUE ? cmp_result < 0 : cmp_result > 0) {
+			ret_node = cur_node;
+			cur_node = forward == TRUE ? cur_node->left : cur_node->right;
+		} else
+			cur_node = forward == TRUE ? cur_node->right : cur_node->left;
+	}
+
+	return ret_node;
+}
+
+/* The path holds all the nodes from the root to the current one. Zero depth
+ * with a current node means that the path didn't fit */
+static pboolean
+pp_tree_iter_step (PTreeIter	*iter,
+		   pboolean	forward,
+		   ppointer	*key,
+		   ppointer	*value)
+{
+	PTree		*tree;
+	PTreeBaseNode	*cur_node;
+	PTreeBaseNode	*child_node;
+	PTreeBaseNode	*parent_node;
+	pboolean	path_lost;
+
+	tree = iter->tree;
+
+	if (tree->type == P_TREE_TYPE_BTREE)
+		return p_tree_btree_iter_step (tree->root,
+					       iter->path,
+					       iter->index,
+					       &iter->depth,
+					       forward,
+					       key,
+					       value);
+
+	cur_node   = (PTreeBaseNode *) iter->node;
+	child_node = NULL;
+	path_lost  = FALSE;
+
+	if (cur_node == NULL) {
+		iter->depth = 0;
+		child_node  = tree->root;
+	} else if (iter->depth == 0) {
+		cur_node  = pp_tree_iter_find_neighbour (tree, cur_node->key, forward);
+		path_lost = TRUE;
+	} else {
+		child_node = forward == TRUE ? cur_node->right : cur_node->left;
+
+		if (child_node == NULL) {
+			/* Go up until we come from the opposite side */
+			do {
+				child_node  = (PTreeBaseNode *) iter->path[--iter->depth];
+				parent_node = iter->depth > 0 ? (PTreeBaseNode *) iter->path[iter->depth - 1] : NULL;
+			} while (parent_node != NULL &&
+				 (forward == TRUE ? parent_node->right : parent_node->left) == child_node);
+
+			cur_node   = parent_node;
+			child_node = NULL;
+		}
+	}
+
+	/* Go down to the closest node of the subtree */
+	while (child_node != NULL) {
+		if (iter->depth < P_TREE_ITER_MAX_DEPTH)
+			iter->path[iter->depth++] = child_node;
+		else
+			path_lost = TRUE;
+
+		cur_node   = child_node;
+		child_node = forward == TRUE ? cur_node->left : cur_node->right;
+	}
+
+	if (path_lost == TRUE)
+		iter->depth = 0;
+
+	iter->node = cur_node;
+
+	if (cur_node == NULL)
+		return FALSE;
+
+	if (key != NULL)
+		*key = cur_node->key;
+
+	if (value != NULL)
+		*value = cur_node->value;
+
+	return TRUE;
+}
+
+P_LIB_API void
+p_tree_iter_init (PTreeIter	*iter,
+		  PTree		*tree)
+{
+	if (P_UNLIKELY (iter == NULL))
+		return;
+
+	iter->tree  = tree;
+	iter->node  = NULL;
+	iter->depth = 0;
+}
+
+P_LIB_API pboolean
+p_tree_iter_next (PTreeIter	*iter,
+		  ppointer	*key,
+		  ppointer	*value)
+{
+	if (P_UNLIKELY (iter == NULL || iter->tree == NULL))
+		return FALSE;
+
+	return pp_tree_iter_step (iter, TRUE, key, value);
+}
+
+P_LIB_API pboolean
+p_tree_iter_prev (PTreeIter	*iter,
+		  ppointer	*key,
+		  ppointer	*value)
+{
+	if (P_UNLIKELY (iter == NULL || iter->tree == NULL))
+		return FALSE;
+
+	return pp_tree_iter_step (iter, FALSE, key, value);
+}
+
 P_LIB_API void
 p_tree_clear (PTree *tree)
 {
@@ -257,6 +1038,32 @@ p_tree_clear (PTree *tree)
 	if (P_UNLIKELY (tree == NULL || tree->root == NULL))
 		return;
 
+	if (tree->is_persistent == TRUE) {
+		p_tree_persistent_node_unref (tree->root);
+
+		tree->root   = NULL;
+		tree->nnodes = 0;
+		return;
+	}
+
+	/* Nothing to destroy, so the pooled nodes are dropped without a walk */
+	if (tree->pool != NULL && tree->key_destroy_func == NULL && tree->value_destroy_func == NULL) {
+		p_tree_node_pool_clear (tree->pool);
+
+		tree->root   = NULL;
+		tree->nnodes = 0;
+		return;
+	}
+
+	if (tree->type == P_TREE_TYPE_BTREE) {
+		p_tree_btree_clear (tree->root, tree->pool, tree->key_destroy_func, tree->value_destroy_func);
+		p_tree_node_pool_clear (tree->pool);
+
+		tree->root   = NULL;
+		tree->nnodes = 0;
+		return;
+	}
+
 	cur_node = tree->root;
 
 	while (cur_node != NULL) {
@@ -269,7 +1076,9 @@ p_tree_clear (PTree *tree)
 			if (tree->value_destroy_func != NULL)
 				tree->value_destroy_func (cur_node->value);
 
-			tree->free_node_func (cur_node);
+			if (tree->pool == NULL)
+				tree->free_node_func (cur_node);
+
 			--tree->nnodes;
 
 			cur_node = next_node;
@@ -286,6 +1095,8 @@ p_tree_clear (PTree *tree)
 		}
 	}
 
+	p_tree_node_pool_clear (tree->pool);
+
 	tree->root = NULL;
 }
 
@@ -310,6 +1121,154 @@ p_tree_get_nnodes (const PTree *tree)
 P_LIB_API void
 p_tree_free (PTree *tree)
 {
+	if (P_UNLIKELY (tree == NULL))
+		return;
+
 	p_tree_clear (tree);
+	p_tree_node_pool_free (tree->pool);
 	p_free (tree);
 }
+
+P_LIB_API void
+p_tree_link_head_init (PTreeLinkHead	*head,
+		       PCompareDataFunc	func,
+		       ppointer		data)
+{
+	if (P_UNLIKELY (head == NULL))
+		return;
+
+	head->root         = NULL;
+	head->compare_func = func;
+	head->data         = data;
+	head->nnodes       = 0;
+}
+
+P_LIB_API PTreeLink *
+p_tree_link_insert (PTreeLinkHead	*head,
+		    PTreeLink		*link,
+		    ppointer		key)
+{
+	PTreeBaseNode	**cur_link;
+	PTreeBaseNode	*parent_node;
+	pint		cmp_result;
+
+	if (P_UNLIKELY (head == NULL || link == NULL || head->compare_func == NULL))
+		return NULL;
+
+	cur_link    = (PTreeBaseNode **) &head->root;
+	parent_node = NULL;
+
+	while (*cur_link != NULL) {
+		cmp_result = head->compare_func (key, (*cur_link)->key, head->data);
+
+		if (cmp_result == 0)
+			return (PTreeLink *) *cur_link;
+
+		parent_node = *cur_link;
+		cur_link    = cmp_result < 0 ? &parent_node->left : &parent_node->right;
+	}
+
+	link->key = key;
+
+	p_tree_rb_link_node ((PTreeBaseNode **) &head->root,
+			     parent_node,
+			     cur_link,
+			     (PTreeBaseNode *) link);
+
+	++head->nnodes;
+
+	return NULL;
+}
+
+P_LIB_API void
+p_tree_link_remove (PTreeLinkHead	*head,
+		    PTreeLink		*link)
+{
+	if (P_UNLIKELY (head == NULL || link == NULL || head->root == NULL))
+		return;
+
+	p_tree_rb_unlink_node ((PTreeBaseNode **) &head->root, (PTreeBaseNode *) link);
+
+	--head->nnodes;
+}
+
+P_LIB_API PTreeLink *
+p_tree_link_lookup (const PTreeLinkHead	*head,
+		    pconstpointer	key)
+{
+	PTreeLink	*cur_link;
+	pint		cmp_result;
+
+	if (P_UNLIKELY (head == NULL || head->compare_func == NULL))
+		return NULL;
+
+	cur_link = head->root;
+
+	while (cur_link != NULL) {
+		cmp_result = head->compare_func (key, cur_link->key, head->data);
+
+		if (cmp_result < 0)
+			cur_link = cur_link->left;
+		else if (cmp_result > 0)
+			cur_link = cur_link->right;
+		else
+			return cur_link;
+	}
+
+	return NULL;
+}
+
+P_LIB_API PTreeLink *
+p_tree_link_first (const PTreeLinkHead *head)
+{
+	PTreeLink *ret;
+
+	if (P_UNLIKELY (head == NULL || head->root == NULL))
+		return NULL;
+
+	for (ret = head->root; ret->left != NULL; ret = ret->left)
+		;
+
+	return ret;
+}
+
+P_LIB_API PTreeLink *
+p_tree_link_last (const PTreeLinkHead *head)
+{
+	PTreeLink *ret;
+
+	if (P_UNLIKELY (head == NULL || head->root == NULL))
+		return NULL;
+
+	for (ret = head->root; ret->right != NULL; ret = ret->right)
+		;
+
+	return ret;
+}
+
+P_LIB_API PTreeLink *
+p_tree_link_next (PTreeLink *link)
+{
+	if (P_UNLIKELY (link == NULL))
+		return NULL;
+
+	return (PTreeLink *) p_tree_rb_node_next ((PTreeBaseNode *) link);
+}
+
+P_LIB_API PTreeLink *
+p_tree_link_prev (PTreeLink *link)
+{
+	if (P_UNLIKELY (link == NULL))
+		return NULL;
+
+	return (PTreeLink *) p_tree_rb_node_prev ((PTreeBaseNode *) link);
+}
+
+P_LIB_API pint
+p_tree_link_get_nnodes (const PTreeLinkHead *head)
+{
+	if (P_UNLIKELY (head == NULL))
+		return 0;
+
+	return head->nnodes;
+}
@@ -36,7 +36,15 @@
  * Currently #PTree supports the following tree types:
  * - unbalanced binary search tree;
  * - red-black self-balancing tree;
- * - AVL self-balancing tree.
+ * - AVL self-balancing tree;
+ * - B-tree.
+ *
+ * Binary trees allocate a node per every key-value pair, so a lookup in a large
+ * tree touches a new cache line on almost every level. #P_TREE_TYPE_BTREE
+ * packs up to 15 pairs into a node sized to a few cache lines and searches
+ * inside a node with a binary search, which makes the tree much shallower and
+ * the lookups less memory latency bound. It is a good choice for large ordered
+ * indexes.
  *
  * Use p_tree_new(), or its detailed variations like p_tree_new_with_data() and
  * p_tree_new_full() to create a tree structure. Take attention that a caller
@@ -48,12 +56,17 @@
  * p_tree_remove().
  *
  * Use p_tree_lookup() to find the value by a given key. You can also traverse
- * the tree in-order with p_tree_foreach().
+ * the tree in-order with p_tree_foreach(), or step through it in both
+ * directions with #PTreeIter, which can be paused at any point.
  *
  * Release memory with p_tree_free() or clear a tree with p_tree_clear(). Keys
  * and values would be destroyed only if the corresponding notification
  * functions were provided.
  *
+ * Objects which are stored in a single tree only can embed a #PTreeLink
+ * instead of being pointed from a separately allocated node, see
+ * p_tree_link_insert(). Such intrusive red-black trees never allocate memory.
+ *
  * Note: all operations with the tree are non-recursive, only iterative calls
  * are used.
  */
@@ -77,9 +90,60 @@ typedef struct PTree_ PTree;
 typedef enum PTreeType_ {
 	P_TREE_TYPE_BINARY	= 0,	/**< Unbalanced binary tree.		*/
 	P_TREE_TYPE_RB		= 1,	/**< Red-black self-balancing tree.	*/
-	P_TREE_TYPE_AVL		= 2	/**< AVL self-balancing tree.		*/
+	P_TREE_TYPE_AVL		= 2,	/**< AVL self-balancing tree.		*/
+	P_TREE_TYPE_BTREE	= 3	/**< B-tree, since 0.0.5.		*/
 } PTreeType;
 
+/** Maximal depth of the path kept by #PTreeIter. */
+#define P_TREE_ITER_MAX_DEPTH	64
+
+/**
+ * @brief Tree iterator.
+ * @since 0.0.5
+ *
+ * The iterator is intended to be allocated on the stack and initialized with
+ * p_tree_iter_init(), its fields are private and should not be accessed
+ * directly.
+ */
+typedef struct PTreeIter_ {
+	PTree		*tree;				/**< Tree being iterated.		*/
+	ppointer	node;				/**< Current node.			*/
+	ppointer	path[P_TREE_ITER_MAX_DEPTH];	/**< Nodes from the root to the current.	*/
+	pint		index[P_TREE_ITER_MAX_DEPTH];	/**< Positions inside the path nodes.	*/
+	pint		depth;				/**< Length of the path.		*/
+} PTreeIter;
+
+/**
+ * @brief Link of an intrusive red-black tree.
+ * @since 0.0.5
+ *
+ * The link is intended to be embedded into a user structure, use
+ * #P_CONTAINER_OF to get the structure back from the link. Only the @a key
+ * field may be read directly, the rest are private.
+ */
+typedef struct PTreeLink_ {
+	struct PTreeLink_	*left;		/**< Left child.			*/
+	struct PTreeLink_	*right;		/**< Right child.			*/
+	ppointer		key;		/**< Key of the link, read-only.	*/
+	ppointer		reserved;	/**< Reserved for the future use.	*/
+	struct PTreeLink_	*parent;	/**< Parent link.			*/
+	pint			color;		/**< Color of the link.			*/
+	pint			size;		/**< Number of links in the subtree.	*/
+} PTreeLink;
+
+/**
+ * @brief Head of an intrusive red-black tree.
+ * @since 0.0.5
+ *
+ * Initialize the head with p_tree_link_head_init(), its fields are private.
+ */
+typedef struct PTreeLinkHead_ {
+	PTreeLink		*root;		/**< Root link, NULL if empty.	*/
+	PCompareDataFunc	compare_func;	/**< Key compare function.	*/
+	ppointer		data;		/**< Data for @a compare_func.	*/
+	pint			nnodes;		/**< Number of links.		*/
+} PTreeLinkHead;
+
 /**
  * @brief Initializes new #PTree.
  * @param type Tree algorithm type to use, can't be changed later.
@@ -127,6 +191,106 @@ P_LIB_API PTree *	p_tree_new_full		(PTreeType		type,
 						 PDestroyFunc		key_destroy,
 						 PDestroyFunc		value_destroy);
 
+/**
+ * @brief Initializes new #PTree which recycles its nodes.
+ * @param type Tree algorithm type to use, can't be changed later.
+ * @param func Key compare function.
+ * @param data Data to be passed to @a func along with the keys.
+ * @param key_destroy Function to call on every key before the node destruction,
+ * maybe NULL.
+ * @param value_destroy Function to call on every value before the node
+ * destruction, maybe NULL.
+ * @return Newly initialized #PTree object in case of success, NULL otherwise.
+ * @since 0.0.5
+ *
+ * Same as p_tree_new_full(), but the nodes are allocated in slabs from a pool
+ * owned by the tree. Removed nodes are kept in the pool for the next
+ * insertions instead of being freed, and p_tree_clear() or p_tree_free()
+ * release all the slabs at once. If no destroy functions are provided,
+ * clearing doesn't even walk through the tree.
+ *
+ * This suits short-lived trees which are rebuilt often. The memory of the
+ * removed nodes is not returned to the system until the tree is cleared.
+ */
+P_LIB_API PTree *	p_tree_new_pooled	(PTreeType		type,
+						 PCompareDataFunc	func,
+						 ppointer		data,
+						 PDestroyFunc		key_destroy,
+						 PDestroyFunc		value_destroy);
+
+/**
+ * @brief Initializes new #PTree from the keys sorted in ascending order.
+ * @param type Tree algorithm type to use, can't be changed later.
+ * @param func Key compare function.
+ * @param data Data to be passed to @a func along with the keys.
+ * @param key_destroy Function to call on every key before the node destruction,
+ * maybe NULL.
+ * @param value_destroy Function to call on every value before the node
+ * destruction, maybe NULL.
+ * @param keys Array of keys in strictly ascending order according to @a func.
+ * @param values Array of values for the @a keys, maybe NULL to use NULL values.
+ * @param count Number of elements in @a keys and @a values.
+ * @return Newly initialized #PTree object in case of success, NULL otherwise.
+ * @since 0.0.5
+ *
+ * The tree is built in a single linear pass without any rebalancing, every
+ * subtree gets the middle key of its range as the root. This is much faster
+ * than inserting the keys one by one, i.e. when loading a sorted snapshot.
+ *
+ * The order of the keys is checked with @a func, NULL is returned if any two
+ * adjacent keys are not in strictly ascending order. The destroy functions are
+ * never called if the tree wasn't created.
+ */
+P_LIB_API PTree *	p_tree_new_from_sorted	(PTreeType		type,
+						 PCompareDataFunc	func,
+						 ppointer		data,
+						 PDestroyFunc		key_destroy,
+						 PDestroyFunc		value_destroy,
+						 ppointer		*keys,
+						 ppointer		*values,
+						 psize			count);
+
+/**
+ * @brief Initializes a new persistent #PTree which can be snapshotted.
+ * @param func Key compare function.
+ * @param data Data to be passed to @a func along with the keys.
+ * @return Newly initialized #PTree object in case of success, NULL otherwise.
+ * @since 0.0.5
+ *
+ * A persistent tree is an AVL tree (p_tree_get_type() returns
+ * #P_TREE_TYPE_AVL) which nodes can be shared with its snapshots, see
+ * p_tree_snapshot(). Shared nodes are never modified: inserting or removing a
+ * key copies only the O(logN) nodes on the path to it, the rest are still
+ * shared. Until any snapshot is taken the tree is modified in place as usual.
+ *
+ * As the keys and the values may be referenced by several trees, persistent
+ * trees don't support the destroy notifiers, so the caller should take care
+ * of the keys and the values after all the trees are freed.
+ */
+P_LIB_API PTree *	p_tree_new_persistent	(PCompareDataFunc	func,
+						 ppointer		data);
+
+/**
+ * @brief Takes a snapshot of a persistent tree.
+ * @param tree Persistent #PTree to take the snapshot of.
+ * @return Snapshot of @a tree in case of success, NULL otherwise.
+ * @since 0.0.5
+ *
+ * The snapshot is a new persistent tree which shares all the nodes with
+ * @a tree, so it takes O(1) time and memory. Both the trees can be modified
+ * independently after that, and neither sees the changes of the other one.
+ * Snapshots can be taken of the snapshots as well, each of them should be
+ * freed with p_tree_free() in any order.
+ *
+ * The shared nodes are reference counted atomically, so a snapshot can be read
+ * (and freed) in another thread while @a tree is being modified. A single tree
+ * object still shouldn't be modified concurrently, p_tree_foreach() doesn't
+ * modify persistent trees while traversing.
+ *
+ * Only the trees created with p_tree_new_persistent() can be snapshotted.
+ */
+P_LIB_API PTree *	p_tree_snapshot		(PTree			*tree);
+
 /**
  * @brief Inserts a new key-value pair into a tree.
  * @param tree #PTree to insert a node in.
@@ -166,6 +330,97 @@ P_LIB_API pboolean	p_tree_remove		(PTree			*tree,
 P_LIB_API ppointer	p_tree_lookup		(PTree			*tree,
 						 pconstpointer		key);
 
+/**
+ * @brief Lookups the first key which is not less than a given one.
+ * @param tree #PTree to lookup in.
+ * @param key Key to lookup the bound for.
+ * @param[out] found_key Found key, maybe NULL.
+ * @param[out] value Value of the found key, maybe NULL.
+ * @return TRUE if such a key exists in the @a tree, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The search takes O(logN) time for the balanced tree types.
+ */
+P_LIB_API pboolean	p_tree_lookup_lower_bound	(PTree		*tree,
+							 pconstpointer	key,
+							 ppointer	*found_key,
+							 ppointer	*value);
+
+/**
+ * @brief Lookups the first key which is greater than a given one.
+ * @param tree #PTree to lookup in.
+ * @param key Key to lookup the bound for.
+ * @param[out] found_key Found key, maybe NULL.
+ * @param[out] value Value of the found key, maybe NULL.
+ * @return TRUE if such a key exists in the @a tree, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The search takes O(logN) time for the balanced tree types.
+ */
+P_LIB_API pboolean	p_tree_lookup_upper_bound	(PTree		*tree,
+							 pconstpointer	key,
+							 ppointer	*found_key,
+							 ppointer	*value);
+
+/**
+ * @brief Gets a key-value pair by its position in the key order.
+ * @param tree #PTree to get the pair from.
+ * @param index Zero-based position of the pair, 0 is the smallest key.
+ * @param[out] key Pointer to store the key of the pair, maybe NULL.
+ * @param[out] value Pointer to store the value of the pair, maybe NULL.
+ * @return TRUE if the pair was found, FALSE if @a index is out of range or
+ * the tree type doesn't support order statistics.
+ * @since 0.0.5
+ *
+ * Red-black and AVL trees keep the size of every subtree in the nodes, so the
+ * call takes O(logN) time, i.e. the median is at the index
+ * p_tree_get_nnodes() / 2. Other tree types are not supported.
+ */
+P_LIB_API pboolean	p_tree_select		(PTree			*tree,
+						 pint			index,
+						 ppointer		*key,
+						 ppointer		*value);
+
+/**
+ * @brief Counts the keys which are less than a given one.
+ * @param tree #PTree to count the keys in.
+ * @param key Key to count the smaller keys for, doesn't need to be in the
+ * tree.
+ * @return Number of the keys less than @a key, -1 if the tree type doesn't
+ * support order statistics.
+ * @since 0.0.5
+ *
+ * That is the position @a key has (or would have) in the key order, so for
+ * the existing keys p_tree_select() with the returned index gives @a key
+ * back. Works in O(logN) time for red-black and AVL trees only.
+ */
+P_LIB_API pint		p_tree_rank		(PTree			*tree,
+						 pconstpointer		key);
+
+/**
+ * @brief Iterates in-order through the tree nodes in a given range of keys.
+ * @param tree A tree to traverse.
+ * @param from Lower bound of the range, inclusive.
+ * @param to Upper bound of the range, exclusive.
+ * @param traverse_func Function for traversing.
+ * @param user_data Additional (maybe NULL) user-provided data for the
+ * @a traverse_func.
+ * @since 0.0.5
+ *
+ * Only the keys from [@a from, @a to) are visited, so the call takes
+ * O(logN + K) time for the balanced tree types, where K is the number of the
+ * visited keys. The traversing stops if @a traverse_func returns TRUE.
+ *
+ * Unlike p_tree_foreach(), the tree structure is not modified along the
+ * traversing process, though it still should not be modified from
+ * @a traverse_func.
+ */
+P_LIB_API void		p_tree_foreach_range	(PTree			*tree,
+						 pconstpointer		from,
+						 pconstpointer		to,
+						 PTraverseFunc		traverse_func,
+						 ppointer		user_data);
+
 /**
  * @brief Iterates in-order through the tree nodes.
  * @param tree A tree to traverse.
@@ -183,6 +438,63 @@ P_LIB_API void		p_tree_foreach		(PTree			*tree,
 						 PTraverseFunc		traverse_func,
 						 ppointer		user_data);
 
+/**
+ * @brief Initializes an iterator over a tree.
+ * @param iter Iterator to initialize.
+ * @param tree Tree to iterate over.
+ * @since 0.0.5
+ *
+ * The iterator doesn't allocate any memory and doesn't require any cleanup.
+ * It starts outside of the tree: p_tree_iter_next() moves it to the smallest
+ * key, and p_tree_iter_prev() moves it to the largest one. The tree must not be
+ * modified during the iteration, otherwise the iterator becomes invalid.
+ *
+ * Typical usage:
+ * @code
+ * PTreeIter	iter;
+ * ppointer	key, value;
+ *
+ * p_tree_iter_init (&iter, tree);
+ *
+ * while (p_tree_iter_next (&iter, &key, &value) == TRUE)
+ *	send_pair (key, value);
+ * @endcode
+ */
+P_LIB_API void		p_tree_iter_init	(PTreeIter		*iter,
+						 PTree			*tree);
+
+/**
+ * @brief Advances an iterator to the next key-value pair in-order.
+ * @param iter Initialized iterator.
+ * @param[out] key Pointer to store the key of the pair, maybe NULL.
+ * @param[out] value Pointer to store the value of the pair, maybe NULL.
+ * @return TRUE if the iterator was advanced to the next pair, FALSE if the end
+ * of the tree was reached.
+ * @since 0.0.5
+ *
+ * Every step takes amortized O(1) time. After reaching the end the iterator is
+ * outside of the tree again, so the next call starts over from the smallest
+ * key.
+ */
+P_LIB_API pboolean	p_tree_iter_next	(PTreeIter		*iter,
+						 ppointer		*key,
+						 ppointer		*value);
+
+/**
+ * @brief Moves an iterator to the previous key-value pair in-order.
+ * @param iter Initialized iterator.
+ * @param[out] key Pointer to store the key of the pair, maybe NULL.
+ * @param[out] value Pointer to store the value of the pair, maybe NULL.
+ * @return TRUE if the iterator was moved to the previous pair, FALSE if the
+ * beginning of the tree was reached.
+ * @since 0.0.5
+ *
+ * Works the same way as p_tree_iter_next(), but in the reverse order.
+ */
+P_LIB_API pboolean	p_tree_iter_prev	(PTreeIter		*iter,
+						 ppointer		*key,
+						 ppointer		*value);
+
 /**
  * @brief Clears a tree.
  * @param tree #PTree to clear.
@@ -225,6 +537,100 @@ P_LIB_API pint		p_tree_get_nnodes	(const PTree		*tree);
  */
 P_LIB_API void		p_tree_free		(PTree			*tree);
 
+/**
+ * @brief Initializes an empty intrusive tree.
+ * @param head Head of the tree to initialize.
+ * @param func Key compare function.
+ * @param data Data to be passed to @a func along with the keys.
+ * @since 0.0.5
+ *
+ * An intrusive tree doesn't own anything, so there is nothing to free: just
+ * drop the head when the links are not needed anymore.
+ */
+P_LIB_API void		p_tree_link_head_init	(PTreeLinkHead		*head,
+						 PCompareDataFunc	func,
+						 ppointer		data);
+
+/**
+ * @brief Inserts a link into an intrusive tree.
+ * @param head Head of the tree to insert the link into.
+ * @param link Link to insert, must not be in any tree.
+ * @param key Key of @a link, usually points inside the structure holding it.
+ * @return NULL in case of success, the link with the same key otherwise.
+ * @since 0.0.5
+ *
+ * Unlike p_tree_insert(), the tree is left unchanged if the key is already in
+ * it. No memory is allocated, so the call can't fail otherwise.
+ */
+P_LIB_API PTreeLink *	p_tree_link_insert	(PTreeLinkHead		*head,
+						 PTreeLink		*link,
+						 ppointer		key);
+
+/**
+ * @brief Removes a link from an intrusive tree.
+ * @param head Head of the tree to remove the link from.
+ * @param link Link to remove, must be in the tree of @a head.
+ * @since 0.0.5
+ *
+ * The link is known already, so no keys are compared. The structure holding
+ * @a link can be freed or inserted into another tree after that.
+ */
+P_LIB_API void		p_tree_link_remove	(PTreeLinkHead		*head,
+						 PTreeLink		*link);
+
+/**
+ * @brief Looks up a link by its key in an intrusive tree.
+ * @param head Head of the tree to look up in.
+ * @param key Key to look up.
+ * @return Link with @a key if found, NULL otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API PTreeLink *	p_tree_link_lookup	(const PTreeLinkHead	*head,
+						 pconstpointer		key);
+
+/**
+ * @brief Gets the link with the smallest key in an intrusive tree.
+ * @param head Head of the tree.
+ * @return The first link, NULL if the tree is empty.
+ * @since 0.0.5
+ */
+P_LIB_API PTreeLink *	p_tree_link_first	(const PTreeLinkHead	*head);
+
+/**
+ * @brief Gets the link with the largest key in an intrusive tree.
+ * @param head Head of the tree.
+ * @return The last link, NULL if the tree is empty.
+ * @since 0.0.5
+ */
+P_LIB_API PTreeLink *	p_tree_link_last	(const PTreeLinkHead	*head);
+
+/**
+ * @brief Gets the in-order next link.
+ * @param link Link in a tree.
+ * @return Link with the next key, NULL for the last one.
+ * @since 0.0.5
+ *
+ * Along with p_tree_link_first() allows to walk the tree without any state,
+ * each step takes O(1) amortized time.
+ */
+P_LIB_API PTreeLink *	p_tree_link_next	(PTreeLink		*link);
+
+/**
+ * @brief Gets the in-order previous link.
+ * @param link Link in a tree.
+ * @return Link with the previous key, NULL for the first one.
+ * @since 0.0.5
+ */
+P_LIB_API PTreeLink *	p_tree_link_prev	(PTreeLink		*link);
+
+/**
+ * @brief Gets the number of links in an intrusive tree.
+ * @param head Head of the tree.
+ * @return Number of the links, 0 in case of error.
+ * @since 0.0.5
+ */
+P_LIB_API pint		p_tree_link_get_nnodes	(const PTreeLinkHead	*head);
+
 P_END_DECLS
 
 #endif /* PLIBSYS_HEADER_PTREE_H */
@@ -0,0 +1,780 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file ptypedcontainers.h
+ * @brief Type-specialized containers
+ * @author Alexander Saprykin
+ *
+ * #PHashTable, #PTree and #PList store keys and values only as pointers:
+ * 64-bit integers and small structures have to be allocated separately, and
+ * every hash and compare goes through a function pointer. The macros from
+ * this header instead generate the containers for the given types, which
+ * store keys and values by value and call the hash and compare functions
+ * directly, so the compiler can inline and specialize them.
+ *
+ * P_DEFINE_HASH_MAP() generates an open addressing hash map with linear
+ * probing, P_DEFINE_SORTED_MAP() generates an ordered map kept in a sorted
+ * array, and P_DEFINE_VECTOR() generates a dynamic array. Each macro
+ * defines a container type with the given name and a set of static inline
+ * functions prefixed with the name, so it can be used both in a source file
+ * and in a header shared by several source files:
+ * @code
+ * typedef struct Point_ {
+ *	pint x;
+ *	pint y;
+ * } Point;
+ *
+ * P_DEFINE_HASH_MAP (PointMap, puint64, Point, p_typed_hash_uint64, P_TYPED_EQUAL)
+ *
+ * PointMap *map = PointMap_new ();
+ * Point     pt  = {1, 2};
+ *
+ * PointMap_insert (map, 42, pt);
+ * PointMap_lookup (map, 42)->y = 3;
+ * PointMap_free (map);
+ * @endcode
+ *
+ * The hash and compare functions receive keys by value, they can be either
+ * functions or function-like macros. The hash function should return an
+ * integer up to 64 bits, the map scrambles it with a multiplicative hash, so
+ * even an identity hash for integer keys doesn't cluster the slots.
+ *
+ * The memory is allocated with p_malloc() and friends, so the memory table
+ * set with p_mem_set_vtable() is respected. Keys and values are copied with
+ * an assignment, the containers never free what they point to. Pointers to
+ * the stored values returned by the lookup functions stay valid only until
+ * the next modification of the container. The containers are not thread
+ * safe.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using "plibsys.h" instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PTYPEDCONTAINERS_H
+#define PLIBSYS_HEADER_PTYPEDCONTAINERS_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+#include "pmem.h"
+
+#if defined (__cplusplus)
+#  define P_TYPED_INLINE_FUNC static inline
+#elif defined (P_CC_MSVC)
+#  define P_TYPED_INLINE_FUNC static __inline
+#else
+#  define P_TYPED_INLINE_FUNC static __inline__
+#endif
+
+/**
+ * @brief Compares two scalar keys for equality.
+ * @param a First key.
+ * @param b Second key.
+ * @return TRUE if the keys are equal, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * Can be used as the equality function of P_DEFINE_HASH_MAP() for integer
+ * and pointer keys.
+ */
+#define P_TYPED_EQUAL(a, b) ((a) == (b))
+
+/**
+ * @brief Compares two scalar keys.
+ * @param a First key.
+ * @param b Second key.
+ * @return Less than zero if @a a < @a b, zero if @a a == @a b, greater than
+ * zero otherwise.
+ * @since 0.0.5
+ *
+ * Can be used as the compare function of P_DEFINE_SORTED_MAP() for integer
+ * and floating point keys.
+ */
+#define P_TYPED_COMPARE(a, b) ((a) < (b) ? -1 : ((a) > (b) ? 1 : 0))
+
+/**
+ * @brief Hashes a 64-bit integer key.
+ * @param key Key to hash.
+ * @return Hash of the key.
+ * @since 0.0.5
+ *
+ * All the bits of the key affect all the bits of the hash (the finalizer of
+ * MurmurHash3).
+ */
+P_TYPED_INLINE_FUNC puint64
+p_typed_hash_uint64 (puint64 key)
+{
+	key ^= key >> 33;
+	key *= 0xFF51AFD7ED558CCDULL;
+	key ^= key >> 33;
+	key *= 0xC4CEB9FE1A85EC53ULL;
+	key ^= key >> 33;
+
+	return key;
+}
+
+/**
+ * @brief Hashes a pointer key.
+ * @param key Key to hash.
+ * @return Hash of the key.
+ * @since 0.0.5
+ */
+P_TYPED_INLINE_FUNC puint64
+p_typed_hash_pointer (pconstpointer key)
+{
+	return p_typed_hash_uint64 ((puint64) (psize) key);
+}
+
+/**
+ * @brief Hashes a memory block, i.e. a structure key.
+ * @param data Memory block to hash.
+ * @param len Length of @a data, in bytes.
+ * @return Hash of the memory block.
+ * @since 0.0.5
+ *
+ * Uses the FNV-1a hash. Note that the padding bytes of a structure are a
+ * part of its memory, so zero them before the insert and the lookup, or hash
+ * the structure members instead.
+ */
+P_TYPED_INLINE_FUNC puint64
+p_typed_hash_mem (pconstpointer	data,
+		  psize		len)
+{
+	const puchar	*bytes = (const puchar *) data;
+	puint64		hash   = 0xCBF29CE484222325ULL;
+	psize		i;
+
+	for (i = 0; i < len; ++i) {
+		hash ^= bytes[i];
+		hash *= 0x100000001B3ULL;
+	}
+
+	return hash;
+}
+
+/**
+ * @brief Generates a hash map type and its functions.
+ * @param name Name of the map type, also used as the functions prefix.
+ * @param key_type Type of the keys.
+ * @param value_type Type of the values.
+ * @param hash_fn Hash function or macro, takes a key and returns an integer.
+ * @param eq_fn Equality function or macro, takes two keys and returns
+ * non-zero if they are equal.
+ * @since 0.0.5
+ *
+ * Defines the following:
+ * - name##Entry: a structure with the @a key and @a value members;
+ * - name: the map structure, treat it as opaque;
+ * - name *name##_new (void): creates an empty map, no slots are allocated
+ * until the first insert, returns NULL if failed;
+ * - void name##_free (name *map): frees the map;
+ * - psize name##_size (const name *map): gets the number of entries;
+ * - pboolean name##_reserve (name *map, psize count): allocates the slots
+ * for at least @a count entries at once, returns FALSE if failed;
+ * - pboolean name##_insert (name *map, key_type key, value_type value):
+ * inserts the entry or replaces the value of the existing one, returns FALSE
+ * if failed to allocate the memory;
+ * - value_type *name##_lookup (const name *map, key_type key): gets the
+ * pointer to the value stored for the key, NULL if there is no such key;
+ * - pboolean name##_remove (name *map, key_type key): removes the entry,
+ * returns FALSE if there is no such key;
+ * - void name##_clear (name *map): removes all the entries, keeps the slots;
+ * - name##Entry *name##_next (const name *map, psize *pos): walks through
+ * the entries in an arbitrary order, start with *pos set to 0, returns NULL
+ * at the end. The map must not be modified during the walk.
+ *
+ * The load factor is kept below 3/4, the removal shifts the following
+ * entries back instead of leaving tombstones, so the lookups don't degrade
+ * after many removals.
+ */
+#define P_DEFINE_HASH_MAP(name, key_type, value_type, hash_fn, eq_fn)			\
+typedef struct name##Entry_ {								\
+	key_type	key;								\
+	value_type	value;								\
+} name##Entry;										\
+											\
+typedef struct name##_ {								\
+	name##Entry	*entries;							\
+	puchar		*used;								\
+	psize		capacity;							\
+	psize		size;								\
+	puint		shift;								\
+} name;											\
+											\
+P_TYPED_INLINE_FUNC psize								\
+name##_home_slot (const name *map, key_type key)					\
+{											\
+	return (psize) (((puint64) (hash_fn (key)) * 0x9E3779B97F4A7C15ULL) >> map->shift); \
+}											\
+											\
+P_TYPED_INLINE_FUNC pboolean								\
+name##_resize (name *map, psize capacity)						\
+{											\
+	name##Entry	*old_entries  = map->entries;					\
+	puchar		*old_used     = map->used;					\
+	psize		old_capacity  = map->capacity;					\
+	puint		shift         = 64;						\
+	psize		i;								\
+	psize		j;								\
+											\
+	if (P_UNLIKELY (capacity > ((psize) -1) / sizeof (name##Entry)))		\
+		return FALSE;								\
+											\
+	for (i = capacity; i > 1; i >>= 1)						\
+		--shift;								\
+											\
+	map->entries = (name##Entry *) p_malloc (capacity * sizeof (name##Entry));	\
+	map->used    = (puchar *) p_malloc0 (capacity);					\
+											\
+	if (P_UNLIKELY (map->entries == NULL || map->used == NULL)) {			\
+		p_free (map->entries);							\
+		p_free (map->used);							\
+											\
+		map->entries = old_entries;						\
+		map->used    = old_used;						\
+											\
+		return FALSE;								\
+	}										\
+											\
+	map->capacity = capacity;							\
+	map->shift    = shift;								\
+											\
+	for (i = 0; i < old_capacity; ++i) {						\
+		if (!old_used[i])							\
+			continue;							\
+											\
+		for (j = name##_home_slot (map, old_entries[i].key);			\
+		     map->used[j];							\
+		     j = (j + 1) & (capacity - 1))					\
+			;								\
+											\
+		map->entries[j] = old_entries[i];					\
+		map->used[j]    = 1;							\
+	}										\
+											\
+	p_free (old_entries);								\
+	p_free (old_used);								\
+											\
+	return TRUE;									\
+}											\
+											\
+P_TYPED_INLINE_FUNC psize								\
+name##_find (const name *map, key_type key)						\
+{											\
+	psize i;									\
+											\
+	if (map->size == 0)								\
+		return map->capacity;							\
+											\
+	for (i = name##_home_slot (map, key); map->used[i]; i = (i + 1) & (map->capacity - 1)) { \
+		if (eq_fn (map->entries[i].key, key))					\
+			return i;							\
+	}										\
+											\
+	return map->capacity;								\
+}											\
+											\
+P_TYPED_INLINE_FUNC name *								\
+name##_new (void)									\
+{											\
+	return (name *) p_malloc0 (sizeof (name));					\
+}											\
+											\
+P_TYPED_INLINE_FUNC void								\
+name##_free (name *map)									\
+{											\
+	if (P_UNLIKELY (map == NULL))							\
+		return;									\
+											\
+	p_free (map->entries);								\
+	p_free (map->used);								\
+	p_free (map);									\
+}											\
+											\
+P_TYPED_INLINE_FUNC psize								\
+name##_size (const name *map)								\
+{											\
+	return P_LIKELY (map != NULL) ? map->size : 0;					\
+}											\
+											\
+P_TYPED_INLINE_FUNC pboolean								\
+name##_reserve (name *map, psize count)							\
+{											\
+	psize capacity = 16;								\
+											\
+	if (P_UNLIKELY (map == NULL))							\
+		return FALSE;								\
+											\
+	while (capacity / 4 * 3 < count) {						\
+		if (P_UNLIKELY (capacity > ((psize) -1) / 2))				\
+			return FALSE;							\
+											\
+		capacity *= 2;								\
+	}										\
+											\
+	if (capacity <= map->capacity)							\
+		return TRUE;								\
+											\
+	return name##_resize (map, capacity);						\
+}											\
+											\
+P_TYPED_INLINE_FUNC pboolean								\
+name##_insert (name *map, key_type key, value_type value)				\
+{											\
+	psize i;									\
+											\
+	if (P_UNLIKELY (map == NULL))							\
+		return FALSE;								\
+											\
+	if (P_UNLIKELY ((map->size + 1) * 4 > map->capacity * 3)) {			\
+		if (P_UNLIKELY (name##_resize (map, map->capacity == 0 ? 16 : map->capacity * 2) == FALSE)) \
+			return FALSE;							\
+	}										\
+											\
+	for (i = name##_home_slot (map, key); map->used[i]; i = (i + 1) & (map->capacity - 1)) { \
+		if (eq_fn (map->entries[i].key, key)) {					\
+			map->entries[i].value = value;					\
+			return TRUE;							\
+		}									\
+	}										\
+											\
+	map->entries[i].key   = key;							\
+	map->entries[i].value = value;							\
+	map->used[i]          = 1;							\
+											\
+	++map->size;									\
+											\
+	return TRUE;									\
+}											\
+											\
+P_TYPED_INLINE_FUNC value_type *							\
+name##_lookup (const name *map, key_type key)						\
+{											\
+	psize i;									\
+											\
+	if (P_UNLIKELY (map == NULL))							\
+		return NULL;								\
+											\
+	i = name##_find (map, key);							\
+											\
+	return i == map->capacity ? NULL : &map->entries[i].value;			\
+}											\
+											\
+P_TYPED_INLINE_FUNC pboolean								\
+name##_remove (name *map, key_type key)							\
+{											\
+	psize i;									\
+	psize j;									\
+	psize k;									\
+											\
+	if (P_UNLIKELY (map == NULL))							\
+		return FALSE;								\
+											\
+	if ((i = name##_find (map, key)) == map->capacity)				\
+		return FALSE;								\
+											\
+	/* Shift back the entries which can't be reached after the hole */		\
+	for (j = (i + 1) & (map->capacity - 1); map->used[j]; j = (j + 1) & (map->capacity - 1)) { \
+		k = name##_home_slot (map, map->entries[j].key);			\
+											\
+		if (i <= j ? (i < k && k <= j) : (i < k || k <= j))			\
+			continue;							\
+											\
+		map->entries[i] = map->entries[j];					\
+		i = j;									\
+	}										\
+											\
+	map->used[i] = 0;								\
+	--map->size;									\
+											\
+	return TRUE;									\
+}											\
+											\
+P_TYPED_INLINE_FUNC void								\
+name##_clear (name *map)								\
+{											\
+	psize i;									\
+											\
+	if (P_UNLIKELY (map == NULL))							\
+		return;									\
+											\
+	for (i = 0; i < map->capacity; ++i)						\
+		map->used[i] = 0;							\
+											\
+	map->size = 0;									\
+}											\
+											\
+P_TYPED_INLINE_FUNC name##Entry *							\
+name##_next (const name *map, psize *pos)						\
+{											\
+	if (P_UNLIKELY (map == NULL || pos == NULL))					\
+		return NULL;								\
+											\
+	for (; *pos < map->capacity; ++*pos) {						\
+		if (map->used[*pos])							\
+			return &map->entries[(*pos)++];					\
+	}										\
+											\
+	return NULL;									\
+}
+
+/**
+ * @brief Generates an ordered map type and its functions.
+ * @param name Name of the map type, also used as the functions prefix.
+ * @param key_type Type of the keys.
+ * @param value_type Type of the values.
+ * @param cmp_fn Compare function or macro, takes two keys and returns less
+ * than zero, zero or greater than zero like strcmp().
+ * @since 0.0.5
+ *
+ * The entries are kept in an array sorted by the keys, so the lookup is a
+ * binary search over contiguous memory, while the insert and the remove
+ * shift the tail of the array. It suits maps which are mostly read or built
+ * in the key order, use #PTree for a large map with random updates.
+ *
+ * Defines the following:
+ * - name##Entry: a structure with the @a key and @a value members;
+ * - name: the map structure, treat it as opaque;
+ * - name *name##_new (void): creates an empty map, returns NULL if failed;
+ * - void name##_free (name *map): frees the map;
+ * - psize name##_size (const name *map): gets the number of entries;
+ * - pboolean name##_reserve (name *map, psize count): allocates the memory
+ * for at least @a count entries at once, returns FALSE if failed;
+ * - psize name##_lower_bound (const name *map, key_type key): gets the index
+ * of the first entry with the key not less than @a key, the size of the map
+ * if there is no such entry;
+ * - pboolean name##_insert (name *map, key_type key, value_type value):
+ * inserts the entry or replaces the value of the existing one, returns FALSE
+ * if failed to allocate the memory;
+ * - value_type *name##_lookup (const name *map, key_type key): gets the
+ * pointer to the value stored for the key, NULL if there is no such key;
+ * - pboolean name##_remove (name *map, key_type key): removes the entry,
+ * returns FALSE if there is no such key;
+ * - void name##_clear (name *map): removes all the entries;
+ * - name##Entry *name##_nth (const name *map, psize index): gets the entry
+ * by its index in the key order, NULL if the index is out of range.
+ */
+#define P_DEFINE_SORTED_MAP(name, key_type, value_type, cmp_fn)				\
+typedef struct name##Entry_ {								\
+	key_type	key;								\
+	value_type	value;								\
+} name##Entry;										\
+											\
+typedef struct name##_ {								\
+	name##Entry	*entries;							\
+	psize		capacity;							\
+	psize		size;								\
+} name;											\
+											\
+P_TYPED_INLINE_FUNC name *								\
+name##_new (void)									\
+{											\
+	return (name *) p_malloc0 (sizeof (name));					\
+}											\
+											\
+P_TYPED_INLINE_FUNC void								\
+name##_free (name *map)									\
+{											\
+	if (P_UNLIKELY (map == NULL))							\
+		return;									\
+											\
+	p_free (map->entries);								\
+	p_free (map);									\
+}											\
+											\
+P_TYPED_INLINE_FUNC psize								\
+name##_size (const name *map)								\
+{											\
+	return P_LIKELY (map != NULL) ? map->size : 0;					\
+}											\
+											\
+P_TYPED_INLINE_FUNC pboolean								\
+name##_reserve (name *map, psize count)							\
+{											\
+	name##Entry *entries;								\
+											\
+	if (P_UNLIKELY (map == NULL))							\
+		return FALSE;								\
+											\
+	if (count <= map->capacity)							\
+		return TRUE;								\
+											\
+	if (P_UNLIKELY (count > ((psize) -1) / sizeof (name##Entry)))			\
+		return FALSE;								\
+											\
+	entries = (name##Entry *) p_realloc (map->entries, count * sizeof (name##Entry)); \
+											\
+	if (P_UNLIKELY (entries == NULL))						\
+		return FALSE;								\
+											\
+	map->entries  = entries;							\
+	map->capacity = count;								\
+											\
+	return TRUE;									\
+}											\
+											\
+P_TYPED_INLINE_FUNC psize								\
+name##_lower_bound (const name *map, key_type key)					\
+{											\
+	psize low  = 0;									\
+	psize high;									\
+	psize mid;									\
+											\
+	if (P_UNLIKELY (map == NULL))							\
+		return 0;								\
+											\
+	high = map->size;								\
+											\
+	while (low < high) {								\
+		mid = low + (high - low) / 2;						\
+											\
+		if (cmp_fn (map->entries[mid].key, key) < 0)				\
+			low = mid + 1;							\
+		else									\
+			high = mid;							\
+	}										\
+											\
+	return low;									\
+}											\
+											\
+P_TYPED_INLINE_FUNC pboolean								\
+name##_insert (name *map, key_type key, value_type value)				\
+{											\
+	psize i;									\
+	psize j;									\
+											\
+	if (P_UNLIKELY (map == NULL))							\
+		return FALSE;								\
+											\
+	i = name##_lower_bound (map, key);						\
+											\
+	if (i < map->size && cmp_fn (map->entries[i].key, key) == 0) {			\
+		map->entries[i].value = value;						\
+		return TRUE;								\
+	}										\
+											\
+	if (P_UNLIKELY (map->size == map->capacity)) {					\
+		if (P_UNLIKELY (name##_reserve (map, map->capacity < 8 ? 8 : map->capacity * 2) == FALSE)) \
+			return FALSE;							\
+	}										\
+											\
+	for (j = map->size; j > i; --j)							\
+		map->entries[j] = map->entries[j - 1];					\
+											\
+	map->entries[i].key   = key;							\
+	map->entries[i].value = value;							\
+											\
+	++map->size;									\
+											\
+	return TRUE;									\
+}											\
+											\
+P_TYPED_INLINE_FUNC value_type *							\
+name##_lookup (const name *map, key_type key)						\
+{											\
+	psize i = name##_lower_bound (map, key);					\
+											\
+	if (P_UNLIKELY (map == NULL) || i == map->size || cmp_fn (map->entries[i].key, key) != 0) \
+		return NULL;								\
+											\
+	return &map->entries[i].value;							\
+}											\
+											\
+P_TYPED_INLINE_FUNC pboolean								\
+name##_remove (name *map, key_type key)							\
+{											\
+	psize i = name##_lower_bound (map, key);					\
+											\
+	if (P_UNLIKELY (map == NULL) || i == map->size || cmp_fn (map->entries[i].key, key) != 0) \
+		return FALSE;								\
+											\
+	for (--map->size; i < map->size; ++i)						\
+		map->entries[i] = map->entries[i + 1];					\
+											\
+	return TRUE;									\
+}											\
+											\
+P_TYPED_INLINE_FUNC void								\
+name##_clear (name *map)								\
+{											\
+	if (P_LIKELY (map != NULL))							\
+		map->size = 0;								\
+}											\
+											\
+P_TYPED_INLINE_FUNC name##Entry *							\
+name##_nth (const name *map, psize index)						\
+{											\
+	if (P_UNLIKELY (map == NULL || index >= map->size))				\
+		return NULL;								\
+											\
+	return &map->entries[index];							\
+}
+
+/**
+ * @brief Generates a dynamic array type and its functions.
+ * @param name Name of the array type, also used as the functions prefix.
+ * @param elem_type Type of the elements.
+ * @since 0.0.5
+ *
+ * Defines the following:
+ * - name: the array structure, treat it as opaque;
+ * - name *name##_new (void): creates an empty array, returns NULL if failed;
+ * - void name##_free (name *vec): frees the array;
+ * - psize name##_size (const name *vec): gets the number of elements;
+ * - elem_type *name##_data (const name *vec): gets the pointer to the first
+ * element, the elements are stored contiguously;
+ * - pboolean name##_reserve (name *vec, psize count): allocates the memory
+ * for at least @a count elements at once, returns FALSE if failed;
+ * - pboolean name##_append (name *vec, elem_type elem): adds the element to
+ * the end, returns FALSE if failed to allocate the memory;
+ * - pboolean name##_pop (name *vec, elem_type *elem): removes the last
+ * element and stores it into @a elem (if not NULL), returns FALSE if the
+ * array is empty;
+ * - elem_type *name##_get (const name *vec, psize index): gets the pointer to
+ * the element, NULL if the index is out of range;
+ * - pboolean name##_remove_index (name *vec, psize index): removes the
+ * element and shifts the following ones, returns FALSE if the index is out
+ * of range;
+ * - void name##_clear (name *vec): removes all the elements.
+ */
+#define P_DEFINE_VECTOR(name, elem_type)						\
+typedef struct name##_ {								\
+	elem_type	*data;								\
+	psize		capacity;							\
+	psize		size;								\
+} name;											\
+											\
+P_TYPED_INLINE_FUNC name *								\
+name##_new (void)									\
+{											\
+	return (name *) p_malloc0 (sizeof (name));					\
+}											\
+											\
+P_TYPED_INLINE_FUNC void								\
+name##_free (name *vec)									\
+{											\
+	if (P_UNLIKELY (vec == NULL))							\
+		return;									\
+											\
+	p_free (vec->data);								\
+	p_free (vec);									\
+}											\
+											\
+P_TYPED_INLINE_FUNC psize								\
+name##_size (const name *vec)								\
+{											\
+	return P_LIKELY (vec != NULL) ? vec->size : 0;					\
+}											\
+											\
+P_TYPED_INLINE_FUNC elem_type *								\
+name##_data (const name *vec)								\
+{											\
+	return P_LIKELY (vec != NULL) ? vec->data : NULL;				\
+}											\
+											\
+P_TYPED_INLINE_FUNC pboolean								\
+name##_reserve (name *vec, psize count)							\
+{											\
+	elem_type *data;								\
+											\
+	if (P_UNLIKELY (vec == NULL))							\
+		return FALSE;								\
+											\
+	if (count <= vec->capacity)							\
+		return TRUE;								\
+											\
+	if (P_UNLIKELY (count > ((psize) -1) / sizeof (elem_type)))			\
+		return FALSE;								\
+											\
+	data = (elem_type *) p_realloc (vec->data, count * sizeof (elem_type));		\
+											\
+	if (P_UNLIKELY (data == NULL))							\
+		return FALSE;								\
+											\
+	vec->data     = data;								\
+	vec->capacity = count;								\
+											\
+	return TRUE;									\
+}											\
+											\
+P_TYPED_INLINE_FUNC pboolean								\
+name##_append (name *vec, elem_type elem)						\
+{											\
+	if (P_UNLIKELY (vec == NULL))							\
+		return FALSE;								\
+											\
+	if (P_UNLIKELY (vec->size == vec->capacity)) {					\
+		if (P_UNLIKELY (name##_reserve (vec, vec->capacity < 8 ? 8 : vec->capacity * 2) == FALSE)) \
+			return FALSE;							\
+	}										\
+											\
+	vec->data[vec->size++] = elem;							\
+											\
+	return TRUE;									\
+}											\
+											\
+P_TYPED_INLINE_FUNC pboolean								\
+name##_pop (name *vec, elem_type *elem)							\
+{											\
+	if (P_UNLIKELY (vec == NULL || vec->size == 0))					\
+		return FALSE;								\
+											\
+	--vec->size;									\
+											\
+	if (elem != NULL)								\
+		*elem = vec->data[vec->size];						\
+											\
+	return TRUE;									\
+}											\
+											\
+P_TYPED_INLINE_FUNC elem_type *								\
+name##_get (const name *vec, psize index)						\
+{											\
+	if (P_UNLIKELY (vec == NULL || index >= vec->size))				\
+		return NULL;								\
+											\
+	return &vec->data[index];							\
+}											\
+											\
+P_TYPED_INLINE_FUNC pboolean								\
+name##_remove_index (name *vec, psize index)						\
+{											\
+	if (P_UNLIKELY (vec == NULL || index >= vec->size))				\
+		return FALSE;								\
+											\
+	for (--vec->size; index < vec->size; ++index)					\
+		vec->data[index] = vec->data[index + 1];				\
+											\
+	return TRUE;									\
+}											\
+											\
+P_TYPED_INLINE_FUNC void								\
+name##_clear (name *vec)								\
+{											\
+	if (P_LIKELY (vec != NULL))							\
+		vec->size = 0;								\
+}
+
+#endif /* PLIBSYS_HEADER_PTYPEDCONTAINERS_H */
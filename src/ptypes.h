@@ -1117,6 +1117,26 @@ typedef pint (*PCompareFunc) (pconstpointer a, pconstpointer b);
  */
 typedef pint (*PCompareDataFunc) (pconstpointer a, pconstpointer b, ppointer data);
 
+/**
+ * @brief Calculates a hash value for a given key.
+ * @param key Key to calculate the hash value for.
+ * @return Hash value of the @a key.
+ * @since 0.0.5
+ *
+ * Equal keys (in terms of the corresponding #PEqualFunc) must produce the same
+ * hash value.
+ */
+typedef puint (*PHashFunc) (pconstpointer key);
+
+/**
+ * @brief Checks two keys for equality.
+ * @param a First key to check.
+ * @param b Second key to check.
+ * @return TRUE if the keys are equal, FALSE otherwise.
+ * @since 0.0.5
+ */
+typedef pboolean (*PEqualFunc) (pconstpointer a, pconstpointer b);
+
 P_END_DECLS
 
 #endif /* PLIBSYS_HEADER_PTYPES_H */
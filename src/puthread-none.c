@@ -52,12 +52,14 @@ PUThread *
 p_uthread_create_internal (PUThreadFunc		func,
 			   pboolean		joinable,
 			   PUThreadPriority	prio,
-			   psize		stack_size)
+			   psize		stack_size,
+			   const PUThreadAttr	*thread_attr)
 {
 	P_UNUSED (func);
 	P_UNUSED (joinable);
 	P_UNUSED (prio);
 	P_UNUSED (stack_size);
+	P_UNUSED (thread_attr);
 
 	return NULL;
 }
@@ -100,6 +102,40 @@ p_uthread_set_priority (PUThread		*thread,
 	return FALSE;
 }
 
+P_LIB_API pboolean
+p_uthread_set_affinity (PUThread		*thread,
+			const PUThreadCpuSet	*cpu_set)
+{
+	P_UNUSED (thread);
+	P_UNUSED (cpu_set);
+
+	return FALSE;
+}
+
+P_LIB_API pboolean
+p_uthread_get_affinity (PUThread	*thread,
+			PUThreadCpuSet	*cpu_set)
+{
+	P_UNUSED (thread);
+	P_UNUSED (cpu_set);
+
+	return FALSE;
+}
+
+P_LIB_API pint
+p_uthread_current_cpu (void)
+{
+	return -1;
+}
+
+P_LIB_API pint64
+p_uthread_get_cpu_time (PUThread *thread)
+{
+	P_UNUSED (thread);
+
+	return -1;
+}
+
 P_LIB_API P_HANDLE
 p_uthread_current_id (void)
 {
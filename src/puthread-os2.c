@@ -280,10 +280,16 @@ PUThread *
 p_uthread_create_internal (PUThreadFunc		func,
 			   pboolean		joinable,
 			   PUThreadPriority	prio,
-			   psize		stack_size)
+			   psize		stack_size,
+			   const PUThreadAttr	*thread_attr)
 {
 	PUThread *ret;
 
+	if (P_UNLIKELY (thread_attr != NULL && thread_attr->stack != NULL)) {
+		P_ERROR ("PUThread::p_uthread_create_internal: caller-provided stacks are not supported");
+		return NULL;
+	}
+
 	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PUThread))) == NULL)) {
 		P_ERROR ("PUThread::p_uthread_create_internal: failed to allocate memory");
 		return NULL;
@@ -375,6 +381,40 @@ p_uthread_set_priority (PUThread		*thread,
 	return TRUE;
 }
 
+P_LIB_API pboolean
+p_uthread_set_affinity (PUThread		*thread,
+			const PUThreadCpuSet	*cpu_set)
+{
+	P_UNUSED (thread);
+	P_UNUSED (cpu_set);
+
+	return FALSE;
+}
+
+P_LIB_API pboolean
+p_uthread_get_affinity (PUThread	*thread,
+			PUThreadCpuSet	*cpu_set)
+{
+	P_UNUSED (thread);
+	P_UNUSED (cpu_set);
+
+	return FALSE;
+}
+
+P_LIB_API pint
+p_uthread_current_cpu (void)
+{
+	return -1;
+}
+
+P_LIB_API pint64
+p_uthread_get_cpu_time (PUThread *thread)
+{
+	P_UNUSED (thread);
+
+	return -1;
+}
+
 P_LIB_API P_HANDLE
 p_uthread_current_id (void)
 {
@@ -50,6 +50,19 @@
 #  endif
 #endif
 
+#ifdef PLIBSYS_HAS_PTHREAD_AFFINITY
+#  ifdef PLIBSYS_HAS_PTHREAD_CPUSET_T
+#    include <sys/param.h>
+#    include <sys/cpuset.h>
+#  else
+#    include <sched.h>
+#  endif
+#endif
+
+#if defined (PLIBSYS_HAS_SCHED_GETCPU) && !defined (PLIBSYS_HAS_PTHREAD_AFFINITY)
+#  include <sched.h>
+#endif
+
 #ifdef PLIBSYS_HAS_PTHREAD_PRCTL
 #  include <sys/prctl.h>
 #  include <linux/prctl.h>
@@ -63,6 +76,10 @@
 #  include <kernel/OS.h>
 #endif
 
+#if !defined (PLIBSYS_HAS_PTHREAD_GETCPUCLOCKID) && defined (P_OS_MAC)
+#  include <mach/mach.h>
+#endif
+
 /* Some systems without native pthreads may lack some of the constants,
  * leave them zero as we are not going to use them anyway */
 
@@ -110,6 +127,14 @@
 
 typedef pthread_t puthread_hdl;
 
+#ifdef PLIBSYS_HAS_PTHREAD_AFFINITY
+#  ifdef PLIBSYS_HAS_PTHREAD_CPUSET_T
+typedef cpuset_t puthread_cpu_set;
+#  else
+typedef cpu_set_t puthread_cpu_set;
+#  endif
+#endif
+
 struct PUThread_ {
 	PUThreadBase	base;
 	puthread_hdl	hdl;
@@ -128,6 +153,11 @@ static PMutex *pp_uthread_tls_mutex = NULL;
 static pboolean pp_uthread_get_unix_priority (PUThreadPriority prio, int *sched_policy, int *sched_priority);
 #endif
 
+#if defined (PLIBSYS_HAS_PTHREAD_AFFINITY) || defined (PLIBSYS_HAS_PTHREAD_GETCPUCLOCKID) || \
+    defined (P_OS_MAC)
+static pboolean pp_uthread_get_affinity_hdl (PUThread *thread, puthread_hdl *hdl);
+#endif
+
 static pthread_key_t * pp_uthread_get_tls_key (PUThreadKey *key);
 
 #ifdef PLIBSYS_HAS_POSIX_SCHEDULING
@@ -171,6 +201,26 @@ pp_uthread_get_unix_priority (PUThreadPriority prio, int *sched_policy, int *sch
 }
 #endif
 
+#if defined (PLIBSYS_HAS_PTHREAD_AFFINITY) || defined (PLIBSYS_HAS_PTHREAD_GETCPUCLOCKID) || \
+    defined (P_OS_MAC)
+static pboolean
+pp_uthread_get_affinity_hdl (PUThread *thread, puthread_hdl *hdl)
+{
+	if (thread->base.ours == TRUE) {
+		*hdl = thread->hdl;
+		return TRUE;
+	}
+
+	/* Foreign threads have no handle, only the caller one can be used */
+	if (thread != p_uthread_current ())
+		return FALSE;
+
+	*hdl = pthread_self ();
+
+	return TRUE;
+}
+#endif
+
 static pthread_key_t *
 pp_uthread_get_tls_key (PUThreadKey *key)
 {
@@ -258,7 +308,8 @@ PUThread *
 p_uthread_create_internal (PUThreadFunc		func,
 			   pboolean		joinable,
 			   PUThreadPriority	prio,
-			   psize		stack_size)
+			   psize		stack_size,
+			   const PUThreadAttr	*thread_attr)
 {
 	PUThread		*ret;
 	pthread_attr_t		attr;
@@ -318,6 +369,30 @@ p_uthread_create_internal (PUThreadFunc		func,
 	}
 #endif
 
+	if (thread_attr->stack != NULL) {
+#ifdef PLIBSYS_HAS_PTHREAD_ATTR_SETSTACK
+		if (P_UNLIKELY (pthread_attr_setstack (&attr, thread_attr->stack, stack_size) != 0)) {
+			P_ERROR ("PUThread::p_uthread_create_internal: pthread_attr_setstack() failed");
+#else
+		{
+			P_ERROR ("PUThread::p_uthread_create_internal: caller-provided stacks are not supported");
+#endif
+			pthread_attr_destroy (&attr);
+			p_free (ret);
+			return NULL;
+		}
+
+		/* The size is the one of the given memory */
+		stack_size = 0;
+	}
+
+#ifdef PLIBSYS_HAS_PTHREAD_ATTR_SETGUARDSIZE
+	if (thread_attr->stack == NULL && thread_attr->has_guard_size == TRUE) {
+		if (P_UNLIKELY (pthread_attr_setguardsize (&attr, thread_attr->guard_size) != 0))
+			P_WARNING ("PUThread::p_uthread_create_internal: pthread_attr_setguardsize() failed");
+	}
+#endif
+
 #ifdef PLIBSYS_HAS_POSIX_STACKSIZE
 #  ifdef _SC_THREAD_STACK_MIN
 	if (stack_size > 0) {
@@ -479,6 +554,155 @@ p_uthread_set_priority (PUThread		*thread,
 	return TRUE;
 }
 
+P_LIB_API pboolean
+p_uthread_set_affinity (PUThread		*thread,
+			const PUThreadCpuSet	*cpu_set)
+{
+#ifdef PLIBSYS_HAS_PTHREAD_AFFINITY
+	puthread_cpu_set	native_set;
+	puthread_hdl		hdl;
+	pint			cpu;
+	pint			n_cpus = 0;
+#endif
+
+	if (P_UNLIKELY (thread == NULL || cpu_set == NULL))
+		return FALSE;
+
+#ifdef PLIBSYS_HAS_PTHREAD_AFFINITY
+	if (P_UNLIKELY (pp_uthread_get_affinity_hdl (thread, &hdl) == FALSE)) {
+		P_ERROR ("PUThread::p_uthread_set_affinity: foreign thread is not the caller one");
+		return FALSE;
+	}
+
+	CPU_ZERO (&native_set);
+
+	for (cpu = 0; cpu < P_UTHREAD_CPU_SET_SIZE && cpu < CPU_SETSIZE; ++cpu) {
+		if (p_uthread_cpu_set_contains (cpu_set, cpu) == TRUE) {
+			CPU_SET (cpu, &native_set);
+			++n_cpus;
+		}
+	}
+
+	if (P_UNLIKELY (n_cpus == 0))
+		return FALSE;
+
+	if (P_UNLIKELY (pthread_setaffinity_np (hdl, sizeof (native_set), &native_set) != 0)) {
+		P_ERROR ("PUThread::p_uthread_set_affinity: pthread_setaffinity_np() failed");
+		return FALSE;
+	}
+
+	return TRUE;
+#else
+	return FALSE;
+#endif
+}
+
+P_LIB_API pboolean
+p_uthread_get_affinity (PUThread	*thread,
+			PUThreadCpuSet	*cpu_set)
+{
+#ifdef PLIBSYS_HAS_PTHREAD_AFFINITY
+	puthread_cpu_set	native_set;
+	puthread_hdl		hdl;
+	pint			cpu;
+#endif
+
+	if (P_UNLIKELY (thread == NULL || cpu_set == NULL))
+		return FALSE;
+
+#ifdef PLIBSYS_HAS_PTHREAD_AFFINITY
+	if (P_UNLIKELY (pp_uthread_get_affinity_hdl (thread, &hdl) == FALSE)) {
+		P_ERROR ("PUThread::p_uthread_get_affinity: foreign thread is not the caller one");
+		return FALSE;
+	}
+
+	CPU_ZERO (&native_set);
+
+	if (P_UNLIKELY (pthread_getaffinity_np (hdl, sizeof (native_set), &native_set) != 0)) {
+		P_ERROR ("PUThread::p_uthread_get_affinity: pthread_getaffinity_np() failed");
+		return FALSE;
+	}
+
+	p_uthread_cpu_set_clear (cpu_set);
+
+	for (cpu = 0; cpu < P_UTHREAD_CPU_SET_SIZE && cpu < CPU_SETSIZE; ++cpu) {
+		if (CPU_ISSET (cpu, &native_set))
+			p_uthread_cpu_set_add (cpu_set, cpu);
+	}
+
+	return TRUE;
+#else
+	return FALSE;
+#endif
+}
+
+P_LIB_API pint
+p_uthread_current_cpu (void)
+{
+#ifdef PLIBSYS_HAS_SCHED_GETCPU
+	return (pint) sched_getcpu ();
+#else
+	return -1;
+#endif
+}
+
+P_LIB_API pint64
+p_uthread_get_cpu_time (PUThread *thread)
+{
+#if defined (PLIBSYS_HAS_PTHREAD_GETCPUCLOCKID)
+	puthread_hdl	hdl;
+	clockid_t	clk;
+	struct timespec	ts;
+
+	if (P_UNLIKELY (thread == NULL))
+		return -1;
+
+	if (P_UNLIKELY (pp_uthread_get_affinity_hdl (thread, &hdl) == FALSE)) {
+		P_ERROR ("PUThread::p_uthread_get_cpu_time: foreign thread is not the caller one");
+		return -1;
+	}
+
+	if (P_UNLIKELY (pthread_getcpuclockid (hdl, &clk) != 0)) {
+		P_ERROR ("PUThread::p_uthread_get_cpu_time: pthread_getcpuclockid() failed");
+		return -1;
+	}
+
+	if (P_UNLIKELY (clock_gettime (clk, &ts) != 0)) {
+		P_ERROR ("PUThread::p_uthread_get_cpu_time: clock_gettime() failed");
+		return -1;
+	}
+
+	return (pint64) ts.tv_sec * 1000000000 + (pint64) ts.tv_nsec;
+#elif defined (P_OS_MAC)
+	puthread_hdl			hdl;
+	thread_basic_info_data_t	info;
+	mach_msg_type_number_t		count = THREAD_BASIC_INFO_COUNT;
+
+	if (P_UNLIKELY (thread == NULL))
+		return -1;
+
+	if (P_UNLIKELY (pp_uthread_get_affinity_hdl (thread, &hdl) == FALSE)) {
+		P_ERROR ("PUThread::p_uthread_get_cpu_time: foreign thread is not the caller one");
+		return -1;
+	}
+
+	if (P_UNLIKELY (thread_info (pthread_mach_thread_np (hdl),
+				     THREAD_BASIC_INFO,
+				     (thread_info_t) &info,
+				     &count) != KERN_SUCCESS)) {
+		P_ERROR ("PUThread::p_uthread_get_cpu_time: thread_info() failed");
+		return -1;
+	}
+
+	return ((pint64) info.user_time.seconds + (pint64) info.system_time.seconds) * 1000000000 +
+	       ((pint64) info.user_time.microseconds + (pint64) info.system_time.microseconds) * 1000;
+#else
+	P_UNUSED (thread);
+
+	return -1;
+#endif
+}
+
 P_LIB_API P_HANDLE
 p_uthread_current_id (void)
 {
@@ -36,6 +36,26 @@
 
 P_BEGIN_DECLS
 
+/* Compiler thread-local storage class, if any */
+#if defined (P_CC_MSVC)
+#  define P_UTHREAD_THREAD_LOCAL	__declspec(thread)
+#elif defined (PLIBSYS_HAS_THREAD_KEYWORD)
+#  define P_UTHREAD_THREAD_LOCAL	__thread
+#elif defined (PLIBSYS_HAS_THREAD_LOCAL_KEYWORD)
+#  define P_UTHREAD_THREAD_LOCAL	_Thread_local
+#endif
+
+/** Thread creation attributes */
+struct PUThreadAttr_ {
+	PUThreadPriority	prio;		/**< Thread priority.			*/
+	psize			stack_size;	/**< Stack size, 0 for default.		*/
+	ppointer		stack;		/**< Caller-provided stack.		*/
+	psize			stack_mem_size;	/**< Size of the caller-provided stack.	*/
+	psize			guard_size;	/**< Guard size.			*/
+	pboolean		has_guard_size;	/**< Whether the guard size is set.	*/
+	pboolean		prefault;	/**< Whether to pre-fault the stack.	*/
+};
+
 /** Base thread structure */
 typedef struct PUThreadBase_ {
 	pint			ref_count;	/**< Reference counter.	*/
@@ -46,6 +66,7 @@ typedef struct PUThreadBase_ {
 	ppointer		data;		/**< Thread input data.	*/
 	PUThreadPriority	prio;		/**< Thread priority.	*/
 	pchar			*name;		/**< Thread name	*/
+	psize			prefault_size;	/**< Stack to pre-fault	*/
 } PUThreadBase;
 
 P_END_DECLS
@@ -164,9 +164,11 @@ PUThread *
 p_uthread_create_internal (PUThreadFunc		func,
 			   pboolean		joinable,
 			   PUThreadPriority	prio,
-			   psize		stack_size)
+			   psize		stack_size,
+			   const PUThreadAttr	*thread_attr)
 {
 	PUThread	*ret;
+	ppointer	stack_base;
 	pint32		flags;
 	psize		min_stack;
 
@@ -175,7 +177,9 @@ p_uthread_create_internal (PUThreadFunc		func,
 		return NULL;
 	}
 
-	if (stack_size > 0) {
+	stack_base = thread_attr != NULL ? thread_attr->stack : NULL;
+
+	if (stack_size > 0 && stack_base == NULL) {
 #ifdef P_OS_UNIXWARE
 		min_stack = thr_minstack ();	
 #else
@@ -189,7 +193,7 @@ p_uthread_create_internal (PUThreadFunc		func,
 	flags = THR_SUSPENDED;
 	flags |= joinable ? 0 : THR_DETACHED;
 
-	if (P_UNLIKELY (thr_create (NULL, stack_size, func, ret, flags, &ret->hdl) != 0)) {
+	if (P_UNLIKELY (thr_create (stack_base, stack_size, func, ret, flags, &ret->hdl) != 0)) {
 		P_ERROR ("PUThread::p_uthread_create_internal: thr_create() failed");
 		p_free (ret);
 		return NULL;
@@ -258,6 +262,40 @@ p_uthread_set_priority (PUThread		*thread,
 	return TRUE;
 }
 
+P_LIB_API pboolean
+p_uthread_set_affinity (PUThread		*thread,
+			const PUThreadCpuSet	*cpu_set)
+{
+	P_UNUSED (thread);
+	P_UNUSED (cpu_set);
+
+	return FALSE;
+}
+
+P_LIB_API pboolean
+p_uthread_get_affinity (PUThread	*thread,
+			PUThreadCpuSet	*cpu_set)
+{
+	P_UNUSED (thread);
+	P_UNUSED (cpu_set);
+
+	return FALSE;
+}
+
+P_LIB_API pint
+p_uthread_current_cpu (void)
+{
+	return -1;
+}
+
+P_LIB_API pint64
+p_uthread_get_cpu_time (PUThread *thread)
+{
+	P_UNUSED (thread);
+
+	return -1;
+}
+
 P_LIB_API P_HANDLE
 p_uthread_current_id (void)
 {
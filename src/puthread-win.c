@@ -36,6 +36,7 @@
 #include "process.h"
 
 typedef HRESULT (WINAPI * PWin32SetThreadDescription) (HANDLE hThread, PCWSTR lpThreadDescription);
+typedef DWORD (WINAPI * PWin32GetCurrentProcessorNumber) (void);
 typedef HANDLE puthread_hdl;
 
 struct PUThread_ {
@@ -91,10 +92,12 @@ pp_uthread_set_thread_name_veh (PEXCEPTION_POINTERS except_info)
 /* Rest of definitions */
 
 static PWin32SetThreadDescription     pp_uthread_set_descr_func  = NULL;
+static PWin32GetCurrentProcessorNumber pp_uthread_cur_cpu_func  = NULL;
 static PUThreadDestructor * volatile  pp_uthread_tls_destructors = NULL;
 static PMutex                        *pp_uthread_tls_mutex       = NULL;
 
 static DWORD pp_uthread_get_tls_key (PUThreadKey *key);
+static HANDLE pp_uthread_get_affinity_hdl (PUThread *thread);
 static puint __stdcall pp_uthread_win32_proxy (ppointer data);
 
 static DWORD
@@ -200,6 +203,19 @@ p_uthread_win32_thread_detach (void)
 	} while (was_called);
 }
 
+static HANDLE
+pp_uthread_get_affinity_hdl (PUThread *thread)
+{
+	if (thread->base.ours == TRUE)
+		return thread->hdl;
+
+	/* Foreign threads have no handle, only the caller one can be used */
+	if (thread != p_uthread_current ())
+		return NULL;
+
+	return GetCurrentThread ();
+}
+
 void
 p_uthread_init_internal (void)
 {
@@ -216,6 +232,7 @@ p_uthread_init_internal (void)
 	}
 
 	pp_uthread_set_descr_func = (PWin32SetThreadDescription) GetProcAddress (hmodule, "SetThreadDescription");
+	pp_uthread_cur_cpu_func   = (PWin32GetCurrentProcessorNumber) GetProcAddress (hmodule, "GetCurrentProcessorNumber");
 
 #ifndef P_CC_MSVC
 	pp_uthread_name_veh_handle = AddVectoredExceptionHandler (1, &pp_uthread_set_thread_name_veh);
@@ -261,10 +278,16 @@ PUThread *
 p_uthread_create_internal (PUThreadFunc		func,
 			   pboolean		joinable,
 			   PUThreadPriority	prio,
-			   psize		stack_size)
+			   psize		stack_size,
+			   const PUThreadAttr	*thread_attr)
 {
 	PUThread *ret;
 
+	if (P_UNLIKELY (thread_attr != NULL && thread_attr->stack != NULL)) {
+		P_ERROR ("PUThread::p_uthread_create_internal: caller-provided stacks are not supported");
+		return NULL;
+	}
+
 	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PUThread))) == NULL)) {
 		P_ERROR ("PUThread::p_uthread_create_internal: failed to allocate memory");
 		return NULL;
@@ -425,6 +448,124 @@ p_uthread_set_priority (PUThread		*thread,
 	return TRUE;
 }
 
+P_LIB_API pboolean
+p_uthread_set_affinity (PUThread		*thread,
+			const PUThreadCpuSet	*cpu_set)
+{
+	HANDLE		hdl;
+	DWORD_PTR	mask = 0;
+	pint		cpu;
+
+	if (P_UNLIKELY (thread == NULL || cpu_set == NULL))
+		return FALSE;
+
+	if (P_UNLIKELY ((hdl = pp_uthread_get_affinity_hdl (thread)) == NULL)) {
+		P_ERROR ("PUThread::p_uthread_set_affinity: foreign thread is not the caller one");
+		return FALSE;
+	}
+
+	/* Only the CPUs of the current processor group fit into the mask */
+	for (cpu = 0; cpu < (pint) (sizeof (DWORD_PTR) * 8); ++cpu) {
+		if (p_uthread_cpu_set_contains (cpu_set, cpu) == TRUE)
+			mask |= ((DWORD_PTR) 1) << cpu;
+	}
+
+	if (P_UNLIKELY (mask == 0))
+		return FALSE;
+
+	if (P_UNLIKELY (SetThreadAffinityMask (hdl, mask) == 0)) {
+		P_ERROR ("PUThread::p_uthread_set_affinity: SetThreadAffinityMask() failed");
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_uthread_get_affinity (PUThread	*thread,
+			PUThreadCpuSet	*cpu_set)
+{
+	HANDLE		hdl;
+	DWORD_PTR	proc_mask;
+	DWORD_PTR	sys_mask;
+	DWORD_PTR	mask;
+	pint		cpu;
+
+	if (P_UNLIKELY (thread == NULL || cpu_set == NULL))
+		return FALSE;
+
+	if (P_UNLIKELY ((hdl = pp_uthread_get_affinity_hdl (thread)) == NULL)) {
+		P_ERROR ("PUThread::p_uthread_get_affinity: foreign thread is not the caller one");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (GetProcessAffinityMask (GetCurrentProcess (), &proc_mask, &sys_mask) == 0)) {
+		P_ERROR ("PUThread::p_uthread_get_affinity: GetProcessAffinityMask() failed");
+		return FALSE;
+	}
+
+	/* There is no getter, the setter returns the previous mask which we restore */
+	if (P_UNLIKELY ((mask = SetThreadAffinityMask (hdl, proc_mask)) == 0)) {
+		P_ERROR ("PUThread::p_uthread_get_affinity: SetThreadAffinityMask() failed");
+		return FALSE;
+	}
+
+	if (mask != proc_mask)
+		SetThreadAffinityMask (hdl, mask);
+
+	p_uthread_cpu_set_clear (cpu_set);
+
+	for (cpu = 0; cpu < (pint) (sizeof (DWORD_PTR) * 8); ++cpu) {
+		if ((mask & (((DWORD_PTR) 1) << cpu)) != 0)
+			p_uthread_cpu_set_add (cpu_set, cpu);
+	}
+
+	return TRUE;
+}
+
+P_LIB_API pint
+p_uthread_current_cpu (void)
+{
+	if (P_UNLIKELY (pp_uthread_cur_cpu_func == NULL))
+		return -1;
+
+	return (pint) pp_uthread_cur_cpu_func ();
+}
+
+P_LIB_API pint64
+p_uthread_get_cpu_time (PUThread *thread)
+{
+	HANDLE		hdl;
+	FILETIME	creation_time;
+	FILETIME	exit_time;
+	FILETIME	kernel_time;
+	FILETIME	user_time;
+	puint64		ticks;
+
+	if (P_UNLIKELY (thread == NULL))
+		return -1;
+
+	if (P_UNLIKELY ((hdl = pp_uthread_get_affinity_hdl (thread)) == NULL)) {
+		P_ERROR ("PUThread::p_uthread_get_cpu_time: foreign thread is not the caller one");
+		return -1;
+	}
+
+	if (P_UNLIKELY (GetThreadTimes (hdl,
+					&creation_time,
+					&exit_time,
+					&kernel_time,
+					&user_time) == 0)) {
+		P_ERROR ("PUThread::p_uthread_get_cpu_time: GetThreadTimes() failed");
+		return -1;
+	}
+
+	/* Both times are in 100-nanosecond intervals */
+	ticks = (((puint64) kernel_time.dwHighDateTime << 32) | kernel_time.dwLowDateTime) +
+		(((puint64) user_time.dwHighDateTime << 32) | user_time.dwLowDateTime);
+
+	return (pint64) (ticks * 100);
+}
+
 P_LIB_API P_HANDLE
 p_uthread_current_id (void)
 {
@@ -103,13 +103,39 @@ extern void p_uthread_exit_internal (void);
 extern void p_uthread_wait_internal (PUThread *thread);
 extern void p_uthread_free_internal (PUThread *thread);
 extern void p_uthread_set_name_internal (PUThread *thread);
-extern PUThread * p_uthread_create_internal (PUThreadFunc	func,
-					     pboolean		joinable,
-					     PUThreadPriority	prio,
-					     psize		stack_size);
+extern PUThread * p_uthread_create_internal (PUThreadFunc		func,
+					     pboolean			joinable,
+					     PUThreadPriority		prio,
+					     psize			stack_size,
+					     const PUThreadAttr		*attr);
+
+#define P_UTHREAD_STATIC_KEYS_MAX	64
+
+/* Part of a system stack left untouched by the pre-faulting: the frames above
+ * the proxy, the thread control block and TLS some systems put there */
+#define P_UTHREAD_PREFAULT_MARGIN	(64 * 1024)
+
+struct PUThreadStaticKey_ {
+	pint		slot;
+	pint		gen;
+	PUThreadKey	*key;
+	PDestroyFunc	free_func;
+};
+
+typedef struct PUThreadStaticValue_ {
+	ppointer	value;
+	pint		gen;
+	PDestroyFunc	free_func;
+} PUThreadStaticValue;
 
 static void pp_uthread_cleanup (ppointer data);
+static void pp_uthread_prefault_stack (psize stack_size);
 static ppointer pp_uthread_proxy (ppointer data);
+#ifdef P_UTHREAD_THREAD_LOCAL
+static pint pp_uthread_static_alloc_slot (pint *gen);
+static void pp_uthread_static_destroy_stale (PUThreadStaticValue *entry);
+static void pp_uthread_static_cleanup (ppointer data);
+#endif
 
 #ifndef P_OS_WIN
 #  if !defined (PLIBSYS_HAS_CLOCKNANOSLEEP) && !defined (PLIBSYS_HAS_NANOSLEEP)
@@ -120,12 +146,113 @@ static pint pp_uthread_nanosleep (puint32 msec);
 static PUThreadKey * pp_uthread_specific_data = NULL;
 static PSpinLock * pp_uthread_new_spin = NULL;
 
+#ifdef P_UTHREAD_THREAD_LOCAL
+/* Compiler TLS caches the current thread, the key is kept for its destructor */
+static P_UTHREAD_THREAD_LOCAL PUThreadBase *	pp_uthread_current_cache = NULL;
+
+/* Static keys own slots in a compiler TLS array. A slot state is odd while a
+ * key owns it and grows on every change, a value belongs to a key only if it
+ * was set with the same state. A value left by a freed key is destroyed with
+ * its own notification function when the slot is reused or the thread exits.
+ * A marker key is set once per thread to run the notifications on exit. */
+static P_UTHREAD_THREAD_LOCAL PUThreadStaticValue	pp_uthread_static_values[P_UTHREAD_STATIC_KEYS_MAX];
+static P_UTHREAD_THREAD_LOCAL pboolean		pp_uthread_static_registered = FALSE;
+static volatile pint				pp_uthread_static_states[P_UTHREAD_STATIC_KEYS_MAX];
+static PUThreadKey *				pp_uthread_static_data = NULL;
+
+static pint
+pp_uthread_static_alloc_slot (pint *gen)
+{
+	pint state;
+	pint i;
+
+	for (i = 0; i < P_UTHREAD_STATIC_KEYS_MAX; ++i) {
+		state = p_atomic_int_get (&pp_uthread_static_states[i]);
+
+		if ((state & 1) == 0 &&
+		    p_atomic_int_compare_and_exchange (&pp_uthread_static_states[i], state, state + 1)) {
+			*gen = state + 1;
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+static void
+pp_uthread_static_destroy_stale (PUThreadStaticValue *entry)
+{
+	ppointer value = entry->value;
+
+	entry->value = NULL;
+
+	if (value != NULL && entry->free_func != NULL)
+		entry->free_func (value);
+}
+
+static void
+pp_uthread_static_cleanup (ppointer data)
+{
+	pboolean	was_called;
+	pint		i;
+
+	P_UNUSED (data);
+
+	pp_uthread_static_registered = FALSE;
+
+	do {
+		was_called = FALSE;
+
+		for (i = 0; i < P_UTHREAD_STATIC_KEYS_MAX; ++i) {
+			if (pp_uthread_static_values[i].value == NULL)
+				continue;
+
+			if (pp_uthread_static_values[i].free_func != NULL)
+				was_called = TRUE;
+
+			pp_uthread_static_destroy_stale (&pp_uthread_static_values[i]);
+		}
+	} while (was_called);
+}
+#endif
+
 static void
 pp_uthread_cleanup (ppointer data)
 {
+#ifdef P_UTHREAD_THREAD_LOCAL
+	pp_uthread_current_cache = NULL;
+#endif
+
 	p_uthread_unref (data);
 }
 
+/* The stack grows down from the caller frame, so the pages below it are
+ * either unused yet or beyond the stack end: the margin keeps off the end */
+static void
+pp_uthread_prefault_stack (psize stack_size)
+{
+#ifndef P_CPU_HPPA
+	volatile pchar	marker = 0;
+	pchar		*high;
+	psize		margin;
+
+	margin = stack_size / 8;
+
+	if (margin < P_UTHREAD_PREFAULT_MARGIN)
+		margin = P_UTHREAD_PREFAULT_MARGIN;
+
+	if (stack_size <= margin * 2)
+		return;
+
+	/* The current frame is resident anyway */
+	high = (pchar *) &marker - 4096;
+
+	p_mem_prefault (high - (stack_size - margin * 2), stack_size - margin * 2, NULL);
+#else
+	P_UNUSED (stack_size);
+#endif
+}
+
 static ppointer
 pp_uthread_proxy (ppointer data)
 {
@@ -133,9 +260,16 @@ pp_uthread_proxy (ppointer data)
 
 	p_uthread_set_local (pp_uthread_specific_data, data);
 
+#ifdef P_UTHREAD_THREAD_LOCAL
+	pp_uthread_current_cache = base_thread;
+#endif
+
 	p_spinlock_lock (pp_uthread_new_spin);
 	p_spinlock_unlock (pp_uthread_new_spin);
 
+	if (base_thread->prefault_size > 0)
+		pp_uthread_prefault_stack (base_thread->prefault_size);
+
 	if (base_thread->name != NULL)
 		p_uthread_set_name_internal ((PUThread *) base_thread);
 
@@ -150,6 +284,11 @@ p_uthread_init (void)
 	if (P_LIKELY (pp_uthread_specific_data == NULL))
 		pp_uthread_specific_data = p_uthread_local_new ((PDestroyFunc) pp_uthread_cleanup);
 
+#ifdef P_UTHREAD_THREAD_LOCAL
+	if (P_LIKELY (pp_uthread_static_data == NULL))
+		pp_uthread_static_data = p_uthread_local_new ((PDestroyFunc) pp_uthread_static_cleanup);
+#endif
+
 	if (P_LIKELY (pp_uthread_new_spin == NULL))
 		pp_uthread_new_spin = p_spinlock_new ();
 
@@ -173,6 +312,17 @@ p_uthread_shutdown (void)
 		pp_uthread_specific_data = NULL;
 	}
 
+#ifdef P_UTHREAD_THREAD_LOCAL
+	pp_uthread_current_cache = NULL;
+
+	if (P_LIKELY (pp_uthread_static_data != NULL)) {
+		p_uthread_local_free (pp_uthread_static_data);
+		pp_uthread_static_data = NULL;
+	}
+
+	pp_uthread_static_registered = FALSE;
+#endif
+
 	if (P_LIKELY (pp_uthread_new_spin != NULL)) {
 		p_spinlock_free (pp_uthread_new_spin);
 		pp_uthread_new_spin = NULL;
@@ -189,17 +339,48 @@ p_uthread_create_full (PUThreadFunc	func,
 		       psize		stack_size,
 		       const pchar	*name)
 {
-	PUThreadBase *base_thread;
+	PUThreadAttr attr;
+
+	memset (&attr, 0, sizeof (PUThreadAttr));
+
+	attr.prio       = prio;
+	attr.stack_size = stack_size;
+
+	return p_uthread_create_with_attr (func, data, joinable, &attr, name);
+}
+
+P_LIB_API PUThread *
+p_uthread_create_with_attr (PUThreadFunc	func,
+			    ppointer		data,
+			    pboolean		joinable,
+			    const PUThreadAttr	*attr,
+			    const pchar		*name)
+{
+	PUThreadBase	*base_thread;
+	PUThreadAttr	default_attr;
+	psize		stack_size;
 
 	if (P_UNLIKELY (func == NULL))
 		return NULL;
 
+	if (attr == NULL) {
+		memset (&default_attr, 0, sizeof (PUThreadAttr));
+		attr = &default_attr;
+	}
+
+	stack_size = attr->stack != NULL ? attr->stack_mem_size : attr->stack_size;
+
+	/* Nobody else uses the caller stack yet, it can be touched right here */
+	if (attr->prefault == TRUE && attr->stack != NULL)
+		p_mem_prefault (attr->stack, attr->stack_mem_size, NULL);
+
 	p_spinlock_lock (pp_uthread_new_spin);
 
 	base_thread = (PUThreadBase *) p_uthread_create_internal (pp_uthread_proxy,
 								  joinable,
-								  prio,
-								  stack_size);
+								  attr->prio,
+								  stack_size,
+								  attr);
 
 	if (P_LIKELY (base_thread != NULL)) {
 		base_thread->ref_count = 2;
@@ -208,6 +389,9 @@ p_uthread_create_full (PUThreadFunc	func,
 		base_thread->func      = func;
 		base_thread->data      = data;
 		base_thread->name      = p_strdup (name);
+
+		if (attr->prefault == TRUE && attr->stack == NULL)
+			base_thread->prefault_size = attr->stack_size;
 	}
 
 	p_spinlock_unlock (pp_uthread_new_spin);
@@ -264,7 +448,14 @@ p_uthread_join (PUThread *thread)
 P_LIB_API PUThread *
 p_uthread_current (void)
 {
-	PUThreadBase *base_thread = p_uthread_get_local (pp_uthread_specific_data);
+	PUThreadBase *base_thread;
+
+#ifdef P_UTHREAD_THREAD_LOCAL
+	if (P_LIKELY (pp_uthread_current_cache != NULL))
+		return (PUThread *) pp_uthread_current_cache;
+#endif
+
+	base_thread = p_uthread_get_local (pp_uthread_specific_data);
 
 	if (P_UNLIKELY (base_thread == NULL)) {
 		if (P_UNLIKELY ((base_thread = p_malloc0 (sizeof (PUThreadBase))) == NULL)) {
@@ -277,6 +468,10 @@ p_uthread_current (void)
 		p_uthread_set_local (pp_uthread_specific_data, base_thread);
 	}
 
+#ifdef P_UTHREAD_THREAD_LOCAL
+	pp_uthread_current_cache = base_thread;
+#endif
+
 	return (PUThread *) base_thread;
 }
 
@@ -556,3 +751,269 @@ p_uthread_sleep (puint32 msec)
 	return pp_uthread_nanosleep (msec);
 #endif
 }
+
+P_LIB_API void
+p_uthread_cpu_set_clear (PUThreadCpuSet *cpu_set)
+{
+	if (P_UNLIKELY (cpu_set == NULL))
+		return;
+
+	memset (cpu_set, 0, sizeof (PUThreadCpuSet));
+}
+
+P_LIB_API pboolean
+p_uthread_cpu_set_add (PUThreadCpuSet	*cpu_set,
+		       pint		cpu)
+{
+	if (P_UNLIKELY (cpu_set == NULL || cpu < 0 || cpu >= P_UTHREAD_CPU_SET_SIZE))
+		return FALSE;
+
+	cpu_set->bits[cpu / 32] |= ((puint32) 1) << (cpu % 32);
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_uthread_cpu_set_remove (PUThreadCpuSet	*cpu_set,
+			  pint			cpu)
+{
+	if (P_UNLIKELY (cpu_set == NULL || cpu < 0 || cpu >= P_UTHREAD_CPU_SET_SIZE))
+		return FALSE;
+
+	cpu_set->bits[cpu / 32] &= ~(((puint32) 1) << (cpu % 32));
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_uthread_cpu_set_contains (const PUThreadCpuSet	*cpu_set,
+			    pint			cpu)
+{
+	if (P_UNLIKELY (cpu_set == NULL || cpu < 0 || cpu >= P_UTHREAD_CPU_SET_SIZE))
+		return FALSE;
+
+	return (cpu_set->bits[cpu / 32] & (((puint32) 1) << (cpu % 32))) != 0;
+}
+
+P_LIB_API pint
+p_uthread_cpu_set_count (const PUThreadCpuSet *cpu_set)
+{
+	puint32	bits;
+	pint	ret = 0;
+	pint	i;
+
+	if (P_UNLIKELY (cpu_set == NULL))
+		return 0;
+
+	for (i = 0; i < P_UTHREAD_CPU_SET_SIZE / 32; ++i) {
+		/* Clears the lowest set bit on every step */
+		for (bits = cpu_set->bits[i]; bits != 0; bits &= bits - 1)
+			++ret;
+	}
+
+	return ret;
+}
+
+P_LIB_API PUThreadStaticKey *
+p_uthread_static_local_new (PDestroyFunc free_func)
+{
+	PUThreadStaticKey *ret;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PUThreadStaticKey))) == NULL)) {
+		P_ERROR ("PUThread::p_uthread_static_local_new: failed to allocate memory");
+		return NULL;
+	}
+
+	ret->free_func = free_func;
+	ret->slot      = -1;
+
+#ifdef P_UTHREAD_THREAD_LOCAL
+	if (P_LIKELY ((ret->slot = pp_uthread_static_alloc_slot (&ret->gen)) >= 0))
+		return ret;
+#endif
+
+	/* No compiler TLS or no free slots left */
+	if (P_UNLIKELY ((ret->key = p_uthread_local_new (free_func)) == NULL)) {
+		P_ERROR ("PUThread::p_uthread_static_local_new: failed to allocate TLS key");
+		p_free (ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+P_LIB_API void
+p_uthread_static_local_free (PUThreadStaticKey *key)
+{
+	if (P_UNLIKELY (key == NULL))
+		return;
+
+#ifdef P_UTHREAD_THREAD_LOCAL
+	if (key->slot >= 0)
+		p_atomic_int_inc (&pp_uthread_static_states[key->slot]);
+#endif
+
+	if (key->key != NULL)
+		p_uthread_local_free (key->key);
+
+	p_free (key);
+}
+
+P_LIB_API ppointer
+p_uthread_get_static_local (const PUThreadStaticKey *key)
+{
+	if (P_UNLIKELY (key == NULL))
+		return NULL;
+
+#ifdef P_UTHREAD_THREAD_LOCAL
+	if (P_LIKELY (key->slot >= 0)) {
+		const PUThreadStaticValue *entry = &pp_uthread_static_values[key->slot];
+
+		return P_LIKELY (entry->gen == key->gen) ? entry->value : NULL;
+	}
+#endif
+
+	return p_uthread_get_local (key->key);
+}
+
+P_LIB_API void
+p_uthread_set_static_local (PUThreadStaticKey	*key,
+			    ppointer		value)
+{
+	if (P_UNLIKELY (key == NULL))
+		return;
+
+#ifdef P_UTHREAD_THREAD_LOCAL
+	if (P_LIKELY (key->slot >= 0)) {
+		PUThreadStaticValue *entry = &pp_uthread_static_values[key->slot];
+
+		if (P_UNLIKELY (entry->gen != key->gen)) {
+			pp_uthread_static_destroy_stale (entry);
+
+			entry->gen       = key->gen;
+			entry->free_func = key->free_func;
+		}
+
+		entry->value = value;
+
+		if (P_UNLIKELY (pp_uthread_static_registered == FALSE && value != NULL)) {
+			p_uthread_set_local (pp_uthread_static_data, (ppointer) pp_uthread_static_values);
+			pp_uthread_static_registered = TRUE;
+		}
+
+		return;
+	}
+#endif
+
+	p_uthread_set_local (key->key, value);
+}
+
+P_LIB_API void
+p_uthread_replace_static_local (PUThreadStaticKey	*key,
+				ppointer		value)
+{
+	if (P_UNLIKELY (key == NULL))
+		return;
+
+#ifdef P_UTHREAD_THREAD_LOCAL
+	if (P_LIKELY (key->slot >= 0)) {
+		ppointer old_value = p_uthread_get_static_local (key);
+
+		if (old_value != NULL && key->free_func != NULL)
+			key->free_func (old_value);
+
+		p_uthread_set_static_local (key, value);
+
+		return;
+	}
+#endif
+
+	p_uthread_replace_local (key->key, value);
+}
+
+P_LIB_API PUThreadAttr *
+p_uthread_attr_new (void)
+{
+	PUThreadAttr *ret;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PUThreadAttr))) == NULL)) {
+		P_ERROR ("PUThread::p_uthread_attr_new: failed to allocate memory");
+		return NULL;
+	}
+
+	ret->prio = P_UTHREAD_PRIORITY_INHERIT;
+
+	return ret;
+}
+
+P_LIB_API pboolean
+p_uthread_attr_set_priority (PUThreadAttr	*attr,
+			     PUThreadPriority	prio)
+{
+	if (P_UNLIKELY (attr == NULL))
+		return FALSE;
+
+	if (P_UNLIKELY (prio < P_UTHREAD_PRIORITY_INHERIT || prio > P_UTHREAD_PRIORITY_TIMECRITICAL))
+		return FALSE;
+
+	attr->prio = prio;
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_uthread_attr_set_stack_size (PUThreadAttr	*attr,
+			       psize		stack_size)
+{
+	if (P_UNLIKELY (attr == NULL))
+		return FALSE;
+
+	attr->stack_size = stack_size;
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_uthread_attr_set_stack (PUThreadAttr	*attr,
+			  ppointer	stack,
+			  psize		stack_size)
+{
+	if (P_UNLIKELY (attr == NULL || (stack != NULL && stack_size == 0)))
+		return FALSE;
+
+	attr->stack          = stack;
+	attr->stack_mem_size = stack != NULL ? stack_size : 0;
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_uthread_attr_set_guard_size (PUThreadAttr	*attr,
+			       psize		guard_size)
+{
+	if (P_UNLIKELY (attr == NULL))
+		return FALSE;
+
+	attr->guard_size     = guard_size;
+	attr->has_guard_size = TRUE;
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_uthread_attr_set_prefault (PUThreadAttr	*attr,
+			     pboolean		prefault)
+{
+	if (P_UNLIKELY (attr == NULL))
+		return FALSE;
+
+	attr->prefault = prefault;
+
+	return TRUE;
+}
+
+P_LIB_API void
+p_uthread_attr_free (PUThreadAttr *attr)
+{
+	p_free (attr);
+}
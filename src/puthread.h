@@ -82,9 +82,39 @@
  * p_uthread_replace_local(). The only difference is that the former one calls
  * the provided destroy notification function before replacing the old value.
  *
+ * A #PUThreadStaticKey is a TLS key for the hot paths, like per-thread caches
+ * accessed millions of times per second. Its value is kept in the compiler
+ * thread-local storage (__thread, _Thread_local or __declspec(thread)) where
+ * supported, so p_uthread_get_static_local() is a plain memory read instead of
+ * a call like pthread_getspecific() or TlsGetValue(). Up to 64 such keys can
+ * exist at a time, further keys and the systems without the compiler
+ * thread-local storage fall back to #PUThreadKey transparently.
+ *
  * Thread names are used on most of operating systems for debugging purposes,
  * thereby some limitations for long name can be applied and too long names
  * will be truncated automatically.
+ *
+ * A thread can be pinned to a set of CPUs with p_uthread_set_affinity(), i.e.
+ * to keep network threads near the NIC and other threads off those CPUs. The
+ * set is described by #PUThreadCpuSet, a bit mask filled with the
+ * p_uthread_cpu_set_*() calls. Affinity is supported on Linux and other
+ * systems with pthread_setaffinity_np(), FreeBSD and DragonFly BSD, and on
+ * Windows (the CPUs of the current processor group only). Elsewhere the calls
+ * fail, and p_uthread_current_cpu() returns -1.
+ *
+ * CPU time consumed by a thread can be obtained with p_uthread_get_cpu_time(),
+ * i.e. to find the threads which are saturated and rebalance work among them.
+ *
+ * Stacks of many threads can be tuned with a #PUThreadAttr passed to
+ * p_uthread_create_with_attr(). A small stack size keeps the memory footprint
+ * of hundreds of threads predictable, a guard size other than the system
+ * default catches stack overflows earlier or saves the address space. A
+ * caller-provided stack can be pre-allocated, reused for the next thread
+ * after a join, or mapped with huge pages using p_mem_mmap_full(). With the
+ * pre-faulting the stack pages are made resident before the thread function
+ * runs, so it doesn't take page faults later. Caller-provided stacks are
+ * supported with POSIX and Solaris threads only, and the guard size with POSIX
+ * threads only.
  */
 
 #if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
@@ -108,6 +138,21 @@ typedef struct PUThread_ PUThread;
 /** TLS key opaque data type. */
 typedef struct PUThreadKey_ PUThreadKey;
 
+/** Static TLS key opaque data type. */
+typedef struct PUThreadStaticKey_ PUThreadStaticKey;
+
+/** Thread creation attributes opaque data type. */
+typedef struct PUThreadAttr_ PUThreadAttr;
+
+/** Max number of CPUs a #PUThreadCpuSet can describe. */
+#define P_UTHREAD_CPU_SET_SIZE	1024
+
+/** Set of CPUs for thread affinity, use the p_uthread_cpu_set_*() calls to
+ * access it. */
+typedef struct PUThreadCpuSet_ {
+	puint32	bits[P_UTHREAD_CPU_SET_SIZE / 32];	/**< CPU bit mask.	*/
+} PUThreadCpuSet;
+
 /** Thread priority. */
 typedef enum PUThreadPriority_ {
 	P_UTHREAD_PRIORITY_INHERIT	= 0,	/**< Inherits the caller thread priority. Default priority.	*/
@@ -141,6 +186,120 @@ P_LIB_API PUThread *	p_uthread_create_full	(PUThreadFunc		func,
 						 psize			stack_size,
 						 const pchar		*name);
 
+/**
+ * @brief Creates a new #PUThread with the given attributes and starts it.
+ * @param func Main thread function to run.
+ * @param data Pointer to pass into the thread main function, may be NULL.
+ * @param joinable Whether to create a joinable thread or not.
+ * @param attr Thread attributes, NULL to use the defaults.
+ * @param name Thread name, maybe NULL.
+ * @return Pointer to #PUThread in case of success, NULL otherwise.
+ * @since 0.0.5
+ * @note Unreference the returned value after use with p_uthread_unref(). You do
+ * not need to call p_uthread_ref() explicitly on the returned value.
+ *
+ * The attributes are copied, @a attr can be changed or freed right after the
+ * call. The call fails if the system doesn't support a caller-provided stack
+ * set in @a attr.
+ */
+P_LIB_API PUThread *	p_uthread_create_with_attr	(PUThreadFunc		func,
+							 ppointer		data,
+							 pboolean		joinable,
+							 const PUThreadAttr	*attr,
+							 const pchar		*name);
+
+/**
+ * @brief Creates new thread attributes with the default values.
+ * @return Pointer to #PUThreadAttr in case of success, NULL otherwise.
+ * @since 0.0.5
+ *
+ * The defaults are the inherited priority, the system default stack and the
+ * system default guard size, without pre-faulting.
+ */
+P_LIB_API PUThreadAttr *	p_uthread_attr_new		(void);
+
+/**
+ * @brief Sets a thread priority in the attributes.
+ * @param attr #PUThreadAttr to set the priority in.
+ * @param prio Thread priority.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean		p_uthread_attr_set_priority	(PUThreadAttr		*attr,
+								 PUThreadPriority	prio);
+
+/**
+ * @brief Sets a thread stack size in the attributes.
+ * @param attr #PUThreadAttr to set the stack size in.
+ * @param stack_size Thread stack size, in bytes. Leave zero to use a default
+ * value.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The size is ignored if a caller-provided stack is set with
+ * p_uthread_attr_set_stack().
+ */
+P_LIB_API pboolean		p_uthread_attr_set_stack_size	(PUThreadAttr		*attr,
+								 psize			stack_size);
+
+/**
+ * @brief Sets a caller-provided thread stack in the attributes.
+ * @param attr #PUThreadAttr to set the stack in.
+ * @param stack Stack memory, NULL to let the system allocate the stack.
+ * @param stack_size Size of @a stack, in bytes.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The memory must stay valid until the thread is joined, it can't be used for
+ * a non-joinable thread unless the caller knows otherwise when the thread has
+ * finished. Use page-aligned memory from p_mem_mmap() or p_mem_mmap_full() and
+ * a size not less than the system minimum. The system doesn't add a guard page
+ * to a caller-provided stack, protect the lowest page of the stack yourself if
+ * it is needed.
+ */
+P_LIB_API pboolean		p_uthread_attr_set_stack	(PUThreadAttr		*attr,
+								 ppointer		stack,
+								 psize			stack_size);
+
+/**
+ * @brief Sets a thread stack guard size in the attributes.
+ * @param attr #PUThreadAttr to set the guard size in.
+ * @param guard_size Size of the inaccessible area below the stack, in bytes,
+ * zero to disable the guard.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The size is rounded up to the page size by the system. It is ignored for a
+ * caller-provided stack and on the systems other than with POSIX threads.
+ */
+P_LIB_API pboolean		p_uthread_attr_set_guard_size	(PUThreadAttr		*attr,
+								 psize			guard_size);
+
+/**
+ * @brief Sets whether to pre-fault a thread stack.
+ * @param attr #PUThreadAttr to set the option in.
+ * @param prefault Whether to make the stack pages resident before the thread
+ * function runs.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * A caller-provided stack is pre-faulted before the thread is created. A
+ * system allocated stack is pre-faulted by the new thread itself, only if the
+ * stack size is set with p_uthread_attr_set_stack_size(): the default stacks
+ * are usually too large to be kept resident.
+ */
+P_LIB_API pboolean		p_uthread_attr_set_prefault	(PUThreadAttr		*attr,
+								 pboolean		prefault);
+
+/**
+ * @brief Frees thread attributes.
+ * @param attr #PUThreadAttr to free.
+ * @since 0.0.5
+ *
+ * A caller-provided stack is not freed.
+ */
+P_LIB_API void			p_uthread_attr_free		(PUThreadAttr		*attr);
+
 /**
  * @brief Creates a #PUThread and starts it. A short version of
  * p_uthread_create_full().
@@ -192,6 +351,102 @@ P_LIB_API pint		p_uthread_sleep		(puint32		msec);
 P_LIB_API pboolean	p_uthread_set_priority	(PUThread		*thread,
 						 PUThreadPriority	prio);
 
+/**
+ * @brief Pins a thread to a set of CPUs.
+ * @param thread Thread to set the affinity for.
+ * @param cpu_set CPUs the thread is allowed to run on.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ *
+ * The call fails if the set is empty, contains only unavailable CPUs or the
+ * system doesn't support thread affinity. A thread which was not created by
+ * the library (i.e. the main one) can be used only from itself, through
+ * p_uthread_current().
+ */
+P_LIB_API pboolean	p_uthread_set_affinity	(PUThread		*thread,
+						 const PUThreadCpuSet	*cpu_set);
+
+/**
+ * @brief Gets a set of CPUs a thread is allowed to run on.
+ * @param thread Thread to get the affinity for.
+ * @param[out] cpu_set CPUs the thread is allowed to run on.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_uthread_get_affinity	(PUThread		*thread,
+						 PUThreadCpuSet		*cpu_set);
+
+/**
+ * @brief Gets an index of the CPU the current (caller) thread is running on.
+ * @return Index of the CPU, -1 if not supported.
+ * @since 0.0.5
+ *
+ * Unless the thread is pinned to a single CPU the result may be outdated by
+ * the time it is returned, use it as a hint only (i.e. to pick a per-CPU
+ * shard).
+ */
+P_LIB_API pint		p_uthread_current_cpu	(void);
+
+/**
+ * @brief Gets CPU time consumed by a thread.
+ * @param thread Thread to get the CPU time for.
+ * @return CPU time (user and system) in nanoseconds, -1 in case of error or if
+ * not supported.
+ * @since 0.0.5
+ *
+ * Unlike the wall-clock time, the CPU time grows only while the thread is
+ * actually running, so comparing two samples shows how saturated the thread
+ * is. As with the affinity calls, a thread which was not created by the
+ * library can be queried only from itself, through p_uthread_current().
+ * Supported on systems with pthread_getcpuclockid(), macOS and Windows.
+ */
+P_LIB_API pint64	p_uthread_get_cpu_time	(PUThread		*thread);
+
+/**
+ * @brief Removes all the CPUs from a CPU set.
+ * @param cpu_set CPU set to clear.
+ * @since 0.0.5
+ */
+P_LIB_API void		p_uthread_cpu_set_clear	(PUThreadCpuSet		*cpu_set);
+
+/**
+ * @brief Adds a CPU to a CPU set.
+ * @param cpu_set CPU set to add the CPU to.
+ * @param cpu Index of the CPU, less than #P_UTHREAD_CPU_SET_SIZE.
+ * @return TRUE in case of success, FALSE if @a cpu is out of range.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_uthread_cpu_set_add	(PUThreadCpuSet		*cpu_set,
+						 pint			cpu);
+
+/**
+ * @brief Removes a CPU from a CPU set.
+ * @param cpu_set CPU set to remove the CPU from.
+ * @param cpu Index of the CPU, less than #P_UTHREAD_CPU_SET_SIZE.
+ * @return TRUE in case of success, FALSE if @a cpu is out of range.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_uthread_cpu_set_remove	(PUThreadCpuSet		*cpu_set,
+							 pint			cpu);
+
+/**
+ * @brief Checks whether a CPU set contains a CPU.
+ * @param cpu_set CPU set to check.
+ * @param cpu Index of the CPU.
+ * @return TRUE if @a cpu_set contains @a cpu, FALSE otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API pboolean	p_uthread_cpu_set_contains	(const PUThreadCpuSet	*cpu_set,
+							 pint			cpu);
+
+/**
+ * @brief Gets the number of CPUs in a CPU set.
+ * @param cpu_set CPU set to count the CPUs in.
+ * @return Number of CPUs in @a cpu_set.
+ * @since 0.0.5
+ */
+P_LIB_API pint		p_uthread_cpu_set_count	(const PUThreadCpuSet	*cpu_set);
+
 /**
  * @brief Tells the scheduler to skip the current (caller) thread in the current
  * planning stage.
@@ -230,6 +485,9 @@ P_LIB_API PUThread *	p_uthread_current	(void);
  * avaialble CPUs and cores (physical and logical).
  * @return Ideal number of threads, 1 in case of failed detection.
  * @since 0.0.3
+ *
+ * Use #PCpuTopology to tell physical cores from SMT siblings or to find out
+ * NUMA nodes and cache sharing.
  */
 P_LIB_API pint		p_uthread_ideal_count	(void);
 
@@ -306,6 +564,56 @@ P_LIB_API void		p_uthread_set_local	(PUThreadKey		*key,
 P_LIB_API void		p_uthread_replace_local	(PUThreadKey		*key,
 						 ppointer		value);
 
+/**
+ * @brief Creates a new static TLS key.
+ * @param free_func TLS value destroy notification call, leave NULL if not
+ * need. It is called on the thread exit.
+ * @return New static TLS key in case of success, NULL otherwise.
+ * @since 0.0.5
+ */
+P_LIB_API PUThreadStaticKey *	p_uthread_static_local_new	(PDestroyFunc			free_func);
+
+/**
+ * @brief Frees a static TLS key.
+ * @param key Static TLS key to free.
+ * @since 0.0.5
+ *
+ * Like p_uthread_local_free() it doesn't destroy the values the threads still
+ * hold, they are destroyed on the thread exit or when a new key reuses the
+ * slot.
+ */
+P_LIB_API void			p_uthread_static_local_free	(PUThreadStaticKey		*key);
+
+/**
+ * @brief Gets a static TLS value.
+ * @param key Static TLS key to get the value for.
+ * @return TLS value for the given key.
+ * @since 0.0.5
+ */
+P_LIB_API ppointer		p_uthread_get_static_local	(const PUThreadStaticKey	*key);
+
+/**
+ * @brief Sets a static TLS value.
+ * @param key Static TLS key to set the value for.
+ * @param value TLS value to set.
+ * @since 0.0.5
+ *
+ * It doesn't call the destroy notification function on the old value.
+ */
+P_LIB_API void			p_uthread_set_static_local	(PUThreadStaticKey		*key,
+								 ppointer			value);
+
+/**
+ * @brief Replaces a static TLS value.
+ * @param key Static TLS key to replace the value for.
+ * @param value TLS value to set.
+ * @since 0.0.5
+ *
+ * It calls the destroy notification function on the old value.
+ */
+P_LIB_API void			p_uthread_replace_static_local	(PUThreadStaticKey		*key,
+								 ppointer			value);
+
 P_END_DECLS
 
 #endif /* PLIBSYS_HEADER_PUTHREAD_H */
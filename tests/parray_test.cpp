@@ -0,0 +1,281 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <stdlib.h>
+
+P_TEST_MODULE_INIT ();
+
+#define PARRAY_STRESS_COUNT	10000
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static void foreach_test_func (ppointer data, ppointer user_data)
+{
+	*((pint *) user_data) += P_POINTER_TO_INT (data);
+}
+
+static pint compare_test_func (pconstpointer a, pconstpointer b)
+{
+	pint ia = P_POINTER_TO_INT (a);
+	pint ib = P_POINTER_TO_INT (b);
+
+	return ia < ib ? -1 : (ia > ib ? 1 : 0);
+}
+
+static pint compare_data_test_func (pconstpointer a, pconstpointer b, ppointer data)
+{
+	/* Descending order if requested */
+	return data == NULL ? compare_test_func (a, b) : compare_test_func (b, a);
+}
+
+P_TEST_CASE_BEGIN (parray_nomem_test)
+{
+	p_libsys_init ();
+
+	PArray *array = p_array_new ();
+	P_TEST_REQUIRE (array != NULL);
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (p_array_new () == NULL);
+	P_TEST_CHECK (p_array_new_sized (10) == NULL);
+	P_TEST_CHECK (p_array_push (array, PINT_TO_POINTER (1)) == FALSE);
+	P_TEST_CHECK (p_array_reserve (array, 10) == FALSE);
+	P_TEST_CHECK (p_array_length (array) == 0);
+
+	p_mem_restore_vtable ();
+
+	p_array_free (array);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (parray_invalid_test)
+{
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_array_push (NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_array_pop (NULL) == NULL);
+	P_TEST_CHECK (p_array_reserve (NULL, 10) == FALSE);
+	P_TEST_CHECK (p_array_index (NULL, 0) == NULL);
+	P_TEST_CHECK (p_array_length (NULL) == 0);
+	P_TEST_CHECK (p_array_data (NULL) == NULL);
+
+	p_array_remove_index (NULL, 0);
+	p_array_foreach (NULL, NULL, NULL);
+	p_array_reverse (NULL);
+	p_array_sort (NULL, NULL);
+	p_array_sort_with_data (NULL, NULL, NULL);
+	p_array_free (NULL);
+
+	PArray *array = p_array_new ();
+	P_TEST_REQUIRE (array != NULL);
+
+	P_TEST_CHECK (p_array_pop (array) == NULL);
+	P_TEST_CHECK (p_array_index (array, 0) == NULL);
+	P_TEST_CHECK (p_array_data (array) == NULL);
+	P_TEST_CHECK (p_array_reserve (array, (psize) -1) == FALSE);
+
+	p_array_remove_index (array, 0);
+	p_array_foreach (array, NULL, NULL);
+	p_array_sort (array, NULL);
+	p_array_sort_with_data (array, NULL, NULL);
+
+	p_array_free (array);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (parray_general_test)
+{
+	p_libsys_init ();
+
+	PArray *array = p_array_new ();
+	P_TEST_REQUIRE (array != NULL);
+
+	for (pint i = 0; i < PARRAY_STRESS_COUNT; ++i)
+		P_TEST_CHECK (p_array_push (array, PINT_TO_POINTER (i)) == TRUE);
+
+	P_TEST_CHECK (p_array_length (array) == PARRAY_STRESS_COUNT);
+
+	ppointer *data = p_array_data (array);
+	P_TEST_REQUIRE (data != NULL);
+
+	for (pint i = 0; i < PARRAY_STRESS_COUNT; ++i) {
+		P_TEST_CHECK (data[i] == PINT_TO_POINTER (i));
+		P_TEST_CHECK (p_array_index (array, (psize) i) == PINT_TO_POINTER (i));
+	}
+
+	P_TEST_CHECK (p_array_index (array, PARRAY_STRESS_COUNT) == NULL);
+
+	pint sum = 0;
+
+	p_array_foreach (array, foreach_test_func, &sum);
+	P_TEST_CHECK (sum == PARRAY_STRESS_COUNT * (PARRAY_STRESS_COUNT - 1) / 2);
+
+	/* Removal keeps the order */
+	p_array_remove_index (array, 0);
+	p_array_remove_index (array, 10);
+	p_array_remove_index (array, p_array_length (array) - 1);
+
+	P_TEST_CHECK (p_array_length (array) == PARRAY_STRESS_COUNT - 3);
+	P_TEST_CHECK (p_array_index (array, 0) == PINT_TO_POINTER (1));
+	P_TEST_CHECK (p_array_index (array, 9) == PINT_TO_POINTER (10));
+	P_TEST_CHECK (p_array_index (array, 10) == PINT_TO_POINTER (12));
+
+	P_TEST_CHECK (p_array_pop (array) == PINT_TO_POINTER (PARRAY_STRESS_COUNT - 2));
+	P_TEST_CHECK (p_array_length (array) == PARRAY_STRESS_COUNT - 4);
+
+	p_array_reverse (array);
+	P_TEST_CHECK (p_array_index (array, 0) == PINT_TO_POINTER (PARRAY_STRESS_COUNT - 3));
+	P_TEST_CHECK (p_array_index (array, PARRAY_STRESS_COUNT - 5) == PINT_TO_POINTER (1));
+
+	p_array_free (array);
+
+	/* Reserved array doesn't grow */
+	array = p_array_new_sized (100);
+	P_TEST_REQUIRE (array != NULL);
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	for (pint i = 0; i < 100; ++i)
+		P_TEST_CHECK (p_array_push (array, PINT_TO_POINTER (i)) == TRUE);
+
+	P_TEST_CHECK (p_array_reserve (array, 50) == TRUE);
+
+	p_mem_restore_vtable ();
+
+	P_TEST_CHECK (p_array_length (array) == 100);
+
+	p_array_free (array);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (parray_sort_test)
+{
+	p_libsys_init ();
+
+	PArray *array = p_array_new_sized (PARRAY_STRESS_COUNT);
+	P_TEST_REQUIRE (array != NULL);
+
+	srand (1);
+
+	/* Use a small range to get a lot of duplicates */
+	for (pint i = 0; i < PARRAY_STRESS_COUNT; ++i)
+		P_TEST_CHECK (p_array_push (array, PINT_TO_POINTER (rand () % 1000)) == TRUE);
+
+	p_array_sort (array, compare_test_func);
+
+	for (psize i = 1; i < PARRAY_STRESS_COUNT; ++i)
+		P_TEST_CHECK (P_POINTER_TO_INT (p_array_index (array, i - 1)) <=
+			      P_POINTER_TO_INT (p_array_index (array, i)));
+
+	p_array_sort_with_data (array, compare_data_test_func, array);
+
+	for (psize i = 1; i < PARRAY_STRESS_COUNT; ++i)
+		P_TEST_CHECK (P_POINTER_TO_INT (p_array_index (array, i - 1)) >=
+			      P_POINTER_TO_INT (p_array_index (array, i)));
+
+	p_array_free (array);
+
+	/* Already sorted, reversed and equal inputs of different sizes */
+	for (pint size = 0; size < 100; ++size) {
+		array = p_array_new ();
+		P_TEST_REQUIRE (array != NULL);
+
+		for (pint i = 0; i < size; ++i)
+			p_array_push (array, PINT_TO_POINTER (size - i));
+
+		p_array_sort (array, compare_test_func);
+
+		for (pint i = 0; i < size; ++i)
+			P_TEST_CHECK (p_array_index (array, (psize) i) == PINT_TO_POINTER (i + 1));
+
+		p_array_sort (array, compare_test_func);
+
+		for (pint i = 0; i < size; ++i)
+			P_TEST_CHECK (p_array_index (array, (psize) i) == PINT_TO_POINTER (i + 1));
+
+		p_array_free (array);
+
+		array = p_array_new ();
+		P_TEST_REQUIRE (array != NULL);
+
+		for (pint i = 0; i < size; ++i)
+			p_array_push (array, PINT_TO_POINTER (7));
+
+		p_array_sort_with_data (array, compare_data_test_func, NULL);
+		P_TEST_CHECK (p_array_length (array) == (psize) size);
+
+		p_array_free (array);
+	}
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (parray_nomem_test);
+	P_TEST_SUITE_RUN_CASE (parray_invalid_test);
+	P_TEST_SUITE_RUN_CASE (parray_general_test);
+	P_TEST_SUITE_RUN_CASE (parray_sort_test);
+}
+P_TEST_SUITE_END()
@@ -0,0 +1,166 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define P_ATOMIC_INLINE
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+P_TEST_MODULE_INIT ();
+
+#define PATOMIC_INLINE_THREADS		4
+#define PATOMIC_INLINE_ITERATIONS	100000
+
+static PSpinLock	*inline_lock    = NULL;
+static pint		inline_counter  = 0;
+static volatile pint	inline_atomic   = 0;
+
+static void * inline_thread (void *)
+{
+	for (pint i = 0; i < PATOMIC_INLINE_ITERATIONS; ++i) {
+		/* Mix the inline and the exported calls on the same objects */
+		if (i % 2 == 0) {
+			p_spinlock_lock (inline_lock);
+			++inline_counter;
+			p_spinlock_unlock (inline_lock);
+
+			p_atomic_int_inc (&inline_atomic);
+		} else {
+			(p_spinlock_lock) (inline_lock);
+			++inline_counter;
+			(p_spinlock_unlock) (inline_lock);
+
+			(p_atomic_int_add) (&inline_atomic, 1);
+		}
+	}
+
+	return NULL;
+}
+
+P_TEST_CASE_BEGIN (patomic_inline_general_test)
+{
+	pint		atomic_int     = 0;
+	ppointer	atomic_pointer = NULL;
+
+	p_libsys_init ();
+
+#ifdef P_ATOMIC_INLINE_ENABLED
+	P_TEST_CHECK (p_atomic_is_lock_free () == TRUE);
+#endif
+
+	p_atomic_int_set (&atomic_int, 10);
+
+	P_TEST_CHECK (p_atomic_int_add (&atomic_int, 5) == 10);
+	P_TEST_CHECK ((p_atomic_int_get) (&atomic_int) == 15);
+
+	(p_atomic_int_set) (&atomic_int, 1);
+	p_atomic_int_inc (&atomic_int);
+	P_TEST_CHECK (p_atomic_int_get (&atomic_int) == 2);
+
+	P_TEST_CHECK (p_atomic_int_dec_and_test (&atomic_int) == FALSE);
+	P_TEST_CHECK (p_atomic_int_dec_and_test (&atomic_int) == TRUE);
+
+	P_TEST_CHECK (p_atomic_int_compare_and_exchange (&atomic_int, 0, -10) == TRUE);
+	P_TEST_CHECK (p_atomic_int_compare_and_exchange (&atomic_int, 0, 20) == FALSE);
+	P_TEST_CHECK (p_atomic_int_get (&atomic_int) == -10);
+
+	p_atomic_int_set (&atomic_int, 4);
+	P_TEST_CHECK (p_atomic_int_xor ((puint *) &atomic_int, (puint) 1) == 4);
+	P_TEST_CHECK (p_atomic_int_or ((puint *) &atomic_int, (puint) 2) == 5);
+	P_TEST_CHECK (p_atomic_int_and ((puint *) &atomic_int, (puint) 1) == 7);
+	P_TEST_CHECK (p_atomic_int_get (&atomic_int) == 1);
+
+	p_atomic_pointer_set (&atomic_pointer, PUINT_TO_POINTER (P_MAXSIZE));
+	P_TEST_CHECK (p_atomic_pointer_get (&atomic_pointer) == PUINT_TO_POINTER (P_MAXSIZE));
+
+	p_atomic_pointer_set (&atomic_pointer, PUINT_TO_POINTER (100));
+	P_TEST_CHECK (p_atomic_pointer_add (&atomic_pointer, (pssize) 100) == 100);
+	P_TEST_CHECK ((p_atomic_pointer_get) (&atomic_pointer) == PUINT_TO_POINTER (200));
+
+	P_TEST_CHECK (p_atomic_pointer_compare_and_exchange (&atomic_pointer, PUINT_TO_POINTER (200), NULL) == TRUE);
+	P_TEST_CHECK (p_atomic_pointer_compare_and_exchange (&atomic_pointer, PUINT_TO_POINTER (200), NULL) == FALSE);
+	P_TEST_CHECK (p_atomic_pointer_get (&atomic_pointer) == NULL);
+
+	p_atomic_int_set_explicit (&atomic_int, 7, P_ATOMIC_MEMORY_ORDER_RELEASE);
+	P_TEST_CHECK (p_atomic_int_get_explicit (&atomic_int, P_ATOMIC_MEMORY_ORDER_ACQUIRE) == 7);
+	P_TEST_CHECK (p_atomic_int_add_explicit (&atomic_int, 3, P_ATOMIC_MEMORY_ORDER_RELAXED) == 7);
+	P_TEST_CHECK (p_atomic_int_get_explicit (&atomic_int, P_ATOMIC_MEMORY_ORDER_RELAXED) == 10);
+
+	p_atomic_pointer_set_explicit (&atomic_pointer, &atomic_int, P_ATOMIC_MEMORY_ORDER_RELEASE);
+	P_TEST_CHECK (p_atomic_pointer_get_explicit (&atomic_pointer, P_ATOMIC_MEMORY_ORDER_ACQUIRE) == &atomic_int);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (patomic_inline_spinlock_test)
+{
+	PUThread	*threads[PATOMIC_INLINE_THREADS];
+	pint		i;
+
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_spinlock_lock (NULL) == FALSE);
+	P_TEST_CHECK (p_spinlock_trylock (NULL) == FALSE);
+	P_TEST_CHECK (p_spinlock_unlock (NULL) == FALSE);
+
+	inline_lock = p_spinlock_new ();
+	P_TEST_REQUIRE (inline_lock != NULL);
+
+	P_TEST_CHECK (p_spinlock_trylock (inline_lock) == TRUE);
+	P_TEST_CHECK (p_spinlock_trylock (inline_lock) == FALSE);
+	P_TEST_CHECK ((p_spinlock_trylock) (inline_lock) == FALSE);
+	P_TEST_CHECK (p_spinlock_unlock (inline_lock) == TRUE);
+	P_TEST_CHECK ((p_spinlock_trylock) (inline_lock) == TRUE);
+	P_TEST_CHECK (p_spinlock_unlock (inline_lock) == TRUE);
+
+	inline_counter = 0;
+	inline_atomic  = 0;
+
+	for (i = 0; i < PATOMIC_INLINE_THREADS; ++i) {
+		threads[i] = p_uthread_create ((PUThreadFunc) inline_thread, NULL, TRUE, NULL);
+		P_TEST_REQUIRE (threads[i] != NULL);
+	}
+
+	for (i = 0; i < PATOMIC_INLINE_THREADS; ++i) {
+		P_TEST_CHECK (p_uthread_join (threads[i]) == 0);
+		p_uthread_unref (threads[i]);
+	}
+
+	P_TEST_CHECK (inline_counter == PATOMIC_INLINE_THREADS * PATOMIC_INLINE_ITERATIONS);
+	P_TEST_CHECK (p_atomic_int_get (&inline_atomic) == PATOMIC_INLINE_THREADS * PATOMIC_INLINE_ITERATIONS);
+
+	p_spinlock_free (inline_lock);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (patomic_inline_general_test);
+	P_TEST_SUITE_RUN_CASE (patomic_inline_spinlock_test);
+}
+P_TEST_SUITE_END()
@@ -31,6 +31,23 @@
 
 P_TEST_MODULE_INIT ();
 
+#define PATOMIC_WAIT_THREADS	4
+
+static volatile pint	wait_value  = 0;
+static volatile pint	wait_passed = 0;
+
+static void * wait_thread (void *)
+{
+	while (p_atomic_int_get (&wait_value) == 0)
+		p_atomic_int_wait (&wait_value, 0, -1);
+
+	p_atomic_int_inc (&wait_passed);
+
+	p_uthread_exit (0);
+
+	return NULL;
+}
+
 P_TEST_CASE_BEGIN (patomic_general_test)
 {
 	p_libsys_init ();
@@ -111,8 +128,187 @@ P_TEST_CASE_BEGIN (patomic_general_test)
 }
 P_TEST_CASE_END ()
 
+P_TEST_CASE_BEGIN (patomic_int64_test)
+{
+	p_libsys_init ();
+
+	(void) p_atomic_int64_is_lock_free ();
+
+	pint64 atomic_int64 = 0;
+	pint64 big_value    = P_MAXINT32;
+
+	big_value += 10;
+
+	p_atomic_int64_set (&atomic_int64, big_value);
+	P_TEST_CHECK (p_atomic_int64_get (&atomic_int64) == big_value);
+
+	/* Crosses the 32-bit boundary */
+	P_TEST_CHECK (p_atomic_int64_add (&atomic_int64, P_MAXINT32) == big_value);
+	P_TEST_CHECK (p_atomic_int64_get (&atomic_int64) == big_value + P_MAXINT32);
+
+	p_atomic_int64_add (&atomic_int64, -((pint64) P_MAXINT32));
+	P_TEST_CHECK (p_atomic_int64_get (&atomic_int64) == big_value);
+
+	p_atomic_int64_inc (&atomic_int64);
+	P_TEST_CHECK (p_atomic_int64_get (&atomic_int64) == big_value + 1);
+
+	P_TEST_CHECK (p_atomic_int64_dec_and_test (&atomic_int64) == FALSE);
+	P_TEST_CHECK (p_atomic_int64_get (&atomic_int64) == big_value);
+
+	P_TEST_CHECK (p_atomic_int64_compare_and_exchange (&atomic_int64, big_value, -big_value) == TRUE);
+	P_TEST_CHECK (p_atomic_int64_get (&atomic_int64) == -big_value);
+	P_TEST_CHECK (p_atomic_int64_compare_and_exchange (&atomic_int64, big_value, 20) == FALSE);
+	P_TEST_CHECK (p_atomic_int64_get (&atomic_int64) == -big_value);
+
+	/* Only the high half differs */
+	p_atomic_int64_set (&atomic_int64, big_value);
+	P_TEST_CHECK (p_atomic_int64_compare_and_exchange (&atomic_int64, big_value + (pint64) 0x100000000LL, 0) == FALSE);
+	P_TEST_CHECK (p_atomic_int64_get (&atomic_int64) == big_value);
+
+	p_atomic_int64_set (&atomic_int64, (pint64) 0x100000004LL);
+
+	P_TEST_CHECK (p_atomic_int64_xor ((puint64 *) &atomic_int64, (puint64) 1) == (puint64) 0x100000004ULL);
+	P_TEST_CHECK (p_atomic_int64_get (&atomic_int64) == (pint64) 0x100000005LL);
+
+	P_TEST_CHECK (p_atomic_int64_or ((puint64 *) &atomic_int64, (puint64) 0x200000002ULL) == (puint64) 0x100000005ULL);
+	P_TEST_CHECK (p_atomic_int64_get (&atomic_int64) == (pint64) 0x300000007LL);
+
+	P_TEST_CHECK (p_atomic_int64_and ((puint64 *) &atomic_int64, (puint64) 0x200000001ULL) == (puint64) 0x300000007ULL);
+	P_TEST_CHECK (p_atomic_int64_get (&atomic_int64) == (pint64) 0x200000001LL);
+
+	p_atomic_int64_set (&atomic_int64, 11);
+
+	for (pint i = 11; i > 1; --i) {
+		P_TEST_CHECK (p_atomic_int64_dec_and_test (&atomic_int64) == FALSE);
+		P_TEST_CHECK (p_atomic_int64_get (&atomic_int64) == (i - 1));
+	}
+
+	P_TEST_CHECK (p_atomic_int64_dec_and_test (&atomic_int64) == TRUE);
+	P_TEST_CHECK (p_atomic_int64_get (&atomic_int64) == 0);
+
+	p_atomic_int64_set (&atomic_int64, P_MAXINT64);
+	P_TEST_CHECK (p_atomic_int64_get (&atomic_int64) == P_MAXINT64);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (patomic_explicit_test)
+{
+	p_libsys_init ();
+
+	PAtomicMemoryOrder orders[] = {
+		P_ATOMIC_MEMORY_ORDER_RELAXED,
+		P_ATOMIC_MEMORY_ORDER_ACQUIRE,
+		P_ATOMIC_MEMORY_ORDER_RELEASE,
+		P_ATOMIC_MEMORY_ORDER_ACQ_REL,
+		P_ATOMIC_MEMORY_ORDER_SEQ_CST
+	};
+
+	for (psize i = 0; i < sizeof (orders) / sizeof (orders[0]); ++i) {
+		PAtomicMemoryOrder order = orders[i];
+
+		pint atomic_int = 0;
+
+		p_atomic_int_set_explicit (&atomic_int, 10, order);
+		P_TEST_CHECK (p_atomic_int_get_explicit (&atomic_int, order) == 10);
+		P_TEST_CHECK (p_atomic_int_add_explicit (&atomic_int, 5, order) == 10);
+		P_TEST_CHECK (p_atomic_int_get_explicit (&atomic_int, order) == 15);
+		P_TEST_CHECK (p_atomic_int_compare_and_exchange_explicit (&atomic_int, 15, -1, order) == TRUE);
+		P_TEST_CHECK (p_atomic_int_compare_and_exchange_explicit (&atomic_int, 15, 0, order) == FALSE);
+		P_TEST_CHECK (p_atomic_int_get (&atomic_int) == -1);
+
+		pint64 atomic_int64 = 0;
+		pint64 big_value    = (pint64) 0x100000000LL;
+
+		p_atomic_int64_set_explicit (&atomic_int64, big_value, order);
+		P_TEST_CHECK (p_atomic_int64_get_explicit (&atomic_int64, order) == big_value);
+		P_TEST_CHECK (p_atomic_int64_add_explicit (&atomic_int64, 1, order) == big_value);
+		P_TEST_CHECK (p_atomic_int64_get_explicit (&atomic_int64, order) == big_value + 1);
+		P_TEST_CHECK (p_atomic_int64_compare_and_exchange_explicit (&atomic_int64, big_value + 1, 7, order) == TRUE);
+		P_TEST_CHECK (p_atomic_int64_compare_and_exchange_explicit (&atomic_int64, big_value + 1, 0, order) == FALSE);
+		P_TEST_CHECK (p_atomic_int64_get (&atomic_int64) == 7);
+
+		ppointer atomic_pointer = NULL;
+
+		p_atomic_pointer_set_explicit (&atomic_pointer, PUINT_TO_POINTER (100), order);
+		P_TEST_CHECK (p_atomic_pointer_get_explicit (&atomic_pointer, order) == PUINT_TO_POINTER (100));
+		P_TEST_CHECK (p_atomic_pointer_add_explicit (&atomic_pointer, (pssize) 100, order) == 100);
+		P_TEST_CHECK (p_atomic_pointer_get_explicit (&atomic_pointer, order) == PUINT_TO_POINTER (200));
+		P_TEST_CHECK (p_atomic_pointer_compare_and_exchange_explicit (&atomic_pointer,
+									      PUINT_TO_POINTER (200),
+									      NULL,
+									      order) == TRUE);
+		P_TEST_CHECK (p_atomic_pointer_compare_and_exchange_explicit (&atomic_pointer,
+									      PUINT_TO_POINTER (200),
+									      PUINT_TO_POINTER (1),
+									      order) == FALSE);
+		P_TEST_CHECK (p_atomic_pointer_get (&atomic_pointer) == NULL);
+
+		p_atomic_thread_fence (order);
+		p_atomic_signal_fence (order);
+	}
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (patomic_wait_test)
+{
+	PUThread	*thr[PATOMIC_WAIT_THREADS];
+	pint		value;
+	pint		i;
+
+	p_libsys_init ();
+
+	value = 5;
+
+	P_TEST_CHECK (p_atomic_int_wait (NULL, 0, 0) == FALSE);
+	p_atomic_int_notify_one (NULL);
+	p_atomic_int_notify_all (NULL);
+
+	/* A different value returns at once */
+	P_TEST_CHECK (p_atomic_int_wait (&value, 4, -1) == TRUE);
+	P_TEST_CHECK (p_atomic_int_wait (&value, 5, 0) == FALSE);
+
+	/* A timeout may end early only as a spurious wakeup */
+	while (p_atomic_int_wait (&value, 5, 20) == TRUE)
+		;
+
+	/* Notifying without waiters is harmless */
+	p_atomic_int_notify_one (&value);
+	p_atomic_int_notify_all (&value);
+
+	p_atomic_int_set (&wait_value, 0);
+	p_atomic_int_set (&wait_passed, 0);
+
+	for (i = 0; i < PATOMIC_WAIT_THREADS; ++i) {
+		thr[i] = p_uthread_create ((PUThreadFunc) wait_thread, NULL, TRUE, NULL);
+		P_TEST_REQUIRE (thr[i] != NULL);
+	}
+
+	p_uthread_sleep (50);
+	P_TEST_CHECK (p_atomic_int_get (&wait_passed) == 0);
+
+	p_atomic_int_set (&wait_value, 1);
+	p_atomic_int_notify_all (&wait_value);
+
+	for (i = 0; i < PATOMIC_WAIT_THREADS; ++i) {
+		P_TEST_CHECK (p_uthread_join (thr[i]) == 0);
+		p_uthread_unref (thr[i]);
+	}
+
+	P_TEST_CHECK (p_atomic_int_get (&wait_passed) == PATOMIC_WAIT_THREADS);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
 P_TEST_SUITE_BEGIN()
 {
 	P_TEST_SUITE_RUN_CASE (patomic_general_test);
+	P_TEST_SUITE_RUN_CASE (patomic_int64_test);
+	P_TEST_SUITE_RUN_CASE (patomic_explicit_test);
+	P_TEST_SUITE_RUN_CASE (patomic_wait_test);
 }
 P_TEST_SUITE_END()
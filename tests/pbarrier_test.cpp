@@ -0,0 +1,238 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+P_TEST_MODULE_INIT ();
+
+#define PBARRIER_THREADS	4
+#define PBARRIER_PHASES		200
+
+static PBarrier *	barrier_test     = NULL;
+static volatile pint	barrier_arrived  = 0;
+static volatile pint	barrier_serial   = 0;
+static volatile pint	barrier_failures = 0;
+static PBarrier * volatile	barrier_slot     = NULL;
+static volatile pint	barrier_stop     = 0;
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static void * barrier_phase_thread (void *)
+{
+	pint phase;
+
+	for (phase = 0; phase < PBARRIER_PHASES; ++phase) {
+		p_atomic_int_inc (&barrier_arrived);
+
+		if (p_barrier_wait (barrier_test) == TRUE)
+			p_atomic_int_inc (&barrier_serial);
+
+		/* Everybody must have arrived for the current phase */
+		if (p_atomic_int_get (&barrier_arrived) < (phase + 1) * PBARRIER_THREADS)
+			p_atomic_int_inc (&barrier_failures);
+
+		/* Nobody may leave before the check above is done by all */
+		p_barrier_wait (barrier_test);
+	}
+
+	return NULL;
+}
+
+static void * barrier_free_thread (void *)
+{
+	PBarrier *barrier;
+
+	while (p_atomic_int_get (&barrier_stop) == 0) {
+		if ((barrier = (PBarrier *) p_atomic_pointer_get (&barrier_slot)) == NULL) {
+			p_uthread_yield ();
+			continue;
+		}
+
+		p_atomic_pointer_set (&barrier_slot, NULL);
+		p_barrier_wait (barrier);
+	}
+
+	return NULL;
+}
+
+static void barrier_run_phases (pint spin_count)
+{
+	PUThread	*threads[PBARRIER_THREADS];
+	pint		i;
+
+	barrier_test = p_barrier_new (PBARRIER_THREADS, spin_count);
+	P_TEST_REQUIRE (barrier_test != NULL);
+	P_TEST_CHECK (p_barrier_get_count (barrier_test) == PBARRIER_THREADS);
+
+	p_atomic_int_set (&barrier_arrived, 0);
+	p_atomic_int_set (&barrier_serial, 0);
+	p_atomic_int_set (&barrier_failures, 0);
+
+	for (i = 0; i < PBARRIER_THREADS; ++i) {
+		threads[i] = p_uthread_create ((PUThreadFunc) barrier_phase_thread, NULL, TRUE, NULL);
+		P_TEST_REQUIRE (threads[i] != NULL);
+	}
+
+	for (i = 0; i < PBARRIER_THREADS; ++i) {
+		p_uthread_join (threads[i]);
+		p_uthread_unref (threads[i]);
+	}
+
+	P_TEST_CHECK (p_atomic_int_get (&barrier_arrived) == PBARRIER_PHASES * PBARRIER_THREADS);
+	P_TEST_CHECK (p_atomic_int_get (&barrier_serial) == PBARRIER_PHASES);
+	P_TEST_CHECK (p_atomic_int_get (&barrier_failures) == 0);
+
+	p_barrier_free (barrier_test);
+	barrier_test = NULL;
+}
+
+P_TEST_CASE_BEGIN (pbarrier_nomem_test)
+{
+	p_libsys_init ();
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (p_barrier_new (2, 0) == NULL);
+	P_TEST_CHECK (p_barrier_new (2, 100) == NULL);
+
+	p_mem_restore_vtable ();
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pbarrier_bad_input_test)
+{
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_barrier_new (0, 0) == NULL);
+	P_TEST_CHECK (p_barrier_new (-1, 0) == NULL);
+	P_TEST_CHECK (p_barrier_new (1, -1) == NULL);
+	P_TEST_CHECK (p_barrier_wait (NULL) == FALSE);
+	P_TEST_CHECK (p_barrier_get_count (NULL) == 0);
+	p_barrier_free (NULL);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pbarrier_general_test)
+{
+	PBarrier	*barrier;
+	pint		i;
+
+	p_libsys_init ();
+
+	/* Single thread barrier never blocks */
+	barrier = p_barrier_new (1, 0);
+	P_TEST_REQUIRE (barrier != NULL);
+
+	for (i = 0; i < 10; ++i)
+		P_TEST_CHECK (p_barrier_wait (barrier) == TRUE);
+
+	p_barrier_free (barrier);
+
+	barrier_run_phases (0);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pbarrier_spin_test)
+{
+	p_libsys_init ();
+
+	barrier_run_phases (1000);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+/* The main thread frees the barrier at once, while the other one may not have
+ * returned yet. A positive spin count selects the generic implementation,
+ * the native one is left to the system. */
+P_TEST_CASE_BEGIN (pbarrier_free_test)
+{
+	PBarrier	*barrier;
+	PUThread	*thr;
+	pint		i;
+
+	p_libsys_init ();
+
+	p_atomic_int_set (&barrier_stop, 0);
+
+	thr = p_uthread_create ((PUThreadFunc) barrier_free_thread, NULL, TRUE, NULL);
+	P_TEST_REQUIRE (thr != NULL);
+
+	for (i = 0; i < 2000; ++i) {
+		barrier = p_barrier_new (2, i % 2 == 0 ? 1 : 100000);
+		P_TEST_REQUIRE (barrier != NULL);
+
+		p_atomic_pointer_set (&barrier_slot, barrier);
+		p_barrier_wait (barrier);
+		p_barrier_free (barrier);
+	}
+
+	p_atomic_int_set (&barrier_stop, 1);
+
+	p_uthread_join (thr);
+	p_uthread_unref (thr);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pbarrier_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pbarrier_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (pbarrier_general_test);
+	P_TEST_SUITE_RUN_CASE (pbarrier_spin_test);
+	P_TEST_SUITE_RUN_CASE (pbarrier_free_test);
+}
+P_TEST_SUITE_END()
@@ -0,0 +1,393 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+P_TEST_MODULE_INIT ();
+
+#define PBITSET_THREADS		4
+#define PBITSET_SLOTS		1000
+#define PBITSET_ITERATIONS	20000
+
+static PAtomicBitset *test_slots = NULL;
+static volatile pint test_owners[PBITSET_SLOTS];
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static void * test_thread_func (void *data)
+{
+	pint	id = PPOINTER_TO_INT (data);
+	psize	slot = 0;
+	pint	i;
+
+	for (i = 0; i < PBITSET_ITERATIONS; ++i) {
+		if ((slot = p_atomic_bitset_find_and_set (test_slots, slot)) == P_BITSET_NOT_FOUND)
+			p_uthread_exit (-1);
+
+		/* Nobody else may own the slot at the same time */
+		if (p_atomic_int_compare_and_exchange (&test_owners[slot], 0, id) == FALSE)
+			p_uthread_exit (-1);
+
+		p_uthread_yield ();
+
+		if (p_atomic_int_compare_and_exchange (&test_owners[slot], id, 0) == FALSE)
+			p_uthread_exit (-1);
+
+		if (p_atomic_bitset_clear (test_slots, slot) == FALSE)
+			p_uthread_exit (-1);
+	}
+
+	p_uthread_exit (1);
+
+	return NULL;
+}
+
+P_TEST_CASE_BEGIN (pbitset_nomem_test)
+{
+	p_libsys_init ();
+
+	PBitset *bitset = p_bitset_new (10);
+	P_TEST_REQUIRE (bitset != NULL);
+
+	p_bitset_set (bitset, 5);
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (p_bitset_new (100) == NULL);
+	P_TEST_CHECK (p_atomic_bitset_new (100) == NULL);
+	P_TEST_CHECK (p_bitset_resize (bitset, 1000) == FALSE);
+
+	p_mem_restore_vtable ();
+
+	P_TEST_CHECK (p_bitset_get_size (bitset) == 10);
+	P_TEST_CHECK (p_bitset_test (bitset, 5) == TRUE);
+
+	p_bitset_free (bitset);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pbitset_invalid_test)
+{
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_bitset_resize (NULL, 10) == FALSE);
+	P_TEST_CHECK (p_bitset_get_size (NULL) == 0);
+	P_TEST_CHECK (p_bitset_test (NULL, 0) == FALSE);
+	P_TEST_CHECK (p_bitset_find_first_set (NULL, 0) == P_BITSET_NOT_FOUND);
+	P_TEST_CHECK (p_bitset_find_first_clear (NULL, 0) == P_BITSET_NOT_FOUND);
+	P_TEST_CHECK (p_bitset_count (NULL) == 0);
+	P_TEST_CHECK (p_bitset_and (NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_bitset_or (NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_bitset_xor (NULL, NULL) == FALSE);
+
+	p_bitset_set (NULL, 0);
+	p_bitset_clear (NULL, 0);
+	p_bitset_set_range (NULL, 0, 1);
+	p_bitset_clear_range (NULL, 0, 1);
+	p_bitset_free (NULL);
+
+	P_TEST_CHECK (p_atomic_bitset_new ((psize) -1) == NULL);
+	P_TEST_CHECK (p_atomic_bitset_get_size (NULL) == 0);
+	P_TEST_CHECK (p_atomic_bitset_set (NULL, 0) == FALSE);
+	P_TEST_CHECK (p_atomic_bitset_clear (NULL, 0) == FALSE);
+	P_TEST_CHECK (p_atomic_bitset_test (NULL, 0) == FALSE);
+	P_TEST_CHECK (p_atomic_bitset_find_and_set (NULL, 0) == P_BITSET_NOT_FOUND);
+	P_TEST_CHECK (p_atomic_bitset_count (NULL) == 0);
+
+	p_atomic_bitset_free (NULL);
+
+	PBitset *bitset = p_bitset_new (0);
+	PBitset *other  = p_bitset_new (1);
+
+	P_TEST_REQUIRE (bitset != NULL && other != NULL);
+
+	/* Operations out of the set are ignored */
+	p_bitset_set (bitset, 0);
+	p_bitset_set_range (bitset, 0, 10);
+
+	P_TEST_CHECK (p_bitset_test (bitset, 0) == FALSE);
+	P_TEST_CHECK (p_bitset_count (bitset) == 0);
+	P_TEST_CHECK (p_bitset_find_first_clear (bitset, 0) == P_BITSET_NOT_FOUND);
+	P_TEST_CHECK (p_bitset_and (bitset, other) == FALSE);
+
+	p_bitset_free (other);
+	p_bitset_free (bitset);
+
+	PAtomicBitset *abitset = p_atomic_bitset_new (0);
+	P_TEST_REQUIRE (abitset != NULL);
+
+	P_TEST_CHECK (p_atomic_bitset_find_and_set (abitset, 0) == P_BITSET_NOT_FOUND);
+	P_TEST_CHECK (p_atomic_bitset_set (abitset, 0) == FALSE);
+	P_TEST_CHECK (p_atomic_bitset_count (abitset) == 0);
+
+	p_atomic_bitset_free (abitset);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pbitset_general_test)
+{
+	p_libsys_init ();
+
+	PBitset	*bitset = p_bitset_new (200);
+	psize	i;
+
+	P_TEST_REQUIRE (bitset != NULL);
+	P_TEST_CHECK (p_bitset_get_size (bitset) == 200);
+	P_TEST_CHECK (p_bitset_count (bitset) == 0);
+	P_TEST_CHECK (p_bitset_find_first_set (bitset, 0) == P_BITSET_NOT_FOUND);
+	P_TEST_CHECK (p_bitset_find_first_clear (bitset, 0) == 0);
+
+	p_bitset_set (bitset, 0);
+	p_bitset_set (bitset, 63);
+	p_bitset_set (bitset, 64);
+	p_bitset_set (bitset, 199);
+	p_bitset_set (bitset, 200);
+
+	P_TEST_CHECK (p_bitset_count (bitset) == 4);
+	P_TEST_CHECK (p_bitset_test (bitset, 63) == TRUE);
+	P_TEST_CHECK (p_bitset_test (bitset, 62) == FALSE);
+	P_TEST_CHECK (p_bitset_test (bitset, 200) == FALSE);
+
+	P_TEST_CHECK (p_bitset_find_first_set (bitset, 0) == 0);
+	P_TEST_CHECK (p_bitset_find_first_set (bitset, 1) == 63);
+	P_TEST_CHECK (p_bitset_find_first_set (bitset, 64) == 64);
+	P_TEST_CHECK (p_bitset_find_first_set (bitset, 65) == 199);
+	P_TEST_CHECK (p_bitset_find_first_set (bitset, 200) == P_BITSET_NOT_FOUND);
+	P_TEST_CHECK (p_bitset_find_first_clear (bitset, 63) == 65);
+
+	p_bitset_clear (bitset, 64);
+	P_TEST_CHECK (p_bitset_find_first_clear (bitset, 63) == 64);
+
+	/* Ranges crossing the word boundaries */
+	p_bitset_set_range (bitset, 10, 150);
+
+	for (i = 0; i < 200; ++i)
+		P_TEST_CHECK (p_bitset_test (bitset, i) == (i == 0 || (i >= 10 && i < 160) || i == 199));
+
+	P_TEST_CHECK (p_bitset_count (bitset) == 152);
+	P_TEST_CHECK (p_bitset_find_first_clear (bitset, 10) == 160);
+
+	p_bitset_clear_range (bitset, 20, 100);
+	P_TEST_CHECK (p_bitset_count (bitset) == 52);
+	P_TEST_CHECK (p_bitset_find_first_set (bitset, 11) == 11);
+	P_TEST_CHECK (p_bitset_find_first_set (bitset, 20) == 120);
+
+	p_bitset_set_range (bitset, 0, (psize) -1);
+	P_TEST_CHECK (p_bitset_count (bitset) == 200);
+	P_TEST_CHECK (p_bitset_find_first_clear (bitset, 0) == P_BITSET_NOT_FOUND);
+
+	/* Growing keeps the bits and adds the clear ones */
+	P_TEST_CHECK (p_bitset_resize (bitset, 1000) == TRUE);
+	P_TEST_CHECK (p_bitset_count (bitset) == 200);
+	P_TEST_CHECK (p_bitset_find_first_clear (bitset, 0) == 200);
+
+	p_bitset_set (bitset, 999);
+	P_TEST_CHECK (p_bitset_find_first_set (bitset, 200) == 999);
+
+	/* Shrinking drops the tail bits */
+	P_TEST_CHECK (p_bitset_resize (bitset, 100) == TRUE);
+	P_TEST_CHECK (p_bitset_count (bitset) == 100);
+	P_TEST_CHECK (p_bitset_resize (bitset, 150) == TRUE);
+	P_TEST_CHECK (p_bitset_count (bitset) == 100);
+	P_TEST_CHECK (p_bitset_find_first_clear (bitset, 0) == 100);
+
+	P_TEST_CHECK (p_bitset_resize (bitset, 0) == TRUE);
+	P_TEST_CHECK (p_bitset_count (bitset) == 0);
+	P_TEST_CHECK (p_bitset_resize (bitset, 70) == TRUE);
+	P_TEST_CHECK (p_bitset_count (bitset) == 0);
+
+	p_bitset_free (bitset);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pbitset_ops_test)
+{
+	p_libsys_init ();
+
+	PBitset	*a = p_bitset_new (1000);
+	PBitset	*b = p_bitset_new (1000);
+	PBitset	*c = p_bitset_new (1000);
+	psize	i;
+
+	P_TEST_REQUIRE (a != NULL && b != NULL && c != NULL);
+
+	for (i = 0; i < 1000; ++i) {
+		if (i % 2 == 0)
+			p_bitset_set (a, i);
+
+		if (i % 3 == 0)
+			p_bitset_set (b, i);
+	}
+
+	P_TEST_CHECK (p_bitset_or (c, a) == TRUE);
+	P_TEST_CHECK (p_bitset_and (c, b) == TRUE);
+	P_TEST_CHECK (p_bitset_count (c) == 167);
+
+	for (i = 0; i < 1000; ++i)
+		P_TEST_CHECK (p_bitset_test (c, i) == (i % 6 == 0));
+
+	P_TEST_CHECK (p_bitset_or (c, a) == TRUE);
+	P_TEST_CHECK (p_bitset_or (c, b) == TRUE);
+	P_TEST_CHECK (p_bitset_count (c) == 667);
+
+	P_TEST_CHECK (p_bitset_xor (c, a) == TRUE);
+
+	for (i = 0; i < 1000; ++i)
+		P_TEST_CHECK (p_bitset_test (c, i) == (i % 3 == 0 && i % 2 != 0));
+
+	P_TEST_CHECK (p_bitset_xor (c, c) == TRUE);
+	P_TEST_CHECK (p_bitset_count (c) == 0);
+
+	P_TEST_CHECK (p_bitset_resize (c, 999) == TRUE);
+	P_TEST_CHECK (p_bitset_or (c, a) == FALSE);
+
+	p_bitset_free (a);
+	p_bitset_free (b);
+	p_bitset_free (c);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pbitset_atomic_test)
+{
+	p_libsys_init ();
+
+	PAtomicBitset	*bitset = p_atomic_bitset_new (70);
+	psize		i;
+
+	P_TEST_REQUIRE (bitset != NULL);
+	P_TEST_CHECK (p_atomic_bitset_get_size (bitset) == 70);
+	P_TEST_CHECK (p_atomic_bitset_count (bitset) == 0);
+
+	P_TEST_CHECK (p_atomic_bitset_set (bitset, 5) == FALSE);
+	P_TEST_CHECK (p_atomic_bitset_set (bitset, 5) == TRUE);
+	P_TEST_CHECK (p_atomic_bitset_test (bitset, 5) == TRUE);
+	P_TEST_CHECK (p_atomic_bitset_test (bitset, 6) == FALSE);
+	P_TEST_CHECK (p_atomic_bitset_set (bitset, 70) == FALSE);
+	P_TEST_CHECK (p_atomic_bitset_test (bitset, 70) == FALSE);
+	P_TEST_CHECK (p_atomic_bitset_count (bitset) == 1);
+
+	P_TEST_CHECK (p_atomic_bitset_find_and_set (bitset, 5) == 6);
+	P_TEST_CHECK (p_atomic_bitset_find_and_set (bitset, 69) == 69);
+
+	/* The search wraps around */
+	P_TEST_CHECK (p_atomic_bitset_find_and_set (bitset, 69) == 0);
+	P_TEST_CHECK (p_atomic_bitset_find_and_set (bitset, 1000) == 1);
+
+	for (i = 4; i < 70; ++i) {
+		if (i != 5 && i != 6 && i != 69)
+			P_TEST_CHECK (p_atomic_bitset_find_and_set (bitset, 4) == i);
+	}
+
+	P_TEST_CHECK (p_atomic_bitset_find_and_set (bitset, 4) == 2);
+	P_TEST_CHECK (p_atomic_bitset_find_and_set (bitset, 4) == 3);
+	P_TEST_CHECK (p_atomic_bitset_count (bitset) == 70);
+	P_TEST_CHECK (p_atomic_bitset_find_and_set (bitset, 0) == P_BITSET_NOT_FOUND);
+
+	P_TEST_CHECK (p_atomic_bitset_clear (bitset, 33) == TRUE);
+	P_TEST_CHECK (p_atomic_bitset_clear (bitset, 33) == FALSE);
+	P_TEST_CHECK (p_atomic_bitset_count (bitset) == 69);
+	P_TEST_CHECK (p_atomic_bitset_find_and_set (bitset, 50) == 33);
+
+	p_atomic_bitset_free (bitset);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pbitset_thread_test)
+{
+	p_libsys_init ();
+
+	PUThread	*threads[PBITSET_THREADS];
+	pint		i;
+
+	test_slots = p_atomic_bitset_new (PBITSET_SLOTS);
+	P_TEST_REQUIRE (test_slots != NULL);
+
+	for (i = 0; i < PBITSET_SLOTS; ++i)
+		test_owners[i] = 0;
+
+	for (i = 0; i < PBITSET_THREADS; ++i) {
+		threads[i] = p_uthread_create ((PUThreadFunc) test_thread_func,
+					       PINT_TO_POINTER (i + 1),
+					       TRUE,
+					       NULL);
+		P_TEST_REQUIRE (threads[i] != NULL);
+	}
+
+	for (i = 0; i < PBITSET_THREADS; ++i) {
+		P_TEST_CHECK (p_uthread_join (threads[i]) == 1);
+		p_uthread_unref (threads[i]);
+	}
+
+	P_TEST_CHECK (p_atomic_bitset_count (test_slots) == 0);
+
+	p_atomic_bitset_free (test_slots);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pbitset_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pbitset_invalid_test);
+	P_TEST_SUITE_RUN_CASE (pbitset_general_test);
+	P_TEST_SUITE_RUN_CASE (pbitset_ops_test);
+	P_TEST_SUITE_RUN_CASE (pbitset_atomic_test);
+	P_TEST_SUITE_RUN_CASE (pbitset_thread_test);
+}
+P_TEST_SUITE_END()
@@ -0,0 +1,169 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+P_TEST_MODULE_INIT ();
+
+#define PBLOOMFILTER_ITEMS	20000
+#define PBLOOMFILTER_PROBES	200000
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+P_TEST_CASE_BEGIN (pbloomfilter_nomem_test)
+{
+	p_libsys_init ();
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (p_bloom_filter_new (1000, 0.01) == NULL);
+
+	p_mem_restore_vtable ();
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pbloomfilter_invalid_test)
+{
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_bloom_filter_new (1000, 0.0) == NULL);
+	P_TEST_CHECK (p_bloom_filter_new (1000, 1.0) == NULL);
+	P_TEST_CHECK (p_bloom_filter_new (1000, -0.5) == NULL);
+	P_TEST_CHECK (p_bloom_filter_new ((psize) -1, 0.01) == NULL);
+	P_TEST_CHECK (p_bloom_filter_contains (NULL, "a", 1) == FALSE);
+	P_TEST_CHECK (p_bloom_filter_contains_hash (NULL, 0) == FALSE);
+	P_TEST_CHECK (p_bloom_filter_get_size (NULL) == 0);
+
+	p_bloom_filter_add (NULL, "a", 1);
+	p_bloom_filter_add_hash (NULL, 0);
+	p_bloom_filter_clear (NULL);
+	p_bloom_filter_free (NULL);
+
+	PBloomFilter *filter = p_bloom_filter_new (0, 0.5);
+	P_TEST_REQUIRE (filter != NULL);
+
+	p_bloom_filter_add (filter, NULL, 10);
+	P_TEST_CHECK (p_bloom_filter_contains (filter, NULL, 10) == FALSE);
+
+	/* Empty data is a valid item */
+	p_bloom_filter_add (filter, NULL, 0);
+	P_TEST_CHECK (p_bloom_filter_contains (filter, NULL, 0) == TRUE);
+	P_TEST_CHECK (p_bloom_filter_contains (filter, "", 0) == TRUE);
+
+	p_bloom_filter_free (filter);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pbloomfilter_general_test)
+{
+	p_libsys_init ();
+
+	const pdouble rates[] = {0.2, 0.05, 0.01, 0.001};
+	psize         prev_size = 0;
+
+	for (psize r = 0; r < sizeof (rates) / sizeof (rates[0]); ++r) {
+		PBloomFilter *filter = p_bloom_filter_new (PBLOOMFILTER_ITEMS, rates[r]);
+		P_TEST_REQUIRE (filter != NULL);
+
+		P_TEST_CHECK (p_bloom_filter_get_size (filter) > prev_size);
+		P_TEST_CHECK (p_bloom_filter_get_size (filter) % 32 == 0);
+
+		prev_size = p_bloom_filter_get_size (filter);
+
+		for (puint32 i = 0; i < PBLOOMFILTER_ITEMS; ++i) {
+			if (i % 2 == 0)
+				p_bloom_filter_add (filter, &i, sizeof (i));
+			else
+				p_bloom_filter_add_hash (filter, i);
+		}
+
+		/* No false negatives */
+		for (puint32 i = 0; i < PBLOOMFILTER_ITEMS; ++i) {
+			if (i % 2 == 0)
+				P_TEST_CHECK (p_bloom_filter_contains (filter, &i, sizeof (i)) == TRUE);
+			else
+				P_TEST_CHECK (p_bloom_filter_contains_hash (filter, i) == TRUE);
+		}
+
+		psize false_positives = 0;
+
+		for (puint32 i = PBLOOMFILTER_ITEMS; i < PBLOOMFILTER_ITEMS + PBLOOMFILTER_PROBES; ++i) {
+			if (p_bloom_filter_contains (filter, &i, sizeof (i)))
+				++false_positives;
+		}
+
+		pdouble rate = (pdouble) false_positives / PBLOOMFILTER_PROBES;
+
+		P_TEST_CHECK (rate <= rates[r] * 1.25 + 0.0005);
+
+		/* The filter should not be oversized too much either */
+		P_TEST_CHECK (rate >= rates[r] / 4);
+
+		p_bloom_filter_clear (filter);
+
+		for (puint32 i = 0; i < PBLOOMFILTER_ITEMS; ++i)
+			P_TEST_CHECK (p_bloom_filter_contains_hash (filter, i) == FALSE);
+
+		p_bloom_filter_free (filter);
+	}
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pbloomfilter_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pbloomfilter_invalid_test);
+	P_TEST_SUITE_RUN_CASE (pbloomfilter_general_test);
+}
+P_TEST_SUITE_END()
@@ -0,0 +1,365 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+P_TEST_MODULE_INIT ();
+
+#define PCACHE_THREADS		4
+#define PCACHE_THREAD_ITERS	20000
+
+static pint evict_count   = 0;
+static pint destroy_count = 0;
+static PCache *test_cache = NULL;
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+extern "C" void test_evict_func (ppointer key, ppointer value, ppointer user_data)
+{
+	P_UNUSED (value);
+
+	if (user_data != NULL)
+		*((pint *) user_data) = PPOINTER_TO_INT (key);
+
+	++evict_count;
+}
+
+extern "C" void test_destroy_func (ppointer data)
+{
+	P_UNUSED (data);
+
+	++destroy_count;
+}
+
+static void * test_thread_func (void *data)
+{
+	pint	base = PPOINTER_TO_INT (data) * PCACHE_THREAD_ITERS;
+	pint	i;
+
+	for (i = 0; i < PCACHE_THREAD_ITERS; ++i) {
+		if (p_cache_insert (test_cache, PINT_TO_POINTER (base + i + 1), PINT_TO_POINTER (i), 1) == FALSE)
+			p_uthread_exit (-1);
+
+		/* Values are never removed while the thread is working on them */
+		ppointer val = p_cache_lookup (test_cache, PINT_TO_POINTER (base + i + 1));
+
+		if (val != (ppointer) -1 && val != PINT_TO_POINTER (i))
+			p_uthread_exit (-1);
+
+		if (i % 3 == 0)
+			p_cache_remove (test_cache, PINT_TO_POINTER (base + i + 1));
+	}
+
+	p_uthread_exit (1);
+
+	return NULL;
+}
+
+P_TEST_CASE_BEGIN (pcache_nomem_test)
+{
+	p_libsys_init ();
+
+	PCache *cache = p_cache_new (16);
+	P_TEST_REQUIRE (cache != NULL);
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (p_cache_new (16) == NULL);
+	P_TEST_CHECK (p_cache_new_full (P_CACHE_POLICY_SIEVE, 16, 0, 4, NULL, NULL, NULL, NULL) == NULL);
+	P_TEST_CHECK (p_cache_insert (cache, PINT_TO_POINTER (1), PINT_TO_POINTER (1), 0) == FALSE);
+
+	p_mem_restore_vtable ();
+
+	P_TEST_CHECK (p_cache_get_count (cache) == 0);
+	P_TEST_CHECK (p_cache_lookup (cache, PINT_TO_POINTER (1)) == (ppointer) -1);
+
+	p_cache_free (cache);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pcache_invalid_test)
+{
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_cache_new (0) == NULL);
+	P_TEST_CHECK (p_cache_new_full (P_CACHE_POLICY_LRU, 0, 0, 0, NULL, NULL, NULL, NULL) == NULL);
+	P_TEST_CHECK (p_cache_new_full ((PCachePolicy) 10, 16, 0, 0, NULL, NULL, NULL, NULL) == NULL);
+	P_TEST_CHECK (p_cache_insert (NULL, NULL, NULL, 0) == FALSE);
+	P_TEST_CHECK (p_cache_lookup (NULL, NULL) == (ppointer) -1);
+	P_TEST_CHECK (p_cache_remove (NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_cache_get_count (NULL) == 0);
+	P_TEST_CHECK (p_cache_get_cost (NULL) == 0);
+
+	p_cache_set_evict_func (NULL, NULL, NULL);
+	p_cache_clear (NULL);
+	p_cache_free (NULL);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pcache_lru_test)
+{
+	p_libsys_init ();
+
+	PCache	*cache = p_cache_new (4);
+	pint	evicted = 0;
+
+	P_TEST_REQUIRE (cache != NULL);
+
+	p_cache_set_evict_func (cache, test_evict_func, &evicted);
+
+	for (pint i = 1; i <= 4; ++i)
+		P_TEST_CHECK (p_cache_insert (cache, PINT_TO_POINTER (i), PINT_TO_POINTER (i * 10), 0) == TRUE);
+
+	P_TEST_CHECK (p_cache_get_count (cache) == 4);
+	P_TEST_CHECK (p_cache_lookup (cache, PINT_TO_POINTER (5)) == (ppointer) -1);
+
+	/* Key 1 becomes the most recently used one, so key 2 goes away */
+	P_TEST_CHECK (p_cache_lookup (cache, PINT_TO_POINTER (1)) == PINT_TO_POINTER (10));
+	P_TEST_CHECK (p_cache_insert (cache, PINT_TO_POINTER (5), PINT_TO_POINTER (50), 0) == TRUE);
+	P_TEST_CHECK (evicted == 2);
+	P_TEST_CHECK (p_cache_get_count (cache) == 4);
+	P_TEST_CHECK (p_cache_lookup (cache, PINT_TO_POINTER (2)) == (ppointer) -1);
+
+	/* Replacing counts as usage, too */
+	P_TEST_CHECK (p_cache_insert (cache, PINT_TO_POINTER (3), PINT_TO_POINTER (300), 0) == TRUE);
+	P_TEST_CHECK (p_cache_insert (cache, PINT_TO_POINTER (6), PINT_TO_POINTER (60), 0) == TRUE);
+	P_TEST_CHECK (evicted == 4);
+	P_TEST_CHECK (p_cache_lookup (cache, PINT_TO_POINTER (3)) == PINT_TO_POINTER (300));
+
+	P_TEST_CHECK (p_cache_remove (cache, PINT_TO_POINTER (3)) == TRUE);
+	P_TEST_CHECK (p_cache_remove (cache, PINT_TO_POINTER (3)) == FALSE);
+	P_TEST_CHECK (p_cache_get_count (cache) == 3);
+
+	/* NULL values are allowed */
+	P_TEST_CHECK (p_cache_insert (cache, PINT_TO_POINTER (7), NULL, 0) == TRUE);
+	P_TEST_CHECK (p_cache_lookup (cache, PINT_TO_POINTER (7)) == NULL);
+
+	P_TEST_CHECK (evict_count == 2);
+
+	p_cache_clear (cache);
+	P_TEST_CHECK (p_cache_get_count (cache) == 0);
+	P_TEST_CHECK (evict_count == 2);
+
+	/* Many keys to grow the index */
+	for (pint i = 1; i <= 1000; ++i)
+		P_TEST_CHECK (p_cache_insert (cache, PINT_TO_POINTER (i), PINT_TO_POINTER (i), 0) == TRUE);
+
+	P_TEST_CHECK (p_cache_get_count (cache) == 4);
+
+	for (pint i = 997; i <= 1000; ++i)
+		P_TEST_CHECK (p_cache_lookup (cache, PINT_TO_POINTER (i)) == PINT_TO_POINTER (i));
+
+	p_cache_free (cache);
+
+	evict_count = 0;
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pcache_sieve_test)
+{
+	p_libsys_init ();
+
+	PCache	*cache = p_cache_new_full (P_CACHE_POLICY_SIEVE, 4, 0, 0, NULL, NULL, NULL, NULL);
+	pint	evicted = 0;
+
+	P_TEST_REQUIRE (cache != NULL);
+
+	p_cache_set_evict_func (cache, test_evict_func, &evicted);
+
+	for (pint i = 1; i <= 4; ++i)
+		P_TEST_CHECK (p_cache_insert (cache, PINT_TO_POINTER (i), PINT_TO_POINTER (i), 0) == TRUE);
+
+	/* Visited keys 1 and 2 survive, the oldest unvisited one goes away */
+	P_TEST_CHECK (p_cache_lookup (cache, PINT_TO_POINTER (1)) == PINT_TO_POINTER (1));
+	P_TEST_CHECK (p_cache_lookup (cache, PINT_TO_POINTER (2)) == PINT_TO_POINTER (2));
+
+	P_TEST_CHECK (p_cache_insert (cache, PINT_TO_POINTER (5), PINT_TO_POINTER (5), 0) == TRUE);
+	P_TEST_CHECK (evicted == 3);
+
+	/* The hand continues from the last position */
+	P_TEST_CHECK (p_cache_insert (cache, PINT_TO_POINTER (6), PINT_TO_POINTER (6), 0) == TRUE);
+	P_TEST_CHECK (evicted == 4);
+
+	/* The hand goes further to the head instead of the oldest pair */
+	P_TEST_CHECK (p_cache_insert (cache, PINT_TO_POINTER (7), PINT_TO_POINTER (7), 0) == TRUE);
+	P_TEST_CHECK (evicted == 5);
+
+	P_TEST_CHECK (p_cache_lookup (cache, PINT_TO_POINTER (1)) == PINT_TO_POINTER (1));
+	P_TEST_CHECK (p_cache_lookup (cache, PINT_TO_POINTER (2)) == PINT_TO_POINTER (2));
+	P_TEST_CHECK (p_cache_lookup (cache, PINT_TO_POINTER (6)) == PINT_TO_POINTER (6));
+	P_TEST_CHECK (p_cache_lookup (cache, PINT_TO_POINTER (7)) == PINT_TO_POINTER (7));
+
+	/* All visited: the hand wraps around clearing the marks */
+	P_TEST_CHECK (p_cache_insert (cache, PINT_TO_POINTER (8), PINT_TO_POINTER (8), 0) == TRUE);
+	P_TEST_CHECK (evicted == 6);
+	P_TEST_CHECK (p_cache_get_count (cache) == 4);
+	P_TEST_CHECK (p_cache_lookup (cache, PINT_TO_POINTER (8)) == PINT_TO_POINTER (8));
+	P_TEST_CHECK (evict_count == 4);
+
+	/* Removing the pair under the hand */
+	P_TEST_CHECK (p_cache_remove (cache, PINT_TO_POINTER (7)) == TRUE);
+
+	for (pint i = 100; i < 1100; ++i) {
+		P_TEST_CHECK (p_cache_insert (cache, PINT_TO_POINTER (i), PINT_TO_POINTER (i), 0) == TRUE);
+
+		if (i % 2 == 0)
+			p_cache_lookup (cache, PINT_TO_POINTER (i));
+	}
+
+	P_TEST_CHECK (p_cache_get_count (cache) == 4);
+
+	p_cache_free (cache);
+
+	evict_count = 0;
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pcache_cost_test)
+{
+	p_libsys_init ();
+
+	PCache *cache = p_cache_new_full (P_CACHE_POLICY_LRU,
+					  0,
+					  100,
+					  0,
+					  NULL,
+					  NULL,
+					  test_destroy_func,
+					  test_destroy_func);
+
+	P_TEST_REQUIRE (cache != NULL);
+
+	P_TEST_CHECK (p_cache_insert (cache, PINT_TO_POINTER (1), PINT_TO_POINTER (1), 101) == FALSE);
+	P_TEST_CHECK (destroy_count == 0);
+
+	P_TEST_CHECK (p_cache_insert (cache, PINT_TO_POINTER (1), PINT_TO_POINTER (1), 40) == TRUE);
+	P_TEST_CHECK (p_cache_insert (cache, PINT_TO_POINTER (2), PINT_TO_POINTER (2), 40) == TRUE);
+	P_TEST_CHECK (p_cache_get_cost (cache) == 80);
+	P_TEST_CHECK (p_cache_get_count (cache) == 2);
+
+	/* The insertion evicts the least recently used pair */
+	P_TEST_CHECK (p_cache_insert (cache, PINT_TO_POINTER (3), PINT_TO_POINTER (3), 30) == TRUE);
+	P_TEST_CHECK (p_cache_get_cost (cache) == 70);
+	P_TEST_CHECK (p_cache_lookup (cache, PINT_TO_POINTER (1)) == (ppointer) -1);
+	P_TEST_CHECK (destroy_count == 2);
+
+	/* Replacing the value with a new cost */
+	P_TEST_CHECK (p_cache_insert (cache, PINT_TO_POINTER (3), PINT_TO_POINTER (33), 10) == TRUE);
+	P_TEST_CHECK (p_cache_get_cost (cache) == 50);
+	P_TEST_CHECK (destroy_count == 3);
+
+	/* A heavy pair displaces everything else */
+	P_TEST_CHECK (p_cache_insert (cache, PINT_TO_POINTER (4), PINT_TO_POINTER (4), 100) == TRUE);
+	P_TEST_CHECK (p_cache_get_count (cache) == 1);
+	P_TEST_CHECK (p_cache_get_cost (cache) == 100);
+	P_TEST_CHECK (destroy_count == 7);
+
+	P_TEST_CHECK (p_cache_remove (cache, PINT_TO_POINTER (4)) == TRUE);
+	P_TEST_CHECK (p_cache_get_cost (cache) == 0);
+	P_TEST_CHECK (destroy_count == 9);
+
+	P_TEST_CHECK (p_cache_insert (cache, PINT_TO_POINTER (5), PINT_TO_POINTER (5), 0) == TRUE);
+	p_cache_free (cache);
+	P_TEST_CHECK (destroy_count == 11);
+
+	destroy_count = 0;
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pcache_thread_test)
+{
+	p_libsys_init ();
+
+	PUThread *threads[PCACHE_THREADS];
+
+	test_cache = p_cache_new_full (P_CACHE_POLICY_SIEVE, 1024, 0, 8, NULL, NULL, NULL, NULL);
+	P_TEST_REQUIRE (test_cache != NULL);
+
+	for (pint i = 0; i < PCACHE_THREADS; ++i) {
+		threads[i] = p_uthread_create ((PUThreadFunc) test_thread_func,
+					       PINT_TO_POINTER (i),
+					       TRUE,
+					       NULL);
+		P_TEST_REQUIRE (threads[i] != NULL);
+	}
+
+	for (pint i = 0; i < PCACHE_THREADS; ++i) {
+		P_TEST_CHECK (p_uthread_join (threads[i]) == 1);
+		p_uthread_unref (threads[i]);
+	}
+
+	/* Every shard is limited with 128 pairs */
+	P_TEST_CHECK (p_cache_get_count (test_cache) > 0);
+	P_TEST_CHECK (p_cache_get_count (test_cache) <= 1024);
+
+	p_cache_free (test_cache);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pcache_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pcache_invalid_test);
+	P_TEST_SUITE_RUN_CASE (pcache_lru_test);
+	P_TEST_SUITE_RUN_CASE (pcache_sieve_test);
+	P_TEST_SUITE_RUN_CASE (pcache_cost_test);
+	P_TEST_SUITE_RUN_CASE (pcache_thread_test);
+}
+P_TEST_SUITE_END()
@@ -0,0 +1,392 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <stdio.h>
+#include <string.h>
+
+P_TEST_MODULE_INIT ();
+
+#define PCONCURRENTHASHTABLE_STRESS_COUNT	10000
+#define PCONCURRENTHASHTABLE_THREADS		4
+
+static PConcurrentHashTable *	test_table            = NULL;
+static volatile pint		test_inserted_counter = 0;
+static volatile pint		test_destroy_counter  = 0;
+static volatile pboolean	test_is_working       = FALSE;
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static void * test_thread_func (void *data)
+{
+	pint thread_idx = PPOINTER_TO_INT (data);
+
+	for (pint i = 1; i <= PCONCURRENTHASHTABLE_STRESS_COUNT; ++i) {
+		/* All the threads compete for the same keys */
+		if (p_concurrent_hash_table_lookup_or_insert (test_table,
+							      PINT_TO_POINTER (i),
+							      PINT_TO_POINTER (thread_idx)) == (ppointer) -1)
+			p_atomic_int_inc (&test_inserted_counter);
+
+		/* And also insert and remove own keys */
+		pint own_key = -(thread_idx * PCONCURRENTHASHTABLE_STRESS_COUNT + i);
+
+		p_concurrent_hash_table_insert (test_table, PINT_TO_POINTER (own_key), PINT_TO_POINTER (i));
+
+		if (p_concurrent_hash_table_lookup (test_table, PINT_TO_POINTER (own_key)) != PINT_TO_POINTER (i))
+			p_uthread_exit (-1);
+
+		p_concurrent_hash_table_remove (test_table, PINT_TO_POINTER (own_key));
+
+		if (p_concurrent_hash_table_lookup (test_table, PINT_TO_POINTER (own_key)) != (ppointer) -1)
+			p_uthread_exit (-1);
+	}
+
+	p_uthread_exit (1);
+
+	return NULL;
+}
+
+static void test_destroy_func (ppointer data)
+{
+	P_UNUSED (data);
+	p_atomic_int_inc (&test_destroy_counter);
+}
+
+static void * test_reader_thread_func (void *data)
+{
+	P_UNUSED (data);
+
+	/* Make at least one pass even if the writer is already done */
+	do {
+		for (pint i = 1; i <= PCONCURRENTHASHTABLE_STRESS_COUNT; ++i) {
+			ppointer value = p_concurrent_hash_table_lookup (test_table, PINT_TO_POINTER (i));
+
+			/* Constant keys must always be found with a proper value */
+			if (i % 2 == 0 && value != PINT_TO_POINTER (i))
+				p_uthread_exit (-1);
+
+			/* Volatile keys are either missing or have a proper value */
+			if (i % 2 != 0 && value != (ppointer) -1 && value != PINT_TO_POINTER (i))
+				p_uthread_exit (-1);
+		}
+	} while (test_is_working == TRUE);
+
+	p_uthread_exit (1);
+
+	return NULL;
+}
+
+static void * test_writer_thread_func (void *data)
+{
+	P_UNUSED (data);
+
+	for (pint k = 0; k < 10; ++k) {
+		for (pint i = 1; i <= PCONCURRENTHASHTABLE_STRESS_COUNT; i += 2)
+			p_concurrent_hash_table_insert (test_table, PINT_TO_POINTER (i), PINT_TO_POINTER (i));
+
+		for (pint i = 1; i <= PCONCURRENTHASHTABLE_STRESS_COUNT; i += 2)
+			p_concurrent_hash_table_remove (test_table, PINT_TO_POINTER (i));
+	}
+
+	p_uthread_exit (1);
+
+	return NULL;
+}
+
+P_TEST_CASE_BEGIN (pconcurrenthashtable_nomem_test)
+{
+	p_libsys_init ();
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (p_concurrent_hash_table_new () == NULL);
+	P_TEST_CHECK (p_concurrent_hash_table_new_full (8, NULL, NULL, NULL, NULL) == NULL);
+	P_TEST_CHECK (p_concurrent_hash_table_new_read_mostly (NULL, NULL, NULL, NULL) == NULL);
+
+	p_mem_restore_vtable ();
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pconcurrenthashtable_invalid_test)
+{
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_concurrent_hash_table_lookup (NULL, NULL) == NULL);
+	P_TEST_CHECK (p_concurrent_hash_table_lookup_or_insert (NULL, NULL, NULL) == NULL);
+	p_concurrent_hash_table_insert (NULL, NULL, NULL);
+	p_concurrent_hash_table_remove (NULL, NULL);
+	p_concurrent_hash_table_free (NULL);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pconcurrenthashtable_general_test)
+{
+	p_libsys_init ();
+
+	PConcurrentHashTable *table = p_concurrent_hash_table_new ();
+	P_TEST_REQUIRE (table != NULL);
+
+	p_concurrent_hash_table_insert (table, PINT_TO_POINTER (1), PINT_TO_POINTER (10));
+	p_concurrent_hash_table_insert (table, PINT_TO_POINTER (2), PINT_TO_POINTER (20));
+
+	P_TEST_CHECK (p_concurrent_hash_table_lookup (table, PINT_TO_POINTER (1)) == PINT_TO_POINTER (10));
+	P_TEST_CHECK (p_concurrent_hash_table_lookup (table, PINT_TO_POINTER (2)) == PINT_TO_POINTER (20));
+	P_TEST_CHECK (p_concurrent_hash_table_lookup (table, PINT_TO_POINTER (3)) == (ppointer) -1);
+
+	P_TEST_CHECK (p_concurrent_hash_table_lookup_or_insert (table,
+								PINT_TO_POINTER (1),
+								PINT_TO_POINTER (15)) == PINT_TO_POINTER (10));
+	P_TEST_CHECK (p_concurrent_hash_table_lookup_or_insert (table,
+								PINT_TO_POINTER (3),
+								PINT_TO_POINTER (30)) == (ppointer) -1);
+	P_TEST_CHECK (p_concurrent_hash_table_lookup (table, PINT_TO_POINTER (1)) == PINT_TO_POINTER (10));
+	P_TEST_CHECK (p_concurrent_hash_table_lookup (table, PINT_TO_POINTER (3)) == PINT_TO_POINTER (30));
+
+	p_concurrent_hash_table_insert (table, PINT_TO_POINTER (1), PINT_TO_POINTER (15));
+	P_TEST_CHECK (p_concurrent_hash_table_lookup (table, PINT_TO_POINTER (1)) == PINT_TO_POINTER (15));
+
+	p_concurrent_hash_table_remove (table, PINT_TO_POINTER (1));
+	p_concurrent_hash_table_remove (table, PINT_TO_POINTER (4));
+	P_TEST_CHECK (p_concurrent_hash_table_lookup (table, PINT_TO_POINTER (1)) == (ppointer) -1);
+	P_TEST_CHECK (p_concurrent_hash_table_lookup (table, PINT_TO_POINTER (2)) == PINT_TO_POINTER (20));
+
+	p_concurrent_hash_table_free (table);
+
+	/* String keys within a single segment */
+	table = p_concurrent_hash_table_new_full (1, p_str_hash, p_str_equal, p_free, NULL);
+	P_TEST_REQUIRE (table != NULL);
+
+	p_concurrent_hash_table_insert (table, p_strdup ("key"), PINT_TO_POINTER (1));
+	P_TEST_CHECK (p_concurrent_hash_table_lookup (table, "key") == PINT_TO_POINTER (1));
+	P_TEST_CHECK (p_concurrent_hash_table_lookup (table, "other") == (ppointer) -1);
+
+	p_concurrent_hash_table_free (table);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pconcurrenthashtable_threads_test)
+{
+	PUThread *threads[PCONCURRENTHASHTABLE_THREADS];
+
+	p_libsys_init ();
+
+	test_table            = p_concurrent_hash_table_new_full (4, NULL, NULL, NULL, NULL);
+	test_inserted_counter = 0;
+
+	P_TEST_REQUIRE (test_table != NULL);
+
+	for (pint i = 0; i < PCONCURRENTHASHTABLE_THREADS; ++i) {
+		threads[i] = p_uthread_create ((PUThreadFunc) test_thread_func,
+					       PINT_TO_POINTER (i + 1),
+					       TRUE,
+					       NULL);
+		P_TEST_REQUIRE (threads[i] != NULL);
+	}
+
+	for (pint i = 0; i < PCONCURRENTHASHTABLE_THREADS; ++i) {
+		P_TEST_CHECK (p_uthread_join (threads[i]) == 1);
+		p_uthread_unref (threads[i]);
+	}
+
+	P_TEST_CHECK (test_inserted_counter == PCONCURRENTHASHTABLE_STRESS_COUNT);
+
+	for (pint i = 1; i <= PCONCURRENTHASHTABLE_STRESS_COUNT; ++i) {
+		ppointer value = p_concurrent_hash_table_lookup (test_table, PINT_TO_POINTER (i));
+
+		P_TEST_CHECK (PPOINTER_TO_INT (value) >= 1 &&
+			      PPOINTER_TO_INT (value) <= PCONCURRENTHASHTABLE_THREADS);
+	}
+
+	p_concurrent_hash_table_free (test_table);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pconcurrenthashtable_read_mostly_test)
+{
+	p_libsys_init ();
+
+	test_destroy_counter = 0;
+
+	PConcurrentHashTable *table = p_concurrent_hash_table_new_read_mostly (p_str_hash,
+									       p_str_equal,
+									       p_free,
+									       (PDestroyFunc) test_destroy_func);
+	P_TEST_REQUIRE (table != NULL);
+
+	pchar key[32];
+
+	for (pint i = 0; i < PCONCURRENTHASHTABLE_STRESS_COUNT; ++i) {
+		sprintf (key, "key%d", i);
+		p_concurrent_hash_table_insert (table, p_strdup (key), PINT_TO_POINTER (i));
+	}
+
+	for (pint i = 0; i < PCONCURRENTHASHTABLE_STRESS_COUNT; ++i) {
+		sprintf (key, "key%d", i);
+		P_TEST_CHECK (p_concurrent_hash_table_lookup (table, key) == PINT_TO_POINTER (i));
+	}
+
+	P_TEST_CHECK (p_concurrent_hash_table_lookup (table, "none") == (ppointer) -1);
+
+	/* Replace and lookup or insert */
+	p_concurrent_hash_table_insert (table, p_strdup ("key1"), PINT_TO_POINTER (100));
+	P_TEST_CHECK (p_concurrent_hash_table_lookup (table, "key1") == PINT_TO_POINTER (100));
+	P_TEST_CHECK (p_concurrent_hash_table_lookup_or_insert (table,
+								(ppointer) "key2",
+								PINT_TO_POINTER (200)) == PINT_TO_POINTER (2));
+
+	pchar *new_key = p_strdup ("new");
+
+	P_TEST_CHECK (p_concurrent_hash_table_lookup_or_insert (table, new_key, PINT_TO_POINTER (300)) == (ppointer) -1);
+	P_TEST_CHECK (p_concurrent_hash_table_lookup (table, "new") == PINT_TO_POINTER (300));
+
+	for (pint i = 0; i < PCONCURRENTHASHTABLE_STRESS_COUNT; i += 2) {
+		sprintf (key, "key%d", i);
+		p_concurrent_hash_table_remove (table, key);
+		P_TEST_CHECK (p_concurrent_hash_table_lookup (table, key) == (ppointer) -1);
+	}
+
+	for (pint i = 1; i < PCONCURRENTHASHTABLE_STRESS_COUNT; i += 2) {
+		sprintf (key, "key%d", i);
+		P_TEST_CHECK (p_concurrent_hash_table_lookup (table, key) == PINT_TO_POINTER (i == 1 ? 100 : i));
+	}
+
+	p_concurrent_hash_table_free (table);
+
+	/* All the values inserted, including the replaced one */
+	P_TEST_CHECK (test_destroy_counter == PCONCURRENTHASHTABLE_STRESS_COUNT + 2);
+
+	/* Reclaimed nodes are reused without the global allocator */
+	table = p_concurrent_hash_table_new_read_mostly (NULL, NULL, NULL, NULL);
+	P_TEST_REQUIRE (table != NULL);
+
+	for (pint i = 1; i <= 256; ++i)
+		p_concurrent_hash_table_insert (table, PINT_TO_POINTER (i), PINT_TO_POINTER (i));
+
+	for (pint i = 1; i <= 256; ++i)
+		p_concurrent_hash_table_remove (table, PINT_TO_POINTER (i));
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	for (pint i = 1; i <= 128; ++i)
+		p_concurrent_hash_table_insert (table, PINT_TO_POINTER (i), PINT_TO_POINTER (i));
+
+	p_mem_restore_vtable ();
+
+	for (pint i = 1; i <= 128; ++i)
+		P_TEST_CHECK (p_concurrent_hash_table_lookup (table, PINT_TO_POINTER (i)) == PINT_TO_POINTER (i));
+
+	p_concurrent_hash_table_free (table);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pconcurrenthashtable_read_mostly_threads_test)
+{
+	PUThread *readers[PCONCURRENTHASHTABLE_THREADS];
+
+	p_libsys_init ();
+
+	test_table = p_concurrent_hash_table_new_read_mostly (NULL, NULL, NULL, NULL);
+	P_TEST_REQUIRE (test_table != NULL);
+
+	for (pint i = 2; i <= PCONCURRENTHASHTABLE_STRESS_COUNT; i += 2)
+		p_concurrent_hash_table_insert (test_table, PINT_TO_POINTER (i), PINT_TO_POINTER (i));
+
+	test_is_working = TRUE;
+
+	for (pint i = 0; i < PCONCURRENTHASHTABLE_THREADS; ++i) {
+		readers[i] = p_uthread_create ((PUThreadFunc) test_reader_thread_func, NULL, TRUE, NULL);
+		P_TEST_REQUIRE (readers[i] != NULL);
+	}
+
+	PUThread *writer = p_uthread_create ((PUThreadFunc) test_writer_thread_func, NULL, TRUE, NULL);
+	P_TEST_REQUIRE (writer != NULL);
+
+	P_TEST_CHECK (p_uthread_join (writer) == 1);
+	p_uthread_unref (writer);
+
+	test_is_working = FALSE;
+
+	for (pint i = 0; i < PCONCURRENTHASHTABLE_THREADS; ++i) {
+		P_TEST_CHECK (p_uthread_join (readers[i]) == 1);
+		p_uthread_unref (readers[i]);
+	}
+
+	p_concurrent_hash_table_free (test_table);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pconcurrenthashtable_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pconcurrenthashtable_invalid_test);
+	P_TEST_SUITE_RUN_CASE (pconcurrenthashtable_general_test);
+	P_TEST_SUITE_RUN_CASE (pconcurrenthashtable_threads_test);
+	P_TEST_SUITE_RUN_CASE (pconcurrenthashtable_read_mostly_test);
+	P_TEST_SUITE_RUN_CASE (pconcurrenthashtable_read_mostly_threads_test);
+}
+P_TEST_SUITE_END()
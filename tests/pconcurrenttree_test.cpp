@@ -0,0 +1,253 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <string.h>
+
+P_TEST_MODULE_INIT ();
+
+#define PCONCURRENTTREE_STRESS_COUNT	10000
+#define PCONCURRENTTREE_THREADS		4
+
+static PConcurrentTree *	test_tree       = NULL;
+static volatile pboolean	test_is_working = FALSE;
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static pint
+compare_keys (pconstpointer a, pconstpointer b, ppointer data)
+{
+	int p1 = PPOINTER_TO_INT (a);
+	int p2 = PPOINTER_TO_INT (b);
+
+	P_UNUSED (data);
+
+	if (p1 < p2)
+		return -1;
+	else if (p1 > p2)
+		return 1;
+	else
+		return 0;
+}
+
+static void * test_reader_thread_func (void *data)
+{
+	P_UNUSED (data);
+
+	pint iterations = 0;
+
+	while (test_is_working == TRUE) {
+		for (pint i = 1; i <= PCONCURRENTTREE_STRESS_COUNT; ++i) {
+			ppointer value = p_concurrent_tree_lookup (test_tree, PINT_TO_POINTER (i));
+
+			/* Constant keys must always be found with a proper value */
+			if (i % 2 == 0 && value != PINT_TO_POINTER (i))
+				p_uthread_exit (-1);
+
+			/* Volatile keys are either missing or have a proper value */
+			if (i % 2 != 0 && value != (ppointer) -1 && value != PINT_TO_POINTER (i))
+				p_uthread_exit (-1);
+		}
+
+		++iterations;
+	}
+
+	p_uthread_exit (iterations > 0 ? 1 : -1);
+
+	return NULL;
+}
+
+static void * test_writer_thread_func (void *data)
+{
+	P_UNUSED (data);
+
+	for (pint k = 0; k < 10; ++k) {
+		for (pint i = 1; i <= PCONCURRENTTREE_STRESS_COUNT; i += 2)
+			p_concurrent_tree_insert (test_tree, PINT_TO_POINTER (i), PINT_TO_POINTER (i));
+
+		for (pint i = 1; i <= PCONCURRENTTREE_STRESS_COUNT; i += 2)
+			p_concurrent_tree_remove (test_tree, PINT_TO_POINTER (i));
+	}
+
+	p_uthread_exit (1);
+
+	return NULL;
+}
+
+P_TEST_CASE_BEGIN (pconcurrenttree_nomem_test)
+{
+	p_libsys_init ();
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	for (int i = (int) P_TREE_TYPE_BINARY; i <= (int) P_TREE_TYPE_AVL; ++i)
+		P_TEST_CHECK (p_concurrent_tree_new ((PTreeType) i, compare_keys, NULL) == NULL);
+
+	p_mem_restore_vtable ();
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pconcurrenttree_invalid_test)
+{
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_concurrent_tree_new (P_TREE_TYPE_RB, NULL, NULL) == NULL);
+	P_TEST_CHECK (p_concurrent_tree_new (P_TREE_TYPE_BTREE, compare_keys, NULL) == NULL);
+	P_TEST_CHECK (p_concurrent_tree_new ((PTreeType) -1, compare_keys, NULL) == NULL);
+
+	P_TEST_CHECK (p_concurrent_tree_lookup (NULL, NULL) == NULL);
+	P_TEST_CHECK (p_concurrent_tree_remove (NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_concurrent_tree_get_nnodes (NULL) == 0);
+	p_concurrent_tree_insert (NULL, NULL, NULL);
+	p_concurrent_tree_free (NULL);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pconcurrenttree_general_test)
+{
+	p_libsys_init ();
+
+	for (int i = (int) P_TREE_TYPE_BINARY; i <= (int) P_TREE_TYPE_AVL; ++i) {
+		PConcurrentTree *tree = p_concurrent_tree_new ((PTreeType) i, compare_keys, NULL);
+		P_TEST_REQUIRE (tree != NULL);
+
+		P_TEST_CHECK (p_concurrent_tree_lookup (tree, PINT_TO_POINTER (1)) == (ppointer) -1);
+		P_TEST_CHECK (p_concurrent_tree_get_nnodes (tree) == 0);
+
+		p_concurrent_tree_insert (tree, PINT_TO_POINTER (1), PINT_TO_POINTER (10));
+		p_concurrent_tree_insert (tree, PINT_TO_POINTER (2), PINT_TO_POINTER (20));
+		p_concurrent_tree_insert (tree, PINT_TO_POINTER (3), NULL);
+
+		P_TEST_CHECK (p_concurrent_tree_get_nnodes (tree) == 3);
+		P_TEST_CHECK (p_concurrent_tree_lookup (tree, PINT_TO_POINTER (1)) == PINT_TO_POINTER (10));
+		P_TEST_CHECK (p_concurrent_tree_lookup (tree, PINT_TO_POINTER (2)) == PINT_TO_POINTER (20));
+		P_TEST_CHECK (p_concurrent_tree_lookup (tree, PINT_TO_POINTER (3)) == NULL);
+		P_TEST_CHECK (p_concurrent_tree_lookup (tree, PINT_TO_POINTER (4)) == (ppointer) -1);
+
+		p_concurrent_tree_insert (tree, PINT_TO_POINTER (1), PINT_TO_POINTER (15));
+		P_TEST_CHECK (p_concurrent_tree_lookup (tree, PINT_TO_POINTER (1)) == PINT_TO_POINTER (15));
+		P_TEST_CHECK (p_concurrent_tree_get_nnodes (tree) == 3);
+
+		P_TEST_CHECK (p_concurrent_tree_remove (tree, PINT_TO_POINTER (1)) == TRUE);
+		P_TEST_CHECK (p_concurrent_tree_remove (tree, PINT_TO_POINTER (4)) == FALSE);
+		P_TEST_CHECK (p_concurrent_tree_lookup (tree, PINT_TO_POINTER (1)) == (ppointer) -1);
+		P_TEST_CHECK (p_concurrent_tree_lookup (tree, PINT_TO_POINTER (2)) == PINT_TO_POINTER (20));
+		P_TEST_CHECK (p_concurrent_tree_get_nnodes (tree) == 2);
+
+		/* Degenerated trees are looked up completely */
+		for (int j = 1; j <= 1000; ++j)
+			p_concurrent_tree_insert (tree, PINT_TO_POINTER (j + 10), PINT_TO_POINTER (j));
+
+		for (int j = 1; j <= 1000; ++j)
+			P_TEST_CHECK (p_concurrent_tree_lookup (tree, PINT_TO_POINTER (j + 10)) == PINT_TO_POINTER (j));
+
+		p_concurrent_tree_free (tree);
+	}
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pconcurrenttree_threads_test)
+{
+	PUThread *readers[PCONCURRENTTREE_THREADS];
+
+	p_libsys_init ();
+
+	for (int t = (int) P_TREE_TYPE_BINARY; t <= (int) P_TREE_TYPE_AVL; ++t) {
+		test_tree = p_concurrent_tree_new ((PTreeType) t, compare_keys, NULL);
+		P_TEST_REQUIRE (test_tree != NULL);
+
+		/* Shuffled order keeps the unbalanced tree from degenerating */
+		for (pint i = 0; i < PCONCURRENTTREE_STRESS_COUNT / 2; ++i) {
+			pint k = ((i * 1597) % (PCONCURRENTTREE_STRESS_COUNT / 2) + 1) * 2;
+			p_concurrent_tree_insert (test_tree, PINT_TO_POINTER (k), PINT_TO_POINTER (k));
+		}
+
+		test_is_working = TRUE;
+
+		for (pint i = 0; i < PCONCURRENTTREE_THREADS; ++i) {
+			readers[i] = p_uthread_create ((PUThreadFunc) test_reader_thread_func, NULL, TRUE, NULL);
+			P_TEST_REQUIRE (readers[i] != NULL);
+		}
+
+		PUThread *writer = p_uthread_create ((PUThreadFunc) test_writer_thread_func, NULL, TRUE, NULL);
+		P_TEST_REQUIRE (writer != NULL);
+
+		P_TEST_CHECK (p_uthread_join (writer) == 1);
+		p_uthread_unref (writer);
+
+		test_is_working = FALSE;
+
+		for (pint i = 0; i < PCONCURRENTTREE_THREADS; ++i) {
+			P_TEST_CHECK (p_uthread_join (readers[i]) == 1);
+			p_uthread_unref (readers[i]);
+		}
+
+		P_TEST_CHECK (p_concurrent_tree_get_nnodes (test_tree) == PCONCURRENTTREE_STRESS_COUNT / 2);
+
+		p_concurrent_tree_free (test_tree);
+	}
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pconcurrenttree_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pconcurrenttree_invalid_test);
+	P_TEST_SUITE_RUN_CASE (pconcurrenttree_general_test);
+	P_TEST_SUITE_RUN_CASE (pconcurrenttree_threads_test);
+}
+P_TEST_SUITE_END()
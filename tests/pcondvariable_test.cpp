@@ -36,6 +36,8 @@ static PCondVariable *   queue_empty_cond = NULL;
 static PCondVariable *   queue_full_cond  = NULL;
 static PMutex *          cond_mutex       = NULL;
 volatile static pboolean is_working       = TRUE;
+static pboolean          timed_flag       = FALSE;
+static PCondVariable *   timed_cond       = NULL;
 
 extern "C" ppointer pmem_alloc (psize nbytes)
 {
@@ -139,6 +141,18 @@ static void * consumer_test_thread (void *)
 	return NULL;
 }
 
+static void * timed_signal_thread (void *)
+{
+	p_uthread_sleep (50);
+
+	p_mutex_lock (cond_mutex);
+	timed_flag = TRUE;
+	p_cond_variable_signal (timed_cond);
+	p_mutex_unlock (cond_mutex);
+
+	return NULL;
+}
+
 P_TEST_CASE_BEGIN (pcondvariable_nomem_test)
 {
 	p_libsys_init ();
@@ -165,6 +179,7 @@ P_TEST_CASE_BEGIN (pcondvariable_bad_input_test)
 	P_TEST_REQUIRE (p_cond_variable_broadcast (NULL) == FALSE);
 	P_TEST_REQUIRE (p_cond_variable_signal (NULL) == FALSE);
 	P_TEST_REQUIRE (p_cond_variable_wait (NULL, NULL) == FALSE);
+	P_TEST_REQUIRE (p_cond_variable_wait_timed (NULL, NULL, 0) == -1);
 	p_cond_variable_free (NULL);
 
 	p_libsys_shutdown ();
@@ -221,10 +236,149 @@ P_TEST_CASE_BEGIN (pcondvariable_general_test)
 }
 P_TEST_CASE_END ()
 
+P_TEST_CASE_BEGIN (pcondvariable_timed_test)
+{
+	PTimeProfiler	*profiler;
+	PUThread	*thr;
+	puint64		elapsed;
+	pint		res = 0;
+
+	p_libsys_init ();
+
+	timed_cond = p_cond_variable_new ();
+	P_TEST_REQUIRE (timed_cond != NULL);
+	cond_mutex = p_mutex_new ();
+	P_TEST_REQUIRE (cond_mutex != NULL);
+	profiler = p_time_profiler_new ();
+	P_TEST_REQUIRE (profiler != NULL);
+
+	P_TEST_CHECK (p_cond_variable_wait_timed (timed_cond, NULL, 0) == -1);
+
+	/* Nobody signals, so waits must time out */
+	P_TEST_REQUIRE (p_mutex_lock (cond_mutex) == TRUE);
+
+	P_TEST_CHECK (p_cond_variable_wait_timed (timed_cond, cond_mutex, 0) == 0);
+
+	p_time_profiler_reset (profiler);
+	res = p_cond_variable_wait_timed (timed_cond, cond_mutex, 100);
+	elapsed = p_time_profiler_elapsed_usecs (profiler);
+
+	/* Spurious wakeups are allowed */
+	P_TEST_CHECK (res == 0 || res == 1);
+
+	if (res == 0)
+		P_TEST_CHECK (elapsed >= 80 * 1000);
+
+	P_TEST_REQUIRE (p_mutex_unlock (cond_mutex) == TRUE);
+
+	/* Signal must arrive before the timeout */
+	timed_flag = FALSE;
+
+	thr = p_uthread_create ((PUThreadFunc) timed_signal_thread, NULL, TRUE, NULL);
+	P_TEST_REQUIRE (thr != NULL);
+
+	p_time_profiler_reset (profiler);
+
+	P_TEST_REQUIRE (p_mutex_lock (cond_mutex) == TRUE);
+
+	while (timed_flag == FALSE && res != -1) {
+		if ((res = p_cond_variable_wait_timed (timed_cond, cond_mutex, 10000)) == 0)
+			break;
+	}
+
+	P_TEST_CHECK (res == 1);
+	P_TEST_CHECK (timed_flag == TRUE);
+	P_TEST_REQUIRE (p_mutex_unlock (cond_mutex) == TRUE);
+
+	P_TEST_CHECK (p_time_profiler_elapsed_usecs (profiler) < 10000 * 1000);
+
+	p_uthread_join (thr);
+	p_uthread_unref (thr);
+
+	p_time_profiler_free (profiler);
+	p_cond_variable_free (timed_cond);
+	p_mutex_free (cond_mutex);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pcondvariable_deadline_test)
+{
+	PTimeProfiler	*profiler;
+	PUThread	*thr;
+	PDeadline	deadline;
+	pint		res = 0;
+
+	p_libsys_init ();
+
+	timed_cond = p_cond_variable_new ();
+	P_TEST_REQUIRE (timed_cond != NULL);
+	cond_mutex = p_mutex_new ();
+	P_TEST_REQUIRE (cond_mutex != NULL);
+	profiler = p_time_profiler_new ();
+	P_TEST_REQUIRE (profiler != NULL);
+
+	p_deadline_init_msecs (&deadline, 0);
+
+	P_TEST_CHECK (p_cond_variable_wait_until (NULL, cond_mutex, &deadline) == -1);
+	P_TEST_CHECK (p_cond_variable_wait_until (timed_cond, NULL, &deadline) == -1);
+
+	P_TEST_REQUIRE (p_mutex_lock (cond_mutex) == TRUE);
+
+	/* Expired deadline doesn't block */
+	P_TEST_CHECK (p_cond_variable_wait_until (timed_cond, cond_mutex, &deadline) == 0);
+
+	/* Waits across spurious wakeups keep the original deadline */
+	p_deadline_init_msecs (&deadline, 100);
+	p_time_profiler_reset (profiler);
+
+	while ((res = p_cond_variable_wait_until (timed_cond, cond_mutex, &deadline)) == 1)
+		;
+
+	P_TEST_CHECK (res == 0);
+	P_TEST_CHECK (p_time_profiler_elapsed_usecs (profiler) >= 80 * 1000);
+	P_TEST_CHECK (p_deadline_has_expired (&deadline) == TRUE);
+
+	P_TEST_REQUIRE (p_mutex_unlock (cond_mutex) == TRUE);
+
+	/* Signal must arrive before the deadline */
+	timed_flag = FALSE;
+
+	thr = p_uthread_create ((PUThreadFunc) timed_signal_thread, NULL, TRUE, NULL);
+	P_TEST_REQUIRE (thr != NULL);
+
+	p_deadline_init_msecs (&deadline, 10000);
+
+	P_TEST_REQUIRE (p_mutex_lock (cond_mutex) == TRUE);
+
+	while (timed_flag == FALSE) {
+		if ((res = p_cond_variable_wait_until (timed_cond, cond_mutex, &deadline)) != 1)
+			break;
+	}
+
+	P_TEST_CHECK (res == 1);
+	P_TEST_CHECK (timed_flag == TRUE);
+	P_TEST_CHECK (p_deadline_has_expired (&deadline) == FALSE);
+	P_TEST_REQUIRE (p_mutex_unlock (cond_mutex) == TRUE);
+
+	p_uthread_join (thr);
+	p_uthread_unref (thr);
+
+	p_time_profiler_free (profiler);
+	p_cond_variable_free (timed_cond);
+	p_mutex_free (cond_mutex);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
 P_TEST_SUITE_BEGIN()
 {
 	P_TEST_SUITE_RUN_CASE (pcondvariable_nomem_test);
 	P_TEST_SUITE_RUN_CASE (pcondvariable_bad_input_test);
 	P_TEST_SUITE_RUN_CASE (pcondvariable_general_test);
+	P_TEST_SUITE_RUN_CASE (pcondvariable_timed_test);
+	P_TEST_SUITE_RUN_CASE (pcondvariable_deadline_test);
 }
 P_TEST_SUITE_END()
@@ -0,0 +1,264 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+P_TEST_MODULE_INIT ();
+
+#define PCOUNTDOWNLATCH_THREADS	4
+
+static PCountDownLatch *	latch_test    = NULL;
+static volatile pint		latch_done    = 0;
+static volatile pint		latch_passed  = 0;
+static PCountDownLatch * volatile	latch_slot    = NULL;
+static volatile pint		latch_stop    = 0;
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static void * latch_worker_thread (void *)
+{
+	p_uthread_sleep (20);
+	p_atomic_int_inc (&latch_done);
+	p_count_down_latch_count_down (latch_test);
+
+	return NULL;
+}
+
+static void * latch_waiter_thread (void *)
+{
+	if (p_count_down_latch_wait (latch_test) == TRUE &&
+	    p_atomic_int_get (&latch_done) == PCOUNTDOWNLATCH_THREADS)
+		p_atomic_int_inc (&latch_passed);
+
+	return NULL;
+}
+
+static void * latch_free_thread (void *)
+{
+	PCountDownLatch *latch;
+
+	while (p_atomic_int_get (&latch_stop) == 0) {
+		if ((latch = (PCountDownLatch *) p_atomic_pointer_get (&latch_slot)) == NULL) {
+			p_uthread_yield ();
+			continue;
+		}
+
+		p_atomic_pointer_set (&latch_slot, NULL);
+		p_count_down_latch_count_down (latch);
+	}
+
+	return NULL;
+}
+
+static void latch_run_workers (pint spin_count)
+{
+	PUThread	*workers[PCOUNTDOWNLATCH_THREADS];
+	PUThread	*waiters[PCOUNTDOWNLATCH_THREADS];
+	pint		i;
+
+	latch_test = p_count_down_latch_new (PCOUNTDOWNLATCH_THREADS, spin_count);
+	P_TEST_REQUIRE (latch_test != NULL);
+
+	p_atomic_int_set (&latch_done, 0);
+	p_atomic_int_set (&latch_passed, 0);
+
+	for (i = 0; i < PCOUNTDOWNLATCH_THREADS; ++i) {
+		waiters[i] = p_uthread_create ((PUThreadFunc) latch_waiter_thread, NULL, TRUE, NULL);
+		P_TEST_REQUIRE (waiters[i] != NULL);
+	}
+
+	for (i = 0; i < PCOUNTDOWNLATCH_THREADS; ++i) {
+		workers[i] = p_uthread_create ((PUThreadFunc) latch_worker_thread, NULL, TRUE, NULL);
+		P_TEST_REQUIRE (workers[i] != NULL);
+	}
+
+	P_TEST_CHECK (p_count_down_latch_wait (latch_test) == TRUE);
+	P_TEST_CHECK (p_atomic_int_get (&latch_done) == PCOUNTDOWNLATCH_THREADS);
+	P_TEST_CHECK (p_count_down_latch_try_wait (latch_test) == TRUE);
+	P_TEST_CHECK (p_count_down_latch_get_count (latch_test) == 0);
+
+	for (i = 0; i < PCOUNTDOWNLATCH_THREADS; ++i) {
+		p_uthread_join (workers[i]);
+		p_uthread_join (waiters[i]);
+		p_uthread_unref (workers[i]);
+		p_uthread_unref (waiters[i]);
+	}
+
+	P_TEST_CHECK (p_atomic_int_get (&latch_passed) == PCOUNTDOWNLATCH_THREADS);
+
+	p_count_down_latch_free (latch_test);
+	latch_test = NULL;
+}
+
+P_TEST_CASE_BEGIN (pcountdownlatch_nomem_test)
+{
+	p_libsys_init ();
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (p_count_down_latch_new (1, 0) == NULL);
+
+	p_mem_restore_vtable ();
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pcountdownlatch_bad_input_test)
+{
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_count_down_latch_new (-1, 0) == NULL);
+	P_TEST_CHECK (p_count_down_latch_new (1, -1) == NULL);
+	P_TEST_CHECK (p_count_down_latch_wait (NULL) == FALSE);
+	P_TEST_CHECK (p_count_down_latch_try_wait (NULL) == FALSE);
+	P_TEST_CHECK (p_count_down_latch_get_count (NULL) == 0);
+	p_count_down_latch_count_down (NULL);
+	p_count_down_latch_free (NULL);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pcountdownlatch_general_test)
+{
+	PCountDownLatch *latch;
+
+	p_libsys_init ();
+
+	/* Zero count latch is open from the start */
+	latch = p_count_down_latch_new (0, 0);
+	P_TEST_REQUIRE (latch != NULL);
+	P_TEST_CHECK (p_count_down_latch_try_wait (latch) == TRUE);
+	P_TEST_CHECK (p_count_down_latch_wait (latch) == TRUE);
+	p_count_down_latch_free (latch);
+
+	latch = p_count_down_latch_new (2, 0);
+	P_TEST_REQUIRE (latch != NULL);
+	P_TEST_CHECK (p_count_down_latch_get_count (latch) == 2);
+	P_TEST_CHECK (p_count_down_latch_try_wait (latch) == FALSE);
+
+	p_count_down_latch_count_down (latch);
+	P_TEST_CHECK (p_count_down_latch_get_count (latch) == 1);
+	P_TEST_CHECK (p_count_down_latch_try_wait (latch) == FALSE);
+
+	p_count_down_latch_count_down (latch);
+	P_TEST_CHECK (p_count_down_latch_get_count (latch) == 0);
+	P_TEST_CHECK (p_count_down_latch_wait (latch) == TRUE);
+
+	/* Count never goes below zero */
+	p_count_down_latch_count_down (latch);
+	P_TEST_CHECK (p_count_down_latch_get_count (latch) == 0);
+	P_TEST_CHECK (p_count_down_latch_try_wait (latch) == TRUE);
+
+	p_count_down_latch_free (latch);
+
+	latch_run_workers (0);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pcountdownlatch_spin_test)
+{
+	p_libsys_init ();
+
+	latch_run_workers (1000);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+/* The waiter frees the latch at once, while the counting down thread may not
+ * have returned yet */
+P_TEST_CASE_BEGIN (pcountdownlatch_free_test)
+{
+	PCountDownLatch	*latch;
+	PUThread	*thr;
+	pint		i;
+
+	p_libsys_init ();
+
+	p_atomic_int_set (&latch_stop, 0);
+
+	thr = p_uthread_create ((PUThreadFunc) latch_free_thread, NULL, TRUE, NULL);
+	P_TEST_REQUIRE (thr != NULL);
+
+	for (i = 0; i < 2000; ++i) {
+		latch = p_count_down_latch_new (1, i % 2 == 0 ? 0 : 100000);
+		P_TEST_REQUIRE (latch != NULL);
+
+		p_atomic_pointer_set (&latch_slot, latch);
+
+		if (i % 3 == 0) {
+			while (p_count_down_latch_try_wait (latch) == FALSE)
+				p_uthread_yield ();
+		} else
+			P_TEST_CHECK (p_count_down_latch_wait (latch) == TRUE);
+
+		p_count_down_latch_free (latch);
+	}
+
+	p_atomic_int_set (&latch_stop, 1);
+
+	p_uthread_join (thr);
+	p_uthread_unref (thr);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pcountdownlatch_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pcountdownlatch_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (pcountdownlatch_general_test);
+	P_TEST_SUITE_RUN_CASE (pcountdownlatch_spin_test);
+	P_TEST_SUITE_RUN_CASE (pcountdownlatch_free_test);
+}
+P_TEST_SUITE_END()
@@ -0,0 +1,190 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+P_TEST_MODULE_INIT ();
+
+#define PCOUNTER_THREADS	4
+#define PCOUNTER_ROUNDS		100000
+
+static PCounter *	global_counter = NULL;
+static volatile pint	counter_done   = 0;
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static void * counter_thread (void *)
+{
+	pint i;
+
+	for (i = 0; i < PCOUNTER_ROUNDS; ++i) {
+		p_counter_inc (global_counter);
+		p_counter_add (global_counter, 2);
+		p_counter_add (global_counter, -1);
+	}
+
+	p_atomic_int_inc (&counter_done);
+
+	p_uthread_exit (0);
+
+	return NULL;
+}
+
+P_TEST_CASE_BEGIN (pcounter_nomem_test)
+{
+	p_libsys_init ();
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+	P_TEST_CHECK (p_counter_new (0) == NULL);
+
+	p_mem_restore_vtable ();
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pcounter_bad_input_test)
+{
+	p_libsys_init ();
+
+	p_counter_add (NULL, 1);
+	p_counter_inc (NULL);
+	P_TEST_CHECK (p_counter_get (NULL) == 0);
+	P_TEST_CHECK (p_counter_reset (NULL) == 0);
+	p_counter_free (NULL);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pcounter_general_test)
+{
+	PCounter *counter;
+
+	p_libsys_init ();
+
+	counter = p_counter_new (1000);
+	P_TEST_REQUIRE (counter != NULL);
+	p_counter_free (counter);
+
+	counter = p_counter_new (3);
+	P_TEST_REQUIRE (counter != NULL);
+	P_TEST_CHECK (p_counter_get (counter) == 0);
+
+	p_counter_inc (counter);
+	p_counter_add (counter, 10);
+	p_counter_add (counter, -3);
+	P_TEST_CHECK (p_counter_get (counter) == 8);
+
+	/* Beyond 32 bits */
+	p_counter_add (counter, P_MAXINT32);
+	p_counter_add (counter, P_MAXINT32);
+	P_TEST_CHECK (p_counter_get (counter) == (pint64) P_MAXINT32 * 2 + 8);
+
+	P_TEST_CHECK (p_counter_reset (counter) == (pint64) P_MAXINT32 * 2 + 8);
+	P_TEST_CHECK (p_counter_get (counter) == 0);
+	P_TEST_CHECK (p_counter_reset (counter) == 0);
+
+	p_counter_add (counter, -5);
+	P_TEST_CHECK (p_counter_get (counter) == -5);
+
+	p_counter_free (counter);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pcounter_thread_test)
+{
+	PUThread	*thr[PCOUNTER_THREADS];
+	pint64		taken;
+	pint		i;
+
+	p_libsys_init ();
+
+	global_counter = p_counter_new (0);
+	P_TEST_REQUIRE (global_counter != NULL);
+
+	p_atomic_int_set (&counter_done, 0);
+
+	for (i = 0; i < PCOUNTER_THREADS; ++i) {
+		thr[i] = p_uthread_create ((PUThreadFunc) counter_thread, NULL, TRUE, NULL);
+		P_TEST_REQUIRE (thr[i] != NULL);
+	}
+
+	/* Periodic resets must not lose any update */
+	taken = 0;
+
+	while (p_atomic_int_get (&counter_done) < PCOUNTER_THREADS) {
+		taken += p_counter_reset (global_counter);
+		p_uthread_yield ();
+	}
+
+	for (i = 0; i < PCOUNTER_THREADS; ++i) {
+		P_TEST_CHECK (p_uthread_join (thr[i]) == 0);
+		p_uthread_unref (thr[i]);
+	}
+
+	taken += p_counter_get (global_counter);
+
+	P_TEST_CHECK (taken == (pint64) PCOUNTER_THREADS * PCOUNTER_ROUNDS * 2);
+
+	p_counter_free (global_counter);
+	global_counter = NULL;
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pcounter_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pcounter_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (pcounter_general_test);
+	P_TEST_SUITE_RUN_CASE (pcounter_thread_test);
+}
+P_TEST_SUITE_END()
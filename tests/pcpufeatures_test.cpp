@@ -0,0 +1,111 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+P_TEST_MODULE_INIT ();
+
+static const PCpuFeature pp_x86_features[] = {
+	P_CPU_FEATURE_BMI,
+	P_CPU_FEATURE_INVARIANT_TSC,
+	P_CPU_FEATURE_RDTSCP,
+	P_CPU_FEATURE_SSE2,
+	P_CPU_FEATURE_SSSE3,
+	P_CPU_FEATURE_SSE4_1,
+	P_CPU_FEATURE_SSE4_2,
+	P_CPU_FEATURE_POPCNT,
+	P_CPU_FEATURE_AVX,
+	P_CPU_FEATURE_AVX2,
+	P_CPU_FEATURE_AVX512F
+};
+
+static const PCpuFeature pp_arm_features[] = {
+	P_CPU_FEATURE_NEON,
+	P_CPU_FEATURE_SHA3,
+	P_CPU_FEATURE_ATOMICS
+};
+
+P_TEST_CASE_BEGIN (pcpufeatures_general_test)
+{
+	puint32	features;
+	puint32	collected = 0;
+	pint	i;
+
+	p_libsys_init ();
+
+	features = p_cpu_get_features ();
+
+	for (i = 0; i < 32; ++i) {
+		if (p_cpu_has_feature ((PCpuFeature) (1U << i)) == TRUE)
+			collected |= 1U << i;
+	}
+
+	P_TEST_CHECK (collected == features);
+	P_TEST_CHECK (p_cpu_get_features () == features);
+
+	/* Unknown bits are never reported */
+	P_TEST_CHECK ((features & ~((puint32) P_CPU_FEATURE_ATOMICS * 2 - 1)) == 0);
+
+	/* Wider vectors can't be usable without the narrower ones */
+	if (p_cpu_has_feature (P_CPU_FEATURE_AVX2) == TRUE)
+		P_TEST_CHECK (p_cpu_has_feature (P_CPU_FEATURE_AVX) == TRUE);
+
+	if (p_cpu_has_feature (P_CPU_FEATURE_AVX512F) == TRUE)
+		P_TEST_CHECK (p_cpu_has_feature (P_CPU_FEATURE_AVX) == TRUE);
+
+	if (p_cpu_has_feature (P_CPU_FEATURE_AVX) == TRUE)
+		P_TEST_CHECK (p_cpu_has_feature (P_CPU_FEATURE_SSE2) == TRUE);
+
+#if defined (P_CPU_X86_64)
+	P_TEST_CHECK (p_cpu_has_feature (P_CPU_FEATURE_SSE2) == TRUE);
+#endif
+
+#if defined (P_CPU_ARM_64) && (defined (__ARM_NEON) || defined (__ARM_NEON__))
+	P_TEST_CHECK (p_cpu_has_feature (P_CPU_FEATURE_NEON) == TRUE);
+#endif
+
+#if !defined (P_CPU_X86_32) && !defined (P_CPU_X86_64)
+	for (i = 0; i < (pint) (sizeof (pp_x86_features) / sizeof (pp_x86_features[0])); ++i)
+		P_TEST_CHECK (p_cpu_has_feature (pp_x86_features[i]) == FALSE);
+#endif
+
+#if !defined (P_CPU_ARM)
+	for (i = 0; i < (pint) (sizeof (pp_arm_features) / sizeof (pp_arm_features[0])); ++i)
+		P_TEST_CHECK (p_cpu_has_feature (pp_arm_features[i]) == FALSE);
+#endif
+
+	P_UNUSED (pp_x86_features);
+	P_UNUSED (pp_arm_features);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pcpufeatures_general_test);
+}
+P_TEST_SUITE_END()
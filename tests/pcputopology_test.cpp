@@ -0,0 +1,257 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+P_TEST_MODULE_INIT ();
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+P_TEST_CASE_BEGIN (pcputopology_nomem_test)
+{
+	p_libsys_init ();
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (p_cpu_topology_new () == NULL);
+
+	p_mem_restore_vtable ();
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pcputopology_bad_input_test)
+{
+	PCpuTopology	*topology;
+	PUThreadCpuSet	cpu_set;
+
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_cpu_topology_get_cpu_count (NULL) == -1);
+	P_TEST_CHECK (p_cpu_topology_get_core_count (NULL) == -1);
+	P_TEST_CHECK (p_cpu_topology_get_package_count (NULL) == -1);
+	P_TEST_CHECK (p_cpu_topology_get_numa_node_count (NULL) == -1);
+	P_TEST_CHECK (p_cpu_topology_get_cache_size (NULL, 1) == 0);
+	P_TEST_CHECK (p_cpu_topology_get_cache_line_size (NULL) == 0);
+	P_TEST_CHECK (p_cpu_topology_get_cpu_core (NULL, 0) == -1);
+	P_TEST_CHECK (p_cpu_topology_get_cpu_package (NULL, 0) == -1);
+	P_TEST_CHECK (p_cpu_topology_get_cpu_numa_node (NULL, 0) == -1);
+	P_TEST_CHECK (p_cpu_topology_get_core_cpus (NULL, 0, &cpu_set) == FALSE);
+	P_TEST_CHECK (p_cpu_topology_get_numa_node_cpus (NULL, 0, &cpu_set) == FALSE);
+	P_TEST_CHECK (p_cpu_topology_get_cache_cpus (NULL, 0, 1, &cpu_set) == FALSE);
+
+	p_cpu_topology_free (NULL);
+
+	topology = p_cpu_topology_new ();
+	P_TEST_REQUIRE (topology != NULL);
+
+	P_TEST_CHECK (p_cpu_topology_get_cache_size (topology, 0) == 0);
+	P_TEST_CHECK (p_cpu_topology_get_cache_size (topology, P_CPU_TOPOLOGY_MAX_CACHE_LEVEL + 1) == 0);
+	P_TEST_CHECK (p_cpu_topology_get_cpu_core (topology, -1) == -1);
+	P_TEST_CHECK (p_cpu_topology_get_cpu_core (topology, P_UTHREAD_CPU_SET_SIZE) == -1);
+	P_TEST_CHECK (p_cpu_topology_get_cpu_package (topology, -1) == -1);
+	P_TEST_CHECK (p_cpu_topology_get_cpu_numa_node (topology, P_UTHREAD_CPU_SET_SIZE) == -1);
+	P_TEST_CHECK (p_cpu_topology_get_core_cpus (topology, 0, NULL) == FALSE);
+	P_TEST_CHECK (p_cpu_topology_get_core_cpus (topology, -1, &cpu_set) == FALSE);
+	P_TEST_CHECK (p_uthread_cpu_set_count (&cpu_set) == 0);
+	P_TEST_CHECK (p_cpu_topology_get_numa_node_cpus (topology, 0, NULL) == FALSE);
+	P_TEST_CHECK (p_cpu_topology_get_numa_node_cpus (topology, -1, &cpu_set) == FALSE);
+	P_TEST_CHECK (p_cpu_topology_get_cache_cpus (topology, 0, 1, NULL) == FALSE);
+	P_TEST_CHECK (p_cpu_topology_get_cache_cpus (topology, -1, 1, &cpu_set) == FALSE);
+	P_TEST_CHECK (p_cpu_topology_get_cache_cpus (topology, 0, 0, &cpu_set) == FALSE);
+	P_TEST_CHECK (p_cpu_topology_get_cache_cpus (topology, 0, P_CPU_TOPOLOGY_MAX_CACHE_LEVEL + 1, &cpu_set) == FALSE);
+
+	p_cpu_topology_free (topology);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pcputopology_general_test)
+{
+	PCpuTopology	*topology;
+	PUThreadCpuSet	cpu_set;
+	pint		n_cpus;
+	pint		n_cores;
+	pint		n_packages;
+	pint		n_nodes;
+	pint		seen_cpus;
+	pint		seen_core_cpus;
+	pint		seen_node_cpus;
+	pint		cpu;
+	pint		i;
+
+	p_libsys_init ();
+
+	topology = p_cpu_topology_new ();
+	P_TEST_REQUIRE (topology != NULL);
+
+	n_cpus     = p_cpu_topology_get_cpu_count (topology);
+	n_cores    = p_cpu_topology_get_core_count (topology);
+	n_packages = p_cpu_topology_get_package_count (topology);
+	n_nodes    = p_cpu_topology_get_numa_node_count (topology);
+
+	P_TEST_CHECK (n_cpus >= 1);
+	P_TEST_CHECK (n_cores >= 1 && n_cores <= n_cpus);
+	P_TEST_CHECK (n_packages >= 1 && n_packages <= n_cores);
+	P_TEST_CHECK (n_nodes >= 1 && n_nodes <= n_cpus);
+
+	/* Detected once and then cached */
+	P_TEST_CHECK (p_cpu_topology_detect_cache_line_size () > 0);
+	P_TEST_CHECK (p_cpu_topology_detect_cache_line_size () == p_cpu_topology_detect_cache_line_size ());
+
+	if (p_cpu_topology_get_cache_line_size (topology) > 0)
+		P_TEST_CHECK (p_cpu_topology_detect_cache_line_size () == p_cpu_topology_get_cache_line_size (topology));
+
+	/* A line never exceeds the cache holding it */
+	if (p_cpu_topology_get_cache_line_size (topology) > 0 && p_cpu_topology_get_cache_size (topology, 1) > 0)
+		P_TEST_CHECK (p_cpu_topology_get_cache_line_size (topology) <= p_cpu_topology_get_cache_size (topology, 1));
+
+	seen_cpus      = 0;
+	seen_core_cpus = 0;
+	seen_node_cpus = 0;
+
+	for (cpu = 0; cpu < P_UTHREAD_CPU_SET_SIZE; ++cpu) {
+		if (p_cpu_topology_get_cpu_package (topology, cpu) < 0) {
+			P_TEST_CHECK (p_cpu_topology_get_cpu_core (topology, cpu) == -1);
+			P_TEST_CHECK (p_cpu_topology_get_cpu_numa_node (topology, cpu) == -1);
+			continue;
+		}
+
+		++seen_cpus;
+
+		P_TEST_CHECK (p_cpu_topology_get_cpu_package (topology, cpu) < n_packages);
+		P_TEST_CHECK (p_cpu_topology_get_cpu_core (topology, cpu) >= 0);
+		P_TEST_CHECK (p_cpu_topology_get_cpu_core (topology, cpu) < n_cores);
+		P_TEST_CHECK (p_cpu_topology_get_cpu_numa_node (topology, cpu) >= 0);
+
+		/* SMT siblings share the package */
+		P_TEST_CHECK (p_cpu_topology_get_core_cpus (topology,
+							    p_cpu_topology_get_cpu_core (topology, cpu),
+							    &cpu_set) == TRUE);
+		P_TEST_CHECK (p_uthread_cpu_set_contains (&cpu_set, cpu) == TRUE);
+
+		for (i = 0; i < P_UTHREAD_CPU_SET_SIZE; ++i)
+			if (p_uthread_cpu_set_contains (&cpu_set, i) == TRUE)
+				P_TEST_CHECK (p_cpu_topology_get_cpu_package (topology, i) ==
+					      p_cpu_topology_get_cpu_package (topology, cpu));
+
+		P_TEST_CHECK (p_cpu_topology_get_numa_node_cpus (topology,
+								 p_cpu_topology_get_cpu_numa_node (topology, cpu),
+								 &cpu_set) == TRUE);
+		P_TEST_CHECK (p_uthread_cpu_set_contains (&cpu_set, cpu) == TRUE);
+
+		for (i = 1; i <= P_CPU_TOPOLOGY_MAX_CACHE_LEVEL; ++i)
+			if (p_cpu_topology_get_cache_cpus (topology, cpu, i, &cpu_set) == TRUE)
+				P_TEST_CHECK (p_uthread_cpu_set_contains (&cpu_set, cpu) == TRUE);
+	}
+
+	P_TEST_CHECK (seen_cpus == n_cpus);
+
+	/* Every CPU belongs to exactly one core and one node */
+	for (i = 0; i < n_cores; ++i) {
+		P_TEST_CHECK (p_cpu_topology_get_core_cpus (topology, i, &cpu_set) == TRUE);
+		seen_core_cpus += p_uthread_cpu_set_count (&cpu_set);
+	}
+
+	for (i = 0; i < P_UTHREAD_CPU_SET_SIZE; ++i)
+		if (p_cpu_topology_get_numa_node_cpus (topology, i, &cpu_set) == TRUE)
+			seen_node_cpus += p_uthread_cpu_set_count (&cpu_set);
+
+	P_TEST_CHECK (seen_core_cpus == n_cpus);
+	P_TEST_CHECK (seen_node_cpus == n_cpus);
+
+	P_TEST_CHECK (p_cpu_topology_get_core_cpus (topology, n_cores, &cpu_set) == FALSE);
+
+	p_cpu_topology_free (topology);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pcputopology_affinity_test)
+{
+	PCpuTopology	*topology;
+	PUThreadCpuSet	cpu_set;
+	pint		cpu;
+
+	p_libsys_init ();
+
+	topology = p_cpu_topology_new ();
+	P_TEST_REQUIRE (topology != NULL);
+
+	cpu = p_uthread_current_cpu ();
+
+	/* The current CPU is known when the platform reports it */
+	if (cpu >= 0 && p_cpu_topology_get_cpu_package (topology, cpu) >= 0) {
+		P_TEST_CHECK (p_cpu_topology_get_core_cpus (topology,
+							    p_cpu_topology_get_cpu_core (topology, cpu),
+							    &cpu_set) == TRUE);
+
+		if (p_uthread_set_affinity (p_uthread_current (), &cpu_set) == TRUE) {
+			cpu = p_uthread_current_cpu ();
+
+			P_TEST_CHECK (p_uthread_cpu_set_contains (&cpu_set, cpu) == TRUE);
+		}
+	}
+
+	p_cpu_topology_free (topology);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pcputopology_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pcputopology_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (pcputopology_general_test);
+	P_TEST_SUITE_RUN_CASE (pcputopology_affinity_test);
+}
+P_TEST_SUITE_END()
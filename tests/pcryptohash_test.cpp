@@ -26,12 +26,24 @@
 #include "plibsys.h"
 #include "ptestmacros.h"
 
+#include <stdio.h>
 #include <string.h>
 
+#ifdef P_OS_UNIX
+#  include <sys/types.h>
+#  include <sys/stat.h>
+#endif
+
 P_TEST_MODULE_INIT ();
 
 #define PCRYPTO_STRESS_LENGTH	10000
 #define PCRYPTO_MAX_UPDATES	1000000
+#define PCRYPTO_MANY_COUNT	203
+#define PCRYPTO_MANY_MAX_LENGTH	300
+#define PCRYPTO_BLAKE3_LENGTH	(3 * 1024 * 1024 + 517)
+#define PCRYPTO_FILE_LENGTH	(9 * 1024 * 1024 + 1234)
+#define PCRYPTO_FILE_NAME	"." P_DIR_SEPARATOR "pcryptohash_test_file.bin"
+#define PCRYPTO_FIFO_NAME	"." P_DIR_SEPARATOR "pcryptohash_test_fifo"
 
 extern "C" ppointer pmem_alloc (psize nbytes)
 {
@@ -168,6 +180,21 @@ general_hash_test (PCryptoHashType	type,
 
 	p_crypto_hash_reset (crypto_hash);
 
+	/* Uneven chunks mix the buffered and the bulk block paths */
+	for (psize pos = 0, chunk = 1; pos < PCRYPTO_STRESS_LENGTH; pos += chunk, chunk = chunk * 7 % 193 + 1) {
+		if (pos + chunk > PCRYPTO_STRESS_LENGTH)
+			chunk = PCRYPTO_STRESS_LENGTH - pos;
+
+		p_crypto_hash_update (crypto_hash, (const puchar *) long_str + pos, chunk);
+	}
+
+	hash_str = p_crypto_hash_get_string (crypto_hash);
+
+	P_TEST_CHECK (strcmp (hash_str, hash_stress) == 0);
+	p_free (hash_str);
+
+	p_crypto_hash_reset (crypto_hash);
+
 	p_free (long_str);
 	p_free (hash_dig);
 	p_crypto_hash_free (crypto_hash);
@@ -189,6 +216,22 @@ P_TEST_CASE_BEGIN (pcryptohash_nomem_test)
 	P_TEST_CHECK (p_crypto_hash_new (P_CRYPTO_HASH_TYPE_SHA1) == NULL);
 	P_TEST_CHECK (p_crypto_hash_new (P_CRYPTO_HASH_TYPE_GOST) == NULL);
 
+	const puchar	*input  = (const puchar *) "abc";
+	psize		len     = 3;
+	puchar		digest[32];
+
+	/* Nothing below needs the heap */
+	P_TEST_CHECK (p_crypto_hash_compute_many (P_CRYPTO_HASH_TYPE_GOST, &input, &len, 1, digest) == TRUE);
+	P_TEST_CHECK (p_crypto_hash_compute (P_CRYPTO_HASH_TYPE_GOST, input, len, digest) == TRUE);
+	P_TEST_CHECK (p_crypto_hash_compute (P_CRYPTO_HASH_TYPE_BLAKE3, input, len, digest) == TRUE);
+
+	puint64 storage[P_CRYPTO_HASH_MAX_CONTEXT_SIZE / sizeof (puint64)];
+
+	PCryptoHash *hash = p_crypto_hash_init_in_place (P_CRYPTO_HASH_TYPE_SHA3_512, storage, sizeof (storage));
+	P_TEST_CHECK (hash != NULL);
+	P_TEST_CHECK (p_crypto_hash_copy (hash) == NULL);
+	p_crypto_hash_free (hash);
+
 	p_mem_restore_vtable ();
 
 	p_libsys_shutdown ();
@@ -209,6 +252,7 @@ P_TEST_CASE_BEGIN (pcryptohash_invalid_test)
 	P_TEST_CHECK (p_crypto_hash_get_length (NULL) == 0);
 	P_TEST_CHECK (p_crypto_hash_get_string (NULL) == NULL);
 	P_TEST_CHECK ((pint) p_crypto_hash_get_type (NULL) == -1);
+	P_TEST_CHECK (p_crypto_hash_copy (NULL) == NULL);
 	p_crypto_hash_free (NULL);
 
 	p_crypto_hash_update (NULL, NULL, 0);
@@ -219,6 +263,32 @@ P_TEST_CASE_BEGIN (pcryptohash_invalid_test)
 
 	p_crypto_hash_reset (NULL);
 
+	const puchar	*input = NULL;
+	psize		in_len = 1;
+	puchar		digest[16];
+
+	P_TEST_CHECK (p_crypto_hash_compute_many ((PCryptoHashType) -1, &input, &in_len, 1, digest) == FALSE);
+	P_TEST_CHECK (p_crypto_hash_compute_many (P_CRYPTO_HASH_TYPE_MD5, NULL, &in_len, 1, digest) == FALSE);
+	P_TEST_CHECK (p_crypto_hash_compute_many (P_CRYPTO_HASH_TYPE_MD5, &input, NULL, 1, digest) == FALSE);
+	P_TEST_CHECK (p_crypto_hash_compute_many (P_CRYPTO_HASH_TYPE_MD5, &input, &in_len, 1, NULL) == FALSE);
+	P_TEST_CHECK (p_crypto_hash_compute_many (P_CRYPTO_HASH_TYPE_MD5, &input, &in_len, 1, digest) == FALSE);
+	P_TEST_CHECK (p_crypto_hash_compute_many (P_CRYPTO_HASH_TYPE_MD5, NULL, NULL, 0, NULL) == TRUE);
+
+	in_len = 0;
+	P_TEST_CHECK (p_crypto_hash_compute_many (P_CRYPTO_HASH_TYPE_MD5, &input, &in_len, 1, digest) == TRUE);
+
+	puint64 storage[P_CRYPTO_HASH_MAX_CONTEXT_SIZE / sizeof (puint64)];
+
+	P_TEST_CHECK (p_crypto_hash_init_in_place ((PCryptoHashType) -1, storage, sizeof (storage)) == NULL);
+	P_TEST_CHECK (p_crypto_hash_init_in_place (P_CRYPTO_HASH_TYPE_MD5, NULL, sizeof (storage)) == NULL);
+	P_TEST_CHECK (p_crypto_hash_init_in_place (P_CRYPTO_HASH_TYPE_MD5, storage, 0) == NULL);
+	P_TEST_CHECK (p_crypto_hash_init_in_place (P_CRYPTO_HASH_TYPE_SHA3_512, storage, 128) == NULL);
+
+	P_TEST_CHECK (p_crypto_hash_compute ((PCryptoHashType) -1, input, 0, digest) == FALSE);
+	P_TEST_CHECK (p_crypto_hash_compute (P_CRYPTO_HASH_TYPE_MD5, NULL, 1, digest) == FALSE);
+	P_TEST_CHECK (p_crypto_hash_compute (P_CRYPTO_HASH_TYPE_MD5, NULL, 0, NULL) == FALSE);
+	P_TEST_CHECK (p_crypto_hash_compute (P_CRYPTO_HASH_TYPE_MD5, NULL, 0, digest) == TRUE);
+
 	hash = p_crypto_hash_new (P_CRYPTO_HASH_TYPE_MD5);
 	P_TEST_CHECK (hash != NULL);
 
@@ -245,6 +315,20 @@ P_TEST_CASE_BEGIN (pcryptohash_invalid_test)
 	P_TEST_CHECK (strcmp (hash_str, "900150983cd24fb0d6963f7d28e17f72") == 0);
 	p_free (hash_str);
 
+	pchar hex[P_CRYPTO_HASH_MAX_DIGEST_SIZE * 2 + 1];
+
+	P_TEST_CHECK (p_crypto_hash_get_string_into (NULL, hex, sizeof (hex)) == FALSE);
+	P_TEST_CHECK (p_crypto_hash_get_string_into (hash, NULL, sizeof (hex)) == FALSE);
+	P_TEST_CHECK (p_crypto_hash_get_string_into (hash, hex, (psize) md5_len * 2) == FALSE);
+	P_TEST_CHECK (p_crypto_hash_get_string_into (hash, hex, (psize) md5_len * 2 + 1) == TRUE);
+	P_TEST_CHECK (strcmp (hex, "900150983cd24fb0d6963f7d28e17f72") == 0);
+
+	p_crypto_hash_reset (hash);
+	p_crypto_hash_update (hash, (const puchar *) ("abc"), 3);
+	memset (hex, 0, sizeof (hex));
+	P_TEST_CHECK (p_crypto_hash_get_string_into (hash, hex, sizeof (hex)) == TRUE);
+	P_TEST_CHECK (strcmp (hex, "900150983cd24fb0d6963f7d28e17f72") == 0);
+
 	p_crypto_hash_free (hash);
 	p_free (buf);
 
@@ -643,6 +727,548 @@ P_TEST_CASE_BEGIN (gost3411_94_test)
 }
 P_TEST_CASE_END ()
 
+P_TEST_CASE_BEGIN (blake2b_test)
+{
+	const puchar	hash_etalon_1[] = {186, 128, 165,  63, 152,  28,  77,  13,
+					   106,  39, 151, 182, 159,  18, 246, 233,
+					    76,  33,  47,  20, 104,  90, 196, 183,
+					    75,  18, 187, 111, 219, 255, 162, 209,
+					   125, 135, 197,  57,  42, 171, 121,  45,
+					   194,  82, 213, 222,  69,  51, 204, 149,
+					    24, 211, 138, 168, 219, 241, 146,  90,
+					   185,  35, 134, 237, 212,   0, 153,  35};
+	const puchar	hash_etalon_2[] = {114, 133, 255,  62, 139, 215, 104, 214,
+					   155, 230,  43,  59, 241, 135, 101, 163,
+					    37, 145, 127, 169, 116,  74, 194, 245,
+					   130, 162,   8,  80, 188,  43,  17,  65,
+					   237,  27,  62,  69,  40,  89,  90, 204,
+					   144, 119,  43, 223,  45,  55, 220, 138,
+					    71,  19,  11,  68, 243,  58,   2, 232,
+					   115,  14,  90, 216, 225, 102, 232, 136};
+	const puchar	hash_etalon_3[] = {152, 251,  62, 251, 114,   6, 253,  25,
+					   235, 246, 155, 111,  49,  44, 247, 182,
+					    78,  59, 148, 219, 225, 161, 113,   7,
+					   145,  57, 117, 167, 147, 241, 119, 225,
+					   208, 119,  96, 157, 127, 186,  54,  60,
+					   187, 160,  13,   5, 247, 170,  78,  79,
+					   168, 113,  93, 100,  40,  16,  76,  10,
+					   117, 100,  59,  15, 243, 253,  62, 175};
+
+	p_libsys_init ();
+
+	general_hash_test (P_CRYPTO_HASH_TYPE_BLAKE2B,
+			   64,
+			   "abc",
+			   "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+			   hash_etalon_1,
+			   hash_etalon_2,
+			   hash_etalon_3,
+			   "ba80a53f981c4d0d6a2797b69f12f6e94c212f14685ac4b74b12bb6fdbffa2d17d87c5392aab792dc252d5de4533cc9518d38aa8dbf1925ab92386edd4009923",
+			   "7285ff3e8bd768d69be62b3bf18765a325917fa9744ac2f582a20850bc2b1141ed1b3e4528595acc90772bdf2d37dc8a47130b44f33a02e8730e5ad8e166e888",
+			   "98fb3efb7206fd19ebf69b6f312cf7b64e3b94dbe1a17107913975a793f177e1d077609d7fba363cbba00d05f7aa4e4fa8715d6428104c0a75643b0ff3fd3eaf",
+			   "6846ed1bfcf01305e90dae4a182e911f2073702e251d99e27ba0ab9bdbc7ca8a2e388ebe033f1ddca6c491f7f210c90ddfa6cda72db19bc366880a2bcb01a1c5");
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (blake2s_test)
+{
+	const puchar	hash_etalon_1[] = { 80, 140,  94, 140,  50, 124,  20, 226,
+					   225, 167,  43, 163,  78, 235,  69,  47,
+					    55,  69, 139,  32, 158, 214,  58,  41,
+					    77, 153, 155,  76, 134, 103,  89, 130};
+	const puchar	hash_etalon_2[] = {111,  77, 245,  17, 106, 111,  51,  46,
+					   218, 177, 217, 225,  14, 232, 125, 246,
+					    85, 123, 234, 182,  37, 157, 118,  99,
+					   243, 188, 213, 114,  44,  19, 241, 137};
+	const puchar	hash_etalon_3[] = {190, 192, 192, 230, 205, 229, 182, 122,
+					   203, 115, 184,  31, 121, 166, 122,  64,
+					   121, 174,  28,  96, 218, 201, 210, 102,
+					    26, 241, 142, 159, 139,  80, 223, 165};
+
+	p_libsys_init ();
+
+	general_hash_test (P_CRYPTO_HASH_TYPE_BLAKE2S,
+			   32,
+			   "abc",
+			   "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+			   hash_etalon_1,
+			   hash_etalon_2,
+			   hash_etalon_3,
+			   "508c5e8c327c14e2e1a72ba34eeb452f37458b209ed63a294d999b4c86675982",
+			   "6f4df5116a6f332edab1d9e10ee87df6557beab6259d7663f3bcd5722c13f189",
+			   "bec0c0e6cde5b67acb73b81f79a67a4079ae1c60dac9d2661af18e9f8b50dfa5",
+			   "ba44fc1e4b8d3a6dbca1f0b17f715e0bdd16a1f269029156367d8325d77bd44d");
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (blake3_test)
+{
+	const puchar	hash_etalon_1[] = {100,  55, 179, 172,  56,  70,  81,  51,
+					   255, 182,  59, 117,  39,  58, 141, 181,
+					    72, 197,  88,  70,  93, 121, 219,   3,
+					   253,  53, 156, 108, 213, 189, 157, 133};
+	const puchar	hash_etalon_2[] = {193, 144,  18, 204,  42, 175,  13, 195,
+					   216, 229, 196,  90,  27, 121,  17,  77,
+					    45, 244,  42, 187,  42,  65,  11, 245,
+					    75, 224, 158, 137,  26, 240, 111, 248};
+	const puchar	hash_etalon_3[] = { 97, 111,  87,  90,  27,  88, 212, 201,
+					   121, 125,  66,  23, 185, 115,  10, 229,
+					   230, 235,  49, 157, 118, 237, 239, 101,
+					    73, 180, 111,  78, 254,  49, 255, 139};
+
+	p_libsys_init ();
+
+	general_hash_test (P_CRYPTO_HASH_TYPE_BLAKE3,
+			   32,
+			   "abc",
+			   "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+			   hash_etalon_1,
+			   hash_etalon_2,
+			   hash_etalon_3,
+			   "6437b3ac38465133ffb63b75273a8db548c558465d79db03fd359c6cd5bd9d85",
+			   "c19012cc2aaf0dc3d8e5c45a1b79114d2df42abb2a410bf54be09e891af06ff8",
+			   "616f575a1b58d4c9797d4217b9730ae5e6eb319d76edef6549b46f4efe31ff8b",
+			   "6c48eaa673f9fed5d3d8f9df4456ef9a2ef6cfc23588f6361b82175187ec5067");
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (blake3_thread_pool_test)
+{
+	PCryptoHash	*serial;
+	PCryptoHash	*parallel;
+	PThreadPool	*pool;
+	puchar		*data;
+	pchar		*serial_str;
+	pchar		*parallel_str;
+
+	p_libsys_init ();
+
+	data = (puchar *) p_malloc0 (PCRYPTO_BLAKE3_LENGTH);
+	P_TEST_REQUIRE (data != NULL);
+
+	for (psize i = 0; i < PCRYPTO_BLAKE3_LENGTH; ++i)
+		data[i] = (puchar) (i * 31 + (i >> 10));
+
+	pool = p_thread_pool_new (3);
+	P_TEST_REQUIRE (pool != NULL);
+
+	serial   = p_crypto_hash_new (P_CRYPTO_HASH_TYPE_BLAKE3);
+	parallel = p_crypto_hash_new (P_CRYPTO_HASH_TYPE_BLAKE3);
+
+	P_TEST_REQUIRE (serial != NULL && parallel != NULL);
+
+	P_TEST_CHECK (p_crypto_hash_set_thread_pool (NULL, pool) == FALSE);
+	P_TEST_CHECK (p_crypto_hash_set_thread_pool (parallel, pool) == TRUE);
+
+	/* Chunk by chunk updates never take the subtree paths */
+	for (psize pos = 0; pos < PCRYPTO_BLAKE3_LENGTH; pos += 1000)
+		p_crypto_hash_update (serial, data + pos, pos + 1000 > PCRYPTO_BLAKE3_LENGTH ? PCRYPTO_BLAKE3_LENGTH - pos : 1000);
+
+	serial_str = p_crypto_hash_get_string (serial);
+
+	/* Unaligned start splits the input into subtrees of different sizes */
+	p_crypto_hash_update (parallel, data, 3000);
+	p_crypto_hash_update (parallel, data + 3000, PCRYPTO_BLAKE3_LENGTH - 3000);
+
+	parallel_str = p_crypto_hash_get_string (parallel);
+
+	P_TEST_CHECK (strcmp (serial_str, parallel_str) == 0);
+	p_free (parallel_str);
+
+	/* Every update creates and frees a latch while the workers finish */
+	for (pint i = 0; i < 20; ++i) {
+		p_crypto_hash_reset (parallel);
+		p_crypto_hash_update (parallel, data, PCRYPTO_BLAKE3_LENGTH);
+
+		parallel_str = p_crypto_hash_get_string (parallel);
+
+		P_TEST_CHECK (strcmp (serial_str, parallel_str) == 0);
+		p_free (parallel_str);
+	}
+
+	p_crypto_hash_reset (parallel);
+	P_TEST_CHECK (p_crypto_hash_set_thread_pool (parallel, NULL) == TRUE);
+	p_crypto_hash_update (parallel, data, PCRYPTO_BLAKE3_LENGTH);
+
+	parallel_str = p_crypto_hash_get_string (parallel);
+
+	P_TEST_CHECK (strcmp (serial_str, parallel_str) == 0);
+	p_free (parallel_str);
+	p_free (serial_str);
+
+	/* Other types can't use a pool */
+	p_crypto_hash_free (serial);
+	serial = p_crypto_hash_new (P_CRYPTO_HASH_TYPE_BLAKE2B);
+	P_TEST_REQUIRE (serial != NULL);
+	P_TEST_CHECK (p_crypto_hash_set_thread_pool (serial, pool) == FALSE);
+
+	p_crypto_hash_free (serial);
+	p_crypto_hash_free (parallel);
+	p_thread_pool_free (pool);
+	p_free (data);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (compute_test)
+{
+	puchar		data[PCRYPTO_MANY_MAX_LENGTH];
+	puchar		storage[P_CRYPTO_HASH_MAX_CONTEXT_SIZE + 16];
+	puchar		digest[P_CRYPTO_HASH_MAX_DIGEST_SIZE];
+	puchar		etalon[P_CRYPTO_HASH_MAX_DIGEST_SIZE];
+	PCryptoHash	*hash;
+	PCryptoHash	*in_place;
+	pchar		*hash_str;
+	pchar		*in_place_str;
+	psize		dig_len;
+	pint		type;
+
+	p_libsys_init ();
+
+	for (psize i = 0; i < sizeof (data); ++i)
+		data[i] = (puchar) (i * 13 + 1);
+
+	for (type = (pint) P_CRYPTO_HASH_TYPE_MD5; type <= (pint) P_CRYPTO_HASH_TYPE_BLAKE3; ++type) {
+		hash = p_crypto_hash_new ((PCryptoHashType) type);
+		P_TEST_REQUIRE (hash != NULL);
+
+		psize hash_len = (psize) p_crypto_hash_get_length (hash);
+
+		P_TEST_CHECK (hash_len <= P_CRYPTO_HASH_MAX_DIGEST_SIZE);
+
+		for (psize len = 0; len < sizeof (data); len += 29) {
+			p_crypto_hash_reset (hash);
+			p_crypto_hash_update (hash, data, len);
+
+			dig_len = sizeof (etalon);
+			p_crypto_hash_get_digest (hash, etalon, &dig_len);
+
+			P_TEST_CHECK (p_crypto_hash_compute ((PCryptoHashType) type, data, len, digest) == TRUE);
+			P_TEST_CHECK (memcmp (digest, etalon, hash_len) == 0);
+		}
+
+		/* Unaligned storage must fit as well */
+		for (psize offset = 0; offset < 16; offset += 5) {
+			in_place = p_crypto_hash_init_in_place ((PCryptoHashType) type,
+								storage + offset,
+								P_CRYPTO_HASH_MAX_CONTEXT_SIZE);
+			P_TEST_REQUIRE (in_place != NULL);
+
+			P_TEST_CHECK (p_crypto_hash_get_type (in_place) == (PCryptoHashType) type);
+			P_TEST_CHECK ((psize) p_crypto_hash_get_length (in_place) == hash_len);
+
+			p_crypto_hash_update (in_place, data, 100);
+			p_crypto_hash_update (in_place, data + 100, sizeof (data) - 100);
+
+			p_crypto_hash_reset (hash);
+			p_crypto_hash_update (hash, data, sizeof (data));
+
+			hash_str     = p_crypto_hash_get_string (hash);
+			in_place_str = p_crypto_hash_get_string (in_place);
+
+			P_TEST_CHECK (strcmp (hash_str, in_place_str) == 0);
+
+			p_free (hash_str);
+			p_free (in_place_str);
+
+			p_crypto_hash_free (in_place);
+		}
+
+		p_crypto_hash_free (hash);
+	}
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (copy_test)
+{
+	puchar		data[PCRYPTO_MANY_MAX_LENGTH];
+	puint64		storage[P_CRYPTO_HASH_MAX_CONTEXT_SIZE / sizeof (puint64)];
+	puchar		digest[P_CRYPTO_HASH_MAX_DIGEST_SIZE];
+	puchar		etalon[P_CRYPTO_HASH_MAX_DIGEST_SIZE];
+	PCryptoHash	*prefix;
+	PCryptoHash	*fork;
+	PCryptoHash	*closed;
+	psize		dig_len;
+	pint		type;
+
+	p_libsys_init ();
+
+	for (psize i = 0; i < sizeof (data); ++i)
+		data[i] = (puchar) (i * 7 + 3);
+
+	for (type = (pint) P_CRYPTO_HASH_TYPE_MD5; type <= (pint) P_CRYPTO_HASH_TYPE_BLAKE3; ++type) {
+		/* Prefix in the in-place context must survive the forks */
+		prefix = p_crypto_hash_init_in_place ((PCryptoHashType) type, storage, sizeof (storage));
+		P_TEST_REQUIRE (prefix != NULL);
+
+		p_crypto_hash_update (prefix, data, 150);
+
+		for (psize split = 151; split < sizeof (data); split += 37) {
+			fork = p_crypto_hash_copy (prefix);
+			P_TEST_REQUIRE (fork != NULL);
+
+			P_TEST_CHECK (p_crypto_hash_get_type (fork) == (PCryptoHashType) type);
+
+			p_crypto_hash_update (fork, data + 150, split - 150);
+
+			dig_len = sizeof (digest);
+			p_crypto_hash_get_digest (fork, digest, &dig_len);
+
+			P_TEST_CHECK (p_crypto_hash_compute ((PCryptoHashType) type, data, split, etalon) == TRUE);
+			P_TEST_CHECK (dig_len == (psize) p_crypto_hash_get_length (fork));
+			P_TEST_CHECK (memcmp (digest, etalon, dig_len) == 0);
+
+			/* A closed context is copied closed with the same digest */
+			closed = p_crypto_hash_copy (fork);
+			P_TEST_REQUIRE (closed != NULL);
+
+			p_crypto_hash_update (closed, data, 10);
+
+			dig_len = sizeof (digest);
+			p_crypto_hash_get_digest (closed, digest, &dig_len);
+			P_TEST_CHECK (memcmp (digest, etalon, dig_len) == 0);
+
+			p_crypto_hash_free (closed);
+			p_crypto_hash_free (fork);
+		}
+
+		p_crypto_hash_update (prefix, data + 150, sizeof (data) - 150);
+
+		dig_len = sizeof (digest);
+		p_crypto_hash_get_digest (prefix, digest, &dig_len);
+
+		P_TEST_CHECK (p_crypto_hash_compute ((PCryptoHashType) type, data, sizeof (data), etalon) == TRUE);
+		P_TEST_CHECK (memcmp (digest, etalon, dig_len) == 0);
+
+		p_crypto_hash_free (prefix);
+	}
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+static bool
+write_test_file (const pchar *path, const puchar *data, psize len)
+{
+	FILE *file = fopen (path, "wb");
+
+	if (file == NULL)
+		return false;
+
+	bool result = fwrite (data, 1, len, file) == len;
+
+	return fclose (file) == 0 && result;
+}
+
+#ifdef P_OS_UNIX
+typedef struct _FifoWriterData {
+	const puchar	*data;
+	psize		len;
+} FifoWriterData;
+
+static ppointer
+fifo_writer (ppointer arg)
+{
+	FifoWriterData *writer = (FifoWriterData *) arg;
+
+	write_test_file (PCRYPTO_FIFO_NAME, writer->data, writer->len);
+
+	return NULL;
+}
+#endif
+
+P_TEST_CASE_BEGIN (file_test)
+{
+	puchar		*data;
+	puchar		digest[P_CRYPTO_HASH_MAX_DIGEST_SIZE];
+	puchar		etalon[P_CRYPTO_HASH_MAX_DIGEST_SIZE];
+	PError		*error = NULL;
+	pint		type;
+
+	p_libsys_init ();
+
+	data = (puchar *) p_malloc (PCRYPTO_FILE_LENGTH);
+	P_TEST_REQUIRE (data != NULL);
+
+	for (psize i = 0; i < PCRYPTO_FILE_LENGTH; ++i)
+		data[i] = (puchar) (i * 7 + (i >> 11));
+
+	P_TEST_CHECK (p_crypto_hash_file (P_CRYPTO_HASH_TYPE_MD5, NULL, digest, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_INVALID_ARGUMENT);
+	p_error_free (error);
+	error = NULL;
+
+	P_TEST_CHECK (p_crypto_hash_file (P_CRYPTO_HASH_TYPE_MD5, PCRYPTO_FILE_NAME, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_crypto_hash_file ((PCryptoHashType) -1, PCRYPTO_FILE_NAME, digest, NULL) == FALSE);
+
+	/* Missing file */
+	p_file_remove (PCRYPTO_FILE_NAME, NULL);
+
+	P_TEST_CHECK (p_crypto_hash_file (P_CRYPTO_HASH_TYPE_MD5, PCRYPTO_FILE_NAME, digest, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+	error = NULL;
+
+	/* Empty file */
+	P_TEST_REQUIRE (write_test_file (PCRYPTO_FILE_NAME, data, 0));
+
+	for (type = (pint) P_CRYPTO_HASH_TYPE_MD5; type <= (pint) P_CRYPTO_HASH_TYPE_BLAKE3; ++type) {
+		P_TEST_CHECK (p_crypto_hash_compute ((PCryptoHashType) type, NULL, 0, etalon) == TRUE);
+		P_TEST_CHECK (p_crypto_hash_file ((PCryptoHashType) type, PCRYPTO_FILE_NAME, digest, NULL) == TRUE);
+		P_TEST_CHECK (memcmp (digest, etalon, P_CRYPTO_HASH_MAX_DIGEST_SIZE / 4) == 0);
+	}
+
+	/* Several mapping windows with a partial one at the end */
+	P_TEST_REQUIRE (write_test_file (PCRYPTO_FILE_NAME, data, PCRYPTO_FILE_LENGTH));
+
+	for (type = (pint) P_CRYPTO_HASH_TYPE_MD5; type <= (pint) P_CRYPTO_HASH_TYPE_BLAKE3; ++type) {
+		PCryptoHash *hash = p_crypto_hash_new ((PCryptoHashType) type);
+		P_TEST_REQUIRE (hash != NULL);
+
+		psize hash_len = (psize) p_crypto_hash_get_length (hash);
+		p_crypto_hash_free (hash);
+
+		P_TEST_CHECK (p_crypto_hash_compute ((PCryptoHashType) type, data, PCRYPTO_FILE_LENGTH, etalon) == TRUE);
+
+		memset (digest, 0, sizeof (digest));
+		P_TEST_CHECK (p_crypto_hash_file ((PCryptoHashType) type, PCRYPTO_FILE_NAME, digest, &error) == TRUE);
+		P_TEST_CHECK (error == NULL);
+		P_TEST_CHECK (memcmp (digest, etalon, hash_len) == 0);
+	}
+
+	P_TEST_CHECK (p_file_remove (PCRYPTO_FILE_NAME, NULL) == TRUE);
+
+#ifdef P_OS_UNIX
+	/* FIFO can't be mapped, it's read through the buffers */
+	p_file_remove (PCRYPTO_FIFO_NAME, NULL);
+
+	if (mkfifo (PCRYPTO_FIFO_NAME, 0600) == 0) {
+		FifoWriterData writer;
+
+		writer.data = data;
+		writer.len  = PCRYPTO_FILE_LENGTH;
+
+		PUThread *thread = p_uthread_create (fifo_writer, &writer, TRUE, NULL);
+		P_TEST_REQUIRE (thread != NULL);
+
+		P_TEST_CHECK (p_crypto_hash_compute (P_CRYPTO_HASH_TYPE_SHA2_256,
+						     data,
+						     PCRYPTO_FILE_LENGTH,
+						     etalon) == TRUE);
+		P_TEST_CHECK (p_crypto_hash_file (P_CRYPTO_HASH_TYPE_SHA2_256,
+						  PCRYPTO_FIFO_NAME,
+						  digest,
+						  NULL) == TRUE);
+		P_TEST_CHECK (memcmp (digest, etalon, 32) == 0);
+
+		p_uthread_join (thread);
+		p_uthread_unref (thread);
+
+		P_TEST_CHECK (p_file_remove (PCRYPTO_FIFO_NAME, NULL) == TRUE);
+	}
+#endif
+
+	p_free (data);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (compute_many_test)
+{
+	const puchar	**inputs;
+	psize		*lens;
+	puchar		*data;
+	puchar		*digests;
+	puchar		digest[64];
+	psize		dig_len;
+	PCryptoHash	*hash;
+	pint		type;
+
+	p_libsys_init ();
+
+	data    = (puchar *) p_malloc0 (PCRYPTO_MANY_COUNT * PCRYPTO_MANY_MAX_LENGTH);
+	inputs  = (const puchar **) p_malloc0 (PCRYPTO_MANY_COUNT * sizeof (puchar *));
+	lens    = (psize *) p_malloc0 (PCRYPTO_MANY_COUNT * sizeof (psize));
+	digests = (puchar *) p_malloc0 (PCRYPTO_MANY_COUNT * 64);
+
+	P_TEST_REQUIRE (data != NULL && inputs != NULL && lens != NULL && digests != NULL);
+
+	for (psize i = 0; i < PCRYPTO_MANY_COUNT * PCRYPTO_MANY_MAX_LENGTH; ++i)
+		data[i] = (puchar) (i * 31 + 7);
+
+	/* Lengths go around all the padding corner cases and differ between
+	 * neighbours, so the lanes finish at different times */
+	for (psize i = 0; i < PCRYPTO_MANY_COUNT; ++i) {
+		lens[i]   = (i * 37) % PCRYPTO_MANY_MAX_LENGTH;
+		inputs[i] = lens[i] == 0 ? NULL : data + i * PCRYPTO_MANY_MAX_LENGTH;
+	}
+
+	for (type = (pint) P_CRYPTO_HASH_TYPE_MD5; type <= (pint) P_CRYPTO_HASH_TYPE_BLAKE3; ++type) {
+		hash = p_crypto_hash_new ((PCryptoHashType) type);
+		P_TEST_REQUIRE (hash != NULL);
+
+		psize hash_len = (psize) p_crypto_hash_get_length (hash);
+
+		P_TEST_CHECK (p_crypto_hash_compute_many ((PCryptoHashType) type,
+							  inputs,
+							  lens,
+							  PCRYPTO_MANY_COUNT,
+							  digests) == TRUE);
+
+		for (psize i = 0; i < PCRYPTO_MANY_COUNT; ++i) {
+			p_crypto_hash_reset (hash);
+			p_crypto_hash_update (hash, inputs[i], lens[i]);
+
+			dig_len = sizeof (digest);
+			p_crypto_hash_get_digest (hash, digest, &dig_len);
+
+			P_TEST_CHECK (dig_len == hash_len);
+			P_TEST_CHECK (memcmp (digest, digests + i * hash_len, hash_len) == 0);
+		}
+
+		p_crypto_hash_free (hash);
+	}
+
+	p_free (digests);
+	p_free (lens);
+	p_free (inputs);
+	p_free (data);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (implementation_test)
+{
+	const pchar *impl;
+
+	p_libsys_init ();
+
+	for (pint type = (pint) P_CRYPTO_HASH_TYPE_MD5; type <= (pint) P_CRYPTO_HASH_TYPE_BLAKE3; ++type) {
+		impl = p_crypto_hash_get_implementation ((PCryptoHashType) type);
+
+		P_TEST_CHECK (impl != NULL);
+		P_TEST_CHECK (strlen (impl) > 0);
+	}
+
+	P_TEST_CHECK (p_crypto_hash_get_implementation ((PCryptoHashType) -1) == NULL);
+	P_TEST_CHECK (p_crypto_hash_get_implementation ((PCryptoHashType) 100) == NULL);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
 P_TEST_SUITE_BEGIN()
 {
 	P_TEST_SUITE_RUN_CASE (pcryptohash_nomem_test);
@@ -658,5 +1284,14 @@ P_TEST_SUITE_BEGIN()
 	P_TEST_SUITE_RUN_CASE (sha3_384_test);
 	P_TEST_SUITE_RUN_CASE (sha3_512_test);
 	P_TEST_SUITE_RUN_CASE (gost3411_94_test);
+	P_TEST_SUITE_RUN_CASE (blake2b_test);
+	P_TEST_SUITE_RUN_CASE (blake2s_test);
+	P_TEST_SUITE_RUN_CASE (blake3_test);
+	P_TEST_SUITE_RUN_CASE (blake3_thread_pool_test);
+	P_TEST_SUITE_RUN_CASE (compute_test);
+	P_TEST_SUITE_RUN_CASE (copy_test);
+	P_TEST_SUITE_RUN_CASE (compute_many_test);
+	P_TEST_SUITE_RUN_CASE (file_test);
+	P_TEST_SUITE_RUN_CASE (implementation_test);
 }
 P_TEST_SUITE_END()
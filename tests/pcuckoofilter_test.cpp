@@ -0,0 +1,235 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+P_TEST_MODULE_INIT ();
+
+#define PCUCKOOFILTER_ITEMS	20000
+#define PCUCKOOFILTER_PROBES	200000
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+P_TEST_CASE_BEGIN (pcuckoofilter_nomem_test)
+{
+	p_libsys_init ();
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (p_cuckoo_filter_new (1000, 0.01) == NULL);
+
+	p_mem_restore_vtable ();
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pcuckoofilter_invalid_test)
+{
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_cuckoo_filter_new (1000, 0.0) == NULL);
+	P_TEST_CHECK (p_cuckoo_filter_new (1000, 1.0) == NULL);
+	P_TEST_CHECK (p_cuckoo_filter_new ((psize) -1, 0.01) == NULL);
+	P_TEST_CHECK (p_cuckoo_filter_add (NULL, "a", 1) == FALSE);
+	P_TEST_CHECK (p_cuckoo_filter_add_hash (NULL, 0) == FALSE);
+	P_TEST_CHECK (p_cuckoo_filter_contains (NULL, "a", 1) == FALSE);
+	P_TEST_CHECK (p_cuckoo_filter_contains_hash (NULL, 0) == FALSE);
+	P_TEST_CHECK (p_cuckoo_filter_remove (NULL, "a", 1) == FALSE);
+	P_TEST_CHECK (p_cuckoo_filter_remove_hash (NULL, 0) == FALSE);
+	P_TEST_CHECK (p_cuckoo_filter_get_count (NULL) == 0);
+	P_TEST_CHECK (p_cuckoo_filter_get_size (NULL) == 0);
+
+	p_cuckoo_filter_clear (NULL);
+	p_cuckoo_filter_free (NULL);
+
+	PCuckooFilter *filter = p_cuckoo_filter_new (0, 0.1);
+	P_TEST_REQUIRE (filter != NULL);
+
+	P_TEST_CHECK (p_cuckoo_filter_add (filter, NULL, 10) == FALSE);
+	P_TEST_CHECK (p_cuckoo_filter_contains (filter, NULL, 10) == FALSE);
+	P_TEST_CHECK (p_cuckoo_filter_remove (filter, NULL, 10) == FALSE);
+	P_TEST_CHECK (p_cuckoo_filter_remove (filter, "a", 1) == FALSE);
+
+	p_cuckoo_filter_free (filter);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pcuckoofilter_general_test)
+{
+	p_libsys_init ();
+
+	const pdouble rates[] = {0.05, 0.001};
+
+	for (psize r = 0; r < sizeof (rates) / sizeof (rates[0]); ++r) {
+		PCuckooFilter *filter = p_cuckoo_filter_new (PCUCKOOFILTER_ITEMS, rates[r]);
+		P_TEST_REQUIRE (filter != NULL);
+
+		for (puint32 i = 0; i < PCUCKOOFILTER_ITEMS; ++i) {
+			if (i % 2 == 0)
+				P_TEST_CHECK (p_cuckoo_filter_add (filter, &i, sizeof (i)) == TRUE);
+			else
+				P_TEST_CHECK (p_cuckoo_filter_add_hash (filter, i) == TRUE);
+		}
+
+		P_TEST_CHECK (p_cuckoo_filter_get_count (filter) == PCUCKOOFILTER_ITEMS);
+
+		for (puint32 i = 0; i < PCUCKOOFILTER_ITEMS; ++i) {
+			if (i % 2 == 0)
+				P_TEST_CHECK (p_cuckoo_filter_contains (filter, &i, sizeof (i)) == TRUE);
+			else
+				P_TEST_CHECK (p_cuckoo_filter_contains_hash (filter, i) == TRUE);
+		}
+
+		psize false_positives = 0;
+
+		for (puint32 i = PCUCKOOFILTER_ITEMS; i < PCUCKOOFILTER_ITEMS + PCUCKOOFILTER_PROBES; ++i) {
+			if (p_cuckoo_filter_contains (filter, &i, sizeof (i)))
+				++false_positives;
+		}
+
+		P_TEST_CHECK ((pdouble) false_positives / PCUCKOOFILTER_PROBES <= rates[r]);
+
+		/* Remove a half, the rest must stay */
+		for (puint32 i = 0; i < PCUCKOOFILTER_ITEMS; i += 2)
+			P_TEST_CHECK (p_cuckoo_filter_remove (filter, &i, sizeof (i)) == TRUE);
+
+		P_TEST_CHECK (p_cuckoo_filter_get_count (filter) == PCUCKOOFILTER_ITEMS / 2);
+
+		psize still_found = 0;
+
+		for (puint32 i = 0; i < PCUCKOOFILTER_ITEMS; ++i) {
+			if (i % 2 == 1)
+				P_TEST_CHECK (p_cuckoo_filter_contains_hash (filter, i) == TRUE);
+			else if (p_cuckoo_filter_contains (filter, &i, sizeof (i)))
+				++still_found;
+		}
+
+		P_TEST_CHECK ((pdouble) still_found / (PCUCKOOFILTER_ITEMS / 2) <= rates[r]);
+
+		/* Duplicates need their own removals */
+		puint32 dup = PCUCKOOFILTER_ITEMS * 10;
+
+		P_TEST_CHECK (p_cuckoo_filter_add (filter, &dup, sizeof (dup)) == TRUE);
+		P_TEST_CHECK (p_cuckoo_filter_add (filter, &dup, sizeof (dup)) == TRUE);
+		P_TEST_CHECK (p_cuckoo_filter_remove (filter, &dup, sizeof (dup)) == TRUE);
+		P_TEST_CHECK (p_cuckoo_filter_contains (filter, &dup, sizeof (dup)) == TRUE);
+		P_TEST_CHECK (p_cuckoo_filter_remove (filter, &dup, sizeof (dup)) == TRUE);
+
+		p_cuckoo_filter_clear (filter);
+		P_TEST_CHECK (p_cuckoo_filter_get_count (filter) == 0);
+
+		for (puint32 i = 1; i < PCUCKOOFILTER_ITEMS; i += 2)
+			P_TEST_CHECK (p_cuckoo_filter_contains_hash (filter, i) == FALSE);
+
+		p_cuckoo_filter_free (filter);
+	}
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pcuckoofilter_full_test)
+{
+	p_libsys_init ();
+
+	PCuckooFilter *filter = p_cuckoo_filter_new (100, 0.01);
+	P_TEST_REQUIRE (filter != NULL);
+
+	psize capacity = p_cuckoo_filter_get_size (filter) / 2;
+	psize added    = 0;
+
+	/* Fill until the insertion fails */
+	for (puint64 i = 0; i < capacity * 2; ++i) {
+		if (!p_cuckoo_filter_add_hash (filter, i))
+			break;
+
+		++added;
+	}
+
+	P_TEST_CHECK (added <= capacity + 1);
+	P_TEST_CHECK (added >= capacity * 9 / 10);
+	P_TEST_CHECK (p_cuckoo_filter_get_count (filter) == added);
+
+	for (puint64 i = 0; i < added; ++i)
+		P_TEST_CHECK (p_cuckoo_filter_contains_hash (filter, i) == TRUE);
+
+	/* Removing items makes room again */
+	for (puint64 i = 0; i < added; i += 2)
+		P_TEST_CHECK (p_cuckoo_filter_remove_hash (filter, i) == TRUE);
+
+	for (puint64 i = 0; i < 10; ++i)
+		P_TEST_CHECK (p_cuckoo_filter_add_hash (filter, capacity * 2 + i) == TRUE);
+
+	for (puint64 i = 1; i < added; i += 2)
+		P_TEST_CHECK (p_cuckoo_filter_contains_hash (filter, i) == TRUE);
+
+	for (puint64 i = 1; i < added; i += 2)
+		P_TEST_CHECK (p_cuckoo_filter_remove_hash (filter, i) == TRUE);
+
+	for (puint64 i = 0; i < 10; ++i)
+		P_TEST_CHECK (p_cuckoo_filter_remove_hash (filter, capacity * 2 + i) == TRUE);
+
+	P_TEST_CHECK (p_cuckoo_filter_get_count (filter) == 0);
+
+	p_cuckoo_filter_free (filter);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pcuckoofilter_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pcuckoofilter_invalid_test);
+	P_TEST_SUITE_RUN_CASE (pcuckoofilter_general_test);
+	P_TEST_SUITE_RUN_CASE (pcuckoofilter_full_test);
+}
+P_TEST_SUITE_END()
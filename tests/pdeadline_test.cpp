@@ -0,0 +1,144 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+P_TEST_MODULE_INIT ();
+
+P_TEST_CASE_BEGIN (pdeadline_bad_input_test)
+{
+	p_libsys_init ();
+
+	p_deadline_init_msecs (NULL, 10);
+	p_deadline_init_nsecs (NULL, 10);
+	p_deadline_init_infinite (NULL);
+	p_deadline_limit (NULL, NULL);
+
+	P_TEST_CHECK (p_deadline_is_infinite (NULL) == TRUE);
+	P_TEST_CHECK (p_deadline_has_expired (NULL) == FALSE);
+	P_TEST_CHECK (p_deadline_get_remaining_nsecs (NULL) == P_MAXUINT64);
+	P_TEST_CHECK (p_deadline_get_remaining_msecs (NULL) == -1);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pdeadline_general_test)
+{
+	PDeadline	deadline;
+	pint		remaining;
+
+	p_libsys_init ();
+
+	p_deadline_init_infinite (&deadline);
+	P_TEST_CHECK (p_deadline_is_infinite (&deadline) == TRUE);
+	P_TEST_CHECK (p_deadline_has_expired (&deadline) == FALSE);
+	P_TEST_CHECK (p_deadline_get_remaining_nsecs (&deadline) == P_MAXUINT64);
+	P_TEST_CHECK (p_deadline_get_remaining_msecs (&deadline) == -1);
+
+	p_deadline_init_msecs (&deadline, -1);
+	P_TEST_CHECK (p_deadline_is_infinite (&deadline) == TRUE);
+
+	p_deadline_init_nsecs (&deadline, P_MAXUINT64);
+	P_TEST_CHECK (p_deadline_is_infinite (&deadline) == TRUE);
+
+	p_deadline_init_msecs (&deadline, 0);
+	P_TEST_CHECK (p_deadline_is_infinite (&deadline) == FALSE);
+	P_TEST_CHECK (p_deadline_has_expired (&deadline) == TRUE);
+	P_TEST_CHECK (p_deadline_get_remaining_nsecs (&deadline) == 0);
+	P_TEST_CHECK (p_deadline_get_remaining_msecs (&deadline) == 0);
+
+	/* Partial milliseconds are rounded up, not to an expired timeout */
+	p_deadline_init_nsecs (&deadline, 10 * 1000 * 1000 + 1);
+	remaining = p_deadline_get_remaining_msecs (&deadline);
+	P_TEST_CHECK (remaining > 0 && remaining <= 11);
+
+	p_deadline_init_msecs (&deadline, 100);
+	P_TEST_CHECK (p_deadline_has_expired (&deadline) == FALSE);
+
+	remaining = p_deadline_get_remaining_msecs (&deadline);
+	P_TEST_CHECK (remaining > 0 && remaining <= 100);
+	P_TEST_CHECK (p_deadline_get_remaining_nsecs (&deadline) <= 100 * 1000 * 1000);
+
+	p_uthread_sleep (120);
+
+	P_TEST_CHECK (p_deadline_has_expired (&deadline) == TRUE);
+	P_TEST_CHECK (p_deadline_get_remaining_nsecs (&deadline) == 0);
+	P_TEST_CHECK (p_deadline_get_remaining_msecs (&deadline) == 0);
+
+	/* Far deadlines are clamped to the largest relative timeout */
+	p_deadline_init_nsecs (&deadline, P_MAXUINT64 - 1);
+	P_TEST_CHECK (p_deadline_is_infinite (&deadline) == FALSE);
+	P_TEST_CHECK (p_deadline_get_remaining_msecs (&deadline) == P_MAXINT32);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pdeadline_limit_test)
+{
+	PDeadline	deadline;
+	PDeadline	limit;
+
+	p_libsys_init ();
+
+	/* Infinite limit keeps the deadline */
+	p_deadline_init_msecs (&deadline, 10000);
+	p_deadline_limit (&deadline, NULL);
+	P_TEST_CHECK (p_deadline_get_remaining_msecs (&deadline) > 5000);
+
+	p_deadline_init_infinite (&limit);
+	p_deadline_limit (&deadline, &limit);
+	P_TEST_CHECK (p_deadline_get_remaining_msecs (&deadline) > 5000);
+
+	/* Earlier limit wins */
+	p_deadline_init_msecs (&limit, 100);
+	p_deadline_limit (&deadline, &limit);
+	P_TEST_CHECK (p_deadline_get_remaining_msecs (&deadline) <= 100);
+
+	/* Later limit does not extend the deadline */
+	p_deadline_init_msecs (&limit, 10000);
+	p_deadline_limit (&deadline, &limit);
+	P_TEST_CHECK (p_deadline_get_remaining_msecs (&deadline) <= 100);
+
+	/* Infinite deadline takes the limit */
+	p_deadline_init_infinite (&deadline);
+	p_deadline_init_msecs (&limit, 0);
+	p_deadline_limit (&deadline, &limit);
+	P_TEST_CHECK (p_deadline_is_infinite (&deadline) == FALSE);
+	P_TEST_CHECK (p_deadline_has_expired (&deadline) == TRUE);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pdeadline_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (pdeadline_general_test);
+	P_TEST_SUITE_RUN_CASE (pdeadline_limit_test);
+}
+P_TEST_SUITE_END()
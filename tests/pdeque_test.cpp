@@ -0,0 +1,278 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+P_TEST_MODULE_INIT ();
+
+#define PDEQUE_STRESS_COUNT	10000
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static void foreach_test_func (ppointer data, ppointer user_data)
+{
+	pint *state = (pint *) user_data;
+
+	/* Elements must come in the ascending order */
+	if (P_POINTER_TO_INT (data) != state[0] + 1)
+		state[1] = 1;
+
+	state[0] = P_POINTER_TO_INT (data);
+}
+
+P_TEST_CASE_BEGIN (pdeque_nomem_test)
+{
+	p_libsys_init ();
+
+	PDeque *deque = p_deque_new ();
+	P_TEST_REQUIRE (deque != NULL);
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (p_deque_new () == NULL);
+	P_TEST_CHECK (p_deque_new_sized (16) == NULL);
+	P_TEST_CHECK (p_deque_push_back (deque, P_INT_TO_POINTER (1)) == FALSE);
+	P_TEST_CHECK (p_deque_push_front (deque, P_INT_TO_POINTER (1)) == FALSE);
+	P_TEST_CHECK (p_deque_reserve (deque, 100) == FALSE);
+	P_TEST_CHECK (p_deque_length (deque) == 0);
+
+	p_mem_restore_vtable ();
+
+	p_deque_free (deque);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pdeque_invalid_test)
+{
+	p_libsys_init ();
+
+	ppointer	*first;
+	psize		first_len;
+
+	P_TEST_CHECK (p_deque_push_back (NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_deque_push_front (NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_deque_pop_back (NULL) == NULL);
+	P_TEST_CHECK (p_deque_pop_front (NULL) == NULL);
+	P_TEST_CHECK (p_deque_peek_back (NULL) == NULL);
+	P_TEST_CHECK (p_deque_peek_front (NULL) == NULL);
+	P_TEST_CHECK (p_deque_discard_front (NULL, 1) == 0);
+	P_TEST_CHECK (p_deque_reserve (NULL, 1) == FALSE);
+	P_TEST_CHECK (p_deque_index (NULL, 0) == NULL);
+	P_TEST_CHECK (p_deque_set_index (NULL, 0, NULL) == FALSE);
+	P_TEST_CHECK (p_deque_length (NULL) == 0);
+	P_TEST_CHECK (p_deque_get_spans (NULL, &first, &first_len, NULL, NULL) == 0);
+	P_TEST_CHECK (first == NULL && first_len == 0);
+
+	p_deque_foreach (NULL, NULL, NULL);
+	p_deque_clear (NULL);
+	p_deque_free (NULL);
+
+	PDeque *deque = p_deque_new ();
+	P_TEST_REQUIRE (deque != NULL);
+
+	P_TEST_CHECK (p_deque_pop_back (deque) == NULL);
+	P_TEST_CHECK (p_deque_pop_front (deque) == NULL);
+	P_TEST_CHECK (p_deque_index (deque, 0) == NULL);
+	P_TEST_CHECK (p_deque_set_index (deque, 0, NULL) == FALSE);
+	P_TEST_CHECK (p_deque_discard_front (deque, 10) == 0);
+	P_TEST_CHECK (p_deque_get_spans (deque, &first, &first_len, NULL, NULL) == 0);
+
+	p_deque_foreach (deque, NULL, NULL);
+	p_deque_free (deque);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pdeque_general_test)
+{
+	p_libsys_init ();
+
+	PDeque		*deque;
+	ppointer	*first;
+	ppointer	*second;
+	psize		first_len;
+	psize		second_len;
+	pint		state[2];
+	pint		i;
+
+	deque = p_deque_new_sized (8);
+	P_TEST_REQUIRE (deque != NULL);
+
+	/* Front and back pushes meet around the storage end */
+	for (i = 4; i >= 1; --i)
+		P_TEST_CHECK (p_deque_push_front (deque, P_INT_TO_POINTER (i)) == TRUE);
+
+	for (i = 5; i <= 8; ++i)
+		P_TEST_CHECK (p_deque_push_back (deque, P_INT_TO_POINTER (i)) == TRUE);
+
+	P_TEST_CHECK (p_deque_length (deque) == 8);
+	P_TEST_CHECK (p_deque_peek_front (deque) == P_INT_TO_POINTER (1));
+	P_TEST_CHECK (p_deque_peek_back (deque) == P_INT_TO_POINTER (8));
+
+	for (i = 0; i < 8; ++i)
+		P_TEST_CHECK (p_deque_index (deque, (psize) i) == P_INT_TO_POINTER (i + 1));
+
+	P_TEST_CHECK (p_deque_index (deque, 8) == NULL);
+
+	P_TEST_CHECK (p_deque_get_spans (deque, &first, &first_len, &second, &second_len) == 8);
+	P_TEST_CHECK (first_len == 4 && second_len == 4);
+	P_TEST_CHECK (first[0] == P_INT_TO_POINTER (1) && first[3] == P_INT_TO_POINTER (4));
+	P_TEST_CHECK (second[0] == P_INT_TO_POINTER (5) && second[3] == P_INT_TO_POINTER (8));
+
+	/* Growing keeps the order of the wrapped elements */
+	for (i = 9; i <= 20; ++i)
+		P_TEST_CHECK (p_deque_push_back (deque, P_INT_TO_POINTER (i)) == TRUE);
+
+	P_TEST_CHECK (p_deque_push_front (deque, P_INT_TO_POINTER (0)) == TRUE);
+	P_TEST_CHECK (p_deque_length (deque) == 21);
+
+	for (i = 0; i <= 20; ++i)
+		P_TEST_CHECK (p_deque_index (deque, (psize) i) == P_INT_TO_POINTER (i));
+
+	P_TEST_CHECK (p_deque_get_spans (deque, &first, &first_len, &second, &second_len) == 21);
+	P_TEST_CHECK (first_len + second_len == 21);
+	P_TEST_CHECK (first[0] == P_INT_TO_POINTER (0));
+
+	state[0] = -1;
+	state[1] = 0;
+
+	p_deque_foreach (deque, foreach_test_func, state);
+
+	P_TEST_CHECK (state[0] == 20 && state[1] == 0);
+
+	P_TEST_CHECK (p_deque_set_index (deque, 10, P_INT_TO_POINTER (100)) == TRUE);
+	P_TEST_CHECK (p_deque_index (deque, 10) == P_INT_TO_POINTER (100));
+	P_TEST_CHECK (p_deque_set_index (deque, 10, P_INT_TO_POINTER (10)) == TRUE);
+
+	P_TEST_CHECK (p_deque_pop_front (deque) == P_INT_TO_POINTER (0));
+	P_TEST_CHECK (p_deque_pop_back (deque) == P_INT_TO_POINTER (20));
+	P_TEST_CHECK (p_deque_discard_front (deque, 5) == 5);
+	P_TEST_CHECK (p_deque_peek_front (deque) == P_INT_TO_POINTER (6));
+	P_TEST_CHECK (p_deque_length (deque) == 14);
+	P_TEST_CHECK (p_deque_discard_front (deque, 100) == 14);
+	P_TEST_CHECK (p_deque_length (deque) == 0);
+	P_TEST_CHECK (p_deque_peek_back (deque) == NULL);
+
+	P_TEST_CHECK (p_deque_push_back (deque, P_INT_TO_POINTER (1)) == TRUE);
+	p_deque_clear (deque);
+	P_TEST_CHECK (p_deque_length (deque) == 0);
+	P_TEST_CHECK (p_deque_pop_front (deque) == NULL);
+
+	P_TEST_CHECK (p_deque_reserve (deque, 100) == TRUE);
+	P_TEST_CHECK (p_deque_reserve (deque, 10) == TRUE);
+
+	p_deque_free (deque);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pdeque_stress_test)
+{
+	p_libsys_init ();
+
+	PDeque	*deque;
+	pint	low;
+	pint	high;
+	pint	i;
+
+	deque = p_deque_new ();
+	P_TEST_REQUIRE (deque != NULL);
+
+	/* The deque always holds the [low, high) range */
+	low  = 0;
+	high = 0;
+
+	for (i = 0; i < PDEQUE_STRESS_COUNT; ++i) {
+		switch ((i * 7 + i / 13) % 5) {
+		case 0:
+		case 1:
+			P_TEST_CHECK (p_deque_push_back (deque, P_INT_TO_POINTER (high)) == TRUE);
+			++high;
+			break;
+		case 2:
+			P_TEST_CHECK (p_deque_push_front (deque, P_INT_TO_POINTER (low - 1)) == TRUE);
+			--low;
+			break;
+		case 3:
+			if (low < high) {
+				P_TEST_CHECK (p_deque_pop_front (deque) == P_INT_TO_POINTER (low));
+				++low;
+			}
+			break;
+		default:
+			if (low < high) {
+				P_TEST_CHECK (p_deque_pop_back (deque) == P_INT_TO_POINTER (high - 1));
+				--high;
+			}
+			break;
+		}
+
+		P_TEST_CHECK (p_deque_length (deque) == (psize) (high - low));
+	}
+
+	for (i = low; i < high; ++i)
+		P_TEST_CHECK (p_deque_index (deque, (psize) (i - low)) == P_INT_TO_POINTER (i));
+
+	p_deque_free (deque);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pdeque_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pdeque_invalid_test);
+	P_TEST_SUITE_RUN_CASE (pdeque_general_test);
+	P_TEST_SUITE_RUN_CASE (pdeque_stress_test);
+}
+P_TEST_SUITE_END()
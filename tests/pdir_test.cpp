@@ -26,6 +26,7 @@
 #include "plibsys.h"
 #include "ptestmacros.h"
 
+#include <stdio.h>
 #include <string.h>
 
 P_TEST_MODULE_INIT ();
@@ -33,8 +34,13 @@ P_TEST_MODULE_INIT ();
 #define PDIR_ENTRY_DIR		"test_2"
 #define PDIR_ENTRY_FILE		"test_file.txt"
 #define PDIR_TEST_DIR		"." P_DIR_SEPARATOR "pdir_test_dir"
+#define PDIR_COPY_DIR		"." P_DIR_SEPARATOR "pdir_copy_dir"
 #define PDIR_TEST_DIR_IN	"." P_DIR_SEPARATOR "pdir_test_dir" P_DIR_SEPARATOR "test_2"
 #define PDIR_TEST_FILE		"." P_DIR_SEPARATOR "pdir_test_dir" P_DIR_SEPARATOR "test_file.txt"
+#define PDIR_BATCH_FILES	300
+#define PDIR_WALK_DIRS		3
+#define PDIR_WALK_SUBDIRS	2
+#define PDIR_WALK_FILES		3
 
 extern "C" ppointer pmem_alloc (psize nbytes)
 {
@@ -54,6 +60,97 @@ extern "C" void pmem_free (ppointer block)
 	P_UNUSED (block);
 }
 
+typedef struct _PDirWalkStats {
+	volatile pint	dirs;
+	volatile pint	files;
+	volatile pint	max_depth;
+	volatile pint	bad_size;
+	const pchar	*skip_name;
+	pint		stop_after;
+} PDirWalkStats;
+
+static PDirWalkResult
+pdir_walk_count (const PDirWalkEntry *entry, ppointer user_data)
+{
+	PDirWalkStats	*stats = (PDirWalkStats *) user_data;
+	pint		depth;
+
+	if (entry->type == P_DIR_ENTRY_TYPE_DIR)
+		p_atomic_int_inc (&stats->dirs);
+	else if (entry->type == P_DIR_ENTRY_TYPE_FILE) {
+		p_atomic_int_inc (&stats->files);
+
+		if (entry->has_stat == TRUE && entry->size != 3)
+			p_atomic_int_inc (&stats->bad_size);
+	}
+
+	while ((depth = p_atomic_int_get (&stats->max_depth)) < entry->depth)
+		p_atomic_int_compare_and_exchange (&stats->max_depth, depth, entry->depth);
+
+	if (entry->path == NULL || strstr (entry->path, entry->name) == NULL)
+		p_atomic_int_inc (&stats->bad_size);
+
+	if (stats->stop_after > 0 &&
+	    p_atomic_int_get (&stats->dirs) + p_atomic_int_get (&stats->files) >= stats->stop_after)
+		return P_DIR_WALK_STOP;
+
+	if (stats->skip_name != NULL && strcmp (entry->name, stats->skip_name) == 0)
+		return P_DIR_WALK_SKIP;
+
+	return P_DIR_WALK_CONTINUE;
+}
+
+static void
+pdir_walk_tree (pboolean create)
+{
+	pchar path[128];
+
+	if (create == TRUE)
+		P_TEST_REQUIRE (p_dir_create (PDIR_TEST_DIR, 0777, NULL) == TRUE);
+
+	for (pint i = 0; i < PDIR_WALK_DIRS; ++i) {
+		snprintf (path, sizeof (path), PDIR_TEST_DIR P_DIR_SEPARATOR "d%d", i);
+
+		if (create == TRUE)
+			P_TEST_REQUIRE (p_dir_create (path, 0777, NULL) == TRUE);
+
+		for (pint j = -1; j < PDIR_WALK_SUBDIRS; ++j) {
+			if (j >= 0) {
+				snprintf (path, sizeof (path), PDIR_TEST_DIR P_DIR_SEPARATOR "d%d"
+					  P_DIR_SEPARATOR "s%d", i, j);
+
+				if (create == TRUE)
+					P_TEST_REQUIRE (p_dir_create (path, 0777, NULL) == TRUE);
+			}
+
+			for (pint k = 0; k < PDIR_WALK_FILES; ++k) {
+				pchar file_path[160];
+
+				snprintf (file_path, sizeof (file_path), "%s" P_DIR_SEPARATOR "f%d", path, k);
+
+				if (create == TRUE) {
+					FILE *file = fopen (file_path, "w");
+					P_TEST_REQUIRE (file != NULL);
+					P_TEST_CHECK (fputs ("abc", file) >= 0);
+					P_TEST_CHECK (fclose (file) == 0);
+				} else
+					p_file_remove (file_path, NULL);
+			}
+
+			if (create == FALSE && j >= 0)
+				p_dir_remove (path, NULL);
+
+			snprintf (path, sizeof (path), PDIR_TEST_DIR P_DIR_SEPARATOR "d%d", i);
+		}
+
+		if (create == FALSE)
+			p_dir_remove (path, NULL);
+	}
+
+	if (create == FALSE)
+		p_dir_remove (PDIR_TEST_DIR, NULL);
+}
+
 P_TEST_CASE_BEGIN (pdir_nomem_test)
 {
 	p_libsys_init ();
@@ -240,9 +337,255 @@ P_TEST_CASE_BEGIN (pdir_general_test)
 }
 P_TEST_CASE_END ()
 
+P_TEST_CASE_BEGIN (pdir_batch_test)
+{
+	p_libsys_init ();
+
+	PDirEntry	entries[7];
+	pchar		path[64];
+
+	P_TEST_CHECK (p_dir_get_next_entries (NULL, entries, 7, NULL) == -1);
+
+	/* Cleanup previous run */
+	for (pint i = 0; i < PDIR_BATCH_FILES; ++i) {
+		snprintf (path, sizeof (path), PDIR_TEST_DIR P_DIR_SEPARATOR "file_%d", i);
+		p_file_remove (path, NULL);
+	}
+
+	p_dir_remove (PDIR_TEST_DIR_IN, NULL);
+	p_dir_remove (PDIR_TEST_DIR, NULL);
+
+	P_TEST_REQUIRE (p_dir_create (PDIR_TEST_DIR, 0777, NULL) == TRUE);
+	P_TEST_REQUIRE (p_dir_create (PDIR_TEST_DIR_IN, 0777, NULL) == TRUE);
+
+	for (pint i = 0; i < PDIR_BATCH_FILES; ++i) {
+		snprintf (path, sizeof (path), PDIR_TEST_DIR P_DIR_SEPARATOR "file_%d", i);
+
+		FILE *file = fopen (path, "w");
+		P_TEST_REQUIRE (file != NULL);
+		P_TEST_CHECK (fclose (file) == 0);
+	}
+
+	PDir *dir = p_dir_new (PDIR_TEST_DIR, NULL);
+	P_TEST_REQUIRE (dir != NULL);
+
+	P_TEST_CHECK (p_dir_get_next_entries (dir, NULL, 7, NULL) == -1);
+	P_TEST_CHECK (p_dir_get_next_entries (dir, entries, 0, NULL) == 0);
+
+	for (pint pass = 0; pass < 2; ++pass) {
+		pboolean	seen[PDIR_BATCH_FILES];
+		pboolean	has_entry_dir = FALSE;
+		pint		file_count    = 0;
+		pint		other_count   = 0;
+		pssize		count;
+
+		memset (seen, 0, sizeof (seen));
+
+		while ((count = p_dir_get_next_entries (dir, entries, 7, NULL)) > 0) {
+			P_TEST_CHECK (count <= 7);
+
+			for (pssize i = 0; i < count; ++i) {
+				pint idx;
+
+				P_TEST_REQUIRE (entries[i].name != NULL);
+
+				if (sscanf (entries[i].name, "file_%d", &idx) == 1) {
+					P_TEST_CHECK (entries[i].type == P_DIR_ENTRY_TYPE_FILE);
+					P_TEST_REQUIRE (idx >= 0 && idx < PDIR_BATCH_FILES);
+					P_TEST_CHECK (seen[idx] == FALSE);
+
+					seen[idx] = TRUE;
+					++file_count;
+				} else if (strcmp (entries[i].name, PDIR_ENTRY_DIR) == 0) {
+					P_TEST_CHECK (entries[i].type == P_DIR_ENTRY_TYPE_DIR);
+					has_entry_dir = TRUE;
+				} else
+					++other_count;
+			}
+		}
+
+		P_TEST_CHECK (count == 0);
+		P_TEST_CHECK (file_count == PDIR_BATCH_FILES);
+		P_TEST_CHECK (has_entry_dir == TRUE);
+		P_TEST_CHECK (other_count < 3);
+
+		/* Stays at the end */
+		P_TEST_CHECK (p_dir_get_next_entries (dir, entries, 7, NULL) == 0);
+
+		P_TEST_CHECK (p_dir_rewind (dir, NULL) == TRUE);
+	}
+
+	p_dir_free (dir);
+
+	for (pint i = 0; i < PDIR_BATCH_FILES; ++i) {
+		snprintf (path, sizeof (path), PDIR_TEST_DIR P_DIR_SEPARATOR "file_%d", i);
+		P_TEST_CHECK (p_file_remove (path, NULL) == TRUE);
+	}
+
+	P_TEST_CHECK (p_dir_remove (PDIR_TEST_DIR_IN, NULL) == TRUE);
+	P_TEST_CHECK (p_dir_remove (PDIR_TEST_DIR, NULL) == TRUE);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pdir_walk_test)
+{
+	p_libsys_init ();
+
+	const pint	total_dirs  = PDIR_WALK_DIRS * (1 + PDIR_WALK_SUBDIRS);
+	const pint	total_files = PDIR_WALK_DIRS * (1 + PDIR_WALK_SUBDIRS) * PDIR_WALK_FILES;
+	PDirWalkStats	stats;
+	PError		*error = NULL;
+
+	P_TEST_CHECK (p_dir_walk (NULL, 0, NULL, pdir_walk_count, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_dir_walk (PDIR_TEST_DIR, 0, NULL, NULL, NULL, NULL) == FALSE);
+
+	P_TEST_CHECK (p_dir_walk (NULL, 0, NULL, pdir_walk_count, NULL, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+	error = NULL;
+
+	/* Cleanup previous run */
+	pdir_walk_tree (FALSE);
+
+	P_TEST_CHECK (p_dir_walk (PDIR_TEST_DIR, 0, NULL, pdir_walk_count, &stats, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+	error = NULL;
+
+	pdir_walk_tree (TRUE);
+
+	PThreadPool *pool = p_thread_pool_new (4);
+	P_TEST_REQUIRE (pool != NULL);
+
+	for (pint pass = 0; pass < 2; ++pass) {
+		PThreadPool *walk_pool = pass == 0 ? NULL : pool;
+
+		/* Full walk with stat */
+		memset (&stats, 0, sizeof (stats));
+
+		P_TEST_CHECK (p_dir_walk (PDIR_TEST_DIR,
+					  P_DIR_WALK_FLAG_STAT,
+					  walk_pool,
+					  pdir_walk_count,
+					  &stats,
+					  &error) == TRUE);
+		P_TEST_CHECK (error == NULL);
+		P_TEST_CHECK (stats.dirs == total_dirs);
+		P_TEST_CHECK (stats.files == total_files);
+		P_TEST_CHECK (stats.max_depth == 2);
+		P_TEST_CHECK (stats.bad_size == 0);
+
+		/* Pruned subtree */
+		memset (&stats, 0, sizeof (stats));
+		stats.skip_name = "d1";
+
+		P_TEST_CHECK (p_dir_walk (PDIR_TEST_DIR, 0, walk_pool, pdir_walk_count, &stats, NULL) == TRUE);
+		P_TEST_CHECK (stats.dirs == total_dirs - PDIR_WALK_SUBDIRS);
+		P_TEST_CHECK (stats.files == total_files - (1 + PDIR_WALK_SUBDIRS) * PDIR_WALK_FILES);
+
+		/* Early stop is not an error */
+		memset (&stats, 0, sizeof (stats));
+		stats.stop_after = 1;
+
+		P_TEST_CHECK (p_dir_walk (PDIR_TEST_DIR, 0, walk_pool, pdir_walk_count, &stats, NULL) == TRUE);
+		P_TEST_CHECK (stats.dirs + stats.files >= 1);
+		P_TEST_CHECK (stats.dirs + stats.files < total_dirs + total_files);
+	}
+
+	p_thread_pool_free (pool);
+
+	pdir_walk_tree (FALSE);
+
+	P_TEST_CHECK (p_dir_is_exists (PDIR_TEST_DIR) == FALSE);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pdir_recursive_test)
+{
+	p_libsys_init ();
+
+	const pint	total_dirs  = PDIR_WALK_DIRS * (1 + PDIR_WALK_SUBDIRS);
+	const pint	total_files = PDIR_WALK_DIRS * (1 + PDIR_WALK_SUBDIRS) * PDIR_WALK_FILES;
+	PDirWalkStats	stats;
+	PError		*error = NULL;
+
+	P_TEST_CHECK (p_dir_remove_recursive (NULL, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_dir_copy_recursive (NULL, PDIR_COPY_DIR, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_dir_copy_recursive (PDIR_TEST_DIR, NULL, NULL, NULL) == FALSE);
+
+	P_TEST_CHECK (p_dir_remove_recursive (NULL, NULL, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+	error = NULL;
+
+	/* Cleanup previous run */
+	p_dir_remove_recursive (PDIR_TEST_DIR, NULL, NULL);
+	p_dir_remove_recursive (PDIR_COPY_DIR, NULL, NULL);
+
+	P_TEST_CHECK (p_dir_remove_recursive (PDIR_TEST_DIR, NULL, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+	error = NULL;
+
+	P_TEST_CHECK (p_dir_copy_recursive (PDIR_TEST_DIR, PDIR_COPY_DIR, NULL, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (p_dir_is_exists (PDIR_COPY_DIR) == FALSE);
+	p_error_free (error);
+	error = NULL;
+
+	PThreadPool *pool = p_thread_pool_new (4);
+	P_TEST_REQUIRE (pool != NULL);
+
+	for (pint pass = 0; pass < 2; ++pass) {
+		PThreadPool *tree_pool = pass == 0 ? NULL : pool;
+
+		pdir_walk_tree (TRUE);
+
+		P_TEST_CHECK (p_dir_copy_recursive (PDIR_TEST_DIR, PDIR_COPY_DIR, tree_pool, &error) == TRUE);
+		P_TEST_CHECK (error == NULL);
+
+		/* Copied files have the same contents */
+		memset (&stats, 0, sizeof (stats));
+
+		P_TEST_CHECK (p_dir_walk (PDIR_COPY_DIR,
+					  P_DIR_WALK_FLAG_STAT,
+					  NULL,
+					  pdir_walk_count,
+					  &stats,
+					  NULL) == TRUE);
+		P_TEST_CHECK (stats.dirs == total_dirs);
+		P_TEST_CHECK (stats.files == total_files);
+		P_TEST_CHECK (stats.max_depth == 2);
+		P_TEST_CHECK (stats.bad_size == 0);
+
+		/* Copying over an existing tree overwrites the files */
+		P_TEST_CHECK (p_dir_copy_recursive (PDIR_TEST_DIR, PDIR_COPY_DIR, tree_pool, NULL) == TRUE);
+
+		P_TEST_CHECK (p_dir_remove_recursive (PDIR_TEST_DIR, tree_pool, &error) == TRUE);
+		P_TEST_CHECK (error == NULL);
+		P_TEST_CHECK (p_dir_is_exists (PDIR_TEST_DIR) == FALSE);
+
+		P_TEST_CHECK (p_dir_remove_recursive (PDIR_COPY_DIR, tree_pool, &error) == TRUE);
+		P_TEST_CHECK (error == NULL);
+		P_TEST_CHECK (p_dir_is_exists (PDIR_COPY_DIR) == FALSE);
+	}
+
+	p_thread_pool_free (pool);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
 P_TEST_SUITE_BEGIN()
 {
 	P_TEST_SUITE_RUN_CASE (pdir_nomem_test);
 	P_TEST_SUITE_RUN_CASE (pdir_general_test);
+	P_TEST_SUITE_RUN_CASE (pdir_batch_test);
+	P_TEST_SUITE_RUN_CASE (pdir_walk_test);
+	P_TEST_SUITE_RUN_CASE (pdir_recursive_test);
 }
 P_TEST_SUITE_END()
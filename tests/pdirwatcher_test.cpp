@@ -0,0 +1,333 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <stdio.h>
+#include <string.h>
+
+P_TEST_MODULE_INIT ();
+
+#define PDIRWATCHER_TEST_DIR		"." P_DIR_SEPARATOR "pdirwatcher_test_dir"
+#define PDIRWATCHER_TEST_FILE		PDIRWATCHER_TEST_DIR P_DIR_SEPARATOR "file_1"
+#define PDIRWATCHER_TEST_FILE_NEW	PDIRWATCHER_TEST_DIR P_DIR_SEPARATOR "file_2"
+#define PDIRWATCHER_MAX_EVENTS		256
+#define PDIRWATCHER_MAX_NAME		64
+
+typedef struct _PDirWatcherSeen {
+	pint			count;
+	PDirWatcherEventType	types[PDIRWATCHER_MAX_EVENTS];
+	pchar			names[PDIRWATCHER_MAX_EVENTS][PDIRWATCHER_MAX_NAME];
+	puint32			cookies[PDIRWATCHER_MAX_EVENTS];
+} PDirWatcherSeen;
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static pboolean write_file (const pchar *path, const pchar *mode, const pchar *data)
+{
+	FILE *file = fopen (path, mode);
+
+	if (file == NULL)
+		return FALSE;
+
+	pboolean result = fputs (data, file) >= 0;
+
+	return fclose (file) == 0 && result;
+}
+
+static pint find_event (const PDirWatcherSeen *seen, PDirWatcherEventType type, const pchar *name)
+{
+	for (pint i = 0; i < seen->count; ++i) {
+		if (seen->types[i] != type)
+			continue;
+
+		if ((name == NULL && seen->names[i][0] == '\0') ||
+		    (name != NULL && strcmp (seen->names[i], name) == 0))
+			return i;
+	}
+
+	return -1;
+}
+
+/* Collects the events until one of the given ones is seen */
+static pint wait_event (PDirWatcher			*watcher,
+			PSocketPoller			*poller,
+			PDirWatcherSeen			*seen,
+			PDirWatcherEventType		type,
+			PDirWatcherEventType		alt_type,
+			const pchar			*name)
+{
+	PSocketPollerEvent	poll_events[1];
+	PDirWatcherEvent	events[4];
+	pint			index;
+
+	for (pint i = 0; i < 100; ++i) {
+		if ((index = find_event (seen, type, name)) >= 0 ||
+		    (index = find_event (seen, alt_type, name)) >= 0)
+			return index;
+
+		if (p_socket_poller_wait (poller, poll_events, 1, 100, NULL) <= 0)
+			continue;
+
+		pint count;
+
+		while ((count = p_dir_watcher_read_events (watcher, events, 4, NULL)) > 0) {
+			for (pint j = 0; j < count && seen->count < PDIRWATCHER_MAX_EVENTS; ++j) {
+				seen->types[seen->count]    = events[j].type;
+				seen->cookies[seen->count]  = events[j].cookie;
+				seen->names[seen->count][0] = '\0';
+
+				if (events[j].name != NULL)
+					strncat (seen->names[seen->count], events[j].name, PDIRWATCHER_MAX_NAME - 1);
+
+				++seen->count;
+			}
+		}
+	}
+
+	return -1;
+}
+
+P_TEST_CASE_BEGIN (pdirwatcher_nomem_test)
+{
+	p_libsys_init ();
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_dir_create (PDIRWATCHER_TEST_DIR, 0777, NULL) == TRUE);
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (p_dir_watcher_new (PDIRWATCHER_TEST_DIR, NULL) == NULL);
+
+	p_mem_restore_vtable ();
+
+	P_TEST_CHECK (p_dir_remove (PDIRWATCHER_TEST_DIR, NULL) == TRUE);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pdirwatcher_bad_input_test)
+{
+	p_libsys_init ();
+
+	PDirWatcherEvent	events[4];
+	PError			*error = NULL;
+
+	P_TEST_CHECK (p_dir_watcher_new (NULL, &error) == NULL);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+	error = NULL;
+
+	P_TEST_CHECK (p_dir_watcher_get_socket (NULL) == NULL);
+	P_TEST_CHECK (p_dir_watcher_read_events (NULL, events, 4, NULL) == -1);
+
+	p_dir_watcher_free (NULL);
+
+	p_dir_remove_recursive (PDIRWATCHER_TEST_DIR, NULL, NULL);
+
+	P_TEST_CHECK (p_dir_watcher_new (PDIRWATCHER_TEST_DIR, &error) == NULL);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+	error = NULL;
+
+	P_TEST_CHECK (p_dir_create (PDIRWATCHER_TEST_DIR, 0777, NULL) == TRUE);
+
+	PDirWatcher *watcher = p_dir_watcher_new (PDIRWATCHER_TEST_DIR, NULL);
+	P_TEST_REQUIRE (watcher != NULL);
+
+	P_TEST_CHECK (p_dir_watcher_read_events (watcher, NULL, 4, NULL) == -1);
+	P_TEST_CHECK (p_dir_watcher_read_events (watcher, events, 0, &error) == -1);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+
+	P_TEST_CHECK (p_dir_watcher_read_events (watcher, events, 4, NULL) == 0);
+
+	p_dir_watcher_free (watcher);
+
+	P_TEST_CHECK (p_dir_remove (PDIRWATCHER_TEST_DIR, NULL) == TRUE);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pdirwatcher_general_test)
+{
+	p_libsys_init ();
+
+	PDirWatcherSeen	*seen = (PDirWatcherSeen *) p_malloc0 (sizeof (PDirWatcherSeen));
+	P_TEST_REQUIRE (seen != NULL);
+
+	p_dir_remove_recursive (PDIRWATCHER_TEST_DIR, NULL, NULL);
+	P_TEST_REQUIRE (p_dir_create (PDIRWATCHER_TEST_DIR, 0777, NULL) == TRUE);
+
+	PDirWatcher *watcher = p_dir_watcher_new (PDIRWATCHER_TEST_DIR, NULL);
+	P_TEST_REQUIRE (watcher != NULL);
+
+	PSocketPoller *poller = p_socket_poller_new (NULL);
+	P_TEST_REQUIRE (poller != NULL);
+
+	P_TEST_REQUIRE (p_socket_poller_add (poller,
+					     p_dir_watcher_get_socket (watcher),
+					     P_SOCKET_POLLER_CONDITION_IN,
+					     P_SOCKET_POLLER_FLAG_NONE,
+					     watcher,
+					     NULL) == TRUE);
+
+	/* Nothing has changed yet */
+	PSocketPollerEvent poll_events[1];
+	P_TEST_CHECK (p_socket_poller_wait (poller, poll_events, 1, 0, NULL) == 0);
+
+	P_TEST_REQUIRE (write_file (PDIRWATCHER_TEST_FILE, "w", "abc") == TRUE);
+	P_TEST_CHECK (wait_event (watcher,
+				  poller,
+				  seen,
+				  P_DIR_WATCHER_EVENT_CREATED,
+				  P_DIR_WATCHER_EVENT_CREATED,
+				  "file_1") >= 0);
+
+	/* Listing based watchers compare sizes and times */
+	p_uthread_sleep (1100);
+
+	seen->count = 0;
+	P_TEST_REQUIRE (write_file (PDIRWATCHER_TEST_FILE, "a", "defgh") == TRUE);
+	P_TEST_CHECK (wait_event (watcher,
+				  poller,
+				  seen,
+				  P_DIR_WATCHER_EVENT_MODIFIED,
+				  P_DIR_WATCHER_EVENT_MODIFIED,
+				  "file_1") >= 0);
+
+	/* Rename is either a pair with the same cookie, or a delete and a create */
+	seen->count = 0;
+	P_TEST_REQUIRE (rename (PDIRWATCHER_TEST_FILE, PDIRWATCHER_TEST_FILE_NEW) == 0);
+
+	pint from = wait_event (watcher,
+				poller,
+				seen,
+				P_DIR_WATCHER_EVENT_RENAMED_FROM,
+				P_DIR_WATCHER_EVENT_DELETED,
+				"file_1");
+	pint to   = wait_event (watcher,
+				poller,
+				seen,
+				P_DIR_WATCHER_EVENT_RENAMED_TO,
+				P_DIR_WATCHER_EVENT_CREATED,
+				"file_2");
+
+	P_TEST_REQUIRE (from >= 0 && to >= 0);
+
+	if (seen->types[from] == P_DIR_WATCHER_EVENT_RENAMED_FROM) {
+		P_TEST_CHECK (seen->types[to] == P_DIR_WATCHER_EVENT_RENAMED_TO);
+		P_TEST_CHECK (seen->cookies[from] == seen->cookies[to]);
+	} else
+		P_TEST_CHECK (seen->types[to] == P_DIR_WATCHER_EVENT_CREATED);
+
+	seen->count = 0;
+	P_TEST_CHECK (p_file_remove (PDIRWATCHER_TEST_FILE_NEW, NULL) == TRUE);
+	P_TEST_CHECK (wait_event (watcher,
+				  poller,
+				  seen,
+				  P_DIR_WATCHER_EVENT_DELETED,
+				  P_DIR_WATCHER_EVENT_DELETED,
+				  "file_2") >= 0);
+
+	/* Events can be read in small portions */
+	seen->count = 0;
+
+	for (pint i = 0; i < 3; ++i) {
+		pchar path[64];
+
+		snprintf (path, sizeof (path), PDIRWATCHER_TEST_DIR P_DIR_SEPARATOR "many_%d", i);
+		P_TEST_REQUIRE (write_file (path, "w", "abc") == TRUE);
+	}
+
+	pint total = 0;
+
+	for (pint i = 0; i < 100 && total < 3; ++i) {
+		PDirWatcherEvent event;
+
+		if (p_socket_poller_wait (poller, poll_events, 1, 100, NULL) <= 0)
+			continue;
+
+		P_TEST_CHECK (poll_events[0].user_data == watcher);
+
+		if (p_dir_watcher_read_events (watcher, &event, 1, NULL) == 1 &&
+		    event.type == P_DIR_WATCHER_EVENT_CREATED &&
+		    strncmp (event.name, "many_", 5) == 0)
+			++total;
+	}
+
+	P_TEST_CHECK (total == 3);
+
+	/* Removal of the watched directory is the last event */
+	seen->count = 0;
+	P_TEST_CHECK (p_dir_remove_recursive (PDIRWATCHER_TEST_DIR, NULL, NULL) == TRUE);
+	P_TEST_CHECK (wait_event (watcher,
+				  poller,
+				  seen,
+				  P_DIR_WATCHER_EVENT_DELETED,
+				  P_DIR_WATCHER_EVENT_DELETED,
+				  NULL) >= 0);
+
+	P_TEST_CHECK (p_socket_poller_remove (poller, p_dir_watcher_get_socket (watcher), NULL) == TRUE);
+
+	p_socket_poller_free (poller);
+	p_dir_watcher_free (watcher);
+	p_free (seen);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pdirwatcher_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pdirwatcher_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (pdirwatcher_general_test);
+}
+P_TEST_SUITE_END()
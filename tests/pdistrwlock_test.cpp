@@ -0,0 +1,228 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+P_TEST_MODULE_INIT ();
+
+#define PDISTRWLOCK_READERS		3
+#define PDISTRWLOCK_READER_ROUNDS	20000
+#define PDISTRWLOCK_WRITER_ROUNDS	2000
+
+static PDistRWLock *	global_dist_lock   = NULL;
+static pint		dist_lock_value_1  = 0;
+static pint		dist_lock_value_2  = 0;
+static volatile pint	dist_lock_inside   = 0;
+static volatile pint	dist_lock_overlap  = 0;
+static volatile pint	dist_lock_mismatch = 0;
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static void * dist_lock_reader_thread (void *)
+{
+	pint	i;
+	pint	slot;
+
+	for (i = 0; i < PDISTRWLOCK_READER_ROUNDS; ++i) {
+		if ((slot = p_dist_rwlock_reader_trylock (global_dist_lock)) < 0) {
+			if ((slot = p_dist_rwlock_reader_lock (global_dist_lock)) < 0)
+				p_uthread_exit (1);
+		}
+
+		if (p_atomic_int_get (&dist_lock_inside) != 0)
+			p_atomic_int_inc (&dist_lock_overlap);
+
+		if (dist_lock_value_1 != dist_lock_value_2)
+			p_atomic_int_inc (&dist_lock_mismatch);
+
+		if (!p_dist_rwlock_reader_unlock (global_dist_lock, slot))
+			p_uthread_exit (1);
+	}
+
+	p_uthread_exit (0);
+
+	return NULL;
+}
+
+static void * dist_lock_writer_thread (void *)
+{
+	pint i;
+
+	for (i = 0; i < PDISTRWLOCK_WRITER_ROUNDS; ++i) {
+		if (!p_dist_rwlock_writer_trylock (global_dist_lock)) {
+			if (!p_dist_rwlock_writer_lock (global_dist_lock))
+				p_uthread_exit (1);
+		}
+
+		p_atomic_int_set (&dist_lock_inside, 1);
+
+		++dist_lock_value_1;
+		p_uthread_yield ();
+		++dist_lock_value_2;
+
+		p_atomic_int_set (&dist_lock_inside, 0);
+
+		if (!p_dist_rwlock_writer_unlock (global_dist_lock))
+			p_uthread_exit (1);
+	}
+
+	p_uthread_exit (0);
+
+	return NULL;
+}
+
+P_TEST_CASE_BEGIN (pdistrwlock_nomem_test)
+{
+	p_libsys_init ();
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+	P_TEST_CHECK (p_dist_rwlock_new (0) == NULL);
+	P_TEST_CHECK (p_dist_rwlock_new (4) == NULL);
+
+	p_mem_restore_vtable ();
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pdistrwlock_bad_input_test)
+{
+	p_libsys_init ();
+
+	P_TEST_REQUIRE (p_dist_rwlock_reader_lock (NULL) == -1);
+	P_TEST_REQUIRE (p_dist_rwlock_reader_trylock (NULL) == -1);
+	P_TEST_REQUIRE (p_dist_rwlock_reader_unlock (NULL, 0) == FALSE);
+	P_TEST_REQUIRE (p_dist_rwlock_writer_lock (NULL) == FALSE);
+	P_TEST_REQUIRE (p_dist_rwlock_writer_trylock (NULL) == FALSE);
+	P_TEST_REQUIRE (p_dist_rwlock_writer_unlock (NULL) == FALSE);
+	p_dist_rwlock_free (NULL);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pdistrwlock_general_test)
+{
+	PUThread	*thr[PDISTRWLOCK_READERS + 1];
+	pint		slot;
+	pint		other_slot;
+	pint		i;
+
+	p_libsys_init ();
+
+	/* Slot numbers are rounded up to a power of two */
+	global_dist_lock = p_dist_rwlock_new (3);
+	P_TEST_REQUIRE (global_dist_lock != NULL);
+
+	slot = p_dist_rwlock_reader_lock (global_dist_lock);
+	P_TEST_CHECK (slot >= 0 && slot < 4);
+	P_TEST_CHECK (p_dist_rwlock_reader_unlock (global_dist_lock, -1) == FALSE);
+	P_TEST_CHECK (p_dist_rwlock_reader_unlock (global_dist_lock, 4) == FALSE);
+
+	other_slot = p_dist_rwlock_reader_trylock (global_dist_lock);
+	P_TEST_CHECK (other_slot >= 0);
+
+	P_TEST_CHECK (p_dist_rwlock_writer_trylock (global_dist_lock) == FALSE);
+	P_TEST_CHECK (p_dist_rwlock_reader_unlock (global_dist_lock, other_slot) == TRUE);
+	P_TEST_CHECK (p_dist_rwlock_writer_trylock (global_dist_lock) == FALSE);
+	P_TEST_CHECK (p_dist_rwlock_reader_unlock (global_dist_lock, slot) == TRUE);
+
+	P_TEST_CHECK (p_dist_rwlock_writer_trylock (global_dist_lock) == TRUE);
+	P_TEST_CHECK (p_dist_rwlock_reader_trylock (global_dist_lock) == -1);
+	P_TEST_CHECK (p_dist_rwlock_writer_trylock (global_dist_lock) == FALSE);
+	P_TEST_CHECK (p_dist_rwlock_writer_unlock (global_dist_lock) == TRUE);
+
+	P_TEST_CHECK (p_dist_rwlock_writer_lock (global_dist_lock) == TRUE);
+	P_TEST_CHECK (p_dist_rwlock_reader_trylock (global_dist_lock) == -1);
+	P_TEST_CHECK (p_dist_rwlock_writer_unlock (global_dist_lock) == TRUE);
+
+	p_dist_rwlock_free (global_dist_lock);
+
+	global_dist_lock = p_dist_rwlock_new (0);
+	P_TEST_REQUIRE (global_dist_lock != NULL);
+
+	dist_lock_value_1 = 0;
+	dist_lock_value_2 = 0;
+	p_atomic_int_set (&dist_lock_inside, 0);
+	p_atomic_int_set (&dist_lock_overlap, 0);
+	p_atomic_int_set (&dist_lock_mismatch, 0);
+
+	for (i = 0; i < PDISTRWLOCK_READERS; ++i) {
+		thr[i] = p_uthread_create ((PUThreadFunc) dist_lock_reader_thread, NULL, TRUE, NULL);
+		P_TEST_REQUIRE (thr[i] != NULL);
+	}
+
+	thr[PDISTRWLOCK_READERS] = p_uthread_create ((PUThreadFunc) dist_lock_writer_thread,
+						     NULL,
+						     TRUE,
+						     NULL);
+	P_TEST_REQUIRE (thr[PDISTRWLOCK_READERS] != NULL);
+
+	for (i = 0; i <= PDISTRWLOCK_READERS; ++i) {
+		P_TEST_CHECK (p_uthread_join (thr[i]) == 0);
+		p_uthread_unref (thr[i]);
+	}
+
+	P_TEST_CHECK (dist_lock_value_1 == PDISTRWLOCK_WRITER_ROUNDS);
+	P_TEST_CHECK (dist_lock_value_2 == PDISTRWLOCK_WRITER_ROUNDS);
+	P_TEST_CHECK (p_atomic_int_get (&dist_lock_overlap) == 0);
+	P_TEST_CHECK (p_atomic_int_get (&dist_lock_mismatch) == 0);
+
+	p_dist_rwlock_free (global_dist_lock);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pdistrwlock_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pdistrwlock_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (pdistrwlock_general_test);
+}
+P_TEST_SUITE_END()
@@ -96,10 +96,14 @@ P_TEST_CASE_BEGIN (perror_invalid_test)
 
 	p_error_set_error (NULL, 0, 0, NULL);
 	p_error_set_error_p (NULL, 0, 0, NULL);
+	p_error_set_error_static_p (NULL, 0, 0, NULL);
 
 	p_error_set_error_p (&error, 0, 0, NULL);
 	P_TEST_CHECK (error == (PError *) 0x1);
 
+	p_error_set_error_static_p (&error, 0, 0, NULL);
+	P_TEST_CHECK (error == (PError *) 0x1);
+
 	p_error_clear (NULL);
 	p_error_free (NULL);
 
@@ -210,6 +214,36 @@ P_TEST_CASE_BEGIN (perror_general_test)
 
 	p_error_free (error);
 
+	/* Static message is referenced, not copied */
+	error = NULL;
+	p_error_set_error_static_p (&error, 20, -20, PERROR_TEST_MESSAGE);
+
+	P_TEST_REQUIRE (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == 20);
+	P_TEST_CHECK (p_error_get_native_code (error) == -20);
+	P_TEST_CHECK (p_error_get_message (error) == (const pchar *) PERROR_TEST_MESSAGE);
+
+	copy_error = p_error_copy (error);
+
+	P_TEST_CHECK (copy_error != NULL);
+	P_TEST_CHECK (p_error_get_message (copy_error) != p_error_get_message (error));
+	P_TEST_CHECK (strcmp (p_error_get_message (copy_error), PERROR_TEST_MESSAGE) == 0);
+
+	p_error_free (copy_error);
+
+	/* Replacing the static message switches back to a copy */
+	p_error_set_message (error, PERROR_TEST_MESSAGE_2);
+	P_TEST_CHECK (strcmp (p_error_get_message (error), PERROR_TEST_MESSAGE_2) == 0);
+
+	p_error_free (error);
+
+	error = NULL;
+	p_error_set_error_static_p (&error, 20, -20, PERROR_TEST_MESSAGE);
+	p_error_clear (error);
+	P_TEST_CHECK (p_error_get_message (error) == NULL);
+
+	p_error_free (error);
+
 	/* System codes */
 	p_error_set_last_system (10);
 	P_TEST_CHECK (p_error_get_last_system () == 10);
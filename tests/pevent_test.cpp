@@ -0,0 +1,307 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+P_TEST_MODULE_INIT ();
+
+#define PEVENT_THREADS	4
+#define PEVENT_SIGNALS	10000
+
+typedef struct _SignalData {
+	PEvent		*event;
+	volatile pint	counter;
+	volatile pint	done;
+} SignalData;
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static void * signal_thread_func (void *data)
+{
+	SignalData *signal_data = (SignalData *) data;
+
+	for (pint i = 0; i < PEVENT_SIGNALS; ++i) {
+		p_atomic_int_inc (&signal_data->counter);
+		p_event_signal (signal_data->event);
+	}
+
+	p_atomic_int_inc (&signal_data->done);
+	p_event_signal (signal_data->event);
+
+	p_uthread_exit (0);
+
+	return NULL;
+}
+
+static void * delayed_signal_thread_func (void *data)
+{
+	p_uthread_sleep (50);
+	p_uthread_exit (p_event_signal ((PEvent *) data) == TRUE ? 1 : 0);
+
+	return NULL;
+}
+
+P_TEST_CASE_BEGIN (pevent_nomem_test)
+{
+	p_libsys_init ();
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (p_event_new (NULL) == NULL);
+
+	p_mem_restore_vtable ();
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pevent_invalid_test)
+{
+	p_libsys_init ();
+
+	PError *error = NULL;
+
+	P_TEST_CHECK (p_event_signal (NULL) == FALSE);
+	P_TEST_CHECK (p_event_clear (NULL) == FALSE);
+	P_TEST_CHECK (p_event_is_signaled (NULL) == FALSE);
+	P_TEST_CHECK (p_event_get_fd (NULL) == -1);
+
+	P_TEST_CHECK (p_socket_poller_add_event (NULL, NULL, NULL, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+	error = NULL;
+
+	P_TEST_CHECK (p_socket_poller_remove_event (NULL, NULL, NULL) == FALSE);
+
+	p_event_free (NULL);
+
+	PSocketPoller *poller = p_socket_poller_new (NULL);
+	P_TEST_REQUIRE (poller != NULL);
+
+	PEvent *event = p_event_new (NULL);
+	P_TEST_REQUIRE (event != NULL);
+
+	/* Not registered yet */
+	P_TEST_CHECK (p_socket_poller_remove_event (poller, event, NULL) == FALSE);
+
+	/* Twice */
+	P_TEST_CHECK (p_socket_poller_add_event (poller, event, NULL, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_poller_add_event (poller, event, NULL, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+
+	P_TEST_CHECK (p_socket_poller_get_count (poller) == 1);
+	P_TEST_CHECK (p_socket_poller_remove_event (poller, event, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_poller_get_count (poller) == 0);
+
+	p_socket_poller_free (poller);
+	p_event_free (event);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pevent_signal_test)
+{
+	p_libsys_init ();
+
+	PEvent *event = p_event_new (NULL);
+	P_TEST_REQUIRE (event != NULL);
+
+	P_TEST_CHECK (p_event_get_fd (event) >= 0);
+	P_TEST_CHECK (p_event_is_signaled (event) == FALSE);
+	P_TEST_CHECK (p_event_clear (event) == FALSE);
+
+	/* Signals coalesce */
+	for (pint i = 0; i < 100; ++i)
+		P_TEST_CHECK (p_event_signal (event) == TRUE);
+
+	P_TEST_CHECK (p_event_is_signaled (event) == TRUE);
+	P_TEST_CHECK (p_event_clear (event) == TRUE);
+	P_TEST_CHECK (p_event_is_signaled (event) == FALSE);
+	P_TEST_CHECK (p_event_clear (event) == FALSE);
+
+	/* The next signal goes through */
+	P_TEST_CHECK (p_event_signal (event) == TRUE);
+	P_TEST_CHECK (p_event_is_signaled (event) == TRUE);
+	P_TEST_CHECK (p_event_clear (event) == TRUE);
+
+	p_event_free (event);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pevent_poller_test)
+{
+	p_libsys_init ();
+
+	PSocketPollerEvent	events[4];
+	pint			marker;
+
+	PSocketPoller *poller = p_socket_poller_new (NULL);
+	P_TEST_REQUIRE (poller != NULL);
+
+	PEvent *event = p_event_new (NULL);
+	P_TEST_REQUIRE (event != NULL);
+
+	PSocket *socket = p_socket_new (P_SOCKET_FAMILY_INET,
+					P_SOCKET_TYPE_DATAGRAM,
+					P_SOCKET_PROTOCOL_UDP,
+					NULL);
+	P_TEST_REQUIRE (socket != NULL);
+
+	PSocketAddress *addr = p_socket_address_new ("127.0.0.1", 0);
+	P_TEST_REQUIRE (addr != NULL);
+	P_TEST_REQUIRE (p_socket_bind (socket, addr, FALSE, NULL) == TRUE);
+	p_socket_address_free (addr);
+
+	p_socket_set_blocking (socket, FALSE);
+
+	/* Sockets and events share the poll set */
+	P_TEST_CHECK (p_socket_poller_add (poller,
+					   socket,
+					   P_SOCKET_POLLER_CONDITION_IN,
+					   P_SOCKET_POLLER_FLAG_NONE,
+					   NULL,
+					   NULL) == TRUE);
+	P_TEST_CHECK (p_socket_poller_add_event (poller, event, &marker, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_poller_get_count (poller) == 2);
+
+	P_TEST_CHECK (p_socket_poller_wait (poller, events, 4, 0, NULL) == 0);
+
+	/* Another thread wakes up the blocked one */
+	PUThread *thread = p_uthread_create ((PUThreadFunc) delayed_signal_thread_func, event, TRUE, NULL);
+	P_TEST_REQUIRE (thread != NULL);
+
+	P_TEST_CHECK (p_socket_poller_wait (poller, events, 4, 10000, NULL) == 1);
+	P_TEST_CHECK (events[0].socket == NULL);
+	P_TEST_CHECK (events[0].user_data == &marker);
+	P_TEST_CHECK ((events[0].conditions & P_SOCKET_POLLER_CONDITION_IN) != 0);
+
+	P_TEST_CHECK (p_uthread_join (thread) == 1);
+	p_uthread_unref (thread);
+
+	/* Reported until cleared */
+	P_TEST_CHECK (p_socket_poller_wait (poller, events, 4, 0, NULL) == 1);
+	P_TEST_CHECK (p_event_clear (event) == TRUE);
+	P_TEST_CHECK (p_socket_poller_wait (poller, events, 4, 0, NULL) == 0);
+
+	P_TEST_CHECK (p_socket_poller_remove_event (poller, event, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_poller_remove (poller, socket, NULL) == TRUE);
+
+	p_socket_poller_free (poller);
+	p_socket_free (socket);
+	p_event_free (event);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pevent_threads_test)
+{
+	p_libsys_init ();
+
+	SignalData		data;
+	PSocketPollerEvent	events[1];
+	PUThread		*threads[PEVENT_THREADS];
+	pint			wakeups = 0;
+
+	data.event   = p_event_new (NULL);
+	data.counter = 0;
+	data.done    = 0;
+
+	P_TEST_REQUIRE (data.event != NULL);
+
+	PSocketPoller *poller = p_socket_poller_new (NULL);
+	P_TEST_REQUIRE (poller != NULL);
+
+	P_TEST_CHECK (p_socket_poller_add_event (poller, data.event, NULL, NULL) == TRUE);
+
+	for (pint i = 0; i < PEVENT_THREADS; ++i) {
+		threads[i] = p_uthread_create ((PUThreadFunc) signal_thread_func, &data, TRUE, NULL);
+		P_TEST_REQUIRE (threads[i] != NULL);
+	}
+
+	/* The state is checked after clearing, so no signal is ever lost */
+	while (p_atomic_int_get (&data.done) < PEVENT_THREADS) {
+		if (p_socket_poller_wait (poller, events, 1, 10000, NULL) != 1)
+			break;
+
+		p_event_clear (data.event);
+		++wakeups;
+	}
+
+	P_TEST_CHECK (p_atomic_int_get (&data.done) == PEVENT_THREADS);
+	P_TEST_CHECK (p_atomic_int_get (&data.counter) == PEVENT_THREADS * PEVENT_SIGNALS);
+
+	P_TEST_CHECK (wakeups > 0);
+
+	for (pint i = 0; i < PEVENT_THREADS; ++i) {
+		P_TEST_CHECK (p_uthread_join (threads[i]) == 0);
+		p_uthread_unref (threads[i]);
+	}
+
+	P_TEST_CHECK (p_socket_poller_remove_event (poller, data.event, NULL) == TRUE);
+
+	p_socket_poller_free (poller);
+	p_event_free (data.event);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pevent_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pevent_invalid_test);
+	P_TEST_SUITE_RUN_CASE (pevent_signal_test);
+	P_TEST_SUITE_RUN_CASE (pevent_poller_test);
+	P_TEST_SUITE_RUN_CASE (pevent_threads_test);
+}
+P_TEST_SUITE_END()
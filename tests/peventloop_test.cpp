@@ -0,0 +1,575 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+P_TEST_MODULE_INIT ();
+
+#define PEVENTLOOP_POST_THREADS	4
+#define PEVENTLOOP_POST_COUNT	1000
+
+typedef struct _PostData {
+	PEventLoop	*loop;
+	volatile pint	counter;
+} PostData;
+
+typedef struct _TimerData {
+	pint		fired;
+	pint		limit;
+	PEventLoopTimer	*other;
+} TimerData;
+
+typedef struct _SocketData {
+	PSocket		*sockets[2];
+	pint		fired[2];
+	pboolean	remove_other;
+} SocketData;
+
+static pchar socket_data[] = "This is a socket test data";
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static PSocket * create_udp_socket (void)
+{
+	PSocket *socket = p_socket_new (P_SOCKET_FAMILY_INET,
+					P_SOCKET_TYPE_DATAGRAM,
+					P_SOCKET_PROTOCOL_UDP,
+					NULL);
+
+	if (socket == NULL)
+		return NULL;
+
+	PSocketAddress *addr = p_socket_address_new ("127.0.0.1", 0);
+
+	if (addr == NULL || !p_socket_bind (socket, addr, FALSE, NULL)) {
+		p_socket_address_free (addr);
+		p_socket_free (socket);
+		return NULL;
+	}
+
+	p_socket_address_free (addr);
+	p_socket_set_blocking (socket, FALSE);
+
+	return socket;
+}
+
+static pboolean send_to_socket (PSocket *sender, PSocket *receiver)
+{
+	PSocketAddress *addr = p_socket_get_local_address (receiver, NULL);
+
+	if (addr == NULL)
+		return FALSE;
+
+	pssize sent = p_socket_send_to (sender, addr, socket_data, sizeof (socket_data), NULL);
+
+	p_socket_address_free (addr);
+
+	return sent == (pssize) sizeof (socket_data);
+}
+
+static void empty_task (PEventLoop *loop, ppointer user_data)
+{
+	P_UNUSED (loop);
+	P_UNUSED (user_data);
+}
+
+static void empty_socket_func (PEventLoop *loop, PSocket *socket, pint conditions, ppointer user_data)
+{
+	P_UNUSED (loop);
+	P_UNUSED (socket);
+	P_UNUSED (conditions);
+	P_UNUSED (user_data);
+}
+
+static void empty_timer_func (PEventLoop *loop, PEventLoopTimer *timer, ppointer user_data)
+{
+	P_UNUSED (loop);
+	P_UNUSED (timer);
+	P_UNUSED (user_data);
+}
+
+static void count_task (PEventLoop *loop, ppointer user_data)
+{
+	P_UNUSED (loop);
+
+	p_atomic_int_inc (&((PostData *) user_data)->counter);
+}
+
+static void stop_task (PEventLoop *loop, ppointer user_data)
+{
+	P_UNUSED (user_data);
+
+	p_event_loop_stop (loop);
+}
+
+static void nested_post_task (PEventLoop *loop, ppointer user_data)
+{
+	PostData *data = (PostData *) user_data;
+
+	p_atomic_int_inc (&data->counter);
+
+	/* Goes to the next batch, otherwise the loop would never finish */
+	p_event_loop_post (loop, count_task, data);
+}
+
+static void * post_thread_func (void *data)
+{
+	PostData *post_data = (PostData *) data;
+
+	for (pint i = 0; i < PEVENTLOOP_POST_COUNT; ++i)
+		p_event_loop_post (post_data->loop, count_task, post_data);
+
+	p_uthread_exit (0);
+
+	return NULL;
+}
+
+static void * run_thread_func (void *data)
+{
+	p_uthread_exit (p_event_loop_run ((PEventLoop *) data, NULL) == TRUE ? 1 : 0);
+
+	return NULL;
+}
+
+static void count_timer_func (PEventLoop *loop, PEventLoopTimer *timer, ppointer user_data)
+{
+	TimerData *data = (TimerData *) user_data;
+
+	if (++data->fired == data->limit)
+		p_event_loop_cancel_timer (loop, timer);
+
+	if (data->other != NULL) {
+		p_event_loop_cancel_timer (loop, data->other);
+		data->other = NULL;
+	}
+}
+
+static void socket_func (PEventLoop *loop, PSocket *socket, pint conditions, ppointer user_data)
+{
+	SocketData	*data = (SocketData *) user_data;
+	pchar		buf[64];
+	pint		index = socket == data->sockets[0] ? 0 : 1;
+
+	P_TEST_CHECK ((conditions & P_SOCKET_POLLER_CONDITION_IN) != 0);
+
+	++data->fired[index];
+
+	while (p_socket_receive (socket, buf, sizeof (buf), NULL) > 0)
+		;
+
+	/* The other socket must not be reported after the removal */
+	if (data->remove_other == TRUE) {
+		p_event_loop_remove_socket (loop, data->sockets[1 - index], NULL);
+		data->remove_other = FALSE;
+	}
+}
+
+P_TEST_CASE_BEGIN (peventloop_nomem_test)
+{
+	p_libsys_init ();
+
+	PEventLoop *loop = p_event_loop_new (NULL);
+	P_TEST_REQUIRE (loop != NULL);
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	PError *error = NULL;
+
+	P_TEST_CHECK (p_event_loop_new (&error) == NULL);
+	P_TEST_CHECK (p_event_loop_add_timer (loop, 10, 0, empty_timer_func, NULL) == NULL);
+	P_TEST_CHECK (p_event_loop_post (loop, empty_task, NULL) == FALSE);
+	P_TEST_CHECK (p_event_loop_group_new (1, NULL) == NULL);
+
+	p_mem_restore_vtable ();
+
+	p_error_free (error);
+
+	P_TEST_CHECK (p_event_loop_run_once (loop, 0, NULL) == 0);
+
+	p_event_loop_free (loop);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (peventloop_invalid_test)
+{
+	p_libsys_init ();
+
+	PError *error = NULL;
+
+	P_TEST_CHECK (p_event_loop_add_socket (NULL, NULL, 0, 0, NULL, NULL, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+	error = NULL;
+
+	P_TEST_CHECK (p_event_loop_modify_socket (NULL, NULL, 0, 0, NULL) == FALSE);
+	P_TEST_CHECK (p_event_loop_remove_socket (NULL, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_event_loop_add_timer (NULL, 0, 0, empty_timer_func, NULL) == NULL);
+	P_TEST_CHECK (p_event_loop_cancel_timer (NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_event_loop_post (NULL, empty_task, NULL) == FALSE);
+	P_TEST_CHECK (p_event_loop_run_once (NULL, 0, NULL) == -1);
+	P_TEST_CHECK (p_event_loop_run (NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_event_loop_group_get_count (NULL) == 0);
+	P_TEST_CHECK (p_event_loop_group_get_loop (NULL, 0) == NULL);
+	P_TEST_CHECK (p_event_loop_group_next (NULL) == NULL);
+
+	p_event_loop_stop (NULL);
+	p_event_loop_free (NULL);
+	p_event_loop_group_free (NULL);
+
+	PEventLoop *loop = p_event_loop_new (NULL);
+	P_TEST_REQUIRE (loop != NULL);
+
+	PSocket *socket = create_udp_socket ();
+	P_TEST_REQUIRE (socket != NULL);
+
+	P_TEST_CHECK (p_event_loop_add_socket (loop, socket, P_SOCKET_POLLER_CONDITION_IN, 0, NULL, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_event_loop_add_timer (loop, 0, 0, NULL, NULL) == NULL);
+	P_TEST_CHECK (p_event_loop_post (loop, NULL, NULL) == FALSE);
+
+	/* Not registered yet */
+	P_TEST_CHECK (p_event_loop_modify_socket (loop, socket, P_SOCKET_POLLER_CONDITION_IN, 0, NULL) == FALSE);
+	P_TEST_CHECK (p_event_loop_remove_socket (loop, socket, NULL) == FALSE);
+
+	/* Twice */
+	P_TEST_CHECK (p_event_loop_add_socket (loop,
+					       socket,
+					       P_SOCKET_POLLER_CONDITION_IN,
+					       0,
+					       empty_socket_func,
+					       NULL,
+					       NULL) == TRUE);
+	P_TEST_CHECK (p_event_loop_add_socket (loop,
+					       socket,
+					       P_SOCKET_POLLER_CONDITION_IN,
+					       0,
+					       empty_socket_func,
+					       NULL,
+					       NULL) == FALSE);
+
+	/* Sockets are left to the caller */
+	p_event_loop_free (loop);
+	p_socket_free (socket);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (peventloop_post_test)
+{
+	p_libsys_init ();
+
+	PostData data;
+
+	data.loop    = p_event_loop_new (NULL);
+	data.counter = 0;
+
+	P_TEST_REQUIRE (data.loop != NULL);
+
+	/* Tasks posted from the loop thread run in the same iteration */
+	P_TEST_CHECK (p_event_loop_post (data.loop, count_task, &data) == TRUE);
+	P_TEST_CHECK (p_event_loop_post (data.loop, count_task, &data) == TRUE);
+	P_TEST_CHECK (p_event_loop_run_once (data.loop, -1, NULL) == 2);
+	P_TEST_CHECK (data.counter == 2);
+
+	/* Nothing is pending, so the timeout is honored */
+	P_TEST_CHECK (p_event_loop_run_once (data.loop, 0, NULL) == 0);
+
+	/* A task posted by another task waits for the next iteration */
+	P_TEST_CHECK (p_event_loop_post (data.loop, nested_post_task, &data) == TRUE);
+	P_TEST_CHECK (p_event_loop_run_once (data.loop, -1, NULL) == 1);
+	P_TEST_CHECK (data.counter == 3);
+	P_TEST_CHECK (p_event_loop_run_once (data.loop, -1, NULL) == 1);
+	P_TEST_CHECK (data.counter == 4);
+
+	/* Cross-thread posting wakes up the blocked loop */
+	data.counter = 0;
+
+	PUThread *run_thread = p_uthread_create ((PUThreadFunc) run_thread_func, data.loop, TRUE, NULL);
+	P_TEST_REQUIRE (run_thread != NULL);
+
+	PUThread *threads[PEVENTLOOP_POST_THREADS];
+
+	for (pint i = 0; i < PEVENTLOOP_POST_THREADS; ++i) {
+		threads[i] = p_uthread_create ((PUThreadFunc) post_thread_func, &data, TRUE, NULL);
+		P_TEST_REQUIRE (threads[i] != NULL);
+	}
+
+	for (pint i = 0; i < PEVENTLOOP_POST_THREADS; ++i) {
+		P_TEST_CHECK (p_uthread_join (threads[i]) == 0);
+		p_uthread_unref (threads[i]);
+	}
+
+	/* Runs after all the tasks posted before it */
+	P_TEST_CHECK (p_event_loop_post (data.loop, stop_task, NULL) == TRUE);
+
+	P_TEST_CHECK (p_uthread_join (run_thread) == 1);
+	p_uthread_unref (run_thread);
+
+	P_TEST_CHECK (data.counter == PEVENTLOOP_POST_THREADS * PEVENTLOOP_POST_COUNT);
+
+	/* Pending tasks are dropped */
+	P_TEST_CHECK (p_event_loop_post (data.loop, count_task, &data) == TRUE);
+
+	p_event_loop_free (data.loop);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (peventloop_timer_test)
+{
+	p_libsys_init ();
+
+	PEventLoop *loop = p_event_loop_new (NULL);
+	P_TEST_REQUIRE (loop != NULL);
+
+	TimerData one_shot  = {0, 0, NULL};
+	TimerData periodic  = {0, 3, NULL};
+	TimerData cancelled = {0, 0, NULL};
+	TimerData pending   = {0, 0, NULL};
+
+	PEventLoopTimer *timer;
+
+	P_TEST_CHECK (p_event_loop_add_timer (loop, 5, 0, count_timer_func, &one_shot) != NULL);
+	P_TEST_CHECK (p_event_loop_add_timer (loop, 2, 2, count_timer_func, &periodic) != NULL);
+
+	timer = p_event_loop_add_timer (loop, 1000, 0, count_timer_func, &cancelled);
+	P_TEST_REQUIRE (timer != NULL);
+
+	/* Cancelled by the one-shot timer */
+	one_shot.other = timer;
+
+	P_TEST_CHECK (p_event_loop_add_timer (loop, 100000, 0, count_timer_func, &pending) != NULL);
+
+	PTimeProfiler *profiler = p_time_profiler_new ();
+	P_TEST_REQUIRE (profiler != NULL);
+
+	/* The loop sleeps until the nearest deadline */
+	while ((one_shot.fired == 0 || periodic.fired < periodic.limit) &&
+	       p_time_profiler_elapsed_usecs (profiler) < 5000000ULL)
+		P_TEST_CHECK (p_event_loop_run_once (loop, -1, NULL) >= 0);
+
+	P_TEST_CHECK (one_shot.fired == 1);
+	P_TEST_CHECK (periodic.fired == periodic.limit);
+	P_TEST_CHECK (one_shot.other == NULL);
+
+	timer = p_event_loop_add_timer (loop, 1, 0, count_timer_func, &cancelled);
+	P_TEST_REQUIRE (timer != NULL);
+	P_TEST_CHECK (p_event_loop_cancel_timer (loop, timer) == TRUE);
+
+	p_uthread_sleep (10);
+
+	P_TEST_CHECK (p_event_loop_run_once (loop, 0, NULL) == 0);
+	P_TEST_CHECK (cancelled.fired == 0);
+	P_TEST_CHECK (periodic.fired == periodic.limit);
+
+	p_time_profiler_free (profiler);
+
+	/* Pending timers are released without firing */
+	p_event_loop_free (loop);
+
+	P_TEST_CHECK (pending.fired == 0);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (peventloop_socket_test)
+{
+	p_libsys_init ();
+
+	PEventLoop *loop = p_event_loop_new (NULL);
+	P_TEST_REQUIRE (loop != NULL);
+
+	SocketData data;
+
+	data.sockets[0]   = create_udp_socket ();
+	data.sockets[1]   = create_udp_socket ();
+	data.fired[0]     = 0;
+	data.fired[1]     = 0;
+	data.remove_other = FALSE;
+
+	P_TEST_REQUIRE (data.sockets[0] != NULL);
+	P_TEST_REQUIRE (data.sockets[1] != NULL);
+
+	for (pint i = 0; i < 2; ++i)
+		P_TEST_CHECK (p_event_loop_add_socket (loop,
+						       data.sockets[i],
+						       P_SOCKET_POLLER_CONDITION_IN,
+						       P_SOCKET_POLLER_FLAG_NONE,
+						       socket_func,
+						       &data,
+						       NULL) == TRUE);
+
+	P_TEST_CHECK (p_event_loop_run_once (loop, 0, NULL) == 0);
+
+	P_TEST_CHECK (send_to_socket (data.sockets[0], data.sockets[1]) == TRUE);
+	P_TEST_CHECK (p_event_loop_run_once (loop, 1000, NULL) == 1);
+	P_TEST_CHECK (data.fired[0] == 0);
+	P_TEST_CHECK (data.fired[1] == 1);
+
+	/* Both sockets are ready, the first dispatched one removes the other */
+	P_TEST_CHECK (send_to_socket (data.sockets[0], data.sockets[1]) == TRUE);
+	P_TEST_CHECK (send_to_socket (data.sockets[1], data.sockets[0]) == TRUE);
+
+	p_uthread_sleep (10);
+
+	data.remove_other = TRUE;
+
+	P_TEST_CHECK (p_event_loop_run_once (loop, 1000, NULL) == 1);
+	P_TEST_CHECK (data.fired[0] + data.fired[1] == 2);
+	P_TEST_CHECK (data.remove_other == FALSE);
+
+	/* Modifying the conditions of a remaining socket */
+	pint remaining = data.fired[0] == 1 ? 0 : 1;
+
+	P_TEST_CHECK (p_event_loop_modify_socket (loop,
+						  data.sockets[remaining],
+						  P_SOCKET_POLLER_CONDITION_IN,
+						  P_SOCKET_POLLER_FLAG_NONE,
+						  NULL) == TRUE);
+	P_TEST_CHECK (p_event_loop_remove_socket (loop, data.sockets[remaining], NULL) == TRUE);
+	P_TEST_CHECK (p_event_loop_remove_socket (loop, data.sockets[remaining], NULL) == FALSE);
+
+	p_event_loop_free (loop);
+
+	p_socket_free (data.sockets[0]);
+	p_socket_free (data.sockets[1]);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (peventloop_stop_test)
+{
+	p_libsys_init ();
+
+	PEventLoop *loop = p_event_loop_new (NULL);
+	P_TEST_REQUIRE (loop != NULL);
+
+	/* Stop requested in advance makes the next run return at once */
+	p_event_loop_stop (loop);
+	P_TEST_CHECK (p_event_loop_run (loop, NULL) == TRUE);
+
+	/* The loop can be run again */
+	P_TEST_CHECK (p_event_loop_post (loop, stop_task, NULL) == TRUE);
+	P_TEST_CHECK (p_event_loop_run (loop, NULL) == TRUE);
+
+	PUThread *thread = p_uthread_create ((PUThreadFunc) run_thread_func, loop, TRUE, NULL);
+	P_TEST_REQUIRE (thread != NULL);
+
+	p_uthread_sleep (20);
+
+	p_event_loop_stop (loop);
+
+	P_TEST_CHECK (p_uthread_join (thread) == 1);
+	p_uthread_unref (thread);
+
+	p_event_loop_free (loop);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (peventloop_group_test)
+{
+	p_libsys_init ();
+
+	PEventLoopGroup *group = p_event_loop_group_new (3, NULL);
+	P_TEST_REQUIRE (group != NULL);
+
+	P_TEST_CHECK (p_event_loop_group_get_count (group) == 3);
+	P_TEST_CHECK (p_event_loop_group_get_loop (group, 3) == NULL);
+	P_TEST_CHECK (p_event_loop_group_get_loop (group, -1) == NULL);
+
+	/* Round-robin over the loops */
+	for (pint i = 0; i < 6; ++i)
+		P_TEST_CHECK (p_event_loop_group_next (group) == p_event_loop_group_get_loop (group, i % 3));
+
+	PostData data;
+
+	data.loop    = NULL;
+	data.counter = 0;
+
+	for (pint i = 0; i < 300; ++i)
+		P_TEST_CHECK (p_event_loop_post (p_event_loop_group_next (group), count_task, &data) == TRUE);
+
+	PTimeProfiler *profiler = p_time_profiler_new ();
+	P_TEST_REQUIRE (profiler != NULL);
+
+	while (p_atomic_int_get (&data.counter) != 300 &&
+	       p_time_profiler_elapsed_usecs (profiler) < 5000000ULL)
+		p_uthread_sleep (1);
+
+	P_TEST_CHECK (p_atomic_int_get (&data.counter) == 300);
+
+	p_time_profiler_free (profiler);
+	p_event_loop_group_free (group);
+
+	group = p_event_loop_group_new (0, NULL);
+	P_TEST_REQUIRE (group != NULL);
+	P_TEST_CHECK (p_event_loop_group_get_count (group) == p_uthread_ideal_count ());
+	p_event_loop_group_free (group);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (peventloop_nomem_test);
+	P_TEST_SUITE_RUN_CASE (peventloop_invalid_test);
+	P_TEST_SUITE_RUN_CASE (peventloop_post_test);
+	P_TEST_SUITE_RUN_CASE (peventloop_timer_test);
+	P_TEST_SUITE_RUN_CASE (peventloop_socket_test);
+	P_TEST_SUITE_RUN_CASE (peventloop_stop_test);
+	P_TEST_SUITE_RUN_CASE (peventloop_group_test);
+}
+P_TEST_SUITE_END()
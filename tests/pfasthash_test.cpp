@@ -0,0 +1,431 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <string.h>
+
+P_TEST_MODULE_INIT ();
+
+#define PFASTHASH_DATA_LENGTH	4096
+#define PFASTHASH_STREAM_LENGTH	3000
+
+typedef struct PFastHashVector_ {
+	psize	len;
+	pint	seed_idx;
+	puint64	xxh3_64;
+	puint64	xxh3_128_low;
+	puint64	xxh3_128_high;
+	puint32	crc32c;
+} PFastHashVector;
+
+/* Seeds are {0, 0x9E3779B97F4A7C15} for xxHash3 and {0, 0x12345678} for CRC32C */
+static const PFastHashVector pp_fast_hash_vectors[] = {
+	{    0, 0, 0x2D06800538D394C2ULL, 0x6001C324468D497FULL, 0x99AA06D3014798D8ULL, 0x00000000U },
+	{    1, 0, 0x4C5CCA45D0F4811FULL, 0x4C5CCA45D0F4811FULL, 0x495B62073EF70CA4ULL, 0x86B737BAU },
+	{    2, 0, 0x29C60963CBFA4E6EULL, 0x29C60963CBFA4E6EULL, 0xF1B5EEC902A1EB5EULL, 0x6218ADD7U },
+	{    3, 0, 0x6E3E2670E61106ACULL, 0x6E3E2670E61106ACULL, 0x390CDC5B4A895DD7ULL, 0xEA2E826FU },
+	{    4, 0, 0x5C4C63133443D03FULL, 0x3D668AF6F2A44D77ULL, 0xAA6E2F274640A3F4ULL, 0xFFEA2E82U },
+	{    5, 0, 0x49F5EB3111280B63ULL, 0x62853C5F1A6EDA6EULL, 0xD9DA89DA8D7E169AULL, 0x3241C66BU },
+	{    8, 0, 0xF9FD4DD0B04D78F5ULL, 0x61DDBE7F31A6100DULL, 0x6A86A3BDA6AF4E3DULL, 0x0E9DB014U },
+	{    9, 0, 0x7C20DF9712C26EDFULL, 0x8C7B67FD458A936BULL, 0x664C7CA18AFD6255ULL, 0xCBFA65DAU },
+	{   12, 0, 0x16D2DFF54DC2EE45ULL, 0xCDEBA3D6707F8F04ULL, 0xDAB57051AFE30B1DULL, 0x41BFF713U },
+	{   16, 0, 0x86ABF6BACCEA0858ULL, 0xE2CE54A7C19C730DULL, 0x7F9A218B0425449AULL, 0x6332CF65U },
+	{   17, 0, 0xB58BF5DC5022D071ULL, 0x8D96EF110FCDEBB4ULL, 0x66FC23F6439DBD77ULL, 0xE200CBBAU },
+	{   32, 0, 0xE3712ED84C04A66EULL, 0xFD357CF6CB2DDA18ULL, 0x49A11EE743D6D342ULL, 0x4C0B9882U },
+	{   33, 0, 0xA4DEE99B093E1F73ULL, 0xF8994653F4BFE6DAULL, 0x7228D9284A8116F6ULL, 0x84F0E4CFU },
+	{   64, 0, 0x1291D2D4042330DDULL, 0xBA7E015A54F14BE1ULL, 0xE0FAF20E0E0FE0DDULL, 0x9EB01D51U },
+	{   65, 0, 0x97C6BF83217E5EC9ULL, 0x85326F4078A61329ULL, 0x9397DF27B7A98713ULL, 0xE6EAF8B3U },
+	{   96, 0, 0x81296929FC063365ULL, 0x8B8720F565DCF40CULL, 0xFB78AC185EF55443ULL, 0x01693014U },
+	{   97, 0, 0xF145A45B658AB9DDULL, 0xBB385623E598C6D4ULL, 0x9CFC8C7D6E7815C8ULL, 0x71CF8024U },
+	{  128, 0, 0x10D17F72C0CCBA41ULL, 0xFF361DEC1385710AULL, 0xAEC730751478556CULL, 0xACA10E82U },
+	{  129, 0, 0x3726A37E48A298EEULL, 0xB3D129936667C5A3ULL, 0xAED510DB69291969ULL, 0x3933DA67U },
+	{  200, 0, 0xDD3658C6F0808DC8ULL, 0x141A236F2FC41233ULL, 0x7E0BDCBD52E533A0ULL, 0x4A9CA6C0U },
+	{  240, 0, 0x651A1549A7C24D40ULL, 0x104BCB360531964DULL, 0x898F80ECAEC8DF00ULL, 0x5B938F01U },
+	{  241, 0, 0xAB75DB49DCDD8BC7ULL, 0xAB75DB49DCDD8BC7ULL, 0x99B8870A5ED7D57BULL, 0xF947FAB9U },
+	{  255, 0, 0x3FA3D63594346755ULL, 0x3FA3D63594346755ULL, 0xCA304A0851A379B0ULL, 0x10D26929U },
+	{  256, 0, 0xE6B3C5D6C6EFF46AULL, 0xE6B3C5D6C6EFF46AULL, 0x2A97AFC55F827F49ULL, 0xBD65FB4EU },
+	{  257, 0, 0x65CDF7EE1838B400ULL, 0x65CDF7EE1838B400ULL, 0x3914E6F7CC28A88DULL, 0xC7714FFDU },
+	{  511, 0, 0xF5A04D1DC3478D04ULL, 0xF5A04D1DC3478D04ULL, 0x4FE2EAE6E925B4FDULL, 0x7ECC1C98U },
+	{ 1023, 0, 0xC2BB479A12B0FA7BULL, 0xC2BB479A12B0FA7BULL, 0x7E531AD2F3D4F3D5ULL, 0x5402CF44U },
+	{ 1024, 0, 0xA30BB8E30E3E000BULL, 0xA30BB8E30E3E000BULL, 0x36507BFE79FC9D6BULL, 0xCFB74B7EU },
+	{ 1025, 0, 0xF06ED38BB8EBC1A3ULL, 0xF06ED38BB8EBC1A3ULL, 0xCB6CBF7BAD3ECD6FULL, 0xD1413314U },
+	{ 2047, 0, 0x5B1AEA13277D1A3AULL, 0x5B1AEA13277D1A3AULL, 0xCA340327123C35D2ULL, 0x2E9973DCU },
+	{ 2048, 0, 0x64DF28E8C7967DCEULL, 0x64DF28E8C7967DCEULL, 0x34CFC52C10E64E06ULL, 0x4D3BEBBAU },
+	{ 2049, 0, 0xF400EC0A640E77D1ULL, 0xF400EC0A640E77D1ULL, 0xC8BD2D034D1ACAF7ULL, 0x4F5391CFU },
+	{ 4095, 0, 0x78DB1C3558F826F2ULL, 0x78DB1C3558F826F2ULL, 0xF14227CA9BEFBB39ULL, 0x7B51E26BU },
+	{    0, 1, 0x602B0E2CD6662C8BULL, 0x4CA5176998171787ULL, 0xD142977A2CCA554BULL, 0x12345678U },
+	{    1, 1, 0x2F3ACD3805F81DE3ULL, 0x2F3ACD3805F81DE3ULL, 0x00A711EB5A736B26ULL, 0x7DE40F2EU },
+	{    2, 1, 0x28A7B77C08C091EBULL, 0x28A7B77C08C091EBULL, 0x729F8AAE8729063CULL, 0x37D195E7U },
+	{    3, 1, 0xBC74611D87F659E0ULL, 0xBC74611D87F659E0ULL, 0x3F5FD00FF400BA58ULL, 0xDA9802E6U },
+	{    4, 1, 0x6C3753177C607DE4ULL, 0xC63AF37DA30D5D08ULL, 0x7E5D191BD8D354E6ULL, 0x059E78B6U },
+	{    5, 1, 0xC527066B4C496B85ULL, 0x2CC1691173E89377ULL, 0x6BE318DC7B2FB79CULL, 0xC5C26C93U },
+	{    8, 1, 0xBC72D0531396303FULL, 0x8A88691D5CECB7B6ULL, 0x9B51BCD70BE038F6ULL, 0x44D7DD03U },
+	{    9, 1, 0x93C5AA006102DAF5ULL, 0xA1E691E73AAF9CA5ULL, 0xC0DD1F12F479931BULL, 0x0F248C33U },
+	{   12, 1, 0xFE7FFCDD4D01FE31ULL, 0x442320DA91F80FFAULL, 0xFE7263475BAD3E1EULL, 0xFBEB8D5EU },
+	{   16, 1, 0x69D001B16ECF450AULL, 0x1097F793402C818AULL, 0xD5F6FDBF62CDC681ULL, 0xEEA50E08U },
+	{   17, 1, 0xB7C99D19BE27EB69ULL, 0x553306F0D043114CULL, 0xFDB93EA9BD7C5A87ULL, 0x3C6383CAU },
+	{   32, 1, 0xE5FB38C81D49C6F5ULL, 0x8113676252DBE0C7ULL, 0x731432CBCC022E37ULL, 0x5658D8B5U },
+	{   33, 1, 0x5A46A370C35146ACULL, 0x8BAA0FEC23CFDDF3ULL, 0xA5369ADEEDA33584ULL, 0x60C39AD5U },
+	{   64, 1, 0x543FA55D8DB03991ULL, 0x60CE1B9D00AC1042ULL, 0x6C800FCD18B46B32ULL, 0x0991DA8EU },
+	{   65, 1, 0xF3EFE40559A76A28ULL, 0xAFDEC891BF7066BDULL, 0x6D799965351E22D8ULL, 0x6BBD04FBU },
+	{   96, 1, 0x260F288635623EE8ULL, 0x79CD945D75928CA3ULL, 0x4B06B5D340F2CB02ULL, 0xB14BB9D9U },
+	{   97, 1, 0x58817B2A6EC0ED2EULL, 0x2EA3921926F4CF9DULL, 0x0BE14F6D3382FC98ULL, 0x0DDAC8BAU },
+	{  128, 1, 0x49B81C6E0ABB9305ULL, 0x18528564127001A4ULL, 0x98B7168A26969C36ULL, 0x4E10033CU },
+	{  129, 1, 0xB29221FEE4632617ULL, 0x27BF46903B3297DBULL, 0xB6B8AF955CAD8A22ULL, 0x27BCA684U },
+	{  200, 1, 0x9DADF3C27C6268F9ULL, 0x4D055107BB0EA392ULL, 0x5EB4C1EC57A8C9BEULL, 0x922481B3U },
+	{  240, 1, 0x4C55A337ECAB75CEULL, 0x01558C7CDE4DEAEEULL, 0x0685EBD890650692ULL, 0x50114CC4U },
+	{  241, 1, 0xF47DCB240E9539B4ULL, 0xF47DCB240E9539B4ULL, 0x26A578DB9B1E0515ULL, 0x0F304AA2U },
+	{  255, 1, 0xEDBCD7A1A2F92EF5ULL, 0xEDBCD7A1A2F92EF5ULL, 0xA89B65E6643BC3FAULL, 0xDE4A2881U },
+	{  256, 1, 0x55052B6AA048A388ULL, 0x55052B6AA048A388ULL, 0x9EBA6E12D6B5B2D3ULL, 0x95398E66U },
+	{  257, 1, 0x883A1302433E6F88ULL, 0x883A1302433E6F88ULL, 0xA3819DBAC1D509DBULL, 0x6D3DC599U },
+	{  511, 1, 0x5C2A063F03DA103BULL, 0x5C2A063F03DA103BULL, 0xC6CE747E1BDD4A67ULL, 0x80BE6033U },
+	{ 1023, 1, 0x3D23A30E78A7101BULL, 0x3D23A30E78A7101BULL, 0xCFFFE4381FC39986ULL, 0x1EFA1F33U },
+	{ 1024, 1, 0xF070C0297BDAF21AULL, 0xF070C0297BDAF21AULL, 0xA9DC49CDEC905513ULL, 0x6AAF8348U },
+	{ 1025, 1, 0x5CB3E341EF69B142ULL, 0x5CB3E341EF69B142ULL, 0xB1E093AA05935616ULL, 0xC7A68585U },
+	{ 2047, 1, 0x9AF62A15C77906BBULL, 0x9AF62A15C77906BBULL, 0xEAFCB4ECD953585EULL, 0x7B77AB6CU },
+	{ 2048, 1, 0x6EE5E80CE71478B4ULL, 0x6EE5E80CE71478B4ULL, 0x57529C2144975FB4ULL, 0xFF7B77ABU },
+	{ 2049, 1, 0x7B6D056B4AC56F75ULL, 0x7B6D056B4AC56F75ULL, 0x4D1C1BE3FB6B69D1ULL, 0xADD4953FU },
+	{ 4095, 1, 0xE530573E2F7F1A8BULL, 0xE530573E2F7F1A8BULL, 0x56564FD11D25ECC1ULL, 0x91296D60U },
+};
+
+static const puint64 pp_fast_hash_xxh3_seeds[] = { 0, 0x9E3779B97F4A7C15ULL };
+static const puint32 pp_fast_hash_crc32c_seeds[] = { 0, 0x12345678U };
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static void
+fill_data (puchar *data, psize len)
+{
+	psize i;
+
+	for (i = 0; i < len; ++i)
+		data[i] = (puchar) (i * 131 + 7 + (i >> 7));
+}
+
+static puint64
+read_be64 (const puchar *buf)
+{
+	puint64	val = 0;
+	pint	i;
+
+	for (i = 0; i < 8; ++i)
+		val = (val << 8) | buf[i];
+
+	return val;
+}
+
+P_TEST_CASE_BEGIN (pfasthash_nomem_test)
+{
+	p_libsys_init ();
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (p_fast_hash_new (P_FAST_HASH_TYPE_XXH3_64, 0) == NULL);
+	P_TEST_CHECK (p_fast_hash_new (P_FAST_HASH_TYPE_XXH3_128, 0) == NULL);
+	P_TEST_CHECK (p_fast_hash_new (P_FAST_HASH_TYPE_CRC32C, 0) == NULL);
+
+	/* One-shot functions don't need the heap */
+	puint64 low, high;
+
+	P_TEST_CHECK (p_fast_hash_xxh3_64 ("", 0, 0) == 0x2D06800538D394C2ULL);
+	P_TEST_CHECK (p_fast_hash_xxh3_128 ("", 0, 0, &low, &high) == TRUE);
+	P_TEST_CHECK (p_fast_hash_crc32c (0, "123456789", 9) == 0xE3069283U);
+
+	p_mem_restore_vtable ();
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pfasthash_invalid_test)
+{
+	p_libsys_init ();
+
+	puchar	buf[16];
+	psize	len = sizeof (buf);
+	puint64	low, high;
+
+	P_TEST_CHECK (p_fast_hash_new ((PFastHashType) -1, 0) == NULL);
+	P_TEST_CHECK (p_fast_hash_new ((PFastHashType) 3, 0) == NULL);
+
+	p_fast_hash_update (NULL, buf, sizeof (buf));
+	p_fast_hash_reset (NULL);
+	p_fast_hash_get_digest (NULL, buf, &len);
+	P_TEST_CHECK (len == 0);
+	p_fast_hash_get_digest (NULL, NULL, NULL);
+	p_fast_hash_free (NULL);
+
+	P_TEST_CHECK (p_fast_hash_get_value (NULL) == 0);
+	P_TEST_CHECK (p_fast_hash_get_length (NULL) == -1);
+	P_TEST_CHECK (p_fast_hash_get_type (NULL) == (PFastHashType) -1);
+
+	P_TEST_CHECK (p_fast_hash_xxh3_64 (NULL, 10, 0) == 0);
+	P_TEST_CHECK (p_fast_hash_xxh3_64 (NULL, 0, 0) == 0x2D06800538D394C2ULL);
+	P_TEST_CHECK (p_fast_hash_xxh3_128 (NULL, 10, 0, &low, &high) == FALSE);
+	P_TEST_CHECK (p_fast_hash_xxh3_128 (buf, 0, 0, NULL, &high) == FALSE);
+	P_TEST_CHECK (p_fast_hash_xxh3_128 (buf, 0, 0, &low, NULL) == FALSE);
+	P_TEST_CHECK (p_fast_hash_crc32c (0x1234, NULL, 10) == 0x1234);
+
+	PFastHash *hash = p_fast_hash_new (P_FAST_HASH_TYPE_XXH3_128, 0);
+
+	P_TEST_REQUIRE (hash != NULL);
+
+	/* Too small buffer */
+	len = 15;
+	p_fast_hash_get_digest (hash, buf, &len);
+	P_TEST_CHECK (len == 0);
+
+	len = sizeof (buf);
+	p_fast_hash_get_digest (hash, NULL, &len);
+	P_TEST_CHECK (len == 0);
+
+	p_fast_hash_update (hash, NULL, 10);
+	p_fast_hash_update (hash, NULL, 0);
+	P_TEST_CHECK (p_fast_hash_get_value (hash) == 0x6001C324468D497FULL);
+
+	p_fast_hash_free (hash);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pfasthash_general_test)
+{
+	p_libsys_init ();
+
+	PFastHash	*hash;
+	puchar		buf[16];
+	psize		len;
+
+	hash = p_fast_hash_new (P_FAST_HASH_TYPE_XXH3_64, 0);
+	P_TEST_REQUIRE (hash != NULL);
+	P_TEST_CHECK (p_fast_hash_get_type (hash) == P_FAST_HASH_TYPE_XXH3_64);
+	P_TEST_CHECK (p_fast_hash_get_length (hash) == 8);
+
+	p_fast_hash_update (hash, "abc", 3);
+	P_TEST_CHECK (p_fast_hash_get_value (hash) == p_fast_hash_xxh3_64 ("abc", 3, 0));
+
+	/* Context stays open after getting the value */
+	p_fast_hash_update (hash, "def", 3);
+	P_TEST_CHECK (p_fast_hash_get_value (hash) == p_fast_hash_xxh3_64 ("abcdef", 6, 0));
+
+	len = sizeof (buf);
+	p_fast_hash_get_digest (hash, buf, &len);
+	P_TEST_CHECK (len == 8);
+	P_TEST_CHECK (read_be64 (buf) == p_fast_hash_xxh3_64 ("abcdef", 6, 0));
+
+	p_fast_hash_reset (hash);
+	P_TEST_CHECK (p_fast_hash_get_value (hash) == 0x2D06800538D394C2ULL);
+	p_fast_hash_free (hash);
+
+	hash = p_fast_hash_new (P_FAST_HASH_TYPE_XXH3_128, 0);
+	P_TEST_REQUIRE (hash != NULL);
+	P_TEST_CHECK (p_fast_hash_get_type (hash) == P_FAST_HASH_TYPE_XXH3_128);
+	P_TEST_CHECK (p_fast_hash_get_length (hash) == 16);
+
+	len = sizeof (buf);
+	p_fast_hash_get_digest (hash, buf, &len);
+	P_TEST_CHECK (len == 16);
+	P_TEST_CHECK (read_be64 (buf) == 0x99AA06D3014798D8ULL);
+	P_TEST_CHECK (read_be64 (buf + 8) == 0x6001C324468D497FULL);
+	p_fast_hash_free (hash);
+
+	hash = p_fast_hash_new (P_FAST_HASH_TYPE_CRC32C, 0);
+	P_TEST_REQUIRE (hash != NULL);
+	P_TEST_CHECK (p_fast_hash_get_type (hash) == P_FAST_HASH_TYPE_CRC32C);
+	P_TEST_CHECK (p_fast_hash_get_length (hash) == 4);
+
+	p_fast_hash_update (hash, "1234", 4);
+	p_fast_hash_update (hash, "56789", 5);
+	P_TEST_CHECK (p_fast_hash_get_value (hash) == 0xE3069283U);
+
+	len = sizeof (buf);
+	p_fast_hash_get_digest (hash, buf, &len);
+	P_TEST_CHECK (len == 4);
+	P_TEST_CHECK (buf[0] == 0xE3 && buf[1] == 0x06 && buf[2] == 0x92 && buf[3] == 0x83);
+
+	/* Continuing from a previous CRC value */
+	P_TEST_CHECK (p_fast_hash_crc32c (p_fast_hash_crc32c (0, "1234", 4), "56789", 5) == 0xE3069283U);
+	p_fast_hash_free (hash);
+
+	hash = p_fast_hash_new (P_FAST_HASH_TYPE_CRC32C, p_fast_hash_crc32c (0, "1234", 4));
+	P_TEST_REQUIRE (hash != NULL);
+	p_fast_hash_update (hash, "56789", 5);
+	P_TEST_CHECK (p_fast_hash_get_value (hash) == 0xE3069283U);
+	p_fast_hash_free (hash);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pfasthash_vectors_test)
+{
+	p_libsys_init ();
+
+	puchar	*data;
+	puint64	low, high;
+	psize	i;
+
+	data = (puchar *) p_malloc (PFASTHASH_DATA_LENGTH);
+	P_TEST_REQUIRE (data != NULL);
+
+	fill_data (data, PFASTHASH_DATA_LENGTH);
+
+	for (i = 0; i < sizeof (pp_fast_hash_vectors) / sizeof (pp_fast_hash_vectors[0]); ++i) {
+		const PFastHashVector	*vec  = &pp_fast_hash_vectors[i];
+		puint64			seed  = pp_fast_hash_xxh3_seeds[vec->seed_idx];
+
+		P_TEST_CHECK (p_fast_hash_xxh3_64 (data, vec->len, seed) == vec->xxh3_64);
+
+		P_TEST_CHECK (p_fast_hash_xxh3_128 (data, vec->len, seed, &low, &high) == TRUE);
+		P_TEST_CHECK (low == vec->xxh3_128_low);
+		P_TEST_CHECK (high == vec->xxh3_128_high);
+
+		P_TEST_CHECK (p_fast_hash_crc32c (pp_fast_hash_crc32c_seeds[vec->seed_idx],
+						  data,
+						  vec->len) == vec->crc32c);
+	}
+
+	p_free (data);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pfasthash_stream_test)
+{
+	p_libsys_init ();
+
+	PFastHash	*hash;
+	puchar		*data;
+	puchar		digest[16];
+	puint64		low, high;
+	psize		len, offset, chunk, dig_len;
+	pint		type;
+
+	data = (puchar *) p_malloc (PFASTHASH_STREAM_LENGTH);
+	P_TEST_REQUIRE (data != NULL);
+
+	fill_data (data, PFASTHASH_STREAM_LENGTH);
+
+	for (type = P_FAST_HASH_TYPE_XXH3_64; type <= P_FAST_HASH_TYPE_CRC32C; ++type) {
+		hash = p_fast_hash_new ((PFastHashType) type, 0x0123456789ABCDEFULL);
+		P_TEST_REQUIRE (hash != NULL);
+
+		for (len = 0; len <= PFASTHASH_STREAM_LENGTH; len += (len < 600 ? 1 : 37)) {
+			p_fast_hash_reset (hash);
+
+			/* Uneven chunks cross the internal buffer at different points */
+			for (offset = 0, chunk = len % 7 + 1; offset < len; chunk = (chunk * 5) % 301 + 1) {
+				if (chunk > len - offset)
+					chunk = len - offset;
+
+				p_fast_hash_update (hash, data + offset, chunk);
+				offset += chunk;
+			}
+
+			dig_len = sizeof (digest);
+			p_fast_hash_get_digest (hash, digest, &dig_len);
+
+			switch (type) {
+			case P_FAST_HASH_TYPE_XXH3_64:
+				P_TEST_CHECK (dig_len == 8);
+				P_TEST_CHECK (read_be64 (digest) ==
+					      p_fast_hash_xxh3_64 (data, len, 0x0123456789ABCDEFULL));
+				break;
+			case P_FAST_HASH_TYPE_XXH3_128:
+				P_TEST_CHECK (p_fast_hash_xxh3_128 (data, len, 0x0123456789ABCDEFULL, &low, &high) == TRUE);
+				P_TEST_CHECK (dig_len == 16);
+				P_TEST_CHECK (read_be64 (digest) == high);
+				P_TEST_CHECK (read_be64 (digest + 8) == low);
+				P_TEST_CHECK (p_fast_hash_get_value (hash) == low);
+				break;
+			default:
+				P_TEST_CHECK (dig_len == 4);
+				P_TEST_CHECK (p_fast_hash_get_value (hash) ==
+					      p_fast_hash_crc32c (0x89ABCDEFU, data, len));
+				break;
+			}
+		}
+
+		p_fast_hash_free (hash);
+	}
+
+	p_free (data);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pfasthash_str_hash_test)
+{
+	p_libsys_init ();
+
+	const pchar	*str = "plibsys hash table key";
+	puint64		hash;
+
+	hash = p_fast_hash_xxh3_64 (str, strlen (str), 0);
+
+	P_TEST_CHECK (p_str_hash (str) == (puint) (hash ^ (hash >> 32)));
+	P_TEST_CHECK (p_str_hash ("") == p_str_hash (""));
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pfasthash_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pfasthash_invalid_test);
+	P_TEST_SUITE_RUN_CASE (pfasthash_general_test);
+	P_TEST_SUITE_RUN_CASE (pfasthash_vectors_test);
+	P_TEST_SUITE_RUN_CASE (pfasthash_stream_test);
+	P_TEST_SUITE_RUN_CASE (pfasthash_str_hash_test);
+}
+P_TEST_SUITE_END()
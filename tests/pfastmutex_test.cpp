@@ -0,0 +1,176 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+P_TEST_MODULE_INIT ();
+
+#define PFASTMUTEX_THREADS	4
+#define PFASTMUTEX_ROUNDS	100000
+
+static PFastMutex *	global_fast_mutex = NULL;
+static pint		fast_mutex_counter = 0;
+static volatile pint	fast_mutex_inside  = 0;
+static volatile pint	fast_mutex_overlap = 0;
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static void * fast_mutex_test_thread (void *)
+{
+	pint i;
+
+	for (i = 0; i < PFASTMUTEX_ROUNDS; ++i) {
+		if (!p_fast_mutex_trylock (global_fast_mutex)) {
+			if (!p_fast_mutex_lock (global_fast_mutex))
+				p_uthread_exit (1);
+		}
+
+		if (p_atomic_int_add (&fast_mutex_inside, 1) != 0)
+			p_atomic_int_inc (&fast_mutex_overlap);
+
+		++fast_mutex_counter;
+
+		/* Hold the lock for a while sometimes to make the others park */
+		if (i % 10000 == 0)
+			p_uthread_sleep (1);
+
+		p_atomic_int_add (&fast_mutex_inside, -1);
+
+		if (!p_fast_mutex_unlock (global_fast_mutex))
+			p_uthread_exit (1);
+	}
+
+	p_uthread_exit (0);
+
+	return NULL;
+}
+
+P_TEST_CASE_BEGIN (pfastmutex_nomem_test)
+{
+	p_libsys_init ();
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+	P_TEST_CHECK (p_fast_mutex_new (0) == NULL);
+
+	p_mem_restore_vtable ();
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pfastmutex_bad_input_test)
+{
+	p_libsys_init ();
+
+	P_TEST_REQUIRE (p_fast_mutex_lock (NULL) == FALSE);
+	P_TEST_REQUIRE (p_fast_mutex_unlock (NULL) == FALSE);
+	P_TEST_REQUIRE (p_fast_mutex_trylock (NULL) == FALSE);
+	p_fast_mutex_free (NULL);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pfastmutex_general_test)
+{
+	PFastMutex	*mutex;
+	PUThread	*thr[PFASTMUTEX_THREADS];
+	pint		i;
+
+	p_libsys_init ();
+
+	mutex = p_fast_mutex_new (-1);
+	P_TEST_REQUIRE (mutex != NULL);
+
+	P_TEST_CHECK (p_fast_mutex_trylock (mutex) == TRUE);
+	P_TEST_CHECK (p_fast_mutex_trylock (mutex) == FALSE);
+	P_TEST_CHECK (p_fast_mutex_unlock (mutex) == TRUE);
+	P_TEST_CHECK (p_fast_mutex_lock (mutex) == TRUE);
+	P_TEST_CHECK (p_fast_mutex_trylock (mutex) == FALSE);
+	P_TEST_CHECK (p_fast_mutex_unlock (mutex) == TRUE);
+	P_TEST_CHECK (p_fast_mutex_trylock (mutex) == TRUE);
+	P_TEST_CHECK (p_fast_mutex_unlock (mutex) == TRUE);
+
+	p_fast_mutex_free (mutex);
+
+	global_fast_mutex = p_fast_mutex_new (0);
+	P_TEST_REQUIRE (global_fast_mutex != NULL);
+
+	fast_mutex_counter = 0;
+	p_atomic_int_set (&fast_mutex_inside, 0);
+	p_atomic_int_set (&fast_mutex_overlap, 0);
+
+	for (i = 0; i < PFASTMUTEX_THREADS; ++i) {
+		thr[i] = p_uthread_create ((PUThreadFunc) fast_mutex_test_thread, NULL, TRUE, NULL);
+		P_TEST_REQUIRE (thr[i] != NULL);
+	}
+
+	for (i = 0; i < PFASTMUTEX_THREADS; ++i) {
+		P_TEST_CHECK (p_uthread_join (thr[i]) == 0);
+		p_uthread_unref (thr[i]);
+	}
+
+	P_TEST_CHECK (fast_mutex_counter == PFASTMUTEX_THREADS * PFASTMUTEX_ROUNDS);
+	P_TEST_CHECK (p_atomic_int_get (&fast_mutex_overlap) == 0);
+
+	P_TEST_CHECK (p_fast_mutex_trylock (global_fast_mutex) == TRUE);
+	P_TEST_CHECK (p_fast_mutex_unlock (global_fast_mutex) == TRUE);
+
+	p_fast_mutex_free (global_fast_mutex);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pfastmutex_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pfastmutex_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (pfastmutex_general_test);
+}
+P_TEST_SUITE_END()
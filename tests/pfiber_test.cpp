@@ -0,0 +1,466 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <string.h>
+
+P_TEST_MODULE_INIT ();
+
+#define PFIBER_YIELD_FIBERS	4
+#define PFIBER_YIELD_ROUNDS	5
+#define PFIBER_MANY_COUNT	1000
+#define PFIBER_PING_COUNT	100
+
+typedef struct _YieldData {
+	pint	id;
+	pint	*sequence;
+	pint	*pos;
+} YieldData;
+
+typedef struct _LoopData {
+	PEventLoop	*loop;
+	PFiberScheduler	*scheduler;
+	pint		done;
+	pint		expected;
+	PSocket		*sockets[2];
+	pint		received;
+	pint		timeouts;
+} LoopData;
+
+static pint suspended_value = 0;
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static PSocket * create_udp_socket (void)
+{
+	PSocket *socket = p_socket_new (P_SOCKET_FAMILY_INET,
+					P_SOCKET_TYPE_DATAGRAM,
+					P_SOCKET_PROTOCOL_UDP,
+					NULL);
+
+	if (socket == NULL)
+		return NULL;
+
+	PSocketAddress *addr = p_socket_address_new ("127.0.0.1", 0);
+
+	if (addr == NULL || !p_socket_bind (socket, addr, FALSE, NULL)) {
+		p_socket_address_free (addr);
+		p_socket_free (socket);
+		return NULL;
+	}
+
+	p_socket_address_free (addr);
+	p_socket_set_blocking (socket, FALSE);
+
+	return socket;
+}
+
+static pboolean connect_socket (PSocket *socket, PSocket *peer)
+{
+	PSocketAddress *addr = p_socket_get_local_address (peer, NULL);
+
+	if (addr == NULL)
+		return FALSE;
+
+	pboolean ret = p_socket_connect (socket, addr, NULL);
+
+	p_socket_address_free (addr);
+
+	return ret;
+}
+
+static void empty_fiber (ppointer data)
+{
+	P_UNUSED (data);
+}
+
+static void yield_fiber (ppointer data)
+{
+	YieldData *yield_data = (YieldData *) data;
+
+	for (pint i = 0; i < PFIBER_YIELD_ROUNDS; ++i) {
+		yield_data->sequence[(*yield_data->pos)++] = yield_data->id;
+		P_TEST_CHECK (p_fiber_yield () == TRUE);
+	}
+}
+
+static pint recurse (pint depth)
+{
+	volatile pchar buf[256];
+
+	memset ((void *) buf, depth, sizeof (buf));
+
+	if (depth == 0)
+		return buf[0];
+
+	return recurse (depth - 1) + buf[1] + 1;
+}
+
+static void stack_fiber (ppointer data)
+{
+	/* About 32 KB of the stack */
+	*((pint *) data) = recurse (100);
+}
+
+static void suspend_fiber (ppointer data)
+{
+	PFiber **fiber = (PFiber **) data;
+
+	*fiber = p_fiber_current ();
+
+	P_TEST_CHECK (*fiber != NULL);
+
+	suspended_value = 1;
+	P_TEST_CHECK (p_fiber_suspend () == TRUE);
+	suspended_value = 2;
+}
+
+static void spawn_fiber (ppointer data)
+{
+	LoopData *loop_data = (LoopData *) data;
+
+	P_TEST_CHECK (p_fiber_scheduler_spawn (loop_data->scheduler, empty_fiber, NULL, NULL) == TRUE);
+}
+
+static void finish_fiber (LoopData *data)
+{
+	if (++data->done == data->expected)
+		p_event_loop_stop (data->loop);
+}
+
+static void sleep_fiber (ppointer data)
+{
+	LoopData *loop_data = (LoopData *) data;
+
+	P_TEST_CHECK (p_fiber_sleep (1) == TRUE);
+
+	finish_fiber (loop_data);
+}
+
+static void ping_fiber (ppointer data)
+{
+	LoopData	*loop_data = (LoopData *) data;
+	PSocket		*socket    = loop_data->sockets[0];
+	pchar		buf[16];
+
+	for (pint i = 0; i < PFIBER_PING_COUNT; ++i) {
+		buf[0] = (pchar) i;
+
+		P_TEST_CHECK (p_fiber_socket_send (socket, buf, 1, NULL) == 1);
+		P_TEST_CHECK (p_fiber_socket_receive (socket, buf, sizeof (buf), NULL) == 1);
+		P_TEST_CHECK (buf[0] == (pchar) (i + 1));
+	}
+
+	finish_fiber (loop_data);
+}
+
+static void pong_fiber (ppointer data)
+{
+	LoopData	*loop_data = (LoopData *) data;
+	PSocket		*socket    = loop_data->sockets[1];
+	pchar		buf[16];
+
+	for (pint i = 0; i < PFIBER_PING_COUNT; ++i) {
+		P_TEST_CHECK (p_fiber_socket_receive (socket, buf, sizeof (buf), NULL) == 1);
+		P_TEST_CHECK (buf[0] == (pchar) i);
+
+		++loop_data->received;
+		++buf[0];
+
+		P_TEST_CHECK (p_fiber_socket_send (socket, buf, 1, NULL) == 1);
+	}
+
+	finish_fiber (loop_data);
+}
+
+static void timeout_fiber (ppointer data)
+{
+	LoopData *loop_data = (LoopData *) data;
+
+	/* Nobody sends to the socket */
+	if (p_fiber_wait_socket (loop_data->sockets[0], P_SOCKET_POLLER_CONDITION_IN, 5, NULL) == 0)
+		++loop_data->timeouts;
+
+	/* The socket is unregistered after the wait */
+	if (p_fiber_wait_socket (loop_data->sockets[0], P_SOCKET_POLLER_CONDITION_OUT, 1000, NULL) > 0)
+		++loop_data->timeouts;
+
+	finish_fiber (loop_data);
+}
+
+static void wait_forever_fiber (ppointer data)
+{
+	LoopData *loop_data = (LoopData *) data;
+
+	p_fiber_wait_socket (loop_data->sockets[1], P_SOCKET_POLLER_CONDITION_IN, -1, NULL);
+
+	P_TEST_CHECK (FALSE);
+}
+
+P_TEST_CASE_BEGIN (pfiber_nomem_test)
+{
+	p_libsys_init ();
+
+	PFiberScheduler *scheduler = p_fiber_scheduler_new (NULL, 0, NULL);
+	P_TEST_REQUIRE (scheduler != NULL);
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (p_fiber_scheduler_new (NULL, 0, NULL) == NULL);
+	P_TEST_CHECK (p_fiber_scheduler_spawn (scheduler, empty_fiber, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_fiber_scheduler_get_count (scheduler) == 0);
+
+	p_mem_restore_vtable ();
+
+	P_TEST_CHECK (p_fiber_scheduler_run_ready (scheduler) == 0);
+
+	p_fiber_scheduler_free (scheduler);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pfiber_invalid_test)
+{
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_fiber_scheduler_spawn (NULL, empty_fiber, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_fiber_scheduler_run_ready (NULL) == -1);
+	P_TEST_CHECK (p_fiber_scheduler_get_count (NULL) == 0);
+	P_TEST_CHECK (p_fiber_current () == NULL);
+	P_TEST_CHECK (p_fiber_yield () == FALSE);
+	P_TEST_CHECK (p_fiber_suspend () == FALSE);
+	P_TEST_CHECK (p_fiber_resume (NULL) == FALSE);
+	P_TEST_CHECK (p_fiber_sleep (1) == FALSE);
+	P_TEST_CHECK (p_fiber_wait_socket (NULL, P_SOCKET_POLLER_CONDITION_IN, 0, NULL) == -1);
+	P_TEST_CHECK (p_fiber_socket_receive (NULL, NULL, 0, NULL) == -1);
+	P_TEST_CHECK (p_fiber_socket_send (NULL, NULL, 0, NULL) == -1);
+
+	p_fiber_scheduler_free (NULL);
+
+	PFiberScheduler *scheduler = p_fiber_scheduler_new (NULL, 0, NULL);
+	P_TEST_REQUIRE (scheduler != NULL);
+
+	P_TEST_CHECK (p_fiber_scheduler_spawn (scheduler, NULL, NULL, NULL) == FALSE);
+
+	PSocket *socket = create_udp_socket ();
+	P_TEST_REQUIRE (socket != NULL);
+
+	PError *error = NULL;
+
+	/* Not from a fiber */
+	P_TEST_CHECK (p_fiber_wait_socket (socket, P_SOCKET_POLLER_CONDITION_IN, 0, &error) == -1);
+	P_TEST_CHECK (error != NULL);
+
+	p_error_free (error);
+	p_socket_free (socket);
+	p_fiber_scheduler_free (scheduler);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pfiber_manual_test)
+{
+	p_libsys_init ();
+
+	PFiberScheduler *scheduler = p_fiber_scheduler_new (NULL, 0, NULL);
+	P_TEST_REQUIRE (scheduler != NULL);
+
+	pint		sequence[PFIBER_YIELD_FIBERS * PFIBER_YIELD_ROUNDS];
+	pint		pos = 0;
+	YieldData	data[PFIBER_YIELD_FIBERS];
+
+	for (pint i = 0; i < PFIBER_YIELD_FIBERS; ++i) {
+		data[i].id       = i;
+		data[i].sequence = sequence;
+		data[i].pos      = &pos;
+
+		P_TEST_CHECK (p_fiber_scheduler_spawn (scheduler, yield_fiber, &data[i], NULL) == TRUE);
+	}
+
+	P_TEST_CHECK (p_fiber_scheduler_get_count (scheduler) == PFIBER_YIELD_FIBERS);
+
+	/* Each run gives every fiber one step */
+	for (pint i = 0; i < PFIBER_YIELD_ROUNDS; ++i)
+		P_TEST_CHECK (p_fiber_scheduler_run_ready (scheduler) == PFIBER_YIELD_FIBERS);
+
+	P_TEST_CHECK (pos == PFIBER_YIELD_FIBERS * PFIBER_YIELD_ROUNDS);
+
+	for (pint i = 0; i < pos; ++i)
+		P_TEST_CHECK (sequence[i] == i % PFIBER_YIELD_FIBERS);
+
+	/* Returning from the last yield */
+	P_TEST_CHECK (p_fiber_scheduler_run_ready (scheduler) == PFIBER_YIELD_FIBERS);
+	P_TEST_CHECK (p_fiber_scheduler_get_count (scheduler) == 0);
+	P_TEST_CHECK (p_fiber_scheduler_run_ready (scheduler) == 0);
+
+	/* Stack usage */
+	pint result = 0;
+
+	P_TEST_CHECK (p_fiber_scheduler_spawn (scheduler, stack_fiber, &result, NULL) == TRUE);
+	P_TEST_CHECK (p_fiber_scheduler_run_ready (scheduler) == 1);
+	P_TEST_CHECK (result == recurse (100));
+
+	/* Suspend and resume */
+	PFiber *fiber = NULL;
+
+	P_TEST_CHECK (p_fiber_scheduler_spawn (scheduler, suspend_fiber, &fiber, NULL) == TRUE);
+	P_TEST_CHECK (p_fiber_scheduler_run_ready (scheduler) == 1);
+	P_TEST_CHECK (suspended_value == 1);
+	P_TEST_CHECK (p_fiber_scheduler_run_ready (scheduler) == 0);
+	P_TEST_CHECK (p_fiber_scheduler_get_count (scheduler) == 1);
+
+	P_TEST_CHECK (p_fiber_resume (fiber) == TRUE);
+	P_TEST_CHECK (p_fiber_resume (fiber) == FALSE);
+	P_TEST_CHECK (p_fiber_scheduler_run_ready (scheduler) == 1);
+	P_TEST_CHECK (suspended_value == 2);
+	P_TEST_CHECK (p_fiber_scheduler_get_count (scheduler) == 0);
+
+	/* Many fibers reuse a bounded number of stacks */
+	for (pint i = 0; i < PFIBER_MANY_COUNT; ++i)
+		P_TEST_CHECK (p_fiber_scheduler_spawn (scheduler, empty_fiber, NULL, NULL) == TRUE);
+
+	P_TEST_CHECK (p_fiber_scheduler_run_ready (scheduler) == PFIBER_MANY_COUNT);
+	P_TEST_CHECK (p_fiber_scheduler_get_count (scheduler) == 0);
+
+	/* Suspended fibers are dropped */
+	P_TEST_CHECK (p_fiber_scheduler_spawn (scheduler, suspend_fiber, &fiber, NULL) == TRUE);
+	P_TEST_CHECK (p_fiber_scheduler_run_ready (scheduler) == 1);
+
+	p_fiber_scheduler_free (scheduler);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pfiber_loop_test)
+{
+	p_libsys_init ();
+
+	LoopData data;
+
+	memset (&data, 0, sizeof (data));
+
+	data.loop = p_event_loop_new (NULL);
+	P_TEST_REQUIRE (data.loop != NULL);
+
+	data.scheduler = p_fiber_scheduler_new (data.loop, 0, NULL);
+	P_TEST_REQUIRE (data.scheduler != NULL);
+
+	/* Sleeping fibers are resumed by the loop timers */
+	data.expected = PFIBER_MANY_COUNT;
+
+	for (pint i = 0; i < PFIBER_MANY_COUNT; ++i)
+		P_TEST_CHECK (p_fiber_scheduler_spawn (data.scheduler, sleep_fiber, &data, NULL) == TRUE);
+
+	P_TEST_CHECK (p_event_loop_run (data.loop, NULL) == TRUE);
+	P_TEST_CHECK (data.done == PFIBER_MANY_COUNT);
+	P_TEST_CHECK (p_fiber_scheduler_get_count (data.scheduler) == 0);
+
+	/* Spawning from a fiber */
+	P_TEST_CHECK (p_fiber_scheduler_spawn (data.scheduler, spawn_fiber, &data, NULL) == TRUE);
+	P_TEST_CHECK (p_event_loop_run_once (data.loop, 0, NULL) >= 1);
+	P_TEST_CHECK (p_event_loop_run_once (data.loop, 0, NULL) >= 1);
+	P_TEST_CHECK (p_fiber_scheduler_get_count (data.scheduler) == 0);
+
+	/* Sockets block the fibers, not the thread */
+	data.sockets[0] = create_udp_socket ();
+	data.sockets[1] = create_udp_socket ();
+
+	P_TEST_REQUIRE (data.sockets[0] != NULL);
+	P_TEST_REQUIRE (data.sockets[1] != NULL);
+
+	P_TEST_CHECK (connect_socket (data.sockets[0], data.sockets[1]) == TRUE);
+	P_TEST_CHECK (connect_socket (data.sockets[1], data.sockets[0]) == TRUE);
+
+	data.done     = 0;
+	data.expected = 2;
+
+	P_TEST_CHECK (p_fiber_scheduler_spawn (data.scheduler, pong_fiber, &data, NULL) == TRUE);
+	P_TEST_CHECK (p_fiber_scheduler_spawn (data.scheduler, ping_fiber, &data, NULL) == TRUE);
+
+	P_TEST_CHECK (p_event_loop_run (data.loop, NULL) == TRUE);
+	P_TEST_CHECK (data.received == PFIBER_PING_COUNT);
+
+	/* Waiting with a timeout */
+	data.done     = 0;
+	data.expected = 1;
+
+	P_TEST_CHECK (p_fiber_scheduler_spawn (data.scheduler, timeout_fiber, &data, NULL) == TRUE);
+	P_TEST_CHECK (p_event_loop_run (data.loop, NULL) == TRUE);
+	P_TEST_CHECK (data.timeouts == 2);
+
+	/* Waiting fibers are dropped along with their registrations */
+	P_TEST_CHECK (p_fiber_scheduler_spawn (data.scheduler, wait_forever_fiber, &data, NULL) == TRUE);
+	P_TEST_CHECK (p_fiber_scheduler_spawn (data.scheduler, sleep_fiber, &data, NULL) == TRUE);
+	P_TEST_CHECK (p_event_loop_run_once (data.loop, 0, NULL) >= 1);
+	P_TEST_CHECK (p_fiber_scheduler_get_count (data.scheduler) == 2);
+
+	p_fiber_scheduler_free (data.scheduler);
+
+	P_TEST_CHECK (p_event_loop_run_once (data.loop, 20, NULL) == 0);
+
+	p_event_loop_free (data.loop);
+
+	p_socket_free (data.sockets[0]);
+	p_socket_free (data.sockets[1]);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pfiber_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pfiber_invalid_test);
+	P_TEST_SUITE_RUN_CASE (pfiber_manual_test);
+	P_TEST_SUITE_RUN_CASE (pfiber_loop_test);
+}
+P_TEST_SUITE_END()
@@ -27,10 +27,36 @@
 #include "ptestmacros.h"
 
 #include <stdio.h>
+#include <string.h>
 
 P_TEST_MODULE_INIT ();
 
 #define PFILE_TEST_FILE "." P_DIR_SEPARATOR "pfile_test_file.txt"
+#define PFILE_COPY_FILE	"." P_DIR_SEPARATOR "pfile_test_copy.txt"
+#define PFILE_WRITER_RECORDS	10000
+#define PFILE_COPY_SIZE		(3 * 1024 * 1024 + 17)
+
+static pboolean pfile_check_copy (const pchar *path, const pchar *data, psize size)
+{
+	PFile	*file = p_file_new (path, P_FILE_OPEN_FLAG_READ, NULL);
+	pchar	*buf  = (pchar *) p_malloc (size + 1);
+	pboolean result;
+
+	if (file == NULL || buf == NULL) {
+		p_file_free (file);
+		p_free (buf);
+		return FALSE;
+	}
+
+	result = p_file_get_size (file, NULL) == (pint64) size &&
+		 p_file_read_at (file, buf, size + 1, 0, NULL) == (pssize) size &&
+		 memcmp (buf, data, size) == 0;
+
+	p_file_free (file);
+	p_free (buf);
+
+	return result;
+}
 
 P_TEST_CASE_BEGIN (pfile_general_test)
 {
@@ -54,8 +80,388 @@ P_TEST_CASE_BEGIN (pfile_general_test)
 }
 P_TEST_CASE_END ()
 
+P_TEST_CASE_BEGIN (pfile_io_test)
+{
+	p_libsys_init ();
+
+	PFile		*file;
+	PError		*error = NULL;
+	pchar		buf[64];
+	pchar		part1[5];
+	pchar		part2[3];
+	pchar		part3[16];
+	PFileVector	vectors[3];
+
+	p_file_remove (PFILE_TEST_FILE, NULL);
+
+	P_TEST_CHECK (p_file_new (NULL, P_FILE_OPEN_FLAG_READ, NULL) == NULL);
+	P_TEST_CHECK (p_file_new (PFILE_TEST_FILE, 0, NULL) == NULL);
+	P_TEST_CHECK (p_file_read_at (NULL, buf, sizeof (buf), 0, NULL) == -1);
+	P_TEST_CHECK (p_file_write_at (NULL, buf, sizeof (buf), 0, NULL) == -1);
+	P_TEST_CHECK (p_file_read_vector_at (NULL, vectors, 1, 0, NULL) == -1);
+	P_TEST_CHECK (p_file_write_vector_at (NULL, vectors, 1, 0, NULL) == -1);
+	P_TEST_CHECK (p_file_sync (NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_file_sync_data (NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_file_get_size (NULL, NULL) == -1);
+	P_TEST_CHECK (p_file_writer_new (NULL, 0, 0) == NULL);
+	P_TEST_CHECK (p_file_writer_write (NULL, buf, 1, NULL) == FALSE);
+	P_TEST_CHECK (p_file_writer_flush (NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_file_writer_get_offset (NULL) == 0);
+
+	p_file_free (NULL);
+	p_file_writer_free (NULL);
+
+	/* Doesn't exist yet */
+	P_TEST_CHECK (p_file_new (PFILE_TEST_FILE, P_FILE_OPEN_FLAG_READ, &error) == NULL);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_NOT_EXISTS);
+	p_error_free (error);
+	error = NULL;
+
+	file = p_file_new (PFILE_TEST_FILE,
+			   P_FILE_OPEN_FLAG_READ | P_FILE_OPEN_FLAG_WRITE | P_FILE_OPEN_FLAG_CREATE,
+			   &error);
+	P_TEST_REQUIRE (file != NULL);
+	P_TEST_CHECK (error == NULL);
+
+	P_TEST_CHECK (p_file_get_size (file, NULL) == 0);
+	P_TEST_CHECK (p_file_read_at (file, buf, sizeof (buf), 0, NULL) == 0);
+
+	/* Writes at offsets leave a hole */
+	P_TEST_CHECK (p_file_write_at (file, "world", 5, 6, NULL) == 5);
+	P_TEST_CHECK (p_file_write_at (file, "hello ", 6, 0, NULL) == 6);
+	P_TEST_CHECK (p_file_write_at (file, "!", 1, 20, NULL) == 1);
+	P_TEST_CHECK (p_file_get_size (file, NULL) == 21);
+
+	memset (buf, 'x', sizeof (buf));
+	P_TEST_CHECK (p_file_read_at (file, buf, 11, 0, NULL) == 11);
+	P_TEST_CHECK (memcmp (buf, "hello world", 11) == 0);
+
+	/* Short read only at the end of the file */
+	P_TEST_CHECK (p_file_read_at (file, buf, sizeof (buf), 6, NULL) == 15);
+	P_TEST_CHECK (memcmp (buf, "world", 5) == 0);
+	P_TEST_CHECK (buf[5] == 0 && buf[13] == 0);
+	P_TEST_CHECK (buf[14] == '!');
+	P_TEST_CHECK (p_file_read_at (file, buf, sizeof (buf), 100, NULL) == 0);
+
+	/* Out of range offsets */
+	P_TEST_CHECK (p_file_read_at (file, buf, 1, P_MAXUINT64, NULL) == -1);
+	P_TEST_CHECK (p_file_write_at (file, buf, 1, P_MAXUINT64, NULL) == -1);
+
+	/* Scatter/gather */
+	vectors[0].buffer = (pchar *) "abcde";
+	vectors[0].buflen = 5;
+	vectors[1].buffer = NULL;
+	vectors[1].buflen = 0;
+	vectors[2].buffer = (pchar *) "fgh";
+	vectors[2].buflen = 3;
+
+	P_TEST_CHECK (p_file_write_vector_at (file, vectors, 3, 30, NULL) == 8);
+	P_TEST_CHECK (p_file_write_vector_at (file, vectors, 0, 30, NULL) == 0);
+	P_TEST_CHECK (p_file_write_vector_at (file, NULL, 1, 30, NULL) == -1);
+	P_TEST_CHECK (p_file_get_size (file, NULL) == 38);
+
+	vectors[0].buffer = part1;
+	vectors[0].buflen = sizeof (part1);
+	vectors[1].buffer = part2;
+	vectors[1].buflen = sizeof (part2);
+	vectors[2].buffer = part3;
+	vectors[2].buflen = sizeof (part3);
+
+	P_TEST_CHECK (p_file_read_vector_at (file, vectors, 3, 30, NULL) == 8);
+	P_TEST_CHECK (memcmp (part1, "abcde", 5) == 0);
+	P_TEST_CHECK (memcmp (part2, "fgh", 3) == 0);
+
+	P_TEST_CHECK (p_file_read_vector_at (file, vectors, 3, 32, NULL) == 6);
+	P_TEST_CHECK (memcmp (part1, "cdefg", 5) == 0);
+	P_TEST_CHECK (part2[0] == 'h');
+
+	P_TEST_CHECK (p_file_sync (file, NULL) == TRUE);
+	P_TEST_CHECK (p_file_sync_data (file, NULL) == TRUE);
+
+	p_file_free (file);
+
+	/* Read-only handle */
+	file = p_file_new (PFILE_TEST_FILE, P_FILE_OPEN_FLAG_READ, NULL);
+	P_TEST_REQUIRE (file != NULL);
+	P_TEST_CHECK (p_file_get_size (file, NULL) == 38);
+	P_TEST_CHECK (p_file_write_at (file, "a", 1, 0, NULL) == -1);
+	P_TEST_CHECK (p_file_writer_new (file, 0, 0) == NULL);
+	p_file_free (file);
+
+	P_TEST_CHECK (p_file_new (PFILE_TEST_FILE,
+				  P_FILE_OPEN_FLAG_WRITE | P_FILE_OPEN_FLAG_CREATE | P_FILE_OPEN_FLAG_EXCLUSIVE,
+				  &error) == NULL);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_EXISTS);
+	p_error_free (error);
+	error = NULL;
+
+	file = p_file_new (PFILE_TEST_FILE, P_FILE_OPEN_FLAG_WRITE | P_FILE_OPEN_FLAG_TRUNCATE, NULL);
+	P_TEST_REQUIRE (file != NULL);
+	P_TEST_CHECK (p_file_get_size (file, NULL) == 0);
+	p_file_free (file);
+
+	P_TEST_CHECK (p_file_remove (PFILE_TEST_FILE, NULL) == TRUE);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pfile_writer_test)
+{
+	p_libsys_init ();
+
+	PFile		*file;
+	PFileWriter	*writer;
+	pchar		record[32];
+	pchar		large[300];
+	pchar		buf[32];
+	puint64		offset = 100;
+	puint64		pos;
+
+	p_file_remove (PFILE_TEST_FILE, NULL);
+
+	file = p_file_new (PFILE_TEST_FILE,
+			   P_FILE_OPEN_FLAG_READ | P_FILE_OPEN_FLAG_WRITE | P_FILE_OPEN_FLAG_CREATE,
+			   NULL);
+	P_TEST_REQUIRE (file != NULL);
+
+	/* Small buffer to go through all the paths */
+	writer = p_file_writer_new (file, offset, 256);
+	P_TEST_REQUIRE (writer != NULL);
+	P_TEST_CHECK (p_file_writer_get_offset (writer) == offset);
+	P_TEST_CHECK (p_file_writer_write (writer, NULL, 1, NULL) == FALSE);
+	P_TEST_CHECK (p_file_writer_write (writer, record, 0, NULL) == TRUE);
+
+	memset (large, 'L', sizeof (large));
+
+	for (pint i = 0; i < PFILE_WRITER_RECORDS; ++i) {
+		snprintf (record, sizeof (record), "%08d", i);
+		P_TEST_CHECK (p_file_writer_write (writer, record, 8, NULL) == TRUE);
+
+		if (i % 1000 == 500)
+			P_TEST_CHECK (p_file_writer_write (writer, large, sizeof (large), NULL) == TRUE);
+	}
+
+	pos = p_file_writer_get_offset (writer);
+	P_TEST_CHECK (pos == offset + PFILE_WRITER_RECORDS * 8 + (PFILE_WRITER_RECORDS / 1000) * sizeof (large));
+
+	/* Not everything is written yet */
+	P_TEST_CHECK (p_file_get_size (file, NULL) < (pint64) pos);
+	P_TEST_CHECK (p_file_writer_flush (writer, NULL) == TRUE);
+	P_TEST_CHECK (p_file_get_size (file, NULL) == (pint64) pos);
+	P_TEST_CHECK (p_file_writer_flush (writer, NULL) == TRUE);
+
+	for (pint i = 0; i < PFILE_WRITER_RECORDS; ++i) {
+		snprintf (record, sizeof (record), "%08d", i);
+		P_TEST_REQUIRE (p_file_read_at (file, buf, 8, offset, NULL) == 8);
+		P_TEST_CHECK (memcmp (buf, record, 8) == 0);
+
+		offset += 8;
+
+		if (i % 1000 == 500) {
+			P_TEST_REQUIRE (p_file_read_at (file, buf, 1, offset + sizeof (large) - 1, NULL) == 1);
+			P_TEST_CHECK (buf[0] == 'L');
+
+			offset += sizeof (large);
+		}
+	}
+
+	/* Freeing flushes the rest */
+	P_TEST_CHECK (p_file_writer_write (writer, "tail", 4, NULL) == TRUE);
+	p_file_writer_free (writer);
+
+	P_TEST_CHECK (p_file_get_size (file, NULL) == (pint64) pos + 4);
+	P_TEST_CHECK (p_file_read_at (file, buf, sizeof (buf), pos, NULL) == 4);
+	P_TEST_CHECK (memcmp (buf, "tail", 4) == 0);
+
+	p_file_free (file);
+
+	P_TEST_CHECK (p_file_remove (PFILE_TEST_FILE, NULL) == TRUE);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pfile_copy_test)
+{
+	p_libsys_init ();
+
+	PError	*error = NULL;
+	pchar	*data  = (pchar *) p_malloc (PFILE_COPY_SIZE);
+	P_TEST_REQUIRE (data != NULL);
+
+	for (pint i = 0; i < PFILE_COPY_SIZE; ++i)
+		data[i] = (pchar) (i * 31 + i / 4096);
+
+	P_TEST_CHECK (p_file_copy (NULL, PFILE_COPY_FILE, 0, NULL) == P_FILE_COPY_METHOD_NONE);
+	P_TEST_CHECK (p_file_copy (PFILE_TEST_FILE, NULL, 0, &error) == P_FILE_COPY_METHOD_NONE);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+	error = NULL;
+
+	p_file_remove (PFILE_TEST_FILE, NULL);
+	p_file_remove (PFILE_COPY_FILE, NULL);
+
+	/* Missing source */
+	P_TEST_CHECK (p_file_copy (PFILE_TEST_FILE, PFILE_COPY_FILE, 0, &error) == P_FILE_COPY_METHOD_NONE);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (p_file_is_exists (PFILE_COPY_FILE) == FALSE);
+	p_error_free (error);
+	error = NULL;
+
+	/* Empty source */
+	PFile *file = p_file_new (PFILE_TEST_FILE,
+				  P_FILE_OPEN_FLAG_WRITE | P_FILE_OPEN_FLAG_CREATE | P_FILE_OPEN_FLAG_TRUNCATE,
+				  NULL);
+	P_TEST_REQUIRE (file != NULL);
+	p_file_free (file);
+
+	P_TEST_CHECK (p_file_copy (PFILE_TEST_FILE, PFILE_COPY_FILE, 0, NULL) != P_FILE_COPY_METHOD_NONE);
+	P_TEST_CHECK (pfile_check_copy (PFILE_COPY_FILE, data, 0) == TRUE);
+
+	/* Existing target */
+	file = p_file_new (PFILE_TEST_FILE, P_FILE_OPEN_FLAG_WRITE | P_FILE_OPEN_FLAG_TRUNCATE, NULL);
+	P_TEST_REQUIRE (file != NULL);
+	P_TEST_CHECK (p_file_write_at (file, data, PFILE_COPY_SIZE, 0, NULL) == PFILE_COPY_SIZE);
+	p_file_free (file);
+
+	P_TEST_CHECK (p_file_copy (PFILE_TEST_FILE, PFILE_COPY_FILE, 0, &error) == P_FILE_COPY_METHOD_NONE);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (p_file_is_exists (PFILE_COPY_FILE) == TRUE);
+	p_error_free (error);
+	error = NULL;
+
+	PFileCopyMethod method = p_file_copy (PFILE_TEST_FILE,
+					      PFILE_COPY_FILE,
+					      P_FILE_COPY_FLAG_OVERWRITE,
+					      &error);
+
+	P_TEST_CHECK (method != P_FILE_COPY_METHOD_NONE);
+	P_TEST_CHECK (error == NULL);
+	P_TEST_CHECK (pfile_check_copy (PFILE_COPY_FILE, data, PFILE_COPY_SIZE) == TRUE);
+
+	/* Physical copy */
+	method = p_file_copy (PFILE_TEST_FILE,
+			      PFILE_COPY_FILE,
+			      P_FILE_COPY_FLAG_OVERWRITE | P_FILE_COPY_FLAG_NO_CLONE,
+			      NULL);
+
+	P_TEST_CHECK (method != P_FILE_COPY_METHOD_NONE);
+	P_TEST_CHECK (method != P_FILE_COPY_METHOD_CLONE);
+	P_TEST_CHECK (pfile_check_copy (PFILE_COPY_FILE, data, PFILE_COPY_SIZE) == TRUE);
+
+	/* Copy onto itself must not lose the data */
+	P_TEST_CHECK (p_file_copy (PFILE_TEST_FILE,
+				   PFILE_TEST_FILE,
+				   P_FILE_COPY_FLAG_OVERWRITE,
+				   NULL) == P_FILE_COPY_METHOD_NONE);
+	P_TEST_CHECK (pfile_check_copy (PFILE_TEST_FILE, data, PFILE_COPY_SIZE) == TRUE);
+
+	P_TEST_CHECK (p_file_remove (PFILE_COPY_FILE, NULL) == TRUE);
+	P_TEST_CHECK (p_file_remove (PFILE_TEST_FILE, NULL) == TRUE);
+
+	p_free (data);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pfile_space_test)
+{
+	p_libsys_init ();
+
+	PFile		*file;
+	PError		*error = NULL;
+	pchar		buf[16];
+	pboolean	supported;
+
+	p_file_remove (PFILE_TEST_FILE, NULL);
+
+	P_TEST_CHECK (p_file_preallocate (NULL, 0, 4096, FALSE, NULL) == FALSE);
+	P_TEST_CHECK (p_file_advise (NULL, 0, 0, P_FILE_ADVICE_SEQUENTIAL, NULL) == FALSE);
+
+	file = p_file_new (PFILE_TEST_FILE,
+			   P_FILE_OPEN_FLAG_READ | P_FILE_OPEN_FLAG_WRITE | P_FILE_OPEN_FLAG_CREATE,
+			   NULL);
+	P_TEST_REQUIRE (file != NULL);
+
+	P_TEST_CHECK (p_file_preallocate (file, 0, 0, FALSE, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_INVALID_ARGUMENT);
+	p_error_free (error);
+	error = NULL;
+
+	P_TEST_CHECK (p_file_preallocate (file, P_MAXUINT64, 1, FALSE, NULL) == FALSE);
+	P_TEST_CHECK (p_file_advise (file, P_MAXUINT64, 0, P_FILE_ADVICE_NORMAL, NULL) == FALSE);
+	P_TEST_CHECK (p_file_advise (file, 0, 0, (PFileAdvice) 100, NULL) == FALSE);
+
+	P_TEST_CHECK (p_file_write_at (file, "data", 4, 0, NULL) == 4);
+
+	/* Some file systems can't reserve the space */
+	supported = p_file_preallocate (file, 0, 64 * 1024, TRUE, &error);
+
+	if (supported) {
+		P_TEST_CHECK (error == NULL);
+		P_TEST_CHECK (p_file_get_size (file, NULL) == 4);
+	} else {
+		P_TEST_CHECK (error != NULL);
+		P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_NOT_SUPPORTED);
+		p_error_free (error);
+		error = NULL;
+	}
+
+	if (p_file_preallocate (file, 1024, 64 * 1024, FALSE, NULL) == TRUE) {
+		P_TEST_CHECK (p_file_get_size (file, NULL) == 65 * 1024);
+
+		/* Reserved region reads as zeros, existing data is untouched */
+		P_TEST_CHECK (p_file_read_at (file, buf, sizeof (buf), 0, NULL) == (pssize) sizeof (buf));
+		P_TEST_CHECK (memcmp (buf, "data", 4) == 0);
+		P_TEST_CHECK (buf[4] == 0 && buf[15] == 0);
+		P_TEST_CHECK (p_file_read_at (file, buf, sizeof (buf), 32 * 1024, NULL) == (pssize) sizeof (buf));
+		P_TEST_CHECK (buf[0] == 0 && buf[15] == 0);
+
+		/* Region inside the file doesn't shrink it */
+		P_TEST_CHECK (p_file_preallocate (file, 0, 1024, FALSE, NULL) == TRUE);
+		P_TEST_CHECK (p_file_get_size (file, NULL) == 65 * 1024);
+	}
+
+	P_TEST_CHECK (p_file_advise (file, 0, 0, P_FILE_ADVICE_SEQUENTIAL, NULL) == TRUE);
+	P_TEST_CHECK (p_file_advise (file, 0, 4096, P_FILE_ADVICE_RANDOM, NULL) == TRUE);
+	P_TEST_CHECK (p_file_advise (file, 0, 0, P_FILE_ADVICE_WILL_NEED, NULL) == TRUE);
+	P_TEST_CHECK (p_file_advise (file, 0, 0, P_FILE_ADVICE_DONT_NEED, NULL) == TRUE);
+	P_TEST_CHECK (p_file_advise (file, 0, 0, P_FILE_ADVICE_NORMAL, NULL) == TRUE);
+
+	/* Hints don't change the data */
+	P_TEST_CHECK (p_file_read_at (file, buf, 4, 0, NULL) == 4);
+	P_TEST_CHECK (memcmp (buf, "data", 4) == 0);
+
+	p_file_free (file);
+
+	/* Read-only handle can't reserve the space */
+	file = p_file_new (PFILE_TEST_FILE, P_FILE_OPEN_FLAG_READ, NULL);
+	P_TEST_REQUIRE (file != NULL);
+
+	if (supported)
+		P_TEST_CHECK (p_file_preallocate (file, 0, 1024 * 1024, FALSE, NULL) == FALSE);
+
+	P_TEST_CHECK (p_file_advise (file, 0, 0, P_FILE_ADVICE_SEQUENTIAL, NULL) == TRUE);
+
+	p_file_free (file);
+
+	P_TEST_CHECK (p_file_remove (PFILE_TEST_FILE, NULL) == TRUE);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
 P_TEST_SUITE_BEGIN()
 {
 	P_TEST_SUITE_RUN_CASE (pfile_general_test);
+	P_TEST_SUITE_RUN_CASE (pfile_io_test);
+	P_TEST_SUITE_RUN_CASE (pfile_writer_test);
+	P_TEST_SUITE_RUN_CASE (pfile_copy_test);
+	P_TEST_SUITE_RUN_CASE (pfile_space_test);
 }
 P_TEST_SUITE_END()
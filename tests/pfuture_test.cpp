@@ -0,0 +1,553 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+P_TEST_MODULE_INIT ();
+
+#define PFUTURE_WORKERS		4
+#define PFUTURE_TASKS		64
+#define PFUTURE_WAITERS		4
+#define PFUTURE_TEST_ERROR	1234
+
+static volatile pint	future_counter = 0;
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static ppointer square_func (ppointer user_data, PError **error)
+{
+	pint value = P_POINTER_TO_INT (user_data);
+
+	P_UNUSED (error);
+
+	p_atomic_int_inc (&future_counter);
+
+	return P_INT_TO_POINTER (value * value);
+}
+
+static ppointer fail_func (ppointer user_data, PError **error)
+{
+	P_UNUSED (user_data);
+
+	*error = p_error_new_literal (PFUTURE_TEST_ERROR, 0, "Test error");
+
+	return NULL;
+}
+
+static ppointer add_then_func (PFuture *future, ppointer user_data, PError **error)
+{
+	pint value = P_POINTER_TO_INT (p_future_get_value (future, error));
+
+	p_atomic_int_inc (&future_counter);
+
+	return P_INT_TO_POINTER (value + P_POINTER_TO_INT (user_data));
+}
+
+static ppointer propagate_then_func (PFuture *future, ppointer user_data, PError **error)
+{
+	P_UNUSED (user_data);
+
+	p_atomic_int_inc (&future_counter);
+
+	return p_future_get_value (future, error);
+}
+
+static ppointer thread_then_func (PFuture *future, ppointer user_data, PError **error)
+{
+	P_UNUSED (future);
+	P_UNUSED (error);
+
+	return P_INT_TO_POINTER (p_uthread_current () == (PUThread *) user_data ? 1 : 2);
+}
+
+static void * wait_thread_func (void *data)
+{
+	PFuture *future = (PFuture *) data;
+
+	p_uthread_exit (P_POINTER_TO_INT (p_future_get_value (future, NULL)));
+
+	return NULL;
+}
+
+P_TEST_CASE_BEGIN (pfuture_nomem_test)
+{
+	p_libsys_init ();
+
+	/* Creates the object pool before breaking the allocator */
+	PPromise *promise = p_promise_new ();
+	P_TEST_REQUIRE (promise != NULL);
+
+	PFuture *futures[2];
+
+	futures[0] = p_promise_get_future (promise);
+	futures[1] = p_promise_get_future (promise);
+
+	P_TEST_REQUIRE (futures[0] != NULL);
+	P_TEST_REQUIRE (futures[1] != NULL);
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	/* The combinator array is allocated from the heap */
+	P_TEST_CHECK (p_future_when_all (futures, 2) == NULL);
+	P_TEST_CHECK (p_future_when_any (futures, 2) == NULL);
+
+	p_mem_restore_vtable ();
+
+	P_TEST_CHECK (p_promise_set_value (promise, P_INT_TO_POINTER (10)) == TRUE);
+	P_TEST_CHECK (P_POINTER_TO_INT (p_future_get_value (futures[0], NULL)) == 10);
+
+	p_future_unref (futures[0]);
+	p_future_unref (futures[1]);
+	p_promise_free (promise);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pfuture_invalid_test)
+{
+	p_libsys_init ();
+
+	PError *error = NULL;
+
+	P_TEST_CHECK (p_promise_get_future (NULL) == NULL);
+	P_TEST_CHECK (p_promise_set_value (NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_promise_set_error (NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_future_async (NULL, square_func, NULL) == NULL);
+	P_TEST_CHECK (p_future_ref (NULL) == NULL);
+	P_TEST_CHECK (p_future_is_ready (NULL) == FALSE);
+	P_TEST_CHECK (p_future_is_failed (NULL) == FALSE);
+	P_TEST_CHECK (p_future_wait (NULL) == FALSE);
+	P_TEST_CHECK (p_future_wait_timed (NULL, 0) == FALSE);
+	P_TEST_CHECK (p_future_get_value (NULL, &error) == NULL);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+	error = NULL;
+	P_TEST_CHECK (p_future_then (NULL, add_then_func, NULL) == NULL);
+	P_TEST_CHECK (p_future_then_pool (NULL, NULL, add_then_func, NULL) == NULL);
+	P_TEST_CHECK (p_future_then_loop (NULL, NULL, add_then_func, NULL) == NULL);
+	P_TEST_CHECK (p_future_when_all (NULL, 1) == NULL);
+	P_TEST_CHECK (p_future_when_any (NULL, 1) == NULL);
+
+	p_future_unref (NULL);
+	p_promise_free (NULL);
+
+	PThreadPool *pool = p_thread_pool_new (1);
+	P_TEST_REQUIRE (pool != NULL);
+
+	PPromise *promise = p_promise_new ();
+	P_TEST_REQUIRE (promise != NULL);
+
+	PFuture *future = p_promise_get_future (promise);
+	P_TEST_REQUIRE (future != NULL);
+
+	P_TEST_CHECK (p_future_async (pool, NULL, NULL) == NULL);
+	P_TEST_CHECK (p_future_then (future, NULL, NULL) == NULL);
+	P_TEST_CHECK (p_future_then_pool (future, NULL, add_then_func, NULL) == NULL);
+	P_TEST_CHECK (p_future_then_pool (future, pool, NULL, NULL) == NULL);
+	P_TEST_CHECK (p_future_then_loop (future, NULL, add_then_func, NULL) == NULL);
+	P_TEST_CHECK (p_future_when_all (&future, 0) == NULL);
+	P_TEST_CHECK (p_future_when_any (&future, 0) == NULL);
+
+	p_future_unref (future);
+	p_promise_free (promise);
+	p_thread_pool_free (pool);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pfuture_promise_test)
+{
+	p_libsys_init ();
+
+	PError *error = NULL;
+
+	/* Value */
+	PPromise *promise = p_promise_new ();
+	P_TEST_REQUIRE (promise != NULL);
+
+	PFuture *future = p_promise_get_future (promise);
+	P_TEST_REQUIRE (future != NULL);
+
+	P_TEST_CHECK (p_future_is_ready (future) == FALSE);
+	P_TEST_CHECK (p_future_is_failed (future) == FALSE);
+	P_TEST_CHECK (p_future_wait_timed (future, 0) == FALSE);
+	P_TEST_CHECK (p_future_wait_timed (future, 10) == FALSE);
+
+	P_TEST_CHECK (p_promise_set_value (promise, P_INT_TO_POINTER (42)) == TRUE);
+	P_TEST_CHECK (p_promise_set_value (promise, P_INT_TO_POINTER (43)) == FALSE);
+	P_TEST_CHECK (p_promise_set_error (promise, NULL) == FALSE);
+
+	P_TEST_CHECK (p_future_is_ready (future) == TRUE);
+	P_TEST_CHECK (p_future_is_failed (future) == FALSE);
+	P_TEST_CHECK (p_future_wait (future) == TRUE);
+	P_TEST_CHECK (p_future_wait_timed (future, 0) == TRUE);
+	P_TEST_CHECK (P_POINTER_TO_INT (p_future_get_value (future, &error)) == 42);
+	P_TEST_CHECK (error == NULL);
+
+	/* The future outlives its promise */
+	p_promise_free (promise);
+
+	P_TEST_CHECK (p_future_ref (future) == future);
+	p_future_unref (future);
+	P_TEST_CHECK (P_POINTER_TO_INT (p_future_get_value (future, NULL)) == 42);
+	p_future_unref (future);
+
+	/* Error */
+	promise = p_promise_new ();
+	P_TEST_REQUIRE (promise != NULL);
+
+	future = p_promise_get_future (promise);
+	P_TEST_REQUIRE (future != NULL);
+
+	P_TEST_CHECK (p_promise_set_error (promise, p_error_new_literal (PFUTURE_TEST_ERROR, 0, "Test error")) == TRUE);
+	P_TEST_CHECK (p_promise_set_error (promise, p_error_new_literal (PFUTURE_TEST_ERROR + 1, 0, NULL)) == FALSE);
+	P_TEST_CHECK (p_promise_set_value (promise, NULL) == FALSE);
+
+	P_TEST_CHECK (p_future_is_ready (future) == TRUE);
+	P_TEST_CHECK (p_future_is_failed (future) == TRUE);
+	P_TEST_CHECK (p_future_get_value (future, &error) == NULL);
+	P_TEST_REQUIRE (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == PFUTURE_TEST_ERROR);
+	p_error_free (error);
+	error = NULL;
+
+	p_promise_free (promise);
+	p_future_unref (future);
+
+	/* Broken promise */
+	promise = p_promise_new ();
+	P_TEST_REQUIRE (promise != NULL);
+
+	future = p_promise_get_future (promise);
+	P_TEST_REQUIRE (future != NULL);
+
+	p_promise_free (promise);
+
+	P_TEST_CHECK (p_future_is_failed (future) == TRUE);
+	P_TEST_CHECK (p_future_get_value (future, &error) == NULL);
+	P_TEST_REQUIRE (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_FAILED);
+	p_error_free (error);
+
+	p_future_unref (future);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pfuture_async_test)
+{
+	p_libsys_init ();
+
+	future_counter = 0;
+
+	PThreadPool *pool = p_thread_pool_new (PFUTURE_WORKERS);
+	P_TEST_REQUIRE (pool != NULL);
+
+	PFuture *futures[PFUTURE_TASKS];
+
+	for (pint i = 0; i < PFUTURE_TASKS; ++i) {
+		futures[i] = p_future_async (pool, square_func, P_INT_TO_POINTER (i));
+		P_TEST_REQUIRE (futures[i] != NULL);
+	}
+
+	/* Several threads block on the same future */
+	PUThread *threads[PFUTURE_WAITERS];
+
+	for (pint i = 0; i < PFUTURE_WAITERS; ++i) {
+		threads[i] = p_uthread_create ((PUThreadFunc) wait_thread_func,
+					       futures[PFUTURE_TASKS - 1],
+					       TRUE,
+					       NULL);
+		P_TEST_REQUIRE (threads[i] != NULL);
+	}
+
+	for (pint i = 0; i < PFUTURE_WAITERS; ++i) {
+		P_TEST_CHECK (p_uthread_join (threads[i]) == (PFUTURE_TASKS - 1) * (PFUTURE_TASKS - 1));
+		p_uthread_unref (threads[i]);
+	}
+
+	for (pint i = 0; i < PFUTURE_TASKS; ++i) {
+		P_TEST_CHECK (P_POINTER_TO_INT (p_future_get_value (futures[i], NULL)) == i * i);
+		p_future_unref (futures[i]);
+	}
+
+	P_TEST_CHECK (future_counter == PFUTURE_TASKS);
+
+	/* Errors reported by the function */
+	PError *error = NULL;
+
+	PFuture *future = p_future_async (pool, fail_func, NULL);
+	P_TEST_REQUIRE (future != NULL);
+
+	P_TEST_CHECK (p_future_get_value (future, &error) == NULL);
+	P_TEST_CHECK (p_future_is_failed (future) == TRUE);
+	P_TEST_REQUIRE (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == PFUTURE_TEST_ERROR);
+	p_error_free (error);
+
+	p_future_unref (future);
+
+	/* A stopped pool refuses the task */
+	p_thread_pool_shutdown (pool, TRUE);
+
+	P_TEST_CHECK (p_future_async (pool, square_func, NULL) == NULL);
+
+	p_thread_pool_free (pool);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pfuture_then_test)
+{
+	p_libsys_init ();
+
+	future_counter = 0;
+
+	PError *error = NULL;
+
+	/* Inline continuations chained before completion run in order */
+	PPromise *promise = p_promise_new ();
+	P_TEST_REQUIRE (promise != NULL);
+
+	PFuture *future = p_promise_get_future (promise);
+	P_TEST_REQUIRE (future != NULL);
+
+	PFuture *first  = p_future_then (future, add_then_func, P_INT_TO_POINTER (1));
+	PFuture *second = p_future_then (first, add_then_func, P_INT_TO_POINTER (10));
+
+	P_TEST_REQUIRE (first != NULL);
+	P_TEST_REQUIRE (second != NULL);
+
+	/* Intermediate futures may be released right away */
+	p_future_unref (first);
+
+	P_TEST_CHECK (p_future_is_ready (second) == FALSE);
+	P_TEST_CHECK (p_promise_set_value (promise, P_INT_TO_POINTER (100)) == TRUE);
+	P_TEST_CHECK (p_future_is_ready (second) == TRUE);
+	P_TEST_CHECK (P_POINTER_TO_INT (p_future_get_value (second, NULL)) == 111);
+	P_TEST_CHECK (future_counter == 2);
+
+	p_future_unref (second);
+
+	/* Chained after completion runs right away */
+	PFuture *late = p_future_then (future, add_then_func, P_INT_TO_POINTER (5));
+	P_TEST_REQUIRE (late != NULL);
+	P_TEST_CHECK (p_future_is_ready (late) == TRUE);
+	P_TEST_CHECK (P_POINTER_TO_INT (p_future_get_value (late, NULL)) == 105);
+
+	p_future_unref (late);
+	p_future_unref (future);
+	p_promise_free (promise);
+
+	/* Errors propagate along the chain */
+	promise = p_promise_new ();
+	P_TEST_REQUIRE (promise != NULL);
+
+	future = p_promise_get_future (promise);
+	P_TEST_REQUIRE (future != NULL);
+
+	first = p_future_then (future, propagate_then_func, NULL);
+	P_TEST_REQUIRE (first != NULL);
+
+	P_TEST_CHECK (p_promise_set_error (promise, p_error_new_literal (PFUTURE_TEST_ERROR, 0, "Test error")) == TRUE);
+	P_TEST_CHECK (p_future_is_failed (first) == TRUE);
+	P_TEST_CHECK (p_future_get_value (first, &error) == NULL);
+	P_TEST_REQUIRE (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == PFUTURE_TEST_ERROR);
+	p_error_free (error);
+
+	p_future_unref (first);
+	p_future_unref (future);
+	p_promise_free (promise);
+
+	/* Thread pool continuations */
+	PThreadPool *pool = p_thread_pool_new (PFUTURE_WORKERS);
+	P_TEST_REQUIRE (pool != NULL);
+
+	future_counter = 0;
+
+	future = p_future_async (pool, square_func, P_INT_TO_POINTER (3));
+	P_TEST_REQUIRE (future != NULL);
+
+	PFuture *chained[PFUTURE_TASKS];
+
+	for (pint i = 0; i < PFUTURE_TASKS; ++i) {
+		chained[i] = p_future_then_pool (future, pool, add_then_func, P_INT_TO_POINTER (i));
+		P_TEST_REQUIRE (chained[i] != NULL);
+	}
+
+	p_future_unref (future);
+
+	for (pint i = 0; i < PFUTURE_TASKS; ++i) {
+		P_TEST_CHECK (P_POINTER_TO_INT (p_future_get_value (chained[i], NULL)) == 9 + i);
+		p_future_unref (chained[i]);
+	}
+
+	P_TEST_CHECK (future_counter == PFUTURE_TASKS + 1);
+
+	/* Event loop continuations run in the loop thread */
+	PEventLoop *loop = p_event_loop_new (NULL);
+	P_TEST_REQUIRE (loop != NULL);
+
+	future = p_future_async (pool, square_func, P_INT_TO_POINTER (4));
+	P_TEST_REQUIRE (future != NULL);
+
+	first = p_future_then_loop (future, loop, thread_then_func, p_uthread_current ());
+	P_TEST_REQUIRE (first != NULL);
+
+	P_TEST_CHECK (p_future_wait (future) == TRUE);
+
+	while (p_future_is_ready (first) == FALSE)
+		P_TEST_CHECK (p_event_loop_run_once (loop, 100, NULL) >= 0);
+
+	P_TEST_CHECK (P_POINTER_TO_INT (p_future_get_value (first, NULL)) == 1);
+
+	p_future_unref (first);
+	p_future_unref (future);
+
+	p_event_loop_free (loop);
+	p_thread_pool_free (pool);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pfuture_combine_test)
+{
+	p_libsys_init ();
+
+	PError		*error = NULL;
+	PPromise	*promises[3];
+	PFuture		*futures[3];
+
+	for (pint i = 0; i < 3; ++i) {
+		promises[i] = p_promise_new ();
+		P_TEST_REQUIRE (promises[i] != NULL);
+
+		futures[i] = p_promise_get_future (promises[i]);
+		P_TEST_REQUIRE (futures[i] != NULL);
+	}
+
+	PFuture *all = p_future_when_all (futures, 3);
+	PFuture *any = p_future_when_any (futures, 3);
+
+	P_TEST_REQUIRE (all != NULL);
+	P_TEST_REQUIRE (any != NULL);
+
+	P_TEST_CHECK (p_future_is_ready (all) == FALSE);
+	P_TEST_CHECK (p_future_is_ready (any) == FALSE);
+
+	P_TEST_CHECK (p_promise_set_value (promises[1], NULL) == TRUE);
+
+	P_TEST_CHECK (p_future_is_ready (all) == FALSE);
+	P_TEST_CHECK (p_future_is_ready (any) == TRUE);
+	P_TEST_CHECK (P_POINTER_TO_INT (p_future_get_value (any, NULL)) == 1);
+
+	/* The last failed one is reported as the first one in the array order */
+	P_TEST_CHECK (p_promise_set_error (promises[2], p_error_new_literal (PFUTURE_TEST_ERROR + 2, 0, NULL)) == TRUE);
+	P_TEST_CHECK (p_future_is_ready (all) == FALSE);
+	P_TEST_CHECK (p_promise_set_error (promises[0], p_error_new_literal (PFUTURE_TEST_ERROR, 0, NULL)) == TRUE);
+
+	P_TEST_CHECK (p_future_is_ready (all) == TRUE);
+	P_TEST_CHECK (p_future_get_value (all, &error) == NULL);
+	P_TEST_REQUIRE (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == PFUTURE_TEST_ERROR);
+	p_error_free (error);
+	error = NULL;
+
+	p_future_unref (all);
+	p_future_unref (any);
+
+	for (pint i = 0; i < 3; ++i) {
+		p_future_unref (futures[i]);
+		p_promise_free (promises[i]);
+	}
+
+	/* All succeeded, combined from a thread pool */
+	PThreadPool *pool = p_thread_pool_new (PFUTURE_WORKERS);
+	P_TEST_REQUIRE (pool != NULL);
+
+	PFuture *tasks[PFUTURE_TASKS];
+
+	for (pint i = 0; i < PFUTURE_TASKS; ++i) {
+		tasks[i] = p_future_async (pool, square_func, P_INT_TO_POINTER (i));
+		P_TEST_REQUIRE (tasks[i] != NULL);
+	}
+
+	all = p_future_when_all (tasks, PFUTURE_TASKS);
+	P_TEST_REQUIRE (all != NULL);
+
+	for (pint i = 0; i < PFUTURE_TASKS; ++i)
+		p_future_unref (tasks[i]);
+
+	P_TEST_CHECK (p_future_wait (all) == TRUE);
+	P_TEST_CHECK (p_future_is_failed (all) == FALSE);
+	P_TEST_CHECK (p_future_get_value (all, &error) == NULL);
+	P_TEST_CHECK (error == NULL);
+
+	p_future_unref (all);
+	p_thread_pool_free (pool);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pfuture_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pfuture_invalid_test);
+	P_TEST_SUITE_RUN_CASE (pfuture_promise_test);
+	P_TEST_SUITE_RUN_CASE (pfuture_async_test);
+	P_TEST_SUITE_RUN_CASE (pfuture_then_test);
+	P_TEST_SUITE_RUN_CASE (pfuture_combine_test);
+}
+P_TEST_SUITE_END()
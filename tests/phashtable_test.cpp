@@ -27,6 +27,7 @@
 #include "ptestmacros.h"
 
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
 P_TEST_MODULE_INIT ();
@@ -56,6 +57,14 @@ static int test_hash_table_values (pconstpointer a, pconstpointer b)
 	return a > b ? 0 : (a < b ? -1 : 1);
 }
 
+static pint test_hash_table_destroy_counter = 0;
+
+static void test_hash_table_destroy (ppointer data)
+{
+	P_UNUSED (data);
+	++test_hash_table_destroy_counter;
+}
+
 P_TEST_CASE_BEGIN (phashtable_nomem_test)
 {
 	p_libsys_init ();
@@ -72,9 +81,20 @@ P_TEST_CASE_BEGIN (phashtable_nomem_test)
 	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
 
 	P_TEST_CHECK (p_hash_table_new () == NULL);
+	P_TEST_CHECK (p_hash_table_new_indexed (NULL, NULL, NULL, NULL, NULL, NULL) == NULL);
+	P_TEST_CHECK (p_hash_table_new_sized (1000) == NULL);
+	P_TEST_CHECK (p_hash_table_reserve (table, 1000) == FALSE);
 	p_hash_table_insert (table, PINT_TO_POINTER (1), PINT_TO_POINTER (10));
 	P_TEST_CHECK (p_hash_table_keys (table) == NULL);
 	P_TEST_CHECK (p_hash_table_values (table) == NULL);
+	P_TEST_CHECK (p_hash_table_keys_array (table) == NULL);
+	P_TEST_CHECK (p_hash_table_values_array (table) == NULL);
+
+	/* Pairs are stored inline, so free slots are used without allocations */
+	P_TEST_CHECK (p_hash_table_lookup (table, PINT_TO_POINTER (1)) == PINT_TO_POINTER (10));
+	p_hash_table_remove (table, PINT_TO_POINTER (1));
+	p_hash_table_insert (table, PINT_TO_POINTER (2), PINT_TO_POINTER (20));
+	P_TEST_CHECK (p_hash_table_lookup (table, PINT_TO_POINTER (2)) == PINT_TO_POINTER (20));
 
 	p_mem_restore_vtable ();
 
@@ -95,6 +115,28 @@ P_TEST_CASE_BEGIN (phashtable_invalid_test)
 	p_hash_table_insert (NULL, NULL, NULL);
 	p_hash_table_remove (NULL, NULL);
 	p_hash_table_free (NULL);
+	P_TEST_CHECK (p_hash_table_insert_bulk (NULL, NULL, NULL, 0) == FALSE);
+	P_TEST_CHECK (p_hash_table_reserve (NULL, 0) == FALSE);
+	P_TEST_CHECK (p_hash_table_keys_array (NULL) == NULL);
+	P_TEST_CHECK (p_hash_table_values_array (NULL) == NULL);
+
+	PHashTable *table = p_hash_table_new ();
+	P_TEST_REQUIRE (table != NULL);
+
+	P_TEST_CHECK (p_hash_table_insert_bulk (table, NULL, NULL, 0) == TRUE);
+	P_TEST_CHECK (p_hash_table_insert_bulk (table, NULL, NULL, 10) == FALSE);
+	P_TEST_CHECK (p_hash_table_reserve (table, (psize) -1) == FALSE);
+
+	p_hash_table_free (table);
+
+	PHashTableIter iter;
+
+	p_hash_table_iter_init (NULL, NULL);
+	p_hash_table_iter_init (&iter, NULL);
+	P_TEST_CHECK (p_hash_table_iter_next (NULL, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_hash_table_iter_next (&iter, NULL, NULL) == FALSE);
+	p_hash_table_iter_remove (NULL);
+	p_hash_table_iter_remove (&iter);
 
 	p_libsys_shutdown ();
 }
@@ -310,11 +352,425 @@ P_TEST_CASE_BEGIN (phashtable_stress_test)
 }
 P_TEST_CASE_END ()
 
+P_TEST_CASE_BEGIN (phashtable_resize_test)
+{
+	p_libsys_init ();
+
+	PHashTable *table = p_hash_table_new ();
+	P_TEST_REQUIRE (table != NULL);
+
+	/* Aligned keys used to collide a lot with the old hashing scheme */
+	for (int i = 0; i < PHASHTABLE_STRESS_COUNT; ++i)
+		p_hash_table_insert (table, PINT_TO_POINTER (i * 16), PINT_TO_POINTER (i + 1));
+
+	for (int i = 0; i < PHASHTABLE_STRESS_COUNT; i += 2)
+		p_hash_table_remove (table, PINT_TO_POINTER (i * 16));
+
+	for (int i = 0; i < PHASHTABLE_STRESS_COUNT; ++i) {
+		if (i % 2 == 0)
+			P_TEST_CHECK (p_hash_table_lookup (table, PINT_TO_POINTER (i * 16)) == (ppointer) (-1));
+		else
+			P_TEST_CHECK (p_hash_table_lookup (table, PINT_TO_POINTER (i * 16)) == PINT_TO_POINTER (i + 1));
+	}
+
+	/* Reuse deleted slots */
+	for (int i = 0; i < PHASHTABLE_STRESS_COUNT; i += 2)
+		p_hash_table_insert (table, PINT_TO_POINTER (i * 16), PINT_TO_POINTER (i + 2));
+
+	for (int i = 0; i < PHASHTABLE_STRESS_COUNT; ++i)
+		P_TEST_CHECK (p_hash_table_lookup (table, PINT_TO_POINTER (i * 16)) ==
+			      PINT_TO_POINTER (i % 2 == 0 ? i + 2 : i + 1));
+
+	PList *list = p_hash_table_keys (table);
+	P_TEST_CHECK (p_list_length (list) == PHASHTABLE_STRESS_COUNT);
+	p_list_free (list);
+
+	for (int i = 0; i < PHASHTABLE_STRESS_COUNT; ++i)
+		p_hash_table_remove (table, PINT_TO_POINTER (i * 16));
+
+	P_TEST_CHECK (p_hash_table_keys (table) == NULL);
+
+	p_hash_table_free (table);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (phashtable_full_test)
+{
+	p_libsys_init ();
+
+	/* String keys */
+	PHashTable *table = p_hash_table_new_full (p_str_hash, p_str_equal, p_free, NULL);
+	P_TEST_REQUIRE (table != NULL);
+
+	p_hash_table_insert (table, p_strdup ("first"), PINT_TO_POINTER (1));
+	p_hash_table_insert (table, p_strdup ("second"), PINT_TO_POINTER (2));
+	p_hash_table_insert (table, p_strdup ("third"), PINT_TO_POINTER (3));
+
+	/* Lookup with different pointers to the same strings */
+	pchar key[16];
+
+	strcpy (key, "first");
+	P_TEST_CHECK (p_hash_table_lookup (table, key) == PINT_TO_POINTER (1));
+	strcpy (key, "second");
+	P_TEST_CHECK (p_hash_table_lookup (table, key) == PINT_TO_POINTER (2));
+	strcpy (key, "fourth");
+	P_TEST_CHECK (p_hash_table_lookup (table, key) == (ppointer) (-1));
+
+	/* Replace the key, the old one is freed */
+	p_hash_table_insert (table, p_strdup ("second"), PINT_TO_POINTER (20));
+	P_TEST_CHECK (p_hash_table_lookup (table, "second") == PINT_TO_POINTER (20));
+
+	PList *list = p_hash_table_keys (table);
+	P_TEST_CHECK (p_list_length (list) == 3);
+	p_list_free (list);
+
+	p_hash_table_remove (table, "first");
+	P_TEST_CHECK (p_hash_table_lookup (table, "first") == (ppointer) (-1));
+	P_TEST_CHECK (p_hash_table_lookup (table, "third") == PINT_TO_POINTER (3));
+
+	p_hash_table_free (table);
+
+	/* Integer keys and destroy notifications */
+	pint int_keys[PHASHTABLE_STRESS_COUNT];
+	pint int_lookup;
+
+	for (int i = 0; i < PHASHTABLE_STRESS_COUNT; ++i)
+		int_keys[i] = i * 4;
+
+	test_hash_table_destroy_counter = 0;
+
+	table = p_hash_table_new_full (p_int_hash,
+				       p_int_equal,
+				       (PDestroyFunc) test_hash_table_destroy,
+				       (PDestroyFunc) test_hash_table_destroy);
+	P_TEST_REQUIRE (table != NULL);
+
+	for (int i = 0; i < PHASHTABLE_STRESS_COUNT; ++i)
+		p_hash_table_insert (table, &int_keys[i], PINT_TO_POINTER (i));
+
+	for (int i = 0; i < PHASHTABLE_STRESS_COUNT; ++i) {
+		int_lookup = i * 4;
+		P_TEST_CHECK (p_hash_table_lookup (table, &int_lookup) == PINT_TO_POINTER (i));
+	}
+
+	P_TEST_CHECK (test_hash_table_destroy_counter == 0);
+
+	int_lookup = 0;
+	p_hash_table_remove (table, &int_lookup);
+	P_TEST_CHECK (test_hash_table_destroy_counter == 2);
+
+	p_hash_table_insert (table, &int_keys[1], PINT_TO_POINTER (100));
+	P_TEST_CHECK (test_hash_table_destroy_counter == 4);
+
+	p_hash_table_free (table);
+	P_TEST_CHECK (test_hash_table_destroy_counter == PHASHTABLE_STRESS_COUNT * 2 + 2);
+
+	/* Built-in functions */
+	P_TEST_CHECK (p_direct_equal (NULL, NULL) == TRUE);
+	P_TEST_CHECK (p_direct_equal (PINT_TO_POINTER (1), PINT_TO_POINTER (2)) == FALSE);
+	P_TEST_CHECK (p_direct_hash (PINT_TO_POINTER (64)) == p_direct_hash (PINT_TO_POINTER (64)));
+	P_TEST_CHECK (p_str_hash ("") == p_str_hash (""));
+	P_TEST_CHECK (p_str_hash ("abc") != p_str_hash ("abd"));
+	P_TEST_CHECK (p_str_equal ("abc", "abc") == TRUE);
+	P_TEST_CHECK (p_str_equal ("abc", "abd") == FALSE);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (phashtable_iter_test)
+{
+	PHashTableIter	iter;
+	ppointer	key;
+	ppointer	value;
+	pint		counter;
+	pint		sum;
+
+	p_libsys_init ();
+
+	test_hash_table_destroy_counter = 0;
+
+	PHashTable *table = p_hash_table_new_full (NULL, NULL, NULL, (PDestroyFunc) test_hash_table_destroy);
+	P_TEST_REQUIRE (table != NULL);
+
+	/* Empty table */
+	p_hash_table_iter_init (&iter, table);
+	P_TEST_CHECK (p_hash_table_iter_next (&iter, &key, &value) == FALSE);
+	p_hash_table_iter_remove (&iter);
+
+	for (int i = 1; i <= PHASHTABLE_STRESS_COUNT; ++i)
+		p_hash_table_insert (table, PINT_TO_POINTER (i), PINT_TO_POINTER (i * 2));
+
+	counter = 0;
+	sum     = 0;
+
+	p_hash_table_iter_init (&iter, table);
+
+	while (p_hash_table_iter_next (&iter, &key, &value) == TRUE) {
+		P_TEST_CHECK (PPOINTER_TO_INT (value) == PPOINTER_TO_INT (key) * 2);
+
+		++counter;
+		sum += PPOINTER_TO_INT (key);
+	}
+
+	P_TEST_CHECK (counter == PHASHTABLE_STRESS_COUNT);
+	P_TEST_CHECK (sum == PHASHTABLE_STRESS_COUNT * (PHASHTABLE_STRESS_COUNT + 1) / 2);
+
+	/* Remove all even keys during iteration */
+	counter = 0;
+
+	p_hash_table_iter_init (&iter, table);
+
+	while (p_hash_table_iter_next (&iter, &key, NULL) == TRUE) {
+		++counter;
+
+		if (PPOINTER_TO_INT (key) % 2 == 0) {
+			p_hash_table_iter_remove (&iter);
+
+			/* Second remove is ignored */
+			p_hash_table_iter_remove (&iter);
+		}
+	}
+
+	P_TEST_CHECK (counter == PHASHTABLE_STRESS_COUNT);
+	P_TEST_CHECK (test_hash_table_destroy_counter == PHASHTABLE_STRESS_COUNT / 2);
+
+	for (int i = 1; i <= PHASHTABLE_STRESS_COUNT; ++i) {
+		if (i % 2 == 0)
+			P_TEST_CHECK (p_hash_table_lookup (table, PINT_TO_POINTER (i)) == (ppointer) (-1));
+		else
+			P_TEST_CHECK (p_hash_table_lookup (table, PINT_TO_POINTER (i)) == PINT_TO_POINTER (i * 2));
+	}
+
+	/* Remove the rest */
+	counter = 0;
+
+	p_hash_table_iter_init (&iter, table);
+
+	while (p_hash_table_iter_next (&iter, NULL, &value) == TRUE) {
+		P_TEST_CHECK ((PPOINTER_TO_INT (value) / 2) % 2 == 1);
+		p_hash_table_iter_remove (&iter);
+		++counter;
+	}
+
+	P_TEST_CHECK (counter == PHASHTABLE_STRESS_COUNT / 2);
+	P_TEST_CHECK (p_hash_table_keys (table) == NULL);
+
+	p_hash_table_free (table);
+
+	P_TEST_CHECK (test_hash_table_destroy_counter == PHASHTABLE_STRESS_COUNT);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (phashtable_indexed_test)
+{
+	p_libsys_init ();
+
+	PHashTable *table = p_hash_table_new_indexed (NULL, NULL, NULL, NULL, NULL, NULL);
+	P_TEST_REQUIRE (table != NULL);
+
+	for (pint i = 0; i < PHASHTABLE_STRESS_COUNT; ++i)
+		p_hash_table_insert (table, PINT_TO_POINTER (i + 1), PINT_TO_POINTER (i % 10 + 1));
+
+	PList *list = p_hash_table_lookup_by_value (table, PINT_TO_POINTER (1), NULL);
+	P_TEST_CHECK (p_list_length (list) == PHASHTABLE_STRESS_COUNT / 10);
+
+	for (PList *iter = list; iter != NULL; iter = iter->next)
+		P_TEST_CHECK ((PPOINTER_TO_INT (iter->data) - 1) % 10 == 0);
+
+	p_list_free (list);
+
+	P_TEST_CHECK (p_hash_table_lookup_by_value (table, PINT_TO_POINTER (11), NULL) == NULL);
+
+	/* Moving a key to another value updates the index */
+	p_hash_table_insert (table, PINT_TO_POINTER (1), PINT_TO_POINTER (11));
+
+	list = p_hash_table_lookup_by_value (table, PINT_TO_POINTER (11), NULL);
+	P_TEST_CHECK (p_list_length (list) == 1);
+	P_TEST_CHECK (list->data == PINT_TO_POINTER (1));
+	p_list_free (list);
+
+	list = p_hash_table_lookup_by_value (table, PINT_TO_POINTER (1), NULL);
+	P_TEST_CHECK (p_list_length (list) == PHASHTABLE_STRESS_COUNT / 10 - 1);
+	p_list_free (list);
+
+	/* Removals through both the table and the iterator */
+	p_hash_table_remove (table, PINT_TO_POINTER (1));
+	P_TEST_CHECK (p_hash_table_lookup_by_value (table, PINT_TO_POINTER (11), NULL) == NULL);
+
+	PHashTableIter	hash_iter;
+	ppointer	key;
+	ppointer	value;
+
+	p_hash_table_iter_init (&hash_iter, table);
+
+	while (p_hash_table_iter_next (&hash_iter, &key, &value) == TRUE) {
+		if (value == PINT_TO_POINTER (2))
+			p_hash_table_iter_remove (&hash_iter);
+	}
+
+	P_TEST_CHECK (p_hash_table_lookup_by_value (table, PINT_TO_POINTER (2), NULL) == NULL);
+
+	/* An explicit compare function scans the table */
+	list = p_hash_table_lookup_by_value (table,
+					     PINT_TO_POINTER (3),
+					     (PCompareFunc) test_hash_table_values);
+	P_TEST_CHECK (p_list_length (list) == PHASHTABLE_STRESS_COUNT / 10 * 7);
+	p_list_free (list);
+
+	p_hash_table_free (table);
+
+	/* String values with destroy notifications */
+	pchar one_first[]  = "one";
+	pchar one_second[] = "one";
+	pchar one_third[]  = "one";
+
+	test_hash_table_destroy_counter = 0;
+
+	table = p_hash_table_new_indexed (NULL,
+					  NULL,
+					  NULL,
+					  test_hash_table_destroy,
+					  p_str_hash,
+					  p_str_equal);
+	P_TEST_REQUIRE (table != NULL);
+
+	p_hash_table_insert (table, PINT_TO_POINTER (1), one_first);
+	p_hash_table_insert (table, PINT_TO_POINTER (2), one_second);
+
+	/* Same value, different pointer: the old one is destroyed */
+	p_hash_table_insert (table, PINT_TO_POINTER (2), one_third);
+	P_TEST_CHECK (test_hash_table_destroy_counter == 1);
+
+	list = p_hash_table_lookup_by_value (table, "one", NULL);
+	P_TEST_CHECK (p_list_length (list) == 2);
+	p_list_free (list);
+
+	p_hash_table_remove (table, PINT_TO_POINTER (1));
+	P_TEST_CHECK (test_hash_table_destroy_counter == 2);
+
+	list = p_hash_table_lookup_by_value (table, "one", NULL);
+	P_TEST_CHECK (p_list_length (list) == 1);
+	p_list_free (list);
+
+	p_hash_table_free (table);
+	P_TEST_CHECK (test_hash_table_destroy_counter == 3);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (phashtable_bulk_test)
+{
+	p_libsys_init ();
+
+	ppointer *keys   = (ppointer *) p_malloc0 (PHASHTABLE_STRESS_COUNT * sizeof (ppointer));
+	ppointer *values = (ppointer *) p_malloc0 (PHASHTABLE_STRESS_COUNT * sizeof (ppointer));
+
+	P_TEST_REQUIRE (keys != NULL);
+	P_TEST_REQUIRE (values != NULL);
+
+	for (pint i = 0; i < PHASHTABLE_STRESS_COUNT; ++i) {
+		keys[i]   = PINT_TO_POINTER (i + 1);
+		values[i] = PINT_TO_POINTER (i + 10);
+	}
+
+	PHashTable *table = p_hash_table_new_sized (PHASHTABLE_STRESS_COUNT);
+	P_TEST_REQUIRE (table != NULL);
+
+	/* Pre-sized table holds all the pairs without allocations */
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	for (pint i = 0; i < PHASHTABLE_STRESS_COUNT / 2; ++i)
+		p_hash_table_insert (table, keys[i], values[i]);
+
+	P_TEST_CHECK (p_hash_table_reserve (table, PHASHTABLE_STRESS_COUNT) == TRUE);
+	P_TEST_CHECK (p_hash_table_insert_bulk (table,
+						keys + PHASHTABLE_STRESS_COUNT / 2,
+						values + PHASHTABLE_STRESS_COUNT / 2,
+						PHASHTABLE_STRESS_COUNT / 2) == TRUE);
+
+	/* Room is reserved for all the given pairs, even the duplicated ones */
+	P_TEST_CHECK (p_hash_table_insert_bulk (table, keys, keys, PHASHTABLE_STRESS_COUNT) == FALSE);
+
+	p_mem_restore_vtable ();
+
+	for (pint i = 0; i < PHASHTABLE_STRESS_COUNT; ++i)
+		P_TEST_CHECK (p_hash_table_lookup (table, keys[i]) == values[i]);
+
+	p_hash_table_free (table);
+
+	/* Bulk insert into a table which has to grow, with duplicated keys */
+	table = p_hash_table_new ();
+	P_TEST_REQUIRE (table != NULL);
+
+	p_hash_table_insert (table, PINT_TO_POINTER (1), PINT_TO_POINTER (1));
+
+	P_TEST_CHECK (p_hash_table_insert_bulk (table, keys, values, PHASHTABLE_STRESS_COUNT) == TRUE);
+	P_TEST_CHECK (p_hash_table_insert_bulk (table, keys, keys, PHASHTABLE_STRESS_COUNT / 2) == TRUE);
+
+	for (pint i = 0; i < PHASHTABLE_STRESS_COUNT; ++i)
+		P_TEST_CHECK (p_hash_table_lookup (table, keys[i]) ==
+			      (i < PHASHTABLE_STRESS_COUNT / 2 ? keys[i] : values[i]));
+
+	PList *list = p_hash_table_keys (table);
+	P_TEST_CHECK (p_list_length (list) == PHASHTABLE_STRESS_COUNT);
+
+	/* Array variants follow the list order */
+	PArray *array = p_hash_table_keys_array (table);
+	P_TEST_REQUIRE (array != NULL);
+	P_TEST_CHECK (p_array_length (array) == PHASHTABLE_STRESS_COUNT);
+
+	psize index = 0;
+
+	for (PList *iter = list; iter != NULL; iter = iter->next, ++index)
+		P_TEST_CHECK (p_array_index (array, index) == iter->data);
+
+	p_array_free (array);
+	p_list_free (list);
+
+	list  = p_hash_table_values (table);
+	array = p_hash_table_values_array (table);
+	P_TEST_REQUIRE (array != NULL);
+	P_TEST_CHECK (p_array_length (array) == PHASHTABLE_STRESS_COUNT);
+
+	index = 0;
+
+	for (PList *iter = list; iter != NULL; iter = iter->next, ++index)
+		P_TEST_CHECK (p_array_index (array, index) == iter->data);
+
+	p_array_free (array);
+	p_list_free (list);
+
+	p_hash_table_free (table);
+
+	p_free (keys);
+	p_free (values);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
 P_TEST_SUITE_BEGIN()
 {
 	P_TEST_SUITE_RUN_CASE (phashtable_nomem_test);
 	P_TEST_SUITE_RUN_CASE (phashtable_invalid_test);
 	P_TEST_SUITE_RUN_CASE (phashtable_general_test);
 	P_TEST_SUITE_RUN_CASE (phashtable_stress_test);
+	P_TEST_SUITE_RUN_CASE (phashtable_resize_test);
+	P_TEST_SUITE_RUN_CASE (phashtable_full_test);
+	P_TEST_SUITE_RUN_CASE (phashtable_iter_test);
+	P_TEST_SUITE_RUN_CASE (phashtable_indexed_test);
+	P_TEST_SUITE_RUN_CASE (phashtable_bulk_test);
 }
 P_TEST_SUITE_END()
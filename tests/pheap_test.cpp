@@ -0,0 +1,385 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <stdlib.h>
+
+P_TEST_MODULE_INIT ();
+
+#define PHEAP_STRESS_COUNT	5000
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static pint compare_test_func (pconstpointer a, pconstpointer b)
+{
+	pint ia = P_POINTER_TO_INT (a);
+	pint ib = P_POINTER_TO_INT (b);
+
+	return ia < ib ? -1 : (ia > ib ? 1 : 0);
+}
+
+static pint compare_data_test_func (pconstpointer a, pconstpointer b, ppointer data)
+{
+	P_UNUSED (data);
+	return compare_test_func (a, b);
+}
+
+static pint compare_key_test_func (pconstpointer a, pconstpointer b, ppointer data)
+{
+	pint *keys = (pint *) data;
+	pint  ia   = keys[P_POINTER_TO_INT (a)];
+	pint  ib   = keys[P_POINTER_TO_INT (b)];
+
+	return ia < ib ? -1 : (ia > ib ? 1 : 0);
+}
+
+static pboolean check_pop_order (PHeap *heap, psize expected)
+{
+	pint	prev  = -1;
+	psize	count = 0;
+
+	while (p_heap_length (heap) > 0) {
+		pint val = P_POINTER_TO_INT (p_heap_peek (heap));
+
+		if (P_POINTER_TO_INT (p_heap_pop (heap)) != val || val < prev)
+			return FALSE;
+
+		prev = val;
+		++count;
+	}
+
+	return count == expected && p_heap_pop (heap) == NULL;
+}
+
+P_TEST_CASE_BEGIN (pheap_nomem_test)
+{
+	p_libsys_init ();
+
+	PHeap *heap = p_heap_new (compare_test_func);
+	P_TEST_REQUIRE (heap != NULL);
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	ppointer bulk[2] = {PINT_TO_POINTER (1), PINT_TO_POINTER (2)};
+
+	P_TEST_CHECK (p_heap_new (compare_test_func) == NULL);
+	P_TEST_CHECK (p_heap_new_full (compare_key_test_func, NULL, 4) == NULL);
+	P_TEST_CHECK (p_heap_push (heap, PINT_TO_POINTER (1), NULL) == FALSE);
+	P_TEST_CHECK (p_heap_push_bulk (heap, bulk, 2, NULL) == FALSE);
+	P_TEST_CHECK (p_heap_reserve (heap, 10) == FALSE);
+	P_TEST_CHECK (p_heap_length (heap) == 0);
+
+	p_mem_restore_vtable ();
+
+	p_heap_free (heap);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pheap_invalid_test)
+{
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_heap_new (NULL) == NULL);
+	P_TEST_CHECK (p_heap_new_full (NULL, NULL, 2) == NULL);
+	P_TEST_CHECK (p_heap_new_full (compare_key_test_func, NULL, 1) == NULL);
+	P_TEST_CHECK (p_heap_reserve (NULL, 10) == FALSE);
+	P_TEST_CHECK (p_heap_push (NULL, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_heap_push_bulk (NULL, NULL, 0, NULL) == FALSE);
+	P_TEST_CHECK (p_heap_peek (NULL) == NULL);
+	P_TEST_CHECK (p_heap_pop (NULL) == NULL);
+	P_TEST_CHECK (p_heap_update (NULL, 0) == FALSE);
+	P_TEST_CHECK (p_heap_remove (NULL, 0) == NULL);
+	P_TEST_CHECK (p_heap_get (NULL, 0) == NULL);
+	P_TEST_CHECK (p_heap_length (NULL) == 0);
+
+	p_heap_clear (NULL);
+	p_heap_free (NULL);
+
+	PHeap *heap = p_heap_new (compare_test_func);
+	P_TEST_REQUIRE (heap != NULL);
+
+	PHeapHandle handle;
+
+	P_TEST_CHECK (p_heap_push_bulk (heap, NULL, 10, NULL) == FALSE);
+	P_TEST_CHECK (p_heap_push_bulk (heap, NULL, 0, NULL) == TRUE);
+	P_TEST_CHECK (p_heap_peek (heap) == NULL);
+	P_TEST_CHECK (p_heap_pop (heap) == NULL);
+	P_TEST_CHECK (p_heap_update (heap, 0) == FALSE);
+	P_TEST_CHECK (p_heap_remove (heap, P_HEAP_INVALID_HANDLE) == NULL);
+
+	P_TEST_CHECK (p_heap_push (heap, PINT_TO_POINTER (10), &handle) == TRUE);
+	P_TEST_CHECK (p_heap_remove (heap, handle) == PINT_TO_POINTER (10));
+	P_TEST_CHECK (p_heap_remove (heap, handle) == NULL);
+	P_TEST_CHECK (p_heap_update (heap, handle) == FALSE);
+	P_TEST_CHECK (p_heap_get (heap, handle) == NULL);
+
+	p_heap_free (heap);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pheap_general_test)
+{
+	p_libsys_init ();
+
+	const psize arities[] = {0, 2, 3, 4, 8, 64};
+
+	for (psize a = 0; a < sizeof (arities) / sizeof (arities[0]); ++a) {
+		PHeap *heap = a == 0 ? p_heap_new (compare_test_func)
+				     : p_heap_new_full (compare_data_test_func, NULL, arities[a]);
+		P_TEST_REQUIRE (heap != NULL);
+
+		P_TEST_CHECK (p_heap_reserve (heap, 4) == TRUE);
+		P_TEST_CHECK (p_heap_reserve (heap, 2) == TRUE);
+
+		srand (100);
+
+		for (pint i = 0; i < PHEAP_STRESS_COUNT; ++i)
+			P_TEST_CHECK (p_heap_push (heap, PINT_TO_POINTER (rand () % 1000), NULL) == TRUE);
+
+		P_TEST_CHECK (p_heap_length (heap) == PHEAP_STRESS_COUNT);
+		P_TEST_CHECK (check_pop_order (heap, PHEAP_STRESS_COUNT) == TRUE);
+
+		p_heap_free (heap);
+	}
+
+	pint *keys = (pint *) p_malloc0 (PHEAP_STRESS_COUNT * sizeof (pint));
+	P_TEST_REQUIRE (keys != NULL);
+
+	for (psize a = 0; a < sizeof (arities) / sizeof (arities[0]); ++a) {
+		PHeap *heap = p_heap_new_full (compare_key_test_func, keys, arities[a]);
+		P_TEST_REQUIRE (heap != NULL);
+
+		srand (200);
+
+		for (pint i = 0; i < PHEAP_STRESS_COUNT; ++i) {
+			keys[i] = rand () % 1000;
+			P_TEST_CHECK (p_heap_push (heap, PINT_TO_POINTER (i), NULL) == TRUE);
+		}
+
+		/* Interleave pops and pushes */
+		pint prev = -1;
+
+		for (pint i = 0; i < PHEAP_STRESS_COUNT / 2; ++i) {
+			pint idx = P_POINTER_TO_INT (p_heap_pop (heap));
+
+			P_TEST_CHECK (keys[idx] >= prev);
+			prev = keys[idx];
+
+			/* Re-insert with a key not less than the current minimum */
+			keys[idx] = prev + rand () % 1000;
+			P_TEST_CHECK (p_heap_push (heap, PINT_TO_POINTER (idx), NULL) == TRUE);
+		}
+
+		P_TEST_CHECK (p_heap_length (heap) == PHEAP_STRESS_COUNT);
+
+		prev = -1;
+
+		while (p_heap_length (heap) > 0) {
+			pint idx = P_POINTER_TO_INT (p_heap_pop (heap));
+
+			P_TEST_CHECK (keys[idx] >= prev);
+			prev = keys[idx];
+		}
+
+		p_heap_free (heap);
+	}
+
+	p_free (keys);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pheap_handle_test)
+{
+	p_libsys_init ();
+
+	pint		*keys    = (pint *) p_malloc0 (PHEAP_STRESS_COUNT * sizeof (pint));
+	PHeapHandle	*handles = (PHeapHandle *) p_malloc0 (PHEAP_STRESS_COUNT * sizeof (PHeapHandle));
+	pboolean	*removed = (pboolean *) p_malloc0 (PHEAP_STRESS_COUNT * sizeof (pboolean));
+
+	P_TEST_REQUIRE (keys != NULL && handles != NULL && removed != NULL);
+
+	const psize arities[] = {2, 3, 4, 8};
+
+	for (psize a = 0; a < sizeof (arities) / sizeof (arities[0]); ++a) {
+		PHeap *heap = p_heap_new_full (compare_key_test_func, keys, arities[a]);
+		P_TEST_REQUIRE (heap != NULL);
+
+		srand (300);
+
+		for (pint i = 0; i < PHEAP_STRESS_COUNT; ++i) {
+			keys[i]    = rand () % 10000;
+			removed[i] = FALSE;
+
+			P_TEST_CHECK (p_heap_push (heap, PINT_TO_POINTER (i), &handles[i]) == TRUE);
+			P_TEST_CHECK (handles[i] != P_HEAP_INVALID_HANDLE);
+		}
+
+		/* Change keys in both directions */
+		for (pint i = 0; i < PHEAP_STRESS_COUNT; i += 3) {
+			keys[i] = (i % 2 == 0) ? keys[i] / 2 : keys[i] * 2;
+			P_TEST_CHECK (p_heap_update (heap, handles[i]) == TRUE);
+		}
+
+		/* Remove from the middle */
+		for (pint i = 1; i < PHEAP_STRESS_COUNT; i += 5) {
+			P_TEST_CHECK (p_heap_get (heap, handles[i]) == PINT_TO_POINTER (i));
+			P_TEST_CHECK (p_heap_remove (heap, handles[i]) == PINT_TO_POINTER (i));
+			P_TEST_CHECK (p_heap_get (heap, handles[i]) == NULL);
+			removed[i] = TRUE;
+		}
+
+		psize expected = 0;
+
+		for (pint i = 0; i < PHEAP_STRESS_COUNT; ++i) {
+			if (!removed[i]) {
+				P_TEST_CHECK (p_heap_get (heap, handles[i]) == PINT_TO_POINTER (i));
+				++expected;
+			}
+		}
+
+		P_TEST_CHECK (p_heap_length (heap) == expected);
+
+		/* Freed handles must be reused */
+		PHeapHandle reused;
+
+		P_TEST_CHECK (p_heap_push (heap, PINT_TO_POINTER (1), &reused) == TRUE);
+		P_TEST_CHECK (removed[1] == TRUE && p_heap_get (heap, reused) == PINT_TO_POINTER (1));
+		P_TEST_CHECK (reused < (PHeapHandle) PHEAP_STRESS_COUNT);
+		++expected;
+
+		pint prev = -1;
+
+		while (p_heap_length (heap) > 0) {
+			pint idx = P_POINTER_TO_INT (p_heap_pop (heap));
+
+			P_TEST_CHECK (keys[idx] >= prev);
+			prev = keys[idx];
+			--expected;
+		}
+
+		P_TEST_CHECK (expected == 0);
+
+		/* Handles are not valid anymore */
+		P_TEST_CHECK (p_heap_update (heap, handles[0]) == FALSE);
+
+		p_heap_clear (heap);
+		P_TEST_CHECK (p_heap_length (heap) == 0);
+
+		p_heap_free (heap);
+	}
+
+	p_free (removed);
+	p_free (handles);
+	p_free (keys);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pheap_bulk_test)
+{
+	p_libsys_init ();
+
+	ppointer	*data    = (ppointer *) p_malloc0 (PHEAP_STRESS_COUNT * sizeof (ppointer));
+	PHeapHandle	*handles = (PHeapHandle *) p_malloc0 (PHEAP_STRESS_COUNT * sizeof (PHeapHandle));
+
+	P_TEST_REQUIRE (data != NULL && handles != NULL);
+
+	const psize arities[] = {2, 4, 8};
+
+	for (psize a = 0; a < sizeof (arities) / sizeof (arities[0]); ++a) {
+		PHeap *heap = p_heap_new_full (compare_data_test_func, NULL, arities[a]);
+		P_TEST_REQUIRE (heap != NULL);
+
+		srand (400);
+
+		for (pint i = 0; i < PHEAP_STRESS_COUNT; ++i)
+			data[i] = PINT_TO_POINTER (rand () % 1000);
+
+		/* Heapify an empty heap */
+		P_TEST_CHECK (p_heap_push_bulk (heap, data, PHEAP_STRESS_COUNT, handles) == TRUE);
+		P_TEST_CHECK (p_heap_length (heap) == PHEAP_STRESS_COUNT);
+
+		for (pint i = 0; i < PHEAP_STRESS_COUNT; ++i)
+			P_TEST_CHECK (p_heap_get (heap, handles[i]) == data[i]);
+
+		/* Small bulk into a large heap is pushed one by one */
+		P_TEST_CHECK (p_heap_push_bulk (heap, data, 10, NULL) == TRUE);
+		P_TEST_CHECK (check_pop_order (heap, PHEAP_STRESS_COUNT + 10) == TRUE);
+
+		/* Large bulk into a small heap */
+		P_TEST_CHECK (p_heap_push (heap, PINT_TO_POINTER (500), NULL) == TRUE);
+		P_TEST_CHECK (p_heap_push_bulk (heap, data, PHEAP_STRESS_COUNT, NULL) == TRUE);
+		P_TEST_CHECK (check_pop_order (heap, PHEAP_STRESS_COUNT + 1) == TRUE);
+
+		p_heap_free (heap);
+	}
+
+	p_free (handles);
+	p_free (data);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pheap_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pheap_invalid_test);
+	P_TEST_SUITE_RUN_CASE (pheap_general_test);
+	P_TEST_SUITE_RUN_CASE (pheap_handle_test);
+	P_TEST_SUITE_RUN_CASE (pheap_bulk_test);
+}
+P_TEST_SUITE_END()
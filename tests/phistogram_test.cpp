@@ -0,0 +1,295 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+P_TEST_MODULE_INIT ();
+
+#define PHISTOGRAM_THREADS	4
+#define PHISTOGRAM_ROUNDS	100000
+
+static PHistogram *	global_histogram = NULL;
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static void * histogram_thread (void *)
+{
+	pint i;
+
+	for (i = 1; i <= PHISTOGRAM_ROUNDS; ++i)
+		p_histogram_record (global_histogram, (puint64) i);
+
+	p_uthread_exit (0);
+
+	return NULL;
+}
+
+/* Checks that a value is within the relative error of 3 significant digits */
+static pboolean
+histogram_is_close (puint64 value, puint64 expected)
+{
+	puint64 diff = value > expected ? value - expected : expected - value;
+
+	return diff * 1000 <= expected;
+}
+
+P_TEST_CASE_BEGIN (phistogram_nomem_test)
+{
+	p_libsys_init ();
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+	P_TEST_CHECK (p_histogram_new (1000, 3, FALSE) == NULL);
+
+	p_mem_restore_vtable ();
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (phistogram_bad_input_test)
+{
+	PHistogram *histogram;
+
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_histogram_new (1, 3, FALSE) == NULL);
+	P_TEST_CHECK (p_histogram_new (1000, 0, FALSE) == NULL);
+	P_TEST_CHECK (p_histogram_new (1000, 6, FALSE) == NULL);
+
+	histogram = p_histogram_new (1000, 3, FALSE);
+	P_TEST_REQUIRE (histogram != NULL);
+
+	p_histogram_record (NULL, 1);
+	p_histogram_record_count (NULL, 1, 1);
+	P_TEST_CHECK (p_histogram_merge (NULL, histogram) == FALSE);
+	P_TEST_CHECK (p_histogram_merge (histogram, NULL) == FALSE);
+	P_TEST_CHECK (p_histogram_merge (histogram, histogram) == FALSE);
+	P_TEST_CHECK (p_histogram_get_percentile (NULL, 50.0) == 0);
+	P_TEST_CHECK (p_histogram_get_count (NULL) == 0);
+	P_TEST_CHECK (p_histogram_get_min (NULL) == 0);
+	P_TEST_CHECK (p_histogram_get_max (NULL) == 0);
+	P_TEST_CHECK (p_histogram_get_mean (NULL) == 0.0);
+	p_histogram_reset (NULL);
+	p_histogram_free (NULL);
+
+	/* Empty histogram */
+	P_TEST_CHECK (p_histogram_get_percentile (histogram, 50.0) == 0);
+	P_TEST_CHECK (p_histogram_get_count (histogram) == 0);
+	P_TEST_CHECK (p_histogram_get_min (histogram) == 0);
+	P_TEST_CHECK (p_histogram_get_max (histogram) == 0);
+	P_TEST_CHECK (p_histogram_get_mean (histogram) == 0.0);
+
+	p_histogram_free (histogram);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (phistogram_general_test)
+{
+	PHistogram	*histogram;
+	double		mean;
+	puint64		i;
+
+	p_libsys_init ();
+
+	histogram = p_histogram_new (P_MAXUINT64, 3, FALSE);
+	P_TEST_REQUIRE (histogram != NULL);
+
+	for (i = 1; i <= 10000; ++i)
+		p_histogram_record (histogram, i);
+
+	P_TEST_CHECK (p_histogram_get_count (histogram) == 10000);
+	P_TEST_CHECK (p_histogram_get_min (histogram) == 1);
+	P_TEST_CHECK (p_histogram_get_max (histogram) == 10000);
+	P_TEST_CHECK (p_histogram_get_percentile (histogram, 0.0) == 1);
+	P_TEST_CHECK (p_histogram_get_percentile (histogram, 100.0) == 10000);
+	P_TEST_CHECK (histogram_is_close (p_histogram_get_percentile (histogram, 50.0), 5000));
+	P_TEST_CHECK (histogram_is_close (p_histogram_get_percentile (histogram, 90.0), 9000));
+	P_TEST_CHECK (histogram_is_close (p_histogram_get_percentile (histogram, 99.0), 9900));
+	P_TEST_CHECK (histogram_is_close (p_histogram_get_percentile (histogram, 99.9), 9990));
+
+	/* Small values are exact */
+	P_TEST_CHECK (p_histogram_get_percentile (histogram, 0.01) == 1);
+	P_TEST_CHECK (p_histogram_get_percentile (histogram, 10.0) == 1000);
+
+	mean = p_histogram_get_mean (histogram);
+	P_TEST_CHECK (mean > 4995.0 && mean < 5006.0);
+
+	/* Large values keep the precision */
+	p_histogram_reset (histogram);
+
+	P_TEST_CHECK (p_histogram_get_count (histogram) == 0);
+	P_TEST_CHECK (p_histogram_get_max (histogram) == 0);
+
+	p_histogram_record_count (histogram, 1000000000ULL, 99);
+	p_histogram_record (histogram, 3600000000000ULL);
+	p_histogram_record_count (histogram, 5, 0);
+
+	P_TEST_CHECK (p_histogram_get_count (histogram) == 100);
+	P_TEST_CHECK (p_histogram_get_min (histogram) == 1000000000ULL);
+	P_TEST_CHECK (p_histogram_get_max (histogram) == 3600000000000ULL);
+	P_TEST_CHECK (histogram_is_close (p_histogram_get_percentile (histogram, 50.0), 1000000000ULL));
+	P_TEST_CHECK (p_histogram_get_percentile (histogram, 50.0) >= 1000000000ULL);
+	P_TEST_CHECK (p_histogram_get_percentile (histogram, 99.5) == 3600000000000ULL);
+
+	p_histogram_free (histogram);
+
+	/* Values above the maximum are counted as the maximum */
+	histogram = p_histogram_new (1000, 2, FALSE);
+	P_TEST_REQUIRE (histogram != NULL);
+
+	p_histogram_record (histogram, 0);
+	p_histogram_record (histogram, 5000);
+
+	P_TEST_CHECK (p_histogram_get_count (histogram) == 2);
+	P_TEST_CHECK (p_histogram_get_min (histogram) == 0);
+	P_TEST_CHECK (p_histogram_get_max (histogram) == 1000);
+	P_TEST_CHECK (p_histogram_get_percentile (histogram, 50.0) == 0);
+	P_TEST_CHECK (p_histogram_get_percentile (histogram, 100.0) == 1000);
+
+	p_histogram_free (histogram);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (phistogram_merge_test)
+{
+	PHistogram	*first;
+	PHistogram	*second;
+	PHistogram	*coarse;
+	puint64		i;
+
+	p_libsys_init ();
+
+	first  = p_histogram_new (1000000, 3, FALSE);
+	second = p_histogram_new (1000000, 3, TRUE);
+	coarse = p_histogram_new (100000000, 2, FALSE);
+
+	P_TEST_REQUIRE (first != NULL);
+	P_TEST_REQUIRE (second != NULL);
+	P_TEST_REQUIRE (coarse != NULL);
+
+	for (i = 1; i <= 5000; ++i) {
+		p_histogram_record (first, i);
+		p_histogram_record (second, i + 5000);
+	}
+
+	/* Same layout */
+	P_TEST_CHECK (p_histogram_merge (first, second) == TRUE);
+	P_TEST_CHECK (p_histogram_get_count (first) == 10000);
+	P_TEST_CHECK (p_histogram_get_min (first) == 1);
+	P_TEST_CHECK (p_histogram_get_max (first) == 10000);
+	P_TEST_CHECK (histogram_is_close (p_histogram_get_percentile (first, 50.0), 5000));
+	P_TEST_CHECK (histogram_is_close (p_histogram_get_percentile (first, 99.0), 9900));
+	P_TEST_CHECK (p_histogram_get_count (second) == 5000);
+
+	/* Different layouts keep the precision of the coarser one */
+	P_TEST_CHECK (p_histogram_merge (coarse, first) == TRUE);
+	P_TEST_CHECK (p_histogram_get_count (coarse) == 10000);
+	P_TEST_CHECK (p_histogram_get_min (coarse) == 1);
+	P_TEST_CHECK (p_histogram_get_max (coarse) == 10000);
+	P_TEST_CHECK (p_histogram_get_percentile (coarse, 50.0) >= 4950);
+	P_TEST_CHECK (p_histogram_get_percentile (coarse, 50.0) <= 5050);
+
+	p_histogram_reset (coarse);
+	P_TEST_CHECK (p_histogram_merge (coarse, coarse) == FALSE);
+	P_TEST_CHECK (p_histogram_merge (first, coarse) == TRUE);
+	P_TEST_CHECK (p_histogram_get_count (first) == 10000);
+	P_TEST_CHECK (p_histogram_get_min (first) == 1);
+
+	p_histogram_free (first);
+	p_histogram_free (second);
+	p_histogram_free (coarse);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (phistogram_thread_test)
+{
+	PUThread	*thr[PHISTOGRAM_THREADS];
+	pint		i;
+
+	p_libsys_init ();
+
+	global_histogram = p_histogram_new (1000000, 3, TRUE);
+	P_TEST_REQUIRE (global_histogram != NULL);
+
+	for (i = 0; i < PHISTOGRAM_THREADS; ++i) {
+		thr[i] = p_uthread_create ((PUThreadFunc) histogram_thread, NULL, TRUE, NULL);
+		P_TEST_REQUIRE (thr[i] != NULL);
+	}
+
+	for (i = 0; i < PHISTOGRAM_THREADS; ++i) {
+		P_TEST_CHECK (p_uthread_join (thr[i]) == 0);
+		p_uthread_unref (thr[i]);
+	}
+
+	P_TEST_CHECK (p_histogram_get_count (global_histogram) == (puint64) PHISTOGRAM_THREADS * PHISTOGRAM_ROUNDS);
+	P_TEST_CHECK (p_histogram_get_min (global_histogram) == 1);
+	P_TEST_CHECK (p_histogram_get_max (global_histogram) == PHISTOGRAM_ROUNDS);
+	P_TEST_CHECK (histogram_is_close (p_histogram_get_percentile (global_histogram, 50.0),
+					  PHISTOGRAM_ROUNDS / 2));
+
+	p_histogram_free (global_histogram);
+	global_histogram = NULL;
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (phistogram_nomem_test);
+	P_TEST_SUITE_RUN_CASE (phistogram_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (phistogram_general_test);
+	P_TEST_SUITE_RUN_CASE (phistogram_merge_test);
+	P_TEST_SUITE_RUN_CASE (phistogram_thread_test);
+}
+P_TEST_SUITE_END()
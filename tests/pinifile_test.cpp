@@ -34,7 +34,6 @@
 P_TEST_MODULE_INIT ();
 
 #define PINIFILE_STRESS_LINE	2048
-#define PINIFILE_MAX_LINE	1024
 
 extern "C" ppointer pmem_alloc (psize nbytes)
 {
@@ -132,8 +131,11 @@ P_TEST_CASE_BEGIN (pinifile_nomem_test)
 	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
 
 	P_TEST_CHECK (p_ini_file_new ("." P_DIR_SEPARATOR "p_ini_test_file.ini") == NULL);
-	P_TEST_CHECK (p_ini_file_parse (ini, NULL) == TRUE);
+	P_TEST_CHECK (p_ini_file_parse (ini, NULL) == FALSE);
+	P_TEST_CHECK (p_ini_file_is_parsed (ini) == FALSE);
 	P_TEST_CHECK (p_ini_file_sections (ini) == NULL);
+	P_TEST_CHECK (p_ini_file_sections_array (ini) == NULL);
+	P_TEST_CHECK (p_ini_file_keys_array (ini, "numeric_section") == NULL);
 
 	p_mem_restore_vtable ();
 
@@ -170,11 +172,14 @@ P_TEST_CASE_BEGIN (pinifile_bad_input_test)
 	P_TEST_CHECK (p_ini_file_is_key_exists (ini, "string_section", "string_paramter_1") == FALSE);
 	P_TEST_CHECK (p_ini_file_sections (ini) == NULL);
 	P_TEST_CHECK (p_ini_file_keys (ini, "string_section") == NULL);
+	P_TEST_CHECK (p_ini_file_sections_array (ini) == NULL);
+	P_TEST_CHECK (p_ini_file_keys_array (ini, "string_section") == NULL);
 	P_TEST_CHECK (p_ini_file_parameter_boolean (ini, "boolean_section", "boolean_parameter_1", FALSE) == FALSE);
 	P_TEST_CHECK_CLOSE (p_ini_file_parameter_double (ini, "numeric_section", "float_parameter_1", 1.0), 1.0, 0.0001);
 	P_TEST_CHECK (p_ini_file_parameter_int (ini, "numeric_section", "int_parameter_1", 0) == 0);
 	P_TEST_CHECK (p_ini_file_parameter_list (ini, "list_section", "list_parameter_1") == NULL);
 	P_TEST_CHECK (p_ini_file_parameter_string (ini, "string_section", "string_parameter_1", NULL) == NULL);
+	P_TEST_CHECK (p_ini_file_parameter_string_view (ini, "string_section", "string_parameter_1", NULL) == NULL);
 
 	ini = p_ini_file_new ("./bad_file_path/fake.ini");
 	P_TEST_CHECK (ini != NULL);
@@ -205,16 +210,44 @@ P_TEST_CASE_BEGIN (pinifile_read_test)
 	P_TEST_CHECK (list != NULL);
 	P_TEST_CHECK (p_list_length (list) == 4);
 
+	/* Array variant gives the same names in the same order */
+	PArray *array = p_ini_file_sections_array (ini);
+	P_TEST_REQUIRE (array != NULL);
+	P_TEST_CHECK (p_array_length (array) == 4);
+
+	psize index = 0;
+
+	for (PList *iter = list; iter != NULL; iter = iter->next, ++index)
+		P_TEST_CHECK (strcmp ((const pchar *) iter->data, (const pchar *) p_array_index (array, index)) == 0);
+
+	p_array_foreach (array, (PFunc) p_free, NULL);
+	p_array_free (array);
+
 	p_list_foreach (list, (PFunc) p_free, NULL);
 	p_list_free (list);
 
 	/* Test empty section */
 	list = p_ini_file_keys (ini, "empty_section");
 	P_TEST_CHECK (list == NULL);
+	P_TEST_CHECK (p_ini_file_keys_array (ini, "empty_section") == NULL);
+	P_TEST_CHECK (p_ini_file_keys_array (ini, "no_such_section") == NULL);
 
 	/* Test numeric section */
 	list = p_ini_file_keys (ini, "numeric_section");
 	P_TEST_CHECK (p_list_length (list) == 5);
+
+	array = p_ini_file_keys_array (ini, "numeric_section");
+	P_TEST_REQUIRE (array != NULL);
+	P_TEST_CHECK (p_array_length (array) == 5);
+
+	index = 0;
+
+	for (PList *iter = list; iter != NULL; iter = iter->next, ++index)
+		P_TEST_CHECK (strcmp ((const pchar *) iter->data, (const pchar *) p_array_index (array, index)) == 0);
+
+	p_array_foreach (array, (PFunc) p_free, NULL);
+	p_array_free (array);
+
 	p_list_foreach (list, (PFunc) p_free, NULL);
 	p_list_free (list);
 
@@ -231,8 +264,9 @@ P_TEST_CASE_BEGIN (pinifile_read_test)
 	P_TEST_CHECK (p_ini_file_is_key_exists (ini, "numeric_section_false", "float_parameter_1") == FALSE);
 
 	/* Test string section */
+	/* The empty string_parameter_3 is dropped, the long key is kept */
 	list = p_ini_file_keys (ini, "string_section");
-	P_TEST_CHECK (p_list_length (list) == 8);
+	P_TEST_CHECK (p_list_length (list) == 9);
 	p_list_foreach (list, (PFunc) p_free, NULL);
 	p_list_free (list);
 
@@ -262,7 +296,7 @@ P_TEST_CASE_BEGIN (pinifile_read_test)
 
 	str = p_ini_file_parameter_string (ini, "string_section", "string_parameter_6", NULL);
 	P_TEST_REQUIRE (str != NULL);
-	P_TEST_CHECK (strlen (str) > 0 && strlen (str) < PINIFILE_MAX_LINE);
+	P_TEST_CHECK (strlen (str) == PINIFILE_STRESS_LINE);
 	p_free (str);
 
 	str = p_ini_file_parameter_string (ini, "string_section", "string_parameter_7", NULL);
@@ -280,6 +314,36 @@ P_TEST_CASE_BEGIN (pinifile_read_test)
 	P_TEST_CHECK (strcmp (str, "default_value") == 0);
 	p_free (str);
 
+	pchar *long_key = (pchar *) p_malloc0 (PINIFILE_STRESS_LINE + 1);
+	P_TEST_REQUIRE (long_key != NULL);
+
+	for (int i = 0; i < PINIFILE_STRESS_LINE; ++i)
+		long_key[i] = (pchar) (97 + i % 20);
+
+	P_TEST_CHECK (p_ini_file_is_key_exists (ini, "string_section", long_key) == TRUE);
+
+	str = p_ini_file_parameter_string (ini, "string_section", long_key, NULL);
+	P_TEST_REQUIRE (str != NULL);
+	P_TEST_CHECK (strcmp (str, "stress line") == 0);
+	p_free (str);
+	p_free (long_key);
+
+	/* Borrowed values */
+	const pchar *view = p_ini_file_parameter_string_view (ini, "string_section", "string_parameter_2", NULL);
+	P_TEST_REQUIRE (view != NULL);
+	P_TEST_CHECK (strcmp (view, "Test string with #'") == 0);
+	P_TEST_CHECK (view == p_ini_file_parameter_string_view (ini, "string_section", "string_parameter_2", NULL));
+
+	view = p_ini_file_parameter_string_view (ini, "string_section", "string_parameter_7", NULL);
+	P_TEST_REQUIRE (view != NULL);
+	P_TEST_CHECK (strcmp (view, "") == 0);
+
+	view = p_ini_file_parameter_string_view (ini, "string_section", "string_parameter_def", "default_value");
+	P_TEST_REQUIRE (view != NULL);
+	P_TEST_CHECK (strcmp (view, "default_value") == 0);
+	P_TEST_CHECK (p_ini_file_parameter_string_view (ini, "string_section_no", "string_parameter_1", NULL) == NULL);
+	P_TEST_CHECK (p_ini_file_parameter_string_view (NULL, "string_section", "string_parameter_1", NULL) == NULL);
+
 	/* Test boolean section */
 	list = p_ini_file_keys (ini, "boolean_section");
 	P_TEST_CHECK (p_list_length (list) == 4);
@@ -292,6 +356,18 @@ P_TEST_CASE_BEGIN (pinifile_read_test)
 	P_TEST_CHECK (p_ini_file_parameter_boolean (ini, "boolean_section", "boolean_parameter_4", FALSE) == TRUE);
 	P_TEST_CHECK (p_ini_file_parameter_boolean (ini, "boolean_section", "boolean_section_def", TRUE) == TRUE);
 
+	/* Cached conversions give the same results, a value can be read as any type */
+	for (int i = 0; i < 2; ++i) {
+		P_TEST_CHECK (p_ini_file_parameter_boolean (ini, "boolean_section", "boolean_parameter_1", FALSE) == TRUE);
+		P_TEST_CHECK (p_ini_file_parameter_boolean (ini, "boolean_section", "boolean_parameter_3", TRUE) == FALSE);
+		P_TEST_CHECK (p_ini_file_parameter_int (ini, "boolean_section", "boolean_parameter_4", -1) == 1);
+		P_TEST_CHECK (p_ini_file_parameter_int (ini, "numeric_section", "int_parameter_2", -1) == 5);
+		P_TEST_CHECK (p_ini_file_parameter_boolean (ini, "numeric_section", "int_parameter_2", FALSE) == TRUE);
+		P_TEST_CHECK_CLOSE (p_ini_file_parameter_double (ini, "numeric_section", "int_parameter_2", -1.0), 5.0, 0.0001);
+		P_TEST_CHECK_CLOSE (p_ini_file_parameter_double (ini, "numeric_section", "float_parameter_1", -1.0), 3.24, 0.0001);
+		P_TEST_CHECK (p_ini_file_parameter_int (ini, "numeric_section", "float_parameter_1", -1) == 3);
+	}
+
 	/* Test list section */
 	list = p_ini_file_keys (ini, "list_section");
 	P_TEST_CHECK (p_list_length (list) == 3);
@@ -348,10 +424,316 @@ P_TEST_CASE_BEGIN (pinifile_read_test)
 }
 P_TEST_CASE_END ()
 
+P_TEST_CASE_BEGIN (pinifile_syntax_test)
+{
+	p_libsys_init ();
+
+	FILE *file = fopen ("." P_DIR_SEPARATOR "p_ini_syntax_file.ini", "wb");
+	P_TEST_REQUIRE (file != NULL);
+
+	pchar *buf = (pchar *) p_malloc0 (PINIFILE_STRESS_LINE + 1);
+	P_TEST_REQUIRE (buf != NULL);
+
+	for (int i = 0; i < PINIFILE_STRESS_LINE; ++i)
+		buf[i] = (pchar) (97 + i % 20);
+
+	/* BOM, CRLF line endings and no line ending at the very end */
+	fprintf (file, "\xEF\xBB\xBForphan_key = 1\r\n");
+	fprintf (file, "[  first section  ]\r\n");
+	fprintf (file, "; commented_key = 2\r\n");
+	fprintf (file, "# commented_key = 3\r\n");
+	fprintf (file, "  spaced key  =   spaced value   \r\n");
+	fprintf (file, "quoted = \"  a ; b # c  \" ; Comment\r\n");
+	fprintf (file, "equals = a=b=c\r\n");
+	fprintf (file, "%s = %s\r\n", buf, buf);
+	fprintf (file, "[]\r\n");
+	fprintf (file, "after_empty_name = 4\r\n");
+	fprintf (file, "[second]\r\n");
+	fprintf (file, "value = 5\r\n");
+	fprintf (file, "[second]\r\n");
+	fprintf (file, "value = 6");
+
+	P_TEST_CHECK (fclose (file) == 0);
+
+	PIniFile *ini = p_ini_file_new ("." P_DIR_SEPARATOR "p_ini_syntax_file.ini");
+	P_TEST_REQUIRE (ini != NULL);
+	P_TEST_REQUIRE (p_ini_file_parse (ini, NULL) == TRUE);
+
+	PList *list = p_ini_file_sections (ini);
+	P_TEST_CHECK (p_list_length (list) == 3);
+	P_TEST_CHECK (list != NULL && strcmp ((const pchar *) list->data, "first section") == 0);
+	p_list_foreach (list, (PFunc) p_free, NULL);
+	p_list_free (list);
+
+	P_TEST_CHECK (p_ini_file_is_key_exists (ini, "first section", "orphan_key") == FALSE);
+	P_TEST_CHECK (p_ini_file_is_key_exists (ini, "first section", "commented_key") == FALSE);
+	P_TEST_CHECK (p_ini_file_is_key_exists (ini, "first section", "; commented_key") == FALSE);
+	P_TEST_CHECK (p_ini_file_parameter_int (ini, "first section", "after_empty_name", -1) == 4);
+
+	pchar *str = p_ini_file_parameter_string (ini, "first section", "spaced key", NULL);
+	P_TEST_CHECK (str != NULL && strcmp (str, "spaced value") == 0);
+	p_free (str);
+
+	str = p_ini_file_parameter_string (ini, "first section", "quoted", NULL);
+	P_TEST_CHECK (str != NULL && strcmp (str, "a ; b # c") == 0);
+	p_free (str);
+
+	str = p_ini_file_parameter_string (ini, "first section", "equals", NULL);
+	P_TEST_CHECK (str != NULL && strcmp (str, "a=b=c") == 0);
+	p_free (str);
+
+	/* Lines are not limited in length */
+	str = p_ini_file_parameter_string (ini, "first section", buf, NULL);
+	P_TEST_CHECK (str != NULL && strcmp (str, buf) == 0);
+	p_free (str);
+
+	/* Last one of the repeated sections wins */
+	P_TEST_CHECK (p_ini_file_parameter_int (ini, "second", "value", -1) == 6);
+
+	/* Case sensitive by default, the option can't be changed after parsing */
+	P_TEST_CHECK (p_ini_file_is_key_exists (ini, "Second", "value") == FALSE);
+	P_TEST_CHECK (p_ini_file_is_key_exists (ini, "second", "VALUE") == FALSE);
+	P_TEST_CHECK (p_ini_file_set_case_sensitive (ini, FALSE) == FALSE);
+	P_TEST_CHECK (p_ini_file_set_case_sensitive (NULL, FALSE) == FALSE);
+
+	p_ini_file_free (ini);
+
+	ini = p_ini_file_new ("." P_DIR_SEPARATOR "p_ini_syntax_file.ini");
+	P_TEST_REQUIRE (ini != NULL);
+	P_TEST_CHECK (p_ini_file_set_case_sensitive (ini, FALSE) == TRUE);
+	P_TEST_REQUIRE (p_ini_file_parse (ini, NULL) == TRUE);
+
+	P_TEST_CHECK (p_ini_file_parameter_int (ini, "SECOND", "Value", -1) == 6);
+	P_TEST_CHECK (p_ini_file_parameter_int (ini, "First Section", "AFTER_EMPTY_NAME", -1) == 4);
+	P_TEST_CHECK (p_ini_file_is_key_exists (ini, "first section", "Spaced Key") == TRUE);
+	P_TEST_CHECK (p_ini_file_is_key_exists (ini, "first section", "spaced keys") == FALSE);
+
+	/* Original case is kept in the names */
+	list = p_ini_file_keys (ini, "FIRST SECTION");
+	P_TEST_CHECK (p_list_length (list) == 5);
+	P_TEST_CHECK (list != NULL && strcmp ((const pchar *) list->data, "spaced key") == 0);
+	p_list_foreach (list, (PFunc) p_free, NULL);
+	p_list_free (list);
+
+	p_ini_file_free (ini);
+	p_free (buf);
+
+	P_TEST_CHECK (p_file_remove ("." P_DIR_SEPARATOR "p_ini_syntax_file.ini", NULL) == TRUE);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+static bool
+write_temp_ini_file (const pchar *contents)
+{
+	FILE *file = fopen ("." P_DIR_SEPARATOR "p_ini_reload_file.ini", "wb");
+
+	if (file == NULL)
+		return false;
+
+	bool result = fputs (contents, file) >= 0;
+
+	return fclose (file) == 0 && result;
+}
+
+static bool
+check_change (PList *item, PIniFileChangeType type, const pchar *section, const pchar *key)
+{
+	if (item == NULL)
+		return false;
+
+	PIniFileChange *change = (PIniFileChange *) item->data;
+
+	if (change->type != type || strcmp (change->section, section) != 0)
+		return false;
+
+	return key == NULL ? change->key == NULL : (change->key != NULL && strcmp (change->key, key) == 0);
+}
+
+P_TEST_CASE_BEGIN (pinifile_reload_test)
+{
+	PList *changes;
+
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_ini_file_reload (NULL, &changes, NULL) == FALSE);
+	p_ini_file_change_free (NULL);
+
+	P_TEST_REQUIRE (write_temp_ini_file ("[first]\na = 1\nb = 2\n[second]\nx = 1\n"));
+
+	PIniFile *ini = p_ini_file_new ("." P_DIR_SEPARATOR "p_ini_reload_file.ini");
+	P_TEST_REQUIRE (ini != NULL);
+
+	/* Not parsed yet: everything is new */
+	P_TEST_REQUIRE (p_ini_file_reload (ini, &changes, NULL) == TRUE);
+	P_TEST_CHECK (p_ini_file_is_parsed (ini) == TRUE);
+	P_TEST_CHECK (p_list_length (changes) == 2);
+	P_TEST_CHECK (check_change (changes, P_INI_FILE_CHANGE_ADDED, "first", NULL));
+	P_TEST_CHECK (changes != NULL && check_change (changes->next, P_INI_FILE_CHANGE_ADDED, "second", NULL));
+	p_list_foreach (changes, (PFunc) p_ini_file_change_free, NULL);
+	p_list_free (changes);
+
+	/* Nothing was changed */
+	P_TEST_CHECK (p_ini_file_reload (ini, &changes, NULL) == TRUE);
+	P_TEST_CHECK (changes == NULL);
+	P_TEST_CHECK (p_ini_file_reload (ini, NULL, NULL) == TRUE);
+
+	/* Same size and content written again */
+	P_TEST_REQUIRE (write_temp_ini_file ("[first]\na = 1\nb = 2\n[second]\nx = 1\n"));
+	P_TEST_CHECK (p_ini_file_reload (ini, &changes, NULL) == TRUE);
+	P_TEST_CHECK (changes == NULL);
+
+	/* Same size, but another content */
+	P_TEST_REQUIRE (write_temp_ini_file ("[first]\na = 1\nb = 3\n[second]\nx = 1\n"));
+	P_TEST_CHECK (p_ini_file_reload (ini, &changes, NULL) == TRUE);
+	P_TEST_CHECK (p_list_length (changes) == 1);
+	P_TEST_CHECK (check_change (changes, P_INI_FILE_CHANGE_MODIFIED, "first", "b"));
+	P_TEST_CHECK (p_ini_file_parameter_int (ini, "first", "b", -1) == 3);
+	p_list_foreach (changes, (PFunc) p_ini_file_change_free, NULL);
+	p_list_free (changes);
+
+	P_TEST_REQUIRE (write_temp_ini_file ("[first]\nb = 4\nc = 5\n[third]\ny = 1\n"));
+	P_TEST_CHECK (p_ini_file_reload (ini, &changes, NULL) == TRUE);
+	P_TEST_CHECK (p_list_length (changes) == 5);
+
+	PList *item = changes;
+
+	P_TEST_CHECK (check_change (item, P_INI_FILE_CHANGE_MODIFIED, "first", "b"));
+	item = item != NULL ? item->next : NULL;
+	P_TEST_CHECK (check_change (item, P_INI_FILE_CHANGE_ADDED, "first", "c"));
+	item = item != NULL ? item->next : NULL;
+	P_TEST_CHECK (check_change (item, P_INI_FILE_CHANGE_REMOVED, "first", "a"));
+	item = item != NULL ? item->next : NULL;
+	P_TEST_CHECK (check_change (item, P_INI_FILE_CHANGE_ADDED, "third", NULL));
+	item = item != NULL ? item->next : NULL;
+	P_TEST_CHECK (check_change (item, P_INI_FILE_CHANGE_REMOVED, "second", NULL));
+
+	p_list_foreach (changes, (PFunc) p_ini_file_change_free, NULL);
+	p_list_free (changes);
+
+	P_TEST_CHECK (p_ini_file_parameter_int (ini, "first", "c", -1) == 5);
+	P_TEST_CHECK (p_ini_file_parameter_int (ini, "third", "y", -1) == 1);
+	P_TEST_CHECK (p_ini_file_is_key_exists (ini, "first", "a") == FALSE);
+	P_TEST_CHECK (p_ini_file_is_key_exists (ini, "second", "x") == FALSE);
+
+	/* Failed reload keeps the previous content */
+	P_TEST_CHECK (p_file_remove ("." P_DIR_SEPARATOR "p_ini_reload_file.ini", NULL) == TRUE);
+	P_TEST_CHECK (p_ini_file_reload (ini, &changes, NULL) == FALSE);
+	P_TEST_CHECK (changes == NULL);
+	P_TEST_CHECK (p_ini_file_parameter_int (ini, "first", "c", -1) == 5);
+
+	p_ini_file_free (ini);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+static pboolean
+collect_parameter (const pchar *key, const pchar *value, ppointer user_data)
+{
+	PList **list = (PList **) user_data;
+
+	*list = p_list_append (*list, p_strdup (key));
+	*list = p_list_append (*list, p_strdup (value));
+
+	return strcmp (key, "stop") == 0;
+}
+
+P_TEST_CASE_BEGIN (pinifile_batch_test)
+{
+	PList		*items = NULL;
+	const pchar	*str_val = "default";
+	pint		int_val = -1;
+	double		double_val = -1.0;
+	pboolean	bool_val = FALSE;
+	pint		missing_val = 42;
+
+	p_libsys_init ();
+
+	P_TEST_REQUIRE (write_temp_ini_file ("[batch]\nname = value\nnum = 10\nratio = 0.5\n"
+					     "flag = true\nnum = 15\nstop = 1\nafter = 2\n"
+					     "[empty]\n x = 1\n"));
+
+	PIniFile *ini = p_ini_file_new ("." P_DIR_SEPARATOR "p_ini_reload_file.ini");
+	P_TEST_REQUIRE (ini != NULL);
+
+	/* Not parsed yet */
+	P_TEST_CHECK (p_ini_file_section_foreach (ini, "batch", collect_parameter, &items) == FALSE);
+	P_TEST_REQUIRE (p_ini_file_parse (ini, NULL) == TRUE);
+
+	P_TEST_CHECK (p_ini_file_section_foreach (NULL, "batch", collect_parameter, &items) == FALSE);
+	P_TEST_CHECK (p_ini_file_section_foreach (ini, NULL, collect_parameter, &items) == FALSE);
+	P_TEST_CHECK (p_ini_file_section_foreach (ini, "batch", NULL, &items) == FALSE);
+	P_TEST_CHECK (p_ini_file_section_foreach (ini, "no_section", collect_parameter, &items) == FALSE);
+	P_TEST_CHECK (items == NULL);
+
+	/* Visited in the file order, including duplicates, until stopped */
+	P_TEST_CHECK (p_ini_file_section_foreach (ini, "batch", collect_parameter, &items) == TRUE);
+	P_TEST_REQUIRE (p_list_length (items) == 12);
+
+	const pchar *expected[] = {"name", "value", "num", "10", "ratio", "0.5",
+				   "flag", "true", "num", "15", "stop", "1"};
+	pint idx = 0;
+
+	for (PList *iter = items; iter != NULL; iter = iter->next, ++idx)
+		P_TEST_CHECK (strcmp ((const pchar *) iter->data, expected[idx]) == 0);
+
+	p_list_foreach (items, (PFunc) p_free, NULL);
+	p_list_free (items);
+
+	PIniFileQuery queries[] = {
+		{"name",	P_INI_FILE_VALUE_STRING,	&str_val,	FALSE},
+		{"num",		P_INI_FILE_VALUE_INT,		&int_val,	FALSE},
+		{"ratio",	P_INI_FILE_VALUE_DOUBLE,	&double_val,	FALSE},
+		{"flag",	P_INI_FILE_VALUE_BOOLEAN,	&bool_val,	TRUE},
+		{"missing",	P_INI_FILE_VALUE_INT,		&missing_val,	TRUE},
+		{"after",	P_INI_FILE_VALUE_INT,		NULL,		FALSE},
+		{NULL,		P_INI_FILE_VALUE_INT,		&missing_val,	TRUE}
+	};
+
+	P_TEST_CHECK (p_ini_file_get_many (NULL, "batch", queries, 7) == 0);
+	P_TEST_CHECK (p_ini_file_get_many (ini, "batch", NULL, 7) == 0);
+	P_TEST_CHECK (p_ini_file_get_many (ini, "batch", queries, 0) == 0);
+
+	P_TEST_CHECK (p_ini_file_get_many (ini, "batch", queries, 7) == 5);
+	P_TEST_CHECK (strcmp (str_val, "value") == 0);
+	P_TEST_CHECK (int_val == 15);
+	P_TEST_CHECK (double_val == 0.5);
+	P_TEST_CHECK (bool_val == TRUE);
+	P_TEST_CHECK (missing_val == 42);
+
+	for (pint i = 0; i < 4; ++i)
+		P_TEST_CHECK (queries[i].found == TRUE);
+
+	P_TEST_CHECK (queries[4].found == FALSE);
+	P_TEST_CHECK (queries[5].found == TRUE);
+	P_TEST_CHECK (queries[6].found == FALSE);
+
+	/* The same values as with the single getters */
+	P_TEST_CHECK (p_ini_file_parameter_int (ini, "batch", "num", 0) == 15);
+
+	P_TEST_CHECK (p_ini_file_get_many (ini, "no_section", queries, 7) == 0);
+
+	for (pint i = 0; i < 7; ++i)
+		P_TEST_CHECK (queries[i].found == FALSE);
+
+	P_TEST_CHECK (missing_val == 42);
+
+	p_ini_file_free (ini);
+	p_file_remove ("." P_DIR_SEPARATOR "p_ini_reload_file.ini", NULL);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
 P_TEST_SUITE_BEGIN()
 {
 	P_TEST_SUITE_RUN_CASE (pinifile_nomem_test);
 	P_TEST_SUITE_RUN_CASE (pinifile_bad_input_test);
 	P_TEST_SUITE_RUN_CASE (pinifile_read_test);
+	P_TEST_SUITE_RUN_CASE (pinifile_syntax_test);
+	P_TEST_SUITE_RUN_CASE (pinifile_reload_test);
+	P_TEST_SUITE_RUN_CASE (pinifile_batch_test);
 }
 P_TEST_SUITE_END()
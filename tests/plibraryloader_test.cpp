@@ -168,12 +168,68 @@ P_TEST_CASE_BEGIN (plibraryloader_general_test)
 }
 P_TEST_CASE_END ()
 
+P_TEST_CASE_BEGIN (plibraryloader_symbols_test)
+{
+	PLibraryLoader	*loader;
+	PFuncAddr	addrs[4];
+	PFuncAddr	init_func;
+	const pchar	*syms[4] = {
+		"p_libsys_init",
+		"there_is_no_such_a_symbol",
+		"p_libsys_version",
+		NULL
+	};
+
+	p_libsys_init ();
+
+	P_TEST_REQUIRE (g_argc > 1);
+
+	P_TEST_CHECK (p_library_loader_new_with_flags (NULL, P_LIBRARY_LOADER_FLAG_LAZY) == NULL);
+	P_TEST_CHECK (p_library_loader_get_symbols (NULL, syms, addrs, 4) == -1);
+
+	if (P_UNLIKELY (p_library_loader_is_ref_counted () == FALSE)) {
+		p_libsys_shutdown ();
+		P_TEST_CASE_RETURN ();
+	}
+
+	loader = p_library_loader_new_with_flags (g_argv[g_argc - 1],
+						  P_LIBRARY_LOADER_FLAG_LAZY |
+						  P_LIBRARY_LOADER_FLAG_GLOBAL);
+	P_TEST_REQUIRE (loader != NULL);
+
+	P_TEST_CHECK (p_library_loader_get_symbols (loader, NULL, addrs, 4) == -1);
+	P_TEST_CHECK (p_library_loader_get_symbols (loader, syms, NULL, 4) == -1);
+	P_TEST_CHECK (p_library_loader_get_symbols (loader, syms, addrs, 0) == 0);
+
+	init_func = p_library_loader_get_symbol (loader, "p_libsys_init");
+
+	/* Some compilers decorate the exported names */
+	if (init_func != NULL) {
+		P_TEST_CHECK (p_library_loader_get_symbols (loader, syms, addrs, 4) == 2);
+		P_TEST_CHECK (addrs[0] == init_func);
+		P_TEST_CHECK (addrs[1] == NULL);
+		P_TEST_CHECK (addrs[2] != NULL);
+		P_TEST_CHECK (addrs[3] == NULL);
+
+		/* Served from the cache */
+		P_TEST_CHECK (p_library_loader_get_symbol (loader, "p_libsys_init") == init_func);
+		P_TEST_CHECK (p_library_loader_get_symbol (loader, "p_libsys_version") == addrs[2]);
+		P_TEST_CHECK (p_library_loader_get_symbol (loader, "there_is_no_such_a_symbol") == NULL);
+	}
+
+	p_library_loader_free (loader);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
 P_TEST_SUITE_ARGS_BEGIN()
 {
 	g_argc = argc;
 	g_argv = argv;
 
 	P_TEST_SUITE_RUN_CASE (plibraryloader_nomem_test);
+	P_TEST_SUITE_RUN_CASE (plibraryloader_symbols_test);
 	P_TEST_SUITE_RUN_CASE (plibraryloader_general_test);
 }
 P_TEST_SUITE_END()
@@ -82,6 +82,22 @@ P_TEST_CASE_BEGIN (plist_nomem_test)
 	P_TEST_CHECK (p_list_append (NULL, PINT_TO_POINTER (10)) == NULL);
 	P_TEST_CHECK (p_list_prepend (NULL, PINT_TO_POINTER (10)) == NULL);
 
+	PListHead head;
+
+	p_list_head_init (&head);
+	P_TEST_CHECK (p_list_head_append (&head, PINT_TO_POINTER (10)) == FALSE);
+	P_TEST_CHECK (p_list_head_prepend (&head, PINT_TO_POINTER (10)) == FALSE);
+	P_TEST_CHECK (p_list_head_length (&head) == 0);
+	P_TEST_CHECK (head.first == NULL && head.last == NULL);
+
+	PListUnrolled unrolled;
+
+	p_list_unrolled_init (&unrolled);
+	P_TEST_CHECK (p_list_unrolled_append (&unrolled, PINT_TO_POINTER (10)) == FALSE);
+	P_TEST_CHECK (p_list_unrolled_prepend (&unrolled, PINT_TO_POINTER (10)) == FALSE);
+	P_TEST_CHECK (p_list_unrolled_length (&unrolled) == 0);
+	P_TEST_CHECK (unrolled.first == NULL && unrolled.last == NULL);
+
 	p_mem_restore_vtable ();
 
 	p_libsys_shutdown ();
@@ -100,6 +116,36 @@ P_TEST_CASE_BEGIN (plist_invalid_test)
 	p_list_free (NULL);
 	p_list_foreach (NULL, NULL, NULL);
 
+	PListHead head;
+
+	p_list_head_init (NULL);
+	p_list_head_init (&head);
+	P_TEST_CHECK (p_list_head_append (NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_list_head_prepend (NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_list_head_pop (NULL) == NULL);
+	P_TEST_CHECK (p_list_head_pop (&head) == NULL);
+	P_TEST_CHECK (p_list_head_length (NULL) == 0);
+	P_TEST_CHECK (p_list_head_steal (NULL) == NULL);
+	P_TEST_CHECK (p_list_head_steal (&head) == NULL);
+	p_list_head_clear (NULL);
+	p_list_head_clear (&head);
+
+	PListUnrolled unrolled;
+
+	p_list_unrolled_init (NULL);
+	p_list_unrolled_init (&unrolled);
+	P_TEST_CHECK (p_list_unrolled_append (NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_list_unrolled_prepend (NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_list_unrolled_remove (NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_list_unrolled_remove (&unrolled, NULL) == FALSE);
+	P_TEST_CHECK (p_list_unrolled_pop (NULL) == NULL);
+	P_TEST_CHECK (p_list_unrolled_pop (&unrolled) == NULL);
+	P_TEST_CHECK (p_list_unrolled_length (NULL) == 0);
+	p_list_unrolled_foreach (NULL, NULL, NULL);
+	p_list_unrolled_foreach (&unrolled, NULL, NULL);
+	p_list_unrolled_clear (NULL);
+	p_list_unrolled_clear (&unrolled);
+
 	p_libsys_shutdown ();
 }
 P_TEST_CASE_END ()
@@ -191,10 +237,314 @@ P_TEST_CASE_BEGIN (plist_general_test)
 }
 P_TEST_CASE_END ()
 
+P_TEST_CASE_BEGIN (plist_head_test)
+{
+	p_libsys_init ();
+
+	PListHead head;
+
+	p_list_head_init (&head);
+	P_TEST_CHECK (p_list_head_length (&head) == 0);
+
+	for (pint i = 1; i <= 100; ++i)
+		P_TEST_CHECK (p_list_head_append (&head, PINT_TO_POINTER (i)) == TRUE);
+
+	P_TEST_CHECK (p_list_head_prepend (&head, PINT_TO_POINTER (0)) == TRUE);
+	P_TEST_CHECK (p_list_head_length (&head) == 101);
+	P_TEST_CHECK (p_list_length (head.first) == 101);
+	P_TEST_CHECK (head.last == p_list_last (head.first));
+	P_TEST_CHECK (P_POINTER_TO_INT (head.last->data) == 100);
+
+	/* Popping keeps the order and the tail */
+	P_TEST_CHECK (P_POINTER_TO_INT (p_list_head_pop (&head)) == 0);
+	P_TEST_CHECK (P_POINTER_TO_INT (p_list_head_pop (&head)) == 1);
+	P_TEST_CHECK (p_list_head_length (&head) == 99);
+
+	PList *list = p_list_head_steal (&head);
+
+	P_TEST_CHECK (p_list_head_length (&head) == 0);
+	P_TEST_CHECK (head.first == NULL && head.last == NULL);
+
+	pint i = 2;
+
+	for (PList *iter = list; iter != NULL; iter = iter->next, ++i)
+		P_TEST_CHECK (P_POINTER_TO_INT (iter->data) == i);
+
+	P_TEST_CHECK (i == 101);
+	p_list_free (list);
+
+	/* Pop the last node, then use the head again */
+	P_TEST_CHECK (p_list_head_prepend (&head, PINT_TO_POINTER (1)) == TRUE);
+	P_TEST_CHECK (head.first == head.last);
+	P_TEST_CHECK (P_POINTER_TO_INT (p_list_head_pop (&head)) == 1);
+	P_TEST_CHECK (head.first == NULL && head.last == NULL);
+
+	P_TEST_CHECK (p_list_head_append (&head, PINT_TO_POINTER (2)) == TRUE);
+	P_TEST_CHECK (p_list_head_append (&head, PINT_TO_POINTER (3)) == TRUE);
+	P_TEST_CHECK (P_POINTER_TO_INT (head.first->data) == 2);
+	P_TEST_CHECK (P_POINTER_TO_INT (head.last->data) == 3);
+
+	p_list_head_clear (&head);
+	P_TEST_CHECK (p_list_head_length (&head) == 0);
+	P_TEST_CHECK (head.first == NULL && head.last == NULL);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+#define PLIST_UNROLLED_MAX	1000
+
+typedef struct _TestUnrolledState {
+	pint	*expected;
+	pint	index;
+	pint	errors;
+} TestUnrolledState;
+
+static void unrolled_check_func (ppointer data, ppointer user_data)
+{
+	TestUnrolledState *state = (TestUnrolledState *) user_data;
+
+	if (state->expected[state->index++] != P_POINTER_TO_INT (data))
+		++state->errors;
+}
+
+static pboolean unrolled_check (const PListUnrolled *list, pint *expected, pint count)
+{
+	TestUnrolledState state;
+
+	state.expected = expected;
+	state.index    = 0;
+	state.errors   = 0;
+
+	if (p_list_unrolled_length (list) != (psize) count)
+		return FALSE;
+
+	p_list_unrolled_foreach (list, (PFunc) unrolled_check_func, &state);
+
+	return state.index == count && state.errors == 0;
+}
+
+P_TEST_CASE_BEGIN (plist_unrolled_test)
+{
+	p_libsys_init ();
+
+	PListUnrolled	list;
+	pint		expected[PLIST_UNROLLED_MAX];
+	pint		count;
+	pint		value;
+	pint		pos;
+	puint32		seed;
+
+	p_list_unrolled_init (&list);
+	P_TEST_CHECK (unrolled_check (&list, expected, 0) == TRUE);
+
+	/* 29 27 ... 3 1 0 2 4 ... 28 spans several chunks both ways */
+	for (pint i = 0; i < 30; ++i) {
+		if (i % 2 == 0)
+			P_TEST_CHECK (p_list_unrolled_append (&list, PINT_TO_POINTER (i)) == TRUE);
+		else
+			P_TEST_CHECK (p_list_unrolled_prepend (&list, PINT_TO_POINTER (i)) == TRUE);
+	}
+
+	for (pint i = 0; i < 15; ++i) {
+		expected[i]      = 29 - i * 2;
+		expected[15 + i] = i * 2;
+	}
+
+	P_TEST_CHECK (unrolled_check (&list, expected, 30) == TRUE);
+
+	P_TEST_CHECK (P_POINTER_TO_INT (p_list_unrolled_pop (&list)) == 29);
+	P_TEST_CHECK (p_list_unrolled_remove (&list, PINT_TO_POINTER (28)) == TRUE);
+	P_TEST_CHECK (p_list_unrolled_remove (&list, PINT_TO_POINTER (0)) == TRUE);
+	P_TEST_CHECK (p_list_unrolled_remove (&list, PINT_TO_POINTER (0)) == FALSE);
+	P_TEST_CHECK (p_list_unrolled_remove (&list, PINT_TO_POINTER (100)) == FALSE);
+
+	memmove (expected + 15, expected + 16, 13 * sizeof (pint));
+	P_TEST_CHECK (unrolled_check (&list, expected + 1, 27) == TRUE);
+
+	/* Only the first duplicate is removed */
+	P_TEST_CHECK (p_list_unrolled_append (&list, PINT_TO_POINTER (1)) == TRUE);
+	P_TEST_CHECK (p_list_unrolled_remove (&list, PINT_TO_POINTER (1)) == TRUE);
+	P_TEST_CHECK (p_list_unrolled_remove (&list, PINT_TO_POINTER (1)) == TRUE);
+	P_TEST_CHECK (p_list_unrolled_remove (&list, PINT_TO_POINTER (1)) == FALSE);
+
+	p_list_unrolled_clear (&list);
+	P_TEST_CHECK (p_list_unrolled_length (&list) == 0);
+	P_TEST_CHECK (list.first == NULL && list.last == NULL);
+
+	/* Random operations against a plain array */
+	count = 0;
+	seed  = 1;
+
+	for (pint i = 0; i < 20000; ++i) {
+		seed  = seed * 1103515245U + 12345U;
+		value = (pint) ((seed >> 8) % 500);
+
+		switch ((seed >> 24) % 4) {
+		case 0:
+			if (count == PLIST_UNROLLED_MAX)
+				break;
+
+			P_TEST_CHECK (p_list_unrolled_append (&list, PINT_TO_POINTER (value)) == TRUE);
+			expected[count++] = value;
+			break;
+		case 1:
+			if (count == PLIST_UNROLLED_MAX)
+				break;
+
+			P_TEST_CHECK (p_list_unrolled_prepend (&list, PINT_TO_POINTER (value)) == TRUE);
+			memmove (expected + 1, expected, (psize) count * sizeof (pint));
+			expected[0] = value;
+			++count;
+			break;
+		case 2:
+			for (pos = 0; pos < count && expected[pos] != value; ++pos)
+				;
+
+			P_TEST_CHECK (p_list_unrolled_remove (&list, PINT_TO_POINTER (value)) == (pos < count));
+
+			if (pos < count) {
+				memmove (expected + pos, expected + pos + 1, (psize) (count - pos - 1) * sizeof (pint));
+				--count;
+			}
+			break;
+		default:
+			if (count == 0) {
+				P_TEST_CHECK (p_list_unrolled_pop (&list) == NULL);
+				break;
+			}
+
+			P_TEST_CHECK (P_POINTER_TO_INT (p_list_unrolled_pop (&list)) == expected[0]);
+			memmove (expected, expected + 1, (psize) (count - 1) * sizeof (pint));
+			--count;
+			break;
+		}
+
+		if (i % 100 == 0)
+			P_TEST_CHECK (unrolled_check (&list, expected, count) == TRUE);
+	}
+
+	P_TEST_CHECK (unrolled_check (&list, expected, count) == TRUE);
+
+	while (count > 0)
+		P_TEST_CHECK (p_list_unrolled_remove (&list, PINT_TO_POINTER (expected[--count])) == TRUE);
+
+	P_TEST_CHECK (list.first == NULL && list.last == NULL);
+
+	p_list_unrolled_clear (&list);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+typedef struct _TestLinkItem {
+	pint		id;
+	PListLink	link;
+} TestLinkItem;
+
+P_TEST_CASE_BEGIN (plist_link_test)
+{
+	p_libsys_init ();
+
+	TestLinkItem	items[10];
+	PListLink	head;
+	PListLink	*link;
+	pint		expected;
+
+	p_list_link_init (NULL);
+	p_list_link_append (NULL, NULL);
+	p_list_link_prepend (NULL, NULL);
+	p_list_link_remove (NULL);
+
+	P_TEST_CHECK (p_list_link_is_empty (NULL) == TRUE);
+	P_TEST_CHECK (p_list_link_length (NULL) == 0);
+
+	p_list_link_init (&head);
+
+	P_TEST_CHECK (p_list_link_is_empty (&head) == TRUE);
+	P_TEST_CHECK (p_list_link_length (&head) == 0);
+
+	/* Linking never allocates memory */
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	for (pint i = 0; i < 10; ++i) {
+		items[i].id = i;
+
+		if (i % 2 == 0)
+			p_list_link_append (&head, &items[i].link);
+		else
+			p_list_link_prepend (&head, &items[i].link);
+	}
+
+	p_mem_restore_vtable ();
+
+	P_TEST_CHECK (p_list_link_is_empty (&head) == FALSE);
+	P_TEST_CHECK (p_list_link_length (&head) == 10);
+
+	/* 9 7 5 3 1 0 2 4 6 8 */
+	expected = 9;
+
+	for (link = head.next; link != &head; link = link->next) {
+		P_TEST_CHECK (P_CONTAINER_OF (link, TestLinkItem, link)->id == expected);
+		expected = expected == 1 ? 0 : (expected % 2 == 1 ? expected - 2 : expected + 2);
+	}
+
+	P_TEST_CHECK (expected == 10);
+
+	expected = 8;
+
+	for (link = head.prev; link != &head; link = link->prev) {
+		P_TEST_CHECK (P_CONTAINER_OF (link, TestLinkItem, link)->id == expected);
+		expected = expected == 0 ? 1 : (expected % 2 == 0 ? expected - 2 : expected + 2);
+	}
+
+	P_TEST_CHECK (expected == 11);
+
+	/* Remove the first, the last and a middle link */
+	p_list_link_remove (&items[9].link);
+	p_list_link_remove (&items[8].link);
+	p_list_link_remove (&items[0].link);
+
+	P_TEST_CHECK (items[0].link.next == &items[0].link);
+	P_TEST_CHECK (items[0].link.prev == &items[0].link);
+
+	p_list_link_remove (&items[0].link);
+
+	P_TEST_CHECK (p_list_link_length (&head) == 7);
+	P_TEST_CHECK (P_CONTAINER_OF (head.next, TestLinkItem, link)->id == 7);
+	P_TEST_CHECK (P_CONTAINER_OF (head.prev, TestLinkItem, link)->id == 6);
+	P_TEST_CHECK (items[1].link.next == &items[2].link);
+	P_TEST_CHECK (items[2].link.prev == &items[1].link);
+
+	/* A removed link can be put into a list again */
+	p_list_link_append (&head, &items[0].link);
+
+	P_TEST_CHECK (head.prev == &items[0].link);
+	P_TEST_CHECK (items[0].link.next == &head);
+
+	while (p_list_link_is_empty (&head) == FALSE)
+		p_list_link_remove (head.next);
+
+	P_TEST_CHECK (p_list_link_length (&head) == 0);
+	P_TEST_CHECK (head.next == &head && head.prev == &head);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
 P_TEST_SUITE_BEGIN()
 {
 	P_TEST_SUITE_RUN_CASE (plist_nomem_test);
 	P_TEST_SUITE_RUN_CASE (plist_invalid_test);
 	P_TEST_SUITE_RUN_CASE (plist_general_test);
+	P_TEST_SUITE_RUN_CASE (plist_head_test);
+	P_TEST_SUITE_RUN_CASE (plist_unrolled_test);
+	P_TEST_SUITE_RUN_CASE (plist_link_test);
 }
 P_TEST_SUITE_END()
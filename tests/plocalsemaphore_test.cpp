@@ -0,0 +1,282 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+P_TEST_MODULE_INIT ();
+
+#define PLOCALSEMAPHORE_THREADS		4
+#define PLOCALSEMAPHORE_ITERATIONS	10000
+
+static PLocalSemaphore *	sem_items  = NULL;
+static PLocalSemaphore *	sem_slots  = NULL;
+static volatile pint		sem_queued = 0;
+static volatile pint		sem_max    = 0;
+static volatile pint		sem_sum    = 0;
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static void * sem_producer_thread (void *)
+{
+	pint i;
+	pint queued;
+
+	for (i = 0; i < PLOCALSEMAPHORE_ITERATIONS; ++i) {
+		if (p_local_semaphore_acquire (sem_slots) == FALSE)
+			break;
+
+		queued = p_atomic_int_add (&sem_queued, 1) + 1;
+
+		if (queued > p_atomic_int_get (&sem_max))
+			p_atomic_int_set (&sem_max, queued);
+
+		p_local_semaphore_release (sem_items, 1);
+	}
+
+	return NULL;
+}
+
+static void * sem_consumer_thread (void *)
+{
+	pint i;
+
+	for (i = 0; i < PLOCALSEMAPHORE_ITERATIONS; ++i) {
+		if (p_local_semaphore_acquire (sem_items) == FALSE)
+			break;
+
+		p_atomic_int_add (&sem_queued, -1);
+		p_atomic_int_inc (&sem_sum);
+
+		p_local_semaphore_release (sem_slots, 1);
+	}
+
+	return NULL;
+}
+
+static void * sem_waiter_thread (void *)
+{
+	if (p_local_semaphore_acquire_timed (sem_items, 10000) == TRUE)
+		p_atomic_int_inc (&sem_sum);
+
+	return NULL;
+}
+
+P_TEST_CASE_BEGIN (plocalsemaphore_nomem_test)
+{
+	p_libsys_init ();
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (p_local_semaphore_new (1) == NULL);
+
+	p_mem_restore_vtable ();
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (plocalsemaphore_bad_input_test)
+{
+	PLocalSemaphore *sem;
+
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_local_semaphore_new (-1) == NULL);
+	P_TEST_CHECK (p_local_semaphore_acquire (NULL) == FALSE);
+	P_TEST_CHECK (p_local_semaphore_try_acquire (NULL) == FALSE);
+	P_TEST_CHECK (p_local_semaphore_acquire_timed (NULL, 0) == FALSE);
+	P_TEST_CHECK (p_local_semaphore_release (NULL, 1) == FALSE);
+	P_TEST_CHECK (p_local_semaphore_get_value (NULL) == 0);
+	p_local_semaphore_free (NULL);
+
+	sem = p_local_semaphore_new (0);
+	P_TEST_REQUIRE (sem != NULL);
+
+	P_TEST_CHECK (p_local_semaphore_acquire_timed (sem, -2) == FALSE);
+	P_TEST_CHECK (p_local_semaphore_release (sem, 0) == FALSE);
+	P_TEST_CHECK (p_local_semaphore_release (sem, -1) == FALSE);
+	P_TEST_CHECK (p_local_semaphore_get_value (sem) == 0);
+
+	/* Counter overflow */
+	P_TEST_CHECK (p_local_semaphore_release (sem, P_MAXINT32) == TRUE);
+	P_TEST_CHECK (p_local_semaphore_release (sem, 1) == FALSE);
+	P_TEST_CHECK (p_local_semaphore_get_value (sem) == P_MAXINT32);
+
+	p_local_semaphore_free (sem);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (plocalsemaphore_general_test)
+{
+	PLocalSemaphore	*sem;
+	puint64		start;
+
+	p_libsys_init ();
+
+	sem = p_local_semaphore_new (2);
+	P_TEST_REQUIRE (sem != NULL);
+	P_TEST_CHECK (p_local_semaphore_get_value (sem) == 2);
+
+	P_TEST_CHECK (p_local_semaphore_acquire (sem) == TRUE);
+	P_TEST_CHECK (p_local_semaphore_try_acquire (sem) == TRUE);
+	P_TEST_CHECK (p_local_semaphore_get_value (sem) == 0);
+	P_TEST_CHECK (p_local_semaphore_try_acquire (sem) == FALSE);
+	P_TEST_CHECK (p_local_semaphore_acquire_timed (sem, 0) == FALSE);
+
+	start = p_time_coarse_now_msecs ();
+	P_TEST_CHECK (p_local_semaphore_acquire_timed (sem, 100) == FALSE);
+	P_TEST_CHECK (p_time_coarse_now_msecs () - start >= 50);
+
+	P_TEST_CHECK (p_local_semaphore_release (sem, 3) == TRUE);
+	P_TEST_CHECK (p_local_semaphore_get_value (sem) == 3);
+	P_TEST_CHECK (p_local_semaphore_acquire_timed (sem, 100) == TRUE);
+	P_TEST_CHECK (p_local_semaphore_acquire_timed (sem, -1) == TRUE);
+	P_TEST_CHECK (p_local_semaphore_acquire (sem) == TRUE);
+	P_TEST_CHECK (p_local_semaphore_get_value (sem) == 0);
+
+	p_local_semaphore_free (sem);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (plocalsemaphore_wakeup_test)
+{
+	PUThread	*threads[PLOCALSEMAPHORE_THREADS];
+	pint		i;
+
+	p_libsys_init ();
+
+	sem_items = p_local_semaphore_new (0);
+	P_TEST_REQUIRE (sem_items != NULL);
+
+	p_atomic_int_set (&sem_sum, 0);
+
+	for (i = 0; i < PLOCALSEMAPHORE_THREADS; ++i) {
+		threads[i] = p_uthread_create ((PUThreadFunc) sem_waiter_thread, NULL, TRUE, NULL);
+		P_TEST_REQUIRE (threads[i] != NULL);
+	}
+
+	p_uthread_sleep (50);
+
+	/* A single release must wake up all the waiters it has units for */
+	P_TEST_CHECK (p_local_semaphore_release (sem_items, PLOCALSEMAPHORE_THREADS) == TRUE);
+
+	for (i = 0; i < PLOCALSEMAPHORE_THREADS; ++i) {
+		p_uthread_join (threads[i]);
+		p_uthread_unref (threads[i]);
+	}
+
+	P_TEST_CHECK (p_atomic_int_get (&sem_sum) == PLOCALSEMAPHORE_THREADS);
+	P_TEST_CHECK (p_local_semaphore_get_value (sem_items) == 0);
+
+	p_local_semaphore_free (sem_items);
+	sem_items = NULL;
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (plocalsemaphore_threads_test)
+{
+	PUThread	*producers[PLOCALSEMAPHORE_THREADS];
+	PUThread	*consumers[PLOCALSEMAPHORE_THREADS];
+	pint		i;
+
+	p_libsys_init ();
+
+	/* Bounded queue of 8 slots */
+	sem_items = p_local_semaphore_new (0);
+	sem_slots = p_local_semaphore_new (8);
+	P_TEST_REQUIRE (sem_items != NULL);
+	P_TEST_REQUIRE (sem_slots != NULL);
+
+	p_atomic_int_set (&sem_queued, 0);
+	p_atomic_int_set (&sem_max, 0);
+	p_atomic_int_set (&sem_sum, 0);
+
+	for (i = 0; i < PLOCALSEMAPHORE_THREADS; ++i) {
+		producers[i] = p_uthread_create ((PUThreadFunc) sem_producer_thread, NULL, TRUE, NULL);
+		consumers[i] = p_uthread_create ((PUThreadFunc) sem_consumer_thread, NULL, TRUE, NULL);
+		P_TEST_REQUIRE (producers[i] != NULL);
+		P_TEST_REQUIRE (consumers[i] != NULL);
+	}
+
+	for (i = 0; i < PLOCALSEMAPHORE_THREADS; ++i) {
+		p_uthread_join (producers[i]);
+		p_uthread_join (consumers[i]);
+		p_uthread_unref (producers[i]);
+		p_uthread_unref (consumers[i]);
+	}
+
+	P_TEST_CHECK (p_atomic_int_get (&sem_sum) == PLOCALSEMAPHORE_THREADS * PLOCALSEMAPHORE_ITERATIONS);
+	P_TEST_CHECK (p_atomic_int_get (&sem_queued) == 0);
+	P_TEST_CHECK (p_atomic_int_get (&sem_max) <= 8);
+	P_TEST_CHECK (p_local_semaphore_get_value (sem_items) == 0);
+	P_TEST_CHECK (p_local_semaphore_get_value (sem_slots) == 8);
+
+	p_local_semaphore_free (sem_items);
+	p_local_semaphore_free (sem_slots);
+	sem_items = NULL;
+	sem_slots = NULL;
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (plocalsemaphore_nomem_test);
+	P_TEST_SUITE_RUN_CASE (plocalsemaphore_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (plocalsemaphore_general_test);
+	P_TEST_SUITE_RUN_CASE (plocalsemaphore_wakeup_test);
+	P_TEST_SUITE_RUN_CASE (plocalsemaphore_threads_test);
+}
+P_TEST_SUITE_END()
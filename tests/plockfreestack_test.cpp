@@ -0,0 +1,264 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+P_TEST_MODULE_INIT ();
+
+#define PLOCKFREESTACK_THREADS	4
+#define PLOCKFREESTACK_NODES	64
+#define PLOCKFREESTACK_ROUNDS	50000
+
+typedef struct PLockFreeStackTestNode_ {
+	PLockFreeStackNode	node;
+	volatile pint		owners;
+	pint			value;
+} PLockFreeStackTestNode;
+
+static PLockFreeStack *		global_stack = NULL;
+static PLockFreeStackTestNode	stack_nodes[PLOCKFREESTACK_NODES];
+static volatile pint		stack_shared = 0;
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+/* Two threads holding the same node at once mean the stack was corrupted */
+static void * stack_thread (void *)
+{
+	PLockFreeStackTestNode	*held[2];
+	PLockFreeStackNode	*chain;
+	pint			i;
+	pint			j;
+
+	for (i = 0; i < PLOCKFREESTACK_ROUNDS; ++i) {
+		for (j = 0; j < 2; ++j) {
+			held[j] = (PLockFreeStackTestNode *) p_lock_free_stack_pop (global_stack);
+
+			if (held[j] != NULL && p_atomic_int_add (&held[j]->owners, 1) != 0)
+				p_atomic_int_inc (&stack_shared);
+		}
+
+		for (j = 0; j < 2; ++j) {
+			if (held[j] == NULL)
+				continue;
+
+			p_atomic_int_add (&held[j]->owners, -1);
+		}
+
+		if (held[0] != NULL && held[1] != NULL && (i & 1) == 0) {
+			/* Return both nodes as a chain */
+			p_atomic_pointer_set_explicit (&held[0]->node.next, &held[1]->node, P_ATOMIC_MEMORY_ORDER_RELAXED);
+			p_lock_free_stack_push_all (global_stack, &held[0]->node, &held[1]->node);
+		} else {
+			for (j = 0; j < 2; ++j) {
+				if (held[j] != NULL)
+					p_lock_free_stack_push (global_stack, &held[j]->node);
+			}
+		}
+
+		/* Sometimes take everything and put it back */
+		if (i % 1000 == 0 && (chain = p_lock_free_stack_pop_all (global_stack)) != NULL) {
+			PLockFreeStackNode *last = chain;
+
+			/* Stale pops may still read the links, so they are atomic */
+			while (p_atomic_pointer_get_explicit (&last->next, P_ATOMIC_MEMORY_ORDER_RELAXED) != NULL)
+				last = (PLockFreeStackNode *) p_atomic_pointer_get_explicit (&last->next, P_ATOMIC_MEMORY_ORDER_RELAXED);
+
+			p_lock_free_stack_push_all (global_stack, chain, last);
+		}
+	}
+
+	p_uthread_exit (0);
+
+	return NULL;
+}
+
+P_TEST_CASE_BEGIN (plockfreestack_nomem_test)
+{
+	p_libsys_init ();
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+	P_TEST_CHECK (p_lock_free_stack_new () == NULL);
+
+	p_mem_restore_vtable ();
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (plockfreestack_bad_input_test)
+{
+	PLockFreeStackNode node;
+
+	p_libsys_init ();
+
+	p_lock_free_stack_push (NULL, &node);
+	p_lock_free_stack_push_all (NULL, &node, &node);
+	P_TEST_CHECK (p_lock_free_stack_pop (NULL) == NULL);
+	P_TEST_CHECK (p_lock_free_stack_pop_all (NULL) == NULL);
+	P_TEST_CHECK (p_lock_free_stack_is_empty (NULL) == TRUE);
+	p_lock_free_stack_free (NULL);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (plockfreestack_general_test)
+{
+	PLockFreeStack		*stack;
+	PLockFreeStackNode	*chain;
+	PLockFreeStackTestNode	nodes[5];
+	pint			i;
+
+	p_libsys_init ();
+
+#if (defined (P_CPU_X86_64) || defined (P_CPU_ARM_64)) && (defined (P_CC_GNU) || defined (P_CC_MSVC))
+	P_TEST_CHECK (p_lock_free_stack_is_lock_free () == TRUE);
+#else
+	(void) p_lock_free_stack_is_lock_free ();
+#endif
+
+	stack = p_lock_free_stack_new ();
+	P_TEST_REQUIRE (stack != NULL);
+
+	P_TEST_CHECK (p_lock_free_stack_is_empty (stack) == TRUE);
+	P_TEST_CHECK (p_lock_free_stack_pop (stack) == NULL);
+	P_TEST_CHECK (p_lock_free_stack_pop_all (stack) == NULL);
+
+	p_lock_free_stack_push (stack, NULL);
+	p_lock_free_stack_push_all (stack, NULL, NULL);
+	P_TEST_CHECK (p_lock_free_stack_is_empty (stack) == TRUE);
+
+	for (i = 0; i < 5; ++i) {
+		nodes[i].value = i;
+		p_lock_free_stack_push (stack, &nodes[i].node);
+	}
+
+	P_TEST_CHECK (p_lock_free_stack_is_empty (stack) == FALSE);
+
+	/* LIFO order */
+	for (i = 4; i >= 0; --i)
+		P_TEST_CHECK (((PLockFreeStackTestNode *) p_lock_free_stack_pop (stack))->value == i);
+
+	P_TEST_CHECK (p_lock_free_stack_is_empty (stack) == TRUE);
+
+	/* A chain lands on top as a whole */
+	p_lock_free_stack_push (stack, &nodes[0].node);
+
+	nodes[1].node.next = &nodes[2].node;
+	nodes[2].node.next = &nodes[3].node;
+	p_lock_free_stack_push_all (stack, &nodes[1].node, &nodes[3].node);
+
+	P_TEST_CHECK (p_lock_free_stack_pop (stack) == &nodes[1].node);
+
+	chain = p_lock_free_stack_pop_all (stack);
+	P_TEST_CHECK (chain == &nodes[2].node);
+	P_TEST_CHECK (chain->next == &nodes[3].node);
+	P_TEST_CHECK (chain->next->next == &nodes[0].node);
+	P_TEST_CHECK (chain->next->next->next == NULL);
+
+	P_TEST_CHECK (p_lock_free_stack_is_empty (stack) == TRUE);
+
+	p_lock_free_stack_free (stack);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (plockfreestack_thread_test)
+{
+	PUThread		*thr[PLOCKFREESTACK_THREADS];
+	PLockFreeStackNode	*node;
+	pint			count;
+	pint			i;
+
+	p_libsys_init ();
+
+	global_stack = p_lock_free_stack_new ();
+	P_TEST_REQUIRE (global_stack != NULL);
+
+	p_atomic_int_set (&stack_shared, 0);
+
+	for (i = 0; i < PLOCKFREESTACK_NODES; ++i) {
+		stack_nodes[i].owners = 0;
+		p_lock_free_stack_push (global_stack, &stack_nodes[i].node);
+	}
+
+	for (i = 0; i < PLOCKFREESTACK_THREADS; ++i) {
+		thr[i] = p_uthread_create ((PUThreadFunc) stack_thread, NULL, TRUE, NULL);
+		P_TEST_REQUIRE (thr[i] != NULL);
+	}
+
+	for (i = 0; i < PLOCKFREESTACK_THREADS; ++i) {
+		P_TEST_CHECK (p_uthread_join (thr[i]) == 0);
+		p_uthread_unref (thr[i]);
+	}
+
+	P_TEST_CHECK (p_atomic_int_get (&stack_shared) == 0);
+
+	/* No node is lost or duplicated */
+	for (count = 0; (node = p_lock_free_stack_pop (global_stack)) != NULL; ++count) {
+		if (count > PLOCKFREESTACK_NODES)
+			break;
+	}
+
+	P_TEST_CHECK (count == PLOCKFREESTACK_NODES);
+
+	p_lock_free_stack_free (global_stack);
+	global_stack = NULL;
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (plockfreestack_nomem_test);
+	P_TEST_SUITE_RUN_CASE (plockfreestack_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (plockfreestack_general_test);
+	P_TEST_SUITE_RUN_CASE (plockfreestack_thread_test);
+}
+P_TEST_SUITE_END()
@@ -0,0 +1,176 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <string.h>
+
+P_TEST_MODULE_INIT ();
+
+#ifdef PLIBSYS_LOCK_STATS
+static PMutex * global_mutex = NULL;
+
+static void * mutex_thread (void *)
+{
+	p_mutex_lock (global_mutex);
+	p_mutex_unlock (global_mutex);
+
+	p_uthread_exit (0);
+
+	return NULL;
+}
+#endif
+
+P_TEST_CASE_BEGIN (plockstats_bad_input_test)
+{
+	PLockStats stats;
+
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_lock_stats_set_name (NULL, "name") == FALSE);
+	P_TEST_CHECK (p_lock_stats_get (NULL, &stats) == FALSE);
+	P_TEST_CHECK (p_lock_stats_get (&stats, &stats) == FALSE);
+	P_TEST_CHECK (p_lock_stats_get_top (NULL, 10) == 0);
+	P_TEST_CHECK (p_lock_stats_get_top (&stats, 0) == 0);
+
+	p_lock_stats_dump (0);
+	p_lock_stats_reset ();
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (plockstats_general_test)
+{
+	PMutex		*mutex;
+	PRWLock		*rwlock;
+	PLockStats	stats;
+
+	p_libsys_init ();
+
+	mutex  = p_mutex_new ();
+	rwlock = p_rwlock_new ();
+
+	P_TEST_REQUIRE (mutex != NULL);
+	P_TEST_REQUIRE (rwlock != NULL);
+
+#ifdef PLIBSYS_LOCK_STATS
+	PLockStats	top[2];
+	PUThread	*thr;
+
+	P_TEST_CHECK (p_lock_stats_set_name (mutex, "test mutex") == TRUE);
+	P_TEST_CHECK (p_lock_stats_set_name (rwlock, "test rwlock with a very long name") == TRUE);
+
+	P_TEST_CHECK (p_mutex_lock (mutex) == TRUE);
+	P_TEST_CHECK (p_mutex_unlock (mutex) == TRUE);
+	P_TEST_CHECK (p_mutex_trylock (mutex) == TRUE);
+	P_TEST_CHECK (p_mutex_unlock (mutex) == TRUE);
+
+	P_TEST_REQUIRE (p_lock_stats_get (mutex, &stats) == TRUE);
+	P_TEST_CHECK (stats.lock == mutex);
+	P_TEST_CHECK (stats.type == P_LOCK_STATS_TYPE_MUTEX);
+	P_TEST_CHECK (strcmp (stats.name, "test mutex") == 0);
+	P_TEST_CHECK (stats.acquisitions == 2);
+	P_TEST_CHECK (stats.contended == 0);
+	P_TEST_CHECK (stats.wait_total_usecs == 0);
+
+	/* The thread has to wait while the mutex is held */
+	global_mutex = mutex;
+
+	P_TEST_CHECK (p_mutex_lock (mutex) == TRUE);
+
+	thr = p_uthread_create ((PUThreadFunc) mutex_thread, NULL, TRUE, NULL);
+	P_TEST_REQUIRE (thr != NULL);
+
+	p_uthread_sleep (50);
+	P_TEST_CHECK (p_mutex_unlock (mutex) == TRUE);
+
+	P_TEST_CHECK (p_uthread_join (thr) == 0);
+	p_uthread_unref (thr);
+
+	P_TEST_REQUIRE (p_lock_stats_get (mutex, &stats) == TRUE);
+	P_TEST_CHECK (stats.acquisitions == 4);
+	P_TEST_CHECK (stats.contended == 1);
+	P_TEST_CHECK (stats.wait_max_usecs > 0);
+	P_TEST_CHECK (stats.wait_total_usecs >= stats.wait_max_usecs);
+	P_TEST_CHECK (stats.hold_max_usecs >= 40000);
+	P_TEST_CHECK (stats.hold_total_usecs >= stats.hold_max_usecs);
+
+	P_TEST_CHECK (p_rwlock_reader_lock (rwlock) == TRUE);
+	P_TEST_CHECK (p_rwlock_reader_trylock (rwlock) == TRUE);
+	P_TEST_CHECK (p_rwlock_writer_trylock (rwlock) == FALSE);
+	P_TEST_CHECK (p_rwlock_reader_unlock (rwlock) == TRUE);
+	P_TEST_CHECK (p_rwlock_reader_unlock (rwlock) == TRUE);
+	P_TEST_CHECK (p_rwlock_writer_lock (rwlock) == TRUE);
+	P_TEST_CHECK (p_rwlock_writer_unlock (rwlock) == TRUE);
+
+	P_TEST_REQUIRE (p_lock_stats_get (rwlock, &stats) == TRUE);
+	P_TEST_CHECK (stats.type == P_LOCK_STATS_TYPE_RWLOCK);
+	P_TEST_CHECK (strlen (stats.name) == P_LOCK_STATS_NAME_SIZE - 1);
+	P_TEST_CHECK (stats.acquisitions == 3);
+	P_TEST_CHECK (stats.contended == 0);
+
+	/* The mutex is the most contended lock of the process */
+	P_TEST_CHECK (p_lock_stats_get_top (top, 2) >= 1);
+	P_TEST_CHECK (top[0].lock == mutex);
+
+	p_lock_stats_dump (5);
+
+	p_lock_stats_reset ();
+
+	P_TEST_REQUIRE (p_lock_stats_get (mutex, &stats) == TRUE);
+	P_TEST_CHECK (stats.acquisitions == 0);
+	P_TEST_CHECK (stats.contended == 0);
+	P_TEST_CHECK (stats.hold_max_usecs == 0);
+	P_TEST_CHECK (strcmp (stats.name, "test mutex") == 0);
+
+	P_TEST_CHECK (p_lock_stats_set_name (mutex, NULL) == TRUE);
+	P_TEST_REQUIRE (p_lock_stats_get (mutex, &stats) == TRUE);
+	P_TEST_CHECK (stats.name[0] == '\0');
+
+#else
+	P_TEST_CHECK (p_lock_stats_set_name (mutex, "test mutex") == FALSE);
+	P_TEST_CHECK (p_lock_stats_get (mutex, &stats) == FALSE);
+	P_TEST_CHECK (p_lock_stats_get_top (&stats, 1) == 0);
+#endif
+
+	p_rwlock_free (rwlock);
+
+	/* Freed locks are not reported */
+	P_TEST_CHECK (p_lock_stats_get (rwlock, &stats) == FALSE);
+
+	p_mutex_free (mutex);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (plockstats_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (plockstats_general_test);
+}
+P_TEST_SUITE_END()
@@ -0,0 +1,434 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Debug messages are compiled out in this file */
+#define P_LOG_MIN_LEVEL 1
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <string.h>
+
+P_TEST_MODULE_INIT ();
+
+#define PLOG_TEST_MAX_MESSAGES	1024
+#define PLOG_TEST_THREADS	4
+#define PLOG_TEST_THREAD_MSGS	100
+
+typedef struct LogTestMessage_ {
+	PLogLevel	level;
+	pchar		text[P_LOG_MESSAGE_SIZE + 64];
+} LogTestMessage;
+
+static LogTestMessage	log_messages[PLOG_TEST_MAX_MESSAGES];
+static volatile pint	log_count     = 0;
+static volatile pint	log_blocked   = 0;
+static volatile pint	log_entered   = 0;
+static volatile pint	log_evaluated = 0;
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static void log_handler (PLogLevel level, const pchar *message, ppointer user_data)
+{
+	pint index;
+
+	P_UNUSED (user_data);
+
+	p_atomic_int_set (&log_entered, 1);
+
+	while (p_atomic_int_get (&log_blocked) != 0)
+		p_uthread_sleep (1);
+
+	index = p_atomic_int_get (&log_count);
+
+	if (index < PLOG_TEST_MAX_MESSAGES) {
+		log_messages[index].level = level;
+		strncpy (log_messages[index].text, message, sizeof (log_messages[index].text) - 1);
+		log_messages[index].text[sizeof (log_messages[index].text) - 1] = '\0';
+	}
+
+	p_atomic_int_set (&log_count, index + 1);
+}
+
+static void log_reset (void)
+{
+	p_atomic_int_set (&log_count, 0);
+	p_atomic_int_set (&log_blocked, 0);
+	p_atomic_int_set (&log_entered, 0);
+}
+
+static const pchar * log_evaluate (const pchar *message)
+{
+	p_atomic_int_inc (&log_evaluated);
+	return message;
+}
+
+static void log_storm_site (void)
+{
+	P_ERROR ("storm");
+}
+
+static pint log_suppressed (const pchar *text)
+{
+	const pchar	*start;
+	pint		value = 0;
+
+	if ((start = strstr (text, " (")) == NULL || strstr (start, " suppressed)") == NULL)
+		return 0;
+
+	for (start += 2; *start >= '0' && *start <= '9'; ++start)
+		value = value * 10 + (*start - '0');
+
+	return value;
+}
+
+static void * log_thread (void *data)
+{
+	pchar	text[32];
+	pint	id = P_POINTER_TO_INT (data);
+	pint	i;
+
+	for (i = 0; i < PLOG_TEST_THREAD_MSGS; ++i) {
+		text[0] = (pchar) ('a' + id);
+		text[1] = (pchar) ('0' + i / 100);
+		text[2] = (pchar) ('0' + i / 10 % 10);
+		text[3] = (pchar) ('0' + i % 10);
+		text[4] = '\0';
+
+		p_log_write (P_LOG_LEVEL_WARNING, text);
+	}
+
+	p_uthread_exit (0);
+
+	return NULL;
+}
+
+P_TEST_CASE_BEGIN (plog_nomem_test)
+{
+	p_libsys_init ();
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	log_reset ();
+	p_log_set_handler (log_handler, NULL);
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (p_log_start_async () == FALSE);
+	P_TEST_CHECK (p_log_is_async () == FALSE);
+
+	/* Messages are still written synchronously */
+	p_log_write (P_LOG_LEVEL_ERROR, "nomem");
+
+	p_mem_restore_vtable ();
+
+	P_TEST_CHECK (p_atomic_int_get (&log_count) >= 1);
+	P_TEST_CHECK (strcmp (log_messages[p_atomic_int_get (&log_count) - 1].text, "nomem") == 0);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (plog_bad_input_test)
+{
+	p_libsys_init ();
+
+	log_reset ();
+	p_log_set_handler (log_handler, NULL);
+
+	p_log_write (P_LOG_LEVEL_ERROR, NULL);
+	p_log_write ((PLogLevel) -1, "bad");
+	p_log_write ((PLogLevel) 3, "bad");
+	p_log_write_site (3, NULL, "bad");
+
+	P_TEST_CHECK (p_atomic_int_get (&log_count) == 0);
+
+	p_log_stop_async ();
+	p_log_flush ();
+
+	P_TEST_CHECK (p_log_is_async () == FALSE);
+	P_TEST_CHECK (p_log_get_dropped () == 0);
+
+	/* The default handler prints to stdout */
+	p_log_set_handler (NULL, NULL);
+	P_WARNING ("PLog test: the default handler");
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (plog_sync_test)
+{
+	p_libsys_init ();
+
+	pint delivered;
+	pint suppressed;
+	pint i;
+
+	log_reset ();
+	p_log_set_handler (log_handler, NULL);
+
+	P_ERROR ("error");
+	P_WARNING ("warning");
+	p_log_write (P_LOG_LEVEL_DEBUG, "debug");
+
+	P_TEST_REQUIRE (p_atomic_int_get (&log_count) == 3);
+	P_TEST_CHECK (log_messages[0].level == P_LOG_LEVEL_ERROR);
+	P_TEST_CHECK (strcmp (log_messages[0].text, "error") == 0);
+	P_TEST_CHECK (log_messages[1].level == P_LOG_LEVEL_WARNING);
+	P_TEST_CHECK (strcmp (log_messages[1].text, "warning") == 0);
+	P_TEST_CHECK (log_messages[2].level == P_LOG_LEVEL_DEBUG);
+
+	/* Compiled out along with the argument */
+	P_DEBUG (log_evaluate ("debug"));
+
+	P_TEST_CHECK (p_atomic_int_get (&log_count) == 3);
+	P_TEST_CHECK (p_atomic_int_get (&log_evaluated) == 0);
+
+	/* Not rate limited */
+	for (i = 0; i < P_LOG_DEFAULT_RATE_LIMIT * 2; ++i)
+		p_log_write (P_LOG_LEVEL_WARNING, "unlimited");
+
+	P_TEST_CHECK (p_atomic_int_get (&log_count) == 3 + P_LOG_DEFAULT_RATE_LIMIT * 2);
+
+	/* Rate limiting, the storm may span two windows */
+	log_reset ();
+	p_log_set_rate_limit (5);
+
+	for (i = 0; i < 100; ++i)
+		log_storm_site ();
+
+	delivered = p_atomic_int_get (&log_count);
+
+	P_TEST_CHECK (delivered >= 5 && delivered <= 10);
+
+	p_uthread_sleep (1100);
+	log_storm_site ();
+
+	P_TEST_REQUIRE (p_atomic_int_get (&log_count) == delivered + 1);
+
+	suppressed = 0;
+
+	for (i = 0; i <= delivered; ++i) {
+		P_TEST_CHECK (strncmp (log_messages[i].text, "storm", 5) == 0);
+		suppressed += log_suppressed (log_messages[i].text);
+	}
+
+	P_TEST_CHECK (log_suppressed (log_messages[delivered].text) > 0);
+	P_TEST_CHECK (delivered + suppressed == 100);
+
+	/* Disabled */
+	log_reset ();
+	p_log_set_rate_limit (0);
+
+	for (i = 0; i < 100; ++i)
+		log_storm_site ();
+
+	P_TEST_CHECK (p_atomic_int_get (&log_count) == 100);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (plog_async_test)
+{
+	p_libsys_init ();
+
+	pchar	long_message[P_LOG_MESSAGE_SIZE * 2];
+	pint	i;
+
+	log_reset ();
+	p_log_set_handler (log_handler, NULL);
+
+	P_TEST_REQUIRE (p_log_start_async () == TRUE);
+	P_TEST_CHECK (p_log_is_async () == TRUE);
+	P_TEST_CHECK (p_log_start_async () == TRUE);
+
+	P_ERROR ("first");
+	P_WARNING ("second");
+
+	memset (long_message, 'x', sizeof (long_message) - 1);
+	long_message[sizeof (long_message) - 1] = '\0';
+
+	p_log_write (P_LOG_LEVEL_ERROR, long_message);
+
+	p_log_flush ();
+
+	P_TEST_REQUIRE (p_atomic_int_get (&log_count) == 3);
+	P_TEST_CHECK (log_messages[0].level == P_LOG_LEVEL_ERROR);
+	P_TEST_CHECK (strcmp (log_messages[0].text, "first") == 0);
+	P_TEST_CHECK (log_messages[1].level == P_LOG_LEVEL_WARNING);
+	P_TEST_CHECK (strcmp (log_messages[1].text, "second") == 0);
+	P_TEST_CHECK (strlen (log_messages[2].text) == P_LOG_MESSAGE_SIZE - 1);
+
+	/* The writer delivers without an explicit flush */
+	P_ERROR ("third");
+
+	for (i = 0; i < 1000 && p_atomic_int_get (&log_count) < 4; ++i)
+		p_uthread_sleep (1);
+
+	P_TEST_REQUIRE (p_atomic_int_get (&log_count) == 4);
+	P_TEST_CHECK (strcmp (log_messages[3].text, "third") == 0);
+
+	/* Delivered on stop as well */
+	P_WARNING ("fourth");
+	p_log_stop_async ();
+
+	P_TEST_CHECK (p_log_is_async () == FALSE);
+	P_TEST_REQUIRE (p_atomic_int_get (&log_count) == 5);
+	P_TEST_CHECK (strcmp (log_messages[4].text, "fourth") == 0);
+
+	/* Synchronous again */
+	P_WARNING ("fifth");
+	P_TEST_CHECK (p_atomic_int_get (&log_count) == 6);
+
+	/* Shutdown stops the writer */
+	P_TEST_CHECK (p_log_start_async () == TRUE);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (plog_threads_test)
+{
+	p_libsys_init ();
+
+	PUThread	*threads[PLOG_TEST_THREADS];
+	pint		last[PLOG_TEST_THREADS];
+	pint		id;
+	pint		value;
+	pint		i;
+
+	log_reset ();
+	p_log_set_handler (log_handler, NULL);
+
+	P_TEST_REQUIRE (p_log_start_async () == TRUE);
+
+	for (i = 0; i < PLOG_TEST_THREADS; ++i) {
+		threads[i] = p_uthread_create ((PUThreadFunc) log_thread, P_INT_TO_POINTER (i), TRUE, NULL);
+		P_TEST_REQUIRE (threads[i] != NULL);
+	}
+
+	for (i = 0; i < PLOG_TEST_THREADS; ++i) {
+		p_uthread_join (threads[i]);
+		p_uthread_unref (threads[i]);
+	}
+
+	p_log_stop_async ();
+
+	P_TEST_CHECK (p_log_get_dropped () == 0);
+	P_TEST_REQUIRE (p_atomic_int_get (&log_count) == PLOG_TEST_THREADS * PLOG_TEST_THREAD_MSGS);
+
+	for (i = 0; i < PLOG_TEST_THREADS; ++i)
+		last[i] = -1;
+
+	/* The order is kept within a thread */
+	for (i = 0; i < PLOG_TEST_THREADS * PLOG_TEST_THREAD_MSGS; ++i) {
+		id    = log_messages[i].text[0] - 'a';
+		value = (log_messages[i].text[1] - '0') * 100 +
+			(log_messages[i].text[2] - '0') * 10 +
+			(log_messages[i].text[3] - '0');
+
+		P_TEST_REQUIRE (id >= 0 && id < PLOG_TEST_THREADS);
+		P_TEST_CHECK (value == last[id] + 1);
+
+		last[id] = value;
+	}
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (plog_overflow_test)
+{
+	p_libsys_init ();
+
+	puint64	dropped;
+	pint	written = P_LOG_BUFFER_SIZE + 16;
+	pint	i;
+
+	log_reset ();
+	p_log_set_handler (log_handler, NULL);
+
+	P_TEST_REQUIRE (p_log_start_async () == TRUE);
+
+	/* The writer is stuck in the handler */
+	p_atomic_int_set (&log_blocked, 1);
+	p_log_write (P_LOG_LEVEL_ERROR, "blocker");
+
+	while (p_atomic_int_get (&log_entered) == 0)
+		p_uthread_sleep (1);
+
+	for (i = 0; i < written; ++i)
+		p_log_write (P_LOG_LEVEL_ERROR, "overflow");
+
+	dropped = p_log_get_dropped ();
+
+	P_TEST_CHECK (dropped >= 16);
+
+	p_atomic_int_set (&log_blocked, 0);
+	p_log_stop_async ();
+
+	P_TEST_CHECK (p_log_get_dropped () == dropped);
+	P_TEST_CHECK (p_atomic_int_get (&log_count) == 1 + written - (pint) dropped);
+
+	/* Reset by the next start */
+	P_TEST_REQUIRE (p_log_start_async () == TRUE);
+	P_TEST_CHECK (p_log_get_dropped () == 0);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (plog_nomem_test);
+	P_TEST_SUITE_RUN_CASE (plog_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (plog_sync_test);
+	P_TEST_SUITE_RUN_CASE (plog_async_test);
+	P_TEST_SUITE_RUN_CASE (plog_threads_test);
+	P_TEST_SUITE_RUN_CASE (plog_overflow_test);
+}
+P_TEST_SUITE_END()
@@ -46,6 +46,13 @@ P_LIB_GLOBAL_API int global_api_test ()
 	return 0;
 }
 
+typedef struct AlignedTestStruct_ {
+	P_CACHE_ALIGNED pint	first;
+	pint			second;
+} AlignedTestStruct;
+
+static P_ALIGNED (16) pchar aligned_test_buf[3];
+
 P_TEST_CASE_BEGIN (pmacros_general_test)
 {
 	p_libsys_init ();
@@ -609,6 +616,22 @@ P_TEST_CASE_BEGIN (pmacros_general_test)
 	P_TEST_CHECK (internal_api_test () == 0);
 	P_TEST_CHECK (global_api_test () == 0);
 
+	/* Test cache line and alignment macros */
+	P_TEST_CHECK (P_CACHE_LINE_SIZE >= 32);
+	P_TEST_CHECK ((P_CACHE_LINE_SIZE & (P_CACHE_LINE_SIZE - 1)) == 0);
+	P_TEST_CHECK (P_MEM_CACHE_LINE_SIZE == P_CACHE_LINE_SIZE);
+
+#if defined (P_CC_GNU) || defined (P_CC_CLANG) || defined (P_CC_MSVC)
+	P_TEST_CHECK (sizeof (AlignedTestStruct) == P_CACHE_LINE_SIZE);
+	P_TEST_CHECK (((psize) aligned_test_buf & 15) == 0);
+#endif
+
+	AlignedTestStruct *aligned = (AlignedTestStruct *) p_malloc0_aligned (sizeof (AlignedTestStruct) * 2,
+									    P_CACHE_LINE_SIZE);
+	P_TEST_REQUIRE (aligned != NULL);
+	P_TEST_CHECK (((psize) &aligned[1].first & (P_CACHE_LINE_SIZE - 1)) == 0);
+	p_free_aligned (aligned);
+
 	P_WARNING ("Test warning output");
 	P_ERROR ("Test error output");
 	P_DEBUG ("Test debug output");
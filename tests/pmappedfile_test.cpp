@@ -0,0 +1,236 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <stdio.h>
+#include <string.h>
+
+P_TEST_MODULE_INIT ();
+
+#define PMAPPEDFILE_TEST_FILE		"." P_DIR_SEPARATOR "pmappedfile_test_file.bin"
+#define PMAPPEDFILE_TEST_EMPTY_FILE	"." P_DIR_SEPARATOR "pmappedfile_test_empty_file.bin"
+#define PMAPPEDFILE_TEST_SIZE		100000
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static bool create_test_file (const pchar *path, psize size)
+{
+	FILE *file = fopen (path, "wb");
+
+	if (file == NULL)
+		return false;
+
+	for (psize i = 0; i < size; ++i)
+		fputc ((int) (i % 251), file);
+
+	return fclose (file) == 0;
+}
+
+P_TEST_CASE_BEGIN (pmappedfile_nomem_test)
+{
+	p_libsys_init ();
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_REQUIRE (create_test_file (PMAPPEDFILE_TEST_FILE, 1024));
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (p_mapped_file_new (PMAPPEDFILE_TEST_FILE,
+					 P_MAPPED_FILE_ACCESS_READONLY,
+					 NULL) == NULL);
+
+	p_mem_restore_vtable ();
+
+	P_TEST_CHECK (p_file_remove (PMAPPEDFILE_TEST_FILE, NULL) == TRUE);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pmappedfile_bad_input_test)
+{
+	p_libsys_init ();
+
+	PError *error = NULL;
+
+	P_TEST_CHECK (p_mapped_file_new (NULL, P_MAPPED_FILE_ACCESS_READONLY, &error) == NULL);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+	error = NULL;
+
+	P_TEST_CHECK (p_mapped_file_new ("." P_DIR_SEPARATOR "pmappedfile_test_missing.bin",
+					 P_MAPPED_FILE_ACCESS_READONLY,
+					 &error) == NULL);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+
+	P_TEST_CHECK (p_mapped_file_get_address (NULL) == NULL);
+	P_TEST_CHECK (p_mapped_file_get_size (NULL) == 0);
+	P_TEST_CHECK (p_mapped_file_advise (NULL, 0, 0, P_MAPPED_FILE_ADVICE_NORMAL, NULL) == FALSE);
+	P_TEST_CHECK (p_mapped_file_sync (NULL, NULL) == FALSE);
+
+	p_mapped_file_free (NULL);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pmappedfile_general_test)
+{
+	p_libsys_init ();
+
+	P_TEST_REQUIRE (create_test_file (PMAPPEDFILE_TEST_FILE, PMAPPEDFILE_TEST_SIZE));
+
+	PMappedFile *file = p_mapped_file_new (PMAPPEDFILE_TEST_FILE,
+					       P_MAPPED_FILE_ACCESS_READONLY,
+					       NULL);
+	P_TEST_REQUIRE (file != NULL);
+	P_TEST_CHECK (p_mapped_file_get_size (file) == PMAPPEDFILE_TEST_SIZE);
+
+	const puchar *data = (const puchar *) p_mapped_file_get_address (file);
+	P_TEST_REQUIRE (data != NULL);
+
+	P_TEST_CHECK (p_mapped_file_advise (file, 0, 0, P_MAPPED_FILE_ADVICE_SEQUENTIAL, NULL) == TRUE);
+	P_TEST_CHECK (p_mapped_file_advise (file, 0, 0, P_MAPPED_FILE_ADVICE_WILLNEED, NULL) == TRUE);
+
+	bool is_equal = true;
+
+	for (psize i = 0; i < PMAPPEDFILE_TEST_SIZE; ++i) {
+		if (data[i] != (puchar) (i % 251)) {
+			is_equal = false;
+			break;
+		}
+	}
+
+	P_TEST_CHECK (is_equal);
+
+	/* Unaligned ranges and ranges past the end */
+	P_TEST_CHECK (p_mapped_file_advise (file, 1000, 5000, P_MAPPED_FILE_ADVICE_RANDOM, NULL) == TRUE);
+	P_TEST_CHECK (p_mapped_file_advise (file, 5000, PMAPPEDFILE_TEST_SIZE, P_MAPPED_FILE_ADVICE_NORMAL, NULL) == TRUE);
+	P_TEST_CHECK (p_mapped_file_advise (file, PMAPPEDFILE_TEST_SIZE, 0, P_MAPPED_FILE_ADVICE_NORMAL, NULL) == TRUE);
+	P_TEST_CHECK (p_mapped_file_advise (file,
+					    PMAPPEDFILE_TEST_SIZE + 1,
+					    0,
+					    P_MAPPED_FILE_ADVICE_NORMAL,
+					    NULL) == FALSE);
+	P_TEST_CHECK (p_mapped_file_advise (file,
+					    0,
+					    0,
+					    (PMappedFileAdvice) 100,
+					    NULL) == FALSE);
+
+	/* Read-only mappings have nothing to write */
+	P_TEST_CHECK (p_mapped_file_sync (file, NULL) == TRUE);
+
+	p_mapped_file_free (file);
+
+	/* Write through the mapping */
+	file = p_mapped_file_new (PMAPPEDFILE_TEST_FILE, P_MAPPED_FILE_ACCESS_READWRITE, NULL);
+	P_TEST_REQUIRE (file != NULL);
+	P_TEST_CHECK (p_mapped_file_get_size (file) == PMAPPEDFILE_TEST_SIZE);
+
+	puchar *wdata = (puchar *) p_mapped_file_get_address (file);
+	P_TEST_REQUIRE (wdata != NULL);
+
+	memset (wdata, 0x5A, 4096);
+	wdata[PMAPPEDFILE_TEST_SIZE - 1] = 0xA5;
+
+	P_TEST_CHECK (p_mapped_file_sync (file, NULL) == TRUE);
+
+	p_mapped_file_free (file);
+
+	FILE *check_file = fopen (PMAPPEDFILE_TEST_FILE, "rb");
+	P_TEST_REQUIRE (check_file != NULL);
+
+	puchar	buf[4096];
+	size_t	n_read = fread (buf, 1, sizeof (buf), check_file);
+
+	P_TEST_CHECK (n_read == sizeof (buf));
+	P_TEST_CHECK (buf[0] == 0x5A && buf[4095] == 0x5A);
+
+	P_TEST_CHECK (fseek (check_file, PMAPPEDFILE_TEST_SIZE - 1, SEEK_SET) == 0);
+	P_TEST_CHECK (fgetc (check_file) == 0xA5);
+	P_TEST_CHECK (fclose (check_file) == 0);
+
+	P_TEST_CHECK (p_file_remove (PMAPPEDFILE_TEST_FILE, NULL) == TRUE);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pmappedfile_empty_test)
+{
+	p_libsys_init ();
+
+	P_TEST_REQUIRE (create_test_file (PMAPPEDFILE_TEST_EMPTY_FILE, 0));
+
+	PMappedFile *file = p_mapped_file_new (PMAPPEDFILE_TEST_EMPTY_FILE,
+					       P_MAPPED_FILE_ACCESS_READWRITE,
+					       NULL);
+	P_TEST_REQUIRE (file != NULL);
+
+	P_TEST_CHECK (p_mapped_file_get_address (file) == NULL);
+	P_TEST_CHECK (p_mapped_file_get_size (file) == 0);
+	P_TEST_CHECK (p_mapped_file_advise (file, 0, 0, P_MAPPED_FILE_ADVICE_WILLNEED, NULL) == TRUE);
+	P_TEST_CHECK (p_mapped_file_sync (file, NULL) == TRUE);
+
+	p_mapped_file_free (file);
+
+	P_TEST_CHECK (p_file_remove (PMAPPEDFILE_TEST_EMPTY_FILE, NULL) == TRUE);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pmappedfile_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pmappedfile_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (pmappedfile_general_test);
+	P_TEST_SUITE_RUN_CASE (pmappedfile_empty_test);
+}
+P_TEST_SUITE_END()
@@ -0,0 +1,482 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <stdio.h>
+#include <string.h>
+
+P_TEST_MODULE_INIT ();
+
+#define PMAPPEDTABLE_TEST_FILE		"." P_DIR_SEPARATOR "pmappedtable_test_file.bin"
+#define PMAPPEDTABLE_TEST_HASH_SIZE	3000
+#define PMAPPEDTABLE_TEST_TREE_SIZE	5000
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static pint tree_compare (pconstpointer a, pconstpointer b)
+{
+	pint p1 = P_POINTER_TO_INT (a);
+	pint p2 = P_POINTER_TO_INT (b);
+
+	return p1 < p2 ? -1 : (p1 > p2 ? 1 : 0);
+}
+
+/* Big-endian numbers keep the tree order */
+static pconstpointer encode_int (pconstpointer data, psize *length, ppointer user_data)
+{
+	puchar	*buf = (puchar *) user_data;
+	puint32	val  = (puint32) P_POINTER_TO_INT (data);
+
+	buf[0] = (puchar) (val >> 24);
+	buf[1] = (puchar) (val >> 16);
+	buf[2] = (puchar) (val >> 8);
+	buf[3] = (puchar) val;
+
+	*length = 4;
+
+	return buf;
+}
+
+static void make_int_key (puint32 val, puchar *buf)
+{
+	psize length;
+
+	encode_int (P_INT_TO_POINTER (val), &length, buf);
+}
+
+static bool patch_test_file (psize offset, puint64 value)
+{
+	FILE *file = fopen (PMAPPEDTABLE_TEST_FILE, "r+b");
+
+	if (file == NULL)
+		return false;
+
+	bool ret = fseek (file, (long) offset, SEEK_SET) == 0 &&
+		   fwrite (&value, sizeof (value), 1, file) == 1;
+
+	return fclose (file) == 0 && ret;
+}
+
+P_TEST_CASE_BEGIN (pmappedtable_nomem_test)
+{
+	p_libsys_init ();
+
+	PHashTable *table = p_hash_table_new ();
+	P_TEST_REQUIRE (table != NULL);
+
+	p_hash_table_insert (table, (ppointer) "key", (ppointer) "value");
+
+	P_TEST_CHECK (p_mapped_table_write_hash_table (table,
+						       PMAPPEDTABLE_TEST_FILE,
+						       p_mapped_table_encode_str,
+						       p_mapped_table_encode_str,
+						       NULL,
+						       NULL) == TRUE);
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (p_mapped_table_new (PMAPPEDTABLE_TEST_FILE, NULL) == NULL);
+	P_TEST_CHECK (p_mapped_table_write_hash_table (table,
+						       PMAPPEDTABLE_TEST_FILE,
+						       p_mapped_table_encode_str,
+						       p_mapped_table_encode_str,
+						       NULL,
+						       NULL) == FALSE);
+
+	p_mem_restore_vtable ();
+
+	p_hash_table_free (table);
+
+	P_TEST_CHECK (p_file_remove (PMAPPEDTABLE_TEST_FILE, NULL) == TRUE);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pmappedtable_bad_input_test)
+{
+	p_libsys_init ();
+
+	PError *error = NULL;
+
+	PHashTable *table = p_hash_table_new ();
+	PTree      *tree  = p_tree_new (P_TREE_TYPE_RB, tree_compare);
+
+	P_TEST_REQUIRE (table != NULL);
+	P_TEST_REQUIRE (tree != NULL);
+
+	P_TEST_CHECK (p_mapped_table_write_hash_table (NULL,
+						       PMAPPEDTABLE_TEST_FILE,
+						       p_mapped_table_encode_str,
+						       NULL,
+						       NULL,
+						       &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_INVALID_ARGUMENT);
+	p_error_free (error);
+	error = NULL;
+
+	P_TEST_CHECK (p_mapped_table_write_hash_table (table, NULL, p_mapped_table_encode_str, NULL, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_mapped_table_write_hash_table (table, PMAPPEDTABLE_TEST_FILE, NULL, NULL, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_mapped_table_write_tree (NULL, PMAPPEDTABLE_TEST_FILE, p_mapped_table_encode_str, NULL, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_mapped_table_write_tree (tree, NULL, p_mapped_table_encode_str, NULL, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_mapped_table_write_tree (tree, PMAPPEDTABLE_TEST_FILE, NULL, NULL, NULL, NULL) == FALSE);
+
+	P_TEST_CHECK (p_mapped_table_new (NULL, &error) == NULL);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+	error = NULL;
+
+	P_TEST_CHECK (p_mapped_table_new ("." P_DIR_SEPARATOR "pmappedtable_test_missing.bin", &error) == NULL);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+
+	P_TEST_CHECK (p_mapped_table_get_layout (NULL) == P_MAPPED_TABLE_LAYOUT_HASH);
+	P_TEST_CHECK (p_mapped_table_get_size (NULL) == 0);
+	P_TEST_CHECK (p_mapped_table_lookup (NULL, "a", 1, NULL) == NULL);
+	P_TEST_CHECK (p_mapped_table_lower_bound (NULL, "a", 1) == 0);
+	P_TEST_CHECK (p_mapped_table_get_entry (NULL, 0, NULL, NULL, NULL, NULL) == FALSE);
+	psize length = 1;
+
+	P_TEST_CHECK (p_mapped_table_encode_str (NULL, &length, NULL) == NULL);
+	P_TEST_CHECK (length == 0);
+
+	p_mapped_table_free (NULL);
+
+	p_hash_table_free (table);
+	p_tree_free (tree);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pmappedtable_hash_test)
+{
+	p_libsys_init ();
+
+	static pchar	keys[PMAPPEDTABLE_TEST_HASH_SIZE][16];
+	static pchar	values[PMAPPEDTABLE_TEST_HASH_SIZE][32];
+	pconstpointer	key;
+	pconstpointer	value;
+	psize		key_len;
+	psize		value_len;
+	psize		i;
+
+	PHashTable *table = p_hash_table_new ();
+	P_TEST_REQUIRE (table != NULL);
+
+	for (i = 0; i < PMAPPEDTABLE_TEST_HASH_SIZE; ++i) {
+		sprintf (keys[i], "key-%u", (puint) i);
+		sprintf (values[i], i % 10 == 0 ? "" : "value-%u-data", (puint) (i * 7));
+
+		p_hash_table_insert (table, keys[i], values[i]);
+	}
+
+	P_TEST_CHECK (p_mapped_table_write_hash_table (table,
+						       PMAPPEDTABLE_TEST_FILE,
+						       p_mapped_table_encode_str,
+						       p_mapped_table_encode_str,
+						       NULL,
+						       NULL) == TRUE);
+	p_hash_table_free (table);
+
+	PMappedTable *mtable = p_mapped_table_new (PMAPPEDTABLE_TEST_FILE, NULL);
+	P_TEST_REQUIRE (mtable != NULL);
+
+	P_TEST_CHECK (p_mapped_table_get_layout (mtable) == P_MAPPED_TABLE_LAYOUT_HASH);
+	P_TEST_CHECK (p_mapped_table_get_size (mtable) == PMAPPEDTABLE_TEST_HASH_SIZE);
+
+	for (i = 0; i < PMAPPEDTABLE_TEST_HASH_SIZE; ++i) {
+		value = p_mapped_table_lookup (mtable, keys[i], strlen (keys[i]), &value_len);
+
+		P_TEST_REQUIRE (value != NULL);
+		P_TEST_CHECK (value_len == strlen (values[i]));
+
+		/* Values are zero terminated inside the mapping */
+		P_TEST_CHECK (strcmp ((const pchar *) value, values[i]) == 0);
+	}
+
+	P_TEST_CHECK (p_mapped_table_lookup (mtable, "key-", 4, NULL) == NULL);
+	P_TEST_CHECK (p_mapped_table_lookup (mtable, "key-30000", 9, NULL) == NULL);
+	P_TEST_CHECK (p_mapped_table_lookup (mtable, NULL, 0, NULL) == NULL);
+	P_TEST_CHECK (p_mapped_table_lower_bound (mtable, "key-1", 5) == PMAPPEDTABLE_TEST_HASH_SIZE);
+
+	/* Every entry is visited once */
+	psize sum = 0;
+
+	for (i = 0; i < PMAPPEDTABLE_TEST_HASH_SIZE; ++i) {
+		P_TEST_REQUIRE (p_mapped_table_get_entry (mtable, i, &key, &key_len, &value, &value_len) == TRUE);
+		P_TEST_CHECK (key_len == strlen ((const pchar *) key));
+		P_TEST_CHECK (value_len == strlen ((const pchar *) value));
+
+		sum += (psize) atoi ((const pchar *) key + 4);
+	}
+
+	P_TEST_CHECK (sum == (PMAPPEDTABLE_TEST_HASH_SIZE - 1) * PMAPPEDTABLE_TEST_HASH_SIZE / 2);
+	P_TEST_CHECK (p_mapped_table_get_entry (mtable, PMAPPEDTABLE_TEST_HASH_SIZE, &key, NULL, NULL, NULL) == FALSE);
+
+	p_mapped_table_free (mtable);
+
+	/* Keys only */
+	table = p_hash_table_new ();
+	P_TEST_REQUIRE (table != NULL);
+
+	p_hash_table_insert (table, (ppointer) "", NULL);
+	p_hash_table_insert (table, (ppointer) "a", NULL);
+
+	P_TEST_CHECK (p_mapped_table_write_hash_table (table,
+						       PMAPPEDTABLE_TEST_FILE,
+						       p_mapped_table_encode_str,
+						       NULL,
+						       NULL,
+						       NULL) == TRUE);
+	p_hash_table_free (table);
+
+	mtable = p_mapped_table_new (PMAPPEDTABLE_TEST_FILE, NULL);
+	P_TEST_REQUIRE (mtable != NULL);
+
+	P_TEST_CHECK (p_mapped_table_get_size (mtable) == 2);
+
+	value = p_mapped_table_lookup (mtable, NULL, 0, &value_len);
+	P_TEST_CHECK (value != NULL && value_len == 0 && *((const pchar *) value) == '\0');
+
+	value = p_mapped_table_lookup (mtable, "a", 1, &value_len);
+	P_TEST_CHECK (value != NULL && value_len == 0);
+
+	P_TEST_CHECK (p_mapped_table_lookup (mtable, "b", 1, NULL) == NULL);
+
+	p_mapped_table_free (mtable);
+
+	P_TEST_CHECK (p_file_remove (PMAPPEDTABLE_TEST_FILE, NULL) == TRUE);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pmappedtable_tree_test)
+{
+	p_libsys_init ();
+
+	puchar		enc_buf[4];
+	puchar		key_buf[4];
+	pconstpointer	key;
+	pconstpointer	value;
+	psize		key_len;
+	psize		value_len;
+	psize		count;
+	psize		expected;
+	pint		i;
+
+	PTree *tree = p_tree_new (P_TREE_TYPE_AVL, tree_compare);
+	P_TEST_REQUIRE (tree != NULL);
+
+	/* Even numbers only, so the odd ones fall in between */
+	for (i = PMAPPEDTABLE_TEST_TREE_SIZE - 1; i >= 0; --i)
+		p_tree_insert (tree, P_INT_TO_POINTER (i * 2), P_INT_TO_POINTER (i * 3));
+
+	P_TEST_CHECK (p_mapped_table_write_tree (tree,
+						 PMAPPEDTABLE_TEST_FILE,
+						 encode_int,
+						 encode_int,
+						 enc_buf,
+						 NULL) == TRUE);
+
+	PMappedTable *mtable = p_mapped_table_new (PMAPPEDTABLE_TEST_FILE, NULL);
+	P_TEST_REQUIRE (mtable != NULL);
+
+	P_TEST_CHECK (p_mapped_table_get_layout (mtable) == P_MAPPED_TABLE_LAYOUT_TREE);
+	P_TEST_CHECK (p_mapped_table_get_size (mtable) == PMAPPEDTABLE_TEST_TREE_SIZE);
+
+	for (i = 0; i < PMAPPEDTABLE_TEST_TREE_SIZE * 2 + 2; ++i) {
+		make_int_key ((puint32) i, key_buf);
+
+		value = p_mapped_table_lookup (mtable, key_buf, 4, &value_len);
+
+		if (i % 2 == 0 && i < PMAPPEDTABLE_TEST_TREE_SIZE * 2) {
+			P_TEST_REQUIRE (value != NULL);
+			P_TEST_CHECK (value_len == 4);
+
+			make_int_key ((puint32) (i / 2 * 3), key_buf);
+			P_TEST_CHECK (memcmp (value, key_buf, 4) == 0);
+		} else
+			P_TEST_CHECK (value == NULL);
+
+		/* Lower bound of an odd number is the next even one */
+		expected = (psize) (i + 1) / 2;
+
+		if (expected > PMAPPEDTABLE_TEST_TREE_SIZE)
+			expected = PMAPPEDTABLE_TEST_TREE_SIZE;
+
+		make_int_key ((puint32) i, key_buf);
+		P_TEST_CHECK (p_mapped_table_lower_bound (mtable, key_buf, 4) == expected);
+	}
+
+	/* Shorter keys go first on a common prefix */
+	P_TEST_CHECK (p_mapped_table_lower_bound (mtable, NULL, 0) == 0);
+	P_TEST_CHECK (p_mapped_table_lower_bound (mtable, "\0\0\0\0\0", 5) == 1);
+	P_TEST_CHECK (p_mapped_table_lower_bound (mtable, "\xff", 1) == PMAPPEDTABLE_TEST_TREE_SIZE);
+	P_TEST_CHECK (p_mapped_table_lookup (mtable, "\0\0\0", 3, NULL) == NULL);
+
+	/* Entries go in the key order */
+	for (count = 0; count < PMAPPEDTABLE_TEST_TREE_SIZE; ++count) {
+		P_TEST_REQUIRE (p_mapped_table_get_entry (mtable, count, &key, &key_len, &value, &value_len) == TRUE);
+		P_TEST_CHECK (key_len == 4 && value_len == 4);
+
+		make_int_key ((puint32) (count * 2), key_buf);
+		P_TEST_CHECK (memcmp (key, key_buf, 4) == 0);
+	}
+
+	p_mapped_table_free (mtable);
+
+	/* Small and empty trees have no index */
+	p_tree_clear (tree);
+
+	for (i = 0; i < 3; ++i)
+		p_tree_insert (tree, P_INT_TO_POINTER (i), NULL);
+
+	P_TEST_CHECK (p_mapped_table_write_tree (tree, PMAPPEDTABLE_TEST_FILE, encode_int, NULL, enc_buf, NULL) == TRUE);
+
+	mtable = p_mapped_table_new (PMAPPEDTABLE_TEST_FILE, NULL);
+	P_TEST_REQUIRE (mtable != NULL);
+
+	make_int_key (2, key_buf);
+	P_TEST_CHECK (p_mapped_table_lookup (mtable, key_buf, 4, &value_len) != NULL);
+	P_TEST_CHECK (value_len == 0);
+	P_TEST_CHECK (p_mapped_table_lower_bound (mtable, key_buf, 4) == 2);
+
+	p_mapped_table_free (mtable);
+
+	p_tree_clear (tree);
+
+	P_TEST_CHECK (p_mapped_table_write_tree (tree, PMAPPEDTABLE_TEST_FILE, encode_int, NULL, enc_buf, NULL) == TRUE);
+
+	mtable = p_mapped_table_new (PMAPPEDTABLE_TEST_FILE, NULL);
+	P_TEST_REQUIRE (mtable != NULL);
+
+	P_TEST_CHECK (p_mapped_table_get_size (mtable) == 0);
+	P_TEST_CHECK (p_mapped_table_lookup (mtable, key_buf, 4, NULL) == NULL);
+	P_TEST_CHECK (p_mapped_table_lower_bound (mtable, key_buf, 4) == 0);
+	P_TEST_CHECK (p_mapped_table_get_entry (mtable, 0, &key, NULL, NULL, NULL) == FALSE);
+
+	p_mapped_table_free (mtable);
+	p_tree_free (tree);
+
+	P_TEST_CHECK (p_file_remove (PMAPPEDTABLE_TEST_FILE, NULL) == TRUE);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pmappedtable_damaged_test)
+{
+	p_libsys_init ();
+
+	PError *error = NULL;
+
+	PHashTable *table = p_hash_table_new ();
+	P_TEST_REQUIRE (table != NULL);
+
+	p_hash_table_insert (table, (ppointer) "key", (ppointer) "value");
+
+	P_TEST_CHECK (p_mapped_table_write_hash_table (table,
+						       PMAPPEDTABLE_TEST_FILE,
+						       p_mapped_table_encode_str,
+						       p_mapped_table_encode_str,
+						       NULL,
+						       NULL) == TRUE);
+
+	PMappedTable *mtable = p_mapped_table_new (PMAPPEDTABLE_TEST_FILE, NULL);
+	P_TEST_REQUIRE (mtable != NULL);
+	p_mapped_table_free (mtable);
+
+	/* Number of entries beyond the file */
+	P_TEST_REQUIRE (patch_test_file (24, P_MAXUINT32));
+	P_TEST_CHECK (p_mapped_table_new (PMAPPEDTABLE_TEST_FILE, &error) == NULL);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_INVALID_ARGUMENT);
+	p_error_free (error);
+	error = NULL;
+
+	/* Byte order */
+	P_TEST_CHECK (p_mapped_table_write_hash_table (table,
+						       PMAPPEDTABLE_TEST_FILE,
+						       p_mapped_table_encode_str,
+						       p_mapped_table_encode_str,
+						       NULL,
+						       NULL) == TRUE);
+	P_TEST_REQUIRE (patch_test_file (8, 0x0403020100000001ULL));
+	P_TEST_CHECK (p_mapped_table_new (PMAPPEDTABLE_TEST_FILE, &error) == NULL);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_NOT_SUPPORTED);
+	p_error_free (error);
+	error = NULL;
+
+	/* Not a table at all */
+	P_TEST_REQUIRE (patch_test_file (0, 0));
+	P_TEST_CHECK (p_mapped_table_new (PMAPPEDTABLE_TEST_FILE, &error) == NULL);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+
+	p_hash_table_free (table);
+
+	P_TEST_CHECK (p_file_remove (PMAPPEDTABLE_TEST_FILE, NULL) == TRUE);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pmappedtable_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pmappedtable_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (pmappedtable_hash_test);
+	P_TEST_SUITE_RUN_CASE (pmappedtable_tree_test);
+	P_TEST_SUITE_RUN_CASE (pmappedtable_damaged_test);
+}
+P_TEST_SUITE_END()
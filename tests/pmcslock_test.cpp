@@ -0,0 +1,176 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+P_TEST_MODULE_INIT ();
+
+#define PMCSLOCK_THREADS	4
+#define PMCSLOCK_ROUNDS	50000
+
+static PMCSLock *	global_mcs_lock  = NULL;
+static pint		mcs_lock_counter = 0;
+static volatile pint	mcs_lock_inside  = 0;
+static volatile pint	mcs_lock_overlap = 0;
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static void * mcs_lock_test_thread (void *)
+{
+	PMCSLockNode	node;
+	pint		i;
+
+	for (i = 0; i < PMCSLOCK_ROUNDS; ++i) {
+		if (!p_mcs_lock_trylock (global_mcs_lock, &node)) {
+			if (!p_mcs_lock_lock (global_mcs_lock, &node))
+				p_uthread_exit (1);
+		}
+
+		if (p_atomic_int_add (&mcs_lock_inside, 1) != 0)
+			p_atomic_int_inc (&mcs_lock_overlap);
+
+		++mcs_lock_counter;
+
+		p_atomic_int_add (&mcs_lock_inside, -1);
+
+		if (!p_mcs_lock_unlock (global_mcs_lock, &node))
+			p_uthread_exit (1);
+	}
+
+	p_uthread_exit (0);
+
+	return NULL;
+}
+
+P_TEST_CASE_BEGIN (pmcslock_nomem_test)
+{
+	p_libsys_init ();
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+	P_TEST_CHECK (p_mcs_lock_new () == NULL);
+
+	p_mem_restore_vtable ();
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pmcslock_bad_input_test)
+{
+	p_libsys_init ();
+
+	PMCSLockNode node;
+
+	P_TEST_REQUIRE (p_mcs_lock_lock (NULL, NULL) == FALSE);
+	P_TEST_REQUIRE (p_mcs_lock_unlock (NULL, NULL) == FALSE);
+	P_TEST_REQUIRE (p_mcs_lock_trylock (NULL, NULL) == FALSE);
+	P_TEST_REQUIRE (p_mcs_lock_lock (NULL, &node) == FALSE);
+	P_TEST_REQUIRE (p_mcs_lock_unlock (NULL, &node) == FALSE);
+	P_TEST_REQUIRE (p_mcs_lock_trylock (NULL, &node) == FALSE);
+	p_mcs_lock_free (NULL);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pmcslock_general_test)
+{
+	PMCSLockNode	node;
+	PMCSLockNode	other_node;
+	PUThread	*thr[PMCSLOCK_THREADS];
+	pint		i;
+
+	p_libsys_init ();
+
+	global_mcs_lock = p_mcs_lock_new ();
+	P_TEST_REQUIRE (global_mcs_lock != NULL);
+
+	P_TEST_REQUIRE (p_mcs_lock_lock (global_mcs_lock, NULL) == FALSE);
+	P_TEST_REQUIRE (p_mcs_lock_trylock (global_mcs_lock, NULL) == FALSE);
+	P_TEST_REQUIRE (p_mcs_lock_unlock (global_mcs_lock, NULL) == FALSE);
+
+	P_TEST_CHECK (p_mcs_lock_trylock (global_mcs_lock, &node) == TRUE);
+	P_TEST_CHECK (p_mcs_lock_trylock (global_mcs_lock, &other_node) == FALSE);
+	P_TEST_CHECK (p_mcs_lock_unlock (global_mcs_lock, &node) == TRUE);
+	P_TEST_CHECK (p_mcs_lock_lock (global_mcs_lock, &node) == TRUE);
+	P_TEST_CHECK (p_mcs_lock_trylock (global_mcs_lock, &other_node) == FALSE);
+	P_TEST_CHECK (p_mcs_lock_unlock (global_mcs_lock, &node) == TRUE);
+
+	mcs_lock_counter = 0;
+	p_atomic_int_set (&mcs_lock_inside, 0);
+	p_atomic_int_set (&mcs_lock_overlap, 0);
+
+	for (i = 0; i < PMCSLOCK_THREADS; ++i) {
+		thr[i] = p_uthread_create ((PUThreadFunc) mcs_lock_test_thread, NULL, TRUE, NULL);
+		P_TEST_REQUIRE (thr[i] != NULL);
+	}
+
+	for (i = 0; i < PMCSLOCK_THREADS; ++i) {
+		P_TEST_CHECK (p_uthread_join (thr[i]) == 0);
+		p_uthread_unref (thr[i]);
+	}
+
+	P_TEST_CHECK (mcs_lock_counter == PMCSLOCK_THREADS * PMCSLOCK_ROUNDS);
+	P_TEST_CHECK (p_atomic_int_get (&mcs_lock_overlap) == 0);
+
+	P_TEST_CHECK (p_mcs_lock_trylock (global_mcs_lock, &node) == TRUE);
+	P_TEST_CHECK (p_mcs_lock_unlock (global_mcs_lock, &node) == TRUE);
+
+	p_mcs_lock_free (global_mcs_lock);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pmcslock_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pmcslock_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (pmcslock_general_test);
+}
+P_TEST_SUITE_END()
@@ -163,9 +163,862 @@ P_TEST_CASE_BEGIN (pmem_general_test)
 }
 P_TEST_CASE_END ()
 
+extern "C" ppointer pmem_alloc_nomem (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return NULL;
+}
+
+extern "C" ppointer pmem_realloc_nomem (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return NULL;
+}
+
+extern "C" void pmem_free_nomem (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+P_TEST_CASE_BEGIN (pmem_arena_test)
+{
+	PMemVTable	vtable;
+	PMemArena	*arena;
+	PMemArena	*inner_arena;
+	PList		*list;
+	PList		*iter;
+	ppointer	ptr;
+	ppointer	first_ptr;
+	ppointer	ext_ptr;
+	pchar		*str;
+	pint		i;
+
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_mem_arena_alloc (NULL, 10) == NULL);
+	P_TEST_CHECK (p_mem_arena_install (NULL) == FALSE);
+	P_TEST_CHECK (p_mem_arena_uninstall (NULL) == FALSE);
+	p_mem_arena_reset (NULL);
+	p_mem_arena_free (NULL);
+
+	vtable.free    = pmem_free_nomem;
+	vtable.malloc  = pmem_alloc_nomem;
+	vtable.realloc = pmem_realloc_nomem;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+	P_TEST_CHECK (p_mem_arena_new (0, FALSE) == NULL);
+	p_mem_restore_vtable ();
+
+	/* Chunks are taken from the table captured at creation */
+	arena = p_mem_arena_new (0, FALSE);
+	P_TEST_REQUIRE (arena != NULL);
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+	P_TEST_CHECK (p_mem_arena_alloc (arena, 100) != NULL);
+	p_mem_restore_vtable ();
+
+	P_TEST_CHECK (p_mem_arena_alloc (arena, 0) == NULL);
+
+	first_ptr = NULL;
+
+	for (i = 1; i < 10000; ++i) {
+		ptr = p_mem_arena_alloc (arena, (psize) (i % 67 + 1));
+
+		P_TEST_REQUIRE (ptr != NULL);
+		P_TEST_CHECK (((psize) ptr) % 16 == 0);
+
+		memset (ptr, 0xAB, (psize) (i % 67 + 1));
+	}
+
+	for (i = 0; i < 10; ++i) {
+		ptr = p_mem_arena_alloc (arena, 100000);
+
+		P_TEST_REQUIRE (ptr != NULL);
+		P_TEST_CHECK (((psize) ptr) % 16 == 0);
+
+		memset (ptr, 0xCD, 100000);
+	}
+
+	/* The first block after the reset reuses the first chunk */
+	p_mem_arena_reset (arena);
+	first_ptr = p_mem_arena_alloc (arena, 32);
+	P_TEST_CHECK (first_ptr != NULL);
+
+	p_mem_arena_reset (arena);
+	P_TEST_CHECK (p_mem_arena_alloc (arena, 32) == first_ptr);
+
+	p_mem_arena_free (arena);
+
+	/* Chunks can be mapped, the table doesn't matter then */
+	arena = p_mem_arena_new (4096, TRUE);
+	P_TEST_REQUIRE (arena != NULL);
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	for (i = 0; i < 1000; ++i) {
+		ptr = p_mem_arena_alloc (arena, 48);
+
+		P_TEST_REQUIRE (ptr != NULL);
+		memset (ptr, 0xEF, 48);
+	}
+
+	P_TEST_CHECK (p_mem_arena_alloc (arena, 10000) != NULL);
+
+	p_mem_restore_vtable ();
+	p_mem_arena_free (arena);
+
+	/* Installed arena serves the library itself */
+	arena = p_mem_arena_new (0, FALSE);
+	P_TEST_REQUIRE (arena != NULL);
+
+	ext_ptr = p_malloc (64);
+	P_TEST_REQUIRE (ext_ptr != NULL);
+	memset (ext_ptr, 0x11, 64);
+
+	P_TEST_CHECK (p_mem_arena_install (arena) == TRUE);
+	P_TEST_CHECK (p_mem_arena_install (arena) == FALSE);
+
+	list = NULL;
+
+	for (i = 0; i < 1000; ++i)
+		list = p_list_append (list, PINT_TO_POINTER (i));
+
+	P_TEST_CHECK (p_list_length (list) == 1000);
+
+	i = 0;
+
+	for (iter = list; iter != NULL; iter = iter->next, ++i)
+		P_TEST_CHECK (PPOINTER_TO_INT (iter->data) == i);
+
+	str = p_strdup ("arena string");
+	P_TEST_REQUIRE (str != NULL);
+	P_TEST_CHECK (strcmp (str, "arena string") == 0);
+
+	/* The last block is rolled back */
+	ptr = p_malloc (100);
+	P_TEST_REQUIRE (ptr != NULL);
+	p_free (ptr);
+	P_TEST_CHECK (p_malloc (100) == ptr);
+
+	/* The last block grows in place, others are copied */
+	memset (ptr, 0x22, 100);
+	P_TEST_CHECK (p_realloc (ptr, 200) == ptr);
+
+	first_ptr = p_realloc (str, 1000);
+	P_TEST_REQUIRE (first_ptr != NULL);
+	P_TEST_CHECK (first_ptr != str);
+	P_TEST_CHECK (strcmp ((const pchar *) first_ptr, "arena string") == 0);
+
+	/* Blocks from before the installation go to the previous table */
+	ext_ptr = p_realloc (ext_ptr, 128);
+	P_TEST_REQUIRE (ext_ptr != NULL);
+	P_TEST_CHECK (((puchar *) ext_ptr)[63] == 0x11);
+
+	/* Nested arena */
+	inner_arena = p_mem_arena_new (1024, FALSE);
+	P_TEST_REQUIRE (inner_arena != NULL);
+
+	P_TEST_CHECK (p_mem_arena_install (inner_arena) == TRUE);
+	P_TEST_CHECK (p_mem_arena_uninstall (arena) == FALSE);
+
+	ptr = p_malloc (10);
+	P_TEST_CHECK (ptr != NULL);
+	P_TEST_CHECK (p_malloc (5000) != NULL);
+	p_free (str);
+
+	P_TEST_CHECK (p_mem_arena_uninstall (inner_arena) == TRUE);
+	P_TEST_CHECK (p_mem_arena_uninstall (inner_arena) == FALSE);
+	p_mem_arena_free (inner_arena);
+
+	p_free (first_ptr);
+
+	p_mem_arena_free (arena);
+	P_TEST_CHECK (p_mem_arena_uninstall (arena) == TRUE);
+
+	p_free (ext_ptr);
+	p_mem_arena_free (arena);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+#ifdef PLIBSYS_MEM_STATS
+static pint trace_alloc_counter   = 0;
+static pint trace_realloc_counter = 0;
+static pint trace_free_counter    = 0;
+
+extern "C" void pmem_trace (PMemTraceEvent	event,
+			    pconstpointer	old_mem,
+			    pconstpointer	mem,
+			    psize		n_bytes,
+			    const pchar		*module,
+			    ppointer		user_data)
+{
+	P_UNUSED (old_mem);
+	P_UNUSED (mem);
+	P_UNUSED (n_bytes);
+	P_UNUSED (module);
+
+	if (user_data != &trace_alloc_counter)
+		return;
+
+	switch (event) {
+	case P_MEM_TRACE_EVENT_ALLOC:
+		++trace_alloc_counter;
+		break;
+	case P_MEM_TRACE_EVENT_REALLOC:
+		++trace_realloc_counter;
+		break;
+	case P_MEM_TRACE_EVENT_FREE:
+		++trace_free_counter;
+		break;
+	}
+}
+#endif
+
+P_TEST_CASE_BEGIN (pmem_stats_test)
+{
+	PMemStats	stats;
+
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_mem_stats_get (NULL) == FALSE);
+	P_TEST_CHECK (p_mem_stats_get_module (-1, &stats) == NULL);
+
+#ifdef PLIBSYS_MEM_STATS
+	PMemStats	before;
+	PMemStats	module_stats;
+	PMemVTable	vtable;
+	PList		*list;
+	ppointer	ptr;
+	const pchar	*name;
+	pint		i;
+	pboolean	found;
+
+	p_mem_stats_reset ();
+
+	P_TEST_REQUIRE (p_mem_stats_get (&before) == TRUE);
+	P_TEST_CHECK (before.alloc_calls == 0);
+	P_TEST_CHECK (before.bytes_peak == before.bytes_live);
+
+	ptr = p_malloc (100);
+	P_TEST_REQUIRE (ptr != NULL);
+
+	P_TEST_CHECK (p_mem_stats_get (&stats) == TRUE);
+	P_TEST_CHECK (stats.alloc_calls == 1);
+	P_TEST_CHECK (stats.bytes_live == before.bytes_live + 100);
+	P_TEST_CHECK (stats.size_classes[3] == 1);
+
+	ptr = p_realloc (ptr, 300);
+	P_TEST_REQUIRE (ptr != NULL);
+
+	P_TEST_CHECK (p_mem_stats_get (&stats) == TRUE);
+	P_TEST_CHECK (stats.realloc_calls == 1);
+	P_TEST_CHECK (stats.bytes_live == before.bytes_live + 300);
+	P_TEST_CHECK (stats.size_classes[5] == 1);
+
+	p_free (ptr);
+
+	P_TEST_CHECK (p_mem_stats_get (&stats) == TRUE);
+	P_TEST_CHECK (stats.free_calls == 1);
+	P_TEST_CHECK (stats.bytes_live == before.bytes_live);
+	P_TEST_CHECK (stats.bytes_peak == before.bytes_live + 300);
+
+	/* The application itself is module 0 */
+	P_TEST_CHECK (p_mem_stats_get_modules () >= 1);
+	name = p_mem_stats_get_module (0, &module_stats);
+	P_TEST_REQUIRE (name != NULL);
+	P_TEST_CHECK (strcmp (name, "application") == 0);
+	P_TEST_CHECK (module_stats.alloc_calls == 1);
+	P_TEST_CHECK (p_mem_stats_get_module (p_mem_stats_get_modules (), &stats) == NULL);
+
+	/* List items are allocated inside the library */
+	list = p_list_append (NULL, PINT_TO_POINTER (10));
+	P_TEST_REQUIRE (list != NULL);
+
+	found = FALSE;
+
+	for (i = 1; i < p_mem_stats_get_modules (); ++i) {
+		name = p_mem_stats_get_module (i, &module_stats);
+		P_TEST_REQUIRE (name != NULL);
+
+		if (strcmp (name, "plist.c") == 0) {
+			P_TEST_CHECK (module_stats.alloc_calls >= 1);
+			P_TEST_CHECK (module_stats.bytes_live >= sizeof (PList));
+			found = TRUE;
+		}
+	}
+
+	P_TEST_CHECK (found == TRUE);
+
+	p_list_free (list);
+
+	/* Failures are counted too */
+	vtable.free    = pmem_free_nomem;
+	vtable.malloc  = pmem_alloc_nomem;
+	vtable.realloc = pmem_realloc_nomem;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+	P_TEST_CHECK (p_malloc (10) == NULL);
+	p_mem_restore_vtable ();
+
+	P_TEST_CHECK (p_mem_stats_get (&stats) == TRUE);
+	P_TEST_CHECK (stats.failed_calls == 1);
+
+	/* Tracing */
+	P_TEST_CHECK (p_mem_stats_set_trace_func (pmem_trace, &trace_alloc_counter) == TRUE);
+
+	ptr = p_malloc0 (10);
+	ptr = p_realloc (ptr, 20);
+	p_free (ptr);
+
+	P_TEST_CHECK (p_mem_stats_set_trace_func (NULL, NULL) == TRUE);
+
+	P_TEST_CHECK (trace_alloc_counter == 1);
+	P_TEST_CHECK (trace_realloc_counter == 1);
+	P_TEST_CHECK (trace_free_counter == 1);
+#else
+	P_TEST_CHECK (p_mem_stats_get (&stats) == FALSE);
+	P_TEST_CHECK (p_mem_stats_get_modules () == 0);
+	P_TEST_CHECK (p_mem_stats_get_module (0, &stats) == NULL);
+	P_TEST_CHECK (p_mem_stats_set_trace_func (NULL, NULL) == FALSE);
+	p_mem_stats_reset ();
+#endif
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pmem_mmap_full_test)
+{
+	PError		*error;
+	ppointer	ptr;
+	psize		page_size;
+	psize		huge_page_size;
+	psize		map_size;
+
+	p_libsys_init ();
+
+	error = NULL;
+
+	P_TEST_CHECK (p_mem_mmap_full (0, P_MEM_MAP_FLAG_NONE, &page_size, &error) == NULL);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+
+	/* Default pages */
+	page_size = 0;
+	ptr       = p_mem_mmap_full (100000, P_MEM_MAP_FLAG_NONE, &page_size, NULL);
+
+	P_TEST_REQUIRE (ptr != NULL);
+	P_TEST_CHECK (page_size > 0);
+	P_TEST_CHECK ((page_size & (page_size - 1)) == 0);
+
+	memset (ptr, 0xAB, 100000);
+	P_TEST_CHECK (p_mem_munmap (ptr, 100000, NULL) == TRUE);
+
+	/* Transparent huge pages are just a hint */
+	huge_page_size = 0;
+	ptr            = p_mem_mmap_full (4 * 1024 * 1024,
+					  P_MEM_MAP_FLAG_TRANSPARENT_HUGE_PAGES,
+					  &huge_page_size,
+					  NULL);
+
+	P_TEST_REQUIRE (ptr != NULL);
+	P_TEST_CHECK (huge_page_size == page_size);
+
+	memset (ptr, 0xCD, 4 * 1024 * 1024);
+	P_TEST_CHECK (p_mem_munmap (ptr, 4 * 1024 * 1024, NULL) == TRUE);
+
+	/* Explicit huge pages may be not reserved, the fallback always works */
+	huge_page_size = 0;
+	ptr            = p_mem_mmap_full (100000,
+					  P_MEM_MAP_FLAG_HUGE_PAGES | P_MEM_MAP_FLAG_FALLBACK,
+					  &huge_page_size,
+					  NULL);
+
+	P_TEST_REQUIRE (ptr != NULL);
+	P_TEST_CHECK (huge_page_size >= page_size);
+
+	map_size = (100000 + huge_page_size - 1) / huge_page_size * huge_page_size;
+
+	memset (ptr, 0xEF, 100000);
+	P_TEST_CHECK (p_mem_munmap (ptr, map_size, NULL) == TRUE);
+
+	error = NULL;
+	ptr   = p_mem_mmap_full (100000, P_MEM_MAP_FLAG_HUGE_PAGES, &huge_page_size, &error);
+
+	if (ptr == NULL) {
+		P_TEST_CHECK (error != NULL);
+		p_error_free (error);
+	} else {
+		P_TEST_CHECK (huge_page_size > page_size);
+
+		map_size = (100000 + huge_page_size - 1) / huge_page_size * huge_page_size;
+
+		memset (ptr, 0x12, map_size);
+		P_TEST_CHECK (p_mem_munmap (ptr, map_size, NULL) == TRUE);
+	}
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+static pint aligned_alloc_counter = 0;
+static pint aligned_free_counter  = 0;
+
+extern "C" ppointer pmem_alloc_aligned (psize nbytes, psize alignment)
+{
+	pchar	*block;
+	psize	addr;
+
+	++aligned_alloc_counter;
+
+	if ((block = (pchar *) malloc (nbytes + alignment + sizeof (ppointer))) == NULL)
+		return NULL;
+
+	addr = ((psize) (block + sizeof (ppointer)) + alignment - 1) & ~(alignment - 1);
+
+	((ppointer *) addr)[-1] = block;
+
+	return (ppointer) addr;
+}
+
+extern "C" void pmem_free_aligned (ppointer block)
+{
+	++aligned_free_counter;
+	free (((ppointer *) block)[-1]);
+}
+
+P_TEST_CASE_BEGIN (pmem_aligned_test)
+{
+	PMemVTable		vtable;
+	PMemAlignedVTable	aligned_vtable;
+	PSpinLock		*spinlock;
+	PRWLock			*rwlock;
+	ppointer		ptr;
+	psize			alignment;
+	pint			i;
+
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_malloc_aligned (0, 16) == NULL);
+	P_TEST_CHECK (p_malloc_aligned (16, 0) == NULL);
+	P_TEST_CHECK (p_malloc_aligned (16, 24) == NULL);
+	P_TEST_CHECK (p_malloc0_aligned (0, 16) == NULL);
+	p_free_aligned (NULL);
+
+	aligned_vtable.malloc_aligned = NULL;
+	aligned_vtable.free_aligned   = NULL;
+
+	P_TEST_CHECK (p_mem_set_aligned_vtable (&aligned_vtable) == FALSE);
+
+	for (alignment = 1; alignment <= 4096; alignment *= 2) {
+		for (i = 1; i < 300; i += 37) {
+			ptr = p_malloc0_aligned ((psize) i, alignment);
+
+			P_TEST_REQUIRE (ptr != NULL);
+			P_TEST_CHECK (((psize) ptr) % alignment == 0);
+			P_TEST_CHECK (((psize) ptr) % sizeof (ppointer) == 0);
+			P_TEST_CHECK (((puchar *) ptr)[0] == 0 && ((puchar *) ptr)[i - 1] == 0);
+
+			memset (ptr, 0xAB, (psize) i);
+			p_free_aligned (ptr);
+		}
+	}
+
+	/* The default routines go through the memory table */
+	vtable.free    = pmem_free_nomem;
+	vtable.malloc  = pmem_alloc_nomem;
+	vtable.realloc = pmem_realloc_nomem;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+	P_TEST_CHECK (p_malloc_aligned (64, 64) == NULL);
+	P_TEST_CHECK (p_spinlock_new () == NULL);
+	P_TEST_CHECK (p_rwlock_new () == NULL);
+	p_mem_restore_vtable ();
+
+	/* Custom routines get the rounded size */
+	aligned_vtable.malloc_aligned = pmem_alloc_aligned;
+	aligned_vtable.free_aligned   = pmem_free_aligned;
+
+	P_TEST_CHECK (p_mem_set_aligned_vtable (&aligned_vtable) == TRUE);
+
+	ptr = p_malloc_aligned (10, 128);
+	P_TEST_REQUIRE (ptr != NULL);
+	P_TEST_CHECK (((psize) ptr) % 128 == 0);
+	memset (ptr, 0xCD, 128);
+	p_free_aligned (ptr);
+
+	P_TEST_CHECK (aligned_alloc_counter == 1);
+	P_TEST_CHECK (aligned_free_counter == 1);
+
+	P_TEST_CHECK (p_mem_set_aligned_vtable (NULL) == TRUE);
+
+	ptr = p_malloc_aligned (10, 128);
+	P_TEST_REQUIRE (ptr != NULL);
+	p_free_aligned (ptr);
+
+	P_TEST_CHECK (aligned_alloc_counter == 1);
+
+	/* Contended primitives sit on their own cache lines */
+	spinlock = p_spinlock_new ();
+	rwlock   = p_rwlock_new ();
+
+	P_TEST_REQUIRE (spinlock != NULL);
+	P_TEST_REQUIRE (rwlock != NULL);
+
+	P_TEST_CHECK (((psize) spinlock) % P_MEM_CACHE_LINE_SIZE == 0);
+	P_TEST_CHECK (((psize) rwlock) % P_MEM_CACHE_LINE_SIZE == 0);
+
+	p_spinlock_free (spinlock);
+	p_rwlock_free (rwlock);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+static pint calloc_counter = 0;
+
+extern "C" ppointer pmem_calloc (psize nblocks, psize nbytes)
+{
+	++calloc_counter;
+	return (ppointer) calloc (nblocks, nbytes);
+}
+
+P_TEST_CASE_BEGIN (pmem_calloc_test)
+{
+	PMemVTable	vtable;
+	PMemArena	*arena;
+	puchar		*ptr;
+	psize		i;
+	pboolean	is_zeroed;
+
+	p_libsys_init ();
+
+	/* Large blocks from the system calloc() */
+	ptr = (puchar *) p_malloc0 (16 * 1024 * 1024);
+	P_TEST_REQUIRE (ptr != NULL);
+
+	is_zeroed = TRUE;
+
+	for (i = 0; i < 16 * 1024 * 1024; i += 4096)
+		is_zeroed = is_zeroed && ptr[i] == 0;
+
+	P_TEST_CHECK (is_zeroed == TRUE);
+	p_free (ptr);
+
+	p_mem_set_calloc (pmem_calloc);
+
+	ptr = (puchar *) p_malloc0 (100);
+	P_TEST_REQUIRE (ptr != NULL);
+	P_TEST_CHECK (ptr[0] == 0 && ptr[99] == 0);
+	p_free (ptr);
+
+	P_TEST_CHECK (calloc_counter == 1);
+
+	/* Custom tables reset the routine */
+	alloc_counter = 0;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	ptr = (puchar *) p_malloc0 (100);
+	P_TEST_REQUIRE (ptr != NULL);
+	P_TEST_CHECK (ptr[0] == 0 && ptr[99] == 0);
+	p_free (ptr);
+
+	P_TEST_CHECK (calloc_counter == 1);
+	P_TEST_CHECK (alloc_counter == 1);
+
+	p_mem_set_calloc (pmem_calloc);
+
+	ptr = (puchar *) p_malloc0 (100);
+	P_TEST_REQUIRE (ptr != NULL);
+	p_free (ptr);
+
+	P_TEST_CHECK (calloc_counter == 2);
+	P_TEST_CHECK (alloc_counter == 1);
+
+	/* Installed arena clears the reused blocks itself */
+	arena = p_mem_arena_new (0, FALSE);
+	P_TEST_REQUIRE (arena != NULL);
+
+	P_TEST_CHECK (p_mem_arena_install (arena) == TRUE);
+
+	ptr = (puchar *) p_malloc (100);
+	P_TEST_REQUIRE (ptr != NULL);
+	memset (ptr, 0xAB, 100);
+
+	p_mem_arena_reset (arena);
+
+	ptr = (puchar *) p_malloc0 (100);
+	P_TEST_REQUIRE (ptr != NULL);
+	P_TEST_CHECK (ptr[0] == 0 && ptr[99] == 0);
+
+	P_TEST_CHECK (calloc_counter == 2);
+	P_TEST_CHECK (p_mem_arena_uninstall (arena) == TRUE);
+	p_mem_arena_free (arena);
+
+	ptr = (puchar *) p_malloc0 (100);
+	P_TEST_REQUIRE (ptr != NULL);
+	p_free (ptr);
+
+	P_TEST_CHECK (calloc_counter == 3);
+
+	p_mem_set_calloc (NULL);
+
+	ptr = (puchar *) p_malloc0 (100);
+	P_TEST_REQUIRE (ptr != NULL);
+	P_TEST_CHECK (ptr[0] == 0 && ptr[99] == 0);
+	p_free (ptr);
+
+	P_TEST_CHECK (calloc_counter == 3);
+
+	p_mem_restore_vtable ();
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pmem_advise_test)
+{
+	PError		*error;
+	pchar		*ptr;
+	psize		page_size;
+	psize		map_size;
+	pboolean	is_locked;
+
+	p_libsys_init ();
+
+	error = NULL;
+
+	P_TEST_CHECK (p_mem_advise (NULL, 4096, P_MEM_ADVICE_NORMAL, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+	error = NULL;
+
+	P_TEST_CHECK (p_mem_prefault (NULL, 4096, NULL) == FALSE);
+	P_TEST_CHECK (p_mem_lock (NULL, 4096, NULL) == FALSE);
+	P_TEST_CHECK (p_mem_unlock (NULL, 4096, NULL) == FALSE);
+
+	map_size = 256 * 1024;
+	ptr      = (pchar *) p_mem_mmap_full (map_size, P_MEM_MAP_FLAG_NONE, &page_size, NULL);
+
+	P_TEST_REQUIRE (ptr != NULL);
+
+	P_TEST_CHECK (p_mem_advise (ptr, 0, P_MEM_ADVICE_NORMAL, NULL) == FALSE);
+	P_TEST_CHECK (p_mem_advise (ptr, map_size, (PMemAdvice) 100, NULL) == FALSE);
+
+	P_TEST_CHECK (p_mem_advise (ptr, map_size, P_MEM_ADVICE_SEQUENTIAL, NULL) == TRUE);
+	P_TEST_CHECK (p_mem_advise (ptr, map_size, P_MEM_ADVICE_RANDOM, NULL) == TRUE);
+	P_TEST_CHECK (p_mem_advise (ptr, map_size, P_MEM_ADVICE_WILLNEED, NULL) == TRUE);
+	P_TEST_CHECK (p_mem_advise (ptr, map_size, P_MEM_ADVICE_NORMAL, NULL) == TRUE);
+
+	/* Prefaulting keeps the contents, unaligned regions are extended */
+	memset (ptr, 0x5A, map_size);
+
+	P_TEST_CHECK (p_mem_prefault (ptr + 100, map_size - 200, NULL) == TRUE);
+	P_TEST_CHECK (ptr[0] == 0x5A && ptr[100] == 0x5A && ptr[map_size - 1] == 0x5A);
+	P_TEST_CHECK (p_mem_prefault (ptr, map_size, NULL) == TRUE);
+	P_TEST_CHECK (ptr[page_size] == 0x5A);
+
+	/* Locking may be limited by the system */
+	is_locked = p_mem_lock (ptr + 10, page_size, &error);
+
+	if (is_locked) {
+		P_TEST_CHECK (error == NULL);
+		P_TEST_CHECK (p_mem_unlock (ptr + 10, page_size, NULL) == TRUE);
+	} else {
+		P_TEST_CHECK (error != NULL);
+		p_error_free (error);
+	}
+
+	/* Unused pages go back to the system */
+	P_TEST_CHECK (p_mem_advise (ptr, map_size, P_MEM_ADVICE_DONTNEED, NULL) == TRUE);
+
+	memset (ptr, 0x33, map_size);
+	P_TEST_CHECK (p_mem_munmap (ptr, map_size, NULL) == TRUE);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+static ppointer pmem_thread_vtable_func (ppointer data)
+{
+	PMemVTable	vtable;
+	ppointer	ptr;
+	pint		result = 0;
+
+	P_UNUSED (data);
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	if (p_mem_push_thread_vtable (&vtable) == FALSE)
+		p_uthread_exit (-1);
+
+	ptr = p_malloc0 (100);
+	ptr = p_realloc (ptr, 200);
+	p_free (ptr);
+
+	if (p_mem_pop_thread_vtable () == FALSE)
+		p_uthread_exit (-1);
+
+	if (alloc_counter == 1 && realloc_counter == 1 && free_counter == 1)
+		result = 1;
+
+	/* Back to the process-wide table */
+	p_free (p_malloc (100));
+
+	if (alloc_counter != 1 || free_counter != 1)
+		result = 0;
+
+	p_uthread_exit (result);
+
+	return NULL;
+}
+
+P_TEST_CASE_BEGIN (pmem_thread_vtable_test)
+{
+	PMemVTable	vtable;
+	PUThread	*thread;
+	ppointer	ptr;
+	pint		i;
+
+	p_libsys_init ();
+
+	vtable.free    = NULL;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_push_thread_vtable (NULL) == FALSE);
+	P_TEST_CHECK (p_mem_push_thread_vtable (&vtable) == FALSE);
+	P_TEST_CHECK (p_mem_pop_thread_vtable () == FALSE);
+
+	vtable.free = pmem_free;
+
+	alloc_counter   = 0;
+	realloc_counter = 0;
+	free_counter    = 0;
+
+	/* Nested tables */
+	P_TEST_REQUIRE (p_mem_push_thread_vtable (&vtable) == TRUE);
+
+	ptr = p_malloc (64);
+	P_TEST_CHECK (ptr != NULL);
+	P_TEST_CHECK (alloc_counter == 1);
+
+	for (i = 1; i < 8; ++i)
+		P_TEST_CHECK (p_mem_push_thread_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (p_mem_push_thread_vtable (&vtable) == FALSE);
+
+	for (i = 1; i < 8; ++i)
+		P_TEST_CHECK (p_mem_pop_thread_vtable () == TRUE);
+
+	p_free (ptr);
+	P_TEST_CHECK (free_counter == 1);
+	P_TEST_CHECK (p_mem_pop_thread_vtable () == TRUE);
+	P_TEST_CHECK (p_mem_pop_thread_vtable () == FALSE);
+
+	p_free (p_malloc (64));
+	P_TEST_CHECK (alloc_counter == 1);
+	P_TEST_CHECK (free_counter == 1);
+
+	/* Other threads don't see the table of a thread */
+	alloc_counter   = 0;
+	realloc_counter = 0;
+	free_counter    = 0;
+
+	thread = p_uthread_create ((PUThreadFunc) pmem_thread_vtable_func, NULL, TRUE, NULL);
+	P_TEST_REQUIRE (thread != NULL);
+
+	P_TEST_CHECK (p_uthread_join (thread) == 1);
+	p_uthread_unref (thread);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pmem_numa_test)
+{
+	PError		*error;
+	ppointer	ptr;
+	psize		page_size;
+	pint		node_count;
+	pint		node;
+
+	p_libsys_init ();
+
+	node_count = p_mem_numa_get_node_count ();
+	node       = p_mem_numa_get_current_node ();
+
+	P_TEST_CHECK (node_count >= 1);
+	P_TEST_CHECK (node_count <= P_MEM_NUMA_MAX_NODES);
+	P_TEST_CHECK (node >= 0 && node < node_count);
+
+	error = NULL;
+
+	P_TEST_CHECK (p_mem_mmap_numa (0, P_MEM_NUMA_POLICY_DEFAULT, 0, &error) == NULL);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+	error = NULL;
+
+	P_TEST_CHECK (p_mem_mmap_numa (4096, P_MEM_NUMA_POLICY_NODE, node_count, &error) == NULL);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+	error = NULL;
+
+	P_TEST_CHECK (p_mem_mmap_numa (4096, P_MEM_NUMA_POLICY_NODE, -1, NULL) == NULL);
+	P_TEST_CHECK (p_mem_numa_set_policy (NULL, 4096, P_MEM_NUMA_POLICY_DEFAULT, 0, NULL) == FALSE);
+
+	ptr = p_mem_mmap_numa (100000, P_MEM_NUMA_POLICY_DEFAULT, 0, NULL);
+	P_TEST_REQUIRE (ptr != NULL);
+	memset (ptr, 0x11, 100000);
+	P_TEST_CHECK (p_mem_munmap (ptr, 100000, NULL) == TRUE);
+
+	ptr = p_mem_mmap_numa (100000, P_MEM_NUMA_POLICY_NODE, node, NULL);
+	P_TEST_REQUIRE (ptr != NULL);
+	memset (ptr, 0x22, 100000);
+	P_TEST_CHECK (p_mem_munmap (ptr, 100000, NULL) == TRUE);
+
+	ptr = p_mem_mmap_numa (100000, P_MEM_NUMA_POLICY_INTERLEAVE, 0, NULL);
+	P_TEST_REQUIRE (ptr != NULL);
+	memset (ptr, 0x33, 100000);
+	P_TEST_CHECK (p_mem_munmap (ptr, 100000, NULL) == TRUE);
+
+	/* Policy for an existing mapping */
+	ptr = p_mem_mmap_full (100000, P_MEM_MAP_FLAG_NONE, &page_size, NULL);
+	P_TEST_REQUIRE (ptr != NULL);
+
+	P_TEST_CHECK (p_mem_numa_set_policy (ptr, 100000, P_MEM_NUMA_POLICY_INTERLEAVE, 0, NULL) == TRUE);
+	P_TEST_CHECK (p_mem_numa_set_policy (ptr, 100000, P_MEM_NUMA_POLICY_NODE, 0, NULL) == TRUE);
+	P_TEST_CHECK (p_mem_numa_set_policy (ptr, 100000, P_MEM_NUMA_POLICY_NODE, node_count, NULL) == FALSE);
+	P_TEST_CHECK (p_mem_numa_set_policy (ptr, 100000, P_MEM_NUMA_POLICY_DEFAULT, 0, NULL) == TRUE);
+
+	memset (ptr, 0x44, 100000);
+	P_TEST_CHECK (p_mem_munmap (ptr, 100000, NULL) == TRUE);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
 P_TEST_SUITE_BEGIN()
 {
 	P_TEST_SUITE_RUN_CASE (pmem_bad_input_test);
 	P_TEST_SUITE_RUN_CASE (pmem_general_test);
+	P_TEST_SUITE_RUN_CASE (pmem_arena_test);
+	P_TEST_SUITE_RUN_CASE (pmem_stats_test);
+	P_TEST_SUITE_RUN_CASE (pmem_mmap_full_test);
+	P_TEST_SUITE_RUN_CASE (pmem_aligned_test);
+	P_TEST_SUITE_RUN_CASE (pmem_calloc_test);
+	P_TEST_SUITE_RUN_CASE (pmem_advise_test);
+	P_TEST_SUITE_RUN_CASE (pmem_numa_test);
+	P_TEST_SUITE_RUN_CASE (pmem_thread_vtable_test);
 }
 P_TEST_SUITE_END()
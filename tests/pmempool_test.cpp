@@ -0,0 +1,305 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <string.h>
+
+P_TEST_MODULE_INIT ();
+
+#define PMEMPOOL_THREADS	4
+#define PMEMPOOL_OBJECTS	2000
+#define PMEMPOOL_ROUNDS		20
+
+typedef struct PMemPoolTestObject_ {
+	pint	owner;
+	pint	index;
+	pchar	payload[40];
+} PMemPoolTestObject;
+
+static PMemPool *		pool_test_pool = NULL;
+static PMemPoolTestObject *	pool_test_handover[PMEMPOOL_THREADS][PMEMPOOL_OBJECTS];
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static pboolean check_object (const PMemPoolTestObject *obj, pint owner, pint index)
+{
+	pint i;
+
+	if (obj->owner != owner || obj->index != index)
+		return FALSE;
+
+	for (i = 0; i < (pint) sizeof (obj->payload); ++i) {
+		if (obj->payload[i] != (pchar) (owner + index))
+			return FALSE;
+	}
+
+	return TRUE;
+}
+
+static void fill_object (PMemPoolTestObject *obj, pint owner, pint index)
+{
+	obj->owner = owner;
+	obj->index = index;
+
+	memset (obj->payload, owner + index, sizeof (obj->payload));
+}
+
+static void * pool_test_thread (void *arg)
+{
+	PMemPoolTestObject	*objects[PMEMPOOL_OBJECTS];
+	pint			owner;
+	pint			round;
+	pint			i;
+	pint			result;
+
+	owner  = PPOINTER_TO_INT (arg);
+	result = 0;
+
+	for (round = 0; round < PMEMPOOL_ROUNDS; ++round) {
+		for (i = 0; i < PMEMPOOL_OBJECTS; ++i) {
+			objects[i] = (PMemPoolTestObject *) p_mem_pool_alloc (pool_test_pool);
+
+			if (objects[i] == NULL) {
+				result = 1;
+				break;
+			}
+
+			fill_object (objects[i], owner, i);
+		}
+
+		if (result != 0)
+			break;
+
+		for (i = 0; i < PMEMPOOL_OBJECTS; ++i) {
+			if (check_object (objects[i], owner, i) == FALSE)
+				result = 1;
+
+			p_mem_pool_release (pool_test_pool, objects[i]);
+		}
+	}
+
+	/* These ones are released by the main thread */
+	for (i = 0; i < PMEMPOOL_OBJECTS; ++i) {
+		pool_test_handover[owner][i] = (PMemPoolTestObject *) p_mem_pool_alloc (pool_test_pool);
+
+		if (pool_test_handover[owner][i] == NULL) {
+			result = 1;
+			break;
+		}
+
+		fill_object (pool_test_handover[owner][i], owner, i);
+	}
+
+	p_uthread_exit (result);
+
+	return NULL;
+}
+
+P_TEST_CASE_BEGIN (pmempool_nomem_test)
+{
+	PMemVTable	vtable;
+	PMemPool	*pool;
+
+	p_libsys_init ();
+
+	pool = p_mem_pool_new (sizeof (PMemPoolTestObject));
+	P_TEST_REQUIRE (pool != NULL);
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (p_mem_pool_new (sizeof (PMemPoolTestObject)) == NULL);
+	P_TEST_CHECK (p_mem_pool_alloc (pool) == NULL);
+	P_TEST_CHECK (p_mem_pool_alloc0 (pool) == NULL);
+
+	p_mem_restore_vtable ();
+
+	p_mem_pool_free (pool);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pmempool_bad_input_test)
+{
+	pint obj;
+
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_mem_pool_new (0) == NULL);
+	P_TEST_CHECK (p_mem_pool_alloc (NULL) == NULL);
+	P_TEST_CHECK (p_mem_pool_alloc0 (NULL) == NULL);
+	P_TEST_CHECK (p_mem_pool_get_used_count (NULL) == 0);
+
+	p_mem_pool_release (NULL, &obj);
+	p_mem_pool_free (NULL);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pmempool_general_test)
+{
+	PMemPool	*pool;
+	ppointer	*objects;
+	ppointer	obj;
+	pint		i;
+	pint		j;
+
+	p_libsys_init ();
+
+	pool = p_mem_pool_new (3);
+	P_TEST_REQUIRE (pool != NULL);
+	P_TEST_CHECK (p_mem_pool_get_used_count (pool) == 0);
+
+	objects = (ppointer *) p_malloc0 (10000 * sizeof (ppointer));
+	P_TEST_REQUIRE (objects != NULL);
+
+	for (i = 0; i < 10000; ++i) {
+		objects[i] = p_mem_pool_alloc0 (pool);
+
+		P_TEST_REQUIRE (objects[i] != NULL);
+		P_TEST_CHECK (((psize) objects[i]) % sizeof (ppointer) == 0);
+		P_TEST_CHECK (memcmp (objects[i], "\0\0\0", 3) == 0);
+
+		memcpy (objects[i], &i, sizeof (pint) < sizeof (ppointer) ? sizeof (pint) : sizeof (ppointer));
+	}
+
+	/* The objects don't overlap */
+	for (i = 0; i < 10000; ++i)
+		P_TEST_CHECK (memcmp (objects[i], &i, sizeof (pint) < sizeof (ppointer) ? sizeof (pint) : sizeof (ppointer)) == 0);
+
+	P_TEST_CHECK (p_mem_pool_get_used_count (pool) == 10000);
+
+	/* The last released object goes first */
+	p_mem_pool_release (pool, objects[5000]);
+	P_TEST_CHECK (p_mem_pool_get_used_count (pool) == 9999);
+	P_TEST_CHECK (p_mem_pool_alloc (pool) == objects[5000]);
+
+	for (i = 0; i < 10000; ++i)
+		p_mem_pool_release (pool, objects[i]);
+
+	P_TEST_CHECK (p_mem_pool_get_used_count (pool) == 0);
+
+	p_mem_pool_release (pool, NULL);
+
+	/* The released objects are reused without new slabs */
+	for (i = 0; i < 10000; ++i) {
+		obj = p_mem_pool_alloc (pool);
+		P_TEST_REQUIRE (obj != NULL);
+
+		for (j = i; j < 10000; ++j) {
+			if (objects[j] == obj) {
+				objects[j] = objects[i];
+				objects[i] = obj;
+				break;
+			}
+		}
+
+		P_TEST_CHECK (j < 10000);
+	}
+
+	P_TEST_CHECK (p_mem_pool_get_used_count (pool) == 10000);
+
+	p_free (objects);
+	p_mem_pool_free (pool);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pmempool_thread_test)
+{
+	PUThread	*threads[PMEMPOOL_THREADS];
+	pint		i;
+	pint		j;
+
+	p_libsys_init ();
+
+	pool_test_pool = p_mem_pool_new (sizeof (PMemPoolTestObject));
+	P_TEST_REQUIRE (pool_test_pool != NULL);
+
+	for (i = 0; i < PMEMPOOL_THREADS; ++i) {
+		threads[i] = p_uthread_create ((PUThreadFunc) pool_test_thread, PINT_TO_POINTER (i), TRUE, NULL);
+		P_TEST_REQUIRE (threads[i] != NULL);
+	}
+
+	for (i = 0; i < PMEMPOOL_THREADS; ++i) {
+		P_TEST_CHECK (p_uthread_join (threads[i]) == 0);
+		p_uthread_unref (threads[i]);
+	}
+
+	/* Objects of the exited threads are released here */
+	for (i = 0; i < PMEMPOOL_THREADS; ++i) {
+		for (j = 0; j < PMEMPOOL_OBJECTS; ++j) {
+			P_TEST_CHECK (check_object (pool_test_handover[i][j], i, j) == TRUE);
+			p_mem_pool_release (pool_test_pool, pool_test_handover[i][j]);
+		}
+	}
+
+	/* Magazines of the exited threads are back in the depot */
+	P_TEST_CHECK (p_mem_pool_get_used_count (pool_test_pool) == 0);
+
+	for (i = 0; i < PMEMPOOL_OBJECTS; ++i) {
+		pool_test_handover[0][i] = (PMemPoolTestObject *) p_mem_pool_alloc (pool_test_pool);
+		P_TEST_REQUIRE (pool_test_handover[0][i] != NULL);
+	}
+
+	p_mem_pool_free (pool_test_pool);
+	pool_test_pool = NULL;
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pmempool_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pmempool_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (pmempool_general_test);
+	P_TEST_SUITE_RUN_CASE (pmempool_thread_test);
+}
+P_TEST_SUITE_END()
@@ -0,0 +1,274 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <string.h>
+
+P_TEST_MODULE_INIT ();
+
+#define PMETRICS_THREADS	4
+#define PMETRICS_ROUNDS		10000
+
+typedef struct MetricsTestData_ {
+	pint		count;
+	pint		stop_after;
+	pint64		requests;
+	pint64		connections;
+	pint64		latency_count;
+	pboolean	has_latency_histogram;
+	pboolean	labels_ok;
+} MetricsTestData;
+
+static PMetric *	global_counter   = NULL;
+static PMetric *	global_histogram = NULL;
+
+static pint64
+metrics_read_func (ppointer user_data)
+{
+	return *((pint64 *) user_data);
+}
+
+static pboolean
+metrics_collect (const PMetricSample *sample, ppointer user_data)
+{
+	MetricsTestData *data = (MetricsTestData *) user_data;
+
+	++data->count;
+
+	if (strcmp (sample->name, "test_requests") == 0 && strcmp (sample->labels, "method=get") == 0) {
+		data->requests  = sample->value;
+		data->labels_ok = strcmp (sample->help, "Handled requests") == 0 &&
+				  sample->type == P_METRIC_TYPE_COUNTER &&
+				  sample->histogram == NULL;
+	} else if (strcmp (sample->name, "test_connections") == 0)
+		data->connections = sample->value;
+	else if (strcmp (sample->name, "test_latency") == 0) {
+		data->latency_count         = sample->value;
+		data->has_latency_histogram = sample->histogram != NULL &&
+					      sample->type == P_METRIC_TYPE_HISTOGRAM;
+	}
+
+	return data->stop_after == 0 || data->count < data->stop_after;
+}
+
+static void * metrics_thread (void *)
+{
+	pint i;
+
+	for (i = 0; i < PMETRICS_ROUNDS; ++i) {
+		p_metrics_inc (global_counter);
+		p_metrics_record (global_histogram, (puint64) i);
+	}
+
+	p_uthread_exit (0);
+
+	return NULL;
+}
+
+P_TEST_CASE_BEGIN (pmetrics_bad_input_test)
+{
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_metrics_register_counter (NULL, NULL, NULL) == NULL);
+	P_TEST_CHECK (p_metrics_register_gauge ("", NULL, NULL) == NULL);
+	P_TEST_CHECK (p_metrics_register_histogram ("test_bad", NULL, NULL, 1, 3) == NULL);
+	P_TEST_CHECK (p_metrics_register_func ("test_bad", NULL, NULL, P_METRIC_TYPE_COUNTER, NULL, NULL) == NULL);
+	P_TEST_CHECK (p_metrics_register_func ("test_bad",
+					       NULL,
+					       NULL,
+					       P_METRIC_TYPE_HISTOGRAM,
+					       metrics_read_func,
+					       NULL) == NULL);
+	P_TEST_CHECK (p_metrics_foreach (NULL, NULL) == 0);
+	P_TEST_CHECK (p_metrics_get_value (NULL) == 0);
+	P_TEST_CHECK (p_metrics_get_histogram (NULL) == NULL);
+
+	p_metrics_unregister (NULL);
+	p_metrics_add (NULL, 1);
+	p_metrics_inc (NULL);
+	p_metrics_set (NULL, 1);
+	p_metrics_record (NULL, 1);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pmetrics_general_test)
+{
+	PMetric		*requests;
+	PMetric		*requests_post;
+	PMetric		*connections;
+	PMetric		*latency;
+	PMetric		*external;
+	PMetric		*shared;
+	MetricsTestData	data;
+	pint64		external_value;
+	pint		builtin;
+
+	p_libsys_init ();
+
+	memset (&data, 0, sizeof (data));
+	builtin = p_metrics_foreach (metrics_collect, &data);
+
+#ifdef PLIBSYS_TRACE
+	P_TEST_CHECK (builtin > 0);
+#endif
+
+	requests      = p_metrics_register_counter ("test_requests", "method=get", "Handled requests");
+	requests_post = p_metrics_register_counter ("test_requests", "method=post", NULL);
+	connections   = p_metrics_register_gauge ("test_connections", NULL, NULL);
+	latency       = p_metrics_register_histogram ("test_latency", NULL, NULL, 1000000000ULL, 3);
+	external      = p_metrics_register_func ("test_external",
+						 NULL,
+						 NULL,
+						 P_METRIC_TYPE_GAUGE,
+						 metrics_read_func,
+						 &external_value);
+
+	P_TEST_REQUIRE (requests != NULL);
+	P_TEST_REQUIRE (requests_post != NULL);
+	P_TEST_REQUIRE (connections != NULL);
+	P_TEST_REQUIRE (latency != NULL);
+	P_TEST_REQUIRE (external != NULL);
+	P_TEST_CHECK (requests != requests_post);
+
+	/* Same name and labels give the same metric, but only of the same type */
+	shared = p_metrics_register_counter ("test_requests", "method=get", NULL);
+	P_TEST_CHECK (shared == requests);
+	P_TEST_CHECK (p_metrics_register_gauge ("test_requests", "method=get", NULL) == NULL);
+	P_TEST_CHECK (p_metrics_register_func ("test_external",
+					       NULL,
+					       NULL,
+					       P_METRIC_TYPE_GAUGE,
+					       metrics_read_func,
+					       &external_value) == NULL);
+
+	p_metrics_inc (requests);
+	p_metrics_add (requests, 9);
+	p_metrics_add (requests_post, 2);
+	p_metrics_set (requests, 100);
+	p_metrics_record (requests, 100);
+
+	p_metrics_set (connections, 5);
+	p_metrics_add (connections, -2);
+	p_metrics_inc (connections);
+
+	p_metrics_record (latency, 1000);
+	p_metrics_record (latency, 2000);
+	p_metrics_add (latency, 1);
+
+	external_value = 42;
+	p_metrics_set (external, 1);
+	p_metrics_add (external, 1);
+
+	P_TEST_CHECK (p_metrics_get_value (requests) == 10);
+	P_TEST_CHECK (p_metrics_get_value (requests_post) == 2);
+	P_TEST_CHECK (p_metrics_get_value (connections) == 4);
+	P_TEST_CHECK (p_metrics_get_value (latency) == 2);
+	P_TEST_CHECK (p_metrics_get_value (external) == 42);
+	P_TEST_CHECK (p_metrics_get_histogram (requests) == NULL);
+	P_TEST_REQUIRE (p_metrics_get_histogram (latency) != NULL);
+	P_TEST_CHECK (p_histogram_get_max (p_metrics_get_histogram (latency)) == 2000);
+
+	memset (&data, 0, sizeof (data));
+	P_TEST_CHECK (p_metrics_foreach (metrics_collect, &data) == builtin + 5);
+	P_TEST_CHECK (data.requests == 10);
+	P_TEST_CHECK (data.labels_ok == TRUE);
+	P_TEST_CHECK (data.connections == 4);
+	P_TEST_CHECK (data.latency_count == 2);
+	P_TEST_CHECK (data.has_latency_histogram == TRUE);
+
+	/* Iteration stops on request */
+	memset (&data, 0, sizeof (data));
+	data.stop_after = 1;
+	P_TEST_CHECK (p_metrics_foreach (metrics_collect, &data) == 1);
+
+	/* A shared metric stays until the last registration is dropped */
+	p_metrics_unregister (shared);
+	P_TEST_CHECK (p_metrics_get_value (requests) == 10);
+
+	p_metrics_unregister (requests);
+	p_metrics_unregister (connections);
+
+	memset (&data, 0, sizeof (data));
+	P_TEST_CHECK (p_metrics_foreach (metrics_collect, &data) == builtin + 3);
+	P_TEST_CHECK (data.requests == 0);
+
+	/* Registered again from zero */
+	requests = p_metrics_register_counter ("test_requests", "method=get", NULL);
+	P_TEST_REQUIRE (requests != NULL);
+	P_TEST_CHECK (p_metrics_get_value (requests) == 0);
+
+	p_metrics_unregister (external);
+
+	/* The rest is freed on shutdown */
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pmetrics_thread_test)
+{
+	PUThread	*thr[PMETRICS_THREADS];
+	pint		i;
+
+	p_libsys_init ();
+
+	global_counter   = p_metrics_register_counter ("test_thread_counter", NULL, NULL);
+	global_histogram = p_metrics_register_histogram ("test_thread_histogram", NULL, NULL, 1000000, 3);
+
+	P_TEST_REQUIRE (global_counter != NULL);
+	P_TEST_REQUIRE (global_histogram != NULL);
+
+	for (i = 0; i < PMETRICS_THREADS; ++i) {
+		thr[i] = p_uthread_create ((PUThreadFunc) metrics_thread, NULL, TRUE, NULL);
+		P_TEST_REQUIRE (thr[i] != NULL);
+	}
+
+	for (i = 0; i < PMETRICS_THREADS; ++i) {
+		P_TEST_CHECK (p_uthread_join (thr[i]) == 0);
+		p_uthread_unref (thr[i]);
+	}
+
+	P_TEST_CHECK (p_metrics_get_value (global_counter) == PMETRICS_THREADS * PMETRICS_ROUNDS);
+	P_TEST_CHECK (p_metrics_get_value (global_histogram) == PMETRICS_THREADS * PMETRICS_ROUNDS);
+
+	p_metrics_unregister (global_counter);
+	p_metrics_unregister (global_histogram);
+
+	global_counter   = NULL;
+	global_histogram = NULL;
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pmetrics_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (pmetrics_general_test);
+	P_TEST_SUITE_RUN_CASE (pmetrics_thread_test);
+}
+P_TEST_SUITE_END()
@@ -0,0 +1,185 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+P_TEST_MODULE_INIT ();
+
+#define PONCE_TEST_THREADS 8
+
+static POnce		once_test_flag      = P_ONCE_INIT;
+static volatile pint	once_test_calls     = 0;
+static volatile pint	once_test_value     = 0;
+static volatile pint	once_test_start     = 0;
+static volatile pint	once_test_mismatch  = 0;
+
+static void once_test_init (ppointer data)
+{
+	p_atomic_int_inc (&once_test_calls);
+
+	/* Let the other threads pile up on the flag */
+	p_uthread_sleep (50);
+
+	once_test_value = PPOINTER_TO_INT (data);
+}
+
+static void once_test_counter (ppointer data)
+{
+	p_atomic_int_inc ((volatile pint *) data);
+}
+
+static void * once_test_thread (void *)
+{
+	while (p_atomic_int_get (&once_test_start) == 0)
+		p_uthread_yield ();
+
+	p_once (&once_test_flag, once_test_init, PINT_TO_POINTER (42));
+
+	/* The initialization must be complete for every caller */
+	if (once_test_value != 42)
+		p_atomic_int_inc (&once_test_mismatch);
+
+	return NULL;
+}
+
+P_TEST_CASE_BEGIN (ponce_bad_input_test)
+{
+	POnce once = P_ONCE_INIT;
+
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_once_init_enter (NULL) == FALSE);
+	P_TEST_CHECK (p_once_is_done (NULL) == FALSE);
+	p_once_init_leave (NULL);
+	p_once (NULL, once_test_counter, NULL);
+
+	/* Missing routine doesn't consume the flag */
+	p_once (&once, NULL, NULL);
+	P_TEST_CHECK (p_once_is_done (&once) == FALSE);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (ponce_general_test)
+{
+	POnce	once    = P_ONCE_INIT;
+	POnce	section = P_ONCE_INIT;
+	pint	counter = 0;
+
+	/* Usable before the library initialization */
+	P_TEST_CHECK (p_once_is_done (&once) == FALSE);
+	p_once (&once, once_test_counter, &counter);
+	P_TEST_CHECK (counter == 1);
+	P_TEST_CHECK (p_once_is_done (&once) == TRUE);
+
+	p_libsys_init ();
+
+	p_once (&once, once_test_counter, &counter);
+	P_TEST_CHECK (counter == 1);
+
+	P_TEST_CHECK (p_once_init_enter (&section) == TRUE);
+	P_TEST_CHECK (p_once_is_done (&section) == FALSE);
+	p_once_init_leave (&section);
+
+	P_TEST_CHECK (p_once_is_done (&section) == TRUE);
+	P_TEST_CHECK (p_once_init_enter (&section) == FALSE);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (ponce_thread_test)
+{
+	PUThread	*threads[PONCE_TEST_THREADS];
+	pint		i;
+
+	p_libsys_init ();
+
+	for (i = 0; i < PONCE_TEST_THREADS; ++i) {
+		threads[i] = p_uthread_create ((PUThreadFunc) once_test_thread, NULL, TRUE, NULL);
+		P_TEST_REQUIRE (threads[i] != NULL);
+	}
+
+	p_atomic_int_set (&once_test_start, 1);
+
+	for (i = 0; i < PONCE_TEST_THREADS; ++i) {
+		p_uthread_join (threads[i]);
+		p_uthread_unref (threads[i]);
+	}
+
+	P_TEST_CHECK (p_atomic_int_get (&once_test_calls) == 1);
+	P_TEST_CHECK (p_atomic_int_get (&once_test_mismatch) == 0);
+	P_TEST_CHECK (p_once_is_done (&once_test_flag) == TRUE);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (ponce_lazy_init_test)
+{
+	PTimeProfiler	*profiler;
+	PMetric		*metric;
+
+	/* Subsystems initialized on the first use survive a restart */
+	p_libsys_init ();
+
+	profiler = p_time_profiler_new ();
+	P_TEST_REQUIRE (profiler != NULL);
+	p_uthread_sleep (10);
+	P_TEST_CHECK (p_time_profiler_elapsed_usecs (profiler) >= 5000);
+	p_time_profiler_free (profiler);
+
+	metric = p_metrics_register_counter ("ponce_test_counter", NULL, NULL);
+	P_TEST_REQUIRE (metric != NULL);
+	p_metrics_unregister (metric);
+
+	p_libsys_shutdown ();
+
+	p_libsys_init ();
+
+	profiler = p_time_profiler_new ();
+	P_TEST_REQUIRE (profiler != NULL);
+	p_uthread_sleep (10);
+	P_TEST_CHECK (p_time_profiler_elapsed_usecs (profiler) >= 5000);
+	p_time_profiler_free (profiler);
+
+	metric = p_metrics_register_counter ("ponce_test_counter", NULL, NULL);
+	P_TEST_REQUIRE (metric != NULL);
+	p_metrics_unregister (metric);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (ponce_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (ponce_general_test);
+	P_TEST_SUITE_RUN_CASE (ponce_thread_test);
+	P_TEST_SUITE_RUN_CASE (ponce_lazy_init_test);
+}
+P_TEST_SUITE_END()
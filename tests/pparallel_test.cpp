@@ -0,0 +1,347 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <string.h>
+
+P_TEST_MODULE_INIT ();
+
+#define PPARALLEL_SIZE		100000
+#define PPARALLEL_NESTED	64
+#define PPARALLEL_BUCKETS	16
+
+typedef struct _ForData {
+	volatile pint	*visits;
+	psize		grain;
+	volatile pint	oversized;
+} ForData;
+
+typedef struct _OrderResult {
+	psize		first;
+	psize		last;
+	psize		count;
+	pboolean	ordered;
+} OrderResult;
+
+typedef struct _HistogramResult {
+	puint64		buckets[PPARALLEL_BUCKETS];
+} HistogramResult;
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static void visit_func (psize begin, psize end, ppointer data)
+{
+	ForData *for_data = (ForData *) data;
+
+	if (for_data->grain > 0 && end - begin > for_data->grain)
+		p_atomic_int_inc (&for_data->oversized);
+
+	for (psize i = begin; i < end; ++i)
+		p_atomic_int_inc (&for_data->visits[i]);
+}
+
+static void nested_func (psize begin, psize end, ppointer data)
+{
+	ForData *for_data = (ForData *) data;
+
+	for (psize i = begin; i < end; ++i)
+		p_parallel_for (i * PPARALLEL_SIZE / PPARALLEL_NESTED,
+				(i + 1) * PPARALLEL_SIZE / PPARALLEL_NESTED,
+				0,
+				visit_func,
+				for_data);
+}
+
+static void sum_func (psize begin, psize end, ppointer result, ppointer data)
+{
+	P_UNUSED (data);
+
+	for (psize i = begin; i < end; ++i)
+		*((puint64 *) result) += i;
+}
+
+static void sum_join_func (ppointer result, pconstpointer other, ppointer data)
+{
+	P_UNUSED (data);
+
+	*((puint64 *) result) += *((const puint64 *) other);
+}
+
+static void order_func (psize begin, psize end, ppointer result, ppointer data)
+{
+	OrderResult *order = (OrderResult *) result;
+
+	P_UNUSED (data);
+
+	if (order->count == 0)
+		order->first = begin;
+	else if (order->last + 1 != begin)
+		order->ordered = FALSE;
+
+	order->last   = end - 1;
+	order->count += end - begin;
+}
+
+static void order_join_func (ppointer result, pconstpointer other, ppointer data)
+{
+	OrderResult		*order = (OrderResult *) result;
+	const OrderResult	*right = (const OrderResult *) other;
+
+	P_UNUSED (data);
+
+	if (right->count == 0)
+		return;
+
+	if (order->count == 0) {
+		*order = *right;
+		return;
+	}
+
+	/* Not commutative: the right part must follow the left one */
+	if (order->last + 1 != right->first || right->ordered == FALSE)
+		order->ordered = FALSE;
+
+	order->last   = right->last;
+	order->count += right->count;
+}
+
+static void histogram_func (psize begin, psize end, ppointer result, ppointer data)
+{
+	HistogramResult *histogram = (HistogramResult *) result;
+
+	P_UNUSED (data);
+
+	for (psize i = begin; i < end; ++i)
+		++histogram->buckets[i % PPARALLEL_BUCKETS];
+}
+
+static void histogram_join_func (ppointer result, pconstpointer other, ppointer data)
+{
+	HistogramResult		*histogram = (HistogramResult *) result;
+	const HistogramResult	*right     = (const HistogramResult *) other;
+
+	P_UNUSED (data);
+
+	for (pint i = 0; i < PPARALLEL_BUCKETS; ++i)
+		histogram->buckets[i] += right->buckets[i];
+}
+
+static pboolean check_visits (volatile pint *visits, psize begin, psize end)
+{
+	for (psize i = 0; i < PPARALLEL_SIZE; ++i) {
+		if (visits[i] != (i >= begin && i < end ? 1 : 0))
+			return FALSE;
+	}
+
+	return TRUE;
+}
+
+P_TEST_CASE_BEGIN (pparallel_nomem_test)
+{
+	p_libsys_init ();
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	/* Falls back to a sequential run */
+	puint64 identity = 0;
+	puint64 sum      = 1;
+
+	P_TEST_CHECK (p_parallel_reduce (0, 1000, 0, sum_func, sum_join_func, &identity, sizeof (sum), &sum, NULL) == TRUE);
+
+	p_mem_restore_vtable ();
+
+	P_TEST_CHECK (sum == 999 * 1000 / 2);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pparallel_invalid_test)
+{
+	p_libsys_init ();
+
+	puint64 value = 0;
+
+	P_TEST_CHECK (p_parallel_for (0, 10, 0, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_parallel_for (10, 0, 0, visit_func, NULL) == FALSE);
+
+	P_TEST_CHECK (p_parallel_reduce (0, 10, 0, NULL, sum_join_func, &value, sizeof (value), &value, NULL) == FALSE);
+	P_TEST_CHECK (p_parallel_reduce (0, 10, 0, sum_func, NULL, &value, sizeof (value), &value, NULL) == FALSE);
+	P_TEST_CHECK (p_parallel_reduce (0, 10, 0, sum_func, sum_join_func, NULL, sizeof (value), &value, NULL) == FALSE);
+	P_TEST_CHECK (p_parallel_reduce (0, 10, 0, sum_func, sum_join_func, &value, 0, &value, NULL) == FALSE);
+	P_TEST_CHECK (p_parallel_reduce (0, 10, 0, sum_func, sum_join_func, &value, sizeof (value), NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_parallel_reduce (10, 0, 0, sum_func, sum_join_func, &value, sizeof (value), &value, NULL) == FALSE);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pparallel_for_test)
+{
+	p_libsys_init ();
+
+	ForData	data;
+	psize	grains[] = {0, 1, 7, 1000, PPARALLEL_SIZE};
+
+	data.visits = (volatile pint *) p_malloc0 (PPARALLEL_SIZE * sizeof (pint));
+	P_TEST_REQUIRE (data.visits != NULL);
+
+	for (psize i = 0; i < sizeof (grains) / sizeof (grains[0]); ++i) {
+		memset ((void *) data.visits, 0, PPARALLEL_SIZE * sizeof (pint));
+
+		data.grain     = grains[i];
+		data.oversized = 0;
+
+		P_TEST_CHECK (p_parallel_for (0, PPARALLEL_SIZE, grains[i], visit_func, &data) == TRUE);
+		P_TEST_CHECK (check_visits (data.visits, 0, PPARALLEL_SIZE) == TRUE);
+
+		/* Single-core systems run the whole range at once */
+		if (p_uthread_ideal_count () > 1)
+			P_TEST_CHECK (data.oversized == 0);
+	}
+
+	/* Subrange and empty range */
+	memset ((void *) data.visits, 0, PPARALLEL_SIZE * sizeof (pint));
+
+	data.grain = 0;
+
+	P_TEST_CHECK (p_parallel_for (100, PPARALLEL_SIZE - 100, 0, visit_func, &data) == TRUE);
+	P_TEST_CHECK (p_parallel_for (500, 500, 0, visit_func, &data) == TRUE);
+	P_TEST_CHECK (check_visits (data.visits, 100, PPARALLEL_SIZE - 100) == TRUE);
+
+	/* Nested loops */
+	memset ((void *) data.visits, 0, PPARALLEL_SIZE * sizeof (pint));
+
+	P_TEST_CHECK (p_parallel_for (0, PPARALLEL_NESTED, 1, nested_func, &data) == TRUE);
+	P_TEST_CHECK (check_visits (data.visits, 0, PPARALLEL_SIZE) == TRUE);
+
+	p_free ((ppointer) data.visits);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pparallel_reduce_test)
+{
+	p_libsys_init ();
+
+	psize grains[] = {0, 1, 13, PPARALLEL_SIZE};
+
+	for (psize i = 0; i < sizeof (grains) / sizeof (grains[0]); ++i) {
+		puint64 identity = 0;
+		puint64 sum      = 0;
+
+		P_TEST_CHECK (p_parallel_reduce (0,
+						 PPARALLEL_SIZE,
+						 grains[i],
+						 sum_func,
+						 sum_join_func,
+						 &identity,
+						 sizeof (sum),
+						 &sum,
+						 NULL) == TRUE);
+		P_TEST_CHECK (sum == (puint64) PPARALLEL_SIZE * (PPARALLEL_SIZE - 1) / 2);
+
+		/* Joins keep the order of the subranges */
+		OrderResult order_identity = {0, 0, 0, TRUE};
+		OrderResult order;
+
+		P_TEST_CHECK (p_parallel_reduce (10,
+						 PPARALLEL_SIZE,
+						 grains[i],
+						 order_func,
+						 order_join_func,
+						 &order_identity,
+						 sizeof (order),
+						 &order,
+						 NULL) == TRUE);
+		P_TEST_CHECK (order.ordered == TRUE);
+		P_TEST_CHECK (order.first == 10);
+		P_TEST_CHECK (order.last == PPARALLEL_SIZE - 1);
+		P_TEST_CHECK (order.count == PPARALLEL_SIZE - 10);
+	}
+
+	/* Larger than the stack buffer */
+	HistogramResult histogram_identity;
+	HistogramResult histogram;
+
+	memset (&histogram_identity, 0, sizeof (histogram_identity));
+
+	P_TEST_CHECK (p_parallel_reduce (0,
+					 PPARALLEL_SIZE,
+					 0,
+					 histogram_func,
+					 histogram_join_func,
+					 &histogram_identity,
+					 sizeof (histogram),
+					 &histogram,
+					 NULL) == TRUE);
+
+	for (pint i = 0; i < PPARALLEL_BUCKETS; ++i)
+		P_TEST_CHECK (histogram.buckets[i] == (puint64) (PPARALLEL_SIZE / PPARALLEL_BUCKETS));
+
+	/* Empty range gives the identity */
+	puint64 identity = 5;
+	puint64 sum      = 0;
+
+	P_TEST_CHECK (p_parallel_reduce (7, 7, 0, sum_func, sum_join_func, &identity, sizeof (sum), &sum, NULL) == TRUE);
+	P_TEST_CHECK (sum == 5);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pparallel_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pparallel_invalid_test);
+	P_TEST_SUITE_RUN_CASE (pparallel_for_test);
+	P_TEST_SUITE_RUN_CASE (pparallel_reduce_test);
+}
+P_TEST_SUITE_END()
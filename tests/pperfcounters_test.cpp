@@ -0,0 +1,160 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <string.h>
+
+P_TEST_MODULE_INIT ();
+
+#define PPERFCOUNTERS_TEST_MEMORY	(4 * 1024 * 1024)
+#define PPERFCOUNTERS_TEST_ROUNDS	1000000
+
+static volatile puint64 test_sink = 0;
+
+P_TEST_CASE_BEGIN (pperfcounters_bad_input_test)
+{
+	PPerfCountersDelta delta;
+
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_perf_counters_is_supported (NULL, P_PERF_COUNTER_TYPE_CYCLES) == FALSE);
+	P_TEST_CHECK (p_perf_counters_begin (NULL) == FALSE);
+	P_TEST_CHECK (p_perf_counters_end (NULL, &delta) == FALSE);
+	P_TEST_CHECK (p_perf_counters_get_name ((PPerfCounterType) -1) == NULL);
+	P_TEST_CHECK (p_perf_counters_get_name ((PPerfCounterType) P_PERF_COUNTER_TYPE_COUNT) == NULL);
+
+	p_perf_counters_free (NULL);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pperfcounters_names_test)
+{
+	p_libsys_init ();
+
+	for (pint i = 0; i < P_PERF_COUNTER_TYPE_COUNT; ++i) {
+		P_TEST_CHECK (p_perf_counters_get_name ((PPerfCounterType) i) != NULL);
+
+		for (pint j = 0; j < i; ++j)
+			P_TEST_CHECK (strcmp (p_perf_counters_get_name ((PPerfCounterType) i),
+					      p_perf_counters_get_name ((PPerfCounterType) j)) != 0);
+	}
+
+	P_TEST_CHECK (strcmp (p_perf_counters_get_name (P_PERF_COUNTER_TYPE_CYCLES), "cycles") == 0);
+	P_TEST_CHECK (strcmp (p_perf_counters_get_name (P_PERF_COUNTER_TYPE_BRANCH_MISSES), "branch-misses") == 0);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pperfcounters_general_test)
+{
+	PPerfCounters		*counters;
+	PPerfCountersDelta	delta;
+	PPerfCountersDelta	next_delta;
+	PError			*error = NULL;
+	pchar			*memory;
+
+	p_libsys_init ();
+
+	/* Not available everywhere, i.e. in containers with a strict policy */
+	if ((counters = p_perf_counters_new (&error)) == NULL) {
+		P_TEST_CHECK (error != NULL);
+		p_error_free (error);
+		p_libsys_shutdown ();
+		P_TEST_CASE_RETURN ();
+	}
+
+	P_TEST_CHECK (p_perf_counters_is_supported (counters, (PPerfCounterType) -1) == FALSE);
+	P_TEST_CHECK (p_perf_counters_is_supported (counters,
+						    (PPerfCounterType) P_PERF_COUNTER_TYPE_COUNT) == FALSE);
+
+	memory = (pchar *) p_malloc (PPERFCOUNTERS_TEST_MEMORY);
+	P_TEST_REQUIRE (memory != NULL);
+
+	P_TEST_CHECK (p_perf_counters_begin (counters) == TRUE);
+
+	/* Fresh pages fault on the first touch */
+	memset (memory, 0x5A, PPERFCOUNTERS_TEST_MEMORY);
+
+	for (psize i = 0; i < PPERFCOUNTERS_TEST_ROUNDS; ++i)
+		test_sink += (puint64) memory[(i * 4099) % PPERFCOUNTERS_TEST_MEMORY];
+
+	p_uthread_sleep (5);
+
+	P_TEST_CHECK (p_perf_counters_end (counters, &delta) == TRUE);
+
+	for (pint i = 0; i < P_PERF_COUNTER_TYPE_COUNT; ++i) {
+		if (p_perf_counters_is_supported (counters, (PPerfCounterType) i) == FALSE)
+			P_TEST_CHECK (delta.values[i] == 0);
+	}
+
+	if (p_perf_counters_is_supported (counters, P_PERF_COUNTER_TYPE_TASK_CLOCK))
+		P_TEST_CHECK (delta.values[P_PERF_COUNTER_TYPE_TASK_CLOCK] > 0);
+
+	if (p_perf_counters_is_supported (counters, P_PERF_COUNTER_TYPE_PAGE_FAULTS))
+		P_TEST_CHECK (delta.values[P_PERF_COUNTER_TYPE_PAGE_FAULTS] > 0);
+
+	if (p_perf_counters_is_supported (counters, P_PERF_COUNTER_TYPE_CONTEXT_SWITCHES))
+		P_TEST_CHECK (delta.values[P_PERF_COUNTER_TYPE_CONTEXT_SWITCHES] > 0);
+
+	/* A busy PMU may leave the group unscheduled, then all reads are zero */
+	if (p_perf_counters_is_supported (counters, P_PERF_COUNTER_TYPE_INSTRUCTIONS) &&
+	    delta.values[P_PERF_COUNTER_TYPE_INSTRUCTIONS] > 0)
+		P_TEST_CHECK (delta.values[P_PERF_COUNTER_TYPE_INSTRUCTIONS] >= PPERFCOUNTERS_TEST_ROUNDS);
+
+	/* The begin mark stays, so the counters only grow */
+	P_TEST_CHECK (p_perf_counters_end (counters, &next_delta) == TRUE);
+
+	if (delta.scaled == FALSE && next_delta.scaled == FALSE) {
+		for (pint i = 0; i < P_PERF_COUNTER_TYPE_COUNT; ++i)
+			P_TEST_CHECK (next_delta.values[i] >= delta.values[i]);
+	}
+
+	/* A new region starts from zero */
+	P_TEST_CHECK (p_perf_counters_begin (counters) == TRUE);
+	P_TEST_CHECK (p_perf_counters_end (counters, &next_delta) == TRUE);
+
+	if (p_perf_counters_is_supported (counters, P_PERF_COUNTER_TYPE_PAGE_FAULTS))
+		P_TEST_CHECK (next_delta.values[P_PERF_COUNTER_TYPE_PAGE_FAULTS] <
+			      delta.values[P_PERF_COUNTER_TYPE_PAGE_FAULTS]);
+
+	p_free (memory);
+	p_perf_counters_free (counters);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pperfcounters_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (pperfcounters_names_test);
+	P_TEST_SUITE_RUN_CASE (pperfcounters_general_test);
+}
+P_TEST_SUITE_END()
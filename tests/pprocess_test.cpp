@@ -26,6 +26,8 @@
 #include "plibsys.h"
 #include "ptestmacros.h"
 
+#include <string.h>
+
 P_TEST_MODULE_INIT ();
 
 P_TEST_CASE_BEGIN (pprocess_general_test)
@@ -38,12 +40,352 @@ P_TEST_CASE_BEGIN (pprocess_general_test)
 	P_TEST_CHECK (pid > 0);
 	P_TEST_REQUIRE (p_process_is_running (pid) == TRUE);
 
+	P_TEST_CHECK (p_process_get_cpu_time () >= 0);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+#ifndef P_OS_WIN
+static psize
+pprocess_test_read_all (PProcess	*process,
+			PProcessStdio	stdio,
+			pchar		*buffer,
+			psize		buflen)
+{
+	psize	total = 0;
+	pssize	res;
+
+	while (total < buflen - 1) {
+		res = p_process_read (process, stdio, buffer + total, buflen - 1 - total, NULL);
+
+		if (res <= 0)
+			break;
+
+		total += (psize) res;
+	}
+
+	buffer[total] = '\0';
+
+	return total;
+}
+#endif
+
+P_TEST_CASE_BEGIN (pprocess_stats_test)
+{
+	PProcessStats	stats;
+	PError		*error = NULL;
+	PSocket		*socket;
+	pint64		open_fds;
+#ifndef P_OS_WIN
+	const pchar	*cat_argv[] = {"cat", NULL};
+	PProcess	*process;
+	pchar		buf[4];
+#endif
+
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_process_get_stats (p_process_get_current_pid (), NULL, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_INVALID_ARGUMENT);
+	p_error_free (error);
+
+	P_TEST_REQUIRE (p_process_get_stats (p_process_get_current_pid (), &stats, NULL) == TRUE);
+	P_TEST_CHECK (stats.user_time >= 0);
+	P_TEST_CHECK (stats.system_time >= 0);
+
+#if defined (P_OS_WIN) || defined (P_OS_LINUX) || defined (P_OS_MAC)
+	P_TEST_CHECK (stats.rss > 0);
+	P_TEST_CHECK (stats.virtual_size > 0);
+	P_TEST_CHECK (stats.open_fds > 0);
+
+	/* A new descriptor must be accounted */
+	open_fds = stats.open_fds;
+	socket   = p_socket_new (P_SOCKET_FAMILY_INET, P_SOCKET_TYPE_DATAGRAM, P_SOCKET_PROTOCOL_UDP, NULL);
+	P_TEST_REQUIRE (socket != NULL);
+
+	P_TEST_REQUIRE (p_process_get_stats (p_process_get_current_pid (), &stats, NULL) == TRUE);
+	P_TEST_CHECK (stats.open_fds > open_fds);
+
+	p_socket_free (socket);
+#else
+	P_UNUSED (socket);
+	P_UNUSED (open_fds);
+#endif
+
+#if defined (P_OS_LINUX) || defined (P_OS_MAC)
+	P_TEST_CHECK (stats.threads >= 1);
+	P_TEST_CHECK (stats.voluntary_switches >= 0);
+	P_TEST_CHECK (stats.involuntary_switches >= 0);
+
+	process = p_process_spawn ("cat",
+				   cat_argv,
+				   NULL,
+				   NULL,
+				   P_PROCESS_SPAWN_SEARCH_PATH |
+				   P_PROCESS_SPAWN_PIPE_STDIN  |
+				   P_PROCESS_SPAWN_PIPE_STDOUT,
+				   NULL);
+	P_TEST_REQUIRE (process != NULL);
+
+	/* Make sure the child has started up */
+	P_TEST_CHECK (p_process_write (process, "x", 1, NULL) == 1);
+	P_TEST_CHECK (p_process_read (process, P_PROCESS_STDIO_OUT, buf, sizeof (buf), NULL) == 1);
+
+	P_TEST_CHECK (p_process_get_stats (p_process_get_pid (process), &stats, NULL) == TRUE);
+	P_TEST_CHECK (stats.rss > 0);
+	P_TEST_CHECK (stats.threads == 1);
+	P_TEST_CHECK (stats.user_time >= 0);
+	P_TEST_CHECK (stats.open_fds >= 0);
+
+	P_TEST_CHECK (p_process_terminate (process, NULL) == TRUE);
+	P_TEST_CHECK (p_process_wait (process, -1, NULL, NULL) == TRUE);
+
+	p_process_free (process);
+#endif
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pprocess_bad_input_test)
+{
+	PError	*error = NULL;
+	pchar	buf[16];
+	pint	exit_code;
+
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_process_spawn (NULL, NULL, NULL, NULL, 0, &error) == NULL);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_INVALID_ARGUMENT);
+	p_error_free (error);
+	error = NULL;
+
+	P_TEST_CHECK (p_process_spawn ("cmd",
+				       NULL,
+				       NULL,
+				       NULL,
+				       P_PROCESS_SPAWN_PIPE_STDOUT | P_PROCESS_SPAWN_NULL_STDOUT,
+				       &error) == NULL);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_INVALID_ARGUMENT);
+	p_error_free (error);
+
+	P_TEST_CHECK (p_process_get_pid (NULL) == 0);
+	P_TEST_CHECK (p_process_get_stdio_socket (NULL, P_PROCESS_STDIO_OUT) == NULL);
+	P_TEST_CHECK (p_process_read (NULL, P_PROCESS_STDIO_OUT, buf, sizeof (buf), NULL) == -1);
+	P_TEST_CHECK (p_process_write (NULL, buf, sizeof (buf), NULL) == -1);
+	P_TEST_CHECK (p_process_close_stdio (NULL, P_PROCESS_STDIO_IN) == FALSE);
+	P_TEST_CHECK (p_process_wait (NULL, 0, &exit_code, NULL) == FALSE);
+	P_TEST_CHECK (p_process_terminate (NULL, NULL) == FALSE);
+
+	p_process_free (NULL);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pprocess_spawn_test)
+{
+#ifndef P_OS_WIN
+	const pchar	*cat_argv[] = {"cat", NULL};
+	const pchar	*sh_argv[]  = {"sh", "-c", "echo \"$PPROCESS_TEST:$(pwd)\"; echo err >&2; exit 3", NULL};
+	const pchar	*sh_envp[]  = {"PPROCESS_TEST=value", NULL};
+	PProcess	*process;
+	PError		*error = NULL;
+	pchar		buf[64];
+	pint		exit_code;
+
+	p_libsys_init ();
+
+	/* Data round trip through both pipes */
+	process = p_process_spawn ("cat",
+				   cat_argv,
+				   NULL,
+				   NULL,
+				   P_PROCESS_SPAWN_SEARCH_PATH |
+				   P_PROCESS_SPAWN_PIPE_STDIN  |
+				   P_PROCESS_SPAWN_PIPE_STDOUT,
+				   NULL);
+	P_TEST_REQUIRE (process != NULL);
+	P_TEST_CHECK (p_process_get_pid (process) > 0);
+	P_TEST_CHECK (p_process_get_stdio_socket (process, P_PROCESS_STDIO_OUT) == NULL);
+	P_TEST_CHECK (p_process_read (process, P_PROCESS_STDIO_ERR, buf, sizeof (buf), NULL) == -1);
+
+	P_TEST_CHECK (p_process_write (process, "plibsys", 7, NULL) == 7);
+	P_TEST_CHECK (p_process_close_stdio (process, P_PROCESS_STDIO_IN) == TRUE);
+	P_TEST_CHECK (p_process_close_stdio (process, P_PROCESS_STDIO_IN) == FALSE);
+	P_TEST_CHECK (p_process_write (process, "plibsys", 7, NULL) == -1);
+
+	P_TEST_CHECK (pprocess_test_read_all (process, P_PROCESS_STDIO_OUT, buf, sizeof (buf)) == 7);
+	P_TEST_CHECK (strcmp (buf, "plibsys") == 0);
+
+	exit_code = -1;
+	P_TEST_CHECK (p_process_wait (process, -1, &exit_code, NULL) == TRUE);
+	P_TEST_CHECK (exit_code == 0);
+
+	/* Result is stored after the process was reaped */
+	exit_code = -1;
+	P_TEST_CHECK (p_process_wait (process, 0, &exit_code, NULL) == TRUE);
+	P_TEST_CHECK (exit_code == 0);
+
+	p_process_free (process);
+
+	/* Environment, working directory and exit code */
+	process = p_process_spawn ("/bin/sh",
+				   sh_argv,
+				   sh_envp,
+				   "/",
+				   P_PROCESS_SPAWN_NULL_STDIN  |
+				   P_PROCESS_SPAWN_PIPE_STDOUT |
+				   P_PROCESS_SPAWN_PIPE_STDERR,
+				   NULL);
+	P_TEST_REQUIRE (process != NULL);
+
+	pprocess_test_read_all (process, P_PROCESS_STDIO_OUT, buf, sizeof (buf));
+	P_TEST_CHECK (strcmp (buf, "value:/\n") == 0);
+
+	pprocess_test_read_all (process, P_PROCESS_STDIO_ERR, buf, sizeof (buf));
+	P_TEST_CHECK (strcmp (buf, "err\n") == 0);
+
+	P_TEST_CHECK (p_process_wait (process, 10000, &exit_code, NULL) == TRUE);
+	P_TEST_CHECK (exit_code == 3);
+
+	p_process_free (process);
+
+	/* Missing executable */
+	P_TEST_CHECK (p_process_spawn ("/nonexistent/pprocess_test",
+				       NULL,
+				       NULL,
+				       NULL,
+				       P_PROCESS_SPAWN_DEFAULT,
+				       &error) == NULL);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_NOT_EXISTS);
+	p_error_free (error);
+
+	p_libsys_shutdown ();
+#endif
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pprocess_wait_test)
+{
+#ifndef P_OS_WIN
+	const pchar	*sleep_argv[] = {"sleep", "30", NULL};
+	PProcess	*process;
+	PError		*error = NULL;
+	pint		exit_code;
+
+	p_libsys_init ();
+
+	process = p_process_spawn ("sleep",
+				   sleep_argv,
+				   NULL,
+				   NULL,
+				   P_PROCESS_SPAWN_SEARCH_PATH,
+				   NULL);
+	P_TEST_REQUIRE (process != NULL);
+
+	P_TEST_CHECK (p_process_wait (process, 0, &exit_code, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_TIMED_OUT);
+	p_error_free (error);
+	error = NULL;
+
+	P_TEST_CHECK (p_process_wait (process, 50, &exit_code, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_TIMED_OUT);
+	p_error_free (error);
+
+	P_TEST_CHECK (p_process_terminate (process, NULL) == TRUE);
+	P_TEST_CHECK (p_process_wait (process, -1, &exit_code, NULL) == TRUE);
+	P_TEST_CHECK (exit_code == -9);
+	P_TEST_CHECK (p_process_terminate (process, NULL) == TRUE);
+
+	p_process_free (process);
+
+	p_libsys_shutdown ();
+#endif
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pprocess_socket_pipes_test)
+{
+#ifndef P_OS_WIN
+	const pchar		*cat_argv[] = {"cat", NULL};
+	PProcess		*process;
+	PSocketPoller		*poller;
+	PSocketPollerEvent	event;
+	PSocket			*sock_in;
+	PSocket			*sock_out;
+	pchar			buf[64];
+	pint			exit_code;
+
+	p_libsys_init ();
+
+	process = p_process_spawn ("cat",
+				   cat_argv,
+				   NULL,
+				   NULL,
+				   P_PROCESS_SPAWN_SEARCH_PATH |
+				   P_PROCESS_SPAWN_SOCKET_PIPES |
+				   P_PROCESS_SPAWN_PIPE_STDIN  |
+				   P_PROCESS_SPAWN_PIPE_STDOUT,
+				   NULL);
+	P_TEST_REQUIRE (process != NULL);
+
+	sock_in  = p_process_get_stdio_socket (process, P_PROCESS_STDIO_IN);
+	sock_out = p_process_get_stdio_socket (process, P_PROCESS_STDIO_OUT);
+
+	P_TEST_CHECK (sock_in != NULL);
+	P_TEST_CHECK (sock_out != NULL);
+	P_TEST_CHECK (p_process_get_stdio_socket (process, P_PROCESS_STDIO_ERR) == NULL);
+
+	poller = p_socket_poller_new (NULL);
+	P_TEST_REQUIRE (poller != NULL);
+
+	P_TEST_CHECK (p_socket_poller_add (poller,
+					   sock_out,
+					   P_SOCKET_POLLER_CONDITION_IN,
+					   P_SOCKET_POLLER_FLAG_NONE,
+					   process,
+					   NULL) == TRUE);
+
+	P_TEST_CHECK (p_process_write (process, "poll", 4, NULL) == 4);
+
+	P_TEST_CHECK (p_socket_poller_wait (poller, &event, 1, 10000, NULL) == 1);
+	P_TEST_CHECK (event.socket == sock_out);
+	P_TEST_CHECK (event.user_data == process);
+	P_TEST_CHECK ((event.conditions & P_SOCKET_POLLER_CONDITION_IN) != 0);
+
+	P_TEST_CHECK (p_socket_poller_remove (poller, sock_out, NULL) == TRUE);
+	p_socket_poller_free (poller);
+
+	P_TEST_CHECK (p_process_close_stdio (process, P_PROCESS_STDIO_IN) == TRUE);
+	P_TEST_CHECK (p_process_get_stdio_socket (process, P_PROCESS_STDIO_IN) == NULL);
+
+	P_TEST_CHECK (pprocess_test_read_all (process, P_PROCESS_STDIO_OUT, buf, sizeof (buf)) == 4);
+	P_TEST_CHECK (strcmp (buf, "poll") == 0);
+
+	P_TEST_CHECK (p_process_wait (process, -1, &exit_code, NULL) == TRUE);
+	P_TEST_CHECK (exit_code == 0);
+
+	p_process_free (process);
+
 	p_libsys_shutdown ();
+#endif
 }
 P_TEST_CASE_END ()
 
 P_TEST_SUITE_BEGIN()
 {
 	P_TEST_SUITE_RUN_CASE (pprocess_general_test);
+	P_TEST_SUITE_RUN_CASE (pprocess_stats_test);
+	P_TEST_SUITE_RUN_CASE (pprocess_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (pprocess_spawn_test);
+	P_TEST_SUITE_RUN_CASE (pprocess_wait_test);
+	P_TEST_SUITE_RUN_CASE (pprocess_socket_pipes_test);
 }
 P_TEST_SUITE_END()
@@ -0,0 +1,329 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+P_TEST_MODULE_INIT ();
+
+#define PQUEUEMPMC_PRODUCERS	2
+#define PQUEUEMPMC_CONSUMERS	2
+#define PQUEUEMPMC_ROUNDS	20000
+
+static PQueueMPMC *	global_queue       = NULL;
+static pboolean		global_blocking    = FALSE;
+static volatile pint	queue_received     = 0;
+static volatile pint	queue_out_of_order = 0;
+static volatile pint64	queue_sum          = 0;
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static void * queue_producer_thread (void *data)
+{
+	psize	producer = PPOINTER_TO_PSIZE (data);
+	psize	i;
+
+	for (i = 1; i <= PQUEUEMPMC_ROUNDS; ++i) {
+		ppointer value = PSIZE_TO_POINTER ((producer << 24) | i);
+
+		if (global_blocking) {
+			if (!p_queue_mpmc_push_wait (global_queue, value, -1))
+				p_uthread_exit (1);
+		} else {
+			while (!p_queue_mpmc_try_push (global_queue, value))
+				p_uthread_yield ();
+		}
+	}
+
+	p_uthread_exit (0);
+
+	return NULL;
+}
+
+static void * queue_consumer_thread (void *)
+{
+	psize		last[PQUEUEMPMC_PRODUCERS];
+	ppointer	value;
+	psize		producer;
+	psize		seq;
+	pint		i;
+
+	for (i = 0; i < PQUEUEMPMC_PRODUCERS; ++i)
+		last[i] = 0;
+
+	while (p_atomic_int_get (&queue_received) < PQUEUEMPMC_PRODUCERS * PQUEUEMPMC_ROUNDS) {
+		if (global_blocking) {
+			if (!p_queue_mpmc_pop_wait (global_queue, &value, 10))
+				continue;
+		} else if (!p_queue_mpmc_try_pop (global_queue, &value)) {
+			p_uthread_yield ();
+			continue;
+		}
+
+		producer = PPOINTER_TO_PSIZE (value) >> 24;
+		seq      = PPOINTER_TO_PSIZE (value) & 0xFFFFFF;
+
+		/* Values from one producer come in order */
+		if (producer >= PQUEUEMPMC_PRODUCERS || seq <= last[producer])
+			p_atomic_int_inc (&queue_out_of_order);
+		else
+			last[producer] = seq;
+
+		p_atomic_int64_add (&queue_sum, (pint64) seq);
+		p_atomic_int_inc (&queue_received);
+	}
+
+	p_uthread_exit (0);
+
+	return NULL;
+}
+
+static pboolean queue_run_threads (pboolean blocking)
+{
+	PUThread	*thr[PQUEUEMPMC_PRODUCERS + PQUEUEMPMC_CONSUMERS];
+	pint64		expected;
+	pboolean	ret;
+	pint		i;
+
+	global_blocking = blocking;
+
+	p_atomic_int_set (&queue_received, 0);
+	p_atomic_int_set (&queue_out_of_order, 0);
+	p_atomic_int64_set (&queue_sum, 0);
+
+	for (i = 0; i < PQUEUEMPMC_PRODUCERS; ++i) {
+		thr[i] = p_uthread_create ((PUThreadFunc) queue_producer_thread, PSIZE_TO_POINTER (i), TRUE, NULL);
+
+		if (thr[i] == NULL)
+			return FALSE;
+	}
+
+	for (i = PQUEUEMPMC_PRODUCERS; i < PQUEUEMPMC_PRODUCERS + PQUEUEMPMC_CONSUMERS; ++i) {
+		thr[i] = p_uthread_create ((PUThreadFunc) queue_consumer_thread, NULL, TRUE, NULL);
+
+		if (thr[i] == NULL)
+			return FALSE;
+	}
+
+	ret = TRUE;
+
+	for (i = 0; i < PQUEUEMPMC_PRODUCERS + PQUEUEMPMC_CONSUMERS; ++i) {
+		if (p_uthread_join (thr[i]) != 0)
+			ret = FALSE;
+
+		p_uthread_unref (thr[i]);
+	}
+
+	expected = (pint64) PQUEUEMPMC_PRODUCERS * PQUEUEMPMC_ROUNDS * (PQUEUEMPMC_ROUNDS + 1) / 2;
+
+	return ret                                                                         &&
+	       p_atomic_int_get (&queue_received) == PQUEUEMPMC_PRODUCERS * PQUEUEMPMC_ROUNDS &&
+	       p_atomic_int_get (&queue_out_of_order) == 0                                   &&
+	       p_atomic_int64_get (&queue_sum) == expected                                   &&
+	       p_queue_mpmc_get_size (global_queue) == 0;
+}
+
+P_TEST_CASE_BEGIN (pqueuempmc_nomem_test)
+{
+	p_libsys_init ();
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+	P_TEST_CHECK (p_queue_mpmc_new (16, FALSE) == NULL);
+	P_TEST_CHECK (p_queue_mpmc_new (16, TRUE) == NULL);
+
+	p_mem_restore_vtable ();
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pqueuempmc_bad_input_test)
+{
+	ppointer value;
+
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_queue_mpmc_new (P_MAXSIZE, FALSE) == NULL);
+	P_TEST_CHECK (p_queue_mpmc_try_push (NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_queue_mpmc_try_pop (NULL, &value) == FALSE);
+	P_TEST_CHECK (p_queue_mpmc_try_push_batch (NULL, &value, 1) == 0);
+	P_TEST_CHECK (p_queue_mpmc_try_pop_batch (NULL, &value, 1) == 0);
+	P_TEST_CHECK (p_queue_mpmc_push_wait (NULL, NULL, 0) == FALSE);
+	P_TEST_CHECK (p_queue_mpmc_pop_wait (NULL, &value, 0) == FALSE);
+	P_TEST_CHECK (p_queue_mpmc_get_capacity (NULL) == 0);
+	P_TEST_CHECK (p_queue_mpmc_get_size (NULL) == 0);
+	p_queue_mpmc_free (NULL);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pqueuempmc_general_test)
+{
+	PQueueMPMC	*queue;
+	ppointer	values[16];
+	ppointer	value;
+	psize		i;
+
+	p_libsys_init ();
+
+	queue = p_queue_mpmc_new (0, FALSE);
+	P_TEST_REQUIRE (queue != NULL);
+	P_TEST_CHECK (p_queue_mpmc_get_capacity (queue) == 2);
+	p_queue_mpmc_free (queue);
+
+	queue = p_queue_mpmc_new (5, FALSE);
+	P_TEST_REQUIRE (queue != NULL);
+	P_TEST_CHECK (p_queue_mpmc_get_capacity (queue) == 8);
+	P_TEST_CHECK (p_queue_mpmc_get_size (queue) == 0);
+
+	P_TEST_CHECK (p_queue_mpmc_try_pop (queue, NULL) == FALSE);
+	P_TEST_CHECK (p_queue_mpmc_try_pop (queue, &value) == FALSE);
+
+	/* Without the blocking support waiting always fails */
+	P_TEST_CHECK (p_queue_mpmc_push_wait (queue, NULL, 0) == FALSE);
+	P_TEST_CHECK (p_queue_mpmc_pop_wait (queue, &value, 0) == FALSE);
+
+	/* Wrap around the ring a few times */
+	for (pint round = 0; round < 3; ++round) {
+		for (i = 0; i < 8; ++i)
+			P_TEST_CHECK (p_queue_mpmc_try_push (queue, PSIZE_TO_POINTER (i)) == TRUE);
+
+		P_TEST_CHECK (p_queue_mpmc_try_push (queue, NULL) == FALSE);
+		P_TEST_CHECK (p_queue_mpmc_get_size (queue) == 8);
+
+		for (i = 0; i < 8; ++i) {
+			P_TEST_CHECK (p_queue_mpmc_try_pop (queue, &value) == TRUE);
+			P_TEST_CHECK (value == PSIZE_TO_POINTER (i));
+		}
+
+		P_TEST_CHECK (p_queue_mpmc_try_pop (queue, &value) == FALSE);
+		P_TEST_CHECK (p_queue_mpmc_get_size (queue) == 0);
+	}
+
+	/* NULL is a valid value */
+	P_TEST_CHECK (p_queue_mpmc_try_push (queue, NULL) == TRUE);
+	value = PSIZE_TO_POINTER (1);
+	P_TEST_CHECK (p_queue_mpmc_try_pop (queue, &value) == TRUE);
+	P_TEST_CHECK (value == NULL);
+
+	for (i = 0; i < 16; ++i)
+		values[i] = PSIZE_TO_POINTER (i + 100);
+
+	P_TEST_CHECK (p_queue_mpmc_try_push_batch (queue, values, 0) == 0);
+	P_TEST_CHECK (p_queue_mpmc_try_push_batch (queue, values, 5) == 5);
+	P_TEST_CHECK (p_queue_mpmc_try_push_batch (queue, values + 5, 11) == 3);
+	P_TEST_CHECK (p_queue_mpmc_get_size (queue) == 8);
+
+	for (i = 0; i < 16; ++i)
+		values[i] = NULL;
+
+	P_TEST_CHECK (p_queue_mpmc_try_pop_batch (queue, values, 3) == 3);
+	P_TEST_CHECK (p_queue_mpmc_try_pop_batch (queue, values + 3, 13) == 5);
+	P_TEST_CHECK (p_queue_mpmc_try_pop_batch (queue, values, 16) == 0);
+
+	for (i = 0; i < 8; ++i)
+		P_TEST_CHECK (values[i] == PSIZE_TO_POINTER (i + 100));
+
+	p_queue_mpmc_free (queue);
+
+	/* Blocking calls with timeouts */
+	queue = p_queue_mpmc_new (2, TRUE);
+	P_TEST_REQUIRE (queue != NULL);
+
+	P_TEST_CHECK (p_queue_mpmc_pop_wait (queue, NULL, 0) == FALSE);
+	P_TEST_CHECK (p_queue_mpmc_pop_wait (queue, &value, 0) == FALSE);
+	P_TEST_CHECK (p_queue_mpmc_pop_wait (queue, &value, 20) == FALSE);
+
+	P_TEST_CHECK (p_queue_mpmc_push_wait (queue, PSIZE_TO_POINTER (1), 0) == TRUE);
+	P_TEST_CHECK (p_queue_mpmc_push_wait (queue, PSIZE_TO_POINTER (2), 20) == TRUE);
+	P_TEST_CHECK (p_queue_mpmc_push_wait (queue, PSIZE_TO_POINTER (3), 0) == FALSE);
+	P_TEST_CHECK (p_queue_mpmc_push_wait (queue, PSIZE_TO_POINTER (3), 20) == FALSE);
+
+	P_TEST_CHECK (p_queue_mpmc_pop_wait (queue, &value, 20) == TRUE);
+	P_TEST_CHECK (value == PSIZE_TO_POINTER (1));
+	P_TEST_CHECK (p_queue_mpmc_try_pop (queue, &value) == TRUE);
+	P_TEST_CHECK (value == PSIZE_TO_POINTER (2));
+
+	p_queue_mpmc_free (queue);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pqueuempmc_thread_test)
+{
+	p_libsys_init ();
+
+	global_queue = p_queue_mpmc_new (64, FALSE);
+	P_TEST_REQUIRE (global_queue != NULL);
+
+	P_TEST_CHECK (queue_run_threads (FALSE) == TRUE);
+
+	p_queue_mpmc_free (global_queue);
+
+	/* Small queue makes both sides sleep */
+	global_queue = p_queue_mpmc_new (4, TRUE);
+	P_TEST_REQUIRE (global_queue != NULL);
+
+	P_TEST_CHECK (queue_run_threads (TRUE) == TRUE);
+
+	p_queue_mpmc_free (global_queue);
+	global_queue = NULL;
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pqueuempmc_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pqueuempmc_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (pqueuempmc_general_test);
+	P_TEST_SUITE_RUN_CASE (pqueuempmc_thread_test);
+}
+P_TEST_SUITE_END()
@@ -0,0 +1,605 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+P_TEST_MODULE_INIT ();
+
+#define PRADIXTREE_MIN(a, b)	((a) < (b) ? (a) : (b))
+#define PRADIXTREE_MAX(a, b)	((a) > (b) ? (a) : (b))
+
+#define PRADIXTREE_POOL_SIZE	5000
+#define PRADIXTREE_MAX_KEY	12
+#define PRADIXTREE_ITERATIONS	50000
+
+typedef struct PRadixTreeTestKey_ {
+	puint8		data[PRADIXTREE_MAX_KEY];
+	psize		len;
+	pboolean	present;
+	pint		value;
+} PRadixTreeTestKey;
+
+typedef struct PRadixTreeTestWalk_ {
+	const PRadixTreeTestKey	*pool;
+	psize			pool_size;
+	psize			pos;
+	psize			visited;
+	psize			stop_at;
+	pboolean		failed;
+} PRadixTreeTestWalk;
+
+static pint destroy_count = 0;
+static puint32 rand_state = 12345;
+
+static PRadixTreeTestKey test_pool[PRADIXTREE_POOL_SIZE];
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+extern "C" void test_destroy_func (ppointer data)
+{
+	P_UNUSED (data);
+
+	++destroy_count;
+}
+
+static puint32 test_rand (void)
+{
+	rand_state ^= rand_state << 13;
+	rand_state ^= rand_state >> 17;
+	rand_state ^= rand_state << 5;
+
+	return rand_state;
+}
+
+static int test_key_compare (const void *a, const void *b)
+{
+	const PRadixTreeTestKey *ka = (const PRadixTreeTestKey *) a;
+	const PRadixTreeTestKey *kb = (const PRadixTreeTestKey *) b;
+
+	int res = memcmp (ka->data, kb->data, PRADIXTREE_MIN (ka->len, kb->len));
+
+	if (res != 0)
+		return res;
+
+	return ka->len < kb->len ? -1 : (ka->len > kb->len ? 1 : 0);
+}
+
+/* Checks that the keys come in the order of the sorted pool */
+extern "C" pboolean test_walk_func (const puint8 *key, psize key_len, ppointer value, ppointer user_data)
+{
+	PRadixTreeTestWalk *walk = (PRadixTreeTestWalk *) user_data;
+
+	while (walk->pos < walk->pool_size && !walk->pool[walk->pos].present)
+		++walk->pos;
+
+	if (walk->pos == walk->pool_size ||
+	    walk->pool[walk->pos].len != key_len ||
+	    memcmp (walk->pool[walk->pos].data, key, key_len) != 0 ||
+	    walk->pool[walk->pos].value != PPOINTER_TO_INT (value))
+		walk->failed = TRUE;
+
+	++walk->pos;
+	++walk->visited;
+
+	return walk->visited == walk->stop_at;
+}
+
+extern "C" pboolean test_collect_func (const puint8 *key, psize key_len, ppointer value, ppointer user_data)
+{
+	pchar *buf = (pchar *) user_data;
+
+	P_UNUSED (value);
+
+	strncat (buf, (const pchar *) key, key_len);
+	strcat (buf, ";");
+
+	return FALSE;
+}
+
+static pboolean test_insert_str (PRadixTree *tree, const pchar *key, pint value)
+{
+	return p_radix_tree_insert (tree, (const puint8 *) key, strlen (key), PINT_TO_POINTER (value));
+}
+
+static ppointer test_lookup_str (PRadixTree *tree, const pchar *key)
+{
+	return p_radix_tree_lookup (tree, (const puint8 *) key, strlen (key));
+}
+
+static pboolean test_remove_str (PRadixTree *tree, const pchar *key)
+{
+	return p_radix_tree_remove (tree, (const puint8 *) key, strlen (key));
+}
+
+static void test_collect_str (PRadixTree *tree, const pchar *prefix, pchar *buf)
+{
+	buf[0] = '\0';
+	p_radix_tree_foreach_prefix (tree, (const puint8 *) prefix, strlen (prefix), test_collect_func, buf);
+}
+
+P_TEST_CASE_BEGIN (pradixtree_nomem_test)
+{
+	p_libsys_init ();
+
+	PRadixTree *tree = p_radix_tree_new ();
+	P_TEST_REQUIRE (tree != NULL);
+
+	P_TEST_CHECK (test_insert_str (tree, "abc", 1) == TRUE);
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (p_radix_tree_new () == NULL);
+	P_TEST_CHECK (test_insert_str (tree, "abd", 2) == FALSE);
+
+	p_mem_restore_vtable ();
+
+	P_TEST_CHECK (p_radix_tree_get_count (tree) == 1);
+	P_TEST_CHECK (test_lookup_str (tree, "abc") == PINT_TO_POINTER (1));
+	P_TEST_CHECK (test_lookup_str (tree, "abd") == (ppointer) -1);
+
+	p_radix_tree_free (tree);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pradixtree_invalid_test)
+{
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_radix_tree_insert (NULL, (const puint8 *) "a", 1, NULL) == FALSE);
+	P_TEST_CHECK (p_radix_tree_lookup (NULL, (const puint8 *) "a", 1) == (ppointer) -1);
+	P_TEST_CHECK (p_radix_tree_lookup_longest (NULL, (const puint8 *) "a", 1, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_radix_tree_remove (NULL, (const puint8 *) "a", 1) == FALSE);
+	P_TEST_CHECK (p_radix_tree_get_count (NULL) == 0);
+
+	p_radix_tree_foreach_prefix (NULL, NULL, 0, test_collect_func, NULL);
+	p_radix_tree_clear (NULL);
+	p_radix_tree_free (NULL);
+
+	PRadixTree *tree = p_radix_tree_new ();
+	P_TEST_REQUIRE (tree != NULL);
+
+	P_TEST_CHECK (p_radix_tree_insert (tree, NULL, 1, NULL) == FALSE);
+	P_TEST_CHECK (p_radix_tree_lookup (tree, NULL, 1) == (ppointer) -1);
+	P_TEST_CHECK (p_radix_tree_remove (tree, NULL, 1) == FALSE);
+	P_TEST_CHECK (p_radix_tree_lookup (tree, NULL, 0) == (ppointer) -1);
+
+	p_radix_tree_free (tree);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pradixtree_general_test)
+{
+	p_libsys_init ();
+
+	PRadixTree	*tree = p_radix_tree_new_full (test_destroy_func);
+	pchar		buf[256];
+	psize		prefix_len;
+	ppointer	value;
+
+	P_TEST_REQUIRE (tree != NULL);
+
+	P_TEST_CHECK (test_insert_str (tree, "romane", 1) == TRUE);
+	P_TEST_CHECK (test_insert_str (tree, "romanus", 2) == TRUE);
+	P_TEST_CHECK (test_insert_str (tree, "romulus", 3) == TRUE);
+	P_TEST_CHECK (test_insert_str (tree, "rubens", 4) == TRUE);
+	P_TEST_CHECK (test_insert_str (tree, "ruber", 5) == TRUE);
+	P_TEST_CHECK (test_insert_str (tree, "rubicon", 6) == TRUE);
+	P_TEST_CHECK (test_insert_str (tree, "rubicundus", 7) == TRUE);
+	P_TEST_CHECK (test_insert_str (tree, "rub", 8) == TRUE);
+	P_TEST_CHECK (test_insert_str (tree, "r", 9) == TRUE);
+	P_TEST_CHECK (p_radix_tree_insert (tree, NULL, 0, PINT_TO_POINTER (10)) == TRUE);
+	P_TEST_CHECK (p_radix_tree_get_count (tree) == 10);
+
+	P_TEST_CHECK (test_lookup_str (tree, "romane") == PINT_TO_POINTER (1));
+	P_TEST_CHECK (test_lookup_str (tree, "rubicundus") == PINT_TO_POINTER (7));
+	P_TEST_CHECK (test_lookup_str (tree, "rub") == PINT_TO_POINTER (8));
+	P_TEST_CHECK (test_lookup_str (tree, "r") == PINT_TO_POINTER (9));
+	P_TEST_CHECK (test_lookup_str (tree, "") == PINT_TO_POINTER (10));
+	P_TEST_CHECK (test_lookup_str (tree, "ru") == (ppointer) -1);
+	P_TEST_CHECK (test_lookup_str (tree, "roman") == (ppointer) -1);
+	P_TEST_CHECK (test_lookup_str (tree, "romanes") == (ppointer) -1);
+	P_TEST_CHECK (test_lookup_str (tree, "x") == (ppointer) -1);
+
+	/* Replacing the value */
+	P_TEST_CHECK (test_insert_str (tree, "ruber", 50) == TRUE);
+	P_TEST_CHECK (test_lookup_str (tree, "ruber") == PINT_TO_POINTER (50));
+	P_TEST_CHECK (p_radix_tree_get_count (tree) == 10);
+	P_TEST_CHECK (destroy_count == 1);
+
+	test_collect_str (tree, "", buf);
+	P_TEST_CHECK (strcmp (buf, ";r;romane;romanus;romulus;rub;rubens;ruber;rubicon;rubicundus;") == 0);
+
+	test_collect_str (tree, "rub", buf);
+	P_TEST_CHECK (strcmp (buf, "rub;rubens;ruber;rubicon;rubicundus;") == 0);
+
+	test_collect_str (tree, "rubi", buf);
+	P_TEST_CHECK (strcmp (buf, "rubicon;rubicundus;") == 0);
+
+	test_collect_str (tree, "roma", buf);
+	P_TEST_CHECK (strcmp (buf, "romane;romanus;") == 0);
+
+	test_collect_str (tree, "romulus", buf);
+	P_TEST_CHECK (strcmp (buf, "romulus;") == 0);
+
+	test_collect_str (tree, "romulusx", buf);
+	P_TEST_CHECK (strcmp (buf, "") == 0);
+
+	test_collect_str (tree, "rx", buf);
+	P_TEST_CHECK (strcmp (buf, "") == 0);
+
+	/* Longest prefix match */
+	P_TEST_CHECK (p_radix_tree_lookup_longest (tree, (const puint8 *) "rubicons", 8, &prefix_len, &value) == TRUE);
+	P_TEST_CHECK (prefix_len == 7 && value == PINT_TO_POINTER (6));
+
+	P_TEST_CHECK (p_radix_tree_lookup_longest (tree, (const puint8 *) "rubi", 4, &prefix_len, &value) == TRUE);
+	P_TEST_CHECK (prefix_len == 3 && value == PINT_TO_POINTER (8));
+
+	P_TEST_CHECK (p_radix_tree_lookup_longest (tree, (const puint8 *) "roman", 5, &prefix_len, &value) == TRUE);
+	P_TEST_CHECK (prefix_len == 1 && value == PINT_TO_POINTER (9));
+
+	P_TEST_CHECK (p_radix_tree_lookup_longest (tree, (const puint8 *) "x", 1, &prefix_len, &value) == TRUE);
+	P_TEST_CHECK (prefix_len == 0 && value == PINT_TO_POINTER (10));
+
+	/* Removals with the path compaction */
+	P_TEST_CHECK (p_radix_tree_remove (tree, NULL, 0) == TRUE);
+	P_TEST_CHECK (p_radix_tree_lookup_longest (tree, (const puint8 *) "x", 1, NULL, NULL) == FALSE);
+	P_TEST_CHECK (test_remove_str (tree, "rub") == TRUE);
+	P_TEST_CHECK (test_remove_str (tree, "rub") == FALSE);
+	P_TEST_CHECK (test_remove_str (tree, "rubi") == FALSE);
+	P_TEST_CHECK (test_remove_str (tree, "rubicon") == TRUE);
+	P_TEST_CHECK (test_remove_str (tree, "ruber") == TRUE);
+	P_TEST_CHECK (test_remove_str (tree, "romanus") == TRUE);
+	P_TEST_CHECK (p_radix_tree_get_count (tree) == 5);
+	P_TEST_CHECK (destroy_count == 6);
+
+	test_collect_str (tree, "", buf);
+	P_TEST_CHECK (strcmp (buf, "r;romane;romulus;rubens;rubicundus;") == 0);
+
+	P_TEST_CHECK (p_radix_tree_lookup_longest (tree, (const puint8 *) "rubicundusx", 11, &prefix_len, NULL) == TRUE);
+	P_TEST_CHECK (prefix_len == 10);
+
+	P_TEST_CHECK (test_lookup_str (tree, "romane") == PINT_TO_POINTER (1));
+	P_TEST_CHECK (test_lookup_str (tree, "rubens") == PINT_TO_POINTER (4));
+
+	p_radix_tree_clear (tree);
+	P_TEST_CHECK (p_radix_tree_get_count (tree) == 0);
+	P_TEST_CHECK (destroy_count == 11);
+	P_TEST_CHECK (test_lookup_str (tree, "r") == (ppointer) -1);
+
+	P_TEST_CHECK (test_insert_str (tree, "after", 1) == TRUE);
+	p_radix_tree_free (tree);
+	P_TEST_CHECK (destroy_count == 12);
+
+	destroy_count = 0;
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pradixtree_long_prefix_test)
+{
+	p_libsys_init ();
+
+	PRadixTree	*tree = p_radix_tree_new ();
+	pchar		buf[512];
+
+	P_TEST_REQUIRE (tree != NULL);
+
+	/* Shared prefixes are longer than the stored part */
+	P_TEST_CHECK (test_insert_str (tree, "/usr/local/share/plibsys/a", 1) == TRUE);
+	P_TEST_CHECK (test_insert_str (tree, "/usr/local/share/plibsys/b", 2) == TRUE);
+	P_TEST_CHECK (test_insert_str (tree, "/usr/local/share/doc", 3) == TRUE);
+	P_TEST_CHECK (test_insert_str (tree, "/usr/local/lib", 4) == TRUE);
+	P_TEST_CHECK (test_insert_str (tree, "/usr/lib", 5) == TRUE);
+	P_TEST_CHECK (test_insert_str (tree, "/usr/local/share/plibsys", 6) == TRUE);
+
+	P_TEST_CHECK (test_lookup_str (tree, "/usr/local/share/plibsys/a") == PINT_TO_POINTER (1));
+	P_TEST_CHECK (test_lookup_str (tree, "/usr/local/share/plibsys/b") == PINT_TO_POINTER (2));
+	P_TEST_CHECK (test_lookup_str (tree, "/usr/local/share/doc") == PINT_TO_POINTER (3));
+	P_TEST_CHECK (test_lookup_str (tree, "/usr/local/lib") == PINT_TO_POINTER (4));
+	P_TEST_CHECK (test_lookup_str (tree, "/usr/lib") == PINT_TO_POINTER (5));
+	P_TEST_CHECK (test_lookup_str (tree, "/usr/local/share/plibsys") == PINT_TO_POINTER (6));
+	P_TEST_CHECK (test_lookup_str (tree, "/usr/local/share/plibsyz/a") == (ppointer) -1);
+	P_TEST_CHECK (test_lookup_str (tree, "/usr/local/shore/plibsys/a") == (ppointer) -1);
+
+	test_collect_str (tree, "/usr/local/sh", buf);
+	P_TEST_CHECK (strcmp (buf, "/usr/local/share/doc;/usr/local/share/plibsys;"
+				   "/usr/local/share/plibsys/a;/usr/local/share/plibsys/b;") == 0);
+
+	test_collect_str (tree, "/usr/local/shore", buf);
+	P_TEST_CHECK (strcmp (buf, "") == 0);
+
+	psize prefix_len = 0;
+
+	P_TEST_CHECK (p_radix_tree_lookup_longest (tree,
+						   (const puint8 *) "/usr/local/share/plibsys/c",
+						   26,
+						   &prefix_len,
+						   NULL) == TRUE);
+	P_TEST_CHECK (prefix_len == 24);
+
+	P_TEST_CHECK (p_radix_tree_lookup_longest (tree,
+						   (const puint8 *) "/usr/local/shore/plibsys/c",
+						   26,
+						   &prefix_len,
+						   NULL) == FALSE);
+
+	/* Removal merges the paths back */
+	P_TEST_CHECK (test_remove_str (tree, "/usr/local/lib") == TRUE);
+	P_TEST_CHECK (test_remove_str (tree, "/usr/lib") == TRUE);
+	P_TEST_CHECK (test_remove_str (tree, "/usr/local/share/doc") == TRUE);
+
+	P_TEST_CHECK (test_lookup_str (tree, "/usr/local/share/plibsys/a") == PINT_TO_POINTER (1));
+	P_TEST_CHECK (test_lookup_str (tree, "/usr/local/share/plibsys/b") == PINT_TO_POINTER (2));
+	P_TEST_CHECK (test_lookup_str (tree, "/usr/local/share/plibsys") == PINT_TO_POINTER (6));
+
+	P_TEST_CHECK (test_insert_str (tree, "/usr/local/share/plibsys/aa", 7) == TRUE);
+	P_TEST_CHECK (test_insert_str (tree, "/usr/local/sha", 8) == TRUE);
+
+	test_collect_str (tree, "", buf);
+	P_TEST_CHECK (strcmp (buf, "/usr/local/sha;/usr/local/share/plibsys;/usr/local/share/plibsys/a;"
+				   "/usr/local/share/plibsys/aa;/usr/local/share/plibsys/b;") == 0);
+
+	p_radix_tree_free (tree);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pradixtree_fanout_test)
+{
+	p_libsys_init ();
+
+	PRadixTree	*tree = p_radix_tree_new ();
+	puint8		key[3];
+	pint		i;
+	pint		j;
+
+	P_TEST_REQUIRE (tree != NULL);
+
+	/* Integer keys in big-endian order grow the nodes up to 256 children */
+	for (i = 0; i < 256; ++i) {
+		key[0] = 0x10;
+		key[1] = (puint8) i;
+		key[2] = (puint8) (255 - i);
+
+		P_TEST_CHECK (p_radix_tree_insert (tree, key, 3, PINT_TO_POINTER (i)) == TRUE);
+
+		for (j = 0; j <= i; ++j) {
+			key[1] = (puint8) j;
+			key[2] = (puint8) (255 - j);
+
+			if (p_radix_tree_lookup (tree, key, 3) != PINT_TO_POINTER (j))
+				break;
+		}
+
+		P_TEST_CHECK (j == i + 1);
+	}
+
+	P_TEST_CHECK (p_radix_tree_get_count (tree) == 256);
+
+	/* And shrink them back in a shuffled order */
+	for (i = 0; i < 256; ++i) {
+		key[1] = (puint8) ((i * 7) & 0xFF);
+		key[2] = (puint8) (255 - key[1]);
+
+		P_TEST_CHECK (p_radix_tree_remove (tree, key, 3) == TRUE);
+
+		for (j = 0; j < 256; ++j) {
+			key[1] = (puint8) ((j * 7) & 0xFF);
+			key[2] = (puint8) (255 - key[1]);
+
+			if ((p_radix_tree_lookup (tree, key, 3) == (ppointer) -1) != (j <= i))
+				break;
+		}
+
+		P_TEST_CHECK (j == 256);
+	}
+
+	P_TEST_CHECK (p_radix_tree_get_count (tree) == 0);
+
+	p_radix_tree_free (tree);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pradixtree_stress_test)
+{
+	p_libsys_init ();
+
+	PRadixTree		*tree = p_radix_tree_new ();
+	PRadixTreeTestWalk	walk;
+	psize			pool_size;
+	psize			count;
+	psize			i;
+	psize			j;
+
+	P_TEST_REQUIRE (tree != NULL);
+
+	/* A small alphabet produces many shared prefixes */
+	for (i = 0; i < PRADIXTREE_POOL_SIZE; ++i) {
+		test_pool[i].len = test_rand () % (PRADIXTREE_MAX_KEY + 1);
+
+		for (j = 0; j < test_pool[i].len; ++j)
+			test_pool[i].data[j] = (puint8) (test_rand () % 4 == 0 ? test_rand () % 256 : test_rand () % 3);
+
+		test_pool[i].present = FALSE;
+		test_pool[i].value   = 0;
+	}
+
+	qsort (test_pool, PRADIXTREE_POOL_SIZE, sizeof (PRadixTreeTestKey), test_key_compare);
+
+	for (i = 1, pool_size = 1; i < PRADIXTREE_POOL_SIZE; ++i) {
+		if (test_key_compare (&test_pool[pool_size - 1], &test_pool[i]) != 0)
+			test_pool[pool_size++] = test_pool[i];
+	}
+
+	for (i = 0, count = 0; i < PRADIXTREE_ITERATIONS; ++i) {
+		PRadixTreeTestKey *k = &test_pool[test_rand () % pool_size];
+
+		if (test_rand () % 3 != 0) {
+			k->value = (pint) (test_rand () & 0xFFFF);
+
+			P_TEST_CHECK (p_radix_tree_insert (tree, k->data, k->len, PINT_TO_POINTER (k->value)) == TRUE);
+
+			if (!k->present)
+				++count;
+
+			k->present = TRUE;
+		} else {
+			P_TEST_CHECK (p_radix_tree_remove (tree, k->data, k->len) == k->present);
+
+			if (k->present)
+				--count;
+
+			k->present = FALSE;
+		}
+	}
+
+	P_TEST_CHECK (p_radix_tree_get_count (tree) == count);
+
+	for (i = 0; i < pool_size; ++i) {
+		ppointer val = p_radix_tree_lookup (tree, test_pool[i].data, test_pool[i].len);
+
+		if (test_pool[i].present)
+			P_TEST_CHECK (val == PINT_TO_POINTER (test_pool[i].value));
+		else
+			P_TEST_CHECK (val == (ppointer) -1);
+	}
+
+	/* Full traversal goes in the sorted order */
+	memset (&walk, 0, sizeof (walk));
+	walk.pool      = test_pool;
+	walk.pool_size = pool_size;
+
+	p_radix_tree_foreach_prefix (tree, NULL, 0, test_walk_func, &walk);
+
+	P_TEST_CHECK (walk.failed == FALSE);
+	P_TEST_CHECK (walk.visited == count);
+
+	/* Traversal can be stopped */
+	memset (&walk, 0, sizeof (walk));
+	walk.pool      = test_pool;
+	walk.pool_size = pool_size;
+	walk.stop_at   = 10;
+
+	p_radix_tree_foreach_prefix (tree, NULL, 0, test_walk_func, &walk);
+
+	P_TEST_CHECK (walk.failed == FALSE);
+	P_TEST_CHECK (walk.visited == 10);
+
+	/* Prefix traversal and the longest prefix match against a linear scan */
+	for (i = 0; i < pool_size; i += 7) {
+		const PRadixTreeTestKey	*k = &test_pool[i];
+		psize			expected_count = 0;
+		psize			expected_len = 0;
+		pboolean		expected_found = FALSE;
+		psize			found_len;
+		ppointer		found_val;
+
+		for (j = 0; j < pool_size; ++j) {
+			if (!test_pool[j].present)
+				continue;
+
+			if (test_pool[j].len >= k->len && memcmp (test_pool[j].data, k->data, k->len) == 0)
+				++expected_count;
+
+			if (test_pool[j].len <= k->len && memcmp (test_pool[j].data, k->data, test_pool[j].len) == 0) {
+				expected_found = TRUE;
+				expected_len   = PRADIXTREE_MAX (expected_len, test_pool[j].len);
+			}
+		}
+
+		memset (&walk, 0, sizeof (walk));
+		walk.pool      = test_pool;
+		walk.pool_size = pool_size;
+		walk.pos       = i;
+
+		p_radix_tree_foreach_prefix (tree, k->data, k->len, test_walk_func, &walk);
+
+		P_TEST_CHECK (walk.failed == FALSE);
+		P_TEST_CHECK (walk.visited == expected_count);
+
+		P_TEST_CHECK (p_radix_tree_lookup_longest (tree, k->data, k->len, &found_len, &found_val) == expected_found);
+
+		if (expected_found)
+			P_TEST_CHECK (found_len == expected_len);
+	}
+
+	/* Remove everything */
+	for (i = 0; i < pool_size; ++i) {
+		if (test_pool[i].present)
+			P_TEST_CHECK (p_radix_tree_remove (tree, test_pool[i].data, test_pool[i].len) == TRUE);
+	}
+
+	P_TEST_CHECK (p_radix_tree_get_count (tree) == 0);
+
+	p_radix_tree_free (tree);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pradixtree_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pradixtree_invalid_test);
+	P_TEST_SUITE_RUN_CASE (pradixtree_general_test);
+	P_TEST_SUITE_RUN_CASE (pradixtree_long_prefix_test);
+	P_TEST_SUITE_RUN_CASE (pradixtree_fanout_test);
+	P_TEST_SUITE_RUN_CASE (pradixtree_stress_test);
+}
+P_TEST_SUITE_END()
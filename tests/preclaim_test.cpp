@@ -0,0 +1,450 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+P_TEST_MODULE_INIT ();
+
+#define PRECLAIM_READERS	2
+#define PRECLAIM_WRITERS	2
+#define PRECLAIM_ROUNDS		2000
+#define PRECLAIM_NODES		(PRECLAIM_WRITERS * PRECLAIM_ROUNDS + 1)
+
+typedef struct PReclaimTestNode_ {
+	volatile pint	alive;
+	pint		value;
+} PReclaimTestNode;
+
+/* Nodes are never really freed, so a premature free shows up as a dead node */
+static PReclaimTestNode		reclaim_nodes[PRECLAIM_NODES];
+static volatile pint		reclaim_next_node = 0;
+static volatile pint		reclaim_freed     = 0;
+static volatile pint		reclaim_dead_seen = 0;
+static volatile pint		reclaim_writers   = 0;
+static PReclaimTestNode * volatile reclaim_current = NULL;
+static PEpochDomain *		global_epoch       = NULL;
+static PHazardDomain *		global_hazard      = NULL;
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static void node_free (ppointer data)
+{
+	p_atomic_int_set (&((PReclaimTestNode *) data)->alive, 0);
+	p_atomic_int_inc (&reclaim_freed);
+}
+
+static PReclaimTestNode * node_new (pint value)
+{
+	PReclaimTestNode *node;
+
+	node = &reclaim_nodes[p_atomic_int_add (&reclaim_next_node, 1)];
+
+	node->value = value;
+	p_atomic_int_set (&node->alive, 1);
+
+	return node;
+}
+
+static void reset_nodes (void)
+{
+	p_atomic_int_set (&reclaim_next_node, 0);
+	p_atomic_int_set (&reclaim_freed, 0);
+	p_atomic_int_set (&reclaim_dead_seen, 0);
+	p_atomic_int_set (&reclaim_writers, PRECLAIM_WRITERS);
+
+	p_atomic_pointer_set (&reclaim_current, node_new (0));
+}
+
+static void * epoch_writer_thread (void *)
+{
+	PReclaimTestNode	*node;
+	PReclaimTestNode	*old;
+	pint			i;
+
+	for (i = 1; i <= PRECLAIM_ROUNDS; ++i) {
+		node = node_new (i);
+
+		do {
+			old = (PReclaimTestNode *) p_atomic_pointer_get (&reclaim_current);
+		} while (!p_atomic_pointer_compare_and_exchange (&reclaim_current, old, node));
+
+		if (!p_epoch_domain_retire (global_epoch, old, node_free))
+			p_uthread_exit (1);
+	}
+
+	p_atomic_int_add (&reclaim_writers, -1);
+
+	p_uthread_exit (0);
+
+	return NULL;
+}
+
+static void * epoch_reader_thread (void *)
+{
+	PReclaimTestNode *node;
+
+	while (p_atomic_int_get (&reclaim_writers) > 0) {
+		if (!p_epoch_domain_enter (global_epoch))
+			p_uthread_exit (1);
+
+		node = (PReclaimTestNode *) p_atomic_pointer_get (&reclaim_current);
+
+		if (p_atomic_int_get (&node->alive) == 0)
+			p_atomic_int_inc (&reclaim_dead_seen);
+
+		p_uthread_yield ();
+
+		if (p_atomic_int_get (&node->alive) == 0)
+			p_atomic_int_inc (&reclaim_dead_seen);
+
+		p_epoch_domain_leave (global_epoch);
+	}
+
+	p_uthread_exit (0);
+
+	return NULL;
+}
+
+static void * hazard_writer_thread (void *)
+{
+	PReclaimTestNode	*node;
+	PReclaimTestNode	*old;
+	pint			i;
+
+	for (i = 1; i <= PRECLAIM_ROUNDS; ++i) {
+		node = node_new (i);
+
+		do {
+			old = (PReclaimTestNode *) p_atomic_pointer_get (&reclaim_current);
+		} while (!p_atomic_pointer_compare_and_exchange (&reclaim_current, old, node));
+
+		if (!p_hazard_domain_retire (global_hazard, old, node_free))
+			p_uthread_exit (1);
+	}
+
+	p_atomic_int_add (&reclaim_writers, -1);
+
+	p_uthread_exit (0);
+
+	return NULL;
+}
+
+static void * hazard_reader_thread (void *)
+{
+	PReclaimTestNode *node;
+
+	while (p_atomic_int_get (&reclaim_writers) > 0) {
+		node = (PReclaimTestNode *) p_hazard_domain_protect (global_hazard, 1, &reclaim_current);
+
+		if (node == NULL)
+			p_uthread_exit (1);
+
+		if (p_atomic_int_get (&node->alive) == 0)
+			p_atomic_int_inc (&reclaim_dead_seen);
+
+		p_uthread_yield ();
+
+		if (p_atomic_int_get (&node->alive) == 0)
+			p_atomic_int_inc (&reclaim_dead_seen);
+
+		p_hazard_domain_clear (global_hazard, 1);
+	}
+
+	p_uthread_exit (0);
+
+	return NULL;
+}
+
+static pboolean run_threads (PUThreadFunc writer_func, PUThreadFunc reader_func)
+{
+	PUThread	*thr[PRECLAIM_WRITERS + PRECLAIM_READERS];
+	pboolean	ret;
+	pint		i;
+
+	reset_nodes ();
+
+	for (i = 0; i < PRECLAIM_WRITERS + PRECLAIM_READERS; ++i) {
+		thr[i] = p_uthread_create (i < PRECLAIM_WRITERS ? writer_func : reader_func, NULL, TRUE, NULL);
+
+		if (thr[i] == NULL)
+			return FALSE;
+	}
+
+	ret = TRUE;
+
+	for (i = 0; i < PRECLAIM_WRITERS + PRECLAIM_READERS; ++i) {
+		if (p_uthread_join (thr[i]) != 0)
+			ret = FALSE;
+
+		p_uthread_unref (thr[i]);
+	}
+
+	return ret && p_atomic_int_get (&reclaim_dead_seen) == 0;
+}
+
+static void * retire_and_exit_thread (void *)
+{
+	pint i;
+
+	for (i = 0; i < 10; ++i) {
+		if (global_epoch != NULL)
+			p_epoch_domain_retire (global_epoch, node_new (i), node_free);
+		else
+			p_hazard_domain_retire (global_hazard, node_new (i), node_free);
+	}
+
+	p_uthread_exit (0);
+
+	return NULL;
+}
+
+P_TEST_CASE_BEGIN (preclaim_nomem_test)
+{
+	p_libsys_init ();
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+	P_TEST_CHECK (p_epoch_domain_new () == NULL);
+	P_TEST_CHECK (p_hazard_domain_new (2) == NULL);
+
+	p_mem_restore_vtable ();
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (preclaim_bad_input_test)
+{
+	pint value;
+
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_epoch_domain_enter (NULL) == FALSE);
+	P_TEST_CHECK (p_epoch_domain_retire (NULL, &value, node_free) == FALSE);
+	p_epoch_domain_leave (NULL);
+	p_epoch_domain_collect (NULL);
+	p_epoch_domain_barrier (NULL);
+	p_epoch_domain_free (NULL);
+
+	P_TEST_CHECK (p_hazard_domain_new (0) == NULL);
+	P_TEST_CHECK (p_hazard_domain_new (-1) == NULL);
+	P_TEST_CHECK (p_hazard_domain_protect (NULL, 0, &value) == NULL);
+	P_TEST_CHECK (p_hazard_domain_set (NULL, 0, &value) == FALSE);
+	P_TEST_CHECK (p_hazard_domain_retire (NULL, &value, node_free) == FALSE);
+	p_hazard_domain_clear (NULL, 0);
+	p_hazard_domain_collect (NULL);
+	p_hazard_domain_free (NULL);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (preclaim_epoch_test)
+{
+	PUThread	*thr;
+	pint		i;
+
+	p_libsys_init ();
+
+	reset_nodes ();
+
+	global_epoch = p_epoch_domain_new ();
+	P_TEST_REQUIRE (global_epoch != NULL);
+
+	P_TEST_CHECK (p_epoch_domain_retire (global_epoch, NULL, node_free) == FALSE);
+	P_TEST_CHECK (p_epoch_domain_retire (global_epoch, reclaim_nodes, NULL) == FALSE);
+
+	/* Unpaired leave is ignored */
+	p_epoch_domain_leave (global_epoch);
+
+	/* Nothing is freed while the thread stays in the critical section */
+	P_TEST_CHECK (p_epoch_domain_enter (global_epoch) == TRUE);
+	P_TEST_CHECK (p_epoch_domain_enter (global_epoch) == TRUE);
+
+	for (i = 0; i < 200; ++i)
+		P_TEST_CHECK (p_epoch_domain_retire (global_epoch, node_new (i), node_free) == TRUE);
+
+	p_epoch_domain_collect (global_epoch);
+	p_epoch_domain_collect (global_epoch);
+	p_epoch_domain_collect (global_epoch);
+	P_TEST_CHECK (p_atomic_int_get (&reclaim_freed) == 0);
+
+	p_epoch_domain_leave (global_epoch);
+	p_epoch_domain_collect (global_epoch);
+	p_epoch_domain_collect (global_epoch);
+	P_TEST_CHECK (p_atomic_int_get (&reclaim_freed) == 0);
+
+	p_epoch_domain_leave (global_epoch);
+	p_epoch_domain_barrier (global_epoch);
+	P_TEST_CHECK (p_atomic_int_get (&reclaim_freed) == 200);
+
+	/* Nodes of an exited thread are collected by the others */
+	thr = p_uthread_create ((PUThreadFunc) retire_and_exit_thread, NULL, TRUE, NULL);
+	P_TEST_REQUIRE (thr != NULL);
+	P_TEST_CHECK (p_uthread_join (thr) == 0);
+	p_uthread_unref (thr);
+
+	p_epoch_domain_barrier (global_epoch);
+	P_TEST_CHECK (p_atomic_int_get (&reclaim_freed) == 210);
+
+	/* The domain frees the pending nodes */
+	P_TEST_CHECK (p_epoch_domain_retire (global_epoch, node_new (0), node_free) == TRUE);
+	p_epoch_domain_free (global_epoch);
+	global_epoch = NULL;
+
+	P_TEST_CHECK (p_atomic_int_get (&reclaim_freed) == 211);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (preclaim_hazard_test)
+{
+	PReclaimTestNode	*node;
+	PUThread		*thr;
+	pint			i;
+
+	p_libsys_init ();
+
+	reset_nodes ();
+
+	global_hazard = p_hazard_domain_new (2);
+	P_TEST_REQUIRE (global_hazard != NULL);
+
+	P_TEST_CHECK (p_hazard_domain_protect (global_hazard, 2, &reclaim_current) == NULL);
+	P_TEST_CHECK (p_hazard_domain_protect (global_hazard, -1, &reclaim_current) == NULL);
+	P_TEST_CHECK (p_hazard_domain_protect (global_hazard, 0, NULL) == NULL);
+	P_TEST_CHECK (p_hazard_domain_set (global_hazard, 2, NULL) == FALSE);
+	P_TEST_CHECK (p_hazard_domain_retire (global_hazard, NULL, node_free) == FALSE);
+	P_TEST_CHECK (p_hazard_domain_retire (global_hazard, reclaim_nodes, NULL) == FALSE);
+
+	node = (PReclaimTestNode *) p_hazard_domain_protect (global_hazard, 0, &reclaim_current);
+	P_TEST_CHECK (node == reclaim_nodes);
+
+	/* A protected node survives any number of scans */
+	P_TEST_CHECK (p_hazard_domain_retire (global_hazard, node, node_free) == TRUE);
+
+	for (i = 1; i < 200; ++i)
+		P_TEST_CHECK (p_hazard_domain_retire (global_hazard, node_new (i), node_free) == TRUE);
+
+	p_hazard_domain_collect (global_hazard);
+	P_TEST_CHECK (p_atomic_int_get (&reclaim_freed) == 199);
+	P_TEST_CHECK (p_atomic_int_get (&node->alive) == 1);
+
+	/* Moving the protection to another slot keeps it */
+	P_TEST_CHECK (p_hazard_domain_set (global_hazard, 1, node) == TRUE);
+	p_hazard_domain_clear (global_hazard, 0);
+	p_hazard_domain_collect (global_hazard);
+	P_TEST_CHECK (p_atomic_int_get (&node->alive) == 1);
+
+	p_hazard_domain_clear (global_hazard, 1);
+	p_hazard_domain_collect (global_hazard);
+	P_TEST_CHECK (p_atomic_int_get (&reclaim_freed) == 200);
+	P_TEST_CHECK (p_atomic_int_get (&node->alive) == 0);
+
+	/* Nodes of an exited thread are collected by the others */
+	thr = p_uthread_create ((PUThreadFunc) retire_and_exit_thread, NULL, TRUE, NULL);
+	P_TEST_REQUIRE (thr != NULL);
+	P_TEST_CHECK (p_uthread_join (thr) == 0);
+	p_uthread_unref (thr);
+
+	p_hazard_domain_collect (global_hazard);
+	P_TEST_CHECK (p_atomic_int_get (&reclaim_freed) == 210);
+
+	/* The domain frees the pending nodes, protected or not */
+	node = node_new (0);
+	P_TEST_CHECK (p_hazard_domain_set (global_hazard, 0, node) == TRUE);
+	P_TEST_CHECK (p_hazard_domain_retire (global_hazard, node, node_free) == TRUE);
+	p_hazard_domain_free (global_hazard);
+	global_hazard = NULL;
+
+	P_TEST_CHECK (p_atomic_int_get (&reclaim_freed) == 211);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (preclaim_thread_test)
+{
+	p_libsys_init ();
+
+	global_epoch = p_epoch_domain_new ();
+	P_TEST_REQUIRE (global_epoch != NULL);
+
+	P_TEST_CHECK (run_threads ((PUThreadFunc) epoch_writer_thread,
+				   (PUThreadFunc) epoch_reader_thread) == TRUE);
+
+	p_epoch_domain_barrier (global_epoch);
+	P_TEST_CHECK (p_atomic_int_get (&reclaim_freed) == PRECLAIM_NODES - 1);
+
+	p_epoch_domain_free (global_epoch);
+	global_epoch = NULL;
+
+	global_hazard = p_hazard_domain_new (2);
+	P_TEST_REQUIRE (global_hazard != NULL);
+
+	P_TEST_CHECK (run_threads ((PUThreadFunc) hazard_writer_thread,
+				   (PUThreadFunc) hazard_reader_thread) == TRUE);
+
+	p_hazard_domain_collect (global_hazard);
+	P_TEST_CHECK (p_atomic_int_get (&reclaim_freed) == PRECLAIM_NODES - 1);
+
+	p_hazard_domain_free (global_hazard);
+	global_hazard = NULL;
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (preclaim_nomem_test);
+	P_TEST_SUITE_RUN_CASE (preclaim_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (preclaim_epoch_test);
+	P_TEST_SUITE_RUN_CASE (preclaim_hazard_test);
+	P_TEST_SUITE_RUN_CASE (preclaim_thread_test);
+}
+P_TEST_SUITE_END()
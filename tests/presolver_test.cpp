@@ -0,0 +1,259 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <string.h>
+
+P_TEST_MODULE_INIT ();
+
+#define PRESOLVER_ASYNC_LOOKUPS	16
+
+static volatile pint resolver_done_count = 0;
+static volatile pint resolver_good_count = 0;
+
+static void resolver_callback (PSocketAddress	**addresses,
+			       psize		n_addresses,
+			       PError		*error,
+			       ppointer		user_data)
+{
+	if (error == NULL && n_addresses > 0 &&
+	    p_socket_address_get_port (addresses[0]) == (puint16) PPOINTER_TO_PSIZE (user_data))
+		p_atomic_int_inc (&resolver_good_count);
+
+	p_resolver_free_addresses (addresses, n_addresses);
+
+	if (error != NULL)
+		p_error_free (error);
+
+	p_atomic_int_inc (&resolver_done_count);
+}
+
+P_TEST_CASE_BEGIN (presolver_bad_input_test)
+{
+	PSocketAddress	**addresses = NULL;
+	PResolver	*resolver;
+	PError		*error      = NULL;
+	psize		n_addresses = 0;
+
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_resolver_new (1, -1, 0, &error) == NULL);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+	error = NULL;
+
+	P_TEST_CHECK (p_resolver_lookup (NULL, "localhost", 80, &addresses, &n_addresses, NULL) == FALSE);
+	P_TEST_CHECK (p_resolver_lookup_async (NULL, "localhost", 80, resolver_callback, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_resolver_connect (NULL, "localhost", 80, 0, 0, NULL) == NULL);
+	P_TEST_CHECK (p_resolver_get_cache_size (NULL) == 0);
+
+	p_resolver_clear_cache (NULL);
+	p_resolver_free_addresses (NULL, 0);
+	p_resolver_free (NULL);
+
+	resolver = p_resolver_new (1, 1000, 1000, NULL);
+	P_TEST_REQUIRE (resolver != NULL);
+
+	P_TEST_CHECK (p_resolver_lookup (resolver, NULL, 80, &addresses, &n_addresses, NULL) == FALSE);
+	P_TEST_CHECK (p_resolver_lookup (resolver, "", 80, &addresses, &n_addresses, NULL) == FALSE);
+	P_TEST_CHECK (p_resolver_lookup (resolver, "localhost", 80, NULL, &n_addresses, NULL) == FALSE);
+	P_TEST_CHECK (p_resolver_lookup_async (resolver, "localhost", 80, NULL, NULL, &error) == FALSE);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_INVALID_ARGUMENT);
+	p_error_free (error);
+
+	p_resolver_free (resolver);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (presolver_lookup_test)
+{
+	PSocketAddress	**addresses;
+	PResolver	*resolver;
+	PError		*error = NULL;
+	pchar		*addr_str;
+	psize		n_addresses;
+	psize		i;
+
+	p_libsys_init ();
+
+	resolver = p_resolver_new (2, 60000, 60000, NULL);
+	P_TEST_REQUIRE (resolver != NULL);
+
+	/* Numeric addresses pass through */
+	P_TEST_REQUIRE (p_resolver_lookup (resolver, "127.0.0.1", 8080, &addresses, &n_addresses, NULL) == TRUE);
+	P_TEST_REQUIRE (n_addresses == 1);
+	P_TEST_CHECK (p_socket_address_get_family (addresses[0]) == P_SOCKET_FAMILY_INET);
+	P_TEST_CHECK (p_socket_address_get_port (addresses[0]) == 8080);
+
+	addr_str = p_socket_address_get_address (addresses[0]);
+	P_TEST_REQUIRE (addr_str != NULL);
+	P_TEST_CHECK (strcmp (addr_str, "127.0.0.1") == 0);
+	p_free (addr_str);
+
+	p_resolver_free_addresses (addresses, n_addresses);
+
+	P_TEST_CHECK (p_resolver_get_cache_size (resolver) == 1);
+
+	/* Cached result gets the port of every lookup */
+	P_TEST_REQUIRE (p_resolver_lookup (resolver, "127.0.0.1", 9090, &addresses, &n_addresses, NULL) == TRUE);
+	P_TEST_REQUIRE (n_addresses == 1);
+	P_TEST_CHECK (p_socket_address_get_port (addresses[0]) == 9090);
+	p_resolver_free_addresses (addresses, n_addresses);
+
+	P_TEST_CHECK (p_resolver_get_cache_size (resolver) == 1);
+
+	P_TEST_REQUIRE (p_resolver_lookup (resolver, "localhost", 80, &addresses, &n_addresses, &error) == TRUE);
+	P_TEST_CHECK (error == NULL);
+	P_TEST_CHECK (n_addresses > 0);
+
+	for (i = 0; i < n_addresses; ++i) {
+		P_TEST_CHECK (p_socket_address_is_loopback (addresses[i]) == TRUE);
+		P_TEST_CHECK (p_socket_address_get_port (addresses[i]) == 80);
+	}
+
+	p_resolver_free_addresses (addresses, n_addresses);
+
+	P_TEST_CHECK (p_resolver_get_cache_size (resolver) == 2);
+
+	/* Failures are cached as well */
+	P_TEST_CHECK (p_resolver_lookup (resolver, "nonexistent.invalid", 80, &addresses, &n_addresses, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+	error = NULL;
+
+	P_TEST_CHECK (p_resolver_get_cache_size (resolver) == 3);
+
+	p_resolver_clear_cache (resolver);
+	P_TEST_CHECK (p_resolver_get_cache_size (resolver) == 0);
+
+	p_resolver_free (resolver);
+
+	/* Caching disabled */
+	resolver = p_resolver_new (1, 0, 0, NULL);
+	P_TEST_REQUIRE (resolver != NULL);
+
+	P_TEST_REQUIRE (p_resolver_lookup (resolver, "127.0.0.1", 80, &addresses, &n_addresses, NULL) == TRUE);
+	p_resolver_free_addresses (addresses, n_addresses);
+
+	P_TEST_CHECK (p_resolver_get_cache_size (resolver) == 0);
+
+	p_resolver_free (resolver);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (presolver_async_test)
+{
+	PResolver	*resolver;
+	pint		i;
+
+	p_libsys_init ();
+
+	resolver = p_resolver_new (2, 60000, 1000, NULL);
+	P_TEST_REQUIRE (resolver != NULL);
+
+	p_atomic_int_set (&resolver_done_count, 0);
+	p_atomic_int_set (&resolver_good_count, 0);
+
+	/* Concurrent lookups of the same name share a single query */
+	for (i = 0; i < PRESOLVER_ASYNC_LOOKUPS; ++i)
+		P_TEST_CHECK (p_resolver_lookup_async (resolver,
+						       "localhost",
+						       (puint16) (1000 + i),
+						       resolver_callback,
+						       PSIZE_TO_POINTER ((psize) (1000 + i)),
+						       NULL) == TRUE);
+
+	P_TEST_CHECK (p_resolver_get_cache_size (resolver) == 1);
+
+	/* Pending lookups are delivered before the resolver is freed */
+	p_resolver_free (resolver);
+
+	P_TEST_CHECK (p_atomic_int_get (&resolver_done_count) == PRESOLVER_ASYNC_LOOKUPS);
+	P_TEST_CHECK (p_atomic_int_get (&resolver_good_count) == PRESOLVER_ASYNC_LOOKUPS);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (presolver_connect_test)
+{
+	PSocketAddress	*addr;
+	PResolver	*resolver;
+	PSocket		*server;
+	PSocket		*client;
+	PSocket		*accepted;
+	puint16		port;
+
+	p_libsys_init ();
+
+	server = p_socket_new (P_SOCKET_FAMILY_INET, P_SOCKET_TYPE_STREAM, P_SOCKET_PROTOCOL_TCP, NULL);
+	P_TEST_REQUIRE (server != NULL);
+
+	addr = p_socket_address_new ("127.0.0.1", 0);
+	P_TEST_REQUIRE (addr != NULL);
+	P_TEST_REQUIRE (p_socket_bind (server, addr, TRUE, NULL) == TRUE);
+	p_socket_address_free (addr);
+
+	P_TEST_REQUIRE (p_socket_listen (server, NULL) == TRUE);
+
+	addr = p_socket_get_local_address (server, NULL);
+	P_TEST_REQUIRE (addr != NULL);
+	port = p_socket_address_get_port (addr);
+	p_socket_address_free (addr);
+
+	resolver = p_resolver_new (1, 60000, 1000, NULL);
+	P_TEST_REQUIRE (resolver != NULL);
+
+	client = p_resolver_connect (resolver, "127.0.0.1", port, 0, 5000, NULL);
+	P_TEST_REQUIRE (client != NULL);
+	P_TEST_CHECK (p_socket_is_connected (client) == TRUE);
+
+	accepted = p_socket_accept (server, NULL);
+	P_TEST_CHECK (accepted != NULL);
+
+	p_socket_free (accepted);
+	p_socket_free (client);
+	p_socket_free (server);
+
+	p_resolver_free (resolver);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (presolver_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (presolver_lookup_test);
+	P_TEST_SUITE_RUN_CASE (presolver_async_test);
+	P_TEST_SUITE_RUN_CASE (presolver_connect_test);
+}
+P_TEST_SUITE_END()
@@ -0,0 +1,329 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <string.h>
+
+P_TEST_MODULE_INIT ();
+
+#define PRINGSPSC_ROUNDS	100000
+
+static PRingSPSC *	global_ring     = NULL;
+static volatile pint	ring_mismatched = 0;
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static void * ring_producer_thread (void *)
+{
+	puint32	*space;
+	puint32	value;
+	psize	reserved;
+	psize	i;
+
+	value = 0;
+
+	while (value < PRINGSPSC_ROUNDS) {
+		/* Alternate between copying and filling in place */
+		if (value % 3 == 0) {
+			if (p_ring_spsc_try_write (global_ring, &value))
+				++value;
+			else
+				p_uthread_yield ();
+
+			continue;
+		}
+
+		space = (puint32 *) p_ring_spsc_reserve (global_ring, 7, &reserved);
+
+		if (space == NULL) {
+			p_uthread_yield ();
+			continue;
+		}
+
+		for (i = 0; i < reserved && value < PRINGSPSC_ROUNDS; ++i)
+			space[i] = value++;
+
+		p_ring_spsc_commit (global_ring, i);
+	}
+
+	p_uthread_exit (0);
+
+	return NULL;
+}
+
+static void * ring_consumer_thread (void *)
+{
+	const puint32	*elements;
+	puint32		batch[5];
+	puint32		expected;
+	psize		count;
+	psize		i;
+
+	expected = 0;
+
+	while (expected < PRINGSPSC_ROUNDS) {
+		/* Alternate between copying and reading in place */
+		if (expected % 2 == 0) {
+			count = p_ring_spsc_try_read_batch (global_ring, batch, 5);
+
+			for (i = 0; i < count; ++i)
+				if (batch[i] != expected++)
+					p_atomic_int_inc (&ring_mismatched);
+		} else {
+			elements = (const puint32 *) p_ring_spsc_peek (global_ring, &count);
+
+			for (i = 0; i < count; ++i)
+				if (elements[i] != expected++)
+					p_atomic_int_inc (&ring_mismatched);
+
+			p_ring_spsc_release (global_ring, count);
+		}
+
+		if (count == 0)
+			p_uthread_yield ();
+	}
+
+	p_uthread_exit (0);
+
+	return NULL;
+}
+
+P_TEST_CASE_BEGIN (pringspsc_nomem_test)
+{
+	p_libsys_init ();
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+	P_TEST_CHECK (p_ring_spsc_new (sizeof (pint), 16) == NULL);
+
+	p_mem_restore_vtable ();
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pringspsc_bad_input_test)
+{
+	pint	value;
+	psize	count;
+
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_ring_spsc_new (0, 16) == NULL);
+	P_TEST_CHECK (p_ring_spsc_new (sizeof (pint), P_MAXSIZE) == NULL);
+	P_TEST_CHECK (p_ring_spsc_new (P_MAXSIZE / 4, 16) == NULL);
+	P_TEST_CHECK (p_ring_spsc_try_write (NULL, &value) == FALSE);
+	P_TEST_CHECK (p_ring_spsc_reserve (NULL, 1, &count) == NULL);
+	P_TEST_CHECK (p_ring_spsc_commit (NULL, 0) == FALSE);
+	P_TEST_CHECK (p_ring_spsc_try_read (NULL, &value) == FALSE);
+	P_TEST_CHECK (p_ring_spsc_try_read_batch (NULL, &value, 1) == 0);
+	P_TEST_CHECK (p_ring_spsc_peek (NULL, &count) == NULL);
+	P_TEST_CHECK (p_ring_spsc_release (NULL, 0) == FALSE);
+	P_TEST_CHECK (p_ring_spsc_get_capacity (NULL) == 0);
+	P_TEST_CHECK (p_ring_spsc_get_size (NULL) == 0);
+	p_ring_spsc_free (NULL);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pringspsc_general_test)
+{
+	PRingSPSC	*ring;
+	const pint	*elements;
+	pint		*space;
+	pint		values[16];
+	pint		value;
+	psize		count;
+	pint		i;
+
+	p_libsys_init ();
+
+	ring = p_ring_spsc_new (sizeof (pint), 0);
+	P_TEST_REQUIRE (ring != NULL);
+	P_TEST_CHECK (p_ring_spsc_get_capacity (ring) == 2);
+	p_ring_spsc_free (ring);
+
+	ring = p_ring_spsc_new (sizeof (pint), 5);
+	P_TEST_REQUIRE (ring != NULL);
+	P_TEST_CHECK (p_ring_spsc_get_capacity (ring) == 8);
+	P_TEST_CHECK (p_ring_spsc_get_size (ring) == 0);
+
+	P_TEST_CHECK (p_ring_spsc_try_write (ring, NULL) == FALSE);
+	P_TEST_CHECK (p_ring_spsc_try_read (ring, NULL) == FALSE);
+	P_TEST_CHECK (p_ring_spsc_try_read (ring, &value) == FALSE);
+	P_TEST_CHECK (p_ring_spsc_peek (ring, &count) == NULL);
+	P_TEST_CHECK (count == 0);
+	P_TEST_CHECK (p_ring_spsc_release (ring, 1) == FALSE);
+
+	/* Wrap around the ring a few times */
+	for (pint round = 0; round < 3; ++round) {
+		for (i = 0; i < 8; ++i)
+			P_TEST_CHECK (p_ring_spsc_try_write (ring, &i) == TRUE);
+
+		P_TEST_CHECK (p_ring_spsc_try_write (ring, &i) == FALSE);
+		P_TEST_CHECK (p_ring_spsc_reserve (ring, 1, &count) == NULL);
+		P_TEST_CHECK (count == 0);
+		P_TEST_CHECK (p_ring_spsc_get_size (ring) == 8);
+
+		for (i = 0; i < 8; ++i) {
+			P_TEST_CHECK (p_ring_spsc_try_read (ring, &value) == TRUE);
+			P_TEST_CHECK (value == i);
+		}
+
+		P_TEST_CHECK (p_ring_spsc_try_read (ring, &value) == FALSE);
+		P_TEST_CHECK (p_ring_spsc_get_size (ring) == 0);
+	}
+
+	/* Reservation stops at the end of the buffer, the head is at 24 now */
+	for (i = 0; i < 5; ++i)
+		P_TEST_CHECK (p_ring_spsc_try_write (ring, &i) == TRUE);
+
+	P_TEST_CHECK (p_ring_spsc_try_read_batch (ring, values, 16) == 5);
+
+	P_TEST_CHECK (p_ring_spsc_reserve (ring, 0, &count) == NULL);
+	P_TEST_CHECK (p_ring_spsc_commit (ring, 1) == FALSE);
+
+	space = (pint *) p_ring_spsc_reserve (ring, 8, &count);
+	P_TEST_REQUIRE (space != NULL);
+	P_TEST_CHECK (count == 3);
+
+	for (i = 0; i < 3; ++i)
+		space[i] = 10 + i;
+
+	P_TEST_CHECK (p_ring_spsc_get_size (ring) == 0);
+	P_TEST_CHECK (p_ring_spsc_commit (ring, 4) == FALSE);
+	P_TEST_CHECK (p_ring_spsc_commit (ring, 3) == TRUE);
+	P_TEST_CHECK (p_ring_spsc_commit (ring, 1) == FALSE);
+	P_TEST_CHECK (p_ring_spsc_get_size (ring) == 3);
+
+	space = (pint *) p_ring_spsc_reserve (ring, 8, &count);
+	P_TEST_REQUIRE (space != NULL);
+	P_TEST_CHECK (count == 5);
+
+	for (i = 0; i < 5; ++i)
+		space[i] = 13 + i;
+
+	/* Only a part of the reservation is used */
+	P_TEST_CHECK (p_ring_spsc_commit (ring, 2) == TRUE);
+	P_TEST_CHECK (p_ring_spsc_get_size (ring) == 5);
+
+	/* Peeking stops at the end of the buffer too */
+	elements = (const pint *) p_ring_spsc_peek (ring, &count);
+	P_TEST_REQUIRE (elements != NULL);
+	P_TEST_CHECK (count == 3);
+	P_TEST_CHECK (elements[0] == 10 && elements[1] == 11 && elements[2] == 12);
+	P_TEST_CHECK (p_ring_spsc_release (ring, 4) == FALSE);
+	P_TEST_CHECK (p_ring_spsc_release (ring, 1) == TRUE);
+	P_TEST_CHECK (p_ring_spsc_release (ring, 1) == FALSE);
+	P_TEST_CHECK (p_ring_spsc_get_size (ring) == 4);
+
+	/* Batch read across the end of the buffer */
+	P_TEST_CHECK (p_ring_spsc_try_read_batch (ring, values, 16) == 4);
+	P_TEST_CHECK (values[0] == 11 && values[1] == 12 && values[2] == 13 && values[3] == 14);
+	P_TEST_CHECK (p_ring_spsc_try_read_batch (ring, values, 16) == 0);
+
+	p_ring_spsc_free (ring);
+
+	/* Elements of an odd size */
+	ring = p_ring_spsc_new (3, 4);
+	P_TEST_REQUIRE (ring != NULL);
+
+	P_TEST_CHECK (p_ring_spsc_try_write (ring, "abc") == TRUE);
+	P_TEST_CHECK (p_ring_spsc_try_write (ring, "def") == TRUE);
+	P_TEST_CHECK (p_ring_spsc_try_read_batch (ring, values, 2) == 2);
+	P_TEST_CHECK (memcmp (values, "abcdef", 6) == 0);
+
+	p_ring_spsc_free (ring);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pringspsc_thread_test)
+{
+	PUThread *thr1;
+	PUThread *thr2;
+
+	p_libsys_init ();
+
+	/* Small ring makes both sides wrap and wait often */
+	global_ring = p_ring_spsc_new (sizeof (puint32), 16);
+	P_TEST_REQUIRE (global_ring != NULL);
+
+	p_atomic_int_set (&ring_mismatched, 0);
+
+	thr1 = p_uthread_create ((PUThreadFunc) ring_producer_thread, NULL, TRUE, NULL);
+	P_TEST_REQUIRE (thr1 != NULL);
+
+	thr2 = p_uthread_create ((PUThreadFunc) ring_consumer_thread, NULL, TRUE, NULL);
+	P_TEST_REQUIRE (thr2 != NULL);
+
+	P_TEST_CHECK (p_uthread_join (thr1) == 0);
+	P_TEST_CHECK (p_uthread_join (thr2) == 0);
+
+	P_TEST_CHECK (p_atomic_int_get (&ring_mismatched) == 0);
+	P_TEST_CHECK (p_ring_spsc_get_size (global_ring) == 0);
+
+	p_uthread_unref (thr1);
+	p_uthread_unref (thr2);
+
+	p_ring_spsc_free (global_ring);
+	global_ring = NULL;
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pringspsc_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pringspsc_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (pringspsc_general_test);
+	P_TEST_SUITE_RUN_CASE (pringspsc_thread_test);
+}
+P_TEST_SUITE_END()
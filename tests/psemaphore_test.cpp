@@ -217,10 +217,86 @@ P_TEST_CASE_BEGIN (psemaphore_thread_test)
 }
 P_TEST_CASE_END ()
 
+static void * semaphore_release_thread (void *arg)
+{
+	p_uthread_sleep (50);
+	p_semaphore_release ((PSemaphore *) arg, NULL);
+
+	return NULL;
+}
+
+P_TEST_CASE_BEGIN (psemaphore_deadline_test)
+{
+	PTimeProfiler	*profiler;
+	PSemaphore	*sem = NULL;
+	PUThread	*thr;
+	PError		*error = NULL;
+	PDeadline	deadline;
+
+	p_libsys_init ();
+
+	p_deadline_init_msecs (&deadline, 0);
+
+	P_TEST_CHECK (p_semaphore_acquire_until (NULL, &deadline, &error) == -1);
+	P_TEST_CHECK (error != NULL);
+	clean_error (&error);
+
+	sem = p_semaphore_new ("p_semaphore_test_object", 1, P_SEM_ACCESS_CREATE, NULL);
+	P_TEST_REQUIRE (sem != NULL);
+	p_semaphore_take_ownership (sem);
+	p_semaphore_free (sem);
+
+	sem = p_semaphore_new ("p_semaphore_test_object", 1, P_SEM_ACCESS_CREATE, NULL);
+	P_TEST_REQUIRE (sem != NULL);
+
+	profiler = p_time_profiler_new ();
+	P_TEST_REQUIRE (profiler != NULL);
+
+	/* Available semaphore is taken even with an expired deadline */
+	P_TEST_CHECK (p_semaphore_acquire_until (sem, &deadline, &error) == 1);
+	P_TEST_CHECK (error == NULL);
+
+	P_TEST_CHECK (p_semaphore_acquire_until (sem, &deadline, &error) == 0);
+	P_TEST_CHECK (error == NULL);
+
+	p_deadline_init_msecs (&deadline, 100);
+	p_time_profiler_reset (profiler);
+
+	P_TEST_CHECK (p_semaphore_acquire_until (sem, &deadline, &error) == 0);
+	P_TEST_CHECK (error == NULL);
+	P_TEST_CHECK (p_time_profiler_elapsed_usecs (profiler) >= 90 * 1000);
+
+	/* Release from another thread must unblock the waiter */
+	thr = p_uthread_create ((PUThreadFunc) semaphore_release_thread, sem, TRUE, NULL);
+	P_TEST_REQUIRE (thr != NULL);
+
+	p_deadline_init_msecs (&deadline, 10000);
+
+	P_TEST_CHECK (p_semaphore_acquire_until (sem, &deadline, &error) == 1);
+	P_TEST_CHECK (error == NULL);
+	P_TEST_CHECK (p_deadline_has_expired (&deadline) == FALSE);
+
+	p_uthread_join (thr);
+	p_uthread_unref (thr);
+
+	P_TEST_CHECK (p_semaphore_release (sem, NULL) == TRUE);
+
+	/* Infinite deadline acts as a regular acquire */
+	P_TEST_CHECK (p_semaphore_acquire_until (sem, NULL, &error) == 1);
+	P_TEST_CHECK (p_semaphore_release (sem, NULL) == TRUE);
+
+	p_time_profiler_free (profiler);
+	p_semaphore_free (sem);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
 P_TEST_SUITE_BEGIN()
 {
 	P_TEST_SUITE_RUN_CASE (psemaphore_nomem_test);
 	P_TEST_SUITE_RUN_CASE (psemaphore_general_test);
 	P_TEST_SUITE_RUN_CASE (psemaphore_thread_test);
+	P_TEST_SUITE_RUN_CASE (psemaphore_deadline_test);
 }
 P_TEST_SUITE_END()
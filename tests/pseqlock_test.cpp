@@ -0,0 +1,209 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+P_TEST_MODULE_INIT ();
+
+#define PSEQLOCK_READERS	2
+#define PSEQLOCK_WRITERS	2
+#define PSEQLOCK_READER_ROUNDS	20000
+#define PSEQLOCK_WRITER_ROUNDS	5000
+
+static PSeqLock *	global_seq_lock   = NULL;
+static volatile pint	seq_lock_value_1  = 0;
+static volatile pint	seq_lock_value_2  = 0;
+static volatile pint	seq_lock_mismatch = 0;
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static void * seq_lock_reader_thread (void *)
+{
+	puint	seq;
+	pint	value_1;
+	pint	value_2;
+	pint	i;
+
+	for (i = 0; i < PSEQLOCK_READER_ROUNDS; ++i) {
+		do {
+			seq     = p_seq_lock_read_begin (global_seq_lock);
+			value_1 = p_atomic_int_get (&seq_lock_value_1);
+			value_2 = p_atomic_int_get (&seq_lock_value_2);
+		} while (p_seq_lock_read_retry (global_seq_lock, seq));
+
+		if (value_1 != value_2)
+			p_atomic_int_inc (&seq_lock_mismatch);
+	}
+
+	p_uthread_exit (0);
+
+	return NULL;
+}
+
+static void * seq_lock_writer_thread (void *)
+{
+	pint i;
+
+	for (i = 0; i < PSEQLOCK_WRITER_ROUNDS; ++i) {
+		if (!p_seq_lock_write_trylock (global_seq_lock)) {
+			if (!p_seq_lock_write_lock (global_seq_lock))
+				p_uthread_exit (1);
+		}
+
+		p_atomic_int_set (&seq_lock_value_1, p_atomic_int_get (&seq_lock_value_1) + 1);
+
+		if (i % 64 == 0)
+			p_uthread_yield ();
+
+		p_atomic_int_set (&seq_lock_value_2, p_atomic_int_get (&seq_lock_value_2) + 1);
+
+		if (!p_seq_lock_write_unlock (global_seq_lock))
+			p_uthread_exit (1);
+	}
+
+	p_uthread_exit (0);
+
+	return NULL;
+}
+
+P_TEST_CASE_BEGIN (pseqlock_nomem_test)
+{
+	p_libsys_init ();
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+	P_TEST_CHECK (p_seq_lock_new () == NULL);
+
+	p_mem_restore_vtable ();
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pseqlock_bad_input_test)
+{
+	p_libsys_init ();
+
+	P_TEST_REQUIRE (p_seq_lock_read_begin (NULL) == 0);
+	P_TEST_REQUIRE (p_seq_lock_read_retry (NULL, 0) == FALSE);
+	P_TEST_REQUIRE (p_seq_lock_write_lock (NULL) == FALSE);
+	P_TEST_REQUIRE (p_seq_lock_write_trylock (NULL) == FALSE);
+	P_TEST_REQUIRE (p_seq_lock_write_unlock (NULL) == FALSE);
+	p_seq_lock_free (NULL);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pseqlock_general_test)
+{
+	PUThread	*thr[PSEQLOCK_READERS + PSEQLOCK_WRITERS];
+	puint		seq;
+	pint		i;
+
+	p_libsys_init ();
+
+	global_seq_lock = p_seq_lock_new ();
+	P_TEST_REQUIRE (global_seq_lock != NULL);
+
+	P_TEST_CHECK (p_seq_lock_write_unlock (global_seq_lock) == FALSE);
+
+	seq = p_seq_lock_read_begin (global_seq_lock);
+	P_TEST_CHECK ((seq & 1) == 0);
+	P_TEST_CHECK (p_seq_lock_read_retry (global_seq_lock, seq) == FALSE);
+
+	P_TEST_CHECK (p_seq_lock_write_trylock (global_seq_lock) == TRUE);
+	P_TEST_CHECK (p_seq_lock_write_trylock (global_seq_lock) == FALSE);
+	P_TEST_CHECK (p_seq_lock_read_retry (global_seq_lock, seq) == TRUE);
+	P_TEST_CHECK (p_seq_lock_write_unlock (global_seq_lock) == TRUE);
+
+	P_TEST_CHECK (p_seq_lock_read_retry (global_seq_lock, seq) == TRUE);
+
+	seq = p_seq_lock_read_begin (global_seq_lock);
+	P_TEST_CHECK ((seq & 1) == 0);
+	P_TEST_CHECK (p_seq_lock_read_retry (global_seq_lock, seq) == FALSE);
+
+	P_TEST_CHECK (p_seq_lock_write_lock (global_seq_lock) == TRUE);
+	P_TEST_CHECK (p_seq_lock_write_unlock (global_seq_lock) == TRUE);
+	P_TEST_CHECK (p_seq_lock_read_retry (global_seq_lock, seq) == TRUE);
+
+	p_atomic_int_set (&seq_lock_value_1, 0);
+	p_atomic_int_set (&seq_lock_value_2, 0);
+	p_atomic_int_set (&seq_lock_mismatch, 0);
+
+	for (i = 0; i < PSEQLOCK_READERS; ++i) {
+		thr[i] = p_uthread_create ((PUThreadFunc) seq_lock_reader_thread, NULL, TRUE, NULL);
+		P_TEST_REQUIRE (thr[i] != NULL);
+	}
+
+	for (i = PSEQLOCK_READERS; i < PSEQLOCK_READERS + PSEQLOCK_WRITERS; ++i) {
+		thr[i] = p_uthread_create ((PUThreadFunc) seq_lock_writer_thread, NULL, TRUE, NULL);
+		P_TEST_REQUIRE (thr[i] != NULL);
+	}
+
+	for (i = 0; i < PSEQLOCK_READERS + PSEQLOCK_WRITERS; ++i) {
+		P_TEST_CHECK (p_uthread_join (thr[i]) == 0);
+		p_uthread_unref (thr[i]);
+	}
+
+	P_TEST_CHECK (p_atomic_int_get (&seq_lock_value_1) == PSEQLOCK_WRITERS * PSEQLOCK_WRITER_ROUNDS);
+	P_TEST_CHECK (p_atomic_int_get (&seq_lock_value_2) == PSEQLOCK_WRITERS * PSEQLOCK_WRITER_ROUNDS);
+	P_TEST_CHECK (p_atomic_int_get (&seq_lock_mismatch) == 0);
+
+	p_seq_lock_free (global_seq_lock);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pseqlock_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pseqlock_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (pseqlock_general_test);
+}
+P_TEST_SUITE_END()
@@ -27,6 +27,7 @@
 #include "ptestmacros.h"
 
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
 P_TEST_MODULE_INIT ();
@@ -110,6 +111,8 @@ P_TEST_CASE_BEGIN (pshm_invalid_test)
 	P_TEST_CHECK (p_shm_unlock (NULL, NULL) == FALSE);
 	P_TEST_CHECK (p_shm_get_address (NULL) == NULL);
 	P_TEST_CHECK (p_shm_get_size (NULL) == 0);
+	P_TEST_CHECK (p_shm_get_page_size (NULL) == 0);
+	P_TEST_CHECK (p_shm_new_with_flags (NULL, 0, P_SHM_ACCESS_READWRITE, P_SHM_FLAG_NONE, NULL) == NULL);
 	p_shm_take_ownership (NULL);
 
 	PShm *shm = p_shm_new ("p_shm_invalid_test", 0, P_SHM_ACCESS_READWRITE, NULL);
@@ -239,6 +242,220 @@ P_TEST_CASE_BEGIN (pshm_general_test)
 }
 P_TEST_CASE_END ()
 
+P_TEST_CASE_BEGIN (pshm_flags_test)
+{
+	PShm		*shm;
+	pchar		*addr;
+	psize		page_size;
+	pint		i;
+
+	p_libsys_init ();
+
+	shm = p_shm_new_with_flags ("p_shm_flags_test",
+				    1024,
+				    P_SHM_ACCESS_READWRITE,
+				    P_SHM_FLAG_PREFAULT,
+				    NULL);
+	P_TEST_REQUIRE (shm != NULL);
+	p_shm_take_ownership (shm);
+
+	page_size = p_shm_get_page_size (shm);
+
+	P_TEST_CHECK (page_size > 0);
+	P_TEST_CHECK (p_shm_get_size (shm) == 1024);
+
+	p_shm_free (shm);
+
+	/* Huge pages are not always available, regular pages are used then */
+	shm = p_shm_new_with_flags ("p_shm_flags_test",
+				    1024,
+				    P_SHM_ACCESS_READWRITE,
+				    (PShmFlags) (P_SHM_FLAG_HUGE_PAGES | P_SHM_FLAG_PREFAULT),
+				    NULL);
+	P_TEST_REQUIRE (shm != NULL);
+	p_shm_take_ownership (shm);
+
+	P_TEST_CHECK (p_shm_get_page_size (shm) >= page_size);
+	P_TEST_CHECK (p_shm_get_size (shm) >= 1024);
+
+	addr = (pchar *) p_shm_get_address (shm);
+	P_TEST_REQUIRE (addr != NULL);
+
+	for (i = 0; i < 1024; ++i)
+		addr[i] = (pchar) i;
+
+	for (i = 0; i < 1024; ++i)
+		P_TEST_CHECK (addr[i] == (pchar) i);
+
+	p_shm_free (shm);
+
+	/* Locking may be limited by the system */
+	shm = p_shm_new_with_flags ("p_shm_flags_test",
+				    1024,
+				    P_SHM_ACCESS_READWRITE,
+				    P_SHM_FLAG_LOCK,
+				    NULL);
+
+	if (shm != NULL) {
+		p_shm_take_ownership (shm);
+		P_TEST_CHECK (p_shm_get_address (shm) != NULL);
+		p_shm_free (shm);
+	}
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pshm_anonymous_test)
+{
+	PShm		*shm;
+	PShm		*shm2;
+	PShm		*shm3;
+	PError		*error = NULL;
+	pchar		*addr;
+	pint		handle;
+
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_shm_new_anonymous (0, P_SHM_ACCESS_READWRITE, NULL) == NULL);
+	P_TEST_CHECK (p_shm_new_from_handle (-1, P_SHM_ACCESS_READWRITE, NULL) == NULL);
+	P_TEST_CHECK (p_shm_get_handle (NULL) == -1);
+
+	shm = p_shm_new ("p_shm_anonymous_test", 1024, P_SHM_ACCESS_READWRITE, NULL);
+	P_TEST_REQUIRE (shm != NULL);
+	p_shm_take_ownership (shm);
+	P_TEST_CHECK (p_shm_get_handle (shm) == -1);
+	p_shm_free (shm);
+
+	shm = p_shm_new_anonymous (4096, P_SHM_ACCESS_READWRITE, &error);
+
+	if (shm == NULL) {
+		/* Not every platform has anonymous segments */
+		P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IPC_NOT_IMPLEMENTED);
+		p_error_free (error);
+		p_libsys_shutdown ();
+		P_TEST_CASE_RETURN ();
+	}
+
+	P_TEST_CHECK (p_shm_get_size (shm) == 4096);
+
+	handle = p_shm_get_handle (shm);
+	P_TEST_CHECK (handle != -1);
+
+	addr = (pchar *) p_shm_get_address (shm);
+	P_TEST_REQUIRE (addr != NULL);
+	strcpy (addr, "anonymous segment");
+
+	shm2 = p_shm_new_from_handle (handle, P_SHM_ACCESS_READWRITE, NULL);
+	P_TEST_REQUIRE (shm2 != NULL);
+	P_TEST_CHECK (p_shm_get_size (shm2) >= 4096);
+	P_TEST_CHECK (p_shm_get_handle (shm2) != -1);
+	P_TEST_CHECK (strcmp ((pchar *) p_shm_get_address (shm2), "anonymous segment") == 0);
+
+	/* The lock is optional for anonymous segments */
+	if (p_shm_lock (shm2, NULL) == TRUE) {
+		*((pchar *) p_shm_get_address (shm2)) = 'A';
+		P_TEST_CHECK (p_shm_unlock (shm2, NULL) == TRUE);
+
+		P_TEST_CHECK (p_shm_lock (shm, NULL) == TRUE);
+		P_TEST_CHECK (addr[0] == 'A');
+		P_TEST_CHECK (p_shm_unlock (shm, NULL) == TRUE);
+	}
+
+	shm3 = p_shm_new_from_handle (handle, P_SHM_ACCESS_READONLY, NULL);
+	P_TEST_REQUIRE (shm3 != NULL);
+	P_TEST_CHECK (strcmp ((pchar *) p_shm_get_address (shm3) + 1, "nonymous segment") == 0);
+
+	/* The segment lives while anyone has it opened */
+	p_shm_free (shm);
+
+	P_TEST_CHECK (strcmp ((pchar *) p_shm_get_address (shm3) + 1, "nonymous segment") == 0);
+
+	p_shm_free (shm3);
+	p_shm_free (shm2);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+#ifndef P_OS_HPUX
+P_TEST_CASE_BEGIN (pshm_shared_lock_test)
+{
+	PShm		*shm;
+	PShm		*shm2;
+	PUThread	*thr1, *thr2;
+	pchar		*addr;
+	pint		i;
+	pboolean	test_ok;
+
+	p_libsys_init ();
+
+	shm = p_shm_new_with_flags ("p_shm_shared_lock_test",
+				    1024 * 1024,
+				    P_SHM_ACCESS_READWRITE,
+				    P_SHM_FLAG_SHARED_LOCK,
+				    NULL);
+	P_TEST_REQUIRE (shm != NULL);
+	p_shm_take_ownership (shm);
+	p_shm_free (shm);
+
+	shm = p_shm_new_with_flags ("p_shm_shared_lock_test",
+				    1024 * 1024,
+				    P_SHM_ACCESS_READWRITE,
+				    P_SHM_FLAG_SHARED_LOCK,
+				    NULL);
+	P_TEST_REQUIRE (shm != NULL);
+	P_TEST_REQUIRE (p_shm_get_size (shm) == 1024 * 1024);
+
+	shm2 = p_shm_new_with_flags ("p_shm_shared_lock_test",
+				     1024 * 1024,
+				     P_SHM_ACCESS_READWRITE,
+				     P_SHM_FLAG_SHARED_LOCK,
+				     NULL);
+	P_TEST_REQUIRE (shm2 != NULL);
+	P_TEST_REQUIRE (p_shm_get_size (shm2) == 1024 * 1024);
+
+	addr = (pchar *) p_shm_get_address (shm);
+	P_TEST_REQUIRE (addr != NULL);
+
+	P_TEST_CHECK (p_shm_lock (shm, NULL) == TRUE);
+	strcpy (addr, "shared lock");
+	P_TEST_CHECK (p_shm_unlock (shm, NULL) == TRUE);
+
+	P_TEST_CHECK (p_shm_lock (shm2, NULL) == TRUE);
+	P_TEST_CHECK (strcmp ((pchar *) p_shm_get_address (shm2), "shared lock") == 0);
+	P_TEST_CHECK (p_shm_unlock (shm2, NULL) == TRUE);
+
+	/* Both instances share the same lock */
+	thr1 = p_uthread_create ((PUThreadFunc) shm_test_thread, (ppointer) shm, TRUE, NULL);
+	P_TEST_REQUIRE (thr1 != NULL);
+
+	thr2 = p_uthread_create ((PUThreadFunc) shm_test_thread, (ppointer) shm2, TRUE, NULL);
+	P_TEST_REQUIRE (thr2 != NULL);
+
+	P_TEST_CHECK (p_uthread_join (thr1) == 0);
+	P_TEST_CHECK (p_uthread_join (thr2) == 0);
+
+	test_ok = TRUE;
+
+	for (i = 1; i < 1024 * 1024; ++i)
+		if (addr[i] != addr[0]) {
+			test_ok = FALSE;
+			break;
+		}
+
+	P_TEST_CHECK (test_ok == TRUE);
+
+	p_uthread_unref (thr1);
+	p_uthread_unref (thr2);
+	p_shm_free (shm2);
+	p_shm_free (shm);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+#endif /* !P_OS_HPUX */
+
 P_TEST_CASE_BEGIN (pshm_thread_test)
 {
 	PShm		*shm;
@@ -308,6 +525,12 @@ P_TEST_SUITE_BEGIN()
 	P_TEST_SUITE_RUN_CASE (pshm_nomem_test);
 	P_TEST_SUITE_RUN_CASE (pshm_invalid_test);
 	P_TEST_SUITE_RUN_CASE (pshm_general_test);
+	P_TEST_SUITE_RUN_CASE (pshm_flags_test);
+	P_TEST_SUITE_RUN_CASE (pshm_anonymous_test);
+
+#ifndef P_OS_HPUX
+	P_TEST_SUITE_RUN_CASE (pshm_shared_lock_test);
+#endif
 	P_TEST_SUITE_RUN_CASE (pshm_thread_test);
 }
 P_TEST_SUITE_END()
@@ -0,0 +1,291 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <string.h>
+
+P_TEST_MODULE_INIT ();
+#define PSHMARENA_THREADS	4
+#define PSHMARENA_ITERATIONS	20000
+
+static volatile pint arena_errors = 0;
+
+#ifndef P_OS_HPUX
+static void * shm_arena_thread (void *arg)
+{
+	PShmArena	*arena = (PShmArena *) arg;
+	psize		offsets[8];
+	puchar		*block;
+	puchar		tag;
+
+	tag = (puchar) (PPOINTER_TO_PSIZE (arena) >> 4);
+
+	for (pint i = 0; i < PSHMARENA_ITERATIONS; ++i) {
+		pint slot = i % 8;
+
+		if (i >= 8) {
+			block = (puchar *) p_shm_arena_get_pointer (arena, offsets[slot]);
+
+			for (psize j = 0; j < 24; ++j) {
+				if (block[j] != (puchar) (tag + slot)) {
+					p_atomic_int_inc (&arena_errors);
+					break;
+				}
+			}
+
+			if (p_shm_arena_release (arena, offsets[slot], NULL) == FALSE)
+				p_atomic_int_inc (&arena_errors);
+		}
+
+		offsets[slot] = p_shm_arena_alloc (arena, 24 + (psize) (i % 100), NULL);
+
+		if (offsets[slot] == 0) {
+			p_atomic_int_inc (&arena_errors);
+			break;
+		}
+
+		memset (p_shm_arena_get_pointer (arena, offsets[slot]), tag + slot, 24);
+	}
+
+	for (pint i = 0; i < 8; ++i)
+		p_shm_arena_release (arena, offsets[i], NULL);
+
+	p_uthread_exit (0);
+
+	return NULL;
+}
+#endif /* !P_OS_HPUX */
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+P_TEST_CASE_BEGIN (pshmarena_nomem_test)
+{
+	p_libsys_init ();
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (p_shm_arena_new ("pshm_test_arena", 4096, NULL) == NULL);
+
+	p_mem_restore_vtable ();
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pshmarena_bad_input_test)
+{
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_shm_arena_new (NULL, 4096, NULL) == NULL);
+	P_TEST_CHECK (p_shm_arena_new ("pshm_test_arena", 0, NULL) == NULL);
+	P_TEST_CHECK (p_shm_arena_alloc (NULL, 16, NULL) == 0);
+	P_TEST_CHECK (p_shm_arena_release (NULL, 64, NULL) == FALSE);
+	P_TEST_CHECK (p_shm_arena_get_pointer (NULL, 64) == NULL);
+	P_TEST_CHECK (p_shm_arena_get_offset (NULL, NULL) == 0);
+	P_TEST_CHECK (p_shm_arena_get_free_size (NULL, NULL) == -1);
+
+	p_shm_arena_take_ownership (NULL);
+	p_shm_arena_free (NULL);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pshmarena_general_test)
+{
+	p_libsys_init ();
+
+	PShmArena	*arena  = NULL;
+	PShmArena	*arena2 = NULL;
+	PError		*error  = NULL;
+	psize		offsets[16];
+	psize		offset;
+	pssize		free_size;
+	pchar		*ptr;
+
+	/* Arena may be from the previous test on UNIX systems */
+	arena = p_shm_arena_new ("pshm_test_arena", 4096, NULL);
+	P_TEST_REQUIRE (arena != NULL);
+	p_shm_arena_take_ownership (arena);
+	p_shm_arena_free (arena);
+	arena = p_shm_arena_new ("pshm_test_arena", 4096, NULL);
+	P_TEST_REQUIRE (arena != NULL);
+
+	free_size = p_shm_arena_get_free_size (arena, NULL);
+	P_TEST_CHECK (free_size > 0 && free_size < 4096);
+
+	P_TEST_CHECK (p_shm_arena_alloc (arena, 0, NULL) == 0);
+	P_TEST_CHECK (p_shm_arena_alloc (arena, 8192, NULL) == 0);
+
+	/* Offsets are the same in every instance */
+	offset = p_shm_arena_alloc (arena, 100, NULL);
+	P_TEST_REQUIRE (offset != 0);
+	P_TEST_CHECK (offset % 16 == 0);
+
+	ptr = (pchar *) p_shm_arena_get_pointer (arena, offset);
+	P_TEST_REQUIRE (ptr != NULL);
+	P_TEST_CHECK (p_shm_arena_get_offset (arena, ptr) == offset);
+	strcpy (ptr, "shared arena block");
+
+	arena2 = p_shm_arena_new ("pshm_test_arena", 4096, NULL);
+	P_TEST_REQUIRE (arena2 != NULL);
+	P_TEST_CHECK (strcmp ((pchar *) p_shm_arena_get_pointer (arena2, offset), "shared arena block") == 0);
+	P_TEST_CHECK (p_shm_arena_get_free_size (arena2, NULL) < free_size);
+
+	/* Released by another instance */
+	P_TEST_CHECK (p_shm_arena_release (arena2, offset, NULL) == TRUE);
+	P_TEST_CHECK (p_shm_arena_get_free_size (arena, NULL) == free_size);
+
+	P_TEST_CHECK (p_shm_arena_release (arena, offset, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IPC_INVALID_ARGUMENT);
+	p_error_free (error);
+	error = NULL;
+
+	P_TEST_CHECK (p_shm_arena_release (arena, 0, NULL) == FALSE);
+	P_TEST_CHECK (p_shm_arena_release (arena, offset + 1, NULL) == FALSE);
+	P_TEST_CHECK (p_shm_arena_release (arena, 1 << 20, NULL) == FALSE);
+
+	/* Fill the arena up */
+	for (pint i = 0; i < 16; ++i) {
+		offsets[i] = p_shm_arena_alloc (arena, 200, NULL);
+		P_TEST_REQUIRE (offsets[i] != 0);
+		memset (p_shm_arena_get_pointer (arena, offsets[i]), i, 200);
+	}
+
+	P_TEST_CHECK (p_shm_arena_alloc (arena, 2048, &error) == 0);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IPC_NO_RESOURCES);
+	p_error_free (error);
+
+	/* Blocks don't overlap */
+	for (pint i = 0; i < 16; ++i) {
+		puchar *block = (puchar *) p_shm_arena_get_pointer (arena2, offsets[i]);
+
+		for (pint j = 0; j < 200; ++j)
+			P_TEST_CHECK (block[j] == (puchar) i);
+	}
+
+	/* Neighbour blocks are merged back */
+	for (pint i = 0; i < 16; i += 2)
+		P_TEST_CHECK (p_shm_arena_release (arena, offsets[i], NULL) == TRUE);
+
+	P_TEST_CHECK (p_shm_arena_alloc (arena, 1024, NULL) == 0);
+
+	for (pint i = 1; i < 16; i += 2)
+		P_TEST_CHECK (p_shm_arena_release (arena2, offsets[i], NULL) == TRUE);
+
+	P_TEST_CHECK (p_shm_arena_get_free_size (arena, NULL) == free_size);
+
+	offset = p_shm_arena_alloc (arena, 2048, NULL);
+	P_TEST_CHECK (offset != 0);
+	P_TEST_CHECK (p_shm_arena_release (arena, offset, NULL) == TRUE);
+
+	p_shm_arena_free (arena2);
+	p_shm_arena_free (arena);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+#ifndef P_OS_HPUX
+P_TEST_CASE_BEGIN (pshmarena_thread_test)
+{
+	p_libsys_init ();
+
+	PShmArena	*arena = NULL;
+	PShmArena	*arenas[PSHMARENA_THREADS];
+	PUThread	*thr[PSHMARENA_THREADS];
+	pssize		free_size;
+
+	arena = p_shm_arena_new ("pshm_test_arena_mt", 65536, NULL);
+	P_TEST_REQUIRE (arena != NULL);
+	p_shm_arena_take_ownership (arena);
+	p_shm_arena_free (arena);
+	arena = p_shm_arena_new ("pshm_test_arena_mt", 65536, NULL);
+	P_TEST_REQUIRE (arena != NULL);
+
+	free_size    = p_shm_arena_get_free_size (arena, NULL);
+	arena_errors = 0;
+
+	for (pint i = 0; i < PSHMARENA_THREADS; ++i) {
+		arenas[i] = p_shm_arena_new ("pshm_test_arena_mt", 65536, NULL);
+		P_TEST_REQUIRE (arenas[i] != NULL);
+
+		thr[i] = p_uthread_create ((PUThreadFunc) shm_arena_thread, arenas[i], TRUE, NULL);
+		P_TEST_REQUIRE (thr[i] != NULL);
+	}
+
+	for (pint i = 0; i < PSHMARENA_THREADS; ++i) {
+		P_TEST_CHECK (p_uthread_join (thr[i]) == 0);
+		p_uthread_unref (thr[i]);
+		p_shm_arena_free (arenas[i]);
+	}
+
+	P_TEST_CHECK (arena_errors == 0);
+	P_TEST_CHECK (p_shm_arena_get_free_size (arena, NULL) == free_size);
+
+	p_shm_arena_free (arena);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+#endif /* !P_OS_HPUX */
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pshmarena_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pshmarena_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (pshmarena_general_test);
+
+#ifndef P_OS_HPUX
+	P_TEST_SUITE_RUN_CASE (pshmarena_thread_test);
+#endif
+}
+P_TEST_SUITE_END()
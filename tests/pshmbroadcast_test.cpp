@@ -0,0 +1,312 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <string.h>
+
+P_TEST_MODULE_INIT ();
+
+#define PSHMBROADCAST_READERS	3
+#define PSHMBROADCAST_MESSAGES	100000
+
+static volatile pint bc_errors = 0;
+
+static psize shm_broadcast_fill_message (puchar *msg, puint32 seq)
+{
+	psize len = sizeof (puint32) + seq % 40;
+
+	memcpy (msg, &seq, sizeof (puint32));
+
+	for (psize i = sizeof (puint32); i < len; ++i)
+		msg[i] = (puchar) (seq * 7 + i);
+
+	return len;
+}
+
+#ifndef P_OS_HPUX
+static void * shm_broadcast_read_thread (void *arg)
+{
+	PShmBroadcast	*bc       = (PShmBroadcast *) arg;
+	puchar		msg[64];
+	puchar		check[64];
+	puint32		seq;
+	puint32		last_seq  = 0;
+	pboolean	has_last  = FALSE;
+	pssize		op_result;
+	PError		*error    = NULL;
+
+	while (has_last == FALSE || last_seq < PSHMBROADCAST_MESSAGES - 1) {
+		op_result = p_shm_broadcast_read (bc, msg, sizeof (msg), &error);
+
+		if (op_result < 0) {
+			/* Lost messages are fine, anything else is not */
+			if (p_error_get_code (error) != (pint) P_ERROR_IPC_OVERFLOW) {
+				p_atomic_int_inc (&bc_errors);
+				p_error_free (error);
+				break;
+			}
+
+			p_error_free (error);
+			error = NULL;
+			continue;
+		}
+
+		if (op_result == 0) {
+			p_uthread_yield ();
+			continue;
+		}
+
+		memcpy (&seq, msg, sizeof (puint32));
+
+		if ((has_last == TRUE && seq <= last_seq) ||
+		    (psize) op_result != shm_broadcast_fill_message (check, seq) ||
+		    memcmp (check, msg, (psize) op_result) != 0)
+			p_atomic_int_inc (&bc_errors);
+
+		last_seq = seq;
+		has_last = TRUE;
+	}
+
+	p_uthread_exit (0);
+
+	return NULL;
+}
+#endif /* !P_OS_HPUX */
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+P_TEST_CASE_BEGIN (pshmbroadcast_nomem_test)
+{
+	p_libsys_init ();
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (p_shm_broadcast_new ("pshm_test_broadcast", 64, 16, NULL) == NULL);
+
+	p_mem_restore_vtable ();
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pshmbroadcast_bad_input_test)
+{
+	p_libsys_init ();
+
+	pchar buf[16];
+
+	P_TEST_CHECK (p_shm_broadcast_new (NULL, 64, 16, NULL) == NULL);
+	P_TEST_CHECK (p_shm_broadcast_new ("pshm_test_broadcast", 0, 16, NULL) == NULL);
+	P_TEST_CHECK (p_shm_broadcast_new ("pshm_test_broadcast", 64, 0, NULL) == NULL);
+	P_TEST_CHECK (p_shm_broadcast_write (NULL, buf, sizeof (buf), NULL) == -1);
+	P_TEST_CHECK (p_shm_broadcast_read (NULL, buf, sizeof (buf), NULL) == -1);
+
+	p_shm_broadcast_take_ownership (NULL);
+	p_shm_broadcast_free (NULL);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pshmbroadcast_general_test)
+{
+	p_libsys_init ();
+
+	PShmBroadcast	*writer = NULL;
+	PShmBroadcast	*reader1;
+	PShmBroadcast	*reader2;
+	PError		*error  = NULL;
+	puchar		msg[64];
+	puchar		buf[64];
+	psize		len;
+
+	if (p_atomic_is_lock_free () == FALSE) {
+		P_TEST_CHECK (p_shm_broadcast_new ("pshm_test_broadcast", 64, 16, NULL) == NULL);
+		p_libsys_shutdown ();
+		P_TEST_CASE_RETURN ();
+	}
+
+	/* Ring may be from the previous test on UNIX systems */
+	writer = p_shm_broadcast_new ("pshm_test_broadcast", 64, 16, NULL);
+	P_TEST_REQUIRE (writer != NULL);
+	p_shm_broadcast_take_ownership (writer);
+	p_shm_broadcast_free (writer);
+	writer = p_shm_broadcast_new ("pshm_test_broadcast", 64, 16, NULL);
+	P_TEST_REQUIRE (writer != NULL);
+
+	P_TEST_CHECK (p_shm_broadcast_new ("pshm_test_broadcast", 1024, 16, NULL) == NULL);
+
+	P_TEST_CHECK (p_shm_broadcast_write (writer, NULL, 10, NULL) == -1);
+	P_TEST_CHECK (p_shm_broadcast_write (writer, msg, 0, NULL) == -1);
+	P_TEST_CHECK (p_shm_broadcast_write (writer, msg, 65, NULL) == -1);
+	P_TEST_CHECK (p_shm_broadcast_read (writer, NULL, sizeof (buf), NULL) == -1);
+	P_TEST_CHECK (p_shm_broadcast_read (writer, buf, 0, NULL) == -1);
+
+	P_TEST_CHECK (p_shm_broadcast_write (writer, msg, shm_broadcast_fill_message (msg, 0), NULL) > 0);
+
+	/* Readers start from the messages written after they are opened */
+	reader1 = p_shm_broadcast_new ("pshm_test_broadcast", 64, 16, NULL);
+	reader2 = p_shm_broadcast_new ("pshm_test_broadcast", 64, 16, NULL);
+	P_TEST_REQUIRE (reader1 != NULL);
+	P_TEST_REQUIRE (reader2 != NULL);
+
+	P_TEST_CHECK (p_shm_broadcast_read (reader1, buf, sizeof (buf), NULL) == 0);
+
+	for (puint32 i = 1; i <= 10; ++i) {
+		len = shm_broadcast_fill_message (msg, i);
+		P_TEST_CHECK (p_shm_broadcast_write (writer, msg, len, NULL) == (pssize) len);
+	}
+
+	/* Every reader gets every message */
+	for (puint32 i = 1; i <= 10; ++i) {
+		len = shm_broadcast_fill_message (msg, i);
+
+		P_TEST_CHECK (p_shm_broadcast_read (reader1, buf, sizeof (buf), NULL) == (pssize) len);
+		P_TEST_CHECK (memcmp (msg, buf, len) == 0);
+	}
+
+	P_TEST_CHECK (p_shm_broadcast_read (reader1, buf, sizeof (buf), NULL) == 0);
+
+	/* The message is kept if the storage is too small */
+	P_TEST_CHECK (p_shm_broadcast_read (reader2, buf, 2, NULL) == -1);
+	P_TEST_CHECK (p_shm_broadcast_read (reader2, buf, sizeof (buf), NULL) == (pssize) shm_broadcast_fill_message (msg, 1));
+
+	/* Lapped by the writer */
+	for (puint32 i = 11; i <= 40; ++i) {
+		len = shm_broadcast_fill_message (msg, i);
+		P_TEST_CHECK (p_shm_broadcast_write (writer, msg, len, NULL) == (pssize) len);
+	}
+
+	P_TEST_CHECK (p_shm_broadcast_read (reader2, buf, sizeof (buf), &error) == -1);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IPC_OVERFLOW);
+	p_error_free (error);
+
+	/* The oldest message still in the ring */
+	len = shm_broadcast_fill_message (msg, 26);
+	P_TEST_CHECK (p_shm_broadcast_read (reader2, buf, sizeof (buf), NULL) == (pssize) len);
+	P_TEST_CHECK (memcmp (msg, buf, len) == 0);
+
+	p_shm_broadcast_free (reader1);
+	p_shm_broadcast_free (reader2);
+	p_shm_broadcast_free (writer);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+#ifndef P_OS_HPUX
+P_TEST_CASE_BEGIN (pshmbroadcast_thread_test)
+{
+	p_libsys_init ();
+
+	PShmBroadcast	*writer = NULL;
+	PShmBroadcast	*readers[PSHMBROADCAST_READERS];
+	PUThread	*thr[PSHMBROADCAST_READERS];
+	puchar		msg[64];
+	psize		len;
+
+	if (p_atomic_is_lock_free () == FALSE) {
+		p_libsys_shutdown ();
+		P_TEST_CASE_RETURN ();
+	}
+
+	writer = p_shm_broadcast_new ("pshm_test_broadcast_mt", 64, 256, NULL);
+	P_TEST_REQUIRE (writer != NULL);
+	p_shm_broadcast_take_ownership (writer);
+	p_shm_broadcast_free (writer);
+	writer = p_shm_broadcast_new ("pshm_test_broadcast_mt", 64, 256, NULL);
+	P_TEST_REQUIRE (writer != NULL);
+
+	bc_errors = 0;
+
+	for (pint i = 0; i < PSHMBROADCAST_READERS; ++i) {
+		readers[i] = p_shm_broadcast_new ("pshm_test_broadcast_mt", 64, 256, NULL);
+		P_TEST_REQUIRE (readers[i] != NULL);
+
+		thr[i] = p_uthread_create ((PUThreadFunc) shm_broadcast_read_thread, readers[i], TRUE, NULL);
+		P_TEST_REQUIRE (thr[i] != NULL);
+	}
+
+	for (puint32 i = 0; i < PSHMBROADCAST_MESSAGES; ++i) {
+		len = shm_broadcast_fill_message (msg, i);
+
+		if (p_shm_broadcast_write (writer, msg, len, NULL) != (pssize) len)
+			p_atomic_int_inc (&bc_errors);
+
+		if (i % 64 == 0)
+			p_uthread_yield ();
+	}
+
+	for (pint i = 0; i < PSHMBROADCAST_READERS; ++i) {
+		P_TEST_CHECK (p_uthread_join (thr[i]) == 0);
+		p_uthread_unref (thr[i]);
+		p_shm_broadcast_free (readers[i]);
+	}
+
+	P_TEST_CHECK (bc_errors == 0);
+
+	p_shm_broadcast_free (writer);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+#endif /* !P_OS_HPUX */
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pshmbroadcast_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pshmbroadcast_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (pshmbroadcast_general_test);
+
+#ifndef P_OS_HPUX
+	P_TEST_SUITE_RUN_CASE (pshmbroadcast_thread_test);
+#endif
+}
+P_TEST_SUITE_END()
@@ -153,6 +153,150 @@ static void * shm_buffer_test_read_thread (void *)
 
 	return NULL;
 }
+
+#define PSHMBUFFER_SPSC_TOTAL	(1024 * 1024)
+
+static volatile pint spsc_errors = 0;
+
+static void * shm_buffer_spsc_write_thread (void *)
+{
+	PShmBuffer	*buffer = p_shm_buffer_new_spsc ("pshm_test_buffer_spsc", 1000, NULL);
+	puchar		chunk[97];
+	psize		sent    = 0;
+
+	if (buffer == NULL)
+		p_uthread_exit (1);
+
+	while (sent < PSHMBUFFER_SPSC_TOTAL) {
+		psize len = sent % sizeof (chunk) + 1;
+
+		if (len > PSHMBUFFER_SPSC_TOTAL - sent)
+			len = PSHMBUFFER_SPSC_TOTAL - sent;
+
+		for (psize i = 0; i < len; ++i)
+			chunk[i] = (puchar) (sent + i);
+
+		pssize op_result = p_shm_buffer_write (buffer, chunk, len, NULL);
+
+		if (op_result < 0) {
+			p_atomic_int_inc (&spsc_errors);
+			break;
+		}
+
+		if (op_result == 0)
+			p_uthread_yield ();
+		else
+			sent += len;
+	}
+
+	p_shm_buffer_free (buffer);
+	p_uthread_exit (0);
+
+	return NULL;
+}
+
+static void * shm_buffer_spsc_read_thread (void *)
+{
+	PShmBuffer	*buffer   = p_shm_buffer_new_spsc ("pshm_test_buffer_spsc", 1000, NULL);
+	puchar		chunk[61];
+	psize		received  = 0;
+
+	if (buffer == NULL)
+		p_uthread_exit (1);
+
+	while (received < PSHMBUFFER_SPSC_TOTAL) {
+		pint op_result = p_shm_buffer_read (buffer, chunk, sizeof (chunk), NULL);
+
+		if (op_result < 0) {
+			p_atomic_int_inc (&spsc_errors);
+			break;
+		}
+
+		if (op_result == 0) {
+			p_uthread_yield ();
+			continue;
+		}
+
+		for (pint i = 0; i < op_result; ++i) {
+			if (chunk[i] != (puchar) (received + (psize) i))
+				p_atomic_int_inc (&spsc_errors);
+		}
+
+		received += (psize) op_result;
+	}
+
+	p_shm_buffer_free (buffer);
+	p_uthread_exit (0);
+
+	return NULL;
+}
+
+#define PSHMBUFFER_WAIT_TOTAL	(256 * 1024)
+
+static volatile pint wait_errors = 0;
+
+static void * shm_buffer_wait_write_thread (void *)
+{
+	PShmBuffer	*buffer = p_shm_buffer_new ("pshm_test_buffer_wait", 100, NULL);
+	puchar		chunk[37];
+	psize		sent    = 0;
+
+	if (buffer == NULL)
+		p_uthread_exit (1);
+
+	while (sent < PSHMBUFFER_WAIT_TOTAL) {
+		psize len = sent % sizeof (chunk) + 1;
+
+		if (len > PSHMBUFFER_WAIT_TOTAL - sent)
+			len = PSHMBUFFER_WAIT_TOTAL - sent;
+
+		for (psize i = 0; i < len; ++i)
+			chunk[i] = (puchar) (sent + i);
+
+		if (p_shm_buffer_write_wait (buffer, chunk, len, -1, NULL) != (pssize) len) {
+			p_atomic_int_inc (&wait_errors);
+			break;
+		}
+
+		sent += len;
+	}
+
+	p_shm_buffer_free (buffer);
+	p_uthread_exit (0);
+
+	return NULL;
+}
+
+static void * shm_buffer_wait_read_thread (void *)
+{
+	PShmBuffer	*buffer   = p_shm_buffer_new ("pshm_test_buffer_wait", 100, NULL);
+	puchar		chunk[23];
+	psize		received  = 0;
+
+	if (buffer == NULL)
+		p_uthread_exit (1);
+
+	while (received < PSHMBUFFER_WAIT_TOTAL) {
+		pint op_result = p_shm_buffer_read_wait (buffer, chunk, sizeof (chunk), -1, NULL);
+
+		if (op_result <= 0) {
+			p_atomic_int_inc (&wait_errors);
+			break;
+		}
+
+		for (pint i = 0; i < op_result; ++i) {
+			if (chunk[i] != (puchar) (received + (psize) i))
+				p_atomic_int_inc (&wait_errors);
+		}
+
+		received += (psize) op_result;
+	}
+
+	p_shm_buffer_free (buffer);
+	p_uthread_exit (0);
+
+	return NULL;
+}
 #endif /* !P_OS_HPUX */
 
 extern "C" ppointer pmem_alloc (psize nbytes)
@@ -286,13 +430,293 @@ P_TEST_CASE_BEGIN (pshmbuffer_general_test)
 	P_TEST_CHECK (p_shm_buffer_get_free_space (buffer, NULL) == (10 - sizeof (test_str_sm)));
 	P_TEST_CHECK (p_shm_buffer_get_used_space (buffer, NULL) == sizeof (test_str_sm));
 
+	/* Data wrapped around the end of the buffer */
+	memset (test_buf, 0, sizeof (test_buf));
+	P_TEST_CHECK (p_shm_buffer_read (buffer, (ppointer) test_buf, sizeof (test_buf), NULL) == sizeof (test_str_sm));
+	P_TEST_CHECK (strncmp (test_buf, test_str_sm, sizeof (test_str_sm)) == 0);
+	P_TEST_CHECK (p_shm_buffer_get_used_space (buffer, NULL) == 0);
+
 	p_shm_buffer_free (buffer);
 
 	p_libsys_shutdown ();
 }
 P_TEST_CASE_END ()
 
+P_TEST_CASE_BEGIN (pshmbuffer_spsc_test)
+{
+	p_libsys_init ();
+
+	pchar		test_buf[sizeof (test_str)];
+	PShmBuffer	*buffer = NULL;
+
+	P_TEST_CHECK (p_shm_buffer_new_spsc (NULL, 0, NULL) == NULL);
+
+	if (p_atomic_is_lock_free () == FALSE) {
+		P_TEST_CHECK (p_shm_buffer_new_spsc ("pshm_test_buffer_spsc", 10, NULL) == NULL);
+		p_libsys_shutdown ();
+		P_TEST_CASE_RETURN ();
+	}
+
+	/* Buffer may be from the previous test on UNIX systems */
+	buffer = p_shm_buffer_new_spsc ("pshm_test_buffer_spsc", 10, NULL);
+	P_TEST_REQUIRE (buffer != NULL);
+	p_shm_buffer_take_ownership (buffer);
+	p_shm_buffer_free (buffer);
+	buffer = p_shm_buffer_new_spsc ("pshm_test_buffer_spsc", 10, NULL);
+	P_TEST_REQUIRE (buffer != NULL);
+
+	P_TEST_CHECK (p_shm_buffer_get_free_space (buffer, NULL) == 10);
+	P_TEST_CHECK (p_shm_buffer_get_used_space (buffer, NULL) == 0);
+	P_TEST_CHECK (p_shm_buffer_read (buffer, (ppointer) test_buf, sizeof (test_buf), NULL) == 0);
+	P_TEST_CHECK (p_shm_buffer_write (buffer, (ppointer) test_str, sizeof (test_str), NULL) == 0);
+
+	/* The second message wraps around the end of the buffer */
+	for (pint i = 0; i < 2; ++i) {
+		memset (test_buf, 0, sizeof (test_buf));
+
+		P_TEST_CHECK (p_shm_buffer_write (buffer, (ppointer) test_str_sm, sizeof (test_str_sm), NULL) == sizeof (test_str_sm));
+		P_TEST_CHECK (p_shm_buffer_get_free_space (buffer, NULL) == (10 - sizeof (test_str_sm)));
+		P_TEST_CHECK (p_shm_buffer_get_used_space (buffer, NULL) == sizeof (test_str_sm));
+		P_TEST_CHECK (p_shm_buffer_read (buffer, (ppointer) test_buf, sizeof (test_buf), NULL) == sizeof (test_str_sm));
+		P_TEST_CHECK (strncmp (test_buf, test_str_sm, sizeof (test_str_sm)) == 0);
+		P_TEST_CHECK (p_shm_buffer_get_used_space (buffer, NULL) == 0);
+	}
+
+	p_shm_buffer_clear (buffer);
+	P_TEST_CHECK (p_shm_buffer_get_free_space (buffer, NULL) == 10);
+	P_TEST_CHECK (p_shm_buffer_get_used_space (buffer, NULL) == 0);
+
+	p_shm_buffer_free (buffer);
+
+#ifndef P_OS_HPUX
+	PUThread *thr1, *thr2;
+
+	/* Each side opens the buffer on its own, like another process would */
+	buffer = p_shm_buffer_new_spsc ("pshm_test_buffer_spsc", 1000, NULL);
+	P_TEST_REQUIRE (buffer != NULL);
+	p_shm_buffer_take_ownership (buffer);
+	p_shm_buffer_free (buffer);
+
+	buffer = p_shm_buffer_new_spsc ("pshm_test_buffer_spsc", 1000, NULL);
+	P_TEST_REQUIRE (buffer != NULL);
+
+	spsc_errors = 0;
+
+	thr1 = p_uthread_create ((PUThreadFunc) shm_buffer_spsc_write_thread, NULL, TRUE, NULL);
+	P_TEST_REQUIRE (thr1 != NULL);
+
+	thr2 = p_uthread_create ((PUThreadFunc) shm_buffer_spsc_read_thread, NULL, TRUE, NULL);
+	P_TEST_REQUIRE (thr2 != NULL);
+
+	P_TEST_CHECK (p_uthread_join (thr1) == 0);
+	P_TEST_CHECK (p_uthread_join (thr2) == 0);
+
+	P_TEST_CHECK (spsc_errors == 0);
+	P_TEST_CHECK (p_shm_buffer_get_used_space (buffer, NULL) == 0);
+
+	p_uthread_unref (thr1);
+	p_uthread_unref (thr2);
+	p_shm_buffer_free (buffer);
+#endif
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+static void shm_buffer_view_write (PShmBufferView *view, const pchar *data)
+{
+	memcpy (view->data[0], data, view->size[0]);
+
+	if (view->size[1] > 0)
+		memcpy (view->data[1], data + view->size[0], view->size[1]);
+}
+
+static pboolean shm_buffer_view_equal (PShmBufferView *view, const pchar *data)
+{
+	if (memcmp (view->data[0], data, view->size[0]) != 0)
+		return FALSE;
+
+	return view->size[1] == 0 || memcmp (view->data[1], data + view->size[0], view->size[1]) == 0;
+}
+
+P_TEST_CASE_BEGIN (pshmbuffer_zero_copy_test)
+{
+	p_libsys_init ();
+
+	PShmBufferView	view;
+	PShmBuffer	*buffer;
+
+	P_TEST_CHECK (p_shm_buffer_reserve_write (NULL, 1, &view, NULL) == -1);
+	P_TEST_CHECK (p_shm_buffer_commit_write (NULL, 0, NULL) == -1);
+	P_TEST_CHECK (p_shm_buffer_peek (NULL, &view, NULL) == -1);
+	P_TEST_CHECK (p_shm_buffer_consume (NULL, 0, NULL) == -1);
+
+	for (pint mode = 0; mode < 2; ++mode) {
+		if (mode == 1 && p_atomic_is_lock_free () == FALSE)
+			break;
+
+		/* Buffer may be from the previous test on UNIX systems */
+		buffer = mode == 0 ? p_shm_buffer_new ("pshm_test_buffer_zc", 10, NULL)
+				   : p_shm_buffer_new_spsc ("pshm_test_buffer_zc_spsc", 10, NULL);
+		P_TEST_REQUIRE (buffer != NULL);
+		p_shm_buffer_take_ownership (buffer);
+		p_shm_buffer_free (buffer);
+
+		buffer = mode == 0 ? p_shm_buffer_new ("pshm_test_buffer_zc", 10, NULL)
+				   : p_shm_buffer_new_spsc ("pshm_test_buffer_zc_spsc", 10, NULL);
+		P_TEST_REQUIRE (buffer != NULL);
+
+		P_TEST_CHECK (p_shm_buffer_reserve_write (buffer, 0, &view, NULL) == -1);
+		P_TEST_CHECK (p_shm_buffer_reserve_write (buffer, 11, &view, NULL) == 0);
+		P_TEST_CHECK (p_shm_buffer_commit_write (buffer, 0, NULL) == -1);
+		P_TEST_CHECK (p_shm_buffer_consume (buffer, 0, NULL) == -1);
+		P_TEST_CHECK (p_shm_buffer_peek (buffer, &view, NULL) == 0);
+		P_TEST_CHECK (view.size[0] == 0 && view.size[1] == 0);
+
+		/* Contiguous range, partly committed */
+		P_TEST_CHECK (p_shm_buffer_reserve_write (buffer, 8, &view, NULL) == 8);
+		P_TEST_CHECK (view.size[0] == 8 && view.size[1] == 0);
+		P_TEST_CHECK (p_shm_buffer_reserve_write (buffer, 1, &view, NULL) == -1);
+		shm_buffer_view_write (&view, "Small!!!");
+		P_TEST_CHECK (p_shm_buffer_commit_write (buffer, 9, NULL) == -1);
+		P_TEST_CHECK (p_shm_buffer_commit_write (buffer, 6, NULL) == 6);
+		P_TEST_CHECK (p_shm_buffer_get_used_space (buffer, NULL) == 6);
+
+		P_TEST_CHECK (p_shm_buffer_peek (buffer, &view, NULL) == 6);
+		P_TEST_CHECK (view.size[0] == 6 && view.size[1] == 0);
+		P_TEST_CHECK (shm_buffer_view_equal (&view, "Small!") == TRUE);
+		P_TEST_CHECK (p_shm_buffer_peek (buffer, &view, NULL) == -1);
+		P_TEST_CHECK (p_shm_buffer_consume (buffer, 7, NULL) == -1);
+		P_TEST_CHECK (p_shm_buffer_consume (buffer, 6, NULL) == 6);
+		P_TEST_CHECK (p_shm_buffer_get_used_space (buffer, NULL) == 0);
+
+		/* The range wraps around the end of the buffer, so it has two parts */
+		P_TEST_CHECK (p_shm_buffer_reserve_write (buffer, 9, &view, NULL) == 9);
+		P_TEST_CHECK (view.size[0] == 5 && view.size[1] == 4);
+		P_TEST_CHECK (view.data[1] != NULL);
+		shm_buffer_view_write (&view, "Wrapped!!");
+
+		/* Locked mode: the reader side of the same object shares the lock */
+		P_TEST_CHECK (p_shm_buffer_peek (buffer, &view, NULL) == 0);
+		P_TEST_CHECK (p_shm_buffer_commit_write (buffer, 9, NULL) == 9);
+
+		P_TEST_CHECK (p_shm_buffer_peek (buffer, &view, NULL) == 9);
+		P_TEST_CHECK (view.size[0] == 5 && view.size[1] == 4);
+		P_TEST_CHECK (shm_buffer_view_equal (&view, "Wrapped!!") == TRUE);
+		P_TEST_CHECK (p_shm_buffer_consume (buffer, 4, NULL) == 4);
+
+		P_TEST_CHECK (p_shm_buffer_peek (buffer, &view, NULL) == 5);
+		P_TEST_CHECK (view.size[0] == 1 && view.size[1] == 4);
+		P_TEST_CHECK (shm_buffer_view_equal (&view, "ped!!") == TRUE);
+		P_TEST_CHECK (p_shm_buffer_consume (buffer, 0, NULL) == 0);
+
+		/* Copying calls still work after the zero-copy ones */
+		pchar test_buf[sizeof (test_str)];
+
+		memset (test_buf, 0, sizeof (test_buf));
+		P_TEST_CHECK (p_shm_buffer_read (buffer, (ppointer) test_buf, sizeof (test_buf), NULL) == 5);
+		P_TEST_CHECK (strncmp (test_buf, "ped!!", 5) == 0);
+		P_TEST_CHECK (p_shm_buffer_get_free_space (buffer, NULL) == 10);
+
+		/* The reservation must not stay locked after free */
+		P_TEST_CHECK (p_shm_buffer_reserve_write (buffer, 3, &view, NULL) == 3);
+		p_shm_buffer_free (buffer);
+	}
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
 #ifndef P_OS_HPUX
+P_TEST_CASE_BEGIN (pshmbuffer_wait_test)
+{
+	p_libsys_init ();
+
+	pchar		test_buf[sizeof (test_str)];
+	PShmBuffer	*buffer = NULL;
+	PTimeProfiler	*profiler;
+	PUThread	*thr1, *thr2;
+	PDeadline	deadline;
+
+	/* Buffer may be from the previous test on UNIX systems */
+	buffer = p_shm_buffer_new ("pshm_test_buffer_wait", 100, NULL);
+	P_TEST_REQUIRE (buffer != NULL);
+	p_shm_buffer_take_ownership (buffer);
+	p_shm_buffer_free (buffer);
+	buffer = p_shm_buffer_new ("pshm_test_buffer_wait", 100, NULL);
+	P_TEST_REQUIRE (buffer != NULL);
+
+	P_TEST_CHECK (p_shm_buffer_read_wait (NULL, (ppointer) test_buf, sizeof (test_buf), 0, NULL) == -1);
+	P_TEST_CHECK (p_shm_buffer_read_wait (buffer, NULL, sizeof (test_buf), 0, NULL) == -1);
+	P_TEST_CHECK (p_shm_buffer_write_wait (NULL, (ppointer) test_str, sizeof (test_str), 0, NULL) == -1);
+	P_TEST_CHECK (p_shm_buffer_write_wait (buffer, (ppointer) test_str, 101, 0, NULL) == -1);
+
+	profiler = p_time_profiler_new ();
+	P_TEST_REQUIRE (profiler != NULL);
+
+	P_TEST_CHECK (p_shm_buffer_read_wait (buffer, (ppointer) test_buf, sizeof (test_buf), 0, NULL) == 0);
+	P_TEST_CHECK (p_shm_buffer_read_wait (buffer, (ppointer) test_buf, sizeof (test_buf), 100, NULL) == 0);
+	P_TEST_CHECK (p_time_profiler_elapsed_usecs (profiler) >= 90 * 1000);
+
+	for (pint i = 0; i < 4; ++i)
+		P_TEST_CHECK (p_shm_buffer_write_wait (buffer, (ppointer) test_str, sizeof (test_str), 0, NULL) == sizeof (test_str));
+
+	p_time_profiler_reset (profiler);
+
+	P_TEST_CHECK (p_shm_buffer_write_wait (buffer, (ppointer) test_str, sizeof (test_str), 100, NULL) == 0);
+	P_TEST_CHECK (p_time_profiler_elapsed_usecs (profiler) >= 90 * 1000);
+
+	/* Deadline variants share the wait path with the relative timeouts */
+	P_TEST_CHECK (p_shm_buffer_read_until (NULL, (ppointer) test_buf, sizeof (test_buf), NULL, NULL) == -1);
+	P_TEST_CHECK (p_shm_buffer_write_until (NULL, (ppointer) test_str, sizeof (test_str), NULL, NULL) == -1);
+
+	p_deadline_init_msecs (&deadline, 0);
+	P_TEST_CHECK (p_shm_buffer_write_until (buffer, (ppointer) test_str, sizeof (test_str), &deadline, NULL) == 0);
+
+	p_deadline_init_msecs (&deadline, 100);
+	p_time_profiler_reset (profiler);
+
+	P_TEST_CHECK (p_shm_buffer_write_until (buffer, (ppointer) test_str, sizeof (test_str), &deadline, NULL) == 0);
+	P_TEST_CHECK (p_time_profiler_elapsed_usecs (profiler) >= 90 * 1000);
+	P_TEST_CHECK (p_deadline_has_expired (&deadline) == TRUE);
+
+	/* Available data is read even after the deadline */
+	memset (test_buf, 0, sizeof (test_buf));
+	P_TEST_CHECK (p_shm_buffer_read_until (buffer, (ppointer) test_buf, sizeof (test_buf), &deadline, NULL) == sizeof (test_buf));
+	P_TEST_CHECK (strncmp (test_buf, test_str, sizeof (test_str)) == 0);
+
+	memset (test_buf, 0, sizeof (test_buf));
+	P_TEST_CHECK (p_shm_buffer_read_wait (buffer, (ppointer) test_buf, sizeof (test_buf), -1, NULL) == sizeof (test_buf));
+	P_TEST_CHECK (strncmp (test_buf, test_str, sizeof (test_str)) == 0);
+
+	p_time_profiler_free (profiler);
+	p_shm_buffer_clear (buffer);
+
+	wait_errors = 0;
+
+	thr1 = p_uthread_create ((PUThreadFunc) shm_buffer_wait_read_thread, NULL, TRUE, NULL);
+	P_TEST_REQUIRE (thr1 != NULL);
+
+	/* Let the reader go to sleep first */
+	p_uthread_sleep (50);
+
+	thr2 = p_uthread_create ((PUThreadFunc) shm_buffer_wait_write_thread, NULL, TRUE, NULL);
+	P_TEST_REQUIRE (thr2 != NULL);
+
+	P_TEST_CHECK (p_uthread_join (thr1) == 0);
+	P_TEST_CHECK (p_uthread_join (thr2) == 0);
+
+	P_TEST_CHECK (wait_errors == 0);
+	P_TEST_CHECK (p_shm_buffer_get_used_space (buffer, NULL) == 0);
+
+	p_uthread_unref (thr1);
+	p_uthread_unref (thr2);
+	p_shm_buffer_free (buffer);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
 P_TEST_CASE_BEGIN (pshmbuffer_thread_test)
 {
 	p_libsys_init ();
@@ -344,8 +768,11 @@ P_TEST_SUITE_BEGIN()
 	P_TEST_SUITE_RUN_CASE (pshmbuffer_nomem_test);
 	P_TEST_SUITE_RUN_CASE (pshmbuffer_bad_input_test);
 	P_TEST_SUITE_RUN_CASE (pshmbuffer_general_test);
+	P_TEST_SUITE_RUN_CASE (pshmbuffer_spsc_test);
+	P_TEST_SUITE_RUN_CASE (pshmbuffer_zero_copy_test);
 
 #ifndef P_OS_HPUX
+	P_TEST_SUITE_RUN_CASE (pshmbuffer_wait_test);
 	P_TEST_SUITE_RUN_CASE (pshmbuffer_thread_test);
 #endif
 }
@@ -0,0 +1,322 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <string.h>
+
+P_TEST_MODULE_INIT ();
+
+#define PSHMQUEUE_PRODUCERS	4
+#define PSHMQUEUE_MESSAGES	20000
+
+static volatile pint	mp_errors = 0;
+static puint32		mp_next_seq[PSHMQUEUE_PRODUCERS];
+static psize		mp_received = 0;
+
+static psize shm_queue_fill_message (puchar *msg, puint32 producer, puint32 seq)
+{
+	psize len = 2 * sizeof (puint32) + seq % 50;
+
+	memcpy (msg, &producer, sizeof (puint32));
+	memcpy (msg + sizeof (puint32), &seq, sizeof (puint32));
+
+	for (psize i = 2 * sizeof (puint32); i < len; ++i)
+		msg[i] = (puchar) (seq + i);
+
+	return len;
+}
+
+#ifndef P_OS_HPUX
+static void * shm_queue_producer_thread (void *arg)
+{
+	PShmQueue	*queue    = p_shm_queue_new ("pshm_test_queue_mp", 4096, NULL);
+	puint32		producer  = (puint32) PPOINTER_TO_PSIZE (arg);
+	puchar		msg[64];
+
+	if (queue == NULL)
+		p_uthread_exit (1);
+
+	for (puint32 seq = 0; seq < PSHMQUEUE_MESSAGES; ) {
+		psize	len       = shm_queue_fill_message (msg, producer, seq);
+		pssize	op_result = p_shm_queue_push (queue, msg, len, NULL);
+
+		if (op_result < 0) {
+			p_atomic_int_inc (&mp_errors);
+			break;
+		}
+
+		if (op_result == 0)
+			p_uthread_yield ();
+		else
+			++seq;
+	}
+
+	p_shm_queue_free (queue);
+	p_uthread_exit (0);
+
+	return NULL;
+}
+#endif /* !P_OS_HPUX */
+
+static void shm_queue_check_message (pconstpointer data, psize len, ppointer user_data)
+{
+	puchar	msg[64];
+	puint32	producer, seq;
+
+	P_UNUSED (user_data);
+
+	memcpy (&producer, data, sizeof (puint32));
+	memcpy (&seq, (const puchar *) data + sizeof (puint32), sizeof (puint32));
+
+	if (producer >= PSHMQUEUE_PRODUCERS || seq != mp_next_seq[producer]) {
+		p_atomic_int_inc (&mp_errors);
+		return;
+	}
+
+	if (len != shm_queue_fill_message (msg, producer, seq) || memcmp (msg, data, len) != 0)
+		p_atomic_int_inc (&mp_errors);
+
+	++mp_next_seq[producer];
+	++mp_received;
+}
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+P_TEST_CASE_BEGIN (pshmqueue_nomem_test)
+{
+	p_libsys_init ();
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (p_shm_queue_new ("pshm_test_queue", 1024, NULL) == NULL);
+
+	p_mem_restore_vtable ();
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pshmqueue_bad_input_test)
+{
+	p_libsys_init ();
+
+	pchar buf[16];
+
+	P_TEST_CHECK (p_shm_queue_new (NULL, 0, NULL) == NULL);
+	P_TEST_CHECK (p_shm_queue_push (NULL, buf, sizeof (buf), NULL) == -1);
+	P_TEST_CHECK (p_shm_queue_pop (NULL, buf, sizeof (buf), NULL) == -1);
+	P_TEST_CHECK (p_shm_queue_pop_batch (NULL, shm_queue_check_message, NULL, 1, NULL) == -1);
+
+	p_shm_queue_take_ownership (NULL);
+	p_shm_queue_free (NULL);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pshmqueue_general_test)
+{
+	p_libsys_init ();
+
+	PShmQueue	*queue = NULL;
+	puchar		msg[128];
+	puchar		buf[128];
+
+	if (p_atomic_is_lock_free () == FALSE) {
+		P_TEST_CHECK (p_shm_queue_new ("pshm_test_queue", 256, NULL) == NULL);
+		p_libsys_shutdown ();
+		P_TEST_CASE_RETURN ();
+	}
+
+	/* Queue may be from the previous test on UNIX systems */
+	queue = p_shm_queue_new ("pshm_test_queue", 256, NULL);
+	P_TEST_REQUIRE (queue != NULL);
+	p_shm_queue_take_ownership (queue);
+	p_shm_queue_free (queue);
+	queue = p_shm_queue_new ("pshm_test_queue", 256, NULL);
+	P_TEST_REQUIRE (queue != NULL);
+
+	P_TEST_CHECK (p_shm_queue_push (queue, NULL, 10, NULL) == -1);
+	P_TEST_CHECK (p_shm_queue_push (queue, msg, 0, NULL) == -1);
+	P_TEST_CHECK (p_shm_queue_push (queue, msg, 128, NULL) == -1);
+	P_TEST_CHECK (p_shm_queue_pop (queue, NULL, sizeof (buf), NULL) == -1);
+	P_TEST_CHECK (p_shm_queue_pop (queue, buf, 0, NULL) == -1);
+	P_TEST_CHECK (p_shm_queue_pop_batch (queue, NULL, NULL, 1, NULL) == -1);
+	P_TEST_CHECK (p_shm_queue_pop_batch (queue, shm_queue_check_message, NULL, 0, NULL) == -1);
+
+	P_TEST_CHECK (p_shm_queue_pop (queue, buf, sizeof (buf), NULL) == 0);
+
+	/* Each 20 bytes message takes a 32 bytes record */
+	for (puint32 i = 0; i < 8; ++i) {
+		memset (msg, (pint) i, 20);
+		P_TEST_CHECK (p_shm_queue_push (queue, msg, 20, NULL) == 20);
+	}
+
+	P_TEST_CHECK (p_shm_queue_push (queue, msg, 1, NULL) == 0);
+
+	/* The message stays in the queue if it doesn't fit */
+	P_TEST_CHECK (p_shm_queue_pop (queue, buf, 10, NULL) == -1);
+
+	for (puint32 i = 0; i < 8; ++i) {
+		memset (msg, (pint) i, 20);
+		memset (buf, 0, sizeof (buf));
+
+		P_TEST_CHECK (p_shm_queue_pop (queue, buf, sizeof (buf), NULL) == 20);
+		P_TEST_CHECK (memcmp (msg, buf, 20) == 0);
+	}
+
+	P_TEST_CHECK (p_shm_queue_pop (queue, buf, sizeof (buf), NULL) == 0);
+
+	/* The last 16 bytes are skipped, the records go on from the start */
+	for (puint32 i = 0; i < 5; ++i) {
+		memset (msg, (pint) i, 40);
+		P_TEST_CHECK (p_shm_queue_push (queue, msg, 40, NULL) == 40);
+	}
+
+	P_TEST_CHECK (p_shm_queue_pop (queue, buf, sizeof (buf), NULL) == 40);
+
+	for (puint32 i = 0; i < 4; ++i)
+		P_TEST_CHECK (p_shm_queue_pop (queue, buf, sizeof (buf), NULL) == 40);
+
+	P_TEST_CHECK (p_shm_queue_push (queue, msg, 40, NULL) == 40);
+	P_TEST_CHECK (p_shm_queue_pop (queue, buf, sizeof (buf), NULL) == 40);
+
+	/* The batch keeps the order and frees the space at once */
+	memset (mp_next_seq, 0, sizeof (mp_next_seq));
+	mp_errors   = 0;
+	mp_received = 0;
+
+	for (puint32 i = 0; i < 3; ++i)
+		P_TEST_CHECK (p_shm_queue_push (queue, msg, shm_queue_fill_message (msg, 1, i), NULL) > 0);
+
+	P_TEST_CHECK (p_shm_queue_pop_batch (queue, shm_queue_check_message, NULL, 2, NULL) == 2);
+	P_TEST_CHECK (p_shm_queue_pop_batch (queue, shm_queue_check_message, NULL, 10, NULL) == 1);
+	P_TEST_CHECK (p_shm_queue_pop_batch (queue, shm_queue_check_message, NULL, 10, NULL) == 0);
+	P_TEST_CHECK (mp_errors == 0);
+	P_TEST_CHECK (mp_received == 3);
+
+	p_shm_queue_free (queue);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+#ifndef P_OS_HPUX
+P_TEST_CASE_BEGIN (pshmqueue_thread_test)
+{
+	p_libsys_init ();
+
+	PShmQueue	*queue = NULL;
+	PUThread	*thr[PSHMQUEUE_PRODUCERS];
+	pssize		op_result;
+
+	if (p_atomic_is_lock_free () == FALSE) {
+		p_libsys_shutdown ();
+		P_TEST_CASE_RETURN ();
+	}
+
+	queue = p_shm_queue_new ("pshm_test_queue_mp", 4096, NULL);
+	P_TEST_REQUIRE (queue != NULL);
+	p_shm_queue_take_ownership (queue);
+	p_shm_queue_free (queue);
+
+	/* Each producer opens the queue on its own, like another process would */
+	queue = p_shm_queue_new ("pshm_test_queue_mp", 4096, NULL);
+	P_TEST_REQUIRE (queue != NULL);
+
+	memset (mp_next_seq, 0, sizeof (mp_next_seq));
+	mp_errors   = 0;
+	mp_received = 0;
+
+	for (psize i = 0; i < PSHMQUEUE_PRODUCERS; ++i) {
+		thr[i] = p_uthread_create ((PUThreadFunc) shm_queue_producer_thread, PSIZE_TO_POINTER (i), TRUE, NULL);
+		P_TEST_REQUIRE (thr[i] != NULL);
+	}
+
+	while (mp_received < PSHMQUEUE_PRODUCERS * PSHMQUEUE_MESSAGES && mp_errors == 0) {
+		op_result = p_shm_queue_pop_batch (queue, shm_queue_check_message, NULL, 16, NULL);
+
+		if (op_result < 0) {
+			p_atomic_int_inc (&mp_errors);
+			break;
+		}
+
+		if (op_result == 0)
+			p_uthread_yield ();
+	}
+
+	for (psize i = 0; i < PSHMQUEUE_PRODUCERS; ++i) {
+		P_TEST_CHECK (p_uthread_join (thr[i]) == 0);
+		p_uthread_unref (thr[i]);
+	}
+
+	P_TEST_CHECK (mp_errors == 0);
+	P_TEST_CHECK (mp_received == PSHMQUEUE_PRODUCERS * PSHMQUEUE_MESSAGES);
+
+	for (psize i = 0; i < PSHMQUEUE_PRODUCERS; ++i)
+		P_TEST_CHECK (mp_next_seq[i] == PSHMQUEUE_MESSAGES);
+
+	p_shm_queue_free (queue);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+#endif /* !P_OS_HPUX */
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pshmqueue_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pshmqueue_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (pshmqueue_general_test);
+
+#ifndef P_OS_HPUX
+	P_TEST_SUITE_RUN_CASE (pshmqueue_thread_test);
+#endif
+}
+P_TEST_SUITE_END()
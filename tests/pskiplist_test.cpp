@@ -0,0 +1,419 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+P_TEST_MODULE_INIT ();
+
+#define PSKIPLIST_STRESS_COUNT	2000
+#define PSKIPLIST_THREADS	4
+
+static PSkipList *		test_list       = NULL;
+static volatile pboolean	test_is_working = FALSE;
+static volatile pint		test_destroyed  = 0;
+static volatile pint		test_net_count  = 0;
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static pint
+compare_keys (pconstpointer a, pconstpointer b, ppointer data)
+{
+	pint p1 = PPOINTER_TO_INT (a);
+	pint p2 = PPOINTER_TO_INT (b);
+
+	P_UNUSED (data);
+
+	return p1 < p2 ? -1 : (p1 > p2 ? 1 : 0);
+}
+
+static void
+destroy_value (ppointer data)
+{
+	P_UNUSED (data);
+
+	p_atomic_int_inc (&test_destroyed);
+}
+
+/* state[0] is the previous key, state[1] counts the keys, state[2] the errors
+ * and state[3] the number of keys to stop after */
+static pboolean
+check_order_func (ppointer key, ppointer value, ppointer user_data)
+{
+	pint *state = (pint *) user_data;
+
+	if (PPOINTER_TO_INT (key) <= state[0] || PPOINTER_TO_INT (value) != PPOINTER_TO_INT (key) * 2)
+		++state[2];
+
+	state[0] = PPOINTER_TO_INT (key);
+	++state[1];
+
+	return state[1] == state[3];
+}
+
+static void * test_writer_thread_func (void *data)
+{
+	pint base = PPOINTER_TO_INT (data) * PSKIPLIST_STRESS_COUNT;
+	pint errors = 0;
+
+	for (pint round = 0; round < 5; ++round) {
+		/* Own keys never collide with the other writers */
+		for (pint i = 1; i <= PSKIPLIST_STRESS_COUNT; ++i)
+			if (p_skip_list_insert (test_list, PINT_TO_POINTER (base + i), PINT_TO_POINTER ((base + i) * 2)) == FALSE)
+				++errors;
+
+		for (pint i = 1; i <= PSKIPLIST_STRESS_COUNT; ++i)
+			if (p_skip_list_lookup (test_list, PINT_TO_POINTER (base + i)) != PINT_TO_POINTER ((base + i) * 2))
+				++errors;
+
+		for (pint i = 1; i <= PSKIPLIST_STRESS_COUNT; i += 2)
+			if (p_skip_list_remove (test_list, PINT_TO_POINTER (base + i)) == FALSE)
+				++errors;
+
+		for (pint i = 1; i <= PSKIPLIST_STRESS_COUNT; i += 2)
+			if (p_skip_list_lookup (test_list, PINT_TO_POINTER (base + i)) != (ppointer) -1)
+				++errors;
+
+		if (round < 4)
+			for (pint i = 2; i <= PSKIPLIST_STRESS_COUNT; i += 2)
+				if (p_skip_list_remove (test_list, PINT_TO_POINTER (base + i)) == FALSE)
+					++errors;
+
+		/* Shared keys are contended by all the writers */
+		for (pint i = 1; i <= 100; ++i) {
+			if (p_skip_list_insert (test_list, PINT_TO_POINTER (-i), PINT_TO_POINTER (-i * 2)) == TRUE)
+				p_atomic_int_inc (&test_net_count);
+
+			if (p_skip_list_remove (test_list, PINT_TO_POINTER (-((i * 7) % 100) - 1)) == TRUE)
+				p_atomic_int_add (&test_net_count, -1);
+		}
+	}
+
+	p_uthread_exit (errors);
+
+	return NULL;
+}
+
+static void * test_reader_thread_func (void *data)
+{
+	pint	errors = 0;
+	pint	state[4];
+
+	P_UNUSED (data);
+
+	while (test_is_working == TRUE) {
+		state[0] = -1000;
+		state[1] = 0;
+		state[2] = 0;
+		state[3] = -1;
+
+		p_skip_list_foreach (test_list, check_order_func, state);
+		errors += state[2];
+
+		state[0] = PSKIPLIST_STRESS_COUNT - 1;
+		state[1] = 0;
+
+		p_skip_list_foreach_range (test_list,
+					   PINT_TO_POINTER (PSKIPLIST_STRESS_COUNT),
+					   PINT_TO_POINTER (PSKIPLIST_STRESS_COUNT * 2),
+					   check_order_func,
+					   state);
+
+		errors += state[2];
+
+		if (state[0] >= PSKIPLIST_STRESS_COUNT * 2)
+			++errors;
+
+		p_uthread_yield ();
+	}
+
+	p_uthread_exit (errors);
+
+	return NULL;
+}
+
+P_TEST_CASE_BEGIN (pskiplist_nomem_test)
+{
+	p_libsys_init ();
+
+	PSkipList *list = p_skip_list_new (compare_keys, NULL);
+	P_TEST_REQUIRE (list != NULL);
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (p_skip_list_new (compare_keys, NULL) == NULL);
+	P_TEST_CHECK (p_skip_list_insert (list, PINT_TO_POINTER (1), PINT_TO_POINTER (2)) == FALSE);
+	P_TEST_CHECK (p_skip_list_lookup (list, PINT_TO_POINTER (1)) == (ppointer) -1);
+	P_TEST_CHECK (p_skip_list_get_count (list) == 0);
+
+	p_mem_restore_vtable ();
+
+	p_skip_list_free (list);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pskiplist_invalid_test)
+{
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_skip_list_new (NULL, NULL) == NULL);
+	P_TEST_CHECK (p_skip_list_new_full (NULL, NULL, NULL, NULL) == NULL);
+	P_TEST_CHECK (p_skip_list_insert (NULL, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_skip_list_remove (NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_skip_list_lookup (NULL, NULL) == (ppointer) -1);
+	P_TEST_CHECK (p_skip_list_get_count (NULL) == 0);
+
+	p_skip_list_foreach (NULL, NULL, NULL);
+	p_skip_list_foreach_range (NULL, NULL, NULL, NULL, NULL);
+	p_skip_list_free (NULL);
+
+	PSkipList *list = p_skip_list_new (compare_keys, NULL);
+	P_TEST_REQUIRE (list != NULL);
+
+	p_skip_list_foreach (list, NULL, NULL);
+	p_skip_list_foreach_range (list, NULL, NULL, NULL, NULL);
+
+	p_skip_list_free (list);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pskiplist_general_test)
+{
+	p_libsys_init ();
+
+	PSkipList	*list;
+	pint		state[4];
+
+	list = p_skip_list_new (compare_keys, NULL);
+	P_TEST_REQUIRE (list != NULL);
+
+	P_TEST_CHECK (p_skip_list_lookup (list, PINT_TO_POINTER (1)) == (ppointer) -1);
+	P_TEST_CHECK (p_skip_list_remove (list, PINT_TO_POINTER (1)) == FALSE);
+
+	/* Inserted in a scattered order */
+	for (pint i = 0; i < 1000; ++i) {
+		pint key = (i * 617) % 1000;
+
+		P_TEST_CHECK (p_skip_list_insert (list, PINT_TO_POINTER (key), PINT_TO_POINTER (key * 2)) == TRUE);
+	}
+
+	P_TEST_CHECK (p_skip_list_get_count (list) == 1000);
+
+	/* Existing values are not replaced */
+	P_TEST_CHECK (p_skip_list_insert (list, PINT_TO_POINTER (10), PINT_TO_POINTER (1)) == FALSE);
+	P_TEST_CHECK (p_skip_list_lookup (list, PINT_TO_POINTER (10)) == PINT_TO_POINTER (20));
+	P_TEST_CHECK (p_skip_list_lookup (list, PINT_TO_POINTER (1000)) == (ppointer) -1);
+
+	for (pint i = 0; i < 1000; ++i)
+		P_TEST_CHECK (p_skip_list_lookup (list, PINT_TO_POINTER (i)) == PINT_TO_POINTER (i * 2));
+
+	state[0] = -1;
+	state[1] = 0;
+	state[2] = 0;
+	state[3] = -1;
+
+	p_skip_list_foreach (list, check_order_func, state);
+	P_TEST_CHECK (state[1] == 1000 && state[2] == 0 && state[0] == 999);
+
+	/* Stop after 10 keys */
+	state[0] = -1;
+	state[1] = 0;
+	state[3] = 10;
+
+	p_skip_list_foreach (list, check_order_func, state);
+	P_TEST_CHECK (state[1] == 10 && state[0] == 9);
+
+	for (pint i = 0; i < 1000; i += 3)
+		P_TEST_CHECK (p_skip_list_remove (list, PINT_TO_POINTER (i)) == TRUE);
+
+	P_TEST_CHECK (p_skip_list_remove (list, PINT_TO_POINTER (0)) == FALSE);
+	P_TEST_CHECK (p_skip_list_get_count (list) == 666);
+
+	for (pint i = 0; i < 1000; ++i) {
+		if (i % 3 == 0)
+			P_TEST_CHECK (p_skip_list_lookup (list, PINT_TO_POINTER (i)) == (ppointer) -1);
+		else
+			P_TEST_CHECK (p_skip_list_lookup (list, PINT_TO_POINTER (i)) == PINT_TO_POINTER (i * 2));
+	}
+
+	/* [100, 200) without the multiples of 3 */
+	state[0] = -1;
+	state[1] = 0;
+	state[2] = 0;
+	state[3] = -1;
+
+	p_skip_list_foreach_range (list, PINT_TO_POINTER (99), PINT_TO_POINTER (200), check_order_func, state);
+	P_TEST_CHECK (state[1] == 67 && state[2] == 0 && state[0] == 199);
+
+	state[0] = -1;
+	state[1] = 0;
+
+	p_skip_list_foreach_range (list, PINT_TO_POINTER (500), PINT_TO_POINTER (500), check_order_func, state);
+	P_TEST_CHECK (state[1] == 0);
+
+	p_skip_list_foreach_range (list, PINT_TO_POINTER (998), PINT_TO_POINTER (5000), check_order_func, state);
+	P_TEST_CHECK (state[1] == 1 && state[0] == 998);
+
+	/* A removed key can be inserted again */
+	P_TEST_CHECK (p_skip_list_insert (list, PINT_TO_POINTER (3), PINT_TO_POINTER (6)) == TRUE);
+	P_TEST_CHECK (p_skip_list_lookup (list, PINT_TO_POINTER (3)) == PINT_TO_POINTER (6));
+
+	p_skip_list_free (list);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pskiplist_destroy_test)
+{
+	p_libsys_init ();
+
+	PSkipList *list;
+
+	list = p_skip_list_new_full (compare_keys, NULL, NULL, destroy_value);
+	P_TEST_REQUIRE (list != NULL);
+
+	test_destroyed = 0;
+
+	for (pint i = 0; i < 100; ++i)
+		P_TEST_CHECK (p_skip_list_insert (list, PINT_TO_POINTER (i), PINT_TO_POINTER (i)) == TRUE);
+
+	/* The failed insertion doesn't destroy anything */
+	P_TEST_CHECK (p_skip_list_insert (list, PINT_TO_POINTER (1), PINT_TO_POINTER (1)) == FALSE);
+
+	for (pint i = 0; i < 50; ++i)
+		P_TEST_CHECK (p_skip_list_remove (list, PINT_TO_POINTER (i)) == TRUE);
+
+	P_TEST_CHECK (p_atomic_int_get (&test_destroyed) <= 50);
+
+	p_skip_list_free (list);
+
+	P_TEST_CHECK (p_atomic_int_get (&test_destroyed) == 100);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pskiplist_thread_test)
+{
+	p_libsys_init ();
+
+	PUThread	*writers[PSKIPLIST_THREADS];
+	PUThread	*readers[2];
+	pint		state[4];
+	pint		shared;
+
+	test_list = p_skip_list_new (compare_keys, NULL);
+	P_TEST_REQUIRE (test_list != NULL);
+
+	test_is_working = TRUE;
+	test_net_count  = 0;
+
+	for (pint i = 0; i < 2; ++i) {
+		readers[i] = p_uthread_create ((PUThreadFunc) test_reader_thread_func, NULL, TRUE, NULL);
+		P_TEST_REQUIRE (readers[i] != NULL);
+	}
+
+	for (pint i = 0; i < PSKIPLIST_THREADS; ++i) {
+		writers[i] = p_uthread_create ((PUThreadFunc) test_writer_thread_func, PINT_TO_POINTER (i + 1), TRUE, NULL);
+		P_TEST_REQUIRE (writers[i] != NULL);
+	}
+
+	for (pint i = 0; i < PSKIPLIST_THREADS; ++i) {
+		P_TEST_CHECK (p_uthread_join (writers[i]) == 0);
+		p_uthread_unref (writers[i]);
+	}
+
+	test_is_working = FALSE;
+
+	for (pint i = 0; i < 2; ++i) {
+		P_TEST_CHECK (p_uthread_join (readers[i]) == 0);
+		p_uthread_unref (readers[i]);
+	}
+
+	/* Each writer keeps its even keys from the last round */
+	shared = p_atomic_int_get (&test_net_count);
+
+	P_TEST_CHECK (shared >= 0 && shared <= 100);
+	P_TEST_CHECK (p_skip_list_get_count (test_list) ==
+		      (psize) (PSKIPLIST_THREADS * PSKIPLIST_STRESS_COUNT / 2 + shared));
+
+	for (pint i = 1; i <= PSKIPLIST_THREADS; ++i)
+		for (pint j = 1; j <= PSKIPLIST_STRESS_COUNT; ++j)
+			P_TEST_CHECK (p_skip_list_lookup (test_list, PINT_TO_POINTER (i * PSKIPLIST_STRESS_COUNT + j)) ==
+				      (j % 2 == 0 ? PINT_TO_POINTER ((i * PSKIPLIST_STRESS_COUNT + j) * 2) : (ppointer) -1));
+
+	state[0] = -1000;
+	state[1] = 0;
+	state[2] = 0;
+	state[3] = -1;
+
+	p_skip_list_foreach (test_list, check_order_func, state);
+
+	P_TEST_CHECK (state[1] == (pint) p_skip_list_get_count (test_list));
+	P_TEST_CHECK (state[2] == 0);
+
+	p_skip_list_free (test_list);
+	test_list = NULL;
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pskiplist_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pskiplist_invalid_test);
+	P_TEST_SUITE_RUN_CASE (pskiplist_general_test);
+	P_TEST_SUITE_RUN_CASE (pskiplist_destroy_test);
+	P_TEST_SUITE_RUN_CASE (pskiplist_thread_test);
+}
+P_TEST_SUITE_END()
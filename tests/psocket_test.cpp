@@ -26,10 +26,22 @@
 #include "plibsys.h"
 #include "ptestmacros.h"
 
+#include <stdio.h>
 #include <string.h>
 
+#ifndef P_OS_WIN
+#  include <unistd.h>
+#endif
+
 P_TEST_MODULE_INIT ();
 
+#define PSOCKET_TEST_SEND_FILE "." P_DIR_SEPARATOR "psocket_test_send_file.bin"
+#define PSOCKET_TEST_ACCEPT_COUNT 5
+#define PSOCKET_TEST_DRAIN_COUNT 4096
+#define PSOCKET_TEST_UNIX_STREAM "psocket_test_unix_stream.sock"
+#define PSOCKET_TEST_UNIX_DGRAM1 "psocket_test_unix_dgram1.sock"
+#define PSOCKET_TEST_UNIX_DGRAM2 "psocket_test_unix_dgram2.sock"
+
 static pchar             socket_data[]       = "This is a socket test data!";
 volatile static pboolean is_sender_working   = FALSE;
 volatile static pboolean is_receiver_working = FALSE;
@@ -585,10 +597,46 @@ static void * tcp_socket_receiver_thread (void *arg)
 	return NULL;
 }
 
+/* Checks an option round trip, the option can be missing on the platform */
+static pboolean check_socket_option (PSocket *socket, PSocketOption option, pint value, pint expected)
+{
+	PError	*error = NULL;
+	pint	result = -1;
+
+	if (p_socket_set_option (socket, option, value, &error) == FALSE) {
+		pboolean ret = p_error_get_code (error) == (pint) P_ERROR_IO_NOT_SUPPORTED;
+
+		p_error_free (error);
+		return ret;
+	}
+
+	if (p_socket_get_option (socket, option, &result, NULL) == FALSE)
+		return FALSE;
+
+	return result == expected;
+}
+
 P_TEST_CASE_BEGIN (psocket_nomem_test)
 {
 	p_libsys_init ();
 
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	/* The object pools can't be created yet */
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (p_socket_new (P_SOCKET_FAMILY_INET,
+				   P_SOCKET_TYPE_DATAGRAM,
+				   P_SOCKET_PROTOCOL_UDP,
+				   NULL) == NULL);
+	P_TEST_CHECK (p_socket_address_new ("127.0.0.1", 32211) == NULL);
+
+	p_mem_restore_vtable ();
+
 	PSocket *socket = p_socket_new (P_SOCKET_FAMILY_INET,
 					P_SOCKET_TYPE_DATAGRAM,
 					P_SOCKET_PROTOCOL_UDP,
@@ -609,24 +657,68 @@ P_TEST_CASE_BEGIN (psocket_nomem_test)
 
 	p_socket_address_free (sock_addr);
 
-	PMemVTable vtable;
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
 
-	vtable.free    = pmem_free;
-	vtable.malloc  = pmem_alloc;
-	vtable.realloc = pmem_realloc;
+	/* Released objects are recycled without the heap */
+	PSocket *recycled = p_socket_new (P_SOCKET_FAMILY_INET,
+					  P_SOCKET_TYPE_DATAGRAM,
+					  P_SOCKET_PROTOCOL_UDP,
+					  NULL);
+	P_TEST_CHECK (recycled != NULL);
 
-	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+	PSocketAddress *local_addr  = p_socket_get_local_address (socket, NULL);
+	PSocketAddress *remote_addr = p_socket_get_remote_address (socket, NULL);
+
+	P_TEST_CHECK (local_addr != NULL);
+	P_TEST_CHECK (remote_addr != NULL);
+	P_TEST_CHECK (p_socket_set_stats_enabled (socket, TRUE, NULL) == FALSE);
+
+	p_socket_address_free (local_addr);
+	p_socket_address_free (remote_addr);
+	p_socket_free (recycled);
+
+	/* Allocations fail once the pools run out of recycled objects */
+	PSocket		*drained_sockets[PSOCKET_TEST_DRAIN_COUNT];
+	PSocketAddress	*drained_addrs[PSOCKET_TEST_DRAIN_COUNT];
+	pint		sockets_count = 0;
+	pint		addrs_count   = 0;
+
+	while (sockets_count < PSOCKET_TEST_DRAIN_COUNT) {
+		drained_sockets[sockets_count] = p_socket_new (P_SOCKET_FAMILY_INET,
+							       P_SOCKET_TYPE_DATAGRAM,
+							       P_SOCKET_PROTOCOL_UDP,
+							       NULL);
+
+		if (drained_sockets[sockets_count] == NULL)
+			break;
+
+		++sockets_count;
+	}
+
+	while (addrs_count < PSOCKET_TEST_DRAIN_COUNT) {
+		drained_addrs[addrs_count] = p_socket_address_new ("127.0.0.1", 32211);
+
+		if (drained_addrs[addrs_count] == NULL)
+			break;
+
+		++addrs_count;
+	}
+
+	P_TEST_CHECK (sockets_count < PSOCKET_TEST_DRAIN_COUNT);
+	P_TEST_CHECK (addrs_count < PSOCKET_TEST_DRAIN_COUNT);
 
-	P_TEST_CHECK (p_socket_new (P_SOCKET_FAMILY_INET,
-				   P_SOCKET_TYPE_DATAGRAM,
-				   P_SOCKET_PROTOCOL_UDP,
-				   NULL) == NULL);
 	P_TEST_CHECK (p_socket_new_from_fd (p_socket_get_fd (socket), NULL) == NULL);
 	P_TEST_CHECK (p_socket_get_local_address (socket, NULL) == NULL);
 	P_TEST_CHECK (p_socket_get_remote_address (socket, NULL) == NULL);
 
 	p_mem_restore_vtable ();
 
+	for (pint i = 0; i < sockets_count; ++i)
+		p_socket_free (drained_sockets[i]);
+
+	for (pint i = 0; i < addrs_count; ++i)
+		p_socket_address_free (drained_addrs[i]);
+
 	p_socket_close (socket, NULL);
 	p_socket_free (socket);
 
@@ -742,6 +834,14 @@ P_TEST_CASE_BEGIN (psocket_bad_input_test)
 	P_TEST_CHECK (error != NULL);
 	clean_error (&error);
 
+	P_TEST_CHECK (p_socket_set_option (NULL, P_SOCKET_OPTION_TCP_NODELAY, 1, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	clean_error (&error);
+
+	P_TEST_CHECK (p_socket_get_option (NULL, P_SOCKET_OPTION_TCP_NODELAY, NULL, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	clean_error (&error);
+
 	p_socket_free (NULL);
 
 	p_libsys_shutdown ();
@@ -983,6 +1083,1391 @@ P_TEST_CASE_BEGIN (psocket_general_tcp_test)
 }
 P_TEST_CASE_END ()
 
+P_TEST_CASE_BEGIN (psocket_vector_test)
+{
+	p_libsys_init ();
+
+	PSocketVector	vectors[3];
+	pchar		sock_buf[10];
+	pchar		head_buf[4];
+	pchar		body_buf[16];
+
+	vectors[0].buffer = sock_buf;
+	vectors[0].buflen = sizeof (sock_buf);
+
+	P_TEST_CHECK (p_socket_send_vector (NULL, vectors, 1, NULL) == -1);
+	P_TEST_CHECK (p_socket_send_vector_to (NULL, NULL, vectors, 1, NULL) == -1);
+	P_TEST_CHECK (p_socket_receive_vector (NULL, vectors, 1, NULL) == -1);
+	P_TEST_CHECK (p_socket_receive_vector_from (NULL, NULL, vectors, 1, NULL) == -1);
+
+	PSocket *receiver = p_socket_new (P_SOCKET_FAMILY_INET,
+					  P_SOCKET_TYPE_DATAGRAM,
+					  P_SOCKET_PROTOCOL_UDP,
+					  NULL);
+	PSocket *sender   = p_socket_new (P_SOCKET_FAMILY_INET,
+					  P_SOCKET_TYPE_DATAGRAM,
+					  P_SOCKET_PROTOCOL_UDP,
+					  NULL);
+
+	P_TEST_REQUIRE (receiver != NULL);
+	P_TEST_REQUIRE (sender != NULL);
+
+	PSocketAddress *addr = p_socket_address_new ("127.0.0.1", 0);
+	P_TEST_REQUIRE (addr != NULL);
+
+	P_TEST_CHECK (p_socket_bind (receiver, addr, FALSE, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_bind (sender, addr, FALSE, NULL) == TRUE);
+	p_socket_address_free (addr);
+
+	PSocketAddress *recv_addr = p_socket_get_local_address (receiver, NULL);
+	PSocketAddress *send_addr = p_socket_get_local_address (sender, NULL);
+
+	P_TEST_REQUIRE (recv_addr != NULL);
+	P_TEST_REQUIRE (send_addr != NULL);
+
+	p_socket_set_timeout (receiver, 2000);
+
+	/* Invalid descriptors */
+	P_TEST_CHECK (p_socket_send_vector_to (sender, NULL, vectors, 1, NULL) == -1);
+	P_TEST_CHECK (p_socket_send_vector_to (sender, recv_addr, NULL, 1, NULL) == -1);
+	P_TEST_CHECK (p_socket_send_vector_to (sender, recv_addr, vectors, 0, NULL) == -1);
+
+	vectors[0].buffer = NULL;
+	P_TEST_CHECK (p_socket_send_vector_to (sender, recv_addr, vectors, 1, NULL) == -1);
+
+	vectors[0].buflen = 0;
+	P_TEST_CHECK (p_socket_send_vector_to (sender, recv_addr, vectors, 1, NULL) == -1);
+	P_TEST_CHECK (p_socket_receive_vector (receiver, vectors, 1, NULL) == -1);
+
+	/* Gather three pieces (one is empty) into a single datagram */
+	vectors[0].buffer = (pchar *) "head";
+	vectors[0].buflen = 4;
+	vectors[1].buffer = NULL;
+	vectors[1].buflen = 0;
+	vectors[2].buffer = (pchar *) "payload";
+	vectors[2].buflen = 7;
+
+	P_TEST_CHECK (p_socket_send_vector_to (sender, recv_addr, vectors, 3, NULL) == 11);
+
+	/* Scatter it into a header and a body buffers */
+	memset (head_buf, 0, sizeof (head_buf));
+	memset (body_buf, 0, sizeof (body_buf));
+
+	vectors[0].buffer = head_buf;
+	vectors[0].buflen = sizeof (head_buf);
+	vectors[1].buffer = body_buf;
+	vectors[1].buflen = sizeof (body_buf);
+
+	PSocketAddress *remote_addr = NULL;
+
+	P_TEST_CHECK (p_socket_receive_vector_from (receiver, &remote_addr, vectors, 2, NULL) == 11);
+	P_TEST_CHECK (memcmp (head_buf, "head", 4) == 0);
+	P_TEST_CHECK (memcmp (body_buf, "payload", 7) == 0);
+	P_TEST_CHECK (body_buf[7] == 0);
+
+	P_TEST_REQUIRE (remote_addr != NULL);
+	P_TEST_CHECK (compare_socket_addresses (remote_addr, send_addr) == TRUE);
+	p_socket_address_free (remote_addr);
+
+	/* Connected variants */
+	P_TEST_CHECK (p_socket_connect (sender, recv_addr, NULL) == TRUE);
+
+	vectors[0].buffer = (pchar *) "ab";
+	vectors[0].buflen = 2;
+	vectors[1].buffer = (pchar *) "cd";
+	vectors[1].buflen = 2;
+
+	P_TEST_CHECK (p_socket_send_vector (sender, vectors, 2, NULL) == 4);
+
+	memset (sock_buf, 0, sizeof (sock_buf));
+
+	vectors[0].buffer = sock_buf;
+	vectors[0].buflen = 1;
+	vectors[1].buffer = sock_buf + 1;
+	vectors[1].buflen = sizeof (sock_buf) - 1;
+
+	P_TEST_CHECK (p_socket_receive_vector (receiver, vectors, 2, NULL) == 4);
+	P_TEST_CHECK (memcmp (sock_buf, "abcd", 4) == 0);
+
+	P_TEST_CHECK (p_socket_close (receiver, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_receive_vector (receiver, vectors, 2, NULL) == -1);
+
+	p_socket_address_free (recv_addr);
+	p_socket_address_free (send_addr);
+	p_socket_free (receiver);
+	p_socket_free (sender);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (psocket_many_test)
+{
+	p_libsys_init ();
+
+	PSocketMessage	messages[8];
+	pchar		recv_bufs[8][16];
+	pchar		send_bufs[5][16];
+	pint		i;
+
+	memset (messages, 0, sizeof (messages));
+
+	P_TEST_CHECK (p_socket_send_many (NULL, messages, 1, NULL) == -1);
+	P_TEST_CHECK (p_socket_receive_many (NULL, messages, 1, NULL) == -1);
+
+	PSocket *receiver = p_socket_new (P_SOCKET_FAMILY_INET,
+					  P_SOCKET_TYPE_DATAGRAM,
+					  P_SOCKET_PROTOCOL_UDP,
+					  NULL);
+	PSocket *sender   = p_socket_new (P_SOCKET_FAMILY_INET,
+					  P_SOCKET_TYPE_DATAGRAM,
+					  P_SOCKET_PROTOCOL_UDP,
+					  NULL);
+
+	P_TEST_REQUIRE (receiver != NULL);
+	P_TEST_REQUIRE (sender != NULL);
+
+	PSocketAddress *addr = p_socket_address_new ("127.0.0.1", 0);
+	P_TEST_REQUIRE (addr != NULL);
+
+	P_TEST_CHECK (p_socket_bind (receiver, addr, FALSE, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_bind (sender, addr, FALSE, NULL) == TRUE);
+	p_socket_address_free (addr);
+
+	PSocketAddress *recv_addr = p_socket_get_local_address (receiver, NULL);
+	PSocketAddress *send_addr = p_socket_get_local_address (sender, NULL);
+
+	P_TEST_REQUIRE (recv_addr != NULL);
+	P_TEST_REQUIRE (send_addr != NULL);
+
+	p_socket_set_timeout (receiver, 2000);
+
+	/* Invalid descriptors */
+	P_TEST_CHECK (p_socket_send_many (sender, NULL, 1, NULL) == -1);
+	P_TEST_CHECK (p_socket_send_many (sender, messages, 0, NULL) == -1);
+	P_TEST_CHECK (p_socket_send_many (sender, messages, 1, NULL) == -1);
+	P_TEST_CHECK (p_socket_receive_many (receiver, messages, 1, NULL) == -1);
+
+	for (i = 0; i < 5; ++i) {
+		memset (send_bufs[i], 'a' + i, sizeof (send_bufs[i]));
+
+		messages[i].address = recv_addr;
+		messages[i].buffer  = send_bufs[i];
+		messages[i].buflen  = (psize) (i + 1);
+	}
+
+	P_TEST_CHECK (p_socket_send_many (sender, messages, 5, NULL) == 5);
+
+	for (i = 0; i < 5; ++i)
+		P_TEST_CHECK (messages[i].length == (psize) (i + 1));
+
+	for (i = 0; i < 8; ++i) {
+		messages[i].address = NULL;
+		messages[i].buffer  = recv_bufs[i];
+		messages[i].buflen  = sizeof (recv_bufs[i]);
+		messages[i].length  = 0;
+	}
+
+	pint	total = 0;
+	pssize	ret;
+
+	while (total < 5 && (ret = p_socket_receive_many (receiver,
+							  messages + total,
+							  (psize) (8 - total),
+							  NULL)) > 0)
+		total += (pint) ret;
+
+	P_TEST_CHECK (total == 5);
+
+	for (i = 0; i < total; ++i) {
+		P_TEST_CHECK (messages[i].length == (psize) (i + 1));
+		P_TEST_CHECK (recv_bufs[i][0] == 'a' + i);
+		P_TEST_CHECK (recv_bufs[i][i] == 'a' + i);
+
+		P_TEST_REQUIRE (messages[i].address != NULL);
+		P_TEST_CHECK (compare_socket_addresses (messages[i].address, send_addr) == TRUE);
+		p_socket_address_free (messages[i].address);
+	}
+
+	P_TEST_CHECK (messages[5].address == NULL);
+	P_TEST_CHECK (messages[5].length == 0);
+
+	/* Connected socket doesn't require an address */
+	P_TEST_CHECK (p_socket_connect (sender, recv_addr, NULL) == TRUE);
+
+	messages[0].address = NULL;
+	messages[0].buffer  = send_bufs[0];
+	messages[0].buflen  = 3;
+
+	P_TEST_CHECK (p_socket_send_many (sender, messages, 1, NULL) == 1);
+
+	messages[0].buffer = recv_bufs[0];
+	messages[0].buflen = sizeof (recv_bufs[0]);
+
+	P_TEST_CHECK (p_socket_receive_many (receiver, messages, 1, NULL) == 1);
+	P_TEST_CHECK (messages[0].length == 3);
+	P_TEST_CHECK (messages[0].address != NULL);
+	p_socket_address_free (messages[0].address);
+
+	/* Non-blocking socket without pending datagrams */
+	p_socket_set_blocking (receiver, FALSE);
+	P_TEST_CHECK (p_socket_receive_many (receiver, messages, 1, NULL) == -1);
+
+	P_TEST_CHECK (p_socket_close (receiver, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_receive_many (receiver, messages, 1, NULL) == -1);
+
+	p_socket_address_free (recv_addr);
+	p_socket_address_free (send_addr);
+	p_socket_free (receiver);
+	p_socket_free (sender);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (psocket_segmented_test)
+{
+	p_libsys_init ();
+
+	static pchar	send_buf[10 * 100 + 50];
+	static pchar	recv_buf[P_SOCKET_MAX_SEGMENT_SIZE];
+	static pchar	joined_buf[sizeof (send_buf)];
+	psize		segment_size;
+	psize		received;
+	psize		i;
+	pssize		ret;
+	pint		value;
+
+	for (i = 0; i < sizeof (send_buf); ++i)
+		send_buf[i] = (pchar) (i / 100 + i % 7);
+
+	P_TEST_CHECK (p_socket_send_segmented (NULL, NULL, send_buf, sizeof (send_buf), 100, NULL) == -1);
+	P_TEST_CHECK (p_socket_receive_segmented (NULL, NULL, recv_buf, sizeof (recv_buf), &segment_size, NULL) == -1);
+
+	PSocket *receiver = p_socket_new (P_SOCKET_FAMILY_INET,
+					  P_SOCKET_TYPE_DATAGRAM,
+					  P_SOCKET_PROTOCOL_UDP,
+					  NULL);
+	PSocket *sender   = p_socket_new (P_SOCKET_FAMILY_INET,
+					  P_SOCKET_TYPE_DATAGRAM,
+					  P_SOCKET_PROTOCOL_UDP,
+					  NULL);
+
+	P_TEST_REQUIRE (receiver != NULL);
+	P_TEST_REQUIRE (sender != NULL);
+
+	P_TEST_CHECK (p_socket_send_segmented (sender, NULL, NULL, 1, 100, NULL) == -1);
+	P_TEST_CHECK (p_socket_send_segmented (sender, NULL, send_buf, 0, 100, NULL) == -1);
+	P_TEST_CHECK (p_socket_send_segmented (sender, NULL, send_buf, 1, 0, NULL) == -1);
+	P_TEST_CHECK (p_socket_send_segmented (sender, NULL, send_buf, 1, P_SOCKET_MAX_SEGMENT_SIZE + 1, NULL) == -1);
+	P_TEST_CHECK (p_socket_receive_segmented (receiver, NULL, NULL, 1, &segment_size, NULL) == -1);
+	P_TEST_CHECK (p_socket_receive_segmented (receiver, NULL, recv_buf, 0, &segment_size, NULL) == -1);
+	P_TEST_CHECK (p_socket_receive_segmented (receiver, NULL, recv_buf, 1, NULL, NULL) == -1);
+
+	PSocketAddress *addr = p_socket_address_new ("127.0.0.1", 0);
+	P_TEST_REQUIRE (addr != NULL);
+
+	P_TEST_CHECK (p_socket_bind (receiver, addr, FALSE, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_bind (sender, addr, FALSE, NULL) == TRUE);
+	p_socket_address_free (addr);
+
+	/* Receiving works the same without the offload */
+	if (p_socket_set_option (receiver, P_SOCKET_OPTION_UDP_GRO, 1, NULL) == TRUE) {
+		P_TEST_CHECK (p_socket_get_option (receiver, P_SOCKET_OPTION_UDP_GRO, &value, NULL) == TRUE);
+		P_TEST_CHECK (value == 1);
+	}
+
+	PSocketAddress *recv_addr = p_socket_get_local_address (receiver, NULL);
+	PSocketAddress *send_addr = p_socket_get_local_address (sender, NULL);
+
+	P_TEST_REQUIRE (recv_addr != NULL);
+	P_TEST_REQUIRE (send_addr != NULL);
+
+	P_TEST_CHECK (p_socket_send_segmented (sender,
+					       recv_addr,
+					       send_buf,
+					       sizeof (send_buf),
+					       100,
+					       NULL) == (pssize) sizeof (send_buf));
+
+	p_socket_set_timeout (receiver, 2000);
+
+	for (received = 0; received < sizeof (send_buf); received += (psize) ret) {
+		addr = NULL;
+		ret  = p_socket_receive_segmented (receiver, &addr, recv_buf, sizeof (recv_buf), &segment_size, NULL);
+
+		P_TEST_REQUIRE (ret > 0);
+		P_TEST_REQUIRE (received + (psize) ret <= sizeof (send_buf));
+		P_TEST_REQUIRE (addr != NULL);
+		P_TEST_CHECK (p_socket_address_equal (addr, send_addr) == TRUE);
+		p_socket_address_free (addr);
+
+		/* Datagram boundaries are kept */
+		P_TEST_CHECK (received % 100 == 0);
+		P_TEST_CHECK (segment_size == 100 || (segment_size == 50 && ret == 50));
+
+		memcpy (joined_buf + received, recv_buf, (psize) ret);
+	}
+
+	P_TEST_CHECK (memcmp (joined_buf, send_buf, sizeof (send_buf)) == 0);
+
+	/* Connected socket and a single datagram */
+	P_TEST_CHECK (p_socket_connect (sender, recv_addr, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_send_segmented (sender, NULL, send_buf, 30, 100, NULL) == 30);
+	P_TEST_CHECK (p_socket_receive_segmented (receiver, NULL, recv_buf, sizeof (recv_buf), &segment_size, NULL) == 30);
+	P_TEST_CHECK (segment_size == 30);
+	P_TEST_CHECK (memcmp (recv_buf, send_buf, 30) == 0);
+
+	p_socket_address_free (send_addr);
+	p_socket_address_free (recv_addr);
+	p_socket_free (receiver);
+	p_socket_free (sender);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (psocket_timestamp_test)
+{
+	p_libsys_init ();
+
+	PSocketTimestamps	timestamps;
+	PError			*error = NULL;
+	pchar			recv_buf[64];
+	puint64			before;
+	pint			i;
+
+	PSocket *receiver = p_socket_new (P_SOCKET_FAMILY_INET,
+					  P_SOCKET_TYPE_DATAGRAM,
+					  P_SOCKET_PROTOCOL_UDP,
+					  NULL);
+	PSocket *sender   = p_socket_new (P_SOCKET_FAMILY_INET,
+					  P_SOCKET_TYPE_DATAGRAM,
+					  P_SOCKET_PROTOCOL_UDP,
+					  NULL);
+
+	P_TEST_REQUIRE (receiver != NULL);
+	P_TEST_REQUIRE (sender != NULL);
+
+	P_TEST_CHECK (p_socket_set_timestamping (NULL, 0, NULL) == FALSE);
+	P_TEST_CHECK (p_socket_set_timestamping (receiver, 0x100, NULL) == FALSE);
+	P_TEST_CHECK (p_socket_set_timestamping (receiver, 0, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_receive_from_timestamped (NULL, NULL, recv_buf, sizeof (recv_buf), &timestamps, NULL) == -1);
+	P_TEST_CHECK (p_socket_receive_from_timestamped (receiver, NULL, NULL, 1, &timestamps, NULL) == -1);
+	P_TEST_CHECK (p_socket_receive_from_timestamped (receiver, NULL, recv_buf, 0, &timestamps, NULL) == -1);
+	P_TEST_CHECK (p_socket_receive_from_timestamped (receiver, NULL, recv_buf, 1, NULL, NULL) == -1);
+	P_TEST_CHECK (p_socket_get_tx_timestamp (NULL, &timestamps, NULL) == FALSE);
+	P_TEST_CHECK (p_socket_get_tx_timestamp (sender, NULL, NULL) == FALSE);
+
+	PSocketAddress *addr = p_socket_address_new ("127.0.0.1", 0);
+	P_TEST_REQUIRE (addr != NULL);
+
+	P_TEST_CHECK (p_socket_bind (receiver, addr, FALSE, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_bind (sender, addr, FALSE, NULL) == TRUE);
+	p_socket_address_free (addr);
+
+	PSocketAddress *recv_addr = p_socket_get_local_address (receiver, NULL);
+	PSocketAddress *send_addr = p_socket_get_local_address (sender, NULL);
+
+	P_TEST_REQUIRE (recv_addr != NULL);
+	P_TEST_REQUIRE (send_addr != NULL);
+
+	p_socket_set_timeout (receiver, 2000);
+
+	/* Without timestamps enabled the data is still received */
+	P_TEST_CHECK (p_socket_send_to (sender, recv_addr, socket_data, 5, NULL) == 5);
+
+	addr   = NULL;
+	before = p_time_profiler_ticks ();
+
+	P_TEST_CHECK (p_socket_receive_from_timestamped (receiver, &addr, recv_buf, sizeof (recv_buf), &timestamps, NULL) == 5);
+	P_TEST_CHECK (memcmp (recv_buf, socket_data, 5) == 0);
+	P_TEST_REQUIRE (addr != NULL);
+	P_TEST_CHECK (p_socket_address_equal (addr, send_addr) == TRUE);
+	P_TEST_CHECK (timestamps.software == 0);
+	P_TEST_CHECK (timestamps.hardware == 0);
+	P_TEST_CHECK (timestamps.age == 0);
+	P_TEST_CHECK (timestamps.ticks >= before);
+	p_socket_address_free (addr);
+
+	if (p_socket_set_timestamping (receiver, P_SOCKET_TIMESTAMP_RX_SOFTWARE, &error) == TRUE) {
+		P_TEST_CHECK (p_socket_send_to (sender, recv_addr, socket_data, 10, NULL) == 10);
+		P_TEST_CHECK (p_socket_receive_from_timestamped (receiver, NULL, recv_buf, sizeof (recv_buf), &timestamps, NULL) == 10);
+		P_TEST_CHECK (memcmp (recv_buf, socket_data, 10) == 0);
+
+		/* Loopback has no hardware timestamps, the age is below a minute */
+		P_TEST_CHECK (timestamps.software != 0);
+		P_TEST_CHECK (timestamps.hardware == 0);
+		P_TEST_CHECK (timestamps.age < (puint64) 60 * 1000000000);
+
+		P_TEST_CHECK (p_socket_set_timestamping (receiver, 0, NULL) == TRUE);
+	} else {
+		P_TEST_CHECK (error != NULL);
+		P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_NOT_SUPPORTED);
+		clean_error (&error);
+	}
+
+	/* Transmit timestamps arrive through the error queue */
+	if (p_socket_set_timestamping (sender, P_SOCKET_TIMESTAMP_TX_SOFTWARE, &error) == TRUE) {
+		P_TEST_CHECK (p_socket_get_tx_timestamp (sender, &timestamps, &error) == FALSE);
+		P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_WOULD_BLOCK);
+		clean_error (&error);
+
+		for (i = 0; i < 2; ++i)
+			P_TEST_CHECK (p_socket_send_to (sender, recv_addr, socket_data, 5, NULL) == 5);
+
+		for (i = 0; i < 2; ++i) {
+			pint attempts;
+
+			for (attempts = 0; attempts < 1000; ++attempts) {
+				if (p_socket_get_tx_timestamp (sender, &timestamps, NULL) == TRUE)
+					break;
+
+				p_uthread_sleep (1);
+			}
+
+			P_TEST_REQUIRE (attempts < 1000);
+			P_TEST_CHECK (timestamps.software != 0);
+			P_TEST_CHECK (timestamps.id == (puint32) i);
+		}
+
+		P_TEST_CHECK (p_socket_set_timestamping (sender, 0, NULL) == TRUE);
+	} else {
+		P_TEST_CHECK (error != NULL);
+		P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_NOT_SUPPORTED);
+		clean_error (&error);
+
+		P_TEST_CHECK (p_socket_get_tx_timestamp (sender, &timestamps, NULL) == FALSE);
+	}
+
+	p_socket_address_free (send_addr);
+	p_socket_address_free (recv_addr);
+	p_socket_free (receiver);
+	p_socket_free (sender);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (psocket_send_file_test)
+{
+	p_libsys_init ();
+
+	pchar	file_data[32 * 1024];
+	pchar	recv_buf[32 * 1024];
+	psize	i;
+
+	for (i = 0; i < sizeof (file_data); ++i)
+		file_data[i] = (pchar) (i % 251);
+
+	FILE *file = fopen (PSOCKET_TEST_SEND_FILE, "wb");
+	P_TEST_REQUIRE (file != NULL);
+	P_TEST_REQUIRE (fwrite (file_data, 1, sizeof (file_data), file) == sizeof (file_data));
+	P_TEST_REQUIRE (fclose (file) == 0);
+
+	PSocket *server = p_socket_new (P_SOCKET_FAMILY_INET,
+					P_SOCKET_TYPE_STREAM,
+					P_SOCKET_PROTOCOL_TCP,
+					NULL);
+	PSocket *client = p_socket_new (P_SOCKET_FAMILY_INET,
+					P_SOCKET_TYPE_STREAM,
+					P_SOCKET_PROTOCOL_TCP,
+					NULL);
+
+	P_TEST_REQUIRE (server != NULL);
+	P_TEST_REQUIRE (client != NULL);
+
+	PSocketAddress *addr = p_socket_address_new ("127.0.0.1", 0);
+	P_TEST_REQUIRE (addr != NULL);
+
+	P_TEST_CHECK (p_socket_bind (server, addr, FALSE, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_listen (server, NULL) == TRUE);
+	p_socket_address_free (addr);
+
+	addr = p_socket_get_local_address (server, NULL);
+	P_TEST_REQUIRE (addr != NULL);
+
+	P_TEST_CHECK (p_socket_connect (client, addr, NULL) == TRUE);
+	p_socket_address_free (addr);
+
+	PSocket *peer = p_socket_accept (server, NULL);
+	P_TEST_REQUIRE (peer != NULL);
+
+	p_socket_set_timeout (client, 2000);
+
+	P_TEST_CHECK (p_socket_send_file (NULL, PSOCKET_TEST_SEND_FILE, 0, 0, NULL) == -1);
+	P_TEST_CHECK (p_socket_send_file (peer, NULL, 0, 0, NULL) == -1);
+	P_TEST_CHECK (p_socket_send_file (peer, "." P_DIR_SEPARATOR "psocket_no_such_file", 0, 0, NULL) == -1);
+	P_TEST_CHECK (p_socket_send_file (peer,
+					  PSOCKET_TEST_SEND_FILE,
+					  sizeof (file_data) + 1,
+					  0,
+					  NULL) == -1);
+	P_TEST_CHECK (p_socket_send_file (peer, PSOCKET_TEST_SEND_FILE, sizeof (file_data), 0, NULL) == 0);
+
+	/* Whole file */
+	P_TEST_CHECK (p_socket_send_file (peer,
+					  PSOCKET_TEST_SEND_FILE,
+					  0,
+					  0,
+					  NULL) == (pssize) sizeof (file_data));
+
+	psize	total = 0;
+	pssize	ret;
+
+	while (total < sizeof (file_data) &&
+	       (ret = p_socket_receive (client, recv_buf + total, sizeof (recv_buf) - total, NULL)) > 0)
+		total += (psize) ret;
+
+	P_TEST_CHECK (total == sizeof (file_data));
+	P_TEST_CHECK (memcmp (recv_buf, file_data, sizeof (file_data)) == 0);
+
+	/* Range which is clamped at the end of the file */
+	P_TEST_CHECK (p_socket_send_file (peer,
+					  PSOCKET_TEST_SEND_FILE,
+					  sizeof (file_data) - 100,
+					  1000,
+					  NULL) == 100);
+
+	for (total = 0; total < 100 &&
+	     (ret = p_socket_receive (client, recv_buf + total, 100 - total, NULL)) > 0; )
+		total += (psize) ret;
+
+	P_TEST_CHECK (total == 100);
+	P_TEST_CHECK (memcmp (recv_buf, file_data + sizeof (file_data) - 100, 100) == 0);
+
+	P_TEST_CHECK (p_socket_close (peer, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_send_file (peer, PSOCKET_TEST_SEND_FILE, 0, 0, NULL) == -1);
+
+	p_socket_free (peer);
+	p_socket_free (client);
+	p_socket_free (server);
+
+	P_TEST_CHECK (p_file_remove (PSOCKET_TEST_SEND_FILE, NULL) == TRUE);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (psocket_unix_test)
+{
+	pchar		buf[64];
+	pint		fds[2];
+	psize		n_fds;
+	pchar		*str;
+	PSocket		*server;
+	PSocket		*client;
+	PSocket		*accepted;
+	PSocket		*sock;
+	PSocketAddress	*addr;
+	PSocketAddress	*addr2;
+#ifndef P_OS_WIN
+	PShm		*shm;
+	PShm		*shm2;
+#endif
+	PError		*error = NULL;
+
+	p_libsys_init ();
+
+	if (p_socket_address_is_unix_supported () == FALSE) {
+		p_libsys_shutdown ();
+		P_TEST_CASE_RETURN ();
+	}
+
+	p_file_remove (PSOCKET_TEST_UNIX_STREAM, NULL);
+	p_file_remove (PSOCKET_TEST_UNIX_DGRAM1, NULL);
+	p_file_remove (PSOCKET_TEST_UNIX_DGRAM2, NULL);
+
+	/* Stream sockets */
+	server = p_socket_new (P_SOCKET_FAMILY_UNIX, P_SOCKET_TYPE_STREAM, P_SOCKET_PROTOCOL_DEFAULT, NULL);
+	client = p_socket_new (P_SOCKET_FAMILY_UNIX, P_SOCKET_TYPE_STREAM, P_SOCKET_PROTOCOL_DEFAULT, NULL);
+	P_TEST_REQUIRE (server != NULL);
+	P_TEST_REQUIRE (client != NULL);
+
+	addr = p_socket_address_new_unix (PSOCKET_TEST_UNIX_STREAM);
+	P_TEST_REQUIRE (addr != NULL);
+
+	P_TEST_CHECK (p_socket_bind (server, addr, FALSE, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_listen (server, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_connect (client, addr, NULL) == TRUE);
+
+	addr2 = p_socket_get_local_address (server, NULL);
+	P_TEST_REQUIRE (addr2 != NULL);
+	P_TEST_CHECK (p_socket_address_equal (addr, addr2) == TRUE);
+	p_socket_address_free (addr2);
+	p_socket_address_free (addr);
+
+	accepted = p_socket_accept (server, NULL);
+	P_TEST_REQUIRE (accepted != NULL);
+	P_TEST_CHECK (p_socket_get_family (accepted) == P_SOCKET_FAMILY_UNIX);
+	P_TEST_CHECK (p_socket_is_connected (client) == TRUE);
+
+	/* The client is not bound, so it has no name */
+	addr = p_socket_get_remote_address (accepted, NULL);
+	P_TEST_REQUIRE (addr != NULL);
+	P_TEST_CHECK (p_socket_address_get_family (addr) == P_SOCKET_FAMILY_UNIX);
+	str = p_socket_address_get_address (addr);
+	P_TEST_REQUIRE (str != NULL);
+	P_TEST_CHECK (str[0] == '\0');
+	p_free (str);
+	p_socket_address_free (addr);
+
+	P_TEST_CHECK (p_socket_send (client, socket_data, sizeof (socket_data), NULL) == sizeof (socket_data));
+	P_TEST_CHECK (p_socket_receive (accepted, buf, sizeof (buf), NULL) == sizeof (socket_data));
+	P_TEST_CHECK (strcmp (buf, socket_data) == 0);
+
+	/* Passing descriptors */
+	n_fds = 2;
+
+	P_TEST_CHECK (p_socket_send_fds (client, NULL, 1, fds, 1, NULL) == -1);
+	P_TEST_CHECK (p_socket_send_fds (client, buf, 0, fds, 1, NULL) == -1);
+	P_TEST_CHECK (p_socket_send_fds (client, buf, 1, NULL, 1, NULL) == -1);
+	P_TEST_CHECK (p_socket_send_fds (client, buf, 1, fds, 0, NULL) == -1);
+	P_TEST_CHECK (p_socket_send_fds (client, buf, 1, fds, P_SOCKET_MAX_FDS + 1, NULL) == -1);
+	P_TEST_CHECK (p_socket_receive_fds (accepted, NULL, 1, fds, &n_fds, NULL) == -1);
+	P_TEST_CHECK (p_socket_receive_fds (accepted, buf, 1, NULL, &n_fds, NULL) == -1);
+	P_TEST_CHECK (p_socket_receive_fds (accepted, buf, 1, fds, NULL, NULL) == -1);
+
+#ifdef P_OS_WIN
+	fds[0] = (pint) p_socket_get_fd (client);
+
+	P_TEST_CHECK (p_socket_send_fds (client, buf, 1, fds, 1, &error) == -1);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_NOT_SUPPORTED);
+	clean_error (&error);
+#else
+	shm = p_shm_new_anonymous (64, P_SHM_ACCESS_READWRITE, NULL);
+	P_TEST_REQUIRE (shm != NULL);
+	strcpy ((pchar *) p_shm_get_address (shm), "Shared data");
+
+	fds[0] = p_shm_get_handle (shm);
+	fds[1] = p_socket_get_fd (client);
+
+	P_TEST_CHECK (p_socket_send_fds (client, "ab", 2, fds, 2, &error) == 2);
+	P_TEST_CHECK (error == NULL);
+
+	fds[0] = -1;
+	fds[1] = -1;
+	n_fds  = 2;
+
+	P_TEST_CHECK (p_socket_receive_fds (accepted, buf, sizeof (buf), fds, &n_fds, &error) == 2);
+	P_TEST_CHECK (error == NULL);
+	P_TEST_CHECK (memcmp (buf, "ab", 2) == 0);
+	P_TEST_REQUIRE (n_fds == 2);
+	P_TEST_CHECK (fds[0] >= 0 && fds[0] != p_shm_get_handle (shm));
+	P_TEST_CHECK (fds[1] >= 0 && fds[1] != p_socket_get_fd (client));
+
+	shm2 = p_shm_new_from_handle (fds[0], P_SHM_ACCESS_READWRITE, NULL);
+	P_TEST_REQUIRE (shm2 != NULL);
+	P_TEST_CHECK (strcmp ((const pchar *) p_shm_get_address (shm2), "Shared data") == 0);
+	p_shm_free (shm2);
+	P_TEST_CHECK (close (fds[0]) == 0);
+
+	/* A duplicate of the client connection */
+	sock = p_socket_new_from_fd (fds[1], NULL);
+	P_TEST_REQUIRE (sock != NULL);
+	P_TEST_CHECK (p_socket_get_family (sock) == P_SOCKET_FAMILY_UNIX);
+	P_TEST_CHECK (p_socket_get_type (sock) == P_SOCKET_TYPE_STREAM);
+	P_TEST_CHECK (p_socket_is_connected (sock) == TRUE);
+	P_TEST_CHECK (p_socket_send (sock, "c", 1, NULL) == 1);
+	P_TEST_CHECK (p_socket_receive (accepted, buf, sizeof (buf), NULL) == 1);
+	P_TEST_CHECK (buf[0] == 'c');
+	p_socket_free (sock);
+
+	/* Descriptors above the capacity are closed */
+	fds[0] = p_shm_get_handle (shm);
+	fds[1] = p_shm_get_handle (shm);
+
+	P_TEST_CHECK (p_socket_send_fds (client, "d", 1, fds, 2, NULL) == 1);
+
+	fds[0] = -1;
+	fds[1] = -1;
+	n_fds  = 1;
+
+	P_TEST_CHECK (p_socket_receive_fds (accepted, buf, sizeof (buf), fds, &n_fds, NULL) == 1);
+	P_TEST_CHECK (n_fds == 1);
+	P_TEST_CHECK (fds[0] >= 0);
+	P_TEST_CHECK (fds[1] == -1);
+	P_TEST_CHECK (close (fds[0]) == 0);
+
+	/* Plain data comes without descriptors */
+	P_TEST_CHECK (p_socket_send (client, "e", 1, NULL) == 1);
+
+	n_fds = 2;
+
+	P_TEST_CHECK (p_socket_receive_fds (accepted, buf, sizeof (buf), fds, &n_fds, NULL) == 1);
+	P_TEST_CHECK (n_fds == 0);
+
+	p_shm_free (shm);
+#endif
+
+	p_socket_free (accepted);
+	p_socket_free (client);
+	p_socket_free (server);
+
+	P_TEST_CHECK (p_file_remove (PSOCKET_TEST_UNIX_STREAM, NULL) == TRUE);
+
+	/* Descriptors can't be passed over the network */
+	sock = p_socket_new (P_SOCKET_FAMILY_INET, P_SOCKET_TYPE_DATAGRAM, P_SOCKET_PROTOCOL_UDP, NULL);
+	P_TEST_REQUIRE (sock != NULL);
+
+	fds[0] = 0;
+
+	P_TEST_CHECK (p_socket_send_fds (sock, buf, 1, fds, 1, &error) == -1);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_NOT_SUPPORTED);
+	clean_error (&error);
+
+	p_socket_free (sock);
+
+	/* Datagram sockets, not supported on Windows */
+#ifndef P_OS_WIN
+	server = p_socket_new (P_SOCKET_FAMILY_UNIX, P_SOCKET_TYPE_DATAGRAM, P_SOCKET_PROTOCOL_DEFAULT, NULL);
+	client = p_socket_new (P_SOCKET_FAMILY_UNIX, P_SOCKET_TYPE_DATAGRAM, P_SOCKET_PROTOCOL_DEFAULT, NULL);
+	P_TEST_REQUIRE (server != NULL);
+	P_TEST_REQUIRE (client != NULL);
+
+	addr  = p_socket_address_new_unix (PSOCKET_TEST_UNIX_DGRAM1);
+	addr2 = p_socket_address_new_unix (PSOCKET_TEST_UNIX_DGRAM2);
+	P_TEST_REQUIRE (addr != NULL);
+	P_TEST_REQUIRE (addr2 != NULL);
+
+	P_TEST_CHECK (p_socket_bind (server, addr, FALSE, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_bind (client, addr2, FALSE, NULL) == TRUE);
+
+	P_TEST_CHECK (p_socket_send_to (client, addr, socket_data, sizeof (socket_data), NULL) == sizeof (socket_data));
+	p_socket_address_free (addr);
+	addr = NULL;
+
+	P_TEST_CHECK (p_socket_receive_from (server, &addr, buf, sizeof (buf), NULL) == sizeof (socket_data));
+	P_TEST_CHECK (strcmp (buf, socket_data) == 0);
+	P_TEST_REQUIRE (addr != NULL);
+	P_TEST_CHECK (p_socket_address_equal (addr, addr2) == TRUE);
+
+	p_socket_address_free (addr2);
+	p_socket_address_free (addr);
+	p_socket_free (client);
+	p_socket_free (server);
+
+	P_TEST_CHECK (p_file_remove (PSOCKET_TEST_UNIX_DGRAM1, NULL) == TRUE);
+	P_TEST_CHECK (p_file_remove (PSOCKET_TEST_UNIX_DGRAM2, NULL) == TRUE);
+#endif
+
+	/* Abstract namespace */
+#ifdef P_OS_LINUX
+	server = p_socket_new (P_SOCKET_FAMILY_UNIX, P_SOCKET_TYPE_STREAM, P_SOCKET_PROTOCOL_DEFAULT, NULL);
+	client = p_socket_new (P_SOCKET_FAMILY_UNIX, P_SOCKET_TYPE_STREAM, P_SOCKET_PROTOCOL_DEFAULT, NULL);
+	P_TEST_REQUIRE (server != NULL);
+	P_TEST_REQUIRE (client != NULL);
+
+	addr = p_socket_address_new_unix_abstract (PSOCKET_TEST_UNIX_STREAM);
+	P_TEST_REQUIRE (addr != NULL);
+
+	P_TEST_CHECK (p_socket_bind (server, addr, FALSE, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_listen (server, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_connect (client, addr, NULL) == TRUE);
+
+	addr2 = p_socket_get_local_address (server, NULL);
+	P_TEST_REQUIRE (addr2 != NULL);
+	P_TEST_CHECK (p_socket_address_is_unix_abstract (addr2) == TRUE);
+	P_TEST_CHECK (p_socket_address_equal (addr, addr2) == TRUE);
+	p_socket_address_free (addr2);
+	p_socket_address_free (addr);
+
+	accepted = p_socket_accept (server, NULL);
+	P_TEST_REQUIRE (accepted != NULL);
+
+	P_TEST_CHECK (p_socket_send (accepted, socket_data, sizeof (socket_data), NULL) == sizeof (socket_data));
+	P_TEST_CHECK (p_socket_receive (client, buf, sizeof (buf), NULL) == sizeof (socket_data));
+	P_TEST_CHECK (strcmp (buf, socket_data) == 0);
+
+	p_socket_free (accepted);
+	p_socket_free (client);
+	p_socket_free (server);
+
+	P_TEST_CHECK (p_file_is_exists (PSOCKET_TEST_UNIX_STREAM) == FALSE);
+#endif
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (psocket_option_test)
+{
+	p_libsys_init ();
+
+	PSocket *socket = p_socket_new (P_SOCKET_FAMILY_INET,
+					P_SOCKET_TYPE_STREAM,
+					P_SOCKET_PROTOCOL_TCP,
+					NULL);
+	P_TEST_REQUIRE (socket != NULL);
+
+	PError	*error = NULL;
+	pint	value  = -1;
+
+	P_TEST_CHECK (p_socket_get_option (socket, P_SOCKET_OPTION_TCP_NODELAY, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_socket_get_option (socket, P_SOCKET_OPTION_TCP_NODELAY, &value, NULL) == TRUE);
+	P_TEST_CHECK (value == 0);
+
+	P_TEST_CHECK (check_socket_option (socket, P_SOCKET_OPTION_TCP_NODELAY, 1, 1) == TRUE);
+	P_TEST_CHECK (check_socket_option (socket, P_SOCKET_OPTION_TCP_NODELAY, 0, 0) == TRUE);
+	P_TEST_CHECK (check_socket_option (socket, P_SOCKET_OPTION_TCP_CORK, 1, 1) == TRUE);
+	P_TEST_CHECK (check_socket_option (socket, P_SOCKET_OPTION_TCP_CORK, 0, 0) == TRUE);
+	P_TEST_CHECK (check_socket_option (socket, P_SOCKET_OPTION_REUSE_PORT, 1, 1) == TRUE);
+	P_TEST_CHECK (check_socket_option (socket, P_SOCKET_OPTION_TOS, 0x10, 0x10) == TRUE);
+	P_TEST_CHECK (check_socket_option (socket, P_SOCKET_OPTION_TCP_NOTSENT_LOWAT, 16384, 16384) == TRUE);
+
+	P_TEST_CHECK (check_socket_option (socket, P_SOCKET_OPTION_TCP_QUICKACK, 1, 1) == TRUE);
+
+	P_TEST_CHECK (p_socket_set_option (socket, (PSocketOption) 100, 1, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_NOT_SUPPORTED);
+	clean_error (&error);
+
+	P_TEST_CHECK (p_socket_close (socket, NULL) == TRUE);
+
+	P_TEST_CHECK (p_socket_set_option (socket, P_SOCKET_OPTION_TCP_NODELAY, 1, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	clean_error (&error);
+
+	P_TEST_CHECK (p_socket_get_option (socket, P_SOCKET_OPTION_TCP_NODELAY, &value, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	clean_error (&error);
+
+	p_socket_free (socket);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (psocket_stats_test)
+{
+	p_libsys_init ();
+
+	PSocketStats	stats;
+	PSocketMessage	messages[2];
+	pchar		buf[64];
+
+	PSocket *receiver = p_socket_new (P_SOCKET_FAMILY_INET,
+					  P_SOCKET_TYPE_DATAGRAM,
+					  P_SOCKET_PROTOCOL_UDP,
+					  NULL);
+	PSocket *sender   = p_socket_new (P_SOCKET_FAMILY_INET,
+					  P_SOCKET_TYPE_DATAGRAM,
+					  P_SOCKET_PROTOCOL_UDP,
+					  NULL);
+	P_TEST_REQUIRE (receiver != NULL);
+	P_TEST_REQUIRE (sender != NULL);
+
+	PSocketAddress *addr = p_socket_address_new ("127.0.0.1", 0);
+	P_TEST_REQUIRE (addr != NULL);
+	P_TEST_CHECK (p_socket_bind (receiver, addr, FALSE, NULL) == TRUE);
+	p_socket_address_free (addr);
+
+	addr = p_socket_get_local_address (receiver, NULL);
+	P_TEST_REQUIRE (addr != NULL);
+	P_TEST_CHECK (p_socket_connect (sender, addr, NULL) == TRUE);
+	p_socket_address_free (addr);
+
+	p_socket_set_timeout (receiver, 2000);
+
+	P_TEST_CHECK (p_socket_set_stats_enabled (NULL, TRUE, NULL) == FALSE);
+	P_TEST_CHECK (p_socket_get_stats (NULL, &stats) == FALSE);
+	P_TEST_CHECK (p_socket_get_stats (sender, NULL) == FALSE);
+	P_TEST_CHECK (p_socket_get_stats (sender, &stats) == FALSE);
+	p_socket_reset_stats (NULL);
+	p_socket_reset_stats (sender);
+
+	P_TEST_CHECK (p_socket_set_stats_enabled (sender, TRUE, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_set_stats_enabled (receiver, TRUE, NULL) == TRUE);
+
+	P_TEST_CHECK (p_socket_get_stats (sender, &stats) == TRUE);
+	P_TEST_CHECK (stats.syscalls == 0 && stats.bytes_sent == 0 && stats.waits == 0);
+
+	memset (buf, 'a', sizeof (buf));
+
+	P_TEST_CHECK (p_socket_send (sender, buf, 10, NULL) == 10);
+
+	messages[0].address = NULL;
+	messages[0].buffer  = buf;
+	messages[0].buflen  = 20;
+	messages[1].address = NULL;
+	messages[1].buffer  = buf;
+	messages[1].buflen  = 30;
+
+	P_TEST_CHECK (p_socket_send_many (sender, messages, 2, NULL) == 2);
+
+	/* Enabling again keeps the counters */
+	P_TEST_CHECK (p_socket_set_stats_enabled (sender, TRUE, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_get_stats (sender, &stats) == TRUE);
+	P_TEST_CHECK (stats.bytes_sent == 60);
+	P_TEST_CHECK (stats.packets_sent == 3);
+	P_TEST_CHECK (stats.syscalls >= 2);
+	P_TEST_CHECK (stats.bytes_received == 0);
+	P_TEST_CHECK (stats.packets_received == 0);
+	P_TEST_CHECK (stats.waits >= 2);
+
+	for (pint i = 0; i < 3; ++i)
+		P_TEST_CHECK (p_socket_receive (receiver, buf, sizeof (buf), NULL) > 0);
+
+	P_TEST_CHECK (p_socket_get_stats (receiver, &stats) == TRUE);
+	P_TEST_CHECK (stats.bytes_received == 60);
+	P_TEST_CHECK (stats.packets_received == 3);
+	P_TEST_CHECK (stats.syscalls >= 3);
+	P_TEST_CHECK (stats.waits >= 3);
+	P_TEST_CHECK (stats.would_block == 0);
+
+	p_socket_set_blocking (receiver, FALSE);
+	P_TEST_CHECK (p_socket_receive (receiver, buf, sizeof (buf), NULL) == -1);
+
+	P_TEST_CHECK (p_socket_get_stats (receiver, &stats) == TRUE);
+	P_TEST_CHECK (stats.would_block == 1);
+	P_TEST_CHECK (stats.packets_received == 3);
+
+	/* Blocking wait accounts its time */
+	p_socket_set_blocking (receiver, TRUE);
+	p_socket_set_timeout (receiver, 100);
+	p_socket_reset_stats (receiver);
+
+	P_TEST_CHECK (p_socket_receive (receiver, buf, sizeof (buf), NULL) == -1);
+
+	P_TEST_CHECK (p_socket_get_stats (receiver, &stats) == TRUE);
+	P_TEST_CHECK (stats.syscalls == 0);
+	P_TEST_CHECK (stats.waits == 1);
+	P_TEST_CHECK (stats.wait_time >= 50000);
+
+	P_TEST_CHECK (p_socket_set_stats_enabled (receiver, FALSE, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_get_stats (receiver, &stats) == FALSE);
+
+	p_socket_free (receiver);
+	p_socket_free (sender);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (psocket_silent_would_block_test)
+{
+	p_libsys_init ();
+
+	PError	*error = NULL;
+	pchar	buf[64];
+
+	PSocket *socket = p_socket_new (P_SOCKET_FAMILY_INET,
+					P_SOCKET_TYPE_DATAGRAM,
+					P_SOCKET_PROTOCOL_UDP,
+					NULL);
+	P_TEST_REQUIRE (socket != NULL);
+
+	PSocketAddress *addr = p_socket_address_new ("127.0.0.1", 0);
+	P_TEST_REQUIRE (addr != NULL);
+	P_TEST_CHECK (p_socket_bind (socket, addr, FALSE, NULL) == TRUE);
+	p_socket_address_free (addr);
+
+	P_TEST_CHECK (p_socket_get_silent_would_block (NULL) == FALSE);
+	p_socket_set_silent_would_block (NULL, TRUE);
+
+	P_TEST_CHECK (p_socket_get_silent_would_block (socket) == FALSE);
+
+	p_socket_set_blocking (socket, FALSE);
+
+	/* Regular mode reports the would-block case with an error */
+	P_TEST_CHECK (p_socket_receive (socket, buf, sizeof (buf), &error) == -1);
+	P_TEST_REQUIRE (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_WOULD_BLOCK);
+	P_TEST_CHECK (p_error_get_message (error) != NULL);
+	clean_error (&error);
+
+	p_socket_set_silent_would_block (socket, TRUE);
+	P_TEST_CHECK (p_socket_get_silent_would_block (socket) == TRUE);
+
+	P_TEST_CHECK (p_socket_receive (socket, buf, sizeof (buf), &error) == -1);
+	P_TEST_CHECK (error == NULL);
+
+	P_TEST_CHECK (p_socket_receive_from (socket, NULL, buf, sizeof (buf), &error) == -1);
+	P_TEST_CHECK (error == NULL);
+
+	/* Other errors are still reported */
+	P_TEST_CHECK (p_socket_receive (socket, NULL, sizeof (buf), &error) == -1);
+	P_TEST_CHECK (error != NULL);
+	clean_error (&error);
+
+	p_socket_set_silent_would_block (socket, FALSE);
+	P_TEST_CHECK (p_socket_get_silent_would_block (socket) == FALSE);
+
+	p_socket_free (socket);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (psocket_deadline_test)
+{
+	p_libsys_init ();
+
+	PTimeProfiler	*profiler;
+	PError		*error = NULL;
+	PDeadline	deadline;
+	pchar		buf[64];
+
+	PSocket *socket = p_socket_new (P_SOCKET_FAMILY_INET,
+					P_SOCKET_TYPE_DATAGRAM,
+					P_SOCKET_PROTOCOL_UDP,
+					NULL);
+	P_TEST_REQUIRE (socket != NULL);
+
+	PSocketAddress *addr = p_socket_address_new ("127.0.0.1", 0);
+	P_TEST_REQUIRE (addr != NULL);
+	P_TEST_CHECK (p_socket_bind (socket, addr, FALSE, NULL) == TRUE);
+	p_socket_address_free (addr);
+
+	p_socket_set_deadline (NULL, NULL);
+
+	profiler = p_time_profiler_new ();
+	P_TEST_REQUIRE (profiler != NULL);
+
+	/* Nothing arrives, so the blocking receive stops at the deadline */
+	p_deadline_init_msecs (&deadline, 100);
+	p_socket_set_deadline (socket, &deadline);
+
+	P_TEST_CHECK (p_socket_receive (socket, buf, sizeof (buf), &error) == -1);
+	P_TEST_REQUIRE (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_TIMED_OUT);
+	P_TEST_CHECK (p_time_profiler_elapsed_usecs (profiler) >= 90 * 1000);
+	clean_error (&error);
+
+	/* Expired deadline fails at once, even with a longer timeout */
+	p_socket_set_timeout (socket, 10000);
+	p_time_profiler_reset (profiler);
+
+	P_TEST_CHECK (p_socket_io_condition_wait (socket, P_SOCKET_IO_CONDITION_POLLIN, &error) == FALSE);
+	P_TEST_REQUIRE (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_TIMED_OUT);
+	P_TEST_CHECK (p_time_profiler_elapsed_usecs (profiler) < 5000 * 1000);
+	clean_error (&error);
+
+	/* Shorter timeout still applies with a far deadline */
+	p_deadline_init_msecs (&deadline, 10000);
+	p_socket_set_deadline (socket, &deadline);
+	p_socket_set_timeout (socket, 100);
+	p_time_profiler_reset (profiler);
+
+	P_TEST_CHECK (p_socket_io_condition_wait (socket, P_SOCKET_IO_CONDITION_POLLIN, &error) == FALSE);
+	P_TEST_REQUIRE (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_TIMED_OUT);
+	P_TEST_CHECK (p_time_profiler_elapsed_usecs (profiler) < 5000 * 1000);
+	clean_error (&error);
+
+	/* Unset deadline leaves only the timeout */
+	p_socket_set_deadline (socket, NULL);
+	P_TEST_CHECK (p_socket_io_condition_wait (socket, P_SOCKET_IO_CONDITION_POLLOUT, NULL) == TRUE);
+
+	p_time_profiler_free (profiler);
+	p_socket_free (socket);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (psocket_shutdown_alive_test)
+{
+	p_libsys_init ();
+
+	PSocket *socket = p_socket_new (P_SOCKET_FAMILY_INET,
+					P_SOCKET_TYPE_DATAGRAM,
+					P_SOCKET_PROTOCOL_UDP,
+					NULL);
+	P_TEST_REQUIRE (socket != NULL);
+
+	PSocketAddress *addr = p_socket_address_new ("127.0.0.1", 0);
+	P_TEST_REQUIRE (addr != NULL);
+
+	/* Objects which outlive the library must stay valid */
+	p_libsys_shutdown ();
+
+	P_TEST_CHECK (p_socket_address_get_port (addr) == 0);
+	P_TEST_CHECK (p_socket_close (socket, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_is_closed (socket) == TRUE);
+
+	p_socket_address_free (addr);
+	p_socket_free (socket);
+
+	/* Fresh pools are used after the next initialization */
+	p_libsys_init ();
+
+	socket = p_socket_new (P_SOCKET_FAMILY_INET,
+			       P_SOCKET_TYPE_DATAGRAM,
+			       P_SOCKET_PROTOCOL_UDP,
+			       NULL);
+	P_TEST_REQUIRE (socket != NULL);
+
+	addr = p_socket_address_new ("127.0.0.1", 0);
+	P_TEST_REQUIRE (addr != NULL);
+
+	p_socket_address_free (addr);
+	p_socket_free (socket);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (psocket_receive_from_into_test)
+{
+	p_libsys_init ();
+
+	pchar	buf[64];
+	pint	i;
+
+	PSocket *receiver = p_socket_new (P_SOCKET_FAMILY_INET,
+					  P_SOCKET_TYPE_DATAGRAM,
+					  P_SOCKET_PROTOCOL_UDP,
+					  NULL);
+	PSocket *sender   = p_socket_new (P_SOCKET_FAMILY_INET,
+					  P_SOCKET_TYPE_DATAGRAM,
+					  P_SOCKET_PROTOCOL_UDP,
+					  NULL);
+	P_TEST_REQUIRE (receiver != NULL);
+	P_TEST_REQUIRE (sender != NULL);
+
+	PSocketAddress *addr = p_socket_address_new ("127.0.0.1", 0);
+	P_TEST_REQUIRE (addr != NULL);
+	P_TEST_CHECK (p_socket_bind (receiver, addr, FALSE, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_bind (sender, addr, FALSE, NULL) == TRUE);
+	p_socket_address_free (addr);
+
+	addr = p_socket_get_local_address (receiver, NULL);
+	P_TEST_REQUIRE (addr != NULL);
+	P_TEST_CHECK (p_socket_connect (sender, addr, NULL) == TRUE);
+	p_socket_address_free (addr);
+
+	PSocketAddress *sender_addr = p_socket_get_local_address (sender, NULL);
+	P_TEST_REQUIRE (sender_addr != NULL);
+
+	p_socket_set_timeout (receiver, 2000);
+
+	P_TEST_CHECK (p_socket_receive_from_into (NULL, NULL, buf, sizeof (buf), NULL) == -1);
+	P_TEST_CHECK (p_socket_receive_from_into (receiver, NULL, NULL, sizeof (buf), NULL) == -1);
+
+	/* The same address object is reused for every datagram */
+	PSocketAddress *remote = p_socket_address_new_any (P_SOCKET_FAMILY_INET, 0);
+	P_TEST_REQUIRE (remote != NULL);
+
+	for (i = 0; i < 3; ++i) {
+		P_TEST_CHECK (p_socket_send (sender, buf, 10 + (psize) i, NULL) == 10 + i);
+		P_TEST_CHECK (p_socket_receive_from_into (receiver, remote, buf, sizeof (buf), NULL) == 10 + i);
+
+		P_TEST_CHECK (p_socket_address_get_family (remote) == P_SOCKET_FAMILY_INET);
+		P_TEST_CHECK (p_socket_address_get_port (remote) == p_socket_address_get_port (sender_addr));
+		P_TEST_CHECK (p_socket_address_is_any (remote) == FALSE);
+	}
+
+	/* Remote address may be ignored */
+	P_TEST_CHECK (p_socket_send (sender, buf, 5, NULL) == 5);
+	P_TEST_CHECK (p_socket_receive_from_into (receiver, NULL, buf, sizeof (buf), NULL) == 5);
+
+	p_socket_address_free (remote);
+	p_socket_address_free (sender_addr);
+	p_socket_free (sender);
+	p_socket_free (receiver);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (psocket_connect_any_test)
+{
+	p_libsys_init ();
+
+	PSocketAddress	*addrs[3];
+	PError		*error = NULL;
+	psize		index  = 0;
+
+	PSocket *server = p_socket_new (P_SOCKET_FAMILY_INET,
+					P_SOCKET_TYPE_STREAM,
+					P_SOCKET_PROTOCOL_TCP,
+					NULL);
+	P_TEST_REQUIRE (server != NULL);
+
+	/* Bound but not listening socket refuses connections */
+	PSocket *closed = p_socket_new (P_SOCKET_FAMILY_INET,
+					P_SOCKET_TYPE_STREAM,
+					P_SOCKET_PROTOCOL_TCP,
+					NULL);
+	P_TEST_REQUIRE (closed != NULL);
+
+	PSocketAddress *addr = p_socket_address_new ("127.0.0.1", 0);
+	P_TEST_REQUIRE (addr != NULL);
+
+	P_TEST_CHECK (p_socket_bind (server, addr, TRUE, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_bind (closed, addr, TRUE, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_listen (server, NULL) == TRUE);
+	p_socket_address_free (addr);
+
+	addrs[0] = p_socket_get_local_address (closed, NULL);
+	addrs[1] = p_socket_get_local_address (server, NULL);
+	addrs[2] = p_socket_address_new ("::1", p_socket_address_get_port (addrs[0]));
+
+	P_TEST_REQUIRE (addrs[0] != NULL);
+	P_TEST_REQUIRE (addrs[1] != NULL);
+
+	P_TEST_CHECK (p_socket_connect_any (NULL, 1, 0, 0, NULL, NULL) == NULL);
+	P_TEST_CHECK (p_socket_connect_any (addrs, 0, 0, 0, NULL, NULL) == NULL);
+	P_TEST_CHECK (p_socket_connect_any (addrs, 1, -1, 0, NULL, NULL) == NULL);
+	P_TEST_CHECK (p_socket_connect_any (addrs, 1, 0, -1, NULL, NULL) == NULL);
+
+	/* Refused attempt starts the next one before the delay */
+	PSocket *socket = p_socket_connect_any (addrs, 2, 10000, 5000, &index, NULL);
+	P_TEST_REQUIRE (socket != NULL);
+	P_TEST_CHECK (index == 1);
+	P_TEST_CHECK (p_socket_is_connected (socket) == TRUE);
+	P_TEST_CHECK (p_socket_get_blocking (socket) == TRUE);
+	p_socket_free (socket);
+
+	socket = p_socket_connect_any (addrs + 1, 1, 0, 0, &index, NULL);
+	P_TEST_REQUIRE (socket != NULL);
+	P_TEST_CHECK (index == 0);
+	p_socket_free (socket);
+
+	/* IPv6 candidate is tried in between */
+	if (addrs[2] != NULL) {
+		socket = p_socket_connect_any (addrs, 3, 50, 5000, &index, NULL);
+		P_TEST_REQUIRE (socket != NULL);
+		P_TEST_CHECK (index == 1);
+		p_socket_free (socket);
+	}
+
+	P_TEST_CHECK (p_socket_connect_any (addrs, 1, 50, 5000, &index, &error) == NULL);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_CONNECTION_REFUSED);
+	clean_error (&error);
+
+	for (pint i = 0; i < 3; ++i)
+		p_socket_address_free (addrs[i]);
+
+	p_socket_free (closed);
+	p_socket_free (server);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (psocket_accept_many_test)
+{
+	p_libsys_init ();
+
+	PSocket	*clients[PSOCKET_TEST_ACCEPT_COUNT];
+	PSocket	*accepted[PSOCKET_TEST_ACCEPT_COUNT + 1];
+	PError	*error = NULL;
+
+	PSocket *server = p_socket_new (P_SOCKET_FAMILY_INET,
+					P_SOCKET_TYPE_STREAM,
+					P_SOCKET_PROTOCOL_TCP,
+					NULL);
+	P_TEST_REQUIRE (server != NULL);
+
+	PSocketAddress *addr = p_socket_address_new ("127.0.0.1", 0);
+	P_TEST_REQUIRE (addr != NULL);
+
+	P_TEST_CHECK (p_socket_bind (server, addr, TRUE, NULL) == TRUE);
+	p_socket_address_free (addr);
+
+	p_socket_set_keepalive (server, TRUE);
+	p_socket_set_blocking (server, FALSE);
+	P_TEST_CHECK (p_socket_listen (server, NULL) == TRUE);
+
+	P_TEST_CHECK (p_socket_accept_many (NULL, accepted, 1, NULL) == -1);
+	P_TEST_CHECK (p_socket_accept_many (server, NULL, 1, NULL) == -1);
+	P_TEST_CHECK (p_socket_accept_many (server, accepted, 0, NULL) == -1);
+
+	/* Nothing to accept yet */
+	P_TEST_CHECK (p_socket_accept_many (server, accepted, 1, &error) == -1);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_WOULD_BLOCK);
+	clean_error (&error);
+
+	addr = p_socket_get_local_address (server, NULL);
+	P_TEST_REQUIRE (addr != NULL);
+
+	for (pint i = 0; i < PSOCKET_TEST_ACCEPT_COUNT; ++i) {
+		clients[i] = p_socket_new (P_SOCKET_FAMILY_INET,
+					   P_SOCKET_TYPE_STREAM,
+					   P_SOCKET_PROTOCOL_TCP,
+					   NULL);
+		P_TEST_REQUIRE (clients[i] != NULL);
+		P_TEST_CHECK (p_socket_connect (clients[i], addr, NULL) == TRUE);
+	}
+
+	p_socket_address_free (addr);
+
+	/* Drain the queue in two parts */
+	P_TEST_CHECK (p_socket_accept_many (server, accepted, 2, NULL) == 2);
+
+	psize total = 2;
+
+	while (total < PSOCKET_TEST_ACCEPT_COUNT &&
+	       p_socket_io_condition_wait (server, P_SOCKET_IO_CONDITION_POLLIN, NULL) == TRUE) {
+		pssize ret = p_socket_accept_many (server,
+						   accepted + total,
+						   PSOCKET_TEST_ACCEPT_COUNT + 1 - total,
+						   NULL);
+
+		if (ret <= 0)
+			break;
+
+		total += (psize) ret;
+	}
+
+	P_TEST_CHECK (total == PSOCKET_TEST_ACCEPT_COUNT);
+
+	for (psize i = 0; i < total; ++i) {
+		P_TEST_CHECK (p_socket_is_connected (accepted[i]) == TRUE);
+		P_TEST_CHECK (p_socket_get_blocking (accepted[i]) == TRUE);
+		P_TEST_CHECK (p_socket_get_keepalive (accepted[i]) == TRUE);
+		P_TEST_CHECK (p_socket_get_family (accepted[i]) == P_SOCKET_FAMILY_INET);
+		P_TEST_CHECK (p_socket_get_type (accepted[i]) == P_SOCKET_TYPE_STREAM);
+		P_TEST_CHECK (p_socket_get_protocol (accepted[i]) == P_SOCKET_PROTOCOL_TCP);
+	}
+
+	/* Find the peer of the first accepted connection */
+	PSocket	*peer = NULL;
+	pchar	buffer[sizeof (socket_data)];
+
+	addr = p_socket_get_remote_address (accepted[0], NULL);
+	P_TEST_REQUIRE (addr != NULL);
+
+	for (pint i = 0; i < PSOCKET_TEST_ACCEPT_COUNT; ++i) {
+		PSocketAddress *local_addr = p_socket_get_local_address (clients[i], NULL);
+		P_TEST_REQUIRE (local_addr != NULL);
+
+		if (p_socket_address_get_port (local_addr) == p_socket_address_get_port (addr))
+			peer = clients[i];
+
+		p_socket_address_free (local_addr);
+	}
+
+	p_socket_address_free (addr);
+
+	P_TEST_REQUIRE (peer != NULL);
+	P_TEST_CHECK (p_socket_send (accepted[0], socket_data, sizeof (socket_data), NULL) ==
+		      (pssize) sizeof (socket_data));
+	P_TEST_CHECK (p_socket_receive (peer, buffer, sizeof (buffer), NULL) == (pssize) sizeof (socket_data));
+	P_TEST_CHECK (memcmp (buffer, socket_data, sizeof (socket_data)) == 0);
+
+	for (psize i = 0; i < total; ++i)
+		p_socket_free (accepted[i]);
+
+	for (pint i = 0; i < PSOCKET_TEST_ACCEPT_COUNT; ++i)
+		p_socket_free (clients[i]);
+
+	P_TEST_CHECK (p_socket_close (server, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_accept_many (server, accepted, 1, NULL) == -1);
+
+	p_socket_free (server);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
 P_TEST_CASE_BEGIN (psocket_udp_test)
 {
 	p_libsys_init ();
@@ -1124,6 +2609,20 @@ P_TEST_SUITE_BEGIN()
 	P_TEST_SUITE_RUN_CASE (psocket_bad_input_test);
 	P_TEST_SUITE_RUN_CASE (psocket_general_udp_test);
 	P_TEST_SUITE_RUN_CASE (psocket_general_tcp_test);
+	P_TEST_SUITE_RUN_CASE (psocket_vector_test);
+	P_TEST_SUITE_RUN_CASE (psocket_many_test);
+	P_TEST_SUITE_RUN_CASE (psocket_segmented_test);
+	P_TEST_SUITE_RUN_CASE (psocket_timestamp_test);
+	P_TEST_SUITE_RUN_CASE (psocket_send_file_test);
+	P_TEST_SUITE_RUN_CASE (psocket_unix_test);
+	P_TEST_SUITE_RUN_CASE (psocket_option_test);
+	P_TEST_SUITE_RUN_CASE (psocket_stats_test);
+	P_TEST_SUITE_RUN_CASE (psocket_silent_would_block_test);
+	P_TEST_SUITE_RUN_CASE (psocket_deadline_test);
+	P_TEST_SUITE_RUN_CASE (psocket_shutdown_alive_test);
+	P_TEST_SUITE_RUN_CASE (psocket_receive_from_into_test);
+	P_TEST_SUITE_RUN_CASE (psocket_connect_any_test);
+	P_TEST_SUITE_RUN_CASE (psocket_accept_many_test);
 	P_TEST_SUITE_RUN_CASE (psocket_udp_test);
 	P_TEST_SUITE_RUN_CASE (psocket_tcp_test);
 	P_TEST_SUITE_RUN_CASE (psocket_shutdown_test);
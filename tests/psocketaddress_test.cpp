@@ -30,6 +30,8 @@
 
 P_TEST_MODULE_INIT ();
 
+#define PSOCKETADDRESS_TEST_DRAIN_COUNT 4096
+
 extern "C" ppointer pmem_alloc (psize nbytes)
 {
 	P_UNUSED (nbytes);
@@ -52,6 +54,21 @@ P_TEST_CASE_BEGIN (psocketaddress_nomem_test)
 {
 	p_libsys_init ();
 
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	/* The object pool can't be created yet */
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (p_socket_address_new ("192.168.0.1", 1058) == NULL);
+	P_TEST_CHECK (p_socket_address_new_any (P_SOCKET_FAMILY_INET, 1058) == NULL);
+	P_TEST_CHECK (p_socket_address_new_loopback (P_SOCKET_FAMILY_INET, 1058) == NULL);
+
+	p_mem_restore_vtable ();
+
 	PSocketAddress *sock_addr = p_socket_address_new ("192.168.0.1", 1058);
 	P_TEST_CHECK (sock_addr != NULL);
 
@@ -84,13 +101,35 @@ P_TEST_CASE_BEGIN (psocketaddress_nomem_test)
 		p_socket_address_free (sock_addr6);
 	}
 
-	PMemVTable vtable;
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
 
-	vtable.free    = pmem_free;
-	vtable.malloc  = pmem_alloc;
-	vtable.realloc = pmem_realloc;
+	/* Released addresses are recycled without the heap */
+	sock_addr = p_socket_address_new_from_native (addr_buf, native_size);
+	P_TEST_CHECK (sock_addr != NULL);
+	P_TEST_CHECK (p_socket_address_get_port (sock_addr) == 1058);
+	p_socket_address_free (sock_addr);
 
-	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+	if (p_socket_address_is_ipv6_supported ()) {
+		sock_addr6 = p_socket_address_new_from_native (addr_buf6, native_size6);
+		P_TEST_CHECK (sock_addr6 != NULL);
+		P_TEST_CHECK (p_socket_address_get_family (sock_addr6) == P_SOCKET_FAMILY_INET6);
+		p_socket_address_free (sock_addr6);
+	}
+
+	/* Allocations fail once the pool runs out of recycled addresses */
+	PSocketAddress	*drained[PSOCKETADDRESS_TEST_DRAIN_COUNT];
+	pint		drained_count = 0;
+
+	while (drained_count < PSOCKETADDRESS_TEST_DRAIN_COUNT) {
+		drained[drained_count] = p_socket_address_new_from_native (addr_buf, native_size);
+
+		if (drained[drained_count] == NULL)
+			break;
+
+		++drained_count;
+	}
+
+	P_TEST_CHECK (drained_count < PSOCKETADDRESS_TEST_DRAIN_COUNT);
 
 	P_TEST_CHECK (p_socket_address_new ("192.168.0.1", 1058) == NULL);
 	P_TEST_CHECK (p_socket_address_new_any (P_SOCKET_FAMILY_INET, 1058) == NULL);
@@ -102,6 +141,9 @@ P_TEST_CASE_BEGIN (psocketaddress_nomem_test)
 
 	p_mem_restore_vtable ();
 
+	for (pint i = 0; i < drained_count; ++i)
+		p_socket_address_free (drained[i]);
+
 	P_TEST_CHECK (p_socket_address_new_from_native (addr_buf, native_size - 1) == NULL);
 
 	if (p_socket_address_is_ipv6_supported ()) {
@@ -120,6 +162,10 @@ P_TEST_CASE_BEGIN (psocketaddress_bad_input_test)
 	p_libsys_init ();
 
 	P_TEST_CHECK (p_socket_address_new_from_native (NULL, 0) == NULL);
+	P_TEST_CHECK (p_socket_address_set_from_native (NULL, NULL, 0) == FALSE);
+	P_TEST_CHECK (p_socket_address_hash (NULL) == 0);
+	P_TEST_CHECK (p_socket_address_equal (NULL, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_address_compare (NULL, NULL) == 0);
 	P_TEST_CHECK (p_socket_address_new (NULL, 0) == NULL);
 	P_TEST_CHECK (p_socket_address_new ("bad_address", 0) == NULL);
 	P_TEST_CHECK (p_socket_address_new_any (P_SOCKET_FAMILY_UNKNOWN, 0) == NULL);
@@ -133,6 +179,13 @@ P_TEST_CASE_BEGIN (psocketaddress_bad_input_test)
 	P_TEST_CHECK (p_socket_address_get_scope_id (NULL) == 0);
 	P_TEST_CHECK (p_socket_address_is_any (NULL) == FALSE);
 	P_TEST_CHECK (p_socket_address_is_loopback (NULL) == FALSE);
+	P_TEST_CHECK (p_socket_address_is_unix_abstract (NULL) == FALSE);
+	P_TEST_CHECK (p_socket_address_new_unix (NULL) == NULL);
+	P_TEST_CHECK (p_socket_address_new_unix ("") == NULL);
+	P_TEST_CHECK (p_socket_address_new_unix_abstract (NULL) == NULL);
+	P_TEST_CHECK (p_socket_address_new_unix_abstract ("") == NULL);
+	P_TEST_CHECK (p_socket_address_new_any (P_SOCKET_FAMILY_UNIX, 0) == NULL);
+	P_TEST_CHECK (p_socket_address_new_loopback (P_SOCKET_FAMILY_UNIX, 0) == NULL);
 
 	p_socket_address_set_flow_info (NULL, 0);
 	p_socket_address_set_scope_id (NULL, 0);
@@ -263,6 +316,26 @@ P_TEST_CASE_BEGIN (psocketaddress_general_test)
 	P_TEST_REQUIRE (addr_str != NULL);
 	P_TEST_CHECK (strcmp (addr_str, "192.168.0.2") == 0);
 
+	p_free (addr_str);
+	p_socket_address_free (addr);
+
+	/* Update an existing address in place */
+	addr = p_socket_address_new ("10.0.0.1", 80);
+	P_TEST_REQUIRE (addr != NULL);
+
+	P_TEST_CHECK (p_socket_address_set_from_native (addr, NULL, native_size) == FALSE);
+	P_TEST_CHECK (p_socket_address_set_from_native (addr, native_buf, native_size - 1) == FALSE);
+	P_TEST_CHECK (p_socket_address_get_port (addr) == 80);
+
+	P_TEST_CHECK (p_socket_address_set_from_native (addr, native_buf, native_size) == TRUE);
+	P_TEST_CHECK (p_socket_address_get_family (addr) == P_SOCKET_FAMILY_INET);
+	P_TEST_CHECK (p_socket_address_get_port (addr) == 2345);
+
+	addr_str = p_socket_address_get_address (addr);
+
+	P_TEST_REQUIRE (addr_str != NULL);
+	P_TEST_CHECK (strcmp (addr_str, "192.168.0.2") == 0);
+
 	p_free (native_buf);
 	p_free (addr_str);
 	p_socket_address_free (addr);
@@ -329,10 +402,191 @@ P_TEST_CASE_BEGIN (psocketaddress_general_test)
 }
 P_TEST_CASE_END ()
 
+P_TEST_CASE_BEGIN (psocketaddress_compare_test)
+{
+	p_libsys_init ();
+
+	PSocketAddress *addr1 = p_socket_address_new ("10.0.0.1", 80);
+	PSocketAddress *addr2 = p_socket_address_new ("10.0.0.1", 80);
+	PSocketAddress *addr3 = p_socket_address_new ("10.0.0.1", 81);
+	PSocketAddress *addr4 = p_socket_address_new ("10.0.0.2", 80);
+	PSocketAddress *addr5 = p_socket_address_new ("9.255.255.255", 65535);
+
+	P_TEST_REQUIRE (addr1 != NULL && addr2 != NULL && addr3 != NULL && addr4 != NULL && addr5 != NULL);
+
+	P_TEST_CHECK (p_socket_address_equal (addr1, addr2) == TRUE);
+	P_TEST_CHECK (p_socket_address_hash (addr1) == p_socket_address_hash (addr2));
+	P_TEST_CHECK (p_socket_address_compare (addr1, addr2) == 0);
+
+	P_TEST_CHECK (p_socket_address_equal (addr1, addr3) == FALSE);
+	P_TEST_CHECK (p_socket_address_equal (addr1, addr4) == FALSE);
+	P_TEST_CHECK (p_socket_address_equal (addr1, NULL) == FALSE);
+	P_TEST_CHECK (p_socket_address_hash (addr1) != p_socket_address_hash (addr3));
+	P_TEST_CHECK (p_socket_address_hash (addr1) != p_socket_address_hash (addr4));
+
+	/* The IP address goes before the port */
+	P_TEST_CHECK (p_socket_address_compare (addr1, addr3) < 0);
+	P_TEST_CHECK (p_socket_address_compare (addr3, addr1) > 0);
+	P_TEST_CHECK (p_socket_address_compare (addr3, addr4) < 0);
+	P_TEST_CHECK (p_socket_address_compare (addr5, addr1) < 0);
+	P_TEST_CHECK (p_socket_address_compare (NULL, addr1) < 0);
+	P_TEST_CHECK (p_socket_address_compare (addr1, NULL) > 0);
+
+	/* Addresses as hash table keys */
+	PHashTable *table = p_hash_table_new_full (p_socket_address_hash, p_socket_address_equal, NULL, NULL);
+	P_TEST_REQUIRE (table != NULL);
+
+	p_hash_table_insert (table, addr1, PINT_TO_POINTER (1));
+	p_hash_table_insert (table, addr3, PINT_TO_POINTER (3));
+	p_hash_table_insert (table, addr4, PINT_TO_POINTER (4));
+
+	P_TEST_CHECK (p_hash_table_lookup (table, addr2) == PINT_TO_POINTER (1));
+	P_TEST_CHECK (p_hash_table_lookup (table, addr3) == PINT_TO_POINTER (3));
+	P_TEST_CHECK (p_hash_table_lookup (table, addr5) == (ppointer) -1);
+
+	p_hash_table_free (table);
+
+	if (p_socket_address_is_ipv6_supported ()) {
+		PSocketAddress *addr6 = p_socket_address_new ("2001:cdba::3257:9652", 80);
+		PSocketAddress *addr7 = p_socket_address_new ("2001:cdba::3257:9652", 80);
+
+		P_TEST_REQUIRE (addr6 != NULL && addr7 != NULL);
+
+		P_TEST_CHECK (p_socket_address_equal (addr6, addr7) == TRUE);
+		P_TEST_CHECK (p_socket_address_hash (addr6) == p_socket_address_hash (addr7));
+		P_TEST_CHECK (p_socket_address_equal (addr6, addr1) == FALSE);
+		P_TEST_CHECK (p_socket_address_compare (addr1, addr6) < 0);
+
+		/* Flow information is ignored, the scope is not */
+		p_socket_address_set_flow_info (addr7, 5);
+		P_TEST_CHECK (p_socket_address_equal (addr6, addr7) == TRUE);
+
+		if (p_socket_address_is_scope_id_supported ()) {
+			p_socket_address_set_scope_id (addr7, 2);
+			P_TEST_CHECK (p_socket_address_equal (addr6, addr7) == FALSE);
+			P_TEST_CHECK (p_socket_address_compare (addr6, addr7) < 0);
+		}
+
+		p_socket_address_free (addr7);
+		p_socket_address_free (addr6);
+	}
+
+	p_socket_address_free (addr5);
+	p_socket_address_free (addr4);
+	p_socket_address_free (addr3);
+	p_socket_address_free (addr2);
+	p_socket_address_free (addr1);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (psocketaddress_unix_test)
+{
+	PSocketAddress	*addr1;
+	PSocketAddress	*addr2;
+	PSocketAddress	*addr3;
+	pchar		long_path[512];
+	pchar		native[256];
+	pchar		*str;
+	psize		native_size;
+
+	p_libsys_init ();
+
+	if (p_socket_address_is_unix_supported () == FALSE) {
+		p_libsys_shutdown ();
+		P_TEST_CASE_RETURN ();
+	}
+
+	memset (long_path, 'a', sizeof (long_path) - 1);
+	long_path[sizeof (long_path) - 1] = '\0';
+
+	P_TEST_CHECK (p_socket_address_new_unix (long_path) == NULL);
+
+	addr1 = p_socket_address_new_unix ("psocketaddress_test.sock");
+	P_TEST_REQUIRE (addr1 != NULL);
+
+	P_TEST_CHECK (p_socket_address_get_family (addr1) == P_SOCKET_FAMILY_UNIX);
+	P_TEST_CHECK (p_socket_address_get_port (addr1) == 0);
+	P_TEST_CHECK (p_socket_address_is_any (addr1) == FALSE);
+	P_TEST_CHECK (p_socket_address_is_loopback (addr1) == FALSE);
+	P_TEST_CHECK (p_socket_address_is_unix_abstract (addr1) == FALSE);
+
+	str = p_socket_address_get_address (addr1);
+	P_TEST_REQUIRE (str != NULL);
+	P_TEST_CHECK (strcmp (str, "psocketaddress_test.sock") == 0);
+	p_free (str);
+
+	/* Round trip through the native structure */
+	native_size = p_socket_address_get_native_size (addr1);
+	P_TEST_REQUIRE (native_size > 0 && native_size <= sizeof (native));
+	P_TEST_CHECK (p_socket_address_to_native (addr1, native, native_size - 1) == FALSE);
+	P_TEST_CHECK (p_socket_address_to_native (addr1, native, native_size) == TRUE);
+
+	addr2 = p_socket_address_new_from_native (native, native_size);
+	P_TEST_REQUIRE (addr2 != NULL);
+	P_TEST_CHECK (p_socket_address_equal (addr1, addr2) == TRUE);
+	P_TEST_CHECK (p_socket_address_hash (addr1) == p_socket_address_hash (addr2));
+	p_socket_address_free (addr2);
+
+	addr2 = p_socket_address_new_unix ("psocketaddress_test.sock2");
+	P_TEST_REQUIRE (addr2 != NULL);
+	P_TEST_CHECK (p_socket_address_equal (addr1, addr2) == FALSE);
+	P_TEST_CHECK (p_socket_address_compare (addr1, addr2) < 0);
+	p_socket_address_free (addr2);
+
+	addr2 = p_socket_address_new_unix_abstract ("psocketaddress_test.sock");
+
+#ifdef P_OS_LINUX
+	P_TEST_REQUIRE (addr2 != NULL);
+	P_TEST_CHECK (p_socket_address_is_unix_abstract (addr2) == TRUE);
+	P_TEST_CHECK (p_socket_address_equal (addr1, addr2) == FALSE);
+
+	str = p_socket_address_get_address (addr2);
+	P_TEST_REQUIRE (str != NULL);
+	P_TEST_CHECK (strcmp (str, "psocketaddress_test.sock") == 0);
+	p_free (str);
+
+	native_size = p_socket_address_get_native_size (addr2);
+	P_TEST_CHECK (p_socket_address_to_native (addr2, native, native_size) == TRUE);
+
+	addr3 = p_socket_address_new_from_native (native, native_size);
+	P_TEST_REQUIRE (addr3 != NULL);
+	P_TEST_CHECK (p_socket_address_is_unix_abstract (addr3) == TRUE);
+	P_TEST_CHECK (p_socket_address_equal (addr2, addr3) == TRUE);
+	p_socket_address_free (addr3);
+	p_socket_address_free (addr2);
+#else
+	P_TEST_CHECK (addr2 == NULL);
+#endif
+
+	/* Unbound socket address consists of the family only */
+	P_TEST_CHECK (p_socket_address_to_native (addr1, native, sizeof (native)) == TRUE);
+
+	addr3 = p_socket_address_new_from_native (native, p_socket_address_get_native_size (addr1) -
+							  strlen ("psocketaddress_test.sock") - 1);
+	P_TEST_REQUIRE (addr3 != NULL);
+	P_TEST_CHECK (p_socket_address_get_family (addr3) == P_SOCKET_FAMILY_UNIX);
+	P_TEST_CHECK (p_socket_address_is_unix_abstract (addr3) == FALSE);
+
+	str = p_socket_address_get_address (addr3);
+	P_TEST_REQUIRE (str != NULL);
+	P_TEST_CHECK (str[0] == '\0');
+	p_free (str);
+
+	p_socket_address_free (addr3);
+	p_socket_address_free (addr1);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
 P_TEST_SUITE_BEGIN()
 {
 	P_TEST_SUITE_RUN_CASE (psocketaddress_nomem_test);
 	P_TEST_SUITE_RUN_CASE (psocketaddress_bad_input_test);
 	P_TEST_SUITE_RUN_CASE (psocketaddress_general_test);
+	P_TEST_SUITE_RUN_CASE (psocketaddress_compare_test);
+	P_TEST_SUITE_RUN_CASE (psocketaddress_unix_test);
 }
 P_TEST_SUITE_END()
@@ -0,0 +1,568 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <string.h>
+
+P_TEST_MODULE_INIT ();
+
+#define PSOCKETASYNC_TEST_COMPLETIONS	8
+#define PSOCKETASYNC_TEST_FILE		"." P_DIR_SEPARATOR "psocketasync_test_file.bin"
+#define PSOCKETASYNC_TEST_FILE_BLOCKS	16
+#define PSOCKETASYNC_TEST_FILE_BLOCK	4096
+
+static pchar socket_data[] = "This is an asynchronous socket test data!";
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static PSocket * create_tcp_server (void)
+{
+	PSocket *socket = p_socket_new (P_SOCKET_FAMILY_INET,
+					P_SOCKET_TYPE_STREAM,
+					P_SOCKET_PROTOCOL_TCP,
+					NULL);
+
+	if (socket == NULL)
+		return NULL;
+
+	PSocketAddress *addr = p_socket_address_new ("127.0.0.1", 0);
+
+	if (addr == NULL || !p_socket_bind (socket, addr, TRUE, NULL) || !p_socket_listen (socket, NULL)) {
+		p_socket_address_free (addr);
+		p_socket_free (socket);
+		return NULL;
+	}
+
+	p_socket_address_free (addr);
+
+	return socket;
+}
+
+/* Waits for the given number of completions, returns actual number */
+static pint wait_completions (PSocketAsync		*async,
+			      PSocketAsyncCompletion	*completions,
+			      pint			count)
+{
+	pint total = 0;
+
+	while (total < count) {
+		pint ret = p_socket_async_wait (async,
+						completions + total,
+						count - total,
+						5000,
+						NULL);
+
+		if (ret <= 0)
+			break;
+
+		total += ret;
+	}
+
+	return total;
+}
+
+static const PSocketAsyncCompletion * find_completion (const PSocketAsyncCompletion	*completions,
+						       pint				count,
+						       PSocketAsyncOperation		operation)
+{
+	for (pint i = 0; i < count; ++i) {
+		if (completions[i].operation == operation)
+			return &completions[i];
+	}
+
+	return NULL;
+}
+
+/* Connects a client to the server through the queue, returns the accepted socket */
+static PSocket * connect_client (PSocketAsync *async, PSocket *server, PSocket *client)
+{
+	PSocketAsyncCompletion	completions[PSOCKETASYNC_TEST_COMPLETIONS];
+	PSocketAddress		*addr = p_socket_get_local_address (server, NULL);
+
+	if (addr == NULL)
+		return NULL;
+
+	pboolean submitted = p_socket_async_submit_accept (async, server, server, NULL) &&
+			     p_socket_async_submit_connect (async, client, addr, client, NULL);
+
+	p_socket_address_free (addr);
+
+	if (!submitted || wait_completions (async, completions, 2) != 2)
+		return NULL;
+
+	const PSocketAsyncCompletion *accepted = find_completion (completions,
+								  2,
+								  P_SOCKET_ASYNC_OPERATION_ACCEPT);
+	const PSocketAsyncCompletion *connected = find_completion (completions,
+								   2,
+								   P_SOCKET_ASYNC_OPERATION_CONNECT);
+
+	if (accepted == NULL || connected == NULL)
+		return NULL;
+
+	if (accepted->socket != server || accepted->user_data != server ||
+	    accepted->error_code != P_ERROR_IO_NONE || accepted->accepted == NULL) {
+		p_socket_free (accepted->accepted);
+		return NULL;
+	}
+
+	if (connected->socket != client || connected->user_data != client ||
+	    connected->error_code != P_ERROR_IO_NONE || connected->result != 0 ||
+	    !p_socket_is_connected (client)) {
+		p_socket_free (accepted->accepted);
+		return NULL;
+	}
+
+	return accepted->accepted;
+}
+
+P_TEST_CASE_BEGIN (psocketasync_nomem_test)
+{
+	p_libsys_init ();
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	PSocketAsync *async = p_socket_async_new (0, NULL);
+	P_TEST_REQUIRE (async != NULL);
+
+	PSocketVector buffer;
+
+	buffer.buffer = socket_data;
+	buffer.buflen = sizeof (socket_data);
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (p_socket_async_new (0, NULL) == NULL);
+	P_TEST_CHECK (p_socket_async_register_buffers (async, &buffer, 1, NULL) == FALSE);
+
+	p_mem_restore_vtable ();
+
+	P_TEST_CHECK (p_socket_async_get_pending (async) == 0);
+
+	p_socket_async_free (async);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (psocketasync_bad_input_test)
+{
+	p_libsys_init ();
+
+	PSocketAsyncCompletion	completion;
+	PSocketVector		buffer;
+	pchar			data[16];
+
+	buffer.buffer = data;
+	buffer.buflen = sizeof (data);
+
+	P_TEST_CHECK (p_socket_async_new (-1, NULL) == NULL);
+	P_TEST_CHECK (p_socket_async_new (32769, NULL) == NULL);
+	P_TEST_CHECK (p_socket_async_is_native (NULL) == FALSE);
+	P_TEST_CHECK (p_socket_async_register_buffers (NULL, &buffer, 1, NULL) == FALSE);
+	P_TEST_CHECK (p_socket_async_submit_accept (NULL, NULL, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_socket_async_submit_connect (NULL, NULL, NULL, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_socket_async_submit_receive (NULL, NULL, NULL, 0, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_socket_async_submit_send (NULL, NULL, NULL, 0, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_socket_async_submit_receive_fixed (NULL, NULL, 0, 0, 0, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_socket_async_submit_send_fixed (NULL, NULL, 0, 0, 0, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_socket_async_get_pending (NULL) == 0);
+	P_TEST_CHECK (p_socket_async_wait (NULL, &completion, 1, 0, NULL) == -1);
+
+	p_socket_async_free (NULL);
+
+	PSocketAsync *async = p_socket_async_new (1, NULL);
+	P_TEST_REQUIRE (async != NULL);
+
+	PSocket *server = create_tcp_server ();
+	P_TEST_REQUIRE (server != NULL);
+
+	PError *error = NULL;
+
+	P_TEST_CHECK (p_socket_async_register_buffers (async, NULL, 1, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_INVALID_ARGUMENT);
+	p_error_free (error);
+	error = NULL;
+
+	buffer.buflen = 0;
+	P_TEST_CHECK (p_socket_async_register_buffers (async, &buffer, 1, NULL) == FALSE);
+	buffer.buflen = sizeof (data);
+
+	P_TEST_CHECK (p_socket_async_submit_connect (async, server, NULL, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_socket_async_submit_receive (async, server, NULL, 1, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_socket_async_submit_send (async, server, data, 0, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_socket_async_submit_receive_fixed (async, server, 0, 0, 1, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_socket_async_wait (async, NULL, 1, 0, NULL) == -1);
+	P_TEST_CHECK (p_socket_async_wait (async, &completion, 0, 0, NULL) == -1);
+
+	/* Nothing to wait for */
+	P_TEST_CHECK (p_socket_async_wait (async, &completion, 1, -1, NULL) == 0);
+
+	P_TEST_CHECK (p_socket_async_register_buffers (async, &buffer, 1, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_async_submit_send_fixed (async, server, 1, 0, 1, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_socket_async_submit_send_fixed (async, server, 0, 0, 0, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_socket_async_submit_send_fixed (async, server, 0, 1, sizeof (data), NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_socket_async_submit_send_fixed (async, server, 0, sizeof (data) + 1, 0, NULL, NULL) == FALSE);
+
+	/* Queue holds only one operation */
+	P_TEST_CHECK (p_socket_async_submit_accept (async, server, NULL, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_async_get_pending (async) == 1);
+	P_TEST_CHECK (p_socket_async_submit_accept (async, server, NULL, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_NO_RESOURCES);
+	p_error_free (error);
+	error = NULL;
+
+	/* Buffers can't be changed with the pending operations */
+	P_TEST_CHECK (p_socket_async_register_buffers (async, NULL, 0, NULL) == FALSE);
+
+	P_TEST_CHECK (p_socket_async_wait (async, &completion, 1, 0, NULL) == 0);
+	P_TEST_CHECK (p_socket_async_get_pending (async) == 1);
+
+	/* Pending operation is cancelled */
+	p_socket_async_free (async);
+	p_socket_free (server);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (psocketasync_tcp_test)
+{
+	p_libsys_init ();
+
+	PSocketAsyncCompletion	completions[PSOCKETASYNC_TEST_COMPLETIONS];
+	pchar			buffer[sizeof (socket_data)];
+
+	PSocketAsync *async = p_socket_async_new (16, NULL);
+	P_TEST_REQUIRE (async != NULL);
+
+	PSocket *server = create_tcp_server ();
+	P_TEST_REQUIRE (server != NULL);
+
+	PSocket *client = p_socket_new (P_SOCKET_FAMILY_INET,
+					P_SOCKET_TYPE_STREAM,
+					P_SOCKET_PROTOCOL_TCP,
+					NULL);
+	P_TEST_REQUIRE (client != NULL);
+
+	PSocket *accepted = connect_client (async, server, client);
+	P_TEST_REQUIRE (accepted != NULL);
+	P_TEST_CHECK (p_socket_async_get_pending (async) == 0);
+
+	/* Nothing to receive yet */
+	memset (buffer, 0, sizeof (buffer));
+
+	P_TEST_CHECK (p_socket_async_submit_receive (async, accepted, buffer, sizeof (buffer), buffer, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_async_wait (async, completions, PSOCKETASYNC_TEST_COMPLETIONS, 100, NULL) == 0);
+	P_TEST_CHECK (p_socket_async_get_pending (async) == 1);
+
+	P_TEST_CHECK (p_socket_async_submit_send (async,
+						  client,
+						  socket_data,
+						  sizeof (socket_data),
+						  socket_data,
+						  NULL) == TRUE);
+	P_TEST_CHECK (p_socket_async_get_pending (async) == 2);
+
+	pint total = wait_completions (async, completions, 2);
+	P_TEST_CHECK (total == 2);
+	P_TEST_CHECK (p_socket_async_get_pending (async) == 0);
+
+	const PSocketAsyncCompletion *sent = find_completion (completions,
+							      total,
+							      P_SOCKET_ASYNC_OPERATION_SEND);
+	const PSocketAsyncCompletion *received = find_completion (completions,
+								  total,
+								  P_SOCKET_ASYNC_OPERATION_RECEIVE);
+
+	P_TEST_REQUIRE (sent != NULL);
+	P_TEST_REQUIRE (received != NULL);
+
+	P_TEST_CHECK (sent->socket == client);
+	P_TEST_CHECK (sent->user_data == socket_data);
+	P_TEST_CHECK (sent->error_code == P_ERROR_IO_NONE);
+	P_TEST_CHECK (sent->result == (pssize) sizeof (socket_data));
+	P_TEST_CHECK (sent->accepted == NULL);
+
+	P_TEST_CHECK (received->socket == accepted);
+	P_TEST_CHECK (received->user_data == buffer);
+	P_TEST_CHECK (received->error_code == P_ERROR_IO_NONE);
+	P_TEST_CHECK (received->result == (pssize) sizeof (socket_data));
+	P_TEST_CHECK (memcmp (buffer, socket_data, sizeof (socket_data)) == 0);
+
+	/* Peer close is reported as an empty receive */
+	P_TEST_CHECK (p_socket_async_submit_receive (async, accepted, buffer, sizeof (buffer), NULL, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_close (client, NULL) == TRUE);
+
+	P_TEST_CHECK (wait_completions (async, completions, 1) == 1);
+	P_TEST_CHECK (completions[0].error_code == P_ERROR_IO_NONE);
+	P_TEST_CHECK (completions[0].result == 0);
+
+	p_socket_async_free (async);
+
+	p_socket_free (accepted);
+	p_socket_free (client);
+	p_socket_free (server);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (psocketasync_fixed_test)
+{
+	p_libsys_init ();
+
+	PSocketAsyncCompletion	completions[PSOCKETASYNC_TEST_COMPLETIONS];
+	PSocketVector		buffers[2];
+	pchar			send_buffer[sizeof (socket_data)];
+	pchar			receive_buffer[sizeof (socket_data) * 2];
+
+	PSocketAsync *async = p_socket_async_new (0, NULL);
+	P_TEST_REQUIRE (async != NULL);
+
+	memcpy (send_buffer, socket_data, sizeof (socket_data));
+	memset (receive_buffer, 0, sizeof (receive_buffer));
+
+	buffers[0].buffer = send_buffer;
+	buffers[0].buflen = sizeof (send_buffer);
+	buffers[1].buffer = receive_buffer;
+	buffers[1].buflen = sizeof (receive_buffer);
+
+	P_TEST_CHECK (p_socket_async_register_buffers (async, buffers, 2, NULL) == TRUE);
+
+	PSocket *server = create_tcp_server ();
+	P_TEST_REQUIRE (server != NULL);
+
+	PSocket *client = p_socket_new (P_SOCKET_FAMILY_INET,
+					P_SOCKET_TYPE_STREAM,
+					P_SOCKET_PROTOCOL_TCP,
+					NULL);
+	P_TEST_REQUIRE (client != NULL);
+
+	p_socket_set_blocking (client, FALSE);
+
+	PSocket *accepted = connect_client (async, server, client);
+	P_TEST_REQUIRE (accepted != NULL);
+
+	P_TEST_CHECK (p_socket_async_submit_receive_fixed (async,
+							   accepted,
+							   1,
+							   sizeof (socket_data),
+							   sizeof (socket_data),
+							   NULL,
+							   NULL) == TRUE);
+	P_TEST_CHECK (p_socket_async_submit_send_fixed (async,
+							client,
+							0,
+							0,
+							sizeof (socket_data),
+							NULL,
+							NULL) == TRUE);
+
+	pint total = wait_completions (async, completions, 2);
+	P_TEST_CHECK (total == 2);
+
+	const PSocketAsyncCompletion *sent = find_completion (completions,
+							      total,
+							      P_SOCKET_ASYNC_OPERATION_SEND);
+	const PSocketAsyncCompletion *received = find_completion (completions,
+								  total,
+								  P_SOCKET_ASYNC_OPERATION_RECEIVE);
+
+	P_TEST_REQUIRE (sent != NULL);
+	P_TEST_REQUIRE (received != NULL);
+
+	P_TEST_CHECK (sent->result == (pssize) sizeof (socket_data));
+	P_TEST_CHECK (received->result == (pssize) sizeof (socket_data));
+	P_TEST_CHECK (memcmp (receive_buffer + sizeof (socket_data), socket_data, sizeof (socket_data)) == 0);
+
+	/* Unregister buffers */
+	P_TEST_CHECK (p_socket_async_register_buffers (async, NULL, 0, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_async_submit_send_fixed (async, client, 0, 0, 1, NULL, NULL) == FALSE);
+
+	p_socket_async_free (async);
+
+	p_socket_free (accepted);
+	p_socket_free (client);
+	p_socket_free (server);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (psocketasync_file_test)
+{
+	p_libsys_init ();
+
+	PSocketAsyncCompletion	completions[PSOCKETASYNC_TEST_FILE_BLOCKS];
+	pchar			*data;
+	pchar			*read_data;
+	pchar			tail[16];
+	PError			*error = NULL;
+
+	data      = (pchar *) p_malloc (PSOCKETASYNC_TEST_FILE_BLOCKS * PSOCKETASYNC_TEST_FILE_BLOCK);
+	read_data = (pchar *) p_malloc0 (PSOCKETASYNC_TEST_FILE_BLOCKS * PSOCKETASYNC_TEST_FILE_BLOCK);
+	P_TEST_REQUIRE (data != NULL && read_data != NULL);
+
+	for (pint i = 0; i < PSOCKETASYNC_TEST_FILE_BLOCKS * PSOCKETASYNC_TEST_FILE_BLOCK; ++i)
+		data[i] = (pchar) (i * 7 + i / PSOCKETASYNC_TEST_FILE_BLOCK);
+
+	p_file_remove (PSOCKETASYNC_TEST_FILE, NULL);
+
+	PFile *file = p_file_new (PSOCKETASYNC_TEST_FILE,
+				  P_FILE_OPEN_FLAG_READ | P_FILE_OPEN_FLAG_WRITE | P_FILE_OPEN_FLAG_CREATE,
+				  NULL);
+	P_TEST_REQUIRE (file != NULL);
+
+	PSocketAsync *async = p_socket_async_new (PSOCKETASYNC_TEST_FILE_BLOCKS, NULL);
+	P_TEST_REQUIRE (async != NULL);
+
+	P_TEST_CHECK (p_socket_async_submit_file_read (NULL, file, tail, 1, 0, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_socket_async_submit_file_read (async, NULL, tail, 1, 0, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_socket_async_submit_file_read (async, file, NULL, 1, 0, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_socket_async_submit_file_write (async, file, tail, 0, 0, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_socket_async_submit_file_write (async, file, tail, 1, P_MAXUINT64, NULL, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_INVALID_ARGUMENT);
+	p_error_free (error);
+	error = NULL;
+	P_TEST_CHECK (p_socket_async_submit_file_sync (async, NULL, FALSE, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_socket_async_get_pending (async) == 0);
+
+	/* Blocks are written in the reverse order */
+	for (pint i = PSOCKETASYNC_TEST_FILE_BLOCKS - 1; i >= 0; --i)
+		P_TEST_CHECK (p_socket_async_submit_file_write (async,
+								file,
+								data + i * PSOCKETASYNC_TEST_FILE_BLOCK,
+								PSOCKETASYNC_TEST_FILE_BLOCK,
+								(puint64) i * PSOCKETASYNC_TEST_FILE_BLOCK,
+								P_INT_TO_POINTER (i + 1),
+								NULL) == TRUE);
+
+	P_TEST_CHECK (p_socket_async_get_pending (async) == PSOCKETASYNC_TEST_FILE_BLOCKS);
+
+	/* Queue is full */
+	P_TEST_CHECK (p_socket_async_submit_file_sync (async, file, TRUE, NULL, NULL) == FALSE);
+
+	P_TEST_CHECK (wait_completions (async, completions, PSOCKETASYNC_TEST_FILE_BLOCKS) ==
+		      PSOCKETASYNC_TEST_FILE_BLOCKS);
+	P_TEST_CHECK (p_socket_async_get_pending (async) == 0);
+
+	pint seen = 0;
+
+	for (pint i = 0; i < PSOCKETASYNC_TEST_FILE_BLOCKS; ++i) {
+		pint idx = P_POINTER_TO_INT (completions[i].user_data) - 1;
+
+		P_TEST_CHECK (completions[i].operation == P_SOCKET_ASYNC_OPERATION_FILE_WRITE);
+		P_TEST_CHECK (completions[i].file == file);
+		P_TEST_CHECK (completions[i].socket == NULL);
+		P_TEST_CHECK (completions[i].error_code == P_ERROR_IO_NONE);
+		P_TEST_CHECK (completions[i].result == PSOCKETASYNC_TEST_FILE_BLOCK);
+		P_TEST_REQUIRE (idx >= 0 && idx < PSOCKETASYNC_TEST_FILE_BLOCKS);
+
+		seen |= 1 << idx;
+	}
+
+	P_TEST_CHECK (seen == (1 << PSOCKETASYNC_TEST_FILE_BLOCKS) - 1);
+
+	P_TEST_CHECK (p_socket_async_submit_file_sync (async, file, TRUE, file, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_async_submit_file_sync (async, file, FALSE, file, NULL) == TRUE);
+	P_TEST_CHECK (wait_completions (async, completions, 2) == 2);
+
+	for (pint i = 0; i < 2; ++i) {
+		P_TEST_CHECK (completions[i].operation == P_SOCKET_ASYNC_OPERATION_FILE_SYNC);
+		P_TEST_CHECK (completions[i].user_data == file);
+		P_TEST_CHECK (completions[i].result == 0);
+		P_TEST_CHECK (completions[i].error_code == P_ERROR_IO_NONE);
+	}
+
+	P_TEST_CHECK (p_file_get_size (file, NULL) == PSOCKETASYNC_TEST_FILE_BLOCKS * PSOCKETASYNC_TEST_FILE_BLOCK);
+
+	/* Read back in two halves and beyond the end */
+	psize half = PSOCKETASYNC_TEST_FILE_BLOCKS * PSOCKETASYNC_TEST_FILE_BLOCK / 2;
+
+	P_TEST_CHECK (p_socket_async_submit_file_read (async, file, read_data, half, 0, NULL, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_async_submit_file_read (async, file, read_data + half, half, half, NULL, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_async_submit_file_read (async, file, tail, sizeof (tail), half * 2, tail, NULL) == TRUE);
+	P_TEST_CHECK (wait_completions (async, completions, 3) == 3);
+
+	for (pint i = 0; i < 3; ++i) {
+		P_TEST_CHECK (completions[i].operation == P_SOCKET_ASYNC_OPERATION_FILE_READ);
+		P_TEST_CHECK (completions[i].error_code == P_ERROR_IO_NONE);
+		P_TEST_CHECK (completions[i].result == (completions[i].user_data == tail ? 0 : (pssize) half));
+	}
+
+	P_TEST_CHECK (memcmp (data, read_data, half * 2) == 0);
+
+	/* Nothing to wait for */
+	P_TEST_CHECK (p_socket_async_wait (async, completions, 1, 0, NULL) == 0);
+
+	/* Freeing waits for the operations in progress */
+	P_TEST_CHECK (p_socket_async_submit_file_write (async, file, data, half, 0, NULL, NULL) == TRUE);
+	p_socket_async_free (async);
+
+	p_file_free (file);
+	P_TEST_CHECK (p_file_remove (PSOCKETASYNC_TEST_FILE, NULL) == TRUE);
+
+	p_free (data);
+	p_free (read_data);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (psocketasync_nomem_test);
+	P_TEST_SUITE_RUN_CASE (psocketasync_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (psocketasync_tcp_test);
+	P_TEST_SUITE_RUN_CASE (psocketasync_fixed_test);
+	P_TEST_SUITE_RUN_CASE (psocketasync_file_test);
+}
+P_TEST_SUITE_END()
@@ -0,0 +1,485 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <string.h>
+
+P_TEST_MODULE_INIT ();
+
+#define PSOCKETPOLLER_TEST_SOCKETS	64
+
+static pchar socket_data[] = "This is a socket poller test data!";
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static PSocket * create_udp_socket (void)
+{
+	PSocket *socket = p_socket_new (P_SOCKET_FAMILY_INET,
+					P_SOCKET_TYPE_DATAGRAM,
+					P_SOCKET_PROTOCOL_UDP,
+					NULL);
+
+	if (socket == NULL)
+		return NULL;
+
+	PSocketAddress *addr = p_socket_address_new ("127.0.0.1", 0);
+
+	if (addr == NULL || !p_socket_bind (socket, addr, FALSE, NULL)) {
+		p_socket_address_free (addr);
+		p_socket_free (socket);
+		return NULL;
+	}
+
+	p_socket_address_free (addr);
+	p_socket_set_blocking (socket, FALSE);
+
+	return socket;
+}
+
+static pboolean send_to_socket (PSocket *sender, PSocket *receiver)
+{
+	PSocketAddress *addr = p_socket_get_local_address (receiver, NULL);
+
+	if (addr == NULL)
+		return FALSE;
+
+	pssize sent = p_socket_send_to (sender, addr, socket_data, sizeof (socket_data), NULL);
+
+	p_socket_address_free (addr);
+
+	return sent == (pssize) sizeof (socket_data);
+}
+
+static const PSocketPollerEvent * find_event (const PSocketPollerEvent	*events,
+					      pint			n_events,
+					      const PSocket		*socket)
+{
+	for (pint i = 0; i < n_events; ++i) {
+		if (events[i].socket == socket)
+			return &events[i];
+	}
+
+	return NULL;
+}
+
+P_TEST_CASE_BEGIN (psocketpoller_nomem_test)
+{
+	p_libsys_init ();
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	PSocket *socket = create_udp_socket ();
+	P_TEST_REQUIRE (socket != NULL);
+
+	PSocketPoller *poller = p_socket_poller_new (NULL);
+	P_TEST_REQUIRE (poller != NULL);
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (p_socket_poller_new (NULL) == NULL);
+	P_TEST_CHECK (p_socket_poller_add (poller,
+					   socket,
+					   P_SOCKET_POLLER_CONDITION_IN,
+					   P_SOCKET_POLLER_FLAG_NONE,
+					   NULL,
+					   NULL) == FALSE);
+
+	p_mem_restore_vtable ();
+
+	P_TEST_CHECK (p_socket_poller_get_count (poller) == 0);
+
+	p_socket_poller_free (poller);
+	p_socket_free (socket);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (psocketpoller_bad_input_test)
+{
+	p_libsys_init ();
+
+	PSocketPollerEvent	events[4];
+	PError			*error = NULL;
+
+	P_TEST_CHECK (p_socket_poller_add (NULL, NULL, 0, 0, NULL, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+	error = NULL;
+
+	P_TEST_CHECK (p_socket_poller_modify (NULL, NULL, 0, 0, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_socket_poller_remove (NULL, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_socket_poller_get_count (NULL) == 0);
+	P_TEST_CHECK (p_socket_poller_wait (NULL, events, 4, 0, NULL) == -1);
+
+	p_socket_poller_free (NULL);
+
+	PSocketPoller *poller = p_socket_poller_new (NULL);
+	P_TEST_REQUIRE (poller != NULL);
+
+	PSocket *socket = create_udp_socket ();
+	P_TEST_REQUIRE (socket != NULL);
+
+	P_TEST_CHECK (p_socket_poller_wait (poller, NULL, 4, 0, NULL) == -1);
+	P_TEST_CHECK (p_socket_poller_wait (poller, events, 0, 0, NULL) == -1);
+	P_TEST_CHECK (p_socket_poller_wait (poller, events, 4, -1, NULL) == 0);
+
+	P_TEST_CHECK (p_socket_poller_add (poller, socket, 16, 0, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_socket_poller_add (poller, socket, P_SOCKET_POLLER_CONDITION_ERROR, 0, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_socket_poller_add (poller, socket, P_SOCKET_POLLER_CONDITION_IN, 2, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_socket_poller_modify (poller, socket, P_SOCKET_POLLER_CONDITION_IN, 0, NULL, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+	error = NULL;
+
+	P_TEST_CHECK (p_socket_poller_remove (poller, socket, NULL) == FALSE);
+
+	P_TEST_CHECK (p_socket_poller_add (poller, socket, P_SOCKET_POLLER_CONDITION_IN, 0, NULL, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_poller_add (poller, socket, P_SOCKET_POLLER_CONDITION_IN, 0, NULL, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+
+	P_TEST_CHECK (p_socket_poller_modify (poller, socket, 16, 0, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_socket_poller_get_count (poller) == 1);
+
+	p_socket_poller_free (poller);
+	p_socket_free (socket);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (psocketpoller_udp_test)
+{
+	p_libsys_init ();
+
+	PSocketPollerEvent	events[4];
+	pchar			buf[64];
+	pint			n_events;
+	pint			user_data1 = 1;
+	pint			user_data2 = 2;
+
+	PSocket *socket1 = create_udp_socket ();
+	PSocket *socket2 = create_udp_socket ();
+
+	P_TEST_REQUIRE (socket1 != NULL);
+	P_TEST_REQUIRE (socket2 != NULL);
+
+	PSocketPoller *poller = p_socket_poller_new (NULL);
+	P_TEST_REQUIRE (poller != NULL);
+
+	P_TEST_CHECK (p_socket_poller_add (poller,
+					   socket1,
+					   P_SOCKET_POLLER_CONDITION_IN,
+					   P_SOCKET_POLLER_FLAG_NONE,
+					   &user_data1,
+					   NULL) == TRUE);
+	P_TEST_CHECK (p_socket_poller_add (poller,
+					   socket2,
+					   P_SOCKET_IO_CONDITION_POLLIN,
+					   P_SOCKET_POLLER_FLAG_NONE,
+					   &user_data2,
+					   NULL) == TRUE);
+	P_TEST_CHECK (p_socket_poller_get_count (poller) == 2);
+
+	/* Nothing to read yet */
+	P_TEST_CHECK (p_socket_poller_wait (poller, events, 4, 0, NULL) == 0);
+	P_TEST_CHECK (p_socket_poller_wait (poller, events, 4, 50, NULL) == 0);
+
+	P_TEST_REQUIRE (send_to_socket (socket1, socket2));
+
+	n_events = p_socket_poller_wait (poller, events, 4, 5000, NULL);
+
+	P_TEST_REQUIRE (n_events == 1);
+	P_TEST_CHECK (events[0].socket == socket2);
+	P_TEST_CHECK (events[0].user_data == &user_data2);
+	P_TEST_CHECK ((events[0].conditions & P_SOCKET_POLLER_CONDITION_IN) != 0);
+	P_TEST_CHECK ((events[0].conditions & P_SOCKET_POLLER_CONDITION_OUT) == 0);
+
+	/* Level-triggered sockets are reported until drained */
+	P_TEST_CHECK (p_socket_poller_wait (poller, events, 4, 0, NULL) == 1);
+
+	/* Datagram sockets are always writable */
+	P_TEST_CHECK (p_socket_poller_modify (poller,
+					      socket1,
+					      P_SOCKET_POLLER_CONDITION_IN | P_SOCKET_POLLER_CONDITION_OUT,
+					      P_SOCKET_POLLER_FLAG_NONE,
+					      &user_data2,
+					      NULL) == TRUE);
+
+	n_events = p_socket_poller_wait (poller, events, 4, 5000, NULL);
+
+	P_TEST_REQUIRE (n_events == 2);
+
+	const PSocketPollerEvent *event1 = find_event (events, n_events, socket1);
+	const PSocketPollerEvent *event2 = find_event (events, n_events, socket2);
+
+	P_TEST_REQUIRE (event1 != NULL);
+	P_TEST_REQUIRE (event2 != NULL);
+
+	P_TEST_CHECK (event1->user_data == &user_data2);
+	P_TEST_CHECK (event1->conditions == P_SOCKET_POLLER_CONDITION_OUT);
+	P_TEST_CHECK (event2->conditions == P_SOCKET_POLLER_CONDITION_IN);
+
+	/* Batches are limited by the array size */
+	P_TEST_CHECK (p_socket_poller_wait (poller, events, 1, 0, NULL) == 1);
+
+	P_TEST_CHECK (p_socket_poller_remove (poller, socket1, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_poller_get_count (poller) == 1);
+
+	P_TEST_CHECK (p_socket_receive (socket2, buf, sizeof (buf), NULL) == (pssize) sizeof (socket_data));
+	P_TEST_CHECK (p_socket_poller_wait (poller, events, 4, 0, NULL) == 0);
+
+	/* Edge-triggered sockets are reported on changes */
+	P_TEST_CHECK (p_socket_poller_modify (poller,
+					      socket2,
+					      P_SOCKET_POLLER_CONDITION_IN,
+					      P_SOCKET_POLLER_FLAG_EDGE_TRIGGERED,
+					      &user_data1,
+					      NULL) == TRUE);
+
+	P_TEST_REQUIRE (send_to_socket (socket1, socket2));
+
+	n_events = p_socket_poller_wait (poller, events, 4, 5000, NULL);
+
+	P_TEST_REQUIRE (n_events == 1);
+	P_TEST_CHECK (events[0].socket == socket2);
+	P_TEST_CHECK (events[0].user_data == &user_data1);
+
+	P_TEST_CHECK (p_socket_receive (socket2, buf, sizeof (buf), NULL) == (pssize) sizeof (socket_data));
+	P_TEST_CHECK (p_socket_poller_wait (poller, events, 4, 0, NULL) == 0);
+
+	P_TEST_CHECK (p_socket_poller_remove (poller, socket2, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_poller_get_count (poller) == 0);
+
+	p_socket_poller_free (poller);
+
+	p_socket_free (socket1);
+	p_socket_free (socket2);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (psocketpoller_tcp_test)
+{
+	p_libsys_init ();
+
+	PSocketPollerEvent	events[4];
+	pchar			buf[64];
+
+	PSocket *server = p_socket_new (P_SOCKET_FAMILY_INET,
+					P_SOCKET_TYPE_STREAM,
+					P_SOCKET_PROTOCOL_TCP,
+					NULL);
+	P_TEST_REQUIRE (server != NULL);
+
+	PSocketAddress *addr = p_socket_address_new ("127.0.0.1", 0);
+	P_TEST_REQUIRE (addr != NULL);
+
+	P_TEST_REQUIRE (p_socket_bind (server, addr, FALSE, NULL) == TRUE);
+	P_TEST_REQUIRE (p_socket_listen (server, NULL) == TRUE);
+
+	p_socket_address_free (addr);
+
+	PSocketPoller *poller = p_socket_poller_new (NULL);
+	P_TEST_REQUIRE (poller != NULL);
+
+	P_TEST_CHECK (p_socket_poller_add (poller,
+					   server,
+					   P_SOCKET_POLLER_CONDITION_IN,
+					   P_SOCKET_POLLER_FLAG_NONE,
+					   server,
+					   NULL) == TRUE);
+
+	P_TEST_CHECK (p_socket_poller_wait (poller, events, 4, 0, NULL) == 0);
+
+	PSocket *client = p_socket_new (P_SOCKET_FAMILY_INET,
+					P_SOCKET_TYPE_STREAM,
+					P_SOCKET_PROTOCOL_TCP,
+					NULL);
+	P_TEST_REQUIRE (client != NULL);
+
+	addr = p_socket_get_local_address (server, NULL);
+	P_TEST_REQUIRE (addr != NULL);
+	P_TEST_CHECK (p_socket_connect (client, addr, NULL) == TRUE);
+	p_socket_address_free (addr);
+
+	/* Incoming connection */
+	P_TEST_REQUIRE (p_socket_poller_wait (poller, events, 4, 5000, NULL) == 1);
+	P_TEST_CHECK (events[0].socket == server);
+	P_TEST_CHECK (events[0].user_data == server);
+	P_TEST_CHECK ((events[0].conditions & P_SOCKET_POLLER_CONDITION_IN) != 0);
+
+	PSocket *conn = p_socket_accept (server, NULL);
+	P_TEST_REQUIRE (conn != NULL);
+
+	p_socket_set_blocking (conn, FALSE);
+
+	P_TEST_CHECK (p_socket_poller_remove (poller, server, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_poller_add (poller,
+					   conn,
+					   P_SOCKET_POLLER_CONDITION_IN,
+					   P_SOCKET_POLLER_FLAG_EDGE_TRIGGERED,
+					   conn,
+					   NULL) == TRUE);
+
+	P_TEST_CHECK (p_socket_poller_wait (poller, events, 4, 0, NULL) == 0);
+
+	/* Incoming data */
+	P_TEST_CHECK (p_socket_send (client, socket_data, sizeof (socket_data), NULL) == (pssize) sizeof (socket_data));
+
+	P_TEST_REQUIRE (p_socket_poller_wait (poller, events, 4, 5000, NULL) == 1);
+	P_TEST_CHECK (events[0].socket == conn);
+	P_TEST_CHECK ((events[0].conditions & P_SOCKET_POLLER_CONDITION_IN) != 0);
+
+	P_TEST_CHECK (p_socket_receive (conn, buf, sizeof (buf), NULL) == (pssize) sizeof (socket_data));
+	P_TEST_CHECK (strcmp (buf, socket_data) == 0);
+
+	/* Peer closes the connection */
+	P_TEST_CHECK (p_socket_close (client, NULL) == TRUE);
+
+	P_TEST_REQUIRE (p_socket_poller_wait (poller, events, 4, 5000, NULL) == 1);
+	P_TEST_CHECK (events[0].socket == conn);
+	P_TEST_CHECK ((events[0].conditions & P_SOCKET_POLLER_CONDITION_IN) != 0);
+	P_TEST_CHECK (p_socket_receive (conn, buf, sizeof (buf), NULL) == 0);
+
+	P_TEST_CHECK (p_socket_poller_remove (poller, conn, NULL) == TRUE);
+
+	p_socket_poller_free (poller);
+
+	p_socket_free (conn);
+	p_socket_free (client);
+	p_socket_free (server);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (psocketpoller_many_test)
+{
+	p_libsys_init ();
+
+	PSocket			*sockets[PSOCKETPOLLER_TEST_SOCKETS];
+	pboolean		is_reported[PSOCKETPOLLER_TEST_SOCKETS];
+	PSocketPollerEvent	events[10];
+	pint			n_reported = 0;
+	pint			i;
+
+	PSocketPoller *poller = p_socket_poller_new (NULL);
+	P_TEST_REQUIRE (poller != NULL);
+
+	for (i = 0; i < PSOCKETPOLLER_TEST_SOCKETS; ++i) {
+		sockets[i]     = create_udp_socket ();
+		is_reported[i] = FALSE;
+
+		P_TEST_REQUIRE (sockets[i] != NULL);
+		P_TEST_CHECK (p_socket_poller_add (poller,
+						   sockets[i],
+						   P_SOCKET_POLLER_CONDITION_IN,
+						   P_SOCKET_POLLER_FLAG_NONE,
+						   P_INT_TO_POINTER (i),
+						   NULL) == TRUE);
+	}
+
+	for (i = 0; i < PSOCKETPOLLER_TEST_SOCKETS; ++i)
+		P_TEST_CHECK (send_to_socket (sockets[0], sockets[i]));
+
+	/* All the ready sockets are reported in batches, undrained ones too */
+	for (pint iter = 0; iter < 100 && n_reported < PSOCKETPOLLER_TEST_SOCKETS; ++iter) {
+		pint n_events = p_socket_poller_wait (poller, events, 10, 1000, NULL);
+
+		P_TEST_REQUIRE (n_events > 0 && n_events <= 10);
+
+		for (pint j = 0; j < n_events; ++j) {
+			pint index = P_POINTER_TO_INT (events[j].user_data);
+
+			P_TEST_REQUIRE (index >= 0 && index < PSOCKETPOLLER_TEST_SOCKETS);
+			P_TEST_CHECK (events[j].socket == sockets[index]);
+
+			if (!is_reported[index]) {
+				is_reported[index] = TRUE;
+				++n_reported;
+			}
+		}
+	}
+
+	P_TEST_CHECK (n_reported == PSOCKETPOLLER_TEST_SOCKETS);
+
+	/* Removal in the middle keeps the others registered */
+	for (i = 0; i < PSOCKETPOLLER_TEST_SOCKETS; i += 2)
+		P_TEST_CHECK (p_socket_poller_remove (poller, sockets[i], NULL) == TRUE);
+
+	P_TEST_CHECK (p_socket_poller_get_count (poller) == PSOCKETPOLLER_TEST_SOCKETS / 2);
+
+	for (pint iter = 0; iter < 10; ++iter) {
+		pint n_events = p_socket_poller_wait (poller, events, 10, 1000, NULL);
+
+		P_TEST_REQUIRE (n_events > 0);
+
+		for (pint j = 0; j < n_events; ++j)
+			P_TEST_CHECK (P_POINTER_TO_INT (events[j].user_data) % 2 == 1);
+	}
+
+	p_socket_poller_free (poller);
+
+	for (i = 0; i < PSOCKETPOLLER_TEST_SOCKETS; ++i)
+		p_socket_free (sockets[i]);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (psocketpoller_nomem_test);
+	P_TEST_SUITE_RUN_CASE (psocketpoller_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (psocketpoller_udp_test);
+	P_TEST_SUITE_RUN_CASE (psocketpoller_tcp_test);
+	P_TEST_SUITE_RUN_CASE (psocketpoller_many_test);
+}
+P_TEST_SUITE_END()
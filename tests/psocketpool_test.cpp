@@ -0,0 +1,452 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+P_TEST_MODULE_INIT ();
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+#define PSOCKETPOOL_TEST_THREADS	4
+#define PSOCKETPOOL_TEST_ITERATIONS	500
+
+static PSocketPool	*thread_pool    = NULL;
+static PSocketAddress	*thread_address = NULL;
+static volatile pint	thread_failures = 0;
+
+static void * socket_pool_test_thread (void *)
+{
+	PSocket	*socket;
+	pint	i;
+
+	for (i = 0; i < PSOCKETPOOL_TEST_ITERATIONS; ++i) {
+		if ((socket = p_socket_pool_acquire (thread_pool, thread_address, NULL)) == NULL) {
+			p_atomic_int_inc (&thread_failures);
+			continue;
+		}
+
+		p_socket_pool_release (thread_pool, thread_address, socket, TRUE);
+	}
+
+	p_uthread_exit (0);
+
+	return NULL;
+}
+
+static PSocket * socket_pool_test_listen (PSocketAddress **address)
+{
+	PSocketAddress	*bind_addr;
+	PSocket		*server;
+
+	*address = NULL;
+
+	if ((server = p_socket_new (P_SOCKET_FAMILY_INET,
+				    P_SOCKET_TYPE_STREAM,
+				    P_SOCKET_PROTOCOL_TCP,
+				    NULL)) == NULL)
+		return NULL;
+
+	if ((bind_addr = p_socket_address_new ("127.0.0.1", 0)) == NULL) {
+		p_socket_free (server);
+		return NULL;
+	}
+
+	p_socket_set_timeout (server, 2000);
+
+	if (p_socket_bind (server, bind_addr, TRUE, NULL) == FALSE ||
+	    p_socket_listen (server, NULL) == FALSE ||
+	    (*address = p_socket_get_local_address (server, NULL)) == NULL) {
+		p_socket_address_free (bind_addr);
+		p_socket_free (server);
+		return NULL;
+	}
+
+	p_socket_address_free (bind_addr);
+
+	return server;
+}
+
+static puint16 socket_pool_test_port (PSocket *socket)
+{
+	PSocketAddress	*address;
+	puint16		port;
+
+	if ((address = p_socket_get_local_address (socket, NULL)) == NULL)
+		return 0;
+
+	port = p_socket_address_get_port (address);
+	p_socket_address_free (address);
+
+	return port;
+}
+
+P_TEST_CASE_BEGIN (psocketpool_nomem_test)
+{
+	p_libsys_init ();
+
+	PMemVTable	vtable;
+	PError		*error = NULL;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (p_socket_pool_new (1, 1, &error) == NULL);
+
+	p_mem_restore_vtable ();
+
+	if (error != NULL)
+		p_error_free (error);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (psocketpool_bad_input_test)
+{
+	p_libsys_init ();
+
+	PSocketAddress	*address;
+	PSocketPool	*pool;
+	PError		*error = NULL;
+
+	P_TEST_CHECK (p_socket_pool_new (-1, 0, &error) == NULL);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_INVALID_ARGUMENT);
+	p_error_free (error);
+	error = NULL;
+
+	P_TEST_CHECK (p_socket_pool_new (0, -1, NULL) == NULL);
+	P_TEST_CHECK (p_socket_pool_acquire (NULL, NULL, &error) == NULL);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+	error = NULL;
+
+	P_TEST_CHECK (p_socket_pool_preconnect (NULL, NULL, 1, &error) == -1);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+
+	P_TEST_CHECK (p_socket_pool_get_idle_count (NULL, NULL) == -1);
+	P_TEST_CHECK (p_socket_pool_get_open_count (NULL, NULL) == -1);
+
+	p_socket_pool_set_idle_timeout (NULL, 0);
+	p_socket_pool_set_connect_timeout (NULL, 0);
+	p_socket_pool_release (NULL, NULL, NULL, TRUE);
+	p_socket_pool_free (NULL);
+
+	pool    = p_socket_pool_new (1, 1, NULL);
+	address = p_socket_address_new ("127.0.0.1", 1);
+
+	P_TEST_REQUIRE (pool != NULL);
+	P_TEST_REQUIRE (address != NULL);
+
+	/* Unknown peers */
+	P_TEST_CHECK (p_socket_pool_get_idle_count (pool, address) == 0);
+	P_TEST_CHECK (p_socket_pool_get_open_count (pool, address) == 0);
+	P_TEST_CHECK (p_socket_pool_preconnect (pool, address, -1, NULL) == -1);
+
+	p_socket_address_free (address);
+	p_socket_pool_free (pool);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (psocketpool_general_test)
+{
+	p_libsys_init ();
+
+	PSocketAddress	*address;
+	PSocketAddress	*other;
+	PSocketPool	*pool;
+	PSocket		*server;
+	PSocket		*peers[4];
+	PSocket		*sockets[4];
+	PError		*error = NULL;
+	pchar		buf[8];
+	puint16		port;
+	pint		i;
+
+	server = socket_pool_test_listen (&address);
+	P_TEST_REQUIRE (server != NULL);
+
+	pool = p_socket_pool_new (2, 3, NULL);
+	P_TEST_REQUIRE (pool != NULL);
+
+	p_socket_pool_set_connect_timeout (pool, 2000);
+
+	/* A new connection */
+	sockets[0] = p_socket_pool_acquire (pool, address, NULL);
+	P_TEST_REQUIRE (sockets[0] != NULL);
+	P_TEST_CHECK (p_socket_is_connected (sockets[0]) == TRUE);
+	P_TEST_CHECK (p_socket_get_blocking (sockets[0]) == TRUE);
+	P_TEST_CHECK (p_socket_pool_get_open_count (pool, address) == 1);
+	P_TEST_CHECK (p_socket_pool_get_idle_count (pool, address) == 0);
+
+	peers[0] = p_socket_accept (server, NULL);
+	P_TEST_REQUIRE (peers[0] != NULL);
+
+	P_TEST_CHECK (p_socket_send (sockets[0], "ping", 4, NULL) == 4);
+	P_TEST_CHECK (p_socket_receive (peers[0], buf, sizeof (buf), NULL) == 4);
+
+	port = socket_pool_test_port (sockets[0]);
+
+	/* Reused */
+	p_socket_pool_release (pool, address, sockets[0], TRUE);
+	P_TEST_CHECK (p_socket_pool_get_idle_count (pool, address) == 1);
+	P_TEST_CHECK (p_socket_pool_get_open_count (pool, address) == 1);
+
+	sockets[0] = p_socket_pool_acquire (pool, address, NULL);
+	P_TEST_REQUIRE (sockets[0] != NULL);
+	P_TEST_CHECK (socket_pool_test_port (sockets[0]) == port);
+	P_TEST_CHECK (p_socket_get_blocking (sockets[0]) == TRUE);
+	P_TEST_CHECK (p_socket_pool_get_idle_count (pool, address) == 0);
+
+	P_TEST_CHECK (p_socket_send (sockets[0], "pong", 4, NULL) == 4);
+	P_TEST_CHECK (p_socket_receive (peers[0], buf, sizeof (buf), NULL) == 4);
+
+	/* Connection limit */
+	for (i = 1; i < 3; ++i) {
+		sockets[i] = p_socket_pool_acquire (pool, address, NULL);
+		P_TEST_REQUIRE (sockets[i] != NULL);
+
+		peers[i] = p_socket_accept (server, NULL);
+		P_TEST_REQUIRE (peers[i] != NULL);
+	}
+
+	P_TEST_CHECK (p_socket_pool_get_open_count (pool, address) == 3);
+	P_TEST_CHECK (p_socket_pool_acquire (pool, address, &error) == NULL);
+	P_TEST_REQUIRE (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_NO_RESOURCES);
+	p_error_free (error);
+	error = NULL;
+
+	/* Idle limit, not reusable ones are closed */
+	p_socket_pool_release (pool, address, sockets[2], FALSE);
+	P_TEST_CHECK (p_socket_pool_get_open_count (pool, address) == 2);
+	P_TEST_CHECK (p_socket_pool_get_idle_count (pool, address) == 0);
+
+	p_socket_pool_release (pool, address, sockets[0], TRUE);
+	p_socket_pool_release (pool, address, sockets[1], TRUE);
+	P_TEST_CHECK (p_socket_pool_get_open_count (pool, address) == 2);
+	P_TEST_CHECK (p_socket_pool_get_idle_count (pool, address) == 2);
+
+	sockets[3] = p_socket_pool_acquire (pool, address, NULL);
+	P_TEST_REQUIRE (sockets[3] != NULL);
+	p_socket_pool_release (pool, address, sockets[3], TRUE);
+
+	/* The peer closes the idle connections */
+	for (i = 0; i < 3; ++i)
+		p_socket_free (peers[i]);
+
+	p_uthread_sleep (50);
+
+	sockets[0] = p_socket_pool_acquire (pool, address, NULL);
+	P_TEST_REQUIRE (sockets[0] != NULL);
+	P_TEST_CHECK (p_socket_pool_get_idle_count (pool, address) == 0);
+	P_TEST_CHECK (p_socket_pool_get_open_count (pool, address) == 1);
+
+	peers[0] = p_socket_accept (server, NULL);
+	P_TEST_REQUIRE (peers[0] != NULL);
+
+	P_TEST_CHECK (p_socket_send (sockets[0], "ping", 4, NULL) == 4);
+	P_TEST_CHECK (p_socket_receive (peers[0], buf, sizeof (buf), NULL) == 4);
+
+	/* Idle timeout */
+	port = socket_pool_test_port (sockets[0]);
+
+	p_socket_pool_set_idle_timeout (pool, 1);
+	p_socket_pool_release (pool, address, sockets[0], TRUE);
+
+	p_uthread_sleep (100);
+
+	sockets[0] = p_socket_pool_acquire (pool, address, NULL);
+	P_TEST_REQUIRE (sockets[0] != NULL);
+	P_TEST_CHECK (socket_pool_test_port (sockets[0]) != port);
+	P_TEST_CHECK (p_socket_pool_get_open_count (pool, address) == 1);
+
+	peers[1] = p_socket_accept (server, NULL);
+	P_TEST_REQUIRE (peers[1] != NULL);
+
+	/* Released for an unknown peer is just closed */
+	other = p_socket_address_new ("127.0.0.1", 1);
+	P_TEST_REQUIRE (other != NULL);
+
+	p_socket_pool_release (pool, other, sockets[0], TRUE);
+	P_TEST_CHECK (p_socket_pool_get_idle_count (pool, other) == 0);
+	P_TEST_CHECK (p_socket_pool_get_idle_count (pool, address) == 0);
+
+	p_socket_address_free (other);
+
+	p_socket_free (peers[0]);
+	p_socket_free (peers[1]);
+	p_socket_pool_free (pool);
+	p_socket_address_free (address);
+	p_socket_free (server);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (psocketpool_preconnect_test)
+{
+	p_libsys_init ();
+
+	PSocketAddress	*address;
+	PSocketPool	*pool;
+	PSocket		*server;
+	PSocket		*socket;
+	PSocket		*peers[4];
+	PError		*error = NULL;
+	pint		i;
+
+	server = socket_pool_test_listen (&address);
+	P_TEST_REQUIRE (server != NULL);
+
+	pool = p_socket_pool_new (4, 0, NULL);
+	P_TEST_REQUIRE (pool != NULL);
+
+	p_socket_pool_set_connect_timeout (pool, 2000);
+
+	P_TEST_CHECK (p_socket_pool_preconnect (pool, address, 0, NULL) == 0);
+	P_TEST_CHECK (p_socket_pool_preconnect (pool, address, 6, NULL) == 4);
+	P_TEST_CHECK (p_socket_pool_get_idle_count (pool, address) == 4);
+	P_TEST_CHECK (p_socket_pool_get_open_count (pool, address) == 4);
+
+	/* No more idle slots */
+	P_TEST_CHECK (p_socket_pool_preconnect (pool, address, 1, NULL) == 0);
+
+	for (i = 0; i < 4; ++i) {
+		peers[i] = p_socket_accept (server, NULL);
+		P_TEST_REQUIRE (peers[i] != NULL);
+	}
+
+	socket = p_socket_pool_acquire (pool, address, NULL);
+	P_TEST_REQUIRE (socket != NULL);
+	P_TEST_CHECK (p_socket_pool_get_idle_count (pool, address) == 3);
+	P_TEST_CHECK (p_socket_pool_get_open_count (pool, address) == 4);
+	p_socket_pool_release (pool, address, socket, FALSE);
+
+	for (i = 0; i < 4; ++i)
+		p_socket_free (peers[i]);
+
+	p_socket_pool_free (pool);
+
+	/* Nobody listens anymore */
+	p_socket_free (server);
+
+	pool = p_socket_pool_new (4, 0, NULL);
+	P_TEST_REQUIRE (pool != NULL);
+
+	p_socket_pool_set_connect_timeout (pool, 2000);
+
+	P_TEST_CHECK (p_socket_pool_preconnect (pool, address, 2, &error) == -1);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (p_socket_pool_get_open_count (pool, address) == 0);
+	P_TEST_CHECK (p_socket_pool_get_idle_count (pool, address) == 0);
+	p_error_free (error);
+	error = NULL;
+
+	P_TEST_CHECK (p_socket_pool_acquire (pool, address, &error) == NULL);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (p_socket_pool_get_open_count (pool, address) == 0);
+	p_error_free (error);
+
+	p_socket_pool_free (pool);
+	p_socket_address_free (address);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (psocketpool_threads_test)
+{
+	p_libsys_init ();
+
+	PUThread	*threads[PSOCKETPOOL_TEST_THREADS];
+	PSocket		*server;
+	pint		i;
+
+	server = socket_pool_test_listen (&thread_address);
+	P_TEST_REQUIRE (server != NULL);
+
+	/* Each thread holds one connection at most, all of them stay idle */
+	thread_pool = p_socket_pool_new (PSOCKETPOOL_TEST_THREADS, PSOCKETPOOL_TEST_THREADS, NULL);
+	P_TEST_REQUIRE (thread_pool != NULL);
+
+	p_socket_pool_set_connect_timeout (thread_pool, 2000);
+
+	for (i = 0; i < PSOCKETPOOL_TEST_THREADS; ++i) {
+		threads[i] = p_uthread_create ((PUThreadFunc) socket_pool_test_thread, NULL, TRUE, NULL);
+		P_TEST_REQUIRE (threads[i] != NULL);
+	}
+
+	for (i = 0; i < PSOCKETPOOL_TEST_THREADS; ++i) {
+		p_uthread_join (threads[i]);
+		p_uthread_unref (threads[i]);
+	}
+
+	P_TEST_CHECK (p_atomic_int_get (&thread_failures) == 0);
+	P_TEST_CHECK (p_socket_pool_get_open_count (thread_pool, thread_address) >= 1);
+	P_TEST_CHECK (p_socket_pool_get_open_count (thread_pool, thread_address) <= PSOCKETPOOL_TEST_THREADS);
+	P_TEST_CHECK (p_socket_pool_get_idle_count (thread_pool, thread_address) ==
+		      p_socket_pool_get_open_count (thread_pool, thread_address));
+
+	p_socket_pool_free (thread_pool);
+	p_socket_address_free (thread_address);
+	p_socket_free (server);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (psocketpool_nomem_test);
+	P_TEST_SUITE_RUN_CASE (psocketpool_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (psocketpool_general_test);
+	P_TEST_SUITE_RUN_CASE (psocketpool_preconnect_test);
+	P_TEST_SUITE_RUN_CASE (psocketpool_threads_test);
+}
+P_TEST_SUITE_END()
@@ -0,0 +1,357 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <string.h>
+
+P_TEST_MODULE_INIT ();
+
+#define PSOCKETSTREAM_TEST_BLOB_SIZE	100000
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+/* Creates a pair of connected TCP sockets */
+static pboolean create_socket_pair (PSocket **sender, PSocket **receiver)
+{
+	PSocket		*server;
+	PSocketAddress	*addr;
+	pboolean	ret = FALSE;
+
+	*sender   = NULL;
+	*receiver = NULL;
+
+	server = p_socket_new (P_SOCKET_FAMILY_INET, P_SOCKET_TYPE_STREAM, P_SOCKET_PROTOCOL_TCP, NULL);
+
+	if (server == NULL)
+		return FALSE;
+
+	addr = p_socket_address_new ("127.0.0.1", 0);
+
+	if (addr != NULL && p_socket_bind (server, addr, TRUE, NULL) && p_socket_listen (server, NULL)) {
+		p_socket_address_free (addr);
+		addr = p_socket_get_local_address (server, NULL);
+
+		*sender = p_socket_new (P_SOCKET_FAMILY_INET, P_SOCKET_TYPE_STREAM, P_SOCKET_PROTOCOL_TCP, NULL);
+
+		if (addr != NULL && *sender != NULL && p_socket_connect (*sender, addr, NULL))
+			*receiver = p_socket_accept (server, NULL);
+
+		ret = *receiver != NULL;
+	}
+
+	p_socket_address_free (addr);
+	p_socket_free (server);
+
+	if (!ret) {
+		p_socket_free (*sender);
+		*sender = NULL;
+	}
+
+	return ret;
+}
+
+static pboolean send_all (PSocket *socket, const pchar *data, psize len)
+{
+	while (len > 0) {
+		pssize ret = p_socket_send (socket, data, len, NULL);
+
+		if (ret <= 0)
+			return FALSE;
+
+		data += ret;
+		len  -= (psize) ret;
+	}
+
+	return TRUE;
+}
+
+static void * sender_thread_func (void *data)
+{
+	PSocket	*socket = (PSocket *) data;
+	pchar	*blob   = (pchar *) p_malloc (PSOCKETSTREAM_TEST_BLOB_SIZE);
+	puint32	length  = p_htonl (PSOCKETSTREAM_TEST_BLOB_SIZE);
+	pint	ret     = -1;
+
+	if (blob != NULL) {
+		for (pint i = 0; i < PSOCKETSTREAM_TEST_BLOB_SIZE; ++i)
+			blob[i] = (pchar) (i % 251);
+
+		if (send_all (socket, "first line\r\n", 12) &&
+		    send_all (socket, "second", 6) &&
+		    send_all (socket, " line\r\n", 7) &&
+		    send_all (socket, (const pchar *) &length, sizeof (length)) &&
+		    send_all (socket, blob, PSOCKETSTREAM_TEST_BLOB_SIZE) &&
+		    send_all (socket, "tail", 4))
+			ret = 1;
+
+		p_free (blob);
+	}
+
+	p_socket_shutdown (socket, FALSE, TRUE, NULL);
+
+	p_uthread_exit (ret);
+
+	return NULL;
+}
+
+P_TEST_CASE_BEGIN (psocketstream_nomem_test)
+{
+	p_libsys_init ();
+
+	PSocket *sender;
+	PSocket *receiver;
+
+	P_TEST_REQUIRE (create_socket_pair (&sender, &receiver) == TRUE);
+
+	PSocketStream *stream = p_socket_stream_new (receiver, 4, NULL);
+	P_TEST_REQUIRE (stream != NULL);
+
+	P_TEST_CHECK (send_all (sender, "01234567", 8) == TRUE);
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	pchar buffer[8];
+
+	P_TEST_CHECK (p_socket_stream_new (receiver, 0, NULL) == NULL);
+	P_TEST_CHECK (p_socket_stream_read_exact (stream, buffer, 8, NULL) == -1);
+
+	p_mem_restore_vtable ();
+
+	P_TEST_CHECK (p_socket_stream_read_exact (stream, buffer, 8, NULL) == 8);
+	P_TEST_CHECK (memcmp (buffer, "01234567", 8) == 0);
+
+	p_socket_stream_free (stream);
+	p_socket_free (sender);
+	p_socket_free (receiver);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (psocketstream_bad_input_test)
+{
+	p_libsys_init ();
+
+	const pchar	*data;
+	pchar		buffer[8];
+
+	P_TEST_CHECK (p_socket_stream_new (NULL, 0, NULL) == NULL);
+	P_TEST_CHECK (p_socket_stream_get_socket (NULL) == NULL);
+	P_TEST_CHECK (p_socket_stream_get_available (NULL) == 0);
+	P_TEST_CHECK (p_socket_stream_read (NULL, buffer, sizeof (buffer), NULL) == -1);
+	P_TEST_CHECK (p_socket_stream_read_exact (NULL, buffer, sizeof (buffer), NULL) == -1);
+	P_TEST_CHECK (p_socket_stream_read_until (NULL, "\n", 1, buffer, sizeof (buffer), NULL) == -1);
+	P_TEST_CHECK (p_socket_stream_peek (NULL, 0, &data, NULL) == -1);
+	P_TEST_CHECK (p_socket_stream_skip (NULL, 0) == FALSE);
+
+	p_socket_stream_free (NULL);
+
+	PSocket *sender;
+	PSocket *receiver;
+
+	P_TEST_REQUIRE (create_socket_pair (&sender, &receiver) == TRUE);
+
+	PSocketStream *stream = p_socket_stream_new (receiver, 0, NULL);
+	P_TEST_REQUIRE (stream != NULL);
+
+	P_TEST_CHECK (p_socket_stream_get_socket (stream) == receiver);
+	P_TEST_CHECK (p_socket_stream_read (stream, NULL, sizeof (buffer), NULL) == -1);
+	P_TEST_CHECK (p_socket_stream_read (stream, buffer, 0, NULL) == -1);
+	P_TEST_CHECK (p_socket_stream_read_exact (stream, buffer, 0, NULL) == -1);
+	P_TEST_CHECK (p_socket_stream_read_until (stream, NULL, 1, buffer, sizeof (buffer), NULL) == -1);
+	P_TEST_CHECK (p_socket_stream_read_until (stream, "\n", 0, buffer, sizeof (buffer), NULL) == -1);
+	P_TEST_CHECK (p_socket_stream_read_until (stream, "\r\n", 2, buffer, 1, NULL) == -1);
+	P_TEST_CHECK (p_socket_stream_peek (stream, 0, NULL, NULL) == -1);
+	P_TEST_CHECK (p_socket_stream_skip (stream, 1) == FALSE);
+
+	/* Nothing is buffered yet */
+	P_TEST_CHECK (p_socket_stream_peek (stream, 0, &data, NULL) == 0);
+	P_TEST_CHECK (p_socket_stream_skip (stream, 0) == TRUE);
+
+	p_socket_stream_free (stream);
+	p_socket_free (sender);
+	p_socket_free (receiver);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (psocketstream_framing_test)
+{
+	p_libsys_init ();
+
+	PSocket *sender;
+	PSocket *receiver;
+
+	P_TEST_REQUIRE (create_socket_pair (&sender, &receiver) == TRUE);
+
+	/* Small buffer forces compaction and growth */
+	PSocketStream *stream = p_socket_stream_new (receiver, 16, NULL);
+	P_TEST_REQUIRE (stream != NULL);
+
+	PUThread *sender_thr = p_uthread_create ((PUThreadFunc) sender_thread_func, sender, TRUE, NULL);
+	P_TEST_REQUIRE (sender_thr != NULL);
+
+	pchar	line[32];
+	PError	*error = NULL;
+
+	P_TEST_CHECK (p_socket_stream_read_until (stream, "\r\n", 2, line, sizeof (line), NULL) == 12);
+	P_TEST_CHECK (memcmp (line, "first line\r\n", 12) == 0);
+
+	/* Delimiter doesn't fit into the limit, nothing is consumed */
+	P_TEST_CHECK (p_socket_stream_read_until (stream, "\r\n", 2, line, 8, &error) == -1);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_NO_RESOURCES);
+	p_error_free (error);
+	error = NULL;
+
+	P_TEST_CHECK (p_socket_stream_get_available (stream) >= 8);
+
+	P_TEST_CHECK (p_socket_stream_read_until (stream, "\r\n", 2, line, sizeof (line), NULL) == 13);
+	P_TEST_CHECK (memcmp (line, "second line\r\n", 13) == 0);
+
+	puint32 length = 0;
+
+	P_TEST_CHECK (p_socket_stream_read_exact (stream, (pchar *) &length, sizeof (length), NULL) ==
+		      (pssize) sizeof (length));
+	P_TEST_CHECK (p_ntohl (length) == PSOCKETSTREAM_TEST_BLOB_SIZE);
+
+	/* Whole body is peeked in place */
+	const pchar *data = NULL;
+
+	P_TEST_CHECK (p_socket_stream_peek (stream, PSOCKETSTREAM_TEST_BLOB_SIZE, &data, NULL) >=
+		      PSOCKETSTREAM_TEST_BLOB_SIZE);
+	P_TEST_REQUIRE (data != NULL);
+
+	pboolean is_valid = TRUE;
+
+	for (pint i = 0; i < PSOCKETSTREAM_TEST_BLOB_SIZE; ++i) {
+		if (data[i] != (pchar) (i % 251))
+			is_valid = FALSE;
+	}
+
+	P_TEST_CHECK (is_valid == TRUE);
+	P_TEST_CHECK (p_socket_stream_skip (stream, p_socket_stream_get_available (stream) + 1) == FALSE);
+	P_TEST_CHECK (p_socket_stream_skip (stream, PSOCKETSTREAM_TEST_BLOB_SIZE) == TRUE);
+
+	/* Peer closes the connection before the whole message */
+	P_TEST_CHECK (p_socket_stream_read_exact (stream, line, 8, NULL) == 0);
+	P_TEST_CHECK (p_socket_stream_get_available (stream) == 4);
+	P_TEST_CHECK (p_socket_stream_read (stream, line, sizeof (line), NULL) == 4);
+	P_TEST_CHECK (memcmp (line, "tail", 4) == 0);
+	P_TEST_CHECK (p_socket_stream_read (stream, line, sizeof (line), NULL) == 0);
+
+	P_TEST_CHECK (p_uthread_join (sender_thr) == 1);
+	p_uthread_unref (sender_thr);
+
+	p_socket_stream_free (stream);
+	p_socket_free (sender);
+	p_socket_free (receiver);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (psocketstream_nonblocking_test)
+{
+	p_libsys_init ();
+
+	PSocket *sender;
+	PSocket *receiver;
+
+	P_TEST_REQUIRE (create_socket_pair (&sender, &receiver) == TRUE);
+
+	p_socket_set_blocking (receiver, FALSE);
+
+	PSocketStream *stream = p_socket_stream_new (receiver, 0, NULL);
+	P_TEST_REQUIRE (stream != NULL);
+
+	pchar	buffer[16];
+	PError	*error = NULL;
+
+	P_TEST_CHECK (send_all (sender, "partial", 7) == TRUE);
+	P_TEST_CHECK (p_socket_io_condition_wait (receiver, P_SOCKET_IO_CONDITION_POLLIN, NULL) == TRUE);
+
+	/* Incomplete message is kept in the buffer */
+	P_TEST_CHECK (p_socket_stream_read_until (stream, "\n", 1, buffer, sizeof (buffer), &error) == -1);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_WOULD_BLOCK);
+	p_error_free (error);
+	error = NULL;
+
+	P_TEST_CHECK (p_socket_stream_get_available (stream) == 7);
+
+	P_TEST_CHECK (send_all (sender, " data\n", 6) == TRUE);
+	P_TEST_CHECK (p_socket_io_condition_wait (receiver, P_SOCKET_IO_CONDITION_POLLIN, NULL) == TRUE);
+
+	P_TEST_CHECK (p_socket_stream_read_until (stream, "\n", 1, buffer, sizeof (buffer), NULL) == 13);
+	P_TEST_CHECK (memcmp (buffer, "partial data\n", 13) == 0);
+	P_TEST_CHECK (p_socket_stream_get_available (stream) == 0);
+
+	P_TEST_CHECK (p_socket_stream_read (stream, buffer, sizeof (buffer), &error) == -1);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_WOULD_BLOCK);
+	p_error_free (error);
+
+	p_socket_stream_free (stream);
+	p_socket_free (sender);
+	p_socket_free (receiver);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (psocketstream_nomem_test);
+	P_TEST_SUITE_RUN_CASE (psocketstream_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (psocketstream_framing_test);
+	P_TEST_SUITE_RUN_CASE (psocketstream_nonblocking_test);
+}
+P_TEST_SUITE_END()
@@ -0,0 +1,506 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <string.h>
+
+P_TEST_MODULE_INIT ();
+
+#define PSORT_MAX_COUNT		20000
+#define PSORT_PARALLEL_COUNT	200000
+
+typedef struct PSortTestRecord_ {
+	pint32	key;
+	puint32	order;
+} PSortTestRecord;
+
+typedef struct PSortTestOdd_ {
+	puint8	bytes[3];
+} PSortTestOdd;
+
+static puint32 test_random_state = 1;
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static puint32 test_random (void)
+{
+	test_random_state ^= test_random_state << 13;
+	test_random_state ^= test_random_state >> 17;
+	test_random_state ^= test_random_state << 5;
+
+	return test_random_state;
+}
+
+static pint compare_int (pconstpointer a, pconstpointer b, ppointer data)
+{
+	pint ia = *((const pint *) a);
+	pint ib = *((const pint *) b);
+
+	if (data != NULL)
+		++*((pint *) data);
+
+	return ia < ib ? -1 : (ia > ib ? 1 : 0);
+}
+
+static pint compare_record (pconstpointer a, pconstpointer b, ppointer data)
+{
+	const PSortTestRecord *ra = (const PSortTestRecord *) a;
+	const PSortTestRecord *rb = (const PSortTestRecord *) b;
+
+	P_UNUSED (data);
+
+	return ra->key < rb->key ? -1 : (ra->key > rb->key ? 1 : 0);
+}
+
+static pint compare_odd (pconstpointer a, pconstpointer b, ppointer data)
+{
+	P_UNUSED (data);
+
+	return memcmp (a, b, sizeof (PSortTestOdd));
+}
+
+/* Fills an array with one of the patterns which are hard for quicksorts */
+static void fill_pattern (pint *array, pint count, pint pattern)
+{
+	pint i;
+
+	for (i = 0; i < count; ++i) {
+		switch (pattern) {
+		case 0:
+			array[i] = (pint) (test_random () % 1000000);
+			break;
+		case 1:
+			array[i] = i;
+			break;
+		case 2:
+			array[i] = count - i;
+			break;
+		case 3:
+			array[i] = 7;
+			break;
+		case 4:
+			array[i] = (pint) (test_random () % 4);
+			break;
+		case 5:
+			/* Organ pipe */
+			array[i] = i < count / 2 ? i : count - i;
+			break;
+		default:
+			/* Sorted with a few random swaps */
+			array[i] = (i % 97 == 0) ? (pint) (test_random () % (puint32) count) : i;
+			break;
+		}
+	}
+}
+
+static pboolean is_sorted (const pint *array, pint count)
+{
+	pint i;
+
+	for (i = 1; i < count; ++i)
+		if (array[i - 1] > array[i])
+			return FALSE;
+
+	return TRUE;
+}
+
+static puint64 array_sum (const pint *array, pint count)
+{
+	puint64	sum = 0;
+	pint	i;
+
+	for (i = 0; i < count; ++i)
+		sum += (puint64) array[i];
+
+	return sum;
+}
+
+P_TEST_CASE_BEGIN (psort_nomem_test)
+{
+	p_libsys_init ();
+
+	pint		array[64];
+	PMemVTable	vtable;
+
+	fill_pattern (array, 64, 2);
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (p_sort_stable (array, 64, sizeof (pint), compare_int, NULL) == FALSE);
+	P_TEST_CHECK (p_sort_radix (array, 64, sizeof (pint), 0, P_SORT_KEY_INT32) == FALSE);
+	P_TEST_CHECK (array[0] == 64);
+
+	/* Small arrays don't need a buffer */
+	P_TEST_CHECK (p_sort_stable (array, 16, sizeof (pint), compare_int, NULL) == TRUE);
+	P_TEST_CHECK (is_sorted (array, 16) == TRUE);
+
+	/* Doesn't allocate at all */
+	p_sort (array, 64, sizeof (pint), compare_int, NULL);
+	P_TEST_CHECK (is_sorted (array, 64) == TRUE);
+
+	p_mem_restore_vtable ();
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (psort_invalid_test)
+{
+	p_libsys_init ();
+
+	pint array[4] = {3, 1, 2, 0};
+
+	p_sort (NULL, 4, sizeof (pint), compare_int, NULL);
+	p_sort (array, 4, 0, compare_int, NULL);
+	p_sort (array, 4, sizeof (pint), NULL, NULL);
+	p_sort_parallel (NULL, NULL, 4, sizeof (pint), compare_int, NULL);
+	P_TEST_CHECK (array[0] == 3);
+
+	P_TEST_CHECK (p_sort_stable (NULL, 4, sizeof (pint), compare_int, NULL) == FALSE);
+	P_TEST_CHECK (p_sort_stable (array, 4, 0, compare_int, NULL) == FALSE);
+	P_TEST_CHECK (p_sort_stable (array, 4, sizeof (pint), NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_sort_stable (NULL, 0, sizeof (pint), compare_int, NULL) == TRUE);
+
+	P_TEST_CHECK (p_sort_radix (NULL, 4, sizeof (pint), 0, P_SORT_KEY_INT32) == FALSE);
+	P_TEST_CHECK (p_sort_radix (array, 4, 2, 0, P_SORT_KEY_INT32) == FALSE);
+	P_TEST_CHECK (p_sort_radix (array, 4, sizeof (pint), 1, P_SORT_KEY_INT32) == FALSE);
+	P_TEST_CHECK (p_sort_radix (array, 4, sizeof (pint), 0, P_SORT_KEY_INT64) == FALSE);
+	P_TEST_CHECK (p_sort_radix (array, 4, sizeof (pint), 0, (PSortKeyType) 100) == FALSE);
+	P_TEST_CHECK (p_sort_radix (NULL, 0, sizeof (pint), 0, P_SORT_KEY_INT32) == TRUE);
+	P_TEST_CHECK (array[0] == 3);
+
+	P_TEST_CHECK (p_lower_bound (NULL, 4, sizeof (pint), array, compare_int, NULL) == 4);
+	P_TEST_CHECK (p_lower_bound (array, 0, sizeof (pint), array, compare_int, NULL) == 0);
+	P_TEST_CHECK (p_upper_bound (array, 4, sizeof (pint), array, NULL, NULL) == 4);
+	P_TEST_CHECK (p_lower_bound_uint32 (NULL, 4, 1) == 4);
+	P_TEST_CHECK (p_lower_bound_uint64 (NULL, 0, 1) == 0);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (psort_general_test)
+{
+	p_libsys_init ();
+
+	pint		*array;
+	PSortTestOdd	odd[1000];
+	pint		counts[] = {0, 1, 2, 3, 15, 16, 17, 100, 129, 1000, PSORT_MAX_COUNT};
+	pint		compares;
+	puint64		sum;
+	psize		i;
+	pint		j;
+	pint		pattern;
+
+	array = (pint *) p_malloc (PSORT_MAX_COUNT * sizeof (pint));
+	P_TEST_REQUIRE (array != NULL);
+
+	for (i = 0; i < sizeof (counts) / sizeof (counts[0]); ++i) {
+		for (pattern = 0; pattern < 7; ++pattern) {
+			fill_pattern (array, counts[i], pattern);
+			sum      = array_sum (array, counts[i]);
+			compares = 0;
+
+			p_sort (array, (psize) counts[i], sizeof (pint), compare_int, &compares);
+
+			P_TEST_CHECK (is_sorted (array, counts[i]) == TRUE);
+			P_TEST_CHECK (array_sum (array, counts[i]) == sum);
+
+			/* No quadratic behavior on any pattern */
+			if (counts[i] == PSORT_MAX_COUNT)
+				P_TEST_CHECK (compares < PSORT_MAX_COUNT * 64);
+		}
+	}
+
+	/* Elements of an odd size are swapped byte by byte */
+	for (j = 0; j < 1000; ++j) {
+		odd[j].bytes[0] = (puint8) (test_random () % 3);
+		odd[j].bytes[1] = (puint8) test_random ();
+		odd[j].bytes[2] = (puint8) j;
+	}
+
+	p_sort (odd, 1000, sizeof (PSortTestOdd), compare_odd, NULL);
+
+	for (j = 1; j < 1000; ++j)
+		P_TEST_CHECK (memcmp (&odd[j - 1], &odd[j], sizeof (PSortTestOdd)) <= 0);
+
+	p_free (array);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (psort_stable_test)
+{
+	p_libsys_init ();
+
+	PSortTestRecord	*records;
+	pint		*array;
+	pint		compares;
+	pint		i;
+
+	records = (PSortTestRecord *) p_malloc (PSORT_MAX_COUNT * sizeof (PSortTestRecord));
+	P_TEST_REQUIRE (records != NULL);
+
+	for (i = 0; i < PSORT_MAX_COUNT; ++i) {
+		records[i].key   = (pint32) (test_random () % 100) - 50;
+		records[i].order = (puint32) i;
+	}
+
+	P_TEST_CHECK (p_sort_stable (records,
+				     PSORT_MAX_COUNT,
+				     sizeof (PSortTestRecord),
+				     compare_record,
+				     NULL) == TRUE);
+
+	for (i = 1; i < PSORT_MAX_COUNT; ++i) {
+		P_TEST_CHECK (records[i - 1].key <= records[i].key);
+
+		if (records[i - 1].key == records[i].key)
+			P_TEST_CHECK (records[i - 1].order < records[i].order);
+	}
+
+	p_free (records);
+
+	/* Already sorted input takes a linear number of comparisons */
+	array = (pint *) p_malloc (PSORT_MAX_COUNT * sizeof (pint));
+	P_TEST_REQUIRE (array != NULL);
+
+	fill_pattern (array, PSORT_MAX_COUNT, 1);
+	compares = 0;
+
+	P_TEST_CHECK (p_sort_stable (array, PSORT_MAX_COUNT, sizeof (pint), compare_int, &compares) == TRUE);
+	P_TEST_CHECK (is_sorted (array, PSORT_MAX_COUNT) == TRUE);
+	P_TEST_CHECK (compares < PSORT_MAX_COUNT * 2);
+
+	fill_pattern (array, PSORT_MAX_COUNT, 0);
+
+	P_TEST_CHECK (p_sort_stable (array, PSORT_MAX_COUNT, sizeof (pint), compare_int, NULL) == TRUE);
+	P_TEST_CHECK (is_sorted (array, PSORT_MAX_COUNT) == TRUE);
+
+	p_free (array);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (psort_radix_test)
+{
+	p_libsys_init ();
+
+	PSortTestRecord	*records;
+	puint64		u64[1000];
+	pint64		i64[1000];
+	pfloat		f32[8] = {3.5f, -1.0f, 0.0f, -0.0f, 1e30f, -1e30f, 2.0f, -2.5f};
+	pdouble		f64[6] = {1.0, -1e300, 0.5, -0.5, 1e-300, 0.0};
+	puint32		u32[5] = {5, 0xFFFFFFFFU, 0, 0x80000000U, 7};
+	pint		i;
+
+	records = (PSortTestRecord *) p_malloc (PSORT_MAX_COUNT * sizeof (PSortTestRecord));
+	P_TEST_REQUIRE (records != NULL);
+
+	for (i = 0; i < PSORT_MAX_COUNT; ++i) {
+		records[i].key   = (pint32) test_random ();
+		records[i].order = (puint32) i;
+
+		/* Some duplicates to check stability */
+		if (i % 5 == 0)
+			records[i].key = (pint32) (i % 3) - 1;
+	}
+
+	P_TEST_CHECK (p_sort_radix (records,
+				    PSORT_MAX_COUNT,
+				    sizeof (PSortTestRecord),
+				    0,
+				    P_SORT_KEY_INT32) == TRUE);
+
+	for (i = 1; i < PSORT_MAX_COUNT; ++i) {
+		P_TEST_CHECK (records[i - 1].key <= records[i].key);
+
+		if (records[i - 1].key == records[i].key)
+			P_TEST_CHECK (records[i - 1].order < records[i].order);
+	}
+
+	/* Sorting by the second field */
+	P_TEST_CHECK (p_sort_radix (records,
+				    PSORT_MAX_COUNT,
+				    sizeof (PSortTestRecord),
+				    sizeof (pint32),
+				    P_SORT_KEY_UINT32) == TRUE);
+
+	for (i = 0; i < PSORT_MAX_COUNT; ++i)
+		P_TEST_CHECK (records[i].order == (puint32) i);
+
+	p_free (records);
+
+	P_TEST_CHECK (p_sort_radix (u32, 5, sizeof (puint32), 0, P_SORT_KEY_UINT32) == TRUE);
+	P_TEST_CHECK (u32[0] == 0 && u32[1] == 5 && u32[2] == 7 && u32[3] == 0x80000000U && u32[4] == 0xFFFFFFFFU);
+
+	for (i = 0; i < 1000; ++i) {
+		u64[i] = ((puint64) test_random () << 32) | test_random ();
+		i64[i] = (pint64) u64[i];
+	}
+
+	P_TEST_CHECK (p_sort_radix (u64, 1000, sizeof (puint64), 0, P_SORT_KEY_UINT64) == TRUE);
+	P_TEST_CHECK (p_sort_radix (i64, 1000, sizeof (pint64), 0, P_SORT_KEY_INT64) == TRUE);
+
+	for (i = 1; i < 1000; ++i) {
+		P_TEST_CHECK (u64[i - 1] <= u64[i]);
+		P_TEST_CHECK (i64[i - 1] <= i64[i]);
+	}
+
+	P_TEST_CHECK (p_sort_radix (f32, 8, sizeof (pfloat), 0, P_SORT_KEY_FLOAT) == TRUE);
+
+	for (i = 1; i < 8; ++i)
+		P_TEST_CHECK (f32[i - 1] <= f32[i]);
+
+	/* Negative zero goes first */
+	P_TEST_CHECK (memcmp (&f32[4], &f32[3], sizeof (pfloat)) != 0);
+	P_TEST_CHECK (f32[3] == 0.0f && f32[4] == 0.0f);
+	P_TEST_CHECK (f32[0] == -1e30f && f32[7] == 1e30f);
+
+	P_TEST_CHECK (p_sort_radix (f64, 6, sizeof (pdouble), 0, P_SORT_KEY_DOUBLE) == TRUE);
+
+	for (i = 1; i < 6; ++i)
+		P_TEST_CHECK (f64[i - 1] <= f64[i]);
+
+	P_TEST_CHECK (f64[0] == -1e300 && f64[5] == 1.0);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (psort_parallel_test)
+{
+	p_libsys_init ();
+
+	PTaskScheduler	*scheduler;
+	pint		*array;
+	puint64		sum;
+	pint		pattern;
+
+	scheduler = p_task_scheduler_new (4);
+	P_TEST_REQUIRE (scheduler != NULL);
+
+	array = (pint *) p_malloc (PSORT_PARALLEL_COUNT * sizeof (pint));
+	P_TEST_REQUIRE (array != NULL);
+
+	for (pattern = 0; pattern < 7; ++pattern) {
+		fill_pattern (array, PSORT_PARALLEL_COUNT, pattern);
+		sum = array_sum (array, PSORT_PARALLEL_COUNT);
+
+		p_sort_parallel (scheduler, array, PSORT_PARALLEL_COUNT, sizeof (pint), compare_int, NULL);
+
+		P_TEST_CHECK (is_sorted (array, PSORT_PARALLEL_COUNT) == TRUE);
+		P_TEST_CHECK (array_sum (array, PSORT_PARALLEL_COUNT) == sum);
+	}
+
+	/* Without a scheduler sorts in the calling thread */
+	fill_pattern (array, 1000, 0);
+	p_sort_parallel (NULL, array, 1000, sizeof (pint), compare_int, NULL);
+	P_TEST_CHECK (is_sorted (array, 1000) == TRUE);
+
+	p_free (array);
+	p_task_scheduler_free (scheduler);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (psort_search_test)
+{
+	p_libsys_init ();
+
+	pint	array[100];
+	puint32	u32[100];
+	puint64	u64[100];
+	pint	key;
+	pint	count;
+	pint	i;
+	psize	lower;
+	psize	upper;
+
+	/* Each value repeats twice: 0, 0, 2, 2, 4, 4, ... */
+	for (i = 0; i < 100; ++i) {
+		array[i] = (i / 2) * 2;
+		u32[i]   = (puint32) array[i];
+		u64[i]   = (puint64) array[i] << 33;
+	}
+
+	for (count = 1; count <= 100; ++count) {
+		for (key = -1; key <= 200; ++key) {
+			lower = p_lower_bound (array, (psize) count, sizeof (pint), &key, compare_int, NULL);
+			upper = p_upper_bound (array, (psize) count, sizeof (pint), &key, compare_int, NULL);
+
+			P_TEST_CHECK (lower <= upper && upper <= (psize) count);
+			P_TEST_CHECK (lower == (psize) count || array[lower] >= key);
+			P_TEST_CHECK (lower == 0 || array[lower - 1] < key);
+			P_TEST_CHECK (upper == (psize) count || array[upper] > key);
+			P_TEST_CHECK (upper == 0 || array[upper - 1] <= key);
+
+			if (key >= 0) {
+				P_TEST_CHECK (p_lower_bound_uint32 (u32, (psize) count, (puint32) key) == lower);
+				P_TEST_CHECK (p_lower_bound_uint64 (u64, (psize) count, (puint64) key << 33) == lower);
+			}
+		}
+	}
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (psort_nomem_test);
+	P_TEST_SUITE_RUN_CASE (psort_invalid_test);
+	P_TEST_SUITE_RUN_CASE (psort_general_test);
+	P_TEST_SUITE_RUN_CASE (psort_stable_test);
+	P_TEST_SUITE_RUN_CASE (psort_radix_test);
+	P_TEST_SUITE_RUN_CASE (psort_parallel_test);
+	P_TEST_SUITE_RUN_CASE (psort_search_test);
+}
+P_TEST_SUITE_END()
@@ -0,0 +1,262 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <stdio.h>
+#include <string.h>
+
+P_TEST_MODULE_INIT ();
+
+static pint test_destroy_counter = 0;
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static void test_destroy_func (ppointer data)
+{
+	P_UNUSED (data);
+	++test_destroy_counter;
+}
+
+P_TEST_CASE_BEGIN (pstrhashtable_nomem_test)
+{
+	p_libsys_init ();
+
+	PStrHashTable *table = p_str_hash_table_new (NULL);
+	P_TEST_REQUIRE (table != NULL);
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (p_str_hash_table_new (NULL) == NULL);
+	P_TEST_CHECK (p_str_hash_table_insert (table, "key", PINT_TO_POINTER (1)) == FALSE);
+
+	p_mem_restore_vtable ();
+
+	P_TEST_CHECK (p_str_hash_table_size (table) == 0);
+	P_TEST_CHECK (p_str_hash_table_lookup (table, "key") == (ppointer) -1);
+
+	p_str_hash_table_free (table);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pstrhashtable_invalid_test)
+{
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_str_hash_table_insert (NULL, "key", NULL) == FALSE);
+	P_TEST_CHECK (p_str_hash_table_insert_len (NULL, "key", 3, NULL) == FALSE);
+	P_TEST_CHECK (p_str_hash_table_lookup (NULL, "key") == (ppointer) -1);
+	P_TEST_CHECK (p_str_hash_table_lookup_len (NULL, "key", 3) == (ppointer) -1);
+	P_TEST_CHECK (p_str_hash_table_remove (NULL, "key") == FALSE);
+	P_TEST_CHECK (p_str_hash_table_remove_len (NULL, "key", 3) == FALSE);
+	P_TEST_CHECK (p_str_hash_table_size (NULL) == 0);
+	P_TEST_CHECK (p_str_hash_table_iter_next (NULL, NULL, NULL, NULL) == FALSE);
+	p_str_hash_table_iter_init (NULL, NULL);
+	p_str_hash_table_iter_remove (NULL);
+	p_str_hash_table_free (NULL);
+
+	PStrHashTable *table = p_str_hash_table_new (NULL);
+	P_TEST_REQUIRE (table != NULL);
+
+	P_TEST_CHECK (p_str_hash_table_insert (table, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_str_hash_table_insert_len (table, NULL, 1, NULL) == FALSE);
+	P_TEST_CHECK (p_str_hash_table_lookup (table, NULL) == (ppointer) -1);
+	P_TEST_CHECK (p_str_hash_table_lookup_len (table, NULL, 1) == (ppointer) -1);
+	P_TEST_CHECK (p_str_hash_table_remove (table, NULL) == FALSE);
+	P_TEST_CHECK (p_str_hash_table_remove_len (table, NULL, 1) == FALSE);
+	P_TEST_CHECK (p_str_hash_table_size (table) == 0);
+
+	p_str_hash_table_free (table);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pstrhashtable_general_test)
+{
+	p_libsys_init ();
+
+	test_destroy_counter = 0;
+
+	PStrHashTable *table = p_str_hash_table_new (test_destroy_func);
+	P_TEST_REQUIRE (table != NULL);
+
+	pchar key[16];
+	strcpy (key, "Host");
+
+	P_TEST_CHECK (p_str_hash_table_insert (table, key, PINT_TO_POINTER (1)) == TRUE);
+	P_TEST_CHECK (p_str_hash_table_insert (table, "Content-Type", PINT_TO_POINTER (2)) == TRUE);
+	P_TEST_CHECK (p_str_hash_table_insert (table, "", PINT_TO_POINTER (3)) == TRUE);
+	P_TEST_CHECK (p_str_hash_table_size (table) == 3);
+
+	/* Keys are copied */
+	strcpy (key, "Xost");
+
+	P_TEST_CHECK (p_str_hash_table_lookup (table, "Host") == PINT_TO_POINTER (1));
+	P_TEST_CHECK (p_str_hash_table_lookup (table, "Xost") == (ppointer) -1);
+	P_TEST_CHECK (p_str_hash_table_lookup (table, "Content-Type") == PINT_TO_POINTER (2));
+	P_TEST_CHECK (p_str_hash_table_lookup (table, "") == PINT_TO_POINTER (3));
+	P_TEST_CHECK (p_str_hash_table_lookup_len (table, NULL, 0) == PINT_TO_POINTER (3));
+
+	/* Slices of a buffer */
+	const pchar *line = "Content-Type: text/plain";
+
+	P_TEST_CHECK (p_str_hash_table_lookup_len (table, line, 12) == PINT_TO_POINTER (2));
+	P_TEST_CHECK (p_str_hash_table_lookup_len (table, line, 7) == (ppointer) -1);
+	P_TEST_CHECK (p_str_hash_table_lookup_len (table, line, 13) == (ppointer) -1);
+
+	/* Embedded zeros */
+	P_TEST_CHECK (p_str_hash_table_insert_len (table, "a\0b", 3, PINT_TO_POINTER (4)) == TRUE);
+	P_TEST_CHECK (p_str_hash_table_lookup_len (table, "a\0b", 3) == PINT_TO_POINTER (4));
+	P_TEST_CHECK (p_str_hash_table_lookup (table, "a") == (ppointer) -1);
+
+	/* Replacement destroys the old value */
+	P_TEST_CHECK (p_str_hash_table_insert_len (table, line, 4, PINT_TO_POINTER (5)) == TRUE);
+	P_TEST_CHECK (p_str_hash_table_insert (table, "Cont", PINT_TO_POINTER (6)) == TRUE);
+	P_TEST_CHECK (test_destroy_counter == 1);
+	P_TEST_CHECK (p_str_hash_table_lookup (table, "Cont") == PINT_TO_POINTER (6));
+	P_TEST_CHECK (p_str_hash_table_size (table) == 5);
+
+	P_TEST_CHECK (p_str_hash_table_remove (table, "Host") == TRUE);
+	P_TEST_CHECK (p_str_hash_table_remove (table, "Host") == FALSE);
+	P_TEST_CHECK (p_str_hash_table_remove_len (table, line, 12) == TRUE);
+	P_TEST_CHECK (test_destroy_counter == 3);
+	P_TEST_CHECK (p_str_hash_table_lookup (table, "Host") == (ppointer) -1);
+	P_TEST_CHECK (p_str_hash_table_lookup (table, "Content-Type") == (ppointer) -1);
+	P_TEST_CHECK (p_str_hash_table_size (table) == 3);
+
+	p_str_hash_table_free (table);
+
+	P_TEST_CHECK (test_destroy_counter == 6);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pstrhashtable_stress_test)
+{
+	p_libsys_init ();
+
+	PStrHashTable *table = p_str_hash_table_new (NULL);
+	P_TEST_REQUIRE (table != NULL);
+
+	pchar key[32];
+
+	/* Long keys and many rounds of churn to go through rebuilds and key
+	 * compaction */
+	pchar *long_key = (pchar *) p_malloc0 (5000);
+	P_TEST_REQUIRE (long_key != NULL);
+
+	memset (long_key, 'k', 4999);
+	P_TEST_CHECK (p_str_hash_table_insert (table, long_key, PINT_TO_POINTER (-1)) == TRUE);
+
+	for (pint round = 0; round < 10; ++round) {
+		for (pint i = 0; i < 1000; ++i) {
+			snprintf (key, sizeof (key), "key_%d_%d", round, i);
+			P_TEST_CHECK (p_str_hash_table_insert (table, key, PINT_TO_POINTER (i)) == TRUE);
+		}
+
+		for (pint i = 0; i < 1000; ++i) {
+			snprintf (key, sizeof (key), "key_%d_%d", round, i);
+			P_TEST_CHECK (p_str_hash_table_lookup (table, key) == PINT_TO_POINTER (i));
+
+			if (i % 10 != 0)
+				P_TEST_CHECK (p_str_hash_table_remove (table, key) == TRUE);
+		}
+	}
+
+	P_TEST_CHECK (p_str_hash_table_size (table) == 1001);
+	P_TEST_CHECK (p_str_hash_table_lookup (table, long_key) == PINT_TO_POINTER (-1));
+
+	for (pint round = 0; round < 10; ++round) {
+		for (pint i = 0; i < 1000; ++i) {
+			snprintf (key, sizeof (key), "key_%d_%d", round, i);
+			P_TEST_CHECK (p_str_hash_table_lookup (table, key) == (i % 10 == 0 ? PINT_TO_POINTER (i) : (ppointer) -1));
+		}
+	}
+
+	p_free (long_key);
+
+	/* Walk and remove a half */
+	PStrHashTableIter	iter;
+	const pchar		*iter_key;
+	psize			iter_len;
+	ppointer		iter_value;
+	psize			count = 0;
+
+	p_str_hash_table_iter_init (&iter, table);
+
+	while (p_str_hash_table_iter_next (&iter, &iter_key, &iter_len, &iter_value) == TRUE) {
+		P_TEST_CHECK (strlen (iter_key) == iter_len);
+		P_TEST_CHECK (p_str_hash_table_lookup_len (table, iter_key, iter_len) == iter_value);
+
+		if (count++ % 2 == 0) {
+			p_str_hash_table_iter_remove (&iter);
+			p_str_hash_table_iter_remove (&iter);
+		}
+	}
+
+	P_TEST_CHECK (count == 1001);
+	P_TEST_CHECK (p_str_hash_table_size (table) == 500);
+
+	p_str_hash_table_free (table);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pstrhashtable_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pstrhashtable_invalid_test);
+	P_TEST_SUITE_RUN_CASE (pstrhashtable_general_test);
+	P_TEST_SUITE_RUN_CASE (pstrhashtable_stress_test);
+}
+P_TEST_SUITE_END()
@@ -26,6 +26,7 @@
 #include "plibsys.h"
 #include "ptestmacros.h"
 
+#include <stdio.h>
 #include <string.h>
 #include <float.h>
 #include <math.h>
@@ -278,12 +279,275 @@ P_TEST_CASE_BEGIN (pstring_strtod_test)
 }
 P_TEST_CASE_END ()
 
+P_TEST_CASE_BEGIN (pstring_strtod_n_test)
+{
+	double	val;
+	puint64	bits;
+
+	p_libsys_init ();
+
+	/* Incorrect input */
+	val = 7.0;
+	P_TEST_CHECK (p_strtod_n (NULL, 3, &val) == 0);
+	P_TEST_CHECK (p_strtod_n ("1.5", 3, NULL) == 0);
+	P_TEST_CHECK (p_strtod_n ("1.5", 0, &val) == 0);
+	P_TEST_CHECK (p_strtod_n ("", 0, &val) == 0);
+	P_TEST_CHECK (p_strtod_n ("-", 1, &val) == 0);
+	P_TEST_CHECK (p_strtod_n (".", 1, &val) == 0);
+	P_TEST_CHECK (p_strtod_n ("-.e1", 4, &val) == 0);
+	P_TEST_CHECK (p_strtod_n (" 1", 2, &val) == 0);
+	P_TEST_CHECK (p_strtod_n ("e5", 2, &val) == 0);
+	P_TEST_CHECK (p_strtod_n ("in", 2, &val) == 0);
+	P_TEST_CHECK (val == 7.0);
+
+	/* Consumed length */
+	P_TEST_CHECK (p_strtod_n ("1.5;", 4, &val) == 3 && val == 1.5);
+	P_TEST_CHECK (p_strtod_n ("1.5e", 4, &val) == 3 && val == 1.5);
+	P_TEST_CHECK (p_strtod_n ("1.5e+", 5, &val) == 3 && val == 1.5);
+	P_TEST_CHECK (p_strtod_n ("1.5e-2x", 7, &val) == 6 && val == 0.015);
+	P_TEST_CHECK (p_strtod_n ("5.", 2, &val) == 2 && val == 5.0);
+	P_TEST_CHECK (p_strtod_n (".25", 3, &val) == 3 && val == 0.25);
+	P_TEST_CHECK (p_strtod_n ("+.25", 4, &val) == 4 && val == 0.25);
+	P_TEST_CHECK (p_strtod_n ("12345", 3, &val) == 3 && val == 123.0);
+	P_TEST_CHECK (p_strtod_n ("-0", 2, &val) == 2 && val == 0.0);
+
+	memcpy (&bits, &val, sizeof (bits));
+	P_TEST_CHECK (bits == (puint64) 0x8000000000000000ULL);
+
+	/* Correctly rounded values */
+	P_TEST_CHECK (p_strtod_n ("0.1", 3, &val) == 3 && val == 0.1);
+	P_TEST_CHECK (p_strtod_n ("1e23", 4, &val) == 4 && val == 1e23);
+	P_TEST_CHECK (p_strtod_n ("9007199254740993", 16, &val) == 16 && val == 9007199254740992.0);
+	P_TEST_CHECK (p_strtod_n ("9007199254740995", 16, &val) == 16 && val == 9007199254740996.0);
+	P_TEST_CHECK (p_strtod_n ("1.7976931348623157e308", 22, &val) == 22 && val == DBL_MAX);
+	P_TEST_CHECK (p_strtod_n ("2.2250738585072014e-308", 23, &val) == 23 && val == DBL_MIN);
+	P_TEST_CHECK (p_strtod_n ("3.14159265358979323846264338327950288", 37, &val) == 37 &&
+		      val == 3.141592653589793);
+
+	/* Halfway between 1 and the next double: ties to even, then just above */
+	const pchar *halfway = "1.00000000000000011102230246251565404236316680908203125";
+
+	P_TEST_CHECK (p_strtod_n (halfway, strlen (halfway), &val) == strlen (halfway) && val == 1.0);
+	P_TEST_CHECK (p_strtod_n ("1.000000000000000111022302462515654042363166809082031251", 56, &val) == 56 &&
+		      val == 1.0000000000000002);
+
+	/* Denormals, overflow and underflow */
+	P_TEST_CHECK (p_strtod_n ("4.9e-324", 8, &val) == 8);
+	memcpy (&bits, &val, sizeof (bits));
+	P_TEST_CHECK (bits == 1);
+
+	P_TEST_CHECK (p_strtod_n ("2e-324", 6, &val) == 6 && val == 0.0);
+	P_TEST_CHECK (p_strtod_n ("1e-400", 6, &val) == 6 && val == 0.0);
+	P_TEST_CHECK (p_strtod_n ("1e309", 5, &val) == 5 && val > DBL_MAX);
+	P_TEST_CHECK (p_strtod_n ("-1e99999999999", 14, &val) == 14 && val < -DBL_MAX);
+
+	/* Special values */
+	P_TEST_CHECK (p_strtod_n ("inf", 3, &val) == 3 && val > DBL_MAX);
+	P_TEST_CHECK (p_strtod_n ("-Infinity", 9, &val) == 9 && val < -DBL_MAX);
+	P_TEST_CHECK (p_strtod_n ("INFINI", 6, &val) == 3 && val > DBL_MAX);
+	P_TEST_CHECK (p_strtod_n ("NaN", 3, &val) == 3 && val != val);
+
+	/* Must agree with the legacy call */
+	P_TEST_CHECK (p_strtod_n ("-12.256", 7, &val) == 7 && val == p_strtod ("  -12.256"));
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pstring_strtoll_n_test)
+{
+	pint64	sval = 7;
+	puint64	uval = 7;
+
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_strtoll_n (NULL, 1, &sval) == 0);
+	P_TEST_CHECK (p_strtoll_n ("1", 1, NULL) == 0);
+	P_TEST_CHECK (p_strtoll_n ("", 0, &sval) == 0);
+	P_TEST_CHECK (p_strtoll_n ("-", 1, &sval) == 0);
+	P_TEST_CHECK (p_strtoll_n (" 1", 2, &sval) == 0);
+	P_TEST_CHECK (p_strtoll_n ("9223372036854775808", 19, &sval) == 0);
+	P_TEST_CHECK (p_strtoll_n ("-9223372036854775809", 20, &sval) == 0);
+	P_TEST_CHECK (sval == 7);
+
+	P_TEST_CHECK (p_strtoll_n ("0", 1, &sval) == 1 && sval == 0);
+	P_TEST_CHECK (p_strtoll_n ("+42,", 4, &sval) == 3 && sval == 42);
+	P_TEST_CHECK (p_strtoll_n ("-1234567890123", 14, &sval) == 14 && sval == -1234567890123LL);
+	P_TEST_CHECK (p_strtoll_n ("1234567890123", 4, &sval) == 4 && sval == 1234);
+	P_TEST_CHECK (p_strtoll_n ("9223372036854775807", 19, &sval) == 19 && sval == P_MAXINT64);
+	P_TEST_CHECK (p_strtoll_n ("-9223372036854775808", 20, &sval) == 20 && sval == P_MININT64);
+	P_TEST_CHECK (p_strtoll_n ("-0000000000000000000000042", 26, &sval) == 26 && sval == -42);
+	P_TEST_CHECK (p_strtoll_n ("1.5", 3, &sval) == 1 && sval == 1);
+
+	P_TEST_CHECK (p_strtoull_n (NULL, 1, &uval) == 0);
+	P_TEST_CHECK (p_strtoull_n ("1", 1, NULL) == 0);
+	P_TEST_CHECK (p_strtoull_n ("-1", 2, &uval) == 0);
+	P_TEST_CHECK (p_strtoull_n ("18446744073709551616", 20, &uval) == 0);
+	P_TEST_CHECK (p_strtoull_n ("99999999999999999999", 20, &uval) == 0);
+	P_TEST_CHECK (p_strtoull_n ("100000000000000000000", 21, &uval) == 0);
+	P_TEST_CHECK (uval == 7);
+
+	P_TEST_CHECK (p_strtoull_n ("18446744073709551615", 20, &uval) == 20 && uval == P_MAXUINT64);
+	P_TEST_CHECK (p_strtoull_n ("+10000000000000000000", 21, &uval) == 21 &&
+		      uval == (puint64) 10000000000000000000ULL);
+	P_TEST_CHECK (p_strtoull_n ("12345678 ", 9, &uval) == 8 && uval == 12345678);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pstring_hex_encode_test)
+{
+	puchar	data[256];
+	pchar	buf[sizeof (data) * 2 + 1];
+	pchar	etalon[sizeof (data) * 2 + 1];
+
+	p_libsys_init ();
+
+	for (psize i = 0; i < sizeof (data); ++i)
+		data[i] = (puchar) (255 - i);
+
+	/* Incorrect input */
+	P_TEST_CHECK (p_hex_encode (NULL, 1, buf, sizeof (buf)) == FALSE);
+	P_TEST_CHECK (p_hex_encode (data, 1, NULL, sizeof (buf)) == FALSE);
+	P_TEST_CHECK (p_hex_encode (data, 1, buf, 0) == FALSE);
+	P_TEST_CHECK (p_hex_encode (data, 1, buf, 2) == FALSE);
+	P_TEST_CHECK (p_hex_encode (NULL, 0, buf, 0) == FALSE);
+
+	/* Correct input */
+	P_TEST_CHECK (p_hex_encode (NULL, 0, buf, 1) == TRUE);
+	P_TEST_CHECK (buf[0] == '\0');
+
+	const puchar small[] = {0x00, 0x09, 0x0A, 0x7F, 0x80, 0xF0, 0xAB, 0xFF};
+
+	P_TEST_CHECK (p_hex_encode (small, sizeof (small), buf, sizeof (small) * 2 + 1) == TRUE);
+	P_TEST_CHECK (strcmp (buf, "00090a7f80f0abff") == 0);
+
+	/* Every length around the vector width, all byte values are covered */
+	for (psize len = 0; len <= sizeof (data); ++len) {
+		for (psize i = 0; i < len; ++i)
+			snprintf (etalon + i * 2, 3, "%02x", (unsigned int) data[i]);
+
+		etalon[len * 2] = '\0';
+
+		memset (buf, 'X', sizeof (buf));
+
+		P_TEST_CHECK (p_hex_encode (data, len, buf, len * 2 + 1) == TRUE);
+		P_TEST_CHECK (strcmp (buf, etalon) == 0);
+
+		if (len * 2 + 1 < sizeof (buf))
+			P_TEST_CHECK (buf[len * 2 + 1] == 'X');
+	}
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pstring_strchomp_view_test)
+{
+	p_libsys_init ();
+
+	const pchar	*view;
+	psize		len;
+	pchar		buf[64];
+
+	P_TEST_CHECK (p_strchomp_view (NULL, &len) == NULL);
+	P_TEST_CHECK (p_strchomp_view ("abc", NULL) == NULL);
+	P_TEST_CHECK (p_strtrim_inplace (NULL) == NULL);
+
+	const pchar *str = "  \r\tTest chomp string \n\v\f ";
+
+	view = p_strchomp_view (str, &len);
+	P_TEST_CHECK (view == str + 4);
+	P_TEST_CHECK (len == strlen ("Test chomp string"));
+	P_TEST_CHECK (strncmp (view, "Test chomp string", len) == 0);
+
+	view = p_strchomp_view (" \n\t ", &len);
+	P_TEST_CHECK (view != NULL && len == 0);
+
+	view = p_strchomp_view ("", &len);
+	P_TEST_CHECK (view != NULL && len == 0);
+
+	view = p_strchomp_view ("I", &len);
+	P_TEST_CHECK (view != NULL && len == 1 && *view == 'I');
+
+	strcpy (buf, "  \rTest chomp string \n\n  ");
+	P_TEST_CHECK (p_strtrim_inplace (buf) == buf);
+	P_TEST_CHECK (strcmp (buf, "Test chomp string") == 0);
+
+	strcpy (buf, "Already trimmed");
+	P_TEST_CHECK (p_strtrim_inplace (buf) == buf);
+	P_TEST_CHECK (strcmp (buf, "Already trimmed") == 0);
+
+	strcpy (buf, " \t\n");
+	P_TEST_CHECK (p_strtrim_inplace (buf) == buf);
+	P_TEST_CHECK (*buf == '\0');
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pstring_scan_test)
+{
+	pchar buf[100];
+
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_str_skip_spaces (NULL, 10) == 0);
+	P_TEST_CHECK (p_str_skip_spaces ("  ", 0) == 0);
+	P_TEST_CHECK (p_str_find_any (NULL, 10, ",") == 10);
+	P_TEST_CHECK (p_str_find_any ("a,b", 3, NULL) == 3);
+	P_TEST_CHECK (p_str_find_any ("a,b", 3, "") == 3);
+
+	/* All the whitespace characters from the "C" locale */
+	P_TEST_CHECK (p_str_skip_spaces (" \t\n\v\f\rx", 7) == 6);
+	P_TEST_CHECK (p_str_skip_spaces (" \t\n\v\f\r", 6) == 6);
+	P_TEST_CHECK (p_str_skip_spaces ("\x08", 1) == 0);
+	P_TEST_CHECK (p_str_skip_spaces ("\x0E", 1) == 0);
+	P_TEST_CHECK (p_str_skip_spaces ("\xA0", 1) == 0);
+
+	/* Every position around the vector width, must not read beyond the length */
+	for (psize len = 0; len <= sizeof (buf); ++len) {
+		for (psize pos = 0; pos <= len; ++pos) {
+			for (psize i = 0; i < len; ++i)
+				buf[i] = " \t\n\v\f\r"[i % 6];
+
+			if (pos < len)
+				buf[pos] = 'x';
+
+			if (len < sizeof (buf))
+				buf[len] = 'y';
+
+			P_TEST_CHECK (p_str_skip_spaces (buf, len) == pos);
+
+			for (psize i = 0; i < len; ++i)
+				buf[i] = (pchar) ('a' + i % 26);
+
+			if (pos < len)
+				buf[pos] = (pos % 2 == 0) ? ';' : '#';
+
+			P_TEST_CHECK (p_str_find_any (buf, len, "#;") == pos);
+			P_TEST_CHECK (p_str_find_any (buf, len, "#;=,:[]{") == pos);
+			P_TEST_CHECK (p_str_find_any (buf, len, "#;=,:[]{}") == pos);
+			P_TEST_CHECK (p_str_find_any (buf, len, pos % 2 == 0 ? ";" : "#") == pos);
+		}
+	}
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
 P_TEST_SUITE_BEGIN()
 {
 	P_TEST_SUITE_RUN_CASE (pstring_nomem_test);
 	P_TEST_SUITE_RUN_CASE (pstring_strdup_test);
 	P_TEST_SUITE_RUN_CASE (pstring_strchomp_test);
+	P_TEST_SUITE_RUN_CASE (pstring_strchomp_view_test);
 	P_TEST_SUITE_RUN_CASE (pstring_strtok_test);
 	P_TEST_SUITE_RUN_CASE (pstring_strtod_test);
+	P_TEST_SUITE_RUN_CASE (pstring_strtod_n_test);
+	P_TEST_SUITE_RUN_CASE (pstring_strtoll_n_test);
+	P_TEST_SUITE_RUN_CASE (pstring_hex_encode_test);
+	P_TEST_SUITE_RUN_CASE (pstring_scan_test);
 }
 P_TEST_SUITE_END()
@@ -0,0 +1,308 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2013-2017 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <string.h>
+#include <float.h>
+
+P_TEST_MODULE_INIT ();
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static bool
+check_double (double val, const pchar *expected)
+{
+	PStringBuilder	sb;
+	double		parsed;
+	bool		ret;
+
+	p_string_builder_init (&sb);
+
+	if (!p_string_builder_append_double (&sb, val))
+		return false;
+
+	if (expected != NULL)
+		ret = strcmp (p_string_builder_get (&sb), expected) == 0;
+	else
+		ret = p_strtod_n (p_string_builder_get (&sb), p_string_builder_length (&sb), &parsed) ==
+		      p_string_builder_length (&sb) && parsed == val;
+
+	p_string_builder_clear (&sb);
+
+	return ret;
+}
+
+P_TEST_CASE_BEGIN (pstringbuilder_nomem_test)
+{
+	PStringBuilder	sb;
+	pchar		small[P_STRING_BUILDER_INLINE_SIZE];
+
+	p_libsys_init ();
+
+	memset (small, 'a', sizeof (small));
+
+	p_string_builder_init (&sb);
+	P_TEST_CHECK (p_string_builder_append (&sb, "inline") == TRUE);
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	/* Inline storage still works, growing and detaching fail without changes */
+	P_TEST_CHECK (p_string_builder_append_len (&sb, small, P_STRING_BUILDER_INLINE_SIZE - 7) == TRUE);
+	P_TEST_CHECK (p_string_builder_append_char (&sb, 'x') == FALSE);
+	P_TEST_CHECK (p_string_builder_append_uint (&sb, 1) == FALSE);
+	P_TEST_CHECK (p_string_builder_append_double (&sb, 1.0) == FALSE);
+	P_TEST_CHECK (p_string_builder_reserve (&sb, 1) == FALSE);
+	P_TEST_CHECK (p_string_builder_length (&sb) == P_STRING_BUILDER_INLINE_SIZE - 1);
+	P_TEST_CHECK (strncmp (p_string_builder_get (&sb), "inline", 6) == 0);
+	P_TEST_CHECK (p_string_builder_detach (&sb) == NULL);
+	P_TEST_CHECK (p_string_builder_length (&sb) == P_STRING_BUILDER_INLINE_SIZE - 1);
+
+	p_mem_restore_vtable ();
+
+	p_string_builder_clear (&sb);
+
+	/* Heap buffer can't be grown */
+	P_TEST_CHECK (p_string_builder_reserve (&sb, 100) == TRUE);
+	P_TEST_CHECK (p_string_builder_append (&sb, "heap") == TRUE);
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (p_string_builder_append_len (&sb, small, sizeof (small)) == TRUE);
+	P_TEST_CHECK (p_string_builder_reserve (&sb, 1000) == FALSE);
+	P_TEST_CHECK (strncmp (p_string_builder_get (&sb), "heapaaaa", 8) == 0);
+
+	p_mem_restore_vtable ();
+
+	p_string_builder_clear (&sb);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pstringbuilder_bad_input_test)
+{
+	PStringBuilder sb;
+
+	p_libsys_init ();
+
+	p_string_builder_init (NULL);
+	p_string_builder_clear (NULL);
+	p_string_builder_truncate (NULL, 0);
+
+	P_TEST_CHECK (p_string_builder_reserve (NULL, 1) == FALSE);
+	P_TEST_CHECK (p_string_builder_append (NULL, "a") == FALSE);
+	P_TEST_CHECK (p_string_builder_append_len (NULL, "a", 1) == FALSE);
+	P_TEST_CHECK (p_string_builder_append_char (NULL, 'a') == FALSE);
+	P_TEST_CHECK (p_string_builder_append_int (NULL, 1) == FALSE);
+	P_TEST_CHECK (p_string_builder_append_uint (NULL, 1) == FALSE);
+	P_TEST_CHECK (p_string_builder_append_double (NULL, 1.0) == FALSE);
+	P_TEST_CHECK (p_string_builder_append_hex (NULL, (const puchar *) "a", 1) == FALSE);
+	P_TEST_CHECK (p_string_builder_get (NULL) == NULL);
+	P_TEST_CHECK (p_string_builder_length (NULL) == 0);
+	P_TEST_CHECK (p_string_builder_detach (NULL) == NULL);
+
+	p_string_builder_init (&sb);
+
+	P_TEST_CHECK (p_string_builder_append (&sb, NULL) == FALSE);
+	P_TEST_CHECK (p_string_builder_append_len (&sb, NULL, 1) == FALSE);
+	P_TEST_CHECK (p_string_builder_append_hex (&sb, NULL, 1) == FALSE);
+	P_TEST_CHECK (p_string_builder_reserve (&sb, (psize) -1) == FALSE);
+	P_TEST_CHECK (p_string_builder_append_len (&sb, NULL, 0) == TRUE);
+	P_TEST_CHECK (p_string_builder_append_hex (&sb, NULL, 0) == TRUE);
+	P_TEST_CHECK (p_string_builder_length (&sb) == 0);
+	P_TEST_CHECK (strcmp (p_string_builder_get (&sb), "") == 0);
+
+	p_string_builder_clear (&sb);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pstringbuilder_general_test)
+{
+	PStringBuilder	sb;
+	pchar		*str;
+
+	p_libsys_init ();
+
+	p_string_builder_init (&sb);
+
+	P_TEST_CHECK (p_string_builder_append (&sb, "id=") == TRUE);
+	P_TEST_CHECK (p_string_builder_append_uint (&sb, 42) == TRUE);
+	P_TEST_CHECK (p_string_builder_append_char (&sb, ' ') == TRUE);
+	P_TEST_CHECK (p_string_builder_append_len (&sb, "delta=xyz", 6) == TRUE);
+	P_TEST_CHECK (p_string_builder_append_int (&sb, -17) == TRUE);
+	P_TEST_CHECK (p_string_builder_append (&sb, " hash=") == TRUE);
+
+	const puchar digest[] = {0xDE, 0xAD, 0xBE, 0xEF};
+
+	P_TEST_CHECK (p_string_builder_append_hex (&sb, digest, sizeof (digest)) == TRUE);
+	P_TEST_CHECK (strcmp (p_string_builder_get (&sb), "id=42 delta=-17 hash=deadbeef") == 0);
+	P_TEST_CHECK (p_string_builder_length (&sb) == strlen ("id=42 delta=-17 hash=deadbeef"));
+
+	/* Truncation keeps the memory */
+	p_string_builder_truncate (&sb, 100);
+	P_TEST_CHECK (p_string_builder_length (&sb) == strlen ("id=42 delta=-17 hash=deadbeef"));
+	p_string_builder_truncate (&sb, 5);
+	P_TEST_CHECK (strcmp (p_string_builder_get (&sb), "id=42") == 0);
+
+	/* Inline string is copied on detach */
+	str = p_string_builder_detach (&sb);
+	P_TEST_REQUIRE (str != NULL);
+	P_TEST_CHECK (strcmp (str, "id=42") == 0);
+	P_TEST_CHECK (p_string_builder_length (&sb) == 0);
+	P_TEST_CHECK (strcmp (p_string_builder_get (&sb), "") == 0);
+	p_free (str);
+
+	/* Long string moves to the heap, the content stays */
+	for (pint i = 0; i < 10000; ++i) {
+		P_TEST_CHECK (p_string_builder_append_int (&sb, i % 10) == TRUE);
+
+		if (i == P_STRING_BUILDER_INLINE_SIZE)
+			P_TEST_CHECK (p_string_builder_get (&sb) != sb.inline_buf);
+	}
+
+	P_TEST_CHECK (p_string_builder_length (&sb) == 10000);
+
+	const pchar *data = p_string_builder_get (&sb);
+
+	for (pint i = 0; i < 10000; ++i)
+		P_TEST_CHECK (data[i] == '0' + i % 10);
+
+	P_TEST_CHECK (data[10000] == '\0');
+
+	/* Reserved space is not reallocated */
+	P_TEST_CHECK (p_string_builder_reserve (&sb, 100000) == TRUE);
+	data = p_string_builder_get (&sb);
+
+	for (pint i = 0; i < 1000; ++i)
+		P_TEST_CHECK (p_string_builder_append (&sb, "0123456789") == TRUE);
+
+	P_TEST_CHECK (p_string_builder_get (&sb) == data);
+
+	/* Heap string is handed over */
+	str = p_string_builder_detach (&sb);
+	P_TEST_CHECK (str == data);
+	P_TEST_CHECK (strlen (str) == 20000);
+	p_free (str);
+
+	p_string_builder_clear (&sb);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pstringbuilder_numbers_test)
+{
+	PStringBuilder	sb;
+	puint64		pow10 = 1;
+
+	p_libsys_init ();
+
+	p_string_builder_init (&sb);
+
+	P_TEST_CHECK (p_string_builder_append_int (&sb, 0) == TRUE);
+	P_TEST_CHECK (p_string_builder_append_char (&sb, ' ') == TRUE);
+	P_TEST_CHECK (p_string_builder_append_int (&sb, P_MININT64) == TRUE);
+	P_TEST_CHECK (p_string_builder_append_char (&sb, ' ') == TRUE);
+	P_TEST_CHECK (p_string_builder_append_int (&sb, P_MAXINT64) == TRUE);
+	P_TEST_CHECK (p_string_builder_append_char (&sb, ' ') == TRUE);
+	P_TEST_CHECK (p_string_builder_append_uint (&sb, P_MAXUINT64) == TRUE);
+
+	P_TEST_CHECK (strcmp (p_string_builder_get (&sb),
+			      "0 -9223372036854775808 9223372036854775807 18446744073709551615") == 0);
+
+	/* Every digit count */
+	for (pint i = 1; i <= 19; ++i) {
+		pint64 parsed;
+
+		pow10 *= 10;
+
+		p_string_builder_truncate (&sb, 0);
+		P_TEST_CHECK (p_string_builder_append_uint (&sb, pow10 - 1) == TRUE);
+		P_TEST_CHECK (p_string_builder_append_char (&sb, ',') == TRUE);
+		P_TEST_CHECK (p_string_builder_append_int (&sb, -((pint64) (pow10 / 10))) == TRUE);
+
+		const pchar *str   = p_string_builder_get (&sb);
+		const pchar *comma = strchr (str, ',');
+
+		P_TEST_REQUIRE (comma != NULL);
+		P_TEST_CHECK ((psize) (comma - str) == (psize) i);
+		P_TEST_CHECK (p_strtoll_n (comma + 1, strlen (comma + 1), &parsed) == strlen (comma + 1));
+		P_TEST_CHECK (parsed == -((pint64) (pow10 / 10)));
+	}
+
+	p_string_builder_clear (&sb);
+
+	/* Doubles: short when possible, always exact */
+	P_TEST_CHECK (check_double (0.0, "0"));
+	P_TEST_CHECK (check_double (-1.5, "-1.5"));
+	P_TEST_CHECK (check_double (0.1, "0.1"));
+	P_TEST_CHECK (check_double (1e100, "1e+100"));
+	P_TEST_CHECK (check_double (1.0 / 0.0, "inf"));
+	P_TEST_CHECK (check_double (-1.0 / 0.0, "-inf"));
+	P_TEST_CHECK (check_double (0.0 / 0.0, "nan"));
+	P_TEST_CHECK (check_double (0.1 + 0.2, "0.30000000000000004"));
+	P_TEST_CHECK (check_double (DBL_MAX, NULL));
+	P_TEST_CHECK (check_double (DBL_MIN, NULL));
+	P_TEST_CHECK (check_double (-DBL_MIN / 1e10, NULL));
+	P_TEST_CHECK (check_double (3.141592653589793, NULL));
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pstringbuilder_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pstringbuilder_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (pstringbuilder_general_test);
+	P_TEST_SUITE_RUN_CASE (pstringbuilder_numbers_test);
+}
+P_TEST_SUITE_END()
@@ -0,0 +1,268 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <stdio.h>
+#include <string.h>
+
+P_TEST_MODULE_INIT ();
+
+#define PSTRINGPOOL_STRESS_COUNT	5000
+#define PSTRINGPOOL_THREADS		4
+
+static PStringPool *	test_pool = NULL;
+static const pchar *	test_results[PSTRINGPOOL_THREADS][PSTRINGPOOL_STRESS_COUNT];
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static void * test_thread_func (void *data)
+{
+	pint	thread_idx = PPOINTER_TO_INT (data);
+	pchar	buf[32];
+
+	/* All the threads intern the same strings, each in its own order */
+	for (pint i = 0; i < PSTRINGPOOL_STRESS_COUNT; ++i) {
+		pint idx = (thread_idx % 2 == 0) ? i : PSTRINGPOOL_STRESS_COUNT - 1 - i;
+
+		snprintf (buf, sizeof (buf), "string_%d", idx);
+
+		const pchar *str = p_string_pool_intern (test_pool, buf);
+
+		if (str == NULL || strcmp (str, buf) != 0)
+			p_uthread_exit (-1);
+
+		test_results[thread_idx][idx] = str;
+	}
+
+	p_uthread_exit (1);
+
+	return NULL;
+}
+
+P_TEST_CASE_BEGIN (pstringpool_nomem_test)
+{
+	p_libsys_init ();
+
+	PStringPool *pool = p_string_pool_new ();
+	P_TEST_REQUIRE (pool != NULL);
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (p_string_pool_new () == NULL);
+	P_TEST_CHECK (p_string_pool_intern (pool, "string") == NULL);
+
+	p_mem_restore_vtable ();
+
+	P_TEST_CHECK (p_string_pool_size (pool) == 0);
+	P_TEST_CHECK (p_string_pool_lookup (pool, "string") == NULL);
+
+	p_string_pool_free (pool);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pstringpool_invalid_test)
+{
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_string_pool_intern (NULL, "string") == NULL);
+	P_TEST_CHECK (p_string_pool_intern_len (NULL, "string", 6) == NULL);
+	P_TEST_CHECK (p_string_pool_lookup (NULL, "string") == NULL);
+	P_TEST_CHECK (p_string_pool_size (NULL) == 0);
+	p_string_pool_free (NULL);
+
+	PStringPool *pool = p_string_pool_new ();
+	P_TEST_REQUIRE (pool != NULL);
+
+	P_TEST_CHECK (p_string_pool_intern (pool, NULL) == NULL);
+	P_TEST_CHECK (p_string_pool_intern_len (pool, NULL, 1) == NULL);
+	P_TEST_CHECK (p_string_pool_lookup (pool, NULL) == NULL);
+	P_TEST_CHECK (p_string_pool_size (pool) == 0);
+
+	p_string_pool_free (pool);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pstringpool_general_test)
+{
+	p_libsys_init ();
+
+	PStringPool *pool = p_string_pool_new ();
+	P_TEST_REQUIRE (pool != NULL);
+
+	pchar buf[16];
+	strcpy (buf, "section");
+
+	const pchar *str1 = p_string_pool_intern (pool, "section");
+	const pchar *str2 = p_string_pool_intern (pool, buf);
+
+	P_TEST_REQUIRE (str1 != NULL);
+	P_TEST_CHECK (str1 == str2);
+	P_TEST_CHECK (str1 != buf);
+	P_TEST_CHECK (strcmp (str1, "section") == 0);
+	P_TEST_CHECK (p_string_pool_size (pool) == 1);
+
+	/* Non-terminated tokens */
+	const pchar *str3 = p_string_pool_intern_len (pool, "section_name", 7);
+	const pchar *str4 = p_string_pool_intern_len (pool, "section_name", 12);
+
+	P_TEST_CHECK (str3 == str1);
+	P_TEST_REQUIRE (str4 != NULL);
+	P_TEST_CHECK (str4 != str1);
+	P_TEST_CHECK (strcmp (str4, "section_name") == 0);
+	P_TEST_CHECK (p_string_pool_size (pool) == 2);
+
+	/* Empty string */
+	const pchar *str5 = p_string_pool_intern (pool, "");
+
+	P_TEST_REQUIRE (str5 != NULL);
+	P_TEST_CHECK (*str5 == '\0');
+	P_TEST_CHECK (p_string_pool_intern_len (pool, NULL, 0) == str5);
+	P_TEST_CHECK (p_string_pool_size (pool) == 3);
+
+	P_TEST_CHECK (p_string_pool_lookup (pool, "section") == str1);
+	P_TEST_CHECK (p_string_pool_lookup (pool, "unknown") == NULL);
+	P_TEST_CHECK (p_string_pool_size (pool) == 3);
+
+	/* Long strings and many of them, to force rehashing and new chunks */
+	pchar *long_str = (pchar *) p_malloc0 (10000);
+	P_TEST_REQUIRE (long_str != NULL);
+
+	memset (long_str, 'a', 9999);
+
+	const pchar *str6 = p_string_pool_intern (pool, long_str);
+
+	P_TEST_REQUIRE (str6 != NULL);
+	P_TEST_CHECK (strcmp (str6, long_str) == 0);
+
+	const pchar *ptrs[1000];
+
+	for (pint i = 0; i < 1000; ++i) {
+		snprintf (buf, sizeof (buf), "key%d", i);
+		ptrs[i] = p_string_pool_intern (pool, buf);
+		P_TEST_REQUIRE (ptrs[i] != NULL);
+	}
+
+	P_TEST_CHECK (p_string_pool_size (pool) == 1004);
+	P_TEST_CHECK (p_string_pool_intern (pool, long_str) == str6);
+
+	for (pint i = 0; i < 1000; ++i) {
+		snprintf (buf, sizeof (buf), "key%d", i);
+		P_TEST_CHECK (p_string_pool_lookup (pool, buf) == ptrs[i]);
+		P_TEST_CHECK (strcmp (ptrs[i], buf) == 0);
+	}
+
+	p_free (long_str);
+
+	/* Interned strings are valid keys for the direct hash */
+	PHashTable *table = p_hash_table_new ();
+	P_TEST_REQUIRE (table != NULL);
+
+	p_hash_table_insert (table, (ppointer) str1, PINT_TO_POINTER (10));
+	p_hash_table_insert (table, (ppointer) str4, PINT_TO_POINTER (20));
+
+	strcpy (buf, "section");
+
+	P_TEST_CHECK (p_hash_table_lookup (table, p_string_pool_intern (pool, buf)) == PINT_TO_POINTER (10));
+	P_TEST_CHECK (p_hash_table_lookup (table, p_string_pool_intern (pool, "section_name")) == PINT_TO_POINTER (20));
+	P_TEST_CHECK (p_hash_table_lookup (table, buf) == (ppointer) -1);
+
+	p_hash_table_free (table);
+	p_string_pool_free (pool);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pstringpool_threads_test)
+{
+	PUThread *threads[PSTRINGPOOL_THREADS];
+
+	p_libsys_init ();
+
+	test_pool = p_string_pool_new ();
+	P_TEST_REQUIRE (test_pool != NULL);
+
+	for (pint i = 0; i < PSTRINGPOOL_THREADS; ++i) {
+		threads[i] = p_uthread_create ((PUThreadFunc) test_thread_func,
+					       PINT_TO_POINTER (i),
+					       TRUE,
+					       NULL);
+		P_TEST_REQUIRE (threads[i] != NULL);
+	}
+
+	for (pint i = 0; i < PSTRINGPOOL_THREADS; ++i) {
+		P_TEST_CHECK (p_uthread_join (threads[i]) == 1);
+		p_uthread_unref (threads[i]);
+	}
+
+	P_TEST_CHECK (p_string_pool_size (test_pool) == PSTRINGPOOL_STRESS_COUNT);
+
+	for (pint i = 0; i < PSTRINGPOOL_STRESS_COUNT; ++i) {
+		for (pint j = 1; j < PSTRINGPOOL_THREADS; ++j)
+			P_TEST_CHECK (test_results[j][i] == test_results[0][i]);
+	}
+
+	p_string_pool_free (test_pool);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pstringpool_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pstringpool_invalid_test);
+	P_TEST_SUITE_RUN_CASE (pstringpool_general_test);
+	P_TEST_SUITE_RUN_CASE (pstringpool_threads_test);
+}
+P_TEST_SUITE_END()
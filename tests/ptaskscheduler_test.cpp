@@ -0,0 +1,298 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+P_TEST_MODULE_INIT ();
+
+#define PTASKSCHEDULER_WORKERS		4
+#define PTASKSCHEDULER_FIB		22
+#define PTASKSCHEDULER_FIB_CUTOFF	8
+#define PTASKSCHEDULER_WIDE		10000
+#define PTASKSCHEDULER_THREADS		3
+
+typedef struct FibData_ {
+	PTaskScheduler	*scheduler;
+	pint		n;
+	pint		result;
+} FibData;
+
+static volatile pint	task_counter = 0;
+static PTaskScheduler *	task_scheduler = NULL;
+static pint		thread_results[PTASKSCHEDULER_THREADS];
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static pint fib_sequential (pint n)
+{
+	return n < 2 ? n : fib_sequential (n - 1) + fib_sequential (n - 2);
+}
+
+static void fib_task (ppointer data)
+{
+	FibData		*fib = (FibData *) data;
+	FibData		left;
+	FibData		right;
+	PTaskGroup	group;
+
+	if (fib->n < PTASKSCHEDULER_FIB_CUTOFF) {
+		fib->result = fib_sequential (fib->n);
+		return;
+	}
+
+	left.scheduler  = fib->scheduler;
+	left.n          = fib->n - 1;
+	right.scheduler = fib->scheduler;
+	right.n         = fib->n - 2;
+
+	p_task_group_init (&group, fib->scheduler);
+	p_task_group_spawn (&group, fib_task, &left);
+	fib_task (&right);
+	p_task_group_sync (&group);
+
+	fib->result = left.result + right.result;
+}
+
+static void count_task (ppointer data)
+{
+	P_UNUSED (data);
+	p_atomic_int_inc (&task_counter);
+}
+
+static void wide_task (ppointer data)
+{
+	PTaskGroup group;
+
+	P_UNUSED (data);
+
+	/* More tasks than the initial deque size */
+	p_task_group_init (&group, task_scheduler);
+
+	for (pint i = 0; i < PTASKSCHEDULER_WIDE; ++i)
+		p_task_group_spawn (&group, count_task, NULL);
+
+	p_task_group_sync (&group);
+}
+
+static ppointer fib_thread (ppointer data)
+{
+	FibData fib;
+
+	fib.scheduler = task_scheduler;
+	fib.n         = PTASKSCHEDULER_FIB - 4;
+
+	fib_task (&fib);
+
+	thread_results[P_POINTER_TO_INT (data)] = fib.result;
+
+	return NULL;
+}
+
+P_TEST_CASE_BEGIN (ptaskscheduler_nomem_test)
+{
+	p_libsys_init ();
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (p_task_scheduler_new (2) == NULL);
+
+	p_mem_restore_vtable ();
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (ptaskscheduler_bad_input_test)
+{
+	p_libsys_init ();
+
+	PTaskGroup group;
+
+	P_TEST_CHECK (p_task_scheduler_get_worker_count (NULL) == 0);
+
+	p_task_scheduler_free (NULL);
+	p_task_group_init (NULL, NULL);
+
+	p_task_group_init (&group, NULL);
+	P_TEST_CHECK (p_task_group_spawn (&group, count_task, NULL) == FALSE);
+	P_TEST_CHECK (p_task_group_spawn (NULL, count_task, NULL) == FALSE);
+
+	p_task_group_sync (NULL);
+	p_task_group_sync (&group);
+
+	PTaskScheduler *scheduler = p_task_scheduler_new (1);
+	P_TEST_REQUIRE (scheduler != NULL);
+
+	p_task_group_init (&group, scheduler);
+	P_TEST_CHECK (p_task_group_spawn (&group, NULL, NULL) == FALSE);
+	p_task_group_sync (&group);
+
+	p_task_scheduler_free (scheduler);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (ptaskscheduler_general_test)
+{
+	p_libsys_init ();
+
+	PTaskGroup group;
+
+	PTaskScheduler *scheduler = p_task_scheduler_new (0);
+	P_TEST_REQUIRE (scheduler != NULL);
+	P_TEST_CHECK (p_task_scheduler_get_worker_count (scheduler) == p_uthread_ideal_count ());
+	p_task_scheduler_free (scheduler);
+
+	scheduler = p_task_scheduler_new (PTASKSCHEDULER_WORKERS);
+	P_TEST_REQUIRE (scheduler != NULL);
+	P_TEST_CHECK (p_task_scheduler_get_worker_count (scheduler) == PTASKSCHEDULER_WORKERS);
+
+	/* Spawning from an outside thread */
+	p_atomic_int_set (&task_counter, 0);
+	p_task_group_init (&group, scheduler);
+
+	for (pint i = 0; i < 1000; ++i)
+		P_TEST_CHECK (p_task_group_spawn (&group, count_task, NULL) == TRUE);
+
+	p_task_group_sync (&group);
+	P_TEST_CHECK (p_atomic_int_get (&task_counter) == 1000);
+
+	/* Group can be reused */
+	for (pint i = 0; i < 1000; ++i)
+		P_TEST_CHECK (p_task_group_spawn (&group, count_task, NULL) == TRUE);
+
+	p_task_group_sync (&group);
+	P_TEST_CHECK (p_atomic_int_get (&task_counter) == 2000);
+
+	/* Syncing an empty group returns immediately */
+	p_task_group_sync (&group);
+
+	p_task_scheduler_free (scheduler);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (ptaskscheduler_recursive_test)
+{
+	p_libsys_init ();
+
+	FibData		fib;
+	PTaskGroup	group;
+
+	task_scheduler = p_task_scheduler_new (PTASKSCHEDULER_WORKERS);
+	P_TEST_REQUIRE (task_scheduler != NULL);
+
+	fib.scheduler = task_scheduler;
+	fib.n         = PTASKSCHEDULER_FIB;
+
+	p_task_group_init (&group, task_scheduler);
+	P_TEST_CHECK (p_task_group_spawn (&group, fib_task, &fib) == TRUE);
+	p_task_group_sync (&group);
+
+	P_TEST_CHECK (fib.result == fib_sequential (PTASKSCHEDULER_FIB));
+
+	/* Run from the outside thread directly */
+	fib.result = 0;
+	fib_task (&fib);
+
+	P_TEST_CHECK (fib.result == fib_sequential (PTASKSCHEDULER_FIB));
+
+	p_atomic_int_set (&task_counter, 0);
+
+	for (pint i = 0; i < 4; ++i)
+		P_TEST_CHECK (p_task_group_spawn (&group, wide_task, NULL) == TRUE);
+
+	p_task_group_sync (&group);
+	P_TEST_CHECK (p_atomic_int_get (&task_counter) == PTASKSCHEDULER_WIDE * 4);
+
+	p_task_scheduler_free (task_scheduler);
+	task_scheduler = NULL;
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (ptaskscheduler_thread_test)
+{
+	p_libsys_init ();
+
+	PUThread *threads[PTASKSCHEDULER_THREADS];
+
+	task_scheduler = p_task_scheduler_new (2);
+	P_TEST_REQUIRE (task_scheduler != NULL);
+
+	for (pint i = 0; i < PTASKSCHEDULER_THREADS; ++i) {
+		threads[i] = p_uthread_create (fib_thread, P_INT_TO_POINTER (i), TRUE, NULL);
+		P_TEST_REQUIRE (threads[i] != NULL);
+	}
+
+	for (pint i = 0; i < PTASKSCHEDULER_THREADS; ++i) {
+		p_uthread_join (threads[i]);
+		p_uthread_unref (threads[i]);
+
+		P_TEST_CHECK (thread_results[i] == fib_sequential (PTASKSCHEDULER_FIB - 4));
+	}
+
+	p_task_scheduler_free (task_scheduler);
+	task_scheduler = NULL;
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (ptaskscheduler_nomem_test);
+	P_TEST_SUITE_RUN_CASE (ptaskscheduler_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (ptaskscheduler_general_test);
+	P_TEST_SUITE_RUN_CASE (ptaskscheduler_recursive_test);
+	P_TEST_SUITE_RUN_CASE (ptaskscheduler_thread_test);
+}
+P_TEST_SUITE_END()
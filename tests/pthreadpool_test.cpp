@@ -0,0 +1,396 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+P_TEST_MODULE_INIT ();
+
+#define PTHREADPOOL_WORKERS	4
+#define PTHREADPOOL_TASKS	100000
+#define PTHREADPOOL_NESTED	100
+
+static volatile pint	thread_pool_counter = 0;
+static volatile pint	thread_pool_started = 0;
+static volatile pint	thread_pool_release = 0;
+static PThreadPool *	thread_pool_test = NULL;
+static volatile pint	thread_pool_bad_node = 0;
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static void count_task (ppointer data)
+{
+	P_UNUSED (data);
+	p_atomic_int_inc (&thread_pool_counter);
+}
+
+static void nested_task (ppointer data)
+{
+	pint i;
+
+	P_UNUSED (data);
+
+	for (i = 0; i < PTHREADPOOL_NESTED; ++i)
+		p_thread_pool_push (thread_pool_test, count_task, NULL);
+
+	p_atomic_int_inc (&thread_pool_counter);
+}
+
+static void numa_task (ppointer data)
+{
+	PMemArena	*arena;
+	pint		*value;
+
+	P_UNUSED (data);
+
+	arena = p_thread_pool_get_local_arena (thread_pool_test);
+
+	if (p_thread_pool_get_current_node (thread_pool_test) < 0 || arena == NULL ||
+	    p_thread_pool_get_local_arena (thread_pool_test) != arena) {
+		p_atomic_int_inc (&thread_pool_bad_node);
+		return;
+	}
+
+	/* Scratch memory is private to the worker */
+	if ((value = (pint *) p_mem_arena_alloc (arena, sizeof (pint))) == NULL) {
+		p_atomic_int_inc (&thread_pool_bad_node);
+		return;
+	}
+
+	*value = 1;
+
+	p_atomic_int_add (&thread_pool_counter, *value);
+}
+
+static void numa_nested_task (ppointer data)
+{
+	pint i;
+
+	P_UNUSED (data);
+
+	for (i = 0; i < PTHREADPOOL_NESTED; ++i)
+		p_thread_pool_push (thread_pool_test, numa_task, NULL);
+
+	p_atomic_int_inc (&thread_pool_counter);
+}
+
+static void blocking_task (ppointer data)
+{
+	P_UNUSED (data);
+
+	p_atomic_int_set (&thread_pool_started, 1);
+
+	while (p_atomic_int_get (&thread_pool_release) == 0)
+		p_uthread_sleep (1);
+
+	p_atomic_int_inc (&thread_pool_counter);
+}
+
+static ppointer release_thread (ppointer data)
+{
+	P_UNUSED (data);
+
+	p_uthread_sleep (100);
+	p_atomic_int_set (&thread_pool_release, 1);
+
+	return NULL;
+}
+
+P_TEST_CASE_BEGIN (pthreadpool_nomem_test)
+{
+	p_libsys_init ();
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (p_thread_pool_new (2) == NULL);
+	P_TEST_CHECK (p_thread_pool_new_numa (2) == NULL);
+
+	p_mem_restore_vtable ();
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pthreadpool_bad_input_test)
+{
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_thread_pool_push (NULL, count_task, NULL) == FALSE);
+	P_TEST_CHECK (p_thread_pool_push_to_node (NULL, 0, count_task, NULL) == FALSE);
+	P_TEST_CHECK (p_thread_pool_get_worker_count (NULL) == 0);
+	P_TEST_CHECK (p_thread_pool_get_node_count (NULL) == 0);
+	P_TEST_CHECK (p_thread_pool_get_current_node (NULL) == -1);
+	P_TEST_CHECK (p_thread_pool_get_local_arena (NULL) == NULL);
+	P_TEST_CHECK (p_thread_pool_get_pending_count (NULL) == 0);
+
+	p_thread_pool_wait (NULL);
+	p_thread_pool_shutdown (NULL, TRUE);
+	p_thread_pool_free (NULL);
+
+	PThreadPool *pool = p_thread_pool_new (1);
+	P_TEST_REQUIRE (pool != NULL);
+
+	P_TEST_CHECK (p_thread_pool_push (pool, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_thread_pool_push_to_node (pool, 0, NULL, NULL) == FALSE);
+
+	/* Only the workers of a NUMA pool have a node and an arena */
+	P_TEST_CHECK (p_thread_pool_get_node_count (pool) == 1);
+	P_TEST_CHECK (p_thread_pool_get_current_node (pool) == -1);
+	P_TEST_CHECK (p_thread_pool_get_local_arena (pool) == NULL);
+
+	p_thread_pool_free (pool);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pthreadpool_general_test)
+{
+	p_libsys_init ();
+
+	PThreadPool *pool = p_thread_pool_new (0);
+	P_TEST_REQUIRE (pool != NULL);
+	P_TEST_CHECK (p_thread_pool_get_worker_count (pool) == p_uthread_ideal_count ());
+	p_thread_pool_free (pool);
+
+	pool = p_thread_pool_new (PTHREADPOOL_WORKERS);
+	P_TEST_REQUIRE (pool != NULL);
+	P_TEST_CHECK (p_thread_pool_get_worker_count (pool) == PTHREADPOOL_WORKERS);
+
+	/* Waiting on an empty pool returns immediately */
+	p_thread_pool_wait (pool);
+	P_TEST_CHECK (p_thread_pool_get_pending_count (pool) == 0);
+
+	p_atomic_int_set (&thread_pool_counter, 0);
+
+	for (pint i = 0; i < PTHREADPOOL_TASKS; ++i)
+		P_TEST_CHECK (p_thread_pool_push (pool, count_task, NULL) == TRUE);
+
+	p_thread_pool_wait (pool);
+
+	P_TEST_CHECK (p_atomic_int_get (&thread_pool_counter) == PTHREADPOOL_TASKS);
+	P_TEST_CHECK (p_thread_pool_get_pending_count (pool) == 0);
+
+	/* Pool is still usable after waiting */
+	for (pint i = 0; i < PTHREADPOOL_TASKS; ++i)
+		P_TEST_CHECK (p_thread_pool_push (pool, count_task, NULL) == TRUE);
+
+	p_thread_pool_wait (pool);
+
+	P_TEST_CHECK (p_atomic_int_get (&thread_pool_counter) == PTHREADPOOL_TASKS * 2);
+
+	p_thread_pool_free (pool);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pthreadpool_nested_test)
+{
+	p_libsys_init ();
+
+	thread_pool_test = p_thread_pool_new (PTHREADPOOL_WORKERS);
+	P_TEST_REQUIRE (thread_pool_test != NULL);
+
+	p_atomic_int_set (&thread_pool_counter, 0);
+
+	for (pint i = 0; i < PTHREADPOOL_NESTED; ++i)
+		P_TEST_CHECK (p_thread_pool_push (thread_pool_test, nested_task, NULL) == TRUE);
+
+	p_thread_pool_wait (thread_pool_test);
+
+	P_TEST_CHECK (p_atomic_int_get (&thread_pool_counter) ==
+		      PTHREADPOOL_NESTED * (PTHREADPOOL_NESTED + 1));
+
+	p_thread_pool_free (thread_pool_test);
+	thread_pool_test = NULL;
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pthreadpool_shutdown_test)
+{
+	p_libsys_init ();
+
+	/* Draining runs all the queued tasks */
+	PThreadPool *pool = p_thread_pool_new (2);
+	P_TEST_REQUIRE (pool != NULL);
+
+	p_atomic_int_set (&thread_pool_counter, 0);
+
+	for (pint i = 0; i < 1000; ++i)
+		P_TEST_CHECK (p_thread_pool_push (pool, count_task, NULL) == TRUE);
+
+	p_thread_pool_shutdown (pool, TRUE);
+	P_TEST_CHECK (p_atomic_int_get (&thread_pool_counter) == 1000);
+
+	P_TEST_CHECK (p_thread_pool_push (pool, count_task, NULL) == FALSE);
+	p_thread_pool_shutdown (pool, TRUE);
+	p_thread_pool_wait (pool);
+	p_thread_pool_free (pool);
+
+	/* Dropping keeps only the running task */
+	pool = p_thread_pool_new (1);
+	P_TEST_REQUIRE (pool != NULL);
+
+	p_atomic_int_set (&thread_pool_counter, 0);
+	p_atomic_int_set (&thread_pool_started, 0);
+	p_atomic_int_set (&thread_pool_release, 0);
+
+	P_TEST_CHECK (p_thread_pool_push (pool, blocking_task, NULL) == TRUE);
+
+	while (p_atomic_int_get (&thread_pool_started) == 0)
+		p_uthread_sleep (1);
+
+	for (pint i = 0; i < 100; ++i)
+		P_TEST_CHECK (p_thread_pool_push (pool, count_task, NULL) == TRUE);
+
+	P_TEST_CHECK (p_thread_pool_get_pending_count (pool) == 100);
+
+	PUThread *thread = p_uthread_create (release_thread, NULL, TRUE, NULL);
+	P_TEST_REQUIRE (thread != NULL);
+
+	p_thread_pool_shutdown (pool, FALSE);
+
+	P_TEST_CHECK (p_atomic_int_get (&thread_pool_counter) == 1);
+	P_TEST_CHECK (p_thread_pool_get_pending_count (pool) == 0);
+
+	p_thread_pool_free (pool);
+
+	p_uthread_join (thread);
+	p_uthread_unref (thread);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pthreadpool_numa_test)
+{
+	PCpuTopology	*topology;
+	pint		n_nodes;
+	pint		numa_node;
+	pint		n_pushed;
+
+	p_libsys_init ();
+
+	topology = p_cpu_topology_new ();
+	P_TEST_REQUIRE (topology != NULL);
+
+	thread_pool_test = p_thread_pool_new_numa (PTHREADPOOL_WORKERS);
+	P_TEST_REQUIRE (thread_pool_test != NULL);
+
+	n_nodes = p_thread_pool_get_node_count (thread_pool_test);
+
+	P_TEST_CHECK (n_nodes == p_cpu_topology_get_numa_node_count (topology));
+	P_TEST_CHECK (p_thread_pool_get_worker_count (thread_pool_test) >= PTHREADPOOL_WORKERS);
+	P_TEST_CHECK (p_thread_pool_get_worker_count (thread_pool_test) >= n_nodes);
+
+	/* Only the workers have a node and an arena */
+	P_TEST_CHECK (p_thread_pool_get_current_node (thread_pool_test) == -1);
+	P_TEST_CHECK (p_thread_pool_get_local_arena (thread_pool_test) == NULL);
+
+	p_atomic_int_set (&thread_pool_counter, 0);
+	p_atomic_int_set (&thread_pool_bad_node, 0);
+
+	n_pushed = 0;
+
+	for (pint i = 0; i < PTHREADPOOL_TASKS; ++i, ++n_pushed)
+		P_TEST_CHECK (p_thread_pool_push (thread_pool_test, numa_task, NULL) == TRUE);
+
+	/* Nodes without workers fall back to a regular push */
+	for (numa_node = -1; numa_node <= P_UTHREAD_CPU_SET_SIZE; ++numa_node, ++n_pushed)
+		P_TEST_CHECK (p_thread_pool_push_to_node (thread_pool_test, numa_node, numa_task, NULL) == TRUE);
+
+	p_thread_pool_wait (thread_pool_test);
+
+	P_TEST_CHECK (p_atomic_int_get (&thread_pool_counter) == n_pushed);
+	P_TEST_CHECK (p_atomic_int_get (&thread_pool_bad_node) == 0);
+	P_TEST_CHECK (p_thread_pool_get_pending_count (thread_pool_test) == 0);
+
+	/* Workers push into their own nodes */
+	p_atomic_int_set (&thread_pool_counter, 0);
+
+	for (pint i = 0; i < PTHREADPOOL_NESTED; ++i)
+		P_TEST_CHECK (p_thread_pool_push (thread_pool_test, numa_nested_task, NULL) == TRUE);
+
+	p_thread_pool_wait (thread_pool_test);
+
+	P_TEST_CHECK (p_atomic_int_get (&thread_pool_counter) ==
+		      PTHREADPOOL_NESTED * (PTHREADPOOL_NESTED + 1));
+	P_TEST_CHECK (p_atomic_int_get (&thread_pool_bad_node) == 0);
+
+	p_thread_pool_shutdown (thread_pool_test, TRUE);
+	P_TEST_CHECK (p_thread_pool_push (thread_pool_test, numa_task, NULL) == FALSE);
+	P_TEST_CHECK (p_thread_pool_push_to_node (thread_pool_test, 0, numa_task, NULL) == FALSE);
+
+	p_thread_pool_free (thread_pool_test);
+	thread_pool_test = NULL;
+
+	/* Default is one worker per CPU */
+	thread_pool_test = p_thread_pool_new_numa (0);
+	P_TEST_REQUIRE (thread_pool_test != NULL);
+	P_TEST_CHECK (p_thread_pool_get_worker_count (thread_pool_test) >= p_cpu_topology_get_cpu_count (topology));
+	p_thread_pool_free (thread_pool_test);
+	thread_pool_test = NULL;
+
+	p_cpu_topology_free (topology);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pthreadpool_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pthreadpool_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (pthreadpool_general_test);
+	P_TEST_SUITE_RUN_CASE (pthreadpool_nested_test);
+	P_TEST_SUITE_RUN_CASE (pthreadpool_shutdown_test);
+	P_TEST_SUITE_RUN_CASE (pthreadpool_numa_test);
+}
+P_TEST_SUITE_END()
@@ -0,0 +1,164 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+P_TEST_MODULE_INIT ();
+
+#define PTICKETLOCK_THREADS	4
+#define PTICKETLOCK_ROUNDS	10000
+
+static PTicketLock *	global_ticket_lock   = NULL;
+static pint		ticket_lock_counter  = 0;
+static volatile pint	ticket_lock_inside   = 0;
+static volatile pint	ticket_lock_overlap  = 0;
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static void * ticket_lock_test_thread (void *)
+{
+	pint i;
+
+	for (i = 0; i < PTICKETLOCK_ROUNDS; ++i) {
+		if (!p_ticket_lock_trylock (global_ticket_lock)) {
+			if (!p_ticket_lock_lock (global_ticket_lock))
+				p_uthread_exit (1);
+		}
+
+		if (p_atomic_int_add (&ticket_lock_inside, 1) != 0)
+			p_atomic_int_inc (&ticket_lock_overlap);
+
+		++ticket_lock_counter;
+
+		p_atomic_int_add (&ticket_lock_inside, -1);
+
+		if (!p_ticket_lock_unlock (global_ticket_lock))
+			p_uthread_exit (1);
+	}
+
+	p_uthread_exit (0);
+
+	return NULL;
+}
+
+P_TEST_CASE_BEGIN (pticketlock_nomem_test)
+{
+	p_libsys_init ();
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+	P_TEST_CHECK (p_ticket_lock_new () == NULL);
+
+	p_mem_restore_vtable ();
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pticketlock_bad_input_test)
+{
+	p_libsys_init ();
+
+	P_TEST_REQUIRE (p_ticket_lock_lock (NULL) == FALSE);
+	P_TEST_REQUIRE (p_ticket_lock_unlock (NULL) == FALSE);
+	P_TEST_REQUIRE (p_ticket_lock_trylock (NULL) == FALSE);
+	p_ticket_lock_free (NULL);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pticketlock_general_test)
+{
+	PUThread	*thr[PTICKETLOCK_THREADS];
+	pint		i;
+
+	p_libsys_init ();
+
+	global_ticket_lock = p_ticket_lock_new ();
+	P_TEST_REQUIRE (global_ticket_lock != NULL);
+
+	P_TEST_CHECK (p_ticket_lock_trylock (global_ticket_lock) == TRUE);
+	P_TEST_CHECK (p_ticket_lock_trylock (global_ticket_lock) == FALSE);
+	P_TEST_CHECK (p_ticket_lock_unlock (global_ticket_lock) == TRUE);
+	P_TEST_CHECK (p_ticket_lock_lock (global_ticket_lock) == TRUE);
+	P_TEST_CHECK (p_ticket_lock_trylock (global_ticket_lock) == FALSE);
+	P_TEST_CHECK (p_ticket_lock_unlock (global_ticket_lock) == TRUE);
+
+	ticket_lock_counter = 0;
+	p_atomic_int_set (&ticket_lock_inside, 0);
+	p_atomic_int_set (&ticket_lock_overlap, 0);
+
+	for (i = 0; i < PTICKETLOCK_THREADS; ++i) {
+		thr[i] = p_uthread_create ((PUThreadFunc) ticket_lock_test_thread, NULL, TRUE, NULL);
+		P_TEST_REQUIRE (thr[i] != NULL);
+	}
+
+	for (i = 0; i < PTICKETLOCK_THREADS; ++i) {
+		P_TEST_CHECK (p_uthread_join (thr[i]) == 0);
+		p_uthread_unref (thr[i]);
+	}
+
+	P_TEST_CHECK (ticket_lock_counter == PTICKETLOCK_THREADS * PTICKETLOCK_ROUNDS);
+	P_TEST_CHECK (p_atomic_int_get (&ticket_lock_overlap) == 0);
+
+	P_TEST_CHECK (p_ticket_lock_trylock (global_ticket_lock) == TRUE);
+	P_TEST_CHECK (p_ticket_lock_unlock (global_ticket_lock) == TRUE);
+
+	p_ticket_lock_free (global_ticket_lock);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pticketlock_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pticketlock_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (pticketlock_general_test);
+}
+P_TEST_SUITE_END()
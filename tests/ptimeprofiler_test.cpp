@@ -71,6 +71,8 @@ P_TEST_CASE_BEGIN (ptimeprofiler_bad_input_test)
 	p_libsys_init ();
 
 	P_TEST_CHECK (p_time_profiler_elapsed_usecs (NULL) == 0);
+	P_TEST_CHECK (p_time_profiler_elapsed_nsecs (NULL) == 0);
+	P_TEST_CHECK (p_time_profiler_ticks_to_nsecs (0) == 0);
 	p_time_profiler_reset (NULL);
 	p_time_profiler_free (NULL);
 
@@ -117,10 +119,89 @@ P_TEST_CASE_BEGIN (ptimeprofiler_general_test)
 }
 P_TEST_CASE_END ()
 
+P_TEST_CASE_BEGIN (ptimeprofiler_nsecs_test)
+{
+	PTimeProfiler	profiler;
+	puint64		start_ticks;
+	puint64		ticks_nsecs;
+	puint64		nsecs;
+	puint64		usecs;
+
+	p_libsys_init ();
+
+	/* Profiler placed on the stack */
+	p_time_profiler_reset (&profiler);
+	start_ticks = p_time_profiler_ticks ();
+
+	p_uthread_sleep (50);
+
+	nsecs       = p_time_profiler_elapsed_nsecs (&profiler);
+	usecs       = p_time_profiler_elapsed_usecs (&profiler);
+	ticks_nsecs = p_time_profiler_ticks_to_nsecs (p_time_profiler_ticks () - start_ticks);
+
+	P_TEST_CHECK (nsecs >= 50 * 1000000ULL);
+	P_TEST_CHECK (usecs >= nsecs / 1000);
+	P_TEST_CHECK (ticks_nsecs >= 50 * 1000000ULL);
+
+	/* Both clocks measure the same interval */
+	P_TEST_CHECK (ticks_nsecs + 10 * 1000000ULL > nsecs && nsecs + 10 * 1000000ULL > ticks_nsecs);
+
+	p_time_profiler_reset (&profiler);
+	P_TEST_CHECK (p_time_profiler_elapsed_nsecs (&profiler) < nsecs);
+
+	/* Conversion is linear */
+	P_TEST_CHECK (p_time_profiler_ticks_to_nsecs (0) == 0);
+	nsecs = p_time_profiler_ticks_to_nsecs (1000000);
+	P_TEST_CHECK (nsecs > 0);
+	P_TEST_CHECK (p_time_profiler_ticks_to_nsecs (2000000) >= 2 * nsecs - 1);
+	P_TEST_CHECK (p_time_profiler_ticks_to_nsecs (2000000) <= 2 * nsecs + 1);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (ptimeprofiler_coarse_test)
+{
+	PTimeProfiler	profiler;
+	puint64		start_msecs;
+	puint64		last_msecs;
+	puint64		msecs;
+	puint64		elapsed;
+
+	p_libsys_init ();
+
+	start_msecs = p_time_coarse_now_msecs ();
+	last_msecs  = start_msecs;
+
+	p_time_profiler_reset (&profiler);
+
+	/* Never goes backwards */
+	for (pint i = 0; i < 100000; ++i) {
+		msecs = p_time_coarse_now_msecs ();
+		P_TEST_CHECK (msecs >= last_msecs);
+		last_msecs = msecs;
+	}
+
+	p_uthread_sleep (100);
+
+	msecs   = p_time_coarse_now_msecs ();
+	elapsed = p_time_profiler_elapsed_nsecs (&profiler) / 1000000;
+
+	/* Coarse clock lags behind by a system timer tick at most */
+	P_TEST_CHECK (msecs >= last_msecs);
+	P_TEST_CHECK (msecs - start_msecs + 20 >= elapsed);
+	P_TEST_CHECK (msecs - start_msecs <= elapsed + 20);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
 P_TEST_SUITE_BEGIN()
 {
 	P_TEST_SUITE_RUN_CASE (ptimeprofiler_nomem_test);
 	P_TEST_SUITE_RUN_CASE (ptimeprofiler_bad_input_test);
 	P_TEST_SUITE_RUN_CASE (ptimeprofiler_general_test);
+	P_TEST_SUITE_RUN_CASE (ptimeprofiler_nsecs_test);
+	P_TEST_SUITE_RUN_CASE (ptimeprofiler_coarse_test);
 }
 P_TEST_SUITE_END()
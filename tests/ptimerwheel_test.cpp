@@ -0,0 +1,445 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+P_TEST_MODULE_INIT ();
+
+#define PTIMERWHEEL_STRESS_COUNT	2000
+
+typedef struct _TimerRecord {
+	puint64			deadline;
+	puint64			fired_at;
+	pint			fired;
+	pint			repeat;
+	PTimerWheelTimer	*timer;
+} TimerRecord;
+
+static puint64 current_time = 0;
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static void record_func (PTimerWheel *wheel, PTimerWheelTimer *timer, ppointer user_data)
+{
+	TimerRecord *rec = (TimerRecord *) user_data;
+
+	P_UNUSED (wheel);
+	P_UNUSED (timer);
+
+	rec->fired_at = current_time;
+	++rec->fired;
+}
+
+static void periodic_func (PTimerWheel *wheel, PTimerWheelTimer *timer, ppointer user_data)
+{
+	TimerRecord *rec = (TimerRecord *) user_data;
+
+	++rec->fired;
+
+	if (rec->fired < rec->repeat)
+		p_timer_wheel_reschedule (wheel, timer, 10);
+}
+
+static void self_cancel_func (PTimerWheel *wheel, PTimerWheelTimer *timer, ppointer user_data)
+{
+	TimerRecord *rec = (TimerRecord *) user_data;
+
+	++rec->fired;
+
+	P_TEST_CHECK (p_timer_wheel_cancel (wheel, timer) == TRUE);
+	P_TEST_CHECK (p_timer_wheel_cancel (wheel, timer) == FALSE);
+	P_TEST_CHECK (p_timer_wheel_reschedule (wheel, timer, 10) == FALSE);
+}
+
+static void cancel_other_func (PTimerWheel *wheel, PTimerWheelTimer *timer, ppointer user_data)
+{
+	TimerRecord *rec = (TimerRecord *) user_data;
+
+	P_UNUSED (timer);
+
+	++rec->fired;
+
+	/* Both timers are due on the same tick, the other one may be pending */
+	if (rec->timer != NULL)
+		P_TEST_CHECK (p_timer_wheel_cancel (wheel, rec->timer) == TRUE);
+}
+
+static void schedule_func (PTimerWheel *wheel, PTimerWheelTimer *timer, ppointer user_data)
+{
+	TimerRecord *rec = (TimerRecord *) user_data;
+
+	P_UNUSED (timer);
+
+	++rec->fired;
+
+	/* Zero delay fires on the next tick, not within the current one */
+	P_TEST_CHECK (p_timer_wheel_schedule (wheel, 0, record_func, rec + 1) != NULL);
+}
+
+P_TEST_CASE_BEGIN (ptimerwheel_nomem_test)
+{
+	p_libsys_init ();
+
+	PTimerWheel *wheel = p_timer_wheel_new_full (1, 0);
+	P_TEST_REQUIRE (wheel != NULL);
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	TimerRecord rec;
+
+	P_TEST_CHECK (p_timer_wheel_new (1) == NULL);
+	P_TEST_CHECK (p_timer_wheel_new_full (1, 0) == NULL);
+	P_TEST_CHECK (p_timer_wheel_schedule (wheel, 10, record_func, &rec) == NULL);
+	P_TEST_CHECK (p_timer_wheel_get_count (wheel) == 0);
+	P_TEST_CHECK (p_timer_wheel_get_timeout (wheel) == -1);
+
+	p_mem_restore_vtable ();
+
+	p_timer_wheel_free (wheel);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (ptimerwheel_invalid_test)
+{
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_timer_wheel_new (0) == NULL);
+	P_TEST_CHECK (p_timer_wheel_new_full (0, 0) == NULL);
+	P_TEST_CHECK (p_timer_wheel_schedule (NULL, 0, record_func, NULL) == NULL);
+	P_TEST_CHECK (p_timer_wheel_reschedule (NULL, NULL, 0) == FALSE);
+	P_TEST_CHECK (p_timer_wheel_cancel (NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_timer_wheel_advance (NULL, 0) == 0);
+	P_TEST_CHECK (p_timer_wheel_process (NULL) == 0);
+	P_TEST_CHECK (p_timer_wheel_get_timeout (NULL) == -1);
+	P_TEST_CHECK (p_timer_wheel_get_count (NULL) == 0);
+
+	p_timer_wheel_free (NULL);
+
+	PTimerWheel *wheel = p_timer_wheel_new_full (1, 0);
+	P_TEST_REQUIRE (wheel != NULL);
+
+	P_TEST_CHECK (p_timer_wheel_schedule (wheel, 0, NULL, NULL) == NULL);
+	P_TEST_CHECK (p_timer_wheel_reschedule (wheel, NULL, 0) == FALSE);
+	P_TEST_CHECK (p_timer_wheel_cancel (wheel, NULL) == FALSE);
+
+	p_timer_wheel_free (wheel);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (ptimerwheel_general_test)
+{
+	p_libsys_init ();
+
+	/* Delays around the level boundaries */
+	const puint64 delays[] = {
+		0, 1, 2, 255, 256, 257, 511, 1000, 65535, 65536, 65537, 100000,
+		(1 << 24) - 1, 1 << 24, (1 << 24) + 1, 50000000
+	};
+
+	const psize delays_count = sizeof (delays) / sizeof (delays[0]);
+
+	TimerRecord recs[sizeof (delays) / sizeof (delays[0])];
+
+	for (pint start = 0; start < 2; ++start) {
+		/* Start at an unaligned time as well */
+		current_time = start == 0 ? 0 : 1000003;
+
+		PTimerWheel *wheel = p_timer_wheel_new_full (1, current_time);
+		P_TEST_REQUIRE (wheel != NULL);
+
+		for (psize i = 0; i < delays_count; ++i) {
+			memset (&recs[i], 0, sizeof (TimerRecord));
+
+			recs[i].deadline = current_time + (delays[i] == 0 ? 1 : delays[i]);
+			P_TEST_CHECK (p_timer_wheel_schedule (wheel, delays[i], record_func, &recs[i]) != NULL);
+		}
+
+		P_TEST_CHECK (p_timer_wheel_get_count (wheel) == delays_count);
+
+		/* Jump straight to the next possible expiration every time, no timer
+		 * may be skipped over or fire early */
+		psize fired = 0;
+
+		while (p_timer_wheel_get_count (wheel) > 0) {
+			pint timeout = p_timer_wheel_get_timeout (wheel);
+
+			P_TEST_REQUIRE (timeout >= 0);
+
+			current_time += timeout == 0 ? 1 : (puint64) timeout;
+			fired += p_timer_wheel_advance (wheel, current_time);
+		}
+
+		P_TEST_CHECK (fired == delays_count);
+		P_TEST_CHECK (p_timer_wheel_get_timeout (wheel) == -1);
+
+		for (psize i = 0; i < delays_count; ++i) {
+			P_TEST_CHECK (recs[i].fired == 1);
+			P_TEST_CHECK (recs[i].fired_at == recs[i].deadline);
+		}
+
+		p_timer_wheel_free (wheel);
+	}
+
+	/* Coarse resolution rounds up to the next tick */
+	current_time = 0;
+
+	PTimerWheel *wheel = p_timer_wheel_new_full (10, 5);
+	P_TEST_REQUIRE (wheel != NULL);
+
+	memset (recs, 0, sizeof (recs));
+
+	P_TEST_CHECK (p_timer_wheel_schedule (wheel, 12, record_func, &recs[0]) != NULL);
+	P_TEST_CHECK (p_timer_wheel_get_timeout (wheel) == 20);
+	P_TEST_CHECK (p_timer_wheel_advance (wheel, 16) == 0);
+	P_TEST_CHECK (p_timer_wheel_advance (wheel, 24) == 0);
+	P_TEST_CHECK (p_timer_wheel_advance (wheel, 25) == 1);
+	P_TEST_CHECK (recs[0].fired == 1);
+
+	/* Time going backwards is no progress */
+	P_TEST_CHECK (p_timer_wheel_schedule (wheel, 10, record_func, &recs[1]) != NULL);
+	P_TEST_CHECK (p_timer_wheel_advance (wheel, 0) == 0);
+	P_TEST_CHECK (p_timer_wheel_advance (wheel, 35) == 1);
+
+	p_timer_wheel_free (wheel);
+
+	/* Delays beyond the top level */
+	wheel = p_timer_wheel_new_full (1000, 0);
+	P_TEST_REQUIRE (wheel != NULL);
+
+	const puint64 huge_delay = (puint64) 3000000 * 1000 * 1000 * 2;
+
+	P_TEST_CHECK (p_timer_wheel_schedule (wheel, huge_delay, record_func, &recs[2]) != NULL);
+	P_TEST_CHECK (p_timer_wheel_get_timeout (wheel) == P_MAXINT32);
+
+	for (puint64 step = huge_delay / 4; step < huge_delay; step += huge_delay / 4) {
+		P_TEST_CHECK (p_timer_wheel_advance (wheel, step) == 0);
+		P_TEST_CHECK (p_timer_wheel_get_count (wheel) == 1);
+	}
+
+	P_TEST_CHECK (p_timer_wheel_advance (wheel, huge_delay - 1) == 0);
+	P_TEST_CHECK (p_timer_wheel_advance (wheel, huge_delay) == 1);
+	P_TEST_CHECK (recs[2].fired == 1);
+
+	P_TEST_CHECK (p_timer_wheel_schedule (wheel, P_MAXUINT64, record_func, &recs[3]) != NULL);
+	P_TEST_CHECK (p_timer_wheel_advance (wheel, huge_delay * 2) == 0);
+	P_TEST_CHECK (p_timer_wheel_get_count (wheel) == 1);
+
+	p_timer_wheel_free (wheel);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (ptimerwheel_cancel_test)
+{
+	p_libsys_init ();
+
+	TimerRecord *recs = (TimerRecord *) p_malloc0 (PTIMERWHEEL_STRESS_COUNT * sizeof (TimerRecord));
+	P_TEST_REQUIRE (recs != NULL);
+
+	current_time = 0;
+
+	PTimerWheel *wheel = p_timer_wheel_new_full (1, 0);
+	P_TEST_REQUIRE (wheel != NULL);
+
+	srand (500);
+
+	for (pint i = 0; i < PTIMERWHEEL_STRESS_COUNT; ++i) {
+		puint64 delay = (puint64) (rand () % 200000) + 1;
+
+		recs[i].deadline = delay;
+		recs[i].timer    = p_timer_wheel_schedule (wheel, delay, record_func, &recs[i]);
+
+		P_TEST_CHECK (recs[i].timer != NULL);
+	}
+
+	psize expected = PTIMERWHEEL_STRESS_COUNT;
+
+	/* Cancel every third timer and move every other one */
+	for (pint i = 0; i < PTIMERWHEEL_STRESS_COUNT; ++i) {
+		if (i % 3 == 0) {
+			P_TEST_CHECK (p_timer_wheel_cancel (wheel, recs[i].timer) == TRUE);
+			recs[i].deadline = 0;
+			--expected;
+		} else if (i % 2 == 0) {
+			puint64 delay = (puint64) (rand () % 300000) + 1;
+
+			P_TEST_CHECK (p_timer_wheel_reschedule (wheel, recs[i].timer, delay) == TRUE);
+			recs[i].deadline = delay;
+		}
+	}
+
+	P_TEST_CHECK (p_timer_wheel_get_count (wheel) == expected);
+
+	/* Advance in irregular steps, a timer must fire on the first step past
+	 * its deadline */
+	psize	fired     = 0;
+	puint64	prev_time = 0;
+
+	while (p_timer_wheel_get_count (wheel) > 0) {
+		prev_time     = current_time;
+		current_time += (puint64) (rand () % 700) + 1;
+
+		psize step_fired = p_timer_wheel_advance (wheel, current_time);
+
+		for (pint i = 0; i < PTIMERWHEEL_STRESS_COUNT && step_fired > 0; ++i) {
+			if (recs[i].fired_at != current_time || recs[i].fired == 0)
+				continue;
+
+			P_TEST_CHECK (recs[i].deadline > prev_time && recs[i].deadline <= current_time);
+		}
+
+		fired += step_fired;
+	}
+
+	P_TEST_CHECK (fired == expected);
+
+	for (pint i = 0; i < PTIMERWHEEL_STRESS_COUNT; ++i)
+		P_TEST_CHECK (recs[i].fired == (i % 3 == 0 ? 0 : 1));
+
+	/* Released timers are reused */
+	P_TEST_CHECK (p_timer_wheel_schedule (wheel, 10, record_func, &recs[0]) != NULL);
+	P_TEST_CHECK (p_timer_wheel_get_count (wheel) == 1);
+
+	p_timer_wheel_free (wheel);
+	p_free (recs);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (ptimerwheel_callback_test)
+{
+	p_libsys_init ();
+
+	TimerRecord recs[6];
+
+	memset (recs, 0, sizeof (recs));
+
+	current_time = 0;
+
+	PTimerWheel *wheel = p_timer_wheel_new_full (1, 0);
+	P_TEST_REQUIRE (wheel != NULL);
+
+	recs[0].repeat = 5;
+
+	P_TEST_CHECK (p_timer_wheel_schedule (wheel, 10, periodic_func, &recs[0]) != NULL);
+	P_TEST_CHECK (p_timer_wheel_schedule (wheel, 10, self_cancel_func, &recs[1]) != NULL);
+	P_TEST_CHECK (p_timer_wheel_schedule (wheel, 20, schedule_func, &recs[2]) != NULL);
+
+	/* Two timers cancelling each other on the same tick, only one fires */
+	recs[4].timer = p_timer_wheel_schedule (wheel, 30, cancel_other_func, &recs[5]);
+	recs[5].timer = p_timer_wheel_schedule (wheel, 30, cancel_other_func, &recs[4]);
+
+	P_TEST_CHECK (recs[4].timer != NULL && recs[5].timer != NULL);
+	P_TEST_CHECK (p_timer_wheel_get_count (wheel) == 5);
+
+	P_TEST_CHECK (p_timer_wheel_advance (wheel, 10) == 2);
+	P_TEST_CHECK (recs[0].fired == 1 && recs[1].fired == 1);
+	P_TEST_CHECK (p_timer_wheel_get_count (wheel) == 4);
+
+	P_TEST_CHECK (p_timer_wheel_advance (wheel, 20) == 2);
+	P_TEST_CHECK (recs[0].fired == 2 && recs[2].fired == 1 && recs[3].fired == 0);
+
+	current_time = 21;
+	P_TEST_CHECK (p_timer_wheel_advance (wheel, 21) == 1);
+	P_TEST_CHECK (recs[3].fired == 1 && recs[3].fired_at == 21);
+
+	P_TEST_CHECK (p_timer_wheel_advance (wheel, 30) == 2);
+	P_TEST_CHECK (recs[4].fired + recs[5].fired == 1);
+
+	P_TEST_CHECK (p_timer_wheel_advance (wheel, 1000) == 2);
+	P_TEST_CHECK (recs[0].fired == 5);
+	P_TEST_CHECK (p_timer_wheel_get_count (wheel) == 0);
+
+	p_timer_wheel_free (wheel);
+
+	/* Coarse clock driven wheel */
+	wheel = p_timer_wheel_new (1);
+	P_TEST_REQUIRE (wheel != NULL);
+
+	memset (recs, 0, sizeof (recs));
+
+	P_TEST_CHECK (p_timer_wheel_schedule (wheel, 5, record_func, &recs[0]) != NULL);
+	P_TEST_CHECK (p_timer_wheel_get_timeout (wheel) >= 0);
+	P_TEST_CHECK (p_timer_wheel_get_timeout (wheel) <= 5);
+
+	for (pint i = 0; i < 100 && recs[0].fired == 0; ++i) {
+		p_uthread_sleep (10);
+		p_timer_wheel_process (wheel);
+	}
+
+	P_TEST_CHECK (recs[0].fired == 1);
+
+	/* Pending timers are released without firing */
+	P_TEST_CHECK (p_timer_wheel_schedule (wheel, 100000, record_func, &recs[1]) != NULL);
+
+	p_timer_wheel_free (wheel);
+
+	P_TEST_CHECK (recs[1].fired == 0);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (ptimerwheel_nomem_test);
+	P_TEST_SUITE_RUN_CASE (ptimerwheel_invalid_test);
+	P_TEST_SUITE_RUN_CASE (ptimerwheel_general_test);
+	P_TEST_SUITE_RUN_CASE (ptimerwheel_cancel_test);
+	P_TEST_SUITE_RUN_CASE (ptimerwheel_callback_test);
+}
+P_TEST_SUITE_END()
@@ -0,0 +1,311 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <string.h>
+
+P_TEST_MODULE_INIT ();
+
+#ifdef PLIBSYS_TRACE
+#  define PTRACE_TEST_MAX_RECORDS	16384
+#  define PTRACE_TEST_THREADS		4
+#  define PTRACE_TEST_THREAD_SPANS	1000
+
+static PTraceRecord	*trace_records = NULL;
+static psize		trace_count    = 0;
+static psize		trace_calls    = 0;
+
+static void
+trace_collect (const PTraceRecord *records, psize count, ppointer user_data)
+{
+	P_UNUSED (user_data);
+
+	++trace_calls;
+
+	if (trace_count + count > PTRACE_TEST_MAX_RECORDS)
+		count = PTRACE_TEST_MAX_RECORDS - trace_count;
+
+	memcpy (trace_records + trace_count, records, count * sizeof (PTraceRecord));
+	trace_count += count;
+}
+
+static void
+trace_reset (void)
+{
+	trace_count = 0;
+	trace_calls = 0;
+}
+
+static void * trace_thread (void *)
+{
+	pint i;
+
+	for (i = 0; i < PTRACE_TEST_THREAD_SPANS; ++i) {
+		P_TRACE_BEGIN_ARGS ("thread span", i, 0);
+		P_TRACE_END;
+	}
+
+	p_uthread_exit (0);
+
+	return NULL;
+}
+#endif
+
+P_TEST_CASE_BEGIN (ptrace_bad_input_test)
+{
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_trace_start (NULL, NULL, 0) == FALSE);
+	P_TEST_CHECK (p_trace_is_enabled () == FALSE);
+	P_TEST_CHECK (p_trace_get_name (0) == NULL);
+	P_TEST_CHECK (p_trace_get_name (P_TRACE_MAX_NAMES + 1) == NULL);
+
+	p_trace_stop ();
+
+	/* Unbalanced and unrecorded spans are ignored */
+	P_TRACE_END;
+	P_TRACE_BEGIN ("not recorded");
+	P_TRACE_END;
+	P_TRACE_END;
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (ptrace_general_test)
+{
+	p_libsys_init ();
+
+#ifdef PLIBSYS_TRACE
+	puint64	last_timestamp;
+	psize	i;
+
+	trace_records = (PTraceRecord *) p_malloc0 (PTRACE_TEST_MAX_RECORDS * sizeof (PTraceRecord));
+	P_TEST_REQUIRE (trace_records != NULL);
+
+	trace_reset ();
+
+	P_TEST_REQUIRE (p_trace_start (trace_collect, NULL, 0) == TRUE);
+	P_TEST_CHECK (p_trace_is_enabled () == TRUE);
+	P_TEST_CHECK (p_trace_start (trace_collect, NULL, 0) == FALSE);
+
+	P_TRACE_BEGIN_ARGS ("outer", 10, 20);
+	P_TRACE_BEGIN ("inner");
+	p_uthread_sleep (1);
+	P_TRACE_END;
+	P_TRACE_END;
+
+	p_trace_stop ();
+
+	P_TEST_CHECK (p_trace_is_enabled () == FALSE);
+	P_TEST_CHECK (p_trace_get_dropped () == 0);
+	P_TEST_REQUIRE (trace_count == 4);
+	P_TEST_CHECK (trace_calls > 0);
+
+	P_TEST_CHECK (trace_records[0].type == P_TRACE_EVENT_TYPE_BEGIN);
+	P_TEST_CHECK (trace_records[1].type == P_TRACE_EVENT_TYPE_BEGIN);
+	P_TEST_CHECK (trace_records[2].type == P_TRACE_EVENT_TYPE_END);
+	P_TEST_CHECK (trace_records[3].type == P_TRACE_EVENT_TYPE_END);
+
+	P_TEST_CHECK (strcmp (p_trace_get_name (trace_records[0].name_id), "outer") == 0);
+	P_TEST_CHECK (strcmp (p_trace_get_name (trace_records[1].name_id), "inner") == 0);
+	P_TEST_CHECK (trace_records[2].name_id == trace_records[1].name_id);
+	P_TEST_CHECK (trace_records[3].name_id == trace_records[0].name_id);
+
+	P_TEST_CHECK (trace_records[0].args[0] == 10 && trace_records[0].args[1] == 20);
+	P_TEST_CHECK (trace_records[3].args[0] == 10 && trace_records[3].args[1] == 20);
+	P_TEST_CHECK (trace_records[1].args[0] == 0 && trace_records[1].args[1] == 0);
+
+	last_timestamp = 0;
+
+	for (i = 0; i < trace_count; ++i) {
+		P_TEST_CHECK (trace_records[i].thread_id == trace_records[0].thread_id);
+		P_TEST_CHECK (trace_records[i].timestamp >= last_timestamp);
+
+		last_timestamp = trace_records[i].timestamp;
+	}
+
+	/* The inner span has slept for a millisecond */
+	P_TEST_CHECK (trace_records[2].timestamp - trace_records[1].timestamp >= 500000);
+
+	/* Nothing is recorded after the stop */
+	trace_reset ();
+
+	P_TRACE_BEGIN ("outer");
+	P_TRACE_END;
+
+	P_TEST_REQUIRE (p_trace_start (trace_collect, NULL, 0) == TRUE);
+	p_trace_stop ();
+
+	P_TEST_CHECK (trace_count == 0);
+
+	p_free (trace_records);
+	trace_records = NULL;
+#else
+	P_TEST_CHECK (p_trace_start ((PTraceFunc) p_free, NULL, 0) == FALSE);
+	P_TEST_CHECK (p_trace_get_dropped () == 0);
+#endif
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (ptrace_threads_test)
+{
+	p_libsys_init ();
+
+#ifdef PLIBSYS_TRACE
+	PUThread	*threads[PTRACE_TEST_THREADS];
+	puint32		thread_ids[PTRACE_TEST_THREADS + 1];
+	psize		per_thread[PTRACE_TEST_THREADS + 1];
+	pint		begins;
+	psize		i;
+	pint		j;
+
+	trace_records = (PTraceRecord *) p_malloc0 (PTRACE_TEST_MAX_RECORDS * sizeof (PTraceRecord));
+	P_TEST_REQUIRE (trace_records != NULL);
+
+	trace_reset ();
+
+	P_TEST_REQUIRE (p_trace_start (trace_collect, NULL, 1) == TRUE);
+
+	for (j = 0; j < PTRACE_TEST_THREADS; ++j) {
+		threads[j] = p_uthread_create ((PUThreadFunc) trace_thread, NULL, TRUE, NULL);
+		P_TEST_REQUIRE (threads[j] != NULL);
+	}
+
+	for (j = 0; j < PTRACE_TEST_THREADS; ++j) {
+		P_TEST_CHECK (p_uthread_join (threads[j]) == 0);
+		p_uthread_unref (threads[j]);
+	}
+
+	p_trace_stop ();
+
+	P_TEST_CHECK (p_trace_get_dropped () == 0);
+	P_TEST_REQUIRE (trace_count == PTRACE_TEST_THREADS * PTRACE_TEST_THREAD_SPANS * 2);
+
+	memset (thread_ids, 0, sizeof (thread_ids));
+	memset (per_thread, 0, sizeof (per_thread));
+	begins = 0;
+
+	/* Records of a thread keep their order and pairing */
+	for (i = 0; i < trace_count; ++i) {
+		for (j = 0; j < PTRACE_TEST_THREADS; ++j) {
+			if (thread_ids[j] == 0)
+				thread_ids[j] = trace_records[i].thread_id;
+
+			if (thread_ids[j] == trace_records[i].thread_id)
+				break;
+		}
+
+		P_TEST_REQUIRE (j < PTRACE_TEST_THREADS);
+
+		P_TEST_CHECK (trace_records[i].type == (per_thread[j] % 2 == 0 ? P_TRACE_EVENT_TYPE_BEGIN :
+										  P_TRACE_EVENT_TYPE_END));
+		P_TEST_CHECK (trace_records[i].args[0] == per_thread[j] / 2);
+		P_TEST_CHECK (strcmp (p_trace_get_name (trace_records[i].name_id), "thread span") == 0);
+
+		if (trace_records[i].type == P_TRACE_EVENT_TYPE_BEGIN)
+			++begins;
+
+		++per_thread[j];
+	}
+
+	P_TEST_CHECK (begins == PTRACE_TEST_THREADS * PTRACE_TEST_THREAD_SPANS);
+
+	for (j = 0; j < PTRACE_TEST_THREADS; ++j)
+		P_TEST_CHECK (per_thread[j] == PTRACE_TEST_THREAD_SPANS * 2);
+
+	p_free (trace_records);
+	trace_records = NULL;
+#endif
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (ptrace_overflow_test)
+{
+	p_libsys_init ();
+
+#ifdef PLIBSYS_TRACE
+	pint i;
+
+	trace_records = (PTraceRecord *) p_malloc0 (PTRACE_TEST_MAX_RECORDS * sizeof (PTraceRecord));
+	P_TEST_REQUIRE (trace_records != NULL);
+
+	trace_reset ();
+
+	/* A long interval lets the buffer overflow */
+	P_TEST_REQUIRE (p_trace_start (trace_collect, NULL, 60000) == TRUE);
+
+	for (i = 0; i < P_TRACE_BUFFER_SIZE; ++i) {
+		P_TRACE_BEGIN ("overflow");
+		P_TRACE_END;
+	}
+
+	p_trace_stop ();
+
+	P_TEST_CHECK (p_trace_get_dropped () > 0);
+	P_TEST_CHECK (trace_count + p_trace_get_dropped () == P_TRACE_BUFFER_SIZE * 2);
+
+	/* Spans deeper than the limit are dropped, the outer ones are kept */
+	trace_reset ();
+
+	P_TEST_REQUIRE (p_trace_start (trace_collect, NULL, 0) == TRUE);
+	P_TEST_CHECK (p_trace_get_dropped () == 0);
+
+	for (i = 0; i < P_TRACE_MAX_DEPTH + 2; ++i)
+		P_TRACE_BEGIN_ARGS ("nested", i, 0);
+
+	for (i = 0; i < P_TRACE_MAX_DEPTH + 2; ++i)
+		P_TRACE_END;
+
+	p_trace_stop ();
+
+	P_TEST_CHECK (p_trace_get_dropped () == 4);
+	P_TEST_REQUIRE (trace_count == P_TRACE_MAX_DEPTH * 2);
+	P_TEST_CHECK (trace_records[P_TRACE_MAX_DEPTH - 1].args[0] == P_TRACE_MAX_DEPTH - 1);
+	P_TEST_CHECK (trace_records[P_TRACE_MAX_DEPTH].type == P_TRACE_EVENT_TYPE_END);
+	P_TEST_CHECK (trace_records[P_TRACE_MAX_DEPTH].args[0] == P_TRACE_MAX_DEPTH - 1);
+
+	p_free (trace_records);
+	trace_records = NULL;
+#endif
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (ptrace_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (ptrace_general_test);
+	P_TEST_SUITE_RUN_CASE (ptrace_threads_test);
+	P_TEST_SUITE_RUN_CASE (ptrace_overflow_test);
+}
+P_TEST_SUITE_END()
@@ -0,0 +1,225 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <stdio.h>
+#include <string.h>
+
+P_TEST_MODULE_INIT ();
+
+#define PTRACEEXPORTER_TEST_FILE	"." P_DIR_SEPARATOR "p_trace_exporter_test.json"
+#define PTRACEEXPORTER_TEST_MAX_SIZE	(1024 * 1024)
+
+static pchar * read_trace_file (void)
+{
+	FILE	*file;
+	pchar	*data;
+	psize	size;
+
+	if ((file = fopen (PTRACEEXPORTER_TEST_FILE, "rb")) == NULL)
+		return NULL;
+
+	if ((data = (pchar *) p_malloc0 (PTRACEEXPORTER_TEST_MAX_SIZE + 1)) == NULL) {
+		fclose (file);
+		return NULL;
+	}
+
+	size = fread (data, 1, PTRACEEXPORTER_TEST_MAX_SIZE, file);
+	data[size] = '\0';
+
+	fclose (file);
+
+	return data;
+}
+
+#ifdef PLIBSYS_TRACE
+static void * trace_thread (void *)
+{
+	for (pint i = 0; i < 10; ++i) {
+		P_TRACE_BEGIN_ARGS ("exported span", i, 7);
+		P_TRACE_END;
+	}
+
+	p_uthread_exit (0);
+
+	return NULL;
+}
+#endif
+
+P_TEST_CASE_BEGIN (ptraceexporter_bad_input_test)
+{
+	PError *error = NULL;
+
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_trace_exporter_new (NULL, &error) == NULL);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+	error = NULL;
+
+	P_TEST_CHECK (p_trace_exporter_new ("." P_DIR_SEPARATOR "p_no_such_dir"
+					    P_DIR_SEPARATOR "trace.json", &error) == NULL);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+	error = NULL;
+
+	P_TEST_CHECK (p_trace_exporter_close (NULL, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+
+	P_TEST_CHECK (p_trace_exporter_write_counters (NULL) == 0);
+	p_trace_exporter_write_records (NULL, 1, NULL);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (ptraceexporter_general_test)
+{
+	PTraceExporter	*exporter;
+	PTraceRecord	records[4];
+	PMetric		*counter;
+	PMetric		*gauge;
+	pchar		*data;
+
+	p_libsys_init ();
+
+	exporter = p_trace_exporter_new (PTRACEEXPORTER_TEST_FILE, NULL);
+	P_TEST_REQUIRE (exporter != NULL);
+
+	/* Hand-made records: unknown names and a name to escape */
+	memset (records, 0, sizeof (records));
+
+	records[0].timestamp   = 1500;
+	records[0].thread_id   = 1;
+	records[0].thread_name = "worker \"one\"";
+	records[0].type        = P_TRACE_EVENT_TYPE_BEGIN;
+	records[0].args[0]     = 42;
+	records[1]             = records[0];
+	records[1].timestamp   = 2500;
+	records[1].type        = P_TRACE_EVENT_TYPE_END;
+	records[2]             = records[0];
+	records[2].thread_id   = 40;
+	records[2].thread_name = NULL;
+	records[3]             = records[2];
+	records[3].type        = P_TRACE_EVENT_TYPE_END;
+
+	p_trace_exporter_write_records (records, 4, exporter);
+	p_trace_exporter_write_records (records, 2, exporter);
+
+	counter = p_metrics_register_counter ("test_exported", "kind=\"a\"", NULL);
+	gauge   = p_metrics_register_gauge ("test_gauge", NULL, NULL);
+
+	P_TEST_REQUIRE (counter != NULL && gauge != NULL);
+
+	p_metrics_add (counter, 5);
+	p_metrics_set (gauge, -3);
+
+	P_TEST_CHECK (p_trace_exporter_write_counters (exporter) >= 2);
+
+	p_metrics_unregister (gauge);
+	p_metrics_unregister (counter);
+
+	P_TEST_CHECK (p_trace_exporter_close (exporter, NULL) == TRUE);
+
+	data = read_trace_file ();
+	P_TEST_REQUIRE (data != NULL);
+
+	P_TEST_CHECK (strncmp (data, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 39) == 0);
+	P_TEST_CHECK (strcmp (data + strlen (data) - 4, "\n]}\n") == 0);
+
+	/* Thread names are written once */
+	P_TEST_CHECK (strstr (data, "\"args\":{\"name\":\"worker \\\"one\\\"\"}") != NULL);
+	P_TEST_CHECK (strstr (strstr (data, "worker") + 1, "worker") == NULL);
+	P_TEST_CHECK (strstr (data, "\"tid\":40,\"args\":{\"name\":\"Thread 40\"}") != NULL);
+
+	P_TEST_CHECK (strstr (data, "{\"name\":\"unknown\",\"ph\":\"B\",\"pid\":") != NULL);
+	P_TEST_CHECK (strstr (data, "\"tid\":1,\"ts\":1.500,\"args\":{\"arg0\":42,\"arg1\":0}}") != NULL);
+	P_TEST_CHECK (strstr (data, "\"ph\":\"E\"") != NULL);
+	P_TEST_CHECK (strstr (data, "\"tid\":1,\"ts\":2.500}") != NULL);
+
+	P_TEST_CHECK (strstr (data, "{\"name\":\"test_exported{kind=\\\"a\\\"}\",\"ph\":\"C\"") != NULL);
+	P_TEST_CHECK (strstr (data, "\"args\":{\"value\":5}}") != NULL);
+	P_TEST_CHECK (strstr (data, "\"args\":{\"value\":-3}}") != NULL);
+
+	p_free (data);
+
+	P_TEST_CHECK (p_file_remove (PTRACEEXPORTER_TEST_FILE, NULL) == TRUE);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (ptraceexporter_trace_test)
+{
+	p_libsys_init ();
+
+#ifdef PLIBSYS_TRACE
+	PTraceExporter	*exporter;
+	PUThread	*thread;
+	pchar		*data;
+
+	exporter = p_trace_exporter_new (PTRACEEXPORTER_TEST_FILE, NULL);
+	P_TEST_REQUIRE (exporter != NULL);
+
+	P_TEST_REQUIRE (p_trace_start (p_trace_exporter_write_records, exporter, 0) == TRUE);
+
+	thread = p_uthread_create (trace_thread, NULL, TRUE, "exporter_thread");
+	P_TEST_REQUIRE (thread != NULL);
+
+	P_TEST_CHECK (p_uthread_join (thread) == 0);
+	p_uthread_unref (thread);
+
+	p_trace_exporter_write_counters (exporter);
+
+	p_trace_stop ();
+
+	P_TEST_CHECK (p_trace_exporter_close (exporter, NULL) == TRUE);
+
+	data = read_trace_file ();
+	P_TEST_REQUIRE (data != NULL);
+
+	P_TEST_CHECK (strstr (data, "\"args\":{\"name\":\"exporter_thread\"}") != NULL);
+	P_TEST_CHECK (strstr (data, "{\"name\":\"exported span\",\"ph\":\"B\"") != NULL);
+	P_TEST_CHECK (strstr (data, "\"args\":{\"arg0\":9,\"arg1\":7}}") != NULL);
+
+	p_free (data);
+
+	P_TEST_CHECK (p_file_remove (PTRACEEXPORTER_TEST_FILE, NULL) == TRUE);
+#endif
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (ptraceexporter_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (ptraceexporter_general_test);
+	P_TEST_SUITE_RUN_CASE (ptraceexporter_trace_test);
+}
+P_TEST_SUITE_END()
@@ -70,6 +70,27 @@ extern "C" void pmem_free (ppointer block)
 	P_UNUSED (block);
 }
 
+static pint alloc_budget = 0;
+
+extern "C" ppointer pmem_alloc_limited (psize nbytes)
+{
+	if (alloc_budget <= 0)
+		return (ppointer) NULL;
+
+	--alloc_budget;
+	return (ppointer) malloc (nbytes);
+}
+
+extern "C" ppointer pmem_realloc_limited (ppointer block, psize nbytes)
+{
+	return (ppointer) realloc (block, nbytes);
+}
+
+extern "C" void pmem_free_limited (ppointer block)
+{
+	free (block);
+}
+
 static pint
 tree_complexity (PTree *tree)
 {
@@ -86,6 +107,13 @@ tree_complexity (PTree *tree)
 		double phi = (1 + sqrt (5.0)) / 2.0;
 		return (pint) (log (sqrt (5.0) * (p_tree_get_nnodes (tree) + 2)) / log (phi) - 2);
 	}
+	case P_TREE_TYPE_BTREE:
+	{
+		/* Binary search over up to 15 keys takes 4 comparisons per level,
+		 * and inner nodes have at least 8 children */
+		double height = log ((p_tree_get_nnodes (tree) + 1) / 2.0) / log (8.0) + 1;
+		return 4 * ((pint) height + 1);
+	}
 	default:
 		return p_tree_get_nnodes (tree);
 	}
@@ -163,6 +191,128 @@ tree_traverse_thres (ppointer key, ppointer value, ppointer data)
 	return tdata->traverse_counter >= tdata->traverse_thres ? TRUE : FALSE;
 }
 
+static pboolean
+tree_traverse_range (ppointer key, ppointer value, ppointer data)
+{
+	TreeData* tdata = ((TreeData *) data);
+
+	if (tdata->traverse_counter == 0)
+		tdata->cmp_counter = PPOINTER_TO_INT (key);
+
+	tree_traverse (key, value, data);
+
+	return tdata->traverse_thres > 0 && tdata->traverse_counter >= tdata->traverse_thres ? TRUE : FALSE;
+}
+
+typedef struct _TreeLinkItem {
+	pint		id;
+	PTreeLink	link;
+	bool		linked;
+} TreeLinkItem;
+
+/* Checks the red-black properties, returns the black height or -1 */
+static pint
+check_tree_link (PTreeLink *link, PTreeLink *parent, pint *count)
+{
+	if (link == NULL)
+		return 1;
+
+	if (link->parent != parent)
+		return -1;
+
+	pint left_height  = check_tree_link (link->left, link, count);
+	pint right_height = check_tree_link (link->right, link, count);
+
+	if (left_height < 0 || left_height != right_height)
+		return -1;
+
+	/* Red links have black children only */
+	if (link->color == 0x01 && ((link->left != NULL && link->left->color == 0x01) ||
+				    (link->right != NULL && link->right->color == 0x01)))
+		return -1;
+
+	++*count;
+
+	return left_height + (link->color == 0x02 ? 1 : 0);
+}
+
+/* Checks that a tree holds exactly the keys 1..count with non-zero values */
+static bool
+check_tree_contents (PTree *tree, const pint *values, pint count)
+{
+	pint expected_nodes = 0;
+	pint expected_sum   = 0;
+	bool ret            = true;
+
+	memset (&tree_data, 0, sizeof (tree_data));
+
+	for (pint j = 0; j < count; ++j) {
+		ppointer key   = PINT_TO_POINTER (j + 1);
+		ppointer found = NULL;
+
+		if (values[j] == 0) {
+			ret = ret && p_tree_lookup (tree, key) == NULL;
+			continue;
+		}
+
+		ret = ret && p_tree_lookup (tree, key) == PINT_TO_POINTER (values[j]);
+		ret = ret && p_tree_rank (tree, key) == expected_nodes;
+		ret = ret && p_tree_select (tree, expected_nodes, &found, NULL) == TRUE;
+		ret = ret && found == key;
+
+		++expected_nodes;
+		expected_sum += j + 1;
+	}
+
+	p_tree_foreach (tree, (PTraverseFunc) tree_traverse, &tree_data);
+
+	ret = ret && p_tree_get_nnodes (tree) == expected_nodes;
+	ret = ret && tree_data.traverse_counter == expected_nodes;
+	ret = ret && tree_data.key_sum == expected_sum;
+	ret = ret && tree_data.key_order_errors == 0;
+
+	return ret;
+}
+
+typedef struct _SnapshotReaderData {
+	PTree	*snapshot;
+	pint	expected_nodes;
+	pint	expected_sum;
+	pint	errors;
+} SnapshotReaderData;
+
+static void *
+snapshot_reader_thread (void *arg)
+{
+	SnapshotReaderData	*reader = (SnapshotReaderData *) arg;
+	PTreeIter		iter;
+	ppointer		key;
+
+	for (pint i = 0; i < 50; ++i) {
+		pint nodes = 0;
+		pint sum   = 0;
+
+		p_tree_iter_init (&iter, reader->snapshot);
+
+		while (p_tree_iter_next (&iter, &key, NULL) == TRUE) {
+			++nodes;
+			sum += PPOINTER_TO_INT (key);
+		}
+
+		if (nodes != reader->expected_nodes || sum != reader->expected_sum)
+			++reader->errors;
+
+		p_uthread_yield ();
+	}
+
+	/* The last references to the shared nodes may be dropped here */
+	p_tree_free (reader->snapshot);
+
+	p_uthread_exit (0);
+
+	return NULL;
+}
+
 static bool
 check_tree_data_is_zero ()
 {
@@ -485,7 +635,7 @@ P_TEST_CASE_BEGIN (ptree_nomem_test)
 
 	PMemVTable vtable;
 
-	for (int i = (int) P_TREE_TYPE_BINARY; i <= (int) P_TREE_TYPE_AVL; ++i) {
+	for (int i = (int) P_TREE_TYPE_BINARY; i <= (int) P_TREE_TYPE_BTREE; ++i) {
 		PTree *tree = p_tree_new ((PTreeType) i, (PCompareFunc) compare_keys);
 		P_TEST_CHECK (tree != NULL);
 
@@ -496,12 +646,45 @@ P_TEST_CASE_BEGIN (ptree_nomem_test)
 		P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
 
 		P_TEST_CHECK (p_tree_new ((PTreeType) i, (PCompareFunc) compare_keys) == NULL);
+		P_TEST_CHECK (p_tree_new_pooled ((PTreeType) i,
+						 (PCompareDataFunc) compare_keys,
+						 NULL,
+						 NULL,
+						 NULL) == NULL);
 		p_tree_insert (tree, PINT_TO_POINTER (1), PINT_TO_POINTER (10));
 		P_TEST_CHECK (p_tree_get_nnodes (tree) == 0);
 
 		p_mem_restore_vtable ();
 
 		p_tree_free (tree);
+
+		/* Removed nodes are reused without allocations */
+		tree = p_tree_new_pooled ((PTreeType) i, (PCompareDataFunc) compare_keys, NULL, NULL, NULL);
+		P_TEST_REQUIRE (tree != NULL);
+
+		for (int j = 0; j < 100; ++j)
+			p_tree_insert (tree, PINT_TO_POINTER (j), PINT_TO_POINTER (j));
+
+		for (int j = 0; j < 100; ++j)
+			P_TEST_CHECK (p_tree_remove (tree, PINT_TO_POINTER (j)) == TRUE);
+
+		P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+		for (int j = 0; j < 100; ++j)
+			p_tree_insert (tree, PINT_TO_POINTER (j * 3), PINT_TO_POINTER (j));
+
+		P_TEST_CHECK (p_tree_get_nnodes (tree) == 100);
+
+		for (int j = 0; j < 100; ++j)
+			P_TEST_CHECK (p_tree_lookup (tree, PINT_TO_POINTER (j * 3)) == PINT_TO_POINTER (j));
+
+		p_mem_restore_vtable ();
+
+		p_tree_clear (tree);
+		P_TEST_CHECK (p_tree_get_nnodes (tree) == 0);
+		P_TEST_CHECK (p_tree_lookup (tree, PINT_TO_POINTER (3)) == NULL);
+
+		p_tree_free (tree);
 	}
 
 	p_libsys_shutdown ();
@@ -512,7 +695,7 @@ P_TEST_CASE_BEGIN (ptree_invalid_test)
 {
 	p_libsys_init ();
 
-	for (int i = (int) P_TREE_TYPE_BINARY; i <= (int) P_TREE_TYPE_AVL; ++i) {
+	for (int i = (int) P_TREE_TYPE_BINARY; i <= (int) P_TREE_TYPE_BTREE; ++i) {
 		/* Invalid usage */
 		P_TEST_CHECK (p_tree_new ((PTreeType) i, NULL) == NULL);
 		P_TEST_CHECK (p_tree_new ((PTreeType) -1, (PCompareFunc) compare_keys) == NULL);
@@ -559,7 +742,7 @@ P_TEST_CASE_BEGIN (ptree_general_test)
 
 	p_libsys_init ();
 
-	for (int i = (int) P_TREE_TYPE_BINARY; i <= (int) P_TREE_TYPE_AVL; ++i) {
+	for (int i = (int) P_TREE_TYPE_BINARY; i <= (int) P_TREE_TYPE_BTREE; ++i) {
 		/* Test 1 */
 		tree = p_tree_new ((PTreeType) i, (PCompareFunc) compare_keys);
 
@@ -594,6 +777,19 @@ P_TEST_CASE_BEGIN (ptree_general_test)
 		p_tree_free (tree);
 
 		P_TEST_CHECK (check_tree_data_is_zero () == true);
+
+		/* Test 4 */
+		tree = p_tree_new_pooled ((PTreeType) i,
+					  (PCompareDataFunc) compare_keys_data,
+					  &tree_data,
+					  (PDestroyFunc) key_destroy_notify,
+					  (PDestroyFunc) value_destroy_notify);
+		P_TEST_CHECK (general_tree_test (tree, (PTreeType) i, true, true) == true);
+
+		memset (&tree_data, 0, sizeof (tree_data));
+		p_tree_free (tree);
+
+		P_TEST_CHECK (check_tree_data_is_zero () == true);
 	}
 
 	p_libsys_shutdown ();
@@ -606,7 +802,7 @@ P_TEST_CASE_BEGIN (ptree_stress_test)
 
 	p_libsys_init ();
 
-	for (int i = (int) P_TREE_TYPE_BINARY; i <= (int) P_TREE_TYPE_AVL; ++i) {
+	for (int i = (int) P_TREE_TYPE_BINARY; i <= (int) P_TREE_TYPE_BTREE; ++i) {
 		tree = p_tree_new_full ((PTreeType) i,
 					(PCompareDataFunc) compare_keys_data,
 					&tree_data,
@@ -617,17 +813,1051 @@ P_TEST_CASE_BEGIN (ptree_stress_test)
 			P_TEST_CHECK (stress_tree_test (tree, PTREE_STRESS_NODES) == true);
 
 		p_tree_free (tree);
+
+		tree = p_tree_new_pooled ((PTreeType) i,
+					  (PCompareDataFunc) compare_keys_data,
+					  &tree_data,
+					  NULL,
+					  NULL);
+
+		for (int j = 0; j < PTREE_STRESS_ITERATIONS / 4; ++j)
+			P_TEST_CHECK (stress_tree_test (tree, PTREE_STRESS_NODES) == true);
+
+		p_tree_free (tree);
 	}
 
 	p_libsys_shutdown ();
 }
 P_TEST_CASE_END ()
 
+P_TEST_CASE_BEGIN (ptree_btree_test)
+{
+	p_libsys_init ();
+
+	PTree *tree = p_tree_new_full (P_TREE_TYPE_BTREE,
+				       (PCompareDataFunc) compare_keys_data,
+				       NULL,
+				       (PDestroyFunc) key_destroy_notify,
+				       (PDestroyFunc) value_destroy_notify);
+	P_TEST_REQUIRE (tree != NULL);
+
+	memset (&tree_data, 0, sizeof (tree_data));
+
+	/* Sequential keys split the rightmost nodes only */
+	for (int i = 1; i <= PTREE_STRESS_NODES; ++i)
+		p_tree_insert (tree, PINT_TO_POINTER (i), PINT_TO_POINTER (i));
+
+	P_TEST_CHECK (p_tree_get_nnodes (tree) == PTREE_STRESS_NODES);
+
+	tree_data.last_key = 0;
+	p_tree_foreach (tree, (PTraverseFunc) tree_traverse, &tree_data);
+	P_TEST_CHECK (tree_data.traverse_counter == PTREE_STRESS_NODES);
+	P_TEST_CHECK (tree_data.key_order_errors == 0);
+
+	/* Remove every odd key from the middle out, then the rest backwards */
+	memset (&tree_data, 0, sizeof (tree_data));
+
+	for (int i = 1; i <= PTREE_STRESS_NODES; i += 2)
+		P_TEST_CHECK (p_tree_remove (tree, PINT_TO_POINTER ((i + PTREE_STRESS_NODES / 2) % PTREE_STRESS_NODES)) == TRUE);
+
+	P_TEST_CHECK (tree_data.key_destroy_counter == PTREE_STRESS_NODES / 2);
+	P_TEST_CHECK (p_tree_get_nnodes (tree) == PTREE_STRESS_NODES / 2);
+
+	for (int i = 1; i <= PTREE_STRESS_NODES; ++i) {
+		if (i % 2 == 0)
+			P_TEST_CHECK (p_tree_lookup (tree, PINT_TO_POINTER (i)) == PINT_TO_POINTER (i));
+		else
+			P_TEST_CHECK (p_tree_lookup (tree, PINT_TO_POINTER (i)) == NULL);
+	}
+
+	for (int i = PTREE_STRESS_NODES; i > 0; --i)
+		P_TEST_CHECK (p_tree_remove (tree, PINT_TO_POINTER (i)) == (i % 2 == 0 ? TRUE : FALSE));
+
+	P_TEST_CHECK (p_tree_get_nnodes (tree) == 0);
+	P_TEST_CHECK (tree_data.key_destroy_counter == PTREE_STRESS_NODES);
+	P_TEST_CHECK (tree_data.key_sum == PTREE_STRESS_NODES * (PTREE_STRESS_NODES + 1) / 2);
+	P_TEST_CHECK (tree_data.value_sum == tree_data.key_sum);
+
+	/* Clear destroys every pair exactly once */
+	memset (&tree_data, 0, sizeof (tree_data));
+
+	for (int i = PTREE_STRESS_NODES; i > 0; --i)
+		p_tree_insert (tree, PINT_TO_POINTER (i), PINT_TO_POINTER (i));
+
+	p_tree_clear (tree);
+
+	P_TEST_CHECK (p_tree_get_nnodes (tree) == 0);
+	P_TEST_CHECK (tree_data.key_destroy_counter == PTREE_STRESS_NODES);
+	P_TEST_CHECK (tree_data.value_destroy_counter == PTREE_STRESS_NODES);
+	P_TEST_CHECK (p_tree_lookup (tree, PINT_TO_POINTER (1)) == NULL);
+
+	p_tree_free (tree);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (ptree_range_test)
+{
+	p_libsys_init ();
+
+	for (int i = (int) P_TREE_TYPE_BINARY; i <= (int) P_TREE_TYPE_BTREE; ++i) {
+		PTree *tree = p_tree_new ((PTreeType) i, (PCompareFunc) compare_keys);
+		P_TEST_REQUIRE (tree != NULL);
+
+		ppointer key;
+		ppointer value;
+
+		P_TEST_CHECK (p_tree_lookup_lower_bound (tree, PINT_TO_POINTER (1), &key, &value) == FALSE);
+		P_TEST_CHECK (p_tree_lookup_upper_bound (tree, PINT_TO_POINTER (1), &key, &value) == FALSE);
+
+		memset (&tree_data, 0, sizeof (tree_data));
+		p_tree_foreach_range (tree, PINT_TO_POINTER (0), PINT_TO_POINTER (10), tree_traverse_range, &tree_data);
+		P_TEST_CHECK (tree_data.traverse_counter == 0);
+
+		/* Even keys from 2 to 2000 in a shuffled order */
+		for (int j = 0; j < 1000; ++j) {
+			int k = (j * 397) % 1000;
+			p_tree_insert (tree, PINT_TO_POINTER ((k + 1) * 2), PINT_TO_POINTER ((k + 1) * 20));
+		}
+
+		P_TEST_CHECK (p_tree_get_nnodes (tree) == 1000);
+
+		for (int j = 0; j <= 2001; ++j) {
+			int lower = j % 2 == 0 ? j : j + 1;
+			int upper = j % 2 == 0 ? j + 2 : j + 1;
+
+			if (lower < 2)
+				lower = 2;
+
+			if (upper < 2)
+				upper = 2;
+
+			key   = NULL;
+			value = NULL;
+
+			if (lower <= 2000) {
+				P_TEST_CHECK (p_tree_lookup_lower_bound (tree, PINT_TO_POINTER (j), &key, &value) == TRUE);
+				P_TEST_CHECK (key == PINT_TO_POINTER (lower));
+				P_TEST_CHECK (value == PINT_TO_POINTER (lower * 10));
+			} else
+				P_TEST_CHECK (p_tree_lookup_lower_bound (tree, PINT_TO_POINTER (j), &key, &value) == FALSE);
+
+			if (upper <= 2000) {
+				P_TEST_CHECK (p_tree_lookup_upper_bound (tree, PINT_TO_POINTER (j), &key, NULL) == TRUE);
+				P_TEST_CHECK (key == PINT_TO_POINTER (upper));
+			} else
+				P_TEST_CHECK (p_tree_lookup_upper_bound (tree, PINT_TO_POINTER (j), NULL, &value) == FALSE);
+		}
+
+		/* Range bounds are [from, to) */
+		memset (&tree_data, 0, sizeof (tree_data));
+		p_tree_foreach_range (tree, PINT_TO_POINTER (100), PINT_TO_POINTER (200), tree_traverse_range, &tree_data);
+
+		P_TEST_CHECK (tree_data.traverse_counter == 50);
+		P_TEST_CHECK (tree_data.key_order_errors == 0);
+		P_TEST_CHECK (tree_data.cmp_counter == 100);
+		P_TEST_CHECK (tree_data.last_key == 198);
+
+		memset (&tree_data, 0, sizeof (tree_data));
+		p_tree_foreach_range (tree, PINT_TO_POINTER (-5), PINT_TO_POINTER (5000), tree_traverse_range, &tree_data);
+
+		P_TEST_CHECK (tree_data.traverse_counter == 1000);
+		P_TEST_CHECK (tree_data.key_order_errors == 0);
+		P_TEST_CHECK (tree_data.value_sum == 10 * tree_data.key_sum);
+
+		memset (&tree_data, 0, sizeof (tree_data));
+		p_tree_foreach_range (tree, PINT_TO_POINTER (101), PINT_TO_POINTER (102), tree_traverse_range, &tree_data);
+		P_TEST_CHECK (tree_data.traverse_counter == 0);
+
+		memset (&tree_data, 0, sizeof (tree_data));
+		p_tree_foreach_range (tree, PINT_TO_POINTER (300), PINT_TO_POINTER (100), tree_traverse_range, &tree_data);
+		P_TEST_CHECK (tree_data.traverse_counter == 0);
+
+		/* Early stop */
+		memset (&tree_data, 0, sizeof (tree_data));
+		tree_data.traverse_thres = 7;
+		p_tree_foreach_range (tree, PINT_TO_POINTER (1001), PINT_TO_POINTER (2001), tree_traverse_range, &tree_data);
+
+		P_TEST_CHECK (tree_data.traverse_counter == 7);
+		P_TEST_CHECK (tree_data.cmp_counter == 1002);
+		P_TEST_CHECK (tree_data.last_key == 1014);
+
+		p_tree_free (tree);
+	}
+
+	/* Degenerated binary tree deeper than the traversal stack */
+	PTree *tree = p_tree_new (P_TREE_TYPE_BINARY, (PCompareFunc) compare_keys);
+	P_TEST_REQUIRE (tree != NULL);
+
+	for (int i = 1000; i > 0; --i)
+		p_tree_insert (tree, PINT_TO_POINTER (i), PINT_TO_POINTER (i));
+
+	memset (&tree_data, 0, sizeof (tree_data));
+	p_tree_foreach_range (tree, PINT_TO_POINTER (1), PINT_TO_POINTER (1001), tree_traverse_range, &tree_data);
+
+	P_TEST_CHECK (tree_data.traverse_counter == 1000);
+	P_TEST_CHECK (tree_data.key_order_errors == 0);
+
+	p_tree_free (tree);
+
+	p_tree_foreach_range (NULL, NULL, NULL, tree_traverse_range, NULL);
+	P_TEST_CHECK (p_tree_lookup_lower_bound (NULL, NULL, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_tree_lookup_upper_bound (NULL, NULL, NULL, NULL) == FALSE);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (ptree_iter_test)
+{
+	p_libsys_init ();
+
+	for (int i = (int) P_TREE_TYPE_BINARY; i <= (int) P_TREE_TYPE_BTREE; ++i) {
+		PTree *tree = p_tree_new ((PTreeType) i, (PCompareFunc) compare_keys);
+		P_TEST_REQUIRE (tree != NULL);
+
+		PTreeIter	iter;
+		ppointer	key;
+		ppointer	value;
+
+		p_tree_iter_init (&iter, tree);
+		P_TEST_CHECK (p_tree_iter_next (&iter, &key, &value) == FALSE);
+		P_TEST_CHECK (p_tree_iter_prev (&iter, &key, &value) == FALSE);
+
+		for (int j = 0; j < 1000; ++j) {
+			int k = (j * 397) % 1000;
+			p_tree_insert (tree, PINT_TO_POINTER (k + 1), PINT_TO_POINTER ((k + 1) * 10));
+		}
+
+		/* Forward pass */
+		p_tree_iter_init (&iter, tree);
+
+		int count = 0;
+
+		while (p_tree_iter_next (&iter, &key, &value) == TRUE) {
+			++count;
+			P_TEST_CHECK (key == PINT_TO_POINTER (count));
+			P_TEST_CHECK (value == PINT_TO_POINTER (count * 10));
+		}
+
+		P_TEST_CHECK (count == 1000);
+
+		/* Backward pass starts over from the largest key */
+		while (p_tree_iter_prev (&iter, &key, NULL) == TRUE) {
+			P_TEST_CHECK (key == PINT_TO_POINTER (count));
+			--count;
+		}
+
+		P_TEST_CHECK (count == 0);
+
+		/* Changing direction in the middle */
+		p_tree_iter_init (&iter, tree);
+
+		for (int j = 1; j <= 500; ++j)
+			P_TEST_CHECK (p_tree_iter_next (&iter, &key, NULL) == TRUE);
+
+		P_TEST_CHECK (key == PINT_TO_POINTER (500));
+
+		for (int j = 499; j >= 250; --j) {
+			P_TEST_CHECK (p_tree_iter_prev (&iter, &key, NULL) == TRUE);
+			P_TEST_CHECK (key == PINT_TO_POINTER (j));
+		}
+
+		for (int j = 251; j <= 1000; ++j) {
+			P_TEST_CHECK (p_tree_iter_next (&iter, NULL, &value) == TRUE);
+			P_TEST_CHECK (value == PINT_TO_POINTER (j * 10));
+		}
+
+		P_TEST_CHECK (p_tree_iter_next (&iter, &key, NULL) == FALSE);
+		P_TEST_CHECK (p_tree_iter_next (&iter, &key, NULL) == TRUE);
+		P_TEST_CHECK (key == PINT_TO_POINTER (1));
+
+		/* Merge join with a tree of the multiples of 3 */
+		PTree *other = p_tree_new ((PTreeType) i, (PCompareFunc) compare_keys);
+		P_TEST_REQUIRE (other != NULL);
+
+		for (int j = 3000; j > 0; j -= 3)
+			p_tree_insert (other, PINT_TO_POINTER (j), NULL);
+
+		PTreeIter	other_iter;
+		ppointer	other_key;
+		int		matches = 0;
+
+		p_tree_iter_init (&iter, tree);
+		p_tree_iter_init (&other_iter, other);
+
+		pboolean has_left  = p_tree_iter_next (&iter, &key, NULL);
+		pboolean has_right = p_tree_iter_next (&other_iter, &other_key, NULL);
+
+		while (has_left == TRUE && has_right == TRUE) {
+			if (PPOINTER_TO_INT (key) < PPOINTER_TO_INT (other_key))
+				has_left = p_tree_iter_next (&iter, &key, NULL);
+			else if (PPOINTER_TO_INT (key) > PPOINTER_TO_INT (other_key))
+				has_right = p_tree_iter_next (&other_iter, &other_key, NULL);
+			else {
+				++matches;
+				has_left  = p_tree_iter_next (&iter, &key, NULL);
+				has_right = p_tree_iter_next (&other_iter, &other_key, NULL);
+			}
+		}
+
+		P_TEST_CHECK (matches == 333);
+
+		p_tree_free (other);
+		p_tree_free (tree);
+	}
+
+	/* Degenerated binary trees deeper than the iterator path */
+	for (int i = 0; i < 2; ++i) {
+		PTree *tree = p_tree_new (P_TREE_TYPE_BINARY, (PCompareFunc) compare_keys);
+		P_TEST_REQUIRE (tree != NULL);
+
+		for (int j = 1; j <= 1000; ++j)
+			p_tree_insert (tree, PINT_TO_POINTER (i == 0 ? j : 1001 - j), NULL);
+
+		PTreeIter	iter;
+		ppointer	key;
+		int		count = 0;
+
+		p_tree_iter_init (&iter, tree);
+
+		while (p_tree_iter_next (&iter, &key, NULL) == TRUE) {
+			++count;
+			P_TEST_CHECK (key == PINT_TO_POINTER (count));
+		}
+
+		P_TEST_CHECK (count == 1000);
+
+		while (p_tree_iter_prev (&iter, &key, NULL) == TRUE) {
+			P_TEST_CHECK (key == PINT_TO_POINTER (count));
+			--count;
+		}
+
+		P_TEST_CHECK (count == 0);
+
+		p_tree_free (tree);
+	}
+
+	p_tree_iter_init (NULL, NULL);
+	P_TEST_CHECK (p_tree_iter_next (NULL, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_tree_iter_prev (NULL, NULL, NULL) == FALSE);
+
+	PTreeIter iter;
+
+	p_tree_iter_init (&iter, NULL);
+	P_TEST_CHECK (p_tree_iter_next (&iter, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_tree_iter_prev (&iter, NULL, NULL) == FALSE);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (ptree_sorted_test)
+{
+	p_libsys_init ();
+
+	const psize counts[] = {0, 1, 2, 3, 7, 8, 15, 16, 17, 100, 255, 256, 1000, 4097};
+	ppointer keys[4097];
+	ppointer values[4097];
+
+	for (int j = 0; j < 4097; ++j) {
+		keys[j]   = PINT_TO_POINTER ((j + 1) * 2);
+		values[j] = PINT_TO_POINTER ((j + 1) * 20);
+	}
+
+	for (int i = (int) P_TREE_TYPE_BINARY; i <= (int) P_TREE_TYPE_BTREE; ++i) {
+		for (psize c = 0; c < sizeof (counts) / sizeof (counts[0]); ++c) {
+			psize	count  = counts[c];
+			pint	height = 0;
+
+			for (psize k = count; k > 0; k >>= 1)
+				++height;
+
+			memset (&tree_data, 0, sizeof (tree_data));
+
+			PTree *tree = p_tree_new_from_sorted ((PTreeType) i,
+							      (PCompareDataFunc) compare_keys_data,
+							      &tree_data,
+							      (PDestroyFunc) key_destroy_notify,
+							      (PDestroyFunc) value_destroy_notify,
+							      keys,
+							      values,
+							      count);
+			P_TEST_REQUIRE (tree != NULL);
+
+			/* Only the order check compares the keys */
+			P_TEST_CHECK (tree_data.cmp_counter == (count > 0 ? (pint) count - 1 : 0));
+			P_TEST_CHECK (p_tree_get_nnodes (tree) == (pint) count);
+			P_TEST_CHECK (p_tree_get_type (tree) == (PTreeType) i);
+
+			for (psize j = 0; j < count; ++j) {
+				tree_data.cmp_counter = 0;
+
+				P_TEST_CHECK (p_tree_lookup (tree, keys[j]) == values[j]);
+
+				/* Binary trees are perfectly balanced */
+				if (i == (int) P_TREE_TYPE_BTREE)
+					P_TEST_CHECK (tree_data.cmp_counter <= tree_complexity (tree));
+				else
+					P_TEST_CHECK (tree_data.cmp_counter <= height);
+			}
+
+			P_TEST_CHECK (p_tree_lookup (tree, PINT_TO_POINTER (1)) == NULL);
+			P_TEST_CHECK (p_tree_lookup (tree, PINT_TO_POINTER ((count + 1) * 2)) == NULL);
+
+			tree_data.traverse_counter = 0;
+			tree_data.key_sum          = 0;
+			tree_data.value_sum        = 0;
+			tree_data.last_key         = 0;
+			tree_data.key_order_errors = 0;
+
+			p_tree_foreach (tree, (PTraverseFunc) tree_traverse, &tree_data);
+
+			P_TEST_CHECK (tree_data.traverse_counter == (pint) count);
+			P_TEST_CHECK (tree_data.key_order_errors == 0);
+			P_TEST_CHECK (tree_data.value_sum == 10 * tree_data.key_sum);
+
+			/* The built tree has to stay valid under further changes */
+			for (psize j = 0; j < count; j += 2)
+				P_TEST_CHECK (p_tree_remove (tree, keys[j]) == TRUE);
+
+			for (psize j = 0; j < count; ++j)
+				p_tree_insert (tree, PINT_TO_POINTER ((pint) j * 2 + 1), NULL);
+
+			P_TEST_CHECK (p_tree_get_nnodes (tree) == (pint) (count + count / 2));
+
+			for (psize j = 0; j < count; ++j) {
+				P_TEST_CHECK (p_tree_lookup (tree, keys[j]) == (j % 2 == 0 ? NULL : values[j]));
+
+				tree_data.cmp_counter = 0;
+				P_TEST_CHECK (p_tree_lookup (tree, PINT_TO_POINTER ((pint) j * 2 + 1)) == NULL);
+				P_TEST_CHECK (tree_data.cmp_counter <= tree_complexity (tree));
+			}
+
+			tree_data.key_destroy_counter   = 0;
+			tree_data.value_destroy_counter = 0;
+
+			p_tree_free (tree);
+
+			P_TEST_CHECK (tree_data.key_destroy_counter == (pint) (count + count / 2));
+			P_TEST_CHECK (tree_data.value_destroy_counter == (pint) (count + count / 2));
+		}
+
+		/* Keys must be in a strictly ascending order */
+		ppointer unsorted[] = {PINT_TO_POINTER (1), PINT_TO_POINTER (3), PINT_TO_POINTER (2)};
+		ppointer duplicated[] = {PINT_TO_POINTER (1), PINT_TO_POINTER (2), PINT_TO_POINTER (2)};
+
+		P_TEST_CHECK (p_tree_new_from_sorted ((PTreeType) i,
+						      (PCompareDataFunc) compare_keys,
+						      NULL,
+						      NULL,
+						      NULL,
+						      unsorted,
+						      NULL,
+						      3) == NULL);
+		P_TEST_CHECK (p_tree_new_from_sorted ((PTreeType) i,
+						      (PCompareDataFunc) compare_keys,
+						      NULL,
+						      NULL,
+						      NULL,
+						      duplicated,
+						      NULL,
+						      3) == NULL);
+		P_TEST_CHECK (p_tree_new_from_sorted ((PTreeType) i,
+						      (PCompareDataFunc) compare_keys,
+						      NULL,
+						      NULL,
+						      NULL,
+						      NULL,
+						      NULL,
+						      3) == NULL);
+		P_TEST_CHECK (p_tree_new_from_sorted ((PTreeType) i,
+						      NULL,
+						      NULL,
+						      NULL,
+						      NULL,
+						      keys,
+						      NULL,
+						      3) == NULL);
+
+		/* NULL values */
+		PTree *tree = p_tree_new_from_sorted ((PTreeType) i,
+						      (PCompareDataFunc) compare_keys,
+						      NULL,
+						      NULL,
+						      NULL,
+						      keys,
+						      NULL,
+						      100);
+		P_TEST_REQUIRE (tree != NULL);
+		P_TEST_CHECK (p_tree_get_nnodes (tree) == 100);
+		P_TEST_CHECK (p_tree_lookup (tree, keys[50]) == NULL);
+		p_tree_free (tree);
+
+		/* Allocation failures in the middle of the build */
+		PMemVTable vtable;
+
+		vtable.free    = pmem_free_limited;
+		vtable.malloc  = pmem_alloc_limited;
+		vtable.realloc = pmem_realloc_limited;
+
+		for (int j = 1; j < 40; ++j) {
+			memset (&tree_data, 0, sizeof (tree_data));
+
+			alloc_budget = j;
+			P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+			tree = p_tree_new_from_sorted ((PTreeType) i,
+						       (PCompareDataFunc) compare_keys,
+						       NULL,
+						       (PDestroyFunc) key_destroy_notify,
+						       (PDestroyFunc) value_destroy_notify,
+						       keys,
+						       values,
+						       1000);
+
+			p_mem_restore_vtable ();
+
+			P_TEST_CHECK (tree == NULL);
+			P_TEST_CHECK (check_tree_data_is_zero () == true);
+		}
+	}
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (ptree_rank_test)
+{
+	p_libsys_init ();
+
+	const pint count = 1000;
+	ppointer keys[1000];
+	ppointer values[1000];
+	pint order[1000];
+	bool present[1000];
+
+	for (pint j = 0; j < count; ++j) {
+		keys[j]   = PINT_TO_POINTER ((j + 1) * 2);
+		values[j] = PINT_TO_POINTER ((j + 1) * 20);
+		order[j]  = j;
+	}
+
+	srand ((unsigned int) time (NULL));
+
+	for (pint i = (pint) P_TREE_TYPE_BINARY; i <= (pint) P_TREE_TYPE_BTREE; ++i) {
+		bool supported = (i == (pint) P_TREE_TYPE_RB || i == (pint) P_TREE_TYPE_AVL);
+
+		PTree *tree = p_tree_new ((PTreeType) i, (PCompareFunc) compare_keys);
+		P_TEST_REQUIRE (tree != NULL);
+
+		P_TEST_CHECK (p_tree_select (tree, 0, NULL, NULL) == FALSE);
+		P_TEST_CHECK (p_tree_rank (tree, PINT_TO_POINTER (10)) == (supported ? 0 : -1));
+
+		if (!supported) {
+			p_tree_insert (tree, keys[0], values[0]);
+
+			P_TEST_CHECK (p_tree_select (tree, 0, NULL, NULL) == FALSE);
+			P_TEST_CHECK (p_tree_rank (tree, keys[0]) == -1);
+
+			p_tree_free (tree);
+			continue;
+		}
+
+		for (pint j = count - 1; j > 0; --j) {
+			pint k   = rand () % (j + 1);
+			pint tmp = order[j];
+
+			order[j] = order[k];
+			order[k] = tmp;
+		}
+
+		for (pint j = 0; j < count; ++j) {
+			p_tree_insert (tree, keys[order[j]], values[order[j]]);
+			present[j] = true;
+		}
+
+		/* Remove a random half and check the positions of the rest */
+		for (pint j = 0; j < count / 2; ++j) {
+			P_TEST_CHECK (p_tree_remove (tree, keys[order[j]]) == TRUE);
+			present[order[j]] = false;
+		}
+
+		P_TEST_CHECK (p_tree_get_nnodes (tree) == count / 2);
+
+		pint pos = 0;
+
+		for (pint j = 0; j < count; ++j) {
+			/* Odd keys aren't in the tree */
+			P_TEST_CHECK (p_tree_rank (tree, PINT_TO_POINTER ((j + 1) * 2 - 1)) == pos);
+
+			if (!present[j])
+				continue;
+
+			ppointer key   = NULL;
+			ppointer value = NULL;
+
+			P_TEST_CHECK (p_tree_select (tree, pos, &key, &value) == TRUE);
+			P_TEST_CHECK (key == keys[j]);
+			P_TEST_CHECK (value == values[j]);
+			P_TEST_CHECK (p_tree_rank (tree, keys[j]) == pos);
+
+			++pos;
+		}
+
+		P_TEST_CHECK (pos == count / 2);
+		P_TEST_CHECK (p_tree_rank (tree, PINT_TO_POINTER (count * 2 + 1)) == pos);
+		P_TEST_CHECK (p_tree_select (tree, pos, NULL, NULL) == FALSE);
+		P_TEST_CHECK (p_tree_select (tree, -1, NULL, NULL) == FALSE);
+
+		/* Sizes must be reset along with the nodes */
+		p_tree_clear (tree);
+
+		P_TEST_CHECK (p_tree_select (tree, 0, NULL, NULL) == FALSE);
+		P_TEST_CHECK (p_tree_rank (tree, keys[0]) == 0);
+
+		p_tree_insert (tree, keys[1], values[1]);
+		p_tree_insert (tree, keys[0], values[0]);
+
+		P_TEST_CHECK (p_tree_rank (tree, keys[1]) == 1);
+		P_TEST_CHECK (p_tree_select (tree, 0, NULL, NULL) == TRUE);
+		P_TEST_CHECK (p_tree_select (tree, 2, NULL, NULL) == FALSE);
+
+		p_tree_free (tree);
+
+		/* Built trees have to keep the sizes as well */
+		tree = p_tree_new_from_sorted ((PTreeType) i,
+					       (PCompareDataFunc) compare_keys,
+					       NULL,
+					       NULL,
+					       NULL,
+					       keys,
+					       values,
+					       (psize) count);
+		P_TEST_REQUIRE (tree != NULL);
+
+		for (pint j = 0; j < count; ++j) {
+			ppointer key = NULL;
+
+			P_TEST_CHECK (p_tree_select (tree, j, &key, NULL) == TRUE);
+			P_TEST_CHECK (key == keys[j]);
+			P_TEST_CHECK (p_tree_rank (tree, keys[j]) == j);
+		}
+
+		for (pint j = 0; j < count; j += 3)
+			P_TEST_CHECK (p_tree_remove (tree, keys[j]) == TRUE);
+
+		pos = 0;
+
+		for (pint j = 0; j < count; ++j) {
+			if (j % 3 == 0)
+				continue;
+
+			ppointer key = NULL;
+
+			P_TEST_CHECK (p_tree_select (tree, pos, &key, NULL) == TRUE);
+			P_TEST_CHECK (key == keys[j]);
+			P_TEST_CHECK (p_tree_rank (tree, keys[j]) == pos);
+
+			++pos;
+		}
+
+		P_TEST_CHECK (pos == p_tree_get_nnodes (tree));
+
+		p_tree_free (tree);
+	}
+
+	P_TEST_CHECK (p_tree_select (NULL, 0, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_tree_rank (NULL, NULL) == -1);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (ptree_snapshot_test)
+{
+	p_libsys_init ();
+
+	const pint count = 1000;
+	pint order[1000];
+	pint values[1000];
+	pint snap_values[1000];
+
+	P_TEST_CHECK (p_tree_snapshot (NULL) == NULL);
+	P_TEST_CHECK (p_tree_new_persistent (NULL, NULL) == NULL);
+
+	for (pint i = (pint) P_TREE_TYPE_BINARY; i <= (pint) P_TREE_TYPE_BTREE; ++i) {
+		PTree *tree = p_tree_new ((PTreeType) i, (PCompareFunc) compare_keys);
+		P_TEST_REQUIRE (tree != NULL);
+		P_TEST_CHECK (p_tree_snapshot (tree) == NULL);
+		p_tree_free (tree);
+	}
+
+	srand ((unsigned int) time (NULL));
+
+	for (pint j = 0; j < count; ++j)
+		order[j] = j;
+
+	for (pint j = count - 1; j > 0; --j) {
+		pint k   = rand () % (j + 1);
+		pint tmp = order[j];
+
+		order[j] = order[k];
+		order[k] = tmp;
+	}
+
+	PTree *tree = p_tree_new_persistent ((PCompareDataFunc) compare_keys, NULL);
+	P_TEST_REQUIRE (tree != NULL);
+	P_TEST_CHECK (p_tree_get_type (tree) == P_TREE_TYPE_AVL);
+
+	/* Snapshot of an empty tree */
+	PTree *snapshot = p_tree_snapshot (tree);
+	P_TEST_REQUIRE (snapshot != NULL);
+
+	memset (values, 0, sizeof (values));
+
+	for (pint j = 0; j < count; ++j) {
+		p_tree_insert (tree, PINT_TO_POINTER (order[j] + 1), PINT_TO_POINTER (order[j] + 10));
+		values[order[j]] = order[j] + 10;
+	}
+
+	P_TEST_CHECK (p_tree_get_nnodes (snapshot) == 0);
+	P_TEST_CHECK (p_tree_lookup (snapshot, PINT_TO_POINTER (1)) == NULL);
+	P_TEST_CHECK (check_tree_contents (tree, values, count) == true);
+	p_tree_free (snapshot);
+
+	snapshot = p_tree_snapshot (tree);
+	P_TEST_REQUIRE (snapshot != NULL);
+	memcpy (snap_values, values, sizeof (values));
+
+	/* Both sides change independently */
+	for (pint j = 0; j < count / 2; ++j) {
+		P_TEST_CHECK (p_tree_remove (tree, PINT_TO_POINTER (order[j] + 1)) == TRUE);
+		values[order[j]] = 0;
+	}
+
+	for (pint j = 0; j < count; j += 7) {
+		p_tree_insert (tree, PINT_TO_POINTER (j + 1), PINT_TO_POINTER (j + 20));
+		values[j] = j + 20;
+	}
+
+	for (pint j = 0; j < count; j += 3) {
+		P_TEST_CHECK (p_tree_remove (snapshot, PINT_TO_POINTER (j + 1)) == TRUE);
+		snap_values[j] = 0;
+	}
+
+	P_TEST_CHECK (check_tree_contents (tree, values, count) == true);
+	P_TEST_CHECK (check_tree_contents (snapshot, snap_values, count) == true);
+
+	/* Changes stay balanced */
+	memset (&tree_data, 0, sizeof (tree_data));
+	PTree *counted = p_tree_new_persistent ((PCompareDataFunc) compare_keys_data, &tree_data);
+	P_TEST_REQUIRE (counted != NULL);
+
+	for (pint j = 0; j < count; ++j)
+		p_tree_insert (counted, PINT_TO_POINTER (j + 1), PINT_TO_POINTER (j + 1));
+
+	PTree *counted_snapshot = p_tree_snapshot (counted);
+	P_TEST_REQUIRE (counted_snapshot != NULL);
+
+	for (pint j = 0; j < count; j += 2)
+		P_TEST_CHECK (p_tree_remove (counted, PINT_TO_POINTER (j + 1)) == TRUE);
+
+	for (pint j = 0; j < count; ++j) {
+		tree_data.cmp_counter = 0;
+		p_tree_lookup (counted, PINT_TO_POINTER (j + 1));
+		P_TEST_CHECK (tree_data.cmp_counter <= tree_complexity (counted));
+
+		tree_data.cmp_counter = 0;
+		P_TEST_CHECK (p_tree_lookup (counted_snapshot, PINT_TO_POINTER (j + 1)) == PINT_TO_POINTER (j + 1));
+		P_TEST_CHECK (tree_data.cmp_counter <= tree_complexity (counted_snapshot));
+	}
+
+	p_tree_free (counted);
+	p_tree_free (counted_snapshot);
+
+	/* Snapshots of snapshots can be freed in any order */
+	PTree *nested = p_tree_snapshot (snapshot);
+	P_TEST_REQUIRE (nested != NULL);
+
+	p_tree_free (snapshot);
+	P_TEST_CHECK (check_tree_contents (nested, snap_values, count) == true);
+
+	p_tree_clear (nested);
+	P_TEST_CHECK (p_tree_get_nnodes (nested) == 0);
+	P_TEST_CHECK (check_tree_contents (tree, values, count) == true);
+	p_tree_free (nested);
+
+	/* Failed copies leave both trees untouched */
+	snapshot = p_tree_snapshot (tree);
+	P_TEST_REQUIRE (snapshot != NULL);
+	memcpy (snap_values, values, sizeof (values));
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (p_tree_snapshot (tree) == NULL);
+	p_tree_insert (tree, PINT_TO_POINTER (count * 2), NULL);
+	P_TEST_CHECK (p_tree_remove (tree, PINT_TO_POINTER (order[count - 1] + 1)) == FALSE);
+
+	p_mem_restore_vtable ();
+
+	P_TEST_CHECK (check_tree_contents (tree, values, count) == true);
+	P_TEST_CHECK (p_tree_lookup (tree, PINT_TO_POINTER (count * 2)) == NULL);
+
+	vtable.free    = pmem_free_limited;
+	vtable.malloc  = pmem_alloc_limited;
+	vtable.realloc = pmem_realloc_limited;
+
+	for (pint j = 0; j < count; ++j) {
+		alloc_budget = rand () % 12;
+
+		P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+		if (values[j] != 0) {
+			if (p_tree_remove (tree, PINT_TO_POINTER (j + 1)) == TRUE)
+				values[j] = 0;
+		} else {
+			p_tree_insert (tree, PINT_TO_POINTER (j + 1), PINT_TO_POINTER (j + 30));
+
+			if (p_tree_lookup (tree, PINT_TO_POINTER (j + 1)) != NULL)
+				values[j] = j + 30;
+		}
+
+		p_mem_restore_vtable ();
+	}
+
+	P_TEST_CHECK (check_tree_contents (tree, values, count) == true);
+	P_TEST_CHECK (check_tree_contents (snapshot, snap_values, count) == true);
+
+	/* Reading a snapshot while the tree is being modified */
+	SnapshotReaderData reader;
+
+	reader.snapshot       = snapshot;
+	reader.expected_nodes = 0;
+	reader.expected_sum   = 0;
+	reader.errors         = 0;
+
+	for (pint j = 0; j < count; ++j) {
+		if (snap_values[j] != 0) {
+			++reader.expected_nodes;
+			reader.expected_sum += j + 1;
+		}
+	}
+
+	PUThread *thread = p_uthread_create ((PUThreadFunc) snapshot_reader_thread, &reader, TRUE, NULL);
+	P_TEST_REQUIRE (thread != NULL);
+
+	for (pint i = 0; i < 20; ++i) {
+		for (pint j = 0; j < count; ++j) {
+			if (values[j] != 0) {
+				P_TEST_CHECK (p_tree_remove (tree, PINT_TO_POINTER (j + 1)) == TRUE);
+				values[j] = 0;
+			} else {
+				p_tree_insert (tree, PINT_TO_POINTER (j + 1), PINT_TO_POINTER (j + 40));
+				values[j] = j + 40;
+			}
+		}
+	}
+
+	P_TEST_CHECK (p_uthread_join (thread) == 0);
+	P_TEST_CHECK (reader.errors == 0);
+	P_TEST_CHECK (check_tree_contents (tree, values, count) == true);
+
+	p_uthread_unref (thread);
+	p_tree_free (tree);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (ptree_link_test)
+{
+	p_libsys_init ();
+
+	const pint	count = 1000;
+	TreeLinkItem	items[1000];
+	pint		order[1000];
+	PTreeLinkHead	head;
+	PTreeLink	*link;
+	pint		nodes;
+
+	p_tree_link_head_init (NULL, NULL, NULL);
+
+	P_TEST_CHECK (p_tree_link_insert (NULL, NULL, NULL) == NULL);
+	P_TEST_CHECK (p_tree_link_lookup (NULL, NULL) == NULL);
+	P_TEST_CHECK (p_tree_link_first (NULL) == NULL);
+	P_TEST_CHECK (p_tree_link_last (NULL) == NULL);
+	P_TEST_CHECK (p_tree_link_next (NULL) == NULL);
+	P_TEST_CHECK (p_tree_link_prev (NULL) == NULL);
+	P_TEST_CHECK (p_tree_link_get_nnodes (NULL) == 0);
+
+	p_tree_link_remove (NULL, NULL);
+
+	p_tree_link_head_init (&head, (PCompareDataFunc) compare_keys_data, &tree_data);
+
+	P_TEST_CHECK (p_tree_link_get_nnodes (&head) == 0);
+	P_TEST_CHECK (p_tree_link_first (&head) == NULL);
+	P_TEST_CHECK (p_tree_link_last (&head) == NULL);
+	P_TEST_CHECK (p_tree_link_lookup (&head, PINT_TO_POINTER (1)) == NULL);
+
+	srand ((unsigned int) time (NULL));
+
+	for (pint i = 0; i < count; ++i) {
+		items[i].id     = i + 1;
+		items[i].linked = false;
+		order[i]        = i;
+	}
+
+	for (pint i = count - 1; i > 0; --i) {
+		pint k   = rand () % (i + 1);
+		pint tmp = order[i];
+
+		order[i] = order[k];
+		order[k] = tmp;
+	}
+
+	/* Linking never allocates memory */
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	for (pint i = 0; i < count; ++i) {
+		TreeLinkItem *item = &items[order[i]];
+
+		P_TEST_CHECK (p_tree_link_insert (&head, &item->link, PINT_TO_POINTER (item->id)) == NULL);
+		item->linked = true;
+	}
+
+	p_mem_restore_vtable ();
+
+	P_TEST_CHECK (p_tree_link_get_nnodes (&head) == count);
+
+	/* Duplicates are not inserted */
+	TreeLinkItem duplicate;
+
+	P_TEST_CHECK (p_tree_link_insert (&head, &duplicate.link, PINT_TO_POINTER (10)) == &items[9].link);
+	P_TEST_CHECK (p_tree_link_get_nnodes (&head) == count);
+
+	for (pint iter = 0; iter < 4; ++iter) {
+		nodes = 0;
+
+		P_TEST_CHECK (check_tree_link (head.root, NULL, &nodes) > 0);
+		P_TEST_CHECK (nodes == p_tree_link_get_nnodes (&head));
+		P_TEST_CHECK (head.root == NULL || head.root->size == nodes);
+
+		/* Walks in both directions */
+		nodes = 0;
+		pint last_id = 0;
+
+		for (link = p_tree_link_first (&head); link != NULL; link = p_tree_link_next (link)) {
+			TreeLinkItem *item = P_CONTAINER_OF (link, TreeLinkItem, link);
+
+			P_TEST_CHECK (item->linked == true);
+			P_TEST_CHECK (item->id > last_id);
+			P_TEST_CHECK (link->key == PINT_TO_POINTER (item->id));
+
+			last_id = item->id;
+			++nodes;
+		}
+
+		P_TEST_CHECK (nodes == p_tree_link_get_nnodes (&head));
+
+		nodes   = 0;
+		last_id = count + 1;
+
+		for (link = p_tree_link_last (&head); link != NULL; link = p_tree_link_prev (link)) {
+			P_TEST_CHECK (P_CONTAINER_OF (link, TreeLinkItem, link)->id < last_id);
+
+			last_id = P_CONTAINER_OF (link, TreeLinkItem, link)->id;
+			++nodes;
+		}
+
+		P_TEST_CHECK (nodes == p_tree_link_get_nnodes (&head));
+
+		for (pint i = 0; i < count; ++i) {
+			tree_data.cmp_counter = 0;
+
+			link = p_tree_link_lookup (&head, PINT_TO_POINTER (i + 1));
+
+			P_TEST_CHECK (link == (items[i].linked ? &items[i].link : NULL));
+			P_TEST_CHECK (tree_data.cmp_counter <= 2 * ((pint) (log ((double) count + 1) / log (2.0))));
+		}
+
+		/* Toggle a random part of the links */
+		for (pint i = 0; i < count; ++i) {
+			if (rand () % 3 != 0)
+				continue;
+
+			if (items[i].linked) {
+				p_tree_link_remove (&head, &items[i].link);
+				items[i].linked = false;
+			} else {
+				P_TEST_CHECK (p_tree_link_insert (&head,
+								  &items[i].link,
+								  PINT_TO_POINTER (items[i].id)) == NULL);
+				items[i].linked = true;
+			}
+		}
+	}
+
+	while ((link = p_tree_link_first (&head)) != NULL)
+		p_tree_link_remove (&head, link);
+
+	P_TEST_CHECK (p_tree_link_get_nnodes (&head) == 0);
+	P_TEST_CHECK (head.root == NULL);
+
+	/* Red-black trees destroy exactly the removed pair */
+	memset (&tree_data, 0, sizeof (tree_data));
+
+	PTree *tree = p_tree_new_full (P_TREE_TYPE_RB,
+				       (PCompareDataFunc) compare_keys,
+				       NULL,
+				       (PDestroyFunc) key_destroy_notify,
+				       (PDestroyFunc) value_destroy_notify);
+	P_TEST_REQUIRE (tree != NULL);
+
+	for (pint i = 1; i <= 100; ++i)
+		p_tree_insert (tree, PINT_TO_POINTER (i), PINT_TO_POINTER (i * 10));
+
+	for (pint i = 50; i <= 100; i += 5) {
+		tree_data.key_sum   = 0;
+		tree_data.value_sum = 0;
+
+		P_TEST_CHECK (p_tree_remove (tree, PINT_TO_POINTER (i)) == TRUE);
+		P_TEST_CHECK (tree_data.key_sum == i);
+		P_TEST_CHECK (tree_data.value_sum == i * 10);
+		P_TEST_CHECK (p_tree_lookup (tree, PINT_TO_POINTER (i - 1)) == PINT_TO_POINTER ((i - 1) * 10));
+	}
+
+	p_tree_free (tree);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
 P_TEST_SUITE_BEGIN()
 {
 	P_TEST_SUITE_RUN_CASE (ptree_nomem_test);
 	P_TEST_SUITE_RUN_CASE (ptree_invalid_test);
 	P_TEST_SUITE_RUN_CASE (ptree_general_test);
 	P_TEST_SUITE_RUN_CASE (ptree_stress_test);
+	P_TEST_SUITE_RUN_CASE (ptree_btree_test);
+	P_TEST_SUITE_RUN_CASE (ptree_range_test);
+	P_TEST_SUITE_RUN_CASE (ptree_iter_test);
+	P_TEST_SUITE_RUN_CASE (ptree_sorted_test);
+	P_TEST_SUITE_RUN_CASE (ptree_rank_test);
+	P_TEST_SUITE_RUN_CASE (ptree_snapshot_test);
+	P_TEST_SUITE_RUN_CASE (ptree_link_test);
 }
 P_TEST_SUITE_END()
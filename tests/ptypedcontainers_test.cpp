@@ -0,0 +1,486 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <string.h>
+
+P_TEST_MODULE_INIT ();
+
+#define PTYPEDCONTAINERS_TEST_SIZE	5000
+
+typedef struct TestPoint_ {
+	pint	x;
+	pint	y;
+} TestPoint;
+
+/* Collides a lot to check the probing and the removal shifts */
+#define test_bad_hash(key) ((key) % 7)
+
+P_DEFINE_HASH_MAP (TestPointMap, puint64, TestPoint, p_typed_hash_uint64, P_TYPED_EQUAL)
+P_DEFINE_HASH_MAP (TestBadMap, puint64, puint64, test_bad_hash, P_TYPED_EQUAL)
+P_DEFINE_SORTED_MAP (TestSortedMap, pint64, TestPoint, P_TYPED_COMPARE)
+P_DEFINE_VECTOR (TestVector, TestPoint)
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static TestPoint make_point (pint x, pint y)
+{
+	TestPoint pt;
+
+	pt.x = x;
+	pt.y = y;
+
+	return pt;
+}
+
+static puint64 test_random (puint64 *state)
+{
+	*state ^= *state << 13;
+	*state ^= *state >> 7;
+	*state ^= *state << 17;
+
+	return *state;
+}
+
+P_TEST_CASE_BEGIN (ptypedcontainers_nomem_test)
+{
+	p_libsys_init ();
+
+	TestPointMap	*hash_map   = TestPointMap_new ();
+	TestSortedMap	*sorted_map = TestSortedMap_new ();
+	TestVector	*vector     = TestVector_new ();
+
+	P_TEST_REQUIRE (hash_map != NULL);
+	P_TEST_REQUIRE (sorted_map != NULL);
+	P_TEST_REQUIRE (vector != NULL);
+
+	PMemVTable vtable;
+
+	vtable.free    = pmem_free;
+	vtable.malloc  = pmem_alloc;
+	vtable.realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (TestPointMap_new () == NULL);
+	P_TEST_CHECK (TestSortedMap_new () == NULL);
+	P_TEST_CHECK (TestVector_new () == NULL);
+
+	P_TEST_CHECK (TestPointMap_insert (hash_map, 1, make_point (1, 1)) == FALSE);
+	P_TEST_CHECK (TestPointMap_reserve (hash_map, 100) == FALSE);
+	P_TEST_CHECK (TestSortedMap_insert (sorted_map, 1, make_point (1, 1)) == FALSE);
+	P_TEST_CHECK (TestSortedMap_reserve (sorted_map, 100) == FALSE);
+	P_TEST_CHECK (TestVector_append (vector, make_point (1, 1)) == FALSE);
+	P_TEST_CHECK (TestVector_reserve (vector, 100) == FALSE);
+
+	p_mem_restore_vtable ();
+
+	/* The containers stay usable after the failures */
+	P_TEST_CHECK (TestPointMap_size (hash_map) == 0);
+	P_TEST_CHECK (TestPointMap_lookup (hash_map, 1) == NULL);
+	P_TEST_CHECK (TestPointMap_insert (hash_map, 1, make_point (1, 1)) == TRUE);
+	P_TEST_CHECK (TestSortedMap_size (sorted_map) == 0);
+	P_TEST_CHECK (TestSortedMap_insert (sorted_map, 1, make_point (1, 1)) == TRUE);
+	P_TEST_CHECK (TestVector_size (vector) == 0);
+	P_TEST_CHECK (TestVector_append (vector, make_point (1, 1)) == TRUE);
+
+	/* Growing fails when the slots are full */
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	pint i;
+
+	for (i = 2; i <= 12; ++i)
+		P_TEST_CHECK (TestPointMap_insert (hash_map, (puint64) i, make_point (i, i)) == TRUE);
+
+	P_TEST_CHECK (TestPointMap_insert (hash_map, 13, make_point (13, 13)) == FALSE);
+
+	for (i = 2; i <= 8; ++i)
+		P_TEST_CHECK (TestVector_append (vector, make_point (i, i)) == TRUE);
+
+	P_TEST_CHECK (TestVector_append (vector, make_point (9, 9)) == FALSE);
+
+	p_mem_restore_vtable ();
+
+	P_TEST_CHECK (TestPointMap_size (hash_map) == 12);
+	P_TEST_CHECK (TestVector_size (vector) == 8);
+
+	for (i = 1; i <= 12; ++i)
+		P_TEST_CHECK (TestPointMap_lookup (hash_map, (puint64) i)->y == i);
+
+	TestPointMap_free (hash_map);
+	TestSortedMap_free (sorted_map);
+	TestVector_free (vector);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (ptypedcontainers_bad_input_test)
+{
+	p_libsys_init ();
+
+	psize pos = 0;
+
+	P_TEST_CHECK (TestPointMap_size (NULL) == 0);
+	P_TEST_CHECK (TestPointMap_reserve (NULL, 10) == FALSE);
+	P_TEST_CHECK (TestPointMap_insert (NULL, 1, make_point (1, 1)) == FALSE);
+	P_TEST_CHECK (TestPointMap_lookup (NULL, 1) == NULL);
+	P_TEST_CHECK (TestPointMap_remove (NULL, 1) == FALSE);
+	P_TEST_CHECK (TestPointMap_next (NULL, &pos) == NULL);
+
+	P_TEST_CHECK (TestSortedMap_size (NULL) == 0);
+	P_TEST_CHECK (TestSortedMap_reserve (NULL, 10) == FALSE);
+	P_TEST_CHECK (TestSortedMap_lower_bound (NULL, 1) == 0);
+	P_TEST_CHECK (TestSortedMap_insert (NULL, 1, make_point (1, 1)) == FALSE);
+	P_TEST_CHECK (TestSortedMap_lookup (NULL, 1) == NULL);
+	P_TEST_CHECK (TestSortedMap_remove (NULL, 1) == FALSE);
+	P_TEST_CHECK (TestSortedMap_nth (NULL, 0) == NULL);
+
+	P_TEST_CHECK (TestVector_size (NULL) == 0);
+	P_TEST_CHECK (TestVector_data (NULL) == NULL);
+	P_TEST_CHECK (TestVector_reserve (NULL, 10) == FALSE);
+	P_TEST_CHECK (TestVector_append (NULL, make_point (1, 1)) == FALSE);
+	P_TEST_CHECK (TestVector_pop (NULL, NULL) == FALSE);
+	P_TEST_CHECK (TestVector_get (NULL, 0) == NULL);
+	P_TEST_CHECK (TestVector_remove_index (NULL, 0) == FALSE);
+
+	TestPointMap_free (NULL);
+	TestPointMap_clear (NULL);
+	TestSortedMap_free (NULL);
+	TestSortedMap_clear (NULL);
+	TestVector_free (NULL);
+	TestVector_clear (NULL);
+
+	/* Empty containers */
+	TestPointMap	*hash_map   = TestPointMap_new ();
+	TestSortedMap	*sorted_map = TestSortedMap_new ();
+	TestVector	*vector     = TestVector_new ();
+
+	P_TEST_REQUIRE (hash_map != NULL);
+	P_TEST_REQUIRE (sorted_map != NULL);
+	P_TEST_REQUIRE (vector != NULL);
+
+	P_TEST_CHECK (TestPointMap_lookup (hash_map, 1) == NULL);
+	P_TEST_CHECK (TestPointMap_remove (hash_map, 1) == FALSE);
+	P_TEST_CHECK (TestPointMap_next (hash_map, NULL) == NULL);
+	P_TEST_CHECK (TestPointMap_next (hash_map, &pos) == NULL);
+	TestPointMap_clear (hash_map);
+
+	P_TEST_CHECK (TestSortedMap_lookup (sorted_map, 1) == NULL);
+	P_TEST_CHECK (TestSortedMap_remove (sorted_map, 1) == FALSE);
+	P_TEST_CHECK (TestSortedMap_lower_bound (sorted_map, 1) == 0);
+	P_TEST_CHECK (TestSortedMap_nth (sorted_map, 0) == NULL);
+
+	P_TEST_CHECK (TestVector_pop (vector, NULL) == FALSE);
+	P_TEST_CHECK (TestVector_get (vector, 0) == NULL);
+	P_TEST_CHECK (TestVector_remove_index (vector, 0) == FALSE);
+
+	TestPointMap_free (hash_map);
+	TestSortedMap_free (sorted_map);
+	TestVector_free (vector);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (ptypedcontainers_hash_map_test)
+{
+	p_libsys_init ();
+
+	TestPointMap *map = TestPointMap_new ();
+	P_TEST_REQUIRE (map != NULL);
+
+	/* Keys don't fit into 32-bit pointers */
+	for (puint64 i = 0; i < PTYPEDCONTAINERS_TEST_SIZE; ++i)
+		P_TEST_REQUIRE (TestPointMap_insert (map, i << 32, make_point ((pint) i, 0)) == TRUE);
+
+	P_TEST_CHECK (TestPointMap_size (map) == PTYPEDCONTAINERS_TEST_SIZE);
+
+	/* Replace the values of the even keys */
+	for (puint64 i = 0; i < PTYPEDCONTAINERS_TEST_SIZE; i += 2)
+		P_TEST_CHECK (TestPointMap_insert (map, i << 32, make_point ((pint) i, 1)) == TRUE);
+
+	P_TEST_CHECK (TestPointMap_size (map) == PTYPEDCONTAINERS_TEST_SIZE);
+
+	for (puint64 i = 0; i < PTYPEDCONTAINERS_TEST_SIZE; ++i) {
+		TestPoint *pt = TestPointMap_lookup (map, i << 32);
+
+		P_TEST_REQUIRE (pt != NULL);
+		P_TEST_CHECK (pt->x == (pint) i);
+		P_TEST_CHECK (pt->y == (pint) (i % 2 == 0));
+
+		/* Values are updated in place */
+		pt->y = 2;
+	}
+
+	P_TEST_CHECK (TestPointMap_lookup (map, 1) == NULL);
+	P_TEST_CHECK (TestPointMap_lookup (map, (puint64) PTYPEDCONTAINERS_TEST_SIZE << 32) == NULL);
+
+	/* Walk through all the entries */
+	psize		pos   = 0;
+	psize		count = 0;
+	puint64		sum   = 0;
+	TestPointMapEntry *entry;
+
+	while ((entry = TestPointMap_next (map, &pos)) != NULL) {
+		P_TEST_CHECK (entry->value.y == 2);
+		P_TEST_CHECK ((puint64) entry->value.x == entry->key >> 32);
+
+		sum += entry->key >> 32;
+		++count;
+	}
+
+	P_TEST_CHECK (count == PTYPEDCONTAINERS_TEST_SIZE);
+	P_TEST_CHECK (sum == (puint64) PTYPEDCONTAINERS_TEST_SIZE * (PTYPEDCONTAINERS_TEST_SIZE - 1) / 2);
+
+	for (puint64 i = 0; i < PTYPEDCONTAINERS_TEST_SIZE; i += 3)
+		P_TEST_CHECK (TestPointMap_remove (map, i << 32) == TRUE);
+
+	for (puint64 i = 0; i < PTYPEDCONTAINERS_TEST_SIZE; ++i) {
+		P_TEST_CHECK ((TestPointMap_lookup (map, i << 32) == NULL) == (i % 3 == 0));
+		P_TEST_CHECK (TestPointMap_remove (map, i << 32) == (i % 3 != 0));
+	}
+
+	P_TEST_CHECK (TestPointMap_size (map) == 0);
+
+	/* Reserved slots are not reallocated by the inserts */
+	P_TEST_CHECK (TestPointMap_reserve (map, 100000) == TRUE);
+
+	TestPointMapEntry *entries = map->entries;
+
+	for (puint64 i = 0; i < 100000; ++i)
+		P_TEST_REQUIRE (TestPointMap_insert (map, i, make_point (0, 0)) == TRUE);
+
+	P_TEST_CHECK (map->entries == entries);
+	P_TEST_CHECK (TestPointMap_size (map) == 100000);
+
+	TestPointMap_clear (map);
+
+	P_TEST_CHECK (TestPointMap_size (map) == 0);
+	P_TEST_CHECK (TestPointMap_lookup (map, 10) == NULL);
+	P_TEST_CHECK (TestPointMap_insert (map, 10, make_point (10, 10)) == TRUE);
+	P_TEST_CHECK (TestPointMap_lookup (map, 10)->x == 10);
+
+	TestPointMap_free (map);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (ptypedcontainers_hash_map_collision_test)
+{
+	p_libsys_init ();
+
+	TestBadMap	*map = TestBadMap_new ();
+	pboolean	present[512];
+	puint64		state = 88172645463325252ULL;
+	psize		size  = 0;
+
+	P_TEST_REQUIRE (map != NULL);
+
+	memset (present, 0, sizeof (present));
+
+	/* Random inserts and removals against a shadow set */
+	for (pint i = 0; i < 50000; ++i) {
+		puint64 key = test_random (&state) % 512;
+
+		if (test_random (&state) % 2 == 0) {
+			P_TEST_REQUIRE (TestBadMap_insert (map, key, key * 3) == TRUE);
+
+			if (!present[key]) {
+				present[key] = TRUE;
+				++size;
+			}
+		} else {
+			P_TEST_REQUIRE (TestBadMap_remove (map, key) == present[key]);
+
+			if (present[key]) {
+				present[key] = FALSE;
+				--size;
+			}
+		}
+
+		P_TEST_REQUIRE (TestBadMap_size (map) == size);
+	}
+
+	for (puint64 key = 0; key < 512; ++key) {
+		puint64 *value = TestBadMap_lookup (map, key);
+
+		P_TEST_CHECK ((value != NULL) == present[key]);
+
+		if (value != NULL)
+			P_TEST_CHECK (*value == key * 3);
+	}
+
+	TestBadMap_free (map);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (ptypedcontainers_sorted_map_test)
+{
+	p_libsys_init ();
+
+	TestSortedMap	*map   = TestSortedMap_new ();
+	puint64		state = 88172645463325252ULL;
+
+	P_TEST_REQUIRE (map != NULL);
+
+	/* Even keys in the random order, with duplicates */
+	for (pint i = 0; i < PTYPEDCONTAINERS_TEST_SIZE * 2; ++i) {
+		pint64 key = (pint64) (test_random (&state) % PTYPEDCONTAINERS_TEST_SIZE) * 2;
+
+		P_TEST_REQUIRE (TestSortedMap_insert (map, key, make_point ((pint) key, 0)) == TRUE);
+	}
+
+	for (pint64 key = 0; key < PTYPEDCONTAINERS_TEST_SIZE * 2; key += 2)
+		P_TEST_REQUIRE (TestSortedMap_insert (map, key, make_point ((pint) key, 1)) == TRUE);
+
+	P_TEST_CHECK (TestSortedMap_size (map) == PTYPEDCONTAINERS_TEST_SIZE);
+
+	for (psize i = 0; i < PTYPEDCONTAINERS_TEST_SIZE; ++i) {
+		TestSortedMapEntry *entry = TestSortedMap_nth (map, i);
+
+		P_TEST_REQUIRE (entry != NULL);
+		P_TEST_CHECK (entry->key == (pint64) i * 2);
+		P_TEST_CHECK (entry->value.x == (pint) i * 2);
+		P_TEST_CHECK (entry->value.y == 1);
+	}
+
+	P_TEST_CHECK (TestSortedMap_nth (map, PTYPEDCONTAINERS_TEST_SIZE) == NULL);
+
+	P_TEST_CHECK (TestSortedMap_lower_bound (map, -1) == 0);
+	P_TEST_CHECK (TestSortedMap_lower_bound (map, 0) == 0);
+	P_TEST_CHECK (TestSortedMap_lower_bound (map, 1) == 1);
+	P_TEST_CHECK (TestSortedMap_lower_bound (map, 100) == 50);
+	P_TEST_CHECK (TestSortedMap_lower_bound (map, 101) == 51);
+	P_TEST_CHECK (TestSortedMap_lower_bound (map, PTYPEDCONTAINERS_TEST_SIZE * 2) == PTYPEDCONTAINERS_TEST_SIZE);
+
+	P_TEST_CHECK (TestSortedMap_lookup (map, 1) == NULL);
+	P_TEST_CHECK (TestSortedMap_lookup (map, -2) == NULL);
+	P_TEST_CHECK (TestSortedMap_lookup (map, 100)->x == 100);
+
+	for (pint64 key = 0; key < PTYPEDCONTAINERS_TEST_SIZE * 2; key += 4)
+		P_TEST_CHECK (TestSortedMap_remove (map, key) == TRUE);
+
+	P_TEST_CHECK (TestSortedMap_remove (map, 0) == FALSE);
+	P_TEST_CHECK (TestSortedMap_remove (map, 1) == FALSE);
+	P_TEST_CHECK (TestSortedMap_size (map) == PTYPEDCONTAINERS_TEST_SIZE / 2);
+
+	for (psize i = 0; i < TestSortedMap_size (map); ++i)
+		P_TEST_CHECK (TestSortedMap_nth (map, i)->key == (pint64) i * 4 + 2);
+
+	TestSortedMap_clear (map);
+
+	P_TEST_CHECK (TestSortedMap_size (map) == 0);
+	P_TEST_CHECK (TestSortedMap_lookup (map, 2) == NULL);
+
+	TestSortedMap_free (map);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (ptypedcontainers_vector_test)
+{
+	p_libsys_init ();
+
+	TestVector	*vector = TestVector_new ();
+	TestPoint	pt;
+
+	P_TEST_REQUIRE (vector != NULL);
+
+	for (pint i = 0; i < PTYPEDCONTAINERS_TEST_SIZE; ++i)
+		P_TEST_REQUIRE (TestVector_append (vector, make_point (i, -i)) == TRUE);
+
+	P_TEST_CHECK (TestVector_size (vector) == PTYPEDCONTAINERS_TEST_SIZE);
+
+	TestPoint *data = TestVector_data (vector);
+
+	for (pint i = 0; i < PTYPEDCONTAINERS_TEST_SIZE; ++i) {
+		P_TEST_CHECK (data[i].x == i);
+		P_TEST_CHECK (TestVector_get (vector, (psize) i) == &data[i]);
+	}
+
+	P_TEST_CHECK (TestVector_get (vector, PTYPEDCONTAINERS_TEST_SIZE) == NULL);
+	P_TEST_CHECK (TestVector_remove_index (vector, PTYPEDCONTAINERS_TEST_SIZE) == FALSE);
+
+	P_TEST_CHECK (TestVector_remove_index (vector, 0) == TRUE);
+	P_TEST_CHECK (TestVector_remove_index (vector, 10) == TRUE);
+	P_TEST_CHECK (TestVector_size (vector) == PTYPEDCONTAINERS_TEST_SIZE - 2);
+	P_TEST_CHECK (TestVector_get (vector, 0)->x == 1);
+	P_TEST_CHECK (TestVector_get (vector, 9)->x == 10);
+	P_TEST_CHECK (TestVector_get (vector, 10)->x == 12);
+
+	P_TEST_CHECK (TestVector_pop (vector, &pt) == TRUE);
+	P_TEST_CHECK (pt.x == PTYPEDCONTAINERS_TEST_SIZE - 1);
+	P_TEST_CHECK (pt.y == -(PTYPEDCONTAINERS_TEST_SIZE - 1));
+	P_TEST_CHECK (TestVector_pop (vector, NULL) == TRUE);
+	P_TEST_CHECK (TestVector_size (vector) == PTYPEDCONTAINERS_TEST_SIZE - 4);
+
+	TestVector_clear (vector);
+
+	P_TEST_CHECK (TestVector_size (vector) == 0);
+	P_TEST_CHECK (TestVector_pop (vector, &pt) == FALSE);
+
+	P_TEST_CHECK (TestVector_reserve (vector, 10) == TRUE);
+	P_TEST_CHECK (TestVector_append (vector, make_point (7, 7)) == TRUE);
+	P_TEST_CHECK (TestVector_get (vector, 0)->y == 7);
+
+	TestVector_free (vector);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (ptypedcontainers_nomem_test);
+	P_TEST_SUITE_RUN_CASE (ptypedcontainers_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (ptypedcontainers_hash_map_test);
+	P_TEST_SUITE_RUN_CASE (ptypedcontainers_hash_map_collision_test);
+	P_TEST_SUITE_RUN_CASE (ptypedcontainers_sorted_map_test);
+	P_TEST_SUITE_RUN_CASE (ptypedcontainers_vector_test);
+}
+P_TEST_SUITE_END()
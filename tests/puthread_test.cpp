@@ -42,6 +42,12 @@ static PUThreadKey * tls_key      = NULL;
 static PUThreadKey * tls_key_2    = NULL;
 static volatile pint free_counter = 0;
 
+static PUThreadStaticKey * static_tls_key = NULL;
+
+static volatile pchar * stack_local_addr = NULL;
+
+static volatile pint cpu_time_stop = 0;
+
 extern "C" ppointer pmem_alloc (psize nbytes)
 {
 	P_UNUSED (nbytes);
@@ -66,6 +72,12 @@ extern "C" void free_with_check (ppointer mem)
 	p_atomic_int_inc (&free_counter);
 }
 
+extern "C" void count_with_check (ppointer mem)
+{
+	P_UNUSED (mem);
+	p_atomic_int_inc (&free_counter);
+}
+
 static void * test_thread_func (void *data)
 {
 	pint *counter = static_cast < pint * > (data);
@@ -180,6 +192,32 @@ static void * test_thread_tls_create_func (void *data)
 	return NULL;
 }
 
+static void * test_thread_static_tls_func (void *data)
+{
+	P_UNUSED (data);
+
+	if (p_uthread_get_static_local (static_tls_key) != NULL)
+		p_uthread_exit (-1);
+
+	pint *tls_value = (pint *) p_malloc0 (sizeof (pint));
+	p_uthread_set_static_local (static_tls_key, (ppointer) tls_value);
+
+	for (pint i = 0; i < 1000; ++i) {
+		pint *last_tls = (pint *) p_uthread_get_static_local (static_tls_key);
+
+		if (last_tls != tls_value || *last_tls != i)
+			p_uthread_exit (-1);
+
+		++(*last_tls);
+
+		if (i % 100 == 0)
+			p_uthread_yield ();
+	}
+
+	/* The value is freed on the thread exit */
+	return NULL;
+}
+
 P_TEST_CASE_BEGIN (puthread_nomem_test)
 {
 	p_libsys_init ();
@@ -249,6 +287,14 @@ P_TEST_CASE_BEGIN (puthread_bad_input_test)
 	P_TEST_CHECK (p_uthread_create_full (NULL, NULL, FALSE, P_UTHREAD_PRIORITY_NORMAL, 0, NULL) == NULL);
 	P_TEST_CHECK (p_uthread_join (NULL) == -1);
 	P_TEST_CHECK (p_uthread_set_priority (NULL, P_UTHREAD_PRIORITY_NORMAL) == FALSE);
+	P_TEST_CHECK (p_uthread_set_affinity (NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_uthread_get_affinity (NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_uthread_get_cpu_time (NULL) == -1);
+	P_TEST_CHECK (p_uthread_cpu_set_add (NULL, 0) == FALSE);
+	P_TEST_CHECK (p_uthread_cpu_set_remove (NULL, 0) == FALSE);
+	P_TEST_CHECK (p_uthread_cpu_set_contains (NULL, 0) == FALSE);
+	P_TEST_CHECK (p_uthread_cpu_set_count (NULL) == 0);
+	p_uthread_cpu_set_clear (NULL);
 	P_TEST_CHECK (p_uthread_get_local (NULL) == NULL);
 	p_uthread_set_local (NULL, NULL);
 	p_uthread_replace_local (NULL, NULL);
@@ -470,6 +516,369 @@ P_TEST_CASE_BEGIN (puthread_tls_test)
 }
 P_TEST_CASE_END ()
 
+P_TEST_CASE_BEGIN (puthread_static_tls_test)
+{
+	PUThreadStaticKey	*keys[80];
+	PUThreadStaticKey	*stale_key;
+	pint			i;
+
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_uthread_get_static_local (NULL) == NULL);
+	p_uthread_set_static_local (NULL, NULL);
+	p_uthread_replace_static_local (NULL, NULL);
+	p_uthread_static_local_free (NULL);
+
+	static_tls_key = p_uthread_static_local_new (free_with_check);
+	P_TEST_REQUIRE (static_tls_key != NULL);
+
+	free_counter = 0;
+
+	P_TEST_CHECK (p_uthread_get_static_local (static_tls_key) == NULL);
+
+	pint *tls_value = (pint *) p_malloc0 (sizeof (pint));
+	p_uthread_set_static_local (static_tls_key, (ppointer) tls_value);
+	P_TEST_CHECK (p_uthread_get_static_local (static_tls_key) == (ppointer) tls_value);
+
+	p_uthread_replace_static_local (static_tls_key, NULL);
+	P_TEST_CHECK (p_uthread_get_static_local (static_tls_key) == NULL);
+	P_TEST_CHECK (free_counter == 1);
+
+	/* Values are destroyed on the thread exit */
+	free_counter = 0;
+
+	PUThread *thr1 = p_uthread_create ((PUThreadFunc) test_thread_static_tls_func,
+					   NULL,
+					   TRUE,
+					   NULL);
+
+	PUThread *thr2 = p_uthread_create ((PUThreadFunc) test_thread_static_tls_func,
+					   NULL,
+					   TRUE,
+					   NULL);
+
+	P_TEST_REQUIRE (thr1 != NULL);
+	P_TEST_REQUIRE (thr2 != NULL);
+
+	P_TEST_CHECK (p_uthread_join (thr1) == 0);
+	P_TEST_CHECK (p_uthread_join (thr2) == 0);
+	P_TEST_CHECK (free_counter == 2);
+
+	p_uthread_unref (thr1);
+	p_uthread_unref (thr2);
+
+	p_uthread_static_local_free (static_tls_key);
+
+	/* More keys than the compiler TLS slots */
+	for (i = 0; i < 80; ++i) {
+		keys[i] = p_uthread_static_local_new (NULL);
+		P_TEST_REQUIRE (keys[i] != NULL);
+
+		p_uthread_set_static_local (keys[i], PINT_TO_POINTER (i + 1));
+	}
+
+	for (i = 0; i < 80; ++i)
+		P_TEST_CHECK (p_uthread_get_static_local (keys[i]) == PINT_TO_POINTER (i + 1));
+
+	for (i = 0; i < 80; ++i) {
+		p_uthread_set_static_local (keys[i], NULL);
+		p_uthread_static_local_free (keys[i]);
+	}
+
+	/* A new key doesn't see the value of a freed one */
+	free_counter = 0;
+
+	stale_key = p_uthread_static_local_new (count_with_check);
+	P_TEST_REQUIRE (stale_key != NULL);
+
+	p_uthread_set_static_local (stale_key, PINT_TO_POINTER (1));
+	p_uthread_static_local_free (stale_key);
+
+	static_tls_key = p_uthread_static_local_new (NULL);
+	P_TEST_REQUIRE (static_tls_key != NULL);
+
+	P_TEST_CHECK (p_uthread_get_static_local (static_tls_key) == NULL);
+	p_uthread_set_static_local (static_tls_key, PINT_TO_POINTER (2));
+	P_TEST_CHECK (p_uthread_get_static_local (static_tls_key) == PINT_TO_POINTER (2));
+	P_TEST_CHECK (free_counter <= 1);
+
+	p_uthread_set_static_local (static_tls_key, NULL);
+	p_uthread_static_local_free (static_tls_key);
+
+	/* The current thread is cached */
+	P_TEST_CHECK (p_uthread_current () != NULL);
+	P_TEST_CHECK (p_uthread_current () == p_uthread_current ());
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+static void * test_thread_stack_func (void *data)
+{
+	volatile pchar buf[256];
+
+	P_UNUSED (data);
+
+	buf[0] = 1;
+	stack_local_addr = buf;
+
+	p_uthread_exit (buf[0]);
+
+	return NULL;
+}
+
+P_TEST_CASE_BEGIN (puthread_attr_test)
+{
+	PUThreadAttr	*attr;
+	PUThread	*thr;
+	ppointer	stack;
+	psize		stack_size;
+
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_uthread_attr_set_priority (NULL, P_UTHREAD_PRIORITY_LOW) == FALSE);
+	P_TEST_CHECK (p_uthread_attr_set_stack_size (NULL, 0) == FALSE);
+	P_TEST_CHECK (p_uthread_attr_set_stack (NULL, NULL, 0) == FALSE);
+	P_TEST_CHECK (p_uthread_attr_set_guard_size (NULL, 0) == FALSE);
+	P_TEST_CHECK (p_uthread_attr_set_prefault (NULL, TRUE) == FALSE);
+	P_TEST_CHECK (p_uthread_create_with_attr (NULL, NULL, TRUE, NULL, NULL) == NULL);
+	p_uthread_attr_free (NULL);
+
+	attr = p_uthread_attr_new ();
+	P_TEST_REQUIRE (attr != NULL);
+
+	P_TEST_CHECK (p_uthread_attr_set_priority (attr, (PUThreadPriority) 100) == FALSE);
+	P_TEST_CHECK (p_uthread_attr_set_stack (attr, &stack, 0) == FALSE);
+
+	/* Defaults */
+	stack_local_addr = NULL;
+	thr = p_uthread_create_with_attr ((PUThreadFunc) test_thread_stack_func, NULL, TRUE, NULL, NULL);
+	P_TEST_REQUIRE (thr != NULL);
+	P_TEST_CHECK (p_uthread_join (thr) == 1);
+	P_TEST_CHECK (stack_local_addr != NULL);
+	p_uthread_unref (thr);
+
+	/* System stack with a guard area, pre-faulted by the new thread */
+	stack_size = 256 * 1024;
+
+	P_TEST_CHECK (p_uthread_attr_set_priority (attr, P_UTHREAD_PRIORITY_NORMAL) == TRUE);
+	P_TEST_CHECK (p_uthread_attr_set_stack_size (attr, stack_size) == TRUE);
+	P_TEST_CHECK (p_uthread_attr_set_guard_size (attr, 64 * 1024) == TRUE);
+	P_TEST_CHECK (p_uthread_attr_set_prefault (attr, TRUE) == TRUE);
+
+	stack_local_addr = NULL;
+	thr = p_uthread_create_with_attr ((PUThreadFunc) test_thread_stack_func, NULL, TRUE, attr, "attr_thread");
+	P_TEST_REQUIRE (thr != NULL);
+	P_TEST_CHECK (p_uthread_join (thr) == 1);
+	P_TEST_CHECK (stack_local_addr != NULL);
+	p_uthread_unref (thr);
+
+	/* Caller-provided stack, not every system supports it */
+	stack = p_mem_mmap (stack_size, NULL);
+	P_TEST_REQUIRE (stack != NULL);
+
+	P_TEST_CHECK (p_uthread_attr_set_stack (attr, stack, stack_size) == TRUE);
+
+	stack_local_addr = NULL;
+	thr = p_uthread_create_with_attr ((PUThreadFunc) test_thread_stack_func, NULL, TRUE, attr, NULL);
+
+	if (thr != NULL) {
+		P_TEST_CHECK (p_uthread_join (thr) == 1);
+		P_TEST_CHECK ((pchar *) stack_local_addr >= (pchar *) stack);
+		P_TEST_CHECK ((pchar *) stack_local_addr < (pchar *) stack + stack_size);
+		p_uthread_unref (thr);
+	}
+
+	P_TEST_CHECK (p_mem_munmap (stack, stack_size, NULL) == TRUE);
+
+	/* Back to the system stack */
+	P_TEST_CHECK (p_uthread_attr_set_stack (attr, NULL, 0) == TRUE);
+
+	thr = p_uthread_create_with_attr ((PUThreadFunc) test_thread_stack_func, NULL, TRUE, attr, NULL);
+	P_TEST_REQUIRE (thr != NULL);
+	P_TEST_CHECK (p_uthread_join (thr) == 1);
+	p_uthread_unref (thr);
+
+	p_uthread_attr_free (attr);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (puthread_affinity_test)
+{
+	PUThreadCpuSet	cpu_set;
+	PUThreadCpuSet	orig_set;
+	PUThreadCpuSet	pin_set;
+	PUThread	*cur_thr;
+	pint		first_cpu;
+	pint		i;
+
+	p_libsys_init ();
+
+	p_uthread_cpu_set_clear (&cpu_set);
+	P_TEST_CHECK (p_uthread_cpu_set_count (&cpu_set) == 0);
+
+	P_TEST_CHECK (p_uthread_cpu_set_add (&cpu_set, -1) == FALSE);
+	P_TEST_CHECK (p_uthread_cpu_set_add (&cpu_set, P_UTHREAD_CPU_SET_SIZE) == FALSE);
+	P_TEST_CHECK (p_uthread_cpu_set_remove (&cpu_set, P_UTHREAD_CPU_SET_SIZE) == FALSE);
+	P_TEST_CHECK (p_uthread_cpu_set_contains (&cpu_set, P_UTHREAD_CPU_SET_SIZE) == FALSE);
+
+	P_TEST_CHECK (p_uthread_cpu_set_add (&cpu_set, 0) == TRUE);
+	P_TEST_CHECK (p_uthread_cpu_set_add (&cpu_set, 33) == TRUE);
+	P_TEST_CHECK (p_uthread_cpu_set_add (&cpu_set, P_UTHREAD_CPU_SET_SIZE - 1) == TRUE);
+	P_TEST_CHECK (p_uthread_cpu_set_add (&cpu_set, 33) == TRUE);
+	P_TEST_CHECK (p_uthread_cpu_set_count (&cpu_set) == 3);
+
+	P_TEST_CHECK (p_uthread_cpu_set_contains (&cpu_set, 0) == TRUE);
+	P_TEST_CHECK (p_uthread_cpu_set_contains (&cpu_set, 1) == FALSE);
+	P_TEST_CHECK (p_uthread_cpu_set_contains (&cpu_set, 33) == TRUE);
+	P_TEST_CHECK (p_uthread_cpu_set_contains (&cpu_set, P_UTHREAD_CPU_SET_SIZE - 1) == TRUE);
+
+	P_TEST_CHECK (p_uthread_cpu_set_remove (&cpu_set, 33) == TRUE);
+	P_TEST_CHECK (p_uthread_cpu_set_contains (&cpu_set, 33) == FALSE);
+	P_TEST_CHECK (p_uthread_cpu_set_count (&cpu_set) == 2);
+
+	p_uthread_cpu_set_clear (&cpu_set);
+	P_TEST_CHECK (p_uthread_cpu_set_count (&cpu_set) == 0);
+
+	cur_thr = p_uthread_current ();
+	P_TEST_REQUIRE (cur_thr != NULL);
+
+	/* Empty set is never accepted */
+	P_TEST_CHECK (p_uthread_set_affinity (cur_thr, &cpu_set) == FALSE);
+
+	if (p_uthread_get_affinity (cur_thr, &orig_set) == TRUE) {
+		P_TEST_REQUIRE (p_uthread_cpu_set_count (&orig_set) > 0);
+
+		first_cpu = -1;
+
+		for (i = 0; i < P_UTHREAD_CPU_SET_SIZE && first_cpu == -1; ++i) {
+			if (p_uthread_cpu_set_contains (&orig_set, i) == TRUE)
+				first_cpu = i;
+		}
+
+		P_TEST_REQUIRE (first_cpu >= 0);
+
+		p_uthread_cpu_set_clear (&pin_set);
+		p_uthread_cpu_set_add (&pin_set, first_cpu);
+
+		P_TEST_CHECK (p_uthread_set_affinity (cur_thr, &pin_set) == TRUE);
+		P_TEST_CHECK (p_uthread_get_affinity (cur_thr, &cpu_set) == TRUE);
+		P_TEST_CHECK (p_uthread_cpu_set_count (&cpu_set) == 1);
+		P_TEST_CHECK (p_uthread_cpu_set_contains (&cpu_set, first_cpu) == TRUE);
+
+		if (p_uthread_current_cpu () != -1)
+			P_TEST_CHECK (p_uthread_current_cpu () == first_cpu);
+
+		P_TEST_CHECK (p_uthread_set_affinity (cur_thr, &orig_set) == TRUE);
+		P_TEST_CHECK (p_uthread_get_affinity (cur_thr, &cpu_set) == TRUE);
+		P_TEST_CHECK (p_uthread_cpu_set_count (&cpu_set) == p_uthread_cpu_set_count (&orig_set));
+	} else {
+		p_uthread_cpu_set_add (&cpu_set, 0);
+		P_TEST_CHECK (p_uthread_set_affinity (cur_thr, &cpu_set) == FALSE);
+	}
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+static void * test_thread_cpu_busy_func (void *data)
+{
+	P_UNUSED (data);
+
+	while (p_atomic_int_get (&cpu_time_stop) == 0)
+		;
+
+	p_uthread_exit (1);
+
+	return NULL;
+}
+
+static void * test_thread_cpu_sleep_func (void *data)
+{
+	pint64 start_time;
+	pint64 end_time;
+
+	P_UNUSED (data);
+
+	start_time = p_uthread_get_cpu_time (p_uthread_current ());
+	p_uthread_sleep (100);
+	end_time = p_uthread_get_cpu_time (p_uthread_current ());
+
+	/* Sleeping thread should consume almost nothing */
+	p_uthread_exit (end_time - start_time < 50000000 ? 1 : 0);
+
+	return NULL;
+}
+
+P_TEST_CASE_BEGIN (puthread_cpu_time_test)
+{
+	PTimeProfiler	*profiler;
+	PUThread	*cur_thr;
+	PUThread	*thr;
+	pint64		start_time;
+	pint64		end_time;
+	pint64		proc_start_time;
+	pint64		proc_end_time;
+
+	p_libsys_init ();
+
+	cur_thr = p_uthread_current ();
+	P_TEST_REQUIRE (cur_thr != NULL);
+
+	proc_start_time = p_process_get_cpu_time ();
+	P_TEST_CHECK (proc_start_time >= 0);
+
+	start_time = p_uthread_get_cpu_time (cur_thr);
+
+	if (start_time == -1) {
+		p_libsys_shutdown ();
+		P_TEST_CASE_RETURN ();
+	}
+
+	/* Spin for 50 ms of wall time, it must be mostly CPU time */
+	profiler = p_time_profiler_new ();
+	P_TEST_REQUIRE (profiler != NULL);
+
+	while (p_time_profiler_elapsed_usecs (profiler) < 50000)
+		;
+
+	p_time_profiler_free (profiler);
+
+	end_time = p_uthread_get_cpu_time (cur_thr);
+	P_TEST_CHECK (end_time - start_time >= 10000000);
+
+	proc_end_time = p_process_get_cpu_time ();
+	P_TEST_CHECK (proc_end_time - proc_start_time >= end_time - start_time - 1000000);
+
+	/* Busy thread is sampled from the outside */
+	p_atomic_int_set (&cpu_time_stop, 0);
+
+	thr = p_uthread_create ((PUThreadFunc) test_thread_cpu_busy_func, NULL, TRUE, NULL);
+	P_TEST_REQUIRE (thr != NULL);
+
+	p_uthread_sleep (10);
+	start_time = p_uthread_get_cpu_time (thr);
+	p_uthread_sleep (100);
+	end_time = p_uthread_get_cpu_time (thr);
+
+	P_TEST_CHECK (start_time >= 0);
+	P_TEST_CHECK (end_time - start_time >= 10000000);
+
+	p_atomic_int_set (&cpu_time_stop, 1);
+	P_TEST_CHECK (p_uthread_join (thr) == 1);
+	p_uthread_unref (thr);
+
+	thr = p_uthread_create ((PUThreadFunc) test_thread_cpu_sleep_func, NULL, TRUE, NULL);
+	P_TEST_REQUIRE (thr != NULL);
+	P_TEST_CHECK (p_uthread_join (thr) == 1);
+	p_uthread_unref (thr);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
 P_TEST_SUITE_BEGIN()
 {
 	P_TEST_SUITE_RUN_CASE (puthread_nomem_test);
@@ -477,5 +886,9 @@ P_TEST_SUITE_BEGIN()
 	P_TEST_SUITE_RUN_CASE (puthread_general_test);
 	P_TEST_SUITE_RUN_CASE (puthread_nonjoinable_test);
 	P_TEST_SUITE_RUN_CASE (puthread_tls_test);
+	P_TEST_SUITE_RUN_CASE (puthread_static_tls_test);
+	P_TEST_SUITE_RUN_CASE (puthread_attr_test);
+	P_TEST_SUITE_RUN_CASE (puthread_affinity_test);
+	P_TEST_SUITE_RUN_CASE (puthread_cpu_time_test);
 }
 P_TEST_SUITE_END()